@@ -159,6 +159,24 @@ IREE_EMBED_EXPORTED void ireeCompilerSessionGetFlags(
     iree_compiler_session_t *session, bool nonDefaultOnly,
     void (*onFlag)(const char *flag, size_t length, void *), void *userData);
 
+// Prepares a session for reuse by many invocations. Plugins are activated,
+// all registered dialects are loaded and the HAL target backends selected by
+// the session flags are instantiated. This work is otherwise done
+// lazily by the first invocation and retained by the session for all that
+// follow, so long-lived sessions (such as those used to JIT compile programs)
+// should call this once after setting flags to keep it off the latency of
+// their first compilation.
+//
+// Invocations created from a prepared session may run concurrently on
+// different threads. Diagnostics are only delivered to the invocation that
+// produced them. Session flags must not be changed while any invocation is
+// live.
+//
+// Returns an error if plugin activation fails.
+// Available since: 1.6
+IREE_EMBED_EXPORTED iree_compiler_error_t *
+ireeCompilerSessionPrepare(iree_compiler_session_t *session);
+
 //===----------------------------------------------------------------------===//
 // Run management.
 // Runs execute against a session and represent a discrete invocation of the
@@ -248,6 +266,16 @@ IREE_EMBED_EXPORTED void ireeCompilerInvocationSetDumpCompilationPhasesTo(
 IREE_EMBED_EXPORTED void
 ireeCompilerInvocationSetVerifyIR(iree_compiler_invocation_t *inv, bool enable);
 
+// Enables/disables collection of compile-time statistics. When enabled the
+// wall time and peak memory usage at the end of each compilation phase, the
+// size of constant data held by the module and the time spent in each pass
+// aggregated over all operations it ran on are printed to stderr after each
+// pipeline run. Defaults to disabled.
+// Available since: 1.5
+IREE_EMBED_EXPORTED void
+ireeCompilerInvocationSetCompileStatistics(iree_compiler_invocation_t *inv,
+                                           bool enable);
+
 // Runs a compilation pipeline.
 // Returns false and emits diagnostics on failure.
 enum iree_compiler_pipeline_t {
@@ -211,6 +211,16 @@ void ireeCompilerSessionGetFlags(
                                        userData);
 }
 
+iree_compiler_error_t *
+ireeCompilerSessionPrepare(iree_compiler_session_t *session) {
+  assertLoaded();
+  if (__ireeCompilerSessionPrepare) {
+    return __ireeCompilerSessionPrepare(session);
+  }
+  // Older compilers prepare lazily on first use.
+  return nullptr;
+}
+
 iree_compiler_invocation_t *
 ireeCompilerInvocationCreate(iree_compiler_session_t *session) {
   return __ireeCompilerInvocationCreate(session);
@@ -268,6 +278,13 @@ void ireeCompilerInvocationSetVerifyIR(iree_compiler_invocation_t *run,
   __ireeCompilerInvocationSetVerifyIR(run, enable);
 }
 
+void ireeCompilerInvocationSetCompileStatistics(iree_compiler_invocation_t *inv,
+                                                bool enable) {
+  if (__ireeCompilerInvocationSetCompileStatistics) {
+    __ireeCompilerInvocationSetCompileStatistics(inv, enable);
+  }
+}
+
 bool ireeCompilerInvocationPipeline(iree_compiler_invocation_t *run,
                                     enum iree_compiler_pipeline_t pipeline) {
   return __ireeCompilerInvocationPipeline(run, pipeline);
@@ -100,6 +100,7 @@ def _init_dylib():
         c_void_p,
         [c_void_p, c_int, c_void_p],
     )
+    _setsig(_dylib.ireeCompilerSessionPrepare, c_void_p, [c_void_p])
     # From mlir_interop.h.
     _setsig(
         _dylib.ireeCompilerSessionStealContext,
@@ -231,6 +232,11 @@ class Session:
             _dylib.ireeCompilerSessionSetFlags(self._session_p, len(argv), argv)
         )
 
+    def prepare(self):
+        """Prepares the session for reuse by many (possibly concurrent)
+        invocations. Should be called once after setting flags."""
+        _handle_error(_dylib.ireeCompilerSessionPrepare(self._session_p))
+
 
 class Output:
     """Wraps an iree_compiler_output_t."""
@@ -0,0 +1,371 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+"""Tunes the tile sizes of dispatches by benchmarking candidate configurations.
+
+Takes the benchmark files produced by `--iree-hal-dump-executable-benchmarks-to`
+and, for each dispatch, compiles and runs candidate tile sizes derived from
+the default configuration. The measurements are written as a dispatch profile
+that is used when compiling the original program with
+`--iree-codegen-dispatch-profile=`:
+
+  iree-compile model.mlir --iree-hal-target-backends=llvm-cpu \\
+      --iree-hal-dump-executable-benchmarks-to=/tmp/benchmarks -o /dev/null
+  iree-tune-dispatches /tmp/benchmarks -o profile.json \\
+      --compile-arg=--iree-hal-target-backends=llvm-cpu --device=local-task
+  iree-compile model.mlir --iree-hal-target-backends=llvm-cpu \\
+      --iree-codegen-dispatch-profile=profile.json -o model.vmfb
+
+Each candidate is compiled with a profile holding only that candidate, which
+the compiler uses as long as it is compatible with the default
+configuration. Candidates only vary the distribution (first level) tile
+sizes and keep the remaining levels as chosen by the compiler.
+"""
+
+import argparse
+import glob
+import itertools
+import json
+import logging
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+from dataclasses import dataclass, field
+from typing import Dict, List, Optional, Sequence
+
+from .. import binaries
+
+logger = logging.getLogger(__name__)
+
+_EXPORT_RE = re.compile(r"hal\.executable\.export\s+(?:public\s+)?@([\w$.-]+)")
+_LOWERING_CONFIG_RE = re.compile(
+    r"#iree_codegen\.lowering_config<tile_sizes\s*=\s*(\[[0-9,\s\[\]]*\])"
+)
+_BENCHMARK_FUNC_RE = re.compile(r"util\.func\s+public\s+@([\w$.-]+)\(")
+
+
+@dataclass
+class DispatchConfig:
+    """Default configuration of a dispatch as chosen by the compiler."""
+
+    export_name: str
+    tile_sizes: List[List[int]]
+
+
+@dataclass
+class Measurement:
+    tile_sizes: List[List[int]]
+    time_us: float
+
+
+@dataclass
+class TuningResult:
+    export_name: str
+    measurements: List[Measurement] = field(default_factory=list)
+
+
+def parse_dispatch_configs(ir_text: str) -> List[DispatchConfig]:
+    """Returns the configuration of each export in configured executable IR.
+
+    The first lowering config following an export is assumed to be that of its
+    root op; exports without a config with static tile sizes are skipped.
+    """
+    configs = []
+    for export_match in _EXPORT_RE.finditer(ir_text):
+        export_name = export_match.group(1)
+        func_match = re.compile(
+            r"func\.func\s+@" + re.escape(export_name) + r"\("
+        ).search(ir_text, export_match.end())
+        if not func_match:
+            continue
+        # Only look within the function body, up to the next function.
+        next_func = ir_text.find("func.func", func_match.end())
+        body = ir_text[func_match.end() : next_func if next_func >= 0 else None]
+        config_match = _LOWERING_CONFIG_RE.search(body)
+        if not config_match:
+            continue
+        try:
+            tile_sizes = json.loads(config_match.group(1))
+        except ValueError:
+            continue
+        if not all(
+            isinstance(level, list) and all(isinstance(t, int) for t in level)
+            for level in tile_sizes
+        ):
+            continue
+        configs.append(DispatchConfig(export_name, tile_sizes))
+    return configs
+
+
+def _get_dim_choices(tile_size: int, inner_tile_size: int) -> List[int]:
+    if tile_size == 0:
+        return [0]
+    choices = [tile_size]
+    half = tile_size // 2
+    if tile_size % 2 == 0 and (inner_tile_size == 0 or half % inner_tile_size == 0):
+        choices.append(half)
+    choices.append(tile_size * 2)
+    return choices
+
+
+def generate_candidates(
+    default_tile_sizes: List[List[int]], max_candidates: int
+) -> List[List[List[int]]]:
+    """Returns candidate tile sizes derived from |default_tile_sizes|.
+
+    Distribution tile sizes are halved (when they remain a multiple of the
+    next level tile size) and doubled per dimension. The default configuration
+    is always the first candidate.
+    """
+    if not default_tile_sizes:
+        return []
+    distribution_sizes = default_tile_sizes[0]
+    inner_sizes = (
+        default_tile_sizes[1]
+        if len(default_tile_sizes) > 1
+        else [0] * len(distribution_sizes)
+    )
+    dim_choices = [
+        _get_dim_choices(t, inner_sizes[i] if i < len(inner_sizes) else 0)
+        for i, t in enumerate(distribution_sizes)
+    ]
+    candidates = []
+    for sizes in itertools.product(*dim_choices):
+        candidates.append([list(sizes)] + [list(l) for l in default_tile_sizes[1:]])
+        if len(candidates) >= max_candidates:
+            break
+    return candidates
+
+
+def parse_benchmark_times(
+    benchmark_json: str, function_prefix: str
+) -> Optional[float]:
+    """Returns the total mean time in microseconds of the benchmarks of the
+    functions starting with |function_prefix| in google benchmark JSON output.
+    """
+    unit_scales = {"ns": 1e-3, "us": 1.0, "ms": 1e3, "s": 1e6}
+    benchmarks = json.loads(benchmark_json).get("benchmarks", [])
+    # With repetitions only the mean aggregate is used.
+    has_aggregates = any(b.get("run_type") == "aggregate" for b in benchmarks)
+    total_us = 0.0
+    found = False
+    for benchmark in benchmarks:
+        name = benchmark.get("run_name", benchmark.get("name", ""))
+        if not name.startswith("BM_" + function_prefix):
+            continue
+        if has_aggregates and benchmark.get("aggregate_name") != "mean":
+            continue
+        scale = unit_scales.get(benchmark.get("time_unit", "ns"), 1e-3)
+        total_us += benchmark["real_time"] * scale
+        found = True
+    return total_us if found else None
+
+
+def make_profile(results: Sequence[TuningResult]) -> Dict:
+    """Returns a dispatch profile in the format of
+    `--iree-codegen-dispatch-profile=`."""
+    dispatches = {}
+    for result in results:
+        dispatches[result.export_name] = {
+            "variants": [
+                {"tile_sizes": m.tile_sizes, "time_us": m.time_us}
+                for m in result.measurements
+            ]
+        }
+    return {"dispatches": dispatches}
+
+
+###############################################################################
+# Tuning
+###############################################################################
+
+
+class Tuner:
+    def __init__(self, args):
+        self.args = args
+        self.compile_tool = args.compile_tool or binaries.find_tool("iree-compile")
+        self.benchmark_tool = args.benchmark_tool or shutil.which(
+            "iree-benchmark-module"
+        )
+        if not self.benchmark_tool:
+            raise RuntimeError(
+                "iree-benchmark-module not found; pass --benchmark-tool"
+            )
+        self.work_dir = tempfile.mkdtemp(prefix="iree-tune-")
+
+    def _compile(self, input_file: str, extra_args: List[str]) -> bytes:
+        command = [self.compile_tool, input_file] + self.args.compile_args + extra_args
+        return binaries.invoke_immediate(command)
+
+    def _benchmark(self, vmfb_path: str, function_prefix: str) -> Optional[float]:
+        command = [
+            self.benchmark_tool,
+            f"--module={vmfb_path}",
+            f"--device={self.args.device}",
+            f"--batch_size={self.args.batch_size}",
+            f"--benchmark_repetitions={self.args.repetitions}",
+            "--benchmark_format=json",
+        ]
+        process = subprocess.run(command, capture_output=True)
+        if process.returncode != 0:
+            logger.warning(
+                "benchmark failed: %s", process.stderr.decode(errors="replace")
+            )
+            return None
+        return parse_benchmark_times(process.stdout.decode(), function_prefix)
+
+    def tune_file(self, benchmark_file: str) -> List[TuningResult]:
+        ir_text = self._compile(
+            benchmark_file, ["--compile-to=executable-configurations"]
+        ).decode()
+        benchmark_funcs = _BENCHMARK_FUNC_RE.findall(ir_text)
+        results = []
+        for config in parse_dispatch_configs(ir_text):
+            # Benchmark functions are named <executable>_<variant>_<export>
+            # optionally suffixed with the workload.
+            function_prefix = next(
+                (
+                    f[: f.index(config.export_name) + len(config.export_name)]
+                    for f in benchmark_funcs
+                    if config.export_name in f
+                ),
+                None,
+            )
+            if function_prefix is None:
+                continue
+            results.append(self._tune_dispatch(benchmark_file, config, function_prefix))
+        return results
+
+    def _tune_dispatch(
+        self, benchmark_file: str, config: DispatchConfig, function_prefix: str
+    ) -> TuningResult:
+        result = TuningResult(config.export_name)
+        candidates = generate_candidates(config.tile_sizes, self.args.max_candidates)
+        for i, tile_sizes in enumerate(candidates):
+            profile_path = os.path.join(self.work_dir, "candidate.json")
+            vmfb_path = os.path.join(self.work_dir, "candidate.vmfb")
+            candidate_result = TuningResult(config.export_name)
+            candidate_result.measurements.append(Measurement(tile_sizes, 0.0))
+            with open(profile_path, "w") as f:
+                json.dump(make_profile([candidate_result]), f)
+            try:
+                self._compile(
+                    benchmark_file,
+                    [
+                        f"--iree-codegen-dispatch-profile={profile_path}",
+                        "-o",
+                        vmfb_path,
+                    ],
+                )
+            except binaries.CompilerToolError as e:
+                logger.warning("candidate %s failed to compile: %s", tile_sizes, e)
+                continue
+            time_us = self._benchmark(vmfb_path, function_prefix)
+            if time_us is None:
+                continue
+            logger.info(
+                "%s candidate %d/%d %s: %.3fus",
+                config.export_name,
+                i + 1,
+                len(candidates),
+                tile_sizes,
+                time_us,
+            )
+            result.measurements.append(Measurement(tile_sizes, time_us))
+        return result
+
+    def cleanup(self):
+        shutil.rmtree(self.work_dir, ignore_errors=True)
+
+
+###############################################################################
+# CLI handling
+###############################################################################
+
+
+def parse_arguments(argv=None):
+    parser = argparse.ArgumentParser(
+        description="IREE dispatch tile size tuner",
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        epilog=__doc__,
+    )
+    parser.add_argument(
+        "inputs",
+        nargs="+",
+        help="Benchmark files or directories of benchmark files produced by "
+        "--iree-hal-dump-executable-benchmarks-to",
+    )
+    parser.add_argument(
+        "-o", required=True, dest="output_file", help="Output profile JSON file"
+    )
+    parser.add_argument(
+        "--compile-arg",
+        action="append",
+        default=[],
+        dest="compile_args",
+        help="Additional argument passed to iree-compile (repeatable)",
+    )
+    parser.add_argument(
+        "--device", default="local-task", help="Device to benchmark on"
+    )
+    parser.add_argument(
+        "--max-candidates",
+        type=int,
+        default=16,
+        help="Maximum number of candidates to benchmark per dispatch",
+    )
+    parser.add_argument(
+        "--batch-size",
+        type=int,
+        default=16,
+        help="Number of dispatches per benchmark iteration",
+    )
+    parser.add_argument(
+        "--repetitions", type=int, default=3, help="Benchmark repetitions"
+    )
+    parser.add_argument("--compile-tool", help="Path to iree-compile")
+    parser.add_argument("--benchmark-tool", help="Path to iree-benchmark-module")
+    parser.add_argument("--verbose", "-v", action="store_true")
+    return parser.parse_args(argv)
+
+
+def _expand_inputs(inputs: List[str]) -> List[str]:
+    files = []
+    for path in inputs:
+        if os.path.isdir(path):
+            files.extend(sorted(glob.glob(os.path.join(path, "*_benchmark.mlir"))))
+        else:
+            files.append(path)
+    return files
+
+
+def main(args) -> int:
+    logging.basicConfig(level=logging.INFO if args.verbose else logging.WARNING)
+    tuner = Tuner(args)
+    results = []
+    try:
+        for benchmark_file in _expand_inputs(args.inputs):
+            results.extend(tuner.tune_file(benchmark_file))
+    finally:
+        tuner.cleanup()
+    results = [r for r in results if r.measurements]
+    with open(args.output_file, "w") as f:
+        json.dump(make_profile(results), f, indent=2)
+    for result in results:
+        best = min(result.measurements, key=lambda m: m.time_us)
+        print(f"{result.export_name}: {best.tile_sizes} ({best.time_us:.3f}us)")
+    return 0
+
+
+def _cli_main():
+    sys.exit(main(parse_arguments()))
+
+
+if __name__ == "__main__":
+    _cli_main()
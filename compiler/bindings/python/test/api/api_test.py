@@ -15,6 +15,7 @@ else:
     import os
     from pathlib import Path
     import tempfile
+    import threading
     import unittest
 
     from iree.compiler.api import *
@@ -131,6 +132,45 @@ else:
             inv.output_vm_bytecode(out)
             out.close()
 
+        def testConcurrentPreparedInvocations(self):
+            session = Session()
+            session.set_flags("--iree-hal-target-backends=vmvx")
+            session.prepare()
+            results = [None] * 4
+
+            def compile(index):
+                inv = session.invocation()
+                source = Source.wrap_buffer(
+                    session,
+                    f"""
+                    builtin.module {{
+                        func.func @main(%arg0: tensor<{index + 1}xf32>) ->
+                            tensor<{index + 1}xf32> {{
+                            %0 = arith.addf %arg0, %arg0 : tensor<{index + 1}xf32>
+                            return %0 : tensor<{index + 1}xf32>
+                        }}
+                    }}
+                    """.encode(),
+                )
+                if not inv.parse_source(source) or not inv.execute():
+                    return
+                out = Output.open_membuffer()
+                inv.output_vm_bytecode(out)
+                results[index] = len(bytes(out.map_memory()))
+                out.close()
+
+            threads = [
+                threading.Thread(target=compile, args=(i,))
+                for i in range(len(results))
+            ]
+            for thread in threads:
+                thread.start()
+            for thread in threads:
+                thread.join()
+            for result in results:
+                self.assertIsNotNone(result)
+                self.assertGreater(result, 0)
+
     class DlOutputTest(unittest.TestCase):
         def testOpenMembuffer(self):
             out = Output.open_membuffer()
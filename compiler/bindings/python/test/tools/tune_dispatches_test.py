@@ -0,0 +1,100 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from iree.compiler.tools.tune_dispatches import __main__
+
+import json
+import unittest
+
+_CONFIGURED_IR = """
+hal.executable private @ex {
+  hal.executable.variant public @embedded_elf_x86_64 target(#target) {
+    hal.executable.export public @matmul ordinal(0) layout(#layout)
+    hal.executable.export public @fill ordinal(1) layout(#layout)
+    builtin.module {
+      func.func @matmul() {
+        %0 = linalg.matmul {lowering_config = #iree_codegen.lowering_config<tile_sizes = [[64, 64, 0], [8, 32, 0], [0, 0, 16]]>} ins(%a, %b) outs(%c)
+        return
+      }
+      func.func @fill() {
+        return
+      }
+    }
+  }
+}
+"""
+
+
+class TuneDispatchesTest(unittest.TestCase):
+    def testParseDispatchConfigs(self):
+        configs = __main__.parse_dispatch_configs(_CONFIGURED_IR)
+        self.assertEqual(len(configs), 1)
+        self.assertEqual(configs[0].export_name, "matmul")
+        self.assertEqual(configs[0].tile_sizes, [[64, 64, 0], [8, 32, 0], [0, 0, 16]])
+
+    def testGenerateCandidates(self):
+        default = [[64, 16, 0], [8, 16, 0], [0, 0, 16]]
+        candidates = __main__.generate_candidates(default, max_candidates=16)
+        self.assertEqual(candidates[0], default)
+        # 16 cannot be halved as it would not be a multiple of the inner tile.
+        self.assertEqual(len(candidates), 3 * 2)
+        for candidate in candidates:
+            self.assertEqual(candidate[1:], default[1:])
+            self.assertEqual(candidate[0][2], 0)
+        self.assertIn([[32, 32, 0], [8, 16, 0], [0, 0, 16]], candidates)
+        self.assertEqual(len(__main__.generate_candidates(default, 2)), 2)
+
+    def testParseBenchmarkTimes(self):
+        output = json.dumps(
+            {
+                "benchmarks": [
+                    {
+                        "run_name": "BM_ex_embedded_elf_x86_64_matmul_4x4",
+                        "run_type": "aggregate",
+                        "aggregate_name": "mean",
+                        "real_time": 2000.0,
+                        "time_unit": "ns",
+                    },
+                    {
+                        "run_name": "BM_ex_embedded_elf_x86_64_matmul_4x4",
+                        "run_type": "aggregate",
+                        "aggregate_name": "stddev",
+                        "real_time": 10.0,
+                        "time_unit": "ns",
+                    },
+                    {
+                        "run_name": "BM_ex_embedded_elf_x86_64_fill",
+                        "run_type": "aggregate",
+                        "aggregate_name": "mean",
+                        "real_time": 1.0,
+                        "time_unit": "ms",
+                    },
+                ]
+            }
+        )
+        self.assertAlmostEqual(
+            __main__.parse_benchmark_times(output, "ex_embedded_elf_x86_64_matmul"),
+            2.0,
+        )
+        self.assertIsNone(__main__.parse_benchmark_times(output, "other"))
+
+    def testMakeProfile(self):
+        result = __main__.TuningResult("matmul")
+        result.measurements.append(__main__.Measurement([[64, 64, 0]], 12.5))
+        self.assertEqual(
+            __main__.make_profile([result]),
+            {
+                "dispatches": {
+                    "matmul": {
+                        "variants": [{"tile_sizes": [[64, 64, 0]], "time_us": 12.5}]
+                    }
+                }
+            },
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
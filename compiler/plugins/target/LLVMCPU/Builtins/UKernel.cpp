@@ -16,6 +16,13 @@ namespace mlir::iree_compiler::IREE::HAL {
 
 // Note: even if the llvm::Expected status is successful, the enclosed pointer
 // may still be null, indicating that the file was not found.
+//
+// The module is loaded lazily: only the function bodies that the linker pulls
+// in with llvm::Linker::LinkOnlyNeeded are ever parsed. The ukernel bitcode is
+// large relative to what any single executable uses and is loaded into a new
+// LLVMContext for each executable, so this keeps it off the critical path of
+// small (re)compilations. The embedded file data lives for the process
+// lifetime and can back the lazy module directly.
 static llvm::Expected<std::unique_ptr<llvm::Module>>
 loadUKernelBitcodeFile(StringRef filename, llvm::LLVMContext &context) {
   const iree_file_toc_t *file_start = iree_ukernel_bitcode_create();
@@ -24,7 +31,7 @@ loadUKernelBitcodeFile(StringRef filename, llvm::LLVMContext &context) {
     if (filename == file->name) {
       llvm::MemoryBufferRef bitcodeBufferRef(
           llvm::StringRef(file->data, file->size), file->name);
-      return llvm::parseBitcodeFile(bitcodeBufferRef, context);
+      return llvm::getLazyBitcodeModule(bitcodeBufferRef, context);
     }
   }
 
@@ -36,6 +43,14 @@ loadUKernelBitcodeFile(StringRef filename, llvm::LLVMContext &context) {
 llvm::Expected<std::unique_ptr<llvm::Module>>
 loadUKernelBitcode(llvm::TargetMachine *targetMachine,
                    llvm::LLVMContext &context) {
+  // A WebAssembly module containing any SIMD128 instruction fails validation
+  // on engines without SIMD128, even if the instruction is never executed, so
+  // the wasm ukernels (which are all SIMD128 code) are only linked in when the
+  // target enables it.
+  if (targetMachine->getTargetTriple().isWasm() &&
+      !targetMachine->getTargetFeatureString().contains("+simd128")) {
+    return std::unique_ptr<llvm::Module>();
+  }
   const char *archName =
       getIreeArchNameForTargetTriple(targetMachine->getTargetTriple());
   std::string filename = std::string("ukernel_bitcode_") + archName + ".bc";
@@ -55,6 +70,7 @@ loadUKernelBitcode(llvm::TargetMachine *targetMachine,
   // combination of data types, a specific SIMD ISA variant, etc. Then all the
   // unused code paths can get DCE'd. That's why failure to inline a ukernel
   // can result in a large penalty in both performance and code size.
+  // Function attributes are available without materializing bodies.
   for (auto &func : module.get()->functions()) {
     func.addFnAttr(llvm::Attribute::AlwaysInline);
   }
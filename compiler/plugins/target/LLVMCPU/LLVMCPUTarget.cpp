@@ -32,6 +32,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "mlir/Dialect/ArmNeon/ArmNeonDialect.h"
 #include "mlir/Dialect/ArmSME/IR/ArmSME.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
@@ -596,16 +597,50 @@ public:
                            variantOp.getName(), ".optimized", *llvmModule);
     }
 
+    // Dump assembly listing after optimization, which is just a textual
+    // representation of the object file we generate below. This happens prior
+    // to splitting the module as splitting renames internal symbols.
+    if (!options.dumpIntermediatesPath.empty()) {
+      std::string asmData;
+      if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
+                                      llvm::CodeGenFileType::AssemblyFile,
+                                      &asmData))) {
+        return variantOp.emitError()
+               << "failed to compile LLVM-IR module to an assembly file";
+      }
+      dumpDataToPath(options.dumpIntermediatesPath, options.dumpBaseName,
+                     variantOp.getName(), ".s", asmData);
+    }
+
     SmallVector<Artifact> objectFiles;
 
-    // Emit the base object file containing the bulk of our code.
-    // This must come first such that we have the proper library linking order.
-    {
-      // NOTE: today we just use a single object file, however if we wanted to
-      // scale code generation and linking we'd want to generate one per
-      // function (or something like that). A single object file is also
-      // instrumental to static library generation (which only supports one
-      // object file per library).
+    // Emit the base object files containing the bulk of our code.
+    // These must come first such that we have the proper library linking order.
+    // Static libraries only support a single object file per library.
+    // Dynamic libraries split the module into partitions that are compiled in
+    // parallel as code generation of the linked module otherwise dominates
+    // compile time when all executables have been linked together.
+    unsigned codegenPartitions =
+        target.linkStatic ? 1
+                          : getCodegenPartitionCount(variantOp.getContext(),
+                                                     *llvmModule);
+    if (codegenPartitions > 1) {
+      SmallVector<std::string> objectDatas(codegenPartitions);
+      runSplitEmitObjFilePasses(target, llvmModule.get(), objectDatas);
+      for (auto [index, objectData] : llvm::enumerate(objectDatas)) {
+        std::string suffix = "." + std::to_string(index);
+        if (!options.dumpIntermediatesPath.empty()) {
+          dumpDataToPath(options.dumpIntermediatesPath, options.dumpBaseName,
+                         variantOp.getName(), suffix + ".o", objectData);
+        }
+        auto objectFile = Artifact::createTemporary(libraryName + suffix, "o");
+        auto &os = objectFile.outputFile->os();
+        os << objectData;
+        os.flush();
+        os.close();
+        objectFiles.push_back(std::move(objectFile));
+      }
+    } else {
       std::string objectData;
       if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
                                       llvm::CodeGenFileType::ObjectFile,
@@ -625,20 +660,6 @@ public:
       objectFiles.push_back(std::move(objectFile));
     }
 
-    // Dump assembly listing after optimization, which is just a textual
-    // representation of the object file we generate below.
-    if (!options.dumpIntermediatesPath.empty()) {
-      std::string asmData;
-      if (failed(runEmitObjFilePasses(targetMachine.get(), llvmModule.get(),
-                                      llvm::CodeGenFileType::AssemblyFile,
-                                      &asmData))) {
-        return variantOp.emitError()
-               << "failed to compile LLVM-IR module to an assembly file";
-      }
-      dumpDataToPath(options.dumpIntermediatesPath, options.dumpBaseName,
-                     variantOp.getName(), ".s", asmData);
-    }
-
     // If custom object files were specified then add those to our artifact set.
     // These will either be combined into the resulting static library or linked
     // statically into the resulting dynamic library.
@@ -677,6 +698,24 @@ public:
     }
   }
 
+  // Returns the number of partitions |module| should be split into for
+  // parallel code generation. Each partition is compiled on its own thread and
+  // there is no benefit to having more partitions than defined functions.
+  unsigned getCodegenPartitionCount(MLIRContext *context,
+                                    const llvm::Module &module) const {
+    if (!context->isMultithreadingEnabled())
+      return 1;
+    unsigned threadCount = defaultOptions_.codegenThreads;
+    if (threadCount == 0) {
+      threadCount = llvm::hardware_concurrency().compute_thread_count();
+    }
+    unsigned definedFunctionCount =
+        llvm::count_if(module, [](const llvm::Function &func) {
+          return !func.isDeclaration();
+        });
+    return std::max(1u, std::min(threadCount, definedFunctionCount));
+  }
+
   LogicalResult serializeStaticLibraryExecutable(
       const SerializationOptions &options, const LLVMTarget &target,
       IREE::HAL::ExecutableVariantOp variantOp, OpBuilder &executableBuilder,
@@ -7,6 +7,7 @@
 #include "compiler/plugins/target/LLVMCPU/LLVMIRPasses.h"
 
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/CodeGen/ParallelCG.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Module.h"
@@ -19,6 +20,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Host.h"
+#include "llvm/Transforms/IPO/ConstantMerge.h"
 #include "llvm/Transforms/Instrumentation/AddressSanitizer.h"
 #include "llvm/Transforms/Instrumentation/ThreadSanitizer.h"
 
@@ -50,6 +52,17 @@ LogicalResult runLLVMIRPasses(const LLVMTarget &target,
   passBuilder.crossRegisterProxies(loopAnalysisManager, functionAnalysisManager,
                                    cGSCCAnalysisManager, moduleAnalysisManager);
 
+  // Linked executables carry a copy of any constant tables (lookup tables,
+  // polynomial coefficients, etc) from each dispatch and ukernel that uses
+  // them. Fold identical constants last so that those only made identical by
+  // late passes (such as MergeFunctions when enabled) are folded as well and
+  // the library only has one copy of each to load and relocate.
+  passBuilder.registerOptimizerLastEPCallback(
+      [](llvm::ModulePassManager &modulePassManager,
+         llvm::OptimizationLevel Level) {
+        modulePassManager.addPass(llvm::ConstantMergePass());
+      });
+
   switch (target.sanitizerKind) {
   case SanitizerKind::kNone:
     break;
@@ -118,4 +131,26 @@ LogicalResult runEmitObjFilePasses(llvm::TargetMachine *machine,
   return success();
 }
 
+void runSplitEmitObjFilePasses(const LLVMTarget &target, llvm::Module *module,
+                               MutableArrayRef<std::string> objData) {
+  SmallVector<SmallVector<char, 0>> streamBuffers(objData.size());
+  SmallVector<std::unique_ptr<llvm::raw_svector_ostream>> ostreams;
+  SmallVector<llvm::raw_pwrite_stream *> ostreamPtrs;
+  for (auto &streamBuffer : streamBuffers) {
+    ostreams.push_back(
+        std::make_unique<llvm::raw_svector_ostream>(streamBuffer));
+    ostreamPtrs.push_back(ostreams.back().get());
+  }
+
+  // Each partition gets its own target machine as they are not thread-safe.
+  llvm::splitCodeGen(
+      *module, ostreamPtrs, /*BCOSs=*/{},
+      [&]() { return createTargetMachine(target); },
+      llvm::CodeGenFileType::ObjectFile);
+
+  for (auto [streamBuffer, data] : llvm::zip_equal(streamBuffers, objData)) {
+    data = std::string(streamBuffer.begin(), streamBuffer.end());
+  }
+}
+
 } // namespace mlir::iree_compiler::IREE::HAL
@@ -27,6 +27,16 @@ LogicalResult runEmitObjFilePasses(llvm::TargetMachine *machine,
                                    llvm::CodeGenFileType fileType,
                                    std::string *objData);
 
+// Emits one object file per entry in |objData| for |target| by splitting
+// |module| into partitions that are each compiled on their own thread with an
+// isolated LLVMContext. Linking all of the objects produces the same result as
+// the single object emitted by runEmitObjFilePasses. Internal symbols in
+// |module| are promoted to hidden visibility so that partitions can reference
+// each other. The target machine for |target| must be known to be creatable as
+// failures are fatal.
+void runSplitEmitObjFilePasses(const LLVMTarget &target, llvm::Module *module,
+                               MutableArrayRef<std::string> objData);
+
 } // namespace mlir::iree_compiler::IREE::HAL
 
 #endif // IREE_COMPILER_PLUGINS_TARGET_LLVMCPU_LLVMIRPASSES_H_
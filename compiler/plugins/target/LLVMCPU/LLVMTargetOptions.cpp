@@ -112,6 +112,9 @@ LLVMTarget::LLVMTarget() {
   // LLVM SLP Auto vectorizer.
   pipelineTuningOptions.SLPVectorization = DEFAULT_SLP_VECTORIZATION;
 
+  // Merging of identical functions and constants across linked executables.
+  pipelineTuningOptions.MergeFunctions = DEFAULT_MERGE_FUNCTIONS;
+
   // LLVM optimization levels.
   // TODO(benvanik): add an option for this.
   optimizerOptLevel = llvm::OptimizationLevel::O2;
@@ -185,6 +188,7 @@ void LLVMTarget::print(llvm::raw_ostream &os) const {
      << "    LoopUnrolling=" << pipelineTuningOptions.LoopUnrolling << "\n"
      << "    SLPVectorization=" << pipelineTuningOptions.SLPVectorization
      << "\n"
+     << "    MergeFunctions=" << pipelineTuningOptions.MergeFunctions << "\n"
      << "  }, llvmTargetOptions={\n"
      << "    FloatABIType=" << static_cast<int>(llvmTargetOptions.FloatABIType)
      << "\n"
@@ -249,6 +253,8 @@ void LLVMTarget::storeToConfigAttrs(MLIRContext *context,
     addBool("loop_unrolling", pipelineTuningOptions.LoopUnrolling);
   if (pipelineTuningOptions.SLPVectorization != DEFAULT_SLP_VECTORIZATION)
     addBool("slp_vectorization", pipelineTuningOptions.SLPVectorization);
+  if (pipelineTuningOptions.MergeFunctions != DEFAULT_MERGE_FUNCTIONS)
+    addBool("merge_functions", pipelineTuningOptions.MergeFunctions);
   if (!llvmTargetOptions.MCOptions.ABIName.empty())
     addString("target_abi", llvmTargetOptions.MCOptions.ABIName);
   if (llvmTargetOptions.FloatABIType != DEFAULT_FLOAT_ABI) {
@@ -376,6 +382,8 @@ LLVMTarget::loadFromConfigAttr(Location loc, DictionaryAttr config,
       getBool("loop_unrolling", target.pipelineTuningOptions.LoopUnrolling);
   target.pipelineTuningOptions.SLPVectorization = getBool(
       "slp_vectorization", target.pipelineTuningOptions.SLPVectorization);
+  target.pipelineTuningOptions.MergeFunctions =
+      getBool("merge_functions", target.pipelineTuningOptions.MergeFunctions);
   auto targetAbi = getOptionalString("target_abi");
   if (targetAbi)
     target.llvmTargetOptions.MCOptions.ABIName = *targetAbi;
@@ -576,6 +584,13 @@ void LLVMCPUTargetCLOptions::bindOptions(OptionsBinder &binder) {
       "iree-llvmcpu-keep-linker-artifacts", keepLinkerArtifacts,
       llvm::cl::cat(category),
       llvm::cl::desc("Keep LLVM linker target artifacts (.so/.dll/etc)"));
+  binder.opt<unsigned>(
+      "iree-llvmcpu-codegen-threads", codegenThreads, llvm::cl::cat(category),
+      llvm::cl::desc(
+          "Maximum number of threads used to generate code for each "
+          "executable library by splitting it into multiple object files "
+          "(0 for hardware concurrency, 1 to disable splitting). Ignored when "
+          "linking statically or with --mlir-disable-threading."));
 
   // Default device options.
   binder.opt<std::string>("iree-llvmcpu-target-triple", targetTriple,
@@ -621,6 +636,13 @@ void LLVMCPUTargetCLOptions::bindOptions(OptionsBinder &binder) {
   binder.opt<bool>("iree-llvmcpu-slp-vectorization", llvmSLPVectorization,
                    llvm::cl::cat(category),
                    llvm::cl::desc("Enable LLVM SLP Vectorization opt"));
+  binder.opt<bool>(
+      "iree-llvmcpu-merge-functions", llvmMergeFunctions,
+      llvm::cl::cat(category),
+      llvm::cl::desc("Merge identical functions (such as those duplicated "
+                     "across linked executables and ukernels) to reduce the "
+                     "size of the produced library; identical constants are "
+                     "always merged"));
   binder.opt<SanitizerKind>(
       "iree-llvmcpu-sanitize", sanitizerKind, llvm::cl::cat(category),
       llvm::cl::desc("Apply LLVM sanitize feature"),
@@ -667,6 +689,7 @@ LLVMTargetOptions LLVMCPUTargetCLOptions::getTargetOptions() {
   targetOptions.embeddedLinkerPath = embeddedLinkerPath;
   targetOptions.wasmLinkerPath = wasmLinkerPath;
   targetOptions.keepLinkerArtifacts = keepLinkerArtifacts;
+  targetOptions.codegenThreads = codegenThreads;
 
   if (targetTriple.empty()) {
     targetTriple = llvm::sys::getProcessTriple();
@@ -688,6 +711,7 @@ LLVMTargetOptions LLVMCPUTargetCLOptions::getTargetOptions() {
   target.pipelineTuningOptions.LoopVectorization = llvmLoopVectorization;
   target.pipelineTuningOptions.LoopUnrolling = llvmLoopUnrolling;
   target.pipelineTuningOptions.SLPVectorization = llvmSLPVectorization;
+  target.pipelineTuningOptions.MergeFunctions = llvmMergeFunctions;
   target.sanitizerKind = sanitizerKind;
   target.llvmTargetOptions.MCOptions.ABIName = targetABI;
   target.llvmTargetOptions.FloatABIType = targetFloatABI;
@@ -40,6 +40,7 @@ struct LLVMTarget {
   static constexpr bool DEFAULT_LOOP_VECTORIZATION = false;
   static constexpr bool DEFAULT_LOOP_UNROLLING = false;
   static constexpr bool DEFAULT_SLP_VECTORIZATION = false;
+  static constexpr bool DEFAULT_MERGE_FUNCTIONS = false;
   static constexpr llvm::FloatABI::ABIType DEFAULT_FLOAT_ABI =
       llvm::FloatABI::ABIType::Hard;
   static constexpr const char *DEFAULT_ENABLE_UKERNELS = "default";
@@ -160,6 +161,11 @@ struct LLVMTargetOptions {
 
   // True to keep linker artifacts for debugging.
   bool keepLinkerArtifacts = false;
+
+  // Maximum number of threads used to generate code for each dynamic library.
+  // 0 selects the hardware concurrency. Code generation is serialized if
+  // the MLIRContext has multithreading disabled.
+  unsigned codegenThreads = 0;
 };
 
 // Creates target machine form target options.
@@ -174,6 +180,7 @@ struct LLVMCPUTargetCLOptions {
   std::string embeddedLinkerPath = "";
   std::string wasmLinkerPath = "";
   bool keepLinkerArtifacts = false;
+  unsigned codegenThreads = 0;
 
   // Default device options.
   std::string targetTriple = "";
@@ -187,6 +194,7 @@ struct LLVMCPUTargetCLOptions {
   bool llvmLoopVectorization = LLVMTarget::DEFAULT_LOOP_VECTORIZATION;
   bool llvmLoopUnrolling = LLVMTarget::DEFAULT_LOOP_UNROLLING;
   bool llvmSLPVectorization = LLVMTarget::DEFAULT_SLP_VECTORIZATION;
+  bool llvmMergeFunctions = LLVMTarget::DEFAULT_MERGE_FUNCTIONS;
   SanitizerKind sanitizerKind = LLVMTarget::DEFAULT_SANITIZER_KIND;
   std::string targetABI = "";
   llvm::FloatABI::ABIType targetFloatABI = LLVMTarget::DEFAULT_FLOAT_ABI;
@@ -0,0 +1,76 @@
+// Tests that identical constants from executables linked into one embedded
+// ELF library are emitted once.
+// RUN: rm -rf %t
+// RUN: iree-opt --iree-stream-transformation-pipeline --iree-hal-transformation-pipeline --iree-llvmcpu-link-embedded=true --iree-hal-dump-executable-intermediates-to=%t %s | FileCheck %s
+// RUN: cat %t/*.optimized.ll | FileCheck %s --check-prefix=IR
+
+module attributes {
+  hal.device.targets = [
+    #hal.device.target<"llvm-cpu", [
+      #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", { native_vector_size = 16 : index }>
+    ]>
+  ]
+} {
+
+stream.executable public @lookup_dispatch_0 {
+  stream.executable.export @lookup_dispatch_0 workgroups(%arg0 : index) -> (index, index, index) {
+    %x, %y, %z = flow.dispatch.workgroup_count_from_dag_root %arg0
+    stream.return %x, %y, %z : index, index, index
+  }
+  builtin.module  {
+    func.func @lookup_dispatch_0(%arg0_binding: !stream.binding, %arg1_binding: !stream.binding) {
+      %c0 = arith.constant 0 : index
+      %table = arith.constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0]> : tensor<8xf32>
+      %arg0 = stream.binding.subspan %arg0_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:tensor<16xi32>>
+      %arg1 = stream.binding.subspan %arg1_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:tensor<16xf32>>
+      %0 = tensor.empty() : tensor<16xf32>
+      %1 = flow.dispatch.tensor.load %arg0, offsets=[0], sizes=[16], strides=[1] : !flow.dispatch.tensor<readonly:tensor<16xi32>> -> tensor<16xi32>
+      %2 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%1 : tensor<16xi32>) outs(%0 : tensor<16xf32>) {
+      ^bb0(%arg2: i32, %arg3: f32):
+        %3 = arith.index_cast %arg2 : i32 to index
+        %4 = tensor.extract %table[%3] : tensor<8xf32>
+        linalg.yield %4 : f32
+      } -> tensor<16xf32>
+      flow.dispatch.tensor.store %2, %arg1, offsets=[0], sizes=[16], strides=[1] : tensor<16xf32> -> !flow.dispatch.tensor<writeonly:tensor<16xf32>>
+      return
+    }
+  }
+}
+
+stream.executable public @lookup_dispatch_1 {
+  stream.executable.export @lookup_dispatch_1 workgroups(%arg0 : index) -> (index, index, index) {
+    %x, %y, %z = flow.dispatch.workgroup_count_from_dag_root %arg0
+    stream.return %x, %y, %z : index, index, index
+  }
+  builtin.module  {
+    func.func @lookup_dispatch_1(%arg0_binding: !stream.binding, %arg1_binding: !stream.binding) {
+      %c0 = arith.constant 0 : index
+      %table = arith.constant dense<[1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0]> : tensor<8xf32>
+      %arg0 = stream.binding.subspan %arg0_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:tensor<16xi32>>
+      %arg1 = stream.binding.subspan %arg1_binding[%c0] : !stream.binding -> !flow.dispatch.tensor<writeonly:tensor<16xf32>>
+      %0 = tensor.empty() : tensor<16xf32>
+      %1 = flow.dispatch.tensor.load %arg0, offsets=[0], sizes=[16], strides=[1] : !flow.dispatch.tensor<readonly:tensor<16xi32>> -> tensor<16xi32>
+      %2 = linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>], iterator_types = ["parallel"]} ins(%1 : tensor<16xi32>) outs(%0 : tensor<16xf32>) {
+      ^bb0(%arg2: i32, %arg3: f32):
+        %3 = arith.index_cast %arg2 : i32 to index
+        %4 = tensor.extract %table[%3] : tensor<8xf32>
+        linalg.yield %4 : f32
+      } -> tensor<16xf32>
+      flow.dispatch.tensor.store %2, %arg1, offsets=[0], sizes=[16], strides=[1] : tensor<16xf32> -> !flow.dispatch.tensor<writeonly:tensor<16xf32>>
+      return
+    }
+  }
+}
+
+}
+
+// Both executables are linked into a single library.
+// CHECK:       hal.executable.binary public @embedded_elf_x86_64
+// CHECK-SAME:     data = dense
+// CHECK-SAME:     format = "embedded-elf-x86_64"
+// CHECK-NOT:   hal.executable.binary
+
+// The lookup table used by both dispatches is only emitted once.
+// IR-NOT: constant [8 x float]
+// IR:     constant [8 x float] [float 1.000000e+00
+// IR-NOT: constant [8 x float]
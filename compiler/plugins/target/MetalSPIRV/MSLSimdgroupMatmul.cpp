@@ -0,0 +1,199 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "compiler/plugins/target/MetalSPIRV/MSLSimdgroupMatmul.h"
+
+#include <map>
+#include <string>
+
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/BuiltinTypes.h"
+
+#define DEBUG_TYPE "msl-simdgroup-matmul"
+
+namespace mlir::iree_compiler {
+
+namespace {
+// A subspan of a descriptor set binding.
+struct BindingRef {
+  int64_t set;
+  int64_t binding;
+  int64_t byteOffset;
+};
+} // namespace
+
+// Simdgroups per threadgroup along M and N; each computes one quarter of the
+// threadgroup tile. This MUST be kept consistent with the tile sizes chosen
+// in the SPIR-V Apple kernel configuration.
+static constexpr int64_t kSimdgroupsM = 2;
+static constexpr int64_t kSimdgroupsN = 2;
+// Apple GPUs have 32 threads per simdgroup.
+static constexpr int64_t kSimdgroupSize = 32;
+// Shape of simdgroup matrices.
+static constexpr int64_t kFragmentSize = 8;
+
+static std::optional<BindingRef> getBindingRef(DictionaryAttr descriptor,
+                                               StringRef name) {
+  auto attr = descriptor.getAs<DenseI64ArrayAttr>(name);
+  if (!attr || attr.size() != 3)
+    return std::nullopt;
+  return BindingRef{attr[0], attr[1], attr[2]};
+}
+
+std::optional<MetalShader>
+generateSimdgroupMatmulMSL(DictionaryAttr descriptor, StringRef entryPoint) {
+  auto shapeAttr = descriptor.getAs<DenseI64ArrayAttr>("shape");
+  auto tileAttr = descriptor.getAs<DenseI64ArrayAttr>("tile");
+  auto typeAttr = descriptor.getAs<TypeAttr>("element_type");
+  auto accumulateAttr = descriptor.getAs<BoolAttr>("accumulate");
+  std::optional<BindingRef> lhs = getBindingRef(descriptor, "lhs");
+  std::optional<BindingRef> rhs = getBindingRef(descriptor, "rhs");
+  std::optional<BindingRef> result = getBindingRef(descriptor, "result");
+  if (!shapeAttr || shapeAttr.size() != 4 || !tileAttr ||
+      tileAttr.size() != 2 || !typeAttr || !accumulateAttr || !lhs || !rhs ||
+      !result) {
+    return std::nullopt;
+  }
+
+  Type elementType = typeAttr.getValue();
+  StringRef mslType;
+  if (elementType.isF16()) {
+    mslType = "half";
+  } else if (elementType.isF32()) {
+    mslType = "float";
+  } else {
+    return std::nullopt;
+  }
+
+  const int64_t dimM = shapeAttr[1], dimN = shapeAttr[2], dimK = shapeAttr[3];
+  const int64_t tileM = tileAttr[0], tileN = tileAttr[1];
+  if (tileM % (kSimdgroupsM * kFragmentSize) != 0 ||
+      tileN % (kSimdgroupsN * kFragmentSize) != 0 || dimM % tileM != 0 ||
+      dimN % tileN != 0 || dimK % kFragmentSize != 0) {
+    return std::nullopt;
+  }
+  // Number of fragments each simdgroup computes along M and N.
+  const int64_t fragmentsM = tileM / kSimdgroupsM / kFragmentSize;
+  const int64_t fragmentsN = tileN / kSimdgroupsN / kFragmentSize;
+
+  std::string source;
+  llvm::raw_string_ostream os(source);
+  os << "#include <metal_stdlib>\n"
+     << "#include <metal_simdgroup_matrix>\n\n"
+     << "using namespace metal;\n\n";
+
+  // Mirror the argument buffer layout SPIRV-Cross uses for descriptor sets so
+  // that the runtime binds resources the same way: one argument buffer per
+  // set at [[buffer(set)]] with a member per binding at [[id(binding)]].
+  // Maps from set to binding to whether the binding is written.
+  std::map<int64_t, std::map<int64_t, bool>> sets;
+  sets[lhs->set].try_emplace(lhs->binding, false);
+  sets[rhs->set].try_emplace(rhs->binding, false);
+  sets[result->set][result->binding] = true;
+  for (const auto &[set, bindings] : sets) {
+    os << "struct spvDescriptorSetBuffer" << set << " {\n";
+    for (const auto &[binding, isWritten] : bindings) {
+      os << "  " << (isWritten ? "" : "const ") << "device " << mslType
+         << "* m_" << binding << " [[id(" << binding << ")]];\n";
+    }
+    os << "};\n\n";
+  }
+
+  os << "kernel void " << entryPoint << "(\n";
+  for (const auto &[set, bindings] : sets) {
+    os << "    constant spvDescriptorSetBuffer" << set
+       << "& spvDescriptorSet" << set << " [[buffer(" << set << ")]],\n";
+  }
+  os << "    uint3 workgroupId [[threadgroup_position_in_grid]],\n"
+     << "    uint simdgroupId [[simdgroup_index_in_threadgroup]]) {\n";
+
+  os << llvm::formatv("  constexpr ulong M = {0}, N = {1}, K = {2};\n", dimM,
+                      dimN, dimK);
+  auto emitPointer = [&](StringRef name, const BindingRef &ref,
+                         bool isWritten, StringRef batchStride) {
+    StringRef qualifier = isWritten ? "" : "const ";
+    os << llvm::formatv("  {0}device {1}* {2} = ({0}device {1}*)(({0}device "
+                        "char*)spvDescriptorSet{3}.m_{4} + {5}) + "
+                        "workgroupId.z * {6};\n",
+                        qualifier, mslType, name, ref.set, ref.binding,
+                        ref.byteOffset, batchStride);
+  };
+  emitPointer("lhs", *lhs, /*isWritten=*/false, "(M * K)");
+  emitPointer("rhs", *rhs, /*isWritten=*/false, "(K * N)");
+  emitPointer("result", *result, /*isWritten=*/true, "(M * N)");
+
+  // Workgroup X/Y map to the N/M dimensions following the SPIR-V kernel
+  // distribution.
+  os << llvm::formatv(
+      "  const ulong row = workgroupId.y * {0} + (simdgroupId / {1}) * {2};\n"
+      "  const ulong col = workgroupId.x * {3} + (simdgroupId % {1}) * {4};\n",
+      tileM, kSimdgroupsN, tileM / kSimdgroupsM, tileN, tileN / kSimdgroupsN);
+  os << "  lhs += row * K;\n"
+     << "  rhs += col;\n"
+     << "  result += row * N + col;\n\n";
+
+  std::string matrixType =
+      llvm::formatv("simdgroup_matrix<{0}, {1}, {1}>", mslType, kFragmentSize);
+  os << llvm::formatv("  {0} acc[{1}][{2}];\n", matrixType, fragmentsM,
+                      fragmentsN);
+  os << llvm::formatv("  for (uint i = 0; i < {0}; ++i) {{\n"
+                      "    for (uint j = 0; j < {1}; ++j) {{\n",
+                      fragmentsM, fragmentsN);
+  if (accumulateAttr.getValue()) {
+    os << llvm::formatv("      simdgroup_load(acc[i][j], result + i * {0} * N "
+                        "+ j * {0}, N);\n",
+                        kFragmentSize);
+  } else {
+    os << llvm::formatv("      acc[i][j] = make_filled_simdgroup_matrix<{0}, "
+                        "{1}, {1}>(0);\n",
+                        mslType, kFragmentSize);
+  }
+  os << "    }\n  }\n\n";
+
+  os << llvm::formatv("  for (ulong k = 0; k < K; k += {0}) {{\n",
+                      kFragmentSize);
+  os << llvm::formatv("    {0} a[{1}];\n"
+                      "    {0} b[{2}];\n",
+                      matrixType, fragmentsM, fragmentsN);
+  os << llvm::formatv("    for (uint i = 0; i < {0}; ++i) {{\n"
+                      "      simdgroup_load(a[i], lhs + i * {1} * K + k, K);\n"
+                      "    }\n",
+                      fragmentsM, kFragmentSize);
+  os << llvm::formatv("    for (uint j = 0; j < {0}; ++j) {{\n"
+                      "      simdgroup_load(b[j], rhs + k * N + j * {1}, N);\n"
+                      "    }\n",
+                      fragmentsN, kFragmentSize);
+  os << llvm::formatv("    for (uint i = 0; i < {0}; ++i) {{\n"
+                      "      for (uint j = 0; j < {1}; ++j) {{\n"
+                      "        simdgroup_multiply_accumulate(acc[i][j], a[i], "
+                      "b[j], acc[i][j]);\n"
+                      "      }\n"
+                      "    }\n",
+                      fragmentsM, fragmentsN);
+  os << "  }\n\n";
+
+  os << llvm::formatv("  for (uint i = 0; i < {0}; ++i) {{\n"
+                      "    for (uint j = 0; j < {1}; ++j) {{\n"
+                      "      simdgroup_store(acc[i][j], result + i * {2} * N "
+                      "+ j * {2}, N);\n"
+                      "    }\n"
+                      "  }\n",
+                      fragmentsM, fragmentsN, kFragmentSize);
+  os << "}\n";
+  os.flush();
+
+  LLVM_DEBUG(llvm::dbgs() << "Generated MSL:\n-----\n" << source
+                          << "\n-----\n");
+
+  MetalShader::ThreadGroupSize threadgroupSize = {
+      static_cast<uint32_t>(kSimdgroupsM * kSimdgroupsN * kSimdgroupSize), 1,
+      1};
+  return MetalShader{std::move(source), threadgroupSize};
+}
+
+} // namespace mlir::iree_compiler
@@ -0,0 +1,29 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_PLUGINS_TARGET_METALSPIRV_MSLSIMDGROUPMATMUL_H_
+#define IREE_COMPILER_PLUGINS_TARGET_METALSPIRV_MSLSIMDGROUPMATMUL_H_
+
+#include <optional>
+
+#include "compiler/plugins/target/MetalSPIRV/SPIRVToMSL.h"
+#include "llvm/ADT/StringRef.h"
+#include "mlir/IR/BuiltinAttributes.h"
+
+namespace mlir::iree_compiler {
+
+// Generates Metal Shading Language source code for a (batch) matmul kernel
+// using simdgroup_matrix multiply-accumulate as the |entryPoint| compute
+// shader. |descriptor| is the `iree.metal.simdgroup_matmul` attribute the
+// SPIR-V kernel configuration recorded on the hal.executable.export op; the
+// kernel uses the same resource bindings and workgroup count as the SPIR-V
+// kernel it replaces. Returns std::nullopt if the descriptor is unsupported.
+std::optional<MetalShader>
+generateSimdgroupMatmulMSL(DictionaryAttr descriptor, StringRef entryPoint);
+
+} // namespace mlir::iree_compiler
+
+#endif // IREE_COMPILER_PLUGINS_TARGET_METALSPIRV_MSLSIMDGROUPMATMUL_H_
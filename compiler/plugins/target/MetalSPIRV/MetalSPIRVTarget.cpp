@@ -4,16 +4,19 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "compiler/plugins/target/MetalSPIRV/MSLSimdgroupMatmul.h"
 #include "compiler/plugins/target/MetalSPIRV/MSLToMetalLib.h"
 #include "compiler/plugins/target/MetalSPIRV/MetalTargetPlatform.h"
 #include "compiler/plugins/target/MetalSPIRV/SPIRVToMSL.h"
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenDialect.h"
 #include "iree/compiler/Codegen/SPIRV/Passes.h"
+#include "iree/compiler/Codegen/SPIRV/Utils.h"
 #include "iree/compiler/Dialect/Flow/IR/FlowDialect.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/PluginAPI/Client.h"
 #include "iree/compiler/Utils/FlatbufferUtils.h"
 #include "iree/schemas/metal_executable_def_builder.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/TargetParser/Host.h"
 #include "llvm/TargetParser/Triple.h"
@@ -213,12 +216,38 @@ public:
                                ".spv", spvBinary);
     }
 
+    // Matmuls the SPIR-V kernel configuration picked the simdgroup_matrix
+    // library kernel for carry its descriptor on the export op.
+    llvm::StringMap<DictionaryAttr> simdgroupMatmulDescriptors;
+    for (auto exportOp : variantOp.getExportOps()) {
+      if (auto descriptor = exportOp->getAttrOfType<DictionaryAttr>(
+              getMetalSimdgroupMatmulAttrName())) {
+        simdgroupMatmulDescriptors[exportOp.getSymName()] = descriptor;
+      }
+    }
+
     // 2. Cross compile SPIR-V to MSL source code.
     SmallVector<MetalShader, 2> mslShaders;
     SmallVector<std::string, 2> mslEntryPointNames;
     mslShaders.reserve(spirvEntryPointNames.size());
     mslEntryPointNames.reserve(spirvEntryPointNames.size());
     for (const auto &entryPoint : spirvEntryPointNames) {
+      // Replace the SPIR-V kernel with the MSL library kernel if requested.
+      // SPIR-V cannot express simdgroup_matrix operations.
+      if (DictionaryAttr descriptor =
+              simdgroupMatmulDescriptors.lookup(entryPoint)) {
+        std::optional<MetalShader> shader =
+            generateSimdgroupMatmulMSL(descriptor, entryPoint);
+        if (!shader) {
+          return variantOp.emitError()
+                 << "failed to generate simdgroup matmul kernel for "
+                 << entryPoint;
+        }
+        mslShaders.push_back(std::move(*shader));
+        mslEntryPointNames.push_back(entryPoint.str());
+        continue;
+      }
+
       // We can use ArrayRef here given spvBinary reserves 0 bytes on stack.
       ArrayRef spvData(spvBinary.data(), spvBinary.size());
       std::optional<std::pair<MetalShader, std::string>> msl =
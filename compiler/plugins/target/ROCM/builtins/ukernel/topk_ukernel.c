@@ -0,0 +1,154 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <hip/hip_fp16.h>
+#include <hip/hip_runtime.h>
+
+extern "C" __device__
+    __attribute__((const)) int32_t __ockl_wfred_min_i32(int32_t);
+
+/*
+Constraint/Tiling note:
+Like argmax, we distribute all parallel dims across different workgroups and
+only use a single subgroup/warp per workgroup. This constraint is also set
+during tiling phase in KernelConfig, which additionally bounds k by
+IREE_UK_ROCM_TOPK_MAX_K so that each lane can keep its candidates in
+registers.
+
+Algorithm:
+Every lane keeps a sorted list of its best k candidates seen while striding
+over the reduction dim. Then k rounds of butterfly subgroup reductions pop the
+best head across all lanes. Candidates are ordered by value and then by their
+occurrence order (existing outputs first, then inputs) so that equal values
+keep the first occurrence as required by iree_linalg_ext.topk.
+*/
+
+#define IREE_UK_ROCM_TOPK_MAX_K 16
+
+template <typename T, typename I>
+static __device__ void iree_uk_rocm_topk(T *inputBuffer, size_t input_offset,
+                                         T *outputValuesBuffer,
+                                         size_t output_values_offset,
+                                         I *outputIndicesBuffer,
+                                         size_t output_indices_offset,
+                                         size_t reductionSize, size_t k) {
+  uint laneID = __builtin_amdgcn_workitem_id_x();
+  float laneValues[IREE_UK_ROCM_TOPK_MAX_K];
+  int32_t laneOrders[IREE_UK_ROCM_TOPK_MAX_K];
+  I laneIndices[IREE_UK_ROCM_TOPK_MAX_K];
+#pragma unroll
+  for (int j = 0; j < IREE_UK_ROCM_TOPK_MAX_K; ++j) {
+    laneValues[j] = -INFINITY;
+    laneOrders[j] = __INT32_MAX__;
+    laneIndices[j] = 0;
+  }
+
+  // Inserts a candidate keeping the per-lane list sorted. The loop is fully
+  // unrolled so that the list stays in registers.
+  auto insert = [&](float value, int32_t order, I index) {
+    if (!(value > laneValues[IREE_UK_ROCM_TOPK_MAX_K - 1]))
+      return;
+    bool shifting = false;
+#pragma unroll
+    for (int j = 0; j < IREE_UK_ROCM_TOPK_MAX_K; ++j) {
+      if (shifting || value > laneValues[j]) {
+        float tmpValue = laneValues[j];
+        int32_t tmpOrder = laneOrders[j];
+        I tmpIndex = laneIndices[j];
+        laneValues[j] = value;
+        laneOrders[j] = order;
+        laneIndices[j] = index;
+        value = tmpValue;
+        order = tmpOrder;
+        index = tmpIndex;
+        shifting = true;
+      }
+    }
+  };
+
+  // The existing outputs take part in the selection and come first.
+  for (size_t idx = laneID; idx < k; idx += warpSize) {
+    insert((float)outputValuesBuffer[output_values_offset + idx], idx,
+           outputIndicesBuffer[output_indices_offset + idx]);
+  }
+  for (size_t idx = laneID; idx < reductionSize; idx += warpSize) {
+    insert((float)inputBuffer[input_offset + idx], k + idx, idx);
+  }
+
+  // Pop the best head across the subgroup k times.
+  // NOTE: __ockl_wfred_max_f32 has correctness issue on gfx1100 documented on
+  // https://github.com/iree-org/iree/issues/16112.
+  for (size_t i = 0; i < k; ++i) {
+    float wgMax = laneValues[0];
+    for (int s = 1; s < warpSize; s *= 2) {
+      wgMax = __ocml_fmax_f32(__shfl_xor(wgMax, s), wgMax);
+    }
+    int32_t wgOrder =
+        __ockl_wfred_min_i32(laneValues[0] == wgMax ? laneOrders[0]
+                                                    : __INT32_MAX__);
+    // Only the single lane holding the winner writes it out and pops it.
+    if (wgOrder != __INT32_MAX__ && laneOrders[0] == wgOrder) {
+      outputValuesBuffer[output_values_offset + i] = (T)laneValues[0];
+      outputIndicesBuffer[output_indices_offset + i] = laneIndices[0];
+#pragma unroll
+      for (int j = 0; j < IREE_UK_ROCM_TOPK_MAX_K - 1; ++j) {
+        laneValues[j] = laneValues[j + 1];
+        laneOrders[j] = laneOrders[j + 1];
+        laneIndices[j] = laneIndices[j + 1];
+      }
+      laneValues[IREE_UK_ROCM_TOPK_MAX_K - 1] = -INFINITY;
+      laneOrders[IREE_UK_ROCM_TOPK_MAX_K - 1] = __INT32_MAX__;
+    }
+  }
+}
+
+extern "C" __device__ void
+__iree_uk_rocm_topk_F32I32(float *inputBuffer, size_t input_offset,
+                           float *outputValuesBuffer,
+                           size_t output_values_offset,
+                           int32_t *outputIndicesBuffer,
+                           size_t output_indices_offset, size_t reductionSize,
+                           size_t k) {
+  iree_uk_rocm_topk(inputBuffer, input_offset, outputValuesBuffer,
+                    output_values_offset, outputIndicesBuffer,
+                    output_indices_offset, reductionSize, k);
+}
+
+extern "C" __device__ void
+__iree_uk_rocm_topk_F32I64(float *inputBuffer, size_t input_offset,
+                           float *outputValuesBuffer,
+                           size_t output_values_offset,
+                           int64_t *outputIndicesBuffer,
+                           size_t output_indices_offset, size_t reductionSize,
+                           size_t k) {
+  iree_uk_rocm_topk(inputBuffer, input_offset, outputValuesBuffer,
+                    output_values_offset, outputIndicesBuffer,
+                    output_indices_offset, reductionSize, k);
+}
+
+extern "C" __device__ void
+__iree_uk_rocm_topk_F16I32(half *inputBuffer, size_t input_offset,
+                           half *outputValuesBuffer,
+                           size_t output_values_offset,
+                           int32_t *outputIndicesBuffer,
+                           size_t output_indices_offset, size_t reductionSize,
+                           size_t k) {
+  iree_uk_rocm_topk(inputBuffer, input_offset, outputValuesBuffer,
+                    output_values_offset, outputIndicesBuffer,
+                    output_indices_offset, reductionSize, k);
+}
+
+extern "C" __device__ void
+__iree_uk_rocm_topk_F16I64(half *inputBuffer, size_t input_offset,
+                           half *outputValuesBuffer,
+                           size_t output_values_offset,
+                           int64_t *outputIndicesBuffer,
+                           size_t output_indices_offset, size_t reductionSize,
+                           size_t k) {
+  iree_uk_rocm_topk(inputBuffer, input_offset, outputValuesBuffer,
+                    output_values_offset, outputIndicesBuffer,
+                    output_indices_offset, reductionSize, k);
+}
@@ -33,6 +33,9 @@ namespace {
 
 struct WebGPUSPIRVOptions {
   bool debugSymbols = true;
+  bool enableShaderF16 = false;
+  bool enableSubgroups = false;
+  int subgroupSize = 32;
 
   void bindOptions(OptionsBinder &binder) {
     static llvm::cl::OptionCategory category("WebGPU HAL Target");
@@ -40,18 +43,72 @@ struct WebGPUSPIRVOptions {
         "iree-webgpu-debug-symbols", debugSymbols, llvm::cl::cat(category),
         llvm::cl::desc(
             "Include debug information like variable names in outputs."));
+    binder.opt<bool>(
+        "iree-webgpu-enable-shader-f16", enableShaderF16,
+        llvm::cl::cat(category),
+        llvm::cl::desc("Additionally generate executables using the optional "
+                       "'shader-f16' feature for f16 arithmetic and storage; "
+                       "selected at runtime when the device supports it."));
+    binder.opt<bool>(
+        "iree-webgpu-enable-subgroups", enableSubgroups,
+        llvm::cl::cat(category),
+        llvm::cl::desc("Additionally generate executables using the optional "
+                       "'subgroups' feature for subgroup shuffles and "
+                       "reductions; selected at runtime when the device "
+                       "supports it."));
+    binder.opt<int>(
+        "iree-webgpu-subgroup-size", subgroupSize, llvm::cl::cat(category),
+        llvm::cl::desc("Subgroup size assumed by executables generated with "
+                       "--iree-webgpu-enable-subgroups."));
   }
 };
 
 // TODO(scotttodd): provide a proper target environment for WebGPU.
-static spirv::TargetEnvAttr getWebGPUTargetEnv(MLIRContext *context) {
+static spirv::TargetEnvAttr
+getWebGPUTargetEnv(MLIRContext *context, const WebGPUSPIRVOptions &options,
+                   bool useOptionalFeatures) {
   // TODO(scotttodd): find list of SPIR-V extensions supported by WebGPU/WGSL
-  auto triple = spirv::VerCapExtAttr::get(
-      spirv::Version::V_1_0, {spirv::Capability::Shader},
-      {spirv::Extension::SPV_KHR_storage_buffer_storage_class}, context);
+  SmallVector<spirv::Capability> capabilities = {spirv::Capability::Shader};
+  SmallVector<spirv::Extension> extensions = {
+      spirv::Extension::SPV_KHR_storage_buffer_storage_class};
+  spirv::ResourceLimitsAttr limits = spirv::getDefaultResourceLimits(context);
+  if (!useOptionalFeatures) {
+    auto triple = spirv::VerCapExtAttr::get(spirv::Version::V_1_0,
+                                            capabilities, extensions, context);
+    return spirv::TargetEnvAttr::get(
+        triple, limits, spirv::ClientAPI::WebGPU, spirv::Vendor::Unknown,
+        spirv::DeviceType::Unknown, spirv::TargetEnvAttr::kUnknownDeviceID);
+  }
+
+  // The 'shader-f16' feature maps to the WGSL `f16` extension, which allows
+  // f16 values both in arithmetic and in storage buffers.
+  if (options.enableShaderF16) {
+    capabilities.push_back(spirv::Capability::Float16);
+    capabilities.push_back(spirv::Capability::StorageBuffer16BitAccess);
+    extensions.push_back(spirv::Extension::SPV_KHR_16bit_storage);
+  }
+  // The 'subgroups' feature maps to the WGSL `subgroups` extension. Only the
+  // shuffle and arithmetic operations the SPIR-V reduction pipelines use are
+  // enabled. WebGPU does not fix the subgroup size so the executables assume
+  // the configured one.
+  if (options.enableSubgroups) {
+    capabilities.push_back(spirv::Capability::GroupNonUniform);
+    capabilities.push_back(spirv::Capability::GroupNonUniformShuffle);
+    capabilities.push_back(spirv::Capability::GroupNonUniformArithmetic);
+    limits = spirv::ResourceLimitsAttr::get(
+        context, limits.getMaxComputeSharedMemorySize(),
+        limits.getMaxComputeWorkgroupInvocations(),
+        limits.getMaxComputeWorkgroupSize(), options.subgroupSize,
+        /*min_subgroup_size=*/std::nullopt,
+        /*max_subgroup_size=*/std::nullopt,
+        /*cooperative_matrix_properties_khr=*/ArrayAttr{},
+        /*cooperative_matrix_properties_nv=*/ArrayAttr{});
+  }
+  // Group non-uniform operations require SPIR-V 1.3.
+  auto triple = spirv::VerCapExtAttr::get(spirv::Version::V_1_3, capabilities,
+                                          extensions, context);
   return spirv::TargetEnvAttr::get(
-      triple, spirv::getDefaultResourceLimits(context),
-      spirv::ClientAPI::WebGPU, spirv::Vendor::Unknown,
+      triple, limits, spirv::ClientAPI::WebGPU, spirv::Vendor::Unknown,
       spirv::DeviceType::Unknown, spirv::TargetEnvAttr::kUnknownDeviceID);
 }
 
@@ -94,8 +151,17 @@ public:
       MLIRContext *context, StringRef deviceID, DictionaryAttr deviceConfigAttr,
       SmallVectorImpl<IREE::HAL::ExecutableTargetAttr> &executableTargetAttrs)
       const override {
-    executableTargetAttrs.push_back(
-        getExecutableTarget(context, getWebGPUTargetEnv(context)));
+    // Executables using optional features come first so that they are
+    // preferred at runtime when the device supports the features; the
+    // baseline executables are used otherwise.
+    if (options.enableShaderF16 || options.enableSubgroups) {
+      executableTargetAttrs.push_back(getExecutableTarget(
+          context, getWebGPUTargetEnv(context, options,
+                                      /*useOptionalFeatures=*/true)));
+    }
+    executableTargetAttrs.push_back(getExecutableTarget(
+        context,
+        getWebGPUTargetEnv(context, options, /*useOptionalFeatures=*/false)));
   }
 
   IREE::HAL::ExecutableTargetAttr
@@ -151,6 +217,18 @@ public:
         spirv::createSPIRVWebGPUPreparePass());
   }
 
+  void buildLinkingPassPipeline(OpPassManager &passManager) override {
+    // Executables are not linked together as each WGSL executable is limited
+    // to a single shader module. The required target environment is still
+    // trimmed and materialized into device queries so that variants using
+    // optional features are only selected on devices supporting them.
+    auto &variantPassManager = passManager.nest<IREE::HAL::ExecutableOp>()
+                                   .nest<IREE::HAL::ExecutableVariantOp>();
+    variantPassManager.addPass(createSPIRVTrimExecutableTargetEnvPass());
+    variantPassManager.addPass(
+        createSPIRVMaterializeExecutableConditionsPass());
+  }
+
   LogicalResult serializeExecutable(const SerializationOptions &serOptions,
                                     IREE::HAL::ExecutableVariantOp variantOp,
                                     OpBuilder &executableBuilder) override {
@@ -216,8 +294,11 @@ public:
 
       // Disassemble the shader and save that too.
       // Note: this should match what getWebGPUTargetEnv used.
-      // TODO(scotttodd): Query spirv env from the executable variant?
-      spvtools::SpirvTools spirvTools(SPV_ENV_VULKAN_1_0);
+      auto vceTriple = spvModuleOp.getVceTriple();
+      spvtools::SpirvTools spirvTools(
+          vceTriple && vceTriple->getVersion() >= spirv::Version::V_1_3
+              ? SPV_ENV_VULKAN_1_1
+              : SPV_ENV_VULKAN_1_0);
       std::string spvDisassembled;
       if (spirvTools.Disassemble(
               spvBinary.data(), spvBinary.size(), &spvDisassembled,
@@ -0,0 +1,239 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/API/Internal/CompileStatistics.h"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif // !_WIN32
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Process.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/AttrTypeSubElements.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir::iree_compiler::embed {
+
+// Returns the peak resident set size of the process in bytes or 0 if it is not
+// available on the host.
+static uint64_t getPeakResidentSetSize() {
+#if defined(_WIN32)
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#if defined(__APPLE__)
+  return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+  // Reported in kilobytes everywhere else.
+  return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif // __APPLE__
+#endif // _WIN32
+}
+
+// Returns the total size in bytes of the constant data referenced by
+// attributes in |moduleOp|. Inline dense elements are counted once per unique
+// attribute and `dense_resource` elements once per unique blob.
+static uint64_t getConstantDataSize(ModuleOp moduleOp) {
+  DenseSet<Attribute> seenAttrs;
+  DenseSet<AsmResourceBlob *> seenBlobs;
+  uint64_t size = 0;
+  moduleOp->walk([&](Operation *op) {
+    for (NamedAttribute namedAttr : op->getAttrs()) {
+      namedAttr.getValue().walk([&](Attribute attr) {
+        if (!seenAttrs.insert(attr).second)
+          return;
+        if (auto resourceAttr = dyn_cast<DenseResourceElementsAttr>(attr)) {
+          AsmResourceBlob *blob = resourceAttr.getRawHandle().getBlob();
+          if (blob && seenBlobs.insert(blob).second)
+            size += blob->getData().size();
+        } else if (auto denseAttr = dyn_cast<DenseElementsAttr>(attr)) {
+          size += denseAttr.getRawData().size();
+        }
+      });
+    }
+  });
+  return size;
+}
+
+// Formats |bytes| in MiB for display.
+static std::string formatSize(uint64_t bytes) {
+  if (!bytes)
+    return "-";
+  return llvm::formatv("{0:f1} MiB", bytes / (1024.0 * 1024.0)).str();
+}
+
+// Marks the beginning or end of a pipeline phase when run.
+class CompileStatisticsPhaseMarkerPass
+    : public PassWrapper<CompileStatisticsPhaseMarkerPass,
+                         OperationPass<ModuleOp>> {
+public:
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(
+      CompileStatisticsPhaseMarkerPass)
+
+  CompileStatisticsPhaseMarkerPass(CompileStatistics &statistics,
+                                   StringRef phaseName, bool isEnd)
+      : statistics(statistics), phaseName(phaseName), isEnd(isEnd) {}
+
+  StringRef getArgument() const override {
+    return "iree-compile-statistics-phase-marker";
+  }
+  StringRef getDescription() const override {
+    return "Marks a pipeline phase boundary for compile statistics.";
+  }
+
+  void runOnOperation() override {
+    if (isEnd) {
+      statistics.endPhase(phaseName, getOperation());
+    } else {
+      statistics.beginPhase(phaseName);
+    }
+  }
+
+private:
+  CompileStatistics &statistics;
+  std::string phaseName;
+  bool isEnd;
+};
+
+// Records the wall time of each pass into the statistics.
+class CompileStatisticsInstrumentation : public PassInstrumentation {
+public:
+  explicit CompileStatisticsInstrumentation(CompileStatistics &statistics)
+      : statistics(statistics) {}
+
+  void runBeforePass(Pass *pass, Operation *op) override {
+    if (shouldRecord(pass))
+      statistics.beginPass(pass, op);
+  }
+  void runAfterPass(Pass *pass, Operation *op) override {
+    if (shouldRecord(pass))
+      statistics.endPass(pass, op);
+  }
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    if (shouldRecord(pass))
+      statistics.endPass(pass, op);
+  }
+
+private:
+  // Adaptors running nested pipelines have no argument and are skipped as
+  // their time is already attributed to the passes they run.
+  static bool shouldRecord(Pass *pass) {
+    return !pass->getArgument().empty() &&
+           !isa<CompileStatisticsPhaseMarkerPass>(pass);
+  }
+
+  CompileStatistics &statistics;
+};
+
+void CompileStatistics::addPhaseBegin(StringRef name,
+                                      OpPassManager &passManager) {
+  passManager.addPass(std::make_unique<CompileStatisticsPhaseMarkerPass>(
+      *this, name, /*isEnd=*/false));
+}
+
+void CompileStatistics::addPhaseEnd(StringRef name,
+                                    OpPassManager &passManager) {
+  passManager.addPass(std::make_unique<CompileStatisticsPhaseMarkerPass>(
+      *this, name, /*isEnd=*/true));
+}
+
+std::unique_ptr<PassInstrumentation>
+CompileStatistics::createPassInstrumentation() {
+  return std::make_unique<CompileStatisticsInstrumentation>(*this);
+}
+
+void CompileStatistics::beginPhase(StringRef name) {
+  std::lock_guard<std::mutex> lock(mutex);
+  phaseStartTimes.push_back(Clock::now());
+}
+
+void CompileStatistics::endPhase(StringRef name, ModuleOp moduleOp) {
+  PhaseStatistics phase;
+  phase.name = name.str();
+  phase.peakResidentSetSize = getPeakResidentSetSize();
+  phase.heapSize = llvm::sys::Process::GetMallocUsage();
+  phase.constantDataSize = getConstantDataSize(moduleOp);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!phaseStartTimes.empty()) {
+    phase.wallTime = std::chrono::duration<double>(Clock::now() -
+                                                   phaseStartTimes.back())
+                         .count();
+    phaseStartTimes.pop_back();
+  }
+  phases.push_back(std::move(phase));
+}
+
+void CompileStatistics::beginPass(Pass *pass, Operation *op) {
+  auto startTime = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex);
+  passStartTimes[{pass, op}] = startTime;
+}
+
+void CompileStatistics::endPass(Pass *pass, Operation *op) {
+  auto endTime = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = passStartTimes.find({pass, op});
+  if (it == passStartTimes.end())
+    return;
+  auto &passStatistics = passes[pass->getArgument()];
+  passStatistics.wallTime +=
+      std::chrono::duration<double>(endTime - it->second).count();
+  ++passStatistics.count;
+  passStartTimes.erase(it);
+}
+
+void CompileStatistics::print(llvm::raw_ostream &os) {
+  std::lock_guard<std::mutex> lock(mutex);
+  os << "===" << std::string(73, '-') << "===\n";
+  os << "                         ... Compile statistics ...\n";
+  os << "===" << std::string(73, '-') << "===\n";
+
+  if (!phases.empty()) {
+    os << "Phases (peak RSS is the process high-water mark at phase end):\n";
+    os << llvm::formatv("  {0,-28}{1,12}{2,14}{3,14}{4,14}\n", "Phase",
+                        "Wall Time", "Peak RSS", "Heap", "Constants");
+    for (auto &phase : phases) {
+      os << llvm::formatv("  {0,-28}{1,11:f4}s{2,14}{3,14}{4,14}\n",
+                          phase.name, phase.wallTime,
+                          formatSize(phase.peakResidentSetSize),
+                          formatSize(phase.heapSize),
+                          formatSize(phase.constantDataSize));
+    }
+    os << "\n";
+  }
+
+  if (!passes.empty()) {
+    // Report the most expensive passes first.
+    SmallVector<std::pair<StringRef, PassStatistics>> sortedPasses;
+    for (auto &entry : passes)
+      sortedPasses.push_back({entry.getKey(), entry.getValue()});
+    llvm::stable_sort(sortedPasses, [](const auto &lhs, const auto &rhs) {
+      return lhs.second.wallTime > rhs.second.wallTime;
+    });
+    os << "Passes (wall time summed over all operations they ran on):\n";
+    os << llvm::formatv("  {0,12}{1,10}  {2}\n", "Wall Time", "Count",
+                        "Pass");
+    for (auto &[name, passStatistics] : sortedPasses) {
+      os << llvm::formatv("  {0,11:f4}s{1,10}  {2}\n", passStatistics.wallTime,
+                          passStatistics.count, name);
+    }
+    os << "\n";
+  }
+  os.flush();
+
+  phases.clear();
+  phaseStartTimes.clear();
+  passes.clear();
+  passStartTimes.clear();
+}
+
+} // namespace mlir::iree_compiler::embed
@@ -0,0 +1,85 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_API_INTERNAL_COMPILESTATISTICS_H
+#define IREE_COMPILER_API_INTERNAL_COMPILESTATISTICS_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/PassInstrumentation.h"
+#include "mlir/Pass/PassManager.h"
+
+namespace mlir::iree_compiler::embed {
+
+/// Collects statistics about the compiler's resource usage during an
+/// invocation in order to attribute compile time and memory to the parts of
+/// the pipeline responsible for them:
+///
+/// * the wall time and process peak resident set size at the end of each
+///   pipeline phase along with the size of the constant data held by the
+///   module (inline dense elements and `dense_resource` blobs);
+/// * the wall time spent in each pass aggregated over all of the operations
+///   it ran on (such as all executables being translated).
+///
+/// Phases are tracked by marker passes added to the pipeline with
+/// addPhaseMarkers and passes by the instrumentation returned from
+/// createPassInstrumentation. Pass times from concurrently processed
+/// operations are summed and may exceed the total wall time.
+class CompileStatistics {
+public:
+  /// Adds a pass to |passManager| marking the beginning of phase |name|.
+  void addPhaseBegin(StringRef name, OpPassManager &passManager);
+  /// Adds a pass to |passManager| marking the end of phase |name|.
+  void addPhaseEnd(StringRef name, OpPassManager &passManager);
+
+  /// Returns an instrumentation that records pass times into the statistics.
+  /// The statistics must outlive the pass manager it is added to.
+  std::unique_ptr<PassInstrumentation> createPassInstrumentation();
+
+  /// Prints the statistics collected so far to |os| and resets them.
+  void print(llvm::raw_ostream &os);
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct PhaseStatistics {
+    std::string name;
+    double wallTime = 0.0;
+    uint64_t peakResidentSetSize = 0;
+    uint64_t heapSize = 0;
+    uint64_t constantDataSize = 0;
+  };
+  struct PassStatistics {
+    double wallTime = 0.0;
+    int64_t count = 0;
+  };
+
+  friend class CompileStatisticsInstrumentation;
+  friend class CompileStatisticsPhaseMarkerPass;
+  void beginPhase(StringRef name);
+  void endPhase(StringRef name, ModuleOp moduleOp);
+  void beginPass(Pass *pass, Operation *op);
+  void endPass(Pass *pass, Operation *op);
+
+  std::mutex mutex;
+  // Start times of the phases currently running as phases may nest.
+  SmallVector<Clock::time_point> phaseStartTimes;
+  SmallVector<PhaseStatistics> phases;
+  DenseMap<std::pair<Pass *, Operation *>, Clock::time_point> passStartTimes;
+  llvm::StringMap<PassStatistics> passes;
+};
+
+} // namespace mlir::iree_compiler::embed
+
+#endif // IREE_COMPILER_API_INTERNAL_COMPILESTATISTICS_H
@@ -39,7 +39,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <limits>
+#include <mutex>
 
+#include "iree/compiler/API/Internal/CompileStatistics.h"
 #include "iree/compiler/API/Internal/Diagnostics.h"
 #include "iree/compiler/ConstEval/Passes.h"
 #include "iree/compiler/Dialect/VM/Target/init_targets.h"
@@ -73,6 +75,7 @@
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/Verifier.h"
 #include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassInstrumentation.h"
 #include "mlir/Support/FileUtilities.h"
 #include "mlir/Support/LogicalResult.h"
 
@@ -86,7 +89,7 @@
 #endif
 
 #define IREE_COMPILER_API_MAJOR 1
-#define IREE_COMPILER_API_MINOR 4
+#define IREE_COMPILER_API_MINOR 6
 
 namespace mlir::iree_compiler::embed {
 namespace {
@@ -334,6 +337,7 @@ struct Session {
   }
 
   LogicalResult activatePluginsOnce() {
+    std::lock_guard<std::mutex> guard(activationMutex);
     if (!pluginsActivated) {
       pluginsActivated = true;
       if (failed(pluginSession.initializePlugins())) {
@@ -357,6 +361,8 @@ struct Session {
     return pluginActivationStatus;
   }
 
+  Error *prepare();
+
   GlobalInit &globalInit;
   // When created, the Session owns the context, but there are situations
   // where ownership can be released, in which case the ownedContext will be
@@ -376,7 +382,9 @@ struct Session {
 
   // We lazily activate plugins on the first invocation. This allows plugin
   // activation to be configured at the session level via the API, if
-  // desired.
+  // desired. Invocations may race to activate them if the session was not
+  // prepared.
+  std::mutex activationMutex;
   bool pluginsActivated = false;
   LogicalResult pluginActivationStatus{failure()};
 
@@ -430,6 +438,37 @@ Session::Session(GlobalInit &globalInit)
   // TODO: Fix binder support for cTargetOptions.
 }
 
+Error *Session::prepare() {
+  std::string errorMessage;
+  {
+    FormattingDiagnosticHandler diagnosticHandler(
+        &context,
+        [&](DiagnosticSeverity severity, std::string_view message) {
+          if (severity != DiagnosticSeverity::Error)
+            return;
+          if (!errorMessage.empty())
+            errorMessage.append("\n");
+          errorMessage.append(message.data(), message.size());
+        });
+    if (failed(activatePluginsOnce())) {
+      if (errorMessage.empty())
+        errorMessage = "failed to activate plugins";
+      return new Error(std::move(errorMessage));
+    }
+  }
+
+  // Loading a dialect mutates the context and would race with concurrent
+  // invocations using it. Once everything registered (including by plugins)
+  // has been loaded any later loads are only lookups.
+  context.loadAllAvailableDialects();
+
+  // Target backends are instantiated once per session on first use.
+  for (const std::string &name : halTargetOptions.targets) {
+    targetRegistry.getTargetBackend(name);
+  }
+  return nullptr;
+}
+
 struct Source {
   Source(Session &session) : session(session) {}
 
@@ -664,6 +703,71 @@ void Output::keep() {
     outputFile->keep();
 }
 
+// Returns the mnemonic name of |phase|.
+static std::string getPhaseName(IREEVMPipelinePhase phase) {
+  std::string phaseName;
+  enumerateIREEVMPipelinePhases(
+      [&](IREEVMPipelinePhase enumeratedPhase, StringRef name, StringRef desc) {
+        if (enumeratedPhase == phase)
+          phaseName = name;
+      });
+  return phaseName;
+}
+
+struct Invocation;
+
+// Stack of invocations with work executing on the current thread. Diagnostics
+// emitted on a thread are attributed to the top-most invocation so that they
+// are only delivered to it when several invocations run concurrently within a
+// session (and so share an MLIRContext). Pushed by the API entry points on the
+// calling thread and by pass instrumentation on the threads running passes.
+// Diagnostics emitted by MLIR worker threads outside of passes are collected
+// and re-emitted on the thread that spawned them.
+static thread_local llvm::SmallVector<const Invocation *> threadInvocations;
+
+struct InvocationScope {
+  InvocationScope(const Invocation *invocation) {
+    threadInvocations.push_back(invocation);
+  }
+  ~InvocationScope() { threadInvocations.pop_back(); }
+};
+
+class InvocationScopeInstrumentation : public PassInstrumentation {
+public:
+  InvocationScopeInstrumentation(const Invocation *invocation)
+      : invocation(invocation) {}
+  void runBeforePass(Pass *pass, Operation *op) override {
+    threadInvocations.push_back(invocation);
+  }
+  void runAfterPass(Pass *pass, Operation *op) override {
+    threadInvocations.pop_back();
+  }
+  void runAfterPassFailed(Pass *pass, Operation *op) override {
+    threadInvocations.pop_back();
+  }
+
+private:
+  const Invocation *invocation;
+};
+
+// Console diagnostic handler that passes on diagnostics not accepted by
+// |filter| to the next handler registered with the context.
+class FilteredSourceMgrDiagnosticHandler : public SourceMgrDiagnosticHandler {
+public:
+  FilteredSourceMgrDiagnosticHandler(llvm::SourceMgr &sourceMgr,
+                                     MLIRContext *ctx,
+                                     std::function<bool()> filter)
+      : SourceMgrDiagnosticHandler(sourceMgr, ctx) {
+    setHandler([this, filter = std::move(filter)](
+                   Diagnostic &diag) -> LogicalResult {
+      if (!filter())
+        return failure();
+      emitDiagnostic(diag);
+      return success();
+    });
+  }
+};
+
 // Invocation corresponds to iree_compiler_invocation_t
 struct Invocation {
   using PassManagerInitializer = std::function<void(PassManager &pm)>;
@@ -679,6 +783,7 @@ struct Invocation {
                            IREEVMPipelinePhase &compileTo);
   void dumpCompilationPhase(IREEVMPipelinePhase phase,
                             OpPassManager &passManager);
+  void printCompileStatistics();
   bool runTextualPassPipeline(const char *textPassPipeline);
   Error *outputIR(Output &output);
   Error *outputIRBytecode(Output &output, int bytecodeVersion);
@@ -686,6 +791,13 @@ struct Invocation {
   Error *outputVMCSource(Output &output);
   Error *outputHALExecutable(Output &output);
 
+  // Returns true if diagnostics emitted on the current thread belong to this
+  // invocation. Unattributed diagnostics are handled by the most recently
+  // initialized invocation, as there is no way to tell where they came from.
+  bool ownsThreadDiagnostics() const {
+    return threadInvocations.empty() || threadInvocations.back() == this;
+  }
+
   Session &session;
   llvm::SmallVector<PassManagerInitializer> passManagerInitializers;
   IREEVMPipelineHooks pipelineHooks;
@@ -693,7 +805,7 @@ struct Invocation {
   // Diagnostic handlers are instantiated upon parsing the source (when we
   // have the SrcMgr) and held for the duration of the invocation. Each will
   // de-register upon destruction if set.
-  std::optional<SourceMgrDiagnosticHandler> consoleDiagnosticHandler;
+  std::optional<FilteredSourceMgrDiagnosticHandler> consoleDiagnosticHandler;
   std::optional<FormattingDiagnosticHandler> callbackDiagnosticHandler;
 
   Operation *parsedModule = nullptr;
@@ -705,6 +817,9 @@ struct Invocation {
   std::string dumpCompilationPhasesTo;
   bool enableVerifier = true;
 
+  // Statistics collected while running pipelines, if enabled.
+  std::unique_ptr<CompileStatistics> compileStatistics;
+
   // Diagnostic options.
   bool enableConsoleDiagnosticHandler = false;
   void (*diagnosticCallback)(enum iree_compiler_diagnostic_severity_t severity,
@@ -724,9 +839,18 @@ Invocation::Invocation(Session &session) : session(session) {
         pm.addPass(ConstEval::createJitGlobalsPass({&targetRegistry}));
       };
 
+  // Mark compilation phases for statistics if they are enabled.
+  pipelineHooks.beforePhase = [this](IREEVMPipelinePhase phase,
+                                     OpPassManager &passManager) {
+    if (compileStatistics)
+      compileStatistics->addPhaseBegin(getPhaseName(phase), passManager);
+  };
+
   // Dump compilation phase results if the option is set.
   pipelineHooks.afterPhase = [this](IREEVMPipelinePhase phase,
                                     OpPassManager &passManager) {
+    if (compileStatistics)
+      compileStatistics->addPhaseEnd(getPhaseName(phase), passManager);
     dumpCompilationPhase(phase, passManager);
   };
 
@@ -750,7 +874,13 @@ std::unique_ptr<PassManager> Invocation::createPassManager() {
     }
     mlir::applyDefaultTimingPassManagerCLOptions(*passManager);
   }
+  passManager->addInstrumentation(
+      std::make_unique<InvocationScopeInstrumentation>(this));
   passManager->addInstrumentation(std::make_unique<PassTracing>());
+  if (compileStatistics) {
+    passManager->addInstrumentation(
+        compileStatistics->createPassInstrumentation());
+  }
   passManager->enableVerifier(enableVerifier);
   for (auto &init : passManagerInitializers) {
     init(*passManager);
@@ -784,7 +914,8 @@ bool Invocation::initializeInvocation() {
           }
           diagnosticCallback(cSeverity, message.data(), message.size(),
                              diagnosticCallbackUserData);
-        });
+        },
+        [this]() { return ownsThreadDiagnostics(); });
   }
 
   // Now that diagnostics are enabled, try to activate plugins.
@@ -822,8 +953,11 @@ bool Invocation::initializeInvocation() {
 bool Invocation::parseSource(Source &source) {
   // Use the source manager's diagnostic handler if console diagnostics
   // are enabled.
+  InvocationScope scope(this);
   if (enableConsoleDiagnosticHandler && !consoleDiagnosticHandler) {
-    consoleDiagnosticHandler.emplace(source.sourceMgr, &session.context);
+    consoleDiagnosticHandler.emplace(
+        source.sourceMgr, &session.context,
+        [this]() { return ownsThreadDiagnostics(); });
   }
   if (!initializeInvocation()) {
     return false;
@@ -841,6 +975,7 @@ bool Invocation::parseSource(Source &source) {
 }
 
 bool Invocation::importModule(Operation *inputModule, bool steal) {
+  InvocationScope scope(this);
   // Take ownership of the module first so we don't have anything dangling
   // on error.
   this->parsedModule = inputModule;
@@ -906,13 +1041,7 @@ void Invocation::dumpCompilationPhase(IREEVMPipelinePhase phase,
   if (!parsedModule || dumpCompilationPhasesTo.empty())
     return;
 
-  std::string phaseName;
-  enumerateIREEVMPipelinePhases(
-      [&](IREEVMPipelinePhase enumeratedPhase, StringRef name, StringRef desc) {
-        if (enumeratedPhase == phase)
-          phaseName = name;
-      });
-
+  std::string phaseName = getPhaseName(phase);
   std::string fileName =
       guessModuleName(cast<ModuleOp>(parsedModule), "module") + "." +
       std::to_string(static_cast<int>(phase)) + "." + phaseName + ".mlir";
@@ -925,7 +1054,13 @@ void Invocation::dumpCompilationPhase(IREEVMPipelinePhase phase,
       IREE::Util::createDumpModulePass(std::string(path.begin(), path.end())));
 }
 
+void Invocation::printCompileStatistics() {
+  if (compileStatistics)
+    compileStatistics->print(llvm::errs());
+}
+
 bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
+  InvocationScope scope(this);
   auto passManager = createPassManager();
   switch (pipeline) {
   case IREE_COMPILER_PIPELINE_STD: {
@@ -992,7 +1127,9 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
     return false;
   }
 
-  if (failed(passManager->run(parsedModule))) {
+  bool succeeded = !failed(passManager->run(parsedModule));
+  printCompileStatistics();
+  if (!succeeded) {
     return false;
   }
   // Done with the pipeline, mark the start of a new 'frame'.
@@ -1001,14 +1138,14 @@ bool Invocation::runPipeline(enum iree_compiler_pipeline_t pipeline) {
 }
 
 bool Invocation::runTextualPassPipeline(const char *textPassPipeline) {
+  InvocationScope scope(this);
   auto passManager = createPassManager();
   if (failed(mlir::parsePassPipeline(textPassPipeline, *passManager,
                                      llvm::errs())))
     return false;
-  if (failed(passManager->run(parsedModule))) {
-    return false;
-  }
-  return true;
+  bool succeeded = !failed(passManager->run(parsedModule));
+  printCompileStatistics();
+  return succeeded;
 }
 
 Error *Invocation::outputIR(Output &output) {
@@ -1028,6 +1165,7 @@ Error *Invocation::outputIRBytecode(Output &output, int bytecodeVersion) {
 }
 
 Error *Invocation::outputVMBytecode(Output &output) {
+  InvocationScope scope(this);
   auto vmModule = llvm::dyn_cast<IREE::VM::ModuleOp>(*parsedModule);
   auto builtinModule = llvm::dyn_cast<mlir::ModuleOp>(*parsedModule);
   LogicalResult result = failure();
@@ -1053,6 +1191,7 @@ Error *Invocation::outputVMCSource(Output &output) {
 #ifndef IREE_HAVE_C_OUTPUT_FORMAT
   return new Error("VM C source output not enabled");
 #else
+  InvocationScope scope(this);
   auto vmModule = llvm::dyn_cast<IREE::VM::ModuleOp>(*parsedModule);
   auto builtinModule = llvm::dyn_cast<mlir::ModuleOp>(*parsedModule);
   LogicalResult result = failure();
@@ -1075,6 +1214,7 @@ Error *Invocation::outputVMCSource(Output &output) {
 }
 
 Error *Invocation::outputHALExecutable(Output &output) {
+  InvocationScope scope(this);
   // Extract the serialized binary representation from the executable.
   auto &block = parsedModule->getRegion(0).front();
   auto executableOp = *(block.getOps<IREE::HAL::ExecutableOp>().begin());
@@ -1333,6 +1473,11 @@ void ireeCompilerSessionGetFlags(
   unwrap(session)->getFlags(nonDefaultOnly, onFlag, userData);
 }
 
+iree_compiler_error_t *
+ireeCompilerSessionPrepare(iree_compiler_session_t *session) {
+  return wrap(unwrap(session)->prepare());
+}
+
 iree_compiler_invocation_t *
 ireeCompilerInvocationCreate(iree_compiler_session_t *session) {
   return wrap(new Invocation(*unwrap(session)));
@@ -1425,6 +1570,16 @@ void ireeCompilerInvocationSetVerifyIR(iree_compiler_invocation_t *inv,
   unwrap(inv)->enableVerifier = enable;
 }
 
+void ireeCompilerInvocationSetCompileStatistics(iree_compiler_invocation_t *inv,
+                                                bool enable) {
+  auto &compileStatistics = unwrap(inv)->compileStatistics;
+  if (!enable) {
+    compileStatistics.reset();
+  } else if (!compileStatistics) {
+    compileStatistics = std::make_unique<CompileStatistics>();
+  }
+}
+
 bool ireeCompilerInvocationPipeline(iree_compiler_invocation_t *inv,
                                     enum iree_compiler_pipeline_t pipeline) {
   return unwrap(inv)->runPipeline(pipeline);
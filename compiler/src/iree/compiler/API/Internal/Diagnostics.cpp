@@ -70,8 +70,9 @@ std::optional<Location> findLocToShow(Location loc) {
 } // namespace
 
 FormattingDiagnosticHandler::FormattingDiagnosticHandler(MLIRContext *ctx,
-                                                         Callback callback)
-    : ctx(ctx), callback(std::move(callback)) {
+                                                         Callback callback,
+                                                         Filter filter)
+    : ctx(ctx), callback(std::move(callback)), filter(std::move(filter)) {
   handlerID = ctx->getDiagEngine().registerHandler(std::bind(
       &FormattingDiagnosticHandler::emit, this, std::placeholders ::_1));
 }
@@ -81,6 +82,10 @@ FormattingDiagnosticHandler::~FormattingDiagnosticHandler() {
 }
 
 LogicalResult FormattingDiagnosticHandler::emit(Diagnostic &diag) {
+  if (filter && !filter()) {
+    return failure();
+  }
+
   std::string messageAccum;
   llvm::raw_string_ostream os(messageAccum);
 
@@ -28,8 +28,13 @@ class FormattingDiagnosticHandler {
 public:
   using Callback = std::function<void(DiagnosticSeverity severity,
                                       std::string_view message)>;
+  // Returns true if the handler should handle the current diagnostic.
+  // Diagnostics filtered out are passed on to the next handler registered
+  // with the context.
+  using Filter = std::function<bool()>;
 
-  FormattingDiagnosticHandler(MLIRContext *ctx, Callback callback);
+  FormattingDiagnosticHandler(MLIRContext *ctx, Callback callback,
+                              Filter filter = nullptr);
   ~FormattingDiagnosticHandler();
 
   LogicalResult emit(Diagnostic &diag);
@@ -38,6 +43,7 @@ private:
   DiagnosticEngine::HandlerID handlerID;
   MLIRContext *ctx;
   Callback callback;
+  Filter filter;
 };
 
 } // namespace mlir::iree_compiler::embed
@@ -34,6 +34,7 @@ extern void ireeCompilerInvocationParseSource();
 extern void ireeCompilerInvocationPipeline();
 extern void ireeCompilerInvocationRunPassPipeline();
 extern void ireeCompilerInvocationSetCompileFromPhase();
+extern void ireeCompilerInvocationSetCompileStatistics();
 extern void ireeCompilerInvocationSetCompileToPhase();
 extern void ireeCompilerInvocationSetCrashHandler();
 extern void ireeCompilerInvocationSetDumpCompilationPhasesTo();
@@ -52,6 +53,7 @@ extern void ireeCompilerSessionBorrowContext();
 extern void ireeCompilerSessionCreate();
 extern void ireeCompilerSessionDestroy();
 extern void ireeCompilerSessionGetFlags();
+extern void ireeCompilerSessionPrepare();
 extern void ireeCompilerSessionSetFlags();
 extern void ireeCompilerSessionStealContext();
 extern void ireeCompilerSetupGlobalCL();
@@ -730,6 +732,7 @@ uintptr_t __iree_compiler_hidden_force_extern() {
   x += (uintptr_t)&ireeCompilerInvocationPipeline;
   x += (uintptr_t)&ireeCompilerInvocationRunPassPipeline;
   x += (uintptr_t)&ireeCompilerInvocationSetCompileFromPhase;
+  x += (uintptr_t)&ireeCompilerInvocationSetCompileStatistics;
   x += (uintptr_t)&ireeCompilerInvocationSetCompileToPhase;
   x += (uintptr_t)&ireeCompilerInvocationSetCrashHandler;
   x += (uintptr_t)&ireeCompilerInvocationSetDumpCompilationPhasesTo;
@@ -748,6 +751,7 @@ uintptr_t __iree_compiler_hidden_force_extern() {
   x += (uintptr_t)&ireeCompilerSessionCreate;
   x += (uintptr_t)&ireeCompilerSessionDestroy;
   x += (uintptr_t)&ireeCompilerSessionGetFlags;
+  x += (uintptr_t)&ireeCompilerSessionPrepare;
   x += (uintptr_t)&ireeCompilerSessionSetFlags;
   x += (uintptr_t)&ireeCompilerSessionStealContext;
   x += (uintptr_t)&ireeCompilerSetupGlobalCL;
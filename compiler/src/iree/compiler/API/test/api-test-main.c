@@ -74,6 +74,16 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  // Prepare the session for reuse.
+  err = ireeCompilerSessionPrepare(state.session);
+  if (err) {
+    fprintf(stderr, "ERROR: %s\n", ireeCompilerErrorGetMessage(err));
+    ireeCompilerErrorDestroy(err);
+    mlirOperationDestroy(module);
+    shutdownCompiler(&state);
+    return 1;
+  }
+
   // Import module.
   iree_compiler_invocation_t *inv = ireeCompilerInvocationCreate(state.session);
   if (!ireeCompilerInvocationImportStealModule(inv, module)) {
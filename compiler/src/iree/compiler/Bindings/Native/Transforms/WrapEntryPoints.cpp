@@ -10,6 +10,7 @@
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "mlir/Dialect/Affine/Utils.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/IR/Attributes.h"
@@ -421,6 +422,19 @@ static void populateReflectionAttrs(IREE::ABI::InvocationModel invocationModel,
     break;
   }
 
+  // Record the arguments providing result storage so that callers know their
+  // contents may be overwritten in-place by the invocation (such as when the
+  // arguments are donated).
+  SmallVector<std::string> storageArgs;
+  for (unsigned i = 0; i < exportOp.getNumArguments(); ++i) {
+    if (exportOp.getArgAttrOfType<IntegerAttr>(i, "iree.abi.output"))
+      storageArgs.push_back(std::to_string(i));
+  }
+  if (!storageArgs.empty()) {
+    attrs.emplace_back(StringAttr::get(context, "iree.abi.output_storage"),
+                       StringAttr::get(context, llvm::join(storageArgs, ",")));
+  }
+
   // If not provided by the user add the source declaration as the MLIR type.
   // Users in source frontends can override this with something more natural
   // (python/whatever).
@@ -274,6 +274,81 @@ matchDAGForUKernel(RewriterBase &rewriter, linalg::Mmt4DOp op,
       genericMicroKernelOp.getOperation());
 }
 
+/// Matches an (linalg.fill -> )? linalg.generic operation sequence, where the
+/// linalg.generic is the data-tiled form of a matmul with a grouped-quantized
+/// RHS, and converts it into a iree_codegen.ukernel.mmt4d_dequant operation,
+/// that is later lowered into a call to the microkernel.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, linalg::GenericOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "mmt4d_dequant";
+  if (!hasUkernel(targetAttr, ukernelName)) {
+    return failure();
+  }
+  FailureOr<int64_t> groupSize = getMmt4dDequantGroupSize(op);
+  if (failed(groupSize)) {
+    return rewriter.notifyMatchFailure(
+        op, "not a data-tiled matmul with grouped-quantized RHS");
+  }
+  Value lhs = op.getDpsInputOperand(0)->get();
+  Value rhs = op.getDpsInputOperand(1)->get();
+  Value scales = op.getDpsInputOperand(2)->get();
+  Value zeroPoints = op.getDpsInputOperand(3)->get();
+  Value out = op.getDpsInitOperand(0)->get();
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  Type scalesElemType = getElementTypeOrSelf(scales.getType());
+  uint32_t flags = scalesElemType.isF16()
+                       ? IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F16F32
+                       : IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4BF16F32;
+
+  // Check if the accumulator is zero-filled.
+  if (isInitializedToZero(out)) {
+    // Not setting flags |= IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE, so the
+    // ukernel won't read the existing accumulator, so its defining op can be
+    // discarded.
+    if (auto fillOp = out.getDefiningOp<linalg::FillOp>()) {
+      out = fillOp.getDpsInitOperand(0)->get();
+    }
+  } else {
+    // Tell the ukernel to read the existing accumulator.
+    flags |= IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE;
+  }
+
+  // As for mmt4d, there is no ukernel info query yet to preserve the
+  // linalg.generic as a fallback for tile shapes without a fast code path.
+  flags |= IREE_UK_FLAG_MMT4D_DEQUANT_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION;
+
+  Location loc = op.getLoc();
+  Value m = rewriter.create<tensor::DimOp>(loc, lhs, 0);
+  Value n = rewriter.create<tensor::DimOp>(loc, rhs, 0);
+  Value k = rewriter.create<tensor::DimOp>(loc, rhs, 1);
+
+  auto getDimAsI32 = [](RewriterBase &rewriter, Location loc, Value value,
+                        int dim) -> Value {
+    return rewriter.create<arith::IndexCastOp>(
+        loc, rewriter.getI32Type(),
+        rewriter.create<tensor::DimOp>(loc, value, dim));
+  };
+  Value m0 = getDimAsI32(rewriter, loc, lhs, 2);
+  Value n0 = getDimAsI32(rewriter, loc, rhs, 2);
+  Value k0 = getDimAsI32(rewriter, loc, rhs, 3);
+  Value groupSizeVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(*groupSize));
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
+  SmallVector<Type> returnTypes =
+      getUKernelGenericReturnTypes(targetAttr, outType);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, returnTypes, fn.name, ValueRange{lhs, rhs, scales, zeroPoints}, out,
+      ValueRange{m, n, k, m0, n0, k0, groupSizeVal, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
 static FailureOr<IREE::Codegen::UKernelOpInterface>
 matchDAGForUKernel(RewriterBase &rewriter, tensor::PackOp op,
                    bool /*skipIntermediateRoundings*/) {
@@ -627,6 +702,7 @@ void CPULowerToUKernelsPass::runOnOperation() {
   // these ops.
   auto allTargets = [](auto target) { return true; };
   patterns.insert<LowerToUKernelPattern<linalg::Mmt4DOp>,
+                  LowerToUKernelPattern<linalg::GenericOp>,
                   LowerToUKernelPattern<tensor::PackOp>,
                   LowerToUKernelPattern<tensor::UnPackOp>>(
       context, allTargets, skipIntermediateRoundings);
@@ -15,6 +15,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
 #include "mlir/Dialect/MemRef/Transforms/Transforms.h"
@@ -72,6 +73,67 @@ enumerateMatmulTileRiscv32(ExecutableTargetAttr target) {
   return {};
 }
 
+// Enumerate tile sizes to choose from on riscv64.
+// For narrow-{M,N} cases, this only enumerates on narrow M. The narrow-N cases
+// are handled by transposition in chooseMatmulTile.
+static SmallVector<TileMxNxK>
+enumerateMatmulTileRiscv64(TypeRange elementTypes,
+                           ExecutableTargetAttr target) {
+  // The RVV ukernels are the only consumers of data-tiled layouts on riscv64
+  // for now; without them, codegen is better off on the untiled matmul.
+  if (!hasUkernel(target) || !hasFeature(target, "+v")) {
+    return {};
+  }
+
+  assert(elementTypes.size() == 3);
+  Type lhs = elementTypes[0];
+  Type rhs = elementTypes[1];
+  Type out = elementTypes[2];
+
+  if ((lhs.isF32() && rhs.isF32() && out.isF32()) ||
+      (lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8) &&
+       out.isSignlessInteger(32))) {
+    return {
+        TileMxNxK{8, 8, 1}, // Aim to use VFMACC.VF or VWMACC.VX.
+        TileMxNxK{4, 8, 1}, // Truncation of the above.
+        TileMxNxK{2, 8, 1}, // Truncation of the above.
+        TileMxNxK{1, 8, 1}, // Truncation of the above.
+    };
+  }
+  // Fallback - no architecture-optimized tile size for this case.
+  return {};
+}
+
+// Enumerate tile sizes to choose from on wasm32.
+// For narrow-{M,N} cases, this only enumerates on narrow M. The narrow-N cases
+// are handled by transposition in chooseMatmulTile.
+static SmallVector<TileMxNxK>
+enumerateMatmulTileWasm32(TypeRange elementTypes, ExecutableTargetAttr target) {
+  // The SIMD128 ukernels are the only consumers of data-tiled layouts on
+  // wasm32 for now; without them, codegen is better off on the untiled matmul.
+  if (!hasUkernel(target) || !hasFeature(target, "+simd128")) {
+    return {};
+  }
+
+  assert(elementTypes.size() == 3);
+  Type lhs = elementTypes[0];
+  Type rhs = elementTypes[1];
+  Type out = elementTypes[2];
+
+  if ((lhs.isF32() && rhs.isF32() && out.isF32()) ||
+      (lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8) &&
+       out.isSignlessInteger(32))) {
+    return {
+        TileMxNxK{8, 8, 1}, // Two 128-bit accumulators per row.
+        TileMxNxK{4, 8, 1}, // Truncation of the above.
+        TileMxNxK{2, 8, 1}, // Truncation of the above.
+        TileMxNxK{1, 8, 1}, // Truncation of the above.
+    };
+  }
+  // Fallback - no architecture-optimized tile size for this case.
+  return {};
+}
+
 // Enumerate tile sizes to choose from on arm64.
 // For narrow-{M,N} cases, this only enumerates on narrow M. The narrow-N cases
 // are handled by transposition in chooseMatmulTile.
@@ -213,6 +275,16 @@ enumerateMatmulTileX86_64(TypeRange elementTypes, ExecutableTargetAttr target) {
 
   if (out.isF32() || out.isF16() || out.isBF16()) {
     if (lhs.isBF16() && rhs.isBF16() && (out.isBF16() || out.isF32())) {
+      if (out.isF32() && hasUkernel(target) &&
+          hasFeature(target, "+amx-bf16")) {
+        return {
+            TileMxNxK{16, 16, 32}, // Aim to use TDPBF16PS.
+            TileMxNxK{8, 16, 32},  // Truncation of the above.
+            TileMxNxK{4, 16, 32},  // Truncation of the above.
+            TileMxNxK{2, 16, 32},  // Truncation of the above.
+            TileMxNxK{1, 16, 32},  // Truncation of the above.
+        };
+      }
       if (hasFeature(target, "+avx512bf16")) {
         return {
             TileMxNxK{16, 16, 2}, // Aim to use VDPBF16PS (zmm).
@@ -223,6 +295,16 @@ enumerateMatmulTileX86_64(TypeRange elementTypes, ExecutableTargetAttr target) {
         };
       }
     }
+    if (lhs.isF16() && rhs.isF16() && out.isF16() && hasUkernel(target) &&
+        hasFeature(target, "+avx512fp16")) {
+      return {
+          TileMxNxK{16, 32, 1}, // Aim to use VFMADD*PH (zmm).
+          TileMxNxK{8, 32, 1},  // Truncation of the above.
+          TileMxNxK{4, 32, 1},  // Truncation of the above.
+          TileMxNxK{2, 32, 1},  // Truncation of the above.
+          TileMxNxK{1, 32, 1},  // Truncation of the above.
+      };
+    }
     if (isa<FloatType>(lhs) && isa<FloatType>(rhs)) {
       // Note: 16-bit floating point types currently use the same tile size as
       // f32. This makes sense when either (1) the accumulator is f32, or (2)
@@ -273,6 +355,17 @@ enumerateMatmulTileX86_64(TypeRange elementTypes, ExecutableTargetAttr target) {
   if (out.isSignlessInteger(32) &&
       ((lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8)) ||
        (lhs.isSignlessInteger(16) && rhs.isSignlessInteger(16)))) {
+    if (lhs.isSignlessInteger(8) && hasUkernel(target) &&
+        hasFeature(target, "+amx-int8")) {
+      // Only the ukernels use AMX: the whole tile is one TDPBSSD per K-step.
+      return {
+          TileMxNxK{16, 16, 64}, // Aim to use TDPBSSD.
+          TileMxNxK{8, 16, 64},  // Truncation of the above.
+          TileMxNxK{4, 16, 64},  // Truncation of the above.
+          TileMxNxK{2, 16, 64},  // Truncation of the above.
+          TileMxNxK{1, 16, 64},  // Truncation of the above.
+      };
+    }
     if (hasFeature(target, "+avx512vnni")) {
       // This is the same tile size as with VPMADDWD as the only difference
       // is that VPDPWSSD accumulates. VPDPBUSD would call for {16, 16, 4} but
@@ -425,12 +518,108 @@ chooseMatmulTile(ArrayRef<TileMxNxK> enumeratedTiles, int64_t matmulNarrowM,
   return bestRatedTile;
 }
 
+// Enumerate the tile sizes tuned for the target CPU model, if any, as listed
+// in CPUEncodingTunedTiles.inc. The tuned tile comes first, followed by its
+// power-of-two truncations along M. These were measured with the mmt4d
+// ukernel, so they are only used when that ukernel is enabled.
+static SmallVector<TileMxNxK>
+enumerateTunedMatmulTiles(TypeRange elementTypes, ExecutableTargetAttr target) {
+  if (!hasUkernel(target, "mmt4d")) {
+    return {};
+  }
+  std::optional<StringAttr> cpu = getConfigStringAttr(target, "cpu");
+  if (!cpu) {
+    return {};
+  }
+  assert(elementTypes.size() == 3);
+  auto getTypeStr = [](Type type) {
+    std::string str;
+    llvm::raw_string_ostream os(str);
+    type.print(os);
+    return os.str();
+  };
+  std::string lhs = getTypeStr(elementTypes[0]);
+  std::string rhs = getTypeStr(elementTypes[1]);
+  std::string out = getTypeStr(elementTypes[2]);
+#define IREE_CPU_ENCODING_TUNED_MATMUL_TILE(CPU, LHS, RHS, OUT, M0, N0, K0,   \
+                                            FEATURE)                          \
+  if (cpu->getValue() == CPU && lhs == LHS && rhs == RHS && out == OUT &&     \
+      (StringRef(FEATURE).empty() || hasFeature(target, FEATURE))) {          \
+    SmallVector<TileMxNxK> tiles;                                             \
+    for (int64_t m = M0; m >= 1; m /= 2) {                                    \
+      tiles.push_back(TileMxNxK{m, N0, K0});                                  \
+    }                                                                         \
+    return tiles;                                                             \
+  }
+#include "iree/compiler/Codegen/Common/CPU/CPUEncodingTunedTiles.inc"
+#undef IREE_CPU_ENCODING_TUNED_MATMUL_TILE
+  return {};
+}
+
+// Enumerate tile sizes to choose from for matmuls with a grouped-quantized RHS,
+// whose encodings carry a fourth element type for the scales and zero points.
+// These are only data-tiled for the mmt4d_dequant ukernel, so the tiles match
+// its tile functions.
+static SmallVector<TileMxNxK>
+enumerateDequantMatmulTileMxNxK(TypeRange elementTypes,
+                                ExecutableTargetAttr target) {
+  if (!hasUkernel(target, "mmt4d_dequant")) {
+    return {};
+  }
+  assert(elementTypes.size() == 4);
+  Type lhs = elementTypes[0];
+  Type rhs = elementTypes[1];
+  Type out = elementTypes[2];
+  Type scales = elementTypes[3];
+  if (!lhs.isF32() || !rhs.isUnsignedInteger(4) || !out.isF32() ||
+      !(scales.isF16() || scales.isBF16())) {
+    return {};
+  }
+  if (isAArch64(target)) {
+    return {
+        TileMxNxK{8, 8, 2}, // Aim to use FMLA on dequantized RHS pairs.
+        TileMxNxK{4, 8, 2}, // Truncation of the above.
+        TileMxNxK{2, 8, 2}, // Truncation of the above.
+        TileMxNxK{1, 8, 2}, // Truncation of the above.
+    };
+  }
+  if (isX86_64(target)) {
+    if (hasFeature(target, "+avx512f")) {
+      return {
+          TileMxNxK{16, 16, 2}, // Aim to use VFMADD* (zmm).
+          TileMxNxK{8, 16, 2},  // Truncation of the above.
+          TileMxNxK{4, 16, 2},  // Truncation of the above.
+          TileMxNxK{2, 16, 2},  // Truncation of the above.
+          TileMxNxK{1, 16, 2},  // Truncation of the above.
+      };
+    }
+    if (hasFeature(target, "+avx2") && hasFeature(target, "+fma")) {
+      return {
+          TileMxNxK{8, 8, 2}, // Aim to use VFMADD* (ymm).
+          TileMxNxK{4, 8, 2}, // Truncation of the above.
+          TileMxNxK{2, 8, 2}, // Truncation of the above.
+          TileMxNxK{1, 8, 2}, // Truncation of the above.
+      };
+    }
+  }
+  // Fallback - the generic tile function is too slow to be worth data-tiling.
+  return {};
+}
+
 SmallVector<TileMxNxK>
 enumerateMatmulTileMxNxK(linalg::ContractionDimensions cDims,
                          TypeRange elementTypes, ExecutableTargetAttr target) {
   if (isVMVXBackend(target)) {
     return enumerateMatmulTilesVMVX(cDims, target);
   }
+  if (elementTypes.size() == 4) {
+    return enumerateDequantMatmulTileMxNxK(elementTypes, target);
+  }
+  SmallVector<TileMxNxK> tunedTiles =
+      enumerateTunedMatmulTiles(elementTypes, target);
+  if (!tunedTiles.empty()) {
+    return tunedTiles;
+  }
   if (isAArch64(target)) {
     return enumerateMatmulTileArm64(elementTypes, target);
   }
@@ -440,6 +629,12 @@ enumerateMatmulTileMxNxK(linalg::ContractionDimensions cDims,
   if (isRISCV32(target)) {
     return enumerateMatmulTileRiscv32(target);
   }
+  if (isRISCV64(target)) {
+    return enumerateMatmulTileRiscv64(elementTypes, target);
+  }
+  if (isWasm32(target)) {
+    return enumerateMatmulTileWasm32(elementTypes, target);
+  }
   return {};
 }
 
@@ -509,7 +704,8 @@ materializeEncodingForTarget(RankedTensorType tensorType,
   // the whole matmul and swapping LHS<->RHS, reducing the narrow-N case to
   // narrow-M.
   int64_t matmulNarrowM = getIntOrZero(encoding.getMatmulNarrow_M());
-  int64_t matmulNarrowN = hasUkernel(targetAttr, "mmt4d")
+  int64_t matmulNarrowN = hasUkernel(targetAttr, "mmt4d") ||
+                                  hasUkernel(targetAttr, "mmt4d_dequant")
                               ? 0
                               : getIntOrZero(encoding.getMatmulNarrow_N());
   // Choose a final matmul TileMxNxK from the above-enumarated tile shapes,
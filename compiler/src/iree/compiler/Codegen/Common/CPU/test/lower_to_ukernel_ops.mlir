@@ -256,6 +256,53 @@ func.func @mmt4d_bf16bf16f32(%arg0 : tensor<?x?x16x2xbf16>, %arg1 : tensor<?x?x1
 
 // CHECK-LABEL: func @pack_i8i8_x86(
 //       CHECK: ukernel.generic "iree_uk_pack"
+#map = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d2, d3, d5)>
+#map1 = affine_map<(d0, d1, d2, d3, d4, d5) -> (d1, d2, d4, d5)>
+#map2 = affine_map<(d0, d1, d2, d3, d4, d5) -> (d1, d2 floordiv 8, d4)>
+#map3 = affine_map<(d0, d1, d2, d3, d4, d5) -> (d0, d1, d3, d4)>
+func.func @mmt4d_dequant_f32u4f16f32(%arg0 : tensor<1x32x16x2xf32>,
+    %arg1 : tensor<2x32x16x2xi4>, %arg2 : tensor<2x4x16xf16>,
+    %arg3 : tensor<2x4x16xf16>, %arg4 : tensor<1x2x16x16xf32>) -> tensor<1x2x16x16xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "mmt4d_dequant", target_triple="x86_64-xyz-xyz", cpu_features="+avx512f"}>
+} {
+  %0 = linalg.generic {
+      indexing_maps = [#map, #map1, #map2, #map2, #map3],
+      iterator_types = ["parallel", "parallel", "reduction", "parallel", "parallel", "reduction"]}
+      ins(%arg0, %arg1, %arg2, %arg3 : tensor<1x32x16x2xf32>, tensor<2x32x16x2xi4>, tensor<2x4x16xf16>, tensor<2x4x16xf16>)
+      outs(%arg4 : tensor<1x2x16x16xf32>) {
+  ^bb0(%in: f32, %in_0: i4, %in_1: f16, %in_2: f16, %acc: f32):
+    %1 = arith.extui %in_0 : i4 to i32
+    %2 = arith.uitofp %1 : i32 to f32
+    %3 = arith.extf %in_2 : f16 to f32
+    %4 = arith.subf %2, %3 : f32
+    %5 = arith.extf %in_1 : f16 to f32
+    %6 = arith.mulf %4, %5 : f32
+    %7 = arith.mulf %in, %6 : f32
+    %8 = arith.addf %7, %acc : f32
+    linalg.yield %8 : f32
+  } -> tensor<1x2x16x16xf32>
+  return %0 : tensor<1x2x16x16xf32>
+}
+// CHECK-LABEL: func @mmt4d_dequant_f32u4f16f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<1x32x16x2xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<2x32x16x2xi4>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<2x4x16xf16>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<2x4x16xf16>
+// CHECK-SAME:     %[[ARG4:[a-zA-Z0-9]+]]: tensor<1x2x16x16xf32>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 769 : i32
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[C2:.+]] = arith.constant 2 : index
+//  CHECK-DAG:   %[[C32:.+]] = arith.constant 32 : index
+//  CHECK-DAG:   %[[C2_i32:.+]] = arith.constant 2 : i32
+//  CHECK-DAG:   %[[C16_i32:.+]] = arith.constant 16 : i32
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_mmt4d_dequant"
+// CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]], %[[ARG2]], %[[ARG3]] :
+// CHECK-SAME:       outs(%[[ARG4]] :
+// CHECK-SAME:       (%[[C1]], %[[C2]], %[[C32]], %[[C16_i32]], %[[C16_i32]], %[[C2_i32]], %[[C16_i32]], %[[FLAGS]] :
+//      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
 func.func @pack_i8i8_x86(%arg0 : tensor<?x?xi8>, %arg1 : tensor<?x?x7x8xi8>, %arg2 : i8) -> tensor<?x?x7x8xi8> attributes {
   hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features="+avx512f"}>
 } {
@@ -6,11 +6,12 @@
 
 //===----------------------------------------------------------------------===//
 //
-// This file implements a pass to emulate 16-bit brain float arithmetic
-// operations with float 32 equivalents.
+// This file implements passes to emulate 16-bit brain float and 8-bit float
+// arithmetic operations with float 32 equivalents.
 //
 //===----------------------------------------------------------------------===//
 
+#include <cmath>
 #include <memory>
 #include <utility>
 
@@ -235,80 +236,383 @@ struct PromoteBF16ToF32Converter
   }
 };
 
+// Promotes all arithmetic on the types converted by |typeConverter| nested
+// within |rootOp| to the converted types.
+static LogicalResult promoteArithmetic(Operation *rootOp,
+                                       TypeConverter &typeConverter) {
+  MLIRContext *context = rootOp->getContext();
+  RewritePatternSet patterns(context);
+  patterns.insert<GenericTypeConversionPattern>(context, typeConverter);
+  patterns.insert<ConvertTypeSensitiveArithCastOp<arith::TruncFOp, FloatType,
+                                                  std::greater<unsigned>>>(
+      typeConverter, context);
+  patterns.insert<ConvertTypeSensitiveArithCastOp<arith::ExtFOp, FloatType,
+                                                  std::less<unsigned>>>(
+      typeConverter, context);
+  patterns.insert<ConvertTypeSensitiveArithCastOp<
+      arith::TruncIOp, IntegerType, std::less<unsigned>>>(typeConverter,
+                                                          context);
+  patterns.insert<ConvertTypeSensitiveArithCastOp<arith::ExtUIOp, IntegerType,
+                                                  std::less<unsigned>>>(
+      typeConverter, context);
+  patterns.insert<ConvertTypeSensitiveArithCastOp<arith::ExtSIOp, IntegerType,
+                                                  std::less<unsigned>>>(
+      typeConverter, context);
+  ConversionTarget target(*context);
+  target.markUnknownOpDynamicallyLegal([](Operation *op) { return true; });
+
+  auto checkOp = [&](Operation *op) {
+    for (Type type : op->getResultTypes()) {
+      if (!typeConverter.isLegal(type))
+        return false;
+    }
+    for (Type type : op->getOperandTypes()) {
+      if (!typeConverter.isLegal(type))
+        return false;
+    }
+    for (auto &region : op->getRegions()) {
+      if (!typeConverter.isLegal(&region))
+        return false;
+    }
+    return true;
+  };
+
+  // Operations are legal if they don't contain any illegal type.
+  target.addDynamicallyLegalDialect<arith::ArithDialect>(checkOp);
+  target.addDynamicallyLegalDialect<math::MathDialect>(checkOp);
+
+  // Some arithmetic operations exist in the vector dialect.
+  target.addDynamicallyLegalOp<vector::FMAOp, vector::ReductionOp,
+                               vector::MultiDimReductionOp, vector::MaskOp,
+                               vector::MatmulOp, vector::OuterProductOp,
+                               vector::YieldOp>(checkOp);
+
+  // Some ops are always legal.
+  target.addLegalOp<arith::BitcastOp>();
+
+  if (failed(applyFullConversion(rootOp, target, std::move(patterns)))) {
+    return failure();
+  }
+
+  // This is due to arith.extf and arith.truncf validation failing on
+  // rank-0 vectors. These can only be generated by arith.constant so
+  // in these cases we just propagate the type.
+  RewritePatternSet cleanupPatterns(context);
+  cleanupPatterns
+      .insert<PropagateCastF<arith::TruncFOp>, PropagateCastF<arith::ExtFOp>>(
+          context);
+  return applyPatternsAndFoldGreedily(rootOp, std::move(cleanupPatterns));
+}
+
 struct ConvertBf16ArithToF32Pass
     : public ConvertBf16ArithToF32Base<ConvertBf16ArithToF32Pass> {
   using ConvertBf16ArithToF32Base::ConvertBf16ArithToF32Base;
   void runOnOperation() override {
-    MLIRContext *context = &this->getContext();
-    RewritePatternSet patterns(context);
-    patterns.insert<GenericTypeConversionPattern>(context, typeConverter);
-    patterns.insert<ConvertTypeSensitiveArithCastOp<arith::TruncFOp, FloatType,
-                                                    std::greater<unsigned>>>(
-        typeConverter, context);
-    patterns.insert<ConvertTypeSensitiveArithCastOp<arith::ExtFOp, FloatType,
-                                                    std::less<unsigned>>>(
-        typeConverter, context);
-    patterns.insert<ConvertTypeSensitiveArithCastOp<
-        arith::TruncIOp, IntegerType, std::less<unsigned>>>(typeConverter,
-                                                            context);
-    patterns.insert<ConvertTypeSensitiveArithCastOp<arith::ExtUIOp, IntegerType,
-                                                    std::less<unsigned>>>(
-        typeConverter, context);
-    patterns.insert<ConvertTypeSensitiveArithCastOp<arith::ExtSIOp, IntegerType,
-                                                    std::less<unsigned>>>(
-        typeConverter, context);
-    ConversionTarget target(*context);
-    target.markUnknownOpDynamicallyLegal([](Operation *op) { return true; });
-
-    auto checkOp = [&](Operation *op) {
-      for (Type type : op->getResultTypes()) {
-        if (!typeConverter.isLegal(type))
-          return false;
-      }
-      for (Type type : op->getOperandTypes()) {
-        if (!typeConverter.isLegal(type))
-          return false;
-      }
-      for (auto &region : op->getRegions()) {
-        if (!typeConverter.isLegal(&region))
-          return false;
-      }
-      return true;
+    if (failed(promoteArithmetic(this->getOperation(), typeConverter))) {
+      return this->signalPassFailure();
+    }
+  }
+
+  PromoteBF16ToF32Converter typeConverter;
+};
+
+//===----------------------------------------------------------------------===//
+// FP8 emulation
+//===----------------------------------------------------------------------===//
+
+// Bit layout of the 8-bit float types we emulate.
+struct F8Format {
+  unsigned mantissaBits;
+  int64_t bias;
+  // True if the all-ones exponent encodes inf/nan as in IEEE types. Otherwise
+  // only the all-ones magnitude encodes nan and there is no inf.
+  bool hasInf;
+
+  int64_t getInfBits() const {
+    return ((1 << (7 - mantissaBits)) - 1) << mantissaBits;
+  }
+  int64_t getMaxFiniteBits() const { return hasInf ? getInfBits() - 1 : 0x7E; }
+  int64_t getNaNBits() const {
+    return hasInf ? getInfBits() | (1 << (mantissaBits - 1)) : 0x7F;
+  }
+  // Values rounding past the largest finite value become inf when supported
+  // and nan otherwise.
+  int64_t getOverflowBits() const { return hasInf ? getInfBits() : 0x7F; }
+};
+
+static std::optional<F8Format> getF8Format(Type type) {
+  Type elementType = getElementTypeOrSelf(type);
+  if (elementType.isFloat8E4M3FN())
+    return F8Format{/*mantissaBits=*/3, /*bias=*/7, /*hasInf=*/false};
+  if (elementType.isFloat8E5M2())
+    return F8Format{/*mantissaBits=*/2, /*bias=*/15, /*hasInf=*/true};
+  return std::nullopt;
+}
+
+// Returns |type| with its element type replaced by |elementType|.
+static Type getTypeWithElementType(Type type, Type elementType) {
+  if (auto vectorType = dyn_cast<VectorType>(type)) {
+    return VectorType::get(vectorType.getShape(), elementType,
+                           vectorType.getScalableDims());
+  }
+  return elementType;
+}
+
+// Creates a scalar or splat vector constant of |type|.
+static Value createConstant(OpBuilder &builder, Location loc, Type type,
+                            TypedAttr scalarAttr) {
+  if (auto vectorType = dyn_cast<VectorType>(type)) {
+    return builder.create<arith::ConstantOp>(
+        loc, vectorType, DenseElementsAttr::get(vectorType, scalarAttr));
+  }
+  return builder.create<arith::ConstantOp>(loc, type, scalarAttr);
+}
+
+static Value createI32Constant(OpBuilder &builder, Location loc, Type type,
+                               int64_t value) {
+  return createConstant(builder, loc, type, builder.getI32IntegerAttr(value));
+}
+
+static Value createF32Constant(OpBuilder &builder, Location loc, Type type,
+                               float value) {
+  return createConstant(builder, loc, type, builder.getF32FloatAttr(value));
+}
+
+// Converts FP8s to F32s.
+struct PromoteF8ToF32Converter
+    : public FloatTypeConverter<FloatType, Float32Type> {
+  bool isSourceType(FloatType type) override {
+    return getF8Format(type).has_value();
+  }
+  Type getTargetType(FloatType type) override {
+    return Float32Type::get(type.getContext());
+  }
+};
+
+// Splits casts between FP8 and non-F32 types into casts through F32 so that
+// only FP8<->F32 casts need to be expanded.
+struct SplitF8ExtFOp : public OpRewritePattern<arith::ExtFOp> {
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(arith::ExtFOp op,
+                                PatternRewriter &rewriter) const override {
+    Type resultElementType = getElementTypeOrSelf(op.getType());
+    if (!getF8Format(op.getIn().getType()) || resultElementType.isF32())
+      return failure();
+    Type f32Type = getTypeWithElementType(op.getType(), rewriter.getF32Type());
+    Value extended =
+        rewriter.create<arith::ExtFOp>(op.getLoc(), f32Type, op.getIn());
+    if (resultElementType.getIntOrFloatBitWidth() < 32) {
+      // The FP8 values are exactly representable in all wider types.
+      rewriter.replaceOpWithNewOp<arith::TruncFOp>(op, op.getType(), extended);
+    } else {
+      rewriter.replaceOpWithNewOp<arith::ExtFOp>(op, op.getType(), extended);
+    }
+    return success();
+  }
+};
+struct SplitF8TruncFOp : public OpRewritePattern<arith::TruncFOp> {
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(arith::TruncFOp op,
+                                PatternRewriter &rewriter) const override {
+    Type inputElementType = getElementTypeOrSelf(op.getIn().getType());
+    if (!getF8Format(op.getType()) || inputElementType.isF32())
+      return failure();
+    Type f32Type = getTypeWithElementType(op.getType(), rewriter.getF32Type());
+    Value f32Value;
+    if (inputElementType.getIntOrFloatBitWidth() < 32) {
+      f32Value =
+          rewriter.create<arith::ExtFOp>(op.getLoc(), f32Type, op.getIn());
+    } else {
+      f32Value =
+          rewriter.create<arith::TruncFOp>(op.getLoc(), f32Type, op.getIn());
+    }
+    rewriter.replaceOpWithNewOp<arith::TruncFOp>(op, op.getType(), f32Value);
+    return success();
+  }
+};
+
+// Expands an FP8 to F32 extension into integer bit manipulation so the values
+// stay packed in memory and are only widened in registers. Subnormals are
+// converted with an integer to float conversion so that targets flushing F32
+// denormals produce exact results.
+struct ExpandF8ExtFOp : public OpRewritePattern<arith::ExtFOp> {
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(arith::ExtFOp op,
+                                PatternRewriter &rewriter) const override {
+    auto format = getF8Format(op.getIn().getType());
+    if (!format || !getElementTypeOrSelf(op.getType()).isF32())
+      return failure();
+    Location loc = op.getLoc();
+    Type inputType = op.getIn().getType();
+    Type i8Type = getTypeWithElementType(inputType, rewriter.getI8Type());
+    Type i32Type = getTypeWithElementType(inputType, rewriter.getI32Type());
+    Type f32Type = op.getType();
+    auto i32 = [&](int64_t value) {
+      return createI32Constant(rewriter, loc, i32Type, value);
     };
+    const unsigned mantissaShift = 23 - format->mantissaBits;
+
+    Value bits = rewriter.create<arith::ExtUIOp>(
+        loc, i32Type,
+        rewriter.create<arith::BitcastOp>(loc, i8Type, op.getIn()));
+    Value magnitude = rewriter.create<arith::AndIOp>(loc, bits, i32(0x7F));
+    Value sign = rewriter.create<arith::ShLIOp>(
+        loc, rewriter.create<arith::AndIOp>(loc, bits, i32(0x80)), i32(24));
+
+    // Normal values only need their exponent rebiased.
+    Value normal = rewriter.create<arith::AddIOp>(
+        loc, rewriter.create<arith::ShLIOp>(loc, magnitude, i32(mantissaShift)),
+        i32((127 - format->bias) << 23));
+
+    // Subnormal values are their mantissa scaled by the smallest subnormal.
+    Value subnormal = rewriter.create<arith::BitcastOp>(
+        loc, i32Type,
+        rewriter.create<arith::MulFOp>(
+            loc, rewriter.create<arith::UIToFPOp>(loc, f32Type, magnitude),
+            createF32Constant(
+                rewriter, loc, f32Type,
+                std::ldexp(1.0f, 1 - format->bias -
+                                     static_cast<int>(format->mantissaBits)))));
+    Value isSubnormal = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::ult, magnitude,
+        i32(1 << format->mantissaBits));
+    Value result =
+        rewriter.create<arith::SelectOp>(loc, isSubnormal, subnormal, normal);
+
+    // Map the special encodings.
+    if (format->hasInf) {
+      Value isSpecial = rewriter.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::uge, magnitude,
+          i32(format->getInfBits()));
+      Value mantissa = rewriter.create<arith::AndIOp>(
+          loc, magnitude, i32((1 << format->mantissaBits) - 1));
+      Value special = rewriter.create<arith::OrIOp>(
+          loc,
+          rewriter.create<arith::ShLIOp>(loc, mantissa, i32(mantissaShift)),
+          i32(0x7F800000));
+      result =
+          rewriter.create<arith::SelectOp>(loc, isSpecial, special, result);
+    } else {
+      Value isNaN = rewriter.create<arith::CmpIOp>(
+          loc, arith::CmpIPredicate::eq, magnitude, i32(format->getNaNBits()));
+      result =
+          rewriter.create<arith::SelectOp>(loc, isNaN, i32(0x7FC00000), result);
+    }
+
+    result = rewriter.create<arith::OrIOp>(loc, result, sign);
+    rewriter.replaceOpWithNewOp<arith::BitcastOp>(op, f32Type, result);
+    return success();
+  }
+};
 
-    // Operations are legal if they don't contain any illegal type.
-    target.addDynamicallyLegalDialect<arith::ArithDialect>(checkOp);
-    target.addDynamicallyLegalDialect<math::MathDialect>(checkOp);
+// Expands an F32 to FP8 truncation into integer bit manipulation rounding to
+// nearest even. Matches the APFloat semantics used for constant folding:
+// values rounding past the largest finite value become inf if the type has
+// one and nan otherwise.
+struct ExpandF8TruncFOp : public OpRewritePattern<arith::TruncFOp> {
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(arith::TruncFOp op,
+                                PatternRewriter &rewriter) const override {
+    auto format = getF8Format(op.getType());
+    if (!format || !getElementTypeOrSelf(op.getIn().getType()).isF32())
+      return failure();
+    Location loc = op.getLoc();
+    Type f32Type = op.getIn().getType();
+    Type i8Type = getTypeWithElementType(f32Type, rewriter.getI8Type());
+    Type i32Type = getTypeWithElementType(f32Type, rewriter.getI32Type());
+    auto i32 = [&](int64_t value) {
+      return createI32Constant(rewriter, loc, i32Type, value);
+    };
+    const unsigned mantissaShift = 23 - format->mantissaBits;
+
+    Value bits = rewriter.create<arith::BitcastOp>(loc, i32Type, op.getIn());
+    Value sign = rewriter.create<arith::AndIOp>(
+        loc, rewriter.create<arith::ShRUIOp>(loc, bits, i32(24)), i32(0x80));
+    Value magnitude =
+        rewriter.create<arith::AndIOp>(loc, bits, i32(0x7FFFFFFF));
+
+    // Normal values round the dropped mantissa bits to nearest even and
+    // rebias the exponent. Rounding may carry into the exponent.
+    Value lsb = rewriter.create<arith::AndIOp>(
+        loc,
+        rewriter.create<arith::ShRUIOp>(loc, magnitude, i32(mantissaShift)),
+        i32(1));
+    Value rounded = rewriter.create<arith::AddIOp>(
+        loc, rewriter.create<arith::AddIOp>(
+                 loc, magnitude, i32((1 << (mantissaShift - 1)) - 1)),
+        lsb);
+    Value normal = rewriter.create<arith::SubIOp>(
+        loc, rewriter.create<arith::ShRUIOp>(loc, rounded, i32(mantissaShift)),
+        i32((127 - format->bias) << format->mantissaBits));
+
+    // Subnormal values are rounded by the float addition of a value whose
+    // ulp is the smallest FP8 subnormal; the mantissa then holds the result.
+    const int64_t magicBits =
+        ((127 - format->bias) + mantissaShift + 1) << 23;
+    Value magic =
+        rewriter.create<arith::BitcastOp>(loc, f32Type, i32(magicBits));
+    Value subnormal = rewriter.create<arith::SubIOp>(
+        loc,
+        rewriter.create<arith::BitcastOp>(
+            loc, i32Type,
+            rewriter.create<arith::AddFOp>(
+                loc,
+                rewriter.create<arith::BitcastOp>(loc, f32Type, magnitude),
+                magic)),
+        i32(magicBits));
+    Value isSubnormal = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::ult, magnitude,
+        i32((127 - format->bias + 1) << 23));
+    Value result =
+        rewriter.create<arith::SelectOp>(loc, isSubnormal, subnormal, normal);
+
+    // Handle overflow (including inf) and nan.
+    Value isOverflow = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::ugt, result,
+        i32(format->getMaxFiniteBits()));
+    result = rewriter.create<arith::SelectOp>(
+        loc, isOverflow, i32(format->getOverflowBits()), result);
+    Value isNaN = rewriter.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::ugt, magnitude, i32(0x7F800000));
+    result = rewriter.create<arith::SelectOp>(
+        loc, isNaN, i32(format->getNaNBits()), result);
+
+    result = rewriter.create<arith::OrIOp>(loc, result, sign);
+    rewriter.replaceOpWithNewOp<arith::BitcastOp>(
+        op, op.getType(),
+        rewriter.create<arith::TruncIOp>(loc, i8Type, result));
+    return success();
+  }
+};
 
-    // Some arithmetic operations exist in the vector dialect.
-    target.addDynamicallyLegalOp<vector::FMAOp, vector::ReductionOp,
-                                 vector::MultiDimReductionOp, vector::MaskOp,
-                                 vector::MatmulOp, vector::OuterProductOp,
-                                 vector::YieldOp>(checkOp);
+struct ConvertF8ArithToF32Pass
+    : public ConvertF8ArithToF32Base<ConvertF8ArithToF32Pass> {
+  using ConvertF8ArithToF32Base::ConvertF8ArithToF32Base;
+  void runOnOperation() override {
+    MLIRContext *context = &this->getContext();
+    Operation *rootOp = this->getOperation();
 
-    // Some ops are always legal.
-    target.addLegalOp<arith::BitcastOp>();
+    RewritePatternSet splitPatterns(context);
+    splitPatterns.insert<SplitF8ExtFOp, SplitF8TruncFOp>(context);
+    if (failed(
+            applyPatternsAndFoldGreedily(rootOp, std::move(splitPatterns)))) {
+      return this->signalPassFailure();
+    }
 
-    if (failed(applyFullConversion(this->getOperation(), target,
-                                   std::move(patterns)))) {
+    if (failed(promoteArithmetic(rootOp, typeConverter))) {
       return this->signalPassFailure();
     }
 
-    // This is due to arith.extf and arith.truncf validation failing on
-    // rank-0 vectors. These can only be generated by arith.constant so
-    // in these cases we just propagate the type.
-    RewritePatternSet cleanupPatterns(context);
-    cleanupPatterns
-        .insert<PropagateCastF<arith::TruncFOp>, PropagateCastF<arith::ExtFOp>>(
-            context);
-    if (applyPatternsAndFoldGreedily(this->getOperation(),
-                                     std::move(cleanupPatterns))
-            .failed()) {
+    // Only the casts to and from the FP8 storage types remain.
+    RewritePatternSet expandPatterns(context);
+    expandPatterns.insert<ExpandF8ExtFOp, ExpandF8TruncFOp>(context);
+    if (failed(
+            applyPatternsAndFoldGreedily(rootOp, std::move(expandPatterns)))) {
       return this->signalPassFailure();
     }
   }
 
-  PromoteBF16ToF32Converter typeConverter;
+  PromoteF8ToF32Converter typeConverter;
 };
 
 } // namespace
@@ -317,4 +621,8 @@ std::unique_ptr<OperationPass<>> createConvertBf16ArithToF32Pass() {
   return std::make_unique<ConvertBf16ArithToF32Pass>();
 }
 
+std::unique_ptr<OperationPass<>> createConvertF8ArithToF32Pass() {
+  return std::make_unique<ConvertF8ArithToF32Pass>();
+}
+
 } // namespace mlir::iree_compiler
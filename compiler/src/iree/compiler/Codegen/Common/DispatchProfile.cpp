@@ -0,0 +1,219 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/Common/DispatchProfile.h"
+
+#include <mutex>
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#define DEBUG_TYPE "iree-codegen-dispatch-profile"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir::iree_compiler {
+
+static llvm::cl::opt<std::string> clCodegenDispatchProfile(
+    "iree-codegen-dispatch-profile",
+    llvm::cl::desc(
+        "File path to a JSON profile of measured dispatch configurations. "
+        "The fastest measured configuration of each dispatch in the profile "
+        "is used in place of the default heuristics when compatible."),
+    llvm::cl::init(""));
+
+static bool parseInt64Array(const llvm::json::Value *value,
+                            SmallVectorImpl<int64_t> &result) {
+  const llvm::json::Array *array = value ? value->getAsArray() : nullptr;
+  if (!array)
+    return false;
+  for (const llvm::json::Value &element : *array) {
+    std::optional<int64_t> integer = element.getAsInteger();
+    if (!integer)
+      return false;
+    result.push_back(*integer);
+  }
+  return true;
+}
+
+static bool parseVariant(const llvm::json::Object &object,
+                         DispatchProfileVariant &variant) {
+  const llvm::json::Array *tileSizes = object.getArray("tile_sizes");
+  std::optional<double> timeUs = object.getNumber("time_us");
+  if (!tileSizes || !timeUs)
+    return false;
+  for (const llvm::json::Value &level : *tileSizes) {
+    if (!parseInt64Array(&level, variant.tileSizes.emplace_back()))
+      return false;
+  }
+  if (const llvm::json::Value *workgroupSize = object.get("workgroup_size")) {
+    if (!parseInt64Array(workgroupSize, variant.workgroupSize))
+      return false;
+  }
+  variant.subgroupSize = object.getInteger("subgroup_size");
+  variant.timeUs = *timeUs;
+  return true;
+}
+
+// static
+std::unique_ptr<DispatchProfile> DispatchProfile::parse(StringRef contents,
+                                                        std::string &error) {
+  llvm::Expected<llvm::json::Value> json = llvm::json::parse(contents);
+  if (!json) {
+    error = llvm::toString(json.takeError());
+    return nullptr;
+  }
+  const llvm::json::Object *root = json->getAsObject();
+  const llvm::json::Object *dispatches =
+      root ? root->getObject("dispatches") : nullptr;
+  if (!dispatches) {
+    error = "expected a top-level object with a `dispatches` object";
+    return nullptr;
+  }
+  auto profile = std::make_unique<DispatchProfile>();
+  for (const auto &[name, entry] : *dispatches) {
+    const llvm::json::Object *entryObject = entry.getAsObject();
+    const llvm::json::Array *variants =
+        entryObject ? entryObject->getArray("variants") : nullptr;
+    if (!variants) {
+      error = "expected a `variants` array for dispatch '" + name.str() + "'";
+      return nullptr;
+    }
+    auto &parsedVariants = profile->dispatches[name.str()];
+    for (const llvm::json::Value &variant : *variants) {
+      const llvm::json::Object *variantObject = variant.getAsObject();
+      if (!variantObject ||
+          !parseVariant(*variantObject, parsedVariants.emplace_back())) {
+        error = "malformed variant for dispatch '" + name.str() +
+                "'; expected `tile_sizes` and `time_us` and optionally "
+                "`workgroup_size` and `subgroup_size`";
+        return nullptr;
+      }
+    }
+  }
+  return profile;
+}
+
+ArrayRef<DispatchProfileVariant>
+DispatchProfile::lookup(StringRef name) const {
+  auto it = dispatches.find(name);
+  if (it == dispatches.end())
+    return {};
+  return it->second;
+}
+
+namespace {
+
+// Profiles loaded by path. Failed loads are cached with their error so that
+// each file is only read once per process.
+struct DispatchProfileCache {
+  struct Entry {
+    std::unique_ptr<DispatchProfile> profile;
+    std::string error;
+  };
+  std::mutex mutex;
+  llvm::StringMap<Entry> entries;
+};
+
+} // namespace
+
+FailureOr<const DispatchProfile *> getDispatchProfile(Operation *op) {
+  if (clCodegenDispatchProfile.empty())
+    return nullptr;
+  static DispatchProfileCache cache;
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto [it, inserted] = cache.entries.try_emplace(clCodegenDispatchProfile);
+  DispatchProfileCache::Entry &entry = it->second;
+  if (inserted) {
+    auto fileOr = llvm::MemoryBuffer::getFile(clCodegenDispatchProfile);
+    if (!fileOr) {
+      entry.error = fileOr.getError().message();
+    } else {
+      entry.profile =
+          DispatchProfile::parse((*fileOr)->getBuffer(), entry.error);
+    }
+  }
+  if (!entry.profile) {
+    return op->emitError() << "failed to load dispatch profile '"
+                           << clCodegenDispatchProfile << "': " << entry.error;
+  }
+  return entry.profile.get();
+}
+
+/// Returns true if |variant| has the same shape as the |defaultTileSizes|.
+static bool
+isCompatibleVariant(const DispatchProfileVariant &variant,
+                    const IREE::Codegen::TileSizesListType &defaultTileSizes) {
+  if (variant.tileSizes.size() != defaultTileSizes.size())
+    return false;
+  for (auto [tileSizes, defaultSizes] :
+       llvm::zip_equal(variant.tileSizes, defaultTileSizes)) {
+    if (tileSizes.size() != defaultSizes.size())
+      return false;
+    if (llvm::any_of(tileSizes, [](int64_t size) { return size < 0; }))
+      return false;
+  }
+  return true;
+}
+
+LogicalResult applyDispatchProfile(mlir::FunctionOpInterface entryPointFn,
+                                   Operation *rootOp,
+                                   bool requireWorkgroupSize) {
+  FailureOr<const DispatchProfile *> profile = getDispatchProfile(entryPointFn);
+  if (failed(profile))
+    return failure();
+  if (!*profile)
+    return success();
+  auto config = getLoweringConfig<IREE::Codegen::LoweringConfigAttr>(rootOp);
+  if (!config)
+    return success();
+
+  IREE::Codegen::TileSizesListType defaultTileSizes = config.getTileSizeVals();
+  const DispatchProfileVariant *fastestVariant = nullptr;
+  for (const auto &variant : (*profile)->lookup(entryPointFn.getName())) {
+    if (!isCompatibleVariant(variant, defaultTileSizes) ||
+        (requireWorkgroupSize && variant.workgroupSize.empty())) {
+      continue;
+    }
+    if (!fastestVariant || variant.timeUs < fastestVariant->timeUs) {
+      fastestVariant = &variant;
+    }
+  }
+  if (!fastestVariant) {
+    LDBG("no applicable profiled variant for " << entryPointFn.getName());
+    return success();
+  }
+  LDBG("using profiled variant for " << entryPointFn.getName() << " measured "
+                                     << fastestVariant->timeUs << "us");
+
+  // Keep everything but the tile sizes from the default configuration.
+  IREE::Codegen::TileSizesListType tileInterchange;
+  for (unsigned level = 0, e = defaultTileSizes.size(); level < e; ++level) {
+    tileInterchange.push_back(config.getTileInterchangeVals(level));
+  }
+  auto newConfig = IREE::Codegen::LoweringConfigAttr::get(
+      rootOp->getContext(), fastestVariant->tileSizes,
+      config.getScalableTileFlagVals(), tileInterchange,
+      config.getNativeVectorSize());
+  setLoweringConfig(rootOp, newConfig);
+
+  IREE::Codegen::TranslationInfoAttr translationInfo =
+      getTranslationInfo(entryPointFn);
+  if (!translationInfo || fastestVariant->workgroupSize.empty())
+    return success();
+  int64_t subgroupSize = fastestVariant->subgroupSize.value_or(
+      translationInfo.getSubgroupSize());
+  return setTranslationInfo(
+      entryPointFn,
+      IREE::Codegen::TranslationInfoAttr::get(
+          entryPointFn->getContext(), translationInfo.getPassPipeline(),
+          translationInfo.getCodegenSpec(), fastestVariant->workgroupSize,
+          subgroupSize, translationInfo.getConfiguration()));
+}
+
+} // namespace mlir::iree_compiler
@@ -0,0 +1,84 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_CODEGEN_COMMON_DISPATCHPROFILE_H_
+#define IREE_COMPILER_CODEGEN_COMMON_DISPATCHPROFILE_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenAttrs.h"
+#include "llvm/ADT/StringMap.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+
+namespace mlir::iree_compiler {
+
+/// A configuration of a dispatch that was measured at runtime.
+struct DispatchProfileVariant {
+  /// Tile sizes of each tiling level of the root op lowering config.
+  IREE::Codegen::TileSizesListType tileSizes;
+  /// Workgroup size the dispatch was run with, if it was specified.
+  SmallVector<int64_t> workgroupSize;
+  /// Subgroup size the dispatch was run with, if it was specified.
+  std::optional<int64_t> subgroupSize;
+  /// Measured mean execution time of a single dispatch in microseconds.
+  double timeUs = 0.0;
+};
+
+/// Measured runtime data used to guide the configuration of dispatches.
+///
+/// Profiles are JSON files mapping dispatch (executable export) names to the
+/// configurations that were measured for them, as produced by benchmarking
+/// a set of candidate configurations:
+///
+/// ```json
+/// {
+///   "dispatches": {
+///     "main_dispatch_0_matmul_128x256x512_f32": {
+///       "variants": [
+///         {"tile_sizes": [[64, 64, 0], [8, 32, 0], [0, 0, 16]],
+///          "time_us": 95.0},
+///         {"tile_sizes": [[32, 64, 0], [8, 32, 0], [0, 0, 16]],
+///          "workgroup_size": [64, 1, 1], "time_us": 120.5}
+///       ]
+///     }
+///   }
+/// }
+/// ```
+class DispatchProfile {
+public:
+  /// Parses a profile from its JSON |contents|. Returns nullptr and sets
+  /// |error| if the profile is malformed.
+  static std::unique_ptr<DispatchProfile> parse(StringRef contents,
+                                                std::string &error);
+
+  /// Returns the measured variants of the dispatch named |name|, if any.
+  ArrayRef<DispatchProfileVariant> lookup(StringRef name) const;
+
+private:
+  llvm::StringMap<SmallVector<DispatchProfileVariant>> dispatches;
+};
+
+/// Returns the profile specified by `--iree-codegen-dispatch-profile` or
+/// nullptr if none was specified. Profiles are loaded once per path and
+/// errors are reported on |op|.
+FailureOr<const DispatchProfile *> getDispatchProfile(Operation *op);
+
+/// Replaces the tile sizes of the lowering config of |rootOp| with those of
+/// the fastest variant measured for |entryPointFn| in the dispatch profile.
+/// Only variants with the same number of tiling levels and loops as the
+/// default configuration are considered. When |requireWorkgroupSize| is set
+/// only variants specifying the workgroup size (that must match the tile
+/// sizes) are used. Does nothing if there is no profile or no measured
+/// variant applies.
+LogicalResult applyDispatchProfile(mlir::FunctionOpInterface entryPointFn,
+                                   Operation *rootOp,
+                                   bool requireWorkgroupSize = false);
+
+} // namespace mlir::iree_compiler
+
+#endif // IREE_COMPILER_CODEGEN_COMMON_DISPATCHPROFILE_H_
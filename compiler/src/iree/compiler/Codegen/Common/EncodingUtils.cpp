@@ -99,6 +99,18 @@ MaterializeEncodingInfo getEncodingInfoForMatmul(EncodingAttr encoding,
   assert(cDims->m.size() <= 1 && cDims->n.size() <= 1 && cDims->k.size() <= 1 &&
          cDims->batch.size() <= 1 &&
          "Expected at most one M, N, K, and Batch dimension");
+  // Per-group scales and zero points are only tiled along N. The group
+  // dimension, which takes the place of K, stays an outer dimension.
+  if (role == EncodingRole::RHS_SCALES) {
+    encodingInfo.outerDimsPerm.push_back(
+        encoding.mapDimToRoleIndex(cDims->n[0]));
+    encodingInfo.outerDimsPerm.push_back(
+        encoding.mapDimToRoleIndex(cDims->k[0]));
+    encodingInfo.innerDimsPos.push_back(
+        encoding.mapDimToRoleIndex(cDims->n[0]));
+    encodingInfo.innerTileSizes.push_back(tileMxNxK.N);
+    return encodingInfo;
+  }
   if (!cDims->batch.empty()) {
     encodingInfo.outerDimsPerm.push_back(
         encoding.mapDimToRoleIndex(cDims->batch[0]));
@@ -9,6 +9,7 @@
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/UKernelOps.h"
 #include "iree/compiler/Codegen/Utils/GPUUtils.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -126,6 +127,69 @@ matchArgmaxDAGForUKernel(RewriterBase &rewriter, linalg::GenericOp op) {
       genericMicroKernelOp.getOperation());
 }
 
+/// Matches an iree_linalg_ext.topk selecting the largest values and checks if
+/// we have the ukernel that matches its shape constraints and types. If we do,
+/// then we convert it into an iree_codegen.ukernel.generic operation that is
+/// later lowered into a call to the microkernel.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchTopkDAGForUKernel(RewriterBase &rewriter, IREE::LinalgExt::TopkOp op) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "topk";
+  if (!hasUkernel(targetAttr, ukernelName) ||
+      !hasUkernelSupportedGpuArch(targetAttr)) {
+    return failure();
+  }
+
+  // Like argmax, only a single row is handled per ukernel call and the tiling
+  // pipeline tiles all parallel dims to 1.
+  Value input = op.getValues();
+  auto inputType = llvm::cast<ShapedType>(input.getType());
+  for (int64_t size : inputType.getShape().drop_back()) {
+    if (size != 1)
+      return failure();
+  }
+
+  // The ukernel keeps the k candidates of each lane in registers.
+  Value values = op.outputValues();
+  Value indices = op.outputIndices();
+  auto valuesType = llvm::cast<ShapedType>(values.getType());
+  auto indicesType = llvm::cast<ShapedType>(indices.getType());
+  int64_t k = valuesType.getShape().back();
+  if (ShapedType::isDynamic(k) || k > kTopkUkernelMaxK) {
+    return failure();
+  }
+
+  Type inputElemType = inputType.getElementType();
+  Type indexElemType = indicesType.getElementType();
+  std::string typeSuffixID = "";
+  if (inputElemType.isF16() && indexElemType.isInteger(32)) {
+    typeSuffixID = "F16I32";
+  } else if (inputElemType.isF16() && indexElemType.isInteger(64)) {
+    typeSuffixID = "F16I64";
+  } else if (inputElemType.isF32() && indexElemType.isInteger(32)) {
+    typeSuffixID = "F32I32";
+  } else if (inputElemType.isF32() && indexElemType.isInteger(64)) {
+    typeSuffixID = "F32I64";
+  } else {
+    return rewriter.notifyMatchFailure(
+        op, "unsupported combination of element types");
+  }
+
+  Location loc = op.getLoc();
+  Value reductionDimSize =
+      rewriter.create<tensor::DimOp>(loc, input, op.getDimension());
+  Value kValue = rewriter.create<arith::ConstantIndexOp>(loc, k);
+  auto fn =
+      getFnNameAndDefAttrs(ukernelName, typeSuffixID, rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, TypeRange{valuesType, indicesType}, fn.name, ValueRange{input},
+      ValueRange{values, indices}, ValueRange{reductionDimSize, kValue},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(0));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
 using TargetPredicate = std::function<bool(IREE::HAL::ExecutableTargetAttr)>;
 
 struct LowerArgmaxToUKernelPattern : OpRewritePattern<linalg::GenericOp> {
@@ -157,6 +221,34 @@ struct LowerArgmaxToUKernelPattern : OpRewritePattern<linalg::GenericOp> {
   TargetPredicate targetPredicate;
 };
 
+struct LowerTopkToUKernelPattern : OpRewritePattern<IREE::LinalgExt::TopkOp> {
+  LowerTopkToUKernelPattern(MLIRContext *context,
+                            TargetPredicate targetPredicate)
+      : OpRewritePattern<IREE::LinalgExt::TopkOp>(context),
+        targetPredicate(targetPredicate) {}
+
+  LogicalResult matchAndRewrite(IREE::LinalgExt::TopkOp op,
+                                PatternRewriter &rewriter) const override {
+    if (targetPredicate &&
+        !targetPredicate(IREE::HAL::ExecutableTargetAttr::lookup(op))) {
+      return failure();
+    }
+    if (!op.hasPureTensorSemantics() || failed(isTopkMaxOp(op))) {
+      return failure();
+    }
+    FailureOr<IREE::Codegen::UKernelOpInterface> ukernelOp =
+        matchTopkDAGForUKernel(rewriter, op);
+    if (failed(ukernelOp)) {
+      return rewriter.notifyMatchFailure(
+          op, "failed to find microkernel op to replace with");
+    }
+    rewriter.replaceOp(op, ukernelOp.value()->getResults());
+    return success();
+  }
+
+  TargetPredicate targetPredicate;
+};
+
 struct GPULowerToUKernelsPass final
     : impl::GPULowerToUKernelsPassBase<GPULowerToUKernelsPass> {
   void runOnOperation() override {
@@ -174,7 +266,8 @@ struct GPULowerToUKernelsPass final
     // evidence that it is difficult for codegen to consistently approach
     // microkernels performance, and that consideration overrides the benefit of
     // fusions for these ops.
-    patterns.insert<LowerArgmaxToUKernelPattern>(context, isROCMBackend);
+    patterns.insert<LowerArgmaxToUKernelPattern, LowerTopkToUKernelPattern>(
+        context, isROCMBackend);
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
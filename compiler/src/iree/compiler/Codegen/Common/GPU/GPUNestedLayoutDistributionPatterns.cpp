@@ -616,14 +616,94 @@ struct DistributeTranspose final : OpDistributionPattern<vector::TransposeOp> {
   }
 };
 
+/// Pattern to distribute 1-D `arith.constant` index vectors holding the
+/// sequence [0, 1, ..., n - 1] with nested layouts. Such constants are produced
+/// when vectorizing `linalg.index` ops, e.g. for causal attention masks, and
+/// each thread materializes the indices of the elements it holds.
+struct DistributeStepConstant final
+    : OpDistributionPattern<arith::ConstantOp> {
+  using OpDistributionPattern::OpDistributionPattern;
+
+  DistributeStepConstant(MLIRContext *context, Value threadId)
+      : OpDistributionPattern(context), threadId(threadId) {}
+
+  LogicalResult matchAndRewrite(arith::ConstantOp constantOp,
+                                DistributionSignature &signature,
+                                PatternRewriter &rewriter) const override {
+    auto constant = dyn_cast<VectorValue>(constantOp.getResult());
+    if (!constant || constant.getType().getRank() != 1 ||
+        !constant.getType().getElementType().isIndex()) {
+      return rewriter.notifyMatchFailure(constantOp, "not a 1-D index vector");
+    }
+    auto attr = dyn_cast<DenseIntElementsAttr>(constantOp.getValue());
+    if (!attr || attr.isSplat()) {
+      return rewriter.notifyMatchFailure(constantOp, "not a step sequence");
+    }
+    for (auto [i, value] : llvm::enumerate(attr.getValues<APInt>())) {
+      if (value.getSExtValue() != static_cast<int64_t>(i)) {
+        return rewriter.notifyMatchFailure(constantOp, "not a step sequence");
+      }
+    }
+    NestedLayoutAttr vectorLayout =
+        dyn_cast<NestedLayoutAttr>(signature[constant]);
+    if (!vectorLayout) {
+      return rewriter.notifyMatchFailure(constantOp,
+                                         "non-nested constant layout");
+    }
+
+    Location loc = constantOp.getLoc();
+    SmallVector<int64_t> distShape = vectorLayout.getDistributedShape();
+    int64_t elementCount = vectorLayout.getElementsPerThread()[0];
+    auto vectorType = VectorType::get(distShape, rewriter.getIndexType());
+    auto elementVectorType =
+        VectorType::get({elementCount}, rewriter.getIndexType());
+    Value acc = rewriter.create<arith::ConstantOp>(
+        loc, vectorType, rewriter.getZeroAttr(vectorType));
+    // Offsets of the elements within the innermost tile of a thread.
+    Value elementOffsets = rewriter.create<arith::ConstantOp>(
+        loc, elementVectorType,
+        rewriter.getIndexVectorAttr(
+            llvm::to_vector(llvm::seq<int64_t>(0, elementCount))));
+
+    SmallVector<Value> warpIndices, threadIndices;
+    populateWarpAndThreadIndices(rewriter, threadId, vectorLayout, warpIndices,
+                                 threadIndices);
+
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    SmallVector<int64_t> sizes = {vectorLayout.getSubgroupsPerWorkgroup()[0],
+                                  vectorLayout.getBatchesPerSubgroup()[0],
+                                  vectorLayout.getOutersPerBatch()[0],
+                                  vectorLayout.getThreadsPerOuter()[0]};
+    for (int64_t batch = 0; batch < sizes[1]; ++batch) {
+      for (int64_t outer = 0; outer < sizes[2]; ++outer) {
+        SmallVector<OpFoldResult> ids = {
+            warpIndices[0], rewriter.getIndexAttr(batch),
+            rewriter.getIndexAttr(outer), threadIndices[0]};
+        Value base = linearizeIndex(rewriter, zero, ids, sizes, elementCount);
+        Value indices = rewriter.create<arith::AddIOp>(
+            loc,
+            rewriter.create<vector::BroadcastOp>(loc, elementVectorType, base),
+            elementOffsets);
+        acc = rewriter.create<vector::InsertOp>(loc, indices, acc,
+                                                ArrayRef{batch, outer});
+      }
+    }
+
+    replaceOpWithDistributedValues(rewriter, constantOp, acc);
+    return success();
+  }
+
+  Value threadId;
+};
+
 } // namespace
 
 void populateGPUDistributeNestedLayoutAttrPatterns(RewritePatternSet &patterns,
                                                    Value threadId,
                                                    int64_t subgroupSize,
                                                    int64_t maxBitsPerShuffle) {
-  patterns.add<DistributeTransferRead, DistributeTransferWrite>(
-      patterns.getContext(), threadId);
+  patterns.add<DistributeTransferRead, DistributeTransferWrite,
+               DistributeStepConstant>(patterns.getContext(), threadId);
   patterns.add<DistributeBroadcast, DistributeTranspose>(patterns.getContext());
   patterns.add<DistributeMultiReduction>(patterns.getContext(), subgroupSize,
                                          maxBitsPerShuffle);
@@ -8,6 +8,7 @@
 #include "iree/compiler/Codegen/Utils/GPUUtils.h"
 #include "iree/compiler/Codegen/Utils/LinalgOpInfo.h"
 #include "llvm/Support/Debug.h"
+#include "mlir/Analysis/SliceAnalysis.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
@@ -53,6 +54,18 @@ static bool contractOpFilter(Operation *op) {
   return numNonUnitParallelLoop > 1 && dims.size() >= 2 && dims.size() <= 3;
 }
 
+/// Returns true if |operand| is computed from the result of another
+/// contraction, like the probabilities of a fused attention. Such operands are
+/// already distributed in registers with the layout of the producer and are
+/// kept there instead of round-tripping through shared memory.
+static bool isProducedByContraction(Value operand) {
+  SetVector<Operation *> slice;
+  BackwardSliceOptions options;
+  options.inclusive = true;
+  getBackwardSlice(operand, &slice, options);
+  return llvm::any_of(slice, llvm::IsaPred<vector::ContractionOp>);
+}
+
 // Allocates a tensor to copy the vector into a la bufferization.alloc_tensor.
 // This allocation is always static as vectors are currently always static
 // where this is used.
@@ -120,30 +133,28 @@ struct GPUVectorAllocPass final
       // reads in the previous iteration of a loop.
       builder.create<gpu::BarrierOp>(contractOp->getLoc());
 
-      // Promote both of the input operands, excluding the accumulator.
-      OpOperand &lhs = contractOp.getLhsMutable();
-      FailureOr<Value> lhsRet =
-          allocateTensorForVector(builder, contractOp->getLoc(), lhs.get());
-      if (failed(lhsRet)) {
-        return signalPassFailure();
-      }
-
-      OpOperand &rhs = contractOp.getRhsMutable();
-      FailureOr<Value> rhsRet =
-          allocateTensorForVector(builder, contractOp->getLoc(), rhs.get());
-      if (failed(rhsRet)) {
-        return signalPassFailure();
+      // Promote both of the input operands, excluding the accumulator and
+      // operands that come from a previous contraction.
+      SmallVector<std::pair<OpOperand *, Value>> promoted;
+      for (OpOperand *operand :
+           {&contractOp.getLhsMutable(), &contractOp.getRhsMutable()}) {
+        if (isProducedByContraction(operand->get()))
+          continue;
+        FailureOr<Value> ret = allocateTensorForVector(
+            builder, contractOp->getLoc(), operand->get());
+        if (failed(ret)) {
+          return signalPassFailure();
+        }
+        promoted.emplace_back(operand, *ret);
       }
 
       // Synchronize after the write to shared memory before we read from it.
       builder.create<gpu::BarrierOp>(contractOp->getLoc());
 
-      Value lhsVec =
-          readVectorFromTensor(builder, contractOp.getLhsType(), *lhsRet);
-      Value rhsVec =
-          readVectorFromTensor(builder, contractOp.getRhsType(), *rhsRet);
-      lhs.set(lhsVec);
-      rhs.set(rhsVec);
+      for (auto [operand, tensor] : promoted) {
+        operand->set(readVectorFromTensor(
+            builder, cast<VectorType>(operand->get().getType()), tensor));
+      }
     }
   }
 };
@@ -229,7 +229,8 @@ struct ReorderWorkgroupsPass final
       llvm::dbgs() << "\n\n";
     });
 
-    if (failed(reorderWorkgroupsInFunc(funcOp, reorderingStrategy, logTile))) {
+    if (failed(reorderWorkgroupsInFunc(funcOp, reorderingStrategy,
+                                       logSwizzleTile))) {
       LLVM_DEBUG(llvm::dbgs() << "Failed to reorder workgroups\n");
       return;
     }
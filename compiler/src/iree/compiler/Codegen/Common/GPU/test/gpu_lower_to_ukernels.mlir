@@ -284,3 +284,66 @@ func.func @argmax_ukernel_unsupported_arch(%arg0 : tensor<1x?xf32>) -> tensor<1x
 //      CDNA1-LABEL: func @argmax_ukernel_unsupported_arch(
 //      CDNA1-NOT: iree_codegen.ukernel.generic
 //      CDNA1: linalg.generic
+
+// -----
+
+func.func @topk_1d_f32i32(%arg0 : tensor<1x?xf32>, %arg1 : tensor<1x8xf32>, %arg2 : tensor<1x8xi32>) -> (tensor<1x8xf32>, tensor<1x8xi32>) attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {ukernels = "all"}>
+} {
+  %0:2 = iree_linalg_ext.topk dimension(1) ins(%arg0 : tensor<1x?xf32>) outs(%arg1, %arg2 : tensor<1x8xf32>, tensor<1x8xi32>) {
+  ^bb0(%lhs: f32, %rhs: f32):
+    %1 = arith.cmpf ogt, %lhs, %rhs : f32
+    iree_linalg_ext.yield %1 : i1
+  } -> tensor<1x8xf32>, tensor<1x8xi32>
+  return %0#0, %0#1 : tensor<1x8xf32>, tensor<1x8xi32>
+}
+
+//      CHECK-LABEL: func @topk_1d_f32i32(
+//       CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<1x?xf32>
+//       CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<1x8xf32>
+//       CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<1x8xi32>
+//        CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//        CHECK-DAG:   %[[C8:.+]] = arith.constant 8 : index
+//            CHECK:   %[[DIM:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//            CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "__iree_uk_rocm_topk_F32I32"
+//       CHECK-SAME:       ins(%[[ARG0]] :
+//       CHECK-SAME:       outs(%[[ARG1]], %[[ARG2]] :
+//       CHECK-SAME:       (%[[DIM]], %[[C8]] : index, index)
+//            CHECK:   return %[[MICRO_KERNEL]]#0, %[[MICRO_KERNEL]]#1
+
+// -----
+
+// The candidates of each lane are kept in registers so only small k is
+// supported.
+
+func.func @topk_1d_large_k(%arg0 : tensor<1x?xf16>, %arg1 : tensor<1x64xf16>, %arg2 : tensor<1x64xi64>) -> (tensor<1x64xf16>, tensor<1x64xi64>) attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {ukernels = "all"}>
+} {
+  %0:2 = iree_linalg_ext.topk dimension(1) ins(%arg0 : tensor<1x?xf16>) outs(%arg1, %arg2 : tensor<1x64xf16>, tensor<1x64xi64>) {
+  ^bb0(%lhs: f16, %rhs: f16):
+    %1 = arith.cmpf ogt, %lhs, %rhs : f16
+    iree_linalg_ext.yield %1 : i1
+  } -> tensor<1x64xf16>, tensor<1x64xi64>
+  return %0#0, %0#1 : tensor<1x64xf16>, tensor<1x64xi64>
+}
+
+//      CHECK-LABEL: func @topk_1d_large_k(
+//        CHECK-NOT:   iree_codegen.ukernel.generic
+//            CHECK:   iree_linalg_ext.topk
+
+// -----
+
+func.func @topk_1d_min_k(%arg0 : tensor<1x?xf32>, %arg1 : tensor<1x8xf32>, %arg2 : tensor<1x8xi32>) -> (tensor<1x8xf32>, tensor<1x8xi32>) attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {ukernels = "all"}>
+} {
+  %0:2 = iree_linalg_ext.topk dimension(1) ins(%arg0 : tensor<1x?xf32>) outs(%arg1, %arg2 : tensor<1x8xf32>, tensor<1x8xi32>) {
+  ^bb0(%lhs: f32, %rhs: f32):
+    %1 = arith.cmpf olt, %lhs, %rhs : f32
+    iree_linalg_ext.yield %1 : i1
+  } -> tensor<1x8xf32>, tensor<1x8xi32>
+  return %0#0, %0#1 : tensor<1x8xf32>, tensor<1x8xi32>
+}
+
+//      CHECK-LABEL: func @topk_1d_min_k(
+//        CHECK-NOT:   iree_codegen.ukernel.generic
+//            CHECK:   iree_linalg_ext.topk
@@ -1029,3 +1029,47 @@ builtin.module attributes { transform.with_named_sequence } {
 // CHECK: vector.multi_reduction <maximumf>, %{{.*}}, %{{.*}} [1, 3, 5] : vector<1x4x1x1x1x4xf32> to vector<1x1x1xf32>
 // Global reduction
 // CHECK: gpu.shuffle  xor %{{.*}}, %[[C32]], %[[C64]] : f32
+
+// -----
+
+#layout = #iree_vector_ext.nested_layout<
+  subgroups_per_workgroup = [1],
+  batches_per_subgroup    = [2],
+  outers_per_batch        = [1],
+  threads_per_outer       = [16],
+  elements_per_thread     = [4],
+
+  subgroup_basis          = [1],
+  thread_basis            = [16]
+>
+
+// CHECK-DAG: #[[$MAP:.+]] = affine_map<()[s0] -> (s0 * 4)>
+// CHECK-DAG: #[[$MAP1:.+]] = affine_map<()[s0] -> (s0 * 4 + 64)>
+
+// CHECK-LABEL: @distribute_step_constant
+func.func @distribute_step_constant() -> vector<128xindex> {
+  %root = arith.constant
+          {"__vector_layout_test_anchor_result_0" = #layout}
+          dense<[0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99, 100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114, 115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127]> : vector<128xindex>
+  func.return %root : vector<128xindex>
+}
+
+builtin.module attributes { transform.with_named_sequence } {
+  transform.named_sequence @__transform_main(%variant_op: !transform.any_op {transform.readonly}) {
+    %top_level_func = transform.structured.match ops{["func.func"]} in %variant_op : (!transform.any_op) -> !transform.any_op
+    transform.iree.test_gpu_vector_distribution %top_level_func : !transform.any_op
+    transform.yield
+  }
+}
+
+// CHECK-DAG: %[[ELEMENTS:.+]] = arith.constant dense<[0, 1, 2, 3]> : vector<4xindex>
+// CHECK: %[[IDS:.+]]:2 = affine.delinearize_index %{{.*}} into (%c1, %c16) : index, index
+// CHECK: %[[BASE0:.+]] = affine.apply #[[$MAP]]()[%[[IDS]]#1]
+// CHECK: %[[SPLAT0:.+]] = vector.broadcast %[[BASE0]] : index to vector<4xindex>
+// CHECK: %[[STEP0:.+]] = arith.addi %[[SPLAT0]], %[[ELEMENTS]] : vector<4xindex>
+// CHECK: %[[INS0:.+]] = vector.insert %[[STEP0]], %{{.*}} [0, 0] : vector<4xindex> into vector<2x1x4xindex>
+// CHECK: %[[BASE1:.+]] = affine.apply #[[$MAP1]]()[%[[IDS]]#1]
+// CHECK: %[[SPLAT1:.+]] = vector.broadcast %[[BASE1]] : index to vector<4xindex>
+// CHECK: %[[STEP1:.+]] = arith.addi %[[SPLAT1]], %[[ELEMENTS]] : vector<4xindex>
+// CHECK: vector.insert %[[STEP1]], %[[INS0]] [1, 0] : vector<4xindex> into vector<2x1x4xindex>
+// CHECK: iree_vector_ext.to_simd %{{.*}} : vector<2x1x4xindex> -> vector<128xindex>
@@ -373,6 +373,180 @@ lowerContractionOpWithEncoding(RewriterBase &rewriter,
   return result;
 }
 
+/// Returns true if `genericOp` is a matmul with grouped-quantized RHS as set up
+/// by SetEncoding, i.e. its operands have the LHS, RHS, RHS_SCALES (scales),
+/// RHS_SCALES (zero points) and RESULT encodings.
+static bool isGroupedDequantMatmulWithEncoding(linalg::GenericOp genericOp) {
+  if (!genericOp.hasPureTensorSemantics() ||
+      genericOp.getNumDpsInputs() != 4 || genericOp.getNumDpsInits() != 1) {
+    return false;
+  }
+  SmallVector<EncodingRole> roles = {EncodingRole::LHS, EncodingRole::RHS,
+                                     EncodingRole::RHS_SCALES,
+                                     EncodingRole::RHS_SCALES,
+                                     EncodingRole::RESULT};
+  for (auto [operand, role] :
+       llvm::zip_equal(genericOp->getOperands(), roles)) {
+    auto encoding = getEncodingAttr(cast<RankedTensorType>(operand.getType()));
+    if (!encoding || encoding.getRole().getValue() != role) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Returns the group size of the scales or zero points indexing map of a matmul
+/// with grouped-quantized RHS, i.e. `group_size` in
+/// (d0, d1, d2) -> (d1, d2 floordiv group_size).
+static std::optional<int64_t> getGroupSizeFromScalesMap(AffineMap map) {
+  if (map.getNumResults() != 2) {
+    return std::nullopt;
+  }
+  auto groupExpr = dyn_cast<AffineBinaryOpExpr>(map.getResult(1));
+  if (!groupExpr || groupExpr.getKind() != AffineExprKind::FloorDiv) {
+    return std::nullopt;
+  }
+  auto groupSizeExpr = dyn_cast<AffineConstantExpr>(groupExpr.getRHS());
+  if (!groupSizeExpr || groupSizeExpr.getValue() <= 0) {
+    return std::nullopt;
+  }
+  return groupSizeExpr.getValue();
+}
+
+/// Lowers a matmul with grouped-quantized RHS, i.e.
+///   out[m, n] += lhs[m, k] * (rhs[n, k] - zero_points[n, k / group_size]) *
+///                scales[n, k / group_size]
+/// If the encodings materialize, the same computation is done on the packed
+/// operands, with the M1, N1, K1, M0, N0, K0 loops of linalg.mmt4d. Otherwise,
+/// the RHS is dequantized by a separate linalg.generic feeding a matmul with
+/// the group and in-group K dimensions, as it was before SetEncoding.
+static FailureOr<Operation *> lowerGroupedDequantMatmulOpWithEncoding(
+    RewriterBase &rewriter, linalg::GenericOp genericOp,
+    ValueRange convertedInputOperands, ValueRange convertedOutputOperands,
+    MaterializeEncodingFn materializeEncodingFn) {
+  std::optional<int64_t> maybeGroupSize =
+      getGroupSizeFromScalesMap(genericOp.getIndexingMapsArray()[2]);
+  if (!maybeGroupSize) {
+    return rewriter.notifyMatchFailure(genericOp,
+                                       "expected a constant group size");
+  }
+  int64_t groupSize = *maybeGroupSize;
+
+  Location loc = genericOp.getLoc();
+  MLIRContext *ctx = rewriter.getContext();
+  Value lhs = convertedInputOperands[0];
+  Value rhs = convertedInputOperands[1];
+  Value scales = convertedInputOperands[2];
+  Value zeroPoints = convertedInputOperands[3];
+  Value out = convertedOutputOperands[0];
+  auto outType = cast<RankedTensorType>(out.getType());
+  using utils::IteratorType;
+
+  FailureOr<MaterializeEncodingInfo> materializeEncodingInfo =
+      materializeEncodingFn(getOriginalTypeWithEncoding(
+          cast<RankedTensorType>(genericOp->getResultTypes()[0])));
+  if (succeeded(materializeEncodingInfo)) {
+    // Each group spans groupSize / K0 consecutive K1 tiles.
+    int64_t K0 = cast<RankedTensorType>(lhs.getType()).getDimSize(3);
+    if (ShapedType::isDynamic(K0) || groupSize % K0 != 0) {
+      return rewriter.notifyMatchFailure(
+          genericOp, "expected the group size to be a multiple of K0");
+    }
+    AffineExpr m1, n1, k1, m0, n0, k0;
+    bindDims(ctx, m1, n1, k1, m0, n0, k0);
+    AffineExpr group = k1.floorDiv(groupSize / K0);
+    auto getMap = [&](ArrayRef<AffineExpr> results) {
+      return AffineMap::get(/*dimCount=*/6, /*symbolCount=*/0, results, ctx);
+    };
+    SmallVector<AffineMap> maps = {
+        getMap({m1, k1, m0, k0}), getMap({n1, k1, n0, k0}),
+        getMap({n1, group, n0}), getMap({n1, group, n0}),
+        getMap({m1, n1, m0, n0})};
+    SmallVector<IteratorType> iteratorTypes = {
+        IteratorType::parallel, IteratorType::parallel,
+        IteratorType::reduction, IteratorType::parallel,
+        IteratorType::parallel, IteratorType::reduction};
+    auto materializedGenericOp = rewriter.create<linalg::GenericOp>(
+        loc, outType, convertedInputOperands, convertedOutputOperands, maps,
+        iteratorTypes, /*bodyBuild=*/nullptr,
+        linalg::getPrunedAttributeList(genericOp));
+    rewriter.inlineRegionBefore(genericOp.getRegion(),
+                                materializedGenericOp.getRegion(),
+                                materializedGenericOp.getRegion().begin());
+    return materializedGenericOp.getOperation();
+  }
+
+  // The operands are not packed: lhs is MxK, rhs is NxK, scales and zero points
+  // are NxG and out is MxN, with K = G * groupSize.
+  auto scalesType = cast<RankedTensorType>(scales.getType());
+  int64_t numGroups = scalesType.getDimSize(1);
+  int64_t K = cast<RankedTensorType>(rhs.getType()).getDimSize(1);
+  if (ShapedType::isDynamic(K) || K != numGroups * groupSize) {
+    return rewriter.notifyMatchFailure(
+        genericOp, "expected K to be the number of groups times group size");
+  }
+  SmallVector<ReassociationIndices> ri = {{0}, {1, 2}};
+  auto expandGroups = [&](Value value) -> Value {
+    auto type = cast<RankedTensorType>(value.getType());
+    auto expandedType = RankedTensorType::get(
+        {type.getDimSize(0), numGroups, groupSize}, type.getElementType());
+    return rewriter.create<tensor::ExpandShapeOp>(loc, expandedType, value,
+                                                  ri);
+  };
+  Value expandedLhs = expandGroups(lhs);
+  Value expandedRhs = expandGroups(rhs);
+  auto expandedRhsType = cast<RankedTensorType>(expandedRhs.getType());
+  Type outElemType = outType.getElementType();
+
+  AffineExpr d0, d1, d2, d3;
+  bindDims(ctx, d0, d1, d2, d3);
+  AffineMap identityMap = rewriter.getMultiDimIdentityMap(3);
+  AffineMap groupMap = AffineMap::get(3, 0, {d0, d1}, ctx);
+  Value dequantInit = rewriter.create<tensor::EmptyOp>(
+      loc, expandedRhsType.getShape(), outElemType);
+  Value dequantizedRhs =
+      rewriter
+          .create<linalg::GenericOp>(
+              loc, expandedRhsType.clone(outElemType),
+              ValueRange{expandedRhs, scales, zeroPoints}, dequantInit,
+              ArrayRef<AffineMap>{identityMap, groupMap, groupMap,
+                                  identityMap},
+              SmallVector<IteratorType>(3, IteratorType::parallel),
+              [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+                Value extended = b.create<arith::ExtUIOp>(
+                    nestedLoc, b.getI32Type(), args[0]);
+                Value weight =
+                    b.create<arith::UIToFPOp>(nestedLoc, outElemType, extended);
+                Value scale =
+                    b.create<arith::ExtFOp>(nestedLoc, outElemType, args[1]);
+                Value zeroPoint =
+                    b.create<arith::ExtFOp>(nestedLoc, outElemType, args[2]);
+                Value centered =
+                    b.create<arith::SubFOp>(nestedLoc, weight, zeroPoint);
+                Value dequantized =
+                    b.create<arith::MulFOp>(nestedLoc, centered, scale);
+                b.create<linalg::YieldOp>(nestedLoc, dequantized);
+              })
+          .getResult(0);
+
+  SmallVector<AffineMap> maps = {AffineMap::get(4, 0, {d0, d2, d3}, ctx),
+                                 AffineMap::get(4, 0, {d1, d2, d3}, ctx),
+                                 AffineMap::get(4, 0, {d0, d1}, ctx)};
+  SmallVector<IteratorType> iteratorTypes = {
+      IteratorType::parallel, IteratorType::parallel, IteratorType::reduction,
+      IteratorType::reduction};
+  auto matmulOp = rewriter.create<linalg::GenericOp>(
+      loc, outType, ValueRange{expandedLhs, dequantizedRhs}, out, maps,
+      iteratorTypes,
+      [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+        Value mul = b.create<arith::MulFOp>(nestedLoc, args[0], args[1]);
+        Value add = b.create<arith::AddFOp>(nestedLoc, mul, args[2]);
+        b.create<linalg::YieldOp>(nestedLoc, add);
+      },
+      linalg::getPrunedAttributeList(genericOp));
+  return matmulOp.getOperation();
+}
+
 /// Utility method to convert `tensor.empty` with encoding to a `tensor.empty`
 /// of the materialized type.
 static FailureOr<Operation *>
@@ -417,6 +591,7 @@ lowerOpWithEncoding(RewriterBase &rewriter, tensor::EmptyOp emptyOp,
 ///  - linalg::LinalgOp that `isaContractionOpInterface`
 ///  - linalg::FillOp
 ///  - element-wise linalg::GenericOp with single input and output
+///  - linalg::GenericOp matmul with grouped-quantized RHS
 static FailureOr<Operation *> lowerOpWithEncoding(
     RewriterBase &rewriter, linalg::LinalgOp linalgOp,
     ValueRange convertedInputOperands, ValueRange convertedOutputOperands,
@@ -443,6 +618,11 @@ static FailureOr<Operation *> lowerOpWithEncoding(
           })
       .Case<linalg::GenericOp>([&](linalg::GenericOp genericOp)
                                    -> FailureOr<Operation *> {
+        if (isGroupedDequantMatmulWithEncoding(genericOp)) {
+          return lowerGroupedDequantMatmulOpWithEncoding(
+              rewriter, genericOp, convertedInputOperands,
+              convertedOutputOperands, materializeEncodingFn);
+        }
         if (!genericOp.hasPureTensorSemantics() || !isElementwise(genericOp) ||
             genericOp.getNumDpsInputs() != 1 ||
             genericOp.getNumDpsInits() != 1) {
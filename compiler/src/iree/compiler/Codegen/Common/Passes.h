@@ -79,6 +79,10 @@ std::unique_ptr<OperationPass<>> createConvertBf16ArithToF32Pass();
 /// Convert BF16 buffer ops and conversions to simulated behavior with uint16.
 std::unique_ptr<OperationPass<>> createConvertBf16ToUInt16BuffersPass();
 
+/// Convert FP8 arithmetic to f32 keeping FP8 storage and expanding the casts
+/// into integer operations.
+std::unique_ptr<OperationPass<>> createConvertF8ArithToF32Pass();
+
 /// Converts entry point function within dispatch regions to use
 /// destination-passing style, which is better suited for the upstream
 /// comprehensive bufferization pass.
@@ -0,0 +1,59 @@
+// RUN: iree-opt --split-input-file --iree-convert-f8-arith-to-f32 %s | FileCheck %s
+
+// Tests that FP8 arithmetic is performed in f32 with the casts to and from the
+// FP8 storage type expanded into integer operations.
+
+func.func @addf_f8E4M3FN(%arg0 : f8E4M3FN, %arg1 : f8E4M3FN) -> f8E4M3FN {
+  %0 = arith.addf %arg0, %arg1 : f8E4M3FN
+  return %0 : f8E4M3FN
+}
+
+// CHECK-LABEL: @addf_f8E4M3FN
+// CHECK-SAME: %[[ARG0:.+]]: f8E4M3FN, %[[ARG1:.+]]: f8E4M3FN
+// CHECK: %[[BITS0:.+]] = arith.bitcast %[[ARG0]] : f8E4M3FN to i8
+// CHECK: arith.extui %[[BITS0]] : i8 to i32
+// CHECK: arith.uitofp %{{.+}} : i32 to f32
+// CHECK: %[[LHS:.+]] = arith.bitcast %{{.+}} : i32 to f32
+// CHECK: %[[BITS1:.+]] = arith.bitcast %[[ARG1]] : f8E4M3FN to i8
+// CHECK: %[[RHS:.+]] = arith.bitcast %{{.+}} : i32 to f32
+// CHECK: %[[ADD:.+]] = arith.addf %[[LHS]], %[[RHS]] : f32
+// CHECK: arith.bitcast %[[ADD]] : f32 to i32
+// CHECK: %[[TRUNC:.+]] = arith.trunci %{{.+}} : i32 to i8
+// CHECK: %[[RESULT:.+]] = arith.bitcast %[[TRUNC]] : i8 to f8E4M3FN
+// CHECK-NOT: arith.extf
+// CHECK-NOT: arith.truncf
+// CHECK: return %[[RESULT]]
+
+// -----
+
+// Tests that FP8 loads stay packed and are only widened in registers.
+
+func.func @dequant_f8E5M2(%arg0 : memref<8xf8E5M2>, %arg1 : memref<8xf16>) {
+  %c0 = arith.constant 0 : index
+  %cst = arith.constant 0.0 : f8E5M2
+  %0 = vector.transfer_read %arg0[%c0], %cst : memref<8xf8E5M2>, vector<8xf8E5M2>
+  %1 = arith.extf %0 : vector<8xf8E5M2> to vector<8xf16>
+  vector.transfer_write %1, %arg1[%c0] : vector<8xf16>, memref<8xf16>
+  return
+}
+
+// CHECK-LABEL: @dequant_f8E5M2
+// CHECK: %[[READ:.+]] = vector.transfer_read %{{.+}} : memref<8xf8E5M2>, vector<8xf8E5M2>
+// CHECK: %[[BITS:.+]] = arith.bitcast %[[READ]] : vector<8xf8E5M2> to vector<8xi8>
+// CHECK: arith.extui %[[BITS]] : vector<8xi8> to vector<8xi32>
+// CHECK: %[[F32:.+]] = arith.bitcast %{{.+}} : vector<8xi32> to vector<8xf32>
+// CHECK: %[[F16:.+]] = arith.truncf %[[F32]] : vector<8xf32> to vector<8xf16>
+// CHECK: vector.transfer_write %[[F16]]
+
+// -----
+
+// Tests that other float types are untouched.
+
+func.func @addf_f16(%arg0 : f16, %arg1 : f16) -> f16 {
+  %0 = arith.addf %arg0, %arg1 : f16
+  return %0 : f16
+}
+
+// CHECK-LABEL: @addf_f16
+// CHECK: %[[ADD:.+]] = arith.addf %{{.+}}, %{{.+}} : f16
+// CHECK: return %[[ADD]]
@@ -249,3 +249,67 @@ func.func @drop_encoding_for_hal_flow_ops_dynamic() {
 // CHECK-DAG:     %[[OUT:.+]] = hal.interface.binding.subspan set(0) binding(1) {{.+}} : !flow.dispatch.tensor<writeonly:tensor<?x?xbf16>>
 // CHECK:         %[[LOAD:.+]] = flow.dispatch.tensor.load %[[IN]]
 // CHECK:         flow.dispatch.tensor.store %[[LOAD]], %[[OUT]]
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d1, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+#map3 = affine_map<(d0, d1, d2) -> (d1, d2 floordiv 16)>
+#lhs_encoding = #iree_encoding.encoding<role = LHS, element_types = [f32, ui4, f32, f16], user_indexing_maps = [#map, #map1, #map2]>
+#rhs_encoding = #iree_encoding.encoding<role = RHS, element_types = [f32, ui4, f32, f16], user_indexing_maps = [#map, #map1, #map2]>
+#scales_encoding = #iree_encoding.encoding<role = RHS_SCALES, element_types = [f32, ui4, f32, f16], user_indexing_maps = [#map, #map1, #map2]>
+#result_encoding = #iree_encoding.encoding<role = RESULT, element_types = [f32, ui4, f32, f16], user_indexing_maps = [#map, #map1, #map2]>
+func.func @grouped_dequant_matmul(
+    %lhs: tensor<16x64xf32>, %rhs: tensor<32x64xi4>, %scales: tensor<32x4xf16>,
+    %zero_points: tensor<32x4xf16>, %out: tensor<16x32xf32>) -> tensor<16x32xf32> {
+  %0 = iree_encoding.set_encoding %lhs : tensor<16x64xf32> -> tensor<16x64xf32, #lhs_encoding>
+  %1 = iree_encoding.set_encoding %rhs : tensor<32x64xi4> -> tensor<32x64xi4, #rhs_encoding>
+  %2 = iree_encoding.set_encoding %scales : tensor<32x4xf16> -> tensor<32x4xf16, #scales_encoding>
+  %3 = iree_encoding.set_encoding %zero_points : tensor<32x4xf16> -> tensor<32x4xf16, #scales_encoding>
+  %4 = iree_encoding.set_encoding %out : tensor<16x32xf32> -> tensor<16x32xf32, #result_encoding>
+  %5 = linalg.generic {
+      indexing_maps = [#map, #map1, #map3, #map3, #map2],
+      iterator_types = ["parallel", "parallel", "reduction"]}
+      ins(%0, %1, %2, %3 : tensor<16x64xf32, #lhs_encoding>, tensor<32x64xi4, #rhs_encoding>, tensor<32x4xf16, #scales_encoding>, tensor<32x4xf16, #scales_encoding>)
+      outs(%4 : tensor<16x32xf32, #result_encoding>) {
+  ^bb0(%in: f32, %in_0: i4, %in_1: f16, %in_2: f16, %acc: f32):
+    %7 = arith.extui %in_0 : i4 to i32
+    %8 = arith.uitofp %7 : i32 to f32
+    %9 = arith.extf %in_2 : f16 to f32
+    %10 = arith.subf %8, %9 : f32
+    %11 = arith.extf %in_1 : f16 to f32
+    %12 = arith.mulf %10, %11 : f32
+    %13 = arith.mulf %in, %12 : f32
+    %14 = arith.addf %13, %acc : f32
+    linalg.yield %14 : f32
+  } -> tensor<16x32xf32, #result_encoding>
+  %6 = iree_encoding.unset_encoding %5 : tensor<16x32xf32, #result_encoding> -> tensor<16x32xf32>
+  return %6 : tensor<16x32xf32>
+}
+//  CHECK-DAG: #[[$IDENTITY_MAP:.+]] = affine_map<(d0, d1, d2) -> (d0, d1, d2)>
+//  CHECK-DAG: #[[$GROUP_MAP:.+]] = affine_map<(d0, d1, d2) -> (d0, d1)>
+//  CHECK-DAG: #[[$LHS_MAP:.+]] = affine_map<(d0, d1, d2, d3) -> (d0, d2, d3)>
+//  CHECK-DAG: #[[$RHS_MAP:.+]] = affine_map<(d0, d1, d2, d3) -> (d1, d2, d3)>
+//  CHECK-DAG: #[[$OUT_MAP:.+]] = affine_map<(d0, d1, d2, d3) -> (d0, d1)>
+// CHECK-LABEL: func.func @grouped_dequant_matmul(
+// CHECK-SAME:    %[[LHS:[a-zA-Z0-9_]+]]: tensor<16x64xf32>, %[[RHS:[a-zA-Z0-9_]+]]: tensor<32x64xi4>
+// CHECK-SAME:    %[[SCALES:[a-zA-Z0-9_]+]]: tensor<32x4xf16>, %[[ZERO_POINTS:[a-zA-Z0-9_]+]]: tensor<32x4xf16>
+// CHECK-SAME:    %[[OUT:[a-zA-Z0-9_]+]]: tensor<16x32xf32>
+// CHECK-DAG:     %[[EXPANDED_LHS:.+]] = tensor.expand_shape %[[LHS]] {{\[}}[0], [1, 2]] {{.*}} : tensor<16x64xf32> into tensor<16x4x16xf32>
+// CHECK-DAG:     %[[EXPANDED_RHS:.+]] = tensor.expand_shape %[[RHS]] {{\[}}[0], [1, 2]] {{.*}} : tensor<32x64xi4> into tensor<32x4x16xi4>
+// CHECK:         %[[DEQUANT:.+]] = linalg.generic
+// CHECK-SAME:        indexing_maps = [#[[$IDENTITY_MAP]], #[[$GROUP_MAP]], #[[$GROUP_MAP]], #[[$IDENTITY_MAP]]]
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "parallel"]
+// CHECK-SAME:        ins(%[[EXPANDED_RHS]], %[[SCALES]], %[[ZERO_POINTS]] :
+// CHECK:           arith.extui
+// CHECK:           arith.uitofp
+// CHECK:           arith.subf
+// CHECK:           arith.mulf
+// CHECK:         } -> tensor<32x4x16xf32>
+// CHECK:         %[[MATMUL:.+]] = linalg.generic
+// CHECK-SAME:        indexing_maps = [#[[$LHS_MAP]], #[[$RHS_MAP]], #[[$OUT_MAP]]]
+// CHECK-SAME:        iterator_types = ["parallel", "parallel", "reduction", "reduction"]
+// CHECK-SAME:        ins(%[[EXPANDED_LHS]], %[[DEQUANT]] :
+// CHECK-SAME:        outs(%[[OUT]] :
+// CHECK:         return %[[MATMUL]]
@@ -50,6 +50,15 @@ func.func @test_target_chip() attributes {
   >
 } { return }
 
+// CHECK-LABEL: func.func @test_target_chip_l2_cache()
+func.func @test_target_chip_l2_cache() attributes {
+  // CHECK: #iree_gpu.target_chip<
+  // CHECK-SAME: wgp_count = 108, l2_cache_bytes = 41943040>
+  chip = #iree_gpu.target_chip<
+    wgp_count = 108, l2_cache_bytes = 41943040
+  >
+} { return }
+
 // CHECK-LABEL: func.func @test_target()
 func.func @test_target() attributes {
   // CHECK: #iree_gpu.target<
@@ -47,6 +47,7 @@ struct WgpDetails {
 // Chip level feature/limit details
 struct ChipDetails {
   uint32_t wgpCount;
+  uint32_t l2CacheBytes;
 };
 
 // Full target details
@@ -105,7 +106,8 @@ TargetAttr createTargetAttr(const TargetDetails &details, StringRef arch,
   TargetChipAttr targetChip;
   if (details.chip)
     targetChip =
-        TargetChipAttr::get(context, details.chip->wgpCount, DictionaryAttr{});
+        TargetChipAttr::get(context, details.chip->wgpCount,
+                            details.chip->l2CacheBytes, DictionaryAttr{});
 
   return TargetAttr::get(context, arch, features, targetWgp, targetChip);
 }
@@ -173,23 +175,23 @@ std::optional<TargetDetails> getAMDGPUTargetDetails(StringRef target) {
 
   // "AMD Instinct MI300 Series Product Offerings" in Page 23 of
   // https://www.amd.com/content/dam/amd/en/documents/instinct-tech-docs/white-papers/amd-cdna-3-white-paper.pdf
-  static const ChipDetails mi300xChip = {304};
-  static const ChipDetails mi300aChip = {228};
+  static const ChipDetails mi300xChip = {304, 32 * 1024 * 1024};
+  static const ChipDetails mi300aChip = {228, 24 * 1024 * 1024};
 
   // "AMD Instinct MI200 Series Accelerator Product Offerings" in Page 14 of
   // https://www.amd.com/content/dam/amd/en/documents/instinct-business-docs/white-papers/amd-cdna2-white-paper.pdf
-  static const ChipDetails mi250xChip = {220};
-  static const ChipDetails mi250Chip = {208};
-  static const ChipDetails mi210Chip = {104};
+  static const ChipDetails mi250xChip = {220, 16 * 1024 * 1024};
+  static const ChipDetails mi250Chip = {208, 16 * 1024 * 1024};
+  static const ChipDetails mi210Chip = {104, 8 * 1024 * 1024};
 
   // "AMD CDNA Architecture Compute Units" in Page 5 of
   // https://www.amd.com/content/dam/amd/en/documents/instinct-business-docs/white-papers/amd-cdna-white-paper.pdf
-  static const ChipDetails mi100Chip = {120};
+  static const ChipDetails mi100Chip = {120, 8 * 1024 * 1024};
 
-  static const ChipDetails rx7900xtxChip = {96};
-  static const ChipDetails rx7900xtChip = {84};
-  static const ChipDetails rx7800xtChip = {60};
-  static const ChipDetails rx7700xtChip = {54};
+  static const ChipDetails rx7900xtxChip = {96, 6 * 1024 * 1024};
+  static const ChipDetails rx7900xtChip = {84, 6 * 1024 * 1024};
+  static const ChipDetails rx7800xtChip = {60, 4 * 1024 * 1024};
+  static const ChipDetails rx7700xtChip = {54, 4 * 1024 * 1024};
 
   // See https://llvm.org/docs/AMDGPUUsage.html#processors for gfxN to
   // cdnaN/rdnaN mapping.
@@ -277,13 +279,13 @@ std::optional<TargetDetails> getNVIDIAGPUTargetDetails(StringRef target) {
   const WgpDetails *voltaWgp = getVoltaWgpDetails();
   const WgpDetails *pascalWgp = getPascalWgpDetails();
 
-  static const ChipDetails a100Chip = {108};
-  static const ChipDetails rtx3090tiChip = {84};
-  static const ChipDetails rtx3090Chip = {82};
-  static const ChipDetails rtx3080tiChip = {80};
-  static const ChipDetails rtx3080Chip = {68};
-  static const ChipDetails rtx3070tiChip = {48};
-  static const ChipDetails rtx3070Chip = {46};
+  static const ChipDetails a100Chip = {108, 40 * 1024 * 1024};
+  static const ChipDetails rtx3090tiChip = {84, 6 * 1024 * 1024};
+  static const ChipDetails rtx3090Chip = {82, 6 * 1024 * 1024};
+  static const ChipDetails rtx3080tiChip = {80, 6 * 1024 * 1024};
+  static const ChipDetails rtx3080Chip = {68, 5 * 1024 * 1024};
+  static const ChipDetails rtx3070tiChip = {48, 4 * 1024 * 1024};
+  static const ChipDetails rtx3070Chip = {46, 4 * 1024 * 1024};
 
   // https://arnon.dk/matching-sm-architectures-arch-and-gencode-for-various-nvidia-cards/
   // lists mappings from microarchitectures to compute capabilities.
@@ -378,6 +378,48 @@ static InstrumentationEntry appendInstrumentationEntry(
   return entry;
 }
 
+// Workgroup key produced by hal.instrument.workgroup in workgroups that were
+// not sampled. Workgroup-specific events using the key are skipped.
+static constexpr int64_t kUnsampledWorkgroupKey = -1;
+
+// Returns true if |workgroupKey| may be kUnsampledWorkgroupKey.
+static bool isSampledWorkgroupKey(Value workgroupKey) {
+  auto workgroupOp =
+      workgroupKey.getDefiningOp<IREE::HAL::InstrumentWorkgroupOp>();
+  return workgroupOp && (workgroupOp.getSampleDispatches() ||
+                         workgroupOp.getSampleRate().value_or(1) > 1);
+}
+
+// Appends an entry for an event of the workgroup identified by
+// |originalWorkgroupKey| (with |workgroupKey| as its converted value). Events
+// of workgroups that may not have been sampled are guarded by a branch that
+// skips the entry for kUnsampledWorkgroupKey.
+static void appendWorkgroupInstrumentationEntry(
+    Location loc, Value originalWorkgroupKey, Value workgroupKey, Value buffer,
+    Value bufferPtr, LLVM::LLVMStructType entryType,
+    ArrayRef<Value> entryValues, DataLayout &dataLayout,
+    ConversionPatternRewriter &rewriter) {
+  if (!isSampledWorkgroupKey(originalWorkgroupKey)) {
+    appendInstrumentationEntry(loc, buffer, bufferPtr, entryType, entryValues,
+                               dataLayout, rewriter);
+    return;
+  }
+  Value isSampled = rewriter.create<LLVM::ICmpOp>(
+      loc, LLVM::ICmpPredicate::ne, workgroupKey,
+      rewriter.create<LLVM::ConstantOp>(loc, rewriter.getI64Type(),
+                                        kUnsampledWorkgroupKey));
+  Block *currentBlock = rewriter.getInsertionBlock();
+  Block *continueBlock =
+      rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
+  Block *appendBlock = rewriter.createBlock(continueBlock);
+  appendInstrumentationEntry(loc, buffer, bufferPtr, entryType, entryValues,
+                             dataLayout, rewriter);
+  rewriter.create<LLVM::BrOp>(loc, ValueRange{}, continueBlock);
+  rewriter.setInsertionPointToEnd(currentBlock);
+  rewriter.create<LLVM::CondBrOp>(loc, isSampled, appendBlock, continueBlock);
+  rewriter.setInsertionPointToStart(continueBlock);
+}
+
 static int64_t getMemoryAccessByteSize(Type type) {
   if (auto vectorType = llvm::dyn_cast<VectorType>(type)) {
     return (vectorType.getNumElements() * vectorType.getElementTypeBitWidth()) /
@@ -420,17 +462,68 @@ struct ConvertHALInstrumentWorkgroupOp
         loc, i32Type, rawDispatchId,
         rewriter.create<LLVM::ConstantOp>(loc, i32Type, 8)); // | 8bit tag
 
+    SmallVector<Value> workgroupId = {
+        abi.loadWorkgroupID(instrumentOp, 0, i32Type, rewriter),
+        abi.loadWorkgroupID(instrumentOp, 1, i32Type, rewriter),
+        abi.loadWorkgroupID(instrumentOp, 2, i32Type, rewriter),
+    };
+    SmallVector<Value> workgroupCount = {
+        abi.loadWorkgroupCount(instrumentOp, 0, i32Type, rewriter),
+        abi.loadWorkgroupCount(instrumentOp, 1, i32Type, rewriter),
+        abi.loadWorkgroupCount(instrumentOp, 2, i32Type, rewriter),
+    };
+
+    // Determine whether the workgroup is sampled, if sampling.
+    Value isSampled;
+    if (instrumentOp.getSampleDispatches()) {
+      // The host sets the high bit of the dispatch ID on unsampled dispatches.
+      isSampled = rewriter.create<LLVM::ICmpOp>(
+          loc, LLVM::ICmpPredicate::sge, rawDispatchId,
+          rewriter.create<LLVM::ConstantOp>(loc, i32Type, 0));
+    } else if (uint32_t sampleRate = instrumentOp.getSampleRate().value_or(1);
+               sampleRate > 1) {
+      // Sample the linearized workgroup ID so that the first workgroup of every
+      // dispatch is always recorded: (x + cx * (y + cy * z)) % rate == 0.
+      Value linearId = rewriter.create<LLVM::AddOp>(
+          loc, workgroupId[0],
+          rewriter.create<LLVM::MulOp>(
+              loc, workgroupCount[0],
+              rewriter.create<LLVM::AddOp>(
+                  loc, workgroupId[1],
+                  rewriter.create<LLVM::MulOp>(loc, workgroupCount[1],
+                                               workgroupId[2]))));
+      isSampled = rewriter.create<LLVM::ICmpOp>(
+          loc, LLVM::ICmpPredicate::eq,
+          rewriter.create<LLVM::URemOp>(
+              loc, linearId,
+              rewriter.create<LLVM::ConstantOp>(loc, i32Type, sampleRate)),
+          rewriter.create<LLVM::ConstantOp>(loc, i32Type, 0));
+    }
+
+    // Unsampled workgroups branch around the entry and produce the unsampled
+    // key that causes all other events in the workgroup to be skipped.
+    Block *currentBlock = nullptr;
+    Block *continueBlock = nullptr;
+    if (isSampled) {
+      currentBlock = rewriter.getInsertionBlock();
+      continueBlock =
+          rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
+      continueBlock->addArgument(i64Type, loc);
+      rewriter.createBlock(continueBlock);
+    }
+
+    Value processorId = abi.loadProcessorID(instrumentOp, rewriter);
     auto entry = appendInstrumentationEntry(
         loc, instrumentOp.getBuffer(), operands.getBuffer(), entryType,
         {
             header,
-            abi.loadWorkgroupID(instrumentOp, 0, i32Type, rewriter),
-            abi.loadWorkgroupID(instrumentOp, 1, i32Type, rewriter),
-            abi.loadWorkgroupID(instrumentOp, 2, i32Type, rewriter),
-            abi.loadWorkgroupCount(instrumentOp, 0, i32Type, rewriter),
-            abi.loadWorkgroupCount(instrumentOp, 1, i32Type, rewriter),
-            abi.loadWorkgroupCount(instrumentOp, 2, i32Type, rewriter),
-            abi.loadProcessorID(instrumentOp, rewriter),
+            workgroupId[0],
+            workgroupId[1],
+            workgroupId[2],
+            workgroupCount[0],
+            workgroupCount[1],
+            workgroupCount[2],
+            processorId,
         },
         dataLayout, rewriter);
 
@@ -444,6 +537,20 @@ struct ConvertHALInstrumentWorkgroupOp
             rewriter.create<LLVM::ConstantOp>(loc, i64Type, 0xFFFFFFFFFFll)),
         rewriter.create<LLVM::ConstantOp>(loc, i64Type, 24));
 
+    if (isSampled) {
+      Block *appendBlock = rewriter.getInsertionBlock();
+      rewriter.create<LLVM::BrOp>(loc, ValueRange{workgroupKey},
+                                  continueBlock);
+      rewriter.setInsertionPointToEnd(currentBlock);
+      Value unsampledKey = rewriter.create<LLVM::ConstantOp>(
+          loc, i64Type, kUnsampledWorkgroupKey);
+      rewriter.create<LLVM::CondBrOp>(loc, isSampled, appendBlock,
+                                      ValueRange{}, continueBlock,
+                                      ValueRange{unsampledKey});
+      rewriter.setInsertionPointToStart(continueBlock);
+      workgroupKey = continueBlock->getArgument(0);
+    }
+
     rewriter.replaceOp(instrumentOp, workgroupKey);
     return success();
   }
@@ -555,13 +662,14 @@ struct ConvertHALInstrumentValueOp
                 instrumentOp.getType().getIntOrFloatBitWidth()),
             operands.getOperand()));
 
-    appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
-                               operands.getBuffer(), entryType,
-                               {
-                                   header,
-                                   bits,
-                               },
-                               dataLayout, rewriter);
+    appendWorkgroupInstrumentationEntry(
+        loc, instrumentOp.getWorkgroupKey(), operands.getWorkgroupKey(),
+        instrumentOp.getBuffer(), operands.getBuffer(), entryType,
+        {
+            header,
+            bits,
+        },
+        dataLayout, rewriter);
 
     rewriter.replaceOp(instrumentOp, operands.getOperand());
     return success();
@@ -602,13 +710,14 @@ struct ConvertHALInstrumentMemoryLoadOp
         operands.getBase(), operands.getIndices(), rewriter);
     Value addressI64 = rewriter.create<LLVM::PtrToIntOp>(loc, i64Type, loadPtr);
 
-    appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
-                               operands.getBuffer(), entryType,
-                               {
-                                   header,
-                                   addressI64,
-                               },
-                               dataLayout, rewriter);
+    appendWorkgroupInstrumentationEntry(
+        loc, instrumentOp.getWorkgroupKey(), operands.getWorkgroupKey(),
+        instrumentOp.getBuffer(), operands.getBuffer(), entryType,
+        {
+            header,
+            addressI64,
+        },
+        dataLayout, rewriter);
 
     rewriter.replaceOp(instrumentOp, operands.getLoadValue());
     return success();
@@ -650,13 +759,14 @@ struct ConvertHALInstrumentMemoryStoreOp
     Value addressI64 =
         rewriter.create<LLVM::PtrToIntOp>(loc, i64Type, storePtr);
 
-    appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
-                               operands.getBuffer(), entryType,
-                               {
-                                   header,
-                                   addressI64,
-                               },
-                               dataLayout, rewriter);
+    appendWorkgroupInstrumentationEntry(
+        loc, instrumentOp.getWorkgroupKey(), operands.getWorkgroupKey(),
+        instrumentOp.getBuffer(), operands.getBuffer(), entryType,
+        {
+            header,
+            addressI64,
+        },
+        dataLayout, rewriter);
 
     rewriter.replaceOp(instrumentOp, operands.getStoreValue());
     return success();
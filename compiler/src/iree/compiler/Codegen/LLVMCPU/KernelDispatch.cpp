@@ -6,6 +6,7 @@
 
 #include "iree/compiler/Codegen/LLVMCPU/KernelDispatch.h"
 
+#include "iree/compiler/Codegen/Common/DispatchProfile.h"
 #include "iree/compiler/Codegen/Common/TileSizeSelection.h"
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenAttrs.h"
 #include "iree/compiler/Codegen/Interfaces/PartitionableLoopsInterface.h"
@@ -79,6 +80,14 @@ static llvm::cl::opt<int> clGeneralMatmulTileBytes(
                    "in data-tiled matmuls (mmt4d)."),
     llvm::cl::init(64 * 1024));
 
+static llvm::cl::opt<int> clAttentionBlockBytes(
+    "iree-llvmcpu-attention-block-bytes",
+    llvm::cl::desc("target size in bytes of the key and value blocks and the "
+                   "scores computed from them in each iteration of the online "
+                   "softmax loop of attention ops. Should fit in the L1 data "
+                   "cache."),
+    llvm::cl::init(32 * 1024));
+
 static llvm::cl::opt<bool> clDisableVectorPeeling(
     "iree-llvmcpu-disable-vector-peeling",
     llvm::cl::desc("Disable peeling as a pre-processing step for "
@@ -202,6 +211,20 @@ static void getRangeBounds(TilingInterface op, SmallVectorImpl<int64_t> &lb,
                            [&](Range r) { return getStaticValue(r.size); });
 }
 
+/// Returns true if the target has native vector predication (AVX-512 mask
+/// registers or RVV) so that masked vector operations cost about the same as
+/// unmasked ones.
+static bool
+hasNativeVectorPredication(IREE::HAL::ExecutableTargetAttr targetAttr) {
+  if (isX86(targetAttr)) {
+    return hasAVX512fFeature(targetAttr);
+  }
+  if (isRISCV(targetAttr)) {
+    return hasVFeature(targetAttr) || hasZve32xFeature(targetAttr);
+  }
+  return false;
+}
+
 /// Returns the vectorization pre-processing strategy (peeling, masking) for the
 /// given LinalgOp. It is based on either (in the priority order):
 ///   * user-specified value, or
@@ -226,6 +249,15 @@ getVectorPreProcStrategy(linalg::LinalgOp linalgOp) {
   auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(linalgOp);
   bool isLinalgGeneric = isa<linalg::GenericOp>(linalgOp.getOperation());
 
+  // On targets with native predication the dynamic remainder of each vector
+  // dimension is cheaper to handle with masks than by peeling it into scalar
+  // or narrow code. Static shapes keep the target defaults below so that the
+  // cache-level tiling of the peeling pipeline is preserved.
+  if (hasNativeVectorPredication(targetAttr) &&
+      llvm::any_of(linalgOp.getStaticLoopRanges(), ShapedType::isDynamic)) {
+    return VectorPreProcStrategy::Masking;
+  }
+
   // Default X86 specific strategy.
   if (isX86(targetAttr)) {
     if (isLinalgGeneric) {
@@ -1712,6 +1744,46 @@ static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
       DispatchLoweringPassPipeline::CPUDataTiling);
 }
 
+/// Returns the size of the blocks of the K2 (key sequence) dimension that the
+/// online softmax loop of |attnOp| iterates over, or 0 if the dimension cannot
+/// be blocked. Blocks are the largest power of two dividing the dimension such
+/// that a block of keys and values together with the f32 scores of
+/// |queryTileSize| queries fit in `clAttentionBlockBytes`, but no smaller than
+/// |vectorSize|.
+static int64_t
+getAttentionKeyBlockSize(IREE::LinalgExt::AttentionOp attnOp,
+                         const IREE::LinalgExt::AttentionOpDetail &opInfo,
+                         ArrayRef<int64_t> ubs, int64_t queryTileSize,
+                         int64_t vectorSize) {
+  if (opInfo.getK2Dims().size() != 1)
+    return 0;
+  int64_t keySequenceLength = ubs[opInfo.getK2Dims().front()];
+  int64_t headDims = 0;
+  for (int64_t i :
+       llvm::concat<const int64_t>(opInfo.getK1Dims(), opInfo.getNDims())) {
+    if (ShapedType::isDynamic(ubs[i]))
+      return 0;
+    headDims += ubs[i];
+  }
+  if (ShapedType::isDynamic(keySequenceLength) || keySequenceLength <= 0 ||
+      ShapedType::isDynamic(queryTileSize)) {
+    return 0;
+  }
+  int64_t elementBytes = IREE::Util::getRoundedElementByteWidth(
+      attnOp.getKeyType().getElementType());
+  auto getBlockBytes = [&](int64_t blockSize) {
+    return blockSize * headDims * elementBytes +
+           queryTileSize * blockSize * sizeof(float);
+  };
+  int64_t blockSize = llvm::bit_floor<uint64_t>(keySequenceLength);
+  while (blockSize > vectorSize &&
+         (keySequenceLength % blockSize != 0 ||
+          getBlockBytes(blockSize) > clAttentionBlockBytes)) {
+    blockSize /= 2;
+  }
+  return keySequenceLength % blockSize == 0 ? blockSize : 0;
+}
+
 static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
                                    IREE::LinalgExt::AttentionOp attnOp) {
   FailureOr<IREE::LinalgExt::AttentionOpDetail> maybeOpInfo =
@@ -1782,9 +1854,24 @@ static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
 
   TileSizesListType tileSizes = {distTileSizes, vecTileSizes};
 
+  // Iterate over K2 in blocks of keys and values that stay in cache while the
+  // online softmax of a vector tile of queries is updated. The block size is
+  // carried in the reduction level and used when tiling the attention op.
   // TODO: (Groverkss): Tile K2 here using reduction tiling interface once we
   // have it. TileAndDecomposeAttention pass only tiles K2. I think it should
   // be possible to tile K1 also, but need to explore it more.
+  int64_t queryTileSize = 1;
+  for (int64_t i : opInfo.getMDims()) {
+    queryTileSize *= vecTileSizes[i] ? vecTileSizes[i] : ubs[i];
+  }
+  int64_t keyBlockSize = getAttentionKeyBlockSize(attnOp, opInfo, ubs,
+                                                  queryTileSize, vectorSize);
+  if (keyBlockSize) {
+    SmallVector<int64_t> reductionTileSizes(attnOp.getIterationDomainRank(),
+                                            0);
+    reductionTileSizes[opInfo.getK2Dims().front()] = keyBlockSize;
+    tileSizes.push_back(reductionTileSizes);
+  }
 
   return setOpConfigAndEntryPointFnTranslation(
       entryPointFn, attnOp, tileSizes,
@@ -2156,6 +2243,14 @@ setRootConfig(mlir::FunctionOpInterface entryPointFn,
     return success();
   }
 
+  // Data-tiled matmuls with grouped-quantized RHS are tiled like linalg.mmt4d
+  // so that they lower to the mmt4d_dequant ukernel.
+  if (succeeded(getMmt4dDequantGroupSize(genericOp))) {
+    return setOpConfigAndEntryPointFnTranslation(
+        entryPointFn, genericOp, getMmt4dTileSizes(genericOp),
+        DispatchLoweringPassPipeline::Mmt4dTilingExpert);
+  }
+
   if (succeeded(setTransposeLikeOpRootConfig(
           entryPointFn, genericOp, linalgOpInfo, targetMLTransInfo))) {
     return success();
@@ -2956,6 +3051,11 @@ setTranslationInfoAndRootConfig(mlir::FunctionOpInterface entryPointFn,
   // Ignore the tile sizes adjustment.
   auto pipeline = getTranslationInfo(entryPointFn).getPassPipeline().getValue();
   if (pipeline != DispatchLoweringPassPipeline::TransformDialectCodegen) {
+    // Prefer the fastest configuration measured at runtime, if any.
+    if (failed(applyDispatchProfile(entryPointFn, rootOperation))) {
+      return failure();
+    }
+
     if (failed(adjustTileSizesForUnPackOp(entryPointFn, rootOperation))) {
       return failure();
     }
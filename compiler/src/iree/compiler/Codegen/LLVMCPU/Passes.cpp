@@ -597,8 +597,23 @@ void addCPULinalgExtTileAndVectorizePipeline(
       createLLVMCPUTilePass(tilingConfig.getVectorCommonParallelLevel()));
   // TODO: Remove the pass once we have PartialReductionOpInterface implemented
   // for AttentionOp.
-  funcPassManager.addPass(IREE::LinalgExt::createTileAttentionPass());
-  funcPassManager.addPass(IREE::LinalgExt::createDecomposeAttentionPass());
+  // The reduction level holds the size of the key blocks the online softmax
+  // loop iterates over, if one was selected.
+  int64_t keyBlockSize = 0;
+  if (tilingConfig.getNumTilingLevels() > 2) {
+    for (int64_t tileSize : tilingConfig.getVectorReductionSizes().first) {
+      keyBlockSize = std::max(keyBlockSize, tileSize);
+    }
+  }
+  if (keyBlockSize > 0) {
+    funcPassManager.addPass(
+        IREE::LinalgExt::createTileAttentionPass(keyBlockSize));
+    funcPassManager.addPass(
+        IREE::LinalgExt::createDecomposeAttentionPass(keyBlockSize));
+  } else {
+    funcPassManager.addPass(IREE::LinalgExt::createTileAttentionPass());
+    funcPassManager.addPass(IREE::LinalgExt::createDecomposeAttentionPass());
+  }
   funcPassManager.addPass(
       IREE::LinalgExt::createDecomposeWinogradTransformPass());
 
@@ -648,6 +663,7 @@ static void addLowerToLLVMPasses(OpPassManager &modulePassManager,
       .addPass(createConvertLinalgToLoopsPass)
       .addPass(createConvertBf16ArithToF32Pass)
       .addPass(createConvertBf16ToUInt16BuffersPass)
+      .addPass(createConvertF8ArithToF32Pass)
       .addPass(createCanonicalizerPass)
       .addPass(createCSEPass);
 
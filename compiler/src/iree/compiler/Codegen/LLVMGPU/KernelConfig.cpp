@@ -10,17 +10,20 @@
 #include <numeric>
 #include <optional>
 
+#include "iree/compiler/Codegen/Common/DispatchProfile.h"
 #include "iree/compiler/Codegen/Common/GPU/GPUHeuristics.h"
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenAttrs.h"
 #include "iree/compiler/Codegen/Dialect/GPU/IR/IREEGPUAttrs.h"
 #include "iree/compiler/Codegen/Interfaces/PartitionableLoopsInterface.h"
 #include "iree/compiler/Codegen/Interfaces/UKernelOpInterface.h"
+#include "iree/compiler/Codegen/LLVMGPU/Passes.h"
 #include "iree/compiler/Codegen/TransformStrategies/GPU/Strategies.h"
 #include "iree/compiler/Codegen/Utils/GPUUtils.h"
 #include "iree/compiler/Codegen/Utils/LinalgOpInfo.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
 #include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtOps.h"
+#include "iree/compiler/Dialect/LinalgExt/Utils/IndexingUtils.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
@@ -70,6 +73,19 @@ llvm::cl::opt<int> clGPUMatmulCThreshold(
     // TODO: We should get this value from the target's parallelism.
     llvm::cl::init(512 * 512));
 
+llvm::cl::opt<bool> clGPUEnableWorkgroupSwizzle(
+    "iree-codegen-llvmgpu-enable-workgroup-swizzle",
+    llvm::cl::desc("swizzle the workgroups of matmuls to keep their operands "
+                   "in the L2 cache when the target chip describes it"),
+    llvm::cl::init(true));
+
+llvm::cl::opt<int> clGPUVectorDistributePipelineDepth(
+    "iree-codegen-llvmgpu-vector-distribute-pipeline-depth",
+    llvm::cl::desc("maximum number of reduction iterations to prefetch into "
+                   "multi-buffered shared memory for matmuls in the vector "
+                   "distribute pipeline (0 disables multi-buffering)"),
+    llvm::cl::init(0));
+
 namespace {
 
 using CodeGenPipeline = IREE::Codegen::DispatchLoweringPassPipeline;
@@ -77,6 +93,9 @@ using CodeGenPipeline = IREE::Codegen::DispatchLoweringPassPipeline;
 constexpr StringLiteral kCudaTarget = "cuda";
 constexpr StringLiteral kRocmTarget = "rocm";
 
+// Largest log2 of the number of workgroup rows grouped together by swizzling.
+constexpr unsigned kMaxWorkgroupSwizzleLogTile = 5;
+
 // Threshold used to determine whether a matmul dimension is 'very skinny'.
 constexpr int64_t kVerySkinnyDimThreshold = 4;
 
@@ -207,6 +226,94 @@ static CodeGenPipeline getTensorCorePipeline(Type elementType) {
   return codegenPipeline;
 }
 
+/// Returns the log2 of the number of workgroup rows to group together when
+/// rasterizing the workgroup grid of the matmul |op| tiled by |tileM| x
+/// |tileN|, or 0 if the default row-major order is kept.
+///
+/// The workgroups running concurrently on the chip read the LHS rows and RHS
+/// columns of the output tiles they cover. In row-major order they cover few
+/// rows that span the whole grid width, so the RHS footprint grows with the
+/// grid. Grouping rows makes the covered block closer to a square. A group is
+/// only used when the row-major footprint does not fit in the L2 cache.
+static unsigned getWorkgroupSwizzleLogTile(IREE::GPU::TargetAttr target,
+                                           linalg::LinalgOp op, int64_t tileM,
+                                           int64_t tileN) {
+  IREE::GPU::TargetChipAttr chip = target.getChip();
+  if (!clGPUEnableWorkgroupSwizzle || !chip || chip.getL2CacheBytes() == 0 ||
+      tileM <= 0 || tileN <= 0) {
+    return 0;
+  }
+  FailureOr<linalg::ContractionDimensions> contractionDims =
+      linalg::inferContractionDims(op);
+  if (failed(contractionDims) || contractionDims->m.empty() ||
+      contractionDims->n.empty() || contractionDims->k.empty()) {
+    return 0;
+  }
+  SmallVector<int64_t, 4> bounds = op.getStaticLoopRanges();
+  int64_t sizeM = bounds[contractionDims->m.back()];
+  int64_t sizeN = bounds[contractionDims->n.back()];
+  int64_t sizeK = 1;
+  for (int64_t k : contractionDims->k) {
+    sizeK = ShapedType::isDynamic(bounds[k]) || ShapedType::isDynamic(sizeK)
+                ? ShapedType::kDynamic
+                : sizeK * bounds[k];
+  }
+  if (ShapedType::isDynamic(sizeM) || ShapedType::isDynamic(sizeN) ||
+      ShapedType::isDynamic(sizeK)) {
+    return 0;
+  }
+
+  int64_t gridX = llvm::divideCeil(sizeN, tileN);
+  int64_t gridY = llvm::divideCeil(sizeM, tileM);
+  int64_t concurrentCount =
+      std::min<int64_t>(chip.getWgpCount(), gridX * gridY);
+  Type lhsElemType = getElementTypeOrSelf(op.getDpsInputOperand(0)->get());
+  Type rhsElemType = getElementTypeOrSelf(op.getDpsInputOperand(1)->get());
+  int64_t lhsRowBytes =
+      tileM * sizeK * lhsElemType.getIntOrFloatBitWidth() / 8;
+  int64_t rhsColumnBytes =
+      tileN * sizeK * rhsElemType.getIntOrFloatBitWidth() / 8;
+  // Bytes read by the concurrent workgroups when they cover |rows| rows.
+  auto getFootprint = [&](int64_t rows) {
+    int64_t columns = std::min(gridX, llvm::divideCeil(concurrentCount, rows));
+    rows = llvm::divideCeil(concurrentCount, columns);
+    return rows * lhsRowBytes + columns * rhsColumnBytes;
+  };
+  int64_t bestFootprint = getFootprint(1);
+  if (bestFootprint <= chip.getL2CacheBytes())
+    return 0;
+
+  unsigned bestLogTile = 0;
+  for (unsigned logTile = 1; logTile <= kMaxWorkgroupSwizzleLogTile &&
+                            (int64_t(1) << logTile) <= gridY;
+       ++logTile) {
+    int64_t footprint = getFootprint(int64_t(1) << logTile);
+    if (footprint < bestFootprint) {
+      bestFootprint = footprint;
+      bestLogTile = logTile;
+    }
+  }
+  LDBG("Workgroup swizzle log tile: " << bestLogTile << " (" << bestFootprint
+                                      << " bytes)");
+  return bestLogTile;
+}
+
+/// Adds the workgroup swizzle picked for |op| to the translation info config
+/// |attrs|.
+static void addWorkgroupSwizzleConfig(IREE::GPU::TargetAttr target,
+                                      linalg::LinalgOp op, int64_t tileM,
+                                      int64_t tileN,
+                                      SmallVectorImpl<NamedAttribute> &attrs) {
+  unsigned logTile = getWorkgroupSwizzleLogTile(target, op, tileM, tileN);
+  if (logTile == 0)
+    return;
+  MLIRContext *context = op.getContext();
+  attrs.emplace_back(
+      StringAttr::get(context,
+                      LLVMGPUAttrNames::kReorderWorkgroupsLogSwizzleTile),
+      IntegerAttr::get(IntegerType::get(context, 64), logTile));
+}
+
 //====---------------------------------------------------------------------===//
 // Vector Distribution Contraction/Convolution Pipeline Configuration
 //====---------------------------------------------------------------------===//
@@ -549,8 +656,33 @@ setMatmulVectorDistributionConfig(IREE::GPU::TargetAttr target,
   auto scheduleAttr = IREE::GPU::MMAScheduleAttr::get(
       context, target.getWgp().getMma()[schedule->index], schedule->mWarpCount,
       schedule->nWarpCount);
-  SmallVector<NamedAttribute, 1> attrs;
+  SmallVector<NamedAttribute, 4> attrs;
   attrs.emplace_back(StringAttr::get(context, "mma_schedule"), scheduleAttr);
+
+  // Copy the operands of the next reduction iterations from global to shared
+  // memory while computing on the current one. Each prefetched iteration
+  // needs its own copy of the operand tiles in shared memory, so decrease the
+  // depth until all buffers fit.
+  int64_t pipelineDepth = clGPUVectorDistributePipelineDepth;
+  int64_t kTripCount =
+      llvm::divideCeil(bounds[kDim], workgroupTileSizes[kDim]);
+  pipelineDepth = std::min(pipelineDepth, kTripCount - 1);
+  int64_t bytesPerBuffer =
+      (workgroupTileSizes[mDim] * lhsElemType.getIntOrFloatBitWidth() +
+       workgroupTileSizes[nDim] * rhsElemType.getIntOrFloatBitWidth()) *
+      workgroupTileSizes[kDim] / 8;
+  while (pipelineDepth > 0 &&
+         (pipelineDepth + 1) * bytesPerBuffer > maxSharedMemoryBytes) {
+    --pipelineDepth;
+  }
+  if (pipelineDepth > 0) {
+    LDBG("Software pipeline depth: " << pipelineDepth);
+    llvm::append_range(attrs, getSoftwarePipeliningAttrDict(
+                                  context, pipelineDepth,
+                                  /*softwarePipelineStoreStage=*/0));
+  }
+  addWorkgroupSwizzleConfig(target, op, workgroupTileSizes[mDim],
+                            workgroupTileSizes[nDim], attrs);
   auto configDict = DictionaryAttr::get(context, attrs);
 
   return setOpConfigAndEntryPointFnTranslation(entryPoint, op, tileSizes,
@@ -558,6 +690,172 @@ setMatmulVectorDistributionConfig(IREE::GPU::TargetAttr target,
                                                targetSubgroupSize, configDict);
 }
 
+/// Sets a fused (Flash Attention 2 style) configuration for |op|. Each
+/// workgroup computes a tile of queries and iterates over blocks of keys and
+/// values, keeping the scores and the online softmax state in registers. Both
+/// contractions of a block are transposed before distribution so that the
+/// queries map to the N dimension of the MMA schedule and the accumulator of
+/// the first feeds the second without going through shared memory.
+static LogicalResult
+setAttentionVectorDistributionConfig(IREE::GPU::TargetAttr target,
+                                     mlir::FunctionOpInterface entryPoint,
+                                     IREE::LinalgExt::AttentionOp op) {
+  if (target.getWgp().getMma().empty())
+    return failure();
+
+  const int64_t targetSubgroupSize = target.getPreferredSubgroupSize();
+
+  FailureOr<IREE::LinalgExt::AttentionOpDetail> maybeOpInfo =
+      IREE::LinalgExt::AttentionOpDetail::get(op.getIndexingMapsArray());
+  if (failed(maybeOpInfo))
+    return failure();
+  IREE::LinalgExt::AttentionOpDetail opInfo = maybeOpInfo.value();
+  if (opInfo.getMDims().size() != 1 || opInfo.getK1Dims().size() != 1 ||
+      opInfo.getK2Dims().size() != 1 || opInfo.getNDims().size() != 1) {
+    return failure();
+  }
+
+  SmallVector<int64_t> bounds(op.getIterationDomainRank(),
+                              ShapedType::kDynamic);
+  auto fillBounds = [&](ShapedType type, AffineMap map) {
+    for (auto [idx, expr] : llvm::enumerate(map.getResults())) {
+      bounds[cast<AffineDimExpr>(expr).getPosition()] = type.getDimSize(idx);
+    }
+  };
+  // Sizes can be found from Q, K, V alone.
+  fillBounds(op.getQueryType(), op.getQueryMap());
+  fillBounds(op.getKeyType(), op.getKeyMap());
+  fillBounds(op.getValueType(), op.getValueMap());
+  int64_t mDim = opInfo.getMDims().front();
+  int64_t k1Dim = opInfo.getK1Dims().front();
+  int64_t k2Dim = opInfo.getK2Dims().front();
+  int64_t nDim = opInfo.getNDims().front();
+  // Dynamic dims are expected to be taken care of earlier in the pipeline.
+  if (llvm::any_of(ArrayRef<int64_t>{bounds[mDim], bounds[k1Dim], bounds[k2Dim],
+                                     bounds[nDim]},
+                   ShapedType::isDynamic)) {
+    return failure();
+  }
+
+  Type elementType = op.getQueryType().getElementType();
+  if (!elementType.isF16() || op.getKeyType().getElementType() != elementType ||
+      op.getValueType().getElementType() != elementType) {
+    return failure();
+  }
+
+  LDBG("Attention Vector Distribution Config");
+
+  // Both contractions accumulate in f32 and the scores are truncated back to
+  // f16 before the second one.
+  MLIRContext *context = op.getContext();
+  Type f32Type = Float32Type::get(context);
+  IREE::GPU::MMAAttr intrinsic;
+  int64_t intrinsicM = 0, intrinsicN = 0, intrinsicK = 0;
+  for (IREE::GPU::MMAAttr mma : target.getWgp().getMma()) {
+    auto [mSize, nSize, kSize] = mma.getMNKShape();
+    auto [aType, bType, cType] = mma.getABCElementTypes();
+    if (mma.getSubgroupSize() != targetSubgroupSize ||
+        aType != elementType || bType != elementType || cType != f32Type) {
+      continue;
+    }
+    // The keys and the head dimension of the values are the M dimensions and
+    // the head dimension of the keys and the keys are the K dimensions.
+    if (bounds[nDim] % mSize != 0 || bounds[k1Dim] % kSize != 0)
+      continue;
+    intrinsic = mma;
+    intrinsicM = mSize;
+    intrinsicN = nSize;
+    intrinsicK = kSize;
+    break;
+  }
+  if (!intrinsic) {
+    LDBG("No intrinsic matching the attention head dimensions");
+    return failure();
+  }
+
+  // Spread the queries of a workgroup across as many subgroups as the query
+  // sequence divides into.
+  int64_t subgroupCount = 4;
+  while (subgroupCount > 1 &&
+         bounds[mDim] % (subgroupCount * intrinsicN) != 0) {
+    subgroupCount /= 2;
+  }
+  int64_t queryTileSize = subgroupCount * intrinsicN;
+  if (bounds[mDim] % queryTileSize != 0)
+    return failure();
+
+  // The key block is both an M dimension of the first contraction and the K
+  // dimension of the second.
+  int64_t keyBlockSize = 64;
+  while (keyBlockSize >= std::max(intrinsicM, intrinsicK) &&
+         bounds[k2Dim] % keyBlockSize != 0) {
+    keyBlockSize /= 2;
+  }
+  if (keyBlockSize < std::max(intrinsicM, intrinsicK) ||
+      keyBlockSize % intrinsicM != 0 || keyBlockSize % intrinsicK != 0) {
+    LDBG("No key block size dividing the key sequence");
+    return failure();
+  }
+
+  LDBG("Target Subgroup size: " << targetSubgroupSize);
+  LDBG("Attention query tile: " << queryTileSize
+                                << ", key block: " << keyBlockSize
+                                << ", subgroups: " << subgroupCount);
+
+  std::array<int64_t, 3> workgroupSize{subgroupCount * targetSubgroupSize, 1,
+                                       1};
+
+  // Distribute all batch dimensions with unit size and the queries in tiles.
+  // The reduction dimensions and the head dimension of the values are kept
+  // whole within a workgroup.
+  SmallVector<int64_t> workgroupTileSizes(op.getIterationDomainRank(), 0);
+  for (int64_t batch : opInfo.getBatchDims()) {
+    workgroupTileSizes[batch] = 1;
+  }
+  workgroupTileSizes[mDim] = queryTileSize;
+  TileSizesListType tileSizes;
+  tileSizes.push_back(workgroupTileSizes);
+
+  // After transposing the chained contractions the queries are the N
+  // dimension of both, so the subgroups are laid out along N.
+  auto scheduleAttr = IREE::GPU::MMAScheduleAttr::get(
+      context, intrinsic, /*subgroup_m_count=*/1,
+      /*subgroup_n_count=*/subgroupCount);
+  SmallVector<NamedAttribute, 4> attrs;
+  attrs.emplace_back(StringAttr::get(context, "mma_schedule"), scheduleAttr);
+  attrs.emplace_back(
+      StringAttr::get(context, LLVMGPUAttrNames::kAttentionKeyBlockSize),
+      IntegerAttr::get(IntegerType::get(context, 64), keyBlockSize));
+
+  // Double buffer the keys and values in shared memory by default so that the
+  // next block is loaded while the current one is computed on.
+  int64_t pipelineDepth = 1;
+  if (clGPUVectorDistributePipelineDepth.getNumOccurrences() > 0)
+    pipelineDepth = clGPUVectorDistributePipelineDepth;
+  int64_t keyTripCount = bounds[k2Dim] / keyBlockSize;
+  pipelineDepth = std::min(pipelineDepth, keyTripCount - 1);
+  int64_t bytesPerBuffer =
+      (queryTileSize * bounds[k1Dim] +
+       keyBlockSize * (bounds[k1Dim] + bounds[nDim])) *
+      elementType.getIntOrFloatBitWidth() / 8;
+  int64_t maxSharedMemoryBytes = target.getWgp().getMaxWorkgroupMemoryBytes();
+  while (pipelineDepth > 0 &&
+         (pipelineDepth + 1) * bytesPerBuffer > maxSharedMemoryBytes) {
+    --pipelineDepth;
+  }
+  if (pipelineDepth > 0) {
+    LDBG("Software pipeline depth: " << pipelineDepth);
+    llvm::append_range(attrs, getSoftwarePipeliningAttrDict(
+                                  context, pipelineDepth,
+                                  /*softwarePipelineStoreStage=*/0));
+  }
+  auto configDict = DictionaryAttr::get(context, attrs);
+
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPoint, op, tileSizes, CodeGenPipeline::LLVMGPUVectorDistribute,
+      workgroupSize, targetSubgroupSize, configDict);
+}
+
 static LogicalResult
 setVectorDistributionConfig(IREE::GPU::TargetAttr target,
                             mlir::FunctionOpInterface entryPoint,
@@ -582,6 +880,11 @@ setVectorDistributionConfig(IREE::GPU::TargetAttr target,
     }
   }
 
+  if (auto attnOp = dyn_cast<IREE::LinalgExt::AttentionOp>(computeOp)) {
+    LDBG("VectorDistribution: trying to find a suitable attention config");
+    return setAttentionVectorDistributionConfig(target, entryPoint, attnOp);
+  }
+
   LDBG("VectorDistribution: failed to find a suitable config");
   return failure();
 }
@@ -647,12 +950,12 @@ static LogicalResult setContractConfig(IREE::GPU::TargetAttr target,
     return failure();
   }
 
-  auto setMatmulConfig = [&entryPoint, &op](int64_t tileX, int64_t tileY,
-                                            int64_t tileK,
-                                            ArrayRef<int64_t> workgroupSize,
-                                            ArrayRef<int32_t> subgroupSizes,
-                                            unsigned softwarePipelineDepth,
-                                            CodeGenPipeline pipeline) {
+  auto setMatmulConfig = [&target, &entryPoint,
+                          &op](int64_t tileX, int64_t tileY, int64_t tileK,
+                               ArrayRef<int64_t> workgroupSize,
+                               ArrayRef<int32_t> subgroupSizes,
+                               unsigned softwarePipelineDepth,
+                               CodeGenPipeline pipeline) {
     TileSizesListType tileSizes;
     unsigned numParallelLoops = op.getNumParallelLoops();
     SmallVector<int64_t> workgroupTileSizes(numParallelLoops - 2, 1);
@@ -676,10 +979,13 @@ static LogicalResult setContractConfig(IREE::GPU::TargetAttr target,
     if (!subgroupSizes.empty())
       subgroupSize = subgroupSizes.front();
 
+    auto attrs = llvm::to_vector(getSoftwarePipeliningAttrDict(
+        op->getContext(), softwarePipelineDepth,
+        /*softwarePipelineStoreStage=*/1));
+    addWorkgroupSwizzleConfig(target, op, tileX, tileY, attrs);
     return setOpConfigAndEntryPointFnTranslation(
         entryPoint, op, tileSizes, pipeline, workgroupSize, subgroupSize,
-        getSoftwarePipeliningAttrDict(op->getContext(), softwarePipelineDepth,
-                                      /*softwarePipelineStoreStage=*/1));
+        DictionaryAttr::get(op->getContext(), attrs));
   };
   // Infer the MxN size of the matmul based on operands and indexing maps.
   auto lhsShape =
@@ -1533,6 +1839,48 @@ setArgmaxUkernelConfig(IREE::GPU::TargetAttr target,
   return success();
 }
 
+/// Set the configuration for topk that can be mapped to the topk uKernel.
+/// Like argmax, distribute all parallel dims across different workgroups, and
+/// only use a single subgroup per workgroup.
+static LogicalResult
+setTopkUkernelConfig(IREE::GPU::TargetAttr target,
+                     mlir::FunctionOpInterface entryPoint,
+                     IREE::LinalgExt::TopkOp op) {
+  // Checks if UKernels are enabled.
+  if (auto target = IREE::HAL::ExecutableTargetAttr::lookup(entryPoint)) {
+    const char ukernelName[] = "topk";
+    if (!hasUkernel(target, ukernelName) ||
+        !hasUkernelSupportedGpuArch(target)) {
+      return failure();
+    }
+  }
+
+  if (!target.supportsSubgroupShuffle())
+    return failure();
+
+  if (failed(isTopkMaxOp(op)))
+    return failure();
+
+  // The uKernel keeps k candidates per lane in registers.
+  int64_t k = cast<ShapedType>(op.outputValues().getType()).getShape().back();
+  if (ShapedType::isDynamic(k) || k > kTopkUkernelMaxK)
+    return failure();
+
+  // Tile all the parallel dimension to 1.
+  SmallVector<unsigned> partitionedLoops =
+      cast<PartitionableLoopsInterface>(op.getOperation())
+          .getPartitionableLoops(kNumMaxParallelDims);
+  size_t numLoops = partitionedLoops.empty() ? 0 : partitionedLoops.back() + 1;
+  SmallVector<int64_t> workgroupTileSizes(numLoops, 1);
+  TileSizesListType tileSizes;
+  tileSizes.emplace_back(std::move(workgroupTileSizes)); // Workgroup level
+  std::array<int64_t, 3> workgroupSize = {target.getPreferredSubgroupSize(), 1,
+                                          1};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPoint, op, tileSizes, CodeGenPipeline::LLVMGPUDefault,
+      workgroupSize);
+}
+
 /// Make UKernels take the LLVMGPUDefault lowering pipeline.
 static LogicalResult
 setUKernelConfig(mlir::FunctionOpInterface entryPoint,
@@ -1761,6 +2109,14 @@ static LogicalResult setRootConfig(IREE::GPU::TargetAttr target,
         LDBG("Sort Config");
         return setSortConfig(target, entryPointFn, sortOp);
       })
+      .Case<IREE::LinalgExt::TopkOp>([&](auto topkOp) {
+        if (succeeded(setTopkUkernelConfig(target, entryPointFn, topkOp))) {
+          LDBG("Topk Ukernel Config");
+          return success();
+        }
+        LDBG("Default Config");
+        return setRootDefaultConfig(target, entryPointFn, computeOp);
+      })
       .Case<IREE::LinalgExt::WinogradInputTransformOp,
             IREE::LinalgExt::WinogradOutputTransformOp,
             IREE::LinalgExt::WinogradFilterTransformOp>([&](auto winogradOp) {
@@ -1882,6 +2238,13 @@ LogicalResult initGPULaunchConfig(FunctionOpInterface funcOp) {
   if (failed(setRootConfig(target, funcOp, rootOperation)))
     return funcOp.emitOpError("failed to set root config");
 
+  // Prefer the fastest configuration measured at runtime, if any. The
+  // workgroup size is derived from the tile sizes so it must also be measured.
+  if (failed(applyDispatchProfile(funcOp, rootOperation,
+                                  /*requireWorkgroupSize=*/true))) {
+    return failure();
+  }
+
   propagateLoweringConfig(rootOperation, computeOps);
   return success();
 }
@@ -88,6 +88,14 @@ getPipelineOptions(FunctionOpInterface funcOp,
       pipelineOptions.enableReduceSharedMemoryBankConflicts = false;
     if (config.contains(LLVMGPUAttrNames::kNoReorderWorkgroups))
       pipelineOptions.enableReorderWorkgroups = false;
+    if (auto logTile = config.getAs<IntegerAttr>(
+            LLVMGPUAttrNames::kReorderWorkgroupsLogSwizzleTile)) {
+      pipelineOptions.reorderWorkgroupsLogSwizzleTile = logTile.getInt();
+    }
+    if (auto keyBlockSize = config.getAs<IntegerAttr>(
+            LLVMGPUAttrNames::kAttentionKeyBlockSize)) {
+      pipelineOptions.attentionKeyBlockSize = keyBlockSize.getInt();
+    }
   }
 
   pipelineOptions.enableUkernels = targetAttr && hasUkernel(targetAttr);
@@ -164,14 +172,20 @@ void LLVMGPULowerExecutableTargetPass::runOnOperation() {
     addGPUTransposePassPipeline(pipeline, pipelineOptions);
     break;
   case IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUVectorDistribute:
-    addGPUVectorDistributePassPipeline(pipeline, pipelineOptions,
-                                       /*usePadToModelSharedMemcpy=*/false);
-    break;
   case IREE::Codegen::DispatchLoweringPassPipeline::
-      LLVMGPUPadAndVectorDistribute:
+      LLVMGPUPadAndVectorDistribute: {
+    // Software pipelining is optional in the vector distribute pipeline.
+    FailureOr<int64_t> maybeDepth =
+        getSoftwarePipelineDepth(translationInfo.getConfiguration());
+    bool usePadToModelSharedMemcpy =
+        translationInfo.getDispatchLoweringPassPipeline() ==
+        IREE::Codegen::DispatchLoweringPassPipeline::
+            LLVMGPUPadAndVectorDistribute;
     addGPUVectorDistributePassPipeline(pipeline, pipelineOptions,
-                                       /*usePadToModelSharedMemcpy=*/true);
+                                       usePadToModelSharedMemcpy,
+                                       succeeded(maybeDepth) ? *maybeDepth : 0);
     break;
+  }
   case IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUWarpReduction:
     addGPUWarpReductionPassPipeline(pipeline);
     break;
@@ -80,6 +80,9 @@ llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
   return os << "{" << "enableReduceSharedMemoryBankConflicts = "
             << options.enableReduceSharedMemoryBankConflicts
             << ", enableReorderWorkgroups = " << options.enableReorderWorkgroups
+            << ", reorderWorkgroupsLogSwizzleTile = "
+            << options.reorderWorkgroupsLogSwizzleTile
+            << ", attentionKeyBlockSize = " << options.attentionKeyBlockSize
             << ", enableUkernels = " << options.enableUkernels << "}";
 }
 
@@ -170,6 +173,23 @@ static LogicalResult canReorderWorkgroups(FunctionOpInterface funcOp) {
   return success(workgroupCounts.size() >= 2);
 }
 
+static void addReorderWorkgroupsPass(OpPassManager &funcPassManager,
+                                     const LLVMGPUPipelineOptions &options) {
+  if (!options.enableReorderWorkgroups)
+    return;
+  ReorderWorkgrupsStrategy strategy = clReorderWorkgroupsStrategy;
+  unsigned logSwizzleTile = clReorderWorkgroupsLogSwizzleTile;
+  // Use the swizzle picked by the kernel configuration unless a strategy is
+  // explicitly requested.
+  if (clReorderWorkgroupsStrategy.getNumOccurrences() == 0 &&
+      options.reorderWorkgroupsLogSwizzleTile != 0) {
+    strategy = ReorderWorkgrupsStrategy::Swizzle;
+    logSwizzleTile = options.reorderWorkgroupsLogSwizzleTile;
+  }
+  funcPassManager.addPass(
+      createReorderWorkgroups(strategy, logSwizzleTile, canReorderWorkgroups));
+}
+
 //===----------------------------------------------------------------------===//
 // Common Pass Recipes
 //===----------------------------------------------------------------------===//
@@ -321,11 +341,7 @@ void addGPUMatmulSimtPassPipeline(OpPassManager &funcPassManager,
     funcPassManager.addPass(createGPUReduceBankConflictsPass());
   }
 
-  if (options.enableReorderWorkgroups) {
-    funcPassManager.addPass(createReorderWorkgroups(
-        clReorderWorkgroupsStrategy, clReorderWorkgroupsLogSwizzleTile,
-        canReorderWorkgroups));
-  }
+  addReorderWorkgroupsPass(funcPassManager, options);
   funcPassManager.addPass(createCanonicalizerPass());
   funcPassManager.addPass(createCSEPass());
 
@@ -368,11 +384,7 @@ void addGPUMatmulTensorCorePassPipeline(OpPassManager &funcPassManager,
   funcPassManager.addPass(createCSEPass());
 
   funcPassManager.addPass(createRemoveSingleIterationLoopPass());
-  if (options.enableReorderWorkgroups) {
-    funcPassManager.addPass(createReorderWorkgroups(
-        clReorderWorkgroupsStrategy, clReorderWorkgroupsLogSwizzleTile,
-        canReorderWorkgroups));
-  }
+  addReorderWorkgroupsPass(funcPassManager, options);
   funcPassManager.addPass(createCanonicalizerPass());
   funcPassManager.addPass(createCSEPass());
 
@@ -434,11 +446,7 @@ void addGPUMatmulTensorCoreMmaSyncPassPipeline(
   funcPassManager.addPass(createCSEPass());
 
   funcPassManager.addPass(createRemoveSingleIterationLoopPass());
-  if (options.enableReorderWorkgroups) {
-    funcPassManager.addPass(createReorderWorkgroups(
-        clReorderWorkgroupsStrategy, clReorderWorkgroupsLogSwizzleTile,
-        canReorderWorkgroups));
-  }
+  addReorderWorkgroupsPass(funcPassManager, options);
   funcPassManager.addPass(createCanonicalizerPass());
   funcPassManager.addPass(createCSEPass());
 
@@ -589,13 +597,10 @@ static void addVectorBufferizePasses(OpPassManager &funcPassManager) {
 
 void addGPUVectorDistributePassPipeline(OpPassManager &funcPassManager,
                                         const LLVMGPUPipelineOptions &options,
-                                        bool usePadToModelSharedMemcpy) {
+                                        bool usePadToModelSharedMemcpy,
+                                        unsigned pipelineDepth) {
   tileAndDistributeToWorkgroup(funcPassManager);
-  if (options.enableReorderWorkgroups) {
-    funcPassManager.addPass(createReorderWorkgroups(
-        clReorderWorkgroupsStrategy, clReorderWorkgroupsLogSwizzleTile,
-        canReorderWorkgroups));
-  }
+  addReorderWorkgroupsPass(funcPassManager, options);
   funcPassManager.addPass(createCanonicalizerPass());
   funcPassManager.addPass(createCSEPass());
 
@@ -612,6 +617,17 @@ void addGPUVectorDistributePassPipeline(OpPassManager &funcPassManager,
         tensorTileToSerialLoopsPassOptions));
   }
 
+  // Fused attention iterates over blocks of keys with an online softmax so
+  // that the scores of a query tile never leave the registers.
+  if (options.attentionKeyBlockSize > 0) {
+    funcPassManager.addPass(IREE::LinalgExt::createTileAttentionPass(
+        options.attentionKeyBlockSize));
+    funcPassManager.addPass(IREE::LinalgExt::createDecomposeAttentionPass(
+        options.attentionKeyBlockSize));
+    funcPassManager.addPass(createCanonicalizerPass());
+    funcPassManager.addPass(createCSEPass());
+  }
+
   if (usePadToModelSharedMemcpy) {
     LLVMGPUMatmulPadOption option = LLVMGPUMatmulPadOption::ReductionDims;
     funcPassManager.addPass(createLLVMGPUPromoteMatmulToFitMMAPass(option));
@@ -636,6 +652,12 @@ void addGPUVectorDistributePassPipeline(OpPassManager &funcPassManager,
   // Linalg -> Vector
   addGPUVectorizationPasses(funcPassManager);
 
+  // Chained contractions of fused attention are transposed so that the
+  // accumulator layout of the first can be used as an operand of the second.
+  if (options.attentionKeyBlockSize > 0) {
+    funcPassManager.addPass(createAMDGPUPrepareForChainedMatmulPass());
+  }
+
   // Allocate tensors for copies to shared memory.
   funcPassManager.addPass(createGPUVectorAllocPass());
 
@@ -651,13 +673,30 @@ void addGPUVectorDistributePassPipeline(OpPassManager &funcPassManager,
   funcPassManager.addPass(createCanonicalizerPass());
   funcPassManager.addPass(createCSEPass());
 
+  // With the store to shared memory in the first stage one more buffer than
+  // the pipeline depth is needed.
+  if (pipelineDepth > 0) {
+    funcPassManager.addPass(createGPUMultiBufferingPass(
+        GPUMultiBufferingPassOptions{pipelineDepth + 1}));
+    funcPassManager.addPass(createCanonicalizerPass());
+    funcPassManager.addPass(createCSEPass());
+  }
+
   if (options.enableReduceSharedMemoryBankConflicts) {
     GPUReduceBankConflictsPassOptions options = {};
     options.paddingBits = 64;
     funcPassManager.addPass(createGPUReduceBankConflictsPass(options));
   }
 
-  if (clLLVMGPUEnablePrefetch) {
+  if (pipelineDepth > 0) {
+    // Hoist loop invariant code to avoid pipelining it.
+    funcPassManager.addPass(createLoopInvariantCodeMotionPass());
+    GPUPipeliningPassOptions pipelieningOptions = {};
+    pipelieningOptions.depth = pipelineDepth;
+    pipelieningOptions.scheduleIndex =
+        llvm::to_underlying(PipeliningSchedulingStrategy::loadStoreStage0);
+    funcPassManager.addPass(createGPUPipeliningPass(pipelieningOptions));
+  } else if (clLLVMGPUEnablePrefetch) {
     funcPassManager.addPass(createLLVMGPUPrefetchSharedMemoryPass());
   }
   funcPassManager.addPass(memref::createFoldMemRefAliasOpsPass());
@@ -862,9 +901,10 @@ static void addLowerToLLVMGPUPasses(OpPassManager &modulePassManager,
       .addPass(createCSEPass)
       // Handle complex operation conversion.
       .addPass(createConvertComplexToStandardPass)
-      // Convert BF16 operations to occur as F32.
+      // Convert BF16 and FP8 operations to occur as F32.
       .addPass(createConvertBf16ArithToF32Pass)
       .addPass(createConvertBf16ToUInt16BuffersPass)
+      .addPass(createConvertF8ArithToF32Pass)
       // Convert math dialect elementry functions to polynomial form.
       .addPass(createPolynomialApproximationPass)
       .addPass(memref::createExpandOpsPass)
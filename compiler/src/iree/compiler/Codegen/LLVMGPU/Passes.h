@@ -28,11 +28,21 @@ namespace LLVMGPUAttrNames {
 inline constexpr StringLiteral kNoReorderWorkgroups = "no_reorder_workgroups";
 inline constexpr StringLiteral kNoReduceSharedMemoryBankConflicts =
     "no_reduce_shared_memory_bank_conflicts";
+inline constexpr StringLiteral kReorderWorkgroupsLogSwizzleTile =
+    "reorder_workgroups_log_swizzle_tile";
+inline constexpr StringLiteral kAttentionKeyBlockSize =
+    "attention_key_block_size";
 } //  namespace LLVMGPUAttrNames
 
 struct LLVMGPUPipelineOptions {
   bool enableReduceSharedMemoryBankConflicts = true;
   bool enableReorderWorkgroups = true;
+  // The log2 of the number of workgroup rows to group together when
+  // swizzling workgroup IDs, or 0 to keep the default order.
+  unsigned reorderWorkgroupsLogSwizzleTile = 0;
+  // The number of keys processed per step of fused attention kernels, or 0 if
+  // the dispatch does not contain attention.
+  unsigned attentionKeyBlockSize = 0;
   bool enableUkernels = false;
 };
 
@@ -80,10 +90,13 @@ void addGPUVectorizationPassPipeline(OpPassManager &funcPassManager);
 /// with different tiling and distribution passes.
 void addGPUWinogradVectorizePassPipeline(OpPassManager &funcPassManager);
 
-/// Lowering based on vector distribution patterns.
+/// Lowering based on vector distribution patterns. When |pipelineDepth| is
+/// non-zero the copies to shared memory are multi-buffered and issued
+/// |pipelineDepth| iterations of the reduction loop ahead.
 void addGPUVectorDistributePassPipeline(OpPassManager &funcPassManager,
                                         const LLVMGPUPipelineOptions &options,
-                                        bool usePadToModelSharedMemcpy);
+                                        bool usePadToModelSharedMemcpy,
+                                        unsigned pipelineDepth);
 
 /// Lowering reductions to warp reductions.
 void addGPUWarpReductionPassPipeline(OpPassManager &funcPassManager);
@@ -0,0 +1,74 @@
+// RUN: iree-opt --split-input-file --iree-gpu-test-target=a100 --pass-pipeline="builtin.module(hal.executable(hal.executable.variant(builtin.module(iree-llvmgpu-select-lowering-strategy))))" %s | FileCheck %s
+
+// Large matmuls whose concurrently running workgroups read more than the L2
+// cache in row-major order get their workgroups swizzled.
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+hal.executable @large_matmul {
+  hal.executable.variant @cuda target(<"cuda", "cuda-nvptx-fb">) {
+    hal.executable.export @large_matmul layout(#pipeline_layout)
+    builtin.module {
+      func.func @large_matmul() {
+        %cst = arith.constant 0.000000e+00 : f16
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<4096x8192xf16>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<8192x4096xf16>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<4096x4096xf16>>
+        %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [4096, 8192], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<4096x8192xf16>> -> tensor<4096x8192xf16>
+        %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [8192, 4096], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<8192x4096xf16>> -> tensor<8192x4096xf16>
+        %5 = tensor.empty() : tensor<4096x4096xf16>
+        %6 = linalg.fill ins(%cst : f16) outs(%5 : tensor<4096x4096xf16>) -> tensor<4096x4096xf16>
+        %7 = linalg.matmul ins(%3, %4 : tensor<4096x8192xf16>, tensor<8192x4096xf16>) outs(%6 : tensor<4096x4096xf16>) -> tensor<4096x4096xf16>
+        flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [4096, 4096], strides = [1, 1] : tensor<4096x4096xf16> -> !flow.dispatch.tensor<writeonly:tensor<4096x4096xf16>>
+        return
+      }
+    }
+  }
+}
+
+// CHECK:       #[[$TRANSLATION:.+]] = #iree_codegen.translation_info
+// CHECK-SAME:    reorder_workgroups_log_swizzle_tile = {{[1-9]}}
+// CHECK-LABEL: func.func @large_matmul()
+// CHECK-SAME:    translation_info = #[[$TRANSLATION]]
+
+// -----
+
+// The operands read by the workgroups of small matmuls fit in the L2 cache.
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>,
+    #hal.descriptor_set.binding<2, storage_buffer>
+  ]>
+]>
+hal.executable @small_matmul {
+  hal.executable.variant @cuda target(<"cuda", "cuda-nvptx-fb">) {
+    hal.executable.export @small_matmul layout(#pipeline_layout)
+    builtin.module {
+      func.func @small_matmul() {
+        %cst = arith.constant 0.000000e+00 : f16
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<1024x1024xf16>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<1024x1024xf16>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<1024x1024xf16>>
+        %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [1024, 1024], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<1024x1024xf16>> -> tensor<1024x1024xf16>
+        %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [1024, 1024], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<1024x1024xf16>> -> tensor<1024x1024xf16>
+        %5 = tensor.empty() : tensor<1024x1024xf16>
+        %6 = linalg.fill ins(%cst : f16) outs(%5 : tensor<1024x1024xf16>) -> tensor<1024x1024xf16>
+        %7 = linalg.matmul ins(%3, %4 : tensor<1024x1024xf16>, tensor<1024x1024xf16>) outs(%6 : tensor<1024x1024xf16>) -> tensor<1024x1024xf16>
+        flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [1024, 1024], strides = [1, 1] : tensor<1024x1024xf16> -> !flow.dispatch.tensor<writeonly:tensor<1024x1024xf16>>
+        return
+      }
+    }
+  }
+}
+
+// CHECK-NOT:   reorder_workgroups_log_swizzle_tile
+// CHECK-LABEL: func.func @small_matmul()
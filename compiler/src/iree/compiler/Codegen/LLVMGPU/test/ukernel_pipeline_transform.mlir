@@ -178,3 +178,31 @@ module {
 //      CHECK: func.func @not_neg_inf_init_argmax_1d()
 // CHECK-SAME:    translation_info = #[[$TRANSLATION]]
 //  CHECK-NOT:   iree_codegen.ukernel.generic
+
+// -----
+
+#executable_target_rocm_hsaco_fb = #hal.executable.target<"rocm", "rocm-hsaco-fb", {ukernels = "topk"}>
+module {
+  func.func @topk_2d_f32i32() attributes {hal.executable.target = #executable_target_rocm_hsaco_fb} {
+    %c0 = arith.constant 0 : index
+    %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<16x32000xf32>>
+    %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readwrite:tensor<16x8xf32>>
+    %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readwrite:tensor<16x8xi32>>
+    %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [16, 32000], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<16x32000xf32>> -> tensor<16x32000xf32>
+    %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [16, 8], strides = [1, 1] : !flow.dispatch.tensor<readwrite:tensor<16x8xf32>> -> tensor<16x8xf32>
+    %5 = flow.dispatch.tensor.load %2, offsets = [0, 0], sizes = [16, 8], strides = [1, 1] : !flow.dispatch.tensor<readwrite:tensor<16x8xi32>> -> tensor<16x8xi32>
+    %6:2 = iree_linalg_ext.topk dimension(1) ins(%3 : tensor<16x32000xf32>) outs(%4, %5 : tensor<16x8xf32>, tensor<16x8xi32>) {
+    ^bb0(%lhs: f32, %rhs: f32):
+      %7 = arith.cmpf ogt, %lhs, %rhs : f32
+      iree_linalg_ext.yield %7 : i1
+    } -> tensor<16x8xf32>, tensor<16x8xi32>
+    flow.dispatch.tensor.store %6#0, %1, offsets = [0, 0], sizes = [16, 8], strides = [1, 1] : tensor<16x8xf32> -> !flow.dispatch.tensor<readwrite:tensor<16x8xf32>>
+    flow.dispatch.tensor.store %6#1, %2, offsets = [0, 0], sizes = [16, 8], strides = [1, 1] : tensor<16x8xi32> -> !flow.dispatch.tensor<readwrite:tensor<16x8xi32>>
+    return
+  }
+}
+
+//      CHECK: #[[$TRANSLATION:.+]] = #iree_codegen.translation_info<LLVMGPUDefault workgroup_size = [32, 1, 1]>
+//      CHECK: func.func @topk_2d_f32i32()
+// CHECK-SAME:     translation_info = #[[$TRANSLATION]]
+//      CHECK:   iree_codegen.ukernel.generic  "__iree_uk_rocm_topk_F32I32"
@@ -11,16 +11,202 @@
 //===----------------------------------------------------------------------===//
 
 #include <array>
+#include <optional>
 
+#include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenAttrs.h"
 #include "iree/compiler/Codegen/SPIRV/KernelConfig.h"
+#include "iree/compiler/Codegen/SPIRV/Utils.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/CommandLine.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/SPIRV/IR/SPIRVAttributes.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Matchers.h"
 
 namespace mlir::iree_compiler::detail {
 
+static llvm::cl::opt<bool> clSPIRVAppleSimdgroupMatmul(
+    "iree-spirv-apple-simdgroup-matmul",
+    llvm::cl::desc("Use the simdgroup_matrix MSL kernel for eligible matmuls "
+                   "when targeting Metal on Apple GPUs"),
+    llvm::cl::init(true));
+
+using CodeGenPipeline = IREE::Codegen::DispatchLoweringPassPipeline;
+
+//===----------------------------------------------------------------------===//
+// Simdgroup Matrix Matmul
+//===----------------------------------------------------------------------===//
+
+// Threadgroup (M, N) tile sizes supported by the simdgroup matmul kernel in
+// order of preference. The kernel runs 2x2 simdgroups with each one computing
+// a quarter of the tile using 8x8 simdgroup matrices.
+static const std::array<std::array<int64_t, 2>, 7> kSimdgroupMatmulTiles = {{
+    {64, 64},
+    {32, 64},
+    {64, 32},
+    {32, 32},
+    {16, 32},
+    {32, 16},
+    {16, 16},
+}};
+
+/// Returns the [set, binding, byte offset] of the interface binding `value`
+/// is a subspan of. Returns std::nullopt if the byte offset is not constant.
+static std::optional<SmallVector<int64_t>> getSubspanBinding(Value value) {
+  auto subspanOp = value.getDefiningOp<IREE::HAL::InterfaceBindingSubspanOp>();
+  if (!subspanOp)
+    return std::nullopt;
+  int64_t byteOffset = 0;
+  if (Value offset = subspanOp.getByteOffset()) {
+    std::optional<int64_t> constOffset = getConstantIntValue(offset);
+    if (!constOffset)
+      return std::nullopt;
+    byteOffset = *constOffset;
+  }
+  return SmallVector<int64_t>{
+      static_cast<int64_t>(subspanOp.getSet().getZExtValue()),
+      static_cast<int64_t>(subspanOp.getBinding().getZExtValue()), byteOffset};
+}
+
+/// Returns the interface binding `value` is loaded from if it is a load of the
+/// whole binding.
+static std::optional<SmallVector<int64_t>> getWholeLoadBinding(Value value) {
+  auto loadOp = value.getDefiningOp<IREE::Flow::DispatchTensorLoadOp>();
+  if (!loadOp || !loadOp.isLoadOfWholeSource() ||
+      loadOp.getType() != loadOp.getSourceType().asRankedTensorType()) {
+    return std::nullopt;
+  }
+  return getSubspanBinding(loadOp.getSource());
+}
+
+/// Sets the configuration for lowering the dispatch of `op` to the
+/// simdgroup_matrix MSL matmul kernel if it just computes a whole row-major
+/// f16/f32 (batch) matmul.
+///
+/// The SPIR-V kernel is still generated as normal but the Metal target
+/// replaces it with the MSL kernel described by the attribute recorded on the
+/// export op. Workgroup tile sizes therefore need to match the threadgroup
+/// tile of the MSL kernel so that both use the same workgroup count.
+static LogicalResult setAppleSimdgroupMatmulConfig(linalg::LinalgOp op) {
+  if (!isa<linalg::MatmulOp, linalg::BatchMatmulOp>(op))
+    return failure();
+  auto funcOp = op->getParentOfType<mlir::FunctionOpInterface>();
+  std::optional<IREE::HAL::ExecutableExportOp> exportOp =
+      getEntryPoint(funcOp);
+  if (!exportOp)
+    return failure();
+
+  // The kernel does not support fusion so the matmul (and the fill
+  // initializing its result) must be the only compute ops in the dispatch.
+  SmallVector<Operation *> computeOps = getComputeOps(funcOp);
+  if (computeOps.back() != op.getOperation() || computeOps.size() > 2)
+    return failure();
+
+  Type elementType = getElementTypeOrSelf(op->getResult(0).getType());
+  if (!elementType.isF16() && !elementType.isF32())
+    return failure();
+  for (Value input : op.getDpsInputs()) {
+    if (getElementTypeOrSelf(input.getType()) != elementType)
+      return failure();
+  }
+
+  SmallVector<int64_t> loopRanges = op.getStaticLoopRanges();
+  if (llvm::any_of(loopRanges, ShapedType::isDynamic))
+    return failure();
+  const bool isBatch = loopRanges.size() == 4;
+  const int64_t dimB = isBatch ? loopRanges[0] : 1;
+  const int64_t dimM = loopRanges[loopRanges.size() - 3];
+  const int64_t dimN = loopRanges[loopRanges.size() - 2];
+  const int64_t dimK = loopRanges.back();
+  if (dimK % 8 != 0)
+    return failure();
+
+  std::optional<SmallVector<int64_t>> lhsBinding =
+      getWholeLoadBinding(op.getDpsInputs()[0]);
+  std::optional<SmallVector<int64_t>> rhsBinding =
+      getWholeLoadBinding(op.getDpsInputs()[1]);
+  if (!lhsBinding || !rhsBinding)
+    return failure();
+
+  // The result must be stored as a whole to a binding.
+  Value result = op->getResult(0);
+  if (!result.hasOneUse())
+    return failure();
+  auto storeOp =
+      dyn_cast<IREE::Flow::DispatchTensorStoreOp>(*result.getUsers().begin());
+  if (!storeOp || storeOp.getValue() != result ||
+      !storeOp.isStoreToWholeTarget() ||
+      result.getType() != storeOp.getTargetType().asRankedTensorType()) {
+    return failure();
+  }
+  std::optional<SmallVector<int64_t>> resultBinding =
+      getSubspanBinding(storeOp.getTarget());
+  if (!resultBinding)
+    return failure();
+
+  // The result is either zero initialized or accumulated into in place.
+  bool accumulate = false;
+  Value init = op.getDpsInits()[0];
+  if (auto fillOp = init.getDefiningOp<linalg::FillOp>()) {
+    if (!matchPattern(fillOp.getDpsInputOperand(0)->get(), m_AnyZeroFloat()))
+      return failure();
+  } else {
+    if (computeOps.size() != 1 || getWholeLoadBinding(init) != resultBinding)
+      return failure();
+    accumulate = true;
+  }
+
+  const std::array<int64_t, 2> *tile =
+      llvm::find_if(kSimdgroupMatmulTiles, [&](ArrayRef<int64_t> tile) {
+        return dimM % tile[0] == 0 && dimN % tile[1] == 0;
+      });
+  if (tile == kSimdgroupMatmulTiles.end())
+    return failure();
+  const int64_t tileM = (*tile)[0], tileN = (*tile)[1];
+
+  Builder b(op->getContext());
+  SmallVector<NamedAttribute> descriptor = {
+      b.getNamedAttr("accumulate", b.getBoolAttr(accumulate)),
+      b.getNamedAttr("element_type", TypeAttr::get(elementType)),
+      b.getNamedAttr("lhs", b.getDenseI64ArrayAttr(*lhsBinding)),
+      b.getNamedAttr("result", b.getDenseI64ArrayAttr(*resultBinding)),
+      b.getNamedAttr("rhs", b.getDenseI64ArrayAttr(*rhsBinding)),
+      b.getNamedAttr("shape",
+                     b.getDenseI64ArrayAttr({dimB, dimM, dimN, dimK})),
+      b.getNamedAttr("tile", b.getDenseI64ArrayAttr({tileM, tileN})),
+  };
+  exportOp.value()->setAttr(getMetalSimdgroupMatmulAttrName(),
+                            b.getDictionaryAttr(descriptor));
+
+  // Use a plain vectorized configuration with the same workgroup tile for the
+  // SPIR-V kernel, with each thread computing a 4x4 tile of the result.
+  const int64_t threadTile = 4;
+  SmallVector<int64_t> workgroupTileSizes = {tileM, tileN};
+  SmallVector<int64_t> threadTileSizes = {threadTile, threadTile};
+  SmallVector<int64_t> reductionTileSizes = {0, 0, threadTile};
+  if (isBatch) {
+    workgroupTileSizes.insert(workgroupTileSizes.begin(), 1);
+    threadTileSizes.insert(threadTileSizes.begin(), 1);
+    reductionTileSizes.insert(reductionTileSizes.begin(), 0);
+  }
+  TileSizesListType tileSizes = {workgroupTileSizes, threadTileSizes,
+                                 reductionTileSizes};
+  std::array<int64_t, 3> workgroupSize = {tileN / threadTile,
+                                          tileM / threadTile, 1};
+  return setOpConfigAndEntryPointFnTranslation(
+      funcOp, op, tileSizes, CodeGenPipeline::SPIRVBaseVectorize,
+      workgroupSize);
+}
+
+//===----------------------------------------------------------------------===//
+// Matmul
+//===----------------------------------------------------------------------===//
+
 static LogicalResult setAppleMatmulConfig(linalg::LinalgOp op,
                                           spirv::ResourceLimitsAttr limits) {
   const std::array<int64_t, 2> workgroupXY = {256, 1};
@@ -45,8 +231,15 @@ LogicalResult setAppleCodeGenConfig(const spirv::TargetEnv &targetEnv,
   int subgroupSize = limits.getSubgroupSize();
 
   if (auto linalgOp = dyn_cast<linalg::LinalgOp>(rootOp)) {
-    if (isMatmulOrBatchMatmul(linalgOp))
+    if (isMatmulOrBatchMatmul(linalgOp)) {
+      // SPIR-V has no way to express simdgroup matrices so only the Metal
+      // target can use the MSL kernel.
+      if (clSPIRVAppleSimdgroupMatmul &&
+          targetEnv.getAttr().getClientAPI() == spirv::ClientAPI::Metal &&
+          succeeded(setAppleSimdgroupMatmulConfig(linalgOp)))
+        return success();
       return setAppleMatmulConfig(linalgOp, limits);
+    }
   }
 
   if (auto convOp = dyn_cast<linalg::ConvolutionOpInterface>(rootOp)) {
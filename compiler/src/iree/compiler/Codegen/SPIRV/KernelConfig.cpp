@@ -467,12 +467,17 @@ static bool tileMatmulK(const int64_t dimK, const int64_t residualTilingFactor,
 }
 
 int64_t getTileBytes(int64_t mTileSize, int64_t nTileSize, int64_t kTileSize,
-                     int64_t elementBits, bool promoteC) {
+                     int64_t elementBits, bool promoteC, int64_t resultBits) {
   int64_t paddingBits = detail::bankConflictReductionPaddingBits / elementBits;
   int64_t count = (mTileSize + nTileSize) * (kTileSize + paddingBits);
-  if (promoteC)
-    count += mTileSize * (nTileSize + paddingBits);
-  return (elementBits / 8) * count;
+  int64_t bytes = (elementBits / 8) * count;
+  if (promoteC) {
+    // The result can be wider than the inputs, e.g., i8 x i8 -> i32.
+    int64_t resultPaddingBits =
+        detail::bankConflictReductionPaddingBits / resultBits;
+    bytes += (resultBits / 8) * mTileSize * (nTileSize + resultPaddingBits);
+  }
+  return bytes;
 }
 
 int64_t getMultiBufferMemoryUsage(int64_t singleBufferBytes, unsigned depth,
@@ -562,8 +567,8 @@ static bool adjustToPromote(ArrayRef<int64_t> dimMNKSize, int64_t &mTileSize,
     storeStage = 1;
   }
 
-  auto usedBytes =
-      getTileBytes(mTileSize, nTileSize, kTileSize, elementBits, false);
+  auto usedBytes = getTileBytes(mTileSize, nTileSize, kTileSize, elementBits,
+                                /*promoteC=*/false, /*resultBits=*/0);
 
   LLVM_DEBUG(llvm::dbgs() << "initial multibuffering bytes = "
                           << getMultiBufferMemoryUsage(usedBytes, pipelineDepth,
@@ -598,7 +603,8 @@ static bool adjustToPromote(ArrayRef<int64_t> dimMNKSize, int64_t &mTileSize,
 
   int64_t totalThreads = wgSize[0] * wgSize[1] * wgSize[2];
   LLVM_DEBUG(llvm::dbgs() << "revised total thread = " << totalThreads << "\n");
-  usedBytes = getTileBytes(mTileSize, nTileSize, kTileSize, elementBits, false);
+  usedBytes = getTileBytes(mTileSize, nTileSize, kTileSize, elementBits,
+                           /*promoteC=*/false, /*resultBits=*/0);
   LLVM_DEBUG(llvm::dbgs() << "revised tile bytes = " << usedBytes << "\n");
   return totalThreads > subgroupSize && usedBytes <= maxBytes;
 }
@@ -976,7 +982,8 @@ LogicalResult setCooperativeMatrixConfig(
   auto usedBytes =
       getTileBytes(workgroupTileSizes[mIndex], workgroupTileSizes[nIndex],
                    reductionTileSizes[kIndex],
-                   IREE::Util::getTypeBitWidth(getElementType(lhs)), promoteC);
+                   IREE::Util::getTypeBitWidth(getElementType(lhs)), promoteC,
+                   IREE::Util::getTypeBitWidth(initElem));
 
   while (pipelineDepth > 0 &&
          getMultiBufferMemoryUsage(usedBytes, pipelineDepth, storeStage) >
@@ -1054,14 +1061,29 @@ static LogicalResult setWinogradOpConfig(spirv::ResourceLimitsAttr limits,
 // Reduction Default Configuration
 //===----------------------------------------------------------------------===//
 
+/// Returns true if the reduction |combinerOp| maps to a SPIR-V subgroup
+/// arithmetic op. NaN-propagating float min/max reductions do not.
+static bool hasSubgroupArithmeticOp(Operation *combinerOp) {
+  return isa<arith::AddFOp, arith::AddIOp, arith::AndIOp, arith::MaxNumFOp,
+             arith::MaxSIOp, arith::MaxUIOp, arith::MinNumFOp, arith::MinSIOp,
+             arith::MinUIOp, arith::MulFOp, arith::MulIOp, arith::OrIOp,
+             arith::XOrIOp>(combinerOp);
+}
+
 /// Set the configuration for reductions that can be mapped to warp reductions.
 static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
                                         linalg::LinalgOp op) {
   LLVM_DEBUG(llvm::dbgs() << "trying to deduce config as reduction...\n");
 
-  // This pipeline eventually generates non-uniform group shuffle ops, which
-  // requires special capability.
-  if (!targetEnv.allows(spirv::Capability::GroupNonUniformShuffle))
+  // This pipeline eventually generates non-uniform group shuffle or
+  // arithmetic ops, which require special capabilities. Targets without
+  // shuffles and with subgroup arithmetic (e.g., some Mali GPUs) can still
+  // handle reductions with a matching subgroup arithmetic op.
+  const bool hasShuffle =
+      targetEnv.allows(spirv::Capability::GroupNonUniformShuffle);
+  const bool hasArithmetic =
+      targetEnv.allows(spirv::Capability::GroupNonUniformArithmetic);
+  if (!hasShuffle && !hasArithmetic)
     return failure();
 
   SmallVector<unsigned> parallelDims;
@@ -1112,6 +1134,8 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
         combinerOps.size() == 1) {
       if (foundSingleReductionOutput)
         return failure();
+      if (!hasShuffle && !hasSubgroupArithmeticOp(combinerOps[0]))
+        return failure();
       foundSingleReductionOutput = true;
       continue;
     }
@@ -32,9 +32,10 @@ constexpr unsigned defaultCoopMatrixSoftwarePipelineDepth = 1;
 constexpr unsigned defaultCoopMatrixSoftwarePipelineStoreStage = 0;
 
 /// Computes the total number of bytes if promoting both matmul LHS and RHS with
-/// the tiven tile sizes.
+/// the tiven tile sizes. If `promoteC` is true, also accounts for promoting the
+/// matmul result with elements of `resultBits`.
 int64_t getTileBytes(int64_t mTileSize, int64_t nTileSize, int64_t kTileSize,
-                     int64_t elementBits, bool promoteC);
+                     int64_t elementBits, bool promoteC, int64_t resultBits);
 
 /// Adjusts the shared memory usage based on the pipelining depth.
 int64_t getMultiBufferMemoryUsage(int64_t usedBytes, unsigned depth,
@@ -12,6 +12,7 @@
 
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/IREECodegenAttrs.h"
 #include "iree/compiler/Codegen/SPIRV/KernelConfig.h"
+#include "iree/compiler/Codegen/SPIRV/Utils.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "llvm/ADT/APInt.h"
@@ -45,7 +46,13 @@ static LogicalResult setNVIDIAMatmulConfig(linalg::LinalgOp op,
   std::array<int64_t, 3> threadMNK;
   auto inputType =
       llvm::cast<ShapedType>(op.getDpsInputOperand(0)->get().getType());
-  if (IREE::Util::getTypeBitWidth(inputType.getElementType()) == 16) {
+  const int64_t inputBits =
+      IREE::Util::getTypeBitWidth(inputType.getElementType());
+  // 8-bit matmuls without cooperative matrix support are reduced with integer
+  // dot product ops, which consume 4 K elements at a time and need fewer
+  // registers for the operands than f32 FMAs.
+  if (inputBits == 16 ||
+      (inputBits == 8 && supportsIntegerDotProductOps(targetEnv))) {
     threadMNK = {8, 8, 32};
   } else {
     threadMNK = {4, 4, 32};
@@ -43,8 +43,11 @@ void addSPIRVMatmulPromoteVectorizePassPipeline(OpPassManager &funcPassManager,
                                                 unsigned storeStage);
 
 /// Pass pipeline to lower IREE HAL executables by tiling and distributing
-/// reduction to workgroups and then subgroups.
-void addSPIRVSubgroupReducePassPipeline(OpPassManager &funcPassManager);
+/// reduction to workgroups and then subgroups. When |useSubgroupArithmetic| is
+/// set, reductions use subgroup arithmetic ops instead of being expanded into
+/// subgroup shuffles where possible.
+void addSPIRVSubgroupReducePassPipeline(OpPassManager &funcPassManager,
+                                        bool useSubgroupArithmetic);
 
 /// Pass pipeline to lower winograd ops. This pipeline follows the
 /// SPIRVBaseVectorize pipeline with the following exception:
@@ -259,7 +259,7 @@ void populateVectorUnrollPatterns(RewritePatternSet &patterns,
 }
 
 /// Returns true when the target environment support integer dot product ops.
-bool supportsIntegerDotProductOps(mlir::FunctionOpInterface fn) {
+bool targetSupportsIntegerDotProductOps(mlir::FunctionOpInterface fn) {
   spirv::TargetEnvAttr targetEnvAttr = getSPIRVTargetEnvAttr(fn);
   if (!targetEnvAttr) {
     // Alternatively, check if the function op itself has a target env
@@ -270,20 +270,7 @@ bool supportsIntegerDotProductOps(mlir::FunctionOpInterface fn) {
       return false;
   }
 
-  spirv::TargetEnv targetEnv(targetEnvAttr);
-  if (!targetEnv.allows(spirv::Extension::SPV_KHR_integer_dot_product))
-    return false;
-
-  // Query all the dot prod capabilities except for the packed one -- none of
-  // the vectorization patterns need it.
-  if (!targetEnv.allows(spirv::Capability::DotProduct))
-    return false;
-  if (!targetEnv.allows(spirv::Capability::DotProductInput4x8Bit))
-    return false;
-  if (!targetEnv.allows(spirv::Capability::DotProductInputAll))
-    return false;
-
-  return true;
+  return supportsIntegerDotProductOps(spirv::TargetEnv(targetEnvAttr));
 }
 
 class SPIRVInitialLoweringPass
@@ -299,7 +286,7 @@ public:
     MLIRContext *context = &getContext();
     auto funcOp = getOperation();
 
-    bool emitIntegerDotProdOps = supportsIntegerDotProductOps(funcOp);
+    bool emitIntegerDotProdOps = targetSupportsIntegerDotProductOps(funcOp);
 
     // First apply vectorization to generate vectors of the original tensor
     // shape for tensor.pad ops.
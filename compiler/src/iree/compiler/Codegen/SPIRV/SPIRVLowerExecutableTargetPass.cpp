@@ -10,6 +10,7 @@
 #include "iree/compiler/Codegen/SPIRV/KernelConfig.h"
 #include "iree/compiler/Codegen/SPIRV/PassDetail.h"
 #include "iree/compiler/Codegen/SPIRV/Passes.h"
+#include "iree/compiler/Codegen/SPIRV/Utils.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
@@ -87,9 +88,14 @@ void SPIRVLowerExecutableTargetPass::runOnOperation() {
   case CodeGenPipeline::SPIRVBaseVectorize:
     addSPIRVBaseVectorizePassPipeline(pipeline);
     break;
-  case CodeGenPipeline::SPIRVSubgroupReduce:
-    addSPIRVSubgroupReducePassPipeline(pipeline);
+  case CodeGenPipeline::SPIRVSubgroupReduce: {
+    spirv::TargetEnvAttr targetEnv = getSPIRVTargetEnvAttr(funcOp);
+    bool useSubgroupArithmetic =
+        targetEnv && spirv::TargetEnv(targetEnv).allows(
+                         spirv::Capability::GroupNonUniformArithmetic);
+    addSPIRVSubgroupReducePassPipeline(pipeline, useSubgroupArithmetic);
     break;
+  }
   case CodeGenPipeline::SPIRVCooperativeMatrixVectorize: {
     FailureOr<int64_t> maybeDepth =
         getSoftwarePipelineDepth(translationInfo.getConfiguration());
@@ -34,6 +34,10 @@ bool usesSPIRVCodeGen(IREE::HAL::ExecutableVariantOp variantOp) {
 
 const char *getSPIRVDistributeAttrName() { return "iree.spirv.distribute_dim"; }
 
+const char *getMetalSimdgroupMatmulAttrName() {
+  return "iree.metal.simdgroup_matmul";
+}
+
 DictionaryAttr getTargetConfigAttr(Operation *op) {
   auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
   if (!targetAttr)
@@ -48,6 +52,17 @@ spirv::TargetEnvAttr getSPIRVTargetEnvAttr(Operation *op) {
   return config.getAs<spirv::TargetEnvAttr>(spirv::getTargetEnvAttrName());
 }
 
+bool supportsIntegerDotProductOps(const spirv::TargetEnv &targetEnv) {
+  if (!targetEnv.allows(spirv::Extension::SPV_KHR_integer_dot_product))
+    return false;
+
+  // Query all the dot prod capabilities except for the packed one -- none of
+  // the vectorization patterns need it.
+  return targetEnv.allows(spirv::Capability::DotProduct) &&
+         targetEnv.allows(spirv::Capability::DotProductInput4x8Bit) &&
+         targetEnv.allows(spirv::Capability::DotProductInputAll);
+}
+
 UnitAttr getIndirectBindingsAttr(Operation *op) {
   DictionaryAttr config = getTargetConfigAttr(op);
   if (!config)
@@ -18,6 +18,7 @@
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/Dialect/SCF/Transforms/TileUsingInterface.h"
 #include "mlir/Dialect/SPIRV/IR/SPIRVAttributes.h"
+#include "mlir/Dialect/SPIRV/IR/TargetAndABI.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinAttributes.h"
 
@@ -29,12 +30,20 @@ bool usesSPIRVCodeGen(IREE::HAL::ExecutableVariantOp variantOp);
 /// Returns the attribute name carrying information about distribution.
 const char *getSPIRVDistributeAttrName();
 
+/// Returns the attribute name on hal.executable.export ops carrying the
+/// descriptor of the simdgroup_matrix MSL matmul kernel to use for the export.
+const char *getMetalSimdgroupMatmulAttrName();
+
 /// Given an operation, returns the HAL target config attribute.
 DictionaryAttr getTargetConfigAttr(Operation *op);
 
 /// Given an operation, returns the `spirv.target_env` attribute.
 spirv::TargetEnvAttr getSPIRVTargetEnvAttr(Operation *op);
 
+/// Returns true if the given target environment supports the integer dot
+/// product ops used when lowering 8-bit contractions.
+bool supportsIntegerDotProductOps(const spirv::TargetEnv &targetEnv);
+
 /// Given an operation, returns the `hal.bindings.indirect` attribute.
 UnitAttr getIndirectBindingsAttr(Operation *op);
 
@@ -168,3 +168,32 @@ module {
 //      CHECK:   linalg.generic
 //      CHECK:   linalg.generic
 // CHECK-SAME:     lowering_config = #[[CONFIG]]
+
+// -----
+
+// Quantized matmul without cooperative matrix support, lowered with integer
+// dot product ops.
+
+#executable_target_vulkan_spirv_fb = #hal.executable.target<"vulkan-spirv", "vulkan-spirv-fb", {spirv.target_env = #spirv.target_env<#spirv.vce<v1.6, [Shader, Int8, StorageBuffer8BitAccess, DotProduct, DotProductInputAll, DotProductInput4x8Bit], [SPV_KHR_integer_dot_product]>, AMD:DiscreteGPU, #spirv.resource_limits<max_compute_shared_memory_size = 65536, max_compute_workgroup_invocations = 1024, max_compute_workgroup_size = [1024, 1024, 1024], subgroup_size = 64>>}>
+module {
+  func.func @matmul_i8_1024x1024x1024() attributes {hal.executable.target = #executable_target_vulkan_spirv_fb} {
+    %c0 = arith.constant 0 : index
+    %c0_i32 = arith.constant 0 : i32
+    %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<1024x1024xi8>>
+    %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<1024x1024xi8>>
+    %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<1024x1024xi32>>
+    %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [1024, 1024], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<1024x1024xi8>> -> tensor<1024x1024xi8>
+    %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [1024, 1024], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<1024x1024xi8>> -> tensor<1024x1024xi8>
+    %5 = tensor.empty() : tensor<1024x1024xi32>
+    %6 = linalg.fill ins(%c0_i32 : i32) outs(%5 : tensor<1024x1024xi32>) -> tensor<1024x1024xi32>
+    %7 = linalg.matmul ins(%3, %4 : tensor<1024x1024xi8>, tensor<1024x1024xi8>) outs(%6 : tensor<1024x1024xi32>) -> tensor<1024x1024xi32>
+    flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [1024, 1024], strides = [1, 1] : tensor<1024x1024xi32> -> !flow.dispatch.tensor<writeonly:tensor<1024x1024xi32>>
+    return
+  }
+}
+
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<SPIRVMatmulPromoteVectorize
+//      CHECK: func.func @matmul_i8_1024x1024x1024()
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//      CHECK:   linalg.matmul
+// CHECK-SAME:     lowering_config
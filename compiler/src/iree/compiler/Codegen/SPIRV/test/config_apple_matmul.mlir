@@ -0,0 +1,113 @@
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(hal.executable(hal.executable.variant(builtin.module(iree-spirv-select-lowering-strategy-pass))))' %s | FileCheck %s
+
+// Whole matmuls targeting Metal use the simdgroup_matrix MSL kernel.
+
+#executable_target_metal_msl_fb = #hal.executable.target<"metal-spirv", "metal-msl-fb", {spirv.target_env = #spirv.target_env<#spirv.vce<v1.3, [Shader, Float16], []>, api=Metal, Apple:IntegratedGPU, #spirv.resource_limits<max_compute_shared_memory_size = 32768, max_compute_workgroup_invocations = 1024, max_compute_workgroup_size = [1024, 1024, 1024], subgroup_size = 32>>}>
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [<0, bindings = [<0, storage_buffer, ReadOnly>, <1, storage_buffer, ReadOnly>, <2, storage_buffer>]>]>
+hal.executable @matmul_1024x2048x512 {
+  hal.executable.variant public @metal_msl_fb target(#executable_target_metal_msl_fb) {
+    hal.executable.export public @matmul_1024x2048x512 ordinal(0) layout(#pipeline_layout)
+    builtin.module {
+      func.func @matmul_1024x2048x512() {
+        %c0 = arith.constant 0 : index
+        %c64 = arith.constant 64 : index
+        %cst = arith.constant 0.000000e+00 : f32
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<1024x512xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c64) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<512x2048xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<1024x2048xf32>>
+        %3 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [1024, 512], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<1024x512xf32>> -> tensor<1024x512xf32>
+        %4 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [512, 2048], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<512x2048xf32>> -> tensor<512x2048xf32>
+        %5 = tensor.empty() : tensor<1024x2048xf32>
+        %6 = linalg.fill ins(%cst : f32) outs(%5 : tensor<1024x2048xf32>) -> tensor<1024x2048xf32>
+        %7 = linalg.matmul ins(%3, %4 : tensor<1024x512xf32>, tensor<512x2048xf32>) outs(%6 : tensor<1024x2048xf32>) -> tensor<1024x2048xf32>
+        flow.dispatch.tensor.store %7, %2, offsets = [0, 0], sizes = [1024, 2048], strides = [1, 1] : tensor<1024x2048xf32> -> !flow.dispatch.tensor<writeonly:tensor<1024x2048xf32>>
+        return
+      }
+    }
+  }
+}
+
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[64, 64], [4, 4], [0, 0, 4]{{\]}}>
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<SPIRVBaseVectorize workgroup_size = [16, 16, 1]>
+//      CHECK: hal.executable.export public @matmul_1024x2048x512
+// CHECK-SAME:   iree.metal.simdgroup_matmul = {accumulate = false, element_type = f32, lhs = array<i64: 0, 0, 0>, result = array<i64: 0, 2, 0>, rhs = array<i64: 0, 1, 64>, shape = array<i64: 1, 1024, 2048, 512>, tile = array<i64: 64, 64>}
+//      CHECK: func.func @matmul_1024x2048x512()
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//      CHECK:   linalg.matmul
+// CHECK-SAME:       lowering_config = #[[CONFIG]]
+
+// -----
+
+// Batch matmuls accumulating into the result in place.
+
+#executable_target_metal_msl_fb = #hal.executable.target<"metal-spirv", "metal-msl-fb", {spirv.target_env = #spirv.target_env<#spirv.vce<v1.3, [Shader, Float16], []>, api=Metal, Apple:IntegratedGPU, #spirv.resource_limits<max_compute_shared_memory_size = 32768, max_compute_workgroup_invocations = 1024, max_compute_workgroup_size = [1024, 1024, 1024], subgroup_size = 32>>}>
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [<0, bindings = [<0, storage_buffer, ReadOnly>, <1, storage_buffer, ReadOnly>, <2, storage_buffer>]>]>
+hal.executable @batch_matmul_4x128x96x64 {
+  hal.executable.variant public @metal_msl_fb target(#executable_target_metal_msl_fb) {
+    hal.executable.export public @batch_matmul_4x128x96x64 ordinal(0) layout(#pipeline_layout)
+    builtin.module {
+      func.func @batch_matmul_4x128x96x64() {
+        %c0 = arith.constant 0 : index
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<4x128x64xf16>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<4x64x96xf16>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readwrite:tensor<4x128x96xf16>>
+        %3 = flow.dispatch.tensor.load %0, offsets = [0, 0, 0], sizes = [4, 128, 64], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<4x128x64xf16>> -> tensor<4x128x64xf16>
+        %4 = flow.dispatch.tensor.load %1, offsets = [0, 0, 0], sizes = [4, 64, 96], strides = [1, 1, 1] : !flow.dispatch.tensor<readonly:tensor<4x64x96xf16>> -> tensor<4x64x96xf16>
+        %5 = flow.dispatch.tensor.load %2, offsets = [0, 0, 0], sizes = [4, 128, 96], strides = [1, 1, 1] : !flow.dispatch.tensor<readwrite:tensor<4x128x96xf16>> -> tensor<4x128x96xf16>
+        %6 = linalg.batch_matmul ins(%3, %4 : tensor<4x128x64xf16>, tensor<4x64x96xf16>) outs(%5 : tensor<4x128x96xf16>) -> tensor<4x128x96xf16>
+        flow.dispatch.tensor.store %6, %2, offsets = [0, 0, 0], sizes = [4, 128, 96], strides = [1, 1, 1] : tensor<4x128x96xf16> -> !flow.dispatch.tensor<readwrite:tensor<4x128x96xf16>>
+        return
+      }
+    }
+  }
+}
+
+//  CHECK-DAG: #[[CONFIG:.+]] = #iree_codegen.lowering_config<tile_sizes = {{\[}}[1, 64, 32], [1, 4, 4], [0, 0, 0, 4]{{\]}}>
+//  CHECK-DAG: #[[TRANSLATION:.+]] = #iree_codegen.translation_info<SPIRVBaseVectorize workgroup_size = [8, 16, 1]>
+//      CHECK: hal.executable.export public @batch_matmul_4x128x96x64
+// CHECK-SAME:   iree.metal.simdgroup_matmul = {accumulate = true, element_type = f16, lhs = array<i64: 0, 0, 0>, result = array<i64: 0, 2, 0>, rhs = array<i64: 0, 1, 0>, shape = array<i64: 4, 128, 96, 64>, tile = array<i64: 64, 32>}
+//      CHECK: func.func @batch_matmul_4x128x96x64()
+// CHECK-SAME:     translation_info = #[[TRANSLATION]]
+//      CHECK:   linalg.batch_matmul
+// CHECK-SAME:       lowering_config = #[[CONFIG]]
+
+// -----
+
+// Matmuls with fused consumers use the SPIR-V kernel.
+
+#executable_target_metal_msl_fb = #hal.executable.target<"metal-spirv", "metal-msl-fb", {spirv.target_env = #spirv.target_env<#spirv.vce<v1.3, [Shader, Float16], []>, api=Metal, Apple:IntegratedGPU, #spirv.resource_limits<max_compute_shared_memory_size = 32768, max_compute_workgroup_invocations = 1024, max_compute_workgroup_size = [1024, 1024, 1024], subgroup_size = 32>>}>
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [<0, bindings = [<0, storage_buffer, ReadOnly>, <1, storage_buffer, ReadOnly>, <2, storage_buffer, ReadOnly>, <3, storage_buffer>]>]>
+#map = affine_map<(d0, d1) -> (d0, d1)>
+#map1 = affine_map<(d0, d1) -> (d1)>
+hal.executable @matmul_bias_128x256x64 {
+  hal.executable.variant public @metal_msl_fb target(#executable_target_metal_msl_fb) {
+    hal.executable.export public @matmul_bias_128x256x64 ordinal(0) layout(#pipeline_layout)
+    builtin.module {
+      func.func @matmul_bias_128x256x64() {
+        %c0 = arith.constant 0 : index
+        %cst = arith.constant 0.000000e+00 : f32
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<128x64xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<64x256xf32>>
+        %2 = hal.interface.binding.subspan set(0) binding(2) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<256xf32>>
+        %3 = hal.interface.binding.subspan set(0) binding(3) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<128x256xf32>>
+        %4 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [128, 64], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<128x64xf32>> -> tensor<128x64xf32>
+        %5 = flow.dispatch.tensor.load %1, offsets = [0, 0], sizes = [64, 256], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<64x256xf32>> -> tensor<64x256xf32>
+        %6 = flow.dispatch.tensor.load %2, offsets = [0], sizes = [256], strides = [1] : !flow.dispatch.tensor<readonly:tensor<256xf32>> -> tensor<256xf32>
+        %7 = tensor.empty() : tensor<128x256xf32>
+        %8 = linalg.fill ins(%cst : f32) outs(%7 : tensor<128x256xf32>) -> tensor<128x256xf32>
+        %9 = linalg.matmul ins(%4, %5 : tensor<128x64xf32>, tensor<64x256xf32>) outs(%8 : tensor<128x256xf32>) -> tensor<128x256xf32>
+        %10 = linalg.generic {indexing_maps = [#map, #map1, #map], iterator_types = ["parallel", "parallel"]} ins(%9, %6 : tensor<128x256xf32>, tensor<256xf32>) outs(%7 : tensor<128x256xf32>) {
+        ^bb0(%in: f32, %in_0: f32, %out: f32):
+          %11 = arith.addf %in, %in_0 : f32
+          linalg.yield %11 : f32
+        } -> tensor<128x256xf32>
+        flow.dispatch.tensor.store %10, %3, offsets = [0, 0], sizes = [128, 256], strides = [1, 1] : tensor<128x256xf32> -> !flow.dispatch.tensor<writeonly:tensor<128x256xf32>>
+        return
+      }
+    }
+  }
+}
+
+//      CHECK: hal.executable.export public @matmul_bias_128x256x64
+//  CHECK-NOT:   iree.metal.simdgroup_matmul
+//      CHECK: func.func @matmul_bias_128x256x64()
@@ -142,3 +142,65 @@ hal.executable private @subgroup_reduce {
 }
 
 // CHECK-NOT: spirv.GroupNonUniformShuffleXor
+
+// -----
+
+// Check the case of GroupNonUniformArithmetic without GroupNonUniformShuffle
+// capability, which uses subgroup arithmetic ops within and across subgroups.
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>
+  ]>
+]>
+hal.executable private @subgroup_reduce {
+  hal.executable.variant @vulkan_spirv_fb target(<"vulkan-spirv", "vulkan-spirv-fb", {
+      spirv.target_env = #spirv.target_env<#spirv.vce<v1.4, [Shader, GroupNonUniform, GroupNonUniformArithmetic], []>, ARM:IntegratedGPU, #spirv.resource_limits<
+        max_compute_shared_memory_size = 32768,
+        max_compute_workgroup_invocations = 512,
+        max_compute_workgroup_size = [512, 512, 512],
+       subgroup_size = 16>>
+    }>) {
+    hal.executable.export public @subgroup_reduce ordinal(0) layout(#pipeline_layout) {
+    ^bb0(%arg0: !hal.device, %arg1: index, %arg2: index):
+      %x, %y, %z = flow.dispatch.workgroup_count_from_dag_root %arg1, %arg2
+      hal.return %x, %y, %z : index, index, index
+    }
+    builtin.module {
+      func.func @subgroup_reduce() {
+        %c0 = arith.constant 0 : index
+        %cst = arith.constant 0.000000e+00 : f32
+        %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<readonly:tensor<2x512xf32>>
+        %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<2xf32>>
+        %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [2, 512], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<2x512xf32>> -> tensor<2x512xf32>
+        %3 = tensor.empty() : tensor<2xf32>
+        %4 = linalg.fill ins(%cst : f32) outs(%3 : tensor<2xf32>) -> tensor<2xf32>
+        %5 = linalg.generic {
+          indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+          iterator_types = ["parallel", "reduction"]
+        } ins(%2 : tensor<2x512xf32>) outs(%4 : tensor<2xf32>) {
+        ^bb0(%arg0: f32, %arg1: f32):
+          %6 = arith.addf %arg1, %arg0 : f32
+          linalg.yield %6 : f32
+        } -> tensor<2xf32>
+        flow.dispatch.tensor.store %5, %1, offsets = [0], sizes = [2], strides = [1] : tensor<2xf32> -> !flow.dispatch.tensor<writeonly:tensor<2xf32>>
+        return
+      }
+    }
+  }
+}
+
+// CHECK-LABEL: spirv.func @subgroup_reduce()
+
+// CHECK-NOT:   spirv.GroupNonUniformShuffle
+// CHECK:       %[[ADD0:.+]] = spirv.GroupNonUniformFAdd "Subgroup" "Reduce" %{{.+}} : f32
+// CHECK:       spirv.Store "Workgroup" %{{.+}}, %[[ADD0]] : f32
+// CHECK:       spirv.ControlBarrier <Workgroup>, <Workgroup>, <AcquireRelease|WorkgroupMemory>
+// CHECK:       %[[LOAD_VAL:.+]] = spirv.Load "Workgroup" {{.+}} : f32
+// CHECK:       %[[SEL:.+]] = spirv.Select %{{.+}}, %{{.+}}, %[[LOAD_VAL]] : i1, f32
+// CHECK:       spirv.GroupNonUniformFAdd "Subgroup" "Reduce" %[[SEL]] : f32
+// CHECK-NOT:   spirv.GroupNonUniformShuffle
+// CHECK:       spirv.Return
+
+// CHECK: spirv.ExecutionMode @{{.+}} "LocalSize", 128, 1, 1
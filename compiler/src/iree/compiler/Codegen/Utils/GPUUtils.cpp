@@ -475,11 +475,17 @@ static TypedAttr getCombiningKindIdentity(OpBuilder &builder,
     return builder.getFloatAttr(type, 1);
   }
   case vector::CombiningKind::MINUI:
+    return builder.getIntegerAttr(
+        type, APInt::getMaxValue(type.getIntOrFloatBitWidth()));
   case vector::CombiningKind::MINSI:
-    return builder.getIntegerAttr(type, std::numeric_limits<int64_t>::max());
+    return builder.getIntegerAttr(
+        type, APInt::getSignedMaxValue(type.getIntOrFloatBitWidth()));
   case vector::CombiningKind::MAXUI:
+    return builder.getIntegerAttr(
+        type, APInt::getMinValue(type.getIntOrFloatBitWidth()));
   case vector::CombiningKind::MAXSI:
-    return builder.getIntegerAttr(type, std::numeric_limits<int64_t>::min());
+    return builder.getIntegerAttr(
+        type, APInt::getSignedMinValue(type.getIntOrFloatBitWidth()));
   case vector::CombiningKind::AND:
     return builder.getIntegerAttr(type, 1);
   case vector::CombiningKind::OR:
@@ -537,14 +543,81 @@ combiningKindToAllReduce(vector::CombiningKind kind) {
     return AllReduceOperation::OR;
   case CombiningKind::XOR:
     return AllReduceOperation::XOR;
-  // Currently, the min/max reductions are not well-defined in the gpu dialect.
-  // See https://github.com/llvm/llvm-project/issues/72354.
+  case CombiningKind::MINUI:
+    return AllReduceOperation::MINUI;
+  case CombiningKind::MINSI:
+    return AllReduceOperation::MINSI;
+  case CombiningKind::MAXUI:
+    return AllReduceOperation::MAXUI;
+  case CombiningKind::MAXSI:
+    return AllReduceOperation::MAXSI;
+  case CombiningKind::MINNUMF:
+    return AllReduceOperation::MINNUMF;
+  case CombiningKind::MAXNUMF:
+    return AllReduceOperation::MAXNUMF;
+  // The NaN-propagating minimumf/maximumf reductions have no subgroup
+  // instruction counterpart on all targets (e.g. SPIR-V), so keep expanding
+  // them into shuffles.
   default:
     break;
   }
   return std::nullopt;
 }
 
+/// Reduces the per-warp values |laneVal| of the |numWarp| warps of a workgroup
+/// by storing them to shared memory and reducing them again with a single warp.
+/// |warpReduce| reduces a value over the given number of lanes of a warp. The
+/// lanes beyond the number of warps are padded with the identity element when
+/// the number of warps is not a power of two, or when |padToWarpSize| is set
+/// because |warpReduce| reduces over all the lanes of the warp.
+static Value
+reduceAcrossWarps(Location loc, OpBuilder &builder, Value laneVal,
+                  vector::CombiningKind kind, uint32_t numWarp,
+                  uint32_t warpSize, bool padToWarpSize,
+                  function_ref<Value(Value, uint32_t)> warpReduce) {
+  assert(numWarp <= warpSize &&
+         "Only support 1 level, need to implement recursive/loop for this "
+         "case.");
+  auto addressSpaceAttr = gpu::AddressSpaceAttr::get(
+      builder.getContext(), gpu::GPUDialect::getWorkgroupAddressSpace());
+  MemRefType memrefType =
+      MemRefType::get(numWarp, laneVal.getType(), MemRefLayoutAttrInterface{},
+                      addressSpaceAttr);
+  Value alloc = builder.create<memref::AllocOp>(loc, memrefType);
+  Value threadX = builder.create<gpu::ThreadIdOp>(loc, builder.getIndexType(),
+                                                  gpu::Dimension::x);
+  Value cstWarpSize = builder.create<arith::ConstantIndexOp>(loc, warpSize);
+  Value warpId = builder.create<arith::DivUIOp>(loc, threadX, cstWarpSize);
+  Value laneId = builder.create<arith::RemUIOp>(loc, threadX, cstWarpSize);
+  Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value lane0 = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                              laneId, zero);
+  // Store the reduction for each warp.
+  SmallVector<Value> indices = {warpId};
+  builder.create<scf::IfOp>(loc, lane0, [&](OpBuilder &b, Location l) {
+    b.create<memref::StoreOp>(l, laneVal, alloc, indices);
+    b.create<scf::YieldOp>(l, std::nullopt);
+  });
+  builder.create<gpu::BarrierOp>(loc);
+  // Further reduce the outputs from each warps with a single warp reduce.
+  Value memrefSize = builder.create<arith::ConstantIndexOp>(loc, numWarp - 1);
+  Value laneIdInBounds =
+      builder.create<arith::MinUIOp>(loc, laneId, memrefSize);
+  Value loadVal = builder.create<memref::LoadOp>(loc, alloc, laneIdInBounds);
+  Value cstNumWarp = builder.create<arith::ConstantIndexOp>(loc, numWarp);
+  if (padToWarpSize ? numWarp < warpSize : !llvm::isPowerOf2_32(numWarp)) {
+    // Pad with identity element if numel < warpSize for valid warp reduction.
+    Value useIdentityElement = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::sge, laneId, cstNumWarp);
+    numWarp = llvm::PowerOf2Ceil(numWarp);
+    Value identity =
+        getCombiningIdentityValue(loc, builder, kind, loadVal.getType());
+    loadVal = builder.create<arith::SelectOp>(loc, useIdentityElement,
+                                              identity, loadVal);
+  }
+  return warpReduce(loadVal, numWarp);
+}
+
 /// Emit reduction across a group for a given input.
 Value emitGPUGroupReduction(Location loc, OpBuilder &builder, Value input,
                             vector::CombiningKind kind, uint32_t size,
@@ -553,12 +626,21 @@ Value emitGPUGroupReduction(Location loc, OpBuilder &builder, Value input,
       size % warpSize == 0 &&
       "Group reduction only support for sizes aligned on warp size for now.");
 
-  if (!expandSubgroupReduce && size == warpSize) {
+  if (!expandSubgroupReduce) {
     if (auto gpuReduceKind = combiningKindToAllReduce(kind)) {
-      // Simple case -- emit `gpu.subgroup_reduce` directly.
+      // Simple case -- emit `gpu.subgroup_reduce` directly, for each warp and
+      // then across warps if needed.
+      auto subgroupReduce = [&](Value val, uint32_t /*numLaneToReduce*/) {
+        return builder.create<gpu::SubgroupReduceOp>(loc, val, *gpuReduceKind)
+            .getResult();
+      };
       Value laneVal = builder.create<vector::ReductionOp>(loc, kind, input);
-      return builder.create<gpu::SubgroupReduceOp>(loc, laneVal,
-                                                   *gpuReduceKind);
+      laneVal = subgroupReduce(laneVal, warpSize);
+      if (size == warpSize)
+        return laneVal;
+      return reduceAcrossWarps(loc, builder, laneVal, kind, size / warpSize,
+                               warpSize, /*padToWarpSize=*/true,
+                               subgroupReduce);
     }
   }
 
@@ -570,48 +652,12 @@ Value emitGPUGroupReduction(Location loc, OpBuilder &builder, Value input,
   laneVal = warpReduction(loc, builder, laneVal, kind, warpSize, warpSize);
   // if we have more than one warp, reduce across warps.
   if (size > warpSize) {
-    uint32_t numWarp = size / warpSize;
-    assert(numWarp <= warpSize &&
-           "Only support 1 level, need to implement recursive/loop for this "
-           "case.");
-    auto addressSpaceAttr = gpu::AddressSpaceAttr::get(
-        builder.getContext(), gpu::GPUDialect::getWorkgroupAddressSpace());
-    MemRefType memrefType =
-        MemRefType::get(numWarp, laneVal.getType(), MemRefLayoutAttrInterface{},
-                        addressSpaceAttr);
-    Value alloc = builder.create<memref::AllocOp>(loc, memrefType);
-    Value threadX = builder.create<gpu::ThreadIdOp>(loc, builder.getIndexType(),
-                                                    gpu::Dimension::x);
-    Value cstWarpSize = builder.create<arith::ConstantIndexOp>(loc, warpSize);
-    Value warpId = builder.create<arith::DivUIOp>(loc, threadX, cstWarpSize);
-    Value laneId = builder.create<arith::RemUIOp>(loc, threadX, cstWarpSize);
-    Value zero = builder.create<arith::ConstantIndexOp>(loc, 0);
-    Value lane0 = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
-                                                laneId, zero);
-    // Store the reduction for each warp.
-    SmallVector<Value> indices = {warpId};
-    builder.create<scf::IfOp>(loc, lane0, [&](OpBuilder &b, Location l) {
-      b.create<memref::StoreOp>(l, laneVal, alloc, indices);
-      b.create<scf::YieldOp>(l, std::nullopt);
-    });
-    builder.create<gpu::BarrierOp>(loc);
-    // Further reduce the outputs from each warps with a single warp reduce.
-    Value memrefSize = builder.create<arith::ConstantIndexOp>(loc, numWarp - 1);
-    Value laneIdInBounds =
-        builder.create<arith::MinUIOp>(loc, laneId, memrefSize);
-    Value loadVal = builder.create<memref::LoadOp>(loc, alloc, laneIdInBounds);
-    Value cstNumWarp = builder.create<arith::ConstantIndexOp>(loc, numWarp);
-    if (!llvm::isPowerOf2_32(numWarp)) {
-      // Pad with identity element if numel < warpSize for valid warp reduction.
-      Value useIdentityElement = builder.create<arith::CmpIOp>(
-          loc, arith::CmpIPredicate::sge, laneId, cstNumWarp);
-      numWarp = llvm::PowerOf2Ceil(numWarp);
-      Value identity =
-          getCombiningIdentityValue(loc, builder, kind, loadVal.getType());
-      loadVal = builder.create<arith::SelectOp>(loc, useIdentityElement,
-                                                identity, loadVal);
-    }
-    laneVal = warpReduction(loc, builder, loadVal, kind, warpSize, numWarp);
+    laneVal = reduceAcrossWarps(
+        loc, builder, laneVal, kind, size / warpSize, warpSize,
+        /*padToWarpSize=*/false, [&](Value val, uint32_t numLaneToReduce) {
+          return warpReduction(loc, builder, val, kind, warpSize,
+                               numLaneToReduce);
+        });
   }
 
   return laneVal;
@@ -95,8 +95,10 @@ void propagateSharedMemoryCopy(mlir::FunctionOpInterface funcOp);
 /// Inserts barriers before and after shared memory copy.
 void insertBarriersAroundSharedMemoryCopy(mlir::FunctionOpInterface funcOp);
 
-/// Emit reduction across a group for a given input. Emits `gpu.shuffle`
-/// based reduction only when `expandSubgroupReduce` is set.
+/// Emit reduction across a group for a given input. Unless
+/// `expandSubgroupReduce` is set, reductions with a matching
+/// `gpu.subgroup_reduce` kind use it both within and across subgroups; other
+/// reductions emit a `gpu.shuffle` based reduction.
 Value emitGPUGroupReduction(Location loc, OpBuilder &builder, Value input,
                             vector::CombiningKind kind, uint32_t size,
                             int warpSize, bool expandSubgroupReduce);
@@ -138,6 +140,10 @@ bool hasUkernelSupportedRocmArch(StringRef targetChip);
 /// Checks if targetAttr's GPU target has UKernel support.
 bool hasUkernelSupportedGpuArch(IREE::HAL::ExecutableTargetAttr targetAttr);
 
+/// Largest k supported by the topk UKernel, which keeps k candidates per lane
+/// in registers.
+static constexpr int64_t kTopkUkernelMaxK = 16;
+
 //===----------------------------------------------------------------------===//
 // GPU Target Information
 //===----------------------------------------------------------------------===//
@@ -225,6 +225,16 @@ bool isRISCV32(IREE::HAL::ExecutableTargetAttr targetAttr) {
   return triple && triple.value().isRISCV32();
 }
 
+bool isRISCV64(IREE::HAL::ExecutableTargetAttr targetAttr) {
+  std::optional<llvm::Triple> triple = getTargetTriple(targetAttr);
+  return triple && triple.value().isRISCV64();
+}
+
+bool isWasm32(IREE::HAL::ExecutableTargetAttr targetAttr) {
+  std::optional<llvm::Triple> triple = getTargetTriple(targetAttr);
+  return triple && triple.value().isWasm() && triple.value().isArch32Bit();
+}
+
 bool isReadOnly(Value v) {
   Operation *definingOp = v.getDefiningOp();
   if (!definingOp)
@@ -909,6 +919,112 @@ LogicalResult isArgmaxOp(linalg::GenericOp genericOp) {
   return success();
 }
 
+FailureOr<int64_t> getMmt4dDequantGroupSize(linalg::GenericOp genericOp) {
+  if (genericOp.getNumDpsInputs() != 4 || genericOp.getNumDpsInits() != 1) {
+    return failure();
+  }
+  using utils::IteratorType;
+  SmallVector<IteratorType> expectedIteratorTypes = {
+      IteratorType::parallel, IteratorType::parallel, IteratorType::reduction,
+      IteratorType::parallel, IteratorType::parallel, IteratorType::reduction};
+  if (genericOp.getIteratorTypesArray() != expectedIteratorTypes) {
+    return failure();
+  }
+
+  // The scales and zero points are indexed by (n1, k1 floordiv c, n0), where
+  // c is the number of K1 tiles per group.
+  SmallVector<AffineMap> maps = genericOp.getIndexingMapsArray();
+  AffineMap scalesMap = maps[2];
+  if (scalesMap.getNumResults() != 3) {
+    return failure();
+  }
+  MLIRContext *ctx = genericOp.getContext();
+  AffineExpr m1, n1, k1, m0, n0, k0;
+  bindDims(ctx, m1, n1, k1, m0, n0, k0);
+  auto groupExpr = dyn_cast<AffineBinaryOpExpr>(scalesMap.getResult(1));
+  if (!groupExpr || groupExpr.getKind() != AffineExprKind::FloorDiv ||
+      groupExpr.getLHS() != k1) {
+    return failure();
+  }
+  auto tilesPerGroup = dyn_cast<AffineConstantExpr>(groupExpr.getRHS());
+  if (!tilesPerGroup || tilesPerGroup.getValue() <= 0) {
+    return failure();
+  }
+  auto getMap = [&](ArrayRef<AffineExpr> results) {
+    return AffineMap::get(/*dimCount=*/6, /*symbolCount=*/0, results, ctx);
+  };
+  SmallVector<AffineMap> expectedMaps = {
+      getMap({m1, k1, m0, k0}), getMap({n1, k1, n0, k0}),
+      getMap({n1, groupExpr, n0}), getMap({n1, groupExpr, n0}),
+      getMap({m1, n1, m0, n0})};
+  if (maps != expectedMaps) {
+    return failure();
+  }
+
+  auto getElementType = [&](unsigned operandIdx) {
+    return getElementTypeOrSelf(genericOp->getOperand(operandIdx).getType());
+  };
+  Type scalesType = getElementType(2);
+  if (!getElementType(0).isF32() || !getElementType(1).isInteger(4) ||
+      !(scalesType.isF16() || scalesType.isBF16()) ||
+      getElementType(3) != scalesType || !getElementType(4).isF32()) {
+    return failure();
+  }
+
+  // yield(addf(mulf(lhs, mulf(subf(uitofp(extui(rhs)), extf(zero_point)),
+  //                           extf(scale))), out))
+  Block *body = genericOp.getBody();
+  auto arg = [&](unsigned i) { return m_Val(body->getArgument(i)); };
+  auto dequantizedRhs = m_Op<arith::MulFOp>(
+      m_Op<arith::SubFOp>(m_Op<arith::UIToFPOp>(m_Op<arith::ExtUIOp>(arg(1))),
+                          m_Op<arith::ExtFOp>(arg(3))),
+      m_Op<arith::ExtFOp>(arg(2)));
+  auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+  if (!matchPattern(yieldOp->getOperand(0),
+                    m_Op<arith::AddFOp>(
+                        m_Op<arith::MulFOp>(arg(0), dequantizedRhs), arg(4)))) {
+    return failure();
+  }
+
+  int64_t K0 =
+      cast<ShapedType>(genericOp.getDpsInputs()[0].getType()).getDimSize(3);
+  if (ShapedType::isDynamic(K0)) {
+    return failure();
+  }
+  return tilesPerGroup.getValue() * K0;
+}
+
+LogicalResult isTopkMaxOp(IREE::LinalgExt::TopkOp topkOp) {
+  // Input indices would need to be forwarded instead of being inferred.
+  if (topkOp.getIndices()) {
+    return failure();
+  }
+  if (topkOp.getDimension() != topkOp.getInputRank() - 1) {
+    return failure();
+  }
+
+  // The region should only compare the new value against the existing one.
+  Block &block = topkOp.getRegion().front();
+  if (block.getNumArguments() != 2 ||
+      !llvm::hasSingleElement(block.without_terminator())) {
+    return failure();
+  }
+  auto cmpOp = dyn_cast<arith::CmpFOp>(block.front());
+  if (!cmpOp || cmpOp.getPredicate() != arith::CmpFPredicate::OGT) {
+    return failure();
+  }
+  if (cmpOp.getLhs() != block.getArgument(0) ||
+      cmpOp.getRhs() != block.getArgument(1)) {
+    return failure();
+  }
+  auto yieldOp = dyn_cast<IREE::LinalgExt::YieldOp>(block.getTerminator());
+  if (!yieldOp || yieldOp.getNumOperands() != 1 ||
+      yieldOp.getOperand(0) != cmpOp.getResult()) {
+    return failure();
+  }
+  return success();
+}
+
 //===---------------------------------------------------------------------===//
 // Replace Memref users (transitively)
 //===---------------------------------------------------------------------===//
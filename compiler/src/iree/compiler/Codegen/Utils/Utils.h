@@ -8,6 +8,7 @@
 #define IREE_COMPILER_CODEGEN_UTILS_UTILS_H_
 
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtOps.h"
 #include "llvm/TargetParser/Triple.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
@@ -84,6 +85,8 @@ bool isX86_64(IREE::HAL::ExecutableTargetAttr targetAttr);
 bool isAArch64(IREE::HAL::ExecutableTargetAttr targetAttr);
 bool isRISCV(IREE::HAL::ExecutableTargetAttr targetAttr);
 bool isRISCV32(IREE::HAL::ExecutableTargetAttr targetAttr);
+bool isRISCV64(IREE::HAL::ExecutableTargetAttr targetAttr);
+bool isWasm32(IREE::HAL::ExecutableTargetAttr targetAttr);
 
 /// Checks if a tensor value is generated from a read-only object, like
 /// and interface binding with read-only attribute or from an `arith.constant`
@@ -210,6 +213,20 @@ OpFoldResult convertByteOffsetToElementOffset(RewriterBase &rewriter,
 /// Check if a linalg.generic is representing an argmax operation.
 LogicalResult isArgmaxOp(linalg::GenericOp genericOp);
 
+/// Check if an iree_linalg_ext.topk is selecting the largest values along its
+/// innermost dimension with the index mapping inferred from the dimension.
+LogicalResult isTopkMaxOp(IREE::LinalgExt::TopkOp topkOp);
+
+/// Check if a linalg.generic is the data-tiled form of a matmul with a
+/// grouped-quantized RHS, as materialized from encodings with an RHS_SCALES
+/// operand:
+///   ins(lhs: M1xK1xM0xK0xf32, rhs: N1xK1xN0xK0xi4,
+///       scales: N1xGxN0, zero_points: N1xGxN0) outs(out: M1xN1xM0xN0xf32)
+/// with f16 or bf16 scales and zero points, and a body computing
+///   out += lhs * (uitofp(extui(rhs)) - extf(zero_point)) * extf(scale).
+/// Returns the group size, in elements along K, on success.
+FailureOr<int64_t> getMmt4dDequantGroupSize(linalg::GenericOp genericOp);
+
 /// Replace the uses of memref value `origValue` with the given
 /// `replacementValue`. Some uses of the memref value might require changes to
 /// the operation itself. Create new operations which can carry the change, and
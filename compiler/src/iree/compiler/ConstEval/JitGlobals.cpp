@@ -7,14 +7,18 @@
 #include "iree/compiler/ConstEval/PassDetail.h"
 #include "iree/compiler/ConstEval/Passes.h"
 #include "iree/compiler/ConstEval/Runtime.h"
+#include "iree/compiler/Dialect/Flow/IR/FlowTypes.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetOptions.h"
 #include "iree/compiler/Dialect/Util/Analysis/Constant/ConstExpr.h"
 #include "iree/compiler/Dialect/Util/Analysis/Constant/OpOracle.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
+#include "iree/compiler/Modules/IO/Parameters/Transforms/ArchiveUtils.h"
 #include "iree/compiler/Pipelines/Pipelines.h"
 #include "iree/compiler/Utils/PassUtils.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
@@ -43,6 +47,28 @@ static llvm::cl::opt<bool> clEnableDebug(
         "don't want to run a debug compiler)."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<std::string> clParameterArchive(
+    "iree-consteval-jit-parameter-archive",
+    llvm::cl::desc(
+        "Streams evaluated globals to a parameter archive at the given "
+        "`[scope=]path` as soon as they are computed instead of keeping them "
+        "in memory as attributes."),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<int64_t> clParameterMinimumSize(
+    "iree-consteval-jit-parameter-minimum-size",
+    llvm::cl::desc("Minimum size in bytes of an evaluated global to be "
+                   "streamed to the parameter archive."),
+    llvm::cl::init(256));
+
+static llvm::cl::opt<int64_t> clMemoryBudget(
+    "iree-consteval-jit-memory-budget",
+    llvm::cl::desc(
+        "Maximum total size in bytes of the evaluated globals kept in memory "
+        "as attributes (0 for unlimited). Initializers whose results do not "
+        "fit in the budget are left to be run at runtime."),
+    llvm::cl::init(0));
+
 namespace {
 
 static bool isDebugEnabled() {
@@ -405,6 +431,32 @@ struct JitFunctionDesc {
   std::string name;
   llvm::SmallVector<ArgumentBinding> argumentBindings;
   llvm::SmallVector<ResultBinding> resultBindings;
+  // The initializer the function was created from. It is only erased once the
+  // function has been evaluated.
+  IREE::Util::InitializerOp initializerOp;
+  bool evaluated = false;
+};
+
+// Returns the size in bytes of a value of |type| or std::nullopt if it is not
+// statically known.
+static std::optional<int64_t> getStorageSize(Type type) {
+  if (auto tensorType = dyn_cast<RankedTensorType>(type)) {
+    if (!tensorType.hasStaticShape())
+      return std::nullopt;
+    return tensorType.getNumElements() *
+           IREE::Util::getRoundedElementByteWidth(tensorType.getElementType());
+  }
+  if (type.isIntOrFloat())
+    return IREE::Util::getRoundedElementByteWidth(type);
+  return std::nullopt;
+}
+
+// A parameter archive that evaluated globals are streamed into.
+struct JitParameterArchive {
+  std::string scope;
+  // Globals with storage reserved in the archive.
+  llvm::DenseSet<Operation *> globalOps;
+  std::optional<IREE::IO::Parameters::FileStreamIndex> fileStreamIndex;
 };
 
 // Clones all object-like symbols used within the function.
@@ -493,6 +545,7 @@ public:
       funcOp.erase();
       return failure();
     }
+    jitFunctions.back().initializerOp = initializerOp;
     return success();
   }
 
@@ -691,12 +744,156 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     return s;
   }
 
+  // Reserves storage in a parameter archive for the results of |jitFunctions|
+  // so that they can be written out as soon as they are evaluated. Results
+  // that are loaded by other jit functions stay in memory as they are needed
+  // as arguments.
+  LogicalResult
+  createParameterArchive(ModuleOp moduleOp,
+                         llvm::SmallVector<JitFunctionDesc> &jitFunctions,
+                         JitParameterArchive &archive) {
+    auto [scope, path] =
+        IREE::IO::Parameters::splitScopePath(clParameterArchive);
+    archive.scope = scope.str();
+
+    llvm::DenseSet<Operation *> consumedGlobalOps;
+    for (JitFunctionDesc &jitFunction : jitFunctions) {
+      for (ArgumentBinding &arg : jitFunction.argumentBindings) {
+        if (arg.getType() == ArgumentBinding::Type::GlobalOp)
+          consumedGlobalOps.insert(arg.getGlobalOp());
+      }
+    }
+
+    auto builder = IREE::IO::Parameters::createArchiveBuilder(moduleOp);
+    if (failed(builder))
+      return failure();
+    for (JitFunctionDesc &jitFunction : jitFunctions) {
+      for (ResultBinding &resultBinding : jitFunction.resultBindings) {
+        IREE::Util::GlobalOpInterface globalOp = resultBinding.getGlobalOp();
+        Type globalType = globalOp.getGlobalType();
+        std::optional<int64_t> storageSize = getStorageSize(globalType);
+        if (!isa<RankedTensorType>(globalType) || !storageSize ||
+            *storageSize < clParameterMinimumSize ||
+            consumedGlobalOps.contains(globalOp)) {
+          continue;
+        }
+        StringRef name = globalOp.getGlobalName();
+        if (failed(IREE::IO::Parameters::handleRuntimeError(
+                globalOp,
+                iree_io_parameter_archive_builder_add_data_entry(
+                    builder->get(),
+                    iree_make_string_view(name.data(), name.size()),
+                    /*metadata=*/iree_const_byte_span_empty(),
+                    /*alignment=*/
+                    IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+                    *storageSize),
+                "failed to add data entry for global"))) {
+          return failure();
+        }
+        archive.globalOps.insert(globalOp);
+      }
+    }
+    if (archive.globalOps.empty())
+      return success();
+
+    auto fileStreamIndex = IREE::IO::Parameters::createParameterIndex(
+        moduleOp, std::move(builder.value()), path);
+    if (failed(fileStreamIndex))
+      return failure();
+    archive.fileStreamIndex = std::move(*fileStreamIndex);
+    return success();
+  }
+
+  // Writes result |resultIndex| of |call| to the storage reserved for
+  // |globalOp| in |archive| and makes the global reference the parameter.
+  static LogicalResult
+  writeResultToArchive(FunctionCall &call, size_t resultIndex,
+                       IREE::Util::GlobalOpInterface globalOp,
+                       JitParameterArchive &archive) {
+    auto &[file, stream, index] = *archive.fileStreamIndex;
+    const iree_io_parameter_index_entry_t *entry = nullptr;
+    StringRef name = globalOp.getGlobalName();
+    if (failed(IREE::IO::Parameters::handleRuntimeError(
+            globalOp,
+            iree_io_parameter_index_lookup(
+                index.get(), iree_make_string_view(name.data(), name.size()),
+                &entry),
+            "retrieve global from index")) ||
+        failed(IREE::IO::Parameters::handleRuntimeError(
+            globalOp,
+            iree_io_stream_seek(stream.get(), IREE_IO_STREAM_SEEK_SET,
+                                entry->storage.file.offset),
+            "failed to seek to location of global in archive"))) {
+      return failure();
+    }
+    IREE::IO::Parameters::iree_io_stream_ostream os(stream.get());
+    if (failed(call.writeResultToStream(globalOp.getLoc(), resultIndex, os)))
+      return failure();
+    os.flush();
+
+    MLIRContext *context = globalOp.getContext();
+    globalOp.setGlobalInitialValue(IREE::Flow::NamedParameterAttr::get(
+        context, globalOp.getGlobalType(),
+        StringAttr::get(context, archive.scope),
+        StringAttr::get(context, name), DictionaryAttr()));
+    return success();
+  }
+
+  // Returns the number of bytes the results of |jitFunction| will occupy in
+  // memory once evaluated or std::nullopt if it is not statically known.
+  static std::optional<int64_t>
+  getResidentSize(JitFunctionDesc &jitFunction,
+                  const JitParameterArchive &archive) {
+    int64_t residentSize = 0;
+    for (ResultBinding &resultBinding : jitFunction.resultBindings) {
+      IREE::Util::GlobalOpInterface globalOp = resultBinding.getGlobalOp();
+      if (archive.globalOps.contains(globalOp))
+        continue;
+      std::optional<int64_t> storageSize =
+          getStorageSize(globalOp.getGlobalType());
+      if (!storageSize)
+        return std::nullopt;
+      residentSize += *storageSize;
+    }
+    return residentSize;
+  }
+
   LogicalResult
   processFunctions(CompiledBinary &binary,
                    llvm::SmallVector<JitFunctionDesc> &jitFunctions,
-                   ModuleOp module, llvm::TimerGroup &tg) {
+                   ModuleOp module, JitParameterArchive &archive,
+                   llvm::TimerGroup &tg) {
+    // Globals whose initializers are left to be run at runtime.
+    llvm::DenseSet<Operation *> skippedGlobalOps;
+    int64_t residentSize = 0;
+
     // Process each function through the runtime.
     for (JitFunctionDesc &jitFunction : jitFunctions) {
+      if (clMemoryBudget > 0) {
+        // Keep the initializer if it depends on a skipped initializer or if
+        // its results would exceed the memory budget. Storage reserved in the
+        // archive for its results is left unused.
+        bool hasSkippedArgument =
+            llvm::any_of(jitFunction.argumentBindings, [&](auto &arg) {
+              return arg.getType() == ArgumentBinding::Type::GlobalOp &&
+                     skippedGlobalOps.contains(arg.getGlobalOp());
+            });
+        std::optional<int64_t> functionSize =
+            getResidentSize(jitFunction, archive);
+        if (hasSkippedArgument || !functionSize ||
+            residentSize + *functionSize > clMemoryBudget) {
+          emitDebugWarning(jitFunction.loc, [&](InFlightDiagnostic &diag) {
+            diag << "skipping consteval initializer: results exceed the "
+                    "memory budget of "
+                 << clMemoryBudget << " bytes";
+          });
+          for (ResultBinding &resultBinding : jitFunction.resultBindings)
+            skippedGlobalOps.insert(resultBinding.getGlobalOp());
+          continue;
+        }
+        residentSize += *functionSize;
+      }
+
       std::optional<llvm::Timer> invokeTimer;
       if (debugEnabled) {
         std::string timerName("Invoke ");
@@ -742,6 +939,12 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
         ResultBinding &resultBinding = it.value();
         switch (resultBinding.getType()) {
         case ResultBinding::Type::GlobalOp: {
+          if (archive.globalOps.contains(resultBinding.getGlobalOp())) {
+            if (failed(writeResultToArchive(
+                    call, it.index(), resultBinding.getGlobalOp(), archive)))
+              return failure();
+            break;
+          }
           TypedAttr attr;
           if (failed(call.getResultAsAttr(
                   resultBinding.getGlobalOp().getLoc(), it.index(),
@@ -753,6 +956,7 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
         }
       }
 
+      jitFunction.evaluated = true;
       if (debugEnabled) {
         invokeTimer->stopTimer();
       }
@@ -783,7 +987,6 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     }
 
     llvm::SmallVector<IREE::Util::InitializerOp> initializerOps;
-    llvm::SmallVector<IREE::Util::InitializerOp> deadInitOps;
     for (auto childOp : outerModule.getOps<IREE::Util::InitializerOp>()) {
       initializerOps.push_back(childOp);
     }
@@ -811,9 +1014,8 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
 
     // Iterate over initializers.
     for (auto initializerOp : initializerOps) {
-      if (succeeded(programBuilder.importInitializer(initializerOp))) {
-        deadInitOps.push_back(initializerOp);
-      } else if (debugEnabled) {
+      if (failed(programBuilder.importInitializer(initializerOp)) &&
+          debugEnabled) {
         llvm::dbgs() << "::: Rejected consteval initializer:\n"
                      << initializerOp << "\n";
       }
@@ -846,19 +1048,42 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
     // Kill the temporary program.
     programBuilder.getTargetModule()->erase();
 
+    // Reserve storage for the evaluated globals streamed to an archive.
+    JitParameterArchive archive;
+    if (!clParameterArchive.empty() &&
+        failed(createParameterArchive(
+            outerModule, programBuilder.getJitFunctions(), archive))) {
+      return signalPassFailure();
+    }
+
     // Process the functions.
     if (failed(processFunctions(binary, programBuilder.getJitFunctions(),
-                                outerModule, tg))) {
+                                outerModule, archive, tg))) {
       signalPassFailure();
       return;
     }
 
+    // Commit the written archive.
+    if (archive.fileStreamIndex) {
+      auto &file = std::get<0>(*archive.fileStreamIndex);
+      if (llvm::Error maybeCommit = file->commit()) {
+        InFlightDiagnostic errorStream =
+            outerModule.emitError() << "failed to commit archive with error: ";
+        llvm::handleAllErrors(std::move(maybeCommit),
+                              [&](const llvm::ErrorInfoBase &PE) {
+                                errorStream << PE.message() << "\n";
+                              });
+        return signalPassFailure();
+      }
+    }
+
     // Cleanup any initializers we replaced.
     // We do this after running the JIT-ed functions because we have deep
     // references into ops and attributes that need to be converted to
     // arguments.
-    for (auto deadOp : deadInitOps) {
-      deadOp.erase();
+    for (JitFunctionDesc &jitFunction : programBuilder.getJitFunctions()) {
+      if (jitFunction.evaluated)
+        jitFunction.initializerOp.erase();
     }
   }
 
@@ -10,6 +10,7 @@
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
 #include "iree/compiler/Dialect/VM/Target/Bytecode/BytecodeModuleTarget.h"
 #include "iree/hal/drivers/local_task/registration/driver_module.h"
+#include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/BuiltinTypes.h"
 
@@ -364,6 +365,34 @@ LogicalResult FunctionCall::getResultAsAttr(Location loc, size_t index,
   return success();
 }
 
+LogicalResult FunctionCall::writeResultToStream(Location loc, size_t index,
+                                                llvm::raw_ostream &os) {
+  iree_vm_variant_t variant = iree_vm_variant_empty();
+  if (failed(handleRuntimeError(loc, iree_vm_list_get_variant_assign(
+                                         outputs.get(), index, &variant))))
+    return failure();
+  if (!iree_vm_variant_is_ref(variant) ||
+      !iree_hal_buffer_view_isa(variant.ref)) {
+    return emitError(loc) << "evaluated result is not a buffer view";
+  }
+  iree_hal_buffer_view_t *bufferView = iree_hal_buffer_view_deref(variant.ref);
+  auto length = iree_hal_buffer_view_byte_length(bufferView);
+  iree_hal_buffer_t *buffer = iree_hal_buffer_view_buffer(bufferView);
+
+  // TODO(benvanik): fallback to alloc + iree_hal_device_transfer_range if
+  // mapping is not available (see convertVariantToAttribute).
+  iree_hal_buffer_mapping_t mapping;
+  if (failed(handleRuntimeError(
+          loc, iree_hal_buffer_map_range(buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+                                         IREE_HAL_MEMORY_ACCESS_READ,
+                                         /*byte_offset=*/0, length, &mapping))))
+    return failure();
+  os.write(reinterpret_cast<const char *>(mapping.contents.data),
+           mapping.contents.data_length);
+  iree_status_ignore(iree_hal_buffer_unmap_range(&mapping));
+  return success();
+}
+
 TypedAttr CompiledBinary::convertVariantToAttribute(Location loc,
                                                     iree_vm_variant_t &variant,
                                                     Type mlirType) {
@@ -60,6 +60,10 @@ public:
   LogicalResult invoke(Location loc, StringRef name);
   LogicalResult getResultAsAttr(Location loc, size_t index, Type mlirType,
                                 TypedAttr &outAttr);
+  // Writes the raw contents of the buffer view result at |index| to |os|
+  // without materializing it as an attribute.
+  LogicalResult writeResultToStream(Location loc, size_t index,
+                                    llvm::raw_ostream &os);
 
 private:
   FailureOr<iree::vm::ref<iree_hal_buffer_t>> importSerializableAttr(
@@ -0,0 +1,65 @@
+// RUN: iree-opt --split-input-file --iree-consteval-jit-globals --iree-consteval-jit-parameter-archive=consteval=%t.irpa --iree-consteval-jit-parameter-minimum-size=64 %s | FileCheck %s
+// RUN: iree-opt --split-input-file --iree-consteval-jit-globals --iree-consteval-jit-memory-budget=128 %s | FileCheck %s --check-prefix=BUDGET
+
+// CHECK-LABEL: @stream_to_archive
+// BUDGET-LABEL: @stream_to_archive
+module @stream_to_archive {
+  // CHECK: util.global private @large = #flow.parameter.named<"consteval"::"large"> : tensor<8x8xf32>
+  // BUDGET: util.global private @large : tensor<8x8xf32>
+  util.global private @large : tensor<8x8xf32>
+  // CHECK: util.global private @small = dense<4.000000e+00> : tensor<2xf32>
+  // BUDGET: util.global private @small = dense<4.000000e+00> : tensor<2xf32>
+  util.global private @small : tensor<2xf32>
+  // CHECK-NOT: util.initializer
+  // BUDGET: util.initializer
+  // BUDGET: util.global.store {{.+}}, @large
+  util.initializer {
+    %cst = arith.constant dense<2.0> : tensor<8x8xf32>
+    %0 = arith.addf %cst, %cst : tensor<8x8xf32>
+    util.global.store %0, @large : tensor<8x8xf32>
+    util.return
+  }
+  // BUDGET-NOT: util.initializer
+  util.initializer {
+    %cst = arith.constant dense<2.0> : tensor<2xf32>
+    %0 = arith.addf %cst, %cst : tensor<2xf32>
+    util.global.store %0, @small : tensor<2xf32>
+    util.return
+  }
+  util.func public @main() -> (tensor<8x8xf32>, tensor<2xf32>) {
+    %large = util.global.load @large : tensor<8x8xf32>
+    %small = util.global.load @small : tensor<2xf32>
+    util.return %large, %small : tensor<8x8xf32>, tensor<2xf32>
+  }
+}
+
+// -----
+
+// Globals needed to evaluate other initializers are kept in memory.
+
+// CHECK-LABEL: @consumed_global
+// BUDGET-LABEL: @consumed_global
+module @consumed_global {
+  // CHECK: util.global private @first = dense<4.000000e+00> : tensor<8x8xf32>
+  util.global private @first : tensor<8x8xf32>
+  // CHECK: util.global private @second = #flow.parameter.named<"consteval"::"second"> : tensor<8x8xf32>
+  util.global private @second : tensor<8x8xf32>
+  // CHECK-NOT: util.initializer
+  // BUDGET-COUNT-2: util.initializer
+  util.initializer {
+    %cst = arith.constant dense<2.0> : tensor<8x8xf32>
+    %0 = arith.addf %cst, %cst : tensor<8x8xf32>
+    util.global.store %0, @first : tensor<8x8xf32>
+    util.return
+  }
+  util.initializer {
+    %first = util.global.load @first : tensor<8x8xf32>
+    %0 = arith.addf %first, %first : tensor<8x8xf32>
+    util.global.store %0, @second : tensor<8x8xf32>
+    util.return
+  }
+  util.func public @main() -> tensor<8x8xf32> {
+    %second = util.global.load @second : tensor<8x8xf32>
+    util.return %second : tensor<8x8xf32>
+  }
+}
@@ -134,6 +134,7 @@ AffineMap EncodingAttr::getMapForRole() {
   case EncodingRole::LHS:
     return llvm::cast<AffineMapAttr>(getUserIndexingMaps()[0]).getAffineMap();
   case EncodingRole::RHS:
+  case EncodingRole::RHS_SCALES:
     return llvm::cast<AffineMapAttr>(getUserIndexingMaps()[1]).getAffineMap();
   case EncodingRole::RESULT:
     return llvm::cast<AffineMapAttr>(getUserIndexingMaps()[2]).getAffineMap();
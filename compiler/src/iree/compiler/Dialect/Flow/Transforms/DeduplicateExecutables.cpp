@@ -4,11 +4,23 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <algorithm>
+#include <iterator>
+#include <optional>
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
 #include "iree/compiler/Utils/EquivalenceUtils.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
 #include "mlir/Pass/Pass.h"
 
+#define DEBUG_TYPE "iree-flow-deduplicate-executables"
+
 namespace mlir::iree_compiler::IREE::Flow {
 
 #define GEN_PASS_DEF_DEDUPLICATEEXECUTABLESPASS
@@ -143,11 +155,239 @@ static int deduplicateObjects(Operation *scopeOp,
   return deadOps.size();
 }
 
+// Maximum number of constants outlined from an executable to allow it to be
+// merged with others. Each outlined constant becomes a dispatch operand.
+static constexpr int64_t kMaxOutlinedConstants = 8;
+
+// An executable with a single export that may be merged with other
+// executables differing only in the values of scalar constants.
+struct ConstantMergeCandidate {
+  IREE::Flow::ExecutableOp executableOp;
+  IREE::Flow::ExecutableExportOp exportOp;
+  mlir::FunctionOpInterface funcOp;
+  // All constants in |funcOp| in walk order.
+  SmallVector<arith::ConstantOp> constantOps;
+};
+
+// Returns true if |constantOp| can be replaced with a function argument.
+static bool isOutlinableConstant(arith::ConstantOp constantOp,
+                                 mlir::FunctionOpInterface funcOp) {
+  if (!constantOp.getType().isIntOrIndexOrFloat())
+    return false;
+  Operation *isolatedOp =
+      constantOp->getParentWithTrait<OpTrait::IsIsolatedFromAbove>();
+  return isolatedOp == funcOp.getOperation();
+}
+
+static std::optional<ConstantMergeCandidate>
+getConstantMergeCandidate(IREE::Flow::ExecutableOp executableOp) {
+  auto exportOps =
+      llvm::to_vector(executableOp.getOps<IREE::Flow::ExecutableExportOp>());
+  auto innerModuleOp = executableOp.getInnerModule();
+  if (exportOps.size() != 1 || !innerModuleOp ||
+      !llvm::hasSingleElement(innerModuleOp.getOps())) {
+    return std::nullopt;
+  }
+  auto funcOp = dyn_cast<mlir::FunctionOpInterface>(
+      *innerModuleOp.getOps().begin());
+  if (!funcOp || funcOp.getName() != exportOps.front().getFunctionRef()) {
+    return std::nullopt;
+  }
+  ConstantMergeCandidate candidate;
+  candidate.executableOp = executableOp;
+  candidate.exportOp = exportOps.front();
+  candidate.funcOp = funcOp;
+  funcOp.walk([&](arith::ConstantOp constantOp) {
+    candidate.constantOps.push_back(constantOp);
+  });
+  if (candidate.constantOps.empty())
+    return std::nullopt;
+  return candidate;
+}
+
+// Returns the positions of the constants in |candidate| that differ from those
+// in |reference| if the executables are otherwise structurally equivalent and
+// all differing constants can be outlined.
+static std::optional<SmallVector<unsigned>>
+matchModuloConstants(const ConstantMergeCandidate &reference,
+                     const ConstantMergeCandidate &candidate) {
+  if (reference.constantOps.size() != candidate.constantOps.size())
+    return std::nullopt;
+  SmallVector<unsigned> positions;
+  for (auto [i, referenceOp, candidateOp] : llvm::enumerate(
+           reference.constantOps, candidate.constantOps)) {
+    if (referenceOp.getType() != candidateOp.getType())
+      return std::nullopt;
+    if (referenceOp.getValue() == candidateOp.getValue())
+      continue;
+    if (!isOutlinableConstant(referenceOp, reference.funcOp) ||
+        !isOutlinableConstant(candidateOp, candidate.funcOp)) {
+      return std::nullopt;
+    }
+    positions.push_back(i);
+  }
+  if (positions.empty() ||
+      static_cast<int64_t>(positions.size()) > kMaxOutlinedConstants) {
+    return std::nullopt;
+  }
+
+  // Compare a clone of the candidate using the constants of the reference.
+  Operation *clonedOp = candidate.executableOp->clone();
+  SmallVector<arith::ConstantOp> clonedConstantOps;
+  clonedOp->walk([&](arith::ConstantOp constantOp) {
+    clonedConstantOps.push_back(constantOp);
+  });
+  for (unsigned position : positions) {
+    clonedConstantOps[position].setValueAttr(
+        reference.constantOps[position].getValue());
+  }
+  bool isEquivalent =
+      isStructurallyEquivalentTo(*clonedOp, *reference.executableOp);
+  clonedOp->erase();
+  if (!isEquivalent)
+    return std::nullopt;
+  return positions;
+}
+
+// Replaces the constants at |positions| in the function of |reference| with
+// new trailing function arguments.
+static void outlineConstants(ConstantMergeCandidate &reference,
+                             ArrayRef<unsigned> positions) {
+  for (unsigned position : positions) {
+    auto constantOp = reference.constantOps[position];
+    unsigned argIndex = reference.funcOp.getNumArguments();
+    reference.funcOp.insertArgument(argIndex, constantOp.getType(),
+                                    /*argAttrs=*/{}, constantOp.getLoc());
+    constantOp.replaceAllUsesWith(reference.funcOp.getArgument(argIndex));
+    constantOp.erase();
+  }
+}
+
+// Merges executables that differ only in the values of scalar constants by
+// outlining the differing constants into dispatch operands. Returns the total
+// number of executables merged and adds the number of constants outlined to
+// |outlinedConstantCount|.
+static int mergeExecutablesModuloConstants(mlir::ModuleOp moduleOp,
+                                           int64_t &outlinedConstantCount) {
+  // Dispatches of each export. Executables dispatched with multiple entry
+  // points are skipped as they must remain compatible with each other.
+  DenseMap<Attribute, SmallVector<IREE::Flow::DispatchOp>> exportDispatchOps;
+  DenseSet<Attribute> excludedExecutables;
+  moduleOp.walk([&](IREE::Flow::DispatchOp dispatchOp) {
+    auto entryPointRefs = llvm::to_vector(dispatchOp.getEntryPointRefs());
+    if (entryPointRefs.size() != 1) {
+      for (auto entryPointRef : entryPointRefs) {
+        excludedExecutables.insert(entryPointRef.getRootReference());
+      }
+      return;
+    }
+    exportDispatchOps[entryPointRefs.front()].push_back(dispatchOp);
+  });
+
+  // Bucket candidates by their function type and number of constants as
+  // these must match for executables to be merged.
+  llvm::MapVector<std::pair<Type, size_t>, SmallVector<ConstantMergeCandidate>>
+      buckets;
+  for (auto executableOp : moduleOp.getOps<IREE::Flow::ExecutableOp>()) {
+    if (excludedExecutables.contains(executableOp.getSymNameAttr()))
+      continue;
+    auto candidate = getConstantMergeCandidate(executableOp);
+    if (!candidate)
+      continue;
+    buckets[{candidate->funcOp.getFunctionType(),
+             candidate->constantOps.size()}]
+        .push_back(std::move(*candidate));
+  }
+
+  int mergedCount = 0;
+  for (auto &[key, candidates] : buckets) {
+    (void)key;
+    // Greedily group each candidate with the first reference it matches.
+    struct MergeGroup {
+      ConstantMergeCandidate *reference;
+      SmallVector<ConstantMergeCandidate *> members;
+      SmallVector<unsigned> positions;
+    };
+    SmallVector<MergeGroup> groups;
+    for (auto &candidate : candidates) {
+      bool didMatch = false;
+      for (auto &group : groups) {
+        auto positions = matchModuloConstants(*group.reference, candidate);
+        if (!positions)
+          continue;
+        SmallVector<unsigned> mergedPositions;
+        std::set_union(group.positions.begin(), group.positions.end(),
+                       positions->begin(), positions->end(),
+                       std::back_inserter(mergedPositions));
+        if (static_cast<int64_t>(mergedPositions.size()) >
+            kMaxOutlinedConstants) {
+          continue;
+        }
+        group.members.push_back(&candidate);
+        group.positions = std::move(mergedPositions);
+        didMatch = true;
+        break;
+      }
+      if (!didMatch) {
+        groups.push_back({&candidate, {}, {}});
+      }
+    }
+
+    for (auto &group : groups) {
+      if (group.members.empty())
+        continue;
+      ConstantMergeCandidate &reference = *group.reference;
+      LLVM_DEBUG(llvm::dbgs()
+                 << "merging " << group.members.size()
+                 << " executable(s) into @" << reference.executableOp.getName()
+                 << " by outlining " << group.positions.size()
+                 << " constant(s)\n");
+
+      // Pass the original constant values at every dispatch site.
+      auto referenceExportRef = SymbolRefAttr::get(
+          reference.executableOp.getSymNameAttr(),
+          {FlatSymbolRefAttr::get(reference.exportOp.getSymNameAttr())});
+      auto updateDispatchOps = [&](ConstantMergeCandidate &candidate) {
+        auto exportRef = SymbolRefAttr::get(
+            candidate.executableOp.getSymNameAttr(),
+            {FlatSymbolRefAttr::get(candidate.exportOp.getSymNameAttr())});
+        for (auto dispatchOp : exportDispatchOps[exportRef]) {
+          OpBuilder builder(dispatchOp);
+          SmallVector<Value> constantValues;
+          for (unsigned position : group.positions) {
+            auto constantOp = candidate.constantOps[position];
+            constantValues.push_back(builder.create<arith::ConstantOp>(
+                dispatchOp.getLoc(), constantOp.getValue()));
+          }
+          dispatchOp.getArgumentsMutable().append(constantValues);
+          dispatchOp.setEntryPointsAttr(
+              builder.getArrayAttr({referenceExportRef}));
+        }
+      };
+      for (auto *member : group.members) {
+        updateDispatchOps(*member);
+      }
+      updateDispatchOps(reference);
+      outlineConstants(reference, group.positions);
+      outlinedConstantCount += group.positions.size();
+
+      for (auto *member : group.members) {
+        member->executableOp.erase();
+      }
+      mergedCount += group.members.size();
+    }
+  }
+  return mergedCount;
+}
+
 } // namespace
 
 class DeduplicateExecutablesPass
     : public IREE::Flow::impl::DeduplicateExecutablesPassBase<
           DeduplicateExecutablesPass> {
+public:
+  using IREE::Flow::impl::DeduplicateExecutablesPassBase<
+      DeduplicateExecutablesPass>::DeduplicateExecutablesPassBase;
 
   void runOnOperation() override {
     auto moduleOp = getOperation();
@@ -158,28 +398,63 @@ class DeduplicateExecutablesPass
     }
     if (allObjects.empty())
       return;
-    (void)deduplicateObjects(moduleOp, allObjects);
-    // totalObjects = allObjects.size();
-    // objectsDeduplicated = deduplicateObjects(moduleOp, allObjects);
-    // remainingObjects = totalObjects - objectsDeduplicated;
+    int64_t opCountBefore = countOps(moduleOp);
+    int deduplicatedCount = deduplicateObjects(moduleOp, allObjects);
+    int mergedCount = 0;
+    int64_t outlinedConstantCount = 0;
+    if (outlineConstants) {
+      mergedCount =
+          mergeExecutablesModuloConstants(moduleOp, outlinedConstantCount);
+    }
+    totalObjects = allObjects.size();
+    objectsDeduplicated = deduplicatedCount;
+    objectsMerged = mergedCount;
+    constantsOutlined = outlinedConstantCount;
+    remainingObjects = allObjects.size() - deduplicatedCount - mergedCount;
+    opsRemoved = opCountBefore - countOps(moduleOp);
   }
 
 private:
-  // Statistic totalObjects{
-  //     this,
-  //     "total object(s)",
-  //     "Number of object ops before deduplication",
-  // };
-  // Statistic objectsDeduplicated{
-  //     this,
-  //     "duplicate object(s)",
-  //     "Number of object ops removed as duplicates",
-  // };
-  // Statistic remainingObjects{
-  //     this,
-  //     "unique object(s)",
-  //     "Number of object ops remaining after deduplication",
-  // };
+  // Returns the number of ops nested within executables in |moduleOp| as an
+  // estimate of the size of the compiled executables.
+  static int64_t countOps(mlir::ModuleOp moduleOp) {
+    int64_t count = 0;
+    for (auto executableOp : moduleOp.getOps<IREE::Flow::ExecutableOp>()) {
+      executableOp.walk([&](Operation *) { ++count; });
+    }
+    return count;
+  }
+
+  Statistic totalObjects{
+      this,
+      "total object(s)",
+      "Number of object ops before deduplication",
+  };
+  Statistic objectsDeduplicated{
+      this,
+      "duplicate object(s)",
+      "Number of object ops removed as duplicates",
+  };
+  Statistic objectsMerged{
+      this,
+      "merged object(s)",
+      "Number of object ops merged by outlining differing constants",
+  };
+  Statistic constantsOutlined{
+      this,
+      "outlined constant(s)",
+      "Number of constants outlined into dispatch operands",
+  };
+  Statistic remainingObjects{
+      this,
+      "unique object(s)",
+      "Number of object ops remaining after deduplication",
+  };
+  Statistic opsRemoved{
+      this,
+      "executable op(s) removed",
+      "Number of ops within executables removed by deduplication",
+  };
 };
 
 } // namespace mlir::iree_compiler::IREE::Flow
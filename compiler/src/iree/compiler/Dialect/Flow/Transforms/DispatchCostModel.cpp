@@ -0,0 +1,227 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Flow/Transforms/DispatchCostModel.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+#include "iree/compiler/Dialect/Flow/Transforms/RegionOpUtils.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
+#include "mlir/IR/BuiltinTypes.h"
+
+namespace mlir::iree_compiler::IREE::Flow {
+
+/// Extent assumed for dynamic dimensions when estimating sizes. Only relative
+/// costs matter so any moderately large value works.
+static constexpr int64_t kDynamicDimEstimate = 128;
+
+/// Fraction of the time of separate dispatches the dispatch overhead must
+/// account for before independent dispatches are merged.
+static constexpr double kHorizontalFusionMinSavings = 0.1;
+
+static int64_t getEstimatedExtent(int64_t extent) {
+  return ShapedType::isDynamic(extent) ? kDynamicDimEstimate : extent;
+}
+
+static int64_t getEstimatedElementCount(ArrayRef<int64_t> shape) {
+  int64_t count = 1;
+  for (int64_t extent : shape) {
+    count *= getEstimatedExtent(extent);
+  }
+  return count;
+}
+
+static int64_t getEstimatedByteSize(Type type) {
+  auto tensorType = dyn_cast<RankedTensorType>(type);
+  if (!tensorType)
+    return 0;
+  return getEstimatedElementCount(tensorType.getShape()) *
+         IREE::Util::getRoundedElementByteWidth(tensorType.getElementType());
+}
+
+/// Returns the estimated arithmetic ops and parallel iterations of |op|.
+static std::pair<int64_t, int64_t> estimateOpWork(Operation *op) {
+  if (auto linalgOp = dyn_cast<linalg::LinalgOp>(op)) {
+    int64_t iterationCount = 1;
+    int64_t parallelCount = 1;
+    for (auto [extent, iteratorType] :
+         llvm::zip_equal(linalgOp.getStaticLoopRanges(),
+                         linalgOp.getIteratorTypesArray())) {
+      iterationCount *= getEstimatedExtent(extent);
+      if (iteratorType == utils::IteratorType::parallel) {
+        parallelCount *= getEstimatedExtent(extent);
+      }
+    }
+    // Every body op other than the terminator is assumed to be one scalar op.
+    int64_t bodyOpCount = std::max<int64_t>(
+        1, linalgOp.getBlock()->getOperations().size() - 1);
+    return {iterationCount * bodyOpCount, parallelCount};
+  }
+  // Data movement ops (pack, pad, etc) perform roughly one op per element.
+  int64_t elementCount = 0;
+  for (Type resultType : op->getResultTypes()) {
+    if (auto shapedType = dyn_cast<ShapedType>(resultType)) {
+      elementCount += getEstimatedElementCount(shapedType.getShape());
+    }
+  }
+  return {elementCount, std::max<int64_t>(1, elementCount)};
+}
+
+DispatchCostEstimate
+DispatchCostModel::estimate(ArrayRef<Operation *> ops) const {
+  DispatchCostEstimate estimate;
+  estimate.parallelism = std::numeric_limits<int64_t>::max();
+  llvm::SmallPtrSet<Operation *, 8> opSet(ops.begin(), ops.end());
+  llvm::SmallPtrSet<Value, 8> readValues;
+  for (Operation *op : ops) {
+    for (Value operand : op->getOperands()) {
+      Operation *producer = operand.getDefiningOp();
+      if (producer && (opSet.contains(producer) ||
+                       isClonableIntoDispatchOp(producer))) {
+        continue;
+      }
+      if (readValues.insert(operand).second) {
+        estimate.bytesRead += getEstimatedByteSize(operand.getType());
+      }
+    }
+    for (Value result : op->getResults()) {
+      if (llvm::any_of(result.getUsers(), [&](Operation *user) {
+            return !opSet.contains(user);
+          })) {
+        estimate.bytesWritten += getEstimatedByteSize(result.getType());
+      }
+    }
+    auto [arithmeticOps, parallelism] = estimateOpWork(op);
+    estimate.arithmeticOps += arithmeticOps;
+    estimate.parallelism = std::min(estimate.parallelism, parallelism);
+  }
+  if (ops.empty()) {
+    estimate.parallelism = 1;
+  }
+  return estimate;
+}
+
+double
+DispatchCostModel::estimateCycles(const DispatchCostEstimate &estimate) const {
+  double memoryCycles =
+      (estimate.bytesRead + estimate.bytesWritten) / bytesPerCycle;
+  double utilization = std::min(
+      1.0, static_cast<double>(estimate.parallelism) / parallelUnits);
+  double computeCycles = estimate.arithmeticOps / (opsPerCycle * utilization);
+  return std::max(memoryCycles, computeCycles) + dispatchOverheadCycles;
+}
+
+bool DispatchCostModel::isProfitableToFuse(ArrayRef<Operation *> group,
+                                           Operation *candidate,
+                                           std::string *reason) const {
+  SmallVector<Operation *> fusedOps(group);
+  fusedOps.push_back(candidate);
+  DispatchCostEstimate fused = estimate(fusedOps);
+  DispatchCostEstimate groupOnly = estimate(group);
+  DispatchCostEstimate candidateOnly = estimate({candidate});
+  double fusedCycles = estimateCycles(fused);
+  double separateCycles =
+      estimateCycles(groupOnly) + estimateCycles(candidateOnly);
+  bool isProfitable = fusedCycles < separateCycles;
+  if (reason) {
+    int64_t separateBytes = groupOnly.bytesRead + groupOnly.bytesWritten +
+                            candidateOnly.bytesRead +
+                            candidateOnly.bytesWritten;
+    *reason = llvm::formatv(
+        "fused {0:F0} cycles vs separate {1:F0} cycles; {2} bytes of memory "
+        "traffic saved; parallelism {3} vs {4}",
+        fusedCycles, separateCycles,
+        separateBytes - (fused.bytesRead + fused.bytesWritten),
+        fused.parallelism,
+        std::max(groupOnly.parallelism, candidateOnly.parallelism));
+  }
+  return isProfitable;
+}
+
+bool DispatchCostModel::isProfitableToFuseHorizontally(
+    ArrayRef<Operation *> lhs, ArrayRef<Operation *> rhs,
+    std::string *reason) const {
+  SmallVector<Operation *> fusedOps(lhs);
+  fusedOps.append(rhs.begin(), rhs.end());
+  DispatchCostEstimate fused = estimate(fusedOps);
+  DispatchCostEstimate lhsOnly = estimate(lhs);
+  DispatchCostEstimate rhsOnly = estimate(rhs);
+  double fusedCycles = estimateCycles(fused);
+  double separateCycles = estimateCycles(lhsOnly) + estimateCycles(rhsOnly);
+  int64_t sharedBytes = lhsOnly.bytesRead + rhsOnly.bytesRead - fused.bytesRead;
+  bool isProfitable =
+      fusedCycles < separateCycles &&
+      (sharedBytes > 0 || separateCycles - fusedCycles >=
+                              kHorizontalFusionMinSavings * separateCycles);
+  if (reason) {
+    *reason = llvm::formatv("fused {0:F0} cycles vs separate {1:F0} cycles; "
+                            "{2} bytes of shared inputs",
+                            fusedCycles, separateCycles, sharedBytes);
+  }
+  return isProfitable;
+}
+
+//===----------------------------------------------------------------------===//
+// Registry
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct DispatchCostModelRegistry {
+  DispatchCostModelRegistry() {
+    // A multi-core CPU with ~50GB/s of bandwidth and SIMD across 8 cores.
+    DispatchCostModel cpuModel;
+    cpuModel.name = "cpu";
+    cpuModel.bytesPerCycle = 16.0;
+    cpuModel.opsPerCycle = 128.0;
+    cpuModel.parallelUnits = 1024;
+    cpuModel.dispatchOverheadCycles = 10000.0;
+    models[cpuModel.name] = cpuModel;
+
+    // A discrete GPU with ~1TB/s of bandwidth that needs large grids to
+    // saturate and has a higher launch overhead relative to its throughput.
+    DispatchCostModel gpuModel;
+    gpuModel.name = "gpu";
+    gpuModel.bytesPerCycle = 512.0;
+    gpuModel.opsPerCycle = 16384.0;
+    gpuModel.parallelUnits = 65536;
+    gpuModel.dispatchOverheadCycles = 5000.0;
+    models[gpuModel.name] = gpuModel;
+  }
+
+  std::mutex mutex;
+  llvm::StringMap<DispatchCostModel> models;
+};
+
+} // namespace
+
+static DispatchCostModelRegistry &getRegistry() {
+  static DispatchCostModelRegistry registry;
+  return registry;
+}
+
+void registerDispatchCostModel(DispatchCostModel model) {
+  auto &registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::string name = model.name;
+  registry.models[name] = std::move(model);
+}
+
+const DispatchCostModel *lookupDispatchCostModel(StringRef name) {
+  auto &registry = getRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  auto it = registry.models.find(name);
+  return it == registry.models.end() ? nullptr : &it->second;
+}
+
+} // namespace mlir::iree_compiler::IREE::Flow
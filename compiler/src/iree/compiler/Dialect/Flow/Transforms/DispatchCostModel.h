@@ -0,0 +1,84 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_FLOW_TRANSFORMS_DISPATCHCOSTMODEL_H_
+#define IREE_COMPILER_DIALECT_FLOW_TRANSFORMS_DISPATCHCOSTMODEL_H_
+
+#include <string>
+
+#include "mlir/IR/Operation.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir::iree_compiler::IREE::Flow {
+
+/// Estimated work performed by a candidate dispatch containing a set of ops.
+struct DispatchCostEstimate {
+  /// Bytes of tensors produced outside of the dispatch that are read by it.
+  int64_t bytesRead = 0;
+  /// Bytes of tensors produced by the dispatch that are used outside of it.
+  int64_t bytesWritten = 0;
+  /// Scalar arithmetic operations performed across the whole iteration space.
+  int64_t arithmeticOps = 0;
+  /// Number of independent parallel iterations the dispatch can be
+  /// distributed across. The dispatch is tiled along the outer parallel loops
+  /// shared by all of its ops so this is the minimum across the ops.
+  int64_t parallelism = 1;
+};
+
+/// Analytic roofline-style cost model used to decide whether fusing ops into
+/// the same dispatch is profitable. A dispatch is estimated to run for the
+/// maximum of its memory and compute time plus a fixed dispatch overhead, with
+/// compute throughput scaled down when the dispatch cannot occupy the device.
+///
+/// Models are registered by name so that target backends and plugins can
+/// provide parameters matching their devices; "cpu" and "gpu" are always
+/// available with rough parameters for a typical multi-core CPU and discrete
+/// GPU. Only ratios between the parameters matter and units are cycles.
+struct DispatchCostModel {
+  /// Name used to select the model.
+  std::string name;
+  /// Sustained memory bandwidth in bytes per cycle.
+  double bytesPerCycle = 1.0;
+  /// Peak arithmetic throughput in scalar ops per cycle.
+  double opsPerCycle = 1.0;
+  /// Parallel iterations required to fully occupy the device.
+  int64_t parallelUnits = 1;
+  /// Fixed cost of launching a dispatch.
+  double dispatchOverheadCycles = 0.0;
+
+  /// Estimates the work of a dispatch formed from |ops|. Tensors that flow
+  /// between ops in |ops| are assumed to never be materialized in memory.
+  DispatchCostEstimate estimate(ArrayRef<Operation *> ops) const;
+
+  /// Returns the estimated execution time of a dispatch in cycles.
+  double estimateCycles(const DispatchCostEstimate &estimate) const;
+
+  /// Returns true if adding |candidate| to the dispatch formed from |group| is
+  /// estimated to be faster than dispatching |candidate| on its own. When
+  /// provided |reason| is set to a human-readable explanation of the decision.
+  bool isProfitableToFuse(ArrayRef<Operation *> group, Operation *candidate,
+                          std::string *reason = nullptr) const;
+
+  /// Returns true if the independent |lhs| and |rhs| dispatches should be
+  /// merged into a single dispatch. Merging always saves a dispatch overhead
+  /// so this is only considered profitable when the saving is a significant
+  /// fraction of the time of the separate dispatches (that is, for small ops)
+  /// or when the dispatches read shared inputs.
+  bool isProfitableToFuseHorizontally(ArrayRef<Operation *> lhs,
+                                      ArrayRef<Operation *> rhs,
+                                      std::string *reason = nullptr) const;
+};
+
+/// Registers |model| so that it can be selected by name. Replaces any
+/// previously registered model with the same name.
+void registerDispatchCostModel(DispatchCostModel model);
+
+/// Returns the registered model named |name| or nullptr if none is registered.
+const DispatchCostModel *lookupDispatchCostModel(StringRef name);
+
+} // namespace mlir::iree_compiler::IREE::Flow
+
+#endif // IREE_COMPILER_DIALECT_FLOW_TRANSFORMS_DISPATCHCOSTMODEL_H_
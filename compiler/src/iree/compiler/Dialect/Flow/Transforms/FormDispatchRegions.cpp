@@ -10,6 +10,7 @@
 #include "iree/compiler/Dialect/Flow/IR/FlowDialect.h"
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "iree/compiler/Dialect/Flow/Transforms/ConvertRegionToWorkgroups.h"
+#include "iree/compiler/Dialect/Flow/Transforms/DispatchCostModel.h"
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
 #include "iree/compiler/Dialect/Flow/Transforms/RegionOpUtils.h"
 #include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtDialect.h"
@@ -19,6 +20,7 @@
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Casting.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "mlir/Analysis/TopologicalSortUtils.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
@@ -171,6 +173,93 @@ static void removeFusionGroupsAttribute(Operation *op) {
   op->removeAttr(kFusionGroupsAttr);
 }
 
+//===----------------------------------------------------------------------===//
+// Cost model driven fusion
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+/// Tracks the ops in each fusion group so that fusion decisions can be checked
+/// against a DispatchCostModel. The heuristics below decide which fusions are
+/// legal (supported by the backends) and the model decides which of those are
+/// profitable. Remarks are emitted explaining each decision.
+class FusionCostTracker {
+public:
+  explicit FusionCostTracker(const DispatchCostModel &model) : model(model) {}
+
+  const DispatchCostModel &getModel() const { return model; }
+
+  /// Records |op| as a member of fusion group |groupNum|.
+  void addToGroup(int64_t groupNum, Operation *op) {
+    groups[groupNum].push_back(op);
+  }
+
+  /// Returns the ops in fusion group |groupNum|.
+  ArrayRef<Operation *> getGroup(int64_t groupNum) const {
+    auto it = groups.find(groupNum);
+    return it == groups.end() ? ArrayRef<Operation *>{} : it->second;
+  }
+
+  /// Replaces the ops of fusion group |groupNum| with |op| and drops the
+  /// group |mergedGroupNum| that was merged into it.
+  void mergeGroups(int64_t groupNum, int64_t mergedGroupNum, Operation *op,
+                   StringRef reason) {
+    groups[groupNum] = {op};
+    groups.erase(mergedGroupNum);
+    reasons[groupNum].push_back({op->getLoc(), reason.str()});
+  }
+
+  /// Returns true if fusing |candidate| into fusion group |groupNum| is
+  /// estimated to be profitable. Rejected candidates get a remark.
+  bool shouldFuse(int64_t groupNum, Operation *candidate) {
+    std::string reason;
+    if (model.isProfitableToFuse(getGroup(groupNum), candidate, &reason)) {
+      reasons[groupNum].push_back(
+          {candidate->getLoc(),
+           llvm::formatv("fused '{0}': {1}",
+                         candidate->getName().getStringRef(), reason)
+               .str()});
+      return true;
+    }
+    candidate->emitRemark()
+        << "not fused into the dispatch of fusion group " << groupNum
+        << " by cost model '" << model.name << "': " << reason;
+    return false;
+  }
+
+  /// Emits a remark on |regionOp| formed from fusion group |groupNum|
+  /// describing its estimated cost and why its ops were fused.
+  void emitRegionRemark(IREE::Flow::DispatchRegionOp regionOp,
+                        int64_t groupNum) const {
+    SmallVector<Operation *> ops;
+    for (Operation &op : regionOp.getBody().front().without_terminator()) {
+      ops.push_back(&op);
+    }
+    DispatchCostEstimate estimate = model.estimate(ops);
+    auto remark = regionOp.emitRemark();
+    remark << "formed dispatch region with " << ops.size()
+           << " op(s) by cost model '" << model.name << "': "
+           << estimate.bytesRead << " bytes read, " << estimate.bytesWritten
+           << " bytes written, " << estimate.arithmeticOps
+           << " arithmetic ops, parallelism " << estimate.parallelism << ", "
+           << llvm::formatv("{0:F0}", model.estimateCycles(estimate))
+           << " cycles";
+    auto it = reasons.find(groupNum);
+    if (it == reasons.end())
+      return;
+    for (auto &[loc, reason] : it->second) {
+      remark.attachNote(loc) << reason;
+    }
+  }
+
+private:
+  const DispatchCostModel &model;
+  DenseMap<int64_t, SmallVector<Operation *>> groups;
+  DenseMap<int64_t, SmallVector<std::pair<Location, std::string>>> reasons;
+};
+
+} // namespace
+
 //===----------------------------------------------------------------------===//
 // Op property charecterizations
 //===----------------------------------------------------------------------===//
@@ -676,10 +765,12 @@ isFusableWithConsumer(OpOperand &fusedOperand,
 
 /// Fuses roots with its consumers. If a root is fused with its consumer, it is
 /// no more tagged as a root to aid with the dispatch region formation.
+/// If |costTracker| is provided only profitable fusions are performed.
 static void
 fuseRootsWithConsumers(MLIRContext *context, ArrayRef<Operation *> roots,
                        DominanceInfo const &dominanceInfo,
-                       FormDispatchRegionsPassOptions const &options) {
+                       FormDispatchRegionsPassOptions const &options,
+                       FusionCostTracker *costTracker) {
   // Fuse with consumers where possible.
   for (Operation *root : roots) {
     SmallVector<Operation *> workList;
@@ -714,6 +805,12 @@ fuseRootsWithConsumers(MLIRContext *context, ArrayRef<Operation *> roots,
 
       if (isFusableWithConsumer(*(fusableUse.value()), rootOuterParallelLoops,
                                 options)) {
+        int64_t rootNumber = getRootNumber(currRoot);
+        if (costTracker) {
+          if (!costTracker->shouldFuse(rootNumber, consumerOp))
+            continue;
+          costTracker->addToGroup(rootNumber, consumerOp);
+        }
         updateRootTo(consumerOp);
         workList.push_back(consumerOp);
       }
@@ -780,10 +877,12 @@ isFusableWithProducer(OpOperand &operand,
 
 /// Starting from the `root` op, traverse the operand use-def chain
 /// in reverse to fuse with producers.
+/// If |costTracker| is provided only profitable fusions are performed.
 static void
 fuseRootsWithProducers(MLIRContext *context, Operation *root, unsigned groupNum,
                        DominanceInfo const &dominanceInfo,
-                       FormDispatchRegionsPassOptions const &options) {
+                       FormDispatchRegionsPassOptions const &options,
+                       FusionCostTracker *costTracker) {
   SmallVector<Operation *> worklist;
   worklist.push_back(root);
   llvm::SmallBitVector rootOuterParallelLoops = getOuterParallelLoops(root);
@@ -807,6 +906,11 @@ fuseRootsWithProducers(MLIRContext *context, Operation *root, unsigned groupNum,
       if (!isFusableWithProducer(operand, rootOuterParallelLoops, options)) {
         continue;
       }
+      if (costTracker) {
+        if (!costTracker->shouldFuse(groupNum, producer))
+          continue;
+        costTracker->addToGroup(groupNum, producer);
+      }
 
       appendToFusionGroup(producer, groupNum);
       worklist.push_back(producer);
@@ -825,6 +929,7 @@ fuseRootsWithProducers(MLIRContext *context, Operation *root, unsigned groupNum,
 static unsigned
 decideFusableLinalgOps(Region &region, DominanceInfo const &dominanceInfo,
                        FormDispatchRegionsPassOptions const &options,
+                       FusionCostTracker *costTracker,
                        unsigned numRootOps = 0) {
   MLIRContext *context = region.getContext();
   OpBuilder builder(context);
@@ -839,7 +944,7 @@ decideFusableLinalgOps(Region &region, DominanceInfo const &dominanceInfo,
       if (isa<scf::SCFDialect>(op.getDialect())) {
         for (auto &region : op.getRegions()) {
           numRootOps = decideFusableLinalgOps(region, dominanceInfo, options,
-                                              numRootOps);
+                                              costTracker, numRootOps);
         }
         continue;
       }
@@ -849,12 +954,17 @@ decideFusableLinalgOps(Region &region, DominanceInfo const &dominanceInfo,
         continue;
       unsigned newGroup = numRootOps++;
       setRootAttribute(context, &op, newGroup);
+      if (costTracker) {
+        costTracker->addToGroup(newGroup, &op);
+      }
 
-      fuseRootsWithProducers(context, &op, newGroup, dominanceInfo, options);
+      fuseRootsWithProducers(context, &op, newGroup, dominanceInfo, options,
+                             costTracker);
       roots.push_back(&op);
     }
     roots = llvm::to_vector(llvm::reverse(roots));
-    fuseRootsWithConsumers(context, roots, dominanceInfo, options);
+    fuseRootsWithConsumers(context, roots, dominanceInfo, options,
+                           costTracker);
   }
 
   // Once all root linalg ops have been tagged, put all remaining generic ops
@@ -878,31 +988,126 @@ decideFusableLinalgOps(Region &region, DominanceInfo const &dominanceInfo,
 
       unsigned newGroup = numRootOps++;
       setRootAttribute(context, &op, newGroup);
+      if (costTracker) {
+        costTracker->addToGroup(newGroup, &op);
+      }
 
-      fuseRootsWithProducers(context, &op, newGroup, dominanceInfo, options);
+      fuseRootsWithProducers(context, &op, newGroup, dominanceInfo, options,
+                             costTracker);
       roots.push_back(&op);
     }
     roots = llvm::to_vector(llvm::reverse(roots));
-    fuseRootsWithConsumers(context, roots, dominanceInfo, options);
+    fuseRootsWithConsumers(context, roots, dominanceInfo, options,
+                           costTracker);
   }
 
   return numRootOps;
 }
 
+//===----------------------------------------------------------------------===//
+// Horizontal fusion
+//===----------------------------------------------------------------------===//
+
+/// Maximum number of results of a horizontally fused op. Bounds the number of
+/// live values in the fused body.
+static constexpr int64_t kMaxHorizontalFusionResults = 8;
+
+/// Returns true if |op| would be dispatched on its own and can be merged with
+/// other independent ops with the same iteration space.
+static bool isHorizontalFusionCandidate(Operation *op) {
+  auto genericOp = dyn_cast<linalg::GenericOp>(op);
+  return genericOp && genericOp.hasPureTensorSemantics() &&
+         genericOp.getNumLoops() == genericOp.getNumParallelLoops() &&
+         !genericOp.hasDynamicShape() && !hasFusionGroupsAttribute(op);
+}
+
+/// Returns true if |first| and the later |second| can be merged into a single
+/// op placed at |second|. This requires all uses of |first| to be after
+/// |second|, which also guarantees that |second| does not depend on |first|.
+static bool canFuseHorizontally(linalg::GenericOp first,
+                                linalg::GenericOp second) {
+  if (first->getBlock() != second->getBlock() ||
+      first.getStaticLoopRanges() != second.getStaticLoopRanges() ||
+      first->getNumResults() + second->getNumResults() >
+          kMaxHorizontalFusionResults) {
+    return false;
+  }
+  Block *block = second->getBlock();
+  return llvm::all_of(first->getUsers(), [&](Operation *user) {
+    Operation *ancestor = block->findAncestorOpInBlock(*user);
+    return ancestor && second->isBeforeInBlock(ancestor);
+  });
+}
+
+/// Merges independent ops that would otherwise each form their own dispatch
+/// when |costTracker| estimates that doing so is profitable. The merged op
+/// takes the fusion group of the earlier op and the group of the later op is
+/// left without a root.
+static void fuseIndependentOpsHorizontally(RewriterBase &rewriter,
+                                           mlir::FunctionOpInterface funcOp,
+                                           FusionCostTracker &costTracker) {
+  MLIRContext *context = funcOp.getContext();
+  SmallVector<Block *> blocks;
+  funcOp.walk([&](Block *block) { blocks.push_back(block); });
+  for (Block *block : blocks) {
+    // Fused ops of each fusion group that may still be merged with later ops.
+    SmallVector<std::pair<int64_t, linalg::GenericOp>> fusedOps;
+    for (Operation &op : llvm::make_early_inc_range(*block)) {
+      if (!hasRootOpAttribute(&op) || !isHorizontalFusionCandidate(&op))
+        continue;
+      int64_t groupNum = getRootNumber(&op);
+      if (costTracker.getGroup(groupNum).size() != 1)
+        continue;
+      auto genericOp = cast<linalg::GenericOp>(op);
+      bool didFuse = false;
+      for (auto &[fusedGroupNum, fusedOp] : llvm::reverse(fusedOps)) {
+        if (!canFuseHorizontally(fusedOp, genericOp))
+          continue;
+        std::string reason;
+        if (!costTracker.getModel().isProfitableToFuseHorizontally(
+                costTracker.getGroup(fusedGroupNum), {&op}, &reason)) {
+          op.emitRemark() << "not fused horizontally with the dispatch of "
+                             "fusion group "
+                          << fusedGroupNum << " by cost model '"
+                          << costTracker.getModel().name << "': " << reason;
+          continue;
+        }
+        auto newOp = fuseGenericOpsHorizontally(rewriter, fusedOp, genericOp);
+        setRootAttribute(context, newOp, fusedGroupNum);
+        costTracker.mergeGroups(fusedGroupNum, groupNum, newOp,
+                                "fused horizontally with independent op: " +
+                                    reason);
+        fusedOp = newOp;
+        didFuse = true;
+        break;
+      }
+      if (!didFuse) {
+        fusedOps.push_back({groupNum, genericOp});
+      }
+    }
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // Dispatch region formation
 //===----------------------------------------------------------------------===//
 
 /// Create IREE::Flow::DispatchGroupsOps based on a fusion heuristic.
+/// If |costTracker| is provided it is used to only perform profitable fusions
+/// and to merge independent small ops.
 static LogicalResult
 createFusionGroups(TensorDimTrackingRewriter &rewriter,
                    mlir::FunctionOpInterface funcOp,
                    DominanceInfo const &dominanceInfo,
-                   FormDispatchRegionsPassOptions const &options) {
+                   FormDispatchRegionsPassOptions const &options,
+                   FusionCostTracker *costTracker) {
   // Step 1: Decide fusion groups (heuristic). This marks rootOps with an
   // attribute
-  unsigned numRoots =
-      decideFusableLinalgOps(funcOp.getFunctionBody(), dominanceInfo, options);
+  unsigned numRoots = decideFusableLinalgOps(
+      funcOp.getFunctionBody(), dominanceInfo, options, costTracker);
+  if (costTracker) {
+    fuseIndependentOpsHorizontally(rewriter, funcOp, *costTracker);
+  }
   SmallVector<Operation *> roots(numRoots, nullptr);
   DenseMap<unsigned, SmallVector<Operation *>> producers;
 
@@ -930,6 +1135,11 @@ createFusionGroups(TensorDimTrackingRewriter &rewriter,
   OpBuilder::InsertionGuard g(rewriter);
   SmallVector<IREE::Flow::DispatchRegionOp> regionOps;
   for (const auto &it : llvm::enumerate(roots)) {
+    // Roots of fusion groups merged into others during horizontal fusion are
+    // left empty.
+    if (!it.value())
+      continue;
+
     // Simplify tensor::DimOps.
     {
       SmallVector<tensor::DimOp> dimOps = rewriter.getTensorDimOps();
@@ -975,6 +1185,9 @@ createFusionGroups(TensorDimTrackingRewriter &rewriter,
         return failure();
       }
     }
+    if (costTracker) {
+      costTracker->emitRegionRemark(regionOp, it.index());
+    }
     regionOps.push_back(regionOp);
   }
 
@@ -1004,8 +1217,19 @@ void FormDispatchRegionsPass::runOnOperation() {
   DominanceInfo const &dominanceInfo = getAnalysis<DominanceInfo>();
   TensorDimTrackingRewriter rewriter(funcOp);
   FormDispatchRegionsPassOptions options{aggressiveFusion, fusePadWithConsumers,
-                                         fusePadWithProducers};
-  if (failed(createFusionGroups(rewriter, funcOp, dominanceInfo, options))) {
+                                         fusePadWithProducers, costModel};
+  std::optional<FusionCostTracker> costTracker;
+  if (!costModel.empty()) {
+    const DispatchCostModel *model = lookupDispatchCostModel(costModel);
+    if (!model) {
+      funcOp->emitOpError("unknown dispatch formation cost model '")
+          << costModel << "'";
+      return signalPassFailure();
+    }
+    costTracker.emplace(*model);
+  }
+  if (failed(createFusionGroups(rewriter, funcOp, dominanceInfo, options,
+                                costTracker ? &*costTracker : nullptr))) {
     funcOp->emitOpError("failed to create fusion groups");
     return signalPassFailure();
   }
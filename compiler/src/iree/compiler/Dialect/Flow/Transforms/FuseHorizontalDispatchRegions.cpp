@@ -0,0 +1,165 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Flow/Transforms/RegionOpUtils.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+
+#define DEBUG_TYPE "iree-flow-fuse-horizontal-dispatch-regions"
+
+namespace mlir::iree_compiler::IREE::Flow {
+
+#define GEN_PASS_DEF_FUSEHORIZONTALDISPATCHREGIONSPASS
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h.inc"
+
+namespace {
+
+/// A dispatch region that may be merged with later regions.
+struct FusionCandidate {
+  DispatchRegionOp regionOp;
+  linalg::GenericOp rootOp;
+};
+
+} // namespace
+
+/// Maximum number of results of a fused dispatch region. Bounds the number of
+/// live values in the fused body and the number of dispatch bindings.
+static constexpr int64_t kMaxFusedResults = 8;
+
+/// Returns the op producing all results of |regionOp| when the region can be
+/// merged with other independent regions: the op must be a static, fully
+/// parallel linalg.generic whose results are exactly the region results so
+/// that the workgroups distributing it can also distribute the merged op.
+static linalg::GenericOp getHorizontalFusionRoot(DispatchRegionOp regionOp) {
+  if (!regionOp.getWorkload().empty() ||
+      !regionOp.getWorkgroupCount().empty() ||
+      !regionOp.getResultDims().empty() || regionOp->getNumResults() == 0) {
+    return {};
+  }
+  auto returnOp =
+      cast<IREE::Flow::ReturnOp>(regionOp.getBody().front().getTerminator());
+  auto genericOp = returnOp.getOperand(0).getDefiningOp<linalg::GenericOp>();
+  if (!genericOp || genericOp->getBlock() != returnOp->getBlock() ||
+      !llvm::equal(genericOp->getResults(), returnOp.getOperands())) {
+    return {};
+  }
+  if (!genericOp.hasPureTensorSemantics() ||
+      genericOp.getNumLoops() != genericOp.getNumParallelLoops() ||
+      genericOp.hasDynamicShape()) {
+    return {};
+  }
+  return genericOp;
+}
+
+/// Returns true if the region of |first| can be merged into the region of
+/// the later |second| at the position of |second|. This requires all uses of
+/// |first| to be after |second|, which also guarantees that |second| does not
+/// depend on |first|.
+static bool canFuseHorizontally(const FusionCandidate &first,
+                                const FusionCandidate &second) {
+  if (first.regionOp->getBlock() != second.regionOp->getBlock() ||
+      first.rootOp.getStaticLoopRanges() !=
+          second.rootOp.getStaticLoopRanges() ||
+      first.regionOp->getNumResults() + second.regionOp->getNumResults() >
+          kMaxFusedResults) {
+    return false;
+  }
+  Block *block = second.regionOp->getBlock();
+  return llvm::all_of(first.regionOp->getUsers(), [&](Operation *user) {
+    Operation *ancestor = block->findAncestorOpInBlock(*user);
+    return ancestor && second.regionOp->isBeforeInBlock(ancestor);
+  });
+}
+
+/// Merges the regions of |first| and |second| into a single region at the
+/// position of |second| with a single root op computing the roots of both.
+static FusionCandidate fuseHorizontally(RewriterBase &rewriter,
+                                        const FusionCandidate &first,
+                                        const FusionCandidate &second) {
+  SmallVector<Type> resultTypes(first.regionOp->getResultTypes());
+  llvm::append_range(resultTypes, second.regionOp->getResultTypes());
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(second.regionOp);
+  Location loc = rewriter.getFusedLoc(
+      {first.regionOp.getLoc(), second.regionOp.getLoc()});
+  auto fusedRegionOp = rewriter.create<DispatchRegionOp>(
+      loc, resultTypes, /*dynamicDims=*/ValueRange(),
+      /*workload=*/ValueRange());
+  Block &fusedBody = fusedRegionOp.getBody().emplaceBlock();
+
+  // Move both bodies over and replace their terminators with a single one.
+  SmallVector<Value> returnedValues;
+  for (DispatchRegionOp regionOp : {first.regionOp, second.regionOp}) {
+    Block &body = regionOp.getBody().front();
+    Operation *returnOp = body.getTerminator();
+    llvm::append_range(returnedValues, returnOp->getOperands());
+    rewriter.eraseOp(returnOp);
+    rewriter.inlineBlockBefore(&body, &fusedBody, fusedBody.end());
+  }
+  rewriter.setInsertionPointToEnd(&fusedBody);
+  rewriter.create<IREE::Flow::ReturnOp>(loc, returnedValues);
+
+  int64_t firstResultCount = first.regionOp->getNumResults();
+  rewriter.replaceOp(first.regionOp,
+                     fusedRegionOp->getResults().take_front(firstResultCount));
+  rewriter.replaceOp(second.regionOp,
+                     fusedRegionOp->getResults().drop_front(firstResultCount));
+
+  // The only use of the first root is the terminator so the roots can be
+  // merged into a single op tiled and distributed across the same workgroups.
+  linalg::GenericOp fusedRootOp =
+      fuseGenericOpsHorizontally(rewriter, first.rootOp, second.rootOp);
+  return {fusedRegionOp, fusedRootOp};
+}
+
+namespace {
+
+struct FuseHorizontalDispatchRegionsPass
+    : public IREE::Flow::impl::FuseHorizontalDispatchRegionsPassBase<
+          FuseHorizontalDispatchRegionsPass> {
+  void runOnOperation() override {
+    mlir::FunctionOpInterface funcOp = getOperation();
+    IRRewriter rewriter(funcOp->getContext());
+
+    SmallVector<Block *> blocks;
+    funcOp.walk([&](Block *block) { blocks.push_back(block); });
+    for (Block *block : blocks) {
+      // Regions that may still be merged with later regions.
+      SmallVector<FusionCandidate> candidates;
+      for (auto regionOp : llvm::make_early_inc_range(
+               block->getOps<DispatchRegionOp>())) {
+        linalg::GenericOp rootOp = getHorizontalFusionRoot(regionOp);
+        if (!rootOp)
+          continue;
+        FusionCandidate candidate = {regionOp, rootOp};
+        bool didFuse = false;
+        for (FusionCandidate &fusedCandidate : llvm::reverse(candidates)) {
+          if (!canFuseHorizontally(fusedCandidate, candidate))
+            continue;
+          LLVM_DEBUG(llvm::dbgs() << "fusing horizontally:\n  "
+                                  << fusedCandidate.regionOp << "\n  "
+                                  << candidate.regionOp << "\n");
+          fusedCandidate =
+              fuseHorizontally(rewriter, fusedCandidate, candidate);
+          didFuse = true;
+          break;
+        }
+        if (!didFuse) {
+          candidates.push_back(candidate);
+        }
+      }
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::Flow
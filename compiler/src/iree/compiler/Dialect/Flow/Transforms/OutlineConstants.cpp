@@ -11,6 +11,7 @@
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Utils/StringUtils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/IR/Attributes.h"
@@ -26,11 +27,20 @@ namespace mlir::iree_compiler::IREE::Flow {
 
 namespace {
 
-// Returns true if |value| is worth outlining (large, etc).
-static bool isOutlinableValue(Attribute value) {
+// Returns true if |value| is worth outlining (large, etc). Elements smaller
+// than |minimumSize| bytes when serialized are left inline.
+static bool isOutlinableValue(Attribute value, int64_t minimumSize) {
   if (auto elementsAttr = llvm::dyn_cast<ElementsAttr>(value)) {
     // Don't outline splats - we want those fused.
-    return !elementsAttr.isSplat();
+    if (elementsAttr.isSplat())
+      return false;
+    if (minimumSize > 0) {
+      auto serializableAttr =
+          dyn_cast<IREE::Util::SerializableAttrInterface>(value);
+      return serializableAttr &&
+             serializableAttr.getStorageSize() >= minimumSize;
+    }
+    return true;
   } else if (isa<IREE::Flow::NamedParameterAttr>(value)) {
     // Always outline parameter constants.
     return true;
@@ -45,7 +55,8 @@ struct ConstantDef {
 };
 
 // Returns a list of all constant-like shaped data ops in the module.
-static SmallVector<ConstantDef> findConstantsInModule(mlir::ModuleOp moduleOp) {
+static SmallVector<ConstantDef> findConstantsInModule(mlir::ModuleOp moduleOp,
+                                                      int64_t minimumSize) {
   SmallVector<ConstantDef> results;
   for (auto callableOp : moduleOp.getOps<CallableOpInterface>()) {
     auto *region = callableOp.getCallableRegion();
@@ -53,7 +64,7 @@ static SmallVector<ConstantDef> findConstantsInModule(mlir::ModuleOp moduleOp) {
       continue;
     region->walk([&](Operation *op) {
       if (auto constantOp = dyn_cast<arith::ConstantOp>(op)) {
-        if (isOutlinableValue(constantOp.getValue())) {
+        if (isOutlinableValue(constantOp.getValue(), minimumSize)) {
           results.push_back(ConstantDef{
               constantOp,
               constantOp.getType(),
@@ -61,7 +72,7 @@ static SmallVector<ConstantDef> findConstantsInModule(mlir::ModuleOp moduleOp) {
           });
         }
       } else if (auto constantOp = dyn_cast<IREE::Flow::TensorConstantOp>(op)) {
-        if (isOutlinableValue(constantOp.getValue())) {
+        if (isOutlinableValue(constantOp.getValue(), minimumSize)) {
           results.push_back(ConstantDef{
               constantOp,
               constantOp.getType(),
@@ -113,6 +124,9 @@ static std::string getConstantName(ConstantDef &def) {
 
 struct OutlineConstantsPass
     : public IREE::Flow::impl::OutlineConstantsPassBase<OutlineConstantsPass> {
+  using IREE::Flow::impl::OutlineConstantsPassBase<
+      OutlineConstantsPass>::OutlineConstantsPassBase;
+
   void runOnOperation() override {
     auto moduleOp = getOperation();
     if (moduleOp.getBody()->empty())
@@ -122,7 +136,7 @@ struct OutlineConstantsPass
 
     // Create all top-level util.globals from constants in the module.
     std::vector<std::pair<Operation *, IREE::Util::GlobalOp>> replacements;
-    for (auto &def : findConstantsInModule(moduleOp)) {
+    for (auto &def : findConstantsInModule(moduleOp, minimumSize)) {
       // Position the global immediately preceding the top-level op that
       // contains the constant.
       OpBuilder moduleBuilder(&moduleOp.getBody()->front());
@@ -52,6 +52,21 @@ static llvm::cl::opt<std::string> clTraceDispatch(
                    "occurrences of the dispatch symbol."),
     llvm::cl::init(""));
 
+static llvm::cl::opt<bool> clDeduplicateOutlineConstants(
+    "iree-flow-deduplicate-outline-constants",
+    llvm::cl::desc("Merge executables that differ only in the values of "
+                   "scalar constants by outlining the constants into dispatch "
+                   "operands."),
+    llvm::cl::init(false));
+
+static llvm::cl::list<int64_t> clDispatchShapeBuckets(
+    "iree-flow-dispatch-shape-buckets",
+    llvm::cl::desc("Comma-separated static sizes of dynamic dimensions to "
+                   "specialize dispatches for. Each dispatch with a dynamic "
+                   "dimension selects a variant matching its runtime size or "
+                   "falls back to the dynamically shaped dispatch."),
+    llvm::cl::CommaSeparated);
+
 static llvm::cl::opt<bool> clDetensoring(
     "iree-flow-enable-detensoring",
     llvm::cl::desc(
@@ -88,6 +103,21 @@ static llvm::cl::opt<bool> clEnableElementWiseFuseMultiReduction(
     llvm::cl::desc("Enable element-wise fusion of multi-reduction loop ops."),
     llvm::cl::init(true));
 
+static llvm::cl::opt<std::string> clDispatchFormationCostModel(
+    "iree-flow-dispatch-formation-cost-model",
+    llvm::cl::desc(
+        "Name of the analytic cost model (`cpu` or `gpu`, or one registered "
+        "by a target backend plugin) used to drive dispatch region formation "
+        "fusion decisions. Remarks are emitted explaining each decision. "
+        "Uses the fixed fusion heuristics when empty."),
+    llvm::cl::init(""));
+
+static llvm::cl::opt<bool> clEnableHorizontalDispatchFusion(
+    "iree-flow-enable-horizontal-dispatch-fusion",
+    llvm::cl::desc("Merge independent dispatches of small elementwise ops "
+                   "with the same iteration space into a single dispatch."),
+    llvm::cl::init(false));
+
 static llvm::cl::opt<bool> clEnableAggressiveFusion(
     "iree-flow-enable-aggressive-fusion",
     llvm::cl::desc("Aggressive fusion opportunities that are behind a flag "
@@ -237,7 +267,8 @@ void addDispatchRegionCreationPasses(OpPassManager &passManager,
             FormDispatchRegionsPassOptions{
                 clEnableAggressiveFusion,
                 clEnableFusePaddingIntoLinalgConsumerOps,
-                clEnableFusePaddingIntoLinalgProducerOps});
+                clEnableFusePaddingIntoLinalgProducerOps,
+                clDispatchFormationCostModel});
       })
       // Clone all producers into the dispatch region to perpare for being
       // isolated from above. This enables running additional transformations
@@ -247,6 +278,10 @@ void addDispatchRegionCreationPasses(OpPassManager &passManager,
       .addPass(IREE::Flow::createCloneProducersIntoDispatchRegionsPass)
       // Collapse dimensions of linalg Ops.
       .addPass(IREE::Flow::createCollapseDimensionsPass)
+      // Merge independent dispatches after collapsing so that elementwise ops
+      // of different ranks but the same number of elements are compatible.
+      .addPredicatedPass(clEnableHorizontalDispatchFusion,
+                         IREE::Flow::createFuseHorizontalDispatchRegionsPass)
       // Convert dispatch regions into dispatch workgroups by capturing values.
       .addPass(IREE::Flow::createFormDispatchWorkgroupsPass);
 }
@@ -333,10 +368,23 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
   FunctionLikeNest(passManager).addPass(mlir::createCanonicalizerPass);
 
   // Deduplicate executables created from dispatch regions.
-  // Note: this only deduplicates equivalent executables. We could in addition
+  // Note: this only deduplicates equivalent executables and, when enabled,
+  // those that differ only in scalar constants. We could in addition
   // generalize executables to prune further (e.g. by promoting a dimension to
   // an argument if two executables differ only in that one dimension).
-  passManager.addPass(IREE::Flow::createDeduplicateExecutablesPass());
+  passManager.addPass(IREE::Flow::createDeduplicateExecutablesPass(
+      DeduplicateExecutablesPassOptions{clDeduplicateOutlineConstants}));
+
+  // Specialize dispatches for common sizes of their dynamic dimensions and
+  // fold the sizes into the specialized executables.
+  if (!clDispatchShapeBuckets.empty()) {
+    SpecializeDynamicDispatchesPassOptions specializeOptions;
+    specializeOptions.buckets = clDispatchShapeBuckets;
+    passManager.addPass(
+        IREE::Flow::createSpecializeDynamicDispatchesPass(specializeOptions));
+    passManager.addNestedPass<IREE::Flow::ExecutableOp>(
+        mlir::createCanonicalizerPass());
+  }
 
   // Create one function per exported program entry point that can be used with
   // iree-benchmark-module to benchmark each function individually. Whether
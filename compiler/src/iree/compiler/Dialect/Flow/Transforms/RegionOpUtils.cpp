@@ -27,6 +27,7 @@
 #include "mlir/IR/Block.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Dominance.h"
+#include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Value.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "mlir/Transforms/RegionUtils.h"
@@ -721,4 +722,75 @@ LogicalResult cloneProducersToRegion(RewriterBase &rewriter,
   return success();
 }
 
+linalg::GenericOp fuseGenericOpsHorizontally(RewriterBase &rewriter,
+                                             linalg::GenericOp first,
+                                             linalg::GenericOp second) {
+  SmallVector<Value> inputs = first.getDpsInputs();
+  llvm::append_range(inputs, second.getDpsInputs());
+  SmallVector<Value> inits = first.getDpsInits();
+  llvm::append_range(inits, second.getDpsInits());
+
+  // Indexing maps are ordered inputs then inits.
+  SmallVector<AffineMap> firstMaps = first.getIndexingMapsArray();
+  SmallVector<AffineMap> secondMaps = second.getIndexingMapsArray();
+  int64_t firstInputCount = first.getNumDpsInputs();
+  int64_t secondInputCount = second.getNumDpsInputs();
+  SmallVector<AffineMap> indexingMaps;
+  llvm::append_range(indexingMaps,
+                     ArrayRef(firstMaps).take_front(firstInputCount));
+  llvm::append_range(indexingMaps,
+                     ArrayRef(secondMaps).take_front(secondInputCount));
+  llvm::append_range(indexingMaps,
+                     ArrayRef(firstMaps).drop_front(firstInputCount));
+  llvm::append_range(indexingMaps,
+                     ArrayRef(secondMaps).drop_front(secondInputCount));
+
+  SmallVector<Type> resultTypes(first->getResultTypes());
+  llvm::append_range(resultTypes, second->getResultTypes());
+
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPoint(second);
+  auto fusedOp = rewriter.create<linalg::GenericOp>(
+      rewriter.getFusedLoc({first.getLoc(), second.getLoc()}), resultTypes,
+      inputs, inits, indexingMaps, first.getIteratorTypesArray(),
+      [&](OpBuilder &builder, Location loc, ValueRange args) {
+        // Block arguments are ordered inputs then inits.
+        int64_t firstInitCount = first.getNumDpsInits();
+        ValueRange firstArgs = args.take_front(firstInputCount);
+        ValueRange secondArgs =
+            args.drop_front(firstInputCount).take_front(secondInputCount);
+        int64_t inputCount = firstInputCount + secondInputCount;
+        ValueRange firstInitArgs =
+            args.drop_front(inputCount).take_front(firstInitCount);
+        ValueRange secondInitArgs =
+            args.drop_front(inputCount + firstInitCount);
+        SmallVector<Value> yieldedValues;
+        auto cloneBody = [&](linalg::GenericOp op, ValueRange inputArgs,
+                             ValueRange initArgs) {
+          IRMapping mapping;
+          Block *body = op.getBlock();
+          mapping.map(body->getArguments().take_front(inputArgs.size()),
+                      inputArgs);
+          mapping.map(body->getArguments().drop_front(inputArgs.size()),
+                      initArgs);
+          for (Operation &bodyOp : body->without_terminator()) {
+            builder.clone(bodyOp, mapping);
+          }
+          for (Value yielded : body->getTerminator()->getOperands()) {
+            yieldedValues.push_back(mapping.lookupOrDefault(yielded));
+          }
+        };
+        cloneBody(first, firstArgs, firstInitArgs);
+        cloneBody(second, secondArgs, secondInitArgs);
+        builder.create<linalg::YieldOp>(loc, yieldedValues);
+      });
+
+  int64_t firstResultCount = first->getNumResults();
+  rewriter.replaceOp(first,
+                     fusedOp->getResults().take_front(firstResultCount));
+  rewriter.replaceOp(second,
+                     fusedOp->getResults().drop_front(firstResultCount));
+  return fusedOp;
+}
+
 } // namespace mlir::iree_compiler::IREE::Flow
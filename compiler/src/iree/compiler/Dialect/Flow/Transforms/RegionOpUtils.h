@@ -16,6 +16,9 @@ class OpBuilder;
 class Operation;
 class RewriterBase;
 class Value;
+namespace linalg {
+class GenericOp;
+} // namespace linalg
 } // namespace mlir
 
 namespace mlir::iree_compiler::IREE::Flow {
@@ -122,6 +125,13 @@ SmallVector<Operation *> getCloneableOps(Flow::DispatchRegionOp regionOp);
 LogicalResult cloneProducersToRegion(RewriterBase &rewriter,
                                      Flow::DispatchRegionOp regionOp);
 
+/// Merges the independent |first| and |second| ops with the same iteration
+/// space into a single op with the inputs, outputs, and body of both. The
+/// merged op is inserted at |second| and all uses of |first| must be after it.
+linalg::GenericOp fuseGenericOpsHorizontally(RewriterBase &rewriter,
+                                             linalg::GenericOp first,
+                                             linalg::GenericOp second);
+
 } // namespace mlir::iree_compiler::IREE::Flow
 
 #endif // IREE_COMPILER_DIALECT_FLOW_TRANSFORMS_REGIONOPUTILS_H_
@@ -0,0 +1,239 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <optional>
+#include <string>
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-flow-specialize-dynamic-dispatches"
+
+namespace mlir::iree_compiler::IREE::Flow {
+
+#define GEN_PASS_DEF_SPECIALIZEDYNAMICDISPATCHESPASS
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h.inc"
+
+namespace {
+
+// An executable with a single export that can be specialized for static
+// values of one of its dynamic dimensions.
+struct SpecializationCandidate {
+  IREE::Flow::ExecutableOp executableOp;
+  IREE::Flow::ExecutableExportOp exportOp;
+  // Index of the function argument (and dispatch operand) carrying the
+  // dynamic dimension.
+  unsigned argIndex = 0;
+  // Dispatch sites that can select a specialized variant.
+  SmallVector<IREE::Flow::DispatchOp> dispatchOps;
+  // Specialized variant exports keyed by the static dimension value.
+  llvm::MapVector<int64_t, SymbolRefAttr> variantRefs;
+  // Most recently created variant; new variants are inserted after it so that
+  // they appear in bucket order.
+  Operation *lastVariantOp = nullptr;
+};
+
+// Returns true if |value| is used as a dynamic dimension of a shaped operand
+// by |user|.
+static bool isUsedAsDynamicDim(Value value, Operation *user) {
+  auto shapeAwareOp = dyn_cast<IREE::Util::ShapeAwareOpInterface>(user);
+  if (!shapeAwareOp)
+    return false;
+  for (unsigned i = 0, e = user->getNumOperands(); i < e; ++i) {
+    if (llvm::is_contained(shapeAwareOp.getOperandDynamicDims(i), value))
+      return true;
+  }
+  return false;
+}
+
+// Returns the index of the first function argument of |executableOp| that is
+// used as a dynamic dimension of a dispatch tensor.
+static std::optional<unsigned>
+findDynamicDimArgument(IREE::Flow::ExecutableOp executableOp,
+                       IREE::Flow::ExecutableExportOp exportOp) {
+  auto innerModuleOp = executableOp.getInnerModule();
+  if (!innerModuleOp)
+    return std::nullopt;
+  auto funcOp = innerModuleOp.lookupSymbol<mlir::FunctionOpInterface>(
+      exportOp.getFunctionRef());
+  if (!funcOp || funcOp.isExternal())
+    return std::nullopt;
+  for (auto arg : funcOp.getArguments()) {
+    if (!arg.getType().isIndex())
+      continue;
+    bool isDim = llvm::any_of(arg.getUsers(), [&](Operation *user) {
+      return isUsedAsDynamicDim(arg, user);
+    });
+    if (isDim)
+      return arg.getArgNumber();
+  }
+  return std::nullopt;
+}
+
+// Returns the export of a clone of |candidate|'s executable in which the
+// dynamic dimension argument is replaced with |size|. Canonicalization then
+// folds the constant into static dispatch tensor types.
+static SymbolRefAttr
+createSpecializedVariant(SymbolTable &symbolTable,
+                         SpecializationCandidate &candidate, int64_t size) {
+  auto it = candidate.variantRefs.find(size);
+  if (it != candidate.variantRefs.end())
+    return it->second;
+
+  auto executableOp = candidate.executableOp;
+  auto variantOp = cast<IREE::Flow::ExecutableOp>(executableOp->clone());
+  variantOp.setSymName(
+      (executableOp.getName() + "_d" + std::to_string(size)).str());
+  Operation *insertAfterOp = candidate.lastVariantOp
+                                 ? candidate.lastVariantOp
+                                 : executableOp.getOperation();
+  symbolTable.insert(variantOp, std::next(Block::iterator(insertAfterOp)));
+  candidate.lastVariantOp = variantOp;
+
+  auto funcOp = variantOp.getInnerModule().lookupSymbol<FunctionOpInterface>(
+      candidate.exportOp.getFunctionRef());
+  BlockArgument arg = funcOp.getArgument(candidate.argIndex);
+  auto builder = OpBuilder::atBlockBegin(&funcOp.getFunctionBody().front());
+  Value sizeValue = builder.create<arith::ConstantIndexOp>(arg.getLoc(), size);
+  arg.replaceAllUsesWith(sizeValue);
+
+  auto variantRef =
+      SymbolRefAttr::get(variantOp.getSymNameAttr(),
+                         {FlatSymbolRefAttr::get(
+                             candidate.exportOp.getSymNameAttr())});
+  candidate.variantRefs[size] = variantRef;
+  return variantRef;
+}
+
+// Builds a chain of scf.if ops selecting between dispatches of the
+// |variantRefs| when the dynamic dimension |dim| equals their static size and
+// falls back to the original |dispatchOp| otherwise.
+static ValueRange
+buildVariantSelection(OpBuilder &builder, IREE::Flow::DispatchOp dispatchOp,
+                      Value dim,
+                      ArrayRef<std::pair<int64_t, SymbolRefAttr>> variantRefs) {
+  if (variantRefs.empty())
+    return builder.clone(*dispatchOp)->getResults();
+  auto loc = dispatchOp.getLoc();
+  auto [size, variantRef] = variantRefs.front();
+  Value sizeValue = builder.create<arith::ConstantIndexOp>(loc, size);
+  Value isMatch = builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq,
+                                                dim, sizeValue);
+  auto ifOp = builder.create<scf::IfOp>(
+      loc, isMatch,
+      [&](OpBuilder &thenBuilder, Location loc) {
+        auto variantDispatchOp =
+            cast<IREE::Flow::DispatchOp>(thenBuilder.clone(*dispatchOp));
+        variantDispatchOp.setEntryPointsAttr(
+            thenBuilder.getArrayAttr({variantRef}));
+        thenBuilder.create<scf::YieldOp>(loc, variantDispatchOp.getResults());
+      },
+      [&](OpBuilder &elseBuilder, Location loc) {
+        elseBuilder.create<scf::YieldOp>(
+            loc, buildVariantSelection(elseBuilder, dispatchOp, dim,
+                                       variantRefs.drop_front()));
+      });
+  return ifOp.getResults();
+}
+
+} // namespace
+
+struct SpecializeDynamicDispatchesPass
+    : public IREE::Flow::impl::SpecializeDynamicDispatchesPassBase<
+          SpecializeDynamicDispatchesPass> {
+  using IREE::Flow::impl::SpecializeDynamicDispatchesPassBase<
+      SpecializeDynamicDispatchesPass>::SpecializeDynamicDispatchesPassBase;
+
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    if (buckets.empty())
+      return;
+    llvm::SetVector<int64_t> bucketSizes;
+    for (int64_t size : buckets) {
+      if (size <= 0) {
+        moduleOp.emitError() << "invalid dispatch shape bucket " << size
+                             << "; buckets must be positive";
+        return signalPassFailure();
+      }
+      bucketSizes.insert(size);
+    }
+
+    // Executables with a single export and their dispatch sites.
+    // Executables dispatched with multiple entry points are skipped as their
+    // exports must remain interchangeable.
+    llvm::MapVector<Attribute, SpecializationCandidate> candidates;
+    for (auto executableOp : moduleOp.getOps<IREE::Flow::ExecutableOp>()) {
+      auto exportOps = llvm::to_vector(
+          executableOp.getOps<IREE::Flow::ExecutableExportOp>());
+      if (exportOps.size() != 1)
+        continue;
+      auto argIndex = findDynamicDimArgument(executableOp, exportOps.front());
+      if (!argIndex)
+        continue;
+      SpecializationCandidate candidate;
+      candidate.executableOp = executableOp;
+      candidate.exportOp = exportOps.front();
+      candidate.argIndex = *argIndex;
+      candidates[executableOp.getSymNameAttr()] = std::move(candidate);
+    }
+    moduleOp.walk([&](IREE::Flow::DispatchOp dispatchOp) {
+      auto entryPointRefs = llvm::to_vector(dispatchOp.getEntryPointRefs());
+      if (entryPointRefs.size() != 1) {
+        for (auto entryPointRef : entryPointRefs) {
+          candidates.erase(entryPointRef.getRootReference());
+        }
+        return;
+      }
+      auto it = candidates.find(entryPointRefs.front().getRootReference());
+      if (it == candidates.end())
+        return;
+      // Sizes known at the dispatch site will already have been folded into
+      // the executable if possible.
+      Value dim = dispatchOp.getArguments()[it->second.argIndex];
+      if (matchPattern(dim, m_Constant()))
+        return;
+      it->second.dispatchOps.push_back(dispatchOp);
+    });
+
+    SymbolTable symbolTable(moduleOp);
+    for (auto &[name, candidate] : candidates) {
+      (void)name;
+      if (candidate.dispatchOps.empty())
+        continue;
+      SmallVector<std::pair<int64_t, SymbolRefAttr>> variantRefs;
+      for (int64_t size : bucketSizes) {
+        variantRefs.push_back(
+            {size, createSpecializedVariant(symbolTable, candidate, size)});
+      }
+      LLVM_DEBUG(llvm::dbgs()
+                 << "specializing @" << candidate.executableOp.getName()
+                 << " argument " << candidate.argIndex << " for "
+                 << variantRefs.size() << " size(s) at "
+                 << candidate.dispatchOps.size() << " dispatch site(s)\n");
+      for (auto dispatchOp : candidate.dispatchOps) {
+        OpBuilder builder(dispatchOp);
+        Value dim = dispatchOp.getArguments()[candidate.argIndex];
+        auto results =
+            buildVariantSelection(builder, dispatchOp, dim, variantRefs);
+        dispatchOp.replaceAllUsesWith(results);
+        dispatchOp.erase();
+      }
+    }
+  }
+};
+
+} // namespace mlir::iree_compiler::IREE::Flow
@@ -0,0 +1,91 @@
+// RUN: iree-opt --split-input-file --iree-flow-deduplicate-executables="outline-constants=true" %s | FileCheck %s
+
+// CHECK-LABEL: flow.executable public @outline_constants_ex_0
+flow.executable public @outline_constants_ex_0 {
+  flow.executable.export @outline_constants_entry_0
+  builtin.module {
+    // CHECK: func.func @outline_constants_entry_0(%[[ARG0:[a-zA-Z0-9]+]]: tensor<4xi32>, %[[SCALE:[a-zA-Z0-9]+]]: i32)
+    func.func @outline_constants_entry_0(%arg0: tensor<4xi32>) -> tensor<4xi32> {
+      // CHECK-NOT: arith.constant
+      %c3 = arith.constant 3 : i32
+      // CHECK: %[[SPLAT:.+]] = tensor.splat %[[SCALE]]
+      %0 = tensor.splat %c3 : tensor<4xi32>
+      // CHECK: arith.muli %[[ARG0]], %[[SPLAT]]
+      %1 = arith.muli %arg0, %0 : tensor<4xi32>
+      return %1 : tensor<4xi32>
+    }
+  }
+}
+// CHECK-NOT: flow.executable public @outline_constants_ex_1
+flow.executable public @outline_constants_ex_1 {
+  flow.executable.export @outline_constants_entry_1
+  builtin.module {
+    func.func @outline_constants_entry_1(%arg0: tensor<4xi32>) -> tensor<4xi32> {
+      %c5 = arith.constant 5 : i32
+      %0 = tensor.splat %c5 : tensor<4xi32>
+      %1 = arith.muli %arg0, %0 : tensor<4xi32>
+      return %1 : tensor<4xi32>
+    }
+  }
+}
+// CHECK-LABEL: flow.executable public @outline_constants_ex_2
+flow.executable public @outline_constants_ex_2 {
+  flow.executable.export @outline_constants_entry_2
+  builtin.module {
+    func.func @outline_constants_entry_2(%arg0: tensor<4xi32>) -> tensor<4xi32> {
+      %c5 = arith.constant 5 : i32
+      %0 = tensor.splat %c5 : tensor<4xi32>
+      %1 = arith.addi %arg0, %0 : tensor<4xi32>
+      return %1 : tensor<4xi32>
+    }
+  }
+}
+// CHECK-LABEL: util.func public @outline_constants
+util.func public @outline_constants(%arg0: tensor<4xi32>) -> tensor<4xi32> {
+  %c4 = arith.constant 4 : index
+  // CHECK: %[[C3:.+]] = arith.constant 3 : i32
+  // CHECK: %[[D0:.+]] = flow.dispatch @outline_constants_ex_0::@outline_constants_entry_0[%c4](%arg0, %[[C3]]) : (tensor<4xi32>, i32) -> tensor<4xi32>
+  %0 = flow.dispatch @outline_constants_ex_0::@outline_constants_entry_0[%c4](%arg0) : (tensor<4xi32>) -> tensor<4xi32>
+  // CHECK: %[[C5:.+]] = arith.constant 5 : i32
+  // CHECK: %[[D1:.+]] = flow.dispatch @outline_constants_ex_0::@outline_constants_entry_0[%c4](%[[D0]], %[[C5]]) : (tensor<4xi32>, i32) -> tensor<4xi32>
+  %1 = flow.dispatch @outline_constants_ex_1::@outline_constants_entry_1[%c4](%0) : (tensor<4xi32>) -> tensor<4xi32>
+  // CHECK: flow.dispatch @outline_constants_ex_2::@outline_constants_entry_2[%c4](%[[D1]]) : (tensor<4xi32>) -> tensor<4xi32>
+  %2 = flow.dispatch @outline_constants_ex_2::@outline_constants_entry_2[%c4](%1) : (tensor<4xi32>) -> tensor<4xi32>
+  util.return %2 : tensor<4xi32>
+}
+
+// -----
+
+// Constants that are not scalars are not outlined.
+
+// CHECK-LABEL: flow.executable public @tensor_constants_ex_0
+flow.executable public @tensor_constants_ex_0 {
+  flow.executable.export @tensor_constants_entry_0
+  builtin.module {
+    func.func @tensor_constants_entry_0(%arg0: tensor<4xi32>) -> tensor<4xi32> {
+      %cst = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi32>
+      %0 = arith.muli %arg0, %cst : tensor<4xi32>
+      return %0 : tensor<4xi32>
+    }
+  }
+}
+// CHECK-LABEL: flow.executable public @tensor_constants_ex_1
+flow.executable public @tensor_constants_ex_1 {
+  flow.executable.export @tensor_constants_entry_1
+  builtin.module {
+    func.func @tensor_constants_entry_1(%arg0: tensor<4xi32>) -> tensor<4xi32> {
+      %cst = arith.constant dense<[5, 6, 7, 8]> : tensor<4xi32>
+      %0 = arith.muli %arg0, %cst : tensor<4xi32>
+      return %0 : tensor<4xi32>
+    }
+  }
+}
+// CHECK-LABEL: util.func public @tensor_constants
+util.func public @tensor_constants(%arg0: tensor<4xi32>) -> tensor<4xi32> {
+  %c4 = arith.constant 4 : index
+  // CHECK: flow.dispatch @tensor_constants_ex_0::@tensor_constants_entry_0[%c4](%arg0)
+  %0 = flow.dispatch @tensor_constants_ex_0::@tensor_constants_entry_0[%c4](%arg0) : (tensor<4xi32>) -> tensor<4xi32>
+  // CHECK: flow.dispatch @tensor_constants_ex_1::@tensor_constants_entry_1[%c4](%0)
+  %1 = flow.dispatch @tensor_constants_ex_1::@tensor_constants_entry_1[%c4](%0) : (tensor<4xi32>) -> tensor<4xi32>
+  util.return %1 : tensor<4xi32>
+}
@@ -0,0 +1,38 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(util.func(iree-flow-form-dispatch-regions{cost-model=cpu}))" --split-input-file %s | FileCheck %s
+
+// Small independent elementwise ops reading the same input are merged into a
+// single dispatch to avoid paying the dispatch overhead twice.
+util.func public @horizontal_fusion(%arg0 : tensor<4x8xf32>)
+    -> (tensor<4x8xf32>, tensor<4x8xf32>) {
+  %0 = tensor.empty() : tensor<4x8xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%arg0 : tensor<4x8xf32>) outs(%0 : tensor<4x8xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32) :
+      %2 = arith.addf %b0, %b0 : f32
+      linalg.yield %2 : f32
+  } -> tensor<4x8xf32>
+  %3 = tensor.empty() : tensor<4x8xf32>
+  %4 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>,
+                       affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%arg0 : tensor<4x8xf32>) outs(%3 : tensor<4x8xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32) :
+      %5 = arith.mulf %b0, %b0 : f32
+      linalg.yield %5 : f32
+  } -> tensor<4x8xf32>
+  util.return %1, %4 : tensor<4x8xf32>, tensor<4x8xf32>
+}
+// CHECK-LABEL: util.func public @horizontal_fusion(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<4x8xf32>
+//       CHECK:   %[[RESULT:.+]]:2 = flow.dispatch.region
+//       CHECK:     %[[GENERIC:.+]]:2 = linalg.generic
+//  CHECK-SAME:         ins(%[[ARG0]], %[[ARG0]] :
+//       CHECK:       arith.addf
+//       CHECK:       arith.mulf
+//       CHECK:     flow.return %[[GENERIC]]#0, %[[GENERIC]]#1
+//   CHECK-NOT:   flow.dispatch.region
+//       CHECK:   util.return %[[RESULT]]#0, %[[RESULT]]#1
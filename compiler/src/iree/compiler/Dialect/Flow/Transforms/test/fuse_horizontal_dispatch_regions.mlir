@@ -0,0 +1,111 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(util.func(iree-flow-fuse-horizontal-dispatch-regions))" --split-input-file %s | FileCheck %s
+
+util.func public @fuse_independent(%arg0 : tensor<32xf32>,
+    %arg1 : tensor<32xf32>)
+    -> (tensor<32xf32>, tensor<32xf32>) {
+  %0 = flow.dispatch.region -> (tensor<32xf32>) {
+    %empty = tensor.empty() : tensor<32xf32>
+    %generic = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]}
+        ins(%arg0 : tensor<32xf32>) outs(%empty : tensor<32xf32>) {
+      ^bb0(%b0 : f32, %b1 : f32) :
+        %add = arith.addf %b0, %b0 : f32
+        linalg.yield %add : f32
+    } -> tensor<32xf32>
+    flow.return %generic : tensor<32xf32>
+  }
+  %1 = flow.dispatch.region -> (tensor<32xf32>) {
+    %empty = tensor.empty() : tensor<32xf32>
+    %generic = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]}
+        ins(%arg1 : tensor<32xf32>) outs(%empty : tensor<32xf32>) {
+      ^bb0(%b0 : f32, %b1 : f32) :
+        %mul = arith.mulf %b0, %b0 : f32
+        linalg.yield %mul : f32
+    } -> tensor<32xf32>
+    flow.return %generic : tensor<32xf32>
+  }
+  util.return %0, %1 : tensor<32xf32>, tensor<32xf32>
+}
+// CHECK-LABEL: util.func public @fuse_independent(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<32xf32>
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<32xf32>
+//       CHECK:   %[[RESULT:.+]]:2 = flow.dispatch.region
+//       CHECK:     %[[GENERIC:.+]]:2 = linalg.generic
+//  CHECK-SAME:         ins(%[[ARG0]], %[[ARG1]] :
+//       CHECK:       arith.addf
+//       CHECK:       arith.mulf
+//       CHECK:     flow.return %[[GENERIC]]#0, %[[GENERIC]]#1
+//   CHECK-NOT:   flow.dispatch.region
+//       CHECK:   util.return %[[RESULT]]#0, %[[RESULT]]#1
+
+// -----
+
+util.func public @no_fuse_dependent(%arg0 : tensor<32xf32>) -> tensor<32xf32> {
+  %0 = flow.dispatch.region -> (tensor<32xf32>) {
+    %empty = tensor.empty() : tensor<32xf32>
+    %generic = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]}
+        ins(%arg0 : tensor<32xf32>) outs(%empty : tensor<32xf32>) {
+      ^bb0(%b0 : f32, %b1 : f32) :
+        %add = arith.addf %b0, %b0 : f32
+        linalg.yield %add : f32
+    } -> tensor<32xf32>
+    flow.return %generic : tensor<32xf32>
+  }
+  %1 = flow.dispatch.region -> (tensor<32xf32>) {
+    %empty = tensor.empty() : tensor<32xf32>
+    %generic = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]}
+        ins(%0 : tensor<32xf32>) outs(%empty : tensor<32xf32>) {
+      ^bb0(%b0 : f32, %b1 : f32) :
+        %mul = arith.mulf %b0, %b0 : f32
+        linalg.yield %mul : f32
+    } -> tensor<32xf32>
+    flow.return %generic : tensor<32xf32>
+  }
+  util.return %1 : tensor<32xf32>
+}
+// CHECK-LABEL: util.func public @no_fuse_dependent(
+//       CHECK:   %[[RESULT0:.+]] = flow.dispatch.region
+//       CHECK:   flow.dispatch.region
+//       CHECK:     linalg.generic
+//  CHECK-SAME:         ins(%[[RESULT0]] :
+
+// -----
+
+util.func public @no_fuse_different_shapes(%arg0 : tensor<32xf32>,
+    %arg1 : tensor<64xf32>) -> (tensor<32xf32>, tensor<64xf32>) {
+  %0 = flow.dispatch.region -> (tensor<32xf32>) {
+    %empty = tensor.empty() : tensor<32xf32>
+    %generic = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]}
+        ins(%arg0 : tensor<32xf32>) outs(%empty : tensor<32xf32>) {
+      ^bb0(%b0 : f32, %b1 : f32) :
+        %add = arith.addf %b0, %b0 : f32
+        linalg.yield %add : f32
+    } -> tensor<32xf32>
+    flow.return %generic : tensor<32xf32>
+  }
+  %1 = flow.dispatch.region -> (tensor<64xf32>) {
+    %empty = tensor.empty() : tensor<64xf32>
+    %generic = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]}
+        ins(%arg1 : tensor<64xf32>) outs(%empty : tensor<64xf32>) {
+      ^bb0(%b0 : f32, %b1 : f32) :
+        %mul = arith.mulf %b0, %b0 : f32
+        linalg.yield %mul : f32
+    } -> tensor<64xf32>
+    flow.return %generic : tensor<64xf32>
+  }
+  util.return %0, %1 : tensor<32xf32>, tensor<64xf32>
+}
+// CHECK-LABEL: util.func public @no_fuse_different_shapes(
+//       CHECK:   flow.dispatch.region -> (tensor<32xf32>)
+//       CHECK:   flow.dispatch.region -> (tensor<64xf32>)
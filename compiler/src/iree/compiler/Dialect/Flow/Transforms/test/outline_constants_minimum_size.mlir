@@ -0,0 +1,23 @@
+// RUN: iree-opt --split-input-file --iree-flow-outline-constants="minimum-size=64" %s | FileCheck %s
+
+// Tests that only constants at least as large as the minimum size are
+// outlined.
+
+// CHECK: util.global private @__constant_tensor_16xf32 {inlining_policy = #util.inline.never} = dense_resource<large> : tensor<16xf32>
+// CHECK-LABEL: @largeConstants
+util.func @largeConstants() -> (tensor<2xi32>, tensor<16xf32>) {
+  // CHECK-DAG: %[[SMALL:.+]] = arith.constant dense<[0, 1]> : tensor<2xi32>
+  %small = arith.constant dense<[0, 1]> : tensor<2xi32>
+  // CHECK-DAG: %[[LARGE:.+]] = util.global.load immutable @__constant_tensor_16xf32 : tensor<16xf32>
+  %large = arith.constant dense_resource<large> : tensor<16xf32>
+  // CHECK: util.return %[[SMALL]], %[[LARGE]]
+  util.return %small, %large : tensor<2xi32>, tensor<16xf32>
+}
+
+{-#
+  dialect_resources: {
+    builtin: {
+      large: "0x040000000000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F0000803F"
+    }
+  }
+#-}
@@ -0,0 +1,72 @@
+// RUN: iree-opt --split-input-file --iree-flow-specialize-dynamic-dispatches="buckets=128,512" %s | FileCheck %s
+
+// CHECK-LABEL: flow.executable private @dynamic_ex
+flow.executable private @dynamic_ex {
+  flow.executable.export public @dynamic_entry
+  builtin.module {
+    // CHECK: func.func @dynamic_entry(%[[IN:.+]]: !flow.dispatch.tensor<readonly:tensor<?x64xf32>>, %[[DIM:.+]]: index
+    func.func @dynamic_entry(%arg0: !flow.dispatch.tensor<readonly:tensor<?x64xf32>>, %arg1: index, %arg2: !flow.dispatch.tensor<writeonly:tensor<?x64xf32>>) {
+      // CHECK: flow.dispatch.tensor.load %[[IN]], {{.+}} sizes = [%[[DIM]], 64]
+      %0 = flow.dispatch.tensor.load %arg0, offsets = [0, 0], sizes = [%arg1, 64], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<?x64xf32>>{%arg1} -> tensor<?x64xf32>
+      %1 = arith.negf %0 : tensor<?x64xf32>
+      flow.dispatch.tensor.store %1, %arg2, offsets = [0, 0], sizes = [%arg1, 64], strides = [1, 1] : tensor<?x64xf32> -> !flow.dispatch.tensor<writeonly:tensor<?x64xf32>>{%arg1}
+      return
+    }
+  }
+}
+// CHECK: flow.executable private @dynamic_ex_d128
+// CHECK:   func.func @dynamic_entry(%[[IN:.+]]: !flow.dispatch.tensor<readonly:tensor<?x64xf32>>, %{{.+}}: index
+// CHECK:     %[[C128:.+]] = arith.constant 128 : index
+// CHECK:     flow.dispatch.tensor.load %[[IN]], {{.+}} sizes = [%[[C128]], 64]
+// CHECK: flow.executable private @dynamic_ex_d512
+// CHECK:   arith.constant 512 : index
+
+// CHECK-LABEL: util.func public @specialize
+// CHECK-SAME: (%[[ARG0:.+]]: tensor<?x64xf32>, %[[DIM:.+]]: index)
+util.func public @specialize(%arg0: tensor<?x64xf32>, %dim: index) -> tensor<?x64xf32> {
+  %c1 = arith.constant 1 : index
+  //      CHECK: %[[C128:.+]] = arith.constant 128 : index
+  //      CHECK: %[[IS_128:.+]] = arith.cmpi eq, %[[DIM]], %[[C128]]
+  //      CHECK: %[[RESULT:.+]] = scf.if %[[IS_128]]
+  //      CHECK:   %[[D128:.+]] = flow.dispatch @dynamic_ex_d128::@dynamic_entry[%c1](%[[ARG0]], %[[DIM]])
+  //      CHECK:   scf.yield %[[D128]]
+  //      CHECK: } else {
+  //      CHECK:   %[[C512:.+]] = arith.constant 512 : index
+  //      CHECK:   %[[IS_512:.+]] = arith.cmpi eq, %[[DIM]], %[[C512]]
+  //      CHECK:   %[[INNER:.+]] = scf.if %[[IS_512]]
+  //      CHECK:     flow.dispatch @dynamic_ex_d512::@dynamic_entry
+  //      CHECK:   } else {
+  //      CHECK:     %[[FALLBACK:.+]] = flow.dispatch @dynamic_ex::@dynamic_entry[%c1](%[[ARG0]], %[[DIM]])
+  //      CHECK:     scf.yield %[[FALLBACK]]
+  //      CHECK:   }
+  //      CHECK:   scf.yield %[[INNER]]
+  //      CHECK: }
+  %0 = flow.dispatch @dynamic_ex::@dynamic_entry[%c1](%arg0, %dim) : (tensor<?x64xf32>{%dim}, index) -> tensor<?x64xf32>{%dim}
+  // CHECK: util.return %[[RESULT]]
+  util.return %0 : tensor<?x64xf32>
+}
+
+// -----
+
+// Executables without arguments used as dynamic dimensions are not specialized.
+
+// CHECK-LABEL: flow.executable private @static_ex
+// CHECK-NOT: flow.executable private @static_ex_d128
+flow.executable private @static_ex {
+  flow.executable.export public @static_entry
+  builtin.module {
+    func.func @static_entry(%arg0: !flow.dispatch.tensor<readonly:tensor<4xf32>>, %arg1: index) {
+      return
+    }
+  }
+}
+
+// CHECK-LABEL: util.func public @no_specialization
+util.func public @no_specialization(%arg0: tensor<4xf32>) {
+  %c1 = arith.constant 1 : index
+  %c7 = arith.constant 7 : index
+  // CHECK-NOT: scf.if
+  // CHECK: flow.dispatch @static_ex::@static_entry
+  flow.dispatch @static_ex::@static_entry[%c1](%arg0, %c7) : (tensor<4xf32>, index) -> ()
+  util.return
+}
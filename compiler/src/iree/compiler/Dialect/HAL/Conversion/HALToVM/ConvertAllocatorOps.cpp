@@ -23,33 +23,48 @@ public:
     importOp =
         importSymbols.lookup<IREE::VM::ImportOp>("hal.allocator.allocate");
     assert(importOp);
+    taggedImportOp = importSymbols.lookup<IREE::VM::ImportOp>(
+        "hal.allocator.allocate.tagged");
+    assert(taggedImportOp);
   }
 
   LogicalResult
   matchAndRewrite(IREE::HAL::AllocatorAllocateOp op, OpAdaptor adaptor,
                   ConversionPatternRewriter &rewriter) const override {
+    SmallVector<Value> operands = {
+        adaptor.getAllocator(),
+        castToImportType(adaptor.getQueueAffinity(), rewriter.getI64Type(),
+                         rewriter),
+        rewriter.createOrFold<IREE::VM::ConstI32Op>(
+            op.getLoc(), op.getMemoryTypesAttr().getInt()),
+        rewriter.createOrFold<IREE::VM::ConstI32Op>(
+            op.getLoc(), op.getBufferUsageAttr().getInt()),
+    };
+
+    // Only use the tagged import when a tag is present so that modules not
+    // using tags remain compatible with older runtimes.
+    auto callImportOp = importOp;
+    if (auto allocationTag = op.getAllocationTagAttr()) {
+      callImportOp = taggedImportOp;
+      operands.push_back(rewriter.createOrFold<IREE::VM::ConstI32Op>(
+          op.getLoc(), static_cast<int32_t>(allocationTag.getValue())));
+    }
+
+    operands.push_back(castToImportType(adaptor.getResultSize(),
+                                        rewriter.getI64Type(), rewriter));
     auto callOp = rewriter.replaceOpWithNewOp<IREE::VM::CallOp>(
-        op, importOp.getName(),
+        op, callImportOp.getName(),
         ArrayRef<Type>{
             getTypeConverter()->convertType(op.getType()),
         },
-        ArrayRef<Value>{
-            adaptor.getAllocator(),
-            castToImportType(adaptor.getQueueAffinity(), rewriter.getI64Type(),
-                             rewriter),
-            rewriter.createOrFold<IREE::VM::ConstI32Op>(
-                op.getLoc(), op.getMemoryTypesAttr().getInt()),
-            rewriter.createOrFold<IREE::VM::ConstI32Op>(
-                op.getLoc(), op.getBufferUsageAttr().getInt()),
-            castToImportType(adaptor.getResultSize(), rewriter.getI64Type(),
-                             rewriter),
-        });
-    copyImportAttrs(importOp, callOp);
+        operands);
+    copyImportAttrs(callImportOp, callOp);
     return success();
   }
 
 private:
   mutable IREE::VM::ImportOp importOp;
+  mutable IREE::VM::ImportOp taggedImportOp;
 };
 
 class AllocatorImportOpConversion
@@ -4,6 +4,8 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <limits>
+
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Dialect/VM/Conversion/ImportUtils.h"
@@ -305,6 +307,89 @@ private:
   mutable IREE::VM::ImportOp importOp;
 };
 
+// Converts hal.command_buffer.dispatch to the single dispatch import unless it
+// begins a straight-line sequence of dispatches into the same command buffer.
+// Such sequences are recorded with a single call to the batch import to avoid
+// paying the VM->native call overhead per dispatch: large command buffers
+// record thousands of dispatches per invocation.
+class CommandBufferDispatchOpConversion
+    : public OpConversionPattern<IREE::HAL::CommandBufferDispatchOp> {
+public:
+  CommandBufferDispatchOpConversion(MLIRContext *context,
+                                    SymbolTable &importSymbols,
+                                    TypeConverter &typeConverter,
+                                    StringRef importName,
+                                    StringRef batchImportName)
+      : OpConversionPattern(typeConverter, context) {
+    importOp = importSymbols.lookup<IREE::VM::ImportOp>(importName);
+    assert(importOp);
+    batchImportOp = importSymbols.lookup<IREE::VM::ImportOp>(batchImportName);
+    assert(batchImportOp);
+  }
+
+  LogicalResult
+  matchAndRewrite(IREE::HAL::CommandBufferDispatchOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    // Gather the dispatches immediately following this one. As there are no
+    // ops in between all of their operands are defined before |op| and have
+    // already been converted.
+    // The batch size is bounded by the variadic segment size limit.
+    SmallVector<IREE::HAL::CommandBufferDispatchOp> batchOps = {op};
+    while (batchOps.size() < std::numeric_limits<int16_t>::max()) {
+      auto nextOp = dyn_cast_or_null<IREE::HAL::CommandBufferDispatchOp>(
+          batchOps.back()->getNextNode());
+      if (!nextOp || nextOp.getCommandBuffer() != op.getCommandBuffer())
+        break;
+      batchOps.push_back(nextOp);
+    }
+    if (batchOps.size() == 1) {
+      auto results = rewriteToCall(op, adaptor, importOp,
+                                   *this->getTypeConverter(), rewriter);
+      if (!results.has_value())
+        return failure();
+      rewriter.replaceOp(op, results.value());
+      return success();
+    }
+
+    auto importType = batchImportOp.getFunctionType();
+    auto i32Type = rewriter.getI32Type();
+    SmallVector<Value> callOperands = {
+        adaptor.getCommandBuffer(),
+    };
+    SmallVector<int16_t, 2> segmentSizes = {
+        /*command_buffer=*/-1,
+        /*dispatches=*/static_cast<int16_t>(batchOps.size()),
+    };
+    for (auto batchOp : batchOps) {
+      // <executable, entry_point, workgroup_x, workgroup_y, workgroup_z>
+      SmallVector<Value> operands;
+      if (failed(rewriter.getRemappedValues(
+              ValueRange{batchOp.getExecutable(), batchOp.getEntryPoint(),
+                         batchOp.getWorkgroupX(), batchOp.getWorkgroupY(),
+                         batchOp.getWorkgroupZ()},
+              operands))) {
+        return failure();
+      }
+      callOperands.push_back(operands[0]);
+      for (Value operand : llvm::drop_begin(operands)) {
+        callOperands.push_back(castToImportType(operand, i32Type, rewriter));
+      }
+    }
+
+    auto callOp = rewriter.create<IREE::VM::CallVariadicOp>(
+        op.getLoc(), SymbolRefAttr::get(batchImportOp), importType.getResults(),
+        segmentSizes, importType.getInputs(), callOperands);
+    copyImportAttrs(batchImportOp, callOp);
+    for (auto batchOp : llvm::reverse(batchOps))
+      rewriter.eraseOp(batchOp);
+    return success();
+  }
+
+private:
+  mutable IREE::VM::ImportOp importOp;
+  mutable IREE::VM::ImportOp batchImportOp;
+};
+
 } // namespace
 
 void populateHALCommandBufferToVMPatterns(MLIRContext *context,
@@ -340,8 +425,9 @@ void populateHALCommandBufferToVMPatterns(MLIRContext *context,
   patterns.insert<CommandBufferPushDescriptorSetOpConversion>(
       context, importSymbols, typeConverter,
       "hal.command_buffer.push_descriptor_set");
-  patterns.insert<VMImportOpConversion<IREE::HAL::CommandBufferDispatchOp>>(
-      context, importSymbols, typeConverter, "hal.command_buffer.dispatch");
+  patterns.insert<CommandBufferDispatchOpConversion>(
+      context, importSymbols, typeConverter, "hal.command_buffer.dispatch",
+      "hal.command_buffer.dispatch.batch");
   patterns
       .insert<VMImportOpConversion<IREE::HAL::CommandBufferDispatchIndirectOp>>(
           context, importSymbols, typeConverter,
@@ -115,6 +115,41 @@ private:
   mutable IREE::VM::ImportOp importOp;
 };
 
+// Converts hal.device.queue.alloca to the tagged import variant when an
+// allocation tag is specified and otherwise to the untagged import so that
+// modules not using tags remain compatible with older runtimes.
+class DeviceQueueAllocaOpConversion
+    : public OpConversionPattern<IREE::HAL::DeviceQueueAllocaOp> {
+public:
+  DeviceQueueAllocaOpConversion(MLIRContext *context,
+                                SymbolTable &importSymbols,
+                                TypeConverter &typeConverter)
+      : OpConversionPattern(typeConverter, context) {
+    importOp =
+        importSymbols.lookup<IREE::VM::ImportOp>("hal.device.queue.alloca");
+    assert(importOp);
+    taggedImportOp = importSymbols.lookup<IREE::VM::ImportOp>(
+        "hal.device.queue.alloca.tagged");
+    assert(taggedImportOp);
+  }
+
+  LogicalResult
+  matchAndRewrite(IREE::HAL::DeviceQueueAllocaOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto results = rewriteToCall(
+        op, adaptor, op.getAllocationTag() ? taggedImportOp : importOp,
+        *getTypeConverter(), rewriter);
+    if (!results.has_value())
+      return failure();
+    rewriter.replaceOp(op, results.value());
+    return success();
+  }
+
+private:
+  mutable IREE::VM::ImportOp importOp;
+  mutable IREE::VM::ImportOp taggedImportOp;
+};
+
 void populateHALDeviceToVMPatterns(MLIRContext *context,
                                    SymbolTable &importSymbols,
                                    TypeConverter &typeConverter,
@@ -126,8 +161,8 @@ void populateHALDeviceToVMPatterns(MLIRContext *context,
   patterns.insert<DeviceQueryI64OpConversion>(
       context, importSymbols, typeConverter, "hal.device.query.i64");
 
-  patterns.insert<VMImportOpConversion<IREE::HAL::DeviceQueueAllocaOp>>(
-      context, importSymbols, typeConverter, "hal.device.queue.alloca");
+  patterns.insert<DeviceQueueAllocaOpConversion>(context, importSymbols,
+                                                 typeConverter);
   patterns.insert<VMImportOpConversion<IREE::HAL::DeviceQueueDeallocaOp>>(
       context, importSymbols, typeConverter, "hal.device.queue.dealloca");
   patterns.insert<VMImportOpConversion<IREE::HAL::DeviceQueueReadOp>>(
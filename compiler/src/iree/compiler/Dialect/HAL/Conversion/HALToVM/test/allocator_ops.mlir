@@ -13,6 +13,19 @@ util.func public @allocatorAllocate(%arg0 : !hal.allocator) -> !hal.buffer {
 
 // -----
 
+// CHECK-LABEL: vm.func private @allocatorAllocateTagged
+util.func public @allocatorAllocateTagged(%arg0 : !hal.allocator) -> !hal.buffer {
+  // CHECK-DAG: %[[SIZE:.+]] = vm.const.i64 1024
+  %size = arith.constant 1024 : index
+  // CHECK-DAG: %[[AFFINITY:.+]] = vm.const.i64 -1
+  %affinity = arith.constant -1 : i64
+  // CHECK: %ref = vm.call @hal.allocator.allocate.tagged(%arg0, %[[AFFINITY]], %c48, %c3075, %c1, %[[SIZE]]) : (!vm.ref<!hal.allocator>, i64, i32, i32, i32, i64) -> !vm.ref<!hal.buffer>
+  %0 = hal.allocator.allocate<%arg0 : !hal.allocator> affinity(%affinity) type("DeviceLocal") usage("DispatchStorage|Transfer") tag(Constant) : !hal.buffer{%size}
+  util.return %0 : !hal.buffer
+}
+
+// -----
+
 // CHECK-LABEL: vm.func private @allocatorImport
 util.func public @allocatorImport(%arg0 : !hal.allocator, %arg1 : !util.buffer) -> (i1, !hal.buffer) {
   // CHECK-DAG: %[[OFFSET:.+]] = vm.const.i64 128
@@ -238,6 +238,49 @@ util.func public @command_buffer_dispatch(
 
 // -----
 
+// CHECK-LABEL: @command_buffer_dispatch_batch
+util.func public @command_buffer_dispatch_batch(
+  %arg0: !hal.command_buffer,
+  %arg1: !hal.executable,
+  %arg2: !hal.executable
+) {
+  // CHECK-DAG: %[[ORDINAL0:.+]] = vm.const.i32 123
+  // CHECK-DAG: %[[ORDINAL1:.+]] = vm.const.i32 456
+  %ordinal0 = arith.constant 123 : index
+  %ordinal1 = arith.constant 456 : index
+  %c1 = arith.constant 1 : index
+  %c100 = arith.constant 100 : index
+  %c200 = arith.constant 200 : index
+  // CHECK: vm.call.variadic @hal.command_buffer.dispatch.batch
+  // CHECK-SAME: (%arg0, [
+  // CHECK-SAME:   (%arg1, %[[ORDINAL0]], %c100, %c1, %c1),
+  // CHECK-SAME:   (%arg2, %[[ORDINAL1]], %c200, %c1, %c1),
+  // CHECK-SAME:   (%arg1, %[[ORDINAL1]], %c100, %c200, %c1)
+  // CHECK-SAME: ]) : (!vm.ref<!hal.command_buffer>, tuple<!vm.ref<!hal.executable>, i32, i32, i32, i32> ...)
+  // CHECK-NOT: vm.call @hal.command_buffer.dispatch(
+  hal.command_buffer.dispatch<%arg0 : !hal.command_buffer>
+      target(%arg1 : !hal.executable)[%ordinal0]
+      workgroups([%c100, %c1, %c1])
+  hal.command_buffer.dispatch<%arg0 : !hal.command_buffer>
+      target(%arg2 : !hal.executable)[%ordinal1]
+      workgroups([%c200, %c1, %c1])
+  hal.command_buffer.dispatch<%arg0 : !hal.command_buffer>
+      target(%arg1 : !hal.executable)[%ordinal1]
+      workgroups([%c100, %c200, %c1])
+  // CHECK: vm.call @hal.command_buffer.execution_barrier
+  hal.command_buffer.execution_barrier<%arg0 : !hal.command_buffer>
+      source("CommandIssue")
+      target("CommandProcess")
+      flags("None")
+  // CHECK: vm.call @hal.command_buffer.dispatch(%arg0, %arg2, %[[ORDINAL0]], %c1, %c1, %c1)
+  hal.command_buffer.dispatch<%arg0 : !hal.command_buffer>
+      target(%arg2 : !hal.executable)[%ordinal0]
+      workgroups([%c1, %c1, %c1])
+  util.return
+}
+
+// -----
+
 // CHECK-LABEL: @command_buffer_dispatch_indirect
 util.func public @command_buffer_dispatch_indirect(
   %arg0: !hal.command_buffer,
@@ -120,6 +120,32 @@ util.func public @device_queue_alloca(
 
 // -----
 
+// CHECK-LABEL: @device_queue_alloca_tagged
+util.func public @device_queue_alloca_tagged(
+    // CHECK-SAME: (%[[DEVICE:.+]]: !vm.ref<!hal.device>, %[[AFFINITY:.+]]: i64,
+    %device: !hal.device, %affinity: i64,
+    // CHECK-SAME:  %[[WAIT_FENCE:.+]]: !vm.ref<!hal.fence>, %[[SIGNAL_FENCE:.+]]: !vm.ref<!hal.fence>,
+    %wait_fence: !hal.fence, %signal_fence: !hal.fence,
+    // CHECK-SAME: %[[SIZE_I32:.+]]: i32)
+    %size: index) -> !hal.buffer {
+  %c100_i64 = arith.constant 100 : i64
+  // CHECK: %[[SIZE_I64:.+]] = vm.ext.i32.i64.s %[[SIZE_I32]]
+  // CHECK: = vm.call @hal.device.queue.alloca.tagged(
+  // CHECK-SAME: %[[DEVICE]], %[[AFFINITY]],
+  // CHECK-SAME: %[[WAIT_FENCE]], %[[SIGNAL_FENCE]],
+  // CHECK-SAME: %c100, %c48, %c3, %c3, %[[SIZE_I64]])
+  %buffer = hal.device.queue.alloca<%device : !hal.device>
+      affinity(%affinity)
+      wait(%wait_fence) signal(%signal_fence)
+      pool(%c100_i64)
+      type(DeviceLocal) usage(Transfer)
+      tag(Transient)
+      : !hal.buffer{%size}
+  util.return %buffer : !hal.buffer
+}
+
+// -----
+
 // CHECK-LABEL: @device_queue_dealloca
 util.func public @device_queue_dealloca(
     // CHECK-SAME: (%[[DEVICE:.+]]: !vm.ref<!hal.device>, %[[AFFINITY:.+]]: i64,
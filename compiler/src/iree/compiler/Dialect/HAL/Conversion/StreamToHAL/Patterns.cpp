@@ -100,9 +100,12 @@ struct ResourceAllocOpPattern
       return failure();
     }
 
+    auto allocationTag = IREE::HAL::AllocationTagAttr::get(
+        rewriter.getContext(), deriveResourceAllocationTag(resourceType));
+
     rewriter.replaceOpWithNewOp<IREE::HAL::AllocatorAllocateOp>(
         allocOp, bufferType, allocator, queueAffinity, memoryTypes, bufferUsage,
-        adaptor.getStorageSize());
+        adaptor.getStorageSize(), allocationTag);
     return success();
   }
 };
@@ -135,9 +138,11 @@ struct ResourceAllocaOpPattern
 
     // Queue allocation.
     auto pool = rewriter.create<arith::ConstantIntOp>(loc, 0, 64);
+    auto allocationTag = IREE::HAL::AllocationTagAttr::get(
+        rewriter.getContext(), deriveResourceAllocationTag(resourceType));
     auto allocateOp = rewriter.create<IREE::HAL::DeviceQueueAllocaOp>(
         loc, bufferType, device, queueAffinity, waitFence, signalFence, pool,
-        memoryTypes, bufferUsage, adaptor.getStorageSize());
+        memoryTypes, bufferUsage, adaptor.getStorageSize(), allocationTag);
 
     rewriter.replaceOp(allocaOp, {allocateOp.getResult(), signalFence});
     return success();
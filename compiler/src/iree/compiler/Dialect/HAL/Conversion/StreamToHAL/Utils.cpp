@@ -244,6 +244,24 @@ deriveAllowedResourceBufferBits(Location loc,
   return success();
 }
 
+IREE::HAL::AllocationTag
+deriveResourceAllocationTag(IREE::Stream::ResourceType resourceType) {
+  switch (resourceType.getLifetime()) {
+  case IREE::Stream::Lifetime::Constant:
+    return IREE::HAL::AllocationTag::Constant;
+  case IREE::Stream::Lifetime::Variable:
+    return IREE::HAL::AllocationTag::Variable;
+  case IREE::Stream::Lifetime::Transient:
+    return IREE::HAL::AllocationTag::Transient;
+  case IREE::Stream::Lifetime::External:
+    return IREE::HAL::AllocationTag::External;
+  case IREE::Stream::Lifetime::Staging:
+    return IREE::HAL::AllocationTag::Staging;
+  default:
+    return IREE::HAL::AllocationTag::Unknown;
+  }
+}
+
 void StreamConversionMapping::mapCommandBuffer(
     IREE::Stream::CmdExecuteOp executeOp, Value commandBuffer) {
   assert(
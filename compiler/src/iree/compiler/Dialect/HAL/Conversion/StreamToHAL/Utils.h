@@ -67,6 +67,11 @@ deriveAllowedResourceBufferBits(Location loc,
                                 IREE::HAL::MemoryTypeBitfield &memoryTypes,
                                 IREE::HAL::BufferUsageBitfield &bufferUsage);
 
+// Maps a resource type to the allocation tag used to attribute allocations of
+// the resource in allocator statistics.
+IREE::HAL::AllocationTag
+deriveResourceAllocationTag(IREE::Stream::ResourceType resourceType);
+
 class StreamConversionMapping {
 public:
   // Maps the stream dialect |executeOp| to the hal dialect |commandBuffer|
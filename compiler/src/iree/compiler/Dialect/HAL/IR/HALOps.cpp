@@ -761,6 +761,8 @@ enum class NumericalType : uint32_t {
   kFloatIEEE = kFloat | 0x01,
   kFloatBrain = kFloat | 0x02,
   kFloatComplex = kFloat | 0x03,
+  kFloat8E5M2 = kFloat | 0x04,
+  kFloat8E4M3FN = kFloat | 0x05,
 };
 
 constexpr inline int32_t makeElementTypeValue(NumericalType numericalType,
@@ -797,6 +799,12 @@ std::optional<int32_t> ElementTypeOp::getTypeValue(Type type) {
     case APFloat::S_BFloat:
       return makeElementTypeValue(NumericalType::kFloatBrain,
                                   floatType.getWidth());
+    case APFloat::S_Float8E5M2:
+      return makeElementTypeValue(NumericalType::kFloat8E5M2,
+                                  floatType.getWidth());
+    case APFloat::S_Float8E4M3FN:
+      return makeElementTypeValue(NumericalType::kFloat8E4M3FN,
+                                  floatType.getWidth());
     default:
       return std::nullopt;
     }
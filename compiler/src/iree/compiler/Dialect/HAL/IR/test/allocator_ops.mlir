@@ -18,6 +18,25 @@ util.func public @allocator_allocate(%allocator: !hal.allocator) {
 
 // -----
 
+// CHECK-LABEL: @allocator_allocate_tagged
+//  CHECK-SAME: (%[[ALLOCATOR:.+]]: !hal.allocator)
+util.func public @allocator_allocate_tagged(%allocator: !hal.allocator) {
+  %affinity = arith.constant -1 : i64
+  // CHECK-DAG: %[[SIZE:.+]] = arith.constant 123
+  %size = arith.constant 123 : index
+  //      CHECK: %[[REF:.+]] = hal.allocator.allocate<%[[ALLOCATOR]] : !hal.allocator>
+  // CHECK-SAME:   type("DeviceVisible|DeviceLocal")
+  // CHECK-SAME:   usage("TransferSource|TransferTarget|Transfer")
+  // CHECK-SAME:   tag(Variable)
+  // CHECK-SAME:   : !hal.buffer{%[[SIZE]]}
+  %ref = hal.allocator.allocate<%allocator : !hal.allocator>
+      affinity(%affinity) type(DeviceLocal) usage(Transfer) tag(Variable)
+      : !hal.buffer{%size}
+  util.return
+}
+
+// -----
+
 // CHECK-LABEL: @allocator_import
 //  CHECK-SAME: %[[ALLOCATOR:.+]]: !hal.allocator
 util.func public @allocator_import(%allocator: !hal.allocator, %arg1: !util.buffer) {
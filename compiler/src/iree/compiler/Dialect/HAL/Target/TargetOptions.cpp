@@ -82,6 +82,23 @@ void TargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Path to write translated and serialized executable binaries into."),
       llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<bool>(
+      "iree-hal-print-executable-timings", printExecutableTimings,
+      llvm::cl::desc("Prints the wall time spent translating and serializing "
+                     "each hal.executable to stderr. Executables are processed "
+                     "in parallel and reported as they complete."),
+      llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<std::string>(
+      "iree-hal-executable-cache-path", executableCachePath,
+      llvm::cl::desc(
+          "Path to a content-addressed cache of translated and serialized "
+          "executables reused across compilations. Entries are keyed on the "
+          "executable IR, target, and compiler version but not on global "
+          "codegen flags: use a different path when changing those or when "
+          "rebuilding a compiler without embedded release information."),
+      llvm::cl::cat(halTargetOptionsCategory));
 }
 
 } // namespace mlir::iree_compiler::IREE::HAL
@@ -49,6 +49,13 @@ struct TargetOptions {
   // A path to write translated and serialized executable binaries into.
   std::string executableBinariesPath;
 
+  // Prints the wall time spent translating and serializing each executable.
+  bool printExecutableTimings = false;
+
+  // A path to an on-disk cache of translated and serialized executables that
+  // is reused across compilations.
+  std::string executableCachePath;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<TargetOptions>;
 };
@@ -153,6 +153,28 @@ struct MaterializeDispatchInstrumentationPass
       initializerBuilder.create<IREE::Util::ReturnOp>(loc);
     }
 
+    // When sampling dispatches the host counts dispatches and marks all but
+    // one in every sampleRate as unsampled by setting the high bit of the
+    // dispatch ID passed to the device. Workgroup sampling happens entirely on
+    // the device and needs no host state.
+    bool isSampling = sampleRate > 1;
+    bool isSamplingDispatches = isSampling && sampleDispatches;
+    IREE::Util::GlobalOp sampleCounterOp;
+    if (isSamplingDispatches) {
+      sampleCounterOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+          loc, "__dispatch_instrumentation_sample_counter",
+          /*isMutable=*/true, i32Type,
+          std::optional<TypedAttr>{moduleBuilder.getI32IntegerAttr(0)});
+      sampleCounterOp.setPrivate();
+    }
+    IntegerAttr sampleRateAttr;
+    UnitAttr sampleDispatchesAttr;
+    if (isSamplingDispatches) {
+      sampleDispatchesAttr = moduleBuilder.getUnitAttr();
+    } else if (isSampling) {
+      sampleRateAttr = moduleBuilder.getI32IntegerAttr(sampleRate);
+    }
+
     FlatbufferBuilder metadataBuilder;
 
     // Update all executable export signatures to include the instrumentation
@@ -203,7 +225,8 @@ struct MaterializeDispatchInstrumentationPass
         auto subspanOp = funcBuilder.create<IREE::Stream::BindingSubspanOp>(
             loc, bufferType, bindingArg, /*byteOffset=*/zero, ValueRange{});
         funcBuilder.create<IREE::HAL::InstrumentWorkgroupOp>(
-            loc, indexType, subspanOp.getResult(), dispatchIdArg);
+            loc, indexType, subspanOp.getResult(), dispatchIdArg,
+            sampleRateAttr, sampleDispatchesAttr);
 
         // Build function metadata.
         auto nameRef = metadataBuilder.createString(exportOp.getName());
@@ -240,6 +263,14 @@ struct MaterializeDispatchInstrumentationPass
         auto bufferArg =
             executeOp.getBody().addArgument(loadedValue.getType(), loc);
 
+        // Load the host dispatch counter used to select sampled dispatches.
+        Value sampleCounter;
+        uint32_t executeDispatchCount = 0;
+        if (isSamplingDispatches) {
+          sampleCounter = sampleCounterOp.createLoadOp(loc, parentBuilder)
+                              .getLoadedGlobalValue();
+        }
+
         // Walk dispatches and pass them the ringbuffer and their unique ID.
         executeOp.walk([&](IREE::Stream::CmdDispatchOp dispatchOp) {
           // NOTE: we just choose the first instrumented export for attribution
@@ -262,10 +293,30 @@ struct MaterializeDispatchInstrumentationPass
           // dispatch ops may reference the same dispatch function after
           // deduplication.
           uint32_t dispatchSiteId = dispatchSiteCount++;
-          dispatchOp.getUniformOperandsMutable().append(
+          Value dispatchIdValue =
               parentBuilder
                   .create<arith::ConstantIntOp>(loc, dispatchSiteId, 32)
-                  .getResult());
+                  .getResult();
+          if (isSamplingDispatches) {
+            // Dispatches are sampled in submission order:
+            //   sampled = (counter + i) % sampleRate == 0
+            Value dispatchIndex = parentBuilder.create<arith::AddIOp>(
+                loc, sampleCounter,
+                parentBuilder.create<arith::ConstantIntOp>(
+                    loc, executeDispatchCount++, 32));
+            Value isSampled = parentBuilder.create<arith::CmpIOp>(
+                loc, arith::CmpIPredicate::eq,
+                parentBuilder.create<arith::RemUIOp>(
+                    loc, dispatchIndex,
+                    parentBuilder.create<arith::ConstantIntOp>(loc, sampleRate,
+                                                               32)),
+                parentBuilder.create<arith::ConstantIntOp>(loc, 0, 32));
+            Value unsampledIdValue = parentBuilder.create<arith::ConstantIntOp>(
+                loc, static_cast<int32_t>(dispatchSiteId | 0x80000000u), 32);
+            dispatchIdValue = parentBuilder.create<arith::SelectOp>(
+                loc, isSampled, dispatchIdValue, unsampledIdValue);
+          }
+          dispatchOp.getUniformOperandsMutable().append(dispatchIdValue);
 
           // Record dispatch site to the host-side metadata.
           iree_instruments_DispatchSiteDef_start(metadataBuilder);
@@ -288,6 +339,15 @@ struct MaterializeDispatchInstrumentationPass
           dispatchOp.setResourceAccessesAttr(
               parentBuilder.getArrayAttr(accesses));
         });
+
+        // Advance the host dispatch counter past all dispatches recorded.
+        if (isSamplingDispatches && executeDispatchCount > 0) {
+          Value newSampleCounter = parentBuilder.create<arith::AddIOp>(
+              loc, sampleCounter,
+              parentBuilder.create<arith::ConstantIntOp>(
+                  loc, executeDispatchCount, 32));
+          sampleCounterOp.createStoreOp(loc, newSampleCounter, parentBuilder);
+        }
       });
     }
 
@@ -303,6 +363,10 @@ struct MaterializeDispatchInstrumentationPass
                                                          dispatchFunctionsRef);
     iree_instruments_DispatchInstrumentDef_sites_add(metadataBuilder,
                                                      dispatchSitesRef);
+    iree_instruments_DispatchInstrumentDef_sample_rate_add(
+        metadataBuilder, isSampling ? sampleRate : 1);
+    iree_instruments_DispatchInstrumentDef_sample_dispatches_add(
+        metadataBuilder, isSamplingDispatches);
     iree_instruments_DispatchInstrumentDef_end_as_root(metadataBuilder);
     auto metadataAttr = metadataBuilder.getBufferAttr(&getContext());
 
@@ -31,6 +31,8 @@ namespace {
 struct MaterializeResourceCachesPass
     : public IREE::HAL::impl::MaterializeResourceCachesPassBase<
           MaterializeResourceCachesPass> {
+  using IREE::HAL::impl::MaterializeResourceCachesPassBase<
+      MaterializeResourceCachesPass>::MaterializeResourceCachesPassBase;
   void runOnOperation() override {
     auto moduleOp = getOperation();
     if (moduleOp.getBody()->empty())
@@ -183,15 +185,68 @@ private:
 
     auto executableType = ExecutableType::get(executableOp.getContext());
     auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
-        loc, symbolName, /*isMutable=*/false, executableType);
+        loc, symbolName, /*isMutable=*/lazyExecutables, executableType);
     globalOp.setPrivate();
     executableCache_.try_emplace(executableOp.getSymName(), globalOp);
 
+    if (lazyExecutables) {
+      defineLazyExecutableLoadOp(executableOp, globalOp);
+      return;
+    }
+
     auto initializerOp = moduleBuilder.create<IREE::Util::InitializerOp>(loc);
     OpBuilder blockBuilder =
         OpBuilder::atBlockEnd(initializerOp.addEntryBlock());
     // TODO(multi-device): pass in resolve info to the call and reuse.
     Value device = IREE::HAL::DeviceType::resolveAny(loc, blockBuilder);
+    Value executableValue =
+        buildExecutableCreate(executableOp, device, blockBuilder);
+    globalOp.createStoreOp(loc, executableValue, blockBuilder);
+    blockBuilder.create<IREE::Util::ReturnOp>(loc);
+  }
+
+  // Defines a function that returns the executable cached in |globalOp| and
+  // creates it on the first call. Executables that are never dispatched are
+  // never loaded and the cost of loading the others is deferred from startup
+  // to their first use.
+  void defineLazyExecutableLoadOp(ExecutableOp executableOp,
+                                  IREE::Util::GlobalOp globalOp) {
+    auto loc = executableOp.getLoc();
+    auto executableType = ExecutableType::get(executableOp.getContext());
+    auto funcName = (StringRef("__load") + globalOp.getSymName()).str();
+    auto funcOp = moduleBuilder.create<IREE::Util::FuncOp>(
+        loc, funcName, moduleBuilder.getFunctionType({}, {executableType}));
+    funcOp.setPrivate();
+    executableLoadFuncs_.try_emplace(executableOp.getSymName(), funcOp);
+
+    OpBuilder blockBuilder = OpBuilder::atBlockEnd(funcOp.addEntryBlock());
+    Value cachedValue =
+        globalOp.createLoadOp(loc, blockBuilder).getLoadedGlobalValue();
+    Value nullValue =
+        blockBuilder.createOrFold<IREE::Util::NullOp>(loc, executableType);
+    Value isNull = blockBuilder.create<IREE::Util::CmpEQOp>(
+        loc, blockBuilder.getI1Type(), cachedValue, nullValue);
+    auto ifOp = blockBuilder.create<scf::IfOp>(loc, executableType, isNull,
+                                               /*addThenBlock=*/true,
+                                               /*addElseBlock=*/true);
+    auto thenBuilder = ifOp.getThenBodyBuilder();
+    // TODO(multi-device): pass in resolve info to the call and reuse.
+    Value device = IREE::HAL::DeviceType::resolveAny(loc, thenBuilder);
+    Value executableValue =
+        buildExecutableCreate(executableOp, device, thenBuilder);
+    globalOp.createStoreOp(loc, executableValue, thenBuilder);
+    thenBuilder.create<scf::YieldOp>(loc, executableValue);
+    auto elseBuilder = ifOp.getElseBodyBuilder();
+    elseBuilder.create<scf::YieldOp>(loc, cachedValue);
+    blockBuilder.create<IREE::Util::ReturnOp>(loc, ifOp.getResult(0));
+  }
+
+  // Builds the selection of the variant of |executableOp| supported by
+  // |device| and its creation and returns the created executable.
+  Value buildExecutableCreate(ExecutableOp executableOp, Value device,
+                              OpBuilder &blockBuilder) {
+    auto loc = executableOp.getLoc();
+    auto executableType = ExecutableType::get(executableOp.getContext());
 
     // Create a switch statement with a case for each variant.
     // Each case should then cache only executables which contain a matching
@@ -264,9 +319,7 @@ private:
         defaultBuilder.createOrFold<IREE::Util::NullOp>(loc, executableType);
     defaultBuilder.create<scf::YieldOp>(loc, nullValue);
 
-    auto executableValue = switchOp.getResult(0);
-    globalOp.createStoreOp(loc, executableValue, blockBuilder);
-    blockBuilder.create<IREE::Util::ReturnOp>(loc);
+    return switchOp.getResult(0);
   }
 
   // Inlines a constant block as a function in |moduleBuilder| and then inserts
@@ -316,6 +369,14 @@ private:
 
   void replaceExecutableLookupOp(ExecutableLookupOp &lookupOp) {
     OpBuilder builder(lookupOp);
+    auto loadFuncIt = executableLoadFuncs_.find(lookupOp.getExecutable());
+    if (loadFuncIt != executableLoadFuncs_.end()) {
+      auto callOp = builder.create<IREE::Util::CallOp>(
+          lookupOp.getLoc(), loadFuncIt->second, ValueRange{});
+      lookupOp.replaceAllUsesWith(callOp.getResult(0));
+      lookupOp.erase();
+      return;
+    }
     auto executableIt = executableCache_.find(lookupOp.getExecutable());
     assert(executableIt != executableCache_.end() &&
            "executable must have been cached");
@@ -332,6 +393,7 @@ private:
       descriptorSetLayoutCache_;
   DenseMap<Attribute, IREE::Util::GlobalOp> pipelineLayoutCache_;
   DenseMap<StringRef, IREE::Util::GlobalOp> executableCache_;
+  DenseMap<StringRef, IREE::Util::FuncOp> executableLoadFuncs_;
 
   int nextUniqueConstantBlockId = 0;
   int nextUniquePipelineLayoutId = 0;
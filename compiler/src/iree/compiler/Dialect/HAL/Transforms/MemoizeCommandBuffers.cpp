@@ -0,0 +1,283 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SetVector.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir::iree_compiler::IREE::HAL {
+
+#define GEN_PASS_DEF_MEMOIZECOMMANDBUFFERSPASS
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h.inc"
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// --iree-hal-memoize-command-buffers
+//===----------------------------------------------------------------------===//
+
+// Tracks which values are identical on every invocation of the program such as
+// constants, immutable globals and pure computations derived from them.
+class InvariantValueAnalysis {
+public:
+  explicit InvariantValueAnalysis(ModuleOp moduleOp) : symbolTable(moduleOp) {}
+
+  bool isInvariant(Value value) {
+    auto it = cache.find(value);
+    if (it != cache.end())
+      return it->second;
+    // Insert a conservative value first to terminate on cycles.
+    cache[value] = false;
+    bool result = computeIsInvariant(value);
+    cache[value] = result;
+    return result;
+  }
+
+private:
+  bool computeIsInvariant(Value value) {
+    Operation *definingOp = value.getDefiningOp();
+    if (!definingOp || definingOp->getNumRegions() != 0)
+      return false;
+    if (matchPattern(value, m_Constant()))
+      return true;
+    if (auto loadOp = dyn_cast<IREE::Util::GlobalLoadOpInterface>(definingOp)) {
+      auto globalOp = symbolTable.lookup<IREE::Util::GlobalOpInterface>(
+          loadOp.getGlobalName());
+      return globalOp && !globalOp.isGlobalMutable();
+    }
+    if (!isMemoryEffectFree(definingOp))
+      return false;
+    return llvm::all_of(definingOp->getOperands(),
+                        [&](Value operand) { return isInvariant(operand); });
+  }
+
+  SymbolTable symbolTable;
+  DenseMap<Value, bool> cache;
+};
+
+// A command buffer whose recording can be hoisted into an initializer.
+struct MemoizableCommandBuffer {
+  IREE::HAL::CommandBufferCreateOp createOp;
+  IREE::HAL::CommandBufferFinalizeOp finalizeOp;
+  // Ops between the create and the finalize that record into the command
+  // buffer, in order.
+  SmallVector<Operation *> recordingOps;
+  // Values defined outside of the recording that it captures.
+  SetVector<Value> capturedValues;
+};
+
+// Returns true if |op| may be moved into the recording initializer. Only ops
+// recording commands, loads of invariant globals and ops without side effects
+// are allowed.
+static bool isRecordingCompatibleOp(Operation *op,
+                                    InvariantValueAnalysis &invariantValues) {
+  if (isa<IREE::HAL::HALDialect>(op->getDialect()) &&
+      llvm::any_of(op->getOperandTypes(), [](Type type) {
+        return isa<IREE::HAL::CommandBufferType>(type);
+      })) {
+    return true;
+  }
+  if (auto loadOp = dyn_cast<IREE::Util::GlobalLoadOpInterface>(op))
+    return invariantValues.isInvariant(loadOp.getLoadedGlobalValue());
+  if (op->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+    return true;
+  return isMemoryEffectFree(op);
+}
+
+// Matches the command buffer created by |createOp| if its recording only
+// depends on invocation-invariant values.
+static std::optional<MemoizableCommandBuffer>
+matchMemoizableCommandBuffer(IREE::HAL::CommandBufferCreateOp createOp,
+                             InvariantValueAnalysis &invariantValues) {
+  // Only one-shot command buffers are created per invocation today.
+  if (!bitEnumContainsAll(createOp.getModes(),
+                          IREE::HAL::CommandBufferModeBitfield::OneShot)) {
+    return std::nullopt;
+  }
+  if (!invariantValues.isInvariant(createOp.getDevice()) ||
+      (createOp.getBindingCapacity() &&
+       !invariantValues.isInvariant(createOp.getBindingCapacity()))) {
+    return std::nullopt;
+  }
+
+  // Find the finalize op ending the recording in the same block.
+  MemoizableCommandBuffer match;
+  match.createOp = createOp;
+  for (Operation *user : createOp.getResult().getUsers()) {
+    auto finalizeOp = dyn_cast<IREE::HAL::CommandBufferFinalizeOp>(user);
+    if (!finalizeOp)
+      continue;
+    if (match.finalizeOp || finalizeOp->getBlock() != createOp->getBlock())
+      return std::nullopt;
+    match.finalizeOp = finalizeOp;
+  }
+  if (!match.finalizeOp)
+    return std::nullopt;
+
+  // All ops in between make up the recording. Everything they use must either
+  // be defined by the recording itself or be invariant.
+  for (Operation *op = createOp->getNextNode(); op != match.finalizeOp;
+       op = op->getNextNode()) {
+    match.recordingOps.push_back(op);
+  }
+  auto isInRecording = [&](Operation *op) {
+    Operation *ancestor = createOp->getBlock()->findAncestorOpInBlock(*op);
+    return ancestor && (ancestor == createOp.getOperation() ||
+                        llvm::is_contained(match.recordingOps, ancestor));
+  };
+  for (Operation *recordingOp : match.recordingOps) {
+    WalkResult walkResult = recordingOp->walk([&](Operation *op) {
+      if (!isRecordingCompatibleOp(op, invariantValues))
+        return WalkResult::interrupt();
+      for (Value operand : op->getOperands()) {
+        if (operand == createOp.getResult())
+          continue;
+        Operation *definingOp = operand.getDefiningOp();
+        Operation *parentOp =
+            definingOp ? definingOp
+                       : operand.getParentRegion()->getParentOp();
+        if (isInRecording(parentOp))
+          continue;
+        if (!invariantValues.isInvariant(operand))
+          return WalkResult::interrupt();
+        match.capturedValues.insert(operand);
+      }
+      return WalkResult::advance();
+    });
+    if (walkResult.wasInterrupted())
+      return std::nullopt;
+
+    // Values produced during recording must not escape it.
+    for (Value result : recordingOp->getResults()) {
+      if (llvm::any_of(result.getUsers(), [&](Operation *user) {
+            return !isInRecording(user);
+          })) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  // The command buffer may only be submitted after it has been finalized.
+  for (Operation *user : createOp.getResult().getUsers()) {
+    if (isInRecording(user) || user == match.finalizeOp)
+      continue;
+    if (!isa<IREE::HAL::DeviceQueueExecuteOp>(user) ||
+        user->getBlock() != createOp->getBlock() ||
+        user->isBeforeInBlock(match.finalizeOp)) {
+      return std::nullopt;
+    }
+  }
+  return match;
+}
+
+// Clones |value| and the invariant computation it is derived from at
+// |builder|'s insertion point.
+static Value cloneInvariantValue(Value value, IRMapping &mapping,
+                                 OpBuilder &builder) {
+  if (Value mappedValue = mapping.lookupOrNull(value))
+    return mappedValue;
+  Operation *definingOp = value.getDefiningOp();
+  for (Value operand : definingOp->getOperands())
+    cloneInvariantValue(operand, mapping, builder);
+  builder.clone(*definingOp, mapping);
+  return mapping.lookup(value);
+}
+
+// Records the command buffer in an initializer storing it in a new global and
+// replaces the per-invocation recording with a load of the global.
+static void memoizeCommandBuffer(MemoizableCommandBuffer &match,
+                                 StringRef name, SymbolTable &symbolTable,
+                                 OpBuilder &moduleBuilder) {
+  IREE::HAL::CommandBufferCreateOp createOp = match.createOp;
+  Location loc = createOp.getLoc();
+  auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+      loc, name, /*isMutable=*/false, createOp.getType());
+  globalOp.setPrivate();
+  symbolTable.insert(globalOp);
+
+  auto initializerOp = moduleBuilder.create<IREE::Util::InitializerOp>(loc);
+  auto initializerBuilder =
+      OpBuilder::atBlockBegin(initializerOp.addEntryBlock());
+  IRMapping mapping;
+  for (Value capturedValue : match.capturedValues)
+    cloneInvariantValue(capturedValue, mapping, initializerBuilder);
+  Value device =
+      cloneInvariantValue(createOp.getDevice(), mapping, initializerBuilder);
+  Value bindingCapacity =
+      createOp.getBindingCapacity()
+          ? cloneInvariantValue(createOp.getBindingCapacity(), mapping,
+                                initializerBuilder)
+          : Value{};
+
+  // The command buffer is submitted many times so it can neither be one-shot
+  // nor execute inline while recording.
+  auto modes = bitEnumClear(
+      createOp.getModes(),
+      IREE::HAL::CommandBufferModeBitfield::OneShot |
+          IREE::HAL::CommandBufferModeBitfield::AllowInlineExecution);
+  auto newCreateOp =
+      initializerBuilder.create<IREE::HAL::CommandBufferCreateOp>(
+          loc, createOp.getType(), device, modes,
+          createOp.getCommandCategories(), bindingCapacity);
+  mapping.map(createOp.getResult(), newCreateOp.getResult());
+  for (Operation *recordingOp : match.recordingOps)
+    initializerBuilder.clone(*recordingOp, mapping);
+  initializerBuilder.clone(*match.finalizeOp, mapping);
+  globalOp.createStoreOp(loc, newCreateOp.getResult(), initializerBuilder);
+  initializerBuilder.create<IREE::Util::ReturnOp>(loc);
+
+  // Submissions now use the memoized command buffer.
+  OpBuilder replaceBuilder(createOp);
+  auto loadOp = globalOp.createLoadOp(loc, replaceBuilder);
+  match.finalizeOp.erase();
+  for (Operation *recordingOp : llvm::reverse(match.recordingOps))
+    recordingOp->erase();
+  createOp.replaceAllUsesWith(loadOp.getLoadedGlobalValue());
+  createOp.erase();
+}
+
+struct MemoizeCommandBuffersPass
+    : public IREE::HAL::impl::MemoizeCommandBuffersPassBase<
+          MemoizeCommandBuffersPass> {
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    InvariantValueAnalysis invariantValues(moduleOp);
+
+    // Initializers already run once so there is nothing to memoize in them.
+    SmallVector<MemoizableCommandBuffer> matches;
+    for (auto funcOp : moduleOp.getOps<IREE::Util::FuncOp>()) {
+      funcOp.walk([&](IREE::HAL::CommandBufferCreateOp createOp) {
+        if (auto match =
+                matchMemoizableCommandBuffer(createOp, invariantValues)) {
+          matches.push_back(std::move(*match));
+        }
+      });
+    }
+
+    // Initializers are appended to the module so that they run after the ones
+    // initializing the globals the recordings depend on.
+    SymbolTable symbolTable(moduleOp);
+    auto moduleBuilder = OpBuilder::atBlockEnd(moduleOp.getBody());
+    for (auto [index, match] : llvm::enumerate(matches)) {
+      memoizeCommandBuffer(match, "_command_buffer_" + std::to_string(index),
+                           symbolTable, moduleBuilder);
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::HAL
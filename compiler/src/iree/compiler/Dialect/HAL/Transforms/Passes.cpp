@@ -55,6 +55,21 @@ static llvm::cl::opt<unsigned> clBenchmarkDispatchRepeatCount{
     llvm::cl::init(1),
 };
 
+static llvm::cl::opt<bool> clMemoizeCommandBuffers{
+    "iree-hal-memoize-command-buffers",
+    llvm::cl::desc("Records command buffers whose commands are the same on "
+                   "every invocation once on startup and reuses them."),
+    llvm::cl::init(false),
+};
+
+static llvm::cl::opt<bool> clLazyExecutableLoading{
+    "iree-hal-lazy-executable-loading",
+    llvm::cl::desc("Loads each executable the first time it is dispatched "
+                   "instead of on startup so that startup time and resident "
+                   "memory scale with the executables actually used."),
+    llvm::cl::init(false),
+};
+
 static llvm::cl::opt<llvm::cl::PowerOf2ByteSize> clInstrumentDispatchBufferSize{
     "iree-hal-instrument-dispatches",
     llvm::cl::desc("Enables dispatch instrumentation with a power-of-two byte "
@@ -62,6 +77,23 @@ static llvm::cl::opt<llvm::cl::PowerOf2ByteSize> clInstrumentDispatchBufferSize{
     llvm::cl::init(llvm::cl::PowerOf2ByteSize(0)),
 };
 
+static llvm::cl::opt<unsigned> clInstrumentDispatchSampleRate{
+    "iree-hal-instrument-dispatches-sample-rate",
+    llvm::cl::desc("Records dispatch instrumentation for only one in every N "
+                   "workgroups (or dispatches with "
+                   "--iree-hal-instrument-dispatches-sample-dispatches). "
+                   "Reduces overhead enough to leave instrumentation enabled "
+                   "in production when combined with runtime draining."),
+    llvm::cl::init(1),
+};
+
+static llvm::cl::opt<bool> clInstrumentDispatchSampleDispatches{
+    "iree-hal-instrument-dispatches-sample-dispatches",
+    llvm::cl::desc("Samples whole dispatches instead of individual workgroups "
+                   "when --iree-hal-instrument-dispatches-sample-rate is set."),
+    llvm::cl::init(false),
+};
+
 static llvm::cl::list<std::string> clSubstituteExecutableSource{
     "iree-hal-substitute-executable-source",
     llvm::cl::desc(
@@ -218,7 +250,8 @@ void buildHALConfigurationPassPipeline(OpPassManager &passManager,
   // more easily mutate the stream dispatch ops and exports.
   if (auto bufferSize = clInstrumentDispatchBufferSize.getValue()) {
     passManager.addPass(IREE::HAL::createMaterializeDispatchInstrumentationPass(
-        {bufferSize.value}));
+        {bufferSize.value, clInstrumentDispatchSampleRate,
+         clInstrumentDispatchSampleDispatches}));
   }
 
   // Each executable needs a hal.interface to specify how the host and
@@ -364,7 +397,9 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
 
   if (compileFrom < PipelinePhase::ExecutableTargets) {
     passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-        IREE::HAL::createTranslateExecutablesPass({targetRegistry}));
+        IREE::HAL::createTranslateExecutablesPass(
+            {targetRegistry, targetOptions.printExecutableTimings,
+             targetOptions.executableCachePath}));
   }
 
   // If debug information is requested capture the translated MLIR source text
@@ -428,8 +463,9 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   passManager.addPass(IREE::HAL::createResolveExportOrdinalsPass());
 
   // Gather cacheable resources such as executables and descriptor sets and
-  // cache them at initialization-time.
-  passManager.addPass(IREE::HAL::createMaterializeResourceCachesPass());
+  // cache them at initialization-time (or first use of lazy executables).
+  passManager.addPass(IREE::HAL::createMaterializeResourceCachesPass(
+      {clLazyExecutableLoading}));
 
   //----------------------------------------------------------------------------
   // Device management and specialization
@@ -456,6 +492,12 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   FunctionLikeNest(passManager)
       .addPass(IREE::HAL::createElideRedundantCommandsPass);
 
+  // Hoist the recording of invocation-invariant command buffers into
+  // initializers so that they are only recorded once.
+  if (clMemoizeCommandBuffers) {
+    passManager.addPass(IREE::HAL::createMemoizeCommandBuffersPass());
+  }
+
   // TODO: Maybe this should be a part of Affine lowering pass.
   // Remove if it is added there.
   // https://github.com/llvm/llvm-project/issues/78458
@@ -483,7 +525,9 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
         IREE::HAL::createSerializeExecutablesPass(
             {&targetRegistry, targetOptions.debugLevel,
              targetOptions.executableIntermediatesPath,
-             targetOptions.executableBinariesPath}));
+             targetOptions.executableBinariesPath,
+             targetOptions.printExecutableTimings,
+             targetOptions.executableCachePath}));
 
     // NOTE: symbol DCE will destroy executable target contents, so only run
     // it if we serialized things.
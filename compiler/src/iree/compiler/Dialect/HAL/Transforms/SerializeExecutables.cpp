@@ -4,7 +4,9 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
@@ -12,9 +14,11 @@
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/HAL/Utils/ExecutableCache.h"
 #include "iree/compiler/Utils/TracingUtils.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/Diagnostics.h"
@@ -75,21 +79,59 @@ struct SerializeTargetExecutablesPass
       llvm::sys::fs::create_directories(dumpBinariesPath);
     }
 
+    // Reuse serialized binaries from prior compilations. The cache is bypassed
+    // when dumping as the dumped files are only produced by serialization.
+    std::optional<ExecutableCache> cache;
+    if (!cachePath.empty() && dumpIntermediatesPath.empty() &&
+        dumpBinariesPath.empty()) {
+      cache.emplace(cachePath);
+    }
+    std::string debugLevelKey = std::to_string(debugLevel);
+
     auto variantOps = llvm::to_vector(
         executableOp.getBlock().getOps<IREE::HAL::ExecutableVariantOp>());
     for (auto variantOp : variantOps) {
       if (variantOp.getTarget().getBackend().getValue() != target)
         continue;
       OpBuilder executableBuilder(variantOp);
+
+      std::string cacheKey;
+      if (cache) {
+        cacheKey = ExecutableCache::computeKey(
+            variantOp, {"serialize", target, debugLevelKey});
+        if (auto cachedModuleOp = cache->load(&getContext(), cacheKey)) {
+          auto cachedExecutableOp =
+              ExecutableCache::getCachedExecutable(*cachedModuleOp);
+          for (auto &cachedOp :
+               cachedExecutableOp.getBlock().without_terminator()) {
+            executableBuilder.clone(cachedOp);
+          }
+          variantOp.erase();
+          continue;
+        }
+      }
+
       // Ask the target backend to serialize the executable. Note that it
       // may create one or more hal.executable.binary ops in the case of
       // multi-architecture binaries.
+      Operation *prevOp = variantOp->getPrevNode();
       if (failed(targetBackend->serializeExecutable(
               serializationOptions, variantOp, executableBuilder))) {
         variantOp.emitError()
             << "failed to serialize executable for target backend " << target;
         return signalPassFailure();
       }
+
+      if (cache) {
+        SmallVector<Operation *> binaryOps;
+        for (Operation *op = prevOp ? prevOp->getNextNode()
+                                    : &executableOp.getBlock().front();
+             op != variantOp; op = op->getNextNode()) {
+          binaryOps.push_back(op);
+        }
+        cache->store(variantOp.getLoc(), cacheKey, binaryOps);
+      }
+
       variantOp.erase();
     }
   }
@@ -110,15 +152,26 @@ struct SerializeExecutablesPass
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addPass(IREE::HAL::createSerializeTargetExecutablesPass(
           {targetRegistry, targetName, debugLevel, dumpIntermediatesPath,
-           dumpBinariesPath}));
+           dumpBinariesPath, cachePath}));
     }
 
     IREE_COMPILER_TRACE_MESSAGE_DYNAMIC(INFO, executableOp.getSymName().str());
 
+    auto startTime = std::chrono::steady_clock::now();
     if (failed(runPipeline(passManager, executableOp))) {
       executableOp.emitError() << "failed to serialize executables";
       return signalPassFailure();
     }
+
+    // Executables are processed in parallel so the line is formatted before
+    // writing to keep the reports from interleaving.
+    if (printTimings) {
+      std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - startTime;
+      llvm::errs() << llvm::formatv("[{0}] @{1}: {2:F2} ms\n", getArgument(),
+                                    executableOp.getSymName(), elapsed.count())
+                          .str();
+    }
   }
 };
 
@@ -4,7 +4,9 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
@@ -12,8 +14,10 @@
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/HAL/Utils/ExecutableCache.h"
 #include "iree/compiler/Utils/TracingUtils.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -62,6 +66,27 @@ struct TranslateTargetExecutableVariantsPass
       return signalPassFailure();
     }
 
+    // Reuse the translated variant from a prior compilation if the source
+    // variant is unchanged.
+    std::optional<ExecutableCache> cache;
+    std::string cacheKey;
+    if (!cachePath.empty()) {
+      cache.emplace(cachePath);
+      cacheKey = ExecutableCache::computeKey(variantOp, {"translate", target});
+      if (auto cachedModuleOp = cache->load(&getContext(), cacheKey)) {
+        auto cachedExecutableOp =
+            ExecutableCache::getCachedExecutable(*cachedModuleOp);
+        auto cachedVariantOps =
+            cachedExecutableOp.getOps<IREE::HAL::ExecutableVariantOp>();
+        if (!cachedVariantOps.empty()) {
+          auto cachedVariantOp = *cachedVariantOps.begin();
+          variantOp->setAttrs(cachedVariantOp->getAttrDictionary());
+          variantOp.getBody().takeBody(cachedVariantOp.getBody());
+          return;
+        }
+      }
+    }
+
     OpPassManager passManager(variantOp.getOperationName());
     targetBackend->buildTranslationPassPipeline(variantOp.getTargetAttr(),
                                                 passManager);
@@ -71,6 +96,10 @@ struct TranslateTargetExecutableVariantsPass
                             << variantOp.getTarget();
       return signalPassFailure();
     }
+
+    if (cache) {
+      cache->store(variantOp.getLoc(), cacheKey, {variantOp});
+    }
   }
 };
 
@@ -100,15 +129,26 @@ struct TranslateExecutablesPass
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addNestedPass<IREE::HAL::ExecutableVariantOp>(
           IREE::HAL::createTranslateTargetExecutableVariantsPass(
-              {targetRegistry, targetName}));
+              {targetRegistry, targetName, cachePath}));
     }
 
     IREE_COMPILER_TRACE_MESSAGE_DYNAMIC(INFO, executableOp.getSymName().str());
 
+    auto startTime = std::chrono::steady_clock::now();
     if (failed(runPipeline(passManager, executableOp))) {
       llvm::errs() << "failed to translate executables\n";
       return signalPassFailure();
     }
+
+    // Executables are processed in parallel so the line is formatted before
+    // writing to keep the reports from interleaving.
+    if (printTimings) {
+      std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - startTime;
+      llvm::errs() << llvm::formatv("[{0}] @{1}: {2:F2} ms\n", getArgument(),
+                                    executableOp.getSymName(), elapsed.count())
+                          .str();
+    }
   }
 };
 
@@ -1,4 +1,5 @@
 // RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(iree-hal-materialize-dispatch-instrumentation{buffer-size=64mib})' %s | FileCheck %s
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(iree-hal-materialize-dispatch-instrumentation{buffer-size=64mib sample-rate=4 sample-dispatches=true})' %s | FileCheck %s --check-prefix=SAMPLED
 
 module attributes {hal.device.targets = [
   #hal.device.target<"llvm-cpu", [
@@ -14,6 +15,9 @@ module attributes {hal.device.targets = [
   // CHECK:   %[[ALLOC_BUFFER:.+]] = stream.resource.alloc uninitialized : !stream.resource<external>{%[[DEFAULT_SIZE]]}
   // CHECK:   util.global.store %[[ALLOC_BUFFER]], @__dispatch_instrumentation
 
+  // Sampling dispatches counts dispatches on the host:
+  // SAMPLED: util.global private mutable @__dispatch_instrumentation_sample_counter = 0 : i32
+
   // Query function used by tools to get the buffers and metadata:
   // CHECK: util.func public @__query_instruments(%[[LIST:.+]]: !util.list<?>)
   // CHECK:   %[[INTERNAL_BUFFER:.+]] = util.global.load @__dispatch_instrumentation
@@ -38,6 +42,7 @@ module attributes {hal.device.targets = [
         // Subsequent dispatch instruments will use the workgroup key.
         // CHECK: %[[INSTR_BUFFER:.+]] = stream.binding.subspan %[[INSTR_BINDING]]
         // CHECK: %[[WORKGROUP_KEY:.+]] = hal.instrument.workgroup[%[[INSTR_BUFFER]] : memref<67112960xi8>] dispatch(%[[SITE_ID]]) : index
+        // SAMPLED: hal.instrument.workgroup[{{.+}}] dispatch(%{{.+}}) {sample_dispatches} : index
         %c0 = arith.constant 0 : index
         %cst = arith.constant 2.000000e+00 : f32
         %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:tensor<f32>>
@@ -62,6 +67,16 @@ module attributes {hal.device.targets = [
     // Note that there's no synchronization here (no timepoint waits/etc) as
     // all accesses to the buffer are atomic.
     // CHECK: %[[EXECUTE_BUFFER:.+]] = util.global.load @__dispatch_instrumentation
+    // Unsampled dispatches have the high bit of their site ID set:
+    // SAMPLED: %[[COUNTER:.+]] = util.global.load @__dispatch_instrumentation_sample_counter : i32
+    // SAMPLED: %[[INDEX:.+]] = arith.addi %[[COUNTER]]
+    // SAMPLED: %[[REM:.+]] = arith.remui %[[INDEX]]
+    // SAMPLED: %[[IS_SAMPLED:.+]] = arith.cmpi eq, %[[REM]]
+    // SAMPLED: %[[SAMPLED_ID:.+]] = arith.select %[[IS_SAMPLED]]
+    // SAMPLED: %[[NEXT_COUNTER:.+]] = arith.addi %[[COUNTER]]
+    // SAMPLED: util.global.store %[[NEXT_COUNTER]], @__dispatch_instrumentation_sample_counter
+    // SAMPLED: stream.cmd.execute
+    // SAMPLED: stream.cmd.dispatch @executable::@dispatch(%[[SAMPLED_ID]] : i32)
     // CHECK: stream.cmd.execute
     // CHECK-SAME: %[[EXECUTE_BUFFER]] as %[[CAPTURE_BUFFER:.+]]: !stream.resource<external>{%[[DEFAULT_SIZE]]})
     %timepoint = stream.cmd.execute with(%arg0 as %arg0_capture: !stream.resource<external>{%c128}, %ret0 as %ret0_capture: !stream.resource<external>{%c128}) {
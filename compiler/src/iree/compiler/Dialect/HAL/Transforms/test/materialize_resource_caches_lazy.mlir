@@ -0,0 +1,54 @@
+// RUN: iree-opt --pass-pipeline='builtin.module(iree-hal-materialize-resource-caches{lazy-executables=true})' %s | FileCheck %s
+
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>
+  ]>
+]>
+
+hal.executable @exe {
+  hal.executable.variant @vmvx target(<"vmvx", "vmvx-bytecode-fb">) {
+    hal.executable.export @entry ordinal(0) layout(#pipeline_layout) attributes {
+      workgroup_size = [32 : index, 1 : index, 1 : index]
+    }
+  }
+}
+
+// Pipeline layouts are still created on startup.
+// CHECK: util.global private @_pipeline_layout_0 : !hal.pipeline_layout
+// CHECK-NEXT: util.initializer
+
+// Executables are stored in a mutable global populated on first use.
+// CHECK: util.global private mutable @_executable_exe : !hal.executable
+// CHECK-NOT: util.initializer
+// CHECK: util.func private @__load_executable_exe() -> !hal.executable
+// CHECK:   %[[CACHED:.+]] = util.global.load @_executable_exe : !hal.executable
+// CHECK:   %[[NULL:.+]] = util.null : !hal.executable
+// CHECK:   %[[IS_NULL:.+]] = util.cmp.eq %[[CACHED]], %[[NULL]] : !hal.executable
+// CHECK:   %[[EXE:.+]] = scf.if %[[IS_NULL]] -> (!hal.executable) {
+// CHECK:     %[[DEVICE:.+]] = hal.devices.get %{{.+}}
+// CHECK:     %[[SELECTED:.+]] = scf.index_switch %{{.+}} -> !hal.executable
+// CHECK:     case 0 {
+// CHECK:       %[[LAYOUT:.+]] = util.global.load @_pipeline_layout_0 : !hal.pipeline_layout
+// CHECK:       %[[CREATED:.+]] = hal.executable.create
+// CHECK-SAME:    device(%[[DEVICE]] : !hal.device)
+// CHECK-SAME:    target(@exe::@vmvx)
+// CHECK-SAME:    layouts([%[[LAYOUT]]])
+// CHECK:       scf.yield %[[CREATED]] : !hal.executable
+// CHECK:     }
+// CHECK:     util.global.store %[[SELECTED]], @_executable_exe : !hal.executable
+// CHECK:     scf.yield %[[SELECTED]] : !hal.executable
+// CHECK:   } else {
+// CHECK:     scf.yield %[[CACHED]] : !hal.executable
+// CHECK:   }
+// CHECK:   util.return %[[EXE]] : !hal.executable
+
+// CHECK-LABEL: @exeLookup
+util.func public @exeLookup(%device : !hal.device) -> !hal.executable {
+  // CHECK: %[[EXE:.+]] = util.call @__load_executable_exe() : () -> !hal.executable
+  %0 = hal.executable.lookup device(%device : !hal.device)
+                             executable(@exe) : !hal.executable
+  // CHECK-NEXT: util.return %[[EXE]]
+  util.return %0 : !hal.executable
+}
@@ -0,0 +1,80 @@
+// RUN: iree-opt --split-input-file --iree-hal-memoize-command-buffers %s | FileCheck %s
+
+// Tests that a command buffer only referencing constant resources is recorded
+// once in an initializer and reused on each invocation.
+
+util.global private @device : !hal.device
+util.global private @layout : !hal.pipeline_layout
+util.global private @executable : !hal.executable
+util.global private @constant_buffer : !hal.buffer
+
+// CHECK-LABEL: util.func public @invariant_recording
+// CHECK-SAME: (%[[WAIT:.+]]: !hal.fence, %[[SIGNAL:.+]]: !hal.fence)
+util.func public @invariant_recording(%wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  %c-1_i64 = arith.constant -1 : i64
+  // CHECK: %[[DEVICE:.+]] = util.global.load @device
+  %device = util.global.load @device : !hal.device
+  %layout = util.global.load @layout : !hal.pipeline_layout
+  %executable = util.global.load @executable : !hal.executable
+  %buffer = util.global.load @constant_buffer : !hal.buffer
+  // CHECK-NOT: hal.command_buffer.create
+  // CHECK-NOT: hal.command_buffer.dispatch
+  // CHECK: %[[CMD:.+]] = util.global.load @_command_buffer_0 : !hal.command_buffer
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer>
+      layout(%layout : !hal.pipeline_layout)[%c0]
+      bindings([
+        %c0 = (%buffer : !hal.buffer)[%c0, %c128]
+      ])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer>
+      target(%executable : !hal.executable)[%c0]
+      workgroups([%c1, %c1, %c1])
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  // CHECK: hal.device.queue.execute<%[[DEVICE]] : !hal.device>
+  // CHECK-SAME: wait(%[[WAIT]]) signal(%[[SIGNAL]])
+  // CHECK-SAME: commands([%[[CMD]]])
+  hal.device.queue.execute<%device : !hal.device> affinity(%c-1_i64) wait(%wait) signal(%signal) commands([%cmd])
+  util.return
+}
+
+//      CHECK: util.global private @_command_buffer_0 : !hal.command_buffer
+// CHECK-NEXT: util.initializer {
+//      CHECK:   %[[INIT_DEVICE:.+]] = util.global.load @device
+//      CHECK:   %[[INIT_CMD:.+]] = hal.command_buffer.create device(%[[INIT_DEVICE]] : !hal.device) mode("None") categories("Transfer|Dispatch")
+//      CHECK:   hal.command_buffer.push_descriptor_set<%[[INIT_CMD]] : !hal.command_buffer>
+//      CHECK:   hal.command_buffer.dispatch<%[[INIT_CMD]] : !hal.command_buffer>
+//      CHECK:   hal.command_buffer.finalize<%[[INIT_CMD]] : !hal.command_buffer>
+//      CHECK:   util.global.store %[[INIT_CMD]], @_command_buffer_0 : !hal.command_buffer
+
+// -----
+
+// Tests that command buffers referencing per-invocation buffers are recorded
+// on each invocation.
+
+util.global private @device : !hal.device
+util.global private @layout : !hal.pipeline_layout
+
+// CHECK-LABEL: util.func public @variant_recording
+util.func public @variant_recording(%buffer: !hal.buffer, %wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c128 = arith.constant 128 : index
+  %c-1_i64 = arith.constant -1 : i64
+  %device = util.global.load @device : !hal.device
+  %layout = util.global.load @layout : !hal.pipeline_layout
+  // CHECK: hal.command_buffer.create
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  // CHECK: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer>
+      layout(%layout : !hal.pipeline_layout)[%c0]
+      bindings([
+        %c0 = (%buffer : !hal.buffer)[%c0, %c128]
+      ])
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  hal.device.queue.execute<%device : !hal.device> affinity(%c-1_i64) wait(%wait) signal(%signal) commands([%cmd])
+  util.return
+}
+
+// CHECK-NOT: util.initializer
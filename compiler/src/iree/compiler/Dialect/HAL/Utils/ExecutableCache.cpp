@@ -0,0 +1,142 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/HAL/Utils/ExecutableCache.h"
+
+#include "iree/compiler/Tools/version.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
+#include "mlir/Parser/Parser.h"
+
+namespace mlir::iree_compiler::IREE::HAL {
+
+// Name of the hal.executable wrapping cached ops. Arbitrary as it is never
+// referenced.
+static constexpr StringLiteral kCachedExecutableName = "cached";
+
+static void updateHash(llvm::SHA256 &hasher, StringRef value) {
+  // Length-prefix each part so that concatenations cannot collide.
+  uint64_t length = value.size();
+  hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(&length),
+                                  sizeof(length)));
+  hasher.update(value);
+}
+
+// static
+std::string ExecutableCache::computeKey(Operation *op,
+                                        ArrayRef<StringRef> keyParts) {
+  llvm::SHA256 hasher;
+
+  // Compiler builds without embedded release info have no version and the
+  // cache must be cleared by the user when the compiler changes.
+  updateHash(hasher, getIreeRevision());
+  for (auto keyPart : keyParts) {
+    updateHash(hasher, keyPart);
+  }
+
+  // Locations are included as they may be embedded in the results as debug
+  // information. Printing with a local scope inlines all aliases and gives the
+  // same output regardless of the surrounding IR.
+  std::string irText;
+  {
+    llvm::raw_string_ostream os(irText);
+    op->print(os, OpPrintingFlags()
+                      .printGenericOpForm()
+                      .useLocalScope()
+                      .enableDebugInfo(/*enable=*/true,
+                                       /*prettyForm=*/false));
+  }
+  updateHash(hasher, irText);
+
+  // Resource blobs are only printed by handle and their contents must be
+  // hashed separately.
+  op->walk([&](Operation *nestedOp) {
+    nestedOp->getAttrDictionary().walk([&](DenseResourceElementsAttr attr) {
+      if (auto *blob = attr.getRawHandle().getBlob()) {
+        ArrayRef<char> data = blob->getData();
+        updateHash(hasher, StringRef(data.data(), data.size()));
+      }
+    });
+  });
+
+  return llvm::toHex(hasher.final(), /*LowerCase=*/true);
+}
+
+std::string ExecutableCache::getEntryPath(StringRef key) const {
+  SmallString<256> entryPath(path);
+  llvm::sys::path::append(entryPath, key + ".mlirbc");
+  return std::string(entryPath);
+}
+
+OwningOpRef<ModuleOp> ExecutableCache::load(MLIRContext *context,
+                                            StringRef key) const {
+  auto fileOr = llvm::MemoryBuffer::getFile(getEntryPath(key));
+  if (!fileOr) {
+    return {};
+  }
+  llvm::SourceMgr sourceMgr;
+  sourceMgr.AddNewSourceBuffer(std::move(*fileOr), llvm::SMLoc());
+  auto moduleOp = parseSourceFile<ModuleOp>(sourceMgr, ParserConfig(context));
+  if (!moduleOp || !getCachedExecutable(*moduleOp)) {
+    return {};
+  }
+  return moduleOp;
+}
+
+void ExecutableCache::store(Location loc, StringRef key,
+                            ArrayRef<Operation *> ops) const {
+  OwningOpRef<ModuleOp> moduleOp = ModuleOp::create(loc);
+  auto moduleBuilder = OpBuilder::atBlockBegin(moduleOp->getBody());
+  auto executableOp = moduleBuilder.create<IREE::HAL::ExecutableOp>(
+      loc, kCachedExecutableName);
+  auto executableBuilder =
+      OpBuilder::atBlockTerminator(&executableOp.getBlock());
+  for (auto *op : ops) {
+    executableBuilder.clone(*op);
+  }
+
+  if (auto ec = llvm::sys::fs::create_directories(path)) {
+    mlir::emitWarning(loc) << "failed to create executable cache directory '"
+                           << path << "': " << ec.message();
+    return;
+  }
+  std::string entryPath = getEntryPath(key);
+  auto error = llvm::writeToOutput(entryPath, [&](llvm::raw_ostream &os) {
+    if (failed(writeBytecodeToFile(*moduleOp, os))) {
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     "failed to serialize bytecode");
+    }
+    return llvm::Error::success();
+  });
+  if (error) {
+    mlir::emitWarning(loc) << "failed to write executable cache entry '"
+                           << entryPath
+                           << "': " << llvm::toString(std::move(error));
+  }
+}
+
+// static
+IREE::HAL::ExecutableOp
+ExecutableCache::getCachedExecutable(ModuleOp moduleOp) {
+  for (auto executableOp : moduleOp.getOps<IREE::HAL::ExecutableOp>()) {
+    if (executableOp.getName() == kCachedExecutableName) {
+      return executableOp;
+    }
+  }
+  return {};
+}
+
+} // namespace mlir::iree_compiler::IREE::HAL
@@ -0,0 +1,59 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_HAL_UTILS_EXECUTABLECACHE_H_
+#define IREE_COMPILER_DIALECT_HAL_UTILS_EXECUTABLECACHE_H_
+
+#include <string>
+
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OwningOpRef.h"
+
+namespace mlir::iree_compiler::IREE::HAL {
+
+// A content-addressed on-disk cache of executable contents shared across
+// compiler invocations. Each entry holds ops produced from an executable (such
+// as translated variants or serialized binaries) stored as MLIR bytecode
+// nested within a `hal.executable` so that they verify when loaded.
+//
+// Keys cover the IR the entry was produced from (including locations and the
+// contents of any referenced resource blobs), the compiler version, and any
+// additional parts the caller provides for options that influence the result.
+// Global command line flags are not part of the key and changing flags that
+// alter code generation requires using a different cache path.
+//
+// Thread-safe: entries are written to a temporary file and renamed into place
+// so concurrent compiler invocations may share the same cache path.
+class ExecutableCache {
+public:
+  explicit ExecutableCache(StringRef path) : path(path) {}
+
+  // Returns the cache key for the contents of |op| combined with |keyParts|.
+  static std::string computeKey(Operation *op, ArrayRef<StringRef> keyParts);
+
+  // Loads the ops cached under |key| into a module holding a single
+  // `hal.executable` that can be retrieved with getCachedExecutable.
+  // Returns nullptr if no entry exists or it could not be read.
+  OwningOpRef<ModuleOp> load(MLIRContext *context, StringRef key) const;
+
+  // Stores clones of |ops| under |key|. Failures to write the entry are
+  // reported as warnings on |loc| as they only impact later compilations.
+  void store(Location loc, StringRef key, ArrayRef<Operation *> ops) const;
+
+  // Returns the `hal.executable` holding the cached ops in a |moduleOp|
+  // returned by load.
+  static IREE::HAL::ExecutableOp getCachedExecutable(ModuleOp moduleOp);
+
+private:
+  std::string getEntryPath(StringRef key) const;
+
+  std::string path;
+};
+
+} // namespace mlir::iree_compiler::IREE::HAL
+
+#endif // IREE_COMPILER_DIALECT_HAL_UTILS_EXECUTABLECACHE_H_
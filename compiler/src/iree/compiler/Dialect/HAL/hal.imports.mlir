@@ -35,6 +35,18 @@ vm.import private @allocator.allocate(
 ) -> !vm.ref<!hal.buffer>
 attributes {minimum_version = 1 : i32}
 
+// Allocates a buffer from the allocator attributed to the given allocation tag
+// in allocator statistics.
+vm.import private @allocator.allocate.tagged(
+  %allocator : !vm.ref<!hal.allocator>,
+  %queue_affinity : i64,
+  %memory_types : i32,
+  %buffer_usage : i32,
+  %allocation_tag : i32,
+  %allocation_size : i64
+) -> !vm.ref<!hal.buffer>
+attributes {minimum_version = 4 : i32}
+
 // Imports a host byte buffer into a device visible buffer.
 // If try!=0 then returns null if the given memory type cannot be mapped.
 // Host-local+constant requests will always succeed.
@@ -292,6 +304,15 @@ vm.import private @command_buffer.dispatch(
   %workgroup_z : i32
 )
 
+// Dispatches a sequence of execution requests in order. Equivalent to one
+// dispatch call per entry but with a single call into the runtime.
+vm.import private @command_buffer.dispatch.batch(
+  %command_buffer : !vm.ref<!hal.command_buffer>,
+  // <executable, entry_point, workgroup_x, workgroup_y, workgroup_z>
+  %dispatches : tuple<!vm.ref<!hal.executable>, i32, i32, i32, i32>...
+)
+attributes {minimum_version = 3 : i32}
+
 // Dispatches an execution request with the dispatch parameters loaded from the
 // given buffer.
 vm.import private @command_buffer.dispatch.indirect(
@@ -356,6 +377,21 @@ vm.import private @device.queue.alloca(
   %allocation_size : i64
 ) -> !vm.ref<!hal.buffer>
 
+// Returns a queue-ordered transient buffer attributed to the given allocation
+// tag in allocator statistics.
+vm.import private @device.queue.alloca.tagged(
+  %device : !vm.ref<!hal.device>,
+  %queue_affinity : i64,
+  %wait_fence : !vm.ref<!hal.fence>,
+  %signal_fence : !vm.ref<!hal.fence>,
+  %pool : i32,
+  %memory_types : i32,
+  %buffer_usage : i32,
+  %allocation_tag : i32,
+  %allocation_size : i64
+) -> !vm.ref<!hal.buffer>
+attributes {minimum_version = 4 : i32}
+
 // Deallocates a queue-ordered transient buffer.
 // The deallocation will not be made until the wait fence has been reached and
 // once the storage is available for reuse the signal fence will be signaled.
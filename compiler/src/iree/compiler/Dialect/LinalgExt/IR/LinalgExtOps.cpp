@@ -1268,7 +1268,15 @@ LogicalResult AttentionOp::verify() {
   int numInputs = getNumDpsInputs();
   int numOutputs = getNumDpsInits();
 
-  if (numInputs != 4) {
+  if (getIsCausal()) {
+    if (numInputs != 5) {
+      return op->emitOpError("expected 5 input operands for causal attention: "
+                             "Query, Key, Value, Scale and Offset");
+    }
+    if (!getCausalOffset()->getType().isIndex()) {
+      return op->emitOpError("expected causal offset to be of index type");
+    }
+  } else if (numInputs != 4) {
     return op->emitOpError(
         "expected 4 input operands: Query, Key, Value and Scale");
   }
@@ -1280,9 +1288,10 @@ LogicalResult AttentionOp::verify() {
 
   bool isTiled = numOutputs == 3;
 
-  if (!llvm::all_of(llvm::drop_end(getDpsInputs()), [](Value input) {
-        return isa<ShapedType>(input.getType());
-      })) {
+  if (!llvm::all_of(ValueRange{getQuery(), getKey(), getValue()},
+                    [](Value input) {
+                      return isa<ShapedType>(input.getType());
+                    })) {
     return op->emitOpError(
         "expected Query, Key, Value inputs to be of shaped type");
   }
@@ -1427,6 +1436,116 @@ SmallVector<AffineMap> AttentionOp::getIndexingMapsArray() {
   return results;
 }
 
+//===----------------------------------------------------------------------===//
+// PagedAttentionOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult PagedAttentionOp::verify() {
+  Operation *op = getOperation();
+
+  if (getNumDpsInputs() != 5) {
+    return op->emitOpError("expected 5 input operands: Query, KeyCache, "
+                           "ValueCache, BlockTable and Scale");
+  }
+  if (getNumDpsInits() != 1) {
+    return op->emitOpError("expected 1 output operand: Output");
+  }
+  if (!llvm::all_of(llvm::drop_end(getDpsInputs()), [](Value input) {
+        return isa<ShapedType>(input.getType());
+      })) {
+    return op->emitOpError("expected Query, KeyCache, ValueCache and "
+                           "BlockTable inputs to be of shaped type");
+  }
+
+  ShapedType queryType = getQueryType();
+  ShapedType keyCacheType = getKeyCacheType();
+  ShapedType valueCacheType = getValueCacheType();
+  ShapedType blockTableType = getBlockTableType();
+  ShapedType outputType = getOutputType();
+
+  auto checkRank = [&op](StringRef operandName, ShapedType type,
+                         int64_t rank) -> LogicalResult {
+    if (type.getRank() != rank) {
+      return op->emitError("Rank Mismatch for ")
+             << operandName << ". Expected: " << rank
+             << " Got: " << type.getRank();
+    }
+    return success();
+  };
+  if (failed(checkRank("Query", queryType, 3)) ||
+      failed(checkRank("KeyCache", keyCacheType, 3)) ||
+      failed(checkRank("ValueCache", valueCacheType, 3)) ||
+      failed(checkRank("BlockTable", blockTableType, 2)) ||
+      failed(checkRank("Output", outputType, 3))) {
+    return failure();
+  }
+
+  // Checks that dimensions that must match do so when both are static.
+  auto checkDim = [&op](StringRef lhsName, ShapedType lhsType, int64_t lhsDim,
+                        StringRef rhsName, ShapedType rhsType,
+                        int64_t rhsDim) -> LogicalResult {
+    int64_t lhsSize = lhsType.getDimSize(lhsDim);
+    int64_t rhsSize = rhsType.getDimSize(rhsDim);
+    if (!ShapedType::isDynamic(lhsSize) && !ShapedType::isDynamic(rhsSize) &&
+        lhsSize != rhsSize) {
+      return op->emitError("Shape Mismatch for ")
+             << rhsName << " dim " << rhsDim << ". Expected: " << lhsSize
+             << " (" << lhsName << " dim " << lhsDim << ") Got: " << rhsSize;
+    }
+    return success();
+  };
+  if (failed(checkDim("Query", queryType, 0, "BlockTable", blockTableType,
+                      0)) ||
+      failed(checkDim("Query", queryType, 0, "Output", outputType, 0)) ||
+      failed(checkDim("Query", queryType, 1, "Output", outputType, 1)) ||
+      failed(checkDim("Query", queryType, 2, "KeyCache", keyCacheType, 2)) ||
+      failed(checkDim("KeyCache", keyCacheType, 0, "ValueCache",
+                      valueCacheType, 0)) ||
+      failed(checkDim("KeyCache", keyCacheType, 1, "ValueCache",
+                      valueCacheType, 1)) ||
+      failed(checkDim("ValueCache", valueCacheType, 2, "Output", outputType,
+                      2))) {
+    return failure();
+  }
+
+  if (!blockTableType.getElementType().isIntOrIndex()) {
+    return op->emitOpError("expected BlockTable to have integer or index "
+                           "element type but got ")
+           << blockTableType.getElementType();
+  }
+
+  FloatType scaleElementType = dyn_cast<FloatType>(getScale().getType());
+  if (!scaleElementType) {
+    return op->emitOpError("expected scale to be of floating point type");
+  }
+  Type queryElementType = queryType.getElementType();
+  if (queryElementType != keyCacheType.getElementType() ||
+      queryElementType != valueCacheType.getElementType() ||
+      queryElementType != scaleElementType) {
+    return op->emitOpError(
+        "element types of (Q)uery, (K)ey and (V)alue caches and scale should "
+        "be same");
+  }
+  if (queryElementType != outputType.getElementType()) {
+    return op->emitOpError("expected element type for Output ")
+           << queryElementType << " but found " << outputType.getElementType()
+           << " instead";
+  }
+
+  return success();
+}
+
+LogicalResult PagedAttentionOp::fold(FoldAdaptor,
+                                     SmallVectorImpl<OpFoldResult> &) {
+  return memref::foldMemRefCast(*this);
+}
+
+LogicalResult PagedAttentionOp::reifyResultShapes(
+    OpBuilder &b, ReifiedRankedShapedTypeDims &reifiedReturnShapes) {
+  return cast<LinalgExtOp>(getOperation())
+      .reifyResultShapes(b, reifiedReturnShapes);
+}
+
 #define DEFINE_OP_GET_EFFECTS(OP_NAME)                                         \
   void OP_NAME::getEffects(                                                    \
       SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>      \
@@ -1446,6 +1565,7 @@ DEFINE_OP_GET_EFFECTS(WinogradInputTransformOp)
 DEFINE_OP_GET_EFFECTS(WinogradFilterTransformOp)
 DEFINE_OP_GET_EFFECTS(WinogradOutputTransformOp)
 DEFINE_OP_GET_EFFECTS(AttentionOp)
+DEFINE_OP_GET_EFFECTS(PagedAttentionOp)
 
 } // namespace mlir::iree_compiler::IREE::LinalgExt
 
@@ -722,3 +722,33 @@ func.func @illegal_attention_inputs(%query: tensor<192x1024x64xf32>, %key: tenso
   %1 = iree_linalg_ext.attention ins(%query, %key, %value, %scale : tensor<192x1024x64xf32>, tensor<192x1024x64xf32>, f32, f32) outs(%0 : tensor<192x1024x64xf32>) -> tensor<192x1024x64xf32>
   return %1 : tensor<192x1024x64xf32>
 }
+
+// -----
+
+func.func @illegal_causal_attention_offset(%query: tensor<192x1024x64xf32>, %key: tensor<192x1024x64xf32>, %value: tensor<192x1024x64xf32>) -> tensor<192x1024x64xf32> {
+  %0 = tensor.empty() : tensor<192x1024x64xf32>
+  %scale = arith.constant 1.0 : f32
+  // expected-error @+1 {{expected 5 input operands for causal attention: Query, Key, Value, Scale and Offset}}
+  %1 = iree_linalg_ext.attention {is_causal = true} ins(%query, %key, %value, %scale : tensor<192x1024x64xf32>, tensor<192x1024x64xf32>, tensor<192x1024x64xf32>, f32) outs(%0 : tensor<192x1024x64xf32>) -> tensor<192x1024x64xf32>
+  return %1 : tensor<192x1024x64xf32>
+}
+
+// -----
+
+func.func @illegal_paged_attention_block_table(%query: tensor<4x16x64xf32>, %key_cache: tensor<128x32x64xf32>, %value_cache: tensor<128x32x64xf32>, %block_table: tensor<4x8xf32>) -> tensor<4x16x64xf32> {
+  %0 = tensor.empty() : tensor<4x16x64xf32>
+  %scale = arith.constant 1.0 : f32
+  // expected-error @+1 {{expected BlockTable to have integer or index element type but got 'f32'}}
+  %1 = iree_linalg_ext.paged_attention ins(%query, %key_cache, %value_cache, %block_table, %scale : tensor<4x16x64xf32>, tensor<128x32x64xf32>, tensor<128x32x64xf32>, tensor<4x8xf32>, f32) outs(%0 : tensor<4x16x64xf32>) -> tensor<4x16x64xf32>
+  return %1 : tensor<4x16x64xf32>
+}
+
+// -----
+
+func.func @illegal_paged_attention_page_size(%query: tensor<4x16x64xf32>, %key_cache: tensor<128x32x64xf32>, %value_cache: tensor<128x16x64xf32>, %block_table: tensor<4x8xi32>) -> tensor<4x16x64xf32> {
+  %0 = tensor.empty() : tensor<4x16x64xf32>
+  %scale = arith.constant 1.0 : f32
+  // expected-error @+1 {{Shape Mismatch for ValueCache dim 1. Expected: 32 (KeyCache dim 1) Got: 16}}
+  %1 = iree_linalg_ext.paged_attention ins(%query, %key_cache, %value_cache, %block_table, %scale : tensor<4x16x64xf32>, tensor<128x32x64xf32>, tensor<128x16x64xf32>, tensor<4x8xi32>, f32) outs(%0 : tensor<4x16x64xf32>) -> tensor<4x16x64xf32>
+  return %1 : tensor<4x16x64xf32>
+}
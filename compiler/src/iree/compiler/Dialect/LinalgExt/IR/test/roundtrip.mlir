@@ -1106,6 +1106,27 @@ func.func @cross_attention_transposev(%query: tensor<192x1024x64xf32>, %key: ten
 
 // -----
 
+func.func @causal_attention(%query: tensor<192x1024x64xf32>, %key: tensor<192x1024x64xf32>, %value: tensor<192x1024x64xf32>) -> tensor<192x1024x64xf32> {
+  %0 = tensor.empty() : tensor<192x1024x64xf32>
+  %scale = arith.constant 1.0 : f32
+  %offset = arith.constant 0 : index
+  %1 = iree_linalg_ext.attention {is_causal = true} ins(%query, %key, %value, %scale, %offset : tensor<192x1024x64xf32>, tensor<192x1024x64xf32>, tensor<192x1024x64xf32>, f32, index) outs(%0 : tensor<192x1024x64xf32>) -> tensor<192x1024x64xf32>
+  return %1 : tensor<192x1024x64xf32>
+}
+// CHECK:      func.func @causal_attention(%[[ARG0:[a-zA-Z0-9_]+]]: tensor<192x1024x64xf32>, %[[ARG1:[a-zA-Z0-9_]+]]:
+// CHECK-SAME:   tensor<192x1024x64xf32>, %[[ARG2:[a-zA-Z0-9_]+]]: tensor<192x1024x64xf32>) -> tensor<192x1024x64xf32>
+// CHECK-SAME:   {
+// CHECK:        %[[D0:.+]] = tensor.empty() : tensor<192x1024x64xf32>
+// CHECK:        %[[SCALE:.+]] = arith.constant 1.000000e+00 : f32
+// CHECK:        %[[OFFSET:.+]] = arith.constant 0 : index
+// CHECK:        %[[D1:.+]] = iree_linalg_ext.attention {is_causal = true} ins(%[[ARG0]], %[[ARG1]], %[[ARG2]], %[[SCALE]], %[[OFFSET]] :
+// CHECK-SAME:     tensor<192x1024x64xf32>, tensor<192x1024x64xf32>, tensor<192x1024x64xf32>, f32, index) outs(%[[D0]] :
+// CHECK-SAME:     tensor<192x1024x64xf32>) -> tensor<192x1024x64xf32>
+// CHECK:        return %[[D1]] : tensor<192x1024x64xf32>
+// CHECK:      }
+
+// -----
+
 func.func @cross_attention_transposev_dyn(%query: tensor<?x?x?xf32>, %key: tensor<?x?x?xf32>, %value: tensor<?x?x?xf32>, %init: tensor<?x?x?xf32>) -> tensor<?x?x?xf32> {
   %scale = arith.constant 1.0 : f32
   %1 = iree_linalg_ext.attention {transpose_v = true} ins(%query, %key, %value, %scale : tensor<?x?x?xf32>, tensor<?x?x?xf32>, tensor<?x?x?xf32>, f32) outs(%init : tensor<?x?x?xf32>) -> tensor<?x?x?xf32>
@@ -1120,3 +1141,22 @@ func.func @cross_attention_transposev_dyn(%query: tensor<?x?x?xf32>, %key: tenso
 // CHECK-SAME:     tensor<?x?x?xf32>) -> tensor<?x?x?xf32>
 // CHECK:        return %[[D1]] : tensor<?x?x?xf32>
 // CHECK:      }
+
+// -----
+
+func.func @paged_attention(%query: tensor<4x16x64xf16>, %key_cache: tensor<128x32x64xf16>, %value_cache: tensor<128x32x64xf16>, %block_table: tensor<4x8xi32>) -> tensor<4x16x64xf16> {
+  %0 = tensor.empty() : tensor<4x16x64xf16>
+  %scale = arith.constant 1.0 : f16
+  %1 = iree_linalg_ext.paged_attention ins(%query, %key_cache, %value_cache, %block_table, %scale : tensor<4x16x64xf16>, tensor<128x32x64xf16>, tensor<128x32x64xf16>, tensor<4x8xi32>, f16) outs(%0 : tensor<4x16x64xf16>) -> tensor<4x16x64xf16>
+  return %1 : tensor<4x16x64xf16>
+}
+// CHECK:      func.func @paged_attention(%[[ARG0:[a-zA-Z0-9_]+]]: tensor<4x16x64xf16>, %[[ARG1:[a-zA-Z0-9_]+]]:
+// CHECK-SAME:   tensor<128x32x64xf16>, %[[ARG2:[a-zA-Z0-9_]+]]: tensor<128x32x64xf16>, %[[ARG3:[a-zA-Z0-9_]+]]: tensor<4x8xi32>) -> tensor<4x16x64xf16>
+// CHECK-SAME:   {
+// CHECK:        %[[D0:.+]] = tensor.empty() : tensor<4x16x64xf16>
+// CHECK:        %[[SCALE:.+]] = arith.constant 1.000000e+00 : f16
+// CHECK:        %[[D1:.+]] = iree_linalg_ext.paged_attention ins(%[[ARG0]], %[[ARG1]], %[[ARG2]], %[[ARG3]], %[[SCALE]] :
+// CHECK-SAME:     tensor<4x16x64xf16>, tensor<128x32x64xf16>, tensor<128x32x64xf16>, tensor<4x8xi32>, f16) outs(%[[D0]] :
+// CHECK-SAME:     tensor<4x16x64xf16>) -> tensor<4x16x64xf16>
+// CHECK:        return %[[D1]] : tensor<4x16x64xf16>
+// CHECK:      }
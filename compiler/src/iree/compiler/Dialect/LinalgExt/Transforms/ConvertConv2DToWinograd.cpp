@@ -33,10 +33,6 @@ static bool hasAllOneValues(DenseIntElementsAttr attr) {
   return llvm::all_of(attr, [](APInt element) { return element.isOne(); });
 }
 
-// TODO: Make this a user-settable parameter once we have support
-// for more tile sizes
-static constexpr int64_t outputTileSize = 6;
-
 template <typename T>
 static bool hasValidStridesAndDilations(Operation *op) {
   auto convOp = dyn_cast<T>(op);
@@ -154,16 +150,22 @@ template <typename ConvOp>
 class ConvertConvToWinograd final : public OpRewritePattern<ConvOp> {
 public:
   using OpRewritePattern<ConvOp>::OpRewritePattern;
-  ConvertConvToWinograd<ConvOp>(MLIRContext *context, bool replaceAllConvs,
+  ConvertConvToWinograd<ConvOp>(MLIRContext *context,
+                                const WinogradControlFn &controlFn,
                                 PatternBenefit benefit = 1)
-      : OpRewritePattern<ConvOp>(context, benefit),
-        replaceAllConvs(replaceAllConvs) {}
+      : OpRewritePattern<ConvOp>(context, benefit), controlFn(controlFn) {}
 
   LogicalResult matchAndRewrite(ConvOp convOp,
                                 PatternRewriter &rewriter) const override {
-    if (!replaceAllConvs && !convOp->hasAttr(kWinogradAttr)) {
+    std::optional<int64_t> maybeOutputTileSize = controlFn(convOp);
+    if (!maybeOutputTileSize) {
       return failure();
     }
+    const int64_t outputTileSize = *maybeOutputTileSize;
+    if (outputTileSize != 4 && outputTileSize != 6) {
+      return rewriter.notifyMatchFailure(
+          convOp, "Winograd only supports output tile sizes of 4 and 6");
+    }
 
     bool isNchwFchw;
     if (!isValidConv2d(convOp, isNchwFchw)) {
@@ -336,7 +338,7 @@ public:
   }
 
 private:
-  bool replaceAllConvs;
+  WinogradControlFn controlFn;
 };
 
 /// The ConvertConv2DToWinograd pass will only transform convs that have been
@@ -410,11 +412,13 @@ struct ConvertConv2DToWinogradPass
         .insert<linalg::LinalgDialect, IREE::LinalgExt::IREELinalgExtDialect>();
   }
   void runOnOperation() override {
-    MLIRContext *context = &getContext();
     RewritePatternSet patterns(&getContext());
-    patterns.insert<ConvertConvToWinograd<linalg::Conv2DNhwcHwcfOp>,
-                    ConvertConvToWinograd<linalg::Conv2DNchwFchwOp>>(
-        context, /*replaceAllConvs=*/replaceAllConvs);
+    populateConvertConv2DToWinogradPatterns(
+        patterns, [&](linalg::LinalgOp convOp) -> std::optional<int64_t> {
+          if (!replaceAllConvs && !convOp->hasAttr(kWinogradAttr))
+            return std::nullopt;
+          return static_cast<int64_t>(outputTileSize);
+        });
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
@@ -424,6 +428,13 @@ struct ConvertConv2DToWinogradPass
 
 } // namespace
 
+void populateConvertConv2DToWinogradPatterns(
+    RewritePatternSet &patterns, const WinogradControlFn &controlFn) {
+  patterns.insert<ConvertConvToWinograd<linalg::Conv2DNhwcHwcfOp>,
+                  ConvertConvToWinograd<linalg::Conv2DNchwFchwOp>>(
+      patterns.getContext(), controlFn);
+}
+
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createConvertConv2DToWinogradPass() {
   return std::make_unique<ConvertConv2DToWinogradPass>();
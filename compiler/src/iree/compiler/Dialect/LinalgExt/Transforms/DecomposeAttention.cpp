@@ -159,6 +159,37 @@ static Value computeQKTranspose(Value query, Value key, Value output,
   return matmulOp.getResult(0);
 }
 
+/// Masks out the scores of the keys after their query for causal attention,
+/// where the first query of the tile is at |offset| relative to the first key.
+static Value applyCausalMask(Value qkTranspose, Value offset, Location loc,
+                             OpBuilder &builder,
+                             SmallVectorImpl<Operation *> &ops) {
+  AffineMap identityMap =
+      AffineMap::getMultiDimIdentityMap(2, builder.getContext());
+  SmallVector<AffineMap> indexingMaps{identityMap};
+  SmallVector<utils::IteratorType> iteratorTypes(2,
+                                                 utils::IteratorType::parallel);
+  auto genericOp = builder.create<linalg::GenericOp>(
+      loc, qkTranspose.getType(), ValueRange{}, qkTranspose, indexingMaps,
+      iteratorTypes, [&](OpBuilder &b, Location loc, ValueRange args) {
+        Value query = b.create<linalg::IndexOp>(loc, 0);
+        Value key = b.create<linalg::IndexOp>(loc, 1);
+        Value lastKey = b.create<arith::AddIOp>(loc, query, offset);
+        Value isMasked = b.create<arith::CmpIOp>(
+            loc, arith::CmpIPredicate::sgt, key, lastKey);
+        auto floatType = cast<FloatType>(args[0].getType());
+        Value negativeInf = b.create<arith::ConstantOp>(
+            loc, b.getFloatAttr(floatType,
+                                APFloat::getInf(floatType.getFloatSemantics(),
+                                                /*Negative=*/true)));
+        Value result =
+            b.create<arith::SelectOp>(loc, isMasked, negativeInf, args[0]);
+        b.create<linalg::YieldOp>(loc, result);
+      });
+  ops.push_back(genericOp);
+  return genericOp.getResult(0);
+}
+
 static Value truncateToF16(Value input, Value output,
                            SmallVectorImpl<Operation *> &ops,
                            OpBuilder &builder, Location loc) {
@@ -183,7 +214,8 @@ createAttentionBody(Value keySlice, Value valueSlice, Value querySlice,
                     OpFoldResult sequenceTileLength,
                     OpFoldResult keyValueTileLength, OpFoldResult headDimension,
                     Type elementType, SmallVectorImpl<Operation *> &ops,
-                    bool transposeV, Location loc, OpBuilder &builder) {
+                    bool transposeV, std::optional<Value> causalOffset,
+                    Location loc, OpBuilder &builder) {
 
   Type f32Type = builder.getF32Type();
   // Compute matmul(q, transpose(k))
@@ -194,6 +226,10 @@ createAttentionBody(Value keySlice, Value valueSlice, Value querySlice,
       builder.create<tensor::EmptyOp>(loc, resultShape, f32Type);
   Value qkTranspose = computeQKTranspose(querySlice, keySlice, emptySquare,
                                          zero, loc, builder, ops);
+  if (causalOffset) {
+    qkTranspose = applyCausalMask(qkTranspose, causalOffset.value(), loc,
+                                  builder, ops);
+  }
 
   // Compute current statistics
   Value newMax = computeRowwiseReduction<arith::MaximumFOp>(
@@ -275,7 +311,8 @@ static Value scaleQuery(Value querySlice, Value scale, RewriterBase &rewriter) {
 /// 3. for i = 0 to S with step T
 ///    a. Load a tile from the K matrix of size T x d -> k
 ///    b. Load a tile from the V matrix of size T x d -> v
-///    c. Compute matmul_transpose_b(q, k) -> qkT
+///    c. Compute matmul_transpose_b(q, k) -> qkT, and for causal attention
+///       replace the scores of keys after their query with -inf
 ///    d. Compute max(max(qkT) along rows, old_max) -> new_max
 ///    e. Compute curent estimate of softmax: exp(qKT - current_max) -> s
 ///    f. Compute product of fixup and old_sum -> fsum
@@ -331,7 +368,8 @@ void decomposeTiledAttention(IREE::LinalgExt::AttentionOp tiledAttnOp,
   auto [result, newMax, newSum] = createAttentionBody(
       keySlice, valueSlice, querySlice, tiledResult, max, sum,
       sequenceTileLength, keyValueTileLength, headDimension, elementType, ops,
-      tiledAttnOp.getTransposeV(), loc, rewriter);
+      tiledAttnOp.getTransposeV(), tiledAttnOp.getCausalOffset(), loc,
+      rewriter);
 
   rewriter.replaceOp(tiledAttnOp, ValueRange{result, newMax, newSum});
 }
@@ -372,4 +410,9 @@ std::unique_ptr<Pass> createDecomposeAttentionPass() {
   return std::make_unique<DecomposeAttentionPass>();
 }
 
+std::unique_ptr<Pass> createDecomposeAttentionPass(uint64_t tileSize) {
+  return std::make_unique<DecomposeAttentionPass>(/*onlyTile=*/false,
+                                                  tileSize);
+}
+
 } // namespace mlir::iree_compiler::IREE::LinalgExt
@@ -26,6 +26,36 @@
 namespace mlir::iree_compiler::IREE::LinalgExt {
 namespace {
 
+/// Winograd constant matrices for a given output tile and kernel size.
+struct WinogradMatrices {
+  const float *BT;
+  const float *B;
+  const float *GT;
+  const float *G;
+  const float *AT;
+  const float *A;
+};
+
+/// Returns the Winograd constant matrices of the winograd op |transformOp|,
+/// or std::nullopt if there are no constants for its tile and kernel sizes.
+template <typename TransformOp>
+static std::optional<WinogradMatrices>
+getWinogradMatrices(TransformOp transformOp) {
+  using namespace IREE::LinalgExt::Winograd;
+  if (transformOp.getKernelSize() != 3)
+    return std::nullopt;
+  switch (transformOp.getOutputTileSize()) {
+  case 4:
+    return WinogradMatrices{BT_4x4_3x3, B_4x4_3x3, GT_4x4_3x3,
+                            G_4x4_3x3, AT_4x4_3x3, A_4x4_3x3};
+  case 6:
+    return WinogradMatrices{BT_6x6_3x3, B_6x6_3x3, GT_6x6_3x3,
+                            G_6x6_3x3, AT_6x6_3x3, A_6x6_3x3};
+  default:
+    return std::nullopt;
+  }
+}
+
 /// Pattern to remove unit dims from winograd ops after tililng. Tiling is
 /// expected to tile most dimensions to 1, so the winograd op is only a small
 /// tile of rank 2 for decomposition.
@@ -121,6 +151,11 @@ struct DecomposeWinogradFilterTransform
     if (transformOp.getInputRank() != 2 || transformOp.getOutputRank() != 2) {
       return rewriter.notifyMatchFailure(transformOp, "Winograd op not tiled");
     }
+    std::optional<WinogradMatrices> matrices = getWinogradMatrices(transformOp);
+    if (!matrices) {
+      return rewriter.notifyMatchFailure(transformOp,
+                                         "unsupported tile or kernel size");
+    }
     const int64_t inputTileSize = transformOp.getInputTileSize();
     const int64_t kernelSize = transformOp.getKernelSize();
     ArrayRef<int64_t> kernelDims = transformOp.getKernelDimensions();
@@ -133,11 +168,9 @@ struct DecomposeWinogradFilterTransform
     /// and G [G] constant matrices that convert the filter
     /// tile from the original domain to the Winograd domain.
     Value GT = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::GT_6x6_3x3, kernelSize, inputTileSize, loc,
-        rewriter);
+        matrices->GT, kernelSize, inputTileSize, loc, rewriter);
     Value G = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::G_6x6_3x3, inputTileSize, kernelSize, loc,
-        rewriter);
+        matrices->G, inputTileSize, kernelSize, loc, rewriter);
 
     // Create matmul(input, GT)
     SmallVector<int64_t> initShape(kernelDims.size(), inputTileSize);
@@ -205,14 +238,17 @@ struct DecomposeWinogradInputTransform
     /// The two values below are the transpose(B) [BT]
     /// and B [B] constant matrices that convert the input
     /// tile from the original domain to the Winograd domain.
+    std::optional<WinogradMatrices> matrices = getWinogradMatrices(transformOp);
+    if (!matrices) {
+      return rewriter.notifyMatchFailure(transformOp,
+                                         "unsupported tile or kernel size");
+    }
     Location loc = transformOp.getLoc();
     const int64_t inputTileSize = transformOp.getInputTileSize();
     Value BT = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::BT_6x6_3x3, inputTileSize, inputTileSize,
-        loc, rewriter);
+        matrices->BT, inputTileSize, inputTileSize, loc, rewriter);
     Value B = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::B_6x6_3x3, inputTileSize, inputTileSize, loc,
-        rewriter);
+        matrices->B, inputTileSize, inputTileSize, loc, rewriter);
 
     // Pad the input slice.
     Value dynamicSlice = transformOp.getInput();
@@ -287,6 +323,11 @@ struct DecomposeWinogradOutputTransform
     if (transformOp.getInputRank() != 2 || transformOp.getOutputRank() != 2) {
       return rewriter.notifyMatchFailure(transformOp, "Winograd op not tiled");
     }
+    std::optional<WinogradMatrices> matrices = getWinogradMatrices(transformOp);
+    if (!matrices) {
+      return rewriter.notifyMatchFailure(transformOp,
+                                         "unsupported tile or kernel size");
+    }
     ShapedType outputType = transformOp.getOutputType();
     Type elementType = outputType.getElementType();
     const int64_t inputTileSize = transformOp.getInputTileSize();
@@ -295,11 +336,9 @@ struct DecomposeWinogradOutputTransform
     /// and A [A] constant matrices that convert the output
     /// tile from the Winograd domain to the original domain.
     Value AT = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::AT_6x6_3x3, outputTileSize, inputTileSize,
-        loc, rewriter);
+        matrices->AT, outputTileSize, inputTileSize, loc, rewriter);
     Value A = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::A_6x6_3x3, inputTileSize, outputTileSize,
-        loc, rewriter);
+        matrices->A, inputTileSize, outputTileSize, loc, rewriter);
     Value zeroF32 = rewriter.create<arith::ConstantOp>(
         loc, rewriter.getZeroAttr(elementType));
     SmallVector<int64_t> scratchShape = {inputTileSize, outputTileSize};
@@ -46,6 +46,18 @@ createDecomposeWinogradTransformPass();
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createConvertConv2DToWinogradPass();
 
+/// Function signature to control the winograd transformation. This returns the
+/// output tile size to use for the convolution, or std::nullopt if the
+/// convolution should not be transformed.
+using WinogradControlFn =
+    std::function<std::optional<int64_t>(linalg::LinalgOp convOp)>;
+
+/// Populates patterns converting the 2-D convolutions accepted by |controlFn|
+/// into winograd transform ops and a linalg.batch_matmul op. Only unit stride
+/// and dilation convolutions with static 3x3 filters are converted.
+void populateConvertConv2DToWinogradPatterns(
+    RewritePatternSet &patterns, const WinogradControlFn &controlFn);
+
 IREE::LinalgExt::AttentionOp
 tileAttention(IREE::LinalgExt::AttentionOp attnOp,
               SmallVectorImpl<Operation *> &ops, RewriterBase &rewriter,
@@ -59,9 +71,17 @@ void decomposeTiledAttention(IREE::LinalgExt::AttentionOp tiledAttnOp,
 // Creates a pass to tile the attention op along the reduction dim.
 std::unique_ptr<Pass> createTileAttentionPass();
 
+// Creates a pass to tile the attention op along the reduction dim in blocks of
+// |tileSize| keys. The reduction dim must be a multiple of |tileSize|.
+std::unique_ptr<Pass> createTileAttentionPass(uint64_t tileSize);
+
 // Creates a pass to convert the attention op into a sequence of linalg ops.
 std::unique_ptr<Pass> createDecomposeAttentionPass();
 
+// Creates a pass to convert the attention op tiled with |tileSize| keys into a
+// sequence of linalg ops.
+std::unique_ptr<Pass> createDecomposeAttentionPass(uint64_t tileSize);
+
 //===---------------------------------------------------------------------===//
 // Codegen Strategy passes that are moved into IREE.
 //===---------------------------------------------------------------------===//
@@ -226,11 +226,23 @@ IREE::LinalgExt::AttentionOp tileAttention(IREE::LinalgExt::AttentionOp attnOp,
   // Construct sequential loop
   SmallVector<Value> ivs;
   Value zeroValue = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+  Value upperBound =
+      getValueOrCreateConstantIndexOp(rewriter, loc, sequenceLength);
+  std::optional<Value> causalOffset = attnOp.getCausalOffset();
+  if (causalOffset) {
+    // With causal masking the keys from `offset + sequenceTileLength` on are
+    // masked out for every query of the tile, so their blocks are skipped.
+    Value queryEnd = rewriter.create<arith::AddIOp>(
+        loc, causalOffset.value(),
+        getValueOrCreateConstantIndexOp(rewriter, loc, sequenceTileLength));
+    queryEnd = rewriter.create<arith::MaxSIOp>(loc, queryEnd, zeroValue);
+    upperBound = rewriter.create<arith::MinSIOp>(loc, upperBound, queryEnd);
+  }
   scf::LoopNest loopNest = createLoopNest(
       ivs, zeroValue,
       getValueOrCreateConstantIndexOp(rewriter, loc, keyValueTileLength),
-      getValueOrCreateConstantIndexOp(rewriter, loc, sequenceLength),
-      ValueRange({accumulatorF32, negativeMax, zeroSum}), loc, rewriter);
+      upperBound, ValueRange({accumulatorF32, negativeMax, zeroSum}), loc,
+      rewriter);
   ops.push_back(loopNest.loops.back());
 
   Value iterArgResult = loopNest.loops.back().getRegionIterArg(0);
@@ -251,14 +263,22 @@ IREE::LinalgExt::AttentionOp tileAttention(IREE::LinalgExt::AttentionOp attnOp,
 
   Value scale = attnOp.getScale();
 
+  SmallVector<Value> tiledInputs = {querySlice, keySlice, valueSlice, scale};
+  if (causalOffset) {
+    // The key block starts at the induction variable.
+    tiledInputs.push_back(
+        rewriter.create<arith::SubIOp>(loc, causalOffset.value(), ivs[0]));
+  }
+
   auto tiledAttentionOp = rewriter.create<IREE::LinalgExt::AttentionOp>(
       attnOp.getLoc(),
       SmallVector<Type>{accumulatorF32.getType(), sum.getType(), max.getType()},
-      SmallVector<Value>{querySlice, keySlice, valueSlice, scale},
-      SmallVector<Value>{iterArgResult, iterArgMax, iterArgSum});
+      tiledInputs, SmallVector<Value>{iterArgResult, iterArgMax, iterArgSum});
 
   if (attnOp.getTransposeV())
     tiledAttentionOp.setTransposeVAttr(attnOp.getTransposeVAttr());
+  if (attnOp.getIsCausal())
+    tiledAttentionOp.setIsCausalAttr(attnOp.getIsCausalAttr());
 
   Value tiledResult = tiledAttentionOp.getResult(0);
   Value newMax = tiledAttentionOp.getResult(1);
@@ -309,4 +329,8 @@ std::unique_ptr<Pass> createTileAttentionPass() {
   return std::make_unique<TileAttentionPass>();
 }
 
+std::unique_ptr<Pass> createTileAttentionPass(uint64_t tileSize) {
+  return std::make_unique<TileAttentionPass>(/*onlyTile=*/false, tileSize);
+}
+
 } // namespace mlir::iree_compiler::IREE::LinalgExt
@@ -1705,6 +1705,23 @@ AttentionOp::getTiledImplementation(OpBuilder &builder,
   tiledOperands.emplace_back(getSlice(builder, loc, getValue(), valueOffsets,
                                       valueSizes, valueStrides));
   tiledOperands.emplace_back(scale);
+  if (std::optional<Value> causalOffset = getCausalOffset()) {
+    // The tile starts at query offsets[m] and key offsets[k2], which moves the
+    // first query relative to the first key by their difference.
+    FailureOr<AttentionOpDetail> maybeOpInfo =
+        AttentionOpDetail::get(getIndexingMapsArray());
+    assert(succeeded(maybeOpInfo) && "Failed to infer attention op details");
+    int64_t mDim = maybeOpInfo->getMDims().front();
+    int64_t k2Dim = maybeOpInfo->getK2Dims().front();
+    AffineExpr d0, d1, d2;
+    bindDims(builder.getContext(), d0, d1, d2);
+    OpFoldResult tiledOffset = affine::makeComposedFoldedAffineApply(
+        builder, loc, d0 + d1 - d2,
+        {causalOffset.value(), offsets[mDim], offsets[k2Dim]});
+    tiledOperands.emplace_back(
+        getValueOrCreateConstantIndexOp(builder, loc, tiledOffset));
+  }
+  int64_t outputIndex = tiledOperands.size();
   tiledOperands.emplace_back(getSlice(builder, loc, getOutput(), outputOffsets,
                                       outputSizes, outputStrides));
 
@@ -1726,12 +1743,12 @@ AttentionOp::getTiledImplementation(OpBuilder &builder,
 
   SmallVector<Type> resultTypes;
   if (hasPureTensorSemantics()) {
-    resultTypes.push_back(tiledOperands[4].getType());
+    resultTypes.push_back(tiledOperands[outputIndex].getType());
     if (max) {
-      resultTypes.push_back(tiledOperands[5].getType());
+      resultTypes.push_back(tiledOperands[outputIndex + 1].getType());
     }
     if (sum) {
-      resultTypes.push_back(tiledOperands[6].getType());
+      resultTypes.push_back(tiledOperands[outputIndex + 2].getType());
     }
   }
 
@@ -326,3 +326,26 @@ func.func @attention_transpose_v(%query: tensor<1x1024x64xf16>, %key: tensor<1x1
 // CHECK: linalg.matmul_transpose_b
 // CHECK-NOT: linalg.matmul
 // CHECK: linalg.matmul_transpose_b
+
+// -----
+
+func.func @causal_attention(%query: tensor<1x1024x64xf16>, %key: tensor<1x1024x64xf16>, %value: tensor<1x1024x64xf16>, %offset: index) -> tensor<1x1024x64xf16> {
+  %0 = tensor.empty() : tensor<1x1024x64xf16>
+  %scale = arith.constant 0.05 : f16
+  %1 = iree_linalg_ext.attention {is_causal = true} ins(%query, %key, %value, %scale, %offset : tensor<1x1024x64xf16>, tensor<1x1024x64xf16>, tensor<1x1024x64xf16>, f16, index) outs(%0 : tensor<1x1024x64xf16>) -> tensor<1x1024x64xf16>
+  return %1 : tensor<1x1024x64xf16>
+}
+
+// CHECK-LABEL:  func.func @causal_attention
+// CHECK-SAME:     %[[OFFSET:[a-zA-Z0-9_]+]]: index
+// CHECK:          scf.for %[[IV:.+]] = %{{.+}} to %{{.+}} step %{{.+}}
+// CHECK:            %[[TILE_OFFSET:.+]] = arith.subi %[[OFFSET]], %[[IV]]
+// CHECK:            %[[QKT:.+]] = linalg.matmul_transpose_b
+// CHECK:            linalg.generic
+// CHECK-SAME:         outs(%[[QKT]] : tensor<1024x32xf32>)
+// CHECK:              %[[QUERY:.+]] = linalg.index 0 : index
+// CHECK:              %[[KEY:.+]] = linalg.index 1 : index
+// CHECK:              %[[LAST_KEY:.+]] = arith.addi %[[QUERY]], %[[TILE_OFFSET]]
+// CHECK:              %[[MASKED:.+]] = arith.cmpi sgt, %[[KEY]], %[[LAST_KEY]]
+// CHECK:              %[[NEG_INF:.+]] = arith.constant 0xFF800000 : f32
+// CHECK:              arith.select %[[MASKED]], %[[NEG_INF]], %{{.+}} : f32
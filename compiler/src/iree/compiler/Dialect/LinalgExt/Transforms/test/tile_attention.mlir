@@ -139,3 +139,22 @@ func.func @attention_transpose_v(%query: tensor<1x1024x64xf16>, %key: tensor<1x1
 // CHECK:          scf.for
 // CHECK:            iree_linalg_ext.attention {transpose_v = true}
 // CHECK:          scf.yield
+
+// -----
+
+func.func @causal_attention(%query: tensor<1x1024x64xf16>, %key: tensor<1x1024x64xf16>, %value: tensor<1x1024x64xf16>, %offset: index) -> tensor<1x1024x64xf16> {
+  %0 = tensor.empty() : tensor<1x1024x64xf16>
+  %scale = arith.constant 0.05 : f16
+  %1 = iree_linalg_ext.attention {is_causal = true} ins(%query, %key, %value, %scale, %offset : tensor<1x1024x64xf16>, tensor<1x1024x64xf16>, tensor<1x1024x64xf16>, f16, index) outs(%0 : tensor<1x1024x64xf16>) -> tensor<1x1024x64xf16>
+  return %1 : tensor<1x1024x64xf16>
+}
+// CHECK-LABEL:  func.func @causal_attention
+// CHECK-SAME:     %[[OFFSET:[a-zA-Z0-9_]+]]: index
+// CHECK:          %[[QUERY_END:.+]] = arith.addi %[[OFFSET]]
+// CHECK:          %[[CLAMPED:.+]] = arith.maxsi %[[QUERY_END]]
+// CHECK:          %[[UB:.+]] = arith.minsi %{{.+}}, %[[CLAMPED]]
+// CHECK:          scf.for %[[IV:.+]] = %{{.+}} to %[[UB]]
+// CHECK:            %[[TILE_OFFSET:.+]] = arith.subi %[[OFFSET]], %[[IV]]
+// CHECK:            iree_linalg_ext.attention {is_causal = true}
+// CHECK-SAME:         %[[TILE_OFFSET]] :
+// CHECK:          scf.yield
@@ -82,6 +82,67 @@ const float A_6x6_3x3[] = {
   0.0f,       0.0f,      0.0f,       0.0f,       0.0f,        1.0f
 };
 
+//===----------------------------------------------------------------------===//
+// Output tile size = 4, Kernel size = 3
+//===----------------------------------------------------------------------===//
+// These constants use the interpolation points 0, 1, -1, 2, -2 and infinity
+// from this paper:
+//
+// Lavin, A. and Gray, S. (2016) Fast Algorithms for Convolutional Neural
+// Networks. https://arxiv.org/abs/1509.09308
+//
+// The smaller tile trades some of the arithmetic savings for much smaller
+// constants, which keeps the transforms accurate for reduced precision types.
+
+const float BT_4x4_3x3[] = {
+  4.0f,   0.0f,  -5.0f,   0.0f,  1.0f,  0.0f,
+  0.0f,  -4.0f,  -4.0f,   1.0f,  1.0f,  0.0f,
+  0.0f,   4.0f,  -4.0f,  -1.0f,  1.0f,  0.0f,
+  0.0f,  -2.0f,  -1.0f,   2.0f,  1.0f,  0.0f,
+  0.0f,   2.0f,  -1.0f,  -2.0f,  1.0f,  0.0f,
+  0.0f,   4.0f,   0.0f,  -5.0f,  0.0f,  1.0f
+};
+
+const float B_4x4_3x3[] = {
+   4.0f,   0.0f,   0.0f,   0.0f,   0.0f,   0.0f,
+   0.0f,  -4.0f,   4.0f,  -2.0f,   2.0f,   4.0f,
+  -5.0f,  -4.0f,  -4.0f,  -1.0f,  -1.0f,   0.0f,
+   0.0f,   1.0f,  -1.0f,   2.0f,  -2.0f,  -5.0f,
+   1.0f,   1.0f,   1.0f,   1.0f,   1.0f,   0.0f,
+   0.0f,   0.0f,   0.0f,   0.0f,   0.0f,   1.0f
+};
+
+const float GT_4x4_3x3[] = {
+  1.0f/4.0f,  -1.0f/6.0f,  -1.0f/6.0f,  1.0f/24.0f,   1.0f/24.0f,  0.0f,
+       0.0f,  -1.0f/6.0f,   1.0f/6.0f,  1.0f/12.0f,  -1.0f/12.0f,  0.0f,
+       0.0f,  -1.0f/6.0f,  -1.0f/6.0f,   1.0f/6.0f,    1.0f/6.0f,  1.0f
+};
+
+const float G_4x4_3x3[] = {
+   1.0f/4.0f,         0.0f,        0.0f,
+  -1.0f/6.0f,   -1.0f/6.0f,  -1.0f/6.0f,
+  -1.0f/6.0f,    1.0f/6.0f,  -1.0f/6.0f,
+  1.0f/24.0f,   1.0f/12.0f,   1.0f/6.0f,
+  1.0f/24.0f,  -1.0f/12.0f,   1.0f/6.0f,
+        0.0f,         0.0f,        1.0f
+};
+
+const float AT_4x4_3x3[] = {
+  1.0f,  1.0f,   1.0f,  1.0f,   1.0f,  0.0f,
+  0.0f,  1.0f,  -1.0f,  2.0f,  -2.0f,  0.0f,
+  0.0f,  1.0f,   1.0f,  4.0f,   4.0f,  0.0f,
+  0.0f,  1.0f,  -1.0f,  8.0f,  -8.0f,  1.0f
+};
+
+const float A_4x4_3x3[] = {
+  1.0f,   0.0f,  0.0f,   0.0f,
+  1.0f,   1.0f,  1.0f,   1.0f,
+  1.0f,  -1.0f,  1.0f,  -1.0f,
+  1.0f,   2.0f,  4.0f,   8.0f,
+  1.0f,  -2.0f,  4.0f,  -8.0f,
+  0.0f,   0.0f,  0.0f,   1.0f
+};
+
 // clang-format on
 
 } // namespace mlir::iree_compiler::IREE::LinalgExt::Winograd
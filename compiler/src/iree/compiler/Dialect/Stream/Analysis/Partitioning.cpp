@@ -166,6 +166,216 @@ void PartitionSet::topologicalSort() {
   partitions = std::move(sortedSet);
 }
 
+// Returns the estimated cost of executing |op| within a partition.
+// Ops that are cloned to their consumers (like splats) are considered free.
+static int64_t estimateOpCost(Operation *op) {
+  auto streamableOp = dyn_cast<IREE::Stream::StreamableOpInterface>(op);
+  if (!streamableOp || streamableOp.preferCloneToConsumers())
+    return 0;
+  return 1;
+}
+
+// Recomputes the inputs and outputs of |partition| from its ops. Values in
+// |escapingValues| that are produced by the partition become outputs.
+static void collectPartitionIO(Partition &partition,
+                               const SetVector<Value> &escapingValues) {
+  SetVector<Value> producedValues;
+  for (auto *op : partition.ops) {
+    producedValues.insert(op->result_begin(), op->result_end());
+  }
+  partition.ins.clear();
+  partition.outs.clear();
+  for (auto *op : llvm::reverse(partition.ops)) {
+    for (auto operand : op->getOperands()) {
+      if (!producedValues.contains(operand))
+        partition.ins.insert(operand);
+    }
+  }
+  for (auto value : escapingValues) {
+    if (producedValues.contains(value))
+      partition.outs.insert(value);
+  }
+}
+
+// Attempts to split |partition| into a leading partition producing the values
+// that escape early and a trailing partition with the remaining work. Only
+// escaping values for which |shouldSplitOn| returns true are considered.
+// Returns false if the split would not be profitable.
+static bool trySplitPartition(Partition &partition, int64_t submissionCost,
+                              llvm::function_ref<bool(Value)> shouldSplitOn,
+                              Partition &leadingPartition,
+                              Partition &trailingPartition) {
+  // Ops are stored in reverse program order.
+  auto &ops = partition.ops;
+  int64_t totalCost = 0;
+  for (auto *op : ops) {
+    totalCost += estimateOpCost(op);
+  }
+  if (totalCost < submissionCost)
+    return false;
+
+  // Captured values passed through as outputs have no producer to split on.
+  for (auto out : partition.outs) {
+    auto *definingOp = out.getDefiningOp();
+    if (!definingOp || !ops.contains(definingOp))
+      return false;
+  }
+
+  // Computes the ops in the partition that |value| transitively depends on.
+  auto computeBackwardSlice = [&](Value value, SetVector<Operation *> &slice) {
+    SmallVector<Operation *> worklist;
+    if (auto *definingOp = value.getDefiningOp())
+      worklist.push_back(definingOp);
+    while (!worklist.empty()) {
+      auto *op = worklist.pop_back_val();
+      if (!ops.contains(op) || !slice.insert(op))
+        continue;
+      for (auto operand : op->getOperands()) {
+        if (auto *definingOp = operand.getDefiningOp())
+          worklist.push_back(definingOp);
+      }
+    }
+  };
+  auto computeCost = [&](const SetVector<Operation *> &slice) {
+    int64_t cost = 0;
+    for (auto *op : slice)
+      cost += estimateOpCost(op);
+    return cost;
+  };
+
+  // Gather the ops required by each escaping value that would otherwise wait
+  // on enough unrelated work to be worth an additional submission.
+  SetVector<Operation *> leadingOps;
+  for (auto out : partition.outs) {
+    if (!shouldSplitOn(out))
+      continue;
+    SetVector<Operation *> slice;
+    computeBackwardSlice(out, slice);
+    if (totalCost - computeCost(slice) >= submissionCost) {
+      leadingOps.insert(slice.begin(), slice.end());
+    }
+  }
+  if (leadingOps.empty() || leadingOps.size() == ops.size() ||
+      totalCost - computeCost(leadingOps) < submissionCost) {
+    return false;
+  }
+
+  // Partition the ops preserving their (reverse program) order. Ops preferring
+  // to be cloned are duplicated into the trailing partition if it needs them
+  // instead of being passed between the partitions.
+  SetVector<Operation *> trailingOps;
+  for (auto *op : ops) {
+    if (!leadingOps.contains(op))
+      trailingOps.insert(op);
+  }
+  for (auto *op : ops) {
+    if (!leadingOps.contains(op))
+      continue;
+    auto streamableOp = dyn_cast<IREE::Stream::StreamableOpInterface>(op);
+    if (!streamableOp || !streamableOp.preferCloneToConsumers())
+      continue;
+    bool escapes = llvm::any_of(op->getResults(), [&](Value result) {
+      return partition.outs.contains(result);
+    });
+    bool usedByTrailing = llvm::any_of(op->getUsers(), [&](Operation *user) {
+      return trailingOps.contains(user);
+    });
+    if (!escapes && usedByTrailing)
+      trailingOps.insert(op);
+  }
+  leadingPartition.ops.clear();
+  trailingPartition.ops.clear();
+  for (auto *op : ops) {
+    if (leadingOps.contains(op))
+      leadingPartition.ops.insert(op);
+    if (trailingOps.contains(op))
+      trailingPartition.ops.insert(op);
+  }
+
+  // The leading partition additionally produces everything the trailing
+  // partition consumes from it.
+  SetVector<Value> leadingEscapingValues = partition.outs;
+  for (auto *op : trailingPartition.ops) {
+    for (auto operand : op->getOperands()) {
+      auto *definingOp = operand.getDefiningOp();
+      if (definingOp && leadingPartition.ops.contains(definingOp) &&
+          !trailingPartition.ops.contains(definingOp)) {
+        leadingEscapingValues.insert(operand);
+      }
+    }
+  }
+  leadingPartition.affinity = partition.affinity;
+  trailingPartition.affinity = partition.affinity;
+  collectPartitionIO(leadingPartition, leadingEscapingValues);
+  SetVector<Value> trailingEscapingValues;
+  for (auto out : partition.outs) {
+    if (!leadingPartition.outs.contains(out))
+      trailingEscapingValues.insert(out);
+  }
+  collectPartitionIO(trailingPartition, trailingEscapingValues);
+  return true;
+}
+
+void splitPartitionsForOverlap(IREE::Stream::PartitioningConfigAttr config,
+                               int64_t submissionCost,
+                               PartitionSet &partitionSet) {
+  if (submissionCost <= 0)
+    return;
+
+  // Values produced on one device and consumed by a partition on another are
+  // the hand-off between pipeline stages. Splitting on them lets the consuming
+  // device start its stage (and the transfer feeding it) while the producing
+  // device continues with the rest of its work instead of idling until the
+  // entire producer partition completes.
+  DenseMap<Value, IREE::Stream::AffinityAttr> producerAffinities;
+  for (auto &partition : partitionSet.partitions) {
+    for (auto out : partition.outs)
+      producerAffinities[out] = partition.affinity;
+  }
+  DenseSet<Value> crossDeviceValues;
+  for (auto &partition : partitionSet.partitions) {
+    if (!partition.affinity)
+      continue;
+    for (auto in : partition.ins) {
+      auto producerAffinity = producerAffinities.lookup(in);
+      if (producerAffinity &&
+          !producerAffinity.isExecutableWith(partition.affinity)) {
+        crossDeviceValues.insert(in);
+      }
+    }
+  }
+
+  // Otherwise splitting trades more submissions (and higher peak memory from
+  // work in flight concurrently) for overlap so we only do it when asked to.
+  bool favorConcurrency =
+      config.getFavor().getValue() == IREE::Stream::Favor::MaxConcurrency;
+  if (!favorConcurrency && crossDeviceValues.empty())
+    return;
+  auto shouldSplitOn = [&](Value value) {
+    return favorConcurrency || crossDeviceValues.contains(value);
+  };
+
+  // Partitions are in topological order and remain so as a leading partition
+  // only depends on partitions the original partition depended on.
+  SmallVector<Partition> partitions;
+  partitions.reserve(partitionSet.partitions.size());
+  for (auto &partition : partitionSet.partitions) {
+    Partition remainingPartition = std::move(partition);
+    Partition leadingPartition;
+    Partition trailingPartition;
+    while (trySplitPartition(remainingPartition, submissionCost,
+                             shouldSplitOn, leadingPartition,
+                             trailingPartition)) {
+      partitions.push_back(std::move(leadingPartition));
+      remainingPartition = std::move(trailingPartition);
+      leadingPartition = Partition();
+      trailingPartition = Partition();
+    }
+    partitions.push_back(std::move(remainingPartition));
+  }
+  partitionSet.partitions = std::move(partitions);
+}
+
 PartitionSet partitionStreamableOps(IREE::Stream::PartitioningConfigAttr config,
                                     Block *block) {
   // Only one algorithm today.
@@ -109,6 +109,25 @@ PartitionSet
 partitionRegionConcurrency(IREE::Stream::PartitioningConfigAttr config,
                            Block *block);
 
+// Splits partitions in |partitionSet| so that values leaving a partition are
+// produced by a leading partition of just the ops they depend on. Consumers of
+// those values (later partitions or the host) then only wait on the leading
+// partition and can overlap with the remaining work instead of waiting for the
+// entire partition to complete.
+//
+// |submissionCost| is the estimated overhead of an additional submission on
+// the target measured in streamable ops. A partition is only split when at
+// least that much work remains to overlap with the consumers of its leading
+// partition, bounding the number of partitions produced.
+//
+// Values handed off to a partition with a different affinity are always split
+// on regardless of the favored partitioning so that work spanning multiple
+// devices is pipelined: each device starts its stage as soon as the values it
+// depends on are produced rather than after all of the producing stage.
+void splitPartitionsForOverlap(IREE::Stream::PartitioningConfigAttr config,
+                               int64_t submissionCost,
+                               PartitionSet &partitionSet);
+
 //===----------------------------------------------------------------------===//
 // Reference partitioning
 //===----------------------------------------------------------------------===//
@@ -11,6 +11,7 @@
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/CommandLine.h"
 #include "mlir/IR/DialectImplementation.h"
+#include "mlir/IR/Matchers.h"
 
 // clang-format off: must be included after all LLVM/MLIR headers.
 #define GET_ATTRDEF_CLASSES
@@ -87,7 +88,11 @@ void AsyncAccessRange::print(llvm::raw_ostream &os, AsmState &asmState) {
   os << stringifyResourceAccessBitfield(access) << " ";
   resource.printAsOperand(os, asmState);
   os << "[";
-  start.printAsOperand(os, asmState);
+  if (start) {
+    start.printAsOperand(os, asmState);
+  } else {
+    os << "0";
+  }
   os << " to ";
   end.printAsOperand(os, asmState);
   os << " for ";
@@ -108,6 +113,21 @@ bool AsyncAccessRange::mayOverlap(const AsyncAccessRange &lhs,
     return false;
   }
 
+  // Check for disjoint constant ranges.
+  auto matchBound = [](Value value, APInt &bound) {
+    if (!value) {
+      bound = APInt(64, 0);
+      return true;
+    }
+    return matchPattern(value, m_ConstantInt(&bound));
+  };
+  APInt lhsStart, lhsEnd, rhsStart, rhsEnd;
+  if (matchBound(lhs.start, lhsStart) && matchBound(lhs.end, lhsEnd) &&
+      matchBound(rhs.start, rhsStart) && matchBound(rhs.end, rhsEnd)) {
+    return lhsStart.getZExtValue() < rhsEnd.getZExtValue() &&
+           rhsStart.getZExtValue() < lhsEnd.getZExtValue();
+  }
+
   // _May_ overlap. More analysis required.
   return true;
 }
@@ -112,6 +112,10 @@ struct Statistics {
   size_t submissionCount = 0;
   int64_t transientSize = 0;
   bool transientSizeDynamic = false;
+  // Static transient allocations with a known peak live size as recorded by
+  // slice layout and the sum of those peak live sizes.
+  int64_t packedTransientSize = 0;
+  int64_t packedTransientPeakLiveSize = 0;
   // TODO(benvanik): add fill/copy sizes (when possible).
   size_t fillCount = 0;
   size_t copyCount = 0;
@@ -157,6 +161,11 @@ struct Statistics {
       APInt allocaSize;
       if (matchPattern(allocaOp.getStorageSize(), m_ConstantInt(&allocaSize))) {
         transientSize += allocaSize.getSExtValue();
+        if (auto peakLiveSizeAttr = allocaOp->getAttrOfType<IntegerAttr>(
+                "stream.peak_live_size")) {
+          packedTransientSize += allocaSize.getSExtValue();
+          packedTransientPeakLiveSize += peakLiveSizeAttr.getInt();
+        }
       } else {
         transientSizeDynamic = true;
       }
@@ -177,6 +186,19 @@ struct Statistics {
     // Executables:
     executableCount = usageInfo.executableOps.size();
   }
+
+  // Returns the bytes of packed transient memory in excess of the peak live
+  // size of the slices packed into them.
+  int64_t getPackedTransientWasteSize() const {
+    return packedTransientSize - packedTransientPeakLiveSize;
+  }
+
+  // Returns the percentage of packed transient memory that is wasted.
+  float getPackedTransientWastePercentage() const {
+    if (!packedTransientSize)
+      return 0.0f;
+    return getPackedTransientWasteSize() / (float)packedTransientSize * 100.0f;
+  }
 };
 
 //===----------------------------------------------------------------------===//
@@ -243,6 +265,11 @@ static void prettyPrintStatistics(const UsageInfo &usageInfo,
   os << llvm::formatv(
       "{0}{1} B ({2:F2} MiB)\n", stats.transientSizeDynamic ? "minimum " : "",
       stats.transientSize, stats.transientSize / (1 * 1024 * 1024.0f));
+  os << llvm::formatv("//     Packing: {0:F1}% wasted, {1} B over peak live "
+                      "size of {2} B\n",
+                      stats.getPackedTransientWastePercentage(),
+                      stats.getPackedTransientWasteSize(),
+                      stats.packedTransientPeakLiveSize);
 
   os << llvm::formatv("//   DMA Fills: {0}\n", stats.fillCount);
   os << llvm::formatv("//  DMA Copies: {0}\n", stats.copyCount);
@@ -402,7 +429,7 @@ static void dumpAggregateCSVTable(const UsageInfo &usageInfo,
   Statistics stats;
   stats.analyze(usageInfo);
 
-  os << R"("Constants","Constant Size","Variables","Variable Size","Awaits","Submissions","Transient Size","Fills","Copies","Dispatches","Async Calls","Executables")";
+  os << R"("Constants","Constant Size","Variables","Variable Size","Awaits","Submissions","Transient Size","Fills","Copies","Dispatches","Async Calls","Executables","Transient Waste")";
   os << "\n";
 
   // Globals:
@@ -419,7 +446,10 @@ static void dumpAggregateCSVTable(const UsageInfo &usageInfo,
                       stats.dispatchCount, stats.callCount);
 
   // Executables:
-  os << llvm::formatv("{0}", stats.executableCount);
+  os << llvm::formatv("{0},", stats.executableCount);
+
+  // Packing:
+  os << llvm::formatv("{0}", stats.getPackedTransientWasteSize());
 
   os << "\n";
   os << "\n";
@@ -537,6 +567,8 @@ static void dumpAggregateJSONStructure(const UsageInfo &usageInfo,
   os << "  \"execution\": {\n";
   os << llvm::formatv(kvPair, "submission-count", stats.submissionCount);
   os << llvm::formatv(kvPair, "transient-memory-size", stats.transientSize);
+  os << llvm::formatv(kvPair, "transient-memory-waste-size",
+                      stats.getPackedTransientWasteSize());
   os << llvm::formatv(kvPair, "fill-count", stats.fillCount);
   os << llvm::formatv(kvPair, "copy-count", stats.copyCount);
   os << llvm::formatv(kvPair, "dispatch-count", stats.dispatchCount);
@@ -16,6 +16,7 @@
 #include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "llvm/ADT/TypeSwitch.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Analysis/Liveness.h"
 #include "mlir/IR/AsmState.h"
@@ -29,6 +30,13 @@
 
 #define DEBUG_TYPE "iree-stream-elide-async-copies"
 
+static llvm::cl::opt<bool> clEmitCopyRemarks(
+    "iree-stream-emit-copy-remarks",
+    llvm::cl::desc("Emits a remark on each stream.async.clone and "
+                   "stream.async.slice that could not be elided explaining "
+                   "why it must be preserved."),
+    llvm::cl::init(false));
+
 namespace mlir::iree_compiler::IREE::Stream {
 
 #define GEN_PASS_DEF_ELIDEASYNCCOPIESPASS
@@ -364,6 +372,83 @@ private:
 // IREE::Stream::AsyncCloneOp elision
 //===----------------------------------------------------------------------===//
 
+// Returns true if the clone can be elided because its only consumer updates
+// the cloned resource in-place at a range no other user of the source reads.
+// This is common with KV-cache style globals where a slot of a large resource
+// is updated while other slots are read by the same invocation:
+//   %0 = util.global.load @cache
+//   %1 = clone(%0) ---> %2 = update(%u, %1[8 to 12])  // only use of %1
+//      \--> dispatch(%0[0 to 8])                      // disjoint read
+// All other users of the source must be known to only read from it, must be
+// ordered before the consumer, and must not access the updated range.
+static bool
+isSafeToUpdateCloneSourceInPlace(IREE::Stream::AsyncCloneOp cloneOp) {
+  Value source = cloneOp.getSource();
+  Value result = cloneOp.getResult();
+  if (!result.hasOneUse())
+    return false;
+  auto &consumerUse = *result.getUses().begin();
+  auto consumerOp =
+      dyn_cast<IREE::Stream::AsyncAccessOpInterface>(consumerUse.getOwner());
+  auto tiedConsumerOp =
+      dyn_cast<IREE::Util::TiedOpInterface>(consumerUse.getOwner());
+  if (!consumerOp || !tiedConsumerOp ||
+      !tiedConsumerOp.isOperandTied(consumerUse.getOperandNumber())) {
+    return false;
+  }
+
+  // Constants cannot be updated in-place and tied sources may be aliased by
+  // values we don't track here.
+  auto sourceType = llvm::cast<IREE::Stream::ResourceType>(source.getType());
+  if (sourceType.getLifetime() == IREE::Stream::Lifetime::Constant ||
+      IREE::Util::TiedOpInterface::findTiedBaseValue(source) != source) {
+    return false;
+  }
+
+  // Gather the ranges of the clone the consumer accesses as if it accessed
+  // the source directly.
+  SmallVector<AsyncAccessRange> consumerRanges;
+  SmallVector<AsyncAccessRange> queryRanges;
+  consumerOp.getAsyncAccessRanges(queryRanges);
+  for (auto range : queryRanges) {
+    if (range.resource != result)
+      continue;
+    range.resource = source;
+    consumerRanges.push_back(range);
+  }
+  queryRanges.clear();
+
+  for (auto &use : source.getUses()) {
+    Operation *userOp = use.getOwner();
+    if (userOp == cloneOp)
+      continue;
+    auto accessOp = dyn_cast<IREE::Stream::AsyncAccessOpInterface>(userOp);
+    if (!accessOp || userOp->getBlock() != consumerOp->getBlock() ||
+        !userOp->isBeforeInBlock(consumerOp)) {
+      return false;
+    }
+    if (auto tiedOp = dyn_cast<IREE::Util::TiedOpInterface>(userOp)) {
+      if (tiedOp.isOperandTied(use.getOperandNumber()))
+        return false;
+    }
+    accessOp.getAsyncAccessRanges(queryRanges);
+    for (auto &userRange : queryRanges) {
+      if (userRange.resource != source)
+        continue;
+      if (!userRange.isReadOnly())
+        return false;
+      for (auto &consumerRange : consumerRanges) {
+        if (IREE::Stream::AsyncAccessRange::mayOverlap(userRange,
+                                                       consumerRange)) {
+          return false;
+        }
+      }
+    }
+    queryRanges.clear();
+  }
+  return true;
+}
+
 // Returns true if the given |operand| value does not need a copy on write.
 // This is a conservative check and will return false ("not safe to elide") in
 // many cases that otherwise don't need a copy. The
@@ -380,8 +465,15 @@ private:
 // Second clone elidable, first required:
 //   %0 ---> %1 = clone(%0) ---> use(%1)
 //      \--> %2 = clone(%0) ---> use(%2)  // last use of %0
+//
+// Clone elidable as the update doesn't overlap other reads of %0:
+//   %0 ---> %1 = clone(%0) ---> update(%1[8 to 12])
+//      \--> use(%0[0 to 8])
+//
+// When the clone cannot be elided |reason| is set to a description of why.
 static bool isSafeToElideCloneOp(IREE::Stream::AsyncCloneOp cloneOp,
-                                 ElisionAnalysis &analysis) {
+                                 ElisionAnalysis &analysis,
+                                 StringRef &reason) {
   LLVM_DEBUG({
     llvm::dbgs() << "isSafeToElideCloneOp:\n";
     llvm::dbgs() << "  ";
@@ -400,6 +492,7 @@ static bool isSafeToElideCloneOp(IREE::Stream::AsyncCloneOp cloneOp,
       sourceType.getLifetime() == IREE::Stream::Lifetime::Constant) {
     LLVM_DEBUG(llvm::dbgs()
                << "  - clone source is a constant; cannot elide\n");
+    reason = "clone changes the lifetime of a constant";
     return false;
   }
 
@@ -411,6 +504,8 @@ static bool isSafeToElideCloneOp(IREE::Stream::AsyncCloneOp cloneOp,
     if (!analysis.isArgMoved(arg)) {
       LLVM_DEBUG(llvm::dbgs()
                  << "  - clone source is a by-ref arg; cannot elide\n");
+      reason = "clone source is an argument that may be retained by a caller "
+               "or predecessor";
       return false;
     }
     LLVM_DEBUG(llvm::dbgs()
@@ -432,8 +527,19 @@ static bool isSafeToElideCloneOp(IREE::Stream::AsyncCloneOp cloneOp,
     return true;
   }
 
+  // If the clone is only used to update a range of the source that no other
+  // user accesses we can perform the update in-place.
+  if (isSafeToUpdateCloneSourceInPlace(cloneOp)) {
+    LLVM_DEBUG(llvm::dbgs()
+               << "  + clone is updated in-place at a range not read by "
+                  "other users; can elide\n");
+    return true;
+  }
+
   // Not safe.
   LLVM_DEBUG(llvm::dbgs() << "  - clone source cannot be elided\n");
+  reason = "clone source is used after the clone and the clone may be "
+           "mutated at a range overlapping those uses";
   return false;
 }
 
@@ -468,8 +574,10 @@ static bool areSliceUsesSupported(IREE::Stream::AsyncSliceOp sliceOp) {
 
 // Returns true if |sliceOp| is safe to elide.
 // This is only the case if the users are all supported ops.
+// When the slice cannot be elided |reason| is set to a description of why.
 static bool isSafeToElideSliceOp(IREE::Stream::AsyncSliceOp sliceOp,
-                                 ElisionAnalysis &analysis) {
+                                 ElisionAnalysis &analysis,
+                                 StringRef &reason) {
   LLVM_DEBUG({
     llvm::dbgs() << "isSafeToElideSliceOp:\n";
     llvm::dbgs() << "  ";
@@ -481,6 +589,7 @@ static bool isSafeToElideSliceOp(IREE::Stream::AsyncSliceOp sliceOp,
   if (!areSliceUsesSupported(sliceOp)) {
     LLVM_DEBUG(llvm::dbgs()
                << "  - slice consumers not supported; cannot elide\n");
+    reason = "slice is consumed by an op it cannot be folded into";
     return false;
   }
 
@@ -491,6 +600,7 @@ static bool isSafeToElideSliceOp(IREE::Stream::AsyncSliceOp sliceOp,
   if (source != sourceBase) {
     LLVM_DEBUG(llvm::dbgs()
                << "  - source is tied; cannot be elided (today)\n");
+    reason = "slice source is the result of an in-place operation";
     return false;
   }
 
@@ -526,6 +636,7 @@ static bool isSafeToElideSliceOp(IREE::Stream::AsyncSliceOp sliceOp,
             << "  - analysis failure on unhandled user of slice source:\n";
         user->print(llvm::dbgs(), analysis.getAsmState());
       });
+      reason = "slice source has users whose accesses cannot be analyzed";
       return false;
     }
   }
@@ -546,6 +657,8 @@ static bool isSafeToElideSliceOp(IREE::Stream::AsyncSliceOp sliceOp,
           otherRange.print(llvm::dbgs(), analysis.getAsmState());
           llvm::dbgs() << "\n";
         });
+        reason = "slice source may be written at a range overlapping the "
+                 "slice";
         return false;
       }
     }
@@ -638,16 +751,17 @@ static bool tryElideAsyncCopiesInRegion(Region &region,
   bool didChange = false;
   for (auto &block : region) {
     block.walk([&](Operation *op) {
+      StringRef reason;
       return TypeSwitch<Operation *, WalkResult>(op)
           .Case<IREE::Stream::AsyncCloneOp>([&](auto cloneOp) {
-            if (isSafeToElideCloneOp(cloneOp, analysis)) {
+            if (isSafeToElideCloneOp(cloneOp, analysis, reason)) {
               elideCloneOp(cloneOp);
               didChange = true;
             }
             return WalkResult::advance();
           })
           .Case<IREE::Stream::AsyncSliceOp>([&](auto sliceOp) {
-            if (isSafeToElideSliceOp(sliceOp, analysis)) {
+            if (isSafeToElideSliceOp(sliceOp, analysis, reason)) {
               elideSliceOp(sliceOp);
               didChange = true;
             }
@@ -659,6 +773,25 @@ static bool tryElideAsyncCopiesInRegion(Region &region,
   return didChange;
 }
 
+// Emits a remark on each copy nested within |region| that the analysis could
+// not elide explaining why it must be preserved.
+static void emitPreservedCopyRemarks(Region &region,
+                                     ElisionAnalysis &analysis) {
+  region.walk([&](Operation *op) {
+    StringRef reason;
+    TypeSwitch<Operation *>(op)
+        .Case<IREE::Stream::AsyncCloneOp>([&](auto cloneOp) {
+          if (!isSafeToElideCloneOp(cloneOp, analysis, reason))
+            cloneOp.emitRemark() << "clone preserved: " << reason;
+        })
+        .Case<IREE::Stream::AsyncSliceOp>([&](auto sliceOp) {
+          if (!isSafeToElideSliceOp(sliceOp, analysis, reason))
+            sliceOp.emitRemark() << "slice preserved: " << reason;
+        })
+        .Default([](auto *op) {});
+  });
+}
+
 // Elides async copies that perform no meaningful work - such as clones of the
 // last use of a value. This is designed to be run after
 // --iree-stream-materialize-copy-on-write to clean up the copies it introduces
@@ -704,8 +837,16 @@ struct ElideAsyncCopiesPass
           continue;
         didChange = tryElideAsyncCopiesInRegion(*region, analysis) || didChange;
       }
-      if (!didChange)
+      if (!didChange) {
+        // Report the copies that remain using the final analysis.
+        if (clEmitCopyRemarks) {
+          for (auto callableOp : analysis.getTopLevelOps()) {
+            if (auto *region = callableOp.getCallableRegion())
+              emitPreservedCopyRemarks(*region, analysis);
+          }
+        }
         break;
+      }
     }
     if (iterationCount == maxIterationCount) {
       // If you find yourself hitting this we can evaluate increasing the
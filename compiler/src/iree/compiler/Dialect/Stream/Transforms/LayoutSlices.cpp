@@ -4,7 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-#include <list>
+#include <functional>
 
 #include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
@@ -14,6 +14,8 @@
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/compiler/Utils/IndexSet.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/IR/AsmState.h"
@@ -34,54 +36,52 @@ namespace {
 
 using Slice = IREE::Stream::ResourcePackOp::Slice;
 
-// Packs a set of statically-sized slices by greedy strip packing.
-//
-// This is the same algorithm used in tflite here:
-// https://github.com/tensorflow/tensorflow/blob/master/tensorflow/lite/simple_memory_arena.cc
-// It's not fantastic and can end up with a significant amount of wastage.
-// They do the packing at runtime and as such care more about performance than
-// we do while doing the packing here offline. For this initial version I
-// wanted to ensure we matched apples/apples their implementation.
-//
-// We should use a set of heuristics and pick the smallest one. There are also
-// some really great papers that have approximations (as all of these are -
-// 2D strip packing is NP-hard) such as
-// https://www.sciencedirect.com/science/article/pii/S0925772113001016 that
-// someone with a brain able to parse mathy papers can try implementing.
-//
-// Slice packed offset SSA values will be updated and start at the given
-// |baseOffset|. Returns |baseOffset| + the total size of the allocation
-// aligned to the requirements of |resourceConfig|.
-static Value
-packStaticSlicesGreedily(IREE::Stream::ResourcePackOp packOp, Value baseOffset,
-                         MutableArrayRef<Slice> slices,
-                         IREE::Stream::ResourceConfigAttr resourceConfig,
-                         IndexSet &indexSet, OpBuilder &builder) {
-  int64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
-  int64_t rangeAlignment = resourceConfig.getMinBufferRangeAlignment();
+// Discardable attribute placed on allocations sized by a static pack recording
+// the peak number of bytes live at any point across the packed slices. This is
+// the lower bound of any packing and lets statistics report the wastage.
+static constexpr StringLiteral kPeakLiveSizeAttrName = "stream.peak_live_size";
 
-  struct Reservation {
-    const Slice *slice = nullptr;
-    int64_t staticOffset = 0;
-    int64_t staticSize = 0;
-  };
-  static constexpr int64_t UNASSIGNED = INT64_MAX;
+// A statically-sized slice with its size aligned to the range alignment.
+struct StaticSlice {
+  Slice *slice = nullptr;
+  int64_t alignedSize = 0;
+};
 
-  std::list<Reservation> reservations;
-  int64_t highwaterMark = 0;
-  for (auto &slice : slices) {
+// Result of packing a set of static slices.
+struct StaticPacking {
+  // Offset of each slice, indexed the same as the packed slices.
+  SmallVector<int64_t> offsets;
+  // Total number of bytes required by the packing prior to range alignment.
+  int64_t highwaterMark = INT64_MAX;
+};
+
+// Incrementally built packing with reservations sorted by ascending offset.
+class StaticPacker {
+public:
+  StaticPacker(ArrayRef<StaticSlice> slices, int64_t offsetAlignment)
+      : slices(slices), offsetAlignment(offsetAlignment),
+        offsets(slices.size(), 0) {}
+
+  int64_t getHighwaterMark() const { return highwaterMark; }
+
+  // Reserves memory for slice |index| in the smallest gap between the existing
+  // reservations of slices with intersecting lifetimes that it fits in.
+  //
+  // This is the same algorithm used in tflite here:
+  // https://github.com/tensorflow/tensorflow/blob/master/tensorflow/lite/simple_memory_arena.cc
+  void reserve(unsigned index) {
+    static constexpr int64_t UNASSIGNED = INT64_MAX;
+    const StaticSlice &slice = slices[index];
     int64_t bestOffset = UNASSIGNED;
     int64_t bestOffsetFit = UNASSIGNED;
-    int64_t staticSize =
-        cast<arith::ConstantIndexOp>(slice.dynamicSize.getDefiningOp()).value();
-    int64_t alignedSize = IREE::Util::align(staticSize, rangeAlignment);
 
     // Iterate through reservations (sorted by ascending offset) and identify
     // gaps in which the slice will fit. To reduce wastage we want to find the
     // smallest gap.
     int64_t currentOffset = 0;
-    for (auto &reservation : reservations) {
-      if (!reservation.slice->intersects(slice)) {
+    for (unsigned reservedIndex : reservations) {
+      const StaticSlice &reservedSlice = slices[reservedIndex];
+      if (!reservedSlice.slice->intersects(*slice.slice)) {
         // Non-overlapping - we can reuse the currentOffset (assuming we find
         // no better place).
         continue;
@@ -89,39 +89,206 @@ packStaticSlicesGreedily(IREE::Stream::ResourcePackOp packOp, Value baseOffset,
 
       // If we found a gap >= the required size and smaller than
       // previous best fit take it.
+      int64_t reservedOffset = offsets[reservedIndex];
       int64_t alignedOffset = IREE::Util::align(currentOffset, offsetAlignment);
-      if (alignedOffset + alignedSize <= reservation.staticOffset &&
-          reservation.staticOffset - alignedOffset < bestOffsetFit) {
+      if (alignedOffset + slice.alignedSize <= reservedOffset &&
+          reservedOffset - alignedOffset < bestOffsetFit) {
         bestOffset = alignedOffset;
-        bestOffsetFit = reservation.staticOffset - currentOffset;
+        bestOffsetFit = reservedOffset - currentOffset;
       }
-      currentOffset = std::max(currentOffset, reservation.staticOffset +
-                                                  reservation.staticSize);
+      currentOffset = std::max(currentOffset,
+                               reservedOffset + reservedSlice.alignedSize);
     }
     if (bestOffset == UNASSIGNED) {
       bestOffset = IREE::Util::align(currentOffset, offsetAlignment);
     }
 
     // Reserve the memory.
-    Reservation reservation;
-    reservation.slice = &slice;
-    reservation.staticOffset = bestOffset;
-    reservation.staticSize = alignedSize;
-    auto insertionIt = reservations.begin();
-    while (insertionIt != reservations.end() &&
-           insertionIt->staticOffset < reservation.staticOffset) {
-      ++insertionIt;
-    }
-    reservations.insert(insertionIt, reservation);
-    slice.packedOffset.replaceAllUsesWith(builder.createOrFold<arith::AddIOp>(
-        packOp.getLoc(), baseOffset, indexSet.get(bestOffset)));
+    offsets[index] = bestOffset;
+    auto insertionIt = llvm::find_if(reservations, [&](unsigned reservedIndex) {
+      return offsets[reservedIndex] >= bestOffset;
+    });
+    reservations.insert(insertionIt, index);
 
     // Update highwater mark indicating how much memory needs to be allocated
     // for the entire slab.
-    highwaterMark = std::max(highwaterMark, bestOffset + alignedSize);
+    highwaterMarks.push_back(highwaterMark);
+    highwaterMark = std::max(highwaterMark, bestOffset + slice.alignedSize);
+  }
+
+  // Removes the reservation of slice |index|, which must have been the last
+  // slice reserved.
+  void unreserve(unsigned index) {
+    reservations.erase(llvm::find(reservations, index));
+    highwaterMark = highwaterMarks.pop_back_val();
   }
 
-  highwaterMark = IREE::Util::align(highwaterMark, rangeAlignment);
+  // Returns the current packing. Only valid once all slices are reserved.
+  StaticPacking getPacking() const { return {offsets, highwaterMark}; }
+
+private:
+  ArrayRef<StaticSlice> slices;
+  int64_t offsetAlignment;
+  SmallVector<int64_t> offsets;
+  SmallVector<unsigned> reservations;
+  SmallVector<int64_t> highwaterMarks;
+  int64_t highwaterMark = 0;
+};
+
+// Packs |slices| by reserving them in the given |order|.
+static StaticPacking packStaticSlicesInOrder(ArrayRef<StaticSlice> slices,
+                                             ArrayRef<unsigned> order,
+                                             int64_t offsetAlignment) {
+  StaticPacker packer(slices, offsetAlignment);
+  for (unsigned index : order) {
+    packer.reserve(index);
+  }
+  return packer.getPacking();
+}
+
+// Returns the peak number of bytes live at any point in the lifetimes of
+// |slices|. No packing can use less memory than this.
+static int64_t computePeakLiveSize(ArrayRef<StaticSlice> slices) {
+  // Lifetimes are inclusive so the peak always occurs at the start of some
+  // slice lifetime.
+  int64_t peakLiveSize = 0;
+  for (auto &slice : slices) {
+    int64_t liveSize = 0;
+    for (auto &otherSlice : slices) {
+      if (otherSlice.slice->lifetimeStart <= slice.slice->lifetimeStart &&
+          otherSlice.slice->lifetimeEnd >= slice.slice->lifetimeStart) {
+        liveSize += otherSlice.alignedSize;
+      }
+    }
+    peakLiveSize = std::max(peakLiveSize, liveSize);
+  }
+  return peakLiveSize;
+}
+
+// Maximum number of slices searched exhaustively by branch and bound.
+static constexpr size_t kMaxBranchAndBoundSliceCount = 10;
+// Maximum number of reservations made by a single branch and bound search.
+static constexpr int64_t kMaxBranchAndBoundSteps = 1 << 20;
+
+// Searches reservation orders of |slices| for the one producing the smallest
+// packing, pruning any partial order that already needs at least as much
+// memory as |bestPacking|. |bestPacking| should be seeded with a heuristic
+// result and is updated with any better packing found. The search stops early
+// if a packing matching |lowerBound| is found or the step budget is exhausted.
+static void packStaticSlicesWithBranchAndBound(ArrayRef<StaticSlice> slices,
+                                               int64_t offsetAlignment,
+                                               int64_t lowerBound,
+                                               StaticPacking &bestPacking) {
+  StaticPacker packer(slices, offsetAlignment);
+  SmallVector<bool> reserved(slices.size(), false);
+  int64_t remainingSteps = kMaxBranchAndBoundSteps;
+  std::function<void(size_t)> search = [&](size_t depth) {
+    if (depth == slices.size()) {
+      if (packer.getHighwaterMark() < bestPacking.highwaterMark) {
+        bestPacking = packer.getPacking();
+      }
+      return;
+    }
+    for (unsigned index = 0; index < slices.size(); ++index) {
+      if (reserved[index])
+        continue;
+      if (remainingSteps-- <= 0 || bestPacking.highwaterMark <= lowerBound)
+        return;
+      packer.reserve(index);
+      if (packer.getHighwaterMark() < bestPacking.highwaterMark) {
+        reserved[index] = true;
+        search(depth + 1);
+        reserved[index] = false;
+      }
+      packer.unreserve(index);
+    }
+  };
+  search(0);
+}
+
+// Packs a set of statically-sized slices by strip packing.
+//
+// The tflite greedy algorithm reserves slices in lifetime order and can end up
+// with a significant amount of wastage. As we do the packing offline we can
+// afford to try a set of heuristics (2D strip packing is NP-hard) and pick the
+// smallest result: the tflite order, best-fit decreasing by size, and best-fit
+// decreasing by lifetime length. Small sets of slices are then searched
+// exhaustively with branch and bound. There are also some really great papers
+// that have approximations such as
+// https://www.sciencedirect.com/science/article/pii/S0925772113001016 that
+// someone with a brain able to parse mathy papers can try implementing.
+//
+// Slice packed offset SSA values will be updated and start at the given
+// |baseOffset|. Returns |baseOffset| + the total size of the allocation
+// aligned to the requirements of |resourceConfig|. |outPeakLiveSize| is set to
+// the minimum size any packing of the slices could have.
+static Value packStaticSlices(IREE::Stream::ResourcePackOp packOp,
+                              Value baseOffset, MutableArrayRef<Slice> slices,
+                              IREE::Stream::ResourceConfigAttr resourceConfig,
+                              IndexSet &indexSet, OpBuilder &builder,
+                              int64_t &outPeakLiveSize) {
+  int64_t offsetAlignment = resourceConfig.getMinBufferOffsetAlignment();
+  int64_t rangeAlignment = resourceConfig.getMinBufferRangeAlignment();
+
+  SmallVector<StaticSlice> staticSlices;
+  staticSlices.reserve(slices.size());
+  for (auto &slice : slices) {
+    int64_t staticSize =
+        cast<arith::ConstantIndexOp>(slice.dynamicSize.getDefiningOp()).value();
+    staticSlices.push_back(
+        {&slice, IREE::Util::align(staticSize, rangeAlignment)});
+  }
+  int64_t peakLiveSize = computePeakLiveSize(staticSlices);
+
+  // Try each heuristic order. Earlier orders win ties so that the tflite
+  // result is kept unless another order produces a strictly smaller packing.
+  SmallVector<unsigned> lifetimeOrder =
+      llvm::to_vector(llvm::seq<unsigned>(0, staticSlices.size()));
+  SmallVector<unsigned> sizeOrder = lifetimeOrder;
+  llvm::stable_sort(sizeOrder, [&](unsigned lhs, unsigned rhs) {
+    return staticSlices[lhs].alignedSize > staticSlices[rhs].alignedSize;
+  });
+  SmallVector<unsigned> lengthOrder = lifetimeOrder;
+  llvm::stable_sort(lengthOrder, [&](unsigned lhs, unsigned rhs) {
+    auto length = [&](unsigned index) {
+      return staticSlices[index].slice->lifetimeEnd -
+             staticSlices[index].slice->lifetimeStart;
+    };
+    return std::make_pair(length(lhs), staticSlices[lhs].alignedSize) >
+           std::make_pair(length(rhs), staticSlices[rhs].alignedSize);
+  });
+  StaticPacking bestPacking;
+  for (ArrayRef<unsigned> order : {ArrayRef<unsigned>(lifetimeOrder),
+                                   ArrayRef<unsigned>(sizeOrder),
+                                   ArrayRef<unsigned>(lengthOrder)}) {
+    auto packing =
+        packStaticSlicesInOrder(staticSlices, order, offsetAlignment);
+    if (packing.highwaterMark < bestPacking.highwaterMark) {
+      bestPacking = std::move(packing);
+    }
+  }
+  LLVM_DEBUG(llvm::dbgs() << "[[ Packing " << staticSlices.size()
+                          << " static slices ]]: heuristic "
+                          << bestPacking.highwaterMark << " B, peak live "
+                          << peakLiveSize << " B\n");
+  if (staticSlices.size() <= kMaxBranchAndBoundSliceCount &&
+      bestPacking.highwaterMark > peakLiveSize) {
+    packStaticSlicesWithBranchAndBound(staticSlices, offsetAlignment,
+                                       peakLiveSize, bestPacking);
+    LLVM_DEBUG(llvm::dbgs() << "  branch and bound: "
+                            << bestPacking.highwaterMark << " B\n");
+  }
+
+  for (auto [staticSlice, offset] :
+       llvm::zip_equal(staticSlices, bestPacking.offsets)) {
+    staticSlice.slice->packedOffset.replaceAllUsesWith(
+        builder.createOrFold<arith::AddIOp>(packOp.getLoc(), baseOffset,
+                                            indexSet.get(offset)));
+  }
+
+  outPeakLiveSize = peakLiveSize;
+  int64_t highwaterMark =
+      IREE::Util::align(bestPacking.highwaterMark, rangeAlignment);
   return builder.createOrFold<arith::AddIOp>(packOp.getLoc(), baseOffset,
                                              indexSet.get(highwaterMark));
 }
@@ -227,9 +394,6 @@ struct LayoutSlicesPass
       return;
     }
 
-    // NOTE: we could try several algorithms and compute which packs best. For
-    // now we just pack greedily as it's fast and what most existing ML
-    // frameworks do.
     parentOp.walk([&](IREE::Stream::ResourcePackOp packOp) {
       // Derive resource constraints based on pack affinity.
       auto resourceConfig = IREE::Stream::ResourceConfigAttr::lookup(packOp);
@@ -256,9 +420,10 @@ struct LayoutSlicesPass
       // First pack all static slices as these are entirely knowable here at
       // compile time.
       auto offset = packOp.getOffset() ? packOp.getOffset() : indexSet.get(0);
+      int64_t peakLiveSize = 0;
       if (!staticSlices.empty()) {
-        offset = packStaticSlicesGreedily(packOp, offset, staticSlices,
-                                          resourceConfig, indexSet, builder);
+        offset = packStaticSlices(packOp, offset, staticSlices, resourceConfig,
+                                  indexSet, builder, peakLiveSize);
 
         // TODO(benvanik): make this an option; it can be useful for debugging
         // this code.
@@ -274,6 +439,17 @@ struct LayoutSlicesPass
             packOp, offset, dynamicSlices, resourceConfig, indexSet, builder);
       }
 
+      // Record the lower bound of the static packing on the allocations using
+      // it so that statistics can report how much memory was wasted.
+      if (!staticSlices.empty()) {
+        auto peakLiveSizeAttr = builder.getIndexAttr(peakLiveSize);
+        for (auto *user : packOp.getTotalLength().getUsers()) {
+          if (isa<IREE::Stream::ResourceAllocaOp>(user)) {
+            user->setAttr(kPeakLiveSizeAttrName, peakLiveSizeAttr);
+          }
+        }
+      }
+
       // Total packed length is the current offset after all slices are
       // allocated. This should be aligned to the range constraints.
       packOp.getTotalLength().replaceAllUsesWith(offset);
@@ -218,13 +218,18 @@ static SmallVector<Block *, 8> sortBlocksInDominanceOrder(Region &region) {
 }
 
 LogicalResult processRegion(Location loc, MLIRContext *context, Region &region,
-                            const PartitioningConfigAttr &configAttr) {
+                            const PartitioningConfigAttr &configAttr,
+                            int64_t submissionCost) {
   for (auto *block : sortBlocksInDominanceOrder(region)) {
     // Compute a set of partitions covering all of the streamable ops in the
     // block.
     auto partitionSet = partitionStreamableOps(configAttr, block);
     if (partitionSet.empty())
       continue;
+
+    // Split partitions so that consumers of their results can start before
+    // unrelated work in the same partition completes.
+    splitPartitionsForOverlap(configAttr, submissionCost, partitionSet);
     if (failed(partitionSet.verify(loc))) {
       return failure();
     }
@@ -304,8 +309,10 @@ LogicalResult processRegion(Location loc, MLIRContext *context, Region &region,
     for (auto &op : *block) {
       if (isa<scf::SCFDialect>(op.getDialect())) {
         for (auto &subregion : op.getRegions()) {
-          if (failed(processRegion(loc, context, subregion, configAttr)))
+          if (failed(processRegion(loc, context, subregion, configAttr,
+                                   submissionCost))) {
             return failure();
+          }
         }
       }
     }
@@ -338,8 +345,10 @@ struct ScheduleExecutionPass
     // order so that we are sure if we replace values that dominate other blocks
     // they see the correct values.
     auto &region = *parentOp.getCallableRegion();
-    if (failed(processRegion(parentOp.getLoc(), context, region, configAttr)))
+    if (failed(processRegion(parentOp.getLoc(), context, region, configAttr,
+                             submissionCost))) {
       return signalPassFailure();
+    }
 
     // Cleanup the dead ops.
     // TODO(benvanik): less work here - maybe no patterns to just force folding?
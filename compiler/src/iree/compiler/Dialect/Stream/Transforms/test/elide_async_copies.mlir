@@ -257,3 +257,71 @@ util.func private @slice_dispatch_fold(%producer: !stream.resource<*>) -> !strea
   %consumer = stream.async.dispatch @ex::@dispatch(%c123_i32, %slice[%c10 to %c30 for %c20]) : (i32, !stream.resource<*>{%c100}) -> !stream.resource<*>{%c100}
   util.return %consumer : !stream.resource<*>
 }
+
+// -----
+
+// Tests that a clone of a global updated at a range disjoint from all other
+// reads of the global is elided and the update is performed in-place. This is
+// the pattern KV-cache style globals produce when a single slot is updated.
+
+stream.executable private @ex {
+  stream.executable.export public @dispatch workgroups() -> (index, index, index) {
+    %c1 = arith.constant 1 : index
+    stream.return %c1, %c1, %c1 : index, index, index
+  }
+}
+
+util.global private mutable @cache : !stream.resource<variable>
+
+// CHECK-LABEL: @inPlaceDisjointUpdate
+// CHECK-SAME: (%[[UPDATE:.+]]: !stream.resource<*>)
+util.func public @inPlaceDisjointUpdate(%update: !stream.resource<*>) -> !stream.resource<*> {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %c128 = arith.constant 128 : index
+  %c192 = arith.constant 192 : index
+  %c256 = arith.constant 256 : index
+  // CHECK: %[[CACHE:.+]] = util.global.load @cache
+  %cache = util.global.load @cache : !stream.resource<variable>
+  // CHECK: stream.async.dispatch @ex::@dispatch(%[[CACHE]][%c0 to %c128 for %c128])
+  %read = stream.async.dispatch @ex::@dispatch(%cache[%c0 to %c128 for %c128]) : (!stream.resource<variable>{%c256}) -> !stream.resource<*>{%c64}
+  // CHECK-NOT: stream.async.clone
+  %clone = stream.async.clone %cache : !stream.resource<variable>{%c256} -> !stream.resource<variable>{%c256}
+  // CHECK: %[[UPDATED:.+]] = stream.async.update %[[UPDATE]], %[[CACHE]][%c128 to %c192]
+  %updated = stream.async.update %update, %clone[%c128 to %c192] : !stream.resource<*>{%c64} -> %clone as !stream.resource<variable>{%c256}
+  // CHECK: util.global.store %[[UPDATED]], @cache
+  util.global.store %updated, @cache : !stream.resource<variable>
+  util.return %read : !stream.resource<*>
+}
+
+// -----
+
+// Tests that a clone of a global updated at a range overlapping another read of
+// the global is preserved.
+
+stream.executable private @ex {
+  stream.executable.export public @dispatch workgroups() -> (index, index, index) {
+    %c1 = arith.constant 1 : index
+    stream.return %c1, %c1, %c1 : index, index, index
+  }
+}
+
+util.global private mutable @cache : !stream.resource<variable>
+
+// CHECK-LABEL: @inPlaceOverlappingUpdate
+util.func public @inPlaceOverlappingUpdate(%update: !stream.resource<*>) -> !stream.resource<*> {
+  %c0 = arith.constant 0 : index
+  %c64 = arith.constant 64 : index
+  %c128 = arith.constant 128 : index
+  %c192 = arith.constant 192 : index
+  %c256 = arith.constant 256 : index
+  // CHECK: %[[CACHE:.+]] = util.global.load @cache
+  %cache = util.global.load @cache : !stream.resource<variable>
+  %read = stream.async.dispatch @ex::@dispatch(%cache[%c64 to %c192 for %c128]) : (!stream.resource<variable>{%c256}) -> !stream.resource<*>{%c64}
+  // CHECK: %[[CLONE:.+]] = stream.async.clone %[[CACHE]]
+  %clone = stream.async.clone %cache : !stream.resource<variable>{%c256} -> !stream.resource<variable>{%c256}
+  // CHECK: stream.async.update %{{.+}}, %[[CLONE]][%c128 to %c192]
+  %updated = stream.async.update %update, %clone[%c128 to %c192] : !stream.resource<*>{%c64} -> %clone as !stream.resource<variable>{%c256}
+  util.global.store %updated, @cache : !stream.resource<variable>
+  util.return %read : !stream.resource<*>
+}
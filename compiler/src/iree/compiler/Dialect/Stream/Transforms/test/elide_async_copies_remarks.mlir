@@ -0,0 +1,15 @@
+// RUN: iree-opt --split-input-file --iree-stream-elide-async-copies --iree-stream-emit-copy-remarks --verify-diagnostics %s | FileCheck %s
+
+// Tests that copies that must be preserved are remarked with the reason.
+
+// CHECK-LABEL: @byRefArgClone
+util.func public @byRefArgClone(%arg: !stream.resource<*>, %size: index) -> (!stream.resource<*>, !stream.resource<*>) {
+  %c0 = arith.constant 0 : index
+  %c128 = arith.constant 128 : index
+  %c123_i32 = arith.constant 123 : i32
+  // CHECK: stream.async.clone
+  // expected-remark @+1 {{clone preserved: clone source is an argument that may be retained by a caller or predecessor}}
+  %clone = stream.async.clone %arg : !stream.resource<*>{%size} -> !stream.resource<*>{%size}
+  %fill = stream.async.fill %c123_i32, %clone[%c0 to %c128 for %c128] : i32 -> %clone as !stream.resource<*>{%size}
+  util.return %arg, %fill : !stream.resource<*>, !stream.resource<*>
+}
@@ -92,3 +92,36 @@ util.func public @layoutMixedStaticDynamic(%size_a: index, %size_b: index) -> (i
   // CHECK: util.return %3, %c0, %c208, %1, %c0
   util.return %t#0, %t#1, %t#2, %t#3, %t#4 : index, index, index, index, index
 }
+
+// -----
+
+#layoutStaticSearchConfig = #stream.resource_config<{
+  max_allocation_size = 1073741824,
+  min_buffer_offset_alignment = 16,
+  max_buffer_range = 1073741824,
+  min_buffer_range_alignment = 16,
+  index_bits = 32
+}>
+
+// Tests a pack where the greedy heuristics all waste memory and the branch and
+// bound search finds a packing matching the peak live size.
+
+// CHECK-LABEL: @layoutStaticSearch
+util.func public @layoutStaticSearch() -> (!stream.resource<transient>, index, index, index, index)
+    attributes {stream.resources = #layoutStaticSearchConfig} {
+  %c48 = arith.constant 48 : index
+  %c64 = arith.constant 64 : index
+  %t:5 = stream.resource.pack slices({
+    [2, 3] = %c64,  // +0
+    [3, 4] = %c64,  // +96
+    [4, 4] = %c48,  // +0
+    [4, 5] = %c48,  // +48
+  }) : index
+  // Greedy in lifetime/size/length order requires 176; peak live is 160.
+  // CHECK: %[[ALLOCA:.+]], %{{.+}} = stream.resource.alloca uninitialized
+  // CHECK-SAME: stream.peak_live_size = 160 : index
+  // CHECK-SAME: !stream.resource<transient>{%c160}
+  %alloca, %alloca_timepoint = stream.resource.alloca uninitialized : !stream.resource<transient>{%t#0} => !stream.timepoint
+  // CHECK: util.return %[[ALLOCA]], %c0, %c96, %c0, %c48
+  util.return %alloca, %t#1, %t#2, %t#3, %t#4 : !stream.resource<transient>, index, index, index, index
+}
@@ -207,6 +207,81 @@ util.func public @deviceHostDevice() -> !stream.resource<transient> {
 
 // -----
 
+// Tests that when favoring max-concurrency a value escaping to the host early
+// is produced by its own execution region so that the host does not wait on
+// the unrelated dispatches partitioned along with it.
+
+// CHECK-LABEL: @splitPartitionsForOverlap
+// CHECK-SAME: (%[[ARG0:.+]]: !stream.resource<external>)
+util.func public @splitPartitionsForOverlap(%arg0: !stream.resource<external>) -> (i8, !stream.resource<external>)
+    attributes {stream.partitioning = #stream.partitioning_config<"max-concurrency">} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c123_i8 = arith.constant 123 : i8
+  // CHECK: %[[RESULT_D2H:.+]], %[[TIMEPOINT_D2H:.+]] = stream.async.execute with()
+  // CHECK-SAME: -> !stream.resource<staging>{%c1}
+  // CHECK-NEXT: stream.async.splat %c123_i8
+  %0 = stream.async.splat %c123_i8 : i8 -> !stream.resource<transient>{%c1}
+  // CHECK-NEXT: stream.async.transfer
+  %1 = stream.async.transfer %0 : !stream.resource<transient>{%c1} -> !stream.resource<staging>{%c1}
+  // CHECK-NEXT: stream.yield
+  // CHECK: %[[RESULT:.+]], %[[TIMEPOINT:.+]] = stream.async.execute
+  // CHECK-SAME: with(%[[ARG0]] as
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_0
+  %2 = stream.async.dispatch @ex::@dispatch_0[%c1, %c1, %c1](%arg0[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_1
+  %3 = stream.async.dispatch @ex::@dispatch_1[%c1, %c1, %c1](%2[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_2
+  %4 = stream.async.dispatch @ex::@dispatch_2[%c1, %c1, %c1](%3[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_3
+  %5 = stream.async.dispatch @ex::@dispatch_3[%c1, %c1, %c1](%4[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK-NEXT: stream.yield
+  // CHECK-DAG: %[[READY_D2H:.+]] = stream.timepoint.await %[[TIMEPOINT_D2H]] => %[[RESULT_D2H]] : !stream.resource<staging>{%c1}
+  // CHECK-DAG: %[[READY:.+]] = stream.timepoint.await %[[TIMEPOINT]] => %[[RESULT]] : !stream.resource<external>{%c4}
+  // CHECK-DAG: %[[LOAD:.+]] = stream.async.load %[[READY_D2H]]
+  %6 = stream.async.load %1[%c0] : !stream.resource<staging>{%c1} -> i8
+  // CHECK: util.return %[[LOAD]], %[[READY]]
+  util.return %6, %5 : i8, !stream.resource<external>
+}
+
+// -----
+
+// Tests that a value handed off to another device is produced by its own
+// execution region even when not favoring max-concurrency so that the second
+// device can run its stage while the first works on the rest of its partition.
+
+// CHECK-LABEL: @splitPartitionsForCrossDevicePipelining
+// CHECK-SAME: (%[[ARG0:.+]]: !stream.resource<external>)
+util.func public @splitPartitionsForCrossDevicePipelining(%arg0: !stream.resource<external>) -> (!stream.resource<external>, !stream.resource<external>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  // CHECK: %[[STAGE0:.+]], %[[STAGE0_TIMEPOINT:.+]] = stream.async.execute on(#hal.affinity.queue<[0]>)
+  // CHECK-SAME: with(%[[ARG0]] as
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_0
+  // CHECK-NEXT: stream.yield
+  %0 = stream.async.dispatch on(#hal.affinity.queue<[0]>) @ex::@dispatch_0[%c1](%arg0[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK: %[[REST:.+]], %[[REST_TIMEPOINT:.+]] = stream.async.execute on(#hal.affinity.queue<[0]>)
+  // CHECK-SAME: with(%[[ARG0]] as
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_1
+  %1 = stream.async.dispatch on(#hal.affinity.queue<[0]>) @ex::@dispatch_1[%c1](%arg0[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_2
+  %2 = stream.async.dispatch on(#hal.affinity.queue<[0]>) @ex::@dispatch_2[%c1](%1[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_3
+  %3 = stream.async.dispatch on(#hal.affinity.queue<[0]>) @ex::@dispatch_3[%c1](%2[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_4
+  %4 = stream.async.dispatch on(#hal.affinity.queue<[0]>) @ex::@dispatch_4[%c1](%3[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  // CHECK-NEXT: stream.yield
+  // CHECK: %[[STAGE1:.+]], %[[STAGE1_TIMEPOINT:.+]] = stream.async.execute on(#hal.affinity.queue<[1]>)
+  // CHECK-SAME: await(%[[STAGE0_TIMEPOINT]])
+  // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_5
+  %5 = stream.async.dispatch on(#hal.affinity.queue<[1]>) @ex::@dispatch_5[%c1](%0[%c0 to %c4 for %c4]) : (!stream.resource<external>{%c4}) -> !stream.resource<external>{%c4}
+  util.return %4, %5 : !stream.resource<external>, !stream.resource<external>
+}
+
+// -----
+
 // Tests that partitioning does not hoist ops across cf.asserts.
 
 // CHECK-LABEL: @dontHoistPastAsserts
@@ -560,8 +560,21 @@ mlir::emitc::CallOp returnIfError(OpBuilder &builder, Location location,
                       /*negateCondition=*/true);
 }
 
+// Returns the name of the static variable holding the module struct when
+// the module state is statically allocated.
+static std::string getModuleStorageName(StringRef moduleName) {
+  return (moduleName + "_module_storage_").str();
+}
+
+// Returns the name of the static variable holding the module state struct when
+// the module state is statically allocated.
+static std::string getStateStorageName(StringRef moduleName) {
+  return (moduleName + "_state_storage_").str();
+}
+
 LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
-                                 IREE::VM::ModuleAnalysis &moduleAnalysis) {
+                                 IREE::VM::ModuleAnalysis &moduleAnalysis,
+                                 bool staticModuleState) {
   auto ctx = moduleOp.getContext();
   auto loc = moduleOp.getLoc();
 
@@ -595,25 +608,29 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
 
     std::string moduleTypeName = std::string("struct ") + moduleName + "_t";
 
-    auto castedModuleOp = builder.create<emitc::CastOp>(
-        /*location=*/loc,
-        /*type=*/
-        emitc::PointerType::get(emitc::OpaqueType::get(ctx, moduleTypeName)),
-        /*operand=*/moduleArg);
+    // Statically allocated modules have nothing to free.
+    if (!staticModuleState) {
+      auto castedModuleOp = builder.create<emitc::CastOp>(
+          /*location=*/loc,
+          /*type=*/
+          emitc::PointerType::get(emitc::OpaqueType::get(ctx, moduleTypeName)),
+          /*operand=*/moduleArg);
 
-    auto allocatorOp = emitc_builders::structPtrMember(
-        builder, loc,
-        /*type=*/emitc::OpaqueType::get(ctx, "iree_allocator_t"),
-        /*memberName=*/"allocator",
-        /*operand=*/castedModuleOp.getResult());
+      auto allocatorOp = emitc_builders::structPtrMember(
+          builder, loc,
+          /*type=*/emitc::OpaqueType::get(ctx, "iree_allocator_t"),
+          /*memberName=*/"allocator",
+          /*operand=*/castedModuleOp.getResult());
 
-    builder.create<emitc::CallOpaqueOp>(
-        /*location=*/loc,
-        /*type=*/TypeRange{},
-        /*callee=*/StringAttr::get(ctx, "iree_allocator_free"),
-        /*args=*/ArrayAttr{},
-        /*templateArgs=*/ArrayAttr{},
-        /*operands=*/ArrayRef<Value>{allocatorOp, castedModuleOp.getResult()});
+      builder.create<emitc::CallOpaqueOp>(
+          /*location=*/loc,
+          /*type=*/TypeRange{},
+          /*callee=*/StringAttr::get(ctx, "iree_allocator_free"),
+          /*args=*/ArrayAttr{},
+          /*templateArgs=*/ArrayAttr{},
+          /*operands=*/
+          ArrayRef<Value>{allocatorOp, castedModuleOp.getResult()});
+    }
 
     builder.create<mlir::emitc::ReturnOp>(loc, nullptr);
   }
@@ -653,27 +670,31 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
     std::string moduleStateTypeName =
         std::string("struct ") + moduleName + "_state_t";
 
+    std::string stateStorageRef = "&" + getStateStorageName(moduleName);
     Value state = emitc_builders::allocateVariable(
         builder, loc,
         emitc::PointerType::get(
             emitc::OpaqueType::get(ctx, moduleStateTypeName)),
-        {"NULL"});
+        {staticModuleState ? StringRef(stateStorageRef) : StringRef("NULL")});
 
     Value stateSize = emitc_builders::sizeOf(
         builder, loc, emitc::OpaqueAttr::get(ctx, moduleStateTypeName));
 
-    Value statePtr = emitc_builders::addressOf(builder, loc, state);
+    if (!staticModuleState) {
+      Value statePtr = emitc_builders::addressOf(builder, loc, state);
 
-    auto voidPtr = builder.create<emitc::CastOp>(
-        /*location=*/loc,
-        /*type=*/
-        emitc::PointerType::get(
-            emitc::PointerType::get(emitc::OpaqueType::get(ctx, "void"))),
-        /*operand=*/statePtr);
+      auto voidPtr = builder.create<emitc::CastOp>(
+          /*location=*/loc,
+          /*type=*/
+          emitc::PointerType::get(
+              emitc::PointerType::get(emitc::OpaqueType::get(ctx, "void"))),
+          /*operand=*/statePtr);
 
-    returnIfError(builder, loc, StringAttr::get(ctx, "iree_allocator_malloc"),
-                  {}, {allocatorArg, stateSize, voidPtr.getResult()},
-                  moduleAnalysis);
+      returnIfError(builder, loc,
+                    StringAttr::get(ctx, "iree_allocator_malloc"), {},
+                    {allocatorArg, stateSize, voidPtr.getResult()},
+                    moduleAnalysis);
+    }
 
     emitc_builders::memset(builder, loc, state, 0, stateSize);
 
@@ -871,20 +892,22 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
       }
     }
 
-    auto allocatorOp = emitc_builders::structPtrMember(
-        builder, loc,
-        /*type=*/emitc::OpaqueType::get(ctx, "iree_allocator_t"),
-        /*memberName=*/"allocator",
-        /*operand=*/stateOp.getResult());
+    if (!staticModuleState) {
+      auto allocatorOp = emitc_builders::structPtrMember(
+          builder, loc,
+          /*type=*/emitc::OpaqueType::get(ctx, "iree_allocator_t"),
+          /*memberName=*/"allocator",
+          /*operand=*/stateOp.getResult());
 
-    builder.create<emitc::CallOpaqueOp>(
-        /*location=*/loc,
-        /*type=*/TypeRange{},
-        /*callee=*/StringAttr::get(ctx, "iree_allocator_free"),
-        /*args=*/ArrayAttr{},
-        /*templateArgs=*/ArrayAttr{},
-        /*operands=*/
-        ArrayRef<Value>{allocatorOp, stateOp.getResult()});
+      builder.create<emitc::CallOpaqueOp>(
+          /*location=*/loc,
+          /*type=*/TypeRange{},
+          /*callee=*/StringAttr::get(ctx, "iree_allocator_free"),
+          /*args=*/ArrayAttr{},
+          /*templateArgs=*/ArrayAttr{},
+          /*operands=*/
+          ArrayRef<Value>{allocatorOp, stateOp.getResult()});
+    }
 
     builder.create<mlir::emitc::ReturnOp>(loc, nullptr);
   }
@@ -1016,26 +1039,30 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
 
     std::string moduleTypeName = std::string("struct ") + moduleName + "_t";
 
+    std::string moduleStorageRef = "&" + getModuleStorageName(moduleName);
     Value module = emitc_builders::allocateVariable(
         builder, loc,
         emitc::PointerType::get(emitc::OpaqueType::get(ctx, moduleTypeName)),
-        {"NULL"});
+        {staticModuleState ? StringRef(moduleStorageRef) : StringRef("NULL")});
 
     Value moduleSize = emitc_builders::sizeOf(
         builder, loc, emitc::OpaqueAttr::get(ctx, moduleTypeName));
 
-    Value modulePtr = emitc_builders::addressOf(builder, loc, module);
+    if (!staticModuleState) {
+      Value modulePtr = emitc_builders::addressOf(builder, loc, module);
 
-    auto voidPtr = builder.create<emitc::CastOp>(
-        /*location=*/loc,
-        /*type=*/
-        emitc::PointerType::get(
-            emitc::PointerType::get(emitc::OpaqueType::get(ctx, "void"))),
-        /*operand=*/modulePtr);
+      auto voidPtr = builder.create<emitc::CastOp>(
+          /*location=*/loc,
+          /*type=*/
+          emitc::PointerType::get(
+              emitc::PointerType::get(emitc::OpaqueType::get(ctx, "void"))),
+          /*operand=*/modulePtr);
 
-    returnIfError(builder, loc, StringAttr::get(ctx, "iree_allocator_malloc"),
-                  {}, {allocatorArg, moduleSize, voidPtr.getResult()},
-                  moduleAnalysis);
+      returnIfError(builder, loc,
+                    StringAttr::get(ctx, "iree_allocator_malloc"), {},
+                    {allocatorArg, moduleSize, voidPtr.getResult()},
+                    moduleAnalysis);
+    }
 
     emitc_builders::memset(builder, loc, module, 0, moduleSize);
 
@@ -1112,14 +1139,16 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
       Region *parentRegion = condBlock->getParent();
       failureBlock = builder.createBlock(parentRegion, parentRegion->end());
 
-      builder.create<emitc::CallOpaqueOp>(
-          /*location=*/loc,
-          /*type=*/TypeRange{},
-          /*callee=*/StringAttr::get(ctx, "iree_allocator_free"),
-          /*args=*/ArrayAttr{},
-          /*templateArgs=*/ArrayAttr{},
-          /*operands=*/
-          ArrayRef<Value>{allocatorArg, module});
+      if (!staticModuleState) {
+        builder.create<emitc::CallOpaqueOp>(
+            /*location=*/loc,
+            /*type=*/TypeRange{},
+            /*callee=*/StringAttr::get(ctx, "iree_allocator_free"),
+            /*args=*/ArrayAttr{},
+            /*templateArgs=*/ArrayAttr{},
+            /*operands=*/
+            ArrayRef<Value>{allocatorArg, module});
+      }
 
       builder.create<mlir::emitc::ReturnOp>(loc,
                                             vmInitializeStatus.getResult(0));
@@ -1167,8 +1196,10 @@ LogicalResult createAPIFunctions(IREE::VM::ModuleOp moduleOp,
 /// create a module instance etc.
 LogicalResult
 createModuleStructure(IREE::VM::ModuleOp moduleOp,
-                      IREE::VM::EmitCTypeConverter &typeConverter) {
-  if (failed(createAPIFunctions(moduleOp, typeConverter.analysis))) {
+                      IREE::VM::EmitCTypeConverter &typeConverter,
+                      bool staticModuleState) {
+  if (failed(createAPIFunctions(moduleOp, typeConverter.analysis,
+                                staticModuleState))) {
     return failure();
   }
 
@@ -1285,6 +1316,17 @@ createModuleStructure(IREE::VM::ModuleOp moduleOp,
     emitc_builders::structDefinition(builder, loc, moduleStructStateName,
                                      moduleStructStateFields);
 
+    // Storage for the module and its state when they are statically allocated.
+    // Only a single instance of the module may be live at a time.
+    if (staticModuleState) {
+      builder.create<emitc::VerbatimOp>(
+          loc, "static struct " + moduleStructName + " " +
+                   getModuleStorageName(moduleOp.getName()) + ";");
+      builder.create<emitc::VerbatimOp>(
+          loc, "static struct " + moduleStructStateName + " " +
+                   getStateStorageName(moduleOp.getName()) + ";");
+    }
+
     // Emit declarations for private functions.
     for (auto funcOp : moduleOp.getOps<mlir::emitc::FuncOp>()) {
       if (funcOp.isPrivate()) {
@@ -4686,6 +4728,12 @@ class ConvertVMToEmitCPass
 public:
   MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(ConvertVMToEmitCPass)
 
+  ConvertVMToEmitCPass() = default;
+  ConvertVMToEmitCPass(const ConvertVMToEmitCPass &pass) {}
+  ConvertVMToEmitCPass(bool staticModuleState) {
+    this->staticModuleState = staticModuleState;
+  }
+
   void getDependentDialects(DialectRegistry &registry) const override {
     registry.insert<mlir::BuiltinDialect, mlir::cf::ControlFlowDialect,
                     mlir::emitc::EmitCDialect, IREE::Util::UtilDialect>();
@@ -4775,17 +4823,27 @@ public:
       }
     });
 
-    if (failed(createModuleStructure(module, typeConverter))) {
+    if (failed(createModuleStructure(module, typeConverter,
+                                     staticModuleState))) {
       return signalPassFailure();
     }
   }
+
+private:
+  Option<bool> staticModuleState{
+      *this,
+      "static-module-state",
+      llvm::cl::desc("Places the module and its state in static storage "
+                     "instead of allocating them at runtime."),
+      llvm::cl::init(false),
+  };
 };
 
 } // namespace
 
 std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
-createConvertVMToEmitCPass() {
-  return std::make_unique<ConvertVMToEmitCPass>();
+createConvertVMToEmitCPass(bool staticModuleState) {
+  return std::make_unique<ConvertVMToEmitCPass>(staticModuleState);
 }
 
 } // namespace IREE::VM
@@ -21,7 +21,11 @@ void populateVMToEmitCPatterns(ConversionTarget &conversionTarget,
 } // namespace mlir::iree_compiler
 
 namespace mlir::iree_compiler::IREE::VM {
-std::unique_ptr<OperationPass<IREE::VM::ModuleOp>> createConvertVMToEmitCPass();
+// Converts a vm.module to the EmitC dialect. When |staticModuleState| is set
+// the module and its state are placed in static storage such that no heap
+// allocations are required to create them.
+std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
+createConvertVMToEmitCPass(bool staticModuleState = false);
 } // namespace mlir::iree_compiler::IREE::VM
 
 #endif // IREE_COMPILER_DIALECT_VM_CONVERSION_VMTOEMITC_CONVERTVMTOEMITC_H_
@@ -149,7 +149,9 @@ void FuncOp::setReflectionAttr(StringRef name, Attribute value) {
   // DictionaryAttr is not very friendly for modification :/
   auto existingAttr =
       getOperation()->getAttrOfType<DictionaryAttr>("iree.reflection");
-  SmallVector<NamedAttribute> attrs(existingAttr.begin(), existingAttr.end());
+  SmallVector<NamedAttribute> attrs;
+  if (existingAttr)
+    attrs.append(existingAttr.begin(), existingAttr.end());
   bool didFind = false;
   for (size_t i = 0; i < attrs.size(); ++i) {
     if (attrs[i].getName() == name) {
@@ -357,7 +357,8 @@ private:
 // static
 std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
     IREE::VM::FuncOp funcOp, llvm::DenseMap<Type, int> &typeTable,
-    SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase) {
+    SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase,
+    size_t functionAlignment) {
   EncodedBytecodeFunction result;
 
   // Perform register allocation first so that we can quickly lookup values as
@@ -420,7 +421,7 @@ std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
   debugDatabase.addFunctionSourceMap(funcOp, sourceMap);
 
   size_t finalLength = encoder.getOffset();
-  if (failed(encoder.ensureAlignment(8))) {
+  if (failed(encoder.ensureAlignment(functionAlignment))) {
     funcOp.emitError() << "failed to pad function";
     return std::nullopt;
   }
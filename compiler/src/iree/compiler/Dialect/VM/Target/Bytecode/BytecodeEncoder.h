@@ -40,10 +40,12 @@ public:
   static constexpr uint32_t kVersion = (kVersionMajor << 16) | kVersionMinor;
 
   // Encodes a vm.func to bytecode and returns the result.
+  // The encoded data is padded to a multiple of |functionAlignment| bytes.
   // Returns None on failure.
   static std::optional<EncodedBytecodeFunction>
   encodeFunction(IREE::VM::FuncOp funcOp, llvm::DenseMap<Type, int> &typeTable,
-                 SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase);
+                 SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase,
+                 size_t functionAlignment = 8);
 
   BytecodeEncoder() = default;
   ~BytecodeEncoder() = default;
@@ -28,6 +28,7 @@
 #include "llvm/Support/CRC.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Diagnostics.h"
@@ -54,6 +55,12 @@ using namespace llvm::support;
 // overridden by creators of the rodata with the `alignment` attribute.
 static constexpr int kDefaultRodataAlignment = 16;
 
+// Function bytecode is padded such that each function starts 8-byte aligned.
+// When minimizing padding only the 2-byte alignment register lists are decoded
+// with is kept.
+static constexpr int kDefaultFunctionAlignment = 8;
+static constexpr int kMinimumFunctionAlignment = 2;
+
 // Anything over a few KB should be split out of the FlatBuffer.
 // This limit is rather arbitrary - we could support hundreds of MB of embedded
 // data at the risk of tripping the 31-bit FlatBuffer offset values.
@@ -90,6 +97,24 @@ static StringRef mimeTypeToFileExtension(StringRef mimeType) {
       .Default(".bin");
 }
 
+// Returns the minimum alignment required to access the elements of
+// |valueAttr|. Used instead of kDefaultRodataAlignment when minimizing padding.
+static uint64_t getNaturalRodataAlignment(Attribute valueAttr) {
+  if (isa<StringAttr>(valueAttr)) {
+    return 1;
+  }
+  auto typedAttr = dyn_cast<TypedAttr>(valueAttr);
+  auto shapedType =
+      typedAttr ? dyn_cast<ShapedType>(typedAttr.getType()) : ShapedType{};
+  if (!shapedType || !shapedType.getElementType().isIntOrFloat()) {
+    return kDefaultRodataAlignment;
+  }
+  uint64_t elementByteWidth =
+      llvm::divideCeil(shapedType.getElementTypeBitWidth(), 8);
+  return std::min<uint64_t>(llvm::PowerOf2Ceil(elementByteWidth),
+                            kDefaultRodataAlignment);
+}
+
 // Serializes a constant attribute to the FlatBuffer as a binary blob.
 // Returns the size in bytes of the serialized value and the FlatBuffers offset
 // to the uint8 vec containing the data.
@@ -346,9 +371,12 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
   functionDescriptors.resize(internalFuncOps.size());
   iree_vm_FeatureBits_enum_t moduleRequirements = 0;
   size_t totalBytecodeLength = 0;
+  const size_t functionAlignment = bytecodeOptions.minimizePadding
+                                       ? kMinimumFunctionAlignment
+                                       : kDefaultFunctionAlignment;
   for (auto [i, funcOp] : llvm::enumerate(internalFuncOps)) {
     auto encodedFunction = BytecodeEncoder::encodeFunction(
-        funcOp, typeOrdinalMap, symbolTable, debugDatabase);
+        funcOp, typeOrdinalMap, symbolTable, debugDatabase, functionAlignment);
     if (!encodedFunction) {
       return funcOp.emitError() << "failed to encode function bytecode";
     }
@@ -649,8 +677,10 @@ translateModuleToBytecode(IREE::VM::ModuleOp moduleOp,
     RodataRef rodataRef;
     Location rodataLoc = rodataOp.getLoc();
     rodataRef.rodataOp = rodataOp;
-    rodataRef.alignment =
-        rodataOp.getAlignment().value_or(kDefaultRodataAlignment);
+    rodataRef.alignment = rodataOp.getAlignment().value_or(
+        bytecodeOptions.minimizePadding
+            ? getNaturalRodataAlignment(rodataOp.getValue())
+            : kDefaultRodataAlignment);
     rodataRef.totalSize = static_cast<uint64_t>(actualSize);
     if (storeExternal) {
       std::string fileName =
@@ -738,6 +768,12 @@ void BytecodeTargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Enables output files to be viewed as zip files for debugging "
           "(only applies to binary targets)"));
+  binder.opt<bool>(
+      "iree-vm-bytecode-module-minimize-padding", minimizePadding,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Pads function bytecode and rodata only to the minimum "
+                     "alignment the runtime requires to reduce module size "
+                     "(for embedded targets)"));
 }
 
 } // namespace mlir::iree_compiler::IREE::VM
@@ -54,6 +54,12 @@ struct BytecodeTargetOptions {
   // should be disabled in release builds.
   bool emitPolyglotZip = true;
 
+  // Pads function bytecode and rodata without an explicit alignment only to
+  // the minimum alignment the runtime requires instead of the defaults. This
+  // reduces module size on targets where flash footprint matters and should be
+  // combined with emitPolyglotZip=false. The bytecode format is unchanged.
+  bool minimizePadding = false;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<BytecodeTargetOptions>;
 };
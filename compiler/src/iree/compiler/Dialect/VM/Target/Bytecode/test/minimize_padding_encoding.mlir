@@ -0,0 +1,28 @@
+// RUN: iree-compile --split-input-file --compile-mode=vm \
+// RUN:   --iree-vm-bytecode-module-minimize-padding \
+// RUN:   --iree-vm-bytecode-module-output-format=flatbuffer-text %s | FileCheck %s
+
+// Tests that functions are only padded to the 2-byte alignment required by
+// register lists instead of 8 bytes.
+
+// CHECK: "name": "minimize_padding"
+vm.module @minimize_padding {
+  vm.export @func0
+  vm.export @func1
+
+  //      CHECK: "function_descriptors":
+  // CHECK-NEXT: {
+  // CHECK-NEXT:   "bytecode_offset": 0
+  // CHECK-NEXT:   "bytecode_length": 14
+  //      CHECK: {
+  // CHECK-NEXT:   "bytecode_offset": 14
+  // CHECK-NEXT:   "bytecode_length": 14
+  vm.func @func0(%arg0 : f32) -> f32 {
+    %0 = vm.add.f32 %arg0, %arg0 : f32
+    vm.return %0 : f32
+  }
+  vm.func @func1(%arg0 : f32) -> f32 {
+    %0 = vm.mul.f32 %arg0, %arg0 : f32
+    vm.return %0 : f32
+  }
+}
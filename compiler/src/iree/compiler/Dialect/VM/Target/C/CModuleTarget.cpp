@@ -94,7 +94,8 @@ canonicalizeModule(IREE::VM::ModuleOp moduleOp,
   modulePasses.addPass(IREE::VM::createOrdinalAllocationPass());
 
   // C target specific pass
-  modulePasses.addPass(createConvertVMToEmitCPass());
+  modulePasses.addPass(
+      createConvertVMToEmitCPass(targetOptions.staticModuleState));
 
   modulePasses.addPass(IREE::Util::createDropCompilerHintsPass());
   modulePasses.addPass(mlir::createCanonicalizerPass());
@@ -32,6 +32,11 @@ struct CTargetOptions {
 
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
+
+  // Places the module and its state in static storage instead of allocating
+  // them with the allocator provided at runtime. Only a single instance of the
+  // module may be live at a time.
+  bool staticModuleState = false;
 };
 
 // Translates a vm.module to a c module.
@@ -33,11 +33,19 @@ static llvm::cl::opt<bool> stripDebugOpsFlag{
     llvm::cl::init(false),
 };
 
+static llvm::cl::opt<bool> staticModuleStateFlag{
+    "iree-vm-c-module-static-state",
+    llvm::cl::desc("Places the module and its state in static storage instead "
+                   "of allocating them at runtime"),
+    llvm::cl::init(false),
+};
+
 CTargetOptions getCTargetOptionsFromFlags() {
   CTargetOptions targetOptions;
   targetOptions.outputFormat = outputFormatFlag;
   targetOptions.optimize = optimizeFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
+  targetOptions.staticModuleState = staticModuleStateFlag;
   return targetOptions;
 }
 
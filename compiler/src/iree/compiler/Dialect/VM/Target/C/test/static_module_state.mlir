@@ -0,0 +1,25 @@
+// RUN: iree-compile --compile-mode=vm --output-format=vm-c \
+// RUN:   --iree-vm-c-module-static-state %s | FileCheck %s
+
+// Tests that the module and its state are placed in static storage and never
+// allocated or freed at runtime.
+
+// CHECK-NOT: iree_allocator_malloc
+// CHECK: static struct static_module_t static_module_module_storage_;
+// CHECK: static struct static_module_state_t static_module_state_storage_;
+// CHECK: static void static_module_destroy(
+// CHECK-NOT: iree_allocator_free
+// CHECK: static iree_status_t static_module_alloc_state(
+// CHECK: = &static_module_state_storage_;
+// CHECK-NOT: iree_allocator_free
+// CHECK: iree_status_t static_module_create(
+// CHECK: = &static_module_module_storage_;
+// CHECK-NOT: iree_allocator_malloc
+// CHECK-NOT: iree_allocator_free
+vm.module @static_module {
+  vm.global.ref private mutable @buffer : !vm.buffer
+  vm.export @fn
+  vm.func @fn(%arg0 : i32) -> i32 {
+    vm.return %arg0 : i32
+  }
+}
@@ -0,0 +1,218 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "iree/compiler/Dialect/VM/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "mlir/IR/Attributes.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/CallInterfaces.h"
+#include "mlir/Interfaces/ControlFlowInterfaces.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir::iree_compiler::IREE::VM {
+
+namespace {
+
+// Computes which functions in a module may mutate module state.
+class StateAccessAnalysis {
+public:
+  explicit StateAccessAnalysis(IREE::VM::ModuleOp moduleOp)
+      : symbolTable(moduleOp) {
+    // Find functions that mutate state directly and record the reverse call
+    // graph so that mutation can be propagated from callees to their callers.
+    DenseMap<Operation *, SmallVector<Operation *>> callers;
+    SmallVector<Operation *> worklist;
+    for (auto funcOp : moduleOp.getOps<IREE::VM::FuncOp>()) {
+      SmallVector<Operation *> callees;
+      if (mayMutateStateLocally(funcOp, callees)) {
+        mutatingFuncs.insert(funcOp);
+        worklist.push_back(funcOp);
+      }
+      for (Operation *calleeOp : callees) {
+        callers[calleeOp].push_back(funcOp);
+      }
+    }
+    // Any function that can reach a mutating function mutates as well. Only
+    // mutation is propagated so recursive cycles never assume a result: a
+    // cycle is stateless only if no function it can reach ever mutates.
+    while (!worklist.empty()) {
+      Operation *calleeOp = worklist.pop_back_val();
+      for (Operation *callerOp : callers[calleeOp]) {
+        if (mutatingFuncs.insert(callerOp).second) {
+          worklist.push_back(callerOp);
+        }
+      }
+    }
+  }
+
+  // Returns true if |funcOp| or any function it transitively calls within the
+  // module may mutate module state.
+  bool mayMutateState(IREE::VM::FuncOp funcOp) const {
+    return mutatingFuncs.contains(funcOp);
+  }
+
+private:
+  // Returns true if |funcOp| itself may mutate module state. Functions within
+  // the module called by |funcOp| are added to |callees|.
+  bool mayMutateStateLocally(IREE::VM::FuncOp funcOp,
+                             SmallVectorImpl<Operation *> &callees) {
+    auto walkResult = funcOp.walk([&](Operation *op) -> WalkResult {
+      if (isa<IREE::Util::GlobalStoreOpInterface,
+              IREE::Util::GlobalStoreIndirectOpInterface>(op)) {
+        return WalkResult::interrupt();
+      }
+      if (auto loadOp = dyn_cast<IREE::Util::GlobalLoadOpInterface>(op)) {
+        Value loadedValue = loadOp.getLoadedGlobalValue();
+        if (!isa<IREE::VM::RefType>(loadedValue.getType()))
+          return WalkResult::advance();
+        // Objects held in mutable ref globals (caches, lazily created
+        // resources, etc) may be modified in-place after being loaded.
+        auto globalOp = symbolTable.lookup<IREE::Util::GlobalOpInterface>(
+            loadOp.getGlobalAttr().getAttr());
+        if (!globalOp || globalOp.isGlobalMutable())
+          return WalkResult::interrupt();
+        // Objects held in immutable ref globals are still module state and
+        // must only ever be read.
+        if (mayWriteThroughRef(loadedValue))
+          return WalkResult::interrupt();
+        return WalkResult::advance();
+      }
+      if (auto loadOp =
+              dyn_cast<IREE::Util::GlobalLoadIndirectOpInterface>(op)) {
+        if (isa<IREE::VM::RefType>(loadOp.getLoadedGlobalValue().getType()))
+          return WalkResult::interrupt();
+        return WalkResult::advance();
+      }
+      if (auto callOp = dyn_cast<CallOpInterface>(op)) {
+        auto calleeAttr =
+            dyn_cast_if_present<SymbolRefAttr>(callOp.getCallableForCallee());
+        if (!calleeAttr)
+          return WalkResult::interrupt();
+        Operation *calleeOp = symbolTable.lookup(calleeAttr.getLeafReference());
+        // Imports are implemented by other modules that are responsible for
+        // their own thread-safety.
+        if (isa_and_nonnull<IREE::VM::ImportOp>(calleeOp))
+          return WalkResult::advance();
+        if (!isa_and_nonnull<IREE::VM::FuncOp>(calleeOp))
+          return WalkResult::interrupt();
+        // Callees may return objects held in immutable ref globals and
+        // anything done with them here must only read them.
+        for (Value result : op->getResults()) {
+          if (isa<IREE::VM::RefType>(result.getType()) &&
+              mayWriteThroughRef(result)) {
+            return WalkResult::interrupt();
+          }
+        }
+        callees.push_back(calleeOp);
+      }
+      return WalkResult::advance();
+    });
+    return walkResult.wasInterrupted();
+  }
+
+  // Returns true if the object referenced by |rootValue| may be written by any
+  // of its users. Objects passed to calls are conservatively assumed to be
+  // written as imports (such as a HAL dispatch writing into a buffer) and
+  // internal functions may modify their arguments in-place.
+  static bool mayWriteThroughRef(Value rootValue) {
+    SmallVector<Value> worklist = {rootValue};
+    DenseSet<Value> visitedValues;
+    while (!worklist.empty()) {
+      Value value = worklist.pop_back_val();
+      if (!visitedValues.insert(value).second)
+        continue;
+      for (OpOperand &use : value.getUses()) {
+        Operation *userOp = use.getOwner();
+        if (isa<CallOpInterface>(userOp))
+          return true;
+        if (auto branchOp = dyn_cast<BranchOpInterface>(userOp)) {
+          for (unsigned i = 0; i < userOp->getNumSuccessors(); ++i) {
+            SuccessorOperands operands = branchOp.getSuccessorOperands(i);
+            for (unsigned j = 0; j < operands.size(); ++j) {
+              if (operands[j] == value) {
+                worklist.push_back(userOp->getSuccessor(i)->getArgument(j));
+              }
+            }
+          }
+          continue;
+        }
+        // Returning an object hands it to the caller which is checked at the
+        // call site (or is outside of the module).
+        if (userOp->hasTrait<OpTrait::ReturnLike>())
+          continue;
+        if (auto effectOp = dyn_cast<MemoryEffectOpInterface>(userOp)) {
+          if (effectOp.hasEffect<MemoryEffects::Write>())
+            return true;
+        } else if (!isMemoryEffectFree(userOp)) {
+          return true;
+        }
+        // Refs derived from the object (casts, elements read from lists, etc)
+        // may alias it.
+        for (Value result : userOp->getResults()) {
+          if (isa<IREE::VM::RefType>(result.getType())) {
+            worklist.push_back(result);
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+  SymbolTable symbolTable;
+  DenseSet<Operation *> mutatingFuncs;
+};
+
+} // namespace
+
+class AnnotateStatelessExportsPass
+    : public PassWrapper<AnnotateStatelessExportsPass,
+                         OperationPass<IREE::VM::ModuleOp>> {
+public:
+  StringRef getArgument() const override {
+    return "iree-vm-annotate-stateless-exports";
+  }
+
+  StringRef getDescription() const override {
+    return "Marks exported functions that never mutate module state as safe "
+           "for concurrent invocation.";
+  }
+
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    SymbolTable symbolTable(moduleOp);
+    StateAccessAnalysis analysis(moduleOp);
+    auto statelessAttr = StringAttr::get(&getContext(), "1");
+    for (auto exportOp : moduleOp.getOps<IREE::VM::ExportOp>()) {
+      auto funcOp =
+          symbolTable.lookup<IREE::VM::FuncOp>(exportOp.getFunctionRef());
+      if (!funcOp)
+        continue;
+      // Initializers run once per context and always write global state.
+      if (funcOp.getName() == "__init" || funcOp.getName() == "__deinit")
+        continue;
+      if (!analysis.mayMutateState(funcOp)) {
+        funcOp.setReflectionAttr("iree.abi.stateless", statelessAttr);
+      }
+    }
+  }
+};
+
+std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
+createAnnotateStatelessExportsPass() {
+  return std::make_unique<AnnotateStatelessExportsPass>();
+}
+
+static PassRegistration<AnnotateStatelessExportsPass> pass;
+
+} // namespace mlir::iree_compiler::IREE::VM
@@ -125,6 +125,10 @@ void buildVMTransformPassPipeline(OpPassManager &passManager,
   passManager.addNestedPass<IREE::VM::ModuleOp>(
       createDropEmptyModuleInitializersPass());
 
+  // Mark exports that can be safely invoked concurrently on the same context.
+  passManager.addNestedPass<IREE::VM::ModuleOp>(
+      createAnnotateStatelessExportsPass());
+
   if (targetOptions.optimizeForStackSize) {
     passManager.addNestedPass<IREE::VM::ModuleOp>(createSinkDefiningOpsPass());
   }
@@ -73,6 +73,12 @@ createResolveRodataLoadsPass();
 std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
 createGlobalInitializationPass();
 
+// Marks exported functions that never mutate module state with the
+// `iree.abi.stateless` reflection attribute. Such functions may be invoked
+// concurrently on a single context.
+std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
+createAnnotateStatelessExportsPass();
+
 // Assigns module-unique ordinals to function/global/etc symbols within the
 // module.
 std::unique_ptr<OperationPass<IREE::VM::ModuleOp>>
@@ -98,6 +104,7 @@ inline void registerVMPasses() {
   auto targetOptions = TargetOptions::FromFlags::get();
   registerVMTransformPassPipeline();
   createConversionPass(targetOptions);
+  createAnnotateStatelessExportsPass();
   createHoistInlinedRodataPass();
   createDeduplicateRodataPass();
   createDropEmptyModuleInitializersPass();
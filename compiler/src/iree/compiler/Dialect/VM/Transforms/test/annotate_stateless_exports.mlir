@@ -0,0 +1,204 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(vm.module(iree-vm-annotate-stateless-exports))" %s | FileCheck %s
+
+// Tests that exports only reading immutable globals are marked stateless.
+
+// CHECK-LABEL: @reads_only
+vm.module @reads_only {
+  vm.global.i32 private @g0 : i32
+  vm.global.ref private @g1 : !vm.ref<?>
+  vm.import private @other.fn(%arg0 : i32) -> i32
+  vm.export @fn
+  // CHECK: vm.func @fn
+  // CHECK-SAME: iree.reflection = {f = "FOOBAR", iree.abi.stateless = "1"}
+  vm.func @fn(%arg0 : i32) -> i32 attributes {
+    iree.reflection = {f = "FOOBAR"}
+  } {
+    %0 = vm.global.load.i32 @g0 : i32
+    %1 = vm.global.load.ref @g1 : !vm.ref<?>
+    %2 = vm.call @other.fn(%0) : (i32) -> i32
+    vm.return %2 : i32
+  }
+}
+
+// -----
+
+// Tests that exports storing to globals directly or through internal calls
+// are not marked.
+
+// CHECK-LABEL: @stores
+vm.module @stores {
+  vm.global.i32 private mutable @g0 : i32
+  vm.export @direct
+  // CHECK: vm.func @direct
+  // CHECK-NOT: iree.abi.stateless
+  vm.func @direct(%arg0 : i32) {
+    vm.global.store.i32 %arg0, @g0 : i32
+    vm.return
+  }
+  vm.export @indirect
+  // CHECK: vm.func @indirect
+  // CHECK-NOT: iree.abi.stateless
+  vm.func @indirect(%arg0 : i32) {
+    vm.call @direct(%arg0) : (i32) -> ()
+    vm.return
+  }
+  vm.export @pure
+  // CHECK: vm.func @pure
+  // CHECK-SAME: iree.abi.stateless = "1"
+  vm.func @pure(%arg0 : i32) -> i32 {
+    vm.return %arg0 : i32
+  }
+}
+
+// -----
+
+// Tests that exports loading mutable ref globals are not marked as the
+// referenced objects may be mutated in-place.
+
+// CHECK-LABEL: @mutable_ref
+vm.module @mutable_ref {
+  vm.global.ref private mutable @g0 : !vm.ref<?>
+  vm.export @fn
+  // CHECK: vm.func @fn
+  // CHECK-NOT: iree.abi.stateless
+  vm.func @fn() -> !vm.ref<?> {
+    %0 = vm.global.load.ref @g0 : !vm.ref<?>
+    vm.return %0 : !vm.ref<?>
+  }
+}
+
+// -----
+
+// Tests that mutation is propagated through chains of internal calls.
+
+// CHECK-LABEL: @transitive
+vm.module @transitive {
+  vm.global.i32 private mutable @g0 : i32
+  vm.export @a
+  // CHECK: vm.func @a
+  // CHECK-NOT: iree.abi.stateless
+  vm.func @a(%arg0 : i32) {
+    vm.call @b(%arg0) : (i32) -> ()
+    vm.return
+  }
+  vm.func private @b(%arg0 : i32) {
+    vm.call @c(%arg0) : (i32) -> ()
+    vm.return
+  }
+  vm.func private @c(%arg0 : i32) {
+    vm.global.store.i32 %arg0, @g0 : i32
+    vm.return
+  }
+}
+
+// -----
+
+// Tests that functions in a recursive cycle are not marked when any function
+// in the cycle mutates state, even if the mutation follows the recursive call.
+
+// CHECK-LABEL: @recursive_store
+vm.module @recursive_store {
+  vm.global.i32 private mutable @g0 : i32
+  vm.export @a
+  // CHECK: vm.func @a
+  // CHECK-NOT: iree.abi.stateless
+  vm.func @a(%arg0 : i32) {
+    vm.call @b(%arg0) : (i32) -> ()
+    vm.global.store.i32 %arg0, @g0 : i32
+    vm.return
+  }
+  vm.export @b
+  // CHECK: vm.func @b
+  // CHECK-NOT: iree.abi.stateless
+  vm.func @b(%arg0 : i32) {
+    %c0 = vm.const.i32 0
+    vm.cond_br %arg0, ^bb1, ^bb2
+  ^bb1:
+    vm.call @a(%c0) : (i32) -> ()
+    vm.br ^bb2
+  ^bb2:
+    vm.return
+  }
+}
+
+// -----
+
+// Tests that functions in a recursive cycle that never mutate state are
+// marked.
+
+// CHECK-LABEL: @recursive_pure
+vm.module @recursive_pure {
+  vm.export @a
+  // CHECK: vm.func @a
+  // CHECK-SAME: iree.abi.stateless = "1"
+  vm.func @a(%arg0 : i32) -> i32 {
+    %0 = vm.call @b(%arg0) : (i32) -> i32
+    vm.return %0 : i32
+  }
+  vm.export @b
+  // CHECK: vm.func @b
+  // CHECK-SAME: iree.abi.stateless = "1"
+  vm.func @b(%arg0 : i32) -> i32 {
+    %c1 = vm.const.i32 1
+    vm.cond_br %arg0, ^bb1, ^bb2(%arg0 : i32)
+  ^bb1:
+    %0 = vm.sub.i32 %arg0, %c1 : i32
+    %1 = vm.call @a(%0) : (i32) -> i32
+    vm.br ^bb2(%1 : i32)
+  ^bb2(%2 : i32):
+    vm.return %2 : i32
+  }
+}
+
+// -----
+
+// Tests that objects held in immutable ref globals are treated as mutated
+// when they are written or passed to calls that may write into them.
+
+// CHECK-LABEL: @immutable_ref
+vm.module @immutable_ref {
+  vm.global.ref private @g0 : !vm.buffer
+  vm.import private @other.write(%arg0 : !vm.buffer)
+  vm.export @import_arg
+  // CHECK: vm.func @import_arg
+  // CHECK-NOT: iree.abi.stateless
+  vm.func @import_arg() {
+    %0 = vm.global.load.ref @g0 : !vm.buffer
+    vm.call @other.write(%0) : (!vm.buffer) -> ()
+    vm.return
+  }
+  vm.export @store
+  // CHECK: vm.func @store
+  // CHECK-NOT: iree.abi.stateless
+  vm.func @store(%arg0 : i32) {
+    %0 = vm.global.load.ref @g0 : !vm.buffer
+    %c0 = vm.const.i64 0
+    vm.br ^bb1(%0 : !vm.buffer)
+  ^bb1(%1 : !vm.buffer):
+    vm.buffer.store.i32 %arg0, %1[%c0] : i32 -> !vm.buffer
+    vm.return
+  }
+  vm.export @load
+  // CHECK: vm.func @load
+  // CHECK-SAME: iree.abi.stateless = "1"
+  vm.func @load() -> i32 {
+    %0 = vm.global.load.ref @g0 : !vm.buffer
+    %c0 = vm.const.i64 0
+    %1 = vm.buffer.load.i32 %0[%c0] : !vm.buffer -> i32
+    vm.return %1 : i32
+  }
+}
+
+// -----
+
+// Tests that initializers are never marked.
+
+// CHECK-LABEL: @initializers
+vm.module @initializers {
+  vm.export @__init
+  // CHECK: vm.func private @__init()
+  // CHECK-NOT: iree.abi.stateless
+  vm.func private @__init() {
+    vm.return
+  }
+}
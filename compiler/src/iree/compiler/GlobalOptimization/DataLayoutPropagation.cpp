@@ -6,8 +6,10 @@
 
 #include "iree/compiler/GlobalOptimization/PassDetail.h"
 #include "iree/compiler/GlobalOptimization/Passes.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tensor/Transforms/Transforms.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 using namespace mlir;
@@ -16,22 +18,61 @@ namespace mlir::iree_compiler::GlobalOptimization {
 
 namespace {
 
+/// Returns true if pack/unpack ops are allowed to be propagated through |op|.
+/// Besides reshapes, this allows generic ops whose operands are all indexed
+/// with projected permutations, i.e., elementwise, broadcast, transpose and
+/// reduction ops. The propagation patterns bail out on their own when a packed
+/// dimension maps to a reduction loop, so reductions only let the layout flow
+/// through when the reduced dimensions are not tiled.
+static bool isPropagationAllowed(Operation *op) {
+  if (isa<tensor::CollapseShapeOp, tensor::ExpandShapeOp>(op))
+    return true;
+  auto genericOp = dyn_cast<linalg::GenericOp>(op);
+  if (!genericOp || genericOp.getNumDpsInits() != 1)
+    return false;
+  return llvm::all_of(genericOp.getIndexingMapsArray(), [](AffineMap map) {
+    return map.isProjectedPermutation();
+  });
+}
+
 struct DataLayoutPropagationPass
     : public DataLayoutPropagationBase<DataLayoutPropagationPass> {
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     FunctionOpInterface funcOp = getOperation();
 
-    RewritePatternSet patterns(context);
-    linalg::populateDataLayoutPropagationPatterns(patterns, [](Operation *op) {
-      // Currently only bubble up/push down pack/unpack through collapse/expand
-      // shape ops.
-      return isa<tensor::CollapseShapeOp, tensor::ExpandShapeOp>(op);
-    });
-    if (failed(applyPatternsAndFoldGreedily(funcOp, std::move(patterns)))) {
-      funcOp.emitOpError("folding patterns failed");
-      return signalPassFailure();
+    {
+      RewritePatternSet patterns(context);
+      linalg::populateDataLayoutPropagationPatterns(patterns,
+                                                    isPropagationAllowed);
+      if (failed(applyPatternsAndFoldGreedily(funcOp, std::move(patterns)))) {
+        funcOp.emitOpError("folding patterns failed");
+        return signalPassFailure();
+      }
     }
+
+    // Cancel out the pack(unpack) pairs that meet after the propagation and
+    // fold transposes into the remaining pack/unpack ops, so tiled activations
+    // stay in the tiled layout between consecutive layers.
+    {
+      RewritePatternSet patterns(context);
+      tensor::PackOp::getCanonicalizationPatterns(patterns, context);
+      tensor::UnPackOp::getCanonicalizationPatterns(patterns, context);
+      tensor::populateFoldIntoPackAndUnpackPatterns(patterns);
+      if (failed(applyPatternsAndFoldGreedily(funcOp, std::move(patterns)))) {
+        funcOp.emitOpError("folding patterns failed");
+        return signalPassFailure();
+      }
+    }
+
+    // Each remaining pack/unpack op becomes a relayout dispatch unless it gets
+    // fused with a producer or a consumer later on.
+    funcOp.walk([&](Operation *op) {
+      if (isa<tensor::PackOp>(op))
+        ++numRemainingPackOps;
+      else if (isa<tensor::UnPackOp>(op))
+        ++numRemainingUnPackOps;
+    });
   }
 };
 
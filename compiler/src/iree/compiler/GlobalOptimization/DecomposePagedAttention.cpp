@@ -0,0 +1,119 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtOps.h"
+#include "iree/compiler/GlobalOptimization/PassDetail.h"
+#include "iree/compiler/GlobalOptimization/Passes.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Arith/Utils/Utils.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+namespace mlir::iree_compiler::GlobalOptimization {
+
+namespace {
+
+// Gathers the pages of |cache| (NumPages x P x D) listed in |blockTable|
+// (B x T) into a contiguous B x (T * P) x D tensor.
+static Value gatherPages(OpBuilder &builder, Location loc, Value cache,
+                         Value blockTable) {
+  auto cacheType = cast<RankedTensorType>(cache.getType());
+  OpFoldResult batchSize = tensor::getMixedSize(builder, loc, blockTable, 0);
+  OpFoldResult pageCount = tensor::getMixedSize(builder, loc, blockTable, 1);
+  OpFoldResult pageSize = tensor::getMixedSize(builder, loc, cache, 1);
+  OpFoldResult headSize = tensor::getMixedSize(builder, loc, cache, 2);
+  AffineExpr s0, s1;
+  bindSymbols(builder.getContext(), s0, s1);
+  OpFoldResult sequenceLength = affine::makeComposedFoldedAffineApply(
+      builder, loc, s0 * s1, {pageCount, pageSize});
+  Value empty = builder.create<tensor::EmptyOp>(
+      loc, SmallVector<OpFoldResult>{batchSize, sequenceLength, headSize},
+      cacheType.getElementType());
+
+  Value pageSizeValue = getValueOrCreateConstantIndexOp(builder, loc, pageSize);
+  auto emptyType = cast<RankedTensorType>(empty.getType());
+  SmallVector<AffineMap> indexingMaps = {
+      builder.getMultiDimIdentityMap(emptyType.getRank())};
+  SmallVector<utils::IteratorType> iteratorTypes(
+      emptyType.getRank(), utils::IteratorType::parallel);
+  auto gatherOp = builder.create<linalg::GenericOp>(
+      loc, emptyType, /*inputs=*/ValueRange{}, /*outputs=*/empty, indexingMaps,
+      iteratorTypes, [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+        Value batch = b.create<linalg::IndexOp>(nestedLoc, 0);
+        Value token = b.create<linalg::IndexOp>(nestedLoc, 1);
+        Value head = b.create<linalg::IndexOp>(nestedLoc, 2);
+        Value tableIndex =
+            b.create<arith::DivUIOp>(nestedLoc, token, pageSizeValue);
+        Value pageOffset =
+            b.create<arith::RemUIOp>(nestedLoc, token, pageSizeValue);
+        Value page = b.create<tensor::ExtractOp>(
+            nestedLoc, blockTable, ValueRange{batch, tableIndex});
+        if (!page.getType().isIndex()) {
+          page = b.create<arith::IndexCastOp>(nestedLoc, b.getIndexType(),
+                                              page);
+        }
+        Value element = b.create<tensor::ExtractOp>(
+            nestedLoc, cache, ValueRange{page, pageOffset, head});
+        b.create<linalg::YieldOp>(nestedLoc, element);
+      });
+  return gatherOp.getResult(0);
+}
+
+// Rewrites a paged attention op into gathers of the referenced key and value
+// pages feeding a regular attention op. Dispatch region formation fuses the
+// gathers into the attention dispatch so that the pages are read in place
+// rather than being materialized as contiguous tensors.
+struct DecomposePagedAttentionOp
+    : public OpRewritePattern<IREE::LinalgExt::PagedAttentionOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(IREE::LinalgExt::PagedAttentionOp op,
+                                PatternRewriter &rewriter) const override {
+    if (!op.hasPureTensorSemantics()) {
+      return rewriter.notifyMatchFailure(op, "expected tensor semantics");
+    }
+    Location loc = op.getLoc();
+    Value key =
+        gatherPages(rewriter, loc, op.getKeyCache(), op.getBlockTable());
+    Value value =
+        gatherPages(rewriter, loc, op.getValueCache(), op.getBlockTable());
+    auto attentionOp = rewriter.create<IREE::LinalgExt::AttentionOp>(
+        loc, op->getResultTypes(),
+        ValueRange{op.getQuery(), key, value, op.getScale()},
+        ValueRange{op.getOutput()});
+    rewriter.replaceOp(op, attentionOp->getResults());
+    return success();
+  }
+};
+
+struct DecomposePagedAttentionPass
+    : public DecomposePagedAttentionBase<DecomposePagedAttentionPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<affine::AffineDialect, arith::ArithDialect,
+                    linalg::LinalgDialect, tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.insert<DecomposePagedAttentionOp>(context);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass> createDecomposePagedAttentionPass() {
+  return std::make_unique<DecomposePagedAttentionPass>();
+}
+
+} // namespace mlir::iree_compiler::GlobalOptimization
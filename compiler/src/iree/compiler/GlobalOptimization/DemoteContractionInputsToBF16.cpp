@@ -24,11 +24,21 @@ namespace {
 // For narrowable inputs, selects
 struct DemoteContractionInputsToBF16Pattern
     : public OpInterfaceRewritePattern<linalg::LinalgOp> {
-  using OpInterfaceRewritePattern::OpInterfaceRewritePattern;
+  DemoteContractionInputsToBF16Pattern(MLIRContext *context, bool report)
+      : OpInterfaceRewritePattern(context), report(report) {}
   LogicalResult matchAndRewrite(linalg::LinalgOp linalgOp,
                                 PatternRewriter &rewriter) const override {
-    if (!isa<linalg::ContractionOpInterface, linalg::ConvolutionOpInterface>(
-            linalgOp.getOperation())) {
+    // Generics are demoted in place when their body is a contraction or
+    // convolution such that the body can extend the inputs back to f32 for
+    // accumulation.
+    auto genericOp = dyn_cast<linalg::GenericOp>(linalgOp.getOperation());
+    if (genericOp) {
+      if (!linalg::isaContractionOpInterface(linalgOp) &&
+          !linalg::isaConvolutionOpInterface(linalgOp)) {
+        return failure();
+      }
+    } else if (!isa<linalg::ContractionOpInterface,
+                    linalg::ConvolutionOpInterface>(linalgOp.getOperation())) {
       return failure();
     }
     for (auto operand : linalgOp->getOperands()) {
@@ -67,14 +77,32 @@ struct DemoteContractionInputsToBF16Pattern
               ->getResults()[0]);
     }
 
+    Operation *demotedOp = nullptr;
     auto replaceOpInputs = [&](auto *typePtr) {
       auto namedOp = cast<std::remove_pointer_t<decltype(typePtr)>>(linalgOp);
-      rewriter.replaceOpWithNewOp<std::remove_pointer_t<decltype(typePtr)>>(
-          linalgOp, demotedInputs, linalgOp.getDpsInits(),
-          linalg::getPrunedAttributeList(namedOp));
+      demotedOp =
+          rewriter.replaceOpWithNewOp<std::remove_pointer_t<decltype(typePtr)>>(
+              linalgOp, demotedInputs, linalgOp.getDpsInits(),
+              linalg::getPrunedAttributeList(namedOp));
     };
 
-    if (isa<linalg::MatmulOp>(linalgOp)) {
+    if (genericOp) {
+      Block *body = genericOp.getBody();
+      rewriter.modifyOpInPlace(genericOp, [&]() {
+        OpBuilder::InsertionGuard guard(rewriter);
+        rewriter.setInsertionPointToStart(body);
+        for (auto [index, demotedInput] : llvm::enumerate(demotedInputs)) {
+          genericOp.getDpsInputOperand(index)->set(demotedInput);
+          BlockArgument arg = body->getArgument(index);
+          arg.setType(rewriter.getBF16Type());
+          auto extendedArg = rewriter.create<arith::ExtFOp>(
+              loc, rewriter.getF32Type(), arg);
+          arg.replaceAllUsesExcept(extendedArg.getResult(),
+                                  extendedArg.getOperation());
+        }
+      });
+      demotedOp = genericOp;
+    } else if (isa<linalg::MatmulOp>(linalgOp)) {
       replaceOpInputs(static_cast<linalg::MatmulOp *>(nullptr));
     } else if (isa<linalg::MatvecOp>(linalgOp)) {
       replaceOpInputs(static_cast<linalg::MatvecOp *>(nullptr));
@@ -110,17 +138,30 @@ struct DemoteContractionInputsToBF16Pattern
       return failure();
     }
 
+    if (report) {
+      demotedOp->emitRemark(
+          "demoted contraction inputs from f32 to bf16 with f32 accumulation");
+    }
     return success();
   }
+
+private:
+  bool report;
 };
 
 class DemoteContractionInputsToBF16Pass
     : public DemoteContractionInputsToBF16Base<
           DemoteContractionInputsToBF16Pass> {
+public:
+  DemoteContractionInputsToBF16Pass(bool report) { this->report = report; }
+  DemoteContractionInputsToBF16Pass(
+      const DemoteContractionInputsToBF16Pass &pass)
+      : DemoteContractionInputsToBF16Pass(pass.report) {}
+
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(context);
-    patterns.insert<DemoteContractionInputsToBF16Pattern>(context);
+    patterns.insert<DemoteContractionInputsToBF16Pattern>(context, report);
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
@@ -130,8 +171,8 @@ class DemoteContractionInputsToBF16Pass
 
 } // namespace
 
-std::unique_ptr<Pass> createDemoteContractionInputsToBF16Pass() {
-  return std::make_unique<DemoteContractionInputsToBF16Pass>();
+std::unique_ptr<Pass> createDemoteContractionInputsToBF16Pass(bool report) {
+  return std::make_unique<DemoteContractionInputsToBF16Pass>(report);
 }
 
 } // namespace mlir::iree_compiler::GlobalOptimization
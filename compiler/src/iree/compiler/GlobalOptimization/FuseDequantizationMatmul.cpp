@@ -8,6 +8,7 @@
 #include "iree/compiler/Dialect/Flow/Transforms/RegionOpUtils.h"
 #include "iree/compiler/GlobalOptimization/PassDetail.h"
 #include "iree/compiler/GlobalOptimization/Passes.h"
+#include "iree/compiler/GlobalOptimization/Utils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
@@ -50,114 +51,6 @@ isContractionWithTwoReductions(linalg::GenericOp genericOp) {
   return success();
 }
 
-// Checks if the passed op is a dequantization on grouped input
-// This function checks that the genericOp:
-// 1. Has a body like:
-//      arith.extui
-//      arith.uitofp
-//      arith.subf
-//      arith.mulf
-// 2. Increases the bit width of the input
-// 3. Has 3 parallel dims
-// 4. Has 2 (weights, scales) or 3 (weights, scales, zero points)
-//    inputs and 1 output
-static LogicalResult isGroupedDequantizationOp(linalg::GenericOp genericOp) {
-  // Check for 1 result, and 2 (input, scales) or 3 (input, scales, zero points)
-  // inputs
-  if (genericOp.getNumDpsInits() != 1) {
-    return failure();
-  }
-  if (genericOp.getNumDpsInputs() != 2 && genericOp.getNumDpsInputs() != 3) {
-    return failure();
-  }
-  // Check that the rank is at least 3 and all loops are parallel
-  unsigned numLoops = genericOp.getNumLoops();
-  unsigned numParallelLoops = genericOp.getNumParallelLoops();
-  if (numLoops < 3) {
-    return failure();
-  }
-  if (numLoops != numParallelLoops) {
-    return failure();
-  }
-
-  // Work back from linalg.yield and check body of genericOp.
-  // The genericOp should yield the result of an arith.mulf,
-  // preceded by an arith.subf, arith.uitofp, and arith.extui
-  auto yieldOp = cast<linalg::YieldOp>(genericOp.getBody()->getTerminator());
-  Value producerOutput;
-  Operation *producer;
-
-  // Producer of linalg.yield op is arith.mulf
-  {
-    producerOutput = yieldOp->getOperand(0);
-    producer = producerOutput.getDefiningOp();
-    if (!producer || producer->getNumOperands() == 0) {
-      return failure();
-    }
-    if (!matchPattern(producer, m_Op<arith::MulFOp>())) {
-      return failure();
-    }
-  }
-
-  // Producer of arith.mulf op is arith.subf
-  {
-    producerOutput = producer->getOperand(0);
-    producer = producerOutput.getDefiningOp();
-    if (!producer || producer->getNumOperands() == 0) {
-      return failure();
-    }
-    if (!matchPattern(producer, m_Op<arith::SubFOp>())) {
-      return failure();
-    }
-  }
-
-  // Producer of arith.subf op is arith.uitofp
-  {
-    producerOutput = producer->getOperand(0);
-    producer = producerOutput.getDefiningOp();
-    if (!producer || producer->getNumOperands() == 0) {
-      return failure();
-    }
-    if (!matchPattern(producer, m_Op<arith::UIToFPOp>())) {
-      return failure();
-    }
-  }
-
-  // Producer of arith.uitofp op is arith.extui
-  {
-    producerOutput = producer->getOperand(0);
-    producer = producerOutput.getDefiningOp();
-    if (!producer) {
-      return failure();
-    }
-    if (!matchPattern(producer, m_Op<arith::ExtUIOp>())) {
-      return failure();
-    }
-  }
-
-  // Ensure that the dequantization increases the
-  // bitwidth from the input to the output
-  auto elementTypeOut =
-      llvm::cast<ShapedType>(genericOp.getOutputs()[0].getType())
-          .getElementType();
-  if (!elementTypeOut.isIntOrFloat()) {
-    return failure();
-  }
-  unsigned bitWidthOut = elementTypeOut.getIntOrFloatBitWidth();
-  auto elementTypeIn =
-      llvm::cast<ShapedType>(genericOp.getInputs()[0].getType())
-          .getElementType();
-  if (!elementTypeIn.isIntOrFloat()) {
-    return failure();
-  }
-  unsigned bitWidthIn = elementTypeIn.getIntOrFloatBitWidth();
-  if (bitWidthIn >= bitWidthOut) {
-    return failure();
-  }
-
-  return success();
-}
-
 static SmallVector<utils::IteratorType>
 getParallelAndReductionIterators(unsigned nLoops, unsigned nReduction) {
   SmallVector<utils::IteratorType> res(nLoops - nReduction,
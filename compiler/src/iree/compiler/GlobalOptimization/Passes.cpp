@@ -13,6 +13,8 @@
 #include "mlir/Dialect/MemRef/Transforms/Passes.h"
 #include "mlir/Transforms/Passes.h"
 
+#include <limits>
+
 namespace mlir::iree_compiler::GlobalOptimization {
 
 using FunctionLikeNest =
@@ -57,6 +59,19 @@ static llvm::cl::opt<bool> clEnableDemoteContractionInputsToBF16(
         "Demote inputs (LHS, RHS) of linalg matmul-like ops from f32 to bf16."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableWinogradConvs(
+    "iree-global-opt-enable-winograd-convs",
+    llvm::cl::desc("Rewrites 3x3 convolutions into winograd transforms and "
+                   "batch matmuls when estimated profitable (experimental)."),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<bool> clEnableGPUSplitReduction(
+    "iree-global-opt-enable-gpu-split-reduction",
+    llvm::cl::desc("Splits the reduction dimension of skinny contractions "
+                   "across workgroups based on the number of workgroup "
+                   "processors of the GPU target (experimental)."),
+    llvm::cl::init(false));
+
 void buildGlobalOptExprHoistingPassPipeline(
     OpPassManager &passManager, const TransformOptions &transformOptions) {
   IREE::Util::ExprHoistingOptions options;
@@ -79,6 +94,17 @@ void buildGlobalOptimizationPassPipeline(
     importParametersOptions.keys = transformOptions.options.parameterImportKeys;
     importParametersOptions.maximumSize =
         transformOptions.options.parameterImportMaximumSize;
+    // Bring in all parameters so const-eval can transform them at compile time
+    // instead of in initializers at startup. The ones left untransformed are
+    // restored as references to their source parameters on export.
+    if (transformOptions.options.parameterExportTransformedOnly &&
+        !transformOptions.options.parameterExportPath.empty()) {
+      importParametersOptions.keepSourceReferences = true;
+      if (!importParametersOptions.maximumSize) {
+        importParametersOptions.maximumSize =
+            std::numeric_limits<int64_t>::max();
+      }
+    }
     mainPassManager.addPass(IREE::IO::Parameters::createImportParametersPass(
         importParametersOptions));
   }
@@ -88,7 +114,9 @@ void buildGlobalOptimizationPassPipeline(
       .addPass(createRemoveZeroExtentTensorsPass)
       .addPass(createDetachElementwiseFromNamedOpsPass)
       .addPass(mlir::createLinalgNamedOpConversionPass)
-      .addPass(createConvert1X1FilterConv2DToMatmulPass);
+      .addPass(createConvert1X1FilterConv2DToMatmulPass)
+      .addPass(createDecomposePagedAttentionPass)
+      .addPredicatedPass(clEnableWinogradConvs, createSelectWinogradConvsPass);
   mainPassManager.addPass(createEraseUnusedLinalgOperands());
 
   // Expand tensor shapes into SSA values and optimize the whole program.
@@ -96,6 +124,21 @@ void buildGlobalOptimizationPassPipeline(
   // better our fusions will be.
   mainPassManager.addPass(createExpandTensorShapesPass());
 
+  const auto precisionPolicy = transformOptions.options.precisionPolicy;
+  if (precisionPolicy ==
+      GlobalOptimizationOptions::PrecisionPolicy::Int8Weights) {
+    // Dequantization of the weights must not be folded back into f32 values
+    // by const-eval so only weights large enough for hoisting to reject the
+    // size increase (3 bytes per element) are quantized.
+    int64_t minimumElementCount = 0;
+    if (transformOptions.options.constExprHoisting) {
+      minimumElementCount =
+          transformOptions.options.constExprMaxSizeIncreaseThreshold / 3 + 1;
+    }
+    mainPassManager.addPass(createQuantizeContractionWeightsPass(
+        minimumElementCount, transformOptions.options.precisionReport));
+  }
+
   FunctionLikeNest(mainPassManager)
       // Preprocess the input to a form more amenable for fusion
       // - Convert all elementwise ops to Linalg
@@ -120,8 +163,14 @@ void buildGlobalOptimizationPassPipeline(
       .addPass(IREE::Flow::createFoldUnitExtentDimsPass)
       .addPredicatedPass(clEnableFuseSiluHorizontalMatmul,
                          createFuseSiluHorizontalMatmulPass)
-      .addPredicatedPass(clEnableDemoteContractionInputsToBF16,
-                         createDemoteContractionInputsToBF16Pass)
+      .addPredicatedPass(
+          clEnableDemoteContractionInputsToBF16 ||
+              precisionPolicy ==
+                  GlobalOptimizationOptions::PrecisionPolicy::BF16Matmul,
+          [&]() {
+            return createDemoteContractionInputsToBF16Pass(
+                transformOptions.options.precisionReport);
+          })
       .addPass([&]() {
         return createFuseDequantizationMatmulPass(
             clEnableQuantizedMatmulReassociation);
@@ -150,6 +199,10 @@ void buildGlobalOptimizationPassPipeline(
         .addPass(mlir::createCSEPass);
   }
 
+  if (clEnableGPUSplitReduction) {
+    mainPassManager.addPass(createSplitReductionForGPUParallelismPass());
+  }
+
   // Enable data tiling after they are in a canonical form.
   if (transformOptions.options.dataTiling) {
     // TODO(hanchung): Make data-tiling passes be FunctionOpInterface pass, so
@@ -229,6 +282,8 @@ void buildGlobalOptimizationPassPipeline(
         transformOptions.options.parameterExportPath;
     exportParametersOptions.minimumSize =
         transformOptions.options.parameterExportMinimumSize;
+    exportParametersOptions.transformedOnly =
+        transformOptions.options.parameterExportTransformedOnly;
     mainPassManager.addPass(IREE::IO::Parameters::createExportParametersPass(
         exportParametersOptions));
   }
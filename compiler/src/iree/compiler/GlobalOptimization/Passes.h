@@ -51,8 +51,14 @@ std::unique_ptr<Pass> createConvert1X1FilterConv2DToMatmulPass();
 std::unique_ptr<Pass>
 createDecomposeConcatPass(bool enableConcatTransposition = false);
 
+/// Decomposes iree_linalg_ext.paged_attention ops into gathers of the key and
+/// value pages feeding iree_linalg_ext.attention ops.
+std::unique_ptr<Pass> createDecomposePagedAttentionPass();
+
 /// Demotes inputs (LHS, RHS) of linalg matmul-like ops from f32 to bf16.
-std::unique_ptr<Pass> createDemoteContractionInputsToBF16Pass();
+/// Demoted ops are reported as remarks when |report| is set.
+std::unique_ptr<Pass>
+createDemoteContractionInputsToBF16Pass(bool report = false);
 
 /// Detaches elementwise ops from named Linalg ops.
 std::unique_ptr<Pass> createDetachElementwiseFromNamedOpsPass();
@@ -100,6 +106,14 @@ std::unique_ptr<Pass> createOptimizeNumericsPass();
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createPropagateLinalgTransposePass(bool enableAggressivePropagation = false);
 
+/// Quantizes constant f32 weights of contractions and convolutions with at
+/// least |minimumElementCount| elements to i8 with symmetric per-channel
+/// scales and dequantizes them at their use. Quantized weights are reported
+/// as remarks when |report| is set.
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createQuantizeContractionWeightsPass(int64_t minimumElementCount = 0,
+                                     bool report = false);
+
 /// Performs specialized raisings of various sequences of ops to a
 /// representation easier for the compiler to handle.
 std::unique_ptr<Pass> createRaiseSpecialOps();
@@ -108,6 +122,11 @@ std::unique_ptr<Pass> createRaiseSpecialOps();
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createRemoveZeroExtentTensorsPass();
 
+/// Rewrites 3x3 convolutions to winograd transforms and a batch matmul when it
+/// is estimated to be profitable.
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createSelectWinogradConvsPass();
+
 /// Sets encoding for tensors to allow tiled execution of operations. If
 /// `padFactor` is set to non-zero, the padding sizes hint will be attached to
 /// encodings. It makes the host and device agree with the same padding sizes.
@@ -116,6 +135,11 @@ std::unique_ptr<Pass> createSetEncodingPass(int64_t padFactor = 0);
 /// Simplifies tensor pack/unpack ops to reshape ops.
 std::unique_ptr<Pass> createSimplifyPackUnpackPass();
 
+/// Splits the reduction of contractions producing too few output tiles to
+/// occupy the workgroup processors of the targeted GPU.
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createSplitReductionForGPUParallelismPass();
+
 /// Hoist loop invariants out of loops with zero-trip-check.
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
 createGlobalLoopInvariantCodeMotionPass();
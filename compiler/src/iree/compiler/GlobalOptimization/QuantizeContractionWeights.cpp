@@ -0,0 +1,361 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===- QuantizeContractionWeights.cpp - Weight-only i8 quantization -------===//
+//
+// Quantizes constant f32 weights of contractions and convolutions to i8 using
+// symmetric per-channel scales computed from the weight values themselves:
+//
+//   scale[c] = max(|w[..., c, ...]|) / 127
+//   q[i] = clamp(round(w[i] / scale[c]), -127, 127)
+//
+// where the channels of a weight are the dimensions not reduced by the
+// consuming op (e.g. the output features of a matmul RHS or a convolution
+// filter). The weight is replaced at its use with a dequantization generic
+// that is recognized as dequantization-like by dispatch region formation and
+// fused into the consumer. Only the weights are changed; activations and
+// accumulation stay f32 so no calibration data is needed.
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cmath>
+
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "iree/compiler/GlobalOptimization/PassDetail.h"
+#include "iree/compiler/GlobalOptimization/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/SymbolTable.h"
+
+namespace mlir::iree_compiler::GlobalOptimization {
+
+namespace {
+
+// Largest magnitude representable by the symmetric i8 range used.
+static constexpr float kQuantizedMax = 127.0f;
+
+struct QuantizedWeight {
+  // i8 values with the same shape as the original weight.
+  DenseElementsAttr values;
+  // f32 scales with the shape of the channel dimensions of the weight.
+  DenseElementsAttr scales;
+  // Largest absolute difference between a weight and its dequantized value.
+  float maxError = 0.0f;
+  // Globals holding the values and scales when quantizing a global.
+  IREE::Util::GlobalOp valuesGlobalOp;
+  IREE::Util::GlobalOp scalesGlobalOp;
+};
+
+// Returns the values of |attr| if it is a non-splat f32 elements attribute
+// whose contents are available to the compiler.
+static std::optional<SmallVector<float>> getWeightValues(Attribute attr) {
+  if (auto denseAttr = dyn_cast<DenseElementsAttr>(attr)) {
+    if (denseAttr.isSplat() || !denseAttr.getElementType().isF32()) {
+      return std::nullopt;
+    }
+    return llvm::to_vector(denseAttr.getValues<float>());
+  }
+  if (auto resourceAttr = dyn_cast<DenseF32ResourceElementsAttr>(attr)) {
+    if (auto values = resourceAttr.tryGetAsArrayRef()) {
+      return llvm::to_vector(*values);
+    }
+  }
+  return std::nullopt;
+}
+
+// Returns the dimensions of |operand| that are not reduced by |linalgOp| or
+// nullopt if the operand is not indexed by a projected permutation.
+static std::optional<SmallVector<int64_t>>
+getChannelDims(linalg::LinalgOp linalgOp, OpOperand *operand) {
+  AffineMap indexingMap = linalgOp.getMatchingIndexingMap(operand);
+  if (!indexingMap.isProjectedPermutation()) {
+    return std::nullopt;
+  }
+  SmallVector<utils::IteratorType> iteratorTypes =
+      linalgOp.getIteratorTypesArray();
+  SmallVector<int64_t> channelDims;
+  for (unsigned i = 0; i < indexingMap.getNumResults(); ++i) {
+    if (iteratorTypes[indexingMap.getDimPosition(i)] ==
+        utils::IteratorType::parallel) {
+      channelDims.push_back(i);
+    }
+  }
+  return channelDims;
+}
+
+// Quantizes |values| of |weightType| symmetrically with one scale per index
+// of the |channelDims|. Returns nullopt if any of the values is not finite.
+static std::optional<QuantizedWeight>
+quantizeWeight(ArrayRef<float> values, RankedTensorType weightType,
+               ArrayRef<int64_t> channelDims) {
+  ArrayRef<int64_t> shape = weightType.getShape();
+  SmallVector<int64_t> scaleShape;
+  for (int64_t dim : channelDims) {
+    scaleShape.push_back(shape[dim]);
+  }
+
+  // Calls |fn| with the linear index of each element and its channel.
+  auto forEachElement = [&](auto fn) {
+    SmallVector<int64_t> indices(shape.size(), 0);
+    for (int64_t i = 0; i < static_cast<int64_t>(values.size()); ++i) {
+      int64_t channel = 0;
+      for (int64_t dim : channelDims) {
+        channel = channel * shape[dim] + indices[dim];
+      }
+      fn(i, channel);
+      for (int64_t dim = shape.size() - 1; dim >= 0; --dim) {
+        if (++indices[dim] < shape[dim]) {
+          break;
+        }
+        indices[dim] = 0;
+      }
+    }
+  };
+
+  SmallVector<float> scales(ShapedType::getNumElements(scaleShape), 0.0f);
+  bool allFinite = true;
+  forEachElement([&](int64_t i, int64_t channel) {
+    allFinite &= std::isfinite(values[i]);
+    scales[channel] = std::max(scales[channel], std::abs(values[i]));
+  });
+  if (!allFinite) {
+    return std::nullopt;
+  }
+  for (float &scale : scales) {
+    scale = scale > 0.0f ? scale / kQuantizedMax : 1.0f;
+  }
+
+  QuantizedWeight weight;
+  SmallVector<int8_t> quantizedValues(values.size());
+  forEachElement([&](int64_t i, int64_t channel) {
+    float quantizedValue = std::clamp(std::round(values[i] / scales[channel]),
+                                      -kQuantizedMax, kQuantizedMax);
+    quantizedValues[i] = static_cast<int8_t>(quantizedValue);
+    float error = std::abs(values[i] - quantizedValue * scales[channel]);
+    weight.maxError = std::max(weight.maxError, error);
+  });
+
+  Builder builder(weightType.getContext());
+  weight.values = DenseElementsAttr::get(
+      RankedTensorType::get(shape, builder.getI8Type()),
+      ArrayRef<int8_t>(quantizedValues));
+  weight.scales = DenseElementsAttr::get(
+      RankedTensorType::get(scaleShape, builder.getF32Type()),
+      ArrayRef<float>(scales));
+  return weight;
+}
+
+// Builds the f32 weight of |weightType| from its i8 |values| and |scales|.
+static Value buildDequantization(OpBuilder &builder, Location loc,
+                                 RankedTensorType weightType, Value values,
+                                 Value scales, ArrayRef<int64_t> channelDims) {
+  int64_t rank = weightType.getRank();
+  AffineMap identityMap = builder.getMultiDimIdentityMap(rank);
+  SmallVector<AffineExpr> scaleExprs;
+  for (int64_t dim : channelDims) {
+    scaleExprs.push_back(builder.getAffineDimExpr(dim));
+  }
+  AffineMap scaleMap =
+      AffineMap::get(rank, /*symbolCount=*/0, scaleExprs, builder.getContext());
+  SmallVector<utils::IteratorType> iteratorTypes(rank,
+                                                 utils::IteratorType::parallel);
+  Value empty = builder.create<tensor::EmptyOp>(loc, weightType.getShape(),
+                                                builder.getF32Type());
+  return builder
+      .create<linalg::GenericOp>(
+          loc, TypeRange{weightType}, ValueRange{values, scales},
+          ValueRange{empty},
+          ArrayRef<AffineMap>{identityMap, scaleMap, identityMap},
+          iteratorTypes,
+          [&](OpBuilder &b, Location loc, ValueRange args) {
+            Value value =
+                b.create<arith::SIToFPOp>(loc, b.getF32Type(), args[0]);
+            Value result = b.create<arith::MulFOp>(loc, value, args[1]);
+            b.create<linalg::YieldOp>(loc, result);
+          })
+      ->getResult(0);
+}
+
+// Returns true if |linalgOp| is a contraction or convolution on f32 tensors.
+static bool isQuantizableContraction(linalg::LinalgOp linalgOp) {
+  if (!linalgOp.hasPureTensorSemantics() || linalgOp.getNumDpsInputs() != 2 ||
+      linalgOp.getNumDpsInits() != 1) {
+    return false;
+  }
+  if (!linalg::isaContractionOpInterface(linalgOp) &&
+      !linalg::isaConvolutionOpInterface(linalgOp)) {
+    return false;
+  }
+  return llvm::all_of(linalgOp->getOperandTypes(), [](Type type) {
+    auto tensorType = dyn_cast<RankedTensorType>(type);
+    return tensorType && tensorType.hasStaticShape() &&
+           !tensorType.getEncoding() && tensorType.getElementType().isF32();
+  });
+}
+
+class QuantizeContractionWeightsPass
+    : public QuantizeContractionWeightsBase<QuantizeContractionWeightsPass> {
+public:
+  QuantizeContractionWeightsPass(int64_t minimumElementCount, bool report) {
+    this->minimumElementCount = minimumElementCount;
+    this->report = report;
+  }
+  QuantizeContractionWeightsPass(const QuantizeContractionWeightsPass &pass)
+      : QuantizeContractionWeightsPass(pass.minimumElementCount, pass.report) {
+  }
+
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    mlir::ModuleOp moduleOp = getOperation();
+    SymbolTable symbolTable(moduleOp);
+
+    // Immutable globals may still be stored from initializers in which case
+    // their initial value is not what is used.
+    DenseSet<StringRef> storedGlobals;
+    moduleOp.walk([&](IREE::Util::GlobalStoreOpInterface storeOp) {
+      storedGlobals.insert(storeOp.getGlobalName());
+    });
+
+    SmallVector<linalg::LinalgOp> contractionOps;
+    moduleOp.walk([&](linalg::LinalgOp linalgOp) {
+      if (isQuantizableContraction(linalgOp)) {
+        contractionOps.push_back(linalgOp);
+      }
+    });
+
+    // Weights keyed by their source (global or constant attribute) and the
+    // channel dimensions they were quantized along.
+    DenseMap<std::pair<const void *, Attribute>, QuantizedWeight> weights;
+    for (linalg::LinalgOp linalgOp : contractionOps) {
+      // Find the single input with a value known to the compiler. Ops with
+      // two constant inputs are left to const-eval.
+      OpOperand *weightOperand = nullptr;
+      Attribute weightAttr;
+      IREE::Util::GlobalOp weightGlobalOp;
+      for (OpOperand *operand : linalgOp.getDpsInputOperands()) {
+        Attribute attr;
+        IREE::Util::GlobalOp globalOp;
+        if (!matchPattern(operand->get(), m_Constant(&attr))) {
+          auto loadOp = operand->get()
+                            .getDefiningOp<IREE::Util::GlobalLoadOpInterface>();
+          if (!loadOp) {
+            continue;
+          }
+          globalOp =
+              symbolTable.lookup<IREE::Util::GlobalOp>(loadOp.getGlobalName());
+          if (!globalOp || globalOp.isGlobalMutable() ||
+              storedGlobals.contains(globalOp.getSymName())) {
+            continue;
+          }
+          attr = globalOp.getGlobalInitialValue();
+          if (!attr) {
+            continue;
+          }
+        }
+        if (weightOperand) {
+          weightOperand = nullptr;
+          break;
+        }
+        weightOperand = operand;
+        weightAttr = attr;
+        weightGlobalOp = globalOp;
+      }
+      if (!weightOperand) {
+        continue;
+      }
+
+      auto weightType = cast<RankedTensorType>(weightOperand->get().getType());
+      if (weightType.getNumElements() < minimumElementCount) {
+        continue;
+      }
+      std::optional<SmallVector<int64_t>> channelDims =
+          getChannelDims(linalgOp, weightOperand);
+      if (!channelDims) {
+        continue;
+      }
+
+      Builder builder(&getContext());
+      std::pair<const void *, Attribute> key = {
+          weightGlobalOp ? weightGlobalOp.getAsOpaquePointer()
+                         : weightAttr.getAsOpaquePointer(),
+          builder.getDenseI64ArrayAttr(*channelDims)};
+      auto it = weights.find(key);
+      if (it == weights.end()) {
+        std::optional<SmallVector<float>> values = getWeightValues(weightAttr);
+        if (!values) {
+          continue;
+        }
+        std::optional<QuantizedWeight> weight =
+            quantizeWeight(*values, weightType, *channelDims);
+        if (!weight) {
+          continue;
+        }
+        if (weightGlobalOp) {
+          OpBuilder moduleBuilder(weightGlobalOp);
+          moduleBuilder.setInsertionPointAfter(weightGlobalOp);
+          auto createGlobal = [&](StringRef suffix, DenseElementsAttr value) {
+            auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+                weightGlobalOp.getLoc(),
+                (weightGlobalOp.getSymName() + suffix).str(),
+                /*isMutable=*/false, value.getType(),
+                std::optional<TypedAttr>(value));
+            globalOp.setVisibility(SymbolTable::Visibility::Private);
+            symbolTable.insert(globalOp);
+            return globalOp;
+          };
+          weight->valuesGlobalOp = createGlobal("_i8", weight->values);
+          weight->scalesGlobalOp = createGlobal("_scales", weight->scales);
+        }
+        it = weights.insert({key, *weight}).first;
+      }
+      QuantizedWeight &weight = it->second;
+
+      OpBuilder opBuilder(linalgOp);
+      Location loc = linalgOp.getLoc();
+      Value values, scales;
+      if (weight.valuesGlobalOp) {
+        values = weight.valuesGlobalOp.createLoadOp(loc, opBuilder)
+                     .getLoadedGlobalValue();
+        scales = weight.scalesGlobalOp.createLoadOp(loc, opBuilder)
+                     .getLoadedGlobalValue();
+      } else {
+        values = opBuilder.create<arith::ConstantOp>(loc, weight.values);
+        scales = opBuilder.create<arith::ConstantOp>(loc, weight.scales);
+      }
+      weightOperand->set(buildDequantization(opBuilder, loc, weightType, values,
+                                             scales, *channelDims));
+
+      if (report) {
+        linalgOp->emitRemark()
+            << "quantized f32 weight of " << weightType.getNumElements()
+            << " elements to i8 with " << weight.scales.getNumElements()
+            << " per-channel scales (max abs error " << weight.maxError << ")";
+      }
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createQuantizeContractionWeightsPass(int64_t minimumElementCount,
+                                     bool report) {
+  return std::make_unique<QuantizeContractionWeightsPass>(minimumElementCount,
+                                                          report);
+}
+
+} // namespace mlir::iree_compiler::GlobalOptimization
@@ -0,0 +1,127 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===- SelectWinogradConvs.cpp --------------------------------------------===//
+//
+// Rewrites 3x3 convolutions into winograd transforms and a batch matmul when
+// a simple cost model estimates that it reduces the amount of computation.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtDialect.h"
+#include "iree/compiler/Dialect/LinalgExt/Transforms/Passes.h"
+#include "iree/compiler/GlobalOptimization/PassDetail.h"
+#include "iree/compiler/GlobalOptimization/Passes.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/PatternMatch.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#define DEBUG_TYPE "iree-global-opt-select-winograd-convs"
+
+namespace mlir::iree_compiler::GlobalOptimization {
+
+// Output tile size of the selected winograd transformation. F(4x4, 3x3) keeps
+// the transform constants small enough to be accurate for f16 inputs.
+static constexpr int64_t kOutputTileSize = 4;
+
+// Minimum estimated reduction of arithmetic operations for a convolution to
+// be rewritten. The transforms are memory bound kernels so the savings need
+// to be large enough to make up for the extra memory traffic.
+static constexpr double kMinSpeedup = 2.0;
+
+namespace {
+
+/// Returns true if the output of |convOp| is initialized with zeros. The
+/// winograd rewrite does not accumulate into the convolution output.
+static bool hasZeroInit(linalg::LinalgOp convOp) {
+  auto fillOp = convOp.getDpsInits()[0].getDefiningOp<linalg::FillOp>();
+  if (!fillOp)
+    return false;
+  Value fillValue = fillOp.getDpsInputOperand(0)->get();
+  return matchPattern(fillValue, m_AnyZeroFloat());
+}
+
+/// Returns the output tile size to rewrite |convOp| with winograd, or
+/// std::nullopt if the direct convolution is estimated to be cheaper.
+static std::optional<int64_t>
+getWinogradOutputTileSize(linalg::LinalgOp convOp) {
+  bool isNchw = isa<linalg::Conv2DNchwFchwOp>(convOp);
+  if (!isNchw && !isa<linalg::Conv2DNhwcHwcfOp>(convOp))
+    return std::nullopt;
+  if (convOp.hasDynamicShape() || !convOp.hasPureTensorSemantics())
+    return std::nullopt;
+  // The winograd transforms use fractional constants.
+  auto outputType = cast<RankedTensorType>(convOp.getDpsInits()[0].getType());
+  if (!isa<FloatType>(outputType.getElementType()) || !hasZeroInit(convOp))
+    return std::nullopt;
+
+  ArrayRef<int64_t> filterShape =
+      cast<RankedTensorType>(convOp.getDpsInputs()[1].getType()).getShape();
+  ArrayRef<int64_t> outputShape = outputType.getShape();
+  const int64_t kh = isNchw ? filterShape[2] : filterShape[0];
+  const int64_t kw = isNchw ? filterShape[3] : filterShape[1];
+  if (kh != 3 || kw != 3)
+    return std::nullopt;
+  const double c = isNchw ? filterShape[1] : filterShape[2];
+  const double f = isNchw ? filterShape[0] : filterShape[3];
+  const int64_t n = outputShape[0];
+  const int64_t oh = isNchw ? outputShape[2] : outputShape[1];
+  const int64_t ow = isNchw ? outputShape[3] : outputShape[2];
+
+  // Estimate the number of multiply-accumulates of both implementations. The
+  // filter transform is ignored as it is an amortized constant computation
+  // for inference.
+  const double m = kOutputTileSize;
+  const double i = kOutputTileSize + kh - 1;
+  const double numTiles = static_cast<double>(n) *
+                          llvm::divideCeil(oh, kOutputTileSize) *
+                          llvm::divideCeil(ow, kOutputTileSize);
+  const double directCost = static_cast<double>(n) * oh * ow * f * c * kh * kw;
+  const double inputTransformCost = numTiles * c * 2 * i * i * i;
+  const double batchMatmulCost = numTiles * i * i * c * f;
+  const double outputTransformCost = numTiles * f * (i * i * m + i * m * m);
+  const double winogradCost =
+      inputTransformCost + batchMatmulCost + outputTransformCost;
+  LLVM_DEBUG(llvm::dbgs() << "direct cost: " << directCost
+                          << ", winograd cost: " << winogradCost << " for "
+                          << convOp << "\n");
+  if (winogradCost * kMinSpeedup > directCost)
+    return std::nullopt;
+  return kOutputTileSize;
+}
+
+struct SelectWinogradConvsPass
+    : public SelectWinogradConvsBase<SelectWinogradConvsPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect,
+                    IREE::LinalgExt::IREELinalgExtDialect>();
+  }
+
+  void runOnOperation() override {
+    RewritePatternSet patterns(&getContext());
+    IREE::LinalgExt::populateConvertConv2DToWinogradPatterns(
+        patterns, getWinogradOutputTileSize);
+    if (failed(applyPatternsAndFoldGreedily(getOperation(),
+                                            std::move(patterns)))) {
+      return signalPassFailure();
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
+createSelectWinogradConvsPass() {
+  return std::make_unique<SelectWinogradConvsPass>();
+}
+
+} // namespace mlir::iree_compiler::GlobalOptimization
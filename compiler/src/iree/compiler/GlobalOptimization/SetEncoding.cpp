@@ -96,23 +96,9 @@ struct MatmulNarrowSizes {
   std::optional<int64_t> M, N;
 };
 
-// Returns the minimum of static sizes of the M/N-dimensions in the types of the
-// Ouput.
-static MatmulNarrowSizes getMatmulNarrowSizes(ShapedType outType,
-                                              linalg::LinalgOp linalgOp) {
-  linalg::ContractionDimensions cDims =
-      linalg::inferContractionDims(linalgOp).value();
-  auto map = linalgOp.getIndexingMapsArray().back();
-  auto getOutputSizeAtDimPos = [&](unsigned dimPos) -> int64_t {
-    return outType.getDimSize(
-        map.getResultPosition(getAffineDimExpr(dimPos, linalgOp->getContext()))
-            .value());
-  };
-  // M or N can be empty instead of having an explicit dim size of 1 for matvec
-  // and vecmat, so set to 1 if empty.
-  int64_t M = cDims.m.empty() ? 1 : getOutputSizeAtDimPos(cDims.m[0]);
-  int64_t N = cDims.n.empty() ? 1 : getOutputSizeAtDimPos(cDims.n[0]);
-
+// Returns the static sizes of the M/N-dimensions that are narrow enough to be
+// eligible for a narrow tile size.
+static MatmulNarrowSizes getMatmulNarrowSizes(int64_t M, int64_t N) {
   MatmulNarrowSizes narrow;
   // Threshold below which a M/N size is considered "narrow", making it
   // eligible for a narrow tile size during materialization. This value should
@@ -131,6 +117,25 @@ static MatmulNarrowSizes getMatmulNarrowSizes(ShapedType outType,
   return narrow;
 }
 
+// Returns the minimum of static sizes of the M/N-dimensions in the types of the
+// Ouput.
+static MatmulNarrowSizes getMatmulNarrowSizes(ShapedType outType,
+                                              linalg::LinalgOp linalgOp) {
+  linalg::ContractionDimensions cDims =
+      linalg::inferContractionDims(linalgOp).value();
+  auto map = linalgOp.getIndexingMapsArray().back();
+  auto getOutputSizeAtDimPos = [&](unsigned dimPos) -> int64_t {
+    return outType.getDimSize(
+        map.getResultPosition(getAffineDimExpr(dimPos, linalgOp->getContext()))
+            .value());
+  };
+  // M or N can be empty instead of having an explicit dim size of 1 for matvec
+  // and vecmat, so set to 1 if empty.
+  int64_t M = cDims.m.empty() ? 1 : getOutputSizeAtDimPos(cDims.m[0]);
+  int64_t N = cDims.n.empty() ? 1 : getOutputSizeAtDimPos(cDims.n[0]);
+  return getMatmulNarrowSizes(M, N);
+}
+
 static Value padAndSetEncoding(OpBuilder &builder, Location loc, Value source,
                                EncodingRole role,
                                ArrayRef<Type> operandElemTypes,
@@ -369,6 +374,245 @@ private:
   int64_t padFactor = 0;
 };
 
+/// Sets encodings on a matmul or vecmat whose RHS is a grouped dequantization
+/// of u4 weights with f16 or bf16 scales and zero points:
+///
+///   %rhs = dequant(%weights: NxGxGSxi4, %scales: NxG, %zero_points: NxG)
+///   %out = matmul(%lhs: [M]xGxGSxf32, %rhs: NxGxGSxf32) -> [M]xNxf32
+///
+/// The pair is replaced by a single 2-D matmul over K = G * GS that reads the
+/// quantized weights, scales and zero points directly. Its encodings carry the
+/// scales element type as a fourth element type, which materialization uses
+/// to lower to the mmt4d_dequant ukernel without writing the dequantized
+/// weights to memory.
+class SetGroupedDequantMatmulEncoding
+    : public OpRewritePattern<linalg::GenericOp> {
+public:
+  using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
+  explicit SetGroupedDequantMatmulEncoding(MLIRContext *ctx, int64_t factor)
+      : OpRewritePattern<linalg::GenericOp>(ctx), padFactor(factor) {}
+
+  LogicalResult matchAndRewrite(linalg::GenericOp matmulOp,
+                                PatternRewriter &rewriter) const override {
+    if (!matmulOp.hasPureTensorSemantics()) {
+      return failure();
+    }
+    if (getCompilationInfo(matmulOp)) {
+      return rewriter.notifyMatchFailure(
+          matmulOp, "the op has preset compilation strategy, skip SetEncoding");
+    }
+    if (matmulOp.getNumDpsInputs() != 2 || matmulOp.getNumDpsInits() != 1 ||
+        !hasMatmulLikeBody(matmulOp)) {
+      return rewriter.notifyMatchFailure(matmulOp, "expected a matmul body");
+    }
+    auto cDims = linalg::inferContractionDims(matmulOp);
+    if (failed(cDims) || !cDims->batch.empty() || cDims->m.size() > 1 ||
+        cDims->n.size() != 1 || cDims->k.size() != 2) {
+      return rewriter.notifyMatchFailure(
+          matmulOp, "expected a matmul or vecmat with split K dims");
+    }
+
+    // The RHS is indexed by (n, group, in-group), and the LHS and output are
+    // indexed like a plain matmul over these dims.
+    MLIRContext *ctx = rewriter.getContext();
+    SmallVector<AffineMap> maps = matmulOp.getIndexingMapsArray();
+    AffineExpr n = getAffineDimExpr(cDims->n[0], ctx);
+    if (maps[1].getNumResults() != 3 || maps[1].getResult(0) != n) {
+      return rewriter.notifyMatchFailure(matmulOp, "unexpected RHS map");
+    }
+    SmallVector<AffineExpr> lhsExprs, outExprs;
+    if (!cDims->m.empty()) {
+      lhsExprs.push_back(getAffineDimExpr(cDims->m[0], ctx));
+      outExprs.push_back(getAffineDimExpr(cDims->m[0], ctx));
+    }
+    lhsExprs.append({maps[1].getResult(1), maps[1].getResult(2)});
+    outExprs.push_back(n);
+    if (maps[0].getResults() != ArrayRef<AffineExpr>(lhsExprs) ||
+        maps[2].getResults() != ArrayRef<AffineExpr>(outExprs)) {
+      return rewriter.notifyMatchFailure(matmulOp, "unexpected LHS/out map");
+    }
+
+    Value lhs = matmulOp.getDpsInputs()[0];
+    Value out = matmulOp.getDpsInits()[0];
+    auto dequantOp =
+        matmulOp.getDpsInputs()[1].getDefiningOp<linalg::GenericOp>();
+    if (!dequantOp || failed(isGroupedDequantizationOp(dequantOp)) ||
+        dequantOp.getNumDpsInputs() != 3 || !dequantOp->hasOneUse()) {
+      return rewriter.notifyMatchFailure(
+          matmulOp, "expected RHS to be a grouped dequantization");
+    }
+    AffineMap identityMap = rewriter.getMultiDimIdentityMap(3);
+    AffineMap groupMap = AffineMap::get(
+        3, 0, {getAffineDimExpr(0, ctx), getAffineDimExpr(1, ctx)}, ctx);
+    if (dequantOp.getIndexingMapsArray() !=
+        SmallVector<AffineMap>{identityMap, groupMap, groupMap, identityMap}) {
+      return rewriter.notifyMatchFailure(dequantOp, "unexpected dequant maps");
+    }
+
+    // The dequantization body is yield(mulf(subf(uitofp(extui(weight)),
+    // zero_point), scale)), where the scale and zero point may be extended
+    // from f16 or bf16 block arguments. Find which inputs they come from.
+    Block *body = dequantOp.getBody();
+    auto yieldOp = cast<linalg::YieldOp>(body->getTerminator());
+    auto mulOp = yieldOp.getOperand(0).getDefiningOp<arith::MulFOp>();
+    auto subOp = mulOp.getLhs().getDefiningOp<arith::SubFOp>();
+    auto extOp = subOp.getLhs()
+                     .getDefiningOp<arith::UIToFPOp>()
+                     .getIn()
+                     .getDefiningOp<arith::ExtUIOp>();
+    auto getExtendedArg = [&](Value value) -> std::optional<unsigned> {
+      auto extFOp = value.getDefiningOp<arith::ExtFOp>();
+      if (!extFOp) {
+        return std::nullopt;
+      }
+      auto blockArg = dyn_cast<BlockArgument>(extFOp.getIn());
+      if (!blockArg || blockArg.getOwner() != body) {
+        return std::nullopt;
+      }
+      return blockArg.getArgNumber();
+    };
+    std::optional<unsigned> scalesIdx = getExtendedArg(mulOp.getRhs());
+    std::optional<unsigned> zeroPointsIdx = getExtendedArg(subOp.getRhs());
+    if (extOp.getIn() != body->getArgument(0) || !scalesIdx ||
+        !zeroPointsIdx || *scalesIdx == 0 || *zeroPointsIdx == 0 ||
+        *scalesIdx == *zeroPointsIdx || *scalesIdx > 2 || *zeroPointsIdx > 2) {
+      return rewriter.notifyMatchFailure(dequantOp, "unexpected dequant body");
+    }
+
+    Value weights = dequantOp.getDpsInputs()[0];
+    Value scales = dequantOp.getDpsInputs()[*scalesIdx];
+    Value zeroPoints = dequantOp.getDpsInputs()[*zeroPointsIdx];
+    auto weightsType = cast<RankedTensorType>(weights.getType());
+    auto lhsType = cast<RankedTensorType>(lhs.getType());
+    auto outType = cast<RankedTensorType>(out.getType());
+    Type scalesElemType = getElementTypeOrSelf(scales.getType());
+    if (!weightsType.getElementType().isInteger(4) ||
+        !(scalesElemType.isF16() || scalesElemType.isBF16()) ||
+        getElementTypeOrSelf(zeroPoints.getType()) != scalesElemType ||
+        !lhsType.getElementType().isF32() ||
+        !outType.getElementType().isF32() ||
+        !getElementTypeOrSelf(dequantOp->getResult(0).getType()).isF32()) {
+      return rewriter.notifyMatchFailure(matmulOp,
+                                         "unsupported element types");
+    }
+    if (!weightsType.hasStaticShape() || !lhsType.hasStaticShape() ||
+        !outType.hasStaticShape()) {
+      return rewriter.notifyMatchFailure(matmulOp, "expected static shapes");
+    }
+    int64_t groupSize = weightsType.getDimSize(2);
+    if (groupSize % 2 != 0) {
+      return rewriter.notifyMatchFailure(matmulOp,
+                                         "expected an even group size");
+    }
+
+    // Collapse the group dims into a single K dim, and give vecmats a unit M
+    // dim, so the new matmul is a plain 2-D matmul.
+    Location loc = matmulOp.getLoc();
+    bool isVecmat = cDims->m.empty();
+    int64_t M = isVecmat ? 1 : lhsType.getDimSize(0);
+    int64_t N = weightsType.getDimSize(0);
+    int64_t K = weightsType.getDimSize(1) * groupSize;
+    Value lhs2D = lhs;
+    if (isVecmat) {
+      Value collapsed = rewriter.create<tensor::CollapseShapeOp>(
+          loc, RankedTensorType::get({K}, lhsType.getElementType()), lhs,
+          SmallVector<ReassociationIndices>{{0, 1}});
+      lhs2D = rewriter.create<tensor::ExpandShapeOp>(
+          loc, RankedTensorType::get({1, K}, lhsType.getElementType()),
+          collapsed, SmallVector<ReassociationIndices>{{0, 1}});
+    } else {
+      lhs2D = rewriter.create<tensor::CollapseShapeOp>(
+          loc, RankedTensorType::get({M, K}, lhsType.getElementType()), lhs,
+          SmallVector<ReassociationIndices>{{0}, {1, 2}});
+    }
+    Value weights2D = rewriter.create<tensor::CollapseShapeOp>(
+        loc, RankedTensorType::get({N, K}, weightsType.getElementType()),
+        weights, SmallVector<ReassociationIndices>{{0}, {1, 2}});
+    Value out2D = out;
+    if (isVecmat) {
+      out2D = rewriter.create<tensor::ExpandShapeOp>(
+          loc, RankedTensorType::get({1, N}, outType.getElementType()), out,
+          SmallVector<ReassociationIndices>{{0, 1}});
+    }
+
+    Type f32Type = rewriter.getF32Type();
+    SmallVector<Type> elemTypes = {
+        f32Type, rewriter.getIntegerType(4, /*isSigned=*/false), f32Type,
+        scalesElemType};
+    AffineExpr d0, d1, d2;
+    bindDims(ctx, d0, d1, d2);
+    SmallVector<AffineMap> encodingMaps = {
+        AffineMap::get(3, 0, {d0, d2}, ctx),
+        AffineMap::get(3, 0, {d1, d2}, ctx),
+        AffineMap::get(3, 0, {d0, d1}, ctx)};
+    MatmulNarrowSizes narrowSizes = getMatmulNarrowSizes(M, N);
+
+    SmallVector<std::pair<Value, EncodingRole>> operandsAndRoles = {
+        {lhs2D, EncodingRole::LHS},
+        {weights2D, EncodingRole::RHS},
+        {scales, EncodingRole::RHS_SCALES},
+        {zeroPoints, EncodingRole::RHS_SCALES},
+        {out2D, EncodingRole::RESULT}};
+    SmallVector<Value> encodedOperands;
+    for (auto [operand, role] : operandsAndRoles) {
+      if (!padFactor) {
+        encodedOperands.push_back(padAndSetEncoding(rewriter, loc, operand,
+                                                    role, elemTypes,
+                                                    narrowSizes, encodingMaps));
+        continue;
+      }
+      SmallVector<int64_t> roundDimsTo(3, padFactor);
+      auto encoding =
+          EncodingAttr::get(ctx, role, elemTypes, operand.getType(),
+                            narrowSizes.M, narrowSizes.N, encodingMaps,
+                            roundDimsTo);
+      encodedOperands.push_back(setEncoding(rewriter, loc, operand, encoding));
+    }
+
+    AffineExpr group = d2.floorDiv(groupSize);
+    AffineMap scalesMap = AffineMap::get(3, 0, {d1, group}, ctx);
+    SmallVector<AffineMap> maps2D = {encodingMaps[0], encodingMaps[1],
+                                     scalesMap, scalesMap, encodingMaps[2]};
+    SmallVector<utils::IteratorType> iteratorTypes = {
+        utils::IteratorType::parallel, utils::IteratorType::parallel,
+        utils::IteratorType::reduction};
+    Value encodedOut = encodedOperands.back();
+    auto encodedMatmulOp = rewriter.create<linalg::GenericOp>(
+        loc, encodedOut.getType(), ValueRange(encodedOperands).drop_back(),
+        encodedOut, maps2D, iteratorTypes,
+        [&](OpBuilder &b, Location nestedLoc, ValueRange args) {
+          Value extended =
+              b.create<arith::ExtUIOp>(nestedLoc, b.getI32Type(), args[1]);
+          Value weight =
+              b.create<arith::UIToFPOp>(nestedLoc, f32Type, extended);
+          Value zeroPoint =
+              b.create<arith::ExtFOp>(nestedLoc, f32Type, args[3]);
+          Value centered =
+              b.create<arith::SubFOp>(nestedLoc, weight, zeroPoint);
+          Value scale = b.create<arith::ExtFOp>(nestedLoc, f32Type, args[2]);
+          Value dequantized =
+              b.create<arith::MulFOp>(nestedLoc, centered, scale);
+          Value mul = b.create<arith::MulFOp>(nestedLoc, args[0], dequantized);
+          Value add = b.create<arith::AddFOp>(nestedLoc, mul, args[4]);
+          b.create<linalg::YieldOp>(nestedLoc, add);
+        });
+
+    SmallVector<OpFoldResult> outSizes = {rewriter.getIndexAttr(M),
+                                          rewriter.getIndexAttr(N)};
+    Value result = unsetEncodingAndExtractSlice(
+        rewriter, loc, encodedMatmulOp.getResult(0), outSizes);
+    if (isVecmat) {
+      result = rewriter.create<tensor::CollapseShapeOp>(
+          loc, outType, result, SmallVector<ReassociationIndices>{{0, 1}});
+    }
+    rewriter.replaceOp(matmulOp, result);
+    return success();
+  }
+
+private:
+  int64_t padFactor = 0;
+};
+
 /// Pattern to fold a `linalg.fill` -> `iree_encoding.set_encoding`
 /// operation into a `linalg.fill` of the encoded type.
 struct FoldFillWithSetEncoding
@@ -409,7 +653,8 @@ void SetEncodingPass::runOnOperation() {
   MLIRContext *context = &getContext();
   {
     RewritePatternSet patterns(context);
-    patterns.insert<setContractionOpEncoding>(context, padFactor);
+    patterns.insert<setContractionOpEncoding, SetGroupedDequantMatmulEncoding>(
+        context, padFactor);
     linalg::FillOp::getCanonicalizationPatterns(patterns, context);
     patterns.insert<FoldFillWithSetEncoding>(context);
     memref::populateResolveRankedShapedTypeResultDimsPatterns(patterns);
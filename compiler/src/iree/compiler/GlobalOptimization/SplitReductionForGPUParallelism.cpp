@@ -0,0 +1,141 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===- SplitReductionForGPUParallelism.cpp --------------------------------===//
+//
+// Splits the reduction dimension of contractions that produce too few output
+// tiles to occupy all workgroup processors of the targeted GPU.
+//
+//===----------------------------------------------------------------------===//
+
+#include "iree/compiler/Codegen/Dialect/GPU/IR/IREEGPUAttrs.h"
+#include "iree/compiler/Codegen/Utils/GPUUtils.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
+#include "iree/compiler/GlobalOptimization/PassDetail.h"
+#include "iree/compiler/GlobalOptimization/Passes.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MathExtras.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/Linalg/IR/LinalgInterfaces.h"
+#include "mlir/Dialect/Linalg/Transforms/Transforms.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/PatternMatch.h"
+
+#define DEBUG_TYPE "iree-global-opt-split-reduction-for-gpu-parallelism"
+
+namespace mlir::iree_compiler::GlobalOptimization {
+
+// Estimated number of output elements computed by each workgroup of a
+// contraction. Skinny contractions are distributed along their output
+// dimensions only so this bounds the number of workgroups they launch.
+static constexpr int64_t kOutputElementsPerWorkgroup = 256;
+
+// Minimum number of reduction elements each split must accumulate so that the
+// extra pass reducing the partial results remains cheap in comparison.
+static constexpr int64_t kMinReductionSizePerSplit = 256;
+
+// Upper bound on the split ratio to limit the size of the partial results.
+static constexpr int64_t kMaxSplitRatio = 64;
+
+namespace {
+
+/// Returns the ratio to split the reduction of |linalgOp| by so that the
+/// output tiles of all splits together occupy |wgpCount| workgroup processors,
+/// or 1 if it should not be split.
+static int64_t getSplitRatio(linalg::LinalgOp linalgOp, int64_t wgpCount) {
+  if (!linalg::isaContractionOpInterface(linalgOp) ||
+      linalgOp.getNumReductionLoops() != 1 || linalgOp.hasDynamicShape() ||
+      !linalgOp.hasPureTensorSemantics()) {
+    return 1;
+  }
+  int64_t outputElements = 1;
+  int64_t reductionSize = 1;
+  for (auto [range, iteratorType] :
+       llvm::zip_equal(linalgOp.getStaticLoopRanges(),
+                       linalgOp.getIteratorTypesArray())) {
+    if (linalg::isReductionIterator(iteratorType)) {
+      reductionSize = range;
+    } else {
+      outputElements *= range;
+    }
+  }
+  int64_t workgroupCount =
+      llvm::divideCeil(outputElements, kOutputElementsPerWorkgroup);
+  if (workgroupCount >= wgpCount)
+    return 1;
+  int64_t ratio = std::min<int64_t>(
+      llvm::PowerOf2Ceil(llvm::divideCeil(wgpCount, workgroupCount)),
+      kMaxSplitRatio);
+  while (ratio > 1 && (reductionSize % ratio != 0 ||
+                       reductionSize / ratio < kMinReductionSizePerSplit)) {
+    ratio /= 2;
+  }
+  return ratio;
+}
+
+struct SplitReductionForGPUParallelismPass
+    : public SplitReductionForGPUParallelismBase<
+          SplitReductionForGPUParallelismPass> {
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    // The number of workgroup processors is only known when compiling for a
+    // single GPU target describing its chip.
+    auto executableTargets =
+        IREE::HAL::DeviceTargetAttr::lookupExecutableTargets(moduleOp);
+    if (executableTargets.size() != 1)
+      return;
+    IREE::GPU::TargetAttr gpuTarget =
+        getGPUTargetAttr(executableTargets.front());
+    if (!gpuTarget || !gpuTarget.getChip())
+      return;
+    int64_t wgpCount = gpuTarget.getChip().getWgpCount();
+
+    SmallVector<linalg::LinalgOp> candidates;
+    moduleOp.walk([&](linalg::LinalgOp linalgOp) {
+      candidates.push_back(linalgOp);
+    });
+
+    IRRewriter rewriter(&getContext());
+    for (auto linalgOp : candidates) {
+      int64_t ratio = getSplitRatio(linalgOp, wgpCount);
+      if (ratio <= 1)
+        continue;
+      LLVM_DEBUG(llvm::dbgs() << "splitting reduction by " << ratio << ": "
+                              << linalgOp << "\n");
+
+      // Since user information about compilation are passed through
+      // attributes we need to make sure to propagate those.
+      SmallVector<NamedAttribute> prunedAttributeList =
+          linalg::getPrunedAttributeList(linalgOp);
+      // Make the new parallel dimension outermost so that the split
+      // contraction looks like a batched one.
+      rewriter.setInsertionPoint(linalgOp);
+      FailureOr<linalg::SplitReductionResult> result = linalg::splitReduction(
+          rewriter, linalgOp, [&](linalg::LinalgOp) {
+            return linalg::SplitReductionOptions{ratio, /*index=*/0,
+                                                 /*innerParallel=*/false};
+          });
+      if (failed(result))
+        continue;
+      result->splitLinalgOp->setAttrs(prunedAttributeList);
+    }
+  }
+};
+
+} // namespace
+
+std::unique_ptr<OperationPass<mlir::ModuleOp>>
+createSplitReductionForGPUParallelismPass() {
+  return std::make_unique<SplitReductionForGPUParallelismPass>();
+}
+
+} // namespace mlir::iree_compiler::GlobalOptimization
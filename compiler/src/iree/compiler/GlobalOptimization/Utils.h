@@ -19,6 +19,9 @@ class CastOpInterface;
 class OpBuilder;
 class Location;
 class NamedAttribute;
+namespace linalg {
+class GenericOp;
+} // namespace linalg
 } // namespace mlir
 
 namespace mlir::iree_compiler::GlobalOptimization {
@@ -50,6 +53,18 @@ Value createGenericElementwiseCastOp(
     ArrayRef<NamedAttribute> attrs,
     std::optional<IREE::Encoding::EncodingAttr> encoding = std::nullopt);
 
+/// Checks if the passed op is a dequantization on grouped input. The op must:
+/// 1. Have a body like:
+///      arith.extui
+///      arith.uitofp
+///      arith.subf
+///      arith.mulf
+/// 2. Increase the bit width of the input
+/// 3. Have 3 parallel dims
+/// 4. Have 2 (weights, scales) or 3 (weights, scales, zero points) inputs and
+///    1 output
+LogicalResult isGroupedDequantizationOp(linalg::GenericOp genericOp);
+
 /// Creates a dispatch region out of a sequence of consecutive ops.
 FailureOr<IREE::Flow::DispatchRegionOp>
 wrapConsecutiveOpsInDispatchRegion(RewriterBase &rewriter,
@@ -33,3 +33,55 @@ func.func @push_down_unpack_through_expand(%5: tensor<?x32x8x8xf32>, %dim: index
 // CHECK:         %[[EMPTY:.+]] = tensor.empty(%[[DIM]]) : tensor<?x256x256xf32>
 // CHECK:         %[[UNPACK:.+]] = tensor.unpack %[[EXPANDED:.+]] outer_dims_perm = [0, 1, 2] inner_dims_pos = [1, 2] inner_tiles = [8, 8] into %[[EMPTY]] : tensor<?x32x32x8x8xf32> -> tensor<?x256x256xf32>
 // CHECK:         return %[[UNPACK]] : tensor<?x256x256xf32>
+
+// -----
+
+func.func @push_down_unpack_through_elementwise(%arg0: tensor<16x32x8x8xf32>, %arg1: tensor<256xf32>) -> tensor<16x32x8x8xf32> {
+  %0 = tensor.empty() : tensor<128x256xf32>
+  %unpack = tensor.unpack %arg0 inner_dims_pos = [0, 1] inner_tiles = [8, 8] into %0 : tensor<16x32x8x8xf32> -> tensor<128x256xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%unpack, %arg1 : tensor<128x256xf32>, tensor<256xf32>) outs(%0 : tensor<128x256xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %2 = arith.addf %in, %in_0 : f32
+    linalg.yield %2 : f32
+  } -> tensor<128x256xf32>
+  %3 = tensor.empty() : tensor<16x32x8x8xf32>
+  %pack = tensor.pack %1 inner_dims_pos = [0, 1] inner_tiles = [8, 8] into %3 : tensor<128x256xf32> -> tensor<16x32x8x8xf32>
+  func.return %pack : tensor<16x32x8x8xf32>
+}
+// CHECK-LABEL: func.func @push_down_unpack_through_elementwise
+// CHECK-SAME:      %[[ARG0:[a-zA-Z0-9]+]]
+// CHECK-SAME:      %[[ARG1:[a-zA-Z0-9]+]]
+// CHECK-NOT:     tensor.unpack
+// CHECK:         %[[BIAS:.+]] = tensor.pack %[[ARG1]] inner_dims_pos = [0] inner_tiles = [8] into %{{.+}} : tensor<256xf32> -> tensor<32x8xf32>
+// CHECK:         %[[GENERIC:.+]] = linalg.generic
+// CHECK-SAME:      ins(%[[ARG0]], %[[BIAS]] : tensor<16x32x8x8xf32>, tensor<32x8xf32>)
+// CHECK-NOT:     tensor.unpack
+// CHECK-NOT:     tensor.pack
+// CHECK:         return %[[GENERIC]] : tensor<16x32x8x8xf32>
+
+// -----
+
+func.func @no_propagation_through_reduction_on_tiled_dim(%arg0: tensor<16x32x8x8xf32>) -> tensor<128xf32> {
+  %0 = tensor.empty() : tensor<128x256xf32>
+  %unpack = tensor.unpack %arg0 inner_dims_pos = [0, 1] inner_tiles = [8, 8] into %0 : tensor<16x32x8x8xf32> -> tensor<128x256xf32>
+  %cst = arith.constant 0.000000e+00 : f32
+  %1 = tensor.empty() : tensor<128xf32>
+  %2 = linalg.fill ins(%cst : f32) outs(%1 : tensor<128xf32>) -> tensor<128xf32>
+  %3 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%unpack : tensor<128x256xf32>) outs(%2 : tensor<128xf32>) {
+  ^bb0(%in: f32, %out: f32):
+    %4 = arith.addf %in, %out : f32
+    linalg.yield %4 : f32
+  } -> tensor<128xf32>
+  func.return %3 : tensor<128xf32>
+}
+// CHECK-LABEL: func.func @no_propagation_through_reduction_on_tiled_dim
+// CHECK-SAME:      %[[ARG0:[a-zA-Z0-9]+]]
+// CHECK:         %[[UNPACK:.+]] = tensor.unpack %[[ARG0]]
+// CHECK:         linalg.generic
+// CHECK-SAME:      ins(%[[UNPACK]] : tensor<128x256xf32>)
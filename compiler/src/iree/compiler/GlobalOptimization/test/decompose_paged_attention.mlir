@@ -0,0 +1,53 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(util.func(iree-global-opt-decompose-paged-attention, cse))" %s | FileCheck %s
+
+util.func public @paged_attention(%query: tensor<4x16x64xf16>, %key_cache: tensor<128x32x64xf16>, %value_cache: tensor<128x32x64xf16>, %block_table: tensor<4x8xi32>) -> tensor<4x16x64xf16> {
+  %0 = tensor.empty() : tensor<4x16x64xf16>
+  %scale = arith.constant 1.0 : f16
+  %1 = iree_linalg_ext.paged_attention ins(%query, %key_cache, %value_cache, %block_table, %scale : tensor<4x16x64xf16>, tensor<128x32x64xf16>, tensor<128x32x64xf16>, tensor<4x8xi32>, f16) outs(%0 : tensor<4x16x64xf16>) -> tensor<4x16x64xf16>
+  util.return %1 : tensor<4x16x64xf16>
+}
+// CHECK-LABEL: util.func public @paged_attention
+//  CHECK-SAME:   %[[QUERY:[a-zA-Z0-9_]+]]: tensor<4x16x64xf16>
+//  CHECK-SAME:   %[[KEY_CACHE:[a-zA-Z0-9_]+]]: tensor<128x32x64xf16>
+//  CHECK-SAME:   %[[VALUE_CACHE:[a-zA-Z0-9_]+]]: tensor<128x32x64xf16>
+//  CHECK-SAME:   %[[BLOCK_TABLE:[a-zA-Z0-9_]+]]: tensor<4x8xi32>
+//   CHECK-DAG:   %[[PAGE_SIZE:.+]] = arith.constant 32 : index
+//   CHECK-DAG:   %[[INIT:.+]] = tensor.empty() : tensor<4x256x64xf16>
+//       CHECK:   %[[KEY:.+]] = linalg.generic
+//  CHECK-SAME:       outs(%[[INIT]] : tensor<4x256x64xf16>)
+//   CHECK-DAG:     %[[BATCH:.+]] = linalg.index 0 : index
+//   CHECK-DAG:     %[[TOKEN:.+]] = linalg.index 1 : index
+//   CHECK-DAG:     %[[HEAD:.+]] = linalg.index 2 : index
+//       CHECK:     %[[TABLE_INDEX:.+]] = arith.divui %[[TOKEN]], %[[PAGE_SIZE]]
+//       CHECK:     %[[OFFSET:.+]] = arith.remui %[[TOKEN]], %[[PAGE_SIZE]]
+//       CHECK:     %[[PAGE_I32:.+]] = tensor.extract %[[BLOCK_TABLE]][%[[BATCH]], %[[TABLE_INDEX]]]
+//       CHECK:     %[[PAGE:.+]] = arith.index_cast %[[PAGE_I32]] : i32 to index
+//       CHECK:     %[[ELEMENT:.+]] = tensor.extract %[[KEY_CACHE]][%[[PAGE]], %[[OFFSET]], %[[HEAD]]]
+//       CHECK:     linalg.yield %[[ELEMENT]]
+//       CHECK:   %[[VALUE:.+]] = linalg.generic
+//  CHECK-SAME:       outs(%[[INIT]] : tensor<4x256x64xf16>)
+//       CHECK:     tensor.extract %[[VALUE_CACHE]]
+//       CHECK:   %[[RESULT:.+]] = iree_linalg_ext.attention
+//  CHECK-SAME:       ins(%[[QUERY]], %[[KEY]], %[[VALUE]], %{{.+}} :
+//       CHECK:   util.return %[[RESULT]]
+
+// -----
+
+util.func public @paged_attention_dynamic(%query: tensor<?x?x64xf32>, %key_cache: tensor<?x16x64xf32>, %value_cache: tensor<?x16x64xf32>, %block_table: tensor<?x?xindex>, %init: tensor<?x?x64xf32>) -> tensor<?x?x64xf32> {
+  %scale = arith.constant 1.0 : f32
+  %1 = iree_linalg_ext.paged_attention ins(%query, %key_cache, %value_cache, %block_table, %scale : tensor<?x?x64xf32>, tensor<?x16x64xf32>, tensor<?x16x64xf32>, tensor<?x?xindex>, f32) outs(%init : tensor<?x?x64xf32>) -> tensor<?x?x64xf32>
+  util.return %1 : tensor<?x?x64xf32>
+}
+//       CHECK: #[[$MAP:.+]] = affine_map<()[s0] -> (s0 * 16)>
+// CHECK-LABEL: util.func public @paged_attention_dynamic
+//  CHECK-SAME:   %[[BLOCK_TABLE:[a-zA-Z0-9_]+]]: tensor<?x?xindex>
+//   CHECK-DAG:   %[[BATCH_SIZE:.+]] = tensor.dim %[[BLOCK_TABLE]], %c0
+//   CHECK-DAG:   %[[PAGE_COUNT:.+]] = tensor.dim %[[BLOCK_TABLE]], %c1
+//       CHECK:   %[[SEQ_LENGTH:.+]] = affine.apply #[[$MAP]]()[%[[PAGE_COUNT]]]
+//       CHECK:   %[[INIT:.+]] = tensor.empty(%[[BATCH_SIZE]], %[[SEQ_LENGTH]]) : tensor<?x?x64xf32>
+//       CHECK:   linalg.generic
+//  CHECK-SAME:       outs(%[[INIT]] : tensor<?x?x64xf32>)
+//       CHECK:     %[[PAGE:.+]] = tensor.extract %[[BLOCK_TABLE]]
+//   CHECK-NOT:     arith.index_cast
+//       CHECK:     tensor.extract %{{.+}}[%[[PAGE]],
+//       CHECK:   iree_linalg_ext.attention
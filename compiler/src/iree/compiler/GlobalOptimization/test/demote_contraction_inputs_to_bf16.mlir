@@ -252,3 +252,53 @@ util.func public @conv_2d_nchw_fchw_f32f32f32(%arg0 : tensor<1x16x130x130xf32>,
 // CHECK:           } -> tensor<512x16x3x3xbf16>
 // CHECK:           %[[VAL_13:.*]] = linalg.conv_2d_nchw_fchw ins(%[[DEMOT1]], %[[DEMOT2]] : tensor<1x16x130x130xbf16>, tensor<512x16x3x3xbf16>)
 // CHECK-SAME:      outs(%[[VAL_2]] : tensor<1x512x128x128xf32>) -> tensor<1x512x128x128xf32>
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d1, d2)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+util.func public @generic_matmul_transpose_b_f32f32f32(%arg0 : tensor<100x250xf32>, %arg1 : tensor<500x250xf32>,
+    %arg2 : tensor<100x500xf32>) -> tensor<100x500xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map1, #map2], iterator_types = ["parallel", "parallel", "reduction"]}
+      ins(%arg0, %arg1 : tensor<100x250xf32>, tensor<500x250xf32>) outs(%arg2 : tensor<100x500xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %1 = arith.mulf %in, %in_0 : f32
+    %2 = arith.addf %out, %1 : f32
+    linalg.yield %2 : f32
+  } -> tensor<100x500xf32>
+  util.return %0 : tensor<100x500xf32>
+}
+
+// CHECK-LABEL: @generic_matmul_transpose_b_f32f32f32
+// CHECK-SAME: %[[ARG0:.+]]: tensor<100x250xf32>
+// CHECK-SAME: %[[ARG1:.+]]: tensor<500x250xf32>
+// CHECK-SAME: %[[ARG2:.+]]: tensor<100x500xf32>
+// CHECK: %[[DEMOTED0:.+]] = linalg.generic
+// CHECK-SAME: ins(%[[ARG0]] : tensor<100x250xf32>)
+// CHECK: arith.truncf {{.*}} : f32 to bf16
+// CHECK: %[[DEMOTED1:.+]] = linalg.generic
+// CHECK-SAME: ins(%[[ARG1]] : tensor<500x250xf32>)
+// CHECK: arith.truncf {{.*}} : f32 to bf16
+// CHECK: linalg.generic
+// CHECK-SAME: ins(%[[DEMOTED0]], %[[DEMOTED1]] : tensor<100x250xbf16>, tensor<500x250xbf16>)
+// CHECK-SAME: outs(%[[ARG2]] : tensor<100x500xf32>)
+// CHECK: ^bb0(%[[IN0:.+]]: bf16, %[[IN1:.+]]: bf16, %[[OUT:.+]]: f32):
+// CHECK-DAG:   %[[EXT0:.+]] = arith.extf %[[IN0]] : bf16 to f32
+// CHECK-DAG:   %[[EXT1:.+]] = arith.extf %[[IN1]] : bf16 to f32
+// CHECK:       %[[MUL:.+]] = arith.mulf %[[EXT0]], %[[EXT1]] : f32
+// CHECK:       %[[ADD:.+]] = arith.addf %[[OUT]], %[[MUL]] : f32
+// CHECK:       linalg.yield %[[ADD]] : f32
+
+// -----
+
+util.func public @softmax_f32_unchanged(%arg0 : tensor<100x500xf32>) -> tensor<100x500xf32> {
+  %0 = tensor.empty() : tensor<100x500xf32>
+  %1 = linalg.softmax dimension(1) ins(%arg0 : tensor<100x500xf32>) outs(%0 : tensor<100x500xf32>) -> tensor<100x500xf32>
+  util.return %1 : tensor<100x500xf32>
+}
+
+// CHECK-LABEL: @softmax_f32_unchanged
+// CHECK-NOT: arith.truncf
+// CHECK: linalg.softmax
+// CHECK-SAME: ins(%{{.+}} : tensor<100x500xf32>)
@@ -0,0 +1,79 @@
+// RUN: iree-opt --split-input-file --iree-global-opt-quantize-contraction-weights %s | FileCheck %s
+
+util.func public @matmul_constant_rhs(%arg0 : tensor<4x2xf32>) -> tensor<4x3xf32> {
+  %cst = arith.constant dense<[[1.0, -3.0, 0.25], [0.25, 4.0, -1.0]]> : tensor<2x3xf32>
+  %zero = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<4x3xf32>
+  %fill = linalg.fill ins(%zero : f32) outs(%empty : tensor<4x3xf32>) -> tensor<4x3xf32>
+  %0 = linalg.matmul ins(%arg0, %cst : tensor<4x2xf32>, tensor<2x3xf32>)
+      outs(%fill : tensor<4x3xf32>) -> tensor<4x3xf32>
+  util.return %0 : tensor<4x3xf32>
+}
+
+//   CHECK-DAG: #[[$IDENTITY:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//   CHECK-DAG: #[[$CHANNEL:.+]] = affine_map<(d0, d1) -> (d1)>
+// CHECK-LABEL: @matmul_constant_rhs
+//  CHECK-SAME: %[[ARG0:.+]]: tensor<4x2xf32>
+//   CHECK-DAG:   %[[VALUES:.+]] = arith.constant dense<{{\[}}[127, -95, 32], [32, 127, -127]]> : tensor<2x3xi8>
+//   CHECK-DAG:   %[[SCALES:.+]] = arith.constant dense<[{{.+}}]> : tensor<3xf32>
+//       CHECK:   %[[DEQUANT:.+]] = linalg.generic
+//  CHECK-SAME:       indexing_maps = [#[[$IDENTITY]], #[[$CHANNEL]], #[[$IDENTITY]]]
+//  CHECK-SAME:       ins(%[[VALUES]], %[[SCALES]] : tensor<2x3xi8>, tensor<3xf32>)
+//       CHECK:     %[[VALUE:.+]] = arith.sitofp %{{.+}} : i8 to f32
+//       CHECK:     %[[SCALED:.+]] = arith.mulf %[[VALUE]], %{{.+}} : f32
+//       CHECK:     linalg.yield %[[SCALED]]
+//       CHECK:   linalg.matmul
+//  CHECK-SAME:       ins(%[[ARG0]], %[[DEQUANT]] : tensor<4x2xf32>, tensor<2x3xf32>)
+
+// -----
+
+util.global private @weight = dense<[[1.0, 0.25], [-3.0, 4.0], [0.25, -1.0]]> : tensor<3x2xf32>
+
+util.func public @matmul_transpose_b_global_rhs(%arg0 : tensor<4x2xf32>, %arg1 : tensor<4x3xf32>) -> tensor<4x3xf32> {
+  %weight = util.global.load @weight : tensor<3x2xf32>
+  %0 = linalg.matmul_transpose_b ins(%arg0, %weight : tensor<4x2xf32>, tensor<3x2xf32>)
+      outs(%arg1 : tensor<4x3xf32>) -> tensor<4x3xf32>
+  util.return %0 : tensor<4x3xf32>
+}
+
+//   CHECK-DAG: #[[$IDENTITY:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//   CHECK-DAG: #[[$CHANNEL:.+]] = affine_map<(d0, d1) -> (d0)>
+//       CHECK: util.global private @weight_i8 = dense<{{\[}}[127, 32], [-95, 127], [32, -127]]> : tensor<3x2xi8>
+//       CHECK: util.global private @weight_scales = dense<[{{.+}}]> : tensor<3xf32>
+// CHECK-LABEL: @matmul_transpose_b_global_rhs
+//   CHECK-DAG:   %[[VALUES:.+]] = util.global.load @weight_i8 : tensor<3x2xi8>
+//   CHECK-DAG:   %[[SCALES:.+]] = util.global.load @weight_scales : tensor<3xf32>
+//       CHECK:   %[[DEQUANT:.+]] = linalg.generic
+//  CHECK-SAME:       indexing_maps = [#[[$IDENTITY]], #[[$CHANNEL]], #[[$IDENTITY]]]
+//  CHECK-SAME:       ins(%[[VALUES]], %[[SCALES]] : tensor<3x2xi8>, tensor<3xf32>)
+//       CHECK:   linalg.matmul_transpose_b
+//  CHECK-SAME:       ins(%{{.+}}, %[[DEQUANT]] : tensor<4x2xf32>, tensor<3x2xf32>)
+
+// -----
+
+util.global private mutable @mutable_weight = dense<[[1.0, 0.5], [-2.0, 4.0]]> : tensor<2x2xf32>
+
+util.func public @matmul_mutable_global_rhs(%arg0 : tensor<4x2xf32>, %arg1 : tensor<4x2xf32>) -> tensor<4x2xf32> {
+  %weight = util.global.load @mutable_weight : tensor<2x2xf32>
+  %0 = linalg.matmul ins(%arg0, %weight : tensor<4x2xf32>, tensor<2x2xf32>)
+      outs(%arg1 : tensor<4x2xf32>) -> tensor<4x2xf32>
+  util.return %0 : tensor<4x2xf32>
+}
+
+// CHECK-LABEL: @matmul_mutable_global_rhs
+//   CHECK-NOT:   arith.sitofp
+//       CHECK:   %[[WEIGHT:.+]] = util.global.load @mutable_weight
+//       CHECK:   linalg.matmul
+//  CHECK-SAME:       ins(%{{.+}}, %[[WEIGHT]] : tensor<4x2xf32>, tensor<2x2xf32>)
+
+// -----
+
+util.func public @matmul_argument_rhs(%arg0 : tensor<4x2xf32>, %arg1 : tensor<2x3xf32>, %arg2 : tensor<4x3xf32>) -> tensor<4x3xf32> {
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<4x2xf32>, tensor<2x3xf32>)
+      outs(%arg2 : tensor<4x3xf32>) -> tensor<4x3xf32>
+  util.return %0 : tensor<4x3xf32>
+}
+
+// CHECK-LABEL: @matmul_argument_rhs
+//   CHECK-NOT:   arith.sitofp
+//       CHECK:   linalg.matmul
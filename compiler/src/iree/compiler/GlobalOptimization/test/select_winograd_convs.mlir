@@ -0,0 +1,88 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(util.func(iree-global-opt-select-winograd-convs))" %s | FileCheck %s
+
+util.func public @conv_3x3_64x64(%input: tensor<1x34x34x64xf32>, %filter: tensor<3x3x64x64xf32>) -> tensor<1x32x32x64xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %empty = tensor.empty() : tensor<1x32x32x64xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<1x32x32x64xf32>) -> tensor<1x32x32x64xf32>
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x34x34x64xf32>, tensor<3x3x64x64xf32>)
+    outs(%fill : tensor<1x32x32x64xf32>) -> tensor<1x32x32x64xf32>
+  util.return %0 : tensor<1x32x32x64xf32>
+}
+// CHECK-LABEL: util.func public @conv_3x3_64x64(
+//       CHECK:   iree_linalg_ext.winograd.filter_transform output_tile_size(4) kernel_size(3)
+//  CHECK-SAME:     -> tensor<6x6x64x64xf32>
+//       CHECK:   iree_linalg_ext.winograd.input_transform output_tile_size(4) kernel_size(3)
+//  CHECK-SAME:     -> tensor<6x6x1x8x8x64xf32>
+//       CHECK:   linalg.batch_matmul
+//  CHECK-SAME:     -> tensor<36x64x64xf32>
+//       CHECK:   iree_linalg_ext.winograd.output_transform output_tile_size(4) kernel_size(3)
+//  CHECK-SAME:     -> tensor<1x32x32x64xf32>
+//   CHECK-NOT:   linalg.conv_2d_nhwc_hwcf
+
+// -----
+
+util.func public @conv_3x3_nchw_64x64(%input: tensor<1x64x34x34xf16>, %filter: tensor<64x64x3x3xf16>) -> tensor<1x64x32x32xf16> {
+  %cst = arith.constant 0.000000e+00 : f16
+  %empty = tensor.empty() : tensor<1x64x32x32xf16>
+  %fill = linalg.fill ins(%cst : f16) outs(%empty : tensor<1x64x32x32xf16>) -> tensor<1x64x32x32xf16>
+  %0 = linalg.conv_2d_nchw_fchw
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x64x34x34xf16>, tensor<64x64x3x3xf16>)
+    outs(%fill : tensor<1x64x32x32xf16>) -> tensor<1x64x32x32xf16>
+  util.return %0 : tensor<1x64x32x32xf16>
+}
+// CHECK-LABEL: util.func public @conv_3x3_nchw_64x64(
+//       CHECK:   iree_linalg_ext.winograd.filter_transform output_tile_size(4)
+//       CHECK:   iree_linalg_ext.winograd.input_transform output_tile_size(4)
+//       CHECK:   linalg.batch_matmul
+//       CHECK:   iree_linalg_ext.winograd.output_transform output_tile_size(4)
+//   CHECK-NOT:   linalg.conv_2d_nchw_fchw
+
+// -----
+
+// Too few channels for the transforms to pay off.
+util.func public @conv_3x3_few_channels(%input: tensor<1x16x16x4xf32>, %filter: tensor<3x3x4x16xf32>) -> tensor<1x14x14x16xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %empty = tensor.empty() : tensor<1x14x14x16xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<1x14x14x16xf32>) -> tensor<1x14x14x16xf32>
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x16x16x4xf32>, tensor<3x3x4x16xf32>)
+    outs(%fill : tensor<1x14x14x16xf32>) -> tensor<1x14x14x16xf32>
+  util.return %0 : tensor<1x14x14x16xf32>
+}
+// CHECK-LABEL: util.func public @conv_3x3_few_channels(
+//   CHECK-NOT:   iree_linalg_ext.winograd
+//       CHECK:   linalg.conv_2d_nhwc_hwcf
+
+// -----
+
+util.func public @conv_3x3_stride_2(%input: tensor<1x65x65x64xf32>, %filter: tensor<3x3x64x64xf32>) -> tensor<1x32x32x64xf32> {
+  %cst = arith.constant 0.000000e+00 : f32
+  %empty = tensor.empty() : tensor<1x32x32x64xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<1x32x32x64xf32>) -> tensor<1x32x32x64xf32>
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<2> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x65x65x64xf32>, tensor<3x3x64x64xf32>)
+    outs(%fill : tensor<1x32x32x64xf32>) -> tensor<1x32x32x64xf32>
+  util.return %0 : tensor<1x32x32x64xf32>
+}
+// CHECK-LABEL: util.func public @conv_3x3_stride_2(
+//   CHECK-NOT:   iree_linalg_ext.winograd
+//       CHECK:   linalg.conv_2d_nhwc_hwcf
+
+// -----
+
+// The winograd rewrite does not accumulate into the output.
+util.func public @conv_3x3_accumulate(%input: tensor<1x34x34x64xf32>, %filter: tensor<3x3x64x64xf32>, %init: tensor<1x32x32x64xf32>) -> tensor<1x32x32x64xf32> {
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>}
+     ins(%input, %filter : tensor<1x34x34x64xf32>, tensor<3x3x64x64xf32>)
+    outs(%init : tensor<1x32x32x64xf32>) -> tensor<1x32x32x64xf32>
+  util.return %0 : tensor<1x32x32x64xf32>
+}
+// CHECK-LABEL: util.func public @conv_3x3_accumulate(
+//   CHECK-NOT:   iree_linalg_ext.winograd
+//       CHECK:   linalg.conv_2d_nhwc_hwcf
@@ -1381,3 +1381,124 @@ util.func public @multi_batch_dim_generic(%arg0 : tensor<4x8x256x128xf32>, %arg1
 //      CHECK:   linalg.generic
 // CHECK-SAME:      ins(%{{.*}}, %{{.*}} : tensor<4x8x256x128xf32>, tensor<4x8x128x512xf32>)
 // CHECK-SAME:      outs(%{{.*}} : tensor<4x8x256x512xf32>)
+
+// -----
+
+util.func public @grouped_dequant_vecmat_f32u4f16f32(%arg0 : tensor<4x16xf32>, %arg1 : tensor<32x4x16xi4>,
+    %arg2 : tensor<32x4xf16>, %arg3 : tensor<32x4xf16>, %arg4 : tensor<32xf32>) -> tensor<32xf32> {
+  %0 = tensor.empty() : tensor<32x4x16xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1, d2)>],
+      iterator_types = ["parallel", "parallel", "parallel"]}
+      ins(%arg1, %arg2, %arg3 : tensor<32x4x16xi4>, tensor<32x4xf16>, tensor<32x4xf16>) outs(%0 : tensor<32x4x16xf32>) {
+  ^bb0(%in: i4, %in_0: f16, %in_1: f16, %out: f32):
+    %3 = arith.extui %in : i4 to i32
+    %4 = arith.uitofp %3 : i32 to f32
+    %5 = arith.extf %in_1 : f16 to f32
+    %6 = arith.subf %4, %5 : f32
+    %7 = arith.extf %in_0 : f16 to f32
+    %8 = arith.mulf %6, %7 : f32
+    linalg.yield %8 : f32
+  } -> tensor<32x4x16xf32>
+  %2 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2) -> (d1, d2)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                       affine_map<(d0, d1, d2) -> (d0)>],
+      iterator_types = ["parallel", "reduction", "reduction"]}
+      ins(%arg0, %1 : tensor<4x16xf32>, tensor<32x4x16xf32>) outs(%arg4 : tensor<32xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %3 = arith.mulf %in, %in_0 : f32
+    %4 = arith.addf %3, %out : f32
+    linalg.yield %4 : f32
+  } -> tensor<32xf32>
+  util.return %2 : tensor<32xf32>
+}
+
+//  CHECK-DAG: #[[MAP1:.+]] = affine_map<(d0, d1, d2) -> (d0, d2)>
+//  CHECK-DAG: #[[MAP2:.+]] = affine_map<(d0, d1, d2) -> (d1, d2)>
+//  CHECK-DAG: #[[MAP3:.+]] = affine_map<(d0, d1, d2) -> (d0, d1)>
+//  CHECK-DAG: #[[SCALES_MAP:.+]] = affine_map<(d0, d1, d2) -> (d1, d2 floordiv 16)>
+//      CHECK: util.func public @grouped_dequant_vecmat_f32u4f16f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<4x16xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<32x4x16xi4>
+// CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<32x4xf16>
+// CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<32x4xf16>
+// CHECK-SAME:     %[[ARG4:[a-zA-Z0-9]+]]: tensor<32xf32>
+//  CHECK-DAG:   %[[LHS_COLLAPSED:.+]] = tensor.collapse_shape %[[ARG0]] {{\[}}[0, 1]] : tensor<4x16xf32> into tensor<64xf32>
+//  CHECK-DAG:   %[[LHS_2D:.+]] = tensor.expand_shape %[[LHS_COLLAPSED]] {{\[}}[0, 1]]
+//  CHECK-DAG:   %[[RHS_2D:.+]] = tensor.collapse_shape %[[ARG1]] {{\[}}[0], [1, 2]] : tensor<32x4x16xi4> into tensor<32x64xi4>
+//  CHECK-DAG:   %[[OUT_2D:.+]] = tensor.expand_shape %[[ARG4]] {{\[}}[0, 1]]
+//      CHECK:   %[[LHS:.+]] = iree_encoding.set_encoding
+// CHECK-SAME:       #iree_encoding.encoding<role = LHS, element_types = [f32, ui4, f32, f16], original_type = tensor<1x64xf32>, matmul_narrow_M = 1 : index, user_indexing_maps = [#[[MAP1]], #[[MAP2]], #[[MAP3]]]>>
+//      CHECK:   %[[RHS:.+]] = iree_encoding.set_encoding
+// CHECK-SAME:       #iree_encoding.encoding<role = RHS, element_types = [f32, ui4, f32, f16], original_type = tensor<32x64xi4>, matmul_narrow_M = 1 : index, user_indexing_maps = [#[[MAP1]], #[[MAP2]], #[[MAP3]]]>>
+//      CHECK:   %[[SCALES:.+]] = iree_encoding.set_encoding
+// CHECK-SAME:       #iree_encoding.encoding<role = RHS_SCALES, element_types = [f32, ui4, f32, f16], original_type = tensor<32x4xf16>, matmul_narrow_M = 1 : index, user_indexing_maps = [#[[MAP1]], #[[MAP2]], #[[MAP3]]]>>
+//      CHECK:   %[[ZERO_POINTS:.+]] = iree_encoding.set_encoding
+// CHECK-SAME:       #iree_encoding.encoding<role = RHS_SCALES, element_types = [f32, ui4, f32, f16], original_type = tensor<32x4xf16>, matmul_narrow_M = 1 : index, user_indexing_maps = [#[[MAP1]], #[[MAP2]], #[[MAP3]]]>>
+//      CHECK:   %[[OUT:.+]] = iree_encoding.set_encoding
+// CHECK-SAME:       #iree_encoding.encoding<role = RESULT, element_types = [f32, ui4, f32, f16], original_type = tensor<1x32xf32>, matmul_narrow_M = 1 : index, user_indexing_maps = [#[[MAP1]], #[[MAP2]], #[[MAP3]]]>>
+//      CHECK:   %[[MATMUL:.+]] = linalg.generic
+// CHECK-SAME:       indexing_maps = [#[[MAP1]], #[[MAP2]], #[[SCALES_MAP]], #[[SCALES_MAP]], #[[MAP3]]]
+// CHECK-SAME:       iterator_types = ["parallel", "parallel", "reduction"]
+// CHECK-SAME:       ins(%[[LHS]], %[[RHS]], %[[SCALES]], %[[ZERO_POINTS]] :
+// CHECK-SAME:       outs(%[[OUT]] :
+//      CHECK:     arith.extui
+//      CHECK:     arith.uitofp
+//      CHECK:     arith.subf
+//      CHECK:     arith.mulf
+//      CHECK:     arith.mulf
+//      CHECK:     arith.addf
+//      CHECK:   %[[RESULT_PADDED:.+]] = iree_encoding.unset_encoding %[[MATMUL]]
+//      CHECK:   %[[RESULT_2D:.+]] = tensor.extract_slice %[[RESULT_PADDED]][0, 0] [1, 32] [1, 1]
+//      CHECK:   %[[RESULT:.+]] = tensor.collapse_shape %[[RESULT_2D]] {{\[}}[0, 1]] : tensor<1x32xf32> into tensor<32xf32>
+//      CHECK:   util.return %[[RESULT]]
+
+// PAD-WITHIN-ENCODING-LABEL: util.func public @grouped_dequant_vecmat_f32u4f16f32(
+//       PAD-WITHIN-ENCODING:   iree_encoding.set_encoding {{.+}} tensor<32x4xf16, #iree_encoding.encoding<role = RHS_SCALES, element_types = [f32, ui4, f32, f16], original_type = tensor<32x4xf16>, matmul_narrow_M = 1 : index, user_indexing_maps = [{{.+}}], round_dims_to = array<i64: 16, 16, 16>>>
+//       PAD-WITHIN-ENCODING:   linalg.generic
+//  PAD-WITHIN-ENCODING-SAME:       iterator_types = ["parallel", "parallel", "reduction"]
+
+// -----
+
+util.func public @grouped_dequant_vecmat_f32_scales(%arg0 : tensor<4x16xf32>, %arg1 : tensor<32x4x16xi4>,
+    %arg2 : tensor<32x4xf32>, %arg3 : tensor<32x4xf32>, %arg4 : tensor<32xf32>) -> tensor<32xf32> {
+  %0 = tensor.empty() : tensor<32x4x16xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1, d2)>],
+      iterator_types = ["parallel", "parallel", "parallel"]}
+      ins(%arg1, %arg2, %arg3 : tensor<32x4x16xi4>, tensor<32x4xf32>, tensor<32x4xf32>) outs(%0 : tensor<32x4x16xf32>) {
+  ^bb0(%in: i4, %in_0: f32, %in_1: f32, %out: f32):
+    %3 = arith.extui %in : i4 to i32
+    %4 = arith.uitofp %3 : i32 to f32
+    %5 = arith.subf %4, %in_1 : f32
+    %6 = arith.mulf %5, %in_0 : f32
+    linalg.yield %6 : f32
+  } -> tensor<32x4x16xf32>
+  %2 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1, d2) -> (d1, d2)>,
+                       affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                       affine_map<(d0, d1, d2) -> (d0)>],
+      iterator_types = ["parallel", "reduction", "reduction"]}
+      ins(%arg0, %1 : tensor<4x16xf32>, tensor<32x4x16xf32>) outs(%arg4 : tensor<32xf32>) {
+  ^bb0(%in: f32, %in_0: f32, %out: f32):
+    %3 = arith.mulf %in, %in_0 : f32
+    %4 = arith.addf %3, %out : f32
+    linalg.yield %4 : f32
+  } -> tensor<32xf32>
+  util.return %2 : tensor<32xf32>
+}
+
+// The mmt4d_dequant ukernel only takes f16 and bf16 scales and zero points.
+//      CHECK: util.func public @grouped_dequant_vecmat_f32_scales(
+//  CHECK-NOT:   iree_encoding.set_encoding
+//      CHECK:   linalg.generic
+// CHECK-SAME:       ins(%{{.*}}, %{{.*}}, %{{.*}} : tensor<32x4x16xi4>, tensor<32x4xf32>, tensor<32x4xf32>)
+//      CHECK:   linalg.generic
+// CHECK-SAME:       ins(%{{.*}}, %{{.*}} : tensor<4x16xf32>, tensor<32x4x16xf32>)
@@ -0,0 +1,64 @@
+// RUN: iree-opt --split-input-file --iree-global-opt-split-reduction-for-gpu-parallelism %s | FileCheck %s
+
+#executable_target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {
+  iree.gpu.target = #iree_gpu.target<arch = "gfx942", features = "",
+    wgp = <compute = fp16|fp32|int8, storage = b16|b32,
+      subgroup = shuffle|arithmetic, dot = dp4xi8toi32,
+      mma = [<MFMA_F16_16x16x16_F32>],
+      subgroup_size_choices = [64], max_workgroup_sizes = [1024, 1024, 1024],
+      max_thread_count_per_workgroup = 1024,
+      max_workgroup_memory_bytes = 65536>,
+    chip = <wgp_count = 304>>}>
+#device_target = #hal.device.target<"rocm", [#executable_target]>
+
+// A 4x4096x16384 matmul has 64 output tiles for 304 workgroup processors and
+// is split by 8 so that each split still reduces over 2048 elements.
+
+module attributes {hal.device.targets = [#device_target]} {
+  // CHECK-LABEL: util.func public @skinny_matmul
+  util.func public @skinny_matmul(%lhs: tensor<4x16384xf16>, %rhs: tensor<16384x4096xf16>) -> tensor<4x4096xf32> {
+    %cst = arith.constant 0.0 : f32
+    %empty = tensor.empty() : tensor<4x4096xf32>
+    %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<4x4096xf32>) -> tensor<4x4096xf32>
+    //      CHECK: %[[LHS:.+]] = tensor.expand_shape %{{.+}} {{\[}}[0], [1, 2]] output_shape [4, 8, 2048]
+    //      CHECK: %[[RHS:.+]] = tensor.expand_shape %{{.+}} {{\[}}[0, 1], [2]] output_shape [8, 2048, 4096]
+    //      CHECK: %[[PARTIAL:.+]] = linalg.generic
+    // CHECK-SAME:     ins(%[[LHS]], %[[RHS]] : tensor<4x8x2048xf16>, tensor<8x2048x4096xf16>)
+    // CHECK-SAME:     outs(%{{.+}} : tensor<8x4x4096xf32>)
+    //      CHECK: %[[RESULT:.+]] = linalg.generic
+    // CHECK-SAME:     iterator_types = ["reduction", "parallel", "parallel"]
+    // CHECK-SAME:     ins(%[[PARTIAL]] : tensor<8x4x4096xf32>)
+    //      CHECK: util.return %[[RESULT]]
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<4x16384xf16>, tensor<16384x4096xf16>) outs(%fill : tensor<4x4096xf32>) -> tensor<4x4096xf32>
+    util.return %0 : tensor<4x4096xf32>
+  }
+
+  // Contractions that already occupy the device are left unchanged.
+
+  // CHECK-LABEL: util.func public @large_matmul
+  util.func public @large_matmul(%lhs: tensor<512x16384xf16>, %rhs: tensor<16384x4096xf16>) -> tensor<512x4096xf32> {
+    %cst = arith.constant 0.0 : f32
+    %empty = tensor.empty() : tensor<512x4096xf32>
+    %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<512x4096xf32>) -> tensor<512x4096xf32>
+    //  CHECK-NOT: tensor.expand_shape
+    //      CHECK: linalg.matmul
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<512x16384xf16>, tensor<16384x4096xf16>) outs(%fill : tensor<512x4096xf32>) -> tensor<512x4096xf32>
+    util.return %0 : tensor<512x4096xf32>
+  }
+}
+
+// -----
+
+// Targets without chip information are not split.
+
+#executable_target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64", {target_triple = "x86_64-none-elf"}>
+#device_target = #hal.device.target<"llvm-cpu", [#executable_target]>
+module attributes {hal.device.targets = [#device_target]} {
+  // CHECK-LABEL: util.func public @cpu_matmul
+  util.func public @cpu_matmul(%lhs: tensor<4x16384xf32>, %rhs: tensor<16384x4096xf32>, %acc: tensor<4x4096xf32>) -> tensor<4x4096xf32> {
+    //  CHECK-NOT: tensor.expand_shape
+    //      CHECK: linalg.matmul
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<4x16384xf32>, tensor<16384x4096xf32>) outs(%acc : tensor<4x4096xf32>) -> tensor<4x4096xf32>
+    util.return %0 : tensor<4x4096xf32>
+  }
+}
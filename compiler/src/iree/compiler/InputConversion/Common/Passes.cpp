@@ -8,6 +8,9 @@
 
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
 #include "iree/compiler/Dialect/Util/Transforms/Passes.h"
+#include "iree/compiler/Modules/IO/Parameters/Transforms/Passes.h"
+#include "mlir/Dialect/Func/IR/FuncOps.h"
+#include "mlir/Dialect/Mesh/Transforms/Passes.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Pass/PassOptions.h"
@@ -22,10 +25,37 @@ namespace {
 
 void buildCommonInputConversionPassPipeline(
     OpPassManager &passManager, const TransformOptions &transformOptions) {
+  // Shardings are propagated and the program partitioned while it is still
+  // made of func.func ops as the mesh sharding interfaces are only
+  // implemented on upstream ops. The collectives inserted are lowered to flow
+  // below.
+  if (transformOptions.options.meshSpmdization) {
+    passManager.addNestedPass<func::FuncOp>(mesh::createShardingPropagation());
+    passManager.addNestedPass<func::FuncOp>(mesh::createSpmdization());
+  }
+
   passManager.addPass(createIREEImportPublicPass());
   passManager.addPass(createImportMLProgramPass());
   passManager.addPass(createSanitizeModuleNamesPass());
 
+  // Spill large constants to a parameter archive as early as possible so
+  // that their data is not held (and duplicated) by the compiler during the
+  // rest of compilation.
+  if (!transformOptions.options.parameterExportPath.empty()) {
+    IREE::Flow::OutlineConstantsPassOptions outlineConstantsOptions;
+    outlineConstantsOptions.minimumSize =
+        transformOptions.options.parameterExportMinimumSize;
+    passManager.addPass(
+        IREE::Flow::createOutlineConstantsPass(outlineConstantsOptions));
+    IREE::IO::Parameters::ExportParametersPassOptions exportParametersOptions;
+    exportParametersOptions.scopePath =
+        transformOptions.options.parameterExportPath;
+    exportParametersOptions.minimumSize =
+        transformOptions.options.parameterExportMinimumSize;
+    passManager.addPass(IREE::IO::Parameters::createExportParametersPass(
+        exportParametersOptions));
+  }
+
   // TODO: this pass should either live in InputConversion or be run in flow -
   // it's a mistake that it's here.
   passManager.addPass(IREE::Flow::createConvertMeshToFlowPass());
@@ -0,0 +1,42 @@
+// RUN: iree-compile --compile-to=input --iree-input-mesh-spmdization --split-input-file %s | FileCheck %s
+
+// Tests that an argument sharded across a 1D mesh is partitioned into its
+// per-device shard and gathered back with a collective on the default channel
+// when the result is replicated.
+
+mesh.mesh @mesh_1d(shape = 2)
+
+// CHECK-LABEL: util.func public @replicate_sharded_argument
+// CHECK-SAME: (%[[ARG:.+]]: tensor<1xf32>) -> tensor<2xf32>
+func.func @replicate_sharded_argument(%arg0: tensor<2xf32>) -> tensor<2xf32> {
+  //  CHECK-DAG: %[[CHANNEL:.+]] = flow.channel.default : !flow.channel
+  //  CHECK-DAG: %[[INIT:.+]] = tensor.empty() : tensor<2xf32>
+  //      CHECK: %[[GATHER:.+]] = flow.collective.all_gather f32, %[[INIT]], %[[ARG]], %[[CHANNEL]]
+  // CHECK-SAME:     (tensor<2xf32>, tensor<1xf32>, !flow.channel) -> %[[INIT]] as tensor<2xf32>
+  %0 = mesh.shard %arg0 to <@mesh_1d, [[0]]> : tensor<2xf32>
+  %1 = mesh.shard %0 to <@mesh_1d, [[0]]> annotate_for_users : tensor<2xf32>
+  %2 = mesh.shard %1 to <@mesh_1d, [[]]> : tensor<2xf32>
+  //      CHECK: util.return %[[GATHER]] : tensor<2xf32>
+  return %2 : tensor<2xf32>
+}
+
+// -----
+
+// Tests that a collective over one axis of a 2D mesh is bound to the channel
+// created for that axis.
+
+mesh.mesh @mesh_2d(shape = 2x2)
+
+// CHECK-LABEL: util.func public @replicate_on_mesh_axis
+// CHECK-SAME: (%[[ARG:.+]]: tensor<2x4xf32>) -> tensor<4x4xf32>
+func.func @replicate_on_mesh_axis(%arg0: tensor<4x4xf32>) -> tensor<4x4xf32> {
+  //  CHECK-DAG: %[[CHANNEL:.+]] = util.global.load @_mesh_mesh_2d_axes_1 : !flow.channel
+  //  CHECK-DAG: %[[INIT:.+]] = tensor.empty() : tensor<4x4xf32>
+  //      CHECK: %[[GATHER:.+]] = flow.collective.all_gather f32, %[[INIT]], %[[ARG]], %[[CHANNEL]]
+  // CHECK-SAME:     (tensor<4x4xf32>, tensor<2x4xf32>, !flow.channel) -> %[[INIT]] as tensor<4x4xf32>
+  %0 = mesh.shard %arg0 to <@mesh_2d, [[1]]> : tensor<4x4xf32>
+  %1 = mesh.shard %0 to <@mesh_2d, [[1]]> annotate_for_users : tensor<4x4xf32>
+  %2 = mesh.shard %1 to <@mesh_2d, [[]]> : tensor<4x4xf32>
+  //      CHECK: util.return %[[GATHER]] : tensor<4x4xf32>
+  return %2 : tensor<4x4xf32>
+}
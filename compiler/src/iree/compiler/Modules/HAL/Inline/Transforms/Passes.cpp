@@ -64,7 +64,9 @@ void buildHALInlineStaticTransformPassPipeline(
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
       IREE::HAL::createConfigureExecutablesPass({targetRegistry}));
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-      IREE::HAL::createTranslateExecutablesPass({targetRegistry}));
+      IREE::HAL::createTranslateExecutablesPass(
+          {targetRegistry, targetOptions.printExecutableTimings,
+           targetOptions.executableCachePath}));
 
   // Inline the translated executable functions.
   // We preserve the executables for their metadata used during conversion.
@@ -69,7 +69,9 @@ void buildHALInlineDynamicTransformPassPipeline(
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
       IREE::HAL::createConfigureExecutablesPass({targetRegistry}));
   passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-      IREE::HAL::createTranslateExecutablesPass({targetRegistry}));
+      IREE::HAL::createTranslateExecutablesPass(
+          {targetRegistry, targetOptions.printExecutableTimings,
+           targetOptions.executableCachePath}));
 
   //----------------------------------------------------------------------------
   // Conversion
@@ -94,7 +96,9 @@ void buildHALInlineDynamicTransformPassPipeline(
       IREE::HAL::createSerializeExecutablesPass(
           {&targetRegistry, targetOptions.debugLevel,
            targetOptions.executableIntermediatesPath,
-           targetOptions.executableBinariesPath}));
+           targetOptions.executableBinariesPath,
+           targetOptions.printExecutableTimings,
+           targetOptions.executableCachePath}));
 
   // NOTE: symbol DCE will destroy executable target contents.
   passManager.addPass(mlir::createSymbolDCEPass());
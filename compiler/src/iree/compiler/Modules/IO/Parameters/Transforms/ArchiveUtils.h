@@ -46,6 +46,13 @@ private:
   iree_io_stream_t *stream = NULL;
 };
 
+// Discardable attribute set on imported globals recording the source
+// parameter and the imported value. Globals still holding the imported value
+// when exporting can reference the source parameter again instead of being
+// written to the new archive.
+static constexpr StringLiteral kSourceParameterAttrName =
+    "iree.io.source_parameter";
+
 using ScopePath = std::pair<StringRef, StringRef>;
 
 // Splits a `scope=path` string into two strings.
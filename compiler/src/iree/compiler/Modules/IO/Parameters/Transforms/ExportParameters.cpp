@@ -11,11 +11,15 @@
 #include "iree/compiler/Modules/IO/Parameters/Transforms/ArchiveUtils.h"
 #include "iree/compiler/Modules/IO/Parameters/Transforms/Passes.h"
 #include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileOutputBuffer.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/AttrTypeSubElements.h"
+#include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Support/FileUtilities.h"
 
@@ -64,6 +68,29 @@ addDataEntry(IREE::Util::GlobalOpInterface globalOp,
       "failed to add data entry for global");
 }
 
+// Restores the source parameter of |globalOp| if it was imported and still
+// holds the imported value. Returns true if the global references its source
+// parameter again and must not be exported.
+static bool restoreSourceParameter(IREE::Util::GlobalOpInterface globalOp,
+                                   bool transformedOnly) {
+  auto sourceAttr =
+      globalOp->getAttrOfType<DictionaryAttr>(kSourceParameterAttrName);
+  if (!sourceAttr)
+    return false;
+  globalOp->removeAttr(kSourceParameterAttrName);
+  if (!transformedOnly)
+    return false;
+  auto parameterAttr =
+      sourceAttr.getAs<IREE::Flow::NamedParameterAttr>("parameter");
+  if (!parameterAttr ||
+      sourceAttr.get("value") != globalOp.getGlobalInitialValue() ||
+      parameterAttr.getType() != globalOp.getGlobalType()) {
+    return false;
+  }
+  globalOp.setGlobalInitialValue(parameterAttr);
+  return true;
+}
+
 // Adds an entry to the parameter archive builder for the given global.
 // If the global is mutable we allocate archive storage for the full
 // serialized parameter. This allows the parameter to be mapped for
@@ -81,6 +108,26 @@ static LogicalResult addEntry(IREE::Util::GlobalOpInterface globalOp,
   return addDataEntry(globalOp, valueAttr, valueAttr.getStorageSize(), builder);
 }
 
+// Releases the data of the resource blobs in |blobEntries| that are no longer
+// referenced from |moduleOp| now that their contents live in the archive.
+// Frontends often deliver weights as dense_resource elements and without
+// releasing them the compiler keeps a copy of every exported parameter alive.
+static void releaseUnreferencedResources(
+    ModuleOp moduleOp,
+    SmallPtrSetImpl<DialectResourceBlobManager::BlobEntry *> &blobEntries) {
+  if (blobEntries.empty())
+    return;
+  moduleOp->walk([&](Operation *op) {
+    for (NamedAttribute namedAttr : op->getAttrs()) {
+      namedAttr.getValue().walk([&](DenseResourceElementsAttr resourceAttr) {
+        blobEntries.erase(resourceAttr.getRawHandle().getResource());
+      });
+    }
+  });
+  for (auto *blobEntry : blobEntries)
+    blobEntry->setBlob(AsmResourceBlob());
+}
+
 struct ExportParametersPass
     : public IREE::IO::Parameters::impl::ExportParametersPassBase<
           ExportParametersPass> {
@@ -104,6 +151,11 @@ struct ExportParametersPass
     // Accumulate globals that match the pass options and add them to the index.
     SmallVector<IREE::Util::GlobalOpInterface> constantGlobalOps;
     for (auto globalOp : moduleOp.getOps<IREE::Util::GlobalOpInterface>()) {
+      // Parameters imported only to be transformed at compile time stay in
+      // their source archive when they are used unmodified.
+      if (restoreSourceParameter(globalOp, transformedOnly))
+        continue;
+
       // Only globals initialized with serializable initial values can be
       // parameterized.
       auto serializableAttr =
@@ -137,6 +189,7 @@ struct ExportParametersPass
     auto [file, stream, index] = *std::move(fileStreamIndexOr);
 
     // Serialize parameters to the file.
+    SmallPtrSet<DialectResourceBlobManager::BlobEntry *, 8> exportedBlobEntries;
     for (auto globalOp : constantGlobalOps) {
       // Lookup the entry in the index corresponding to the global.
       const iree_io_parameter_index_entry_t *entry = nullptr;
@@ -174,6 +227,11 @@ struct ExportParametersPass
       }
 
       // Change the global to reference the parameter.
+      if (auto resourceAttr = dyn_cast<DenseResourceElementsAttr>(
+              globalOp.getGlobalInitialValue())) {
+        if (auto *blobEntry = resourceAttr.getRawHandle().getResource())
+          exportedBlobEntries.insert(blobEntry);
+      }
       globalOp.setGlobalInitialValue(IREE::Flow::NamedParameterAttr::get(
           context, globalOp.getGlobalType(), StringAttr::get(context, scope),
           StringAttr::get(context, name), DictionaryAttr()));
@@ -189,6 +247,8 @@ struct ExportParametersPass
                             });
       return signalPassFailure();
     }
+
+    releaseUnreferencedResources(moduleOp, exportedBlobEntries);
   }
 };
 
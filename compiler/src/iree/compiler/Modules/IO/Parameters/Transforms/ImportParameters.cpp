@@ -354,6 +354,19 @@ struct ImportParametersPass
 
         // Replace the initial value with the constant.
         globalOp.setGlobalInitialValue(*valueOr);
+        if (keepSourceReferences) {
+          MLIRContext *context = &getContext();
+          globalOp->setAttr(
+              kSourceParameterAttrName,
+              DictionaryAttr::get(
+                  context,
+                  {
+                      NamedAttribute(StringAttr::get(context, "parameter"),
+                                     parameterAttr),
+                      NamedAttribute(StringAttr::get(context, "value"),
+                                     *valueOr),
+                  }));
+        }
       }
     }
   }
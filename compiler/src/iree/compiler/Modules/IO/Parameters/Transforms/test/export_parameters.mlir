@@ -40,3 +40,18 @@ util.global private mutable @mutable_dense_2xf32 = dense<[11.0, 12.0]> : tensor<
 // CHECK-NEXT: util.global private mutable @mutable_splat_2xf32 = #flow.parameter.named<"opt"::"mutable_splat_2xf32"> : tensor<2xf32>
 //  DUMP-NEXT: {{[0-9]+}} | {{[0-9]+}} | 8 | `mutable_splat_2xf32`
 util.global private mutable @mutable_splat_2xf32 = dense<11.0> : tensor<2xf32>
+
+// CHECK-NEXT: util.global private @constant_resource_2xf32 = #flow.parameter.named<"opt"::"constant_resource_2xf32"> : tensor<2xf32>
+//  DUMP-NEXT: {{[0-9]+}} | {{[0-9]+}} | 8 | `constant_resource_2xf32`
+util.global private @constant_resource_2xf32 = dense_resource<blob> : tensor<2xf32>
+
+// The exported resource data is released and no longer part of the module.
+// CHECK-NOT: dialect_resources
+
+{-#
+  dialect_resources: {
+    builtin: {
+      blob: "0x040000000000304100004041"
+    }
+  }
+#-}
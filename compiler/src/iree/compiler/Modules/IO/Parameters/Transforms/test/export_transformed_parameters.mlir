@@ -0,0 +1,15 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(iree-io-generate-splat-parameter-archive{file="%t.src.irpa"})" %s -o /dev/null
+// RUN: iree-opt --pass-pipeline="builtin.module(iree-io-import-parameters{paths="src=%t.src.irpa" keep-source-references=true},iree-io-export-parameters{path="opt=%t.irpa" minimum-size=0 transformed-only=true})" %s | FileCheck %s
+// RUN: iree-dump-parameters --parameters=%t.irpa | FileCheck %s --check-prefix=DUMP
+
+// Imported parameters that are used unmodified reference the source archive.
+//      CHECK: util.global private @weight = #flow.parameter.named<"src"::"weight"> : tensor<8xf32>
+//  DUMP-NOT: `weight`
+util.global private @weight = #flow.parameter.named<"src"::"weight"> : tensor<8xf32>
+
+// Values computed at compile time (for example packed weights) are exported.
+// CHECK-NEXT: util.global private @packed = #flow.parameter.named<"opt"::"packed"> : tensor<2x4xf32>
+//       DUMP: {{[0-9]+}} | {{[0-9]+}} | 32 | `packed`
+util.global private @packed = dense<[[1.0, 2.0, 3.0, 4.0], [5.0, 6.0, 7.0, 8.0]]> : tensor<2x4xf32>
+
+// CHECK-NOT: iree.io.source_parameter
@@ -84,6 +84,27 @@ void InputDialectOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc("Converts all bf16 ops and values into f32 counterparts "
                      "unconditionally before main global optimizations."),
       llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-input-mesh-spmdization", meshSpmdization,
+      llvm::cl::desc(
+          "Propagates the tensor shardings annotated with mesh.shard ops and "
+          "partitions the program into the per-device SPMD program inserting "
+          "the required collectives."),
+      llvm::cl::cat(category));
+
+  binder.opt<std::string>(
+      "iree-input-export-parameters", parameterExportPath,
+      llvm::cl::desc(
+          "File path to an archive to export large constants to during input "
+          "conversion with an optional `scope=` prefix. The constants are "
+          "replaced with parameter references and their data released before "
+          "any other transformation runs."),
+      llvm::cl::cat(category));
+  binder.opt<int64_t>(
+      "iree-input-export-parameter-minimum-size", parameterExportMinimumSize,
+      llvm::cl::desc("Minimum size in bytes of constants to export to the "
+                     "archive created with `iree-input-export-parameters`."),
+      llvm::cl::cat(category));
 }
 
 InputDialectOptions::Type InputDialectOptions::parseInputTypeMnemonic() {
@@ -158,6 +179,25 @@ void GlobalOptimizationOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Reduces numeric precision to lower bit depths where possible."),
       llvm::cl::cat(category));
+  binder.opt<PrecisionPolicy>(
+      "iree-opt-precision-policy", precisionPolicy,
+      llvm::cl::desc("Lowers the precision of contractions (matmuls and "
+                     "convolutions) where the change in results is accepted."),
+      llvm::cl::values(
+          clEnumValN(PrecisionPolicy::None, "none",
+                     "Contractions keep the precision of the program."),
+          clEnumValN(PrecisionPolicy::BF16Matmul, "bf16-matmul",
+                     "Demotes f32 contraction inputs to bf16 while keeping f32 "
+                     "accumulation."),
+          clEnumValN(PrecisionPolicy::Int8Weights, "int8-weights",
+                     "Quantizes large f32 constant contraction weights to i8 "
+                     "with per-channel scales.")),
+      llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-opt-precision-report", precisionReport,
+      llvm::cl::desc("Emits a remark for each op changed by "
+                     "--iree-opt-precision-policy."),
+      llvm::cl::cat(category));
   binder.opt<bool>("iree-opt-strip-assertions", stripAssertions,
                    llvm::cl::desc("Strips debug assertions after any useful "
                                   "information has been extracted."),
@@ -188,6 +228,14 @@ void GlobalOptimizationOptions::bindOptions(OptionsBinder &binder) {
           "Minimum size of constants to export to the archive created in "
           "`iree-opt-export-parameter-archive-export-file`."),
       llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-opt-export-transformed-parameters", parameterExportTransformedOnly,
+      llvm::cl::desc(
+          "Imports all parameters from `iree-opt-import-parameters` so that "
+          "const-eval can transform them (e.g. pack them for data tiling) and "
+          "only exports the transformed ones to `iree-opt-export-parameters`. "
+          "Parameters used unmodified keep referencing their source archive."),
+      llvm::cl::cat(category));
 
   binder.opt<std::string>(
       "iree-opt-splat-parameters", parameterSplatExportFile,
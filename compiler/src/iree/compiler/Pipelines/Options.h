@@ -57,6 +57,19 @@ struct InputDialectOptions {
   bool promoteF16ToF32 = false;
   bool promoteBF16ToF32 = false;
 
+  // Completes the tensor shardings annotated with mesh.shard ops and
+  // partitions the program into the per-device program before the mesh
+  // collectives are lowered to flow.
+  bool meshSpmdization = false;
+
+  // File path to an archive to export large constants to during input
+  // conversion with an optional `scope=` prefix. Exporting them before any
+  // other transformation keeps the weights of large models out of the
+  // compiler's memory.
+  std::string parameterExportPath;
+  // Minimum size of constants to export as parameters during input conversion.
+  int64_t parameterExportMinimumSize = 4096;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<InputDialectOptions>;
 };
@@ -97,6 +110,22 @@ struct GlobalOptimizationOptions {
   // Optimizations to reduce numeric precision where it is safe to do so.
   bool numericPrecisionReduction = false;
 
+  // Policy for automatically lowering the precision of contractions.
+  enum class PrecisionPolicy {
+    // Contractions keep the precision of the input program.
+    None = 0,
+    // Demotes f32 inputs of contractions to bf16 while accumulating in f32.
+    BF16Matmul = 1,
+    // Quantizes large f32 constant contraction weights to i8 with per-channel
+    // scales and dequantizes them at their use.
+    Int8Weights = 2,
+  };
+  // Precision policy applied to contractions. Unlike numeric precision
+  // reduction this changes program results and is opt-in.
+  PrecisionPolicy precisionPolicy = PrecisionPolicy::None;
+  // Emits a remark for each op whose precision is changed by the policy.
+  bool precisionReport = false;
+
   // Strips debug assertions after any useful information has been extracted.
   bool stripAssertions = false;
 
@@ -118,6 +147,10 @@ struct GlobalOptimizationOptions {
   std::string parameterExportPath;
   // Minimum size of constants to export as parameters.
   int64_t parameterExportMinimumSize = 0;
+  // Only exports the parameters transformed at compile time (e.g. packed by
+  // data tiling and const-eval). Imported parameters used unmodified keep
+  // referencing their source archive.
+  bool parameterExportTransformedOnly = false;
 
   // File path to create a splat parameter archive out of all parameters in the
   // module.
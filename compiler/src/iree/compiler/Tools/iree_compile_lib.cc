@@ -139,6 +139,14 @@ int mlir::iree_compiler::runIreecMain(int argc, char **argv) {
       llvm::cl::desc("Dumps IR at the end of each compilation phase to the "
                      "given directory."));
 
+  llvm::cl::opt<bool> compileStatistics(
+      "iree-compile-statistics",
+      llvm::cl::desc("Prints the wall time and peak memory usage of each "
+                     "compilation phase, the size of constant data held by "
+                     "the module and the time spent in each pass aggregated "
+                     "over all operations it ran on."),
+      llvm::cl::init(false));
+
   llvm::cl::opt<bool> emitMLIRBytecode(
       "emit-mlir-bytecode",
       llvm::cl::desc(
@@ -245,6 +253,7 @@ int mlir::iree_compiler::runIreecMain(int argc, char **argv) {
     ireeCompilerInvocationSetDumpCompilationPhasesTo(
         r.inv, dumpCompilationPhasesTo.c_str());
     ireeCompilerInvocationSetVerifyIR(r.inv, verifyIR);
+    ireeCompilerInvocationSetCompileStatistics(r.inv, compileStatistics);
     if (!ireeCompilerInvocationParseSource(r.inv, source))
       return false;
 
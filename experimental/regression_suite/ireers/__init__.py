@@ -6,7 +6,12 @@
 
 from .fixtures import (
     fetch_source_fixture,
+    local_source_fixture,
     iree_compile,
     iree_benchmark_module,
     iree_run_module,
 )
+from .perf import (
+    BenchmarkMeasurement,
+    iree_benchmark_module_measure,
+)
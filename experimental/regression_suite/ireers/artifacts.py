@@ -80,6 +80,21 @@ class Artifact:
         return str(self.path)
 
 
+class LocalArtifact(Artifact):
+    """An artifact that already exists on disk, such as a source in the repo.
+
+    Products derived from it are placed in its group directory.
+    """
+
+    def __init__(self, group: Union[ArtifactGroup, str], local_path: Path):
+        super().__init__(group, local_path.name)
+        self.local_path = local_path
+
+    @property
+    def path(self) -> Path:
+        return self.local_path
+
+
 class ProducedArtifact(Artifact):
     def __init__(
         self,
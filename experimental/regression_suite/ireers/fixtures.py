@@ -14,6 +14,7 @@ import time
 from .artifacts import (
     Artifact,
     FetchedArtifact,
+    LocalArtifact,
     ProducedArtifact,
 )
 
@@ -35,6 +36,14 @@ def fetch_source_fixture(url: str, *, group: str):
     return fetcher
 
 
+def local_source_fixture(path: Union[str, Path], *, group: str):
+    @pytest.fixture
+    def loader() -> LocalArtifact:
+        return LocalArtifact(group, Path(path).resolve())
+
+    return loader
+
+
 def iree_compile(source: Artifact, compiled_variant: str, flags: Sequence[str]):
     name = Path(source.name).with_suffix(f".{compiled_variant}.vmfb")
 
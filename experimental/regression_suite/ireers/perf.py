@@ -0,0 +1,308 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+"""Performance regression checking against stored baselines.
+
+Performance tests run `iree-benchmark-module` with repetitions, take the
+median latency and the peak resident memory of the benchmark process, and
+compare them against a baseline recorded for the target and machine. A
+measurement regresses when it exceeds the baseline by more than a relative
+tolerance plus a multiple of the observed noise (the larger of the baseline and
+current standard deviations) so that noisy benchmarks do not flake.
+
+Baselines are JSON files named `<target>_<machine>.json` mapping benchmark
+names to their recorded measurements. They are (re)written by running with
+`--update-perf-baselines` and are expected to be checked in.
+
+This module is registered as a pytest plugin by the package and provides the
+command line options and the `perf_baselines` fixture.
+"""
+
+from typing import Dict, Optional, Sequence
+from dataclasses import asdict, dataclass
+from pathlib import Path
+import json
+import os
+import platform
+import subprocess
+import sys
+import tempfile
+
+import pytest
+
+from .artifacts import Artifact
+
+DEFAULT_BASELINES_DIR = Path(__file__).resolve().parent.parent / "baselines"
+
+_TIME_UNIT_TO_MS = {
+    "ns": 1e-6,
+    "us": 1e-3,
+    "ms": 1.0,
+    "s": 1e3,
+}
+
+
+@dataclass
+class BenchmarkMeasurement:
+    """Aggregated results of a benchmarked function."""
+
+    # Median wall time of a single call.
+    latency_ms: float
+    # Standard deviation of the wall time across repetitions.
+    latency_stddev_ms: float
+    # Peak resident set size of the benchmark process. This is host memory
+    # only and includes the runtime and the loaded module.
+    peak_memory_mib: float
+    repetitions: int
+
+    def __str__(self):
+        return (
+            f"{self.latency_ms:.3f}ms (+/- {self.latency_stddev_ms:.3f}ms), "
+            f"{self.peak_memory_mib:.1f}MiB peak"
+        )
+
+
+def _parse_benchmark_json(contents: str) -> Dict[str, float]:
+    """Returns the median and stddev aggregates of the first benchmark."""
+    aggregates = {}
+    for benchmark in json.loads(contents).get("benchmarks", []):
+        aggregate_name = benchmark.get("aggregate_name")
+        if aggregate_name not in ("mean", "median", "stddev"):
+            continue
+        if aggregate_name in aggregates:
+            continue
+        scale = _TIME_UNIT_TO_MS[benchmark.get("time_unit", "ns")]
+        aggregates[aggregate_name] = float(benchmark["real_time"]) * scale
+    if "median" not in aggregates:
+        raise RuntimeError("benchmark output did not contain a median aggregate")
+    return aggregates
+
+
+def _run_and_measure_peak_memory(exec_args: Sequence[str], cwd: Path):
+    """Runs a process and returns its stdout and peak RSS in MiB.
+
+    The peak RSS is only available on POSIX platforms and is 0 elsewhere.
+    """
+    with tempfile.TemporaryFile() as stdout_file:
+        process = subprocess.Popen(exec_args, cwd=cwd, stdout=stdout_file)
+        peak_memory_mib = 0.0
+        if hasattr(os, "wait4"):
+            # Reap the process ourselves to get its own resource usage: the
+            # RUSAGE_CHILDREN totals would include earlier compiler runs.
+            _, wait_status, rusage = os.wait4(process.pid, 0)
+            process.returncode = os.waitstatus_to_exitcode(wait_status)
+            # Reported in bytes on macOS and kilobytes elsewhere.
+            divisor = 1024 * 1024 if sys.platform == "darwin" else 1024
+            peak_memory_mib = rusage.ru_maxrss / divisor
+        else:
+            process.wait()
+        stdout_file.seek(0)
+        stdout = stdout_file.read()
+    if process.returncode != 0:
+        raise subprocess.CalledProcessError(process.returncode, exec_args, stdout)
+    return stdout.decode(), peak_memory_mib
+
+
+def iree_benchmark_module_measure(
+    vmfb: Artifact,
+    *,
+    device,
+    function,
+    args: Sequence[str] = (),
+    repetitions: int = 5,
+) -> BenchmarkMeasurement:
+    """Benchmarks |function| and returns its aggregated measurement."""
+    vmfb.join()
+    exec_args = [
+        "iree-benchmark-module",
+        f"--device={device}",
+        f"--module={vmfb.path}",
+        f"--function={function}",
+        "--benchmark_format=json",
+        f"--benchmark_repetitions={repetitions}",
+        "--benchmark_report_aggregates_only=true",
+    ]
+    exec_args.extend(args)
+    print("**************************************************************")
+    print("Exec:", " ".join(exec_args))
+    stdout, peak_memory_mib = _run_and_measure_peak_memory(
+        exec_args, vmfb.group.directory
+    )
+    aggregates = _parse_benchmark_json(stdout)
+    return BenchmarkMeasurement(
+        latency_ms=aggregates["median"],
+        latency_stddev_ms=aggregates.get("stddev", 0.0),
+        peak_memory_mib=peak_memory_mib,
+        repetitions=repetitions,
+    )
+
+
+class PerfBaselines:
+    """Baselines of one target and machine loaded from a JSON file."""
+
+    def __init__(
+        self,
+        path: Path,
+        *,
+        update: bool,
+        latency_tolerance: float,
+        memory_tolerance: float,
+        noise_sigmas: float,
+    ):
+        self.path = path
+        self.update = update
+        self.latency_tolerance = latency_tolerance
+        self.memory_tolerance = memory_tolerance
+        self.noise_sigmas = noise_sigmas
+        self.baselines: Dict[str, BenchmarkMeasurement] = {}
+        self.dirty = False
+        if path.exists():
+            with open(path, "r") as f:
+                for name, values in json.load(f).items():
+                    self.baselines[name] = BenchmarkMeasurement(**values)
+
+    def save(self):
+        if not self.dirty:
+            return
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        contents = {
+            name: asdict(self.baselines[name]) for name in sorted(self.baselines)
+        }
+        with open(self.path, "w") as f:
+            json.dump(contents, f, indent=2)
+            f.write("\n")
+        print(f"Wrote performance baselines to {self.path}")
+
+    def latency_threshold_ms(
+        self, baseline: BenchmarkMeasurement, measurement: BenchmarkMeasurement
+    ) -> float:
+        noise_ms = max(baseline.latency_stddev_ms, measurement.latency_stddev_ms)
+        return (
+            baseline.latency_ms * (1.0 + self.latency_tolerance)
+            + self.noise_sigmas * noise_ms
+        )
+
+    def memory_threshold_mib(self, baseline: BenchmarkMeasurement) -> float:
+        return baseline.peak_memory_mib * (1.0 + self.memory_tolerance)
+
+    def check(self, name: str, measurement: BenchmarkMeasurement):
+        """Fails the calling test if |measurement| regressed from the baseline.
+
+        In update mode the measurement is recorded as the new baseline instead.
+        """
+        print(f"Benchmark {name}: {measurement}")
+        baseline: Optional[BenchmarkMeasurement] = self.baselines.get(name)
+        if self.update:
+            self.baselines[name] = measurement
+            self.dirty = True
+            return
+        if baseline is None:
+            pytest.skip(
+                f"no performance baseline for '{name}' in {self.path}; run with "
+                f"--update-perf-baselines to record one"
+            )
+        print(f"  baseline: {baseline}")
+
+        regressions = []
+        latency_threshold_ms = self.latency_threshold_ms(baseline, measurement)
+        if measurement.latency_ms > latency_threshold_ms:
+            regressions.append(
+                f"latency {measurement.latency_ms:.3f}ms exceeds "
+                f"{latency_threshold_ms:.3f}ms (baseline "
+                f"{baseline.latency_ms:.3f}ms)"
+            )
+        memory_threshold_mib = self.memory_threshold_mib(baseline)
+        if baseline.peak_memory_mib > 0 and (
+            measurement.peak_memory_mib > memory_threshold_mib
+        ):
+            regressions.append(
+                f"peak memory {measurement.peak_memory_mib:.1f}MiB exceeds "
+                f"{memory_threshold_mib:.1f}MiB (baseline "
+                f"{baseline.peak_memory_mib:.1f}MiB)"
+            )
+        if regressions:
+            pytest.fail(
+                f"performance regression in '{name}': " + "; ".join(regressions)
+            )
+
+
+class PerfBaselinesRegistry:
+    """Lazily loads the baselines of each target for the session."""
+
+    def __init__(self, config):
+        self.baselines_dir = Path(config.getoption("perf_baselines_dir"))
+        self.machine = config.getoption("perf_machine") or platform.machine()
+        self.update = config.getoption("update_perf_baselines")
+        self.latency_tolerance = config.getoption("perf_latency_tolerance")
+        self.memory_tolerance = config.getoption("perf_memory_tolerance")
+        self.noise_sigmas = config.getoption("perf_noise_sigmas")
+        self.targets: Dict[str, PerfBaselines] = {}
+
+    def __getitem__(self, target: str) -> PerfBaselines:
+        baselines = self.targets.get(target)
+        if baselines is None:
+            baselines = PerfBaselines(
+                self.baselines_dir / f"{target}_{self.machine}.json",
+                update=self.update,
+                latency_tolerance=self.latency_tolerance,
+                memory_tolerance=self.memory_tolerance,
+                noise_sigmas=self.noise_sigmas,
+            )
+            self.targets[target] = baselines
+        return baselines
+
+    def save(self):
+        for baselines in self.targets.values():
+            baselines.save()
+
+
+def pytest_addoption(parser):
+    group = parser.getgroup("ireers performance")
+    group.addoption(
+        "--perf-baselines-dir",
+        default=str(DEFAULT_BASELINES_DIR),
+        help="Directory containing the performance baseline JSON files.",
+    )
+    group.addoption(
+        "--perf-machine",
+        default="",
+        help="Name of the machine class the baselines are recorded for "
+        "(defaults to the host architecture). CI runners should set this so "
+        "that baselines of different hardware are kept apart.",
+    )
+    group.addoption(
+        "--update-perf-baselines",
+        action="store_true",
+        default=False,
+        help="Records the measurements as the new baselines instead of "
+        "checking them.",
+    )
+    group.addoption(
+        "--perf-latency-tolerance",
+        type=float,
+        default=0.05,
+        help="Allowed relative latency increase over the baseline.",
+    )
+    group.addoption(
+        "--perf-memory-tolerance",
+        type=float,
+        default=0.05,
+        help="Allowed relative peak memory increase over the baseline.",
+    )
+    group.addoption(
+        "--perf-noise-sigmas",
+        type=float,
+        default=3.0,
+        help="Number of latency standard deviations allowed on top of the "
+        "relative tolerance.",
+    )
+
+
+@pytest.fixture(scope="session")
+def perf_baselines(request):
+    registry = PerfBaselinesRegistry(request.config)
+    yield registry
+    registry.save()
@@ -22,4 +22,8 @@ setup(
         "tqdm",
     ],
     extras_require={},
+    entry_points={
+        # Provides the performance baseline options and fixtures.
+        "pytest11": ["ireers_perf = ireers.perf"],
+    },
 )
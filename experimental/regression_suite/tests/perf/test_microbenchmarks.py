@@ -0,0 +1,143 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from pathlib import Path
+
+import pytest
+from ireers import *
+
+###############################################################################
+# Fixtures
+###############################################################################
+
+REPO_ROOT = Path(__file__).resolve().parents[4]
+MICROBENCHMARKS_DIR = REPO_ROOT / "tests" / "microbenchmarks"
+
+HOST_CPU_FLAGS = [
+    "--iree-input-type=stablehlo",
+    "--iree-hal-target-backends=llvm-cpu",
+    "--iree-llvmcpu-target-cpu-features=host",
+]
+
+linalg_matmul_i8_source = local_source_fixture(
+    MICROBENCHMARKS_DIR / "linalg_matmul_i8.mlir",
+    group="microbenchmarks_linalg_matmul_i8",
+)
+
+linalg_mmt4d_source = local_source_fixture(
+    MICROBENCHMARKS_DIR / "linalg_mmt4d.mlir",
+    group="microbenchmarks_linalg_mmt4d",
+)
+
+dynamic_shape_vectorization_source = local_source_fixture(
+    MICROBENCHMARKS_DIR / "dynamic_shape_vectorization.mlir",
+    group="microbenchmarks_dynamic_shape_vectorization",
+)
+
+
+@pytest.fixture
+def linalg_matmul_i8_host_cpu_vmfb(linalg_matmul_i8_source):
+    return iree_compile(linalg_matmul_i8_source, "host_cpu", flags=HOST_CPU_FLAGS)
+
+
+@pytest.fixture
+def linalg_matmul_i8_host_cpu_data_tiling_vmfb(linalg_matmul_i8_source):
+    return iree_compile(
+        linalg_matmul_i8_source,
+        "host_cpu_data_tiling",
+        flags=HOST_CPU_FLAGS
+        + [
+            "--iree-opt-data-tiling",
+            "--iree-llvmcpu-enable-ukernels=all",
+        ],
+    )
+
+
+@pytest.fixture
+def linalg_mmt4d_host_cpu_vmfb(linalg_mmt4d_source):
+    return iree_compile(linalg_mmt4d_source, "host_cpu", flags=HOST_CPU_FLAGS)
+
+
+@pytest.fixture
+def dynamic_shape_vectorization_host_cpu_vmfb(dynamic_shape_vectorization_source):
+    return iree_compile(
+        dynamic_shape_vectorization_source, "host_cpu", flags=HOST_CPU_FLAGS
+    )
+
+
+###############################################################################
+# Performance
+###############################################################################
+
+
+@pytest.mark.perf
+@pytest.mark.plat_host_cpu
+@pytest.mark.parametrize(
+    "function",
+    [
+        "matmul_i8i8i32_384x384x512",
+        "matmul_i8i8i32_1x2048x2048",
+    ],
+)
+def test_perf_matmul_i8_host_cpu(
+    linalg_matmul_i8_host_cpu_vmfb,
+    linalg_matmul_i8_host_cpu_data_tiling_vmfb,
+    perf_baselines,
+    function,
+):
+    for variant, vmfb in [
+        ("default", linalg_matmul_i8_host_cpu_vmfb),
+        ("data_tiling", linalg_matmul_i8_host_cpu_data_tiling_vmfb),
+    ]:
+        perf_baselines["host_cpu"].check(
+            f"linalg_matmul_i8.{variant}.{function}",
+            iree_benchmark_module_measure(
+                vmfb, device="local-task", function=function
+            ),
+        )
+
+
+@pytest.mark.perf
+@pytest.mark.plat_host_cpu
+@pytest.mark.parametrize(
+    "function",
+    [
+        "matmul_384x384x512",
+        "mmt4d_384x384x512_4x1x4",
+        "mmt4d_384x384x512_8x1x8",
+    ],
+)
+def test_perf_mmt4d_host_cpu(linalg_mmt4d_host_cpu_vmfb, perf_baselines, function):
+    perf_baselines["host_cpu"].check(
+        f"linalg_mmt4d.{function}",
+        iree_benchmark_module_measure(
+            linalg_mmt4d_host_cpu_vmfb, device="local-task", function=function
+        ),
+    )
+
+
+@pytest.mark.perf
+@pytest.mark.plat_host_cpu
+@pytest.mark.parametrize(
+    "function",
+    [
+        "dynamic_matmul",
+        "dynamic_matmul_small_tails",
+        "dynamic_batch_matmul",
+        "dynamic_elw",
+    ],
+)
+def test_perf_dynamic_shape_vectorization_host_cpu(
+    dynamic_shape_vectorization_host_cpu_vmfb, perf_baselines, function
+):
+    perf_baselines["host_cpu"].check(
+        f"dynamic_shape_vectorization.{function}",
+        iree_benchmark_module_measure(
+            dynamic_shape_vectorization_host_cpu_vmfb,
+            device="local-task",
+            function=function,
+        ),
+    )
@@ -171,6 +171,39 @@ def test_step_host_cpu_stripped(llama2_7b_f16qi4_stripped_host_cpu_vmfb):
     )
 
 
+@pytest.mark.perf
+@pytest.mark.unstable_linalg
+@pytest.mark.plat_host_cpu
+def test_perf_step_host_cpu_stripped(
+    llama2_7b_f16qi4_stripped_host_cpu_vmfb, perf_baselines
+):
+    perf_baselines["host_cpu"].check(
+        "llama2_7b_f16qi4_stripped.first_vicuna_forward",
+        iree_benchmark_module_measure(
+            llama2_7b_f16qi4_stripped_host_cpu_vmfb,
+            device="local-task",
+            function="first_vicuna_forward",
+            args=[
+                "--input=1x1xi64",
+            ],
+            repetitions=3,
+        ),
+    )
+    perf_baselines["host_cpu"].check(
+        "llama2_7b_f16qi4_stripped.second_vicuna_forward",
+        iree_benchmark_module_measure(
+            llama2_7b_f16qi4_stripped_host_cpu_vmfb,
+            device="local-task",
+            function="second_vicuna_forward",
+            args=[
+                "--input=1x1xi64",
+            ]
+            + (["--input=1x32x1x128xf16"] * 64),
+            repetitions=3,
+        ),
+    )
+
+
 @pytest.mark.presubmit
 @pytest.mark.unstable_linalg
 @pytest.mark.plat_nvidia_a100
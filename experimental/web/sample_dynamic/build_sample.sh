@@ -65,6 +65,8 @@ compile_sample() {
     --iree-hal-target-backends=llvm-cpu \
     --iree-llvmcpu-target-triple=wasm32-unknown-emscripten \
     --iree-llvmcpu-target-cpu-features=+atomics,+bulk-memory,+simd128 \
+    --iree-opt-data-tiling \
+    --iree-llvmcpu-enable-ukernels=all \
     --o "${BINARY_DIR}/$1.vmfb"
 }
 
@@ -4,8 +4,6 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
-#include <emscripten/threading.h>
-
 #include "iree/hal/drivers/local_task/task_device.h"
 #include "iree/hal/local/loaders/static_library_loader.h"
 #include "iree/task/api.h"
@@ -32,13 +30,21 @@ iree_status_t create_device_with_static_loader(iree_allocator_t host_allocator,
   options.worker_local_memory_size = 0;
   iree_task_topology_t topology;
   iree_task_topology_initialize(&topology);
-  iree_task_topology_initialize_from_group_count(
-      /*group_count=*/4, &topology);
-  // Note: threads increase memory usage. If using a high thread count, consider
-  // passing in a larger WebAssembly.Memory object, increasing Emscripten's
-  // INITIAL_MEMORY, or setting Emscripten's ALLOW_MEMORY_GROWTH.
-  // iree_task_topology_initialize_from_group_count(
-  //     /*group_count=*/emscripten_num_logical_cores(), &topology);
+  // One worker per physical core as guessed from navigator.hardwareConcurrency,
+  // falling back to a single worker if SharedArrayBuffer is unavailable.
+  // Note: threads increase memory usage. If raising the core count limit,
+  // consider passing in a larger WebAssembly.Memory object, increasing
+  // Emscripten's INITIAL_MEMORY, or setting Emscripten's ALLOW_MEMORY_GROWTH.
+  iree_status_t topology_status =
+      iree_task_topology_initialize_from_physical_cores(
+          IREE_TASK_TOPOLOGY_NODE_ID_ANY,
+          IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY, /*max_core_count=*/4,
+          &topology);
+  if (iree_status_is_ok(status)) {
+    status = topology_status;
+  } else {
+    iree_status_ignore(topology_status);
+  }
   iree_task_executor_t* executor = NULL;
   if (iree_status_is_ok(status)) {
     status = iree_task_executor_create(options, &topology, host_allocator,
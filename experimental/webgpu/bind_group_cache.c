@@ -14,13 +14,32 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/math.h"
 
+static_assert(IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY <
+                  IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX,
+              "entry indices must fit in uint16_t");
+static_assert((IREE_HAL_WEBGPU_BIND_GROUP_CACHE_BUCKET_COUNT &
+               (IREE_HAL_WEBGPU_BIND_GROUP_CACHE_BUCKET_COUNT - 1)) == 0,
+              "bucket count must be a power of two");
+
+// Sets |cache| to an empty state with no entries populated.
+static void iree_hal_webgpu_bind_group_cache_reset(
+    iree_hal_webgpu_bind_group_cache_t* cache) {
+  cache->entry_count = 0;
+  cache->lru_head = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+  cache->lru_tail = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(cache->buckets); ++i) {
+    cache->buckets[i] = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+  }
+}
+
 void iree_hal_webgpu_bind_group_cache_initialize(
     WGPUDevice device, iree_hal_webgpu_bind_group_cache_t* out_cache) {
   IREE_ASSERT_ARGUMENT(out_cache);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  memset(out_cache, 0, sizeof(*out_cache));
   out_cache->device = device;
-  out_cache->entry_count = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY;
+  iree_hal_webgpu_bind_group_cache_reset(out_cache);
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -32,7 +51,6 @@ void iree_hal_webgpu_bind_group_cache_deinitialize(
 
   // Trim is the same as deinit today.
   iree_hal_webgpu_bind_group_cache_trim(cache);
-  cache->entry_count = 0;
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -47,10 +65,114 @@ void iree_hal_webgpu_bind_group_cache_trim(
     if (entry->handle) iree_wgpuBindGroupDrop(entry->handle);
   }
   memset(cache->entries, 0, sizeof(cache->entries));
+  iree_hal_webgpu_bind_group_cache_reset(cache);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Mixes |value| into the FNV-1a |hash|.
+static inline uint32_t iree_hal_webgpu_bind_group_hash_u64(uint32_t hash,
+                                                           uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (uint32_t)(value & 0xFF);
+    hash *= 16777619u;
+    value >>= 8;
+  }
+  return hash;
+}
+
+// Hashes the group layout and all bindings used by |binding_mask|.
+static uint32_t iree_hal_webgpu_bind_group_hash(
+    WGPUBindGroupLayout group_layout,
+    const iree_hal_webgpu_bind_group_binding_t* bindings,
+    iree_hal_webgpu_binding_mask_t binding_mask) {
+  uint32_t hash = 2166136261u;
+  hash = iree_hal_webgpu_bind_group_hash_u64(hash, (uintptr_t)group_layout);
+  hash = iree_hal_webgpu_bind_group_hash_u64(hash, binding_mask);
+  for (iree_host_size_t i = 0;
+       i < IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT; ++i) {
+    if (!(binding_mask & (1u << i))) continue;
+    const iree_hal_webgpu_bind_group_binding_t* binding = &bindings[i];
+    hash = iree_hal_webgpu_bind_group_hash_u64(hash, (uint64_t)binding->type);
+    hash =
+        iree_hal_webgpu_bind_group_hash_u64(hash, (uintptr_t)binding->buffer);
+    hash = iree_hal_webgpu_bind_group_hash_u64(hash, binding->offset);
+    hash = iree_hal_webgpu_bind_group_hash_u64(hash, binding->length);
+  }
+  return hash;
+}
+
+// Returns true if |entry| matches the given key. Only bindings used by
+// |binding_mask| are compared as the others may contain stale values.
+static bool iree_hal_webgpu_bind_group_cache_entry_matches(
+    const iree_hal_webgpu_bind_group_cache_entry_t* entry, uint32_t hash,
+    WGPUBindGroupLayout group_layout,
+    const iree_hal_webgpu_bind_group_binding_t* bindings,
+    iree_hal_webgpu_binding_mask_t binding_mask) {
+  if (entry->hash != hash || entry->group_layout != group_layout ||
+      entry->binding_mask != binding_mask) {
+    return false;
+  }
+  for (iree_host_size_t i = 0;
+       i < IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT; ++i) {
+    if (!(binding_mask & (1u << i))) continue;
+    const iree_hal_webgpu_bind_group_binding_t* lhs = &entry->bindings[i];
+    const iree_hal_webgpu_bind_group_binding_t* rhs = &bindings[i];
+    if (lhs->type != rhs->type || lhs->buffer != rhs->buffer ||
+        lhs->offset != rhs->offset || lhs->length != rhs->length) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void iree_hal_webgpu_bind_group_cache_lru_unlink(
+    iree_hal_webgpu_bind_group_cache_t* cache, uint16_t index) {
+  iree_hal_webgpu_bind_group_cache_entry_t* entry = &cache->entries[index];
+  if (entry->lru_prev != IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX) {
+    cache->entries[entry->lru_prev].lru_next = entry->lru_next;
+  } else {
+    cache->lru_head = entry->lru_next;
+  }
+  if (entry->lru_next != IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX) {
+    cache->entries[entry->lru_next].lru_prev = entry->lru_prev;
+  } else {
+    cache->lru_tail = entry->lru_prev;
+  }
+  entry->lru_prev = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+  entry->lru_next = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+}
+
+static void iree_hal_webgpu_bind_group_cache_lru_push_front(
+    iree_hal_webgpu_bind_group_cache_t* cache, uint16_t index) {
+  iree_hal_webgpu_bind_group_cache_entry_t* entry = &cache->entries[index];
+  entry->lru_prev = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+  entry->lru_next = cache->lru_head;
+  if (cache->lru_head != IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX) {
+    cache->entries[cache->lru_head].lru_prev = index;
+  } else {
+    cache->lru_tail = index;
+  }
+  cache->lru_head = index;
+}
+
+// Removes the entry at |index| from its hash bucket list.
+static void iree_hal_webgpu_bind_group_cache_bucket_remove(
+    iree_hal_webgpu_bind_group_cache_t* cache, uint16_t index) {
+  iree_hal_webgpu_bind_group_cache_entry_t* entry = &cache->entries[index];
+  uint16_t* link =
+      &cache->buckets[entry->hash &
+                      (IREE_HAL_WEBGPU_BIND_GROUP_CACHE_BUCKET_COUNT - 1)];
+  while (*link != IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX) {
+    if (*link == index) {
+      *link = entry->bucket_next;
+      break;
+    }
+    link = &cache->entries[*link].bucket_next;
+  }
+  entry->bucket_next = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+}
+
 WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
     iree_hal_webgpu_bind_group_cache_t* cache, WGPUBindGroupLayout group_layout,
     const iree_hal_webgpu_bind_group_binding_t* bindings,
@@ -59,52 +181,52 @@ WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
   IREE_ASSERT_ARGUMENT(bindings);
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // This is not a good algorithm :)
-  // We should probably have a split index and a mechanism to partition it such
-  // that lookups don't need to perform a full scan. This is cheaper than the
-  // cost of creating a new bind group per dispatch (no need to call out to
-  // WebGPU, allocate new objects, track those new objects lifetimes, etc) but
-  // not cheap. Ideally we'd be relying on this for 4-5 bind groups per command
-  // buffer at which point it doesn't matter but the compiler still needs to
-  // improve a bit there.
-
-  // Scan the cache for entries with a matching group layout and binding mask.
-  // These should be the same today but in the future we may want to allow for
-  // subsetting as defined by bind group compatibility.
-  iree_host_size_t insertion_slot = cache->entry_count - 1;
-  for (iree_host_size_t i = 0; i < cache->entry_count; ++i) {
-    iree_hal_webgpu_bind_group_cache_entry_t* entry = &cache->entries[i];
-    if (!entry->handle) {
-      insertion_slot = iree_min(insertion_slot, i);
-      continue;
-    }
-    if (entry->group_layout != group_layout) continue;
-    if (entry->binding_mask != binding_mask) continue;
-
-    // Found a potential match. Do a full comparison of the bindings.
-    // TODO(benvanik): we only really need to compare the bindings that are
-    // set in the mask, however memcmp over a few hundred bytes is usually
-    // faster than what we'd have to do for that comparison.
-    if (memcmp(bindings, entry->bindings, sizeof(entry->bindings)) == 0) {
-      // Same exact bindings - cache hit!
-      // TODO(benvanik): a real LRU that rearranges this to the front/back.
+  // Look for an entry with a matching group layout and bindings in the hash
+  // bucket. Group layouts should match exactly today but in the future we may
+  // want to allow for subsetting as defined by bind group compatibility.
+  const uint32_t hash =
+      iree_hal_webgpu_bind_group_hash(group_layout, bindings, binding_mask);
+  uint16_t* bucket =
+      &cache->buckets[hash &
+                      (IREE_HAL_WEBGPU_BIND_GROUP_CACHE_BUCKET_COUNT - 1)];
+  for (uint16_t index = *bucket;
+       index != IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+       index = cache->entries[index].bucket_next) {
+    iree_hal_webgpu_bind_group_cache_entry_t* entry = &cache->entries[index];
+    if (iree_hal_webgpu_bind_group_cache_entry_matches(
+            entry, hash, group_layout, bindings, binding_mask)) {
+      // Same exact bindings - cache hit! Move to the front of the LRU list.
+      if (cache->lru_head != index) {
+        iree_hal_webgpu_bind_group_cache_lru_unlink(cache, index);
+        iree_hal_webgpu_bind_group_cache_lru_push_front(cache, index);
+      }
       IREE_TRACE_ZONE_END(z0);
       return entry->handle;
     }
   }
 
-  // Evict an existing entry to store this new one or use the last unused slot.
-  iree_hal_webgpu_bind_group_cache_entry_t* entry =
-      &cache->entries[insertion_slot];
-  if (entry->handle) {
-    IREE_TRACE_ZONE_APPEND_TEXT(z0, "evict");
-    iree_wgpuBindGroupDrop(entry->handle);
-  } else {
+  // Use an unused entry or evict the least recently used one.
+  uint16_t index = IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX;
+  if (cache->entry_count < IREE_ARRAYSIZE(cache->entries)) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+    index = (uint16_t)cache->entry_count++;
+  } else {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "evict");
+    index = cache->lru_tail;
+    iree_hal_webgpu_bind_group_cache_lru_unlink(cache, index);
+    iree_hal_webgpu_bind_group_cache_bucket_remove(cache, index);
+    if (cache->entries[index].handle) {
+      iree_wgpuBindGroupDrop(cache->entries[index].handle);
+    }
   }
+  iree_hal_webgpu_bind_group_cache_entry_t* entry = &cache->entries[index];
   entry->group_layout = group_layout;
   entry->binding_mask = binding_mask;
   memcpy(entry->bindings, bindings, sizeof(entry->bindings));
+  entry->hash = hash;
+  entry->bucket_next = *bucket;
+  *bucket = index;
+  iree_hal_webgpu_bind_group_cache_lru_push_front(cache, index);
 
   // NOTE: we could change this to do bit scans over the binding_mask but I
   // haven't checked to see how expensive those are in WebAssembly. For now we
@@ -16,11 +16,18 @@
 extern "C" {
 #endif  // __cplusplus
 
-// NOTE: this is probably too small, but this is all a hack anyway.
-// TODO(benvanik): build a real cache - today this is assuming the compiler does
-// a much better job than it currently does as reducing the number of push
-// descriptor sets.
-#define IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY 32
+// Maximum number of bind groups retained in the cache. Programs commonly
+// dispatch with more unique binding combinations than a command buffer has
+// dispatches as the compiler does not yet do a great job at reducing the number
+// of push descriptor sets; this is sized to hold the working set of a few
+// hundred dispatches so that bind groups survive across submissions.
+#define IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY 128
+
+// Number of hash buckets used to index cache entries. Must be a power of two.
+#define IREE_HAL_WEBGPU_BIND_GROUP_CACHE_BUCKET_COUNT 256
+
+// Sentinel index used to terminate entry lists.
+#define IREE_HAL_WEBGPU_BIND_GROUP_CACHE_INVALID_INDEX UINT16_MAX
 
 // A subset of WGPUBindGroupEntry containing only what we need.
 // WGPUBindGroupEntry is quite large (has sampler and texture information).
@@ -42,16 +49,31 @@ typedef struct iree_hal_webgpu_bind_group_cache_entry_t {
   // Each bit indicates a populated binding at the respective ordinal.
   iree_hal_webgpu_binding_mask_t binding_mask;
   // Each source binding to use for cache equality comparison.
+  // Only bindings set in |binding_mask| are valid.
   iree_hal_webgpu_bind_group_binding_t
       bindings[IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+  // Hash of the group layout and the bindings in |binding_mask|.
+  uint32_t hash;
+  // Next entry in the same hash bucket.
+  uint16_t bucket_next;
+  // Adjacent entries in the LRU list; |lru_prev| is more recently used.
+  uint16_t lru_prev;
+  uint16_t lru_next;
 } iree_hal_webgpu_bind_group_cache_entry_t;
 
-// Simple cache of WGPUBindGroups.
+// LRU cache of WGPUBindGroups keyed by group layout and bound buffer ranges.
 // Bind groups in WebGPU are immutable and we need to create new ones for each
-// unique set of bindings.
+// unique set of bindings. Entries are indexed by a hash of their key and when
+// the cache is full the least recently used bind group is evicted.
 typedef struct iree_hal_webgpu_bind_group_cache_t {
   WGPUDevice device;
+  // Number of entries in use; entries [0, entry_count) are populated.
   iree_host_size_t entry_count;
+  // Most and least recently used entries.
+  uint16_t lru_head;
+  uint16_t lru_tail;
+  // Head entry of each hash bucket list.
+  uint16_t buckets[IREE_HAL_WEBGPU_BIND_GROUP_CACHE_BUCKET_COUNT];
   iree_hal_webgpu_bind_group_cache_entry_t
       entries[IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY];
 } iree_hal_webgpu_bind_group_cache_t;
@@ -73,7 +95,9 @@ void iree_hal_webgpu_bind_group_cache_trim(
 // Each bit of |binding_mask| indicates a binding that is used by the caller;
 // this allows for matching of cached bind groups to match any with only the
 // used bindings needing to match.
-// Callers may use the returned bind group handle until the cache is trimmed.
+// Callers may use the returned bind group handle until the cache is trimmed or
+// the next acquire (which may evict it). WebGPU retains bind groups that have
+// been set on an encoder so recorded commands are unaffected by eviction.
 WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
     iree_hal_webgpu_bind_group_cache_t* cache, WGPUBindGroupLayout group_layout,
     const iree_hal_webgpu_bind_group_binding_t* bindings,
@@ -66,7 +66,13 @@ EM_ASYNC_JS(WGPUDevice, wgpuAdapterRequestDeviceSync, (WGPUAdapter adapterId), {
   const adapter = WebGPU.mgrAdapter.get(adapterId);
 
   // TODO(scotttodd): WGPUDeviceDescriptor struct
-  const descriptor = {};
+  // Request the optional features executables may be compiled to use when the
+  // adapter supports them. Executables query for them at load time and fall
+  // back to variants that do not use them when absent.
+  const optionalFeatures = [ 'shader-f16', 'subgroups' ];
+  const requiredFeatures =
+      optionalFeatures.filter((feature) => adapter['features']['has'](feature));
+  const descriptor = {'requiredFeatures' : requiredFeatures};
   const device = await adapter['requestDevice'](descriptor);
 
   const deviceWrapper = {queueId : WebGPU.mgrQueue.create(device["queue"])};
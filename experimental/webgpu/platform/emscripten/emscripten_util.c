@@ -6,6 +6,8 @@
 
 #include "experimental/webgpu/platform/webgpu.h"
 
+#include <emscripten.h>
+
 //===----------------------------------------------------------------------===//
 // Implementation compatibility layer
 //===----------------------------------------------------------------------===//
@@ -52,3 +54,15 @@ void iree_wgpuQuerySetDrop(WGPUQuerySet querySet) {
 void iree_wgpuShaderModuleDrop(WGPUShaderModule shaderModule) {
   // Not implemented on the web / Emscripten.
 }
+
+// WARNING: this calls functions directly on Emscripten's library_webgpu.js.
+// This is not a stable API!
+EM_JS(int, iree_wgpuDeviceHasFeatureImpl,
+      (WGPUDevice deviceId, const char* featureName), {
+        const device = WebGPU.mgrDevice.get(deviceId);
+        return device['features']['has'](UTF8ToString(featureName)) ? 1 : 0;
+      });
+
+bool iree_wgpuDeviceHasFeature(WGPUDevice device, const char* feature_name) {
+  return iree_wgpuDeviceHasFeatureImpl(device, feature_name) != 0;
+}
@@ -54,6 +54,12 @@ void iree_wgpuPipelineLayoutDrop(WGPUPipelineLayout pipelineLayout);
 void iree_wgpuQuerySetDrop(WGPUQuerySet querySet);
 void iree_wgpuShaderModuleDrop(WGPUShaderModule shaderModule);
 
+// Returns true if |device| was created with the optional feature named
+// |feature_name| (such as "shader-f16" or "subgroups") enabled.
+// Feature enums are not yet consistent across implementations so features are
+// identified by their WebGPU specification names.
+bool iree_wgpuDeviceHasFeature(WGPUDevice device, const char* feature_name);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -47,6 +47,10 @@ typedef struct iree_hal_webgpu_device_t {
   WGPUDevice handle;
   WGPUQueue queue;
 
+  // Optional WebGPU features enabled on the device.
+  bool supports_shader_f16;
+  bool supports_subgroups;
+
   // Block pool used for small allocations like submissions and callbacks.
   iree_arena_block_pool_t small_block_pool;
   // Block pool used for command buffers with a large block size (as command
@@ -111,6 +115,8 @@ IREE_API_EXPORT iree_status_t iree_hal_webgpu_wrap_device(
   device->owns_device_handle = false;
   device->handle = handle;
   device->queue = wgpuDeviceGetQueue(handle);
+  device->supports_shader_f16 = iree_wgpuDeviceHasFeature(handle, "shader-f16");
+  device->supports_subgroups = iree_wgpuDeviceHasFeature(handle, "subgroups");
 
   iree_arena_block_pool_initialize(IREE_HAL_WEBGPU_SMALL_POOL_BLOCK_SIZE,
                                    host_allocator, &device->small_block_pool);
@@ -230,6 +236,34 @@ static iree_status_t iree_hal_webgpu_device_query_i64(
     return iree_ok_status();
   }
 
+  // Note that the device queries used here should match the ones produced by
+  // the compiler in SPIRVMaterializeExecutableConditionsPass.
+  if (iree_string_view_equal(category, IREE_SV("hal.dispatch"))) {
+    if (iree_string_view_equal(key, IREE_SV("compute.bitwidths.fp"))) {
+      // Bit 0: f16 arithmetic.
+      *out_value = device->supports_shader_f16 ? 0b01 : 0;
+      return iree_ok_status();
+    }
+    if (iree_string_view_equal(key, IREE_SV("storage.bitwidths"))) {
+      // Bit 1: 16-bit storage buffer access.
+      *out_value = device->supports_shader_f16 ? 0b10 : 0;
+      return iree_ok_status();
+    }
+    if (iree_string_view_equal(key, IREE_SV("subgroup.ops"))) {
+      // Bit 0: subgroup shuffle; bit 1: subgroup arithmetic.
+      *out_value = device->supports_subgroups ? 0b11 : 0;
+      return iree_ok_status();
+    }
+    if (iree_string_view_equal(key, IREE_SV("compute.bitwidths.int")) ||
+        iree_string_view_equal(key, IREE_SV("dotprod.ops")) ||
+        iree_string_view_equal(key, IREE_SV("coopmatrix.ops")) ||
+        iree_string_view_equal(key, IREE_SV("address.mode"))) {
+      // Not exposed by WebGPU.
+      *out_value = 0;
+      return iree_ok_status();
+    }
+  }
+
   return iree_make_status(
       IREE_STATUS_NOT_FOUND,
       "unknown device configuration key value '%.*s :: %.*s'",
@@ -394,7 +428,8 @@ static iree_status_t iree_hal_webgpu_device_queue_execute(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
   iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
 
   // TODO(benvanik): this currently assumes we are synchronizing on semaphores
@@ -6,11 +6,15 @@
 
 #include "iree_pjrt/common/api_impl.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <optional>
 #include <sstream>
+#include <thread>
 #include <utility>
 
 #include "iree/hal/api.h"
+#include "iree_pjrt/common/compilation_cache.h"
 #include "iree_pjrt/common/iree_helpers.h"
 #include "iree_pjrt/common/tensor_utils.h"
 // TODO: Excise. Uses deep XLA internals.
@@ -263,6 +267,46 @@ const std::string& ErrorInstance::message() const {
   return cached_message_;
 }
 
+//===----------------------------------------------------------------------===//
+// Host memory import
+//===----------------------------------------------------------------------===//
+
+// Imports caller-owned host memory [ptr, ptr + size) as a buffer that device
+// transfers can use directly without staging through another allocation.
+// Drivers may require aligned imports so the range is widened to the import
+// alignment; the widened range stays within the pages holding the original
+// range and transfers only ever touch the original range at |out_offset|.
+static iree_status_t ImportHostRange(
+    iree_hal_allocator_t* allocator, void* ptr, iree_host_size_t size,
+    iree_hal_buffer_usage_t usage, iree_hal_buffer_t** out_buffer,
+    iree_device_size_t* out_offset) {
+  const uintptr_t alignment = 64;
+  uintptr_t begin = (uintptr_t)ptr & ~(alignment - 1);
+  uintptr_t end = ((uintptr_t)ptr + size + alignment - 1) & ~(alignment - 1);
+  iree_hal_buffer_params_t params;
+  memset(&params, 0, sizeof(params));
+  params.usage = usage;
+  // TODO: We should be able to use narrower access here since the buffer
+  // is never actually mapped (just accessed through the void* later).
+  // However, that seems to cause the memory to never be committed and the
+  // interaction aborted.
+  params.access = IREE_HAL_MEMORY_ACCESS_ALL;
+  params.type =
+      IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+  iree_hal_external_buffer_t external_buffer;
+  memset(&external_buffer, 0, sizeof(external_buffer));
+  external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+  external_buffer.flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE;
+  external_buffer.size = end - begin;
+  external_buffer.handle.host_allocation.ptr = (void*)begin;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_import_buffer(
+      allocator, params, &external_buffer,
+      /*release_callback=*/iree_hal_buffer_release_callback_null(),
+      out_buffer));
+  *out_offset = (uintptr_t)ptr - begin;
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // BufferInstance
 //===----------------------------------------------------------------------===//
@@ -451,7 +495,7 @@ iree_status_t BufferInstance::AsyncDeallocate() {
 iree_status_t BufferInstance::Delete() {
   IREE_TRACE_SCOPE();
   is_deleted_ = true;
-  buffer_view_.release();
+  buffer_view_.reset();
   return iree_ok_status();
 }
 
@@ -470,46 +514,39 @@ iree_status_t BufferInstance::CopyToHost(void* dst, iree_host_size_t dst_size,
   };
 
   //  Configure a default structure that writes directly to dst.
-  const size_t alignment = 64;
   struct CopyToHostData* copy_to_host_data = new CopyToHostData;
   copy_to_host_data->alloc = nullptr;
   copy_to_host_data->aligned = dst;
   copy_to_host_data->dst = dst;
   copy_to_host_data->size = dst_size;
 
-  // If the destination is unaligned we need to write to an intermediary buffer.
-  if (((uintptr_t)dst) & (alignment - 1)) {
+  // Import the destination (host) buffer as an iree_hal_buffer_t so that we
+  // can issue copy commands directly into it. Only if the driver is unable to
+  // import it do we write to an aligned intermediary buffer and copy out of it
+  // once the transfer completes.
+  iree::vm::ref<iree_hal_buffer_t> dst_buffer;
+  iree_device_size_t dst_offset = 0;
+  iree_status_t import_status = ImportHostRange(
+      device_.device_allocator(), dst, dst_size,
+      IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET, &dst_buffer, &dst_offset);
+  if (!iree_status_is_ok(import_status)) {
+    iree_status_ignore(import_status);
+    const size_t alignment = 64;
     const size_t alignment_size = alignment + dst_size + sizeof(uintptr_t);
     char* alloc = new char[alignment_size];
     copy_to_host_data->alloc = alloc;
     copy_to_host_data->aligned =
         (void*)((((uintptr_t)alloc + alignment) & ~(uintptr_t)(alignment - 1)));
+    import_status = ImportHostRange(
+        device_.device_allocator(), copy_to_host_data->aligned, dst_size,
+        IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET, &dst_buffer, &dst_offset);
+    if (!iree_status_is_ok(import_status)) {
+      delete[] alloc;
+      delete copy_to_host_data;
+      return import_status;
+    }
   }
 
-  // Import the destination (host) buffer as an iree_hal_buffer_t so that we
-  // can issue copy commands.
-  iree::vm::ref<iree_hal_buffer_t> dst_buffer;
-  iree_hal_buffer_params_t dst_buffer_params = {
-      /*usage=*/IREE_HAL_BUFFER_USAGE_TRANSFER_TARGET,
-      // TODO: We should be able to use WRITE access here since the buffer
-      // is never actually mapped to read back out (just accessed through the
-      // void* later). However, that seems to cause the memory to never be
-      // committed and the interaction aborted.
-      /*access=*/IREE_HAL_MEMORY_ACCESS_ALL,
-      /*type=*/IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
-          IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
-  };
-  iree_hal_external_buffer_t dst_external_buffer;
-  memset(&dst_external_buffer, 0, sizeof(dst_external_buffer));
-  dst_external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
-  dst_external_buffer.flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE;
-  dst_external_buffer.size = dst_size;
-  dst_external_buffer.handle.host_allocation.ptr = copy_to_host_data->aligned;
-  IREE_RETURN_IF_ERROR(IreeApi::hal_allocator_import_buffer(
-      device_.device_allocator(), dst_buffer_params, &dst_external_buffer,
-      /*release_callback=*/iree_hal_buffer_release_callback_null(),
-      &dst_buffer));
-
   // Create the transfer command buffer.
   iree::vm::ref<iree_hal_command_buffer_t> transfer_cb;
   iree_hal_transfer_command_t transfer_command;
@@ -519,7 +556,7 @@ iree_status_t BufferInstance::CopyToHost(void* dst, iree_host_size_t dst_size,
       iree_hal_buffer_view_buffer(buffer_view());
   transfer_command.copy.source_offset = 0;
   transfer_command.copy.target_buffer = dst_buffer.get();
-  transfer_command.copy.target_offset = 0;
+  transfer_command.copy.target_offset = dst_offset;
   transfer_command.copy.length = dst_size;
   IREE_RETURN_IF_ERROR(iree_hal_create_transfer_command_buffer(
       device_.device(), IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
@@ -590,6 +627,10 @@ iree_status_t BufferInstance::CopyToHost(void* dst, iree_host_size_t dst_size,
       iree_hal_fence_semaphore_list(dst_buffer_ready_fence.get()),
       /*command_buffer_count=*/1, &transfer_cb));
 
+  // The buffer may not be reused (such as by being donated) until the copy
+  // has read it.
+  IREE_RETURN_IF_ERROR(AdvanceDoneFence(semaphore.get(), 1ull));
+
   *out_done_event = copy_done_event;
   return iree_ok_status();
 }
@@ -1134,14 +1175,10 @@ iree_status_t DeviceInstance::HostBufferToDevice(
   bool caller_data_done = false;
 
   iree::vm::ref<iree_hal_buffer_t> host_staging_buffer;
+  iree_device_size_t host_staging_offset = 0;
   IREE_RETURN_IF_ERROR(AcquireHostStagingBuffer(
       iree_make_const_byte_span(data, byte_length), require_snapshot_now,
-      &caller_data_done, &host_staging_buffer));
-  if (!caller_data_done) {
-    return iree_make_status(
-        IREE_STATUS_UNIMPLEMENTED,
-        "deferred snapshot of host data not yet implemented");
-  }
+      &caller_data_done, &host_staging_buffer, &host_staging_offset));
 
   // Allocate on stream. We serialize across 3 timepoints:
   //   0. Last transfer complete
@@ -1173,7 +1210,7 @@ iree_status_t DeviceInstance::HostBufferToDevice(
   memset(&transfer_command, 0, sizeof(transfer_command));
   transfer_command.type = IREE_HAL_TRANSFER_COMMAND_TYPE_COPY;
   transfer_command.copy.source_buffer = host_staging_buffer.get(),
-  transfer_command.copy.source_offset = 0;
+  transfer_command.copy.source_offset = host_staging_offset;
   transfer_command.copy.target_buffer = buffer.get();
   transfer_command.copy.target_offset = 0;
   transfer_command.copy.length = byte_length;
@@ -1204,9 +1241,20 @@ iree_status_t DeviceInstance::HostBufferToDevice(
   if (is_dense_row_major) {
     *out_buffer = instance;
 
-    // We snapshotted the caller data when acquiring the host staging buffer,
-    // so we won't be touching it again.
-    *out_done_with_host_buffer_event = new EventInstance(/*fence=*/nullptr);
+    if (caller_data_done) {
+      // We snapshotted the caller data when acquiring the host staging
+      // buffer, so we won't be touching it again.
+      *out_done_with_host_buffer_event = new EventInstance(/*fence=*/nullptr);
+    } else {
+      // The transfer reads directly from the caller data so the caller has to
+      // keep it alive until the copy completes.
+      iree::vm::ref<iree_hal_fence_t> copy_done_fence;
+      IREE_RETURN_IF_ERROR(IreeApi::hal_fence_create_at(
+          transfer_timeline_.get(), signal_copy_complete,
+          client_.host_allocator(), &copy_done_fence));
+      *out_done_with_host_buffer_event =
+          new EventInstance(std::move(copy_done_fence));
+    }
 
     return iree_ok_status();
   }
@@ -1221,13 +1269,28 @@ iree_status_t DeviceInstance::HostBufferToDevice(
 
 iree_status_t DeviceInstance::AcquireHostStagingBuffer(
     iree_const_byte_span_t initial_contents, bool snapshot_initial_contents_now,
-    bool* initial_contents_snapshotted, iree_hal_buffer_t** out_buffer) {
+    bool* initial_contents_snapshotted, iree_hal_buffer_t** out_buffer,
+    iree_device_size_t* out_offset) {
   IREE_TRACE_SCOPE();
+  // If the caller keeps the contents alive until the transfer completes we
+  // try to import them directly so that the device transfers out of the
+  // (pinned) host memory without an intermediate snapshot. Drivers that cannot
+  // import the allocation fall back to the snapshot below.
+  if (!snapshot_initial_contents_now) {
+    iree_status_t import_status = ImportHostRange(
+        device_allocator(), const_cast<uint8_t*>(initial_contents.data),
+        initial_contents.data_length, IREE_HAL_BUFFER_USAGE_TRANSFER_SOURCE,
+        out_buffer, out_offset);
+    if (iree_status_is_ok(import_status)) {
+      *initial_contents_snapshotted = false;
+      return iree_ok_status();
+    }
+    iree_status_ignore(import_status);
+  }
+
   // There are multiple ways to do this that have different cost/benefits.
   // Here we do the simplest thing and snapshot into a new host allocation.
-  // This could be replaced with either some form of staging ring buffer
-  // or importing from a raw pointer (on implementations where the cost of
-  // unified addressing is zero).
+  // This could be replaced with some form of staging ring buffer.
   iree_hal_buffer_params_t params;
   memset(&params, 0, sizeof(params));
   params.type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_DEVICE;
@@ -1240,6 +1303,7 @@ iree_status_t DeviceInstance::AcquireHostStagingBuffer(
       iree_infinite_timeout()));
   // We did a synchronous snapshot (memcpy).
   *initial_contents_snapshotted = true;
+  *out_offset = 0;
   return iree_ok_status();
 }
 
@@ -1253,6 +1317,22 @@ iree_status_t DeviceInstance::GetHalDevice(iree_hal_device_t** out_device) {
 // ClientInstance
 //===----------------------------------------------------------------------===//
 
+namespace {
+
+// A compiler output backed by an in-memory copy of a previously compiled
+// executable (i.e. loaded from the compilation cache).
+class CachedCompilerOutput : public CompilerOutput {
+ public:
+  explicit CachedCompilerOutput(std::string data) : data_(std::move(data)) {}
+  void* GetData() override { return data_.data(); }
+  size_t GetDataSize() override { return data_.size(); }
+
+ private:
+  std::string data_;
+};
+
+}  // namespace
+
 ClientInstance::ClientInstance(std::unique_ptr<Platform> platform)
     : platform_(std::move(platform)) {
   host_allocator_ = iree_allocator_system();
@@ -1419,6 +1499,13 @@ PJRT_Error* ClientInstance::Initialize() {
     return MakeError(status);
   }
 
+  // On-disk compilation cache, keyed on the program and everything that
+  // influences how it is compiled.
+  if (auto cache_dir = platform().config_vars().Lookup("COMPILATION_CACHE_DIR");
+      cache_dir && !cache_dir->empty()) {
+    compilation_cache_dir_ = std::move(*cache_dir);
+  }
+
   // More initialization.
   return nullptr;
 }
@@ -1478,78 +1565,106 @@ PJRT_Error* ClientInstance::Compile(const PJRT_Program* program,
                                       message.c_str()));
   };
 
-  std::vector<std::unique_ptr<CompilerOutput>> retained_outputs;
+  // Start the main compilation job and set its flags up front so that they
+  // can be used to key the compilation cache before doing any work.
+  std::unique_ptr<CompilerJob> job = platform().compiler().StartJob();
+  if (!job) {
+    std::string message = platform().compiler().GetErrorMessage();
+    return MakeError(
+        iree_make_status(IREE_STATUS_CANCELLED, ": %s", message.c_str()));
+  }
+  if (artifact_tx) {
+    job->EnableCrashDumps(artifact_tx.get());
+  }
 
-  // Partition.
-  if (platform().partitioner()) {
-    std::unique_ptr<CompilerJob> job = platform().partitioner()->StartJob();
-    if (!job) {
-      std::string message = platform().partitioner()->GetErrorMessage();
-      return MakeError(
-          iree_make_status(IREE_STATUS_CANCELLED, ": %s", message.c_str()));
-    }
-    if (artifact_tx) {
-      job->EnableCrashDumps(artifact_tx.get());
-    }
+  // Set flags.
+  // TODO: This should be done as part of session setup from a named pool.
+  // TODO: The HAL backends and other flags should come from the assigned
+  // devices.
+  if (!SetDefaultCompilerFlags(job.get())) {
+    return MakeCompilerError(*job);
+  }
+  // TODO: Plumb CompileOptions through.
+  // if (!job->SetFlags(options)) return MakeCompilerError(*job);
+  std::string flags = job->GetFlags();
+  if (artifact_tx) {
+    artifact_tx->WriteArtifact(
+        /*label=*/"flags", /*extension=*/"txt", /*index=*/-1, flags);
+  }
 
-    // Set flags.
-    // TODO: Plumb CompileOptions through.
-    // if (!job->SetFlags(options)) return MakeCompilerError(*job);
-    if (artifact_tx) {
-      artifact_tx->WriteArtifact(
-          /*label=*/"partitioner_flags", /*extension=*/"txt", /*index=*/-1,
-          job->GetFlags());
+  // Look up the compilation cache. The key covers the original program, the
+  // compiler flags (which carry the target devices), the platform and the
+  // revisions of the compiler and partitioner.
+  std::string cache_path;
+  if (!compilation_cache_dir_.empty()) {
+    std::string partitioner_revision;
+    if (platform().partitioner()) {
+      partitioner_revision = platform().partitioner()->GetRevision();
     }
+    uint64_t fingerprint = FingerprintCompilation(
+        {code, flags, cached_platform_name(),
+         platform().compiler().GetRevision(), partitioner_revision});
+    cache_path = GetCompilationCachePath(compilation_cache_dir_, fingerprint);
+  }
 
-    // Parse the source.
-    if (!job->ParseSourceBuffer(code.data(), code.size())) {
-      return MakeCompilerError(*job);
+  std::unique_ptr<CompilerOutput> output;
+  if (!cache_path.empty()) {
+    std::string cached_data;
+    if (ReadCompilationCacheEntry(cache_path, &cached_data)) {
+      output = std::make_unique<CachedCompilerOutput>(std::move(cached_data));
+      logger().debug("Loaded executable from the compilation cache");
     }
+  }
 
+  std::vector<std::unique_ptr<CompilerOutput>> retained_outputs;
+  if (!output) {
     // Partition.
-    std::unique_ptr<CompilerOutput> output = job->CompileStandardPipeline();
-    if (!output) {
-      return MakeCompilerError(*job);
-    }
-    if (artifact_tx) {
-      artifact_tx->WriteArtifact(
-          /*label=*/"partitioned", /*extension=*/"mlir", /*index=*/-1,
-          std::string_view(static_cast<const char*>(output->GetData()),
-                           output->GetDataSize()));
-    }
+    if (platform().partitioner()) {
+      std::unique_ptr<CompilerJob> partitioner_job =
+          platform().partitioner()->StartJob();
+      if (!partitioner_job) {
+        std::string message = platform().partitioner()->GetErrorMessage();
+        return MakeError(
+            iree_make_status(IREE_STATUS_CANCELLED, ": %s", message.c_str()));
+      }
+      if (artifact_tx) {
+        partitioner_job->EnableCrashDumps(artifact_tx.get());
+      }
 
-    // Update the code alias and retain the backing output for the next
-    // compilation step.
-    code = std::string_view(static_cast<const char*>(output->GetData()),
-                            output->GetDataSize());
-    retained_outputs.push_back(std::move(output));
-  }
+      // Set flags.
+      // TODO: Plumb CompileOptions through.
+      // if (!partitioner_job->SetFlags(options)) {
+      //   return MakeCompilerError(*partitioner_job);
+      // }
+      if (artifact_tx) {
+        artifact_tx->WriteArtifact(
+            /*label=*/"partitioner_flags", /*extension=*/"txt", /*index=*/-1,
+            partitioner_job->GetFlags());
+      }
 
-  // Main compilation.
-  {
-    std::unique_ptr<CompilerJob> job = platform().compiler().StartJob();
-    if (!job) {
-      std::string message = platform().compiler().GetErrorMessage();
-      return MakeError(
-          iree_make_status(IREE_STATUS_CANCELLED, ": %s", message.c_str()));
-    }
-    if (artifact_tx) {
-      job->EnableCrashDumps(artifact_tx.get());
-    }
+      // Parse the source.
+      if (!partitioner_job->ParseSourceBuffer(code.data(), code.size())) {
+        return MakeCompilerError(*partitioner_job);
+      }
 
-    // Set flags.
-    // TODO: This should be done as part of session setup from a named pool.
-    // TODO: The HAL backends and other flags should come from the assigned
-    // devices.
-    if (!SetDefaultCompilerFlags(job.get())) {
-      return MakeCompilerError(*job);
-    }
-    // TODO: Plumb CompileOptions through.
-    // if (!job->SetFlags(options)) return MakeCompilerError(*job);
-    if (artifact_tx) {
-      artifact_tx->WriteArtifact(
-          /*label=*/"flags", /*extension=*/"txt", /*index=*/-1,
-          job->GetFlags());
+      // Partition.
+      std::unique_ptr<CompilerOutput> partitioned =
+          partitioner_job->CompileStandardPipeline();
+      if (!partitioned) {
+        return MakeCompilerError(*partitioner_job);
+      }
+      if (artifact_tx) {
+        artifact_tx->WriteArtifact(
+            /*label=*/"partitioned", /*extension=*/"mlir", /*index=*/-1,
+            std::string_view(static_cast<const char*>(partitioned->GetData()),
+                             partitioned->GetDataSize()));
+      }
+
+      // Update the code alias and retain the backing output for the next
+      // compilation step.
+      code = std::string_view(static_cast<const char*>(partitioned->GetData()),
+                              partitioned->GetDataSize());
+      retained_outputs.push_back(std::move(partitioned));
     }
 
     // Parse the source.
@@ -1558,30 +1673,36 @@ PJRT_Error* ClientInstance::Compile(const PJRT_Program* program,
     }
 
     // Perform main compilation.
-    std::unique_ptr<CompilerOutput> output = job->CompileStandardPipeline();
+    output = job->CompileStandardPipeline();
     if (!output) {
       return MakeCompilerError(*job);
     }
-    if (artifact_tx) {
-      artifact_tx->WriteArtifact(
-          /*label=*/"program", /*extension=*/"vmfb", /*index=*/-1,
+    if (!cache_path.empty()) {
+      WriteCompilationCacheEntry(
+          cache_path,
           std::string_view(static_cast<const char*>(output->GetData()),
                            output->GetDataSize()));
     }
+  }
+  if (artifact_tx) {
+    artifact_tx->WriteArtifact(
+        /*label=*/"program", /*extension=*/"vmfb", /*index=*/-1,
+        std::string_view(static_cast<const char*>(output->GetData()),
+                         output->GetDataSize()));
+  }
 
-    auto executable = std::make_unique<LoadedExecutableInstance>(
-        *this,
-        new ExecutableImage(std::move(output),
-                            std::string(program->code, program->code_size)),
-        addressable_devices_);
-    status = executable->LoadAll();
-    if (!iree_status_is_ok(status)) {
-      return MakeError(status);
-    }
-
-    *out_executable = executable.release();
+  auto executable = std::make_unique<LoadedExecutableInstance>(
+      *this,
+      new ExecutableImage(std::move(output),
+                          std::string(program->code, program->code_size)),
+      addressable_devices_);
+  status = executable->LoadAll();
+  if (!iree_status_is_ok(status)) {
+    return MakeError(status);
   }
 
+  *out_executable = executable.release();
+
   // Success? Cancel the artifact so we don't persist successful runs
   // (unless if so configured).
   if (artifact_tx) {
@@ -1946,6 +2067,24 @@ iree_status_t LoadedExecutableInstance::LoadAll() {
     IREE_RETURN_IF_ERROR(iree_vm_function_call_count_arguments_and_results(
         &sig, &loaded.arg_count, &loaded.result_count));
 
+    // Record the arguments the compiler aliased results to (from donated
+    // inputs marked with `tf.aliasing_output`).
+    iree_string_view_t output_storage = iree_vm_function_lookup_attr_by_name(
+        &loaded.main_function, IREE_SV("iree.abi.output_storage"));
+    while (!iree_string_view_is_empty(output_storage)) {
+      iree_string_view_t arg_index_str;
+      iree_string_view_split(output_storage, ',', &arg_index_str,
+                             &output_storage);
+      uint64_t arg_index = 0;
+      if (!iree_string_view_atoi_uint64(arg_index_str, &arg_index) ||
+          arg_index >= loaded.arg_count) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "invalid output storage argument '%.*s'",
+                                (int)arg_index_str.size, arg_index_str.data);
+      }
+      loaded.donated_arg_indices.push_back(arg_index);
+    }
+
     // Defer to the client to populate the stack of modules.
     std::vector<iree::vm::ref<iree_vm_module_t>> modules;
     IREE_RETURN_IF_ERROR(
@@ -2052,6 +2191,11 @@ iree_status_t LoadedExecutableInstance::BatchExecute(
     // Populate inputs.
     for (size_t i = 0; i < args->num_args; ++i) {
       auto* buffer = BufferInstance::Unwrap(args->argument_lists[dev_index][i]);
+      if (buffer->is_deleted()) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "argument %d has been deleted or donated",
+                                (int)i);
+      }
       iree_vm_ref_t bv_ref =
           iree_hal_buffer_view_retain_ref(buffer->buffer_view());
       IREE_RETURN_IF_ERROR(
@@ -2061,6 +2205,15 @@ iree_status_t LoadedExecutableInstance::BatchExecute(
       IREE_RETURN_IF_ERROR(IreeApi::hal_fence_extend(inv.wait_fence.get(),
                                                      buffer->ready_fence()));
 
+      // Donated inputs are overwritten in-place so all pending work using
+      // them (such as transfers to the host) must complete first.
+      const auto& donated_arg_indices = inv.res_exe->donated_arg_indices;
+      if (std::find(donated_arg_indices.begin(), donated_arg_indices.end(),
+                    i) != donated_arg_indices.end()) {
+        IREE_RETURN_IF_ERROR(IreeApi::hal_fence_extend(inv.wait_fence.get(),
+                                                       buffer->done_fence()));
+      }
+
       // And extend the buffer's done fence to close over this execution.
       buffer->AdvanceDoneFence(inv.res_exe->device_instance->main_timeline(),
                                signal_timepoint);
@@ -2132,6 +2285,14 @@ iree_status_t LoadedExecutableInstance::BatchExecute(
       args->device_complete_events[dev_index] =
           *(new EventInstance(retain_ref(inv.wait_fence)));
     }
+
+    // Donated inputs now back the results they were aliased to and can no
+    // longer be used through the argument buffers.
+    for (iree_host_size_t arg_index : inv.res_exe->donated_arg_indices) {
+      IREE_RETURN_IF_ERROR(
+          BufferInstance::Unwrap(args->argument_lists[dev_index][arg_index])
+              ->Delete());
+    }
   }
 
   return status;
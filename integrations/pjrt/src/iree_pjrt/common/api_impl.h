@@ -259,10 +259,15 @@ class DeviceInstance {
 
  private:
   iree_status_t OpenDevice();
+  // Acquires a host buffer holding |initial_contents| to transfer from at
+  // |out_offset|. Unless |snapshot_initial_contents_now| is set the contents
+  // may be used in-place, in which case |initial_contents_snapshotted| is
+  // false and the caller must keep the contents alive until the transfer
+  // completes.
   iree_status_t AcquireHostStagingBuffer(
       iree_const_byte_span_t initial_contents,
       bool snapshot_initial_contents_now, bool* initial_contents_snapshotted,
-      iree_hal_buffer_t** out_buffer);
+      iree_hal_buffer_t** out_buffer, iree_device_size_t* out_offset);
 
   ClientInstance& client_;
   iree_hal_driver_t* driver_;  // Owned by client.
@@ -368,6 +373,9 @@ struct ResidentExecutable {
   iree_vm_function_t main_function;
   iree_host_size_t arg_count;
   iree_host_size_t result_count;
+  // Arguments whose storage is reused in-place for results. These are donated
+  // to the invocation and must not be used by the caller afterwards.
+  std::vector<iree_host_size_t> donated_arg_indices;
 };
 
 class LoadedExecutableInstance {
@@ -491,6 +499,10 @@ class ClientInstance {
 
   std::unique_ptr<Platform> platform_;
 
+  // Directory holding compiled executables keyed on a fingerprint of the
+  // program and compiler configuration. Empty if caching is disabled.
+  std::string compilation_cache_dir_;
+
   // HAL.
   iree_hal_driver_t* driver_ = nullptr;
   iree_hal_device_info_t* device_infos_ = nullptr;
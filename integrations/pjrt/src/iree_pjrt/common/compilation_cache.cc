@@ -0,0 +1,139 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree_pjrt/common/compilation_cache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <process.h>
+
+#include <functional>
+#include <thread>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#endif  // _WIN32
+
+namespace iree::pjrt {
+
+uint64_t FingerprintCompilation(std::initializer_list<std::string_view> parts) {
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&](const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+      hash ^= static_cast<uint8_t>(data[i]);
+      hash *= 1099511628211ull;
+    }
+  };
+  for (std::string_view part : parts) {
+    uint64_t size = part.size();
+    mix(reinterpret_cast<const char*>(&size), sizeof(size));
+    mix(part.data(), part.size());
+  }
+  return hash;
+}
+
+std::string GetCompilationCachePath(std::string_view cache_dir,
+                                    uint64_t fingerprint) {
+  char key[17];
+  std::snprintf(key, sizeof(key), "%016llx",
+                static_cast<unsigned long long>(fingerprint));
+  std::string path(cache_dir);
+  path.append("/");
+  path.append(key);
+  path.append(".vmfb");
+  return path;
+}
+
+bool ReadCompilationCacheEntry(const std::string& path, std::string* out_data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return false;
+  std::stringstream contents;
+  contents << file.rdbuf();
+  if (!file.good() && !file.eof()) return false;
+  *out_data = contents.str();
+  return !out_data->empty();
+}
+
+namespace {
+
+#if defined(_WIN32)
+
+// Writes |data| to a new temporary file next to |path|. The name includes the
+// process and thread IDs as no other writer can be using both at once.
+bool WriteTemporaryFile(const std::string& path, std::string_view data,
+                        std::string* out_temp_path) {
+  std::string temp_path = path;
+  temp_path.append(".tmp.");
+  temp_path.append(std::to_string(_getpid()));
+  temp_path.append(".");
+  temp_path.append(
+      std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+  std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+  if (!file) return false;
+  file.write(data.data(), data.size());
+  file.close();
+  if (!file.good()) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  *out_temp_path = std::move(temp_path);
+  return true;
+}
+
+#else
+
+// Writes |data| to a new temporary file next to |path|. mkstemp guarantees the
+// file did not exist before so no other writer in any process can share it.
+bool WriteTemporaryFile(const std::string& path, std::string_view data,
+                        std::string* out_temp_path) {
+  std::string temp_path = path;
+  temp_path.append(".tmp.XXXXXX");
+  int fd = mkstemp(temp_path.data());
+  if (fd < 0) return false;
+  // mkstemp creates the file owner-only; entries are readable like any other
+  // file written to the cache directory.
+  fchmod(fd, 0644);
+  const char* ptr = data.data();
+  size_t remaining = data.size();
+  while (remaining > 0) {
+    ssize_t written = write(fd, ptr, remaining);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    ptr += written;
+    remaining -= written;
+  }
+  if (close(fd) != 0 || remaining > 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  *out_temp_path = std::move(temp_path);
+  return true;
+}
+
+#endif  // _WIN32
+
+}  // namespace
+
+bool WriteCompilationCacheEntry(const std::string& path,
+                                std::string_view data) {
+  std::string temp_path;
+  if (!WriteTemporaryFile(path, data, &temp_path)) return false;
+  if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace iree::pjrt
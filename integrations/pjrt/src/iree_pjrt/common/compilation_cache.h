@@ -0,0 +1,38 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_PJRT_PLUGIN_PJRT_COMMON_COMPILATION_CACHE_H_
+#define IREE_PJRT_PLUGIN_PJRT_COMMON_COMPILATION_CACHE_H_
+
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace iree::pjrt {
+
+// Computes a 64-bit FNV-1a fingerprint over |parts|. Each part is prefixed
+// by its length so that moving bytes between adjacent parts changes the key.
+uint64_t FingerprintCompilation(std::initializer_list<std::string_view> parts);
+
+// Returns the path of the cache entry for |fingerprint| under |cache_dir|.
+std::string GetCompilationCachePath(std::string_view cache_dir,
+                                    uint64_t fingerprint);
+
+// Reads the cache entry at |path| into |out_data|. Returns false if there is
+// no entry or it could not be read.
+bool ReadCompilationCacheEntry(const std::string& path, std::string* out_data);
+
+// Writes |data| to the cache entry at |path|. The entry is written to a
+// uniquely named temporary file first and renamed into place so that
+// concurrent readers and writers (including other processes sharing the
+// cache) never observe a partial entry. Returns false on failure; callers may
+// ignore it as the cache is only an optimization.
+bool WriteCompilationCacheEntry(const std::string& path, std::string_view data);
+
+}  // namespace iree::pjrt
+
+#endif  // IREE_PJRT_PLUGIN_PJRT_COMMON_COMPILATION_CACHE_H_
@@ -0,0 +1,116 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree_pjrt/common/compilation_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace iree::pjrt {
+namespace {
+
+class CompilationCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const char* test_name =
+        ::testing::UnitTest::GetInstance()->current_test_info()->name();
+    cache_dir_ = std::filesystem::path(::testing::TempDir()) / test_name;
+    std::filesystem::remove_all(cache_dir_);
+    std::filesystem::create_directories(cache_dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(cache_dir_); }
+
+  // Returns the file name of the entry at |path|.
+  static std::string EntryName(const std::string& path) {
+    return std::filesystem::path(path).filename().string();
+  }
+
+  // Returns the names of all files in the cache directory.
+  std::vector<std::string> ListCacheDir() {
+    std::vector<std::string> names;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir_)) {
+      names.push_back(entry.path().filename().string());
+    }
+    return names;
+  }
+
+  std::filesystem::path cache_dir_;
+};
+
+TEST_F(CompilationCacheTest, FingerprintCoversAllParts) {
+  uint64_t base = FingerprintCompilation({"program", "flags", "platform"});
+  EXPECT_EQ(base, FingerprintCompilation({"program", "flags", "platform"}));
+  EXPECT_NE(base, FingerprintCompilation({"program2", "flags", "platform"}));
+  EXPECT_NE(base, FingerprintCompilation({"program", "flags2", "platform"}));
+  EXPECT_NE(base, FingerprintCompilation({"program", "flags", "platform2"}));
+  // Moving bytes between adjacent parts changes the key.
+  EXPECT_NE(base, FingerprintCompilation({"programf", "lags", "platform"}));
+}
+
+TEST_F(CompilationCacheTest, MissThenHit) {
+  std::string path = GetCompilationCachePath(
+      cache_dir_.string(), FingerprintCompilation({"program"}));
+  std::string data;
+  EXPECT_FALSE(ReadCompilationCacheEntry(path, &data));
+
+  ASSERT_TRUE(WriteCompilationCacheEntry(path, "executable"));
+  ASSERT_TRUE(ReadCompilationCacheEntry(path, &data));
+  EXPECT_EQ(data, "executable");
+
+  // Other keys still miss.
+  std::string other_path = GetCompilationCachePath(
+      cache_dir_.string(), FingerprintCompilation({"other program"}));
+  EXPECT_NE(path, other_path);
+  EXPECT_FALSE(ReadCompilationCacheEntry(other_path, &data));
+
+  // Only the entry remains; the temporary file was renamed into place.
+  EXPECT_THAT(ListCacheDir(), ::testing::ElementsAre(EntryName(path)));
+}
+
+TEST_F(CompilationCacheTest, EmptyEntryMisses) {
+  std::string path = GetCompilationCachePath(cache_dir_.string(), 0);
+  ASSERT_TRUE(WriteCompilationCacheEntry(path, ""));
+  std::string data;
+  EXPECT_FALSE(ReadCompilationCacheEntry(path, &data));
+}
+
+TEST_F(CompilationCacheTest, WriteFailsWithoutDirectory) {
+  std::string path = GetCompilationCachePath(
+      (cache_dir_ / "missing").string(), FingerprintCompilation({"program"}));
+  EXPECT_FALSE(WriteCompilationCacheEntry(path, "executable"));
+  EXPECT_THAT(ListCacheDir(), ::testing::IsEmpty());
+}
+
+// Tests many threads writing the same entry at once, as happens when several
+// processes sharing the cache compile the same program. Every write must use
+// its own temporary file so readers only ever see a complete entry.
+TEST_F(CompilationCacheTest, ConcurrentWrites) {
+  std::string path = GetCompilationCachePath(
+      cache_dir_.string(), FingerprintCompilation({"program"}));
+  const std::string executable(64 * 1024, 'x');
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 16; ++j) {
+        EXPECT_TRUE(WriteCompilationCacheEntry(path, executable));
+        std::string data;
+        ASSERT_TRUE(ReadCompilationCacheEntry(path, &data));
+        EXPECT_EQ(data, executable);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_THAT(ListCacheDir(), ::testing::ElementsAre(EntryName(path)));
+}
+
+}  // namespace
+}  // namespace iree::pjrt
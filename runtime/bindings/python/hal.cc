@@ -137,6 +137,11 @@ py::dict HalAllocator::QueryStatistics() {
   items["device_bytes_peak"] = stats.device_bytes_peak;
   items["device_bytes_allocated"] = stats.device_bytes_allocated;
   items["device_bytes_freed"] = stats.device_bytes_freed;
+  items["pool_hits"] = stats.pool_hits;
+  items["pool_misses"] = stats.pool_misses;
+  items["pool_bytes_reserved"] = stats.pool_bytes_reserved;
+  items["pool_bytes_used"] = stats.pool_bytes_used;
+  items["pool_bytes_requested"] = stats.pool_bytes_requested;
 #endif
   return items;
 }
@@ -262,6 +267,97 @@ HalBuffer HalAllocator::AllocateHostStagingBufferCopy(HalDevice& device,
   return HalBuffer::StealFromRawPtr(hal_buffer);
 }
 
+py::object HalAllocator::ImportHostBuffer(
+    int memory_type, int allowed_usage, py::object buffer,
+    std::optional<uint64_t> raw_element_type) {
+  IREE_TRACE_SCOPE_NAMED("HalAllocator::ImportHostBuffer");
+  // The Py_buffer is kept alive (along with a reference to its exporter) for
+  // as long as the imported HAL buffer is. Only C-contiguous ND-arrays can be
+  // aliased so we request that and let the caller fall back to a copy when
+  // the exporter cannot provide it.
+  struct ImportedView {
+    Py_buffer view;
+    // Set once the import succeeds. Implementations may destroy a partially
+    // constructed buffer on failure and the view is released by the caller in
+    // that case.
+    bool owned_by_buffer = false;
+  };
+  auto imported_view = std::make_unique<ImportedView>();
+  iree_hal_memory_access_t access = IREE_HAL_MEMORY_ACCESS_ALL;
+  if (PyObject_GetBuffer(buffer.ptr(), &imported_view->view,
+                         PyBUF_FORMAT | PyBUF_ND | PyBUF_WRITABLE) != 0) {
+    // Read-only exporters (bytes, read-only arrays) can still be imported
+    // but the device must not write to them.
+    PyErr_Clear();
+    if (PyObject_GetBuffer(buffer.ptr(), &imported_view->view,
+                           PyBUF_FORMAT | PyBUF_ND) != 0) {
+      PyErr_Clear();
+      return py::none();
+    }
+    access = IREE_HAL_MEMORY_ACCESS_READ;
+  }
+  Py_buffer& py_view = imported_view->view;
+
+  iree_hal_buffer_params_t params = {0};
+  params.type = memory_type | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  params.usage = allowed_usage;
+  params.access = access;
+
+  iree_hal_external_buffer_t external_buffer;
+  memset(&external_buffer, 0, sizeof(external_buffer));
+  external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+  external_buffer.flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE;
+  external_buffer.size = py_view.len;
+  external_buffer.handle.host_allocation.ptr = py_view.buf;
+  iree_hal_buffer_release_callback_t release_callback = {
+      +[](void* user_data, struct iree_hal_buffer_t* buffer) {
+        auto* imported_view = static_cast<ImportedView*>(user_data);
+        if (!imported_view->owned_by_buffer) return;
+        // Buffers may be released from runtime threads and during interpreter
+        // shutdown; leak the view rather than touch a dead interpreter.
+        if (Py_IsInitialized()) {
+          py::gil_scoped_acquire acquire;
+          PyBuffer_Release(&imported_view->view);
+        }
+        delete imported_view;
+      },
+      imported_view.get(),
+  };
+
+  iree_hal_buffer_t* hal_buffer = nullptr;
+  iree_status_t status = iree_hal_allocator_import_buffer(
+      raw_ptr(), params, &external_buffer, release_callback, &hal_buffer);
+  if (!iree_status_is_ok(status)) {
+    // Not all devices can import all host memory (alignment, memory types,
+    // missing extensions); signal the caller to fall back to a copy.
+    iree_status_ignore(status);
+    PyBuffer_Release(&py_view);
+    return py::none();
+  }
+  imported_view->owned_by_buffer = true;
+  imported_view.release();  // Ownership transferred to the HAL buffer.
+
+  if (!raw_element_type) {
+    return py::cast(HalBuffer::StealFromRawPtr(hal_buffer),
+                    py::rv_policy::move);
+  }
+
+  iree_hal_element_types_t element_type =
+      (iree_hal_element_types_t)*raw_element_type;
+  std::vector<iree_hal_dim_t> dims(py_view.ndim);
+  std::copy(py_view.shape, py_view.shape + py_view.ndim, dims.begin());
+  iree_hal_buffer_view_t* hal_buffer_view = nullptr;
+  status = iree_hal_buffer_view_create(
+      hal_buffer, dims.size(), dims.data(), element_type,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      iree_hal_allocator_host_allocator(raw_ptr()), &hal_buffer_view);
+  iree_hal_buffer_release(hal_buffer);
+  CheckApiStatus(status, "Error allocating buffer_view");
+
+  return py::cast(HalBufferView::StealFromRawPtr(hal_buffer_view),
+                  py::rv_policy::move);
+}
+
 //------------------------------------------------------------------------------
 // HalBuffer
 //------------------------------------------------------------------------------
@@ -551,7 +647,8 @@ void HalDevice::QueueExecute(py::handle command_buffers,
 
   CheckApiStatus(
       iree_hal_device_queue_execute(raw_ptr(), IREE_HAL_QUEUE_AFFINITY_ANY,
-                                    wait_list, signal_list, cb_count, cb_list),
+                                    wait_list, signal_list, cb_count, cb_list,
+                                    /*binding_tables=*/NULL),
       "executing command buffers");
 }
 
@@ -850,10 +947,20 @@ HalBufferView HalDevice::FromDLPackCapsule(py::object input_capsule) {
   params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
   iree_hal_external_buffer_t external_buffer;
   memset(&external_buffer, 0, sizeof(external_buffer));
-  external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION;
   external_buffer.size = byte_size;
-  external_buffer.handle.device_allocation.ptr =
-      reinterpret_cast<uint64_t>(dlt->data);
+  if (dlt->device.device_type == kDLCPU) {
+    // Plain host memory (numpy and friends) has to be imported as a host
+    // allocation so that devices with their own address spaces can register
+    // it instead of treating the pointer as device memory.
+    params.type =
+        IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+    external_buffer.handle.host_allocation.ptr = dlt->data;
+  } else {
+    external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION;
+    external_buffer.handle.device_allocation.ptr =
+        reinterpret_cast<uint64_t>(dlt->data);
+  }
   iree_hal_buffer_release_callback_t release_callback = {
       +[](void* user_data, struct iree_hal_buffer_t* buffer) {
         auto managed_tensor = static_cast<DLManagedTensor*>(user_data);
@@ -1347,7 +1454,16 @@ void SetupHalBindings(nanobind::module_ m) {
            "object. The buffer is configured as optimal for use on the device "
            "as a transfer buffer. For buffers of unknown providence, this is a "
            "last resort method for making them compatible for transfer to "
-           "arbitrary devices.");
+           "arbitrary devices.")
+      .def("import_host_buffer", &HalAllocator::ImportHostBuffer,
+           py::arg("memory_type"), py::arg("allowed_usage"), py::arg("buffer"),
+           py::arg("element_type") = py::none(), py::keep_alive<0, 1>(),
+           "Imports the memory of a Python buffer object without copying. "
+           "The returned Buffer (or BufferView if an element type is "
+           "specified) aliases the Python buffer and keeps it alive. Returns "
+           "None if the allocator cannot import the memory with the given "
+           "parameters, in which case allocate_buffer_copy should be used. "
+           "Read-only buffers are imported with read-only access.");
 
   auto hal_buffer = py::class_<HalBuffer>(m, "HalBuffer");
   VmRef::BindRefProtocol(hal_buffer, iree_hal_buffer_type,
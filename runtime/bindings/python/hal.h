@@ -164,6 +164,9 @@ class HalAllocator : public ApiRefCounted<HalAllocator, iree_hal_allocator_t> {
                                 HalDevice& device, py::object buffer,
                                 std::optional<uint64_t> element_type);
   HalBuffer AllocateHostStagingBufferCopy(HalDevice& device, py::handle buffer);
+  py::object ImportHostBuffer(int memory_type, int allowed_usage,
+                              py::object buffer,
+                              std::optional<uint64_t> element_type);
 };
 
 struct HalShape {
@@ -54,6 +54,7 @@ from ._binding import (
     VmContext,
     VmModule,
     VmRef,
+    VmStack,
 )
 
 from .array_interop import *
@@ -83,6 +83,13 @@ class HalAllocator:
     def allocate_host_staging_buffer_copy(
         self, device: HalDevice, initial_contents: object
     ) -> HalBuffer: ...
+    def import_host_buffer(
+        self,
+        memory_type: Union[MemoryType, int],
+        allowed_usage: Union[BufferUsage, int],
+        buffer: object,
+        element_type: Optional[HalElementType] = ...,
+    ) -> Optional[Union[HalBuffer, HalBufferView]]: ...
     def query_buffer_compatibility(
         self,
         memory_type: Union[MemoryType, int],
@@ -458,12 +465,19 @@ class VmContext:
         self, instance: VmInstance, modules: Optional[list[VmModule]] = None
     ) -> None: ...
     def invoke(
-        self, function: VmFunction, inputs: VmVariantList, outputs: VmVariantList
+        self,
+        function: VmFunction,
+        inputs: VmVariantList,
+        outputs: VmVariantList,
+        stack: Optional[VmStack] = None,
     ) -> None: ...
     def register_modules(self, modules: Sequence[VmModule]) -> None: ...
     @property
     def context_id(self) -> int: ...
 
+class VmStack:
+    def __init__(self, context: VmContext) -> None: ...
+
 class VmFunction:
     @property
     def linkage(self) -> int: ...
@@ -22,9 +22,28 @@ from ._binding import (
 
 __all__ = [
     "asdevicearray",
+    "from_dlpack",
     "DeviceArray",
 ]
 
+# DLPack DLDeviceType codes keyed by the HAL device id prefix. Devices not
+# listed are treated as CPU devices operating on host memory.
+_DLPACK_DEVICE_TYPES = (
+    ("cuda", 2),  # kDLCUDA
+    ("vulkan", 7),  # kDLVulkan
+    ("metal", 8),  # kDLMetal
+    ("hip", 10),  # kDLROCM
+)
+_DLPACK_CPU_DEVICE_TYPE = 1  # kDLCPU
+
+
+def _dlpack_device_of(device: HalDevice) -> Tuple[int, int]:
+    device_id = repr(device)
+    for prefix, device_type in _DLPACK_DEVICE_TYPES:
+        if device_id.startswith(prefix):
+            return (device_type, 0)
+    return (_DLPACK_CPU_DEVICE_TYPE, 0)
+
 _DEVICE_HANDLED_FUNCTIONS = {}
 
 
@@ -98,6 +117,31 @@ class DeviceArray(numpy.lib.mixins.NDArrayOperatorsMixin):
     def __repr__(self):
         return f"<IREE DeviceArray: shape={np.shape(self)}, dtype={self.dtype}>"
 
+    def __dlpack_device__(self) -> Tuple[int, int]:
+        return _dlpack_device_of(self._device)
+
+    def __dlpack__(self, *, stream=None, max_version=None, dl_device=None, copy=None):
+        """Exports the array as a DLPack capsule aliasing the device buffer.
+
+        Device arrays are only produced once their contents are available (the
+        synchronous invocation ABI waits for results) so no synchronization
+        with the consumer `stream` is required. If `copy` is True the contents
+        are transferred to a new host array which is exported instead.
+        """
+        if copy:
+            return np.array(self.to_host(), copy=True).__dlpack__()
+        if self._override_dtype is not None and (
+            self._override_dtype != self._get_raw_dtype()
+        ):
+            raise BufferError(
+                f"Cannot export a DeviceArray with an overridden dtype "
+                f"({self._override_dtype}) without copying"
+            )
+        device_type, device_id = self.__dlpack_device__()
+        return self._device.create_dlpack_capsule(
+            self._buffer_view, device_type, device_id
+        )
+
     @property
     def is_host_accessible(self):
         """Whether this array is currently host accessible."""
@@ -241,6 +285,7 @@ def asdevicearray(
     memory_type=MemoryType.DEVICE_LOCAL,
     allowed_usage=(BufferUsage.DEFAULT | BufferUsage.MAPPING),
     element_type: Optional[HalElementType] = None,
+    zero_copy: bool = True,
 ) -> DeviceArray:
     """Helper to create a DeviceArray from an arbitrary array like.
 
@@ -254,6 +299,12 @@ def asdevicearray(
     Note that additional flags `memory_type`, `allowed_usage` and `element_type`
     are only hints if creating a new DeviceArray. If `a` is already a DeviceArray,
     they are ignored.
+
+    If `zero_copy` is set and the device can import the host memory backing the
+    (C-contiguous) array then the returned DeviceArray aliases it and keeps it
+    alive instead of copying, matching the semantics of np.asarray: subsequent
+    host writes to `a` are visible to the device. Devices that cannot import
+    host memory with the requested parameters fall back to a copy.
     """
     if isinstance(a, DeviceArray):
         if dtype is None:
@@ -268,13 +319,22 @@ def asdevicearray(
     element_type = map_dtype_to_element_type(a.dtype)
     if element_type is None:
         raise ValueError(f"Could not map dtype {a.dtype} to IREE element type")
-    buffer_view = device.allocator.allocate_buffer_copy(
-        memory_type=memory_type,
-        allowed_usage=allowed_usage,
-        device=device,
-        buffer=a,
-        element_type=element_type,
-    )
+    buffer_view = None
+    if zero_copy:
+        buffer_view = device.allocator.import_host_buffer(
+            memory_type=memory_type,
+            allowed_usage=allowed_usage,
+            buffer=a,
+            element_type=element_type,
+        )
+    if buffer_view is None:
+        buffer_view = device.allocator.allocate_buffer_copy(
+            memory_type=memory_type,
+            allowed_usage=allowed_usage,
+            device=device,
+            buffer=a,
+            element_type=element_type,
+        )
     return DeviceArray(
         device,
         buffer_view,
@@ -283,6 +343,25 @@ def asdevicearray(
     )
 
 
+def from_dlpack(
+    device: HalDevice, x, *, implicit_host_transfer: bool = False
+) -> DeviceArray:
+    """Creates a DeviceArray aliasing the memory of a DLPack tensor.
+
+    `x` may either be an object implementing `__dlpack__` (such as a numpy
+    array or framework tensor) or a DLPack capsule. The tensor memory is
+    imported into `device` without copying and the producer is kept alive
+    until the returned array and any buffers derived from it are released.
+    Tensors must be dense row-major; host tensors must be suitably aligned for
+    import by the device.
+    """
+    capsule = x.__dlpack__() if hasattr(x, "__dlpack__") else x
+    buffer_view = device.from_dlpack_capsule(capsule)
+    return DeviceArray(
+        device, buffer_view, implicit_host_transfer=implicit_host_transfer
+    )
+
+
 # NOTE: Numpy dtypes are not hashable and exist in a hierarchy that should
 # be queried via isinstance checks. This should be done as a fallback but
 # this is a linear list for quick access to the most common. There may also
@@ -6,8 +6,10 @@
 
 from typing import Dict, Optional
 
+import concurrent.futures
 import json
 import logging
+import threading
 
 import numpy as np
 
@@ -37,6 +39,21 @@ __all__ = [
     "FunctionInvoker",
 ]
 
+# Worker used by FunctionInvoker.invoke_async. A single worker serializes all
+# asynchronous invocations as VM contexts are not thread-safe.
+_async_executor: Optional[concurrent.futures.ThreadPoolExecutor] = None
+_async_executor_lock = threading.Lock()
+
+
+def _get_async_executor() -> concurrent.futures.ThreadPoolExecutor:
+    global _async_executor
+    with _async_executor_lock:
+        if _async_executor is None:
+            _async_executor = concurrent.futures.ThreadPoolExecutor(
+                max_workers=1, thread_name_prefix="iree-invoke"
+            )
+        return _async_executor
+
 
 class Invocation:
     __slots__ = [
@@ -114,17 +131,45 @@ class FunctionInvoker:
         return self._vm_function
 
     def __call__(self, *args, **kwargs):
+        arg_list, ret_list = self._prepare(args, kwargs)
+        self._invoke(arg_list, ret_list)
+        return self._unpack_results(ret_list)
+
+    def invoke_async(self, *args, **kwargs) -> concurrent.futures.Future:
+        """Invokes the function without blocking the calling thread.
+
+        Arguments are packed on the calling thread and the invocation runs on a
+        background worker with the GIL released, allowing other Python threads
+        (and event loops) to make progress. Returns a future resolving to the
+        same value that calling the function would return. asyncio users can
+        await the result with `asyncio.wrap_future`.
+
+        Asynchronous invocations are executed one at a time in submission order.
+        Synchronous calls into the same context must not be made while
+        asynchronous invocations are pending.
+        """
+        arg_list, ret_list = self._prepare(args, kwargs)
+
+        def run():
+            self._invoke(arg_list, ret_list)
+            return self._unpack_results(ret_list)
+
+        return _get_async_executor().submit(run)
+
+    def _prepare(self, args, kwargs):
         invoke_context = InvokeContext(self._device)
         arg_list = self._arg_packer.pack(invoke_context, args, kwargs)
 
         # Initialize the capacity to our total number of args, since we should
         # be below that when doing a flat invocation. May want to be more
         # conservative here when considering nesting.
-        inv = Invocation(self._device)
         ret_descs = self._ret_descs
-
         ret_list = VmVariantList(len(ret_descs) if ret_descs is not None else 1)
-        self._invoke(arg_list, ret_list)
+        return arg_list, ret_list
+
+    def _unpack_results(self, ret_list: VmVariantList):
+        inv = Invocation(self._device)
+        ret_descs = self._ret_descs
 
         # Un-inline the results to align with reflection, as needed.
         reflection_aligned_ret_list = ret_list
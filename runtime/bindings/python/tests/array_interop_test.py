@@ -157,6 +157,45 @@ class DeviceHalTest(unittest.TestCase):
         self.assertEqual(f32_copy.dtype, np.float32)
         np.testing.assert_array_equal(orig_ary.astype(np.float32), f32_copy)
 
+    def testZeroCopyAliasesHostMemory(self):
+        init_ary = np.zeros([3, 4], dtype=np.int32) + 2
+        ary = iree.runtime.asdevicearray(self.device, init_ary)
+        # The local device imports host memory so writes are visible.
+        init_ary[0, 0] = 7
+        self.assertEqual(ary.to_host()[0, 0], 7)
+
+    def testZeroCopyRetainsHostMemory(self):
+        init_ary = np.zeros([3, 4], dtype=np.float32) + 2
+        ary = iree.runtime.asdevicearray(self.device, init_ary)
+        init_ary = None
+        gc.collect()
+        np.testing.assert_array_equal(
+            ary.to_host(), np.zeros([3, 4], dtype=np.float32) + 2
+        )
+
+    def testZeroCopyReadOnly(self):
+        init_ary = np.zeros([3, 4], dtype=np.int32) + 2
+        init_ary.flags.writeable = False
+        ary = iree.runtime.asdevicearray(self.device, init_ary)
+        np.testing.assert_array_equal(ary.to_host(), init_ary)
+
+    def testZeroCopyDisabled(self):
+        init_ary = np.zeros([3, 4], dtype=np.int32) + 2
+        ary = iree.runtime.asdevicearray(self.device, init_ary, zero_copy=False)
+        init_ary[0, 0] = 7
+        self.assertEqual(ary.to_host()[0, 0], 2)
+
+    def testImportHostBuffer(self):
+        init_ary = np.arange(12, dtype=np.int32).reshape([3, 4])
+        buffer_view = self.allocator.import_host_buffer(
+            memory_type=iree.runtime.MemoryType.DEVICE_LOCAL,
+            allowed_usage=iree.runtime.BufferUsage.DEFAULT,
+            buffer=init_ary,
+            element_type=iree.runtime.HalElementType.SINT_32,
+        )
+        self.assertIsNotNone(buffer_view)
+        self.assertEqual([3, 4], buffer_view.shape)
+
     def testBool(self):
         init_ary = np.zeros([3, 4], dtype=np.bool_)
         init_ary[1] = True  # Set some non-zero value.
@@ -164,6 +203,33 @@ class DeviceHalTest(unittest.TestCase):
         self.assertEqual(repr(ary), "<IREE DeviceArray: shape=[3, 4], dtype=bool>")
         np.testing.assert_array_equal(ary.to_host(), init_ary)
 
+    def testDLPackExport(self):
+        init_ary = np.arange(12, dtype=np.float32).reshape(3, 4)
+        ary = iree.runtime.asdevicearray(self.device, init_ary)
+        self.assertEqual((1, 0), ary.__dlpack_device__())
+        exported = np.from_dlpack(ary)
+        ary = None
+        gc.collect()
+        np.testing.assert_array_equal(exported, init_ary)
+
+    def testDLPackExportCopy(self):
+        init_ary = np.arange(6, dtype=np.int32)
+        ary = iree.runtime.asdevicearray(self.device, init_ary)
+        exported = np.from_dlpack(ary.__dlpack__(copy=True))
+        np.testing.assert_array_equal(exported, init_ary)
+
+    def testDLPackImport(self):
+        # Round trip through a device array so that the imported memory has the
+        # alignment required for import.
+        init_ary = np.arange(12, dtype=np.int32).reshape(3, 4)
+        source = iree.runtime.asdevicearray(self.device, init_ary)
+        ary = iree.runtime.from_dlpack(self.device, source)
+        source = None
+        gc.collect()
+        self.assertEqual([3, 4], ary.shape)
+        self.assertEqual(np.int32, ary.dtype)
+        np.testing.assert_array_equal(ary.to_host(), init_ary)
+
 
 if __name__ == "__main__":
     unittest.main()
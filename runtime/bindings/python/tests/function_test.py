@@ -56,6 +56,18 @@ class FunctionTest(unittest.TestCase):
         self.assertEqual("[<VmVariantList(2): [1, 2]>]", vm_context.mock_arg_reprs)
         self.assertEqual((3, 4), result)
 
+    def testInvokeAsync(self):
+        def invoke(arg_list, ret_list):
+            ret_list.push_int(3)
+            ret_list.push_int(4)
+
+        vm_context = MockVmContext(invoke)
+        vm_function = MockVmFunction(reflection={})
+        invoker = FunctionInvoker(vm_context, self.device, vm_function)
+        future = invoker.invoke_async(1, 2)
+        self.assertEqual((3, 4), future.result())
+        self.assertEqual("[<VmVariantList(2): [1, 2]>]", vm_context.mock_arg_reprs)
+
     def testKeywordArgs(self):
         def invoke(arg_list, ret_list):
             ret_list.push_int(3)
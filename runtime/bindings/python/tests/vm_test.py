@@ -115,6 +115,20 @@ class VmTest(unittest.TestCase):
         logging.info("result: %s", result)
         self.assertEqual(result, 11)
 
+    def test_invoke_reused_stack(self):
+        m = create_add_scalar_module(self.instance)
+        context = iree.runtime.VmContext(self.instance, modules=[self.hal_module, m])
+        f = m.lookup_function("add_scalar")
+        stack = iree.runtime.VmStack(context)
+        outputs = iree.runtime.VmVariantList(1)
+        for i in range(3):
+            inputs = iree.runtime.VmVariantList(2)
+            inputs.push_int(i)
+            inputs.push_int(10)
+            context.invoke(f, inputs, outputs, stack=stack)
+            self.assertEqual(len(outputs), 1)
+            self.assertEqual(outputs.get_variant(0), i + 10)
+
     def test_unaligned_buffer_error(self):
         buffer = memoryview(b"foobar")
         with self.assertRaisesRegex(ValueError, "unaligned buffer"):
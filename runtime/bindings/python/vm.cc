@@ -212,17 +212,44 @@ void VmContext::RegisterModules(std::vector<VmModule*> modules) {
 }
 
 void VmContext::Invoke(iree_vm_function_t f, VmVariantList& inputs,
-                       VmVariantList& outputs) {
+                       VmVariantList& outputs, VmStack* stack) {
   iree_status_t status;
   {
     py::gil_scoped_release release;
-    status = iree_vm_invoke(raw_ptr(), f, IREE_VM_INVOCATION_FLAG_NONE, nullptr,
-                            inputs.raw_ptr(), outputs.raw_ptr(),
-                            iree_allocator_system());
+    if (stack) {
+      status = iree_vm_invoke_with_stack(stack->raw_ptr(), raw_ptr(), f,
+                                         nullptr, inputs.raw_ptr(),
+                                         outputs.raw_ptr());
+    } else {
+      status = iree_vm_invoke(raw_ptr(), f, IREE_VM_INVOCATION_FLAG_NONE,
+                              nullptr, inputs.raw_ptr(), outputs.raw_ptr(),
+                              iree_allocator_system());
+    }
   }
   CheckApiStatus(status, "Error invoking function");
 }
 
+//------------------------------------------------------------------------------
+// VmStack
+//------------------------------------------------------------------------------
+
+VmStack::VmStack(VmContext& context) : context_(context.raw_ptr()) {
+  iree_vm_context_retain(context_);
+  auto status = iree_vm_stack_allocate(
+      IREE_VM_INVOCATION_FLAG_NONE, iree_vm_context_state_resolver(context_),
+      iree_allocator_system(), &stack_);
+  if (!iree_status_is_ok(status)) {
+    iree_vm_context_release(context_);
+    context_ = nullptr;
+  }
+  CheckApiStatus(status, "Error allocating vm stack");
+}
+
+VmStack::~VmStack() {
+  if (stack_) iree_vm_stack_free(stack_);
+  if (context_) iree_vm_context_release(context_);
+}
+
 //------------------------------------------------------------------------------
 // VmModule
 //------------------------------------------------------------------------------
@@ -929,7 +956,12 @@ void SetupVmBindings(nanobind::module_ m) {
           py::arg("modules") = std::optional<std::vector<VmModule*>>())
       .def("register_modules", &VmContext::RegisterModules)
       .def_prop_ro("context_id", &VmContext::context_id)
-      .def("invoke", &VmContext::Invoke);
+      .def("invoke", &VmContext::Invoke, py::arg("function"),
+           py::arg("inputs"), py::arg("outputs"),
+           py::arg("stack") = py::none());
+
+  py::class_<VmStack>(m, "VmStack")
+      .def(py::init<VmContext&>(), py::arg("context"));
 
   py::class_<VmModule>(m, "VmModule")
       .def_static("resolve_module_dependency",
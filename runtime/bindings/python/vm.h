@@ -168,6 +168,8 @@ class VmModule : public ApiRefCounted<VmModule, iree_vm_module_t> {
 // VmContext
 //------------------------------------------------------------------------------
 
+class VmStack;
+
 class VmContext : public ApiRefCounted<VmContext, iree_vm_context_t> {
  public:
   // Creates a context, optionally with modules, which will make the context
@@ -184,8 +186,27 @@ class VmContext : public ApiRefCounted<VmContext, iree_vm_context_t> {
   int context_id() const { return iree_vm_context_id(raw_ptr()); }
 
   // Synchronously invokes the given function.
+  // If |stack| is provided it is reused instead of initializing a new stack.
   void Invoke(iree_vm_function_t f, VmVariantList& inputs,
-              VmVariantList& outputs);
+              VmVariantList& outputs, VmStack* stack);
+};
+
+// A VM stack bound to a context that can be reused across invocations to avoid
+// per-invocation stack setup and growth. Must not be used by multiple
+// invocations concurrently.
+class VmStack {
+ public:
+  explicit VmStack(VmContext& context);
+  ~VmStack();
+  VmStack(const VmStack&) = delete;
+  VmStack& operator=(const VmStack&) = delete;
+
+  iree_vm_stack_t* raw_ptr() { return stack_; }
+
+ private:
+  // Retained as the stack state resolver references the context.
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_stack_t* stack_ = nullptr;
 };
 
 class VmInvocation : public ApiRefCounted<VmInvocation, iree_vm_invocation_t> {
@@ -198,9 +198,12 @@ static iree_status_t _TfLiteInterpreterRefreshOutputShapes(
   return iree_ok_status();
 }
 
-// Refreshes both input and output tensor shapes by querying the module.
-// This should be called after each shape change so that we can let the module
-// run "shape propagation" and compute the new output shapes.
+// Refreshes tensor shapes by querying the module. Input shapes are only
+// queried if they were resized since the last query while output shapes are
+// always queried as they may depend on the input data and not just the input
+// shapes. This should be called after each shape change so that we can let the
+// module run "shape propagation" and compute the new output shapes, and after
+// each invocation for any data-dependent output shapes.
 static iree_status_t _TfLiteInterpreterRefreshIOShapes(
     TfLiteInterpreter* interpreter) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -210,7 +213,7 @@ static iree_status_t _TfLiteInterpreterRefreshIOShapes(
 
   // Query all shapes.
   iree_status_t status = iree_ok_status();
-  if (iree_status_is_ok(status)) {
+  if (iree_status_is_ok(status) && interpreter->io_shapes_dirty) {
     status = _TfLiteInterpreterRefreshInputShapes(interpreter, &frame);
   }
   if (iree_status_is_ok(status)) {
@@ -218,6 +221,7 @@ static iree_status_t _TfLiteInterpreterRefreshIOShapes(
   }
 
   _TfLiteInterpreterShapeFrameDeinitialize(&frame);
+  if (iree_status_is_ok(status)) interpreter->io_shapes_dirty = false;
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -255,6 +259,7 @@ static iree_status_t _TfLiteInterpreterAllocate(
   memset(interpreter, 0, interpreter_size);
   interpreter->allocator = model->allocator;
   _TfLiteInterpreterOptionsSetDefaults(&interpreter->options);
+  interpreter->io_shapes_dirty = true;
   *out_interpreter = interpreter;
 
   interpreter->model = (TfLiteModel*)model;
@@ -483,20 +488,29 @@ static iree_status_t _TfLiteInterpreterResizeInputTensor(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "model has no dynamic shapes");
   }
+  if (input_dims_size < 0 || input_dims_size > IREE_BINDINGS_TFLITE_MAX_RANK) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "input rank out of range (0 <= %d <= %d)",
+                            input_dims_size, IREE_BINDINGS_TFLITE_MAX_RANK);
+  }
+  int32_t shape_dims[IREE_BINDINGS_TFLITE_MAX_RANK];
+  for (int32_t i = 0; i < input_dims_size; ++i) {
+    shape_dims[i] = (int32_t)input_dims[i];
+  }
 
   _TfLiteInterpreterShapeFrame frame;
   IREE_RETURN_IF_ERROR(_TfLiteInterpreterShapeFrameInitialize(&frame));
 
   // Poke the model and let it update its internal shape.
   // TODO(#3975): return bool to allow model to say it failed.
-  TfLiteTensor* tensor = &interpreter->input_tensors[input_index];
   iree_status_t status = _TfLiteInterpreterShapeFrameWriteValue(
-      &frame, tensor->shape_rank, tensor->shape_dims);
+      &frame, input_dims_size, shape_dims);
   if (iree_status_is_ok(status)) {
     status = _TfLiteInterpreterShapeFrameApply(
         &frame, interpreter, interpreter->model->exports._resize_input_shape,
         input_index);
   }
+  if (iree_status_is_ok(status)) interpreter->io_shapes_dirty = true;
 
   // NOTE: the allocation may now not match the requested shape. This is just
   // how the tflite API works unfortunately; until
@@ -521,7 +535,9 @@ static iree_status_t _TfLiteInterpreterAllocateTensors(
   // NOTE: we could slab allocate like tflite does, but then if any single
   // tensor has any single dimension that is resized the whole thing gets
   // reallocated upon resize. That's no good. Instead, we realloc each tensor
-  // if their size has changed.
+  // if their size has changed. Input buffers remain mapped and referenced by
+  // the input list across invocations so that TfLiteInterpreterInvoke performs
+  // no allocations of its own.
 
   // Refresh all shapes from the model. It should have all of the
   // non-data-dependent output shapes.
@@ -580,17 +596,21 @@ static iree_status_t _TfLiteInterpreterInvoke(TfLiteInterpreter* interpreter) {
                      /*policy=*/NULL, interpreter->input_list,
                      interpreter->output_list, interpreter->allocator));
 
-  // Refresh output shapes.
-  // TODO(#3975): just use buffer view results or at least just refresh outputs.
+  // Refresh output shapes: data-dependent outputs only have their final shape
+  // after the invocation. Input shapes are only queried again if they were
+  // resized without a subsequent TfLiteInterpreterAllocateTensors.
+  // TODO(#3975): just use buffer view results.
   IREE_RETURN_IF_ERROR(_TfLiteInterpreterRefreshIOShapes(interpreter));
 
   // Map the output buffers.
-  // NOTE: we could defer the mapping unless requested and ensure state buffers
-  // remain where they currently are for the next invocation.
+  // Outputs that alias the buffer already bound to the tensor (such as state
+  // buffers or results the module reuses) keep their existing mapping.
+  // NOTE: we could defer the mapping unless requested.
   for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
     iree_hal_buffer_t* buffer =
         iree_vm_list_get_buffer_assign(interpreter->output_list, i);
     TfLiteTensor* tensor = &interpreter->output_tensors[i];
+    if (buffer && buffer == tensor->buffer) continue;
     IREE_RETURN_IF_ERROR(_TfLiteTensorBind(tensor, buffer));
   }
 
@@ -39,10 +39,17 @@ struct TfLiteInterpreter {
   };
   iree_vm_context_t* context;
 
+  // Persistent invocation state reused across calls to
+  // TfLiteInterpreterInvoke. The input list references the input tensor
+  // buffers and is only rebuilt by TfLiteInterpreterAllocateTensors.
   iree_vm_list_t* input_list;
   iree_vm_list_t* output_list;
   TfLiteTensor* input_tensors;
   TfLiteTensor* output_tensors;
+
+  // True if input shapes have been resized since they were last queried from
+  // the module. Output shapes are queried after every invocation regardless.
+  bool io_shapes_dirty;
 };
 
 #endif  // IREE_BINDINGS_TFLITE_INTERPRETER_H_
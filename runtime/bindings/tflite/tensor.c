@@ -133,6 +133,10 @@ iree_status_t _TfLiteTensorReallocateIfNeeded(
     return iree_ok_status();
   }
 
+  // Drop the old buffer (if any) before allocating its replacement so that we
+  // don't leak it or its mapping.
+  _TfLiteTensorDiscardBuffer(tensor);
+
   // Allocate the underlying buffer for the tensor.
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_allocator_allocate_buffer(
@@ -4,12 +4,22 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+// Needed for syscall on Linux. On other platforms does nothing.
+#define _GNU_SOURCE
+
 #include <stdlib.h>
 #include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/base/tracing.h"
 
+#if defined(IREE_PLATFORM_LINUX)
+#include <errno.h>
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX
+
 //===----------------------------------------------------------------------===//
 // iree_allocator_t (std::allocator-like interface)
 //===----------------------------------------------------------------------===//
@@ -63,6 +73,22 @@ IREE_API_EXPORT void iree_allocator_free(iree_allocator_t allocator,
   }
 }
 
+IREE_API_EXPORT iree_status_t iree_allocator_bind(
+    iree_allocator_t allocator, void* ptr, iree_host_size_t byte_length,
+    iree_allocator_node_id_t node_id, iree_allocator_bind_flags_t flags) {
+  if (IREE_UNLIKELY(!allocator.ctl)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "allocator has no control routine");
+  }
+  iree_allocator_bind_params_t params = {
+      .byte_length = byte_length,
+      .node_id = node_id,
+      .flags = flags,
+  };
+  return allocator.ctl(allocator.self, IREE_ALLOCATOR_COMMAND_BIND, &params,
+                       &ptr);
+}
+
 //===----------------------------------------------------------------------===//
 // Built-in iree_allocator_t implementations
 //===----------------------------------------------------------------------===//
@@ -135,6 +161,65 @@ static iree_status_t iree_allocator_system_free(void** inout_ptr) {
   return iree_ok_status();
 }
 
+#if defined(IREE_PLATFORM_LINUX) && defined(SYS_mbind)
+
+static iree_status_t iree_allocator_system_bind(
+    const iree_allocator_bind_params_t* params, void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(inout_ptr);
+  if (params->node_id == IREE_ALLOCATOR_NODE_ID_ANY) return iree_ok_status();
+
+  // mbind operates on whole pages so we only bind those fully within the range
+  // to avoid changing the policy of unrelated neighboring allocations.
+  long page_size = sysconf(_SC_PAGESIZE);
+  if (page_size <= 0) page_size = 4096;
+  uintptr_t begin =
+      iree_host_align((uintptr_t)*inout_ptr, (iree_host_size_t)page_size);
+  uintptr_t end = ((uintptr_t)*inout_ptr + params->byte_length) &
+                  ~((uintptr_t)page_size - 1);
+  if (end <= begin) return iree_ok_status();
+
+  // Node masks are variable-length bitmaps; we support a fixed maximum which
+  // is well beyond any system we expect to run on.
+  unsigned long node_mask[1024 / (sizeof(unsigned long) * 8)];
+  const iree_host_size_t max_node_count = sizeof(node_mask) * 8;
+  if (params->node_id >= max_node_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "NUMA node %u exceeds the supported maximum of "
+                            "%" PRIhsz,
+                            params->node_id, max_node_count);
+  }
+  memset(node_mask, 0, sizeof(node_mask));
+  node_mask[params->node_id / (sizeof(unsigned long) * 8)] |=
+      1ul << (params->node_id % (sizeof(unsigned long) * 8));
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)(end - begin));
+  unsigned flags = 0;
+  if (params->flags & IREE_ALLOCATOR_BIND_FLAG_MOVE) flags |= MPOL_MF_MOVE;
+  // NOTE: the kernel expects maxnode to be one larger than the bit count.
+  iree_status_t status = iree_ok_status();
+  if (syscall(SYS_mbind, (void*)begin, (unsigned long)(end - begin),
+              MPOL_PREFERRED, node_mask, (unsigned long)max_node_count + 1,
+              flags) != 0) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "mbind to NUMA node %u failed (%d)",
+                              params->node_id, errno);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#else
+
+static iree_status_t iree_allocator_system_bind(
+    const iree_allocator_bind_params_t* params, void** inout_ptr) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "NUMA binding not supported on this platform");
+}
+
+#endif  // IREE_PLATFORM_LINUX && SYS_mbind
+
 IREE_API_EXPORT iree_status_t
 iree_allocator_system_ctl(void* self, iree_allocator_command_t command,
                           const void* params, void** inout_ptr) {
@@ -146,6 +231,9 @@ iree_allocator_system_ctl(void* self, iree_allocator_command_t command,
           command, (const iree_allocator_alloc_params_t*)params, inout_ptr);
     case IREE_ALLOCATOR_COMMAND_FREE:
       return iree_allocator_system_free(inout_ptr);
+    case IREE_ALLOCATOR_COMMAND_BIND:
+      return iree_allocator_system_bind(
+          (const iree_allocator_bind_params_t*)params, inout_ptr);
     default:
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                               "unsupported system allocator command");
@@ -262,9 +350,10 @@ static inline void iree_aligned_ptr_set_base(void* aligned_ptr,
   ptr_ref[-1] = base_ptr;
 }
 
-IREE_API_EXPORT iree_status_t iree_allocator_malloc_aligned(
-    iree_allocator_t allocator, iree_host_size_t byte_length,
-    iree_host_size_t min_alignment, iree_host_size_t offset, void** out_ptr) {
+static iree_status_t iree_allocator_issue_alloc_aligned(
+    iree_allocator_t allocator, iree_allocator_command_t command,
+    iree_host_size_t byte_length, iree_host_size_t min_alignment,
+    iree_host_size_t offset, void** out_ptr) {
   IREE_ASSERT_ARGUMENT(out_ptr);
   if (IREE_UNLIKELY(byte_length == 0)) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
@@ -281,8 +370,8 @@ IREE_API_EXPORT iree_status_t iree_allocator_malloc_aligned(
   const iree_host_size_t total_length =
       sizeof(uintptr_t) + byte_length + alignment;
   void* unaligned_ptr = NULL;
-  IREE_RETURN_IF_ERROR(
-      iree_allocator_malloc(allocator, total_length, (void**)&unaligned_ptr));
+  IREE_RETURN_IF_ERROR(iree_allocator_issue_alloc(
+      allocator, command, total_length, (void**)&unaligned_ptr));
   void* aligned_ptr = iree_aligned_ptr(unaligned_ptr, alignment, offset);
 
   iree_aligned_ptr_set_base(aligned_ptr, unaligned_ptr);
@@ -290,6 +379,24 @@ IREE_API_EXPORT iree_status_t iree_allocator_malloc_aligned(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t iree_allocator_malloc_aligned(
+    iree_allocator_t allocator, iree_host_size_t byte_length,
+    iree_host_size_t min_alignment, iree_host_size_t offset, void** out_ptr) {
+  return iree_allocator_issue_alloc_aligned(allocator,
+                                            IREE_ALLOCATOR_COMMAND_CALLOC,
+                                            byte_length, min_alignment, offset,
+                                            out_ptr);
+}
+
+IREE_API_EXPORT iree_status_t iree_allocator_malloc_aligned_uninitialized(
+    iree_allocator_t allocator, iree_host_size_t byte_length,
+    iree_host_size_t min_alignment, iree_host_size_t offset, void** out_ptr) {
+  return iree_allocator_issue_alloc_aligned(allocator,
+                                            IREE_ALLOCATOR_COMMAND_MALLOC,
+                                            byte_length, min_alignment, offset,
+                                            out_ptr);
+}
+
 IREE_API_EXPORT iree_status_t iree_allocator_realloc_aligned(
     iree_allocator_t allocator, iree_host_size_t byte_length,
     iree_host_size_t min_alignment, iree_host_size_t offset, void** inout_ptr) {
@@ -160,11 +160,17 @@ typedef enum iree_allocator_command_e {
   //   inout_ptr: pointer to free
   IREE_ALLOCATOR_COMMAND_FREE = 3,
 
-  // TODO(benvanik): add optional IREE_ALLOCATOR_COMMAND_BIND like mbind:
+  // Binds the pages covering a range of memory to a NUMA node, like mbind:
   // https://man7.org/linux/man-pages/man2/mbind.2.html
-  // This would take a pointer/length and a NUMA node ID to bind the memory to.
-  // We may want flags for controlling whether this is a new allocation getting
-  // bound or an existing one that is migrating to use MPOL_MF_MOVE.
+  // Binding is a placement hint: pages not yet touched will prefer the node
+  // and pages already resident may be migrated if requested with
+  // IREE_ALLOCATOR_BIND_FLAG_MOVE. Allocators that do not support binding
+  // return IREE_STATUS_UNIMPLEMENTED and callers should treat that as benign.
+  //
+  // iree_allocator_ctl_fn_t:
+  //   params: iree_allocator_bind_params_t
+  //   inout_ptr: pointer to the base of the range to bind
+  IREE_ALLOCATOR_COMMAND_BIND = 4,
 } iree_allocator_command_t;
 
 // Parameters for various allocation commands.
@@ -174,6 +180,32 @@ typedef struct iree_allocator_alloc_params_t {
   iree_host_size_t byte_length;
 } iree_allocator_alloc_params_t;
 
+// A NUMA node ordinal used when binding memory.
+typedef uint32_t iree_allocator_node_id_t;
+
+// Indicates no specific NUMA node preference.
+#define IREE_ALLOCATOR_NODE_ID_ANY ((iree_allocator_node_id_t)-1)
+
+// Bits controlling IREE_ALLOCATOR_COMMAND_BIND behavior.
+enum iree_allocator_bind_flag_bits_t {
+  IREE_ALLOCATOR_BIND_FLAG_NONE = 0u,
+  // Migrates pages that are already resident on another node. Without this
+  // only pages faulted in after the bind are placed on the node.
+  IREE_ALLOCATOR_BIND_FLAG_MOVE = 1u << 0,
+};
+typedef uint32_t iree_allocator_bind_flags_t;
+
+// Parameters for IREE_ALLOCATOR_COMMAND_BIND.
+typedef struct iree_allocator_bind_params_t {
+  // Length, in bytes, of the range to bind. Only pages entirely contained
+  // within the range are bound.
+  iree_host_size_t byte_length;
+  // NUMA node the pages should be placed on.
+  iree_allocator_node_id_t node_id;
+  // Controls binding behavior.
+  iree_allocator_bind_flags_t flags;
+} iree_allocator_bind_params_t;
+
 // Function pointer for an iree_allocator_t control function.
 // |command| provides the operation to perform. Optionally some commands may use
 // |params| to pass additional operation-specific parameters. |inout_ptr| usage
@@ -222,6 +254,16 @@ iree_allocator_clone(iree_allocator_t allocator,
 // Frees a previously-allocated block of memory to the given allocator.
 IREE_API_EXPORT void iree_allocator_free(iree_allocator_t allocator, void* ptr);
 
+// Binds the pages fully contained in |byte_length| bytes starting at |ptr| to
+// the NUMA node |node_id|. |ptr| need not have been allocated from |allocator|
+// but the allocator must be one that is able to control its placement.
+// Returns IREE_STATUS_UNIMPLEMENTED if the allocator or platform does not
+// support binding; binding is a performance hint and callers should generally
+// ignore failures.
+IREE_API_EXPORT iree_status_t iree_allocator_bind(
+    iree_allocator_t allocator, void* ptr, iree_host_size_t byte_length,
+    iree_allocator_node_id_t node_id, iree_allocator_bind_flags_t flags);
+
 //===----------------------------------------------------------------------===//
 // Built-in iree_allocator_t implementations
 //===----------------------------------------------------------------------===//
@@ -315,6 +357,12 @@ IREE_API_EXPORT iree_status_t iree_allocator_malloc_aligned(
     iree_allocator_t allocator, iree_host_size_t byte_length,
     iree_host_size_t min_alignment, iree_host_size_t offset, void** out_ptr);
 
+// Allocates memory as with iree_allocator_malloc_aligned but leaves the
+// contents undefined. Only use this when immediately overwriting all memory.
+IREE_API_EXPORT iree_status_t iree_allocator_malloc_aligned_uninitialized(
+    iree_allocator_t allocator, iree_host_size_t byte_length,
+    iree_host_size_t min_alignment, iree_host_size_t offset, void** out_ptr);
+
 // Reallocates memory to |byte_length|, growing or shrinking as needed.
 // Only valid on memory allocated with iree_allocator_malloc_aligned.
 // The newly reallocated memory will have the byte at |offset| aligned to at
@@ -10,51 +10,319 @@
 #include <string.h>
 
 #include "iree/base/internal/debugging.h"
+#include "iree/base/metrics.h"
 
 //===----------------------------------------------------------------------===//
 // iree_arena_block_pool_t
 //===----------------------------------------------------------------------===//
 
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_arena_block_pool_hits, "iree_arena_block_pool_hits_total",
+    "Total number of arena blocks acquired from a pool without allocating.");
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_arena_block_pool_misses, "iree_arena_block_pool_misses_total",
+    "Total number of arena block acquisitions that allocated.");
+
+// NOTE: threading support is optional. Without thread-local storage all
+// threads use the first shard which still works but contends as the shared
+// list alone would.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+// Single-threaded; a single shard is all that's needed.
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define iree_arena_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define iree_arena_thread_local __declspec(thread)
+#endif  // __STDC_NO_THREADS__
+
+// Returns the shard in |block_pool| the calling thread should use.
+// Threads are assigned shards round-robin on first use and keep the same shard
+// index across all pools.
+static iree_arena_block_pool_shard_t* iree_arena_block_pool_thread_shard(
+    iree_arena_block_pool_t* block_pool) {
+#if defined(iree_arena_thread_local)
+  static iree_atomic_int32_t next_shard_index = IREE_ATOMIC_VAR_INIT(0);
+  static iree_arena_thread_local int32_t thread_shard_index = -1;
+  if (IREE_UNLIKELY(thread_shard_index < 0)) {
+    thread_shard_index = iree_atomic_fetch_add_int32(
+                             &next_shard_index, 1, iree_memory_order_relaxed) &
+                         INT32_MAX;
+  }
+  return &block_pool->shards[thread_shard_index %
+                             IREE_ARENA_BLOCK_POOL_SHARD_COUNT];
+#else
+  return &block_pool->shards[0];
+#endif  // iree_arena_thread_local
+}
+
+// Pops a block from |shard| if any are available.
+static iree_arena_block_t* iree_arena_block_pool_shard_pop(
+    iree_arena_block_pool_shard_t* shard) {
+  iree_arena_block_t* block = shard->cache.head;
+  if (block) {
+    shard->cache.head = block->next;
+    if (!shard->cache.head) shard->cache.tail = NULL;
+    --shard->cache.count;
+  }
+  return block;
+}
+
+// Pushes a chain of |count| blocks from |head| to |tail| to the front of
+// |shard|.
+static void iree_arena_block_pool_shard_push(
+    iree_arena_block_pool_shard_t* shard, iree_arena_block_t* head,
+    iree_arena_block_t* tail, iree_host_size_t count) {
+  tail->next = shard->cache.head;
+  if (!shard->cache.head) shard->cache.tail = tail;
+  shard->cache.head = head;
+  shard->cache.count += count;
+}
+
+// Removes all blocks from |shard| and returns them as a chain.
+// Returns false if the shard was empty.
+static bool iree_arena_block_pool_shard_flush(
+    iree_arena_block_pool_shard_t* shard, iree_arena_block_t** out_head,
+    iree_arena_block_t** out_tail) {
+  *out_head = shard->cache.head;
+  *out_tail = shard->cache.tail;
+  shard->cache.head = NULL;
+  shard->cache.tail = NULL;
+  shard->cache.count = 0;
+  return *out_head != NULL;
+}
+
+// Frees a chain of blocks starting at |head| back to the allocator.
+static void iree_arena_block_pool_free_blocks(
+    iree_arena_block_pool_t* block_pool, iree_arena_block_t* head) {
+  while (head) {
+    void* ptr = iree_arena_block_ptr(block_pool, head);
+    head = head->next;
+    iree_allocator_free(block_pool->block_allocator, ptr);
+  }
+}
+
 void iree_arena_block_pool_initialize(iree_host_size_t total_block_size,
                                       iree_allocator_t block_allocator,
                                       iree_arena_block_pool_t* out_block_pool) {
+  iree_arena_block_pool_initialize_on_node(total_block_size,
+                                           IREE_ALLOCATOR_NODE_ID_ANY,
+                                           block_allocator, out_block_pool);
+}
+
+void iree_arena_block_pool_initialize_on_node(
+    iree_host_size_t total_block_size, iree_allocator_node_id_t node_id,
+    iree_allocator_t block_allocator, iree_arena_block_pool_t* out_block_pool) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_metric_register(&iree_arena_block_pool_hits.base);
+  iree_metric_register(&iree_arena_block_pool_misses.base);
+
   memset(out_block_pool, 0, sizeof(*out_block_pool));
   out_block_pool->total_block_size = total_block_size;
   out_block_pool->usable_block_size =
       total_block_size - sizeof(iree_arena_block_t);
   out_block_pool->block_allocator = block_allocator;
+  out_block_pool->node_id = node_id;
   iree_atomic_arena_block_slist_initialize(&out_block_pool->available_slist);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(out_block_pool->shards);
+       ++i) {
+    iree_slim_mutex_initialize(&out_block_pool->shards[i].cache.mutex);
+  }
+  iree_slim_mutex_initialize(&out_block_pool->slab_mutex);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+void iree_arena_block_pool_initialize_slabbed(
+    iree_host_size_t total_block_size, iree_host_size_t slab_size,
+    iree_allocator_node_id_t node_id, iree_allocator_t block_allocator,
+    iree_arena_block_pool_t* out_block_pool) {
+  iree_arena_block_pool_initialize_on_node(total_block_size, node_id,
+                                           block_allocator, out_block_pool);
+  // Slabs always hold at least one block.
+  out_block_pool->slab_size = iree_max(slab_size, total_block_size);
+}
+
 void iree_arena_block_pool_deinitialize(iree_arena_block_pool_t* block_pool) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Since all blocks must have been released we can just reuse trim (today) as
-  // it doesn't retain any blocks.
-  iree_arena_block_pool_trim(block_pool);
+  if (block_pool->slab_size) {
+    // All blocks must have been released so the slabs can be freed without
+    // gathering their blocks from the caches and shared list.
+    iree_slim_mutex_lock(&block_pool->slab_mutex);
+    iree_arena_block_slab_t* slab = block_pool->slab_head;
+    block_pool->slab_head = NULL;
+    iree_slim_mutex_unlock(&block_pool->slab_mutex);
+    while (slab) {
+      iree_arena_block_slab_t* next_slab = slab->next;
+      iree_allocator_free(block_pool->block_allocator, slab->base_address);
+      iree_allocator_free(block_pool->block_allocator, slab);
+      slab = next_slab;
+    }
+  } else {
+    // Since all blocks must have been released we can just reuse trim (today)
+    // as it doesn't retain any blocks.
+    iree_arena_block_pool_trim(block_pool);
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(block_pool->shards); ++i) {
+    iree_slim_mutex_deinitialize(&block_pool->shards[i].cache.mutex);
+  }
+  iree_slim_mutex_deinitialize(&block_pool->slab_mutex);
   iree_atomic_arena_block_slist_deinitialize(&block_pool->available_slist);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
 void iree_arena_block_pool_trim(iree_arena_block_pool_t* block_pool) {
+  // Blocks in slabs can't be freed individually.
+  if (block_pool->slab_size) return;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(block_pool->shards); ++i) {
+    iree_arena_block_pool_shard_t* shard = &block_pool->shards[i];
+    iree_arena_block_t* head = NULL;
+    iree_arena_block_t* tail = NULL;
+    iree_slim_mutex_lock(&shard->cache.mutex);
+    iree_arena_block_pool_shard_flush(shard, &head, &tail);
+    iree_slim_mutex_unlock(&shard->cache.mutex);
+    iree_arena_block_pool_free_blocks(block_pool, head);
+  }
+
   iree_arena_block_t* head = NULL;
   iree_atomic_arena_block_slist_flush(
       &block_pool->available_slist,
       IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO, &head, NULL);
-  while (head) {
-    void* ptr = (uint8_t*)head - block_pool->usable_block_size;
-    head = head->next;
-    iree_allocator_free(block_pool->block_allocator, ptr);
+  iree_arena_block_pool_free_blocks(block_pool, head);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Refills |shard| from the shared list and returns one block for the caller.
+// Takes up to half of the shard capacity at once so that the next several
+// acquires on this thread don't need to touch the shared list.
+// Returns NULL if the shared list is empty.
+static iree_arena_block_t* iree_arena_block_pool_refill_shard(
+    iree_arena_block_pool_t* block_pool, iree_arena_block_pool_shard_t* shard) {
+  iree_arena_block_t* head = NULL;
+  iree_arena_block_t* tail = NULL;
+  iree_host_size_t count = iree_atomic_arena_block_slist_pop_span(
+      &block_pool->available_slist,
+      1 + IREE_ARENA_BLOCK_POOL_SHARD_CAPACITY / 2, &head, &tail);
+  if (!count) return NULL;
+
+  // Keep the first block for the caller and cache the rest.
+  iree_arena_block_t* block = head;
+  if (count > 1) {
+    iree_slim_mutex_lock(&shard->cache.mutex);
+    iree_arena_block_pool_shard_push(shard, block->next, tail, count - 1);
+    iree_slim_mutex_unlock(&shard->cache.mutex);
+  }
+  return block;
+}
+
+// Takes a single block from any shard other than |own_shard|.
+// This is only used before allocating a new block so that blocks cached by
+// threads that are releasing more than acquiring are not stranded. Other
+// shards are only locked briefly so the wait is short even when contended.
+static iree_arena_block_t* iree_arena_block_pool_steal(
+    iree_arena_block_pool_t* block_pool,
+    iree_arena_block_pool_shard_t* own_shard) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(block_pool->shards); ++i) {
+    iree_arena_block_pool_shard_t* shard = &block_pool->shards[i];
+    if (shard == own_shard) continue;
+    iree_slim_mutex_lock(&shard->cache.mutex);
+    iree_arena_block_t* block = iree_arena_block_pool_shard_pop(shard);
+    iree_slim_mutex_unlock(&shard->cache.mutex);
+    if (block) return block;
+  }
+  return NULL;
+}
+
+// Allocates a new block from the system, binding it to the pool node.
+static iree_status_t iree_arena_block_pool_allocate_block(
+    iree_arena_block_pool_t* block_pool, iree_arena_block_t** out_block) {
+  uint8_t* block_base = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc_uninitialized(
+      block_pool->block_allocator, block_pool->total_block_size,
+      (void**)&block_base));
+  if (block_pool->node_id != IREE_ALLOCATOR_NODE_ID_ANY) {
+    // Bind before first touch so that the pages fault in on the node. Only
+    // whole pages within the block are bound and failures are ignored as
+    // placement is just a performance hint.
+    iree_status_ignore(iree_allocator_bind(
+        block_pool->block_allocator, block_base, block_pool->total_block_size,
+        block_pool->node_id, IREE_ALLOCATOR_BIND_FLAG_NONE));
   }
+  *out_block = iree_arena_block_trailer(block_pool, block_base);
+  return iree_ok_status();
+}
+
+// Allocates a new slab and returns one of its blocks. The remaining blocks are
+// added to the shared list.
+static iree_status_t iree_arena_block_pool_allocate_slab(
+    iree_arena_block_pool_t* block_pool, iree_arena_block_t** out_block) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&block_pool->slab_mutex);
 
+  // Another thread may have allocated a slab while we were waiting.
+  iree_arena_block_t* block =
+      iree_atomic_arena_block_slist_pop(&block_pool->available_slist);
+  if (block) {
+    iree_slim_mutex_unlock(&block_pool->slab_mutex);
+    *out_block = block;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  iree_arena_block_slab_t* slab = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      block_pool->block_allocator, sizeof(*slab), (void**)&slab);
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc_uninitialized(block_pool->block_allocator,
+                                                 block_pool->slab_size,
+                                                 &slab->base_address);
+    if (!iree_status_is_ok(status)) {
+      iree_allocator_free(block_pool->block_allocator, slab);
+    }
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_slim_mutex_unlock(&block_pool->slab_mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  slab->next = block_pool->slab_head;
+  block_pool->slab_head = slab;
+  iree_slim_mutex_unlock(&block_pool->slab_mutex);
+
+  uint8_t* slab_base = (uint8_t*)slab->base_address;
+  if (block_pool->node_id != IREE_ALLOCATOR_NODE_ID_ANY) {
+    iree_status_ignore(iree_allocator_bind(
+        block_pool->block_allocator, slab_base, block_pool->slab_size,
+        block_pool->node_id, IREE_ALLOCATOR_BIND_FLAG_NONE));
+  }
+
+  // Keep the first block for the caller and chain the rest.
+  const iree_host_size_t block_count =
+      block_pool->slab_size / block_pool->total_block_size;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)block_count);
+  block = iree_arena_block_trailer(block_pool, slab_base);
+  iree_arena_block_t* head = NULL;
+  iree_arena_block_t* tail = NULL;
+  for (iree_host_size_t i = block_count - 1; i > 0; --i) {
+    iree_arena_block_t* next = iree_arena_block_trailer(
+        block_pool, slab_base + i * block_pool->total_block_size);
+    next->next = head;
+    head = next;
+    if (!tail) tail = next;
+  }
+  if (head) {
+    iree_atomic_arena_block_slist_concat(&block_pool->available_slist, head,
+                                         tail);
+  }
+
+  *out_block = block;
   IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 iree_status_t iree_arena_block_pool_acquire(iree_arena_block_pool_t* block_pool,
@@ -62,26 +330,34 @@ iree_status_t iree_arena_block_pool_acquire(iree_arena_block_pool_t* block_pool,
                                             void** out_ptr) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_arena_block_t* block =
-      iree_atomic_arena_block_slist_pop(&block_pool->available_slist);
-
+  iree_arena_block_pool_shard_t* shard =
+      iree_arena_block_pool_thread_shard(block_pool);
+  iree_slim_mutex_lock(&shard->cache.mutex);
+  iree_arena_block_t* block = iree_arena_block_pool_shard_pop(shard);
+  iree_slim_mutex_unlock(&shard->cache.mutex);
+  if (!block) {
+    block = iree_arena_block_pool_refill_shard(block_pool, shard);
+  }
   if (!block) {
-    // No blocks available; allocate one now.
+    block = iree_arena_block_pool_steal(block_pool, shard);
+  }
+
+  if (block) {
+    iree_metric_counter_increment(&iree_arena_block_pool_hits);
+  } else {
+    iree_metric_counter_increment(&iree_arena_block_pool_misses);
+    // No blocks available; allocate one (or a slab of them) now.
     // Note that it's possible for there to be a race here where one thread
     // releases a block to the pool while we are trying to acquire one - in that
     // case we may end up allocating a block when perhaps we didn't need to but
     // that's fine - it's just one block and the contention means there's likely
     // to be a need for more anyway.
-    uint8_t* block_base = NULL;
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_allocator_malloc_uninitialized(block_pool->block_allocator,
-                                                block_pool->total_block_size,
-                                                (void**)&block_base));
-    block = iree_arena_block_trailer(block_pool, block_base);
-    *out_ptr = block_base;
-  } else {
-    *out_ptr = iree_arena_block_ptr(block_pool, block);
+        z0, block_pool->slab_size
+                ? iree_arena_block_pool_allocate_slab(block_pool, &block)
+                : iree_arena_block_pool_allocate_block(block_pool, &block));
   }
+  *out_ptr = iree_arena_block_ptr(block_pool, block);
 
   block->next = NULL;
   *out_block = block;
@@ -93,9 +369,42 @@ iree_status_t iree_arena_block_pool_acquire(iree_arena_block_pool_t* block_pool,
 void iree_arena_block_pool_release(iree_arena_block_pool_t* block_pool,
                                    iree_arena_block_t* block_head,
                                    iree_arena_block_t* block_tail) {
+  if (IREE_UNLIKELY(!block_head)) return;
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_atomic_arena_block_slist_concat(&block_pool->available_slist, block_head,
-                                       block_tail);
+
+  // Count the chain without holding any locks as the caller still owns it.
+  // Chains too long for the cache (such as from large arena resets) go
+  // straight to the shared list in one operation.
+  iree_host_size_t count = 0;
+  for (iree_arena_block_t* it = block_head;
+       count <= IREE_ARENA_BLOCK_POOL_SHARD_CAPACITY; it = it->next) {
+    ++count;
+    if (it == block_tail) break;
+  }
+  if (count > IREE_ARENA_BLOCK_POOL_SHARD_CAPACITY) {
+    iree_atomic_arena_block_slist_concat(&block_pool->available_slist,
+                                         block_head, block_tail);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
+
+  // If the cache would overflow we spill its current contents to the shared
+  // list in bulk and keep the new blocks as they are the most recently used.
+  iree_arena_block_pool_shard_t* shard =
+      iree_arena_block_pool_thread_shard(block_pool);
+  iree_arena_block_t* spill_head = NULL;
+  iree_arena_block_t* spill_tail = NULL;
+  iree_slim_mutex_lock(&shard->cache.mutex);
+  if (shard->cache.count + count > IREE_ARENA_BLOCK_POOL_SHARD_CAPACITY) {
+    iree_arena_block_pool_shard_flush(shard, &spill_head, &spill_tail);
+  }
+  iree_arena_block_pool_shard_push(shard, block_head, block_tail, count);
+  iree_slim_mutex_unlock(&shard->cache.mutex);
+  if (spill_head) {
+    iree_atomic_arena_block_slist_concat(&block_pool->available_slist,
+                                         spill_head, spill_tail);
+  }
+
   IREE_TRACE_ZONE_END(z0);
 }
 
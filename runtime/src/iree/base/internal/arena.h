@@ -11,6 +11,8 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/atomic_slist.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,6 +45,46 @@ IREE_TYPED_ATOMIC_SLIST_WRAPPER(iree_atomic_arena_block, iree_arena_block_t,
 #define iree_arena_block_trailer(block_pool, ptr) \
   (iree_arena_block_t*)((const uint8_t*)(ptr) + (block_pool)->usable_block_size)
 
+// Number of per-thread block caches in each iree_arena_block_pool_t.
+// Threads are assigned a cache round-robin the first time they use any pool
+// and up to this many threads can acquire and release blocks without touching
+// the same cache lines. Threads beyond this count share caches.
+#if !defined(IREE_ARENA_BLOCK_POOL_SHARD_COUNT)
+#define IREE_ARENA_BLOCK_POOL_SHARD_COUNT 8
+#endif  // !IREE_ARENA_BLOCK_POOL_SHARD_COUNT
+
+// Maximum number of free blocks held in each per-thread block cache.
+// Caches are refilled from and spill to the shared pool list in bulk so only
+// about one in every IREE_ARENA_BLOCK_POOL_SHARD_CAPACITY/2 operations touches
+// the shared list. Release chains longer than this bypass the cache.
+#if !defined(IREE_ARENA_BLOCK_POOL_SHARD_CAPACITY)
+#define IREE_ARENA_BLOCK_POOL_SHARD_CAPACITY 16
+#endif  // !IREE_ARENA_BLOCK_POOL_SHARD_CAPACITY
+
+// A cache of free blocks used by a subset of the threads using a pool.
+// Padded so that each cache is on its own cache line and threads using
+// different caches don't contend.
+typedef union iree_arena_block_pool_shard_t {
+  struct {
+    // Held only while manipulating the list; uncontended unless more threads
+    // than IREE_ARENA_BLOCK_POOL_SHARD_COUNT are using the pool.
+    iree_slim_mutex_t mutex;
+    // LIFO list of free blocks.
+    iree_arena_block_t* head IREE_GUARDED_BY(mutex);
+    iree_arena_block_t* tail IREE_GUARDED_BY(mutex);
+    // Total number of blocks in the list.
+    iree_host_size_t count IREE_GUARDED_BY(mutex);
+  } cache;
+  uint8_t padding[iree_hardware_destructive_interference_size];
+} iree_arena_block_pool_shard_t;
+
+// A slab of contiguous blocks allocated by a slabbed iree_arena_block_pool_t.
+typedef struct iree_arena_block_slab_t {
+  struct iree_arena_block_slab_t* next;
+  // Base address of the slab allocation.
+  void* base_address;
+} iree_arena_block_slab_t;
+
 // A simple atomic fixed-size block pool.
 // Blocks are allocated from the system as required and kept in the pool to
 // satisfy future requests. Blocks are all of a uniform size specified when the
@@ -50,6 +92,16 @@ IREE_TYPED_ATOMIC_SLIST_WRAPPER(iree_atomic_arena_block, iree_arena_block_t,
 // blocks so that the underlying allocator is more likely to bucket them
 // appropriately.
 //
+// Free blocks are cached per-thread in front of the shared available_slist so
+// that threads acquiring and releasing blocks concurrently (command buffer
+// recording, task submission, invocations, etc) don't all serialize on the
+// shared list. A thread that finds nothing in its own cache or the shared list
+// will take blocks from other caches before allocating new ones.
+//
+// Slabbed pools allocate many blocks at a time as a single slab that is only
+// freed when the pool is deinitialized. Paired with a huge page allocator and
+// a slab size of the huge page size this places all blocks in huge pages.
+//
 // Thread-safe; multiple threads may acquire and release blocks from the pool.
 // The underlying allocator must also be thread-safe.
 typedef struct iree_arena_block_pool_t {
@@ -60,8 +112,20 @@ typedef struct iree_arena_block_pool_t {
   iree_host_size_t usable_block_size;
   // Allocator used for allocating/freeing each allocation block.
   iree_allocator_t block_allocator;
-  // Linked list of free blocks (LIFO).
+  // NUMA node new blocks are bound to or IREE_ALLOCATOR_NODE_ID_ANY.
+  iree_allocator_node_id_t node_id;
+  // Linked list of free blocks (LIFO) shared by all threads.
   iree_atomic_arena_block_slist_t available_slist;
+  // Per-thread caches of free blocks.
+  iree_arena_block_pool_shard_t shards[IREE_ARENA_BLOCK_POOL_SHARD_COUNT];
+  // Size, in bytes, of each slab blocks are carved from or 0 if blocks are
+  // allocated individually.
+  iree_host_size_t slab_size;
+  // Held while allocating slabs so that concurrent acquires that find the pool
+  // empty only allocate one slab.
+  iree_slim_mutex_t slab_mutex;
+  // All slabs allocated by the pool.
+  iree_arena_block_slab_t* slab_head IREE_GUARDED_BY(slab_mutex);
 } iree_arena_block_pool_t;
 
 // Initializes a new block pool in |out_block_pool|.
@@ -72,13 +136,35 @@ void iree_arena_block_pool_initialize(iree_host_size_t total_block_size,
                                       iree_allocator_t block_allocator,
                                       iree_arena_block_pool_t* out_block_pool);
 
+// Initializes a new block pool in |out_block_pool| whose blocks are bound to
+// the NUMA node |node_id| as they are allocated. Binding is best-effort and
+// only applies if |block_allocator| supports IREE_ALLOCATOR_COMMAND_BIND.
+// Blocks are reused without rebinding and pools used from threads on multiple
+// nodes should use IREE_ALLOCATOR_NODE_ID_ANY.
+void iree_arena_block_pool_initialize_on_node(
+    iree_host_size_t total_block_size, iree_allocator_node_id_t node_id,
+    iree_allocator_t block_allocator, iree_arena_block_pool_t* out_block_pool);
+
+// Initializes a new block pool in |out_block_pool| that allocates its blocks
+// in slabs of |slab_size| bytes from |block_allocator|. Each slab holds as many
+// |total_block_size| blocks as fit and is bound to |node_id| as with
+// iree_arena_block_pool_initialize_on_node. Slabs are retained until the pool
+// is deinitialized and trimming has no effect. Intended for use with a huge
+// page allocator (see iree_memory_huge_page_allocator_t) with a slab size that
+// is a multiple of the huge page size.
+void iree_arena_block_pool_initialize_slabbed(
+    iree_host_size_t total_block_size, iree_host_size_t slab_size,
+    iree_allocator_node_id_t node_id, iree_allocator_t block_allocator,
+    iree_arena_block_pool_t* out_block_pool);
+
 // Deinitializes a block pool and frees all allocations.
 // All blocks that were acquired from the pool must have already been released
 // back to it.
 void iree_arena_block_pool_deinitialize(iree_arena_block_pool_t* block_pool);
 
 // Trims the pool by freeing unused blocks back to the allocator.
-// Acquired blocks are not freed and remain valid.
+// Acquired blocks are not freed and remain valid. Slabbed pools retain their
+// slabs and are not trimmed.
 void iree_arena_block_pool_trim(iree_arena_block_pool_t* block_pool);
 
 // Acquires a single block from the pool and returns it in |out_block|.
@@ -0,0 +1,97 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstddef>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
+
+namespace {
+
+// Block size used by all pools; matches the default HAL arena block size.
+constexpr iree_host_size_t kBlockSize = 32 * 1024;
+
+// Number of blocks used per iteration in the arena benchmarks, approximating
+// a small command buffer recording or submission.
+constexpr int kBlocksPerArena = 4;
+
+// Returns a block pool shared by all benchmark threads. It is never
+// deinitialized so that blocks stay cached across benchmark runs.
+iree_arena_block_pool_t* SharedBlockPool() {
+  static iree_arena_block_pool_t* block_pool =
+      ([]() -> iree_arena_block_pool_t* {
+        auto pool = new iree_arena_block_pool_t();
+        iree_arena_block_pool_initialize(kBlockSize, iree_allocator_system(),
+                                         pool);
+        return pool;
+      })();
+  return block_pool;
+}
+
+//==============================================================================
+// Baseline: a single shared slist
+//==============================================================================
+
+// Acquires and releases one block at a time on a single shared list as all
+// threads did prior to the per-thread block caches.
+void BM_SharedSlist(benchmark::State& state) {
+  static iree_atomic_arena_block_slist_t* slist =
+      ([]() -> iree_atomic_arena_block_slist_t* {
+        auto list = new iree_atomic_arena_block_slist_t();
+        iree_atomic_arena_block_slist_initialize(list);
+        // Enough entries that no thread ever finds the list empty.
+        for (int i = 0; i < 256; ++i) {
+          iree_atomic_arena_block_slist_push(list, new iree_arena_block_t());
+        }
+        return list;
+      })();
+  for (auto _ : state) {
+    iree_arena_block_t* block = iree_atomic_arena_block_slist_pop(slist);
+    benchmark::DoNotOptimize(block);
+    iree_atomic_arena_block_slist_push(slist, block);
+  }
+}
+BENCHMARK(BM_SharedSlist)->UseRealTime()->ThreadRange(1, 16);
+
+//==============================================================================
+// iree_arena_block_pool_t
+//==============================================================================
+
+// Acquires and releases one block at a time.
+void BM_BlockPoolAcquireRelease(benchmark::State& state) {
+  iree_arena_block_pool_t* block_pool = SharedBlockPool();
+  for (auto _ : state) {
+    iree_arena_block_t* block = NULL;
+    void* ptr = NULL;
+    IREE_CHECK_OK(iree_arena_block_pool_acquire(block_pool, &block, &ptr));
+    benchmark::DoNotOptimize(ptr);
+    iree_arena_block_pool_release(block_pool, block, block);
+  }
+}
+BENCHMARK(BM_BlockPoolAcquireRelease)->UseRealTime()->ThreadRange(1, 16);
+
+// Fills an arena with several blocks and resets it, returning all blocks to
+// the pool as a single chain.
+void BM_BlockPoolArena(benchmark::State& state) {
+  iree_arena_block_pool_t* block_pool = SharedBlockPool();
+  iree_arena_allocator_t arena;
+  iree_arena_initialize(block_pool, &arena);
+  for (auto _ : state) {
+    for (int i = 0; i < kBlocksPerArena; ++i) {
+      void* ptr = NULL;
+      IREE_CHECK_OK(
+          iree_arena_allocate(&arena, block_pool->usable_block_size, &ptr));
+      benchmark::DoNotOptimize(ptr);
+    }
+    iree_arena_reset(&arena);
+  }
+  iree_arena_deinitialize(&arena);
+  state.SetItemsProcessed(state.iterations() * kBlocksPerArena);
+}
+BENCHMARK(BM_BlockPoolArena)->UseRealTime()->ThreadRange(1, 16);
+
+}  // namespace
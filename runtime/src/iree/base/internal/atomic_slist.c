@@ -61,6 +61,34 @@ iree_atomic_slist_entry_t* iree_atomic_slist_pop(iree_atomic_slist_t* list) {
   return entry;
 }
 
+iree_host_size_t iree_atomic_slist_pop_span(
+    iree_atomic_slist_t* list, iree_host_size_t max_count,
+    iree_atomic_slist_entry_t** out_head,
+    iree_atomic_slist_entry_t** out_tail) {
+  *out_head = NULL;
+  *out_tail = NULL;
+  if (IREE_UNLIKELY(max_count == 0)) return 0;
+  iree_slim_mutex_lock(&list->mutex);
+  iree_atomic_slist_entry_t* head = list->head;
+  iree_atomic_slist_entry_t* tail = head;
+  iree_host_size_t count = 0;
+  if (head) {
+    count = 1;
+    while (count < max_count && tail->next) {
+      tail = tail->next;
+      ++count;
+    }
+    list->head = tail->next;
+    tail->next = NULL;
+  }
+  iree_slim_mutex_unlock(&list->mutex);
+  if (count) {
+    *out_head = head;
+    *out_tail = tail;
+  }
+  return count;
+}
+
 bool iree_atomic_slist_flush(iree_atomic_slist_t* list,
                              iree_atomic_slist_flush_order_t flush_order,
                              iree_atomic_slist_entry_t** out_head,
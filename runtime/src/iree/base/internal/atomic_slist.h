@@ -130,6 +130,19 @@ void iree_atomic_slist_push_unsafe(iree_atomic_slist_t* list,
 //   returned entry: C
 iree_atomic_slist_entry_t* iree_atomic_slist_pop(iree_atomic_slist_t* list);
 
+// Pops up to |max_count| of the most recently pushed entries from the list and
+// returns them as a span from |out_head| to |out_tail| in LIFO order.
+// Returns the number of entries popped which is 0 if the list was empty. Unlike
+// a flush the remaining entries stay available to other threads.
+//
+//   existing slist: D C B A
+//        max_count: 2
+//  resulting slist: B A
+//    returned span: D C
+iree_host_size_t iree_atomic_slist_pop_span(
+    iree_atomic_slist_t* list, iree_host_size_t max_count,
+    iree_atomic_slist_entry_t** out_head, iree_atomic_slist_entry_t** out_tail);
+
 // Defines the approximate order in which a span of flushed entries is returned.
 typedef enum iree_atomic_slist_flush_order_e {
   // |out_head| and |out_tail| will be set to a span of the entries roughly in
@@ -234,6 +247,17 @@ bool iree_atomic_slist_flush(iree_atomic_slist_t* list,
   }                                                                            \
   static inline type* name##_slist_pop(name##_slist_t* list) {                 \
     return name##_slist_entry_to_ptr(iree_atomic_slist_pop(&list->impl));      \
+  }                                                                            \
+  static inline iree_host_size_t name##_slist_pop_span(                        \
+      name##_slist_t* list, iree_host_size_t max_count, type** out_head,       \
+      type** out_tail) {                                                       \
+    iree_atomic_slist_entry_t* head = NULL;                                    \
+    iree_atomic_slist_entry_t* tail = NULL;                                    \
+    iree_host_size_t count =                                                   \
+        iree_atomic_slist_pop_span(&list->impl, max_count, &head, &tail);      \
+    *out_head = name##_slist_entry_to_ptr(head);                               \
+    *out_tail = name##_slist_entry_to_ptr(tail);                               \
+    return count;                                                              \
   }                                                                            \
                                                                                \
   static inline bool name##_slist_flush(                                       \
@@ -107,6 +107,42 @@ TEST(AtomicSList, Concat) {
   dummy_slist_deinitialize(&list);
 }
 
+TEST(AtomicSList, PopSpan) {
+  dummy_slist_t list;
+  dummy_slist_initialize(&list);
+
+  // Popping when empty is ok.
+  dummy_entry_t* head = NULL;
+  dummy_entry_t* tail = NULL;
+  EXPECT_EQ(0u, dummy_slist_pop_span(&list, 2, &head, &tail));
+  EXPECT_EQ(NULL, head);
+  EXPECT_EQ(NULL, tail);
+
+  // Push items into the list (LIFO order).
+  // New contents: 3 2 1 0
+  auto item_storage = MakeDummySListItems(0, 4);
+  for (size_t i = 0; i < item_storage.size(); ++i) {
+    dummy_slist_push(&list, &item_storage[i]);
+  }
+
+  // Pop the two most recent items.
+  // New contents: 1 0
+  EXPECT_EQ(2u, dummy_slist_pop_span(&list, 2, &head, &tail));
+  EXPECT_EQ(&item_storage[3], head);
+  EXPECT_EQ(&item_storage[2], tail);
+  EXPECT_EQ(tail, dummy_slist_get_next(head));
+  EXPECT_EQ(NULL, dummy_slist_get_next(tail));
+
+  // Asking for more than are present returns what remains.
+  // New contents: e
+  EXPECT_EQ(2u, dummy_slist_pop_span(&list, 8, &head, &tail));
+  EXPECT_EQ(&item_storage[1], head);
+  EXPECT_EQ(&item_storage[0], tail);
+  EXPECT_EQ(NULL, dummy_slist_pop(&list));
+
+  dummy_slist_deinitialize(&list);
+}
+
 TEST(AtomicSList, FlushLIFO) {
   dummy_slist_t list;
   dummy_slist_initialize(&list);
@@ -177,6 +177,25 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
 #include <intrin.h>
 #endif
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Linux keeps AMX tile data disabled for each process until it requests
+// permission for it, even when XCR0 reports the state as enabled. Executing an
+// AMX instruction before that raises SIGILL. See
+// https://docs.kernel.org/arch/x86/xstate.html
+#define IREE_ARCH_REQ_XCOMP_PERM 0x1023
+#define IREE_XFEATURE_XTILEDATA 18
+
+static bool iree_cpu_request_amx_permission(void) {
+  return syscall(SYS_arch_prctl, IREE_ARCH_REQ_XCOMP_PERM,
+                 IREE_XFEATURE_XTILEDATA) == 0;
+}
+#else
+static bool iree_cpu_request_amx_permission(void) { return true; }
+#endif  // IREE_PLATFORM_*
+
 typedef struct iree_cpuid_regs_t {
   uint32_t eax;
   uint32_t ebx;
@@ -305,6 +324,12 @@ static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXTILE, leaf7_0.edx, 1 << 24);
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXINT8, leaf7_0.edx, 1 << 25);
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXBF16, leaf7_0.edx, 1 << 22);
+    // Only report AMX as available if the OS lets this process use it.
+    if ((out0 & IREE_CPU_DATA0_X86_64_AMXTILE) &&
+        !iree_cpu_request_amx_permission()) {
+      out0 &= ~(IREE_CPU_DATA0_X86_64_AMXTILE | IREE_CPU_DATA0_X86_64_AMXINT8 |
+                IREE_CPU_DATA0_X86_64_AMXBF16);
+    }
   }
 
   out_fields[0] = out0;
@@ -313,20 +338,65 @@ static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
 #elif defined(IREE_ARCH_RISCV_64)
 #if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
 
-// For now as we only need ISA feature bits and no CPU identification beyond
-// that, and as we are OK with requiring a sufficiently recent linux kernel to
-// expose the features that we need, we can just rely on the basic HWCAP way.
+// The single-letter HWCAP bits are the baseline, available on all kernels
+// with RISC-V support. Kernels since 6.4 also provide the riscv_hwprobe
+// syscall, which is the only way to query multi-letter extensions and which
+// reports V only when the kernel has enabled vector state for userspace, so we
+// prefer it when present and fall back to HWCAP otherwise.
 #include <sys/auxv.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #define IREE_HWCAP_ISA_V (1 << ('V' - 'A'))
 
+// NOTE: not all libc versions have <asm/hwprobe.h> so we define what we need
+// locally. https://docs.kernel.org/arch/riscv/hwprobe.html
+#define IREE_RISCV_HWPROBE_SYSCALL_NR 258
+#define IREE_RISCV_HWPROBE_KEY_IMA_EXT_0 4
+#define IREE_RISCV_HWPROBE_IMA_V (1ull << 2)
+
+typedef struct iree_riscv_hwprobe_pair_t {
+  int64_t key;
+  uint64_t value;
+} iree_riscv_hwprobe_pair_t;
+
+// Returns true if the kernel answered the query, in which case the result
+// supersedes what HWCAP says.
+static bool iree_cpu_query_riscv_hwprobe(iree_riscv_hwprobe_pair_t* pair) {
+  long ret = syscall(IREE_RISCV_HWPROBE_SYSCALL_NR, pair, /*pair_count=*/1,
+                     /*cpu_count=*/0, /*cpus=*/NULL, /*flags=*/0);
+  // Unknown keys are reported back with key set to -1.
+  return ret == 0 && pair->key != -1;
+}
+
 static void iree_cpu_initialize_from_platform_riscv_64(uint64_t* out_fields) {
+  iree_riscv_hwprobe_pair_t ima_ext_0 = {
+      .key = IREE_RISCV_HWPROBE_KEY_IMA_EXT_0,
+      .value = 0,
+  };
+  if (iree_cpu_query_riscv_hwprobe(&ima_ext_0)) {
+    IREE_COPY_BITS(out_fields[0], IREE_CPU_DATA0_RISCV_64_RVV, ima_ext_0.value,
+                   IREE_RISCV_HWPROBE_IMA_V);
+    return;
+  }
   unsigned long hwcap = getauxval(AT_HWCAP);
   IREE_COPY_BITS(out_fields[0], IREE_CPU_DATA0_RISCV_64_RVV, hwcap,
                  IREE_HWCAP_ISA_V);
 }
 
 #endif  // IREE_PLATFORM_*
+
+#elif defined(IREE_ARCH_WASM_32)
+
+// WebAssembly has no feature detection from within a module: a module using
+// SIMD128 instructions fails validation on engines without it. So if this code
+// is running and was built with SIMD128 then the engine supports it.
+static void iree_cpu_initialize_from_platform_wasm_32(uint64_t* out_fields) {
+#if defined(__wasm_simd128__)
+  out_fields[0] |= IREE_CPU_DATA0_WASM_32_SIMD128;
+#endif  // defined(__wasm_simd128__)
+}
+
 #endif  // defined(IREE_ARCH_ARM_64)
 
 static void iree_cpu_initialize_from_platform(iree_allocator_t temp_allocator,
@@ -337,6 +407,8 @@ static void iree_cpu_initialize_from_platform(iree_allocator_t temp_allocator,
   iree_cpu_initialize_from_platform_x86_64(out_fields);
 #elif defined(IREE_ARCH_RISCV_64)
   iree_cpu_initialize_from_platform_riscv_64(out_fields);
+#elif defined(IREE_ARCH_WASM_32)
+  iree_cpu_initialize_from_platform_wasm_32(out_fields);
 #else
   // No implementation available. CPU data will be all zeros.
 #endif  // defined(IREE_ARCH_ARM_64)
@@ -10,26 +10,97 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/synchronization.h"
 
+// A cache of available events used by a subset of the threads using a pool.
+typedef struct iree_event_pool_shard_cache_t {
+  // Held only while manipulating the cache; uncontended unless more threads
+  // than IREE_EVENT_POOL_SHARD_COUNT are using the pool or another thread is
+  // stealing events from the cache.
+  iree_slim_mutex_t mutex;
+  // Total number of available events in the cache.
+  iree_host_size_t count IREE_GUARDED_BY(mutex);
+  // Dense left-aligned LIFO list of count events.
+  iree_event_t events[IREE_EVENT_POOL_SHARD_CAPACITY] IREE_GUARDED_BY(mutex);
+} iree_event_pool_shard_cache_t;
+
+// Padded so that each cache is on its own cache lines and threads using
+// different caches don't contend.
+typedef union iree_event_pool_shard_t {
+  iree_event_pool_shard_cache_t cache;
+  uint8_t padding[((sizeof(iree_event_pool_shard_cache_t) +
+                    iree_hardware_destructive_interference_size - 1) /
+                   iree_hardware_destructive_interference_size) *
+                  iree_hardware_destructive_interference_size];
+} iree_event_pool_shard_t;
+
 struct iree_event_pool_t {
+  // Per-thread caches of available events. Threads only touch the shared pool
+  // below when their cache runs dry or overflows.
+  iree_event_pool_shard_t shards[IREE_EVENT_POOL_SHARD_COUNT];
   // Allocator used to create the event pool.
   iree_allocator_t host_allocator;
-  // Guards the pool. Since this pool is used to get operating system-level
-  // event objects that will be signaled and waited on using syscalls it's got
-  // relatively low contention: callers are rate limited by how fast they can
-  // signal and wait on the events they get.
+  // Guards the shared pool. May be acquired while holding a shard mutex but
+  // never the other way around.
   iree_slim_mutex_t mutex;
   // Maximum number of events that will be maintained in the pool. More events
   // may be allocated at any time but when they are no longer needed they will
   // be disposed directly.
   iree_host_size_t available_capacity;
-  // Total number of available
-  iree_host_size_t available_count;
+  // Total number of available events in the shared pool.
+  iree_host_size_t available_count IREE_GUARDED_BY(mutex);
   // Dense left-aligned list of available_count events.
-  iree_event_t available_list[];
+  iree_event_t available_list[] IREE_GUARDED_BY(mutex);
 };
 
+// NOTE: threading support is optional. Without thread-local storage all
+// threads use the first shard which still works but contends as the shared
+// pool alone would.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+// Single-threaded; a single shard is all that's needed.
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define iree_event_pool_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define iree_event_pool_thread_local __declspec(thread)
+#endif  // __STDC_NO_THREADS__
+
+// Returns the index of the shard the calling thread should use.
+// Threads are assigned shards round-robin on first use and keep the same shard
+// index across all pools.
+static iree_host_size_t iree_event_pool_thread_shard_index(void) {
+#if defined(iree_event_pool_thread_local)
+  static iree_atomic_int32_t next_shard_index = IREE_ATOMIC_VAR_INIT(0);
+  static iree_event_pool_thread_local int32_t thread_shard_index = -1;
+  if (IREE_UNLIKELY(thread_shard_index < 0)) {
+    thread_shard_index = iree_atomic_fetch_add_int32(
+                             &next_shard_index, 1, iree_memory_order_relaxed) &
+                         INT32_MAX;
+  }
+  return (iree_host_size_t)thread_shard_index % IREE_EVENT_POOL_SHARD_COUNT;
+#else
+  return 0;
+#endif  // iree_event_pool_thread_local
+}
+
+// Moves up to |max_count| events from the end of |source_list| to the end of
+// |target_list| and returns the number of events moved.
+static iree_host_size_t iree_event_pool_move(iree_event_t* source_list,
+                                             iree_host_size_t* source_count,
+                                             iree_event_t* target_list,
+                                             iree_host_size_t* target_count,
+                                             iree_host_size_t max_count) {
+  iree_host_size_t count = iree_min(*source_count, max_count);
+  if (count > 0) {
+    memcpy(&target_list[*target_count], &source_list[*source_count - count],
+           count * sizeof(iree_event_t));
+    *source_count -= count;
+    *target_count += count;
+  }
+  return count;
+}
+
 iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
                                        iree_allocator_t host_allocator,
                                        iree_event_pool_t** out_event_pool) {
@@ -44,7 +115,13 @@ iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0,
       iree_allocator_malloc(host_allocator, total_size, (void**)&event_pool));
+  for (iree_host_size_t i = 0; i < IREE_EVENT_POOL_SHARD_COUNT; ++i) {
+    iree_event_pool_shard_cache_t* cache = &event_pool->shards[i].cache;
+    iree_slim_mutex_initialize(&cache->mutex);
+    cache->count = 0;
+  }
   event_pool->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&event_pool->mutex);
   event_pool->available_capacity = available_capacity;
   event_pool->available_count = 0;
 
@@ -53,7 +130,10 @@ iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
     status = iree_event_initialize(
         /*initial_state=*/false,
         &event_pool->available_list[event_pool->available_count++]);
-    if (!iree_status_is_ok(status)) break;
+    if (!iree_status_is_ok(status)) {
+      --event_pool->available_count;
+      break;
+    }
   }
 
   if (iree_status_is_ok(status)) {
@@ -69,6 +149,13 @@ void iree_event_pool_free(iree_event_pool_t* event_pool) {
   iree_allocator_t host_allocator = event_pool->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  for (iree_host_size_t i = 0; i < IREE_EVENT_POOL_SHARD_COUNT; ++i) {
+    iree_event_pool_shard_cache_t* cache = &event_pool->shards[i].cache;
+    for (iree_host_size_t j = 0; j < cache->count; ++j) {
+      iree_event_deinitialize(&cache->events[j]);
+    }
+    iree_slim_mutex_deinitialize(&cache->mutex);
+  }
   for (iree_host_size_t i = 0; i < event_pool->available_count; ++i) {
     iree_event_deinitialize(&event_pool->available_list[i]);
   }
@@ -87,32 +174,50 @@ iree_status_t iree_event_pool_acquire(iree_event_pool_t* event_pool,
 
   // We'll try to get what we can from the pool and fall back to initializing
   // new events.
-  iree_host_size_t remaining_count = event_count;
+  iree_host_size_t acquired_count = 0;
 
-  // Try first to grab from the pool.
-  iree_slim_mutex_lock(&event_pool->mutex);
-  iree_host_size_t from_pool_count =
-      iree_min(event_pool->available_count, event_count);
-  if (from_pool_count > 0) {
-    iree_host_size_t pool_base_index =
-        event_pool->available_count - from_pool_count;
-    memcpy(out_events, &event_pool->available_list[pool_base_index],
-           from_pool_count * sizeof(iree_event_t));
-    event_pool->available_count -= from_pool_count;
-    remaining_count -= from_pool_count;
+  // Try first to grab from the thread cache. If it runs dry we take what we
+  // need from the shared pool and refill the cache with a batch so the next
+  // several acquires on this thread can avoid the shared pool.
+  const iree_host_size_t shard_index = iree_event_pool_thread_shard_index();
+  iree_event_pool_shard_cache_t* cache = &event_pool->shards[shard_index].cache;
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_event_pool_move(cache->events, &cache->count, out_events,
+                       &acquired_count, event_count);
+  if (acquired_count < event_count) {
+    iree_slim_mutex_lock(&event_pool->mutex);
+    iree_event_pool_move(event_pool->available_list,
+                         &event_pool->available_count, out_events,
+                         &acquired_count, event_count - acquired_count);
+    iree_event_pool_move(event_pool->available_list,
+                         &event_pool->available_count, cache->events,
+                         &cache->count, IREE_EVENT_POOL_SHARD_CAPACITY / 2);
+    iree_slim_mutex_unlock(&event_pool->mutex);
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  // Take from other thread caches before paying for new events. This happens
+  // when events are acquired and released on different threads.
+  for (iree_host_size_t i = 1;
+       i < IREE_EVENT_POOL_SHARD_COUNT && acquired_count < event_count; ++i) {
+    iree_event_pool_shard_cache_t* other_cache =
+        &event_pool->shards[(shard_index + i) % IREE_EVENT_POOL_SHARD_COUNT]
+             .cache;
+    iree_slim_mutex_lock(&other_cache->mutex);
+    iree_event_pool_move(other_cache->events, &other_cache->count, out_events,
+                         &acquired_count, event_count - acquired_count);
+    iree_slim_mutex_unlock(&other_cache->mutex);
   }
-  iree_slim_mutex_unlock(&event_pool->mutex);
 
   // Allocate the rest of the events.
-  if (remaining_count > 0) {
+  if (acquired_count < event_count) {
     IREE_TRACE_ZONE_BEGIN(z0);
-    iree_status_t status = iree_ok_status();
-    for (iree_host_size_t i = 0; i < remaining_count; ++i) {
-      status = iree_event_initialize(/*initial_state=*/false,
-                                     &out_events[from_pool_count + i]);
+    for (iree_host_size_t i = acquired_count; i < event_count; ++i) {
+      iree_status_t status =
+          iree_event_initialize(/*initial_state=*/false, &out_events[i]);
       if (!iree_status_is_ok(status)) {
         // Must release all events we've acquired so far.
-        iree_event_pool_release(event_pool, from_pool_count + i, out_events);
+        iree_event_pool_release(event_pool, i, out_events);
         IREE_TRACE_ZONE_END(z0);
         return status;
       }
@@ -130,35 +235,52 @@ void iree_event_pool_release(iree_event_pool_t* event_pool,
   if (!event_count) return;
   IREE_ASSERT_ARGUMENT(events);
 
-  // We'll try to release all we can back to the pool and then deinitialize
-  // the ones that won't fit.
-  iree_host_size_t remaining_count = event_count;
+  // Reset the events we may add back to the pool so that they are ready to be
+  // acquired again. This is done outside of the locks as it may be a syscall.
+  // Events that don't fit are deinitialized below and would not need a reset
+  // but that's rare enough that it's not worth the bookkeeping.
+  for (iree_host_size_t i = 0; i < event_count; ++i) {
+    iree_event_reset(&events[i]);
+  }
 
-  // Try first to release to the pool.
-  // Note that we reset the events we add back to the pool so that they are
-  // ready to be acquired again.
-  iree_slim_mutex_lock(&event_pool->mutex);
-  iree_host_size_t to_pool_count =
-      iree_min(event_pool->available_capacity - event_pool->available_count,
-               event_count);
-  if (to_pool_count > 0) {
-    iree_host_size_t pool_base_index = event_pool->available_count;
-    for (iree_host_size_t i = 0; i < to_pool_count; ++i) {
-      iree_event_reset(&events[i]);
+  // Release into the thread cache. If the cache is full we spill half of it to
+  // the shared pool in a batch and put the new events in its place so that the
+  // next several releases on this thread can avoid the shared pool. Any events
+  // that fit in neither are deinitialized.
+  iree_host_size_t remaining_count = event_count;
+  iree_event_pool_shard_cache_t* cache =
+      &event_pool->shards[iree_event_pool_thread_shard_index()].cache;
+  iree_slim_mutex_lock(&cache->mutex);
+  if (cache->count + remaining_count > IREE_EVENT_POOL_SHARD_CAPACITY) {
+    iree_slim_mutex_lock(&event_pool->mutex);
+    iree_host_size_t shared_free_count =
+        event_pool->available_capacity - event_pool->available_count;
+    if (cache->count > IREE_EVENT_POOL_SHARD_CAPACITY / 2) {
+      shared_free_count -= iree_event_pool_move(
+          cache->events, &cache->count, event_pool->available_list,
+          &event_pool->available_count,
+          iree_min(shared_free_count,
+                   cache->count - IREE_EVENT_POOL_SHARD_CAPACITY / 2));
+    }
+    iree_host_size_t cache_free_count =
+        IREE_EVENT_POOL_SHARD_CAPACITY - cache->count;
+    if (remaining_count > cache_free_count) {
+      iree_event_pool_move(
+          events, &remaining_count, event_pool->available_list,
+          &event_pool->available_count,
+          iree_min(shared_free_count, remaining_count - cache_free_count));
     }
-    memcpy(&event_pool->available_list[pool_base_index], events,
-           to_pool_count * sizeof(iree_event_t));
-    event_pool->available_count += to_pool_count;
-    remaining_count -= to_pool_count;
+    iree_slim_mutex_unlock(&event_pool->mutex);
   }
-  iree_slim_mutex_unlock(&event_pool->mutex);
+  iree_event_pool_move(events, &remaining_count, cache->events, &cache->count,
+                       IREE_EVENT_POOL_SHARD_CAPACITY - cache->count);
+  iree_slim_mutex_unlock(&cache->mutex);
 
-  // Deallocate the rest of the events. We don't bother resetting them as we are
-  // getting rid of them.
+  // Deallocate the rest of the events.
   if (remaining_count > 0) {
     IREE_TRACE_ZONE_BEGIN(z0);
     for (iree_host_size_t i = 0; i < remaining_count; ++i) {
-      iree_event_deinitialize(&events[to_pool_count + i]);
+      iree_event_deinitialize(&events[i]);
     }
     IREE_TRACE_ZONE_END(z0);
   }
@@ -14,12 +14,34 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Number of per-thread event caches maintained by each pool.
+// Threads are assigned caches round-robin on first use and up to this many
+// threads can acquire and release events without contending with each other.
+#if !defined(IREE_EVENT_POOL_SHARD_COUNT)
+#define IREE_EVENT_POOL_SHARD_COUNT 8
+#endif  // !IREE_EVENT_POOL_SHARD_COUNT
+
+// Maximum number of events held in each per-thread event cache.
+// Caches are refilled from and spill to the shared pool in batches of half
+// this size so that most acquires and releases never touch the shared pool.
+#if !defined(IREE_EVENT_POOL_SHARD_CAPACITY)
+#define IREE_EVENT_POOL_SHARD_CAPACITY 8
+#endif  // !IREE_EVENT_POOL_SHARD_CAPACITY
+
 // A simple pool of iree_event_ts to recycle.
 //
+// Released events are cached per-thread in front of the shared pool so that
+// threads signaling and waiting at high rates (semaphores, fences, task
+// waits) don't all serialize on the shared pool. A thread that finds nothing
+// in its own cache or the shared pool will take events from other caches
+// before creating new ones.
+//
 // Thread-safe; multiple threads may acquire and release events from the pool.
 typedef struct iree_event_pool_t iree_event_pool_t;
 
 // Allocates a new event pool with up to |available_capacity| events.
+// The per-thread caches may retain up to IREE_EVENT_POOL_SHARD_CAPACITY
+// additional events each.
 iree_status_t iree_event_pool_allocate(iree_host_size_t available_capacity,
                                        iree_allocator_t host_allocator,
                                        iree_event_pool_t** out_event_pool);
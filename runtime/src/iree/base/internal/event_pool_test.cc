@@ -0,0 +1,169 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/event_pool.h"
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace {
+
+// Expects that all |events| are unsignaled.
+static void ExpectUnsignaled(iree_host_size_t event_count,
+                             iree_event_t* events) {
+  for (iree_host_size_t i = 0; i < event_count; ++i) {
+    IREE_EXPECT_STATUS_IS(IREE_STATUS_DEADLINE_EXCEEDED,
+                          iree_wait_one(&events[i], IREE_TIME_INFINITE_PAST));
+  }
+}
+
+// Tests that events released signaled are reset before being handed out
+// again, both from the thread cache and from the shared pool.
+TEST(EventPool, AcquireReturnsResetEvents) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(/*available_capacity=*/4,
+                                          iree_allocator_system(),
+                                          &event_pool));
+
+  // Enough to overflow the thread cache so that some events go through the
+  // shared pool.
+  constexpr iree_host_size_t kEventCount = IREE_EVENT_POOL_SHARD_CAPACITY + 4;
+  iree_event_t events[kEventCount];
+  IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, kEventCount, events));
+  ExpectUnsignaled(kEventCount, events);
+  for (iree_host_size_t i = 0; i < kEventCount; ++i) {
+    iree_event_set(&events[i]);
+  }
+  iree_event_pool_release(event_pool, kEventCount, events);
+
+  IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, kEventCount, events));
+  ExpectUnsignaled(kEventCount, events);
+  iree_event_pool_release(event_pool, kEventCount, events);
+
+  iree_event_pool_free(event_pool);
+}
+
+// Tests a pool with no shared capacity: only the thread caches retain events
+// and everything beyond them is created and destroyed on demand.
+TEST(EventPool, ZeroCapacity) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(/*available_capacity=*/0,
+                                          iree_allocator_system(),
+                                          &event_pool));
+
+  constexpr iree_host_size_t kEventCount = IREE_EVENT_POOL_SHARD_CAPACITY * 2;
+  iree_event_t events[kEventCount];
+  for (int i = 0; i < 4; ++i) {
+    IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, kEventCount, events));
+    ExpectUnsignaled(kEventCount, events);
+    iree_event_pool_release(event_pool, kEventCount, events);
+    IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, 1, events));
+    ExpectUnsignaled(1, events);
+    iree_event_pool_release(event_pool, 1, events);
+  }
+
+  iree_event_pool_free(event_pool);
+}
+
+// Tests releasing and acquiring one event at a time across several multiples
+// of the thread cache capacity so that the cache repeatedly spills to and
+// refills from the shared pool.
+TEST(EventPool, SpillAndRefill) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(
+      /*available_capacity=*/IREE_EVENT_POOL_SHARD_CAPACITY * 2,
+      iree_allocator_system(), &event_pool));
+
+  constexpr iree_host_size_t kEventCount = IREE_EVENT_POOL_SHARD_CAPACITY * 4;
+  iree_event_t events[kEventCount];
+  for (int round = 0; round < 4; ++round) {
+    for (iree_host_size_t i = 0; i < kEventCount; ++i) {
+      IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, 1, &events[i]));
+    }
+    ExpectUnsignaled(kEventCount, events);
+    for (iree_host_size_t i = 0; i < kEventCount; ++i) {
+      iree_event_set(&events[i]);
+      iree_event_pool_release(event_pool, 1, &events[i]);
+    }
+  }
+
+  // One large acquire drains the thread cache and the shared pool together.
+  IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, kEventCount, events));
+  ExpectUnsignaled(kEventCount, events);
+  iree_event_pool_release(event_pool, kEventCount, events);
+
+  iree_event_pool_free(event_pool);
+}
+
+// Tests events acquired on one thread and released on another, as happens when
+// a waiter acquires an event and the signaler releases it. Events accumulate
+// in the releasing thread's cache and must be found by the acquiring thread.
+TEST(EventPool, CrossThreadAcquireRelease) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(/*available_capacity=*/4,
+                                          iree_allocator_system(),
+                                          &event_pool));
+
+  constexpr iree_host_size_t kEventCount = IREE_EVENT_POOL_SHARD_CAPACITY * 3;
+  iree_event_t events[kEventCount];
+  for (int round = 0; round < 8; ++round) {
+    IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, kEventCount, events));
+    ExpectUnsignaled(kEventCount, events);
+    std::thread releaser([&]() {
+      for (iree_host_size_t i = 0; i < kEventCount; ++i) {
+        iree_event_set(&events[i]);
+      }
+      iree_event_pool_release(event_pool, kEventCount, events);
+    });
+    releaser.join();
+  }
+
+  iree_event_pool_free(event_pool);
+}
+
+// Tests many threads acquiring and releasing concurrently with mixed batch
+// sizes. There are more threads than shards so threads share caches and steal
+// from each other's while they are in use.
+TEST(EventPool, ConcurrentAcquireRelease) {
+  iree_event_pool_t* event_pool = NULL;
+  IREE_ASSERT_OK(iree_event_pool_allocate(/*available_capacity=*/16,
+                                          iree_allocator_system(),
+                                          &event_pool));
+
+  constexpr int kThreadCount = IREE_EVENT_POOL_SHARD_COUNT * 2;
+  constexpr int kIterationCount = 200;
+  constexpr iree_host_size_t kMaxBatchSize = IREE_EVENT_POOL_SHARD_CAPACITY;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&, t]() {
+      iree_event_t events[kMaxBatchSize];
+      for (int i = 0; i < kIterationCount; ++i) {
+        iree_host_size_t batch_size = 1 + (t + i) % kMaxBatchSize;
+        IREE_ASSERT_OK(
+            iree_event_pool_acquire(event_pool, batch_size, events));
+        ExpectUnsignaled(batch_size, events);
+        iree_event_set(&events[0]);
+        iree_event_pool_release(event_pool, batch_size, events);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  iree_event_t events[kMaxBatchSize];
+  IREE_ASSERT_OK(iree_event_pool_acquire(event_pool, kMaxBatchSize, events));
+  ExpectUnsignaled(kMaxBatchSize, events);
+  iree_event_pool_release(event_pool, kMaxBatchSize, events);
+
+  iree_event_pool_free(event_pool);
+}
+
+}  // namespace
+}  // namespace iree
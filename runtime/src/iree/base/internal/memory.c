@@ -6,6 +6,10 @@
 
 #include "iree/base/internal/memory.h"
 
+#include <string.h>
+
+#include "iree/base/internal/math.h"
+
 //===----------------------------------------------------------------------===//
 // Memory subsystem information and control
 //===----------------------------------------------------------------------===//
@@ -159,3 +163,369 @@ void iree_memory_flush_icache(void* base_address, iree_host_size_t length) {
 }
 
 #endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// Huge page allocator
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(MADV_HUGEPAGE)
+#define IREE_MEMORY_HAVE_HUGE_PAGES 1
+#endif  // MADV_HUGEPAGE
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
+#if !defined(IREE_MEMORY_HAVE_HUGE_PAGES)
+#define IREE_MEMORY_HAVE_HUGE_PAGES 0
+#endif  // !IREE_MEMORY_HAVE_HUGE_PAGES
+
+iree_status_t iree_memory_huge_page_mode_parse(
+    iree_string_view_t value, iree_memory_huge_page_mode_t* out_mode) {
+  IREE_ASSERT_ARGUMENT(out_mode);
+  if (iree_string_view_is_empty(value) ||
+      iree_string_view_equal(value, IREE_SV("none"))) {
+    *out_mode = IREE_MEMORY_HUGE_PAGE_MODE_NONE;
+  } else if (iree_string_view_equal(value, IREE_SV("transparent"))) {
+    *out_mode = IREE_MEMORY_HUGE_PAGE_MODE_TRANSPARENT;
+  } else if (iree_string_view_equal(value, IREE_SV("2mb"))) {
+    *out_mode = IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_2MB;
+  } else if (iree_string_view_equal(value, IREE_SV("1gb"))) {
+    *out_mode = IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_1GB;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown huge page mode '%.*s'; expected one of "
+                            "none, transparent, 2mb, or 1gb",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
+// A live mapping made by the huge page allocator.
+struct iree_memory_huge_page_mapping_t {
+  iree_memory_huge_page_mapping_t* next;
+  // Base address of the mapping; this is the pointer returned to users.
+  void* base_address;
+  // Total length of the mapping in bytes.
+  iree_host_size_t mapping_length;
+  // Length in bytes of the allocation as last requested by the user.
+  iree_host_size_t byte_length;
+};
+
+#if IREE_MEMORY_HAVE_HUGE_PAGES
+
+#if !defined(MAP_HUGE_SHIFT)
+#define MAP_HUGE_SHIFT 26
+#endif  // !MAP_HUGE_SHIFT
+
+// Returns the size of transparent huge pages on the system.
+static iree_host_size_t iree_memory_query_transparent_huge_page_size(void) {
+  iree_host_size_t page_size = 0;
+  int fd = open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size",
+                O_RDONLY | O_CLOEXEC);
+  if (fd >= 0) {
+    char buffer[32];
+    ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length > 0) {
+      buffer[length] = 0;
+      page_size = (iree_host_size_t)strtoull(buffer, NULL, 10);
+    }
+  }
+  // Older kernels don't report the size; all common configurations with 4KB
+  // base pages use 2MB.
+  if (!page_size || !iree_host_size_is_power_of_two(page_size)) {
+    page_size = 2 * 1024 * 1024;
+  }
+  return page_size;
+}
+
+// Maps |length| bytes (a multiple of the normal page size) aligned to the
+// transparent huge page size and advises the kernel to back it with huge
+// pages. Returns NULL if the mapping could not be made.
+static void* iree_memory_huge_page_map_transparent(
+    iree_memory_huge_page_allocator_t* allocator, iree_host_size_t length) {
+  // Over-reserve so that the mapping can be trimmed to an aligned base.
+  const iree_host_size_t alignment = allocator->transparent_page_size;
+  const iree_host_size_t reserve_length = length + alignment;
+  uint8_t* reserve_base =
+      (uint8_t*)mmap(NULL, reserve_length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (reserve_base == MAP_FAILED) return NULL;
+  uint8_t* base = (uint8_t*)iree_host_align((uintptr_t)reserve_base, alignment);
+  uint8_t* end = base + length;
+  uint8_t* reserve_end = reserve_base + reserve_length;
+  if (base > reserve_base) munmap(reserve_base, base - reserve_base);
+  if (reserve_end > end) munmap(end, reserve_end - end);
+  // Failure is ignored as THP may be disabled; the memory is usable anyway.
+  madvise(base, length, MADV_HUGEPAGE);
+  return base;
+}
+
+// Maps |length| bytes (a multiple of the huge page size) from the explicit
+// hugetlb pool. Returns NULL if the pool is unavailable or exhausted.
+static void* iree_memory_huge_page_map_explicit(
+    iree_memory_huge_page_allocator_t* allocator, iree_host_size_t length) {
+#if defined(MAP_HUGETLB)
+  const int page_shift =
+      iree_math_count_trailing_zeros_u64(allocator->huge_page_size);
+  void* base = mmap(NULL, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                        (page_shift << MAP_HUGE_SHIFT),
+                    -1, 0);
+  return base == MAP_FAILED ? NULL : base;
+#else
+  return NULL;
+#endif  // MAP_HUGETLB
+}
+
+// Maps a new zeroed region of at least |byte_length| bytes.
+static iree_status_t iree_memory_huge_page_map(
+    iree_memory_huge_page_allocator_t* allocator, iree_host_size_t byte_length,
+    void** out_base_address, iree_host_size_t* out_mapping_length) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)byte_length);
+  void* base_address = NULL;
+  iree_host_size_t mapping_length = 0;
+  if (allocator->mode == IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_2MB ||
+      allocator->mode == IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_1GB) {
+    mapping_length = iree_host_align(byte_length, allocator->huge_page_size);
+    base_address =
+        iree_memory_huge_page_map_explicit(allocator, mapping_length);
+  }
+  if (!base_address) {
+    mapping_length = iree_host_align(byte_length, allocator->normal_page_size);
+    base_address =
+        iree_memory_huge_page_map_transparent(allocator, mapping_length);
+  }
+  if (!base_address) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "failed to map %" PRIhsz " bytes", byte_length);
+  }
+  IREE_TRACE_ALLOC(base_address, byte_length);
+  *out_base_address = base_address;
+  *out_mapping_length = mapping_length;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_memory_huge_page_unmap(void* base_address,
+                                        iree_host_size_t mapping_length) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_FREE(base_address);
+  munmap(base_address, mapping_length);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+#else
+
+static iree_status_t iree_memory_huge_page_map(
+    iree_memory_huge_page_allocator_t* allocator, iree_host_size_t byte_length,
+    void** out_base_address, iree_host_size_t* out_mapping_length) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "huge pages not supported on this platform");
+}
+
+static void iree_memory_huge_page_unmap(void* base_address,
+                                        iree_host_size_t mapping_length) {}
+
+#endif  // IREE_MEMORY_HAVE_HUGE_PAGES
+
+void iree_memory_huge_page_allocator_initialize(
+    const iree_memory_huge_page_allocator_params_t* params,
+    iree_allocator_t fallback_allocator,
+    iree_memory_huge_page_allocator_t* out_allocator) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_allocator);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  memset(out_allocator, 0, sizeof(*out_allocator));
+  out_allocator->fallback_allocator = fallback_allocator;
+  out_allocator->normal_page_size = iree_memory_query_info().normal_page_size;
+  iree_slim_mutex_initialize(&out_allocator->mutex);
+
+#if IREE_MEMORY_HAVE_HUGE_PAGES
+  out_allocator->mode = params->mode;
+  out_allocator->transparent_page_size =
+      iree_memory_query_transparent_huge_page_size();
+#else
+  out_allocator->mode = IREE_MEMORY_HUGE_PAGE_MODE_NONE;
+  out_allocator->transparent_page_size = out_allocator->normal_page_size;
+#endif  // IREE_MEMORY_HAVE_HUGE_PAGES
+  switch (out_allocator->mode) {
+    case IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_2MB:
+      out_allocator->huge_page_size = 2 * 1024 * 1024;
+      break;
+    case IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_1GB:
+      out_allocator->huge_page_size = 1024 * 1024 * 1024;
+      break;
+    default:
+      out_allocator->huge_page_size = out_allocator->transparent_page_size;
+      break;
+  }
+  out_allocator->min_byte_length = params->min_byte_length
+                                       ? params->min_byte_length
+                                       : out_allocator->huge_page_size;
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_memory_huge_page_allocator_deinitialize(
+    iree_memory_huge_page_allocator_t* allocator) {
+  IREE_ASSERT_ARGUMENT(allocator);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT(!allocator->mapping_head,
+              "all huge page allocations must be freed before deinitializing");
+  iree_slim_mutex_deinitialize(&allocator->mutex);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns the live mapping with the given |base_address| or NULL if the
+// address was not mapped by |allocator| (in which case it came from the
+// fallback allocator). If |remove| is set the mapping is removed from the list.
+static iree_memory_huge_page_mapping_t* iree_memory_huge_page_find_mapping(
+    iree_memory_huge_page_allocator_t* allocator, void* base_address,
+    bool remove) {
+  // Mappings are always aligned to at least the transparent huge page size so
+  // fallback allocations can usually be identified without taking the lock.
+  if (allocator->mode == IREE_MEMORY_HUGE_PAGE_MODE_NONE ||
+      !iree_host_size_has_alignment((iree_host_size_t)base_address,
+                                    allocator->transparent_page_size)) {
+    return NULL;
+  }
+  iree_slim_mutex_lock(&allocator->mutex);
+  iree_memory_huge_page_mapping_t* prev = NULL;
+  iree_memory_huge_page_mapping_t* mapping = allocator->mapping_head;
+  while (mapping && mapping->base_address != base_address) {
+    prev = mapping;
+    mapping = mapping->next;
+  }
+  if (mapping && remove) {
+    if (prev) {
+      prev->next = mapping->next;
+    } else {
+      allocator->mapping_head = mapping->next;
+    }
+    mapping->next = NULL;
+  }
+  iree_slim_mutex_unlock(&allocator->mutex);
+  return mapping;
+}
+
+// Reallocates the huge page |mapping| to hold |byte_length| bytes.
+// The mapping is only moved if it must grow beyond its current length.
+static iree_status_t iree_memory_huge_page_allocator_remap(
+    iree_memory_huge_page_allocator_t* allocator,
+    iree_memory_huge_page_mapping_t* mapping, iree_host_size_t byte_length) {
+  if (byte_length <= mapping->mapping_length) {
+    mapping->byte_length = byte_length;
+    return iree_ok_status();
+  }
+  void* new_base_address = NULL;
+  iree_host_size_t new_mapping_length = 0;
+  IREE_RETURN_IF_ERROR(iree_memory_huge_page_map(
+      allocator, byte_length, &new_base_address, &new_mapping_length));
+  memcpy(new_base_address, mapping->base_address, mapping->byte_length);
+  iree_memory_huge_page_unmap(mapping->base_address, mapping->mapping_length);
+  // Only the owner of the allocation may reallocate it but other threads may
+  // be walking the list.
+  iree_slim_mutex_lock(&allocator->mutex);
+  mapping->base_address = new_base_address;
+  mapping->mapping_length = new_mapping_length;
+  mapping->byte_length = byte_length;
+  iree_slim_mutex_unlock(&allocator->mutex);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_memory_huge_page_allocator_alloc(
+    iree_memory_huge_page_allocator_t* allocator,
+    iree_allocator_command_t command,
+    const iree_allocator_alloc_params_t* params, void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(inout_ptr);
+  const iree_host_size_t byte_length = params->byte_length;
+
+  if (command == IREE_ALLOCATOR_COMMAND_REALLOC && *inout_ptr) {
+    iree_memory_huge_page_mapping_t* mapping =
+        iree_memory_huge_page_find_mapping(allocator, *inout_ptr,
+                                           /*remove=*/false);
+    if (mapping) {
+      IREE_RETURN_IF_ERROR(iree_memory_huge_page_allocator_remap(
+          allocator, mapping, byte_length));
+      *inout_ptr = mapping->base_address;
+      return iree_ok_status();
+    }
+    // Allocations stay on the fallback allocator when grown as we don't know
+    // how many bytes are valid to move into a new mapping.
+    return allocator->fallback_allocator.ctl(allocator->fallback_allocator.self,
+                                             command, params, inout_ptr);
+  }
+
+  if (allocator->mode == IREE_MEMORY_HUGE_PAGE_MODE_NONE ||
+      byte_length < allocator->min_byte_length) {
+    return allocator->fallback_allocator.ctl(allocator->fallback_allocator.self,
+                                             command, params, inout_ptr);
+  }
+
+  iree_memory_huge_page_mapping_t* mapping = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator->fallback_allocator, sizeof(*mapping), (void**)&mapping));
+  mapping->byte_length = byte_length;
+  iree_status_t status =
+      iree_memory_huge_page_map(allocator, byte_length, &mapping->base_address,
+                                &mapping->mapping_length);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(allocator->fallback_allocator, mapping);
+    return status;
+  }
+
+  // New mappings are zeroed by the system so MALLOC and CALLOC are the same.
+  iree_slim_mutex_lock(&allocator->mutex);
+  mapping->next = allocator->mapping_head;
+  allocator->mapping_head = mapping;
+  iree_slim_mutex_unlock(&allocator->mutex);
+  *inout_ptr = mapping->base_address;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_memory_huge_page_allocator_free(
+    iree_memory_huge_page_allocator_t* allocator, void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(inout_ptr);
+  if (!*inout_ptr) return iree_ok_status();
+  iree_memory_huge_page_mapping_t* mapping = iree_memory_huge_page_find_mapping(
+      allocator, *inout_ptr, /*remove=*/true);
+  if (!mapping) {
+    return allocator->fallback_allocator.ctl(allocator->fallback_allocator.self,
+                                             IREE_ALLOCATOR_COMMAND_FREE, NULL,
+                                             inout_ptr);
+  }
+  iree_memory_huge_page_unmap(mapping->base_address, mapping->mapping_length);
+  iree_allocator_free(allocator->fallback_allocator, mapping);
+  *inout_ptr = NULL;
+  return iree_ok_status();
+}
+
+iree_status_t iree_memory_huge_page_allocator_ctl(
+    void* self, iree_allocator_command_t command, const void* params,
+    void** inout_ptr) {
+  iree_memory_huge_page_allocator_t* allocator =
+      (iree_memory_huge_page_allocator_t*)self;
+  switch (command) {
+    case IREE_ALLOCATOR_COMMAND_MALLOC:
+    case IREE_ALLOCATOR_COMMAND_CALLOC:
+    case IREE_ALLOCATOR_COMMAND_REALLOC:
+      return iree_memory_huge_page_allocator_alloc(
+          allocator, command, (const iree_allocator_alloc_params_t*)params,
+          inout_ptr);
+    case IREE_ALLOCATOR_COMMAND_FREE:
+      return iree_memory_huge_page_allocator_free(allocator, inout_ptr);
+    default:
+      // Placement commands such as binding apply to any pages and are handled
+      // by the fallback allocator for both mapped and fallback allocations.
+      return allocator->fallback_allocator.ctl(
+          allocator->fallback_allocator.self, command, params, inout_ptr);
+  }
+}
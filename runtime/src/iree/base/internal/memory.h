@@ -8,6 +8,7 @@
 #define IREE_BASE_INTERNAL_MEMORY_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,6 +69,105 @@ void iree_memory_jit_context_end(void);
 // executing code from any pages that have been written during load.
 void iree_memory_flush_icache(void* base_address, iree_host_size_t length);
 
+//===----------------------------------------------------------------------===//
+// Huge page allocator
+//===----------------------------------------------------------------------===//
+
+// Controls whether and how huge pages back large allocations.
+typedef enum iree_memory_huge_page_mode_e {
+  // Huge pages are not used and all allocations use the fallback allocator.
+  IREE_MEMORY_HUGE_PAGE_MODE_NONE = 0,
+  // Large allocations are aligned to the transparent huge page size and
+  // advised with MADV_HUGEPAGE so that the kernel backs them with huge pages
+  // when it can. Requires THP to be set to `madvise` or `always`.
+  IREE_MEMORY_HUGE_PAGE_MODE_TRANSPARENT = 1,
+  // Large allocations are mapped from the 2MB hugetlb pool (MAP_HUGETLB).
+  // The pool must be reserved ahead of time (vm.nr_hugepages) and when it is
+  // exhausted allocations fall back to IREE_MEMORY_HUGE_PAGE_MODE_TRANSPARENT.
+  IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_2MB = 2,
+  // Large allocations are mapped from the 1GB hugetlb pool (MAP_HUGETLB).
+  // As with IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_2MB this falls back to
+  // transparent huge pages when the pool is exhausted.
+  IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_1GB = 3,
+} iree_memory_huge_page_mode_t;
+
+// Parses a huge page mode from one of `none`, `transparent`, `2mb`, or `1gb`.
+// An empty |value| is treated as `none`.
+iree_status_t iree_memory_huge_page_mode_parse(
+    iree_string_view_t value, iree_memory_huge_page_mode_t* out_mode);
+
+// Parameters controlling iree_memory_huge_page_allocator_t behavior.
+typedef struct iree_memory_huge_page_allocator_params_t {
+  // Huge page mode used for allocations of at least |min_byte_length|.
+  iree_memory_huge_page_mode_t mode;
+  // Minimum size, in bytes, of allocations backed by huge pages. Smaller
+  // allocations use the fallback allocator. 0 selects the huge page size.
+  iree_host_size_t min_byte_length;
+} iree_memory_huge_page_allocator_params_t;
+
+typedef struct iree_memory_huge_page_mapping_t iree_memory_huge_page_mapping_t;
+
+// An allocator that backs large allocations with huge pages to reduce TLB
+// pressure when streaming through large buffers.
+//
+// Allocations of at least min_byte_length bytes are mapped directly from the
+// system and are always aligned to the transparent huge page size (usually
+// 2MB) and so exceed any alignment required of buffer storage. Smaller
+// allocations and all allocations on platforms without huge page support are
+// passed through to the fallback allocator. Reallocations stay on whichever
+// path the allocation was first made on.
+//
+// Mappings are tracked out-of-line so that the allocation sizes requested are
+// exactly what is mapped: a 2MB allocation occupies a single 2MB huge page.
+//
+// Thread-safe; the fallback allocator must also be thread-safe.
+typedef struct iree_memory_huge_page_allocator_t {
+  // Huge page mode used for large allocations; may be downgraded from the
+  // requested mode if the platform does not support it.
+  iree_memory_huge_page_mode_t mode;
+  // Size, in bytes, of the huge pages requested for large allocations.
+  iree_host_size_t huge_page_size;
+  // Size, in bytes, of transparent huge pages. All large allocations are
+  // aligned to at least this even when explicit huge pages are unavailable.
+  iree_host_size_t transparent_page_size;
+  // Size, in bytes, of normal system pages.
+  iree_host_size_t normal_page_size;
+  // Minimum size, in bytes, of allocations backed by huge pages.
+  iree_host_size_t min_byte_length;
+  // Allocator used for small allocations and mapping tracking.
+  iree_allocator_t fallback_allocator;
+  // Guards the live mapping list.
+  iree_slim_mutex_t mutex;
+  // All live huge page mappings (unordered).
+  iree_memory_huge_page_mapping_t* mapping_head IREE_GUARDED_BY(mutex);
+} iree_memory_huge_page_allocator_t;
+
+// Initializes a huge page allocator in |out_allocator| that forwards small
+// allocations to |fallback_allocator|.
+void iree_memory_huge_page_allocator_initialize(
+    const iree_memory_huge_page_allocator_params_t* params,
+    iree_allocator_t fallback_allocator,
+    iree_memory_huge_page_allocator_t* out_allocator);
+
+// Deinitializes |allocator|. All allocations made from it must have been freed.
+void iree_memory_huge_page_allocator_deinitialize(
+    iree_memory_huge_page_allocator_t* allocator);
+
+// Control function for the huge page allocator; |self| is the
+// iree_memory_huge_page_allocator_t.
+iree_status_t iree_memory_huge_page_allocator_ctl(
+    void* self, iree_allocator_command_t command, const void* params,
+    void** inout_ptr);
+
+// Returns an iree_allocator_t that allocates from |allocator|.
+// The huge page allocator must remain live for as long as the returned
+// iree_allocator_t is used.
+static inline iree_allocator_t iree_memory_huge_page_allocator(
+    iree_memory_huge_page_allocator_t* allocator) {
+  iree_allocator_t v = {allocator, iree_memory_huge_page_allocator_ctl};
+  return v;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,112 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/memory.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+TEST(HugePageModeTest, Parse) {
+  iree_memory_huge_page_mode_t mode = IREE_MEMORY_HUGE_PAGE_MODE_TRANSPARENT;
+  IREE_EXPECT_OK(iree_memory_huge_page_mode_parse(IREE_SV(""), &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_HUGE_PAGE_MODE_NONE);
+  IREE_EXPECT_OK(
+      iree_memory_huge_page_mode_parse(IREE_SV("transparent"), &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_HUGE_PAGE_MODE_TRANSPARENT);
+  IREE_EXPECT_OK(iree_memory_huge_page_mode_parse(IREE_SV("2mb"), &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_2MB);
+  IREE_EXPECT_OK(iree_memory_huge_page_mode_parse(IREE_SV("1gb"), &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_1GB);
+  IREE_EXPECT_OK(iree_memory_huge_page_mode_parse(IREE_SV("none"), &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_HUGE_PAGE_MODE_NONE);
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_INVALID_ARGUMENT,
+      iree_memory_huge_page_mode_parse(IREE_SV("4kb"), &mode));
+}
+
+class HugePageAllocatorTest
+    : public ::testing::TestWithParam<iree_memory_huge_page_mode_t> {
+ protected:
+  void SetUp() override {
+    iree_memory_huge_page_allocator_params_t params = {
+        /*.mode=*/GetParam(),
+        /*.min_byte_length=*/0,
+    };
+    iree_memory_huge_page_allocator_initialize(&params, iree_allocator_system(),
+                                               &huge_page_allocator_);
+    allocator_ = iree_memory_huge_page_allocator(&huge_page_allocator_);
+  }
+
+  void TearDown() override {
+    iree_memory_huge_page_allocator_deinitialize(&huge_page_allocator_);
+  }
+
+  bool IsPageAligned(void* ptr) {
+    return iree_host_size_has_alignment(
+        (uintptr_t)ptr, huge_page_allocator_.transparent_page_size);
+  }
+
+  iree_memory_huge_page_allocator_t huge_page_allocator_;
+  iree_allocator_t allocator_;
+};
+
+// Small allocations are passed through to the fallback allocator.
+TEST_P(HugePageAllocatorTest, SmallAllocation) {
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator_, 64, (void**)&ptr));
+  for (int i = 0; i < 64; ++i) EXPECT_EQ(ptr[i], 0);
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator_, 128, (void**)&ptr));
+  iree_allocator_free(allocator_, ptr);
+  EXPECT_EQ(huge_page_allocator_.mapping_head, nullptr);
+}
+
+// Large allocations are mapped, zeroed, and aligned to the huge page size.
+TEST_P(HugePageAllocatorTest, LargeAllocation) {
+  const iree_host_size_t length = huge_page_allocator_.min_byte_length;
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator_, length, (void**)&ptr));
+  if (huge_page_allocator_.mode != IREE_MEMORY_HUGE_PAGE_MODE_NONE) {
+    EXPECT_TRUE(IsPageAligned(ptr));
+    EXPECT_NE(huge_page_allocator_.mapping_head, nullptr);
+  }
+  EXPECT_EQ(ptr[0], 0);
+  EXPECT_EQ(ptr[length - 1], 0);
+  memset(ptr, 0xCD, length);
+  iree_allocator_free(allocator_, ptr);
+  EXPECT_EQ(huge_page_allocator_.mapping_head, nullptr);
+}
+
+// Growing a large allocation preserves its contents.
+TEST_P(HugePageAllocatorTest, ReallocLarge) {
+  const iree_host_size_t length = huge_page_allocator_.min_byte_length;
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator_, length, (void**)&ptr));
+  memset(ptr, 0xCD, length);
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator_, length * 2, (void**)&ptr));
+  if (huge_page_allocator_.mode != IREE_MEMORY_HUGE_PAGE_MODE_NONE) {
+    EXPECT_TRUE(IsPageAligned(ptr));
+  }
+  EXPECT_EQ(ptr[0], 0xCD);
+  EXPECT_EQ(ptr[length - 1], 0xCD);
+  ptr[length * 2 - 1] = 0xAB;
+  iree_allocator_free(allocator_, ptr);
+  EXPECT_EQ(huge_page_allocator_.mapping_head, nullptr);
+}
+
+// Explicit huge pages are rarely reserved on test machines so the 2MB mode
+// usually exercises the fallback to transparent huge pages.
+INSTANTIATE_TEST_SUITE_P(
+    AllModes, HugePageAllocatorTest,
+    ::testing::Values(IREE_MEMORY_HUGE_PAGE_MODE_NONE,
+                      IREE_MEMORY_HUGE_PAGE_MODE_TRANSPARENT,
+                      IREE_MEMORY_HUGE_PAGE_MODE_EXPLICIT_2MB));
+
+}  // namespace
@@ -9,6 +9,8 @@
 #include <assert.h>
 #include <string.h>
 
+#include "iree/base/metrics.h"
+
 #if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
 
 // Disabled.
@@ -440,6 +442,29 @@ void iree_slim_mutex_unlock(iree_slim_mutex_t* mutex)
 
 #define iree_slim_mutex_value(value) (0x80000000u | (value))
 #define iree_slim_mutex_is_locked(value) (0x80000000u & (value))
+#define IREE_SLIM_MUTEX_HAS_STATISTICS 1
+
+// Minimum number of spin iterations performed before waiting in the kernel.
+// This is roughly in the range of spins that equal the cost of a futex wait
+// and lets locks with no history (or that recently only waited) still catch
+// short hold times.
+#define IREE_SLIM_MUTEX_MIN_SPIN_COUNT 16
+
+// Maximum number of spin iterations performed before waiting in the kernel.
+// Spinning longer than this costs more than the context switch it avoids.
+#define IREE_SLIM_MUTEX_MAX_SPIN_COUNT 1024
+
+// Maximum number of processor yields performed between polls of the lock.
+// Backoff doubles after each poll up to this limit to reduce the cache line
+// traffic spinners generate while the holder is trying to make progress.
+#define IREE_SLIM_MUTEX_MAX_BACKOFF 64
+
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_slim_mutex_contended_locks, "iree_slim_mutex_contended_locks_total",
+    "Total number of slim mutex acquisitions that found the mutex held.");
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_slim_mutex_waits, "iree_slim_mutex_waits_total",
+    "Total number of times slim mutex acquisitions waited in the kernel.");
 
 void iree_slim_mutex_initialize(iree_slim_mutex_t* out_mutex) {
   memset(out_mutex, 0, sizeof(*out_mutex));
@@ -451,6 +476,32 @@ void iree_slim_mutex_deinitialize(iree_slim_mutex_t* mutex) {
       iree_atomic_load_int32(&mutex->value, iree_memory_order_acquire) == 0);
 }
 
+bool iree_slim_mutex_query_statistics(
+    iree_slim_mutex_t* mutex, iree_slim_mutex_statistics_t* out_statistics) {
+  memset(out_statistics, 0, sizeof(*out_statistics));
+#if IREE_SLIM_MUTEX_STATISTICS
+  out_statistics->lock_count =
+      iree_atomic_load_int64(&mutex->lock_count, iree_memory_order_relaxed);
+  out_statistics->contended_count = iree_atomic_load_int64(
+      &mutex->contended_count, iree_memory_order_relaxed);
+  out_statistics->wait_count =
+      iree_atomic_load_int64(&mutex->wait_count, iree_memory_order_relaxed);
+  out_statistics->spin_count =
+      iree_atomic_load_int64(&mutex->spin_count, iree_memory_order_relaxed);
+  return true;
+#else
+  return false;
+#endif  // IREE_SLIM_MUTEX_STATISTICS
+}
+
+#if IREE_SLIM_MUTEX_STATISTICS
+#define iree_slim_mutex_statistics_add(mutex, field, delta) \
+  iree_atomic_fetch_add_int64(&(mutex)->field, (delta),     \
+                              iree_memory_order_relaxed)
+#else
+#define iree_slim_mutex_statistics_add(mutex, field, delta)
+#endif  // IREE_SLIM_MUTEX_STATISTICS
+
 // Helper to perform a compare_exchange operation on mutex->value, internally
 // used by iree_slim_mutex_try_lock and iree_slim_mutex_lock.
 static bool iree_slim_mutex_try_lock_compare_exchange(
@@ -472,10 +523,66 @@ static bool iree_slim_mutex_try_lock_compare_exchange(
       iree_memory_order_relaxed);
 }
 
+// Folds the |spin_count| of a contended acquisition into the spin estimate of
+// |mutex|. Acquisitions that succeeded while spinning move the estimate toward
+// the number of spins they needed and acquisitions that had to wait in the
+// kernel decay it as spinning was wasted on them. This is an exponential moving
+// average with a weight of 1/8 so a few outliers don't swing the estimate. The
+// step is rounded away from zero so that small differences still move it.
+static void iree_slim_mutex_update_spin_estimate(iree_slim_mutex_t* mutex,
+                                                 int32_t spin_count,
+                                                 bool did_wait) {
+  int32_t estimate =
+      iree_atomic_load_int32(&mutex->spin_estimate, iree_memory_order_relaxed);
+  int32_t delta = did_wait ? -estimate : spin_count - estimate;
+  estimate += (delta + (delta > 0 ? 7 : delta < 0 ? -7 : 0)) / 8;
+  iree_atomic_store_int32(&mutex->spin_estimate, estimate,
+                          iree_memory_order_relaxed);
+}
+
+// Spins on |mutex| for a duration based on its spin estimate and tries to
+// acquire it once it is observed unlocked. The caller has not registered as a
+// waiter. Returns true if the lock was acquired.
+static bool iree_slim_mutex_spin_lock(iree_slim_mutex_t* mutex)
+    IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
+  // Spin up to twice the typical hold time so that most acquisitions that
+  // would succeed by spinning do, but never longer than a kernel wait costs.
+  const int32_t max_spin_count = iree_min(
+      IREE_SLIM_MUTEX_MIN_SPIN_COUNT +
+          2 * iree_atomic_load_int32(&mutex->spin_estimate,
+                                     iree_memory_order_relaxed),
+      IREE_SLIM_MUTEX_MAX_SPIN_COUNT);
+  int32_t spin_count = 0;
+  int32_t backoff = 1;
+  while (spin_count < max_spin_count) {
+    for (int32_t i = 0; i < backoff; ++i) {
+      iree_processor_yield();
+    }
+    spin_count += backoff;
+    backoff = iree_min(backoff * 2, IREE_SLIM_MUTEX_MAX_BACKOFF);
+    int32_t value =
+        iree_atomic_load_int32(&mutex->value, iree_memory_order_relaxed);
+    // Acquire the lock bit and add ourselves to the interested count as if we
+    // had registered as a waiter in the slow path.
+    if (!iree_slim_mutex_is_locked(value) &&
+        iree_slim_mutex_try_lock_compare_exchange(
+            mutex, &value, iree_slim_mutex_value(value + 1))) {
+      iree_slim_mutex_statistics_add(mutex, spin_count, spin_count);
+      iree_slim_mutex_update_spin_estimate(mutex, spin_count,
+                                           /*did_wait=*/false);
+      return true;
+    }
+  }
+  iree_slim_mutex_statistics_add(mutex, spin_count, spin_count);
+  iree_slim_mutex_update_spin_estimate(mutex, spin_count, /*did_wait=*/true);
+  return false;
+}
+
 void iree_slim_mutex_lock(iree_slim_mutex_t* mutex)
     IREE_DISABLE_THREAD_SAFETY_ANALYSIS {
   // Refer to the iree_slim_mutex_t struct comment, "Notes on atomics".
   // Try first to acquire the lock from an unlocked state.
+  iree_slim_mutex_statistics_add(mutex, lock_count, 1);
   int32_t value = 0;
   if (iree_slim_mutex_try_lock_compare_exchange(mutex, &value,
                                                 iree_slim_mutex_value(1))) {
@@ -483,6 +590,16 @@ void iree_slim_mutex_lock(iree_slim_mutex_t* mutex)
     return;
   }
 
+  // Contended; everything below here is the slow path and can afford the
+  // bookkeeping.
+  iree_metric_register(&iree_slim_mutex_contended_locks.base);
+  iree_metric_counter_increment(&iree_slim_mutex_contended_locks);
+  iree_slim_mutex_statistics_add(mutex, contended_count, 1);
+
+  // Spin for a while before registering as a waiter as the lock is likely to
+  // be released soon if it's typically held only briefly.
+  if (iree_slim_mutex_spin_lock(mutex)) return;
+
   // Increment the count bits to indicate that we want the lock and are willing
   // to wait for it to be available. Note that between the CAS above and this
   // the lock could have been made available and we want to ensure we don't
@@ -502,29 +619,22 @@ void iree_slim_mutex_lock(iree_slim_mutex_t* mutex)
         // Successfully took the lock.
         return;
       }
-
-      // Spin a small amount to give us a tiny chance of falling through to the
-      // wait. We can tune this value based on likely contention, however 10-60
-      // is the recommended value and we should keep it in that order of
-      // magnitude. A way to think of this is "how many spins would we have to
-      // do to equal one call to iree_futex_wait" - if it's faster just to do
-      // a futex wait then we shouldn't be spinning!
-      // TODO(benvanik): measure on real workload on ARM; maybe remove entirely.
-      int spin_count = 100;
-      for (int i = 0; i < spin_count && iree_slim_mutex_is_locked(value); ++i) {
-        iree_processor_yield();
-        value =
-            iree_atomic_load_int32(&mutex->value, iree_memory_order_relaxed);
-      }
     }
 
     // While the lock is unavailable: wait for it to become available.
+    // Spinning has already been given its chance above (and is tuned to the
+    // observed hold times of the lock) so we go straight to the kernel.
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_slim_mutex_lock_wait");
+    iree_metric_register(&iree_slim_mutex_waits.base);
     while (iree_slim_mutex_is_locked(value)) {
+      iree_metric_counter_increment(&iree_slim_mutex_waits);
+      iree_slim_mutex_statistics_add(mutex, wait_count, 1);
       // NOTE: we don't care about wait failure here as we are going to loop
       // and check again anyway.
       iree_futex_wait(&mutex->value, value, IREE_TIME_INFINITE_FUTURE);
       value = iree_atomic_load_int32(&mutex->value, iree_memory_order_relaxed);
     }
+    IREE_TRACE_ZONE_END(z0);
   }
 }
 
@@ -587,6 +697,16 @@ void iree_slim_mutex_unlock(iree_slim_mutex_t* mutex)
 
 #endif  //  IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_SLOW_LOCKS
 
+#if !defined(IREE_SLIM_MUTEX_HAS_STATISTICS)
+
+bool iree_slim_mutex_query_statistics(
+    iree_slim_mutex_t* mutex, iree_slim_mutex_statistics_t* out_statistics) {
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  return false;
+}
+
+#endif  // !IREE_SLIM_MUTEX_HAS_STATISTICS
+
 //==============================================================================
 // iree_notification_t
 //==============================================================================
@@ -619,6 +739,11 @@ bool iree_notification_commit_wait(iree_notification_t* notification,
 
 void iree_notification_cancel_wait(iree_notification_t* notification) {}
 
+static bool iree_notification_is_posted(iree_notification_t* notification,
+                                        iree_wait_token_t wait_token) {
+  return true;
+}
+
 #elif !defined(IREE_RUNTIME_USE_FUTEX)
 
 // Emulation of a lock-free futex-backed notification using pthreads.
@@ -710,6 +835,14 @@ void iree_notification_cancel_wait(iree_notification_t* notification) {
   pthread_mutex_unlock(&notification->mutex);
 }
 
+static bool iree_notification_is_posted(iree_notification_t* notification,
+                                        iree_wait_token_t wait_token) {
+  pthread_mutex_lock(&notification->mutex);
+  bool result = notification->epoch != wait_token;
+  pthread_mutex_unlock(&notification->mutex);
+  return result;
+}
+
 #else
 
 // The 64-bit value used to atomically read-modify-write (RMW) the state is
@@ -848,8 +981,28 @@ void iree_notification_cancel_wait(iree_notification_t* notification) {
   SYNC_ASSERT((previous_value & IREE_NOTIFICATION_WAITER_MASK) != 0);
 }
 
+static bool iree_notification_is_posted(iree_notification_t* notification,
+                                        iree_wait_token_t wait_token) {
+  return iree_notification_test_wait_condition(notification, wait_token) ==
+         IREE_NOTIFICATION_RESULT_RESOLVED;
+}
+
 #endif  // DISABLED / HAS_FUTEX
 
+bool iree_notification_poll(iree_notification_t* notification,
+                            iree_wait_token_t wait_token,
+                            iree_duration_t spin_ns) {
+  if (iree_notification_is_posted(notification, wait_token)) return true;
+  if (spin_ns == IREE_DURATION_ZERO) return false;
+  const iree_time_t spin_deadline_ns = iree_time_now() + spin_ns;
+  do {
+    // Try to be nice to the processor when using SMT.
+    iree_processor_yield();
+    if (iree_notification_is_posted(notification, wait_token)) return true;
+  } while (iree_time_now() < spin_deadline_ns);
+  return false;
+}
+
 bool iree_notification_await(iree_notification_t* notification,
                              iree_condition_fn_t condition_fn,
                              void* condition_arg, iree_timeout_t timeout) {
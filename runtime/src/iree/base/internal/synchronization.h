@@ -82,6 +82,11 @@
 extern "C" {
 #endif
 
+// Enables per-mutex contention statistics on iree_slim_mutex_t.
+#if !defined(IREE_SLIM_MUTEX_STATISTICS)
+#define IREE_SLIM_MUTEX_STATISTICS 0
+#endif  // !IREE_SLIM_MUTEX_STATISTICS
+
 #define IREE_ALL_WAITERS INT32_MAX
 #define IREE_INFINITE_TIMEOUT_MS UINT32_MAX
 
@@ -268,12 +273,30 @@ void iree_mutex_unlock(iree_mutex_t* mutex)
 //   https://devblogs.microsoft.com/oldnewthing/20170601-00/?p=96265
 //
 // Linux/Android/others: futex
-//   Spins and after a short backoff drops to a futex and waits in the kernel.
+//   Spins with exponential backoff for an adaptive duration and then drops to
+//   a futex and waits in the kernel. Each mutex tracks a running estimate of
+//   how long contended acquisitions spent spinning before the lock became
+//   available (a proxy for the hold time of the lock) and uses it to bound the
+//   next spin: locks held briefly are spun on and locks held for long periods
+//   quickly fall through to the kernel instead of wasting cycles.
 // See:
 //   http://locklessinc.com/articles/futex_cheat_sheet/
 //   https://man7.org/linux/man-pages/man2/futex.2.html
 //   https://eli.thegreenplace.net/2018/basics-of-futexes/
 //   https://bartoszmilewski.com/2008/09/01/thin-lock-vs-futex/
+//
+// Contention statistics
+// ---------------------
+//
+// Process-wide counts of contended acquisitions and kernel waits across all
+// slim mutexes are always recorded as runtime metrics (see iree/base/metrics.h)
+// as they only cost anything on the contended path. Defining
+// IREE_SLIM_MUTEX_STATISTICS=1 additionally tracks per-mutex statistics that
+// can be queried with iree_slim_mutex_query_statistics to find the specific
+// locks that serialize a workload. This increases the size of each mutex and
+// adds an uncontended atomic increment to each acquisition so it is off by
+// default. Per-mutex statistics are only available with the futex
+// implementation.
 typedef struct iree_slim_mutex_t IREE_THREAD_ANNOTATION_ATTRIBUTE(
     capability("mutex")) {
 #if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
@@ -286,6 +309,15 @@ typedef struct iree_slim_mutex_t IREE_THREAD_ANNOTATION_ATTRIBUTE(
   SRWLOCK value;
 #elif defined(IREE_RUNTIME_USE_FUTEX)
   iree_atomic_int32_t value;
+  // Running average of the spin iterations contended acquisitions required.
+  // Only a hint and accessed with relaxed ordering.
+  iree_atomic_int32_t spin_estimate;
+#if IREE_SLIM_MUTEX_STATISTICS
+  iree_atomic_int64_t lock_count;
+  iree_atomic_int64_t contended_count;
+  iree_atomic_int64_t wait_count;
+  iree_atomic_int64_t spin_count;
+#endif  // IREE_SLIM_MUTEX_STATISTICS
 #else
   iree_mutex_t impl;  // fallback
 #endif  // IREE_PLATFORM_*
@@ -333,6 +365,24 @@ bool iree_slim_mutex_try_lock(iree_slim_mutex_t* mutex)
 void iree_slim_mutex_unlock(iree_slim_mutex_t* mutex)
     IREE_THREAD_ANNOTATION_ATTRIBUTE(release_capability(mutex));
 
+// Contention statistics of a single slim mutex.
+typedef struct iree_slim_mutex_statistics_t {
+  // Total number of iree_slim_mutex_lock calls.
+  int64_t lock_count;
+  // Number of lock calls that found the mutex held.
+  int64_t contended_count;
+  // Number of times a lock call waited in the kernel.
+  int64_t wait_count;
+  // Total spin iterations performed by contended lock calls.
+  int64_t spin_count;
+} iree_slim_mutex_statistics_t;
+
+// Queries the contention statistics of |mutex|.
+// Returns false and zeros |out_statistics| if per-mutex statistics are
+// unavailable in this build (see IREE_SLIM_MUTEX_STATISTICS).
+bool iree_slim_mutex_query_statistics(
+    iree_slim_mutex_t* mutex, iree_slim_mutex_statistics_t* out_statistics);
+
 //==============================================================================
 // iree_notification_t
 //==============================================================================
@@ -432,6 +482,23 @@ bool iree_notification_commit_wait(iree_notification_t* notification,
 //   guaranteed.
 void iree_notification_cancel_wait(iree_notification_t* notification);
 
+// Returns true if |notification| has been posted since |wait_token| was
+// returned from iree_notification_prepare_wait. If |spin_ns| is not
+// IREE_DURATION_ZERO the poll will spin for up to the specified duration
+// waiting for a post before returning false. Never enters the system wait API.
+//
+// This allows callers to poll for a notification without being registered as
+// a waiter: after iree_notification_cancel_wait the token can still be polled
+// and posting threads need not wake the caller via the system. Callers must
+// prepare a new wait before committing to block and compare the new token to
+// the polled one to avoid missing posts that happen in between.
+//
+// Acts as (at least) a memory_order_acquire operation on the notification
+// object when it returns true.
+bool iree_notification_poll(iree_notification_t* notification,
+                            iree_wait_token_t wait_token,
+                            iree_duration_t spin_ns);
+
 // Returns true if the condition is true.
 // |arg| is the |condition_arg| passed to the await function.
 // Implementations must ensure they are coherent with their state values.
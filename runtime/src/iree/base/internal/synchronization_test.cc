@@ -7,6 +7,7 @@
 #include "iree/base/internal/synchronization.h"
 
 #include <thread>
+#include <vector>
 
 #include "iree/testing/gtest.h"
 
@@ -171,6 +172,40 @@ TEST(SlimMutexTest, ExclusiveAccessTryLock) {
   TestMutexExclusiveAccessTryLock<iree_slim_mutex_t>();
 }
 
+// Tests that many threads hammering a single slim mutex (going through both the
+// spinning and kernel wait paths) all get exclusive access.
+TEST(SlimMutexTest, Contention) {
+  static constexpr int kThreadCount = 8;
+  static constexpr int kIterationCount = 20000;
+  iree_slim_mutex_t mutex;
+  iree_slim_mutex_initialize(&mutex);
+  int counter = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < kIterationCount; ++j) {
+        Mutex<iree_slim_mutex_t>::Lock(&mutex);
+        ++counter;
+        // Occasionally hold the lock long enough for waiters to give up
+        // spinning and wait in the kernel.
+        if ((j % 1024) == 0) std::this_thread::yield();
+        Mutex<iree_slim_mutex_t>::Unlock(&mutex);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(counter, kThreadCount * kIterationCount);
+
+  iree_slim_mutex_statistics_t statistics;
+  if (iree_slim_mutex_query_statistics(&mutex, &statistics)) {
+    EXPECT_EQ(statistics.lock_count, kThreadCount * kIterationCount);
+    EXPECT_LE(statistics.contended_count, statistics.lock_count);
+  } else {
+    EXPECT_EQ(statistics.lock_count, 0);
+  }
+  iree_slim_mutex_deinitialize(&mutex);
+}
+
 //==============================================================================
 // iree_notification_t
 //==============================================================================
@@ -217,4 +252,29 @@ TEST(NotificationTest, Timeout) {
   iree_notification_deinitialize(&notification);
 }
 
+TEST(NotificationTest, PollAfterCancel) {
+  iree_notification_t notification;
+  iree_notification_initialize(&notification);
+
+  // Polling does not require being registered as a waiter.
+  iree_wait_token_t wait_token = iree_notification_prepare_wait(&notification);
+  iree_notification_cancel_wait(&notification);
+  EXPECT_FALSE(iree_notification_poll(&notification, wait_token,
+                                      IREE_DURATION_ZERO));
+
+  iree_notification_post(&notification, IREE_ALL_WAITERS);
+  EXPECT_TRUE(iree_notification_poll(&notification, wait_token,
+                                      IREE_DURATION_ZERO));
+
+  // New tokens observe the post and are unresolved until the next one.
+  iree_wait_token_t new_wait_token =
+      iree_notification_prepare_wait(&notification);
+  EXPECT_NE(wait_token, new_wait_token);
+  EXPECT_FALSE(iree_notification_poll(&notification, new_wait_token,
+                                      /*spin_ns=*/1000000));
+  iree_notification_cancel_wait(&notification);
+
+  iree_notification_deinitialize(&notification);
+}
+
 }  // namespace
@@ -41,6 +41,61 @@ void iree_thread_affinity_set_any(iree_thread_affinity_t* out_thread_affinity) {
   memset(out_thread_affinity, 0x00, sizeof(*out_thread_affinity));
 }
 
+iree_status_t iree_thread_affinity_parse(
+    iree_string_view_t value, iree_thread_affinity_t* out_thread_affinity) {
+  iree_thread_affinity_set_any(out_thread_affinity);
+  value = iree_string_view_trim(value);
+  if (iree_string_view_is_empty(value) ||
+      iree_string_view_equal(value, IREE_SV("any"))) {
+    return iree_ok_status();
+  }
+  bool smt = iree_string_view_consume_suffix(&value, IREE_SV("+smt"));
+  uint32_t id = 0;
+  if (!iree_string_view_atoi_uint32(value, &id) || id >= (1u << 23)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid thread affinity '%.*s'; expected `any` "
+                            "or a processor ID optionally suffixed with `+smt`",
+                            (int)value.size, value.data);
+  }
+  out_thread_affinity->specified = 1;
+  out_thread_affinity->smt = smt ? 1 : 0;
+  out_thread_affinity->id = id;
+  return iree_ok_status();
+}
+
+//==============================================================================
+// iree_thread_priority_class_t
+//==============================================================================
+
+iree_status_t iree_thread_priority_class_parse(
+    iree_string_view_t value,
+    iree_thread_priority_class_t* out_priority_class) {
+  static const struct {
+    const char* name;
+    iree_thread_priority_class_t priority_class;
+  } kPriorityClasses[] = {
+      {"lowest", IREE_THREAD_PRIORITY_CLASS_LOWEST},
+      {"low", IREE_THREAD_PRIORITY_CLASS_LOW},
+      {"normal", IREE_THREAD_PRIORITY_CLASS_NORMAL},
+      {"high", IREE_THREAD_PRIORITY_CLASS_HIGH},
+      {"highest", IREE_THREAD_PRIORITY_CLASS_HIGHEST},
+  };
+  *out_priority_class = IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  value = iree_string_view_trim(value);
+  if (iree_string_view_is_empty(value)) return iree_ok_status();
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(kPriorityClasses); ++i) {
+    iree_string_view_t name = iree_make_cstring_view(kPriorityClasses[i].name);
+    if (iree_string_view_equal(value, name)) {
+      *out_priority_class = kPriorityClasses[i].priority_class;
+      return iree_ok_status();
+    }
+  }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                          "invalid thread priority class '%.*s'; expected "
+                          "`lowest`, `low`, `normal`, `high`, or `highest`",
+                          (int)value.size, value.data);
+}
+
 //==============================================================================
 // iree_thread_override_list_t
 //==============================================================================
@@ -46,6 +46,11 @@ typedef enum iree_thread_priority_class_e {
   IREE_THREAD_PRIORITY_CLASS_HIGHEST = 2,
 } iree_thread_priority_class_t;
 
+// Parses |value| as one of `lowest`, `low`, `normal`, `high`, or `highest`.
+// Used to specify thread priority classes via flags.
+iree_status_t iree_thread_priority_class_parse(
+    iree_string_view_t value, iree_thread_priority_class_t* out_priority_class);
+
 // Specifies the processor affinity for a particular thread.
 // Each platform handles this differently (if at all).
 //
@@ -107,6 +112,14 @@ typedef struct iree_thread_affinity_t {
 // Sets |thread_affinity| to match with any processor in the system.
 void iree_thread_affinity_set_any(iree_thread_affinity_t* out_thread_affinity);
 
+// Parses |value| as either `any` (or empty) or a logical processor ID
+// optionally suffixed with `+smt` to reserve the SMT sibling of the processor
+// as well (e.g. `3` or `6+smt`). Processor IDs match those used by
+// iree_thread_request_affinity on the platform (the Linux logical CPU ID).
+// Used to pin runtime-internal threads via flags.
+iree_status_t iree_thread_affinity_parse(
+    iree_string_view_t value, iree_thread_affinity_t* out_thread_affinity);
+
 // Thread creation parameters.
 // All are optional and the entire struct can safely be zero-initialized.
 typedef struct iree_thread_create_params_t {
@@ -14,6 +14,7 @@
 #include <mach/thread_act.h>
 #include <pthread.h>
 #include <sched.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "iree/base/internal/atomics.h"
@@ -221,6 +222,14 @@ void iree_thread_request_affinity(iree_thread_t* thread,
                                   iree_thread_affinity_t affinity) {
   if (!affinity.specified) return;
   IREE_TRACE_ZONE_BEGIN(z0);
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+  char affinity_desc[32];
+  int affinity_desc_length = snprintf(
+      affinity_desc, IREE_ARRAYSIZE(affinity_desc), "group=%d, id=%d, smt=%d",
+      affinity.group, affinity.id, affinity.smt);
+  IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW(z0, affinity_desc,
+                                          affinity_desc_length);
+#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
   // Use mach_task_self when the caller requesting the affinity change is the
   // thread being changed.
@@ -19,6 +19,51 @@
 namespace {
 
 using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+//==============================================================================
+// Flag parsing
+//==============================================================================
+
+TEST(ThreadAffinityTest, Parse) {
+  iree_thread_affinity_t affinity;
+  IREE_ASSERT_OK(iree_thread_affinity_parse(IREE_SV("any"), &affinity));
+  EXPECT_FALSE(affinity.specified);
+  IREE_ASSERT_OK(iree_thread_affinity_parse(IREE_SV(""), &affinity));
+  EXPECT_FALSE(affinity.specified);
+
+  IREE_ASSERT_OK(iree_thread_affinity_parse(IREE_SV("3"), &affinity));
+  EXPECT_TRUE(affinity.specified);
+  EXPECT_FALSE(affinity.smt);
+  EXPECT_EQ(3u, affinity.id);
+
+  IREE_ASSERT_OK(iree_thread_affinity_parse(IREE_SV("6+smt"), &affinity));
+  EXPECT_TRUE(affinity.specified);
+  EXPECT_TRUE(affinity.smt);
+  EXPECT_EQ(6u, affinity.id);
+
+  EXPECT_THAT(Status(iree_thread_affinity_parse(IREE_SV("core0"), &affinity)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_thread_affinity_parse(IREE_SV("-1"), &affinity)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(ThreadPriorityClassTest, Parse) {
+  iree_thread_priority_class_t priority_class;
+  IREE_ASSERT_OK(
+      iree_thread_priority_class_parse(IREE_SV("lowest"), &priority_class));
+  EXPECT_EQ(IREE_THREAD_PRIORITY_CLASS_LOWEST, priority_class);
+  IREE_ASSERT_OK(
+      iree_thread_priority_class_parse(IREE_SV("high"), &priority_class));
+  EXPECT_EQ(IREE_THREAD_PRIORITY_CLASS_HIGH, priority_class);
+  IREE_ASSERT_OK(
+      iree_thread_priority_class_parse(IREE_SV(""), &priority_class));
+  EXPECT_EQ(IREE_THREAD_PRIORITY_CLASS_NORMAL, priority_class);
+  EXPECT_THAT(Status(iree_thread_priority_class_parse(IREE_SV("realtime"),
+                                                      &priority_class)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
 
 //==============================================================================
 // iree_thread_t
@@ -229,6 +229,7 @@ uintptr_t iree_thread_id(iree_thread_t* thread) {
 static void iree_thread_set_priority_class(
     iree_thread_t* thread, iree_thread_priority_class_t priority_class) {
   IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, priority_class);
 
   DWORD priority = THREAD_PRIORITY_NORMAL;
   switch (priority_class) {
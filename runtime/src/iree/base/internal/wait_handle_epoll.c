@@ -9,57 +9,452 @@
 
 #if IREE_WAIT_API == IREE_WAIT_API_EPOLL
 
+#include <errno.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "iree/base/internal/math.h"
 #include "iree/base/internal/wait_handle_posix.h"
 
+//===----------------------------------------------------------------------===//
+// Platform utilities
+//===----------------------------------------------------------------------===//
+
+// Maximum number of events harvested from the kernel per epoll_wait during
+// iree_wait_all. iree_wait_any only ever needs one.
+#define IREE_WAIT_SET_EPOLL_EVENT_BATCH 32
+
+// Minimum number of entries in the handle table. The table is kept at most
+// half full so this allows for 8 unique handles before growing.
+#define IREE_WAIT_SET_MIN_ENTRY_CAPACITY 16
+
+// epoll_wait may spuriously wake with an EINTR. We don't do anything with that
+// opportunity (no fancy signal stuff), but we do need to retry the wait and
+// ensure that we do so with an updated timeout based on the deadline.
+//
+// Documentation: https://man7.org/linux/man-pages/man2/epoll_wait.2.html
+static iree_status_t iree_syscall_epoll_wait(int epoll_fd,
+                                             struct epoll_event* events,
+                                             int max_events,
+                                             iree_time_t deadline_ns,
+                                             int* out_signaled_count) {
+  *out_signaled_count = 0;
+  int rv = -1;
+  do {
+    uint32_t timeout_ms = iree_absolute_deadline_to_timeout_ms(deadline_ns);
+    rv = epoll_wait(epoll_fd, events, max_events, (int)timeout_ms);
+  } while (rv < 0 && errno == EINTR);
+  if (rv > 0) {
+    // One or more events set.
+    *out_signaled_count = rv;
+    return iree_ok_status();
+  } else if (IREE_UNLIKELY(rv < 0)) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "epoll_wait failure %d", errno);
+  }
+  // rv == 0
+  // Timeout; no events set.
+  return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
+// Registers |fd| with the |epoll_fd| for readability.
+static iree_status_t iree_syscall_epoll_add(int epoll_fd, int fd) {
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN | EPOLLPRI;  // implicit EPOLLERR | EPOLLHUP
+  event.data.fd = fd;
+  if (IREE_UNLIKELY(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0)) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "epoll_ctl add failure %d", errno);
+  }
+  return iree_ok_status();
+}
+
+// Unregisters |fd| from the |epoll_fd|.
+// Failures are ignored: the kernel drops closed file descriptions from the
+// epoll set on its own and that is the only way the removal can fail when used
+// correctly.
+static void iree_syscall_epoll_del(int epoll_fd, int fd) {
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, &event);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_wait_set_t
 //===----------------------------------------------------------------------===//
 
-// TODO(benvanik): iree_wait_set_s using an epoll fd.
-// epoll lets us route the wait set operations right to kernel and not need our
-// own duplicate data structure. epoll is great, just not available on mac/ios
-// so we still need poll for that. linux/android/bsd all have epoll, though.
+// A unique handle registered with the epoll set.
+typedef struct iree_wait_set_entry_t {
+  // Read fd of the handle or -1 if the entry is unused.
+  int fd;
+  // Number of times the handle has been inserted without a matching erase.
+  uint32_t ref_count;
+  // True if the handle has been signaled during the current iree_wait_all and
+  // is temporarily removed from the epoll set.
+  bool signaled;
+  // User-provided handle. We only really need to track these so that we can
+  // preserve the handle types when returning wake handles.
+  iree_wait_handle_t handle;
+} iree_wait_set_entry_t;
+
+// The kernel owns the registered handles and only reports those that are ready
+// so waits scale with the number of ready handles instead of the number
+// registered. We keep an open-addressing table keyed by fd alongside it so that
+// we can reference count duplicate insertions and map ready fds back to the
+// user handles without ever walking the whole set.
 struct iree_wait_set_t {
-  // NOTE: we could in theory use the epoll handle directly (iree_wait_set_s
-  // then is just a pointer). Then allocate/free just go straight to the system.
-  int reserved;
+  iree_allocator_t allocator;
+
+  // epoll instance all unique handles are registered with.
+  int epoll_fd;
+
+  // Total number of unique handles in the set.
+  iree_host_size_t handle_count;
+
+  // Power-of-two capacity of the entry table.
+  iree_host_size_t entry_capacity;
+
+  // Linear-probing hash table of entry_capacity entries.
+  // fds are small dense integers and make a fine hash on their own.
+  iree_wait_set_entry_t* entries;
 };
 
+// Allocates an empty entry table with |entry_capacity| entries.
+static iree_status_t iree_wait_set_allocate_entries(
+    iree_allocator_t allocator, iree_host_size_t entry_capacity,
+    iree_wait_set_entry_t** out_entries) {
+  iree_wait_set_entry_t* entries = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      allocator, entry_capacity * sizeof(*entries), (void**)&entries));
+  for (iree_host_size_t i = 0; i < entry_capacity; ++i) {
+    entries[i].fd = -1;
+  }
+  *out_entries = entries;
+  return iree_ok_status();
+}
+
+// Returns the index of the entry for |fd|, or if not present the index of the
+// unused entry it would be inserted at.
+static iree_host_size_t iree_wait_set_probe(const iree_wait_set_t* set,
+                                            int fd) {
+  const iree_host_size_t mask = set->entry_capacity - 1;
+  iree_host_size_t index = (iree_host_size_t)fd & mask;
+  while (set->entries[index].fd != -1 && set->entries[index].fd != fd) {
+    index = (index + 1) & mask;
+  }
+  return index;
+}
+
+// Returns the entry for |fd|, or NULL if not present. |index_hint| is checked
+// first and may be the index iree_wait_any stored in a wake handle.
+static iree_wait_set_entry_t* iree_wait_set_find(iree_wait_set_t* set, int fd,
+                                                 iree_host_size_t index_hint) {
+  if (index_hint < set->entry_capacity &&
+      set->entries[index_hint].fd == fd) {
+    return &set->entries[index_hint];
+  }
+  iree_wait_set_entry_t* entry = &set->entries[iree_wait_set_probe(set, fd)];
+  return entry->fd == fd ? entry : NULL;
+}
+
+// Doubles the entry table capacity and rehashes all entries.
+static iree_status_t iree_wait_set_grow(iree_wait_set_t* set) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_wait_set_entry_t* old_entries = set->entries;
+  const iree_host_size_t old_capacity = set->entry_capacity;
+  iree_wait_set_entry_t* new_entries = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_wait_set_allocate_entries(set->allocator, old_capacity * 2,
+                                         &new_entries));
+  set->entries = new_entries;
+  set->entry_capacity = old_capacity * 2;
+  for (iree_host_size_t i = 0; i < old_capacity; ++i) {
+    if (old_entries[i].fd == -1) continue;
+    set->entries[iree_wait_set_probe(set, old_entries[i].fd)] = old_entries[i];
+  }
+  iree_allocator_free(set->allocator, old_entries);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Removes the |entry| from the table by shifting back any entries in the same
+// probe sequence so that lookups never need tombstones.
+static void iree_wait_set_remove_entry(iree_wait_set_t* set,
+                                       iree_wait_set_entry_t* entry) {
+  const iree_host_size_t mask = set->entry_capacity - 1;
+  iree_host_size_t hole = (iree_host_size_t)(entry - set->entries);
+  iree_host_size_t index = hole;
+  while (true) {
+    index = (index + 1) & mask;
+    if (set->entries[index].fd == -1) break;
+    // Entries whose home slot lies cyclically within (hole, index] are still
+    // reachable and must stay; anything else can fill the hole.
+    iree_host_size_t home = (iree_host_size_t)set->entries[index].fd & mask;
+    bool reachable = hole <= index ? (hole < home && home <= index)
+                                   : (hole < home || home <= index);
+    if (reachable) continue;
+    set->entries[hole] = set->entries[index];
+    hole = index;
+  }
+  set->entries[hole].fd = -1;
+}
+
 iree_status_t iree_wait_set_allocate(iree_host_size_t capacity,
                                      iree_allocator_t allocator,
                                      iree_wait_set_t** out_set) {
-  // TODO(benvanik): epoll_create()
+  IREE_ASSERT_ARGUMENT(out_set);
+  *out_set = NULL;
+
+  // The set grows as needed and |capacity| only sizes the initial table, but
+  // we still reject sizes that indicate a bug in the caller to match the other
+  // implementations.
+  if (capacity >= UINT16_MAX) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "wait set capacity of %" PRIhsz " is unreasonably large", capacity);
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_wait_set_t* set = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, sizeof(*set), (void**)&set));
+  set->allocator = allocator;
+  set->handle_count = 0;
+  set->entry_capacity = (iree_host_size_t)iree_math_round_up_to_pow2_u32(
+      (uint32_t)iree_max(capacity * 2, IREE_WAIT_SET_MIN_ENTRY_CAPACITY));
+  set->entries = NULL;
+
+  iree_status_t status = iree_wait_set_allocate_entries(
+      allocator, set->entry_capacity, &set->entries);
+  if (iree_status_is_ok(status)) {
+    set->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (IREE_UNLIKELY(set->epoll_fd < 0)) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "epoll_create1 failure %d", errno);
+    }
+  } else {
+    set->epoll_fd = -1;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_set = set;
+  } else {
+    iree_wait_set_free(set);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 void iree_wait_set_free(iree_wait_set_t* set) {
-  // TODO(benvanik): close()
+  if (!set) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  // Closing the epoll fd drops all registrations.
+  if (set->epoll_fd >= 0) close(set->epoll_fd);
+  iree_allocator_free(set->allocator, set->entries);
+  iree_allocator_free(set->allocator, set);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_wait_set_is_empty(const iree_wait_set_t* set) {
+  return set->handle_count == 0;
 }
 
 iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
                                    iree_wait_handle_t handle) {
-  // TODO(benvanik): epoll_ctl(EPOLL_CTL_ADD)
+  // NOTE: like poll we ignore any negative fds.
+  int fd = iree_wait_primitive_get_read_fd(&handle);
+  if (fd < 0) return iree_ok_status();
+
+  iree_wait_set_entry_t* entry = &set->entries[iree_wait_set_probe(set, fd)];
+  if (entry->fd == fd) {
+    // Already registered with the kernel; just track the duplicate.
+    ++entry->ref_count;
+    return iree_ok_status();
+  }
+
+  // Keep the table at most half full so that probe sequences stay short.
+  if ((set->handle_count + 1) * 2 > set->entry_capacity) {
+    IREE_RETURN_IF_ERROR(iree_wait_set_grow(set));
+    entry = &set->entries[iree_wait_set_probe(set, fd)];
+  }
+
+  IREE_RETURN_IF_ERROR(iree_syscall_epoll_add(set->epoll_fd, fd));
+
+  entry->fd = fd;
+  entry->ref_count = 1;
+  entry->signaled = false;
+  iree_wait_handle_wrap_primitive(handle.type, handle.value, &entry->handle);
+  ++set->handle_count;
+  return iree_ok_status();
 }
 
 void iree_wait_set_erase(iree_wait_set_t* set, iree_wait_handle_t handle) {
-  // TODO(benvanik): epoll_ctl(EPOLL_CTL_DEL)
+  int fd = iree_wait_primitive_get_read_fd(&handle);
+  if (fd < 0) return;
+
+  // The index set after an iree_wait_any wake lets us skip the probe.
+  iree_wait_set_entry_t* entry =
+      iree_wait_set_find(set, fd, handle.set_internal.index);
+  if (!entry) return;
+  if (--entry->ref_count > 0) return;
+
+  iree_syscall_epoll_del(set->epoll_fd, fd);
+  iree_wait_set_remove_entry(set, entry);
+  --set->handle_count;
 }
 
 void iree_wait_set_clear(iree_wait_set_t* set) {
-  // TODO(benvanik): close and reopen?
+  if (set->handle_count == 0) return;
+  for (iree_host_size_t i = 0; i < set->entry_capacity; ++i) {
+    iree_wait_set_entry_t* entry = &set->entries[i];
+    if (entry->fd == -1) continue;
+    iree_syscall_epoll_del(set->epoll_fd, entry->fd);
+    entry->fd = -1;
+  }
+  set->handle_count = 0;
+}
+
+// Maps an epoll event bitfield result to a status (on failure) and an
+// indicator of whether the event was signaled.
+static iree_status_t iree_wait_set_resolve_epoll_events(uint32_t events,
+                                                        bool* out_signaled) {
+  if (events & EPOLLERR) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "EPOLLERR on fd");
+  } else if (events & EPOLLHUP) {
+    return iree_make_status(IREE_STATUS_CANCELLED, "EPOLLHUP on fd");
+  }
+  *out_signaled = (events & (EPOLLIN | EPOLLPRI)) != 0;
+  return iree_ok_status();
 }
 
 iree_status_t iree_wait_all(iree_wait_set_t* set, iree_time_t deadline_ns) {
-  // TODO(benvanik): epoll_wait
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count == 0) {
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Wait-all requires that we repeatedly wait until all handles have been
+  // signaled. Level-triggered epoll keeps reporting signaled handles so we
+  // temporarily remove each from the epoll set once seen and only handles we
+  // are still waiting on can wake us.
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t unsignaled_count = set->handle_count;
+  do {
+    struct epoll_event events[IREE_WAIT_SET_EPOLL_EVENT_BATCH];
+    int signaled_count = 0;
+    status = iree_syscall_epoll_wait(set->epoll_fd, events,
+                                     IREE_ARRAYSIZE(events), deadline_ns,
+                                     &signaled_count);
+    if (!iree_status_is_ok(status)) break;
+    for (int i = 0; i < signaled_count; ++i) {
+      bool signaled = false;
+      status = iree_wait_set_resolve_epoll_events(events[i].events, &signaled);
+      if (!iree_status_is_ok(status)) break;
+      if (!signaled) continue;
+      iree_wait_set_entry_t* entry =
+          iree_wait_set_find(set, events[i].data.fd, IREE_HOST_SIZE_MAX);
+      if (!entry || entry->signaled) continue;
+      entry->signaled = true;
+      iree_syscall_epoll_del(set->epoll_fd, entry->fd);
+      --unsignaled_count;
+    }
+  } while (iree_status_is_ok(status) && unsignaled_count > 0);
+
+  // Re-register all of the handles we removed so that the next wait can
+  // happen. Wait-all is rare compared to wait-any and this is only one syscall
+  // per handle.
+  for (iree_host_size_t i = 0; i < set->entry_capacity; ++i) {
+    iree_wait_set_entry_t* entry = &set->entries[i];
+    if (entry->fd == -1 || !entry->signaled) continue;
+    entry->signaled = false;
+    iree_status_t add_status = iree_syscall_epoll_add(set->epoll_fd, entry->fd);
+    if (iree_status_is_ok(status)) {
+      status = add_status;
+    } else {
+      iree_status_ignore(add_status);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 iree_status_t iree_wait_any(iree_wait_set_t* set, iree_time_t deadline_ns,
                             iree_wait_handle_t* out_wake_handle) {
-  // TODO(benvanik): epoll_wait
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count == 0) {
+    if (out_wake_handle) {
+      memset(out_wake_handle, 0, sizeof(*out_wake_handle));
+    }
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // We only report a single wake handle and level-triggered epoll will report
+  // any others again on the next wait (rotating through ready handles so none
+  // are starved). Asking for one event keeps the kernel from copying out
+  // events we won't use.
+  struct epoll_event event;
+  int signaled_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_syscall_epoll_wait(set->epoll_fd, &event, 1, deadline_ns,
+                                  &signaled_count));
+
+  if (out_wake_handle) {
+    memset(out_wake_handle, 0, sizeof(*out_wake_handle));
+    bool signaled = false;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_wait_set_resolve_epoll_events(event.events, &signaled));
+    iree_wait_set_entry_t* entry =
+        signaled ? iree_wait_set_find(set, event.data.fd, IREE_HOST_SIZE_MAX)
+                 : NULL;
+    if (entry) {
+      memcpy(out_wake_handle, &entry->handle, sizeof(*out_wake_handle));
+      out_wake_handle->set_internal.index =
+          (iree_host_size_t)(entry - set->entries);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 iree_status_t iree_wait_one(iree_wait_handle_t* handle,
                             iree_time_t deadline_ns) {
-  // TODO(benvanik): just use poll?
+  struct pollfd poll_fds;
+  poll_fds.fd = iree_wait_primitive_get_read_fd(handle);
+  if (poll_fds.fd == -1) return iree_ok_status();
+  poll_fds.events = POLLIN;
+  poll_fds.revents = 0;
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Just check for our single handle/event. Creating an epoll instance for a
+  // single wait would cost more syscalls than it saves.
+  int rv = -1;
+  do {
+    uint32_t timeout_ms = iree_absolute_deadline_to_timeout_ms(deadline_ns);
+    rv = poll(&poll_fds, 1, (int)timeout_ms);
+  } while (rv < 0 && errno == EINTR);
+
+  iree_status_t status = iree_ok_status();
+  if (IREE_UNLIKELY(rv < 0)) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "poll failure %d", errno);
+  } else if (rv == 0) {
+    status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 #endif  // IREE_WAIT_API == IREE_WAIT_API_EPOLL
@@ -796,6 +796,67 @@ TEST(WaitSet, WaitAnyEraseSplit) {
   iree_event_deinitialize(&ev_set);
 }
 
+// Tests that sets supporting growth can hold far more handles than their
+// initial capacity and still route wakes and erases to the right handles.
+TEST(WaitSet, GrowBeyondCapacity) {
+  constexpr int kHandleCount = 128;
+  iree_event_t events[kHandleCount];
+  for (int i = 0; i < kHandleCount; ++i) {
+    IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &events[i]));
+  }
+  iree_wait_set_t* wait_set = NULL;
+  IREE_ASSERT_OK(iree_wait_set_allocate(8, iree_allocator_system(), &wait_set));
+
+  iree_status_t status = iree_ok_status();
+  for (int i = 0; i < kHandleCount && iree_status_is_ok(status); ++i) {
+    status = iree_wait_set_insert(wait_set, events[i]);
+  }
+  if (iree_status_is_resource_exhausted(status)) {
+    // Fixed-capacity implementation.
+    iree_status_free(status);
+    iree_wait_set_free(wait_set);
+    for (int i = 0; i < kHandleCount; ++i) iree_event_deinitialize(&events[i]);
+    GTEST_SKIP() << "wait set does not grow";
+  }
+  IREE_ASSERT_OK(status);
+
+  // Signal a few handles scattered through the set and expect exactly those
+  // to be reported before the set goes quiet.
+  const int signaled_indices[] = {3, 64, 65, 127};
+  for (int index : signaled_indices) iree_event_set(&events[index]);
+  for (size_t i = 0; i < IREE_ARRAYSIZE(signaled_indices); ++i) {
+    iree_wait_handle_t wake_handle;
+    IREE_ASSERT_OK(
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+    bool found = false;
+    for (int index : signaled_indices) {
+      if (memcmp(&events[index].value, &wake_handle.value,
+                 sizeof(wake_handle.value)) == 0) {
+        found = true;
+      }
+    }
+    EXPECT_TRUE(found);
+    iree_wait_set_erase(wait_set, wake_handle);
+  }
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, NULL));
+  EXPECT_FALSE(iree_wait_set_is_empty(wait_set));
+
+  // Signaling a remaining handle after the erases must still wake.
+  iree_event_set(&events[100]);
+  iree_wait_handle_t wake_handle;
+  IREE_ASSERT_OK(
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+  EXPECT_EQ(0, memcmp(&events[100].value, &wake_handle.value,
+                      sizeof(wake_handle.value)));
+
+  iree_wait_set_clear(wait_set);
+  EXPECT_TRUE(iree_wait_set_is_empty(wait_set));
+  iree_wait_set_free(wait_set);
+  for (int i = 0; i < kHandleCount; ++i) iree_event_deinitialize(&events[i]);
+}
+
 // Tests iree_wait_one when polling (deadline_ns = IREE_TIME_INFINITE_PAST).
 TEST(WaitSet, WaitOnePolling) {
   iree_event_t ev_unset, ev_set;
@@ -9,6 +9,7 @@
 #if defined(IREE_PLATFORM_EMSCRIPTEN)
 
 #include <emscripten.h>
+#include <string.h>
 
 #include "iree/base/assert.h"
 #include "iree/base/internal/wait_handle.h"
@@ -89,6 +90,153 @@ static iree_status_t iree_loop_emscripten_run_wait_until(
                            /*promise_handles=*/NULL, loop);
 }
 
+//===----------------------------------------------------------------------===//
+// Grid dispatch
+//===----------------------------------------------------------------------===//
+
+// Heap copy of dispatch parameters kept alive until the loop runs the grid.
+typedef struct iree_loop_emscripten_dispatch_t {
+  iree_allocator_t allocator;
+  iree_loop_dispatch_params_t params;
+} iree_loop_emscripten_dispatch_t;
+
+static iree_status_t iree_loop_emscripten_dispatch_grid(void* user_data,
+                                                        iree_loop_t loop,
+                                                        iree_status_t status) {
+  iree_loop_emscripten_dispatch_t* dispatch =
+      (iree_loop_emscripten_dispatch_t*)user_data;
+  iree_loop_dispatch_params_t params = dispatch->params;
+  iree_allocator_free(dispatch->allocator, dispatch);
+
+  // Workgroups run serially on the loop thread before issuing the completion
+  // callback; parallelism on the web comes from the task executor running on
+  // Web Workers instead. If any workgroup fails we exit early and pass the
+  // failing status back to the completion handler exactly once.
+  for (uint32_t z = 0; iree_status_is_ok(status) &&
+                       z < params.workgroup_count_xyz[2];
+       ++z) {
+    for (uint32_t y = 0; iree_status_is_ok(status) &&
+                         y < params.workgroup_count_xyz[1];
+         ++y) {
+      for (uint32_t x = 0; iree_status_is_ok(status) &&
+                           x < params.workgroup_count_xyz[0];
+           ++x) {
+        status = params.workgroup_fn(params.callback.user_data, loop, x, y, z);
+      }
+    }
+  }
+  return params.callback.fn(params.callback.user_data, loop, status);
+}
+
+static iree_status_t iree_loop_emscripten_run_dispatch(
+    iree_loop_emscripten_t* loop_emscripten,
+    iree_loop_dispatch_params_t* params) {
+  iree_loop_emscripten_dispatch_t* dispatch = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      loop_emscripten->allocator, sizeof(*dispatch), (void**)&dispatch));
+  dispatch->allocator = loop_emscripten->allocator;
+  dispatch->params = *params;
+  iree_loop_t loop = iree_loop_emscripten(loop_emscripten);
+  iree_status_t status = iree_loop_command(
+      loop_emscripten->scope, IREE_LOOP_COMMAND_CALL,
+      iree_loop_emscripten_dispatch_grid, dispatch, /*timeout_ms=*/0,
+      /*promise_handles_count=*/0, /*promise_handles=*/NULL, loop);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(loop_emscripten->allocator, dispatch);
+  }
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Waits
+//===----------------------------------------------------------------------===//
+
+// Interval between queries of wait sources that are not backed by Promises.
+#define IREE_LOOP_EMSCRIPTEN_POLL_INTERVAL_MS 1
+
+// Waits on wait sources that cannot be exported as Promises, such as the
+// semaphores signaled from Web Workers by the task executor. The browser main
+// thread is not allowed to block so we query the sources from timers instead.
+typedef struct iree_loop_emscripten_poll_t {
+  iree_loop_emscripten_t* loop_emscripten;
+  iree_loop_callback_t callback;
+  // Either IREE_LOOP_COMMAND_WAIT_ALL or a wait resolved by any source.
+  iree_loop_command_t command;
+  iree_time_t deadline_ns;
+  iree_host_size_t count;
+  iree_wait_source_t wait_sources[];
+} iree_loop_emscripten_poll_t;
+
+static bool iree_loop_emscripten_is_promise(iree_wait_source_t wait_source) {
+  iree_wait_handle_t* wait_handle_ptr =
+      iree_wait_handle_from_source(&wait_source);
+  return wait_handle_ptr &&
+         wait_handle_ptr->type == IREE_WAIT_PRIMITIVE_TYPE_JAVASCRIPT_PROMISE;
+}
+
+static iree_status_t iree_loop_emscripten_poll_waits(void* user_data,
+                                                     iree_loop_t loop,
+                                                     iree_status_t status) {
+  iree_loop_emscripten_poll_t* poll = (iree_loop_emscripten_poll_t*)user_data;
+  bool resolved = false;
+  if (iree_status_is_ok(status)) {
+    resolved = poll->command == IREE_LOOP_COMMAND_WAIT_ALL;
+    for (iree_host_size_t i = 0; i < poll->count; ++i) {
+      iree_status_code_t wait_status_code = IREE_STATUS_OK;
+      status = iree_wait_source_query(poll->wait_sources[i], &wait_status_code);
+      if (!iree_status_is_ok(status)) break;
+      if (poll->command == IREE_LOOP_COMMAND_WAIT_ALL) {
+        resolved &= wait_status_code == IREE_STATUS_OK;
+      } else {
+        resolved |= wait_status_code == IREE_STATUS_OK;
+      }
+    }
+  }
+  if (iree_status_is_ok(status) && !resolved) {
+    if (poll->deadline_ns <= iree_time_now()) {
+      status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+    } else {
+      // Still waiting: check again on a later tick of the event loop.
+      status = iree_loop_command(
+          poll->loop_emscripten->scope, IREE_LOOP_COMMAND_WAIT_UNTIL,
+          iree_loop_emscripten_poll_waits, poll,
+          IREE_LOOP_EMSCRIPTEN_POLL_INTERVAL_MS, /*promise_handles_count=*/0,
+          /*promise_handles=*/NULL, loop);
+      if (iree_status_is_ok(status)) return status;
+    }
+  }
+  iree_loop_callback_t callback = poll->callback;
+  iree_allocator_free(poll->loop_emscripten->allocator, poll);
+  return callback.fn(callback.user_data, loop, status);
+}
+
+static iree_status_t iree_loop_emscripten_run_poll(
+    iree_loop_emscripten_t* loop_emscripten, iree_loop_command_t command,
+    iree_loop_callback_t callback, iree_time_t deadline_ns,
+    iree_host_size_t count, const iree_wait_source_t* wait_sources) {
+  iree_loop_emscripten_poll_t* poll = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      loop_emscripten->allocator,
+      sizeof(*poll) + count * sizeof(poll->wait_sources[0]), (void**)&poll));
+  poll->loop_emscripten = loop_emscripten;
+  poll->callback = callback;
+  poll->command = command;
+  poll->deadline_ns = deadline_ns;
+  poll->count = count;
+  memcpy(poll->wait_sources, wait_sources, count * sizeof(wait_sources[0]));
+  // The first query happens on the next tick as callbacks must not be issued
+  // re-entrantly.
+  iree_loop_t loop = iree_loop_emscripten(loop_emscripten);
+  iree_status_t status = iree_loop_command(
+      loop_emscripten->scope, IREE_LOOP_COMMAND_CALL,
+      iree_loop_emscripten_poll_waits, poll, /*timeout_ms=*/0,
+      /*promise_handles_count=*/0, /*promise_handles=*/NULL, loop);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(loop_emscripten->allocator, poll);
+  }
+  return status;
+}
+
 static iree_status_t iree_loop_emscripten_get_promise_handle(
     iree_wait_source_t wait_source, int* out_handle) {
   if (iree_wait_source_is_immediate(wait_source)) {
@@ -119,6 +267,11 @@ static iree_status_t iree_loop_emscripten_get_promise_handle(
 static iree_status_t iree_loop_emscripten_run_wait_one(
     iree_loop_emscripten_t* loop_emscripten,
     iree_loop_wait_one_params_t* params) {
+  if (!iree_loop_emscripten_is_promise(params->wait_source)) {
+    return iree_loop_emscripten_run_poll(
+        loop_emscripten, IREE_LOOP_COMMAND_WAIT_ONE, params->callback,
+        params->deadline_ns, 1, &params->wait_source);
+  }
   int promise_handle = 0;
   IREE_RETURN_IF_ERROR(iree_loop_emscripten_get_promise_handle(
       params->wait_source, &promise_handle));
@@ -133,6 +286,14 @@ static iree_status_t iree_loop_emscripten_run_wait_one(
 static iree_status_t iree_loop_emscripten_run_wait_any(
     iree_loop_emscripten_t* loop_emscripten,
     iree_loop_wait_multi_params_t* params) {
+  for (iree_host_size_t i = 0; i < params->count; ++i) {
+    if (!iree_loop_emscripten_is_promise(params->wait_sources[i])) {
+      return iree_loop_emscripten_run_poll(
+          loop_emscripten, IREE_LOOP_COMMAND_WAIT_ANY, params->callback,
+          params->deadline_ns, params->count, params->wait_sources);
+    }
+  }
+
   int* promise_handles = (int*)iree_alloca(sizeof(int) * params->count);
 
   iree_status_t status = iree_ok_status();
@@ -152,13 +313,20 @@ static iree_status_t iree_loop_emscripten_run_wait_any(
                           timeout_ms, params->count, promise_handles, loop);
   }
 
-  iree_allocator_free(loop_emscripten->allocator, promise_handles);
   return status;
 }
 
 static iree_status_t iree_loop_emscripten_run_wait_all(
     iree_loop_emscripten_t* loop_emscripten,
     iree_loop_wait_multi_params_t* params) {
+  for (iree_host_size_t i = 0; i < params->count; ++i) {
+    if (!iree_loop_emscripten_is_promise(params->wait_sources[i])) {
+      return iree_loop_emscripten_run_poll(
+          loop_emscripten, IREE_LOOP_COMMAND_WAIT_ALL, params->callback,
+          params->deadline_ns, params->count, params->wait_sources);
+    }
+  }
+
   int* promise_handles = (int*)iree_alloca(sizeof(int) * params->count);
 
   iree_status_t status = iree_ok_status();
@@ -178,7 +346,6 @@ static iree_status_t iree_loop_emscripten_run_wait_all(
                           timeout_ms, params->count, promise_handles, loop);
   }
 
-  iree_allocator_free(loop_emscripten->allocator, promise_handles);
   return status;
 }
 
@@ -196,8 +363,8 @@ iree_loop_emscripten_ctl(void* self, iree_loop_command_t command,
       return iree_loop_emscripten_run_call(loop_emscripten,
                                            (iree_loop_call_params_t*)params);
     case IREE_LOOP_COMMAND_DISPATCH:
-      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                              "IREE_LOOP_COMMAND_DISPATCH not implemented");
+      return iree_loop_emscripten_run_dispatch(
+          loop_emscripten, (iree_loop_dispatch_params_t*)params);
     case IREE_LOOP_COMMAND_WAIT_UNTIL:
       return iree_loop_emscripten_run_wait_until(
           loop_emscripten, (iree_loop_wait_until_params_t*)params);
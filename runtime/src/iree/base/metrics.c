@@ -0,0 +1,184 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/metrics.h"
+
+#include <inttypes.h>
+
+//===----------------------------------------------------------------------===//
+// Shards
+//===----------------------------------------------------------------------===//
+
+// NOTE: threading support is optional. Without thread-local storage all
+// threads record into the first shard which still works but contends as an
+// unsharded metric would.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+// Single-threaded; a single shard is all that's needed.
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define iree_metric_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define iree_metric_thread_local __declspec(thread)
+#endif  // __STDC_NO_THREADS__
+
+iree_host_size_t iree_metric_thread_shard_index(void) {
+#if defined(iree_metric_thread_local)
+  static iree_atomic_int32_t next_shard_index = IREE_ATOMIC_VAR_INIT(0);
+  static iree_metric_thread_local int32_t thread_shard_index = -1;
+  if (IREE_UNLIKELY(thread_shard_index < 0)) {
+    thread_shard_index = iree_atomic_fetch_add_int32(
+                             &next_shard_index, 1, iree_memory_order_relaxed) &
+                         INT32_MAX;
+  }
+  return (iree_host_size_t)thread_shard_index % IREE_METRIC_SHARD_COUNT;
+#else
+  return 0;
+#endif  // iree_metric_thread_local
+}
+
+//===----------------------------------------------------------------------===//
+// Registry
+//===----------------------------------------------------------------------===//
+
+#if IREE_METRICS_ENABLE
+
+// Head of the singly-linked list of all registered metrics.
+// Metrics are only ever prepended and never removed such that readers can walk
+// the list without synchronizing with registration.
+static iree_atomic_intptr_t iree_metrics_registry_head =
+    IREE_ATOMIC_VAR_INIT(0);
+
+void iree_metric_register(iree_metric_t* metric) {
+  IREE_ASSERT_ARGUMENT(metric);
+  if (iree_atomic_load_int32(&metric->registered, iree_memory_order_acquire)) {
+    return;  // already registered
+  }
+  int32_t expected = 0;
+  if (!iree_atomic_compare_exchange_strong_int32(
+          &metric->registered, &expected, 1, iree_memory_order_acq_rel,
+          iree_memory_order_acquire)) {
+    return;  // lost the race with another thread registering
+  }
+  intptr_t head = iree_atomic_load_intptr(&iree_metrics_registry_head,
+                                          iree_memory_order_acquire);
+  do {
+    metric->next = (iree_metric_t*)head;
+  } while (!iree_atomic_compare_exchange_weak_intptr(
+      &iree_metrics_registry_head, &head, (intptr_t)metric,
+      iree_memory_order_release, iree_memory_order_acquire));
+}
+
+iree_status_t iree_metrics_enumerate(iree_metrics_enumerate_fn_t fn,
+                                     void* user_data) {
+  IREE_ASSERT_ARGUMENT(fn);
+  iree_metric_t* metric = (iree_metric_t*)iree_atomic_load_intptr(
+      &iree_metrics_registry_head, iree_memory_order_acquire);
+  for (; metric != NULL; metric = metric->next) {
+    IREE_RETURN_IF_ERROR(fn(user_data, metric));
+  }
+  return iree_ok_status();
+}
+
+#else
+
+void iree_metric_register(iree_metric_t* metric) {}
+
+iree_status_t iree_metrics_enumerate(iree_metrics_enumerate_fn_t fn,
+                                     void* user_data) {
+  return iree_ok_status();
+}
+
+#endif  // IREE_METRICS_ENABLE
+
+//===----------------------------------------------------------------------===//
+// Prometheus text exposition format
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_metrics_format_prometheus_histogram(
+    iree_metric_histogram_t* histogram, iree_string_builder_t* builder) {
+  const char* name = histogram->base.name;
+
+  // Snapshot the buckets summed across all shards so that the cumulative
+  // counts are self-consistent even if values are recorded while we are
+  // formatting.
+  int64_t buckets[IREE_METRIC_HISTOGRAM_BUCKET_COUNT] = {0};
+  int64_t sum = 0;
+  for (iree_host_size_t j = 0; j < IREE_METRIC_SHARD_COUNT; ++j) {
+    iree_metric_histogram_values_t* values = &histogram->shards[j].values;
+    for (int i = 0; i < IREE_METRIC_HISTOGRAM_BUCKET_COUNT; ++i) {
+      buckets[i] += iree_atomic_load_int64(&values->buckets[i],
+                                           iree_memory_order_relaxed);
+    }
+    sum += iree_atomic_load_int64(&values->sum, iree_memory_order_relaxed);
+  }
+  int last_bucket = 0;
+  for (int i = 0; i < IREE_METRIC_HISTOGRAM_BUCKET_COUNT; ++i) {
+    if (buckets[i]) last_bucket = i;
+  }
+
+  // Buckets above the largest recorded value are omitted for brevity; they'd
+  // all have the same cumulative count as +Inf.
+  int64_t cumulative_count = 0;
+  for (int i = 0; i <= last_bucket; ++i) {
+    cumulative_count += buckets[i];
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%s_bucket{le=\"%" PRIu64 "\"} %" PRId64 "\n", name,
+        (uint64_t)1 << i, cumulative_count));
+  }
+  for (int i = last_bucket + 1; i < IREE_METRIC_HISTOGRAM_BUCKET_COUNT; ++i) {
+    cumulative_count += buckets[i];
+  }
+  return iree_string_builder_append_format(
+      builder,
+      "%s_bucket{le=\"+Inf\"} %" PRId64 "\n%s_sum %" PRId64
+      "\n%s_count %" PRId64 "\n",
+      name, cumulative_count, name, sum, name, cumulative_count);
+}
+
+static iree_status_t iree_metrics_format_prometheus_metric(
+    void* user_data, iree_metric_t* metric) {
+  iree_string_builder_t* builder = (iree_string_builder_t*)user_data;
+  const char* type_name = "untyped";
+  switch (metric->type) {
+    case IREE_METRIC_TYPE_COUNTER:
+      type_name = "counter";
+      break;
+    case IREE_METRIC_TYPE_GAUGE:
+      type_name = "gauge";
+      break;
+    case IREE_METRIC_TYPE_HISTOGRAM:
+      type_name = "histogram";
+      break;
+  }
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "# HELP %s %s\n# TYPE %s %s\n", metric->name,
+      metric->help ? metric->help : "", metric->name, type_name));
+  switch (metric->type) {
+    case IREE_METRIC_TYPE_COUNTER:
+      return iree_string_builder_append_format(
+          builder, "%s %" PRId64 "\n", metric->name,
+          iree_metric_counter_value((iree_metric_counter_t*)metric));
+    case IREE_METRIC_TYPE_GAUGE:
+      return iree_string_builder_append_format(
+          builder, "%s %" PRId64 "\n", metric->name,
+          iree_metric_gauge_value((iree_metric_gauge_t*)metric));
+    case IREE_METRIC_TYPE_HISTOGRAM:
+      return iree_metrics_format_prometheus_histogram(
+          (iree_metric_histogram_t*)metric, builder);
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unknown metric type %d", (int)metric->type);
+  }
+}
+
+iree_status_t iree_metrics_format_prometheus(iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(builder);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_metrics_enumerate(
+      iree_metrics_format_prometheus_metric, builder);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
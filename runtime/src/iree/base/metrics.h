@@ -0,0 +1,292 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Low-overhead always-on runtime metrics.
+//
+// Metrics are process-wide counters, gauges, and histograms statically defined
+// by the runtime components that record them. Unlike tracing (see tracing.h)
+// metrics are intended to be enabled in production builds: recording a value
+// is at most a relaxed atomic add and metrics never allocate or lock. Counters
+// and histograms are sharded per thread so that hot paths recording from many
+// threads at once don't bounce a shared cache line between cores. Hosting
+// applications can periodically scrape all registered metrics with
+// iree_metrics_format_prometheus (or walk them with iree_metrics_enumerate) to
+// get visibility into runtime behavior without rebuilding with Tracy.
+//
+// Usage:
+//  // In the .c file of the component recording the metric:
+//  static IREE_METRIC_COUNTER_DEFINE(my_events, "iree_my_events_total",
+//                                    "Total number of my events.");
+//  // When the component is created (idempotent and thread-safe):
+//  iree_metric_register(&my_events.base);
+//  // When the event occurs:
+//  iree_metric_counter_increment(&my_events);
+//
+// Metrics can be compiled out entirely by defining IREE_METRICS_ENABLE=0. All
+// functions remain available but record and return nothing.
+
+#ifndef IREE_BASE_METRICS_H_
+#define IREE_BASE_METRICS_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Enables recording of runtime metrics.
+#if !defined(IREE_METRICS_ENABLE)
+#define IREE_METRICS_ENABLE 1
+#endif  // !IREE_METRICS_ENABLE
+
+// Number of shards each counter and histogram is split into.
+// Threads are assigned shards round-robin on first use and record into their
+// own shard. Reading a metric sums all of its shards.
+#if !defined(IREE_METRIC_SHARD_COUNT)
+#define IREE_METRIC_SHARD_COUNT 8
+#endif  // !IREE_METRIC_SHARD_COUNT
+
+//===----------------------------------------------------------------------===//
+// iree_metric_t
+//===----------------------------------------------------------------------===//
+
+typedef enum iree_metric_type_e {
+  // Monotonically increasing value (events, bytes, etc).
+  IREE_METRIC_TYPE_COUNTER = 0,
+  // Value that may go up and down (current depth, live count, etc).
+  IREE_METRIC_TYPE_GAUGE = 1,
+  // Distribution of values in power-of-two buckets.
+  IREE_METRIC_TYPE_HISTOGRAM = 2,
+} iree_metric_type_t;
+
+// Common header of all metric types.
+// Metrics must have static storage duration as once registered they remain in
+// the registry for the lifetime of the process.
+typedef struct iree_metric_t {
+  // Next metric in the registry. Only valid once registered.
+  struct iree_metric_t* next;
+  // 1 once the metric has been added to the registry.
+  iree_atomic_int32_t registered;
+  // Type of the metric defining which iree_metric_*_t it is embedded in.
+  iree_metric_type_t type;
+  // Prometheus-compatible metric name matching [a-zA-Z_:][a-zA-Z0-9_:]*.
+  // By convention names are prefixed by the component (`iree_task_`) and
+  // suffixed with the unit (`_bytes`, `_nanoseconds`) and `_total` if a
+  // counter.
+  const char* name;
+  // Human-readable description of the metric.
+  const char* help;
+} iree_metric_t;
+
+// Adds |metric| to the process-wide registry, if it has not already been.
+// Safe to call from multiple threads and cheap enough to call each time the
+// component recording the metric is created.
+void iree_metric_register(iree_metric_t* metric);
+
+// Returns the index of the shard in [0, IREE_METRIC_SHARD_COUNT) the calling
+// thread records metrics into.
+iree_host_size_t iree_metric_thread_shard_index(void);
+
+//===----------------------------------------------------------------------===//
+// iree_metric_counter_t
+//===----------------------------------------------------------------------===//
+
+// One shard of a counter padded to its own cache line.
+typedef union iree_metric_counter_shard_t {
+  iree_atomic_int64_t value;
+  uint8_t padding[iree_hardware_destructive_interference_size];
+} iree_metric_counter_shard_t;
+
+// A monotonically increasing 64-bit counter.
+typedef struct iree_metric_counter_t {
+  iree_metric_t base;
+  iree_metric_counter_shard_t shards[IREE_METRIC_SHARD_COUNT];
+} iree_metric_counter_t;
+
+// Defines a counter named |metric_name| in |variable|.
+#define IREE_METRIC_COUNTER_DEFINE(variable, metric_name, metric_help) \
+  iree_metric_counter_t variable = {                                   \
+      {                                                                \
+          NULL,                                                        \
+          IREE_ATOMIC_VAR_INIT(0),                                     \
+          IREE_METRIC_TYPE_COUNTER,                                    \
+          (metric_name),                                               \
+          (metric_help),                                               \
+      },                                                               \
+  }
+
+// Adds |delta| to |counter|.
+static inline void iree_metric_counter_add(iree_metric_counter_t* counter,
+                                           int64_t delta) {
+#if IREE_METRICS_ENABLE
+  iree_atomic_fetch_add_int64(
+      &counter->shards[iree_metric_thread_shard_index()].value, delta,
+      iree_memory_order_relaxed);
+#endif  // IREE_METRICS_ENABLE
+}
+
+// Adds 1 to |counter|.
+static inline void iree_metric_counter_increment(
+    iree_metric_counter_t* counter) {
+  iree_metric_counter_add(counter, 1);
+}
+
+// Returns the current value of |counter| summed across all shards.
+static inline int64_t iree_metric_counter_value(
+    iree_metric_counter_t* counter) {
+  int64_t value = 0;
+  for (iree_host_size_t i = 0; i < IREE_METRIC_SHARD_COUNT; ++i) {
+    value += iree_atomic_load_int64(&counter->shards[i].value,
+                                    iree_memory_order_relaxed);
+  }
+  return value;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_metric_gauge_t
+//===----------------------------------------------------------------------===//
+
+// A 64-bit value that may increase or decrease.
+// Gauges are not sharded as setting one must replace the value seen by all
+// threads; they should not be recorded on hot paths.
+typedef struct iree_metric_gauge_t {
+  iree_metric_t base;
+  iree_atomic_int64_t value;
+} iree_metric_gauge_t;
+
+// Defines a gauge named |metric_name| in |variable|.
+#define IREE_METRIC_GAUGE_DEFINE(variable, metric_name, metric_help) \
+  iree_metric_gauge_t variable = {                                   \
+      {                                                              \
+          NULL,                                                      \
+          IREE_ATOMIC_VAR_INIT(0),                                   \
+          IREE_METRIC_TYPE_GAUGE,                                    \
+          (metric_name),                                             \
+          (metric_help),                                             \
+      },                                                             \
+      IREE_ATOMIC_VAR_INIT(0),                                       \
+  }
+
+// Adds |delta| (which may be negative) to |gauge|.
+static inline void iree_metric_gauge_add(iree_metric_gauge_t* gauge,
+                                         int64_t delta) {
+#if IREE_METRICS_ENABLE
+  iree_atomic_fetch_add_int64(&gauge->value, delta, iree_memory_order_relaxed);
+#endif  // IREE_METRICS_ENABLE
+}
+
+// Sets |gauge| to |value|.
+static inline void iree_metric_gauge_set(iree_metric_gauge_t* gauge,
+                                         int64_t value) {
+#if IREE_METRICS_ENABLE
+  iree_atomic_store_int64(&gauge->value, value, iree_memory_order_relaxed);
+#endif  // IREE_METRICS_ENABLE
+}
+
+// Returns the current value of |gauge|.
+static inline int64_t iree_metric_gauge_value(iree_metric_gauge_t* gauge) {
+  return iree_atomic_load_int64(&gauge->value, iree_memory_order_relaxed);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_metric_histogram_t
+//===----------------------------------------------------------------------===//
+
+// Total number of buckets in a histogram.
+// Bucket 0 counts values <= 1 and bucket i counts values in (2^(i-1), 2^i].
+#define IREE_METRIC_HISTOGRAM_BUCKET_COUNT 64
+
+// Values recorded into one shard of a histogram.
+typedef struct iree_metric_histogram_values_t {
+  // Sum of all recorded values.
+  iree_atomic_int64_t sum;
+  // Number of values recorded in each bucket.
+  iree_atomic_int64_t buckets[IREE_METRIC_HISTOGRAM_BUCKET_COUNT];
+} iree_metric_histogram_values_t;
+
+// One shard of a histogram padded to its own cache lines.
+typedef union iree_metric_histogram_shard_t {
+  iree_metric_histogram_values_t values;
+  uint8_t padding[((sizeof(iree_metric_histogram_values_t) +
+                    iree_hardware_destructive_interference_size - 1) /
+                   iree_hardware_destructive_interference_size) *
+                  iree_hardware_destructive_interference_size];
+} iree_metric_histogram_shard_t;
+
+// A distribution of unsigned values in power-of-two buckets.
+// Power-of-two buckets cover the full range of durations (in nanoseconds) and
+// sizes (in bytes) we care about with fixed storage and let recording compute
+// the bucket with a single count-leading-zeros.
+typedef struct iree_metric_histogram_t {
+  iree_metric_t base;
+  iree_metric_histogram_shard_t shards[IREE_METRIC_SHARD_COUNT];
+} iree_metric_histogram_t;
+
+// Defines a histogram named |metric_name| in |variable|.
+#define IREE_METRIC_HISTOGRAM_DEFINE(variable, metric_name, metric_help) \
+  iree_metric_histogram_t variable = {                                   \
+      {                                                                  \
+          NULL,                                                          \
+          IREE_ATOMIC_VAR_INIT(0),                                       \
+          IREE_METRIC_TYPE_HISTOGRAM,                                    \
+          (metric_name),                                                 \
+          (metric_help),                                                 \
+      },                                                                 \
+  }
+
+// Returns the index of the bucket |value| is recorded in.
+static inline int iree_metric_histogram_bucket_index(uint64_t value) {
+  if (value <= 1) return 0;
+  int index = 64 - iree_math_count_leading_zeros_u64(value - 1);
+  return index < IREE_METRIC_HISTOGRAM_BUCKET_COUNT
+             ? index
+             : IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1;
+}
+
+// Records |value| in |histogram|.
+static inline void iree_metric_histogram_record(
+    iree_metric_histogram_t* histogram, uint64_t value) {
+#if IREE_METRICS_ENABLE
+  iree_metric_histogram_values_t* values =
+      &histogram->shards[iree_metric_thread_shard_index()].values;
+  iree_atomic_fetch_add_int64(
+      &values->buckets[iree_metric_histogram_bucket_index(value)], 1,
+      iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&values->sum, (int64_t)value,
+                              iree_memory_order_relaxed);
+#endif  // IREE_METRICS_ENABLE
+}
+
+//===----------------------------------------------------------------------===//
+// Registry
+//===----------------------------------------------------------------------===//
+
+// Called once for each registered |metric|.
+// Returning a failure stops enumeration and the status is returned to the
+// caller of iree_metrics_enumerate.
+typedef iree_status_t (*iree_metrics_enumerate_fn_t)(void* user_data,
+                                                     iree_metric_t* metric);
+
+// Calls |fn| for each registered metric.
+// Metrics registered concurrently with the enumeration may not be visited.
+// Values are read with relaxed ordering and metrics recorded concurrently with
+// enumeration may not be consistent with each other.
+iree_status_t iree_metrics_enumerate(iree_metrics_enumerate_fn_t fn,
+                                     void* user_data);
+
+// Appends all registered metrics to |builder| in the Prometheus text
+// exposition format (version 0.0.4).
+iree_status_t iree_metrics_format_prometheus(iree_string_builder_t* builder);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_METRICS_H_
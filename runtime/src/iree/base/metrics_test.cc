@@ -0,0 +1,161 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/metrics.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using ::testing::HasSubstr;
+
+static IREE_METRIC_COUNTER_DEFINE(test_counter, "iree_test_events_total",
+                                  "Test events.");
+static IREE_METRIC_GAUGE_DEFINE(test_gauge, "iree_test_depth", "Test depth.");
+static IREE_METRIC_HISTOGRAM_DEFINE(test_histogram, "iree_test_size_bytes",
+                                    "Test sizes.");
+
+std::string FormatPrometheus() {
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(iree_allocator_system(), &builder);
+  IREE_CHECK_OK(iree_metrics_format_prometheus(&builder));
+  std::string result(iree_string_builder_buffer(&builder),
+                     iree_string_builder_size(&builder));
+  iree_string_builder_deinitialize(&builder);
+  return result;
+}
+
+TEST(MetricsTest, HistogramBucketIndex) {
+  EXPECT_EQ(iree_metric_histogram_bucket_index(0), 0);
+  EXPECT_EQ(iree_metric_histogram_bucket_index(1), 0);
+  EXPECT_EQ(iree_metric_histogram_bucket_index(2), 1);
+  EXPECT_EQ(iree_metric_histogram_bucket_index(3), 2);
+  EXPECT_EQ(iree_metric_histogram_bucket_index(4), 2);
+  EXPECT_EQ(iree_metric_histogram_bucket_index(5), 3);
+  EXPECT_EQ(iree_metric_histogram_bucket_index(1024), 10);
+  EXPECT_EQ(iree_metric_histogram_bucket_index(UINT64_MAX),
+            IREE_METRIC_HISTOGRAM_BUCKET_COUNT - 1);
+}
+
+TEST(MetricsTest, RegisterIsIdempotent) {
+  iree_metric_register(&test_counter.base);
+  iree_metric_register(&test_counter.base);
+  int count = 0;
+  IREE_ASSERT_OK(iree_metrics_enumerate(
+      +[](void* user_data, iree_metric_t* metric) {
+        if (metric == &test_counter.base) ++*(int*)user_data;
+        return iree_ok_status();
+      },
+      &count));
+  EXPECT_EQ(count, 1);
+}
+
+TEST(MetricsTest, Counter) {
+  iree_metric_register(&test_counter.base);
+  int64_t initial_value = iree_metric_counter_value(&test_counter);
+  iree_metric_counter_increment(&test_counter);
+  iree_metric_counter_add(&test_counter, 10);
+  EXPECT_EQ(iree_metric_counter_value(&test_counter), initial_value + 11);
+  std::string text = FormatPrometheus();
+  EXPECT_THAT(text, HasSubstr("# TYPE iree_test_events_total counter\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_events_total " +
+                              std::to_string(initial_value + 11) + "\n"));
+}
+
+TEST(MetricsTest, Gauge) {
+  iree_metric_register(&test_gauge.base);
+  iree_metric_gauge_set(&test_gauge, 5);
+  iree_metric_gauge_add(&test_gauge, -2);
+  EXPECT_EQ(iree_metric_gauge_value(&test_gauge), 3);
+  std::string text = FormatPrometheus();
+  EXPECT_THAT(text, HasSubstr("# HELP iree_test_depth Test depth.\n"));
+  EXPECT_THAT(text, HasSubstr("# TYPE iree_test_depth gauge\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_depth 3\n"));
+}
+
+TEST(MetricsTest, Histogram) {
+  iree_metric_register(&test_histogram.base);
+  iree_metric_histogram_record(&test_histogram, 1);
+  iree_metric_histogram_record(&test_histogram, 3);
+  iree_metric_histogram_record(&test_histogram, 4);
+  iree_metric_histogram_record(&test_histogram, 100);
+  std::string text = FormatPrometheus();
+  EXPECT_THAT(text, HasSubstr("# TYPE iree_test_size_bytes histogram\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_size_bytes_bucket{le=\"1\"} 1\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_size_bytes_bucket{le=\"2\"} 1\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_size_bytes_bucket{le=\"4\"} 3\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_size_bytes_bucket{le=\"128\"} 4\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_size_bytes_bucket{le=\"+Inf\"} 4\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_size_bytes_sum 108\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_size_bytes_count 4\n"));
+  EXPECT_THAT(text, ::testing::Not(HasSubstr("{le=\"256\"}")));
+}
+
+TEST(MetricsTest, ThreadShardIndex) {
+  iree_host_size_t shard_index = iree_metric_thread_shard_index();
+  EXPECT_LT(shard_index, IREE_METRIC_SHARD_COUNT);
+  EXPECT_EQ(iree_metric_thread_shard_index(), shard_index);
+}
+
+// Tests that values recorded from more threads than there are shards are all
+// summed when read.
+TEST(MetricsTest, ConcurrentIncrements) {
+  static IREE_METRIC_COUNTER_DEFINE(concurrent_counter,
+                                    "iree_test_concurrent_total",
+                                    "Concurrent test events.");
+  static constexpr int kThreadCount = IREE_METRIC_SHARD_COUNT * 2;
+  static constexpr int kIncrementCount = 10000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([]() {
+      iree_metric_register(&concurrent_counter.base);
+      for (int j = 0; j < kIncrementCount; ++j) {
+        iree_metric_counter_increment(&concurrent_counter);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  EXPECT_EQ(iree_metric_counter_value(&concurrent_counter),
+            kThreadCount * kIncrementCount);
+  EXPECT_THAT(FormatPrometheus(),
+              HasSubstr("iree_test_concurrent_total " +
+                        std::to_string(kThreadCount * kIncrementCount) + "\n"));
+}
+
+TEST(MetricsTest, ConcurrentHistogram) {
+  static IREE_METRIC_HISTOGRAM_DEFINE(concurrent_histogram,
+                                      "iree_test_concurrent_bytes",
+                                      "Concurrent test sizes.");
+  static constexpr int kThreadCount = IREE_METRIC_SHARD_COUNT * 2;
+  static constexpr int kRecordCount = 1000;
+  iree_metric_register(&concurrent_histogram.base);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([]() {
+      for (int j = 0; j < kRecordCount; ++j) {
+        iree_metric_histogram_record(&concurrent_histogram, 4);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  std::string total = std::to_string(kThreadCount * kRecordCount);
+  std::string text = FormatPrometheus();
+  EXPECT_THAT(text, HasSubstr("iree_test_concurrent_bytes_bucket{le=\"4\"} " +
+                              total + "\n"));
+  EXPECT_THAT(text, HasSubstr("iree_test_concurrent_bytes_sum " +
+                              std::to_string(kThreadCount * kRecordCount * 4) +
+                              "\n"));
+  EXPECT_THAT(text,
+              HasSubstr("iree_test_concurrent_bytes_count " + total + "\n"));
+}
+
+}  // namespace
@@ -19,6 +19,7 @@
 #define IREE_UK_BUILD_ARM_64_BF16
 #define IREE_UK_BUILD_ARM_64_DOTPROD
 #define IREE_UK_BUILD_ARM_64_I8MM
+#define IREE_UK_BUILD_ARM_64_SVE
 #else
 // Compiling with the system toolchain. Include the configured header.
 #include "iree/builtins/ukernel/arch/arm_64/config_arm_64.h"
@@ -52,6 +53,10 @@ static inline bool iree_uk_cpu_arm_64_i8mm(const iree_uk_uint64_t* cpu_data) {
   return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_ARM_64_I8MM);
 }
 
+static inline bool iree_uk_cpu_arm_64_sve(const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_ARM_64_SVE);
+}
+
 static inline int8x16x2_t iree_uk_neon_load_8x4xi8_strided(
     const iree_uk_int8_t* src, iree_uk_index_t stride) {
   int32x4_t v0_i32 = vdupq_n_s32(0);
@@ -180,6 +185,29 @@ iree_uk_neon_copy_8x8xi8_tiled_1x4_transpose_strided_to_strided(
   vst1q_s8(out_ptr + 16 + 1 * out_stride, vreinterpretq_s8_s32(c1.val[1]));
 }
 
+// Prefetches each of the 8 rows starting at `in_ptr`, 256 bytes (4 cache lines)
+// ahead. Used by pack tile functions that stream through many rows at once,
+// which hardware prefetchers may not track well.
+static inline void iree_uk_neon_prefetch_8_rows_ahead(
+    const iree_uk_int8_t* in_ptr, iree_uk_index_t in_stride) {
+  for (int i = 0; i < 8; ++i) {
+    IREE_UK_PREFETCH_RO(in_ptr + i * in_stride + 256,
+                        IREE_UK_PREFETCH_LOCALITY_L1);
+  }
+}
+
+// Stores 16 bytes with a non-temporal hint (STNP) where the compiler lets us
+// express it, falling back to a regular store otherwise. Unlike on x86, there
+// is no alignment requirement and no fence is needed for correctness.
+static inline void iree_uk_neon_store_nontemporal_16xi8(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr, int8x16_t val) {
+#if IREE_UK_HAVE_BUILTIN(__builtin_nontemporal_store)
+  __builtin_nontemporal_store(val, (int8x16_t*)out_ptr);
+#else
+  vst1q_s8(out_ptr, val);
+#endif
+}
+
 static inline void iree_uk_neon_copy_8x32xi8_strided_to_strided(
     iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
     const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
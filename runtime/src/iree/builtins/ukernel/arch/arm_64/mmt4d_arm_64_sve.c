@@ -0,0 +1,119 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <arm_sve.h>
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/mmt4d_arm_64_internal.h"
+
+// Vector-length agnostic f32 tile: each row of 8 accumulators is covered by two
+// predicated vectors. With 128-bit vectors each one holds 4 columns. With
+// 256-bit or wider vectors the first one holds all 8 columns and the second one
+// has an all-false predicate, making its loads, stores and FMAs no-ops.
+//
+// LHS values are loaded with LD1RQ, replicating up to 4 values into every
+// 128-bit segment, so that the indexed FMLA picks the same LHS value for every
+// column regardless of the vector length.
+
+#define IREE_UK_SVE_F32_ACC_LOAD(i)                    \
+  if (M0 > i) {                                        \
+    acc##i##_0 = svld1_f32(pg0, out_ptr + 8 * i);      \
+    acc##i##_1 = svld1_f32(pg1, out_ptr + 8 * i + vl); \
+  }
+
+#define IREE_UK_SVE_F32_ACC_STORE(i)                  \
+  if (M0 > i) {                                       \
+    svst1_f32(pg0, out_ptr + 8 * i, acc##i##_0);      \
+    svst1_f32(pg1, out_ptr + 8 * i + vl, acc##i##_1); \
+  }
+
+#define IREE_UK_SVE_F32_ACC_FMA(i, lhs, lane)                  \
+  if (M0 > i) {                                                \
+    acc##i##_0 = svmla_lane_f32(acc##i##_0, rhs_0, lhs, lane); \
+    acc##i##_1 = svmla_lane_f32(acc##i##_1, rhs_1, lhs, lane); \
+  }
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_arm_64_sve(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const int vl = (int)svcntw();
+  const svbool_t pg0 = svwhilelt_b32_s32(0, 8);
+  const svbool_t pg1 = svwhilelt_b32_s32(vl, 8);
+  const svbool_t pg_lhs = svwhilelt_b32_s32(0, M0);
+
+  svfloat32_t acc0_0 = svdup_n_f32(0), acc0_1 = svdup_n_f32(0);
+  svfloat32_t acc1_0 = svdup_n_f32(0), acc1_1 = svdup_n_f32(0);
+  svfloat32_t acc2_0 = svdup_n_f32(0), acc2_1 = svdup_n_f32(0);
+  svfloat32_t acc3_0 = svdup_n_f32(0), acc3_1 = svdup_n_f32(0);
+  svfloat32_t acc4_0 = svdup_n_f32(0), acc4_1 = svdup_n_f32(0);
+  svfloat32_t acc5_0 = svdup_n_f32(0), acc5_1 = svdup_n_f32(0);
+  svfloat32_t acc6_0 = svdup_n_f32(0), acc6_1 = svdup_n_f32(0);
+  svfloat32_t acc7_0 = svdup_n_f32(0), acc7_1 = svdup_n_f32(0);
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_SVE_F32_ACC_LOAD(0);
+    IREE_UK_SVE_F32_ACC_LOAD(1);
+    IREE_UK_SVE_F32_ACC_LOAD(2);
+    IREE_UK_SVE_F32_ACC_LOAD(3);
+    IREE_UK_SVE_F32_ACC_LOAD(4);
+    IREE_UK_SVE_F32_ACC_LOAD(5);
+    IREE_UK_SVE_F32_ACC_LOAD(6);
+    IREE_UK_SVE_F32_ACC_LOAD(7);
+  }
+
+  for (int k = 0; k < params->K; ++k) {
+    svfloat32_t rhs_0 = svld1_f32(pg0, rhs_ptr);
+    svfloat32_t rhs_1 = svld1_f32(pg1, rhs_ptr + vl);
+    rhs_ptr += 8;
+
+    if (M0 == 1) {
+      float lhs = *lhs_ptr++;
+      acc0_0 = svmla_n_f32_x(pg0, acc0_0, rhs_0, lhs);
+      acc0_1 = svmla_n_f32_x(pg1, acc0_1, rhs_1, lhs);
+    } else {
+      svfloat32_t lhs_0 = svld1rq_f32(pg_lhs, lhs_ptr);
+      IREE_UK_SVE_F32_ACC_FMA(0, lhs_0, 0);
+      IREE_UK_SVE_F32_ACC_FMA(1, lhs_0, 1);
+      IREE_UK_SVE_F32_ACC_FMA(2, lhs_0, 2);
+      IREE_UK_SVE_F32_ACC_FMA(3, lhs_0, 3);
+      if (M0 == 8) {
+        svfloat32_t lhs_1 = svld1rq_f32(svptrue_b32(), lhs_ptr + 4);
+        IREE_UK_SVE_F32_ACC_FMA(4, lhs_1, 0);
+        IREE_UK_SVE_F32_ACC_FMA(5, lhs_1, 1);
+        IREE_UK_SVE_F32_ACC_FMA(6, lhs_1, 2);
+        IREE_UK_SVE_F32_ACC_FMA(7, lhs_1, 3);
+      }
+      lhs_ptr += M0;
+    }
+  }
+
+  IREE_UK_SVE_F32_ACC_STORE(0);
+  IREE_UK_SVE_F32_ACC_STORE(1);
+  IREE_UK_SVE_F32_ACC_STORE(2);
+  IREE_UK_SVE_F32_ACC_STORE(3);
+  IREE_UK_SVE_F32_ACC_STORE(4);
+  IREE_UK_SVE_F32_ACC_STORE(5);
+  IREE_UK_SVE_F32_ACC_STORE(6);
+  IREE_UK_SVE_F32_ACC_STORE(7);
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_arm_64_sve,
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_arm_64_sve, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_arm_64_sve,
+    iree_uk_mmt4d_tile_f32f32f32_2x8x1_arm_64_sve, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_arm_64_sve,
+    iree_uk_mmt4d_tile_f32f32f32_4x8x1_arm_64_sve, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_arm_64_sve,
+    iree_uk_mmt4d_tile_f32f32f32_8x8x1_arm_64_sve, 8)
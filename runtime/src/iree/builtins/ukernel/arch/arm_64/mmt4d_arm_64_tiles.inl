@@ -11,6 +11,10 @@ IREE_UK_MMT4D_TILE(arm_64, f32, f32, f32, 1, 8, 1, )
 IREE_UK_MMT4D_TILE(arm_64, f32, f32, f32, 2, 8, 1, )
 IREE_UK_MMT4D_TILE(arm_64, f32, f32, f32, 4, 8, 1, )
 IREE_UK_MMT4D_TILE(arm_64, f32, f32, f32, 8, 8, 1, )
+IREE_UK_MMT4D_TILE(arm_64, f32, f32, f32, 1, 8, 1, _sve)
+IREE_UK_MMT4D_TILE(arm_64, f32, f32, f32, 2, 8, 1, _sve)
+IREE_UK_MMT4D_TILE(arm_64, f32, f32, f32, 4, 8, 1, _sve)
+IREE_UK_MMT4D_TILE(arm_64, f32, f32, f32, 8, 8, 1, _sve)
 IREE_UK_MMT4D_TILE(arm_64, f16, f16, f32, 1, 8, 1, )
 IREE_UK_MMT4D_TILE(arm_64, f16, f16, f32, 2, 8, 1, )
 IREE_UK_MMT4D_TILE(arm_64, f16, f16, f32, 4, 8, 1, )
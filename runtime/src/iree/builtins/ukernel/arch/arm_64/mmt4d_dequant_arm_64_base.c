@@ -0,0 +1,116 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/mmt4d_dequant_arm_64_internal.h"
+
+// Loads 8 f16 or bf16 values and converts them to f32, as 2 vectors of 4.
+static inline void iree_uk_mmt4d_dequant_load_8x16bit_as_f32(
+    const iree_uk_uint16_t* ptr, bool bf16, float32x4_t* out) {
+  uint16x8_t v = vld1q_u16(ptr);
+  if (bf16) {
+    out[0] = vreinterpretq_f32_u32(vshll_n_u16(vget_low_u16(v), 16));
+    out[1] = vreinterpretq_f32_u32(vshll_high_n_u16(v, 16));
+  } else {
+    out[0] = vcvt_f32_f16(vreinterpret_f16_u16(vget_low_u16(v)));
+    out[1] = vcvt_high_f32_f16(vreinterpretq_f16_u16(v));
+  }
+}
+
+// The RHS tile for one K step is N0=8 bytes, each holding the K0=2 u4 values
+// of one column, low nibble first. The dequantized RHS values
+// (rhs - zero_point) * scale are computed once per K step and shared by all
+// M0 rows. The scale and zero point vectors are reloaded once per group.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_to_8x8x2_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const void* IREE_UK_RESTRICT scales_panel,
+    const void* IREE_UK_RESTRICT zero_points_panel,
+    const iree_uk_mmt4d_dequant_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT scales_ptr = scales_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT zero_points_ptr =
+      zero_points_panel;
+  const bool bf16 =
+      iree_uk_mmt4d_dequant_scale_type(params->flags) == IREE_UK_TYPE_BFLOAT_16;
+  const int k_per_group = params->group_size / 2;
+  float32x4_t acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = vld1q_f32(out_ptr + 4 * i);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) { acc[i] = vdupq_n_f32(0); }
+  }
+  for (int k = 0; k < params->K; k += k_per_group) {
+    float32x4_t scale[2];
+    float32x4_t zero_point[2];
+    iree_uk_mmt4d_dequant_load_8x16bit_as_f32(scales_ptr, bf16, scale);
+    iree_uk_mmt4d_dequant_load_8x16bit_as_f32(zero_points_ptr, bf16,
+                                              zero_point);
+    scales_ptr += 8;
+    zero_points_ptr += 8;
+    for (int kg = 0; kg < k_per_group; ++kg) {
+      uint8x8_t rhs_bytes = vld1_u8(rhs_ptr);
+      rhs_ptr += 8;
+      // rhs_u16[k0] holds the 8 u4 values for K0-index k0.
+      uint16x8_t rhs_u16[2] = {
+          vmovl_u8(vand_u8(rhs_bytes, vdup_n_u8(0x0F))),
+          vmovl_u8(vshr_n_u8(rhs_bytes, 4)),
+      };
+      // rhs[2 * k0 + c] holds columns 4 * c .. 4 * c + 3 for K0-index k0.
+      float32x4_t rhs[4];
+      IREE_UK_UNROLL for (int k0 = 0; k0 < 2; ++k0) {
+        rhs[2 * k0 + 0] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(rhs_u16[k0])));
+        rhs[2 * k0 + 1] = vcvtq_f32_u32(vmovl_high_u16(rhs_u16[k0]));
+      }
+      IREE_UK_UNROLL for (int i = 0; i < 4; ++i) {
+        rhs[i] = vmulq_f32(vsubq_f32(rhs[i], zero_point[i % 2]), scale[i % 2]);
+      }
+      if (M0 == 1) {
+        float32x2_t lhs = vld1_f32(lhs_ptr);
+        IREE_UK_UNROLL for (int c = 0; c < 2; ++c) {
+          acc[c] = vfmaq_lane_f32(acc[c], rhs[0 + c], lhs, 0);
+          acc[c] = vfmaq_lane_f32(acc[c], rhs[2 + c], lhs, 1);
+        }
+      } else {
+        // Each LHS vector holds the K0=2 values of 2 consecutive rows.
+        IREE_UK_UNROLL for (int i = 0; i < M0 / 2; ++i) {
+          float32x4_t lhs = vld1q_f32(lhs_ptr + 4 * i);
+          IREE_UK_UNROLL for (int c = 0; c < 2; ++c) {
+            float32x4_t* acc_0 = &acc[2 * (2 * i + 0) + c];
+            float32x4_t* acc_1 = &acc[2 * (2 * i + 1) + c];
+            *acc_0 = vfmaq_laneq_f32(*acc_0, rhs[0 + c], lhs, 0);
+            *acc_0 = vfmaq_laneq_f32(*acc_0, rhs[2 + c], lhs, 1);
+            *acc_1 = vfmaq_laneq_f32(*acc_1, rhs[0 + c], lhs, 2);
+            *acc_1 = vfmaq_laneq_f32(*acc_1, rhs[2 + c], lhs, 3);
+          }
+        }
+      }
+      lhs_ptr += 2 * M0;
+    }
+  }
+  IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+    vst1q_f32(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_arm_64, 1)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_2x8x2_arm_64, 2)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_4x8x2_arm_64, 4)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_8x8x2_arm_64, 8)
@@ -0,0 +1,27 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/mmt4d_dequant_arm_64_internal.h"
+
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  // All current types share the f32 LHS, u4 RHS and f32 output, and only
+  // differ in the scales type, which the tile functions handle at runtime.
+  if (params->N0 != 8 || params->K0 != 2) return 0;
+  switch (params->M0) {
+    case 1:
+      return iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_arm_64;
+    case 2:
+      return iree_uk_mmt4d_dequant_tile_f32u4f32_2x8x2_arm_64;
+    case 4:
+      return iree_uk_mmt4d_dequant_tile_f32u4f32_4x8x2_arm_64;
+    case 8:
+      return iree_uk_mmt4d_dequant_tile_f32u4f32_8x8x2_arm_64;
+    default:
+      return 0;
+  }
+}
@@ -193,9 +193,40 @@ void iree_uk_pack_tile_8x8_x32_arm_64_direct(
   const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
   iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
   for (; outer_size1 > 0; --outer_size1) {
+    // Each iteration consumes half a cache line of each source row, so only
+    // prefetch every other iteration.
+    if (outer_size1 & 1) {
+      iree_uk_neon_prefetch_8_rows_ahead(in_ptr, 4 * in_stride0);
+    }
     iree_uk_neon_copy_8x32xi8_strided_to_strided(out_ptr, in_ptr, 32,
                                                  4 * in_stride0);
     out_ptr += 4 * out_stride1;
     in_ptr += 32;
   }
 }
+
+void iree_uk_pack_tile_8x8_x32_arm_64_direct_nontemporal(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    if (outer_size1 & 1) {
+      iree_uk_neon_prefetch_8_rows_ahead(in_ptr, 4 * in_stride0);
+    }
+    for (int i = 0; i < 8; ++i) {
+      const iree_uk_int8_t* in_row = in_ptr + i * 4 * in_stride0;
+      iree_uk_int8_t* out_row = out_ptr + i * 32;
+      iree_uk_neon_store_nontemporal_16xi8(out_row, vld1q_s8(in_row));
+      iree_uk_neon_store_nontemporal_16xi8(out_row + 16, vld1q_s8(in_row + 16));
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 32;
+  }
+}
@@ -17,7 +17,11 @@ iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
   bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
   if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 8) {
     // Currently only used for accumulators, which are never transposed.
-    return transpose ? 0 : iree_uk_pack_tile_8x8_x32_arm_64_direct;
+    if (transpose) return 0;
+    if (params->flags & IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES) {
+      return iree_uk_pack_tile_8x8_x32_arm_64_direct_nontemporal;
+    }
+    return iree_uk_pack_tile_8x8_x32_arm_64_direct;
   } else if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 1) {
     return transpose ? iree_uk_pack_tile_8x1_x32_arm_64_transpose
                      : iree_uk_pack_tile_8x1_x32_arm_64_direct;
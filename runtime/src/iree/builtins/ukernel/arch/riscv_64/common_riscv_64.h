@@ -0,0 +1,51 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_COMMON_RISCV_64_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_COMMON_RISCV_64_H_
+
+#include "iree/builtins/ukernel/common.h"
+#include "iree/schemas/cpu_data.h"
+
+#if defined(IREE_DEVICE_STANDALONE)
+// Standalone builds (e.g. bitcode) use our own Clang, supporting everything.
+#define IREE_UK_BUILD_RISCV_64_RVV
+#else  // IREE_DEVICE_STANDALONE
+// Compiling with the system toolchain. Include the configured header.
+#include "iree/builtins/ukernel/arch/riscv_64/config_riscv_64.h"
+#endif  // IREE_DEVICE_STANDALONE
+
+static inline bool iree_uk_cpu_riscv_64_rvv(const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_RISCV_64_RVV);
+}
+
+#if defined(__riscv_vector)
+
+#include <riscv_vector.h>
+
+// The V extension guarantees VLEN >= 128, so a LMUL=2 register group holds at
+// least 8 32-bit elements and a LMUL=1/2 register holds at least 8 bytes. All
+// the tiles in this directory have an 8-wide dimension and rely on that: they
+// always request vl=8 and never need to handle vl < 8. On wider
+// implementations, the remaining lanes are simply left unused.
+#define IREE_UK_RVV_VL8 8
+
+// Copies 8 rows of 8 32-bit elements from a strided source to a strided
+// destination. Strides are in elements.
+static inline void iree_uk_rvv_copy_8x8xi32_strided_to_strided(
+    iree_uk_int32_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  IREE_UK_UNROLL for (int i = 0; i < 8; ++i) {
+    vint32m2_t row = __riscv_vle32_v_i32m2(in_ptr + i * in_stride,
+                                           IREE_UK_RVV_VL8);
+    __riscv_vse32_v_i32m2(out_ptr + i * out_stride, row, IREE_UK_RVV_VL8);
+  }
+}
+
+#endif  // defined(__riscv_vector)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_COMMON_RISCV_64_H_
@@ -0,0 +1,115 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/common_riscv_64.h"
+#include "iree/builtins/ukernel/arch/riscv_64/mmt4d_riscv_64_internal.h"
+
+// Each row of the 8-wide accumulator tile is one LMUL=2 register group, see
+// IREE_UK_RVV_VL8. An 8x8 tile thus takes 16 of the 32 vector registers,
+// leaving room for the RHS row and for the widened RHS in the s8 case.
+//
+// RVV types are sizeless and can't be array elements, so accumulators are
+// individual variables and per-row code is stamped out by these macros.
+
+#define IREE_UK_RVV_ACC_DECL(type, zero)                                \
+  type acc0 = zero, acc1 = zero, acc2 = zero, acc3 = zero, acc4 = zero, \
+       acc5 = zero, acc6 = zero, acc7 = zero;
+
+#define IREE_UK_RVV_FOR_EACH_ROW(X) X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7)
+
+#define IREE_UK_RVV_F32_ACC_LOAD(i) \
+  if (M0 > i) acc##i = __riscv_vle32_v_f32m2(out_ptr + 8 * i, vl);
+
+#define IREE_UK_RVV_F32_ACC_STORE(i) \
+  if (M0 > i) __riscv_vse32_v_f32m2(out_ptr + 8 * i, acc##i, vl);
+
+#define IREE_UK_RVV_F32_ACC_FMA(i) \
+  if (M0 > i) acc##i = __riscv_vfmacc_vf_f32m2(acc##i, lhs_ptr[i], rhs, vl);
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_riscv_64_rvv(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const size_t vl = IREE_UK_RVV_VL8;
+  IREE_UK_RVV_ACC_DECL(vfloat32m2_t, __riscv_vfmv_v_f_f32m2(0.f, vl))
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_F32_ACC_LOAD)
+  }
+  for (int k = 0; k < params->K; ++k) {
+    vfloat32m2_t rhs = __riscv_vle32_v_f32m2(rhs_ptr, vl);
+    rhs_ptr += 8;
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_F32_ACC_FMA)
+    lhs_ptr += M0;
+  }
+  IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_F32_ACC_STORE)
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_riscv_64_rvv,
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_riscv_64_rvv, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_riscv_64_rvv,
+    iree_uk_mmt4d_tile_f32f32f32_2x8x1_riscv_64_rvv, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_riscv_64_rvv,
+    iree_uk_mmt4d_tile_f32f32f32_4x8x1_riscv_64_rvv, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_riscv_64_rvv,
+    iree_uk_mmt4d_tile_f32f32f32_8x8x1_riscv_64_rvv, 8)
+
+#define IREE_UK_RVV_S32_ACC_LOAD(i) \
+  if (M0 > i) acc##i = __riscv_vle32_v_i32m2(out_ptr + 8 * i, vl);
+
+#define IREE_UK_RVV_S32_ACC_STORE(i) \
+  if (M0 > i) __riscv_vse32_v_i32m2(out_ptr + 8 * i, acc##i, vl);
+
+// Widening multiply-accumulate of the sign-extended RHS row (16-bit) by a
+// scalar LHS value into the 32-bit accumulators. The s8 x s8 products fit in
+// 16 bits, so this is exact.
+#define IREE_UK_RVV_S32_ACC_WMACC(i) \
+  if (M0 > i) acc##i = __riscv_vwmacc_vx_i32m2(acc##i, lhs_ptr[i], rhs, vl);
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_riscv_64_rvv(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const size_t vl = IREE_UK_RVV_VL8;
+  IREE_UK_RVV_ACC_DECL(vint32m2_t, __riscv_vmv_v_x_i32m2(0, vl))
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_S32_ACC_LOAD)
+  }
+  for (int k = 0; k < params->K; ++k) {
+    vint16m1_t rhs =
+        __riscv_vsext_vf2_i16m1(__riscv_vle8_v_i8mf2(rhs_ptr, vl), vl);
+    rhs_ptr += 8;
+    IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_S32_ACC_WMACC)
+    lhs_ptr += M0;
+  }
+  IREE_UK_RVV_FOR_EACH_ROW(IREE_UK_RVV_S32_ACC_STORE)
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_riscv_64_rvv,
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_riscv_64_rvv, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_riscv_64_rvv,
+    iree_uk_mmt4d_tile_s8s8s32_2x8x1_riscv_64_rvv, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_riscv_64_rvv,
+    iree_uk_mmt4d_tile_s8s8s32_4x8x1_riscv_64_rvv, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_riscv_64_rvv,
+    iree_uk_mmt4d_tile_s8s8s32_8x8x1_riscv_64_rvv, 8)
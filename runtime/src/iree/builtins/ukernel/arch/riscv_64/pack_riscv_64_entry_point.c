@@ -0,0 +1,32 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/common_riscv_64.h"
+#include "iree/builtins/ukernel/arch/riscv_64/pack_riscv_64_internal.h"
+
+iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
+    const iree_uk_pack_params_t* params) {
+#if defined(IREE_UK_BUILD_RISCV_64_RVV)
+  if (!iree_uk_cpu_riscv_64_rvv(params->cpu_data)) return 0;
+  // At the moment, as sum-reductions are not yet part of pack ops,
+  // no arithmetic whatsoever is being done here, so only the element type
+  // size matters, not the type itself.
+  iree_uk_pack_type_t pack_type = iree_uk_pack_type(params->flags);
+  int esize = iree_uk_type_size(iree_uk_pack_out_type(pack_type));
+  bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+  if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 8) {
+    // Currently only used for accumulators, which are never transposed.
+    return transpose ? 0 : iree_uk_pack_tile_8x8_x32_riscv_64_rvv_direct;
+  } else if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 1) {
+    return transpose ? iree_uk_pack_tile_8x1_x32_riscv_64_rvv_transpose
+                     : iree_uk_pack_tile_8x1_x32_riscv_64_rvv_direct;
+  } else if (esize == 1 && params->out_size2 == 8 && params->out_size3 == 1) {
+    return transpose ? iree_uk_pack_tile_8x1_x8_riscv_64_rvv_transpose
+                     : iree_uk_pack_tile_8x1_x8_riscv_64_rvv_direct;
+  }
+#endif  // defined(IREE_UK_BUILD_RISCV_64_RVV)
+  return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/common_riscv_64.h"
+#include "iree/builtins/ukernel/arch/riscv_64/pack_riscv_64_internal.h"
+
+void iree_uk_pack_tile_8x8_x32_riscv_64_rvv_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_rvv_copy_8x8xi32_strided_to_strided(out_ptr, in_ptr, 8,
+                                                in_stride0);
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
+
+// Gathers each column of 8 rows with a single strided load, so no transposing
+// through registers is needed.
+void iree_uk_pack_tile_8x1_x32_riscv_64_rvv_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_index_t in_byte_stride = in_stride0 * 4;
+  for (; outer_size1 > 0; --outer_size1) {
+    vint32m2_t col =
+        __riscv_vlse32_v_i32m2(in_ptr, in_byte_stride, IREE_UK_RVV_VL8);
+    __riscv_vse32_v_i32m2(out_ptr, col, IREE_UK_RVV_VL8);
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+void iree_uk_pack_tile_8x1_x32_riscv_64_rvv_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    vint32m2_t row = __riscv_vle32_v_i32m2(in_ptr, IREE_UK_RVV_VL8);
+    __riscv_vse32_v_i32m2(out_ptr, row, IREE_UK_RVV_VL8);
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
+
+void iree_uk_pack_tile_8x1_x8_riscv_64_rvv_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    vint8mf2_t col = __riscv_vlse8_v_i8mf2(in_ptr, in_stride0, IREE_UK_RVV_VL8);
+    __riscv_vse8_v_i8mf2(out_ptr, col, IREE_UK_RVV_VL8);
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+void iree_uk_pack_tile_8x1_x8_riscv_64_rvv_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    vint8mf2_t row = __riscv_vle8_v_i8mf2(in_ptr, IREE_UK_RVV_VL8);
+    __riscv_vse8_v_i8mf2(out_ptr, row, IREE_UK_RVV_VL8);
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
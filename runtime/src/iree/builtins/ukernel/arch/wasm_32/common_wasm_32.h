@@ -0,0 +1,59 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
+
+#include "iree/builtins/ukernel/common.h"
+#include "iree/schemas/cpu_data.h"
+
+#if defined(IREE_DEVICE_STANDALONE)
+// Standalone builds (e.g. bitcode) use our own Clang, supporting everything.
+#define IREE_UK_BUILD_WASM_32_SIMD128
+#else  // IREE_DEVICE_STANDALONE
+// Compiling with the system toolchain. Include the configured header.
+#include "iree/builtins/ukernel/arch/wasm_32/config_wasm_32.h"
+#endif  // IREE_DEVICE_STANDALONE
+
+static inline bool iree_uk_cpu_wasm_32_simd128(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_WASM_32_SIMD128);
+}
+
+#if defined(__wasm_simd128__)
+
+#include <wasm_simd128.h>
+
+// Copies 8 rows of 8 32-bit elements from a strided source to a strided
+// destination. Strides are in elements.
+static inline void iree_uk_wasm_copy_8x8xi32_strided_to_strided(
+    iree_uk_int32_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  IREE_UK_UNROLL for (int i = 0; i < 8; ++i) {
+    wasm_v128_store(out_ptr + i * out_stride + 0,
+                    wasm_v128_load(in_ptr + i * in_stride + 0));
+    wasm_v128_store(out_ptr + i * out_stride + 4,
+                    wasm_v128_load(in_ptr + i * in_stride + 4));
+  }
+}
+
+// Transposes the 4x4 32-bit matrix held in the rows |r0|..|r3| in place.
+static inline void iree_uk_wasm_transpose_4x4xi32(v128_t* r0, v128_t* r1,
+                                                  v128_t* r2, v128_t* r3) {
+  v128_t t0 = wasm_i32x4_shuffle(*r0, *r1, 0, 4, 1, 5);
+  v128_t t1 = wasm_i32x4_shuffle(*r0, *r1, 2, 6, 3, 7);
+  v128_t t2 = wasm_i32x4_shuffle(*r2, *r3, 0, 4, 1, 5);
+  v128_t t3 = wasm_i32x4_shuffle(*r2, *r3, 2, 6, 3, 7);
+  *r0 = wasm_i32x4_shuffle(t0, t2, 0, 1, 4, 5);
+  *r1 = wasm_i32x4_shuffle(t0, t2, 2, 3, 6, 7);
+  *r2 = wasm_i32x4_shuffle(t1, t3, 0, 1, 4, 5);
+  *r3 = wasm_i32x4_shuffle(t1, t3, 2, 3, 6, 7);
+}
+
+#endif  // defined(__wasm_simd128__)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
@@ -0,0 +1,114 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32.h"
+#include "iree/builtins/ukernel/arch/wasm_32/mmt4d_wasm_32_internal.h"
+
+// Each row of the 8-wide accumulator tile is held in two 128-bit vectors. The
+// SIMD128 proposal has no fused multiply-add (that is part of relaxed SIMD) so
+// f32 accumulation is a separate multiply and add.
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_wasm_32_simd128(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  v128_t acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = wasm_v128_load(out_ptr + 4 * i);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = wasm_f32x4_splat(0.f);
+    }
+  }
+  for (int k = 0; k < params->K; ++k) {
+    v128_t rhs0 = wasm_v128_load(rhs_ptr + 0);
+    v128_t rhs1 = wasm_v128_load(rhs_ptr + 4);
+    rhs_ptr += 8;
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      v128_t lhs = wasm_f32x4_splat(lhs_ptr[i]);
+      acc[2 * i + 0] =
+          wasm_f32x4_add(acc[2 * i + 0], wasm_f32x4_mul(lhs, rhs0));
+      acc[2 * i + 1] =
+          wasm_f32x4_add(acc[2 * i + 1], wasm_f32x4_mul(lhs, rhs1));
+    }
+    lhs_ptr += M0;
+  }
+  IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+    wasm_v128_store(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_wasm_32_simd128, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_2x8x1_wasm_32_simd128, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_4x8x1_wasm_32_simd128, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_8x8x1_wasm_32_simd128, 8)
+
+// The RHS row is sign-extended to 16 bits on load and multiplied by the
+// splatted LHS value with widening multiplies into the 32-bit accumulators.
+// The s8 x s8 products fit in 16 bits, so this is exact.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_wasm_32_simd128(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  v128_t acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = wasm_v128_load(out_ptr + 4 * i);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = wasm_i32x4_splat(0);
+    }
+  }
+  for (int k = 0; k < params->K; ++k) {
+    v128_t rhs = wasm_i16x8_load8x8(rhs_ptr);
+    rhs_ptr += 8;
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      v128_t lhs = wasm_i16x8_splat(lhs_ptr[i]);
+      acc[2 * i + 0] = wasm_i32x4_add(acc[2 * i + 0],
+                                      wasm_i32x4_extmul_low_i16x8(lhs, rhs));
+      acc[2 * i + 1] = wasm_i32x4_add(acc[2 * i + 1],
+                                      wasm_i32x4_extmul_high_i16x8(lhs, rhs));
+    }
+    lhs_ptr += M0;
+  }
+  IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+    wasm_v128_store(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_wasm_32_simd128, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_s8s8s32_2x8x1_wasm_32_simd128, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_s8s8s32_4x8x1_wasm_32_simd128, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x8x1_to_8x8x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_s8s8s32_8x8x1_wasm_32_simd128, 8)
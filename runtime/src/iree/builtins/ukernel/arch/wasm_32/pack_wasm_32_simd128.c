@@ -0,0 +1,156 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32.h"
+#include "iree/builtins/ukernel/arch/wasm_32/pack_wasm_32_internal.h"
+
+void iree_uk_pack_tile_8x8_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_wasm_copy_8x8xi32_strided_to_strided(out_ptr, in_ptr, 8,
+                                                 in_stride0);
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
+
+// SIMD128 has no strided loads, so 4 columns of 8 rows are loaded at once and
+// transposed through registers into 4 output tiles. Leftover columns are
+// gathered one element at a time.
+void iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 >= 4; outer_size1 -= 4) {
+    v128_t rows[8];
+    IREE_UK_UNROLL for (int i = 0; i < 8; ++i) {
+      rows[i] = wasm_v128_load(in_ptr + i * in_stride0);
+    }
+    iree_uk_wasm_transpose_4x4xi32(&rows[0], &rows[1], &rows[2], &rows[3]);
+    iree_uk_wasm_transpose_4x4xi32(&rows[4], &rows[5], &rows[6], &rows[7]);
+    IREE_UK_UNROLL for (int j = 0; j < 4; ++j) {
+      wasm_v128_store(out_ptr + j * out_stride1 + 0, rows[j]);
+      wasm_v128_store(out_ptr + j * out_stride1 + 4, rows[4 + j]);
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 4;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    IREE_UK_UNROLL for (int i = 0; i < 8; ++i) {
+      out_ptr[i] = in_ptr[i * in_stride0];
+    }
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+void iree_uk_pack_tile_8x1_x32_wasm_32_simd128_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    wasm_v128_store(out_ptr + 0, wasm_v128_load(in_ptr + 0));
+    wasm_v128_store(out_ptr + 4, wasm_v128_load(in_ptr + 4));
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
+
+// Transposes 8 columns of 8 rows of bytes at once by interleaving 8-bit, then
+// 16-bit, then 32-bit lanes, leaving each column in one 64-bit lane.
+void iree_uk_pack_tile_8x1_x8_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 >= 8; outer_size1 -= 8) {
+    v128_t rows[8];
+    IREE_UK_UNROLL for (int i = 0; i < 8; ++i) {
+      rows[i] = wasm_v128_load64_zero(in_ptr + i * in_stride0);
+    }
+    // Pairs of rows, interleaved per column.
+    v128_t r01 = wasm_i8x16_shuffle(rows[0], rows[1], 0, 16, 1, 17, 2, 18, 3,
+                                    19, 4, 20, 5, 21, 6, 22, 7, 23);
+    v128_t r23 = wasm_i8x16_shuffle(rows[2], rows[3], 0, 16, 1, 17, 2, 18, 3,
+                                    19, 4, 20, 5, 21, 6, 22, 7, 23);
+    v128_t r45 = wasm_i8x16_shuffle(rows[4], rows[5], 0, 16, 1, 17, 2, 18, 3,
+                                    19, 4, 20, 5, 21, 6, 22, 7, 23);
+    v128_t r67 = wasm_i8x16_shuffle(rows[6], rows[7], 0, 16, 1, 17, 2, 18, 3,
+                                    19, 4, 20, 5, 21, 6, 22, 7, 23);
+    // Quads of rows for columns 0-3 and 4-7.
+    v128_t r0123_lo = wasm_i16x8_shuffle(r01, r23, 0, 8, 1, 9, 2, 10, 3, 11);
+    v128_t r0123_hi = wasm_i16x8_shuffle(r01, r23, 4, 12, 5, 13, 6, 14, 7, 15);
+    v128_t r4567_lo = wasm_i16x8_shuffle(r45, r67, 0, 8, 1, 9, 2, 10, 3, 11);
+    v128_t r4567_hi = wasm_i16x8_shuffle(r45, r67, 4, 12, 5, 13, 6, 14, 7, 15);
+    // All 8 rows, 2 columns per vector.
+    v128_t cols[4] = {
+        wasm_i32x4_shuffle(r0123_lo, r4567_lo, 0, 4, 1, 5),
+        wasm_i32x4_shuffle(r0123_lo, r4567_lo, 2, 6, 3, 7),
+        wasm_i32x4_shuffle(r0123_hi, r4567_hi, 0, 4, 1, 5),
+        wasm_i32x4_shuffle(r0123_hi, r4567_hi, 2, 6, 3, 7),
+    };
+    IREE_UK_UNROLL for (int j = 0; j < 4; ++j) {
+      wasm_v128_store64_lane(out_ptr + (2 * j + 0) * out_stride1, cols[j], 0);
+      wasm_v128_store64_lane(out_ptr + (2 * j + 1) * out_stride1, cols[j], 1);
+    }
+    out_ptr += 8 * out_stride1;
+    in_ptr += 8;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    IREE_UK_UNROLL for (int i = 0; i < 8; ++i) {
+      out_ptr[i] = in_ptr[i * in_stride0];
+    }
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+void iree_uk_pack_tile_8x1_x8_wasm_32_simd128_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    wasm_v128_store64_lane(out_ptr, wasm_v128_load64_zero(in_ptr), 0);
+    out_ptr += out_stride1;
+    in_ptr += 8;
+  }
+}
@@ -18,6 +18,9 @@
 #define IREE_UK_BUILD_X86_64_AVX512_BASE
 #define IREE_UK_BUILD_X86_64_AVX512_VNNI
 #define IREE_UK_BUILD_X86_64_AVX512_BF16
+#define IREE_UK_BUILD_X86_64_AVX512_FP16
+#define IREE_UK_BUILD_X86_64_AMX_INT8
+#define IREE_UK_BUILD_X86_64_AMX_BF16
 #else  // IREE_DEVICE_STANDALONE
 // Compiling with the system toolchain. Include the configured header.
 #include "iree/builtins/ukernel/arch/x86_64/config_x86_64.h"
@@ -52,6 +55,28 @@ static inline bool iree_uk_cpu_x86_64_avx512_bf16(
          iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX512BF16);
 }
 
+static inline bool iree_uk_cpu_x86_64_avx512_fp16(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_x86_64_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX512FP16);
+}
+
+// The AMX kernels also use AVX-512 to relayout the RHS, so they require
+// avx512_base on top of the AMX bits. Every CPU with AMX has AVX-512.
+static inline bool iree_uk_cpu_x86_64_amx_int8(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_x86_64_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AMXTILE |
+                                               IREE_CPU_DATA0_X86_64_AMXINT8);
+}
+
+static inline bool iree_uk_cpu_x86_64_amx_bf16(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_x86_64_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AMXTILE |
+                                               IREE_CPU_DATA0_X86_64_AMXBF16);
+}
+
 #if defined(__AVX2__)
 
 static inline __m256i iree_uk_avx_loadu_2x128(const void* src0,
@@ -87,6 +112,23 @@ static inline void iree_uk_copy_16x64xi8_strided_to_strided(
   }
 }
 
+// Prefetches each of the 8 or 16 rows starting at `in_ptr`, 256 bytes (4 cache
+// lines) ahead. Used by pack tile functions that stream through many rows at
+// once, which hardware prefetchers may not track well.
+static inline void iree_uk_prefetch_8_rows_ahead(
+    const iree_uk_int8_t* in_ptr, iree_uk_index_t in_stride) {
+  for (int i = 0; i < 8; ++i) {
+    IREE_UK_PREFETCH_RO(in_ptr + i * in_stride + 256,
+                        IREE_UK_PREFETCH_LOCALITY_L1);
+  }
+}
+
+static inline void iree_uk_prefetch_16_rows_ahead(
+    const iree_uk_int8_t* in_ptr, iree_uk_index_t in_stride) {
+  iree_uk_prefetch_8_rows_ahead(in_ptr, in_stride);
+  iree_uk_prefetch_8_rows_ahead(in_ptr + 8 * in_stride, in_stride);
+}
+
 static inline __m256i iree_uk_avx2_load_8x4xi8_strided(
     const iree_uk_int8_t* src, iree_uk_index_t stride) {
   __m256i indices = _mm256_mullo_epi32(
@@ -446,8 +488,89 @@ iree_uk_avx512_copy_16x16xi8_tiled_1x2_transpose_strided_to_strided(
       r0123456701234567_3);
 }
 
+// Transposes a 16x16 matrix of 32-bit elements. Strides are in bytes.
+static inline void iree_uk_avx512_transpose_16x16xi32_strided_to_strided(
+    iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
+    const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
+    iree_uk_index_t in_stride) {
+  __m512i r[16];
+  IREE_UK_UNROLL for (int i = 0; i < 16; ++i) {
+    r[i] = _mm512_loadu_si512((const __m512i*)(in_ptr + i * in_stride));
+  }
+  // Interleave pairs of rows, then pairs of pairs. Afterwards, 128-bit lane L
+  // of t[4 * b + c] holds column 4 * L + c of rows 4 * b .. 4 * b + 3.
+  __m512i t[16];
+  IREE_UK_UNROLL for (int i = 0; i < 16; i += 2) {
+    t[i + 0] = _mm512_unpacklo_epi32(r[i], r[i + 1]);
+    t[i + 1] = _mm512_unpackhi_epi32(r[i], r[i + 1]);
+  }
+  IREE_UK_UNROLL for (int b = 0; b < 16; b += 4) {
+    r[b + 0] = _mm512_unpacklo_epi64(t[b + 0], t[b + 2]);
+    r[b + 1] = _mm512_unpackhi_epi64(t[b + 0], t[b + 2]);
+    r[b + 2] = _mm512_unpacklo_epi64(t[b + 1], t[b + 3]);
+    r[b + 3] = _mm512_unpackhi_epi64(t[b + 1], t[b + 3]);
+  }
+  // Gather the same 128-bit lane from the 4 row blocks.
+  IREE_UK_UNROLL for (int c = 0; c < 4; ++c) {
+    __m512i lo01 = _mm512_shuffle_i32x4(r[c + 0], r[c + 4], 0x44);
+    __m512i hi01 = _mm512_shuffle_i32x4(r[c + 0], r[c + 4], 0xEE);
+    __m512i lo23 = _mm512_shuffle_i32x4(r[c + 8], r[c + 12], 0x44);
+    __m512i hi23 = _mm512_shuffle_i32x4(r[c + 8], r[c + 12], 0xEE);
+    _mm512_storeu_si512((__m512i*)(out_ptr + (c + 0) * out_stride),
+                        _mm512_shuffle_i32x4(lo01, lo23, 0x88));
+    _mm512_storeu_si512((__m512i*)(out_ptr + (c + 4) * out_stride),
+                        _mm512_shuffle_i32x4(lo01, lo23, 0xDD));
+    _mm512_storeu_si512((__m512i*)(out_ptr + (c + 8) * out_stride),
+                        _mm512_shuffle_i32x4(hi01, hi23, 0x88));
+    _mm512_storeu_si512((__m512i*)(out_ptr + (c + 12) * out_stride),
+                        _mm512_shuffle_i32x4(hi01, hi23, 0xDD));
+  }
+}
+
 #endif  // defined (__AVX512F__)
 
+#if defined(__AMX_TILE__)
+
+// Palette 1 tile configuration, as loaded by LDTILECFG.
+typedef struct iree_uk_amx_tile_config_t {
+  iree_uk_uint8_t palette_id;
+  iree_uk_uint8_t start_row;
+  iree_uk_uint8_t reserved[14];
+  iree_uk_uint16_t colsb[16];
+  iree_uk_uint8_t rows[16];
+} iree_uk_amx_tile_config_t;
+
+// GCC implements LDTILECFG and TILELOADD as inline asm taking only the address
+// of the memory that they read, so it may drop or sink earlier stores to that
+// memory, such as the tile configuration or the relayout of the RHS. Call this
+// compiler barrier between such stores and the instruction reading them.
+static inline void iree_uk_amx_compiler_barrier(void) {
+#if defined(IREE_UK_COMPILER_GCC)
+  __asm__ volatile("" ::: "memory");
+#endif
+}
+
+// Configures the tiles used by the AMX mmt4d kernels:
+//   tmm0: M0 x 16 accumulator, 32-bit elements.
+//   tmm1: M0 x 64 bytes of LHS.
+//   tmm2: 16 x 64 bytes of RHS, in the VNNI layout: 16 rows each holding
+//         the 4 bytes of one K-group for all 16 columns.
+static inline void iree_uk_amx_configure_mmt4d_tiles(int M0) {
+  iree_uk_amx_tile_config_t config;
+  iree_uk_memset(&config, 0, sizeof config);
+  config.palette_id = 1;
+  config.rows[0] = M0;
+  config.colsb[0] = 64;
+  config.rows[1] = M0;
+  config.colsb[1] = 64;
+  config.rows[2] = 16;
+  config.colsb[2] = 64;
+  iree_uk_amx_compiler_barrier();
+  _tile_loadconfig(&config);
+}
+
+#endif  // defined(__AMX_TILE__)
+
 #endif  // defined(__AVX2__)
 
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_COMMON_X86_64_H_
@@ -0,0 +1,96 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_dequant_x86_64_internal.h"
+
+// Loads 16 f16 or bf16 values and converts them to f32.
+static inline __m512 iree_uk_mmt4d_dequant_load_16x16bit_as_f32(
+    const iree_uk_uint16_t* ptr, bool bf16) {
+  __m256i v = _mm256_loadu_si256((const __m256i*)ptr);
+  return bf16 ? _mm512_castsi512_ps(
+                    _mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16))
+              : _mm512_cvtph_ps(v);
+}
+
+// Same as the avx2_fma tile function, with N0=16.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_to_16x16x2_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const void* IREE_UK_RESTRICT scales_panel,
+    const void* IREE_UK_RESTRICT zero_points_panel,
+    const iree_uk_mmt4d_dequant_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT scales_ptr = scales_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT zero_points_ptr =
+      zero_points_panel;
+  const bool bf16 =
+      iree_uk_mmt4d_dequant_scale_type(params->flags) == IREE_UK_TYPE_BFLOAT_16;
+  const int k_per_group = params->group_size / 2;
+  const __m128i mask_0f = _mm_set1_epi8(0x0F);
+  __m512 acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_loadu_ps(out_ptr + i * 16);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_setzero_ps();
+    }
+  }
+  for (int k = 0; k < params->K; k += k_per_group) {
+    __m512 scale =
+        iree_uk_mmt4d_dequant_load_16x16bit_as_f32(scales_ptr, bf16);
+    __m512 zero_point =
+        iree_uk_mmt4d_dequant_load_16x16bit_as_f32(zero_points_ptr, bf16);
+    scales_ptr += 16;
+    zero_points_ptr += 16;
+    for (int kg = 0; kg < k_per_group; ++kg) {
+      __m128i rhs_bytes = _mm_loadu_si128((const __m128i*)rhs_ptr);
+      rhs_ptr += 16;
+      __m128i rhs_i8_0 = _mm_and_si128(rhs_bytes, mask_0f);
+      __m128i rhs_i8_1 = _mm_and_si128(_mm_srli_epi16(rhs_bytes, 4), mask_0f);
+      __m512 rhs_0 = _mm512_mul_ps(
+          _mm512_sub_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(rhs_i8_0)),
+                        zero_point),
+          scale);
+      __m512 rhs_1 = _mm512_mul_ps(
+          _mm512_sub_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(rhs_i8_1)),
+                        zero_point),
+          scale);
+      IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+        acc[i] = _mm512_fmadd_ps(_mm512_set1_ps(lhs_ptr[2 * i + 0]), rhs_0,
+                                 acc[i]);
+        acc[i] = _mm512_fmadd_ps(_mm512_set1_ps(lhs_ptr[2 * i + 1]), rhs_1,
+                                 acc[i]);
+      }
+      lhs_ptr += 2 * M0;
+    }
+  }
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    _mm512_storeu_ps(out_ptr + i * 16, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_x86_64_avx512_base, 1)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_2x16x2_x86_64_avx512_base, 2)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_4x16x2_x86_64_avx512_base, 4)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_8x16x2_x86_64_avx512_base, 8)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f32u4f32_16x16x2_x86_64_avx512_base, 16)
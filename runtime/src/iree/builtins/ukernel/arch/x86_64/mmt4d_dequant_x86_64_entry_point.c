@@ -0,0 +1,67 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_dequant_x86_64_internal.h"
+
+static iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_x86_64_f32u4f32_M0x8x2(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
+  if (iree_uk_cpu_x86_64_avx2_fma(params->cpu_data)) {
+    switch (params->M0) {
+      case 1:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_x86_64_avx2_fma;
+      case 2:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_2x8x2_x86_64_avx2_fma;
+      case 4:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_4x8x2_x86_64_avx2_fma;
+      case 8:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_8x8x2_x86_64_avx2_fma;
+    }
+  }
+#endif
+  return 0;
+}
+
+static iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_x86_64_f32u4f32_M0x16x2(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
+    switch (params->M0) {
+      case 1:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_x86_64_avx512_base;
+      case 2:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_2x16x2_x86_64_avx512_base;
+      case 4:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_4x16x2_x86_64_avx512_base;
+      case 8:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_8x16x2_x86_64_avx512_base;
+      case 16:
+        return iree_uk_mmt4d_dequant_tile_f32u4f32_16x16x2_x86_64_avx512_base;
+    }
+  }
+#endif
+  return 0;
+}
+
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  // All current types share the f32 LHS, u4 RHS and f32 output, and only
+  // differ in the scales type, which the tile functions handle at runtime.
+  if (params->K0 != 2) return 0;
+  switch (params->N0) {
+    case 8:
+      return iree_uk_mmt4d_dequant_select_tile_func_x86_64_f32u4f32_M0x8x2(
+          params);
+    case 16:
+      return iree_uk_mmt4d_dequant_select_tile_func_x86_64_f32u4f32_M0x16x2(
+          params);
+    default:
+      return 0;
+  }
+}
@@ -0,0 +1,31 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_X86_64_MMT4D_DEQUANT_X86_64_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_X86_64_MMT4D_DEQUANT_X86_64_INTERNAL_H_
+
+#include "iree/builtins/ukernel/mmt4d_dequant_internal.h"
+
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x8x2_x86_64_avx2_fma)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_2x8x2_x86_64_avx2_fma)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_4x8x2_x86_64_avx2_fma)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_8x8x2_x86_64_avx2_fma)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_1x16x2_x86_64_avx512_base)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_2x16x2_x86_64_avx512_base)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_4x16x2_x86_64_avx512_base)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_8x16x2_x86_64_avx512_base)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(
+    iree_uk_mmt4d_dequant_tile_f32u4f32_16x16x2_x86_64_avx512_base)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_MMT4D_DEQUANT_X86_64_INTERNAL_H_
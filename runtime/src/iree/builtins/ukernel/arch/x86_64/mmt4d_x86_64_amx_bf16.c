@@ -0,0 +1,139 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64_internal.h"
+
+// Converts 16 bf16 values to f32. This is exact: bf16 is the top half of f32.
+static inline __m512 iree_uk_avx512_cvt_16xbf16_to_16xf32(const void* src) {
+  __m256i bf16 = _mm256_loadu_si256((const __m256i*)src);
+  return _mm512_castsi512_ps(
+      _mm512_slli_epi32(_mm512_cvtepu16_epi32(bf16), 16));
+}
+
+// Converts 16 f32 values to bf16, rounding to nearest even like VCVTNEPS2BF16,
+// which is not available here as these kernels only require AVX-512 base on
+// top of AMX. NaNs are made quiet so that rounding cannot turn them into Inf.
+static inline void iree_uk_avx512_cvt_16xf32_to_16xbf16(void* dst, __m512 src) {
+  __m512i bits = _mm512_castps_si512(src);
+  __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(bits, 16),
+                                 _mm512_set1_epi32(1));
+  __m512i bias = _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF));
+  __m512i rounded = _mm512_srli_epi32(_mm512_add_epi32(bits, bias), 16);
+  __m512i quiet_nan = _mm512_or_si512(_mm512_srli_epi32(bits, 16),
+                                      _mm512_set1_epi32(0x40));
+  __mmask16 is_nan = _mm512_cmpgt_epu32_mask(
+      _mm512_and_si512(bits, _mm512_set1_epi32(0x7FFFFFFF)),
+      _mm512_set1_epi32(0x7F800000));
+  __m512i result = _mm512_mask_mov_epi32(rounded, is_nan, quiet_nan);
+  _mm256_storeu_si256((__m256i*)dst, _mm512_cvtepi32_epi16(result));
+}
+
+// One TDPBF16PS per K-step computes the whole M0x16 tile. The RHS panel stores
+// each column's 64 bytes contiguously, while TDPBF16PS wants each row of its B
+// tile to hold one 4-byte K-group for all 16 columns, so each RHS K-step is
+// transposed as a 16x16 matrix of 32-bit elements before being loaded.
+//
+// AMX only accumulates into f32, so a bf16 accumulator goes through an f32
+// copy of the tile and is rounded to bf16 once at the end.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_bf16bf16fXX_1x16x32_to_16x16x32_x86_64_amx_bf16(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, iree_uk_type_t acc_type, int M0) {
+  IREE_UK_ASSERT(acc_type == IREE_UK_TYPE_FLOAT_32 ||
+                 acc_type == IREE_UK_TYPE_BFLOAT_16);
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  const iree_uk_uint16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int8_t rhs_vnni[16 * 64];
+  float acc_f32[16 * 16];
+  float* IREE_UK_RESTRICT acc_ptr =
+      acc_type == IREE_UK_TYPE_FLOAT_32 ? out_tile : acc_f32;
+  iree_uk_amx_configure_mmt4d_tiles(M0);
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    if (acc_type == IREE_UK_TYPE_BFLOAT_16) {
+      const iree_uk_uint16_t* IREE_UK_RESTRICT out_ptr = out_tile;
+      for (int i = 0; i < M0; ++i) {
+        __m512 acc = iree_uk_avx512_cvt_16xbf16_to_16xf32(out_ptr + i * 16);
+        _mm512_storeu_ps(acc_ptr + i * 16, acc);
+      }
+    }
+    iree_uk_amx_compiler_barrier();
+    _tile_loadd(0, acc_ptr, 64);
+  } else {
+    _tile_zero(0);
+  }
+  for (int k = 0; k < params->K; ++k) {
+    iree_uk_avx512_transpose_16x16xi32_strided_to_strided(rhs_vnni, rhs_ptr,
+                                                          64, 64);
+    rhs_ptr += 16 * 64;
+    iree_uk_amx_compiler_barrier();
+    _tile_loadd(1, lhs_ptr, 64);
+    lhs_ptr += M0 * 32;
+    _tile_loadd(2, rhs_vnni, 64);
+    _tile_dpbf16ps(0, 1, 2);
+  }
+  _tile_stored(0, acc_ptr, 64);
+  _tile_release();
+  if (acc_type == IREE_UK_TYPE_BFLOAT_16) {
+    iree_uk_uint16_t* IREE_UK_RESTRICT out_ptr = out_tile;
+    for (int i = 0; i < M0; ++i) {
+      iree_uk_avx512_cvt_16xf32_to_16xbf16(out_ptr + i * 16,
+                                           _mm512_loadu_ps(acc_ptr + i * 16));
+    }
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_bf16bf16f32_1x16x32_to_16x16x32_x86_64_amx_bf16(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_tile_bf16bf16fXX_1x16x32_to_16x16x32_x86_64_amx_bf16(
+      out_tile, lhs_panel, rhs_panel, params, IREE_UK_TYPE_FLOAT_32, M0);
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_bf16bf16bf16_1x16x32_to_16x16x32_x86_64_amx_bf16(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_tile_bf16bf16fXX_1x16x32_to_16x16x32_x86_64_amx_bf16(
+      out_tile, lhs_panel, rhs_panel, params, IREE_UK_TYPE_BFLOAT_16, M0);
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x32_x86_64_amx_bf16, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16f32_2x16x32_x86_64_amx_bf16, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16f32_4x16x32_x86_64_amx_bf16, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16f32_8x16x32_x86_64_amx_bf16, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16f32_16x16x32_x86_64_amx_bf16, 16)
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16bf16_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16bf16_1x16x32_x86_64_amx_bf16, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16bf16_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16bf16_2x16x32_x86_64_amx_bf16, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16bf16_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16bf16_4x16x32_x86_64_amx_bf16, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16bf16_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16bf16_8x16x32_x86_64_amx_bf16, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16bf16_1x16x32_to_16x16x32_x86_64_amx_bf16,
+    iree_uk_mmt4d_tile_bf16bf16bf16_16x16x32_x86_64_amx_bf16, 16)
@@ -0,0 +1,59 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64_internal.h"
+
+// One TDPBSSD per K-step computes the whole M0x16 tile. The RHS panel stores
+// each column's 64 bytes contiguously, while TDPBSSD wants each row of its B
+// tile to hold one 4-byte K-group for all 16 columns, so each RHS K-step is
+// transposed as a 16x16 matrix of 32-bit elements before being loaded.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s8s8s32_1x16x64_to_16x16x64_x86_64_amx_int8(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int8_t rhs_vnni[16 * 64];
+  iree_uk_amx_configure_mmt4d_tiles(M0);
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    iree_uk_amx_compiler_barrier();
+    _tile_loadd(0, out_ptr, 64);
+  } else {
+    _tile_zero(0);
+  }
+  for (int k = 0; k < params->K; ++k) {
+    iree_uk_avx512_transpose_16x16xi32_strided_to_strided(rhs_vnni, rhs_ptr,
+                                                          64, 64);
+    rhs_ptr += 16 * 64;
+    iree_uk_amx_compiler_barrier();
+    _tile_loadd(1, lhs_ptr, 64);
+    lhs_ptr += M0 * 64;
+    _tile_loadd(2, rhs_vnni, 64);
+    _tile_dpbssd(0, 1, 2);
+  }
+  _tile_stored(0, out_ptr, 64);
+  _tile_release();
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x64_to_16x16x64_x86_64_amx_int8,
+    iree_uk_mmt4d_tile_s8s8s32_1x16x64_x86_64_amx_int8, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x64_to_16x16x64_x86_64_amx_int8,
+    iree_uk_mmt4d_tile_s8s8s32_2x16x64_x86_64_amx_int8, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x64_to_16x16x64_x86_64_amx_int8,
+    iree_uk_mmt4d_tile_s8s8s32_4x16x64_x86_64_amx_int8, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x64_to_16x16x64_x86_64_amx_int8,
+    iree_uk_mmt4d_tile_s8s8s32_8x16x64_x86_64_amx_int8, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x64_to_16x16x64_x86_64_amx_int8,
+    iree_uk_mmt4d_tile_s8s8s32_16x16x64_x86_64_amx_int8, 16)
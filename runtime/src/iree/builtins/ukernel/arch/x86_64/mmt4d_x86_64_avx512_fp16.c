@@ -0,0 +1,65 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64_internal.h"
+
+// Native f16 arithmetic: each 512-bit FMA covers 32 columns, twice as many as
+// the avx512_base kernel which converts to f32. Accumulating in f16 performs
+// every intermediate rounding, so this is correct whether or not
+// IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS is set.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_f16f16f16_1x32x1_to_16x32x1_x86_64_avx512_fp16(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  iree_uk_uint16_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint16_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  _mm_prefetch((const char*)lhs_ptr, _MM_HINT_T0);
+  _mm_prefetch((const char*)rhs_ptr, _MM_HINT_T0);
+  __m512h acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_loadu_ph(out_ptr + i * 32);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_setzero_ph();
+    }
+  }
+  for (int k = 0; k < params->K; ++k) {
+    __m512h rhs = _mm512_loadu_ph(rhs_ptr);
+    _mm_prefetch((const char*)(rhs_ptr + 256), _MM_HINT_T0);
+    rhs_ptr += 32;
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      __m512h lhs = _mm512_castsi512_ph(_mm512_set1_epi16(lhs_ptr[i]));
+      acc[i] = _mm512_fmadd_ph(lhs, rhs, acc[i]);
+    }
+    _mm_prefetch((const char*)(lhs_ptr + 128), _MM_HINT_T0);
+    lhs_ptr += M0;
+  }
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    _mm512_storeu_ph(out_ptr + i * 32, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f16_1x32x1_to_16x32x1_x86_64_avx512_fp16,
+    iree_uk_mmt4d_tile_f16f16f16_1x32x1_x86_64_avx512_fp16, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f16_1x32x1_to_16x32x1_x86_64_avx512_fp16,
+    iree_uk_mmt4d_tile_f16f16f16_2x32x1_x86_64_avx512_fp16, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f16_1x32x1_to_16x32x1_x86_64_avx512_fp16,
+    iree_uk_mmt4d_tile_f16f16f16_4x32x1_x86_64_avx512_fp16, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f16_1x32x1_to_16x32x1_x86_64_avx512_fp16,
+    iree_uk_mmt4d_tile_f16f16f16_8x32x1_x86_64_avx512_fp16, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f16_1x32x1_to_16x32x1_x86_64_avx512_fp16,
+    iree_uk_mmt4d_tile_f16f16f16_16x32x1_x86_64_avx512_fp16, 16)
@@ -52,6 +52,27 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
 #define IREE_UK_MMT4D_TILE_x86_64_avx512_bf16(lhs, rhs, out, m0, n0, k0)
 #endif
 
+#ifdef IREE_UK_BUILD_X86_64_AVX512_FP16
+#define IREE_UK_MMT4D_TILE_x86_64_avx512_fp16(lhs, rhs, out, m0, n0, k0) \
+  IREE_UK_MMT4D_TILE_IMPL_x86_64(lhs, rhs, out, m0, n0, k0, _avx512_fp16)
+#else
+#define IREE_UK_MMT4D_TILE_x86_64_avx512_fp16(lhs, rhs, out, m0, n0, k0)
+#endif
+
+#ifdef IREE_UK_BUILD_X86_64_AMX_INT8
+#define IREE_UK_MMT4D_TILE_x86_64_amx_int8(lhs, rhs, out, m0, n0, k0) \
+  IREE_UK_MMT4D_TILE_IMPL_x86_64(lhs, rhs, out, m0, n0, k0, _amx_int8)
+#else
+#define IREE_UK_MMT4D_TILE_x86_64_amx_int8(lhs, rhs, out, m0, n0, k0)
+#endif
+
+#ifdef IREE_UK_BUILD_X86_64_AMX_BF16
+#define IREE_UK_MMT4D_TILE_x86_64_amx_bf16(lhs, rhs, out, m0, n0, k0) \
+  IREE_UK_MMT4D_TILE_IMPL_x86_64(lhs, rhs, out, m0, n0, k0, _amx_bf16)
+#else
+#define IREE_UK_MMT4D_TILE_x86_64_amx_bf16(lhs, rhs, out, m0, n0, k0)
+#endif
+
 #define IREE_UK_MMT4D_TILE(arch, lhs, rhs, out, m0, n0, k0, suffix) \
   IREE_UK_MMT4D_TILE_x86_64##suffix(lhs, rhs, out, m0, n0, k0)
 
@@ -19,6 +19,11 @@ void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct(
   const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
   iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
   for (; outer_size1 > 0; --outer_size1) {
+    // Each iteration consumes half a cache line of each source row, so only
+    // prefetch every other iteration.
+    if (outer_size1 & 1) {
+      iree_uk_prefetch_8_rows_ahead(in_ptr, 4 * in_stride0);
+    }
     iree_uk_copy_8x32xi8_strided_to_strided(out_ptr, in_ptr, 32,
                                             4 * in_stride0);
     out_ptr += 4 * out_stride1;
@@ -26,6 +31,41 @@ void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct(
   }
 }
 
+void iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct_nontemporal(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  // Streaming stores require 32-byte aligned destinations.
+  if (((iree_uk_index_t)out_tile_ptr | (4 * out_stride1)) & 31) {
+    iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct(
+        out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0,
+        elem_size, tile_size0, tile_size1);
+    return;
+  }
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    if (outer_size1 & 1) {
+      iree_uk_prefetch_8_rows_ahead(in_ptr, 4 * in_stride0);
+    }
+    for (int i = 0; i < 8; ++i) {
+      __m256i row =
+          _mm256_loadu_si256((const __m256i*)(in_ptr + i * 4 * in_stride0));
+      _mm256_stream_si256((__m256i*)(out_ptr + i * 32), row);
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 32;
+  }
+  // Order the weakly-ordered streaming stores before any subsequent stores,
+  // e.g. the one signaling completion of this workgroup.
+  _mm_sfence();
+}
+
 static void iree_uk_pack_tile_8x4_x8_x86_64_avx2_fma_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
@@ -19,6 +19,7 @@ void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct(
   const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
   iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
   for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_prefetch_16_rows_ahead(in_ptr, 4 * in_stride0);
     iree_uk_copy_16x64xi8_strided_to_strided(out_ptr, in_ptr, 64,
                                              4 * in_stride0);
     out_ptr += 4 * out_stride1;
@@ -26,6 +27,83 @@ void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct(
   }
 }
 
+void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_nontemporal(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  // Streaming stores require 64-byte aligned destinations.
+  if (((iree_uk_index_t)out_tile_ptr | (4 * out_stride1)) & 63) {
+    iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct(
+        out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0,
+        elem_size, tile_size0, tile_size1);
+    return;
+  }
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_prefetch_16_rows_ahead(in_ptr, 4 * in_stride0);
+    for (int i = 0; i < 16; ++i) {
+      __m512i row = _mm512_loadu_si512(in_ptr + i * 4 * in_stride0);
+      _mm512_stream_si512((__m512i*)(out_ptr + i * 64), row);
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 64;
+  }
+  // Order the weakly-ordered streaming stores before any subsequent stores,
+  // e.g. the one signaling completion of this workgroup.
+  _mm_sfence();
+}
+
+// Shared by the 16x64_x8 and 16x32_x16 tiles used by AMX: both have 16 rows
+// of 64 bytes each.
+static void iree_uk_pack_tile_16x64xi8_x86_64_avx512_base_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size) {
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_copy_16x64xi8_strided_to_strided(out_ptr, in_ptr, 64,
+                                             elem_size * in_stride0);
+    out_ptr += elem_size * out_stride1;
+    in_ptr += 64;
+  }
+}
+
+void iree_uk_pack_tile_16x64_x8_x86_64_avx512_base_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 1);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 64);
+  iree_uk_pack_tile_16x64xi8_x86_64_avx512_base_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0,
+      elem_size);
+}
+
+void iree_uk_pack_tile_16x32_x16_x86_64_avx512_base_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 2);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 32);
+  iree_uk_pack_tile_16x64xi8_x86_64_avx512_base_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0,
+      elem_size);
+}
+
 static void iree_uk_pack_tile_16x4_x8_x86_64_avx512_base_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
@@ -12,7 +12,11 @@ static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_8x8_x32(
 #if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
   if (iree_uk_cpu_x86_64_avx2_fma(params->cpu_data)) {
     bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
-    return transpose ? 0 : iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct;
+    if (transpose) return 0;
+    if (params->flags & IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES) {
+      return iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct_nontemporal;
+    }
+    return iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct;
   }
 #endif
   return 0;
@@ -23,8 +27,11 @@ static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_16x16_x32(
 #if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
   if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
     bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
-    return transpose ? 0
-                     : iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct;
+    if (transpose) return 0;
+    if (params->flags & IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES) {
+      return iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_nontemporal;
+    }
+    return iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct;
   }
 #endif
   return 0;
@@ -90,6 +97,29 @@ static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_16x2_x8(
   return 0;
 }
 
+static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_16x64_x8(
+    const iree_uk_pack_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
+    bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+    return transpose ? 0 : iree_uk_pack_tile_16x64_x8_x86_64_avx512_base_direct;
+  }
+#endif
+  return 0;
+}
+
+static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_16x32_x16(
+    const iree_uk_pack_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
+  if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
+    bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+    return transpose ? 0
+                     : iree_uk_pack_tile_16x32_x16_x86_64_avx512_base_direct;
+  }
+#endif
+  return 0;
+}
+
 iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
     const iree_uk_pack_params_t* params) {
   // At the moment, as sum-reductions are not yet part of pack ops,
@@ -111,6 +141,10 @@ iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
     return iree_uk_pack_select_tile_func_x86_64_8x2_x8(params);
   } else if (esize == 1 && params->out_size2 == 16 && params->out_size3 == 2) {
     return iree_uk_pack_select_tile_func_x86_64_16x2_x8(params);
+  } else if (esize == 1 && params->out_size2 == 16 && params->out_size3 == 64) {
+    return iree_uk_pack_select_tile_func_x86_64_16x64_x8(params);
+  } else if (esize == 2 && params->out_size2 == 16 && params->out_size3 == 32) {
+    return iree_uk_pack_select_tile_func_x86_64_16x32_x16(params);
   }
   return 0;
 }
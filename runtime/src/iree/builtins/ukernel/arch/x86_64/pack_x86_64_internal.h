@@ -10,8 +10,12 @@
 #include "iree/builtins/ukernel/pack_internal.h"
 
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct_nontemporal)
 IREE_UK_PACK_TILE_FUNC_DECL(
     iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_nontemporal)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_x86_64_avx2_fma_direct)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_x86_64_avx2_fma_transpose)
 IREE_UK_PACK_TILE_FUNC_DECL(
@@ -27,5 +31,9 @@ IREE_UK_PACK_TILE_FUNC_DECL(
     iree_uk_pack_tile_16x2_x16_x86_64_avx512_base_direct)
 IREE_UK_PACK_TILE_FUNC_DECL(
     iree_uk_pack_tile_16x2_x16_x86_64_avx512_base_transpose)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_16x64_x8_x86_64_avx512_base_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_16x32_x16_x86_64_avx512_base_direct)
 
 #endif  // foIREE_BUILTINS_UKERNEL_ARCH_X86_64_PACK_X86_64_INTERNAL_H_
@@ -48,6 +48,23 @@
 // output bit flags for iree_uk_mmt4d_info
 #define IREE_UK_FLAG_MMT4D_INFO_HAVE_ARCHITECTURE_SPECIFIC_TILE_FUNCTION 0x1
 
+//===----------------------------------------------------------------------===//
+// mmt4d_dequant
+//===----------------------------------------------------------------------===//
+
+// type enum. The type names are LHS, RHS, scales/zero-points, output. The RHS
+// element type u4 is dequantized as (rhs - zero_point) * scale with one scale
+// and one zero point per group of consecutive K elements and per N element.
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_NONE 0x00
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F16F32 0x01
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4BF16F32 0x02
+#define IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_END 0x03
+
+// bit flags
+#define IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE 0x100
+#define IREE_UK_FLAG_MMT4D_DEQUANT_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION 0x200
+
 //===----------------------------------------------------------------------===//
 // pack
 //===----------------------------------------------------------------------===//
@@ -64,6 +81,10 @@
 // bit flags
 #define IREE_UK_FLAG_PACK_TRANSPOSE_INNER 0x100
 #define IREE_UK_FLAG_PACK_TRANSPOSE_OUTER 0x200
+// Hint that the packed output will not be read again soon, e.g. because it is
+// much larger than the cache. Tile functions may then use non-temporal stores
+// to avoid evicting useful data. Does not change the result.
+#define IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES 0x400
 
 //===----------------------------------------------------------------------===//
 // unpack
@@ -0,0 +1,162 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/mmt4d_dequant.h"
+
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/mmt4d_dequant_internal.h"
+
+static void iree_uk_mmt4d_dequant_validate(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_MASK |
+      IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE |
+      IREE_UK_FLAG_MMT4D_DEQUANT_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type =
+      params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type != IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_NONE &&
+                 flags_type < IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_END);
+  // Same ranges as in mmt4d, see the comment in iree_uk_mmt4d_validate.
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->M, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->N, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->K, 31));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->M0, 15));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->N0, 15));
+  IREE_UK_ASSERT(IREE_UK_VALUE_IN_UNSIGNED_INT_RANGE(params->K0, 15));
+  // The u4 RHS requires K0 and the RHS stride to be even so that the RHS
+  // panels and tiles start on byte boundaries.
+  IREE_UK_ASSERT(!(params->K0 % 2));
+  IREE_UK_ASSERT(!(params->rhs_stride0 % 2));
+  IREE_UK_ASSERT(!(params->rhs_offset % 2));
+  // Groups are made of whole K0-slices and evenly divide the reduction.
+  IREE_UK_ASSERT(params->group_size > 0);
+  IREE_UK_ASSERT(!(params->group_size % params->K0));
+  IREE_UK_ASSERT(!((params->K * params->K0) % params->group_size));
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// General mmt4d_dequant implementation, mirroring
+// iree_uk_mmt4d_using_tile_func, with the scales and zero points panels
+// advancing along with the RHS panels.
+static void iree_uk_mmt4d_dequant_using_tile_func(
+    const iree_uk_mmt4d_dequant_params_t* params,
+    iree_uk_mmt4d_dequant_tile_func_t tile_func) {
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  // Element sizes: f32 LHS and output, u4 RHS, 16-bit scales and zero points.
+  char* out_tile_row =
+      (char*)params->out_buffer + params->out_offset * sizeof(float);
+  const char* lhs_panel =
+      (const char*)params->lhs_buffer + params->lhs_offset * sizeof(float);
+  const char* rhs_panel_start =
+      (const char*)params->rhs_buffer + params->rhs_offset / 2;
+  const char* scales_panel_start =
+      (const char*)params->scales_buffer +
+      params->scales_offset * sizeof(iree_uk_uint16_t);
+  const char* zero_points_panel_start =
+      (const char*)params->zero_points_buffer +
+      params->zero_points_offset * sizeof(iree_uk_uint16_t);
+  iree_uk_int32_t out_tile_size = M0 * N0 * sizeof(float);
+  iree_uk_index_t lhs_panel_stride = params->lhs_stride0 * sizeof(float);
+  iree_uk_index_t rhs_panel_stride = params->rhs_stride0 / 2;
+  iree_uk_index_t scales_panel_stride =
+      params->scales_stride0 * sizeof(iree_uk_uint16_t);
+  iree_uk_index_t zero_points_panel_stride =
+      params->zero_points_stride0 * sizeof(iree_uk_uint16_t);
+  iree_uk_index_t out_stride = params->out_stride0 * sizeof(float);
+  for (iree_uk_int32_t i = 0; i < M; ++i) {
+    char* out_tile = out_tile_row;
+    const char* rhs_panel = rhs_panel_start;
+    const char* scales_panel = scales_panel_start;
+    const char* zero_points_panel = zero_points_panel_start;
+    IREE_UK_PREFETCH_RW(out_tile_row, IREE_UK_PREFETCH_LOCALITY_L3);
+    IREE_UK_PREFETCH_RO(lhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+    IREE_UK_PREFETCH_RO(rhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+    for (iree_uk_int32_t j = 0; j < N; ++j) {
+      tile_func(out_tile, lhs_panel, rhs_panel, scales_panel,
+                zero_points_panel, params);
+      out_tile += out_tile_size;
+      rhs_panel += rhs_panel_stride;
+      scales_panel += scales_panel_stride;
+      zero_points_panel += zero_points_panel_stride;
+    }
+    out_tile_row += out_stride;
+    lhs_panel += lhs_panel_stride;
+  }
+}
+
+// Returns true if already done.
+static bool iree_uk_mmt4d_dequant_early(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  return params->M == 0 || params->N == 0 ||
+         (params->K == 0 &&
+          params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE);
+}
+
+void iree_uk_mmt4d_dequant_p(const iree_uk_mmt4d_dequant_params_t* params) {
+  iree_uk_mmt4d_dequant_validate(params);
+
+  if (iree_uk_mmt4d_dequant_early(params)) return;
+
+  iree_uk_mmt4d_dequant_tile_func_t tile_func =
+      iree_uk_mmt4d_dequant_select_tile_func_arch(params);
+
+  if (!tile_func) {
+    if (params->flags &
+        IREE_UK_FLAG_MMT4D_DEQUANT_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION) {
+      tile_func = iree_uk_mmt4d_dequant_select_tile_func_generic(params);
+    } else {
+      IREE_UK_ASSERT(
+          0 && "no target-specific tile function, and fallback not enabled.");
+    }
+  }
+
+  iree_uk_mmt4d_dequant_using_tile_func(params, tile_func);
+}
+
+IREE_UK_EXPORT void iree_uk_mmt4d_dequant(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0,
+    const void* scales_buffer, iree_uk_index_t scales_offset,
+    iree_uk_index_t scales_stride0, const void* zero_points_buffer,
+    iree_uk_index_t zero_points_offset, iree_uk_index_t zero_points_stride0,
+    void* out_buffer, iree_uk_index_t out_offset, iree_uk_index_t out_stride0,
+    iree_uk_index_t M, iree_uk_index_t N, iree_uk_index_t K,
+    iree_uk_int32_t M0, iree_uk_int32_t N0, iree_uk_int32_t K0,
+    iree_uk_int32_t group_size, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data) {
+  iree_uk_mmt4d_dequant_params_t params = {
+      .lhs_buffer = lhs_buffer,
+      .lhs_offset = lhs_offset,
+      .lhs_stride0 = lhs_stride0,
+      .rhs_buffer = rhs_buffer,
+      .rhs_offset = rhs_offset,
+      .rhs_stride0 = rhs_stride0,
+      .scales_buffer = scales_buffer,
+      .scales_offset = scales_offset,
+      .scales_stride0 = scales_stride0,
+      .zero_points_buffer = zero_points_buffer,
+      .zero_points_offset = zero_points_offset,
+      .zero_points_stride0 = zero_points_stride0,
+      .out_buffer = out_buffer,
+      .out_offset = out_offset,
+      .out_stride0 = out_stride0,
+      .M = M,
+      .N = N,
+      .K = K,
+      .M0 = M0,
+      .N0 = N0,
+      .K0 = K0,
+      .group_size = group_size,
+      .flags = flags,
+      .cpu_data = cpu_data};
+  iree_uk_mmt4d_dequant_p(&params);
+}
@@ -0,0 +1,34 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_H_
+#define IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `mmt4d_dequant` microkernel: a mmt4d whose RHS is made of 4-bit quantized
+// weights that get dequantized on the fly with per-group scales and zero
+// points, as in GPTQ/AWQ-style quantization.
+//
+// The LHS and RHS layouts are the same as in mmt4d. The scales and zero points
+// buffers share the layout [N][K * K0 / group_size][N0], with stride0 being the
+// stride along N, and group_size being the number of consecutive elements along
+// the K * K0 reduction dimension sharing a scale and zero point. The
+// group_size must be a multiple of K0 and must divide K * K0.
+IREE_UK_EXPORT void iree_uk_mmt4d_dequant(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0,
+    const void* scales_buffer, iree_uk_index_t scales_offset,
+    iree_uk_index_t scales_stride0, const void* zero_points_buffer,
+    iree_uk_index_t zero_points_offset, iree_uk_index_t zero_points_stride0,
+    void* out_buffer, iree_uk_index_t out_offset, iree_uk_index_t out_stride0,
+    iree_uk_index_t M, iree_uk_index_t N, iree_uk_index_t K,
+    iree_uk_int32_t M0, iree_uk_int32_t N0, iree_uk_int32_t K0,
+    iree_uk_int32_t group_size, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_H_
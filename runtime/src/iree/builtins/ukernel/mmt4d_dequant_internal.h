@@ -0,0 +1,103 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_INTERNAL_H_
+
+#include "iree/builtins/ukernel/mmt4d_dequant.h"
+
+// While the iree_uk_mmt4d_dequant public entry point takes separate
+// parameters, internally the implementation functions pass parameters as this
+// struct.
+typedef struct iree_uk_mmt4d_dequant_params_t {
+  const void* lhs_buffer;
+  iree_uk_index_t lhs_offset;
+  iree_uk_index_t lhs_stride0;
+  const void* rhs_buffer;
+  iree_uk_index_t rhs_offset;
+  iree_uk_index_t rhs_stride0;
+  const void* scales_buffer;
+  iree_uk_index_t scales_offset;
+  iree_uk_index_t scales_stride0;
+  const void* zero_points_buffer;
+  iree_uk_index_t zero_points_offset;
+  iree_uk_index_t zero_points_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  iree_uk_int32_t M0;
+  iree_uk_int32_t N0;
+  iree_uk_int32_t K0;
+  iree_uk_int32_t group_size;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_mmt4d_dequant_params_t;
+
+// Same as the iree_uk_mmt4d_dequant public entry point, but taking the struct.
+void iree_uk_mmt4d_dequant_p(const iree_uk_mmt4d_dequant_params_t* params);
+
+// The LHS, RHS and output types are currently the same for all type enum
+// values: f32, u4 and f32. Only the scales and zero points type varies.
+static inline iree_uk_type_t iree_uk_mmt4d_dequant_scale_type(
+    iree_uk_uint32_t flags) {
+  return (flags & IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_MASK) ==
+                 IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4BF16F32
+             ? IREE_UK_TYPE_BFLOAT_16
+             : IREE_UK_TYPE_FLOAT_16;
+}
+
+// Converts a scale or zero point value to f32.
+static inline float iree_uk_mmt4d_dequant_scale_to_f32(
+    iree_uk_uint16_t value, iree_uk_uint32_t flags) {
+  return iree_uk_mmt4d_dequant_scale_type(flags) == IREE_UK_TYPE_BFLOAT_16
+             ? iree_uk_bf16_to_f32(value)
+             : iree_uk_f16_to_f32(value);
+}
+
+// Function pointer type for tile functions, computing one M0xN0 tile of the
+// output matrix. The scales and zero points panels point to the
+// [K * K0 / group_size][N0] slices corresponding to the rhs_panel.
+typedef void (*iree_uk_mmt4d_dequant_tile_func_t)(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const void* IREE_UK_RESTRICT scales_panel,
+    const void* IREE_UK_RESTRICT zero_points_panel,
+    const iree_uk_mmt4d_dequant_params_t* params);
+
+// Tile kernel declarations. Prototype matches
+// iree_uk_mmt4d_dequant_tile_func_t.
+#define IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(NAME)          \
+  void NAME(void* IREE_UK_RESTRICT out_tile,                \
+            const void* IREE_UK_RESTRICT lhs_panel,         \
+            const void* IREE_UK_RESTRICT rhs_panel,         \
+            const void* IREE_UK_RESTRICT scales_panel,      \
+            const void* IREE_UK_RESTRICT zero_points_panel, \
+            const iree_uk_mmt4d_dequant_params_t* params);
+
+#define IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(GENERIC_FUNC, FUNC, M0) \
+  void FUNC(void* IREE_UK_RESTRICT out_tile,                                \
+            const void* IREE_UK_RESTRICT lhs_panel,                         \
+            const void* IREE_UK_RESTRICT rhs_panel,                         \
+            const void* IREE_UK_RESTRICT scales_panel,                      \
+            const void* IREE_UK_RESTRICT zero_points_panel,                 \
+            const iree_uk_mmt4d_dequant_params_t* params) {                 \
+    GENERIC_FUNC(out_tile, lhs_panel, rhs_panel, scales_panel,              \
+                 zero_points_panel, params, M0);                            \
+  }
+
+// Architecture-specific implementation, or generic fallback returning null.
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_dequant_params_t* params);
+
+// Generic fallback.
+iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_generic(
+    const iree_uk_mmt4d_dequant_params_t* params);
+
+#endif  // IREE_BUILTINS_UKERNEL_MMT4D_DEQUANT_INTERNAL_H_
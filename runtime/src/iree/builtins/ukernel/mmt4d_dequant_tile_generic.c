@@ -0,0 +1,64 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/mmt4d_dequant_internal.h"
+
+// Generic implementation of the dequantizing matmul tile, f32*u4->f32 case,
+// with f16 or bf16 scales and zero points.
+static void iree_uk_mmt4d_dequant_tile_f32u4f32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, const void* scales_panel_untyped,
+    const void* zero_points_panel_untyped,
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  float* out_tile = out_tile_untyped;
+  const float* lhs_panel = lhs_panel_untyped;
+  const iree_uk_uint8_t* rhs_panel = rhs_panel_untyped;
+  const iree_uk_uint16_t* scales_panel = scales_panel_untyped;
+  const iree_uk_uint16_t* zero_points_panel = zero_points_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  iree_uk_int16_t K0half = K0 / 2;
+  iree_uk_index_t k_per_group = params->group_size / K0;
+  for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+    for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+      float acc = (params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE)
+                      ? out_tile[i0 * N0 + j0]
+                      : 0.f;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        iree_uk_index_t g = k / k_per_group;
+        float scale = iree_uk_mmt4d_dequant_scale_to_f32(
+            scales_panel[g * N0 + j0], params->flags);
+        float zero_point = iree_uk_mmt4d_dequant_scale_to_f32(
+            zero_points_panel[g * N0 + j0], params->flags);
+        for (iree_uk_index_t k0h = 0; k0h < K0half; ++k0h) {
+          float lhs_0 = lhs_panel[k * M0 * K0 + i0 * K0 + 2 * k0h];
+          float lhs_1 = lhs_panel[k * M0 * K0 + i0 * K0 + 2 * k0h + 1];
+          iree_uk_uint8_t rhs_byte =
+              rhs_panel[k * N0 * K0half + j0 * K0half + k0h];
+          float rhs_0 = ((float)(rhs_byte & 0x0F) - zero_point) * scale;
+          float rhs_1 = ((float)(rhs_byte >> 4) - zero_point) * scale;
+          acc += lhs_0 * rhs_0 + lhs_1 * rhs_1;
+        }
+      }
+      out_tile[i0 * N0 + j0] = acc;
+    }
+  }
+}
+
+iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_generic(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  switch (params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_MASK) {
+    case IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F16F32:
+    case IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4BF16F32:
+      return iree_uk_mmt4d_dequant_tile_f32u4f32_generic;
+    default:
+      // Shouldn't happen, validated earlier.
+      return 0;
+  }
+}
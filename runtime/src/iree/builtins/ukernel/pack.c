@@ -52,6 +52,7 @@ static void iree_uk_pack_validate(const iree_uk_pack_params_t* params) {
 #ifdef IREE_UK_ENABLE_ASSERTS
   const iree_uk_uint32_t allflags = IREE_UK_FLAG_PACK_TRANSPOSE_INNER |
                                     IREE_UK_FLAG_PACK_TRANSPOSE_OUTER |
+                                    IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES |
                                     IREE_UK_FLAG_PACK_TYPE_MASK;
   IREE_UK_ASSERT(!(params->flags & ~allflags));
   iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_PACK_TYPE_MASK;
@@ -0,0 +1,251 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/exported_bits.h"
+#include "iree/builtins/ukernel/mmt4d_dequant_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+static float iree_mmt4d_dequant_reference_scale_to_f32(
+    uint16_t value, const iree_uk_mmt4d_dequant_params_t* params) {
+  return iree_uk_mmt4d_dequant_scale_type(params->flags) ==
+                 IREE_UK_TYPE_BFLOAT_16
+             ? iree_math_bf16_to_f32(value)
+             : iree_math_f16_to_f32(value);
+}
+
+static void iree_mmt4d_dequant_reference(
+    const iree_uk_mmt4d_dequant_params_t* params) {
+  const float* lhs = (const float*)params->lhs_buffer + params->lhs_offset;
+  const uint8_t* rhs =
+      (const uint8_t*)params->rhs_buffer + params->rhs_offset / 2;
+  const uint16_t* scales =
+      (const uint16_t*)params->scales_buffer + params->scales_offset;
+  const uint16_t* zero_points =
+      (const uint16_t*)params->zero_points_buffer + params->zero_points_offset;
+  float* out = (float*)params->out_buffer + params->out_offset;
+  iree_uk_index_t M0 = params->M0;
+  iree_uk_index_t N0 = params->N0;
+  iree_uk_index_t K0 = params->K0;
+  for (iree_uk_index_t i = 0; i < params->M; ++i) {
+    for (iree_uk_index_t j = 0; j < params->N; ++j) {
+      for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+        for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+          float* out_ptr =
+              out + i * params->out_stride0 + (j * M0 + i0) * N0 + j0;
+          float acc =
+              params->flags & IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE ? *out_ptr
+                                                                    : 0.f;
+          for (iree_uk_index_t k = 0; k < params->K; ++k) {
+            iree_uk_index_t g = k * K0 / params->group_size;
+            iree_uk_index_t scale_index =
+                j * params->scales_stride0 + g * N0 + j0;
+            iree_uk_index_t zero_point_index =
+                j * params->zero_points_stride0 + g * N0 + j0;
+            float scale = iree_mmt4d_dequant_reference_scale_to_f32(
+                scales[scale_index], params);
+            float zero_point = iree_mmt4d_dequant_reference_scale_to_f32(
+                zero_points[zero_point_index], params);
+            for (iree_uk_index_t k0 = 0; k0 < K0; ++k0) {
+              float lhs_f32 =
+                  lhs[i * params->lhs_stride0 + (k * M0 + i0) * K0 + k0];
+              iree_uk_index_t rhs_index =
+                  j * params->rhs_stride0 + (k * N0 + j0) * K0 + k0;
+              uint8_t rhs_byte = rhs[rhs_index / 2];
+              float rhs_u4 =
+                  (rhs_index % 2) ? (rhs_byte >> 4) : (rhs_byte & 15);
+              acc += lhs_f32 * ((rhs_u4 - zero_point) * scale);
+            }
+          }
+          *out_ptr = acc;
+        }
+      }
+    }
+  }
+}
+
+static void iree_uk_test_mmt4d_dequant_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_mmt4d_dequant_params_t* src_params) {
+  iree_uk_mmt4d_dequant_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_type_t lhs_type = IREE_UK_TYPE_FLOAT_32;
+  iree_uk_type_t rhs_type = IREE_UK_TYPE_UINT_4;
+  iree_uk_type_t scale_type = iree_uk_mmt4d_dequant_scale_type(params.flags);
+  iree_uk_type_t out_type = IREE_UK_TYPE_FLOAT_32;
+  iree_uk_index_t groups = params.K * params.K0 / params.group_size;
+  // Randomly make strides and offsets either tight or not to exercise all
+  // cases. The u4 RHS strides and offsets have to be even.
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  params.lhs_stride0 = params.K * params.M0 * params.K0 +
+                       iree_uk_random_engine_get_0_1(engine);
+  params.rhs_stride0 = params.K * params.N0 * params.K0 +
+                       2 * iree_uk_random_engine_get_0_1(engine);
+  params.scales_stride0 =
+      groups * params.N0 + iree_uk_random_engine_get_0_1(engine);
+  params.zero_points_stride0 =
+      groups * params.N0 + iree_uk_random_engine_get_0_1(engine);
+  params.out_stride0 = params.N * params.M0 * params.N0 +
+                       iree_uk_random_engine_get_0_1(engine);
+  params.lhs_offset = iree_uk_random_engine_get_0_1(engine);
+  params.rhs_offset = 2 * iree_uk_random_engine_get_0_1(engine);
+  params.scales_offset = iree_uk_random_engine_get_0_1(engine);
+  params.zero_points_offset = iree_uk_random_engine_get_0_1(engine);
+  params.out_offset = iree_uk_random_engine_get_0_1(engine);
+
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  iree_uk_index_t scales_buffer_size =
+      iree_uk_2d_buffer_length(scale_type, params.N, params.scales_stride0);
+  iree_uk_index_t zero_points_buffer_size = iree_uk_2d_buffer_length(
+      scale_type, params.N, params.zero_points_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* scales_buffer = malloc(scales_buffer_size);
+  void* zero_points_buffer = malloc(zero_points_buffer_size);
+  void* init_out_buffer = malloc(out_buffer_size);
+  void* reference_out_buffer = malloc(out_buffer_size);
+  void* actual_out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  iree_uk_write_random_buffer(scales_buffer, scales_buffer_size, scale_type,
+                              engine);
+  iree_uk_write_random_buffer(zero_points_buffer, zero_points_buffer_size,
+                              scale_type, engine);
+  iree_uk_write_random_buffer(init_out_buffer, out_buffer_size, out_type,
+                              engine);
+  memcpy(reference_out_buffer, init_out_buffer, out_buffer_size);
+  memcpy(actual_out_buffer, init_out_buffer, out_buffer_size);
+  // The buffers allocated above start at the offsets.
+  params.lhs_buffer = (const float*)lhs_buffer - params.lhs_offset;
+  params.rhs_buffer = (const uint8_t*)rhs_buffer - params.rhs_offset / 2;
+  params.scales_buffer = (const uint16_t*)scales_buffer - params.scales_offset;
+  params.zero_points_buffer =
+      (const uint16_t*)zero_points_buffer - params.zero_points_offset;
+
+  iree_uk_mmt4d_dequant_params_t reference_params;
+  memcpy(&reference_params, &params, sizeof params);
+  reference_params.out_buffer =
+      (float*)reference_out_buffer - params.out_offset;
+  iree_uk_mmt4d_dequant_params_t actual_params;
+  memcpy(&actual_params, &params, sizeof params);
+  actual_params.out_buffer = (float*)actual_out_buffer - params.out_offset;
+
+  iree_mmt4d_dequant_reference(&reference_params);
+  iree_uk_mmt4d_dequant_p(&actual_params);
+
+  // Exact comparison, as in mmt4d_test: all test values are small integers,
+  // so all intermediate values are exactly representable.
+  bool fail = memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size);
+  if (fail) {
+    IREE_UK_TEST_FAIL(test);
+  }
+
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(scales_buffer);
+  free(zero_points_buffer);
+  free(init_out_buffer);
+  free(reference_out_buffer);
+  free(actual_out_buffer);
+}
+
+static void iree_uk_test_mmt4d_dequant_for_tile_params(iree_uk_test_t* test,
+                                                       const void* src_params) {
+  typedef struct shape_mnk_t {
+    int m, n, k;
+  } shape_mnk_t;
+  const shape_mnk_t shapes[] = {
+      // Degenerate cases.
+      {0, 1, 1},
+      {1, 0, 1},
+      {1, 1, 0},
+      {5, 7, 0},
+      // Non-degenerate cases.
+      {1, 1, 1},
+      {1, 1, 2},
+      {1, 1, 10},
+      {1, 1, 1000},
+      {2, 1, 1},
+      {1, 2, 1},
+      {2, 2, 2},
+      {5, 7, 10},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    shape_mnk_t shape = shapes[i];
+    // Number of K-steps per group: per-K-step, a few small groups, and a
+    // single group covering the whole reduction.
+    const int k_per_group_values[] = {1, 2, 5, shape.k};
+    for (int g = 0; g < IREE_ARRAYSIZE(k_per_group_values); ++g) {
+      int k_per_group = k_per_group_values[g];
+      if (k_per_group == 0 || shape.k % k_per_group) continue;
+      iree_uk_mmt4d_dequant_params_t params;
+      memcpy(&params, src_params, sizeof params);
+      params.cpu_data = iree_uk_test_cpu_data(test);
+      params.M = shape.m;
+      params.N = shape.n;
+      params.K = shape.k;
+      params.group_size = k_per_group * params.K0;
+      for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+        if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_DEQUANT_ACCUMULATE;
+        iree_uk_test_mmt4d_dequant_for_shape_params(test, &params);
+      }
+    }
+  }
+}
+
+static void iree_uk_test_mmt4d_dequant_impl(iree_uk_uint32_t flags, int M0,
+                                            int N0, int K0,
+                                            const char* cpu_features) {
+  char scale_type_str[16];
+  iree_uk_type_str(scale_type_str, sizeof scale_type_str,
+                   iree_uk_mmt4d_dequant_scale_type(flags));
+  iree_uk_mmt4d_dequant_params_t params = {
+      .flags = flags, .M0 = M0, .N0 = N0, .K0 = K0};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str,
+           "types:f32u4f32 scales:%s tile:%dx%dx%d", scale_type_str, M0, N0,
+           K0);
+  iree_uk_test(test_label_str, iree_uk_test_mmt4d_dequant_for_tile_params,
+               &params, cpu_features);
+}
+
+static void iree_uk_test_mmt4d_dequant(int M0, int N0, int K0,
+                                       const char* cpu_features) {
+  // Always allow the fallback in this test, see the comment in mmt4d_test.c.
+  const iree_uk_uint32_t types[] = {
+      IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4F16F32,
+      IREE_UK_FLAG_MMT4D_DEQUANT_TYPE_F32U4BF16F32,
+  };
+  for (int t = 0; t < IREE_ARRAYSIZE(types); ++t) {
+    iree_uk_uint32_t flags =
+        types[t] |
+        IREE_UK_FLAG_MMT4D_DEQUANT_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION;
+    for (int narrowM0 = 1; narrowM0 < M0; narrowM0 *= 2) {
+      iree_uk_test_mmt4d_dequant_impl(flags, narrowM0, N0, K0, cpu_features);
+    }
+    iree_uk_test_mmt4d_dequant_impl(flags, M0, N0, K0, cpu_features);
+  }
+}
+
+int main(int argc, char** argv) {
+  // Generic tests, not matching any particular CPU feature.
+  iree_uk_test_mmt4d_dequant(3, 5, 4, "");
+  iree_uk_test_mmt4d_dequant(8, 8, 2, "");
+
+#if defined(IREE_ARCH_X86_64)
+  iree_uk_test_mmt4d_dequant(8, 8, 2, "avx2_fma");
+  iree_uk_test_mmt4d_dequant(16, 16, 2, "avx512_base");
+#endif  // defined(IREE_ARCH_X86_64)
+
+  return iree_uk_test_exit_status();
+}
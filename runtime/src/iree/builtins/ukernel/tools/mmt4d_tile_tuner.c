@@ -0,0 +1,253 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Offline tool sweeping the mmt4d tile shapes that have optimized code paths on
+// the host CPU, and printing the fastest one for each element type as rows of
+// the table consumed by the compiler's CPU encoding materialization, see
+// compiler/src/iree/compiler/Codegen/Common/CPU/CPUEncodingTunedTiles.inc.
+//
+// Example:
+//   mmt4d_tile_tuner --cpu=znver4 >> CPUEncodingTunedTiles.inc
+//
+// The --cpu value is the LLVM CPU name that the table row will be keyed on, as
+// in --iree-llvmcpu-target-cpu. It is not detected, as the runtime CPU feature
+// detection has no notion of LLVM CPU names.
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/util.h"
+#include "iree/schemas/cpu_data.h"
+
+IREE_FLAG(string, cpu, "",
+          "LLVM CPU name to key the emitted table rows on, e.g. znver4, "
+          "icelake-server, neoverse-v1. Required.");
+IREE_FLAG(int32_t, M, 256, "M dimension size of the matmul to time.");
+IREE_FLAG(int32_t, K, 256, "K dimension size of the matmul to time.");
+IREE_FLAG(int32_t, N, 256, "N dimension size of the matmul to time.");
+IREE_FLAG(int32_t, min_duration_ms, 200,
+          "Minimum duration of the timing loop for each candidate tile.");
+
+typedef struct iree_uk_tuner_candidate_t {
+  iree_uk_uint32_t flags;
+  int M0;
+  int N0;
+  int K0;
+  // CPU features as understood by iree_uk_make_cpu_data_for_features.
+  const char* cpu_features;
+  // LLVM target feature required by the compiler to select this tile, or ""
+  // for the architecture baseline.
+  const char* llvm_feature;
+} iree_uk_tuner_candidate_t;
+
+// Candidates are grouped by element types, and within a group ordered from the
+// most to the least preferred by default. On a tie, the first one wins.
+static const iree_uk_tuner_candidate_t iree_uk_tuner_candidates[] = {
+#if defined(IREE_ARCH_ARM_64)
+    {IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "sve", "+sve"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "", ""},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 8, 8, 1, "fp16fml", "+fp16fml"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 8, 8, 1, "", ""},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 8, 8, 1, "fullfp16", "+fullfp16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 8, 8, 1, "", ""},
+    {IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 8, 8, 4, "bf16", "+bf16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 8, 8, 4, "bf16", "+bf16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 8, "i8mm", "+i8mm"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 4, "dotprod", "+dotprod"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 1, "", ""},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 4, 8, 16, "i8mm", "+i8mm"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 8, 8, 8, "dotprod", "+dotprod"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 4, 16, 2, "", ""},
+#elif defined(IREE_ARCH_X86_64)
+    {IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 16, 16, 1, "avx512_base", "+avx512f"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 8, 1, "avx2_fma", "+fma"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 16, 16, 1, "avx512_base", "+avx512f"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 8, 8, 1, "avx2_fma", "+fma"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 16, 32, 1, "avx512_fp16",
+     "+avx512fp16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 16, 16, 1, "avx512_base", "+avx512f"},
+    {IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 8, 8, 1, "avx2_fma", "+fma"},
+    {IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 16, 16, 32, "amx_bf16", "+amx-bf16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 16, 16, 2, "avx512_bf16",
+     "+avx512bf16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 16, 16, 32, "amx_bf16",
+     "+amx-bf16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 16, 16, 2, "avx512_bf16",
+     "+avx512bf16"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 16, 16, 64, "amx_int8", "+amx-int8"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 16, 16, 2, "avx512_vnni",
+     "+avx512vnni"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 16, 16, 2, "avx512_base", "+avx512bw"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 2, "avx2_fma", "+avx2"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 16, 16, 2, "avx512_vnni",
+     "+avx512vnni"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 16, 16, 2, "avx512_base", "+avx512bw"},
+    {IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 8, 8, 2, "avx2_fma", "+avx2"},
+#endif  // defined(IREE_ARCH_ARM_64)
+};
+
+// Prints `type` the way MLIR spells it, which is how the compiler-side table
+// is keyed. Signed and signless integers are both spelled "iN", as the
+// compiler only deals in signless integers for these matmuls.
+static const char* iree_uk_tuner_mlir_type_str(char* buf, int buf_length,
+                                               iree_uk_type_t type) {
+  int bits = iree_uk_type_bit_count(type);
+  if (iree_uk_type_category(type) == IREE_UK_TYPE_CATEGORY_FLOAT_BRAIN) {
+    snprintf(buf, buf_length, "bf%d", bits);
+  } else if (iree_uk_type_category(type) == IREE_UK_TYPE_CATEGORY_FLOAT_IEEE) {
+    snprintf(buf, buf_length, "f%d", bits);
+  } else if (iree_uk_type_category(type) ==
+             IREE_UK_TYPE_CATEGORY_INTEGER_UNSIGNED) {
+    snprintf(buf, buf_length, "ui%d", bits);
+  } else {
+    snprintf(buf, buf_length, "i%d", bits);
+  }
+  return buf;
+}
+
+// Returns whether the host has architecture-specific tile functions for this
+// candidate and all of its power-of-two narrowings of M0, which the compiler
+// enumerates alongside it.
+static bool iree_uk_tuner_candidate_is_available(
+    const iree_uk_tuner_candidate_t* candidate,
+    const iree_uk_uint64_t* cpu_data) {
+  if (!iree_uk_cpu_supports(cpu_data)) return false;
+  for (int M0 = 1; M0 <= candidate->M0; M0 *= 2) {
+    iree_uk_mmt4d_params_t params = {.flags = candidate->flags,
+                                     .M0 = M0,
+                                     .N0 = candidate->N0,
+                                     .K0 = candidate->K0,
+                                     .cpu_data = cpu_data};
+    if (!(iree_uk_mmt4d_info_p(&params) &
+          IREE_UK_FLAG_MMT4D_INFO_HAVE_ARCHITECTURE_SPECIFIC_TILE_FUNCTION)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the achieved rate in useful (unpadded) Gop/s of a FLAG_M x FLAG_K x
+// FLAG_N matmul using this candidate tile, so that tiles causing more padding
+// are penalized the same way as in an actual workload.
+static double iree_uk_tuner_time_candidate(
+    const iree_uk_tuner_candidate_t* candidate,
+    const iree_uk_uint64_t* cpu_data, iree_uk_random_engine_t* engine) {
+  iree_uk_uint32_t flags =
+      candidate->flags | IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+  iree_uk_mmt4d_params_t params = {
+      .flags = flags,
+      .M = (FLAG_M + candidate->M0 - 1) / candidate->M0,
+      .N = (FLAG_N + candidate->N0 - 1) / candidate->N0,
+      .K = (FLAG_K + candidate->K0 - 1) / candidate->K0,
+      .M0 = candidate->M0,
+      .N0 = candidate->N0,
+      .K0 = candidate->K0,
+      .cpu_data = cpu_data};
+  params.lhs_stride0 = params.K * params.M0 * params.K0;
+  params.rhs_stride0 = params.K * params.N0 * params.K0;
+  params.out_stride0 = params.N * params.M0 * params.N0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params.N, params.rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+  void* lhs_buffer = malloc(lhs_buffer_size);
+  void* rhs_buffer = malloc(rhs_buffer_size);
+  void* out_buffer = malloc(out_buffer_size);
+  iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+  iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+  iree_uk_write_random_buffer(out_buffer, out_buffer_size, out_type, engine);
+  params.lhs_buffer = lhs_buffer;
+  params.rhs_buffer = rhs_buffer;
+  params.out_buffer = out_buffer;
+
+  // Warm up caches and any lazily initialized state.
+  iree_uk_mmt4d_p(&params);
+  int64_t iterations = 0;
+  iree_time_t time_start = iree_time_now();
+  iree_time_t time_elapsed = 0;
+  do {
+    iree_uk_mmt4d_p(&params);
+    ++iterations;
+    time_elapsed = iree_time_now() - time_start;
+  } while (time_elapsed < FLAG_min_duration_ms * 1000000ll);
+
+  free(lhs_buffer);
+  free(rhs_buffer);
+  free(out_buffer);
+  double ops = 2.0 * FLAG_M * FLAG_N * FLAG_K * iterations;
+  return ops / time_elapsed;
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage(
+      "mmt4d_tile_tuner",
+      "Times the mmt4d tile shapes available on the host CPU and prints the "
+      "fastest one for each element type as CPUEncodingTunedTiles.inc rows.\n");
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_DEFAULT, &argc, &argv);
+  if (!strcmp(FLAG_cpu, "")) {
+    fprintf(stderr, "--cpu is required, see --help.\n");
+    return EXIT_FAILURE;
+  }
+  iree_uk_initialize_cpu_once();
+  iree_uk_random_engine_t engine = iree_uk_random_engine_init();
+
+  int count = IREE_ARRAYSIZE(iree_uk_tuner_candidates);
+  for (int group_start = 0; group_start < count;) {
+    iree_uk_uint32_t type_flags = iree_uk_tuner_candidates[group_start].flags;
+    int group_end = group_start;
+    while (group_end < count &&
+           iree_uk_tuner_candidates[group_end].flags == type_flags) {
+      ++group_end;
+    }
+    char type_str[32];
+    iree_uk_type_triple_str(type_str, sizeof type_str,
+                            iree_uk_mmt4d_type(type_flags));
+    const iree_uk_tuner_candidate_t* best = NULL;
+    double best_rate = 0;
+    for (int i = group_start; i < group_end; ++i) {
+      const iree_uk_tuner_candidate_t* candidate = &iree_uk_tuner_candidates[i];
+      iree_uk_uint64_t cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+      iree_uk_make_cpu_data_for_features(candidate->cpu_features, cpu_data);
+      if (!iree_uk_tuner_candidate_is_available(candidate, cpu_data)) continue;
+      double rate = iree_uk_tuner_time_candidate(candidate, cpu_data, &engine);
+      fprintf(stderr, "%s tile %dx%dx%d (%s): %.2f Gop/s\n", type_str,
+              candidate->M0, candidate->N0, candidate->K0,
+              candidate->cpu_features[0] ? candidate->cpu_features
+                                         : "baseline",
+              rate);
+      if (rate > best_rate) {
+        best = candidate;
+        best_rate = rate;
+      }
+    }
+    if (best) {
+      iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(type_flags);
+      char lhs_str[8], rhs_str[8], out_str[8];
+      fprintf(stdout,
+              "IREE_CPU_ENCODING_TUNED_MATMUL_TILE(\"%s\", \"%s\", \"%s\", "
+              "\"%s\", %d, %d, %d, \"%s\")\n",
+              FLAG_cpu,
+              iree_uk_tuner_mlir_type_str(lhs_str, sizeof lhs_str,
+                                          iree_uk_mmt4d_lhs_type(mmt4d_type)),
+              iree_uk_tuner_mlir_type_str(rhs_str, sizeof rhs_str,
+                                          iree_uk_mmt4d_rhs_type(mmt4d_type)),
+              iree_uk_tuner_mlir_type_str(out_str, sizeof out_str,
+                                          iree_uk_mmt4d_out_type(mmt4d_type)),
+              best->M0, best->N0, best->K0, best->llvm_feature);
+    }
+    group_start = group_end;
+  }
+  return EXIT_SUCCESS;
+}
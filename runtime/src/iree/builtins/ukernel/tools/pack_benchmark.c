@@ -73,7 +73,11 @@ static iree_status_t iree_uk_benchmark_pack(
   iree_uk_index_t out_buffer_size =
       iree_uk_2d_buffer_length(out_type, params.out_size0, params.out_stride0);
   void* in_buffer = malloc(in_buffer_size);
-  void* out_buffer = malloc(out_buffer_size);
+  // Align the output buffer to a cache line so that the non-temporal store
+  // paths, which require aligned destinations, are actually taken.
+  void* out_allocation = malloc(out_buffer_size + 64);
+  void* out_buffer =
+      (void*)(((uintptr_t)out_allocation + 63) & ~(uintptr_t)63);
   iree_uk_random_engine_t* engine = iree_uk_benchmark_random_engine(user_data);
   // It's just about plausible that on some platform, for some number type,
   // performance might be different on zero buffers vs random buffers. But it
@@ -96,11 +100,12 @@ static iree_status_t iree_uk_benchmark_pack(
   }
   // Report bytes per second, so that can be easily compared to known memory
   // system performance metrics (e.g. RAM bandwidth, to tell whether this is
-  // memory-bound).
+  // memory-bound). Like the memcpy benchmark, this counts the bytes written,
+  // so the two are directly comparable at equal --working_set_size.
   iree_benchmark_set_bytes_processed(benchmark_state,
                                      total_iterations * out_buffer_size);
   free(in_buffer);
-  free(out_buffer);
+  free(out_allocation);
   return iree_ok_status();
 }
 
@@ -122,6 +127,11 @@ static void iree_uk_benchmark_register_pack(iree_uk_uint32_t flags,
       {"trouter", IREE_UK_FLAG_PACK_TRANSPOSE_OUTER},
       {"trboth",
        IREE_UK_FLAG_PACK_TRANSPOSE_INNER | IREE_UK_FLAG_PACK_TRANSPOSE_OUTER},
+      // Non-temporal stores only pay off once the working set exceeds the
+      // cache, so compare these against memcpy at large --working_set_size.
+      {"trnone_nt", IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES},
+      {"trouter_nt", IREE_UK_FLAG_PACK_TRANSPOSE_OUTER |
+                         IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES},
   };
   for (int i = 0; i < IREE_ARRAYSIZE(variants); ++i) {
     pack_variant_t variant = variants[i];
@@ -170,6 +180,20 @@ int main(int argc, char** argv) {
                                   "avx2_fma");
   iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 16, 16,
                                   "avx512_base");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 16, 64,
+                                  "avx512_base");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 16, 32,
+                                  "avx512_base");
+#elif defined(IREE_ARCH_RISCV_64)
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1, "rvv");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 1, "rvv");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8, "rvv");
+#elif defined(IREE_ARCH_WASM_32)
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1,
+                                  "simd128");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 1, "simd128");
+  iree_uk_benchmark_register_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8,
+                                  "simd128");
 #else   // defined(IREE_ARCH_ARM_64)
   // Architectures on which we do not have any optimized ukernel code.
   // Benchmark some arbitrary tile shape.
@@ -201,9 +201,11 @@ static void iree_uk_test_pack(iree_uk_uint32_t flags, int tile_size0,
   char types_str[32];
   iree_uk_pack_type_t type = iree_uk_pack_type(flags);
   iree_uk_type_pair_str(types_str, sizeof types_str, type);
+  const char* nontemporal_str =
+      (flags & IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES) ? " nontemporal" : "";
   char test_label_str[256];
-  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%d",
-           types_str, tile_size0, tile_size1);
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%d%s",
+           types_str, tile_size0, tile_size1, nontemporal_str);
   iree_uk_test(test_label_str, iree_uk_test_pack_for_tile_params, &params,
                cpu_features);
 }
@@ -221,6 +223,9 @@ int main(int argc, char** argv) {
 #if defined(IREE_ARCH_ARM_64)
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1, "");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 8, "");
+  iree_uk_test_pack(
+      IREE_UK_FLAG_PACK_TYPE_F32F32 | IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES, 8,
+      8, "");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 1, "");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8, "");
   // Tile size selected with CPU feature dotprod.
@@ -233,13 +238,32 @@ int main(int argc, char** argv) {
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1, "avx2_fma");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 2, "avx2_fma");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 8, "avx2_fma");
+  iree_uk_test_pack(
+      IREE_UK_FLAG_PACK_TYPE_F32F32 | IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES, 8,
+      8, "avx2_fma");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8, "avx2_fma");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 16, 1, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 16, 2, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 16, 2, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 16, 16, "avx512_base");
+  iree_uk_test_pack(
+      IREE_UK_FLAG_PACK_TYPE_F32F32 | IREE_UK_FLAG_PACK_NON_TEMPORAL_STORES, 16,
+      16, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 16, 16, "avx512_base");
   // avx512_vnni uses the same tile size and same pack code as avx512_base.
+  // AMX tiles are packed with avx512_base code.
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 16, 64, "avx512_base");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_BF16BF16, 16, 32, "avx512_base");
+#elif defined(IREE_ARCH_RISCV_64)
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1, "rvv");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 1, "rvv");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 8, "rvv");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8, "rvv");
+#elif defined(IREE_ARCH_WASM_32)
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1, "simd128");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 1, "simd128");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 8, "simd128");
+  iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8, "simd128");
 #endif  // defined(IREE_ARCH_ARM_64)
 
   return iree_uk_test_exit_status();
@@ -67,6 +67,30 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_statistics_format(
       statistics->device_bytes_freed,
       (statistics->device_bytes_allocated - statistics->device_bytes_freed)));
 
+  if (statistics->pool_hits || statistics->pool_misses) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        "      POOLED: %12" PRIu64 "  hits / %12" PRIu64
+        "  misses / %12" PRIdsz "B reserved / %12" PRIdsz
+        "B used / %12" PRIdsz "B requested\n",
+        statistics->pool_hits, statistics->pool_misses,
+        statistics->pool_bytes_reserved, statistics->pool_bytes_used,
+        statistics->pool_bytes_requested));
+  }
+
+  // Attribution of memory by allocation tag; tags never used are omitted.
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(statistics->tags); ++i) {
+    const iree_hal_allocator_tag_statistics_t* tag_statistics =
+        &statistics->tags[i];
+    if (!tag_statistics->bytes_peak) continue;
+    iree_string_view_t tag_name =
+        iree_hal_allocation_tag_name((iree_hal_allocation_tag_t)i);
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%12.*s: %12" PRIdsz "B peak / %12" PRIdsz "B live\n",
+        (int)tag_name.size, tag_name.data, tag_statistics->bytes_peak,
+        tag_statistics->bytes_live));
+  }
+
 #else
   // No-op when disabled.
 #endif  // IREE_STATISTICS_ENABLE
@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/resource.h"
 
@@ -131,6 +132,12 @@ typedef struct iree_hal_buffer_params_t {
   // If 0 then the alignment will be decided by the allocator based on optimal
   // device parameters.
   iree_device_size_t min_alignment;
+
+  // Class of program resource the allocation backs used to attribute memory
+  // in allocator statistics. Does not influence placement.
+  //
+  // If 0 then the allocation is counted as IREE_HAL_ALLOCATION_TAG_UNKNOWN.
+  iree_hal_allocation_tag_t tag;
 } iree_hal_buffer_params_t;
 
 // Canonicalizes |params| fields when zero initialization is used.
@@ -268,14 +275,19 @@ typedef enum iree_hal_external_buffer_type_e {
   // The handle supports dup, dup2, close, and transport using the SCM_RIGHTS
   // control message. All other usage with system APIs is undefined.
   // An imported/exported handle owns a reference to the underlying allocator
-  // memory. May only be shared with the same underlying driver and device
+  // memory. May only be shared with the same underlying driver and device.
+  // The caller retains ownership of the file descriptor passed on import and
+  // may close it as soon as the import returns.
   //
   // CUDA:
   //  Requires device support.
   //  Uses CU_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD.
   //
+  // HIP:
+  //  Uses hipExternalMemoryHandleTypeOpaqueFd.
+  //
   // Vulkan:
-  //  Requires device support.
+  //  Requires VK_KHR_external_memory_fd.
   //  Uses VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT.
   IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_FD,
 
@@ -294,16 +306,37 @@ typedef enum iree_hal_external_buffer_type_e {
   //  Uses VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT.
   IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_WIN32,
 
+  // A Linux dma-buf file descriptor as produced by DRM/V4L2/other drivers.
+  // Unlike OPAQUE_FD the memory may come from any device or driver supporting
+  // dma-buf sharing (cameras, video decoders, other GPUs).
+  // An imported handle owns a reference to the underlying memory. The caller
+  // retains ownership of the file descriptor passed on import and may close it
+  // as soon as the import returns.
+  //
+  // HIP:
+  //  Imported as hipExternalMemoryHandleTypeOpaqueFd; ROCm resolves opaque
+  //  file descriptors through its dma-buf interop path.
+  //
+  // Vulkan:
+  //  Requires VK_EXT_external_memory_dma_buf.
+  //  Uses VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT.
+  IREE_HAL_EXTERNAL_BUFFER_TYPE_DMA_BUF,
+
   // TODO(benvanik): additional memory types:
   //  shared memory fd (shmem)/mapped file
   //  VkBuffer?
-  //  VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT
   //  VK_EXTERNAL_MEMORY_HANDLE_TYPE_ANDROID_HARDWARE_BUFFER_BIT_ANDROID
 } iree_hal_external_buffer_type_t;
 
 // Flags for controlling iree_hal_external_buffer_t implementation details.
 enum iree_hal_external_buffer_flag_bits_t {
   IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE = 0u,
+
+  // The handle references a dedicated allocation containing only this buffer.
+  // Some implementations require this to be declared when importing memory
+  // that was exported from a dedicated allocation (for example Vulkan memory
+  // allocated with VkMemoryDedicatedAllocateInfo).
+  IREE_HAL_EXTERNAL_BUFFER_FLAG_DEDICATED = 1u << 0,
 };
 typedef uint32_t iree_hal_external_buffer_flags_t;
 
@@ -349,6 +382,10 @@ typedef struct iree_hal_external_buffer_t {
     struct {
       void* handle;
     } opaque_win32;
+    // IREE_HAL_EXTERNAL_BUFFER_TYPE_DMA_BUF
+    struct {
+      int fd;
+    } dma_buf;
   } handle;
 } iree_hal_external_buffer_t;
 
@@ -356,6 +393,14 @@ typedef struct iree_hal_external_buffer_t {
 // Statistics/reporting
 //===----------------------------------------------------------------------===//
 
+// Allocation statistics for a single iree_hal_allocation_tag_t.
+typedef struct iree_hal_allocator_tag_statistics_t {
+  // Bytes held by live allocations with the tag.
+  iree_device_size_t bytes_live;
+  // High water mark of |bytes_live|.
+  iree_device_size_t bytes_peak;
+} iree_hal_allocator_tag_statistics_t;
+
 // Aggregate allocation statistics.
 typedef struct iree_hal_allocator_statistics_t {
 #if IREE_STATISTICS_ENABLE
@@ -365,6 +410,21 @@ typedef struct iree_hal_allocator_statistics_t {
   iree_device_size_t device_bytes_peak;
   iree_device_size_t device_bytes_allocated;
   iree_device_size_t device_bytes_freed;
+  // Allocations serviced by an allocator pool from memory it already held.
+  uint64_t pool_hits;
+  // Pooled allocations that required new memory from the underlying source.
+  uint64_t pool_misses;
+  // Total bytes pools have reserved from the underlying source.
+  iree_device_size_t pool_bytes_reserved;
+  // Bytes of reserved pool memory assigned to live allocations including any
+  // size class rounding. The remainder of |pool_bytes_reserved| is free.
+  iree_device_size_t pool_bytes_used;
+  // Bytes requested by live pooled allocations. The difference from
+  // |pool_bytes_used| is lost to internal fragmentation.
+  iree_device_size_t pool_bytes_requested;
+  // Live and peak bytes attributed to each iree_hal_allocation_tag_t across
+  // all heaps. Peaks are tracked per tag and may not have been concurrent.
+  iree_hal_allocator_tag_statistics_t tags[IREE_HAL_ALLOCATION_TAG_COUNT];
   // TODO(benvanik): mapping information (discarded, mapping ranges,
   //                 flushed/invalidated, etc).
 #else
@@ -524,6 +584,22 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_export_buffer(
 // iree_hal_heap_allocator_t
 //===----------------------------------------------------------------------===//
 
+// Parameters configuring an iree_hal_heap_allocator_t.
+// Must be initialized with iree_hal_heap_allocator_params_initialize prior to
+// use.
+typedef struct iree_hal_heap_allocator_params_t {
+  // Controls whether the storage of large buffers is backed by huge pages.
+  // Reduces TLB misses when streaming through large weights and activations.
+  iree_memory_huge_page_mode_t huge_page_mode;
+  // Minimum size, in bytes, of buffers backed by huge pages when enabled.
+  // 0 selects the huge page size.
+  iree_device_size_t huge_page_min_size;
+} iree_hal_heap_allocator_params_t;
+
+// Initializes |out_params| to default values (huge pages disabled).
+IREE_API_EXPORT void iree_hal_heap_allocator_params_initialize(
+    iree_hal_heap_allocator_params_t* out_params);
+
 // Creates a host-local heap allocator that can be used when buffers are
 // required that will not interact with a real hardware device (such as those
 // used in file IO or tests). Buffers allocated with this will not be compatible
@@ -537,6 +613,16 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
 
+// Creates a host-local heap allocator as with iree_hal_allocator_create_heap
+// using the given |params|. When huge pages are enabled buffers of at least
+// the minimum huge page size have their storage mapped directly from the
+// system and all other buffers use |data_allocator|.
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_with_params(
+    iree_string_view_t identifier,
+    const iree_hal_heap_allocator_params_t* params,
+    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t implementation details
 //===----------------------------------------------------------------------===//
@@ -599,10 +685,37 @@ IREE_API_EXPORT void iree_hal_allocator_deallocate_buffer(
 
 #if IREE_STATISTICS_ENABLE
 
-// Records a buffer allocation to |statistics|.
+// Records an allocation of |allocation_size| bytes attributed to |tag| in the
+// |tag_statistics| array of IREE_HAL_ALLOCATION_TAG_COUNT entries.
+static inline void iree_hal_allocator_statistics_record_tag_alloc(
+    iree_hal_allocator_tag_statistics_t* tag_statistics,
+    iree_hal_allocation_tag_t tag, iree_device_size_t allocation_size) {
+  if (tag >= IREE_HAL_ALLOCATION_TAG_COUNT) {
+    tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
+  }
+  tag_statistics[tag].bytes_live += allocation_size;
+  tag_statistics[tag].bytes_peak =
+      iree_max(tag_statistics[tag].bytes_peak, tag_statistics[tag].bytes_live);
+}
+
+// Records a deallocation of |allocation_size| bytes attributed to |tag| in the
+// |tag_statistics| array of IREE_HAL_ALLOCATION_TAG_COUNT entries.
+static inline void iree_hal_allocator_statistics_record_tag_free(
+    iree_hal_allocator_tag_statistics_t* tag_statistics,
+    iree_hal_allocation_tag_t tag, iree_device_size_t allocation_size) {
+  if (tag >= IREE_HAL_ALLOCATION_TAG_COUNT) {
+    tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
+  }
+  tag_statistics[tag].bytes_live -= allocation_size;
+}
+
+// Records a buffer allocation attributed to |tag| to |statistics|.
 static inline void iree_hal_allocator_statistics_record_alloc(
     iree_hal_allocator_statistics_t* statistics,
-    iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size) {
+    iree_hal_memory_type_t memory_type, iree_hal_allocation_tag_t tag,
+    iree_device_size_t allocation_size) {
+  iree_hal_allocator_statistics_record_tag_alloc(statistics->tags, tag,
+                                                 allocation_size);
   if (iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_LOCAL)) {
     statistics->host_bytes_allocated += allocation_size;
     statistics->host_bytes_peak =
@@ -616,10 +729,13 @@ static inline void iree_hal_allocator_statistics_record_alloc(
   }
 }
 
-// Records a buffer deallocation to |statistics|.
+// Records a buffer deallocation attributed to |tag| to |statistics|.
 static inline void iree_hal_allocator_statistics_record_free(
     iree_hal_allocator_statistics_t* statistics,
-    iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size) {
+    iree_hal_memory_type_t memory_type, iree_hal_allocation_tag_t tag,
+    iree_device_size_t allocation_size) {
+  iree_hal_allocator_statistics_record_tag_free(statistics->tags, tag,
+                                                allocation_size);
   if (iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_LOCAL)) {
     statistics->host_bytes_freed += allocation_size;
   } else {
@@ -628,6 +744,8 @@ static inline void iree_hal_allocator_statistics_record_free(
 }
 
 #else
+#define iree_hal_allocator_statistics_record_tag_alloc(tag_statistics, ...)
+#define iree_hal_allocator_statistics_record_tag_free(tag_statistics, ...)
 #define iree_hal_allocator_statistics_record_alloc(statistics, ...)
 #define iree_hal_allocator_statistics_record_free(statistics, ...)
 #endif  // IREE_STATISTICS_ENABLE
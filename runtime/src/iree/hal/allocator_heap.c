@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/hal/allocator.h"
@@ -17,6 +18,11 @@ typedef struct iree_hal_heap_allocator_t {
   iree_allocator_t host_allocator;
   iree_allocator_t data_allocator;
   iree_string_view_t identifier;
+  // Allocator used for buffer storage of at least huge_page_min_size bytes
+  // when huge pages are enabled.
+  bool use_huge_pages;
+  iree_device_size_t huge_page_min_size;
+  iree_memory_huge_page_allocator_t huge_page_allocator;
   IREE_STATISTICS(iree_hal_heap_allocator_statistics_t statistics;)
 } iree_hal_heap_allocator_t;
 
@@ -27,9 +33,28 @@ iree_hal_heap_allocator_t* iree_hal_heap_allocator_cast(
   return (iree_hal_heap_allocator_t*)base_value;
 }
 
+IREE_API_EXPORT void iree_hal_heap_allocator_params_initialize(
+    iree_hal_heap_allocator_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->huge_page_mode = IREE_MEMORY_HUGE_PAGE_MODE_NONE;
+  out_params->huge_page_min_size = 0;
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  iree_hal_heap_allocator_params_t params;
+  iree_hal_heap_allocator_params_initialize(&params);
+  return iree_hal_allocator_create_heap_with_params(
+      identifier, &params, data_allocator, host_allocator, out_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_with_params(
+    iree_string_view_t identifier,
+    const iree_hal_heap_allocator_params_t* params,
+    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
+  IREE_ASSERT_ARGUMENT(params);
   IREE_ASSERT_ARGUMENT(out_allocator);
   *out_allocator = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -48,6 +73,27 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
         identifier, &allocator->identifier,
         (char*)allocator + iree_sizeof_struct(*allocator));
 
+    if (params->huge_page_mode != IREE_MEMORY_HUGE_PAGE_MODE_NONE) {
+      // Small buffers bypass the huge page allocator entirely so it only sees
+      // requests it should map.
+      iree_memory_huge_page_allocator_params_t huge_page_params = {
+          .mode = params->huge_page_mode,
+          .min_byte_length = 1,
+      };
+      iree_memory_huge_page_allocator_initialize(
+          &huge_page_params, data_allocator, &allocator->huge_page_allocator);
+      allocator->use_huge_pages = allocator->huge_page_allocator.mode !=
+                                  IREE_MEMORY_HUGE_PAGE_MODE_NONE;
+      allocator->huge_page_min_size =
+          params->huge_page_min_size
+              ? params->huge_page_min_size
+              : allocator->huge_page_allocator.huge_page_size;
+      if (!allocator->use_huge_pages) {
+        iree_memory_huge_page_allocator_deinitialize(
+            &allocator->huge_page_allocator);
+      }
+    }
+
     IREE_STATISTICS({
       // All start initialized to zero.
       iree_slim_mutex_initialize(&allocator->statistics.mutex);
@@ -69,6 +115,11 @@ static void iree_hal_heap_allocator_destroy(
 
   IREE_STATISTICS(iree_slim_mutex_deinitialize(&allocator->statistics.mutex));
 
+  if (allocator->use_huge_pages) {
+    iree_memory_huge_page_allocator_deinitialize(
+        &allocator->huge_page_allocator);
+  }
+
   iree_allocator_free(host_allocator, allocator);
 
   IREE_TRACE_ZONE_END(z0);
@@ -197,9 +248,17 @@ static iree_status_t iree_hal_heap_allocator_allocate_buffer(
   iree_hal_heap_allocator_statistics_t* statistics = NULL;
   IREE_STATISTICS(statistics = &allocator->statistics);
   iree_hal_buffer_t* buffer = NULL;
-  IREE_RETURN_IF_ERROR(iree_hal_heap_buffer_create(
-      base_allocator, statistics, &compat_params, allocation_size,
-      allocator->data_allocator, allocator->host_allocator, &buffer));
+  if (allocator->use_huge_pages &&
+      allocation_size >= allocator->huge_page_min_size) {
+    IREE_RETURN_IF_ERROR(iree_hal_heap_buffer_create_paged(
+        base_allocator, statistics, &compat_params, allocation_size,
+        iree_memory_huge_page_allocator(&allocator->huge_page_allocator),
+        allocator->host_allocator, &buffer));
+  } else {
+    IREE_RETURN_IF_ERROR(iree_hal_heap_buffer_create(
+        base_allocator, statistics, &compat_params, allocation_size,
+        allocator->data_allocator, allocator->host_allocator, &buffer));
+  }
 
   *out_buffer = buffer;
   return iree_ok_status();
@@ -118,6 +118,24 @@ IREE_API_EXPORT iree_string_view_t iree_hal_buffer_usage_format(
       iree_hal_buffer_usage_mappings, out_temp);
 }
 
+IREE_API_EXPORT iree_string_view_t
+iree_hal_allocation_tag_name(iree_hal_allocation_tag_t tag) {
+  switch (tag) {
+    case IREE_HAL_ALLOCATION_TAG_CONSTANT:
+      return IREE_SV("constant");
+    case IREE_HAL_ALLOCATION_TAG_VARIABLE:
+      return IREE_SV("variable");
+    case IREE_HAL_ALLOCATION_TAG_TRANSIENT:
+      return IREE_SV("transient");
+    case IREE_HAL_ALLOCATION_TAG_EXTERNAL:
+      return IREE_SV("external");
+    case IREE_HAL_ALLOCATION_TAG_STAGING:
+      return IREE_SV("staging");
+    default:
+      return IREE_SV("unknown");
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // Subspan indirection buffer
 //===----------------------------------------------------------------------===//
@@ -242,11 +260,13 @@ IREE_API_EXPORT void iree_hal_buffer_initialize(
   buffer->memory_type = memory_type;
   buffer->allowed_access = allowed_access;
   buffer->allowed_usage = allowed_usage;
+  buffer->allocation_tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
 
   // Retain the base allocated buffer if it's unique from the buffer we are
-  // initializing.
+  // initializing. Subspans are attributed the same as the allocation.
   if (allocated_buffer != buffer) {
     iree_hal_buffer_retain(buffer->allocated_buffer);
+    buffer->allocation_tag = allocated_buffer->allocation_tag;
   }
 }
 
@@ -493,6 +513,15 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_subspan(
     iree_hal_buffer_t* buffer, iree_device_size_t byte_offset,
     iree_device_size_t byte_length, iree_hal_buffer_t** out_buffer) {
   IREE_ASSERT_ARGUMENT(buffer);
+  return iree_hal_buffer_subspan_with_allocator(
+      buffer, byte_offset, byte_length, buffer->host_allocator, out_buffer);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_buffer_subspan_with_allocator(
+    iree_hal_buffer_t* buffer, iree_device_size_t byte_offset,
+    iree_device_size_t byte_length, iree_allocator_t host_allocator,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(buffer);
   IREE_ASSERT_ARGUMENT(out_buffer);
   *out_buffer = NULL;
 
@@ -514,13 +543,14 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_subspan(
   iree_hal_buffer_t* allocated_buffer =
       iree_hal_buffer_allocated_buffer(buffer);
   if (allocated_buffer != buffer) {
-    return iree_hal_buffer_subspan(allocated_buffer, byte_offset, byte_length,
-                                   out_buffer);
+    return iree_hal_buffer_subspan_with_allocator(
+        allocated_buffer, byte_offset, byte_length, host_allocator,
+        out_buffer);
   }
 
   return iree_hal_subspan_buffer_create(buffer, byte_offset, byte_length,
                                         /*device_allocator=*/NULL,
-                                        buffer->host_allocator, out_buffer);
+                                        host_allocator, out_buffer);
 }
 
 IREE_API_EXPORT iree_hal_buffer_t* iree_hal_buffer_allocated_buffer(
@@ -554,6 +584,13 @@ iree_hal_memory_type_t iree_hal_buffer_memory_type(
   return buffer->memory_type;
 }
 
+IREE_API_EXPORT
+iree_hal_allocation_tag_t iree_hal_buffer_allocation_tag(
+    const iree_hal_buffer_t* buffer) {
+  IREE_ASSERT_ARGUMENT(buffer);
+  return (iree_hal_allocation_tag_t)buffer->allocation_tag;
+}
+
 IREE_API_EXPORT
 iree_hal_memory_access_t iree_hal_buffer_allowed_access(
     const iree_hal_buffer_t* buffer) {
@@ -388,6 +388,30 @@ enum iree_hal_buffer_usage_bits_t {
 };
 typedef uint32_t iree_hal_buffer_usage_t;
 
+// Identifies the class of program resource an allocation backs.
+// Tags are used to attribute memory in allocator statistics and do not change
+// allocation behavior. Values match the HAL compiler AllocationTag enum.
+typedef enum iree_hal_allocation_tag_e {
+  // Allocation is not attributed to any particular class of resource.
+  IREE_HAL_ALLOCATION_TAG_UNKNOWN = 0,
+  // Immutable program constants (weights/parameters/etc).
+  IREE_HAL_ALLOCATION_TAG_CONSTANT = 1,
+  // Mutable program variables persisting across invocations (KV caches/etc).
+  IREE_HAL_ALLOCATION_TAG_VARIABLE = 2,
+  // Transient storage used only during a single invocation.
+  IREE_HAL_ALLOCATION_TAG_TRANSIENT = 3,
+  // Storage exchanged with the hosting application (inputs/outputs/etc).
+  IREE_HAL_ALLOCATION_TAG_EXTERNAL = 4,
+  // Staging storage used for transfers to and from the host.
+  IREE_HAL_ALLOCATION_TAG_STAGING = 5,
+  // Total number of allocation tags.
+  IREE_HAL_ALLOCATION_TAG_COUNT,
+} iree_hal_allocation_tag_t;
+
+// Returns a string name for the allocation |tag| (such as `constant`).
+IREE_API_EXPORT iree_string_view_t
+iree_hal_allocation_tag_name(iree_hal_allocation_tag_t tag);
+
 // Buffer overlap testing results.
 typedef enum iree_hal_buffer_overlap_e {
   // No overlap between the two buffers.
@@ -595,6 +619,15 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_subspan(
     iree_hal_buffer_t* buffer, iree_device_size_t byte_offset,
     iree_device_size_t byte_length, iree_hal_buffer_t** out_buffer);
 
+// Returns a reference to a subspan of the |buffer| as with
+// iree_hal_buffer_subspan but allocates any new subspan buffer from
+// |host_allocator| instead of the allocator of |buffer|. Useful for routing
+// the many short-lived subspans made during invocations to a pool.
+IREE_API_EXPORT iree_status_t iree_hal_buffer_subspan_with_allocator(
+    iree_hal_buffer_t* buffer, iree_device_size_t byte_offset,
+    iree_device_size_t byte_length, iree_allocator_t host_allocator,
+    iree_hal_buffer_t** out_buffer);
+
 // Retains the given |buffer| for the caller.
 IREE_API_EXPORT void iree_hal_buffer_retain(iree_hal_buffer_t* buffer);
 
@@ -627,6 +660,11 @@ IREE_API_EXPORT
 iree_hal_memory_type_t iree_hal_buffer_memory_type(
     const iree_hal_buffer_t* buffer);
 
+// Returns the allocation tag the buffer is attributed to in statistics.
+IREE_API_EXPORT
+iree_hal_allocation_tag_t iree_hal_buffer_allocation_tag(
+    const iree_hal_buffer_t* buffer);
+
 // Returns the allowed memory access modes.
 // These may be more strict than the underlying allocation, for example when the
 // buffer is exposing read-only memory that may be in mutable pages.
@@ -868,6 +906,9 @@ struct iree_hal_buffer_t {
 
   // Implementation-defined flags.
   uint16_t flags;
+  // iree_hal_allocation_tag_t the buffer is attributed to in statistics.
+  // Set by allocators when allocating and inherited by subspans.
+  uint8_t allocation_tag;
 };
 
 IREE_API_EXPORT void iree_hal_buffer_initialize(
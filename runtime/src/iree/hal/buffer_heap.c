@@ -28,6 +28,11 @@ typedef enum iree_hal_heap_buffer_storage_mode_e {
   // A user-provided buffer release callback is notified that the buffer is no
   // longer referencing the data.
   IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL = 2u,
+  // Allocated as split [metadata] and whole-page [data] from an allocator that
+  // guarantees the buffer alignment (such as a huge page allocator).
+  // The base metadata pointer must be freed with iree_allocator_free.
+  // The data storage must be freed with iree_allocator_free.
+  IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT_PAGES = 3u,
 } iree_hal_heap_buffer_storage_mode_t;
 
 typedef struct iree_hal_heap_buffer_t {
@@ -36,7 +41,8 @@ typedef struct iree_hal_heap_buffer_t {
 
   iree_byte_span_t data;
   union {
-    // Used for IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT.
+    // Used for IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT and
+    // IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT_PAGES.
     iree_allocator_t data_allocator;
     // Used for IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL.
     iree_hal_buffer_release_callback_t release_callback;
@@ -79,6 +85,36 @@ static iree_status_t iree_hal_heap_buffer_allocate_split(
   return status;
 }
 
+// Allocates a buffer with the metadata and page storage split.
+// Unlike iree_hal_heap_buffer_allocate_split the storage is requested at
+// exactly the allocation size so that page-granular allocators don't need to
+// round up to make room for alignment padding.
+static iree_status_t iree_hal_heap_buffer_allocate_split_pages(
+    iree_device_size_t allocation_size, iree_allocator_t page_allocator,
+    iree_allocator_t host_allocator, iree_hal_heap_buffer_t** out_buffer,
+    iree_byte_span_t* out_data) {
+  out_data->data_length = allocation_size;
+  uint8_t* data_ptr = 0;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(page_allocator, allocation_size,
+                                             (void**)&data_ptr));
+  if (!iree_host_size_has_alignment((iree_host_size_t)data_ptr,
+                                    IREE_HAL_HEAP_BUFFER_ALIGNMENT)) {
+    iree_allocator_free(page_allocator, data_ptr);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "page allocator returned storage not aligned to "
+                            "the minimum buffer alignment of %d",
+                            (int)IREE_HAL_HEAP_BUFFER_ALIGNMENT);
+  }
+  out_data->data = data_ptr;
+
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(**out_buffer), (void**)out_buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(page_allocator, out_data->data);
+  }
+  return status;
+}
+
 // Allocates a buffer with the metadata as a prefix to the storage.
 // This results in a single allocation per buffer but requires that both the
 // metadata and storage live together.
@@ -110,10 +146,11 @@ static iree_status_t iree_hal_heap_buffer_allocate_slab(
   return iree_ok_status();
 }
 
-iree_status_t iree_hal_heap_buffer_create(
+static iree_status_t iree_hal_heap_buffer_create_with_storage_mode(
     iree_hal_allocator_t* allocator,
     iree_hal_heap_allocator_statistics_t* statistics,
     const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_hal_heap_buffer_storage_mode_t storage_mode,
     iree_allocator_t data_allocator, iree_allocator_t host_allocator,
     iree_hal_buffer_t** out_buffer) {
   IREE_ASSERT_ARGUMENT(allocator);
@@ -121,20 +158,27 @@ iree_status_t iree_hal_heap_buffer_create(
   IREE_ASSERT_ARGUMENT(out_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // If the data and host allocators are the same we can allocate more
-  // efficiently as a large slab. Otherwise we need to allocate both the
-  // metadata and the storage independently.
-  const bool same_allocator =
-      memcmp(&data_allocator, &host_allocator, sizeof(data_allocator)) == 0;
-
   iree_hal_heap_buffer_t* buffer = NULL;
   iree_byte_span_t data = iree_make_byte_span(NULL, 0);
-  iree_status_t status =
-      same_allocator
-          ? iree_hal_heap_buffer_allocate_slab(allocation_size, host_allocator,
-                                               &buffer, &data)
-          : iree_hal_heap_buffer_allocate_split(allocation_size, data_allocator,
-                                                host_allocator, &buffer, &data);
+  iree_status_t status = iree_ok_status();
+  switch (storage_mode) {
+    case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB:
+      status = iree_hal_heap_buffer_allocate_slab(
+          allocation_size, host_allocator, &buffer, &data);
+      break;
+    case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT:
+      status = iree_hal_heap_buffer_allocate_split(
+          allocation_size, data_allocator, host_allocator, &buffer, &data);
+      break;
+    case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT_PAGES:
+      status = iree_hal_heap_buffer_allocate_split_pages(
+          allocation_size, data_allocator, host_allocator, &buffer, &data);
+      break;
+    default:
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "unsupported heap buffer storage mode");
+      break;
+  }
 
   if (iree_status_is_ok(status)) {
     iree_hal_buffer_initialize(host_allocator, allocator, &buffer->base,
@@ -143,11 +187,11 @@ iree_status_t iree_hal_heap_buffer_create(
                                &iree_hal_heap_buffer_vtable, &buffer->base);
     buffer->data = data;
 
-    if (same_allocator) {
-      buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB;
+    buffer->base.flags = storage_mode;
+    buffer->base.allocation_tag = params->tag;
+    if (storage_mode == IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB) {
       buffer->data_allocator = iree_allocator_null();
     } else {
-      buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT;
       buffer->data_allocator = data_allocator;
     }
 
@@ -156,7 +200,7 @@ iree_status_t iree_hal_heap_buffer_create(
         buffer->statistics = statistics;
         iree_slim_mutex_lock(&statistics->mutex);
         iree_hal_allocator_statistics_record_alloc(
-            &statistics->base, params->type, allocation_size);
+            &statistics->base, params->type, params->tag, allocation_size);
         iree_slim_mutex_unlock(&statistics->mutex);
       }
     });
@@ -168,6 +212,36 @@ iree_status_t iree_hal_heap_buffer_create(
   return status;
 }
 
+iree_status_t iree_hal_heap_buffer_create(
+    iree_hal_allocator_t* allocator,
+    iree_hal_heap_allocator_statistics_t* statistics,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
+    iree_hal_buffer_t** out_buffer) {
+  // If the data and host allocators are the same we can allocate more
+  // efficiently as a large slab. Otherwise we need to allocate both the
+  // metadata and the storage independently.
+  const bool same_allocator =
+      memcmp(&data_allocator, &host_allocator, sizeof(data_allocator)) == 0;
+  return iree_hal_heap_buffer_create_with_storage_mode(
+      allocator, statistics, params, allocation_size,
+      same_allocator ? IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB
+                     : IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT,
+      data_allocator, host_allocator, out_buffer);
+}
+
+iree_status_t iree_hal_heap_buffer_create_paged(
+    iree_hal_allocator_t* allocator,
+    iree_hal_heap_allocator_statistics_t* statistics,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_allocator_t page_allocator, iree_allocator_t host_allocator,
+    iree_hal_buffer_t** out_buffer) {
+  return iree_hal_heap_buffer_create_with_storage_mode(
+      allocator, statistics, params, allocation_size,
+      IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT_PAGES, page_allocator,
+      host_allocator, out_buffer);
+}
+
 iree_status_t iree_hal_heap_buffer_wrap(
     iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
@@ -219,9 +293,10 @@ static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
   IREE_STATISTICS({
     if (buffer->statistics != NULL) {
       iree_slim_mutex_lock(&buffer->statistics->mutex);
-      iree_hal_allocator_statistics_record_free(&buffer->statistics->base,
-                                                base_buffer->memory_type,
-                                                base_buffer->allocation_size);
+      iree_hal_allocator_statistics_record_free(
+          &buffer->statistics->base, base_buffer->memory_type,
+          (iree_hal_allocation_tag_t)base_buffer->allocation_tag,
+          base_buffer->allocation_size);
       iree_slim_mutex_unlock(&buffer->statistics->mutex);
     }
   });
@@ -232,6 +307,11 @@ static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
       break;
     }
     case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT: {
+      iree_allocator_free_aligned(buffer->data_allocator, buffer->data.data);
+      iree_allocator_free(host_allocator, buffer);
+      break;
+    }
+    case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT_PAGES: {
       iree_allocator_free(buffer->data_allocator, buffer->data.data);
       iree_allocator_free(host_allocator, buffer);
       break;
@@ -37,6 +37,18 @@ iree_status_t iree_hal_heap_buffer_create(
     iree_allocator_t data_allocator, iree_allocator_t host_allocator,
     iree_hal_buffer_t** out_buffer);
 
+// Allocates a new heap buffer with storage allocated from |page_allocator| at
+// exactly |allocation_size| bytes. The allocator must return storage aligned
+// to at least IREE_HAL_HEAP_BUFFER_ALIGNMENT, such as the mappings made by
+// iree_memory_huge_page_allocator_t. |host_allocator| is used for the
+// iree_hal_buffer_t metadata. |out_buffer| must be released by the caller.
+iree_status_t iree_hal_heap_buffer_create_paged(
+    iree_hal_allocator_t* allocator,
+    iree_hal_heap_allocator_statistics_t* statistics,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_allocator_t page_allocator, iree_allocator_t host_allocator,
+    iree_hal_buffer_t** out_buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -78,7 +78,8 @@ static iree_status_t iree_hal_device_transfer_and_wait(
     };
     status = iree_hal_device_queue_execute(device, IREE_HAL_QUEUE_AFFINITY_ANY,
                                            wait_semaphores, signal_semaphores,
-                                           1, &command_buffer);
+                                           1, &command_buffer,
+                                           /*binding_tables=*/NULL);
   }
   if (iree_status_is_ok(status)) {
     status = iree_hal_semaphore_wait(fence_semaphore, signal_value, timeout);
@@ -95,6 +96,15 @@ static iree_status_t iree_hal_device_transfer_and_wait(
 // iree_hal_device_transfer_range implementations
 //===----------------------------------------------------------------------===//
 
+// Returns true if |buffer| can be mapped for direct host access.
+static bool iree_hal_device_transfer_buffer_is_mappable(
+    iree_hal_buffer_t* buffer) {
+  return iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED);
+}
+
 // Generic implementation of iree_hal_device_transfer_range for when the buffers
 // are mappable. In certain implementations even if buffers are mappable it's
 // often cheaper to still use the full queue transfers: instead of wasting CPU
@@ -196,16 +206,10 @@ static iree_status_t iree_hal_device_submit_transfer_range_and_wait(
   // TODO(benvanik): check for device-local -> device-local and avoid mapping.
   bool is_source_mappable =
       !source.device_buffer ||
-      (iree_all_bits_set(iree_hal_buffer_memory_type(source.device_buffer),
-                         IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
-       iree_all_bits_set(iree_hal_buffer_allowed_usage(source.device_buffer),
-                         IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED));
+      iree_hal_device_transfer_buffer_is_mappable(source.device_buffer);
   bool is_target_mappable =
       !target.device_buffer ||
-      (iree_all_bits_set(iree_hal_buffer_memory_type(target.device_buffer),
-                         IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
-       iree_all_bits_set(iree_hal_buffer_allowed_usage(target.device_buffer),
-                         IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED));
+      iree_hal_device_transfer_buffer_is_mappable(target.device_buffer);
   if (is_source_mappable && is_target_mappable) {
     return iree_hal_device_transfer_mappable_range(
         device, source, source_offset, target, target_offset, data_length,
@@ -394,6 +398,183 @@ IREE_API_EXPORT iree_status_t iree_hal_device_transfer_d2d(
       flags, timeout);
 }
 
+//===----------------------------------------------------------------------===//
+// Batched transfer APIs
+//===----------------------------------------------------------------------===//
+
+// Writes |range| directly into its mapped target.
+static iree_status_t iree_hal_device_transfer_h2d_mapped(
+    const iree_hal_transfer_h2d_range_t* range) {
+  iree_hal_buffer_mapping_t mapping = {{0}};
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      range->target, IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE, range->target_offset,
+      range->length, &mapping));
+  memcpy(mapping.contents.data, range->source, range->length);
+  iree_status_t status = iree_ok_status();
+  if (!iree_all_bits_set(iree_hal_buffer_memory_type(range->target),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status = iree_hal_buffer_mapping_flush_range(&mapping, 0, range->length);
+  }
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+}
+
+// Uploads all |ranges| with a single command buffer submission. Ranges small
+// enough to be embedded in the command buffer are recorded as updates and the
+// remainder are packed into one staging buffer and copied from there.
+static iree_status_t iree_hal_device_transfer_h2d_submit_and_wait(
+    iree_hal_device_t* device, iree_host_size_t range_count,
+    const iree_hal_transfer_h2d_range_t** ranges, iree_timeout_t timeout) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, range_count);
+  iree_allocator_t host_allocator = iree_hal_device_host_allocator(device);
+
+  // Assign staging offsets to all ranges that don't fit in an update.
+  iree_device_size_t staging_size = 0;
+  for (iree_host_size_t i = 0; i < range_count; ++i) {
+    if (ranges[i]->length > IREE_HAL_COMMAND_BUFFER_MAX_UPDATE_SIZE) {
+      staging_size =
+          iree_device_align(staging_size, IREE_HAL_HEAP_BUFFER_ALIGNMENT) +
+          ranges[i]->length;
+    }
+  }
+
+  iree_hal_transfer_command_t* transfer_commands = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator,
+                                range_count * sizeof(*transfer_commands),
+                                (void**)&transfer_commands));
+
+  // Allocate and fill the staging buffer with one mapping.
+  iree_hal_buffer_t* staging_buffer = NULL;
+  iree_status_t status = iree_ok_status();
+  if (staging_size > 0) {
+    const iree_hal_buffer_params_t staging_params = {
+        .type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
+        .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+    };
+    status = iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device), staging_params, staging_size,
+        &staging_buffer);
+  }
+  iree_hal_buffer_mapping_t staging_mapping = {{0}};
+  if (iree_status_is_ok(status) && staging_buffer) {
+    status = iree_hal_buffer_map_range(
+        staging_buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE, 0, staging_size,
+        &staging_mapping);
+  }
+
+  // Record the transfer commands, populating the staging buffer as we go.
+  if (iree_status_is_ok(status)) {
+    iree_device_size_t staging_offset = 0;
+    for (iree_host_size_t i = 0; i < range_count; ++i) {
+      const iree_hal_transfer_h2d_range_t* range = ranges[i];
+      if (range->length <= IREE_HAL_COMMAND_BUFFER_MAX_UPDATE_SIZE) {
+        transfer_commands[i] = (iree_hal_transfer_command_t){
+            .type = IREE_HAL_TRANSFER_COMMAND_TYPE_UPDATE,
+            .update =
+                {
+                    .source_buffer = range->source,
+                    .source_offset = 0,
+                    .target_buffer = range->target,
+                    .target_offset = range->target_offset,
+                    .length = range->length,
+                },
+        };
+        continue;
+      }
+      staging_offset =
+          iree_device_align(staging_offset, IREE_HAL_HEAP_BUFFER_ALIGNMENT);
+      memcpy(staging_mapping.contents.data + staging_offset, range->source,
+             range->length);
+      transfer_commands[i] = (iree_hal_transfer_command_t){
+          .type = IREE_HAL_TRANSFER_COMMAND_TYPE_COPY,
+          .copy =
+              {
+                  .source_buffer = staging_buffer,
+                  .source_offset = staging_offset,
+                  .target_buffer = range->target,
+                  .target_offset = range->target_offset,
+                  .length = range->length,
+              },
+      };
+      staging_offset += range->length;
+    }
+  }
+  if (staging_mapping.contents.data) {
+    if (iree_status_is_ok(status) &&
+        !iree_all_bits_set(iree_hal_buffer_memory_type(staging_buffer),
+                           IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+      status = iree_hal_buffer_mapping_flush_range(&staging_mapping, 0,
+                                                   staging_size);
+    }
+    status =
+        iree_status_join(status, iree_hal_buffer_unmap_range(&staging_mapping));
+  }
+
+  // Issue all of the transfers in one submission.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_transfer_and_wait(
+        device, /*wait_semaphore=*/NULL, /*wait_value=*/0ull, range_count,
+        transfer_commands, timeout);
+  }
+
+  iree_hal_buffer_release(staging_buffer);
+  iree_allocator_free(host_allocator, transfer_commands);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_device_transfer_h2d_batch(
+    iree_hal_device_t* device, iree_host_size_t range_count,
+    const iree_hal_transfer_h2d_range_t* ranges,
+    iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(!range_count || ranges);
+  if (range_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, range_count);
+
+  // Write all mappable targets directly and gather the rest for the device.
+  // The gathered list is stored in transient host memory as the common case
+  // of all targets being mappable does not need it.
+  const iree_hal_transfer_h2d_range_t** device_ranges = NULL;
+  iree_host_size_t device_range_count = 0;
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < range_count && iree_status_is_ok(status);
+       ++i) {
+    const iree_hal_transfer_h2d_range_t* range = &ranges[i];
+    if (range->length == 0) continue;  // No-op.
+    if (!range->target) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "transfer range %" PRIhsz " has no target", i);
+      break;
+    }
+    if (iree_hal_device_transfer_buffer_is_mappable(range->target)) {
+      status = iree_hal_device_transfer_h2d_mapped(range);
+      continue;
+    }
+    if (!device_ranges) {
+      status = iree_allocator_malloc(iree_hal_device_host_allocator(device),
+                                     range_count * sizeof(*device_ranges),
+                                     (void**)&device_ranges);
+      if (!iree_status_is_ok(status)) break;
+    }
+    device_ranges[device_range_count++] = range;
+  }
+
+  if (iree_status_is_ok(status) && device_range_count > 0) {
+    status = iree_hal_device_transfer_h2d_submit_and_wait(
+        device, device_range_count, device_ranges, timeout);
+  }
+
+  iree_allocator_free(iree_hal_device_host_allocator(device), device_ranges);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_map_range implementations
 //===----------------------------------------------------------------------===//
@@ -99,6 +99,32 @@ IREE_API_EXPORT iree_status_t iree_hal_device_transfer_d2d(
     iree_device_size_t target_offset, iree_device_size_t data_length,
     iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout);
 
+// A single host->device range in a batched transfer.
+typedef struct iree_hal_transfer_h2d_range_t {
+  // Host memory to copy from containing at least |length| bytes.
+  const void* source;
+  // Device buffer to copy into.
+  iree_hal_buffer_t* target;
+  // Byte offset into |target| to copy to.
+  iree_device_size_t target_offset;
+  // Total number of bytes to copy.
+  iree_device_size_t length;
+} iree_hal_transfer_h2d_range_t;
+
+// Synchronously copies a scatter list of host |ranges| into device buffers.
+// Equivalent to calling iree_hal_device_transfer_h2d for each range but with
+// the device work for all ranges coalesced: mappable targets are written
+// directly while the remaining ranges are uploaded through a single staging
+// buffer and command buffer submission. This makes it practical to update many
+// small buffers per step without paying per-range submission overheads.
+//
+// Target ranges must not overlap; the order the ranges are written in is
+// undefined. The same ordering caveats as iree_hal_device_transfer_range apply.
+IREE_API_EXPORT iree_status_t iree_hal_device_transfer_h2d_batch(
+    iree_hal_device_t* device, iree_host_size_t range_count,
+    const iree_hal_transfer_h2d_range_t* ranges,
+    iree_hal_transfer_buffer_flags_t flags, iree_timeout_t timeout);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_map_range implementations
 //===----------------------------------------------------------------------===//
@@ -207,10 +207,12 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_create(
     }
   }
   if (binding_capacity > 0 &&
-      !iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED)) {
+      iree_all_bits_set(mode,
+                        IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION)) {
+    // Inline execution may run commands as they are recorded and before the
+    // binding table is available at submission time.
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "command buffer bindings are only supported for "
-                            "nested command buffers (today)");
+                            "inline command buffers cannot use binding tables");
   }
 
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -497,8 +497,12 @@ typedef struct iree_hal_command_buffer_t iree_hal_command_buffer_t;
 //
 // |binding_capacity| specifies the maximum number of indirect binding slots
 // available for use by iree_hal_command_buffer_push_descriptor_set commands
-// referencing the binding table. Must only be non-zero for command buffer modes
-// supporting indirect bindings.
+// referencing the binding table. Primary command buffers with indirect bindings
+// have their binding table provided each time they are submitted with
+// iree_hal_device_queue_execute and nested command buffers have theirs provided
+// by iree_hal_command_buffer_execute_commands. This allows a reusable command
+// buffer to be recorded once and executed many times with different buffers.
+// Must be zero for command buffers allowing inline execution.
 //
 // |queue_affinity| specifies the device queues the command buffer may be
 // submitted to. The queue affinity provided to iree_hal_device_queue_execute
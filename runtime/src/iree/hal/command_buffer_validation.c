@@ -498,10 +498,7 @@ iree_status_t iree_hal_command_buffer_push_descriptor_set_validation(
 
   // TODO(benvanik): validate set index.
 
-  // TODO(benvanik): allow indirect bindings on primary command buffers?
-  const bool has_binding_table =
-      iree_all_bits_set(iree_hal_command_buffer_mode(command_buffer),
-                        IREE_HAL_COMMAND_BUFFER_MODE_NESTED);
+  const bool has_binding_table = command_buffer->binding_capacity > 0;
   for (iree_host_size_t i = 0; i < binding_count; ++i) {
     const iree_hal_descriptor_set_binding_t* binding = &bindings[i];
     // TODO(benvanik): validate binding index.
@@ -550,6 +550,51 @@ TEST_P(buffer_mapping_test, MapRangeWrite) {
   iree_hal_buffer_release(buffer);
 }
 
+TEST_P(buffer_mapping_test, TransferH2DBatch) {
+  // Mix of mappable and device-only targets with both small ranges and ranges
+  // too large for command buffer updates, in varying orders.
+  iree_device_size_t small_size = 16;
+  iree_device_size_t large_size = IREE_HAL_COMMAND_BUFFER_MAX_UPDATE_SIZE + 4;
+  iree_hal_buffer_t* mapped_buffer = NULL;
+  AllocateUninitializedBuffer(large_size, &mapped_buffer);
+  iree_hal_buffer_params_t params = {0};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+  iree_hal_buffer_t* device_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_, params, large_size + small_size, &device_buffer));
+
+  std::vector<uint8_t> small_data(small_size, 0x11);
+  std::vector<uint8_t> large_data(large_size, 0x22);
+  std::vector<uint8_t> other_data(small_size, 0x33);
+  iree_hal_transfer_h2d_range_t ranges[] = {
+      {small_data.data(), device_buffer, large_size, small_size},
+      {large_data.data(), mapped_buffer, 0, large_size},
+      {large_data.data(), device_buffer, 0, large_size},
+      {other_data.data(), mapped_buffer, 4, 0},  // no-op
+  };
+  IREE_ASSERT_OK(iree_hal_device_transfer_h2d_batch(
+      device_, IREE_ARRAYSIZE(ranges), ranges,
+      IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+
+  std::vector<uint8_t> actual_data(large_size);
+  IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+      device_, mapped_buffer, 0, actual_data.data(), actual_data.size(),
+      IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+  EXPECT_THAT(actual_data, ContainerEq(large_data));
+  std::vector<uint8_t> reference_data = large_data;
+  reference_data.insert(reference_data.end(), small_data.begin(),
+                        small_data.end());
+  actual_data.resize(large_size + small_size);
+  IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+      device_, device_buffer, 0, actual_data.data(), actual_data.size(),
+      IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+  EXPECT_THAT(actual_data, ContainerEq(reference_data));
+
+  iree_hal_buffer_release(device_buffer);
+  iree_hal_buffer_release(mapped_buffer);
+}
+
 }  // namespace cts
 }  // namespace hal
 }  // namespace iree
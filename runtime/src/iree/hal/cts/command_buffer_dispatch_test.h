@@ -7,6 +7,8 @@
 #ifndef IREE_HAL_CTS_COMMAND_BUFFER_DISPATCH_TEST_H_
 #define IREE_HAL_CTS_COMMAND_BUFFER_DISPATCH_TEST_H_
 
+#include <cmath>
+
 #include "iree/base/api.h"
 #include "iree/base/string_view.h"
 #include "iree/hal/api.h"
@@ -164,6 +166,109 @@ TEST_P(command_buffer_dispatch_test, DispatchAbs) {
   CleanupExecutable();
 }
 
+TEST_P(command_buffer_dispatch_test, DispatchAbsWithBindingTable) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  iree_status_t status = iree_hal_command_buffer_create(
+      device_, /*mode=*/0,
+      IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/2, &command_buffer);
+  if (iree_status_is_unimplemented(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "binding tables not supported by the device";
+  }
+  IREE_ASSERT_OK(status);
+
+  PrepareAbsExecutable();
+
+  // Record the dispatch once with both bindings sourced from the table.
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  iree_hal_descriptor_set_binding_t descriptor_set_bindings[] = {
+      {
+          /*binding=*/0,
+          /*buffer_slot=*/0,
+          /*buffer=*/NULL,
+          /*offset=*/0,
+          IREE_WHOLE_BUFFER,
+      },
+      {
+          /*binding=*/1,
+          /*buffer_slot=*/1,
+          /*buffer=*/NULL,
+          /*offset=*/0,
+          IREE_WHOLE_BUFFER,
+      },
+  };
+  IREE_ASSERT_OK(iree_hal_command_buffer_push_descriptor_set(
+      command_buffer, pipeline_layout_, /*set=*/0,
+      IREE_ARRAYSIZE(descriptor_set_bindings), descriptor_set_bindings));
+  IREE_ASSERT_OK(iree_hal_command_buffer_dispatch(
+      command_buffer, executable_, /*entry_point=*/0,
+      /*workgroup_x=*/1, /*workgroup_y=*/1, /*workgroup_z=*/1));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  iree_hal_buffer_params_t input_params = {0};
+  input_params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  input_params.usage =
+      IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE | IREE_HAL_BUFFER_USAGE_TRANSFER;
+  iree_hal_buffer_params_t output_params = {0};
+  output_params.type =
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  output_params.usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                        IREE_HAL_BUFFER_USAGE_TRANSFER |
+                        IREE_HAL_BUFFER_USAGE_MAPPING;
+
+  // Execute the same command buffer with different buffers each submission.
+  const float input_values[] = {-2.5f, 7.0f};
+  for (float input_value : input_values) {
+    iree_hal_buffer_view_t* input_buffer_view = NULL;
+    IREE_ASSERT_OK(iree_hal_buffer_view_allocate_buffer_copy(
+        device_, device_allocator_,
+        /*shape_rank=*/0, /*shape=*/NULL, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, input_params,
+        iree_make_const_byte_span((void*)&input_value, sizeof(input_value)),
+        &input_buffer_view));
+    iree_hal_buffer_t* output_buffer = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+        device_allocator_, output_params, sizeof(float), &output_buffer));
+
+    iree_hal_buffer_binding_t bindings[] = {
+        {iree_hal_buffer_view_buffer(input_buffer_view), 0, IREE_WHOLE_BUFFER},
+        {output_buffer, 0, IREE_WHOLE_BUFFER},
+    };
+    iree_hal_buffer_binding_table_t binding_table = {
+        IREE_ARRAYSIZE(bindings),
+        bindings,
+    };
+
+    iree_hal_semaphore_t* signal_semaphore = CreateSemaphore();
+    uint64_t target_payload_value = 1ull;
+    iree_hal_semaphore_list_t signal_semaphores = {
+        /*count=*/1,
+        /*semaphores=*/&signal_semaphore,
+        /*payload_values=*/&target_payload_value,
+    };
+    IREE_ASSERT_OK(iree_hal_device_queue_execute(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_semaphores, 1, &command_buffer, &binding_table));
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(
+        signal_semaphore, target_payload_value, iree_infinite_timeout()));
+
+    float output_value = 0.0f;
+    IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+        device_, output_buffer,
+        /*source_offset=*/0, &output_value, sizeof(output_value),
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+    EXPECT_EQ(fabsf(input_value), output_value);
+
+    iree_hal_semaphore_release(signal_semaphore);
+    iree_hal_buffer_release(output_buffer);
+    iree_hal_buffer_view_release(input_buffer_view);
+  }
+
+  iree_hal_command_buffer_release(command_buffer);
+  CleanupExecutable();
+}
+
 }  // namespace cts
 }  // namespace hal
 }  // namespace iree
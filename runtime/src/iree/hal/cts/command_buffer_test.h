@@ -186,6 +186,67 @@ TEST_P(command_buffer_test, CopyWholeBuffer) {
   iree_hal_buffer_release(host_buffer);
 }
 
+// Tests that reusable command buffers observe buffer contents at the time of
+// each submission and not the time of recording.
+TEST_P(command_buffer_test, SubmitReusableMultipleTimes) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, /*mode=*/0, IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+      IREE_HAL_QUEUE_AFFINITY_ANY, /*binding_capacity=*/0, &command_buffer));
+
+  iree_hal_buffer_params_t params = {0};
+  params.type =
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  params.usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                 IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+  iree_hal_buffer_t* source_buffer = nullptr;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_, params, kDefaultAllocationSize, &source_buffer));
+  iree_hal_buffer_t* target_buffer = nullptr;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_, params, kDefaultAllocationSize, &target_buffer));
+
+  // Copy the whole source buffer and then overwrite the first 4 bytes.
+  const uint8_t update_data[4] = {0xAA, 0xBB, 0xCC, 0xDD};
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, source_buffer, /*source_offset=*/0, target_buffer,
+      /*target_offset=*/0, kDefaultAllocationSize));
+  IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+      command_buffer, IREE_HAL_EXECUTION_STAGE_TRANSFER,
+      IREE_HAL_EXECUTION_STAGE_TRANSFER, IREE_HAL_EXECUTION_BARRIER_FLAG_NONE,
+      /*memory_barrier_count=*/0, /*memory_barriers=*/NULL,
+      /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  IREE_ASSERT_OK(iree_hal_command_buffer_update_buffer(
+      command_buffer, update_data, /*source_offset=*/0, target_buffer,
+      /*target_offset=*/0, sizeof(update_data)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  for (uint8_t value : {0x11, 0x22}) {
+    std::vector<uint8_t> source_data(kDefaultAllocationSize, value);
+    IREE_ASSERT_OK(iree_hal_device_transfer_h2d(
+        device_, source_data.data(), source_buffer, 0, source_data.size(),
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+
+    IREE_ASSERT_OK(SubmitCommandBufferAndWait(command_buffer));
+
+    std::vector<uint8_t> actual_data(kDefaultAllocationSize);
+    IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+        device_, target_buffer, /*source_offset=*/0,
+        /*target_buffer=*/actual_data.data(),
+        /*data_length=*/kDefaultAllocationSize,
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+    std::vector<uint8_t> reference_data = source_data;
+    std::memcpy(reference_data.data(), update_data, sizeof(update_data));
+    EXPECT_THAT(actual_data, ContainerEq(reference_data));
+  }
+
+  // Must release the command buffer before resources used by it.
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(target_buffer);
+  iree_hal_buffer_release(source_buffer);
+}
+
 TEST_P(command_buffer_test, CopySubBuffer) {
   iree_hal_command_buffer_t* command_buffer = NULL;
   IREE_ASSERT_OK(iree_hal_command_buffer_create(
@@ -590,6 +651,91 @@ TEST_P(command_buffer_test, UpdateBufferSubspan) {
   iree_hal_buffer_release(device_buffer);
 }
 
+// Records sequences of transfers over contiguous ranges separated by barriers
+// that are both required and redundant. Implementations that rewrite command
+// streams (such as merging transfers or eliding barriers) must produce the
+// same results as executing the commands verbatim.
+TEST_P(command_buffer_test, TransferSequenceContiguousRanges) {
+  iree_device_size_t buffer_size = 16;
+  iree_hal_buffer_t* buffer_a = NULL;
+  CreateZeroedDeviceBuffer(buffer_size, &buffer_a);
+  iree_hal_buffer_t* buffer_b = NULL;
+  CreateZeroedDeviceBuffer(buffer_size, &buffer_b);
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+      /*binding_capacity=*/0, &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  auto barrier = [&]() {
+    return iree_hal_command_buffer_execution_barrier(
+        command_buffer,
+        /*source_stage_mask=*/IREE_HAL_EXECUTION_STAGE_TRANSFER,
+        /*target_stage_mask=*/IREE_HAL_EXECUTION_STAGE_TRANSFER,
+        IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, /*memory_barrier_count=*/0,
+        /*memory_barriers=*/NULL,
+        /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL);
+  };
+
+  // Fill all of A in two halves.
+  uint8_t pattern_11 = 0x11;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, buffer_a, /*target_offset=*/0, /*length=*/8,
+      &pattern_11, sizeof(pattern_11)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, buffer_a, /*target_offset=*/8, /*length=*/8,
+      &pattern_11, sizeof(pattern_11)));
+  IREE_ASSERT_OK(barrier());
+
+  // Copy all of A to B in two halves.
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, buffer_a, /*source_offset=*/0, buffer_b,
+      /*target_offset=*/0, /*length=*/8));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, buffer_a, /*source_offset=*/8, buffer_b,
+      /*target_offset=*/8, /*length=*/8));
+  IREE_ASSERT_OK(barrier());
+
+  // Overwrite the tail of B that was just copied.
+  uint8_t pattern_22 = 0x22;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, buffer_b, /*target_offset=*/12, /*length=*/4,
+      &pattern_22, sizeof(pattern_22)));
+  IREE_ASSERT_OK(barrier());
+
+  // Overwrite the head of A; independent of the preceding fill.
+  uint8_t pattern_33 = 0x33;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, buffer_a, /*target_offset=*/0, /*length=*/4,
+      &pattern_33, sizeof(pattern_33)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  IREE_ASSERT_OK(SubmitCommandBufferAndWait(command_buffer));
+
+  std::vector<uint8_t> actual_a(buffer_size);
+  IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+      device_, buffer_a, /*source_offset=*/0, actual_a.data(), actual_a.size(),
+      IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+  std::vector<uint8_t> reference_a{0x33, 0x33, 0x33, 0x33,  //
+                                   0x11, 0x11, 0x11, 0x11,  //
+                                   0x11, 0x11, 0x11, 0x11,  //
+                                   0x11, 0x11, 0x11, 0x11};
+  EXPECT_THAT(actual_a, ContainerEq(reference_a));
+  std::vector<uint8_t> actual_b(buffer_size);
+  IREE_ASSERT_OK(iree_hal_device_transfer_d2h(
+      device_, buffer_b, /*source_offset=*/0, actual_b.data(), actual_b.size(),
+      IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+  std::vector<uint8_t> reference_b{0x11, 0x11, 0x11, 0x11,  //
+                                   0x11, 0x11, 0x11, 0x11,  //
+                                   0x11, 0x11, 0x11, 0x11,  //
+                                   0x22, 0x22, 0x22, 0x22};
+  EXPECT_THAT(actual_b, ContainerEq(reference_b));
+
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(buffer_b);
+  iree_hal_buffer_release(buffer_a);
+}
+
 }  // namespace cts
 }  // namespace hal
 }  // namespace iree
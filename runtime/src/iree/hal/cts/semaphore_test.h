@@ -9,6 +9,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <thread>
 
 #include "iree/base/api.h"
@@ -17,6 +18,10 @@
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <unistd.h>
+#endif  // !IREE_PLATFORM_WINDOWS
+
 namespace iree {
 namespace hal {
 namespace cts {
@@ -378,6 +383,115 @@ TEST_P(semaphore_test, SimultaneousMultiWaitAll) {
   iree_hal_semaphore_release(semaphore2);
 }
 
+// Tests that importing an external semaphore of a type the device does not
+// support fails as unavailable. Devices without any import support must fail
+// the same way.
+TEST_P(semaphore_test, ImportUnsupportedType) {
+  iree_hal_external_semaphore_t external_semaphore;
+  memset(&external_semaphore, 0, sizeof(external_semaphore));
+  external_semaphore.type = IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_NONE;
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_UNAVAILABLE,
+      Status(iree_hal_semaphore_import(device_, &external_semaphore,
+                                       IREE_HAL_EXTERNAL_SEMAPHORE_FLAG_NONE,
+                                       &semaphore)));
+  EXPECT_EQ(NULL, semaphore);
+}
+
+// Tests that exporting a semaphore to a type it does not support fails as
+// unavailable. Semaphores without any export support must fail the same way.
+TEST_P(semaphore_test, ExportUnsupportedType) {
+  iree_hal_semaphore_t* semaphore = this->CreateSemaphore();
+
+  iree_hal_external_semaphore_t external_semaphore;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_UNAVAILABLE,
+      Status(iree_hal_semaphore_export(semaphore,
+                                       IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_NONE,
+                                       IREE_HAL_EXTERNAL_SEMAPHORE_FLAG_NONE,
+                                       &external_semaphore)));
+
+  iree_hal_semaphore_release(semaphore);
+}
+
+#if !defined(IREE_PLATFORM_WINDOWS)
+
+// Tests exporting a semaphore as an opaque fd and importing it back into the
+// same device. The imported semaphore must observe the payload of the exported
+// one and signals on either must be visible through the other.
+TEST_P(semaphore_test, ExportImportOpaqueFd) {
+  iree_hal_semaphore_t* semaphore = this->CreateSemaphore();
+
+  iree_hal_external_semaphore_t external_semaphore;
+  iree_status_t status = iree_hal_semaphore_export(
+      semaphore, IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD,
+      IREE_HAL_EXTERNAL_SEMAPHORE_FLAG_NONE, &external_semaphore);
+  if (iree_status_is_unavailable(status)) {
+    iree_status_free(status);
+    iree_hal_semaphore_release(semaphore);
+    GTEST_SKIP() << "Semaphore cannot be exported as an opaque fd";
+  }
+  IREE_ASSERT_OK(status);
+  EXPECT_EQ(IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD,
+            external_semaphore.type);
+
+  iree_hal_semaphore_t* imported_semaphore = NULL;
+  status = iree_hal_semaphore_import(device_, &external_semaphore,
+                                     IREE_HAL_EXTERNAL_SEMAPHORE_FLAG_NONE,
+                                     &imported_semaphore);
+  // The caller retains ownership of the fd passed to import.
+  close(external_semaphore.handle.opaque_fd.fd);
+  IREE_ASSERT_OK(status);
+
+  iree_hal_semaphore_compatibility_t compatibility =
+      iree_hal_device_query_semaphore_compatibility(device_,
+                                                    imported_semaphore);
+  if (iree_all_bits_set(compatibility,
+                        IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY)) {
+    IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1ull));
+    CheckSemaphoreValue(imported_semaphore, 1ull);
+    IREE_ASSERT_OK(iree_hal_semaphore_signal(imported_semaphore, 2ull));
+    CheckSemaphoreValue(semaphore, 2ull);
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(imported_semaphore, 2ull,
+                                           iree_immediate_timeout()));
+  } else {
+    // Device-only imports reject host operations; they go through the
+    // exporting semaphore instead.
+    uint64_t value = 0;
+    IREE_EXPECT_STATUS_IS(
+        IREE_STATUS_UNAVAILABLE,
+        Status(iree_hal_semaphore_query(imported_semaphore, &value)));
+    IREE_EXPECT_STATUS_IS(
+        IREE_STATUS_UNAVAILABLE,
+        Status(iree_hal_semaphore_signal(imported_semaphore, 1ull)));
+    IREE_EXPECT_STATUS_IS(
+        IREE_STATUS_UNAVAILABLE,
+        Status(iree_hal_semaphore_wait(imported_semaphore, 1ull,
+                                       iree_immediate_timeout())));
+  }
+
+  // Queue operations ordered on the imported semaphore must observe signals
+  // made through the exported one.
+  iree_hal_semaphore_t* signal_semaphore = this->CreateSemaphore();
+  uint64_t wait_value = 3ull;
+  iree_hal_semaphore_list_t wait_list = {1, &imported_semaphore, &wait_value};
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t signal_list = {1, &signal_semaphore,
+                                           &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_barrier(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, wait_list, signal_list));
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 3ull));
+  IREE_ASSERT_OK(iree_hal_semaphore_wait(signal_semaphore, 1ull,
+                                         iree_infinite_timeout()));
+
+  iree_hal_semaphore_release(signal_semaphore);
+  iree_hal_semaphore_release(imported_semaphore);
+  iree_hal_semaphore_release(semaphore);
+}
+
+#endif  // !IREE_PLATFORM_WINDOWS
+
 }  // namespace cts
 }  // namespace hal
 }  // namespace iree
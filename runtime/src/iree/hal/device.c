@@ -6,6 +6,7 @@
 
 #include "iree/hal/device.h"
 
+#include "iree/base/metrics.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/command_buffer.h"
@@ -21,6 +22,18 @@
 
 IREE_HAL_API_RETAIN_RELEASE(device);
 
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_hal_device_transfer_bytes, "iree_hal_device_transfer_bytes_total",
+    "Total number of bytes submitted in queue transfer operations.");
+
+// Records |length| bytes of queue transfer.
+// Registration is done here instead of at device creation as devices are
+// created by drivers and the cost is negligible relative to a queue operation.
+static void iree_hal_device_record_transfer(iree_device_size_t length) {
+  iree_metric_register(&iree_hal_device_transfer_bytes.base);
+  iree_metric_counter_add(&iree_hal_device_transfer_bytes, (int64_t)length);
+}
+
 IREE_API_EXPORT iree_string_view_t
 iree_hal_device_id(iree_hal_device_t* device) {
   IREE_ASSERT_ARGUMENT(device);
@@ -142,6 +155,7 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_fill(
   IREE_ASSERT_ARGUMENT(pattern);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+  iree_hal_device_record_transfer(length);
 
   // If we are starting execution immediately then we can reduce latency by
   // allowing inline command buffer execution.
@@ -171,7 +185,8 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_fill(
 
   iree_status_t status =
       iree_hal_device_queue_execute(device, queue_affinity, wait_semaphore_list,
-                                    signal_semaphore_list, 1, &command_buffer);
+                                    signal_semaphore_list, 1, &command_buffer,
+                                    /*binding_tables=*/NULL);
 
   iree_hal_command_buffer_release(command_buffer);
 
@@ -191,6 +206,7 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_copy(
   IREE_ASSERT_ARGUMENT(target_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+  iree_hal_device_record_transfer(length);
 
   // If we are starting execution immediately then we can reduce latency by
   // allowing inline command buffer execution.
@@ -220,7 +236,8 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_copy(
 
   iree_status_t status =
       iree_hal_device_queue_execute(device, queue_affinity, wait_semaphore_list,
-                                    signal_semaphore_list, 1, &command_buffer);
+                                    signal_semaphore_list, 1, &command_buffer,
+                                    /*binding_tables=*/NULL);
 
   iree_hal_command_buffer_release(command_buffer);
 
@@ -245,6 +262,7 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_read(
   IREE_ASSERT_ARGUMENT(source_file);
   IREE_ASSERT_ARGUMENT(target_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_device_record_transfer(length);
   iree_status_t status = _VTABLE_DISPATCH(device, queue_read)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
       source_file, source_offset, target_buffer, target_offset, length, flags);
@@ -269,6 +287,7 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_write(
   IREE_ASSERT_ARGUMENT(source_buffer);
   IREE_ASSERT_ARGUMENT(target_file);
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_device_record_transfer(length);
   iree_status_t status = _VTABLE_DISPATCH(device, queue_write)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
       source_buffer, source_offset, target_file, target_offset, length, flags);
@@ -281,7 +300,8 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_execute(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(
       !wait_semaphore_list.count ||
@@ -311,11 +331,25 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_execute(
           "inline command buffer submitted with a wait; inline command "
           "buffers must be ready to execute immediately");
     }
+    // Command buffers with indirect bindings must have a binding table large
+    // enough to resolve all slots they may reference.
+    const iree_host_size_t binding_capacity =
+        command_buffers[i]->binding_capacity;
+    const iree_host_size_t binding_count =
+        binding_tables ? binding_tables[i].count : 0;
+    if (IREE_UNLIKELY(binding_count < binding_capacity)) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "command_buffers[%" PRIhsz "] requires a binding table with %" PRIhsz
+          " bindings but %" PRIhsz " were provided",
+          i, binding_capacity, binding_count);
+    }
   }
 
   iree_status_t status = _VTABLE_DISPATCH(device, queue_execute)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
-      command_buffer_count, command_buffers);
+      command_buffer_count, command_buffers, binding_tables);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -329,7 +363,8 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_barrier(
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_status_t status =
       iree_hal_device_queue_execute(device, queue_affinity, wait_semaphore_list,
-                                    signal_semaphore_list, 0, NULL);
+                                    signal_semaphore_list, 0, NULL,
+                                    /*binding_tables=*/NULL);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
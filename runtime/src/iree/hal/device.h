@@ -178,6 +178,10 @@ typedef struct iree_hal_submission_batch_t {
 
   // Semaphores to signal once all command buffers have completed execution.
   iree_hal_semaphore_list_t signal_semaphores;
+
+  // Optional binding tables, one per command buffer, used to resolve indirect
+  // bindings. May be NULL if no command buffer uses indirect bindings.
+  const iree_hal_buffer_binding_table_t* binding_tables;
 } iree_hal_submission_batch_t;
 
 // Defines how a multi-wait operation treats the results of multiple semaphores.
@@ -395,6 +399,14 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_write(
 // placed on to the same queue. Note that the exact hashing function is
 // implementation dependent.
 //
+// |binding_tables| is either NULL or has one binding table per command buffer
+// in |command_buffers| used to resolve the indirect bindings recorded in it.
+// Command buffers created with a non-zero binding capacity must have a table
+// with at least that many bindings and those without may use an empty table.
+// This allows a reusable command buffer to be recorded once and then executed
+// many times with a different set of buffers each time. The buffers referenced
+// by the tables are retained until the submission has completed.
+//
 // The submission behavior matches Vulkan's vkQueueSubmit, with each submission
 // executing its command buffers in the order they are defined but allowing the
 // command buffers to complete out-of-order. See:
@@ -404,7 +416,8 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_execute(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers);
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables);
 
 // Enqueues a barrier waiting for |wait_semaphore_list| and signaling
 // |signal_semaphore_list| when reached.
@@ -571,6 +584,12 @@ typedef struct iree_hal_device_vtable_t {
   iree_status_t(IREE_API_PTR* create_semaphore)(
       iree_hal_device_t* device, uint64_t initial_value,
       iree_hal_semaphore_t** out_semaphore);
+  // Optional; devices that cannot import semaphores may leave this NULL.
+  iree_status_t(IREE_API_PTR* import_semaphore)(
+      iree_hal_device_t* device,
+      const iree_hal_external_semaphore_t* external_semaphore,
+      iree_hal_external_semaphore_flags_t flags,
+      iree_hal_semaphore_t** out_semaphore);
 
   iree_hal_semaphore_compatibility_t(
       IREE_API_PTR* query_semaphore_compatibility)(
@@ -611,7 +630,8 @@ typedef struct iree_hal_device_vtable_t {
       const iree_hal_semaphore_list_t wait_semaphore_list,
       const iree_hal_semaphore_list_t signal_semaphore_list,
       iree_host_size_t command_buffer_count,
-      iree_hal_command_buffer_t* const* command_buffers);
+      iree_hal_command_buffer_t* const* command_buffers,
+      const iree_hal_buffer_binding_table_t* binding_tables);
 
   iree_status_t(IREE_API_PTR* queue_flush)(
       iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity);
@@ -10,6 +10,7 @@
 #define IREE_HAL_DRIVERS_CUDA_API_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/threading.h"
 #include "iree/hal/api.h"
 
 #ifdef __cplusplus
@@ -42,6 +43,10 @@ typedef struct iree_hal_cuda_memory_pool_params_t {
   // When more than this is allocated the extra will be freed at the next
   // device synchronization in order to remain under the threshold.
   uint64_t release_threshold;
+  // Creates the pool with support for exporting it as a POSIX file descriptor
+  // so that allocations made from it can be shared with other processes. See
+  // iree_hal_cuda_device_export_memory_pool.
+  bool shareable;
   // TODO: per-device access permissions array.
 } iree_hal_cuda_memory_pool_params_t;
 
@@ -51,17 +56,39 @@ typedef struct iree_hal_cuda_memory_pooling_params_t {
   iree_hal_cuda_memory_pool_params_t device_local;
   // Used for any host-visible/host-local memory types.
   iree_hal_cuda_memory_pool_params_t other;
+  // Creates a separate set of pools for each queue instead of sharing one set
+  // across all queues. Isolating queues keeps allocations made on one stream
+  // from being reused by another only after cross-stream synchronization and
+  // lets each queue retain memory up to its own release threshold.
+  bool per_queue;
 } iree_hal_cuda_memory_pooling_params_t;
 
+// CUmemPoolPtrExportData exposed without exporting the CUDA headers.
+typedef struct {
+  uint8_t data[64];
+} iree_hal_cuda_memory_pool_ptr_export_data_t;
+
+// Maximum number of CUstreams backing device queues, including the dedicated
+// copy queues.
+#define IREE_HAL_CUDA_MAX_QUEUE_COUNT 16
+
 // Parameters configuring an iree_hal_cuda_device_t.
 // Must be initialized with iree_hal_cuda_device_params_initialize prior to
 // use.
 typedef struct iree_hal_cuda_device_params_t {
   // Number of queues exposed on the device.
   // Each queue acts as a separate synchronization scope where all work executes
-  // concurrently unless prohibited by semaphores.
+  // concurrently unless prohibited by semaphores. Each queue is backed by its
+  // own CUstream and queue affinity bit N selects queue N (modulo the total
+  // number of queues).
   iree_host_size_t queue_count;
 
+  // Exposes two additional queues backed by dedicated host-to-device and
+  // device-to-host copy streams after the |queue_count| dispatch queues.
+  // File reads and writes are routed to these so that transfers (such as
+  // parameter uploads) overlap with compute on the dispatch queues.
+  bool dedicated_copy_queues;
+
   // Total size of each block in the device shared block pool.
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
@@ -91,14 +118,141 @@ typedef struct iree_hal_cuda_device_params_t {
   // device. Defaults to true when the device supports it.
   bool async_allocations;
 
+  // Maximum total size in bytes of small all-reduce collectives fused into a
+  // single collective over a packed staging buffer. Fusing trades two device
+  // copies for one fewer NCCL launch per entry and helps workloads issuing
+  // many small collectives (such as tensor-parallel inference). 0 disables.
+  iree_device_size_t collective_bucket_size;
+
+  // Maximum duration to wait for collective channel communicators to be
+  // initialized. Communicators are created in nonblocking mode and channel
+  // creation fails with IREE_STATUS_DEADLINE_EXCEEDED if not all participants
+  // join before the timeout elapses. Defaults to IREE_DURATION_INFINITE.
+  iree_duration_t channel_init_timeout;
+
+  // Maximum number of dispatches retained while profiling with
+  // IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS. Older dispatches are
+  // overwritten once the capacity is reached.
+  iree_host_size_t dispatch_profile_capacity;
+
+  // Size in bytes of a persistent page-locked host staging ring used to back
+  // host-local transfer buffers such as those used by
+  // iree_hal_device_transfer_h2d/d2h and file streaming. Transfers larger than
+  // the free space in the ring fall back to allocating page-locked memory per
+  // transfer. 0 disables the ring.
+  iree_device_size_t staging_ring_capacity;
+
+  // Enables reading and writing files through GPUDirect Storage (cuFile) when
+  // the library is available. File descriptors imported as HAL files that
+  // reside on a filesystem supporting GPUDirect Storage are then transferred
+  // directly between storage and device memory instead of being streamed
+  // through host staging buffers. Other files are unaffected. Opening the
+  // cuFile driver is expensive and so this is disabled by default.
+  bool gpu_direct_storage;
+
   // Parameters for each CUmemoryPool used for queue-ordered allocations.
   iree_hal_cuda_memory_pooling_params_t memory_pools;
+
+  // Parameters of the worker thread that issues queue actions to the device
+  // once their waits have been satisfied. The name defaults to
+  // `deferque_worker` when empty and |create_suspended| is ignored. Setting
+  // |initial_affinity| and |priority_class| keeps the thread off cores
+  // reserved for other latency-sensitive work.
+  iree_thread_create_params_t worker_thread_params;
 } iree_hal_cuda_device_params_t;
 
 // Initializes |out_params| to default values.
 IREE_API_EXPORT void iree_hal_cuda_device_params_initialize(
     iree_hal_cuda_device_params_t* out_params);
 
+// Exports the memory pool used for DEVICE_LOCAL queue-ordered allocations on
+// the queue selected by |queue_affinity| as a POSIX file descriptor. The pool
+// must have been created with the device_local.shareable pooling parameter.
+// The descriptor can be passed to another process (such as over a UNIX domain
+// socket) and used with iree_hal_cuda_device_import_buffer. The caller owns the
+// returned descriptor and must close it.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_export_memory_pool(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    int* out_fd);
+
+// Exports |buffer| allocated with iree_hal_device_queue_alloca from a shareable
+// memory pool. The returned |out_export_data| can be sent to other processes
+// that have imported the pool to map the same allocation. The buffer must not
+// be deallocated until all importers have released their buffers.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_export_buffer(
+    iree_hal_device_t* device, iree_hal_buffer_t* buffer,
+    iree_hal_cuda_memory_pool_ptr_export_data_t* out_export_data);
+
+// Device timing of a single dispatch captured while profiling the device with
+// IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS.
+typedef struct iree_hal_cuda_dispatch_profile_record_t {
+  // NUL-terminated name of the kernel function, truncated if too long.
+  char function_name[64];
+  // Opaque identifier of the dispatched executable. Only meaningful for
+  // correlating dispatches of the same executable within a profile.
+  uint64_t executable_id;
+  // Export ordinal of the dispatched function within the executable.
+  uint32_t export_ordinal;
+  // XYZ workgroup (grid) count of the dispatch.
+  uint32_t workgroup_count[3];
+  // XYZ workgroup (block) size of the dispatched function.
+  uint32_t workgroup_size[3];
+  // Device execution time of the dispatch in nanoseconds.
+  uint64_t duration_ns;
+} iree_hal_cuda_dispatch_profile_record_t;
+
+// Copies up to |capacity| of the most recent dispatch profile records captured
+// by iree_hal_device_profiling_begin/end into |out_records|, oldest first.
+// |out_count| is set to the total number of records available, which may be
+// larger than |capacity|; pass a |capacity| of 0 to query the count. Pending
+// dispatches are waited on and timings are resolved before returning.
+//
+// Only dispatches issued through stream command buffers are profiled: while
+// dispatch profiling is active command buffers are recorded for stream
+// execution even if the device is configured to use CUDA graphs.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_query_dispatch_profile(
+    iree_hal_device_t* device, iree_host_size_t capacity,
+    iree_hal_cuda_dispatch_profile_record_t* out_records,
+    iree_host_size_t* out_count);
+
+// Imports an allocation exported by another process from the memory pool
+// shared as |pool_fd|. |allocation_size| must match the size of the exported
+// buffer. The returned buffer aliases the exporter's memory and keeps its own
+// reference to the imported pool; |pool_fd| is not consumed and may be reused
+// to import additional buffers.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_import_buffer(
+    iree_hal_device_t* device, int pool_fd,
+    const iree_hal_cuda_memory_pool_ptr_export_data_t* export_data,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_t
+//===----------------------------------------------------------------------===//
+
+// Occupancy of an executable export on the device it was loaded for, as
+// computed when the executable was created.
+typedef struct iree_hal_cuda_export_occupancy_t {
+  // Maximum number of blocks of the export that can be resident on a single
+  // multiprocessor at once.
+  uint32_t max_active_blocks_per_multiprocessor;
+  // Total number of threads per block.
+  uint32_t threads_per_block;
+  // Static and dynamic shared memory used per block in bytes.
+  uint32_t shared_memory_per_block;
+  // Percentage of the unified L1/shared memory reserved as shared memory
+  // (CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT) selected for the
+  // export. The smallest carveout that does not reduce occupancy is chosen so
+  // that the remainder can be used as L1 cache.
+  int32_t shared_memory_carveout;
+} iree_hal_cuda_export_occupancy_t;
+
+// Queries the occupancy of |export_ordinal| in |executable|, which must have
+// been created by a CUDA device.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_executable_query_export_occupancy(
+    iree_hal_executable_t* executable, uint32_t export_ordinal,
+    iree_hal_cuda_export_occupancy_t* out_occupancy);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_cuda_driver_t
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,174 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests CUDA devices importing timeline semaphores exported by Vulkan devices.
+// CUDA cannot export semaphores itself so this cannot be covered by the
+// single-driver CTS.
+
+#include <unistd.h>
+
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/registration/driver_module.h"
+#include "iree/hal/drivers/vulkan/registration/driver_module.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace cuda {
+namespace {
+
+class VulkanSemaphoreImportTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_driver_registry_allocate(iree_allocator_system(),
+                                                     &registry_));
+    IREE_ASSERT_OK(iree_hal_cuda_driver_module_register(registry_));
+    IREE_ASSERT_OK(iree_hal_vulkan_driver_module_register(registry_));
+    if (!TryCreateDevice("cuda", &cuda_driver_, &cuda_device_) ||
+        !TryCreateDevice("vulkan", &vulkan_driver_, &vulkan_device_)) {
+      GTEST_SKIP() << "CUDA and Vulkan devices are both required";
+    }
+  }
+
+  void TearDown() override {
+    iree_hal_device_release(vulkan_device_);
+    iree_hal_driver_release(vulkan_driver_);
+    iree_hal_device_release(cuda_device_);
+    iree_hal_driver_release(cuda_driver_);
+    iree_hal_driver_registry_free(registry_);
+  }
+
+  // Creates the default device of |driver_name|. Returns false if either the
+  // driver or the device is unavailable.
+  bool TryCreateDevice(const char* driver_name, iree_hal_driver_t** out_driver,
+                       iree_hal_device_t** out_device) {
+    iree_status_t status = iree_hal_driver_registry_try_create(
+        registry_, iree_make_cstring_view(driver_name),
+        iree_allocator_system(), out_driver);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_driver_create_default_device(
+          *out_driver, iree_allocator_system(), out_device);
+    }
+    if (iree_status_is_unavailable(status)) {
+      iree_status_free(status);
+      return false;
+    }
+    IREE_EXPECT_OK(status);
+    return *out_device != NULL;
+  }
+
+  // Imports |semaphore| exported as an opaque fd into the CUDA device.
+  // Returns NULL if either side does not support external semaphores.
+  iree_hal_semaphore_t* TryImportIntoCuda(iree_hal_semaphore_t* semaphore) {
+    iree_hal_external_semaphore_t external_semaphore;
+    iree_status_t status = iree_hal_semaphore_export(
+        semaphore, IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD,
+        IREE_HAL_EXTERNAL_SEMAPHORE_FLAG_NONE, &external_semaphore);
+    if (iree_status_is_unavailable(status)) {
+      iree_status_free(status);
+      return NULL;
+    }
+    IREE_EXPECT_OK(status);
+    if (!iree_status_is_ok(status)) return NULL;
+
+    iree_hal_semaphore_t* imported_semaphore = NULL;
+    status = iree_hal_semaphore_import(cuda_device_, &external_semaphore,
+                                       IREE_HAL_EXTERNAL_SEMAPHORE_FLAG_NONE,
+                                       &imported_semaphore);
+    // The caller retains ownership of the fd passed to import.
+    close(external_semaphore.handle.opaque_fd.fd);
+    if (iree_status_is_unavailable(status)) {
+      iree_status_free(status);
+      return NULL;
+    }
+    IREE_EXPECT_OK(status);
+    return imported_semaphore;
+  }
+
+  iree_hal_driver_registry_t* registry_ = NULL;
+  iree_hal_driver_t* cuda_driver_ = NULL;
+  iree_hal_device_t* cuda_device_ = NULL;
+  iree_hal_driver_t* vulkan_driver_ = NULL;
+  iree_hal_device_t* vulkan_device_ = NULL;
+};
+
+// Tests that imported semaphores are device-only: host query, signal, and wait
+// fail as unavailable and compatibility only reports device usage.
+TEST_F(VulkanSemaphoreImportTest, HostOperationsUnavailable) {
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(vulkan_device_, 0ull, &semaphore));
+  iree_hal_semaphore_t* imported_semaphore = TryImportIntoCuda(semaphore);
+  if (!imported_semaphore) {
+    iree_hal_semaphore_release(semaphore);
+    GTEST_SKIP() << "Vulkan semaphores cannot be imported into CUDA";
+  }
+
+  EXPECT_EQ(IREE_HAL_SEMAPHORE_COMPATIBILITY_DEVICE_WAIT |
+                IREE_HAL_SEMAPHORE_COMPATIBILITY_DEVICE_SIGNAL,
+            iree_hal_device_query_semaphore_compatibility(cuda_device_,
+                                                          imported_semaphore));
+
+  uint64_t value = 0;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_UNAVAILABLE,
+      Status(iree_hal_semaphore_query(imported_semaphore, &value)));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_UNAVAILABLE,
+      Status(iree_hal_semaphore_signal(imported_semaphore, 1ull)));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_UNAVAILABLE,
+      Status(iree_hal_semaphore_wait(imported_semaphore, 1ull,
+                                     iree_immediate_timeout())));
+
+  iree_hal_semaphore_release(imported_semaphore);
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Tests that CUDA queue operations wait on and signal imported semaphores on
+// the device and that the Vulkan semaphore observes the signal.
+TEST_F(VulkanSemaphoreImportTest, QueueWaitAndSignal) {
+  iree_hal_semaphore_t* wait_semaphore = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_create(vulkan_device_, 0ull, &wait_semaphore));
+  iree_hal_semaphore_t* signal_semaphore = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_create(vulkan_device_, 0ull, &signal_semaphore));
+  iree_hal_semaphore_t* imported_wait_semaphore =
+      TryImportIntoCuda(wait_semaphore);
+  iree_hal_semaphore_t* imported_signal_semaphore =
+      imported_wait_semaphore ? TryImportIntoCuda(signal_semaphore) : NULL;
+  if (!imported_wait_semaphore || !imported_signal_semaphore) {
+    iree_hal_semaphore_release(imported_wait_semaphore);
+    iree_hal_semaphore_release(signal_semaphore);
+    iree_hal_semaphore_release(wait_semaphore);
+    GTEST_SKIP() << "Vulkan semaphores cannot be imported into CUDA";
+  }
+
+  uint64_t value = 1ull;
+  iree_hal_semaphore_list_t wait_list = {1, &imported_wait_semaphore, &value};
+  iree_hal_semaphore_list_t signal_list = {1, &imported_signal_semaphore,
+                                           &value};
+  IREE_ASSERT_OK(iree_hal_device_queue_barrier(
+      cuda_device_, IREE_HAL_QUEUE_AFFINITY_ANY, wait_list, signal_list));
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(wait_semaphore, 1ull));
+  IREE_ASSERT_OK(iree_hal_semaphore_wait(signal_semaphore, 1ull,
+                                         iree_infinite_timeout()));
+
+  iree_hal_semaphore_release(imported_signal_semaphore);
+  iree_hal_semaphore_release(imported_wait_semaphore);
+  iree_hal_semaphore_release(signal_semaphore);
+  iree_hal_semaphore_release(wait_semaphore);
+}
+
+}  // namespace
+}  // namespace cuda
+}  // namespace hal
+}  // namespace iree
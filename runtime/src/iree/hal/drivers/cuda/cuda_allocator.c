@@ -6,12 +6,19 @@
 
 #include "iree/hal/drivers/cuda/cuda_allocator.h"
 
+#include <errno.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_status_util.h"
+#include "iree/hal/drivers/utils/staging_ring.h"
+
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <unistd.h>
+#endif  // !IREE_PLATFORM_WINDOWS
 
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
 static const char* IREE_HAL_CUDA_ALLOCATOR_ID = "CUDA unpooled";
@@ -43,6 +50,17 @@ typedef struct iree_hal_cuda_allocator_t {
   // Whether host memory can be registered with CU_MEMHOSTREGISTER_READ_ONLY.
   bool supports_read_only_host_register;
 
+  // Whether the device is integrated with the host and shares its physical
+  // memory. Device-local memory is backed by page-locked host memory mapped
+  // into the device so that the host can access it directly without staging.
+  bool is_integrated;
+
+  // Persistent page-locked host memory used for transfer staging buffers.
+  // NULL if the staging ring is disabled.
+  void* staging_host_ptr;
+  CUdeviceptr staging_device_ptr;
+  iree_hal_staging_ring_t staging_ring;
+
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
 } iree_hal_cuda_allocator_t;
 
@@ -57,7 +75,8 @@ static iree_hal_cuda_allocator_t* iree_hal_cuda_allocator_cast(
 iree_status_t iree_hal_cuda_allocator_create(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols, CUdevice device,
     CUstream stream, iree_hal_cuda_memory_pools_t* pools,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+    iree_device_size_t staging_ring_capacity, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(cuda_symbols);
   IREE_ASSERT_ARGUMENT(out_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -97,6 +116,19 @@ iree_status_t iree_hal_cuda_allocator_create(
                                       ? "has READ_ONLY_HOST_REGISTER_SUPPORTED"
                                       : "no READ_ONLY_HOST_REGISTER_SUPPORTED");
 
+  // Integrated devices (such as Tegra/Jetson) share physical memory with the
+  // host and page-locked host memory is as fast for the device to access as
+  // memory from cuMemAlloc.
+  int is_integrated = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, IREE_CURESULT_TO_STATUS(
+              cuda_symbols,
+              cuDeviceGetAttribute(&is_integrated,
+                                   CU_DEVICE_ATTRIBUTE_INTEGRATED, device),
+              "cuDeviceGetAttribute"));
+  IREE_TRACE_ZONE_APPEND_TEXT(
+      z0, is_integrated ? "INTEGRATED (unified memory)" : "discrete");
+
   iree_hal_cuda_allocator_t* allocator = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_allocator_malloc(host_allocator, sizeof(*allocator),
@@ -113,10 +145,37 @@ iree_status_t iree_hal_cuda_allocator_create(
       supports_concurrent_managed_access != 0;
   allocator->supports_read_only_host_register =
       supports_read_only_host_register != 0;
-  *out_allocator = (iree_hal_allocator_t*)allocator;
+  allocator->is_integrated = is_integrated != 0;
 
+  // Allocate the staging ring. It is not write-combined as it is used for
+  // both uploads and readbacks and host reads from write-combined memory are
+  // very slow.
+  iree_status_t status = iree_ok_status();
+  if (staging_ring_capacity > 0) {
+    iree_hal_staging_ring_initialize(staging_ring_capacity,
+                                     /*alignment=*/64,
+                                     &allocator->staging_ring);
+    status = IREE_CURESULT_TO_STATUS(
+        cuda_symbols,
+        cuMemHostAlloc(&allocator->staging_host_ptr, staging_ring_capacity,
+                       CU_MEMHOSTALLOC_DEVICEMAP),
+        "cuMemHostAlloc");
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          cuda_symbols,
+          cuMemHostGetDevicePointer(&allocator->staging_device_ptr,
+                                    allocator->staging_host_ptr, /*flags=*/0),
+          "cuMemHostGetDevicePointer");
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_allocator = (iree_hal_allocator_t*)allocator;
+  } else {
+    iree_hal_allocator_release((iree_hal_allocator_t*)allocator);
+  }
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_cuda_allocator_destroy(
@@ -126,6 +185,14 @@ static void iree_hal_cuda_allocator_destroy(
       iree_hal_cuda_allocator_cast(base_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (allocator->staging_ring.capacity > 0) {
+    iree_hal_staging_ring_deinitialize(&allocator->staging_ring);
+  }
+  if (allocator->staging_host_ptr) {
+    IREE_CUDA_IGNORE_ERROR(allocator->symbols,
+                           cuMemFreeHost(allocator->staging_host_ptr));
+  }
+
   iree_allocator_free(allocator->host_allocator, allocator);
 
   IREE_TRACE_ZONE_END(z0);
@@ -169,11 +236,14 @@ static iree_status_t iree_hal_cuda_allocator_query_memory_heaps(
   iree_hal_cuda_allocator_t* allocator =
       iree_hal_cuda_allocator_cast(base_allocator);
 
-  // TODO(benvanik): check CU_DEVICE_ATTRIBUTE_INTEGRATED and return a unified
-  // set of heaps (likely still a cached and uncached, at minimum).
-  iree_host_size_t count = 3;
-  if (allocator->supports_concurrent_managed_access) {
-    ++count;  // device-local | host-visible
+  iree_host_size_t count = 0;
+  if (allocator->is_integrated) {
+    count = 2;  // unified | cached host-local
+  } else {
+    count = 3;
+    if (allocator->supports_concurrent_managed_access) {
+      ++count;  // device-local | host-visible
+    }
   }
   if (out_count) *out_count = count;
   if (capacity < count) {
@@ -189,6 +259,37 @@ static iree_status_t iree_hal_cuda_allocator_query_memory_heaps(
 
   int i = 0;
 
+  if (allocator->is_integrated) {
+    // Unified page-locked memory shared by the host and device (dispatch
+    // resources and upload):
+    heaps[i++] = (iree_hal_allocator_memory_heap_t){
+        .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
+                IREE_HAL_MEMORY_TYPE_HOST_VISIBLE |
+                IREE_HAL_MEMORY_TYPE_HOST_COHERENT,
+        .allowed_usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                         IREE_HAL_BUFFER_USAGE_DISPATCH |
+                         IREE_HAL_BUFFER_USAGE_MAPPING,
+        .max_allocation_size = max_allocation_size,
+        .min_alignment = min_alignment,
+    };
+
+    // Cached page-locked host-local memory (download):
+    heaps[i++] = (iree_hal_allocator_memory_heap_t){
+        .type = IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE |
+                IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                IREE_HAL_MEMORY_TYPE_HOST_COHERENT |
+                IREE_HAL_MEMORY_TYPE_HOST_CACHED,
+        .allowed_usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                         IREE_HAL_BUFFER_USAGE_DISPATCH |
+                         IREE_HAL_BUFFER_USAGE_MAPPING,
+        .max_allocation_size = max_allocation_size,
+        .min_alignment = min_alignment,
+    };
+
+    IREE_ASSERT(i == count);
+    return iree_ok_status();
+  }
+
   // Device-local memory (dispatch resources):
   heaps[i++] = (iree_hal_allocator_memory_heap_t){
       .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
@@ -271,12 +372,24 @@ iree_hal_cuda_allocator_query_buffer_compatibility(
     }
   }
 
+  // Integrated devices back all device-local memory with page-locked host
+  // memory that the host can map directly. Making these buffers host-visible
+  // and mappable lets transfers and file reads write them in place instead of
+  // going through staging buffers and device copies.
+  if (allocator->is_integrated &&
+      iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    params->type |=
+        IREE_HAL_MEMORY_TYPE_HOST_VISIBLE | IREE_HAL_MEMORY_TYPE_HOST_COHERENT;
+    params->usage |= IREE_HAL_BUFFER_USAGE_MAPPING;
+  }
+
   // If concurrent managed access is not supported then make device-local +
   // host-visible allocations fall back to host-local + device-visible
   // page-locked memory. This will be significantly slower for the device to
   // access but the compiler only uses this type for readback staging buffers
   // and it's better to function than function fast.
-  if (!allocator->supports_concurrent_managed_access &&
+  if (!allocator->is_integrated &&
+      !allocator->supports_concurrent_managed_access &&
       iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
                                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
     compatibility |= IREE_HAL_BUFFER_COMPATIBILITY_LOW_PERFORMANCE;
@@ -326,10 +439,76 @@ static void iree_hal_cuda_buffer_free(
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "(ignored; external)");
       break;
     }
+    case IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL_MEMORY: {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "cuMemFree (external memory)");
+      IREE_CUDA_IGNORE_ERROR(cuda_symbols, cuMemFree(device_ptr));
+      break;
+    }
+    case IREE_HAL_CUDA_BUFFER_TYPE_IMPORTED_POOL: {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "(ignored; imported pool)");
+      break;
+    }
+    case IREE_HAL_CUDA_BUFFER_TYPE_STAGING: {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "(ignored; staging ring)");
+      break;
+    }
   }
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Usage bits allowed on buffers suballocated from the staging ring. Buffers
+// used by dispatches may be long-lived and would pin the ring.
+#define IREE_HAL_CUDA_STAGING_USAGE_MASK                                    \
+  (IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED | \
+   IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT |                              \
+   IREE_HAL_BUFFER_USAGE_MAPPING_OPTIONAL |                                \
+   IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_RANDOM |                           \
+   IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_SEQUENTIAL_WRITE)
+
+static void iree_hal_cuda_allocator_release_staging(void* user_data,
+                                                    iree_hal_buffer_t* buffer) {
+  iree_hal_cuda_allocator_t* allocator = (iree_hal_cuda_allocator_t*)user_data;
+  const iree_device_size_t offset =
+      (iree_device_size_t)((uint8_t*)iree_hal_cuda_buffer_host_pointer(buffer) -
+                           (uint8_t*)allocator->staging_host_ptr);
+  iree_hal_staging_ring_release(&allocator->staging_ring, offset);
+}
+
+// Attempts to suballocate a host-local transfer buffer from the staging ring.
+// Returns NULL in |out_buffer| if the buffer cannot be served from the ring and
+// must be allocated normally.
+static iree_status_t iree_hal_cuda_allocator_allocate_staging(
+    iree_hal_cuda_allocator_t* allocator,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (!allocator->staging_device_ptr ||
+      iree_any_bit_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL) ||
+      iree_any_bit_set(params->usage, ~IREE_HAL_CUDA_STAGING_USAGE_MASK)) {
+    return iree_ok_status();
+  }
+  iree_device_size_t offset = 0;
+  if (!iree_hal_staging_ring_reserve(&allocator->staging_ring,
+                                     allocation_size, &offset)) {
+    return iree_ok_status();
+  }
+  iree_status_t status = iree_hal_cuda_buffer_wrap(
+      (iree_hal_allocator_t*)allocator, params->type, params->access,
+      params->usage, allocation_size, /*byte_offset=*/0,
+      /*byte_length=*/allocation_size, IREE_HAL_CUDA_BUFFER_TYPE_STAGING,
+      allocator->staging_device_ptr + offset,
+      (uint8_t*)allocator->staging_host_ptr + offset,
+      (iree_hal_buffer_release_callback_t){
+          .fn = iree_hal_cuda_allocator_release_staging,
+          .user_data = allocator,
+      },
+      allocator->host_allocator, out_buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_staging_ring_release(&allocator->staging_ring, offset);
+  }
+  return status;
+}
+
 static iree_status_t iree_hal_cuda_allocator_allocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -369,14 +548,41 @@ static iree_status_t iree_hal_cuda_allocator_allocate_buffer(
 #endif  // IREE_STATUS_MODE
   }
 
+  // Host-local transfer buffers are served from the staging ring when it has
+  // space to avoid the cost of allocating and pinning host memory per
+  // transfer.
+  iree_hal_buffer_t* staging_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_allocator_allocate_staging(
+      allocator, &compat_params, allocation_size, &staging_buffer));
+  if (staging_buffer) {
+    *out_buffer = staging_buffer;
+    return iree_ok_status();
+  }
+
   iree_status_t status = iree_ok_status();
   iree_hal_cuda_buffer_type_t buffer_type = IREE_HAL_CUDA_BUFFER_TYPE_DEVICE;
   void* host_ptr = NULL;
   CUdeviceptr device_ptr = 0;
   IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_hal_cuda_buffer_allocate");
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, allocation_size);
-  if (iree_all_bits_set(compat_params.type,
+  if (allocator->is_integrated &&
+      iree_all_bits_set(compat_params.type,
                         IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    // Unified memory on integrated devices. Managed memory is avoided as
+    // integrated devices generally lack concurrent managed access and the host
+    // would not be able to touch it while the device is running. Page-locked
+    // memory is not write-combined so that host reads remain fast.
+    buffer_type = IREE_HAL_CUDA_BUFFER_TYPE_HOST;
+    status = IREE_CURESULT_TO_STATUS(
+        allocator->symbols,
+        cuMemHostAlloc(&host_ptr, allocation_size, CU_MEMHOSTALLOC_DEVICEMAP));
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          allocator->symbols,
+          cuMemHostGetDevicePointer(&device_ptr, host_ptr, /*flags=*/0));
+    }
+  } else if (iree_all_bits_set(compat_params.type,
+                               IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
     if (iree_all_bits_set(compat_params.type,
                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
       // Device local + host visible.
@@ -432,8 +638,10 @@ static iree_status_t iree_hal_cuda_allocator_allocate_buffer(
     IREE_TRACE_ALLOC_NAMED(IREE_HAL_CUDA_ALLOCATOR_ID,
                            (void*)iree_hal_cuda_buffer_device_pointer(buffer),
                            allocation_size);
+    buffer->allocation_tag = compat_params.tag;
     IREE_STATISTICS(iree_hal_allocator_statistics_record_alloc(
-        &allocator->statistics, compat_params.type, allocation_size));
+        &allocator->statistics, compat_params.type, compat_params.tag,
+        allocation_size));
     *out_buffer = buffer;
   } else {
     if (!buffer && (device_ptr || host_ptr)) {
@@ -483,6 +691,7 @@ static void iree_hal_cuda_allocator_deallocate_buffer(
           (void*)iree_hal_cuda_buffer_device_pointer(base_buffer));
       IREE_STATISTICS(iree_hal_allocator_statistics_record_free(
           &allocator->statistics, iree_hal_buffer_memory_type(base_buffer),
+          iree_hal_buffer_allocation_tag(base_buffer),
           iree_hal_buffer_allocation_size(base_buffer)));
       break;
     }
@@ -494,6 +703,132 @@ static void iree_hal_cuda_allocator_deallocate_buffer(
   iree_hal_buffer_destroy(base_buffer);
 }
 
+// External memory object imported from a handle. Kept alive until the buffer
+// mapped from it is destroyed; the mapping itself is freed with cuMemFree by
+// the allocator before the buffer release callback runs.
+typedef struct iree_hal_cuda_external_memory_t {
+  const iree_hal_cuda_dynamic_symbols_t* symbols;
+  iree_allocator_t host_allocator;
+  CUexternalMemory handle;
+  // User-provided release callback chained after the external memory is gone.
+  iree_hal_buffer_release_callback_t user_release_callback;
+} iree_hal_cuda_external_memory_t;
+
+static void iree_hal_cuda_external_memory_release(void* user_data,
+                                                  iree_hal_buffer_t* buffer) {
+  iree_hal_cuda_external_memory_t* external_memory =
+      (iree_hal_cuda_external_memory_t*)user_data;
+  IREE_CUDA_IGNORE_ERROR(external_memory->symbols,
+                         cuDestroyExternalMemory(external_memory->handle));
+  if (external_memory->user_release_callback.fn) {
+    external_memory->user_release_callback.fn(
+        external_memory->user_release_callback.user_data, buffer);
+  }
+  iree_allocator_free(external_memory->host_allocator, external_memory);
+}
+
+// Imports an OPAQUE_FD or OPAQUE_WIN32 handle with cuImportExternalMemory and
+// maps the entire allocation as a device buffer. The caller retains ownership
+// of the handle: CUDA takes ownership of file descriptors on a successful
+// import so we hand it a duplicate.
+static iree_status_t iree_hal_cuda_allocator_import_external_memory(
+    iree_hal_cuda_allocator_t* allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT compat_params,
+    iree_hal_external_buffer_t* IREE_RESTRICT external_buffer,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  CUDA_EXTERNAL_MEMORY_HANDLE_DESC handle_desc;
+  memset(&handle_desc, 0, sizeof(handle_desc));
+  handle_desc.size = external_buffer->size;
+  if (iree_all_bits_set(external_buffer->flags,
+                        IREE_HAL_EXTERNAL_BUFFER_FLAG_DEDICATED)) {
+    handle_desc.flags |= CUDA_EXTERNAL_MEMORY_DEDICATED;
+  }
+  int import_fd = -1;
+  if (external_buffer->type == IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_FD) {
+#if defined(IREE_PLATFORM_WINDOWS)
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "file descriptor imports are not available on "
+                            "Windows; use OPAQUE_WIN32 handles instead");
+#else
+    import_fd = dup(external_buffer->handle.opaque_fd.fd);
+    if (import_fd < 0) {
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "unable to duplicate file descriptor %d",
+                              external_buffer->handle.opaque_fd.fd);
+    }
+    handle_desc.type = CU_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD;
+    handle_desc.handle.fd = import_fd;
+#endif  // IREE_PLATFORM_WINDOWS
+  } else {
+    handle_desc.type = CU_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32;
+    handle_desc.handle.win32.handle =
+        external_buffer->handle.opaque_win32.handle;
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)external_buffer->size);
+
+  CUexternalMemory external_memory_handle = NULL;
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      allocator->symbols,
+      cuImportExternalMemory(&external_memory_handle, &handle_desc),
+      "cuImportExternalMemory");
+#if !defined(IREE_PLATFORM_WINDOWS)
+  if (!iree_status_is_ok(status) && import_fd >= 0) close(import_fd);
+#endif  // !IREE_PLATFORM_WINDOWS
+
+  CUdeviceptr device_ptr = 0;
+  if (iree_status_is_ok(status)) {
+    CUDA_EXTERNAL_MEMORY_BUFFER_DESC buffer_desc;
+    memset(&buffer_desc, 0, sizeof(buffer_desc));
+    buffer_desc.offset = 0;
+    buffer_desc.size = external_buffer->size;
+    status = IREE_CURESULT_TO_STATUS(
+        allocator->symbols,
+        cuExternalMemoryGetMappedBuffer(&device_ptr, external_memory_handle,
+                                        &buffer_desc),
+        "cuExternalMemoryGetMappedBuffer");
+  }
+
+  iree_hal_cuda_external_memory_t* external_memory = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(allocator->host_allocator,
+                                   sizeof(*external_memory),
+                                   (void**)&external_memory);
+  }
+  if (iree_status_is_ok(status)) {
+    external_memory->symbols = allocator->symbols;
+    external_memory->host_allocator = allocator->host_allocator;
+    external_memory->handle = external_memory_handle;
+    external_memory->user_release_callback = release_callback;
+    iree_hal_buffer_release_callback_t internal_release_callback = {
+        .fn = iree_hal_cuda_external_memory_release,
+        .user_data = external_memory,
+    };
+    status = iree_hal_cuda_buffer_wrap(
+        (iree_hal_allocator_t*)allocator, compat_params->type,
+        compat_params->access, compat_params->usage, external_buffer->size,
+        /*byte_offset=*/0, /*byte_length=*/external_buffer->size,
+        IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL_MEMORY, device_ptr,
+        /*host_ptr=*/NULL, internal_release_callback,
+        allocator->host_allocator, out_buffer);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(allocator->host_allocator, external_memory);
+    if (device_ptr) {
+      IREE_CUDA_IGNORE_ERROR(allocator->symbols, cuMemFree(device_ptr));
+    }
+    if (external_memory_handle) {
+      IREE_CUDA_IGNORE_ERROR(allocator->symbols,
+                             cuDestroyExternalMemory(external_memory_handle));
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_cuda_allocator_import_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -575,8 +910,9 @@ static iree_status_t iree_hal_cuda_allocator_import_buffer(
     }
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_FD:
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_WIN32:
-      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                              "handle-based imports not yet implemented");
+      return iree_hal_cuda_allocator_import_external_memory(
+          allocator, &compat_params, external_buffer, release_callback,
+          out_buffer);
     default:
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                               "external buffer type not supported");
@@ -30,6 +30,17 @@ typedef enum iree_hal_cuda_buffer_type_e {
   // Externally registered buffer whose providence is unknown.
   // Must be freed by the user.
   IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL,
+  // Device local buffer mapped from memory imported with
+  // cuImportExternalMemory; the mapping is freed with cuMemFree and the
+  // external memory object is destroyed by the buffer release callback.
+  IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL_MEMORY,
+  // Device local buffer imported from a memory pool shared by another process
+  // with cuMemPoolImportPointer; the mapping is freed with cuMemFree and the
+  // imported pool is destroyed by the buffer release callback.
+  IREE_HAL_CUDA_BUFFER_TYPE_IMPORTED_POOL,
+  // Host local buffer suballocated from the allocator staging ring; the range
+  // is returned to the ring by the buffer release callback.
+  IREE_HAL_CUDA_BUFFER_TYPE_STAGING,
 } iree_hal_cuda_buffer_type_t;
 
 // Wraps a CUDA allocation in an iree_hal_buffer_t.
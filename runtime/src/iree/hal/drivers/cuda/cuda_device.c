@@ -16,10 +16,13 @@
 #include "iree/hal/drivers/cuda/cuda_allocator.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_status_util.h"
+#include "iree/hal/drivers/cuda/dispatch_profiler.h"
 #include "iree/hal/drivers/cuda/event_pool.h"
 #include "iree/hal/drivers/cuda/event_semaphore.h"
+#include "iree/hal/drivers/cuda/external_semaphore.h"
 #include "iree/hal/drivers/cuda/graph_command_buffer.h"
 #include "iree/hal/drivers/cuda/memory_pools.h"
+#include "iree/hal/drivers/cuda/cufile_file.h"
 #include "iree/hal/drivers/cuda/nccl_channel.h"
 #include "iree/hal/drivers/cuda/nccl_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/nop_executable_cache.h"
@@ -28,6 +31,7 @@
 #include "iree/hal/drivers/cuda/stream_command_buffer.h"
 #include "iree/hal/drivers/cuda/timepoint_pool.h"
 #include "iree/hal/drivers/cuda/tracing.h"
+#include "iree/hal/drivers/utils/queue.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
@@ -52,20 +56,36 @@ typedef struct iree_hal_cuda_device_t {
 
   const iree_hal_cuda_dynamic_symbols_t* cuda_symbols;
   const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols;
+  // Only loaded when GPUDirect Storage is enabled and available.
+  const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols;
 
   // Parameters used to control device behavior.
   iree_hal_cuda_device_params_t params;
 
   CUcontext cu_context;
   CUdevice cu_device;
-  // TODO: Support multiple device streams.
-  // The CUstream used to issue device kernels and allocations.
-  CUstream dispatch_cu_stream;
-  // The CUstream used to issue host callback functions.
-  CUstream callback_cu_stream;
+  // Total number of queues, each backed by a pair of streams. The first
+  // params.queue_count are dispatch queues and when enabled the last two are
+  // the dedicated host-to-device and device-to-host copy queues.
+  iree_host_size_t queue_count;
+  // The CUstreams used to issue device kernels and allocations per queue.
+  CUstream dispatch_cu_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT];
+  // The CUstreams used to issue host callback functions per queue.
+  // Separate per queue so that completions on one queue are not blocked
+  // behind pending work on another.
+  CUstream callback_cu_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT];
 
   iree_hal_cuda_tracing_context_t* tracing_context;
 
+  // Per-dispatch timing profiler allocated on the first profiling_begin with
+  // IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS and retained until the
+  // device is destroyed so that results can be queried after profiling ends.
+  iree_hal_cuda_dispatch_profiler_t* dispatch_profiler;
+  // True while dispatches are being captured by |dispatch_profiler|.
+  bool dispatch_profiling;
+  // Optional file path the dispatch profile is written to on profiling_end.
+  char* dispatch_profile_file_path;
+
   iree_allocator_t host_allocator;
 
   // Host/device event pools, used for backing semaphore timepoints.
@@ -102,15 +122,40 @@ static iree_hal_cuda_device_t* iree_hal_cuda_device_cast_unsafe(
   return (iree_hal_cuda_device_t*)base_value;
 }
 
+// Returns the index of the queue that work with |queue_affinity| is issued to.
+static iree_host_size_t iree_hal_cuda_device_select_queue(
+    iree_hal_cuda_device_t* device, iree_hal_queue_affinity_t queue_affinity) {
+  return iree_hal_queue_affinity_select_index(queue_affinity,
+                                              device->queue_count);
+}
+
+// Returns the queue affinity used for file transfers in the given direction.
+// Transfers are routed to the dedicated copy queues when enabled and otherwise
+// use the |queue_affinity| requested.
+static iree_hal_queue_affinity_t iree_hal_cuda_device_transfer_affinity(
+    iree_hal_cuda_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    bool host_to_device) {
+  if (!device->params.dedicated_copy_queues) return queue_affinity;
+  const iree_host_size_t queue_index =
+      device->params.queue_count + (host_to_device ? 0 : 1);
+  return 1ull << queue_index;
+}
+
 IREE_API_EXPORT void iree_hal_cuda_device_params_initialize(
     iree_hal_cuda_device_params_t* out_params) {
   memset(out_params, 0, sizeof(*out_params));
   out_params->arena_block_size = 32 * 1024;
   out_params->event_pool_capacity = 32;
   out_params->queue_count = 1;
+  out_params->dedicated_copy_queues = false;
   out_params->command_buffer_mode = IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH;
   out_params->stream_tracing = false;
   out_params->async_allocations = true;
+  out_params->collective_bucket_size = 4 * 1024 * 1024;
+  out_params->channel_init_timeout = IREE_DURATION_INFINITE;
+  out_params->dispatch_profile_capacity = 64 * 1024;
+  out_params->staging_ring_capacity = 32 * 1024 * 1024;
+  out_params->gpu_direct_storage = false;
 }
 
 static iree_status_t iree_hal_cuda_device_check_params(
@@ -123,15 +168,25 @@ static iree_status_t iree_hal_cuda_device_check_params(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "at least one queue is required");
   }
+  const iree_host_size_t total_queue_count =
+      params->queue_count + (params->dedicated_copy_queues ? 2 : 0);
+  if (total_queue_count > IREE_HAL_CUDA_MAX_QUEUE_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "too many queues requested (%" PRIhsz
+                            " including copy queues, max %d)",
+                            total_queue_count, IREE_HAL_CUDA_MAX_QUEUE_COUNT);
+  }
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_cuda_device_create_internal(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
     const iree_hal_cuda_device_params_t* params, CUdevice cu_device,
-    CUstream dispatch_stream, CUstream callback_stream, CUcontext context,
+    iree_host_size_t queue_count, const CUstream* dispatch_streams,
+    const CUstream* callback_streams, CUcontext context,
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
     const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
+    const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols,
     iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
   iree_hal_cuda_device_t* device = NULL;
   iree_host_size_t total_size = iree_sizeof_struct(*device) + identifier.size;
@@ -148,21 +203,26 @@ static iree_status_t iree_hal_cuda_device_create_internal(
   iree_hal_driver_retain(device->driver);
   device->cuda_symbols = cuda_symbols;
   device->nccl_symbols = nccl_symbols;
+  device->cufile_symbols = cufile_symbols;
   device->params = *params;
   device->cu_context = context;
   device->cu_device = cu_device;
-  device->dispatch_cu_stream = dispatch_stream;
-  device->callback_cu_stream = callback_stream;
+  device->queue_count = queue_count;
+  for (iree_host_size_t i = 0; i < queue_count; ++i) {
+    device->dispatch_cu_streams[i] = dispatch_streams[i];
+    device->callback_cu_streams[i] = callback_streams[i];
+  }
   device->host_allocator = host_allocator;
 
   iree_status_t status = iree_hal_cuda_pending_queue_actions_create(
-      cuda_symbols, &device->block_pool, host_allocator,
-      &device->pending_queue_actions);
+      cuda_symbols, device->params.worker_thread_params, &device->block_pool,
+      host_allocator, &device->pending_queue_actions);
 
-  // Enable tracing for the (currently only) stream - no-op if disabled.
+  // Enable tracing for the first dispatch stream - no-op if disabled.
+  // TODO: trace all queues; each needs its own tracing context.
   if (iree_status_is_ok(status) && device->params.stream_tracing) {
     status = iree_hal_cuda_tracing_context_allocate(
-        device->cuda_symbols, device->identifier, dispatch_stream,
+        device->cuda_symbols, device->identifier, dispatch_streams[0],
         &device->block_pool, host_allocator, &device->tracing_context);
   }
 
@@ -181,15 +241,16 @@ static iree_status_t iree_hal_cuda_device_create_internal(
   // Create memory pools first so that we can share them with the allocator.
   if (iree_status_is_ok(status) && device->supports_memory_pools) {
     status = iree_hal_cuda_memory_pools_initialize(
-        cuda_symbols, cu_device, &params->memory_pools, host_allocator,
-        &device->memory_pools);
+        cuda_symbols, cu_device, queue_count, &params->memory_pools,
+        host_allocator, &device->memory_pools);
   }
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_allocator_create(
-        cuda_symbols, cu_device, dispatch_stream,
+        cuda_symbols, cu_device, dispatch_streams[0],
         device->supports_memory_pools ? &device->memory_pools : NULL,
-        host_allocator, &device->device_allocator);
+        params->staging_ring_capacity, host_allocator,
+        &device->device_allocator);
   }
 
   if (iree_status_is_ok(status)) {
@@ -204,8 +265,10 @@ iree_status_t iree_hal_cuda_device_create(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
     const iree_hal_cuda_device_params_t* params,
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
-    const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols, CUdevice device,
-    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
+    const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
+    const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols,
+    CUdevice device, iree_allocator_t host_allocator,
+    iree_hal_device_t** out_device) {
   IREE_ASSERT_ARGUMENT(driver);
   IREE_ASSERT_ARGUMENT(params);
   IREE_ASSERT_ARGUMENT(cuda_symbols);
@@ -224,27 +287,38 @@ iree_status_t iree_hal_cuda_device_create(
     status = IREE_CURESULT_TO_STATUS(cuda_symbols, cuCtxSetCurrent(context));
   }
 
-  // Create the default dispatch stream for the device.
-  CUstream dispatch_stream = NULL;
-  if (iree_status_is_ok(status)) {
-    status = IREE_CURESULT_TO_STATUS(
-        cuda_symbols, cuStreamCreate(&dispatch_stream, CU_STREAM_NON_BLOCKING));
-  }
-  // Create the default callback stream for the device.
-  CUstream callback_stream = NULL;
-  if (iree_status_is_ok(status)) {
+  // Create the dispatch and callback streams for each queue.
+  const iree_host_size_t queue_count =
+      params->queue_count + (params->dedicated_copy_queues ? 2 : 0);
+  CUstream dispatch_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT] = {NULL};
+  CUstream callback_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT] = {NULL};
+  for (iree_host_size_t i = 0; i < queue_count && iree_status_is_ok(status);
+       ++i) {
     status = IREE_CURESULT_TO_STATUS(
-        cuda_symbols, cuStreamCreate(&callback_stream, CU_STREAM_NON_BLOCKING));
+        cuda_symbols,
+        cuStreamCreate(&dispatch_streams[i], CU_STREAM_NON_BLOCKING));
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          cuda_symbols,
+          cuStreamCreate(&callback_streams[i], CU_STREAM_NON_BLOCKING));
+    }
   }
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_device_create_internal(
-        driver, identifier, params, device, dispatch_stream, callback_stream,
-        context, cuda_symbols, nccl_symbols, host_allocator, out_device);
+        driver, identifier, params, device, queue_count, dispatch_streams,
+        callback_streams, context, cuda_symbols, nccl_symbols, cufile_symbols,
+        host_allocator, out_device);
   } else {
     // Release resources we have accquired thus far.
-    if (callback_stream) cuda_symbols->cuStreamDestroy(callback_stream);
-    if (dispatch_stream) cuda_symbols->cuStreamDestroy(dispatch_stream);
+    for (iree_host_size_t i = 0; i < queue_count; ++i) {
+      if (callback_streams[i]) {
+        cuda_symbols->cuStreamDestroy(callback_streams[i]);
+      }
+      if (dispatch_streams[i]) {
+        cuda_symbols->cuStreamDestroy(dispatch_streams[i]);
+      }
+    }
     if (context) cuda_symbols->cuDevicePrimaryCtxRelease(device);
   }
 
@@ -300,6 +374,73 @@ const iree_hal_cuda_dynamic_symbols_t* iree_hal_cuda_device_dynamic_symbols(
   return device->cuda_symbols;
 }
 
+// Returns the device memory pools or an error if |base_device| is not a CUDA
+// device or does not support queue-ordered allocations.
+static iree_status_t iree_hal_cuda_device_query_memory_pools(
+    iree_hal_device_t* base_device, iree_hal_cuda_device_t** out_device) {
+  if (!iree_hal_resource_is(base_device, &iree_hal_cuda_device_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "device is not a CUDA device");
+  }
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (!device->supports_memory_pools) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "device memory pools are not supported or "
+                            "async allocations are disabled");
+  }
+  *out_device = device;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_export_memory_pool(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    int* out_fd) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(out_fd);
+  *out_fd = -1;
+  iree_hal_cuda_device_t* device = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_device_query_memory_pools(base_device, &device));
+  if (!device->params.memory_pools.device_local.shareable) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "device-local memory pools must be created "
+                            "shareable in order to be exported");
+  }
+  return iree_hal_cuda_memory_pools_export_pool(
+      &device->memory_pools,
+      iree_hal_cuda_device_select_queue(device, queue_affinity), out_fd);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_export_buffer(
+    iree_hal_device_t* base_device, iree_hal_buffer_t* buffer,
+    iree_hal_cuda_memory_pool_ptr_export_data_t* out_export_data) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(buffer);
+  IREE_ASSERT_ARGUMENT(out_export_data);
+  iree_hal_cuda_device_t* device = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_device_query_memory_pools(base_device, &device));
+  return iree_hal_cuda_memory_pools_export_buffer(&device->memory_pools,
+                                                  buffer, out_export_data);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_import_buffer(
+    iree_hal_device_t* base_device, int pool_fd,
+    const iree_hal_cuda_memory_pool_ptr_export_data_t* export_data,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(export_data);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  iree_hal_cuda_device_t* device = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_device_query_memory_pools(base_device, &device));
+  return iree_hal_cuda_memory_pools_import_buffer(
+      &device->memory_pools, pool_fd, export_data, params, allocation_size,
+      out_buffer);
+}
+
 static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
@@ -320,6 +461,8 @@ static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_cuda_memory_pools_deinitialize(&device->memory_pools);
 
   iree_hal_cuda_tracing_context_free(device->tracing_context);
+  iree_hal_cuda_dispatch_profiler_free(device->dispatch_profiler);
+  iree_allocator_free(host_allocator, device->dispatch_profile_file_path);
 
   // Destroy various pools for synchronization.
   if (device->timepoint_pool) {
@@ -330,8 +473,12 @@ static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   }
   if (device->host_event_pool) iree_event_pool_free(device->host_event_pool);
 
-  IREE_CUDA_IGNORE_ERROR(symbols, cuStreamDestroy(device->dispatch_cu_stream));
-  IREE_CUDA_IGNORE_ERROR(symbols, cuStreamDestroy(device->callback_cu_stream));
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    IREE_CUDA_IGNORE_ERROR(symbols,
+                           cuStreamDestroy(device->dispatch_cu_streams[i]));
+    IREE_CUDA_IGNORE_ERROR(symbols,
+                           cuStreamDestroy(device->callback_cu_streams[i]));
+  }
 
   IREE_CUDA_IGNORE_ERROR(symbols, cuDevicePrimaryCtxRelease(device->cu_device));
 
@@ -419,6 +566,13 @@ static iree_status_t iree_hal_cuda_device_query_i64(
     return iree_ok_status();
   }
 
+  if (iree_string_view_equal(category, IREE_SV("hal.device"))) {
+    if (iree_string_view_equal(key, IREE_SV("concurrency"))) {
+      *out_value = (int64_t)device->queue_count;
+      return iree_ok_status();
+    }
+  }
+
   if (iree_string_view_equal(category, IREE_SV("cuda.device"))) {
     if (iree_string_view_equal(key, IREE_SV("compute_capability_major"))) {
       return iree_hal_cuda_device_query_attribute(
@@ -517,20 +671,27 @@ static iree_status_t iree_hal_cuda_device_create_channel(
   // implementation only supports one device we pass in the only one we have.
   return iree_hal_cuda_nccl_channel_create(
       device->cuda_symbols, device->nccl_symbols, &id, params.rank,
-      params.count, device->host_allocator, out_channel);
+      params.count, device->params.channel_init_timeout,
+      device->host_allocator, out_channel);
 }
 
 iree_status_t iree_hal_cuda_device_create_stream_command_buffer(
     iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_host_size_t binding_capacity,
+    iree_host_size_t binding_capacity, CUstream stream,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  // The tracing context is only valid for the stream it was created with.
+  iree_hal_cuda_tracing_context_t* tracing_context =
+      stream == device->dispatch_cu_streams[0] ? device->tracing_context
+                                               : NULL;
+  iree_hal_cuda_dispatch_profiler_t* dispatch_profiler =
+      device->dispatch_profiling ? device->dispatch_profiler : NULL;
   return iree_hal_cuda_stream_command_buffer_create(
-      base_device, device->cuda_symbols, device->nccl_symbols,
-      device->tracing_context, mode, command_categories, binding_capacity,
-      device->dispatch_cu_stream, &device->block_pool, device->host_allocator,
-      out_command_buffer);
+      base_device, device->cuda_symbols, device->nccl_symbols, tracing_context,
+      dispatch_profiler, mode, command_categories, binding_capacity, stream,
+      device->params.collective_bucket_size, &device->block_pool,
+      device->host_allocator, out_command_buffer);
 }
 
 static iree_status_t iree_hal_cuda_device_create_command_buffer(
@@ -540,13 +701,21 @@ static iree_status_t iree_hal_cuda_device_create_command_buffer(
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
 
-  switch (device->params.command_buffer_mode) {
+  // Dispatches within graphs cannot be individually timed so command buffers
+  // are recorded for replay on streams while dispatch profiling is active.
+  iree_hal_cuda_command_buffer_mode_t command_buffer_mode =
+      device->params.command_buffer_mode;
+  if (device->dispatch_profiling) {
+    command_buffer_mode = IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM;
+  }
+
+  switch (command_buffer_mode) {
     case IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH:
       return iree_hal_cuda_graph_command_buffer_create(
-          base_device, device->cuda_symbols, device->tracing_context,
-          device->cu_context, mode, command_categories, queue_affinity,
-          binding_capacity, &device->block_pool, device->host_allocator,
-          out_command_buffer);
+          base_device, device->cuda_symbols, device->nccl_symbols,
+          device->tracing_context, device->cu_context, mode,
+          command_categories, queue_affinity, binding_capacity,
+          &device->block_pool, device->host_allocator, out_command_buffer);
     case IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM:
       return iree_hal_deferred_command_buffer_create(
           base_device, mode, command_categories, binding_capacity,
@@ -589,6 +758,15 @@ static iree_status_t iree_hal_cuda_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (iree_io_file_handle_type(handle) == IREE_IO_FILE_HANDLE_TYPE_FD &&
+      device->cufile_symbols && device->cufile_symbols->dylib) {
+    // Files that cannot be registered with GPUDirect Storage are reported as
+    // unavailable so that callers can fall back to mapping or reading them.
+    return iree_hal_cuda_cufile_file_create(
+        device->cuda_symbols, device->cufile_symbols, device->cu_context,
+        access, handle, device->host_allocator, out_file);
+  }
   if (iree_io_file_handle_type(handle) !=
       IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
     return iree_make_status(
@@ -620,17 +798,33 @@ static iree_status_t iree_hal_cuda_device_create_semaphore(
       device->pending_queue_actions, device->host_allocator, out_semaphore);
 }
 
+static iree_status_t iree_hal_cuda_device_import_semaphore(
+    iree_hal_device_t* base_device,
+    const iree_hal_external_semaphore_t* external_semaphore,
+    iree_hal_external_semaphore_flags_t flags,
+    iree_hal_semaphore_t** out_semaphore) {
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  return iree_hal_cuda_external_semaphore_import(
+      device->cuda_symbols, external_semaphore, flags, device->host_allocator,
+      out_semaphore);
+}
+
 static iree_hal_semaphore_compatibility_t
 iree_hal_cuda_device_query_semaphore_compatibility(
     iree_hal_device_t* base_device, iree_hal_semaphore_t* semaphore) {
+  // Imported semaphores are only waited on and signaled on CUDA streams by
+  // queue_execute; other queue operations perform host waits.
+  if (iree_hal_cuda_external_semaphore_isa(semaphore)) {
+    return IREE_HAL_SEMAPHORE_COMPATIBILITY_DEVICE_WAIT |
+           IREE_HAL_SEMAPHORE_COMPATIBILITY_DEVICE_SIGNAL;
+  }
   // TODO: implement CUDA semaphores.
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
-// TODO: implement proper semaphores in CUDA to ensure ordering and avoid
-//       the barrier here.
+// Allocations are made immediately in stream order on the selected queue and
+// the signals are ordered after them through the pending queue actions so that
+// the host never blocks on the waits.
 static iree_status_t iree_hal_cuda_device_queue_alloca(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -639,69 +833,133 @@ static iree_status_t iree_hal_cuda_device_queue_alloca(
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
 
-  // NOTE: block on the semaphores here; we could avoid this by properly
-  // sequencing device work with semaphores. The CUDA HAL is not currently
-  // asynchronous.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
+  const iree_host_size_t queue_index =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
 
   // Allocate from the pool; likely to fail in cases of virtual memory
   // exhaustion but the error may be deferred until a later synchronization.
   // If pools are not supported we allocate a buffer as normal from whatever
   // allocator is set on the device.
+  //
+  // Pooled allocations do not depend on the waits: the memory returned is not
+  // in use by anything ordered before it on the stream.
+  iree_hal_buffer_t* buffer = NULL;
   iree_status_t status = iree_ok_status();
   if (device->supports_memory_pools &&
       !iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
     status = iree_hal_cuda_memory_pools_alloca(
-        &device->memory_pools, device->dispatch_cu_stream, pool, params,
-        allocation_size, out_buffer);
+        &device->memory_pools, queue_index,
+        device->dispatch_cu_streams[queue_index], pool, params,
+        allocation_size, &buffer);
   } else {
     status = iree_hal_allocator_allocate_buffer(
         iree_hal_device_allocator(base_device), params, allocation_size,
-        out_buffer);
+        &buffer);
   }
 
-  // Only signal if not returning a synchronous error - synchronous failure
-  // indicates that the stream is unchanged (it's not really since we waited
-  // above, but we at least won't deadlock like this).
+  // Signal once the waits have been resolved and the allocation is made on the
+  // device. Only signal if not returning a synchronous error - synchronous
+  // failure indicates that the stream is unchanged.
   if (iree_status_is_ok(status)) {
-    status = iree_hal_semaphore_list_signal(signal_semaphore_list);
+    status = iree_hal_cuda_pending_queue_actions_enqueue_alloca(
+        base_device, device->dispatch_cu_streams[queue_index],
+        device->callback_cu_streams[queue_index],
+        device->pending_queue_actions, wait_semaphore_list,
+        signal_semaphore_list);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_pending_queue_actions_issue(
+        device->pending_queue_actions);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_buffer = buffer;
+  } else {
+    iree_hal_buffer_release(buffer);
   }
+  IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
-// TODO: implement proper semaphores in CUDA to ensure ordering and avoid
-//       the barrier here.
+// Deallocations are deferred through the pending queue actions until the waits
+// have been resolved on the device. Buffers we got from a pool are returned to
+// it in stream order and others are dropped on the floor and freed when the
+// buffer is released.
 static iree_status_t iree_hal_cuda_device_queue_dealloca(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  IREE_TRACE_ZONE_BEGIN(z0);
 
-  // NOTE: block on the semaphores here; we could avoid this by properly
-  // sequencing device work with semaphores. The CUDA HAL is not currently
-  // asynchronous.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
+  const iree_host_size_t queue_index =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
+  iree_status_t status = iree_hal_cuda_pending_queue_actions_enqueue_dealloca(
+      base_device, device->dispatch_cu_streams[queue_index],
+      device->callback_cu_streams[queue_index], device->pending_queue_actions,
+      device->supports_memory_pools ? &device->memory_pools : NULL,
+      wait_semaphore_list, signal_semaphore_list, buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_pending_queue_actions_issue(
+        device->pending_queue_actions);
+  }
 
-  // Schedule the buffer deallocation if we got it from a pool and otherwise
-  // drop it on the floor and let it be freed when the buffer is released.
-  iree_status_t status = iree_ok_status();
-  if (device->supports_memory_pools) {
-    status = iree_hal_cuda_memory_pools_dealloca(
-        &device->memory_pools, device->dispatch_cu_stream, buffer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns options for streaming file transfers issued on the device.
+// When the staging ring is enabled the staging buffers are sized so that two
+// chunks can be double-buffered out of half of the ring, leaving the other
+// half for concurrent transfers.
+//
+// TODO: expose streaming chunk count/size options.
+static iree_hal_file_transfer_options_t
+iree_hal_cuda_device_file_transfer_options(iree_hal_cuda_device_t* device,
+                                           iree_status_t* loop_status) {
+  iree_hal_file_transfer_options_t options = {
+      .loop = iree_loop_inline(loop_status),
+      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
+      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+  };
+  const iree_device_size_t staging_ring_capacity =
+      device->params.staging_ring_capacity;
+  if (staging_ring_capacity >= 4 * 64) {
+    options.chunk_count = 2;
+    options.chunk_size = (staging_ring_capacity / 4) & ~(iree_device_size_t)63;
+    options.staging_limit = staging_ring_capacity / 2;
   }
+  return options;
+}
 
-  // Only signal if not returning a synchronous error - synchronous failure
-  // indicates that the stream is unchanged (it's not really since we waited
-  // above, but we at least won't deadlock like this).
+// Performs a synchronous GPUDirect Storage transfer after waiting for
+// |wait_semaphore_list| and then signals or fails |signal_semaphore_list|.
+// This matches the streaming transfers which also run on the inline loop.
+static iree_status_t iree_hal_cuda_device_queue_transfer_cufile(
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list, bool is_read,
+    iree_hal_file_t* file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_semaphore_list_wait(wait_semaphore_list,
+                                       iree_infinite_timeout()));
+  iree_status_t status =
+      is_read ? iree_hal_cuda_cufile_file_read(file, file_offset, buffer,
+                                               buffer_offset, length)
+              : iree_hal_cuda_cufile_file_write(file, file_offset, buffer,
+                                                buffer_offset, length);
   if (iree_status_is_ok(status)) {
     status = iree_hal_semaphore_list_signal(signal_semaphore_list);
+  } else {
+    iree_hal_semaphore_list_fail(signal_semaphore_list,
+                                 iree_status_clone(status));
   }
+  IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
@@ -712,17 +970,22 @@ static iree_status_t iree_hal_cuda_device_queue_read(
     iree_hal_file_t* source_file, uint64_t source_offset,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (iree_hal_cuda_cufile_file_isa(source_file)) {
+    return iree_hal_cuda_device_queue_transfer_cufile(
+        wait_semaphore_list, signal_semaphore_list, /*is_read=*/true,
+        source_file, source_offset, target_buffer, target_offset, length);
+  }
   iree_status_t loop_status = iree_ok_status();
-  iree_hal_file_transfer_options_t options = {
-      .loop = iree_loop_inline(&loop_status),
-      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
-  };
+  iree_hal_file_transfer_options_t options =
+      iree_hal_cuda_device_file_transfer_options(device, &loop_status);
+  const iree_hal_queue_affinity_t transfer_affinity =
+      iree_hal_cuda_device_transfer_affinity(device, queue_affinity,
+                                             /*host_to_device=*/true);
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_read_streaming(
-      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
-      source_file, source_offset, target_buffer, target_offset, length, flags,
-      options));
+      base_device, transfer_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_file, source_offset, target_buffer,
+      target_offset, length, flags, options));
   return loop_status;
 }
 
@@ -733,17 +996,22 @@ static iree_status_t iree_hal_cuda_device_queue_write(
     iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
     iree_hal_file_t* target_file, uint64_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (iree_hal_cuda_cufile_file_isa(target_file)) {
+    return iree_hal_cuda_device_queue_transfer_cufile(
+        wait_semaphore_list, signal_semaphore_list, /*is_read=*/false,
+        target_file, target_offset, source_buffer, source_offset, length);
+  }
   iree_status_t loop_status = iree_ok_status();
-  iree_hal_file_transfer_options_t options = {
-      .loop = iree_loop_inline(&loop_status),
-      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
-  };
+  iree_hal_file_transfer_options_t options =
+      iree_hal_cuda_device_file_transfer_options(device, &loop_status);
+  const iree_hal_queue_affinity_t transfer_affinity =
+      iree_hal_cuda_device_transfer_affinity(device, queue_affinity,
+                                             /*host_to_device=*/false);
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_write_streaming(
-      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
-      source_buffer, source_offset, target_file, target_offset, length, flags,
-      options));
+      base_device, transfer_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_buffer, source_offset, target_file,
+      target_offset, length, flags, options));
   return loop_status;
 }
 
@@ -757,16 +1025,22 @@ static iree_status_t iree_hal_cuda_device_queue_execute(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Cross-queue dependencies are expressed with semaphores; the pending queue
+  // actions resolve waits on device-signaled timepoints with CUevents waited
+  // on the selected dispatch stream.
+  const iree_host_size_t queue_index =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
   iree_status_t status = iree_hal_cuda_pending_queue_actions_enqueue_execution(
-      base_device, device->dispatch_cu_stream, device->callback_cu_stream,
-      device->pending_queue_actions,
+      base_device, device->dispatch_cu_streams[queue_index],
+      device->callback_cu_streams[queue_index], device->pending_queue_actions,
       iree_hal_cuda_device_collect_tracing_context, device->tracing_context,
       wait_semaphore_list, signal_semaphore_list, command_buffer_count,
-      command_buffers);
+      command_buffers, binding_tables);
   if (iree_status_is_ok(status)) {
     // Try to advance the pending workload queue.
     status = iree_hal_cuda_pending_queue_actions_issue(
@@ -799,20 +1073,92 @@ static iree_status_t iree_hal_cuda_device_wait_semaphores(
 static iree_status_t iree_hal_cuda_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to CUPTI here or use the much simpler cuProfilerStart API.
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+
+  // Only dispatch timing is supported today. Other modes are ignored (and
+  // that's ok); we could hook in to CUPTI for executable counters.
+  if (!iree_all_bits_set(options->mode,
+                         IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS)) {
+    return iree_ok_status();
+  }
+  if (device->dispatch_profiling) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "dispatch profiling already active");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (!device->dispatch_profiler) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_cuda_dispatch_profiler_allocate(
+                device->cuda_symbols, device->cu_context,
+                device->params.dispatch_profile_capacity,
+                device->host_allocator, &device->dispatch_profiler));
+  } else {
+    iree_hal_cuda_dispatch_profiler_reset(device->dispatch_profiler);
+  }
+
+  iree_allocator_free(device->host_allocator,
+                      device->dispatch_profile_file_path);
+  device->dispatch_profile_file_path = NULL;
+  iree_string_view_t file_path = iree_make_cstring_view(options->file_path);
+  if (!iree_string_view_is_empty(file_path)) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_clone(
+                device->host_allocator,
+                iree_make_const_byte_span(file_path.data, file_path.size + 1),
+                (void**)&device->dispatch_profile_file_path));
+  }
+
+  device->dispatch_profiling = true;
+  IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_cuda_device_profiling_flush(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (!device->dispatch_profiling) return iree_ok_status();
+  return iree_hal_cuda_dispatch_profiler_collect(device->dispatch_profiler);
 }
 
 static iree_status_t iree_hal_cuda_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (!device->dispatch_profiling) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Stop capturing new dispatches; the profiler is retained so that results
+  // remain queryable until the next capture begins.
+  device->dispatch_profiling = false;
+  iree_status_t status =
+      iree_hal_cuda_dispatch_profiler_collect(device->dispatch_profiler);
+  if (iree_status_is_ok(status) && device->dispatch_profile_file_path) {
+    status = iree_hal_cuda_dispatch_profiler_write_file(
+        device->dispatch_profiler, device->dispatch_profile_file_path);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_query_dispatch_profile(
+    iree_hal_device_t* base_device, iree_host_size_t capacity,
+    iree_hal_cuda_dispatch_profile_record_t* out_records,
+    iree_host_size_t* out_count) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(!capacity || out_records);
+  IREE_ASSERT_ARGUMENT(out_count);
+  *out_count = 0;
+  if (!iree_hal_resource_is(base_device, &iree_hal_cuda_device_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "device is not a CUDA device");
+  }
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (!device->dispatch_profiler) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_dispatch_profiler_collect(device->dispatch_profiler));
+  iree_hal_cuda_dispatch_profiler_query(device->dispatch_profiler, capacity,
+                                        out_records, out_count);
   return iree_ok_status();
 }
 
@@ -834,6 +1180,7 @@ static const iree_hal_device_vtable_t iree_hal_cuda_device_vtable = {
     .import_file = iree_hal_cuda_device_import_file,
     .create_pipeline_layout = iree_hal_cuda_device_create_pipeline_layout,
     .create_semaphore = iree_hal_cuda_device_create_semaphore,
+    .import_semaphore = iree_hal_cuda_device_import_semaphore,
     .query_semaphore_compatibility =
         iree_hal_cuda_device_query_semaphore_compatibility,
     .queue_alloca = iree_hal_cuda_device_queue_alloca,
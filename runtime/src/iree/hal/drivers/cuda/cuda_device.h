@@ -11,6 +11,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/nccl_dynamic_symbols.h"
 
 #ifdef __cplusplus
@@ -22,15 +23,18 @@ iree_status_t iree_hal_cuda_device_create(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
     const iree_hal_cuda_device_params_t* params,
     const iree_hal_cuda_dynamic_symbols_t* symbols,
-    const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols, CUdevice device,
-    iree_allocator_t host_allocator, iree_hal_device_t** out_device);
+    const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
+    const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols,
+    CUdevice device, iree_allocator_t host_allocator,
+    iree_hal_device_t** out_device);
 
 // Creates a CUDA stream-backed command buffer using resources from the the
-// given |base_device|.
+// given |base_device| that issues its commands to |stream|. The stream must be
+// one of the dispatch streams owned by the device.
 iree_status_t iree_hal_cuda_device_create_stream_command_buffer(
     iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_host_size_t binding_capacity,
+    iree_host_size_t binding_capacity, CUstream stream,
     iree_hal_command_buffer_t** out_command_buffer);
 
 // Returns the CUDA context bound to the given |device| if it is a CUDA device
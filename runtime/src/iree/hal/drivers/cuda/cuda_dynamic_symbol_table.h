@@ -27,7 +27,23 @@ IREE_CU_PFN_DECL(cuEventElapsedTime, float*, CUevent, CUevent)
 IREE_CU_PFN_DECL(cuEventQuery, CUevent)
 IREE_CU_PFN_DECL(cuEventRecord, CUevent, CUstream)
 IREE_CU_PFN_DECL(cuEventSynchronize, CUevent)
+IREE_CU_PFN_DECL(cuImportExternalMemory, CUexternalMemory*,
+                 const CUDA_EXTERNAL_MEMORY_HANDLE_DESC*)
+IREE_CU_PFN_DECL(cuExternalMemoryGetMappedBuffer, CUdeviceptr*,
+                 CUexternalMemory, const CUDA_EXTERNAL_MEMORY_BUFFER_DESC*)
+IREE_CU_PFN_DECL(cuDestroyExternalMemory, CUexternalMemory)
+IREE_CU_PFN_DECL(cuImportExternalSemaphore, CUexternalSemaphore*,
+                 const CUDA_EXTERNAL_SEMAPHORE_HANDLE_DESC*)
+IREE_CU_PFN_DECL(cuSignalExternalSemaphoresAsync, const CUexternalSemaphore*,
+                 const CUDA_EXTERNAL_SEMAPHORE_SIGNAL_PARAMS*, unsigned int,
+                 CUstream)
+IREE_CU_PFN_DECL(cuWaitExternalSemaphoresAsync, const CUexternalSemaphore*,
+                 const CUDA_EXTERNAL_SEMAPHORE_WAIT_PARAMS*, unsigned int,
+                 CUstream)
+IREE_CU_PFN_DECL(cuDestroyExternalSemaphore, CUexternalSemaphore)
 IREE_CU_PFN_DECL(cuGetProcAddress, const char*, void**, int, cuuint64_t)
+IREE_CU_PFN_DECL(cuGraphAddChildGraphNode, CUgraphNode*, CUgraph,
+                 const CUgraphNode*, size_t, CUgraph)
 IREE_CU_PFN_DECL(cuGraphAddEmptyNode, CUgraphNode*, CUgraph, const CUgraphNode*,
                  size_t)
 IREE_CU_PFN_DECL(cuGraphAddEventRecordNode, CUgraphNode*, CUgraph,
@@ -42,6 +58,8 @@ IREE_CU_PFN_DECL(cuGraphAddKernelNode, CUgraphNode*, CUgraph,
 IREE_CU_PFN_DECL(cuGraphCreate, CUgraph*, unsigned int)
 IREE_CU_PFN_DECL(cuGraphDestroy, CUgraph)
 IREE_CU_PFN_DECL(cuGraphExecDestroy, CUgraphExec)
+IREE_CU_PFN_DECL(cuGraphExecKernelNodeSetParams, CUgraphExec, CUgraphNode,
+                 const CUDA_KERNEL_NODE_PARAMS*)
 IREE_CU_PFN_DECL(cuGraphGetNodes, CUgraph, CUgraphNode*, size_t*)
 IREE_CU_PFN_DECL(cuGraphInstantiate, CUgraphExec*, CUgraph, CUgraphNode*, char*,
                  size_t)
@@ -65,15 +83,26 @@ IREE_CU_PFN_DECL(cuMemPoolGetAttribute, CUmemoryPool, CUmemPool_attribute,
 IREE_CU_PFN_DECL(cuMemPoolSetAttribute, CUmemoryPool, CUmemPool_attribute,
                  void*)
 IREE_CU_PFN_DECL(cuMemPoolTrimTo, CUmemoryPool, size_t)
+IREE_CU_PFN_DECL(cuMemPoolExportToShareableHandle, void*, CUmemoryPool,
+                 CUmemAllocationHandleType, unsigned long long)
+IREE_CU_PFN_DECL(cuMemPoolImportFromShareableHandle, CUmemoryPool*, void*,
+                 CUmemAllocationHandleType, unsigned long long)
+IREE_CU_PFN_DECL(cuMemPoolExportPointer, CUmemPoolPtrExportData*, CUdeviceptr)
+IREE_CU_PFN_DECL(cuMemPoolImportPointer, CUdeviceptr*, CUmemoryPool,
+                 CUmemPoolPtrExportData*)
 IREE_CU_PFN_DECL(cuMemAllocFromPoolAsync, CUdeviceptr*, size_t, CUmemoryPool,
                  CUstream)
+IREE_CU_PFN_DECL(cuMemAllocAsync, CUdeviceptr*, size_t, CUstream)
 IREE_CU_PFN_DECL(cuMemFreeAsync, CUdeviceptr dptr, CUstream hStream)
 IREE_CU_PFN_DECL(cuModuleGetFunction, CUfunction*, CUmodule, const char*)
 IREE_CU_PFN_DECL(cuModuleLoadDataEx, CUmodule*, const void*, unsigned int,
                  CUjit_option*, void**)
 IREE_CU_PFN_DECL(cuModuleUnload, CUmodule)
+IREE_CU_PFN_DECL(cuStreamBeginCapture, CUstream, CUstreamCaptureMode)
 IREE_CU_PFN_DECL(cuStreamCreate, CUstream*, unsigned int)
 IREE_CU_PFN_DECL(cuStreamDestroy, CUstream)
+IREE_CU_PFN_DECL(cuStreamEndCapture, CUstream, CUgraph*)
+IREE_CU_PFN_DECL(cuStreamIsCapturing, CUstream, CUstreamCaptureStatus*)
 IREE_CU_PFN_DECL(cuStreamSynchronize, CUstream)
 IREE_CU_PFN_DECL(cuStreamWaitEvent, CUstream, CUevent, unsigned int)
 IREE_CU_PFN_DECL(cuMemsetD32Async, unsigned long long, unsigned int, size_t,
@@ -84,7 +113,10 @@ IREE_CU_PFN_DECL(cuMemsetD8Async, unsigned long long, unsigned char, size_t,
                  CUstream)
 IREE_CU_PFN_DECL(cuMemcpyAsync, CUdeviceptr, CUdeviceptr, size_t, CUstream)
 IREE_CU_PFN_DECL(cuMemcpyHtoDAsync, CUdeviceptr, const void*, size_t, CUstream)
+IREE_CU_PFN_DECL(cuFuncGetAttribute, int*, CUfunction_attribute, CUfunction)
 IREE_CU_PFN_DECL(cuFuncSetAttribute, CUfunction, CUfunction_attribute, int)
+IREE_CU_PFN_DECL(cuOccupancyMaxActiveBlocksPerMultiprocessor, int*, CUfunction,
+                 int, size_t)
 IREE_CU_PFN_DECL(cuLaunchKernel, CUfunction, unsigned int, unsigned int,
                  unsigned int, unsigned int, unsigned int, unsigned int,
                  unsigned int, CUstream, void**, void**)
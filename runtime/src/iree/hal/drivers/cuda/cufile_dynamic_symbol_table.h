@@ -0,0 +1,15 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+IREE_CUFILE_PFN_DECL(CUfileError_t, cuFileDriverOpen, void)
+IREE_CUFILE_PFN_DECL(CUfileError_t, cuFileDriverClose, void)
+IREE_CUFILE_PFN_DECL(CUfileError_t, cuFileHandleRegister, CUfileHandle_t*,
+                     CUfileDescr_t*)
+IREE_CUFILE_PFN_DECL(void, cuFileHandleDeregister, CUfileHandle_t)
+IREE_CUFILE_PFN_DECL(int64_t, cuFileRead, CUfileHandle_t, void*, size_t,
+                     int64_t, int64_t)
+IREE_CUFILE_PFN_DECL(int64_t, cuFileWrite, CUfileHandle_t, const void*, size_t,
+                     int64_t, int64_t)
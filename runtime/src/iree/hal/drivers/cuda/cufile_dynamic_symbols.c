@@ -0,0 +1,135 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbols.h"
+
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/dynamic_library.h"
+
+static const char* iree_hal_cuda_cufile_dylib_names[] = {
+    "libcufile.so.0",
+    "libcufile.so",
+};
+
+// Resolves all cuFile dynamic symbols in `cufile_dynamic_symbol_table.h`.
+static iree_status_t iree_hal_cuda_cufile_dynamic_symbols_resolve_all(
+    iree_hal_cuda_cufile_dynamic_symbols_t* syms) {
+#define IREE_CUFILE_PFN_DECL(result_type, cufile_symbol_name, ...) \
+  {                                                                \
+    static const char* name = #cufile_symbol_name;                 \
+    IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(       \
+        syms->dylib, name, (void**)&syms->cufile_symbol_name));    \
+  }
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbol_table.h"  // IWYU pragma: keep
+#undef IREE_CUFILE_PFN_DECL
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_cuda_cufile_dynamic_symbols_initialize(
+    iree_allocator_t host_allocator,
+    const iree_hal_cuda_dynamic_symbols_t* cuda_library,
+    iree_hal_cuda_cufile_dynamic_symbols_t* out_syms) {
+  IREE_ASSERT_ARGUMENT(out_syms);
+  if (!cuda_library->dylib) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "CUDA dynamic symbols must be resolved prior to "
+                            "loading cuFile symbols");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  memset(out_syms, 0, sizeof(*out_syms));
+#if defined(IREE_PLATFORM_LINUX) && !defined(IREE_PLATFORM_ANDROID)
+  iree_status_t status = iree_dynamic_library_load_from_files(
+      IREE_ARRAYSIZE(iree_hal_cuda_cufile_dylib_names),
+      iree_hal_cuda_cufile_dylib_names, IREE_DYNAMIC_LIBRARY_FLAG_NONE,
+      host_allocator, &out_syms->dylib);
+  if (iree_status_is_not_found(status)) {
+    iree_status_ignore(status);
+    status = iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "GPUDirect Storage cuFile library not available; ensure installed and "
+        "the shared library (libcufile.so) is on your LD_LIBRARY_PATH.");
+  }
+#else
+  iree_status_t status = iree_make_status(
+      IREE_STATUS_UNAVAILABLE,
+      "GPUDirect Storage is only available on Linux");
+#endif  // IREE_PLATFORM_LINUX && !IREE_PLATFORM_ANDROID
+
+  // Resolve all symbols; this will fail if any required symbols are missing.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_cufile_dynamic_symbols_resolve_all(out_syms);
+  }
+
+  // Opening the driver is relatively expensive (it probes the nvidia-fs
+  // kernel module and the configured filesystems) and is done once here
+  // instead of lazily on the first file registration.
+  if (iree_status_is_ok(status)) {
+    CUfileError_t result = out_syms->cuFileDriverOpen();
+    if (result.err != CU_FILE_SUCCESS) {
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "cuFileDriverOpen failed with error %d; "
+                                "GPUDirect Storage is not usable on this host",
+                                (int)result.err);
+    }
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_dynamic_library_release(out_syms->dylib);
+    memset(out_syms, 0, sizeof(*out_syms));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_cufile_dynamic_symbols_deinitialize(
+    iree_hal_cuda_cufile_dynamic_symbols_t* syms) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (syms->dylib && syms->cuFileDriverClose) {
+    syms->cuFileDriverClose();
+  }
+  iree_dynamic_library_release(syms->dylib);
+  memset(syms, 0, sizeof(*syms));
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_cuda_cufile_result_to_status(CUfileError_t result,
+                                                    const char* symbol,
+                                                    const char* file,
+                                                    uint32_t line) {
+  if (IREE_LIKELY(result.err == CU_FILE_SUCCESS)) {
+    return iree_ok_status();
+  }
+  iree_status_code_t code = IREE_STATUS_INTERNAL;
+  switch (result.err) {
+    case CU_FILE_PLATFORM_NOT_SUPPORTED:
+    case CU_FILE_IO_NOT_SUPPORTED:
+    case CU_FILE_DEVICE_NOT_SUPPORTED:
+    case CU_FILE_INVALID_FILE_TYPE:
+    case CU_FILE_DIO_NOT_SET:
+      code = IREE_STATUS_UNAVAILABLE;
+      break;
+    case CU_FILE_CUDA_POINTER_INVALID:
+    case CU_FILE_CUDA_MEMORY_TYPE_INVALID:
+    case CU_FILE_CUDA_POINTER_RANGE_ERROR:
+    case CU_FILE_INVALID_MAPPING_SIZE:
+    case CU_FILE_INVALID_MAPPING_RANGE:
+    case CU_FILE_INVALID_FILE_OPEN_FLAG:
+      code = IREE_STATUS_INVALID_ARGUMENT;
+      break;
+    default:
+      break;
+  }
+  return iree_make_status_with_location(file, line, code,
+                                        "cuFile error %d (CUresult %d): %s",
+                                        (int)result.err, (int)result.cu_err,
+                                        symbol);
+}
@@ -0,0 +1,70 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_CUFILE_DYNAMIC_SYMBOLS_H_
+#define IREE_HAL_DRIVERS_CUDA_CUFILE_DYNAMIC_SYMBOLS_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/dynamic_library.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cufile_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// iree_dynamic_library_t allows dynamically loading the subset of the
+// GPUDirect Storage cuFile API we use. We load all the symbols in
+// `cufile_dynamic_symbol_table.h` and fail if any of the symbols are not
+// available. The function signatures match the declarations in `cufile.h`.
+
+// cuFile API dynamic symbols.
+typedef struct iree_hal_cuda_cufile_dynamic_symbols_t {
+  // The dynamic library handle.
+  iree_dynamic_library_t* dylib;
+
+  // Concrete cuFile symbols defined by including the symbol table.
+#define IREE_CUFILE_PFN_DECL(result_type, cufileSymbolName, ...) \
+  result_type (*cufileSymbolName)(__VA_ARGS__);
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbol_table.h"  // IWYU pragma: export
+#undef IREE_CUFILE_PFN_DECL
+} iree_hal_cuda_cufile_dynamic_symbols_t;
+
+// Initializes |out_syms| in-place with dynamically loaded cuFile symbols and
+// opens the cuFile driver. Returns IREE_STATUS_UNAVAILABLE if the library is
+// not installed or the platform does not support GPUDirect Storage.
+// iree_hal_cuda_cufile_dynamic_symbols_deinitialize must be used to close the
+// driver and release the library resources.
+iree_status_t iree_hal_cuda_cufile_dynamic_symbols_initialize(
+    iree_allocator_t host_allocator,
+    const iree_hal_cuda_dynamic_symbols_t* cuda_library,
+    iree_hal_cuda_cufile_dynamic_symbols_t* out_syms);
+
+// Deinitializes |syms| by closing the cuFile driver and unloading the backing
+// library. All function pointers will be invalidated.
+void iree_hal_cuda_cufile_dynamic_symbols_deinitialize(
+    iree_hal_cuda_cufile_dynamic_symbols_t* syms);
+
+// Converts a CUfileError_t to an iree_status_t object.
+iree_status_t iree_hal_cuda_cufile_result_to_status(CUfileError_t result,
+                                                    const char* symbol,
+                                                    const char* file,
+                                                    uint32_t line);
+
+// Converts a CUfileError_t returned from |expr| to an iree_status_t.
+//
+// Usage:
+//   iree_status_t status = IREE_CUFILE_RESULT_TO_STATUS(cufile_symbols,
+//                                                       cuFileDoThing(...));
+#define IREE_CUFILE_RESULT_TO_STATUS(syms, expr)                  \
+  iree_hal_cuda_cufile_result_to_status(((syms)->expr), #expr, \
+                                        __FILE__, __LINE__)
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_CUFILE_DYNAMIC_SYMBOLS_H_
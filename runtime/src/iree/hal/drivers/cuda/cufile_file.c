@@ -0,0 +1,274 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/cufile_file.h"
+
+#include <errno.h>
+
+#include "iree/hal/drivers/cuda/cuda_buffer.h"
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
+
+typedef struct iree_hal_cuda_cufile_file_t {
+  iree_hal_resource_t resource;
+  // Used to allocate this structure.
+  iree_allocator_t host_allocator;
+  const iree_hal_cuda_dynamic_symbols_t* cuda_symbols;
+  const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols;
+  // Context device pointers are resolved in during transfers.
+  CUcontext cu_context;
+  // Allowed access bits.
+  iree_hal_memory_access_t access;
+  // Retained file descriptor handle.
+  iree_io_file_handle_t* handle;
+  // cuFile registration of the file descriptor in |handle|.
+  CUfileHandle_t cufile_handle;
+} iree_hal_cuda_cufile_file_t;
+
+static const iree_hal_file_vtable_t iree_hal_cuda_cufile_file_vtable;
+
+static iree_hal_cuda_cufile_file_t* iree_hal_cuda_cufile_file_cast(
+    iree_hal_file_t* IREE_RESTRICT base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_cuda_cufile_file_vtable);
+  return (iree_hal_cuda_cufile_file_t*)base_value;
+}
+
+iree_status_t iree_hal_cuda_cufile_file_create(
+    const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
+    const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols,
+    CUcontext cu_context, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(cuda_symbols);
+  IREE_ASSERT_ARGUMENT(cufile_symbols);
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  if (!cufile_symbols->dylib) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "GPUDirect Storage is not enabled");
+  }
+  if (iree_io_file_handle_type(handle) != IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "only file descriptors can be used with cuFile");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Registration fails if the file is not on a filesystem supported by
+  // GPUDirect Storage and we report that as unavailable so that the caller
+  // can use another file implementation.
+  CUfileDescr_t descriptor;
+  memset(&descriptor, 0, sizeof(descriptor));
+  descriptor.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+  descriptor.handle.fd = iree_io_file_handle_value(handle).fd;
+  CUfileHandle_t cufile_handle = NULL;
+  iree_status_t status = IREE_CUFILE_RESULT_TO_STATUS(
+      cufile_symbols, cuFileHandleRegister(&cufile_handle, &descriptor));
+  if (!iree_status_is_ok(status)) {
+    iree_status_code_t status_code = iree_status_consume_code(status);
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "file cannot be used with GPUDirect Storage "
+                              "(cuFileHandleRegister failed: %s)",
+                              iree_status_code_string(status_code));
+  }
+
+  iree_hal_cuda_cufile_file_t* file = NULL;
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_allocator_malloc(host_allocator, sizeof(*file), (void**)&file);
+    if (!iree_status_is_ok(status)) {
+      cufile_symbols->cuFileHandleDeregister(cufile_handle);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    iree_hal_resource_initialize(&iree_hal_cuda_cufile_file_vtable,
+                                 &file->resource);
+    file->host_allocator = host_allocator;
+    file->cuda_symbols = cuda_symbols;
+    file->cufile_symbols = cufile_symbols;
+    file->cu_context = cu_context;
+    file->access = access;
+    file->handle = handle;
+    iree_io_file_handle_retain(handle);
+    file->cufile_handle = cufile_handle;
+    *out_file = (iree_hal_file_t*)file;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_cuda_cufile_file_destroy(
+    iree_hal_file_t* IREE_RESTRICT base_file) {
+  iree_hal_cuda_cufile_file_t* file = iree_hal_cuda_cufile_file_cast(base_file);
+  iree_allocator_t host_allocator = file->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  file->cufile_symbols->cuFileHandleDeregister(file->cufile_handle);
+  iree_io_file_handle_release(file->handle);
+  iree_allocator_free(host_allocator, file);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_cuda_cufile_file_isa(iree_hal_file_t* file) {
+  return iree_hal_resource_is(file, &iree_hal_cuda_cufile_file_vtable);
+}
+
+// Transfers between the file and a host-visible buffer with positional I/O.
+// GPUDirect Storage only provides a direct path for device memory and would
+// otherwise bounce through its own staging buffers.
+static iree_status_t iree_hal_cuda_cufile_file_transfer_host(
+    iree_hal_cuda_cufile_file_t* file, bool is_read, uint64_t file_offset,
+    iree_hal_buffer_t* buffer, iree_device_size_t buffer_offset,
+    iree_device_size_t length) {
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+      is_read ? IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE
+              : IREE_HAL_MEMORY_ACCESS_READ,
+      buffer_offset, length, &mapping));
+
+  // Wrap the mapped memory so that the file handle copy utilities select the
+  // fastest positional I/O available.
+  iree_io_file_handle_t* mapping_handle = NULL;
+  iree_status_t status = iree_io_file_handle_wrap_host_allocation(
+      is_read ? IREE_IO_FILE_ACCESS_WRITE : IREE_IO_FILE_ACCESS_READ,
+      mapping.contents, iree_io_file_handle_release_callback_null(),
+      file->host_allocator, &mapping_handle);
+  if (iree_status_is_ok(status)) {
+    status = is_read ? iree_io_file_handle_copy_range(
+                           file->handle, file_offset, mapping_handle, 0,
+                           length, file->host_allocator)
+                     : iree_io_file_handle_copy_range(
+                           mapping_handle, 0, file->handle, file_offset,
+                           length, file->host_allocator);
+  }
+  iree_io_file_handle_release(mapping_handle);
+
+  if (iree_status_is_ok(status) && is_read) {
+    status = iree_hal_buffer_mapping_flush_range(&mapping, 0, length);
+  }
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+}
+
+// Transfers between the file and device memory with cuFile.
+static iree_status_t iree_hal_cuda_cufile_file_transfer_device(
+    iree_hal_cuda_cufile_file_t* file, bool is_read, uint64_t file_offset,
+    iree_hal_buffer_t* buffer, iree_device_size_t buffer_offset,
+    iree_device_size_t length) {
+  // cuFile takes the base of the allocation and an offset into it so that
+  // registered buffers can be looked up.
+  CUdeviceptr device_ptr = iree_hal_cuda_buffer_device_pointer(
+      iree_hal_buffer_allocated_buffer(buffer));
+  if (!device_ptr) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "buffer has no device pointer usable with cuFile");
+  }
+  uint64_t device_offset = iree_hal_buffer_byte_offset(buffer) + buffer_offset;
+
+  // Device pointers are resolved in the calling thread's current context.
+  IREE_CUDA_RETURN_IF_ERROR(file->cuda_symbols,
+                            cuCtxPushCurrent(file->cu_context),
+                            "cuCtxPushCurrent");
+
+  iree_status_t status = iree_ok_status();
+  uint64_t transferred = 0;
+  while (transferred < length) {
+    const uint64_t remaining = length - transferred;
+    int64_t result =
+        is_read ? file->cufile_symbols->cuFileRead(
+                      file->cufile_handle, (void*)device_ptr, (size_t)remaining,
+                      (int64_t)(file_offset + transferred),
+                      (int64_t)(device_offset + transferred))
+                : file->cufile_symbols->cuFileWrite(
+                      file->cufile_handle, (const void*)device_ptr,
+                      (size_t)remaining, (int64_t)(file_offset + transferred),
+                      (int64_t)(device_offset + transferred));
+    if (result == -1) {
+      // System errors are reported via errno.
+      int error_number = errno;
+      status = iree_make_status(iree_status_code_from_errno(error_number),
+                                "%s of %" PRIu64 " bytes at offset %" PRIu64
+                                " failed: %s",
+                                is_read ? "cuFileRead" : "cuFileWrite",
+                                remaining, file_offset + transferred,
+                                strerror(error_number));
+      break;
+    } else if (result < 0) {
+      CUfileError_t error = {(CUfileOpError)(-result), CUDA_SUCCESS};
+      status = iree_hal_cuda_cufile_result_to_status(
+          error, is_read ? "cuFileRead" : "cuFileWrite", __FILE__, __LINE__);
+      break;
+    } else if (result == 0) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "end of file reached at offset %" PRIu64
+                                " with %" PRIu64 " bytes remaining",
+                                file_offset + transferred, remaining);
+      break;
+    }
+    transferred += (uint64_t)result;
+  }
+
+  IREE_CUDA_IGNORE_ERROR(file->cuda_symbols, cuCtxPopCurrent(NULL));
+  return status;
+}
+
+static iree_status_t iree_hal_cuda_cufile_file_transfer(
+    iree_hal_file_t* base_file, bool is_read, uint64_t file_offset,
+    iree_hal_buffer_t* buffer, iree_device_size_t buffer_offset,
+    iree_device_size_t length) {
+  iree_hal_cuda_cufile_file_t* file = iree_hal_cuda_cufile_file_cast(base_file);
+  const iree_hal_memory_access_t required_access =
+      is_read ? IREE_HAL_MEMORY_ACCESS_READ : IREE_HAL_MEMORY_ACCESS_WRITE;
+  if (!iree_all_bits_set(file->access, required_access)) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "file does not allow %s access",
+                            is_read ? "read" : "write");
+  }
+  if (length == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, file_offset);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+
+  iree_status_t status = iree_ok_status();
+  if (iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                        IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
+      iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                        IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED)) {
+    status = iree_hal_cuda_cufile_file_transfer_host(
+        file, is_read, file_offset, buffer, buffer_offset, length);
+  } else {
+    status = iree_hal_cuda_cufile_file_transfer_device(
+        file, is_read, file_offset, buffer, buffer_offset, length);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_cufile_file_read(iree_hal_file_t* file,
+                                             uint64_t file_offset,
+                                             iree_hal_buffer_t* buffer,
+                                             iree_device_size_t buffer_offset,
+                                             iree_device_size_t length) {
+  return iree_hal_cuda_cufile_file_transfer(file, /*is_read=*/true,
+                                            file_offset, buffer, buffer_offset,
+                                            length);
+}
+
+iree_status_t iree_hal_cuda_cufile_file_write(iree_hal_file_t* file,
+                                              uint64_t file_offset,
+                                              iree_hal_buffer_t* buffer,
+                                              iree_device_size_t buffer_offset,
+                                              iree_device_size_t length) {
+  return iree_hal_cuda_cufile_file_transfer(file, /*is_read=*/false,
+                                            file_offset, buffer, buffer_offset,
+                                            length);
+}
+
+static const iree_hal_file_vtable_t iree_hal_cuda_cufile_file_vtable = {
+    .destroy = iree_hal_cuda_cufile_file_destroy,
+};
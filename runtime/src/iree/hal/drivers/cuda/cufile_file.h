@@ -0,0 +1,66 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_CUFILE_FILE_H_
+#define IREE_HAL_DRIVERS_CUDA_CUFILE_FILE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbols.h"
+#include "iree/io/file_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_cufile_file_t
+//===----------------------------------------------------------------------===//
+
+// Creates a file backed by a file descriptor |handle| registered with
+// GPUDirect Storage. Reads and writes of device-local buffers are DMAed
+// directly between the storage and device memory without staging through
+// host memory.
+//
+// Returns IREE_STATUS_UNAVAILABLE if the handle is not a file descriptor or
+// cuFile rejects it (such as when the file resides on a filesystem that does
+// not support GPUDirect Storage) so that callers can fall back to other file
+// implementations. For the direct path to be used the file descriptor should
+// be opened with O_DIRECT.
+iree_status_t iree_hal_cuda_cufile_file_create(
+    const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
+    const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols,
+    CUcontext cu_context, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file);
+
+// Returns true if |file| is a cuFile-backed file.
+bool iree_hal_cuda_cufile_file_isa(iree_hal_file_t* file);
+
+// Synchronously reads |length| bytes from |file| at |file_offset| into
+// |buffer| at |buffer_offset|. Host-visible buffers are read with positional
+// I/O and all other buffers are read with cuFileRead.
+iree_status_t iree_hal_cuda_cufile_file_read(iree_hal_file_t* file,
+                                             uint64_t file_offset,
+                                             iree_hal_buffer_t* buffer,
+                                             iree_device_size_t buffer_offset,
+                                             iree_device_size_t length);
+
+// Synchronously writes |length| bytes from |buffer| at |buffer_offset| into
+// |file| at |file_offset|. Host-visible buffers are written with positional
+// I/O and all other buffers are written with cuFileWrite.
+iree_status_t iree_hal_cuda_cufile_file_write(iree_hal_file_t* file,
+                                              uint64_t file_offset,
+                                              iree_hal_buffer_t* buffer,
+                                              iree_device_size_t buffer_offset,
+                                              iree_device_size_t length);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_CUFILE_FILE_H_
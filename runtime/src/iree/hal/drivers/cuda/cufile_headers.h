@@ -0,0 +1,67 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
+#define IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+// The subset of the GPUDirect Storage cuFile API (`cufile.h`) that we use.
+// cuFile is only distributed for 64-bit Linux and the library is always loaded
+// dynamically so we declare the ABI here instead of requiring the GDS headers
+// at build time. `ssize_t` and `off_t` are 64-bit on all supported platforms.
+
+typedef enum CUfileOpError {
+  CU_FILE_SUCCESS = 0,
+  CU_FILE_DRIVER_NOT_INITIALIZED = 5001,
+  CU_FILE_DRIVER_INVALID_PROPS = 5002,
+  CU_FILE_DRIVER_UNSUPPORTED_LIMIT = 5003,
+  CU_FILE_DRIVER_VERSION_MISMATCH = 5004,
+  CU_FILE_DRIVER_VERSION_READ_ERROR = 5005,
+  CU_FILE_DRIVER_CLOSING = 5006,
+  CU_FILE_PLATFORM_NOT_SUPPORTED = 5007,
+  CU_FILE_IO_NOT_SUPPORTED = 5008,
+  CU_FILE_DEVICE_NOT_SUPPORTED = 5009,
+  CU_FILE_NVFS_DRIVER_ERROR = 5010,
+  CU_FILE_CUDA_DRIVER_ERROR = 5011,
+  CU_FILE_CUDA_POINTER_INVALID = 5012,
+  CU_FILE_CUDA_MEMORY_TYPE_INVALID = 5013,
+  CU_FILE_CUDA_POINTER_RANGE_ERROR = 5014,
+  CU_FILE_CUDA_CONTEXT_MISMATCH = 5015,
+  CU_FILE_INVALID_MAPPING_SIZE = 5016,
+  CU_FILE_INVALID_MAPPING_RANGE = 5017,
+  CU_FILE_INVALID_FILE_TYPE = 5018,
+  CU_FILE_INVALID_FILE_OPEN_FLAG = 5019,
+  CU_FILE_DIO_NOT_SET = 5020,
+} CUfileOpError;
+
+typedef struct CUfileError {
+  CUfileOpError err;
+  CUresult cu_err;
+} CUfileError_t;
+
+typedef enum CUfileFileHandleType {
+  CU_FILE_HANDLE_TYPE_OPAQUE_FD = 1,
+  CU_FILE_HANDLE_TYPE_OPAQUE_WIN32 = 2,
+  CU_FILE_HANDLE_TYPE_USERSPACE_FS = 3,
+} CUfileFileHandleType;
+
+typedef struct CUfileDescr_t {
+  CUfileFileHandleType type;
+  union {
+    int fd;
+    void* handle;
+  } handle;
+  // Userspace filesystem callbacks; unused and must be NULL.
+  const void* fs_ops;
+} CUfileDescr_t;
+
+typedef void* CUfileHandle_t;
+
+#endif  // IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
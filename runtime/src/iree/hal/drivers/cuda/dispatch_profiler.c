@@ -0,0 +1,279 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/dispatch_profiler.h"
+
+#include <string.h>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
+
+typedef struct iree_hal_cuda_dispatch_profile_slot_t {
+  // Timing events recorded before and after the dispatch.
+  CUevent start_event;
+  CUevent end_event;
+  // True if the events have been recorded but the duration not yet resolved.
+  bool pending;
+  iree_hal_cuda_dispatch_profile_record_t record;
+} iree_hal_cuda_dispatch_profile_slot_t;
+
+struct iree_hal_cuda_dispatch_profiler_t {
+  iree_allocator_t host_allocator;
+  const iree_hal_cuda_dynamic_symbols_t* symbols;
+
+  // Guards all slot state and |dispatch_count|.
+  iree_slim_mutex_t mutex;
+
+  // Total number of dispatches recorded since the last reset. The slot used
+  // for each dispatch is its index modulo |capacity|.
+  uint64_t dispatch_count;
+
+  iree_host_size_t capacity;
+  iree_hal_cuda_dispatch_profile_slot_t slots[];
+};
+
+iree_status_t iree_hal_cuda_dispatch_profiler_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUcontext context,
+    iree_host_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_cuda_dispatch_profiler_t** out_profiler) {
+  IREE_ASSERT_ARGUMENT(symbols);
+  IREE_ASSERT_ARGUMENT(out_profiler);
+  *out_profiler = NULL;
+  if (capacity == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "dispatch profile capacity must be non-zero");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, capacity);
+
+  iree_hal_cuda_dispatch_profiler_t* profiler = NULL;
+  iree_host_size_t total_size =
+      sizeof(*profiler) + capacity * sizeof(profiler->slots[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&profiler));
+  memset(profiler, 0, total_size);
+  profiler->host_allocator = host_allocator;
+  profiler->symbols = symbols;
+  iree_slim_mutex_initialize(&profiler->mutex);
+  profiler->capacity = capacity;
+
+  // The profiler may be allocated from any thread so the device context must
+  // be made current in order to create the events.
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      symbols, cuCtxPushCurrent(context), "cuCtxPushCurrent");
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < capacity && iree_status_is_ok(status);
+         ++i) {
+      status = IREE_CURESULT_TO_STATUS(
+          symbols,
+          cuEventCreate(&profiler->slots[i].start_event, CU_EVENT_DEFAULT),
+          "cuEventCreate");
+      if (iree_status_is_ok(status)) {
+        status = IREE_CURESULT_TO_STATUS(
+            symbols,
+            cuEventCreate(&profiler->slots[i].end_event, CU_EVENT_DEFAULT),
+            "cuEventCreate");
+      }
+    }
+    IREE_CUDA_IGNORE_ERROR(symbols, cuCtxPopCurrent(NULL));
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_profiler = profiler;
+  } else {
+    iree_hal_cuda_dispatch_profiler_free(profiler);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_dispatch_profiler_free(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  if (!profiler) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = profiler->host_allocator;
+
+  for (iree_host_size_t i = 0; i < profiler->capacity; ++i) {
+    iree_hal_cuda_dispatch_profile_slot_t* slot = &profiler->slots[i];
+    if (slot->start_event) {
+      IREE_CUDA_IGNORE_ERROR(profiler->symbols,
+                             cuEventDestroy(slot->start_event));
+    }
+    if (slot->end_event) {
+      IREE_CUDA_IGNORE_ERROR(profiler->symbols,
+                             cuEventDestroy(slot->end_event));
+    }
+  }
+  iree_slim_mutex_deinitialize(&profiler->mutex);
+  iree_allocator_free(host_allocator, profiler);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_cuda_dispatch_profiler_reset(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  iree_slim_mutex_lock(&profiler->mutex);
+  for (iree_host_size_t i = 0; i < profiler->capacity; ++i) {
+    profiler->slots[i].pending = false;
+  }
+  profiler->dispatch_count = 0;
+  iree_slim_mutex_unlock(&profiler->mutex);
+}
+
+iree_host_size_t iree_hal_cuda_dispatch_profiler_begin_dispatch(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_hal_executable_t* executable, uint32_t export_ordinal,
+    iree_string_view_t function_name, const uint32_t workgroup_count[3],
+    const uint32_t workgroup_size[3]) {
+  iree_slim_mutex_lock(&profiler->mutex);
+  iree_host_size_t slot_index =
+      (iree_host_size_t)(profiler->dispatch_count++ % profiler->capacity);
+  iree_hal_cuda_dispatch_profile_slot_t* slot = &profiler->slots[slot_index];
+
+  iree_hal_cuda_dispatch_profile_record_t* record = &slot->record;
+  memset(record, 0, sizeof(*record));
+  function_name = iree_string_view_substr(function_name, 0,
+                                          sizeof(record->function_name) - 1);
+  memcpy(record->function_name, function_name.data, function_name.size);
+  record->executable_id = (uint64_t)(uintptr_t)executable;
+  record->export_ordinal = export_ordinal;
+  memcpy(record->workgroup_count, workgroup_count,
+         sizeof(record->workgroup_count));
+  memcpy(record->workgroup_size, workgroup_size,
+         sizeof(record->workgroup_size));
+  slot->pending = true;
+
+  IREE_CUDA_IGNORE_ERROR(profiler->symbols,
+                         cuEventRecord(slot->start_event, stream));
+  iree_slim_mutex_unlock(&profiler->mutex);
+  return slot_index;
+}
+
+void iree_hal_cuda_dispatch_profiler_end_dispatch(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_host_size_t slot) {
+  iree_slim_mutex_lock(&profiler->mutex);
+  IREE_CUDA_IGNORE_ERROR(
+      profiler->symbols,
+      cuEventRecord(profiler->slots[slot].end_event, stream));
+  iree_slim_mutex_unlock(&profiler->mutex);
+}
+
+// Returns the index of the oldest retained dispatch and the retained count.
+static void iree_hal_cuda_dispatch_profiler_window(
+    const iree_hal_cuda_dispatch_profiler_t* profiler,
+    uint64_t* out_first_index, iree_host_size_t* out_count) {
+  iree_host_size_t count = (iree_host_size_t)iree_min(
+      profiler->dispatch_count, (uint64_t)profiler->capacity);
+  *out_first_index = profiler->dispatch_count - count;
+  *out_count = count;
+}
+
+iree_status_t iree_hal_cuda_dispatch_profiler_collect(
+    iree_hal_cuda_dispatch_profiler_t* profiler) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&profiler->mutex);
+
+  uint64_t first_index = 0;
+  iree_host_size_t count = 0;
+  iree_hal_cuda_dispatch_profiler_window(profiler, &first_index, &count);
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    iree_hal_cuda_dispatch_profile_slot_t* slot =
+        &profiler->slots[(first_index + i) % profiler->capacity];
+    if (!slot->pending) continue;
+    status = IREE_CURESULT_TO_STATUS(profiler->symbols,
+                                     cuEventSynchronize(slot->end_event),
+                                     "cuEventSynchronize");
+    float duration_ms = 0.0f;
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          profiler->symbols,
+          cuEventElapsedTime(&duration_ms, slot->start_event, slot->end_event),
+          "cuEventElapsedTime");
+    }
+    if (iree_status_is_ok(status)) {
+      slot->record.duration_ns = (uint64_t)(duration_ms * 1000000.0);
+      slot->pending = false;
+    }
+  }
+
+  iree_slim_mutex_unlock(&profiler->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_dispatch_profiler_query(
+    iree_hal_cuda_dispatch_profiler_t* profiler, iree_host_size_t capacity,
+    iree_hal_cuda_dispatch_profile_record_t* out_records,
+    iree_host_size_t* out_count) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  IREE_ASSERT_ARGUMENT(out_count);
+  iree_slim_mutex_lock(&profiler->mutex);
+
+  uint64_t first_index = 0;
+  iree_host_size_t count = 0;
+  iree_hal_cuda_dispatch_profiler_window(profiler, &first_index, &count);
+
+  // Only the newest records are returned if the caller storage is too small.
+  iree_host_size_t copy_count = iree_min(count, capacity);
+  first_index += count - copy_count;
+  for (iree_host_size_t i = 0; i < copy_count; ++i) {
+    out_records[i] =
+        profiler->slots[(first_index + i) % profiler->capacity].record;
+  }
+  *out_count = count;
+
+  iree_slim_mutex_unlock(&profiler->mutex);
+}
+
+iree_status_t iree_hal_cuda_dispatch_profiler_write_file(
+    iree_hal_cuda_dispatch_profiler_t* profiler, const char* file_path) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  IREE_ASSERT_ARGUMENT(file_path);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(profiler->host_allocator, &builder);
+
+  iree_slim_mutex_lock(&profiler->mutex);
+  uint64_t first_index = 0;
+  iree_host_size_t count = 0;
+  iree_hal_cuda_dispatch_profiler_window(profiler, &first_index, &count);
+  iree_status_t status = iree_string_builder_append_format(
+      &builder,
+      "# %" PRIu64 " dispatches recorded, %" PRIhsz " retained\n"
+      "executable,export,function,workgroup_count_x,workgroup_count_y,"
+      "workgroup_count_z,workgroup_size_x,workgroup_size_y,workgroup_size_z,"
+      "duration_ns\n",
+      profiler->dispatch_count, count);
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    const iree_hal_cuda_dispatch_profile_record_t* record =
+        &profiler->slots[(first_index + i) % profiler->capacity].record;
+    status = iree_string_builder_append_format(
+        &builder,
+        "0x%016" PRIx64 ",%u,%s,%u,%u,%u,%u,%u,%u,%" PRIu64 "\n",
+        record->executable_id, record->export_ordinal, record->function_name,
+        record->workgroup_count[0], record->workgroup_count[1],
+        record->workgroup_count[2], record->workgroup_size[0],
+        record->workgroup_size[1], record->workgroup_size[2],
+        record->duration_ns);
+  }
+  iree_slim_mutex_unlock(&profiler->mutex);
+
+  if (iree_status_is_ok(status)) {
+    status = iree_file_write_contents(
+        file_path,
+        iree_make_const_byte_span(iree_string_builder_buffer(&builder),
+                                  iree_string_builder_size(&builder)));
+  }
+
+  iree_string_builder_deinitialize(&builder);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,92 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_DISPATCH_PROFILER_H_
+#define IREE_HAL_DRIVERS_CUDA_DISPATCH_PROFILER_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/api.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Records per-dispatch device timings into a fixed-capacity ring buffer.
+// This is used to implement IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS
+// and works in all build configurations as it does not depend on Tracy.
+//
+// Each dispatch is bracketed by a pair of timing CUevents recorded on the
+// stream it is issued to. Timings are resolved lazily when the profile is
+// collected so recording a dispatch never blocks. When more dispatches are
+// recorded than the profiler has capacity for the oldest are overwritten.
+//
+// Usage:
+//   iree_host_size_t slot =
+//       iree_hal_cuda_dispatch_profiler_begin_dispatch(profiler, stream, ...);
+//   cuLaunchKernel(..., stream);
+//   iree_hal_cuda_dispatch_profiler_end_dispatch(profiler, stream, slot);
+//   ...
+//   iree_hal_cuda_dispatch_profiler_collect(profiler);
+//
+// Thread-safe: dispatches may be recorded from multiple threads and streams.
+typedef struct iree_hal_cuda_dispatch_profiler_t
+    iree_hal_cuda_dispatch_profiler_t;
+
+// Allocates a profiler able to retain the last |capacity| dispatches.
+// The events used for timing are created in |context|.
+iree_status_t iree_hal_cuda_dispatch_profiler_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUcontext context,
+    iree_host_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_cuda_dispatch_profiler_t** out_profiler);
+
+// Frees the profiler and all associated CUDA resources.
+// All submissions using the profiler must be completed prior to calling.
+void iree_hal_cuda_dispatch_profiler_free(
+    iree_hal_cuda_dispatch_profiler_t* profiler);
+
+// Discards all recorded dispatches.
+void iree_hal_cuda_dispatch_profiler_reset(
+    iree_hal_cuda_dispatch_profiler_t* profiler);
+
+// Records the start of a dispatch of |export_ordinal| in |executable| on
+// |stream| and returns the slot that must be passed to the matching
+// iree_hal_cuda_dispatch_profiler_end_dispatch.
+iree_host_size_t iree_hal_cuda_dispatch_profiler_begin_dispatch(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_hal_executable_t* executable, uint32_t export_ordinal,
+    iree_string_view_t function_name, const uint32_t workgroup_count[3],
+    const uint32_t workgroup_size[3]);
+
+// Records the end of the dispatch started in |slot| on |stream|.
+void iree_hal_cuda_dispatch_profiler_end_dispatch(
+    iree_hal_cuda_dispatch_profiler_t* profiler, CUstream stream,
+    iree_host_size_t slot);
+
+// Waits for all recorded dispatches to complete and resolves their timings.
+iree_status_t iree_hal_cuda_dispatch_profiler_collect(
+    iree_hal_cuda_dispatch_profiler_t* profiler);
+
+// Copies up to |capacity| of the most recently collected dispatch records into
+// |out_records| ordered from oldest to newest. |out_count| is set to the total
+// number of records available which may be larger than |capacity|; callers can
+// pass a |capacity| of 0 to query the required storage size.
+void iree_hal_cuda_dispatch_profiler_query(
+    iree_hal_cuda_dispatch_profiler_t* profiler, iree_host_size_t capacity,
+    iree_hal_cuda_dispatch_profile_record_t* out_records,
+    iree_host_size_t* out_count);
+
+// Writes all collected dispatch records to |file_path| as CSV.
+iree_status_t iree_hal_cuda_dispatch_profiler_write_file(
+    iree_hal_cuda_dispatch_profiler_t* profiler, const char* file_path);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_DISPATCH_PROFILER_H_
@@ -10,6 +10,7 @@
 #include "iree/base/internal/wait_handle.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_status_util.h"
+#include "iree/hal/drivers/cuda/external_semaphore.h"
 #include "iree/hal/drivers/cuda/timepoint_pool.h"
 #include "iree/hal/utils/semaphore_base.h"
 
@@ -263,6 +264,12 @@ static iree_status_t iree_hal_cuda_semaphore_try_wait_or_acquire_wait_timepoint(
     iree_hal_semaphore_t* base_semaphore, uint64_t value,
     iree_timeout_t timeout, iree_hal_cuda_timepoint_t** out_timepoint) {
   *out_timepoint = NULL;
+  if (iree_hal_cuda_external_semaphore_isa(base_semaphore)) {
+    // Imported semaphores do not support host waits; route through the
+    // semaphore to get its error.
+    return iree_hal_semaphore_wait(base_semaphore, value,
+                                   iree_immediate_timeout());
+  }
   iree_hal_cuda_semaphore_t* semaphore =
       iree_hal_cuda_semaphore_cast(base_semaphore);
   IREE_TRACE_ZONE_BEGIN(z0);
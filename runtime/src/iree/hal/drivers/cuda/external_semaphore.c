@@ -0,0 +1,276 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/external_semaphore.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
+#include "iree/hal/utils/semaphore_base.h"
+
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <unistd.h>
+#endif  // !IREE_PLATFORM_WINDOWS
+
+typedef struct iree_hal_cuda_external_semaphore_t {
+  // Abstract resource used for injecting reference counting and vtable;
+  // must be at offset 0.
+  iree_hal_semaphore_t base;
+
+  // The allocator used to create this semaphore.
+  iree_allocator_t host_allocator;
+  // The symbols used to issue CUDA API calls.
+  const iree_hal_cuda_dynamic_symbols_t* symbols;
+
+  // Imported CUDA handle; the exporting semaphore owns the timeline payload.
+  CUexternalSemaphore handle;
+
+  // Guards failure_status.
+  iree_slim_mutex_t mutex;
+  // OK or the status passed to iree_hal_semaphore_fail. Owned by the semaphore.
+  iree_status_t failure_status IREE_GUARDED_BY(mutex);
+} iree_hal_cuda_external_semaphore_t;
+
+static const iree_hal_semaphore_vtable_t
+    iree_hal_cuda_external_semaphore_vtable;
+
+static iree_hal_cuda_external_semaphore_t*
+iree_hal_cuda_external_semaphore_cast(iree_hal_semaphore_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_cuda_external_semaphore_vtable);
+  return (iree_hal_cuda_external_semaphore_t*)base_value;
+}
+
+bool iree_hal_cuda_external_semaphore_isa(iree_hal_semaphore_t* semaphore) {
+  return iree_hal_resource_is(&semaphore->resource,
+                              &iree_hal_cuda_external_semaphore_vtable);
+}
+
+CUexternalSemaphore iree_hal_cuda_external_semaphore_handle(
+    iree_hal_semaphore_t* base_semaphore) {
+  return iree_hal_cuda_external_semaphore_cast(base_semaphore)->handle;
+}
+
+// Populates |out_desc| from |external_semaphore|. File descriptors are
+// duplicated as CUDA takes ownership of them on successful import while the
+// caller retains ownership of the one they passed in.
+static iree_status_t iree_hal_cuda_external_semaphore_make_handle_desc(
+    const iree_hal_external_semaphore_t* external_semaphore,
+    CUDA_EXTERNAL_SEMAPHORE_HANDLE_DESC* out_desc) {
+  memset(out_desc, 0, sizeof(*out_desc));
+  switch (external_semaphore->type) {
+#if !defined(IREE_PLATFORM_WINDOWS)
+    case IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD: {
+      int fd = dup(external_semaphore->handle.opaque_fd.fd);
+      if (fd < 0) {
+        return iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to duplicate semaphore fd %d",
+                                external_semaphore->handle.opaque_fd.fd);
+      }
+      out_desc->type = CU_EXTERNAL_SEMAPHORE_HANDLE_TYPE_TIMELINE_SEMAPHORE_FD;
+      out_desc->handle.fd = fd;
+      return iree_ok_status();
+    }
+#else
+    case IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_WIN32: {
+      // CUDA does not take ownership of NT handles.
+      out_desc->type =
+          CU_EXTERNAL_SEMAPHORE_HANDLE_TYPE_TIMELINE_SEMAPHORE_WIN32;
+      out_desc->handle.win32.handle =
+          external_semaphore->handle.opaque_win32.handle;
+      return iree_ok_status();
+    }
+#endif  // !IREE_PLATFORM_WINDOWS
+    default:
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "external semaphore type %d not supported",
+                              (int)external_semaphore->type);
+  }
+}
+
+iree_status_t iree_hal_cuda_external_semaphore_import(
+    const iree_hal_cuda_dynamic_symbols_t* symbols,
+    const iree_hal_external_semaphore_t* external_semaphore,
+    iree_hal_external_semaphore_flags_t flags, iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore) {
+  IREE_ASSERT_ARGUMENT(symbols);
+  IREE_ASSERT_ARGUMENT(external_semaphore);
+  IREE_ASSERT_ARGUMENT(out_semaphore);
+  *out_semaphore = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (!symbols->cuImportExternalSemaphore) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "CUDA driver does not support external semaphores");
+  }
+
+  CUDA_EXTERNAL_SEMAPHORE_HANDLE_DESC handle_desc;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_external_semaphore_make_handle_desc(external_semaphore,
+                                                            &handle_desc));
+
+  CUexternalSemaphore handle = NULL;
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      symbols, cuImportExternalSemaphore(&handle, &handle_desc),
+      "cuImportExternalSemaphore");
+  if (!iree_status_is_ok(status)) {
+#if !defined(IREE_PLATFORM_WINDOWS)
+    // Ownership of the duplicated fd only transfers on success.
+    if (handle_desc.type ==
+        CU_EXTERNAL_SEMAPHORE_HANDLE_TYPE_TIMELINE_SEMAPHORE_FD) {
+      close(handle_desc.handle.fd);
+    }
+#endif  // !IREE_PLATFORM_WINDOWS
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_hal_cuda_external_semaphore_t* semaphore = NULL;
+  status = iree_allocator_malloc(host_allocator, sizeof(*semaphore),
+                                 (void**)&semaphore);
+  if (!iree_status_is_ok(status)) {
+    IREE_CUDA_IGNORE_ERROR(symbols, cuDestroyExternalSemaphore(handle));
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_hal_semaphore_initialize(&iree_hal_cuda_external_semaphore_vtable,
+                                &semaphore->base);
+  semaphore->host_allocator = host_allocator;
+  semaphore->symbols = symbols;
+  semaphore->handle = handle;
+  iree_slim_mutex_initialize(&semaphore->mutex);
+  semaphore->failure_status = iree_ok_status();
+
+  *out_semaphore = &semaphore->base;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_cuda_external_semaphore_destroy(
+    iree_hal_semaphore_t* base_semaphore) {
+  iree_hal_cuda_external_semaphore_t* semaphore =
+      iree_hal_cuda_external_semaphore_cast(base_semaphore);
+  iree_allocator_t host_allocator = semaphore->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  IREE_CUDA_IGNORE_ERROR(semaphore->symbols,
+                         cuDestroyExternalSemaphore(semaphore->handle));
+  iree_status_ignore(semaphore->failure_status);
+  iree_slim_mutex_deinitialize(&semaphore->mutex);
+
+  iree_hal_semaphore_deinitialize(&semaphore->base);
+  iree_allocator_free(host_allocator, semaphore);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns a clone of the failure status if the semaphore has failed.
+static iree_status_t iree_hal_cuda_external_semaphore_check_failure(
+    iree_hal_cuda_external_semaphore_t* semaphore) {
+  iree_slim_mutex_lock(&semaphore->mutex);
+  iree_status_t status = iree_status_clone(semaphore->failure_status);
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return status;
+}
+
+static iree_status_t iree_hal_cuda_external_semaphore_query(
+    iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
+  iree_hal_cuda_external_semaphore_t* semaphore =
+      iree_hal_cuda_external_semaphore_cast(base_semaphore);
+  *out_value = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_external_semaphore_check_failure(semaphore));
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "imported CUDA semaphores are device-only; query "
+                          "the exporting semaphore instead");
+}
+
+static iree_status_t iree_hal_cuda_external_semaphore_signal(
+    iree_hal_semaphore_t* base_semaphore, uint64_t new_value) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "imported CUDA semaphores are device-only; signal "
+                          "the exporting semaphore instead");
+}
+
+static void iree_hal_cuda_external_semaphore_fail(
+    iree_hal_semaphore_t* base_semaphore, iree_status_t status) {
+  iree_hal_cuda_external_semaphore_t* semaphore =
+      iree_hal_cuda_external_semaphore_cast(base_semaphore);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_status_code_t status_code = iree_status_code(status);
+
+  // Only the first failure is preserved. The failure is local to this import:
+  // the exporting semaphore is not failed and device waiters are not released.
+  iree_slim_mutex_lock(&semaphore->mutex);
+  if (!iree_status_is_ok(semaphore->failure_status)) {
+    IREE_IGNORE_ERROR(status);
+    iree_slim_mutex_unlock(&semaphore->mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return;
+  }
+  semaphore->failure_status = status;
+  iree_slim_mutex_unlock(&semaphore->mutex);
+
+  iree_hal_semaphore_notify(&semaphore->base, IREE_HAL_SEMAPHORE_FAILURE_VALUE,
+                            status_code);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_hal_cuda_external_semaphore_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value,
+    iree_timeout_t timeout) {
+  iree_hal_cuda_external_semaphore_t* semaphore =
+      iree_hal_cuda_external_semaphore_cast(base_semaphore);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_external_semaphore_check_failure(semaphore));
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "imported CUDA semaphores are device-only; wait on "
+                          "the exporting semaphore instead");
+}
+
+iree_status_t iree_hal_cuda_external_semaphore_enqueue_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value, CUstream stream) {
+  iree_hal_cuda_external_semaphore_t* semaphore =
+      iree_hal_cuda_external_semaphore_cast(base_semaphore);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_external_semaphore_check_failure(semaphore));
+  CUDA_EXTERNAL_SEMAPHORE_WAIT_PARAMS params;
+  memset(&params, 0, sizeof(params));
+  params.params.fence.value = value;
+  return IREE_CURESULT_TO_STATUS(
+      semaphore->symbols,
+      cuWaitExternalSemaphoresAsync(&semaphore->handle, &params, 1, stream),
+      "cuWaitExternalSemaphoresAsync");
+}
+
+iree_status_t iree_hal_cuda_external_semaphore_enqueue_signal(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value, CUstream stream) {
+  iree_hal_cuda_external_semaphore_t* semaphore =
+      iree_hal_cuda_external_semaphore_cast(base_semaphore);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_external_semaphore_check_failure(semaphore));
+  CUDA_EXTERNAL_SEMAPHORE_SIGNAL_PARAMS params;
+  memset(&params, 0, sizeof(params));
+  params.params.fence.value = value;
+  return IREE_CURESULT_TO_STATUS(
+      semaphore->symbols,
+      cuSignalExternalSemaphoresAsync(&semaphore->handle, &params, 1, stream),
+      "cuSignalExternalSemaphoresAsync");
+}
+
+static const iree_hal_semaphore_vtable_t
+    iree_hal_cuda_external_semaphore_vtable = {
+        .destroy = iree_hal_cuda_external_semaphore_destroy,
+        .query = iree_hal_cuda_external_semaphore_query,
+        .signal = iree_hal_cuda_external_semaphore_signal,
+        .fail = iree_hal_cuda_external_semaphore_fail,
+        .wait = iree_hal_cuda_external_semaphore_wait,
+};
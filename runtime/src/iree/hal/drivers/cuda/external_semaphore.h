@@ -0,0 +1,54 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_EXTERNAL_SEMAPHORE_H_
+#define IREE_HAL_DRIVERS_CUDA_EXTERNAL_SEMAPHORE_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Imports an |external_semaphore| timeline exported by another device or
+// driver (such as a Vulkan timeline semaphore) as a CUexternalSemaphore.
+//
+// Imported semaphores are device-only: queue operations wait on and signal
+// them directly on CUDA streams without waking the host. Host queries, waits,
+// and signals are unavailable and must be performed on the semaphore the
+// handle was exported from.
+iree_status_t iree_hal_cuda_external_semaphore_import(
+    const iree_hal_cuda_dynamic_symbols_t* symbols,
+    const iree_hal_external_semaphore_t* external_semaphore,
+    iree_hal_external_semaphore_flags_t flags, iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore);
+
+// Returns true if |semaphore| is a CUDA external semaphore.
+bool iree_hal_cuda_external_semaphore_isa(iree_hal_semaphore_t* semaphore);
+
+// Returns the CUDA handle backing the external |semaphore|.
+CUexternalSemaphore iree_hal_cuda_external_semaphore_handle(
+    iree_hal_semaphore_t* semaphore);
+
+// Enqueues a wait on |stream| until the external |semaphore| timeline reaches
+// at least |value|.
+iree_status_t iree_hal_cuda_external_semaphore_enqueue_wait(
+    iree_hal_semaphore_t* semaphore, uint64_t value, CUstream stream);
+
+// Enqueues a signal of the external |semaphore| timeline to |value| on
+// |stream| after all prior work on the stream has completed.
+iree_status_t iree_hal_cuda_external_semaphore_enqueue_signal(
+    iree_hal_semaphore_t* semaphore, uint64_t value, CUstream stream);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_EXTERNAL_SEMAPHORE_H_
@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/nccl_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
 
 #ifdef __cplusplus
@@ -24,9 +25,13 @@ typedef struct iree_hal_cuda_tracing_context_t iree_hal_cuda_tracing_context_t;
 // |block_pool| will be used by the graph command buffer to retain copies of
 // input data until reset. It must remain live for the lifetime of the command
 // buffers that use it.
+//
+// Collective operations are captured from a scratch stream with
+// |nccl_symbols| and added to the graph as child graph nodes.
 iree_status_t iree_hal_cuda_graph_command_buffer_create(
     iree_hal_device_t* device,
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
+    const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
     iree_hal_cuda_tracing_context_t* tracing_context, CUcontext context,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
@@ -42,6 +47,14 @@ bool iree_hal_cuda_graph_command_buffer_isa(
 CUgraphExec iree_hal_cuda_graph_command_buffer_handle(
     iree_hal_command_buffer_t* command_buffer);
 
+// Updates the kernel parameters of the instantiated graph that reference
+// binding table slots with the buffers in |binding_table|. Must be called
+// prior to each launch of a command buffer with a non-zero binding capacity.
+// Launches already enqueued are not affected.
+iree_status_t iree_hal_cuda_graph_command_buffer_update_bindings(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
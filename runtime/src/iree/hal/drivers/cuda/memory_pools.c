@@ -26,10 +26,21 @@ static iree_status_t iree_hal_cuda_create_memory_pool(
     CUmemoryPool* IREE_RESTRICT out_pool) {
   *out_pool = NULL;
 
+  CUmemAllocationHandleType handle_types = CU_MEM_HANDLE_TYPE_NONE;
+  if (params.shareable) {
+#if defined(IREE_PLATFORM_WINDOWS)
+    // TODO: support sharing by HANDLE; requires security attributes.
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "shareable memory pools are only supported with "
+                            "POSIX file descriptors");
+#else
+    handle_types = CU_MEM_HANDLE_TYPE_POSIX_FILE_DESCRIPTOR;
+#endif  // IREE_PLATFORM_WINDOWS
+  }
+
   CUmemPoolProps pool_props = {
       .allocType = CU_MEM_ALLOCATION_TYPE_PINNED,
-      // TODO: allow sharing of certain pool memory types by fd/HANDLE.
-      .handleTypes = CU_MEM_HANDLE_TYPE_NONE,
+      .handleTypes = handle_types,
       .location =
           {
               .type = CU_MEM_LOCATION_TYPE_DEVICE,
@@ -59,29 +70,34 @@ static iree_status_t iree_hal_cuda_create_memory_pool(
 
 iree_status_t iree_hal_cuda_memory_pools_initialize(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols, CUdevice cu_device,
+    iree_host_size_t queue_count,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params,
     iree_allocator_t host_allocator,
     iree_hal_cuda_memory_pools_t* IREE_RESTRICT out_pools) {
   IREE_ASSERT_ARGUMENT(cuda_symbols);
   IREE_ASSERT_ARGUMENT(pooling_params);
   IREE_ASSERT_ARGUMENT(out_pools);
+  IREE_ASSERT(queue_count > 0 && queue_count <= IREE_HAL_CUDA_MAX_QUEUE_COUNT);
   IREE_TRACE_ZONE_BEGIN(z0);
 
   memset(out_pools, 0, sizeof(*out_pools));
+  out_pools->set_count = pooling_params->per_queue ? queue_count : 1;
+  out_pools->cu_device = cu_device;
   out_pools->cuda_symbols = cuda_symbols;
   out_pools->host_allocator = host_allocator;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)out_pools->set_count);
 
   iree_status_t status = iree_ok_status();
-
-  if (iree_status_is_ok(status)) {
-    status = iree_hal_cuda_create_memory_pool(cuda_symbols, cu_device,
-                                              pooling_params->device_local,
-                                              &out_pools->device_local);
-  }
-
-  if (iree_status_is_ok(status)) {
+  for (iree_host_size_t i = 0;
+       i < out_pools->set_count && iree_status_is_ok(status); ++i) {
     status = iree_hal_cuda_create_memory_pool(
-        cuda_symbols, cu_device, pooling_params->other, &out_pools->other);
+        cuda_symbols, cu_device, pooling_params->device_local,
+        &out_pools->sets[i].device_local);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_cuda_create_memory_pool(cuda_symbols, cu_device,
+                                                pooling_params->other,
+                                                &out_pools->sets[i].other);
+    }
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -92,20 +108,28 @@ void iree_hal_cuda_memory_pools_deinitialize(
     iree_hal_cuda_memory_pools_t* pools) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  if (pools->device_local) {
-    IREE_CUDA_IGNORE_ERROR(pools->cuda_symbols,
-                           cuMemPoolDestroy(pools->device_local));
-    pools->device_local = NULL;
-  }
-
-  if (pools->other) {
-    IREE_CUDA_IGNORE_ERROR(pools->cuda_symbols, cuMemPoolDestroy(pools->other));
-    pools->other = NULL;
+  for (iree_host_size_t i = 0; i < pools->set_count; ++i) {
+    if (pools->sets[i].device_local) {
+      IREE_CUDA_IGNORE_ERROR(pools->cuda_symbols,
+                             cuMemPoolDestroy(pools->sets[i].device_local));
+      pools->sets[i].device_local = NULL;
+    }
+    if (pools->sets[i].other) {
+      IREE_CUDA_IGNORE_ERROR(pools->cuda_symbols,
+                             cuMemPoolDestroy(pools->sets[i].other));
+      pools->sets[i].other = NULL;
+    }
   }
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns the index of the pool set used by the queue at |queue_index|.
+static iree_host_size_t iree_hal_cuda_memory_pools_select_set(
+    const iree_hal_cuda_memory_pools_t* pools, iree_host_size_t queue_index) {
+  return pools->set_count == 1 ? 0 : queue_index % pools->set_count;
+}
+
 static void iree_hal_cuda_memory_pool_track_alloc(
     iree_hal_cuda_memory_pools_t* pools, iree_hal_buffer_t* buffer) {
   bool is_device_local = iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
@@ -123,6 +147,24 @@ static void iree_hal_cuda_memory_pool_track_alloc(
                         : &pools->statistics.host_bytes_allocated;
     iree_atomic_fetch_add_int64(bytes_allocated, allocation_size,
                                 iree_memory_order_relaxed);
+    iree_hal_allocation_tag_t tag = iree_hal_buffer_allocation_tag(buffer);
+    if (tag >= IREE_HAL_ALLOCATION_TAG_COUNT) {
+      tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
+    }
+    int64_t bytes_live =
+        iree_atomic_fetch_add_int64(&pools->statistics.tags[tag].bytes_live,
+                                    allocation_size,
+                                    iree_memory_order_relaxed) +
+        allocation_size;
+    int64_t bytes_peak = iree_atomic_load_int64(
+        &pools->statistics.tags[tag].bytes_peak, iree_memory_order_relaxed);
+    while (bytes_peak < bytes_live) {
+      if (iree_atomic_compare_exchange_weak_int64(
+              &pools->statistics.tags[tag].bytes_peak, &bytes_peak, bytes_live,
+              iree_memory_order_relaxed, iree_memory_order_relaxed)) {
+        break;
+      }
+    }
   });
 }
 
@@ -143,6 +185,12 @@ static void iree_hal_cuda_memory_pool_track_free(
         iree_hal_buffer_allocation_size(buffer);
     iree_atomic_fetch_add_int64(bytes_freed, allocation_size,
                                 iree_memory_order_relaxed);
+    iree_hal_allocation_tag_t tag = iree_hal_buffer_allocation_tag(buffer);
+    if (tag >= IREE_HAL_ALLOCATION_TAG_COUNT) {
+      tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
+    }
+    iree_atomic_fetch_sub_int64(&pools->statistics.tags[tag].bytes_live,
+                                allocation_size, iree_memory_order_relaxed);
   });
 }
 
@@ -158,21 +206,29 @@ void iree_hal_cuda_memory_pools_merge_statistics(
         &pools->statistics.device_bytes_freed, iree_memory_order_relaxed);
     statistics->host_bytes_freed = iree_atomic_load_int64(
         &pools->statistics.host_bytes_freed, iree_memory_order_relaxed);
-    if (pools->device_local) {
-      cuuint64_t pool_peak = 0;
-      IREE_CUDA_IGNORE_ERROR(
-          pools->cuda_symbols,
-          cuMemPoolGetAttribute(pools->device_local,
-                                CU_MEMPOOL_ATTR_USED_MEM_HIGH, &pool_peak));
-      statistics->device_bytes_peak += (iree_device_size_t)pool_peak;
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(statistics->tags); ++i) {
+      statistics->tags[i].bytes_live += iree_atomic_load_int64(
+          &pools->statistics.tags[i].bytes_live, iree_memory_order_relaxed);
+      statistics->tags[i].bytes_peak += iree_atomic_load_int64(
+          &pools->statistics.tags[i].bytes_peak, iree_memory_order_relaxed);
     }
-    if (pools->other) {
-      cuuint64_t pool_peak = 0;
-      IREE_CUDA_IGNORE_ERROR(
-          pools->cuda_symbols,
-          cuMemPoolGetAttribute(pools->other, CU_MEMPOOL_ATTR_USED_MEM_HIGH,
-                                &pool_peak));
-      statistics->host_bytes_peak += (iree_device_size_t)pool_peak;
+    for (iree_host_size_t i = 0; i < pools->set_count; ++i) {
+      if (pools->sets[i].device_local) {
+        cuuint64_t pool_peak = 0;
+        IREE_CUDA_IGNORE_ERROR(
+            pools->cuda_symbols,
+            cuMemPoolGetAttribute(pools->sets[i].device_local,
+                                  CU_MEMPOOL_ATTR_USED_MEM_HIGH, &pool_peak));
+        statistics->device_bytes_peak += (iree_device_size_t)pool_peak;
+      }
+      if (pools->sets[i].other) {
+        cuuint64_t pool_peak = 0;
+        IREE_CUDA_IGNORE_ERROR(
+            pools->cuda_symbols,
+            cuMemPoolGetAttribute(pools->sets[i].other,
+                                  CU_MEMPOOL_ATTR_USED_MEM_HIGH, &pool_peak));
+        statistics->host_bytes_peak += (iree_device_size_t)pool_peak;
+      }
     }
   });
 }
@@ -180,15 +236,18 @@ void iree_hal_cuda_memory_pools_merge_statistics(
 iree_status_t iree_hal_cuda_memory_pools_trim(
     iree_hal_cuda_memory_pools_t* pools,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params) {
-  IREE_CUDA_RETURN_IF_ERROR(
-      pools->cuda_symbols,
-      cuMemPoolTrimTo(pools->device_local,
-                      pooling_params->device_local.minimum_capacity),
-      "cuMemPoolTrimTo");
-  IREE_CUDA_RETURN_IF_ERROR(
-      pools->cuda_symbols,
-      cuMemPoolTrimTo(pools->other, pooling_params->other.minimum_capacity),
-      "cuMemPoolTrimTo");
+  for (iree_host_size_t i = 0; i < pools->set_count; ++i) {
+    IREE_CUDA_RETURN_IF_ERROR(
+        pools->cuda_symbols,
+        cuMemPoolTrimTo(pools->sets[i].device_local,
+                        pooling_params->device_local.minimum_capacity),
+        "cuMemPoolTrimTo");
+    IREE_CUDA_RETURN_IF_ERROR(
+        pools->cuda_symbols,
+        cuMemPoolTrimTo(pools->sets[i].other,
+                        pooling_params->other.minimum_capacity),
+        "cuMemPoolTrimTo");
+  }
   return iree_ok_status();
 }
 
@@ -209,7 +268,8 @@ static void iree_hal_cuda_async_buffer_release_callback(
 }
 
 iree_status_t iree_hal_cuda_memory_pools_alloca(
-    iree_hal_cuda_memory_pools_t* pools, CUstream stream,
+    iree_hal_cuda_memory_pools_t* pools, iree_host_size_t queue_index,
+    CUstream stream,
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
@@ -218,15 +278,17 @@ iree_status_t iree_hal_cuda_memory_pools_alloca(
 
   iree_hal_buffer_params_canonicalize(&params);
 
-  // TODO: more pools and better selection; this is coarsely deciding between
-  // only device local (variables, constants, transients) and other (staging,
-  // external) but could use more buffer properties (including usage/export
-  // flags) to better isolate the different usage patterns and keep the pools
-  // operating with reasonable limits. We should be using the |pool| arg.
+  // TODO: better selection; this is coarsely deciding between only device
+  // local (variables, constants, transients) and other (staging, external) but
+  // could use more buffer properties (including usage/export flags) to better
+  // isolate the different usage patterns and keep the pools operating with
+  // reasonable limits. We should be using the |pool| arg.
+  const iree_host_size_t set_index =
+      iree_hal_cuda_memory_pools_select_set(pools, queue_index);
   CUmemoryPool memory_pool =
       iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)
-          ? pools->device_local
-          : pools->other;
+          ? pools->sets[set_index].device_local
+          : pools->sets[set_index].other;
 
   CUdeviceptr device_ptr = 0;
   iree_status_t status = IREE_CURESULT_TO_STATUS(
@@ -255,6 +317,7 @@ iree_status_t iree_hal_cuda_memory_pools_alloca(
 
   if (iree_status_is_ok(status)) {
     // Update statistics (note that it may not yet be accurate).
+    buffer->allocation_tag = params.tag;
     iree_hal_cuda_memory_pool_track_alloc(pools, buffer);
     *out_buffer = buffer;
   } else if (buffer) {
@@ -304,3 +367,162 @@ iree_status_t iree_hal_cuda_memory_pools_dealloca(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+iree_status_t iree_hal_cuda_memory_pools_export_pool(
+    iree_hal_cuda_memory_pools_t* pools, iree_host_size_t queue_index,
+    int* out_fd) {
+  IREE_ASSERT_ARGUMENT(out_fd);
+  *out_fd = -1;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_host_size_t set_index =
+      iree_hal_cuda_memory_pools_select_set(pools, queue_index);
+  int fd = -1;
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      pools->cuda_symbols,
+      cuMemPoolExportToShareableHandle(
+          &fd, pools->sets[set_index].device_local,
+          CU_MEM_HANDLE_TYPE_POSIX_FILE_DESCRIPTOR, /*flags=*/0),
+      "cuMemPoolExportToShareableHandle");
+  if (iree_status_is_ok(status)) *out_fd = fd;
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_memory_pools_export_buffer(
+    iree_hal_cuda_memory_pools_t* pools, iree_hal_buffer_t* buffer,
+    iree_hal_cuda_memory_pool_ptr_export_data_t* out_export_data) {
+  IREE_ASSERT_ARGUMENT(buffer);
+  IREE_ASSERT_ARGUMENT(out_export_data);
+  memset(out_export_data, 0, sizeof(*out_export_data));
+
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  if (iree_hal_cuda_buffer_type(allocated_buffer) !=
+      IREE_HAL_CUDA_BUFFER_TYPE_ASYNC) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "only buffers allocated from memory pools with "
+                            "queue-ordered allocations can be exported");
+  }
+
+  static_assert(sizeof(out_export_data->data) == sizeof(CUmemPoolPtrExportData),
+                "export data storage must match CUmemPoolPtrExportData");
+  CUmemPoolPtrExportData export_data;
+  IREE_CUDA_RETURN_IF_ERROR(
+      pools->cuda_symbols,
+      cuMemPoolExportPointer(
+          &export_data, iree_hal_cuda_buffer_device_pointer(allocated_buffer)),
+      "cuMemPoolExportPointer");
+  memcpy(out_export_data->data, &export_data, sizeof(export_data));
+  return iree_ok_status();
+}
+
+// Retains an imported pool for as long as the buffer imported from it lives.
+typedef struct iree_hal_cuda_imported_pool_t {
+  const iree_hal_cuda_dynamic_symbols_t* cuda_symbols;
+  iree_allocator_t host_allocator;
+  CUmemoryPool pool;
+} iree_hal_cuda_imported_pool_t;
+
+static void iree_hal_cuda_imported_pool_buffer_release_callback(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_hal_cuda_imported_pool_t* imported_pool =
+      (iree_hal_cuda_imported_pool_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Imported pointers must be freed before the pool they came from.
+  CUdeviceptr device_ptr = iree_hal_cuda_buffer_device_pointer(buffer);
+  IREE_CUDA_IGNORE_ERROR(imported_pool->cuda_symbols, cuMemFree(device_ptr));
+  IREE_CUDA_IGNORE_ERROR(imported_pool->cuda_symbols,
+                         cuMemPoolDestroy(imported_pool->pool));
+  iree_allocator_free(imported_pool->host_allocator, imported_pool);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_cuda_memory_pools_import_buffer(
+    iree_hal_cuda_memory_pools_t* pools, int pool_fd,
+    const iree_hal_cuda_memory_pool_ptr_export_data_t* export_data,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  IREE_ASSERT_ARGUMENT(export_data);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  iree_hal_buffer_params_canonicalize(&params);
+
+  iree_hal_cuda_imported_pool_t* imported_pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(pools->host_allocator, sizeof(*imported_pool),
+                                (void**)&imported_pool));
+  imported_pool->cuda_symbols = pools->cuda_symbols;
+  imported_pool->host_allocator = pools->host_allocator;
+  imported_pool->pool = NULL;
+
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      pools->cuda_symbols,
+      cuMemPoolImportFromShareableHandle(
+          &imported_pool->pool, (void*)(intptr_t)pool_fd,
+          CU_MEM_HANDLE_TYPE_POSIX_FILE_DESCRIPTOR, /*flags=*/0),
+      "cuMemPoolImportFromShareableHandle");
+
+  // Imported pools are not accessible by any device until access is granted.
+  if (iree_status_is_ok(status)) {
+    CUmemAccessDesc access_desc = {
+        .location =
+            {
+                .type = CU_MEM_LOCATION_TYPE_DEVICE,
+                .id = pools->cu_device,
+            },
+        .flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE,
+    };
+    status = IREE_CURESULT_TO_STATUS(
+        pools->cuda_symbols,
+        cuMemPoolSetAccess(imported_pool->pool, &access_desc, 1),
+        "cuMemPoolSetAccess");
+  }
+
+  CUdeviceptr device_ptr = 0;
+  if (iree_status_is_ok(status)) {
+    CUmemPoolPtrExportData ptr_export_data;
+    memcpy(&ptr_export_data, export_data->data, sizeof(ptr_export_data));
+    status = IREE_CURESULT_TO_STATUS(
+        pools->cuda_symbols,
+        cuMemPoolImportPointer(&device_ptr, imported_pool->pool,
+                               &ptr_export_data),
+        "cuMemPoolImportPointer");
+  }
+
+  // The buffer takes ownership of the imported pool and destroys it when
+  // released.
+  if (iree_status_is_ok(status)) {
+    iree_hal_buffer_release_callback_t release_callback = {
+        .fn = iree_hal_cuda_imported_pool_buffer_release_callback,
+        .user_data = imported_pool,
+    };
+    status = iree_hal_cuda_buffer_wrap(
+        /*device_allocator=*/NULL, params.type, params.access, params.usage,
+        allocation_size, /*byte_offset=*/0,
+        /*byte_length=*/allocation_size,
+        IREE_HAL_CUDA_BUFFER_TYPE_IMPORTED_POOL, device_ptr,
+        /*host_ptr=*/NULL, release_callback, pools->host_allocator,
+        out_buffer);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    if (device_ptr) {
+      IREE_CUDA_IGNORE_ERROR(pools->cuda_symbols, cuMemFree(device_ptr));
+    }
+    if (imported_pool->pool) {
+      IREE_CUDA_IGNORE_ERROR(pools->cuda_symbols,
+                             cuMemPoolDestroy(imported_pool->pool));
+    }
+    iree_allocator_free(pools->host_allocator, imported_pool);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
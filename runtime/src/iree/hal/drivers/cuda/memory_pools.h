@@ -20,11 +20,18 @@ extern "C" {
 
 // Retained CUDA memory pools for various allocation types.
 typedef struct iree_hal_cuda_memory_pools_t {
-  // Used exclusively for DEVICE_LOCAL allocations.
-  CUmemoryPool device_local;
-  // Used for any host-visible/host-local memory types.
-  CUmemoryPool other;
+  // Number of valid entries in |sets|. 1 when all queues share the same pools
+  // and otherwise one per queue.
+  iree_host_size_t set_count;
+  struct {
+    // Used exclusively for DEVICE_LOCAL allocations.
+    CUmemoryPool device_local;
+    // Used for any host-visible/host-local memory types.
+    CUmemoryPool other;
+  } sets[IREE_HAL_CUDA_MAX_QUEUE_COUNT];
 
+  // Device the pools allocate from and imported pools are made accessible to.
+  CUdevice cu_device;
   const iree_hal_cuda_dynamic_symbols_t* cuda_symbols;
   iree_allocator_t host_allocator;
 
@@ -33,12 +40,21 @@ typedef struct iree_hal_cuda_memory_pools_t {
     iree_atomic_int64_t device_bytes_freed;
     iree_atomic_int64_t host_bytes_allocated;
     iree_atomic_int64_t host_bytes_freed;
+    // Live and peak bytes per iree_hal_allocation_tag_t.
+    struct {
+      iree_atomic_int64_t bytes_live;
+      iree_atomic_int64_t bytes_peak;
+    } tags[IREE_HAL_ALLOCATION_TAG_COUNT];
   } statistics;)
 } iree_hal_cuda_memory_pools_t;
 
 // Initializes |out_pools| by configuring new CUDA memory pools.
+// One set of pools is created for each of the |queue_count| queues when
+// |pooling_params| requests per-queue pools and otherwise a single set is
+// shared by all queues.
 iree_status_t iree_hal_cuda_memory_pools_initialize(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols, CUdevice cu_device,
+    iree_host_size_t queue_count,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params,
     iree_allocator_t host_allocator,
     iree_hal_cuda_memory_pools_t* IREE_RESTRICT out_pools);
@@ -57,10 +73,11 @@ iree_status_t iree_hal_cuda_memory_pools_trim(
     iree_hal_cuda_memory_pools_t* pools,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params);
 
-// Asynchronously allocates a buffer from an appropriate pool.
-// The allocation will be stream-ordered on |stream|.
+// Asynchronously allocates a buffer from an appropriate pool of the queue at
+// |queue_index|. The allocation will be stream-ordered on |stream|.
 iree_status_t iree_hal_cuda_memory_pools_alloca(
-    iree_hal_cuda_memory_pools_t* pools, CUstream stream,
+    iree_hal_cuda_memory_pools_t* pools, iree_host_size_t queue_index,
+    CUstream stream,
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer);
@@ -71,6 +88,27 @@ iree_status_t iree_hal_cuda_memory_pools_dealloca(
     iree_hal_cuda_memory_pools_t* pools, CUstream stream,
     iree_hal_buffer_t* buffer);
 
+// Exports the DEVICE_LOCAL pool of the queue at |queue_index| as a POSIX file
+// descriptor owned by the caller. The pool must have been created shareable.
+iree_status_t iree_hal_cuda_memory_pools_export_pool(
+    iree_hal_cuda_memory_pools_t* pools, iree_host_size_t queue_index,
+    int* out_fd);
+
+// Exports |buffer| allocated from a shareable pool so that it can be imported
+// by other processes that have imported the pool.
+iree_status_t iree_hal_cuda_memory_pools_export_buffer(
+    iree_hal_cuda_memory_pools_t* pools, iree_hal_buffer_t* buffer,
+    iree_hal_cuda_memory_pool_ptr_export_data_t* out_export_data);
+
+// Imports the pool shared as |pool_fd| and maps the allocation described by
+// |export_data| from it. The imported pool is retained by the returned buffer
+// and destroyed once the buffer is released.
+iree_status_t iree_hal_cuda_memory_pools_import_buffer(
+    iree_hal_cuda_memory_pools_t* pools, int pool_fd,
+    const iree_hal_cuda_memory_pool_ptr_export_data_t* export_data,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
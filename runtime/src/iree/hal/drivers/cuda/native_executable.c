@@ -7,8 +7,10 @@
 #include "iree/hal/drivers/cuda/native_executable.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_status_util.h"
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
@@ -109,6 +111,166 @@ static iree_status_t iree_hal_cuda_native_executable_flatbuffer_verify(
   return iree_ok_status();
 }
 
+// Precomputes the kernel parameter layout of |info| from its pipeline layout.
+static iree_status_t iree_hal_cuda_kernel_info_initialize_params(
+    iree_hal_cuda_kernel_info_t* info) {
+  const iree_host_size_t set_count =
+      iree_hal_cuda_pipeline_layout_descriptor_set_count(info->layout);
+  if (set_count > IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "descriptor set count %" PRIhsz
+                            " over the limit of %d",
+                            set_count, IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_COUNT);
+  }
+  info->set_count = (uint32_t)set_count;
+  for (iree_host_size_t i = 0; i < set_count; ++i) {
+    const iree_host_size_t binding_count =
+        iree_hal_cuda_descriptor_set_layout_binding_count(
+            iree_hal_cuda_pipeline_layout_descriptor_set_layout(
+                info->layout, (uint32_t)i));
+    if (binding_count > IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_BINDING_COUNT) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "descriptor set %" PRIhsz " binding count %" PRIhsz
+          " over the limit of %d",
+          i, binding_count, IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_BINDING_COUNT);
+    }
+    info->sets[i].base_index =
+        (uint16_t)iree_hal_cuda_pipeline_layout_base_binding_index(
+            info->layout, (uint32_t)i);
+    info->sets[i].binding_count = (uint16_t)binding_count;
+  }
+  info->push_constant_index =
+      (uint32_t)iree_hal_cuda_pipeline_layout_push_constant_index(info->layout);
+  info->push_constant_count =
+      (uint32_t)iree_hal_cuda_pipeline_layout_push_constant_count(info->layout);
+  info->param_count = info->push_constant_index + info->push_constant_count;
+  return iree_ok_status();
+}
+
+// Shared memory limits of the device used when tuning kernels.
+typedef struct iree_hal_cuda_shared_memory_limits_t {
+  // Maximum opt-in shared memory per block.
+  int32_t max_per_block;
+  // Total shared memory per multiprocessor available at the maximum carveout.
+  int32_t max_per_multiprocessor;
+  // Shared memory reserved by the driver for each resident block.
+  int32_t reserved_per_block;
+} iree_hal_cuda_shared_memory_limits_t;
+
+static iree_status_t iree_hal_cuda_query_shared_memory_limits(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    iree_hal_cuda_shared_memory_limits_t* out_limits) {
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      symbols,
+      cuDeviceGetAttribute(
+          &out_limits->max_per_block,
+          CU_DEVICE_ATTRIBUTE_MAX_SHARED_MEMORY_PER_BLOCK_OPTIN, device),
+      "cuDeviceGetAttribute"));
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      symbols,
+      cuDeviceGetAttribute(
+          &out_limits->max_per_multiprocessor,
+          CU_DEVICE_ATTRIBUTE_MAX_SHARED_MEMORY_PER_MULTIPROCESSOR, device),
+      "cuDeviceGetAttribute"));
+  return IREE_CURESULT_TO_STATUS(
+      symbols,
+      cuDeviceGetAttribute(&out_limits->reserved_per_block,
+                           CU_DEVICE_ATTRIBUTE_RESERVED_SHARED_MEMORY_PER_BLOCK,
+                           device),
+      "cuDeviceGetAttribute");
+}
+
+// Tunes the shared memory configuration of the kernel in |info| for the device
+// and records its occupancy.
+//
+// Kernels are compiled with a fixed block size and shared memory requirement
+// that may have been chosen for a different device. We compute how many blocks
+// of the kernel can be resident on a multiprocessor of this device when all of
+// the unified L1/shared storage is used as shared memory and then pick the
+// smallest carveout that still fits that many blocks. Kernels using little or
+// no shared memory get the rest of the storage as L1 cache instead of leaving
+// it to the driver default.
+static iree_status_t iree_hal_cuda_kernel_info_tune_occupancy(
+    const iree_hal_cuda_dynamic_symbols_t* symbols,
+    const iree_hal_cuda_shared_memory_limits_t* limits,
+    iree_hal_cuda_kernel_info_t* info) {
+  const int threads_per_block =
+      (int)(info->block_size[0] * info->block_size[1] * info->block_size[2]);
+
+  int static_shared_memory_size = 0;
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      symbols,
+      cuFuncGetAttribute(&static_shared_memory_size,
+                         CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, info->function),
+      "cuFuncGetAttribute"));
+  info->static_shared_memory_size = (uint32_t)static_shared_memory_size;
+
+  // Occupancy with the maximum shared memory carveout.
+  int32_t carveout = CU_SHAREDMEM_CARVEOUT_MAX_SHARED;
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      symbols,
+      cuFuncSetAttribute(info->function,
+                         CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT,
+                         carveout),
+      "cuFuncSetAttribute"));
+  int max_active_blocks = 0;
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      symbols,
+      cuOccupancyMaxActiveBlocksPerMultiprocessor(
+          &max_active_blocks, info->function, threads_per_block,
+          info->shared_memory_size),
+      "cuOccupancyMaxActiveBlocksPerMultiprocessor"));
+
+  // Smallest carveout holding the shared memory of all resident blocks.
+  const uint64_t shared_memory_per_block =
+      (uint64_t)static_shared_memory_size + info->shared_memory_size;
+  if (shared_memory_per_block == 0) {
+    carveout = CU_SHAREDMEM_CARVEOUT_MAX_L1;
+  } else if (max_active_blocks > 0 && limits->max_per_multiprocessor > 0) {
+    const uint64_t required_shared_memory =
+        (uint64_t)max_active_blocks *
+        (shared_memory_per_block + (uint64_t)limits->reserved_per_block);
+    const uint64_t max_per_multiprocessor =
+        (uint64_t)limits->max_per_multiprocessor;
+    carveout = (int32_t)iree_min(
+        (uint64_t)CU_SHAREDMEM_CARVEOUT_MAX_SHARED,
+        (required_shared_memory * 100 + max_per_multiprocessor - 1) /
+            max_per_multiprocessor);
+  }
+
+  // The carveout is only a hint and the driver rounds it to a supported
+  // configuration; keep the maximum if the reduced carveout lowers occupancy.
+  if (carveout != CU_SHAREDMEM_CARVEOUT_MAX_SHARED) {
+    IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+        symbols,
+        cuFuncSetAttribute(info->function,
+                           CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT,
+                           carveout),
+        "cuFuncSetAttribute"));
+    int tuned_active_blocks = 0;
+    IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+        symbols,
+        cuOccupancyMaxActiveBlocksPerMultiprocessor(
+            &tuned_active_blocks, info->function, threads_per_block,
+            info->shared_memory_size),
+        "cuOccupancyMaxActiveBlocksPerMultiprocessor"));
+    if (tuned_active_blocks < max_active_blocks) {
+      carveout = CU_SHAREDMEM_CARVEOUT_MAX_SHARED;
+      IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+          symbols,
+          cuFuncSetAttribute(info->function,
+                             CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT,
+                             carveout),
+          "cuFuncSetAttribute"));
+    }
+  }
+
+  info->max_active_blocks_per_multiprocessor = (uint32_t)max_active_blocks;
+  info->shared_memory_carveout = carveout;
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_cuda_native_executable_create(
     const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
     const iree_hal_executable_params_t* executable_params,
@@ -139,17 +301,14 @@ iree_status_t iree_hal_cuda_native_executable_create(
   iree_host_size_t entry_point_count =
       flatbuffers_string_vec_len(entry_points_vec);
 
-  // Calculate the total number of characters across all entry point names. This
-  // is only required when tracing so that we can store copies of the names as
-  // the flatbuffer storing the strings may be released while the executable is
-  // still live.
+  // Calculate the total number of characters across all entry point names. We
+  // store copies of the names for tracing and profiling as the flatbuffer
+  // storing the strings may be released while the executable is still live.
   iree_host_size_t total_entry_point_name_chars = 0;
-  IREE_TRACE({
-    for (iree_host_size_t i = 0; i < entry_point_count; i++) {
-      const char* entry_name = flatbuffers_string_vec_at(entry_points_vec, i);
-      total_entry_point_name_chars += flatbuffers_string_len(entry_name);
-    }
-  });
+  for (iree_host_size_t i = 0; i < entry_point_count; i++) {
+    const char* entry_name = flatbuffers_string_vec_at(entry_points_vec, i);
+    total_entry_point_name_chars += flatbuffers_string_len(entry_name);
+  }
 
   // Allocate storage for the kernel module.
   iree_host_size_t total_size =
@@ -159,10 +318,9 @@ iree_status_t iree_hal_cuda_native_executable_create(
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0,
       iree_allocator_malloc(host_allocator, total_size, (void**)&executable));
-  IREE_TRACE(
-      char* string_table_buffer =
-          (char*)((char*)executable + sizeof(*executable) +
-                  entry_point_count * sizeof(executable->entry_points[0])));
+  char* string_table_buffer =
+      (char*)((char*)executable + sizeof(*executable) +
+              entry_point_count * sizeof(executable->entry_points[0]));
 
   iree_hal_resource_initialize(&iree_hal_cuda_native_executable_vtable,
                                &executable->resource);
@@ -175,16 +333,12 @@ iree_status_t iree_hal_cuda_native_executable_create(
       symbols, cuModuleLoadDataEx(&module, ptx_image, 0, NULL, NULL),
       "cuModuleLoadDataEx");
 
-  // Query max optin shared memory per block - we'll use it to compare with
-  // kernel usages.
-  int32_t max_shared_memory = 0;
+  // Query shared memory limits - we'll use them to compare with kernel usages
+  // and to tune the shared memory carveout of each kernel.
+  iree_hal_cuda_shared_memory_limits_t shared_memory_limits = {0};
   if (iree_status_is_ok(status)) {
-    status = IREE_CURESULT_TO_STATUS(
-        symbols,
-        cuDeviceGetAttribute(
-            &max_shared_memory,
-            CU_DEVICE_ATTRIBUTE_MAX_SHARED_MEMORY_PER_BLOCK_OPTIN, device),
-        "cuDeviceGetAttribute");
+    status = iree_hal_cuda_query_shared_memory_limits(symbols, device,
+                                                      &shared_memory_limits);
   }
 
   if (iree_status_is_ok(status)) {
@@ -209,11 +363,12 @@ iree_status_t iree_hal_cuda_native_executable_create(
         break;
       }
 
-      if (shared_memory_sizes[i] > max_shared_memory) {
-        status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
-                                  "requested shared memory size of %d bytes "
-                                  "larger than allowed size of %d bytes",
-                                  shared_memory_sizes[i], max_shared_memory);
+      if (shared_memory_sizes[i] > shared_memory_limits.max_per_block) {
+        status = iree_make_status(
+            IREE_STATUS_OUT_OF_RANGE,
+            "requested shared memory size of %d bytes larger than allowed "
+            "size of %d bytes",
+            shared_memory_sizes[i], shared_memory_limits.max_per_block);
       } else {
         status = IREE_CURESULT_TO_STATUS(
             symbols,
@@ -233,15 +388,19 @@ iree_status_t iree_hal_cuda_native_executable_create(
       info->block_size[1] = block_sizes_vec[i].y;
       info->block_size[2] = block_sizes_vec[i].z;
       info->shared_memory_size = shared_memory_sizes[i];
+      status = iree_hal_cuda_kernel_info_initialize_params(info);
+      if (!iree_status_is_ok(status)) break;
+      status = iree_hal_cuda_kernel_info_tune_occupancy(
+          symbols, &shared_memory_limits, info);
+      if (!iree_status_is_ok(status)) break;
 
-      // Stash the entry point name in the string table for use when tracing.
-      IREE_TRACE({
-        iree_host_size_t entry_name_length = flatbuffers_string_len(entry_name);
-        memcpy(string_table_buffer, entry_name, entry_name_length);
-        info->function_name =
-            iree_make_string_view(string_table_buffer, entry_name_length);
-        string_table_buffer += entry_name_length;
-      });
+      // Stash the entry point name in the string table for use when tracing
+      // and profiling.
+      iree_host_size_t entry_name_length = flatbuffers_string_len(entry_name);
+      memcpy(string_table_buffer, entry_name, entry_name_length);
+      info->function_name =
+          iree_make_string_view(string_table_buffer, entry_name_length);
+      string_table_buffer += entry_name_length;
 
       IREE_TRACE({
         if (iree_hal_cuda_ExecutableDef_source_locations_is_present(
@@ -292,7 +451,7 @@ static void iree_hal_cuda_native_executable_destroy(
 
 iree_status_t iree_hal_cuda_native_executable_entry_point_kernel_info(
     iree_hal_executable_t* base_executable, int32_t entry_point,
-    iree_hal_cuda_kernel_info_t* out_info) {
+    const iree_hal_cuda_kernel_info_t** out_info) {
   iree_hal_cuda_native_executable_t* executable =
       iree_hal_cuda_native_executable_cast(base_executable);
   if (entry_point >= executable->entry_point_count) {
@@ -301,7 +460,7 @@ iree_status_t iree_hal_cuda_native_executable_entry_point_kernel_info(
                             "only contains %" PRIhsz " entry points",
                             entry_point, executable->entry_point_count);
   }
-  memcpy(out_info, &executable->entry_points[entry_point], sizeof(*out_info));
+  *out_info = &executable->entry_points[entry_point];
   return iree_ok_status();
 }
 
@@ -309,3 +468,27 @@ static const iree_hal_executable_vtable_t
     iree_hal_cuda_native_executable_vtable = {
         .destroy = iree_hal_cuda_native_executable_destroy,
 };
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_executable_query_export_occupancy(
+    iree_hal_executable_t* base_executable, uint32_t export_ordinal,
+    iree_hal_cuda_export_occupancy_t* out_occupancy) {
+  IREE_ASSERT_ARGUMENT(base_executable);
+  IREE_ASSERT_ARGUMENT(out_occupancy);
+  memset(out_occupancy, 0, sizeof(*out_occupancy));
+  if (!iree_hal_resource_is(base_executable,
+                            &iree_hal_cuda_native_executable_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "executable is not a CUDA executable");
+  }
+  const iree_hal_cuda_kernel_info_t* info = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_cuda_native_executable_entry_point_kernel_info(
+      base_executable, (int32_t)export_ordinal, &info));
+  out_occupancy->max_active_blocks_per_multiprocessor =
+      info->max_active_blocks_per_multiprocessor;
+  out_occupancy->threads_per_block =
+      info->block_size[0] * info->block_size[1] * info->block_size[2];
+  out_occupancy->shared_memory_per_block =
+      info->static_shared_memory_size + info->shared_memory_size;
+  out_occupancy->shared_memory_carveout = info->shared_memory_carveout;
+  return iree_ok_status();
+}
@@ -14,18 +14,51 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/pipeline_layout.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
+// The max number of kernel parameters of any kernel: the bindings of all
+// descriptor sets followed by all push constants.
+#define IREE_HAL_CUDA_MAX_KERNEL_PARAM_COUNT            \
+  (IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_COUNT *             \
+       IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_BINDING_COUNT + \
+   IREE_HAL_CUDA_MAX_PUSH_CONSTANT_COUNT)
+
 typedef struct iree_hal_cuda_kernel_info_t {
   iree_hal_pipeline_layout_t* layout;
   CUfunction function;
   uint32_t block_size[3];
   uint32_t shared_memory_size;
 
-  IREE_TRACE(iree_string_view_t function_name;)
+  // Occupancy of the kernel on the device computed at load time.
+  uint32_t max_active_blocks_per_multiprocessor;
+  // Static shared memory declared by the kernel in bytes.
+  uint32_t static_shared_memory_size;
+  // Preferred shared memory carveout percentage set on |function|.
+  int32_t shared_memory_carveout;
+
+  // Kernel parameter layout precomputed from |layout| when the executable is
+  // created so that recording a dispatch only needs to store binding pointers
+  // and push constants into the parameter payload.
+  uint32_t set_count;
+  struct {
+    // Index of the kernel parameter of the first binding in the set.
+    uint16_t base_index;
+    // Number of bindings in the set.
+    uint16_t binding_count;
+  } sets[IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_COUNT];
+  // Index of the kernel parameter of the first push constant.
+  uint32_t push_constant_index;
+  // Number of 32-bit push constants.
+  uint32_t push_constant_count;
+  // Total number of kernel parameters (bindings and push constants).
+  uint32_t param_count;
+
+  // Name of the exported function, used for tracing and profiling.
+  iree_string_view_t function_name;
   IREE_TRACE(iree_string_view_t source_filename;)
   IREE_TRACE(uint32_t source_line;)
 } iree_hal_cuda_kernel_info_t;
@@ -38,10 +71,11 @@ iree_status_t iree_hal_cuda_native_executable_create(
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable);
 
 // Returns the kernel launch information for the given |entry_point| in the
-// |executable|.
+// |executable|. The information remains valid for the lifetime of the
+// executable.
 iree_status_t iree_hal_cuda_native_executable_entry_point_kernel_info(
     iree_hal_executable_t* executable, int32_t entry_point,
-    iree_hal_cuda_kernel_info_t* out_info);
+    const iree_hal_cuda_kernel_info_t** out_info);
 
 #ifdef __cplusplus
 }  // extern "C"
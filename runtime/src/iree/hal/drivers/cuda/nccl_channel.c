@@ -38,6 +38,10 @@ typedef struct iree_hal_cuda_nccl_channel_t {
   // Communicator handle.
   ncclComm_t comm;
 
+  // Maximum duration to wait for nonblocking communicator initialization when
+  // creating split channels from this one.
+  iree_duration_t init_timeout;
+
   // Hash of the unique ID used to create the communicator.
   // This is consistent with the hashes NCCL itself uses for logging but is not
   // guaranteed to be unique - only use for informational purposes.
@@ -73,6 +77,46 @@ static uint64_t iree_hal_cuda_nccl_hash_id(const iree_hal_cuda_nccl_id_t* id) {
   return hash;
 }
 
+// Waits for all pending nonblocking operations on |comm| to complete or
+// |deadline_ns| to elapse. Communicators are created in nonblocking mode so
+// that initialization across large numbers of participants does not block
+// indefinitely; NCCL reports ncclInProgress until the communicator is ready.
+static iree_status_t iree_hal_cuda_nccl_wait_comm(
+    const iree_hal_cuda_nccl_dynamic_symbols_t* symbols, ncclComm_t comm,
+    iree_time_t deadline_ns) {
+  ncclResult_t result = ncclInProgress;
+  while (true) {
+    ncclResult_t query_result = symbols->ncclCommGetAsyncError(comm, &result);
+    if (query_result != ncclSuccess) result = query_result;
+    if (result != ncclInProgress) break;
+    iree_time_t now_ns = iree_time_now();
+    if (now_ns >= deadline_ns) {
+      return iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
+                              "timed out waiting for NCCL communicator");
+    }
+    // Communicator initialization takes on the order of milliseconds to
+    // seconds so we back off instead of spinning.
+    iree_wait_until(iree_min(deadline_ns, now_ns + 1000000ll));
+  }
+  return iree_hal_cuda_nccl_result_to_status(symbols, result, __FILE__,
+                                             __LINE__);
+}
+
+// Waits for nonblocking initialization of |comm| to complete. On failure
+// (including timeout) the communicator is aborted and must not be used.
+static iree_status_t iree_hal_cuda_nccl_wait_comm_initialized(
+    const iree_hal_cuda_nccl_dynamic_symbols_t* symbols, ncclComm_t comm,
+    iree_duration_t timeout) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_hal_cuda_nccl_wait_comm(
+      symbols, comm, iree_relative_timeout_to_deadline_ns(timeout));
+  if (!iree_status_is_ok(status)) {
+    IREE_NCCL_IGNORE_ERROR(symbols, ncclCommAbort(comm));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 iree_status_t iree_hal_cuda_nccl_get_unique_id(
     const iree_hal_cuda_nccl_dynamic_symbols_t* symbols,
     iree_hal_cuda_nccl_id_t* out_id) {
@@ -95,7 +139,8 @@ iree_status_t iree_hal_cuda_nccl_channel_create(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
     const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
     const iree_hal_cuda_nccl_id_t* id, int rank, int count,
-    iree_allocator_t host_allocator, iree_hal_channel_t** out_channel) {
+    iree_duration_t init_timeout, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel) {
   IREE_ASSERT_ARGUMENT(cuda_symbols);
   IREE_ASSERT_ARGUMENT(nccl_symbols);
   IREE_ASSERT_ARGUMENT(id);
@@ -110,18 +155,32 @@ iree_status_t iree_hal_cuda_nccl_channel_create(
 
   ncclComm_t comm = NULL;
   ncclConfig_t config = NCCL_CONFIG_INITIALIZER;
-  // TODO: use async to check a timeout.
-  config.blocking = 1;
-  IREE_NCCL_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, nccl_symbols,
-      ncclCommInitRankConfig(&comm, count, *((const ncclUniqueId*)id), rank,
-                             &config),
-      "ncclCommInitRankConfig");
+  config.blocking = 0;
+  ncclResult_t init_result = nccl_symbols->ncclCommInitRankConfig(
+      &comm, count, *((const ncclUniqueId*)id), rank, &config);
+  if (init_result != ncclSuccess && init_result != ncclInProgress) {
+    if (comm) {
+      IREE_NCCL_IGNORE_ERROR(nccl_symbols, ncclCommAbort(comm));
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return iree_status_annotate(
+        iree_hal_cuda_nccl_result_to_status(nccl_symbols, init_result,
+                                            __FILE__, __LINE__),
+        IREE_SV("ncclCommInitRankConfig"));
+  }
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_nccl_wait_comm_initialized(nccl_symbols, comm,
+                                                   init_timeout),
+      "initializing NCCL communicator");
 
   iree_hal_cuda_nccl_channel_t* channel = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(host_allocator, sizeof(*channel),
-                                (void**)&channel));
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*channel), (void**)&channel);
+  if (!iree_status_is_ok(status)) {
+    IREE_NCCL_IGNORE_ERROR(nccl_symbols, ncclCommDestroy(comm));
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
 
   iree_hal_resource_initialize(&iree_hal_cuda_nccl_channel_vtable,
                                &channel->resource);
@@ -132,6 +191,7 @@ iree_status_t iree_hal_cuda_nccl_channel_create(
   channel->rank = rank;
   channel->count = count;
   channel->comm = comm;
+  channel->init_timeout = init_timeout;
   IREE_TRACE(channel->id_hash = id_hash);
   *out_channel = (iree_hal_channel_t*)channel;
 
@@ -156,14 +216,13 @@ static void iree_hal_cuda_nccl_channel_destroy(
   // lifetime performance. To do that we'd probably want to track each open
   // channel on the device that created them and manage teardown there.
   //
-  // Recommended:
-  //   ncclCommFinalize(channel->comm);  // non-blocking!
-  //   while (ncclCommGetAsyncError == ncclInProgress) sleep(1);
-  //   ncclCommDestroy(channel->comm)
-  // Should work the same (as we are doing a blocking teardown):
-  //   ncclCommDestroy(channel->comm)
+  //
+  // Communicators are nonblocking and finalization returns immediately so we
+  // wait for it to complete before destroying the communicator.
   IREE_NCCL_IGNORE_ERROR(channel->nccl_symbols,
                          ncclCommFinalize(channel->comm));
+  iree_status_ignore(iree_hal_cuda_nccl_wait_comm(
+      channel->nccl_symbols, channel->comm, IREE_TIME_INFINITE_FUTURE));
 
   IREE_NCCL_IGNORE_ERROR(channel->nccl_symbols, ncclCommDestroy(channel->comm));
 
@@ -181,15 +240,23 @@ static iree_status_t iree_hal_cuda_nccl_channel_split(
 
   // TODO: see if we need to set the sharing config - we may always want to.
   ncclConfig_t config = NCCL_CONFIG_INITIALIZER;
-  // TODO: use async to check a timeout.
-  config.blocking = 1;
+  config.blocking = 0;
 
-  // Split the communicator.
+  // Split the communicator. This is a collective operation on the parent and
+  // the split communicator is initialized asynchronously.
   ncclComm_t split_comm = NULL;
-  IREE_NCCL_RETURN_IF_ERROR(
-      channel->nccl_symbols,
-      ncclCommSplit(channel->comm, color, key, &split_comm, &config),
-      "ncclCommSplit");
+  ncclResult_t split_result = channel->nccl_symbols->ncclCommSplit(
+      channel->comm, color, key, &split_comm, &config);
+  if (split_result != ncclSuccess && split_result != ncclInProgress) {
+    return iree_status_annotate(
+        iree_hal_cuda_nccl_result_to_status(
+            channel->nccl_symbols, split_result, __FILE__, __LINE__),
+        IREE_SV("ncclCommSplit"));
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_nccl_wait_comm_initialized(
+          channel->nccl_symbols, split_comm, channel->init_timeout),
+      "initializing split NCCL communicator");
 
   // Query the local rank/count from the split communicator.
   int split_rank = 0;
@@ -221,6 +288,7 @@ static iree_status_t iree_hal_cuda_nccl_channel_split(
     split_channel->rank = split_rank;
     split_channel->count = split_count;
     split_channel->comm = split_comm;
+    split_channel->init_timeout = channel->init_timeout;
     *out_split_channel = (iree_hal_channel_t*)split_channel;
   }
 
@@ -539,6 +607,80 @@ static iree_status_t iree_hal_cuda_nccl_submit_batch_entry(
   return iree_ok_status();
 }
 
+// Returns the device pointer to the start of |binding|.
+static CUdeviceptr iree_hal_cuda_nccl_binding_device_pointer(
+    iree_hal_buffer_binding_t binding) {
+  return iree_hal_cuda_buffer_device_pointer(
+             iree_hal_buffer_allocated_buffer(binding.buffer)) +
+         iree_hal_buffer_byte_offset(binding.buffer) + binding.offset;
+}
+
+// Copies the send buffers of all entries in the fused |bucket| into |staging|
+// if |pack| is true or the packed results from |staging| into the recv buffers
+// of all entries if false.
+static iree_status_t iree_hal_cuda_nccl_copy_bucket(
+    const iree_hal_collective_bucket_t* bucket, CUdeviceptr staging, bool pack,
+    CUstream stream) {
+  iree_hal_cuda_nccl_channel_t* channel =
+      iree_hal_cuda_nccl_channel_cast(bucket->entries[0]->channel);
+  iree_device_size_t element_size_bytes =
+      iree_hal_collective_element_byte_count(bucket->op.element_type);
+  CUdeviceptr packed_ptr = staging + bucket->staging_offset;
+  for (iree_host_size_t i = 0; i < bucket->entry_count; ++i) {
+    const iree_hal_collective_batch_entry_t* entry = bucket->entries[i];
+    iree_device_size_t length = entry->element_count * element_size_bytes;
+    CUdeviceptr src = pack ? iree_hal_cuda_nccl_binding_device_pointer(
+                                 entry->send_binding)
+                           : packed_ptr;
+    CUdeviceptr dst = pack ? packed_ptr
+                           : iree_hal_cuda_nccl_binding_device_pointer(
+                                 entry->recv_binding);
+    IREE_CUDA_RETURN_IF_ERROR(channel->cuda_symbols,
+                              cuMemcpyAsync(dst, src, length, stream),
+                              "cuMemcpyAsync");
+    packed_ptr += length;
+  }
+  return iree_ok_status();
+}
+
+// Issues a single in-place all-reduce over the packed entries of the fused
+// |bucket| in |staging|.
+static iree_status_t iree_hal_cuda_nccl_submit_bucket(
+    const iree_hal_collective_bucket_t* bucket, CUdeviceptr staging,
+    CUstream stream) {
+  iree_hal_channel_t* base_channel = bucket->entries[0]->channel;
+  iree_hal_cuda_nccl_channel_t* channel =
+      iree_hal_cuda_nccl_channel_cast(base_channel);
+  const iree_hal_cuda_nccl_dynamic_symbols_t* symbols = channel->nccl_symbols;
+  ncclComm_t comm = iree_hal_cuda_nccl_channel_comm(base_channel);
+  ncclDataType_t datatype;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_get_nccl_data_type(bucket->op.element_type, &datatype));
+  ncclRedOp_t redop;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_cuda_get_nccl_reduction_type(bucket->op.reduction, &redop));
+  CUdeviceptr buff = staging + bucket->staging_offset;
+  IREE_NCCL_RETURN_IF_ERROR(
+      symbols,
+      ncclAllReduce((const void*)buff, (void*)buff, bucket->element_count,
+                    datatype, redop, comm, stream),
+      "ncclAllReduce");
+  return iree_ok_status();
+}
+
+// Returns the CUDA symbols of the channel of the first fused bucket.
+static const iree_hal_cuda_dynamic_symbols_t*
+iree_hal_cuda_nccl_fused_cuda_symbols(
+    iree_host_size_t bucket_count,
+    const iree_hal_collective_bucket_t* buckets) {
+  for (iree_host_size_t i = 0; i < bucket_count; ++i) {
+    if (buckets[i].entry_count < 2) continue;
+    return iree_hal_cuda_nccl_channel_cast(buckets[i].entries[0]->channel)
+        ->cuda_symbols;
+  }
+  return NULL;
+}
+
 iree_status_t iree_hal_cuda_nccl_submit_batch(
     const iree_hal_cuda_nccl_dynamic_symbols_t* symbols,
     iree_hal_cuda_tracing_context_t* tracing_context,
@@ -564,14 +706,104 @@ iree_status_t iree_hal_cuda_nccl_submit_batch(
   }
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
 
+  // Partition the batch into buckets of small collectives that can be fused.
+  iree_host_size_t bucket_count = 0;
+  iree_hal_collective_bucket_t* buckets = NULL;
+  iree_device_size_t staging_size = 0;
+  IREE_RETURN_IF_ERROR(iree_hal_collective_batch_partition(
+      batch, &bucket_count, &buckets, &staging_size));
+
+  // Allocate stream-ordered staging memory for all fused buckets. If the
+  // allocation fails (such as when the device does not support memory pools)
+  // we fall back to issuing each entry independently. The same fallback is
+  // used when the stream is being captured into a graph as the captured graph
+  // is added as a child graph node and those may not contain memory nodes.
+  const iree_hal_cuda_dynamic_symbols_t* cuda_symbols =
+      iree_hal_cuda_nccl_fused_cuda_symbols(bucket_count, buckets);
+  if (cuda_symbols && staging_size > 0) {
+    CUstreamCaptureStatus capture_status = CU_STREAM_CAPTURE_STATUS_NONE;
+    if (cuda_symbols->cuStreamIsCapturing(stream, &capture_status) !=
+            CUDA_SUCCESS ||
+        capture_status != CU_STREAM_CAPTURE_STATUS_NONE) {
+      staging_size = 0;
+    }
+  }
+  CUdeviceptr staging = 0;
+  if (cuda_symbols && staging_size > 0) {
+    iree_status_t alloc_status = IREE_CURESULT_TO_STATUS(
+        cuda_symbols, cuMemAllocAsync(&staging, staging_size, stream),
+        "cuMemAllocAsync");
+    if (!iree_status_is_ok(alloc_status)) {
+      iree_status_ignore(alloc_status);
+      staging = 0;
+    }
+  }
+
+  // Pack the inputs of each fused bucket. This must happen outside of the
+  // group as NCCL defers launching grouped operations until the group ends.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < bucket_count && staging; ++i) {
+    if (buckets[i].entry_count < 2) continue;
+    status = iree_hal_cuda_nccl_copy_bucket(&buckets[i], staging,
+                                            /*pack=*/true, stream);
+    if (!iree_status_is_ok(status)) break;
+  }
+
   // Issue all collective operations in the batch as part of a group.
   // NCCL may be able to fuse or reduce overheads by issuing like this.
-  IREE_NCCL_RETURN_IF_ERROR(symbols, ncclGroupStart(), "ncclGroupStart");
-  for (iree_host_size_t i = 0; i < batch->count; ++i) {
-    IREE_RETURN_IF_ERROR(
-        iree_hal_cuda_nccl_submit_batch_entry(&batch->entries[i], stream));
+  if (iree_status_is_ok(status)) {
+    status = IREE_NCCL_RESULT_TO_STATUS(symbols, ncclGroupStart(),
+                                        "ncclGroupStart");
+  }
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < bucket_count; ++i) {
+      const iree_hal_collective_bucket_t* bucket = &buckets[i];
+      if (staging && bucket->entry_count > 1) {
+        status = iree_hal_cuda_nccl_submit_bucket(bucket, staging, stream);
+      } else {
+        for (iree_host_size_t j = 0; j < bucket->entry_count; ++j) {
+          status =
+              iree_hal_cuda_nccl_submit_batch_entry(bucket->entries[j], stream);
+          if (!iree_status_is_ok(status)) break;
+        }
+      }
+      if (!iree_status_is_ok(status)) break;
+    }
+    // Nonblocking communicators may return from the group before all
+    // operations have been enqueued on the stream and we must wait for them
+    // before issuing any dependent work.
+    ncclResult_t group_result = symbols->ncclGroupEnd();
+    if (group_result == ncclInProgress) {
+      for (iree_host_size_t i = 0;
+           i < batch->count && iree_status_is_ok(status); ++i) {
+        status = iree_hal_cuda_nccl_wait_comm(
+            symbols, iree_hal_cuda_nccl_channel_comm(batch->entries[i].channel),
+            IREE_TIME_INFINITE_FUTURE);
+      }
+    } else {
+      status = iree_status_join(
+          status, iree_status_annotate(
+                      iree_hal_cuda_nccl_result_to_status(
+                          symbols, group_result, __FILE__, __LINE__),
+                      IREE_SV("ncclGroupEnd")));
+    }
+  }
+
+  // Unpack the results of each fused bucket and release the staging memory
+  // once all uses on the stream have completed.
+  for (iree_host_size_t i = 0;
+       i < bucket_count && staging && iree_status_is_ok(status); ++i) {
+    if (buckets[i].entry_count < 2) continue;
+    status = iree_hal_cuda_nccl_copy_bucket(&buckets[i], staging,
+                                            /*pack=*/false, stream);
+  }
+  if (staging) {
+    status = iree_status_join(
+        status, IREE_CURESULT_TO_STATUS(cuda_symbols,
+                                        cuMemFreeAsync(staging, stream),
+                                        "cuMemFreeAsync"));
   }
-  IREE_NCCL_RETURN_IF_ERROR(symbols, ncclGroupEnd(), "ncclGroupEnd");
+  IREE_RETURN_IF_ERROR(status);
 
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
   // End all zones we began above - note that these are just simply nested so
@@ -35,12 +35,14 @@ iree_status_t iree_hal_cuda_nccl_get_unique_id(
     iree_hal_cuda_nccl_id_t* out_id);
 
 // Creates a IREE HAL channel using the given NCCL |id|, |rank|, and |count|.
-// It calls ncclCommInitRankConfig under the hood.
+// It calls ncclCommInitRankConfig under the hood in nonblocking mode and waits
+// up to |init_timeout| for all participants to join.
 iree_status_t iree_hal_cuda_nccl_channel_create(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
     const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
     const iree_hal_cuda_nccl_id_t* id, int rank, int count,
-    iree_allocator_t host_allocator, iree_hal_channel_t** out_channel);
+    iree_duration_t init_timeout, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel);
 
 // Performs a non-blocking submission of |batch| to |stream|.
 // The backing storage of |batch| is dropped immediately but all resources
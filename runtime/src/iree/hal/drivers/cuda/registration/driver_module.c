@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/threading.h"
 #include "iree/hal/drivers/cuda/api.h"
 
 IREE_FLAG(
@@ -31,6 +32,56 @@ IREE_FLAG(
     "Severely impacts benchmark timings and should only be used when\n"
     "analyzing dispatch timings.");
 
+IREE_FLAG(int32_t, cuda_queue_count, 1,
+          "Number of dispatch queues exposed per CUDA device, each backed by\n"
+          "its own stream.");
+
+IREE_FLAG(bool, cuda_dedicated_copy_queues, false,
+          "Exposes dedicated host-to-device and device-to-host copy queues\n"
+          "that file transfers are routed to so they overlap with compute.");
+
+IREE_FLAG(int32_t, cuda_collective_bucket_size, 4 * 1024 * 1024,
+          "Maximum total size in bytes of small all-reduces fused into one\n"
+          "collective over a packed staging buffer. 0 disables fusion.");
+
+IREE_FLAG(int32_t, cuda_channel_init_timeout_ms, 0,
+          "Maximum time in milliseconds to wait for all participants to join\n"
+          "when creating a collective channel. 0 waits indefinitely.");
+
+IREE_FLAG(int32_t, cuda_dispatch_profile_capacity, 64 * 1024,
+          "Maximum number of dispatches retained when profiling with\n"
+          "--device_profiling_mode=dispatch; older dispatches are dropped.");
+
+IREE_FLAG(int64_t, cuda_staging_ring_capacity, 32 * 1024 * 1024,
+          "Size in bytes of the persistent page-locked host staging ring used\n"
+          "for host/device transfers. 0 allocates staging memory per\n"
+          "transfer.");
+
+IREE_FLAG(bool, cuda_gpu_direct_storage, false,
+          "Reads and writes files on supported filesystems directly to and\n"
+          "from device memory using GPUDirect Storage (libcufile) when\n"
+          "available. Files should be opened with O_DIRECT.");
+
+IREE_FLAG(bool, cuda_per_queue_memory_pools, false,
+          "Creates separate memory pools for queue-ordered allocations on\n"
+          "each queue instead of sharing one set of pools across queues.");
+
+IREE_FLAG(int64_t, cuda_memory_pool_release_threshold, 0,
+          "Soft maximum number of bytes retained in each device-local memory\n"
+          "pool; memory above this is released at device synchronization.");
+
+IREE_FLAG(bool, cuda_shareable_memory_pools, false,
+          "Creates device-local memory pools that can be exported as file\n"
+          "descriptors and shared with other processes.");
+
+IREE_FLAG(string, cuda_worker_thread_affinity, "any",
+          "Logical processor ID the worker thread issuing queue actions of\n"
+          "each device is pinned to (optionally suffixed with `+smt`) or\n"
+          "`any` to let the system place it.");
+IREE_FLAG(string, cuda_worker_thread_priority, "normal",
+          "Priority class of the worker thread issuing queue actions of each\n"
+          "device from [`lowest`, `low`, `normal`, `high`, `highest`].");
+
 IREE_FLAG(int32_t, cuda_default_index, 0,
           "Specifies the index of the default CUDA device to use");
 
@@ -102,8 +153,35 @@ static iree_status_t iree_hal_cuda_driver_factory_try_create(
     device_params.command_buffer_mode =
         IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM;
   }
+  device_params.queue_count =
+      (iree_host_size_t)iree_max(1, FLAG_cuda_queue_count);
+  device_params.dedicated_copy_queues = FLAG_cuda_dedicated_copy_queues;
   device_params.stream_tracing = FLAG_cuda_tracing;
   device_params.async_allocations = FLAG_cuda_async_allocations;
+  device_params.collective_bucket_size =
+      (iree_device_size_t)iree_max(0, FLAG_cuda_collective_bucket_size);
+  if (FLAG_cuda_channel_init_timeout_ms > 0) {
+    device_params.channel_init_timeout =
+        FLAG_cuda_channel_init_timeout_ms * 1000000ll;
+  }
+  device_params.dispatch_profile_capacity =
+      (iree_host_size_t)iree_max(1, FLAG_cuda_dispatch_profile_capacity);
+  device_params.staging_ring_capacity =
+      (iree_device_size_t)iree_max(0, FLAG_cuda_staging_ring_capacity);
+  device_params.gpu_direct_storage = FLAG_cuda_gpu_direct_storage;
+  device_params.memory_pools.per_queue = FLAG_cuda_per_queue_memory_pools;
+  device_params.memory_pools.device_local.release_threshold =
+      (uint64_t)iree_max(0, FLAG_cuda_memory_pool_release_threshold);
+  device_params.memory_pools.device_local.shareable =
+      FLAG_cuda_shareable_memory_pools;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_thread_affinity_parse(
+              iree_make_cstring_view(FLAG_cuda_worker_thread_affinity),
+              &device_params.worker_thread_params.initial_affinity));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_thread_priority_class_parse(
+              iree_make_cstring_view(FLAG_cuda_worker_thread_priority),
+              &device_params.worker_thread_params.priority_class));
 
   driver_options.default_device_index = FLAG_cuda_default_index;
   if (FLAG_cuda_default_index_from_mpi) {
@@ -24,6 +24,9 @@ typedef struct iree_hal_cuda_stream_command_buffer_t {
   // Per-stream CUDA tracing context.
   iree_hal_cuda_tracing_context_t* tracing_context;
 
+  // Optional profiler recording the device timing of each dispatch.
+  iree_hal_cuda_dispatch_profiler_t* dispatch_profiler;
+
   CUstream cu_stream;
 
   // A resource set to maintain references to all resources used within the
@@ -45,6 +48,13 @@ typedef struct iree_hal_cuda_stream_command_buffer_t {
   struct {
     CUdeviceptr bindings[IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_BINDING_COUNT];
   } descriptor_sets[IREE_HAL_CUDA_MAX_DESCRIPTOR_SET_COUNT];
+
+  // Preformatted kernel parameters reused by every dispatch. cuLaunchKernel
+  // copies the parameter values when called so each |kernel_params| entry
+  // permanently points at its |kernel_payload| slot and recording a dispatch
+  // only stores binding pointers and push constants into the payload.
+  void* kernel_params[IREE_HAL_CUDA_MAX_KERNEL_PARAM_COUNT];
+  CUdeviceptr kernel_payload[IREE_HAL_CUDA_MAX_KERNEL_PARAM_COUNT];
 } iree_hal_cuda_stream_command_buffer_t;
 
 static const iree_hal_command_buffer_vtable_t
@@ -62,9 +72,11 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
     const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
     iree_hal_cuda_tracing_context_t* tracing_context,
+    iree_hal_cuda_dispatch_profiler_t* dispatch_profiler,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_host_size_t binding_capacity, CUstream stream,
+    iree_device_size_t collective_bucket_size,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(device);
@@ -94,8 +106,12 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
   command_buffer->cuda_symbols = cuda_symbols;
   command_buffer->nccl_symbols = nccl_symbols;
   command_buffer->tracing_context = tracing_context;
+  command_buffer->dispatch_profiler = dispatch_profiler;
   command_buffer->cu_stream = stream;
   iree_arena_initialize(block_pool, &command_buffer->arena);
+  for (iree_host_size_t i = 0; i < IREE_HAL_CUDA_MAX_KERNEL_PARAM_COUNT; ++i) {
+    command_buffer->kernel_params[i] = &command_buffer->kernel_payload[i];
+  }
 
   iree_status_t status =
       iree_hal_resource_set_allocate(block_pool, &command_buffer->resource_set);
@@ -104,6 +120,8 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
     iree_hal_collective_batch_initialize(&command_buffer->arena,
                                          command_buffer->resource_set,
                                          &command_buffer->collective_batch);
+    iree_hal_collective_batch_set_bucket_size(&command_buffer->collective_batch,
+                                              collective_bucket_size);
   }
 
   *out_command_buffer = &command_buffer->base;
@@ -511,97 +529,72 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_dispatch(
 
   // Lookup kernel parameters used for side-channeling additional launch
   // information from the compiler.
-  iree_hal_cuda_kernel_info_t kernel_info;
+  const iree_hal_cuda_kernel_info_t* kernel_info = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_cuda_native_executable_entry_point_kernel_info(
               executable, entry_point, &kernel_info));
 
   IREE_CUDA_STREAM_TRACE_ZONE_BEGIN_EXTERNAL(
       command_buffer->tracing_context, command_buffer->cu_stream,
-      kernel_info.source_filename.data, kernel_info.source_filename.size,
-      kernel_info.source_line, kernel_info.function_name.data,
-      kernel_info.function_name.size,
+      kernel_info->source_filename.data, kernel_info->source_filename.size,
+      kernel_info->source_line, kernel_info->function_name.data,
+      kernel_info->function_name.size,
       /*name=*/NULL, 0);
 
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_resource_set_insert(command_buffer->resource_set, 1,
                                        &executable));
 
-  // The total number of descriptors across all descriptor sets.
-  iree_host_size_t descriptor_count =
-      iree_hal_cuda_pipeline_layout_total_binding_count(kernel_info.layout);
-  // The total number of push constants.
-  iree_host_size_t push_constant_count =
-      iree_hal_cuda_pipeline_layout_push_constant_count(kernel_info.layout);
-  // We append push constants to the end of descriptors to form a linear chain
-  // of kernel arguments.
-  iree_host_size_t kernel_params_count = descriptor_count + push_constant_count;
-  iree_host_size_t kernel_params_length = kernel_params_count * sizeof(void*);
-
-  // Per CUDA API requirements, we need two levels of indirection for passing
-  // kernel arguments in.
-  //   "If the kernel has N parameters, then kernelParams needs to be an array
-  //   of N pointers. Each pointer, from kernelParams[0] to kernelParams[N-1],
-  //   points to the region of memory from which the actual parameter will be
-  //   copied."
-  //
-  // (From the cuGraphAddKernelNode API doc in
-  // https://docs.nvidia.com/cuda/cuda-driver-api/group__CUDA__GRAPH.html#group__CUDA__GRAPH_1g50d871e3bd06c1b835e52f2966ef366b)
-  //
-  // It means each kernel_params[i] is itself a pointer to the corresponding
-  // element at the *second* inline allocation at the end of the current
-  // segment.
-  iree_host_size_t total_size = kernel_params_length * 2;
-  uint8_t* storage_base = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_arena_allocate(&command_buffer->arena, total_size,
-                              (void**)&storage_base));
-  void** params_ptr = (void**)storage_base;
-
-  // Set up kernel arguments to point to the payload slots.
-  CUdeviceptr* payload_ptr =
-      (CUdeviceptr*)((uint8_t*)params_ptr + kernel_params_length);
-  for (size_t i = 0; i < kernel_params_count; i++) {
-    params_ptr[i] = &payload_ptr[i];
+  // Kernel arguments are all descriptors of all sets followed by the push
+  // constants. The parameter pointers were set up when the command buffer was
+  // created and only the payload needs to be updated.
+  CUdeviceptr* payload_ptr = command_buffer->kernel_payload;
+  for (uint32_t i = 0; i < kernel_info->set_count; ++i) {
+    memcpy(payload_ptr + kernel_info->sets[i].base_index,
+           command_buffer->descriptor_sets[i].bindings,
+           kernel_info->sets[i].binding_count * sizeof(CUdeviceptr));
   }
 
-  // Copy descriptors from all sets to the end of the current segment for later
-  // access.
-  iree_host_size_t set_count =
-      iree_hal_cuda_pipeline_layout_descriptor_set_count(kernel_info.layout);
-  for (iree_host_size_t i = 0; i < set_count; ++i) {
-    // TODO: cache this information in the kernel info to avoid recomputation.
-    iree_host_size_t binding_count =
-        iree_hal_cuda_descriptor_set_layout_binding_count(
-            iree_hal_cuda_pipeline_layout_descriptor_set_layout(
-                kernel_info.layout, i));
-    iree_host_size_t index =
-        iree_hal_cuda_pipeline_layout_base_binding_index(kernel_info.layout, i);
-    memcpy(payload_ptr + index, command_buffer->descriptor_sets[i].bindings,
-           binding_count * sizeof(CUdeviceptr));
+  // Each kernel parameter slot is a CUdeviceptr, which has the size of a
+  // pointer on the target machine, but push constants are 32-bit values stored
+  // at the start of their slots.
+  for (uint32_t i = 0; i < kernel_info->push_constant_count; ++i) {
+    *((uint32_t*)&payload_ptr[kernel_info->push_constant_index + i]) =
+        command_buffer->push_constants[i];
   }
 
-  // Append the push constants to the kernel arguments.
-  iree_host_size_t base_index =
-      iree_hal_cuda_pipeline_layout_push_constant_index(kernel_info.layout);
-  // As commented in the above, what each kernel parameter points to is a
-  // CUdeviceptr, which as the size of a pointer on the target machine. we are
-  // just storing a 32-bit value for the push constant here instead. So we must
-  // process one element each type, for 64-bit machines.
-  for (iree_host_size_t i = 0; i < push_constant_count; i++) {
-    *((uint32_t*)params_ptr[base_index + i]) =
-        command_buffer->push_constants[i];
+  iree_host_size_t profile_slot = 0;
+  if (command_buffer->dispatch_profiler) {
+    const uint32_t workgroup_count[3] = {workgroup_x, workgroup_y,
+                                         workgroup_z};
+    profile_slot = iree_hal_cuda_dispatch_profiler_begin_dispatch(
+        command_buffer->dispatch_profiler, command_buffer->cu_stream,
+        executable, (uint32_t)entry_point, kernel_info->function_name,
+        workgroup_count, kernel_info->block_size);
   }
 
-  IREE_CUDA_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, command_buffer->cuda_symbols,
-      cuLaunchKernel(kernel_info.function, workgroup_x, workgroup_y,
-                     workgroup_z, kernel_info.block_size[0],
-                     kernel_info.block_size[1], kernel_info.block_size[2],
-                     kernel_info.shared_memory_size, command_buffer->cu_stream,
-                     params_ptr, NULL),
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      command_buffer->cuda_symbols,
+      cuLaunchKernel(kernel_info->function, workgroup_x, workgroup_y,
+                     workgroup_z, kernel_info->block_size[0],
+                     kernel_info->block_size[1], kernel_info->block_size[2],
+                     kernel_info->shared_memory_size,
+                     command_buffer->cu_stream, command_buffer->kernel_params,
+                     NULL),
       "cuLaunchKernel");
 
+  // The end event is recorded even if the launch failed so that the profile
+  // slot can still be resolved.
+  if (command_buffer->dispatch_profiler) {
+    iree_hal_cuda_dispatch_profiler_end_dispatch(
+        command_buffer->dispatch_profiler, command_buffer->cu_stream,
+        profile_slot);
+  }
+  if (!iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
   IREE_CUDA_STREAM_TRACE_ZONE_END(command_buffer->tracing_context,
                                   command_buffer->cu_stream);
 
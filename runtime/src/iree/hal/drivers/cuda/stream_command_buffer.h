@@ -11,6 +11,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/dispatch_profiler.h"
 #include "iree/hal/drivers/cuda/nccl_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/tracing.h"
 
@@ -29,14 +30,22 @@ extern "C" {
 // replaying the scratch data required for things like buffer updates is
 // retained by the source deferred command buffer and as such the |block_pool|
 // and can be NULL to avoid a double copy.
+//
+// Small all-reduces recorded between barriers are fused into buckets of up to
+// |collective_bucket_size| bytes when non-zero.
+//
+// When |dispatch_profiler| is non-NULL the device execution time of each
+// dispatch is recorded into it.
 iree_status_t iree_hal_cuda_stream_command_buffer_create(
     iree_hal_device_t* device,
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
     const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
     iree_hal_cuda_tracing_context_t* tracing_context,
+    iree_hal_cuda_dispatch_profiler_t* dispatch_profiler,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_host_size_t binding_capacity, CUstream stream,
+    iree_device_size_t collective_bucket_size,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
@@ -10,6 +10,7 @@
 #define IREE_HAL_DRIVERS_HIP_API_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/threading.h"
 #include "iree/hal/api.h"
 
 #ifdef __cplusplus
@@ -52,15 +53,27 @@ typedef struct iree_hal_hip_memory_pooling_params_t {
   iree_hal_hip_memory_pool_params_t other;
 } iree_hal_hip_memory_pooling_params_t;
 
+// Maximum number of hipStream_ts backing device queues, including the
+// dedicated copy queues.
+#define IREE_HAL_HIP_MAX_QUEUE_COUNT 16
+
 // Parameters configuring an iree_hal_hip_device_t.
 // Must be initialized with iree_hal_hip_device_params_initialize prior to
 // use.
 typedef struct iree_hal_hip_device_params_t {
   // Number of queues exposed on the device.
   // Each queue acts as a separate synchronization scope where all work executes
-  // concurrently unless prohibited by semaphores.
+  // concurrently unless prohibited by semaphores. Each queue is backed by its
+  // own hipStream_t and queue affinity bit N selects queue N (modulo the total
+  // number of queues).
   iree_host_size_t queue_count;
 
+  // Exposes two additional queues backed by dedicated host-to-device and
+  // device-to-host copy streams after the |queue_count| dispatch queues.
+  // File reads and writes are routed to these so that transfers (such as
+  // parameter uploads) overlap with compute on the dispatch queues.
+  bool dedicated_copy_queues;
+
   // Total size of each block in the device shared block pool.
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
@@ -90,6 +103,25 @@ typedef struct iree_hal_hip_device_params_t {
   // device. Defaults to true when the device supports it.
   bool async_allocations;
 
+  // Maximum total size in bytes of small all-reduce collectives fused into a
+  // single collective over a packed staging buffer. Fusing trades two device
+  // copies for one fewer RCCL launch per entry and helps workloads issuing
+  // many small collectives (such as tensor-parallel inference). 0 disables.
+  iree_device_size_t collective_bucket_size;
+
+  // Maximum duration to wait for collective channel communicators to be
+  // initialized. Communicators are created in nonblocking mode and channel
+  // creation fails with IREE_STATUS_DEADLINE_EXCEEDED if not all participants
+  // join before the timeout elapses. Defaults to IREE_DURATION_INFINITE.
+  iree_duration_t channel_init_timeout;
+
+  // Size in bytes of a persistent page-locked host staging ring used to back
+  // host-local transfer buffers such as those used by
+  // iree_hal_device_transfer_h2d/d2h and file streaming. Transfers larger than
+  // the free space in the ring fall back to allocating page-locked memory per
+  // transfer. 0 disables the ring.
+  iree_device_size_t staging_ring_capacity;
+
   // Parameters for each hipMemPool_t used for queue-ordered allocations.
   iree_hal_hip_memory_pooling_params_t memory_pools;
 
@@ -97,12 +129,41 @@ typedef struct iree_hal_hip_device_params_t {
   // Only command buffers produced by the compiler that have the
   // IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION bit set will use this.
   bool allow_inline_execution;
+
+  // Parameters of the worker thread that issues queue actions to the device
+  // once their waits have been satisfied. The name defaults to
+  // `deferque_worker` when empty and |create_suspended| is ignored. Setting
+  // |initial_affinity| and |priority_class| keeps the thread off cores
+  // reserved for other latency-sensitive work.
+  iree_thread_create_params_t worker_thread_params;
 } iree_hal_hip_device_params_t;
 
 // Initializes |out_params| to default values.
 IREE_API_EXPORT void iree_hal_hip_device_params_initialize(
     iree_hal_hip_device_params_t* out_params);
 
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_t
+//===----------------------------------------------------------------------===//
+
+// Occupancy of an executable export on the device it was loaded for, as
+// computed when the executable was created.
+typedef struct iree_hal_hip_export_occupancy_t {
+  // Maximum number of blocks of the export that can be resident on a single
+  // compute unit at once.
+  uint32_t max_active_blocks_per_multiprocessor;
+  // Total number of threads per block.
+  uint32_t threads_per_block;
+  // Static and dynamic shared memory (LDS) used per block in bytes.
+  uint32_t shared_memory_per_block;
+} iree_hal_hip_export_occupancy_t;
+
+// Queries the occupancy of |export_ordinal| in |executable|, which must have
+// been created by a HIP device.
+IREE_API_EXPORT iree_status_t iree_hal_hip_executable_query_export_occupancy(
+    iree_hal_executable_t* executable, uint32_t export_ordinal,
+    iree_hal_hip_export_occupancy_t* out_occupancy);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_hip_driver_t
 //===----------------------------------------------------------------------===//
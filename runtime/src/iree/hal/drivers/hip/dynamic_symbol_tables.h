@@ -9,6 +9,7 @@
 //===----------------------------------------------------------------------===//
 
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipCtxSetCurrent, hipCtx_t)
+IREE_HAL_HIP_OPTIONAL_PFN_DECL(hipDestroyExternalMemory, hipExternalMemory_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipDeviceGet, hipDevice_t *, int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipDeviceGetAttribute, int *,
                                hipDeviceAttribute_t, int)
@@ -29,8 +30,13 @@ IREE_HAL_HIP_REQUIRED_PFN_DECL(hipEventElapsedTime, float *, hipEvent_t,
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipEventQuery, hipEvent_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipEventRecord, hipEvent_t, hipStream_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipEventSynchronize, hipEvent_t)
+IREE_HAL_HIP_OPTIONAL_PFN_DECL(hipExternalMemoryGetMappedBuffer, void **,
+                               hipExternalMemory_t,
+                               const hipExternalMemoryBufferDesc *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipFree, void *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipFreeAsync, void *, hipStream_t)
+IREE_HAL_HIP_REQUIRED_PFN_DECL(hipFuncGetAttribute, int *,
+                               hipFunction_attribute, hipFunction_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipFuncSetAttribute, const void *,
                                hipFuncAttribute, int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGetDeviceCount, int *)
@@ -54,6 +60,8 @@ IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphAddMemsetNode, hipGraphNode_t *,
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphCreate, hipGraph_t *, unsigned int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphDestroy, hipGraph_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphExecDestroy, hipGraphExec_t)
+IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphExecKernelNodeSetParams, hipGraphExec_t,
+                               hipGraphNode_t, const hipKernelNodeParams *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphInstantiate, hipGraphExec_t *,
                                hipGraph_t, hipGraphNode_t *, char *, size_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphLaunch, hipGraphExec_t, hipStream_t)
@@ -63,12 +71,15 @@ IREE_HAL_HIP_REQUIRED_PFN_DECL(hipHostGetDevicePointer, void **, void *,
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipHostMalloc, void **, size_t, unsigned int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipHostRegister, void *, size_t, unsigned int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipHostUnregister, void *)
+IREE_HAL_HIP_OPTIONAL_PFN_DECL(hipImportExternalMemory, hipExternalMemory_t *,
+                               const hipExternalMemoryHandleDesc *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipInit, unsigned int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipLaunchHostFunc, hipStream_t, hipHostFn_t,
                                void *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipLaunchKernel, const void *, dim3, dim3,
                                void **, size_t, hipStream_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipMalloc, void **, size_t)
+IREE_HAL_HIP_REQUIRED_PFN_DECL(hipMallocAsync, void **, size_t, hipStream_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipMallocFromPoolAsync, void **, size_t,
                                hipMemPool_t, hipStream_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipMallocManaged, hipDeviceptr_t *, size_t,
@@ -107,6 +118,8 @@ IREE_HAL_HIP_REQUIRED_PFN_DECL(hipModuleLoadData, hipModule_t *, const void *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipModuleLoadDataEx, hipModule_t *, const void *,
                                unsigned int, hipJitOption *, void **)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipModuleUnload, hipModule_t)
+IREE_HAL_HIP_REQUIRED_PFN_DECL(hipModuleOccupancyMaxActiveBlocksPerMultiprocessor,
+                               int *, hipFunction_t, int, size_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipStreamCreateWithFlags, hipStream_t *,
                                unsigned int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipStreamDestroy, hipStream_t)
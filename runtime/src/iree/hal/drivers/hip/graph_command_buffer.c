@@ -24,6 +24,32 @@
 // barriers.
 #define IREE_HAL_HIP_MAX_CONCURRENT_GRAPH_NODE_COUNT 32
 
+// A kernel node with parameters that reference binding table slots.
+// The parameters are updated in the instantiated graph with the device
+// pointers from the binding table provided with each submission.
+typedef struct iree_hal_hip_graph_binding_patch_t {
+  struct iree_hal_hip_graph_binding_patch_t* next;
+  // Kernel node in the command buffer graph.
+  hipGraphNode_t node;
+  // Launch parameters of the node with kernelParams pointing at |payload|.
+  hipKernelNodeParams params;
+  // Kernel parameter payload storage updated with the resolved pointers.
+  hipDeviceptr_t* payload;
+  // True if |payload| has been applied to the instantiated graph. Updates
+  // that resolve to the same pointers as the last applied ones are skipped.
+  bool is_applied;
+  // Kernel parameters sourced from the binding table.
+  iree_host_size_t binding_count;
+  struct {
+    // Index of the kernel parameter in |payload|.
+    uint32_t param_index;
+    // Binding table slot the buffer is sourced from.
+    uint32_t slot;
+    // Offset added to the binding table buffer range.
+    iree_device_size_t offset;
+  } bindings[];
+} iree_hal_hip_graph_binding_patch_t;
+
 // Command buffer implementation that directly records into HIP graphs.
 // The command buffer records the commands on the calling thread without
 // additional threading indirection.
@@ -63,8 +89,25 @@ typedef struct iree_hal_hip_graph_command_buffer_t {
 
   // The current bound descriptor sets.
   struct {
+    // Device pointers of direct bindings or the offset relative to the binding
+    // table entry of indirect bindings.
     hipDeviceptr_t bindings[IREE_HAL_HIP_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+    // Binding table slot + 1 of each binding or 0 if the binding is direct.
+    uint32_t binding_slots[IREE_HAL_HIP_MAX_DESCRIPTOR_SET_BINDING_COUNT];
   } descriptor_sets[IREE_HAL_HIP_MAX_DESCRIPTOR_SET_COUNT];
+
+  // Preformatted kernel parameters used by dispatches that do not reference
+  // the binding table. Kernel node parameters are copied when the node is
+  // added so each |kernel_params| entry permanently points at its
+  // |kernel_payload| slot and only the payload is updated per dispatch.
+  void* kernel_params[IREE_HAL_HIP_MAX_KERNEL_PARAM_COUNT];
+  hipDeviceptr_t kernel_payload[IREE_HAL_HIP_MAX_KERNEL_PARAM_COUNT];
+
+  // All kernel nodes referencing the binding table in recording order.
+  // The graph is retained after instantiation when non-empty as the node
+  // handles are required to update the instantiated graph.
+  iree_hal_hip_graph_binding_patch_t* binding_patch_head;
+  iree_hal_hip_graph_binding_patch_t* binding_patch_tail;
 } iree_hal_hip_graph_command_buffer_t;
 
 static const iree_hal_command_buffer_vtable_t
@@ -170,12 +213,6 @@ iree_status_t iree_hal_hip_graph_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_hip_graph_command_buffer_t* command_buffer = NULL;
@@ -190,11 +227,18 @@ iree_status_t iree_hal_hip_graph_command_buffer_create(
   command_buffer->symbols = hip_symbols;
   command_buffer->tracing_context = tracing_context;
   iree_arena_initialize(block_pool, &command_buffer->arena);
+  for (iree_host_size_t i = 0; i < IREE_HAL_HIP_MAX_KERNEL_PARAM_COUNT; ++i) {
+    command_buffer->kernel_params[i] = &command_buffer->kernel_payload[i];
+  }
   command_buffer->hip_context = context;
   command_buffer->hip_graph = NULL;
   command_buffer->hip_exec = NULL;
   command_buffer->hip_barrier_node = NULL;
   command_buffer->graph_node_count = 0;
+  memset(command_buffer->descriptor_sets, 0,
+         sizeof(command_buffer->descriptor_sets));
+  command_buffer->binding_patch_head = NULL;
+  command_buffer->binding_patch_tail = NULL;
 
   iree_status_t status =
       iree_hal_resource_set_allocate(block_pool, &command_buffer->resource_set);
@@ -259,6 +303,65 @@ hipGraphExec_t iree_hal_hip_graph_command_buffer_handle(
   return command_buffer->hip_exec;
 }
 
+iree_status_t iree_hal_hip_graph_command_buffer_update_bindings(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_buffer_binding_table_t binding_table) {
+  iree_hal_hip_graph_command_buffer_t* command_buffer =
+      iree_hal_hip_graph_command_buffer_cast(base_command_buffer);
+  if (!command_buffer->binding_patch_head) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (iree_hal_hip_graph_binding_patch_t* patch =
+           command_buffer->binding_patch_head;
+       patch != NULL; patch = patch->next) {
+    bool is_dirty = !patch->is_applied;
+    for (iree_host_size_t i = 0; i < patch->binding_count; ++i) {
+      const uint32_t slot = patch->bindings[i].slot;
+      if (IREE_UNLIKELY(slot >= binding_table.count)) {
+        IREE_TRACE_ZONE_END(z0);
+        return iree_make_status(
+            IREE_STATUS_OUT_OF_RANGE,
+            "binding table slot %u out of range of the %" PRIhsz
+            " bindings provided",
+            slot, binding_table.count);
+      }
+      const iree_hal_buffer_binding_t* binding = &binding_table.bindings[slot];
+      if (IREE_UNLIKELY(!binding->buffer)) {
+        IREE_TRACE_ZONE_END(z0);
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "binding table slot %u has no buffer bound",
+                                slot);
+      }
+      hipDeviceptr_t device_buffer = iree_hal_hip_buffer_device_pointer(
+          iree_hal_buffer_allocated_buffer(binding->buffer));
+      hipDeviceptr_t device_ptr =
+          (uint8_t*)device_buffer +
+          iree_hal_buffer_byte_offset(binding->buffer) + binding->offset +
+          patch->bindings[i].offset;
+      hipDeviceptr_t* param = &patch->payload[patch->bindings[i].param_index];
+      if (*param != device_ptr) {
+        *param = device_ptr;
+        is_dirty = true;
+      }
+    }
+    // Resubmitting with the same bindings is common (e.g. steady-state loops
+    // that reuse their buffers) and needs no update of the instantiated graph.
+    if (!is_dirty) continue;
+    // Kernel parameters are copied when set; launches already enqueued are
+    // not affected by the update.
+    patch->is_applied = false;
+    IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, command_buffer->symbols,
+        hipGraphExecKernelNodeSetParams(command_buffer->hip_exec, patch->node,
+                                        &patch->params),
+        "hipGraphExecKernelNodeSetParams");
+    patch->is_applied = true;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 // Flushes any pending batched collective operations.
 // Must be called before any other non-collective nodes are added to the graph
 // or a barrier is encountered.
@@ -344,8 +447,10 @@ static iree_status_t iree_hal_hip_graph_command_buffer_end(
                           &error_node,
                           /*logBuffer=*/NULL,
                           /*bufferSize=*/0));
-  if (iree_status_is_ok(status)) {
-    // No longer need the source graph used for construction.
+  if (iree_status_is_ok(status) && !command_buffer->binding_patch_head) {
+    // No longer need the source graph used for construction. Command buffers
+    // with indirect bindings keep it as the nodes are used to update the
+    // instantiated graph.
     IREE_HIP_IGNORE_ERROR(command_buffer->symbols,
                           hipGraphDestroy(command_buffer->hip_graph));
     command_buffer->hip_graph = NULL;
@@ -709,9 +814,12 @@ static iree_status_t iree_hal_hip_graph_command_buffer_push_descriptor_set(
   IREE_TRACE_ZONE_BEGIN(z0);
   hipDeviceptr_t* current_bindings =
       command_buffer->descriptor_sets[set].bindings;
+  uint32_t* current_binding_slots =
+      command_buffer->descriptor_sets[set].binding_slots;
   for (iree_host_size_t i = 0; i < binding_count; i++) {
     const iree_hal_descriptor_set_binding_t* binding = &bindings[i];
     hipDeviceptr_t device_ptr = NULL;
+    uint32_t binding_slot = 0;
     if (binding->buffer) {
       IREE_RETURN_AND_END_ZONE_IF_ERROR(
           z0, iree_hal_resource_set_insert(command_buffer->resource_set, 1,
@@ -721,9 +829,14 @@ static iree_status_t iree_hal_hip_graph_command_buffer_push_descriptor_set(
           iree_hal_buffer_allocated_buffer(binding->buffer));
       iree_device_size_t offset = iree_hal_buffer_byte_offset(binding->buffer);
       device_ptr = (uint8_t*)device_buffer + offset + binding->offset;
+    } else {
+      // Resolved from the binding table when submitted.
+      device_ptr = (hipDeviceptr_t)(uintptr_t)binding->offset;
+      binding_slot = binding->buffer_slot + 1;
     }
 
     current_bindings[binding->binding] = device_ptr;
+    current_binding_slots[binding->binding] = binding_slot;
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -743,82 +856,102 @@ static iree_status_t iree_hal_hip_graph_command_buffer_dispatch(
 
   // Lookup kernel parameters used for side-channeling additional launch
   // information from the compiler.
-  iree_hal_hip_kernel_info_t kernel_info;
+  const iree_hal_hip_kernel_info_t* kernel_info = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_hip_native_executable_entry_point_kernel_info(
               executable, entry_point, &kernel_info));
 
   IREE_HIP_GRAPH_COMMAND_BUFFER_TRACE_ZONE_BEGIN_EXTERNAL(
-      command_buffer, kernel_info.source_filename.data,
-      kernel_info.source_filename.size, kernel_info.source_line,
-      kernel_info.function_name.data, kernel_info.function_name.size,
+      command_buffer, kernel_info->source_filename.data,
+      kernel_info->source_filename.size, kernel_info->source_line,
+      kernel_info->function_name.data, kernel_info->function_name.size,
       /*name=*/NULL, 0);
 
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_resource_set_insert(command_buffer->resource_set, 1,
                                        &executable));
-  iree_hal_hip_dispatch_layout_t dispatch_params =
-      iree_hal_hip_pipeline_layout_dispatch_layout(kernel_info.layout);
-  // The total number of descriptors across all descriptor sets.
-  iree_host_size_t descriptor_count = dispatch_params.total_binding_count;
-  // The total number of push constants.
-  iree_host_size_t push_constant_count = dispatch_params.push_constant_count;
-  // We append push constants to the end of descriptors to form a linear chain
-  // of kernel arguments.
-  iree_host_size_t kernel_params_count = descriptor_count + push_constant_count;
-  iree_host_size_t kernel_params_length = kernel_params_count * sizeof(void*);
-
-  iree_host_size_t total_size = kernel_params_length * 2;
-  uint8_t* storage_base = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_arena_allocate(&command_buffer->arena, total_size,
-                              (void**)&storage_base));
-  void** params_ptr = (void**)storage_base;
-
-  // Set up kernel arguments to point to the payload slots.
-  hipDeviceptr_t* payload_ptr =
-      (hipDeviceptr_t*)((uint8_t*)params_ptr + kernel_params_length);
-  for (size_t i = 0; i < kernel_params_count; i++) {
-    params_ptr[i] = &payload_ptr[i];
+
+  // Count the kernel parameters that must be resolved from the binding table.
+  iree_host_size_t indirect_binding_count = 0;
+  for (uint32_t i = 0; i < kernel_info->set_count; ++i) {
+    for (uint32_t j = 0; j < kernel_info->sets[i].binding_count; ++j) {
+      if (command_buffer->descriptor_sets[i].binding_slots[j]) {
+        ++indirect_binding_count;
+      }
+    }
   }
 
-  // Copy descriptors from all sets to the end of the current segment for later
-  // access.
-  iree_host_size_t set_count = dispatch_params.set_layout_count;
-  for (iree_host_size_t i = 0; i < set_count; ++i) {
-    // TODO: cache this information in the kernel info to avoid recomputation.
-    iree_host_size_t binding_count =
-        iree_hal_hip_descriptor_set_layout_binding_count(
-            iree_hal_hip_pipeline_layout_descriptor_set_layout(
-                kernel_info.layout, i));
-    iree_host_size_t index =
-        iree_hal_hip_pipeline_layout_base_binding_index(kernel_info.layout, i);
-    memcpy(payload_ptr + index, command_buffer->descriptor_sets[i].bindings,
-           binding_count * sizeof(hipDeviceptr_t));
+  // Dispatches that do not reference the binding table use the preformatted
+  // parameters of the command buffer. Dispatches that do must keep their
+  // parameters alive so that they can be patched with the binding table of
+  // each submission and get their own copy from the arena.
+  void** params_ptr = command_buffer->kernel_params;
+  hipDeviceptr_t* payload_ptr = command_buffer->kernel_payload;
+  iree_hal_hip_graph_binding_patch_t* patch = NULL;
+  if (indirect_binding_count > 0) {
+    iree_host_size_t kernel_params_length =
+        kernel_info->param_count * sizeof(void*);
+    uint8_t* storage_base = NULL;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(&command_buffer->arena,
+                                kernel_params_length * 2,
+                                (void**)&storage_base));
+    params_ptr = (void**)storage_base;
+    payload_ptr = (hipDeviceptr_t*)(storage_base + kernel_params_length);
+    for (uint32_t i = 0; i < kernel_info->param_count; ++i) {
+      params_ptr[i] = &payload_ptr[i];
+    }
+
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(&command_buffer->arena,
+                                sizeof(*patch) + indirect_binding_count *
+                                                     sizeof(patch->bindings[0]),
+                                (void**)&patch));
+    patch->next = NULL;
+    patch->payload = payload_ptr;
+    patch->is_applied = false;
+    patch->binding_count = 0;
+    for (uint32_t i = 0; i < kernel_info->set_count; ++i) {
+      const uint32_t base_index = kernel_info->sets[i].base_index;
+      for (uint32_t j = 0; j < kernel_info->sets[i].binding_count; ++j) {
+        uint32_t slot = command_buffer->descriptor_sets[i].binding_slots[j];
+        if (!slot) continue;
+        patch->bindings[patch->binding_count].param_index = base_index + j;
+        patch->bindings[patch->binding_count].slot = slot - 1;
+        patch->bindings[patch->binding_count].offset =
+            (iree_device_size_t)(uintptr_t)command_buffer->descriptor_sets[i]
+                .bindings[j];
+        ++patch->binding_count;
+      }
+    }
   }
 
-  // Append the push constants to the kernel arguments.
-  iree_host_size_t base_index = dispatch_params.push_constant_base_index;
+  // Copy descriptors from all sets into the kernel parameter payload. Indirect
+  // bindings store their binding table offset and are resolved when patched.
+  for (uint32_t i = 0; i < kernel_info->set_count; ++i) {
+    memcpy(payload_ptr + kernel_info->sets[i].base_index,
+           command_buffer->descriptor_sets[i].bindings,
+           kernel_info->sets[i].binding_count * sizeof(hipDeviceptr_t));
+  }
 
-  // Each kernel parameter points to is a hipDeviceptr_t, which as the size of a
-  // pointer on the target machine. we are just storing a 32-bit value for the
-  // push constant here instead. So we must process one element each type, for
-  // 64-bit machines.
-  for (iree_host_size_t i = 0; i < push_constant_count; i++) {
-    *((uint32_t*)params_ptr[base_index + i]) =
+  // Each kernel parameter slot is a hipDeviceptr_t, which has the size of a
+  // pointer on the target machine, but push constants are 32-bit values stored
+  // at the start of their slots.
+  for (uint32_t i = 0; i < kernel_info->push_constant_count; ++i) {
+    *((uint32_t*)&payload_ptr[kernel_info->push_constant_index + i]) =
         command_buffer->push_constants[i];
   }
 
   hipKernelNodeParams params = {
-      .blockDim.x = kernel_info.block_size[0],
-      .blockDim.y = kernel_info.block_size[1],
-      .blockDim.z = kernel_info.block_size[2],
+      .blockDim.x = kernel_info->block_size[0],
+      .blockDim.y = kernel_info->block_size[1],
+      .blockDim.z = kernel_info->block_size[2],
       .gridDim.x = workgroup_x,
       .gridDim.y = workgroup_y,
       .gridDim.z = workgroup_z,
-      .func = kernel_info.function,
+      .func = kernel_info->function,
       .kernelParams = params_ptr,
-      .sharedMemBytes = kernel_info.shared_memory_size,
+      .sharedMemBytes = kernel_info->shared_memory_size,
   };
 
   if (command_buffer->graph_node_count >=
@@ -828,14 +961,26 @@ static iree_status_t iree_hal_hip_graph_command_buffer_dispatch(
   }
 
   size_t dependency_count = command_buffer->hip_barrier_node ? 1 : 0;
+  hipGraphNode_t* kernel_node =
+      &command_buffer->hip_graph_nodes[command_buffer->graph_node_count++];
   IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
       z0, command_buffer->symbols,
-      hipGraphAddKernelNode(
-          &command_buffer->hip_graph_nodes[command_buffer->graph_node_count++],
-          command_buffer->hip_graph, &command_buffer->hip_barrier_node,
-          dependency_count, &params),
+      hipGraphAddKernelNode(kernel_node, command_buffer->hip_graph,
+                            &command_buffer->hip_barrier_node,
+                            dependency_count, &params),
       "hipGraphAddKernelNode");
 
+  if (patch) {
+    patch->node = *kernel_node;
+    patch->params = params;
+    if (command_buffer->binding_patch_tail) {
+      command_buffer->binding_patch_tail->next = patch;
+    } else {
+      command_buffer->binding_patch_head = patch;
+    }
+    command_buffer->binding_patch_tail = patch;
+  }
+
   IREE_HIP_GRAPH_COMMAND_BUFFER_TRACE_ZONE_END(command_buffer);
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
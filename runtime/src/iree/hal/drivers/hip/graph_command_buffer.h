@@ -45,6 +45,14 @@ bool iree_hal_hip_graph_command_buffer_isa(
 hipGraphExec_t iree_hal_hip_graph_command_buffer_handle(
     iree_hal_command_buffer_t* command_buffer);
 
+// Updates the kernel parameters of the instantiated graph that reference
+// binding table slots with the buffers in |binding_table|. Must be called
+// prior to each launch of a command buffer with a non-zero binding capacity.
+// Launches already enqueued are not affected.
+iree_status_t iree_hal_hip_graph_command_buffer_update_bindings(
+    iree_hal_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,13 +6,20 @@
 
 #include "iree/hal/drivers/hip/hip_allocator.h"
 
+#include <errno.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/hip/dynamic_symbols.h"
 #include "iree/hal/drivers/hip/hip_buffer.h"
 #include "iree/hal/drivers/hip/status_util.h"
+#include "iree/hal/drivers/utils/staging_ring.h"
+
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <unistd.h>
+#endif  // !IREE_PLATFORM_WINDOWS
 
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
 static const char* IREE_HAL_HIP_ALLOCATOR_ID = "HIP unpooled";
@@ -41,6 +48,17 @@ typedef struct iree_hal_hip_allocator_t {
   // between GPU and CPU if not.
   bool supports_concurrent_managed_access;
 
+  // Whether the device is integrated with the host and shares its physical
+  // memory. Device-local memory is backed by page-locked host memory mapped
+  // into the device so that the host can access it directly without staging.
+  bool is_integrated;
+
+  // Persistent page-locked host memory used for transfer staging buffers.
+  // NULL if the staging ring is disabled.
+  void* staging_host_ptr;
+  hipDeviceptr_t staging_device_ptr;
+  iree_hal_staging_ring_t staging_ring;
+
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
 } iree_hal_hip_allocator_t;
 
@@ -55,7 +73,8 @@ static iree_hal_hip_allocator_t* iree_hal_hip_allocator_cast(
 iree_status_t iree_hal_hip_allocator_create(
     const iree_hal_hip_dynamic_symbols_t* hip_symbols, hipDevice_t device,
     hipStream_t stream, iree_hal_hip_memory_pools_t* pools,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+    iree_device_size_t staging_ring_capacity, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(hip_symbols);
   IREE_ASSERT_ARGUMENT(out_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -81,6 +100,19 @@ iree_status_t iree_hal_hip_allocator_create(
               : "no CONCURRENT_MANAGED_ACCESS (expect slow accesses on "
                 "device-local + host-visible memory)");
 
+  // Integrated devices (such as APUs) share physical memory with the host and
+  // page-locked host memory is as fast for the device to access as memory from
+  // hipMalloc.
+  int is_integrated = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, IREE_HIP_RESULT_TO_STATUS(
+              hip_symbols,
+              hipDeviceGetAttribute(&is_integrated,
+                                    hipDeviceAttributeIntegrated, device),
+              "hipDeviceGetAttribute"));
+  IREE_TRACE_ZONE_APPEND_TEXT(
+      z0, is_integrated ? "INTEGRATED (unified memory)" : "discrete");
+
   iree_hal_hip_allocator_t* allocator = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_allocator_malloc(host_allocator, sizeof(*allocator),
@@ -94,10 +126,37 @@ iree_status_t iree_hal_hip_allocator_create(
   allocator->host_allocator = host_allocator;
   allocator->supports_concurrent_managed_access =
       supports_concurrent_managed_access != 0;
-  *out_allocator = (iree_hal_allocator_t*)allocator;
+  allocator->is_integrated = is_integrated != 0;
+
+  // Allocate the staging ring. It is not write-combined as it is used for
+  // both uploads and readbacks and host reads from write-combined memory are
+  // very slow.
+  iree_status_t status = iree_ok_status();
+  if (staging_ring_capacity > 0) {
+    iree_hal_staging_ring_initialize(staging_ring_capacity,
+                                     /*alignment=*/64,
+                                     &allocator->staging_ring);
+    status = IREE_HIP_RESULT_TO_STATUS(
+        hip_symbols,
+        hipHostMalloc(&allocator->staging_host_ptr, staging_ring_capacity,
+                      hipHostMallocMapped),
+        "hipHostMalloc");
+    if (iree_status_is_ok(status)) {
+      status = IREE_HIP_RESULT_TO_STATUS(
+          hip_symbols,
+          hipHostGetDevicePointer(&allocator->staging_device_ptr,
+                                  allocator->staging_host_ptr, /*flags=*/0),
+          "hipHostGetDevicePointer");
+    }
+  }
 
+  if (iree_status_is_ok(status)) {
+    *out_allocator = (iree_hal_allocator_t*)allocator;
+  } else {
+    iree_hal_allocator_release((iree_hal_allocator_t*)allocator);
+  }
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_hip_allocator_destroy(
@@ -106,6 +165,14 @@ static void iree_hal_hip_allocator_destroy(
       iree_hal_hip_allocator_cast(base_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (allocator->staging_ring.capacity > 0) {
+    iree_hal_staging_ring_deinitialize(&allocator->staging_ring);
+  }
+  if (allocator->staging_host_ptr) {
+    IREE_HIP_IGNORE_ERROR(allocator->symbols,
+                          hipHostFree(allocator->staging_host_ptr));
+  }
+
   iree_allocator_free(allocator->host_allocator, allocator);
 
   IREE_TRACE_ZONE_END(z0);
@@ -145,9 +212,14 @@ static iree_status_t iree_hal_hip_allocator_query_memory_heaps(
   iree_hal_hip_allocator_t* allocator =
       iree_hal_hip_allocator_cast(base_allocator);
 
-  iree_host_size_t count = 3;
-  if (allocator->supports_concurrent_managed_access) {
-    ++count;  // device-local | host-visible
+  iree_host_size_t count = 0;
+  if (allocator->is_integrated) {
+    count = 2;  // unified | cached host-local
+  } else {
+    count = 3;
+    if (allocator->supports_concurrent_managed_access) {
+      ++count;  // device-local | host-visible
+    }
   }
   if (out_count) *out_count = count;
   if (capacity < count) {
@@ -163,6 +235,37 @@ static iree_status_t iree_hal_hip_allocator_query_memory_heaps(
 
   int i = 0;
 
+  if (allocator->is_integrated) {
+    // Unified page-locked memory shared by the host and device (dispatch
+    // resources and upload):
+    heaps[i++] = (iree_hal_allocator_memory_heap_t){
+        .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
+                IREE_HAL_MEMORY_TYPE_HOST_VISIBLE |
+                IREE_HAL_MEMORY_TYPE_HOST_COHERENT,
+        .allowed_usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                         IREE_HAL_BUFFER_USAGE_DISPATCH |
+                         IREE_HAL_BUFFER_USAGE_MAPPING,
+        .max_allocation_size = max_allocation_size,
+        .min_alignment = min_alignment,
+    };
+
+    // Cached page-locked host-local memory (download):
+    heaps[i++] = (iree_hal_allocator_memory_heap_t){
+        .type = IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE |
+                IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                IREE_HAL_MEMORY_TYPE_HOST_COHERENT |
+                IREE_HAL_MEMORY_TYPE_HOST_CACHED,
+        .allowed_usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                         IREE_HAL_BUFFER_USAGE_DISPATCH |
+                         IREE_HAL_BUFFER_USAGE_MAPPING,
+        .max_allocation_size = max_allocation_size,
+        .min_alignment = min_alignment,
+    };
+
+    IREE_ASSERT(i == count);
+    return iree_ok_status();
+  }
+
   // Device-local memory (dispatch resources):
   heaps[i++] = (iree_hal_allocator_memory_heap_t){
       .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
@@ -245,8 +348,18 @@ iree_hal_hip_allocator_query_buffer_compatibility(
     }
   }
 
-  if (iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
-                                          IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
+  // Integrated devices back all device-local memory with page-locked host
+  // memory that the host can map directly. Making these buffers host-visible
+  // and mappable lets transfers and file reads write them in place instead of
+  // going through staging buffers and device copies.
+  if (allocator->is_integrated &&
+      iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    params->type |=
+        IREE_HAL_MEMORY_TYPE_HOST_VISIBLE | IREE_HAL_MEMORY_TYPE_HOST_COHERENT;
+    params->usage |= IREE_HAL_BUFFER_USAGE_MAPPING;
+  } else if (iree_all_bits_set(params->type,
+                               IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
+                                   IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
     // Device local and host visible in general is much more slower than device
     // only for discrete GPUs. So mark as so accordingly.
     compatibility |= IREE_HAL_BUFFER_COMPATIBILITY_LOW_PERFORMANCE;
@@ -303,10 +416,71 @@ static void iree_hal_hip_buffer_free(
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "(ignored; external)");
       break;
     }
+    case IREE_HAL_HIP_BUFFER_TYPE_EXTERNAL_MEMORY: {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "hipFree (external memory)");
+      IREE_HIP_IGNORE_ERROR(hip_symbols, hipFree(device_ptr));
+      break;
+    }
+    case IREE_HAL_HIP_BUFFER_TYPE_STAGING: {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "(ignored; staging ring)");
+      break;
+    }
   }
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Usage bits allowed on buffers suballocated from the staging ring. Buffers
+// used by dispatches may be long-lived and would pin the ring.
+#define IREE_HAL_HIP_STAGING_USAGE_MASK                                     \
+  (IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED | \
+   IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT |                              \
+   IREE_HAL_BUFFER_USAGE_MAPPING_OPTIONAL |                                \
+   IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_RANDOM |                           \
+   IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_SEQUENTIAL_WRITE)
+
+static void iree_hal_hip_allocator_release_staging(void* user_data,
+                                                   iree_hal_buffer_t* buffer) {
+  iree_hal_hip_allocator_t* allocator = (iree_hal_hip_allocator_t*)user_data;
+  const iree_device_size_t offset =
+      (iree_device_size_t)((uint8_t*)iree_hal_hip_buffer_host_pointer(buffer) -
+                           (uint8_t*)allocator->staging_host_ptr);
+  iree_hal_staging_ring_release(&allocator->staging_ring, offset);
+}
+
+// Attempts to suballocate a host-local transfer buffer from the staging ring.
+// Returns NULL in |out_buffer| if the buffer cannot be served from the ring and
+// must be allocated normally.
+static iree_status_t iree_hal_hip_allocator_allocate_staging(
+    iree_hal_hip_allocator_t* allocator, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (!allocator->staging_device_ptr ||
+      iree_any_bit_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL) ||
+      iree_any_bit_set(params->usage, ~IREE_HAL_HIP_STAGING_USAGE_MASK)) {
+    return iree_ok_status();
+  }
+  iree_device_size_t offset = 0;
+  if (!iree_hal_staging_ring_reserve(&allocator->staging_ring,
+                                     allocation_size, &offset)) {
+    return iree_ok_status();
+  }
+  iree_status_t status = iree_hal_hip_buffer_wrap(
+      (iree_hal_allocator_t*)allocator, params->type, params->access,
+      params->usage, allocation_size, /*byte_offset=*/0,
+      /*byte_length=*/allocation_size, IREE_HAL_HIP_BUFFER_TYPE_STAGING,
+      (uint8_t*)allocator->staging_device_ptr + offset,
+      (uint8_t*)allocator->staging_host_ptr + offset,
+      (iree_hal_buffer_release_callback_t){
+          .fn = iree_hal_hip_allocator_release_staging,
+          .user_data = allocator,
+      },
+      allocator->host_allocator, out_buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_staging_ring_release(&allocator->staging_ring, offset);
+  }
+  return status;
+}
+
 static iree_status_t iree_hal_hip_allocator_allocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -343,14 +517,40 @@ static iree_status_t iree_hal_hip_allocator_allocate_buffer(
 #endif  // IREE_STATUS_MODE
   }
 
+  // Host-local transfer buffers are served from the staging ring when it has
+  // space to avoid the cost of allocating and pinning host memory per
+  // transfer.
+  iree_hal_buffer_t* staging_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_hip_allocator_allocate_staging(
+      allocator, &compat_params, allocation_size, &staging_buffer));
+  if (staging_buffer) {
+    *out_buffer = staging_buffer;
+    return iree_ok_status();
+  }
+
   iree_status_t status = iree_ok_status();
   iree_hal_hip_buffer_type_t buffer_type = IREE_HAL_HIP_BUFFER_TYPE_DEVICE;
   void* host_ptr = NULL;
   hipDeviceptr_t device_ptr = NULL;
   IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_hal_hip_buffer_allocate");
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, allocation_size);
-  if (iree_all_bits_set(compat_params.type,
+  if (allocator->is_integrated &&
+      iree_all_bits_set(compat_params.type,
                         IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    // Unified memory on integrated devices. Managed memory is avoided as
+    // the host may not be able to touch it while the device is running.
+    // Page-locked memory is not write-combined so that host reads remain fast.
+    buffer_type = IREE_HAL_HIP_BUFFER_TYPE_HOST;
+    status = IREE_HIP_RESULT_TO_STATUS(
+        allocator->symbols,
+        hipHostMalloc(&host_ptr, allocation_size, hipHostMallocMapped));
+    if (iree_status_is_ok(status)) {
+      status = IREE_HIP_RESULT_TO_STATUS(
+          allocator->symbols,
+          hipHostGetDevicePointer(&device_ptr, host_ptr, /*flags=*/0));
+    }
+  } else if (iree_all_bits_set(compat_params.type,
+                               IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
     // Device local case.
     if (iree_all_bits_set(compat_params.type,
                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
@@ -407,8 +607,10 @@ static iree_status_t iree_hal_hip_allocator_allocate_buffer(
     IREE_TRACE_ALLOC_NAMED(IREE_HAL_HIP_ALLOCATOR_ID,
                            (void*)iree_hal_hip_buffer_device_pointer(buffer),
                            allocation_size);
+    buffer->allocation_tag = compat_params.tag;
     IREE_STATISTICS(iree_hal_allocator_statistics_record_alloc(
-        &allocator->statistics, compat_params.type, allocation_size));
+        &allocator->statistics, compat_params.type, compat_params.tag,
+        allocation_size));
     *out_buffer = buffer;
   } else {
     if (!buffer && (device_ptr || host_ptr)) {
@@ -442,6 +644,7 @@ static void iree_hal_hip_allocator_deallocate_buffer(
           (void*)iree_hal_hip_buffer_device_pointer(base_buffer));
       IREE_STATISTICS(iree_hal_allocator_statistics_record_free(
           &allocator->statistics, iree_hal_buffer_memory_type(base_buffer),
+          iree_hal_buffer_allocation_tag(base_buffer),
           iree_hal_buffer_allocation_size(base_buffer)));
       break;
     }
@@ -453,6 +656,145 @@ static void iree_hal_hip_allocator_deallocate_buffer(
   iree_hal_buffer_destroy(base_buffer);
 }
 
+// External memory object imported from a handle. Kept alive until the buffer
+// mapped from it is destroyed; the mapping itself is freed with hipFree by the
+// allocator before the buffer release callback runs.
+typedef struct iree_hal_hip_external_memory_t {
+  const iree_hal_hip_dynamic_symbols_t* symbols;
+  iree_allocator_t host_allocator;
+  hipExternalMemory_t handle;
+  // User-provided release callback chained after the external memory is gone.
+  iree_hal_buffer_release_callback_t user_release_callback;
+} iree_hal_hip_external_memory_t;
+
+static void iree_hal_hip_external_memory_release(void* user_data,
+                                                 iree_hal_buffer_t* buffer) {
+  iree_hal_hip_external_memory_t* external_memory =
+      (iree_hal_hip_external_memory_t*)user_data;
+  IREE_HIP_IGNORE_ERROR(external_memory->symbols,
+                        hipDestroyExternalMemory(external_memory->handle));
+  if (external_memory->user_release_callback.fn) {
+    external_memory->user_release_callback.fn(
+        external_memory->user_release_callback.user_data, buffer);
+  }
+  iree_allocator_free(external_memory->host_allocator, external_memory);
+}
+
+// Imports an OPAQUE_FD, DMA_BUF, or OPAQUE_WIN32 handle with
+// hipImportExternalMemory and maps the entire allocation as a device buffer.
+// ROCm resolves opaque file descriptors through its dma-buf interop path and
+// dma-bufs from other drivers are imported the same way. The caller retains
+// ownership of the handle: HIP takes ownership of file descriptors on a
+// successful import so we hand it a duplicate.
+static iree_status_t iree_hal_hip_allocator_import_external_memory(
+    iree_hal_hip_allocator_t* allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT compat_params,
+    iree_hal_external_buffer_t* IREE_RESTRICT external_buffer,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  if (!allocator->symbols->hipImportExternalMemory ||
+      !allocator->symbols->hipExternalMemoryGetMappedBuffer ||
+      !allocator->symbols->hipDestroyExternalMemory) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "missing hipImportExternalMemory symbols; cannot import external "
+        "memory handles with this HIP runtime");
+  }
+
+  hipExternalMemoryHandleDesc handle_desc;
+  memset(&handle_desc, 0, sizeof(handle_desc));
+  handle_desc.size = external_buffer->size;
+  if (iree_all_bits_set(external_buffer->flags,
+                        IREE_HAL_EXTERNAL_BUFFER_FLAG_DEDICATED)) {
+    handle_desc.flags |= hipExternalMemoryDedicated;
+  }
+  int import_fd = -1;
+  if (external_buffer->type == IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_WIN32) {
+    handle_desc.type = hipExternalMemoryHandleTypeOpaqueWin32;
+    handle_desc.handle.win32.handle =
+        external_buffer->handle.opaque_win32.handle;
+  } else {
+#if defined(IREE_PLATFORM_WINDOWS)
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "file descriptor imports are not available on "
+                            "Windows; use OPAQUE_WIN32 handles instead");
+#else
+    int fd = external_buffer->type == IREE_HAL_EXTERNAL_BUFFER_TYPE_DMA_BUF
+                 ? external_buffer->handle.dma_buf.fd
+                 : external_buffer->handle.opaque_fd.fd;
+    import_fd = dup(fd);
+    if (import_fd < 0) {
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "unable to duplicate file descriptor %d", fd);
+    }
+    handle_desc.type = hipExternalMemoryHandleTypeOpaqueFd;
+    handle_desc.handle.fd = import_fd;
+#endif  // IREE_PLATFORM_WINDOWS
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)external_buffer->size);
+
+  hipExternalMemory_t external_memory_handle = NULL;
+  iree_status_t status = IREE_HIP_RESULT_TO_STATUS(
+      allocator->symbols,
+      hipImportExternalMemory(&external_memory_handle, &handle_desc),
+      "hipImportExternalMemory");
+#if !defined(IREE_PLATFORM_WINDOWS)
+  if (!iree_status_is_ok(status) && import_fd >= 0) close(import_fd);
+#endif  // !IREE_PLATFORM_WINDOWS
+
+  hipDeviceptr_t device_ptr = NULL;
+  if (iree_status_is_ok(status)) {
+    hipExternalMemoryBufferDesc buffer_desc;
+    memset(&buffer_desc, 0, sizeof(buffer_desc));
+    buffer_desc.offset = 0;
+    buffer_desc.size = external_buffer->size;
+    status = IREE_HIP_RESULT_TO_STATUS(
+        allocator->symbols,
+        hipExternalMemoryGetMappedBuffer(&device_ptr, external_memory_handle,
+                                         &buffer_desc),
+        "hipExternalMemoryGetMappedBuffer");
+  }
+
+  iree_hal_hip_external_memory_t* external_memory = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(allocator->host_allocator,
+                                   sizeof(*external_memory),
+                                   (void**)&external_memory);
+  }
+  if (iree_status_is_ok(status)) {
+    external_memory->symbols = allocator->symbols;
+    external_memory->host_allocator = allocator->host_allocator;
+    external_memory->handle = external_memory_handle;
+    external_memory->user_release_callback = release_callback;
+    iree_hal_buffer_release_callback_t internal_release_callback = {
+        .fn = iree_hal_hip_external_memory_release,
+        .user_data = external_memory,
+    };
+    status = iree_hal_hip_buffer_wrap(
+        (iree_hal_allocator_t*)allocator, compat_params->type,
+        compat_params->access, compat_params->usage, external_buffer->size,
+        /*byte_offset=*/0, /*byte_length=*/external_buffer->size,
+        IREE_HAL_HIP_BUFFER_TYPE_EXTERNAL_MEMORY, device_ptr,
+        /*host_ptr=*/NULL, internal_release_callback,
+        allocator->host_allocator, out_buffer);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(allocator->host_allocator, external_memory);
+    if (device_ptr) {
+      IREE_HIP_IGNORE_ERROR(allocator->symbols, hipFree(device_ptr));
+    }
+    if (external_memory_handle) {
+      IREE_HIP_IGNORE_ERROR(allocator->symbols,
+                            hipDestroyExternalMemory(external_memory_handle));
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_hip_allocator_import_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -527,8 +869,10 @@ static iree_status_t iree_hal_hip_allocator_import_buffer(
     }
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_FD:
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_WIN32:
-      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                              "handle-based imports not yet implemented");
+    case IREE_HAL_EXTERNAL_BUFFER_TYPE_DMA_BUF:
+      return iree_hal_hip_allocator_import_external_memory(
+          allocator, &compat_params, external_buffer, release_callback,
+          out_buffer);
     default:
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                               "external buffer type not supported");
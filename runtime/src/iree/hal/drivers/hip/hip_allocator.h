@@ -20,10 +20,14 @@ extern "C" {
 // |device| and |stream| will be used for management operations.
 // |pools| provides memory pools that may be shared across multiple allocators
 // and the pointer must remain valid for the lifetime of the allocator.
+// |staging_ring_capacity| bytes of page-locked host memory are allocated up
+// front and used to service host-local transfer buffers; 0 disables the ring.
+// The HIP context must be current on the calling thread.
 iree_status_t iree_hal_hip_allocator_create(
     const iree_hal_hip_dynamic_symbols_t* hip_symbols, hipDevice_t device,
     hipStream_t stream, iree_hal_hip_memory_pools_t* pools,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+    iree_device_size_t staging_ring_capacity, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -30,6 +30,13 @@ typedef enum iree_hal_hip_buffer_type_e {
   // Externally registered buffer whose providence is unknown.
   // Must be freed by the user.
   IREE_HAL_HIP_BUFFER_TYPE_EXTERNAL,
+  // Device local buffer mapped from memory imported with
+  // hipImportExternalMemory; the mapping is freed with hipFree and the
+  // external memory object is destroyed by the buffer release callback.
+  IREE_HAL_HIP_BUFFER_TYPE_EXTERNAL_MEMORY,
+  // Host local buffer suballocated from the allocator staging ring; the range
+  // is returned to the ring by the buffer release callback.
+  IREE_HAL_HIP_BUFFER_TYPE_STAGING,
 } iree_hal_hip_buffer_type_t;
 
 // Wraps a HIP allocation in an iree_hal_buffer_t.
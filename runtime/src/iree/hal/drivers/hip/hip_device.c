@@ -30,6 +30,7 @@
 #include "iree/hal/drivers/hip/stream_command_buffer.h"
 #include "iree/hal/drivers/hip/timepoint_pool.h"
 #include "iree/hal/drivers/hip/tracing.h"
+#include "iree/hal/drivers/utils/queue.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
@@ -60,11 +61,16 @@ typedef struct iree_hal_hip_device_t {
 
   hipCtx_t hip_context;
   hipDevice_t hip_device;
-  // TODO: Support multiple device streams.
-  // The hipStream_t used to issue device kernels and allocations.
-  hipStream_t hip_dispatch_stream;
-  // The hipStream_t used to issue host callback functions.
-  hipStream_t hip_callback_stream;
+  // Total number of queues, each backed by a pair of streams. The first
+  // params.queue_count are dispatch queues and when enabled the last two are
+  // the dedicated host-to-device and device-to-host copy queues.
+  iree_host_size_t queue_count;
+  // The hipStream_ts used to issue device kernels and allocations per queue.
+  hipStream_t hip_dispatch_streams[IREE_HAL_HIP_MAX_QUEUE_COUNT];
+  // The hipStream_ts used to issue host callback functions per queue.
+  // Separate per queue so that completions on one queue are not blocked
+  // behind pending work on another.
+  hipStream_t hip_callback_streams[IREE_HAL_HIP_MAX_QUEUE_COUNT];
 
   iree_hal_hip_tracing_context_t* tracing_context;
 
@@ -104,15 +110,38 @@ static iree_hal_hip_device_t* iree_hal_hip_device_cast_unsafe(
   return (iree_hal_hip_device_t*)base_value;
 }
 
+// Returns the index of the queue that work with |queue_affinity| is issued to.
+static iree_host_size_t iree_hal_hip_device_select_queue(
+    iree_hal_hip_device_t* device, iree_hal_queue_affinity_t queue_affinity) {
+  return iree_hal_queue_affinity_select_index(queue_affinity,
+                                              device->queue_count);
+}
+
+// Returns the queue affinity used for file transfers in the given direction.
+// Transfers are routed to the dedicated copy queues when enabled and otherwise
+// use the |queue_affinity| requested.
+static iree_hal_queue_affinity_t iree_hal_hip_device_transfer_affinity(
+    iree_hal_hip_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    bool host_to_device) {
+  if (!device->params.dedicated_copy_queues) return queue_affinity;
+  const iree_host_size_t queue_index =
+      device->params.queue_count + (host_to_device ? 0 : 1);
+  return 1ull << queue_index;
+}
+
 IREE_API_EXPORT void iree_hal_hip_device_params_initialize(
     iree_hal_hip_device_params_t* out_params) {
   memset(out_params, 0, sizeof(*out_params));
   out_params->arena_block_size = 32 * 1024;
   out_params->event_pool_capacity = 32;
   out_params->queue_count = 1;
+  out_params->dedicated_copy_queues = false;
   out_params->command_buffer_mode = IREE_HAL_HIP_COMMAND_BUFFER_MODE_GRAPH;
   out_params->stream_tracing = false;
   out_params->async_allocations = true;
+  out_params->collective_bucket_size = 4 * 1024 * 1024;
+  out_params->channel_init_timeout = IREE_DURATION_INFINITE;
+  out_params->staging_ring_capacity = 32 * 1024 * 1024;
   out_params->allow_inline_execution = false;
 }
 
@@ -126,13 +155,22 @@ static iree_status_t iree_hal_hip_device_check_params(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "at least one queue is required");
   }
+  const iree_host_size_t total_queue_count =
+      params->queue_count + (params->dedicated_copy_queues ? 2 : 0);
+  if (total_queue_count > IREE_HAL_HIP_MAX_QUEUE_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "too many queues requested (%" PRIhsz
+                            " including copy queues, max %d)",
+                            total_queue_count, IREE_HAL_HIP_MAX_QUEUE_COUNT);
+  }
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_hip_device_create_internal(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
     const iree_hal_hip_device_params_t* params, hipDevice_t hip_device,
-    hipStream_t dispatch_stream, hipStream_t callback_stream, hipCtx_t context,
+    iree_host_size_t queue_count, const hipStream_t* dispatch_streams,
+    const hipStream_t* callback_streams, hipCtx_t context,
     const iree_hal_hip_dynamic_symbols_t* symbols,
     const iree_hal_hip_nccl_dynamic_symbols_t* nccl_symbols,
     iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
@@ -154,18 +192,22 @@ static iree_status_t iree_hal_hip_device_create_internal(
   device->params = *params;
   device->hip_context = context;
   device->hip_device = hip_device;
-  device->hip_dispatch_stream = dispatch_stream;
-  device->hip_callback_stream = callback_stream;
+  device->queue_count = queue_count;
+  for (iree_host_size_t i = 0; i < queue_count; ++i) {
+    device->hip_dispatch_streams[i] = dispatch_streams[i];
+    device->hip_callback_streams[i] = callback_streams[i];
+  }
   device->host_allocator = host_allocator;
 
   iree_status_t status = iree_hal_hip_pending_queue_actions_create(
-      symbols, &device->block_pool, host_allocator,
-      &device->pending_queue_actions);
+      symbols, device->params.worker_thread_params, &device->block_pool,
+      host_allocator, &device->pending_queue_actions);
 
-  // Enable tracing for the (currently only) stream - no-op if disabled.
+  // Enable tracing for the first dispatch stream - no-op if disabled.
+  // TODO: trace all queues; each needs its own tracing context.
   if (iree_status_is_ok(status) && device->params.stream_tracing) {
     status = iree_hal_hip_tracing_context_allocate(
-        device->hip_symbols, device->identifier, dispatch_stream,
+        device->hip_symbols, device->identifier, dispatch_streams[0],
         &device->block_pool, host_allocator, &device->tracing_context);
   }
 
@@ -190,9 +232,10 @@ static iree_status_t iree_hal_hip_device_create_internal(
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_hip_allocator_create(
-        symbols, hip_device, dispatch_stream,
+        symbols, hip_device, dispatch_streams[0],
         device->supports_memory_pools ? &device->memory_pools : NULL,
-        host_allocator, &device->device_allocator);
+        params->staging_ring_capacity, host_allocator,
+        &device->device_allocator);
   }
 
   if (iree_status_is_ok(status)) {
@@ -227,28 +270,33 @@ iree_status_t iree_hal_hip_device_create(
     status = IREE_HIP_RESULT_TO_STATUS(symbols, hipCtxSetCurrent(context));
   }
 
-  // Create the default dispatch stream for the device.
-  hipStream_t dispatch_stream = NULL;
-  if (iree_status_is_ok(status)) {
+  // Create the dispatch and callback streams for each queue.
+  const iree_host_size_t queue_count =
+      params->queue_count + (params->dedicated_copy_queues ? 2 : 0);
+  hipStream_t dispatch_streams[IREE_HAL_HIP_MAX_QUEUE_COUNT] = {NULL};
+  hipStream_t callback_streams[IREE_HAL_HIP_MAX_QUEUE_COUNT] = {NULL};
+  for (iree_host_size_t i = 0; i < queue_count && iree_status_is_ok(status);
+       ++i) {
     status = IREE_HIP_RESULT_TO_STATUS(
         symbols,
-        hipStreamCreateWithFlags(&dispatch_stream, hipStreamNonBlocking));
-  }
-  // Create the default callback stream for the device.
-  hipStream_t callback_stream = NULL;
-  if (iree_status_is_ok(status)) {
-    status = IREE_HIP_RESULT_TO_STATUS(
-        symbols,
-        hipStreamCreateWithFlags(&callback_stream, hipStreamNonBlocking));
+        hipStreamCreateWithFlags(&dispatch_streams[i], hipStreamNonBlocking));
+    if (iree_status_is_ok(status)) {
+      status = IREE_HIP_RESULT_TO_STATUS(
+          symbols, hipStreamCreateWithFlags(&callback_streams[i],
+                                            hipStreamNonBlocking));
+    }
   }
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_hip_device_create_internal(
-        driver, identifier, params, device, dispatch_stream, callback_stream,
-        context, symbols, nccl_symbols, host_allocator, out_device);
+        driver, identifier, params, device, queue_count, dispatch_streams,
+        callback_streams, context, symbols, nccl_symbols, host_allocator,
+        out_device);
   } else {
-    if (callback_stream) symbols->hipStreamDestroy(callback_stream);
-    if (dispatch_stream) symbols->hipStreamDestroy(dispatch_stream);
+    for (iree_host_size_t i = 0; i < queue_count; ++i) {
+      if (callback_streams[i]) symbols->hipStreamDestroy(callback_streams[i]);
+      if (dispatch_streams[i]) symbols->hipStreamDestroy(dispatch_streams[i]);
+    }
     // NOTE: This function return hipSuccess though doesn't release the
     // primaryCtx by design on HIP/HCC path.
     if (context) symbols->hipDevicePrimaryCtxRelease(device);
@@ -333,8 +381,12 @@ static void iree_hal_hip_device_destroy(iree_hal_device_t* base_device) {
   }
   if (device->host_event_pool) iree_event_pool_free(device->host_event_pool);
 
-  IREE_HIP_IGNORE_ERROR(symbols, hipStreamDestroy(device->hip_dispatch_stream));
-  IREE_HIP_IGNORE_ERROR(symbols, hipStreamDestroy(device->hip_callback_stream));
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    IREE_HIP_IGNORE_ERROR(symbols,
+                          hipStreamDestroy(device->hip_dispatch_streams[i]));
+    IREE_HIP_IGNORE_ERROR(symbols,
+                          hipStreamDestroy(device->hip_callback_streams[i]));
+  }
 
   // NOTE: This function return hipSuccess though doesn't release the
   // primaryCtx by design on HIP/HCC path.
@@ -425,6 +477,13 @@ static iree_status_t iree_hal_hip_device_query_i64(
     return iree_ok_status();
   }
 
+  if (iree_string_view_equal(category, IREE_SV("hal.device"))) {
+    if (iree_string_view_equal(key, IREE_SV("concurrency"))) {
+      *out_value = (int64_t)device->queue_count;
+      return iree_ok_status();
+    }
+  }
+
   return iree_make_status(
       IREE_STATUS_NOT_FOUND,
       "unknown device configuration key value '%.*s :: %.*s'",
@@ -512,20 +571,25 @@ static iree_status_t iree_hal_hip_device_create_channel(
   // implementation only supports one device we pass in the only one we have.
   return iree_hal_hip_nccl_channel_create(
       device->hip_symbols, device->nccl_symbols, &id, params.rank, params.count,
-      device->host_allocator, out_channel);
+      device->params.channel_init_timeout, device->host_allocator,
+      out_channel);
 }
 
 iree_status_t iree_hal_hip_device_create_stream_command_buffer(
     iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_host_size_t binding_capacity,
+    iree_host_size_t binding_capacity, hipStream_t stream,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
+  // The tracing context is only valid for the stream it was created with.
+  iree_hal_hip_tracing_context_t* tracing_context =
+      stream == device->hip_dispatch_streams[0] ? device->tracing_context
+                                                : NULL;
   return iree_hal_hip_stream_command_buffer_create(
-      base_device, device->hip_symbols, device->nccl_symbols,
-      device->tracing_context, mode, command_categories, binding_capacity,
-      device->hip_dispatch_stream, &device->block_pool, device->host_allocator,
-      out_command_buffer);
+      base_device, device->hip_symbols, device->nccl_symbols, tracing_context,
+      mode, command_categories, binding_capacity, stream,
+      device->params.collective_bucket_size, &device->block_pool,
+      device->host_allocator, out_command_buffer);
 }
 
 static iree_status_t iree_hal_hip_device_create_command_buffer(
@@ -541,11 +605,11 @@ static iree_status_t iree_hal_hip_device_create_command_buffer(
     // recorded, implying that the command buffer cannot be reused and doesn't
     // need to be persisted. This lets us lower the execution delay as we can
     // directly route commands to a HIP stream and let it eagerly flush.
-    return iree_hal_hip_stream_command_buffer_create(
-        base_device, device->hip_symbols, device->nccl_symbols,
-        device->tracing_context, mode, command_categories, binding_capacity,
-        device->hip_dispatch_stream, &device->block_pool,
-        device->host_allocator, out_command_buffer);
+    const iree_host_size_t queue_index =
+        iree_hal_hip_device_select_queue(device, queue_affinity);
+    return iree_hal_hip_device_create_stream_command_buffer(
+        base_device, mode, command_categories, binding_capacity,
+        device->hip_dispatch_streams[queue_index], out_command_buffer);
   }
   switch (device->params.command_buffer_mode) {
     case IREE_HAL_HIP_COMMAND_BUFFER_MODE_GRAPH:
@@ -634,10 +698,11 @@ iree_hal_hip_device_query_semaphore_compatibility(
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
-// TODO: implement proper semaphores in HIP to ensure ordering and avoid
-//       the barrier here.
+// Allocations are made immediately in stream order and the signals are ordered
+// after them through the pending queue actions so that the host never blocks
+// on the waits. The signal is recorded on the stream of the selected queue and
+// other queues waiting on it are ordered after the allocation by the device
+// event backing the signaled timepoint.
 static iree_status_t iree_hal_hip_device_queue_alloca(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -646,72 +711,107 @@ static iree_status_t iree_hal_hip_device_queue_alloca(
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
-
-  // NOTE: block on the semaphores here; we could avoid this by properly
-  // sequencing device work with semaphores. The HIP HAL is not currently
-  // asynchronous.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
 
   // Allocate from the pool; likely to fail in cases of virtual memory
   // exhaustion but the error may be deferred until a later synchronization.
   // If pools are not supported we allocate a buffer as normal from whatever
   // allocator is set on the device.
+  //
+  // Pooled allocations do not depend on the waits: the memory returned is not
+  // in use by anything ordered before it on the stream.
+  const iree_host_size_t queue_index =
+      iree_hal_hip_device_select_queue(device, queue_affinity);
+  hipStream_t dispatch_stream = device->hip_dispatch_streams[queue_index];
+  iree_hal_buffer_t* buffer = NULL;
   iree_status_t status = iree_ok_status();
   if (device->supports_memory_pools &&
       !iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
     status = iree_hal_hip_memory_pools_allocate(
-        &device->memory_pools, device->hip_dispatch_stream, pool, params,
-        allocation_size, out_buffer);
+        &device->memory_pools, dispatch_stream, pool, params, allocation_size,
+        &buffer);
   } else {
     status = iree_hal_allocator_allocate_buffer(
         iree_hal_device_allocator(base_device), params, allocation_size,
-        out_buffer);
+        &buffer);
+  }
+
+  // Signal once the waits have been resolved and the allocation is made on the
+  // device. Only signal if not returning a synchronous error - synchronous
+  // failure indicates that the stream is unchanged.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_hip_pending_queue_actions_enqueue_alloca(
+        base_device, dispatch_stream, device->hip_callback_streams[queue_index],
+        device->pending_queue_actions, wait_semaphore_list,
+        signal_semaphore_list);
+  }
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_hal_hip_pending_queue_actions_issue(device->pending_queue_actions);
   }
 
-  // Only signal if not returning a synchronous error - synchronous failure
-  // indicates that the stream is unchanged (it's not really since we waited
-  // above, but we at least won't deadlock like this).
   if (iree_status_is_ok(status)) {
-    status = iree_hal_semaphore_list_signal(signal_semaphore_list);
+    *out_buffer = buffer;
+  } else {
+    iree_hal_buffer_release(buffer);
   }
+  IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
-// TODO: implement proper semaphores in HIP to ensure ordering and avoid
-//       the barrier here.
+// Deallocations are deferred through the pending queue actions until the waits
+// have been resolved on the device. Buffers we got from a pool are returned to
+// it in stream order and others are dropped on the floor and freed when the
+// buffer is released.
 static iree_status_t iree_hal_hip_device_queue_dealloca(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
   iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
+  IREE_TRACE_ZONE_BEGIN(z0);
 
-  // NOTE: block on the semaphores here; we could avoid this by properly
-  // sequencing device work with semaphores. The HIP HAL is not currently
-  // asynchronous.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
-
-  // Schedule the buffer deallocation if we got it from a pool and otherwise
-  // drop it on the floor and let it be freed when the buffer is released.
-  iree_status_t status = iree_ok_status();
-  if (device->supports_memory_pools) {
-    status = iree_hal_hip_memory_pools_deallocate(
-        &device->memory_pools, device->hip_dispatch_stream, buffer);
-  }
-
-  // Only signal if not returning a synchronous error - synchronous failure
-  // indicates that the stream is unchanged (it's not really since we waited
-  // above, but we at least won't deadlock like this).
+  const iree_host_size_t queue_index =
+      iree_hal_hip_device_select_queue(device, queue_affinity);
+  iree_status_t status = iree_hal_hip_pending_queue_actions_enqueue_dealloca(
+      base_device, device->hip_dispatch_streams[queue_index],
+      device->hip_callback_streams[queue_index], device->pending_queue_actions,
+      device->supports_memory_pools ? &device->memory_pools : NULL,
+      wait_semaphore_list, signal_semaphore_list, buffer);
   if (iree_status_is_ok(status)) {
-    status = iree_hal_semaphore_list_signal(signal_semaphore_list);
+    status =
+        iree_hal_hip_pending_queue_actions_issue(device->pending_queue_actions);
   }
+
+  IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+// Returns options for streaming file transfers issued on the device.
+// When the staging ring is enabled the staging buffers are sized so that two
+// chunks can be double-buffered out of half of the ring, leaving the other
+// half for concurrent transfers.
+//
+// TODO: expose streaming chunk count/size options.
+static iree_hal_file_transfer_options_t
+iree_hal_hip_device_file_transfer_options(iree_hal_hip_device_t* device,
+                                          iree_status_t* loop_status) {
+  iree_hal_file_transfer_options_t options = {
+      .loop = iree_loop_inline(loop_status),
+      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
+      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+  };
+  const iree_device_size_t staging_ring_capacity =
+      device->params.staging_ring_capacity;
+  if (staging_ring_capacity >= 4 * 64) {
+    options.chunk_count = 2;
+    options.chunk_size = (staging_ring_capacity / 4) & ~(iree_device_size_t)63;
+    options.staging_limit = staging_ring_capacity / 2;
+  }
+  return options;
+}
+
 static iree_status_t iree_hal_hip_device_queue_read(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -719,17 +819,17 @@ static iree_status_t iree_hal_hip_device_queue_read(
     iree_hal_file_t* source_file, uint64_t source_offset,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
-  iree_hal_file_transfer_options_t options = {
-      .loop = iree_loop_inline(&loop_status),
-      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
-  };
+  iree_hal_file_transfer_options_t options =
+      iree_hal_hip_device_file_transfer_options(device, &loop_status);
+  const iree_hal_queue_affinity_t transfer_affinity =
+      iree_hal_hip_device_transfer_affinity(device, queue_affinity,
+                                            /*host_to_device=*/true);
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_read_streaming(
-      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
-      source_file, source_offset, target_buffer, target_offset, length, flags,
-      options));
+      base_device, transfer_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_file, source_offset, target_buffer,
+      target_offset, length, flags, options));
   return loop_status;
 }
 
@@ -740,17 +840,17 @@ static iree_status_t iree_hal_hip_device_queue_write(
     iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
     iree_hal_file_t* target_file, uint64_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
-  iree_hal_file_transfer_options_t options = {
-      .loop = iree_loop_inline(&loop_status),
-      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
-  };
+  iree_hal_file_transfer_options_t options =
+      iree_hal_hip_device_file_transfer_options(device, &loop_status);
+  const iree_hal_queue_affinity_t transfer_affinity =
+      iree_hal_hip_device_transfer_affinity(device, queue_affinity,
+                                            /*host_to_device=*/false);
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_write_streaming(
-      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
-      source_buffer, source_offset, target_file, target_offset, length, flags,
-      options));
+      base_device, transfer_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_buffer, source_offset, target_file,
+      target_offset, length, flags, options));
   return loop_status;
 }
 
@@ -764,16 +864,22 @@ static iree_status_t iree_hal_hip_device_queue_execute(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
   iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Cross-queue dependencies are expressed with semaphores; the pending queue
+  // actions resolve waits on device-signaled timepoints with hipEvent_ts
+  // waited on the selected dispatch stream.
+  const iree_host_size_t queue_index =
+      iree_hal_hip_device_select_queue(device, queue_affinity);
   iree_status_t status = iree_hal_hip_pending_queue_actions_enqueue_execution(
-      base_device, device->hip_dispatch_stream, device->hip_callback_stream,
-      device->pending_queue_actions,
+      base_device, device->hip_dispatch_streams[queue_index],
+      device->hip_callback_streams[queue_index], device->pending_queue_actions,
       iree_hal_hip_device_collect_tracing_context, device->tracing_context,
       wait_semaphore_list, signal_semaphore_list, command_buffer_count,
-      command_buffers);
+      command_buffers, binding_tables);
   if (iree_status_is_ok(status)) {
     // Try to advance the pending workload queue.
     status =
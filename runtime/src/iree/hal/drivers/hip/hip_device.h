@@ -28,11 +28,12 @@ iree_status_t iree_hal_hip_device_create(
     iree_allocator_t host_allocator, iree_hal_device_t** out_device);
 
 // Creates a HIP stream-backed command buffer using resources from the
-// given |base_device|.
+// given |base_device| that issues its commands to |stream|. The stream must be
+// one of the dispatch streams owned by the device.
 iree_status_t iree_hal_hip_device_create_stream_command_buffer(
     iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_host_size_t binding_capacity,
+    iree_host_size_t binding_capacity, hipStream_t stream,
     iree_hal_command_buffer_t** out_command_buffer);
 
 // Returns the HIP context bound to the given |device| if it is a HIP device
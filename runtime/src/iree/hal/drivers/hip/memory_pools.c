@@ -123,6 +123,24 @@ static void iree_hal_hip_memory_pool_track_alloc(
                         : &pools->statistics.host_bytes_allocated;
     iree_atomic_fetch_add_int64(bytes_allocated, allocation_size,
                                 iree_memory_order_relaxed);
+    iree_hal_allocation_tag_t tag = iree_hal_buffer_allocation_tag(buffer);
+    if (tag >= IREE_HAL_ALLOCATION_TAG_COUNT) {
+      tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
+    }
+    int64_t bytes_live =
+        iree_atomic_fetch_add_int64(&pools->statistics.tags[tag].bytes_live,
+                                    allocation_size,
+                                    iree_memory_order_relaxed) +
+        allocation_size;
+    int64_t bytes_peak = iree_atomic_load_int64(
+        &pools->statistics.tags[tag].bytes_peak, iree_memory_order_relaxed);
+    while (bytes_peak < bytes_live) {
+      if (iree_atomic_compare_exchange_weak_int64(
+              &pools->statistics.tags[tag].bytes_peak, &bytes_peak, bytes_live,
+              iree_memory_order_relaxed, iree_memory_order_relaxed)) {
+        break;
+      }
+    }
   });
 }
 
@@ -143,6 +161,12 @@ static void iree_hal_hip_memory_pool_track_free(
         iree_hal_buffer_allocation_size(buffer);
     iree_atomic_fetch_add_int64(bytes_freed, allocation_size,
                                 iree_memory_order_relaxed);
+    iree_hal_allocation_tag_t tag = iree_hal_buffer_allocation_tag(buffer);
+    if (tag >= IREE_HAL_ALLOCATION_TAG_COUNT) {
+      tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
+    }
+    iree_atomic_fetch_sub_int64(&pools->statistics.tags[tag].bytes_live,
+                                allocation_size, iree_memory_order_relaxed);
   });
 }
 
@@ -158,6 +182,12 @@ void iree_hal_hip_memory_pools_merge_statistics(
         &pools->statistics.device_bytes_freed, iree_memory_order_relaxed);
     statistics->host_bytes_freed = iree_atomic_load_int64(
         &pools->statistics.host_bytes_freed, iree_memory_order_relaxed);
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(statistics->tags); ++i) {
+      statistics->tags[i].bytes_live += iree_atomic_load_int64(
+          &pools->statistics.tags[i].bytes_live, iree_memory_order_relaxed);
+      statistics->tags[i].bytes_peak += iree_atomic_load_int64(
+          &pools->statistics.tags[i].bytes_peak, iree_memory_order_relaxed);
+    }
 
     if (pools->device_local) {
       uint64_t pool_peak = 0;
@@ -255,6 +285,7 @@ iree_status_t iree_hal_hip_memory_pools_allocate(
 
   if (iree_status_is_ok(status)) {
     // Update statistics (note that it may not yet be accurate).
+    buffer->allocation_tag = params.tag;
     iree_hal_hip_memory_pool_track_alloc(pools, buffer);
     *out_buffer = buffer;
   } else if (buffer) {
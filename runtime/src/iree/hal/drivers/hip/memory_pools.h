@@ -40,6 +40,11 @@ typedef struct iree_hal_hip_memory_pools_t {
     iree_atomic_int64_t device_bytes_freed;
     iree_atomic_int64_t host_bytes_allocated;
     iree_atomic_int64_t host_bytes_freed;
+    // Live and peak bytes per iree_hal_allocation_tag_t.
+    struct {
+      iree_atomic_int64_t bytes_live;
+      iree_atomic_int64_t bytes_peak;
+    } tags[IREE_HAL_ALLOCATION_TAG_COUNT];
   } statistics;)
 } iree_hal_hip_memory_pools_t;
 
@@ -7,8 +7,10 @@
 #include "iree/hal/drivers/hip/native_executable.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/hal/drivers/hip/api.h"
 #include "iree/hal/drivers/hip/dynamic_symbols.h"
 #include "iree/hal/drivers/hip/status_util.h"
 
@@ -118,6 +120,70 @@ static iree_status_t iree_hal_hip_native_executable_flatbuffer_verify(
   return iree_ok_status();
 }
 
+// Precomputes the kernel parameter layout of |info| from its pipeline layout.
+static iree_status_t iree_hal_hip_kernel_info_initialize_params(
+    iree_hal_hip_kernel_info_t* info) {
+  iree_hal_hip_dispatch_layout_t dispatch_layout =
+      iree_hal_hip_pipeline_layout_dispatch_layout(info->layout);
+  if (dispatch_layout.set_layout_count >
+      IREE_HAL_HIP_MAX_DESCRIPTOR_SET_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "descriptor set count %" PRIhsz
+                            " over the limit of %d",
+                            dispatch_layout.set_layout_count,
+                            IREE_HAL_HIP_MAX_DESCRIPTOR_SET_COUNT);
+  }
+  info->set_count = (uint32_t)dispatch_layout.set_layout_count;
+  for (uint32_t i = 0; i < info->set_count; ++i) {
+    const iree_host_size_t binding_count =
+        iree_hal_hip_descriptor_set_layout_binding_count(
+            iree_hal_hip_pipeline_layout_descriptor_set_layout(info->layout,
+                                                               i));
+    if (binding_count > IREE_HAL_HIP_MAX_DESCRIPTOR_SET_BINDING_COUNT) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "descriptor set %u binding count %" PRIhsz " over the limit of %d", i,
+          binding_count, IREE_HAL_HIP_MAX_DESCRIPTOR_SET_BINDING_COUNT);
+    }
+    info->sets[i].base_index =
+        (uint16_t)iree_hal_hip_pipeline_layout_base_binding_index(info->layout,
+                                                                  i);
+    info->sets[i].binding_count = (uint16_t)binding_count;
+  }
+  info->push_constant_index =
+      (uint32_t)dispatch_layout.push_constant_base_index;
+  info->push_constant_count = (uint32_t)dispatch_layout.push_constant_count;
+  info->param_count = info->push_constant_index + info->push_constant_count;
+  return iree_ok_status();
+}
+
+// Records the occupancy of the kernel in |info| on the device.
+//
+// Unlike NVIDIA devices the LDS on AMD devices is not shared with the L1 cache
+// so there is no carveout to tune and the occupancy is only reported.
+static iree_status_t iree_hal_hip_kernel_info_query_occupancy(
+    const iree_hal_hip_dynamic_symbols_t* symbols,
+    iree_hal_hip_kernel_info_t* info) {
+  const int threads_per_block =
+      (int)(info->block_size[0] * info->block_size[1] * info->block_size[2]);
+  int static_shared_memory_size = 0;
+  IREE_RETURN_IF_ERROR(IREE_HIP_RESULT_TO_STATUS(
+      symbols,
+      hipFuncGetAttribute(&static_shared_memory_size,
+                          HIP_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES, info->function),
+      "hipFuncGetAttribute"));
+  int max_active_blocks = 0;
+  IREE_RETURN_IF_ERROR(IREE_HIP_RESULT_TO_STATUS(
+      symbols,
+      hipModuleOccupancyMaxActiveBlocksPerMultiprocessor(
+          &max_active_blocks, info->function, threads_per_block,
+          info->shared_memory_size),
+      "hipModuleOccupancyMaxActiveBlocksPerMultiprocessor"));
+  info->static_shared_memory_size = (uint32_t)static_shared_memory_size;
+  info->max_active_blocks_per_multiprocessor = (uint32_t)max_active_blocks;
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_hip_native_executable_create(
     const iree_hal_hip_dynamic_symbols_t* symbols, hipDevice_t device,
     const iree_hal_executable_params_t* executable_params,
@@ -251,6 +317,10 @@ iree_status_t iree_hal_hip_native_executable_create(
       kernel_info->block_size[1] = block_sizes_vec[i].y;
       kernel_info->block_size[2] = block_sizes_vec[i].z;
       kernel_info->shared_memory_size = shared_memory_sizes_vec[i];
+      status = iree_hal_hip_kernel_info_initialize_params(kernel_info);
+      if (!iree_status_is_ok(status)) break;
+      status = iree_hal_hip_kernel_info_query_occupancy(symbols, kernel_info);
+      if (!iree_status_is_ok(status)) break;
 
       // Stash the entry point name in the string table for use when tracing.
       IREE_TRACE({
@@ -310,7 +380,7 @@ static void iree_hal_hip_native_executable_destroy(
 
 iree_status_t iree_hal_hip_native_executable_entry_point_kernel_info(
     iree_hal_executable_t* base_executable, int32_t entry_point,
-    iree_hal_hip_kernel_info_t* out_info) {
+    const iree_hal_hip_kernel_info_t** out_info) {
   iree_hal_hip_native_executable_t* executable =
       iree_hal_hip_native_executable_cast(base_executable);
   if (entry_point >= executable->entry_point_count) {
@@ -319,7 +389,7 @@ iree_status_t iree_hal_hip_native_executable_entry_point_kernel_info(
                             "only contains %" PRIhsz " entry points",
                             entry_point, executable->entry_point_count);
   }
-  memcpy(out_info, &executable->entry_points[entry_point], sizeof(*out_info));
+  *out_info = &executable->entry_points[entry_point];
   return iree_ok_status();
 }
 
@@ -327,3 +397,26 @@ static const iree_hal_executable_vtable_t
     iree_hal_hip_native_executable_vtable = {
         .destroy = iree_hal_hip_native_executable_destroy,
 };
+
+IREE_API_EXPORT iree_status_t iree_hal_hip_executable_query_export_occupancy(
+    iree_hal_executable_t* base_executable, uint32_t export_ordinal,
+    iree_hal_hip_export_occupancy_t* out_occupancy) {
+  IREE_ASSERT_ARGUMENT(base_executable);
+  IREE_ASSERT_ARGUMENT(out_occupancy);
+  memset(out_occupancy, 0, sizeof(*out_occupancy));
+  if (!iree_hal_resource_is(base_executable,
+                            &iree_hal_hip_native_executable_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "executable is not a HIP executable");
+  }
+  const iree_hal_hip_kernel_info_t* info = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_hip_native_executable_entry_point_kernel_info(
+      base_executable, (int32_t)export_ordinal, &info));
+  out_occupancy->max_active_blocks_per_multiprocessor =
+      info->max_active_blocks_per_multiprocessor;
+  out_occupancy->threads_per_block =
+      info->block_size[0] * info->block_size[1] * info->block_size[2];
+  out_occupancy->shared_memory_per_block =
+      info->static_shared_memory_size + info->shared_memory_size;
+  return iree_ok_status();
+}
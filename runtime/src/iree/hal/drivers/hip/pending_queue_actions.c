@@ -21,6 +21,7 @@
 #include "iree/hal/drivers/hip/event_semaphore.h"
 #include "iree/hal/drivers/hip/graph_command_buffer.h"
 #include "iree/hal/drivers/hip/hip_device.h"
+#include "iree/hal/drivers/hip/memory_pools.h"
 #include "iree/hal/drivers/hip/status_util.h"
 #include "iree/hal/drivers/hip/stream_command_buffer.h"
 #include "iree/hal/drivers/utils/semaphore.h"
@@ -36,7 +37,8 @@
 
 typedef enum iree_hal_hip_queue_action_kind_e {
   IREE_HAL_HIP_QUEUE_ACTION_TYPE_EXECUTION,
-  // TODO: Add support for queue alloca and dealloca.
+  IREE_HAL_HIP_QUEUE_ACTION_TYPE_ALLOCA,
+  IREE_HAL_HIP_QUEUE_ACTION_TYPE_DEALLOCA,
 } iree_hal_hip_queue_action_kind_t;
 
 typedef enum iree_hal_hip_queue_action_state_e {
@@ -46,16 +48,31 @@ typedef enum iree_hal_hip_queue_action_state_e {
   IREE_HAL_HIP_QUEUE_ACTION_STATE_ZOMBIE,
 } iree_hal_hip_queue_action_state_t;
 
+// Ready action atomic slist entry struct.
+typedef struct iree_hal_hip_atomic_slist_entry_t {
+  struct iree_hal_hip_queue_action_t* ready_list_head;
+  iree_atomic_slist_intrusive_ptr_t slist_next;
+} iree_hal_hip_atomic_slist_entry_t;
+
 // A pending queue action.
 //
 // Note that this struct does not have internal synchronization; it's expected
 // to work together with the pending action queue, which synchronizes accesses.
 typedef struct iree_hal_hip_queue_action_t {
+  // Arena the action and all of its variable-length storage are allocated
+  // from. Backed by the shared block pool so that steady-state submission
+  // reuses blocks instead of hitting the host allocator.
+  iree_arena_allocator_t arena;
+
   // Intrusive doubly-linked list next entry pointer.
   struct iree_hal_hip_queue_action_t* next;
   // Intrusive doubly-linked list previous entry pointer.
   struct iree_hal_hip_queue_action_t* prev;
 
+  // Entry used to hand a batch of ready actions headed by this action to the
+  // worker. Only valid while this action is the head of a ready batch.
+  iree_hal_hip_atomic_slist_entry_t ready_entry;
+
   // The owning pending actions queue. We use its allocators and pools.
   // Retained to make sure it outlives the current action.
   iree_hal_hip_pending_queue_actions_t* owning_actions;
@@ -76,7 +93,16 @@ typedef struct iree_hal_hip_queue_action_t {
     struct {
       iree_host_size_t count;
       iree_hal_command_buffer_t** ptr;
+      // Binding tables for each command buffer or NULL if none were provided.
+      // Stored in the same allocation as |ptr|.
+      iree_hal_buffer_binding_table_t* binding_tables;
     } command_buffers;
+    struct {
+      // Pools the buffer is returned to or NULL if not pooled.
+      iree_hal_hip_memory_pools_t* memory_pools;
+      // Retained by |resource_set|.
+      iree_hal_buffer_t* buffer;
+    } dealloca;
   } payload;
 
   // The device from which to allocate HIP stream-based command buffers for
@@ -185,45 +211,34 @@ static void iree_hal_hip_queue_action_list_destroy(
 // Ready-list processing
 //===----------------------------------------------------------------------===//
 
-// Ready action atomic slist entry struct.
-typedef struct iree_hal_hip_atomic_slist_entry_t {
-  iree_hal_hip_queue_action_t* ready_list_head;
-  iree_atomic_slist_intrusive_ptr_t slist_next;
-} iree_hal_hip_atomic_slist_entry_t;
-
 // Ready action atomic slist.
 IREE_TYPED_ATOMIC_SLIST_WRAPPER(iree_hal_hip_ready_action,
                                 iree_hal_hip_atomic_slist_entry_t,
                                 offsetof(iree_hal_hip_atomic_slist_entry_t,
                                          slist_next));
 
+// Pushes the batch of ready actions starting at |head_action| to |list| using
+// the entry embedded in the head action.
+static void iree_hal_hip_ready_action_slist_push_batch(
+    iree_hal_hip_ready_action_slist_t* list,
+    iree_hal_hip_queue_action_t* head_action) {
+  IREE_ASSERT(!head_action->prev);
+  head_action->ready_entry.ready_list_head = head_action;
+  iree_hal_hip_ready_action_slist_push(list, &head_action->ready_entry);
+}
+
 static void iree_hal_hip_ready_action_slist_destroy(
-    iree_hal_hip_ready_action_slist_t* list, iree_allocator_t host_allocator) {
+    iree_hal_hip_ready_action_slist_t* list) {
   while (true) {
     iree_hal_hip_atomic_slist_entry_t* entry =
         iree_hal_hip_ready_action_slist_pop(list);
     if (!entry) break;
+    // The entry is stored in the head action and freed along with it.
     iree_hal_hip_queue_action_list_destroy(entry->ready_list_head);
-    iree_allocator_free(host_allocator, entry);
   }
   iree_hal_hip_ready_action_slist_deinitialize(list);
 }
 
-static iree_hal_hip_queue_action_t* iree_hal_hip_atomic_slist_entry_pop_front(
-    iree_hal_hip_atomic_slist_entry_t* list) {
-  IREE_ASSERT(list->ready_list_head);
-
-  iree_hal_hip_queue_action_t* action = list->ready_list_head;
-  IREE_ASSERT(!action->prev);
-  list->ready_list_head = action->next;
-  if (action->next) {
-    action->next->prev = NULL;
-    action->next = NULL;
-  }
-
-  return action;
-}
-
 // The ready-list processing worker's working/exiting state.
 //
 // States in the list has increasing priorities--meaning normally ones appearing
@@ -270,12 +285,9 @@ typedef struct iree_hal_hip_working_area_t {
   iree_notification_t pending_work_items_count_notification;
   int32_t pending_work_items_count
       IREE_GUARDED_BY(pending_work_items_count_mutex);
-
-  iree_allocator_t host_allocator;  // const
 } iree_hal_hip_working_area_t;
 
 static void iree_hal_hip_working_area_initialize(
-    iree_allocator_t host_allocator,
     iree_hal_hip_working_area_t* working_area) {
   iree_notification_initialize(&working_area->state_notification);
   iree_notification_initialize(&working_area->exit_notification);
@@ -289,13 +301,11 @@ static void iree_hal_hip_working_area_initialize(
   iree_notification_initialize(
       &working_area->pending_work_items_count_notification);
   working_area->pending_work_items_count = 0;
-  working_area->host_allocator = host_allocator;
 }
 
 static void iree_hal_hip_working_area_deinitialize(
     iree_hal_hip_working_area_t* working_area) {
-  iree_hal_hip_ready_action_slist_destroy(&working_area->ready_worklist,
-                                          working_area->host_allocator);
+  iree_hal_hip_ready_action_slist_destroy(&working_area->ready_worklist);
   iree_notification_deinitialize(&working_area->exit_notification);
   iree_notification_deinitialize(&working_area->state_notification);
   iree_slim_mutex_deinitialize(&working_area->pending_work_items_count_mutex);
@@ -318,7 +328,7 @@ struct iree_hal_hip_pending_queue_actions_t {
 
   // The allocator used to create the timepoint pool.
   iree_allocator_t host_allocator;
-  // The block pool to allocate resource sets from.
+  // The block pool to allocate actions and their resource sets from.
   iree_arena_block_pool_t* block_pool;
 
   // The symbols used to create and destroy hipEvent_t objects.
@@ -342,6 +352,7 @@ static const iree_hal_resource_vtable_t
 
 iree_status_t iree_hal_hip_pending_queue_actions_create(
     const iree_hal_hip_dynamic_symbols_t* symbols,
+    iree_thread_create_params_t worker_params,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_hip_pending_queue_actions_t** out_actions) {
   IREE_ASSERT_ARGUMENT(symbols);
@@ -363,12 +374,13 @@ iree_status_t iree_hal_hip_pending_queue_actions_create(
 
   // Initialize the working area for the ready-list processing worker.
   iree_hal_hip_working_area_t* working_area = &actions->working_area;
-  iree_hal_hip_working_area_initialize(host_allocator, working_area);
+  iree_hal_hip_working_area_initialize(working_area);
 
   // Create the ready-list processing worker itself.
-  iree_thread_create_params_t params;
-  memset(&params, 0, sizeof(params));
-  params.name = IREE_SV("deferque_worker");
+  iree_thread_create_params_t params = worker_params;
+  if (iree_string_view_is_empty(params.name)) {
+    params.name = IREE_SV("deferque_worker");
+  }
   params.create_suspended = false;
   iree_status_t status = iree_thread_create(
       (iree_thread_entry_t)iree_hal_hip_worker_execute, working_area, params,
@@ -381,7 +393,7 @@ iree_status_t iree_hal_hip_pending_queue_actions_create(
   }
 
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static iree_hal_hip_pending_queue_actions_t*
@@ -433,62 +445,83 @@ static const iree_hal_resource_vtable_t
 };
 
 // Copies of the given |in_list| to |out_list| to retain the command buffer
-// list.
+// list. If provided the |in_binding_tables| and their bindings are copied into
+// the same allocation and returned in |out_binding_tables|.
 static iree_status_t iree_hal_hip_copy_command_buffer_list(
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* in_list, iree_allocator_t host_allocator,
-    iree_hal_command_buffer_t*** out_list) {
+    iree_hal_command_buffer_t* const* in_list,
+    const iree_hal_buffer_binding_table_t* in_binding_tables,
+    iree_arena_allocator_t* arena, iree_hal_command_buffer_t*** out_list,
+    iree_hal_buffer_binding_table_t** out_binding_tables) {
   *out_list = NULL;
+  *out_binding_tables = NULL;
   if (!command_buffer_count) return iree_ok_status();
 
-  iree_host_size_t total_size = command_buffer_count * sizeof(*in_list);
+  iree_host_size_t list_size = command_buffer_count * sizeof(*in_list);
+  iree_host_size_t total_size = list_size;
+  if (in_binding_tables) {
+    total_size += command_buffer_count * sizeof(*in_binding_tables);
+    for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+      total_size +=
+          in_binding_tables[i].count * sizeof(iree_hal_buffer_binding_t);
+    }
+  }
+  uint8_t* storage = NULL;
   IREE_RETURN_IF_ERROR(
-      iree_allocator_malloc(host_allocator, total_size, (void**)out_list));
-  memcpy((void*)*out_list, in_list, total_size);
+      iree_arena_allocate(arena, total_size, (void**)&storage));
+  memcpy(storage, in_list, list_size);
+  *out_list = (iree_hal_command_buffer_t**)storage;
+  if (in_binding_tables) {
+    iree_hal_buffer_binding_table_t* binding_tables =
+        (iree_hal_buffer_binding_table_t*)(storage + list_size);
+    iree_hal_buffer_binding_t* bindings =
+        (iree_hal_buffer_binding_t*)(binding_tables + command_buffer_count);
+    for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+      binding_tables[i].count = in_binding_tables[i].count;
+      binding_tables[i].bindings = bindings;
+      memcpy(bindings, in_binding_tables[i].bindings,
+             in_binding_tables[i].count * sizeof(*bindings));
+      bindings += in_binding_tables[i].count;
+    }
+    *out_binding_tables = binding_tables;
+  }
   return iree_ok_status();
 }
 
-// Frees the semaphore and value list inside |semaphore_list|.
-static void iree_hal_hip_free_command_buffer_list(
-    iree_allocator_t host_allocator,
-    iree_hal_command_buffer_t* const* command_buffer_list) {
-  iree_allocator_free(host_allocator, (void*)command_buffer_list);
-}
-
 // Copies of the given |in_list| to |out_list| to retain the semaphore and value
 // list.
 static iree_status_t iree_hal_hip_copy_semaphore_list(
-    iree_hal_semaphore_list_t in_list, iree_allocator_t host_allocator,
+    iree_hal_semaphore_list_t in_list, iree_arena_allocator_t* arena,
     iree_hal_semaphore_list_t* out_list) {
   memset(out_list, 0, sizeof(*out_list));
   if (!in_list.count) return iree_ok_status();
 
   out_list->count = in_list.count;
   iree_host_size_t semaphore_size = in_list.count * sizeof(*in_list.semaphores);
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, semaphore_size,
-                                             (void**)&out_list->semaphores));
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(arena, semaphore_size,
+                                           (void**)&out_list->semaphores));
   memcpy(out_list->semaphores, in_list.semaphores, semaphore_size);
 
   iree_host_size_t value_size = in_list.count * sizeof(*in_list.payload_values);
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      host_allocator, value_size, (void**)&out_list->payload_values));
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(arena, value_size,
+                                           (void**)&out_list->payload_values));
   memcpy(out_list->payload_values, in_list.payload_values, value_size);
   return iree_ok_status();
 }
 
-// Frees the semaphore and value list inside |semaphore_list|.
-static void iree_hal_hip_free_semaphore_list(
-    iree_allocator_t host_allocator,
-    iree_hal_semaphore_list_t* semaphore_list) {
-  iree_allocator_free(host_allocator, semaphore_list->semaphores);
-  iree_allocator_free(host_allocator, semaphore_list->payload_values);
+// Frees |action| and its arena storage. The action must not be referenced by
+// any list.
+static void iree_hal_hip_queue_action_free(
+    iree_hal_hip_queue_action_t* action) {
+  // The arena is stored within the action itself; copy it out before freeing.
+  iree_arena_allocator_t arena = action->arena;
+  iree_arena_deinitialize(&arena);
 }
 
 static void iree_hal_hip_queue_action_destroy(
     iree_hal_hip_queue_action_t* action) {
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_hal_hip_pending_queue_actions_t* actions = action->owning_actions;
-  iree_allocator_t host_allocator = actions->host_allocator;
 
   // Call user provided callback before releasing any resource.
   if (action->cleanup_callback) {
@@ -497,16 +530,12 @@ static void iree_hal_hip_queue_action_destroy(
 
   // Only release resources after callbacks have been issued.
   iree_hal_resource_set_free(action->resource_set);
-  iree_hal_hip_free_semaphore_list(host_allocator,
-                                   &action->wait_semaphore_list);
-  iree_hal_hip_free_semaphore_list(host_allocator,
-                                   &action->signal_semaphore_list);
 
   iree_hal_hip_queue_action_clear_events(action);
 
-  iree_hal_resource_release(actions);
+  iree_hal_hip_queue_action_free(action);
 
-  iree_allocator_free(host_allocator, action);
+  iree_hal_resource_release(actions);
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -524,98 +553,197 @@ static void decrement_work_items_count(
   iree_slim_mutex_unlock(&working_area->pending_work_items_count_mutex);
 }
 
-iree_status_t iree_hal_hip_pending_queue_actions_enqueue_execution(
-    iree_hal_device_t* device, hipStream_t dispatch_stream,
-    hipStream_t callback_stream, iree_hal_hip_pending_queue_actions_t* actions,
-    iree_hal_hip_pending_action_cleanup_callback_t cleanup_callback,
-    void* callback_user_data,
+// Allocates a new action of the given |kind| from the shared block pool that
+// retains and copies the wait and signal semaphore lists. The action is not
+// enqueued and must either be passed to
+// iree_hal_hip_pending_queue_actions_enqueue or freed with
+// iree_hal_hip_queue_action_fail.
+static iree_status_t iree_hal_hip_queue_action_allocate(
+    iree_hal_hip_pending_queue_actions_t* actions,
+    iree_hal_hip_queue_action_kind_t kind, iree_hal_device_t* device,
+    hipStream_t dispatch_stream, hipStream_t callback_stream,
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
-    iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
-  IREE_ASSERT_ARGUMENT(actions);
-  IREE_ASSERT_ARGUMENT(command_buffer_count == 0 || command_buffers);
-  IREE_TRACE_ZONE_BEGIN(z0);
+    iree_hal_hip_queue_action_t** out_action) {
+  *out_action = NULL;
 
+  iree_arena_allocator_t arena;
+  iree_arena_initialize(actions->block_pool, &arena);
   iree_hal_hip_queue_action_t* action = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(actions->host_allocator, sizeof(*action),
-                                (void**)&action));
+  iree_status_t status =
+      iree_arena_allocate(&arena, sizeof(*action), (void**)&action);
+  if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+    iree_arena_deinitialize(&arena);
+    return status;
+  }
+  memset(action, 0, sizeof(*action));
+  memcpy(&action->arena, &arena, sizeof(action->arena));
 
   action->owning_actions = actions;
   action->state = IREE_HAL_HIP_QUEUE_ACTION_STATE_ALIVE;
-  action->cleanup_callback = cleanup_callback;
-  action->callback_user_data = callback_user_data;
-  action->kind = IREE_HAL_HIP_QUEUE_ACTION_TYPE_EXECUTION;
+  action->kind = kind;
   action->device = device;
   action->dispatch_hip_stream = dispatch_stream;
   action->callback_hip_stream = callback_stream;
-
-  // Initialize scratch fields.
-  action->event_count = 0;
   action->is_pending = true;
 
-  // Retain all command buffers and semaphores.
-  iree_hal_resource_set_t* resource_set = NULL;
-  iree_status_t status =
-      iree_hal_resource_set_allocate(actions->block_pool, &resource_set);
+  // Retain all semaphores.
+  status = iree_hal_resource_set_allocate(actions->block_pool,
+                                          &action->resource_set);
   if (IREE_LIKELY(iree_status_is_ok(status))) {
-    status = iree_hal_resource_set_insert(resource_set, command_buffer_count,
-                                          command_buffers);
+    status = iree_hal_resource_set_insert(action->resource_set,
+                                          wait_semaphore_list.count,
+                                          wait_semaphore_list.semaphores);
   }
   if (IREE_LIKELY(iree_status_is_ok(status))) {
-    status =
-        iree_hal_resource_set_insert(resource_set, wait_semaphore_list.count,
-                                     wait_semaphore_list.semaphores);
+    status = iree_hal_resource_set_insert(action->resource_set,
+                                          signal_semaphore_list.count,
+                                          signal_semaphore_list.semaphores);
   }
+
+  // Copy the semaphore and value list for later access.
   if (IREE_LIKELY(iree_status_is_ok(status))) {
-    status =
-        iree_hal_resource_set_insert(resource_set, signal_semaphore_list.count,
-                                     signal_semaphore_list.semaphores);
+    status = iree_hal_hip_copy_semaphore_list(
+        wait_semaphore_list, &action->arena, &action->wait_semaphore_list);
   }
   if (IREE_LIKELY(iree_status_is_ok(status))) {
-    action->resource_set = resource_set;
+    status = iree_hal_hip_copy_semaphore_list(
+        signal_semaphore_list, &action->arena, &action->signal_semaphore_list);
+  }
+
+  if (IREE_LIKELY(iree_status_is_ok(status))) {
+    *out_action = action;
+  } else {
+    iree_hal_resource_set_free(action->resource_set);
+    iree_hal_hip_queue_action_free(action);
+  }
+  return status;
+}
+
+// Frees an |action| that failed to initialize and was never enqueued.
+static void iree_hal_hip_queue_action_fail(
+    iree_hal_hip_queue_action_t* action) {
+  iree_hal_resource_set_free(action->resource_set);
+  iree_hal_hip_queue_action_free(action);
+}
+
+// Enqueues a fully initialized |action| to wait for its dependencies.
+static void iree_hal_hip_pending_queue_actions_enqueue(
+    iree_hal_hip_pending_queue_actions_t* actions,
+    iree_hal_hip_queue_action_t* action) {
+  // Retain the owning queue to make sure the action outlives it.
+  iree_hal_resource_retain(actions);
+
+  iree_slim_mutex_lock(&actions->action_mutex);
+  iree_hal_hip_queue_action_list_push_back(&actions->action_list, action);
+  iree_slim_mutex_unlock(&actions->action_mutex);
+}
+
+iree_status_t iree_hal_hip_pending_queue_actions_enqueue_execution(
+    iree_hal_device_t* device, hipStream_t dispatch_stream,
+    hipStream_t callback_stream, iree_hal_hip_pending_queue_actions_t* actions,
+    iree_hal_hip_pending_action_cleanup_callback_t cleanup_callback,
+    void* callback_user_data,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
+  IREE_ASSERT_ARGUMENT(actions);
+  IREE_ASSERT_ARGUMENT(command_buffer_count == 0 || command_buffers);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_hip_queue_action_t* action = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_hip_queue_action_allocate(
+              actions, IREE_HAL_HIP_QUEUE_ACTION_TYPE_EXECUTION, device,
+              dispatch_stream, callback_stream, wait_semaphore_list,
+              signal_semaphore_list, &action));
+  action->cleanup_callback = cleanup_callback;
+  action->callback_user_data = callback_user_data;
+
+  // Retain all command buffers and the buffers in their binding tables.
+  iree_status_t status = iree_hal_resource_set_insert(
+      action->resource_set, command_buffer_count, command_buffers);
+  if (binding_tables) {
+    for (iree_host_size_t i = 0;
+         i < command_buffer_count && iree_status_is_ok(status); ++i) {
+      for (iree_host_size_t j = 0;
+           j < binding_tables[i].count && iree_status_is_ok(status); ++j) {
+        const iree_hal_buffer_binding_t* binding =
+            &binding_tables[i].bindings[j];
+        if (!binding->buffer) continue;
+        status = iree_hal_resource_set_insert(action->resource_set, 1,
+                                              &binding->buffer);
+      }
+    }
   }
 
   // Copy the command buffer list for later access.
-  // TODO: avoid host allocator malloc; use some pool for the allocation.
   if (IREE_LIKELY(iree_status_is_ok(status))) {
     action->payload.command_buffers.count = command_buffer_count;
     status = iree_hal_hip_copy_command_buffer_list(
-        command_buffer_count, command_buffers, actions->host_allocator,
-        &action->payload.command_buffers.ptr);
+        command_buffer_count, command_buffers, binding_tables, &action->arena,
+        &action->payload.command_buffers.ptr,
+        &action->payload.command_buffers.binding_tables);
   }
 
-  // Copy the semaphore and value list for later access.
-  // TODO: avoid host allocator malloc; use some pool for the allocation.
   if (IREE_LIKELY(iree_status_is_ok(status))) {
-    status = iree_hal_hip_copy_semaphore_list(wait_semaphore_list,
-                                              actions->host_allocator,
-                                              &action->wait_semaphore_list);
-  }
-  if (IREE_LIKELY(iree_status_is_ok(status))) {
-    status = iree_hal_hip_copy_semaphore_list(signal_semaphore_list,
-                                              actions->host_allocator,
-                                              &action->signal_semaphore_list);
+    iree_hal_hip_pending_queue_actions_enqueue(actions, action);
+  } else {
+    iree_hal_hip_queue_action_fail(action);
   }
 
-  if (IREE_LIKELY(iree_status_is_ok(status))) {
-    // Retain the owning queue to make sure the action outlives it.
-    iree_hal_resource_retain(actions);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
 
-    // Now everything is okay and we can enqueue the action.
-    iree_slim_mutex_lock(&actions->action_mutex);
-    iree_hal_hip_queue_action_list_push_back(&actions->action_list, action);
-    iree_slim_mutex_unlock(&actions->action_mutex);
+iree_status_t iree_hal_hip_pending_queue_actions_enqueue_alloca(
+    iree_hal_device_t* device, hipStream_t dispatch_stream,
+    hipStream_t callback_stream, iree_hal_hip_pending_queue_actions_t* actions,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list) {
+  IREE_ASSERT_ARGUMENT(actions);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_hip_queue_action_t* action = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_hip_queue_action_allocate(
+              actions, IREE_HAL_HIP_QUEUE_ACTION_TYPE_ALLOCA, device,
+              dispatch_stream, callback_stream, wait_semaphore_list,
+              signal_semaphore_list, &action));
+  iree_hal_hip_pending_queue_actions_enqueue(actions, action);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_hip_pending_queue_actions_enqueue_dealloca(
+    iree_hal_device_t* device, hipStream_t dispatch_stream,
+    hipStream_t callback_stream, iree_hal_hip_pending_queue_actions_t* actions,
+    iree_hal_hip_memory_pools_t* memory_pools,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer) {
+  IREE_ASSERT_ARGUMENT(actions);
+  IREE_ASSERT_ARGUMENT(buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_hip_queue_action_t* action = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_hip_queue_action_allocate(
+              actions, IREE_HAL_HIP_QUEUE_ACTION_TYPE_DEALLOCA, device,
+              dispatch_stream, callback_stream, wait_semaphore_list,
+              signal_semaphore_list, &action));
+  action->payload.dealloca.memory_pools = memory_pools;
+  action->payload.dealloca.buffer = buffer;
+
+  iree_status_t status =
+      iree_hal_resource_set_insert(action->resource_set, 1, &buffer);
+  if (IREE_LIKELY(iree_status_is_ok(status))) {
+    iree_hal_hip_pending_queue_actions_enqueue(actions, action);
   } else {
-    iree_hal_hip_free_semaphore_list(actions->host_allocator,
-                                     &action->wait_semaphore_list);
-    iree_hal_hip_free_semaphore_list(actions->host_allocator,
-                                     &action->signal_semaphore_list);
-    iree_hal_hip_free_command_buffer_list(actions->host_allocator,
-                                          action->payload.command_buffers.ptr);
-    iree_hal_resource_set_free(resource_set);
-    iree_allocator_free(actions->host_allocator, action);
+    iree_hal_hip_queue_action_fail(action);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -649,7 +777,6 @@ static void iree_hal_hip_execution_device_signal_host_callback(
     void* user_data) {
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_hal_hip_queue_action_t* action = (iree_hal_hip_queue_action_t*)user_data;
-  IREE_ASSERT_EQ(action->kind, IREE_HAL_HIP_QUEUE_ACTION_TYPE_EXECUTION);
   IREE_ASSERT_EQ(action->state, IREE_HAL_HIP_QUEUE_ACTION_STATE_ALIVE);
   iree_hal_hip_pending_queue_actions_t* actions = action->owning_actions;
 
@@ -689,42 +816,32 @@ static void iree_hal_hip_execution_device_signal_host_callback(
   IREE_TRACE_ZONE_END(z0);
 }
 
-// Issues the given kernel dispatch |action| to the GPU.
-static iree_status_t iree_hal_hip_pending_queue_actions_issue_execution(
+// Issues the command buffers of the given kernel dispatch |action| to the GPU.
+static iree_status_t iree_hal_hip_queue_action_issue_command_buffers(
     iree_hal_hip_queue_action_t* action) {
-  IREE_ASSERT_EQ(action->kind, IREE_HAL_HIP_QUEUE_ACTION_TYPE_EXECUTION);
-  IREE_ASSERT_EQ(action->is_pending, false);
   const iree_hal_hip_dynamic_symbols_t* symbols =
       action->owning_actions->symbols;
   IREE_TRACE_ZONE_BEGIN(z0);
-
-  // No need to lock given that this action is already detched from the pending
-  // actions list; so only this thread is seeing it now.
-
-  // First wait all the device hipEvent_t in the dispatch stream.
-  for (iree_host_size_t i = 0; i < action->event_count; ++i) {
-    IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, symbols,
-        hipStreamWaitEvent(action->dispatch_hip_stream,
-                           iree_hal_hip_event_handle(action->events[i]),
-                           /*flags=*/0),
-        "hipStreamWaitEvent");
-  }
-
-  // Then launch all command buffers to the dispatch stream.
-  IREE_TRACE_ZONE_BEGIN(dispatch_command_buffers);
-  IREE_TRACE_ZONE_APPEND_TEXT(dispatch_command_buffers,
-                              " dispatch_command_buffers",
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, " dispatch_command_buffers",
                               strlen(" dispatch_command_buffers"));
   for (iree_host_size_t i = 0; i < action->payload.command_buffers.count; ++i) {
     iree_hal_command_buffer_t* command_buffer =
         action->payload.command_buffers.ptr[i];
+    iree_hal_buffer_binding_table_t binding_table =
+        action->payload.command_buffers.binding_tables
+            ? action->payload.command_buffers.binding_tables[i]
+            : iree_hal_buffer_binding_table_empty();
     if (iree_hal_hip_stream_command_buffer_isa(command_buffer)) {
       // Nothing to do for an inline command buffer; all the work has already
       // been submitted. When we support semaphores we'll still need to signal
       // their completion but do not have to worry about any waits: if there
       // were waits we wouldn't have been able to execute inline!
     } else if (iree_hal_hip_graph_command_buffer_isa(command_buffer)) {
+      // Resolve indirect bindings prior to the launch; this only updates the
+      // kernel parameters of the instantiated graph.
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_hal_hip_graph_command_buffer_update_bindings(
+                  command_buffer, binding_table));
       hipGraphExec_t exec = iree_hal_hip_graph_command_buffer_handle(
           action->payload.command_buffers.ptr[i]);
       IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
@@ -739,17 +856,61 @@ static iree_status_t iree_hal_hip_pending_queue_actions_issue_execution(
       IREE_RETURN_AND_END_ZONE_IF_ERROR(
           z0, iree_hal_hip_device_create_stream_command_buffer(
                   action->device, mode, IREE_HAL_COMMAND_CATEGORY_ANY,
-                  /*binding_capacity=*/0, &stream_command_buffer));
+                  /*binding_capacity=*/0, action->dispatch_hip_stream,
+                  &stream_command_buffer));
       IREE_RETURN_AND_END_ZONE_IF_ERROR(
           z0, iree_hal_resource_set_insert(action->resource_set, 1,
                                            &stream_command_buffer));
       IREE_RETURN_AND_END_ZONE_IF_ERROR(
           z0, iree_hal_deferred_command_buffer_apply(
-                  command_buffer, stream_command_buffer,
-                  iree_hal_buffer_binding_table_empty()));
+                  command_buffer, stream_command_buffer, binding_table));
     }
   }
-  IREE_TRACE_ZONE_END(dispatch_command_buffers);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Issues the given |action| to the GPU.
+static iree_status_t iree_hal_hip_pending_queue_actions_issue_action(
+    iree_hal_hip_queue_action_t* action) {
+  IREE_ASSERT_EQ(action->is_pending, false);
+  const iree_hal_hip_dynamic_symbols_t* symbols =
+      action->owning_actions->symbols;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // No need to lock given that this action is already detched from the pending
+  // actions list; so only this thread is seeing it now.
+
+  // First wait all the device hipEvent_t in the dispatch stream.
+  for (iree_host_size_t i = 0; i < action->event_count; ++i) {
+    IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, symbols,
+        hipStreamWaitEvent(action->dispatch_hip_stream,
+                           iree_hal_hip_event_handle(action->events[i]),
+                           /*flags=*/0),
+        "hipStreamWaitEvent");
+  }
+
+  // Then issue the payload to the dispatch stream.
+  switch (action->kind) {
+    case IREE_HAL_HIP_QUEUE_ACTION_TYPE_EXECUTION:
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_hal_hip_queue_action_issue_command_buffers(action));
+      break;
+    case IREE_HAL_HIP_QUEUE_ACTION_TYPE_ALLOCA:
+      // The allocation was made in stream order when enqueued; only the
+      // signals below need to be ordered after it.
+      break;
+    case IREE_HAL_HIP_QUEUE_ACTION_TYPE_DEALLOCA:
+      if (action->payload.dealloca.memory_pools) {
+        IREE_RETURN_AND_END_ZONE_IF_ERROR(
+            z0, iree_hal_hip_memory_pools_deallocate(
+                    action->payload.dealloca.memory_pools,
+                    action->dispatch_hip_stream,
+                    action->payload.dealloca.buffer));
+      }
+      break;
+  }
 
   // Last record hipEvent_t signals in the dispatch stream.
   for (iree_host_size_t i = 0; i < action->signal_semaphore_list.count; ++i) {
@@ -909,39 +1070,36 @@ iree_status_t iree_hal_hip_pending_queue_actions_issue(
     return status;
   }
 
-  iree_hal_hip_atomic_slist_entry_t* entry = NULL;
-  // TODO: avoid host allocator malloc; use some pool for the allocation.
-  if (iree_status_is_ok(status)) {
-    status = iree_allocator_malloc(actions->host_allocator, sizeof(*entry),
-                                   (void**)&entry);
-  }
-
   if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
     // Release all actions in the ready list to avoid leaking.
     iree_hal_hip_queue_action_list_destroy(ready_list.head);
-    iree_allocator_free(actions->host_allocator, entry);
     IREE_TRACE_ZONE_END(z0);
     return status;
   }
 
   // Now push the ready list to the worker and have it to issue the actions to
-  // the GPU.
-  entry->ready_list_head = ready_list.head;
-  iree_hal_hip_ready_action_slist_push(&actions->working_area.ready_worklist,
-                                       entry);
+  // the GPU. The list entry is stored in the head action so no allocation is
+  // required.
+  iree_hal_hip_ready_action_slist_push_batch(
+      &actions->working_area.ready_worklist, ready_list.head);
 
   // We can only overwrite the worker state if the previous state is idle
   // waiting; we cannot overwrite exit related states. so we need to perform
   // atomic compare and exchange here.
+  //
+  // Only wake the worker on the idle to pending transition: if workload is
+  // already pending the worker has not yet started on it and will pick up this
+  // batch along with all others pushed before it flips back to idle.
   iree_hal_hip_worker_state_t prev_state =
       IREE_HAL_HIP_WORKER_STATE_IDLE_WAITING;
-  iree_atomic_compare_exchange_strong_int32(
-      &actions->working_area.worker_state, /*expected=*/&prev_state,
-      /*desired=*/IREE_HAL_HIP_WORKER_STATE_WORKLOAD_PENDING,
-      /*order_succ=*/iree_memory_order_acq_rel,
-      /*order_fail=*/iree_memory_order_acquire);
-  iree_notification_post(&actions->working_area.state_notification,
-                         IREE_ALL_WAITERS);
+  if (iree_atomic_compare_exchange_strong_int32(
+          &actions->working_area.worker_state, /*expected=*/&prev_state,
+          /*desired=*/IREE_HAL_HIP_WORKER_STATE_WORKLOAD_PENDING,
+          /*order_succ=*/iree_memory_order_acq_rel,
+          /*order_fail=*/iree_memory_order_acquire)) {
+    iree_notification_post(&actions->working_area.state_notification,
+                           IREE_ALL_WAITERS);
+  }
 
   // Handle potential error cases from the worker thread.
   if (prev_state == IREE_HAL_HIP_WORKER_STATE_EXIT_ERROR) {
@@ -976,24 +1134,26 @@ static bool iree_hal_hip_worker_committed_exiting(
 
 // Processes all ready actions in the given |worklist|.
 static iree_status_t iree_hal_hip_worker_process_ready_list(
-    iree_allocator_t host_allocator,
     iree_hal_hip_ready_action_slist_t* worklist) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_status_t status = iree_ok_status();
-  while (true) {
+  while (iree_status_is_ok(status)) {
     iree_hal_hip_atomic_slist_entry_t* entry =
         iree_hal_hip_ready_action_slist_pop(worklist);
     if (!entry) break;
 
-    // Process the current batch of ready actions.
-    while (entry->ready_list_head) {
-      iree_hal_hip_queue_action_t* action =
-          iree_hal_hip_atomic_slist_entry_pop_front(entry);
+    // Process the current batch of ready actions. The entry is stored in the
+    // head action and must not be touched once that has been processed.
+    iree_hal_hip_queue_action_t* action = entry->ready_list_head;
+    while (action) {
+      iree_hal_hip_queue_action_t* next_action = action->next;
+      action->next = NULL;
+      if (next_action) next_action->prev = NULL;
 
       switch (action->state) {
         case IREE_HAL_HIP_QUEUE_ACTION_STATE_ALIVE:
-          status = iree_hal_hip_pending_queue_actions_issue_execution(action);
+          status = iree_hal_hip_pending_queue_actions_issue_action(action);
           if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
             iree_hal_hip_queue_action_destroy(action);
           }
@@ -1002,18 +1162,18 @@ static iree_status_t iree_hal_hip_worker_process_ready_list(
           iree_hal_hip_pending_queue_actions_issue_cleanup(action);
           break;
       }
-      if (IREE_UNLIKELY(!iree_status_is_ok(status))) break;
-    }
 
-    if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
-      // Let common destruction path take care of destroying the worklist.
-      // When we know all host stream callbacks are done and not touching
-      // anything.
-      iree_hal_hip_ready_action_slist_push(worklist, entry);
-      break;
+      if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+        // Let common destruction path take care of destroying the remaining
+        // actions when we know all host stream callbacks are done and not
+        // touching anything.
+        if (next_action) {
+          iree_hal_hip_ready_action_slist_push_batch(worklist, next_action);
+        }
+        break;
+      }
+      action = next_action;
     }
-
-    iree_allocator_free(host_allocator, entry);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -1085,8 +1245,7 @@ static int iree_hal_hip_worker_execute(
         (worker_state == IREE_HAL_HIP_WORKER_STATE_EXIT_REQUESTED);
 
     // Process the ready list. We also want this even requested to exit.
-    iree_status_t status = iree_hal_hip_worker_process_ready_list(
-        working_area->host_allocator, worklist);
+    iree_status_t status = iree_hal_hip_worker_process_ready_list(worklist);
     if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
       iree_hal_hip_worker_wait_pending_work_items(working_area);
       iree_hal_hip_post_error_to_worker_state(working_area,
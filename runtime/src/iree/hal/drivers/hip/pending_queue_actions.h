@@ -9,8 +9,10 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/arena.h"
+#include "iree/base/internal/threading.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/hip/dynamic_symbols.h"
+#include "iree/hal/drivers/hip/memory_pools.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,8 +39,10 @@ typedef struct iree_hal_hip_pending_queue_actions_t
     iree_hal_hip_pending_queue_actions_t;
 
 // Creates a pending actions queue.
+// The worker thread issuing ready actions is created with |worker_params|.
 iree_status_t iree_hal_hip_pending_queue_actions_create(
     const iree_hal_hip_dynamic_symbols_t* symbols,
+    iree_thread_create_params_t worker_params,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_hip_pending_queue_actions_t** out_actions);
 
@@ -54,6 +58,8 @@ typedef void(IREE_API_PTR* iree_hal_hip_pending_action_cleanup_callback_t)(
 
 // Enqueues the given list of |command_buffers| that waits on
 // |wait_semaphore_list| and signals |signal_semaphore_lsit|.
+// |binding_tables|, if not NULL, provides a binding table for each command
+// buffer used to resolve its indirect bindings at issue time.
 //
 // |cleanup_callback|, if not NULL, will run after the action completes but
 // before releasing all retained resources.
@@ -65,7 +71,32 @@ iree_status_t iree_hal_hip_pending_queue_actions_enqueue_execution(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers);
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables);
+
+// Enqueues an allocation that waits on |wait_semaphore_list| and signals
+// |signal_semaphore_list|. The allocation itself must already have been made
+// in stream order on |dispatch_stream|; the action only orders the signals
+// after it and after all waits have been resolved on the device.
+iree_status_t iree_hal_hip_pending_queue_actions_enqueue_alloca(
+    iree_hal_device_t* device, hipStream_t dispatch_stream,
+    hipStream_t callback_stream, iree_hal_hip_pending_queue_actions_t* actions,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list);
+
+// Enqueues a deallocation of |buffer| that waits on |wait_semaphore_list| and
+// signals |signal_semaphore_list|. The buffer is retained until the action
+// completes and returned to |memory_pools| in stream order on
+// |dispatch_stream| once all waits have been resolved. |memory_pools| may be
+// NULL if the device does not support them in which case the buffer is only
+// released.
+iree_status_t iree_hal_hip_pending_queue_actions_enqueue_dealloca(
+    iree_hal_device_t* device, hipStream_t dispatch_stream,
+    hipStream_t callback_stream, iree_hal_hip_pending_queue_actions_t* actions,
+    iree_hal_hip_memory_pools_t* memory_pools,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer);
 
 // Tries to scan the pending actions and release ready ones to the GPU.
 iree_status_t iree_hal_hip_pending_queue_actions_issue(
@@ -12,6 +12,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/threading.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/drivers/hip/api.h"
@@ -41,6 +42,35 @@ IREE_FLAG(
     "Severely impacts benchmark timings and should only be used when\n"
     "analyzing dispatch timings.");
 
+IREE_FLAG(int32_t, hip_collective_bucket_size, 4 * 1024 * 1024,
+          "Maximum total size in bytes of small all-reduces fused into one\n"
+          "collective over a packed staging buffer. 0 disables fusion.");
+
+IREE_FLAG(int32_t, hip_channel_init_timeout_ms, 0,
+          "Maximum time in milliseconds to wait for all participants to join\n"
+          "when creating a collective channel. 0 waits indefinitely.");
+
+IREE_FLAG(int32_t, hip_staging_ring_capacity, 32 * 1024 * 1024,
+          "Size in bytes of the persistent page-locked host staging ring used\n"
+          "for host/device transfers. 0 allocates staging memory per\n"
+          "transfer.");
+
+IREE_FLAG(int32_t, hip_queue_count, 1,
+          "Number of dispatch queues exposed by each device, each backed by\n"
+          "its own HIP stream.");
+
+IREE_FLAG(bool, hip_dedicated_copy_queues, false,
+          "Exposes dedicated host-to-device and device-to-host copy queues\n"
+          "used for file transfers so they overlap with dispatches.");
+
+IREE_FLAG(string, hip_worker_thread_affinity, "any",
+          "Logical processor ID the worker thread issuing queue actions of\n"
+          "each device is pinned to (optionally suffixed with `+smt`) or\n"
+          "`any` to let the system place it.");
+IREE_FLAG(string, hip_worker_thread_priority, "normal",
+          "Priority class of the worker thread issuing queue actions of each\n"
+          "device from [`lowest`, `low`, `normal`, `high`, `highest`].");
+
 IREE_FLAG(int32_t, hip_default_index, 0,
           "Specifies the index of the default HIP device to use");
 
@@ -73,6 +103,20 @@ static const iree_string_view_t key_hip_async_allocations =
     iree_string_view_literal("hip_async_allocations");
 static const iree_string_view_t key_hip_tracing =
     iree_string_view_literal("hip_tracing");
+static const iree_string_view_t key_hip_collective_bucket_size =
+    iree_string_view_literal("hip_collective_bucket_size");
+static const iree_string_view_t key_hip_channel_init_timeout_ms =
+    iree_string_view_literal("hip_channel_init_timeout_ms");
+static const iree_string_view_t key_hip_staging_ring_capacity =
+    iree_string_view_literal("hip_staging_ring_capacity");
+static const iree_string_view_t key_hip_queue_count =
+    iree_string_view_literal("hip_queue_count");
+static const iree_string_view_t key_hip_dedicated_copy_queues =
+    iree_string_view_literal("hip_dedicated_copy_queues");
+static const iree_string_view_t key_hip_worker_thread_affinity =
+    iree_string_view_literal("hip_worker_thread_affinity");
+static const iree_string_view_t key_hip_worker_thread_priority =
+    iree_string_view_literal("hip_worker_thread_priority");
 static const iree_string_view_t key_hip_default_index =
     iree_string_view_literal("hip_default_index");
 
@@ -98,6 +142,28 @@ static iree_status_t iree_hal_hip_driver_parse_flags(
       builder, key_hip_async_allocations, FLAG_hip_async_allocations));
   IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
       builder, key_hip_tracing, FLAG_hip_tracing));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
+      builder, key_hip_collective_bucket_size,
+      FLAG_hip_collective_bucket_size));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
+      builder, key_hip_channel_init_timeout_ms,
+      FLAG_hip_channel_init_timeout_ms));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
+      builder, key_hip_staging_ring_capacity, FLAG_hip_staging_ring_capacity));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
+      builder, key_hip_queue_count, FLAG_hip_queue_count));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
+      builder, key_hip_dedicated_copy_queues, FLAG_hip_dedicated_copy_queues));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add(
+      builder,
+      iree_make_string_pair(key_hip_worker_thread_affinity,
+                            iree_make_cstring_view(
+                                FLAG_hip_worker_thread_affinity))));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add(
+      builder,
+      iree_make_string_pair(key_hip_worker_thread_priority,
+                            iree_make_cstring_view(
+                                FLAG_hip_worker_thread_priority))));
   IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
       builder, key_hip_default_index, FLAG_hip_default_index));
 
@@ -183,6 +249,58 @@ static iree_status_t iree_hal_hip_driver_populate_options(
             (int)value.size, value.data);
       }
       device_params->stream_tracing = ivalue ? true : false;
+    } else if (iree_string_view_equal(key, key_hip_collective_bucket_size)) {
+      if (!iree_string_view_atoi_int32(value, &ivalue) || ivalue < 0) {
+        return iree_make_status(
+            IREE_STATUS_FAILED_PRECONDITION,
+            "Option 'hip_collective_bucket_size' expected to be a "
+            "non-negative int. Got: '%.*s'",
+            (int)value.size, value.data);
+      }
+      device_params->collective_bucket_size = (iree_device_size_t)ivalue;
+    } else if (iree_string_view_equal(key, key_hip_channel_init_timeout_ms)) {
+      if (!iree_string_view_atoi_int32(value, &ivalue) || ivalue < 0) {
+        return iree_make_status(
+            IREE_STATUS_FAILED_PRECONDITION,
+            "Option 'hip_channel_init_timeout_ms' expected to be a "
+            "non-negative int. Got: '%.*s'",
+            (int)value.size, value.data);
+      }
+      device_params->channel_init_timeout =
+          ivalue > 0 ? ivalue * 1000000ll : IREE_DURATION_INFINITE;
+    } else if (iree_string_view_equal(key, key_hip_staging_ring_capacity)) {
+      if (!iree_string_view_atoi_int32(value, &ivalue) || ivalue < 0) {
+        return iree_make_status(
+            IREE_STATUS_FAILED_PRECONDITION,
+            "Option 'hip_staging_ring_capacity' expected to be a "
+            "non-negative int. Got: '%.*s'",
+            (int)value.size, value.data);
+      }
+      device_params->staging_ring_capacity = (iree_device_size_t)ivalue;
+    } else if (iree_string_view_equal(key, key_hip_queue_count)) {
+      if (!iree_string_view_atoi_int32(value, &ivalue) || ivalue <= 0) {
+        return iree_make_status(
+            IREE_STATUS_FAILED_PRECONDITION,
+            "Option 'hip_queue_count' expected to be a positive int. "
+            "Got: '%.*s'",
+            (int)value.size, value.data);
+      }
+      device_params->queue_count = (iree_host_size_t)ivalue;
+    } else if (iree_string_view_equal(key, key_hip_dedicated_copy_queues)) {
+      if (!iree_string_view_atoi_int32(value, &ivalue)) {
+        return iree_make_status(
+            IREE_STATUS_FAILED_PRECONDITION,
+            "Option 'hip_dedicated_copy_queues' expected to be int. "
+            "Got: '%.*s'",
+            (int)value.size, value.data);
+      }
+      device_params->dedicated_copy_queues = ivalue ? true : false;
+    } else if (iree_string_view_equal(key, key_hip_worker_thread_affinity)) {
+      IREE_RETURN_IF_ERROR(iree_thread_affinity_parse(
+          value, &device_params->worker_thread_params.initial_affinity));
+    } else if (iree_string_view_equal(key, key_hip_worker_thread_priority)) {
+      IREE_RETURN_IF_ERROR(iree_thread_priority_class_parse(
+          value, &device_params->worker_thread_params.priority_class));
     } else if (iree_string_view_equal(key, key_hip_default_index)) {
       if (!iree_string_view_atoi_int32(value, &ivalue)) {
         return iree_make_status(
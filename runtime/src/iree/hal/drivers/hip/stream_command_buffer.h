@@ -29,6 +29,9 @@ extern "C" {
 // replaying the scratch data required for things like buffer updates is
 // retained by the source deferred command buffer and as such the |block_pool|
 // and can be NULL to avoid a double copy.
+//
+// Small all-reduces recorded between barriers are fused into buckets of up to
+// |collective_bucket_size| bytes when non-zero.
 iree_status_t iree_hal_hip_stream_command_buffer_create(
     iree_hal_device_t* device,
     const iree_hal_hip_dynamic_symbols_t* hip_symbols,
@@ -37,6 +40,7 @@ iree_status_t iree_hal_hip_stream_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_host_size_t binding_capacity, hipStream_t stream,
+    iree_device_size_t collective_bucket_size,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
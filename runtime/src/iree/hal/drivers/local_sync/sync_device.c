@@ -14,8 +14,10 @@
 #include "iree/base/internal/cpu.h"
 #include "iree/hal/drivers/local_sync/sync_event.h"
 #include "iree/hal/drivers/local_sync/sync_semaphore.h"
+#include "iree/hal/local/dispatch_statistics.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/inline_command_buffer.h"
+#include "iree/hal/local/prepared_command_buffer.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
@@ -36,11 +38,22 @@ typedef struct iree_hal_sync_device_t {
   // buffers can contain inlined data uploads).
   iree_arena_block_pool_t large_block_pool;
 
+  // Streaming file transfer options from the device parameters. The loop is
+  // ignored and provided per-operation.
+  iree_hal_file_transfer_options_t file_transfer_options;
+
   // Shared semaphore state used to emulate OS-level primitives. This backend
   // is intended to run on bare-metal systems where we need to perform all
   // synchronization ourselves.
   iree_hal_sync_semaphore_state_t semaphore_state;
 
+  // True while profiling with IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS
+  // or IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS and contributing to
+  // the process-wide local dispatch statistics.
+  bool capturing_dispatch_statistics;
+  // Flags the capture was started with.
+  iree_hal_local_dispatch_statistics_flags_t dispatch_statistics_flags;
+
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_sync_device_t;
@@ -101,6 +114,11 @@ iree_status_t iree_hal_sync_device_create(
     iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
                                      &device->large_block_pool);
 
+    device->file_transfer_options.chunk_count = params->file_transfer.chunk_count;
+    device->file_transfer_options.chunk_size = params->file_transfer.chunk_size;
+    device->file_transfer_options.staging_limit =
+        params->file_transfer.staging_limit;
+
     device->loader_count = loader_count;
     for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
       device->loaders[i] = loaders[i];
@@ -124,6 +142,11 @@ static void iree_hal_sync_device_destroy(iree_hal_device_t* base_device) {
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Balance any capture left running by a profiling session never ended.
+  if (device->capturing_dispatch_statistics) {
+    iree_hal_local_dispatch_statistics_end(device->dispatch_statistics_flags);
+  }
+
   iree_hal_sync_semaphore_state_deinitialize(&device->semaphore_state);
 
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
@@ -237,8 +260,16 @@ static iree_status_t iree_hal_sync_device_create_command_buffer(
     return iree_hal_inline_command_buffer_create(
         base_device, mode, command_categories, queue_affinity, binding_capacity,
         iree_hal_device_host_allocator(base_device), out_command_buffer);
+  }
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT) &&
+      binding_capacity == 0) {
+    // Reusable command buffers are prepared once during recording so that
+    // each submission only needs to issue the executable calls.
+    return iree_hal_prepared_command_buffer_create(
+        base_device, mode, command_categories, queue_affinity, binding_capacity,
+        &device->large_block_pool, device->host_allocator, out_command_buffer);
   } else {
-    iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
     return iree_hal_deferred_command_buffer_create(
         base_device, mode, command_categories, binding_capacity,
         &device->large_block_pool, device->host_allocator, out_command_buffer);
@@ -341,14 +372,26 @@ static iree_status_t iree_hal_sync_device_queue_dealloca(
 
 static iree_status_t iree_hal_sync_device_apply_deferred_command_buffers(
     iree_hal_sync_device_t* device, iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
-  // See if there are any deferred command buffers; this saves us work in cases
-  // of pure inline execution.
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
+  // Prepared command buffers were compiled into a flat list of calls when
+  // recorded and just run in order. Deferred command buffers need to be
+  // replayed through an inline command buffer and we only set one up if any
+  // are present; this saves us work in cases of pure inline or prepared
+  // execution.
   bool any_deferred = false;
   for (iree_host_size_t i = 0; i < command_buffer_count && !any_deferred; ++i) {
     any_deferred = iree_hal_deferred_command_buffer_isa(command_buffers[i]);
   }
-  if (!any_deferred) return iree_ok_status();
+  if (!any_deferred) {
+    for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+      if (iree_hal_prepared_command_buffer_isa(command_buffers[i])) {
+        IREE_RETURN_IF_ERROR(
+            iree_hal_prepared_command_buffer_execute(command_buffers[i]));
+      }
+    }
+    return iree_ok_status();
+  }
 
   // Stack allocate storage for an inline command buffer we'll use to replay
   // the deferred command buffers. We want to reset it between each apply so
@@ -362,7 +405,10 @@ static iree_status_t iree_hal_sync_device_apply_deferred_command_buffers(
   // if they mixed the two modes together!
   for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
     iree_hal_command_buffer_t* command_buffer = command_buffers[i];
-    if (iree_hal_deferred_command_buffer_isa(command_buffer)) {
+    if (iree_hal_prepared_command_buffer_isa(command_buffer)) {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_prepared_command_buffer_execute(command_buffer));
+    } else if (iree_hal_deferred_command_buffer_isa(command_buffer)) {
       iree_hal_command_buffer_t* inline_command_buffer = NULL;
       IREE_RETURN_IF_ERROR(iree_hal_inline_command_buffer_initialize(
           (iree_hal_device_t*)device,
@@ -373,7 +419,8 @@ static iree_status_t iree_hal_sync_device_apply_deferred_command_buffers(
           &inline_command_buffer));
       iree_status_t status = iree_hal_deferred_command_buffer_apply(
           command_buffer, inline_command_buffer,
-          iree_hal_buffer_binding_table_empty());
+          binding_tables ? binding_tables[i]
+                         : iree_hal_buffer_binding_table_empty());
       iree_hal_inline_command_buffer_deinitialize(inline_command_buffer);
       IREE_RETURN_IF_ERROR(status);
     }
@@ -389,12 +436,13 @@ static iree_status_t iree_hal_sync_device_queue_read(
     iree_hal_file_t* source_file, uint64_t source_offset,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
       .loop = iree_loop_inline(&loop_status),
-      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+      .chunk_count = device->file_transfer_options.chunk_count,
+      .chunk_size = device->file_transfer_options.chunk_size,
+      .staging_limit = device->file_transfer_options.staging_limit,
   };
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_read_streaming(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
@@ -410,12 +458,13 @@ static iree_status_t iree_hal_sync_device_queue_write(
     iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
     iree_hal_file_t* target_file, uint64_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
       .loop = iree_loop_inline(&loop_status),
-      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+      .chunk_count = device->file_transfer_options.chunk_count,
+      .chunk_size = device->file_transfer_options.chunk_size,
+      .staging_limit = device->file_transfer_options.staging_limit,
   };
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_write_streaming(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
@@ -429,7 +478,8 @@ static iree_status_t iree_hal_sync_device_queue_execute(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
 
   // TODO(#4680): there is some better error handling here needed; we should
@@ -445,7 +495,7 @@ static iree_status_t iree_hal_sync_device_queue_execute(
   // Run all deferred command buffers - any we could have run inline we already
   // did during recording.
   IREE_RETURN_IF_ERROR(iree_hal_sync_device_apply_deferred_command_buffers(
-      device, command_buffer_count, command_buffers));
+      device, command_buffer_count, command_buffers, binding_tables));
 
   // Signal all semaphores now that batch work has completed.
   IREE_RETURN_IF_ERROR(iree_hal_sync_semaphore_multi_signal(
@@ -471,14 +521,25 @@ static iree_status_t iree_hal_sync_device_wait_semaphores(
 static iree_status_t iree_hal_sync_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  // Executable counters additionally sample the hardware performance counters
+  // of the workers around each call.
+  iree_hal_local_dispatch_statistics_flags_t flags =
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE;
+  if (iree_all_bits_set(options->mode,
+                        IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS)) {
+    flags |= IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_HARDWARE_COUNTERS;
+  }
+  if (iree_any_bit_set(
+          options->mode,
+          IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS |
+              IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS) &&
+      !device->capturing_dispatch_statistics) {
+    iree_hal_local_dispatch_statistics_begin(flags);
+    device->capturing_dispatch_statistics = true;
+    device->dispatch_statistics_flags = flags;
+  }
+  // Other modes are unimplemented (and that's ok).
   return iree_ok_status();
 }
 
@@ -490,7 +551,11 @@ static iree_status_t iree_hal_sync_device_profiling_flush(
 
 static iree_status_t iree_hal_sync_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  if (device->capturing_dispatch_statistics) {
+    iree_hal_local_dispatch_statistics_end(device->dispatch_statistics_flags);
+    device->capturing_dispatch_statistics = false;
+  }
   return iree_ok_status();
 }
 
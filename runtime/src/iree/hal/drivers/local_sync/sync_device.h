@@ -22,6 +22,18 @@ typedef struct iree_hal_sync_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+  // Streaming file transfer options used when files cannot be mapped directly
+  // into device memory. A 0 value selects a default based on the transfer.
+  struct {
+    // Number of staging chunks each handled by a transfer worker. Queue
+    // operations complete inline on this device so workers do not overlap
+    // and counts >1 only add staging memory.
+    iree_device_size_t chunk_count;
+    // Size of each staging chunk in bytes.
+    iree_device_size_t chunk_size;
+    // Maximum total size of the staging memory in bytes.
+    iree_device_size_t staging_limit;
+  } file_transfer;
 } iree_hal_sync_device_params_t;
 
 // Initializes |out_params| to default values.
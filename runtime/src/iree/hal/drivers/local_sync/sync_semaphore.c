@@ -81,6 +81,7 @@ iree_status_t iree_hal_sync_semaphore_create(
 
     iree_slim_mutex_initialize(&semaphore->mutex);
     semaphore->current_value = initial_value;
+    iree_hal_semaphore_publish_value(&semaphore->base, initial_value);
     semaphore->failure_status = iree_ok_status();
 
     *out_semaphore = &semaphore->base;
@@ -111,6 +112,15 @@ static iree_status_t iree_hal_sync_semaphore_query(
   iree_hal_sync_semaphore_t* semaphore =
       iree_hal_sync_semaphore_cast(base_semaphore);
 
+  // Fast path: the published value is updated under the mutex along with
+  // |current_value| and only failures need the lock to clone the status.
+  const uint64_t published_value =
+      iree_hal_semaphore_load_published_value(base_semaphore);
+  if (IREE_LIKELY(published_value < IREE_HAL_SEMAPHORE_FAILURE_VALUE)) {
+    *out_value = published_value;
+    return iree_ok_status();
+  }
+
   iree_slim_mutex_lock(&semaphore->mutex);
 
   *out_value = semaphore->current_value;
@@ -140,6 +150,7 @@ static iree_status_t iree_hal_sync_semaphore_signal_unsafe(
 
   // Update to the new value.
   semaphore->current_value = new_value;
+  iree_hal_semaphore_publish_value(&semaphore->base, new_value);
 
   return iree_ok_status();
 }
@@ -192,6 +203,8 @@ static void iree_hal_sync_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
   // Signal to our failure sentinel value.
   semaphore->current_value = IREE_HAL_SEMAPHORE_FAILURE_VALUE;
   semaphore->failure_status = status;
+  iree_hal_semaphore_publish_value(&semaphore->base,
+                                   IREE_HAL_SEMAPHORE_FAILURE_VALUE);
 
   iree_slim_mutex_unlock(&semaphore->mutex);
 
@@ -266,10 +279,18 @@ static iree_status_t iree_hal_sync_semaphore_wait(
   iree_hal_sync_semaphore_t* semaphore =
       iree_hal_sync_semaphore_cast(base_semaphore);
 
+  // Fastest path: already satisfied without taking any locks.
+  const uint64_t published_value =
+      iree_hal_semaphore_load_published_value(base_semaphore);
+  if (published_value >= value &&
+      published_value < IREE_HAL_SEMAPHORE_FAILURE_VALUE) {
+    return iree_ok_status();
+  }
+
   // Try to see if we can return immediately.
   iree_slim_mutex_lock(&semaphore->mutex);
   if (!iree_status_is_ok(semaphore->failure_status)) {
-    // Fastest path: failed; return an error to tell callers to query for it.
+    // Fast path: failed; return an error to tell callers to query for it.
     iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_status_from_code(IREE_STATUS_ABORTED);
   } else if (semaphore->current_value >= value) {
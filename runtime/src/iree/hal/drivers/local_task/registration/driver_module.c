@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/drivers/local_task/task_driver.h"
 #include "iree/hal/local/loaders/registration/init.h"
 #include "iree/hal/local/plugins/registration/init.h"
@@ -20,6 +21,39 @@ IREE_FLAG(
     bool, task_abort_on_failure, false,
     "Aborts the program on the first failure within a task system queue.");
 
+IREE_FLAG(
+    int64_t, task_high_priority_queues, 0,
+    "Bitmask of device queues whose work is preferred by the task system\n"
+    "over that of other queues sharing the same executor. Intended for\n"
+    "latency-sensitive work sharing an executor with batch work.");
+
+IREE_FLAG(
+    int64_t, task_file_transfer_chunk_count, 0,
+    "Number of staging chunks used when streaming files that cannot be\n"
+    "mapped into device memory. 0 selects a default.");
+IREE_FLAG(
+    int64_t, task_file_transfer_chunk_size, 0,
+    "Size in bytes of each staging chunk used when streaming files that\n"
+    "cannot be mapped into device memory. 0 selects a default.");
+IREE_FLAG(
+    int64_t, task_file_transfer_staging_limit, 0,
+    "Maximum total size in bytes of the staging memory used when streaming\n"
+    "files that cannot be mapped into device memory. The chunk count is\n"
+    "reduced to fit though at least one chunk is always used. 0 is no limit.");
+
+IREE_FLAG(
+    string, task_huge_pages, "none",
+    "Backs the storage of large device buffers with huge pages to reduce TLB\n"
+    "misses in kernels streaming through weights and activations:\n"
+    "  'none': huge pages are not used.\n"
+    "  'transparent': 2MB-aligned mappings advised with MADV_HUGEPAGE.\n"
+    "  '2mb'/'1gb': explicit MAP_HUGETLB pages from the reserved pool,\n"
+    "               falling back to transparent huge pages when exhausted.");
+IREE_FLAG(
+    int64_t, task_huge_page_min_size, 0,
+    "Minimum size in bytes of buffers backed by huge pages when\n"
+    "--task_huge_pages is set. 0 selects the huge page size.");
+
 static iree_status_t iree_hal_local_task_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
     const iree_hal_driver_info_t** out_driver_infos) {
@@ -49,6 +83,33 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
   if (FLAG_task_abort_on_failure) {
     default_params.queue_scope_flags |= IREE_TASK_SCOPE_FLAG_ABORT_ON_FAILURE;
   }
+  default_params.high_priority_queues =
+      (iree_hal_queue_affinity_t)FLAG_task_high_priority_queues;
+  if (FLAG_task_file_transfer_chunk_count < 0 ||
+      FLAG_task_file_transfer_chunk_size < 0 ||
+      FLAG_task_file_transfer_staging_limit < 0) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "file transfer chunk count/size and staging limit must be >= 0");
+  }
+  default_params.file_transfer.chunk_count =
+      (iree_device_size_t)FLAG_task_file_transfer_chunk_count;
+  default_params.file_transfer.chunk_size =
+      (iree_device_size_t)FLAG_task_file_transfer_chunk_size;
+  default_params.file_transfer.staging_limit =
+      (iree_device_size_t)FLAG_task_file_transfer_staging_limit;
+
+  iree_hal_heap_allocator_params_t heap_params;
+  iree_hal_heap_allocator_params_initialize(&heap_params);
+  IREE_RETURN_IF_ERROR(iree_memory_huge_page_mode_parse(
+      iree_make_cstring_view(FLAG_task_huge_pages),
+      &heap_params.huge_page_mode));
+  if (FLAG_task_huge_page_min_size < 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "huge page minimum size must be >= 0");
+  }
+  heap_params.huge_page_min_size =
+      (iree_device_size_t)FLAG_task_huge_page_min_size;
 
   // Create executors for each topology specified by flags.
   // Stack allocated storage today but we can query for the total count and
@@ -76,9 +137,9 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
   // TODO(benvanik): allow this to be injected to share across drivers.
   iree_hal_allocator_t* device_allocator = NULL;
   if (iree_status_is_ok(status)) {
-    status = iree_hal_allocator_create_heap(iree_make_cstring_view("local"),
-                                            host_allocator, host_allocator,
-                                            &device_allocator);
+    status = iree_hal_allocator_create_heap_with_params(
+        iree_make_cstring_view("local"), &heap_params, host_allocator,
+        host_allocator, &device_allocator);
   }
 
   // Create a task driver that will use the given executors for scheduling work
@@ -12,16 +12,66 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/wait_handle.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/executable_parallel.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/utils/local_channel.h"
+#include "iree/hal/utils/mpi_channel.h"
 #include "iree/hal/utils/resource_set.h"
 #include "iree/task/affinity_set.h"
+#include "iree/task/executor.h"
 #include "iree/task/list.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 
+//===----------------------------------------------------------------------===//
+// iree_hal_task_cmd_capture_t
+//===----------------------------------------------------------------------===//
+
+// Initial state of a task recorded into a reusable command buffer.
+// Executing a task consumes its dependency count, completion task, and (for
+// indirect dispatches) workgroup count; the captured values are restored each
+// time the command buffer is issued so that the same task DAG can be replayed
+// without re-recording it.
+typedef struct iree_hal_task_cmd_capture_t {
+  struct iree_hal_task_cmd_capture_t* next;
+  iree_task_t* task;
+  iree_task_t* completion_task;
+  int32_t pending_dependency_count;
+  iree_task_flags_t flags;
+  // Only used for IREE_TASK_TYPE_DISPATCH. Indirect dispatches have their
+  // pointer replaced with the resolved workgroup count when issued.
+  union {
+    const uint32_t* ptr;
+    uint32_t value[3];
+  } workgroup_count;
+} iree_hal_task_cmd_capture_t;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_task_cmd_binding_patch_t
+//===----------------------------------------------------------------------===//
+
+// A dispatch binding that references a binding table slot.
+// The binding pointer and length in the dispatch command are resolved from the
+// binding table provided with each issue.
+typedef struct iree_hal_task_cmd_binding_patch_t {
+  struct iree_hal_task_cmd_binding_patch_t* next;
+  // Dense binding entries in the dispatch command to update.
+  void** binding_ptr;
+  size_t* binding_length;
+  // Binding table slot the buffer is sourced from.
+  uint32_t slot;
+  // Offset into the binding table buffer range.
+  iree_device_size_t offset;
+  // Length of the range or IREE_WHOLE_BUFFER for the entire table range.
+  iree_device_size_t length;
+} iree_hal_task_cmd_binding_patch_t;
+
+typedef struct iree_hal_cmd_collective_t iree_hal_cmd_collective_t;
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t
 //===----------------------------------------------------------------------===//
@@ -59,6 +109,42 @@ typedef struct iree_hal_task_command_buffer_t {
   // An empty list indicates that root_tasks are also the leaves.
   iree_task_list_t leaf_tasks;
 
+  // All dispatch bindings referencing the binding table in recording order.
+  // Resolved each time the command buffer is issued.
+  iree_hal_task_cmd_binding_patch_t* binding_patch_head;
+  iree_hal_task_cmd_binding_patch_t* binding_patch_tail;
+
+  // All collective commands recorded. Each owns an event that must be
+  // deinitialized with the command buffer.
+  iree_hal_cmd_collective_t* collective_head;
+
+  // State used to replay command buffers that are not
+  // IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT. Unused for one-shot command buffers
+  // as their tasks are directly consumed by the submission they are issued in.
+  struct {
+    // All tasks recorded in the command buffer in recording order.
+    iree_hal_task_cmd_capture_t* capture_head;
+    iree_hal_task_cmd_capture_t* capture_tail;
+
+    // Tasks at the root of the DAG that are enqueued on each issue.
+    iree_host_size_t root_task_count;
+    iree_task_t** root_tasks;
+
+    // Tasks at the leaves of the DAG that are joined into |join_task|.
+    iree_host_size_t leaf_task_count;
+    iree_task_t** leaf_tasks;
+
+    // Joins all leaf tasks of an execution before the issuing submission's
+    // retire task. Its cleanup marks the command buffer as no longer in flight
+    // and runs regardless of whether the execution succeeded.
+    iree_task_nop_t join_task;
+
+    // Nonzero while an issued execution has not yet fully retired.
+    // Executions of the same command buffer must not overlap as they share the
+    // same task storage.
+    iree_atomic_int32_t in_flight;
+  } replay;
+
   // TODO(benvanik): move this out of the struct and allocate from the arena -
   // we only need this during recording and it's ~4KB of waste otherwise.
   // State tracked within the command buffer during recording only.
@@ -89,6 +175,15 @@ typedef struct iree_hal_task_command_buffer_t {
         binding_lengths[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
                         IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
 
+    // Binding table slot + 1 of each binding or 0 if the binding is direct.
+    // Indirect bindings store their offset in |binding_offsets| and their
+    // length in |binding_lengths| until resolved when issued.
+    uint32_t binding_slots[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                           IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+    iree_device_size_t
+        binding_offsets[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                        IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+
     // All available push constants updated each time push_constants is called.
     // Reset only with the command buffer and otherwise will maintain its values
     // during recording to allow for partial push_constants updates.
@@ -105,6 +200,11 @@ static iree_hal_task_command_buffer_t* iree_hal_task_command_buffer_cast(
   return (iree_hal_task_command_buffer_t*)base_value;
 }
 
+static void iree_hal_task_command_buffer_rearm_collectives(
+    iree_hal_task_command_buffer_t* command_buffer);
+static void iree_hal_task_command_buffer_deinitialize_collectives(
+    iree_hal_task_command_buffer_t* command_buffer);
+
 iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_device_t* device, iree_task_scope_t* scope,
     iree_hal_command_buffer_mode_t mode,
@@ -115,24 +215,11 @@ iree_status_t iree_hal_task_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
-    // If we want reuse we'd need to support duplicating the task DAG after
-    // recording or have some kind of copy-on-submit behavior that does so if
-    // a command buffer is submitted for execution twice. Allowing for the same
-    // command buffer to be enqueued multiple times would be fine so long as
-    // execution doesn't overlap (`cmdbuf|cmdbuf` vs
-    // `cmdbuf -> semaphore -> cmdbuf`) though we'd still need to be careful
-    // that we did the enqueuing and reset of the task structures at the right
-    // times. Definitely something that'll be useful in the future... but not
-    // today :)
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "only one-shot command buffer usage is supported");
-  }
-  if (binding_capacity > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
+  // NOTE: command buffers that are not one-shot are replayed by restoring the
+  // recorded task DAG on each issue (see iree_hal_task_command_buffer_rearm).
+  // This is fine so long as executions don't overlap (`cmdbuf|cmdbuf` vs
+  // `cmdbuf -> semaphore -> cmdbuf`); overlapping issues fail. Indirect
+  // bindings are resolved from the binding table provided with each issue.
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -148,6 +235,10 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
+    command_buffer->binding_patch_head = NULL;
+    command_buffer->binding_patch_tail = NULL;
+    command_buffer->collective_head = NULL;
+    memset(&command_buffer->replay, 0, sizeof(command_buffer->replay));
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
     status = iree_hal_resource_set_allocate(block_pool,
                                             &command_buffer->resource_set);
@@ -172,6 +263,7 @@ static void iree_hal_task_command_buffer_destroy(
   memset(&command_buffer->state, 0, sizeof(command_buffer->state));
   iree_task_list_discard(&command_buffer->root_tasks);
   iree_task_list_discard(&command_buffer->leaf_tasks);
+  iree_hal_task_command_buffer_deinitialize_collectives(command_buffer);
   iree_arena_deinitialize(&command_buffer->arena);
   iree_hal_resource_set_free(command_buffer->resource_set);
   iree_allocator_free(host_allocator, command_buffer);
@@ -191,12 +283,15 @@ bool iree_hal_task_command_buffer_isa(
 
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
     iree_hal_task_command_buffer_t* command_buffer);
+static iree_status_t iree_hal_task_command_buffer_capture_tasks(
+    iree_hal_task_command_buffer_t* command_buffer);
 
 static iree_status_t iree_hal_task_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
-  if (!iree_task_list_is_empty(&command_buffer->root_tasks)) {
+  if (!iree_task_list_is_empty(&command_buffer->root_tasks) ||
+      command_buffer->replay.capture_head) {
     return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                             "command buffer cannot be re-recorded");
   }
@@ -220,6 +315,12 @@ static iree_status_t iree_hal_task_command_buffer_end(
                         &command_buffer->root_tasks);
   }
 
+  if (!iree_all_bits_set(command_buffer->base.mode,
+                         IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_capture_tasks(command_buffer));
+  }
+
   iree_hal_resource_set_freeze(command_buffer->resource_set);
 
   return iree_ok_status();
@@ -274,6 +375,102 @@ static iree_status_t iree_hal_task_command_buffer_flush_tasks(
   return iree_ok_status();
 }
 
+// Tracks |task| for replay if the command buffer is reusable.
+// The initial task state is captured once recording ends as dependencies are
+// wired up after tasks are emitted.
+static iree_status_t iree_hal_task_command_buffer_track_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  if (iree_all_bits_set(command_buffer->base.mode,
+                        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    return iree_ok_status();
+  }
+  iree_hal_task_cmd_capture_t* capture = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*capture), (void**)&capture));
+  memset(capture, 0, sizeof(*capture));
+  capture->task = task;
+  if (command_buffer->replay.capture_tail) {
+    command_buffer->replay.capture_tail->next = capture;
+  } else {
+    command_buffer->replay.capture_head = capture;
+  }
+  command_buffer->replay.capture_tail = capture;
+  return iree_ok_status();
+}
+
+// Copies the tasks in |list| into an arena-allocated array.
+static iree_status_t iree_hal_task_command_buffer_capture_list(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_list_t* list,
+    iree_host_size_t* out_task_count, iree_task_t*** out_tasks) {
+  iree_host_size_t task_count = iree_task_list_calculate_size(list);
+  iree_task_t** tasks = NULL;
+  if (task_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena, task_count * sizeof(*tasks), (void**)&tasks));
+    iree_host_size_t i = 0;
+    for (iree_task_t* task = list->head; task != NULL; task = task->next_task) {
+      tasks[i++] = task;
+    }
+  }
+  *out_task_count = task_count;
+  *out_tasks = tasks;
+  return iree_ok_status();
+}
+
+// Captures the fully recorded task DAG of a reusable command buffer such that
+// it can be restored by iree_hal_task_command_buffer_rearm on each issue.
+// The root and leaf lists are flattened into arrays as the task list links
+// are clobbered during execution.
+static iree_status_t iree_hal_task_command_buffer_capture_tasks(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (iree_hal_task_cmd_capture_t* capture =
+           command_buffer->replay.capture_head;
+       capture != NULL; capture = capture->next) {
+    iree_task_t* task = capture->task;
+    capture->completion_task = task->completion_task;
+    capture->pending_dependency_count = iree_atomic_load_int32(
+        &task->pending_dependency_count, iree_memory_order_relaxed);
+    capture->flags = task->flags;
+    if (task->type == IREE_TASK_TYPE_DISPATCH) {
+      iree_task_dispatch_t* dispatch_task = (iree_task_dispatch_t*)task;
+      if (task->flags & IREE_TASK_FLAG_DISPATCH_INDIRECT) {
+        capture->workgroup_count.ptr = dispatch_task->workgroup_count.ptr;
+      } else {
+        memcpy(capture->workgroup_count.value,
+               dispatch_task->workgroup_count.value,
+               sizeof(capture->workgroup_count.value));
+      }
+    }
+  }
+
+  // An empty leaf list indicates that the root tasks are also the leaves.
+  iree_task_list_t* leaf_list =
+      iree_task_list_is_empty(&command_buffer->leaf_tasks)
+          ? &command_buffer->root_tasks
+          : &command_buffer->leaf_tasks;
+  iree_status_t status = iree_hal_task_command_buffer_capture_list(
+      command_buffer, &command_buffer->root_tasks,
+      &command_buffer->replay.root_task_count,
+      &command_buffer->replay.root_tasks);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_task_command_buffer_capture_list(
+        command_buffer, leaf_list, &command_buffer->replay.leaf_task_count,
+        &command_buffer->replay.leaf_tasks);
+  }
+
+  // The captured arrays now own the DAG; the lists are only used by one-shot
+  // command buffers when issuing and discarding.
+  if (iree_status_is_ok(status)) {
+    iree_task_list_initialize(&command_buffer->root_tasks);
+    iree_task_list_initialize(&command_buffer->leaf_tasks);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Emits a global barrier, splitting execution into all prior recorded tasks
 // and all subsequent recorded tasks. This is currently the critical piece that
 // limits our concurrency: changing to fine-grained barriers (via barrier
@@ -296,6 +493,8 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
   IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
                                            sizeof(*barrier), (void**)&barrier));
   iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_task(
+      command_buffer, &barrier->header));
 
   // If there were previous tasks then join them to the barrier.
   for (iree_task_t* task = iree_task_list_front(&command_buffer->leaf_tasks);
@@ -332,6 +531,8 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
 // scope (after state.open_barrier and before the next barrier).
 static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
     iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_track_task(command_buffer, task));
   if (command_buffer->state.open_barrier == NULL) {
     // If there is no open barrier then we are at the head and going right into
     // the task DAG.
@@ -348,20 +549,173 @@ static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
 // iree_hal_task_command_buffer_t execution
 //===----------------------------------------------------------------------===//
 
+// Cleanup for the replay join task marking the execution as retired.
+// Called both when the execution completes and when it is discarded.
+static void iree_hal_task_command_buffer_join_cleanup(
+    iree_task_t* task, iree_status_code_t status_code) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      (iree_hal_task_command_buffer_t*)((uint8_t*)task -
+                                        offsetof(iree_hal_task_command_buffer_t,
+                                                 replay.join_task));
+  iree_atomic_store_int32(&command_buffer->replay.in_flight, 0,
+                          iree_memory_order_release);
+}
+
+// Restores all recorded tasks to the state they were in when recording ended.
+// Must only be called when no prior execution is in flight.
+static void iree_hal_task_command_buffer_rearm(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  for (iree_hal_task_cmd_capture_t* capture =
+           command_buffer->replay.capture_head;
+       capture != NULL; capture = capture->next) {
+    iree_task_t* task = capture->task;
+    task->next_task = NULL;
+    task->completion_task = capture->completion_task;
+    iree_atomic_store_int32(&task->pending_dependency_count,
+                            capture->pending_dependency_count,
+                            iree_memory_order_relaxed);
+    task->flags = capture->flags;
+    if (task->type == IREE_TASK_TYPE_DISPATCH) {
+      iree_task_dispatch_t* dispatch_task = (iree_task_dispatch_t*)task;
+      if (capture->flags & IREE_TASK_FLAG_DISPATCH_INDIRECT) {
+        dispatch_task->workgroup_count.ptr = capture->workgroup_count.ptr;
+      } else {
+        memcpy(dispatch_task->workgroup_count.value,
+               capture->workgroup_count.value,
+               sizeof(dispatch_task->workgroup_count.value));
+      }
+      memset(&dispatch_task->statistics, 0, sizeof(dispatch_task->statistics));
+    }
+  }
+  iree_hal_task_command_buffer_rearm_collectives(command_buffer);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Resolves all dispatch bindings referencing the binding table from the
+// buffers in |binding_table|. The caller must ensure the buffers remain live
+// until the issued execution retires.
+static iree_status_t iree_hal_task_command_buffer_resolve_bindings(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table) {
+  if (!command_buffer->binding_patch_head) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  for (iree_hal_task_cmd_binding_patch_t* patch =
+           command_buffer->binding_patch_head;
+       patch != NULL; patch = patch->next) {
+    if (IREE_UNLIKELY(patch->slot >= binding_table.count)) {
+      status = iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE,
+          "binding table slot %u out of range of the %" PRIhsz
+          " bindings provided",
+          patch->slot, binding_table.count);
+      break;
+    }
+    const iree_hal_buffer_binding_t* binding =
+        &binding_table.bindings[patch->slot];
+    if (IREE_UNLIKELY(!binding->buffer)) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "binding table slot %u has no buffer bound",
+                                patch->slot);
+      break;
+    }
+    // TODO(benvanik): track mapping so we can properly map/unmap/flush/etc.
+    iree_hal_buffer_mapping_t buffer_mapping = {{0}};
+    status = iree_hal_buffer_map_range(
+        binding->buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+        IREE_HAL_MEMORY_ACCESS_ANY, binding->offset + patch->offset,
+        patch->length == IREE_WHOLE_BUFFER ? binding->length : patch->length,
+        &buffer_mapping);
+    if (!iree_status_is_ok(status)) break;
+    *patch->binding_ptr = buffer_mapping.contents.data;
+    *patch->binding_length = buffer_mapping.contents.data_length;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Issues a reusable command buffer by re-arming its recorded task DAG.
+// No tasks are allocated and no dependencies are rewired beyond joining the
+// leaves to |retire_task|.
+static iree_status_t iree_hal_task_command_buffer_issue_reusable(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table, iree_task_t* retire_task,
+    iree_task_submission_t* pending_submission) {
+  // If the command buffer is empty (valid!) then we are a no-op.
+  if (command_buffer->replay.root_task_count == 0) {
+    return iree_ok_status();
+  }
+
+  int32_t expected = 0;
+  if (IREE_UNLIKELY(!iree_atomic_compare_exchange_strong_int32(
+          &command_buffer->replay.in_flight, &expected, 1,
+          iree_memory_order_acquire, iree_memory_order_relaxed))) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "reusable command buffer issued while a prior execution is still in "
+        "flight; executions of the same command buffer must not overlap");
+  }
+
+  // Bindings can only be updated once we know no prior execution is using
+  // them.
+  iree_status_t status = iree_hal_task_command_buffer_resolve_bindings(
+      command_buffer, binding_table);
+  if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+    iree_atomic_store_int32(&command_buffer->replay.in_flight, 0,
+                            iree_memory_order_release);
+    return status;
+  }
+
+  iree_hal_task_command_buffer_rearm(command_buffer);
+
+  // Join all leaves into the retire task. The join task is reinitialized each
+  // time as it is consumed by the execution like any other task.
+  iree_task_nop_t* join_task = &command_buffer->replay.join_task;
+  iree_task_nop_initialize(command_buffer->scope, join_task);
+  iree_task_set_cleanup_fn(&join_task->header,
+                           iree_hal_task_command_buffer_join_cleanup);
+  iree_task_set_completion_task(&join_task->header, retire_task);
+  for (iree_host_size_t i = 0; i < command_buffer->replay.leaf_task_count;
+       ++i) {
+    iree_task_set_completion_task(command_buffer->replay.leaf_tasks[i],
+                                  &join_task->header);
+  }
+
+  // Enqueue all root tasks that are ready to run immediately.
+  for (iree_host_size_t i = 0; i < command_buffer->replay.root_task_count;
+       ++i) {
+    iree_task_submission_enqueue(pending_submission,
+                                 command_buffer->replay.root_tasks[i]);
+  }
+
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_buffer_binding_table_t binding_table,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
     iree_arena_allocator_t* arena, iree_task_submission_t* pending_submission) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
   IREE_ASSERT_TRUE(command_buffer);
 
+  if (!iree_all_bits_set(command_buffer->base.mode,
+                         IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    return iree_hal_task_command_buffer_issue_reusable(
+        command_buffer, binding_table, retire_task, pending_submission);
+  }
+
   // If the command buffer is empty (valid!) then we are a no-op.
   bool has_root_tasks = !iree_task_list_is_empty(&command_buffer->root_tasks);
   if (!has_root_tasks) {
     return iree_ok_status();
   }
 
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_resolve_bindings(
+      command_buffer, binding_table));
+
   bool has_leaf_tasks = !iree_task_list_is_empty(&command_buffer->leaf_tasks);
   if (has_leaf_tasks) {
     // Chain the retire task onto the leaf tasks as their completion indicates
@@ -703,31 +1057,224 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
 // iree_hal_command_buffer_collective
 //===----------------------------------------------------------------------===//
 
+// A collective operation executed asynchronously by an MPI or local channel.
+//
+// With MPI channels the call task runs twice per execution: the first time it
+// submits the operation to the channel and enqueues a nested wait task on
+// |event| as its own dependency, and the second time (once the wait
+// completes) it reports the operation result. The executor is free to run
+// other tasks (including dispatches recorded concurrently with the
+// collective) while the transfer is in flight.
+//
+// With local channels the call task advances the operation each time it runs
+// and performs its share of the data movement inline; while waiting on other
+// participants it blocks on |event| the same way, which the participant that
+// unblocks it signals.
+typedef struct iree_hal_cmd_collective_t {
+  iree_task_call_t task;
+  iree_hal_cmd_collective_t* next;
+  iree_hal_channel_t* channel;
+  // True if |channel| is a local channel and |local_operation| is used.
+  bool is_local;
+  iree_hal_mpi_channel_operation_t operation;
+  iree_hal_local_channel_operation_t local_operation;
+  // Host pointers to the send and receive bindings, if used.
+  void* send_ptr;
+  void* recv_ptr;
+  // Signaled by the channel when the operation completes.
+  iree_event_t event;
+  // Nested wait on |event|, reinitialized on each execution.
+  iree_task_wait_t wait_task;
+  // True between submitting the operation and its completion being reported.
+  bool is_issued;
+  // Result of the operation set by the channel prior to signaling |event|.
+  iree_status_t status;
+} iree_hal_cmd_collective_t;
+
+// Called from the channel progress thread when the operation completes.
+static void iree_hal_cmd_collective_complete(
+    void* user_data, iree_hal_mpi_channel_operation_t* operation,
+    iree_status_t status) {
+  iree_hal_cmd_collective_t* cmd = (iree_hal_cmd_collective_t*)user_data;
+  cmd->status = status;
+  iree_event_set(&cmd->event);
+}
+
+// Called by the participant that allows the local operation to progress.
+static void iree_hal_cmd_collective_resume(
+    void* user_data, iree_hal_local_channel_operation_t* operation) {
+  iree_hal_cmd_collective_t* cmd = (iree_hal_cmd_collective_t*)user_data;
+  iree_event_set(&cmd->event);
+}
+
+// Blocks |task| on the completion event of |cmd|. The call will be executed
+// again once the wait task retires.
+static void iree_hal_cmd_collective_enqueue_wait(
+    iree_hal_cmd_collective_t* cmd, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  iree_task_wait_initialize(task->scope, iree_event_await(&cmd->event),
+                            IREE_TIME_INFINITE_FUTURE, &cmd->wait_task);
+  iree_task_set_completion_task(&cmd->wait_task.header, task);
+  iree_task_submission_enqueue(pending_submission, &cmd->wait_task.header);
+}
+
+static iree_status_t iree_hal_cmd_collective_local(
+    iree_hal_cmd_collective_t* cmd, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  if (!cmd->is_issued) {
+    cmd->local_operation.send_ptr = cmd->send_ptr;
+    cmd->local_operation.recv_ptr = cmd->recv_ptr;
+    memset(&cmd->local_operation.impl, 0, sizeof(cmd->local_operation.impl));
+  }
+
+  // The event must be reset prior to advancing as other participants may
+  // signal it as soon as the operation has arrived.
+  iree_event_reset(&cmd->event);
+  bool is_completed = false;
+  iree_status_t status = iree_hal_local_channel_advance(
+      cmd->channel, &cmd->local_operation, &is_completed);
+  if (iree_status_is_ok(status) && !is_completed) {
+    cmd->is_issued = true;
+    iree_hal_cmd_collective_enqueue_wait(cmd, task, pending_submission);
+  } else {
+    cmd->is_issued = false;
+  }
+  return status;
+}
+
+static iree_status_t iree_hal_cmd_collective(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  iree_hal_cmd_collective_t* cmd = (iree_hal_cmd_collective_t*)user_context;
+
+  if (cmd->is_local) {
+    return iree_hal_cmd_collective_local(cmd, task, pending_submission);
+  }
+
+  if (cmd->is_issued) {
+    // Resumed after the nested wait completed; the event wait ensures the
+    // status written by the progress thread is visible.
+    cmd->is_issued = false;
+    iree_status_t status = cmd->status;
+    cmd->status = iree_ok_status();
+    return status;
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, cmd->operation.element_count);
+
+  iree_event_reset(&cmd->event);
+  cmd->operation.send_ptr = cmd->send_ptr;
+  cmd->operation.recv_ptr = cmd->recv_ptr;
+  iree_status_t status =
+      iree_hal_mpi_channel_submit(cmd->channel, &cmd->operation);
+  if (iree_status_is_ok(status)) {
+    cmd->is_issued = true;
+    iree_hal_cmd_collective_enqueue_wait(cmd, task, pending_submission);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Maps |binding| for host access during execution, returning NULL if it has
+// no buffer.
+static iree_status_t iree_hal_task_command_buffer_map_collective_binding(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_t binding, void** out_ptr) {
+  *out_ptr = NULL;
+  if (!binding.buffer) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &binding.buffer));
+  // TODO(benvanik): track mapping so we can properly map/unmap/flush/etc.
+  iree_hal_buffer_mapping_t buffer_mapping = {{0}};
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      binding.buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+      IREE_HAL_MEMORY_ACCESS_ANY, binding.offset, binding.length,
+      &buffer_mapping));
+  *out_ptr = buffer_mapping.contents.data;
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_collective(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_channel_t* channel,
     iree_hal_collective_op_t op, uint32_t param,
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
-  // The channel can be used as a vtable if we want to inject collective APIs -
-  // the device creation function would set up the channel once and we'll
-  // receive it here each time. When interacting with the task system we want to
-  // get wait handles we can model with iree_task_wait_t.
-  //
-  // An example basic flow:
-  //   insert iree_task_call_t:
-  //     chains with prior commands and makes the collective API call
-  //   insert iree_task_wait_t with API wait handle or our event:
-  //     chains with call
-  //
-  // What we probably want to do, though, is group the commands based on
-  // execution barriers. When a new collective command comes in we should
-  // reserve an event from the event pool, create the call to issue the
-  // collective operation, and then track the event in the command buffer state.
-  // When another collective call comes in we'll do the same and append the
-  // event. At the next execution barrier (or non-collective command) we'd
-  // flush to a multi-wait on all of the pending events.
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not yet implemented on the task system");
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+
+  // Only MPI and local channels support asynchronous collectives today.
+  // Channels are created by the device and will always be one of the two if
+  // created at all.
+  const bool is_local = iree_hal_local_channel_isa(channel);
+  if (!is_local && !iree_hal_mpi_channel_isa(channel)) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "collectives on the task system require an MPI or local channel");
+  }
+
+  IREE_RETURN_IF_ERROR(
+      iree_hal_resource_set_insert(command_buffer->resource_set, 1, &channel));
+
+  iree_hal_cmd_collective_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
+  memset(cmd, 0, sizeof(*cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_map_collective_binding(
+      command_buffer, send_binding, &cmd->send_ptr));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_map_collective_binding(
+      command_buffer, recv_binding, &cmd->recv_ptr));
+
+  IREE_RETURN_IF_ERROR(iree_event_initialize(/*initial_state=*/false,
+                                             &cmd->event));
+  cmd->next = command_buffer->collective_head;
+  command_buffer->collective_head = cmd;
+
+  iree_task_call_initialize(
+      command_buffer->scope,
+      iree_task_make_call_closure(iree_hal_cmd_collective, (void*)cmd),
+      &cmd->task);
+  cmd->channel = channel;
+  cmd->is_local = is_local;
+  if (is_local) {
+    cmd->local_operation.op = op;
+    cmd->local_operation.param = param;
+    cmd->local_operation.element_count = element_count;
+    cmd->local_operation.fn = iree_hal_cmd_collective_resume;
+    cmd->local_operation.user_data = cmd;
+  } else {
+    cmd->operation.op = op;
+    cmd->operation.param = param;
+    cmd->operation.element_count = element_count;
+    cmd->operation.fn = iree_hal_cmd_collective_complete;
+    cmd->operation.user_data = cmd;
+  }
+
+  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
+                                                          &cmd->task.header);
+}
+
+// Resets the execution state of all recorded collectives for replay.
+static void iree_hal_task_command_buffer_rearm_collectives(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  for (iree_hal_cmd_collective_t* cmd = command_buffer->collective_head;
+       cmd != NULL; cmd = cmd->next) {
+    cmd->is_issued = false;
+    iree_status_ignore(cmd->status);
+    cmd->status = iree_ok_status();
+  }
+}
+
+// Releases the events owned by all recorded collectives.
+static void iree_hal_task_command_buffer_deinitialize_collectives(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  for (iree_hal_cmd_collective_t* cmd = command_buffer->collective_head;
+       cmd != NULL; cmd = cmd->next) {
+    iree_status_ignore(cmd->status);
+    iree_event_deinitialize(&cmd->event);
+  }
+  command_buffer->collective_head = NULL;
 }
 
 //===----------------------------------------------------------------------===//
@@ -784,13 +1331,13 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
     }
     iree_host_size_t binding_ordinal = binding_base + bindings[i].binding;
 
-    // TODO(benvanik): batch insert by getting the resources in their own list.
-    IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
-        command_buffer->resource_set, 1, &bindings[i].buffer));
-
     // TODO(benvanik): track mapping so we can properly map/unmap/flush/etc.
     iree_hal_buffer_mapping_t buffer_mapping = {{0}};
     if (bindings[i].buffer) {
+      // TODO(benvanik): batch insert by getting the resources in their own
+      // list.
+      IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+          command_buffer->resource_set, 1, &bindings[i].buffer));
       IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
           bindings[i].buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
           IREE_HAL_MEMORY_ACCESS_ANY, bindings[i].offset, bindings[i].length,
@@ -799,10 +1346,17 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
           buffer_mapping.contents.data;
       command_buffer->state.binding_lengths[binding_ordinal] =
           buffer_mapping.contents.data_length;
+      command_buffer->state.binding_slots[binding_ordinal] = 0;
     } else {
-      // TODO(#10144): stash indirect binding reference in the state table.
-      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                              "binding table lookup not yet supported");
+      // Stash the indirect binding reference; dispatches using it will have
+      // the buffer resolved from the binding table when issued.
+      command_buffer->state.bindings[binding_ordinal] = NULL;
+      command_buffer->state.binding_lengths[binding_ordinal] =
+          bindings[i].length;
+      command_buffer->state.binding_slots[binding_ordinal] =
+          bindings[i].buffer_slot + 1;
+      command_buffer->state.binding_offsets[binding_ordinal] =
+          bindings[i].offset;
     }
   }
 
@@ -813,11 +1367,19 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
 // iree_hal_command_buffer_dispatch
 //===----------------------------------------------------------------------===//
 
+// Indicates that the dispatch variant depends on an indirect workgroup count.
+#define IREE_HAL_CMD_DISPATCH_VARIANT_UNRESOLVED UINT32_MAX
+
 typedef struct iree_hal_cmd_dispatch_t {
   iree_task_dispatch_t task;
   iree_hal_local_executable_t* executable;
   int32_t ordinal;
 
+  // Specialized variant of the entry point selected when recording or
+  // IREE_HAL_CMD_DISPATCH_VARIANT_UNRESOLVED if the workgroup count is only
+  // known at execution time and the variant must be selected per tile.
+  uint32_t variant;
+
   // Total number of available 4 byte push constant values in |push_constants|.
   uint16_t push_constant_count;
 
@@ -832,6 +1394,13 @@ typedef struct iree_hal_cmd_dispatch_t {
   // - const size_t binding_lengths[binding_count];
 } iree_hal_cmd_dispatch_t;
 
+static iree_status_t iree_hal_cmd_dispatch_parallel_for(
+    void* self, uint32_t tile_count,
+    iree_hal_executable_parallel_tile_fn_t tile_fn, void* user_data) {
+  return iree_task_executor_parallel_for((iree_task_executor_t*)self,
+                                         tile_count, tile_fn, user_data);
+}
+
 static iree_status_t iree_hal_cmd_dispatch_tile(
     void* user_context, const iree_task_tile_context_t* tile_context,
     iree_task_submission_t* pending_submission) {
@@ -869,19 +1438,63 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
           .workgroup_id_x = tile_context->workgroup_xyz[0],
           .workgroup_id_y = tile_context->workgroup_xyz[1],
           .workgroup_id_z = tile_context->workgroup_xyz[2],
-          .reserved = 0,
+          .workgroup_range_x = (uint16_t)tile_context->workgroup_range_x,
           .processor_id = tile_context->processor_id,
           .local_memory = tile_context->local_memory.data,
           .local_memory_size = (size_t)tile_context->local_memory.data_length,
       };
+  uint32_t variant = cmd->variant;
+  if (IREE_UNLIKELY(variant == IREE_HAL_CMD_DISPATCH_VARIANT_UNRESOLVED)) {
+    variant = iree_hal_local_executable_select_variant(
+        cmd->executable, cmd->ordinal, tile_context->workgroup_count,
+        cmd->push_constant_count, dispatch_state.push_constants);
+  }
+
+  // Imports called by the executable may fork nested work across the executor.
+  // Only executables with imports can make use of it so others skip the setup.
+  const iree_hal_executable_parallel_t parallel = {
+      .self = tile_context->executor,
+      .concurrency = dispatch_state.max_concurrency,
+      .parallel_for = iree_hal_cmd_dispatch_parallel_for,
+  };
+  const bool has_imports = cmd->executable->environment.import_funcs != NULL;
+  const iree_hal_executable_parallel_t* previous_parallel =
+      has_imports ? iree_hal_executable_parallel_exchange(&parallel) : NULL;
+
   iree_status_t status = iree_hal_local_executable_issue_call(
-      cmd->executable, cmd->ordinal, &dispatch_state, &workgroup_state,
-      tile_context->worker_id);
+      cmd->executable, cmd->ordinal, variant, &dispatch_state,
+      &workgroup_state, tile_context->worker_id);
+
+  if (has_imports) iree_hal_executable_parallel_exchange(previous_parallel);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+// Records that the dense binding at |binding_ptr|/|binding_length| must be
+// resolved from binding table |slot| each time the command buffer is issued.
+static iree_status_t iree_hal_task_command_buffer_append_binding_patch(
+    iree_hal_task_command_buffer_t* command_buffer, uint32_t slot,
+    iree_device_size_t offset, iree_device_size_t length, void** binding_ptr,
+    size_t* binding_length) {
+  iree_hal_task_cmd_binding_patch_t* patch = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*patch), (void**)&patch));
+  patch->next = NULL;
+  patch->binding_ptr = binding_ptr;
+  patch->binding_length = binding_length;
+  patch->slot = slot;
+  patch->offset = offset;
+  patch->length = length;
+  if (command_buffer->binding_patch_tail) {
+    command_buffer->binding_patch_tail->next = patch;
+  } else {
+    command_buffer->binding_patch_head = patch;
+  }
+  command_buffer->binding_patch_tail = patch;
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -934,6 +1547,15 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
       iree_task_make_dispatch_closure(iree_hal_cmd_dispatch_tile, (void*)cmd),
       workgroup_size, workgroup_count, &cmd->task);
 
+  // Functions that can process ranges of workgroups receive each contiguous
+  // run of tiles reserved by a shard in a single call.
+  if (iree_all_bits_set(
+          iree_hal_local_executable_dispatch_flags(local_executable,
+                                                   entry_point),
+          IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE)) {
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_RANGE;
+  }
+
   // Tell the task system how much workgroup local memory is required for the
   // dispatch; each invocation of the entry point will have at least as much
   // scratch memory available during execution.
@@ -950,6 +1572,12 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
          push_constant_count * sizeof(*push_constants));
   cmd_ptr += push_constant_count * sizeof(*push_constants);
 
+  // Select the specialized variant once when recording as the push constants
+  // and (direct) workgroup count are fixed for all executions.
+  cmd->variant = iree_hal_local_executable_select_variant(
+      local_executable, entry_point, workgroup_count, push_constant_count,
+      push_constants);
+
   // Produce the dense binding list based on the declared bindings used.
   // This allows us to change the descriptor sets and bindings counts supported
   // in the HAL independent of any executable as each executable just gets the
@@ -970,7 +1598,15 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     used_binding_mask = iree_shr(used_binding_mask, mask_offset + 1);
     binding_ptrs[i] = command_buffer->state.bindings[binding_ordinal];
     binding_lengths[i] = command_buffer->state.binding_lengths[binding_ordinal];
-    if (!binding_ptrs[i]) {
+    const uint32_t binding_slot =
+        command_buffer->state.binding_slots[binding_ordinal];
+    if (binding_slot) {
+      IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_append_binding_patch(
+          command_buffer, binding_slot - 1,
+          command_buffer->state.binding_offsets[binding_ordinal],
+          command_buffer->state.binding_lengths[binding_ordinal],
+          &binding_ptrs[i], &binding_lengths[i]));
+    } else if (!binding_ptrs[i]) {
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "(flat) binding %d is NULL", binding_ordinal);
     }
@@ -1019,6 +1655,9 @@ static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
       base_command_buffer, executable, entry_point, 0, 0, 0, &cmd));
   cmd->task.workgroup_count.ptr = (const uint32_t*)buffer_mapping.contents.data;
   cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INDIRECT;
+  if (cmd->executable->export_variants) {
+    cmd->variant = IREE_HAL_CMD_DISPATCH_VARIANT_UNRESOLVED;
+  }
   return iree_ok_status();
 }
 
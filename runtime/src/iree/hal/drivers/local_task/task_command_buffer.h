@@ -35,6 +35,10 @@ bool iree_hal_task_command_buffer_isa(
 // prior commands such as signaled events and will be mutated as events are
 // reset or new events are signaled.
 //
+// |binding_table| is used to resolve indirect bindings referenced by dispatches
+// recorded in the command buffer. The buffers in the table must remain live
+// until |retire_task| has completed.
+//
 // |retire_task| will be scheduled once all commands issued from the command
 // buffer retire and can be used as a fence point.
 //
@@ -46,8 +50,15 @@ bool iree_hal_task_command_buffer_isa(
 //
 // |pending_submission| will receive the ready list of commands and must be
 // submitted to the executor (or discarded on failure) by the caller.
+//
+// Command buffers recorded without IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT keep
+// their recorded task DAG and re-arm it on each issue instead of handing the
+// tasks off to the submission. Executions of the same command buffer must not
+// overlap and issuing one while a prior execution has not yet retired fails
+// with IREE_STATUS_FAILED_PRECONDITION.
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* command_buffer,
+    iree_hal_buffer_binding_table_t binding_table,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
     iree_arena_allocator_t* arena, iree_task_submission_t* pending_submission);
 
@@ -12,25 +12,28 @@
 
 #include "iree/base/internal/arena.h"
 #include "iree/base/internal/cpu.h"
+#include "iree/base/internal/math.h"
 #include "iree/hal/drivers/local_task/task_command_buffer.h"
 #include "iree/hal/drivers/local_task/task_event.h"
 #include "iree/hal/drivers/local_task/task_queue.h"
 #include "iree/hal/drivers/local_task/task_semaphore.h"
+#include "iree/hal/local/dispatch_statistics.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
 #include "iree/hal/utils/file_transfer.h"
+#include "iree/hal/utils/local_channel.h"
 #include "iree/hal/utils/memory_file.h"
+#include "iree/hal/utils/mpi_channel.h"
+#include "iree/hal/utils/mpi_channel_provider.h"
+#include "iree/hal/utils/queue_pool.h"
 
 typedef struct iree_hal_task_device_t {
   iree_hal_resource_t resource;
   iree_string_view_t identifier;
 
-  // Block pool used for small allocations like tasks and submissions.
-  iree_arena_block_pool_t small_block_pool;
-
-  // Block pool used for command buffers with a larger block size (as command
-  // buffers can contain inlined data uploads).
+  // Block pool used for transient allocations not associated with any
+  // particular queue (such as multi-waits).
   iree_arena_block_pool_t large_block_pool;
 
   iree_host_size_t loader_count;
@@ -42,6 +45,21 @@ typedef struct iree_hal_task_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Streaming file transfer options from the device parameters. The loop is
+  // ignored and provided per-operation.
+  iree_hal_file_transfer_options_t file_transfer_options;
+
+  // Pool servicing queue-ordered allocations from |device_allocator|.
+  iree_hal_queue_pool_params_t queue_pool_params;
+  iree_hal_queue_pool_t* queue_pool;
+
+  // True while profiling with IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS
+  // or IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS and contributing to
+  // the process-wide local dispatch statistics.
+  bool capturing_dispatch_statistics;
+  // Flags the capture was started with.
+  iree_hal_local_dispatch_statistics_flags_t dispatch_statistics_flags;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -58,6 +76,14 @@ void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_scope_flags = IREE_TASK_SCOPE_FLAG_NONE;
+  out_params->high_priority_queues = 0;
+  out_params->file_transfer.chunk_count =
+      IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT;
+  out_params->file_transfer.chunk_size =
+      IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT;
+  out_params->file_transfer.staging_limit =
+      IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT;
+  iree_hal_queue_pool_params_initialize(&out_params->queue_pool);
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -115,11 +141,15 @@ iree_status_t iree_hal_task_device_create(
     device->device_allocator = device_allocator;
     iree_hal_allocator_retain(device_allocator);
 
-    iree_arena_block_pool_initialize(4096, host_allocator,
-                                     &device->small_block_pool);
     iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
                                      &device->large_block_pool);
 
+    device->file_transfer_options.chunk_count = params->file_transfer.chunk_count;
+    device->file_transfer_options.chunk_size = params->file_transfer.chunk_size;
+    device->file_transfer_options.staging_limit =
+        params->file_transfer.staging_limit;
+    device->queue_pool_params = params->queue_pool;
+
     device->loader_count = loader_count;
     device->loaders =
         (iree_hal_executable_loader_t**)((uint8_t*)device + sizeof(*device) +
@@ -131,13 +161,26 @@ iree_status_t iree_hal_task_device_create(
 
     device->queue_count = queue_count;
     for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+      iree_task_scope_flags_t queue_scope_flags = params->queue_scope_flags;
+      if (i < sizeof(iree_hal_queue_affinity_t) * 8 &&
+          iree_all_bits_set(params->high_priority_queues,
+                            (iree_hal_queue_affinity_t)1ull << i)) {
+        queue_scope_flags |= IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY;
+      }
       // TODO(benvanik): add a number to each queue ID.
       iree_hal_task_queue_initialize(
-          device->identifier, params->queue_scope_flags, queue_executors[i],
-          &device->small_block_pool, &device->queues[i]);
+          device->identifier, queue_scope_flags, queue_executors[i],
+          /*small_block_size=*/4096, params->arena_block_size, host_allocator,
+          &device->queues[i]);
     }
   }
 
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_queue_pool_create(device->queue_pool_params,
+                                        device_allocator, host_allocator,
+                                        &device->queue_pool);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -152,6 +195,11 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Balance any capture left running by a profiling session never ended.
+  if (device->capturing_dispatch_statistics) {
+    iree_hal_local_dispatch_statistics_end(device->dispatch_statistics_flags);
+  }
+
   for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
     iree_hal_task_queue_deinitialize(&device->queues[i]);
   }
@@ -160,11 +208,11 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
 
+  iree_hal_queue_pool_free(device->queue_pool);
   iree_hal_allocator_release(device->device_allocator);
   iree_hal_channel_provider_release(device->channel_provider);
 
   iree_arena_block_pool_deinitialize(&device->large_block_pool);
-  iree_arena_block_pool_deinitialize(&device->small_block_pool);
 
   iree_allocator_free(host_allocator, device);
 
@@ -195,6 +243,20 @@ static void iree_hal_task_replace_device_allocator(
   iree_hal_allocator_retain(new_allocator);
   iree_hal_allocator_release(device->device_allocator);
   device->device_allocator = new_allocator;
+
+  // Recreate the queue pool so that new queue-ordered allocations come from
+  // the new allocator. Buffers acquired from the old pool remain valid. If the
+  // pool can't be recreated the old one continues to be used.
+  iree_hal_queue_pool_t* new_queue_pool = NULL;
+  iree_status_t status =
+      iree_hal_queue_pool_create(device->queue_pool_params, new_allocator,
+                                 device->host_allocator, &new_queue_pool);
+  if (iree_status_is_ok(status)) {
+    iree_hal_queue_pool_free(device->queue_pool);
+    device->queue_pool = new_queue_pool;
+  } else {
+    iree_status_ignore(status);
+  }
 }
 
 static void iree_hal_task_replace_channel_provider(
@@ -213,9 +275,9 @@ static iree_status_t iree_hal_task_device_trim(iree_hal_device_t* base_device) {
   for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
     iree_hal_task_queue_trim(&device->queues[i]);
   }
+  iree_hal_queue_pool_trim(device->queue_pool);
   IREE_RETURN_IF_ERROR(iree_hal_allocator_trim(device->device_allocator));
 
-  iree_arena_block_pool_trim(&device->small_block_pool);
   iree_arena_block_pool_trim(&device->large_block_pool);
 
   return iree_ok_status();
@@ -242,6 +304,12 @@ static iree_status_t iree_hal_task_device_query_i64(
     return iree_ok_status();
   }
 
+  if (iree_string_view_equal(category, IREE_SV("hal.queue_pool"))) {
+    // Queue-ordered allocation pool accounting; used to verify steady state
+    // workloads are not allocating and to size the pool.
+    return iree_hal_queue_pool_query_i64(device->queue_pool, key, out_value);
+  }
+
   if (iree_string_view_equal(category, IREE_SV("hal.device"))) {
     if (iree_string_view_equal(key, IREE_SV("concurrency"))) {
       *out_value = (int64_t)device->queue_count;
@@ -266,6 +334,10 @@ static iree_status_t iree_hal_task_device_query_i64(
 }
 
 // Returns the queue index to submit work to based on the |queue_affinity|.
+// Each queue is backed by its own executor and when executors are created per
+// NUMA node (--task_topology_nodes=) bit N of the affinity selects node N. The
+// lowest set bit is used when multiple queues are allowed and any affinity
+// bits beyond the queue count wrap around.
 //
 // If we wanted to have dedicated transfer queues we'd fork off based on
 // command_categories. For now all queues are general purpose.
@@ -273,17 +345,33 @@ static iree_host_size_t iree_hal_task_device_select_queue(
     iree_hal_task_device_t* device,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity) {
-  // TODO(benvanik): evaluate if we want to obscure this mapping a bit so that
-  // affinity really means "equivalent affinities map to equivalent queues" and
-  // not a specific queue index.
-  return queue_affinity % device->queue_count;
+  if (queue_affinity == 0 || device->queue_count == 1) return 0;
+  return iree_math_count_trailing_zeros_u64(queue_affinity) %
+         device->queue_count;
 }
 
 static iree_status_t iree_hal_task_device_create_channel(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not implemented");
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+
+  // Collectives are implemented with MPI or in-process shared memory; other
+  // providers (or none) are not able to create channels that the task system
+  // can execute.
+  if (device->channel_provider &&
+      iree_hal_local_channel_provider_isa(device->channel_provider)) {
+    return iree_hal_local_channel_create(device->channel_provider, params,
+                                         device->host_allocator, out_channel);
+  }
+  if (!device->channel_provider ||
+      !iree_hal_mpi_channel_provider_isa(device->channel_provider)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "collectives on the task system require an MPI or "
+                            "local channel provider");
+  }
+
+  return iree_hal_mpi_channel_create(device->channel_provider, params,
+                                     device->host_allocator, out_channel);
 }
 
 static iree_status_t iree_hal_task_device_create_command_buffer(
@@ -296,7 +384,8 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
       device, command_categories, queue_affinity);
   return iree_hal_task_command_buffer_create(
       base_device, &device->queues[queue_index].scope, mode, command_categories,
-      queue_affinity, binding_capacity, &device->large_block_pool,
+      queue_affinity, binding_capacity,
+      &device->queues[queue_index].large_block_pool,
       device->host_allocator, out_command_buffer);
 }
 
@@ -391,14 +480,23 @@ static iree_status_t iree_hal_task_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO(benvanik): queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(
-      iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(base_device),
-                                         params, allocation_size, out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+
+  // Reserve memory that will be free by the time the waits are reached. The
+  // signal is ordered on the queue after the waits so that the host never
+  // blocks and the storage is only available once the prior users complete.
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_queue_pool_acquire(
+      device->queue_pool, wait_semaphore_list, params, allocation_size,
+      &buffer));
+  iree_status_t status = iree_hal_device_queue_barrier(
+      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list);
+  if (iree_status_is_ok(status)) {
+    *out_buffer = buffer;
+  } else {
+    iree_hal_buffer_release(buffer);
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_task_device_queue_dealloca(
@@ -406,9 +504,13 @@ static iree_status_t iree_hal_task_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO(benvanik): queue-ordered allocations.
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+
+  // The memory is no longer used once the waits are reached and can be reused
+  // by any allocation ordered after them.
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
+  iree_hal_queue_pool_release(device->queue_pool, buffer, wait_semaphore_list);
   return iree_ok_status();
 }
 
@@ -419,12 +521,13 @@ static iree_status_t iree_hal_task_device_queue_read(
     iree_hal_file_t* source_file, uint64_t source_offset,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
       .loop = iree_loop_inline(&loop_status),
-      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+      .chunk_count = device->file_transfer_options.chunk_count,
+      .chunk_size = device->file_transfer_options.chunk_size,
+      .staging_limit = device->file_transfer_options.staging_limit,
   };
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_read_streaming(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
@@ -440,12 +543,13 @@ static iree_status_t iree_hal_task_device_queue_write(
     iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
     iree_hal_file_t* target_file, uint64_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
       .loop = iree_loop_inline(&loop_status),
-      .chunk_count = IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      .chunk_size = IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+      .chunk_count = device->file_transfer_options.chunk_count,
+      .chunk_size = device->file_transfer_options.chunk_size,
+      .staging_limit = device->file_transfer_options.staging_limit,
   };
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_write_streaming(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
@@ -459,7 +563,8 @@ static iree_status_t iree_hal_task_device_queue_execute(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
   // NOTE: today we are not discriminating queues based on command type.
   iree_host_size_t queue_index = iree_hal_task_device_select_queue(
@@ -469,6 +574,7 @@ static iree_status_t iree_hal_task_device_queue_execute(
       .signal_semaphores = signal_semaphore_list,
       .command_buffer_count = command_buffer_count,
       .command_buffers = command_buffers,
+      .binding_tables = binding_tables,
   };
   return iree_hal_task_queue_submit(&device->queues[queue_index], 1, &batch);
 }
@@ -492,14 +598,25 @@ static iree_status_t iree_hal_task_device_wait_semaphores(
 static iree_status_t iree_hal_task_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
-  // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
-  // Capturing things like:
-  //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
-  //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
-  //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  // Executable counters additionally sample the hardware performance counters
+  // of the workers around each call.
+  iree_hal_local_dispatch_statistics_flags_t flags =
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE;
+  if (iree_all_bits_set(options->mode,
+                        IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS)) {
+    flags |= IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_HARDWARE_COUNTERS;
+  }
+  if (iree_any_bit_set(
+          options->mode,
+          IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS |
+              IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS) &&
+      !device->capturing_dispatch_statistics) {
+    iree_hal_local_dispatch_statistics_begin(flags);
+    device->capturing_dispatch_statistics = true;
+    device->dispatch_statistics_flags = flags;
+  }
+  // Other modes are unimplemented (and that's ok).
   return iree_ok_status();
 }
 
@@ -511,7 +628,11 @@ static iree_status_t iree_hal_task_device_profiling_flush(
 
 static iree_status_t iree_hal_task_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (device->capturing_dispatch_statistics) {
+    iree_hal_local_dispatch_statistics_end(device->dispatch_statistics_flags);
+    device->capturing_dispatch_statistics = false;
+  }
   return iree_ok_status();
 }
 
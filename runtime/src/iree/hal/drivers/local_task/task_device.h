@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_loader.h"
+#include "iree/hal/utils/queue_pool.h"
 #include "iree/task/executor.h"
 
 #ifdef __cplusplus
@@ -25,6 +26,24 @@ typedef struct iree_hal_task_device_params_t {
   iree_host_size_t arena_block_size;
   // Default flags for the iree_task_scope_t used for each queue.
   iree_task_scope_flags_t queue_scope_flags;
+  // Queues whose work is latency-sensitive and should be preferred over that
+  // of other queues sharing the same executor. Each queue with its bit set
+  // uses a scope with IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY.
+  iree_hal_queue_affinity_t high_priority_queues;
+  // Streaming file transfer options used when files cannot be mapped directly
+  // into device memory. A 0 value selects a default based on the transfer.
+  struct {
+    // Number of staging chunks each handled by a transfer worker. Workers
+    // overlap staging chunks on the host with the queue operations of other
+    // workers so counts >1 trade staging memory for throughput.
+    iree_device_size_t chunk_count;
+    // Size of each staging chunk in bytes.
+    iree_device_size_t chunk_size;
+    // Maximum total size of the staging memory in bytes.
+    iree_device_size_t staging_limit;
+  } file_transfer;
+  // Pool servicing queue-ordered allocations made with queue_alloca.
+  iree_hal_queue_pool_params_t queue_pool;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -25,12 +25,12 @@
 //  +--------------------+
 //    |
 //    |   +--------------+
-//    +-> | +--------------+  Unsatisfied waits are scheduled as wait tasks and
-//    .   +-|  sema waits  |  block the issuing of commands until all have
-//    .     +--------------+  been satisfied. If the wait is immediately
-//    .        | | | | |      following a signal from the same queue then it
-//    +--------+-+-+-+-+      elided - only cross-queue or external waits
-//    |                       actually go down to system wait handles.
+//    +-> | +--------------+  Unsatisfied waits are chained to semaphore
+//    .   +-|  sema waits  |  timepoints and block the issuing of commands
+//    .     +--------------+  until all have been satisfied. If the wait is
+//    .        | | | | |      immediately following a signal from the same
+//    +--------+-+-+-+-+      queue then it is elided - only cross-queue or
+//    |                       external waits are chained.
 //    v
 //  +--------------------+    Command buffers in the batch are issued in-order
 //  |   command issue    |    as if all commands had been recorded into the same
@@ -93,41 +93,222 @@ static void iree_hal_semaphore_list_release(iree_hal_semaphore_list_t* list) {
 // iree_hal_task_queue_wait_cmd_t
 //===----------------------------------------------------------------------===//
 
+typedef struct iree_hal_task_queue_wait_cmd_t iree_hal_task_queue_wait_cmd_t;
+
+// States of an iree_hal_task_queue_wait_chain_t. A chain transitions exactly
+// once from PENDING to RESOLVED by whichever of the timepoint callback or a
+// cancellation claims it first; the claimant releases the dependency.
+enum iree_hal_task_queue_wait_chain_state_e {
+  IREE_HAL_TASK_QUEUE_WAIT_CHAIN_STATE_PENDING = 0,
+  IREE_HAL_TASK_QUEUE_WAIT_CHAIN_STATE_RESOLVED = 1,
+};
+
+// A dependency edge from a semaphore timepoint directly to the task that issues
+// the work waiting on it. Rather than parking a wait task in the executor
+// poller on an event the timepoint callback releases the dependency and submits
+// the issue task once it is ready. When the semaphore is signaled by work on
+// the same executor the callback runs on the worker retiring that work and the
+// waiter is scheduled without an OS event or a poller wake. Allocated from the
+// submission arena which outlives the issue task.
+typedef struct iree_hal_task_queue_wait_chain_t {
+  // Timepoint registered with the semaphore.
+  iree_hal_semaphore_timepoint_t timepoint;
+  // Wait command the chain belongs to.
+  iree_hal_task_queue_wait_cmd_t* cmd;
+  // Semaphore the timepoint was acquired on or NULL if the wait was already
+  // satisfied. Retained until the submission retires.
+  iree_hal_semaphore_t* semaphore;
+  // iree_hal_task_queue_wait_chain_state_e value.
+  iree_atomic_int32_t state;
+  // Next chain claimed for cancellation during queue deinitialization.
+  struct iree_hal_task_queue_wait_chain_t* next_cancelled;
+} iree_hal_task_queue_wait_chain_t;
+
 // Task to fork out and wait on one or more semaphores.
 // This optimizes for same-queue semaphore chaining by ensuring that semaphores
 // used to stitch together subsequent submissions never have to go to the system
 // to wait as the implicit queue ordering ensures that the signals would have
 // happened prior to the sequence command being executed. Cross-queue semaphores
-// will still cause waits if they have not yet been signaled.
-typedef struct iree_hal_task_queue_wait_cmd_t {
+// that have not yet been signaled chain the issue task to their timepoints so
+// that the signal schedules it without blocking a thread or the poller.
+struct iree_hal_task_queue_wait_cmd_t {
   // Call to iree_hal_task_queue_wait_cmd.
   iree_task_call_t task;
 
+  // Queue the submission was made on. Unsignaled semaphores submit the issue
+  // task to the queue executor directly once they are signaled.
+  iree_hal_task_queue_t* queue;
+
   // Arena used for the submission - additional tasks can be allocated from
   // this.
   iree_arena_allocator_t* arena;
 
+  // Task issuing the submission once all waits are satisfied. Captured when
+  // the command runs as the completion task is cleared when it retires.
+  iree_task_t* issue_task;
+
+  // Intrusive links in the queue wait list, guarded by the queue wait mutex.
+  iree_hal_task_queue_wait_cmd_t* next;
+  iree_hal_task_queue_wait_cmd_t* prev;
+  bool is_linked;
+
   // A list of semaphores to wait on prior to issuing the rest of the
   // submission.
   iree_hal_semaphore_list_t wait_semaphores;
-} iree_hal_task_queue_wait_cmd_t;
 
-// Forks out multiple wait tasks prior to issuing the commands.
+  // One chain per wait semaphore.
+  iree_hal_task_queue_wait_chain_t* chains;
+};
+
+// Attempts to claim |chain| for resolution. Only one of the timepoint callback
+// or a cancellation will succeed and the winner must release the dependency.
+static bool iree_hal_task_queue_wait_chain_try_claim(
+    iree_hal_task_queue_wait_chain_t* chain) {
+  int32_t expected = IREE_HAL_TASK_QUEUE_WAIT_CHAIN_STATE_PENDING;
+  return iree_atomic_compare_exchange_strong_int32(
+      &chain->state, &expected, IREE_HAL_TASK_QUEUE_WAIT_CHAIN_STATE_RESOLVED,
+      iree_memory_order_acq_rel, iree_memory_order_relaxed);
+}
+
+// Releases the dependency a claimed |chain| holds on the issue task and the
+// executor reference taken when it was acquired. If this was the last
+// dependency the issue task is submitted to the executor.
+static void iree_hal_task_queue_wait_chain_release(
+    iree_hal_task_queue_wait_chain_t* chain) {
+  // The chain lives in the submission arena that may be reset as soon as the
+  // issue task runs so we must not touch it after releasing the dependency.
+  iree_task_executor_t* executor = chain->cmd->queue->executor;
+  iree_task_t* issue_task = chain->cmd->issue_task;
+  if (iree_atomic_fetch_sub_int32(&issue_task->pending_dependency_count, 1,
+                                  iree_memory_order_acq_rel) == 1) {
+    // This was the last pending dependency; hand the task to the executor.
+    // Submission is safe from any thread whether the signal came from a
+    // worker or the host.
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, issue_task);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+  }
+  iree_task_executor_release(executor);
+}
+
+// Handles timepoint callbacks when either the timepoint is reached or the
+// semaphore fails. Failures are stashed on the issue task so that it skips
+// issuing and retires with the failure on a worker, failing the signal
+// semaphores of the submission instead of signaling them.
+static iree_status_t iree_hal_task_queue_wait_chain_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  iree_hal_task_queue_wait_chain_t* chain =
+      (iree_hal_task_queue_wait_chain_t*)user_data;
+  if (!iree_hal_task_queue_wait_chain_try_claim(chain)) {
+    // Cancelled; the canceller owns the dependency.
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (IREE_UNLIKELY(status_code != IREE_STATUS_OK)) {
+    iree_task_call_fail((iree_task_call_t*)chain->cmd->issue_task,
+                        iree_make_status(status_code,
+                                         "wait semaphore failed while a queue "
+                                         "submission was waiting on it"));
+  }
+  iree_hal_task_queue_wait_chain_release(chain);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Cancels a claimed |chain| timepoint and releases its dependency. Any
+// in-flight callback will have completed (and found the chain claimed) by the
+// time the timepoint is cancelled. Must not be called from a timepoint callback
+// or with the queue wait mutex held.
+static void iree_hal_task_queue_wait_chain_cancel(
+    iree_hal_task_queue_wait_chain_t* chain) {
+  iree_hal_semaphore_cancel_timepoint(chain->semaphore, &chain->timepoint);
+  iree_hal_task_queue_wait_chain_release(chain);
+}
+
+// Chains the issue task to each unsignaled wait semaphore timepoint prior to
+// issuing the commands. This task holds a dependency on the issue task until it
+// retires so that timepoints resolved while chaining cannot issue early.
 static iree_status_t iree_hal_task_queue_wait_cmd(
     void* user_context, iree_task_t* task,
     iree_task_submission_t* pending_submission) {
   iree_hal_task_queue_wait_cmd_t* cmd = (iree_hal_task_queue_wait_cmd_t*)task;
+  iree_hal_task_queue_t* queue = cmd->queue;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  cmd->issue_task = cmd->task.header.completion_task;
+
+  // The dependency and executor reference are taken before the timepoint is
+  // acquired as the callback may be made from another thread immediately. We
+  // hold our own dependency on the issue task so the count cannot reach zero
+  // before we retire.
   iree_status_t status = iree_ok_status();
+  iree_host_size_t acquired_count = 0;
   for (iree_host_size_t i = 0; i < cmd->wait_semaphores.count; ++i) {
+    iree_hal_task_queue_wait_chain_t* chain = &cmd->chains[i];
+    chain->cmd = cmd;
+    chain->semaphore = NULL;
+    iree_atomic_store_int32(&chain->state,
+                            IREE_HAL_TASK_QUEUE_WAIT_CHAIN_STATE_PENDING,
+                            iree_memory_order_relaxed);
+    chain->next_cancelled = NULL;
+    iree_task_executor_retain(queue->executor);
+    iree_atomic_fetch_add_int32(&cmd->issue_task->pending_dependency_count, 1,
+                                iree_memory_order_acq_rel);
+    bool acquired = false;
     status = iree_hal_task_semaphore_enqueue_timepoint(
         cmd->wait_semaphores.semaphores[i],
         cmd->wait_semaphores.payload_values[i],
-        cmd->task.header.completion_task, cmd->arena, pending_submission);
+        (iree_hal_semaphore_callback_t){
+            .fn = iree_hal_task_queue_wait_chain_callback,
+            .user_data = chain,
+        },
+        &chain->timepoint, &acquired);
+    if (acquired) {
+      chain->semaphore = cmd->wait_semaphores.semaphores[i];
+      iree_hal_semaphore_retain(chain->semaphore);
+      ++acquired_count;
+    } else {
+      // Already satisfied (or failed); drop the unused dependency.
+      iree_atomic_fetch_sub_int32(&cmd->issue_task->pending_dependency_count,
+                                  1, iree_memory_order_acq_rel);
+      iree_task_executor_release(queue->executor);
+    }
     if (IREE_UNLIKELY(!iree_status_is_ok(status))) break;
   }
 
+  // Track the pending chains on the queue so that they can be cancelled if the
+  // queue is deinitialized before the semaphores are signaled.
+  if (iree_status_is_ok(status) && acquired_count > 0) {
+    iree_slim_mutex_lock(&queue->wait_mutex);
+    if (!queue->wait_list_closed) {
+      cmd->next = queue->wait_list_head;
+      cmd->prev = NULL;
+      if (queue->wait_list_head) queue->wait_list_head->prev = cmd;
+      queue->wait_list_head = cmd;
+      cmd->is_linked = true;
+    } else {
+      status = iree_make_status(IREE_STATUS_ABORTED,
+                                "queue is being deinitialized");
+    }
+    iree_slim_mutex_unlock(&queue->wait_mutex);
+  }
+
+  // On failure cancel any chains that were acquired. Our own dependency keeps
+  // the issue task from being submitted and it will be aborted when we retire
+  // with the failure.
+  if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+    for (iree_host_size_t i = 0; i < cmd->wait_semaphores.count; ++i) {
+      iree_hal_task_queue_wait_chain_t* chain = &cmd->chains[i];
+      if (!chain->semaphore) continue;
+      if (iree_hal_task_queue_wait_chain_try_claim(chain)) {
+        iree_hal_task_queue_wait_chain_cancel(chain);
+      }
+    }
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -144,9 +325,39 @@ static void iree_hal_task_queue_wait_cmd_cleanup(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Retires the chains of |cmd| once the issue task has run or been discarded.
+// All chains have been resolved by this point: the issue task cannot run until
+// every acquired chain has released its dependency. Called from the retire
+// cleanup as the final use of the submission arena.
+static void iree_hal_task_queue_wait_cmd_retire_chains(
+    iree_hal_task_queue_wait_cmd_t* cmd) {
+  iree_hal_task_queue_t* queue = cmd->queue;
+  if (cmd->is_linked) {
+    iree_slim_mutex_lock(&queue->wait_mutex);
+    if (cmd->prev) {
+      cmd->prev->next = cmd->next;
+    } else {
+      queue->wait_list_head = cmd->next;
+    }
+    if (cmd->next) cmd->next->prev = cmd->prev;
+    cmd->is_linked = false;
+    iree_slim_mutex_unlock(&queue->wait_mutex);
+  }
+  for (iree_host_size_t i = 0; i < cmd->wait_semaphores.count; ++i) {
+    iree_hal_task_queue_wait_chain_t* chain = &cmd->chains[i];
+    if (!chain->semaphore) continue;
+    IREE_ASSERT_EQ(IREE_HAL_TASK_QUEUE_WAIT_CHAIN_STATE_RESOLVED,
+                   iree_atomic_load_int32(&chain->state,
+                                          iree_memory_order_acquire));
+    iree_hal_semaphore_release(chain->semaphore);
+    chain->semaphore = NULL;
+  }
+}
+
 // Allocates and initializes a iree_hal_task_queue_wait_cmd_t task.
 static iree_status_t iree_hal_task_queue_wait_cmd_allocate(
-    iree_task_scope_t* scope, const iree_hal_semaphore_list_t* wait_semaphores,
+    iree_task_scope_t* scope, iree_hal_task_queue_t* queue,
+    const iree_hal_semaphore_list_t* wait_semaphores,
     iree_arena_allocator_t* arena, iree_hal_task_queue_wait_cmd_t** out_cmd) {
   iree_hal_task_queue_wait_cmd_t* cmd = NULL;
   IREE_RETURN_IF_ERROR(iree_arena_allocate(arena, sizeof(*cmd), (void**)&cmd));
@@ -155,7 +366,19 @@ static iree_status_t iree_hal_task_queue_wait_cmd_allocate(
       &cmd->task);
   iree_task_set_cleanup_fn(&cmd->task.header,
                            iree_hal_task_queue_wait_cmd_cleanup);
+  cmd->queue = queue;
   cmd->arena = arena;
+  cmd->issue_task = NULL;
+  cmd->next = NULL;
+  cmd->prev = NULL;
+  cmd->is_linked = false;
+
+  // Chains are initialized when the command runs but must be valid for the
+  // retire cleanup even if the command is discarded before then.
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      arena, wait_semaphores->count * sizeof(*cmd->chains),
+      (void**)&cmd->chains));
+  memset(cmd->chains, 0, wait_semaphores->count * sizeof(*cmd->chains));
 
   // Clone the wait semaphores from the batch - we retain them and their
   // payloads.
@@ -185,6 +408,10 @@ typedef struct iree_hal_task_queue_issue_cmd_t {
   // if we are the last issue pending.
   iree_hal_task_queue_t* queue;
 
+  // Binding tables for each command buffer cloned into the submission arena or
+  // NULL if no command buffer uses indirect bindings.
+  iree_hal_buffer_binding_table_t* binding_tables;
+
   // Command buffers to be issued in the order the appeared in the submission.
   iree_host_size_t command_buffer_count;
   iree_hal_command_buffer_t* command_buffers[];
@@ -204,8 +431,11 @@ static iree_status_t iree_hal_task_queue_issue_cmd(
   for (iree_host_size_t i = 0; i < cmd->command_buffer_count; ++i) {
     if (iree_hal_task_command_buffer_isa(cmd->command_buffers[i])) {
       status = iree_hal_task_command_buffer_issue(
-          cmd->command_buffers[i], &cmd->queue->state,
-          cmd->task.header.completion_task, cmd->arena, pending_submission);
+          cmd->command_buffers[i],
+          cmd->binding_tables ? cmd->binding_tables[i]
+                              : iree_hal_buffer_binding_table_empty(),
+          &cmd->queue->state, cmd->task.header.completion_task, cmd->arena,
+          pending_submission);
       iree_hal_command_buffer_release(cmd->command_buffers[i]);
       cmd->command_buffers[i] = NULL;
     } else {
@@ -243,6 +473,7 @@ static iree_status_t iree_hal_task_queue_issue_cmd_allocate(
     iree_task_scope_t* scope, iree_hal_task_queue_t* queue,
     iree_task_t* retire_task, iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables,
     iree_arena_allocator_t* arena, iree_hal_task_queue_issue_cmd_t** out_cmd) {
   iree_hal_task_queue_issue_cmd_t* cmd = NULL;
   iree_host_size_t total_cmd_size =
@@ -258,6 +489,28 @@ static iree_status_t iree_hal_task_queue_issue_cmd_allocate(
   cmd->arena = arena;
   cmd->queue = queue;
 
+  // Clone the binding tables as the caller's storage is only valid for the
+  // duration of the submit call. The buffers are retained by the retire
+  // command.
+  cmd->binding_tables = NULL;
+  if (binding_tables) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        arena, command_buffer_count * sizeof(*cmd->binding_tables),
+        (void**)&cmd->binding_tables));
+    for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+      iree_hal_buffer_binding_table_t* binding_table = &cmd->binding_tables[i];
+      binding_table->count = binding_tables[i].count;
+      binding_table->bindings = NULL;
+      if (binding_table->count == 0) continue;
+      iree_hal_buffer_binding_t* bindings = NULL;
+      IREE_RETURN_IF_ERROR(iree_arena_allocate(
+          arena, binding_table->count * sizeof(*bindings), (void**)&bindings));
+      memcpy(bindings, binding_tables[i].bindings,
+             binding_table->count * sizeof(*bindings));
+      binding_table->bindings = bindings;
+    }
+  }
+
   cmd->command_buffer_count = command_buffer_count;
   for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
     cmd->command_buffers[i] = command_buffers[i];
@@ -288,6 +541,9 @@ typedef struct iree_hal_task_queue_retire_cmd_t {
   // A list of semaphores to signal upon retiring.
   iree_hal_semaphore_list_t signal_semaphores;
 
+  // Wait command of the submission, if any, with chains to retire.
+  iree_hal_task_queue_wait_cmd_t* wait_cmd;
+
   // Resources retained until all have retired.
   // We could release them earlier but that would require tracking individual
   // resource-level completion.
@@ -356,6 +612,13 @@ static void iree_hal_task_queue_retire_cmd_cleanup(
   // Release all semaphores.
   iree_hal_semaphore_list_release(&cmd->signal_semaphores);
 
+  // Stop tracking the waits of the submission before the arena holding them
+  // is dropped.
+  if (cmd->wait_cmd) {
+    iree_hal_task_queue_wait_cmd_retire_chains(cmd->wait_cmd);
+    cmd->wait_cmd = NULL;
+  }
+
   // Drop all memory used by the submission (**including cmd**).
   iree_arena_allocator_t arena = cmd->arena;
   cmd = NULL;
@@ -368,11 +631,21 @@ static void iree_hal_task_queue_retire_cmd_cleanup(
 // The command will own an arena that can be used for other submission-related
 // allocations.
 static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
-    iree_task_scope_t* scope, iree_host_size_t resource_count,
-    iree_hal_resource_t* const* resources,
+    iree_task_scope_t* scope, iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables,
     const iree_hal_semaphore_list_t* signal_semaphores,
     iree_arena_block_pool_t* block_pool,
     iree_hal_task_queue_retire_cmd_t** out_cmd) {
+  // Command buffers and all buffers referenced by their binding tables are
+  // retained until the submission retires.
+  iree_host_size_t resource_count = command_buffer_count;
+  if (binding_tables) {
+    for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+      resource_count += binding_tables[i].count;
+    }
+  }
+
   // Make an arena we'll use for allocating the command itself.
   iree_arena_allocator_t arena;
   iree_arena_initialize(block_pool, &arena);
@@ -389,6 +662,7 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
         &cmd->task);
     iree_task_set_cleanup_fn(&cmd->task.header,
                              iree_hal_task_queue_retire_cmd_cleanup);
+    cmd->wait_cmd = NULL;
   }
 
   // Clone the signal semaphores from the batch - we retain them and their
@@ -402,10 +676,24 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
     // Transfer ownership of the arena to command.
     memcpy(&cmd->arena, &arena, sizeof(cmd->arena));
 
-    // Retain command buffers.
-    cmd->resource_count = resource_count;
-    for (iree_host_size_t i = 0; i < resource_count; ++i) {
-      cmd->resources[i] = resources[i];
+    // Retain command buffers and binding table buffers.
+    iree_host_size_t resource_index = 0;
+    for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+      cmd->resources[resource_index++] =
+          (iree_hal_resource_t*)command_buffers[i];
+    }
+    if (binding_tables) {
+      for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+        for (iree_host_size_t j = 0; j < binding_tables[i].count; ++j) {
+          iree_hal_buffer_t* buffer = binding_tables[i].bindings[j].buffer;
+          if (buffer) {
+            cmd->resources[resource_index++] = (iree_hal_resource_t*)buffer;
+          }
+        }
+      }
+    }
+    cmd->resource_count = resource_index;
+    for (iree_host_size_t i = 0; i < cmd->resource_count; ++i) {
       iree_hal_resource_retain(cmd->resources[i]);
     }
 
@@ -423,7 +711,9 @@ static iree_status_t iree_hal_task_queue_retire_cmd_allocate(
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
                                     iree_task_scope_flags_t scope_flags,
                                     iree_task_executor_t* executor,
-                                    iree_arena_block_pool_t* block_pool,
+                                    iree_host_size_t small_block_size,
+                                    iree_host_size_t large_block_size,
+                                    iree_allocator_t host_allocator,
                                     iree_hal_task_queue_t* out_queue) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, identifier.data, identifier.size);
@@ -432,31 +722,96 @@ void iree_hal_task_queue_initialize(iree_string_view_t identifier,
 
   out_queue->executor = executor;
   iree_task_executor_retain(out_queue->executor);
-  out_queue->block_pool = block_pool;
+
+  // NOTE: the topology node ID maps directly to the allocator node ID.
+  iree_allocator_node_id_t node_id =
+      (iree_allocator_node_id_t)iree_task_executor_node_id(executor);
+  iree_arena_block_pool_initialize_on_node(small_block_size, node_id,
+                                           host_allocator,
+                                           &out_queue->small_block_pool);
+  iree_arena_block_pool_initialize_on_node(large_block_size, node_id,
+                                           host_allocator,
+                                           &out_queue->large_block_pool);
 
   iree_task_scope_initialize(identifier, scope_flags, &out_queue->scope);
 
   iree_hal_task_queue_state_initialize(&out_queue->state);
 
+  iree_slim_mutex_initialize(&out_queue->wait_mutex);
+  out_queue->wait_list_head = NULL;
+  out_queue->wait_list_closed = false;
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Cancels all semaphore waits still pending on the queue. Submissions waiting
+// on semaphores that will never be signaled would otherwise keep the queue from
+// going idle and leave timepoints referencing freed submission memory. The
+// cancelled submissions are aborted and fail their signal semaphores.
+static void iree_hal_task_queue_cancel_waits(iree_hal_task_queue_t* queue) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Claim all pending chains under the lock. Claimed chains hold a dependency
+  // on their issue task so their submissions cannot retire (and unlink) until
+  // we release them below. Cancelling the timepoints must happen outside of the
+  // lock as timepoint callbacks may retire submissions that take it.
+  iree_hal_task_queue_wait_chain_t* cancelled_head = NULL;
+  iree_slim_mutex_lock(&queue->wait_mutex);
+  queue->wait_list_closed = true;
+  for (iree_hal_task_queue_wait_cmd_t* cmd = queue->wait_list_head; cmd;
+       cmd = cmd->next) {
+    for (iree_host_size_t i = 0; i < cmd->wait_semaphores.count; ++i) {
+      iree_hal_task_queue_wait_chain_t* chain = &cmd->chains[i];
+      if (!chain->semaphore) continue;
+      if (iree_hal_task_queue_wait_chain_try_claim(chain)) {
+        chain->next_cancelled = cancelled_head;
+        cancelled_head = chain;
+      }
+    }
+  }
+  iree_slim_mutex_unlock(&queue->wait_mutex);
+
+  if (cancelled_head) {
+    // Fail the scope first so that issue tasks released below are discarded.
+    iree_task_scope_fail(
+        &queue->scope,
+        iree_make_status(IREE_STATUS_ABORTED,
+                         "queue deinitialized while submissions were waiting "
+                         "on unsignaled semaphores"));
+  }
+  while (cancelled_head) {
+    iree_hal_task_queue_wait_chain_t* chain = cancelled_head;
+    cancelled_head = chain->next_cancelled;
+    iree_hal_task_queue_wait_chain_cancel(chain);
+  }
+
   IREE_TRACE_ZONE_END(z0);
 }
 
 void iree_hal_task_queue_deinitialize(iree_hal_task_queue_t* queue) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_task_queue_cancel_waits(queue);
   iree_status_ignore(
       iree_task_scope_wait_idle(&queue->scope, IREE_TIME_INFINITE_FUTURE));
 
+  IREE_ASSERT(!queue->wait_list_head);
+  iree_slim_mutex_deinitialize(&queue->wait_mutex);
   iree_hal_task_queue_state_deinitialize(&queue->state);
   iree_task_scope_deinitialize(&queue->scope);
   iree_task_executor_release(queue->executor);
 
+  iree_arena_block_pool_deinitialize(&queue->large_block_pool);
+  iree_arena_block_pool_deinitialize(&queue->small_block_pool);
+
   IREE_TRACE_ZONE_END(z0);
 }
 
 void iree_hal_task_queue_trim(iree_hal_task_queue_t* queue) {
   IREE_ASSERT_ARGUMENT(queue);
   iree_task_executor_trim(queue->executor);
+  iree_arena_block_pool_trim(&queue->small_block_pool);
+  iree_arena_block_pool_trim(&queue->large_block_pool);
 }
 
 static iree_status_t iree_hal_task_queue_submit_batch(
@@ -466,9 +821,9 @@ static iree_status_t iree_hal_task_queue_submit_batch(
   // arena which we will use to allocate all other commands.
   iree_hal_task_queue_retire_cmd_t* retire_cmd = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_task_queue_retire_cmd_allocate(
-      &queue->scope, batch->command_buffer_count,
-      (iree_hal_resource_t* const*)batch->command_buffers,
-      &batch->signal_semaphores, queue->block_pool, &retire_cmd));
+      &queue->scope, batch->command_buffer_count, batch->command_buffers,
+      batch->binding_tables, &batch->signal_semaphores,
+      &queue->small_block_pool, &retire_cmd));
 
   // NOTE: if we fail from here on we must drop the retire_cmd arena.
   iree_status_t status = iree_ok_status();
@@ -486,7 +841,8 @@ static iree_status_t iree_hal_task_queue_submit_batch(
   iree_hal_task_queue_wait_cmd_t* wait_cmd = NULL;
   if (iree_status_is_ok(status) && batch->wait_semaphores.count > 0) {
     status = iree_hal_task_queue_wait_cmd_allocate(
-        &queue->scope, &batch->wait_semaphores, &retire_cmd->arena, &wait_cmd);
+        &queue->scope, queue, &batch->wait_semaphores, &retire_cmd->arena,
+        &wait_cmd);
   }
 
   // Task to issue all the command buffers in the batch.
@@ -496,8 +852,8 @@ static iree_status_t iree_hal_task_queue_submit_batch(
   if (iree_status_is_ok(status) && batch->command_buffer_count > 0) {
     status = iree_hal_task_queue_issue_cmd_allocate(
         &queue->scope, queue, &retire_cmd->task.header,
-        batch->command_buffer_count, batch->command_buffers, &retire_cmd->arena,
-        &issue_cmd);
+        batch->command_buffer_count, batch->command_buffers,
+        batch->binding_tables, &retire_cmd->arena, &issue_cmd);
   }
 
   // Last chance for failure - from here on we are submitting.
@@ -505,6 +861,7 @@ static iree_status_t iree_hal_task_queue_submit_batch(
     iree_arena_deinitialize(&retire_cmd->arena);
     return status;
   }
+  retire_cmd->wait_cmd = wait_cmd;
 
   iree_task_submission_t submission;
   iree_task_submission_initialize(&submission);
@@ -26,8 +26,15 @@ typedef struct iree_hal_task_queue_t {
   // Shared executor that the queue submits tasks to.
   iree_task_executor_t* executor;
 
-  // Shared block pool for allocating submission transients (tasks/events/etc).
-  iree_arena_block_pool_t* block_pool;
+  // Block pool used for small allocations like tasks and submissions.
+  // Blocks are bound to the NUMA node of the executor so that the workers
+  // processing the submissions access node-local memory.
+  iree_arena_block_pool_t small_block_pool;
+
+  // Block pool used for command buffers recorded for execution on the queue
+  // with a larger block size (as command buffers can contain inlined data
+  // uploads). Bound to the NUMA node of the executor.
+  iree_arena_block_pool_t large_block_pool;
 
   // Scope used for all tasks in the queue.
   // This allows for easy waits on all outstanding queue tasks as well as
@@ -37,12 +44,28 @@ typedef struct iree_hal_task_queue_t {
   // The intra-queue synchronization (barriers/events) carries across command
   // buffers and this is used to rendezvous the tasks in each set.
   iree_hal_task_queue_state_t state;
+
+  // Guards the list of submissions with pending semaphore waits.
+  iree_slim_mutex_t wait_mutex;
+  // Submissions that chained their issue to semaphore timepoints that may not
+  // have resolved yet. The queue cancels these when it is deinitialized so
+  // that a later signal cannot touch the freed submission.
+  struct iree_hal_task_queue_wait_cmd_t* wait_list_head
+      IREE_GUARDED_BY(wait_mutex);
+  // True once the queue has begun deinitializing and will no longer accept
+  // new semaphore waits.
+  bool wait_list_closed IREE_GUARDED_BY(wait_mutex);
 } iree_hal_task_queue_t;
 
+// Initializes |out_queue| to submit work to |executor|. Block pools with
+// |small_block_size| and |large_block_size| are allocated from
+// |host_allocator| and bound to the NUMA node of the executor, if any.
 void iree_hal_task_queue_initialize(iree_string_view_t identifier,
                                     iree_task_scope_flags_t scope_flags,
                                     iree_task_executor_t* executor,
-                                    iree_arena_block_pool_t* block_pool,
+                                    iree_host_size_t small_block_size,
+                                    iree_host_size_t large_block_size,
+                                    iree_allocator_t host_allocator,
                                     iree_hal_task_queue_t* out_queue);
 
 void iree_hal_task_queue_deinitialize(iree_hal_task_queue_t* queue);
@@ -0,0 +1,245 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_queue.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_semaphore.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+class TaskQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/2,
+                                                   &topology);
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    IREE_ASSERT_OK(iree_task_executor_create(
+        options, &topology, iree_allocator_system(), &executor_));
+    iree_task_topology_deinitialize(&topology);
+
+    for (int i = 0; i < 2; ++i) {
+      iree_hal_task_queue_initialize(
+          iree_make_cstring_view("queue"), IREE_TASK_SCOPE_FLAG_NONE,
+          executor_, /*small_block_size=*/4 * 1024,
+          /*large_block_size=*/64 * 1024, iree_allocator_system(), &queues_[i]);
+      queue_live_[i] = true;
+    }
+  }
+
+  void TearDown() override {
+    for (int i = 0; i < 2; ++i) DeinitializeQueue(i);
+    iree_task_executor_release(executor_);
+  }
+
+  void DeinitializeQueue(int i) {
+    if (!queue_live_[i]) return;
+    iree_hal_task_queue_deinitialize(&queues_[i]);
+    queue_live_[i] = false;
+  }
+
+  iree_hal_semaphore_t* CreateSemaphore(uint64_t initial_value) {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_CHECK_OK(iree_hal_task_semaphore_create(
+        iree_task_executor_event_pool(executor_), initial_value,
+        iree_allocator_system(), &semaphore));
+    return semaphore;
+  }
+
+  // Submits a batch with no command buffers to queue |i|.
+  iree_status_t Submit(int i, iree_hal_semaphore_list_t wait_semaphores,
+                       iree_hal_semaphore_list_t signal_semaphores) {
+    iree_hal_submission_batch_t batch = {
+        wait_semaphores, 0, NULL, signal_semaphores, NULL,
+    };
+    return iree_hal_task_queue_submit(&queues_[i], 1, &batch);
+  }
+
+  uint64_t QuerySemaphore(iree_hal_semaphore_t* semaphore) {
+    uint64_t value = 0;
+    IREE_CHECK_OK(iree_hal_semaphore_query(semaphore, &value));
+    return value;
+  }
+
+  // Expects that |semaphore| is not signaled after a short wait. This gives
+  // the queue time to chain any pending waits of prior submissions.
+  void ExpectPending(iree_hal_semaphore_t* semaphore) {
+    EXPECT_THAT(Status(iree_hal_semaphore_wait(semaphore, 1,
+                                               iree_make_timeout_ms(10))),
+                StatusIs(StatusCode::kDeadlineExceeded));
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_hal_task_queue_t queues_[2];
+  bool queue_live_[2] = {false, false};
+};
+
+// Tests that a submission waiting on a semaphore signaled by another queue is
+// issued once the other queue signals it.
+TEST_F(TaskQueueTest, CrossQueueWait) {
+  iree_hal_semaphore_t* semaphore_a = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore_b = CreateSemaphore(0);
+  uint64_t value = 1;
+  iree_hal_semaphore_list_t list_a = {1, &semaphore_a, &value};
+  iree_hal_semaphore_list_t list_b = {1, &semaphore_b, &value};
+
+  // Queue 1 waits on a signal from queue 0 that has not been submitted yet.
+  IREE_ASSERT_OK(Submit(1, list_a, list_b));
+  ExpectPending(semaphore_b);
+
+  IREE_ASSERT_OK(Submit(0, iree_hal_semaphore_list_empty(), list_a));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore_b, 1, iree_infinite_timeout()));
+  EXPECT_EQ(1, QuerySemaphore(semaphore_a));
+
+  IREE_EXPECT_OK(iree_hal_task_queue_wait_idle(&queues_[0],
+                                               iree_infinite_timeout()));
+  IREE_EXPECT_OK(iree_hal_task_queue_wait_idle(&queues_[1],
+                                               iree_infinite_timeout()));
+  iree_hal_semaphore_release(semaphore_a);
+  iree_hal_semaphore_release(semaphore_b);
+}
+
+// Tests that a wait semaphore failing while a submission waits on it aborts the
+// submission and fails its signal semaphores instead of signaling them.
+TEST_F(TaskQueueTest, WaitSemaphoreFailure) {
+  iree_hal_semaphore_t* semaphore_a = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore_b = CreateSemaphore(0);
+  uint64_t value = 1;
+  iree_hal_semaphore_list_t list_a = {1, &semaphore_a, &value};
+  iree_hal_semaphore_list_t list_b = {1, &semaphore_b, &value};
+
+  IREE_ASSERT_OK(Submit(0, list_a, list_b));
+  ExpectPending(semaphore_b);
+  iree_hal_semaphore_fail(semaphore_a,
+                          iree_make_status(IREE_STATUS_DATA_LOSS, "whoops!"));
+
+  EXPECT_THAT(Status(iree_hal_semaphore_wait(semaphore_b, 1,
+                                             iree_infinite_timeout())),
+              StatusIs(StatusCode::kAborted));
+  IREE_EXPECT_OK(iree_hal_task_queue_wait_idle(&queues_[0],
+                                               iree_infinite_timeout()));
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&queues_[0].scope)),
+              StatusIs(StatusCode::kDataLoss));
+
+  iree_hal_semaphore_release(semaphore_a);
+  iree_hal_semaphore_release(semaphore_b);
+}
+
+// Tests that waiting on an unsignaled and a failed semaphore in the same
+// submission aborts it and cancels the timepoint on the unsignaled one.
+TEST_F(TaskQueueTest, SubmissionAbortCancelsWaits) {
+  iree_hal_semaphore_t* semaphore_a = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore_b = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore_c = CreateSemaphore(0);
+  iree_hal_semaphore_fail(semaphore_c,
+                          iree_make_status(IREE_STATUS_DATA_LOSS, "whoops!"));
+  iree_hal_semaphore_t* wait_semaphores[] = {semaphore_a, semaphore_c};
+  uint64_t wait_values[] = {1, 1};
+  iree_hal_semaphore_list_t wait_list = {2, wait_semaphores, wait_values};
+  uint64_t value = 1;
+  iree_hal_semaphore_list_t list_b = {1, &semaphore_b, &value};
+
+  IREE_ASSERT_OK(Submit(0, wait_list, list_b));
+  EXPECT_THAT(Status(iree_hal_semaphore_wait(semaphore_b, 1,
+                                             iree_infinite_timeout())),
+              StatusIs(StatusCode::kAborted));
+  IREE_EXPECT_OK(iree_hal_task_queue_wait_idle(&queues_[0],
+                                               iree_infinite_timeout()));
+
+  // The submission memory has been released; signaling must not reach it.
+  IREE_EXPECT_OK(iree_hal_semaphore_signal(semaphore_a, 1));
+
+  iree_hal_semaphore_release(semaphore_a);
+  iree_hal_semaphore_release(semaphore_b);
+  iree_hal_semaphore_release(semaphore_c);
+}
+
+// Tests that deinitializing a queue with a submission waiting on a semaphore
+// that is never signaled aborts the submission instead of hanging and that a
+// later signal does not touch the released submission.
+TEST_F(TaskQueueTest, DeinitializeWithPendingWait) {
+  iree_hal_semaphore_t* semaphore_a = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore_b = CreateSemaphore(0);
+  uint64_t value = 1;
+  iree_hal_semaphore_list_t list_a = {1, &semaphore_a, &value};
+  iree_hal_semaphore_list_t list_b = {1, &semaphore_b, &value};
+
+  IREE_ASSERT_OK(Submit(0, list_a, list_b));
+  ExpectPending(semaphore_b);
+  DeinitializeQueue(0);
+
+  EXPECT_THAT(Status(iree_hal_semaphore_wait(semaphore_b, 1,
+                                             iree_infinite_timeout())),
+              StatusIs(StatusCode::kAborted));
+  IREE_EXPECT_OK(iree_hal_semaphore_signal(semaphore_a, 1));
+
+  iree_hal_semaphore_release(semaphore_a);
+  iree_hal_semaphore_release(semaphore_b);
+}
+
+// Tests several host waiters and queue waits on the same semaphore value,
+// which all share one timepoint. One host waiter times out before the value is
+// signaled and must not tear down the timepoint for the others.
+TEST_F(TaskQueueTest, SharedWaitWithTimeout) {
+  iree_hal_semaphore_t* semaphore_a = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore_b = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore_c = CreateSemaphore(0);
+  uint64_t value = 1;
+  iree_hal_semaphore_list_t list_a = {1, &semaphore_a, &value};
+  iree_hal_semaphore_list_t list_b = {1, &semaphore_b, &value};
+  iree_hal_semaphore_list_t list_c = {1, &semaphore_c, &value};
+
+  std::vector<std::thread> waiters;
+  for (int i = 0; i < 3; ++i) {
+    waiters.emplace_back([&]() {
+      IREE_EXPECT_OK(
+          iree_hal_semaphore_wait(semaphore_a, 1, iree_infinite_timeout()));
+    });
+  }
+  IREE_ASSERT_OK(Submit(0, list_a, list_b));
+  IREE_ASSERT_OK(Submit(1, list_a, list_c));
+
+  std::thread timed_waiter([&]() {
+    EXPECT_THAT(Status(iree_hal_semaphore_wait(semaphore_a, 1,
+                                               iree_make_timeout_ms(50))),
+                StatusIs(StatusCode::kDeadlineExceeded));
+  });
+  timed_waiter.join();
+  ExpectPending(semaphore_b);
+  ExpectPending(semaphore_c);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore_a, 1));
+  for (auto& waiter : waiters) waiter.join();
+  IREE_EXPECT_OK(
+      iree_hal_semaphore_wait(semaphore_b, 1, iree_infinite_timeout()));
+  IREE_EXPECT_OK(
+      iree_hal_semaphore_wait(semaphore_c, 1, iree_infinite_timeout()));
+
+  IREE_EXPECT_OK(iree_hal_task_queue_wait_idle(&queues_[0],
+                                               iree_infinite_timeout()));
+  IREE_EXPECT_OK(iree_hal_task_queue_wait_idle(&queues_[1],
+                                               iree_infinite_timeout()));
+  iree_hal_semaphore_release(semaphore_a);
+  iree_hal_semaphore_release(semaphore_b);
+  iree_hal_semaphore_release(semaphore_c);
+}
+
+}  // namespace
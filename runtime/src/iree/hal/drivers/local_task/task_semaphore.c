@@ -21,14 +21,26 @@
 
 // Represents a point in the timeline that someone is waiting to be reached.
 // When the semaphore is signaled to at least the specified value then the
-// given event will be signaled and the timepoint discarded.
+// given event will be signaled. The event remains signaled until the last
+// waiter releases the timepoint.
 //
-// Instances are owned and retained by the caller that requested them - usually
-// in the arena associated with the submission, but could be on the stack of a
-// synchronously waiting thread.
+// Timepoints are shared by all waiters on the same semaphore value so that
+// many waiters (such as every submission waiting on the same fence) only need
+// a single event and a single entry in the semaphore timepoint list. Instances
+// are heap allocated, reference counted by their waiters, and tracked by the
+// semaphore in its shared timepoint list.
 typedef struct iree_hal_task_timepoint_t {
   iree_hal_semaphore_timepoint_t base;
-  iree_hal_semaphore_t* semaphore;
+  // Semaphore the timepoint was acquired from. Not retained.
+  struct iree_hal_task_semaphore_t* semaphore;
+  // Next timepoint in the semaphore shared timepoint list.
+  struct iree_hal_task_timepoint_t* next;
+  // Value the timepoint is waiting for.
+  uint64_t minimum_value;
+  // Number of waiters that have acquired the timepoint and not yet released it.
+  // Guarded by the semaphore mutex.
+  iree_host_size_t waiter_count;
+  // Event signaled when the timepoint is reached or the semaphore fails.
   iree_event_t event;
 } iree_hal_task_timepoint_t;
 
@@ -63,6 +75,11 @@ typedef struct iree_hal_task_semaphore_t {
 
   // OK or the status passed to iree_hal_semaphore_fail. Owned by the semaphore.
   iree_status_t failure_status;
+
+  // Timepoints with at least one waiter. Waiters on a value that already has a
+  // timepoint share it instead of acquiring their own. Since each timepoint
+  // retains the semaphore until reached the list is always empty on destroy.
+  iree_hal_task_timepoint_t* timepoint_list;
 } iree_hal_task_semaphore_t;
 
 static const iree_hal_semaphore_vtable_t iree_hal_task_semaphore_vtable;
@@ -92,7 +109,9 @@ iree_status_t iree_hal_task_semaphore_create(
 
     iree_slim_mutex_initialize(&semaphore->mutex);
     semaphore->current_value = initial_value;
+    iree_hal_semaphore_publish_value(&semaphore->base, initial_value);
     semaphore->failure_status = iree_ok_status();
+    semaphore->timepoint_list = NULL;
 
     *out_semaphore = &semaphore->base;
   }
@@ -127,6 +146,15 @@ static iree_status_t iree_hal_task_semaphore_query(
   iree_hal_task_semaphore_t* semaphore =
       iree_hal_task_semaphore_cast(base_semaphore);
 
+  // Fast path: the published value is updated under the mutex along with
+  // |current_value| and only failures need the lock to clone the status.
+  const uint64_t published_value =
+      iree_hal_semaphore_load_published_value(base_semaphore);
+  if (IREE_LIKELY(published_value < IREE_HAL_SEMAPHORE_FAILURE_VALUE)) {
+    *out_value = published_value;
+    return iree_ok_status();
+  }
+
   iree_slim_mutex_lock(&semaphore->mutex);
 
   *out_value = semaphore->current_value;
@@ -159,6 +187,7 @@ static iree_status_t iree_hal_task_semaphore_signal(
   }
 
   semaphore->current_value = new_value;
+  iree_hal_semaphore_publish_value(&semaphore->base, new_value);
 
   iree_slim_mutex_unlock(&semaphore->mutex);
 
@@ -188,6 +217,8 @@ static void iree_hal_task_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
   // Signal to our failure sentinel value.
   semaphore->current_value = IREE_HAL_SEMAPHORE_FAILURE_VALUE;
   semaphore->failure_status = status;
+  iree_hal_semaphore_publish_value(&semaphore->base,
+                                   IREE_HAL_SEMAPHORE_FAILURE_VALUE);
 
   iree_slim_mutex_unlock(&semaphore->mutex);
 
@@ -196,81 +227,105 @@ static void iree_hal_task_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
                             status_code);
 }
 
-// Acquires a timepoint waiting for the given value.
-// |out_timepoint| is owned by the caller and must be kept live until the
-// timepoint has been reached (or it is cancelled by the caller).
+// Acquires a timepoint waiting for the given value, sharing an existing one if
+// another waiter is already waiting for the same value. The semaphore mutex
+// must be held by the caller. The timepoint has no deadline and callers must
+// handle their own timeouts when waiting on its event.
+// |out_timepoint| must be released with
+// iree_hal_task_semaphore_release_timepoint once the caller is done with it.
 static iree_status_t iree_hal_task_semaphore_acquire_timepoint(
     iree_hal_task_semaphore_t* semaphore, uint64_t minimum_value,
-    iree_timeout_t timeout, iree_hal_task_timepoint_t* out_timepoint) {
-  IREE_RETURN_IF_ERROR(
-      iree_event_pool_acquire(semaphore->event_pool, 1, &out_timepoint->event));
-  out_timepoint->semaphore = &semaphore->base;
+    iree_hal_task_timepoint_t** out_timepoint) {
+  *out_timepoint = NULL;
+
+  // Fast path: share an existing timepoint for the same value.
+  for (iree_hal_task_timepoint_t* timepoint = semaphore->timepoint_list;
+       timepoint != NULL; timepoint = timepoint->next) {
+    if (timepoint->minimum_value == minimum_value) {
+      ++timepoint->waiter_count;
+      *out_timepoint = timepoint;
+      return iree_ok_status();
+    }
+  }
+
+  // Slow path: create a new timepoint and register it with the semaphore.
+  iree_hal_task_timepoint_t* timepoint = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      semaphore->host_allocator, sizeof(*timepoint), (void**)&timepoint));
+  iree_status_t status =
+      iree_event_pool_acquire(semaphore->event_pool, 1, &timepoint->event);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(semaphore->host_allocator, timepoint);
+    return status;
+  }
+  timepoint->semaphore = semaphore;
+  timepoint->minimum_value = minimum_value;
+  timepoint->waiter_count = 1;
+  timepoint->next = semaphore->timepoint_list;
+  semaphore->timepoint_list = timepoint;
   iree_hal_semaphore_acquire_timepoint(
-      &semaphore->base, minimum_value, timeout,
+      &semaphore->base, minimum_value, iree_infinite_timeout(),
       (iree_hal_semaphore_callback_t){
           .fn = iree_hal_task_semaphore_timepoint_callback,
-          .user_data = out_timepoint,
+          .user_data = timepoint,
       },
-      &out_timepoint->base);
+      &timepoint->base);
+
+  *out_timepoint = timepoint;
   return iree_ok_status();
 }
 
-typedef struct iree_hal_task_semaphore_wait_cmd_t {
-  iree_task_wait_t task;
-  iree_hal_task_semaphore_t* semaphore;
-  iree_hal_task_timepoint_t timepoint;
-} iree_hal_task_semaphore_wait_cmd_t;
-
-// Cleans up a wait task by returning the event used to the pool and - if the
-// task failed - ensuring we scrub it from the timepoint list.
-static void iree_hal_task_semaphore_wait_cmd_cleanup(
-    iree_task_t* task, iree_status_code_t status_code) {
-  iree_hal_task_semaphore_wait_cmd_t* cmd =
-      (iree_hal_task_semaphore_wait_cmd_t*)task;
-  if (IREE_UNLIKELY(status_code != IREE_STATUS_OK)) {
-    // Abort the timepoint. Note that this is not designed to be fast as
-    // semaphore failure is an exceptional case.
-    iree_hal_semaphore_cancel_timepoint(&cmd->semaphore->base,
-                                        &cmd->timepoint.base);
+// Releases a waiter reference to |timepoint| acquired with
+// iree_hal_task_semaphore_acquire_timepoint. When the last waiter releases the
+// timepoint it is cancelled (if not yet reached) and its event is returned to
+// the pool. The semaphore mutex must not be held by the caller.
+static void iree_hal_task_semaphore_release_timepoint(
+    iree_hal_task_timepoint_t* timepoint) {
+  iree_hal_task_semaphore_t* semaphore = timepoint->semaphore;
+  iree_slim_mutex_lock(&semaphore->mutex);
+  bool is_last_waiter = --timepoint->waiter_count == 0;
+  if (is_last_waiter) {
+    iree_hal_task_timepoint_t** prev_next = &semaphore->timepoint_list;
+    while (*prev_next != timepoint) prev_next = &(*prev_next)->next;
+    *prev_next = timepoint->next;
   }
-  iree_event_pool_release(cmd->semaphore->event_pool, 1, &cmd->timepoint.event);
-  iree_hal_semaphore_release((iree_hal_semaphore_t*)cmd->semaphore);
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  if (!is_last_waiter) return;
+
+  // Now unreachable by other waiters. Cancelling is a no-op if the timepoint
+  // has already been reached. Note that this may drop the last reference to
+  // the semaphore held by the timepoint and callers must hold their own.
+  iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint->base);
+  iree_event_pool_release(semaphore->event_pool, 1, &timepoint->event);
+  iree_allocator_free(semaphore->host_allocator, timepoint);
 }
 
 iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
     iree_hal_semaphore_t* base_semaphore, uint64_t minimum_value,
-    iree_task_t* issue_task, iree_arena_allocator_t* arena,
-    iree_task_submission_t* submission) {
+    iree_hal_semaphore_callback_t callback,
+    iree_hal_semaphore_timepoint_t* out_timepoint, bool* out_acquired) {
   iree_hal_task_semaphore_t* semaphore =
       iree_hal_task_semaphore_cast(base_semaphore);
+  *out_acquired = false;
 
   iree_slim_mutex_lock(&semaphore->mutex);
 
   iree_status_t status = iree_ok_status();
-  if (semaphore->current_value >= minimum_value) {
-    // Fast path: already satisfied.
-  } else if (!iree_status_is_ok(semaphore->failure_status)) {
+  if (!iree_status_is_ok(semaphore->failure_status)) {
     // Semaphore failed; can't enqueue timepoints (they'll reject immediately).
+    // Checked first as the failure value compares as reaching any payload.
     status = iree_status_clone(semaphore->failure_status);
+  } else if (semaphore->current_value >= minimum_value) {
+    // Fast path: already satisfied.
   } else {
-    // Slow path: acquire a system wait handle and perform a full wait.
-    iree_hal_task_semaphore_wait_cmd_t* cmd = NULL;
-    status = iree_arena_allocate(arena, sizeof(*cmd), (void**)&cmd);
-    if (iree_status_is_ok(status)) {
-      status = iree_hal_task_semaphore_acquire_timepoint(
-          semaphore, minimum_value, iree_infinite_timeout(), &cmd->timepoint);
-    }
-    if (iree_status_is_ok(status)) {
-      iree_task_wait_initialize(issue_task->scope,
-                                iree_event_await(&cmd->timepoint.event),
-                                IREE_TIME_INFINITE_FUTURE, &cmd->task);
-      iree_task_set_cleanup_fn(&cmd->task.header,
-                               iree_hal_task_semaphore_wait_cmd_cleanup);
-      iree_task_set_completion_task(&cmd->task.header, issue_task);
-      cmd->semaphore = semaphore;
-      iree_hal_semaphore_retain(base_semaphore);
-      iree_task_submission_enqueue(submission, &cmd->task.header);
-    }
+    // Slow path: acquire the timepoint while holding the lock so that a signal
+    // cannot land between the check above and the registration. Callbacks are
+    // never made from within the acquisition but may be made from another
+    // thread as soon as we unlock.
+    iree_hal_semaphore_acquire_timepoint(&semaphore->base, minimum_value,
+                                         iree_infinite_timeout(), callback,
+                                         out_timepoint);
+    *out_acquired = true;
   }
 
   iree_slim_mutex_unlock(&semaphore->mutex);
@@ -283,10 +338,18 @@ static iree_status_t iree_hal_task_semaphore_wait(
   iree_hal_task_semaphore_t* semaphore =
       iree_hal_task_semaphore_cast(base_semaphore);
 
+  // Fastest path: already satisfied without taking any locks.
+  const uint64_t published_value =
+      iree_hal_semaphore_load_published_value(base_semaphore);
+  if (published_value >= value &&
+      published_value < IREE_HAL_SEMAPHORE_FAILURE_VALUE) {
+    return iree_ok_status();
+  }
+
   iree_slim_mutex_lock(&semaphore->mutex);
 
   if (!iree_status_is_ok(semaphore->failure_status)) {
-    // Fastest path: failed; return an error to tell callers to query for it.
+    // Fast path: failed; return an error to tell callers to query for it.
     iree_slim_mutex_unlock(&semaphore->mutex);
     return iree_status_from_code(IREE_STATUS_ABORTED);
   } else if (semaphore->current_value >= value) {
@@ -302,21 +365,26 @@ static iree_status_t iree_hal_task_semaphore_wait(
   iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
 
   // Slow path: acquire a timepoint while we hold the lock.
-  iree_hal_task_timepoint_t timepoint;
-  iree_status_t status = iree_hal_task_semaphore_acquire_timepoint(
-      semaphore, value, timeout, &timepoint);
+  iree_hal_task_timepoint_t* timepoint = NULL;
+  iree_status_t status =
+      iree_hal_task_semaphore_acquire_timepoint(semaphore, value, &timepoint);
 
   iree_slim_mutex_unlock(&semaphore->mutex);
   if (IREE_UNLIKELY(!iree_status_is_ok(status))) return status;
 
   // Wait until the timepoint resolves.
-  // If satisfied the timepoint is automatically cleaned up and we are done. If
-  // the deadline is reached before satisfied then we have to clean it up.
-  status = iree_wait_one(&timepoint.event, deadline_ns);
-  if (!iree_status_is_ok(status)) {
-    iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint.base);
+  // If the deadline is reached before satisfied the timepoint stays live for
+  // any other waiters and is cleaned up when the last one releases it.
+  status = iree_wait_one(&timepoint->event, deadline_ns);
+  iree_hal_task_semaphore_release_timepoint(timepoint);
+
+  // The event is also set when the semaphore fails; report that the same way
+  // as the fast path above.
+  if (iree_status_is_ok(status) &&
+      iree_hal_semaphore_load_published_value(base_semaphore) >=
+          IREE_HAL_SEMAPHORE_FAILURE_VALUE) {
+    status = iree_status_from_code(IREE_STATUS_ABORTED);
   }
-  iree_event_pool_release(semaphore->event_pool, 1, &timepoint.event);
 
   return status;
 }
@@ -345,18 +413,16 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
       semaphore_list.count, iree_arena_allocator(&arena), &wait_set);
 
   // Acquire a wait handle for each semaphore timepoint we are to wait on.
-  // TODO(benvanik): flip this API around so we can batch request events from
-  // the event pool. We should be acquiring all required time points in one
-  // call.
+  // Timepoints (and their events) are shared with any other waiters on the
+  // same semaphore values.
   iree_host_size_t timepoint_count = 0;
-  iree_hal_task_timepoint_t* timepoints = NULL;
+  iree_hal_task_timepoint_t** timepoints = NULL;
   iree_host_size_t total_timepoint_size =
       semaphore_list.count * sizeof(timepoints[0]);
   bool needs_wait = true;
   status =
       iree_arena_allocate(&arena, total_timepoint_size, (void**)&timepoints);
   if (iree_status_is_ok(status)) {
-    memset(timepoints, 0, total_timepoint_size);
     for (iree_host_size_t i = 0; i < semaphore_list.count && needs_wait; ++i) {
       iree_hal_task_semaphore_t* semaphore =
           iree_hal_task_semaphore_cast(semaphore_list.semaphores[i]);
@@ -372,10 +438,11 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
         }
       } else {
         // Slow path: get a native wait handle for the timepoint.
-        iree_hal_task_timepoint_t* timepoint = &timepoints[timepoint_count++];
+        iree_hal_task_timepoint_t* timepoint = NULL;
         status = iree_hal_task_semaphore_acquire_timepoint(
-            semaphore, semaphore_list.payload_values[i], timeout, timepoint);
+            semaphore, semaphore_list.payload_values[i], &timepoint);
         if (iree_status_is_ok(status)) {
+          timepoints[timepoint_count++] = timepoint;
           status = iree_wait_set_insert(wait_set, timepoint->event);
         }
       }
@@ -393,14 +460,8 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
     }
   }
 
-  // TODO(benvanik): if we flip the API to multi-acquire events from the pool
-  // above then we can multi-release here too.
   for (iree_host_size_t i = 0; i < timepoint_count; ++i) {
-    iree_hal_semaphore_t* semaphore = timepoints[i].semaphore;
-    if (semaphore) {
-      iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i].base);
-      iree_event_pool_release(event_pool, 1, &timepoints[i].event);
-    }
+    iree_hal_task_semaphore_release_timepoint(timepoints[i]);
   }
   iree_wait_set_free(wait_set);
   iree_arena_deinitialize(&arena);
@@ -13,6 +13,7 @@
 #include "iree/base/internal/arena.h"
 #include "iree/base/internal/event_pool.h"
 #include "iree/hal/api.h"
+#include "iree/hal/utils/semaphore_base.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 
@@ -30,14 +31,16 @@ iree_status_t iree_hal_task_semaphore_create(
 bool iree_hal_task_semaphore_isa(iree_hal_semaphore_t* semaphore);
 
 // Reserves a new timepoint in the timeline for the given minimum payload value.
-// |issue_task| will wait until the timeline semaphore is signaled to at least
-// |minimum_value| before proceeding, with a possible wait task generated and
-// appended to the |submission|. Allocations for any intermediates will be made
-// from |arena| whose lifetime must be tied to the submission.
+// |callback| will be made when the timeline reaches at least |minimum_value| or
+// the semaphore fails. This allows queues to chain work directly to the signal
+// without a wait task parked in the executor poller. If the value has already
+// been reached |out_acquired| is set to false and no callback will be made.
+// Callers must keep |out_timepoint| live until the callback is made or they
+// cancel it with iree_hal_semaphore_cancel_timepoint.
 iree_status_t iree_hal_task_semaphore_enqueue_timepoint(
     iree_hal_semaphore_t* semaphore, uint64_t minimum_value,
-    iree_task_t* issue_task, iree_arena_allocator_t* arena,
-    iree_task_submission_t* submission);
+    iree_hal_semaphore_callback_t callback,
+    iree_hal_semaphore_timepoint_t* out_timepoint, bool* out_acquired);
 
 // Performs a multi-wait on one or more semaphores.
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if the wait does not complete before
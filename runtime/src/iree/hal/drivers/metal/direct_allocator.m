@@ -7,6 +7,7 @@
 #include "iree/hal/drivers/metal/direct_allocator.h"
 
 #import <Metal/Metal.h>
+#include <unistd.h>
 
 #include "iree/base/api.h"
 #include "iree/base/target_platform.h"
@@ -140,16 +141,14 @@ static iree_hal_buffer_compatibility_t iree_hal_metal_allocator_query_buffer_com
 
   if (iree_all_bits_set(params->type,
                         IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
-    // On iOS, we don't have device local + host visible memory. But given the unified memory
-    // architecture, it's fine to just request host local + device visible memory.
-    // On macOS, for unified memory architecture, it's similar to iOS. Otherwise, we can have
-    // device local + host visible memory backed by Managed storage mode.
+    // With a unified memory architecture (all iOS devices and Apple silicon Macs) the memory
+    // backing MTLStorageModeShared is both device local and host visible, so these buffers can be
+    // mapped directly without any staging copies. Shared storage is always coherent.
+    // Otherwise on macOS we can have device local + host visible memory backed by Managed storage
+    // mode that requires explicit synchronization.
     iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
     if (allocator->is_unified_memory) {
-      params->type &= ~(IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE);
-      params->type |= IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
-      // We have suggested other configurations than the original request. Mark accordingly.
-      compatibility |= IREE_HAL_BUFFER_COMPATIBILITY_LOW_PERFORMANCE;
+      params->type |= IREE_HAL_MEMORY_TYPE_HOST_COHERENT;
     }
   }
 
@@ -191,11 +190,10 @@ static MTLResourceOptions iree_hal_metal_select_resource_options(
   if (iree_all_bits_set(type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
     if (iree_all_bits_set(type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
       // Device local + host visible.
-      // iree_hal_metal_allocator_query_buffer_compatibility guarantees that we only fall into this
-      // case for macOS devices with non-uniform memory.
+      // Unified memory devices share the same physical memory between the CPU and GPU so the
+      // Shared storage mode is zero-copy; only macOS devices with non-uniform memory need Managed.
 #if defined(IREE_PLATFORM_MACOS)
-      IREE_ASSERT(!is_unified_memory);
-      options = MTLResourceStorageModeManaged;
+      options = is_unified_memory ? MTLResourceStorageModeShared : MTLResourceStorageModeManaged;
 #else
       options = MTLResourceStorageModeShared;
 #endif  // IREE_PLATFORM_MACOS
@@ -285,8 +283,9 @@ static iree_status_t iree_hal_metal_allocator_allocate_buffer(
   if (iree_status_is_ok(status)) {
     IREE_TRACE_ALLOC_NAMED(IREE_HAL_METAL_ALLOCATOR_ID, (void*)iree_hal_metal_buffer_handle(buffer),
                            allocation_size);
+    buffer->allocation_tag = compat_params.tag;
     IREE_STATISTICS(iree_hal_allocator_statistics_record_alloc(
-        &allocator->statistics, compat_params.type, allocation_size));
+        &allocator->statistics, compat_params.type, compat_params.tag, allocation_size));
     *out_buffer = buffer;
   } else {
     if (buffer) iree_hal_buffer_release(buffer);
@@ -307,7 +306,7 @@ static void iree_hal_metal_allocator_deallocate_buffer(
                         (void*)iree_hal_metal_buffer_handle(base_buffer));
   IREE_STATISTICS(iree_hal_allocator_statistics_record_free(
       &allocator->statistics, iree_hal_buffer_memory_type(base_buffer),
-      iree_hal_buffer_allocation_size(base_buffer)));
+      iree_hal_buffer_allocation_tag(base_buffer), iree_hal_buffer_allocation_size(base_buffer)));
 
   iree_hal_buffer_destroy(base_buffer);  // -1
 }
@@ -320,27 +319,56 @@ static iree_status_t iree_hal_metal_allocator_import_host_buffer(
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
 
-  // MTLResourceOptions options = iree_hal_metal_select_resource_options(
-  //     params->type, allocator->is_unified_memory, allocator->resource_tracking_mode);
-  MTLResourceOptions options = MTLResourceCPUCacheModeDefaultCache | MTLResourceStorageModeShared |
-                               MTLResourceHazardTrackingModeUntracked;
+  // newBufferWithBytesNoCopy wraps the host pages directly and requires both the pointer and the
+  // length to be page aligned. Anything else cannot be imported without a copy so we report the
+  // import as unavailable and let callers fall back to allocating and uploading.
+  void* host_ptr = external_buffer->handle.host_allocation.ptr;
+  const iree_host_size_t page_size = (iree_host_size_t)getpagesize();
+  if (!iree_host_size_has_alignment((iree_host_size_t)host_ptr, page_size) ||
+      !iree_host_size_has_alignment((iree_host_size_t)external_buffer->size, page_size)) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "host allocation import requires page-aligned memory (%" PRIhsz
+                            " bytes); ptr=%p, size=%" PRIdsz,
+                            page_size, host_ptr, external_buffer->size);
+  }
+
+  // Imported host memory is always backed by Shared storage and is coherent with the device. The
+  // CPU cache mode follows the requested memory type.
+  iree_hal_memory_type_t memory_type = params->type | IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+                                       IREE_HAL_MEMORY_TYPE_HOST_VISIBLE |
+                                       IREE_HAL_MEMORY_TYPE_HOST_COHERENT |
+                                       IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+  if (allocator->is_unified_memory) {
+    // Without a discrete GPU the host pages are also device local.
+    memory_type |= IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  }
+  MTLResourceOptions options = MTLResourceStorageModeShared;
+  options |= iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_CACHED)
+                 ? MTLResourceCPUCacheModeDefaultCache
+                 : MTLResourceCPUCacheModeWriteCombined;
+  options |=
+      allocator->resource_tracking_mode == IREE_HAL_METAL_RESOURCE_HAZARD_TRACKING_MODE_TRACKED
+          ? MTLResourceHazardTrackingModeTracked
+          : MTLResourceHazardTrackingModeUntracked;
 
   id<MTLBuffer> metal_buffer =
-      [allocator->device newBufferWithBytesNoCopy:external_buffer->handle.host_allocation.ptr
+      [allocator->device newBufferWithBytesNoCopy:host_ptr
                                            length:(NSUInteger)external_buffer->size
                                           options:options
                                       deallocator:nil];  // +1
   if (!metal_buffer) {
-    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED, "unable to allocate buffer");
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED, "unable to import host allocation");
   }
 
-  return iree_hal_metal_buffer_wrap(
+  iree_status_t status = iree_hal_metal_buffer_wrap(
 #if defined(IREE_PLATFORM_MACOS)
       allocator->queue,
 #endif  // IREE_PLATFORM_MACOS
-      metal_buffer, base_allocator, params->type, params->access, params->usage,
+      metal_buffer, base_allocator, memory_type, params->access, params->usage,
       external_buffer->size, /*byte_offset=*/0, /*byte_length=*/external_buffer->size,
       release_callback, out_buffer);  // +1
+  [metal_buffer release];  // -1
+  return status;
 }
 
 static iree_status_t iree_hal_metal_allocator_import_device_buffer(
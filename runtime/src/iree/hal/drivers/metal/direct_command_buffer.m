@@ -70,6 +70,17 @@ typedef struct iree_hal_metal_descriptor_t {
   MTLResourceUsage usage;
 } iree_hal_metal_descriptor_t;
 
+// An argument buffer encoded into the staging buffer for one descriptor set.
+typedef struct iree_hal_metal_argument_buffer_t {
+  // The function the argument buffer was encoded for, or nil if none has been encoded.
+  id<MTLFunction> function;
+  // Offset of the encoded argument buffer in the staging buffer.
+  uint32_t offset;
+  // The descriptors encoded into the argument buffer.
+  iree_host_size_t descriptor_count;
+  iree_hal_metal_descriptor_t descriptors[IREE_HAL_METAL_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+} iree_hal_metal_argument_buffer_t;
+
 // API data for dispatch command segments.
 typedef struct iree_hal_metal_dispatch_segment_t {
   // Compute kernel information--kernel object, pipeline layout, threadgroup size, etc.
@@ -212,6 +223,11 @@ typedef struct iree_hal_metal_command_buffer_t {
       iree_hal_metal_descriptor_t bindings[IREE_HAL_METAL_MAX_DESCRIPTOR_SET_BINDING_COUNT];
     } descriptor_sets[IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_INDEX];
 
+    // The argument buffer most recently encoded for each descriptor set. Consecutive dispatches of
+    // the same function with unchanged bindings in a set reuse the encoded argument buffer instead
+    // of reserving and encoding a new one from the staging buffer.
+    iree_hal_metal_argument_buffer_t argument_buffers[IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_INDEX];
+
     // All available push constants updated each time push_constants is called. Reset only with the
     // command buffer and otherwise will maintain its values during recording to allow for partial
     // push_constants updates.
@@ -266,6 +282,7 @@ static void iree_hal_metal_command_buffer_reset(iree_hal_metal_command_buffer_t*
   iree_hal_metal_end_compute_encoder(command_buffer);
   iree_hal_metal_command_segment_list_reset(&command_buffer->segments);
   iree_arena_reset(&command_buffer->arena);
+  memset(command_buffer->state.argument_buffers, 0, sizeof(command_buffer->state.argument_buffers));
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -987,6 +1004,45 @@ static iree_status_t iree_hal_metal_command_segment_create_dispatch(
   return iree_ok_status();
 }
 
+// Returns true and the staging buffer offset in |out_offset| if the argument buffer last encoded
+// for |set| was encoded for |function| with the same |descriptors|.
+static bool iree_hal_metal_argument_buffer_lookup(iree_hal_metal_command_buffer_t* command_buffer,
+                                                  id<MTLFunction> function, uint32_t set,
+                                                  iree_host_size_t descriptor_count,
+                                                  const iree_hal_metal_descriptor_t* descriptors,
+                                                  uint32_t* out_offset) {
+  if (set >= IREE_ARRAYSIZE(command_buffer->state.argument_buffers)) return false;
+  const iree_hal_metal_argument_buffer_t* cached = &command_buffer->state.argument_buffers[set];
+  if (cached->function == nil || cached->function != function) return false;
+  if (cached->descriptor_count != descriptor_count) return false;
+  for (iree_host_size_t i = 0; i < descriptor_count; ++i) {
+    if (cached->descriptors[i].binding != descriptors[i].binding ||
+        cached->descriptors[i].buffer != descriptors[i].buffer ||
+        cached->descriptors[i].offset != descriptors[i].offset) {
+      return false;
+    }
+  }
+  *out_offset = cached->offset;
+  return true;
+}
+
+// Records that the argument buffer at |offset| was encoded for |function| with |descriptors|.
+static void iree_hal_metal_argument_buffer_update(iree_hal_metal_command_buffer_t* command_buffer,
+                                                  id<MTLFunction> function, uint32_t set,
+                                                  iree_host_size_t descriptor_count,
+                                                  const iree_hal_metal_descriptor_t* descriptors,
+                                                  uint32_t offset) {
+  if (set >= IREE_ARRAYSIZE(command_buffer->state.argument_buffers) ||
+      descriptor_count > IREE_HAL_METAL_MAX_DESCRIPTOR_SET_BINDING_COUNT) {
+    return;
+  }
+  iree_hal_metal_argument_buffer_t* cached = &command_buffer->state.argument_buffers[set];
+  cached->function = function;
+  cached->offset = offset;
+  cached->descriptor_count = descriptor_count;
+  memcpy(cached->descriptors, descriptors, descriptor_count * sizeof(*descriptors));
+}
+
 static iree_status_t iree_hal_metal_command_segment_record_dispatch(
     iree_hal_metal_command_buffer_t* command_buffer, iree_hal_metal_dispatch_segment_t* segment) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -1004,43 +1060,61 @@ static iree_status_t iree_hal_metal_command_segment_record_dispatch(
   }
 
   // Record argument buffers for all descriptors and record buffer usages.
+  id<MTLBuffer> argument_buffer = command_buffer->staging_buffer->metal_buffer;
   iree_hal_metal_descriptor_t* descriptors = segment->descriptors;
   for (iree_host_size_t i = 0; i < segment->descriptor_count;) {
     uint32_t current_set = descriptors[i].set;
+    iree_host_size_t set_begin = i;
+    while (i < segment->descriptor_count && descriptors[i].set == current_set) ++i;
+    iree_host_size_t set_count = i - set_begin;
 
-    // Build argument encoder and argument buffer for the current descriptor set.
-    // TODO(antiagainst): Use a cache layer to cache and reuse argument buffers with the same
-    // content, to avoid duplicating overhead.
-    id<MTLBuffer> argument_buffer = command_buffer->staging_buffer->metal_buffer;
-    id<MTLArgumentEncoder> argument_encoder =
-        [segment->kernel_params.function newArgumentEncoderWithBufferIndex:current_set];  // +1
-    IREE_ASSERT(argument_encoder != nil);
-
-    // Reserve space for the argument buffer from shared staging buffer.
-    iree_byte_span_t reservation;
-    uint32_t argument_buffer_offset;
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_hal_metal_staging_buffer_reserve(
-                command_buffer->staging_buffer, argument_encoder.encodedLength,
-                argument_encoder.alignment, &reservation, &argument_buffer_offset));
-    [argument_encoder setArgumentBuffer:argument_buffer offset:argument_buffer_offset];
-
-    // Now record all bound buffers belonging to the current set into the argument buffer.
-    for (; i < segment->descriptor_count && descriptors[i].set == current_set; ++i) {
-      uint32_t current_binding = descriptors[i].binding;
+    // Record buffer usages for all bound buffers belonging to the current set.
+    for (iree_host_size_t j = set_begin; j < i; ++j) {
       id<MTLBuffer> current_buffer =
-          iree_hal_metal_buffer_handle(iree_hal_buffer_allocated_buffer(descriptors[i].buffer));
-      iree_host_size_t offset =
-          iree_hal_buffer_byte_offset(descriptors[i].buffer) + descriptors[i].offset;
-      [argument_encoder setBuffer:current_buffer offset:offset atIndex:current_binding];
+          iree_hal_metal_buffer_handle(iree_hal_buffer_allocated_buffer(descriptors[j].buffer));
+      [compute_encoder useResource:current_buffer usage:descriptors[j].usage];
+    }
+
+    // Reuse the previously encoded argument buffer if it has the same layout and content.
+    uint32_t argument_buffer_offset = 0;
+    if (!iree_hal_metal_argument_buffer_lookup(command_buffer, segment->kernel_params.function,
+                                               current_set, set_count, &descriptors[set_begin],
+                                               &argument_buffer_offset)) {
+      // Build argument encoder and argument buffer for the current descriptor set.
+      id<MTLArgumentEncoder> argument_encoder =
+          [segment->kernel_params.function newArgumentEncoderWithBufferIndex:current_set];  // +1
+      IREE_ASSERT(argument_encoder != nil);
+
+      // Reserve space for the argument buffer from shared staging buffer.
+      iree_byte_span_t reservation;
+      iree_status_t status = iree_hal_metal_staging_buffer_reserve(
+          command_buffer->staging_buffer, argument_encoder.encodedLength,
+          argument_encoder.alignment, &reservation, &argument_buffer_offset);
+      if (!iree_status_is_ok(status)) {
+        [argument_encoder release];  // -1
+        IREE_TRACE_ZONE_END(z0);
+        return status;
+      }
+      [argument_encoder setArgumentBuffer:argument_buffer offset:argument_buffer_offset];
+
+      // Now record all bound buffers belonging to the current set into the argument buffer.
+      for (iree_host_size_t j = set_begin; j < i; ++j) {
+        id<MTLBuffer> current_buffer =
+            iree_hal_metal_buffer_handle(iree_hal_buffer_allocated_buffer(descriptors[j].buffer));
+        iree_host_size_t offset =
+            iree_hal_buffer_byte_offset(descriptors[j].buffer) + descriptors[j].offset;
+        [argument_encoder setBuffer:current_buffer offset:offset atIndex:descriptors[j].binding];
+      }
+
+      [argument_encoder release];  // -1
 
-      // Also record buffer usages.
-      [compute_encoder useResource:current_buffer usage:descriptors[i].usage];
+      iree_hal_metal_argument_buffer_update(command_buffer, segment->kernel_params.function,
+                                            current_set, set_count, &descriptors[set_begin],
+                                            argument_buffer_offset);
     }
+
     // Record the argument buffer.
     [compute_encoder setBuffer:argument_buffer offset:argument_buffer_offset atIndex:current_set];
-
-    [argument_encoder release];  // -1
   }
 
   // Record the dispatch, either direct or indirect.
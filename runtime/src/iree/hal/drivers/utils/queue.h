@@ -0,0 +1,32 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_UTILS_QUEUE_H_
+#define IREE_HAL_DRIVERS_UTILS_QUEUE_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Returns the index of the queue that work with |queue_affinity| is issued to
+// on a device exposing |queue_count| queues. Only the lowest set bit is used
+// when multiple queues are allowed and any affinity bits beyond the queue count
+// wrap around.
+static inline iree_host_size_t iree_hal_queue_affinity_select_index(
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t queue_count) {
+  if (queue_affinity == 0 || queue_count == 1) return 0;
+  return iree_math_count_trailing_zeros_u64(queue_affinity) % queue_count;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_UTILS_QUEUE_H_
@@ -0,0 +1,104 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/utils/staging_ring.h"
+
+#include <string.h>
+
+void iree_hal_staging_ring_initialize(iree_device_size_t capacity,
+                                      iree_device_size_t alignment,
+                                      iree_hal_staging_ring_t* out_ring) {
+  IREE_ASSERT_ARGUMENT(out_ring);
+  IREE_ASSERT(iree_device_size_is_power_of_two(alignment));
+  memset(out_ring, 0, sizeof(*out_ring));
+  iree_slim_mutex_initialize(&out_ring->mutex);
+  out_ring->capacity = capacity;
+  out_ring->alignment = alignment;
+}
+
+void iree_hal_staging_ring_deinitialize(iree_hal_staging_ring_t* ring) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_ASSERT(ring->count == 0, "all reservations must be released");
+  iree_slim_mutex_deinitialize(&ring->mutex);
+}
+
+static iree_hal_staging_ring_reservation_t* iree_hal_staging_ring_at(
+    iree_hal_staging_ring_t* ring, iree_host_size_t i) {
+  return &ring->reservations[(ring->first + i) %
+                             IREE_HAL_STAGING_RING_MAX_RESERVATIONS];
+}
+
+bool iree_hal_staging_ring_reserve(iree_hal_staging_ring_t* ring,
+                                   iree_device_size_t length,
+                                   iree_device_size_t* out_offset) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_ASSERT_ARGUMENT(out_offset);
+  *out_offset = 0;
+  length = iree_device_align(iree_max(1, length), ring->alignment);
+  if (length > ring->capacity) return false;
+
+  iree_slim_mutex_lock(&ring->mutex);
+  bool reserved = false;
+  iree_device_size_t offset = 0;
+  if (ring->count == 0) {
+    // Empty ring; restart at the beginning so that the whole capacity is
+    // available as a single contiguous range.
+    ring->first = 0;
+    reserved = true;
+  } else if (ring->count < IREE_HAL_STAGING_RING_MAX_RESERVATIONS) {
+    const iree_hal_staging_ring_reservation_t* oldest =
+        iree_hal_staging_ring_at(ring, 0);
+    const iree_hal_staging_ring_reservation_t* newest =
+        iree_hal_staging_ring_at(ring, ring->count - 1);
+    const iree_device_size_t head = newest->offset + newest->length;
+    const iree_device_size_t tail = oldest->offset;
+    if (head > tail) {
+      // Live ranges are contiguous in [tail, head): try the end of the ring
+      // and otherwise wrap around to the free space before the tail.
+      if (ring->capacity - head >= length) {
+        offset = head;
+        reserved = true;
+      } else if (tail >= length) {
+        offset = 0;
+        reserved = true;
+      }
+    } else if (tail - head >= length) {
+      // Ring has wrapped and the free space is [head, tail).
+      offset = head;
+      reserved = true;
+    }
+  }
+  if (reserved) {
+    iree_hal_staging_ring_reservation_t* reservation =
+        iree_hal_staging_ring_at(ring, ring->count++);
+    reservation->offset = offset;
+    reservation->length = length;
+    reservation->released = false;
+    *out_offset = offset;
+  }
+  iree_slim_mutex_unlock(&ring->mutex);
+  return reserved;
+}
+
+void iree_hal_staging_ring_release(iree_hal_staging_ring_t* ring,
+                                   iree_device_size_t offset) {
+  IREE_ASSERT_ARGUMENT(ring);
+  iree_slim_mutex_lock(&ring->mutex);
+  for (iree_host_size_t i = 0; i < ring->count; ++i) {
+    iree_hal_staging_ring_reservation_t* reservation =
+        iree_hal_staging_ring_at(ring, i);
+    if (reservation->offset == offset && !reservation->released) {
+      reservation->released = true;
+      break;
+    }
+  }
+  // Reclaim all released reservations from the tail.
+  while (ring->count > 0 && iree_hal_staging_ring_at(ring, 0)->released) {
+    ring->first = (ring->first + 1) % IREE_HAL_STAGING_RING_MAX_RESERVATIONS;
+    --ring->count;
+  }
+  iree_slim_mutex_unlock(&ring->mutex);
+}
@@ -0,0 +1,75 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_UTILS_STAGING_RING_H_
+#define IREE_HAL_DRIVERS_UTILS_STAGING_RING_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Maximum number of reservations that may be live in a staging ring at once.
+#define IREE_HAL_STAGING_RING_MAX_RESERVATIONS 64
+
+typedef struct iree_hal_staging_ring_reservation_t {
+  iree_device_size_t offset;
+  iree_device_size_t length;
+  bool released;
+} iree_hal_staging_ring_reservation_t;
+
+// Tracks reservations of byte ranges within a fixed-capacity ring of staging
+// memory owned by the caller (such as a persistent page-locked host
+// allocation). Reservations are made at the head of the ring and storage is
+// reclaimed from the tail in reservation order: a reservation released out of
+// order only frees its storage once all reservations made before it have also
+// been released.
+//
+// Ranges are handed out in a first-come first-served manner and reserving
+// never blocks; if there is insufficient contiguous space the reservation
+// fails and callers are expected to fall back to their normal allocation path.
+//
+// Thread-safe.
+typedef struct iree_hal_staging_ring_t {
+  iree_slim_mutex_t mutex;
+  // Total capacity of the ring in bytes.
+  iree_device_size_t capacity;
+  // Alignment in bytes of all reserved offsets and lengths.
+  iree_device_size_t alignment;
+  // Index of the oldest live reservation in |reservations|.
+  iree_host_size_t first;
+  // Number of live reservations starting at |first|.
+  iree_host_size_t count;
+  iree_hal_staging_ring_reservation_t
+      reservations[IREE_HAL_STAGING_RING_MAX_RESERVATIONS];
+} iree_hal_staging_ring_t;
+
+// Initializes |out_ring| to manage |capacity| bytes with all reservations
+// aligned to the power-of-two |alignment|.
+void iree_hal_staging_ring_initialize(iree_device_size_t capacity,
+                                      iree_device_size_t alignment,
+                                      iree_hal_staging_ring_t* out_ring);
+
+// Deinitializes |ring|. All reservations must have been released.
+void iree_hal_staging_ring_deinitialize(iree_hal_staging_ring_t* ring);
+
+// Reserves |length| bytes from the ring and returns the offset of the range in
+// |out_offset|. Returns false if the ring cannot satisfy the request.
+bool iree_hal_staging_ring_reserve(iree_hal_staging_ring_t* ring,
+                                   iree_device_size_t length,
+                                   iree_device_size_t* out_offset);
+
+// Releases the reservation beginning at |offset|.
+void iree_hal_staging_ring_release(iree_hal_staging_ring_t* ring,
+                                   iree_device_size_t offset);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_UTILS_STAGING_RING_H_
@@ -0,0 +1,87 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/utils/staging_ring.h"
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class StagingRingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_hal_staging_ring_initialize(/*capacity=*/1024, /*alignment=*/64,
+                                     &ring_);
+  }
+  void TearDown() override { iree_hal_staging_ring_deinitialize(&ring_); }
+  iree_hal_staging_ring_t ring_;
+};
+
+TEST_F(StagingRingTest, ReserveAligned) {
+  iree_device_size_t offset0 = 0, offset1 = 0;
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 1, &offset0));
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 100, &offset1));
+  EXPECT_EQ(offset0, 0);
+  EXPECT_EQ(offset1, 64);
+  iree_hal_staging_ring_release(&ring_, offset0);
+  iree_hal_staging_ring_release(&ring_, offset1);
+}
+
+TEST_F(StagingRingTest, ReserveTooLarge) {
+  iree_device_size_t offset = 0;
+  EXPECT_FALSE(iree_hal_staging_ring_reserve(&ring_, 2048, &offset));
+}
+
+TEST_F(StagingRingTest, Exhaust) {
+  iree_device_size_t offset0 = 0, offset1 = 0, offset2 = 0;
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 512, &offset0));
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 512, &offset1));
+  EXPECT_FALSE(iree_hal_staging_ring_reserve(&ring_, 64, &offset2));
+  iree_hal_staging_ring_release(&ring_, offset0);
+  iree_hal_staging_ring_release(&ring_, offset1);
+  // Fully released rings restart at the beginning.
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 1024, &offset2));
+  EXPECT_EQ(offset2, 0);
+  iree_hal_staging_ring_release(&ring_, offset2);
+}
+
+TEST_F(StagingRingTest, WrapAround) {
+  iree_device_size_t offset0 = 0, offset1 = 0, offset2 = 0;
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 512, &offset0));
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 256, &offset1));
+  iree_hal_staging_ring_release(&ring_, offset0);
+  // Only 256 bytes remain at the end so the reservation wraps to the front.
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 384, &offset2));
+  EXPECT_EQ(offset2, 0);
+  // Free space between the wrapped head and the tail is [384, 512).
+  iree_device_size_t offset3 = 0;
+  EXPECT_FALSE(iree_hal_staging_ring_reserve(&ring_, 256, &offset3));
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 128, &offset3));
+  EXPECT_EQ(offset3, 384);
+  iree_hal_staging_ring_release(&ring_, offset1);
+  iree_hal_staging_ring_release(&ring_, offset2);
+  iree_hal_staging_ring_release(&ring_, offset3);
+}
+
+TEST_F(StagingRingTest, OutOfOrderRelease) {
+  iree_device_size_t offset0 = 0, offset1 = 0, offset2 = 0;
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 512, &offset0));
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 512, &offset1));
+  // Releasing the newer reservation does not reclaim storage while the older
+  // one is still live.
+  iree_hal_staging_ring_release(&ring_, offset1);
+  EXPECT_FALSE(iree_hal_staging_ring_reserve(&ring_, 64, &offset2));
+  iree_hal_staging_ring_release(&ring_, offset0);
+  ASSERT_TRUE(iree_hal_staging_ring_reserve(&ring_, 1024, &offset2));
+  iree_hal_staging_ring_release(&ring_, offset2);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
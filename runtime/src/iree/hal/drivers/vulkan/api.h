@@ -94,6 +94,11 @@ enum iree_hal_vulkan_feature_bits_t {
   // Enables buffer device addresses when supported and uses them when
   // appropriately compiled SPIR-V executables require them.
   IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES = 1u << 6,
+
+  // Enables VK_EXT_descriptor_buffer when supported and uses descriptor
+  // buffers instead of descriptor sets for binding dispatch resources.
+  // Implies IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES.
+  IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS = 1u << 7,
 };
 typedef uint32_t iree_hal_vulkan_features_t;
 
@@ -213,6 +218,29 @@ typedef uint32_t iree_hal_vulkan_device_flags_t;
 typedef struct iree_hal_vulkan_device_options_t {
   // Flags controlling device behavior.
   iree_hal_vulkan_device_flags_t flags;
+  // Streaming file transfer options used when files cannot be imported
+  // directly into device memory. A 0 value selects a default based on the
+  // transfer.
+  struct {
+    // Number of staging chunks each handled by a transfer worker. Workers
+    // overlap staging chunks on the host with the queue operations of other
+    // workers so counts >1 trade staging memory for throughput.
+    iree_device_size_t chunk_count;
+    // Size of each staging chunk in bytes.
+    iree_device_size_t chunk_size;
+    // Maximum total size of the staging memory in bytes.
+    iree_device_size_t staging_limit;
+  } file_transfer;
+  // Directory used to persist VkPipelineCache contents across processes.
+  // Executable caches load previously compiled pipelines from and store newly
+  // compiled pipelines to a file per cache identifier and physical device.
+  // Empty disables persistence. The directory must exist and be writable.
+  iree_string_view_t pipeline_cache_path;
+  // Maximum number of threads used to compile the pipelines of a single
+  // executable. Entry points are split into contiguous batches that are
+  // compiled concurrently against the shared VkPipelineCache. 0 or 1 compiles
+  // all pipelines on the calling thread.
+  iree_host_size_t pipeline_compile_concurrency;
 } iree_hal_vulkan_device_options_t;
 
 IREE_API_EXPORT void iree_hal_vulkan_device_options_initialize(
@@ -323,6 +351,39 @@ IREE_API_EXPORT iree_status_t iree_hal_vulkan_allocated_buffer_handle(
     iree_hal_buffer_t* allocated_buffer, VkDeviceMemory* out_memory,
     VkBuffer* out_handle);
 
+// EXPERIMENTAL: reserves a partially resident buffer of |allocation_size|
+// bytes on |device| with no device memory committed. Memory is committed on
+// demand with iree_hal_vulkan_sparse_buffer_commit_range as the used range of
+// the buffer grows such that buffers sized for their maximum use (such as KV
+// caches sized for the maximum context length) only consume the memory that
+// has been committed. The contents of uncommitted ranges are undefined and the
+// buffer cannot be mapped.
+//
+// Requires IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_BINDING and
+// IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_RESIDENCY_ALIASED and returns
+// IREE_STATUS_UNAVAILABLE if the device does not support them.
+IREE_API_EXPORT iree_status_t iree_hal_vulkan_sparse_buffer_reserve(
+    iree_hal_device_t* device, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer);
+
+// EXPERIMENTAL: commits device memory backing at least the byte range
+// [|offset|, |offset| + |length|) of a |buffer| reserved with
+// iree_hal_vulkan_sparse_buffer_reserve. Ranges already committed are left
+// unchanged. The memory is bound on the queue selected by |queue_affinity|
+// once |wait_semaphore_list| is reached and |signal_semaphore_list| is
+// signaled once the range may be used by subsequent queue operations.
+IREE_API_EXPORT iree_status_t iree_hal_vulkan_sparse_buffer_commit_range(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer, iree_device_size_t offset,
+    iree_device_size_t length);
+
+// EXPERIMENTAL: returns the total bytes of device memory committed to a
+// |buffer| reserved with iree_hal_vulkan_sparse_buffer_reserve.
+IREE_API_EXPORT iree_device_size_t
+iree_hal_vulkan_sparse_buffer_query_committed_size(iree_hal_buffer_t* buffer);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_vulkan_*_semaphore_t
 //===----------------------------------------------------------------------===//
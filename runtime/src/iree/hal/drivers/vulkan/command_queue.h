@@ -50,6 +50,14 @@ class CommandQueue {
   virtual iree_status_t Submit(iree_host_size_t batch_count,
                                const iree_hal_submission_batch_t* batches) = 0;
 
+  // Binds device memory to ranges of a sparse |buffer| once all
+  // |wait_semaphores| are reached and signals |signal_semaphores| after the
+  // binds complete. The queue must support VK_QUEUE_SPARSE_BINDING_BIT.
+  virtual iree_status_t BindSparse(
+      const iree_hal_semaphore_list_t wait_semaphores,
+      const iree_hal_semaphore_list_t signal_semaphores, VkBuffer buffer,
+      iree_host_size_t bind_count, const VkSparseMemoryBind* binds) = 0;
+
   virtual iree_status_t WaitIdle(iree_timeout_t timeout) = 0;
 
  protected:
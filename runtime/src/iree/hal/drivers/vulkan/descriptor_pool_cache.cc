@@ -8,6 +8,8 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <ostream>
 
 #include "iree/hal/drivers/vulkan/status_util.h"
@@ -22,10 +24,21 @@ namespace {
 // chaining in the command buffer when pools run out.
 static constexpr int kMaxDescriptorSets = 4096;
 
+// Maximum number of reset pools retained in the cache. Pools released beyond
+// this are destroyed.
+static constexpr size_t kMaxFreeDescriptorPools = 64;
+
+// Capacity of each descriptor buffer. Command buffers acquire additional
+// buffers as needed when recording more descriptors than fit in one.
+static constexpr VkDeviceSize kDescriptorBufferCapacity = 256 * 1024;
+
+// Maximum number of descriptor buffers retained in the cache.
+static constexpr size_t kMaxFreeDescriptorBuffers = 16;
+
 }  // namespace
 
 DescriptorSetGroup::~DescriptorSetGroup() {
-  IREE_ASSERT_TRUE(descriptor_pools_.empty(),
+  IREE_ASSERT_TRUE(descriptor_pools_.empty() && descriptor_buffers_.empty(),
                    "DescriptorSetGroup must be reset explicitly");
 }
 
@@ -33,23 +46,66 @@ iree_status_t DescriptorSetGroup::Reset() {
   IREE_TRACE_SCOPE_NAMED("DescriptorSetGroup::Reset");
 
   if (descriptor_pool_cache_ != nullptr) {
+    descriptor_pool_cache_->ReleaseDescriptorBuffers(descriptor_buffers_);
     IREE_RETURN_IF_ERROR(
         descriptor_pool_cache_->ReleaseDescriptorPools(descriptor_pools_));
   }
+  descriptor_buffers_.clear();
   descriptor_pools_.clear();
 
   return iree_ok_status();
 }
 
 DescriptorPoolCache::DescriptorPoolCache(VkDeviceHandle* logical_device)
-    : logical_device_(logical_device) {}
+    : logical_device_(logical_device) {
+  iree_slim_mutex_initialize(&mutex_);
+  memset(&descriptor_buffer_properties_, 0,
+         sizeof(descriptor_buffer_properties_));
+  descriptor_buffer_properties_.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+  if (descriptor_buffers_enabled()) {
+    VkPhysicalDeviceProperties2 properties2;
+    memset(&properties2, 0, sizeof(properties2));
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    properties2.pNext = &descriptor_buffer_properties_;
+    syms().vkGetPhysicalDeviceProperties2(logical_device_->physical_device(),
+                                          &properties2);
+    descriptor_buffer_properties_.pNext = nullptr;
+  }
+}
+
+DescriptorPoolCache::~DescriptorPoolCache() {
+  for (const auto& descriptor_pool : free_descriptor_pools_) {
+    syms().vkDestroyDescriptorPool(*logical_device_, descriptor_pool.handle,
+                                   logical_device_->allocator());
+  }
+  free_descriptor_pools_.clear();
+  for (const auto& descriptor_buffer : free_descriptor_buffers_) {
+    DestroyDescriptorBuffer(descriptor_buffer);
+  }
+  free_descriptor_buffers_.clear();
+  iree_slim_mutex_deinitialize(&mutex_);
+}
 
 iree_status_t DescriptorPoolCache::AcquireDescriptorPool(
     VkDescriptorType descriptor_type, int max_descriptor_count,
     DescriptorPool* out_descriptor_pool) {
   IREE_TRACE_SCOPE_NAMED("DescriptorPoolCache::AcquireDescriptorPool");
 
-  // TODO(benvanik): lookup in cache.
+  // Reuse a previously released pool with the same configuration if one is
+  // available. Pools are reset when released so all sets are available.
+  iree_slim_mutex_lock(&mutex_);
+  for (auto it = free_descriptor_pools_.rbegin();
+       it != free_descriptor_pools_.rend(); ++it) {
+    if (it->descriptor_type == descriptor_type &&
+        it->max_descriptor_count == max_descriptor_count) {
+      *out_descriptor_pool = *it;
+      free_descriptor_pools_.erase(std::next(it).base());
+      iree_slim_mutex_unlock(&mutex_);
+      return iree_ok_status();
+    }
+  }
+  iree_slim_mutex_unlock(&mutex_);
 
   VkDescriptorPoolCreateInfo create_info;
   create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
@@ -64,6 +120,7 @@ iree_status_t DescriptorPoolCache::AcquireDescriptorPool(
 
   DescriptorPool descriptor_pool;
   descriptor_pool.descriptor_type = descriptor_type;
+  descriptor_pool.max_descriptor_count = max_descriptor_count;
   descriptor_pool.handle = VK_NULL_HANDLE;
 
   VK_RETURN_IF_ERROR(syms().vkCreateDescriptorPool(
@@ -87,14 +144,161 @@ iree_status_t DescriptorPoolCache::ReleaseDescriptorPools(
                                                     descriptor_pool.handle, 0),
                        "vkResetDescriptorPool");
 
-    // TODO(benvanik): release to cache.
-    syms().vkDestroyDescriptorPool(*logical_device_, descriptor_pool.handle,
-                                   logical_device_->allocator());
+    iree_slim_mutex_lock(&mutex_);
+    bool retained = false;
+    if (free_descriptor_pools_.size() < kMaxFreeDescriptorPools) {
+      free_descriptor_pools_.push_back(descriptor_pool);
+      retained = true;
+    }
+    iree_slim_mutex_unlock(&mutex_);
+    if (!retained) {
+      syms().vkDestroyDescriptorPool(*logical_device_, descriptor_pool.handle,
+                                     logical_device_->allocator());
+    }
   }
 
   return iree_ok_status();
 }
 
+iree_status_t DescriptorPoolCache::AcquireDescriptorBuffer(
+    DescriptorBuffer* out_descriptor_buffer) {
+  IREE_TRACE_SCOPE_NAMED("DescriptorPoolCache::AcquireDescriptorBuffer");
+  *out_descriptor_buffer = DescriptorBuffer{};
+
+  iree_slim_mutex_lock(&mutex_);
+  if (!free_descriptor_buffers_.empty()) {
+    *out_descriptor_buffer = free_descriptor_buffers_.back();
+    free_descriptor_buffers_.pop_back();
+    iree_slim_mutex_unlock(&mutex_);
+    return iree_ok_status();
+  }
+  iree_slim_mutex_unlock(&mutex_);
+
+  DescriptorBuffer descriptor_buffer;
+  descriptor_buffer.capacity = kDescriptorBufferCapacity;
+
+  VkBufferCreateInfo buffer_create_info;
+  memset(&buffer_create_info, 0, sizeof(buffer_create_info));
+  buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_create_info.size = descriptor_buffer.capacity;
+  buffer_create_info.usage =
+      VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+      VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  VK_RETURN_IF_ERROR(syms().vkCreateBuffer(*logical_device_,
+                                           &buffer_create_info,
+                                           logical_device_->allocator(),
+                                           &descriptor_buffer.handle),
+                     "vkCreateBuffer");
+
+  // Descriptors are written by the host and read by the device; prefer memory
+  // that is also device-local when the implementation exposes it.
+  VkMemoryRequirements requirements;
+  syms().vkGetBufferMemoryRequirements(*logical_device_,
+                                       descriptor_buffer.handle, &requirements);
+  VkPhysicalDeviceMemoryProperties memory_properties;
+  syms().vkGetPhysicalDeviceMemoryProperties(logical_device_->physical_device(),
+                                             &memory_properties);
+  const VkMemoryPropertyFlags required_flags =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  uint32_t memory_type_index = UINT32_MAX;
+  for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+    if (!(requirements.memoryTypeBits & (1u << i))) continue;
+    const VkMemoryPropertyFlags flags =
+        memory_properties.memoryTypes[i].propertyFlags;
+    if (!iree_all_bits_set(flags, required_flags)) continue;
+    if (memory_type_index == UINT32_MAX) memory_type_index = i;
+    if (iree_all_bits_set(flags, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+      memory_type_index = i;
+      break;
+    }
+  }
+  iree_status_t status = iree_ok_status();
+  if (memory_type_index == UINT32_MAX) {
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "no host-visible coherent memory type available "
+                              "for descriptor buffers");
+  }
+
+  if (iree_status_is_ok(status)) {
+    VkMemoryAllocateFlagsInfo allocate_flags_info;
+    memset(&allocate_flags_info, 0, sizeof(allocate_flags_info));
+    allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    VkMemoryAllocateInfo allocate_info;
+    memset(&allocate_info, 0, sizeof(allocate_info));
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.pNext = &allocate_flags_info;
+    allocate_info.allocationSize = requirements.size;
+    allocate_info.memoryTypeIndex = memory_type_index;
+    status = VK_RESULT_TO_STATUS(
+        syms().vkAllocateMemory(*logical_device_, &allocate_info,
+                                logical_device_->allocator(),
+                                &descriptor_buffer.memory),
+        "vkAllocateMemory");
+  }
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        syms().vkBindBufferMemory(*logical_device_, descriptor_buffer.handle,
+                                  descriptor_buffer.memory, 0),
+        "vkBindBufferMemory");
+  }
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        syms().vkMapMemory(*logical_device_, descriptor_buffer.memory, 0,
+                           VK_WHOLE_SIZE, 0,
+                           (void**)&descriptor_buffer.host_ptr),
+        "vkMapMemory");
+  }
+  if (iree_status_is_ok(status)) {
+    VkBufferDeviceAddressInfo address_info;
+    memset(&address_info, 0, sizeof(address_info));
+    address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    address_info.buffer = descriptor_buffer.handle;
+    descriptor_buffer.device_address =
+        syms().vkGetBufferDeviceAddress
+            ? syms().vkGetBufferDeviceAddress(*logical_device_, &address_info)
+            : syms().vkGetBufferDeviceAddressKHR(*logical_device_,
+                                                 &address_info);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_descriptor_buffer = descriptor_buffer;
+  } else {
+    DestroyDescriptorBuffer(descriptor_buffer);
+  }
+  return status;
+}
+
+void DescriptorPoolCache::ReleaseDescriptorBuffers(
+    const std::vector<DescriptorBuffer>& descriptor_buffers) {
+  IREE_TRACE_SCOPE_NAMED("DescriptorPoolCache::ReleaseDescriptorBuffers");
+  for (const auto& descriptor_buffer : descriptor_buffers) {
+    iree_slim_mutex_lock(&mutex_);
+    bool retained = false;
+    if (free_descriptor_buffers_.size() < kMaxFreeDescriptorBuffers) {
+      free_descriptor_buffers_.push_back(descriptor_buffer);
+      retained = true;
+    }
+    iree_slim_mutex_unlock(&mutex_);
+    if (!retained) DestroyDescriptorBuffer(descriptor_buffer);
+  }
+}
+
+void DescriptorPoolCache::DestroyDescriptorBuffer(
+    const DescriptorBuffer& descriptor_buffer) {
+  if (descriptor_buffer.handle != VK_NULL_HANDLE) {
+    syms().vkDestroyBuffer(*logical_device_, descriptor_buffer.handle,
+                           logical_device_->allocator());
+  }
+  if (descriptor_buffer.memory != VK_NULL_HANDLE) {
+    // Memory is implicitly unmapped when freed.
+    syms().vkFreeMemory(*logical_device_, descriptor_buffer.memory,
+                        logical_device_->allocator());
+  }
+}
+
 }  // namespace vulkan
 }  // namespace hal
 }  // namespace iree
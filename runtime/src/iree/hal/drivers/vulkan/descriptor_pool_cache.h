@@ -28,27 +28,48 @@ class DescriptorPoolCache;
 struct DescriptorPool {
   // Type of the descriptor in the set.
   VkDescriptorType descriptor_type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+  // Maximum number of descriptors per set allocated from the pool.
+  int max_descriptor_count = 0;
   // Pool handle.
   VkDescriptorPool handle = VK_NULL_HANDLE;
 };
 
+// A host-visible buffer that descriptors are written into when using
+// VK_EXT_descriptor_buffer. The buffer is persistently mapped.
+struct DescriptorBuffer {
+  // Buffer handle.
+  VkBuffer handle = VK_NULL_HANDLE;
+  // Memory bound to the buffer.
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  // Device address of the start of the buffer.
+  VkDeviceAddress device_address = 0;
+  // Host pointer to the start of the mapped buffer.
+  uint8_t* host_ptr = nullptr;
+  // Total capacity of the buffer in bytes.
+  VkDeviceSize capacity = 0;
+};
+
 // A group of descriptor sets allocated and released together.
 // The group must be explicitly reset with Reset() prior to disposing.
 class DescriptorSetGroup final {
  public:
   DescriptorSetGroup() = default;
   DescriptorSetGroup(DescriptorPoolCache* descriptor_pool_cache,
-                     std::vector<DescriptorPool> descriptor_pools)
+                     std::vector<DescriptorPool> descriptor_pools,
+                     std::vector<DescriptorBuffer> descriptor_buffers)
       : descriptor_pool_cache_(descriptor_pool_cache),
-        descriptor_pools_(std::move(descriptor_pools)) {}
+        descriptor_pools_(std::move(descriptor_pools)),
+        descriptor_buffers_(std::move(descriptor_buffers)) {}
   DescriptorSetGroup(const DescriptorSetGroup&) = delete;
   DescriptorSetGroup& operator=(const DescriptorSetGroup&) = delete;
   DescriptorSetGroup(DescriptorSetGroup&& other) noexcept
       : descriptor_pool_cache_(std::move(other.descriptor_pool_cache_)),
-        descriptor_pools_(std::move(other.descriptor_pools_)) {}
+        descriptor_pools_(std::move(other.descriptor_pools_)),
+        descriptor_buffers_(std::move(other.descriptor_buffers_)) {}
   DescriptorSetGroup& operator=(DescriptorSetGroup&& other) {
     std::swap(descriptor_pool_cache_, other.descriptor_pool_cache_);
     std::swap(descriptor_pools_, other.descriptor_pools_);
+    std::swap(descriptor_buffers_, other.descriptor_buffers_);
     return *this;
   }
   ~DescriptorSetGroup();
@@ -58,6 +79,7 @@ class DescriptorSetGroup final {
  private:
   DescriptorPoolCache* descriptor_pool_cache_;
   std::vector<DescriptorPool> descriptor_pools_;
+  std::vector<DescriptorBuffer> descriptor_buffers_;
 };
 
 // A "cache" (or really, pool) of descriptor pools. These pools are allocated
@@ -66,9 +88,22 @@ class DescriptorSetGroup final {
 // resources. After the descriptors in the pool are no longer used (all
 // command buffers using descriptor sets allocated from the pool have retired)
 // the pool is returned here to be reused in the future.
+//
+// Released pools are reset and retained in free lists keyed by their
+// descriptor type and maximum descriptor count so that recording command
+// buffers does not need to create and destroy Vulkan pools.
+//
+// When VK_EXT_descriptor_buffer is enabled descriptor buffers are cached in
+// the same way instead of descriptor pools.
+//
+// Thread-safe.
 class DescriptorPoolCache final {
  public:
   explicit DescriptorPoolCache(VkDeviceHandle* logical_device);
+  ~DescriptorPoolCache();
+
+  DescriptorPoolCache(const DescriptorPoolCache&) = delete;
+  DescriptorPoolCache& operator=(const DescriptorPoolCache&) = delete;
 
   VkDeviceHandle* logical_device() const { return logical_device_; }
   const DynamicSymbols& syms() const { return *logical_device_->syms(); }
@@ -86,8 +121,42 @@ class DescriptorPoolCache final {
   iree_status_t ReleaseDescriptorPools(
       const std::vector<DescriptorPool>& descriptor_pools);
 
+  // Returns true if descriptors are bound with VK_EXT_descriptor_buffer.
+  bool descriptor_buffers_enabled() const {
+    return logical_device_->enabled_extensions().descriptor_buffer;
+  }
+
+  // Properties of the implementation's descriptor buffer support.
+  // Only valid if descriptor_buffers_enabled().
+  const VkPhysicalDeviceDescriptorBufferPropertiesEXT&
+  descriptor_buffer_properties() const {
+    return descriptor_buffer_properties_;
+  }
+
+  // Acquires a mapped descriptor buffer for use by the caller.
+  // When all descriptors in the buffer are no longer in use it must be returned
+  // to the cache with ReleaseDescriptorBuffers.
+  iree_status_t AcquireDescriptorBuffer(
+      DescriptorBuffer* out_descriptor_buffer);
+
+  // Releases descriptor buffers back to the cache. The buffers must no longer
+  // be in use by any in-flight command.
+  void ReleaseDescriptorBuffers(
+      const std::vector<DescriptorBuffer>& descriptor_buffers);
+
  private:
+  void DestroyDescriptorBuffer(const DescriptorBuffer& descriptor_buffer);
+
   VkDeviceHandle* logical_device_;
+
+  VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties_;
+
+  iree_slim_mutex_t mutex_;
+  // Reset pools available for reuse.
+  std::vector<DescriptorPool> free_descriptor_pools_ IREE_GUARDED_BY(mutex_);
+  // Descriptor buffers available for reuse.
+  std::vector<DescriptorBuffer> free_descriptor_buffers_
+      IREE_GUARDED_BY(mutex_);
 };
 
 }  // namespace vulkan
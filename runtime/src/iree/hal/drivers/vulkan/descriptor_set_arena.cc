@@ -6,7 +6,9 @@
 
 #include "iree/hal/drivers/vulkan/descriptor_set_arena.h"
 
+#include <cinttypes>
 #include <cstddef>
+#include <cstring>
 #include <type_traits>
 #include <utility>
 
@@ -85,6 +87,27 @@ static void PopulateDescriptorSetWriteInfos(
   *out_infos = write_infos.data();
 }
 
+// Hashes the set layout and buffer ranges referenced by |write_infos| with
+// FNV-1a. Used to find identical descriptor sets for reuse.
+static uint64_t HashDescriptorSetWriteInfos(
+    VkDescriptorSetLayout set_layout, iree_host_size_t write_info_count,
+    const VkWriteDescriptorSet* write_infos) {
+  uint64_t hash = 14695981039346656037ull;
+  auto mix = [&hash](uint64_t value) {
+    hash ^= value;
+    hash *= 1099511628211ull;
+  };
+  mix((uint64_t)set_layout);
+  for (iree_host_size_t i = 0; i < write_info_count; ++i) {
+    const VkDescriptorBufferInfo* buffer_info = write_infos[i].pBufferInfo;
+    mix(write_infos[i].dstBinding);
+    mix((uint64_t)buffer_info->buffer);
+    mix(buffer_info->offset);
+    mix(buffer_info->range);
+  }
+  return hash;
+}
+
 }  // namespace
 
 DescriptorSetArena::DescriptorSetArena(
@@ -93,6 +116,10 @@ DescriptorSetArena::DescriptorSetArena(
       descriptor_pool_cache_(descriptor_pool_cache) {}
 
 DescriptorSetArena::~DescriptorSetArena() {
+  if (!used_descriptor_buffers_.empty()) {
+    descriptor_pool_cache_->ReleaseDescriptorBuffers(used_descriptor_buffers_);
+    used_descriptor_buffers_.clear();
+  }
   if (!used_descriptor_pools_.empty()) {
     iree_status_ignore(
         descriptor_pool_cache_->ReleaseDescriptorPools(used_descriptor_pools_));
@@ -104,6 +131,13 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
     VkCommandBuffer command_buffer, iree_hal_pipeline_layout_t* pipeline_layout,
     uint32_t set, iree_host_size_t binding_count,
     const iree_hal_descriptor_set_binding_t* bindings) {
+  // Descriptor buffers are used exclusively when enabled as all layouts and
+  // pipelines have been created for them.
+  if (descriptor_pool_cache_->descriptor_buffers_enabled()) {
+    return WriteDescriptorBuffer(command_buffer, pipeline_layout, set,
+                                 binding_count, bindings);
+  }
+
   // Always prefer using push descriptors when available as we can avoid the
   // additional API overhead of updating/resetting pools.
   if (logical_device_->enabled_extensions().push_descriptors) {
@@ -116,6 +150,29 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
 
   auto* set_layout =
       iree_hal_vulkan_native_pipeline_layout_set(pipeline_layout, set);
+  VkDescriptorSetLayout set_layout_handle =
+      iree_hal_vulkan_native_descriptor_set_layout_handle(set_layout);
+
+  // Get a list of VkWriteDescriptorSet structs with all bound buffers.
+  iree_host_size_t write_info_count = 0;
+  VkWriteDescriptorSet* write_infos = NULL;
+  PopulateDescriptorSetWriteInfos(binding_count, bindings, VK_NULL_HANDLE,
+                                  &scratch_arena_, &write_info_count,
+                                  &write_infos);
+
+  // Rebind an identical descriptor set if one was already allocated in this
+  // arena. This is common when the same dispatches are recorded repeatedly.
+  uint64_t key_hash = HashDescriptorSetWriteInfos(
+      set_layout_handle, write_info_count, write_infos);
+  VkDescriptorSet descriptor_set = LookupDescriptorSet(
+      set_layout_handle, key_hash, write_info_count, write_infos);
+  if (descriptor_set != VK_NULL_HANDLE) {
+    syms().vkCmdBindDescriptorSets(
+        command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        iree_hal_vulkan_native_pipeline_layout_handle(pipeline_layout), set, 1,
+        &descriptor_set, 0, nullptr);
+    return iree_ok_status();
+  }
 
   // Pick a bucket based on the number of descriptors required.
   // NOTE: right now we are 1:1 with bindings.
@@ -143,12 +200,9 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
   allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
   allocate_info.pNext = nullptr;
   allocate_info.descriptorPool = descriptor_pool.handle;
-  VkDescriptorSetLayout set_layout_handle =
-      iree_hal_vulkan_native_descriptor_set_layout_handle(set_layout);
   allocate_info.descriptorSetCount = 1;
   allocate_info.pSetLayouts = &set_layout_handle;
 
-  VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
   VkResult result = syms().vkAllocateDescriptorSets(
       *logical_device_, &allocate_info, &descriptor_set);
 
@@ -173,12 +227,18 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
                        "vkAllocateDescriptorSets");
   }
 
-  // Get a list of VkWriteDescriptorSet structs with all bound buffers.
-  iree_host_size_t write_info_count = 0;
-  VkWriteDescriptorSet* write_infos = NULL;
-  PopulateDescriptorSetWriteInfos(binding_count, bindings, descriptor_set,
-                                  &scratch_arena_, &write_info_count,
-                                  &write_infos);
+  // Point the writes at the newly allocated set and remember its contents.
+  CachedDescriptorSet cached_set;
+  cached_set.set_layout = set_layout_handle;
+  cached_set.bindings.resize(write_info_count);
+  cached_set.handle = descriptor_set;
+  for (iree_host_size_t i = 0; i < write_info_count; ++i) {
+    write_infos[i].dstSet = descriptor_set;
+    const VkDescriptorBufferInfo* buffer_info = write_infos[i].pBufferInfo;
+    cached_set.bindings[i] = {write_infos[i].dstBinding, buffer_info->buffer,
+                              buffer_info->offset, buffer_info->range};
+  }
+  cached_sets_.emplace(key_hash, std::move(cached_set));
 
   // This is the reason why push descriptor sets are good.
   // We can't batch these effectively as we don't know prior to recording what
@@ -198,6 +258,29 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
   return iree_ok_status();
 }
 
+VkDescriptorSet DescriptorSetArena::LookupDescriptorSet(
+    VkDescriptorSetLayout set_layout, uint64_t key_hash,
+    iree_host_size_t write_info_count,
+    const VkWriteDescriptorSet* write_infos) {
+  auto range = cached_sets_.equal_range(key_hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    const CachedDescriptorSet& cached_set = it->second;
+    if (cached_set.set_layout != set_layout ||
+        cached_set.bindings.size() != write_info_count) {
+      continue;
+    }
+    bool matches = true;
+    for (iree_host_size_t i = 0; i < write_info_count && matches; ++i) {
+      const VkDescriptorBufferInfo* buffer_info = write_infos[i].pBufferInfo;
+      matches = cached_set.bindings[i] ==
+                CachedBinding{write_infos[i].dstBinding, buffer_info->buffer,
+                              buffer_info->offset, buffer_info->range};
+    }
+    if (matches) return cached_set.handle;
+  }
+  return VK_NULL_HANDLE;
+}
+
 void DescriptorSetArena::PushDescriptorSet(
     VkCommandBuffer command_buffer, iree_hal_pipeline_layout_t* pipeline_layout,
     uint32_t set, iree_host_size_t binding_count,
@@ -220,10 +303,150 @@ void DescriptorSetArena::PushDescriptorSet(
       set, static_cast<uint32_t>(write_info_count), write_infos);
 }
 
+iree_status_t DescriptorSetArena::WriteDescriptorBuffer(
+    VkCommandBuffer command_buffer, iree_hal_pipeline_layout_t* pipeline_layout,
+    uint32_t set, iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  IREE_TRACE_SCOPE_NAMED("DescriptorSetArena::WriteDescriptorBuffer");
+  if (set >= bound_descriptor_buffer_sets_.size()) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "descriptor set %u out of range (max=%u)", set,
+                            kMaxBoundDescriptorSets);
+  }
+
+  const VkPhysicalDeviceDescriptorBufferPropertiesEXT& properties =
+      descriptor_pool_cache_->descriptor_buffer_properties();
+  auto* set_layout =
+      iree_hal_vulkan_native_pipeline_layout_set(pipeline_layout, set);
+  VkDeviceSize set_size = iree_device_align(
+      iree_hal_vulkan_native_descriptor_set_layout_size(set_layout),
+      properties.descriptorBufferOffsetAlignment);
+  VkDeviceSize set_offset = 0;
+  IREE_RETURN_IF_ERROR(
+      ReserveDescriptorBuffer(command_buffer, set_size, &set_offset));
+  uint8_t* set_ptr = current_descriptor_buffer_.host_ptr + set_offset;
+
+  // Descriptors are opaque blobs produced by the implementation from the
+  // device address range of each buffer.
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    const auto& binding = bindings[i];
+    if (!binding.buffer) continue;
+    VkBufferDeviceAddressInfo buffer_address_info;
+    buffer_address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    buffer_address_info.pNext = nullptr;
+    buffer_address_info.buffer = iree_hal_vulkan_buffer_handle(binding.buffer);
+    VkDeviceAddress buffer_address =
+        syms().vkGetBufferDeviceAddress
+            ? syms().vkGetBufferDeviceAddress(*logical_device_,
+                                              &buffer_address_info)
+            : syms().vkGetBufferDeviceAddressKHR(*logical_device_,
+                                                 &buffer_address_info);
+
+    // Ranges are rounded up to 32-bit as with descriptor sets; see
+    // PopulateDescriptorSetWriteInfos.
+    iree_device_size_t range =
+        binding.length == IREE_WHOLE_BUFFER
+            ? iree_hal_buffer_byte_length(binding.buffer) - binding.offset
+            : std::min(binding.length,
+                       iree_hal_buffer_byte_length(binding.buffer) -
+                           binding.offset);
+    VkDescriptorAddressInfoEXT address_info;
+    address_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+    address_info.pNext = nullptr;
+    address_info.address = buffer_address +
+                           iree_hal_buffer_byte_offset(binding.buffer) +
+                           binding.offset;
+    address_info.range = iree_device_align(range, 4);
+    address_info.format = VK_FORMAT_UNDEFINED;
+
+    VkDescriptorGetInfoEXT get_info;
+    get_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    get_info.pNext = nullptr;
+    get_info.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    get_info.data.pStorageBuffer = &address_info;
+    syms().vkGetDescriptorEXT(
+        *logical_device_, &get_info, properties.storageBufferDescriptorSize,
+        set_ptr + iree_hal_vulkan_native_descriptor_set_layout_binding_offset(
+                      set_layout, binding.binding));
+  }
+
+  VkPipelineLayout pipeline_layout_handle =
+      iree_hal_vulkan_native_pipeline_layout_handle(pipeline_layout);
+  auto& bound_set = bound_descriptor_buffer_sets_[set];
+  bound_set.pipeline_layout = pipeline_layout_handle;
+  bound_set.offset = set_offset;
+  bound_set.size = set_size;
+
+  const uint32_t buffer_index = 0;
+  syms().vkCmdSetDescriptorBufferOffsetsEXT(
+      command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout_handle,
+      set, 1, &buffer_index, &set_offset);
+  return iree_ok_status();
+}
+
+iree_status_t DescriptorSetArena::ReserveDescriptorBuffer(
+    VkCommandBuffer command_buffer, VkDeviceSize size,
+    VkDeviceSize* out_offset) {
+  *out_offset = 0;
+  if (current_descriptor_buffer_.handle != VK_NULL_HANDLE &&
+      current_descriptor_buffer_offset_ + size <=
+          current_descriptor_buffer_.capacity) {
+    *out_offset = current_descriptor_buffer_offset_;
+    current_descriptor_buffer_offset_ += size;
+    return iree_ok_status();
+  }
+
+  // Acquire and bind a new descriptor buffer.
+  DescriptorBuffer descriptor_buffer;
+  IREE_RETURN_IF_ERROR(
+      descriptor_pool_cache_->AcquireDescriptorBuffer(&descriptor_buffer));
+  used_descriptor_buffers_.push_back(descriptor_buffer);
+  VkDescriptorBufferBindingInfoEXT binding_info;
+  binding_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+  binding_info.pNext = nullptr;
+  binding_info.address = descriptor_buffer.device_address;
+  binding_info.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+  syms().vkCmdBindDescriptorBuffersEXT(command_buffer, 1, &binding_info);
+
+  // Carry over any sets still bound from the previous buffer as their offsets
+  // now refer to the new buffer. This is just a memcpy of the descriptors.
+  const DescriptorBuffer previous_buffer = current_descriptor_buffer_;
+  current_descriptor_buffer_ = descriptor_buffer;
+  current_descriptor_buffer_offset_ = 0;
+  for (uint32_t set = 0; set < bound_descriptor_buffer_sets_.size(); ++set) {
+    auto& bound_set = bound_descriptor_buffer_sets_[set];
+    if (bound_set.pipeline_layout == VK_NULL_HANDLE) continue;
+    memcpy(descriptor_buffer.host_ptr + current_descriptor_buffer_offset_,
+           previous_buffer.host_ptr + bound_set.offset, bound_set.size);
+    bound_set.offset = current_descriptor_buffer_offset_;
+    current_descriptor_buffer_offset_ += bound_set.size;
+    const uint32_t buffer_index = 0;
+    syms().vkCmdSetDescriptorBufferOffsetsEXT(
+        command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        bound_set.pipeline_layout, set, 1, &buffer_index, &bound_set.offset);
+  }
+
+  if (current_descriptor_buffer_offset_ + size >
+      current_descriptor_buffer_.capacity) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "descriptor set of %" PRIu64
+                            " bytes exceeds the descriptor buffer capacity",
+                            (uint64_t)size);
+  }
+  *out_offset = current_descriptor_buffer_offset_;
+  current_descriptor_buffer_offset_ += size;
+  return iree_ok_status();
+}
+
 DescriptorSetGroup DescriptorSetArena::Flush() {
   IREE_TRACE_SCOPE_NAMED("DescriptorSetArena::Flush");
 
-  if (used_descriptor_pools_.empty()) {
+  cached_sets_.clear();
+  current_descriptor_buffer_ = {};
+  current_descriptor_buffer_offset_ = 0;
+  bound_descriptor_buffer_sets_.fill({});
+
+  if (used_descriptor_pools_.empty() && used_descriptor_buffers_.empty()) {
     // No resources to free.
     return DescriptorSetGroup{};
   }
@@ -232,7 +455,8 @@ DescriptorSetGroup DescriptorSetArena::Flush() {
     bucket = {};
   }
   return DescriptorSetGroup(descriptor_pool_cache_,
-                            std::move(used_descriptor_pools_));
+                            std::move(used_descriptor_pools_),
+                            std::move(used_descriptor_buffers_));
 }
 
 }  // namespace vulkan
@@ -10,6 +10,7 @@
 #include <stdint.h>
 
 #include <array>
+#include <unordered_map>
 #include <vector>
 
 #include "iree/base/api.h"
@@ -26,6 +27,15 @@ namespace hal {
 namespace vulkan {
 
 // A reusable arena for allocating descriptor sets and batching updates.
+//
+// Descriptor sets are immutable once updated and bound so when the same
+// layout is bound with identical buffer ranges multiple times before the arena
+// is flushed the previously allocated set is bound again instead of
+// allocating and updating a new one.
+//
+// When VK_EXT_descriptor_buffer is enabled descriptors are instead written
+// directly into host-visible descriptor buffers and bound by offset, avoiding
+// descriptor set allocation entirely.
 class DescriptorSetArena final {
  public:
   explicit DescriptorSetArena(DescriptorPoolCache* descriptor_pool_cache);
@@ -54,6 +64,47 @@ class DescriptorSetArena final {
                          uint32_t set, iree_host_size_t binding_count,
                          const iree_hal_descriptor_set_binding_t* bindings);
 
+  // Writes the descriptor set into the current descriptor buffer and binds it
+  // to the command buffer. Only valid with VK_EXT_descriptor_buffer.
+  iree_status_t WriteDescriptorBuffer(
+      VkCommandBuffer command_buffer,
+      iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set,
+      iree_host_size_t binding_count,
+      const iree_hal_descriptor_set_binding_t* bindings);
+
+  // Reserves |size| bytes in the current descriptor buffer, acquiring and
+  // binding a new one if required.
+  iree_status_t ReserveDescriptorBuffer(VkCommandBuffer command_buffer,
+                                        VkDeviceSize size,
+                                        VkDeviceSize* out_offset);
+
+  // A single buffer binding within a cached descriptor set.
+  struct CachedBinding {
+    uint32_t binding;
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkDeviceSize range;
+    bool operator==(const CachedBinding& other) const {
+      return binding == other.binding && buffer == other.buffer &&
+             offset == other.offset && range == other.range;
+    }
+  };
+
+  // A descriptor set allocated from the arena and the contents it was
+  // updated with.
+  struct CachedDescriptorSet {
+    VkDescriptorSetLayout set_layout;
+    std::vector<CachedBinding> bindings;
+    VkDescriptorSet handle;
+  };
+
+  // Returns a previously allocated descriptor set matching |set_layout| and
+  // |write_infos| or VK_NULL_HANDLE if none exists.
+  VkDescriptorSet LookupDescriptorSet(VkDescriptorSetLayout set_layout,
+                                      uint64_t key_hash,
+                                      iree_host_size_t write_info_count,
+                                      const VkWriteDescriptorSet* write_infos);
+
   VkDeviceHandle* logical_device_;
   DescriptorPoolCache* descriptor_pool_cache_;
 
@@ -66,6 +117,33 @@ class DescriptorSetArena final {
 
   // All pools that have been used during allocation.
   std::vector<DescriptorPool> used_descriptor_pools_;
+
+  // Descriptor sets allocated from |used_descriptor_pools_| keyed by a hash of
+  // their layout and bindings. Cleared when the arena is flushed as the sets
+  // are returned to the pool cache with the pools they were allocated from.
+  std::unordered_multimap<uint64_t, CachedDescriptorSet> cached_sets_;
+
+  // Maximum number of descriptor sets tracked when binding descriptor buffers.
+  static constexpr uint32_t kMaxBoundDescriptorSets = 8;
+
+  // A descriptor set bound from the current descriptor buffer.
+  struct BoundDescriptorBufferSet {
+    VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+  };
+
+  // Descriptor buffer currently bound to the command buffer, if any.
+  DescriptorBuffer current_descriptor_buffer_;
+  // Offset of the next unused byte in |current_descriptor_buffer_|.
+  VkDeviceSize current_descriptor_buffer_offset_ = 0;
+  // All descriptor buffers that have been used during recording.
+  std::vector<DescriptorBuffer> used_descriptor_buffers_;
+  // Sets bound from |current_descriptor_buffer_| by set index. Binding a new
+  // descriptor buffer changes what previously set offsets refer to so the
+  // bound sets are carried over into the new buffer.
+  std::array<BoundDescriptorBufferSet, kMaxBoundDescriptorSets>
+      bound_descriptor_buffer_sets_;
 };
 
 }  // namespace vulkan
@@ -36,6 +36,12 @@ typedef struct iree_hal_vulkan_direct_command_buffer_t {
   VkCommandPoolHandle* command_pool;
   VkCommandBuffer handle;
 
+  // Execution stages and access scopes supported by the queue family the
+  // command buffer is allocated from. Transfer-only queue families support
+  // neither compute shader stages nor shader accesses in barriers.
+  iree_hal_execution_stage_t supported_stages;
+  iree_hal_access_scope_t supported_scopes;
+
   DynamicSymbols* syms;
 
   // Maintains a reference to all resources used within the command buffer.
@@ -125,6 +131,19 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
     command_buffer->command_pool = command_pool;
     command_buffer->handle = handle;
     command_buffer->syms = logical_device->syms().get();
+    command_buffer->supported_stages = ~(iree_hal_execution_stage_t)0;
+    command_buffer->supported_scopes = ~(iree_hal_access_scope_t)0;
+    if (!iree_all_bits_set(command_categories,
+                           IREE_HAL_COMMAND_CATEGORY_DISPATCH)) {
+      command_buffer->supported_stages &=
+          ~(IREE_HAL_EXECUTION_STAGE_COMMAND_PROCESS |
+            IREE_HAL_EXECUTION_STAGE_DISPATCH);
+      command_buffer->supported_scopes &=
+          ~(IREE_HAL_ACCESS_SCOPE_INDIRECT_COMMAND_READ |
+            IREE_HAL_ACCESS_SCOPE_CONSTANT_READ |
+            IREE_HAL_ACCESS_SCOPE_DISPATCH_READ |
+            IREE_HAL_ACCESS_SCOPE_DISPATCH_WRITE);
+    }
 
     new (&command_buffer->descriptor_set_arena)
         DescriptorSetArena(descriptor_pool_cache);
@@ -296,6 +315,17 @@ static VkPipelineStageFlags iree_hal_vulkan_convert_pipeline_stage_flags(
   return flags;
 }
 
+// Converts |stage_mask| to the pipeline stages supported by the queue family
+// of |command_buffer|. Vulkan requires a non-zero stage mask so masks with no
+// supported stages conservatively cover all commands.
+static VkPipelineStageFlags iree_hal_vulkan_direct_command_buffer_stage_flags(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_execution_stage_t stage_mask) {
+  VkPipelineStageFlags flags = iree_hal_vulkan_convert_pipeline_stage_flags(
+      stage_mask & command_buffer->supported_stages);
+  return flags ? flags : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+}
+
 static VkAccessFlags iree_hal_vulkan_convert_access_mask(
     iree_hal_access_scope_t access_mask) {
   VkAccessFlags flags = 0;
@@ -333,6 +363,15 @@ static VkAccessFlags iree_hal_vulkan_convert_access_mask(
   return flags;
 }
 
+// Converts |access_mask| to the access types supported by the queue family of
+// |command_buffer|.
+static VkAccessFlags iree_hal_vulkan_direct_command_buffer_access_mask(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_access_scope_t access_mask) {
+  return iree_hal_vulkan_convert_access_mask(access_mask &
+                                             command_buffer->supported_scopes);
+}
+
 static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_execution_stage_t source_stage_mask,
@@ -355,9 +394,11 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     info->sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     info->pNext = NULL;
     info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.source_scope);
+        iree_hal_vulkan_direct_command_buffer_access_mask(
+            command_buffer, memory_barrier.source_scope);
     info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.target_scope);
+        iree_hal_vulkan_direct_command_buffer_access_mask(
+            command_buffer, memory_barrier.target_scope);
   }
 
   iree_inline_array(VkBufferMemoryBarrier, buffer_barrier_infos,
@@ -368,9 +409,11 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     info->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
     info->pNext = NULL;
     info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.source_scope);
+        iree_hal_vulkan_direct_command_buffer_access_mask(
+            command_buffer, buffer_barrier.source_scope);
     info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.target_scope);
+        iree_hal_vulkan_direct_command_buffer_access_mask(
+            command_buffer, buffer_barrier.target_scope);
     info->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->buffer = iree_hal_vulkan_buffer_handle(buffer_barrier.buffer);
@@ -380,8 +423,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
 
   command_buffer->syms->vkCmdPipelineBarrier(
       command_buffer->handle,
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask),
-      iree_hal_vulkan_convert_pipeline_stage_flags(target_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stage_flags(
+          command_buffer, source_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stage_flags(
+          command_buffer, target_stage_mask),
       /*dependencyFlags=*/0, (uint32_t)memory_barrier_count,
       iree_inline_array_data(memory_barrier_infos),
       (uint32_t)buffer_barrier_count,
@@ -404,7 +449,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_signal_event(
 
   command_buffer->syms->vkCmdSetEvent(
       command_buffer->handle, iree_hal_vulkan_native_event_handle(event),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask));
+      iree_hal_vulkan_direct_command_buffer_stage_flags(
+          command_buffer, source_stage_mask));
 
   return iree_ok_status();
 }
@@ -420,7 +466,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_reset_event(
 
   command_buffer->syms->vkCmdResetEvent(
       command_buffer->handle, iree_hal_vulkan_native_event_handle(event),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask));
+      iree_hal_vulkan_direct_command_buffer_stage_flags(
+          command_buffer, source_stage_mask));
 
   return iree_ok_status();
 }
@@ -456,9 +503,11 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
     info->sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     info->pNext = NULL;
     info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.source_scope);
+        iree_hal_vulkan_direct_command_buffer_access_mask(
+            command_buffer, memory_barrier.source_scope);
     info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.target_scope);
+        iree_hal_vulkan_direct_command_buffer_access_mask(
+            command_buffer, memory_barrier.target_scope);
   }
 
   iree_inline_array(VkBufferMemoryBarrier, buffer_barrier_infos,
@@ -469,9 +518,11 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
     info->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
     info->pNext = NULL;
     info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.source_scope);
+        iree_hal_vulkan_direct_command_buffer_access_mask(
+            command_buffer, buffer_barrier.source_scope);
     info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.target_scope);
+        iree_hal_vulkan_direct_command_buffer_access_mask(
+            command_buffer, buffer_barrier.target_scope);
     info->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->buffer = iree_hal_vulkan_buffer_handle(buffer_barrier.buffer);
@@ -482,8 +533,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
   command_buffer->syms->vkCmdWaitEvents(
       command_buffer->handle, (uint32_t)event_count,
       iree_inline_array_data(event_handles),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask),
-      iree_hal_vulkan_convert_pipeline_stage_flags(target_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stage_flags(
+          command_buffer, source_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stage_flags(
+          command_buffer, target_stage_mask),
       (uint32_t)memory_barrier_count,
       iree_inline_array_data(memory_barrier_infos),
       (uint32_t)buffer_barrier_count,
@@ -533,6 +586,19 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_fill_buffer(
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
   VkBuffer target_device_buffer = iree_hal_vulkan_buffer_handle(target_buffer);
 
+  // Unaligned fills are polyfilled with a dispatch that can't be recorded
+  // into command buffers allocated for transfer-only queue families. The
+  // device records these again for a dispatch queue when this fails.
+  const bool is_aligned = target_offset % 4 == 0 && length % 4 == 0;
+  if (!is_aligned &&
+      !iree_all_bits_set(
+          iree_hal_command_buffer_allowed_categories(base_command_buffer),
+          IREE_HAL_COMMAND_CATEGORY_DISPATCH)) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "unaligned fills require a command buffer supporting dispatches");
+  }
+
   IREE_VULKAN_TRACE_ZONE_BEGIN(command_buffer->tracing_context,
                                command_buffer->handle);
 
@@ -543,7 +609,7 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_fill_buffer(
   // length. We use a polyfill here that fills the unaligned start and end of
   // fill operations, if needed.
 
-  if (target_offset % 4 != 0 || length % 4 != 0) {
+  if (!is_aligned) {
     // TODO(scotttodd): only restore push constants that have been modified?
     //                  (this can pass uninitialized memory right now, which
     //                   *should* be safe but is wasteful)
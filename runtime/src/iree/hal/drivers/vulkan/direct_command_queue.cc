@@ -7,6 +7,7 @@
 #include "iree/hal/drivers/vulkan/direct_command_queue.h"
 
 #include <cstdint>
+#include <cstring>
 
 #include "iree/hal/drivers/vulkan/direct_command_buffer.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
@@ -22,7 +23,8 @@ namespace vulkan {
 DirectCommandQueue::DirectCommandQueue(
     VkDeviceHandle* logical_device,
     iree_hal_command_category_t supported_categories, VkQueue queue)
-    : CommandQueue(logical_device, supported_categories, queue) {}
+    : CommandQueue(logical_device, supported_categories, queue),
+      submit_arena_(4 * 1024) {}
 
 DirectCommandQueue::~DirectCommandQueue() = default;
 
@@ -95,27 +97,100 @@ iree_status_t DirectCommandQueue::Submit(
     iree_host_size_t batch_count, const iree_hal_submission_batch_t* batches) {
   IREE_TRACE_SCOPE_NAMED("DirectCommandQueue::Submit");
 
+  iree_slim_mutex_lock(&queue_mutex_);
+
   // Map the submission batches to VkSubmitInfos.
   // Note that we must keep all arrays referenced alive until submission
-  // completes and since there are a bunch of them we use an arena.
-  Arena arena(4 * 1024);
-  auto submit_infos = arena.AllocateSpan<VkSubmitInfo>(batch_count);
+  // completes and since there are a bunch of them we use an arena. The arena
+  // is shared by all submissions to the queue and retains its blocks when
+  // reset.
+  Arena* arena = &submit_arena_;
+  auto submit_infos = arena->AllocateSpan<VkSubmitInfo>(batch_count);
   auto timeline_submit_infos =
-      arena.AllocateSpan<VkTimelineSemaphoreSubmitInfo>(batch_count);
-  for (int i = 0; i < batch_count; ++i) {
-    IREE_RETURN_IF_ERROR(TranslateBatchInfo(&batches[i], &submit_infos[i],
-                                            &timeline_submit_infos[i], &arena));
+      arena->AllocateSpan<VkTimelineSemaphoreSubmitInfo>(batch_count);
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < batch_count && iree_status_is_ok(status);
+       ++i) {
+    status = TranslateBatchInfo(&batches[i], &submit_infos[i],
+                                &timeline_submit_infos[i], arena);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        syms()->vkQueueSubmit(queue_,
+                              static_cast<uint32_t>(submit_infos.size()),
+                              submit_infos.data(), VK_NULL_HANDLE),
+        "vkQueueSubmit");
   }
 
+  arena->Reset();
+  iree_slim_mutex_unlock(&queue_mutex_);
+  return status;
+}
+
+iree_status_t DirectCommandQueue::BindSparse(
+    const iree_hal_semaphore_list_t wait_semaphores,
+    const iree_hal_semaphore_list_t signal_semaphores, VkBuffer buffer,
+    iree_host_size_t bind_count, const VkSparseMemoryBind* binds) {
+  IREE_TRACE_SCOPE_NAMED("DirectCommandQueue::BindSparse");
+
   iree_slim_mutex_lock(&queue_mutex_);
+
+  Arena* arena = &submit_arena_;
+  auto wait_semaphore_handles =
+      arena->AllocateSpan<VkSemaphore>(wait_semaphores.count);
+  auto wait_semaphore_values =
+      arena->AllocateSpan<uint64_t>(wait_semaphores.count);
+  for (iree_host_size_t i = 0; i < wait_semaphores.count; ++i) {
+    wait_semaphore_handles[i] =
+        iree_hal_vulkan_native_semaphore_handle(wait_semaphores.semaphores[i]);
+    wait_semaphore_values[i] = wait_semaphores.payload_values[i];
+  }
+  auto signal_semaphore_handles =
+      arena->AllocateSpan<VkSemaphore>(signal_semaphores.count);
+  auto signal_semaphore_values =
+      arena->AllocateSpan<uint64_t>(signal_semaphores.count);
+  for (iree_host_size_t i = 0; i < signal_semaphores.count; ++i) {
+    signal_semaphore_handles[i] = iree_hal_vulkan_native_semaphore_handle(
+        signal_semaphores.semaphores[i]);
+    signal_semaphore_values[i] = signal_semaphores.payload_values[i];
+  }
+
+  VkTimelineSemaphoreSubmitInfo timeline_submit_info;
+  timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timeline_submit_info.pNext = nullptr;
+  timeline_submit_info.waitSemaphoreValueCount =
+      static_cast<uint32_t>(wait_semaphore_values.size());
+  timeline_submit_info.pWaitSemaphoreValues = wait_semaphore_values.data();
+  timeline_submit_info.signalSemaphoreValueCount =
+      static_cast<uint32_t>(signal_semaphore_values.size());
+  timeline_submit_info.pSignalSemaphoreValues = signal_semaphore_values.data();
+
+  VkSparseBufferMemoryBindInfo buffer_bind_info;
+  buffer_bind_info.buffer = buffer;
+  buffer_bind_info.bindCount = static_cast<uint32_t>(bind_count);
+  buffer_bind_info.pBinds = binds;
+
+  // A bind with no memory ranges is still used to order the semaphores.
+  VkBindSparseInfo bind_info;
+  memset(&bind_info, 0, sizeof(bind_info));
+  bind_info.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+  bind_info.pNext = &timeline_submit_info;
+  bind_info.waitSemaphoreCount =
+      static_cast<uint32_t>(wait_semaphore_handles.size());
+  bind_info.pWaitSemaphores = wait_semaphore_handles.data();
+  bind_info.bufferBindCount = bind_count > 0 ? 1 : 0;
+  bind_info.pBufferBinds = &buffer_bind_info;
+  bind_info.signalSemaphoreCount =
+      static_cast<uint32_t>(signal_semaphore_handles.size());
+  bind_info.pSignalSemaphores = signal_semaphore_handles.data();
+
   iree_status_t status = VK_RESULT_TO_STATUS(
-      syms()->vkQueueSubmit(queue_, static_cast<uint32_t>(submit_infos.size()),
-                            submit_infos.data(), VK_NULL_HANDLE),
-      "vkQueueSubmit");
+      syms()->vkQueueBindSparse(queue_, 1, &bind_info, VK_NULL_HANDLE),
+      "vkQueueBindSparse");
+  arena->Reset();
   iree_slim_mutex_unlock(&queue_mutex_);
-  IREE_RETURN_IF_ERROR(status);
-
-  return iree_ok_status();
+  return status;
 }
 
 iree_status_t DirectCommandQueue::WaitIdle(iree_timeout_t timeout) {
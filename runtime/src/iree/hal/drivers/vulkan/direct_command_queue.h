@@ -28,12 +28,22 @@ class DirectCommandQueue final : public CommandQueue {
   iree_status_t Submit(iree_host_size_t batch_count,
                        const iree_hal_submission_batch_t* batches) override;
 
+  iree_status_t BindSparse(const iree_hal_semaphore_list_t wait_semaphores,
+                           const iree_hal_semaphore_list_t signal_semaphores,
+                           VkBuffer buffer, iree_host_size_t bind_count,
+                           const VkSparseMemoryBind* binds) override;
+
   iree_status_t WaitIdle(iree_timeout_t timeout) override;
 
  private:
   iree_status_t TranslateBatchInfo(
       const iree_hal_submission_batch_t* batch, VkSubmitInfo* submit_info,
       VkTimelineSemaphoreSubmitInfo* timeline_submit_info, Arena* arena);
+
+  // Scratch storage for the Vulkan structures built for each submission.
+  // Reset after every use so that its blocks are retained and steady-state
+  // submissions do not allocate.
+  Arena submit_arena_ IREE_GUARDED_BY(queue_mutex_);
 };
 
 }  // namespace vulkan
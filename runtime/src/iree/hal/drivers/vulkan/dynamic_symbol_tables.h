@@ -243,7 +243,7 @@ namespace vulkan {
   DEV_PFN(EXCLUDED, vkGetImageSubresourceLayout)                        \
   DEV_PFN(EXCLUDED, vkGetImageViewHandleNVX)                            \
   DEV_PFN(EXCLUDED, vkGetMemoryFdKHR)                                   \
-  DEV_PFN(EXCLUDED, vkGetMemoryFdPropertiesKHR)                         \
+  DEV_PFN(OPTIONAL, vkGetMemoryFdPropertiesKHR)                         \
   DEV_PFN(OPTIONAL, vkGetMemoryHostPointerPropertiesEXT)                \
   DEV_PFN(EXCLUDED, vkGetPastPresentationTimingGOOGLE)                  \
   DEV_PFN(REQUIRED, vkGetPipelineCacheData)                             \
@@ -296,6 +296,12 @@ namespace vulkan {
   DEV_PFN(OPTIONAL, vkGetBufferDeviceAddress)                           \
   DEV_PFN(OPTIONAL, vkGetBufferDeviceAddressKHR)                        \
                                                                         \
+  DEV_PFN(OPTIONAL, vkCmdBindDescriptorBuffersEXT)                      \
+  DEV_PFN(OPTIONAL, vkCmdSetDescriptorBufferOffsetsEXT)                 \
+  DEV_PFN(OPTIONAL, vkGetDescriptorEXT)                                 \
+  DEV_PFN(OPTIONAL, vkGetDescriptorSetLayoutBindingOffsetEXT)           \
+  DEV_PFN(OPTIONAL, vkGetDescriptorSetLayoutSizeEXT)                    \
+                                                                        \
   INS_PFN(EXCLUDED, vkCreateDebugReportCallbackEXT)                     \
   INS_PFN(OPTIONAL, vkCreateDebugUtilsMessengerEXT)                     \
   INS_PFN(EXCLUDED, vkCreateDisplayPlaneSurfaceKHR)                     \
@@ -329,7 +335,7 @@ namespace vulkan {
   INS_PFN(EXCLUDED, vkGetPhysicalDeviceExternalFenceProperties)         \
   INS_PFN(EXCLUDED, vkGetPhysicalDeviceExternalFencePropertiesKHR)      \
   INS_PFN(EXCLUDED, vkGetPhysicalDeviceExternalImageFormatPropertiesNV) \
-  INS_PFN(EXCLUDED, vkGetPhysicalDeviceExternalSemaphoreProperties)     \
+  INS_PFN(OPTIONAL, vkGetPhysicalDeviceExternalSemaphoreProperties)     \
   INS_PFN(EXCLUDED, vkGetPhysicalDeviceExternalSemaphorePropertiesKHR)  \
   INS_PFN(REQUIRED, vkGetPhysicalDeviceFeatures)                        \
   INS_PFN(REQUIRED, vkGetPhysicalDeviceFeatures2)                       \
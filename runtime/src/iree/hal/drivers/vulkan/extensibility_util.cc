@@ -213,6 +213,15 @@ iree_hal_vulkan_populate_enabled_device_extensions(
     } else if (strcmp(extension_name,
                       VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME) == 0) {
       extensions.external_memory_host = true;
+    } else if (strcmp(extension_name,
+                      VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME) == 0) {
+      extensions.external_memory_fd = true;
+    } else if (strcmp(extension_name,
+                      VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME) == 0) {
+      extensions.external_memory_dma_buf = true;
+    } else if (strcmp(extension_name,
+                      VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME) == 0) {
+      extensions.external_semaphore_fd = true;
     } else if (strcmp(extension_name,
                       VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME) == 0) {
       extensions.buffer_device_address = true;
@@ -225,6 +234,13 @@ iree_hal_vulkan_populate_enabled_device_extensions(
     } else if (strcmp(extension_name,
                       VK_KHR_COOPERATIVE_MATRIX_EXTENSION_NAME) == 0) {
       extensions.cooperative_matrix = true;
+    } else if (strcmp(extension_name,
+                      VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) == 0) {
+      extensions.descriptor_buffer = true;
+    } else if (strcmp(extension_name,
+                      VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME) ==
+               0) {
+      extensions.pipeline_creation_cache_control = true;
     }
   }
   return extensions;
@@ -250,9 +266,17 @@ iree_hal_vulkan_infer_enabled_device_extensions(
   if (device_syms->vkGetMemoryHostPointerPropertiesEXT) {
     extensions.external_memory_host = true;
   }
+  if (device_syms->vkGetMemoryFdPropertiesKHR) {
+    extensions.external_memory_fd = true;
+  }
+  if (device_syms->vkImportSemaphoreFdKHR) {
+    extensions.external_semaphore_fd = true;
+  }
   if (device_syms->vkGetBufferDeviceAddress ||
       device_syms->vkGetBufferDeviceAddressKHR) {
     extensions.buffer_device_address = true;
   }
+  // NOTE: descriptor_buffer is never inferred as using it requires device
+  // features we cannot query on a device we did not create.
   return extensions;
 }
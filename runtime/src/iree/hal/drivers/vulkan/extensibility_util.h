@@ -84,6 +84,12 @@ typedef struct iree_hal_vulkan_device_extensions_t {
   bool subgroup_size_control : 1;
   // VK_EXT_external_memory_host is enabled.
   bool external_memory_host : 1;
+  // VK_KHR_external_memory_fd is enabled.
+  bool external_memory_fd : 1;
+  // VK_EXT_external_memory_dma_buf is enabled.
+  bool external_memory_dma_buf : 1;
+  // VK_KHR_external_semaphore_fd is enabled.
+  bool external_semaphore_fd : 1;
   // VK_KHR_buffer_device_address is enabled.
   bool buffer_device_address : 1;
   // VK_KHR_8bit_storage is enabled.
@@ -92,6 +98,13 @@ typedef struct iree_hal_vulkan_device_extensions_t {
   bool shader_float16_int8 : 1;
   // VK_KHR_cooperative_matrix is enabled.
   bool cooperative_matrix : 1;
+  // VK_EXT_descriptor_buffer is enabled along with the descriptorBuffer and
+  // bufferDeviceAddress features and descriptor buffers are used for all
+  // dispatch resource bindings.
+  bool descriptor_buffer : 1;
+  // VK_EXT_pipeline_creation_cache_control is enabled along with the
+  // pipelineCreationCacheControl feature.
+  bool pipeline_creation_cache_control : 1;
 } iree_hal_vulkan_device_extensions_t;
 
 // Returns a bitfield with all of the provided extension names.
@@ -114,6 +114,9 @@ class VkDeviceHandle : public RefObject<VkDeviceHandle> {
 
 class VkCommandPoolHandle {
  public:
+  // Maximum number of freed primary command buffers retained for reuse.
+  static constexpr iree_host_size_t kMaxFreeCommandBuffers = 32;
+
   explicit VkCommandPoolHandle(VkDeviceHandle* logical_device)
       : logical_device_(logical_device) {
     iree_slim_mutex_initialize(&mutex_);
@@ -128,17 +131,26 @@ class VkCommandPoolHandle {
   VkCommandPoolHandle(VkCommandPoolHandle&& other) noexcept
       : logical_device_(std::move(other.logical_device_)),
         value_(exchange(other.value_,
-                        static_cast<VkCommandPool>(VK_NULL_HANDLE))) {}
+                        static_cast<VkCommandPool>(VK_NULL_HANDLE))) {
+    iree_slim_mutex_initialize(&mutex_);
+    std::swap(free_handles_, other.free_handles_);
+    std::swap(free_count_, other.free_count_);
+  }
   VkCommandPoolHandle& operator=(VkCommandPoolHandle&& other) {
     std::swap(logical_device_, other.logical_device_);
     std::swap(value_, other.value_);
+    std::swap(free_handles_, other.free_handles_);
+    std::swap(free_count_, other.free_count_);
     return *this;
   }
 
   void reset() {
     if (value_ == VK_NULL_HANDLE) return;
+    // Destroying the pool frees all command buffers allocated from it,
+    // including those retained for reuse.
     syms()->vkDestroyCommandPool(*logical_device_, value_, allocator());
     value_ = VK_NULL_HANDLE;
+    free_count_ = 0;
   }
 
   VkCommandPool value() const noexcept { return value_; }
@@ -155,20 +167,38 @@ class VkCommandPoolHandle {
     return logical_device_->allocator();
   }
 
+  // Allocates command buffers from the pool. Single primary command buffers
+  // are taken from those previously returned with Free when available; the
+  // pool is created with VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT so
+  // they are implicitly reset by vkBeginCommandBuffer.
   iree_status_t Allocate(const VkCommandBufferAllocateInfo* allocate_info,
                          VkCommandBuffer* out_handle) {
     iree_slim_mutex_lock(&mutex_);
-    iree_status_t status =
-        VK_RESULT_TO_STATUS(syms()->vkAllocateCommandBuffers(
-                                *logical_device_, allocate_info, out_handle),
-                            "vkAllocateCommandBuffers");
+    iree_status_t status = iree_ok_status();
+    if (allocate_info->commandBufferCount == 1 &&
+        allocate_info->level == VK_COMMAND_BUFFER_LEVEL_PRIMARY &&
+        free_count_ > 0) {
+      *out_handle = free_handles_[--free_count_];
+    } else {
+      status = VK_RESULT_TO_STATUS(
+          syms()->vkAllocateCommandBuffers(*logical_device_, allocate_info,
+                                           out_handle),
+          "vkAllocateCommandBuffers");
+    }
     iree_slim_mutex_unlock(&mutex_);
     return status;
   }
 
+  // Returns a primary command buffer to the pool. The command buffer must not
+  // be pending execution. Up to kMaxFreeCommandBuffers handles are retained
+  // for reuse by Allocate and any beyond that are freed.
   void Free(VkCommandBuffer handle) {
     iree_slim_mutex_lock(&mutex_);
-    syms()->vkFreeCommandBuffers(*logical_device_, value_, 1, &handle);
+    if (free_count_ < kMaxFreeCommandBuffers) {
+      free_handles_[free_count_++] = handle;
+    } else {
+      syms()->vkFreeCommandBuffers(*logical_device_, value_, 1, &handle);
+    }
     iree_slim_mutex_unlock(&mutex_);
   }
 
@@ -180,6 +210,10 @@ class VkCommandPoolHandle {
   // synchronization. Since we allow arbitrary threads to allocate and
   // deallocate the HAL command buffers we need to externally synchronize.
   iree_slim_mutex_t mutex_;
+
+  // Command buffers returned with Free that are available for reuse.
+  VkCommandBuffer free_handles_[kMaxFreeCommandBuffers] IREE_GUARDED_BY(mutex_);
+  iree_host_size_t free_count_ IREE_GUARDED_BY(mutex_) = 0;
 };
 
 }  // namespace vulkan
@@ -4,6 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <cerrno>
 #include <cstddef>
 #include <cstring>
 
@@ -18,6 +19,10 @@
 #include <sys/mman.h>
 #endif  // IREE_PLATFORM_LINUX
 
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <unistd.h>
+#endif  // !IREE_PLATFORM_WINDOWS
+
 using namespace iree::hal::vulkan;
 
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
@@ -348,7 +353,8 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
     VkDeviceHandle* logical_device,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
     iree_device_size_t allocation_size, bool use_sparse_allocation,
-    bool bind_host_memory, VkBuffer* out_handle) {
+    VkExternalMemoryHandleTypeFlagBits external_handle_type,
+    VkBuffer* out_handle) {
   IREE_ASSERT_ARGUMENT(logical_device);
   IREE_ASSERT_ARGUMENT(params);
   *out_handle = VK_NULL_HANDLE;
@@ -371,6 +377,10 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
     buffer_create_info.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
     buffer_create_info.usage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     buffer_create_info.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    // Descriptor buffers reference storage buffers by device address.
+    if (logical_device->enabled_extensions().descriptor_buffer) {
+      buffer_create_info.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    }
   }
   if (use_sparse_allocation) {
     buffer_create_info.flags |= VK_BUFFER_CREATE_SPARSE_BINDING_BIT |
@@ -382,7 +392,7 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
 
   // If trying to bind to external memory we need to verify we can create a
   // buffer that can be bound.
-  if (bind_host_memory) {
+  if (external_handle_type) {
     VkPhysicalDeviceExternalBufferInfo external_info;
     memset(&external_info, 0, sizeof(external_info));
     external_info.sType =
@@ -390,8 +400,7 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
     external_info.pNext = NULL;
     external_info.flags = buffer_create_info.flags;
     external_info.usage = buffer_create_info.usage;
-    external_info.handleType =
-        VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+    external_info.handleType = external_handle_type;
     VkExternalBufferProperties external_props;
     memset(&external_props, 0, sizeof(external_props));
     external_props.sType = VK_STRUCTURE_TYPE_EXTERNAL_BUFFER_PROPERTIES;
@@ -406,7 +415,7 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
           iree_hal_buffer_usage_format(params->usage, &temp0);
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                               "implementation does not support binding "
-                              "imported host memory to buffers for usage=%.*s",
+                              "imported memory to buffers for usage=%.*s",
                               (int)usage_str.size, usage_str.data);
 #else
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
@@ -414,15 +423,15 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
     }
     if (!iree_all_bits_set(
             external_props.externalMemoryProperties.compatibleHandleTypes,
-            VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT)) {
+            external_handle_type)) {
 #if IREE_STATUS_MODE
       iree_bitfield_string_temp_t temp0;
       iree_string_view_t usage_str =
           iree_hal_buffer_usage_format(params->usage, &temp0);
       return iree_make_status(
           IREE_STATUS_UNIMPLEMENTED,
-          "implementation does not support binding external host allocations "
-          "to buffers for usage=%.*s",
+          "implementation does not support binding external allocations of "
+          "this handle type to buffers for usage=%.*s",
           (int)usage_str.size, usage_str.data);
 #else
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
@@ -431,12 +440,11 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
   }
 
   VkExternalMemoryBufferCreateInfo external_create_info = {};
-  if (bind_host_memory) {
+  if (external_handle_type) {
     external_create_info.sType =
         VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO;
     external_create_info.pNext = NULL;
-    external_create_info.handleTypes =
-        VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
+    external_create_info.handleTypes = external_handle_type;
     buffer_create_info.pNext = &external_create_info;
   }
 
@@ -479,7 +487,8 @@ static iree_status_t iree_hal_vulkan_native_allocator_allocate_internal(
   VkBuffer handle = VK_NULL_HANDLE;
   IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_allocator_create_buffer(
       logical_device, params, allocation_size, use_sparse_allocation,
-      /*bind_host_memory=*/false, &handle));
+      /*external_handle_type=*/(VkExternalMemoryHandleTypeFlagBits)0,
+      &handle));
 
   // Commit the backing memory for the buffer and wrap it in a HAL buffer type.
   // If this fails the buffer may still be set and need to be released below.
@@ -504,8 +513,10 @@ static iree_status_t iree_hal_vulkan_native_allocator_allocate_internal(
                          allocation_size);
 
   if (iree_status_is_ok(status)) {
-    iree_hal_allocator_statistics_record_alloc(
-        &allocator->statistics, params->type, buffer->allocation_size);
+    buffer->allocation_tag = params->tag;
+    iree_hal_allocator_statistics_record_alloc(&allocator->statistics,
+                                               params->type, params->tag,
+                                               buffer->allocation_size);
     *out_buffer = buffer;
   } else {
     iree_hal_buffer_release(buffer);
@@ -542,9 +553,10 @@ static void iree_hal_vulkan_native_allocator_deallocate_buffer(
   iree_hal_vulkan_native_allocator_t* allocator =
       iree_hal_vulkan_native_allocator_cast(base_allocator);
   (void)allocator;
-  iree_hal_allocator_statistics_record_free(&allocator->statistics,
-                                            base_buffer->memory_type,
-                                            base_buffer->allocation_size);
+  iree_hal_allocator_statistics_record_free(
+      &allocator->statistics, base_buffer->memory_type,
+      (iree_hal_allocation_tag_t)base_buffer->allocation_tag,
+      base_buffer->allocation_size);
   iree_hal_buffer_destroy(base_buffer);
 }
 
@@ -662,7 +674,7 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_host_buffer(
   IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_allocator_create_buffer(
       logical_device, params, external_buffer->size,
       /*use_sparse_allocation=*/false,
-      /*bind_host_memory=*/true, &handle));
+      VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT, &handle));
 
   // Ask Vulkan what the implementation requires of the allocation(s) for the
   // buffer. We should in most cases always get the same kind of values but
@@ -708,6 +720,13 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_host_buffer(
   import_host_ptr_info.handleType =
       VK_EXTERNAL_MEMORY_HANDLE_TYPE_HOST_ALLOCATION_BIT_EXT;
   allocate_info.pNext = &import_host_ptr_info;
+  VkMemoryAllocateFlagsInfo allocate_flags_info = {};
+  if (logical_device->enabled_extensions().descriptor_buffer) {
+    allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocate_flags_info.pNext = NULL;
+    allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    import_host_ptr_info.pNext = &allocate_flags_info;
+  }
   VkDeviceMemory device_memory = VK_NULL_HANDLE;
   IREE_TRACE_ZONE_BEGIN_NAMED(z_c, "vkAllocateMemory");
   status = VK_RESULT_TO_STATUS(logical_device->syms()->vkAllocateMemory(
@@ -793,7 +812,8 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_device_buffer(
   IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_allocator_create_buffer(
       logical_device, params, external_buffer->size,
       /*use_sparse_allocation=*/false,
-      /*bind_host_memory=*/false, &handle));
+      /*external_handle_type=*/(VkExternalMemoryHandleTypeFlagBits)0,
+      &handle));
 
   // Bind the memory to the buffer.
   IREE_TRACE_ZONE_BEGIN_NAMED(z_a, "vkBindBufferMemory");
@@ -822,6 +842,174 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_device_buffer(
       handle, internal_release_callback, release_callback, out_buffer);
 }
 
+// Imports a POSIX file descriptor referencing device memory exported by another
+// API or process (OPAQUE_FD) or a Linux dma-buf (DMA_BUF). The caller retains
+// ownership of the file descriptor: Vulkan takes ownership of the descriptor
+// passed on a successful import so we hand it a duplicate.
+static iree_status_t iree_hal_vulkan_native_allocator_import_fd_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_hal_external_buffer_t* IREE_RESTRICT external_buffer,
+    iree_hal_buffer_release_callback_t release_callback,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+#if defined(IREE_PLATFORM_WINDOWS)
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file descriptor imports are not available on "
+                          "Windows; use OPAQUE_WIN32 handles instead");
+#else
+  iree_hal_vulkan_native_allocator_t* allocator =
+      iree_hal_vulkan_native_allocator_cast(base_allocator);
+  VkDeviceHandle* logical_device = allocator->logical_device;
+
+  VkExternalMemoryHandleTypeFlagBits handle_type =
+      (VkExternalMemoryHandleTypeFlagBits)0;
+  int fd = -1;
+  bool is_supported = false;
+  if (external_buffer->type == IREE_HAL_EXTERNAL_BUFFER_TYPE_DMA_BUF) {
+    handle_type = VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT;
+    fd = external_buffer->handle.dma_buf.fd;
+    is_supported = logical_device->enabled_extensions().external_memory_dma_buf;
+  } else {
+    handle_type = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT;
+    fd = external_buffer->handle.opaque_fd.fd;
+    is_supported = logical_device->enabled_extensions().external_memory_fd;
+  }
+  if (!is_supported) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "external file descriptor memory import is not supported on this "
+        "device");
+  }
+  if (IREE_UNLIKELY(fd < 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid file descriptor %d", fd);
+  }
+
+  // dma-bufs can be queried for the memory types they are compatible with.
+  // Opaque fds cannot (and must be imported with the same memory type they
+  // were exported with) so we trust the params to select the right one.
+  uint32_t allowed_type_bits = UINT32_MAX;
+  if (handle_type == VK_EXTERNAL_MEMORY_HANDLE_TYPE_DMA_BUF_BIT_EXT &&
+      logical_device->syms()->vkGetMemoryFdPropertiesKHR) {
+    VkMemoryFdPropertiesKHR fd_props = {};
+    fd_props.sType = VK_STRUCTURE_TYPE_MEMORY_FD_PROPERTIES_KHR;
+    fd_props.pNext = NULL;
+    IREE_RETURN_IF_ERROR(VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkGetMemoryFdPropertiesKHR(
+            *logical_device, handle_type, fd, &fd_props),
+        "vkGetMemoryFdPropertiesKHR"));
+    allowed_type_bits = fd_props.memoryTypeBits;
+  }
+
+  // Create the unbound buffer first as we need it to query the requirements the
+  // imported memory must satisfy.
+  VkBuffer handle = VK_NULL_HANDLE;
+  IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_allocator_create_buffer(
+      logical_device, params, external_buffer->size,
+      /*use_sparse_allocation=*/false, handle_type, &handle));
+
+  VkMemoryRequirements requirements = {0};
+  logical_device->syms()->vkGetBufferMemoryRequirements(*logical_device, handle,
+                                                        &requirements);
+  iree_status_t status = iree_ok_status();
+  if (requirements.size > (VkDeviceSize)external_buffer->size) {
+    status = iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "external memory of %" PRIu64
+        " bytes is smaller than the %" PRIu64 " bytes the buffer requires",
+        (uint64_t)external_buffer->size, (uint64_t)requirements.size);
+  }
+  uint32_t memory_type_index = 0;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_find_memory_type(
+        &allocator->device_props, &allocator->memory_props, params,
+        /*allowed_type_indices=*/
+        (allowed_type_bits & requirements.memoryTypeBits), &memory_type_index);
+  }
+
+  // Vulkan takes ownership of the fd only if the import succeeds.
+  int import_fd = -1;
+  if (iree_status_is_ok(status)) {
+    import_fd = dup(fd);
+    if (import_fd < 0) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "unable to duplicate file descriptor %d", fd);
+    }
+  }
+
+  VkDeviceMemory device_memory = VK_NULL_HANDLE;
+  if (iree_status_is_ok(status)) {
+    VkMemoryAllocateInfo allocate_info = {};
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.pNext = NULL;
+    allocate_info.allocationSize = (VkDeviceSize)external_buffer->size;
+    allocate_info.memoryTypeIndex = memory_type_index;
+    VkImportMemoryFdInfoKHR import_fd_info = {};
+    import_fd_info.sType = VK_STRUCTURE_TYPE_IMPORT_MEMORY_FD_INFO_KHR;
+    import_fd_info.pNext = NULL;
+    import_fd_info.handleType = handle_type;
+    import_fd_info.fd = import_fd;
+    allocate_info.pNext = &import_fd_info;
+    VkMemoryDedicatedAllocateInfo dedicated_info = {};
+    if (iree_all_bits_set(external_buffer->flags,
+                          IREE_HAL_EXTERNAL_BUFFER_FLAG_DEDICATED)) {
+      dedicated_info.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO;
+      dedicated_info.pNext = NULL;
+      dedicated_info.image = VK_NULL_HANDLE;
+      dedicated_info.buffer = handle;
+      import_fd_info.pNext = &dedicated_info;
+    }
+    VkMemoryAllocateFlagsInfo allocate_flags_info = {};
+    if (logical_device->enabled_extensions().descriptor_buffer) {
+      allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+      allocate_flags_info.pNext = allocate_info.pNext;
+      allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+      allocate_info.pNext = &allocate_flags_info;
+    }
+    IREE_TRACE_ZONE_BEGIN_NAMED(z_a, "vkAllocateMemory");
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkAllocateMemory(*logical_device,
+                                                 &allocate_info,
+                                                 logical_device->allocator(),
+                                                 &device_memory),
+        "vkAllocateMemory");
+    IREE_TRACE_ZONE_END(z_a);
+    if (!iree_status_is_ok(status)) close(import_fd);
+  }
+
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z_b, "vkBindBufferMemory");
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkBindBufferMemory(
+            *logical_device, handle, device_memory, /*memoryOffset=*/0),
+        "vkBindBufferMemory");
+    IREE_TRACE_ZONE_END(z_b);
+  }
+
+  // The imported memory is owned by us now and freeing it drops the reference
+  // to the external allocation; the host buffer release does that for us.
+  if (iree_status_is_ok(status)) {
+    iree_hal_vulkan_native_buffer_release_callback_t
+        internal_release_callback = {0};
+    internal_release_callback.fn =
+        iree_hal_vulkan_native_allocator_external_host_buffer_release;
+    internal_release_callback.user_data = NULL;
+    status = iree_hal_vulkan_native_buffer_wrap(
+        (iree_hal_allocator_t*)allocator, params->type, params->access,
+        params->usage, (iree_device_size_t)external_buffer->size,
+        /*byte_offset=*/0,
+        /*byte_length=*/external_buffer->size, logical_device, device_memory,
+        handle, internal_release_callback, release_callback, out_buffer);
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_hal_vulkan_native_allocator_external_host_buffer_release(
+        NULL, logical_device, device_memory, handle);
+  }
+  return status;
+#endif  // IREE_PLATFORM_WINDOWS
+}
+
 static iree_status_t iree_hal_vulkan_native_allocator_import_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -837,6 +1025,11 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_buffer(
       return iree_hal_vulkan_native_allocator_import_device_buffer(
           base_allocator, params, external_buffer, release_callback,
           out_buffer);
+    case IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_FD:
+    case IREE_HAL_EXTERNAL_BUFFER_TYPE_DMA_BUF:
+      return iree_hal_vulkan_native_allocator_import_fd_buffer(
+          base_allocator, params, external_buffer, release_callback,
+          out_buffer);
     default:
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                               "external buffer type import not implemented");
@@ -853,6 +1046,96 @@ static iree_status_t iree_hal_vulkan_native_allocator_export_buffer(
                           "exporting to external buffers not supported");
 }
 
+iree_status_t iree_hal_vulkan_native_allocator_reserve_sparse_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  IREE_ASSERT_ARGUMENT(base_allocator);
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  if (!iree_hal_resource_is(base_allocator,
+                            &iree_hal_vulkan_native_allocator_vtable)) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "partially resident buffers require the native Vulkan allocator");
+  }
+  iree_hal_vulkan_native_allocator_t* allocator =
+      iree_hal_vulkan_native_allocator_cast(base_allocator);
+  VkDeviceHandle* logical_device = allocator->logical_device;
+  if (!iree_all_bits_set(
+          logical_device->enabled_features(),
+          IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_BINDING |
+              IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_RESIDENCY_ALIASED)) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "partially resident buffers require sparse binding and sparse "
+        "residency support to be present and enabled on this device");
+  }
+  if (iree_any_bit_set(params->usage,
+                       IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+                           IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT) &&
+      !iree_all_bits_set(params->usage,
+                         IREE_HAL_BUFFER_USAGE_MAPPING_OPTIONAL)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "partially resident buffers cannot be mapped");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  iree_hal_buffer_params_t compat_params = *params;
+  compat_params.type &= ~IREE_HAL_MEMORY_TYPE_OPTIMAL;
+  compat_params.usage &=
+      ~(IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+        IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT |
+        IREE_HAL_BUFFER_USAGE_MAPPING_OPTIONAL |
+        IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_RANDOM |
+        IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_SEQUENTIAL_WRITE);
+  allocation_size = iree_host_align(iree_max(allocation_size, 4), 4);
+
+  // Create the buffer handle with sparse residency; no memory is bound until
+  // ranges are committed.
+  VkBuffer handle = VK_NULL_HANDLE;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_vulkan_native_allocator_create_buffer(
+              logical_device, &compat_params, allocation_size,
+              /*use_sparse_allocation=*/true,
+              /*external_handle_type=*/(VkExternalMemoryHandleTypeFlagBits)0,
+              &handle));
+
+  VkMemoryRequirements requirements = {0};
+  logical_device->syms()->vkGetBufferMemoryRequirements(*logical_device, handle,
+                                                        &requirements);
+  uint32_t memory_type_index = 0;
+  iree_status_t status = iree_hal_vulkan_find_memory_type(
+      &allocator->device_props, &allocator->memory_props, &compat_params,
+      /*allowed_type_indices=*/requirements.memoryTypeBits,
+      &memory_type_index);
+
+  iree_hal_buffer_t* buffer = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_sparse_buffer_create_reserved(
+        base_allocator, compat_params.type, compat_params.access,
+        compat_params.usage, allocation_size, logical_device, handle,
+        requirements, memory_type_index,
+        allocator->device_props_11.maxMemoryAllocationSize, &buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    buffer->allocation_tag = compat_params.tag;
+    iree_hal_allocator_statistics_record_alloc(
+        &allocator->statistics, compat_params.type, compat_params.tag,
+        buffer->allocation_size);
+    *out_buffer = buffer;
+  } else {
+    logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
+                                            logical_device->allocator());
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 namespace {
 const iree_hal_allocator_vtable_t iree_hal_vulkan_native_allocator_vtable = {
     /*.destroy=*/iree_hal_vulkan_native_allocator_destroy,
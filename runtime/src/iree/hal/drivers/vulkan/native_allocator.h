@@ -23,6 +23,14 @@ iree_status_t iree_hal_vulkan_native_allocator_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
     iree_hal_allocator_t** out_allocator);
 
+// Reserves a partially resident sparse buffer of |allocation_size| bytes from
+// |allocator| with no device memory committed. Fails with
+// IREE_STATUS_UNAVAILABLE if |allocator| is not a native Vulkan allocator or
+// the device does not have sparse residency enabled.
+iree_status_t iree_hal_vulkan_native_allocator_reserve_sparse_buffer(
+    iree_hal_allocator_t* allocator, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -11,6 +11,7 @@
 #include <cstring>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/threading.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
 #include "iree/hal/drivers/vulkan/native_pipeline_layout.h"
@@ -59,8 +60,217 @@ static void iree_hal_vulkan_destroy_shader_module(
                                                 logical_device->allocator());
 }
 
+// A contiguous range of pipelines compiled with one vkCreateComputePipelines
+// call. Batches may run on their own threads.
+typedef struct iree_hal_vulkan_pipeline_batch_t {
+  VkDeviceHandle* logical_device;
+  VkPipelineCache pipeline_cache;
+  uint32_t create_info_count;
+  const VkComputePipelineCreateInfo* create_infos;
+  VkPipeline* pipelines;
+  VkResult result;
+} iree_hal_vulkan_pipeline_batch_t;
+
+static int iree_hal_vulkan_pipeline_batch_run(void* entry_arg) {
+  iree_hal_vulkan_pipeline_batch_t* batch =
+      (iree_hal_vulkan_pipeline_batch_t*)entry_arg;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, batch->create_info_count);
+  batch->result = batch->logical_device->syms()->vkCreateComputePipelines(
+      *batch->logical_device, batch->pipeline_cache, batch->create_info_count,
+      batch->create_infos, batch->logical_device->allocator(),
+      batch->pipelines);
+  IREE_TRACE_ZONE_END(z0);
+  return 0;
+}
+
+// Compiles |pipeline_count| pipelines from |create_infos| into |out_pipelines|
+// using up to |compile_concurrency| threads. The first create info of each
+// batch is made the base of the derivatives in that batch as derivative
+// indices are relative to the create infos of a single call.
+//
+// On failure all pipelines created are destroyed.
+static iree_status_t iree_hal_vulkan_compile_pipeline_batches(
+    VkDeviceHandle* logical_device, VkPipelineCache pipeline_cache,
+    iree_host_size_t compile_concurrency, iree_host_size_t pipeline_count,
+    VkComputePipelineCreateInfo* create_infos, VkPipeline* out_pipelines) {
+  IREE_TRACE_SCOPE();
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+    out_pipelines[i] = VK_NULL_HANDLE;
+  }
+
+  iree_host_size_t batch_count =
+      iree_max(1, iree_min(compile_concurrency, pipeline_count));
+  iree_hal_vulkan_pipeline_batch_t* batches = NULL;
+  iree_thread_t** threads = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, batch_count * (sizeof(*batches) + sizeof(*threads)),
+      (void**)&batches));
+  threads = (iree_thread_t**)(batches + batch_count);
+
+  // Distribute pipelines such that batch sizes differ by at most one.
+  iree_host_size_t pipeline_base = 0;
+  for (iree_host_size_t i = 0; i < batch_count; ++i) {
+    iree_host_size_t batch_size = pipeline_count / batch_count +
+                                  (i < pipeline_count % batch_count ? 1 : 0);
+    VkComputePipelineCreateInfo* batch_create_infos =
+        &create_infos[pipeline_base];
+    batch_create_infos[0].flags &= ~VK_PIPELINE_CREATE_DERIVATIVE_BIT;
+    batch_create_infos[0].flags |= VK_PIPELINE_CREATE_ALLOW_DERIVATIVES_BIT;
+    batches[i].logical_device = logical_device;
+    batches[i].pipeline_cache = pipeline_cache;
+    batches[i].create_info_count = (uint32_t)batch_size;
+    batches[i].create_infos = batch_create_infos;
+    batches[i].pipelines = &out_pipelines[pipeline_base];
+    batches[i].result = VK_SUCCESS;
+    threads[i] = NULL;
+    pipeline_base += batch_size;
+  }
+
+  // Batch 0 runs on the calling thread. Batches whose thread cannot be created
+  // also run on the calling thread as it only delays their compilation.
+  for (iree_host_size_t i = 1; i < batch_count; ++i) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = IREE_SV("iree-vk-pipeline");
+    iree_status_t thread_status =
+        iree_thread_create(iree_hal_vulkan_pipeline_batch_run, &batches[i],
+                           params, host_allocator, &threads[i]);
+    if (!iree_status_is_ok(thread_status)) {
+      iree_status_ignore(thread_status);
+      threads[i] = NULL;
+    }
+  }
+  iree_hal_vulkan_pipeline_batch_run(&batches[0]);
+  for (iree_host_size_t i = 1; i < batch_count; ++i) {
+    if (threads[i]) {
+      // Releasing the last reference joins the thread.
+      iree_thread_release(threads[i]);
+    } else {
+      iree_hal_vulkan_pipeline_batch_run(&batches[i]);
+    }
+  }
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < batch_count; ++i) {
+    if (batches[i].result != VK_SUCCESS) {
+      status = VK_RESULT_TO_STATUS(batches[i].result,
+                                   "vkCreateComputePipelines");
+      break;
+    }
+  }
+  if (!iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+      if (out_pipelines[i] == VK_NULL_HANDLE) continue;
+      logical_device->syms()->vkDestroyPipeline(
+          *logical_device, out_pipelines[i], logical_device->allocator());
+      out_pipelines[i] = VK_NULL_HANDLE;
+    }
+  }
+
+  iree_allocator_free(host_allocator, batches);
+  return status;
+}
+
+static void iree_hal_vulkan_destroy_pipelines(VkDeviceHandle* logical_device,
+                                              iree_host_size_t pipeline_count,
+                                              VkPipeline* pipelines) {
+  for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+    if (pipelines[i] == VK_NULL_HANDLE) continue;
+    logical_device->syms()->vkDestroyPipeline(*logical_device, pipelines[i],
+                                              logical_device->allocator());
+    pipelines[i] = VK_NULL_HANDLE;
+  }
+}
+
+// Creates |pipeline_count| pipelines from |create_infos| into |out_pipelines|.
+//
+// When VK_EXT_pipeline_creation_cache_control is available and a pipeline
+// cache is used all pipelines are first created on the calling thread with
+// VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_EXT. This only
+// succeeds for pipelines already in the cache and is cheap, so when the cache
+// is warm no compilation threads are needed. Only the pipelines missing from
+// the cache are then compiled with iree_hal_vulkan_compile_pipeline_batches.
+//
+// On failure all pipelines created are destroyed.
+static iree_status_t iree_hal_vulkan_compile_pipelines(
+    VkDeviceHandle* logical_device, VkPipelineCache pipeline_cache,
+    iree_host_size_t compile_concurrency, iree_host_size_t pipeline_count,
+    VkComputePipelineCreateInfo* create_infos, VkPipeline* out_pipelines) {
+  if (pipeline_cache == VK_NULL_HANDLE ||
+      !logical_device->enabled_extensions().pipeline_creation_cache_control) {
+    return iree_hal_vulkan_compile_pipeline_batches(
+        logical_device, pipeline_cache, compile_concurrency, pipeline_count,
+        create_infos, out_pipelines);
+  }
+  IREE_TRACE_SCOPE();
+
+  // Probe the cache for all pipelines at once.
+  for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+    out_pipelines[i] = VK_NULL_HANDLE;
+    create_infos[i].flags |=
+        VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_EXT;
+  }
+  VkResult result = logical_device->syms()->vkCreateComputePipelines(
+      *logical_device, pipeline_cache, (uint32_t)pipeline_count, create_infos,
+      logical_device->allocator(), out_pipelines);
+  for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+    create_infos[i].flags &=
+        ~VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_EXT;
+  }
+  if (result == VK_SUCCESS) return iree_ok_status();
+  if (result != VK_PIPELINE_COMPILE_REQUIRED_EXT) {
+    iree_hal_vulkan_destroy_pipelines(logical_device, pipeline_count,
+                                      out_pipelines);
+    return VK_RESULT_TO_STATUS(result, "vkCreateComputePipelines");
+  }
+
+  // Gather the create infos of all pipelines that missed in the cache.
+  iree_host_size_t miss_count = 0;
+  for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+    if (out_pipelines[i] == VK_NULL_HANDLE) ++miss_count;
+  }
+  IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_hal_vulkan_compile_pipeline_misses");
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)miss_count);
+  VkComputePipelineCreateInfo* miss_create_infos = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      logical_device->host_allocator(),
+      miss_count * (sizeof(*miss_create_infos) + sizeof(VkPipeline) +
+                    sizeof(iree_host_size_t)),
+      (void**)&miss_create_infos);
+  if (iree_status_is_ok(status)) {
+    VkPipeline* miss_pipelines = (VkPipeline*)(miss_create_infos + miss_count);
+    iree_host_size_t* miss_indices =
+        (iree_host_size_t*)(miss_pipelines + miss_count);
+    iree_host_size_t miss_ordinal = 0;
+    for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
+      if (out_pipelines[i] != VK_NULL_HANDLE) continue;
+      miss_create_infos[miss_ordinal] = create_infos[i];
+      miss_indices[miss_ordinal] = i;
+      ++miss_ordinal;
+    }
+    status = iree_hal_vulkan_compile_pipeline_batches(
+        logical_device, pipeline_cache, compile_concurrency, miss_count,
+        miss_create_infos, miss_pipelines);
+    if (iree_status_is_ok(status)) {
+      for (iree_host_size_t i = 0; i < miss_count; ++i) {
+        out_pipelines[miss_indices[i]] = miss_pipelines[i];
+      }
+    }
+    iree_allocator_free(logical_device->host_allocator(), miss_create_infos);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_vulkan_destroy_pipelines(logical_device, pipeline_count,
+                                      out_pipelines);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_vulkan_create_pipelines(
     VkDeviceHandle* logical_device, VkPipelineCache pipeline_cache,
+    iree_host_size_t compile_concurrency,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_spirv_ExecutableDef_table_t executable_def,
     VkShaderModule* shader_modules, iree_host_size_t pipeline_count,
@@ -121,6 +331,9 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
     } else {
       create_info->flags |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
     }
+    if (logical_device->enabled_extensions().descriptor_buffer) {
+      create_info->flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+    }
     create_info->layout = iree_hal_vulkan_native_pipeline_layout_handle(
         executable_params->pipeline_layouts[entry_ordinal]);
     create_info->basePipelineHandle = VK_NULL_HANDLE;
@@ -157,11 +370,9 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
 
   VkPipeline* pipelines =
       (VkPipeline*)iree_alloca(pipeline_count * sizeof(VkPipeline));
-  iree_status_t status = VK_RESULT_TO_STATUS(
-      logical_device->syms()->vkCreateComputePipelines(
-          *logical_device, pipeline_cache, (uint32_t)pipeline_count,
-          create_infos, logical_device->allocator(), pipelines),
-      "vkCreateComputePipelines");
+  iree_status_t status = iree_hal_vulkan_compile_pipelines(
+      logical_device, pipeline_cache, compile_concurrency, pipeline_count,
+      create_infos, pipelines);
   if (iree_status_is_ok(status)) {
     for (iree_host_size_t i = 0; i < pipeline_count; ++i) {
       out_entry_points[i].pipeline = pipelines[i];
@@ -318,7 +529,7 @@ iree_hal_vulkan_native_executable_cast(iree_hal_executable_t* base_value) {
 
 iree_status_t iree_hal_vulkan_native_executable_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkPipelineCache pipeline_cache,
+    VkPipelineCache pipeline_cache, iree_host_size_t compile_concurrency,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(logical_device);
@@ -386,9 +597,9 @@ iree_status_t iree_hal_vulkan_native_executable_create(
   }
   if (iree_status_is_ok(status)) {
     status = iree_hal_vulkan_create_pipelines(
-        logical_device, pipeline_cache, executable_params, executable_def,
-        shader_modules, executable->entry_point_count,
-        executable->entry_points);
+        logical_device, pipeline_cache, compile_concurrency,
+        executable_params, executable_def, shader_modules,
+        executable->entry_point_count, executable->entry_points);
   }
   // Pipelines are created and we don't need the shader modules anymore.
   // Note that if error happens before, we also destroy the shader modules here.
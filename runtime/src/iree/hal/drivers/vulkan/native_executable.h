@@ -28,9 +28,15 @@ typedef struct iree_hal_vulkan_source_location_t {
 // Creates a wrapper for one or more VkPipelines that are sourced from the same
 // IREE executable. Each of the pipelines will share the same shader module
 // and just differs by the entry point into the shader module they reference.
+//
+// Up to |compile_concurrency| threads (including the calling thread) are used
+// to compile the pipelines. Pipelines are split into contiguous batches with
+// one vkCreateComputePipelines call per batch; |pipeline_cache| must be
+// internally synchronized if non-null (as all VkPipelineCaches are unless
+// created as externally synchronized).
 iree_status_t iree_hal_vulkan_native_executable_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkPipelineCache pipeline_cache,
+    VkPipelineCache pipeline_cache, iree_host_size_t compile_concurrency,
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable);
 
@@ -22,10 +22,22 @@ using namespace iree::hal::vulkan;
 // iree_hal_vulkan_native_descriptor_set_layout_t
 //===----------------------------------------------------------------------===//
 
+// Location of a binding within a descriptor set layout in a descriptor buffer.
+typedef struct iree_hal_vulkan_descriptor_buffer_binding_t {
+  uint32_t binding;
+  VkDeviceSize offset;
+} iree_hal_vulkan_descriptor_buffer_binding_t;
+
 typedef struct iree_hal_vulkan_native_descriptor_set_layout_t {
   iree_hal_resource_t resource;
   VkDeviceHandle* logical_device;
   VkDescriptorSetLayout handle;
+  // Total size of the layout in a descriptor buffer as queried from the
+  // implementation. 0 when not using VK_EXT_descriptor_buffer.
+  VkDeviceSize descriptor_buffer_size;
+  iree_host_size_t binding_count;
+  // Offsets of each binding in a descriptor buffer, if in use.
+  iree_hal_vulkan_descriptor_buffer_binding_t bindings[];
 } iree_hal_vulkan_native_descriptor_set_layout_t;
 
 namespace {
@@ -53,8 +65,16 @@ static iree_status_t iree_hal_vulkan_create_descriptor_set_layout(
   create_info.flags = 0;
 
   VkDescriptorSetLayoutBinding* native_bindings = NULL;
+  if (logical_device->enabled_extensions().descriptor_buffer) {
+    // All set layouts in a pipeline layout must be created for descriptor
+    // buffers if any are so we set this even for empty layouts. Descriptor
+    // buffers are used instead of push descriptors when enabled.
+    create_info.flags |=
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+  }
   if (binding_count > 0) {
-    if (logical_device->enabled_extensions().push_descriptors) {
+    if (logical_device->enabled_extensions().push_descriptors &&
+        !logical_device->enabled_extensions().descriptor_buffer) {
       // Note that we can *only* use push descriptor sets if we set this create
       // flag. If push descriptors aren't supported we emulate them with normal
       // descriptors so it's fine to have kPushOnly without support.
@@ -118,15 +138,32 @@ iree_status_t iree_hal_vulkan_native_descriptor_set_layout_create(
               logical_device, flags, binding_count, bindings, &handle));
 
   iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout = NULL;
-  iree_status_t status = iree_allocator_malloc(logical_device->host_allocator(),
-                                               sizeof(*descriptor_set_layout),
-                                               (void**)&descriptor_set_layout);
+  iree_status_t status = iree_allocator_malloc(
+      logical_device->host_allocator(),
+      sizeof(*descriptor_set_layout) +
+          binding_count * sizeof(descriptor_set_layout->bindings[0]),
+      (void**)&descriptor_set_layout);
   if (iree_status_is_ok(status)) {
     iree_hal_resource_initialize(
         &iree_hal_vulkan_native_descriptor_set_layout_vtable,
         &descriptor_set_layout->resource);
     descriptor_set_layout->logical_device = logical_device;
     descriptor_set_layout->handle = handle;
+    descriptor_set_layout->binding_count = binding_count;
+    if (logical_device->enabled_extensions().descriptor_buffer) {
+      // Cache the layout size and binding offsets so that writing descriptors
+      // while recording does not need to query them each time.
+      const DynamicSymbols* syms = logical_device->syms().get();
+      syms->vkGetDescriptorSetLayoutSizeEXT(
+          *logical_device, handle,
+          &descriptor_set_layout->descriptor_buffer_size);
+      for (iree_host_size_t i = 0; i < binding_count; ++i) {
+        descriptor_set_layout->bindings[i].binding = bindings[i].binding;
+        syms->vkGetDescriptorSetLayoutBindingOffsetEXT(
+            *logical_device, handle, bindings[i].binding,
+            &descriptor_set_layout->bindings[i].offset);
+      }
+    }
     *out_descriptor_set_layout =
         (iree_hal_descriptor_set_layout_t*)descriptor_set_layout;
   } else {
@@ -161,6 +198,29 @@ VkDescriptorSetLayout iree_hal_vulkan_native_descriptor_set_layout_handle(
   return descriptor_set_layout->handle;
 }
 
+VkDeviceSize iree_hal_vulkan_native_descriptor_set_layout_size(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout) {
+  iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout =
+      iree_hal_vulkan_native_descriptor_set_layout_cast(
+          base_descriptor_set_layout);
+  return descriptor_set_layout->descriptor_buffer_size;
+}
+
+VkDeviceSize iree_hal_vulkan_native_descriptor_set_layout_binding_offset(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout,
+    uint32_t binding) {
+  iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout =
+      iree_hal_vulkan_native_descriptor_set_layout_cast(
+          base_descriptor_set_layout);
+  for (iree_host_size_t i = 0; i < descriptor_set_layout->binding_count; ++i) {
+    if (descriptor_set_layout->bindings[i].binding == binding) {
+      return descriptor_set_layout->bindings[i].offset;
+    }
+  }
+  IREE_ASSERT(false, "binding not present in the descriptor set layout");
+  return 0;
+}
+
 namespace {
 const iree_hal_descriptor_set_layout_vtable_t
     iree_hal_vulkan_native_descriptor_set_layout_vtable = {
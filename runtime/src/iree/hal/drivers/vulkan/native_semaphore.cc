@@ -6,6 +6,7 @@
 
 #include "iree/hal/drivers/vulkan/native_semaphore.h"
 
+#include <cerrno>
 #include <cstddef>
 
 #include "iree/base/api.h"
@@ -15,12 +16,18 @@
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
 #include "iree/hal/utils/semaphore_base.h"
 
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <unistd.h>
+#endif  // !IREE_PLATFORM_WINDOWS
+
 using namespace iree::hal::vulkan;
 
 typedef struct iree_hal_vulkan_native_semaphore_t {
   iree_hal_semaphore_t base;
   VkDeviceHandle* logical_device;
   VkSemaphore handle;
+  // External handle types the semaphore was created to be exportable as.
+  VkExternalSemaphoreHandleTypeFlags export_handle_types;
   iree_atomic_intptr_t failure_status;
 } iree_hal_vulkan_native_semaphore_t;
 
@@ -35,31 +42,53 @@ iree_hal_vulkan_native_semaphore_cast(iree_hal_semaphore_t* base_value) {
   return (iree_hal_vulkan_native_semaphore_t*)base_value;
 }
 
-iree_status_t iree_hal_vulkan_native_semaphore_create(
-    iree::hal::vulkan::VkDeviceHandle* logical_device, uint64_t initial_value,
-    iree_hal_semaphore_t** out_semaphore) {
-  IREE_ASSERT_ARGUMENT(logical_device);
-  IREE_ASSERT_ARGUMENT(out_semaphore);
-  *out_semaphore = NULL;
-  IREE_TRACE_ZONE_BEGIN(z0);
+VkExternalSemaphoreHandleTypeFlags
+iree_hal_vulkan_native_semaphore_query_export_handle_types(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    VkPhysicalDevice physical_device) {
+#if defined(IREE_PLATFORM_WINDOWS)
+  // TODO: support VK_KHR_external_semaphore_win32.
+  return 0;
+#else
+  if (!logical_device->enabled_extensions().external_semaphore_fd ||
+      !logical_device->syms()->vkGetPhysicalDeviceExternalSemaphoreProperties) {
+    return 0;
+  }
 
+  // Exportability of timeline semaphores is reported separately from binary
+  // semaphores and must be queried with the semaphore type chained.
   VkSemaphoreTypeCreateInfo timeline_create_info;
   timeline_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
   timeline_create_info.pNext = NULL;
   timeline_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
-  timeline_create_info.initialValue = initial_value;
-
-  VkSemaphoreCreateInfo create_info;
-  create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-  create_info.pNext = &timeline_create_info;
-  create_info.flags = 0;
-  VkSemaphore handle = VK_NULL_HANDLE;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, VK_RESULT_TO_STATUS(logical_device->syms()->vkCreateSemaphore(
-                                  *logical_device, &create_info,
-                                  logical_device->allocator(), &handle),
-                              "vkCreateSemaphore"));
+  timeline_create_info.initialValue = 0;
+  VkPhysicalDeviceExternalSemaphoreInfo external_info;
+  external_info.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_SEMAPHORE_INFO;
+  external_info.pNext = &timeline_create_info;
+  external_info.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+  VkExternalSemaphoreProperties external_properties;
+  memset(&external_properties, 0, sizeof(external_properties));
+  external_properties.sType = VK_STRUCTURE_TYPE_EXTERNAL_SEMAPHORE_PROPERTIES;
+  logical_device->syms()->vkGetPhysicalDeviceExternalSemaphoreProperties(
+      physical_device, &external_info, &external_properties);
+  const VkExternalSemaphoreFeatureFlags required_features =
+      VK_EXTERNAL_SEMAPHORE_FEATURE_EXPORTABLE_BIT |
+      VK_EXTERNAL_SEMAPHORE_FEATURE_IMPORTABLE_BIT;
+  if (!iree_all_bits_set(external_properties.externalSemaphoreFeatures,
+                         required_features)) {
+    return 0;
+  }
+  return VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+#endif  // IREE_PLATFORM_WINDOWS
+}
 
+// Wraps a timeline semaphore |handle| in a HAL semaphore. Takes ownership of
+// |handle| and destroys it on failure.
+static iree_status_t iree_hal_vulkan_native_semaphore_wrap(
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkSemaphore handle,
+    VkExternalSemaphoreHandleTypeFlags export_handle_types,
+    iree_hal_semaphore_t** out_semaphore) {
   iree_hal_vulkan_native_semaphore_t* semaphore = NULL;
   iree_status_t status = iree_allocator_malloc(
       logical_device->host_allocator(), sizeof(*semaphore), (void**)&semaphore);
@@ -68,6 +97,7 @@ iree_status_t iree_hal_vulkan_native_semaphore_create(
                                   &semaphore->base);
     semaphore->logical_device = logical_device;
     semaphore->handle = handle;
+    semaphore->export_handle_types = export_handle_types;
     iree_atomic_store_intptr(&semaphore->failure_status, 0,
                              iree_memory_order_release);
     *out_semaphore = &semaphore->base;
@@ -75,9 +105,127 @@ iree_status_t iree_hal_vulkan_native_semaphore_create(
     logical_device->syms()->vkDestroySemaphore(*logical_device, handle,
                                                logical_device->allocator());
   }
+  return status;
+}
+
+// Creates a new timeline semaphore handle exportable as any of
+// |export_handle_types|.
+static iree_status_t iree_hal_vulkan_native_semaphore_create_handle(
+    iree::hal::vulkan::VkDeviceHandle* logical_device, uint64_t initial_value,
+    VkExternalSemaphoreHandleTypeFlags export_handle_types,
+    VkSemaphore* out_handle) {
+  VkSemaphoreTypeCreateInfo timeline_create_info;
+  timeline_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  timeline_create_info.pNext = NULL;
+  timeline_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  timeline_create_info.initialValue = initial_value;
+
+  VkExportSemaphoreCreateInfo export_create_info;
+  export_create_info.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO;
+  export_create_info.pNext = NULL;
+  export_create_info.handleTypes = export_handle_types;
+  if (export_handle_types) {
+    timeline_create_info.pNext = &export_create_info;
+  }
+
+  VkSemaphoreCreateInfo create_info;
+  create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  create_info.pNext = &timeline_create_info;
+  create_info.flags = 0;
+  return VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkCreateSemaphore(
+          *logical_device, &create_info, logical_device->allocator(),
+          out_handle),
+      "vkCreateSemaphore");
+}
+
+iree_status_t iree_hal_vulkan_native_semaphore_create(
+    iree::hal::vulkan::VkDeviceHandle* logical_device, uint64_t initial_value,
+    VkExternalSemaphoreHandleTypeFlags export_handle_types,
+    iree_hal_semaphore_t** out_semaphore) {
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(out_semaphore);
+  *out_semaphore = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  VkSemaphore handle = VK_NULL_HANDLE;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_vulkan_native_semaphore_create_handle(
+              logical_device, initial_value, export_handle_types, &handle));
+  iree_status_t status = iree_hal_vulkan_native_semaphore_wrap(
+      logical_device, handle, export_handle_types, out_semaphore);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_vulkan_native_semaphore_import(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    const iree_hal_external_semaphore_t* external_semaphore,
+    iree_hal_external_semaphore_flags_t flags,
+    iree_hal_semaphore_t** out_semaphore) {
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(external_semaphore);
+  IREE_ASSERT_ARGUMENT(out_semaphore);
+  *out_semaphore = NULL;
+#if defined(IREE_PLATFORM_WINDOWS)
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "external semaphore import not yet implemented on "
+                          "Windows");
+#else
+  if (external_semaphore->type != IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "external semaphore type %d not supported",
+                            (int)external_semaphore->type);
+  } else if (!logical_device->enabled_extensions().external_semaphore_fd ||
+             !logical_device->syms()->vkImportSemaphoreFdKHR) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "VK_KHR_external_semaphore_fd not enabled");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The payload of the imported semaphore is replaced with that of the
+  // external one and the initial value here is ignored.
+  VkSemaphore handle = VK_NULL_HANDLE;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_vulkan_native_semaphore_create_handle(
+              logical_device, /*initial_value=*/0,
+              /*export_handle_types=*/0, &handle));
+
+  // Vulkan takes ownership of the file descriptor on success but the caller
+  // retains ownership of theirs so we import a duplicate.
+  iree_status_t status = iree_ok_status();
+  int import_fd = dup(external_semaphore->handle.opaque_fd.fd);
+  if (import_fd < 0) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to duplicate external semaphore fd");
+  }
+  if (iree_status_is_ok(status)) {
+    VkImportSemaphoreFdInfoKHR import_info;
+    import_info.sType = VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_FD_INFO_KHR;
+    import_info.pNext = NULL;
+    import_info.semaphore = handle;
+    import_info.flags = 0;
+    import_info.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+    import_info.fd = import_fd;
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkImportSemaphoreFdKHR(*logical_device,
+                                                       &import_info),
+        "vkImportSemaphoreFdKHR");
+    if (!iree_status_is_ok(status)) close(import_fd);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_native_semaphore_wrap(
+        logical_device, handle, /*export_handle_types=*/0, out_semaphore);
+  } else {
+    logical_device->syms()->vkDestroySemaphore(*logical_device, handle,
+                                               logical_device->allocator());
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
+#endif  // IREE_PLATFORM_WINDOWS
 }
 
 static void iree_hal_vulkan_native_semaphore_destroy(
@@ -286,6 +434,49 @@ static iree_status_t iree_hal_vulkan_native_semaphore_wait(
       semaphore->logical_device, &semaphore_list, timeout, 0);
 }
 
+static iree_status_t iree_hal_vulkan_native_semaphore_export(
+    iree_hal_semaphore_t* base_semaphore,
+    iree_hal_external_semaphore_type_t requested_type,
+    iree_hal_external_semaphore_flags_t requested_flags,
+    iree_hal_external_semaphore_t* out_external_semaphore) {
+  iree_hal_vulkan_native_semaphore_t* semaphore =
+      iree_hal_vulkan_native_semaphore_cast(base_semaphore);
+#if defined(IREE_PLATFORM_WINDOWS)
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "external semaphore export not yet implemented on "
+                          "Windows");
+#else
+  if (requested_type != IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "external semaphore type %d not supported",
+                            (int)requested_type);
+  } else if (!iree_all_bits_set(
+                 semaphore->export_handle_types,
+                 VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT) ||
+             !semaphore->logical_device->syms()->vkGetSemaphoreFdKHR) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "semaphore was not created exportable as an opaque fd; the device "
+        "may not support VK_KHR_external_semaphore_fd for timelines");
+  }
+
+  VkSemaphoreGetFdInfoKHR get_fd_info;
+  get_fd_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR;
+  get_fd_info.pNext = NULL;
+  get_fd_info.semaphore = semaphore->handle;
+  get_fd_info.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT;
+  int fd = -1;
+  IREE_RETURN_IF_ERROR(VK_RESULT_TO_STATUS(
+      semaphore->logical_device->syms()->vkGetSemaphoreFdKHR(
+          *semaphore->logical_device, &get_fd_info, &fd),
+      "vkGetSemaphoreFdKHR"));
+  out_external_semaphore->type = IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD;
+  out_external_semaphore->flags = requested_flags;
+  out_external_semaphore->handle.opaque_fd.fd = fd;
+  return iree_ok_status();
+#endif  // IREE_PLATFORM_WINDOWS
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_vulkan_semaphore_handle(
     iree_hal_semaphore_t* base_semaphore, VkSemaphore* out_handle) {
   IREE_ASSERT_ARGUMENT(base_semaphore);
@@ -303,5 +494,6 @@ const iree_hal_semaphore_vtable_t iree_hal_vulkan_native_semaphore_vtable = {
     /*.signal=*/iree_hal_vulkan_native_semaphore_signal,
     /*.fail=*/iree_hal_vulkan_native_semaphore_fail,
     /*.wait=*/iree_hal_vulkan_native_semaphore_wait,
+    /*.export_semaphore=*/iree_hal_vulkan_native_semaphore_export,
 };
 }  // namespace
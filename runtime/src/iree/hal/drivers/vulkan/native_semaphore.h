@@ -17,9 +17,28 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Returns the external handle types timeline semaphores created on
+// |logical_device| can be made exportable as, or 0 if export is unsupported.
+VkExternalSemaphoreHandleTypeFlags
+iree_hal_vulkan_native_semaphore_query_export_handle_types(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    VkPhysicalDevice physical_device);
+
 // Creates a timeline semaphore implemented using the native VkSemaphore type.
+// If |export_handle_types| is non-zero the semaphore may be exported with
+// iree_hal_semaphore_export as any of the given types.
 iree_status_t iree_hal_vulkan_native_semaphore_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device, uint64_t initial_value,
+    VkExternalSemaphoreHandleTypeFlags export_handle_types,
+    iree_hal_semaphore_t** out_semaphore);
+
+// Imports an |external_semaphore| as a native timeline semaphore. The imported
+// semaphore shares the payload of the semaphore it was exported from and can be
+// used for device-side waits and signals on |logical_device| queues.
+iree_status_t iree_hal_vulkan_native_semaphore_import(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    const iree_hal_external_semaphore_t* external_semaphore,
+    iree_hal_external_semaphore_flags_t flags,
     iree_hal_semaphore_t** out_semaphore);
 
 // Returns true if |semaphore| is a Vulkan native semaphore.
@@ -18,9 +18,12 @@ extern "C" {
 // Creates a no-op executable cache that does not cache at all.
 // This is useful to isolate pipeline caching behavior and verify compilation
 // behavior.
+//
+// |compile_concurrency| is the maximum number of threads used to compile the
+// pipelines of each executable prepared.
 iree_status_t iree_hal_vulkan_nop_executable_cache_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    iree_string_view_t identifier,
+    iree_string_view_t identifier, iree_host_size_t compile_concurrency,
     iree_hal_executable_cache_t** out_executable_cache);
 
 #ifdef __cplusplus
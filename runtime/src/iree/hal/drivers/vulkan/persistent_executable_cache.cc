@@ -0,0 +1,327 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/vulkan/persistent_executable_cache.h"
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/path.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/vulkan/dynamic_symbol_tables.h"
+#include "iree/hal/drivers/vulkan/native_executable.h"
+#include "iree/hal/drivers/vulkan/status_util.h"
+
+using namespace iree::hal::vulkan;
+
+typedef struct iree_hal_vulkan_persistent_executable_cache_t {
+  iree_hal_resource_t resource;
+  VkDeviceHandle* logical_device;
+  // Maximum number of threads used to compile the pipelines of an executable.
+  iree_host_size_t compile_concurrency;
+
+  // Header fields that persisted data must match to be loaded.
+  VkPhysicalDeviceProperties physical_device_properties;
+
+  // Pipeline cache shared by all executables prepared from this cache.
+  // Vulkan pipeline caches are internally synchronized.
+  VkPipelineCache pipeline_cache;
+
+  // Guards writes to the cache file.
+  iree_slim_mutex_t file_mutex;
+  // NUL-terminated path of the cache file; stored after the struct.
+  char* file_path;
+} iree_hal_vulkan_persistent_executable_cache_t;
+
+namespace {
+extern const iree_hal_executable_cache_vtable_t
+    iree_hal_vulkan_persistent_executable_cache_vtable;
+}  // namespace
+
+static iree_hal_vulkan_persistent_executable_cache_t*
+iree_hal_vulkan_persistent_executable_cache_cast(
+    iree_hal_executable_cache_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value,
+                       &iree_hal_vulkan_persistent_executable_cache_vtable);
+  return (iree_hal_vulkan_persistent_executable_cache_t*)base_value;
+}
+
+// Formats the cache file name for |identifier| on the device described by
+// |properties| into |buffer|. Characters in the identifier that may not be
+// valid in file names are replaced.
+static void iree_hal_vulkan_persistent_executable_cache_format_file_name(
+    iree_string_view_t identifier, const VkPhysicalDeviceProperties* properties,
+    char* buffer, iree_host_size_t buffer_capacity) {
+  char sanitized_identifier[64];
+  iree_host_size_t identifier_length =
+      iree_min(identifier.size, IREE_ARRAYSIZE(sanitized_identifier) - 1);
+  for (iree_host_size_t i = 0; i < identifier_length; ++i) {
+    char c = identifier.data[i];
+    bool is_valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                    (c >= '0' && c <= '9') || c == '-' || c == '_';
+    sanitized_identifier[i] = is_valid ? c : '_';
+  }
+  sanitized_identifier[identifier_length] = 0;
+  char uuid[VK_UUID_SIZE * 2 + 1];
+  for (iree_host_size_t i = 0; i < VK_UUID_SIZE; ++i) {
+    snprintf(&uuid[i * 2], 3, "%02x", properties->pipelineCacheUUID[i]);
+  }
+  snprintf(buffer, buffer_capacity, "%s-%08x-%08x-%s.vkpipelinecache",
+           sanitized_identifier, properties->vendorID, properties->deviceID,
+           uuid);
+}
+
+// Returns true if |data| starts with a pipeline cache header matching the
+// device in |properties|. Drivers are required to validate this themselves but
+// not all do so robustly.
+static bool iree_hal_vulkan_persistent_executable_cache_is_compatible(
+    iree_const_byte_span_t data, const VkPhysicalDeviceProperties* properties) {
+  VkPipelineCacheHeaderVersionOne header;
+  if (data.data_length < sizeof(header)) return false;
+  memcpy(&header, data.data, sizeof(header));
+  return header.headerSize >= sizeof(header) &&
+         header.headerSize <= data.data_length &&
+         header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header.vendorID == properties->vendorID &&
+         header.deviceID == properties->deviceID &&
+         memcmp(header.pipelineCacheUUID, properties->pipelineCacheUUID,
+                VK_UUID_SIZE) == 0;
+}
+
+iree_status_t iree_hal_vulkan_persistent_executable_cache_create(
+    VkDeviceHandle* logical_device, VkPhysicalDevice physical_device,
+    iree_string_view_t identifier, iree_string_view_t cache_path,
+    iree_host_size_t compile_concurrency,
+    iree_hal_executable_cache_t** out_executable_cache) {
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(out_executable_cache);
+  *out_executable_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+
+  VkPhysicalDeviceProperties physical_device_properties;
+  logical_device->syms()->vkGetPhysicalDeviceProperties(
+      physical_device, &physical_device_properties);
+
+  char file_name[256];
+  iree_hal_vulkan_persistent_executable_cache_format_file_name(
+      identifier, &physical_device_properties, file_name, sizeof(file_name));
+  char* joined_path = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_file_path_join(cache_path, iree_make_cstring_view(file_name),
+                              host_allocator, &joined_path));
+  iree_host_size_t file_path_length = strlen(joined_path);
+
+  iree_hal_vulkan_persistent_executable_cache_t* executable_cache = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*executable_cache) + file_path_length + 1,
+      (void**)&executable_cache);
+  if (iree_status_is_ok(status)) {
+    iree_hal_resource_initialize(
+        &iree_hal_vulkan_persistent_executable_cache_vtable,
+        &executable_cache->resource);
+    executable_cache->logical_device = logical_device;
+    executable_cache->compile_concurrency = compile_concurrency;
+    executable_cache->physical_device_properties = physical_device_properties;
+    executable_cache->pipeline_cache = VK_NULL_HANDLE;
+    iree_slim_mutex_initialize(&executable_cache->file_mutex);
+    executable_cache->file_path =
+        (char*)executable_cache + sizeof(*executable_cache);
+    memcpy(executable_cache->file_path, joined_path, file_path_length + 1);
+  }
+  iree_allocator_free(host_allocator, joined_path);
+
+  // Seed the pipeline cache with previously persisted data, if any. Missing or
+  // incompatible files just start with an empty cache.
+  iree_file_contents_t* contents = NULL;
+  if (iree_status_is_ok(status)) {
+    iree_status_t read_status = iree_file_read_contents(
+        executable_cache->file_path, IREE_FILE_READ_FLAG_DEFAULT,
+        host_allocator, &contents);
+    if (iree_status_is_ok(read_status) &&
+        !iree_hal_vulkan_persistent_executable_cache_is_compatible(
+            contents->const_buffer, &physical_device_properties)) {
+      iree_file_contents_free(contents);
+      contents = NULL;
+    }
+    iree_status_ignore(read_status);
+  }
+
+  if (iree_status_is_ok(status)) {
+    VkPipelineCacheCreateInfo create_info;
+    create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    create_info.pNext = NULL;
+    create_info.flags = 0;
+    create_info.initialDataSize =
+        contents ? contents->const_buffer.data_length : 0;
+    create_info.pInitialData = contents ? contents->const_buffer.data : NULL;
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkCreatePipelineCache(
+            *logical_device, &create_info, logical_device->allocator(),
+            &executable_cache->pipeline_cache),
+        "vkCreatePipelineCache");
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(
+      z0, contents ? (int64_t)contents->const_buffer.data_length : 0);
+  if (contents) iree_file_contents_free(contents);
+
+  if (iree_status_is_ok(status)) {
+    *out_executable_cache = (iree_hal_executable_cache_t*)executable_cache;
+  } else if (executable_cache) {
+    iree_hal_executable_cache_release(
+        (iree_hal_executable_cache_t*)executable_cache);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_vulkan_persistent_executable_cache_destroy(
+    iree_hal_executable_cache_t* base_executable_cache) {
+  iree_hal_vulkan_persistent_executable_cache_t* executable_cache =
+      iree_hal_vulkan_persistent_executable_cache_cast(base_executable_cache);
+  VkDeviceHandle* logical_device = executable_cache->logical_device;
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (executable_cache->pipeline_cache != VK_NULL_HANDLE) {
+    logical_device->syms()->vkDestroyPipelineCache(
+        *logical_device, executable_cache->pipeline_cache,
+        logical_device->allocator());
+  }
+  iree_slim_mutex_deinitialize(&executable_cache->file_mutex);
+  iree_allocator_free(host_allocator, executable_cache);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Writes the current pipeline cache contents to the cache file.
+// The data is written to a temporary file that then replaces the cache file
+// so that concurrent readers never observe partial contents.
+static iree_status_t iree_hal_vulkan_persistent_executable_cache_store(
+    iree_hal_vulkan_persistent_executable_cache_t* executable_cache) {
+  VkDeviceHandle* logical_device = executable_cache->logical_device;
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  size_t data_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, VK_RESULT_TO_STATUS(
+              logical_device->syms()->vkGetPipelineCacheData(
+                  *logical_device, executable_cache->pipeline_cache,
+                  &data_size, NULL),
+              "vkGetPipelineCacheData"));
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)data_size);
+  if (data_size == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  // The temporary file name includes the current time to avoid colliding with
+  // other processes updating the same cache.
+  iree_host_size_t file_path_length = strlen(executable_cache->file_path);
+  iree_host_size_t temp_path_capacity = file_path_length + 32;
+  char* temp_path = NULL;
+  void* data = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, temp_path_capacity + data_size, (void**)&temp_path);
+  if (iree_status_is_ok(status)) {
+    snprintf(temp_path, temp_path_capacity, "%s.%016" PRIx64 ".tmp",
+             executable_cache->file_path, (uint64_t)iree_time_now());
+    data = temp_path + temp_path_capacity;
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkGetPipelineCacheData(
+            *logical_device, executable_cache->pipeline_cache, &data_size,
+            data),
+        "vkGetPipelineCacheData");
+  }
+
+  // If the cache grew between the queries the driver writes nothing and
+  // returns VK_INCOMPLETE with a zero size; the next store will catch up.
+  if (iree_status_is_ok(status) && data_size > 0) {
+    iree_slim_mutex_lock(&executable_cache->file_mutex);
+    status = iree_file_write_contents(
+        temp_path, iree_make_const_byte_span(data, data_size));
+    if (iree_status_is_ok(status) &&
+        std::rename(temp_path, executable_cache->file_path) != 0) {
+      // Windows does not allow replacing existing files with rename.
+      std::remove(executable_cache->file_path);
+      if (std::rename(temp_path, executable_cache->file_path) != 0) {
+        std::remove(temp_path);
+        status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                  "failed to replace pipeline cache file '%s'",
+                                  executable_cache->file_path);
+      }
+    }
+    iree_slim_mutex_unlock(&executable_cache->file_mutex);
+  }
+
+  iree_allocator_free(host_allocator, temp_path);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static bool iree_hal_vulkan_persistent_executable_cache_can_prepare_format(
+    iree_hal_executable_cache_t* base_executable_cache,
+    iree_hal_executable_caching_mode_t caching_mode,
+    iree_string_view_t executable_format) {
+  iree_hal_vulkan_persistent_executable_cache_t* executable_cache =
+      iree_hal_vulkan_persistent_executable_cache_cast(base_executable_cache);
+  if (iree_string_view_equal(executable_format,
+                             iree_make_cstring_view("vulkan-spirv-fb"))) {
+    return true;
+  } else if (iree_string_view_equal(
+                 executable_format,
+                 iree_make_cstring_view("vulkan-spirv-fb-ptr"))) {
+    return iree_all_bits_set(
+        executable_cache->logical_device->enabled_features(),
+        IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES);
+  }
+  return false;
+}
+
+static iree_status_t
+iree_hal_vulkan_persistent_executable_cache_prepare_executable(
+    iree_hal_executable_cache_t* base_executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_executable_t** out_executable) {
+  if (!iree_hal_vulkan_persistent_executable_cache_can_prepare_format(
+          base_executable_cache, executable_params->caching_mode,
+          executable_params->executable_format)) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "no Vulkan executable implementation registered "
+                            "for the given executable format '%.*s'",
+                            (int)executable_params->executable_format.size,
+                            executable_params->executable_format.data);
+  }
+  iree_hal_vulkan_persistent_executable_cache_t* executable_cache =
+      iree_hal_vulkan_persistent_executable_cache_cast(base_executable_cache);
+  IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_executable_create(
+      executable_cache->logical_device, executable_cache->pipeline_cache,
+      executable_cache->compile_concurrency, executable_params,
+      out_executable));
+
+  // Persisting is best-effort: the executable is usable even if the cache
+  // directory is read-only or full.
+  iree_status_ignore(
+      iree_hal_vulkan_persistent_executable_cache_store(executable_cache));
+  return iree_ok_status();
+}
+
+namespace {
+const iree_hal_executable_cache_vtable_t
+    iree_hal_vulkan_persistent_executable_cache_vtable = {
+        /*.destroy=*/iree_hal_vulkan_persistent_executable_cache_destroy,
+        /*.can_prepare_format=*/
+        iree_hal_vulkan_persistent_executable_cache_can_prepare_format,
+        /*.prepare_executable=*/
+        iree_hal_vulkan_persistent_executable_cache_prepare_executable,
+};
+}  // namespace
@@ -0,0 +1,39 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_VULKAN_PERSISTENT_EXECUTABLE_CACHE_H_
+#define IREE_HAL_DRIVERS_VULKAN_PERSISTENT_EXECUTABLE_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/vulkan/handle_util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates an executable cache backed by a VkPipelineCache that is persisted to
+// a file under |cache_path| so that pipelines compiled by one process can be
+// reused by subsequent ones without a driver recompile.
+//
+// The file is keyed by |identifier| and the vendor, device, and pipeline cache
+// UUID of |physical_device| such that driver updates or different devices
+// never observe incompatible data. Files that fail validation are ignored and
+// overwritten. The cache file is updated after each executable is prepared.
+//
+// |compile_concurrency| is the maximum number of threads used to compile the
+// pipelines of each executable prepared.
+iree_status_t iree_hal_vulkan_persistent_executable_cache_create(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    VkPhysicalDevice physical_device, iree_string_view_t identifier,
+    iree_string_view_t cache_path, iree_host_size_t compile_concurrency,
+    iree_hal_executable_cache_t** out_executable_cache);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_VULKAN_PERSISTENT_EXECUTABLE_CACHE_H_
@@ -41,11 +41,21 @@ IREE_FLAG(bool, vulkan_sparse_residency, true,
 IREE_FLAG(bool, vulkan_buffer_device_addresses, true,
           "Enables the Vulkan 'bufferDeviceAddress` feature and support for "
           "SPIR-V executables compiled to use it.");
+IREE_FLAG(bool, vulkan_descriptor_buffers, false,
+          "Enables VK_EXT_descriptor_buffer when available and binds dispatch "
+          "resources with descriptor buffers instead of descriptor sets.");
 
 IREE_FLAG(
     bool, vulkan_dedicated_compute_queue, false,
     "Use a dedicated queue with VK_QUEUE_COMPUTE_BIT for dispatch workloads.");
 
+IREE_FLAG(string, vulkan_pipeline_cache_path, "",
+          "Directory used to persist compiled pipelines across processes. "
+          "Empty disables persistence.");
+IREE_FLAG(int32_t, vulkan_pipeline_compile_concurrency, 1,
+          "Maximum number of threads used to compile the pipelines of a "
+          "single executable. 1 compiles on the loading thread.");
+
 static iree_status_t iree_hal_vulkan_create_driver_with_flags(
     iree_string_view_t identifier, iree_allocator_t host_allocator,
     iree_hal_driver_t** out_driver) {
@@ -94,11 +104,19 @@ static iree_status_t iree_hal_vulkan_create_driver_with_flags(
     driver_options.requested_features |=
         IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES;
   }
+  if (FLAG_vulkan_descriptor_buffers) {
+    driver_options.requested_features |=
+        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS;
+  }
 
   if (FLAG_vulkan_dedicated_compute_queue) {
     driver_options.device_options.flags |=
         IREE_HAL_VULKAN_DEVICE_FLAG_DEDICATED_COMPUTE_QUEUE;
   }
+  driver_options.device_options.pipeline_cache_path =
+      iree_make_cstring_view(FLAG_vulkan_pipeline_cache_path);
+  driver_options.device_options.pipeline_compile_concurrency =
+      (iree_host_size_t)iree_max(1, FLAG_vulkan_pipeline_compile_concurrency);
 
   // Load the Vulkan library. This will fail if the library cannot be found or
   // does not have the expected functions.
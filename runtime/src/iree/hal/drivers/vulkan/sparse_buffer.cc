@@ -11,13 +11,31 @@
 #include <cstring>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/drivers/vulkan/base_buffer.h"
 #include "iree/hal/drivers/vulkan/status_util.h"
 
+// Preferred size of the physical blocks committed on demand to partially
+// resident buffers. Larger blocks reduce the number of allocations as buffers
+// grow at the cost of committing more memory than may be used.
+#define IREE_HAL_VULKAN_SPARSE_BUFFER_COMMIT_BLOCK_SIZE (2 * 1024 * 1024)
+
 typedef struct iree_hal_vulkan_sparse_buffer_t {
   iree_hal_vulkan_base_buffer_t base;
   iree::hal::vulkan::VkDeviceHandle* logical_device;
+  // Guards commits to |physical_blocks|.
+  iree_slim_mutex_t mutex;
+  // Total size of the buffer memory requirements.
+  VkDeviceSize resource_size;
+  // Memory type all physical blocks are allocated from.
+  uint32_t memory_type_index;
+  // Size of each physical block; the last block may be of partial size.
+  VkDeviceSize physical_block_size;
+  // Total bytes of device memory bound to the buffer.
+  iree_device_size_t committed_size;
   iree_host_size_t physical_block_count;
+  // Physical blocks indexed by resource offset / |physical_block_size|.
+  // Uncommitted blocks of partially resident buffers are VK_NULL_HANDLE.
   VkDeviceMemory physical_blocks[];
 } iree_hal_vulkan_sparse_buffer_t;
 
@@ -31,49 +49,93 @@ static iree_hal_vulkan_sparse_buffer_t* iree_hal_vulkan_sparse_buffer_cast(
   return (iree_hal_vulkan_sparse_buffer_t*)base_value;
 }
 
+// Returns the size of physical block |block_index| of |buffer|; all blocks are
+// |physical_block_size| except for the last which covers whatever remains of
+// the resource.
+static VkDeviceSize iree_hal_vulkan_sparse_buffer_block_size(
+    iree_hal_vulkan_sparse_buffer_t* buffer, iree_host_size_t block_index) {
+  if (block_index < buffer->physical_block_count - 1) {
+    return buffer->physical_block_size;
+  }
+  return buffer->resource_size -
+         buffer->physical_block_size * (buffer->physical_block_count - 1);
+}
+
+// Allocates the device memory for physical block |block_index| of |buffer|
+// and populates |out_bind| with the bind attaching it to the buffer.
+static iree_status_t iree_hal_vulkan_sparse_buffer_allocate_block(
+    iree_hal_vulkan_sparse_buffer_t* buffer, iree_host_size_t block_index,
+    VkSparseMemoryBind* out_bind) {
+  iree::hal::vulkan::VkDeviceHandle* logical_device = buffer->logical_device;
+
+  VkMemoryAllocateInfo allocate_info;
+  allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocate_info.pNext = NULL;
+  allocate_info.allocationSize =
+      iree_hal_vulkan_sparse_buffer_block_size(buffer, block_index);
+  allocate_info.memoryTypeIndex = buffer->memory_type_index;
+  // Descriptor buffers reference storage buffers by device address and all
+  // memory bound to such buffers must be allocated with device addressing.
+  VkMemoryAllocateFlagsInfo allocate_flags_info;
+  if (logical_device->enabled_extensions().descriptor_buffer) {
+    allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocate_flags_info.pNext = NULL;
+    allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    allocate_flags_info.deviceMask = 0;
+    allocate_info.pNext = &allocate_flags_info;
+  }
+
+  IREE_TRACE_ZONE_BEGIN_NAMED(z0, "vkAllocateMemory");
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocate_info.allocationSize);
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkAllocateMemory(
+          *logical_device, &allocate_info, logical_device->allocator(),
+          &buffer->physical_blocks[block_index]),
+      "vkAllocateMemory");
+  IREE_TRACE_ZONE_END(z0);
+  IREE_RETURN_IF_ERROR(status);
+
+  buffer->committed_size += allocate_info.allocationSize;
+  out_bind->resourceOffset = block_index * buffer->physical_block_size;
+  out_bind->size = allocate_info.allocationSize;
+  out_bind->memory = buffer->physical_blocks[block_index];
+  out_bind->memoryOffset = 0;
+  out_bind->flags = 0;
+  return iree_ok_status();
+}
+
+// Frees the device memory of physical block |block_index| of |buffer|. The
+// block must not be bound or in use by the device.
+static void iree_hal_vulkan_sparse_buffer_free_block(
+    iree_hal_vulkan_sparse_buffer_t* buffer, iree_host_size_t block_index) {
+  iree::hal::vulkan::VkDeviceHandle* logical_device = buffer->logical_device;
+  if (buffer->physical_blocks[block_index] == VK_NULL_HANDLE) return;
+  logical_device->syms()->vkFreeMemory(*logical_device,
+                                       buffer->physical_blocks[block_index],
+                                       logical_device->allocator());
+  buffer->physical_blocks[block_index] = VK_NULL_HANDLE;
+  buffer->committed_size -=
+      iree_hal_vulkan_sparse_buffer_block_size(buffer, block_index);
+}
+
 static iree_status_t iree_hal_vulkan_sparse_buffer_commit_sync(
-    iree::hal::vulkan::VkDeviceHandle* logical_device, VkQueue queue,
-    VkBuffer handle, VkMemoryRequirements requirements,
-    uint32_t memory_type_index, VkDeviceSize physical_block_size,
-    iree_host_size_t physical_block_count,
-    VkDeviceMemory out_physical_blocks[]) {
+    iree_hal_vulkan_sparse_buffer_t* buffer, VkQueue queue) {
+  iree::hal::vulkan::VkDeviceHandle* logical_device = buffer->logical_device;
+  VkBuffer handle = buffer->base.handle;
+  iree_host_size_t physical_block_count = buffer->physical_block_count;
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)requirements.size);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)requirements.alignment);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)physical_block_size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer->resource_size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer->physical_block_size);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)physical_block_count);
 
   // Allocate all physical blocks; note that the last block may be of partial
   // size and we'll just allocate whatever remains from the total requested
   // size.
-  VkMemoryAllocateInfo allocate_info;
-  allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-  allocate_info.pNext = NULL;
-  allocate_info.memoryTypeIndex = memory_type_index;
   VkSparseMemoryBind* binds = (VkSparseMemoryBind*)iree_alloca(
       sizeof(VkSparseMemoryBind) * physical_block_count);
   for (iree_host_size_t i = 0; i < physical_block_count; ++i) {
-    if (i < physical_block_count - 1) {
-      allocate_info.allocationSize = physical_block_size;
-    } else {
-      allocate_info.allocationSize =
-          requirements.size - physical_block_size * (physical_block_count - 1);
-    }
-    IREE_TRACE_ZONE_BEGIN_NAMED(z1, "vkAllocateMemory");
-    IREE_TRACE_ZONE_APPEND_VALUE_I64(z1, (int64_t)allocate_info.allocationSize);
-    iree_status_t allocate_status = VK_RESULT_TO_STATUS(
-        logical_device->syms()->vkAllocateMemory(
-            *logical_device, &allocate_info, logical_device->allocator(),
-            &out_physical_blocks[i]),
-        "vkAllocateMemory");
-    IREE_TRACE_ZONE_END(z1);
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, allocate_status);
-
-    binds[i].resourceOffset = i * physical_block_size;
-    binds[i].size = allocate_info.allocationSize;
-    binds[i].memory = out_physical_blocks[i];
-    binds[i].memoryOffset = 0;
-    binds[i].flags = 0;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_vulkan_sparse_buffer_allocate_block(buffer, i, &binds[i]));
   }
 
   // Temporary fence for enforcing host-synchronous execution.
@@ -122,6 +184,40 @@ static iree_status_t iree_hal_vulkan_sparse_buffer_commit_sync(
   return status;
 }
 
+// Allocates a sparse buffer wrapping |handle| with no physical blocks.
+static iree_status_t iree_hal_vulkan_sparse_buffer_allocate(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree_device_size_t byte_offset, iree_device_size_t byte_length,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkBuffer handle,
+    VkMemoryRequirements requirements, uint32_t memory_type_index,
+    VkDeviceSize physical_block_size, iree_host_size_t physical_block_count,
+    iree_hal_vulkan_sparse_buffer_t** out_buffer) {
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(allocator);
+  iree_hal_vulkan_sparse_buffer_t* buffer = NULL;
+  iree_host_size_t total_size =
+      iree_host_align(sizeof(*buffer), iree_max_align_t) +
+      sizeof(buffer->physical_blocks[0]) * physical_block_count;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, total_size, (void**)&buffer));
+  iree_hal_buffer_initialize(
+      host_allocator, allocator, &buffer->base.base, allocation_size,
+      byte_offset, byte_length, memory_type, allowed_access, allowed_usage,
+      &iree_hal_vulkan_sparse_buffer_vtable, &buffer->base.base);
+  buffer->base.handle = handle;
+  buffer->logical_device = logical_device;
+  iree_slim_mutex_initialize(&buffer->mutex);
+  buffer->resource_size = requirements.size;
+  buffer->memory_type_index = memory_type_index;
+  buffer->physical_block_size = physical_block_size;
+  buffer->committed_size = 0;
+  buffer->physical_block_count = physical_block_count;
+  *out_buffer = buffer;
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
     iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
@@ -151,26 +247,17 @@ iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
       (iree_host_size_t)iree_device_size_ceil_div(requirements.size,
                                                   physical_block_size);
 
-  iree_allocator_t host_allocator =
-      iree_hal_allocator_host_allocator(allocator);
   iree_hal_vulkan_sparse_buffer_t* buffer = NULL;
-  iree_host_size_t total_size =
-      iree_host_align(sizeof(*buffer), iree_max_align_t) +
-      sizeof(buffer->physical_blocks[0]) * physical_block_count;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&buffer));
-  iree_hal_buffer_initialize(
-      host_allocator, allocator, &buffer->base.base, allocation_size,
-      byte_offset, byte_length, memory_type, allowed_access, allowed_usage,
-      &iree_hal_vulkan_sparse_buffer_vtable, &buffer->base.base);
-  buffer->base.handle = handle;
-  buffer->logical_device = logical_device;
-  buffer->physical_block_count = physical_block_count;
+      z0, iree_hal_vulkan_sparse_buffer_allocate(
+              allocator, memory_type, allowed_access, allowed_usage,
+              allocation_size, byte_offset, byte_length, logical_device,
+              handle, requirements, memory_type_index, physical_block_size,
+              physical_block_count, &buffer));
 
   // Synchronously commit all physical blocks and bind them to the buffer.
-  iree_status_t status = iree_hal_vulkan_sparse_buffer_commit_sync(
-      logical_device, queue, handle, requirements, memory_type_index,
-      physical_block_size, physical_block_count, buffer->physical_blocks);
+  iree_status_t status =
+      iree_hal_vulkan_sparse_buffer_commit_sync(buffer, queue);
 
   if (iree_status_is_ok(status)) {
     *out_buffer = &buffer->base.base;
@@ -198,18 +285,145 @@ static void iree_hal_vulkan_sparse_buffer_destroy(
         *logical_device, buffer->base.handle, logical_device->allocator());
   }
   for (iree_host_size_t i = 0; i < buffer->physical_block_count; ++i) {
-    if (buffer->physical_blocks[i] != VK_NULL_HANDLE) {
-      logical_device->syms()->vkFreeMemory(*logical_device,
-                                           buffer->physical_blocks[i],
-                                           logical_device->allocator());
-    }
+    iree_hal_vulkan_sparse_buffer_free_block(buffer, i);
   }
 
+  iree_slim_mutex_deinitialize(&buffer->mutex);
   iree_allocator_free(host_allocator, buffer);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+iree_status_t iree_hal_vulkan_sparse_buffer_create_reserved(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkBuffer handle,
+    VkMemoryRequirements requirements, uint32_t memory_type_index,
+    VkDeviceSize max_allocation_size, iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(allocator);
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  // Blocks must be aligned to the sparse page size (the buffer alignment) and
+  // be under the maximum allocation size of the implementation.
+  iree_device_size_t physical_block_size = iree_min(
+      iree_device_align(IREE_HAL_VULKAN_SPARSE_BUFFER_COMMIT_BLOCK_SIZE,
+                        requirements.alignment),
+      iree_device_size_floor_div(max_allocation_size, requirements.alignment) *
+          requirements.alignment);
+  iree_host_size_t physical_block_count =
+      (iree_host_size_t)iree_device_size_ceil_div(requirements.size,
+                                                  physical_block_size);
+
+  iree_hal_vulkan_sparse_buffer_t* buffer = NULL;
+  iree_status_t status = iree_hal_vulkan_sparse_buffer_allocate(
+      allocator, memory_type, allowed_access, allowed_usage, allocation_size,
+      /*byte_offset=*/0, /*byte_length=*/allocation_size, logical_device,
+      handle, requirements, memory_type_index, physical_block_size,
+      physical_block_count, &buffer);
+  if (iree_status_is_ok(status)) {
+    *out_buffer = &buffer->base.base;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+bool iree_hal_vulkan_sparse_buffer_isa(iree_hal_buffer_t* buffer) {
+  return iree_hal_resource_is(buffer, &iree_hal_vulkan_sparse_buffer_vtable);
+}
+
+iree_status_t iree_hal_vulkan_sparse_buffer_commit(
+    iree_hal_buffer_t* base_buffer, iree::hal::vulkan::CommandQueue* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_device_size_t offset, iree_device_size_t length) {
+  IREE_ASSERT_ARGUMENT(base_buffer);
+  IREE_ASSERT_ARGUMENT(queue);
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(base_buffer);
+  if (!iree_hal_vulkan_sparse_buffer_isa(allocated_buffer)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "buffer is not a Vulkan sparse buffer");
+  }
+  iree_hal_vulkan_sparse_buffer_t* buffer =
+      iree_hal_vulkan_sparse_buffer_cast(allocated_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_validate_range(base_buffer, offset, length));
+  const iree_device_size_t resource_offset =
+      iree_hal_buffer_byte_offset(base_buffer) + offset;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)resource_offset);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+
+  // Commits are serialized so that concurrent growth of the same buffer never
+  // allocates the same block twice.
+  iree_slim_mutex_lock(&buffer->mutex);
+
+  // Allocate any blocks overlapping the range that are not yet committed.
+  iree_host_size_t first_block = 0;
+  iree_host_size_t block_count = 0;
+  if (length > 0) {
+    first_block =
+        (iree_host_size_t)(resource_offset / buffer->physical_block_size);
+    block_count = (iree_host_size_t)iree_device_size_ceil_div(
+                      resource_offset + length, buffer->physical_block_size) -
+                  first_block;
+  }
+  VkSparseMemoryBind* binds = NULL;
+  iree_allocator_t host_allocator = base_buffer->host_allocator;
+  iree_status_t status = iree_ok_status();
+  if (block_count > 0) {
+    status = iree_allocator_malloc(
+        host_allocator, block_count * sizeof(*binds), (void**)&binds);
+  }
+  iree_host_size_t bind_count = 0;
+  for (iree_host_size_t i = first_block;
+       iree_status_is_ok(status) && i < first_block + block_count; ++i) {
+    if (buffer->physical_blocks[i] != VK_NULL_HANDLE) continue;
+    status = iree_hal_vulkan_sparse_buffer_allocate_block(buffer, i,
+                                                          &binds[bind_count]);
+    if (iree_status_is_ok(status)) ++bind_count;
+  }
+
+  // Bind the new blocks; this is still issued if there's nothing to bind so
+  // that the semaphores are ordered as requested.
+  if (iree_status_is_ok(status)) {
+    status = queue->BindSparse(wait_semaphore_list, signal_semaphore_list,
+                               buffer->base.handle, bind_count, binds);
+  }
+  if (!iree_status_is_ok(status)) {
+    // The binds were never issued so the new blocks can be freed immediately.
+    for (iree_host_size_t i = 0; i < bind_count; ++i) {
+      iree_hal_vulkan_sparse_buffer_free_block(
+          buffer, (iree_host_size_t)(binds[i].resourceOffset /
+                                     buffer->physical_block_size));
+    }
+  }
+
+  iree_slim_mutex_unlock(&buffer->mutex);
+  iree_allocator_free(host_allocator, binds);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_device_size_t iree_hal_vulkan_sparse_buffer_committed_size(
+    iree_hal_buffer_t* base_buffer) {
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(base_buffer);
+  if (!iree_hal_vulkan_sparse_buffer_isa(allocated_buffer)) return 0;
+  iree_hal_vulkan_sparse_buffer_t* buffer =
+      iree_hal_vulkan_sparse_buffer_cast(allocated_buffer);
+  iree_slim_mutex_lock(&buffer->mutex);
+  iree_device_size_t committed_size = buffer->committed_size;
+  iree_slim_mutex_unlock(&buffer->mutex);
+  return committed_size;
+}
+
 static iree_status_t iree_hal_vulkan_sparse_buffer_map_range(
     iree_hal_buffer_t* base_buffer, iree_hal_mapping_mode_t mapping_mode,
     iree_hal_memory_access_t memory_access,
@@ -13,6 +13,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/vulkan/command_queue.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
 
 #ifdef __cplusplus
@@ -35,6 +36,35 @@ iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
     uint32_t memory_type_index, VkDeviceSize max_allocation_size,
     iree_hal_buffer_t** out_buffer);
 
+// EXPERIMENTAL: allocate a partially resident buffer with no memory bound.
+// Device memory is committed in blocks on demand with
+// iree_hal_vulkan_sparse_buffer_commit as the used range of the buffer grows.
+// |handle| must have been created with VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT.
+iree_status_t iree_hal_vulkan_sparse_buffer_create_reserved(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkBuffer handle,
+    VkMemoryRequirements requirements, uint32_t memory_type_index,
+    VkDeviceSize max_allocation_size, iree_hal_buffer_t** out_buffer);
+
+// Returns true if |buffer| is a Vulkan sparse buffer.
+bool iree_hal_vulkan_sparse_buffer_isa(iree_hal_buffer_t* buffer);
+
+// Commits device memory to all blocks of |buffer| overlapping the byte range
+// [|offset|, |offset| + |length|) that are not yet committed. The memory is
+// bound on |queue| once |wait_semaphore_list| is reached and
+// |signal_semaphore_list| is signaled when the range may be used.
+iree_status_t iree_hal_vulkan_sparse_buffer_commit(
+    iree_hal_buffer_t* buffer, iree::hal::vulkan::CommandQueue* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_device_size_t offset, iree_device_size_t length);
+
+// Returns the total bytes of device memory committed to |buffer|.
+iree_device_size_t iree_hal_vulkan_sparse_buffer_committed_size(
+    iree_hal_buffer_t* buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
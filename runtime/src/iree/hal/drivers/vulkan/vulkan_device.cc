@@ -13,6 +13,7 @@
 
 #include "iree/base/internal/arena.h"
 #include "iree/base/internal/math.h"
+#include "iree/hal/drivers/utils/queue.h"
 #include "iree/hal/drivers/vulkan/api.h"
 #include "iree/hal/drivers/vulkan/builtin_executables.h"
 #include "iree/hal/drivers/vulkan/command_queue.h"
@@ -27,12 +28,16 @@
 #include "iree/hal/drivers/vulkan/native_pipeline_layout.h"
 #include "iree/hal/drivers/vulkan/native_semaphore.h"
 #include "iree/hal/drivers/vulkan/nop_executable_cache.h"
+#include "iree/hal/drivers/vulkan/persistent_executable_cache.h"
+#include "iree/hal/drivers/vulkan/sparse_buffer.h"
 #include "iree/hal/drivers/vulkan/status_util.h"
 #include "iree/hal/drivers/vulkan/tracing.h"
 #include "iree/hal/drivers/vulkan/util/arena.h"
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
+#include "iree/hal/utils/queue_pool.h"
 
 using namespace iree::hal::vulkan;
 
@@ -213,11 +218,41 @@ IREE_API_EXPORT iree_status_t iree_hal_vulkan_query_extensibility_set(
   ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
           VK_EXT_EXTERNAL_MEMORY_HOST_EXTENSION_NAME);
 
+  // VK_KHR_external_memory_fd + VK_EXT_external_memory_dma_buf:
+  // Optional to enable import of opaque file descriptors and dma-bufs shared
+  // from other APIs/processes.
+  ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+          VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME);
+  ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+          VK_EXT_EXTERNAL_MEMORY_DMA_BUF_EXTENSION_NAME);
+
+  // VK_KHR_external_semaphore_fd:
+  // Optional to enable import/export of timeline semaphores for device-side
+  // synchronization with other APIs/processes.
+  ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+          VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME);
+
   // VK_KHR_buffer_device_address:
   // Promoted to core in Vulkan 1.2 but still an extension in 1.1.
   ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
           VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
 
+  // VK_EXT_descriptor_buffer:
+  // Only enabled when requested as it changes how all descriptor set layouts
+  // and pipelines are created. Descriptors become plain memory written by the
+  // host and bound by offset instead of being allocated from pools.
+  if (iree_all_bits_set(requested_features,
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS)) {
+    ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+            VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+  }
+
+  // VK_EXT_pipeline_creation_cache_control:
+  // Allows probing the pipeline cache without compiling so that only pipelines
+  // missing from the cache are compiled. Promoted to core in Vulkan 1.3.
+  ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+          VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME);
+
   //===--------------------------------------------------------------------===//
   // Vulkan forward-compatibility shims
   //===--------------------------------------------------------------------===//
@@ -427,15 +462,6 @@ static iree_status_t iree_hal_vulkan_select_queue_families(
         queue_family_properties[out_family_info->transfer_index].queueCount;
   }
 
-  // Ensure that we don't share the dispatch queues with transfer queues if
-  // that would put us over the queue count.
-  if (out_family_info->dispatch_index == out_family_info->transfer_index) {
-    out_family_info->transfer_queue_count = iree_min(
-        queue_family_properties[out_family_info->dispatch_index].queueCount -
-            out_family_info->dispatch_queue_count,
-        out_family_info->transfer_queue_count);
-  }
-
   // Limit the number of queues we create (for now).
   // We may want to allow this to grow, but each queue adds overhead and we
   // need to measure to make sure we can effectively use them all.
@@ -444,6 +470,17 @@ static iree_status_t iree_hal_vulkan_select_queue_families(
   out_family_info->transfer_queue_count =
       iree_min(1u, out_family_info->transfer_queue_count);
 
+  // Ensure that we don't share the dispatch queues with transfer queues if
+  // that would put us over the queue count. Any queues left in the family
+  // after the dispatch queues are used as transfer queues so that transfers
+  // can still run async with dispatches.
+  if (out_family_info->dispatch_index == out_family_info->transfer_index) {
+    out_family_info->transfer_queue_count = iree_min(
+        queue_family_properties[out_family_info->dispatch_index].queueCount -
+            out_family_info->dispatch_queue_count,
+        out_family_info->transfer_queue_count);
+  }
+
   return iree_ok_status();
 }
 
@@ -472,7 +509,7 @@ static iree_status_t iree_hal_vulkan_build_queue_sets(
   uint32_t base_queue_index = 0;
   if (queue_family_info.dispatch_index == queue_family_info.transfer_index) {
     // Sharing a family, so transfer queues follow compute queues.
-    base_queue_index = queue_family_info.dispatch_index;
+    base_queue_index = queue_family_info.dispatch_queue_count;
   }
   for (iree_host_size_t i = 0; i < queue_family_info.transfer_queue_count;
        ++i) {
@@ -496,10 +533,19 @@ typedef struct iree_hal_vulkan_device_t {
 
   // Flags overriding default device behavior.
   iree_hal_vulkan_device_flags_t flags;
+  // Streaming file transfer options from the device options. The loop is
+  // ignored and provided per-operation.
+  iree_hal_file_transfer_options_t file_transfer_options;
+  // Directory executable caches persist pipelines to or empty if disabled.
+  iree_string_view_t pipeline_cache_path;
+  // Maximum number of threads used to compile the pipelines of an executable.
+  iree_host_size_t pipeline_compile_concurrency;
   // Which optional extensions are active and available on the device.
   iree_hal_vulkan_device_extensions_t device_extensions;
   // Device properties for various optional features.
   iree_hal_vulkan_device_properties_t device_properties;
+  // External handle types all semaphores are created exportable as.
+  VkExternalSemaphoreHandleTypeFlags semaphore_export_handle_types;
 
   VkInstance instance;
   VkPhysicalDevice physical_device;
@@ -508,6 +554,10 @@ typedef struct iree_hal_vulkan_device_t {
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
 
+  // Pool servicing queue-ordered allocations from |device_allocator|.
+  iree_hal_queue_pool_params_t queue_pool_params;
+  iree_hal_queue_pool_t* queue_pool;
+
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
@@ -522,6 +572,8 @@ typedef struct iree_hal_vulkan_device_t {
   // dispatch_queues.
   iree_host_size_t transfer_queue_count;
   CommandQueue** transfer_queues;
+  // True if the dispatch queue family supports sparse binding operations.
+  bool dispatch_queues_support_sparse_binding;
 
   // |queue_count| tracing contexts, if tracing is enabled.
   iree_hal_vulkan_tracing_context_t** queue_tracing_contexts;
@@ -612,11 +664,9 @@ static iree_status_t iree_hal_vulkan_device_initialize_command_queues(
   // the tracing subsystem for query and cleanup tasks.
   VkQueue maintenance_dispatch_queue = VK_NULL_HANDLE;
 
-  uint64_t compute_queue_count =
-      iree_math_count_ones_u64(compute_queue_set->queue_indices);
   uint64_t transfer_queue_count =
       iree_math_count_ones_u64(transfer_queue_set->queue_indices);
-  for (iree_host_size_t i = 0; i < compute_queue_count; ++i) {
+  for (iree_host_size_t i = 0; i < 64; ++i) {
     if (!(compute_queue_set->queue_indices & (1ull << i))) continue;
 
     char queue_name_buffer[32];
@@ -654,7 +704,7 @@ static iree_status_t iree_hal_vulkan_device_initialize_command_queues(
       queue->set_tracing_context(device->queue_tracing_contexts[queue_index]);
     }
   }
-  for (iree_host_size_t i = 0; i < transfer_queue_count; ++i) {
+  for (iree_host_size_t i = 0; i < 64; ++i) {
     if (!(transfer_queue_set->queue_indices & (1ull << i))) continue;
 
     char queue_name_buffer[32];
@@ -705,7 +755,7 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
 
   iree_hal_vulkan_device_t* device = NULL;
   iree_host_size_t total_size =
-      sizeof(*device) + identifier.size +
+      sizeof(*device) + identifier.size + options->pipeline_cache_path.size +
       total_queue_count * sizeof(device->queues[0]) +
       total_queue_count * sizeof(device->dispatch_queues[0]) +
       total_queue_count * sizeof(device->transfer_queues[0]) +
@@ -721,7 +771,16 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
   uint8_t* buffer_ptr = (uint8_t*)device + sizeof(*device);
   buffer_ptr += iree_string_view_append_to_buffer(
       identifier, &device->identifier, (char*)buffer_ptr);
+  buffer_ptr += iree_string_view_append_to_buffer(
+      options->pipeline_cache_path, &device->pipeline_cache_path,
+      (char*)buffer_ptr);
   device->flags = options->flags;
+  device->file_transfer_options.chunk_count =
+      options->file_transfer.chunk_count;
+  device->file_transfer_options.chunk_size = options->file_transfer.chunk_size;
+  device->file_transfer_options.staging_limit =
+      options->file_transfer.staging_limit;
+  device->pipeline_compile_concurrency = options->pipeline_compile_concurrency;
 
   device->device_extensions = *device_extensions;
   device->device_properties = *device_properties;
@@ -729,6 +788,26 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
   device->physical_device = physical_device;
   device->logical_device = logical_device;
   device->logical_device->AddReference();
+  device->semaphore_export_handle_types =
+      iree_hal_vulkan_native_semaphore_query_export_handle_types(
+          logical_device, physical_device);
+
+  // Partially resident buffers are committed with sparse binds issued on the
+  // dispatch queues and require the family to support them.
+  uint32_t queue_family_count = 0;
+  logical_device->syms()->vkGetPhysicalDeviceQueueFamilyProperties(
+      physical_device, &queue_family_count, NULL);
+  VkQueueFamilyProperties* queue_family_properties =
+      (VkQueueFamilyProperties*)iree_alloca(queue_family_count *
+                                            sizeof(VkQueueFamilyProperties));
+  logical_device->syms()->vkGetPhysicalDeviceQueueFamilyProperties(
+      physical_device, &queue_family_count, queue_family_properties);
+  if (compute_queue_set->queue_family_index < queue_family_count) {
+    device->dispatch_queues_support_sparse_binding = iree_all_bits_set(
+        queue_family_properties[compute_queue_set->queue_family_index]
+            .queueFlags,
+        VK_QUEUE_SPARSE_BINDING_BIT);
+  }
 
 #if defined(IREE_HAL_VULKAN_HAVE_RENDERDOC)
   device->renderdoc_api = iree_hal_vulkan_query_renderdoc_api(instance);
@@ -758,6 +837,15 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
       options, instance, physical_device, logical_device,
       &device->device_allocator);
 
+  // Create the pool used for queue-ordered allocations on top of the device
+  // allocator.
+  if (iree_status_is_ok(status)) {
+    iree_hal_queue_pool_params_initialize(&device->queue_pool_params);
+    status = iree_hal_queue_pool_create(
+        device->queue_pool_params, device->device_allocator,
+        device->host_allocator, &device->queue_pool);
+  }
+
   // Create command pools for each queue family. If we don't have a transfer
   // queue then we'll ignore that one and just use the dispatch pool.
   // If we wanted to expose the pools through the HAL to allow the VM to more
@@ -819,6 +907,7 @@ static void iree_hal_vulkan_device_destroy(iree_hal_device_t* base_device) {
   delete device->descriptor_pool_cache;
 
   // There should be no more buffers live that use the allocator.
+  iree_hal_queue_pool_free(device->queue_pool);
   iree_hal_allocator_release(device->device_allocator);
 
   // Buffers may have been retaining collective resources.
@@ -1150,6 +1239,30 @@ iree_status_t iree_hal_vulkan_device_create(
   available_coop_matrix_features.pNext = available_features2.pNext;
   available_features2.pNext = &available_coop_matrix_features;
 
+  // + Descriptor buffer features.
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT
+      available_descriptor_buffer_features;
+  memset(&available_descriptor_buffer_features, 0,
+         sizeof(available_descriptor_buffer_features));
+  available_descriptor_buffer_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+  if (enabled_device_extensions.descriptor_buffer) {
+    available_descriptor_buffer_features.pNext = available_features2.pNext;
+    available_features2.pNext = &available_descriptor_buffer_features;
+  }
+
+  // + Pipeline creation cache control features.
+  VkPhysicalDevicePipelineCreationCacheControlFeaturesEXT
+      available_cache_control_features;
+  memset(&available_cache_control_features, 0,
+         sizeof(available_cache_control_features));
+  available_cache_control_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES_EXT;
+  if (enabled_device_extensions.pipeline_creation_cache_control) {
+    available_cache_control_features.pNext = available_features2.pNext;
+    available_features2.pNext = &available_cache_control_features;
+  }
+
   instance_syms->vkGetPhysicalDeviceFeatures2(physical_device,
                                               &available_features2);
   const VkPhysicalDeviceFeatures* available_features =
@@ -1214,10 +1327,21 @@ iree_status_t iree_hal_vulkan_device_create(
     enabled_features |= IREE_HAL_VULKAN_FEATURE_ENABLE_ROBUST_BUFFER_ACCESS;
   }
 
+  // Descriptor buffers require buffer device addresses for both the descriptor
+  // buffers themselves and the buffers referenced by descriptors.
+  const bool enable_descriptor_buffers =
+      iree_all_bits_set(requested_features,
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS) &&
+      enabled_device_extensions.descriptor_buffer &&
+      available_descriptor_buffer_features.descriptorBuffer &&
+      available_buffer_device_address_features.bufferDeviceAddress;
+  enabled_device_extensions.descriptor_buffer = enable_descriptor_buffers;
+
   VkPhysicalDeviceBufferDeviceAddressFeatures buffer_device_address_features;
-  if (iree_all_bits_set(
-          requested_features,
-          IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES) &&
+  if ((enable_descriptor_buffers ||
+       iree_all_bits_set(
+           requested_features,
+           IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES)) &&
       available_buffer_device_address_features.bufferDeviceAddress) {
     memset(&buffer_device_address_features, 0,
            sizeof(buffer_device_address_features));
@@ -1229,6 +1353,31 @@ iree_status_t iree_hal_vulkan_device_create(
     enabled_features |= IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES;
   }
 
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features;
+  if (enable_descriptor_buffers) {
+    memset(&descriptor_buffer_features, 0, sizeof(descriptor_buffer_features));
+    descriptor_buffer_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+    descriptor_buffer_features.pNext = enabled_features2.pNext;
+    enabled_features2.pNext = &descriptor_buffer_features;
+    descriptor_buffer_features.descriptorBuffer = VK_TRUE;
+    enabled_features |= IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS;
+  }
+
+  VkPhysicalDevicePipelineCreationCacheControlFeaturesEXT
+      cache_control_features;
+  enabled_device_extensions.pipeline_creation_cache_control =
+      enabled_device_extensions.pipeline_creation_cache_control &&
+      available_cache_control_features.pipelineCreationCacheControl;
+  if (enabled_device_extensions.pipeline_creation_cache_control) {
+    memset(&cache_control_features, 0, sizeof(cache_control_features));
+    cache_control_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES_EXT;
+    cache_control_features.pNext = enabled_features2.pNext;
+    enabled_features2.pNext = &cache_control_features;
+    cache_control_features.pipelineCreationCacheControl = VK_TRUE;
+  }
+
   VkPhysicalDeviceTimelineSemaphoreFeatures semaphore_features;
   memset(&semaphore_features, 0, sizeof(semaphore_features));
   semaphore_features.sType =
@@ -1401,6 +1550,20 @@ static void iree_hal_vulkan_replace_device_allocator(
   iree_hal_allocator_retain(new_allocator);
   iree_hal_allocator_release(device->device_allocator);
   device->device_allocator = new_allocator;
+
+  // Recreate the queue pool so that new queue-ordered allocations come from
+  // the new allocator. Buffers acquired from the old pool remain valid. If the
+  // pool can't be recreated the old one continues to be used.
+  iree_hal_queue_pool_t* new_queue_pool = NULL;
+  iree_status_t status =
+      iree_hal_queue_pool_create(device->queue_pool_params, new_allocator,
+                                 device->host_allocator, &new_queue_pool);
+  if (iree_status_is_ok(status)) {
+    iree_hal_queue_pool_free(device->queue_pool);
+    device->queue_pool = new_queue_pool;
+  } else {
+    iree_status_ignore(status);
+  }
 }
 
 static void iree_hal_vulkan_replace_channel_provider(
@@ -1415,6 +1578,7 @@ static iree_status_t iree_hal_vulkan_device_trim(
     iree_hal_device_t* base_device) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   iree_arena_block_pool_trim(&device->block_pool);
+  iree_hal_queue_pool_trim(device->queue_pool);
   return iree_hal_allocator_trim(device->device_allocator);
 }
 
@@ -1448,6 +1612,12 @@ static iree_status_t iree_hal_vulkan_device_query_i64(
     }
   }
 
+  if (iree_string_view_equal(category, IREE_SV("hal.queue_pool"))) {
+    // Queue-ordered allocation pool accounting; used to verify steady state
+    // workloads are not allocating and to size the pool.
+    return iree_hal_queue_pool_query_i64(device->queue_pool, key, out_value);
+  }
+
   // Note that the device queries used here should match the ones used in
   // buildDeviceQueryRegion() on the compiler side.
   if (iree_string_view_equal(category, IREE_SV("hal.dispatch"))) {
@@ -1488,27 +1658,32 @@ static iree_status_t iree_hal_vulkan_device_query_i64(
       (int)category.size, category.data, (int)key.size, key.data);
 }
 
+// Returns true if command buffers containing only |command_categories| are
+// recorded for and submitted to the transfer queues. This is only done when
+// the device has transfer queues separate from its dispatch queues.
+static bool iree_hal_vulkan_device_uses_transfer_queues(
+    iree_hal_vulkan_device_t* device,
+    iree_hal_command_category_t command_categories) {
+  return device->transfer_command_pool != NULL &&
+         command_categories == IREE_HAL_COMMAND_CATEGORY_TRANSFER;
+}
+
 // Returns the queue to submit work to based on the |queue_affinity|.
+// Each affinity bit maps to one dispatch queue and work touching only transfer
+// commands is routed to the transfer queues when available such that it can
+// overlap with dispatches. Ordering across queues is established by the
+// timeline semaphores waited and signaled by each submission.
 static CommandQueue* iree_hal_vulkan_device_select_queue(
     iree_hal_vulkan_device_t* device,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity) {
-  // TODO(scotttodd): revisit queue selection logic and remove this
-  //   * the unaligned buffer fill polyfill and tracing timestamp queries may
-  //     both insert dispatches into command buffers that at compile time are
-  //     expected to only contain transfer commands
-  //   * we could set a bit at recording time if emulation or tracing is used
-  //     and submit to the right queue based on that
-  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
-
-  // TODO(benvanik): meaningful heuristics for affinity. We don't generate
-  // anything from the compiler that uses multiple queues and until we do it's
-  // best not to do anything too clever here.
-  if (command_categories == IREE_HAL_COMMAND_CATEGORY_TRANSFER) {
-    return device
-        ->transfer_queues[queue_affinity % device->transfer_queue_count];
-  }
-  return device->dispatch_queues[queue_affinity % device->dispatch_queue_count];
+  if (iree_hal_vulkan_device_uses_transfer_queues(device,
+                                                 command_categories)) {
+    return device->transfer_queues[iree_hal_queue_affinity_select_index(
+        queue_affinity, device->transfer_queue_count)];
+  }
+  return device->dispatch_queues[iree_hal_queue_affinity_select_index(
+      queue_affinity, device->dispatch_queue_count)];
 }
 
 static iree_status_t iree_hal_vulkan_device_create_channel(
@@ -1518,30 +1693,26 @@ static iree_status_t iree_hal_vulkan_device_create_channel(
                           "collectives not implemented");
 }
 
-static iree_status_t iree_hal_vulkan_device_create_command_buffer(
-    iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
+// Allocates a command buffer recording directly into a VkCommandBuffer.
+// Command buffers with only transfer commands are allocated for the transfer
+// queue family when there are transfer queues and otherwise for the dispatch
+// queue family.
+static iree_status_t iree_hal_vulkan_device_create_direct_command_buffer(
+    iree_hal_vulkan_device_t* device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_queue_affinity_t queue_affinity,
     iree_hal_command_buffer_t** out_command_buffer) {
-  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
-
-  // TODO(scotttodd): revisit queue selection logic and remove this
-  //   * the unaligned buffer fill polyfill and tracing timestamp queries may
-  //     both insert dispatches into command buffers that at compile time are
-  //     expected to only contain transfer commands
-  //   * we could set a bit at recording time if emulation or tracing is used
-  //     and submit to the right queue based on that
-  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
-
   // Select the command pool to used based on the types of commands used.
   // Note that we may not have a dedicated transfer command pool if there are
   // no dedicated transfer queues.
   VkCommandPoolHandle* command_pool = NULL;
-  if (device->transfer_command_pool &&
-      !iree_all_bits_set(command_categories,
-                         IREE_HAL_COMMAND_CATEGORY_DISPATCH)) {
+  if (iree_hal_vulkan_device_uses_transfer_queues(device,
+                                                 command_categories)) {
     command_pool = device->transfer_command_pool;
   } else {
+    // The unaligned buffer fill polyfill may insert dispatches into command
+    // buffers that are expected to only contain transfer commands.
+    command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
     command_pool = device->dispatch_command_pool;
   }
 
@@ -1554,12 +1725,38 @@ static iree_status_t iree_hal_vulkan_device_create_command_buffer(
       device, command_categories, queue_affinity);
 
   return iree_hal_vulkan_direct_command_buffer_allocate(
-      base_device, device->logical_device, command_pool, mode,
-      command_categories, queue_affinity, binding_capacity,
+      (iree_hal_device_t*)device, device->logical_device, command_pool, mode,
+      command_categories, queue_affinity, /*binding_capacity=*/0,
       queue->tracing_context(), device->descriptor_pool_cache,
       device->builtin_executables, &device->block_pool, out_command_buffer);
 }
 
+static iree_status_t iree_hal_vulkan_device_create_command_buffer(
+    iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+
+  // Descriptor sets are pushed directly into the Vulkan command buffer during
+  // recording and can't be updated after. Command buffers with indirect
+  // bindings are recorded as deferred command buffers and replayed with the
+  // binding table provided each time they are submitted.
+  //
+  // Transfer-only command buffers are also deferred when there are transfer
+  // queues: whether they can run on the transfer queue family is only known
+  // once all commands have been recorded (unaligned fills require dispatches).
+  if (binding_capacity > 0 || iree_hal_vulkan_device_uses_transfer_queues(
+                                  device, command_categories)) {
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->block_pool, device->host_allocator, out_command_buffer);
+  }
+
+  return iree_hal_vulkan_device_create_direct_command_buffer(
+      device, mode, command_categories, queue_affinity, out_command_buffer);
+}
+
 static iree_status_t iree_hal_vulkan_device_create_descriptor_set_layout(
     iree_hal_device_t* base_device,
     iree_hal_descriptor_set_layout_flags_t flags,
@@ -1582,8 +1779,15 @@ static iree_status_t iree_hal_vulkan_device_create_executable_cache(
     iree_hal_device_t* base_device, iree_string_view_t identifier,
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  if (!iree_string_view_is_empty(device->pipeline_cache_path)) {
+    return iree_hal_vulkan_persistent_executable_cache_create(
+        device->logical_device, device->physical_device, identifier,
+        device->pipeline_cache_path, device->pipeline_compile_concurrency,
+        out_executable_cache);
+  }
   return iree_hal_vulkan_nop_executable_cache_create(
-      device->logical_device, identifier, out_executable_cache);
+      device->logical_device, identifier, device->pipeline_compile_concurrency,
+      out_executable_cache);
 }
 
 static iree_status_t iree_hal_vulkan_device_import_file(
@@ -1616,8 +1820,19 @@ static iree_status_t iree_hal_vulkan_device_create_semaphore(
     iree_hal_device_t* base_device, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
-  return iree_hal_vulkan_native_semaphore_create(device->logical_device,
-                                                 initial_value, out_semaphore);
+  return iree_hal_vulkan_native_semaphore_create(
+      device->logical_device, initial_value,
+      device->semaphore_export_handle_types, out_semaphore);
+}
+
+static iree_status_t iree_hal_vulkan_device_import_semaphore(
+    iree_hal_device_t* base_device,
+    const iree_hal_external_semaphore_t* external_semaphore,
+    iree_hal_external_semaphore_flags_t flags,
+    iree_hal_semaphore_t** out_semaphore) {
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  return iree_hal_vulkan_native_semaphore_import(
+      device->logical_device, external_semaphore, flags, out_semaphore);
 }
 
 static iree_hal_semaphore_compatibility_t
@@ -1629,8 +1844,8 @@ iree_hal_vulkan_device_query_semaphore_compatibility(
     // multiple devices are used.
     return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
   }
-  // TODO(benvanik): semaphore APIs for querying allowed export formats. We
-  // can check device caps to see what external semaphore types are supported.
+  // Semaphores from other devices must be exported and imported with
+  // iree_hal_semaphore_import for device-side use.
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
 }
 
@@ -1641,14 +1856,22 @@ static iree_status_t iree_hal_vulkan_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO(benvanik): queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
-                                                    iree_infinite_timeout()));
-  IREE_RETURN_IF_ERROR(
-      iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(base_device),
-                                         params, allocation_size, out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+
+  // Reserve memory that will be free by the time the waits are reached and
+  // order the signal after the waits on the queue.
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_queue_pool_acquire(
+      device->queue_pool, wait_semaphore_list, params, allocation_size,
+      &buffer));
+  iree_status_t status = iree_hal_device_queue_barrier(
+      base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list);
+  if (iree_status_is_ok(status)) {
+    *out_buffer = buffer;
+  } else {
+    iree_hal_buffer_release(buffer);
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_vulkan_device_queue_dealloca(
@@ -1656,9 +1879,13 @@ static iree_status_t iree_hal_vulkan_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO(benvanik): queue-ordered allocations.
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+
+  // The memory is no longer used once the waits are reached and can be reused
+  // by any allocation ordered after them.
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
+  iree_hal_queue_pool_release(device->queue_pool, buffer, wait_semaphore_list);
   return iree_ok_status();
 }
 
@@ -1669,13 +1896,10 @@ static iree_status_t iree_hal_vulkan_device_queue_read(
     iree_hal_file_t* source_file, uint64_t source_offset,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
-  iree_hal_file_transfer_options_t options = {
-      /*.loop=*/iree_loop_inline(&loop_status),
-      /*.chunk_count=*/IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      /*.chunk_size=*/IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
-  };
+  iree_hal_file_transfer_options_t options = device->file_transfer_options;
+  options.loop = iree_loop_inline(&loop_status);
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_read_streaming(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
       source_file, source_offset, target_buffer, target_offset, length, flags,
@@ -1690,13 +1914,10 @@ static iree_status_t iree_hal_vulkan_device_queue_write(
     iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
     iree_hal_file_t* target_file, uint64_t target_offset,
     iree_device_size_t length, uint32_t flags) {
-  // TODO: expose streaming chunk count/size options.
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   iree_status_t loop_status = iree_ok_status();
-  iree_hal_file_transfer_options_t options = {
-      /*.loop=*/iree_loop_inline(&loop_status),
-      /*.chunk_count=*/IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
-      /*.chunk_size=*/IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
-  };
+  iree_hal_file_transfer_options_t options = device->file_transfer_options;
+  options.loop = iree_loop_inline(&loop_status);
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_write_streaming(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
       source_buffer, source_offset, target_file, target_offset, length, flags,
@@ -1704,26 +1925,122 @@ static iree_status_t iree_hal_vulkan_device_queue_write(
   return loop_status;
 }
 
+// Replays each deferred command buffer in |command_buffers| with its binding
+// table into a new one-shot direct command buffer stored in
+// |out_command_buffers|. All other command buffers are passed through. All
+// command buffers in |out_command_buffers| are retained and must be released
+// by the caller, even on failure. Transfer-only command buffers are replayed
+// for the transfer queue family if |use_transfer_queues| is set and fail with
+// IREE_STATUS_UNAVAILABLE if they contain commands that family can't execute.
+static iree_status_t iree_hal_vulkan_device_replay_command_buffers(
+    iree_hal_vulkan_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    bool use_transfer_queues, iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables,
+    iree_hal_command_buffer_t** out_command_buffers) {
+  memset(out_command_buffers, 0,
+         command_buffer_count * sizeof(*out_command_buffers));
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    iree_hal_command_buffer_t* command_buffer = command_buffers[i];
+    if (!iree_hal_deferred_command_buffer_isa(command_buffer)) {
+      iree_hal_command_buffer_retain(command_buffer);
+      out_command_buffers[i] = command_buffer;
+      continue;
+    }
+    iree_hal_command_category_t command_categories =
+        iree_hal_command_buffer_allowed_categories(command_buffer);
+    if (!use_transfer_queues) {
+      command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
+    }
+    IREE_RETURN_IF_ERROR(iree_hal_vulkan_device_create_direct_command_buffer(
+        device,
+        iree_hal_command_buffer_mode(command_buffer) |
+            IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        command_categories, queue_affinity, &out_command_buffers[i]));
+    IREE_RETURN_IF_ERROR(iree_hal_deferred_command_buffer_apply(
+        command_buffer, out_command_buffers[i],
+        binding_tables ? binding_tables[i]
+                       : iree_hal_buffer_binding_table_empty()));
+  }
+  return iree_ok_status();
+}
+
+static void iree_hal_vulkan_device_release_command_buffers(
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t** command_buffers) {
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    iree_hal_command_buffer_release(command_buffers[i]);
+    command_buffers[i] = NULL;
+  }
+}
+
 static iree_status_t iree_hal_vulkan_device_queue_execute(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_host_size_t command_buffer_count,
-    iree_hal_command_buffer_t* const* command_buffers) {
+    iree_hal_command_buffer_t* const* command_buffers,
+    const iree_hal_buffer_binding_table_t* binding_tables) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
-  // NOTE: today we are not discriminating queues based on command type.
-  CommandQueue* queue = iree_hal_vulkan_device_select_queue(
-      device, IREE_HAL_COMMAND_CATEGORY_DISPATCH, queue_affinity);
-  iree_hal_submission_batch_t batch = {
-      /*.wait_semaphores=*/wait_semaphore_list,
-      /*.command_buffer_count=*/command_buffer_count,
-      /*.command_buffers=*/command_buffers,
-      /*.signal_semaphores=*/signal_semaphore_list,
-  };
-  IREE_RETURN_IF_ERROR(queue->Submit(1, &batch));
-  // HACK: we don't track async resource lifetimes so we have to block.
-  return iree_hal_semaphore_list_wait(signal_semaphore_list,
-                                      iree_infinite_timeout());
+
+  // Submissions containing only transfer command buffers go to the transfer
+  // queues (when the device has any) so that they can overlap with dispatches
+  // on the dispatch queues. Submissions without command buffers are only used
+  // to order semaphores and are kept on the dispatch queues.
+  iree_hal_command_category_t command_categories = 0;
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    command_categories |=
+        iree_hal_command_buffer_allowed_categories(command_buffers[i]);
+  }
+  bool use_transfer_queues =
+      command_buffer_count > 0 &&
+      iree_hal_vulkan_device_uses_transfer_queues(device, command_categories);
+
+  // Replay any deferred command buffers. The replayed command buffers only
+  // need to live until the submission completes below.
+  iree_hal_command_buffer_t** replayed_command_buffers =
+      (iree_hal_command_buffer_t**)iree_alloca(
+          command_buffer_count * sizeof(iree_hal_command_buffer_t*));
+  iree_status_t status = iree_hal_vulkan_device_replay_command_buffers(
+      device, queue_affinity, use_transfer_queues, command_buffer_count,
+      command_buffers, binding_tables, replayed_command_buffers);
+  if (use_transfer_queues && iree_status_is_unavailable(status)) {
+    // Some commands can't run on the transfer queue family (such as unaligned
+    // fills that are polyfilled with dispatches) so replay everything for the
+    // dispatch queues instead.
+    iree_status_ignore(status);
+    iree_hal_vulkan_device_release_command_buffers(command_buffer_count,
+                                                   replayed_command_buffers);
+    use_transfer_queues = false;
+    status = iree_hal_vulkan_device_replay_command_buffers(
+        device, queue_affinity, use_transfer_queues, command_buffer_count,
+        command_buffers, binding_tables, replayed_command_buffers);
+  }
+
+  if (iree_status_is_ok(status)) {
+    CommandQueue* queue = iree_hal_vulkan_device_select_queue(
+        device,
+        use_transfer_queues ? IREE_HAL_COMMAND_CATEGORY_TRANSFER
+                            : IREE_HAL_COMMAND_CATEGORY_ANY,
+        queue_affinity);
+    iree_hal_submission_batch_t batch = {
+        /*.wait_semaphores=*/wait_semaphore_list,
+        /*.command_buffer_count=*/command_buffer_count,
+        /*.command_buffers=*/replayed_command_buffers,
+        /*.signal_semaphores=*/signal_semaphore_list,
+        /*.binding_tables=*/NULL,
+    };
+    status = queue->Submit(1, &batch);
+  }
+  if (iree_status_is_ok(status)) {
+    // HACK: we don't track async resource lifetimes so we have to block.
+    status = iree_hal_semaphore_list_wait(signal_semaphore_list,
+                                          iree_infinite_timeout());
+  }
+
+  iree_hal_vulkan_device_release_command_buffers(command_buffer_count,
+                                                 replayed_command_buffers);
+  return status;
 }
 
 static iree_status_t iree_hal_vulkan_device_queue_flush(
@@ -1828,6 +2145,54 @@ static iree_status_t iree_hal_vulkan_device_profiling_end(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_vulkan_sparse_buffer_reserve(
+    iree_hal_device_t* base_device, iree_hal_buffer_params_t params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  if (!iree_hal_resource_is(base_device, &iree_hal_vulkan_device_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "device is not a Vulkan HAL device");
+  }
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  if (!device->dispatch_queues_support_sparse_binding) {
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "dispatch queues do not support sparse binding operations");
+  }
+  iree_hal_buffer_params_canonicalize(&params);
+  return iree_hal_vulkan_native_allocator_reserve_sparse_buffer(
+      device->device_allocator, &params, allocation_size, out_buffer);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_vulkan_sparse_buffer_commit_range(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* buffer, iree_device_size_t offset,
+    iree_device_size_t length) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(buffer);
+  if (!iree_hal_resource_is(base_device, &iree_hal_vulkan_device_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "device is not a Vulkan HAL device");
+  }
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  CommandQueue* queue = iree_hal_vulkan_device_select_queue(
+      device, IREE_HAL_COMMAND_CATEGORY_ANY, queue_affinity);
+  return iree_hal_vulkan_sparse_buffer_commit(buffer, queue,
+                                              wait_semaphore_list,
+                                              signal_semaphore_list, offset,
+                                              length);
+}
+
+IREE_API_EXPORT iree_device_size_t
+iree_hal_vulkan_sparse_buffer_query_committed_size(iree_hal_buffer_t* buffer) {
+  IREE_ASSERT_ARGUMENT(buffer);
+  return iree_hal_vulkan_sparse_buffer_committed_size(buffer);
+}
+
 namespace {
 const iree_hal_device_vtable_t iree_hal_vulkan_device_vtable = {
     /*.destroy=*/iree_hal_vulkan_device_destroy,
@@ -1849,6 +2214,7 @@ const iree_hal_device_vtable_t iree_hal_vulkan_device_vtable = {
     /*.create_pipeline_layout=*/
     iree_hal_vulkan_device_create_pipeline_layout,
     /*.create_semaphore=*/iree_hal_vulkan_device_create_semaphore,
+    /*.import_semaphore=*/iree_hal_vulkan_device_import_semaphore,
     /*.query_semaphore_compatibility=*/
     iree_hal_vulkan_device_query_semaphore_compatibility,
     /*.queue_alloca=*/iree_hal_vulkan_device_queue_alloca,
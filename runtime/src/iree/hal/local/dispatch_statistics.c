@@ -0,0 +1,445 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_statistics.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define IREE_HAL_LOCAL_HARDWARE_COUNTERS_PERF_EVENT 1
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
+iree_atomic_int32_t iree_hal_local_dispatch_statistics_capture_count =
+    IREE_ATOMIC_VAR_INIT(0);
+iree_atomic_int32_t iree_hal_local_dispatch_statistics_sample_count =
+    IREE_ATOMIC_VAR_INIT(0);
+
+// Bitmask of 1 << iree_hal_local_hardware_counter_t of the counters that any
+// thread has successfully opened.
+static iree_atomic_int32_t iree_hal_local_hardware_counters_available_mask =
+    IREE_ATOMIC_VAR_INIT(0);
+
+//===----------------------------------------------------------------------===//
+// Hardware counters
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_HAL_LOCAL_HARDWARE_COUNTERS_PERF_EVENT)
+
+// Per-thread perf_event group. Allocated on first read by each thread and
+// closed when the thread exits.
+typedef struct iree_hal_local_hardware_counters_state_t {
+  // Group leader file descriptor or -1 if no counters could be opened.
+  int group_fd;
+  // File descriptor of each counter or -1 if unavailable.
+  int fds[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT];
+  // Number of counters in the group in the order of |fds|.
+  uint64_t open_count;
+} iree_hal_local_hardware_counters_state_t;
+
+static pthread_key_t iree_hal_local_hardware_counters_key;
+static iree_once_flag iree_hal_local_hardware_counters_key_flag =
+    IREE_ONCE_FLAG_INIT;
+
+static void iree_hal_local_hardware_counters_state_free(void* arg) {
+  iree_hal_local_hardware_counters_state_t* state =
+      (iree_hal_local_hardware_counters_state_t*)arg;
+  for (int i = IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT - 1; i >= 0; --i) {
+    if (state->fds[i] != -1) close(state->fds[i]);
+  }
+  free(state);
+}
+
+static void iree_hal_local_hardware_counters_initialize_key(void) {
+  pthread_key_create(&iree_hal_local_hardware_counters_key,
+                     iree_hal_local_hardware_counters_state_free);
+}
+
+static void iree_hal_local_hardware_counters_make_attr(
+    iree_hal_local_hardware_counter_t counter, struct perf_event_attr* attr) {
+  memset(attr, 0, sizeof(*attr));
+  attr->size = sizeof(*attr);
+  attr->read_format = PERF_FORMAT_GROUP;
+  attr->exclude_kernel = 1;
+  attr->exclude_hv = 1;
+  switch (counter) {
+    case IREE_HAL_LOCAL_HARDWARE_COUNTER_CYCLES:
+      attr->type = PERF_TYPE_HARDWARE;
+      attr->config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case IREE_HAL_LOCAL_HARDWARE_COUNTER_INSTRUCTIONS:
+      attr->type = PERF_TYPE_HARDWARE;
+      attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case IREE_HAL_LOCAL_HARDWARE_COUNTER_L1D_READ_MISSES:
+      attr->type = PERF_TYPE_HW_CACHE;
+      attr->config = PERF_COUNT_HW_CACHE_L1D |
+                     (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    default:
+    case IREE_HAL_LOCAL_HARDWARE_COUNTER_LLC_MISSES:
+      attr->type = PERF_TYPE_HARDWARE;
+      attr->config = PERF_COUNT_HW_CACHE_MISSES;
+      break;
+  }
+}
+
+// Opens the counters of the calling thread as a single group so that they are
+// scheduled onto the PMU together and read with a single syscall.
+static iree_hal_local_hardware_counters_state_t*
+iree_hal_local_hardware_counters_open(void) {
+  iree_hal_local_hardware_counters_state_t* state =
+      (iree_hal_local_hardware_counters_state_t*)malloc(sizeof(*state));
+  if (!state) return NULL;
+  state->group_fd = -1;
+  state->open_count = 0;
+  int32_t available_mask = 0;
+  for (int i = 0; i < IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT; ++i) {
+    struct perf_event_attr attr;
+    iree_hal_local_hardware_counters_make_attr(
+        (iree_hal_local_hardware_counter_t)i, &attr);
+    attr.disabled = state->group_fd == -1 ? 1 : 0;
+    int fd = (int)syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                          state->group_fd, /*flags=*/0);
+    state->fds[i] = fd;
+    if (fd == -1) continue;
+    if (state->group_fd == -1) state->group_fd = fd;
+    ++state->open_count;
+    available_mask |= 1 << i;
+  }
+  if (state->group_fd != -1) {
+    ioctl(state->group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(state->group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    iree_atomic_fetch_or_int32(&iree_hal_local_hardware_counters_available_mask,
+                               available_mask, iree_memory_order_relaxed);
+  }
+  return state;
+}
+
+bool iree_hal_local_hardware_counters_read(
+    uint64_t out_values[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT]) {
+  iree_call_once(&iree_hal_local_hardware_counters_key_flag,
+                 iree_hal_local_hardware_counters_initialize_key);
+  iree_hal_local_hardware_counters_state_t* state =
+      (iree_hal_local_hardware_counters_state_t*)pthread_getspecific(
+          iree_hal_local_hardware_counters_key);
+  if (IREE_UNLIKELY(!state)) {
+    state = iree_hal_local_hardware_counters_open();
+    if (!state) return false;
+    pthread_setspecific(iree_hal_local_hardware_counters_key, state);
+  }
+  if (state->group_fd == -1) return false;
+
+  // PERF_FORMAT_GROUP: { u64 nr; u64 values[nr]; }
+  uint64_t buffer[1 + IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT];
+  ssize_t read_length = read(state->group_fd, buffer, sizeof(buffer));
+  if (read_length < (ssize_t)sizeof(uint64_t) ||
+      buffer[0] != state->open_count) {
+    return false;
+  }
+  uint64_t value_index = 1;
+  for (int i = 0; i < IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT; ++i) {
+    out_values[i] = state->fds[i] != -1 ? buffer[value_index++] : 0;
+  }
+  return true;
+}
+
+#else
+
+bool iree_hal_local_hardware_counters_read(
+    uint64_t out_values[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT]) {
+  // Unimplemented on this platform. Vendor APIs (such as kperf on Apple
+  // platforms) could be used here.
+  return false;
+}
+
+#endif  // IREE_HAL_LOCAL_HARDWARE_COUNTERS_PERF_EVENT
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_dispatch_statistics_*
+//===----------------------------------------------------------------------===//
+
+// Guards the entry list. Entries themselves are updated atomically without
+// holding the lock.
+static iree_slim_mutex_t iree_hal_local_dispatch_statistics_mutex;
+static iree_once_flag iree_hal_local_dispatch_statistics_init_flag =
+    IREE_ONCE_FLAG_INIT;
+
+// All entries ever created. Never freed so that executables can cache them.
+static iree_hal_local_dispatch_statistics_entry_t*
+    iree_hal_local_dispatch_statistics_head
+        IREE_GUARDED_BY(iree_hal_local_dispatch_statistics_mutex) = NULL;
+
+static void iree_hal_local_dispatch_statistics_initialize(void) {
+  iree_slim_mutex_initialize(&iree_hal_local_dispatch_statistics_mutex);
+}
+
+static void iree_hal_local_dispatch_statistics_lock(void) {
+  iree_call_once(&iree_hal_local_dispatch_statistics_init_flag,
+                 iree_hal_local_dispatch_statistics_initialize);
+  iree_slim_mutex_lock(&iree_hal_local_dispatch_statistics_mutex);
+}
+
+static void iree_hal_local_dispatch_statistics_unlock(void) {
+  iree_slim_mutex_unlock(&iree_hal_local_dispatch_statistics_mutex);
+}
+
+void iree_hal_local_dispatch_statistics_begin(
+    iree_hal_local_dispatch_statistics_flags_t flags) {
+  iree_hal_local_dispatch_statistics_lock();
+  if (iree_atomic_fetch_add_int32(
+          &iree_hal_local_dispatch_statistics_capture_count, 1,
+          iree_memory_order_acq_rel) == 0) {
+    for (iree_hal_local_dispatch_statistics_entry_t* entry =
+             iree_hal_local_dispatch_statistics_head;
+         entry != NULL; entry = entry->next) {
+      iree_atomic_store_int64(&entry->dispatch_count, 0,
+                              iree_memory_order_relaxed);
+      iree_atomic_store_int64(&entry->workgroup_count, 0,
+                              iree_memory_order_relaxed);
+      iree_atomic_store_int64(&entry->total_time_ns, 0,
+                              iree_memory_order_relaxed);
+      iree_atomic_store_int64(&entry->binding_bytes, 0,
+                              iree_memory_order_relaxed);
+      iree_atomic_store_int64(&entry->sampled_time_ns, 0,
+                              iree_memory_order_relaxed);
+      for (int i = 0; i < IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT; ++i) {
+        iree_atomic_store_int64(&entry->hardware_counters[i], 0,
+                                iree_memory_order_relaxed);
+      }
+    }
+  }
+  if (iree_all_bits_set(
+          flags, IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_HARDWARE_COUNTERS)) {
+    iree_atomic_fetch_add_int32(
+        &iree_hal_local_dispatch_statistics_sample_count, 1,
+        iree_memory_order_acq_rel);
+  }
+  iree_hal_local_dispatch_statistics_unlock();
+}
+
+void iree_hal_local_dispatch_statistics_end(
+    iree_hal_local_dispatch_statistics_flags_t flags) {
+  if (iree_all_bits_set(
+          flags, IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_HARDWARE_COUNTERS)) {
+    iree_atomic_fetch_add_int32(
+        &iree_hal_local_dispatch_statistics_sample_count, -1,
+        iree_memory_order_acq_rel);
+  }
+  iree_atomic_fetch_add_int32(&iree_hal_local_dispatch_statistics_capture_count,
+                              -1, iree_memory_order_acq_rel);
+}
+
+iree_status_t iree_hal_local_dispatch_statistics_lookup(
+    iree_string_view_t library_name, iree_string_view_t export_name,
+    iree_hal_local_dispatch_statistics_entry_t** out_entry) {
+  IREE_ASSERT_ARGUMENT(out_entry);
+  *out_entry = NULL;
+  iree_host_size_t name_length = library_name.size + 1 + export_name.size;
+
+  iree_hal_local_dispatch_statistics_lock();
+  iree_hal_local_dispatch_statistics_entry_t* entry =
+      iree_hal_local_dispatch_statistics_head;
+  for (; entry != NULL; entry = entry->next) {
+    if (strlen(entry->name) == name_length &&
+        memcmp(entry->name, library_name.data, library_name.size) == 0 &&
+        entry->name[library_name.size] == ':' &&
+        memcmp(entry->name + library_name.size + 1, export_name.data,
+               export_name.size) == 0) {
+      break;
+    }
+  }
+
+  iree_status_t status = iree_ok_status();
+  if (!entry) {
+    status = iree_allocator_malloc(iree_allocator_system(),
+                                   sizeof(*entry) + name_length + 1,
+                                   (void**)&entry);
+    if (iree_status_is_ok(status)) {
+      memset(entry, 0, sizeof(*entry));
+      char* name = (char*)entry + sizeof(*entry);
+      memcpy(name, library_name.data, library_name.size);
+      name[library_name.size] = ':';
+      memcpy(name + library_name.size + 1, export_name.data, export_name.size);
+      name[name_length] = 0;
+      entry->name = name;
+      entry->next = iree_hal_local_dispatch_statistics_head;
+      iree_hal_local_dispatch_statistics_head = entry;
+    }
+  }
+  iree_hal_local_dispatch_statistics_unlock();
+
+  *out_entry = entry;
+  return status;
+}
+
+// Snapshot of an entry taken for printing.
+typedef struct iree_hal_local_dispatch_statistics_row_t {
+  const char* name;
+  int64_t dispatch_count;
+  int64_t workgroup_count;
+  int64_t total_time_ns;
+  int64_t binding_bytes;
+  int64_t sampled_time_ns;
+  int64_t hardware_counters[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT];
+} iree_hal_local_dispatch_statistics_row_t;
+
+// Assumed size of the transfers counted by LLC misses.
+#define IREE_HAL_LOCAL_DISPATCH_STATISTICS_CACHE_LINE_SIZE 64
+
+// Prints the ratio of counters |lhs| / |rhs| * |scale| or `-` if either
+// counter is unavailable.
+static void iree_hal_local_dispatch_statistics_fprint_ratio(
+    FILE* file, const iree_hal_local_dispatch_statistics_row_t* row,
+    int32_t available_mask, iree_hal_local_hardware_counter_t lhs,
+    iree_hal_local_hardware_counter_t rhs, double scale) {
+  if (!iree_all_bits_set(available_mask, (1 << lhs) | (1 << rhs)) ||
+      row->hardware_counters[rhs] == 0) {
+    fprintf(file, " %10s", "-");
+    return;
+  }
+  fprintf(file, " %10.3f",
+          scale * row->hardware_counters[lhs] / row->hardware_counters[rhs]);
+}
+
+static int iree_hal_local_dispatch_statistics_row_compare(const void* lhs,
+                                                          const void* rhs) {
+  int64_t lhs_time =
+      ((const iree_hal_local_dispatch_statistics_row_t*)lhs)->total_time_ns;
+  int64_t rhs_time =
+      ((const iree_hal_local_dispatch_statistics_row_t*)rhs)->total_time_ns;
+  return lhs_time < rhs_time ? 1 : (lhs_time > rhs_time ? -1 : 0);
+}
+
+iree_status_t iree_hal_local_dispatch_statistics_fprint(FILE* file) {
+  IREE_ASSERT_ARGUMENT(file);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Snapshot the entries with dispatches so that printing happens without
+  // the lock held.
+  iree_hal_local_dispatch_statistics_lock();
+  iree_host_size_t row_capacity = 0;
+  for (iree_hal_local_dispatch_statistics_entry_t* entry =
+           iree_hal_local_dispatch_statistics_head;
+       entry != NULL; entry = entry->next) {
+    ++row_capacity;
+  }
+  iree_hal_local_dispatch_statistics_row_t* rows = NULL;
+  iree_status_t status = iree_ok_status();
+  if (row_capacity > 0) {
+    status = iree_allocator_malloc(iree_allocator_system(),
+                                   row_capacity * sizeof(*rows), (void**)&rows);
+  }
+  iree_host_size_t row_count = 0;
+  iree_time_t all_time_ns = 0;
+  bool any_sampled = false;
+  if (iree_status_is_ok(status)) {
+    for (iree_hal_local_dispatch_statistics_entry_t* entry =
+             iree_hal_local_dispatch_statistics_head;
+         entry != NULL; entry = entry->next) {
+      iree_hal_local_dispatch_statistics_row_t row = {
+          .name = entry->name,
+          .dispatch_count = iree_atomic_load_int64(&entry->dispatch_count,
+                                                   iree_memory_order_relaxed),
+          .workgroup_count = iree_atomic_load_int64(&entry->workgroup_count,
+                                                    iree_memory_order_relaxed),
+          .total_time_ns = iree_atomic_load_int64(&entry->total_time_ns,
+                                                  iree_memory_order_relaxed),
+          .binding_bytes = iree_atomic_load_int64(&entry->binding_bytes,
+                                                  iree_memory_order_relaxed),
+      };
+      if (row.dispatch_count == 0) continue;
+      row.sampled_time_ns = iree_atomic_load_int64(&entry->sampled_time_ns,
+                                                   iree_memory_order_relaxed);
+      for (int j = 0; j < IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT; ++j) {
+        row.hardware_counters[j] = iree_atomic_load_int64(
+            &entry->hardware_counters[j], iree_memory_order_relaxed);
+      }
+      if (row.sampled_time_ns > 0) any_sampled = true;
+      all_time_ns += row.total_time_ns;
+      rows[row_count++] = row;
+    }
+  }
+  iree_hal_local_dispatch_statistics_unlock();
+  if (!iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  qsort(rows, row_count, sizeof(*rows),
+        iree_hal_local_dispatch_statistics_row_compare);
+
+  const int32_t available_mask =
+      any_sampled
+          ? iree_atomic_load_int32(
+                &iree_hal_local_hardware_counters_available_mask,
+                iree_memory_order_relaxed)
+          : 0;
+  fprintf(file,
+          "[[ iree_hal_local_dispatch_statistics ]]\n"
+          "%6s %10s %12s %12s %12s %10s",
+          "%time", "calls", "total(ms)", "mean(us)", "wg/call", "GB/s");
+  if (available_mask) {
+    // Misses are reported per thousand instructions (MPKI) and the memory
+    // bandwidth is estimated from the LLC misses.
+    fprintf(file, " %10s %10s %10s %10s", "IPC", "L1D MPKI", "LLC MPKI",
+            "mem GB/s");
+  }
+  fprintf(file, "  %s\n", "executable:export");
+  for (iree_host_size_t i = 0; i < row_count; ++i) {
+    const iree_hal_local_dispatch_statistics_row_t* row = &rows[i];
+    double total_ms = row->total_time_ns / 1e6;
+    double mean_us = row->total_time_ns / 1e3 / row->dispatch_count;
+    double workgroups_per_call =
+        (double)row->workgroup_count / row->dispatch_count;
+    double gbps = row->total_time_ns > 0
+                      ? (double)row->binding_bytes / row->total_time_ns
+                      : 0.0;
+    double percent =
+        all_time_ns > 0 ? 100.0 * row->total_time_ns / all_time_ns : 0.0;
+    fprintf(file, "%6.2f %10" PRId64 " %12.3f %12.3f %12.1f %10.2f", percent,
+            row->dispatch_count, total_ms, mean_us, workgroups_per_call, gbps);
+    if (available_mask) {
+      iree_hal_local_dispatch_statistics_fprint_ratio(
+          file, row, available_mask,
+          IREE_HAL_LOCAL_HARDWARE_COUNTER_INSTRUCTIONS,
+          IREE_HAL_LOCAL_HARDWARE_COUNTER_CYCLES, 1.0);
+      iree_hal_local_dispatch_statistics_fprint_ratio(
+          file, row, available_mask,
+          IREE_HAL_LOCAL_HARDWARE_COUNTER_L1D_READ_MISSES,
+          IREE_HAL_LOCAL_HARDWARE_COUNTER_INSTRUCTIONS, 1000.0);
+      iree_hal_local_dispatch_statistics_fprint_ratio(
+          file, row, available_mask,
+          IREE_HAL_LOCAL_HARDWARE_COUNTER_LLC_MISSES,
+          IREE_HAL_LOCAL_HARDWARE_COUNTER_INSTRUCTIONS, 1000.0);
+      if (iree_all_bits_set(available_mask,
+                            1 << IREE_HAL_LOCAL_HARDWARE_COUNTER_LLC_MISSES) &&
+          row->sampled_time_ns > 0) {
+        fprintf(file, " %10.2f",
+                (double)row->hardware_counters
+                        [IREE_HAL_LOCAL_HARDWARE_COUNTER_LLC_MISSES] *
+                    IREE_HAL_LOCAL_DISPATCH_STATISTICS_CACHE_LINE_SIZE /
+                    row->sampled_time_ns);
+      } else {
+        fprintf(file, " %10s", "-");
+      }
+    }
+    fprintf(file, "  %s\n", row->name);
+  }
+
+  iree_allocator_free(iree_allocator_system(), rows);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
@@ -0,0 +1,174 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_DISPATCH_STATISTICS_H_
+#define IREE_HAL_LOCAL_DISPATCH_STATISTICS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_dispatch_statistics_*
+//===----------------------------------------------------------------------===//
+
+// Process-wide per-export dispatch statistics for local executables.
+//
+// Local devices enable capture while profiling with
+// IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS and tools print the
+// aggregated results with iree_hal_local_dispatch_statistics_fprint. This
+// gives a per-dispatch breakdown of where time goes without requiring a
+// tracing build. Executables are keyed by their library and export names so
+// compiler-assigned dispatch names (such as those from AnnotateDispatches) show
+// up in the report.
+//
+// Times are measured around each workgroup call and summed across all workers
+// so they represent the CPU time spent in the dispatch: with more than one
+// worker the wall time of a dispatch is lower than its reported time.
+//
+// When profiling with IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS the
+// hardware performance counters of each worker thread are also sampled around
+// each call. This uses perf_event_open on Linux and Android and requires that
+// the process is allowed to monitor its own threads (see
+// /proc/sys/kernel/perf_event_paranoid). Counters that cannot be opened are
+// omitted from the report and on other platforms only times are captured.
+
+// A hardware performance counter sampled per call.
+typedef enum iree_hal_local_hardware_counter_e {
+  // CPU cycles spent in the call.
+  IREE_HAL_LOCAL_HARDWARE_COUNTER_CYCLES = 0,
+  // Instructions retired.
+  IREE_HAL_LOCAL_HARDWARE_COUNTER_INSTRUCTIONS,
+  // L1 data cache read misses.
+  IREE_HAL_LOCAL_HARDWARE_COUNTER_L1D_READ_MISSES,
+  // Last-level cache misses. Each miss is assumed to transfer one cache line
+  // from memory when estimating the memory bandwidth of a dispatch.
+  IREE_HAL_LOCAL_HARDWARE_COUNTER_LLC_MISSES,
+  IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT,
+} iree_hal_local_hardware_counter_t;
+
+// Controls what is captured in addition to call times.
+enum iree_hal_local_dispatch_statistics_flag_bits_t {
+  IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE = 0u,
+  // Samples the hardware performance counters around each call.
+  IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_HARDWARE_COUNTERS = 1u << 0,
+};
+typedef uint32_t iree_hal_local_dispatch_statistics_flags_t;
+
+// Aggregated statistics of a single executable export.
+// Counters are updated atomically by workers while capture is enabled.
+typedef struct iree_hal_local_dispatch_statistics_entry_t {
+  struct iree_hal_local_dispatch_statistics_entry_t* next;
+  // Number of dispatches issued.
+  iree_atomic_int64_t dispatch_count;
+  // Number of workgroups executed across all dispatches.
+  iree_atomic_int64_t workgroup_count;
+  // Total time spent executing workgroups across all workers.
+  iree_atomic_int64_t total_time_ns;
+  // Total bytes of bindings accessible to all dispatches. This is an upper
+  // bound on the memory traffic as not all bytes of every binding are
+  // guaranteed to be touched.
+  iree_atomic_int64_t binding_bytes;
+  // Total time of the calls that had their hardware counters sampled.
+  iree_atomic_int64_t sampled_time_ns;
+  // Hardware counter deltas summed across all sampled calls.
+  iree_atomic_int64_t hardware_counters[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT];
+  // NUL-terminated `library:export` name stored in the same allocation.
+  const char* name;
+} iree_hal_local_dispatch_statistics_entry_t;
+
+// Nonzero while any device is capturing dispatch statistics.
+extern iree_atomic_int32_t iree_hal_local_dispatch_statistics_capture_count;
+
+// Nonzero while any device is sampling hardware counters.
+extern iree_atomic_int32_t iree_hal_local_dispatch_statistics_sample_count;
+
+// Returns true if dispatch statistics are being captured.
+static inline bool iree_hal_local_dispatch_statistics_is_capturing(void) {
+  return iree_atomic_load_int32(
+             &iree_hal_local_dispatch_statistics_capture_count,
+             iree_memory_order_relaxed) != 0;
+}
+
+// Returns true if hardware counters should be sampled around calls.
+static inline bool iree_hal_local_dispatch_statistics_is_sampling(void) {
+  return iree_atomic_load_int32(
+             &iree_hal_local_dispatch_statistics_sample_count,
+             iree_memory_order_relaxed) != 0;
+}
+
+// Starts capturing dispatch statistics. Counters of all entries are reset when
+// no capture was in progress. Must be balanced with a call to
+// iree_hal_local_dispatch_statistics_end with the same |flags|.
+void iree_hal_local_dispatch_statistics_begin(
+    iree_hal_local_dispatch_statistics_flags_t flags);
+
+// Stops a capture started with iree_hal_local_dispatch_statistics_begin.
+// Counters are retained so that they can be printed after capture ends.
+void iree_hal_local_dispatch_statistics_end(
+    iree_hal_local_dispatch_statistics_flags_t flags);
+
+// Reads the current hardware counter values of the calling thread into
+// |out_values|, lazily opening the counters on first use by each thread.
+// Returns false if no counters are available on the thread. Counters that are
+// unavailable while others are read as 0.
+bool iree_hal_local_hardware_counters_read(
+    uint64_t out_values[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT]);
+
+// Returns the entry for export |export_name| in |library_name|, creating it if
+// needed. Entries are retained for the lifetime of the process so that the
+// returned pointer may be cached.
+iree_status_t iree_hal_local_dispatch_statistics_lookup(
+    iree_string_view_t library_name, iree_string_view_t export_name,
+    iree_hal_local_dispatch_statistics_entry_t** out_entry);
+
+// Records |workgroup_count| workgroups of a dispatch of |entry| taking
+// |duration_ns|. |is_first_call| indicates that the call included the first
+// workgroup of the dispatch and |binding_bytes| are attributed to it.
+static inline void iree_hal_local_dispatch_statistics_record(
+    iree_hal_local_dispatch_statistics_entry_t* entry, bool is_first_call,
+    uint32_t workgroup_count, iree_time_t duration_ns, uint64_t binding_bytes) {
+  if (is_first_call) {
+    iree_atomic_fetch_add_int64(&entry->dispatch_count, 1,
+                                iree_memory_order_relaxed);
+    iree_atomic_fetch_add_int64(&entry->binding_bytes, (int64_t)binding_bytes,
+                                iree_memory_order_relaxed);
+  }
+  iree_atomic_fetch_add_int64(&entry->workgroup_count, workgroup_count,
+                              iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&entry->total_time_ns, duration_ns,
+                              iree_memory_order_relaxed);
+}
+
+// Records the hardware counter deltas of a call of |entry| taking
+// |duration_ns| that was sampled with iree_hal_local_hardware_counters_read.
+static inline void iree_hal_local_dispatch_statistics_record_counters(
+    iree_hal_local_dispatch_statistics_entry_t* entry, iree_time_t duration_ns,
+    const uint64_t deltas[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT]) {
+  iree_atomic_fetch_add_int64(&entry->sampled_time_ns, duration_ns,
+                              iree_memory_order_relaxed);
+  for (int i = 0; i < IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT; ++i) {
+    iree_atomic_fetch_add_int64(&entry->hardware_counters[i],
+                                (int64_t)deltas[i], iree_memory_order_relaxed);
+  }
+}
+
+// Prints a table of all exports dispatched since capture last started, sorted
+// by descending total time. Hardware counter columns are included if any
+// export had its counters sampled.
+iree_status_t iree_hal_local_dispatch_statistics_fprint(FILE* file);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_STATISTICS_H_
@@ -0,0 +1,129 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_statistics.h"
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+static int64_t Load(iree_atomic_int64_t* value) {
+  return iree_atomic_load_int64(value, iree_memory_order_relaxed);
+}
+
+TEST(DispatchStatisticsTest, LookupIsUniquePerName) {
+  iree_hal_local_dispatch_statistics_entry_t* a = NULL;
+  iree_hal_local_dispatch_statistics_entry_t* b = NULL;
+  iree_hal_local_dispatch_statistics_entry_t* c = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_statistics_lookup(
+      IREE_SV("lookup_lib"), IREE_SV("dispatch_0"), &a));
+  IREE_ASSERT_OK(iree_hal_local_dispatch_statistics_lookup(
+      IREE_SV("lookup_lib"), IREE_SV("dispatch_1"), &b));
+  IREE_ASSERT_OK(iree_hal_local_dispatch_statistics_lookup(
+      IREE_SV("lookup_lib"), IREE_SV("dispatch_0"), &c));
+  EXPECT_EQ(a, c);
+  EXPECT_NE(a, b);
+  EXPECT_STREQ(a->name, "lookup_lib:dispatch_0");
+  EXPECT_STREQ(b->name, "lookup_lib:dispatch_1");
+}
+
+TEST(DispatchStatisticsTest, RecordAndReset) {
+  iree_hal_local_dispatch_statistics_entry_t* entry = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_statistics_lookup(
+      IREE_SV("record_lib"), IREE_SV("dispatch_0"), &entry));
+
+  iree_hal_local_dispatch_statistics_begin(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE);
+  EXPECT_TRUE(iree_hal_local_dispatch_statistics_is_capturing());
+  iree_hal_local_dispatch_statistics_record(entry, /*is_first_call=*/true,
+                                            /*workgroup_count=*/2,
+                                            /*duration_ns=*/100,
+                                            /*binding_bytes=*/1024);
+  iree_hal_local_dispatch_statistics_record(entry, /*is_first_call=*/false,
+                                            /*workgroup_count=*/2,
+                                            /*duration_ns=*/50,
+                                            /*binding_bytes=*/1024);
+  iree_hal_local_dispatch_statistics_end(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE);
+  EXPECT_FALSE(iree_hal_local_dispatch_statistics_is_capturing());
+
+  // Counters are retained after capture ends.
+  EXPECT_EQ(Load(&entry->dispatch_count), 1);
+  EXPECT_EQ(Load(&entry->workgroup_count), 4);
+  EXPECT_EQ(Load(&entry->total_time_ns), 150);
+  EXPECT_EQ(Load(&entry->binding_bytes), 1024);
+
+  // And reset when the next capture begins.
+  iree_hal_local_dispatch_statistics_begin(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE);
+  EXPECT_EQ(Load(&entry->dispatch_count), 0);
+  EXPECT_EQ(Load(&entry->total_time_ns), 0);
+  iree_hal_local_dispatch_statistics_end(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE);
+}
+
+TEST(DispatchStatisticsTest, NestedCapture) {
+  iree_hal_local_dispatch_statistics_begin(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE);
+  iree_hal_local_dispatch_statistics_begin(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE);
+  iree_hal_local_dispatch_statistics_end(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE);
+  EXPECT_TRUE(iree_hal_local_dispatch_statistics_is_capturing());
+  iree_hal_local_dispatch_statistics_end(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_NONE);
+  EXPECT_FALSE(iree_hal_local_dispatch_statistics_is_capturing());
+}
+
+TEST(DispatchStatisticsTest, RecordHardwareCounters) {
+  iree_hal_local_dispatch_statistics_entry_t* entry = NULL;
+  IREE_ASSERT_OK(iree_hal_local_dispatch_statistics_lookup(
+      IREE_SV("counters_lib"), IREE_SV("dispatch_0"), &entry));
+
+  iree_hal_local_dispatch_statistics_begin(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_HARDWARE_COUNTERS);
+  EXPECT_TRUE(iree_hal_local_dispatch_statistics_is_sampling());
+  const uint64_t deltas[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT] = {
+      /*cycles=*/1000, /*instructions=*/2000, /*l1d_read_misses=*/10,
+      /*llc_misses=*/1};
+  iree_hal_local_dispatch_statistics_record_counters(entry, 100, deltas);
+  iree_hal_local_dispatch_statistics_record_counters(entry, 100, deltas);
+  iree_hal_local_dispatch_statistics_end(
+      IREE_HAL_LOCAL_DISPATCH_STATISTICS_FLAG_HARDWARE_COUNTERS);
+  EXPECT_FALSE(iree_hal_local_dispatch_statistics_is_sampling());
+
+  EXPECT_EQ(Load(&entry->sampled_time_ns), 200);
+  EXPECT_EQ(Load(&entry->hardware_counters
+                     [IREE_HAL_LOCAL_HARDWARE_COUNTER_CYCLES]),
+            2000);
+  EXPECT_EQ(Load(&entry->hardware_counters
+                     [IREE_HAL_LOCAL_HARDWARE_COUNTER_LLC_MISSES]),
+            2);
+}
+
+TEST(DispatchStatisticsTest, ReadHardwareCounters) {
+  // Counters may be unavailable on the host (or disallowed by the kernel) but
+  // when they are available they must be monotonic.
+  uint64_t begin[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT] = {0};
+  if (!iree_hal_local_hardware_counters_read(begin)) {
+    GTEST_SKIP() << "hardware counters unavailable";
+  }
+  volatile uint64_t sum = 0;
+  for (int i = 0; i < 100000; ++i) sum += i;
+  uint64_t end[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT] = {0};
+  ASSERT_TRUE(iree_hal_local_hardware_counters_read(end));
+  for (int i = 0; i < IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT; ++i) {
+    EXPECT_GE(end[i], begin[i]);
+  }
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -13,6 +13,12 @@
 #include "iree/hal/local/elf/fatelf.h"
 #include "iree/hal/local/elf/platform.h"
 
+// Enables mapping read-only segments directly from the source ELF data when
+// it is backed by a shareable mapping. See iree_memory_view_alias_range.
+#if !defined(IREE_ELF_MODULE_SHARE_READONLY_SEGMENTS)
+#define IREE_ELF_MODULE_SHARE_READONLY_SEGMENTS 1
+#endif  // !IREE_ELF_MODULE_SHARE_READONLY_SEGMENTS
+
 //==============================================================================
 // Verification and section/info caching
 //==============================================================================
@@ -229,6 +235,86 @@ static iree_byte_range_t iree_elf_module_calculate_vaddr_range(
   return byte_range;
 }
 
+// Returns the access protection a loaded |phdr| segment should have.
+// Interprets the access bits and widens to the implicit allowable
+// permissions. See Table 7-37:
+// https://docs.oracle.com/cd/E19683-01/816-1386/6m7qcoblk/index.html#chapter6-34713
+static iree_memory_access_t iree_elf_module_segment_access(
+    const iree_elf_phdr_t* phdr) {
+  iree_memory_access_t access = 0;
+  if (phdr->p_flags & IREE_ELF_PF_R) access |= IREE_MEMORY_ACCESS_READ;
+  if (phdr->p_flags & IREE_ELF_PF_W) access |= IREE_MEMORY_ACCESS_WRITE;
+  if (phdr->p_flags & IREE_ELF_PF_X) access |= IREE_MEMORY_ACCESS_EXECUTE;
+  if (access & IREE_MEMORY_ACCESS_WRITE) access |= IREE_MEMORY_ACCESS_READ;
+  if (access & IREE_MEMORY_ACCESS_EXECUTE) access |= IREE_MEMORY_ACCESS_READ;
+  return access;
+}
+
+// Returns true if the ELF may have relocations applied to non-writable
+// segments (DT_TEXTREL). Such segments must be copied so that they can be
+// written during relocation. This scans the dynamic table in the raw file as
+// the loaded one is not yet available.
+static bool iree_elf_module_has_text_relocations(
+    iree_const_byte_span_t raw_data, iree_elf_module_load_state_t* load_state) {
+  for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+    const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
+    if (phdr->p_type != IREE_ELF_PT_DYNAMIC) continue;
+    if (phdr->p_offset + phdr->p_filesz > raw_data.data_length) return true;
+    const iree_elf_dyn_t* dyn_table =
+        (const iree_elf_dyn_t*)(raw_data.data + phdr->p_offset);
+    iree_host_size_t dyn_table_count = phdr->p_filesz / sizeof(iree_elf_dyn_t);
+    for (iree_host_size_t j = 0; j < dyn_table_count; ++j) {
+      const iree_elf_dyn_t* dyn = &dyn_table[j];
+      if (dyn->d_tag == IREE_ELF_DT_NULL) break;
+      if (dyn->d_tag == IREE_ELF_DT_TEXTREL) return true;
+      if (dyn->d_tag == IREE_ELF_DT_FLAGS &&
+          (dyn->d_un.d_val & IREE_ELF_DF_TEXTREL)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return false;
+}
+
+// Returns true if the |phdr| segment can be mapped directly from |raw_data|
+// instead of being committed and copied. The segment must be read-only, fully
+// backed by the file, congruent with the source pages, and must not share any
+// host page with another segment that will be committed over it.
+static bool iree_elf_module_can_share_segment(
+    iree_const_byte_span_t raw_data, iree_elf_module_load_state_t* load_state,
+    iree_elf_module_t* module, const iree_elf_phdr_t* phdr) {
+  if (phdr->p_flags & IREE_ELF_PF_W) return false;
+  if (phdr->p_filesz != phdr->p_memsz || phdr->p_memsz == 0) return false;
+
+  const iree_host_size_t page_size = load_state->memory_info.normal_page_size;
+  const uintptr_t source_address = (uintptr_t)raw_data.data + phdr->p_offset;
+  const uintptr_t target_address =
+      (uintptr_t)module->vaddr_bias + phdr->p_vaddr;
+  if (((source_address - target_address) & (page_size - 1)) != 0) return false;
+  if (iree_page_align_start(source_address, page_size) <
+      (uintptr_t)raw_data.data) {
+    // The first page would include data preceding the ELF.
+    return false;
+  }
+
+  const uintptr_t page_start = iree_page_align_start(phdr->p_vaddr, page_size);
+  const uintptr_t page_end =
+      iree_page_align_end(phdr->p_vaddr + phdr->p_memsz, page_size);
+  for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
+    const iree_elf_phdr_t* other_phdr = &load_state->phdr_table[i];
+    if (other_phdr == phdr || other_phdr->p_type != IREE_ELF_PT_LOAD) continue;
+    const uintptr_t other_page_start =
+        iree_page_align_start(other_phdr->p_vaddr, page_size);
+    const uintptr_t other_page_end = iree_page_align_end(
+        other_phdr->p_vaddr + other_phdr->p_memsz, page_size);
+    if (other_page_start < page_end && page_start < other_page_end) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Allocates space for and loads all DT_LOAD segments into the host virtual
 // address space.
 static iree_status_t iree_elf_module_load_segments(
@@ -247,29 +333,45 @@ static iree_status_t iree_elf_module_load_segments(
       module->host_allocator, (void**)&module->vaddr_base));
   module->vaddr_bias = module->vaddr_base - vaddr_range.offset;
 
+  // Read-only segments can only be shared with the source if relocation will
+  // not need to modify them.
+  const bool may_share_segments =
+      IREE_ELF_MODULE_SHARE_READONLY_SEGMENTS &&
+      !iree_elf_module_has_text_relocations(raw_data, load_state);
+
   // Commit and load all of the segments.
   for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
     const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
     if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
-
-    // Commit the range of pages used by this segment, initially with write
-    // access so that we can modify the pages.
     iree_byte_range_t byte_range = {
         .offset = phdr->p_vaddr,
         .length = phdr->p_memsz,
     };
+
+    // If the source is a shareable mapping (such as a mapped file) we can
+    // directly reference its pages for read-only segments and avoid both the
+    // copy and the private memory. Failure is not fatal: the source may be a
+    // private mapping or heap memory and we fall back to copying.
+    if (may_share_segments &&
+        iree_elf_module_can_share_segment(raw_data, load_state, module,
+                                          phdr)) {
+      iree_status_t share_status = iree_memory_view_alias_range(
+          module->vaddr_bias, byte_range, raw_data.data + phdr->p_offset,
+          iree_elf_module_segment_access(phdr));
+      if (iree_status_is_ok(share_status)) {
+        module->vaddr_shared_size += phdr->p_memsz;
+        continue;
+      }
+      iree_status_ignore(share_status);
+    }
+
+    // Commit the range of pages used by this segment, initially with write
+    // access so that we can modify the pages.
     IREE_RETURN_IF_ERROR(iree_memory_view_commit_ranges(
         module->vaddr_bias, 1, &byte_range,
         IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
 
     // Copy data present in the file.
-    // TODO(benvanik): infra for being able to detect if the source model is in
-    // a mapped file - if it is, we can remap the page and directly reference it
-    // here for read-only segments and setup copy-on-write for writeable ones.
-    // We'd need a way to pass in the underlying mapping and some guarantees on
-    // the lifetime of it. Today we are just always committing above and copying
-    // here because it keeps this all super simple (you know, as simple as an
-    // entire custom ELF loader can be :).
     if (phdr->p_filesz > 0) {
       memcpy(module->vaddr_bias + phdr->p_vaddr, raw_data.data + phdr->p_offset,
              phdr->p_filesz);
@@ -298,15 +400,7 @@ static iree_status_t iree_elf_module_protect_segments(
     const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
     if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
 
-    // Interpret the access bits and widen to the implicit allowable
-    // permissions. See Table 7-37:
-    // https://docs.oracle.com/cd/E19683-01/816-1386/6m7qcoblk/index.html#chapter6-34713
-    iree_memory_access_t access = 0;
-    if (phdr->p_flags & IREE_ELF_PF_R) access |= IREE_MEMORY_ACCESS_READ;
-    if (phdr->p_flags & IREE_ELF_PF_W) access |= IREE_MEMORY_ACCESS_WRITE;
-    if (phdr->p_flags & IREE_ELF_PF_X) access |= IREE_MEMORY_ACCESS_EXECUTE;
-    if (access & IREE_MEMORY_ACCESS_WRITE) access |= IREE_MEMORY_ACCESS_READ;
-    if (access & IREE_MEMORY_ACCESS_EXECUTE) access |= IREE_MEMORY_ACCESS_READ;
+    iree_memory_access_t access = iree_elf_module_segment_access(phdr);
 
     // We only support R+X (no W).
     if ((phdr->p_flags & IREE_ELF_PF_X) && (phdr->p_flags & IREE_ELF_PF_W)) {
@@ -314,7 +408,8 @@ static iree_status_t iree_elf_module_protect_segments(
                               "unable to create a writable executable segment");
     }
 
-    // Apply new access protection.
+    // Apply new access protection. Shared segments already have their final
+    // protection but reapplying it is harmless.
     iree_byte_range_t byte_range = {
         .offset = phdr->p_vaddr,
         .length = phdr->p_memsz,
@@ -356,6 +451,7 @@ static void iree_elf_module_unload_segments(iree_elf_module_t* module) {
   module->vaddr_base = NULL;
   module->vaddr_bias = NULL;
   module->vaddr_size = 0;
+  module->vaddr_shared_size = 0;
 }
 
 //==============================================================================
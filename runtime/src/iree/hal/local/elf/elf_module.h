@@ -49,6 +49,10 @@ typedef struct iree_elf_module_t {
   // host page granularity was larger than the ELF's defined granularity.
   uint8_t* vaddr_bias;
 
+  // Total size, in bytes, of read-only segments mapped directly from the
+  // source data and sharing its pages instead of being copied.
+  iree_host_size_t vaddr_shared_size;
+
   // Dynamic symbol string table (.dynstr).
   const char* dynstr;            // DT_STRTAB
   iree_host_size_t dynstr_size;  // DT_STRSZ (bytes)
@@ -62,6 +66,13 @@ typedef struct iree_elf_module_t {
 // |raw_data| only needs to remain valid for the initialization of the module
 // and may be discarded afterward.
 //
+// If |raw_data| is backed by a shareable mapping (such as a file mapped with
+// MAP_SHARED) and the ELF is page-aligned within it then read-only and
+// executable segments that are not relocated are mapped directly from it
+// instead of being copied. This allows multiple processes loading the same
+// file to share the code pages through the page cache. Writable segments are
+// always copied and relocated privately.
+//
 // An optional |import_table| may be specified to provide a set of symbols that
 // the module may import. Strong imports will not be resolved from the host
 // system and initialization will fail if any are not present in the provided
@@ -13,6 +13,11 @@
 // ELF modules for various platforms embedded in the binary:
 #include "iree/hal/local/elf/testdata/elementwise_mul.h"
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <errno.h>
+#include <sys/mman.h>
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
 static iree_status_t query_arch_test_file_data(
     iree_const_byte_span_t* out_file_data) {
   *out_file_data = iree_make_const_byte_span(NULL, 0);
@@ -51,10 +56,8 @@ static iree_status_t query_arch_test_file_data(
                           "the application for the current target platform");
 }
 
-static iree_status_t run_test() {
-  iree_const_byte_span_t file_data;
-  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
-
+static iree_status_t run_test(iree_const_byte_span_t file_data,
+                              bool expect_shared) {
   iree_elf_import_table_t import_table;
   memset(&import_table, 0, sizeof(import_table));
   iree_elf_module_t module;
@@ -69,6 +72,12 @@ static iree_status_t run_test() {
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
       &module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
 
+  if (expect_shared && module.vaddr_shared_size == 0) {
+    iree_elf_module_deinitialize(&module);
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "no segments were shared with the source data");
+  }
+
   union {
     const iree_hal_executable_library_header_t** header;
     const iree_hal_executable_library_v0_t* v0;
@@ -155,8 +164,39 @@ static iree_status_t run_test() {
   return status;
 }
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+// Runs the test with the ELF placed at the start of a shared mapping such that
+// read-only segments are mapped directly from it instead of being copied.
+static iree_status_t run_shared_test(iree_const_byte_span_t file_data) {
+  void* mapping = mmap(NULL, file_data.data_length, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "unable to allocate shared mapping");
+  }
+  memcpy(mapping, file_data.data, file_data.data_length);
+  iree_status_t status = run_test(
+      iree_make_const_byte_span(mapping, file_data.data_length),
+      /*expect_shared=*/true);
+  munmap(mapping, file_data.data_length);
+  return status;
+}
+
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+
+static iree_status_t run_all_tests() {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+  IREE_RETURN_IF_ERROR(run_test(file_data, /*expect_shared=*/false));
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+  IREE_RETURN_IF_ERROR(run_shared_test(file_data));
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
+  return iree_ok_status();
+}
+
 int main() {
-  const iree_status_t result = run_test();
+  const iree_status_t result = run_all_tests();
   int ret = (int)iree_status_code(result);
   if (!iree_status_is_ok(result)) {
     iree_status_fprint(stderr, result);
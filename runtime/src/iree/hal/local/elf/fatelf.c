@@ -6,7 +6,29 @@
 
 #include "iree/hal/local/elf/fatelf.h"
 
+#include "iree/base/internal/cpu.h"
+#include "iree/base/internal/math.h"
 #include "iree/hal/local/elf/arch.h"
+#include "iree/schemas/cpu_data.h"
+
+static_assert(IREE_FATELF_CPU_DATA_FIELD_COUNT == IREE_CPU_DATA_FIELD_COUNT,
+              "FatELF CPU feature table must match the CPU data schema");
+
+// Returns true if all CPU data bits in |raw_features| are present on the host
+// and otherwise false. |out_feature_count| receives the total number of
+// required bits used to rank candidates.
+static bool iree_fatelf_cpu_features_match(
+    const iree_fatelf_cpu_features_t* raw_features,
+    iree_host_size_t* out_feature_count) {
+  *out_feature_count = 0;
+  const uint64_t* host_fields = iree_cpu_data_fields();
+  for (iree_host_size_t i = 0; i < IREE_FATELF_CPU_DATA_FIELD_COUNT; ++i) {
+    uint64_t required = iree_unaligned_load_le_u64(&raw_features->cpu_data[i]);
+    if (!iree_all_bits_set(host_fields[i], required)) return false;
+    *out_feature_count += iree_math_count_ones_u64(required);
+  }
+  return true;
+}
 
 iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                                  iree_const_byte_span_t* out_elf_data) {
@@ -46,10 +68,19 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
         host_header.version, IREE_FATELF_FORMAT_VERSION);
   }
 
-  // Ensure there's enough space for all the declared records.
+  // Ensure there's enough space for all the declared records and their
+  // optional CPU feature requirements.
+  const bool has_cpu_features = iree_all_bits_set(
+      host_header.reserved, IREE_FATELF_HEADER_FLAG_CPU_FEATURES);
   iree_host_size_t required_bytes =
       sizeof(iree_fatelf_header_t) +
       host_header.record_count * sizeof(iree_fatelf_record_t);
+  const iree_fatelf_cpu_features_t* raw_cpu_features =
+      (const iree_fatelf_cpu_features_t*)(file_data.data + required_bytes);
+  if (has_cpu_features) {
+    required_bytes +=
+        host_header.record_count * sizeof(iree_fatelf_cpu_features_t);
+  }
   if (file_data.data_length < required_bytes) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "FatELF file truncated, requires at least %" PRIhsz
@@ -58,9 +89,11 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                             required_bytes, file_data.data_length);
   }
 
-  // Scan record table to find one that matches.
+  // Scan record table to find the best one that matches. Without CPU feature
+  // requirements this is the first compatible record.
   iree_elf64_off_t selected_offset = 0;
   iree_elf64_xword_t selected_size = 0;
+  iree_host_size_t selected_feature_count = 0;
   for (iree_elf64_byte_t i = 0; i < host_header.record_count; ++i) {
     const iree_fatelf_record_t* raw_record = &raw_header->records[i];
     const iree_fatelf_record_t host_record = {
@@ -91,14 +124,26 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
 #else
     if (host_record.byte_order != IREE_FATELF_BYTE_ORDER_MSB) continue;
 #endif  // IREE_ENDIANNESS_LITTLE
-    selected_offset = host_record.offset;
-    selected_size = host_record.size;
-    break;
+    if (!has_cpu_features) {
+      selected_offset = host_record.offset;
+      selected_size = host_record.size;
+      break;
+    }
+    iree_host_size_t feature_count = 0;
+    if (!iree_fatelf_cpu_features_match(&raw_cpu_features[i],
+                                        &feature_count)) {
+      continue;  // requires features the host does not have
+    }
+    if (!selected_size || feature_count > selected_feature_count) {
+      selected_offset = host_record.offset;
+      selected_size = host_record.size;
+      selected_feature_count = feature_count;
+    }
   }
   if (!selected_offset || !selected_size) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "no ELFs matching the runtime architecture or "
-                            "Linux ABI found in the FatELF");
+                            "no ELFs matching the runtime architecture, "
+                            "Linux ABI, or CPU features found in the FatELF");
   }
 
   // Bounds check the file range - the caller expects valid pointers.
@@ -39,11 +39,25 @@
 #define IREE_FATELF_MAGIC 0x1F0E70FA  // FA700E1F 'fat' 'elf' lol
 
 // Only version 1 is defined. We may end up with our own versions if we diverge.
-// FatELF doesn't have any architectural feature requirement bits which makes it
-// difficult to support specialized ELFs based on things like instruction set
-// support and we may want to add that.
+// FatELF doesn't have any architectural feature requirement bits so we carry
+// them in an extension table (see IREE_FATELF_HEADER_FLAG_CPU_FEATURES) that
+// keeps the file readable by the original tools.
 #define IREE_FATELF_FORMAT_VERSION 1
 
+// IREE extension: set in iree_fatelf_header_t::reserved when a table of
+// iree_fatelf_cpu_features_t immediately follows the record table with one
+// entry per record. Each entry lists the CPU data bits (see
+// iree/schemas/cpu_data.h for the record machine) that must be present on the
+// host for the ELF to be selected. This allows a single FatELF to carry
+// microarchitecture-specific variants (such as x86-64 with AVX2, AVX-512, or
+// AMX) with the best match picked once at load time. Original FatELF tools
+// ignore the reserved byte and locate ELFs by offset so are unaffected.
+#define IREE_FATELF_HEADER_FLAG_CPU_FEATURES 0x01u
+
+// Number of CPU data fields in each iree_fatelf_cpu_features_t.
+// Matches IREE_CPU_DATA_FIELD_COUNT.
+#define IREE_FATELF_CPU_DATA_FIELD_COUNT 8
+
 enum {
   IREE_FATELF_WORD_SIZE_32 = 1,  // IREE_ELF_ELFCLASS32
   IREE_FATELF_WORD_SIZE_64 = 2,  // IREE_ELF_ELFCLASS64
@@ -80,8 +94,18 @@ typedef struct {
 } iree_fatelf_header_t;
 static_assert(sizeof(iree_fatelf_header_t) == 8, "must be packed");
 
+// CPU feature requirements of the record at the same index in the record table.
+// Records with no requirements have all fields zeroed and act as the baseline.
+typedef struct {
+  iree_elf64_xword_t cpu_data[IREE_FATELF_CPU_DATA_FIELD_COUNT];
+} iree_fatelf_cpu_features_t;
+static_assert(sizeof(iree_fatelf_cpu_features_t) == 64, "must be packed");
+
 // Scans |file_data| for a FatELF header and if present selects the matching ELF
-// for the current system if available.
+// for the current system if available. When the FatELF carries CPU feature
+// requirements the ELF with the most required features that are all supported
+// by the host (as reported by iree_cpu_data_fields) is selected and ties go to
+// the first record.
 // Upon return |out_elf_data| will either be the entire file if no FatELF header
 // was found or just the bytes of the selected ELF.
 iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
@@ -89,4 +89,22 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
                                               const iree_byte_range_t* ranges,
                                               iree_memory_access_t new_access);
 
+// Maps the pages backing |source_address| into the view byte range |range|
+// such that both share the same physical pages (and any page cache backing
+// them) instead of holding a private copy. |source_address| corresponds to the
+// start of |range| and must have the same offset within a page. The pages are
+// mapped with |access| and must never be written through the view.
+//
+// Returns IREE_STATUS_UNAVAILABLE if the platform does not support aliasing or
+// the source memory is not backed by a shareable mapping (such as a file mapped
+// with MAP_SHARED). Callers should fall back to committing the range with
+// iree_memory_view_commit_ranges and copying the contents. The range may have
+// been replaced on failure and must be recommitted before use.
+//
+// Implemented by mremap on Linux.
+iree_status_t iree_memory_view_alias_range(void* base_address,
+                                           iree_byte_range_t range,
+                                           const void* source_address,
+                                           iree_memory_access_t access);
+
 #endif  // IREE_HAL_LOCAL_ELF_PLATFORM_H_
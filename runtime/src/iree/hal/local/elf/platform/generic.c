@@ -49,4 +49,13 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return iree_ok_status();
 }
 
+iree_status_t iree_memory_view_alias_range(void* base_address,
+                                           iree_byte_range_t range,
+                                           const void* source_address,
+                                           iree_memory_access_t access) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "memory view aliasing not supported on this "
+                          "platform");
+}
+
 #endif  // IREE_PLATFORM_GENERIC
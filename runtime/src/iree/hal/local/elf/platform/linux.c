@@ -4,11 +4,15 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+// Needed for mremap and MREMAP_* on Linux.
+#define _GNU_SOURCE
+
 #include "iree/hal/local/elf/platform.h"
 
 #if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
 
 #include <errno.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
@@ -109,4 +113,55 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+iree_status_t iree_memory_view_alias_range(void* base_address,
+                                           iree_byte_range_t range,
+                                           const void* source_address,
+                                           iree_memory_access_t access) {
+#if defined(MREMAP_FIXED)
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_host_size_t page_size = getpagesize();
+  void* range_start = NULL;
+  iree_host_size_t aligned_length = 0;
+  iree_page_align_range(base_address, range, page_size, &range_start,
+                        &aligned_length);
+  const uintptr_t page_offset =
+      ((uintptr_t)base_address + range.offset) - (uintptr_t)range_start;
+  if ((((uintptr_t)source_address - page_offset) & (page_size - 1)) != 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "source and view ranges are not page congruent");
+  }
+  const void* source_start = (const uint8_t*)source_address - page_offset;
+
+  // An old_size of 0 creates a new mapping of the same pages as the source
+  // mapping at the fixed target address replacing the reserved range. This is
+  // only supported for shared mappings: Linux 4.14+ reports EINVAL for private
+  // ones while older kernels create an unrelated private mapping that we
+  // detect by comparing the contents.
+  iree_status_t status = iree_ok_status();
+  void* result = mremap((void*)source_start, 0, aligned_length,
+                        MREMAP_MAYMOVE | MREMAP_FIXED, range_start);
+  if (result == MAP_FAILED) {
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "source memory is not a shareable mapping (%d)",
+                              errno);
+  } else if (memcmp(range_start, source_start, aligned_length) != 0) {
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "aliased mapping does not match the source");
+  } else if (mprotect(range_start, aligned_length,
+                      iree_memory_access_to_prot(access)) != 0) {
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "aliased mapping protection failed (%d)", errno);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+#else
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "memory view aliasing not supported on this "
+                          "platform");
+#endif  // MREMAP_FIXED
+}
+
 #endif  // IREE_PLATFORM_*
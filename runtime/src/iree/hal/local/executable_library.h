@@ -88,11 +88,16 @@ typedef struct iree_hal_executable_environment_v0_t
 typedef uint32_t iree_hal_executable_library_version_t;
 
 #define IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4 0x00000004u
+// Adds iree_hal_executable_library_v0_t::export_variants.
+#define IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_5 0x00000005u
+// Adds IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE and
+// iree_hal_executable_workgroup_state_v0_t::workgroup_range_x.
+#define IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_6 0x00000006u
 
 // The latest version of the library API; can be used to populate the
 // iree_hal_executable_library_header_t::version when building libraries.
 #define IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST \
-  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_6
 
 // A header present at the top of all versions of the library API used by the
 // runtime to ensure version compatibility.
@@ -326,8 +331,12 @@ typedef struct iree_hal_executable_workgroup_state_v0_t {
   uint32_t workgroup_id_y;
   uint16_t workgroup_id_z;
 
-  // Reserved for future use.
-  uint16_t reserved;
+  // Number of consecutive workgroups along X starting at |workgroup_id_x| that
+  // the call must process. Only dispatch functions declaring
+  // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE process ranges; all
+  // others are called once per workgroup and see a value of 1. Ranges never
+  // span multiple rows of the workgroup grid.
+  uint16_t workgroup_range_x;
 
   // Logical processor identifier used to index into processor info fields.
   // Depending on the implementation this may be an ordinal, a bitfield, or an
@@ -374,6 +383,17 @@ typedef int (*iree_hal_executable_dispatch_v0_t)(
 // This is chosen to match the common page size of devices.
 #define IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE 4096
 
+enum iree_hal_executable_dispatch_flag_bits_v0_e {
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_NONE = 0u,
+  // The dispatch function processes the range of workgroups
+  // [workgroup_id_x, workgroup_id_x + workgroup_range_x) in a single call.
+  // This amortizes call overhead and per-call state setup across workgroups
+  // and is useful for dispatches with many small workgroups. Runtimes may
+  // still pass ranges of a single workgroup.
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE = 1u << 0,
+};
+typedef uint16_t iree_hal_executable_dispatch_flags_v0_t;
+
 // Attributes for exported dispatch functions defining how they are to be
 // executed. 0 defaults are well-specified and the entire attributes table may
 // be omitted if no dispatch functions require these fields.
@@ -382,9 +402,10 @@ typedef struct iree_hal_executable_dispatch_attrs_v0_t {
   // indicating how much workgroup local memory is required for the dispatch.
   // This is the size of the buffer referenced by the `local_memory` argument.
   uint16_t local_memory_pages;
-  // Must be 0. May be used in the future for flags controlling the dispatch
-  // behavior/synchronization requirements.
-  uint16_t reserved;
+  // IREE_HAL_EXECUTABLE_DISPATCH_FLAG_* bits controlling how the dispatch
+  // function is called. Must be 0 in libraries older than
+  // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_6.
+  iree_hal_executable_dispatch_flags_v0_t flags;
 } iree_hal_executable_dispatch_attrs_v0_t;
 static_assert(sizeof(iree_hal_executable_dispatch_attrs_v0_t) == 4, "uint32_t");
 
@@ -448,6 +469,68 @@ typedef struct iree_hal_executable_export_table_v0_t {
   const iree_hal_executable_stage_location_table_v0_t* stage_locations;
 } iree_hal_executable_export_table_v0_t;
 
+// Identifies the dispatch parameter a variant condition is evaluated on.
+enum iree_hal_executable_variant_operand_e {
+  // Workgroup count along the X/Y/Z dimension of the dispatch.
+  IREE_HAL_EXECUTABLE_VARIANT_OPERAND_WORKGROUP_COUNT_X = 0u,
+  IREE_HAL_EXECUTABLE_VARIANT_OPERAND_WORKGROUP_COUNT_Y = 1u,
+  IREE_HAL_EXECUTABLE_VARIANT_OPERAND_WORKGROUP_COUNT_Z = 2u,
+  // Push constant with the ordinal specified by the condition |index|.
+  // Conditions referencing push constants beyond those provided fail.
+  IREE_HAL_EXECUTABLE_VARIANT_OPERAND_PUSH_CONSTANT = 3u,
+};
+typedef uint8_t iree_hal_executable_variant_operand_t;
+
+// Unsigned 32-bit comparison applied to the operand and condition value.
+enum iree_hal_executable_variant_predicate_e {
+  IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_EQ = 0u,  // operand == value
+  IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_NE = 1u,  // operand != value
+  IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_LT = 2u,  // operand < value
+  IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_LE = 3u,  // operand <= value
+  IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_GT = 4u,  // operand > value
+  IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_GE = 5u,  // operand >= value
+  // operand % value == 0 (fails if value is 0)
+  IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_MULTIPLE_OF = 6u,
+};
+typedef uint8_t iree_hal_executable_variant_predicate_t;
+
+// A single condition that must hold on the dispatch parameters for a variant
+// to be selected.
+typedef struct iree_hal_executable_variant_condition_v0_t {
+  // IREE_HAL_EXECUTABLE_VARIANT_OPERAND_* identifying the tested parameter.
+  iree_hal_executable_variant_operand_t operand;
+  // IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_* comparison with |value|.
+  iree_hal_executable_variant_predicate_t predicate;
+  // Push constant ordinal when |operand| is a push constant; otherwise 0.
+  uint16_t index;
+  // Value compared against the operand.
+  uint32_t value;
+} iree_hal_executable_variant_condition_v0_t;
+static_assert(sizeof(iree_hal_executable_variant_condition_v0_t) == 8,
+              "uint64_t");
+
+// A specialized implementation of an exported function (such as one fully
+// unrolled for a particular shape) that can be used in place of the generic
+// export when all of its conditions hold. Variants must declare the same
+// bindings, push constants, and attributes as the export they specialize.
+typedef struct iree_hal_executable_export_variant_v0_t {
+  // Specialized function pointer with the same signature as the export.
+  iree_hal_executable_dispatch_v0_t ptr;
+  // Total number of conditions in |conditions|; all must hold.
+  uint32_t condition_count;
+  // Conditions evaluated on the dispatch parameters.
+  const iree_hal_executable_variant_condition_v0_t* conditions;
+} iree_hal_executable_export_variant_v0_t;
+
+// Specialized variants of a single export evaluated in order with the first
+// matching variant used. The generic export function is used if none match.
+typedef struct iree_hal_executable_export_variant_list_v0_t {
+  // Total number of variants in |variants|.
+  uint32_t count;
+  // Variants in priority order.
+  const iree_hal_executable_export_variant_v0_t* variants;
+} iree_hal_executable_export_variant_list_v0_t;
+
 // A table declaring the executable-level constants that can be used to
 // specialize the executable behavior.
 typedef struct iree_hal_executable_constant_table_v0_t {
@@ -503,6 +586,12 @@ typedef struct iree_hal_executable_library_v0_t {
   // Table of optional sources used for debugging.
   // Exports may reference locations within the sources by path.
   iree_hal_executable_source_file_table_v0_t sources;
+
+  // Optional table of specialized variants 1:1 with the exports table.
+  // Omitting the table means that all dispatches use the generic exports.
+  // Only present in libraries declaring IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_5
+  // or newer and must not be accessed on older libraries.
+  const iree_hal_executable_export_variant_list_v0_t* export_variants;
 } iree_hal_executable_library_v0_t;
 
 #endif  // IREE_HAL_LOCAL_EXECUTABLE_LIBRARY_H_
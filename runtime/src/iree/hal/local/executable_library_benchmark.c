@@ -10,8 +10,11 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/executable_loader.h"
@@ -46,8 +49,29 @@ IREE_FLAG(int32_t, workgroup_size_y, 1,
 IREE_FLAG(int32_t, workgroup_size_z, 1,
           "Z dimension of the workgroup size passed to the executable.");
 
-IREE_FLAG(int32_t, max_concurrency, 1,
-          "Maximum available concurrency exposed to the dispatch.");
+IREE_FLAG(int32_t, max_concurrency, 0,
+          "Maximum available concurrency exposed to the dispatch.\n"
+          "Defaults to --thread_count (or 1 when running inline).");
+
+IREE_FLAG(int32_t, thread_count, 0,
+          "Number of worker threads the workgroups of each dispatch are\n"
+          "distributed across. When 0 all workgroups run serially on the\n"
+          "benchmark thread.");
+IREE_FLAG(int32_t, tiles_per_reservation, 1,
+          "Number of consecutive workgroups each worker claims at a time.");
+IREE_FLAG(string, thread_affinity, "any",
+          "Logical processor ID the first worker thread is pinned to with\n"
+          "each subsequent worker pinned to the next processor (optionally\n"
+          "suffixed with `+smt` to reserve SMT siblings and skip over them)\n"
+          "or `any` to let the system place and migrate workers.");
+IREE_FLAG(string, thread_priority, "normal",
+          "Priority class of worker threads from [`lowest`, `low`,\n"
+          "`normal`, `high`, `highest`].");
+IREE_FLAG(int64_t, flush_cache_bytes, 0,
+          "When non-zero each thread running workgroups writes to a buffer\n"
+          "of this many bytes between iterations (excluded from timing) to\n"
+          "evict the bindings from its caches. Should be larger than the\n"
+          "last-level cache shared by the threads.");
 
 // Total number of bindings we (currently) allow any executable to have.
 #define IREE_HAL_LOCAL_MAX_TOTAL_BINDING_COUNT \
@@ -130,6 +154,363 @@ IREE_FLAG_CALLBACK(
     "  # 2 4-byte floating-point values with contents [[1.4], [2.1]]:\n"
     "  --binding=2x1xf32=1.4,2.1");
 
+//===----------------------------------------------------------------------===//
+// Multithreaded workgroup execution
+//===----------------------------------------------------------------------===//
+
+// Dirties each cache line of |buffer| to evict whatever was previously cached.
+// The contents are never read back by anything and just accumulate garbage.
+static void benchmark_flush_cache(iree_byte_span_t buffer) {
+  volatile uint8_t* data = (volatile uint8_t*)buffer.data;
+  for (iree_host_size_t i = 0; i < buffer.data_length; i += 64) {
+    data[i] = (uint8_t)(data[i] + 1);
+  }
+}
+
+// Command broadcast to all workers at the start of each phase.
+typedef enum benchmark_worker_command_e {
+  // Run the workgroups of the pool dispatch until none remain.
+  BENCHMARK_WORKER_COMMAND_DISPATCH = 0,
+  // Flush caches with the worker flush buffer.
+  BENCHMARK_WORKER_COMMAND_FLUSH,
+  // Exit the worker thread.
+  BENCHMARK_WORKER_COMMAND_EXIT,
+} benchmark_worker_command_t;
+
+typedef struct benchmark_pool_t benchmark_pool_t;
+
+typedef struct benchmark_worker_t {
+  benchmark_pool_t* pool;
+  iree_thread_t* thread;
+  // Processor ID passed to the executable: the pinned processor, if any, and
+  // otherwise the worker index.
+  uint32_t processor_id;
+  // Last phase epoch the worker has observed.
+  int32_t epoch;
+  // Workgroup-local memory and the cache flush buffer, if enabled.
+  iree_byte_span_t local_memory;
+  iree_byte_span_t flush_buffer;
+  // First failure of the current phase; only touched by the worker while the
+  // phase is pending.
+  iree_status_t status;
+  // Totals across all dispatch phases.
+  int64_t workgroup_count;
+  iree_duration_t busy_duration_ns;
+} benchmark_worker_t;
+
+// A fixed set of worker threads that cooperatively execute the workgroups of
+// a dispatch by claiming reservations of linearized workgroup indices, the
+// same way the task system distributes dispatch tiles across its workers.
+struct benchmark_pool_t {
+  iree_allocator_t host_allocator;
+
+  iree_hal_local_executable_t* executable;
+  iree_host_size_t ordinal;
+  uint32_t variant;
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state;
+  uint32_t max_range_x;
+  uint32_t tile_count;
+  uint32_t tiles_per_reservation;
+
+  // Incremented (after |command| is set) to start a new phase.
+  iree_atomic_int32_t epoch;
+  iree_atomic_int32_t command;
+  iree_notification_t phase_notification;
+
+  // Next linearized workgroup index to be claimed by a worker.
+  iree_atomic_int32_t tile_index;
+
+  // Workers still running the current phase. The last to finish posts the
+  // idle notification.
+  iree_atomic_int32_t pending_worker_count;
+  iree_notification_t idle_notification;
+
+  iree_host_size_t worker_count;
+  benchmark_worker_t workers[];
+};
+
+static void benchmark_worker_dispatch(benchmark_worker_t* worker) {
+  benchmark_pool_t* pool = worker->pool;
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state =
+      pool->dispatch_state;
+  const uint32_t workgroup_count_x = dispatch_state->workgroup_count_x;
+  const uint32_t workgroup_count_y = dispatch_state->workgroup_count_y;
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+      .workgroup_id_x = 0,
+      .workgroup_id_y = 0,
+      .workgroup_id_z = 0,
+      .workgroup_range_x = 1,
+      .processor_id = worker->processor_id,
+      .local_memory = worker->local_memory.data,
+      .local_memory_size = (size_t)worker->local_memory.data_length,
+  };
+  const uint32_t worker_id = (uint32_t)(worker - pool->workers);
+  iree_time_t start_ns = iree_time_now();
+  int64_t workgroup_count = 0;
+  uint32_t tile_base = 0;
+  while ((tile_base = (uint32_t)iree_atomic_fetch_add_int32(
+              &pool->tile_index, (int32_t)pool->tiles_per_reservation,
+              iree_memory_order_relaxed)) < pool->tile_count) {
+    const uint32_t tile_end =
+        iree_min(tile_base + pool->tiles_per_reservation, pool->tile_count);
+    for (uint32_t tile_index = tile_base; tile_index < tile_end;
+         tile_index += workgroup_state.workgroup_range_x) {
+      uint32_t tile_i = tile_index;
+      workgroup_state.workgroup_id_x = tile_i % workgroup_count_x;
+      tile_i /= workgroup_count_x;
+      workgroup_state.workgroup_id_y = tile_i % workgroup_count_y;
+      tile_i /= workgroup_count_y;
+      workgroup_state.workgroup_id_z = (uint16_t)tile_i;
+      // Ranges cover the rest of the reservation up to the end of the row.
+      workgroup_state.workgroup_range_x = (uint16_t)iree_min(
+          iree_min(tile_end - tile_index,
+                   workgroup_count_x - workgroup_state.workgroup_id_x),
+          pool->max_range_x);
+      iree_status_t status = iree_hal_local_executable_issue_call(
+          pool->executable, pool->ordinal, pool->variant, dispatch_state,
+          &workgroup_state, worker_id);
+      if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+        // Drain the remaining workgroups so all workers stop early.
+        iree_atomic_store_int32(&pool->tile_index, (int32_t)pool->tile_count,
+                                iree_memory_order_relaxed);
+        worker->status = status;
+        break;
+      }
+      workgroup_count += workgroup_state.workgroup_range_x;
+    }
+    if (!iree_status_is_ok(worker->status)) break;
+  }
+  worker->workgroup_count += workgroup_count;
+  worker->busy_duration_ns += iree_time_now() - start_ns;
+}
+
+static bool benchmark_worker_has_new_phase(void* arg) {
+  benchmark_worker_t* worker = (benchmark_worker_t*)arg;
+  return iree_atomic_load_int32(&worker->pool->epoch,
+                                iree_memory_order_acquire) != worker->epoch;
+}
+
+static int benchmark_worker_main(void* arg) {
+  benchmark_worker_t* worker = (benchmark_worker_t*)arg;
+  benchmark_pool_t* pool = worker->pool;
+  for (;;) {
+    iree_notification_await(&pool->phase_notification,
+                            benchmark_worker_has_new_phase, worker,
+                            iree_infinite_timeout());
+    worker->epoch =
+        iree_atomic_load_int32(&pool->epoch, iree_memory_order_acquire);
+    const benchmark_worker_command_t command =
+        (benchmark_worker_command_t)iree_atomic_load_int32(
+            &pool->command, iree_memory_order_relaxed);
+    switch (command) {
+      case BENCHMARK_WORKER_COMMAND_DISPATCH:
+        benchmark_worker_dispatch(worker);
+        break;
+      case BENCHMARK_WORKER_COMMAND_FLUSH:
+        benchmark_flush_cache(worker->flush_buffer);
+        break;
+      default:
+      case BENCHMARK_WORKER_COMMAND_EXIT:
+        return 0;
+    }
+    if (iree_atomic_fetch_sub_int32(&pool->pending_worker_count, 1,
+                                    iree_memory_order_acq_rel) == 1) {
+      iree_notification_post(&pool->idle_notification, IREE_ALL_WAITERS);
+    }
+  }
+  return 0;
+}
+
+static bool benchmark_pool_is_idle(void* arg) {
+  benchmark_pool_t* pool = (benchmark_pool_t*)arg;
+  return iree_atomic_load_int32(&pool->pending_worker_count,
+                                iree_memory_order_acquire) == 0;
+}
+
+// Starts a phase running |command| on all workers. Unless the command is EXIT
+// the caller must wait for it to complete with benchmark_pool_join.
+static void benchmark_pool_begin(benchmark_pool_t* pool,
+                                 benchmark_worker_command_t command) {
+  iree_atomic_store_int32(&pool->tile_index, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&pool->pending_worker_count,
+                          (int32_t)pool->worker_count,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int32(&pool->command, (int32_t)command,
+                          iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int32(&pool->epoch, 1, iree_memory_order_release);
+  iree_notification_post(&pool->phase_notification, IREE_ALL_WAITERS);
+}
+
+// Waits for all workers to complete the current phase and returns the failure
+// of the first worker that failed, if any.
+static iree_status_t benchmark_pool_join(benchmark_pool_t* pool) {
+  iree_notification_await(&pool->idle_notification, benchmark_pool_is_idle,
+                          pool, iree_infinite_timeout());
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < pool->worker_count; ++i) {
+    benchmark_worker_t* worker = &pool->workers[i];
+    if (iree_status_is_ok(status)) {
+      status = worker->status;
+    } else {
+      iree_status_ignore(worker->status);
+    }
+    worker->status = iree_ok_status();
+  }
+  return status;
+}
+
+static void benchmark_pool_destroy(benchmark_pool_t* pool) {
+  if (!pool) return;
+  iree_allocator_t host_allocator = pool->host_allocator;
+  benchmark_pool_begin(pool, BENCHMARK_WORKER_COMMAND_EXIT);
+  for (iree_host_size_t i = 0; i < pool->worker_count; ++i) {
+    benchmark_worker_t* worker = &pool->workers[i];
+    iree_thread_release(worker->thread);  // joins
+    iree_allocator_free(host_allocator, worker->local_memory.data);
+    iree_allocator_free(host_allocator, worker->flush_buffer.data);
+  }
+  iree_notification_deinitialize(&pool->idle_notification);
+  iree_notification_deinitialize(&pool->phase_notification);
+  iree_allocator_free(host_allocator, pool);
+}
+
+// Creates a pool of |worker_count| threads executing |dispatch_state| for
+// entry point |ordinal| of |executable| with the affinity and priority
+// specified by flags. Each worker has its own |local_memory_size| bytes of
+// workgroup-local memory and |flush_buffer_size| bytes for cache flushing.
+static iree_status_t benchmark_pool_create(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    uint32_t variant,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_host_size_t worker_count, iree_host_size_t local_memory_size,
+    iree_host_size_t flush_buffer_size, iree_allocator_t host_allocator,
+    benchmark_pool_t** out_pool) {
+  *out_pool = NULL;
+
+  iree_thread_affinity_t base_affinity;
+  IREE_RETURN_IF_ERROR(iree_thread_affinity_parse(
+      iree_make_cstring_view(FLAG_thread_affinity), &base_affinity));
+  iree_thread_priority_class_t priority_class;
+  IREE_RETURN_IF_ERROR(iree_thread_priority_class_parse(
+      iree_make_cstring_view(FLAG_thread_priority), &priority_class));
+  if (FLAG_tiles_per_reservation <= 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "--tiles_per_reservation must be positive");
+  }
+
+  benchmark_pool_t* pool = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*pool) + worker_count * sizeof(pool->workers[0]),
+      (void**)&pool));
+  memset(pool, 0, sizeof(*pool) + worker_count * sizeof(pool->workers[0]));
+  pool->host_allocator = host_allocator;
+  pool->executable = executable;
+  pool->ordinal = ordinal;
+  pool->variant = variant;
+  pool->dispatch_state = dispatch_state;
+  pool->max_range_x =
+      iree_all_bits_set(
+          iree_hal_local_executable_dispatch_flags(executable, ordinal),
+          IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE)
+          ? UINT16_MAX
+          : 1;
+  pool->tile_count = dispatch_state->workgroup_count_x *
+                     dispatch_state->workgroup_count_y *
+                     dispatch_state->workgroup_count_z;
+  pool->tiles_per_reservation = (uint32_t)FLAG_tiles_per_reservation;
+  iree_atomic_store_int32(&pool->epoch, 0, iree_memory_order_relaxed);
+  iree_notification_initialize(&pool->phase_notification);
+  iree_notification_initialize(&pool->idle_notification);
+
+  // Workers are created one at a time so that a failure only needs to tear
+  // down the ones that exist (pool->worker_count).
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < worker_count && iree_status_is_ok(status);
+       ++i) {
+    benchmark_worker_t* worker = &pool->workers[i];
+    worker->pool = pool;
+    worker->status = iree_ok_status();
+
+    char name[32];
+    snprintf(name, IREE_ARRAYSIZE(name), "benchmark_worker[%d]", (int)i);
+    iree_thread_create_params_t thread_params;
+    memset(&thread_params, 0, sizeof(thread_params));
+    thread_params.name = iree_make_cstring_view(name);
+    thread_params.priority_class = priority_class;
+    iree_thread_affinity_set_any(&thread_params.initial_affinity);
+    worker->processor_id = (uint32_t)i;
+    if (base_affinity.specified) {
+      thread_params.initial_affinity = base_affinity;
+      thread_params.initial_affinity.id =
+          base_affinity.id + (uint32_t)i * (base_affinity.smt ? 2 : 1);
+      worker->processor_id = thread_params.initial_affinity.id;
+    }
+
+    if (local_memory_size > 0) {
+      status = iree_allocator_malloc(host_allocator, local_memory_size,
+                                     (void**)&worker->local_memory.data);
+      worker->local_memory.data_length = local_memory_size;
+    }
+    if (iree_status_is_ok(status) && flush_buffer_size > 0) {
+      status = iree_allocator_malloc(host_allocator, flush_buffer_size,
+                                     (void**)&worker->flush_buffer.data);
+      worker->flush_buffer.data_length = flush_buffer_size;
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_thread_create(benchmark_worker_main, worker, thread_params,
+                                  host_allocator, &worker->thread);
+    }
+    if (iree_status_is_ok(status)) {
+      pool->worker_count = i + 1;
+    } else {
+      iree_allocator_free(host_allocator, worker->local_memory.data);
+      iree_allocator_free(host_allocator, worker->flush_buffer.data);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    benchmark_pool_destroy(pool);
+  }
+  return status;
+}
+
+// Reports per-worker throughput and utilization over |dispatch_duration_ns|
+// of total wall time spent in dispatch phases.
+static void benchmark_pool_report(benchmark_pool_t* pool,
+                                  iree_duration_t dispatch_duration_ns,
+                                  iree_benchmark_state_t* benchmark_state) {
+  int64_t total_workgroup_count = 0;
+  for (iree_host_size_t i = 0; i < pool->worker_count; ++i) {
+    total_workgroup_count += pool->workers[i].workgroup_count;
+  }
+  iree_benchmark_set_counter(benchmark_state, "threads",
+                             (double)pool->worker_count);
+  iree_benchmark_set_counter(
+      benchmark_state, "workgroups_per_s",
+      dispatch_duration_ns > 0 ? (double)total_workgroup_count * 1e9 /
+                                     (double)dispatch_duration_ns
+                               : 0.0);
+  for (iree_host_size_t i = 0; i < pool->worker_count; ++i) {
+    const benchmark_worker_t* worker = &pool->workers[i];
+    char name[64];
+    snprintf(name, IREE_ARRAYSIZE(name), "t%d_workgroups_per_s", (int)i);
+    iree_benchmark_set_counter(
+        benchmark_state, name,
+        worker->busy_duration_ns > 0
+            ? (double)worker->workgroup_count * 1e9 /
+                  (double)worker->busy_duration_ns
+            : 0.0);
+    snprintf(name, IREE_ARRAYSIZE(name), "t%d_utilization", (int)i);
+    iree_benchmark_set_counter(
+        benchmark_state, name,
+        dispatch_duration_ns > 0 ? (double)worker->busy_duration_ns /
+                                       (double)dispatch_duration_ns
+                                 : 0.0);
+  }
+}
+
 // NOTE: error handling is here just for better diagnostics: it is not tracking
 // allocations correctly and will leak. Don't use this as an example for how to
 // write robust code.
@@ -173,10 +554,15 @@ static iree_status_t iree_hal_executable_library_run(
 
   // Perform the load, which will fail if the executable cannot be loaded or
   // there was an issue with the layouts.
+  if (FLAG_thread_count < 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "--thread_count must be non-negative");
+  }
+  const iree_host_size_t thread_count = (iree_host_size_t)FLAG_thread_count;
   iree_hal_executable_t* executable = NULL;
-  IREE_RETURN_IF_ERROR(
-      iree_hal_executable_loader_try_load(executable_loader, &executable_params,
-                                          /*worker_capacity=*/1, &executable));
+  IREE_RETURN_IF_ERROR(iree_hal_executable_loader_try_load(
+      executable_loader, &executable_params,
+      /*worker_capacity=*/iree_max(1, thread_count), &executable));
   iree_hal_local_executable_t* local_executable =
       iree_hal_local_executable_cast(executable);
 
@@ -188,7 +574,7 @@ static iree_status_t iree_hal_executable_library_run(
                     .local_memory_pages *
                 IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
           : 0;
-  if (local_memory_size > 0) {
+  if (local_memory_size > 0 && thread_count == 0) {
     IREE_RETURN_IF_ERROR(iree_allocator_malloc(
         host_allocator, local_memory_size, (void**)&local_memory.data));
     local_memory.data_length = local_memory_size;
@@ -228,7 +614,9 @@ static iree_status_t iree_hal_executable_library_run(
       .workgroup_size_x = FLAG_workgroup_size_x,
       .workgroup_size_y = FLAG_workgroup_size_y,
       .workgroup_size_z = FLAG_workgroup_size_z,
-      .max_concurrency = FLAG_max_concurrency,
+      .max_concurrency = FLAG_max_concurrency > 0
+                             ? FLAG_max_concurrency
+                             : iree_max(1, FLAG_thread_count),
       .push_constant_count = dispatch_params.push_constant_count,
       .push_constants = &dispatch_params.push_constants[0].ui32,
       .binding_count = dispatch_params.binding_count,
@@ -241,11 +629,65 @@ static iree_status_t iree_hal_executable_library_run(
   // we are testing the memory access patterns: if we just ran the same single
   // tile processing the same exact region of memory over and over we are not
   // testing cache effects.
+  //
+  // When threaded the workgroups are distributed across the workers of a pool
+  // and the time includes waking the workers, matching what the task system
+  // does for each dispatch.
+  iree_host_size_t flush_buffer_size =
+      FLAG_flush_cache_bytes > 0 ? (iree_host_size_t)FLAG_flush_cache_bytes : 0;
   int64_t dispatch_count = 0;
-  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
-    IREE_RETURN_IF_ERROR(iree_hal_local_executable_issue_dispatch_inline(
-        local_executable, FLAG_entry_point, &dispatch_state, 0, local_memory));
-    ++dispatch_count;
+  if (thread_count == 0) {
+    iree_byte_span_t flush_buffer = iree_make_byte_span(NULL, 0);
+    if (flush_buffer_size > 0) {
+      IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+          host_allocator, flush_buffer_size, (void**)&flush_buffer.data));
+      flush_buffer.data_length = flush_buffer_size;
+    }
+    while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+      if (flush_buffer_size > 0) {
+        iree_benchmark_pause_timing(benchmark_state);
+        benchmark_flush_cache(flush_buffer);
+        iree_benchmark_resume_timing(benchmark_state);
+      }
+      IREE_RETURN_IF_ERROR(iree_hal_local_executable_issue_dispatch_inline(
+          local_executable, FLAG_entry_point, &dispatch_state, 0,
+          local_memory));
+      ++dispatch_count;
+    }
+    iree_allocator_free(host_allocator, flush_buffer.data);
+  } else {
+    const uint32_t workgroup_count[3] = {dispatch_state.workgroup_count_x,
+                                         dispatch_state.workgroup_count_y,
+                                         dispatch_state.workgroup_count_z};
+    const uint32_t variant = iree_hal_local_executable_select_variant(
+        local_executable, FLAG_entry_point, workgroup_count,
+        dispatch_state.push_constant_count, dispatch_state.push_constants);
+    benchmark_pool_t* pool = NULL;
+    IREE_RETURN_IF_ERROR(benchmark_pool_create(
+        local_executable, FLAG_entry_point, variant, &dispatch_state,
+        thread_count, local_memory_size, flush_buffer_size, host_allocator,
+        &pool));
+    iree_status_t status = iree_ok_status();
+    iree_duration_t dispatch_duration_ns = 0;
+    while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+      if (flush_buffer_size > 0) {
+        iree_benchmark_pause_timing(benchmark_state);
+        benchmark_pool_begin(pool, BENCHMARK_WORKER_COMMAND_FLUSH);
+        iree_status_ignore(benchmark_pool_join(pool));
+        iree_benchmark_resume_timing(benchmark_state);
+      }
+      iree_time_t start_ns = iree_time_now();
+      benchmark_pool_begin(pool, BENCHMARK_WORKER_COMMAND_DISPATCH);
+      status = benchmark_pool_join(pool);
+      dispatch_duration_ns += iree_time_now() - start_ns;
+      if (!iree_status_is_ok(status)) break;
+      ++dispatch_count;
+    }
+    if (iree_status_is_ok(status)) {
+      benchmark_pool_report(pool, dispatch_duration_ns, benchmark_state);
+    }
+    benchmark_pool_destroy(pool);
+    IREE_RETURN_IF_ERROR(status);
   }
 
   // To get a total time per invocation we set the item count to the total
@@ -301,6 +743,12 @@ int main(int argc, char** argv) {
       "  --binding=4xf32=1,2,3,4\n"
       "  --binding=4xf32=100,200,300,400\n"
       "  --binding=4xf32=0,0,0,0\n"
+      "\n"
+      "Workgroups run serially on the benchmark thread unless\n"
+      "--thread_count=N is specified to distribute them across N worker\n"
+      "threads (optionally pinned with --thread_affinity=). Per-thread\n"
+      "throughput and utilization are reported as counters and\n"
+      "--flush_cache_bytes= can be used to measure cold-cache performance.\n"
       "\n");
 
   iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
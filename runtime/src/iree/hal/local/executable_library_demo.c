@@ -23,6 +23,10 @@
 //
 // This is a simple scalar addition:
 //    binding[1] = binding[0] + push_constant[0]
+//
+// The function is declared as processing workgroup ranges and handles all
+// workgroups in [workgroup_id_x, workgroup_id_x + workgroup_range_x) per call
+// to amortize the call overhead across the tiny workgroups.
 static int dispatch_tile_a(
     const iree_hal_executable_environment_v0_t* environment,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
@@ -31,8 +35,11 @@ static int dispatch_tile_a(
       (const dispatch_tile_a_push_constants_t*)dispatch_state->push_constants;
   const float* src = ((const float*)dispatch_state->binding_ptrs[0]);
   float* dst = ((float*)dispatch_state->binding_ptrs[1]);
-  const uint32_t x = workgroup_state->workgroup_id_x;
-  dst[x] = src[x] + push_constants->f0;
+  const uint32_t x_begin = workgroup_state->workgroup_id_x;
+  const uint32_t x_end = x_begin + workgroup_state->workgroup_range_x;
+  for (uint32_t x = x_begin; x < x_end; ++x) {
+    dst[x] = src[x] + push_constants->f0;
+  }
   return 0;
 }
 
@@ -66,6 +73,7 @@ static const iree_hal_executable_dispatch_v0_t entry_points[2] = {
 static const iree_hal_executable_dispatch_attrs_v0_t entry_attrs[2] = {
     {
         .local_memory_pages = 0,
+        .flags = IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE,
     },
     {
         .local_memory_pages = 0,
@@ -81,6 +81,13 @@ int main(int argc, char** argv) {
   const iree_hal_executable_dispatch_v0_t entry_fn_ptr =
       library.v0->exports.ptrs[0];
 
+  // Entry points may process a range of workgroups along X per call. Those
+  // that don't are called once per workgroup.
+  const bool issue_ranges =
+      library.v0->exports.attrs &&
+      (library.v0->exports.attrs[0].flags &
+       IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE);
+
   // Dispatch each workgroup with the same state.
   const iree_hal_executable_dispatch_state_v0_t dispatch_state = {
       .workgroup_count_x = 4,
@@ -103,9 +110,12 @@ int main(int argc, char** argv) {
     workgroup_state.workgroup_id_z = z;
     for (uint32_t y = 0; y < dispatch_state.workgroup_count_y; ++y) {
       workgroup_state.workgroup_id_y = y;
-      for (uint32_t x = 0; x < dispatch_state.workgroup_count_x; ++x) {
+      for (uint32_t x = 0; x < dispatch_state.workgroup_count_x;
+           x += workgroup_state.workgroup_range_x) {
         workgroup_state.workgroup_id_x = x;
-        // Invoke the workgroup (x, y, z).
+        workgroup_state.workgroup_range_x =
+            issue_ranges ? dispatch_state.workgroup_count_x - x : 1;
+        // Invoke the workgroups [x, x + range_x) at (y, z).
         int ret = entry_fn_ptr(&environment, &dispatch_state, &workgroup_state);
         IREE_ASSERT_EQ(
             ret, 0,
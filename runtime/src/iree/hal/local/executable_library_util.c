@@ -39,9 +39,62 @@ iree_status_t iree_hal_executable_library_verify(
                             executable_params->constant_count);
   }
 
+  // Check that dispatch flags are understood; a library relying on a behavior
+  // we don't implement would otherwise silently produce incorrect results.
+  for (uint32_t i = 0; library->exports.attrs && i < library->exports.count;
+       ++i) {
+    const iree_hal_executable_dispatch_flags_v0_t flags =
+        library->exports.attrs[i].flags;
+    if (flags & ~IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "export %u has unsupported dispatch flags %04X",
+                              i, flags);
+    }
+  }
+
+  // Check that variants are well-formed. Unknown operands or predicates would
+  // silently never match and indicate a compiler/runtime mismatch.
+  const iree_hal_executable_export_variant_list_v0_t* export_variants =
+      iree_hal_executable_library_export_variants(library);
+  for (uint32_t i = 0; export_variants && i < library->exports.count; ++i) {
+    const iree_hal_executable_export_variant_list_v0_t* variant_list =
+        &export_variants[i];
+    for (uint32_t j = 0; j < variant_list->count; ++j) {
+      const iree_hal_executable_export_variant_v0_t* variant =
+          &variant_list->variants[j];
+      if (!variant->ptr) {
+        return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "export %u variant %u has no function", i, j);
+      }
+      for (uint32_t k = 0; k < variant->condition_count; ++k) {
+        const iree_hal_executable_variant_condition_v0_t* condition =
+            &variant->conditions[k];
+        if (condition->operand >
+                IREE_HAL_EXECUTABLE_VARIANT_OPERAND_PUSH_CONSTANT ||
+            condition->predicate >
+                IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_MULTIPLE_OF) {
+          return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                  "export %u variant %u condition %u has an "
+                                  "unsupported operand (%u) or predicate (%u)",
+                                  i, j, k, condition->operand,
+                                  condition->predicate);
+        }
+      }
+    }
+  }
+
   return iree_ok_status();
 }
 
+const iree_hal_executable_export_variant_list_v0_t*
+iree_hal_executable_library_export_variants(
+    const iree_hal_executable_library_v0_t* library) {
+  if (library->header->version < IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_5) {
+    return NULL;
+  }
+  return library->export_variants;
+}
+
 iree_status_t iree_hal_executable_library_initialize_imports(
     iree_hal_executable_environment_v0_t* environment,
     const iree_hal_executable_import_provider_t import_provider,
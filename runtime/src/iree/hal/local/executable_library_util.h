@@ -17,6 +17,24 @@ iree_status_t iree_hal_executable_library_verify(
     const iree_hal_executable_params_t* executable_params,
     const iree_hal_executable_library_v0_t* library);
 
+// Returns the export variant table of |library| or NULL if the library does
+// not declare one (including libraries predating the table).
+const iree_hal_executable_export_variant_list_v0_t*
+iree_hal_executable_library_export_variants(
+    const iree_hal_executable_library_v0_t* library);
+
+// Returns the function pointer for the export |ordinal| specialized as
+// |variant| (as selected by iree_hal_local_executable_select_variant).
+// Variant 0 is the generic export.
+static inline iree_hal_executable_dispatch_v0_t
+iree_hal_executable_library_export_ptr(
+    const iree_hal_executable_library_v0_t* library, iree_host_size_t ordinal,
+    uint32_t variant) {
+  if (IREE_LIKELY(variant == 0)) return library->exports.ptrs[ordinal];
+  IREE_ASSERT(variant <= library->export_variants[ordinal].count);
+  return library->export_variants[ordinal].variants[variant - 1].ptr;
+}
+
 // Allocates and resolves import function and context storage on |environment|
 // using |import_provider|. All imports will be called through |import_thunk|.
 iree_status_t iree_hal_executable_library_initialize_imports(
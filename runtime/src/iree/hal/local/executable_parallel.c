@@ -0,0 +1,82 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/executable_parallel.h"
+
+#include "iree/base/internal/synchronization.h"
+
+// NOTE: threading support is optional. Without thread-local storage providers
+// can't be installed and all loops run serially on the calling thread.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+// Single-threaded; a plain global is equivalent to thread-local storage.
+#define iree_hal_executable_parallel_thread_local
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define iree_hal_executable_parallel_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define iree_hal_executable_parallel_thread_local __declspec(thread)
+#endif  // __STDC_NO_THREADS__
+
+#if defined(iree_hal_executable_parallel_thread_local)
+
+static iree_hal_executable_parallel_thread_local const
+    iree_hal_executable_parallel_t* iree_hal_executable_parallel_current =
+        NULL;
+
+const iree_hal_executable_parallel_t* iree_hal_executable_parallel_exchange(
+    const iree_hal_executable_parallel_t* parallel) {
+  const iree_hal_executable_parallel_t* previous =
+      iree_hal_executable_parallel_current;
+  iree_hal_executable_parallel_current = parallel;
+  return previous;
+}
+
+static const iree_hal_executable_parallel_t*
+iree_hal_executable_parallel_query(void) {
+  return iree_hal_executable_parallel_current;
+}
+
+#else
+
+const iree_hal_executable_parallel_t* iree_hal_executable_parallel_exchange(
+    const iree_hal_executable_parallel_t* parallel) {
+  return NULL;
+}
+
+static const iree_hal_executable_parallel_t*
+iree_hal_executable_parallel_query(void) {
+  return NULL;
+}
+
+#endif  // iree_hal_executable_parallel_thread_local
+
+uint32_t iree_hal_executable_parallel_concurrency(void) {
+  const iree_hal_executable_parallel_t* parallel =
+      iree_hal_executable_parallel_query();
+  return parallel ? iree_max(1u, parallel->concurrency) : 1u;
+}
+
+iree_status_t iree_hal_executable_parallel_for(
+    uint32_t tile_count, iree_hal_executable_parallel_tile_fn_t tile_fn,
+    void* user_data) {
+  IREE_ASSERT_ARGUMENT(tile_fn);
+  const iree_hal_executable_parallel_t* parallel =
+      iree_hal_executable_parallel_query();
+  if (parallel && tile_count > 1) {
+    // Remove the provider while the loop runs so that tiles executing on the
+    // calling thread don't recursively fork.
+    iree_hal_executable_parallel_exchange(NULL);
+    iree_status_t status =
+        parallel->parallel_for(parallel->self, tile_count, tile_fn, user_data);
+    iree_hal_executable_parallel_exchange(parallel);
+    return status;
+  }
+  iree_status_t status = iree_ok_status();
+  for (uint32_t i = 0; i < tile_count && iree_status_is_ok(status); ++i) {
+    status = tile_fn(user_data, i);
+  }
+  return status;
+}
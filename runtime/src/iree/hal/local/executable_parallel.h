@@ -0,0 +1,67 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_EXECUTABLE_PARALLEL_H_
+#define IREE_HAL_LOCAL_EXECUTABLE_PARALLEL_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_parallel_t
+//===----------------------------------------------------------------------===//
+
+// Function called for each tile of a parallel loop.
+typedef iree_status_t(IREE_API_PTR* iree_hal_executable_parallel_tile_fn_t)(
+    void* user_data, uint32_t tile_index);
+
+// Parallel execution support made available to executable imports.
+//
+// Executables (and the imports they call) run on threads owned by whatever is
+// executing the dispatch. Drivers that can fork nested work (such as the task
+// system) install a provider on the calling thread for the duration of each
+// workgroup so that imports implementing large operations can spread their
+// work across the available threads. When no provider is installed loops run
+// serially on the calling thread.
+typedef struct iree_hal_executable_parallel_t {
+  // Opaque state passed to |parallel_for|.
+  void* self;
+  // Estimated maximum number of threads that may process tiles concurrently.
+  uint32_t concurrency;
+  // Calls |tile_fn| for each tile in [0, |tile_count|) and returns after all
+  // have completed. Returns the first failure from any tile.
+  iree_status_t(IREE_API_PTR* parallel_for)(
+      void* self, uint32_t tile_count,
+      iree_hal_executable_parallel_tile_fn_t tile_fn, void* user_data);
+} iree_hal_executable_parallel_t;
+
+// Installs |parallel| as the provider for the calling thread and returns the
+// previously installed provider (or NULL). Callers must restore the previous
+// provider before |parallel| goes out of scope. |parallel| may be NULL to
+// remove the current provider.
+const iree_hal_executable_parallel_t* iree_hal_executable_parallel_exchange(
+    const iree_hal_executable_parallel_t* parallel);
+
+// Returns the concurrency of the provider installed on the calling thread or 1
+// if none is installed.
+uint32_t iree_hal_executable_parallel_concurrency(void);
+
+// Calls |tile_fn| for each tile in [0, |tile_count|) using the provider
+// installed on the calling thread, if any, or serially otherwise.
+iree_status_t iree_hal_executable_parallel_for(
+    uint32_t tile_count, iree_hal_executable_parallel_tile_fn_t tile_fn,
+    void* user_data);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_EXECUTABLE_PARALLEL_H_
@@ -0,0 +1,94 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/executable_parallel.h"
+
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// Provider that runs tiles serially in reverse order and counts its loops.
+struct ReverseProvider {
+  iree_hal_executable_parallel_t parallel;
+  int loop_count = 0;
+
+  ReverseProvider() {
+    parallel.self = this;
+    parallel.concurrency = 4;
+    parallel.parallel_for = [](void* self, uint32_t tile_count,
+                               iree_hal_executable_parallel_tile_fn_t tile_fn,
+                               void* user_data) {
+      auto* provider = (ReverseProvider*)self;
+      ++provider->loop_count;
+      // Nested loops must not see the provider.
+      EXPECT_EQ(iree_hal_executable_parallel_concurrency(), 1u);
+      for (uint32_t i = tile_count; i > 0; --i) {
+        IREE_RETURN_IF_ERROR(tile_fn(user_data, i - 1));
+      }
+      return iree_ok_status();
+    };
+  }
+};
+
+static iree_status_t RecordTile(void* user_data, uint32_t tile_index) {
+  ((std::vector<uint32_t>*)user_data)->push_back(tile_index);
+  return iree_ok_status();
+}
+
+// Tests that loops run serially in order without a provider.
+TEST(ExecutableParallelTest, SerialFallback) {
+  EXPECT_EQ(iree_hal_executable_parallel_concurrency(), 1u);
+  std::vector<uint32_t> tiles;
+  IREE_ASSERT_OK(iree_hal_executable_parallel_for(3, RecordTile, &tiles));
+  EXPECT_EQ(tiles, (std::vector<uint32_t>{0, 1, 2}));
+}
+
+// Tests that loops use the installed provider and that it can be removed.
+TEST(ExecutableParallelTest, InstalledProvider) {
+  ReverseProvider provider;
+  EXPECT_EQ(iree_hal_executable_parallel_exchange(&provider.parallel),
+            nullptr);
+  EXPECT_EQ(iree_hal_executable_parallel_concurrency(), 4u);
+  std::vector<uint32_t> tiles;
+  IREE_ASSERT_OK(iree_hal_executable_parallel_for(3, RecordTile, &tiles));
+  EXPECT_EQ(tiles, (std::vector<uint32_t>{2, 1, 0}));
+  EXPECT_EQ(provider.loop_count, 1);
+
+  // Single tile loops don't need the provider.
+  IREE_ASSERT_OK(iree_hal_executable_parallel_for(1, RecordTile, &tiles));
+  EXPECT_EQ(provider.loop_count, 1);
+
+  EXPECT_EQ(iree_hal_executable_parallel_exchange(NULL), &provider.parallel);
+  EXPECT_EQ(iree_hal_executable_parallel_concurrency(), 1u);
+}
+
+// Tests that tile failures stop the loop and are returned.
+TEST(ExecutableParallelTest, TileFailure) {
+  int call_count = 0;
+  EXPECT_THAT(Status(iree_hal_executable_parallel_for(
+                  8,
+                  [](void* user_data, uint32_t tile_index) {
+                    ++*(int*)user_data;
+                    return tile_index == 2
+                               ? iree_make_status(IREE_STATUS_DATA_LOSS)
+                               : iree_ok_status();
+                  },
+                  &call_count)),
+              StatusIs(StatusCode::kDataLoss));
+  EXPECT_EQ(call_count, 3);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -142,10 +142,13 @@ typedef uint32_t iree_hal_executable_plugin_version_t;
 
 #define IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_1 0x00000001u
 
+// Adds parallel execution support to iree_hal_executable_plugin_environment_t.
+#define IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_2 0x00000002u
+
 // The latest version of the plugin API; can be used to populate the
 // iree_hal_executable_plugin_header_t::version when building plugins.
 #define IREE_HAL_EXECUTABLE_PLUGIN_VERSION_LATEST \
-  IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_1
+  IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_2
 
 // A header present at the top of all versions of the plugin API used by the
 // runtime to ensure version compatibility.
@@ -375,12 +378,45 @@ static inline int iree_hal_executable_plugin_strcmp(const char* lhs,
 // IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_*
 //===----------------------------------------------------------------------===//
 
+// Function called for each tile of a parallel loop requested by an import.
+// Returns 0 on success and non-zero on failure; failures cause any tiles not
+// yet started to be skipped and the loop to fail.
+typedef int (*iree_hal_executable_plugin_tile_fn_v0_t)(void* user_data,
+                                                       uint32_t tile_index);
+
+// Returns the estimated maximum number of threads that may process tiles of a
+// parallel loop issued from the calling thread. Always at least 1. Imports can
+// use this to choose a tile count that keeps all threads busy without
+// excessive per-tile overhead.
+typedef uint32_t (*iree_hal_executable_plugin_parallel_concurrency_fn_v0_t)(
+    void* self);
+
+// Calls |tile_fn| for each tile in [0, |tile_count|) and returns once all tiles
+// have completed. Tiles may run in any order and concurrently on any thread
+// (including the calling one) and must not depend on thread-local state.
+//
+// Only imports called from within an executable dispatch may use this. When
+// the hosting driver is unable to fork work (such as synchronous devices) the
+// tiles run serially on the calling thread. Parallel loops issued from within
+// a tile always run serially.
+typedef iree_hal_executable_plugin_status_t (
+    *iree_hal_executable_plugin_parallel_for_fn_v0_t)(
+    void* self, uint32_t tile_count,
+    iree_hal_executable_plugin_tile_fn_v0_t tile_fn, void* user_data);
+
 // Environment provided to the plugin on load.
 typedef struct iree_hal_executable_plugin_environment_v0_t {
   // Allocator to be used for all plugin allocations for the lifetime of the
   // plugin (such as those needed during resolution). The allocator will be
   // valid until the plugin is unloaded.
   iree_hal_executable_plugin_allocator_t host_allocator;
+
+  // Parallel execution support for imports; available in
+  // IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_2 and later. |parallel_self| must be
+  // passed to the functions and both remain valid until the plugin is unloaded.
+  void* parallel_self;
+  iree_hal_executable_plugin_parallel_concurrency_fn_v0_t parallel_concurrency;
+  iree_hal_executable_plugin_parallel_for_fn_v0_t parallel_for;
 } iree_hal_executable_plugin_environment_v0_t;
 
 typedef struct iree_hal_executable_plugin_resolve_params_v0_t {
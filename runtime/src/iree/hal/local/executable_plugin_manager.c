@@ -7,6 +7,7 @@
 #include "iree/hal/local/executable_plugin_manager.h"
 
 #include "iree/base/internal/synchronization.h"
+#include "iree/hal/local/executable_parallel.h"
 
 //===----------------------------------------------------------------------===//
 // Plugin API compatibility checks
@@ -79,6 +80,47 @@ STATIC_ASSERT_EQ(sizeof(iree_hal_executable_plugin_string_pair_t),
 
 #undef STATIC_ASSERT_EQ
 
+//===----------------------------------------------------------------------===//
+// Parallel execution
+//===----------------------------------------------------------------------===//
+
+static uint32_t iree_hal_executable_plugin_parallel_concurrency(void* self) {
+  return iree_hal_executable_parallel_concurrency();
+}
+
+typedef struct iree_hal_executable_plugin_tile_closure_t {
+  iree_hal_executable_plugin_tile_fn_v0_t fn;
+  void* user_data;
+} iree_hal_executable_plugin_tile_closure_t;
+
+static iree_status_t iree_hal_executable_plugin_tile_thunk(
+    void* user_data, uint32_t tile_index) {
+  const iree_hal_executable_plugin_tile_closure_t* closure =
+      (const iree_hal_executable_plugin_tile_closure_t*)user_data;
+  int result = closure->fn(closure->user_data, tile_index);
+  if (IREE_UNLIKELY(result != 0)) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "plugin tile %u failed with result %d", tile_index,
+                            result);
+  }
+  return iree_ok_status();
+}
+
+static iree_hal_executable_plugin_status_t
+iree_hal_executable_plugin_parallel_for(
+    void* self, uint32_t tile_count,
+    iree_hal_executable_plugin_tile_fn_v0_t tile_fn, void* user_data) {
+  iree_hal_executable_plugin_tile_closure_t closure = {
+      .fn = tile_fn,
+      .user_data = user_data,
+  };
+  iree_status_t status = iree_hal_executable_parallel_for(
+      tile_count, iree_hal_executable_plugin_tile_thunk, &closure);
+  // Plugins may not support full status objects so only the code is returned.
+  return iree_hal_executable_plugin_status_from_code(
+      iree_status_consume_code(status));
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_executable_plugin_t
 //===----------------------------------------------------------------------===//
@@ -163,6 +205,9 @@ static iree_status_t iree_hal_executable_plugin_load(
               .ctl = (iree_hal_executable_plugin_allocator_ctl_fn_t)
                          host_allocator.ctl,
           },
+      .parallel_self = NULL,
+      .parallel_concurrency = iree_hal_executable_plugin_parallel_concurrency,
+      .parallel_for = iree_hal_executable_plugin_parallel_for,
   };
 
   // Plugin is probably good - let's try loading it! It could fail for any
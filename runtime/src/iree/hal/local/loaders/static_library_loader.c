@@ -74,6 +74,11 @@ static iree_status_t iree_hal_static_executable_create(
     executable->library.header = library_header;
     executable->identifier = iree_make_cstring_view((*library_header)->name);
     executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+    executable->base.export_variants =
+        iree_hal_executable_library_export_variants(executable->library.v0);
+    executable->base.export_count = executable->library.v0->exports.count;
+    executable->base.library_name = (*library_header)->name;
+    executable->base.export_names = executable->library.v0->exports.names;
   }
 
   // Copy executable constants so we own them.
@@ -135,6 +140,7 @@ static void iree_hal_static_executable_destroy(
 
 static iree_status_t iree_hal_static_executable_issue_call(
     iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    uint32_t variant,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
     const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
     uint32_t worker_id) {
@@ -151,8 +157,10 @@ static iree_status_t iree_hal_static_executable_issue_call(
                                                     library, ordinal);
   IREE_HAL_EXECUTABLE_LIBRARY_CALL_HOOK_BEGIN(executable->identifier, library,
                                               ordinal);
-  int ret = library->exports.ptrs[ordinal](&base_executable->environment,
-                                           dispatch_state, workgroup_state);
+  iree_hal_executable_dispatch_v0_t fn_ptr =
+      iree_hal_executable_library_export_ptr(library, ordinal, variant);
+  int ret =
+      fn_ptr(&base_executable->environment, dispatch_state, workgroup_state);
   IREE_HAL_EXECUTABLE_LIBRARY_CALL_HOOK_END(executable->identifier, library,
                                             ordinal);
   IREE_TRACE_ZONE_END(z0);
@@ -6,6 +6,7 @@
 
 #include "iree/hal/local/local_executable.h"
 
+#include "iree/hal/local/dispatch_statistics.h"
 #include "iree/hal/local/executable_environment.h"
 
 void iree_hal_local_executable_initialize(
@@ -27,6 +28,12 @@ void iree_hal_local_executable_initialize(
 
   // Function attributes are optional and populated by the parent type.
   out_base_executable->dispatch_attrs = NULL;
+  out_base_executable->export_variants = NULL;
+  out_base_executable->export_count = pipeline_layout_count;
+  out_base_executable->library_name = NULL;
+  out_base_executable->export_names = NULL;
+  iree_atomic_store_intptr(&out_base_executable->dispatch_statistics, 0,
+                           iree_memory_order_relaxed);
 
   // Default environment with no imports assigned.
   iree_hal_executable_environment_initialize(host_allocator,
@@ -39,6 +46,10 @@ void iree_hal_local_executable_deinitialize(
        ++i) {
     iree_hal_pipeline_layout_release(base_executable->pipeline_layouts[i]);
   }
+  iree_allocator_free(base_executable->host_allocator,
+                      (void*)iree_atomic_load_intptr(
+                          &base_executable->dispatch_statistics,
+                          iree_memory_order_acquire));
 }
 
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
@@ -46,18 +57,202 @@ iree_hal_local_executable_t* iree_hal_local_executable_cast(
   return (iree_hal_local_executable_t*)base_value;
 }
 
+static bool iree_hal_local_executable_variant_condition_matches(
+    const iree_hal_executable_variant_condition_v0_t* condition,
+    const uint32_t workgroup_count[3], iree_host_size_t push_constant_count,
+    const uint32_t* push_constants) {
+  uint32_t operand = 0;
+  switch (condition->operand) {
+    case IREE_HAL_EXECUTABLE_VARIANT_OPERAND_WORKGROUP_COUNT_X:
+    case IREE_HAL_EXECUTABLE_VARIANT_OPERAND_WORKGROUP_COUNT_Y:
+    case IREE_HAL_EXECUTABLE_VARIANT_OPERAND_WORKGROUP_COUNT_Z:
+      operand = workgroup_count[condition->operand];
+      break;
+    case IREE_HAL_EXECUTABLE_VARIANT_OPERAND_PUSH_CONSTANT:
+      if (condition->index >= push_constant_count) return false;
+      operand = push_constants[condition->index];
+      break;
+    default:
+      return false;
+  }
+  const uint32_t value = condition->value;
+  switch (condition->predicate) {
+    case IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_EQ:
+      return operand == value;
+    case IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_NE:
+      return operand != value;
+    case IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_LT:
+      return operand < value;
+    case IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_LE:
+      return operand <= value;
+    case IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_GT:
+      return operand > value;
+    case IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_GE:
+      return operand >= value;
+    case IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_MULTIPLE_OF:
+      return value != 0 && (operand % value) == 0;
+    default:
+      return false;
+  }
+}
+
+uint32_t iree_hal_local_executable_select_variant(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const uint32_t workgroup_count[3], iree_host_size_t push_constant_count,
+    const uint32_t* push_constants) {
+  IREE_ASSERT_ARGUMENT(executable);
+  if (IREE_LIKELY(!executable->export_variants)) {
+    return IREE_HAL_LOCAL_EXECUTABLE_VARIANT_GENERIC;
+  }
+  const iree_hal_executable_export_variant_list_v0_t* variant_list =
+      &executable->export_variants[ordinal];
+  for (uint32_t i = 0; i < variant_list->count; ++i) {
+    const iree_hal_executable_export_variant_v0_t* variant =
+        &variant_list->variants[i];
+    bool matches = true;
+    for (uint32_t j = 0; j < variant->condition_count && matches; ++j) {
+      matches = iree_hal_local_executable_variant_condition_matches(
+          &variant->conditions[j], workgroup_count, push_constant_count,
+          push_constants);
+    }
+    if (matches) return i + 1;
+  }
+  return IREE_HAL_LOCAL_EXECUTABLE_VARIANT_GENERIC;
+}
+
+// Returns the dispatch statistics entry of entry point |ordinal|, resolving it
+// on first use. Returns NULL if the entry could not be resolved in which case
+// the dispatch goes unrecorded.
+static iree_hal_local_dispatch_statistics_entry_t*
+iree_hal_local_executable_dispatch_statistics_entry(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  if (IREE_UNLIKELY(ordinal >= executable->export_count)) return NULL;
+
+  // Allocate the table on first use. Workers may race and the loser discards
+  // its copy.
+  iree_atomic_intptr_t* table = (iree_atomic_intptr_t*)iree_atomic_load_intptr(
+      &executable->dispatch_statistics, iree_memory_order_acquire);
+  if (IREE_UNLIKELY(!table)) {
+    iree_atomic_intptr_t* new_table = NULL;
+    if (!iree_status_is_ok(iree_allocator_malloc(
+            executable->host_allocator,
+            executable->export_count * sizeof(*new_table),
+            (void**)&new_table))) {
+      return NULL;
+    }
+    for (iree_host_size_t i = 0; i < executable->export_count; ++i) {
+      iree_atomic_store_intptr(&new_table[i], 0, iree_memory_order_relaxed);
+    }
+    intptr_t expected = 0;
+    if (iree_atomic_compare_exchange_strong_intptr(
+            &executable->dispatch_statistics, &expected, (intptr_t)new_table,
+            iree_memory_order_acq_rel, iree_memory_order_acquire)) {
+      table = new_table;
+    } else {
+      iree_allocator_free(executable->host_allocator, new_table);
+      table = (iree_atomic_intptr_t*)expected;
+    }
+  }
+
+  iree_hal_local_dispatch_statistics_entry_t* entry =
+      (iree_hal_local_dispatch_statistics_entry_t*)iree_atomic_load_intptr(
+          &table[ordinal], iree_memory_order_acquire);
+  if (IREE_LIKELY(entry)) return entry;
+
+  // Entries are unique per name so racing lookups resolve the same entry.
+  char ordinal_name[32];
+  iree_string_view_t export_name = iree_string_view_empty();
+  if (executable->export_names && executable->export_names[ordinal]) {
+    export_name = iree_make_cstring_view(executable->export_names[ordinal]);
+  } else {
+    int length = snprintf(ordinal_name, sizeof(ordinal_name), "%" PRIhsz,
+                          ordinal);
+    export_name = iree_make_string_view(ordinal_name, (iree_host_size_t)length);
+  }
+  iree_string_view_t library_name =
+      executable->library_name
+          ? iree_make_cstring_view(executable->library_name)
+          : IREE_SV("executable");
+  iree_status_t status = iree_hal_local_dispatch_statistics_lookup(
+      library_name, export_name, &entry);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return NULL;
+  }
+  iree_atomic_store_intptr(&table[ordinal], (intptr_t)entry,
+                           iree_memory_order_release);
+  return entry;
+}
+
+// Issues the call and records it in the dispatch statistics.
+static iree_status_t iree_hal_local_executable_issue_call_with_statistics(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    uint32_t variant,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id) {
+  iree_hal_local_dispatch_statistics_entry_t* entry =
+      iree_hal_local_executable_dispatch_statistics_entry(executable, ordinal);
+
+  // Hardware counters are read as close to the call as possible so that the
+  // deltas exclude as much of our own bookkeeping as we can.
+  uint64_t counters_begin[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT];
+  const bool is_sampling =
+      entry && iree_hal_local_dispatch_statistics_is_sampling() &&
+      iree_hal_local_hardware_counters_read(counters_begin);
+  iree_time_t start_ns = iree_time_now();
+  iree_status_t status =
+      ((const iree_hal_local_executable_vtable_t*)executable->resource.vtable)
+          ->issue_call(executable, ordinal, variant, dispatch_state,
+                       workgroup_state, worker_id);
+  iree_time_t duration_ns = iree_time_now() - start_ns;
+  if (IREE_UNLIKELY(!entry)) return status;
+  if (is_sampling) {
+    uint64_t counters_end[IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT];
+    if (iree_hal_local_hardware_counters_read(counters_end)) {
+      for (int i = 0; i < IREE_HAL_LOCAL_HARDWARE_COUNTER_COUNT; ++i) {
+        counters_end[i] -= counters_begin[i];
+      }
+      iree_hal_local_dispatch_statistics_record_counters(entry, duration_ns,
+                                                         counters_end);
+    }
+  }
+
+  // Each dispatch has exactly one call covering workgroup 0,0,0 and the
+  // bindings of the dispatch are attributed to it.
+  const bool is_first_call = workgroup_state->workgroup_id_x == 0 &&
+                             workgroup_state->workgroup_id_y == 0 &&
+                             workgroup_state->workgroup_id_z == 0;
+  uint64_t binding_bytes = 0;
+  if (is_first_call) {
+    for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
+      binding_bytes += dispatch_state->binding_lengths[i];
+    }
+  }
+  iree_hal_local_dispatch_statistics_record(
+      entry, is_first_call, iree_max(1u, workgroup_state->workgroup_range_x),
+      duration_ns, binding_bytes);
+  return status;
+}
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    uint32_t variant,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
     const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
     uint32_t worker_id) {
   IREE_ASSERT_ARGUMENT(executable);
   IREE_ASSERT_ARGUMENT(dispatch_state);
   IREE_ASSERT_ARGUMENT(workgroup_state);
+  if (IREE_UNLIKELY(iree_hal_local_dispatch_statistics_is_capturing())) {
+    return iree_hal_local_executable_issue_call_with_statistics(
+        executable, ordinal, variant, dispatch_state, workgroup_state,
+        worker_id);
+  }
   return ((const iree_hal_local_executable_vtable_t*)
               executable->resource.vtable)
-      ->issue_call(executable, ordinal, dispatch_state, workgroup_state,
-                   worker_id);
+      ->issue_call(executable, ordinal, variant, dispatch_state,
+                   workgroup_state, worker_id);
 }
 
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
@@ -82,12 +277,30 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
   });
 #endif  // IREE_HAL_VERBOSE_TRACING_ENABLE
 
+  // Specialized variants depend only on dispatch-invariant state and are
+  // selected once for all workgroups.
+  const uint32_t workgroup_count[3] = {workgroup_count_x, workgroup_count_y,
+                                       workgroup_count_z};
+  const uint32_t variant = iree_hal_local_executable_select_variant(
+      executable, ordinal, workgroup_count,
+      dispatch_state->push_constant_count, dispatch_state->push_constants);
+
   iree_status_t status = iree_ok_status();
 
+  // Functions supporting ranges are called once per row (or the largest range
+  // we can represent) instead of once per workgroup.
+  const uint32_t max_range_x =
+      iree_all_bits_set(
+          iree_hal_local_executable_dispatch_flags(executable, ordinal),
+          IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE)
+          ? UINT16_MAX
+          : 1;
+
   iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
       .workgroup_id_x = 0,
       .workgroup_id_y = 0,
       .workgroup_id_z = 0,
+      .workgroup_range_x = 1,
       .processor_id = processor_id,
       .local_memory = local_memory.data,
       .local_memory_size = (size_t)local_memory.data_length,
@@ -96,10 +309,13 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     workgroup_state.workgroup_id_z = z;
     for (uint32_t y = 0; y < workgroup_count_y; ++y) {
       workgroup_state.workgroup_id_y = y;
-      for (uint32_t x = 0; x < workgroup_count_x; ++x) {
+      for (uint32_t x = 0; x < workgroup_count_x;
+           x += workgroup_state.workgroup_range_x) {
         workgroup_state.workgroup_id_x = x;
+        workgroup_state.workgroup_range_x =
+            (uint16_t)iree_min(workgroup_count_x - x, max_range_x);
         status = iree_hal_local_executable_issue_call(
-            executable, ordinal, dispatch_state, &workgroup_state,
+            executable, ordinal, variant, dispatch_state, &workgroup_state,
             /*worker_id=*/0);
         if (!iree_status_is_ok(status)) break;
       }
@@ -8,6 +8,7 @@
 #define IREE_HAL_LOCAL_LOCAL_EXECUTABLE_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/executable_library.h"
 
@@ -35,15 +36,38 @@ typedef struct iree_hal_local_executable_t {
   // of memory required by the function.
   const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs;
 
+  // Optional per-entry point specialized variants selected at dispatch time
+  // based on the workgroup count and push constants. NULL if no entry points
+  // have variants.
+  const iree_hal_executable_export_variant_list_v0_t* export_variants;
+
+  // Number of entry points. Defaults to the pipeline layout count and is set
+  // by the parent type when layouts are omitted.
+  iree_host_size_t export_count;
+  // Optional name of the executable and names of each entry point used when
+  // reporting dispatch statistics. Either may be NULL.
+  const char* library_name;
+  const char* const* export_names;
+  // Lazily allocated table of iree_hal_local_dispatch_statistics_entry_t
+  // pointers 1:1 with entry points, populated on first dispatch while dispatch
+  // statistics are being captured.
+  iree_atomic_intptr_t dispatch_statistics;
+
   // Execution environment.
   iree_hal_executable_environment_v0_t environment;
 } iree_hal_local_executable_t;
 
+// Variant index indicating the generic (unspecialized) entry point.
+#define IREE_HAL_LOCAL_EXECUTABLE_VARIANT_GENERIC 0u
+
 typedef struct iree_hal_local_executable_vtable_t {
   iree_hal_executable_vtable_t base;
 
+  // Issues a call to entry point |ordinal| using the specialized |variant| as
+  // returned from iree_hal_local_executable_select_variant.
   iree_status_t(IREE_API_PTR* issue_call)(
       iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+      uint32_t variant,
       const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
       const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
       uint32_t worker_id);
@@ -67,8 +91,32 @@ void iree_hal_local_executable_deinitialize(
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value);
 
+// Selects the variant of entry point |ordinal| to use for a dispatch with the
+// given |workgroup_count| and |push_constants|. Variants are evaluated in
+// order and the first with all conditions passing is returned as a 1-based
+// index. Returns IREE_HAL_LOCAL_EXECUTABLE_VARIANT_GENERIC if the entry point
+// has no variants or none match.
+//
+// The result depends only on the provided parameters and callers are expected
+// to select once per dispatch (or once when recording) and reuse the result
+// for all workgroups.
+// Returns the IREE_HAL_EXECUTABLE_DISPATCH_FLAG_* bits of entry point
+// |ordinal|.
+static inline iree_hal_executable_dispatch_flags_v0_t
+iree_hal_local_executable_dispatch_flags(
+    const iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  return executable->dispatch_attrs ? executable->dispatch_attrs[ordinal].flags
+                                    : IREE_HAL_EXECUTABLE_DISPATCH_FLAG_NONE;
+}
+
+uint32_t iree_hal_local_executable_select_variant(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const uint32_t workgroup_count[3], iree_host_size_t push_constant_count,
+    const uint32_t* push_constants);
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    uint32_t variant,
     const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
     const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
     uint32_t worker_id);
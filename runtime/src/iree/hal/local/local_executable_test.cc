@@ -0,0 +1,182 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/local_executable.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// Executable that records the variant of each issued call instead of calling
+// into any library.
+typedef struct iree_hal_test_executable_t {
+  iree_hal_local_executable_t base;
+  uint32_t call_count;
+  uint32_t last_variant;
+  uint32_t workgroup_total;
+} iree_hal_test_executable_t;
+
+static void iree_hal_test_executable_destroy(
+    iree_hal_executable_t* base_executable) {}
+
+static iree_status_t iree_hal_test_executable_issue_call(
+    iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
+    uint32_t variant,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state,
+    uint32_t worker_id) {
+  auto* executable = (iree_hal_test_executable_t*)base_executable;
+  ++executable->call_count;
+  executable->last_variant = variant;
+  executable->workgroup_total += workgroup_state->workgroup_range_x;
+  return iree_ok_status();
+}
+
+static const iree_hal_local_executable_vtable_t*
+iree_hal_test_executable_vtable() {
+  static iree_hal_local_executable_vtable_t vtable = []() {
+    iree_hal_local_executable_vtable_t vtable;
+    memset(&vtable, 0, sizeof(vtable));
+    vtable.base.destroy = iree_hal_test_executable_destroy;
+    vtable.issue_call = iree_hal_test_executable_issue_call;
+    return vtable;
+  }();
+  return &vtable;
+}
+
+static int iree_hal_test_dispatch(
+    const iree_hal_executable_environment_v0_t* environment,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  return 0;
+}
+
+// Export 0: variant 1 when x is a multiple of 4 and push constant 1 is 8,
+// variant 2 when x < 16.
+static const iree_hal_executable_variant_condition_v0_t kConditions0A[] = {
+    {IREE_HAL_EXECUTABLE_VARIANT_OPERAND_WORKGROUP_COUNT_X,
+     IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_MULTIPLE_OF, 0, 4},
+    {IREE_HAL_EXECUTABLE_VARIANT_OPERAND_PUSH_CONSTANT,
+     IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_EQ, 1, 8},
+};
+static const iree_hal_executable_variant_condition_v0_t kConditions0B[] = {
+    {IREE_HAL_EXECUTABLE_VARIANT_OPERAND_WORKGROUP_COUNT_X,
+     IREE_HAL_EXECUTABLE_VARIANT_PREDICATE_LT, 0, 16},
+};
+static const iree_hal_executable_export_variant_v0_t kVariants0[] = {
+    {iree_hal_test_dispatch, IREE_ARRAYSIZE(kConditions0A), kConditions0A},
+    {iree_hal_test_dispatch, IREE_ARRAYSIZE(kConditions0B), kConditions0B},
+};
+// Export 1 has no variants.
+static const iree_hal_executable_export_variant_list_v0_t kExportVariants[] = {
+    {IREE_ARRAYSIZE(kVariants0), kVariants0},
+    {0, NULL},
+};
+
+struct LocalExecutableTest : public ::testing::Test {
+  iree_hal_test_executable_t executable;
+
+  void SetUp() override {
+    memset(&executable, 0, sizeof(executable));
+    iree_hal_local_executable_initialize(
+        iree_hal_test_executable_vtable(), /*pipeline_layout_count=*/0,
+        /*source_pipeline_layouts=*/NULL, /*target_pipeline_layouts=*/NULL,
+        iree_allocator_system(), &executable.base);
+  }
+
+  void TearDown() override {
+    iree_hal_local_executable_deinitialize(&executable.base);
+  }
+
+  uint32_t Select(iree_host_size_t ordinal, uint32_t x,
+                  iree_host_size_t push_constant_count,
+                  const uint32_t* push_constants) {
+    const uint32_t workgroup_count[3] = {x, 1, 1};
+    return iree_hal_local_executable_select_variant(
+        &executable.base, ordinal, workgroup_count, push_constant_count,
+        push_constants);
+  }
+};
+
+// Tests that executables without variants always use the generic export.
+TEST_F(LocalExecutableTest, SelectWithoutVariants) {
+  const uint32_t push_constants[2] = {0, 8};
+  EXPECT_EQ(Select(0, 4, 2, push_constants),
+            IREE_HAL_LOCAL_EXECUTABLE_VARIANT_GENERIC);
+}
+
+// Tests that variants are matched in order with the generic export used as a
+// fallback.
+TEST_F(LocalExecutableTest, SelectFirstMatch) {
+  executable.base.export_variants = kExportVariants;
+  const uint32_t push_constants[2] = {0, 8};
+  EXPECT_EQ(Select(0, 8, 2, push_constants), 1u);
+  EXPECT_EQ(Select(0, 6, 2, push_constants), 2u);
+  EXPECT_EQ(Select(0, 32, 2, push_constants), 1u);
+  EXPECT_EQ(Select(0, 33, 2, push_constants),
+            IREE_HAL_LOCAL_EXECUTABLE_VARIANT_GENERIC);
+  EXPECT_EQ(Select(1, 8, 2, push_constants),
+            IREE_HAL_LOCAL_EXECUTABLE_VARIANT_GENERIC);
+}
+
+// Tests that conditions on push constants that were not provided fail.
+TEST_F(LocalExecutableTest, SelectMissingPushConstant) {
+  executable.base.export_variants = kExportVariants;
+  const uint32_t push_constants[1] = {8};
+  EXPECT_EQ(Select(0, 32, 1, push_constants),
+            IREE_HAL_LOCAL_EXECUTABLE_VARIANT_GENERIC);
+  EXPECT_EQ(Select(0, 8, 1, push_constants), 2u);
+}
+
+// Tests that inline dispatches issue all workgroups with the selected variant.
+TEST_F(LocalExecutableTest, DispatchInlineUsesVariant) {
+  executable.base.export_variants = kExportVariants;
+  const uint32_t push_constants[2] = {0, 8};
+  iree_hal_executable_dispatch_state_v0_t dispatch_state;
+  memset(&dispatch_state, 0, sizeof(dispatch_state));
+  dispatch_state.workgroup_count_x = 4;
+  dispatch_state.workgroup_count_y = 2;
+  dispatch_state.workgroup_count_z = 1;
+  dispatch_state.push_constant_count = IREE_ARRAYSIZE(push_constants);
+  dispatch_state.push_constants = push_constants;
+  IREE_ASSERT_OK(iree_hal_local_executable_issue_dispatch_inline(
+      &executable.base, 0, &dispatch_state, /*processor_id=*/0,
+      iree_byte_span_empty()));
+  EXPECT_EQ(executable.call_count, 8u);
+  EXPECT_EQ(executable.last_variant, 1u);
+  EXPECT_EQ(executable.workgroup_total, 8u);
+}
+
+// Tests that inline dispatches of entry points processing workgroup ranges are
+// issued once per row.
+TEST_F(LocalExecutableTest, DispatchInlineRanges) {
+  static const iree_hal_executable_dispatch_attrs_v0_t kAttrs[1] = {
+      {/*local_memory_pages=*/0,
+       /*flags=*/IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE},
+  };
+  executable.base.dispatch_attrs = kAttrs;
+  iree_hal_executable_dispatch_state_v0_t dispatch_state;
+  memset(&dispatch_state, 0, sizeof(dispatch_state));
+  dispatch_state.workgroup_count_x = 100;
+  dispatch_state.workgroup_count_y = 3;
+  dispatch_state.workgroup_count_z = 2;
+  IREE_ASSERT_OK(iree_hal_local_executable_issue_dispatch_inline(
+      &executable.base, 0, &dispatch_state, /*processor_id=*/0,
+      iree_byte_span_empty()));
+  EXPECT_EQ(executable.call_count, 3u * 2u);
+  EXPECT_EQ(executable.workgroup_total, 100u * 3u * 2u);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
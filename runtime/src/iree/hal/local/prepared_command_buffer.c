@@ -0,0 +1,755 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/prepared_command_buffer.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/cpu.h"
+#include "iree/base/internal/fpu_state.h"
+#include "iree/base/internal/math.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/utils/resource_set.h"
+
+//===----------------------------------------------------------------------===//
+// Prepared commands
+//===----------------------------------------------------------------------===//
+
+typedef enum iree_hal_prepared_cmd_type_e {
+  IREE_HAL_PREPARED_CMD_FILL_BUFFER = 0,
+  IREE_HAL_PREPARED_CMD_UPDATE_BUFFER,
+  IREE_HAL_PREPARED_CMD_COPY_BUFFER,
+  IREE_HAL_PREPARED_CMD_DISPATCH,
+  IREE_HAL_PREPARED_CMD_DISPATCH_INDIRECT,
+  IREE_HAL_PREPARED_CMD_TYPE_COUNT,
+} iree_hal_prepared_cmd_type_t;
+
+typedef struct iree_hal_prepared_cmd_header_t {
+  struct iree_hal_prepared_cmd_header_t* next;
+  iree_hal_prepared_cmd_type_t type;
+} iree_hal_prepared_cmd_header_t;
+
+typedef struct iree_hal_prepared_cmd_fill_buffer_t {
+  iree_hal_prepared_cmd_header_t header;
+  iree_hal_buffer_t* target_buffer;
+  iree_device_size_t target_offset;
+  iree_device_size_t length;
+  uint64_t pattern;
+  iree_host_size_t pattern_length;
+} iree_hal_prepared_cmd_fill_buffer_t;
+
+typedef struct iree_hal_prepared_cmd_update_buffer_t {
+  iree_hal_prepared_cmd_header_t header;
+  iree_hal_buffer_t* target_buffer;
+  iree_device_size_t target_offset;
+  iree_device_size_t length;
+  uint8_t source_buffer[];
+} iree_hal_prepared_cmd_update_buffer_t;
+
+typedef struct iree_hal_prepared_cmd_copy_buffer_t {
+  iree_hal_prepared_cmd_header_t header;
+  iree_hal_buffer_t* source_buffer;
+  iree_device_size_t source_offset;
+  iree_hal_buffer_t* target_buffer;
+  iree_device_size_t target_offset;
+  iree_device_size_t length;
+} iree_hal_prepared_cmd_copy_buffer_t;
+
+typedef struct iree_hal_prepared_cmd_dispatch_t {
+  iree_hal_prepared_cmd_header_t header;
+  iree_hal_local_executable_t* executable;
+  int32_t ordinal;
+
+  // Bytes of workgroup local memory required by the dispatch.
+  iree_host_size_t local_memory_size;
+
+  // Mapped workgroup count read on each execution for indirect dispatches or
+  // NULL if the count is embedded in |dispatch_state|. Only used by
+  // IREE_HAL_PREPARED_CMD_DISPATCH_INDIRECT.
+  const uint32_t* workgroup_count_ptr;
+
+  // Fully-resolved dispatch state referencing the push constants and bindings
+  // stored immediately following this struct in memory:
+  // - uint32_t push_constants[dispatch_state.push_constant_count];
+  // - void* binding_ptrs[dispatch_state.binding_count];
+  // - size_t binding_lengths[dispatch_state.binding_count];
+  iree_alignas(64) iree_hal_executable_dispatch_state_v0_t dispatch_state;
+} iree_hal_prepared_cmd_dispatch_t;
+
+// Executes a single prepared command on the calling thread.
+typedef iree_status_t (*iree_hal_prepared_cmd_fn_t)(
+    const iree_hal_prepared_cmd_header_t* header,
+    iree_cpu_processor_id_t processor_id, iree_byte_span_t local_memory);
+
+// An entry in the flattened execution list built when recording ends.
+typedef struct iree_hal_prepared_op_t {
+  iree_hal_prepared_cmd_fn_t fn;
+  const iree_hal_prepared_cmd_header_t* cmd;
+} iree_hal_prepared_op_t;
+
+// Returns the function used to execute commands of the given |type|.
+static iree_hal_prepared_cmd_fn_t iree_hal_prepared_cmd_fn(
+    iree_hal_prepared_cmd_type_t type);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_prepared_command_buffer_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_prepared_command_buffer_t {
+  iree_hal_command_buffer_t base;
+  iree_allocator_t host_allocator;
+
+  // Arena used for all prepared commands.
+  iree_arena_allocator_t arena;
+
+  // Maintains a reference to all resources used within the command buffer.
+  iree_hal_resource_set_t* resource_set;
+
+  // Singly-linked list of commands in recording order.
+  iree_hal_prepared_cmd_header_t* cmd_head;
+  iree_hal_prepared_cmd_header_t* cmd_tail;
+  iree_host_size_t cmd_count;
+
+  // Flat list of |op_count| commands and the functions executing them built
+  // from the command list when recording ends. Execution is a single pass
+  // over this array without any per-command type dispatch.
+  iree_hal_prepared_op_t* ops;
+  iree_host_size_t op_count;
+
+  // Maximum local memory size required by any dispatch. Allocated once per
+  // execution and shared by all dispatches.
+  iree_host_size_t max_local_memory_size;
+
+  // Recording state; unused after the command buffer has been ended.
+  struct {
+    // A flattened list of all available descriptor set bindings.
+    // As descriptor sets are pushed/bound the bindings will be updated to
+    // represent the fully-translated binding data pointer.
+    void* full_bindings[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                        IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+    size_t full_binding_lengths[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                                IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+
+    // All available push constants updated each time push_constants is called.
+    // Reset only with the command buffer and otherwise will maintain its values
+    // during recording to allow for partial push_constants updates.
+    uint32_t push_constants[IREE_HAL_LOCAL_MAX_PUSH_CONSTANT_COUNT];
+  } state;
+} iree_hal_prepared_command_buffer_t;
+
+static const iree_hal_command_buffer_vtable_t
+    iree_hal_prepared_command_buffer_vtable;
+
+static iree_hal_prepared_command_buffer_t*
+iree_hal_prepared_command_buffer_cast(iree_hal_command_buffer_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_prepared_command_buffer_vtable);
+  return (iree_hal_prepared_command_buffer_t*)base_value;
+}
+
+iree_status_t iree_hal_prepared_command_buffer_create(
+    iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    iree_hal_command_buffer_t** out_command_buffer) {
+  IREE_ASSERT_ARGUMENT(block_pool);
+  IREE_ASSERT_ARGUMENT(out_command_buffer);
+  *out_command_buffer = NULL;
+  if (binding_capacity > 0) {
+    // Bindings are resolved while recording and can't come from a table.
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "prepared command buffers do not support binding tables");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_prepared_command_buffer_t* command_buffer = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, sizeof(*command_buffer), (void**)&command_buffer);
+  if (iree_status_is_ok(status)) {
+    iree_hal_command_buffer_initialize(
+        device, mode, command_categories, queue_affinity, binding_capacity,
+        &iree_hal_prepared_command_buffer_vtable, &command_buffer->base);
+    command_buffer->host_allocator = host_allocator;
+    iree_arena_initialize(block_pool, &command_buffer->arena);
+    command_buffer->cmd_head = NULL;
+    command_buffer->cmd_tail = NULL;
+    command_buffer->cmd_count = 0;
+    command_buffer->ops = NULL;
+    command_buffer->op_count = 0;
+    command_buffer->max_local_memory_size = 0;
+    memset(&command_buffer->state, 0, sizeof(command_buffer->state));
+    status = iree_hal_resource_set_allocate(block_pool,
+                                            &command_buffer->resource_set);
+  }
+  if (iree_status_is_ok(status)) {
+    *out_command_buffer = &command_buffer->base;
+  } else {
+    iree_hal_command_buffer_release(&command_buffer->base);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_prepared_command_buffer_destroy(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  iree_allocator_t host_allocator = command_buffer->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_arena_deinitialize(&command_buffer->arena);
+  iree_hal_resource_set_free(command_buffer->resource_set);
+  iree_allocator_free(host_allocator, command_buffer);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_prepared_command_buffer_isa(
+    iree_hal_command_buffer_t* command_buffer) {
+  return iree_hal_resource_is(&command_buffer->resource,
+                              &iree_hal_prepared_command_buffer_vtable);
+}
+
+// Allocates a command of |cmd_size| bytes and appends it to the command list.
+static iree_status_t iree_hal_prepared_command_buffer_append_cmd(
+    iree_hal_prepared_command_buffer_t* command_buffer,
+    iree_hal_prepared_cmd_type_t type, iree_host_size_t cmd_size,
+    void** out_cmd) {
+  iree_hal_prepared_cmd_header_t* header = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_arena_allocate(&command_buffer->arena, cmd_size, (void**)&header));
+  header->next = NULL;
+  header->type = type;
+  if (command_buffer->cmd_tail) {
+    command_buffer->cmd_tail->next = header;
+  } else {
+    command_buffer->cmd_head = header;
+  }
+  command_buffer->cmd_tail = header;
+  ++command_buffer->cmd_count;
+  *out_cmd = header;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_prepared_command_buffer_t recording
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_hal_prepared_command_buffer_begin(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  if (command_buffer->cmd_head) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "command buffer cannot be re-recorded");
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_end(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  memset(&command_buffer->state, 0, sizeof(command_buffer->state));
+
+  // Flatten the command list so that execution doesn't need to chase pointers
+  // or switch on the command type.
+  if (command_buffer->cmd_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena,
+        command_buffer->cmd_count * sizeof(command_buffer->ops[0]),
+        (void**)&command_buffer->ops));
+    iree_host_size_t op_count = 0;
+    for (const iree_hal_prepared_cmd_header_t* header =
+             command_buffer->cmd_head;
+         header != NULL; header = header->next) {
+      iree_hal_prepared_op_t* op = &command_buffer->ops[op_count++];
+      op->fn = iree_hal_prepared_cmd_fn(header->type);
+      op->cmd = header;
+    }
+    command_buffer->op_count = op_count;
+  }
+
+  iree_hal_resource_set_freeze(command_buffer->resource_set);
+  return iree_ok_status();
+}
+
+static void iree_hal_prepared_command_buffer_begin_debug_group(
+    iree_hal_command_buffer_t* base_command_buffer, iree_string_view_t label,
+    iree_hal_label_color_t label_color,
+    const iree_hal_label_location_t* location) {}
+
+static void iree_hal_prepared_command_buffer_end_debug_group(
+    iree_hal_command_buffer_t* base_command_buffer) {}
+
+static iree_status_t iree_hal_prepared_command_buffer_execution_barrier(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_execution_stage_t source_stage_mask,
+    iree_hal_execution_stage_t target_stage_mask,
+    iree_hal_execution_barrier_flags_t flags,
+    iree_host_size_t memory_barrier_count,
+    const iree_hal_memory_barrier_t* memory_barriers,
+    iree_host_size_t buffer_barrier_count,
+    const iree_hal_buffer_barrier_t* buffer_barriers) {
+  // No-op; we execute synchronously.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_signal_event(
+    iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
+    iree_hal_execution_stage_t source_stage_mask) {
+  // No-op; we execute synchronously.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_reset_event(
+    iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
+    iree_hal_execution_stage_t source_stage_mask) {
+  // No-op; we execute synchronously.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_wait_events(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_host_size_t event_count, const iree_hal_event_t** events,
+    iree_hal_execution_stage_t source_stage_mask,
+    iree_hal_execution_stage_t target_stage_mask,
+    iree_host_size_t memory_barrier_count,
+    const iree_hal_memory_barrier_t* memory_barriers,
+    iree_host_size_t buffer_barrier_count,
+    const iree_hal_buffer_barrier_t* buffer_barriers) {
+  // No-op; we execute synchronously.
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_discard_buffer(
+    iree_hal_command_buffer_t* base_command_buffer, iree_hal_buffer_t* buffer) {
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_fill_buffer(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, const void* pattern,
+    iree_host_size_t pattern_length) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  if (IREE_UNLIKELY(pattern_length > sizeof(uint64_t))) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "fill patterns must be at most 8 bytes");
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &target_buffer));
+  iree_hal_prepared_cmd_fill_buffer_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_prepared_command_buffer_append_cmd(
+      command_buffer, IREE_HAL_PREPARED_CMD_FILL_BUFFER, sizeof(*cmd),
+      (void**)&cmd));
+  cmd->target_buffer = target_buffer;
+  cmd->target_offset = target_offset;
+  cmd->length = length;
+  cmd->pattern = 0;
+  memcpy(&cmd->pattern, pattern, pattern_length);
+  cmd->pattern_length = pattern_length;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_update_buffer(
+    iree_hal_command_buffer_t* base_command_buffer, const void* source_buffer,
+    iree_host_size_t source_offset, iree_hal_buffer_t* target_buffer,
+    iree_device_size_t target_offset, iree_device_size_t length) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &target_buffer));
+  iree_hal_prepared_cmd_update_buffer_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_prepared_command_buffer_append_cmd(
+      command_buffer, IREE_HAL_PREPARED_CMD_UPDATE_BUFFER,
+      sizeof(*cmd) + (iree_host_size_t)length, (void**)&cmd));
+  cmd->target_buffer = target_buffer;
+  cmd->target_offset = target_offset;
+  cmd->length = length;
+  memcpy(cmd->source_buffer, (const uint8_t*)source_buffer + source_offset,
+         (iree_host_size_t)length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_copy_buffer(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  const void* resources[2] = {source_buffer, target_buffer};
+  IREE_RETURN_IF_ERROR(
+      iree_hal_resource_set_insert(command_buffer->resource_set, 2, resources));
+  iree_hal_prepared_cmd_copy_buffer_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_prepared_command_buffer_append_cmd(
+      command_buffer, IREE_HAL_PREPARED_CMD_COPY_BUFFER, sizeof(*cmd),
+      (void**)&cmd));
+  cmd->source_buffer = source_buffer;
+  cmd->source_offset = source_offset;
+  cmd->target_buffer = target_buffer;
+  cmd->target_offset = target_offset;
+  cmd->length = length;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_collective(
+    iree_hal_command_buffer_t* base_command_buffer, iree_hal_channel_t* channel,
+    iree_hal_collective_op_t op, uint32_t param,
+    iree_hal_buffer_binding_t send_binding,
+    iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "collectives not yet implemented on CPU");
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_push_constants(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_pipeline_layout_t* pipeline_layout, iree_host_size_t offset,
+    const void* values, iree_host_size_t values_length) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  if (IREE_UNLIKELY(offset + values_length >=
+                    sizeof(command_buffer->state.push_constants))) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "push constant range %" PRIhsz " (length=%" PRIhsz
+                            ") out of range",
+                            offset, values_length);
+  }
+  memcpy((uint8_t*)&command_buffer->state.push_constants + offset, values,
+         values_length);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_push_descriptor_set(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set,
+    iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+
+  if (IREE_UNLIKELY(set >= IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "set %u out of bounds", set);
+  }
+
+  iree_host_size_t binding_base =
+      set * IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT;
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    if (IREE_UNLIKELY(bindings[i].binding >=
+                      IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "buffer binding index out of bounds");
+    }
+    iree_host_size_t binding_ordinal = binding_base + bindings[i].binding;
+
+    // Mapped persistently so that the pointer can be used for all executions.
+    iree_hal_buffer_mapping_t buffer_mapping = {{0}};
+    if (bindings[i].buffer) {
+      IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+          command_buffer->resource_set, 1, &bindings[i].buffer));
+      IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+          bindings[i].buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+          IREE_HAL_MEMORY_ACCESS_ANY, bindings[i].offset, bindings[i].length,
+          &buffer_mapping));
+    }
+    command_buffer->state.full_bindings[binding_ordinal] =
+        buffer_mapping.contents.data;
+    command_buffer->state.full_binding_lengths[binding_ordinal] =
+        buffer_mapping.contents.data_length;
+  }
+
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_build_dispatch(
+    iree_hal_prepared_command_buffer_t* command_buffer,
+    iree_hal_prepared_cmd_type_t type, iree_hal_executable_t* executable,
+    int32_t entry_point, uint32_t workgroup_x, uint32_t workgroup_y,
+    uint32_t workgroup_z, iree_hal_prepared_cmd_dispatch_t** out_cmd) {
+  iree_hal_local_executable_t* local_executable =
+      iree_hal_local_executable_cast(executable);
+  if (IREE_UNLIKELY(!local_executable->pipeline_layouts)) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "layouts not provided during executable creation; cannot dispatch");
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &executable));
+
+  iree_hal_local_pipeline_layout_t* local_layout =
+      (iree_hal_local_pipeline_layout_t*)
+          local_executable->pipeline_layouts[entry_point];
+  iree_host_size_t push_constant_count = local_layout->push_constants;
+  iree_hal_local_binding_mask_t used_binding_mask = local_layout->used_bindings;
+  iree_host_size_t used_binding_count =
+      iree_math_count_ones_u64(used_binding_mask);
+
+  iree_hal_prepared_cmd_dispatch_t* cmd = NULL;
+  iree_host_size_t total_cmd_size =
+      sizeof(*cmd) + push_constant_count * sizeof(uint32_t) +
+      used_binding_count * sizeof(void*) + used_binding_count * sizeof(size_t);
+  IREE_RETURN_IF_ERROR(iree_hal_prepared_command_buffer_append_cmd(
+      command_buffer, type, total_cmd_size, (void**)&cmd));
+  cmd->executable = local_executable;
+  cmd->ordinal = entry_point;
+  cmd->local_memory_size =
+      local_executable->dispatch_attrs
+          ? local_executable->dispatch_attrs[entry_point].local_memory_pages *
+                IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
+          : 0;
+  command_buffer->max_local_memory_size = iree_max(
+      command_buffer->max_local_memory_size, cmd->local_memory_size);
+  cmd->workgroup_count_ptr = NULL;
+
+  iree_hal_executable_dispatch_state_v0_t* dispatch_state =
+      &cmd->dispatch_state;
+  memset(dispatch_state, 0, sizeof(*dispatch_state));
+  // TODO(benvanik): expose on API or keep fixed on executable.
+  dispatch_state->workgroup_size_x = 1;
+  dispatch_state->workgroup_size_y = 1;
+  dispatch_state->workgroup_size_z = 1;
+  dispatch_state->workgroup_count_x = workgroup_x;
+  dispatch_state->workgroup_count_y = workgroup_y;
+  dispatch_state->workgroup_count_z = workgroup_z;
+  // Single-threaded.
+  dispatch_state->max_concurrency = 1;
+  dispatch_state->push_constant_count = push_constant_count;
+  dispatch_state->binding_count = used_binding_count;
+
+  // Copy only the push constant range used by the executable.
+  uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
+  uint32_t* push_constants = (uint32_t*)cmd_ptr;
+  memcpy(push_constants, command_buffer->state.push_constants,
+         push_constant_count * sizeof(*push_constants));
+  cmd_ptr += push_constant_count * sizeof(*push_constants);
+  dispatch_state->push_constants = push_constants;
+
+  // Produce the dense binding list based on the declared bindings used.
+  void** binding_ptrs = (void**)cmd_ptr;
+  cmd_ptr += used_binding_count * sizeof(*binding_ptrs);
+  size_t* binding_lengths = (size_t*)cmd_ptr;
+  cmd_ptr += used_binding_count * sizeof(*binding_lengths);
+  dispatch_state->binding_ptrs = binding_ptrs;
+  dispatch_state->binding_lengths = binding_lengths;
+  iree_host_size_t binding_base = 0;
+  for (iree_host_size_t i = 0; i < used_binding_count; ++i) {
+    int mask_offset = iree_math_count_trailing_zeros_u64(used_binding_mask);
+    int binding_ordinal = binding_base + mask_offset;
+    binding_base += mask_offset + 1;
+    used_binding_mask = iree_shr(used_binding_mask, mask_offset + 1);
+    binding_ptrs[i] = command_buffer->state.full_bindings[binding_ordinal];
+    if (!binding_ptrs[i]) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "(flat) binding %d is NULL", binding_ordinal);
+    }
+    binding_lengths[i] =
+        command_buffer->state.full_binding_lengths[binding_ordinal];
+  }
+
+  *out_cmd = cmd;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_dispatch(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  iree_hal_prepared_cmd_dispatch_t* cmd = NULL;
+  return iree_hal_prepared_command_buffer_build_dispatch(
+      command_buffer, IREE_HAL_PREPARED_CMD_DISPATCH, executable, entry_point,
+      workgroup_x, workgroup_y, workgroup_z, &cmd);
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_dispatch_indirect(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    iree_hal_buffer_t* workgroups_buffer,
+    iree_device_size_t workgroups_offset) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, 1, &workgroups_buffer));
+
+  // The workgroup count is read from the mapped buffer on each execution.
+  iree_hal_buffer_mapping_t buffer_mapping = {{0}};
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      workgroups_buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+      IREE_HAL_MEMORY_ACCESS_READ, workgroups_offset, 3 * sizeof(uint32_t),
+      &buffer_mapping));
+
+  iree_hal_prepared_cmd_dispatch_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_prepared_command_buffer_build_dispatch(
+      command_buffer, IREE_HAL_PREPARED_CMD_DISPATCH_INDIRECT, executable,
+      entry_point, 0, 0, 0, &cmd));
+  cmd->workgroup_count_ptr = (const uint32_t*)buffer_mapping.contents.data;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_prepared_command_buffer_execute_commands(
+    iree_hal_command_buffer_t* base_command_buffer,
+    iree_hal_command_buffer_t* base_commands,
+    iree_hal_buffer_binding_table_t binding_table) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "indirect command buffers not yet implemented");
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_prepared_command_buffer_t execution
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_hal_prepared_cmd_dispatch_execute(
+    const iree_hal_prepared_cmd_header_t* header,
+    iree_cpu_processor_id_t processor_id, iree_byte_span_t local_memory) {
+  const iree_hal_prepared_cmd_dispatch_t* cmd =
+      (const iree_hal_prepared_cmd_dispatch_t*)header;
+  return iree_hal_local_executable_issue_dispatch_inline(
+      cmd->executable, cmd->ordinal, &cmd->dispatch_state, processor_id,
+      local_memory);
+}
+
+static iree_status_t iree_hal_prepared_cmd_dispatch_indirect_execute(
+    const iree_hal_prepared_cmd_header_t* header,
+    iree_cpu_processor_id_t processor_id, iree_byte_span_t local_memory) {
+  const iree_hal_prepared_cmd_dispatch_t* cmd =
+      (const iree_hal_prepared_cmd_dispatch_t*)header;
+  // Indirect dispatches patch a copy of the state as the command may be
+  // executing concurrently on other threads.
+  iree_alignas(64) iree_hal_executable_dispatch_state_v0_t dispatch_state =
+      cmd->dispatch_state;
+  dispatch_state.workgroup_count_x = cmd->workgroup_count_ptr[0];
+  dispatch_state.workgroup_count_y = cmd->workgroup_count_ptr[1];
+  dispatch_state.workgroup_count_z = cmd->workgroup_count_ptr[2];
+  return iree_hal_local_executable_issue_dispatch_inline(
+      cmd->executable, cmd->ordinal, &dispatch_state, processor_id,
+      local_memory);
+}
+
+static iree_status_t iree_hal_prepared_cmd_fill_buffer_execute(
+    const iree_hal_prepared_cmd_header_t* header,
+    iree_cpu_processor_id_t processor_id, iree_byte_span_t local_memory) {
+  const iree_hal_prepared_cmd_fill_buffer_t* cmd =
+      (const iree_hal_prepared_cmd_fill_buffer_t*)header;
+  return iree_hal_buffer_map_fill(cmd->target_buffer, cmd->target_offset,
+                                  cmd->length, &cmd->pattern,
+                                  cmd->pattern_length);
+}
+
+static iree_status_t iree_hal_prepared_cmd_update_buffer_execute(
+    const iree_hal_prepared_cmd_header_t* header,
+    iree_cpu_processor_id_t processor_id, iree_byte_span_t local_memory) {
+  const iree_hal_prepared_cmd_update_buffer_t* cmd =
+      (const iree_hal_prepared_cmd_update_buffer_t*)header;
+  return iree_hal_buffer_map_write(cmd->target_buffer, cmd->target_offset,
+                                   cmd->source_buffer, cmd->length);
+}
+
+static iree_status_t iree_hal_prepared_cmd_copy_buffer_execute(
+    const iree_hal_prepared_cmd_header_t* header,
+    iree_cpu_processor_id_t processor_id, iree_byte_span_t local_memory) {
+  const iree_hal_prepared_cmd_copy_buffer_t* cmd =
+      (const iree_hal_prepared_cmd_copy_buffer_t*)header;
+  return iree_hal_buffer_map_copy(cmd->source_buffer, cmd->source_offset,
+                                  cmd->target_buffer, cmd->target_offset,
+                                  cmd->length);
+}
+
+static iree_hal_prepared_cmd_fn_t iree_hal_prepared_cmd_fn(
+    iree_hal_prepared_cmd_type_t type) {
+  static const iree_hal_prepared_cmd_fn_t
+      fns[IREE_HAL_PREPARED_CMD_TYPE_COUNT] = {
+          [IREE_HAL_PREPARED_CMD_FILL_BUFFER] =
+              iree_hal_prepared_cmd_fill_buffer_execute,
+          [IREE_HAL_PREPARED_CMD_UPDATE_BUFFER] =
+              iree_hal_prepared_cmd_update_buffer_execute,
+          [IREE_HAL_PREPARED_CMD_COPY_BUFFER] =
+              iree_hal_prepared_cmd_copy_buffer_execute,
+          [IREE_HAL_PREPARED_CMD_DISPATCH] =
+              iree_hal_prepared_cmd_dispatch_execute,
+          [IREE_HAL_PREPARED_CMD_DISPATCH_INDIRECT] =
+              iree_hal_prepared_cmd_dispatch_indirect_execute,
+      };
+  return fns[type];
+}
+
+iree_status_t iree_hal_prepared_command_buffer_execute(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_prepared_command_buffer_t* command_buffer =
+      iree_hal_prepared_command_buffer_cast(base_command_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // A single scratch allocation large enough for any dispatch is shared by all
+  // dispatches. It's allocated per execution so that concurrent executions of
+  // the same command buffer don't share it.
+  iree_byte_span_t local_memory =
+      iree_make_byte_span(NULL, command_buffer->max_local_memory_size);
+  if (local_memory.data_length > 0) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(command_buffer->host_allocator,
+                                  local_memory.data_length,
+                                  (void**)&local_memory.data));
+  }
+
+  // We are running on a borrowed thread and know nothing about its processor
+  // or floating point state. Both are established once for all commands.
+  const iree_cpu_processor_id_t processor_id = iree_cpu_query_processor_id();
+  iree_fpu_state_t fpu_state =
+      iree_fpu_state_push(IREE_FPU_STATE_FLAG_FLUSH_DENORMALS_TO_ZERO);
+
+  iree_status_t status = iree_ok_status();
+  const iree_hal_prepared_op_t* ops = command_buffer->ops;
+  for (iree_host_size_t i = 0; i < command_buffer->op_count; ++i) {
+    status = ops[i].fn(ops[i].cmd, processor_id, local_memory);
+    if (IREE_UNLIKELY(!iree_status_is_ok(status))) break;
+  }
+
+  iree_fpu_state_pop(fpu_state);
+  if (local_memory.data) {
+    iree_allocator_free(command_buffer->host_allocator, local_memory.data);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_command_buffer_vtable_t
+//===----------------------------------------------------------------------===//
+
+static const iree_hal_command_buffer_vtable_t
+    iree_hal_prepared_command_buffer_vtable = {
+        .destroy = iree_hal_prepared_command_buffer_destroy,
+        .begin = iree_hal_prepared_command_buffer_begin,
+        .end = iree_hal_prepared_command_buffer_end,
+        .begin_debug_group = iree_hal_prepared_command_buffer_begin_debug_group,
+        .end_debug_group = iree_hal_prepared_command_buffer_end_debug_group,
+        .execution_barrier = iree_hal_prepared_command_buffer_execution_barrier,
+        .signal_event = iree_hal_prepared_command_buffer_signal_event,
+        .reset_event = iree_hal_prepared_command_buffer_reset_event,
+        .wait_events = iree_hal_prepared_command_buffer_wait_events,
+        .discard_buffer = iree_hal_prepared_command_buffer_discard_buffer,
+        .fill_buffer = iree_hal_prepared_command_buffer_fill_buffer,
+        .update_buffer = iree_hal_prepared_command_buffer_update_buffer,
+        .copy_buffer = iree_hal_prepared_command_buffer_copy_buffer,
+        .collective = iree_hal_prepared_command_buffer_collective,
+        .push_constants = iree_hal_prepared_command_buffer_push_constants,
+        .push_descriptor_set =
+            iree_hal_prepared_command_buffer_push_descriptor_set,
+        .dispatch = iree_hal_prepared_command_buffer_dispatch,
+        .dispatch_indirect = iree_hal_prepared_command_buffer_dispatch_indirect,
+        .execute_commands = iree_hal_prepared_command_buffer_execute_commands,
+};
@@ -0,0 +1,55 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_PREPARED_COMMAND_BUFFER_H_
+#define IREE_HAL_LOCAL_PREPARED_COMMAND_BUFFER_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a reusable command buffer that resolves all dispatch state when
+// recording so that it can be executed synchronously as a tight loop of
+// executable function calls.
+//
+// Binding pointers and lengths, push constants, workgroup counts, and
+// workgroup local memory requirements are computed once during recording
+// instead of on every execution as with deferred command buffers replayed
+// through an inline command buffer. Ending the command buffer flattens the
+// commands into an array of function pointers and their prepared state and
+// execution is a single loop over it. Execution performs no validation or
+// resource lookups and all barriers and events are ignored as commands execute
+// in order on the calling thread.
+//
+// Buffers are mapped persistently when bound and must remain mappable for the
+// lifetime of the command buffer. Binding tables are not supported and
+// |binding_capacity| must be 0.
+iree_status_t iree_hal_prepared_command_buffer_create(
+    iree_hal_device_t* device, iree_hal_command_buffer_mode_t mode,
+    iree_hal_command_category_t command_categories,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    iree_hal_command_buffer_t** out_command_buffer);
+
+// Returns true if |command_buffer| is a prepared command buffer.
+bool iree_hal_prepared_command_buffer_isa(
+    iree_hal_command_buffer_t* command_buffer);
+
+// Executes all commands recorded in |command_buffer| on the calling thread.
+// The command buffer must have been ended. Multiple threads may execute the
+// same command buffer concurrently.
+iree_status_t iree_hal_prepared_command_buffer_execute(
+    iree_hal_command_buffer_t* command_buffer);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_PREPARED_COMMAND_BUFFER_H_
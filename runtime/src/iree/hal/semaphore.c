@@ -8,6 +8,7 @@
 
 #include <stddef.h>
 
+#include "iree/base/metrics.h"
 #include "iree/hal/detail.h"
 #include "iree/hal/device.h"
 
@@ -18,6 +19,10 @@
 #define _VTABLE_DISPATCH(semaphore, method_name) \
   IREE_HAL_VTABLE_DISPATCH(semaphore, iree_hal_semaphore, method_name)
 
+static IREE_METRIC_HISTOGRAM_DEFINE(
+    iree_hal_semaphore_wait_duration, "iree_hal_semaphore_wait_nanoseconds",
+    "Duration of blocking semaphore waits.");
+
 IREE_HAL_API_RETAIN_RELEASE(semaphore);
 
 IREE_API_EXPORT iree_status_t
@@ -35,6 +40,52 @@ iree_hal_semaphore_create(iree_hal_device_t* device, uint64_t initial_value,
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_semaphore_import(
+    iree_hal_device_t* device,
+    const iree_hal_external_semaphore_t* external_semaphore,
+    iree_hal_external_semaphore_flags_t flags,
+    iree_hal_semaphore_t** out_semaphore) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(external_semaphore);
+  IREE_ASSERT_ARGUMENT(out_semaphore);
+  *out_semaphore = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, external_semaphore->type);
+  iree_status_t status = iree_ok_status();
+  if (IREE_HAL_VTABLE_DISPATCH(device, iree_hal_device, import_semaphore)) {
+    status =
+        IREE_HAL_VTABLE_DISPATCH(device, iree_hal_device, import_semaphore)(
+            device, external_semaphore, flags, out_semaphore);
+  } else {
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "device does not support semaphore import");
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_semaphore_export(
+    iree_hal_semaphore_t* semaphore,
+    iree_hal_external_semaphore_type_t requested_type,
+    iree_hal_external_semaphore_flags_t requested_flags,
+    iree_hal_external_semaphore_t* out_external_semaphore) {
+  IREE_ASSERT_ARGUMENT(semaphore);
+  IREE_ASSERT_ARGUMENT(out_external_semaphore);
+  memset(out_external_semaphore, 0, sizeof(*out_external_semaphore));
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, requested_type);
+  iree_status_t status = iree_ok_status();
+  if (_VTABLE_DISPATCH(semaphore, export_semaphore)) {
+    status = _VTABLE_DISPATCH(semaphore, export_semaphore)(
+        semaphore, requested_type, requested_flags, out_external_semaphore);
+  } else {
+    status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "semaphore does not support export");
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t
 iree_hal_semaphore_query(iree_hal_semaphore_t* semaphore, uint64_t* out_value) {
   IREE_ASSERT_ARGUMENT(semaphore);
@@ -73,8 +124,22 @@ IREE_API_EXPORT iree_status_t iree_hal_semaphore_wait(
   IREE_ASSERT_ARGUMENT(semaphore);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, value);
+
+  // Polling waits are not timed as they'd dominate the distribution and the
+  // clock query may cost more than the poll itself.
+  if (iree_timeout_is_immediate(timeout)) {
+    iree_status_t status =
+        _VTABLE_DISPATCH(semaphore, wait)(semaphore, value, timeout);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_metric_register(&iree_hal_semaphore_wait_duration.base);
+  iree_time_t start_time_ns = iree_time_now();
   iree_status_t status =
       _VTABLE_DISPATCH(semaphore, wait)(semaphore, value, timeout);
+  iree_metric_histogram_record(&iree_hal_semaphore_wait_duration,
+                               (uint64_t)(iree_time_now() - start_time_ns));
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
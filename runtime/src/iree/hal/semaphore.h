@@ -78,6 +78,72 @@ typedef struct iree_hal_device_t iree_hal_device_t;
 // https://docs.microsoft.com/en-us/windows/win32/direct3d12/user-mode-heap-synchronization
 typedef struct iree_hal_semaphore_t iree_hal_semaphore_t;
 
+// Describes the type of an external semaphore handle.
+// External semaphores allow timelines to be shared across devices, drivers,
+// and processes so that device->device handoffs can happen without waking the
+// host. Imported semaphores observe the same payload as the semaphore they
+// were exported from.
+//
+// The Vulkan documentation on external semaphores covers the design:
+// https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/VK_KHR_external_semaphore.html
+typedef enum iree_hal_external_semaphore_type_e {
+  IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_NONE = 0,
+
+  // A driver/device-specific POSIX file descriptor referencing a timeline
+  // semaphore. The handle supports dup, dup2, close, and transport using the
+  // SCM_RIGHTS control message. All other usage with system APIs is undefined.
+  // The caller owns exported file descriptors and retains ownership of the
+  // file descriptor passed on import; it may be closed as soon as the import
+  // returns.
+  //
+  // CUDA:
+  //  Import only; requires device support.
+  //  Uses CU_EXTERNAL_SEMAPHORE_HANDLE_TYPE_TIMELINE_SEMAPHORE_FD.
+  //
+  // Vulkan:
+  //  Requires VK_KHR_external_semaphore_fd.
+  //  Uses VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT.
+  IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD,
+
+  // A driver/device-specific Win32 HANDLE referencing a timeline semaphore.
+  // The handle supports DuplicateHandle, CompareObjectHandles, CloseHandle, and
+  // Get/SetHandleInformation. All other usage with system APIs is undefined.
+  //
+  // CUDA:
+  //  Import only; requires device support.
+  //  Uses CU_EXTERNAL_SEMAPHORE_HANDLE_TYPE_TIMELINE_SEMAPHORE_WIN32.
+  //
+  // Vulkan:
+  //  Requires VK_KHR_external_semaphore_win32.
+  //  Uses VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_WIN32_BIT.
+  IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_WIN32,
+} iree_hal_external_semaphore_type_t;
+
+// Flags for controlling iree_hal_external_semaphore_t implementation details.
+enum iree_hal_external_semaphore_flag_bits_t {
+  IREE_HAL_EXTERNAL_SEMAPHORE_FLAG_NONE = 0u,
+};
+typedef uint32_t iree_hal_external_semaphore_flags_t;
+
+// Handle to a typed external semaphore.
+// See the type enum for ownership information.
+typedef struct iree_hal_external_semaphore_t {
+  // Type of the resource used to interpret the handle.
+  iree_hal_external_semaphore_type_t type;
+  // Flags indicating semaphore compatibility.
+  iree_hal_external_semaphore_flags_t flags;
+  union {
+    // IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_FD
+    struct {
+      int fd;
+    } opaque_fd;
+    // IREE_HAL_EXTERNAL_SEMAPHORE_TYPE_OPAQUE_WIN32
+    struct {
+      void* handle;
+    } opaque_win32;
+  } handle;
+} iree_hal_external_semaphore_t;
+
 // Creates a semaphore that can be used with command queues owned by this
 // device. To use the semaphores with other devices or instances they must
 // first be exported.
@@ -85,6 +151,38 @@ IREE_API_EXPORT iree_status_t
 iree_hal_semaphore_create(iree_hal_device_t* device, uint64_t initial_value,
                           iree_hal_semaphore_t** out_semaphore);
 
+// Imports an |external_semaphore| exported from another semaphore (possibly
+// from another device, driver, or process) such that it can be used with
+// command queues owned by |device|. Queue operations on |device| waiting on or
+// signaling the returned semaphore are ordered on the device without host
+// involvement when supported by the implementation.
+//
+// Imported semaphores may not support host operations on all implementations;
+// use iree_hal_device_query_semaphore_compatibility to check and prefer
+// performing host waits and signals on the semaphore that was exported.
+//
+// Fails with IREE_STATUS_UNAVAILABLE if the device cannot import the
+// semaphore type.
+IREE_API_EXPORT iree_status_t iree_hal_semaphore_import(
+    iree_hal_device_t* device,
+    const iree_hal_external_semaphore_t* external_semaphore,
+    iree_hal_external_semaphore_flags_t flags,
+    iree_hal_semaphore_t** out_semaphore);
+
+// Exports |semaphore| to an external semaphore handle of |requested_type|.
+// See the notes on iree_hal_external_semaphore_type_t for ownership
+// information. The |semaphore| must remain live for as long as any semaphores
+// imported from the exported handle are in use.
+//
+// Fails with IREE_STATUS_UNAVAILABLE if the semaphore cannot be exported to
+// the requested type. This may be due to unavailable device/platform
+// capabilities or how the semaphore was created.
+IREE_API_EXPORT iree_status_t iree_hal_semaphore_export(
+    iree_hal_semaphore_t* semaphore,
+    iree_hal_external_semaphore_type_t requested_type,
+    iree_hal_external_semaphore_flags_t requested_flags,
+    iree_hal_external_semaphore_t* out_external_semaphore);
+
 // Retains the given |semaphore| for the caller.
 IREE_API_EXPORT void iree_hal_semaphore_retain(iree_hal_semaphore_t* semaphore);
 
@@ -204,6 +302,13 @@ typedef struct iree_hal_semaphore_vtable_t {
 
   iree_status_t(IREE_API_PTR* wait)(iree_hal_semaphore_t* semaphore,
                                     uint64_t value, iree_timeout_t timeout);
+
+  // Optional; semaphores that cannot be exported may leave this NULL.
+  iree_status_t(IREE_API_PTR* export_semaphore)(
+      iree_hal_semaphore_t* semaphore,
+      iree_hal_external_semaphore_type_t requested_type,
+      iree_hal_external_semaphore_flags_t requested_flags,
+      iree_hal_external_semaphore_t* out_external_semaphore);
 } iree_hal_semaphore_vtable_t;
 IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_semaphore_vtable_t);
 
@@ -128,6 +128,12 @@ IREE_API_EXPORT iree_status_t iree_hal_parse_element_type(
     numerical_type = IREE_HAL_NUMERICAL_TYPE_BOOLEAN;
     *out_element_type = iree_hal_make_element_type(numerical_type, 8);
     return iree_ok_status();
+  } else if (iree_string_view_equal(str_value, IREE_SV("f8E5M2"))) {
+    *out_element_type = IREE_HAL_ELEMENT_TYPE_FLOAT_8_E5M2;
+    return iree_ok_status();
+  } else if (iree_string_view_equal(str_value, IREE_SV("f8E4M3FN"))) {
+    *out_element_type = IREE_HAL_ELEMENT_TYPE_FLOAT_8_E4M3_FN;
+    return iree_ok_status();
   } else if (iree_string_view_consume_prefix(&str_value, IREE_SV("i"))) {
     numerical_type = IREE_HAL_NUMERICAL_TYPE_INTEGER;
   } else if (iree_string_view_consume_prefix(&str_value, IREE_SV("si"))) {
@@ -169,6 +175,7 @@ IREE_API_EXPORT iree_status_t iree_hal_format_element_type(
   }
   const char* prefix;
   int32_t bit_count = (int32_t)iree_hal_element_bit_count(element_type);
+  bool has_bit_count = true;
   switch (iree_hal_element_numerical_type(element_type)) {
     case IREE_HAL_NUMERICAL_TYPE_BOOLEAN:
       prefix = "i";
@@ -192,11 +199,22 @@ IREE_API_EXPORT iree_status_t iree_hal_format_element_type(
     case IREE_HAL_NUMERICAL_TYPE_FLOAT_COMPLEX:
       prefix = "cf";
       break;
+    case IREE_HAL_NUMERICAL_TYPE_FLOAT_8_E5M2:
+      prefix = "f8E5M2";
+      has_bit_count = false;
+      break;
+    case IREE_HAL_NUMERICAL_TYPE_FLOAT_8_E4M3_FN:
+      prefix = "f8E4M3FN";
+      has_bit_count = false;
+      break;
     default:
       prefix = "*";
       break;
   }
-  int n = snprintf(buffer, buffer_capacity, "%s%d", prefix, bit_count);
+  // Some type names already include their bit count.
+  int n = has_bit_count
+              ? snprintf(buffer, buffer_capacity, "%s%d", prefix, bit_count)
+              : snprintf(buffer, buffer_capacity, "%s", prefix);
   if (n < 0) {
     return iree_make_status(IREE_STATUS_FAILED_PRECONDITION, "snprintf failed");
   }
@@ -210,7 +228,7 @@ IREE_API_EXPORT iree_status_t iree_hal_format_element_type(
 IREE_API_EXPORT iree_status_t
 iree_hal_append_element_type_string(iree_hal_element_type_t element_type,
                                     iree_string_builder_t* string_builder) {
-  char temp[8];
+  char temp[16];
   iree_host_size_t length = 0;
   IREE_RETURN_IF_ERROR(
       iree_hal_format_element_type(element_type, sizeof(temp), temp, &length));
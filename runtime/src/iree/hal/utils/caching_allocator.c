@@ -6,11 +6,24 @@
 
 #include "iree/hal/utils/caching_allocator.h"
 
+#include "iree/base/internal/math.h"
 #include "iree/base/internal/synchronization.h"
+#include "iree/base/metrics.h"
 
 // Default capacity of a pool free list when not specified by the user.
 #define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY 64
 
+// Smallest slab size class in bytes.
+#define IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS 256
+
+// Maximum number of slab size classes in a pool. With four classes per power
+// of two this covers slots from 256B to 16MB.
+#define IREE_HAL_CACHING_ALLOCATOR_MAX_SIZE_CLASS_COUNT 64
+
+// Minimum number of slots per slab block used to derive the maximum slab
+// allocation size when not specified.
+#define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_SLAB_SLOT_COUNT 8
+
 //===----------------------------------------------------------------------===//
 // iree_hal_caching_allocator_pool_t
 //===----------------------------------------------------------------------===//
@@ -18,6 +31,14 @@
 IREE_TRACE(
     static const char* IREE_HAL_CACHING_ALLOCATOR_ID = "Free Cached Memory");
 
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_hal_caching_allocator_hits, "iree_hal_caching_allocator_hits_total",
+    "Total number of allocations serviced from a caching allocator pool.");
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_hal_caching_allocator_misses,
+    "iree_hal_caching_allocator_misses_total",
+    "Total number of caching allocator pool allocations that allocated.");
+
 void iree_hal_caching_allocator_pool_params_initialize(
     iree_hal_allocator_memory_heap_t heap,
     iree_hal_caching_allocator_pool_params_t* out_params) {
@@ -30,9 +51,40 @@ void iree_hal_caching_allocator_pool_params_initialize(
       IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY;
 }
 
+// A device block carved into equally-sized slots of a single size class.
+// Slots are handed out as subspans of the block. Subspans derived from a slot
+// reference the block directly and may outlive the slot so released slots are
+// pending until the block is referenced only by the slab and its live slots.
+typedef struct iree_hal_caching_allocator_slab_t {
+  struct iree_hal_caching_allocator_slab_t* next;
+  // Device block the slots are carved from. Retained.
+  iree_hal_buffer_t* block;
+  // Size in bytes of each slot.
+  iree_device_size_t slot_size;
+  // Total number of slots in the block.
+  iree_host_size_t slot_count;
+  // Number of slots currently handed out.
+  iree_host_size_t live_count;
+  // Number of released slots not yet available for reuse.
+  iree_host_size_t pending_count;
+  // Bitmaps of available and pending slots with |word_count| words each.
+  iree_host_size_t word_count;
+  uint64_t* free_bits;
+  uint64_t* pending_bits;
+} iree_hal_caching_allocator_slab_t;
+
+// A slot handed out from a slab.
+typedef struct iree_hal_caching_allocator_slot_buffer_t {
+  // Subspan of the slab block; must be at 0.
+  iree_hal_buffer_t base;
+  struct iree_hal_caching_allocator_pool_t* pool;
+  iree_hal_caching_allocator_slab_t* slab;
+} iree_hal_caching_allocator_slot_buffer_t;
+
 // Pool of arbitrarily-sized device allocations for a particular heap.
 // This maintains a free list of blocks available for use but does not track
-// outstanding allocations.
+// outstanding allocations. Allocations that fit a size class are instead
+// carved out of slabs when enabled.
 //
 // Thread-safe. Pools can service requests from multiple threads concurrently by
 // way of a pool-specific mutex. The mutex will not be held during underlying
@@ -63,6 +115,39 @@ typedef iree_alignas(
   // Total size, in bytes, of all free buffers currently in this pool.
   iree_device_size_t free_allocated_size;
 
+  // Host allocator used for slabs and slot buffers.
+  iree_allocator_t host_allocator;
+
+  // Allocator slot buffers are returned to when released.
+  // Unretained as it owns the pool.
+  iree_hal_allocator_t* base_allocator;
+
+  // Ascending slab size classes in bytes; empty if slabs are disabled.
+  iree_host_size_t size_class_count;
+  iree_device_size_t
+      size_classes[IREE_HAL_CACHING_ALLOCATOR_MAX_SIZE_CLASS_COUNT];
+
+  // Slabs for each size class with the most recently created first.
+  iree_hal_caching_allocator_slab_t*
+      slabs[IREE_HAL_CACHING_ALLOCATOR_MAX_SIZE_CLASS_COUNT];
+
+  // Total size, in bytes, of all slab blocks.
+  iree_device_size_t slab_reserved_size;
+  // Total size, in bytes, of all live slots.
+  iree_device_size_t slab_used_size;
+  // Total size, in bytes, requested by the allocations in the live slots.
+  iree_device_size_t slab_requested_size;
+
+  // Number of allocations serviced with and without allocating memory.
+  uint64_t hit_count;
+  uint64_t miss_count;
+
+  // Bytes of pool memory assigned to live allocations per
+  // iree_hal_allocation_tag_t. Pool storage is allocated untagged from the
+  // device allocator so that reused memory is attributed to its current user.
+  iree_hal_allocator_tag_statistics_t
+      tag_statistics[IREE_HAL_ALLOCATION_TAG_COUNT];
+
   // Flat MRU list of available buffers with max_free_allocation_count slots.
   // Sorted by ascending recency (the higher the index the more recent).
   // If we really cared about optimizing the interior removal then we'd want
@@ -75,20 +160,57 @@ typedef iree_alignas(
 static void iree_hal_caching_allocator_pool_trim(
     iree_hal_caching_allocator_pool_t* pool);
 
+// Populates the slab size classes of |pool| based on its parameters.
+// Classes are powers of two with three evenly spaced intermediate classes
+// (256, 320, 384, 448, 512, 640, ...) rounded up to the heap alignment.
+static void iree_hal_caching_allocator_pool_initialize_size_classes(
+    iree_hal_caching_allocator_pool_t* pool) {
+  pool->size_class_count = 0;
+  const iree_device_size_t block_size = pool->params.slab_block_size;
+  if (!block_size) return;
+  iree_device_size_t max_size = pool->params.slab_max_allocation_size;
+  if (!max_size) {
+    max_size = block_size / IREE_HAL_CACHING_ALLOCATOR_DEFAULT_SLAB_SLOT_COUNT;
+  }
+  max_size = iree_min(max_size, block_size);
+  if (pool->params.max_allocation_size) {
+    max_size = iree_min(max_size, pool->params.max_allocation_size);
+  }
+  const iree_device_size_t alignment =
+      iree_max(pool->params.heap.min_alignment, 1);
+  iree_device_size_t octave = IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS;
+  for (iree_device_size_t size = octave;
+       size <= max_size &&
+       pool->size_class_count < IREE_HAL_CACHING_ALLOCATOR_MAX_SIZE_CLASS_COUNT;
+       size += octave / 4) {
+    if (size >= octave * 2) octave *= 2;
+    const iree_device_size_t class_size = iree_device_align(size, alignment);
+    if (class_size > max_size) break;
+    if (pool->size_class_count > 0 &&
+        pool->size_classes[pool->size_class_count - 1] >= class_size) {
+      continue;  // merged with the previous class by alignment
+    }
+    pool->size_classes[pool->size_class_count++] = class_size;
+  }
+}
+
 // Initializes a buffer pool in |out_pool|.
-// Buffer device storage will be allocated from |device_allocator|.
+// Buffer device storage will be allocated from |device_allocator| and slot
+// buffers will be returned to |base_allocator| when released.
 static void iree_hal_caching_allocator_pool_initialize(
     iree_hal_caching_allocator_pool_params_t params,
     iree_hal_allocator_t* device_allocator,
+    iree_hal_allocator_t* base_allocator, iree_allocator_t host_allocator,
     iree_hal_caching_allocator_pool_t* out_pool) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  memset(out_pool, 0, sizeof(*out_pool));
   out_pool->params = params;
   out_pool->device_allocator = device_allocator;
+  out_pool->base_allocator = base_allocator;
+  out_pool->host_allocator = host_allocator;
   iree_slim_mutex_initialize(&out_pool->mutex);
-  out_pool->total_allocated_size = 0;
-  out_pool->free_allocated_size = 0;
-  out_pool->free_count = 0;
+  iree_hal_caching_allocator_pool_initialize_size_classes(out_pool);
 
   IREE_TRACE_SET_PLOT_TYPE(IREE_HAL_CACHING_ALLOCATOR_ID,
                            IREE_TRACING_PLOT_TYPE_MEMORY, /*step=*/true,
@@ -113,6 +235,8 @@ static void iree_hal_caching_allocator_pool_deinitialize(
                  "must have released all allocations prior to deinit");
   IREE_ASSERT_EQ(pool->free_count, 0,
                  "must have released all allocations prior to deinit");
+  IREE_ASSERT_EQ(pool->slab_reserved_size, 0,
+                 "must have released all allocations prior to deinit");
 
   iree_slim_mutex_deinitialize(&pool->mutex);
 
@@ -224,12 +348,303 @@ static void iree_hal_caching_allocator_pool_trim_to_size(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns true if nothing other than the slab and its live slots references
+// the block of |slab| and any pending slots can be reused.
+//
+// Must be called with the pool mutex held.
+static bool iree_hal_caching_allocator_slab_is_unreferenced(
+    iree_hal_caching_allocator_slab_t* slab) {
+  return iree_atomic_ref_count_load(
+             &((iree_hal_resource_t*)slab->block)->ref_count) ==
+         1 + (int32_t)slab->live_count;
+}
+
+// Makes pending slots in the slabs of |class_index| available for reuse if
+// possible and unlinks empty slabs into |dead_slabs|. If |keep_empty| is set
+// the first empty slab is retained for future allocations.
+//
+// Must be called with the pool mutex held.
+static void iree_hal_caching_allocator_pool_sweep_slabs(
+    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t class_index,
+    bool keep_empty, iree_hal_caching_allocator_slab_t** dead_slabs) {
+  iree_hal_caching_allocator_slab_t** slab_ptr = &pool->slabs[class_index];
+  while (*slab_ptr) {
+    iree_hal_caching_allocator_slab_t* slab = *slab_ptr;
+    if (slab->pending_count > 0 &&
+        iree_hal_caching_allocator_slab_is_unreferenced(slab)) {
+      for (iree_host_size_t i = 0; i < slab->word_count; ++i) {
+        slab->free_bits[i] |= slab->pending_bits[i];
+        slab->pending_bits[i] = 0;
+      }
+      slab->pending_count = 0;
+    }
+    if (slab->live_count == 0 && slab->pending_count == 0) {
+      if (keep_empty) {
+        keep_empty = false;
+      } else {
+        *slab_ptr = slab->next;
+        slab->next = *dead_slabs;
+        *dead_slabs = slab;
+        pool->slab_reserved_size -=
+            iree_hal_buffer_allocation_size(slab->block);
+        continue;
+      }
+    }
+    slab_ptr = &slab->next;
+  }
+}
+
+// Releases the |dead_slabs| list and their blocks.
+//
+// The pool mutex must not be held by the caller as deallocation can be slow.
+static void iree_hal_caching_allocator_pool_free_slabs(
+    iree_hal_caching_allocator_pool_t* pool,
+    iree_hal_caching_allocator_slab_t* dead_slabs) {
+  while (dead_slabs) {
+    iree_hal_caching_allocator_slab_t* next = dead_slabs->next;
+    iree_hal_buffer_release(dead_slabs->block);
+    iree_allocator_free(pool->host_allocator, dead_slabs);
+    dead_slabs = next;
+  }
+}
+
 // Releases all unused buffers in |pool| to the underlying device allocator.
 //
 // The pool mutex must not be held by the caller.
 static void iree_hal_caching_allocator_pool_trim(
     iree_hal_caching_allocator_pool_t* pool) {
   iree_hal_caching_allocator_pool_trim_to_size(pool, 0);
+
+  iree_hal_caching_allocator_slab_t* dead_slabs = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  for (iree_host_size_t i = 0; i < pool->size_class_count; ++i) {
+    iree_hal_caching_allocator_pool_sweep_slabs(pool, i, /*keep_empty=*/false,
+                                                &dead_slabs);
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_hal_caching_allocator_pool_free_slabs(pool, dead_slabs);
+}
+
+// Selects the smallest slab size class in |pool| that can hold
+// |allocation_size| bytes. Returns false if slabs are disabled or the
+// allocation is too large.
+static bool iree_hal_caching_allocator_pool_select_size_class(
+    iree_hal_caching_allocator_pool_t* pool, iree_device_size_t allocation_size,
+    iree_host_size_t* out_class_index) {
+  for (iree_host_size_t i = 0; i < pool->size_class_count; ++i) {
+    if (pool->size_classes[i] >= allocation_size) {
+      *out_class_index = i;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns a slab in |class_index| compatible with |params| that has an
+// available slot or NULL if none exists.
+//
+// Must be called with the pool mutex held.
+static iree_hal_caching_allocator_slab_t*
+iree_hal_caching_allocator_pool_find_slab(
+    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t class_index,
+    const iree_hal_buffer_params_t* params) {
+  for (iree_hal_caching_allocator_slab_t* slab = pool->slabs[class_index];
+       slab != NULL; slab = slab->next) {
+    if (slab->live_count + slab->pending_count < slab->slot_count &&
+        iree_all_bits_set(iree_hal_buffer_memory_type(slab->block),
+                          params->type) &&
+        iree_all_bits_set(iree_hal_buffer_allowed_usage(slab->block),
+                          params->usage)) {
+      return slab;
+    }
+  }
+  return NULL;
+}
+
+// Takes an available slot from |slab| and initializes |slot_buffer| as a
+// subspan of |allocation_size| bytes referencing it.
+//
+// Must be called with the pool mutex held.
+static void iree_hal_caching_allocator_pool_take_slot(
+    iree_hal_caching_allocator_pool_t* pool,
+    iree_hal_caching_allocator_slab_t* slab, iree_hal_allocation_tag_t tag,
+    iree_device_size_t allocation_size,
+    iree_hal_caching_allocator_slot_buffer_t* slot_buffer) {
+  iree_host_size_t slot_index = 0;
+  for (iree_host_size_t i = 0; i < slab->word_count; ++i) {
+    if (slab->free_bits[i]) {
+      const int bit = iree_math_count_trailing_zeros_u64(slab->free_bits[i]);
+      slab->free_bits[i] &= ~(1ull << bit);
+      slot_index = i * 64 + bit;
+      break;
+    }
+  }
+  ++slab->live_count;
+  pool->slab_used_size += slab->slot_size;
+  pool->slab_requested_size += allocation_size;
+  iree_hal_subspan_buffer_initialize(
+      slab->block, slot_index * slab->slot_size, allocation_size,
+      pool->base_allocator, pool->host_allocator, &slot_buffer->base);
+  slot_buffer->base.allocation_tag = tag;
+  slot_buffer->pool = pool;
+  slot_buffer->slab = slab;
+  iree_hal_allocator_statistics_record_tag_alloc(pool->tag_statistics, tag,
+                                                 slab->slot_size);
+}
+
+// Allocates a new slab for |class_index| with a block compatible with
+// |params|.
+static iree_status_t iree_hal_caching_allocator_pool_allocate_slab(
+    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t class_index,
+    const iree_hal_buffer_params_t* params,
+    iree_hal_caching_allocator_slab_t** out_slab) {
+  const iree_device_size_t slot_size = pool->size_classes[class_index];
+  const iree_host_size_t slot_count =
+      (iree_host_size_t)(pool->params.slab_block_size / slot_size);
+  const iree_host_size_t word_count = iree_host_size_ceil_div(slot_count, 64);
+
+  iree_hal_caching_allocator_slab_t* slab = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      pool->host_allocator, sizeof(*slab) + 2 * word_count * sizeof(uint64_t),
+      (void**)&slab));
+  slab->next = NULL;
+  slab->slot_size = slot_size;
+  slab->slot_count = slot_count;
+  slab->live_count = 0;
+  slab->pending_count = 0;
+  slab->word_count = word_count;
+  slab->free_bits = (uint64_t*)((uint8_t*)slab + sizeof(*slab));
+  slab->pending_bits = slab->free_bits + word_count;
+  for (iree_host_size_t i = 0; i < word_count; ++i) {
+    const iree_host_size_t bit_count = iree_min(slot_count - i * 64, 64);
+    slab->free_bits[i] = bit_count == 64 ? UINT64_MAX : (1ull << bit_count) - 1;
+    slab->pending_bits[i] = 0;
+  }
+
+  iree_hal_buffer_params_t block_params = *params;
+  block_params.tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      pool->device_allocator, block_params, pool->params.slab_block_size,
+      &slab->block);
+  if (iree_status_is_ok(status)) {
+    *out_slab = slab;
+  } else {
+    iree_allocator_free(pool->host_allocator, slab);
+  }
+  return status;
+}
+
+// Acquires a slot of size class |class_index| for an allocation of
+// |allocation_size| bytes. Returns a NULL |out_buffer| if a new slab would be
+// required but the pool is at capacity.
+//
+// Thread-safe; multiple threads may concurrently access the |pool|.
+static iree_status_t iree_hal_caching_allocator_pool_acquire_slot(
+    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t class_index,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+  *out_buffer = NULL;
+
+  iree_hal_caching_allocator_slot_buffer_t* slot_buffer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(pool->host_allocator, sizeof(*slot_buffer),
+                                (void**)&slot_buffer));
+
+  // Reuse a slot from an existing slab if possible. If a new slab is needed
+  // its block is accounted for before allocating so that other threads
+  // allocating at the same time respect the capacity.
+  const iree_device_size_t block_size = pool->params.slab_block_size;
+  iree_hal_caching_allocator_slab_t* dead_slabs = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_caching_allocator_pool_sweep_slabs(pool, class_index,
+                                              /*keep_empty=*/true, &dead_slabs);
+  iree_hal_caching_allocator_slab_t* slab =
+      iree_hal_caching_allocator_pool_find_slab(pool, class_index, params);
+  bool under_capacity = false;
+  if (slab) {
+    ++pool->hit_count;
+    iree_hal_caching_allocator_pool_take_slot(pool, slab, params->tag,
+                                              allocation_size, slot_buffer);
+  } else {
+    const iree_device_size_t committed_size =
+        pool->total_allocated_size + pool->slab_reserved_size;
+    const iree_device_size_t max_capacity =
+        pool->params.max_allocation_capacity;
+    under_capacity = committed_size <= max_capacity &&
+                     max_capacity - committed_size >= block_size;
+    if (under_capacity) {
+      ++pool->miss_count;
+      pool->slab_reserved_size += block_size;
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_hal_caching_allocator_pool_free_slabs(pool, dead_slabs);
+  if (slab) {
+    iree_metric_counter_increment(&iree_hal_caching_allocator_hits);
+    *out_buffer = &slot_buffer->base;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  } else if (!under_capacity) {
+    iree_allocator_free(pool->host_allocator, slot_buffer);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  // Allocate a new slab without holding the lock as the underlying device
+  // allocator can be very slow.
+  iree_metric_counter_increment(&iree_hal_caching_allocator_misses);
+  iree_status_t status = iree_hal_caching_allocator_pool_allocate_slab(
+      pool, class_index, params, &slab);
+  iree_slim_mutex_lock(&pool->mutex);
+  if (iree_status_is_ok(status)) {
+    slab->next = pool->slabs[class_index];
+    pool->slabs[class_index] = slab;
+    iree_hal_caching_allocator_pool_take_slot(pool, slab, params->tag,
+                                              allocation_size, slot_buffer);
+  } else {
+    pool->slab_reserved_size -= block_size;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (iree_status_is_ok(status)) {
+    *out_buffer = &slot_buffer->base;
+  } else {
+    iree_allocator_free(pool->host_allocator, slot_buffer);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Releases |slot_buffer| back to its slab. The slot is pending until nothing
+// derived from it references the slab block.
+//
+// Thread-safe; multiple threads may concurrently access the pool.
+static void iree_hal_caching_allocator_pool_release_slot(
+    iree_hal_caching_allocator_slot_buffer_t* slot_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_caching_allocator_pool_t* pool = slot_buffer->pool;
+  iree_hal_caching_allocator_slab_t* slab = slot_buffer->slab;
+  const iree_host_size_t slot_index = (iree_host_size_t)(
+      iree_hal_buffer_byte_offset(&slot_buffer->base) / slab->slot_size);
+
+  iree_slim_mutex_lock(&pool->mutex);
+  slab->pending_bits[slot_index / 64] |= 1ull << (slot_index % 64);
+  ++slab->pending_count;
+  --slab->live_count;
+  pool->slab_used_size -= slab->slot_size;
+  pool->slab_requested_size -=
+      iree_hal_buffer_byte_length(&slot_buffer->base);
+  iree_hal_allocator_statistics_record_tag_free(
+      pool->tag_statistics,
+      iree_hal_buffer_allocation_tag(&slot_buffer->base), slab->slot_size);
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  // Drops the slot reference to the block and frees the slot buffer.
+  iree_hal_buffer_destroy(&slot_buffer->base);
+
+  IREE_TRACE_ZONE_END(z0);
 }
 
 // Acquires a buffer of |allocation_size| from the |pool|.
@@ -250,19 +665,29 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
   iree_hal_buffer_t* existing_buffer =
       iree_hal_caching_allocator_pool_find_and_take_buffer(pool, params,
                                                            allocation_size);
-  if (!existing_buffer) {
+  if (existing_buffer) {
+    ++pool->hit_count;
+    existing_buffer->allocation_tag = params->tag;
+    iree_hal_allocator_statistics_record_tag_alloc(
+        pool->tag_statistics, params->tag,
+        iree_hal_buffer_allocation_size(existing_buffer));
+  } else {
     // We'll need to allocate so we add the size such that it'll be accounted
     // for by other threads allocating at the same time.
+    ++pool->miss_count;
     pool->total_allocated_size += allocation_size;
   }
   iree_slim_mutex_unlock(&pool->mutex);
   if (existing_buffer) {
     // Found a buffer! Return it uninitialized.
+    iree_metric_counter_increment(&iree_hal_caching_allocator_hits);
     *out_buffer = existing_buffer;
     IREE_TRACE_ZONE_END(z0);
     return iree_ok_status();
   }
 
+  iree_metric_counter_increment(&iree_hal_caching_allocator_misses);
+
   // Trim first before allocating so that we don't go over peak.
   iree_hal_caching_allocator_pool_trim_to_size(
       pool, pool->params.max_allocation_capacity);
@@ -272,11 +697,19 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
   // device allocator can be very slow. It's possible for buffers to be released
   // to the pool by another thread while we're allocating here but that's OK.
   iree_hal_buffer_t* buffer = NULL;
+  iree_hal_buffer_params_t storage_params = *params;
+  storage_params.tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
   iree_status_t status = iree_hal_allocator_allocate_buffer(
-      pool->device_allocator, *params, allocation_size, &buffer);
+      pool->device_allocator, storage_params, allocation_size, &buffer);
 
   // If the allocation failed then remove the size from the total.
   if (iree_status_is_ok(status)) {
+    iree_slim_mutex_lock(&pool->mutex);
+    buffer->allocation_tag = params->tag;
+    iree_hal_allocator_statistics_record_tag_alloc(
+        pool->tag_statistics, params->tag,
+        iree_hal_buffer_allocation_size(buffer));
+    iree_slim_mutex_unlock(&pool->mutex);
     *out_buffer = buffer;
   } else {
     if (buffer) iree_hal_buffer_release(buffer);
@@ -304,6 +737,13 @@ static void iree_hal_caching_allocator_pool_release(
 
   const iree_device_size_t allocation_size =
       iree_hal_buffer_allocation_size(buffer);
+
+  // Storage in the pool (or returned to the device allocator) is untagged.
+  iree_hal_allocator_statistics_record_tag_free(
+      pool->tag_statistics, iree_hal_buffer_allocation_tag(buffer),
+      allocation_size);
+  buffer->allocation_tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN;
+
   const bool under_capacity = pool->total_allocated_size - allocation_size <=
                               pool->params.max_allocation_capacity;
   const bool under_count =
@@ -396,6 +836,9 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
   IREE_ASSERT_ARGUMENT(out_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_metric_register(&iree_hal_caching_allocator_hits.base);
+  iree_metric_register(&iree_hal_caching_allocator_misses.base);
+
   // Allocate the allocator itself and then a trailing list of variable-length
   // pools based on their free list sizes.
   iree_hal_caching_allocator_t* allocator = NULL;
@@ -432,8 +875,9 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
                             pool_params[i].max_free_allocation_count,
         iree_max_align_t);
     allocator->pools[i] = pool;
-    iree_hal_caching_allocator_pool_initialize(pool_params[i], device_allocator,
-                                               pool);
+    iree_hal_caching_allocator_pool_initialize(
+        pool_params[i], device_allocator, (iree_hal_allocator_t*)allocator,
+        host_allocator, pool);
   }
 
   *out_allocator = (iree_hal_allocator_t*)allocator;
@@ -547,12 +991,15 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t max_allocation_size_str = iree_string_view_empty();
     iree_string_view_t max_allocation_capacity_str = iree_string_view_empty();
     iree_string_view_t max_free_allocation_count_str = iree_string_view_empty();
+    iree_string_view_t slab_block_size_str = iree_string_view_empty();
     iree_string_view_split(pool_config, ';', &max_allocation_size_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_allocation_capacity_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_free_allocation_count_str,
                            &pool_config);
+    iree_string_view_split(pool_config, ';', &slab_block_size_str,
+                           &pool_config);
     max_allocation_size_str = iree_string_view_trim(max_allocation_size_str);
     if (!iree_string_view_is_empty(max_allocation_size_str) &&
         !iree_string_view_equal(max_allocation_size_str, IREE_SV("*"))) {
@@ -584,6 +1031,13 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
       }
       pool_params->max_free_allocation_count = max_free_allocation_count;
     }
+    slab_block_size_str = iree_string_view_trim(slab_block_size_str);
+    if (!iree_string_view_is_empty(slab_block_size_str)) {
+      IREE_RETURN_IF_ERROR(
+          iree_string_view_parse_device_size(slab_block_size_str,
+                                             &pool_params->slab_block_size),
+          "parsing slab_block_size");
+    }
   } while (!iree_string_view_is_empty(config_pairs));
   return iree_hal_caching_allocator_create_with_pools(
       pool_count, pool_params_storage, device_allocator, host_allocator,
@@ -633,6 +1087,35 @@ static void iree_hal_caching_allocator_query_statistics(
       iree_hal_caching_allocator_cast(base_allocator);
   iree_hal_allocator_query_statistics(allocator->device_allocator,
                                       out_statistics);
+#if IREE_STATISTICS_ENABLE
+  for (iree_host_size_t i = 0; i < allocator->pool_count; ++i) {
+    iree_hal_caching_allocator_pool_t* pool = allocator->pools[i];
+    iree_slim_mutex_lock(&pool->mutex);
+    out_statistics->pool_hits += pool->hit_count;
+    out_statistics->pool_misses += pool->miss_count;
+    out_statistics->pool_bytes_reserved +=
+        pool->total_allocated_size + pool->slab_reserved_size;
+    // Free list allocations are exact so there's no internal fragmentation.
+    const iree_device_size_t list_used_size =
+        pool->total_allocated_size - pool->free_allocated_size;
+    out_statistics->pool_bytes_used += list_used_size + pool->slab_used_size;
+    out_statistics->pool_bytes_requested +=
+        list_used_size + pool->slab_requested_size;
+    // Pool storage is untagged in the device allocator and instead attributed
+    // to the tags of the live allocations using it.
+    iree_hal_allocator_tag_statistics_t* unknown_statistics =
+        &out_statistics->tags[IREE_HAL_ALLOCATION_TAG_UNKNOWN];
+    unknown_statistics->bytes_live -=
+        iree_min(unknown_statistics->bytes_live,
+                 pool->total_allocated_size + pool->slab_reserved_size);
+    for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(pool->tag_statistics);
+         ++j) {
+      out_statistics->tags[j].bytes_live += pool->tag_statistics[j].bytes_live;
+      out_statistics->tags[j].bytes_peak += pool->tag_statistics[j].bytes_peak;
+    }
+    iree_slim_mutex_unlock(&pool->mutex);
+  }
+#endif  // IREE_STATISTICS_ENABLE
 }
 
 static iree_status_t iree_hal_caching_allocator_query_memory_heaps(
@@ -725,6 +1208,16 @@ static iree_status_t iree_hal_caching_allocator_allocate_buffer(
                                               out_buffer);
   }
 
+  // Allocations that fit a size class are carved from slabs. If the pool is at
+  // capacity and can't create a new slab the free list is used instead.
+  iree_host_size_t class_index = 0;
+  if (iree_hal_caching_allocator_pool_select_size_class(pool, allocation_size,
+                                                        &class_index)) {
+    IREE_RETURN_IF_ERROR(iree_hal_caching_allocator_pool_acquire_slot(
+        pool, class_index, &compat_params, allocation_size, out_buffer));
+    if (*out_buffer) return iree_ok_status();
+  }
+
   // Acquire the buffer from the pool.
   IREE_RETURN_IF_ERROR(iree_hal_caching_allocator_pool_acquire(
       pool, &compat_params, allocation_size, out_buffer));
@@ -741,6 +1234,13 @@ static void iree_hal_caching_allocator_deallocate_buffer(
   iree_hal_caching_allocator_t* allocator =
       iree_hal_caching_allocator_cast(base_allocator);
 
+  // Slab slots are the only subspans we allocate and know their pool.
+  if (iree_hal_buffer_allocated_buffer(buffer) != buffer) {
+    iree_hal_caching_allocator_pool_release_slot(
+        (iree_hal_caching_allocator_slot_buffer_t*)buffer);
+    return;
+  }
+
   // Try to find the pool we would want to release the buffer into.
   // Note that we are only going to get called if we had successfully placed the
   // buffer into a pool.
@@ -22,6 +22,13 @@ extern "C" {
 // device-local and host-visible buffers on devices with discrete memory.
 // Pools are scanned in-order to allow for prioritization.
 //
+// Pools may optionally carve large device blocks into slabs of fixed-size
+// slots. Allocation sizes are rounded up to the nearest size class (powers of
+// two with three intermediate classes each) so that requests with slightly
+// different sizes, as is common with dynamic shapes, share cached memory
+// instead of missing the free list. Pool hit rates and fragmentation are
+// reported via iree_hal_allocator_query_statistics.
+//
 // Thread-safe: the allocator can be shared across multiple user-level devices
 // manipulated from multiple threads.
 typedef struct iree_hal_caching_allocator_t iree_hal_caching_allocator_t;
@@ -49,6 +56,16 @@ typedef struct iree_hal_caching_allocator_pool_params_t {
   // This is used to allocate storage for the free list and should be reasonably
   // bounded (~64-1024).
   iree_host_size_t max_free_allocation_count;
+
+  // Size in bytes of the device blocks carved into size-classed slabs or 0 to
+  // disable slab suballocation. Blocks count towards max_allocation_capacity
+  // and are only returned to the underlying allocator when trimmed.
+  iree_device_size_t slab_block_size;
+
+  // Maximum size of an allocation in bytes serviced from a slab. Larger
+  // allocations use the free list. If 0 a value ensuring each block holds at
+  // least a few slots is derived from slab_block_size.
+  iree_device_size_t slab_max_allocation_size;
 } iree_hal_caching_allocator_pool_params_t;
 
 // Initializes |out_params| to the default values using |heap| for storage.
@@ -100,11 +117,16 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
 // than 100MB can be retained. Wildcards can be used to indicate max values or
 // defaults.
 //
+// An optional fourth parameter enables slab suballocation with the given block
+// size.
+//
 // Expected form:
 //   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count
+//            [;slab_block_size]
 // Example:
 //   device_local=1gib;1gib;8
 //   host_local=*;*;32
+//   device_local=*;2gib;64;64mib
 iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
@@ -0,0 +1,122 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/prng.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/caching_allocator.h"
+#include "iree/testing/benchmark.h"
+
+// Number of allocations kept live at any time.
+#define IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_LIVE_COUNT 64
+
+// Creates a caching allocator over a heap allocator with a single pool.
+// Slabs are used if |slab_block_size| is non-zero.
+static iree_status_t iree_hal_caching_allocator_benchmark_create(
+    iree_device_size_t slab_block_size, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
+  iree_hal_allocator_t* device_allocator = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_create_heap(
+      iree_make_cstring_view("heap"), host_allocator, host_allocator,
+      &device_allocator));
+  iree_hal_allocator_memory_heap_t heaps[8];
+  iree_host_size_t heap_count = 0;
+  iree_status_t status = iree_hal_allocator_query_memory_heaps(
+      device_allocator, IREE_ARRAYSIZE(heaps), heaps, &heap_count);
+  if (iree_status_is_ok(status)) {
+    iree_hal_caching_allocator_pool_params_t pool_params;
+    iree_hal_caching_allocator_pool_params_initialize(heaps[0], &pool_params);
+    pool_params.slab_block_size = slab_block_size;
+    status = iree_hal_caching_allocator_create_with_pools(
+        1, &pool_params, device_allocator, host_allocator, out_allocator);
+  }
+  iree_hal_allocator_release(device_allocator);
+  return status;
+}
+
+// Simulates a dynamically shaped workload: a fixed number of allocations are
+// kept live and each iteration replaces a random one with an allocation of a
+// random size within +/-12.5% of a base size. Exact-size caching rarely hits
+// while size classes do.
+//
+// user_data is the slab block size or 0 to use only the free list.
+static iree_status_t iree_hal_caching_allocator_benchmark_dynamic_sizes(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_device_size_t slab_block_size =
+      (iree_device_size_t)(uintptr_t)benchmark_def->user_data;
+
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_CHECK_OK(iree_hal_caching_allocator_benchmark_create(
+      slab_block_size, host_allocator, &allocator));
+
+  iree_hal_buffer_params_t params = {
+      .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+      .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+  };
+  const iree_device_size_t base_size = 16 * 1024;
+
+  // The PRNG we use to select the allocations and their sizes.
+  iree_prng_xoroshiro128_state_t prng = {0};
+  iree_prng_xoroshiro128_initialize(123ull, &prng);
+
+  iree_hal_buffer_t*
+      buffers[IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_LIVE_COUNT] = {0};
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/256)) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t buffer_idx = iree_prng_xoroshiro128plus_next_uint32(&prng) %
+                            IREE_HAL_CACHING_ALLOCATOR_BENCHMARK_LIVE_COUNT;
+      iree_device_size_t allocation_size =
+          base_size - base_size / 8 +
+          iree_prng_xoroshiro128plus_next_uint32(&prng) % (base_size / 4);
+      iree_hal_buffer_release(buffers[buffer_idx]);
+      IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+          allocator, params, allocation_size, &buffers[buffer_idx]));
+    }
+  }
+
+  // Cleanup.
+  for (uint32_t i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    iree_hal_buffer_release(buffers[i]);
+  }
+  iree_hal_allocator_release(allocator);
+
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_caching_allocator_benchmark_dynamic_sizes
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_caching_allocator_benchmark_dynamic_sizes,
+    };
+    benchmark_def.user_data = (void*)0u;
+    iree_benchmark_register(iree_make_cstring_view("dynamic_sizes_free_list"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)(uintptr_t)(1024 * 1024);
+    iree_benchmark_register(iree_make_cstring_view("dynamic_sizes_slab_1mb"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)(uintptr_t)(4 * 1024 * 1024);
+    iree_benchmark_register(iree_make_cstring_view("dynamic_sizes_slab_4mb"),
+                            &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
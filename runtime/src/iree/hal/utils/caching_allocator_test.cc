@@ -0,0 +1,220 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/caching_allocator.h"
+
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class CachingAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+  }
+
+  void TearDown() override {
+    iree_hal_allocator_release(allocator_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  // Creates |allocator_| with a single pool using slabs of |slab_block_size|.
+  void CreateAllocator(iree_device_size_t slab_block_size) {
+    iree_hal_allocator_memory_heap_t heaps[8];
+    iree_host_size_t heap_count = 0;
+    IREE_ASSERT_OK(iree_hal_allocator_query_memory_heaps(
+        device_allocator_, IREE_ARRAYSIZE(heaps), heaps, &heap_count));
+    ASSERT_GT(heap_count, 0);
+    iree_hal_caching_allocator_pool_params_t pool_params;
+    iree_hal_caching_allocator_pool_params_initialize(heaps[0], &pool_params);
+    pool_params.slab_block_size = slab_block_size;
+    IREE_ASSERT_OK(iree_hal_caching_allocator_create_with_pools(
+        1, &pool_params, device_allocator_, iree_allocator_system(),
+        &allocator_));
+  }
+
+  iree_hal_buffer_t* Allocate(
+      iree_device_size_t allocation_size,
+      iree_hal_allocation_tag_t tag = IREE_HAL_ALLOCATION_TAG_UNKNOWN) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    params.tag = tag;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        allocator_, params, allocation_size, &buffer));
+    return buffer;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+TEST_F(CachingAllocatorTest, FreeListReusesExactSize) {
+  CreateAllocator(/*slab_block_size=*/0);
+  iree_hal_buffer_t* buffer_a = Allocate(1024);
+  iree_hal_buffer_release(buffer_a);
+  iree_hal_buffer_t* buffer_b = Allocate(1024);
+  EXPECT_EQ(buffer_a, buffer_b);
+  iree_hal_buffer_release(buffer_b);
+}
+
+TEST_F(CachingAllocatorTest, SlabSlotsShareBlock) {
+  CreateAllocator(/*slab_block_size=*/64 * 1024);
+  iree_hal_buffer_t* buffer_a = Allocate(1000);
+  iree_hal_buffer_t* buffer_b = Allocate(1000);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer_a), 1000);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer_a),
+            iree_hal_buffer_allocated_buffer(buffer_b));
+  EXPECT_EQ(iree_hal_buffer_test_overlap(buffer_a, 0, IREE_WHOLE_BUFFER,
+                                         buffer_b, 0, IREE_WHOLE_BUFFER),
+            IREE_HAL_BUFFER_OVERLAP_DISJOINT);
+  iree_hal_buffer_release(buffer_a);
+  iree_hal_buffer_release(buffer_b);
+}
+
+TEST_F(CachingAllocatorTest, SlabReusesSizeClass) {
+  CreateAllocator(/*slab_block_size=*/64 * 1024);
+  iree_hal_buffer_t* buffer_a = Allocate(1000);
+  iree_device_size_t offset_a = iree_hal_buffer_byte_offset(buffer_a);
+  iree_hal_buffer_release(buffer_a);
+
+  // A slightly different size falls in the same class and reuses the slot.
+  iree_hal_buffer_t* buffer_b = Allocate(1010);
+  EXPECT_EQ(iree_hal_buffer_byte_offset(buffer_b), offset_a);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer_b), 1010);
+  iree_hal_buffer_release(buffer_b);
+
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+#if IREE_STATISTICS_ENABLE
+  EXPECT_EQ(statistics.pool_hits, 1);
+  EXPECT_EQ(statistics.pool_misses, 1);
+  EXPECT_EQ(statistics.pool_bytes_reserved, 64 * 1024);
+  EXPECT_EQ(statistics.pool_bytes_used, 0);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+TEST_F(CachingAllocatorTest, SlabDerivedSubspanDefersReuse) {
+  CreateAllocator(/*slab_block_size=*/64 * 1024);
+  iree_hal_buffer_t* buffer_a = Allocate(1000);
+  iree_device_size_t offset_a = iree_hal_buffer_byte_offset(buffer_a);
+  iree_hal_buffer_t* subspan_a = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_subspan(buffer_a, 0, 100, &subspan_a));
+  iree_hal_buffer_release(buffer_a);
+
+  // The subspan still references the slot memory so it must not be reused.
+  iree_hal_buffer_t* buffer_b = Allocate(1000);
+  EXPECT_NE(iree_hal_buffer_byte_offset(buffer_b), offset_a);
+
+  // Once the subspan is gone the slot can be reused.
+  iree_hal_buffer_release(subspan_a);
+  iree_hal_buffer_t* buffer_c = Allocate(1000);
+  EXPECT_EQ(iree_hal_buffer_byte_offset(buffer_c), offset_a);
+
+  iree_hal_buffer_release(buffer_c);
+  iree_hal_buffer_release(buffer_b);
+}
+
+TEST_F(CachingAllocatorTest, SlabStatistics) {
+  CreateAllocator(/*slab_block_size=*/64 * 1024);
+  iree_hal_buffer_t* buffer = Allocate(1000);
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+#if IREE_STATISTICS_ENABLE
+  EXPECT_EQ(statistics.pool_misses, 1);
+  EXPECT_EQ(statistics.pool_bytes_reserved, 64 * 1024);
+  EXPECT_GE(statistics.pool_bytes_used, 1000);
+  EXPECT_EQ(statistics.pool_bytes_requested,
+            iree_hal_buffer_byte_length(buffer));
+#endif  // IREE_STATISTICS_ENABLE
+  iree_hal_buffer_release(buffer);
+}
+
+TEST_F(CachingAllocatorTest, FreeListAttributesReuseToTag) {
+  CreateAllocator(/*slab_block_size=*/0);
+  iree_hal_buffer_t* buffer_a =
+      Allocate(1024, IREE_HAL_ALLOCATION_TAG_CONSTANT);
+  iree_hal_buffer_release(buffer_a);
+
+  // Pooled memory is attributed to the tag of its current user.
+  iree_hal_buffer_t* buffer_b =
+      Allocate(1024, IREE_HAL_ALLOCATION_TAG_TRANSIENT);
+  EXPECT_EQ(buffer_a, buffer_b);
+  EXPECT_EQ(iree_hal_buffer_allocation_tag(buffer_b),
+            IREE_HAL_ALLOCATION_TAG_TRANSIENT);
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+#if IREE_STATISTICS_ENABLE
+  const auto& constant = statistics.tags[IREE_HAL_ALLOCATION_TAG_CONSTANT];
+  const auto& transient = statistics.tags[IREE_HAL_ALLOCATION_TAG_TRANSIENT];
+  const auto& unknown = statistics.tags[IREE_HAL_ALLOCATION_TAG_UNKNOWN];
+  EXPECT_EQ(constant.bytes_live, 0);
+  EXPECT_EQ(constant.bytes_peak, 1024);
+  EXPECT_EQ(transient.bytes_live, 1024);
+  EXPECT_EQ(transient.bytes_peak, 1024);
+  EXPECT_EQ(unknown.bytes_live, 0);
+#endif  // IREE_STATISTICS_ENABLE
+  iree_hal_buffer_release(buffer_b);
+}
+
+TEST_F(CachingAllocatorTest, SlabTagStatistics) {
+  CreateAllocator(/*slab_block_size=*/64 * 1024);
+  iree_hal_buffer_t* buffer_a =
+      Allocate(1000, IREE_HAL_ALLOCATION_TAG_VARIABLE);
+  iree_hal_buffer_t* buffer_b =
+      Allocate(1000, IREE_HAL_ALLOCATION_TAG_VARIABLE);
+  iree_hal_buffer_release(buffer_a);
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+#if IREE_STATISTICS_ENABLE
+  const auto& variable = statistics.tags[IREE_HAL_ALLOCATION_TAG_VARIABLE];
+  EXPECT_EQ(variable.bytes_live, statistics.pool_bytes_used);
+  EXPECT_EQ(variable.bytes_peak, 2 * statistics.pool_bytes_used);
+  EXPECT_EQ(statistics.tags[IREE_HAL_ALLOCATION_TAG_UNKNOWN].bytes_live, 0);
+#endif  // IREE_STATISTICS_ENABLE
+  iree_hal_buffer_release(buffer_b);
+}
+
+TEST_F(CachingAllocatorTest, SlabLargeAllocationsUseFreeList) {
+  CreateAllocator(/*slab_block_size=*/64 * 1024);
+  iree_hal_buffer_t* buffer = Allocate(32 * 1024);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer), buffer);
+  iree_hal_buffer_release(buffer);
+}
+
+TEST_F(CachingAllocatorTest, TrimReleasesSlabs) {
+  CreateAllocator(/*slab_block_size=*/64 * 1024);
+  iree_hal_buffer_release(Allocate(1000));
+  IREE_ASSERT_OK(iree_hal_allocator_trim(allocator_));
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator_, &statistics);
+#if IREE_STATISTICS_ENABLE
+  EXPECT_EQ(statistics.pool_bytes_reserved, 0);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+TEST_F(CachingAllocatorTest, CreateFromSpecWithSlabs) {
+  IREE_ASSERT_OK(iree_hal_caching_allocator_create_from_spec(
+      iree_make_cstring_view("*=*;*;*;64kib"), device_allocator_,
+      iree_allocator_system(), &allocator_));
+  iree_hal_buffer_t* buffer = Allocate(1000);
+  EXPECT_NE(iree_hal_buffer_allocated_buffer(buffer), buffer);
+  iree_hal_buffer_release(buffer);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -20,6 +20,7 @@ IREE_API_EXPORT void iree_hal_collective_batch_initialize(
   out_batch->capacity = 0;
   out_batch->count = 0;
   out_batch->entries = NULL;
+  out_batch->bucket_size = 0;
 }
 
 IREE_API_EXPORT void iree_hal_collective_batch_deinitialize(
@@ -31,6 +32,11 @@ IREE_API_EXPORT void iree_hal_collective_batch_deinitialize(
   batch->entries = NULL;
 }
 
+IREE_API_EXPORT void iree_hal_collective_batch_set_bucket_size(
+    iree_hal_collective_batch_t* batch, iree_device_size_t bucket_size) {
+  batch->bucket_size = bucket_size;
+}
+
 IREE_API_EXPORT bool iree_hal_collective_batch_is_empty(
     const iree_hal_collective_batch_t* batch) {
   return batch->count == 0;
@@ -110,3 +116,133 @@ IREE_API_EXPORT iree_status_t iree_hal_collective_batch_append(
 
   return iree_ok_status();
 }
+
+// Returns the total size in bytes of the data operated on by |entry|.
+static iree_device_size_t iree_hal_collective_batch_entry_byte_length(
+    const iree_hal_collective_batch_entry_t* entry) {
+  return entry->element_count *
+         iree_hal_collective_element_byte_count(entry->op.element_type);
+}
+
+// Returns true if |entry| can be fused with other entries in a bucket of
+// |bucket_size| bytes.
+static bool iree_hal_collective_batch_entry_is_fusable(
+    const iree_hal_collective_batch_entry_t* entry,
+    iree_device_size_t bucket_size) {
+  // Only all-reduce is elementwise across ranks such that packing entries
+  // end-to-end produces the same results as issuing them independently.
+  if (entry->op.kind != IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE) return false;
+  if (!entry->send_binding.buffer || !entry->recv_binding.buffer) return false;
+  iree_device_size_t byte_length =
+      iree_hal_collective_batch_entry_byte_length(entry);
+  return byte_length > 0 && byte_length < bucket_size;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_collective_batch_partition(
+    const iree_hal_collective_batch_t* batch,
+    iree_host_size_t* out_bucket_count,
+    iree_hal_collective_bucket_t** out_buckets,
+    iree_device_size_t* out_staging_size) {
+  IREE_ASSERT_ARGUMENT(batch);
+  IREE_ASSERT_ARGUMENT(out_bucket_count);
+  IREE_ASSERT_ARGUMENT(out_buckets);
+  IREE_ASSERT_ARGUMENT(out_staging_size);
+  *out_bucket_count = 0;
+  *out_buckets = NULL;
+  *out_staging_size = 0;
+  if (batch->count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, batch->count);
+
+  // Worst case is one bucket per entry.
+  iree_hal_collective_bucket_t* buckets = NULL;
+  const iree_hal_collective_batch_entry_t** bucket_entries = NULL;
+  iree_host_size_t* entry_buckets = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(batch->arena, batch->count * sizeof(*buckets),
+                              (void**)&buckets));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_arena_allocate(batch->arena, batch->count * sizeof(*bucket_entries),
+                          (void**)&bucket_entries));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_arena_allocate(batch->arena, batch->count * sizeof(*entry_buckets),
+                          (void**)&entry_buckets));
+
+  // Assign each entry to a bucket. Fusable entries join the first bucket with
+  // the same channel and operation that has room remaining and otherwise open
+  // a new bucket. Batches are small (dozens to hundreds of entries) so the
+  // quadratic scan is cheaper than anything fancier.
+  iree_host_size_t bucket_count = 0;
+  for (iree_host_size_t i = 0; i < batch->count; ++i) {
+    const iree_hal_collective_batch_entry_t* entry = &batch->entries[i];
+    iree_host_size_t bucket_index = bucket_count;
+    if (iree_hal_collective_batch_entry_is_fusable(entry, batch->bucket_size)) {
+      iree_device_size_t byte_length =
+          iree_hal_collective_batch_entry_byte_length(entry);
+      for (iree_host_size_t j = 0; j < bucket_count; ++j) {
+        const iree_hal_collective_bucket_t* bucket = &buckets[j];
+        const iree_hal_collective_batch_entry_t* head = bucket->entries[0];
+        if (head->channel != entry->channel ||
+            bucket->op.packed != entry->op.packed ||
+            !iree_hal_collective_batch_entry_is_fusable(head,
+                                                        batch->bucket_size)) {
+          continue;
+        }
+        iree_device_size_t bucket_length =
+            bucket->element_count *
+            iree_hal_collective_element_byte_count(bucket->op.element_type);
+        if (bucket_length + byte_length > batch->bucket_size) continue;
+        bucket_index = j;
+        break;
+      }
+    }
+    if (bucket_index == bucket_count) {
+      // The entry list slot of the opening entry temporarily holds the bucket
+      // head used for matching; lists are laid out below once sizes are known.
+      buckets[bucket_count++] = (iree_hal_collective_bucket_t){
+          .op = entry->op,
+          .element_count = 0,
+          .staging_offset = 0,
+          .entry_count = 0,
+          .entries = &bucket_entries[i],
+      };
+      bucket_entries[i] = entry;
+    }
+    iree_hal_collective_bucket_t* bucket = &buckets[bucket_index];
+    bucket->element_count += entry->element_count;
+    ++bucket->entry_count;
+    entry_buckets[i] = bucket_index;
+  }
+
+  // Lay out the entry lists of each bucket contiguously and assign staging
+  // space to each fused bucket.
+  iree_host_size_t entry_offset = 0;
+  iree_device_size_t staging_size = 0;
+  for (iree_host_size_t j = 0; j < bucket_count; ++j) {
+    iree_hal_collective_bucket_t* bucket = &buckets[j];
+    bucket->entries = &bucket_entries[entry_offset];
+    entry_offset += bucket->entry_count;
+    bucket->entry_count = 0;  // rebuilt below
+  }
+  for (iree_host_size_t i = 0; i < batch->count; ++i) {
+    iree_hal_collective_bucket_t* bucket = &buckets[entry_buckets[i]];
+    bucket->entries[bucket->entry_count++] = &batch->entries[i];
+  }
+  for (iree_host_size_t j = 0; j < bucket_count; ++j) {
+    iree_hal_collective_bucket_t* bucket = &buckets[j];
+    if (bucket->entry_count < 2) continue;
+    bucket->staging_offset = staging_size;
+    staging_size += iree_device_align(
+        bucket->element_count *
+            iree_hal_collective_element_byte_count(bucket->op.element_type),
+        IREE_HAL_COLLECTIVE_BUCKET_ALIGNMENT);
+  }
+
+  *out_bucket_count = bucket_count;
+  *out_buckets = buckets;
+  *out_staging_size = staging_size;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
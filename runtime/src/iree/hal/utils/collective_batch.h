@@ -32,6 +32,27 @@ typedef struct {
   iree_device_size_t element_count;
 } iree_hal_collective_batch_entry_t;
 
+// A group of batch entries that can be issued as a single collective.
+// Buckets with a single entry are issued as-is. Buckets with multiple entries
+// are fused: the send buffers of each entry are packed into a staging buffer
+// at |staging_offset|, one collective is issued over all |element_count|
+// elements of the staging buffer in-place, and the results are unpacked into
+// the recv buffers of each entry.
+typedef struct {
+  // Operation shared by all entries in the bucket.
+  iree_hal_collective_op_t op;
+  // Total number of elements across all entries in the bucket.
+  iree_device_size_t element_count;
+  // Byte offset of the bucket in the staging buffer if fused.
+  iree_device_size_t staging_offset;
+  // Entries in the bucket in their packing order.
+  iree_host_size_t entry_count;
+  const iree_hal_collective_batch_entry_t** entries;
+} iree_hal_collective_bucket_t;
+
+// Alignment of each fused bucket in the staging buffer.
+#define IREE_HAL_COLLECTIVE_BUCKET_ALIGNMENT 256
+
 // Builds batches of collective operations for grouped submission.
 // This is to be embedded in command buffer implementations and used to
 // incrementally build batches of collective operations that can be submitted to
@@ -63,6 +84,12 @@ typedef struct {
   iree_host_size_t capacity;
   iree_host_size_t count;
   iree_hal_collective_batch_entry_t* entries;
+
+  // Maximum total size in bytes of a fused bucket or 0 to disable fusion.
+  // Similar to gradient bucketing in data-parallel training this trades a copy
+  // into and out of a staging buffer for issuing one larger collective instead
+  // of many small latency-bound ones.
+  iree_device_size_t bucket_size;
 } iree_hal_collective_batch_t;
 
 // Initializes |out_batch| for use using |arena| for any transient allocations
@@ -75,6 +102,11 @@ IREE_API_EXPORT void iree_hal_collective_batch_initialize(
 IREE_API_EXPORT void iree_hal_collective_batch_deinitialize(
     iree_hal_collective_batch_t* batch);
 
+// Sets the maximum total size in bytes of collectives fused into a single
+// bucket. 0 disables fusion and each entry is issued independently.
+IREE_API_EXPORT void iree_hal_collective_batch_set_bucket_size(
+    iree_hal_collective_batch_t* batch, iree_device_size_t bucket_size);
+
 // Returns true if the batch is empty.
 IREE_API_EXPORT bool iree_hal_collective_batch_is_empty(
     const iree_hal_collective_batch_t* batch);
@@ -92,6 +124,22 @@ IREE_API_EXPORT iree_status_t iree_hal_collective_batch_append(
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count);
 
+// Partitions the entries of |batch| into buckets for submission.
+// Entries are fused when they are all-reduces on the same channel with the same
+// reduction and element type and their combined size fits within the bucket
+// size of the batch. All entries are expected to be independent (recorded
+// within the same barrier scope) and may be reordered.
+//
+// Returns the buckets in |out_buckets| and the total size of the staging
+// buffer required for all fused buckets in |out_staging_size| (0 if nothing
+// was fused). Storage is allocated from the batch arena and is valid until the
+// arena is reset.
+IREE_API_EXPORT iree_status_t iree_hal_collective_batch_partition(
+    const iree_hal_collective_batch_t* batch,
+    iree_host_size_t* out_bucket_count,
+    iree_hal_collective_bucket_t** out_buckets,
+    iree_device_size_t* out_staging_size);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,203 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/collective_batch.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// Placeholder resource used for channels and buffers. Partitioning only
+// compares identities so the batch never calls into them beyond retaining.
+typedef struct iree_hal_test_resource_t {
+  iree_hal_resource_t resource;
+} iree_hal_test_resource_t;
+
+typedef struct iree_hal_test_resource_vtable_t {
+  void(IREE_API_PTR* destroy)(iree_hal_test_resource_t* resource);
+} iree_hal_test_resource_vtable_t;
+IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_test_resource_vtable_t);
+
+static void iree_hal_test_resource_destroy(iree_hal_test_resource_t* resource) {
+}
+
+static const iree_hal_test_resource_vtable_t iree_hal_test_resource_vtable = {
+    /*.destroy=*/iree_hal_test_resource_destroy,
+};
+
+static iree_hal_collective_op_t MakeOp(
+    iree_hal_collective_kind_t kind, iree_hal_collective_reduction_t reduction,
+    iree_hal_collective_element_type_t element_type) {
+  iree_hal_collective_op_t op;
+  op.packed = 0;
+  op.kind = kind;
+  op.reduction = reduction;
+  op.element_type = element_type;
+  return op;
+}
+
+struct CollectiveBatchTest : public ::testing::Test {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_arena_block_pool_t block_pool;
+  iree_arena_allocator_t arena;
+  iree_hal_resource_set_t* resource_set = NULL;
+  iree_hal_collective_batch_t batch;
+
+  iree_hal_test_resource_t channels[2];
+  iree_hal_test_resource_t buffers[8];
+
+  void SetUp() override {
+    iree_arena_block_pool_initialize(4096, host_allocator, &block_pool);
+    iree_arena_initialize(&block_pool, &arena);
+    IREE_ASSERT_OK(iree_hal_resource_set_allocate(&block_pool, &resource_set));
+    iree_hal_collective_batch_initialize(&arena, resource_set, &batch);
+    for (auto& channel : channels) {
+      iree_hal_resource_initialize(&iree_hal_test_resource_vtable,
+                                   &channel.resource);
+    }
+    for (auto& buffer : buffers) {
+      iree_hal_resource_initialize(&iree_hal_test_resource_vtable,
+                                   &buffer.resource);
+    }
+  }
+
+  void TearDown() override {
+    iree_hal_collective_batch_deinitialize(&batch);
+    iree_hal_resource_set_free(resource_set);
+    iree_arena_deinitialize(&arena);
+    iree_arena_block_pool_deinitialize(&block_pool);
+  }
+
+  iree_hal_channel_t* channel(int i) {
+    return (iree_hal_channel_t*)&channels[i];
+  }
+
+  iree_hal_buffer_binding_t binding(int i) {
+    iree_hal_buffer_binding_t binding = {0};
+    binding.buffer = (iree_hal_buffer_t*)&buffers[i];
+    binding.length = IREE_WHOLE_BUFFER;
+    return binding;
+  }
+
+  void Append(iree_hal_channel_t* channel, iree_hal_collective_op_t op,
+              int buffer, iree_device_size_t element_count) {
+    IREE_ASSERT_OK(iree_hal_collective_batch_append(
+        &batch, channel, op, 0, binding(buffer), binding(buffer),
+        element_count));
+  }
+};
+
+static const iree_hal_collective_op_t kAllReduceSumF32 = MakeOp(
+    IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE, IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+    IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32);
+
+// Tests that partitioning an empty batch produces no buckets.
+TEST_F(CollectiveBatchTest, PartitionEmpty) {
+  iree_host_size_t bucket_count = 0;
+  iree_hal_collective_bucket_t* buckets = NULL;
+  iree_device_size_t staging_size = 0;
+  IREE_ASSERT_OK(iree_hal_collective_batch_partition(
+      &batch, &bucket_count, &buckets, &staging_size));
+  EXPECT_EQ(bucket_count, 0);
+  EXPECT_EQ(staging_size, 0);
+}
+
+// Tests that each entry is issued independently when fusion is disabled.
+TEST_F(CollectiveBatchTest, PartitionFusionDisabled) {
+  for (int i = 0; i < 4; ++i) Append(channel(0), kAllReduceSumF32, i, 16);
+
+  iree_host_size_t bucket_count = 0;
+  iree_hal_collective_bucket_t* buckets = NULL;
+  iree_device_size_t staging_size = 0;
+  IREE_ASSERT_OK(iree_hal_collective_batch_partition(
+      &batch, &bucket_count, &buckets, &staging_size));
+  ASSERT_EQ(bucket_count, 4);
+  EXPECT_EQ(staging_size, 0);
+  for (iree_host_size_t i = 0; i < bucket_count; ++i) {
+    ASSERT_EQ(buckets[i].entry_count, 1);
+    EXPECT_EQ(buckets[i].entries[0], &batch.entries[i]);
+  }
+}
+
+// Tests that small all-reduces of the same kind are packed into one bucket.
+TEST_F(CollectiveBatchTest, PartitionFusesSmallAllReduces) {
+  iree_hal_collective_batch_set_bucket_size(&batch, 1024 * 1024);
+  for (int i = 0; i < 4; ++i) Append(channel(0), kAllReduceSumF32, i, 16);
+
+  iree_host_size_t bucket_count = 0;
+  iree_hal_collective_bucket_t* buckets = NULL;
+  iree_device_size_t staging_size = 0;
+  IREE_ASSERT_OK(iree_hal_collective_batch_partition(
+      &batch, &bucket_count, &buckets, &staging_size));
+  ASSERT_EQ(bucket_count, 1);
+  EXPECT_EQ(buckets[0].op.packed, kAllReduceSumF32.packed);
+  EXPECT_EQ(buckets[0].element_count, 4 * 16);
+  EXPECT_EQ(buckets[0].staging_offset, 0);
+  ASSERT_EQ(buckets[0].entry_count, 4);
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(buckets[0].entries[i], &batch.entries[i]);
+  }
+  EXPECT_EQ(staging_size,
+            iree_device_align(4 * 16 * sizeof(float),
+                              IREE_HAL_COLLECTIVE_BUCKET_ALIGNMENT));
+}
+
+// Tests that entries are only fused with others on the same channel with the
+// same operation and that buckets respect the bucket size.
+TEST_F(CollectiveBatchTest, PartitionSplitsBuckets) {
+  // Each bucket holds at most two 64-element f32 entries.
+  iree_hal_collective_batch_set_bucket_size(&batch, 2 * 64 * sizeof(float));
+  const iree_hal_collective_op_t all_reduce_max_f32 = MakeOp(
+      IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+      IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM,
+      IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32);
+  const iree_hal_collective_op_t all_gather_f32 = MakeOp(
+      IREE_HAL_COLLECTIVE_KIND_ALL_GATHER, IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+      IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32);
+  Append(channel(0), kAllReduceSumF32, 0, 64);    // bucket 0
+  Append(channel(1), kAllReduceSumF32, 1, 64);    // bucket 1 (channel)
+  Append(channel(0), all_reduce_max_f32, 2, 64);  // bucket 2 (reduction)
+  Append(channel(0), all_gather_f32, 3, 64);      // bucket 3 (not fusable)
+  Append(channel(0), kAllReduceSumF32, 4, 64);    // bucket 0 (now full)
+  Append(channel(0), kAllReduceSumF32, 5, 64);    // bucket 4 (size)
+  Append(channel(1), kAllReduceSumF32, 6, 256);   // bucket 5 (too large)
+
+  iree_host_size_t bucket_count = 0;
+  iree_hal_collective_bucket_t* buckets = NULL;
+  iree_device_size_t staging_size = 0;
+  IREE_ASSERT_OK(iree_hal_collective_batch_partition(
+      &batch, &bucket_count, &buckets, &staging_size));
+  ASSERT_EQ(bucket_count, 6);
+  ASSERT_EQ(buckets[0].entry_count, 2);
+  EXPECT_EQ(buckets[0].entries[0], &batch.entries[0]);
+  EXPECT_EQ(buckets[0].entries[1], &batch.entries[4]);
+  EXPECT_EQ(buckets[0].element_count, 128);
+  for (iree_host_size_t i = 1; i < bucket_count; ++i) {
+    EXPECT_EQ(buckets[i].entry_count, 1);
+  }
+  EXPECT_EQ(buckets[1].entries[0], &batch.entries[1]);
+  EXPECT_EQ(buckets[2].entries[0], &batch.entries[2]);
+  EXPECT_EQ(buckets[3].entries[0], &batch.entries[3]);
+  EXPECT_EQ(buckets[4].entries[0], &batch.entries[5]);
+  EXPECT_EQ(buckets[5].entries[0], &batch.entries[6]);
+
+  // Only the first bucket was fused and needs staging.
+  EXPECT_EQ(staging_size,
+            iree_device_align(128 * sizeof(float),
+                              IREE_HAL_COLLECTIVE_BUCKET_ALIGNMENT));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
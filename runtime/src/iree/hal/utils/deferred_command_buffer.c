@@ -35,11 +35,12 @@ typedef enum iree_hal_command_type_e {
 // Each command is allocated from the arena and does *not* retain any resources;
 // the command buffer has a resource set that does lifetime tracking.
 //
-// We could elide some of these commands by keeping local state however that
-// requires knowing more about the target device (pipeline layouts, etc) and
-// prevents using this as a way to debug or benchmark command buffers. The
-// intent is that each command captures the exact information passed during the
-// call such that the target command buffer cannot tell they were deferred.
+// Each command captures the exact information passed during the call. When
+// IREE_HAL_DEFERRED_COMMAND_BUFFER_OPTIMIZE is enabled the list is rewritten
+// when recording ends to merge or drop commands in ways that do not change the
+// results of execution (see iree_hal_cmd_list_optimize). Disabling it replays
+// the commands verbatim such that the target command buffer cannot tell they
+// were deferred, which is useful when debugging or benchmarking.
 //
 // As each command is variable sized we store pointers to the following command
 // to allow us to walk the list during replay. Storing just a size would be
@@ -227,11 +228,18 @@ static iree_status_t iree_hal_deferred_command_buffer_begin(
   return iree_ok_status();
 }
 
+static iree_status_t iree_hal_cmd_list_optimize(iree_hal_cmd_list_t* cmd_list);
+
 static iree_status_t iree_hal_deferred_command_buffer_end(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_deferred_command_buffer_t* command_buffer =
       iree_hal_deferred_command_buffer_cast(base_command_buffer);
   iree_hal_resource_set_freeze(command_buffer->resource_set);
+#if IREE_HAL_DEFERRED_COMMAND_BUFFER_OPTIMIZE
+  // The full command stream is known now and is optimized once regardless of
+  // how many times it is replayed.
+  IREE_RETURN_IF_ERROR(iree_hal_cmd_list_optimize(&command_buffer->cmd_list));
+#endif  // IREE_HAL_DEFERRED_COMMAND_BUFFER_OPTIMIZE
   return iree_ok_status();
 }
 
@@ -731,9 +739,55 @@ static iree_status_t iree_hal_deferred_command_buffer_apply_push_descriptor_set(
     iree_hal_command_buffer_t* target_command_buffer,
     iree_hal_buffer_binding_table_t binding_table,
     const iree_hal_cmd_push_descriptor_set_t* cmd) {
+  // Fast path for sets that only contain direct bindings as we can pass them
+  // through unmodified.
+  bool any_indirect = false;
+  for (iree_host_size_t i = 0; i < cmd->binding_count; ++i) {
+    if (!cmd->bindings[i].buffer) {
+      any_indirect = true;
+      break;
+    }
+  }
+  if (!any_indirect) {
+    return iree_hal_command_buffer_push_descriptor_set(
+        target_command_buffer, cmd->pipeline_layout, cmd->set,
+        cmd->binding_count, cmd->bindings);
+  }
+
+  // Resolve indirect bindings from the binding table provided at submission
+  // time. Offsets are relative to the binding table entry and whole-buffer
+  // lengths take the length of the entry.
+  iree_hal_descriptor_set_binding_t* bindings =
+      (iree_hal_descriptor_set_binding_t*)iree_alloca(
+          cmd->binding_count * sizeof(iree_hal_descriptor_set_binding_t));
+  for (iree_host_size_t i = 0; i < cmd->binding_count; ++i) {
+    iree_hal_descriptor_set_binding_t binding = cmd->bindings[i];
+    if (!binding.buffer) {
+      if (IREE_UNLIKELY(binding.buffer_slot >= binding_table.count)) {
+        return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "bindings[%" PRIhsz
+                                "] references binding table slot %u but only "
+                                "%" PRIhsz " bindings were provided",
+                                i, binding.buffer_slot, binding_table.count);
+      }
+      const iree_hal_buffer_binding_t* table_binding =
+          &binding_table.bindings[binding.buffer_slot];
+      if (IREE_UNLIKELY(!table_binding->buffer)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "binding table slot %u has no buffer bound",
+                                binding.buffer_slot);
+      }
+      binding.buffer = table_binding->buffer;
+      binding.offset += table_binding->offset;
+      if (binding.length == IREE_WHOLE_BUFFER) {
+        binding.length = table_binding->length;
+      }
+    }
+    bindings[i] = binding;
+  }
   return iree_hal_command_buffer_push_descriptor_set(
       target_command_buffer, cmd->pipeline_layout, cmd->set, cmd->binding_count,
-      cmd->bindings);
+      bindings);
 }
 
 //===----------------------------------------------------------------------===//
@@ -870,6 +924,480 @@ static iree_status_t iree_hal_deferred_command_buffer_apply_execute_commands(
       target_command_buffer, cmd->commands, child_binding_table);
 }
 
+//===----------------------------------------------------------------------===//
+// Command list optimization
+//===----------------------------------------------------------------------===//
+
+// Maximum number of buffer ranges tracked per barrier-delimited segment when
+// proving barriers redundant. Segments with more accesses keep their barriers.
+#define IREE_HAL_CMD_ACCESS_SET_CAPACITY 16
+
+// Number of descriptor sets tracked when eliding redundant pushes. Pushes to
+// higher sets are always replayed.
+#define IREE_HAL_CMD_TRACKED_SET_COUNT 4
+
+// Removes the command following |prev| (or the head if |prev| is NULL).
+// The storage remains in the arena until the list is reset.
+static void iree_hal_cmd_list_remove_next(iree_hal_cmd_list_t* cmd_list,
+                                          iree_hal_cmd_header_t* prev) {
+  iree_hal_cmd_header_t* cmd = prev ? prev->next : cmd_list->head;
+  if (prev) {
+    prev->next = cmd->next;
+  } else {
+    cmd_list->head = cmd->next;
+  }
+  if (cmd_list->tail == cmd) cmd_list->tail = prev;
+}
+
+// Replaces the command following |prev| (or the head if |prev| is NULL) with
+// |new_cmd|.
+static void iree_hal_cmd_list_replace_next(iree_hal_cmd_list_t* cmd_list,
+                                           iree_hal_cmd_header_t* prev,
+                                           iree_hal_cmd_header_t* new_cmd) {
+  iree_hal_cmd_header_t* cmd = prev ? prev->next : cmd_list->head;
+  new_cmd->next = cmd->next;
+  if (prev) {
+    prev->next = new_cmd;
+  } else {
+    cmd_list->head = new_cmd;
+  }
+  if (cmd_list->tail == cmd) cmd_list->tail = new_cmd;
+}
+
+// Merges |next| into |cmd| if both fill contiguous ranges of the same buffer
+// with the same pattern.
+static bool iree_hal_cmd_try_merge_fill(
+    iree_hal_cmd_fill_buffer_t* cmd, const iree_hal_cmd_fill_buffer_t* next) {
+  if (cmd->target_buffer != next->target_buffer) return false;
+  if (cmd->length == IREE_WHOLE_BUFFER || next->length == IREE_WHOLE_BUFFER) {
+    return false;
+  }
+  if (cmd->pattern_length != next->pattern_length ||
+      memcmp(&cmd->pattern, &next->pattern, cmd->pattern_length) != 0) {
+    return false;
+  }
+  if (next->target_offset != cmd->target_offset + cmd->length) return false;
+  cmd->length += next->length;
+  return true;
+}
+
+// Merges |next| into |cmd| if both copy contiguous ranges between the same
+// buffers. Copies within a single buffer are only merged if the merged source
+// and target ranges do not overlap.
+static bool iree_hal_cmd_try_merge_copy(
+    iree_hal_cmd_copy_buffer_t* cmd, const iree_hal_cmd_copy_buffer_t* next) {
+  if (cmd->source_buffer != next->source_buffer ||
+      cmd->target_buffer != next->target_buffer) {
+    return false;
+  }
+  if (cmd->length == IREE_WHOLE_BUFFER || next->length == IREE_WHOLE_BUFFER) {
+    return false;
+  }
+  if (next->source_offset != cmd->source_offset + cmd->length ||
+      next->target_offset != cmd->target_offset + cmd->length) {
+    return false;
+  }
+  iree_device_size_t length = cmd->length + next->length;
+  if (cmd->source_buffer == cmd->target_buffer &&
+      cmd->source_offset < cmd->target_offset + length &&
+      cmd->target_offset < cmd->source_offset + length) {
+    return false;
+  }
+  cmd->length = length;
+  return true;
+}
+
+// Merges runs of adjacent fills and copies over contiguous ranges.
+static void iree_hal_cmd_list_merge_transfers(iree_hal_cmd_list_t* cmd_list) {
+  for (iree_hal_cmd_header_t* cmd = cmd_list->head; cmd; cmd = cmd->next) {
+    while (cmd->next && cmd->next->type == cmd->type) {
+      bool merged = false;
+      if (cmd->type == IREE_HAL_CMD_FILL_BUFFER) {
+        merged = iree_hal_cmd_try_merge_fill(
+            (iree_hal_cmd_fill_buffer_t*)cmd,
+            (const iree_hal_cmd_fill_buffer_t*)cmd->next);
+      } else if (cmd->type == IREE_HAL_CMD_COPY_BUFFER) {
+        merged = iree_hal_cmd_try_merge_copy(
+            (iree_hal_cmd_copy_buffer_t*)cmd,
+            (const iree_hal_cmd_copy_buffer_t*)cmd->next);
+      }
+      if (!merged) break;
+      iree_hal_cmd_list_remove_next(cmd_list, cmd);
+    }
+  }
+}
+
+// Merges two execution barriers with no commands between them into one that
+// covers the scopes of both.
+static iree_status_t iree_hal_cmd_list_merge_barriers(
+    iree_hal_cmd_list_t* cmd_list, iree_hal_cmd_execution_barrier_t* cmd,
+    const iree_hal_cmd_execution_barrier_t* next) {
+  iree_host_size_t memory_barrier_count =
+      cmd->memory_barrier_count + next->memory_barrier_count;
+  iree_host_size_t buffer_barrier_count =
+      cmd->buffer_barrier_count + next->buffer_barrier_count;
+  iree_hal_memory_barrier_t* memory_barriers = NULL;
+  iree_hal_buffer_barrier_t* buffer_barriers = NULL;
+  if (memory_barrier_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &cmd_list->arena, memory_barrier_count * sizeof(*memory_barriers),
+        (void**)&memory_barriers));
+  }
+  if (buffer_barrier_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &cmd_list->arena, buffer_barrier_count * sizeof(*buffer_barriers),
+        (void**)&buffer_barriers));
+  }
+  if (cmd->memory_barrier_count > 0) {
+    memcpy(memory_barriers, cmd->memory_barriers,
+           cmd->memory_barrier_count * sizeof(*memory_barriers));
+  }
+  if (next->memory_barrier_count > 0) {
+    memcpy(memory_barriers + cmd->memory_barrier_count, next->memory_barriers,
+           next->memory_barrier_count * sizeof(*memory_barriers));
+  }
+  if (cmd->buffer_barrier_count > 0) {
+    memcpy(buffer_barriers, cmd->buffer_barriers,
+           cmd->buffer_barrier_count * sizeof(*buffer_barriers));
+  }
+  if (next->buffer_barrier_count > 0) {
+    memcpy(buffer_barriers + cmd->buffer_barrier_count, next->buffer_barriers,
+           next->buffer_barrier_count * sizeof(*buffer_barriers));
+  }
+  cmd->source_stage_mask |= next->source_stage_mask;
+  cmd->target_stage_mask |= next->target_stage_mask;
+  cmd->flags |= next->flags;
+  cmd->memory_barrier_count = memory_barrier_count;
+  cmd->memory_barriers = memory_barriers;
+  cmd->buffer_barrier_count = buffer_barrier_count;
+  cmd->buffer_barriers = buffer_barriers;
+  return iree_ok_status();
+}
+
+// A byte range of an allocated buffer accessed by a command.
+typedef struct iree_hal_cmd_access_t {
+  iree_hal_buffer_t* allocated_buffer;
+  iree_device_size_t begin;
+  iree_device_size_t end;
+  bool is_write;
+} iree_hal_cmd_access_t;
+
+// Buffer ranges accessed by a sequence of commands. |unknown| is set if any
+// command accesses memory that cannot be determined from its arguments (such
+// as dispatches) or if the set overflows.
+typedef struct iree_hal_cmd_access_set_t {
+  bool unknown;
+  iree_host_size_t count;
+  iree_hal_cmd_access_t values[IREE_HAL_CMD_ACCESS_SET_CAPACITY];
+} iree_hal_cmd_access_set_t;
+
+static void iree_hal_cmd_access_set_insert(iree_hal_cmd_access_set_t* set,
+                                           iree_hal_buffer_t* buffer,
+                                           iree_device_size_t offset,
+                                           iree_device_size_t length,
+                                           bool is_write) {
+  if (!buffer || set->count >= IREE_ARRAYSIZE(set->values)) {
+    set->unknown = true;
+    return;
+  }
+  iree_hal_cmd_access_t* access = &set->values[set->count++];
+  access->allocated_buffer = iree_hal_buffer_allocated_buffer(buffer);
+  access->begin = iree_hal_buffer_byte_offset(buffer) + offset;
+  access->end = length == IREE_WHOLE_BUFFER ? IREE_DEVICE_SIZE_MAX
+                                            : access->begin + length;
+  access->is_write = is_write;
+}
+
+// Adds the buffer ranges accessed by |cmd| to |set|.
+static void iree_hal_cmd_access_set_insert_cmd(
+    iree_hal_cmd_access_set_t* set, const iree_hal_cmd_header_t* cmd) {
+  switch (cmd->type) {
+    case IREE_HAL_CMD_DISCARD_BUFFER: {
+      const iree_hal_cmd_discard_buffer_t* discard_cmd =
+          (const iree_hal_cmd_discard_buffer_t*)cmd;
+      iree_hal_cmd_access_set_insert(set, discard_cmd->buffer, 0,
+                                     IREE_WHOLE_BUFFER, /*is_write=*/true);
+      break;
+    }
+    case IREE_HAL_CMD_FILL_BUFFER: {
+      const iree_hal_cmd_fill_buffer_t* fill_cmd =
+          (const iree_hal_cmd_fill_buffer_t*)cmd;
+      iree_hal_cmd_access_set_insert(set, fill_cmd->target_buffer,
+                                     fill_cmd->target_offset, fill_cmd->length,
+                                     /*is_write=*/true);
+      break;
+    }
+    case IREE_HAL_CMD_UPDATE_BUFFER: {
+      const iree_hal_cmd_update_buffer_t* update_cmd =
+          (const iree_hal_cmd_update_buffer_t*)cmd;
+      iree_hal_cmd_access_set_insert(set, update_cmd->target_buffer,
+                                     update_cmd->target_offset,
+                                     update_cmd->length, /*is_write=*/true);
+      break;
+    }
+    case IREE_HAL_CMD_COPY_BUFFER: {
+      const iree_hal_cmd_copy_buffer_t* copy_cmd =
+          (const iree_hal_cmd_copy_buffer_t*)cmd;
+      iree_hal_cmd_access_set_insert(set, copy_cmd->source_buffer,
+                                     copy_cmd->source_offset, copy_cmd->length,
+                                     /*is_write=*/false);
+      iree_hal_cmd_access_set_insert(set, copy_cmd->target_buffer,
+                                     copy_cmd->target_offset, copy_cmd->length,
+                                     /*is_write=*/true);
+      break;
+    }
+    case IREE_HAL_CMD_PUSH_CONSTANTS:
+    case IREE_HAL_CMD_PUSH_DESCRIPTOR_SET:
+      // State changes only; the accesses happen in the dispatches using them.
+      break;
+    default:
+      set->unknown = true;
+      break;
+  }
+}
+
+// Returns true if any access in |before| conflicts with any in |after|.
+static bool iree_hal_cmd_access_sets_conflict(
+    const iree_hal_cmd_access_set_t* before,
+    const iree_hal_cmd_access_set_t* after) {
+  for (iree_host_size_t i = 0; i < before->count; ++i) {
+    const iree_hal_cmd_access_t* a = &before->values[i];
+    for (iree_host_size_t j = 0; j < after->count; ++j) {
+      const iree_hal_cmd_access_t* b = &after->values[j];
+      if (!a->is_write && !b->is_write) continue;
+      if (a->allocated_buffer != b->allocated_buffer) continue;
+      if (a->begin < b->end && b->begin < a->end) return true;
+    }
+  }
+  return false;
+}
+
+// Merges adjacent execution barriers and removes barriers between transfer
+// commands that the recorded ranges prove independent. Barriers are kept if
+// either side of them has no accesses (as they then order against work outside
+// of the command buffer), has accesses that cannot be determined, or if they
+// involve the host.
+static iree_status_t iree_hal_cmd_list_elide_barriers(
+    iree_hal_cmd_list_t* cmd_list) {
+  iree_hal_cmd_access_set_t before;
+  memset(&before, 0, sizeof(before));
+  iree_hal_cmd_header_t* prev = NULL;
+  iree_hal_cmd_header_t* cmd = cmd_list->head;
+  while (cmd) {
+    if (cmd->type != IREE_HAL_CMD_EXECUTION_BARRIER) {
+      iree_hal_cmd_access_set_insert_cmd(&before, cmd);
+      prev = cmd;
+      cmd = cmd->next;
+      continue;
+    }
+    iree_hal_cmd_execution_barrier_t* barrier_cmd =
+        (iree_hal_cmd_execution_barrier_t*)cmd;
+    while (cmd->next && cmd->next->type == IREE_HAL_CMD_EXECUTION_BARRIER) {
+      IREE_RETURN_IF_ERROR(iree_hal_cmd_list_merge_barriers(
+          cmd_list, barrier_cmd,
+          (const iree_hal_cmd_execution_barrier_t*)cmd->next));
+      iree_hal_cmd_list_remove_next(cmd_list, cmd);
+    }
+
+    bool is_redundant = false;
+    if (!before.unknown && before.count > 0 &&
+        !iree_any_bit_set(
+            barrier_cmd->source_stage_mask | barrier_cmd->target_stage_mask,
+            IREE_HAL_EXECUTION_STAGE_HOST)) {
+      iree_hal_cmd_access_set_t after;
+      memset(&after, 0, sizeof(after));
+      for (iree_hal_cmd_header_t* next = cmd->next;
+           next && next->type != IREE_HAL_CMD_EXECUTION_BARRIER &&
+           !after.unknown;
+           next = next->next) {
+        iree_hal_cmd_access_set_insert_cmd(&after, next);
+      }
+      is_redundant = !after.unknown && after.count > 0 &&
+                     !iree_hal_cmd_access_sets_conflict(&before, &after);
+    }
+
+    cmd = cmd->next;
+    if (is_redundant) {
+      // The following commands join the segment preceding the barrier.
+      iree_hal_cmd_list_remove_next(cmd_list, prev);
+    } else {
+      memset(&before, 0, sizeof(before));
+      prev = &barrier_cmd->header;
+    }
+  }
+  return iree_ok_status();
+}
+
+// Returns true if the push descriptor commands bind identical descriptors.
+static bool iree_hal_cmd_push_descriptor_sets_equal(
+    const iree_hal_cmd_push_descriptor_set_t* lhs,
+    const iree_hal_cmd_push_descriptor_set_t* rhs) {
+  if (lhs->pipeline_layout != rhs->pipeline_layout || lhs->set != rhs->set ||
+      lhs->binding_count != rhs->binding_count) {
+    return false;
+  }
+  for (iree_host_size_t i = 0; i < lhs->binding_count; ++i) {
+    const iree_hal_descriptor_set_binding_t* a = &lhs->bindings[i];
+    const iree_hal_descriptor_set_binding_t* b = &rhs->bindings[i];
+    if (a->binding != b->binding || a->buffer_slot != b->buffer_slot ||
+        a->buffer != b->buffer || a->offset != b->offset ||
+        a->length != b->length) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if |cmd| binds the same binding ordinal as |binding|.
+static bool iree_hal_cmd_push_descriptor_set_has_binding(
+    const iree_hal_cmd_push_descriptor_set_t* cmd, uint32_t binding) {
+  for (iree_host_size_t i = 0; i < cmd->binding_count; ++i) {
+    if (cmd->bindings[i].binding == binding) return true;
+  }
+  return false;
+}
+
+// Folds |cmd| into the push |target| that follows it and returns the command
+// that replaces |target| in |out_merged_cmd|. Bindings in |target| take
+// precedence over those in |cmd|. Returns NULL if the merged push would bind
+// more descriptors than either push does on its own as that may exceed the
+// limits of the target command buffer.
+static iree_status_t iree_hal_cmd_list_merge_push_descriptor_sets(
+    iree_hal_cmd_list_t* cmd_list,
+    const iree_hal_cmd_push_descriptor_set_t* cmd,
+    const iree_hal_cmd_push_descriptor_set_t* target,
+    iree_hal_cmd_push_descriptor_set_t** out_merged_cmd) {
+  *out_merged_cmd = NULL;
+  iree_host_size_t binding_count = target->binding_count;
+  for (iree_host_size_t i = 0; i < cmd->binding_count; ++i) {
+    if (!iree_hal_cmd_push_descriptor_set_has_binding(
+            target, cmd->bindings[i].binding)) {
+      ++binding_count;
+    }
+  }
+  if (binding_count > iree_max(cmd->binding_count, target->binding_count)) {
+    return iree_ok_status();
+  }
+  iree_hal_cmd_push_descriptor_set_t* merged_cmd = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &cmd_list->arena,
+      sizeof(*merged_cmd) + binding_count * sizeof(merged_cmd->bindings[0]),
+      (void**)&merged_cmd));
+  merged_cmd->header.type = IREE_HAL_CMD_PUSH_DESCRIPTOR_SET;
+  merged_cmd->pipeline_layout = target->pipeline_layout;
+  merged_cmd->set = target->set;
+  merged_cmd->binding_count = 0;
+  for (iree_host_size_t i = 0; i < cmd->binding_count; ++i) {
+    if (!iree_hal_cmd_push_descriptor_set_has_binding(
+            target, cmd->bindings[i].binding)) {
+      merged_cmd->bindings[merged_cmd->binding_count++] = cmd->bindings[i];
+    }
+  }
+  memcpy(&merged_cmd->bindings[merged_cmd->binding_count], target->bindings,
+         target->binding_count * sizeof(target->bindings[0]));
+  merged_cmd->binding_count += target->binding_count;
+  *out_merged_cmd = merged_cmd;
+  return iree_ok_status();
+}
+
+// Returns true if |cmd| consumes or resets the bound descriptor set state.
+static bool iree_hal_cmd_uses_descriptor_sets(
+    const iree_hal_cmd_header_t* cmd) {
+  switch (cmd->type) {
+    case IREE_HAL_CMD_DISPATCH:
+    case IREE_HAL_CMD_DISPATCH_INDIRECT:
+    case IREE_HAL_CMD_EXECUTE_COMMANDS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Coalesces push descriptor updates:
+//  * pushes that are followed by another push to the same set and layout
+//    before any dispatch are folded into the later push.
+//  * pushes that are identical to the last push to the same set are dropped.
+static iree_status_t iree_hal_cmd_list_coalesce_push_descriptor_sets(
+    iree_hal_cmd_list_t* cmd_list) {
+  // Fold pushes forward into the next push of the same set.
+  iree_hal_cmd_header_t* prev = NULL;
+  iree_hal_cmd_header_t* cmd = cmd_list->head;
+  while (cmd) {
+    iree_hal_cmd_header_t* next = cmd->next;
+    if (cmd->type == IREE_HAL_CMD_PUSH_DESCRIPTOR_SET) {
+      const iree_hal_cmd_push_descriptor_set_t* push_cmd =
+          (const iree_hal_cmd_push_descriptor_set_t*)cmd;
+      iree_hal_cmd_header_t* target_prev = cmd;
+      for (iree_hal_cmd_header_t* target = next;
+           target && !iree_hal_cmd_uses_descriptor_sets(target);
+           target_prev = target, target = target->next) {
+        if (target->type != IREE_HAL_CMD_PUSH_DESCRIPTOR_SET) continue;
+        const iree_hal_cmd_push_descriptor_set_t* target_cmd =
+            (const iree_hal_cmd_push_descriptor_set_t*)target;
+        if (target_cmd->set != push_cmd->set) continue;
+        if (target_cmd->pipeline_layout != push_cmd->pipeline_layout) break;
+        iree_hal_cmd_push_descriptor_set_t* merged_cmd = NULL;
+        IREE_RETURN_IF_ERROR(iree_hal_cmd_list_merge_push_descriptor_sets(
+            cmd_list, push_cmd, target_cmd, &merged_cmd));
+        if (!merged_cmd) break;
+        iree_hal_cmd_list_replace_next(cmd_list, target_prev,
+                                       &merged_cmd->header);
+        iree_hal_cmd_list_remove_next(cmd_list, prev);
+        next = prev ? prev->next : cmd_list->head;
+        cmd = NULL;
+        break;
+      }
+    }
+    if (cmd) prev = cmd;
+    cmd = next;
+  }
+
+  // Drop pushes that rebind what is already bound.
+  const iree_hal_cmd_push_descriptor_set_t*
+      last_pushes[IREE_HAL_CMD_TRACKED_SET_COUNT] = {NULL};
+  prev = NULL;
+  cmd = cmd_list->head;
+  while (cmd) {
+    iree_hal_cmd_header_t* next = cmd->next;
+    if (cmd->type == IREE_HAL_CMD_EXECUTE_COMMANDS) {
+      memset(last_pushes, 0, sizeof(last_pushes));
+    } else if (cmd->type == IREE_HAL_CMD_PUSH_DESCRIPTOR_SET) {
+      const iree_hal_cmd_push_descriptor_set_t* push_cmd =
+          (const iree_hal_cmd_push_descriptor_set_t*)cmd;
+      if (push_cmd->set < IREE_ARRAYSIZE(last_pushes)) {
+        const iree_hal_cmd_push_descriptor_set_t* last_push =
+            last_pushes[push_cmd->set];
+        if (last_push &&
+            iree_hal_cmd_push_descriptor_sets_equal(last_push, push_cmd)) {
+          iree_hal_cmd_list_remove_next(cmd_list, prev);
+          cmd = next;
+          continue;
+        }
+        last_pushes[push_cmd->set] = push_cmd;
+      }
+    }
+    prev = cmd;
+    cmd = next;
+  }
+  return iree_ok_status();
+}
+
+// Rewrites the recorded command list to reduce the number of commands issued
+// during replay without changing the results of execution.
+static iree_status_t iree_hal_cmd_list_optimize(iree_hal_cmd_list_t* cmd_list) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  // Transfers are merged again after eliding barriers as that may make more of
+  // them adjacent.
+  iree_hal_cmd_list_merge_transfers(cmd_list);
+  iree_status_t status = iree_hal_cmd_list_elide_barriers(cmd_list);
+  if (iree_status_is_ok(status)) {
+    iree_hal_cmd_list_merge_transfers(cmd_list);
+    status = iree_hal_cmd_list_coalesce_push_descriptor_sets(cmd_list);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // Dynamic replay dispatch
 //===----------------------------------------------------------------------===//
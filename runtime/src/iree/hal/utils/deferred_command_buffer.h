@@ -16,6 +16,15 @@ extern "C" {
 
 typedef struct iree_arena_block_pool_t iree_arena_block_pool_t;
 
+// Enables rewriting the recorded commands when recording ends to reduce the
+// number of commands issued during replay. Adjacent fills and copies over
+// contiguous ranges are merged, execution barriers between transfers that the
+// recorded ranges prove independent are dropped, and redundant push descriptor
+// updates are coalesced. Disable to replay commands exactly as recorded.
+#if !defined(IREE_HAL_DEFERRED_COMMAND_BUFFER_OPTIMIZE)
+#define IREE_HAL_DEFERRED_COMMAND_BUFFER_OPTIMIZE 1
+#endif  // !IREE_HAL_DEFERRED_COMMAND_BUFFER_OPTIMIZE
+
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_t deferred record/replay wrapper
 //===----------------------------------------------------------------------===//
@@ -15,14 +15,35 @@ typedef struct iree_hal_file_cache_entry_t {
   iree_hal_queue_affinity_t queue_affinity;
   iree_hal_memory_access_t access;
   iree_hal_file_t* file;
+  // Total number of acquired scopes referencing the entry. Entries with no
+  // references are subject to eviction.
+  iree_host_size_t scope_count;
+  // Value of the cache use epoch when the entry was last looked up.
+  uint64_t last_use;
 } iree_hal_file_cache_entry_t;
 
+// A named scope referencing a set of cache entries.
+typedef struct iree_hal_file_cache_scope_t {
+  struct iree_hal_file_cache_scope_t* next;
+  // Number of outstanding acquisitions of the scope.
+  iree_host_size_t ref_count;
+  // Total capacity of the entries list in elements.
+  iree_host_size_t entry_capacity;
+  // Currently used entry count in elements.
+  iree_host_size_t entry_count;
+  // Unordered set of entries referenced by the scope.
+  iree_hal_file_cache_entry_t** entries;
+  // Scope name; storage trails the struct.
+  iree_string_view_t name;
+} iree_hal_file_cache_scope_t;
+
 struct iree_hal_file_cache_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t host_allocator;
+  iree_hal_file_cache_params_t params;
 
-  // Guards mutation of the entries list.
-  // NOTE: this does not guard the entries themselves as we assume they are
+  // Guards mutation of the entries list and scopes.
+  // NOTE: this does not guard the entry files themselves as we assume they are
   // immutable (today).
   iree_slim_mutex_t mutex;
 
@@ -32,10 +53,27 @@ struct iree_hal_file_cache_t {
   iree_host_size_t entry_count;
   // Dense list of entries in the cache. Grows as needed.
   iree_hal_file_cache_entry_t** entries;
+
+  // Number of entries with no scope references.
+  iree_host_size_t unreferenced_count;
+  // Monotonically increasing counter bumped on each lookup used to order
+  // entries for eviction.
+  uint64_t use_epoch;
+
+  // Linked list of all acquired scopes.
+  iree_hal_file_cache_scope_t* scope_head;
 };
 
+IREE_API_EXPORT void iree_hal_file_cache_params_initialize(
+    iree_hal_file_cache_params_t* out_params) {
+  IREE_ASSERT_ARGUMENT(out_params);
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->eviction_budget = IREE_HOST_SIZE_MAX;
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_file_cache_create(
-    iree_allocator_t host_allocator, iree_hal_file_cache_t** out_file_cache) {
+    iree_hal_file_cache_params_t params, iree_allocator_t host_allocator,
+    iree_hal_file_cache_t** out_file_cache) {
   IREE_ASSERT_ARGUMENT(out_file_cache);
   *out_file_cache = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -46,6 +84,7 @@ IREE_API_EXPORT iree_status_t iree_hal_file_cache_create(
                                 (void**)&file_cache));
   iree_atomic_ref_count_init(&file_cache->ref_count);
   file_cache->host_allocator = host_allocator;
+  file_cache->params = params;
 
   iree_slim_mutex_initialize(&file_cache->mutex);
 
@@ -54,18 +93,47 @@ IREE_API_EXPORT iree_status_t iree_hal_file_cache_create(
   file_cache->entry_capacity = 0;
   file_cache->entry_count = 0;
   file_cache->entries = NULL;
+  file_cache->unreferenced_count = 0;
+  file_cache->use_epoch = 0;
+  file_cache->scope_head = NULL;
 
   *out_file_cache = file_cache;
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
+static void iree_hal_file_cache_entry_free(iree_allocator_t host_allocator,
+                                           iree_hal_file_cache_entry_t* entry) {
+  iree_hal_file_release(entry->file);
+  iree_hal_device_release(entry->device);
+  iree_io_file_handle_release(entry->handle);
+  iree_allocator_free(host_allocator, entry);
+}
+
+static void iree_hal_file_cache_scope_free(iree_allocator_t host_allocator,
+                                           iree_hal_file_cache_scope_t* scope) {
+  iree_allocator_free(host_allocator, scope->entries);
+  iree_allocator_free(host_allocator, scope);
+}
+
 static void iree_hal_file_cache_destroy(iree_hal_file_cache_t* file_cache) {
   IREE_ASSERT_ARGUMENT(file_cache);
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_allocator_t host_allocator = file_cache->host_allocator;
 
-  iree_hal_file_cache_trim(file_cache);
+  // Users are expected to have released their scopes before releasing the
+  // cache but we drop any that remain along with all entries regardless of
+  // whether they are referenced.
+  iree_hal_file_cache_scope_t* scope = file_cache->scope_head;
+  while (scope) {
+    iree_hal_file_cache_scope_t* next_scope = scope->next;
+    iree_hal_file_cache_scope_free(host_allocator, scope);
+    scope = next_scope;
+  }
+  for (iree_host_size_t i = 0; i < file_cache->entry_count; ++i) {
+    iree_hal_file_cache_entry_free(host_allocator, file_cache->entries[i]);
+  }
+  iree_allocator_free(host_allocator, file_cache->entries);
 
   iree_slim_mutex_deinitialize(&file_cache->mutex);
 
@@ -89,47 +157,142 @@ IREE_API_EXPORT void iree_hal_file_cache_release(
   }
 }
 
+// Evicts least-recently-used unreferenced entries until no more than
+// |budget| remain. Both the eviction scan and the removal are linear in the
+// number of entries; caches are expected to hold few files (one per parameter
+// archive per device) so this is not worth a more complex structure.
+static void iree_hal_file_cache_evict_unsafe(iree_hal_file_cache_t* file_cache,
+                                             iree_host_size_t budget) {
+  while (file_cache->unreferenced_count > budget) {
+    iree_host_size_t victim_index = IREE_HOST_SIZE_MAX;
+    for (iree_host_size_t i = 0; i < file_cache->entry_count; ++i) {
+      iree_hal_file_cache_entry_t* entry = file_cache->entries[i];
+      if (entry->scope_count > 0) continue;
+      if (victim_index == IREE_HOST_SIZE_MAX ||
+          entry->last_use < file_cache->entries[victim_index]->last_use) {
+        victim_index = i;
+      }
+    }
+    IREE_ASSERT(victim_index != IREE_HOST_SIZE_MAX);
+    if (victim_index == IREE_HOST_SIZE_MAX) break;
+
+    // Compact the entries list to keep it dense.
+    iree_hal_file_cache_entry_t* victim = file_cache->entries[victim_index];
+    memmove(&file_cache->entries[victim_index],
+            &file_cache->entries[victim_index + 1],
+            (file_cache->entry_count - victim_index - 1) *
+                sizeof(file_cache->entries[0]));
+    --file_cache->entry_count;
+    --file_cache->unreferenced_count;
+    iree_hal_file_cache_entry_free(file_cache->host_allocator, victim);
+  }
+}
+
 IREE_API_EXPORT void iree_hal_file_cache_trim(
     iree_hal_file_cache_t* file_cache) {
   IREE_ASSERT_ARGUMENT(file_cache);
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_allocator_t host_allocator = file_cache->host_allocator;
-
   iree_slim_mutex_lock(&file_cache->mutex);
 
-  for (iree_host_size_t i = 0; i < file_cache->entry_count; ++i) {
-    iree_hal_file_cache_entry_t* entry = file_cache->entries[i];
-    iree_hal_file_release(entry->file);
-    iree_hal_device_release(entry->device);
-    iree_io_file_handle_release(entry->handle);
-    iree_allocator_free(host_allocator, entry);
-  }
-  file_cache->entry_count = 0;
-  if (file_cache->entries) {
-    iree_allocator_free(host_allocator, file_cache->entries);
+  iree_hal_file_cache_evict_unsafe(file_cache, 0);
+  if (file_cache->entry_count == 0 && file_cache->entries) {
+    iree_allocator_free(file_cache->host_allocator, file_cache->entries);
     file_cache->entries = NULL;
     file_cache->entry_capacity = 0;
   }
 
   iree_slim_mutex_unlock(&file_cache->mutex);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_hal_file_cache_scope_t* iree_hal_file_cache_find_scope_unsafe(
+    iree_hal_file_cache_t* file_cache, iree_string_view_t name) {
+  for (iree_hal_file_cache_scope_t* scope = file_cache->scope_head; scope;
+       scope = scope->next) {
+    if (iree_string_view_equal(scope->name, name)) return scope;
+  }
+  return NULL;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_file_cache_acquire_scope(
+    iree_hal_file_cache_t* file_cache, iree_string_view_t scope) {
+  IREE_ASSERT_ARGUMENT(file_cache);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, scope.data, scope.size);
+  iree_slim_mutex_lock(&file_cache->mutex);
+
+  iree_status_t status = iree_ok_status();
+  iree_hal_file_cache_scope_t* existing_scope =
+      iree_hal_file_cache_find_scope_unsafe(file_cache, scope);
+  if (existing_scope) {
+    ++existing_scope->ref_count;
+  } else {
+    iree_hal_file_cache_scope_t* new_scope = NULL;
+    status = iree_allocator_malloc(file_cache->host_allocator,
+                                   sizeof(*new_scope) + scope.size,
+                                   (void**)&new_scope);
+    if (iree_status_is_ok(status)) {
+      new_scope->ref_count = 1;
+      new_scope->entry_capacity = 0;
+      new_scope->entry_count = 0;
+      new_scope->entries = NULL;
+      new_scope->name = iree_make_string_view(
+          (const char*)new_scope + sizeof(*new_scope), scope.size);
+      memcpy((void*)new_scope->name.data, scope.data, scope.size);
+      new_scope->next = file_cache->scope_head;
+      file_cache->scope_head = new_scope;
+    }
+  }
 
+  iree_slim_mutex_unlock(&file_cache->mutex);
   IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
-static iree_status_t iree_hal_file_cache_reserve_unsafe(
-    iree_hal_file_cache_t* file_cache, iree_host_size_t new_capacity) {
+IREE_API_EXPORT void iree_hal_file_cache_release_scope(
+    iree_hal_file_cache_t* file_cache, iree_string_view_t scope) {
   IREE_ASSERT_ARGUMENT(file_cache);
-  if (new_capacity < file_cache->entry_capacity) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, scope.data, scope.size);
+  iree_slim_mutex_lock(&file_cache->mutex);
+
+  iree_hal_file_cache_scope_t** scope_ptr = &file_cache->scope_head;
+  while (*scope_ptr && !iree_string_view_equal((*scope_ptr)->name, scope)) {
+    scope_ptr = &(*scope_ptr)->next;
+  }
+  iree_hal_file_cache_scope_t* released_scope = *scope_ptr;
+  IREE_ASSERT(released_scope, "releasing a scope that was not acquired");
+  if (released_scope && --released_scope->ref_count == 0) {
+    // Drop the scope references on all of its entries; any that are no longer
+    // referenced by other scopes become subject to eviction.
+    for (iree_host_size_t i = 0; i < released_scope->entry_count; ++i) {
+      iree_hal_file_cache_entry_t* entry = released_scope->entries[i];
+      if (--entry->scope_count == 0) ++file_cache->unreferenced_count;
+    }
+    *scope_ptr = released_scope->next;
+    iree_hal_file_cache_scope_free(file_cache->host_allocator, released_scope);
+    iree_hal_file_cache_evict_unsafe(file_cache,
+                                     file_cache->params.eviction_budget);
+  }
+
+  iree_slim_mutex_unlock(&file_cache->mutex);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_hal_file_cache_reserve_unsafe(
+    iree_allocator_t host_allocator, iree_host_size_t new_capacity,
+    iree_host_size_t* capacity, iree_hal_file_cache_entry_t*** entries) {
+  if (new_capacity < *capacity) return iree_ok_status();
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_capacity);
 
-  iree_hal_file_cache_entry_t** new_entries = file_cache->entries;
+  iree_hal_file_cache_entry_t** new_entries = *entries;
   iree_status_t status = iree_allocator_realloc(
-      file_cache->host_allocator, new_capacity * sizeof(file_cache->entries[0]),
+      host_allocator, new_capacity * sizeof(new_entries[0]),
       (void**)&new_entries);
   if (iree_status_is_ok(status)) {
-    file_cache->entry_capacity = new_capacity;
-    file_cache->entries = new_entries;
+    *capacity = new_capacity;
+    *entries = new_entries;
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -139,11 +302,14 @@ static iree_status_t iree_hal_file_cache_reserve_unsafe(
 static iree_status_t iree_hal_file_cache_insert_unsafe(
     iree_hal_file_cache_t* file_cache, iree_hal_device_t* device,
     iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
-    iree_io_file_handle_t* handle, iree_hal_file_t* file) {
+    iree_io_file_handle_t* handle, iree_hal_file_t* file,
+    iree_hal_file_cache_entry_t** out_entry) {
   // Ensure there's space to grow the cache table.
   if (file_cache->entry_count == file_cache->entry_capacity) {
     IREE_RETURN_IF_ERROR(iree_hal_file_cache_reserve_unsafe(
-        file_cache, iree_max(16u, file_cache->entry_capacity * 2)));
+        file_cache->host_allocator,
+        iree_max(16u, file_cache->entry_capacity * 2),
+        &file_cache->entry_capacity, &file_cache->entries));
   }
 
   // Allocate the cache entry and retain all resources.
@@ -158,17 +324,38 @@ static iree_status_t iree_hal_file_cache_insert_unsafe(
   entry->access = access;
   entry->file = file;
   iree_hal_file_retain(entry->file);
+  entry->scope_count = 0;
+  entry->last_use = 0;
 
   file_cache->entries[file_cache->entry_count++] = entry;
+  ++file_cache->unreferenced_count;
 
+  *out_entry = entry;
+  return iree_ok_status();
+}
+
+// Adds a reference from |scope| to |entry| if it does not already have one.
+static iree_status_t iree_hal_file_cache_scope_reference_unsafe(
+    iree_hal_file_cache_t* file_cache, iree_hal_file_cache_scope_t* scope,
+    iree_hal_file_cache_entry_t* entry) {
+  for (iree_host_size_t i = 0; i < scope->entry_count; ++i) {
+    if (scope->entries[i] == entry) return iree_ok_status();
+  }
+  if (scope->entry_count == scope->entry_capacity) {
+    IREE_RETURN_IF_ERROR(iree_hal_file_cache_reserve_unsafe(
+        file_cache->host_allocator, iree_max(4u, scope->entry_capacity * 2),
+        &scope->entry_capacity, &scope->entries));
+  }
+  scope->entries[scope->entry_count++] = entry;
+  if (entry->scope_count++ == 0) --file_cache->unreferenced_count;
   return iree_ok_status();
 }
 
 IREE_API_EXPORT iree_status_t iree_hal_file_cache_lookup(
-    iree_hal_file_cache_t* file_cache, iree_hal_device_t* device,
-    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
-    iree_io_file_handle_t* handle, iree_hal_external_file_flags_t flags,
-    iree_hal_file_t** out_file) {
+    iree_hal_file_cache_t* file_cache, iree_string_view_t scope,
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
   IREE_ASSERT_ARGUMENT(file_cache);
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(handle);
@@ -177,42 +364,63 @@ IREE_API_EXPORT iree_status_t iree_hal_file_cache_lookup(
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_slim_mutex_lock(&file_cache->mutex);
 
+  iree_hal_file_cache_scope_t* cache_scope =
+      iree_hal_file_cache_find_scope_unsafe(file_cache, scope);
+  if (!cache_scope) {
+    iree_slim_mutex_unlock(&file_cache->mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "file cache scope `%.*s` has not been acquired",
+                            (int)scope.size, scope.data);
+  }
+
   // Scan the cache to see if we have an already imported file we can use.
+  iree_hal_file_cache_entry_t* entry = NULL;
   for (iree_host_size_t i = 0; i < file_cache->entry_count; ++i) {
-    iree_hal_file_cache_entry_t* entry = file_cache->entries[i];
-    if (entry->device == device &&
-        iree_all_bits_set(entry->queue_affinity, queue_affinity) &&
-        iree_all_bits_set(entry->access, access) && entry->handle == handle) {
-      iree_hal_file_t* file = entry->file;
-      iree_hal_file_retain(file);
-      iree_slim_mutex_unlock(&file_cache->mutex);
-      *out_file = file;
-      IREE_TRACE_ZONE_END(z0);
-      return iree_ok_status();
+    iree_hal_file_cache_entry_t* existing_entry = file_cache->entries[i];
+    if (existing_entry->device == device &&
+        iree_all_bits_set(existing_entry->queue_affinity, queue_affinity) &&
+        iree_all_bits_set(existing_entry->access, access) &&
+        existing_entry->handle == handle) {
+      entry = existing_entry;
+      break;
     }
   }
 
-  // Import the file. This could be slow and ideally we'd not hold the mutex
-  // such that other files can still be accessed through the cache but (today)
-  // it's unexpected that file I/O initialization is a hot path.
-  iree_hal_file_t* file = NULL;
-  iree_status_t status = iree_hal_file_import(device, queue_affinity, access,
-                                              handle, flags, &file);
+  // Import the file if not found. This could be slow and ideally we'd not hold
+  // the mutex such that other files can still be accessed through the cache
+  // but (today) it's unexpected that file I/O initialization is a hot path.
+  iree_status_t status = iree_ok_status();
+  if (!entry) {
+    iree_hal_file_t* file = NULL;
+    status = iree_hal_file_import(device, queue_affinity, access, handle, flags,
+                                  &file);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_file_cache_insert_unsafe(
+          file_cache, device, queue_affinity, access, handle, file, &entry);
+    }
+    iree_hal_file_release(file);
+  }
 
-  // Insert into cache as an append.
-  // If we support removal we'll compact the entries list at the time an entry
-  // is removed to keep this simple.
+  // Reference the entry from the scope and mark it as recently used.
   if (iree_status_is_ok(status)) {
-    status = iree_hal_file_cache_insert_unsafe(
-        file_cache, device, queue_affinity, access, handle, file);
+    status = iree_hal_file_cache_scope_reference_unsafe(file_cache,
+                                                        cache_scope, entry);
   }
-
-  iree_slim_mutex_unlock(&file_cache->mutex);
+  iree_hal_file_t* file = NULL;
   if (iree_status_is_ok(status)) {
-    *out_file = file;
-  } else {
-    iree_hal_file_release(file);
+    entry->last_use = ++file_cache->use_epoch;
+    file = entry->file;
+    iree_hal_file_retain(file);
   }
+
+  // A failure to reference a newly inserted entry may leave it unreferenced
+  // and push the cache over budget.
+  iree_hal_file_cache_evict_unsafe(file_cache,
+                                   file_cache->params.eviction_budget);
+
+  iree_slim_mutex_unlock(&file_cache->mutex);
+  *out_file = file;
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -17,14 +17,40 @@ extern "C" {
 
 // An in-memory cache of file handles to devices and queues that have an open
 // HAL file reference. A single file cache may be shared across multiple devices
-// and/or multiple queues within individual devices.
+// and/or multiple queues within individual devices as well as across multiple
+// parameter providers (and the VM contexts using them) such that files are
+// only imported once per device.
+//
+// Cache entries are referenced by named scopes: each user of the cache acquires
+// its scope for as long as it may look up files and any entry looked up within
+// a scope is kept alive until all scopes referencing it have been released.
+// Entries not referenced by any scope are retained up to an eviction budget and
+// evicted in least-recently-used order beyond that. This allows a context that
+// is torn down and recreated (or a sibling context using the same parameter
+// archive) to reuse the files imported by its predecessor.
 //
 // Thread-safe: multiple threads can access the cache concurrently.
 typedef struct iree_hal_file_cache_t iree_hal_file_cache_t;
 
+// Parameters used to configure an iree_hal_file_cache_t.
+// These cannot be changed once the cache has been created.
+typedef struct iree_hal_file_cache_params_t {
+  // Maximum number of entries not referenced by any acquired scope that will be
+  // retained. Beyond this the least-recently-used unreferenced entries are
+  // evicted. IREE_HOST_SIZE_MAX retains all entries until the cache is trimmed
+  // and 0 drops entries as soon as they are no longer referenced.
+  iree_host_size_t eviction_budget;
+} iree_hal_file_cache_params_t;
+
+// Initializes |out_params| to the default values.
+// By default unreferenced entries are retained until the cache is trimmed.
+IREE_API_EXPORT void iree_hal_file_cache_params_initialize(
+    iree_hal_file_cache_params_t* out_params);
+
 // Creates a new empty file cache.
 IREE_API_EXPORT iree_status_t iree_hal_file_cache_create(
-    iree_allocator_t host_allocator, iree_hal_file_cache_t** out_file_cache);
+    iree_hal_file_cache_params_t params, iree_allocator_t host_allocator,
+    iree_hal_file_cache_t** out_file_cache);
 
 // Retains the given |file_cache| for the caller.
 IREE_API_EXPORT void iree_hal_file_cache_retain(
@@ -34,22 +60,37 @@ IREE_API_EXPORT void iree_hal_file_cache_retain(
 IREE_API_EXPORT void iree_hal_file_cache_release(
     iree_hal_file_cache_t* file_cache);
 
-// Drops all cached file references.
+// Drops all cached file references not referenced by an acquired scope.
 // Note that resources may not be returned to the system immediately as others
 // may still retain them. Avoid trimming in such cases as it can easily lead
 // to multiple open files pointing at the same underlying resources.
 IREE_API_EXPORT void iree_hal_file_cache_trim(
     iree_hal_file_cache_t* file_cache);
 
+// Acquires a reference to |scope| in the cache. Entries looked up within the
+// scope will be retained until a matching number of
+// iree_hal_file_cache_release_scope calls have been made. Multiple users may
+// acquire the same scope and will share its entries.
+IREE_API_EXPORT iree_status_t iree_hal_file_cache_acquire_scope(
+    iree_hal_file_cache_t* file_cache, iree_string_view_t scope);
+
+// Releases a reference to |scope| previously acquired with
+// iree_hal_file_cache_acquire_scope. When the last reference is released any
+// entries no longer referenced by any scope become eligible for eviction.
+IREE_API_EXPORT void iree_hal_file_cache_release_scope(
+    iree_hal_file_cache_t* file_cache, iree_string_view_t scope);
+
 // Looks up the file |handle| for use on |device| with any of the queues
 // specified with |queue_affinity| and returns it retained in |out_file|.
 // If the file has not been used on the device yet it will be imported and
-// cached until the cache is trimmed.
+// cached. The entry is referenced by |scope| (which may be the empty default
+// scope) and |scope| must have been acquired with
+// iree_hal_file_cache_acquire_scope.
 IREE_API_EXPORT iree_status_t iree_hal_file_cache_lookup(
-    iree_hal_file_cache_t* file_cache, iree_hal_device_t* device,
-    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
-    iree_io_file_handle_t* handle, iree_hal_external_file_flags_t flags,
-    iree_hal_file_t** out_file);
+    iree_hal_file_cache_t* file_cache, iree_string_view_t scope,
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file);
 
 #ifdef __cplusplus
 }  // extern "C"
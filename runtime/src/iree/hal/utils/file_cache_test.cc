@@ -0,0 +1,226 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/file_cache.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// Placeholder file returned by the test device. Files are only compared by
+// identity and the live count tracks whether the cache has released them.
+typedef struct iree_hal_test_file_t {
+  iree_hal_resource_t resource;
+  int* live_count;
+} iree_hal_test_file_t;
+
+typedef struct iree_hal_test_file_vtable_t {
+  void(IREE_API_PTR* destroy)(iree_hal_test_file_t* file);
+} iree_hal_test_file_vtable_t;
+IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_test_file_vtable_t);
+
+static void iree_hal_test_file_destroy(iree_hal_test_file_t* file) {
+  --*file->live_count;
+  delete file;
+}
+
+static const iree_hal_test_file_vtable_t iree_hal_test_file_vtable = {
+    /*.destroy=*/iree_hal_test_file_destroy,
+};
+
+// Minimal device that only supports importing files. The device outlives all
+// caches in the tests so destruction is a no-op.
+typedef struct iree_hal_test_device_t {
+  iree_hal_resource_t resource;
+  int import_count;
+  int live_file_count;
+} iree_hal_test_device_t;
+
+static void iree_hal_test_device_destroy(iree_hal_device_t* device) {}
+
+static iree_status_t iree_hal_test_device_import_file(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
+    iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
+  auto* device = (iree_hal_test_device_t*)base_device;
+  auto* file = new iree_hal_test_file_t();
+  iree_hal_resource_initialize(&iree_hal_test_file_vtable, &file->resource);
+  file->live_count = &device->live_file_count;
+  ++device->import_count;
+  ++device->live_file_count;
+  *out_file = (iree_hal_file_t*)file;
+  return iree_ok_status();
+}
+
+static const iree_hal_device_vtable_t* iree_hal_test_device_vtable() {
+  static iree_hal_device_vtable_t vtable = []() {
+    iree_hal_device_vtable_t vtable;
+    memset(&vtable, 0, sizeof(vtable));
+    vtable.destroy = iree_hal_test_device_destroy;
+    vtable.import_file = iree_hal_test_device_import_file;
+    return vtable;
+  }();
+  return &vtable;
+}
+
+static const iree_string_view_t kScopeA = iree_make_cstring_view("a");
+static const iree_string_view_t kScopeB = iree_make_cstring_view("b");
+
+struct FileCacheTest : public ::testing::Test {
+  iree_hal_test_device_t test_device;
+  uint8_t storage[3][16];
+  iree_io_file_handle_t* handles[3] = {NULL};
+
+  void SetUp() override {
+    memset(&test_device, 0, sizeof(test_device));
+    iree_hal_resource_initialize(iree_hal_test_device_vtable(),
+                                 &test_device.resource);
+    for (int i = 0; i < 3; ++i) {
+      IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+          IREE_IO_FILE_ACCESS_READ,
+          iree_make_byte_span(storage[i], sizeof(storage[i])),
+          iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+          &handles[i]));
+    }
+  }
+
+  void TearDown() override {
+    for (auto* handle : handles) iree_io_file_handle_release(handle);
+    EXPECT_EQ(test_device.live_file_count, 0);
+  }
+
+  iree_hal_device_t* device() { return (iree_hal_device_t*)&test_device; }
+
+  iree_hal_file_cache_t* CreateCache(iree_host_size_t eviction_budget) {
+    iree_hal_file_cache_params_t params;
+    iree_hal_file_cache_params_initialize(&params);
+    params.eviction_budget = eviction_budget;
+    iree_hal_file_cache_t* file_cache = NULL;
+    IREE_CHECK_OK(iree_hal_file_cache_create(params, iree_allocator_system(),
+                                             &file_cache));
+    return file_cache;
+  }
+
+  // Looks up |handle| in |scope| and drops the returned file reference.
+  void Lookup(iree_hal_file_cache_t* file_cache, iree_string_view_t scope,
+              int handle) {
+    iree_hal_file_t* file = NULL;
+    IREE_ASSERT_OK(iree_hal_file_cache_lookup(
+        file_cache, scope, device(), IREE_HAL_QUEUE_AFFINITY_ANY,
+        IREE_HAL_MEMORY_ACCESS_READ, handles[handle],
+        IREE_HAL_EXTERNAL_FILE_FLAG_NONE, &file));
+    ASSERT_NE(file, nullptr);
+    iree_hal_file_release(file);
+  }
+};
+
+// Tests that repeated lookups within and across scopes import only once.
+TEST_F(FileCacheTest, SharedAcrossScopes) {
+  iree_hal_file_cache_t* file_cache = CreateCache(IREE_HOST_SIZE_MAX);
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeA));
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeB));
+  Lookup(file_cache, kScopeA, 0);
+  Lookup(file_cache, kScopeA, 0);
+  Lookup(file_cache, kScopeB, 0);
+  EXPECT_EQ(test_device.import_count, 1);
+  Lookup(file_cache, kScopeB, 1);
+  EXPECT_EQ(test_device.import_count, 2);
+  iree_hal_file_cache_release_scope(file_cache, kScopeA);
+  iree_hal_file_cache_release_scope(file_cache, kScopeB);
+  EXPECT_EQ(test_device.live_file_count, 2);
+  iree_hal_file_cache_release(file_cache);
+}
+
+// Tests that lookups require the scope to have been acquired.
+TEST_F(FileCacheTest, LookupUnacquiredScope) {
+  iree_hal_file_cache_t* file_cache = CreateCache(IREE_HOST_SIZE_MAX);
+  iree_hal_file_t* file = NULL;
+  EXPECT_THAT(Status(iree_hal_file_cache_lookup(
+                  file_cache, kScopeA, device(), IREE_HAL_QUEUE_AFFINITY_ANY,
+                  IREE_HAL_MEMORY_ACCESS_READ, handles[0],
+                  IREE_HAL_EXTERNAL_FILE_FLAG_NONE, &file)),
+              StatusIs(StatusCode::kFailedPrecondition));
+  EXPECT_EQ(file, nullptr);
+  EXPECT_EQ(test_device.import_count, 0);
+  iree_hal_file_cache_release(file_cache);
+}
+
+// Tests that entries are kept while any scope references them and that
+// trimming only drops unreferenced entries.
+TEST_F(FileCacheTest, TrimKeepsReferencedEntries) {
+  iree_hal_file_cache_t* file_cache = CreateCache(IREE_HOST_SIZE_MAX);
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeA));
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeB));
+  Lookup(file_cache, kScopeA, 0);
+  Lookup(file_cache, kScopeB, 0);
+  Lookup(file_cache, kScopeB, 1);
+
+  // Scope A still references handle 0 so only handle 1 is dropped.
+  iree_hal_file_cache_release_scope(file_cache, kScopeB);
+  iree_hal_file_cache_trim(file_cache);
+  EXPECT_EQ(test_device.live_file_count, 1);
+  Lookup(file_cache, kScopeA, 0);
+  EXPECT_EQ(test_device.import_count, 2);
+
+  iree_hal_file_cache_release_scope(file_cache, kScopeA);
+  iree_hal_file_cache_trim(file_cache);
+  EXPECT_EQ(test_device.live_file_count, 0);
+  iree_hal_file_cache_release(file_cache);
+}
+
+// Tests that a scope acquired multiple times keeps its entries until fully
+// released and that a recreated scope reuses retained entries.
+TEST_F(FileCacheTest, ScopeReacquire) {
+  iree_hal_file_cache_t* file_cache = CreateCache(IREE_HOST_SIZE_MAX);
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeA));
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeA));
+  Lookup(file_cache, kScopeA, 0);
+  iree_hal_file_cache_release_scope(file_cache, kScopeA);
+  iree_hal_file_cache_trim(file_cache);
+  EXPECT_EQ(test_device.live_file_count, 1);
+  iree_hal_file_cache_release_scope(file_cache, kScopeA);
+
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeA));
+  Lookup(file_cache, kScopeA, 0);
+  EXPECT_EQ(test_device.import_count, 1);
+  iree_hal_file_cache_release_scope(file_cache, kScopeA);
+  iree_hal_file_cache_release(file_cache);
+}
+
+// Tests that unreferenced entries beyond the budget are evicted in LRU order.
+TEST_F(FileCacheTest, EvictionBudget) {
+  iree_hal_file_cache_t* file_cache = CreateCache(/*eviction_budget=*/1);
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeA));
+  Lookup(file_cache, kScopeA, 0);
+  Lookup(file_cache, kScopeA, 1);
+  Lookup(file_cache, kScopeA, 0);  // handle 1 is now least recently used
+  iree_hal_file_cache_release_scope(file_cache, kScopeA);
+  EXPECT_EQ(test_device.live_file_count, 1);
+
+  // Handle 0 was retained and is reused; handle 1 was evicted.
+  IREE_ASSERT_OK(iree_hal_file_cache_acquire_scope(file_cache, kScopeB));
+  Lookup(file_cache, kScopeB, 0);
+  EXPECT_EQ(test_device.import_count, 2);
+  Lookup(file_cache, kScopeB, 1);
+  EXPECT_EQ(test_device.import_count, 3);
+  iree_hal_file_cache_release_scope(file_cache, kScopeB);
+  EXPECT_EQ(test_device.live_file_count, 1);
+  iree_hal_file_cache_release(file_cache);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -6,21 +6,22 @@
 
 #include "iree/hal/utils/file_transfer.h"
 
-#include "iree/base/internal/math.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/hal/utils/memory_file.h"
 
 //===----------------------------------------------------------------------===//
 // Configuration
 //===----------------------------------------------------------------------===//
 
-// TODO(benvanik): make these either compile-time configuration options so we
-// can prune code paths or flags (somehow).
+// These are only defaults used when the transfer options do not specify values.
+// Devices should expose iree_hal_file_transfer_options_t fields in their
+// creation parameters so that hosts can tune for their storage.
 
 #if !defined(IREE_HAL_TRANSFER_WORKER_LIMIT)
-// Maximum number of workers that will be used. This is something we can derive
-// from the transfer size and the loop; small transfers or synchronous loops
-// should have 1 and we can measure to see how many others we need.
-#define IREE_HAL_TRANSFER_WORKER_LIMIT 1
+// Maximum number of workers that will be used when the worker count is derived
+// automatically. Even when driven by an inline loop one worker can stage its
+// chunk on the host while the device queue operation of another is in-flight.
+#define IREE_HAL_TRANSFER_WORKER_LIMIT 2
 #endif  // !IREE_HAL_TRANSFER_WORKER_LIMIT
 
 #if !defined(IREE_HAL_TRANSFER_CHUNK_SIZE)
@@ -51,9 +52,12 @@
 // the operation workers array.
 typedef uint64_t iree_hal_transfer_worker_bitmask_t;
 
-// Counts the total number of workers indicated by the given worker bitmask.
-#define iree_hal_transfer_worker_live_count(bitmask) \
-  iree_math_count_ones_u64(bitmask)
+// Returns a bitmask with a bit set for each of the first |worker_count|
+// workers.
+#define iree_hal_transfer_worker_mask(worker_count)      \
+  ((worker_count) >= IREE_HAL_TRANSFER_WORKER_MAX_COUNT \
+       ? ~0ull                                          \
+       : ((1ull << (worker_count)) - 1))
 
 // Describes the direction of a transfer operation.
 typedef enum {
@@ -95,6 +99,10 @@ typedef struct iree_hal_transfer_worker_t {
 } iree_hal_transfer_worker_t;
 
 // Manages an asynchronous transfer operation.
+//
+// Workers may run concurrently if the loop the operation is scheduled on
+// executes callbacks from multiple threads. All state shared between workers is
+// accessed atomically and each worker only touches its own worker state.
 typedef struct iree_hal_transfer_operation_t {
   // Some loop implementations are re-entrant and we need to be able to handle
   // the operation completing immediately upon allocation instead of
@@ -122,8 +130,9 @@ typedef struct iree_hal_transfer_operation_t {
 
   // Sticky error status; when any worker fails this will be set to non-OK and
   // when all workers end the staging buffer will be deallocated and the signal
-  // semaphores will be marked as failing.
-  iree_status_t error_status;
+  // semaphores will be marked as failing. Stores an iree_status_t and is only
+  // set once by the first worker to fail.
+  iree_atomic_intptr_t error_status;
   // Original user semaphores to signal at the end of the transfer operation.
   // Contents are stored at the end of the struct.
   iree_hal_semaphore_list_t signal_semaphore_list;
@@ -133,12 +142,15 @@ typedef struct iree_hal_transfer_operation_t {
   iree_hal_buffer_t* staging_buffer;
   iree_device_size_t staging_buffer_size;
 
-  // Offset to where the transfer head is in the operation.
-  // Ranges from 0 at the start and length at the end.
-  // Workers use this to consume chunks of the operation.
-  iree_device_size_t transfer_head;
-  // Total number of chunks remaining in the transfer.
-  iree_host_size_t remaining_chunks;
+  // Size of each chunk of the transfer in bytes. All workers use the same chunk
+  // size so chunk i always covers [i * chunk_size, (i + 1) * chunk_size).
+  iree_device_size_t chunk_size;
+  // Total number of chunks in the transfer.
+  int64_t total_chunks;
+  // Ordinal of the next chunk to be claimed by a worker. Ranges from 0 at the
+  // start and total_chunks (or beyond) at the end. Workers atomically increment
+  // this to claim chunks of the operation.
+  iree_atomic_int64_t next_chunk;
 
   // Total number of workers participating in the operation.
   iree_host_size_t worker_count;
@@ -151,9 +163,68 @@ typedef struct iree_hal_transfer_operation_t {
   // When reading workers exit after enqueuing their final transfer such that
   // the final staging buffer dealloca can be asynchronously chained.
   // When writing workers exit after flushing their final chunk to the file.
-  iree_hal_transfer_worker_bitmask_t live_workers;
+  // Stores an iree_hal_transfer_worker_bitmask_t.
+  iree_atomic_int64_t live_workers;
 } iree_hal_transfer_operation_t;
 
+// Returns the number of chunks that have not yet been claimed by workers.
+static iree_host_size_t iree_hal_transfer_operation_remaining_chunks(
+    iree_hal_transfer_operation_t* operation) {
+  int64_t next_chunk =
+      iree_atomic_load_int64(&operation->next_chunk, iree_memory_order_acquire);
+  return next_chunk < operation->total_chunks
+             ? (iree_host_size_t)(operation->total_chunks - next_chunk)
+             : 0;
+}
+
+// Claims the next unprocessed chunk of the transfer and returns its offset and
+// length relative to the start of the operation. Returns false if all chunks
+// have already been claimed.
+static bool iree_hal_transfer_operation_claim_chunk(
+    iree_hal_transfer_operation_t* operation,
+    iree_device_size_t* out_transfer_offset,
+    iree_device_size_t* out_transfer_length) {
+  int64_t chunk = iree_atomic_fetch_add_int64(&operation->next_chunk, 1,
+                                              iree_memory_order_acq_rel);
+  if (chunk >= operation->total_chunks) return false;
+  iree_device_size_t transfer_offset =
+      (iree_device_size_t)chunk * operation->chunk_size;
+  *out_transfer_offset = transfer_offset;
+  *out_transfer_length =
+      iree_min(operation->length - transfer_offset, operation->chunk_size);
+  return true;
+}
+
+// Returns a bitmask of the workers that are currently live.
+static iree_hal_transfer_worker_bitmask_t
+iree_hal_transfer_operation_live_workers(
+    iree_hal_transfer_operation_t* operation) {
+  return (iree_hal_transfer_worker_bitmask_t)iree_atomic_load_int64(
+      &operation->live_workers, iree_memory_order_acquire);
+}
+
+// Returns true if any worker has failed and the operation is aborting.
+static bool iree_hal_transfer_operation_has_failed(
+    iree_hal_transfer_operation_t* operation) {
+  return iree_atomic_load_intptr(&operation->error_status,
+                                 iree_memory_order_acquire) != 0;
+}
+
+// Sets the sticky error |status| on the operation if it is the first failure.
+// Takes ownership of |status|.
+static void iree_hal_transfer_operation_set_error(
+    iree_hal_transfer_operation_t* operation, iree_status_t status) {
+  if (iree_status_is_ok(status)) return;
+  intptr_t expected = 0;
+  if (!iree_atomic_compare_exchange_strong_intptr(
+          &operation->error_status, &expected, (intptr_t)status,
+          iree_memory_order_acq_rel, iree_memory_order_acquire)) {
+    // Another worker already failed; it's likely this is just telling us the
+    // worker has aborted.
+    iree_status_ignore(status);
+  }
+}
+
 static void iree_hal_transfer_operation_release(
     iree_hal_transfer_operation_t* operation);
 static void iree_hal_transfer_operation_destroy(
@@ -176,19 +247,28 @@ static iree_status_t iree_hal_transfer_operation_create(
   // Determine how many workers are required and their staging reservation.
   iree_device_size_t worker_chunk_size = options.chunk_size;
   if (worker_chunk_size == IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT) {
-    worker_chunk_size = iree_min(IREE_HAL_TRANSFER_CHUNK_SIZE, length);
+    worker_chunk_size = IREE_HAL_TRANSFER_CHUNK_SIZE;
   }
+  worker_chunk_size = iree_max(1, iree_min(worker_chunk_size, length));
   iree_device_size_t total_chunk_count =
       iree_device_size_ceil_div(length, worker_chunk_size);
-  iree_host_size_t worker_count = options.chunk_count;
+  iree_host_size_t worker_count = (iree_host_size_t)options.chunk_count;
   if (worker_count == IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT) {
     // Try to give each worker a couple chunks.
     worker_count = (iree_host_size_t)iree_device_size_ceil_div(
         total_chunk_count, IREE_HAL_TRANSFER_CHUNKS_PER_WORKER);
+    worker_count = iree_min(worker_count, IREE_HAL_TRANSFER_WORKER_LIMIT);
+  }
+  // Never use more workers than there are chunks or than fit in the staging
+  // limit (always allowing at least one worker).
+  if (options.staging_limit != IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT) {
+    worker_count = iree_min(
+        worker_count,
+        (iree_host_size_t)(options.staging_limit / worker_chunk_size));
   }
+  worker_count = iree_min(worker_count, (iree_host_size_t)total_chunk_count);
   worker_count =
-      iree_min(worker_count, iree_min(IREE_HAL_TRANSFER_WORKER_LIMIT,
-                                      IREE_HAL_TRANSFER_WORKER_MAX_COUNT));
+      iree_max(1, iree_min(worker_count, IREE_HAL_TRANSFER_WORKER_MAX_COUNT));
 
   // Calculate total size of the structure with all its associated data.
   iree_hal_transfer_operation_t* operation = NULL;
@@ -223,9 +303,14 @@ static iree_status_t iree_hal_transfer_operation_create(
   operation->buffer_offset = buffer_offset;
   operation->length = length;
   operation->staging_buffer_size = worker_count * worker_chunk_size;
-  operation->transfer_head = 0;
-  operation->remaining_chunks = (iree_host_size_t)total_chunk_count;
+  operation->chunk_size = worker_chunk_size;
+  operation->total_chunks = (int64_t)total_chunk_count;
+  iree_atomic_store_int64(&operation->next_chunk, 0, iree_memory_order_relaxed);
   operation->worker_count = worker_count;
+  iree_atomic_store_intptr(&operation->error_status, 0,
+                           iree_memory_order_relaxed);
+  iree_atomic_store_int64(&operation->live_workers, 0,
+                          iree_memory_order_relaxed);
 
   // Assign all pointers to the struct suffix storage.
   // We do this first so that if we have to free the struct we have valid
@@ -320,7 +405,8 @@ static void iree_hal_transfer_operation_destroy(
 
   // We don't want any pending loop operations when freeing as the loop event
   // handlers will try to access the memory.
-  IREE_ASSERT(operation->live_workers == 0, "all workers must have exited");
+  IREE_ASSERT(iree_hal_transfer_operation_live_workers(operation) == 0,
+              "all workers must have exited");
 
   for (iree_host_size_t i = 0; i < operation->worker_count; ++i) {
     iree_hal_semaphore_release(operation->workers[i].semaphore);
@@ -333,7 +419,8 @@ static void iree_hal_transfer_operation_destroy(
   iree_hal_buffer_release(operation->buffer);
   iree_hal_file_release(operation->file);
   iree_hal_device_release(operation->device);
-  iree_status_ignore(operation->error_status);
+  iree_status_ignore((iree_status_t)iree_atomic_load_intptr(
+      &operation->error_status, iree_memory_order_acquire));
 
   iree_allocator_free(host_allocator, operation);
 
@@ -354,7 +441,8 @@ static void iree_hal_transfer_operation_notify_completion(
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->trace_id);
 
   // We can only free the operation if no workers have pending work.
-  IREE_ASSERT(operation->live_workers == 0, "no workers can be live");
+  IREE_ASSERT(iree_hal_transfer_operation_live_workers(operation) == 0,
+              "no workers can be live");
 
   // Deallocating the staging buffer can only happen after all workers have
   // completed copies into/out-of it. In reads it's expected there are copies
@@ -382,7 +470,7 @@ static void iree_hal_transfer_operation_notify_completion(
   // failure payload.
   iree_hal_semaphore_list_t signal_semaphore_list =
       operation->signal_semaphore_list;
-  if (!iree_status_is_ok(operation->error_status)) {
+  if (iree_hal_transfer_operation_has_failed(operation)) {
     for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
       signal_semaphore_list.payload_values[i] =
           IREE_HAL_SEMAPHORE_FAILURE_VALUE;
@@ -423,19 +511,20 @@ static iree_status_t iree_hal_transfer_worker_exit(
   // Check if this is the first failure of an operation and set the error bit.
   // Otherwise we ignore the error here as it's probably just telling us the
   // worker has aborted.
-  if (iree_status_is_ok(operation->error_status) &&
-      !iree_status_is_ok(status)) {
-    operation->error_status = status;
-  } else {
-    iree_status_ignore(status);
-  }
+  iree_hal_transfer_operation_set_error(operation, status);
 
   // Clear the worker live bit and see if there are any more workers live. So
   // long as there is at least one we need to keep the operation running.
+  // Only the worker that clears the last bit observes an empty mask and
+  // completes the operation.
   iree_host_size_t worker_index =
       (iree_host_size_t)(worker - operation->workers);
-  operation->live_workers &= ~(1ull << worker_index);
-  if (operation->live_workers > 0) {
+  const iree_hal_transfer_worker_bitmask_t worker_bit = 1ull << worker_index;
+  const iree_hal_transfer_worker_bitmask_t previous_live_workers =
+      (iree_hal_transfer_worker_bitmask_t)iree_atomic_fetch_and_int64(
+          &operation->live_workers, (int64_t)~worker_bit,
+          iree_memory_order_acq_rel);
+  if ((previous_live_workers & ~worker_bit) != 0) {
     // Other workers are still live - this is just one worker exiting by not
     // rescheduling itself.
     iree_hal_transfer_operation_release(operation);
@@ -467,28 +556,26 @@ static iree_status_t iree_hal_transfer_worker_copy_file_to_buffer(
 
   // Bail immediately if the operation has failed.
   if (!iree_status_is_ok(status) ||
-      !iree_status_is_ok(operation->error_status)) {
+      iree_hal_transfer_operation_has_failed(operation)) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "bail: loop error");
     IREE_TRACE_ZONE_END(z0);
     return iree_hal_transfer_worker_exit(operation, worker, status);
   }
 
-  // Early-exit if we're out of chunks to process.
-  // This can happen with some loop implementations that run things in batches.
-  if (operation->remaining_chunks == 0) {
+  // Grab a piece of the transfer to operate on.
+  // Early-exit if we're out of chunks to process. This can happen with some
+  // loop implementations that run things in batches or when other workers
+  // running concurrently claimed the remaining chunks.
+  iree_device_size_t transfer_offset = 0;
+  iree_device_size_t transfer_length = 0;
+  if (!iree_hal_transfer_operation_claim_chunk(operation, &transfer_offset,
+                                               &transfer_length)) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "exit: no remaining chunks");
     IREE_TRACE_ZONE_END(z0);
     return iree_hal_transfer_worker_exit(operation, worker, iree_ok_status());
   }
-
-  // Grab a piece of the transfer to operate on.
-  --operation->remaining_chunks;
-  iree_device_size_t transfer_offset = operation->transfer_head;
-  iree_device_size_t transfer_length = iree_min(
-      operation->length - transfer_offset, worker->staging_buffer_length);
   IREE_ASSERT(transfer_length > 0,
               "should not have ticked if there was no work to do");
-  operation->transfer_head += transfer_length;
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_offset);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_length);
 
@@ -527,16 +614,16 @@ static iree_status_t iree_hal_transfer_worker_copy_file_to_buffer(
   }
 
   // Wait for the copy to complete and tick again if we expect there to be more
-  // work. If there are no more chunks to copy (or they are spoken for by other
-  // live workers) we can avoid the loop wait and exit such that the dealloca
-  // can chain on to the copy operations.
+  // work. If there are no more chunks to copy we can avoid the loop wait and
+  // exit such that the dealloca can chain on to the copy operations. Chunks
+  // already claimed are always processed by the worker that claimed them; we
+  // can't exit based on how many other workers are live as they may be making
+  // the same decision concurrently.
   if (iree_status_is_ok(status)) {
-    if (iree_hal_transfer_worker_live_count(operation->live_workers) >
-        operation->remaining_chunks) {
-      // Enough workers to cover all remaining chunks so we can exit now and
-      // avoid an additional host wake (+ latency) by the loop event.
-      IREE_TRACE_ZONE_APPEND_TEXT(z0,
-                                  "exit: remaining chunks covered by workers");
+    if (iree_hal_transfer_operation_remaining_chunks(operation) == 0) {
+      // All chunks have been claimed so we can exit now and avoid an
+      // additional host wake (+ latency) by the loop event.
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "exit: no remaining chunks");
       status = iree_hal_transfer_worker_exit(operation, worker, status);
     } else {
       status = iree_loop_wait_one(
@@ -604,31 +691,41 @@ static iree_status_t iree_hal_transfer_operation_launch_read(
 
   // After the alloca completes each worker will be at the same starting point.
   // We'll wait on each and start the worker-specific coroutines.
-  iree_status_t status = iree_ok_status();
+  //
+  // All workers are marked live before any starts as started workers may run
+  // concurrently with this loop and the operation completes when the last live
+  // bit is cleared. Workers that are not started exit immediately.
+  iree_atomic_store_int64(
+      &operation->live_workers,
+      (int64_t)iree_hal_transfer_worker_mask(operation->worker_count),
+      iree_memory_order_release);
+  bool launch_failed = false;
   for (iree_host_size_t worker_index = 0;
        worker_index < operation->worker_count; ++worker_index) {
     iree_hal_transfer_worker_t* worker = &operation->workers[worker_index];
-    operation->live_workers |= 1ull << worker_index;
     iree_hal_transfer_operation_retain(operation);
-    status = iree_loop_wait_one(
+
+    // It's possible that the entire operation completed inline.
+    if (launch_failed ||
+        iree_hal_transfer_operation_remaining_chunks(operation) == 0) {
+      iree_status_ignore(
+          iree_hal_transfer_worker_exit(operation, worker, iree_ok_status()));
+      continue;
+    }
+
+    iree_status_t status = iree_loop_wait_one(
         loop,
         iree_hal_semaphore_await(worker->semaphore, worker->pending_timepoint),
         iree_infinite_timeout(), iree_hal_transfer_worker_copy_file_to_buffer,
         worker);
     if (!iree_status_is_ok(status)) {
-      operation->live_workers &= ~(1ull << worker_index);
-      iree_hal_transfer_operation_release(operation);
-      break;
+      // Failed to wait on one of the workers. This is a fatal error but we may
+      // have already waited on some workers and need to instead set the sticky
+      // error flag so that when any complete they stop processing.
+      iree_status_ignore(
+          iree_hal_transfer_worker_exit(operation, worker, status));
+      launch_failed = true;
     }
-
-    // It's possible that the entire operation completed inline.
-    if (operation->remaining_chunks == 0) break;
-  }
-  if (!iree_status_is_ok(status)) {
-    // Failed to wait on one of the workers. This is a fatal error but we may
-    // have already waited on some workers and need to instead set the sticky
-    // error flag so that when any complete they stop processing.
-    operation->error_status = status;
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -646,36 +743,39 @@ static iree_status_t iree_hal_transfer_worker_copy_buffer_to_staging(
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)worker->trace_id);
 
   // If there's been an error we bail.
-  if (!iree_status_is_ok(operation->error_status)) {
+  if (iree_hal_transfer_operation_has_failed(operation)) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "bail: error bit set");
     IREE_TRACE_ZONE_END(z0);
     return iree_hal_transfer_worker_exit(operation, worker, iree_ok_status());
   }
 
-  // Grab a piece of the transfer to operate on.
-  IREE_ASSERT(operation->remaining_chunks > 0,
-              "should not have ticked if there was no work to do");
-  --operation->remaining_chunks;
-  iree_device_size_t transfer_offset = operation->transfer_head;
-  iree_device_size_t transfer_length = iree_min(
-      operation->length - transfer_offset, worker->staging_buffer_length);
+  // Grab a piece of the transfer to operate on. Other workers running
+  // concurrently may have claimed the remaining chunks.
+  iree_device_size_t transfer_offset = 0;
+  iree_device_size_t transfer_length = 0;
+  if (!iree_hal_transfer_operation_claim_chunk(operation, &transfer_offset,
+                                               &transfer_length)) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "exit: no remaining chunks");
+    IREE_TRACE_ZONE_END(z0);
+    return iree_hal_transfer_worker_exit(operation, worker, iree_ok_status());
+  }
   IREE_ASSERT(transfer_length > 0,
               "should not have ticked if there was no work to do");
-  operation->transfer_head += transfer_length;
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_offset);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_length);
 
   // Timeline increments by one.
+  uint64_t wait_timepoint = worker->pending_timepoint;
   iree_hal_semaphore_list_t wait_semaphore_list = {
       .count = 1,
       .semaphores = &worker->semaphore,
-      .payload_values = &worker->pending_timepoint,
+      .payload_values = &wait_timepoint,
   };
-  ++worker->pending_timepoint;
+  uint64_t signal_timepoint = ++worker->pending_timepoint;
   iree_hal_semaphore_list_t signal_semaphore_list = {
       .count = 1,
       .semaphores = &worker->semaphore,
-      .payload_values = &worker->pending_timepoint,
+      .payload_values = &signal_timepoint,
   };
 
   // Track the pending copy operation so we know where to place it in the file.
@@ -716,7 +816,7 @@ static iree_status_t iree_hal_transfer_worker_copy_staging_to_file(
 
   // Bail immediately if the operation has failed.
   if (!iree_status_is_ok(status) ||
-      !iree_status_is_ok(operation->error_status)) {
+      iree_hal_transfer_operation_has_failed(operation)) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "bail: loop error");
     IREE_TRACE_ZONE_END(z0);
     return iree_hal_transfer_worker_exit(operation, worker, status);
@@ -728,7 +828,8 @@ static iree_status_t iree_hal_transfer_worker_copy_staging_to_file(
       operation->staging_buffer, worker->staging_buffer_offset,
       worker->pending_transfer_length);
 
-  if (iree_status_is_ok(status) && operation->remaining_chunks == 0) {
+  if (iree_status_is_ok(status) &&
+      iree_hal_transfer_operation_remaining_chunks(operation) == 0) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "exit: no more chunks remaining to write");
     IREE_TRACE_ZONE_END(z0);
     return iree_hal_transfer_worker_exit(operation, worker, iree_ok_status());
@@ -796,29 +897,34 @@ static iree_status_t iree_hal_transfer_operation_launch_write(
 
   // After the alloca completes each worker will be at the same starting point.
   // We'll wait on each and start the worker-specific coroutines.
-  iree_status_t status = iree_ok_status();
+  //
+  // All workers are marked live before any starts as started workers may run
+  // concurrently with this loop and the operation completes when the last live
+  // bit is cleared. Workers that are not started exit immediately.
+  iree_atomic_store_int64(
+      &operation->live_workers,
+      (int64_t)iree_hal_transfer_worker_mask(operation->worker_count),
+      iree_memory_order_release);
   for (iree_host_size_t worker_index = 0;
        worker_index < operation->worker_count; ++worker_index) {
     iree_hal_transfer_worker_t* worker = &operation->workers[worker_index];
-    operation->live_workers |= 1ull << worker_index;
     iree_hal_transfer_operation_retain(operation);
 
+    // It's possible that the entire operation completed inline.
+    if (iree_hal_transfer_operation_remaining_chunks(operation) == 0) {
+      iree_status_ignore(
+          iree_hal_transfer_worker_exit(operation, worker, iree_ok_status()));
+      continue;
+    }
+
     // Issue the initial asynchronous copy from the source buffer to the worker
     // chunk. This will wait for the alloca to complete so that the staging
     // buffer is available for use. After the copy completes the worker will
-    // tick itself so long as there are chunks remaining to write.
-    status = iree_hal_transfer_worker_copy_buffer_to_staging(operation, worker,
-                                                             loop);
-    if (!iree_status_is_ok(status)) break;
-
-    // It's possible that the entire operation completed inline.
-    if (operation->remaining_chunks == 0) break;
-  }
-  if (!iree_status_is_ok(status)) {
-    // Failed to wait on one of the workers. This is a fatal error but we may
-    // have already waited on some workers and need to instead set the sticky
-    // error flag so that when any complete they stop processing.
-    operation->error_status = status;
+    // tick itself so long as there are chunks remaining to write. Failures
+    // exit the worker and set the sticky error flag on the operation so that
+    // other workers stop processing.
+    IREE_IGNORE_ERROR(iree_hal_transfer_worker_copy_buffer_to_staging(
+        operation, worker, loop));
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -20,17 +20,26 @@ extern "C" {
 
 #define IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT 0
 #define IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT 0
+#define IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT 0
 
 // Options for file-based transfer operations.
 typedef struct iree_hal_file_transfer_options_t {
   // Loop to use for asynchronous host operations. If inline then the transfer
-  // will run synchronously with the caller.
+  // will run synchronously with the caller though workers still overlap their
+  // host staging with the in-flight device queue operations of other workers.
+  // If the loop executes callbacks concurrently from multiple threads then
+  // workers will run in parallel.
+  // The loop must be able to wait on HAL semaphores: the task executor loop
+  // (iree_loop_task) cannot yet as semaphores do not export wait handles for
+  // its poller and all in-tree devices use an inline loop.
   iree_loop_t loop;
-  // Total number of staging buffer chunks to allocate.
+  // Total number of staging buffer chunks to allocate. Each chunk is processed
+  // by its own worker and the number of workers is clamped to the number of
+  // chunks in the transfer.
   // Setting to >1 will allow for overlapped staging and transfer at the cost
   // of additional staging buffer memory consumption.
   // IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT can be used to have the
-  // implementation select a chunk size based on whether the device can benefit
+  // implementation select a chunk count based on whether the device can benefit
   // from overlapping staging.
   iree_device_size_t chunk_count;
   // Maximum size of chunks in bytes. The size may be adjusted to meet alignment
@@ -38,6 +47,11 @@ typedef struct iree_hal_file_transfer_options_t {
   // IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT can be used to have the
   // implementation select a chunk size based on the size of the transfer.
   iree_device_size_t chunk_size;
+  // Maximum total size of the staging buffer in bytes across all chunks. The
+  // chunk count will be reduced to fit though at least one chunk will always
+  // be used.
+  // IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT indicates no limit.
+  iree_device_size_t staging_limit;
 } iree_hal_file_transfer_options_t;
 
 // EXPERIMENTAL: eventually we'll focus this only on emulating support where
@@ -0,0 +1,362 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tests the streaming file transfer utilities against the synchronous local
+// device as it requires no executor and has device queue operations that
+// complete inline. Transfers are driven either by an inline loop or by a loop
+// that runs each wait on its own thread so that workers run concurrently.
+
+#include "iree/hal/utils/file_transfer.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/hal/utils/memory_file.h"
+#include "iree/io/file_handle.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// Transfer length chosen to not be a multiple of the chunk sizes used below so
+// that the last chunk of each transfer is partial.
+static constexpr iree_device_size_t kTransferLength = 1000;
+
+// A loop that performs each wait on a new thread and issues the callback from
+// that thread. Callbacks from different waits run concurrently.
+class ThreadedLoop {
+ public:
+  ~ThreadedLoop() { Drain(); }
+
+  iree_loop_t loop() { return {this, &ThreadedLoop::Ctl}; }
+
+  // Blocks until all waits have completed and their callbacks have returned.
+  void Drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return pending_count_ == 0; });
+    std::vector<std::thread> threads;
+    threads.swap(threads_);
+    lock.unlock();
+    for (auto& thread : threads) thread.join();
+  }
+
+  // Returns the first error returned by a callback, if any.
+  iree_status_t ConsumeStatus() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::exchange(status_, iree_ok_status());
+  }
+
+  // Maximum number of callbacks that were running at the same time.
+  int max_concurrency() const { return max_concurrency_.load(); }
+
+ private:
+  static iree_status_t Ctl(void* self, iree_loop_command_t command,
+                           const void* params, void** inout_ptr) {
+    auto* loop = reinterpret_cast<ThreadedLoop*>(self);
+    switch (command) {
+      case IREE_LOOP_COMMAND_WAIT_ONE: {
+        const auto* wait_params =
+            reinterpret_cast<const iree_loop_wait_one_params_t*>(params);
+        loop->Enqueue(wait_params->callback, wait_params->wait_source,
+                      wait_params->deadline_ns);
+        return iree_ok_status();
+      }
+      case IREE_LOOP_COMMAND_DRAIN:
+        loop->Drain();
+        return iree_ok_status();
+      default:
+        return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "unsupported loop command %u", command);
+    }
+  }
+
+  void Enqueue(iree_loop_callback_t callback, iree_wait_source_t wait_source,
+               iree_time_t deadline_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++pending_count_;
+    threads_.emplace_back([this, callback, wait_source, deadline_ns]() {
+      iree_status_t wait_status = iree_wait_source_wait_one(
+          wait_source, iree_make_deadline(deadline_ns));
+      int concurrency = ++running_count_;
+      int max_concurrency = max_concurrency_.load();
+      while (concurrency > max_concurrency &&
+             !max_concurrency_.compare_exchange_weak(max_concurrency,
+                                                     concurrency)) {
+      }
+      // Give other workers a chance to run while this one is in its callback.
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      iree_status_t status =
+          callback.fn(callback.user_data, loop(), wait_status);
+      --running_count_;
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (iree_status_is_ok(status_)) {
+        status_ = status;
+      } else {
+        iree_status_ignore(status);
+      }
+      if (--pending_count_ == 0) idle_.notify_all();
+    });
+  }
+
+  std::mutex mutex_;
+  std::condition_variable idle_;
+  std::vector<std::thread> threads_;
+  int pending_count_ = 0;
+  iree_status_t status_ = iree_ok_status();
+  std::atomic<int> running_count_{0};
+  std::atomic<int> max_concurrency_{0};
+};
+
+class FileTransferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_hal_allocator_t* device_allocator = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &device_allocator));
+    iree_hal_sync_device_params_t params;
+    iree_hal_sync_device_params_initialize(&params);
+    IREE_ASSERT_OK(iree_hal_sync_device_create(
+        iree_make_cstring_view("local-sync"), &params, /*loader_count=*/0,
+        /*loaders=*/NULL, device_allocator, host_allocator, &device_));
+    iree_hal_allocator_release(device_allocator);
+    IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore_));
+  }
+
+  void TearDown() override {
+    iree_hal_semaphore_release(semaphore_);
+    iree_hal_device_release(device_);
+  }
+
+  // Wraps |contents| in a memory file. No device allocator is provided so that
+  // the file is never imported and transfers always take the streaming path.
+  iree_hal_file_t* WrapFile(std::vector<uint8_t>& contents) {
+    iree_io_file_handle_t* handle = NULL;
+    IREE_CHECK_OK(iree_io_file_handle_wrap_host_allocation(
+        IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+        iree_make_byte_span(contents.data(), contents.size()),
+        iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+        &handle));
+    iree_hal_file_t* file = NULL;
+    IREE_CHECK_OK(iree_hal_memory_file_wrap(
+        IREE_HAL_QUEUE_AFFINITY_ANY, IREE_HAL_MEMORY_ACCESS_ALL, handle,
+        /*device_allocator=*/NULL, iree_allocator_system(), &file));
+    iree_io_file_handle_release(handle);
+    return file;
+  }
+
+  iree_hal_buffer_t* AllocateBuffer(iree_device_size_t size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device_), params, size, &buffer));
+    return buffer;
+  }
+
+  // Returns transfer options using |threaded_loop| if provided and otherwise
+  // an inline loop storing its status in |loop_status|.
+  iree_hal_file_transfer_options_t MakeOptions(
+      iree_status_t* loop_status, ThreadedLoop* threaded_loop,
+      iree_device_size_t chunk_count, iree_device_size_t chunk_size,
+      iree_device_size_t staging_limit) {
+    iree_hal_file_transfer_options_t options;
+    options.loop =
+        threaded_loop ? threaded_loop->loop() : iree_loop_inline(loop_status);
+    options.chunk_count = chunk_count;
+    options.chunk_size = chunk_size;
+    options.staging_limit = staging_limit;
+    return options;
+  }
+
+  // Reads |kTransferLength| bytes of a patterned file into a buffer and
+  // verifies the buffer contents. The transfer runs on |threaded_loop| if
+  // provided and otherwise on an inline loop.
+  void ReadAndVerify(iree_device_size_t chunk_count,
+                     iree_device_size_t chunk_size,
+                     iree_device_size_t staging_limit,
+                     ThreadedLoop* threaded_loop = nullptr) {
+    std::vector<uint8_t> contents(kTransferLength + 16);
+    for (size_t i = 0; i < contents.size(); ++i) {
+      contents[i] = (uint8_t)(i * 7 + 3);
+    }
+    iree_hal_file_t* file = WrapFile(contents);
+    iree_hal_buffer_t* buffer = AllocateBuffer(kTransferLength + 8);
+    uint8_t zero = 0;
+    IREE_ASSERT_OK(
+        iree_hal_buffer_map_fill(buffer, 0, IREE_WHOLE_BUFFER, &zero, 1));
+
+    uint64_t signal_value = ++timepoint_;
+    iree_hal_semaphore_list_t signal_list = {1, &semaphore_, &signal_value};
+    iree_status_t loop_status = iree_ok_status();
+    IREE_ASSERT_OK(iree_hal_device_queue_read_streaming(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_list, file, /*source_offset=*/16, buffer, /*target_offset=*/8,
+        kTransferLength, /*flags=*/0,
+        MakeOptions(&loop_status, threaded_loop, chunk_count, chunk_size,
+                    staging_limit)));
+    IREE_ASSERT_OK(loop_status);
+    if (threaded_loop) {
+      threaded_loop->Drain();
+      IREE_ASSERT_OK(threaded_loop->ConsumeStatus());
+    }
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore_, signal_value,
+                                           iree_infinite_timeout()));
+
+    std::vector<uint8_t> result(kTransferLength + 8);
+    IREE_ASSERT_OK(
+        iree_hal_buffer_map_read(buffer, 0, result.data(), result.size()));
+    for (size_t i = 0; i < 8; ++i) EXPECT_EQ(0, result[i]);
+    for (size_t i = 0; i < kTransferLength; ++i) {
+      ASSERT_EQ(contents[16 + i], result[8 + i]) << "byte " << i;
+    }
+
+    iree_hal_buffer_release(buffer);
+    iree_hal_file_release(file);
+  }
+
+  // Writes |kTransferLength| bytes of a patterned buffer into a file and
+  // verifies the file contents. The transfer runs on |threaded_loop| if
+  // provided and otherwise on an inline loop.
+  void WriteAndVerify(iree_device_size_t chunk_count,
+                      iree_device_size_t chunk_size,
+                      iree_device_size_t staging_limit,
+                      ThreadedLoop* threaded_loop = nullptr) {
+    std::vector<uint8_t> pattern(kTransferLength + 8);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+      pattern[i] = (uint8_t)(i * 5 + 1);
+    }
+    iree_hal_buffer_t* buffer = AllocateBuffer(pattern.size());
+    IREE_ASSERT_OK(
+        iree_hal_buffer_map_write(buffer, 0, pattern.data(), pattern.size()));
+    std::vector<uint8_t> contents(kTransferLength + 16, 0);
+    iree_hal_file_t* file = WrapFile(contents);
+
+    uint64_t signal_value = ++timepoint_;
+    iree_hal_semaphore_list_t signal_list = {1, &semaphore_, &signal_value};
+    iree_status_t loop_status = iree_ok_status();
+    IREE_ASSERT_OK(iree_hal_device_queue_write_streaming(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_list, buffer, /*source_offset=*/8, file, /*target_offset=*/16,
+        kTransferLength, /*flags=*/0,
+        MakeOptions(&loop_status, threaded_loop, chunk_count, chunk_size,
+                    staging_limit)));
+    IREE_ASSERT_OK(loop_status);
+    if (threaded_loop) {
+      threaded_loop->Drain();
+      IREE_ASSERT_OK(threaded_loop->ConsumeStatus());
+    }
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore_, signal_value,
+                                           iree_infinite_timeout()));
+
+    for (size_t i = 0; i < 16; ++i) EXPECT_EQ(0, contents[i]);
+    for (size_t i = 0; i < kTransferLength; ++i) {
+      ASSERT_EQ(pattern[8 + i], contents[16 + i]) << "byte " << i;
+    }
+
+    iree_hal_file_release(file);
+    iree_hal_buffer_release(buffer);
+  }
+
+  iree_hal_device_t* device_ = NULL;
+  iree_hal_semaphore_t* semaphore_ = NULL;
+  uint64_t timepoint_ = 0;
+};
+
+TEST_F(FileTransferTest, ReadSingleChunk) {
+  ReadAndVerify(/*chunk_count=*/1, /*chunk_size=*/kTransferLength,
+                IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT);
+}
+
+TEST_F(FileTransferTest, ReadDefaults) {
+  ReadAndVerify(IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT,
+                IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT,
+                IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT);
+}
+
+// Multiple workers each handling several chunks with a partial final chunk.
+TEST_F(FileTransferTest, ReadMultipleChunks) {
+  ReadAndVerify(/*chunk_count=*/4, /*chunk_size=*/64,
+                IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT);
+}
+
+// More workers requested than there are chunks in the transfer.
+TEST_F(FileTransferTest, ReadMoreWorkersThanChunks) {
+  ReadAndVerify(/*chunk_count=*/8, /*chunk_size=*/256,
+                IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT);
+}
+
+// The staging limit clamps the requested worker count.
+TEST_F(FileTransferTest, ReadStagingLimit) {
+  ReadAndVerify(/*chunk_count=*/8, /*chunk_size=*/64, /*staging_limit=*/128);
+}
+
+TEST_F(FileTransferTest, WriteSingleChunk) {
+  WriteAndVerify(/*chunk_count=*/1, /*chunk_size=*/kTransferLength,
+                 IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT);
+}
+
+TEST_F(FileTransferTest, WriteMultipleChunks) {
+  WriteAndVerify(/*chunk_count=*/4, /*chunk_size=*/64,
+                 IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT);
+}
+
+TEST_F(FileTransferTest, WriteMoreWorkersThanChunks) {
+  WriteAndVerify(/*chunk_count=*/8, /*chunk_size=*/256,
+                 IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT);
+}
+
+TEST_F(FileTransferTest, WriteStagingLimit) {
+  WriteAndVerify(/*chunk_count=*/8, /*chunk_size=*/64, /*staging_limit=*/128);
+}
+
+// Workers running concurrently on different threads claim chunks from each
+// other until the transfer completes.
+TEST_F(FileTransferTest, ReadConcurrentWorkers) {
+  ThreadedLoop threaded_loop;
+  ReadAndVerify(/*chunk_count=*/4, /*chunk_size=*/16,
+                IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT, &threaded_loop);
+  EXPECT_GT(threaded_loop.max_concurrency(), 1);
+}
+
+TEST_F(FileTransferTest, WriteConcurrentWorkers) {
+  ThreadedLoop threaded_loop;
+  WriteAndVerify(/*chunk_count=*/4, /*chunk_size=*/16,
+                 IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT, &threaded_loop);
+  EXPECT_GT(threaded_loop.max_concurrency(), 1);
+}
+
+// Runs many concurrent transfers back to back to shake out races between
+// workers claiming the last chunks and exiting.
+TEST_F(FileTransferTest, ConcurrentWorkersStress) {
+  for (int i = 0; i < 16; ++i) {
+    ThreadedLoop threaded_loop;
+    ReadAndVerify(/*chunk_count=*/8, /*chunk_size=*/8,
+                  IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT, &threaded_loop);
+    WriteAndVerify(/*chunk_count=*/8, /*chunk_size=*/8,
+                   IREE_HAL_FILE_TRANSFER_STAGING_LIMIT_DEFAULT,
+                   &threaded_loop);
+  }
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
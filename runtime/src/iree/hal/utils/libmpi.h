@@ -33,20 +33,76 @@ extern "C" {
 
 typedef void* IREE_MPI_Datatype;
 #define IREE_MPI_BYTE(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_byte)
+#define IREE_MPI_INT8_T(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_int8_t)
+#define IREE_MPI_UINT8_T(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_uint8_t)
+#define IREE_MPI_INT16_T(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_int16_t)
+#define IREE_MPI_UINT16_T(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_uint16_t)
+#define IREE_MPI_INT32_T(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_int32_t)
+#define IREE_MPI_UINT32_T(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_uint32_t)
+#define IREE_MPI_INT64_T(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_int64_t)
+#define IREE_MPI_UINT64_T(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_uint64_t)
+#define IREE_MPI_FLOAT(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_float)
+#define IREE_MPI_DOUBLE(syms) (IREE_MPI_Datatype)((syms)->ompi_mpi_double)
+
+typedef void* IREE_MPI_Op;
+#define IREE_MPI_MAX(syms) (IREE_MPI_Op)((syms)->ompi_mpi_op_max)
+#define IREE_MPI_MIN(syms) (IREE_MPI_Op)((syms)->ompi_mpi_op_min)
+#define IREE_MPI_SUM(syms) (IREE_MPI_Op)((syms)->ompi_mpi_op_sum)
+#define IREE_MPI_PROD(syms) (IREE_MPI_Op)((syms)->ompi_mpi_op_prod)
 
 typedef void* IREE_MPI_Comm;
 #define IREE_MPI_COMM_WORLD(syms) (IREE_MPI_Comm)((syms)->ompi_mpi_comm_world)
 
+typedef void* IREE_MPI_Request;
+#define IREE_MPI_REQUEST_NULL(syms) \
+  (IREE_MPI_Request)((syms)->ompi_request_null)
+
+#define IREE_MPI_IN_PLACE ((void*)1)
+#define IREE_MPI_STATUS_IGNORE ((void*)0)
+
 #else
 
 typedef int IREE_MPI_Datatype;
 #define IREE_MPI_BYTE(syms) ((IREE_MPI_Datatype)0x4C00010D)
+#define IREE_MPI_INT8_T(syms) ((IREE_MPI_Datatype)0x4C000137)
+#define IREE_MPI_UINT8_T(syms) ((IREE_MPI_Datatype)0x4C00013B)
+#define IREE_MPI_INT16_T(syms) ((IREE_MPI_Datatype)0x4C000238)
+#define IREE_MPI_UINT16_T(syms) ((IREE_MPI_Datatype)0x4C00023C)
+#define IREE_MPI_INT32_T(syms) ((IREE_MPI_Datatype)0x4C000439)
+#define IREE_MPI_UINT32_T(syms) ((IREE_MPI_Datatype)0x4C00043D)
+#define IREE_MPI_INT64_T(syms) ((IREE_MPI_Datatype)0x4C00083A)
+#define IREE_MPI_UINT64_T(syms) ((IREE_MPI_Datatype)0x4C00083E)
+#define IREE_MPI_FLOAT(syms) ((IREE_MPI_Datatype)0x4C00040A)
+#define IREE_MPI_DOUBLE(syms) ((IREE_MPI_Datatype)0x4C00080B)
+
+typedef int IREE_MPI_Op;
+#define IREE_MPI_MAX(syms) ((IREE_MPI_Op)0x58000001)
+#define IREE_MPI_MIN(syms) ((IREE_MPI_Op)0x58000002)
+#define IREE_MPI_SUM(syms) ((IREE_MPI_Op)0x58000003)
+#define IREE_MPI_PROD(syms) ((IREE_MPI_Op)0x58000004)
 
 typedef int IREE_MPI_Comm;
 #define IREE_MPI_COMM_WORLD(syms) ((IREE_MPI_Comm)0x44000000)
 
+typedef int IREE_MPI_Request;
+#define IREE_MPI_REQUEST_NULL(syms) ((IREE_MPI_Request)0x2C000000)
+
+#define IREE_MPI_IN_PLACE ((void*)-1)
+#define IREE_MPI_STATUS_IGNORE ((void*)1)
+
 #endif  // IREE_MPI_TYPES_ARE_POINTERS
 
+// Color passed to MPI_Comm_split by ranks not joining any new communicator.
+// Consistent across implementations.
+#define IREE_MPI_UNDEFINED (-32766)
+
+// Thread support levels as passed to MPI_Init_thread. These are consistent
+// across implementations.
+#define IREE_MPI_THREAD_SINGLE 0
+#define IREE_MPI_THREAD_FUNNELED 1
+#define IREE_MPI_THREAD_SERIALIZED 2
+#define IREE_MPI_THREAD_MULTIPLE 3
+
 //===----------------------------------------------------------------------===//
 // Dynamic symbol table
 //===----------------------------------------------------------------------===//
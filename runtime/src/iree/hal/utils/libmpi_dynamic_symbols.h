@@ -5,7 +5,9 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 MPI_PFN_DECL(MPI_Init, int*, char***)
+MPI_PFN_DECL(MPI_Init_thread, int*, char***, int required, int* provided)
 MPI_PFN_DECL(MPI_Initialized, int*)
+MPI_PFN_DECL(MPI_Query_thread, int* provided)
 MPI_PFN_DECL(MPI_Finalize)
 MPI_PFN_DECL(MPI_Bcast, void* buffer, int count, IREE_MPI_Datatype datatype,
              int root, IREE_MPI_Comm comm)
@@ -13,10 +15,54 @@ MPI_PFN_DECL(MPI_Comm_rank, IREE_MPI_Comm comm, int* rank)
 MPI_PFN_DECL(MPI_Comm_size, IREE_MPI_Comm comm, int* size)
 MPI_PFN_DECL(MPI_Comm_split, IREE_MPI_Comm comm, int color, int key,
              IREE_MPI_Comm* newcomm)
+MPI_PFN_DECL(MPI_Comm_dup, IREE_MPI_Comm comm, IREE_MPI_Comm* newcomm)
+MPI_PFN_DECL(MPI_Comm_free, IREE_MPI_Comm* comm)
+
+// Nonblocking collectives and point-to-point operations
+MPI_PFN_DECL(MPI_Iallgather, const void* sendbuf, int sendcount,
+             IREE_MPI_Datatype sendtype, void* recvbuf, int recvcount,
+             IREE_MPI_Datatype recvtype, IREE_MPI_Comm comm,
+             IREE_MPI_Request* request)
+MPI_PFN_DECL(MPI_Iallreduce, const void* sendbuf, void* recvbuf, int count,
+             IREE_MPI_Datatype datatype, IREE_MPI_Op op, IREE_MPI_Comm comm,
+             IREE_MPI_Request* request)
+MPI_PFN_DECL(MPI_Ialltoall, const void* sendbuf, int sendcount,
+             IREE_MPI_Datatype sendtype, void* recvbuf, int recvcount,
+             IREE_MPI_Datatype recvtype, IREE_MPI_Comm comm,
+             IREE_MPI_Request* request)
+MPI_PFN_DECL(MPI_Ibcast, void* buffer, int count, IREE_MPI_Datatype datatype,
+             int root, IREE_MPI_Comm comm, IREE_MPI_Request* request)
+MPI_PFN_DECL(MPI_Ireduce, const void* sendbuf, void* recvbuf, int count,
+             IREE_MPI_Datatype datatype, IREE_MPI_Op op, int root,
+             IREE_MPI_Comm comm, IREE_MPI_Request* request)
+MPI_PFN_DECL(MPI_Ireduce_scatter_block, const void* sendbuf, void* recvbuf,
+             int recvcount, IREE_MPI_Datatype datatype, IREE_MPI_Op op,
+             IREE_MPI_Comm comm, IREE_MPI_Request* request)
+MPI_PFN_DECL(MPI_Isend, const void* buf, int count, IREE_MPI_Datatype datatype,
+             int dest, int tag, IREE_MPI_Comm comm, IREE_MPI_Request* request)
+MPI_PFN_DECL(MPI_Irecv, void* buf, int count, IREE_MPI_Datatype datatype,
+             int source, int tag, IREE_MPI_Comm comm,
+             IREE_MPI_Request* request)
+MPI_PFN_DECL(MPI_Test, IREE_MPI_Request* request, int* flag, void* status)
 
 #if IREE_MPI_TYPES_ARE_POINTERS
 MPI_PFN_DECL(ompi_mpi_byte)
+MPI_PFN_DECL(ompi_mpi_int8_t)
+MPI_PFN_DECL(ompi_mpi_uint8_t)
+MPI_PFN_DECL(ompi_mpi_int16_t)
+MPI_PFN_DECL(ompi_mpi_uint16_t)
+MPI_PFN_DECL(ompi_mpi_int32_t)
+MPI_PFN_DECL(ompi_mpi_uint32_t)
+MPI_PFN_DECL(ompi_mpi_int64_t)
+MPI_PFN_DECL(ompi_mpi_uint64_t)
+MPI_PFN_DECL(ompi_mpi_float)
+MPI_PFN_DECL(ompi_mpi_double)
+MPI_PFN_DECL(ompi_mpi_op_max)
+MPI_PFN_DECL(ompi_mpi_op_min)
+MPI_PFN_DECL(ompi_mpi_op_sum)
+MPI_PFN_DECL(ompi_mpi_op_prod)
 MPI_PFN_DECL(ompi_mpi_comm_world)
+MPI_PFN_DECL(ompi_request_null)
 #endif  // IREE_MPI_TYPES_ARE_POINTERS
 
 // MPI error handling
@@ -0,0 +1,948 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/local_channel.h"
+
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+
+// Number of operations that may be in flight on a group at a time. All
+// participants must finish an operation before any of them completes it and
+// as such at most two consecutive operations can be live at once.
+#define IREE_HAL_LOCAL_CHANNEL_ROUND_COUNT 4
+
+// Alignment in bytes of the chunks partitioned across participants. Chunks
+// never share cache lines so that participants do not contend on writes.
+#define IREE_HAL_LOCAL_CHANNEL_CHUNK_ALIGNMENT 64
+
+// Maximum number of bytes reduced at a time. Each block is reduced from all
+// send buffers and then broadcast while it remains resident in cache.
+#define IREE_HAL_LOCAL_CHANNEL_BLOCK_SIZE (32 * 1024)
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_channel_world_t
+//===----------------------------------------------------------------------===//
+
+// A single in-flight collective operation on a group.
+typedef struct iree_hal_local_channel_round_t {
+  // Sequence number of the operation or -1 if the round is unused.
+  int64_t sequence;
+  // Number of participants that have arrived at the operation.
+  int32_t arrived_count;
+  // True if the arrived operations do not agree with each other.
+  bool is_mismatched;
+  // Number of participants that have finished their share of the work.
+  iree_atomic_int32_t finished_count;
+  // Operations of each participant indexed by rank.
+  iree_hal_local_channel_operation_t*
+      operations[IREE_HAL_LOCAL_CHANNEL_MAX_COUNT];
+} iree_hal_local_channel_round_t;
+
+typedef struct iree_hal_local_channel_group_t
+    iree_hal_local_channel_group_t;
+
+// A set of channels with matching group keys that exchange data.
+typedef struct iree_hal_local_channel_group_t {
+  // Next group in the world list. Guarded by the world mutex.
+  iree_hal_local_channel_group_t* next;
+  // Number of channels referencing the group. Guarded by the world mutex.
+  int32_t reference_count;
+  // Bitmask of ranks with live channels. Guarded by the world mutex.
+  uint64_t joined_ranks;
+
+  // Group key; storage is allocated with the group.
+  iree_string_view_t key;
+  iree_const_byte_span_t id;
+  int32_t count;
+
+  // Guards arrival at and release of rounds. Once all participants have
+  // arrived the round is read without the lock until all have finished.
+  iree_slim_mutex_t mutex;
+  iree_hal_local_channel_round_t rounds[IREE_HAL_LOCAL_CHANNEL_ROUND_COUNT];
+} iree_hal_local_channel_group_t;
+
+// State shared by all providers created together.
+typedef struct iree_hal_local_channel_world_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  // Total number of providers in the world.
+  int32_t count;
+  iree_slim_mutex_t mutex;
+  // All groups with live channels.
+  iree_hal_local_channel_group_t* group_head IREE_GUARDED_BY(mutex);
+} iree_hal_local_channel_world_t;
+
+static void iree_hal_local_channel_world_retain(
+    iree_hal_local_channel_world_t* world) {
+  iree_atomic_ref_count_inc(&world->ref_count);
+}
+
+static void iree_hal_local_channel_world_release(
+    iree_hal_local_channel_world_t* world) {
+  if (iree_atomic_ref_count_dec(&world->ref_count) == 1) {
+    IREE_ASSERT(!world->group_head, "groups must not outlive their channels");
+    iree_slim_mutex_deinitialize(&world->mutex);
+    iree_allocator_free(world->host_allocator, world);
+  }
+}
+
+// Acquires the group matching |key|, |id|, and |count| for use by |rank|,
+// creating it if this is the first channel to reference it.
+static iree_status_t iree_hal_local_channel_world_acquire_group(
+    iree_hal_local_channel_world_t* world, iree_string_view_t key,
+    iree_const_byte_span_t id, int32_t rank, int32_t count,
+    iree_hal_local_channel_group_t** out_group) {
+  *out_group = NULL;
+  iree_slim_mutex_lock(&world->mutex);
+
+  iree_hal_local_channel_group_t* group = world->group_head;
+  for (; group != NULL; group = group->next) {
+    if (group->count == count && iree_string_view_equal(group->key, key) &&
+        group->id.data_length == id.data_length &&
+        (!id.data_length ||
+         memcmp(group->id.data, id.data, id.data_length) == 0)) {
+      break;
+    }
+  }
+
+  iree_status_t status = iree_ok_status();
+  if (group) {
+    if (group->joined_ranks & (1ull << rank)) {
+      status = iree_make_status(IREE_STATUS_ALREADY_EXISTS,
+                                "rank %d has already joined the channel group",
+                                rank);
+    }
+  } else {
+    iree_host_size_t total_size = sizeof(*group) + key.size + id.data_length;
+    status = iree_allocator_malloc(world->host_allocator, total_size,
+                                   (void**)&group);
+    if (iree_status_is_ok(status)) {
+      memset(group, 0, sizeof(*group));
+      char* key_ptr = (char*)group + sizeof(*group);
+      if (key.size) memcpy(key_ptr, key.data, key.size);
+      group->key = iree_make_string_view(key_ptr, key.size);
+      uint8_t* id_ptr = (uint8_t*)key_ptr + key.size;
+      if (id.data_length) memcpy(id_ptr, id.data, id.data_length);
+      group->id = iree_make_const_byte_span(id_ptr, id.data_length);
+      group->count = count;
+      iree_slim_mutex_initialize(&group->mutex);
+      for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(group->rounds); ++i) {
+        group->rounds[i].sequence = -1;
+      }
+      group->next = world->group_head;
+      world->group_head = group;
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    group->joined_ranks |= 1ull << rank;
+    ++group->reference_count;
+    *out_group = group;
+  }
+
+  iree_slim_mutex_unlock(&world->mutex);
+  return status;
+}
+
+// Releases the use of |group| by |rank| and frees it if unused.
+static void iree_hal_local_channel_world_release_group(
+    iree_hal_local_channel_world_t* world,
+    iree_hal_local_channel_group_t* group, int32_t rank) {
+  iree_slim_mutex_lock(&world->mutex);
+  group->joined_ranks &= ~(1ull << rank);
+  bool is_unused = --group->reference_count == 0;
+  if (is_unused) {
+    iree_hal_local_channel_group_t** prev_next = &world->group_head;
+    while (*prev_next != group) prev_next = &(*prev_next)->next;
+    *prev_next = group->next;
+  }
+  iree_slim_mutex_unlock(&world->mutex);
+  if (is_unused) {
+    iree_slim_mutex_deinitialize(&group->mutex);
+    iree_allocator_free(world->host_allocator, group);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_channel_provider_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_local_channel_provider_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  // World shared with all providers created together.
+  iree_hal_local_channel_world_t* world;
+  // Default rank of channels created from this provider.
+  int32_t rank;
+} iree_hal_local_channel_provider_t;
+
+static const iree_hal_channel_provider_vtable_t
+    iree_hal_local_channel_provider_vtable;
+
+static iree_hal_local_channel_provider_t* iree_hal_local_channel_provider_cast(
+    iree_hal_channel_provider_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_local_channel_provider_vtable);
+  return (iree_hal_local_channel_provider_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_local_channel_provider_create(
+    iree_host_size_t count, iree_allocator_t host_allocator,
+    iree_hal_channel_provider_t** out_channel_providers) {
+  IREE_ASSERT_ARGUMENT(out_channel_providers);
+  if (count == 0 || count > IREE_HAL_LOCAL_CHANNEL_MAX_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "local channel worlds must have between 1 and %d "
+                            "participants but %" PRIhsz " were requested",
+                            IREE_HAL_LOCAL_CHANNEL_MAX_COUNT, count);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+  memset(out_channel_providers, 0, count * sizeof(*out_channel_providers));
+
+  iree_hal_local_channel_world_t* world = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*world),
+                                (void**)&world));
+  iree_atomic_ref_count_init(&world->ref_count);
+  world->host_allocator = host_allocator;
+  world->count = (int32_t)count;
+  iree_slim_mutex_initialize(&world->mutex);
+  world->group_head = NULL;
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    iree_hal_local_channel_provider_t* channel_provider = NULL;
+    status = iree_allocator_malloc(host_allocator, sizeof(*channel_provider),
+                                   (void**)&channel_provider);
+    if (!iree_status_is_ok(status)) break;
+    iree_hal_resource_initialize(&iree_hal_local_channel_provider_vtable,
+                                 &channel_provider->resource);
+    channel_provider->host_allocator = host_allocator;
+    channel_provider->world = world;
+    iree_hal_local_channel_world_retain(world);
+    channel_provider->rank = (int32_t)i;
+    out_channel_providers[i] = (iree_hal_channel_provider_t*)channel_provider;
+  }
+
+  if (!iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      iree_hal_channel_provider_release(out_channel_providers[i]);
+      out_channel_providers[i] = NULL;
+    }
+  }
+  iree_hal_local_channel_world_release(world);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_local_channel_provider_destroy(
+    iree_hal_channel_provider_t* base_channel_provider) {
+  iree_hal_local_channel_provider_t* channel_provider =
+      iree_hal_local_channel_provider_cast(base_channel_provider);
+  iree_allocator_t host_allocator = channel_provider->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_channel_world_release(channel_provider->world);
+  iree_allocator_free(host_allocator, channel_provider);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT bool iree_hal_local_channel_provider_isa(
+    iree_hal_channel_provider_t* channel_provider) {
+  return iree_hal_resource_is(channel_provider,
+                              &iree_hal_local_channel_provider_vtable);
+}
+
+static iree_status_t
+iree_hal_local_channel_provider_query_default_rank_and_count(
+    iree_hal_channel_provider_t* base_channel_provider, int32_t* out_rank,
+    int32_t* out_count) {
+  iree_hal_local_channel_provider_t* channel_provider =
+      iree_hal_local_channel_provider_cast(base_channel_provider);
+  *out_rank = channel_provider->rank;
+  *out_count = channel_provider->world->count;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_local_channel_provider_exchange_default_id(
+    iree_hal_channel_provider_t* base_channel_provider, iree_byte_span_t id) {
+  // All participants share the world and an empty id selects the default
+  // group; there's nothing to exchange.
+  return iree_ok_status();
+}
+
+static const iree_hal_channel_provider_vtable_t
+    iree_hal_local_channel_provider_vtable = {
+        .destroy = iree_hal_local_channel_provider_destroy,
+        .query_default_rank_and_count =
+            iree_hal_local_channel_provider_query_default_rank_and_count,
+        .exchange_default_id =
+            iree_hal_local_channel_provider_exchange_default_id,
+};
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_channel_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_local_channel_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+
+  // Provider owning the world the group was created in.
+  iree_hal_channel_provider_t* channel_provider;
+  iree_hal_local_channel_world_t* world;
+  iree_hal_local_channel_group_t* group;
+
+  // This participant's rank in the group.
+  int32_t rank;
+  // Total number of participants in the group.
+  int32_t count;
+
+  // Sequence number assigned to the next operation issued on the channel.
+  int64_t next_sequence;
+} iree_hal_local_channel_t;
+
+static const iree_hal_channel_vtable_t iree_hal_local_channel_vtable;
+
+static iree_hal_local_channel_t* iree_hal_local_channel_cast(
+    iree_hal_channel_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_local_channel_vtable);
+  return (iree_hal_local_channel_t*)base_value;
+}
+
+static const iree_hal_local_channel_t* iree_hal_local_channel_const_cast(
+    const iree_hal_channel_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_local_channel_vtable);
+  return (const iree_hal_local_channel_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_local_channel_create(
+    iree_hal_channel_provider_t* base_channel_provider,
+    iree_hal_channel_params_t params, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel) {
+  IREE_ASSERT_ARGUMENT(base_channel_provider);
+  IREE_ASSERT_ARGUMENT(out_channel);
+  *out_channel = NULL;
+  iree_hal_local_channel_provider_t* channel_provider =
+      iree_hal_local_channel_provider_cast(base_channel_provider);
+
+  int32_t rank = params.rank == IREE_HAL_CHANNEL_RANK_DEFAULT
+                     ? channel_provider->rank
+                     : params.rank;
+  int32_t count = params.count == IREE_HAL_CHANNEL_COUNT_DEFAULT
+                      ? channel_provider->world->count
+                      : params.count;
+  if (count <= 0 || count > IREE_HAL_LOCAL_CHANNEL_MAX_COUNT || rank < 0 ||
+      rank >= count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid local channel rank %d of %d (maximum of "
+                            "%d participants)",
+                            rank, count, IREE_HAL_LOCAL_CHANNEL_MAX_COUNT);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, rank);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+
+  iree_hal_local_channel_t* channel = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*channel),
+                                (void**)&channel));
+  iree_status_t status = iree_hal_local_channel_world_acquire_group(
+      channel_provider->world, params.group, params.id, rank, count,
+      &channel->group);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, channel);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_hal_resource_initialize(&iree_hal_local_channel_vtable,
+                               &channel->resource);
+  channel->host_allocator = host_allocator;
+  channel->channel_provider = base_channel_provider;
+  iree_hal_channel_provider_retain(base_channel_provider);
+  channel->world = channel_provider->world;
+  channel->rank = rank;
+  channel->count = count;
+  channel->next_sequence = 0;
+
+  *out_channel = (iree_hal_channel_t*)channel;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_local_channel_destroy(iree_hal_channel_t* base_channel) {
+  iree_hal_local_channel_t* channel = iree_hal_local_channel_cast(base_channel);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, channel->rank);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, channel->count);
+
+  iree_allocator_t host_allocator = channel->host_allocator;
+  iree_hal_local_channel_world_release_group(channel->world, channel->group,
+                                             channel->rank);
+  iree_hal_channel_provider_release(channel->channel_provider);
+  iree_allocator_free(host_allocator, channel);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT bool iree_hal_local_channel_isa(iree_hal_channel_t* channel) {
+  return iree_hal_resource_is(channel, &iree_hal_local_channel_vtable);
+}
+
+static iree_status_t iree_hal_local_channel_split(
+    iree_hal_channel_t* base_channel, int32_t color, int32_t key,
+    iree_hal_channel_flags_t flags, iree_hal_channel_t** out_split_channel) {
+  // Splitting requires all participants to rendezvous synchronously and that
+  // would deadlock when participants share a thread. Subgroups can instead be
+  // created directly with a distinct group key and the split rank and count.
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "local channels do not support splitting; create "
+                          "subgroup channels with explicit ranks instead");
+}
+
+static void iree_hal_local_channel_query_rank_and_count(
+    const iree_hal_channel_t* base_channel, int32_t* out_rank,
+    int32_t* out_count) {
+  IREE_ASSERT_ARGUMENT(base_channel);
+  IREE_ASSERT_ARGUMENT(out_count);
+  const iree_hal_local_channel_t* channel =
+      iree_hal_local_channel_const_cast(base_channel);
+  *out_rank = channel->rank;
+  *out_count = channel->count;
+}
+
+static const iree_hal_channel_vtable_t iree_hal_local_channel_vtable = {
+    .destroy = iree_hal_local_channel_destroy,
+    .split = iree_hal_local_channel_split,
+    .query_rank_and_count = iree_hal_local_channel_query_rank_and_count,
+};
+
+//===----------------------------------------------------------------------===//
+// Reductions
+//===----------------------------------------------------------------------===//
+
+#define IREE_HAL_LOCAL_CHANNEL_IDENTITY(x) (x)
+
+// Applies |EXPR| of the current value |a| and incoming value |b| to each
+// element. Values of storage type |T| are loaded as |V| with |LOAD| and stored
+// back with |STORE|.
+#define IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(T, V, LOAD, STORE, EXPR) \
+  for (iree_host_size_t i = 0; i < count; ++i) {                     \
+    V a = LOAD(((T*)dst)[i]);                                        \
+    V b = LOAD(((const T*)src)[i]);                                  \
+    ((T*)dst)[i] = STORE(EXPR);                                      \
+  }
+
+#define IREE_HAL_LOCAL_CHANNEL_REDUCE_INT_LOOP(T, EXPR)                      \
+  IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(T, T, IREE_HAL_LOCAL_CHANNEL_IDENTITY, \
+                                     (T), EXPR)
+
+// Integer reductions wrap on overflow: sums and products are computed in the
+// unsigned type |U| while comparisons use the declared type |S|.
+#define IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(S, U)                          \
+  switch (reduction) {                                                   \
+    case IREE_HAL_COLLECTIVE_REDUCTION_SUM:                              \
+    case IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE:                          \
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT_LOOP(U, (uint64_t)a + b);        \
+      break;                                                             \
+    case IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT:                          \
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT_LOOP(U, (uint64_t)a * b);        \
+      break;                                                             \
+    case IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM:                          \
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT_LOOP(S, a < b ? a : b);          \
+      break;                                                             \
+    case IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM:                          \
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT_LOOP(S, a > b ? a : b);          \
+      break;                                                             \
+    default:                                                             \
+      break;                                                             \
+  }
+
+// Floating-point reductions of storage type |T| computed in type |V|.
+#define IREE_HAL_LOCAL_CHANNEL_REDUCE_FLOAT(T, V, LOAD, STORE)                \
+  switch (reduction) {                                                        \
+    case IREE_HAL_COLLECTIVE_REDUCTION_SUM:                                   \
+    case IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE:                               \
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(T, V, LOAD, STORE, a + b);           \
+      break;                                                                  \
+    case IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT:                               \
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(T, V, LOAD, STORE, a * b);           \
+      break;                                                                  \
+    case IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM:                               \
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(T, V, LOAD, STORE, a < b ? a : b);   \
+      break;                                                                  \
+    case IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM:                               \
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_LOOP(T, V, LOAD, STORE, a > b ? a : b);   \
+      break;                                                                  \
+    default:                                                                  \
+      break;                                                                  \
+  }
+
+// Reduces |count| elements of |src| into |dst|. Averages are accumulated as
+// sums and divided by iree_hal_local_channel_average once all participants
+// have been reduced.
+static void iree_hal_local_channel_reduce(
+    iree_hal_collective_element_type_t element_type,
+    iree_hal_collective_reduction_t reduction, void* dst, const void* src,
+    iree_host_size_t count) {
+  switch (element_type) {
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_8:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(int8_t, uint8_t);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_8:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(uint8_t, uint8_t);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_16:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(int16_t, uint16_t);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_16:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(uint16_t, uint16_t);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(int32_t, uint32_t);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_32:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(uint32_t, uint32_t);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_64:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(int64_t, uint64_t);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_64:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_INT(uint64_t, uint64_t);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_16:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_FLOAT(uint16_t, float, iree_math_f16_to_f32,
+                                          iree_math_f32_to_f16);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_FLOAT(float, float,
+                                          IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                          IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_64:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_FLOAT(double, double,
+                                          IREE_HAL_LOCAL_CHANNEL_IDENTITY,
+                                          IREE_HAL_LOCAL_CHANNEL_IDENTITY);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_BFLOAT_16:
+      IREE_HAL_LOCAL_CHANNEL_REDUCE_FLOAT(uint16_t, float,
+                                          iree_math_bf16_to_f32,
+                                          iree_math_f32_to_bf16);
+      break;
+    default:
+      break;
+  }
+}
+
+#define IREE_HAL_LOCAL_CHANNEL_AVERAGE_LOOP(T, V, LOAD, STORE) \
+  for (iree_host_size_t i = 0; i < count; ++i) {                \
+    V a = LOAD(((T*)dst)[i]);                                   \
+    ((T*)dst)[i] = STORE(a / (V)divisor);                       \
+  }
+
+// Divides |count| elements of |dst| by |divisor|.
+static void iree_hal_local_channel_average(
+    iree_hal_collective_element_type_t element_type, void* dst,
+    iree_host_size_t count, int32_t divisor) {
+  switch (element_type) {
+#define IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(ELEMENT_TYPE, T)           \
+  case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_##ELEMENT_TYPE:                \
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_LOOP(T, T,                          \
+                                        IREE_HAL_LOCAL_CHANNEL_IDENTITY, \
+                                        (T));                          \
+    break;
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(SINT_8, int8_t)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(UINT_8, uint8_t)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(SINT_16, int16_t)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(UINT_16, uint16_t)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(SINT_32, int32_t)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(UINT_32, uint32_t)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(SINT_64, int64_t)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(UINT_64, uint64_t)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(FLOAT_32, float)
+    IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE(FLOAT_64, double)
+#undef IREE_HAL_LOCAL_CHANNEL_AVERAGE_CASE
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_16:
+      IREE_HAL_LOCAL_CHANNEL_AVERAGE_LOOP(uint16_t, float, iree_math_f16_to_f32,
+                                          iree_math_f32_to_f16);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_BFLOAT_16:
+      IREE_HAL_LOCAL_CHANNEL_AVERAGE_LOOP(uint16_t, float,
+                                          iree_math_bf16_to_f32,
+                                          iree_math_f32_to_bf16);
+      break;
+    default:
+      break;
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Operation execution
+//===----------------------------------------------------------------------===//
+
+enum iree_hal_local_channel_operation_state_e {
+  // Not yet arrived at the group.
+  IREE_HAL_LOCAL_CHANNEL_OPERATION_STATE_IDLE = 0,
+  // Arrived and waiting for all other participants to arrive.
+  IREE_HAL_LOCAL_CHANNEL_OPERATION_STATE_ARRIVED,
+  // Finished its share of the work and waiting for all other participants to
+  // finish theirs.
+  IREE_HAL_LOCAL_CHANNEL_OPERATION_STATE_FINISHED,
+};
+
+// Returns true if |kind| uses a reduction operation.
+static bool iree_hal_local_collective_kind_reduces(
+    iree_hal_collective_kind_t kind) {
+  return kind == IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE ||
+         kind == IREE_HAL_COLLECTIVE_KIND_REDUCE ||
+         kind == IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER;
+}
+
+// Verifies that |operation| can be executed on |channel|.
+static iree_status_t iree_hal_local_channel_validate(
+    iree_hal_local_channel_t* channel,
+    const iree_hal_local_channel_operation_t* operation) {
+  const iree_hal_collective_op_t op = operation->op;
+  if (op.element_type > IREE_HAL_COLLECTIVE_ELEMENT_TYPE_MAX_VALUE) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "unhandled element type for collective op");
+  }
+  if (iree_hal_local_collective_kind_reduces(op.kind) &&
+      (op.reduction == IREE_HAL_COLLECTIVE_REDUCTION_NONE ||
+       op.reduction > IREE_HAL_COLLECTIVE_REDUCTION_MAX_VALUE)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "unhandled reduction type for collective op");
+  }
+  if (operation->element_count > IREE_HOST_SIZE_MAX /
+                                     IREE_HAL_LOCAL_CHANNEL_MAX_COUNT /
+                                     sizeof(uint64_t)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "collective element count out of range");
+  }
+  switch (op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER:
+    case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE:
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER:
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_ALL_TO_ALL:
+      if (operation->element_count % channel->count != 0) {
+        return iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "all-to-all element count %" PRIu64
+            " must be divisible by the participant count %d",
+            (uint64_t)operation->element_count, channel->count);
+      }
+      if (operation->send_ptr == operation->recv_ptr) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "in-place all-to-all is not supported");
+      }
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_BROADCAST:
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE:
+      if (operation->param >= (uint32_t)channel->count) {
+        return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "root rank %u out of range (count %d)",
+                                operation->param, channel->count);
+      }
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_SEND_RECV: {
+      int16_t send_rank;
+      int16_t recv_rank;
+      memcpy(&send_rank, &operation->param, 2);
+      memcpy(&recv_rank, (const char*)&operation->param + 2, 2);
+      if (send_rank < -1 || send_rank >= channel->count || recv_rank < -1 ||
+          recv_rank >= channel->count) {
+        return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "send/recv ranks %d/%d out of range (count %d)",
+                                send_rank, recv_rank, channel->count);
+      }
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_SEND:
+    case IREE_HAL_COLLECTIVE_KIND_RECV:
+      // Standalone sends and receives pair up operations from two ranks that
+      // are not issued as part of the same collective across the group.
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "local channels do not support standalone "
+                              "send/recv; use send_recv instead");
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unhandled collective op kind %u",
+                              (uint32_t)op.kind);
+  }
+  return iree_ok_status();
+}
+
+// Returns true if |a| and |b| can be executed together as one collective.
+static bool iree_hal_local_channel_operations_match(
+    const iree_hal_local_channel_operation_t* a,
+    const iree_hal_local_channel_operation_t* b) {
+  if (a->op.packed != b->op.packed) return false;
+  if (a->element_count != b->element_count) return false;
+  switch (a->op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_BROADCAST:
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE:
+      return a->param == b->param;
+    default:
+      return true;
+  }
+}
+
+// Computes the range of elements [*out_begin, *out_end) of |element_count|
+// that |rank| of |count| is responsible for reducing. Ranges are aligned to
+// cache lines and may be empty for higher ranks when the count is small.
+static void iree_hal_local_channel_partition(
+    iree_host_size_t element_count, iree_host_size_t element_size,
+    int32_t rank, int32_t count, iree_host_size_t* out_begin,
+    iree_host_size_t* out_end) {
+  const iree_host_size_t elements_per_line =
+      IREE_HAL_LOCAL_CHANNEL_CHUNK_ALIGNMENT / element_size;
+  const iree_host_size_t line_count =
+      iree_host_size_ceil_div(element_count, elements_per_line);
+  const iree_host_size_t chunk_elements =
+      iree_host_size_ceil_div(line_count, count) * elements_per_line;
+  *out_begin = iree_min(element_count, rank * chunk_elements);
+  *out_end = iree_min(element_count, *out_begin + chunk_elements);
+}
+
+// Reduces elements [begin, end) of the send buffers of all |operations| into
+// |dst| (indexed by element). The participant |self| is reduced first as its
+// send buffer may alias |dst|.
+static void iree_hal_local_channel_reduce_range(
+    iree_hal_collective_op_t op,
+    iree_hal_local_channel_operation_t** operations, int32_t count,
+    int32_t self, iree_host_size_t send_offset, uint8_t* dst,
+    iree_host_size_t element_count) {
+  const iree_host_size_t element_size =
+      (iree_host_size_t)iree_hal_collective_element_byte_count(op.element_type);
+  const uint8_t* self_src =
+      (const uint8_t*)operations[self]->send_ptr + send_offset * element_size;
+  if (self_src != dst) memcpy(dst, self_src, element_count * element_size);
+  for (int32_t i = 0; i < count; ++i) {
+    if (i == self) continue;
+    iree_hal_local_channel_reduce(
+        op.element_type, op.reduction, dst,
+        (const uint8_t*)operations[i]->send_ptr + send_offset * element_size,
+        element_count);
+  }
+  if (op.reduction == IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE) {
+    iree_hal_local_channel_average(op.element_type, dst, element_count, count);
+  }
+}
+
+// Performs the share of the work of |round| assigned to |rank|.
+static void iree_hal_local_channel_execute(
+    iree_hal_local_channel_round_t* round, int32_t rank, int32_t count) {
+  iree_hal_local_channel_operation_t** operations = round->operations;
+  iree_hal_local_channel_operation_t* operation = operations[rank];
+  const iree_hal_collective_op_t op = operation->op;
+  const iree_host_size_t element_size =
+      (iree_host_size_t)iree_hal_collective_element_byte_count(op.element_type);
+  const iree_host_size_t element_count =
+      (iree_host_size_t)operation->element_count;
+  const iree_host_size_t byte_length = element_count * element_size;
+  const iree_host_size_t block_elements =
+      IREE_HAL_LOCAL_CHANNEL_BLOCK_SIZE / element_size;
+  uint8_t* recv_ptr = (uint8_t*)operation->recv_ptr;
+  switch (op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER: {
+      // Pull each participant's contribution into our receive buffer.
+      for (int32_t i = 0; i < count; ++i) {
+        uint8_t* dst = recv_ptr + i * byte_length;
+        if (dst != operations[i]->send_ptr) {
+          memcpy(dst, operations[i]->send_ptr, byte_length);
+        }
+      }
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE: {
+      // Reduce our chunk from all participants into our receive buffer and
+      // then copy it to all other participants while it is still in cache.
+      iree_host_size_t begin = 0, end = 0;
+      iree_hal_local_channel_partition(element_count, element_size, rank,
+                                       count, &begin, &end);
+      for (iree_host_size_t i = begin; i < end; i += block_elements) {
+        const iree_host_size_t n = iree_min(block_elements, end - i);
+        uint8_t* dst = recv_ptr + i * element_size;
+        iree_hal_local_channel_reduce_range(op, operations, count, rank, i, dst,
+                                            n);
+        for (int32_t j = 0; j < count; ++j) {
+          if (j == rank) continue;
+          memcpy((uint8_t*)operations[j]->recv_ptr + i * element_size, dst,
+                 n * element_size);
+        }
+      }
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_ALL_TO_ALL: {
+      // Pull our part from each participant's send buffer.
+      const iree_host_size_t part_length = byte_length / count;
+      for (int32_t i = 0; i < count; ++i) {
+        memcpy(recv_ptr + i * part_length,
+               (const uint8_t*)operations[i]->send_ptr + rank * part_length,
+               part_length);
+      }
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_BROADCAST: {
+      const void* src = operations[operation->param]->send_ptr;
+      if (recv_ptr && recv_ptr != src) memcpy(recv_ptr, src, byte_length);
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE: {
+      // Reduce our chunk from all participants into the root receive buffer.
+      const int32_t root = (int32_t)operation->param;
+      uint8_t* root_recv_ptr = (uint8_t*)operations[root]->recv_ptr;
+      iree_host_size_t begin = 0, end = 0;
+      iree_hal_local_channel_partition(element_count, element_size, rank,
+                                       count, &begin, &end);
+      for (iree_host_size_t i = begin; i < end; i += block_elements) {
+        const iree_host_size_t n = iree_min(block_elements, end - i);
+        iree_hal_local_channel_reduce_range(op, operations, count, root, i,
+                                            root_recv_ptr + i * element_size,
+                                            n);
+      }
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER: {
+      // Reduce our block of all participants into our receive buffer.
+      for (iree_host_size_t i = 0; i < element_count; i += block_elements) {
+        const iree_host_size_t n = iree_min(block_elements, element_count - i);
+        iree_hal_local_channel_reduce_range(op, operations, count, rank,
+                                            rank * element_count + i,
+                                            recv_ptr + i * element_size, n);
+      }
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_SEND_RECV: {
+      int16_t recv_rank;
+      memcpy(&recv_rank, (const char*)&operation->param + 2, 2);
+      if (recv_rank != -1) {
+        memcpy(recv_ptr, operations[recv_rank]->send_ptr, byte_length);
+      } else {
+        // Zero out the receive buffer if this rank is not receiving any data.
+        memset(recv_ptr, 0, byte_length);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// Issues the resume callbacks of all |operations| other than |self|.
+static void iree_hal_local_channel_resume_peers(
+    iree_hal_local_channel_operation_t** operations, int32_t count,
+    int32_t self) {
+  for (int32_t i = 0; i < count; ++i) {
+    if (i == self) continue;
+    operations[i]->fn(operations[i]->user_data, operations[i]);
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_local_channel_advance(
+    iree_hal_channel_t* base_channel,
+    iree_hal_local_channel_operation_t* operation, bool* out_completed) {
+  IREE_ASSERT_ARGUMENT(base_channel);
+  IREE_ASSERT_ARGUMENT(operation);
+  IREE_ASSERT_ARGUMENT(out_completed);
+  *out_completed = false;
+  iree_hal_local_channel_t* channel = iree_hal_local_channel_cast(base_channel);
+  iree_hal_local_channel_group_t* group = channel->group;
+  const int32_t rank = channel->rank;
+  const int32_t count = channel->count;
+  iree_hal_local_channel_operation_t* peers[IREE_HAL_LOCAL_CHANNEL_MAX_COUNT];
+
+  if (operation->impl.state == IREE_HAL_LOCAL_CHANNEL_OPERATION_STATE_IDLE) {
+    IREE_RETURN_IF_ERROR(iree_hal_local_channel_validate(channel, operation));
+
+    // Arrive at the round for the operation, claiming it if we are first.
+    const int64_t sequence = channel->next_sequence;
+    iree_hal_local_channel_round_t* round =
+        &group->rounds[sequence % IREE_HAL_LOCAL_CHANNEL_ROUND_COUNT];
+    iree_slim_mutex_lock(&group->mutex);
+    if (round->sequence == -1) {
+      round->sequence = sequence;
+      round->arrived_count = 0;
+      round->is_mismatched = false;
+      iree_atomic_store_int32(&round->finished_count, 0,
+                              iree_memory_order_relaxed);
+      memset(round->operations, 0, sizeof(round->operations));
+    } else if (round->sequence != sequence) {
+      iree_slim_mutex_unlock(&group->mutex);
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "collective operation %" PRIi64
+                              " issued while operation %" PRIi64
+                              " is still in flight",
+                              sequence, round->sequence);
+    }
+    for (int32_t i = 0; i < count && !round->is_mismatched; ++i) {
+      if (round->operations[i] &&
+          !iree_hal_local_channel_operations_match(round->operations[i],
+                                                   operation)) {
+        round->is_mismatched = true;
+      }
+    }
+    round->operations[rank] = operation;
+    operation->impl.state = IREE_HAL_LOCAL_CHANNEL_OPERATION_STATE_ARRIVED;
+    operation->impl.sequence = sequence;
+    ++channel->next_sequence;
+    const bool is_last = ++round->arrived_count == count;
+    if (is_last) memcpy(peers, round->operations, count * sizeof(peers[0]));
+    iree_slim_mutex_unlock(&group->mutex);
+    if (!is_last) return iree_ok_status();
+
+    // All participants have arrived; wake the others to do their share.
+    iree_hal_local_channel_resume_peers(peers, count, rank);
+  }
+
+  if (operation->impl.state ==
+      IREE_HAL_LOCAL_CHANNEL_OPERATION_STATE_ARRIVED) {
+    // The round is not modified until all participants have finished.
+    iree_hal_local_channel_round_t* round =
+        &group->rounds[operation->impl.sequence %
+                       IREE_HAL_LOCAL_CHANNEL_ROUND_COUNT];
+    if (round->is_mismatched) {
+      operation->impl.status_code = IREE_STATUS_FAILED_PRECONDITION;
+    } else {
+      IREE_TRACE_ZONE_BEGIN(z0);
+      IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, operation->element_count);
+      iree_hal_local_channel_execute(round, rank, count);
+      IREE_TRACE_ZONE_END(z0);
+      operation->impl.status_code = IREE_STATUS_OK;
+    }
+    operation->impl.state = IREE_HAL_LOCAL_CHANNEL_OPERATION_STATE_FINISHED;
+    if (iree_atomic_fetch_add_int32(&round->finished_count, 1,
+                                    iree_memory_order_acq_rel) +
+            1 <
+        count) {
+      return iree_ok_status();
+    }
+
+    // All participants have finished; release the round and wake the others
+    // so they can complete.
+    iree_slim_mutex_lock(&group->mutex);
+    memcpy(peers, round->operations, count * sizeof(peers[0]));
+    round->sequence = -1;
+    iree_slim_mutex_unlock(&group->mutex);
+    iree_hal_local_channel_resume_peers(peers, count, rank);
+  }
+
+  // Finished and all other participants have as well.
+  const iree_status_code_t status_code = operation->impl.status_code;
+  memset(&operation->impl, 0, sizeof(operation->impl));
+  *out_completed = true;
+  if (status_code != IREE_STATUS_OK) {
+    return iree_make_status(status_code,
+                            "collective operations issued by participants of "
+                            "the channel do not match");
+  }
+  return iree_ok_status();
+}
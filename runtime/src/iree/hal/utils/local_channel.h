@@ -0,0 +1,112 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_LOCAL_CHANNEL_H_
+#define IREE_HAL_UTILS_LOCAL_CHANNEL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Maximum number of participants in a local channel group.
+#define IREE_HAL_LOCAL_CHANNEL_MAX_COUNT 64
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_channel_provider_t
+//===----------------------------------------------------------------------===//
+
+// Creates |count| in-process channel providers that share a single world.
+// Provider i reports rank i of |count| as its default and should be assigned
+// to the i-th device (usually one per NUMA node) participating in
+// collectives. Channels created from any of the providers with the same
+// group, id, and count join the same collective group.
+//
+// |out_channel_providers| must have room for |count| providers, each of which
+// must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_hal_local_channel_provider_create(
+    iree_host_size_t count, iree_allocator_t host_allocator,
+    iree_hal_channel_provider_t** out_channel_providers);
+
+// Returns true if |channel_provider| is a local channel provider.
+IREE_API_EXPORT bool iree_hal_local_channel_provider_isa(
+    iree_hal_channel_provider_t* channel_provider);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_channel_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_local_channel_operation_t
+    iree_hal_local_channel_operation_t;
+
+// Called when |operation| may be able to make progress and should be advanced
+// again with iree_hal_local_channel_advance. May be called from any thread
+// participating in the collective. The callback must not block and must not
+// call back into the channel.
+typedef void(IREE_API_PTR* iree_hal_local_channel_operation_fn_t)(
+    void* user_data, iree_hal_local_channel_operation_t* operation);
+
+// A collective operation executed by a local channel. Storage is owned by the
+// submitter and must remain valid (and unmodified) until
+// iree_hal_local_channel_advance reports that it has completed.
+typedef struct iree_hal_local_channel_operation_t {
+  // Collective operation as defined by iree_hal_command_buffer_collective.
+  iree_hal_collective_op_t op;
+  uint32_t param;
+  // Host pointers to the send and receive buffers (may be NULL if unused by
+  // the operation).
+  const void* send_ptr;
+  void* recv_ptr;
+  iree_device_size_t element_count;
+  // Resume callback issued each time the operation is ready to be advanced.
+  iree_hal_local_channel_operation_fn_t fn;
+  void* user_data;
+
+  // Execution state managed by the channel; zero-initialize before the first
+  // iree_hal_local_channel_advance of each execution.
+  struct {
+    uint32_t state;
+    int64_t sequence;
+    iree_status_code_t status_code;
+  } impl;
+} iree_hal_local_channel_operation_t;
+
+// Creates an in-process collective channel for |params| using the local
+// |channel_provider|. Default ranks and counts are taken from the provider.
+// All participants exchange data directly through shared memory and the
+// channel must only be used with host-accessible buffers.
+IREE_API_EXPORT iree_status_t iree_hal_local_channel_create(
+    iree_hal_channel_provider_t* channel_provider,
+    iree_hal_channel_params_t params, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel);
+
+// Returns true if |channel| is a local channel.
+IREE_API_EXPORT bool iree_hal_local_channel_isa(iree_hal_channel_t* channel);
+
+// Advances |operation| on the local |channel| without blocking.
+// Sets |out_completed| to true and returns the operation result once the
+// operation has completed on all participants. Otherwise returns OK with
+// |out_completed| false and the operation |fn| will be called when the
+// operation should be advanced again; it must not be advanced before then.
+//
+// Returns an error without arriving if the operation is not supported.
+//
+// Operations must be issued in the same order by all participants. Once all
+// have arrived each participant performs its share of the work from its own
+// thread when next advanced: reductions are partitioned into contiguous
+// cache-line-aligned chunks with each participant reducing one chunk from all
+// send buffers exactly once, and data movement is pulled by the receiver.
+IREE_API_EXPORT iree_status_t iree_hal_local_channel_advance(
+    iree_hal_channel_t* channel, iree_hal_local_channel_operation_t* operation,
+    bool* out_completed);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_LOCAL_CHANNEL_H_
@@ -0,0 +1,292 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/local_channel.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using ::iree::StatusCode;
+using ::iree::testing::status::StatusIs;
+
+// Number of participants in the test world. Chosen so that element counts in
+// the tests do not partition evenly.
+constexpr int32_t kCount = 3;
+
+// A participant operation driven by the test.
+struct Participant {
+  iree_hal_channel_t* channel = NULL;
+  iree_hal_local_channel_operation_t operation;
+  bool is_ready = false;
+  bool is_completed = false;
+  iree_status_t status = iree_ok_status();
+
+  static void Resume(void* user_data,
+                     iree_hal_local_channel_operation_t* operation) {
+    ((Participant*)user_data)->is_ready = true;
+  }
+};
+
+class LocalChannelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_local_channel_provider_create(
+        kCount, iree_allocator_system(), channel_providers_));
+    for (int32_t i = 0; i < kCount; ++i) {
+      iree_hal_channel_params_t params = {0};
+      params.rank = IREE_HAL_CHANNEL_RANK_DEFAULT;
+      params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+      IREE_ASSERT_OK(iree_hal_local_channel_create(
+          channel_providers_[i], params, iree_allocator_system(),
+          &participants_[i].channel));
+    }
+  }
+
+  void TearDown() override {
+    for (int32_t i = 0; i < kCount; ++i) {
+      iree_status_ignore(participants_[i].status);
+      iree_hal_channel_release(participants_[i].channel);
+      iree_hal_channel_provider_release(channel_providers_[i]);
+    }
+  }
+
+  // Prepares the operation of participant |rank|.
+  void Prepare(int32_t rank, iree_hal_collective_kind_t kind,
+               iree_hal_collective_reduction_t reduction,
+               iree_hal_collective_element_type_t element_type,
+               uint32_t param, const void* send_ptr, void* recv_ptr,
+               iree_device_size_t element_count) {
+    Participant& participant = participants_[rank];
+    memset(&participant.operation, 0, sizeof(participant.operation));
+    participant.operation.op.kind = kind;
+    participant.operation.op.reduction = reduction;
+    participant.operation.op.element_type = element_type;
+    participant.operation.param = param;
+    participant.operation.send_ptr = send_ptr;
+    participant.operation.recv_ptr = recv_ptr;
+    participant.operation.element_count = element_count;
+    participant.operation.fn = Participant::Resume;
+    participant.operation.user_data = &participant;
+    participant.is_ready = true;
+    participant.is_completed = false;
+  }
+
+  // Advances participants in |order| from a single thread as they become
+  // ready until all have completed.
+  void Run(std::vector<int32_t> order = {2, 0, 1}) {
+    for (int iteration = 0; iteration < 4 * kCount; ++iteration) {
+      bool all_completed = true;
+      for (int32_t rank : order) {
+        Participant& participant = participants_[rank];
+        if (participant.is_completed) continue;
+        all_completed = false;
+        if (!participant.is_ready) continue;
+        participant.is_ready = false;
+        participant.status = iree_hal_local_channel_advance(
+            participant.channel, &participant.operation,
+            &participant.is_completed);
+        if (!iree_status_is_ok(participant.status)) {
+          participant.is_completed = true;
+        }
+      }
+      if (all_completed) return;
+    }
+    FAIL() << "collective did not complete";
+  }
+
+  iree_hal_channel_provider_t* channel_providers_[kCount] = {NULL};
+  Participant participants_[kCount];
+};
+
+TEST_F(LocalChannelTest, QueryRankAndCount) {
+  for (int32_t i = 0; i < kCount; ++i) {
+    int32_t rank = -1;
+    int32_t count = -1;
+    iree_hal_channel_query_rank_and_count(participants_[i].channel, &rank,
+                                          &count);
+    EXPECT_EQ(rank, i);
+    EXPECT_EQ(count, kCount);
+  }
+}
+
+TEST_F(LocalChannelTest, AllReduceSum) {
+  // Large enough to span several chunks and blocks.
+  constexpr iree_device_size_t kElementCount = 50001;
+  std::vector<float> send[kCount];
+  std::vector<float> recv[kCount];
+  for (int32_t i = 0; i < kCount; ++i) {
+    send[i].resize(kElementCount);
+    recv[i].resize(kElementCount, -1.0f);
+    for (iree_device_size_t j = 0; j < kElementCount; ++j) {
+      send[i][j] = (float)((i + 1) * (j % 7));
+    }
+    Prepare(i, IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+            IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+            IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32, 0, send[i].data(),
+            recv[i].data(), kElementCount);
+  }
+  Run();
+  for (int32_t i = 0; i < kCount; ++i) {
+    IREE_ASSERT_OK(participants_[i].status);
+    for (iree_device_size_t j = 0; j < kElementCount; ++j) {
+      ASSERT_EQ(recv[i][j], (float)(6 * (j % 7)));
+    }
+  }
+}
+
+TEST_F(LocalChannelTest, AllReduceAverageInPlace) {
+  constexpr iree_device_size_t kElementCount = 37;
+  std::vector<int32_t> buffer[kCount];
+  for (int32_t i = 0; i < kCount; ++i) {
+    buffer[i].resize(kElementCount, (i + 1) * 10);
+    Prepare(i, IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+            IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE,
+            IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32, 0, buffer[i].data(),
+            buffer[i].data(), kElementCount);
+  }
+  Run();
+  for (int32_t i = 0; i < kCount; ++i) {
+    IREE_ASSERT_OK(participants_[i].status);
+    for (int32_t value : buffer[i]) ASSERT_EQ(value, 20);
+  }
+}
+
+TEST_F(LocalChannelTest, AllGather) {
+  constexpr iree_device_size_t kElementCount = 5;
+  std::vector<uint16_t> send[kCount];
+  std::vector<uint16_t> recv[kCount];
+  for (int32_t i = 0; i < kCount; ++i) {
+    send[i].resize(kElementCount);
+    for (iree_device_size_t j = 0; j < kElementCount; ++j) {
+      send[i][j] = (uint16_t)(i * 100 + j);
+    }
+    recv[i].resize(kElementCount * kCount);
+    Prepare(i, IREE_HAL_COLLECTIVE_KIND_ALL_GATHER,
+            IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+            IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_16, 0, send[i].data(),
+            recv[i].data(), kElementCount);
+  }
+  Run();
+  for (int32_t i = 0; i < kCount; ++i) {
+    IREE_ASSERT_OK(participants_[i].status);
+    for (int32_t k = 0; k < kCount; ++k) {
+      for (iree_device_size_t j = 0; j < kElementCount; ++j) {
+        ASSERT_EQ(recv[i][k * kElementCount + j], (uint16_t)(k * 100 + j));
+      }
+    }
+  }
+}
+
+TEST_F(LocalChannelTest, ReduceScatterMaximum) {
+  constexpr iree_device_size_t kElementCount = 4;
+  std::vector<int8_t> send[kCount];
+  std::vector<int8_t> recv[kCount];
+  for (int32_t i = 0; i < kCount; ++i) {
+    send[i].resize(kElementCount * kCount);
+    for (iree_device_size_t j = 0; j < send[i].size(); ++j) {
+      send[i][j] = (int8_t)((j % kCount) == (iree_device_size_t)i ? j : -j);
+    }
+    recv[i].resize(kElementCount);
+    Prepare(i, IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER,
+            IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM,
+            IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_8, 0, send[i].data(),
+            recv[i].data(), kElementCount);
+  }
+  Run();
+  for (int32_t i = 0; i < kCount; ++i) {
+    IREE_ASSERT_OK(participants_[i].status);
+    for (iree_device_size_t j = 0; j < kElementCount; ++j) {
+      const iree_device_size_t index = i * kElementCount + j;
+      ASSERT_EQ(recv[i][j], (int8_t)index) << "rank " << i << " element " << j;
+    }
+  }
+}
+
+TEST_F(LocalChannelTest, SendRecvRing) {
+  constexpr iree_device_size_t kElementCount = 3;
+  std::vector<uint32_t> send[kCount];
+  std::vector<uint32_t> recv[kCount];
+  for (int32_t i = 0; i < kCount; ++i) {
+    send[i].resize(kElementCount, (uint32_t)(i + 1));
+    recv[i].resize(kElementCount, 0xCDCDCDCDu);
+    // Each rank sends to the next and receives from the previous except for
+    // rank 0 which receives nothing.
+    uint16_t send_rank = i + 1 < kCount ? (uint16_t)(i + 1) : 0xFFFF;
+    uint16_t recv_rank = i > 0 ? (uint16_t)(i - 1) : 0xFFFF;
+    Prepare(i, IREE_HAL_COLLECTIVE_KIND_SEND_RECV,
+            IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+            IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_32,
+            (uint32_t)send_rank | ((uint32_t)recv_rank << 16), send[i].data(),
+            recv[i].data(), kElementCount);
+  }
+  Run();
+  for (int32_t i = 0; i < kCount; ++i) {
+    IREE_ASSERT_OK(participants_[i].status);
+    for (uint32_t value : recv[i]) ASSERT_EQ(value, (uint32_t)i);
+  }
+}
+
+TEST_F(LocalChannelTest, SequentialOperations) {
+  // Operations are matched by issue order across participants regardless of
+  // the order in which participants advance.
+  std::vector<float> buffer[kCount];
+  for (int32_t i = 0; i < kCount; ++i) buffer[i].resize(16, 1.0f);
+  for (int iteration = 0; iteration < 8; ++iteration) {
+    for (int32_t i = 0; i < kCount; ++i) {
+      Prepare(i, IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+              IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+              IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32, 0, buffer[i].data(),
+              buffer[i].data(), buffer[i].size());
+    }
+    Run(iteration % 2 ? std::vector<int32_t>{0, 1, 2}
+                      : std::vector<int32_t>{1, 2, 0});
+    for (int32_t i = 0; i < kCount; ++i) {
+      IREE_ASSERT_OK(participants_[i].status);
+    }
+  }
+  for (int32_t i = 0; i < kCount; ++i) {
+    for (float value : buffer[i]) ASSERT_EQ(value, 6561.0f);  // 3^8
+  }
+}
+
+TEST_F(LocalChannelTest, MismatchedOperationsFail) {
+  float send[kCount][4] = {{0}};
+  float recv[kCount][4] = {{0}};
+  for (int32_t i = 0; i < kCount; ++i) {
+    Prepare(i, IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+            IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+            IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32, 0, send[i], recv[i],
+            i == 1 ? 2 : 4);
+  }
+  Run();
+  for (int32_t i = 0; i < kCount; ++i) {
+    EXPECT_THAT(iree::Status(participants_[i].status),
+                StatusIs(StatusCode::kFailedPrecondition));
+    participants_[i].status = iree_ok_status();
+  }
+}
+
+TEST_F(LocalChannelTest, DuplicateRankFails) {
+  iree_hal_channel_params_t params = {0};
+  params.rank = IREE_HAL_CHANNEL_RANK_DEFAULT;
+  params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+  iree_hal_channel_t* channel = NULL;
+  EXPECT_THAT(iree::Status(iree_hal_local_channel_create(
+                  channel_providers_[0], params, iree_allocator_system(),
+                  &channel)),
+              StatusIs(StatusCode::kAlreadyExists));
+  EXPECT_EQ(channel, nullptr);
+}
+
+}  // namespace
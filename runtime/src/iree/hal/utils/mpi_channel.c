@@ -0,0 +1,702 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/mpi_channel.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/hal/utils/libmpi.h"
+#include "iree/hal/utils/mpi_channel_provider.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_mpi_channel_t
+//===----------------------------------------------------------------------===//
+
+// An operation that has been issued to MPI and is awaiting completion.
+// SEND_RECV operations may require two requests; all others require one.
+typedef struct iree_hal_mpi_channel_request_t {
+  iree_hal_mpi_channel_operation_t* operation;
+  int request_count;
+  IREE_MPI_Request requests[2];
+  // Failure encountered while issuing or testing the requests, if any.
+  iree_status_t status;
+} iree_hal_mpi_channel_request_t;
+
+typedef struct iree_hal_mpi_channel_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+
+  // Provider owning the MPI library and context. Retained for the lifetime of
+  // the channel so that MPI is not finalized while the channel is live.
+  iree_hal_channel_provider_t* channel_provider;
+  iree_hal_mpi_dynamic_symbols_t* symbols;
+
+  // Parent channel this was split from, if any.
+  // This is only used to keep the parent channel live for as long as there are
+  // any split channels live (including transitive splits).
+  iree_hal_channel_t* parent_channel;
+
+  // This participant's rank in the communicator.
+  int rank;
+  // Total number of participants in the communicator.
+  int count;
+
+  // Communicator owned by the channel.
+  IREE_MPI_Comm comm;
+
+  // Thread issuing submitted operations to MPI and driving their progress.
+  // All MPI calls for the channel after creation are made on this thread.
+  iree_thread_t* progress_thread;
+
+  // Posted when operations are submitted or an exit is requested.
+  iree_notification_t notification;
+
+  iree_slim_mutex_t mutex;
+  // Operations submitted but not yet picked up by the progress thread.
+  iree_hal_mpi_channel_operation_t* pending_head IREE_GUARDED_BY(mutex);
+  iree_hal_mpi_channel_operation_t* pending_tail IREE_GUARDED_BY(mutex);
+  // Set when the channel is being destroyed. The progress thread exits once
+  // all previously submitted operations have completed.
+  bool exit_requested IREE_GUARDED_BY(mutex);
+
+  // Operations issued to MPI. Only accessed by the progress thread.
+  iree_host_size_t inflight_count;
+  iree_hal_mpi_channel_request_t
+      inflight[IREE_HAL_MPI_CHANNEL_MAX_INFLIGHT_OPERATIONS];
+} iree_hal_mpi_channel_t;
+
+static const iree_hal_channel_vtable_t iree_hal_mpi_channel_vtable;
+
+static iree_hal_mpi_channel_t* iree_hal_mpi_channel_cast(
+    iree_hal_channel_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_mpi_channel_vtable);
+  return (iree_hal_mpi_channel_t*)base_value;
+}
+
+static const iree_hal_mpi_channel_t* iree_hal_mpi_channel_const_cast(
+    const iree_hal_channel_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_mpi_channel_vtable);
+  return (const iree_hal_mpi_channel_t*)base_value;
+}
+
+static int iree_hal_mpi_channel_progress_main(void* entry_arg);
+
+// Wraps |comm| in a new channel and starts its progress thread.
+// Takes ownership of |comm| and frees it on failure.
+static iree_status_t iree_hal_mpi_channel_create_with_comm(
+    iree_hal_channel_provider_t* channel_provider, IREE_MPI_Comm comm,
+    iree_hal_channel_t* parent_channel, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel) {
+  iree_hal_mpi_dynamic_symbols_t* symbols =
+      iree_hal_mpi_channel_provider_symbols(channel_provider);
+
+  int rank = 0;
+  int count = 0;
+  iree_hal_mpi_channel_provider_lock(channel_provider);
+  iree_status_t status = MPI_RESULT_TO_STATUS(
+      symbols, MPI_Comm_rank(comm, &rank), "MPI_Comm_rank");
+  if (iree_status_is_ok(status)) {
+    status = MPI_RESULT_TO_STATUS(symbols, MPI_Comm_size(comm, &count),
+                                  "MPI_Comm_size");
+  }
+  iree_hal_mpi_channel_provider_unlock(channel_provider);
+
+  iree_hal_mpi_channel_t* channel = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(host_allocator, sizeof(*channel),
+                                   (void**)&channel);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_mpi_channel_provider_lock(channel_provider);
+    MPI_IGNORE_ERROR(symbols, MPI_Comm_free(&comm));
+    iree_hal_mpi_channel_provider_unlock(channel_provider);
+    return status;
+  }
+
+  iree_hal_resource_initialize(&iree_hal_mpi_channel_vtable,
+                               &channel->resource);
+  channel->host_allocator = host_allocator;
+  channel->channel_provider = channel_provider;
+  iree_hal_channel_provider_retain(channel_provider);
+  channel->symbols = symbols;
+  channel->parent_channel = parent_channel;
+  iree_hal_channel_retain(parent_channel);
+  channel->rank = rank;
+  channel->count = count;
+  channel->comm = comm;
+  iree_notification_initialize(&channel->notification);
+  iree_slim_mutex_initialize(&channel->mutex);
+  channel->pending_head = NULL;
+  channel->pending_tail = NULL;
+  channel->exit_requested = false;
+  channel->inflight_count = 0;
+
+  iree_thread_create_params_t params;
+  memset(&params, 0, sizeof(params));
+  params.name = IREE_SV("iree-mpi-progress");
+  status = iree_thread_create(iree_hal_mpi_channel_progress_main, channel,
+                              params, host_allocator,
+                              &channel->progress_thread);
+
+  if (iree_status_is_ok(status)) {
+    *out_channel = (iree_hal_channel_t*)channel;
+  } else {
+    iree_hal_channel_release((iree_hal_channel_t*)channel);
+  }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_create(
+    iree_hal_channel_provider_t* channel_provider,
+    iree_hal_channel_params_t params, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel) {
+  IREE_ASSERT_ARGUMENT(channel_provider);
+  IREE_ASSERT_ARGUMENT(out_channel);
+  *out_channel = NULL;
+  if (!iree_hal_mpi_channel_provider_isa(channel_provider)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "MPI channels require an MPI channel provider");
+  }
+  if (iree_hal_mpi_channel_provider_thread_level(channel_provider) <
+      IREE_MPI_THREAD_SERIALIZED) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "MPI was initialized without MPI_THREAD_SERIALIZED support; MPI "
+        "channels require calls from their progress threads");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_mpi_dynamic_symbols_t* symbols =
+      iree_hal_mpi_channel_provider_symbols(channel_provider);
+
+  // Validate the requested rank and count against the world.
+  int world_rank = 0;
+  int world_count = 0;
+  IREE_MPI_Comm comm;
+  memset(&comm, 0, sizeof(comm));
+  iree_hal_mpi_channel_provider_lock(channel_provider);
+  iree_status_t status = MPI_RESULT_TO_STATUS(
+      symbols, MPI_Comm_rank(IREE_MPI_COMM_WORLD(symbols), &world_rank),
+      "MPI_Comm_rank");
+  if (iree_status_is_ok(status)) {
+    status = MPI_RESULT_TO_STATUS(
+        symbols, MPI_Comm_size(IREE_MPI_COMM_WORLD(symbols), &world_count),
+        "MPI_Comm_size");
+  }
+  if (iree_status_is_ok(status) &&
+      ((params.rank != IREE_HAL_CHANNEL_RANK_DEFAULT &&
+        params.rank != world_rank) ||
+       (params.count != IREE_HAL_CHANNEL_COUNT_DEFAULT &&
+        params.count != world_count))) {
+    status = iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "MPI channels span the MPI world (rank %d of %d) but rank %d of %d "
+        "was requested; use iree_hal_channel_split to create subgroups",
+        world_rank, world_count, params.rank, params.count);
+  }
+
+  // Duplicate the world communicator so that channel traffic is isolated from
+  // any other MPI use in the process (including the provider itself).
+  if (iree_status_is_ok(status)) {
+    status = MPI_RESULT_TO_STATUS(
+        symbols, MPI_Comm_dup(IREE_MPI_COMM_WORLD(symbols), &comm),
+        "MPI_Comm_dup");
+  }
+  iree_hal_mpi_channel_provider_unlock(channel_provider);
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_mpi_channel_create_with_comm(
+        channel_provider, comm, /*parent_channel=*/NULL, host_allocator,
+        out_channel);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_mpi_channel_destroy(iree_hal_channel_t* base_channel) {
+  iree_hal_mpi_channel_t* channel = iree_hal_mpi_channel_cast(base_channel);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, channel->rank);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, channel->count);
+
+  iree_allocator_t host_allocator = channel->host_allocator;
+
+  // Request the progress thread exit and join with it. It will drain any
+  // remaining operations prior to exiting.
+  if (channel->progress_thread) {
+    iree_slim_mutex_lock(&channel->mutex);
+    channel->exit_requested = true;
+    iree_slim_mutex_unlock(&channel->mutex);
+    iree_notification_post(&channel->notification, IREE_ALL_WAITERS);
+    iree_thread_release(channel->progress_thread);
+  }
+
+  iree_hal_mpi_channel_provider_lock(channel->channel_provider);
+  MPI_IGNORE_ERROR(channel->symbols, MPI_Comm_free(&channel->comm));
+  iree_hal_mpi_channel_provider_unlock(channel->channel_provider);
+
+  iree_slim_mutex_deinitialize(&channel->mutex);
+  iree_notification_deinitialize(&channel->notification);
+  iree_hal_channel_release(channel->parent_channel);
+  iree_hal_channel_provider_release(channel->channel_provider);
+  iree_allocator_free(host_allocator, channel);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT bool iree_hal_mpi_channel_isa(iree_hal_channel_t* channel) {
+  return iree_hal_resource_is(channel, &iree_hal_mpi_channel_vtable);
+}
+
+static iree_status_t iree_hal_mpi_channel_split(
+    iree_hal_channel_t* base_channel, int32_t color, int32_t key,
+    iree_hal_channel_flags_t flags, iree_hal_channel_t** out_split_channel) {
+  iree_hal_mpi_channel_t* channel = iree_hal_mpi_channel_cast(base_channel);
+
+  // NOTE: splitting is a collective operation on the communicator and callers
+  // must ensure all previously submitted operations have completed.
+  IREE_MPI_Comm split_comm;
+  memset(&split_comm, 0, sizeof(split_comm));
+  iree_hal_mpi_channel_provider_lock(channel->channel_provider);
+  iree_status_t status = MPI_RESULT_TO_STATUS(
+      channel->symbols,
+      MPI_Comm_split(channel->comm,
+                     color == IREE_HAL_CHANNEL_NO_COLOR ? IREE_MPI_UNDEFINED
+                                                        : color,
+                     key, &split_comm),
+      "MPI_Comm_split");
+  iree_hal_mpi_channel_provider_unlock(channel->channel_provider);
+  IREE_RETURN_IF_ERROR(status);
+
+  // Ranks not joining any group participate in the split but get no channel.
+  if (color == IREE_HAL_CHANNEL_NO_COLOR) return iree_ok_status();
+
+  return iree_hal_mpi_channel_create_with_comm(
+      channel->channel_provider, split_comm, base_channel,
+      channel->host_allocator, out_split_channel);
+}
+
+static void iree_hal_mpi_channel_query_rank_and_count(
+    const iree_hal_channel_t* base_channel, int32_t* out_rank,
+    int32_t* out_count) {
+  IREE_ASSERT_ARGUMENT(base_channel);
+  IREE_ASSERT_ARGUMENT(out_count);
+  const iree_hal_mpi_channel_t* channel =
+      iree_hal_mpi_channel_const_cast(base_channel);
+  *out_rank = channel->rank;
+  *out_count = channel->count;
+}
+
+//===----------------------------------------------------------------------===//
+// Operation translation
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_hal_mpi_get_data_type(
+    iree_hal_mpi_dynamic_symbols_t* symbols,
+    iree_hal_collective_element_type_t in, IREE_MPI_Datatype* out) {
+  switch (in) {
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_8:
+      *out = IREE_MPI_INT8_T(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_8:
+      *out = IREE_MPI_UINT8_T(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_16:
+      *out = IREE_MPI_INT16_T(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_16:
+      *out = IREE_MPI_UINT16_T(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32:
+      *out = IREE_MPI_INT32_T(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_32:
+      *out = IREE_MPI_UINT32_T(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_64:
+      *out = IREE_MPI_INT64_T(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_UINT_64:
+      *out = IREE_MPI_UINT64_T(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32:
+      *out = IREE_MPI_FLOAT(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_64:
+      *out = IREE_MPI_DOUBLE(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_16:
+    case IREE_HAL_COLLECTIVE_ELEMENT_TYPE_BFLOAT_16:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "MPI has no standard 16-bit float types");
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unhandled element type for collective op");
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_mpi_get_reduction_op(
+    iree_hal_mpi_dynamic_symbols_t* symbols, iree_hal_collective_reduction_t in,
+    IREE_MPI_Op* out) {
+  switch (in) {
+    case IREE_HAL_COLLECTIVE_REDUCTION_SUM:
+      *out = IREE_MPI_SUM(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT:
+      *out = IREE_MPI_PROD(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM:
+      *out = IREE_MPI_MIN(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM:
+      *out = IREE_MPI_MAX(symbols);
+      break;
+    case IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "MPI has no average reduction");
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unhandled reduction type for collective op");
+  }
+  return iree_ok_status();
+}
+
+// Returns true if |kind| uses a reduction operation.
+static bool iree_hal_mpi_collective_kind_reduces(
+    iree_hal_collective_kind_t kind) {
+  return kind == IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE ||
+         kind == IREE_HAL_COLLECTIVE_KIND_REDUCE ||
+         kind == IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER;
+}
+
+// Issues |operation| as one or more nonblocking MPI calls populating
+// |request|. Must be called with the provider lock held. On failure
+// |request|->request_count indicates how many requests were issued prior to
+// the error and must still be waited on.
+static iree_status_t iree_hal_mpi_channel_issue(
+    iree_hal_mpi_channel_t* channel,
+    iree_hal_mpi_channel_operation_t* operation,
+    iree_hal_mpi_channel_request_t* request) {
+  iree_hal_mpi_dynamic_symbols_t* symbols = channel->symbols;
+  request->operation = operation;
+  request->request_count = 0;
+  request->requests[0] = IREE_MPI_REQUEST_NULL(symbols);
+  request->requests[1] = IREE_MPI_REQUEST_NULL(symbols);
+  request->status = iree_ok_status();
+
+  IREE_MPI_Datatype datatype;
+  IREE_RETURN_IF_ERROR(iree_hal_mpi_get_data_type(
+      symbols, operation->op.element_type, &datatype));
+  IREE_MPI_Op op;
+  memset(&op, 0, sizeof(op));
+  if (iree_hal_mpi_collective_kind_reduces(operation->op.kind)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_mpi_get_reduction_op(symbols, operation->op.reduction, &op));
+  }
+
+  const int count = (int)operation->element_count;
+  const iree_device_size_t byte_length =
+      iree_hal_collective_element_byte_count(operation->op.element_type) *
+      operation->element_count;
+  const void* send_ptr = operation->send_ptr;
+  void* recv_ptr = operation->recv_ptr;
+  iree_status_t status = iree_ok_status();
+  switch (operation->op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER: {
+      if ((const uint8_t*)send_ptr ==
+          (const uint8_t*)recv_ptr + channel->rank * byte_length) {
+        send_ptr = IREE_MPI_IN_PLACE;
+      }
+      status = MPI_RESULT_TO_STATUS(
+          symbols,
+          MPI_Iallgather(send_ptr, count, datatype, recv_ptr, count, datatype,
+                         channel->comm, &request->requests[0]),
+          "MPI_Iallgather");
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE: {
+      if (send_ptr == recv_ptr) send_ptr = IREE_MPI_IN_PLACE;
+      status = MPI_RESULT_TO_STATUS(
+          symbols,
+          MPI_Iallreduce(send_ptr, recv_ptr, count, datatype, op,
+                         channel->comm, &request->requests[0]),
+          "MPI_Iallreduce");
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_ALL_TO_ALL: {
+      // Each rank sends and receives an equal share of the elements.
+      const int part_count = count / channel->count;
+      status = MPI_RESULT_TO_STATUS(
+          symbols,
+          MPI_Ialltoall(send_ptr, part_count, datatype, recv_ptr, part_count,
+                        datatype, channel->comm, &request->requests[0]),
+          "MPI_Ialltoall");
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_BROADCAST: {
+      // MPI broadcasts in-place: the root sends from and all others receive
+      // into the same buffer argument.
+      const int root = (int)operation->param;
+      void* buffer = root == channel->rank ? (void*)send_ptr : recv_ptr;
+      status = MPI_RESULT_TO_STATUS(
+          symbols,
+          MPI_Ibcast(buffer, count, datatype, root, channel->comm,
+                     &request->requests[0]),
+          "MPI_Ibcast");
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE: {
+      const int root = (int)operation->param;
+      if (root == channel->rank && send_ptr == recv_ptr) {
+        send_ptr = IREE_MPI_IN_PLACE;
+      }
+      status = MPI_RESULT_TO_STATUS(
+          symbols,
+          MPI_Ireduce(send_ptr, recv_ptr, count, datatype, op, root,
+                      channel->comm, &request->requests[0]),
+          "MPI_Ireduce");
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER: {
+      status = MPI_RESULT_TO_STATUS(
+          symbols,
+          MPI_Ireduce_scatter_block(send_ptr, recv_ptr, count, datatype, op,
+                                    channel->comm, &request->requests[0]),
+          "MPI_Ireduce_scatter_block");
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_SEND: {
+      status = MPI_RESULT_TO_STATUS(
+          symbols,
+          MPI_Isend(send_ptr, count, datatype, (int)operation->param,
+                    /*tag=*/0, channel->comm, &request->requests[0]),
+          "MPI_Isend");
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_RECV: {
+      status = MPI_RESULT_TO_STATUS(
+          symbols,
+          MPI_Irecv(recv_ptr, count, datatype, (int)operation->param,
+                    /*tag=*/0, channel->comm, &request->requests[0]),
+          "MPI_Irecv");
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_SEND_RECV: {
+      int16_t send_rank;
+      int16_t recv_rank;
+      memcpy(&send_rank, &operation->param, 2);
+      memcpy(&recv_rank, (const char*)&operation->param + 2, 2);
+      if (recv_rank != -1) {
+        status = MPI_RESULT_TO_STATUS(
+            symbols,
+            MPI_Irecv(recv_ptr, count, datatype, recv_rank, /*tag=*/0,
+                      channel->comm, &request->requests[0]),
+            "MPI_Irecv");
+        if (iree_status_is_ok(status)) request->request_count = 1;
+      } else {
+        // Zero out the receive buffer if this rank is not receiving any data.
+        memset(recv_ptr, 0, (size_t)byte_length);
+      }
+      if (iree_status_is_ok(status) && send_rank != -1) {
+        status = MPI_RESULT_TO_STATUS(
+            symbols,
+            MPI_Isend(send_ptr, count, datatype, send_rank, /*tag=*/0,
+                      channel->comm,
+                      &request->requests[request->request_count]),
+            "MPI_Isend");
+        if (iree_status_is_ok(status)) ++request->request_count;
+      }
+      return status;
+    }
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unhandled collective op kind %u",
+                              (uint32_t)operation->op.kind);
+  }
+  if (iree_status_is_ok(status)) request->request_count = 1;
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_submit(
+    iree_hal_channel_t* base_channel,
+    iree_hal_mpi_channel_operation_t* operation) {
+  IREE_ASSERT_ARGUMENT(base_channel);
+  IREE_ASSERT_ARGUMENT(operation);
+  iree_hal_mpi_channel_t* channel = iree_hal_mpi_channel_cast(base_channel);
+
+  // Verify the operation can be issued so that errors are reported to the
+  // submitter instead of asynchronously.
+  IREE_MPI_Datatype datatype;
+  IREE_RETURN_IF_ERROR(iree_hal_mpi_get_data_type(
+      channel->symbols, operation->op.element_type, &datatype));
+  if (iree_hal_mpi_collective_kind_reduces(operation->op.kind)) {
+    IREE_MPI_Op op;
+    IREE_RETURN_IF_ERROR(iree_hal_mpi_get_reduction_op(
+        channel->symbols, operation->op.reduction, &op));
+  }
+  if (operation->op.kind > IREE_HAL_COLLECTIVE_KIND_MAX_VALUE) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "unhandled collective op kind %u",
+                            (uint32_t)operation->op.kind);
+  }
+  if (operation->element_count > INT_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "MPI element counts are limited to %d but %" PRIu64
+                            " were requested",
+                            INT_MAX, (uint64_t)operation->element_count);
+  }
+
+  operation->next = NULL;
+  iree_slim_mutex_lock(&channel->mutex);
+  if (channel->pending_tail) {
+    channel->pending_tail->next = operation;
+  } else {
+    channel->pending_head = operation;
+  }
+  channel->pending_tail = operation;
+  iree_slim_mutex_unlock(&channel->mutex);
+  iree_notification_post(&channel->notification, IREE_ALL_WAITERS);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Progress thread
+//===----------------------------------------------------------------------===//
+
+// Returns true if the progress thread has new operations or should exit.
+static bool iree_hal_mpi_channel_has_work(void* arg) {
+  iree_hal_mpi_channel_t* channel = (iree_hal_mpi_channel_t*)arg;
+  iree_slim_mutex_lock(&channel->mutex);
+  bool has_work = channel->pending_head != NULL || channel->exit_requested;
+  iree_slim_mutex_unlock(&channel->mutex);
+  return has_work;
+}
+
+// Tests all requests of |request| for completion and returns true if they have
+// all completed. Completed requests are reset to MPI_REQUEST_NULL by MPI and
+// are considered complete on subsequent tests. Failures are accumulated in
+// |request|->status and reported once all requests have completed as their
+// buffers may still be in use by MPI until then.
+static bool iree_hal_mpi_channel_test_request(
+    iree_hal_mpi_channel_t* channel, iree_hal_mpi_channel_request_t* request) {
+  bool all_complete = true;
+  iree_hal_mpi_channel_provider_lock(channel->channel_provider);
+  for (int i = 0; i < request->request_count; ++i) {
+    int flag = 0;
+    iree_status_t status = MPI_RESULT_TO_STATUS(
+        channel->symbols,
+        MPI_Test(&request->requests[i], &flag, IREE_MPI_STATUS_IGNORE),
+        "MPI_Test");
+    if (!iree_status_is_ok(status)) {
+      // Failed requests are not retried.
+      request->status = iree_status_join(request->status, status);
+      request->requests[i] = IREE_MPI_REQUEST_NULL(channel->symbols);
+    } else if (!flag) {
+      all_complete = false;
+    }
+  }
+  iree_hal_mpi_channel_provider_unlock(channel->channel_provider);
+  return all_complete;
+}
+
+// Issues operations in |*backlog_head| until the inflight list is full.
+static void iree_hal_mpi_channel_issue_backlog(
+    iree_hal_mpi_channel_t* channel,
+    iree_hal_mpi_channel_operation_t** backlog_head) {
+  while (*backlog_head &&
+         channel->inflight_count < IREE_ARRAYSIZE(channel->inflight)) {
+    iree_hal_mpi_channel_operation_t* operation = *backlog_head;
+    *backlog_head = operation->next;
+    operation->next = NULL;
+    iree_hal_mpi_channel_request_t* request =
+        &channel->inflight[channel->inflight_count];
+    iree_hal_mpi_channel_provider_lock(channel->channel_provider);
+    iree_status_t status =
+        iree_hal_mpi_channel_issue(channel, operation, request);
+    iree_hal_mpi_channel_provider_unlock(channel->channel_provider);
+    if (request->request_count > 0) {
+      // Partially issued operations must wait for their outstanding requests
+      // before reporting the failure.
+      request->status = status;
+      ++channel->inflight_count;
+    } else {
+      operation->fn(operation->user_data, operation, status);
+    }
+  }
+}
+
+static int iree_hal_mpi_channel_progress_main(void* entry_arg) {
+  iree_hal_mpi_channel_t* channel = (iree_hal_mpi_channel_t*)entry_arg;
+
+  // Operations dequeued from the pending list but not yet issued as the
+  // inflight list was full.
+  iree_hal_mpi_channel_operation_t* backlog_head = NULL;
+  iree_hal_mpi_channel_operation_t* backlog_tail = NULL;
+
+  while (true) {
+    // Sleep until there is new work if nothing is outstanding. While requests
+    // are in flight we keep polling them as MPI implementations generally only
+    // make progress on nonblocking operations from within MPI calls.
+    if (channel->inflight_count == 0 && !backlog_head) {
+      iree_notification_await(&channel->notification,
+                              iree_hal_mpi_channel_has_work, channel,
+                              iree_infinite_timeout());
+    }
+
+    iree_slim_mutex_lock(&channel->mutex);
+    if (channel->pending_head) {
+      if (backlog_tail) {
+        backlog_tail->next = channel->pending_head;
+      } else {
+        backlog_head = channel->pending_head;
+      }
+      backlog_tail = channel->pending_tail;
+      channel->pending_head = NULL;
+      channel->pending_tail = NULL;
+    }
+    bool exit_requested = channel->exit_requested;
+    iree_slim_mutex_unlock(&channel->mutex);
+
+    iree_hal_mpi_channel_issue_backlog(channel, &backlog_head);
+    if (!backlog_head) backlog_tail = NULL;
+
+    // Poll all inflight operations and retire those that have completed.
+    bool any_completed = false;
+    for (iree_host_size_t i = 0; i < channel->inflight_count;) {
+      iree_hal_mpi_channel_request_t* request = &channel->inflight[i];
+      if (!iree_hal_mpi_channel_test_request(channel, request)) {
+        ++i;
+        continue;
+      }
+      iree_hal_mpi_channel_operation_t* operation = request->operation;
+      iree_status_t status = request->status;
+      // Swap-remove; operations complete in any order.
+      channel->inflight[i] = channel->inflight[--channel->inflight_count];
+      operation->fn(operation->user_data, operation, status);
+      any_completed = true;
+    }
+
+    if (exit_requested && channel->inflight_count == 0 && !backlog_head) {
+      break;
+    }
+    if (!any_completed && channel->inflight_count > 0) {
+      iree_thread_yield();
+    }
+  }
+
+  return 0;
+}
+
+static const iree_hal_channel_vtable_t iree_hal_mpi_channel_vtable = {
+    .destroy = iree_hal_mpi_channel_destroy,
+    .split = iree_hal_mpi_channel_split,
+    .query_rank_and_count = iree_hal_mpi_channel_query_rank_and_count,
+};
@@ -0,0 +1,75 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_MPI_CHANNEL_H_
+#define IREE_HAL_UTILS_MPI_CHANNEL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Maximum number of operations a channel will have issued to MPI at a time.
+// Additional submitted operations are queued until prior ones complete.
+#define IREE_HAL_MPI_CHANNEL_MAX_INFLIGHT_OPERATIONS 64
+
+typedef struct iree_hal_mpi_channel_operation_t
+    iree_hal_mpi_channel_operation_t;
+
+// Called from the channel progress thread when |operation| has completed.
+// Ownership of |status| is transferred to the callee. The callback must not
+// block and must not call back into MPI.
+typedef void(IREE_API_PTR* iree_hal_mpi_channel_operation_fn_t)(
+    void* user_data, iree_hal_mpi_channel_operation_t* operation,
+    iree_status_t status);
+
+// A collective operation submitted to an MPI channel for asynchronous
+// execution. Storage is owned by the submitter and must remain valid (and
+// unmodified) until the completion callback has been issued.
+typedef struct iree_hal_mpi_channel_operation_t {
+  // Used by the channel to queue the operation; initialized on submission.
+  iree_hal_mpi_channel_operation_t* next;
+  // Collective operation as defined by iree_hal_command_buffer_collective.
+  iree_hal_collective_op_t op;
+  uint32_t param;
+  // Host pointers to the send and receive buffers (may be NULL if unused by
+  // the operation).
+  const void* send_ptr;
+  void* recv_ptr;
+  iree_device_size_t element_count;
+  // Completion callback issued exactly once per submission.
+  iree_hal_mpi_channel_operation_fn_t fn;
+  void* user_data;
+} iree_hal_mpi_channel_operation_t;
+
+// Creates an MPI collective channel using the library loaded by the MPI
+// |channel_provider|. The channel spans the default MPI world and |params|
+// must either leave the rank and count as default or match the world.
+//
+// Operations are issued as nonblocking MPI collectives from a progress thread
+// owned by the channel, allowing the submitting thread to continue with other
+// work while communication is in flight.
+IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_create(
+    iree_hal_channel_provider_t* channel_provider,
+    iree_hal_channel_params_t params, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel);
+
+// Returns true if |channel| is an MPI channel.
+IREE_API_EXPORT bool iree_hal_mpi_channel_isa(iree_hal_channel_t* channel);
+
+// Submits |operation| for asynchronous execution on the MPI |channel|.
+// Operations are issued to MPI in submission order. Returns an error without
+// issuing the completion callback if the operation is not supported.
+IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_submit(
+    iree_hal_channel_t* channel, iree_hal_mpi_channel_operation_t* operation);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_MPI_CHANNEL_H_
@@ -8,6 +8,7 @@
 
 #include <stdlib.h>
 
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/utils/libmpi.h"
 
 // Returns true if |var_name| is set to a non-empty value in the environment.
@@ -42,6 +43,13 @@ typedef struct iree_hal_mpi_channel_provider_t {
   // that use MPI will depend on the channel provider lifespan.
   // It may be better to let the user be the owner of MPI's context.
   bool is_mpi_context_owner;
+
+  // Thread support level provided by the MPI library (IREE_MPI_THREAD_*).
+  // Channels issue MPI calls from their progress threads and unless the
+  // library supports IREE_MPI_THREAD_MULTIPLE all calls are serialized with
+  // |mutex|.
+  int thread_level;
+  iree_slim_mutex_t mutex;
 } iree_hal_mpi_channel_provider_t;
 
 static const iree_hal_channel_provider_vtable_t
@@ -66,6 +74,7 @@ IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_provider_create(
   iree_hal_resource_initialize(&iree_hal_mpi_channel_provider_vtable,
                                &channel_provider->resource);
   channel_provider->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&channel_provider->mutex);
 
   // Attempt to load the shared library. This will fail if it's not found,
   // not compatible with the process (wrong arch), or missing symbols (out of
@@ -84,10 +93,21 @@ IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_provider_create(
   }
   if (iree_status_is_ok(status)) {
     if (!is_mpi_initialized_already) {
-      IREE_TRACE_ZONE_BEGIN_NAMED(z2, "MPI_Init");
-      status = MPI_RESULT_TO_STATUS(&channel_provider->symbols,
-                                    MPI_Init(NULL, NULL), "MPI_Init");
+      // Channels make MPI calls from their own progress threads so we need at
+      // least serialized access; we ask for full thread support so that those
+      // calls need not take a process-wide lock.
+      IREE_TRACE_ZONE_BEGIN_NAMED(z2, "MPI_Init_thread");
+      status = MPI_RESULT_TO_STATUS(
+          &channel_provider->symbols,
+          MPI_Init_thread(NULL, NULL, IREE_MPI_THREAD_MULTIPLE,
+                          &channel_provider->thread_level),
+          "MPI_Init_thread");
       IREE_TRACE_ZONE_END(z2);
+    } else {
+      status = MPI_RESULT_TO_STATUS(
+          &channel_provider->symbols,
+          MPI_Query_thread(&channel_provider->thread_level),
+          "MPI_Query_thread");
     }
     channel_provider->is_mpi_context_owner = !is_mpi_initialized_already;
   }
@@ -133,6 +153,7 @@ static void iree_hal_mpi_channel_provider_destroy(
 
   iree_dynamic_library_release(channel_provider->library);
 
+  iree_slim_mutex_deinitialize(&channel_provider->mutex);
   iree_allocator_free(host_allocator, channel_provider);
 
   IREE_TRACE_ZONE_END(z0);
@@ -154,6 +175,31 @@ iree_hal_mpi_channel_provider_symbols(
   return &channel_provider->symbols;
 }
 
+IREE_API_EXPORT int iree_hal_mpi_channel_provider_thread_level(
+    iree_hal_channel_provider_t* base_channel_provider) {
+  iree_hal_mpi_channel_provider_t* channel_provider =
+      iree_hal_mpi_channel_provider_cast(base_channel_provider);
+  return channel_provider->thread_level;
+}
+
+IREE_API_EXPORT void iree_hal_mpi_channel_provider_lock(
+    iree_hal_channel_provider_t* base_channel_provider) {
+  iree_hal_mpi_channel_provider_t* channel_provider =
+      iree_hal_mpi_channel_provider_cast(base_channel_provider);
+  if (channel_provider->thread_level < IREE_MPI_THREAD_MULTIPLE) {
+    iree_slim_mutex_lock(&channel_provider->mutex);
+  }
+}
+
+IREE_API_EXPORT void iree_hal_mpi_channel_provider_unlock(
+    iree_hal_channel_provider_t* base_channel_provider) {
+  iree_hal_mpi_channel_provider_t* channel_provider =
+      iree_hal_mpi_channel_provider_cast(base_channel_provider);
+  if (channel_provider->thread_level < IREE_MPI_THREAD_MULTIPLE) {
+    iree_slim_mutex_unlock(&channel_provider->mutex);
+  }
+}
+
 static iree_status_t iree_hal_mpi_channel_provider_query_default_rank_and_count(
     iree_hal_channel_provider_t* base_channel_provider, int32_t* out_rank,
     int32_t* out_count) {
@@ -161,18 +207,21 @@ static iree_status_t iree_hal_mpi_channel_provider_query_default_rank_and_count(
       iree_hal_mpi_channel_provider_cast(base_channel_provider);
 
   static_assert(sizeof(int32_t) == sizeof(int), "MPI uses int");
-  MPI_RETURN_IF_ERROR(
+  iree_hal_mpi_channel_provider_lock(base_channel_provider);
+  iree_status_t status = MPI_RESULT_TO_STATUS(
       &channel_provider->symbols,
       MPI_Comm_rank(IREE_MPI_COMM_WORLD(&channel_provider->symbols),
                     (int*)out_rank),
       "MPI_Comm_rank");
-  MPI_RETURN_IF_ERROR(
-      &channel_provider->symbols,
-      MPI_Comm_size(IREE_MPI_COMM_WORLD(&channel_provider->symbols),
-                    (int*)out_count),
-      "MPI_Comm_size");
-
-  return iree_ok_status();
+  if (iree_status_is_ok(status)) {
+    status = MPI_RESULT_TO_STATUS(
+        &channel_provider->symbols,
+        MPI_Comm_size(IREE_MPI_COMM_WORLD(&channel_provider->symbols),
+                      (int*)out_count),
+        "MPI_Comm_size");
+  }
+  iree_hal_mpi_channel_provider_unlock(base_channel_provider);
+  return status;
 }
 
 IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_provider_exchange_default_id(
@@ -182,14 +231,15 @@ IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_provider_exchange_default_id(
 
   // Exchange the ID with all other participants. The root participant will
   // send its ID while the others will receive it.
-  MPI_RETURN_IF_ERROR(
+  iree_hal_mpi_channel_provider_lock(base_channel_provider);
+  iree_status_t status = MPI_RESULT_TO_STATUS(
       &channel_provider->symbols,
       MPI_Bcast(id.data, id.data_length,
                 IREE_MPI_BYTE(&channel_provider->symbols), 0,
                 IREE_MPI_COMM_WORLD(&channel_provider->symbols)),
       "MPI_Bcast");
-
-  return iree_ok_status();
+  iree_hal_mpi_channel_provider_unlock(base_channel_provider);
+  return status;
 }
 
 static const iree_hal_channel_provider_vtable_t
@@ -22,10 +22,10 @@ typedef struct iree_hal_mpi_dynamic_symbols_t iree_hal_mpi_dynamic_symbols_t;
 IREE_API_EXPORT bool iree_hal_mpi_is_configured(void);
 
 // Creates an MPI-based collective channel provider.
-// On creation the provider will initialize MPI with MPI_Init and on destruction
-// will finalize MPI with MPI_Finalize after which time MPI can never be used in
-// the process again. Users should create one provider and share it across all
-// devices used within the process.
+// On creation the provider will initialize MPI with MPI_Init_thread (requesting
+// MPI_THREAD_MULTIPLE) and on destruction will finalize MPI with MPI_Finalize
+// after which time MPI can never be used in the process again. Users should
+// create one provider and share it across all devices used within the process.
 IREE_API_EXPORT iree_status_t iree_hal_mpi_channel_provider_create(
     iree_allocator_t host_allocator,
     iree_hal_channel_provider_t** out_channel_provider);
@@ -40,6 +40,23 @@ IREE_API_EXPORT iree_hal_mpi_dynamic_symbols_t*
 iree_hal_mpi_channel_provider_symbols(
     iree_hal_channel_provider_t* channel_provider);
 
+// Returns the thread support level provided by the MPI library as one of the
+// MPI_THREAD_* values. |channel_provider| must be an MPI channel provider.
+IREE_API_EXPORT int iree_hal_mpi_channel_provider_thread_level(
+    iree_hal_channel_provider_t* channel_provider);
+
+// Acquires exclusive use of the MPI library for the calling thread if the
+// library does not support concurrent calls from multiple threads. All MPI
+// calls made through the provider symbols must be bracketed by a lock/unlock
+// pair. |channel_provider| must be an MPI channel provider.
+IREE_API_EXPORT void iree_hal_mpi_channel_provider_lock(
+    iree_hal_channel_provider_t* channel_provider);
+
+// Releases the use of the MPI library acquired with
+// iree_hal_mpi_channel_provider_lock.
+IREE_API_EXPORT void iree_hal_mpi_channel_provider_unlock(
+    iree_hal_channel_provider_t* channel_provider);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,171 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/mpi_channel.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/mpi_channel_provider.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using ::iree::StatusCode;
+using ::iree::testing::status::StatusIs;
+
+// Tracks completion of a submitted operation.
+struct Completion {
+  iree_notification_t notification;
+  iree_atomic_int32_t completed = IREE_ATOMIC_VAR_INIT(0);
+  iree_status_t status = iree_ok_status();
+
+  Completion() { iree_notification_initialize(&notification); }
+  ~Completion() { iree_notification_deinitialize(&notification); }
+
+  static void Callback(void* user_data,
+                       iree_hal_mpi_channel_operation_t* operation,
+                       iree_status_t status) {
+    auto* completion = (Completion*)user_data;
+    completion->status = status;
+    iree_atomic_store_int32(&completion->completed, 1,
+                            iree_memory_order_release);
+    iree_notification_post(&completion->notification, IREE_ALL_WAITERS);
+  }
+
+  iree_status_t Wait() {
+    iree_notification_await(
+        &notification,
+        [](void* arg) {
+          return iree_atomic_load_int32((iree_atomic_int32_t*)arg,
+                                        iree_memory_order_acquire) == 1;
+        },
+        &completed, iree_infinite_timeout());
+    return status;
+  }
+};
+
+class MpiChannelTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    iree_status_t status = iree_hal_mpi_channel_provider_create(
+        iree_allocator_system(), &channel_provider);
+    if (!iree_status_is_ok(status)) {
+      iree_status_fprint(stderr, status);
+      iree_status_ignore(status);
+      channel_provider = NULL;
+    }
+  }
+
+  static void TearDownTestSuite() {
+    iree_hal_channel_provider_release(channel_provider);
+    channel_provider = NULL;
+  }
+
+  void SetUp() override {
+    if (!channel_provider) {
+      GTEST_SKIP() << "No MPI library available. Skipping suite.";
+    }
+    iree_hal_channel_params_t params = {0};
+    params.rank = IREE_HAL_CHANNEL_RANK_DEFAULT;
+    params.count = IREE_HAL_CHANNEL_COUNT_DEFAULT;
+    IREE_ASSERT_OK(iree_hal_mpi_channel_create(
+        channel_provider, params, iree_allocator_system(), &channel));
+    iree_hal_channel_query_rank_and_count(channel, &rank, &count);
+  }
+
+  void TearDown() override { iree_hal_channel_release(channel); }
+
+  static iree_hal_mpi_channel_operation_t MakeOperation(
+      iree_hal_collective_kind_t kind,
+      iree_hal_collective_reduction_t reduction,
+      iree_hal_collective_element_type_t element_type, const void* send_ptr,
+      void* recv_ptr, iree_device_size_t element_count,
+      Completion* completion) {
+    iree_hal_mpi_channel_operation_t operation;
+    memset(&operation, 0, sizeof(operation));
+    operation.op.kind = kind;
+    operation.op.reduction = reduction;
+    operation.op.element_type = element_type;
+    operation.send_ptr = send_ptr;
+    operation.recv_ptr = recv_ptr;
+    operation.element_count = element_count;
+    operation.fn = Completion::Callback;
+    operation.user_data = completion;
+    return operation;
+  }
+
+  static iree_hal_channel_provider_t* channel_provider;
+  iree_hal_channel_t* channel = NULL;
+  int32_t rank = 0;
+  int32_t count = 0;
+};
+
+iree_hal_channel_provider_t* MpiChannelTest::channel_provider = NULL;
+
+// Tests that a channel reports a valid rank in the MPI world.
+TEST_F(MpiChannelTest, RankAndCount) {
+  EXPECT_GE(rank, 0);
+  EXPECT_LT(rank, count);
+}
+
+// Tests an in-place all-reduce completing asynchronously.
+TEST_F(MpiChannelTest, AllReduceInPlace) {
+  std::vector<int32_t> values(16, rank + 1);
+  Completion completion;
+  iree_hal_mpi_channel_operation_t operation = MakeOperation(
+      IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE, IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+      IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32, values.data(), values.data(),
+      values.size(), &completion);
+  IREE_ASSERT_OK(iree_hal_mpi_channel_submit(channel, &operation));
+  IREE_ASSERT_OK(completion.Wait());
+  for (int32_t value : values) {
+    EXPECT_EQ(value, count * (count + 1) / 2);
+  }
+}
+
+// Tests that many operations in flight at once all complete.
+TEST_F(MpiChannelTest, ManyInflight) {
+  static const int kOperationCount =
+      IREE_HAL_MPI_CHANNEL_MAX_INFLIGHT_OPERATIONS * 2;
+  std::vector<float> send_values(kOperationCount);
+  std::vector<float> recv_values(kOperationCount);
+  std::vector<Completion> completions(kOperationCount);
+  std::vector<iree_hal_mpi_channel_operation_t> operations(kOperationCount);
+  for (int i = 0; i < kOperationCount; ++i) {
+    send_values[i] = (float)i;
+    operations[i] = MakeOperation(
+        IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+        IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM,
+        IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32, &send_values[i],
+        &recv_values[i], 1, &completions[i]);
+    IREE_ASSERT_OK(iree_hal_mpi_channel_submit(channel, &operations[i]));
+  }
+  for (int i = 0; i < kOperationCount; ++i) {
+    IREE_ASSERT_OK(completions[i].Wait());
+    EXPECT_EQ(recv_values[i], (float)i);
+  }
+}
+
+// Tests that unsupported operations are rejected without being issued.
+TEST_F(MpiChannelTest, UnsupportedReduction) {
+  float value = 0.0f;
+  Completion completion;
+  iree_hal_mpi_channel_operation_t operation = MakeOperation(
+      IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+      IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE,
+      IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32, &value, &value, 1,
+      &completion);
+  EXPECT_THAT(iree::Status(iree_hal_mpi_channel_submit(channel, &operation)),
+              StatusIs(StatusCode::kUnimplemented));
+}
+
+}  // namespace
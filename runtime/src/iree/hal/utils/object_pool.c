@@ -0,0 +1,210 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/object_pool.h"
+
+#include <string.h>
+
+#include "iree/base/internal/arena.h"
+#include "iree/base/internal/atomics.h"
+
+// Prefix of every allocation made from the pool used to route frees.
+// Padded so that the user pointer keeps the natural alignment.
+typedef union iree_hal_object_pool_header_t {
+  // Block the allocation was carved from or NULL if it was forwarded to the
+  // host allocator.
+  iree_arena_block_t* block;
+  uint8_t padding[iree_max_align_t];
+} iree_hal_object_pool_header_t;
+
+struct iree_hal_object_pool_t {
+  // One reference for the creator and one for each outstanding allocation.
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_arena_block_pool_t block_pool;
+  iree_atomic_int64_t pooled_count;
+  iree_atomic_int64_t fallback_count;
+};
+
+static void iree_hal_object_pool_destroy(iree_hal_object_pool_t* pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = pool->host_allocator;
+  iree_arena_block_pool_deinitialize(&pool->block_pool);
+  iree_allocator_free(host_allocator, pool);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_hal_object_pool_create(
+    iree_host_size_t block_size, iree_allocator_t host_allocator,
+    iree_hal_object_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  if (IREE_UNLIKELY(block_size < sizeof(iree_hal_object_pool_header_t) +
+                                     sizeof(iree_arena_block_t) +
+                                     iree_max_align_t)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "object pool block size %" PRIhsz " too small",
+                            block_size);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)block_size);
+
+  iree_hal_object_pool_t* pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*pool), (void**)&pool));
+  iree_atomic_ref_count_init(&pool->ref_count);
+  pool->host_allocator = host_allocator;
+  // Slabs keep recently used objects close together and amortize the host
+  // allocations; they are only returned when the pool is destroyed.
+  iree_arena_block_pool_initialize_slabbed(
+      iree_host_align(block_size, iree_max_align_t),
+      iree_host_align(block_size, iree_max_align_t) *
+          IREE_HAL_OBJECT_POOL_BLOCKS_PER_SLAB,
+      IREE_ALLOCATOR_NODE_ID_ANY, host_allocator, &pool->block_pool);
+
+  *out_pool = pool;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Drops a reference to |pool| and destroys it if it was the last.
+static void iree_hal_object_pool_release_ref(iree_hal_object_pool_t* pool) {
+  if (iree_atomic_ref_count_dec(&pool->ref_count) == 1) {
+    iree_hal_object_pool_destroy(pool);
+  }
+}
+
+void iree_hal_object_pool_release(iree_hal_object_pool_t* pool) {
+  if (pool) iree_hal_object_pool_release_ref(pool);
+}
+
+iree_host_size_t iree_hal_object_pool_max_pooled_size(
+    const iree_hal_object_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  return pool->block_pool.usable_block_size -
+         sizeof(iree_hal_object_pool_header_t);
+}
+
+void iree_hal_object_pool_query_statistics(
+    iree_hal_object_pool_t* pool,
+    iree_hal_object_pool_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  // Excludes the creator reference if it is still held; after release the
+  // allocator may no longer be used so querying is only valid before then.
+  out_statistics->live_count =
+      (iree_host_size_t)(iree_atomic_ref_count_load(&pool->ref_count) - 1);
+  out_statistics->pooled_count = (uint64_t)iree_atomic_load_int64(
+      &pool->pooled_count, iree_memory_order_relaxed);
+  out_statistics->fallback_count = (uint64_t)iree_atomic_load_int64(
+      &pool->fallback_count, iree_memory_order_relaxed);
+}
+
+// Allocates |byte_length| bytes and returns the user pointer in |out_ptr|.
+// Contents are undefined unless |zero| is set.
+static iree_status_t iree_hal_object_pool_allocate(
+    iree_hal_object_pool_t* pool, iree_host_size_t byte_length, bool zero,
+    void** out_ptr) {
+  iree_hal_object_pool_header_t* header = NULL;
+  if (byte_length <= iree_hal_object_pool_max_pooled_size(pool)) {
+    iree_arena_block_t* block = NULL;
+    IREE_RETURN_IF_ERROR(iree_arena_block_pool_acquire(
+        &pool->block_pool, &block, (void**)&header));
+    header->block = block;
+    iree_atomic_fetch_add_int64(&pool->pooled_count, 1,
+                                iree_memory_order_relaxed);
+  } else {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc_uninitialized(
+        pool->host_allocator, sizeof(*header) + byte_length,
+        (void**)&header));
+    header->block = NULL;
+    iree_atomic_fetch_add_int64(&pool->fallback_count, 1,
+                                iree_memory_order_relaxed);
+  }
+  iree_atomic_ref_count_inc(&pool->ref_count);
+  void* ptr = (uint8_t*)header + sizeof(*header);
+  if (zero) memset(ptr, 0, byte_length);
+  *out_ptr = ptr;
+  return iree_ok_status();
+}
+
+static void iree_hal_object_pool_free(iree_hal_object_pool_t* pool,
+                                      void* ptr) {
+  iree_hal_object_pool_header_t* header =
+      (iree_hal_object_pool_header_t*)((uint8_t*)ptr - sizeof(*header));
+  if (header->block) {
+    iree_arena_block_pool_release(&pool->block_pool, header->block,
+                                  header->block);
+  } else {
+    iree_allocator_free(pool->host_allocator, header);
+  }
+  // May destroy the pool if the creator has already released it.
+  iree_hal_object_pool_release_ref(pool);
+}
+
+static iree_status_t iree_hal_object_pool_reallocate(
+    iree_hal_object_pool_t* pool, iree_host_size_t byte_length,
+    void** inout_ptr) {
+  iree_hal_object_pool_header_t* header =
+      (iree_hal_object_pool_header_t*)((uint8_t*)*inout_ptr - sizeof(*header));
+  const iree_host_size_t max_pooled_size =
+      iree_hal_object_pool_max_pooled_size(pool);
+  if (header->block) {
+    // Blocks have a fixed capacity so shrinking is free. Growing beyond it
+    // moves the allocation to the host allocator.
+    if (byte_length <= max_pooled_size) return iree_ok_status();
+    void* new_ptr = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_object_pool_allocate(
+        pool, byte_length, /*zero=*/false, &new_ptr));
+    memcpy(new_ptr, *inout_ptr, max_pooled_size);
+    iree_hal_object_pool_free(pool, *inout_ptr);
+    *inout_ptr = new_ptr;
+    return iree_ok_status();
+  }
+  // Forwarded allocations stay with the host allocator.
+  IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+      pool->host_allocator, sizeof(*header) + byte_length, (void**)&header));
+  *inout_ptr = (uint8_t*)header + sizeof(*header);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_object_pool_allocator_ctl(
+    void* self, iree_allocator_command_t command, const void* params,
+    void** inout_ptr) {
+  iree_hal_object_pool_t* pool = (iree_hal_object_pool_t*)self;
+  switch (command) {
+    case IREE_ALLOCATOR_COMMAND_MALLOC:
+    case IREE_ALLOCATOR_COMMAND_CALLOC:
+    case IREE_ALLOCATOR_COMMAND_REALLOC: {
+      const iree_allocator_alloc_params_t* alloc_params =
+          (const iree_allocator_alloc_params_t*)params;
+      if (command == IREE_ALLOCATOR_COMMAND_REALLOC && *inout_ptr) {
+        return iree_hal_object_pool_reallocate(
+            pool, alloc_params->byte_length, inout_ptr);
+      }
+      return iree_hal_object_pool_allocate(
+          pool, alloc_params->byte_length,
+          /*zero=*/command == IREE_ALLOCATOR_COMMAND_CALLOC, inout_ptr);
+    }
+    case IREE_ALLOCATOR_COMMAND_FREE: {
+      if (*inout_ptr) iree_hal_object_pool_free(pool, *inout_ptr);
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported object pool command");
+  }
+}
+
+iree_allocator_t iree_hal_object_pool_allocator(iree_hal_object_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  iree_allocator_t allocator = {
+      .self = pool,
+      .ctl = iree_hal_object_pool_allocator_ctl,
+  };
+  return allocator;
+}
@@ -0,0 +1,83 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_OBJECT_POOL_H_
+#define IREE_HAL_UTILS_OBJECT_POOL_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Default total size, in bytes, of each pooled block. Sized to hold a subspan
+// iree_hal_buffer_t or an iree_hal_buffer_view_t with up to rank 4 inline.
+#if !defined(IREE_HAL_OBJECT_POOL_DEFAULT_BLOCK_SIZE)
+#define IREE_HAL_OBJECT_POOL_DEFAULT_BLOCK_SIZE 128
+#endif  // !IREE_HAL_OBJECT_POOL_DEFAULT_BLOCK_SIZE
+
+// Number of blocks allocated together when the pool runs out.
+#if !defined(IREE_HAL_OBJECT_POOL_BLOCKS_PER_SLAB)
+#define IREE_HAL_OBJECT_POOL_BLOCKS_PER_SLAB 64
+#endif  // !IREE_HAL_OBJECT_POOL_BLOCKS_PER_SLAB
+
+// Statistics reported by iree_hal_object_pool_query_statistics.
+typedef struct iree_hal_object_pool_statistics_t {
+  // Total number of allocations currently outstanding.
+  iree_host_size_t live_count;
+  // Total number of allocations served from pooled blocks.
+  uint64_t pooled_count;
+  // Total number of allocations too large for a block that were forwarded to
+  // the host allocator.
+  uint64_t fallback_count;
+} iree_hal_object_pool_statistics_t;
+
+// A pool of small fixed-size host allocations exposed as an iree_allocator_t.
+// Intended to be passed as the host allocator of short-lived HAL objects like
+// buffer views and subspan buffers that are created and destroyed many times
+// per invocation so that they are recycled instead of round-tripping through
+// the host allocator. Allocations up to the block size come from a thread-safe
+// block pool and larger ones are forwarded to the host allocator.
+//
+// Objects store the allocator they were created with and free themselves
+// through it, possibly after the creator has dropped its pool reference. The
+// pool is kept alive until the last of its allocations has been freed.
+//
+// Thread-safe; the host allocator must also be thread-safe.
+typedef struct iree_hal_object_pool_t iree_hal_object_pool_t;
+
+// Creates a pool of |block_size| byte blocks (including pool overhead)
+// allocated from |host_allocator|. Prefer a power of two such as
+// IREE_HAL_OBJECT_POOL_DEFAULT_BLOCK_SIZE.
+iree_status_t iree_hal_object_pool_create(
+    iree_host_size_t block_size, iree_allocator_t host_allocator,
+    iree_hal_object_pool_t** out_pool);
+
+// Releases the creator reference to |pool|. Allocations still outstanding
+// remain valid and the pool is freed once they have all been freed.
+void iree_hal_object_pool_release(iree_hal_object_pool_t* pool);
+
+// Returns an allocator that allocates from |pool|. The allocator is valid
+// until iree_hal_object_pool_release and allocations from it keep the pool
+// alive.
+iree_allocator_t iree_hal_object_pool_allocator(iree_hal_object_pool_t* pool);
+
+// Returns the largest allocation that is served from a pooled block.
+iree_host_size_t iree_hal_object_pool_max_pooled_size(
+    const iree_hal_object_pool_t* pool);
+
+// Queries the statistics of |pool|. Counters may lag concurrent operations.
+void iree_hal_object_pool_query_statistics(
+    iree_hal_object_pool_t* pool,
+    iree_hal_object_pool_statistics_t* out_statistics);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_OBJECT_POOL_H_
@@ -0,0 +1,166 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/object_pool.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+class ObjectPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_object_pool_create(
+        IREE_HAL_OBJECT_POOL_DEFAULT_BLOCK_SIZE, iree_allocator_system(),
+        &pool_));
+    allocator_ = iree_hal_object_pool_allocator(pool_);
+  }
+
+  void TearDown() override { iree_hal_object_pool_release(pool_); }
+
+  iree_hal_object_pool_statistics_t QueryStatistics() {
+    iree_hal_object_pool_statistics_t statistics;
+    iree_hal_object_pool_query_statistics(pool_, &statistics);
+    return statistics;
+  }
+
+  iree_hal_object_pool_t* pool_ = NULL;
+  iree_allocator_t allocator_;
+};
+
+TEST(ObjectPoolCreateTest, BlockSizeTooSmall) {
+  iree_hal_object_pool_t* pool = NULL;
+  EXPECT_THAT(Status(iree_hal_object_pool_create(8, iree_allocator_system(),
+                                                 &pool)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(pool, nullptr);
+}
+
+TEST_F(ObjectPoolTest, ReusesBlocks) {
+  const iree_host_size_t max_size = iree_hal_object_pool_max_pooled_size(pool_);
+  EXPECT_GE(max_size, 64);
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator_, max_size, &ptr));
+  EXPECT_EQ((uintptr_t)ptr % iree_max_align_t, 0);
+  std::memset(ptr, 0xCD, max_size);
+  EXPECT_EQ(QueryStatistics().live_count, 1);
+  iree_allocator_free(allocator_, ptr);
+  EXPECT_EQ(QueryStatistics().live_count, 0);
+
+  // The most recently released block is handed out again and zeroed.
+  void* reused_ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator_, max_size, &reused_ptr));
+  EXPECT_EQ(reused_ptr, ptr);
+  for (iree_host_size_t i = 0; i < max_size; ++i) {
+    ASSERT_EQ(((uint8_t*)reused_ptr)[i], 0);
+  }
+  iree_allocator_free(allocator_, reused_ptr);
+
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.pooled_count, 2);
+  EXPECT_EQ(statistics.fallback_count, 0);
+}
+
+TEST_F(ObjectPoolTest, LargeAllocationsFallBack) {
+  const iree_host_size_t size = iree_hal_object_pool_max_pooled_size(pool_) + 1;
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator_, size, &ptr));
+  std::memset(ptr, 0xCD, size);
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.live_count, 1);
+  EXPECT_EQ(statistics.pooled_count, 0);
+  EXPECT_EQ(statistics.fallback_count, 1);
+  iree_allocator_free(allocator_, ptr);
+  EXPECT_EQ(QueryStatistics().live_count, 0);
+}
+
+TEST_F(ObjectPoolTest, ReallocGrowsOutOfBlock) {
+  const iree_host_size_t max_size = iree_hal_object_pool_max_pooled_size(pool_);
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator_, 16, (void**)&ptr));
+  for (int i = 0; i < 16; ++i) ptr[i] = (uint8_t)i;
+
+  // Staying within the block keeps the allocation in place.
+  uint8_t* same_ptr = ptr;
+  IREE_ASSERT_OK(
+      iree_allocator_realloc(allocator_, max_size, (void**)&same_ptr));
+  EXPECT_EQ(same_ptr, ptr);
+
+  // Growing past the block moves it to the host allocator.
+  IREE_ASSERT_OK(
+      iree_allocator_realloc(allocator_, max_size * 4, (void**)&ptr));
+  for (int i = 0; i < 16; ++i) EXPECT_EQ(ptr[i], (uint8_t)i);
+  IREE_ASSERT_OK(
+      iree_allocator_realloc(allocator_, max_size * 8, (void**)&ptr));
+  for (int i = 0; i < 16; ++i) EXPECT_EQ(ptr[i], (uint8_t)i);
+  EXPECT_EQ(QueryStatistics().live_count, 1);
+  iree_allocator_free(allocator_, ptr);
+  EXPECT_EQ(QueryStatistics().live_count, 0);
+}
+
+TEST_F(ObjectPoolTest, AllocationsOutlivePool) {
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator_, 32, &ptr));
+  iree_hal_object_pool_release(pool_);
+  pool_ = NULL;
+  // The allocation keeps the pool alive; freeing it destroys the pool.
+  std::memset(ptr, 0xCD, 32);
+  iree_allocator_free(allocator_, ptr);
+}
+
+TEST_F(ObjectPoolTest, PoolsBufferViewsAndSubspans) {
+  iree_hal_allocator_t* device_allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+      iree_make_cstring_view("heap"), iree_allocator_system(),
+      iree_allocator_system(), &device_allocator));
+  iree_hal_buffer_params_t params = {0};
+  params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(device_allocator, params,
+                                                    1024, &buffer));
+
+  iree_hal_buffer_t* subspan_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_subspan_with_allocator(
+      buffer, 128, 512, allocator_, &subspan_buffer));
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(subspan_buffer), buffer);
+  EXPECT_EQ(iree_hal_buffer_byte_offset(subspan_buffer), 128);
+  EXPECT_EQ(iree_hal_buffer_byte_length(subspan_buffer), 512);
+
+  // Rank 4 shapes are the largest guaranteed to fit within a default block.
+  const iree_hal_dim_t shape[4] = {2, 4, 4, 4};
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_create(
+      subspan_buffer, IREE_ARRAYSIZE(shape), shape,
+      IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      allocator_, &buffer_view));
+  iree_hal_buffer_release(subspan_buffer);
+
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.live_count, 2);
+  EXPECT_EQ(statistics.pooled_count, 2);
+  EXPECT_EQ(statistics.fallback_count, 0);
+
+  iree_hal_buffer_view_release(buffer_view);
+  EXPECT_EQ(QueryStatistics().live_count, 0);
+
+  iree_hal_buffer_release(buffer);
+  iree_hal_allocator_release(device_allocator);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
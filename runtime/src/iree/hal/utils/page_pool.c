@@ -0,0 +1,212 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/page_pool.h"
+
+#include "iree/base/internal/synchronization.h"
+
+void iree_hal_page_pool_params_initialize(
+    iree_hal_page_pool_params_t* out_params) {
+  IREE_ASSERT_ARGUMENT(out_params);
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->buffer_params.type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_DEVICE;
+  out_params->buffer_params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+}
+
+struct iree_hal_page_pool_t {
+  iree_allocator_t host_allocator;
+
+  // Storage for all pages in index order.
+  iree_hal_buffer_t* buffer;
+  iree_device_size_t page_size;
+  uint32_t page_capacity;
+
+  // Guards the free list, reference counts, and accounting.
+  iree_slim_mutex_t mutex;
+
+  // Number of pages in |free_pages|.
+  uint32_t free_count;
+  // Stack of unused page indices with the next page to acquire at the top.
+  // Lower indices are acquired first so that a lightly used pool touches a
+  // compact prefix of the buffer.
+  uint32_t* free_pages;
+  // Reference count of each page. Pages with a count of 0 are in |free_pages|.
+  uint32_t* ref_counts;
+
+  iree_hal_page_pool_statistics_t statistics;
+};
+
+iree_status_t iree_hal_page_pool_create(iree_hal_page_pool_params_t params,
+                                        iree_hal_allocator_t* device_allocator,
+                                        iree_allocator_t host_allocator,
+                                        iree_hal_page_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  if (params.page_size == 0 || params.page_capacity == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "page pools require a non-zero page size and "
+                            "capacity");
+  }
+  if (params.page_size > IREE_DEVICE_SIZE_MAX / params.page_capacity) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "page pool of %u pages of %" PRIdsz
+                            " bytes overflows the device size",
+                            params.page_capacity, params.page_size);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, params.page_size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, params.page_capacity);
+
+  iree_hal_page_pool_t* pool = NULL;
+  const iree_host_size_t total_size =
+      sizeof(*pool) + 2 * params.page_capacity * sizeof(uint32_t);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&pool));
+  memset(pool, 0, sizeof(*pool));
+  pool->host_allocator = host_allocator;
+  pool->page_size = params.page_size;
+  pool->page_capacity = params.page_capacity;
+  iree_slim_mutex_initialize(&pool->mutex);
+  pool->free_pages = (uint32_t*)((uint8_t*)pool + sizeof(*pool));
+  pool->ref_counts = pool->free_pages + params.page_capacity;
+  pool->free_count = params.page_capacity;
+  for (uint32_t i = 0; i < params.page_capacity; ++i) {
+    pool->free_pages[i] = params.page_capacity - 1 - i;
+    pool->ref_counts[i] = 0;
+  }
+
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      device_allocator, params.buffer_params,
+      params.page_size * params.page_capacity, &pool->buffer);
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    iree_hal_page_pool_free(pool);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_page_pool_free(iree_hal_page_pool_t* pool) {
+  if (!pool) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_buffer_release(pool->buffer);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(pool->host_allocator, pool);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_hal_buffer_t* iree_hal_page_pool_buffer(const iree_hal_page_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  return pool->buffer;
+}
+
+iree_device_size_t iree_hal_page_pool_page_size(
+    const iree_hal_page_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  return pool->page_size;
+}
+
+uint32_t iree_hal_page_pool_page_capacity(const iree_hal_page_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  return pool->page_capacity;
+}
+
+uint32_t iree_hal_page_pool_available_page_count(iree_hal_page_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  iree_slim_mutex_lock(&pool->mutex);
+  uint32_t free_count = pool->free_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+  return free_count;
+}
+
+iree_status_t iree_hal_page_pool_acquire(iree_hal_page_pool_t* pool,
+                                         iree_host_size_t page_count,
+                                         uint32_t* out_pages) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(!page_count || out_pages);
+  if (page_count == 0) return iree_ok_status();
+  iree_slim_mutex_lock(&pool->mutex);
+
+  if (page_count > pool->free_count) {
+    uint32_t free_count = pool->free_count;
+    iree_slim_mutex_unlock(&pool->mutex);
+    return iree_make_status(
+        IREE_STATUS_RESOURCE_EXHAUSTED,
+        "page pool has %u of %u pages available but %" PRIhsz " were requested",
+        free_count, pool->page_capacity, page_count);
+  }
+
+  for (iree_host_size_t i = 0; i < page_count; ++i) {
+    uint32_t page = pool->free_pages[--pool->free_count];
+    pool->ref_counts[page] = 1;
+    out_pages[i] = page;
+  }
+  iree_hal_page_pool_statistics_t* statistics = &pool->statistics;
+  statistics->live_page_count += (uint32_t)page_count;
+  statistics->peak_live_page_count = iree_max(
+      statistics->peak_live_page_count, statistics->live_page_count);
+  statistics->acquire_count += page_count;
+
+  iree_slim_mutex_unlock(&pool->mutex);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_page_pool_retain(iree_hal_page_pool_t* pool,
+                                        iree_host_size_t page_count,
+                                        const uint32_t* pages) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(!page_count || pages);
+  iree_slim_mutex_lock(&pool->mutex);
+
+  // Validate all pages first so that no references are added on failure.
+  for (iree_host_size_t i = 0; i < page_count; ++i) {
+    if (pages[i] >= pool->page_capacity || !pool->ref_counts[pages[i]]) {
+      uint32_t page = pages[i];
+      iree_slim_mutex_unlock(&pool->mutex);
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "page %u is not live in the pool of %u pages",
+                              page, pool->page_capacity);
+    }
+  }
+  for (iree_host_size_t i = 0; i < page_count; ++i) {
+    ++pool->ref_counts[pages[i]];
+  }
+
+  iree_slim_mutex_unlock(&pool->mutex);
+  return iree_ok_status();
+}
+
+void iree_hal_page_pool_release(iree_hal_page_pool_t* pool,
+                                iree_host_size_t page_count,
+                                const uint32_t* pages) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(!page_count || pages);
+  iree_slim_mutex_lock(&pool->mutex);
+  for (iree_host_size_t i = 0; i < page_count; ++i) {
+    uint32_t page = pages[i];
+    IREE_ASSERT(page < pool->page_capacity && pool->ref_counts[page] > 0,
+                "releasing a page that is not live");
+    if (page >= pool->page_capacity || !pool->ref_counts[page]) continue;
+    if (--pool->ref_counts[page] == 0) {
+      pool->free_pages[pool->free_count++] = page;
+      --pool->statistics.live_page_count;
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+void iree_hal_page_pool_query_statistics(
+    iree_hal_page_pool_t* pool,
+    iree_hal_page_pool_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  iree_slim_mutex_lock(&pool->mutex);
+  *out_statistics = pool->statistics;
+  iree_slim_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,116 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_PAGE_POOL_H_
+#define IREE_HAL_UTILS_PAGE_POOL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// A pool of fixed-size pages carved out of a single device buffer.
+//
+// Paged tensors such as the key/value caches used by paged attention
+// (`iree_linalg_ext.paged_attention`) store each sequence as a list of pages
+// that may live anywhere in the pool. Programs receive the pool buffer as a
+// NumPages x PageSize x ... tensor along with a block table of page indices
+// per sequence. Sequences grow a page at a time as they are extended instead of
+// being allocated for their maximum length up front, so concurrent sessions of
+// varying length only waste memory in their last partially filled page.
+//
+// Pages are reference counted so that they can be shared between sequences
+// (such as a common prompt prefix). The pool only tracks page ownership: the
+// contents of pages are managed by the programs reading and writing them and
+// callers must order page reuse against any in-flight work using the pages.
+//
+// Thread-safe: pages may be acquired and released from multiple threads.
+typedef struct iree_hal_page_pool_t iree_hal_page_pool_t;
+
+// Parameters used to configure an iree_hal_page_pool_t.
+typedef struct iree_hal_page_pool_params_t {
+  // Size in bytes of each page. Must be a multiple of the minimum buffer
+  // offset alignment of the device so that pages can be bound individually.
+  iree_device_size_t page_size;
+  // Total number of pages in the pool.
+  uint32_t page_capacity;
+  // Parameters of the backing buffer. Defaults to device-local storage usable
+  // by dispatches and transfers.
+  iree_hal_buffer_params_t buffer_params;
+} iree_hal_page_pool_params_t;
+
+// Initializes |out_params| to the default values.
+void iree_hal_page_pool_params_initialize(
+    iree_hal_page_pool_params_t* out_params);
+
+// Accounting for an iree_hal_page_pool_t since creation.
+typedef struct iree_hal_page_pool_statistics_t {
+  // Number of pages referenced by at least one user.
+  uint32_t live_page_count;
+  // High-water mark of |live_page_count|. This is the capacity needed to
+  // service the observed workload.
+  uint32_t peak_live_page_count;
+  // Total number of pages handed out by iree_hal_page_pool_acquire.
+  uint64_t acquire_count;
+} iree_hal_page_pool_statistics_t;
+
+// Creates a page pool with storage allocated from |device_allocator|.
+// All pages are allocated up front in a single buffer so that they can be
+// indexed from a block table.
+iree_status_t iree_hal_page_pool_create(iree_hal_page_pool_params_t params,
+                                        iree_hal_allocator_t* device_allocator,
+                                        iree_allocator_t host_allocator,
+                                        iree_hal_page_pool_t** out_pool);
+
+// Frees |pool|. The backing buffer remains valid while referenced elsewhere.
+void iree_hal_page_pool_free(iree_hal_page_pool_t* pool);
+
+// Returns the buffer containing all pages in index order. Page |i| occupies
+// bytes [i * page_size, (i + 1) * page_size). The buffer remains owned by
+// |pool| and callers must retain it to extend its lifetime.
+iree_hal_buffer_t* iree_hal_page_pool_buffer(const iree_hal_page_pool_t* pool);
+
+// Returns the size in bytes of each page in |pool|.
+iree_device_size_t iree_hal_page_pool_page_size(
+    const iree_hal_page_pool_t* pool);
+
+// Returns the total number of pages in |pool|.
+uint32_t iree_hal_page_pool_page_capacity(const iree_hal_page_pool_t* pool);
+
+// Returns the number of pages currently available for acquisition.
+uint32_t iree_hal_page_pool_available_page_count(iree_hal_page_pool_t* pool);
+
+// Acquires |page_count| unused pages and stores their indices in |out_pages|.
+// Each page starts with a reference count of 1. Either all pages are acquired
+// or none are and IREE_STATUS_RESOURCE_EXHAUSTED is returned so that callers
+// can preempt or defer sequences when the pool is full.
+iree_status_t iree_hal_page_pool_acquire(iree_hal_page_pool_t* pool,
+                                         iree_host_size_t page_count,
+                                         uint32_t* out_pages);
+
+// Adds a reference to each of the |page_count| live pages in |pages|.
+iree_status_t iree_hal_page_pool_retain(iree_hal_page_pool_t* pool,
+                                        iree_host_size_t page_count,
+                                        const uint32_t* pages);
+
+// Removes a reference from each of the |page_count| live pages in |pages|.
+// Pages are returned to the pool once they are no longer referenced.
+void iree_hal_page_pool_release(iree_hal_page_pool_t* pool,
+                                iree_host_size_t page_count,
+                                const uint32_t* pages);
+
+// Queries the current |pool| accounting.
+void iree_hal_page_pool_query_statistics(
+    iree_hal_page_pool_t* pool,
+    iree_hal_page_pool_statistics_t* out_statistics);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_PAGE_POOL_H_
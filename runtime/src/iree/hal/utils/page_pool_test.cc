@@ -0,0 +1,159 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/page_pool.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+using ::testing::ElementsAre;
+
+class PagePoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+  }
+
+  void TearDown() override {
+    iree_hal_page_pool_free(pool_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  void CreatePool(uint32_t page_capacity) {
+    iree_hal_page_pool_params_t params;
+    iree_hal_page_pool_params_initialize(&params);
+    params.page_size = kPageSize;
+    params.page_capacity = page_capacity;
+    IREE_ASSERT_OK(iree_hal_page_pool_create(
+        params, device_allocator_, iree_allocator_system(), &pool_));
+  }
+
+  std::vector<uint32_t> Acquire(iree_host_size_t page_count) {
+    std::vector<uint32_t> pages(page_count);
+    IREE_CHECK_OK(iree_hal_page_pool_acquire(pool_, pages.size(),
+                                             pages.data()));
+    return pages;
+  }
+
+  void Release(const std::vector<uint32_t>& pages) {
+    iree_hal_page_pool_release(pool_, pages.size(), pages.data());
+  }
+
+  static constexpr iree_device_size_t kPageSize = 4096;
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_page_pool_t* pool_ = NULL;
+};
+
+TEST_F(PagePoolTest, InvalidParams) {
+  iree_hal_page_pool_params_t params;
+  iree_hal_page_pool_params_initialize(&params);
+  EXPECT_THAT(Status(iree_hal_page_pool_create(params, device_allocator_,
+                                               iree_allocator_system(),
+                                               &pool_)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(pool_, nullptr);
+}
+
+TEST_F(PagePoolTest, Lifetime) {
+  CreatePool(/*page_capacity=*/16);
+  EXPECT_EQ(iree_hal_page_pool_page_size(pool_), kPageSize);
+  EXPECT_EQ(iree_hal_page_pool_page_capacity(pool_), 16);
+  EXPECT_EQ(iree_hal_page_pool_available_page_count(pool_), 16);
+  iree_hal_buffer_t* buffer = iree_hal_page_pool_buffer(pool_);
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer), 16 * kPageSize);
+}
+
+TEST_F(PagePoolTest, AcquireInOrder) {
+  CreatePool(/*page_capacity=*/8);
+  EXPECT_THAT(Acquire(3), ElementsAre(0, 1, 2));
+  EXPECT_THAT(Acquire(2), ElementsAre(3, 4));
+  EXPECT_EQ(iree_hal_page_pool_available_page_count(pool_), 3);
+}
+
+TEST_F(PagePoolTest, ReleasedPagesAreReused) {
+  CreatePool(/*page_capacity=*/4);
+  std::vector<uint32_t> sequence_a = Acquire(2);
+  std::vector<uint32_t> sequence_b = Acquire(2);
+  Release(sequence_a);
+  EXPECT_EQ(iree_hal_page_pool_available_page_count(pool_), 2);
+  std::vector<uint32_t> sequence_c = Acquire(2);
+  EXPECT_THAT(sequence_c, ::testing::UnorderedElementsAre(0, 1));
+  Release(sequence_b);
+  Release(sequence_c);
+  EXPECT_EQ(iree_hal_page_pool_available_page_count(pool_), 4);
+}
+
+TEST_F(PagePoolTest, ExhaustionAcquiresNothing) {
+  CreatePool(/*page_capacity=*/4);
+  std::vector<uint32_t> live = Acquire(3);
+  std::vector<uint32_t> pages(2);
+  EXPECT_THAT(Status(iree_hal_page_pool_acquire(pool_, pages.size(),
+                                                pages.data())),
+              StatusIs(StatusCode::kResourceExhausted));
+  EXPECT_EQ(iree_hal_page_pool_available_page_count(pool_), 1);
+  Release(live);
+  EXPECT_EQ(Acquire(4).size(), 4);
+}
+
+TEST_F(PagePoolTest, SharedPagesAreRefCounted) {
+  CreatePool(/*page_capacity=*/4);
+  // Two sequences sharing a prefix page.
+  std::vector<uint32_t> prefix = Acquire(1);
+  IREE_ASSERT_OK(
+      iree_hal_page_pool_retain(pool_, prefix.size(), prefix.data()));
+  Release(prefix);
+  EXPECT_EQ(iree_hal_page_pool_available_page_count(pool_), 3);
+  Release(prefix);
+  EXPECT_EQ(iree_hal_page_pool_available_page_count(pool_), 4);
+}
+
+TEST_F(PagePoolTest, RetainRequiresLivePages) {
+  CreatePool(/*page_capacity=*/4);
+  std::vector<uint32_t> live = Acquire(1);
+  uint32_t pages[2] = {live[0], 3};
+  EXPECT_THAT(Status(iree_hal_page_pool_retain(pool_, 2, pages)),
+              StatusIs(StatusCode::kFailedPrecondition));
+  // The live page must not have been retained by the failed call.
+  Release(live);
+  EXPECT_EQ(iree_hal_page_pool_available_page_count(pool_), 4);
+  uint32_t out_of_range = 4;
+  EXPECT_THAT(Status(iree_hal_page_pool_retain(pool_, 1, &out_of_range)),
+              StatusIs(StatusCode::kFailedPrecondition));
+}
+
+TEST_F(PagePoolTest, Statistics) {
+  CreatePool(/*page_capacity=*/8);
+  std::vector<uint32_t> sequence_a = Acquire(3);
+  std::vector<uint32_t> sequence_b = Acquire(2);
+  Release(sequence_a);
+  std::vector<uint32_t> sequence_c = Acquire(1);
+  iree_hal_page_pool_statistics_t statistics;
+  iree_hal_page_pool_query_statistics(pool_, &statistics);
+  EXPECT_EQ(statistics.live_page_count, 3);
+  EXPECT_EQ(statistics.peak_live_page_count, 5);
+  EXPECT_EQ(statistics.acquire_count, 6);
+  Release(sequence_b);
+  Release(sequence_c);
+  iree_hal_page_pool_query_statistics(pool_, &statistics);
+  EXPECT_EQ(statistics.live_page_count, 0);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
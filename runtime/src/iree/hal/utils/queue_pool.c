@@ -0,0 +1,516 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/queue_pool.h"
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/metrics.h"
+
+// Default maximum total size of deallocated memory retained for reuse.
+#define IREE_HAL_QUEUE_POOL_DEFAULT_MAX_FREE_CAPACITY (256 * 1024 * 1024)
+
+// Maximum number of semaphores a deallocation can be ordered on while still
+// retaining the memory for reuse. Deallocations with more are rare enough that
+// we just release the memory back to the device allocator.
+#define IREE_HAL_QUEUE_POOL_MAX_FENCE_COUNT 4
+
+// Pooled memory is only reused for allocations at least this fraction of its
+// size to bound the amount of memory wasted by larger allocations servicing
+// smaller requests.
+#define IREE_HAL_QUEUE_POOL_MAX_WASTE_FACTOR 2
+
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_hal_queue_pool_hits, "iree_hal_queue_pool_hits_total",
+    "Total number of queue-ordered allocations that reused pooled memory.");
+static IREE_METRIC_COUNTER_DEFINE(
+    iree_hal_queue_pool_misses, "iree_hal_queue_pool_misses_total",
+    "Total number of queue-ordered allocations that allocated new memory.");
+
+void iree_hal_queue_pool_params_initialize(
+    iree_hal_queue_pool_params_t* out_params) {
+  IREE_ASSERT_ARGUMENT(out_params);
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->max_free_capacity = IREE_HAL_QUEUE_POOL_DEFAULT_MAX_FREE_CAPACITY;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_queue_pool_slot_t
+//===----------------------------------------------------------------------===//
+
+// A pooled allocation that is either live (handed out to a user) or free
+// (available for reuse once its fence has been reached).
+typedef struct iree_hal_queue_pool_slot_t {
+  struct iree_hal_queue_pool_slot_t* next;
+  // Allocation from the device allocator retained by the pool.
+  iree_hal_buffer_t* buffer;
+  // True while a buffer referencing the allocation has been handed out and not
+  // yet deallocated.
+  bool is_live;
+  // Semaphore payloads that must be reached before a free slot is no longer
+  // in use. Semaphores are retained.
+  iree_host_size_t fence_count;
+  iree_hal_semaphore_t* fence_semaphores[IREE_HAL_QUEUE_POOL_MAX_FENCE_COUNT];
+  uint64_t fence_values[IREE_HAL_QUEUE_POOL_MAX_FENCE_COUNT];
+} iree_hal_queue_pool_slot_t;
+
+// Releases the semaphores retained in the |slot| fence.
+static void iree_hal_queue_pool_slot_clear_fence(
+    iree_hal_queue_pool_slot_t* slot) {
+  for (iree_host_size_t i = 0; i < slot->fence_count; ++i) {
+    iree_hal_semaphore_release(slot->fence_semaphores[i]);
+  }
+  slot->fence_count = 0;
+}
+
+// Returns true if the memory of the free |slot| will no longer be in use once
+// all of |wait_semaphore_list| has been reached. That's either because the
+// fence has already been reached or because waiting on the list implies
+// waiting on the fence.
+static bool iree_hal_queue_pool_slot_is_reusable(
+    iree_hal_queue_pool_slot_t* slot,
+    const iree_hal_semaphore_list_t wait_semaphore_list) {
+  bool is_reached = true;
+  for (iree_host_size_t i = 0; i < slot->fence_count; ++i) {
+    bool is_dominated = false;
+    for (iree_host_size_t j = 0; j < wait_semaphore_list.count; ++j) {
+      if (wait_semaphore_list.semaphores[j] == slot->fence_semaphores[i] &&
+          wait_semaphore_list.payload_values[j] >= slot->fence_values[i]) {
+        is_dominated = true;
+        break;
+      }
+    }
+    uint64_t current_value = 0;
+    iree_status_t status =
+        iree_hal_semaphore_query(slot->fence_semaphores[i], &current_value);
+    if (!iree_status_is_ok(status)) {
+      // Failed semaphores may never be reached; keep the memory out of use
+      // until the pool is trimmed.
+      iree_status_ignore(status);
+      return false;
+    } else if (current_value < slot->fence_values[i]) {
+      if (!is_dominated) return false;
+      is_reached = false;
+    }
+  }
+  // Drop the fence once reached to avoid querying it again.
+  if (is_reached) iree_hal_queue_pool_slot_clear_fence(slot);
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_queue_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_queue_pool_t {
+  iree_allocator_t host_allocator;
+  iree_hal_queue_pool_params_t params;
+
+  // Device allocator used to allocate storage and free it when trimmed.
+  iree_hal_allocator_t* device_allocator;
+
+  // Guards the slot list and accounting. The mutex is not held during device
+  // allocations as those can be slow.
+  iree_slim_mutex_t mutex;
+
+  // All pooled allocations, both live and free.
+  iree_hal_queue_pool_slot_t* slot_head;
+
+  // Total size in bytes of all free slots.
+  iree_device_size_t free_size;
+
+  // Accounting reported by iree_hal_queue_pool_query_statistics. The free
+  // size above is subtracted from the reserved size to get the live size.
+  iree_hal_queue_pool_statistics_t statistics;
+};
+
+// Updates the high-water marks after the reserved or live size has grown.
+//
+// Must be called with the pool mutex held.
+static void iree_hal_queue_pool_update_peaks(iree_hal_queue_pool_t* pool) {
+  iree_hal_queue_pool_statistics_t* statistics = &pool->statistics;
+  statistics->peak_reserved_size =
+      iree_max(statistics->peak_reserved_size, statistics->reserved_size);
+  statistics->peak_live_size = iree_max(statistics->peak_live_size,
+                                        statistics->reserved_size -
+                                            pool->free_size);
+}
+
+iree_status_t iree_hal_queue_pool_create(
+    iree_hal_queue_pool_params_t params, iree_hal_allocator_t* device_allocator,
+    iree_allocator_t host_allocator, iree_hal_queue_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_queue_pool_t* pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*pool), (void**)&pool));
+  pool->host_allocator = host_allocator;
+  pool->params = params;
+  pool->device_allocator = device_allocator;
+  iree_hal_allocator_retain(device_allocator);
+  iree_slim_mutex_initialize(&pool->mutex);
+  pool->slot_head = NULL;
+  pool->free_size = 0;
+  memset(&pool->statistics, 0, sizeof(pool->statistics));
+
+  iree_metric_register(&iree_hal_queue_pool_hits.base);
+  iree_metric_register(&iree_hal_queue_pool_misses.base);
+
+  *out_pool = pool;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Frees the |slot| storage and drops the pool reference to its allocation.
+// Any buffers acquired from the slot retain the allocation until released.
+//
+// The pool mutex must not be held by the caller.
+static void iree_hal_queue_pool_slot_free(iree_hal_queue_pool_t* pool,
+                                          iree_hal_queue_pool_slot_t* slot) {
+  iree_hal_queue_pool_slot_clear_fence(slot);
+  iree_hal_buffer_release(slot->buffer);
+  iree_allocator_free(pool->host_allocator, slot);
+}
+
+// Returns true if all buffers acquired from the live |slot| have been released
+// without being deallocated such that the pool holds the only reference.
+static bool iree_hal_queue_pool_slot_is_abandoned(
+    iree_hal_queue_pool_slot_t* slot) {
+  return iree_atomic_ref_count_load(
+             &((iree_hal_resource_t*)slot->buffer)->ref_count) == 1;
+}
+
+// Reclaims any live slots that have been abandoned by their users as free.
+//
+// Must be called with the pool mutex held.
+static void iree_hal_queue_pool_reclaim_abandoned(iree_hal_queue_pool_t* pool) {
+  for (iree_hal_queue_pool_slot_t* slot = pool->slot_head; slot != NULL;
+       slot = slot->next) {
+    if (slot->is_live && iree_hal_queue_pool_slot_is_abandoned(slot)) {
+      slot->is_live = false;
+      pool->free_size += iree_hal_buffer_allocation_size(slot->buffer);
+    }
+  }
+}
+
+// Unlinks all free slots from |pool| and returns them as a list.
+//
+// Must be called with the pool mutex held.
+static iree_hal_queue_pool_slot_t* iree_hal_queue_pool_take_free_slots(
+    iree_hal_queue_pool_t* pool) {
+  iree_hal_queue_pool_slot_t* free_head = NULL;
+  iree_hal_queue_pool_slot_t** slot_ptr = &pool->slot_head;
+  while (*slot_ptr) {
+    iree_hal_queue_pool_slot_t* slot = *slot_ptr;
+    if (slot->is_live) {
+      slot_ptr = &slot->next;
+      continue;
+    }
+    *slot_ptr = slot->next;
+    slot->next = free_head;
+    free_head = slot;
+    pool->statistics.reserved_size -=
+        iree_hal_buffer_allocation_size(slot->buffer);
+  }
+  pool->free_size = 0;
+  return free_head;
+}
+
+void iree_hal_queue_pool_trim(iree_hal_queue_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_queue_pool_reclaim_abandoned(pool);
+  iree_hal_queue_pool_slot_t* free_head =
+      iree_hal_queue_pool_take_free_slots(pool);
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  // Free without holding the lock as deallocation can be slow. Device work
+  // that may still be using the memory retains its buffers and keeps the
+  // allocations alive until it completes.
+  while (free_head) {
+    iree_hal_queue_pool_slot_t* next = free_head->next;
+    iree_hal_queue_pool_slot_free(pool, free_head);
+    free_head = next;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_queue_pool_free(iree_hal_queue_pool_t* pool) {
+  if (!pool) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = pool->host_allocator;
+
+  iree_hal_queue_pool_slot_t* slot = pool->slot_head;
+  while (slot) {
+    iree_hal_queue_pool_slot_t* next = slot->next;
+    iree_hal_queue_pool_slot_free(pool, slot);
+    slot = next;
+  }
+  pool->slot_head = NULL;
+
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_hal_allocator_release(pool->device_allocator);
+  iree_allocator_free(host_allocator, pool);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns true if the allocation in |slot| can service a request for
+// |allocation_size| bytes with |params|.
+static bool iree_hal_queue_pool_slot_is_compatible(
+    iree_hal_queue_pool_slot_t* slot, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size) {
+  iree_hal_buffer_t* buffer = slot->buffer;
+  const iree_device_size_t slot_size = iree_hal_buffer_allocation_size(buffer);
+  return iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                           params->type) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           params->usage) &&
+         slot_size >= allocation_size &&
+         slot_size <= allocation_size * IREE_HAL_QUEUE_POOL_MAX_WASTE_FACTOR;
+}
+
+// Finds the smallest free slot that can service the request and marks it live.
+//
+// Must be called with the pool mutex held.
+static iree_hal_queue_pool_slot_t* iree_hal_queue_pool_find_and_take_slot(
+    iree_hal_queue_pool_t* pool,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size) {
+  iree_hal_queue_pool_slot_t* best_slot = NULL;
+  for (int pass = 0; pass < 2 && !best_slot; ++pass) {
+    // Only scan for abandoned allocations if the free slots can't be used.
+    if (pass == 1) iree_hal_queue_pool_reclaim_abandoned(pool);
+    for (iree_hal_queue_pool_slot_t* slot = pool->slot_head; slot != NULL;
+         slot = slot->next) {
+      if (slot->is_live ||
+          !iree_hal_queue_pool_slot_is_compatible(slot, params,
+                                                  allocation_size)) {
+        continue;
+      }
+      if (best_slot && iree_hal_buffer_allocation_size(slot->buffer) >=
+                           iree_hal_buffer_allocation_size(best_slot->buffer)) {
+        continue;
+      }
+      if (!iree_hal_queue_pool_slot_is_reusable(slot, wait_semaphore_list)) {
+        continue;
+      }
+      best_slot = slot;
+    }
+  }
+  if (best_slot) {
+    best_slot->is_live = true;
+    iree_hal_queue_pool_slot_clear_fence(best_slot);
+    pool->free_size -= iree_hal_buffer_allocation_size(best_slot->buffer);
+    iree_hal_queue_pool_update_peaks(pool);
+  }
+  return best_slot;
+}
+
+// Records an allocation that bypasses the pool in the statistics.
+static void iree_hal_queue_pool_record_allocation(iree_hal_queue_pool_t* pool,
+                                                  bool is_device_allocation) {
+  iree_slim_mutex_lock(&pool->mutex);
+  ++pool->statistics.allocation_count;
+  if (is_device_allocation) ++pool->statistics.device_allocation_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+iree_status_t iree_hal_queue_pool_acquire(
+    iree_hal_queue_pool_t* pool,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  // Buffers that may be shared outside of the queue timeline can't be pooled.
+  if (iree_any_bit_set(params.usage,
+                       IREE_HAL_BUFFER_USAGE_SHARING_EXPORT |
+                           IREE_HAL_BUFFER_USAGE_SHARING_IMMUTABLE |
+                           IREE_HAL_BUFFER_USAGE_SHARING_REPLICATE)) {
+    iree_hal_queue_pool_record_allocation(pool, /*is_device_allocation=*/true);
+    iree_status_t status = iree_hal_allocator_allocate_buffer(
+        pool->device_allocator, params, allocation_size, out_buffer);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Use the same parameters the allocator would so that pooled memory is
+  // allocated with the broadest set that can service each request.
+  iree_hal_buffer_params_t compat_params;
+  iree_device_size_t compat_allocation_size = 0;
+  if (!iree_all_bits_set(iree_hal_allocator_query_buffer_compatibility(
+                             pool->device_allocator, params, allocation_size,
+                             &compat_params, &compat_allocation_size),
+                         IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "allocator cannot allocate a buffer with the given parameters");
+  }
+
+  // Try to reuse memory from a prior deallocation. The returned subspan is
+  // created with the lock held so that the slot can't be seen as abandoned.
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_queue_pool_slot_t* slot = iree_hal_queue_pool_find_and_take_slot(
+      pool, wait_semaphore_list, &compat_params, compat_allocation_size);
+  ++pool->statistics.allocation_count;
+  if (!slot) ++pool->statistics.device_allocation_count;
+  if (slot) {
+    status = iree_hal_subspan_buffer_create(
+        slot->buffer, 0, allocation_size, /*device_allocator=*/NULL,
+        pool->host_allocator, out_buffer);
+    if (!iree_status_is_ok(status)) {
+      slot->is_live = false;
+      pool->free_size += iree_hal_buffer_allocation_size(slot->buffer);
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (slot) {
+    iree_metric_counter_increment(&iree_hal_queue_pool_hits);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Allocate new memory without holding the lock.
+  iree_metric_counter_increment(&iree_hal_queue_pool_misses);
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_allocator_allocate_buffer(pool->device_allocator,
+                                             compat_params,
+                                             compat_allocation_size, &buffer));
+
+  // Allocators that suballocate (such as caching allocator slabs) return
+  // subspans that can't be wrapped again. Those are returned unpooled and the
+  // underlying allocator reuses the memory once the buffer is released.
+  if (iree_hal_buffer_allocated_buffer(buffer) != buffer) {
+    *out_buffer = buffer;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  status =
+      iree_allocator_malloc(pool->host_allocator, sizeof(*slot), (void**)&slot);
+  if (iree_status_is_ok(status)) {
+    memset(slot, 0, sizeof(*slot));
+    slot->is_live = true;
+    slot->buffer = buffer;
+    status = iree_hal_subspan_buffer_create(
+        slot->buffer, 0, allocation_size, /*device_allocator=*/NULL,
+        pool->host_allocator, out_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_slim_mutex_lock(&pool->mutex);
+    slot->next = pool->slot_head;
+    pool->slot_head = slot;
+    pool->statistics.reserved_size +=
+        iree_hal_buffer_allocation_size(slot->buffer);
+    iree_hal_queue_pool_update_peaks(pool);
+    iree_slim_mutex_unlock(&pool->mutex);
+  } else {
+    iree_hal_buffer_release(buffer);
+    iree_allocator_free(pool->host_allocator, slot);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_queue_pool_release(
+    iree_hal_queue_pool_t* pool, iree_hal_buffer_t* buffer,
+    const iree_hal_semaphore_list_t release_semaphore_list) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  const iree_device_size_t allocation_size =
+      iree_hal_buffer_allocation_size(allocated_buffer);
+  iree_hal_queue_pool_slot_t* dead_slot = NULL;
+
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_queue_pool_slot_t** slot_ptr = &pool->slot_head;
+  while (*slot_ptr && (*slot_ptr)->buffer != allocated_buffer) {
+    slot_ptr = &(*slot_ptr)->next;
+  }
+  iree_hal_queue_pool_slot_t* slot = *slot_ptr;
+  if (slot && slot->is_live) {
+    if (release_semaphore_list.count > IREE_HAL_QUEUE_POOL_MAX_FENCE_COUNT ||
+        pool->free_size + allocation_size > pool->params.max_free_capacity) {
+      // Stop pooling the memory; it'll be freed when the last buffer
+      // referencing it is released.
+      *slot_ptr = slot->next;
+      dead_slot = slot;
+      pool->statistics.reserved_size -= allocation_size;
+    } else {
+      slot->is_live = false;
+      slot->fence_count = release_semaphore_list.count;
+      for (iree_host_size_t i = 0; i < release_semaphore_list.count; ++i) {
+        slot->fence_semaphores[i] = release_semaphore_list.semaphores[i];
+        iree_hal_semaphore_retain(slot->fence_semaphores[i]);
+        slot->fence_values[i] = release_semaphore_list.payload_values[i];
+      }
+      pool->free_size += allocation_size;
+    }
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  if (dead_slot) iree_hal_queue_pool_slot_free(pool, dead_slot);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_queue_pool_query_statistics(
+    iree_hal_queue_pool_t* pool,
+    iree_hal_queue_pool_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  iree_slim_mutex_lock(&pool->mutex);
+  *out_statistics = pool->statistics;
+  out_statistics->live_size = pool->statistics.reserved_size - pool->free_size;
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+iree_status_t iree_hal_queue_pool_query_i64(iree_hal_queue_pool_t* pool,
+                                            iree_string_view_t key,
+                                            int64_t* out_value) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_value);
+  *out_value = 0;
+  iree_hal_queue_pool_statistics_t statistics;
+  iree_hal_queue_pool_query_statistics(pool, &statistics);
+  if (iree_string_view_equal(key, IREE_SV("allocation_count"))) {
+    *out_value = (int64_t)statistics.allocation_count;
+  } else if (iree_string_view_equal(key, IREE_SV("device_allocation_count"))) {
+    *out_value = (int64_t)statistics.device_allocation_count;
+  } else if (iree_string_view_equal(key, IREE_SV("reserved_size"))) {
+    *out_value = (int64_t)statistics.reserved_size;
+  } else if (iree_string_view_equal(key, IREE_SV("peak_reserved_size"))) {
+    *out_value = (int64_t)statistics.peak_reserved_size;
+  } else if (iree_string_view_equal(key, IREE_SV("live_size"))) {
+    *out_value = (int64_t)statistics.live_size;
+  } else if (iree_string_view_equal(key, IREE_SV("peak_live_size"))) {
+    *out_value = (int64_t)statistics.peak_live_size;
+  } else {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "unknown queue pool statistic '%.*s'",
+                            (int)key.size, key.data);
+  }
+  return iree_ok_status();
+}
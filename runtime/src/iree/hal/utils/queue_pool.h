@@ -0,0 +1,122 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_QUEUE_POOL_H_
+#define IREE_HAL_UTILS_QUEUE_POOL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// A timeline-aware pool servicing queue-ordered allocations.
+//
+// Devices without native stream-ordered allocators can use the pool to
+// implement iree_hal_device_queue_alloca and iree_hal_device_queue_dealloca
+// without blocking the host. Memory deallocated on the queue is tagged with
+// the semaphore payloads that must be reached before it is no longer in use
+// and a subsequent allocation may reuse it as soon as those are reached. An
+// allocation that waits on the same (or later) semaphore payloads as a prior
+// deallocation can reuse the memory immediately even though the payloads have
+// not yet been reached as the queue ordering guarantees the prior user has
+// completed before the new one starts. This lets transient allocations alias
+// across asynchronous stages on the same timeline.
+//
+// Buffers returned from the pool are subspans of the pooled allocations.
+// Releasing all references to a buffer without deallocating it on the queue is
+// safe and the memory will be reused once nothing references it.
+//
+// In steady state workloads that repeatedly allocate the same transients per
+// invocation (such as serving) the pool grows to cover the invocations in
+// flight and then services all allocations without allocating device memory.
+// The statistics can be used to verify this and to right-size the pool.
+//
+// Thread-safe: allocations and deallocations may happen from multiple threads.
+typedef struct iree_hal_queue_pool_t iree_hal_queue_pool_t;
+
+// Parameters used to configure an iree_hal_queue_pool_t.
+typedef struct iree_hal_queue_pool_params_t {
+  // Maximum total size in bytes of deallocated memory retained for reuse.
+  // Deallocations that would exceed the capacity release their memory back to
+  // the device allocator once it is no longer in use.
+  iree_device_size_t max_free_capacity;
+} iree_hal_queue_pool_params_t;
+
+// Initializes |out_params| to the default values.
+void iree_hal_queue_pool_params_initialize(
+    iree_hal_queue_pool_params_t* out_params);
+
+// Accounting for an iree_hal_queue_pool_t since creation.
+typedef struct iree_hal_queue_pool_statistics_t {
+  // Total number of allocations requested from the pool.
+  uint64_t allocation_count;
+  // Number of allocations that required allocating from the device allocator.
+  // Remains unchanged across invocations once the pool reaches steady state.
+  uint64_t device_allocation_count;
+  // Total size in bytes of the memory retained by the pool.
+  iree_device_size_t reserved_size;
+  // High-water mark of |reserved_size|. This is the capacity needed to service
+  // the observed workload without device allocations.
+  iree_device_size_t peak_reserved_size;
+  // Size in bytes of the retained memory currently allocated to users.
+  iree_device_size_t live_size;
+  // High-water mark of |live_size|. The difference from |peak_reserved_size|
+  // is memory that was waiting for prior users to complete.
+  iree_device_size_t peak_live_size;
+} iree_hal_queue_pool_statistics_t;
+
+// Creates a queue pool allocating storage from |device_allocator|.
+// The device allocator is retained by the pool.
+iree_status_t iree_hal_queue_pool_create(
+    iree_hal_queue_pool_params_t params, iree_hal_allocator_t* device_allocator,
+    iree_allocator_t host_allocator, iree_hal_queue_pool_t** out_pool);
+
+// Frees |pool| and releases all retained memory. Buffers acquired from the pool
+// remain valid until they are released.
+void iree_hal_queue_pool_free(iree_hal_queue_pool_t* pool);
+
+// Releases all unused memory retained by |pool| to the device allocator.
+void iree_hal_queue_pool_trim(iree_hal_queue_pool_t* pool);
+
+// Acquires a buffer of |allocation_size| bytes with the given |params| that may
+// be used once all of |wait_semaphore_list| has been reached. Memory from
+// prior deallocations is reused if it is no longer in use or will not be by
+// the time the |wait_semaphore_list| is reached and otherwise new memory is
+// allocated. Does not wait. Buffers suballocated by the device allocator (such
+// as caching allocator slab slots) are returned unpooled.
+iree_status_t iree_hal_queue_pool_acquire(
+    iree_hal_queue_pool_t* pool,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
+    iree_hal_buffer_t** out_buffer);
+
+// Returns the memory of |buffer| to the |pool| for reuse once all of
+// |release_semaphore_list| has been reached. Buffers not acquired from the pool
+// are ignored and freed when released. The caller must still release |buffer|.
+void iree_hal_queue_pool_release(
+    iree_hal_queue_pool_t* pool, iree_hal_buffer_t* buffer,
+    const iree_hal_semaphore_list_t release_semaphore_list);
+
+// Queries the current |pool| accounting.
+void iree_hal_queue_pool_query_statistics(
+    iree_hal_queue_pool_t* pool,
+    iree_hal_queue_pool_statistics_t* out_statistics);
+
+// Queries a single statistic of |pool| by |key| for use with
+// iree_hal_device_query_i64 under the `hal.queue_pool` category. Keys match
+// the iree_hal_queue_pool_statistics_t field names.
+// Returns IREE_STATUS_NOT_FOUND if the key is unknown.
+iree_status_t iree_hal_queue_pool_query_i64(iree_hal_queue_pool_t* pool,
+                                            iree_string_view_t key,
+                                            int64_t* out_value);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_QUEUE_POOL_H_
@@ -0,0 +1,272 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/queue_pool.h"
+
+#include <cstdint>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/semaphore_base.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+namespace {
+extern const iree_hal_semaphore_vtable_t test_semaphore_vtable;
+}  // namespace
+
+// Semaphore that is only ever queried and signaled from the test thread.
+struct TestSemaphore {
+  iree_hal_semaphore_t base;
+  iree_allocator_t host_allocator;
+  uint64_t current_value;
+
+  static iree_hal_semaphore_t* Create(iree_allocator_t host_allocator) {
+    TestSemaphore* semaphore = nullptr;
+    IREE_CHECK_OK(iree_allocator_malloc(host_allocator, sizeof(*semaphore),
+                                        (void**)&semaphore));
+    iree_hal_semaphore_initialize(&test_semaphore_vtable, &semaphore->base);
+    semaphore->host_allocator = host_allocator;
+    semaphore->current_value = 0;
+    return &semaphore->base;
+  }
+
+  static TestSemaphore* Cast(iree_hal_semaphore_t* base_semaphore) {
+    return reinterpret_cast<TestSemaphore*>(base_semaphore);
+  }
+
+  static void Destroy(iree_hal_semaphore_t* base_semaphore) {
+    auto* semaphore = Cast(base_semaphore);
+    iree_hal_semaphore_deinitialize(&semaphore->base);
+    iree_allocator_free(semaphore->host_allocator, semaphore);
+  }
+
+  static iree_status_t Query(iree_hal_semaphore_t* base_semaphore,
+                             uint64_t* out_value) {
+    *out_value = Cast(base_semaphore)->current_value;
+    return iree_ok_status();
+  }
+
+  static iree_status_t Signal(iree_hal_semaphore_t* base_semaphore,
+                              uint64_t new_value) {
+    Cast(base_semaphore)->current_value = new_value;
+    return iree_ok_status();
+  }
+
+  static void Fail(iree_hal_semaphore_t* base_semaphore,
+                   iree_status_t status) {
+    iree_status_ignore(status);
+  }
+
+  static iree_status_t Wait(iree_hal_semaphore_t* base_semaphore,
+                            uint64_t value, iree_timeout_t timeout) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+  }
+};
+
+namespace {
+const iree_hal_semaphore_vtable_t test_semaphore_vtable = {
+    /*.destroy=*/TestSemaphore::Destroy,
+    /*.query=*/TestSemaphore::Query,
+    /*.signal=*/TestSemaphore::Signal,
+    /*.fail=*/TestSemaphore::Fail,
+    /*.wait=*/TestSemaphore::Wait,
+};
+}  // namespace
+
+class QueuePoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("heap"), iree_allocator_system(),
+        iree_allocator_system(), &device_allocator_));
+    iree_hal_queue_pool_params_t pool_params;
+    iree_hal_queue_pool_params_initialize(&pool_params);
+    IREE_ASSERT_OK(iree_hal_queue_pool_create(pool_params, device_allocator_,
+                                              iree_allocator_system(), &pool_));
+    semaphore_ = TestSemaphore::Create(iree_allocator_system());
+  }
+
+  void TearDown() override {
+    iree_hal_semaphore_release(semaphore_);
+    iree_hal_queue_pool_free(pool_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  iree_hal_buffer_t* Acquire(iree_device_size_t allocation_size,
+                             iree_hal_semaphore_list_t wait_semaphore_list =
+                                 iree_hal_semaphore_list_empty()) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_queue_pool_acquire(pool_, wait_semaphore_list,
+                                              params, allocation_size,
+                                              &buffer));
+    return buffer;
+  }
+
+  // Returns a list referencing |semaphore_| at |*value|.
+  iree_hal_semaphore_list_t SemaphoreList(uint64_t* value) {
+    iree_hal_semaphore_list_t list = {
+        /*count=*/1,
+        /*semaphores=*/&semaphore_,
+        /*payload_values=*/value,
+    };
+    return list;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_queue_pool_t* pool_ = NULL;
+  iree_hal_semaphore_t* semaphore_ = NULL;
+};
+
+TEST_F(QueuePoolTest, AcquireExactSize) {
+  iree_hal_buffer_t* buffer = Acquire(100);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer), 100);
+  iree_hal_queue_pool_release(pool_, buffer, iree_hal_semaphore_list_empty());
+  iree_hal_buffer_release(buffer);
+}
+
+TEST_F(QueuePoolTest, ReuseAfterFenceReached) {
+  iree_hal_buffer_t* buffer_a = Acquire(1024);
+  iree_hal_buffer_t* allocation_a = iree_hal_buffer_allocated_buffer(buffer_a);
+  iree_hal_buffer_retain(allocation_a);
+  uint64_t fence_value = 1;
+  iree_hal_queue_pool_release(pool_, buffer_a, SemaphoreList(&fence_value));
+  iree_hal_buffer_release(buffer_a);
+
+  // The fence has not been reached and the allocation isn't ordered after it
+  // so new memory must be used.
+  iree_hal_buffer_t* buffer_b = Acquire(1024);
+  EXPECT_NE(iree_hal_buffer_allocated_buffer(buffer_b), allocation_a);
+
+  // Once reached the memory can be reused.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore_, 1));
+  iree_hal_buffer_t* buffer_c = Acquire(1024);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer_c), allocation_a);
+
+  iree_hal_buffer_release(buffer_c);
+  iree_hal_buffer_release(buffer_b);
+  iree_hal_buffer_release(allocation_a);
+}
+
+TEST_F(QueuePoolTest, ReuseWhenOrderedAfterFence) {
+  iree_hal_buffer_t* buffer_a = Acquire(1024);
+  iree_hal_buffer_t* allocation_a = iree_hal_buffer_allocated_buffer(buffer_a);
+  uint64_t fence_value = 1;
+  iree_hal_queue_pool_release(pool_, buffer_a, SemaphoreList(&fence_value));
+  iree_hal_buffer_release(buffer_a);
+
+  // Waiting on a later payload of the same semaphore implies the prior user
+  // has completed and the memory can be reused immediately.
+  uint64_t wait_value = 2;
+  iree_hal_buffer_t* buffer_b = Acquire(1024, SemaphoreList(&wait_value));
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer_b), allocation_a);
+  iree_hal_buffer_release(buffer_b);
+}
+
+TEST_F(QueuePoolTest, ReuseAbandoned) {
+  // Releasing without deallocating returns the memory once unreferenced.
+  iree_hal_buffer_t* buffer_a = Acquire(1024);
+  iree_hal_buffer_t* allocation_a = iree_hal_buffer_allocated_buffer(buffer_a);
+  iree_hal_buffer_release(buffer_a);
+  iree_hal_buffer_t* buffer_b = Acquire(1024);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer_b), allocation_a);
+  iree_hal_buffer_release(buffer_b);
+}
+
+TEST_F(QueuePoolTest, ReuseSmaller) {
+  iree_hal_buffer_t* buffer_a = Acquire(1024);
+  iree_hal_buffer_t* allocation_a = iree_hal_buffer_allocated_buffer(buffer_a);
+  iree_hal_buffer_retain(allocation_a);
+  iree_hal_queue_pool_release(pool_, buffer_a, iree_hal_semaphore_list_empty());
+  iree_hal_buffer_release(buffer_a);
+
+  // Too small to reuse without wasting most of the allocation.
+  iree_hal_buffer_t* buffer_b = Acquire(100);
+  EXPECT_NE(iree_hal_buffer_allocated_buffer(buffer_b), allocation_a);
+
+  // Close enough in size to reuse.
+  iree_hal_buffer_t* buffer_c = Acquire(1000);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer_c), allocation_a);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer_c), 1000);
+
+  iree_hal_buffer_release(buffer_c);
+  iree_hal_buffer_release(buffer_b);
+  iree_hal_buffer_release(allocation_a);
+}
+
+TEST_F(QueuePoolTest, TrimReleasesFreeMemory) {
+  iree_hal_buffer_t* buffer_a = Acquire(1024);
+  iree_hal_buffer_t* allocation_a = iree_hal_buffer_allocated_buffer(buffer_a);
+  iree_hal_buffer_retain(allocation_a);
+  iree_hal_queue_pool_release(pool_, buffer_a, iree_hal_semaphore_list_empty());
+  iree_hal_buffer_release(buffer_a);
+
+  iree_hal_queue_pool_trim(pool_);
+  iree_hal_buffer_t* buffer_b = Acquire(1024);
+  EXPECT_NE(iree_hal_buffer_allocated_buffer(buffer_b), allocation_a);
+
+  iree_hal_buffer_release(buffer_b);
+  iree_hal_buffer_release(allocation_a);
+}
+
+TEST_F(QueuePoolTest, SteadyStateDoesNotAllocate) {
+  // Each invocation allocates the same transients and deallocates them once
+  // the invocation completes.
+  iree_hal_queue_pool_statistics_t statistics;
+  for (uint64_t i = 0; i < 4; ++i) {
+    iree_hal_buffer_t* buffer_a = Acquire(1024);
+    iree_hal_buffer_t* buffer_b = Acquire(2048);
+    uint64_t fence_value = i + 1;
+    iree_hal_queue_pool_release(pool_, buffer_a, SemaphoreList(&fence_value));
+    iree_hal_queue_pool_release(pool_, buffer_b, SemaphoreList(&fence_value));
+    iree_hal_buffer_release(buffer_a);
+    iree_hal_buffer_release(buffer_b);
+    IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore_, fence_value));
+  }
+  iree_hal_queue_pool_query_statistics(pool_, &statistics);
+  EXPECT_EQ(statistics.allocation_count, 8);
+  EXPECT_EQ(statistics.device_allocation_count, 2);
+  EXPECT_EQ(statistics.live_size, 0);
+  EXPECT_EQ(statistics.peak_live_size, 1024 + 2048);
+
+  int64_t value = 0;
+  IREE_ASSERT_OK(iree_hal_queue_pool_query_i64(
+      pool_, IREE_SV("peak_reserved_size"), &value));
+  EXPECT_EQ(value, 1024 + 2048);
+}
+
+TEST_F(QueuePoolTest, HighWaterMarkCoversInvocationsInFlight) {
+  // Two invocations are in flight at a time: memory from invocation i is only
+  // reusable by invocation i + 2.
+  for (uint64_t i = 0; i < 4; ++i) {
+    iree_hal_buffer_t* buffer = Acquire(1024);
+    uint64_t fence_value = i + 1;
+    iree_hal_queue_pool_release(pool_, buffer, SemaphoreList(&fence_value));
+    iree_hal_buffer_release(buffer);
+    if (i > 0) IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore_, i));
+  }
+  iree_hal_queue_pool_statistics_t statistics;
+  iree_hal_queue_pool_query_statistics(pool_, &statistics);
+  EXPECT_EQ(statistics.device_allocation_count, 2);
+  EXPECT_EQ(statistics.peak_reserved_size, 2 * 1024);
+  EXPECT_EQ(statistics.peak_live_size, 1024);
+
+  int64_t value = 0;
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_NOT_FOUND,
+      iree_hal_queue_pool_query_i64(pool_, IREE_SV("unknown"), &value));
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -7,6 +7,20 @@
 #include "iree/hal/utils/resource_set.h"
 
 #include "iree/base/internal/debugging.h"
+#include "iree/base/internal/math.h"
+
+// Maximum number of slots probed for a resource before giving up. Giving up
+// only results in a redundant retain and bounds the cost of a full table.
+#define IREE_HAL_RESOURCE_SET_HASH_MAX_PROBES 16
+
+// Minimum number of slots in a hash segment. Block pools with blocks smaller
+// than this don't use the hash table. Must also leave room for the table
+// header (iree_hal_resource_set_hash_t) in a single block.
+#define IREE_HAL_RESOURCE_SET_HASH_MIN_SEGMENT_CAPACITY 128
+static_assert(sizeof(iree_hal_resource_set_hash_t) <=
+                  IREE_HAL_RESOURCE_SET_HASH_MIN_SEGMENT_CAPACITY *
+                      sizeof(iree_hal_resource_t*),
+              "hash table header must fit in a segment-sized block");
 
 // Computes the total capacity in resources of a chunk allocated with a total
 // |storage_size| (including the header).
@@ -86,6 +100,23 @@ static void iree_hal_resource_set_release_blocks(iree_hal_resource_set_t* set) {
     chunk = next_chunk;
   }
 
+  // Add the hash table and all of its segments to the release list.
+  iree_hal_resource_set_hash_t* hash = set->hash;
+  if (hash) {
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(hash->segments); ++i) {
+      if (!hash->segments[i]) continue;
+      iree_arena_block_t* block =
+          iree_arena_block_trailer(set->block_pool, hash->segments[i]);
+      block->next = block_head;
+      block_head = block;
+      if (!block_tail) block_tail = block;
+    }
+    iree_arena_block_t* block = iree_arena_block_trailer(set->block_pool, hash);
+    block->next = block_head;
+    block_head = block;
+    if (!block_tail) block_tail = block;
+  }
+
   // Release all blocks back to the block pool in one operation.
   // NOTE: this invalidates the |set| memory.
   iree_arena_block_pool_t* block_pool = set->block_pool;
@@ -110,6 +141,15 @@ IREE_API_EXPORT void iree_hal_resource_set_free(iree_hal_resource_set_t* set) {
     // Once unpoisoned we can read the memory to get the next chunk.
     chunk = chunk->next_chunk;
   }
+  if (set->hash) {
+    iree_hal_resource_set_hash_t* hash = set->hash;
+    IREE_ASAN_UNPOISON_MEMORY_REGION(hash, set->block_pool->usable_block_size);
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(hash->segments); ++i) {
+      if (!hash->segments[i]) continue;
+      IREE_ASAN_UNPOISON_MEMORY_REGION(hash->segments[i],
+                                       set->block_pool->usable_block_size);
+    }
+  }
 #endif  // IREE_SANITIZER_ADDRESS
 
   // Release all resources and the arena block used by the set.
@@ -134,6 +174,16 @@ IREE_API_EXPORT void iree_hal_resource_set_freeze(
                         : 0));
     chunk = next_chunk;
   }
+  // Poison the hash table and all of its segments.
+  if (set->hash) {
+    iree_hal_resource_set_hash_t* hash = set->hash;
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(hash->segments); ++i) {
+      if (!hash->segments[i]) continue;
+      IREE_ASAN_POISON_MEMORY_REGION(hash->segments[i],
+                                     set->block_pool->usable_block_size);
+    }
+    IREE_ASAN_POISON_MEMORY_REGION(hash, set->block_pool->usable_block_size);
+  }
   // Poison the set.
   IREE_ASAN_POISON_MEMORY_REGION(set, sizeof(iree_hal_resource_set_t));
 #endif  // IREE_SANITIZER_ADDRESS
@@ -158,10 +208,157 @@ static iree_status_t iree_hal_resource_set_insert_retain(
 
   // Retain and insert into the chunk.
   chunk->resources[chunk->count++] = resource;
+  ++set->retained_count;
   iree_hal_resource_retain(resource);
   return iree_ok_status();
 }
 
+// Returns true if the hash table of |set| has been built.
+static inline bool iree_hal_resource_set_is_hashed(
+    const iree_hal_resource_set_t* set) {
+  return set->hash && set->hash->segment_count > 0;
+}
+
+// Returns the number of slots in each hash table segment of |set|.
+// Always a power of two.
+static iree_host_size_t iree_hal_resource_set_hash_segment_capacity(
+    const iree_hal_resource_set_t* set) {
+  uint32_t slot_count =
+      (uint32_t)(set->block_pool->usable_block_size / sizeof(void*));
+  return slot_count ? 1u << (31 - iree_math_count_leading_zeros_u32(slot_count))
+                    : 0;
+}
+
+// Mixes the bits of the |resource| pointer such that both the low bits used for
+// the slot and the high bits used for the segment are well distributed.
+static uint64_t iree_hal_resource_set_hash_resource(
+    const iree_hal_resource_t* resource) {
+  uint64_t hash = (uint64_t)(uintptr_t)resource;
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Probes the hash table for |resource|. Returns the slot containing the
+// resource with |out_found| set or the empty slot it should be stored in.
+// Returns NULL if the resource is not found and no empty slot is available
+// within the probe limit.
+static iree_hal_resource_t** iree_hal_resource_set_hash_lookup(
+    iree_hal_resource_set_t* set, iree_hal_resource_t* resource,
+    bool* out_found) {
+  *out_found = false;
+  uint64_t hash_value = iree_hal_resource_set_hash_resource(resource);
+  iree_hal_resource_t** segment =
+      set->hash->segments[(hash_value >> 32) & (set->hash->segment_count - 1)];
+  iree_host_size_t slot_mask =
+      iree_hal_resource_set_hash_segment_capacity(set) - 1;
+  for (iree_host_size_t i = 0; i < IREE_HAL_RESOURCE_SET_HASH_MAX_PROBES;
+       ++i) {
+    iree_hal_resource_t** slot = &segment[(hash_value + i) & slot_mask];
+    if (*slot == resource) {
+      *out_found = true;
+      return slot;
+    } else if (!*slot) {
+      return slot;
+    }
+  }
+  return NULL;
+}
+
+// Rebuilds the hash table with |segment_count| segments from all resources
+// retained in the chunk list.
+static iree_status_t iree_hal_resource_set_hash_rebuild(
+    iree_hal_resource_set_t* set, iree_host_size_t segment_count) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, segment_count);
+
+  // Acquire the table and storage for any new segments. Blocks are retained
+  // with the set even if this fails partway.
+  iree_arena_block_t* block = NULL;
+  if (!set->hash) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_block_pool_acquire(set->block_pool, &block,
+                                          (void**)&set->hash));
+    memset(set->hash, 0, sizeof(*set->hash));
+  }
+  iree_hal_resource_set_hash_t* hash = set->hash;
+  for (iree_host_size_t i = hash->segment_count; i < segment_count; ++i) {
+    if (hash->segments[i]) continue;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_block_pool_acquire(set->block_pool, &block,
+                                          (void**)&hash->segments[i]));
+  }
+  iree_host_size_t segment_capacity =
+      iree_hal_resource_set_hash_segment_capacity(set);
+  for (iree_host_size_t i = 0; i < segment_count; ++i) {
+    memset(hash->segments[i], 0,
+           segment_capacity * sizeof(hash->segments[i][0]));
+  }
+  hash->segment_count = segment_count;
+  hash->count = 0;
+
+  // Reinsert all retained resources. Duplicates retained prior to the table
+  // being built (or that overflowed) are stored once.
+  for (iree_hal_resource_set_chunk_t* chunk = set->chunk_head; chunk;
+       chunk = chunk->next_chunk) {
+    for (iree_host_size_t i = 0; i < chunk->count; ++i) {
+      bool found = false;
+      iree_hal_resource_t** slot =
+          iree_hal_resource_set_hash_lookup(set, chunk->resources[i], &found);
+      if (slot && !found) {
+        *slot = chunk->resources[i];
+        ++hash->count;
+      }
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Builds or grows the hash table if the set has grown past the threshold or
+// the table is more than half full. No-op if the block pool blocks are too
+// small to hold useful segments or the table is at its maximum size.
+static iree_status_t iree_hal_resource_set_hash_reserve(
+    iree_hal_resource_set_t* set) {
+  iree_host_size_t segment_capacity =
+      iree_hal_resource_set_hash_segment_capacity(set);
+  iree_host_size_t current_segment_count =
+      set->hash ? set->hash->segment_count : 0;
+  if (current_segment_count == 0) {
+    if (set->retained_count < IREE_HAL_RESOURCE_SET_HASH_THRESHOLD) {
+      return iree_ok_status();
+    } else if (segment_capacity <
+               IREE_HAL_RESOURCE_SET_HASH_MIN_SEGMENT_CAPACITY) {
+      return iree_ok_status();
+    }
+  } else if (set->hash->count * 2 <=
+             current_segment_count * segment_capacity) {
+    return iree_ok_status();
+  }
+  iree_host_size_t segment_count = iree_max(1, current_segment_count);
+  while (segment_count < IREE_HAL_RESOURCE_SET_HASH_MAX_SEGMENTS &&
+         segment_count * segment_capacity < set->retained_count * 2) {
+    segment_count *= 2;
+  }
+  if (segment_count <= current_segment_count) return iree_ok_status();
+  return iree_hal_resource_set_hash_rebuild(set, segment_count);
+}
+
+// Retains |resource| after it has missed the MRU and the hash table. |slot| is
+// the empty hash table slot to store the resource in, if any.
+static iree_status_t iree_hal_resource_set_insert_miss(
+    iree_hal_resource_set_t* set, iree_hal_resource_t* resource,
+    iree_hal_resource_t** slot) {
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_retain(set, resource));
+  if (slot) {
+    *slot = resource;
+    ++set->hash->count;
+  }
+  return iree_hal_resource_set_hash_reserve(set);
+}
+
 // Scans the lookaside for the resource pointer and updates the order if found.
 // If the resource was not found then it will be inserted into the main list as
 // well as the MRU.
@@ -259,10 +456,23 @@ static iree_status_t iree_hal_resource_set_insert_1(
     return iree_ok_status();
   }
 
-  // Miss - insert into the main list (slow path).
+  // Miss - check the hash table if the set has grown large enough to have one.
+  iree_hal_resource_t** slot = NULL;
+  if (iree_hal_resource_set_is_hashed(set)) {
+    bool found = false;
+    slot = iree_hal_resource_set_hash_lookup(set, resource, &found);
+    if (found) {
+      memmove(&set->mru[1], &set->mru[0],
+              sizeof(set->mru[0]) * (IREE_ARRAYSIZE(set->mru) - 1));
+      set->mru[0] = resource;
+      return iree_ok_status();
+    }
+  }
+
+  // Insert into the main list (slow path).
   // Note that we do this before updating the MRU in case allocation fails - we
   // don't want to keep the pointer around unless we've really retained it.
-  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_retain(set, resource));
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_miss(set, resource, slot));
 
   // Shift the MRU down and insert the new item at the head.
   memmove(&set->mru[1], &set->mru[0],
@@ -272,16 +482,39 @@ static iree_status_t iree_hal_resource_set_insert_1(
   return iree_ok_status();
 }
 
+// Inserts a batch of resources directly into the hash table without touching
+// the MRU. Large batches are usually unique resources (such as all bindings of
+// a binding table) that would otherwise evict everything in the MRU.
+static iree_status_t iree_hal_resource_set_insert_n_hashed(
+    iree_hal_resource_set_t* set, iree_host_size_t count,
+    iree_hal_resource_t* const* resources) {
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    if (!resources[i]) continue;
+    bool found = false;
+    iree_hal_resource_t** slot =
+        iree_hal_resource_set_hash_lookup(set, resources[i], &found);
+    if (found) continue;
+    IREE_RETURN_IF_ERROR(
+        iree_hal_resource_set_insert_miss(set, resources[i], slot));
+  }
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_status_t
 iree_hal_resource_set_insert(iree_hal_resource_set_t* set,
                              iree_host_size_t count, const void* resources) {
+  iree_hal_resource_t* const* typed_resources =
+      (iree_hal_resource_t* const*)resources;
+  if (iree_hal_resource_set_is_hashed(set) &&
+      count > IREE_ARRAYSIZE(set->mru)) {
+    return iree_hal_resource_set_insert_n_hashed(set, count, typed_resources);
+  }
+
   // For now we process one at a time. We should have a stride that lets us
   // amortize the cost of doing the MRU update and insertion allocation by
   // say slicing off 4/8/16/32 resources at a time etc. Today each miss that
   // requires a full insertion goes down the whole path of checking chunk
   // capacity and such.
-  iree_hal_resource_t* const* typed_resources =
-      (iree_hal_resource_t* const*)resources;
   for (iree_host_size_t i = 0; i < count; ++i) {
     IREE_RETURN_IF_ERROR(
         iree_hal_resource_set_insert_1(set, typed_resources[i]));
@@ -54,6 +54,31 @@ typedef struct iree_hal_resource_set_chunk_t {
 #define IREE_HAL_RESOURCE_SET_MRU_SIZE \
   (iree_hardware_constructive_interference_size / sizeof(uintptr_t))
 
+// Number of resources retained by a set after which insertions that miss the
+// MRU are deduplicated with a hash table. Below this the MRU alone is used as
+// it avoids the additional memory and is usually sufficient.
+#define IREE_HAL_RESOURCE_SET_HASH_THRESHOLD \
+  (4 * IREE_HAL_RESOURCE_SET_MRU_SIZE)
+
+// Maximum number of block pool blocks used for hash table slots. The table
+// grows by doubling the segment count up to this limit and afterward may fail
+// to deduplicate some insertions.
+#define IREE_HAL_RESOURCE_SET_HASH_MAX_SEGMENTS 32
+
+// Hash table used by large resource sets to deduplicate insertions.
+// Allocated from the block pool of the set when first needed. Each segment is
+// one block holding a power-of-two number of slots. Resources hash to a
+// segment and are then linearly probed within it.
+typedef struct iree_hal_resource_set_hash_t {
+  // Number of live segments.
+  iree_host_size_t segment_count;
+  // Number of resources stored across all segments.
+  iree_host_size_t count;
+  // Segment storage; segments beyond segment_count may be allocated but are
+  // unused and are released with the set.
+  iree_hal_resource_t** segments[IREE_HAL_RESOURCE_SET_HASH_MAX_SEGMENTS];
+} iree_hal_resource_set_hash_t;
+
 // "Efficient" append-only set for retaining a set of resources.
 // This is a non-deterministic data structure that tries to reduce the amount of
 // overhead involved in tracking a reasonably-sized set of resources (~dozens to
@@ -74,6 +99,13 @@ typedef struct iree_hal_resource_set_chunk_t {
 // whatever user code may need to do to maintain proper lifetime - or as small
 // in terms of code-size.
 //
+// Sets that grow large (command buffers with thousands of commands over
+// hundreds of unique resources) miss the MRU often enough that the duplicate
+// retains dominate. Once IREE_HAL_RESOURCE_SET_HASH_THRESHOLD resources have
+// been retained the set builds an open-addressing hash table from block pool
+// blocks and uses it to deduplicate MRU misses. The table remains best-effort:
+// if it is full or cannot grow insertions fall back to retaining duplicates.
+//
 // **WARNING**: thread-unsafe insertion: it's assumed that sets are constructed
 // by a single thread, sealed, and then released at once at a future time point.
 // Multiple threads needing to insert into a set should have their own sets and
@@ -99,6 +131,14 @@ typedef struct iree_hal_resource_set_t {
 
   // Linked list of storage chunks.
   iree_hal_resource_set_chunk_t* chunk_head;
+
+  // Total number of resources retained across all chunks including any
+  // duplicates.
+  iree_host_size_t retained_count;
+
+  // Hash table of retained resources used once the set grows past
+  // IREE_HAL_RESOURCE_SET_HASH_THRESHOLD or NULL if not yet needed.
+  iree_hal_resource_set_hash_t* hash;
 } iree_hal_resource_set_t;
 
 // TODO(benvanik): add an allocation method that allows for placement; in many
@@ -122,6 +162,9 @@ IREE_API_EXPORT void iree_hal_resource_set_freeze(iree_hal_resource_set_t* set);
 
 // Inserts zero or more resources into the set.
 // Each resource will be retained for at least the lifetime of the set.
+//
+// Batches larger than the MRU inserted into sets using the hash table bypass
+// the MRU so that they do not thrash it.
 IREE_API_EXPORT iree_status_t
 iree_hal_resource_set_insert(iree_hal_resource_set_t* set,
                              iree_host_size_t count, const void* resources);
@@ -252,6 +252,57 @@ TEST_F(ResourceSetTest, RedundantInsertion) {
   EXPECT_EQ(live_bitmap, 0u);
 }
 
+// Tests redundant insertion of more resources than the MRU can track so that
+// deduplication is handled by the hash table.
+TEST_F(ResourceSetTest, HashedDeduplication) {
+  // The hash table requires blocks large enough to hold useful segments.
+  iree_arena_block_pool_t large_block_pool;
+  iree_arena_block_pool_initialize(4096, host_allocator, &large_block_pool);
+  auto resource_set = make_resource_set(&large_block_pool);
+
+  // Allocate 256 resources tracked across 8 live maps.
+  iree_hal_resource_t* resources[256] = {NULL};
+  static_assert(
+      IREE_ARRAYSIZE(resources) > IREE_HAL_RESOURCE_SET_HASH_THRESHOLD,
+      "need to pick a value that lets us exceed the hash table threshold");
+  uint32_t live_bitmaps[IREE_ARRAYSIZE(resources) / 32] = {0u};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources); ++i) {
+    IREE_ASSERT_OK(iree_hal_test_resource_create(
+        i % 32, &live_bitmaps[i / 32], host_allocator, &resources[i]));
+  }
+
+  // Insert all resources in bulk twice; the second time hits the table.
+  for (int pass = 0; pass < 2; ++pass) {
+    IREE_ASSERT_OK(iree_hal_resource_set_insert(
+        resource_set.get(), IREE_ARRAYSIZE(resources), resources));
+    EXPECT_EQ(resource_set->retained_count, IREE_ARRAYSIZE(resources));
+  }
+  ASSERT_NE(resource_set->hash, nullptr);
+
+  // Insert individually in a scattered order that defeats the MRU.
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources) * 4; ++i) {
+    iree_host_size_t index = (i * 97) % IREE_ARRAYSIZE(resources);
+    IREE_ASSERT_OK(
+        iree_hal_resource_set_insert(resource_set.get(), 1, &resources[index]));
+  }
+  EXPECT_EQ(resource_set->retained_count, IREE_ARRAYSIZE(resources));
+
+  // Release all of the resources - they should still be owned by the set.
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources); ++i) {
+    iree_hal_resource_release(resources[i]);
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(live_bitmaps); ++i) {
+    EXPECT_EQ(live_bitmaps[i], 0xFFFFFFFFu);
+  }
+
+  // Ensure the set releases the resources.
+  resource_set.reset();
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(live_bitmaps); ++i) {
+    EXPECT_EQ(live_bitmaps[i], 0u);
+  }
+  iree_arena_block_pool_deinitialize(&large_block_pool);
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
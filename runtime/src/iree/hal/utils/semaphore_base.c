@@ -32,6 +32,38 @@ static void iree_hal_semaphore_timepoint_list_push_back(
   list->tail = timepoint;
 }
 
+// Inserts |timepoint| into |list| after all timepoints with a minimum value
+// less than or equal to its own. Timepoints are usually acquired in increasing
+// order and the scan from the tail is expected to terminate immediately.
+static void iree_hal_semaphore_timepoint_list_insert_sorted(
+    iree_hal_semaphore_timepoint_list_t* list,
+    iree_hal_semaphore_timepoint_t* timepoint) {
+  iree_hal_semaphore_timepoint_t* prev = list->tail;
+  while (prev && prev->minimum_value > timepoint->minimum_value) {
+    prev = prev->prev;
+  }
+  if (!prev) {
+    // New head (or the list is empty).
+    timepoint->prev = NULL;
+    timepoint->next = list->head;
+    if (list->head) {
+      list->head->prev = timepoint;
+    } else {
+      list->tail = timepoint;
+    }
+    list->head = timepoint;
+    return;
+  }
+  timepoint->prev = prev;
+  timepoint->next = prev->next;
+  if (prev->next) {
+    prev->next->prev = timepoint;
+  } else {
+    list->tail = timepoint;
+  }
+  prev->next = timepoint;
+}
+
 // Erases |timepoint| from |list|.
 static void iree_hal_semaphore_timepoint_list_erase(
     iree_hal_semaphore_timepoint_list_t* list,
@@ -63,6 +95,36 @@ static void iree_hal_semaphore_timepoint_list_take_all(
   available_list->tail = NULL;
 }
 
+// Moves the prefix of the sorted |available_list| with minimum values less than
+// or equal to |value| into |ready_list|. Only the timepoints moved are visited.
+static void iree_hal_semaphore_timepoint_list_take_reached(
+    iree_hal_semaphore_timepoint_list_t* available_list, uint64_t value,
+    iree_hal_semaphore_timepoint_list_t* ready_list) {
+  IREE_ASSERT(available_list != ready_list);
+  iree_hal_semaphore_timepoint_t* last_reached = NULL;
+  for (iree_hal_semaphore_timepoint_t* timepoint = available_list->head;
+       timepoint != NULL && timepoint->minimum_value <= value;
+       timepoint = timepoint->next) {
+    last_reached = timepoint;
+  }
+  if (!last_reached) return;
+  ready_list->head = available_list->head;
+  ready_list->tail = last_reached;
+  available_list->head = last_reached->next;
+  if (available_list->head) {
+    available_list->head->prev = NULL;
+  } else {
+    available_list->tail = NULL;
+  }
+  last_reached->next = NULL;
+}
+
+// Returns true if |timepoint| has a finite deadline.
+static inline bool iree_hal_semaphore_timepoint_has_deadline(
+    const iree_hal_semaphore_timepoint_t* timepoint) {
+  return timepoint->deadline_ns != IREE_TIME_INFINITE_FUTURE;
+}
+
 // Issues the callback for the given |timepoint| and resets it.
 static void iree_hal_semaphore_issue_timepoint_callback(
     iree_hal_semaphore_t* semaphore, uint64_t new_value,
@@ -112,7 +174,6 @@ static void iree_hal_semaphore_resolve_timepoints(
     iree_hal_semaphore_t* semaphore, uint64_t new_value) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_hal_semaphore_timepoint_list_t pending_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t ready_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t expired_list = {NULL, NULL};
 
@@ -124,32 +185,39 @@ static void iree_hal_semaphore_resolve_timepoints(
     return;
   }
 
-  // Scan through the list and divvy up timepoints into still-pending, ready to
-  // resolve, and expired buckets.
-  iree_time_t now_ns = iree_time_now();
-  for (iree_hal_semaphore_timepoint_t* timepoint =
-           semaphore->timepoint_list.head;
-       timepoint != NULL;) {
-    iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
-    timepoint->next = NULL;
-
-    if (timepoint->minimum_value <= new_value) {
-      // Reached the timepoint; even if the deadline has been reached we'll
-      // still consider this a hit.
-      iree_hal_semaphore_timepoint_list_push_back(&ready_list, timepoint);
-    } else if (timepoint->deadline_ns <= now_ns) {
-      // Deadline expired before the timepoint was reached.
-      iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
-    } else {
-      // Still pending.
-      iree_hal_semaphore_timepoint_list_push_back(&pending_list, timepoint);
+  // Take all timepoints that have been reached; even if their deadline has
+  // been reached we'll still consider them a hit. Because the list is sorted
+  // this only visits the timepoints being resolved.
+  iree_hal_semaphore_timepoint_list_take_reached(&semaphore->timepoint_list,
+                                                 new_value, &ready_list);
+  if (semaphore->deadline_count > 0) {
+    for (iree_hal_semaphore_timepoint_t* timepoint = ready_list.head;
+         timepoint != NULL; timepoint = timepoint->next) {
+      if (iree_hal_semaphore_timepoint_has_deadline(timepoint)) {
+        --semaphore->deadline_count;
+      }
     }
-
-    timepoint = next_timepoint;
   }
 
-  // Preserve pending timepoints.
-  semaphore->timepoint_list = pending_list;
+  // Timepoints with deadlines may be anywhere in the remaining list and we
+  // have to scan for those that have expired. Most waits are infinite and
+  // this (along with the time query) is skipped.
+  if (semaphore->deadline_count > 0) {
+    iree_time_t now_ns = iree_time_now();
+    for (iree_hal_semaphore_timepoint_t* timepoint =
+             semaphore->timepoint_list.head;
+         timepoint != NULL;) {
+      iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
+      if (timepoint->deadline_ns <= now_ns) {
+        // Deadline expired before the timepoint was reached.
+        iree_hal_semaphore_timepoint_list_erase(&semaphore->timepoint_list,
+                                                timepoint);
+        iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
+        --semaphore->deadline_count;
+      }
+      timepoint = next_timepoint;
+    }
+  }
 
   // Issue callbacks for all successes and failures.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, new_value,
@@ -173,6 +241,7 @@ static void iree_hal_semaphore_reject_timepoints(
   iree_hal_semaphore_timepoint_list_t failed_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_take_all(&semaphore->timepoint_list,
                                              &failed_list);
+  semaphore->deadline_count = 0;
 
   // Issue failure callbacks for all timepoints.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, UINT64_MAX,
@@ -192,9 +261,12 @@ IREE_API_EXPORT void iree_hal_semaphore_initialize(
     iree_hal_semaphore_t* out_semaphore) {
   IREE_ASSERT_ARGUMENT(out_semaphore);
   iree_hal_resource_initialize(vtable, &out_semaphore->resource);
+  iree_atomic_store_int64(&out_semaphore->published_value, 0,
+                          iree_memory_order_relaxed);
   iree_slim_mutex_initialize(&out_semaphore->timepoint_mutex);
   memset(&out_semaphore->timepoint_list, 0,
          sizeof(out_semaphore->timepoint_list));
+  out_semaphore->deadline_count = 0;
 }
 
 IREE_API_EXPORT void iree_hal_semaphore_deinitialize(
@@ -203,6 +275,20 @@ IREE_API_EXPORT void iree_hal_semaphore_deinitialize(
   iree_slim_mutex_deinitialize(&semaphore->timepoint_mutex);
 }
 
+IREE_API_EXPORT void iree_hal_semaphore_publish_value(
+    iree_hal_semaphore_t* semaphore, uint64_t new_value) {
+  IREE_ASSERT_ARGUMENT(semaphore);
+  int64_t current_value = iree_atomic_load_int64(&semaphore->published_value,
+                                                 iree_memory_order_relaxed);
+  while ((uint64_t)current_value < new_value) {
+    if (iree_atomic_compare_exchange_weak_int64(
+            &semaphore->published_value, &current_value, (int64_t)new_value,
+            iree_memory_order_release, iree_memory_order_relaxed)) {
+      break;
+    }
+  }
+}
+
 IREE_API_EXPORT void iree_hal_semaphore_acquire_timepoint(
     iree_hal_semaphore_t* semaphore, uint64_t minimum_value,
     iree_timeout_t timeout, iree_hal_semaphore_callback_t callback,
@@ -226,8 +312,11 @@ IREE_API_EXPORT void iree_hal_semaphore_acquire_timepoint(
   // After we release the lock the callback may be issued immediately as another
   // thread may be waiting to signal the timepoint.
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
-  iree_hal_semaphore_timepoint_list_push_back(&semaphore->timepoint_list,
-                                              out_timepoint);
+  iree_hal_semaphore_timepoint_list_insert_sorted(&semaphore->timepoint_list,
+                                                  out_timepoint);
+  if (iree_hal_semaphore_timepoint_has_deadline(out_timepoint)) {
+    ++semaphore->deadline_count;
+  }
   iree_slim_mutex_unlock(&semaphore->timepoint_mutex);
 
   IREE_TRACE_ZONE_END(z0);
@@ -250,6 +339,9 @@ IREE_API_EXPORT void iree_hal_semaphore_cancel_timepoint(
     // callback.
     iree_hal_semaphore_timepoint_list_erase(&semaphore->timepoint_list,
                                             timepoint);
+    if (iree_hal_semaphore_timepoint_has_deadline(timepoint)) {
+      --semaphore->deadline_count;
+    }
 
     // Neuter the timepoint so that it is never called.
     // Other threads may be sitting and waiting for the lock and we need to
@@ -280,10 +372,14 @@ IREE_API_EXPORT void iree_hal_semaphore_notify(
 
   if (new_status_code == IREE_STATUS_OK) {
     // Semaphore is in a valid state and has reached some value.
+    // Publish before resolving so that callbacks observe the new value.
+    iree_hal_semaphore_publish_value(semaphore, new_value);
     // Resolve timepoints that have been hit (or have expired).
     iree_hal_semaphore_resolve_timepoints(semaphore, new_value);
   } else {
     // Semaphore has failed and we need to reject all timepoints.
+    iree_hal_semaphore_publish_value(semaphore,
+                                     IREE_HAL_SEMAPHORE_FAILURE_VALUE);
     iree_hal_semaphore_reject_timepoints(semaphore, new_status_code);
   }
 
@@ -66,9 +66,8 @@ typedef struct iree_hal_semaphore_timepoint_t {
   iree_hal_semaphore_callback_t callback;
 } iree_hal_semaphore_timepoint_t;
 
-// A doubly-linked FIFO list of timepoints.
-// The order of the timepoints does *not* match increasing payload values but
-// instead the order they were added to the list.
+// A doubly-linked list of timepoints sorted by increasing minimum value.
+// Timepoints with equal minimum values are kept in the order they were added.
 //
 // Note that the timepoints are not owned by the list - this just nicely
 // stitches together timepoints for easier management.
@@ -89,20 +88,30 @@ typedef struct iree_hal_semaphore_timepoint_list_t {
 // failure events using the iree_hal_semaphore_notify method. Any satisfied
 // timepoints will have their callback made immediately from the notifying
 // thread.
+//
+// The most recently notified value is also published atomically so that
+// implementations can answer queries and already-satisfied waits without
+// taking any locks (see iree_hal_semaphore_load_published_value).
 struct iree_hal_semaphore_t {
   iree_hal_resource_t resource;  // must be at 0
 
+  // Highest value published via iree_hal_semaphore_publish_value or
+  // iree_hal_semaphore_notify or IREE_HAL_SEMAPHORE_FAILURE_VALUE if the
+  // semaphore has failed. Only ever increases.
+  iree_atomic_int64_t published_value;
+
   // Non-recursive mutex guarding access to the timepoint list.
   iree_slim_mutex_t timepoint_mutex;
 
-  // Timepoint list in insertion order.
-  // There are probably better orderings we could use here that allow us to
-  // walk the entire list less frequently, though target payload value is not
-  // enough as deadlines still require the scan. We could sort by non-infinite
-  // deadlines first and then infinite ones last but given the common timepoint
-  // counts (0..1) it's not worth the complexity today.
+  // Timepoint list sorted by minimum value so that resolving only needs to
+  // visit the timepoints that are actually reached.
   iree_hal_semaphore_timepoint_list_t timepoint_list
       IREE_GUARDED_BY(timepoint_mutex);
+
+  // Number of timepoints in the list with a finite deadline. Deadlines are not
+  // ordered by the list and expiring them requires a scan that is skipped
+  // entirely when this is zero (the common case of infinite waits).
+  iree_host_size_t deadline_count IREE_GUARDED_BY(timepoint_mutex);
 };
 
 // Initializes the base |out_semaphore| resource.
@@ -110,6 +119,26 @@ IREE_API_EXPORT void iree_hal_semaphore_initialize(
     const iree_hal_semaphore_vtable_t* vtable,
     iree_hal_semaphore_t* out_semaphore);
 
+// Publishes |new_value| as the latest value observed by the implementation
+// without resolving any timepoints. Values lower than the currently published
+// value are ignored. Implementations that track their payload under their own
+// lock can publish while holding it so that lock-free readers never observe
+// the value moving backwards relative to lock-holding readers. The initial
+// value of the semaphore should be published after initialization.
+IREE_API_EXPORT void iree_hal_semaphore_publish_value(
+    iree_hal_semaphore_t* semaphore, uint64_t new_value);
+
+// Returns the latest published value of the |semaphore| without locking.
+// The value is a lower bound of the payload of the implementation: waits for
+// values less than or equal to it are already satisfied. Returns
+// IREE_HAL_SEMAPHORE_FAILURE_VALUE if the semaphore has failed and callers
+// must go to the implementation to get the failure status.
+static inline uint64_t iree_hal_semaphore_load_published_value(
+    iree_hal_semaphore_t* semaphore) {
+  return (uint64_t)iree_atomic_load_int64(&semaphore->published_value,
+                                          iree_memory_order_acquire);
+}
+
 // Deinitializes the |semaphore|.
 // Because timepoints retain their semaphore the timepoint list is known empty.
 IREE_API_EXPORT void iree_hal_semaphore_deinitialize(
@@ -153,7 +182,9 @@ IREE_API_EXPORT void iree_hal_semaphore_cancel_timepoint(
     iree_hal_semaphore_t* semaphore, iree_hal_semaphore_timepoint_t* timepoint);
 
 // Used by implementations to notify when a new timepoint is reached.
-// Implementations must call this when they observe changes.
+// Implementations must call this when they observe changes. The |new_value| is
+// published (or IREE_HAL_SEMAPHORE_FAILURE_VALUE on failure) and only the
+// timepoints reached are visited unless any have finite deadlines.
 // Calling this incorrectly will result in undefined behavior.
 //
 // Must not be called from a timepoint callback.
@@ -0,0 +1,205 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/semaphore_base.h"
+#include "iree/testing/benchmark.h"
+
+//===----------------------------------------------------------------------===//
+// Host-only semaphore used to drive the base implementation
+//===----------------------------------------------------------------------===//
+
+// Minimal semaphore that reports the published value and notifies on signal.
+// Waits are not supported as the benchmarks only exercise timepoints.
+typedef struct iree_hal_benchmark_semaphore_t {
+  iree_hal_semaphore_t base;
+  iree_allocator_t host_allocator;
+} iree_hal_benchmark_semaphore_t;
+
+static const iree_hal_semaphore_vtable_t iree_hal_benchmark_semaphore_vtable;
+
+static iree_hal_semaphore_t* iree_hal_benchmark_semaphore_create(
+    iree_allocator_t host_allocator) {
+  iree_hal_benchmark_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(host_allocator, sizeof(*semaphore),
+                                      (void**)&semaphore));
+  iree_hal_semaphore_initialize(&iree_hal_benchmark_semaphore_vtable,
+                                &semaphore->base);
+  semaphore->host_allocator = host_allocator;
+  return &semaphore->base;
+}
+
+static void iree_hal_benchmark_semaphore_destroy(
+    iree_hal_semaphore_t* base_semaphore) {
+  iree_hal_benchmark_semaphore_t* semaphore =
+      (iree_hal_benchmark_semaphore_t*)base_semaphore;
+  iree_hal_semaphore_deinitialize(&semaphore->base);
+  iree_allocator_free(semaphore->host_allocator, semaphore);
+}
+
+static iree_status_t iree_hal_benchmark_semaphore_query(
+    iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
+  *out_value = iree_hal_semaphore_load_published_value(base_semaphore);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_benchmark_semaphore_signal(
+    iree_hal_semaphore_t* base_semaphore, uint64_t new_value) {
+  iree_hal_semaphore_notify(base_semaphore, new_value, IREE_STATUS_OK);
+  return iree_ok_status();
+}
+
+static void iree_hal_benchmark_semaphore_fail(
+    iree_hal_semaphore_t* base_semaphore, iree_status_t status) {
+  iree_hal_semaphore_notify(base_semaphore, IREE_HAL_SEMAPHORE_FAILURE_VALUE,
+                            iree_status_consume_code(status));
+}
+
+static iree_status_t iree_hal_benchmark_semaphore_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value,
+    iree_timeout_t timeout) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "waits not supported on benchmark semaphores");
+}
+
+static const iree_hal_semaphore_vtable_t iree_hal_benchmark_semaphore_vtable = {
+    .destroy = iree_hal_benchmark_semaphore_destroy,
+    .query = iree_hal_benchmark_semaphore_query,
+    .signal = iree_hal_benchmark_semaphore_signal,
+    .fail = iree_hal_benchmark_semaphore_fail,
+    .wait = iree_hal_benchmark_semaphore_wait,
+};
+
+static iree_status_t iree_hal_semaphore_benchmark_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  ++*(uint64_t*)user_data;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Benchmarks
+//===----------------------------------------------------------------------===//
+
+// Keeps a fixed number of timepoints pending on increasing values and signals
+// the semaphore such that each signal releases exactly one of them. Timepoints
+// are resolved in O(1) regardless of how many are pending.
+//
+// user_data is the number of pending timepoints.
+static iree_status_t iree_hal_semaphore_benchmark_signal_pending(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_host_size_t pending_count =
+      (iree_host_size_t)(uintptr_t)benchmark_def->user_data;
+  iree_hal_semaphore_t* semaphore =
+      iree_hal_benchmark_semaphore_create(benchmark_state->host_allocator);
+
+  uint64_t resolved_count = 0;
+  iree_hal_semaphore_callback_t callback = {
+      .fn = iree_hal_semaphore_benchmark_callback,
+      .user_data = &resolved_count,
+  };
+
+  // Timepoints are always waiting on values in [value + 1, value + count].
+  iree_hal_semaphore_timepoint_t* timepoints = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(benchmark_state->host_allocator,
+                                      pending_count * sizeof(*timepoints),
+                                      (void**)&timepoints));
+  uint64_t value = 0;
+  for (iree_host_size_t i = 0; i < pending_count; ++i) {
+    iree_hal_semaphore_acquire_timepoint(semaphore, value + i + 1,
+                                         iree_infinite_timeout(), callback,
+                                         &timepoints[i]);
+  }
+
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/256)) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      // Resolves the timepoint that was waiting on value + 1 and reuses its
+      // storage for a new timepoint at the end of the window.
+      ++value;
+      iree_host_size_t timepoint_idx = (value - 1) % pending_count;
+      IREE_CHECK_OK(iree_hal_semaphore_signal(semaphore, value));
+      iree_hal_semaphore_acquire_timepoint(
+          semaphore, value + pending_count, iree_infinite_timeout(), callback,
+          &timepoints[timepoint_idx]);
+    }
+  }
+  IREE_ASSERT_EQ(resolved_count, value);
+
+  // Fails the semaphore to flush all remaining timepoints.
+  iree_hal_semaphore_fail(semaphore,
+                          iree_status_from_code(IREE_STATUS_CANCELLED));
+  iree_hal_semaphore_release(semaphore);
+  iree_allocator_free(benchmark_state->host_allocator, timepoints);
+
+  return iree_ok_status();
+}
+
+// Queries the published value of a semaphore, as done by drivers on the
+// lock-free query and already-satisfied wait paths.
+static iree_status_t iree_hal_semaphore_benchmark_query(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_hal_semaphore_t* semaphore =
+      iree_hal_benchmark_semaphore_create(benchmark_state->host_allocator);
+  IREE_CHECK_OK(iree_hal_semaphore_signal(semaphore, 1ull));
+
+  volatile uint64_t value_sum = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/256)) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint64_t value = 0;
+      IREE_CHECK_OK(iree_hal_semaphore_query(semaphore, &value));
+      value_sum += value;
+    }
+  }
+
+  iree_hal_semaphore_release(semaphore);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_semaphore_benchmark_signal_pending
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_signal_pending,
+    };
+    benchmark_def.user_data = (void*)(uintptr_t)1;
+    iree_benchmark_register(iree_make_cstring_view("signal_pending_1"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)(uintptr_t)64;
+    iree_benchmark_register(iree_make_cstring_view("signal_pending_64"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)(uintptr_t)1024;
+    iree_benchmark_register(iree_make_cstring_view("signal_pending_1024"),
+                            &benchmark_def);
+  }
+
+  // iree_hal_semaphore_benchmark_query
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_query,
+    };
+    iree_benchmark_register(iree_make_cstring_view("query"), &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
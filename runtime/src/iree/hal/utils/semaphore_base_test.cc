@@ -374,6 +374,87 @@ TEST_F(TrackingSemaphoreTest, CancelResolvedTimepoint) {
   iree_hal_semaphore_release(*semaphore);
 }
 
+// Tests that timepoints acquired out of order are resolved only once their
+// value is reached and that unreached ones remain pending.
+TEST_F(TrackingSemaphoreTest, ResolveOutOfOrderTimepoints) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  CallbackState states[4];
+  iree_hal_semaphore_timepoint_t timepoints[4];
+  const uint64_t values[4] = {3ull, 1ull, 4ull, 2ull};
+  for (int i = 0; i < 4; ++i) {
+    iree_hal_semaphore_acquire_timepoint(*semaphore, values[i],
+                                         iree_infinite_timeout(),
+                                         MakeCallback(&states[i]),
+                                         &timepoints[i]);
+  }
+
+  // Only the timepoints for 1 and 2 are reached.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 2ull));
+  EXPECT_EQ(states[0].callback_count, 0);
+  EXPECT_EQ(states[1].callback_count, 1);
+  EXPECT_EQ(states[2].callback_count, 0);
+  EXPECT_EQ(states[3].callback_count, 1);
+
+  // Cancel one of the pending timepoints and resolve the remaining one.
+  iree_hal_semaphore_cancel_timepoint(*semaphore, &timepoints[2]);
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 4ull));
+  EXPECT_EQ(states[0].callback_count, 1);
+  EXPECT_EQ(states[0].value, 4ull);
+  EXPECT_EQ(states[2].callback_count, 0);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
+// Tests that timepoints with expired deadlines are resolved with
+// IREE_STATUS_DEADLINE_EXCEEDED while others remain pending.
+TEST_F(TrackingSemaphoreTest, ExpireTimepoint) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+
+  CallbackState expired_state;
+  iree_hal_semaphore_timepoint_t expired_timepoint;
+  iree_hal_semaphore_acquire_timepoint(
+      *semaphore, 2ull, iree_immediate_timeout(), MakeCallback(&expired_state),
+      &expired_timepoint);
+  CallbackState pending_state;
+  iree_hal_semaphore_timepoint_t pending_timepoint;
+  iree_hal_semaphore_acquire_timepoint(
+      *semaphore, 3ull, iree_infinite_timeout(), MakeCallback(&pending_state),
+      &pending_timepoint);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 1ull));
+  EXPECT_EQ(expired_state.callback_count, 1);
+  EXPECT_EQ(expired_state.status_code, IREE_STATUS_DEADLINE_EXCEEDED);
+  EXPECT_EQ(pending_state.callback_count, 0);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 3ull));
+  EXPECT_EQ(expired_state.callback_count, 1);
+  EXPECT_EQ(pending_state.callback_count, 1);
+  EXPECT_EQ(pending_state.status_code, IREE_STATUS_OK);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
+// Tests that notified values are published and only ever increase.
+TEST_F(TrackingSemaphoreTest, PublishedValue) {
+  auto* semaphore = TestSemaphore::Create(0ull, host_allocator);
+  EXPECT_EQ(iree_hal_semaphore_load_published_value(*semaphore), 0ull);
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(*semaphore, 2ull));
+  EXPECT_EQ(iree_hal_semaphore_load_published_value(*semaphore), 2ull);
+
+  // Stale notifications (such as from racing pollers) are ignored.
+  iree_hal_semaphore_notify(*semaphore, 1ull, IREE_STATUS_OK);
+  EXPECT_EQ(iree_hal_semaphore_load_published_value(*semaphore), 2ull);
+
+  iree_hal_semaphore_fail(*semaphore,
+                          iree_make_status(IREE_STATUS_DATA_LOSS, "whoops"));
+  EXPECT_EQ(iree_hal_semaphore_load_published_value(*semaphore),
+            IREE_HAL_SEMAPHORE_FAILURE_VALUE);
+
+  iree_hal_semaphore_release(*semaphore);
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
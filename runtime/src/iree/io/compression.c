@@ -0,0 +1,521 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/compression.h"
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+
+IREE_API_EXPORT iree_status_t iree_io_compression_type_parse(
+    iree_string_view_t name, iree_io_compression_type_t* out_type) {
+  IREE_ASSERT_ARGUMENT(out_type);
+  if (iree_string_view_is_empty(name) ||
+      iree_string_view_equal_case(name, IREE_SV("none"))) {
+    *out_type = IREE_IO_COMPRESSION_TYPE_NONE;
+  } else if (iree_string_view_equal_case(name, IREE_SV("lz4"))) {
+    *out_type = IREE_IO_COMPRESSION_TYPE_LZ4;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported compression type `%.*s`; expected "
+                            "one of [none, lz4]",
+                            (int)name.size, name.data);
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// LZ4 block format
+//===----------------------------------------------------------------------===//
+//
+// Block format: https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+// A block is a sequence of (token, [literal length], literals, offset,
+// [match length]) sequences where the final sequence has only literals. The
+// encoder here is a simple greedy single-probe hash matcher: it's not as good
+// as the reference implementation but is compatible with it and decompression
+// speed (what matters at load time) is independent of the encoder.
+
+#define IREE_IO_LZ4_MIN_MATCH 4
+#define IREE_IO_LZ4_LAST_LITERALS 5
+#define IREE_IO_LZ4_MATCH_FIND_LIMIT 12
+#define IREE_IO_LZ4_MAX_OFFSET 65535
+#define IREE_IO_LZ4_HASH_LOG 12
+
+// Returns the worst-case compressed size of |length| bytes.
+static iree_host_size_t iree_io_lz4_compress_bound(iree_host_size_t length) {
+  return length + length / 255 + 16;
+}
+
+static inline uint32_t iree_io_lz4_read32(const uint8_t* ptr) {
+  uint32_t value = 0;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+static inline uint32_t iree_io_lz4_hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - IREE_IO_LZ4_HASH_LOG);
+}
+
+// Writes the extended portion of a literal or match length that has already
+// had the 15 stored in the token subtracted.
+static uint8_t* iree_io_lz4_write_length(uint8_t* op,
+                                         iree_host_size_t length) {
+  while (length >= 255) {
+    *op++ = 255;
+    length -= 255;
+  }
+  *op++ = (uint8_t)length;
+  return op;
+}
+
+// Writes a sequence of |literal_length| literals from |literals| to |op| with
+// an optional match (|match_length| of 0 for the final literal-only sequence).
+static uint8_t* iree_io_lz4_write_sequence(uint8_t* op, const uint8_t* literals,
+                                           iree_host_size_t literal_length,
+                                           uint16_t offset,
+                                           iree_host_size_t match_length) {
+  uint8_t* token = op++;
+  *token = (uint8_t)(iree_min(literal_length, 15) << 4);
+  if (literal_length >= 15) {
+    op = iree_io_lz4_write_length(op, literal_length - 15);
+  }
+  memcpy(op, literals, literal_length);
+  op += literal_length;
+  if (match_length == 0) return op;
+  *op++ = (uint8_t)(offset & 0xFF);
+  *op++ = (uint8_t)(offset >> 8);
+  const iree_host_size_t match_code = match_length - IREE_IO_LZ4_MIN_MATCH;
+  *token |= (uint8_t)iree_min(match_code, 15);
+  if (match_code >= 15) op = iree_io_lz4_write_length(op, match_code - 15);
+  return op;
+}
+
+// Compresses |source_length| bytes of |source| into |target| which must have
+// at least iree_io_lz4_compress_bound bytes available. Returns the number of
+// bytes written.
+static iree_host_size_t iree_io_lz4_compress_block(
+    const uint8_t* source, iree_host_size_t source_length, uint8_t* target) {
+  // Positions are stored +1 so that 0 indicates an empty slot.
+  uint32_t table[1 << IREE_IO_LZ4_HASH_LOG];
+  memset(table, 0, sizeof(table));
+
+  const uint8_t* ip = source;
+  const uint8_t* anchor = source;
+  uint8_t* op = target;
+  if (source_length > IREE_IO_LZ4_MATCH_FIND_LIMIT) {
+    // Matches must start at least 12 bytes before the end of the block and the
+    // last 5 bytes are always literals.
+    const uint8_t* match_start_limit =
+        source + source_length - IREE_IO_LZ4_MATCH_FIND_LIMIT;
+    const uint8_t* match_end_limit =
+        source + source_length - IREE_IO_LZ4_LAST_LITERALS;
+    while (ip < match_start_limit) {
+      const uint32_t sequence = iree_io_lz4_read32(ip);
+      const uint32_t hash = iree_io_lz4_hash(sequence);
+      const uint32_t candidate = table[hash];
+      table[hash] = (uint32_t)(ip - source) + 1;
+      const uint8_t* ref = candidate ? source + candidate - 1 : NULL;
+      if (!ref || ip - ref > IREE_IO_LZ4_MAX_OFFSET ||
+          iree_io_lz4_read32(ref) != sequence) {
+        ++ip;
+        continue;
+      }
+      iree_host_size_t match_length = IREE_IO_LZ4_MIN_MATCH;
+      while (ip + match_length < match_end_limit &&
+             ref[match_length] == ip[match_length]) {
+        ++match_length;
+      }
+      op = iree_io_lz4_write_sequence(op, anchor,
+                                      (iree_host_size_t)(ip - anchor),
+                                      (uint16_t)(ip - ref), match_length);
+      ip += match_length;
+      anchor = ip;
+    }
+  }
+  op = iree_io_lz4_write_sequence(
+      op, anchor, (iree_host_size_t)(source + source_length - anchor), 0, 0);
+  return (iree_host_size_t)(op - target);
+}
+
+// Reads the extended portion of a literal or match length.
+static bool iree_io_lz4_read_length(const uint8_t** ip, const uint8_t* ip_end,
+                                    iree_host_size_t* length) {
+  uint8_t byte = 0;
+  do {
+    if (*ip >= ip_end) return false;
+    byte = *(*ip)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+// Decompresses an LZ4 block from |source| into exactly |target_length| bytes
+// of |target|.
+static iree_status_t iree_io_lz4_decompress_block(
+    const uint8_t* source, iree_host_size_t source_length, uint8_t* target,
+    iree_host_size_t target_length) {
+  const uint8_t* ip = source;
+  const uint8_t* const ip_end = source + source_length;
+  uint8_t* op = target;
+  uint8_t* const op_end = target + target_length;
+  for (;;) {
+    if (ip >= ip_end) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 block truncated before sequence token");
+    }
+    const uint8_t token = *ip++;
+
+    // Literals.
+    iree_host_size_t literal_length = token >> 4;
+    if (literal_length == 15 &&
+        !iree_io_lz4_read_length(&ip, ip_end, &literal_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 block truncated in literal length");
+    }
+    if (literal_length > (iree_host_size_t)(ip_end - ip) ||
+        literal_length > (iree_host_size_t)(op_end - op)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 literals out of bounds");
+    }
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+    if (ip == ip_end) break;  // final literal-only sequence
+
+    // Match.
+    if (ip_end - ip < 2) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 block truncated in match offset");
+    }
+    const iree_host_size_t offset = (iree_host_size_t)ip[0] |
+                                    ((iree_host_size_t)ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (iree_host_size_t)(op - target)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 match offset %" PRIhsz " out of bounds",
+                              offset);
+    }
+    iree_host_size_t match_length = token & 15;
+    if (match_length == 15 &&
+        !iree_io_lz4_read_length(&ip, ip_end, &match_length)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 block truncated in match length");
+    }
+    match_length += IREE_IO_LZ4_MIN_MATCH;
+    if (match_length > (iree_host_size_t)(op_end - op)) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "LZ4 match out of bounds");
+    }
+    const uint8_t* match = op - offset;
+    if (offset >= match_length) {
+      memcpy(op, match, match_length);
+    } else {
+      // Overlapping matches repeat the last |offset| bytes.
+      for (iree_host_size_t i = 0; i < match_length; ++i) op[i] = match[i];
+    }
+    op += match_length;
+  }
+  if (op != op_end) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "LZ4 block decompressed to %" PRIhsz
+                            " bytes but expected %" PRIhsz,
+                            (iree_host_size_t)(op - target), target_length);
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Chunked blobs
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t iree_io_compress(
+    iree_io_compression_type_t type, iree_host_size_t chunk_size,
+    iree_const_byte_span_t source, iree_allocator_t host_allocator,
+    iree_byte_span_t* out_blob) {
+  IREE_ASSERT_ARGUMENT(out_blob);
+  *out_blob = iree_make_byte_span(NULL, 0);
+  if (type != IREE_IO_COMPRESSION_TYPE_LZ4) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported compression type %u", (uint32_t)type);
+  }
+  if (chunk_size == 0) chunk_size = IREE_IO_COMPRESSION_DEFAULT_CHUNK_SIZE;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)source.data_length);
+
+  // Allocate for the worst case and shrink when done.
+  const iree_host_size_t chunk_count =
+      (iree_host_size_t)iree_host_size_ceil_div(source.data_length, chunk_size);
+  const iree_host_size_t table_size =
+      sizeof(iree_io_compressed_blob_header_t) + chunk_count * sizeof(uint64_t);
+  const iree_host_size_t capacity =
+      table_size + iree_io_lz4_compress_bound(source.data_length) +
+      chunk_count * 16;
+  uint8_t* blob = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc_uninitialized(host_allocator, capacity,
+                                              (void**)&blob));
+
+  iree_io_compressed_blob_header_t header = {
+      .magic = IREE_IO_COMPRESSED_BLOB_MAGIC,
+      .compression = (uint32_t)type,
+      .length = source.data_length,
+      .chunk_size = chunk_size,
+      .chunk_count = chunk_count,
+  };
+  memcpy(blob, &header, sizeof(header));
+  uint8_t* chunk_ends = blob + sizeof(header);
+  uint8_t* chunk_data = blob + table_size;
+  uint64_t chunk_data_length = 0;
+  for (iree_host_size_t i = 0; i < chunk_count; ++i) {
+    const iree_host_size_t source_offset = i * chunk_size;
+    const iree_host_size_t source_length =
+        iree_min(chunk_size, source.data_length - source_offset);
+    uint8_t* chunk = chunk_data + chunk_data_length;
+    iree_host_size_t chunk_length = iree_io_lz4_compress_block(
+        source.data + source_offset, source_length, chunk);
+    if (chunk_length >= source_length) {
+      // Incompressible; store the chunk as-is.
+      memcpy(chunk, source.data + source_offset, source_length);
+      chunk_length = source_length;
+    }
+    chunk_data_length += chunk_length;
+    iree_unaligned_store_le_u64((uint64_t*)(chunk_ends + i * sizeof(uint64_t)),
+                                chunk_data_length);
+  }
+
+  const iree_host_size_t blob_length =
+      table_size + (iree_host_size_t)chunk_data_length;
+  iree_status_t status =
+      iree_allocator_realloc(host_allocator, blob_length, (void**)&blob);
+  if (iree_status_is_ok(status)) {
+    *out_blob = iree_make_byte_span(blob, blob_length);
+  } else {
+    iree_allocator_free(host_allocator, blob);
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)blob_length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Shared state for decompressing the chunks of a blob across threads.
+typedef struct iree_io_decompress_state_t {
+  iree_io_compressed_blob_header_t header;
+  // Table of chunk end offsets in |chunk_data|.
+  const uint8_t* chunk_ends;
+  // Base of the chunk data following the chunk table.
+  const uint8_t* chunk_data;
+  // Target memory of header.length bytes.
+  uint8_t* target;
+  // Index of the next chunk to be decompressed by any worker.
+  iree_atomic_intptr_t next_chunk;
+  // Set to 1 when any chunk fails so that workers stop early.
+  iree_atomic_int32_t failed;
+  // Number of spawned workers that have entered iree_io_decompress_worker.
+  // Once a thread has started its creator holds the last reference and
+  // releasing it joins the thread; see iree_io_decompress_await_started.
+  iree_atomic_int32_t started_count;
+  iree_notification_t started_notification;
+  // First failure reported by any worker; guarded by |mutex|.
+  iree_slim_mutex_t mutex;
+  iree_status_t status;
+} iree_io_decompress_state_t;
+
+static uint64_t iree_io_decompress_chunk_end(
+    const iree_io_decompress_state_t* state, iree_host_size_t i) {
+  return iree_unaligned_load_le_u64(
+      (const uint64_t*)(state->chunk_ends + i * sizeof(uint64_t)));
+}
+
+static iree_status_t iree_io_decompress_chunk(iree_io_decompress_state_t* state,
+                                              iree_host_size_t i) {
+  const uint64_t chunk_begin =
+      i ? iree_io_decompress_chunk_end(state, i - 1) : 0;
+  const uint64_t chunk_end = iree_io_decompress_chunk_end(state, i);
+  const iree_host_size_t chunk_length =
+      (iree_host_size_t)(chunk_end - chunk_begin);
+  const iree_host_size_t target_offset =
+      i * (iree_host_size_t)state->header.chunk_size;
+  const iree_host_size_t target_length =
+      iree_min((iree_host_size_t)state->header.chunk_size,
+               (iree_host_size_t)state->header.length - target_offset);
+  const uint8_t* chunk = state->chunk_data + chunk_begin;
+  uint8_t* target = state->target + target_offset;
+  if (chunk_length == target_length) {
+    memcpy(target, chunk, chunk_length);  // stored uncompressed
+    return iree_ok_status();
+  }
+  return iree_io_lz4_decompress_block(chunk, chunk_length, target,
+                                      target_length);
+}
+
+static void iree_io_decompress_run(iree_io_decompress_state_t* state) {
+  while (!iree_atomic_load_int32(&state->failed, iree_memory_order_acquire)) {
+    const iree_host_size_t i = (iree_host_size_t)iree_atomic_fetch_add_intptr(
+        &state->next_chunk, 1, iree_memory_order_relaxed);
+    if (i >= state->header.chunk_count) break;
+    iree_status_t status = iree_io_decompress_chunk(state, i);
+    if (!iree_status_is_ok(status)) {
+      status = iree_status_annotate_f(status, "decompressing chunk %" PRIhsz,
+                                      i);
+      iree_slim_mutex_lock(&state->mutex);
+      if (iree_status_is_ok(state->status)) {
+        state->status = status;
+      } else {
+        iree_status_ignore(status);
+      }
+      iree_slim_mutex_unlock(&state->mutex);
+      iree_atomic_store_int32(&state->failed, 1, iree_memory_order_release);
+      break;
+    }
+  }
+}
+
+static int iree_io_decompress_worker(void* user_data) {
+  iree_io_decompress_state_t* state = (iree_io_decompress_state_t*)user_data;
+  iree_atomic_fetch_add_int32(&state->started_count, 1,
+                              iree_memory_order_acq_rel);
+  iree_notification_post(&state->started_notification, IREE_ALL_WAITERS);
+  iree_io_decompress_run(state);
+  return 0;
+}
+
+typedef struct iree_io_decompress_started_args_t {
+  iree_io_decompress_state_t* state;
+  int32_t thread_count;
+} iree_io_decompress_started_args_t;
+
+static bool iree_io_decompress_all_started(void* arg) {
+  iree_io_decompress_started_args_t* args =
+      (iree_io_decompress_started_args_t*)arg;
+  return iree_atomic_load_int32(&args->state->started_count,
+                                iree_memory_order_acquire) >=
+         args->thread_count;
+}
+
+// Validates the blob header and chunk table against the |blob| and |target|
+// sizes such that chunks can be decompressed without further range checks.
+static iree_status_t iree_io_decompress_verify(
+    iree_const_byte_span_t blob, iree_byte_span_t target,
+    iree_io_decompress_state_t* state) {
+  if (blob.data_length < sizeof(state->header)) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "compressed blob truncated before header");
+  }
+  memcpy(&state->header, blob.data, sizeof(state->header));
+  const iree_io_compressed_blob_header_t* header = &state->header;
+  if (header->magic != IREE_IO_COMPRESSED_BLOB_MAGIC) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "compressed blob magic mismatch");
+  }
+  if (header->compression != IREE_IO_COMPRESSION_TYPE_LZ4) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "unsupported compression type %u",
+                            header->compression);
+  }
+  if (header->length != target.data_length) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "compressed blob decompresses to %" PRIu64
+                            " bytes but target is %" PRIhsz,
+                            header->length, target.data_length);
+  }
+  if (header->chunk_size == 0 || header->chunk_size > IREE_HOST_SIZE_MAX ||
+      header->chunk_count !=
+          (header->length + header->chunk_size - 1) / header->chunk_size) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "compressed blob chunking invalid (%" PRIu64
+                            " chunks of %" PRIu64 " bytes for %" PRIu64 ")",
+                            header->chunk_count, header->chunk_size,
+                            header->length);
+  }
+  const uint64_t available = blob.data_length - sizeof(*header);
+  if (header->chunk_count > available / sizeof(uint64_t)) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "compressed blob truncated in chunk table");
+  }
+  state->chunk_ends = blob.data + sizeof(*header);
+  state->chunk_data =
+      state->chunk_ends + header->chunk_count * sizeof(uint64_t);
+  const uint64_t chunk_data_length =
+      available - header->chunk_count * sizeof(uint64_t);
+  uint64_t chunk_begin = 0;
+  for (iree_host_size_t i = 0; i < header->chunk_count; ++i) {
+    const uint64_t chunk_end = iree_io_decompress_chunk_end(state, i);
+    const uint64_t target_length =
+        iree_min(header->chunk_size, header->length - i * header->chunk_size);
+    if (chunk_end < chunk_begin || chunk_end > chunk_data_length ||
+        chunk_end - chunk_begin > target_length) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "compressed blob chunk %" PRIhsz
+                              " range invalid",
+                              i);
+    }
+    chunk_begin = chunk_end;
+  }
+  state->target = target.data;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_decompress(
+    iree_const_byte_span_t blob, iree_byte_span_t target,
+    iree_host_size_t concurrency, iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)target.data_length);
+
+  iree_io_decompress_state_t state;
+  memset(&state, 0, sizeof(state));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_decompress_verify(blob, target, &state));
+  state.status = iree_ok_status();
+  iree_atomic_store_intptr(&state.next_chunk, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&state.failed, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&state.started_count, 0, iree_memory_order_relaxed);
+  iree_notification_initialize(&state.started_notification);
+  iree_slim_mutex_initialize(&state.mutex);
+
+  // Spin up additional workers; the calling thread also acts as a worker so
+  // a concurrency of 1 (or a single chunk) decompresses inline. If we fail to
+  // create a thread we continue with whatever workers we have.
+  const iree_host_size_t thread_count =
+      iree_min(iree_min(iree_max(concurrency, 1),
+                        IREE_IO_COMPRESSION_MAX_CONCURRENCY),
+               (iree_host_size_t)state.header.chunk_count) -
+      (state.header.chunk_count ? 1 : 0);
+  iree_thread_t* threads[IREE_IO_COMPRESSION_MAX_CONCURRENCY] = {0};
+  iree_host_size_t live_thread_count = 0;
+  for (iree_host_size_t i = 0; i < thread_count; ++i) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = IREE_SV("iree-io-decompress");
+    iree_status_t status =
+        iree_thread_create(iree_io_decompress_worker, &state, params,
+                           host_allocator, &threads[live_thread_count]);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      break;
+    }
+    ++live_thread_count;
+  }
+  iree_io_decompress_run(&state);
+
+  // A thread that has not yet started holds its own reference and would be
+  // detached instead of joined when we release ours so wait for all of them to
+  // start before releasing (which then joins them).
+  iree_io_decompress_started_args_t started_args = {
+      .state = &state,
+      .thread_count = (int32_t)live_thread_count,
+  };
+  iree_notification_await(&state.started_notification,
+                          iree_io_decompress_all_started, &started_args,
+                          iree_infinite_timeout());
+  for (iree_host_size_t i = 0; i < live_thread_count; ++i) {
+    iree_thread_release(threads[i]);
+  }
+  iree_notification_deinitialize(&state.started_notification);
+  iree_slim_mutex_deinitialize(&state.mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return state.status;
+}
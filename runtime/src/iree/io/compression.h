@@ -0,0 +1,97 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_COMPRESSION_H_
+#define IREE_IO_COMPRESSION_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Chunked compressed blobs
+//===----------------------------------------------------------------------===//
+//
+// Parameter contents may be stored compressed as a blob of independently
+// compressed chunks such that decompression can be split across threads and
+// written directly into the final destination memory without any intermediate
+// copies of the full uncompressed contents.
+//
+// Blob layout (little-endian):
+//   iree_io_compressed_blob_header_t header;
+//   uint64_t chunk_ends[header.chunk_count];
+//   uint8_t chunk_data[];
+//
+// Each chunk decompresses to header.chunk_size bytes except for the last which
+// contains the remainder. chunk_ends[i] is the end offset of chunk i in
+// chunk_data (chunk i begins at chunk_ends[i - 1] or 0). Chunks that did not
+// compress are stored uncompressed and are identified by a stored length equal
+// to their decompressed length.
+
+// Compression algorithm used for the chunks of a compressed blob.
+typedef enum iree_io_compression_type_e {
+  // Contents are stored uncompressed.
+  IREE_IO_COMPRESSION_TYPE_NONE = 0u,
+  // Each chunk is an LZ4 block (https://github.com/lz4/lz4, block format only):
+  // fast to decompress with a moderate compression ratio.
+  IREE_IO_COMPRESSION_TYPE_LZ4 = 1u,
+} iree_io_compression_type_t;
+
+// Compressed blob magic identifier.
+// "IRPZ" = 0x49 0x52 0x50 0x5A
+#define IREE_IO_COMPRESSED_BLOB_MAGIC 0x5A505249u
+
+// Default decompressed size of each chunk. Large enough to amortize per-chunk
+// overheads and small enough that parameters of a few MB still decompress in
+// parallel.
+#define IREE_IO_COMPRESSION_DEFAULT_CHUNK_SIZE (1 * 1024 * 1024)
+
+// Maximum number of threads used to decompress a single blob.
+#define IREE_IO_COMPRESSION_MAX_CONCURRENCY 16
+
+typedef struct iree_io_compressed_blob_header_t {
+  // Magic header bytes; must be IREE_IO_COMPRESSED_BLOB_MAGIC.
+  uint32_t magic;
+  // iree_io_compression_type_t used for all chunks.
+  uint32_t compression;
+  // Total decompressed length of the blob in bytes.
+  uint64_t length;
+  // Decompressed length of each chunk in bytes (except the last).
+  uint64_t chunk_size;
+  // Total number of chunks in the blob.
+  uint64_t chunk_count;
+} iree_io_compressed_blob_header_t;
+
+// Parses a compression type from a name such as `none` or `lz4`.
+IREE_API_EXPORT iree_status_t iree_io_compression_type_parse(
+    iree_string_view_t name, iree_io_compression_type_t* out_type);
+
+// Compresses |source| into a new blob with chunks of |chunk_size| bytes (or
+// IREE_IO_COMPRESSION_DEFAULT_CHUNK_SIZE if 0) using |type|.
+// The blob is allocated from |host_allocator| and returned in |out_blob|; the
+// caller must free it with the same allocator.
+IREE_API_EXPORT iree_status_t iree_io_compress(
+    iree_io_compression_type_t type, iree_host_size_t chunk_size,
+    iree_const_byte_span_t source, iree_allocator_t host_allocator,
+    iree_byte_span_t* out_blob);
+
+// Decompresses the compressed |blob| into |target|, which must be exactly the
+// decompressed length. Chunks are decompressed using up to |concurrency|
+// threads (including the calling thread). The blob is fully validated and
+// malformed blobs fail without reading or writing out of bounds.
+IREE_API_EXPORT iree_status_t iree_io_decompress(
+    iree_const_byte_span_t blob, iree_byte_span_t target,
+    iree_host_size_t concurrency, iree_allocator_t host_allocator);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_COMPRESSION_H_
@@ -0,0 +1,169 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/compression.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+// Compresses |source| and returns the blob contents.
+static std::vector<uint8_t> Compress(const std::vector<uint8_t>& source,
+                                     iree_host_size_t chunk_size) {
+  iree_byte_span_t blob = iree_make_byte_span(NULL, 0);
+  IREE_CHECK_OK(iree_io_compress(
+      IREE_IO_COMPRESSION_TYPE_LZ4, chunk_size,
+      iree_make_const_byte_span(source.data(), source.size()),
+      iree_allocator_system(), &blob));
+  std::vector<uint8_t> result(blob.data, blob.data + blob.data_length);
+  iree_allocator_free(iree_allocator_system(), blob.data);
+  return result;
+}
+
+static iree_status_t Decompress(const std::vector<uint8_t>& blob,
+                                std::vector<uint8_t>& target,
+                                iree_host_size_t concurrency) {
+  return iree_io_decompress(
+      iree_make_const_byte_span(blob.data(), blob.size()),
+      iree_make_byte_span(target.data(), target.size()), concurrency,
+      iree_allocator_system());
+}
+
+// Returns |length| bytes of moderately compressible data.
+static std::vector<uint8_t> MakeCompressible(size_t length) {
+  std::vector<uint8_t> data(length);
+  for (size_t i = 0; i < length; ++i) {
+    data[i] = (uint8_t)((i / 7) % 13 + (i % 3));
+  }
+  return data;
+}
+
+static std::vector<uint8_t> MakeRandom(size_t length) {
+  std::mt19937 rng(1234);
+  std::vector<uint8_t> data(length);
+  for (auto& value : data) value = (uint8_t)rng();
+  return data;
+}
+
+TEST(CompressionTest, ParseType) {
+  iree_io_compression_type_t type = IREE_IO_COMPRESSION_TYPE_LZ4;
+  IREE_ASSERT_OK(iree_io_compression_type_parse(IREE_SV("none"), &type));
+  EXPECT_EQ(type, IREE_IO_COMPRESSION_TYPE_NONE);
+  IREE_ASSERT_OK(iree_io_compression_type_parse(IREE_SV("lz4"), &type));
+  EXPECT_EQ(type, IREE_IO_COMPRESSION_TYPE_LZ4);
+  EXPECT_THAT(Status(iree_io_compression_type_parse(IREE_SV("zip"), &type)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(CompressionTest, RoundTripEmpty) {
+  std::vector<uint8_t> source;
+  auto blob = Compress(source, 0);
+  std::vector<uint8_t> target;
+  IREE_ASSERT_OK(Decompress(blob, target, 4));
+}
+
+TEST(CompressionTest, RoundTripSmall) {
+  std::vector<uint8_t> source = {1, 2, 3};
+  auto blob = Compress(source, 0);
+  std::vector<uint8_t> target(source.size());
+  IREE_ASSERT_OK(Decompress(blob, target, 1));
+  EXPECT_EQ(target, source);
+}
+
+TEST(CompressionTest, RoundTripCompressible) {
+  auto source = MakeCompressible(100 * 1024);
+  auto blob = Compress(source, 0);
+  EXPECT_LT(blob.size(), source.size() / 4);
+  std::vector<uint8_t> target(source.size());
+  IREE_ASSERT_OK(Decompress(blob, target, 1));
+  EXPECT_EQ(target, source);
+}
+
+TEST(CompressionTest, RoundTripRuns) {
+  // Long runs produce overlapping matches and extended lengths.
+  std::vector<uint8_t> source(70000, 0xCD);
+  for (size_t i = 30000; i < 30100; ++i) source[i] = (uint8_t)i;
+  auto blob = Compress(source, 0);
+  EXPECT_LT(blob.size(), 1024);
+  std::vector<uint8_t> target(source.size());
+  IREE_ASSERT_OK(Decompress(blob, target, 1));
+  EXPECT_EQ(target, source);
+}
+
+TEST(CompressionTest, RoundTripIncompressible) {
+  auto source = MakeRandom(10000);
+  auto blob = Compress(source, 4096);
+  // Chunks are stored raw so overhead is only the header and chunk table.
+  EXPECT_EQ(blob.size(), sizeof(iree_io_compressed_blob_header_t) +
+                             3 * sizeof(uint64_t) + source.size());
+  std::vector<uint8_t> target(source.size());
+  IREE_ASSERT_OK(Decompress(blob, target, 2));
+  EXPECT_EQ(target, source);
+}
+
+TEST(CompressionTest, ParallelChunks) {
+  auto source = MakeCompressible(1024 * 1024 + 123);
+  auto random = MakeRandom(64 * 1024);
+  std::memcpy(source.data() + 4096, random.data(), random.size());
+  auto blob = Compress(source, 16 * 1024);
+  std::vector<uint8_t> target(source.size());
+  IREE_ASSERT_OK(Decompress(blob, target, 8));
+  EXPECT_EQ(target, source);
+}
+
+TEST(CompressionTest, TargetLengthMismatch) {
+  auto source = MakeCompressible(1000);
+  auto blob = Compress(source, 0);
+  std::vector<uint8_t> target(source.size() - 1);
+  EXPECT_THAT(Status(Decompress(blob, target, 1)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(CompressionTest, Truncated) {
+  auto source = MakeCompressible(64 * 1024);
+  auto blob = Compress(source, 8 * 1024);
+  std::vector<uint8_t> target(source.size());
+  for (size_t length : {(size_t)0, sizeof(iree_io_compressed_blob_header_t),
+                        blob.size() / 2, blob.size() - 1}) {
+    std::vector<uint8_t> truncated(blob.begin(), blob.begin() + length);
+    EXPECT_THAT(Status(Decompress(truncated, target, 4)),
+                StatusIs(StatusCode::kDataLoss));
+  }
+}
+
+TEST(CompressionTest, CorruptChunks) {
+  auto source = MakeCompressible(64 * 1024);
+  auto blob = Compress(source, 8 * 1024);
+  std::vector<uint8_t> target(source.size());
+  // Flipping bytes in chunk data must never read or write out of bounds; it
+  // either fails or produces garbage of the right length.
+  const size_t data_offset =
+      sizeof(iree_io_compressed_blob_header_t) + 8 * sizeof(uint64_t);
+  std::mt19937 rng(42);
+  for (int i = 0; i < 256; ++i) {
+    auto corrupt = blob;
+    size_t offset = data_offset + rng() % (corrupt.size() - data_offset);
+    corrupt[offset] ^= (uint8_t)(1 + rng() % 255);
+    iree_status_ignore(Decompress(corrupt, target, 4));
+  }
+  // Corrupting the magic is always detected.
+  auto corrupt = blob;
+  corrupt[0] ^= 0xFF;
+  EXPECT_THAT(Status(Decompress(corrupt, target, 1)),
+              StatusIs(StatusCode::kDataLoss));
+}
+
+}  // namespace
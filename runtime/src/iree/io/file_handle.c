@@ -4,11 +4,36 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+// Needed for O_DIRECT on Linux. On other platforms does nothing.
+#define _GNU_SOURCE
+
 #include "iree/io/file_handle.h"
 
 #include "iree/base/internal/atomics.h"
 #include "iree/io/memory_stream.h"
 
+#if IREE_FILE_IO_ENABLE && !defined(IREE_PLATFORM_WINDOWS) && \
+    !defined(IREE_PLATFORM_EMSCRIPTEN) && !defined(IREE_PLATFORM_GENERIC)
+#define IREE_IO_FILE_HANDLE_HAVE_FD 1
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // IREE_FILE_IO_ENABLE && posix
+
+#if defined(IREE_IO_FILE_HANDLE_HAVE_FD) && \
+    (defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID))
+#define IREE_IO_FILE_HANDLE_HAVE_PREADV 1
+#include <sys/uio.h>
+#endif  // IREE_IO_FILE_HANDLE_HAVE_FD && linux
+
+#if !defined(IREE_PLATFORM_WINDOWS) && !defined(IREE_PLATFORM_EMSCRIPTEN) && \
+    !defined(IREE_PLATFORM_GENERIC)
+#define IREE_IO_FILE_HANDLE_HAVE_MADVISE 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // posix
+
 //===----------------------------------------------------------------------===//
 // iree_io_file_handle_t
 //===----------------------------------------------------------------------===//
@@ -60,6 +85,118 @@ IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_host_allocation(
                                   release_callback, host_allocator, out_handle);
 }
 
+IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_fd(
+    iree_io_file_access_t allowed_access, int fd,
+    iree_io_file_handle_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle) {
+  iree_io_file_handle_primitive_t handle_primitive = {
+      .type = IREE_IO_FILE_HANDLE_TYPE_FD,
+      .value =
+          {
+              .fd = fd,
+          },
+  };
+  return iree_io_file_handle_wrap(allowed_access, handle_primitive,
+                                  release_callback, host_allocator, out_handle);
+}
+
+#if defined(IREE_IO_FILE_HANDLE_HAVE_FD)
+
+#define IREE_MAX_PATH ((size_t)2048)
+
+static void iree_io_file_handle_fd_close(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  close(handle_primitive.value.fd);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_open_fd(
+    iree_io_file_access_t allowed_access, iree_io_file_open_flags_t flags,
+    iree_string_view_t path, iree_allocator_t host_allocator,
+    iree_io_file_handle_t** out_handle) {
+  IREE_ASSERT_ARGUMENT(out_handle);
+  *out_handle = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, path.data, path.size);
+
+  int open_flags = O_CLOEXEC;
+  if (iree_all_bits_set(allowed_access, IREE_IO_FILE_ACCESS_READ |
+                                            IREE_IO_FILE_ACCESS_WRITE)) {
+    open_flags |= O_RDWR;
+  } else if (iree_all_bits_set(allowed_access, IREE_IO_FILE_ACCESS_WRITE)) {
+    open_flags |= O_WRONLY;
+  } else {
+    open_flags |= O_RDONLY;
+  }
+  if (iree_all_bits_set(flags, IREE_IO_FILE_OPEN_FLAG_DISCARD)) {
+    if (!iree_all_bits_set(allowed_access, IREE_IO_FILE_ACCESS_WRITE)) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "discarding file contents requires write access");
+    }
+    open_flags |= O_CREAT | O_TRUNC;
+  }
+  if (iree_all_bits_set(flags, IREE_IO_FILE_OPEN_FLAG_DIRECT)) {
+#if defined(O_DIRECT)
+    open_flags |= O_DIRECT;
+#else
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "direct (uncached) file I/O not available on this "
+                            "platform");
+#endif  // O_DIRECT
+  }
+
+  // Since we stack alloc the path we want to keep it reasonable.
+  if (path.size > IREE_MAX_PATH) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "path exceeds reasonable maximum (%" PRIhsz
+                            " > %" PRIhsz ")",
+                            path.size, IREE_MAX_PATH);
+  }
+  char* open_path = (char*)iree_alloca(path.size + 1);
+  memcpy(open_path, path.data, path.size);
+  open_path[path.size] = 0;  // NUL
+
+  int fd = -1;
+  do {
+    fd = open(open_path, open_flags, 0644);
+  } while (fd == -1 && errno == EINTR);
+  if (fd == -1) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "unable to open file `%.*s` (%d)", (int)path.size,
+                            path.data, errno);
+  }
+
+  iree_io_file_handle_release_callback_t release_callback = {
+      .fn = iree_io_file_handle_fd_close,
+      .user_data = NULL,
+  };
+  iree_status_t status = iree_io_file_handle_wrap_fd(
+      allowed_access, fd, release_callback, host_allocator, out_handle);
+  if (!iree_status_is_ok(status)) close(fd);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#else
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_open_fd(
+    iree_io_file_access_t allowed_access, iree_io_file_open_flags_t flags,
+    iree_string_view_t path, iree_allocator_t host_allocator,
+    iree_io_file_handle_t** out_handle) {
+  IREE_ASSERT_ARGUMENT(out_handle);
+  *out_handle = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file descriptor support is not available in this "
+                          "binary; set IREE_FILE_IO_ENABLE=1 on a POSIX "
+                          "platform to include it");
+}
+
+#endif  // IREE_IO_FILE_HANDLE_HAVE_FD
+
 static void iree_io_file_handle_destroy(iree_io_file_handle_t* handle) {
   IREE_ASSERT_ARGUMENT(handle);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -111,6 +248,16 @@ iree_io_file_handle_flush(iree_io_file_handle_t* handle) {
       // No-op (though we could flush when known mapped).
       break;
     }
+#if defined(IREE_IO_FILE_HANDLE_HAVE_FD)
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+      if (fsync(handle->primitive.value.fd) != 0) {
+        status = iree_make_status(iree_status_code_from_errno(errno),
+                                  "failed to flush file descriptor (%d)",
+                                  errno);
+      }
+      break;
+    }
+#endif  // IREE_IO_FILE_HANDLE_HAVE_FD
     default: {
       status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                 "flush not supported on handle type %d",
@@ -122,6 +269,590 @@ iree_io_file_handle_flush(iree_io_file_handle_t* handle) {
   return status;
 }
 
+// Size of the bounce buffer used when copying between file descriptors when no
+// kernel copy path is available.
+#define IREE_IO_FILE_HANDLE_COPY_CHUNK_SIZE (4 * 1024 * 1024)
+
+// Maximum number of bytes transferred per read/write/copy system call; some
+// platforms reject or truncate larger requests.
+#define IREE_IO_FILE_HANDLE_MAX_IO_SIZE (1024 * 1024 * 1024)
+
+#if defined(IREE_IO_FILE_HANDLE_HAVE_FD)
+
+// Reads exactly |length| bytes from |fd| at |offset| into |buffer|.
+static iree_status_t iree_io_fd_pread_all(int fd, uint64_t offset,
+                                          uint64_t length, uint8_t* buffer) {
+  while (length > 0) {
+    const size_t chunk_length =
+        (size_t)iree_min(length, IREE_IO_FILE_HANDLE_MAX_IO_SIZE);
+    ssize_t read_length = pread(fd, buffer, chunk_length, (off_t)offset);
+    if (read_length < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to read %" PRIhsz
+                              " bytes at offset %" PRIu64 " (%d)",
+                              chunk_length, offset, errno);
+    } else if (read_length == 0) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "unexpected end of file reading offset %" PRIu64,
+                              offset);
+    }
+    buffer += read_length;
+    offset += read_length;
+    length -= read_length;
+  }
+  return iree_ok_status();
+}
+
+// Writes exactly |length| bytes from |buffer| to |fd| at |offset|.
+static iree_status_t iree_io_fd_pwrite_all(int fd, uint64_t offset,
+                                           uint64_t length,
+                                           const uint8_t* buffer) {
+  while (length > 0) {
+    const size_t chunk_length =
+        (size_t)iree_min(length, IREE_IO_FILE_HANDLE_MAX_IO_SIZE);
+    ssize_t write_length = pwrite(fd, buffer, chunk_length, (off_t)offset);
+    if (write_length < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to write %" PRIhsz
+                              " bytes at offset %" PRIu64 " (%d)",
+                              chunk_length, offset, errno);
+    }
+    buffer += write_length;
+    offset += write_length;
+    length -= write_length;
+  }
+  return iree_ok_status();
+}
+
+// Copies |length| bytes between file descriptors.
+// Tries to use copy_file_range to keep data in the kernel (and let filesystems
+// that support it share extents) and otherwise falls back to a bounce buffer.
+static iree_status_t iree_io_fd_copy_range(int source_fd,
+                                           uint64_t source_offset,
+                                           int target_fd,
+                                           uint64_t target_offset,
+                                           uint64_t length,
+                                           iree_allocator_t host_allocator) {
+#if defined(IREE_PLATFORM_LINUX) && !defined(IREE_PLATFORM_ANDROID)
+  while (length > 0) {
+    off_t source_pos = (off_t)source_offset;
+    off_t target_pos = (off_t)target_offset;
+    ssize_t copied_length = copy_file_range(
+        source_fd, &source_pos, target_fd, &target_pos,
+        (size_t)iree_min(length, IREE_IO_FILE_HANDLE_MAX_IO_SIZE), 0);
+    if (copied_length < 0) {
+      if (errno == EINTR) continue;
+      if (errno == ENOSYS || errno == EXDEV || errno == EINVAL ||
+          errno == EOPNOTSUPP || errno == EBADF) {
+        // Not supported between these files; fall back to the slow path for
+        // the remainder of the range.
+        break;
+      }
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to copy file range (%d)", errno);
+    } else if (copied_length == 0) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "unexpected end of file copying offset %" PRIu64,
+                              source_offset);
+    }
+    source_offset += copied_length;
+    target_offset += copied_length;
+    length -= copied_length;
+  }
+  if (length == 0) return iree_ok_status();
+#endif  // IREE_PLATFORM_LINUX && !IREE_PLATFORM_ANDROID
+
+  const iree_host_size_t buffer_capacity =
+      (iree_host_size_t)iree_min(length, IREE_IO_FILE_HANDLE_COPY_CHUNK_SIZE);
+  uint8_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc_uninitialized(host_allocator, buffer_capacity,
+                                          (void**)&buffer));
+  iree_status_t status = iree_ok_status();
+  while (iree_status_is_ok(status) && length > 0) {
+    const uint64_t chunk_length = iree_min(length, buffer_capacity);
+    status = iree_io_fd_pread_all(source_fd, source_offset, chunk_length,
+                                  buffer);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_fd_pwrite_all(target_fd, target_offset, chunk_length,
+                                     buffer);
+    }
+    source_offset += chunk_length;
+    target_offset += chunk_length;
+    length -= chunk_length;
+  }
+  iree_allocator_free(host_allocator, buffer);
+  return status;
+}
+
+#endif  // IREE_IO_FILE_HANDLE_HAVE_FD
+
+// Returns the host memory range [offset, offset+length) of |primitive|.
+static iree_status_t iree_io_file_handle_host_range(
+    iree_io_file_handle_primitive_t primitive, uint64_t offset,
+    uint64_t length, uint8_t** out_ptr) {
+  iree_byte_span_t host_allocation = primitive.value.host_allocation;
+  if (offset > host_allocation.data_length ||
+      length > host_allocation.data_length - offset) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "range [%" PRIu64 ", %" PRIu64
+        ") out of bounds of host allocation with %" PRIhsz " bytes",
+        offset, offset + length, host_allocation.data_length);
+  }
+  *out_ptr = host_allocation.data + offset;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_file_handle_copy_range(
+    iree_io_file_handle_t* source_handle, uint64_t source_offset,
+    iree_io_file_handle_t* target_handle, uint64_t target_offset,
+    uint64_t length, iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(source_handle);
+  IREE_ASSERT_ARGUMENT(target_handle);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+
+  const iree_io_file_handle_primitive_t source = source_handle->primitive;
+  const iree_io_file_handle_primitive_t target = target_handle->primitive;
+  iree_status_t status = iree_ok_status();
+  uint8_t* source_ptr = NULL;
+  uint8_t* target_ptr = NULL;
+  if (source.type == IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION &&
+      target.type == IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    status = iree_io_file_handle_host_range(source, source_offset, length,
+                                            &source_ptr);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_file_handle_host_range(target, target_offset, length,
+                                              &target_ptr);
+    }
+    if (iree_status_is_ok(status)) {
+      memcpy(target_ptr, source_ptr, (iree_host_size_t)length);
+    }
+#if defined(IREE_IO_FILE_HANDLE_HAVE_FD)
+  } else if (source.type == IREE_IO_FILE_HANDLE_TYPE_FD &&
+             target.type == IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    status = iree_io_file_handle_host_range(target, target_offset, length,
+                                            &target_ptr);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_fd_pread_all(source.value.fd, source_offset, length,
+                                    target_ptr);
+    }
+  } else if (source.type == IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION &&
+             target.type == IREE_IO_FILE_HANDLE_TYPE_FD) {
+    status = iree_io_file_handle_host_range(source, source_offset, length,
+                                            &source_ptr);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_fd_pwrite_all(target.value.fd, target_offset, length,
+                                     source_ptr);
+    }
+  } else if (source.type == IREE_IO_FILE_HANDLE_TYPE_FD &&
+             target.type == IREE_IO_FILE_HANDLE_TYPE_FD) {
+    status = iree_io_fd_copy_range(source.value.fd, source_offset,
+                                   target.value.fd, target_offset, length,
+                                   host_allocator);
+#endif  // IREE_IO_FILE_HANDLE_HAVE_FD
+  } else {
+    status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "copy not supported from handle type %d to %d",
+                              (int)source.type, (int)target.type);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_io_file_handle_prefetch(
+    iree_io_file_handle_t* handle, uint64_t offset, uint64_t length) {
+  IREE_ASSERT_ARGUMENT(handle);
+  if (length == 0) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+  switch (handle->primitive.type) {
+#if defined(IREE_IO_FILE_HANDLE_HAVE_MADVISE) && defined(MADV_WILLNEED)
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION: {
+      iree_byte_span_t allocation = handle->primitive.value.host_allocation;
+      if (offset >= allocation.data_length) break;
+      length = iree_min(length, allocation.data_length - offset);
+      // madvise requires page-aligned addresses; the rounded range may extend
+      // beyond the allocation but stays within its pages.
+      const uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+      const uintptr_t begin = (uintptr_t)allocation.data + (uintptr_t)offset;
+      const uintptr_t aligned_begin = begin & ~(page_size - 1);
+      // Not all host allocations are mapped (or mapped by us) and failures are
+      // harmless as this is only a hint.
+      (void)madvise((void*)aligned_begin,
+                    (size_t)(begin - aligned_begin + length), MADV_WILLNEED);
+      break;
+    }
+#endif  // IREE_IO_FILE_HANDLE_HAVE_MADVISE
+#if defined(IREE_IO_FILE_HANDLE_HAVE_FD) && defined(POSIX_FADV_WILLNEED)
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+      (void)posix_fadvise(handle->primitive.value.fd, (off_t)offset,
+                          (off_t)length, POSIX_FADV_WILLNEED);
+      break;
+    }
+#endif  // IREE_IO_FILE_HANDLE_HAVE_FD
+    default:
+      break;
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_fd_stream_t
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_IO_FILE_HANDLE_HAVE_FD)
+
+// A stream over a file descriptor using positional reads and writes so that
+// multiple streams may share the same descriptor without affecting each other.
+typedef struct iree_io_fd_stream_t {
+  iree_io_stream_t base;
+  iree_allocator_t host_allocator;
+  // Retained file handle owning |fd|.
+  iree_io_file_handle_t* file_handle;
+  int fd;
+  // Absolute file offset of stream position 0.
+  uint64_t file_offset;
+  iree_io_stream_pos_t offset;
+  iree_io_stream_pos_t length;
+} iree_io_fd_stream_t;
+
+static const iree_io_stream_vtable_t iree_io_fd_stream_vtable;
+
+static iree_io_fd_stream_t* iree_io_fd_stream_cast(
+    iree_io_stream_t* IREE_RESTRICT base_stream) {
+  return (iree_io_fd_stream_t*)base_stream;
+}
+
+static iree_status_t iree_io_fd_stream_open(iree_io_stream_mode_t mode,
+                                            iree_io_file_handle_t* file_handle,
+                                            uint64_t file_offset,
+                                            iree_allocator_t host_allocator,
+                                            iree_io_stream_t** out_stream) {
+  *out_stream = NULL;
+  int fd = iree_io_file_handle_primitive(file_handle).value.fd;
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "unable to query file size (%d)", errno);
+  }
+  if (file_offset > (uint64_t)file_stat.st_size) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "file offset %" PRIu64
+                            " out of range of file with %" PRIu64
+                            " bytes available",
+                            file_offset, (uint64_t)file_stat.st_size);
+  }
+
+  iree_io_fd_stream_t* stream = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, sizeof(*stream), (void**)&stream));
+  iree_atomic_ref_count_init(&stream->base.ref_count);
+  stream->base.vtable = &iree_io_fd_stream_vtable;
+  stream->base.mode = mode;
+  stream->host_allocator = host_allocator;
+  stream->file_handle = file_handle;
+  iree_io_file_handle_retain(file_handle);
+  stream->fd = fd;
+  stream->file_offset = file_offset;
+  stream->offset = 0;
+  stream->length = (iree_io_stream_pos_t)(file_stat.st_size - file_offset);
+
+  *out_stream = &stream->base;
+  return iree_ok_status();
+}
+
+static void iree_io_fd_stream_destroy(
+    iree_io_stream_t* IREE_RESTRICT base_stream) {
+  iree_io_fd_stream_t* stream = iree_io_fd_stream_cast(base_stream);
+  iree_allocator_t host_allocator = stream->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_io_file_handle_release(stream->file_handle);
+  iree_allocator_free(host_allocator, stream);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_io_stream_pos_t iree_io_fd_stream_offset(
+    iree_io_stream_t* base_stream) {
+  return iree_io_fd_stream_cast(base_stream)->offset;
+}
+
+static iree_io_stream_pos_t iree_io_fd_stream_length(
+    iree_io_stream_t* base_stream) {
+  return iree_io_fd_stream_cast(base_stream)->length;
+}
+
+static iree_status_t iree_io_fd_stream_seek(
+    iree_io_stream_t* base_stream, iree_io_stream_seek_mode_t seek_mode,
+    iree_io_stream_pos_t seek_offset) {
+  iree_io_fd_stream_t* stream = iree_io_fd_stream_cast(base_stream);
+  iree_io_stream_pos_t new_offset = stream->offset;
+  switch (seek_mode) {
+    case IREE_IO_STREAM_SEEK_SET:
+      new_offset = seek_offset;
+      break;
+    case IREE_IO_STREAM_SEEK_FROM_CURRENT:
+      new_offset = stream->offset + seek_offset;
+      break;
+    case IREE_IO_STREAM_SEEK_FROM_END:
+      new_offset = stream->length + seek_offset;
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unrecognized seek mode %u", (uint32_t)seek_mode);
+  }
+  if (new_offset < 0 || new_offset > stream->length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "seek offset %" PRIi64
+                            " out of stream bounds; expected 0 <= %" PRIi64
+                            " <= %" PRIi64,
+                            seek_offset, new_offset, stream->length);
+  }
+  stream->offset = new_offset;
+  return iree_ok_status();
+}
+
+// Advances the written end of the stream after a write of |length| bytes.
+static void iree_io_fd_stream_advance_write(iree_io_fd_stream_t* stream,
+                                            uint64_t length) {
+  stream->offset += (iree_io_stream_pos_t)length;
+  stream->length = iree_max(stream->length, stream->offset);
+}
+
+static iree_status_t iree_io_fd_stream_read(
+    iree_io_stream_t* base_stream, iree_host_size_t buffer_capacity,
+    void* buffer, iree_host_size_t* out_buffer_length) {
+  if (out_buffer_length) *out_buffer_length = 0;
+  iree_io_fd_stream_t* stream = iree_io_fd_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t read_length = (iree_host_size_t)iree_min(
+      (iree_io_stream_pos_t)buffer_capacity, stream->length - stream->offset);
+  if (!out_buffer_length && read_length != buffer_capacity) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                             "read of %" PRIhsz
+                             " bytes out of range; stream offset %" PRIu64
+                             " and length %" PRIu64 " insufficient",
+                             buffer_capacity, stream->offset, stream->length));
+  }
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_fd_pread_all(stream->fd, stream->file_offset + stream->offset,
+                               read_length, (uint8_t*)buffer));
+  stream->offset += read_length;
+
+  if (out_buffer_length) *out_buffer_length = read_length;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_io_fd_stream_write(iree_io_stream_t* base_stream,
+                                             iree_host_size_t buffer_length,
+                                             const void* buffer) {
+  iree_io_fd_stream_t* stream = iree_io_fd_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_io_fd_pwrite_all(stream->fd, stream->file_offset + stream->offset,
+                            buffer_length, (const uint8_t*)buffer));
+  iree_io_fd_stream_advance_write(stream, buffer_length);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Size of the block of repeated pattern values written per fill write.
+#define IREE_IO_FD_STREAM_FILL_BLOCK_SIZE 4096
+
+static iree_status_t iree_io_fd_stream_fill(iree_io_stream_t* base_stream,
+                                            iree_io_stream_pos_t count,
+                                            const void* pattern,
+                                            iree_host_size_t pattern_length) {
+  iree_io_fd_stream_t* stream = iree_io_fd_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Pattern lengths are powers of two <= 8 and evenly divide the block.
+  uint8_t block[IREE_IO_FD_STREAM_FILL_BLOCK_SIZE];
+  for (iree_host_size_t i = 0; i < sizeof(block); i += pattern_length) {
+    memcpy(&block[i], pattern, pattern_length);
+  }
+  iree_status_t status = iree_ok_status();
+  uint64_t remaining = (uint64_t)count * pattern_length;
+  while (iree_status_is_ok(status) && remaining > 0) {
+    uint64_t block_length = iree_min(remaining, sizeof(block));
+    status =
+        iree_io_fd_pwrite_all(stream->fd, stream->file_offset + stream->offset,
+                              block_length, block);
+    if (iree_status_is_ok(status)) {
+      iree_io_fd_stream_advance_write(stream, block_length);
+      remaining -= block_length;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_fd_stream_map_read(
+    iree_io_stream_t* stream, iree_host_size_t length,
+    iree_const_byte_span_t* out_span) {
+  return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                          "file descriptor streams do not support mapping");
+}
+
+static iree_status_t iree_io_fd_stream_map_write(
+    iree_io_stream_t* stream, iree_host_size_t length,
+    iree_byte_span_t* out_span) {
+  return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                          "file descriptor streams do not support mapping");
+}
+
+#if defined(IREE_IO_FILE_HANDLE_HAVE_PREADV)
+
+// Maximum number of iovecs passed to a single preadv/pwritev call.
+#define IREE_IO_FD_STREAM_MAX_IOVECS 64
+
+// Transfers |buffers| to or from |fd| at |offset| with preadv/pwritev,
+// resuming after partial transfers. Reads stop early at end-of-file. The number
+// of bytes transferred is returned in |out_total_length| even on failure.
+static iree_status_t iree_io_fd_transfer_vectored(
+    int fd, uint64_t offset, bool is_write, iree_host_size_t buffer_count,
+    const iree_byte_span_t* buffers, uint64_t* out_total_length) {
+  *out_total_length = 0;
+  struct iovec iovecs[IREE_IO_FD_STREAM_MAX_IOVECS];
+  iree_host_size_t buffer_index = 0;
+  iree_host_size_t buffer_offset = 0;
+  while (buffer_index < buffer_count) {
+    // Gather the next batch starting at the partially transferred buffer.
+    int iovec_count = 0;
+    for (iree_host_size_t i = buffer_index;
+         i < buffer_count && iovec_count < IREE_IO_FD_STREAM_MAX_IOVECS; ++i) {
+      iree_host_size_t buffer_start = i == buffer_index ? buffer_offset : 0;
+      iree_host_size_t length = buffers[i].data_length - buffer_start;
+      if (!length) continue;
+      iovecs[iovec_count].iov_base = buffers[i].data + buffer_start;
+      iovecs[iovec_count].iov_len =
+          iree_min(length, IREE_IO_FILE_HANDLE_MAX_IO_SIZE);
+      ++iovec_count;
+    }
+    if (!iovec_count) break;
+
+    const off_t position = (off_t)(offset + *out_total_length);
+    ssize_t result = is_write ? pwritev(fd, iovecs, iovec_count, position)
+                              : preadv(fd, iovecs, iovec_count, position);
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "vectored %s at offset %" PRIu64 " failed (%d)",
+                              is_write ? "write" : "read", (uint64_t)position,
+                              errno);
+    } else if (result == 0) {
+      if (!is_write) break;  // end-of-file
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "vectored write at offset %" PRIu64
+                              " made no progress",
+                              (uint64_t)position);
+    }
+    *out_total_length += (uint64_t)result;
+
+    // Advance the cursor past the transferred bytes and any empty buffers.
+    iree_host_size_t remaining = (iree_host_size_t)result;
+    while (buffer_index < buffer_count) {
+      iree_host_size_t available =
+          buffers[buffer_index].data_length - buffer_offset;
+      if (remaining < available) {
+        buffer_offset += remaining;
+        break;
+      }
+      remaining -= available;
+      ++buffer_index;
+      buffer_offset = 0;
+    }
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_io_fd_stream_readv(
+    iree_io_stream_t* base_stream, iree_host_size_t buffer_count,
+    const iree_byte_span_t* buffers, iree_host_size_t* out_total_length) {
+  if (out_total_length) *out_total_length = 0;
+  iree_io_fd_stream_t* stream = iree_io_fd_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  uint64_t total_capacity = 0;
+  for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+    total_capacity += buffers[i].data_length;
+  }
+  if (!out_total_length &&
+      total_capacity > (uint64_t)(stream->length - stream->offset)) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                             "vectored read of %" PRIu64
+                             " bytes out of range; stream offset %" PRIu64
+                             " and length %" PRIu64 " insufficient",
+                             total_capacity, stream->offset, stream->length));
+  }
+
+  uint64_t total_length = 0;
+  iree_status_t status = iree_io_fd_transfer_vectored(
+      stream->fd, stream->file_offset + stream->offset, /*is_write=*/false,
+      buffer_count, buffers, &total_length);
+  // Bytes past the stream length may exist if the file was extended by another
+  // writer; the stream length is authoritative.
+  total_length =
+      iree_min(total_length, (uint64_t)(stream->length - stream->offset));
+  stream->offset += (iree_io_stream_pos_t)total_length;
+  if (iree_status_is_ok(status) && !out_total_length &&
+      total_length != total_capacity) {
+    status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "unexpected end of file during vectored read");
+  }
+  if (iree_status_is_ok(status) && out_total_length) {
+    *out_total_length = (iree_host_size_t)total_length;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_fd_stream_writev(
+    iree_io_stream_t* base_stream, iree_host_size_t buffer_count,
+    const iree_const_byte_span_t* buffers) {
+  iree_io_fd_stream_t* stream = iree_io_fd_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  uint64_t total_length = 0;
+  iree_status_t status = iree_io_fd_transfer_vectored(
+      stream->fd, stream->file_offset + stream->offset, /*is_write=*/true,
+      buffer_count, (const iree_byte_span_t*)buffers, &total_length);
+  iree_io_fd_stream_advance_write(stream, total_length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#endif  // IREE_IO_FILE_HANDLE_HAVE_PREADV
+
+static const iree_io_stream_vtable_t iree_io_fd_stream_vtable = {
+    .destroy = iree_io_fd_stream_destroy,
+    .offset = iree_io_fd_stream_offset,
+    .length = iree_io_fd_stream_length,
+    .seek = iree_io_fd_stream_seek,
+    .read = iree_io_fd_stream_read,
+    .write = iree_io_fd_stream_write,
+    .fill = iree_io_fd_stream_fill,
+    .map_read = iree_io_fd_stream_map_read,
+    .map_write = iree_io_fd_stream_map_write,
+#if defined(IREE_IO_FILE_HANDLE_HAVE_PREADV)
+    .readv = iree_io_fd_stream_readv,
+    .writev = iree_io_fd_stream_writev,
+#endif  // IREE_IO_FILE_HANDLE_HAVE_PREADV
+};
+
+#endif  // IREE_IO_FILE_HANDLE_HAVE_FD
+
 //===----------------------------------------------------------------------===//
 // iree_io_stream_t utilities
 //===----------------------------------------------------------------------===//
@@ -169,6 +900,13 @@ IREE_API_EXPORT iree_status_t iree_io_stream_open(
       if (!iree_status_is_ok(status)) iree_io_file_handle_release(file_handle);
       break;
     }
+#if defined(IREE_IO_FILE_HANDLE_HAVE_FD)
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+      status = iree_io_fd_stream_open(mode, file_handle, file_offset,
+                                      host_allocator, &stream);
+      break;
+    }
+#endif  // IREE_IO_FILE_HANDLE_HAVE_FD
     default: {
       status =
           iree_make_status(IREE_STATUS_UNIMPLEMENTED,
@@ -46,7 +46,12 @@ typedef enum iree_io_file_handle_type_e {
   // as long as the file handle referencing it.
   IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION = 0u,
 
-  // TODO(benvanik): file descriptor, FILE*, HANDLE, etc.
+  // A POSIX file descriptor opened for positional I/O (pread/pwrite-style).
+  // The file descriptor offset is never used or modified by IREE and the same
+  // descriptor may be shared across multiple concurrent operations.
+  IREE_IO_FILE_HANDLE_TYPE_FD = 1u,
+
+  // TODO(benvanik): FILE*, HANDLE, etc.
 } iree_io_file_handle_type_t;
 
 // A platform handle to a file primitive.
@@ -55,6 +60,8 @@ typedef enum iree_io_file_handle_type_e {
 typedef union iree_io_file_handle_primitive_value_t {
   // IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION
   iree_byte_span_t host_allocation;
+  // IREE_IO_FILE_HANDLE_TYPE_FD
+  int fd;
 } iree_io_file_handle_primitive_value_t;
 
 // A (type, value) pair describing a system file primitive handle.
@@ -112,6 +119,38 @@ IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_host_allocation(
     iree_io_file_handle_release_callback_t release_callback,
     iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle);
 
+// Wraps a POSIX file descriptor |fd| in a reference-counted file handle.
+// |allowed_access| declares which operations are allowed on the handle and may
+// be more restrictive than the mode the descriptor was opened with.
+// The optional provided |release_callback| will be issued when the last
+// reference to the handle is released and may be used to close the descriptor.
+IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_fd(
+    iree_io_file_access_t allowed_access, int fd,
+    iree_io_file_handle_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle);
+
+// Bits controlling how files are opened with iree_io_file_handle_open_fd.
+enum iree_io_file_open_flag_bits_t {
+  IREE_IO_FILE_OPEN_FLAG_NONE = 0u,
+  // Creates the file if it does not exist and truncates it if it does.
+  // Requires IREE_IO_FILE_ACCESS_WRITE.
+  IREE_IO_FILE_OPEN_FLAG_DISCARD = 1u << 0,
+  // Bypasses the OS page cache (O_DIRECT on Linux). All I/O issued against the
+  // resulting handle must use buffers, offsets, and lengths aligned to the
+  // logical block size of the underlying device (usually 512 or 4096 bytes).
+  IREE_IO_FILE_OPEN_FLAG_DIRECT = 1u << 1,
+};
+typedef uint32_t iree_io_file_open_flags_t;
+
+// Opens the file at |path| as a POSIX file descriptor handle with the given
+// |allowed_access|. The descriptor is closed when the handle is released.
+// Returns IREE_STATUS_UNAVAILABLE on platforms without file descriptors or if
+// file I/O has been compiled out.
+IREE_API_EXPORT iree_status_t iree_io_file_handle_open_fd(
+    iree_io_file_access_t allowed_access, iree_io_file_open_flags_t flags,
+    iree_string_view_t path, iree_allocator_t host_allocator,
+    iree_io_file_handle_t** out_handle);
+
 // Retains the file |handle| for the caller.
 IREE_API_EXPORT void iree_io_file_handle_retain(iree_io_file_handle_t* handle);
 
@@ -151,6 +190,29 @@ static inline iree_io_file_handle_primitive_value_t iree_io_file_handle_value(
 IREE_API_EXPORT iree_status_t
 iree_io_file_handle_flush(iree_io_file_handle_t* handle);
 
+// Copies |length| bytes from |source_handle| at |source_offset| to
+// |target_handle| at |target_offset| using the fastest mechanism available for
+// the handle types. Host allocations are copied directly to/from memory and
+// file descriptors use positional I/O; file descriptor to file descriptor
+// copies use copy_file_range where available which allows the kernel to
+// perform the copy without round-tripping through user memory (or to share
+// extents via reflinks on filesystems that support them). |host_allocator| may
+// be used for transient bounce buffers when no direct path is available.
+//
+// Only positional I/O is performed and it is safe to concurrently copy
+// disjoint ranges of the same handles from multiple threads.
+IREE_API_EXPORT iree_status_t iree_io_file_handle_copy_range(
+    iree_io_file_handle_t* source_handle, uint64_t source_offset,
+    iree_io_file_handle_t* target_handle, uint64_t target_offset,
+    uint64_t length, iree_allocator_t host_allocator);
+
+// Hints that the range [offset, offset+length) of |handle| will be read soon
+// such that the platform can begin reading it into memory asynchronously.
+// Mapped host allocations use madvise(MADV_WILLNEED) and file descriptors use
+// posix_fadvise(POSIX_FADV_WILLNEED). Best-effort and ignored if unsupported.
+IREE_API_EXPORT void iree_io_file_handle_prefetch(
+    iree_io_file_handle_t* handle, uint64_t offset, uint64_t length);
+
 //===----------------------------------------------------------------------===//
 // iree_io_stream_t utilities
 //===----------------------------------------------------------------------===//
@@ -7,6 +7,7 @@
 #include "iree/io/formats/gguf/gguf_parser.h"
 
 #include <ctype.h>
+#include <stddef.h>
 
 // File format:
 // https://github.com/ggerganov/ggml/blob/master/docs/gguf.md
@@ -635,10 +636,27 @@ static iree_status_t iree_io_gguf_append_tensor_info(
                             begin, end, parser->tensor_data_size);
   }
 
+  // Attach the tensor description so that consumers (such as parameter
+  // transforms) can interpret the stored contents. Tensors exceeding the
+  // supported rank are left without metadata. Dimensions are unaligned in the
+  // file and must be copied out.
+  iree_io_gguf_tensor_metadata_t metadata = {
+      .magic = IREE_IO_GGUF_TENSOR_METADATA_MAGIC,
+      .type = tensor_info->type,
+      .rank = tensor_info->n_dimensions,
+  };
+  iree_const_byte_span_t metadata_span = iree_const_byte_span_empty();
+  if (tensor_info->n_dimensions <= IREE_IO_GGUF_MAX_TENSOR_RANK) {
+    memcpy(metadata.dims, tensor_info->dimensions,
+           tensor_info->n_dimensions * sizeof(metadata.dims[0]));
+    metadata_span =
+        iree_make_const_byte_span((const uint8_t*)&metadata, sizeof(metadata));
+  }
+
   // Add entry to the index.
   iree_io_parameter_index_entry_t entry = {
       .key = tensor_info->name,
-      .metadata = iree_const_byte_span_empty(),
+      .metadata = metadata_span,
       .length = storage_size,
       .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE,
       .storage =
@@ -751,3 +769,150 @@ IREE_API_EXPORT iree_status_t iree_io_parse_gguf_index(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// Tensor metadata
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT bool iree_io_gguf_tensor_metadata_lookup(
+    const iree_io_parameter_index_entry_t* entry,
+    iree_io_gguf_tensor_metadata_t* out_metadata) {
+  IREE_ASSERT_ARGUMENT(entry);
+  IREE_ASSERT_ARGUMENT(out_metadata);
+  memset(out_metadata, 0, sizeof(*out_metadata));
+  if (entry->metadata.data_length != sizeof(*out_metadata)) return false;
+  // Index metadata storage has no alignment guarantees.
+  iree_io_gguf_tensor_metadata_t metadata;
+  memcpy(&metadata, entry->metadata.data, sizeof(metadata));
+  if (metadata.magic != IREE_IO_GGUF_TENSOR_METADATA_MAGIC ||
+      metadata.rank > IREE_IO_GGUF_MAX_TENSOR_RANK) {
+    return false;
+  }
+  *out_metadata = metadata;
+  return true;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_gguf_unpack_transform
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_io_gguf_unpack_transform_query(
+    void* user_data, const iree_io_parameter_index_entry_t* entry,
+    bool* out_transformed, uint64_t* out_length) {
+  *out_transformed = false;
+  *out_length = entry->length;
+  iree_io_gguf_tensor_metadata_t metadata;
+  if (!iree_io_gguf_tensor_metadata_lookup(entry, &metadata)) {
+    return iree_ok_status();
+  }
+  switch (metadata.type) {
+    case GGML_TYPE_Q4_0:
+    case GGML_TYPE_Q8_0:
+      // Planar layouts have the same total size as the interleaved blocks.
+      *out_transformed = true;
+      break;
+    default:
+      break;
+  }
+  return iree_ok_status();
+}
+
+// Unpacks |block_count| Q8_0 blocks from |source| into |values| and |scales|.
+static void iree_io_gguf_unpack_q8_0(const uint8_t* IREE_RESTRICT source,
+                                     iree_host_size_t block_count,
+                                     uint8_t* IREE_RESTRICT values,
+                                     uint8_t* IREE_RESTRICT scales) {
+  for (iree_host_size_t i = 0; i < block_count; ++i) {
+    const uint8_t* block = source + i * sizeof(block_q8_0);
+    memcpy(scales + i * sizeof(uint16_t), block + offsetof(block_q8_0, d),
+           sizeof(uint16_t));
+    memcpy(values + i * QK8_0, block + offsetof(block_q8_0, qs), QK8_0);
+  }
+}
+
+// Unpacks |block_count| Q4_0 blocks from |source| into |values| and |scales|.
+// Q4_0 stores block element j in the low nibble of qs[j] and element j+16 in
+// the high nibble of qs[j] with an implicit bias of 8.
+static void iree_io_gguf_unpack_q4_0(const uint8_t* IREE_RESTRICT source,
+                                     iree_host_size_t block_count,
+                                     uint8_t* IREE_RESTRICT values,
+                                     uint8_t* IREE_RESTRICT scales) {
+  for (iree_host_size_t i = 0; i < block_count; ++i) {
+    const uint8_t* block = source + i * sizeof(block_q4_0);
+    memcpy(scales + i * sizeof(uint16_t), block + offsetof(block_q4_0, d),
+           sizeof(uint16_t));
+    const uint8_t* qs = block + offsetof(block_q4_0, qs);
+    uint8_t* block_values = values + i * (QK4_0 / 2);
+    // Elements [0, 16) come from the low nibbles and [16, 32) from the high
+    // nibbles so each half of the output is produced from one half of qs.
+    for (iree_host_size_t j = 0; j < QK4_0 / 4; ++j) {
+      const uint8_t lo0 = qs[j * 2 + 0] & 0xF;
+      const uint8_t lo1 = qs[j * 2 + 1] & 0xF;
+      const uint8_t hi0 = qs[j * 2 + 0] >> 4;
+      const uint8_t hi1 = qs[j * 2 + 1] >> 4;
+      // Subtracting the bias in 4 bits produces the two's complement i4.
+      block_values[j] = (uint8_t)(((lo0 - 8) & 0xF) | (((lo1 - 8) & 0xF) << 4));
+      block_values[j + QK4_0 / 4] =
+          (uint8_t)(((hi0 - 8) & 0xF) | (((hi1 - 8) & 0xF) << 4));
+    }
+  }
+}
+
+static iree_status_t iree_io_gguf_unpack_transform_apply(
+    void* user_data, const iree_io_parameter_index_entry_t* entry,
+    iree_const_byte_span_t source, iree_byte_span_t target) {
+  iree_io_gguf_tensor_metadata_t metadata;
+  if (!iree_io_gguf_tensor_metadata_lookup(entry, &metadata)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter `%.*s` has no GGUF tensor metadata",
+                            (int)entry->key.size, entry->key.data);
+  }
+  iree_host_size_t block_size = 0;
+  iree_host_size_t block_values_size = 0;
+  switch (metadata.type) {
+    case GGML_TYPE_Q4_0:
+      block_size = sizeof(block_q4_0);
+      block_values_size = QK4_0 / 2;
+      break;
+    case GGML_TYPE_Q8_0:
+      block_size = sizeof(block_q8_0);
+      block_values_size = QK8_0;
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "GGML tensor type %u cannot be unpacked",
+                              metadata.type);
+  }
+  if (source.data_length % block_size != 0 ||
+      target.data_length != source.data_length) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "parameter `%.*s` storage size %" PRIhsz
+        " is not a whole number of blocks or does not match the target "
+        "size %" PRIhsz,
+        (int)entry->key.size, entry->key.data, source.data_length,
+        target.data_length);
+  }
+  const iree_host_size_t block_count = source.data_length / block_size;
+  uint8_t* values = target.data;
+  uint8_t* scales = target.data + block_count * block_values_size;
+  switch (metadata.type) {
+    case GGML_TYPE_Q4_0:
+      iree_io_gguf_unpack_q4_0(source.data, block_count, values, scales);
+      break;
+    case GGML_TYPE_Q8_0:
+      iree_io_gguf_unpack_q8_0(source.data, block_count, values, scales);
+      break;
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_io_parameter_transform_t
+iree_io_gguf_unpack_transform(void) {
+  iree_io_parameter_transform_t transform = {
+      .query = iree_io_gguf_unpack_transform_query,
+      .apply = iree_io_gguf_unpack_transform_apply,
+      .user_data = NULL,
+  };
+  return transform;
+}
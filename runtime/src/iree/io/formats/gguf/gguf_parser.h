@@ -16,12 +16,89 @@ extern "C" {
 #endif  // __cplusplus
 
 // Parses a .gguf file and merges its contained resources into |index|.
+// Each entry has an iree_io_gguf_tensor_metadata_t describing the tensor
+// attached as its metadata; use iree_io_gguf_tensor_metadata_lookup to query
+// it.
 //
 // Specification:
 // https://github.com/ggerganov/ggml/blob/master/docs/gguf.md
 IREE_API_EXPORT iree_status_t iree_io_parse_gguf_index(
     iree_io_file_handle_t* file_handle, iree_io_parameter_index_t* index);
 
+//===----------------------------------------------------------------------===//
+// Tensor metadata
+//===----------------------------------------------------------------------===//
+
+// Maximum rank of tensors with metadata. Matches GGML_MAX_DIMS.
+#define IREE_IO_GGUF_MAX_TENSOR_RANK 4
+
+// Identifies iree_io_gguf_tensor_metadata_t in parameter entry metadata.
+#define IREE_IO_GGUF_TENSOR_METADATA_MAGIC 0x4D544747u  // 'GGTM'
+
+// GGML tensor element types as stored in GGUF files.
+typedef enum iree_io_gguf_tensor_type_e {
+  IREE_IO_GGUF_TENSOR_TYPE_F32 = 0,
+  IREE_IO_GGUF_TENSOR_TYPE_F16 = 1,
+  IREE_IO_GGUF_TENSOR_TYPE_Q4_0 = 2,
+  IREE_IO_GGUF_TENSOR_TYPE_Q4_1 = 3,
+  IREE_IO_GGUF_TENSOR_TYPE_Q5_0 = 6,
+  IREE_IO_GGUF_TENSOR_TYPE_Q5_1 = 7,
+  IREE_IO_GGUF_TENSOR_TYPE_Q8_0 = 8,
+  IREE_IO_GGUF_TENSOR_TYPE_Q8_1 = 9,
+  IREE_IO_GGUF_TENSOR_TYPE_Q2_K = 10,
+  IREE_IO_GGUF_TENSOR_TYPE_Q3_K = 11,
+  IREE_IO_GGUF_TENSOR_TYPE_Q4_K = 12,
+  IREE_IO_GGUF_TENSOR_TYPE_Q5_K = 13,
+  IREE_IO_GGUF_TENSOR_TYPE_Q6_K = 14,
+  IREE_IO_GGUF_TENSOR_TYPE_Q8_K = 15,
+  IREE_IO_GGUF_TENSOR_TYPE_I8 = 16,
+  IREE_IO_GGUF_TENSOR_TYPE_I16 = 17,
+  IREE_IO_GGUF_TENSOR_TYPE_I32 = 18,
+} iree_io_gguf_tensor_type_t;
+
+// Describes a tensor stored in a GGUF file.
+// Attached as the metadata of parameter index entries parsed from GGUF files
+// so that parameter transforms can interpret the stored contents.
+typedef struct iree_io_gguf_tensor_metadata_t {
+  // IREE_IO_GGUF_TENSOR_METADATA_MAGIC.
+  uint32_t magic;
+  // Element type of the tensor (iree_io_gguf_tensor_type_t).
+  uint32_t type;
+  // Number of valid dimensions in |dims|.
+  uint32_t rank;
+  uint32_t reserved;
+  // Tensor dimensions in GGML order with dims[0] being the innermost
+  // (fastest-varying) dimension.
+  uint64_t dims[IREE_IO_GGUF_MAX_TENSOR_RANK];
+} iree_io_gguf_tensor_metadata_t;
+
+// Returns true and the tensor metadata in |out_metadata| if |entry| was parsed
+// from a GGUF file. Returns false if the entry has no GGUF tensor metadata.
+IREE_API_EXPORT bool iree_io_gguf_tensor_metadata_lookup(
+    const iree_io_parameter_index_entry_t* entry,
+    iree_io_gguf_tensor_metadata_t* out_metadata);
+
+//===----------------------------------------------------------------------===//
+// Parameter transforms
+//===----------------------------------------------------------------------===//
+
+// Returns a parameter transform that unpacks block-quantized GGUF tensors into
+// planar value and scale arrays as they are loaded. Blocks are unpacked in
+// storage order with all block values followed by all block scales:
+//   Q8_0: [block_count * 32 x i8 values][block_count x f16 scales]
+//   Q4_0: [block_count * 16 x i4x2 values][block_count x f16 scales]
+// Q4_0 values are stored as signed i4 (the stored value minus 8) with two
+// elements per byte in element order starting from the low nibble. Unpacked
+// tensors have the same total length as the stored tensors. All other tensor
+// types are left unmodified.
+//
+// Use with iree_io_parameter_index_provider_create_with_transform. Transforms
+// to other layouts (such as data-tiled encodings matching the compiled program)
+// can be implemented in the same way using iree_io_gguf_tensor_metadata_lookup
+// to interpret entries.
+IREE_API_EXPORT iree_io_parameter_transform_t
+iree_io_gguf_unpack_transform(void);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
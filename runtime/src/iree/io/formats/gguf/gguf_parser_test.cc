@@ -57,7 +57,6 @@ TEST(GgufFormatTest, SingleTensor) {
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor0"), &entry0));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor0"), entry0->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry0->metadata));
   EXPECT_EQ(entry0->storage.file.offset, 384);
   EXPECT_EQ(entry0->length, 16);
 
@@ -78,7 +77,6 @@ TEST(GgufFormatTest, SingleTensorV2) {
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor0"), &entry0));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor0"), entry0->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry0->metadata));
   EXPECT_EQ(entry0->storage.file.offset, 384);
   EXPECT_EQ(entry0->length, 16);
 
@@ -98,7 +96,6 @@ TEST(GgufFormatTest, MultipleTensors) {
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor0"), &entry0));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor0"), entry0->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry0->metadata));
   EXPECT_EQ(entry0->storage.file.offset, 448);
   EXPECT_EQ(entry0->length, 16);
 
@@ -106,7 +103,6 @@ TEST(GgufFormatTest, MultipleTensors) {
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor1"), &entry1));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor1"), entry1->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry1->metadata));
   EXPECT_EQ(entry1->storage.file.offset, 512);
   EXPECT_EQ(entry1->length, 8);
 
@@ -114,12 +110,116 @@ TEST(GgufFormatTest, MultipleTensors) {
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor2"), &entry2));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor2"), entry2->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry2->metadata));
   EXPECT_EQ(entry2->storage.file.offset, 576);
   EXPECT_EQ(entry2->length, 48);
 
+  // Dimensions are in GGML order with the innermost dimension first.
+  iree_io_gguf_tensor_metadata_t metadata2;
+  ASSERT_TRUE(iree_io_gguf_tensor_metadata_lookup(entry2, &metadata2));
+  EXPECT_EQ(metadata2.type, IREE_IO_GGUF_TENSOR_TYPE_F32);
+  EXPECT_EQ(metadata2.rank, 2);
+  EXPECT_EQ(metadata2.dims[0], 3);
+  EXPECT_EQ(metadata2.dims[1], 4);
+
+  // Unquantized tensors are not transformed by the unpack transform.
+  iree_io_parameter_transform_t transform = iree_io_gguf_unpack_transform();
+  bool transformed = true;
+  uint64_t transformed_length = 0;
+  IREE_ASSERT_OK(transform.query(transform.user_data, entry2, &transformed,
+                                 &transformed_length));
+  EXPECT_FALSE(transformed);
+
   iree_io_parameter_index_release(index);
 }
 
+// Returns an entry describing a tensor of |type| with |element_count| elements
+// whose metadata is stored in |metadata|.
+static iree_io_parameter_index_entry_t MakeTensorEntry(
+    iree_io_gguf_tensor_type_t type, uint64_t element_count,
+    uint64_t storage_size, iree_io_gguf_tensor_metadata_t* metadata) {
+  memset(metadata, 0, sizeof(*metadata));
+  metadata->magic = IREE_IO_GGUF_TENSOR_METADATA_MAGIC;
+  metadata->type = type;
+  metadata->rank = 1;
+  metadata->dims[0] = element_count;
+  iree_io_parameter_index_entry_t entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.key = IREE_SV("tensor");
+  entry.metadata =
+      iree_make_const_byte_span((const uint8_t*)metadata, sizeof(*metadata));
+  entry.length = storage_size;
+  entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE;
+  return entry;
+}
+
+TEST(GgufUnpackTransformTest, Q8_0) {
+  // Two blocks of 32 values each with a 2 byte f16 scale prefix.
+  uint8_t source[2 * 34];
+  for (int block = 0; block < 2; ++block) {
+    source[block * 34 + 0] = (uint8_t)(0xA0 + block);
+    source[block * 34 + 1] = (uint8_t)(0xB0 + block);
+    for (int i = 0; i < 32; ++i) {
+      source[block * 34 + 2 + i] = (uint8_t)(block * 32 + i);
+    }
+  }
+  iree_io_gguf_tensor_metadata_t metadata;
+  iree_io_parameter_index_entry_t entry = MakeTensorEntry(
+      IREE_IO_GGUF_TENSOR_TYPE_Q8_0, 64, sizeof(source), &metadata);
+
+  iree_io_parameter_transform_t transform = iree_io_gguf_unpack_transform();
+  bool transformed = false;
+  uint64_t transformed_length = 0;
+  IREE_ASSERT_OK(transform.query(transform.user_data, &entry, &transformed,
+                                 &transformed_length));
+  ASSERT_TRUE(transformed);
+  ASSERT_EQ(transformed_length, sizeof(source));
+
+  uint8_t target[sizeof(source)] = {0};
+  IREE_ASSERT_OK(transform.apply(
+      transform.user_data, &entry,
+      iree_make_const_byte_span(source, sizeof(source)),
+      iree_make_byte_span(target, sizeof(target))));
+  for (int i = 0; i < 64; ++i) {
+    EXPECT_EQ(target[i], i);
+  }
+  EXPECT_EQ(target[64 + 0], 0xA0);
+  EXPECT_EQ(target[64 + 1], 0xB0);
+  EXPECT_EQ(target[64 + 2], 0xA1);
+  EXPECT_EQ(target[64 + 3], 0xB1);
+}
+
+TEST(GgufUnpackTransformTest, Q4_0) {
+  // One block of 32 values with a 2 byte f16 scale prefix. Element j is stored
+  // in the low nibble of qs[j] and element j+16 in the high nibble.
+  uint8_t source[18];
+  source[0] = 0x12;
+  source[1] = 0x34;
+  for (int j = 0; j < 16; ++j) {
+    const uint8_t lo = (uint8_t)(j & 0xF);         // element j
+    const uint8_t hi = (uint8_t)((15 - j) & 0xF);  // element j+16
+    source[2 + j] = (uint8_t)(lo | (hi << 4));
+  }
+  iree_io_gguf_tensor_metadata_t metadata;
+  iree_io_parameter_index_entry_t entry = MakeTensorEntry(
+      IREE_IO_GGUF_TENSOR_TYPE_Q4_0, 32, sizeof(source), &metadata);
+
+  iree_io_parameter_transform_t transform = iree_io_gguf_unpack_transform();
+  uint8_t target[sizeof(source)] = {0};
+  IREE_ASSERT_OK(transform.apply(
+      transform.user_data, &entry,
+      iree_make_const_byte_span(source, sizeof(source)),
+      iree_make_byte_span(target, sizeof(target))));
+
+  // Values are signed i4 (stored - 8) packed in element order.
+  for (int e = 0; e < 32; ++e) {
+    const uint8_t stored = e < 16 ? (uint8_t)e : (uint8_t)(15 - (e - 16));
+    const uint8_t expected = (uint8_t)((stored - 8) & 0xF);
+    const uint8_t actual = (target[e / 2] >> ((e % 2) * 4)) & 0xF;
+    EXPECT_EQ(actual, expected) << "element " << e;
+  }
+  EXPECT_EQ(target[16], 0x12);
+  EXPECT_EQ(target[17], 0x34);
+}
+
 }  // namespace
 }  // namespace iree
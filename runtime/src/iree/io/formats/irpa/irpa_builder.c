@@ -6,6 +6,10 @@
 
 #include "iree/io/formats/irpa/irpa_builder.h"
 
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_initialize(
     iree_allocator_t host_allocator,
     iree_io_parameter_archive_builder_t* out_builder) {
@@ -58,6 +62,9 @@ iree_io_parameter_archive_builder_total_size(
       builder->file_alignment);
 }
 
+// Number of entries whose metadata is written per vectored stream write.
+#define IREE_IO_PARAMETER_ARCHIVE_WRITE_BATCH_SIZE 32
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
     const iree_io_parameter_archive_builder_t* builder,
     iree_io_file_handle_t* file_handle, iree_io_physical_offset_t file_offset,
@@ -165,6 +172,35 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
         break;
       }
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE: {
+        if (target_entry.storage.file.compression !=
+            IREE_IO_COMPRESSION_TYPE_NONE) {
+          iree_io_parameter_archive_compressed_data_entry_t data_entry = {
+              .header =
+                  {
+                      .entry_size = sizeof(data_entry),
+                      .type =
+                          IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_COMPRESSED_DATA,
+                      .flags = 0,
+                      .name = name_ref,
+                      .metadata = metadata_ref,
+                      .minimum_alignment =
+                          IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+                  },
+              .storage =
+                  {
+                      .offset = target_entry.storage.file.offset,
+                      .length = target_entry.storage.file.compressed_length,
+                  },
+              .length = target_entry.length,
+              .compression = IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_LZ4,
+          };
+          target_entry.storage.file.handle = file_handle;
+          target_entry.storage.file.offset += storage_segment.offset;
+          IREE_RETURN_AND_END_ZONE_IF_ERROR(
+              z0,
+              iree_io_stream_write(stream, sizeof(data_entry), &data_entry));
+          break;
+        }
         iree_io_parameter_archive_data_entry_t data_entry = {
             .header =
                 {
@@ -202,21 +238,27 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
         z0, iree_io_parameter_index_add(target_index, &target_entry));
   }
 
-  // Write out the metadata table.
-  for (iree_host_size_t i = 0;
-       i < iree_io_parameter_index_count(builder->index); ++i) {
+  // Write out the metadata table in batches of name/metadata pairs so that
+  // archives with many small entries need few write calls.
+  iree_const_byte_span_t spans[2 * IREE_IO_PARAMETER_ARCHIVE_WRITE_BATCH_SIZE];
+  iree_host_size_t span_count = 0;
+  const iree_host_size_t entry_count =
+      iree_io_parameter_index_count(builder->index);
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
     // Query the source entry template.
     const iree_io_parameter_index_entry_t* source_entry = NULL;
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0, iree_io_parameter_index_get(builder->index, i, &source_entry));
 
-    // Write header metadata.
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_io_stream_write(stream, source_entry->key.size,
-                                 source_entry->key.data));
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_io_stream_write(stream, source_entry->metadata.data_length,
-                                 source_entry->metadata.data));
+    // Queue header metadata and flush when the batch is full.
+    spans[span_count++] = iree_make_const_byte_span(source_entry->key.data,
+                                                    source_entry->key.size);
+    spans[span_count++] = source_entry->metadata;
+    if (span_count == IREE_ARRAYSIZE(spans) || i + 1 == entry_count) {
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_io_stream_writev(stream, span_count, spans));
+      span_count = 0;
+    }
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -303,25 +345,406 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_data_entry(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_archive_builder_add_compressed_entry(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    iree_const_byte_span_t metadata, iree_io_physical_size_t minimum_alignment,
+    iree_io_compression_type_t compression,
+    iree_io_physical_size_t compressed_length,
+    iree_io_physical_size_t data_length) {
+  IREE_ASSERT_ARGUMENT(builder);
+  if (compression != IREE_IO_COMPRESSION_TYPE_LZ4) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported compression type %u",
+                            (uint32_t)compression);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, name.data, name.size);
+  iree_io_parameter_index_entry_t entry = {
+      .key = name,
+      .metadata = metadata,
+      .length = data_length,
+      .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE,
+      .storage =
+          {
+              .file =
+                  {
+                      .handle = NULL,  // set on commit
+                      .offset = iree_align_uint64(builder->storage_segment_size,
+                                                  minimum_alignment),
+                      .compression = compression,
+                      .compressed_length = compressed_length,
+                  },
+          },
+  };
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_parameter_index_add(builder->index, &entry));
+  builder->entry_segment_size =
+      iree_align_uint64(builder->entry_segment_size,
+                        IREE_IO_PARAMETER_ARCHIVE_ENTRY_ALIGNMENT) +
+      sizeof(iree_io_parameter_archive_compressed_data_entry_t);
+  builder->metadata_segment_size += name.size + metadata.data_length;
+  builder->storage_segment_size = entry.storage.file.offset + compressed_length;
+  if (!builder->storage_alignment) {
+    // First entry sets the base alignment.
+    builder->storage_alignment = minimum_alignment;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+
+//===----------------------------------------------------------------------===//
+// iree_io_build_parameter_archive
+//===----------------------------------------------------------------------===//
+
+// Processes item |i| of a parallel loop.
+typedef iree_status_t (*iree_io_parameter_archive_parallel_fn_t)(
+    void* user_data, iree_host_size_t i);
+
+// Shared state for processing archive entries across threads.
+// Workers pull items from a shared counter until all have been processed or
+// any fails.
+typedef struct iree_io_parameter_archive_parallel_state_t {
+  iree_io_parameter_archive_parallel_fn_t fn;
+  void* user_data;
+  // Total number of items to process.
+  iree_host_size_t count;
+  // Index of the next item to be processed by any worker.
+  iree_atomic_intptr_t next;
+  // Set to 1 when any item fails so that workers stop early.
+  iree_atomic_int32_t failed;
+  // Number of spawned workers that have started and the number we wait for.
+  // Once a thread has started its creator holds the last reference and
+  // releasing it joins the thread.
+  iree_atomic_int32_t started_count;
+  int32_t thread_count;
+  iree_notification_t started_notification;
+  // First failure reported by any worker; guarded by |mutex|.
+  iree_slim_mutex_t mutex;
+  iree_status_t status;
+} iree_io_parameter_archive_parallel_state_t;
+
+// Processes items until none remain or any worker has failed.
+static void iree_io_parameter_archive_parallel_run(
+    iree_io_parameter_archive_parallel_state_t* state) {
+  while (!iree_atomic_load_int32(&state->failed, iree_memory_order_acquire)) {
+    const iree_host_size_t i = (iree_host_size_t)iree_atomic_fetch_add_intptr(
+        &state->next, 1, iree_memory_order_relaxed);
+    if (i >= state->count) break;
+    iree_status_t status = state->fn(state->user_data, i);
+    if (!iree_status_is_ok(status)) {
+      iree_slim_mutex_lock(&state->mutex);
+      if (iree_status_is_ok(state->status)) {
+        state->status = status;
+      } else {
+        iree_status_ignore(status);
+      }
+      iree_slim_mutex_unlock(&state->mutex);
+      iree_atomic_store_int32(&state->failed, 1, iree_memory_order_release);
+      break;
+    }
+  }
+}
+
+static int iree_io_parameter_archive_parallel_worker(void* user_data) {
+  iree_io_parameter_archive_parallel_state_t* state =
+      (iree_io_parameter_archive_parallel_state_t*)user_data;
+  iree_atomic_fetch_add_int32(&state->started_count, 1,
+                              iree_memory_order_acq_rel);
+  iree_notification_post(&state->started_notification, IREE_ALL_WAITERS);
+  iree_io_parameter_archive_parallel_run(state);
+  return 0;
+}
+
+static bool iree_io_parameter_archive_parallel_all_started(void* arg) {
+  iree_io_parameter_archive_parallel_state_t* state =
+      (iree_io_parameter_archive_parallel_state_t*)arg;
+  return iree_atomic_load_int32(&state->started_count,
+                                iree_memory_order_acquire) >=
+         state->thread_count;
+}
+
+// Calls |fn| for each item in [0, |count|) using up to |concurrency| threads
+// (including the calling thread) and returns the first failure, if any.
+static iree_status_t iree_io_parameter_archive_parallel_for(
+    iree_host_size_t count, iree_host_size_t concurrency,
+    iree_string_view_t thread_name, iree_io_parameter_archive_parallel_fn_t fn,
+    void* user_data, iree_allocator_t host_allocator) {
+  iree_io_parameter_archive_parallel_state_t state = {
+      .fn = fn,
+      .user_data = user_data,
+      .count = count,
+      .thread_count = 0,
+      .status = iree_ok_status(),
+  };
+  iree_atomic_store_intptr(&state.next, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&state.failed, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&state.started_count, 0, iree_memory_order_relaxed);
+  iree_notification_initialize(&state.started_notification);
+  iree_slim_mutex_initialize(&state.mutex);
+
+  // Spin up additional workers; the calling thread also acts as a worker so
+  // a concurrency of 1 performs all work inline. If we fail to create a
+  // thread we continue with whatever workers we have.
+  const iree_host_size_t thread_count =
+      iree_min(iree_max(concurrency, 1),
+               IREE_IO_PARAMETER_ARCHIVE_MAX_CONCURRENCY) -
+      1;
+  iree_thread_t* threads[IREE_IO_PARAMETER_ARCHIVE_MAX_CONCURRENCY] = {0};
+  for (iree_host_size_t i = 0; i < iree_min(thread_count, count); ++i) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = thread_name;
+    iree_status_t status =
+        iree_thread_create(iree_io_parameter_archive_parallel_worker, &state,
+                           params, host_allocator, &threads[i]);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      break;
+    }
+    ++state.thread_count;
+  }
+  iree_io_parameter_archive_parallel_run(&state);
+
+  // A thread that has not yet started holds its own reference and would be
+  // detached instead of joined when we release ours so wait for all of them to
+  // start before releasing (which then joins them).
+  iree_notification_await(&state.started_notification,
+                          iree_io_parameter_archive_parallel_all_started,
+                          &state, iree_infinite_timeout());
+  for (int32_t i = 0; i < state.thread_count; ++i) {
+    iree_thread_release(threads[i]);
+  }
+  iree_notification_deinitialize(&state.started_notification);
+  iree_slim_mutex_deinitialize(&state.mutex);
+  return state.status;
+}
+
+// State for compressing source parameter entries prior to building an archive.
+typedef struct iree_io_parameter_archive_compress_state_t {
+  iree_io_parameter_index_t* source_index;
+  iree_io_compression_type_t compression;
+  iree_host_size_t chunk_size;
+  iree_allocator_t host_allocator;
+  // Compressed blobs indexed by source entry; empty if stored uncompressed.
+  iree_byte_span_t* blobs;
+} iree_io_parameter_archive_compress_state_t;
+
+// Compresses the contents of source entry |i| if it is an uncompressed file
+// entry. Entries that don't get smaller are left uncompressed.
+static iree_status_t iree_io_parameter_archive_compress_entry(
+    void* user_data, iree_host_size_t i) {
+  iree_io_parameter_archive_compress_state_t* state =
+      (iree_io_parameter_archive_compress_state_t*)user_data;
+  const iree_io_parameter_index_entry_t* source_entry = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_io_parameter_index_get(state->source_index, i, &source_entry));
+  if (source_entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE ||
+      source_entry->storage.file.compression != IREE_IO_COMPRESSION_TYPE_NONE ||
+      source_entry->length == 0) {
+    return iree_ok_status();
+  }
+  if (source_entry->length > IREE_HOST_SIZE_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "parameter `%.*s` too large to compress in memory",
+                            (int)source_entry->key.size,
+                            source_entry->key.data);
+  }
+  const iree_host_size_t length = (iree_host_size_t)source_entry->length;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, source_entry->key.data,
+                              source_entry->key.size);
+
+  // Get the source contents in host memory, reading them in if the source is
+  // not already host memory.
+  iree_io_file_handle_t* file_handle = source_entry->storage.file.handle;
+  iree_const_byte_span_t contents = iree_const_byte_span_empty();
+  uint8_t* staging = NULL;
+  iree_status_t status = iree_ok_status();
+  if (iree_io_file_handle_type(file_handle) ==
+      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    iree_byte_span_t host_allocation =
+        iree_io_file_handle_value(file_handle).host_allocation;
+    if (source_entry->storage.file.offset + length >
+        host_allocation.data_length) {
+      status = iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE,
+          "parameter `%.*s` storage out of range of its file",
+          (int)source_entry->key.size, source_entry->key.data);
+    } else {
+      contents = iree_make_const_byte_span(
+          host_allocation.data + source_entry->storage.file.offset, length);
+    }
+  } else {
+    status = iree_allocator_malloc_uninitialized(state->host_allocator,
+                                                 length, (void**)&staging);
+    iree_io_file_handle_t* staging_handle = NULL;
+    if (iree_status_is_ok(status)) {
+      status = iree_io_file_handle_wrap_host_allocation(
+          IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+          iree_make_byte_span(staging, length),
+          iree_io_file_handle_release_callback_null(), state->host_allocator,
+          &staging_handle);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_io_file_handle_copy_range(
+          file_handle, source_entry->storage.file.offset, staging_handle, 0,
+          length, state->host_allocator);
+    }
+    iree_io_file_handle_release(staging_handle);
+    contents = iree_make_const_byte_span(staging, length);
+  }
+
+  // Compress and only keep the blob if it is an improvement.
+  iree_byte_span_t blob = iree_make_byte_span(NULL, 0);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_compress(state->compression, state->chunk_size, contents,
+                              state->host_allocator, &blob);
+  }
+  if (iree_status_is_ok(status) && blob.data_length < length) {
+    state->blobs[i] = blob;
+  } else {
+    iree_allocator_free(state->host_allocator, blob.data);
+  }
+
+  iree_allocator_free(state->host_allocator, staging);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// State for copying parameter entry contents into an archive.
+// Entries have disjoint pre-computed ranges in the target file.
+typedef struct iree_io_parameter_archive_copy_state_t {
+  iree_io_parameter_index_t* source_index;
+  iree_io_parameter_index_t* target_index;
+  iree_io_file_handle_t* target_file_handle;
+  iree_io_physical_offset_t target_file_offset;
+  iree_allocator_t host_allocator;
+  // Optional compressed blobs indexed by source entry that are written in
+  // place of the source contents.
+  const iree_byte_span_t* blobs;
+} iree_io_parameter_archive_copy_state_t;
+
+// Copies the contents of source entry |i| to its location in the target file.
+// Splat entries are preserved as-is in the archive header and have no storage.
+static iree_status_t iree_io_parameter_archive_copy_entry(
+    void* user_data, iree_host_size_t i) {
+  iree_io_parameter_archive_copy_state_t* state =
+      (iree_io_parameter_archive_copy_state_t*)user_data;
+  const iree_io_parameter_index_entry_t* source_entry = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_io_parameter_index_get(state->source_index, i, &source_entry));
+  switch (source_entry->type) {
+    case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT:
+      // No work to do.
+      return iree_ok_status();
+    case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unhandled index entry storage type %d",
+                              (int)source_entry->type);
+  }
+  const iree_io_parameter_index_entry_t* target_entry = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_index_lookup(
+      state->target_index, source_entry->key, &target_entry));
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, source_entry->key.data,
+                              source_entry->key.size);
+  const iree_io_physical_offset_t target_offset =
+      state->target_file_offset + target_entry->storage.file.offset;
+  iree_status_t status = iree_ok_status();
+  if (state->blobs && state->blobs[i].data) {
+    // Newly compressed contents are written from memory.
+    iree_io_file_handle_t* blob_handle = NULL;
+    status = iree_io_file_handle_wrap_host_allocation(
+        IREE_IO_FILE_ACCESS_READ, state->blobs[i],
+        iree_io_file_handle_release_callback_null(), state->host_allocator,
+        &blob_handle);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_file_handle_copy_range(
+          blob_handle, 0, state->target_file_handle, target_offset,
+          state->blobs[i].data_length, state->host_allocator);
+    }
+    iree_io_file_handle_release(blob_handle);
+  } else {
+    // Uncompressed contents or already-compressed blobs are copied as-is.
+    const uint64_t stored_length =
+        source_entry->storage.file.compression != IREE_IO_COMPRESSION_TYPE_NONE
+            ? source_entry->storage.file.compressed_length
+            : target_entry->length;
+    status = iree_io_file_handle_copy_range(
+        source_entry->storage.file.handle, source_entry->storage.file.offset,
+        state->target_file_handle, target_offset, stored_length,
+        state->host_allocator);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
     iree_io_parameter_index_t* source_index,
     iree_io_parameter_index_t* target_index,
     iree_io_parameter_archive_file_open_callback_t target_file_open,
     iree_io_physical_offset_t target_file_offset,
     iree_allocator_t host_allocator) {
+  iree_io_parameter_archive_build_options_t options;
+  memset(&options, 0, sizeof(options));
+  return iree_io_build_parameter_archive_with_options(
+      source_index, target_index, target_file_open, target_file_offset,
+      &options, host_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive_with_options(
+    iree_io_parameter_index_t* source_index,
+    iree_io_parameter_index_t* target_index,
+    iree_io_parameter_archive_file_open_callback_t target_file_open,
+    iree_io_physical_offset_t target_file_offset,
+    const iree_io_parameter_archive_build_options_t* options,
+    iree_allocator_t host_allocator) {
   IREE_ASSERT_ARGUMENT(source_index);
   IREE_ASSERT_ARGUMENT(target_index);
   IREE_ASSERT_ARGUMENT(target_file_open.fn);
+  IREE_ASSERT_ARGUMENT(options);
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_io_parameter_archive_builder_t builder;
   iree_io_parameter_archive_builder_initialize(host_allocator, &builder);
 
+  // Lazily resolved entries must be added to the index first so that they are
+  // enumerated.
+  iree_status_t status = iree_io_parameter_index_resolve_all(source_index);
+  const iree_host_size_t entry_count =
+      iree_io_parameter_index_count(source_index);
+
+  // Compress entries up front as we need to know their compressed sizes in
+  // order to lay out the archive.
+  iree_byte_span_t* blobs = NULL;
+  if (iree_status_is_ok(status) &&
+      options->compression != IREE_IO_COMPRESSION_TYPE_NONE &&
+      entry_count > 0) {
+    status = iree_allocator_malloc(host_allocator, entry_count * sizeof(*blobs),
+                                   (void**)&blobs);
+    if (iree_status_is_ok(status)) {
+      iree_io_parameter_archive_compress_state_t compress_state = {
+          .source_index = source_index,
+          .compression = options->compression,
+          .chunk_size = options->compression_chunk_size,
+          .host_allocator = host_allocator,
+          .blobs = blobs,
+      };
+      status = iree_io_parameter_archive_parallel_for(
+          entry_count, options->concurrency, IREE_SV("iree-irpa-compress"),
+          iree_io_parameter_archive_compress_entry, &compress_state,
+          host_allocator);
+    }
+  }
+
   // Declare a parameter for each entry in the index.
   // This lets us calculate the size we require to store the entry metadata and
   // its contents (if any). No data is accessed yet.
-  iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < iree_io_parameter_index_count(source_index);
+  for (iree_host_size_t i = 0; iree_status_is_ok(status) && i < entry_count;
        ++i) {
     const iree_io_parameter_index_entry_t* source_entry = NULL;
     status = iree_io_parameter_index_get(source_index, i, &source_entry);
@@ -334,10 +757,26 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
             source_entry->storage.splat.pattern_length, source_entry->length);
         break;
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
-        status = iree_io_parameter_archive_builder_add_data_entry(
-            &builder, source_entry->key, source_entry->metadata,
-            IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
-            source_entry->length);
+        if (blobs && blobs[i].data) {
+          status = iree_io_parameter_archive_builder_add_compressed_entry(
+              &builder, source_entry->key, source_entry->metadata,
+              IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+              options->compression, blobs[i].data_length,
+              source_entry->length);
+        } else if (source_entry->storage.file.compression !=
+                   IREE_IO_COMPRESSION_TYPE_NONE) {
+          status = iree_io_parameter_archive_builder_add_compressed_entry(
+              &builder, source_entry->key, source_entry->metadata,
+              IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+              source_entry->storage.file.compression,
+              source_entry->storage.file.compressed_length,
+              source_entry->length);
+        } else {
+          status = iree_io_parameter_archive_builder_add_data_entry(
+              &builder, source_entry->key, source_entry->metadata,
+              IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+              source_entry->length);
+        }
         break;
       default:
         status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
@@ -375,51 +814,37 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
         target_index);
   }
 
-  // Copy over parameter entry file contents (if any).
-  // This is a slow operation and something we could optimize with lower-level
-  // platform primitives.
+  iree_io_stream_release(target_stream);
+
+  // Copy over parameter entry file contents (if any). Each entry has a disjoint
+  // range in the target file so entries can be copied in parallel with
+  // positional I/O instead of through the forward-only stream.
   if (iree_status_is_ok(status)) {
-    for (iree_host_size_t i = 0;
-         i < iree_io_parameter_index_count(source_index); ++i) {
-      const iree_io_parameter_index_entry_t* source_entry = NULL;
-      status = iree_io_parameter_index_get(source_index, i, &source_entry);
-      if (!iree_status_is_ok(status)) break;
-      const iree_io_parameter_index_entry_t* target_entry = NULL;
-      status = iree_io_parameter_index_lookup(target_index, source_entry->key,
-                                              &target_entry);
-      if (!iree_status_is_ok(status)) break;
-      switch (source_entry->type) {
-        case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT:
-          // No work to do.
-          break;
-        case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
-          status = iree_io_stream_seek(
-              target_stream, IREE_IO_STREAM_SEEK_SET,
-              target_file_offset + target_entry->storage.file.offset);
-          if (!iree_status_is_ok(status)) break;
-          status = iree_io_stream_write_file(
-              target_stream, source_entry->storage.file.handle,
-              source_entry->storage.file.offset, target_entry->length,
-              host_allocator);
-          break;
-        default:
-          status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                                    "unhandled index entry storage type %d",
-                                    (int)source_entry->type);
-          break;
-      }
-      if (!iree_status_is_ok(status)) break;
-    }
+    iree_io_parameter_archive_copy_state_t copy_state = {
+        .source_index = source_index,
+        .target_index = target_index,
+        .target_file_handle = target_file_handle,
+        .target_file_offset = target_file_offset,
+        .host_allocator = host_allocator,
+        .blobs = blobs,
+    };
+    status = iree_io_parameter_archive_parallel_for(
+        entry_count, options->concurrency, IREE_SV("iree-irpa-copy"),
+        iree_io_parameter_archive_copy_entry, &copy_state, host_allocator);
   }
 
-  iree_io_stream_release(target_stream);
-
   // Flush file contents before returning to the caller (in case they open the
   // file via a different handle).
   if (iree_status_is_ok(status)) {
     status = iree_io_file_handle_flush(target_file_handle);
   }
 
+  if (blobs) {
+    for (iree_host_size_t i = 0; i < entry_count; ++i) {
+      iree_allocator_free(host_allocator, blobs[i].data);
+    }
+    iree_allocator_free(host_allocator, blobs);
+  }
   iree_io_file_handle_release(target_file_handle);
   iree_io_parameter_archive_builder_deinitialize(&builder);
 
@@ -8,6 +8,7 @@
 #define IREE_IO_FORMATS_IRPA_IRPA_BUILDER_H_
 
 #include "iree/base/api.h"
+#include "iree/io/compression.h"
 #include "iree/io/file_handle.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/stream.h"
@@ -92,6 +93,19 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_data_entry(
     iree_const_byte_span_t metadata, iree_io_physical_size_t minimum_alignment,
     iree_io_physical_size_t data_length);
 
+// Adds a new compressed data entry to |builder|.
+// |metadata| (if provided) is copied prior to returning.
+// Physical storage will be allocated for a |compressed_length| blob produced by
+// iree_io_compress with |compression| that decompresses to |data_length|
+// bytes. The storage will be aligned to at least |minimum_alignment|.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_archive_builder_add_compressed_entry(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    iree_const_byte_span_t metadata, iree_io_physical_size_t minimum_alignment,
+    iree_io_compression_type_t compression,
+    iree_io_physical_size_t compressed_length,
+    iree_io_physical_size_t data_length);
+
 // Callback for opening a file for writing.
 // Implementations need to ensure that at least |archive_length| bytes are
 // available in the file starting at |archive_offset|.
@@ -121,6 +135,39 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
     iree_io_physical_offset_t target_file_offset,
     iree_allocator_t host_allocator);
 
+// Maximum number of threads used to compress and copy parameter contents into
+// an archive.
+#define IREE_IO_PARAMETER_ARCHIVE_MAX_CONCURRENCY 64
+
+// Options controlling how iree_io_build_parameter_archive_with_options builds
+// an archive. Zero-initialized options match iree_io_build_parameter_archive.
+typedef struct iree_io_parameter_archive_build_options_t {
+  // Maximum number of threads (including the calling thread) used to compress
+  // and copy parameter contents. 0 or 1 performs all work on the caller.
+  iree_host_size_t concurrency;
+  // Compression applied to file-backed parameters. Parameters that don't get
+  // any smaller are stored uncompressed and parameters that are already
+  // compressed in the source index are copied without recompressing.
+  iree_io_compression_type_t compression;
+  // Decompressed size of each independently decompressible chunk or 0 to use
+  // IREE_IO_COMPRESSION_DEFAULT_CHUNK_SIZE.
+  iree_host_size_t compression_chunk_size;
+} iree_io_parameter_archive_build_options_t;
+
+// Builds a parameter archive as with iree_io_build_parameter_archive using the
+// given |options|. Each entry is written to its own pre-computed range of the
+// target file with positional I/O so entries are copied independently and in
+// parallel. When compressing, all compressed blobs are produced in host memory
+// before the archive is sized and written.
+// Splat entries are preserved in the archive header and never materialized.
+IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive_with_options(
+    iree_io_parameter_index_t* source_index,
+    iree_io_parameter_index_t* target_index,
+    iree_io_parameter_archive_file_open_callback_t target_file_open,
+    iree_io_physical_offset_t target_file_offset,
+    const iree_io_parameter_archive_build_options_t* options,
+    iree_allocator_t host_allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -154,6 +154,50 @@ static iree_status_t iree_io_parse_irpa_v0_data_entry(
   return iree_io_parameter_index_add(index, &entry);
 }
 
+static iree_status_t iree_io_parse_irpa_v0_compressed_data_entry(
+    iree_io_file_handle_t* file_handle, iree_const_byte_span_t file_contents,
+    iree_io_physical_offset_t base_offset,
+    const iree_io_parameter_archive_header_v0_t* header,
+    const iree_io_parameter_archive_compressed_data_entry_t* data_entry,
+    iree_string_view_t name, iree_const_byte_span_t metadata,
+    iree_io_parameter_index_t* index) {
+  if (data_entry->header.entry_size < sizeof(*data_entry)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "compressed data entry length underflow");
+  }
+  iree_io_compression_type_t compression = IREE_IO_COMPRESSION_TYPE_NONE;
+  switch (data_entry->compression) {
+    case IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_LZ4:
+      compression = IREE_IO_COMPRESSION_TYPE_LZ4;
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "parser does not support compression type %u",
+                              data_entry->compression);
+  }
+  iree_io_physical_offset_t storage_offset = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_io_resolve_irpa_v0_storage(file_contents, base_offset, header,
+                                      data_entry->storage, &storage_offset));
+  iree_io_parameter_index_entry_t entry = {
+      .key = name,
+      .metadata = metadata,
+      .length = data_entry->length,
+      .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE,
+      .storage =
+          {
+              .file =
+                  {
+                      .handle = file_handle,
+                      .offset = storage_offset,
+                      .compression = compression,
+                      .compressed_length = data_entry->storage.length,
+                  },
+          },
+  };
+  return iree_io_parameter_index_add(index, &entry);
+}
+
 static iree_status_t iree_io_parse_irpa_v0_index_from_memory(
     iree_io_file_handle_t* file_handle, iree_const_byte_span_t file_contents,
     iree_io_physical_offset_t base_offset,
@@ -250,6 +294,14 @@ static iree_status_t iree_io_parse_irpa_v0_index_from_memory(
             metadata, index));
         break;
       }
+      case IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_COMPRESSED_DATA: {
+        IREE_RETURN_IF_ERROR(iree_io_parse_irpa_v0_compressed_data_entry(
+            file_handle, file_contents, base_offset, header,
+            (const iree_io_parameter_archive_compressed_data_entry_t*)
+                entry_header,
+            name, metadata, index));
+        break;
+      }
       default:
         return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                 "parser does not support entry type %d",
@@ -8,6 +8,9 @@
 
 #include <ctype.h>
 
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+
 // File format:
 // - uint64_t header_length;
 // - uint8_t header_json[header_length];
@@ -228,6 +231,7 @@ static iree_status_t iree_json_consume_object(iree_string_view_t* str,
     // Scan ahead to get the value span.
     iree_string_view_t value = iree_string_view_empty();
     IREE_RETURN_IF_ERROR(iree_json_consume_value(str, &value));
+    *str = iree_string_view_trim(*str);
     // If there's a comma then we expect another value.
     if (!iree_string_view_consume_prefix(str, IREE_SV(","))) break;
     *str = iree_string_view_trim(*str);
@@ -257,6 +261,7 @@ static iree_status_t iree_json_consume_array(iree_string_view_t* str,
     // Get the array element.
     iree_string_view_t value = iree_string_view_empty();
     IREE_RETURN_IF_ERROR(iree_json_consume_value(str, &value));
+    *str = iree_string_view_trim(*str);
     // If there's a comma then we expect another value.
     if (!iree_string_view_consume_prefix(str, IREE_SV(","))) break;
     *str = iree_string_view_trim(*str);
@@ -323,6 +328,7 @@ static iree_status_t iree_json_enumerate_object(
     // Scan ahead to get the value span.
     iree_string_view_t value = iree_string_view_empty();
     IREE_RETURN_IF_ERROR(iree_json_consume_value(&str, &value));
+    str = iree_string_view_trim(str);
     // Emit the key-value pair.
     iree_status_t status = enumerator(user_data, key, value);
     if (iree_status_is_cancelled(status)) {
@@ -525,3 +531,262 @@ IREE_API_EXPORT iree_status_t iree_io_parse_safetensors_index(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// Sharded safetensors index
+//===----------------------------------------------------------------------===//
+
+// A shard file referenced from the index `weight_map`.
+typedef struct iree_io_safetensors_shard_t {
+  // File name as it appears in the index JSON.
+  iree_string_view_t name;
+  // True once the shard header has been parsed into the parameter index.
+  bool is_parsed;
+} iree_io_safetensors_shard_t;
+
+// A tensor name mapped to the shard that contains it.
+typedef struct iree_io_safetensors_shard_key_t {
+  iree_string_view_t key;
+  iree_host_size_t shard_ordinal;
+} iree_io_safetensors_shard_key_t;
+
+// Parameter index resolver parsing shard headers as their tensors are used.
+// All string views reference the retained index file contents.
+typedef struct iree_io_safetensors_sharded_resolver_t {
+  iree_allocator_t host_allocator;
+  // Index JSON file backing all keys and shard names.
+  iree_io_file_handle_t* index_file_handle;
+  iree_io_safetensors_shard_open_callback_t shard_open;
+  // Guards shard parsing so that each shard is parsed exactly once.
+  iree_slim_mutex_t mutex;
+  iree_host_size_t shard_count;
+  iree_io_safetensors_shard_t* shards;
+  iree_host_size_t key_count;
+  iree_io_safetensors_shard_key_t* keys;
+  // Open-addressed (linear probing) hash table of keys. Power of two sized and
+  // kept at no more than 50% load.
+  iree_host_size_t bucket_capacity;
+  iree_io_safetensors_shard_key_t** buckets;
+} iree_io_safetensors_sharded_resolver_t;
+
+// Hashes |key| using 64-bit FNV-1a.
+static uint64_t iree_io_safetensors_hash_key(iree_string_view_t key) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < key.size; ++i) {
+    hash ^= (uint8_t)key.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Returns the shard key entry for |key| or NULL if not in the weight map.
+static const iree_io_safetensors_shard_key_t*
+iree_io_safetensors_sharded_resolver_find(
+    const iree_io_safetensors_sharded_resolver_t* resolver,
+    iree_string_view_t key) {
+  const iree_host_size_t mask = resolver->bucket_capacity - 1;
+  iree_host_size_t i =
+      (iree_host_size_t)iree_io_safetensors_hash_key(key) & mask;
+  for (const iree_io_safetensors_shard_key_t* entry = resolver->buckets[i];
+       entry; entry = resolver->buckets[i]) {
+    if (iree_string_view_equal(key, entry->key)) return entry;
+    i = (i + 1) & mask;
+  }
+  return NULL;
+}
+
+static iree_status_t iree_io_safetensors_count_weight_map_entries(
+    void* user_data, iree_string_view_t key, iree_string_view_t value) {
+  ++*(iree_host_size_t*)user_data;
+  return iree_ok_status();
+}
+
+// Records a `"TENSOR_NAME": "shard.safetensors"` weight map entry.
+static iree_status_t iree_io_safetensors_add_weight_map_entry(
+    void* user_data, iree_string_view_t key, iree_string_view_t value) {
+  iree_io_safetensors_sharded_resolver_t* resolver =
+      (iree_io_safetensors_sharded_resolver_t*)user_data;
+  if (iree_string_view_is_empty(value)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "weight map entry `%.*s` has no shard file",
+                            (int)key.size, key.data);
+  }
+
+  // Tensors are usually listed grouped by shard so scan from the most recently
+  // added shard backwards.
+  iree_host_size_t shard_ordinal = resolver->shard_count;
+  for (iree_host_size_t i = resolver->shard_count; i > 0; --i) {
+    if (iree_string_view_equal(resolver->shards[i - 1].name, value)) {
+      shard_ordinal = i - 1;
+      break;
+    }
+  }
+  if (shard_ordinal == resolver->shard_count) {
+    resolver->shards[resolver->shard_count].name = value;
+    resolver->shards[resolver->shard_count].is_parsed = false;
+    ++resolver->shard_count;
+  }
+
+  iree_io_safetensors_shard_key_t* entry =
+      &resolver->keys[resolver->key_count++];
+  entry->key = key;
+  entry->shard_ordinal = shard_ordinal;
+  const iree_host_size_t mask = resolver->bucket_capacity - 1;
+  iree_host_size_t i =
+      (iree_host_size_t)iree_io_safetensors_hash_key(key) & mask;
+  while (resolver->buckets[i]) i = (i + 1) & mask;
+  resolver->buckets[i] = entry;
+  return iree_ok_status();
+}
+
+// Opens and parses the header of shard |shard_ordinal| into |index|.
+// Must be called with the resolver mutex held.
+static iree_status_t iree_io_safetensors_sharded_resolver_parse_shard_locked(
+    iree_io_safetensors_sharded_resolver_t* resolver,
+    iree_host_size_t shard_ordinal, iree_io_parameter_index_t* index) {
+  iree_io_safetensors_shard_t* shard = &resolver->shards[shard_ordinal];
+  if (shard->is_parsed) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, shard->name.data, shard->name.size);
+
+  iree_io_file_handle_t* file_handle = NULL;
+  iree_status_t status = resolver->shard_open.fn(
+      resolver->shard_open.user_data, shard->name, &file_handle);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parse_safetensors_index(file_handle, index);
+  }
+  iree_io_file_handle_release(file_handle);
+  if (iree_status_is_ok(status)) {
+    shard->is_parsed = true;
+  } else {
+    status = iree_status_annotate_f(status, "parsing safetensors shard `%.*s`",
+                                    (int)shard->name.size, shard->name.data);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_safetensors_sharded_resolver_resolve(
+    void* user_data, iree_io_parameter_index_t* index, iree_string_view_t key) {
+  iree_io_safetensors_sharded_resolver_t* resolver =
+      (iree_io_safetensors_sharded_resolver_t*)user_data;
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&resolver->mutex);
+  if (iree_string_view_is_empty(key)) {
+    for (iree_host_size_t i = 0;
+         i < resolver->shard_count && iree_status_is_ok(status); ++i) {
+      status = iree_io_safetensors_sharded_resolver_parse_shard_locked(
+          resolver, i, index);
+    }
+  } else {
+    const iree_io_safetensors_shard_key_t* entry =
+        iree_io_safetensors_sharded_resolver_find(resolver, key);
+    if (entry) {
+      status = iree_io_safetensors_sharded_resolver_parse_shard_locked(
+          resolver, entry->shard_ordinal, index);
+    }
+  }
+  iree_slim_mutex_unlock(&resolver->mutex);
+  return status;
+}
+
+static void iree_io_safetensors_sharded_resolver_release(void* user_data) {
+  iree_io_safetensors_sharded_resolver_t* resolver =
+      (iree_io_safetensors_sharded_resolver_t*)user_data;
+  if (resolver->shard_open.release) {
+    resolver->shard_open.release(resolver->shard_open.user_data);
+  }
+  iree_io_file_handle_release(resolver->index_file_handle);
+  iree_slim_mutex_deinitialize(&resolver->mutex);
+  iree_allocator_free(resolver->host_allocator, resolver);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parse_safetensors_sharded_index(
+    iree_io_file_handle_t* index_file_handle,
+    iree_io_safetensors_shard_open_callback_t shard_open,
+    iree_allocator_t host_allocator, iree_io_parameter_index_t* index) {
+  IREE_ASSERT_ARGUMENT(index_file_handle);
+  IREE_ASSERT_ARGUMENT(shard_open.fn);
+  IREE_ASSERT_ARGUMENT(index);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Today we only support memory files.
+  iree_status_t status = iree_ok_status();
+  if (iree_io_file_handle_type(index_file_handle) !=
+      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    status = iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "non-memory safetensors index files not yet supported");
+  }
+
+  // Find the weight map and count its entries so that all storage can be
+  // allocated up front.
+  iree_string_view_t weight_map = iree_string_view_empty();
+  iree_host_size_t key_count = 0;
+  if (iree_status_is_ok(status)) {
+    iree_byte_span_t host_allocation =
+        iree_io_file_handle_primitive(index_file_handle).value.host_allocation;
+    iree_string_view_t index_json = iree_string_view_trim(
+        iree_make_string_view((const char*)host_allocation.data,
+                              host_allocation.data_length));
+    status = iree_json_lookup_object_value(index_json, IREE_SV("weight_map"),
+                                           &weight_map);
+  }
+  if (iree_status_is_ok(status) &&
+      !iree_string_view_starts_with(weight_map, IREE_SV("{"))) {
+    status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "safetensors index has no `weight_map` object");
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_json_enumerate_object(
+        weight_map, iree_io_safetensors_count_weight_map_entries, &key_count);
+  }
+
+  iree_io_safetensors_sharded_resolver_t* resolver = NULL;
+  if (iree_status_is_ok(status)) {
+    const iree_host_size_t bucket_capacity =
+        iree_math_round_up_to_pow2_u64(iree_max(16, key_count * 2));
+    const iree_host_size_t total_size =
+        sizeof(*resolver) + key_count * sizeof(resolver->shards[0]) +
+        key_count * sizeof(resolver->keys[0]) +
+        bucket_capacity * sizeof(resolver->buckets[0]);
+    status =
+        iree_allocator_malloc(host_allocator, total_size, (void**)&resolver);
+    if (iree_status_is_ok(status)) {
+      memset(resolver, 0, total_size);
+      resolver->host_allocator = host_allocator;
+      iree_slim_mutex_initialize(&resolver->mutex);
+      resolver->shards = (iree_io_safetensors_shard_t*)(resolver + 1);
+      resolver->keys =
+          (iree_io_safetensors_shard_key_t*)(resolver->shards + key_count);
+      resolver->bucket_capacity = bucket_capacity;
+      resolver->buckets =
+          (iree_io_safetensors_shard_key_t**)(resolver->keys + key_count);
+      status = iree_json_enumerate_object(
+          weight_map, iree_io_safetensors_add_weight_map_entry, resolver);
+    }
+  }
+
+  // Hand ownership of the resolver (and the shard open user data) to the index.
+  if (iree_status_is_ok(status)) {
+    resolver->index_file_handle = index_file_handle;
+    iree_io_file_handle_retain(index_file_handle);
+    resolver->shard_open = shard_open;
+    iree_io_parameter_index_resolver_t index_resolver = {
+        .resolve = iree_io_safetensors_sharded_resolver_resolve,
+        .release = iree_io_safetensors_sharded_resolver_release,
+        .user_data = resolver,
+    };
+    status = iree_io_parameter_index_add_resolver(index, index_resolver);
+  } else {
+    if (resolver) {
+      iree_slim_mutex_deinitialize(&resolver->mutex);
+      iree_allocator_free(host_allocator, resolver);
+    }
+    if (shard_open.release) shard_open.release(shard_open.user_data);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
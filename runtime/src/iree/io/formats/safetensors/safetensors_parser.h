@@ -34,6 +34,51 @@ extern "C" {
 IREE_API_EXPORT iree_status_t iree_io_parse_safetensors_index(
     iree_io_file_handle_t* file_handle, iree_io_parameter_index_t* index);
 
+// Opens the shard file |shard_name| referenced from a sharded safetensors index
+// (the file name as it appears in the `weight_map`) and returns its handle.
+typedef iree_status_t(IREE_API_PTR* iree_io_safetensors_shard_open_fn_t)(
+    void* user_data, iree_string_view_t shard_name,
+    iree_io_file_handle_t** out_file_handle);
+
+// Releases the shard open callback user data.
+typedef void(IREE_API_PTR* iree_io_safetensors_shard_release_fn_t)(
+    void* user_data);
+
+// A callback issued to open shard files as they are first used.
+typedef struct iree_io_safetensors_shard_open_callback_t {
+  // Callback function pointer.
+  iree_io_safetensors_shard_open_fn_t fn;
+  // Optional function releasing |user_data| when no longer required.
+  iree_io_safetensors_shard_release_fn_t release;
+  // User data passed to the callback function.
+  void* user_data;
+} iree_io_safetensors_shard_open_callback_t;
+
+// Parses a sharded safetensors index (`model.safetensors.index.json`) and
+// registers all of its shards with |index|.
+//
+// Format:
+//   {
+//     "metadata": {"total_size": 123},
+//     "weight_map": {
+//       "TENSOR_NAME": "model-00001-of-00002.safetensors",
+//       "NEXT_TENSOR_NAME": "model-00002-of-00002.safetensors"
+//     }
+//   }
+//
+// Only the index JSON is parsed immediately. Each shard is opened with
+// |shard_open| and has its header parsed the first time one of its tensors is
+// looked up in |index| such that shards containing no used parameters are
+// never touched. The index retains |index_file_handle| and owns the
+// |shard_open| user data for the lifetime of the index. Enumerating the index
+// requires iree_io_parameter_index_resolve_all to parse all shards first.
+//
+// The same warnings as iree_io_parse_safetensors_index apply.
+IREE_API_EXPORT iree_status_t iree_io_parse_safetensors_sharded_index(
+    iree_io_file_handle_t* index_file_handle,
+    iree_io_safetensors_shard_open_callback_t shard_open,
+    iree_allocator_t host_allocator, iree_io_parameter_index_t* index);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
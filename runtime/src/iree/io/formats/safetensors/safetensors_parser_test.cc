@@ -13,6 +13,8 @@
 namespace iree {
 namespace {
 
+using ::iree::testing::status::StatusIs;
+
 static iree_io_file_handle_t* OpenTestFile(const char* name) {
   const struct iree_file_toc_t* file_toc = iree_io_safetensors_files_create();
   for (size_t i = 0; i < iree_io_safetensors_files_size(); ++i) {
@@ -100,5 +102,143 @@ TEST(SafetensorsFormatTest, MultipleTensors) {
   iree_io_parameter_index_release(index);
 }
 
+// Opens embedded test files by name and counts how many shards were opened.
+struct ShardOpenState {
+  int open_count = 0;
+  bool released = false;
+};
+
+static iree_status_t OpenTestShard(void* user_data,
+                                   iree_string_view_t shard_name,
+                                   iree_io_file_handle_t** out_file_handle) {
+  auto* state = reinterpret_cast<ShardOpenState*>(user_data);
+  ++state->open_count;
+  const struct iree_file_toc_t* file_toc = iree_io_safetensors_files_create();
+  for (size_t i = 0; i < iree_io_safetensors_files_size(); ++i) {
+    if (iree_string_view_equal(shard_name,
+                               iree_make_cstring_view(file_toc[i].name))) {
+      return iree_io_file_handle_wrap_host_allocation(
+          IREE_IO_FILE_ACCESS_READ,
+          iree_make_byte_span((void*)file_toc[i].data, file_toc[i].size),
+          iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+          out_file_handle);
+    }
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND, "shard `%.*s` not found",
+                          (int)shard_name.size, shard_name.data);
+}
+
+static void ReleaseTestShardState(void* user_data) {
+  reinterpret_cast<ShardOpenState*>(user_data)->released = true;
+}
+
+static const char kShardedIndexJson[] = R"({
+  "metadata": {"total_size": 88},
+  "weight_map": {
+    "tensor0": "single.safetensors",
+    "tensor1": "multiple.safetensors",
+    "tensor2": "multiple.safetensors",
+    "missing0": "missing.safetensors"
+  }
+})";
+
+TEST(SafetensorsFormatTest, ShardedIndexLazy) {
+  iree_io_parameter_index_t* index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &index));
+
+  iree_io_file_handle_t* index_file_handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ,
+      iree_make_byte_span((void*)kShardedIndexJson,
+                          sizeof(kShardedIndexJson) - 1),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &index_file_handle));
+  ShardOpenState state;
+  iree_io_safetensors_shard_open_callback_t shard_open = {
+      OpenTestShard,
+      ReleaseTestShardState,
+      &state,
+  };
+  IREE_ASSERT_OK(iree_io_parse_safetensors_sharded_index(
+      index_file_handle, shard_open, iree_allocator_system(), index));
+  iree_io_file_handle_release(index_file_handle);
+
+  // No shards are touched until their parameters are looked up.
+  EXPECT_EQ(state.open_count, 0);
+  EXPECT_EQ(iree_io_parameter_index_count(index), 0);
+
+  const iree_io_parameter_index_entry_t* entry0 = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_lookup(index, IREE_SV("tensor0"), &entry0));
+  EXPECT_EQ(entry0->storage.file.offset, 72);
+  EXPECT_EQ(entry0->length, 16);
+  EXPECT_EQ(state.open_count, 1);
+
+  // Looking up one parameter in a shard makes all of its parameters available.
+  const iree_io_parameter_index_entry_t* entries[2] = {NULL, NULL};
+  iree_string_view_t keys[2] = {IREE_SV("tensor1"), IREE_SV("tensor2")};
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_lookup_batch(index, 2, keys, entries));
+  EXPECT_EQ(entries[0]->storage.file.offset, 216);
+  EXPECT_EQ(entries[1]->storage.file.offset, 224);
+  EXPECT_EQ(state.open_count, 2);
+
+  // Keys not in the weight map don't open anything.
+  const iree_io_parameter_index_entry_t* unknown_entry = NULL;
+  EXPECT_THAT(Status(iree_io_parameter_index_lookup(index, IREE_SV("unknown"),
+                                                    &unknown_entry)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(state.open_count, 2);
+
+  // Failures opening shards are propagated to the lookup.
+  const iree_io_parameter_index_entry_t* missing_entry = NULL;
+  EXPECT_THAT(Status(iree_io_parameter_index_lookup(index, IREE_SV("missing0"),
+                                                    &missing_entry)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(state.open_count, 3);
+
+  EXPECT_FALSE(state.released);
+  iree_io_parameter_index_release(index);
+  EXPECT_TRUE(state.released);
+}
+
+TEST(SafetensorsFormatTest, ShardedIndexResolveAll) {
+  iree_io_parameter_index_t* index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &index));
+
+  static const char kIndexJson[] = R"({"weight_map": {
+    "tensor0": "single.safetensors",
+    "tensor1": "multiple.safetensors"
+  }})";
+  iree_io_file_handle_t* index_file_handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ,
+      iree_make_byte_span((void*)kIndexJson, sizeof(kIndexJson) - 1),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &index_file_handle));
+  ShardOpenState state;
+  iree_io_safetensors_shard_open_callback_t shard_open = {
+      OpenTestShard,
+      ReleaseTestShardState,
+      &state,
+  };
+  IREE_ASSERT_OK(iree_io_parse_safetensors_sharded_index(
+      index_file_handle, shard_open, iree_allocator_system(), index));
+  iree_io_file_handle_release(index_file_handle);
+
+  // single.safetensors has 1 tensor and multiple.safetensors has 3.
+  IREE_ASSERT_OK(iree_io_parameter_index_resolve_all(index));
+  EXPECT_EQ(state.open_count, 2);
+  EXPECT_EQ(iree_io_parameter_index_count(index), 4);
+
+  // Resolving again does not reopen shards.
+  IREE_ASSERT_OK(iree_io_parameter_index_resolve_all(index));
+  EXPECT_EQ(state.open_count, 2);
+
+  iree_io_parameter_index_release(index);
+}
+
 }  // namespace
 }  // namespace iree
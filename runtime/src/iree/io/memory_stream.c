@@ -337,6 +337,74 @@ static iree_status_t iree_io_memory_stream_map_write(
   return iree_ok_status();
 }
 
+static iree_status_t iree_io_memory_stream_readv(
+    iree_io_stream_t* base_stream, iree_host_size_t buffer_count,
+    const iree_byte_span_t* buffers, iree_host_size_t* out_total_length) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  IREE_ASSERT_ARGUMENT(buffers);
+  if (out_total_length) *out_total_length = 0;
+  iree_io_memory_stream_t* stream = iree_io_memory_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_stream_pos_t total_capacity = 0;
+  for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+    total_capacity += buffers[i].data_length;
+  }
+  iree_io_stream_pos_t read_length = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_stream_validate_fixed_range(stream->offset, stream->length,
+                                              total_capacity, &read_length));
+  if (!out_total_length && read_length != total_capacity) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0,
+        iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                         "vectored read of %" PRIu64
+                         " bytes out of range; stream offset %" PRIu64
+                         " and length %" PRIu64 " insufficient",
+                         total_capacity, stream->offset, stream->length));
+  }
+
+  iree_io_stream_pos_t remaining = read_length;
+  for (iree_host_size_t i = 0; i < buffer_count && remaining > 0; ++i) {
+    iree_host_size_t length = (iree_host_size_t)iree_min(
+        (iree_io_stream_pos_t)buffers[i].data_length, remaining);
+    memcpy(buffers[i].data, stream->contents + stream->offset, length);
+    stream->offset += length;
+    remaining -= length;
+  }
+
+  if (out_total_length) *out_total_length = (iree_host_size_t)read_length;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_io_memory_stream_writev(
+    iree_io_stream_t* base_stream, iree_host_size_t buffer_count,
+    const iree_const_byte_span_t* buffers) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  IREE_ASSERT_ARGUMENT(buffers);
+  iree_io_memory_stream_t* stream = iree_io_memory_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_stream_pos_t total_length = 0;
+  for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+    total_length += buffers[i].data_length;
+  }
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_stream_validate_fixed_range(stream->offset, stream->length,
+                                              total_length, NULL));
+
+  for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+    if (!buffers[i].data_length) continue;
+    memcpy(stream->contents + stream->offset, buffers[i].data,
+           buffers[i].data_length);
+    stream->offset += buffers[i].data_length;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static const iree_io_stream_vtable_t iree_io_memory_stream_vtable = {
     .destroy = iree_io_memory_stream_destroy,
     .offset = iree_io_memory_stream_offset,
@@ -347,4 +415,6 @@ static const iree_io_stream_vtable_t iree_io_memory_stream_vtable = {
     .fill = iree_io_memory_stream_fill,
     .map_read = iree_io_memory_stream_map_read,
     .map_write = iree_io_memory_stream_map_write,
+    .readv = iree_io_memory_stream_readv,
+    .writev = iree_io_memory_stream_writev,
 };
@@ -455,6 +455,85 @@ TEST(MemoryStreamTest, Write) {
   iree_io_stream_release(stream);
 }
 
+TEST(MemoryStreamTest, ReadV) {
+  uint8_t data[5] = {0, 1, 2, 3, 4};
+  iree_io_stream_t* stream = NULL;
+  IREE_ASSERT_OK(iree_io_memory_stream_wrap(
+      IREE_IO_STREAM_MODE_READABLE, iree_make_byte_span(data, sizeof(data)),
+      iree_io_memory_stream_release_callback_null(), iree_allocator_system(),
+      &stream));
+
+  // Reads are scattered across all buffers in order, skipping empty ones.
+  std::array<uint8_t, 2> buffer0 = {0xDD, 0xDD};
+  std::array<uint8_t, 8> buffer1;
+  buffer1.fill(0xDD);
+  iree_byte_span_t buffers[3] = {
+      iree_make_byte_span(buffer0.data(), buffer0.size()),
+      iree_make_byte_span(NULL, 0),
+      iree_make_byte_span(buffer1.data(), 2),
+  };
+  IREE_EXPECT_OK(iree_io_stream_readv(stream, IREE_ARRAYSIZE(buffers),
+                                      buffers, NULL));
+  EXPECT_EQ(iree_io_stream_offset(stream), 4);
+  EXPECT_THAT(buffer0, ElementsAre(0, 1));
+  EXPECT_EQ(buffer1[0], 2);
+  EXPECT_EQ(buffer1[1], 3);
+  EXPECT_EQ(buffer1[2], 0xDD);
+
+  // Reads off the end fail without a length and don't advance the stream.
+  buffers[2] = iree_make_byte_span(buffer1.data(), buffer1.size());
+  IREE_EXPECT_OK(iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, 0));
+  EXPECT_THAT(Status(iree_io_stream_readv(stream, IREE_ARRAYSIZE(buffers),
+                                          buffers, NULL)),
+              StatusIs(StatusCode::kOutOfRange));
+  EXPECT_EQ(iree_io_stream_offset(stream), 0);
+
+  // Reads up to the end return what was available.
+  buffer1.fill(0xDD);
+  iree_host_size_t read_length = 0;
+  IREE_EXPECT_OK(iree_io_stream_readv(stream, IREE_ARRAYSIZE(buffers),
+                                      buffers, &read_length));
+  EXPECT_EQ(read_length, sizeof(data));
+  EXPECT_TRUE(iree_io_stream_is_eos(stream));
+  EXPECT_THAT(buffer0, ElementsAre(0, 1));
+  EXPECT_EQ(buffer1[0], 2);
+  EXPECT_EQ(buffer1[2], 4);
+  EXPECT_EQ(buffer1[3], 0xDD);
+
+  iree_io_stream_release(stream);
+}
+
+TEST(MemoryStreamTest, WriteV) {
+  uint8_t data[5] = {0xDD};
+  iree_io_stream_t* stream = NULL;
+  IREE_ASSERT_OK(iree_io_memory_stream_wrap(
+      IREE_IO_STREAM_MODE_WRITABLE, iree_make_byte_span(data, sizeof(data)),
+      iree_io_memory_stream_release_callback_null(), iree_allocator_system(),
+      &stream));
+
+  // Writes are gathered from all buffers in order, skipping empty ones.
+  memset(data, 0xDD, sizeof(data));
+  const uint8_t write_buffer[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  const iree_const_byte_span_t buffers[3] = {
+      iree_make_const_byte_span(&write_buffer[4], 2),
+      iree_make_const_byte_span(NULL, 0),
+      iree_make_const_byte_span(&write_buffer[1], 2),
+  };
+  IREE_EXPECT_OK(
+      iree_io_stream_writev(stream, IREE_ARRAYSIZE(buffers), buffers));
+  EXPECT_EQ(iree_io_stream_offset(stream), 4);
+  EXPECT_THAT(data, ElementsAre(4, 5, 1, 2, 0xDD));
+
+  // Writes off the end fail without modifying the contents.
+  EXPECT_THAT(
+      Status(iree_io_stream_writev(stream, IREE_ARRAYSIZE(buffers), buffers)),
+      StatusIs(StatusCode::kOutOfRange));
+  EXPECT_EQ(iree_io_stream_offset(stream), 4);
+  EXPECT_THAT(data, ElementsAre(4, 5, 1, 2, 0xDD));
+
+  iree_io_stream_release(stream);
+}
+
 TEST(MemoryStreamTest, Fill) {
   uint8_t data[16] = {0xDD};
   iree_io_stream_t* stream = NULL;
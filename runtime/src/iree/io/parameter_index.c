@@ -7,8 +7,15 @@
 #include "iree/io/parameter_index.h"
 
 #include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
 #include "iree/base/internal/synchronization.h"
 
+// A registered resolver in the index resolver list.
+typedef struct iree_io_parameter_index_resolver_node_t {
+  struct iree_io_parameter_index_resolver_node_t* next;
+  iree_io_parameter_index_resolver_t resolver;
+} iree_io_parameter_index_resolver_node_t;
+
 struct iree_io_parameter_index_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t host_allocator;
@@ -24,8 +31,84 @@ struct iree_io_parameter_index_t {
   iree_host_size_t entry_count;
   // Dense list of entries in the index. Grows as needed.
   iree_io_parameter_index_entry_t** entries;
+
+  // Total capacity of the hash table in buckets. Always a power of two (or 0)
+  // and maintained at no more than 50% load so probe sequences stay short.
+  iree_host_size_t bucket_capacity;
+  // Open-addressed (linear probing) hash table of entry pointers keyed on the
+  // entry key. Empty buckets are NULL. Entries are inserted in index order so
+  // that lookups of duplicate keys return the first entry added, matching the
+  // behavior of a linear scan. Rebuilt whenever the bucket capacity grows.
+  iree_io_parameter_index_entry_t** buckets;
+
+  // Singly-linked list of resolvers in the order they were added. Nodes are
+  // never removed until the index is destroyed and |next| is only read or
+  // written with the mutex held.
+  iree_io_parameter_index_resolver_node_t* resolver_head;
+  iree_io_parameter_index_resolver_node_t* resolver_tail;
 };
 
+// Hashes |key| using 64-bit FNV-1a. Keys are usually short paths or names and
+// this is cheap enough to not show up next to the string compare on hit.
+static uint64_t iree_io_parameter_index_hash_key(iree_string_view_t key) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < key.size; ++i) {
+    hash ^= (uint8_t)key.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Inserts |entry| into the hash table. The table must have at least one empty
+// bucket.
+static void iree_io_parameter_index_insert_bucket_unsafe(
+    iree_io_parameter_index_t* index, iree_io_parameter_index_entry_t* entry) {
+  const iree_host_size_t mask = index->bucket_capacity - 1;
+  iree_host_size_t i =
+      (iree_host_size_t)iree_io_parameter_index_hash_key(entry->key) & mask;
+  while (index->buckets[i]) i = (i + 1) & mask;
+  index->buckets[i] = entry;
+}
+
+// Finds the first entry added with |key| or NULL if not found.
+static const iree_io_parameter_index_entry_t*
+iree_io_parameter_index_find_unsafe(iree_io_parameter_index_t* index,
+                                    iree_string_view_t key) {
+  if (!index->bucket_capacity) return NULL;
+  const iree_host_size_t mask = index->bucket_capacity - 1;
+  iree_host_size_t i =
+      (iree_host_size_t)iree_io_parameter_index_hash_key(key) & mask;
+  for (const iree_io_parameter_index_entry_t* entry = index->buckets[i]; entry;
+       entry = index->buckets[i]) {
+    if (iree_string_view_equal(key, entry->key)) return entry;
+    i = (i + 1) & mask;
+  }
+  return NULL;
+}
+
+// Grows the hash table such that it can hold |entry_capacity| entries at 50%
+// load and rehashes all existing entries.
+static iree_status_t iree_io_parameter_index_reserve_buckets_unsafe(
+    iree_io_parameter_index_t* index, iree_host_size_t entry_capacity) {
+  iree_host_size_t new_bucket_capacity =
+      iree_math_round_up_to_pow2_u64(iree_max(16, entry_capacity * 2));
+  if (new_bucket_capacity <= index->bucket_capacity) return iree_ok_status();
+
+  iree_io_parameter_index_entry_t** new_buckets = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      index->host_allocator, new_bucket_capacity * sizeof(new_buckets[0]),
+      (void**)&new_buckets));
+  memset(new_buckets, 0, new_bucket_capacity * sizeof(new_buckets[0]));
+  iree_allocator_free(index->host_allocator, index->buckets);
+  index->bucket_capacity = new_bucket_capacity;
+  index->buckets = new_buckets;
+
+  for (iree_host_size_t i = 0; i < index->entry_count; ++i) {
+    iree_io_parameter_index_insert_bucket_unsafe(index, index->entries[i]);
+  }
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_create(
     iree_allocator_t host_allocator, iree_io_parameter_index_t** out_index) {
   IREE_ASSERT_ARGUMENT(out_index);
@@ -46,6 +129,10 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_create(
   index->entry_capacity = 0;
   index->entry_count = 0;
   index->entries = NULL;
+  index->bucket_capacity = 0;
+  index->buckets = NULL;
+  index->resolver_head = NULL;
+  index->resolver_tail = NULL;
 
   *out_index = index;
   IREE_TRACE_ZONE_END(z0);
@@ -57,6 +144,16 @@ static void iree_io_parameter_index_destroy(iree_io_parameter_index_t* index) {
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_allocator_t host_allocator = index->host_allocator;
 
+  iree_io_parameter_index_resolver_node_t* node = index->resolver_head;
+  while (node) {
+    iree_io_parameter_index_resolver_node_t* next_node = node->next;
+    if (node->resolver.release) {
+      node->resolver.release(node->resolver.user_data);
+    }
+    iree_allocator_free(host_allocator, node);
+    node = next_node;
+  }
+
   for (iree_host_size_t i = 0; i < index->entry_count; ++i) {
     iree_io_parameter_index_entry_t* entry = index->entries[i];
     switch (entry->type) {
@@ -71,6 +168,9 @@ static void iree_io_parameter_index_destroy(iree_io_parameter_index_t* index) {
   if (index->entries) {
     iree_allocator_free(host_allocator, index->entries);
   }
+  if (index->buckets) {
+    iree_allocator_free(host_allocator, index->buckets);
+  }
 
   iree_slim_mutex_deinitialize(&index->mutex);
 
@@ -109,10 +209,17 @@ static iree_status_t iree_io_parameter_index_reserve_unsafe(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_capacity);
 
+  // Grow the hash table first so that it can always hold entry_capacity
+  // entries even if the entry list reallocation fails.
+  iree_status_t status =
+      iree_io_parameter_index_reserve_buckets_unsafe(index, new_capacity);
+
   iree_io_parameter_index_entry_t** new_entries = index->entries;
-  iree_status_t status = iree_allocator_realloc(
-      index->host_allocator, new_capacity * sizeof(index->entries[0]),
-      (void**)&new_entries);
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_realloc(index->host_allocator,
+                                    new_capacity * sizeof(index->entries[0]),
+                                    (void**)&new_entries);
+  }
   if (iree_status_is_ok(status)) {
     index->entry_capacity = new_capacity;
     index->entries = new_entries;
@@ -184,8 +291,11 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
     memcpy((void*)cloned_entry->metadata.data, entry->metadata.data,
            entry->metadata.data_length);
 
-    // Append the entry to the file index.
+    // Append the entry to the file index and make it available for lookup.
+    // The hash table is always sized to the entry capacity so a bucket is
+    // guaranteed to be available.
     index->entries[index->entry_count++] = cloned_entry;
+    iree_io_parameter_index_insert_bucket_unsafe(index, cloned_entry);
   }
 
   iree_slim_mutex_unlock(&index->mutex);
@@ -215,6 +325,77 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
   return status;
 }
 
+// Finds the first entry added with |key| and if not found queries each
+// resolver in order until one adds it. The index mutex must be held by the
+// caller and is released while resolvers are running. |out_entry| is NULL if
+// the key was not found.
+static iree_status_t iree_io_parameter_index_find_or_resolve_unsafe(
+    iree_io_parameter_index_t* index, iree_string_view_t key,
+    const iree_io_parameter_index_entry_t** out_entry) {
+  *out_entry = iree_io_parameter_index_find_unsafe(index, key);
+  if (*out_entry || iree_string_view_is_empty(key)) return iree_ok_status();
+  iree_status_t status = iree_ok_status();
+  for (iree_io_parameter_index_resolver_node_t* node = index->resolver_head;
+       node && iree_status_is_ok(status) && !*out_entry; node = node->next) {
+    iree_slim_mutex_unlock(&index->mutex);
+    status = node->resolver.resolve(node->resolver.user_data, index, key);
+    iree_slim_mutex_lock(&index->mutex);
+    if (iree_status_is_ok(status)) {
+      *out_entry = iree_io_parameter_index_find_unsafe(index, key);
+    }
+  }
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_index_add_resolver(
+    iree_io_parameter_index_t* index,
+    iree_io_parameter_index_resolver_t resolver) {
+  IREE_ASSERT_ARGUMENT(index);
+  IREE_ASSERT_ARGUMENT(resolver.resolve);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_parameter_index_resolver_node_t* node = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      index->host_allocator, sizeof(*node), (void**)&node);
+  if (iree_status_is_ok(status)) {
+    node->next = NULL;
+    node->resolver = resolver;
+    iree_slim_mutex_lock(&index->mutex);
+    if (index->resolver_tail) {
+      index->resolver_tail->next = node;
+    } else {
+      index->resolver_head = node;
+    }
+    index->resolver_tail = node;
+    iree_slim_mutex_unlock(&index->mutex);
+  } else if (resolver.release) {
+    resolver.release(resolver.user_data);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_resolve_all(iree_io_parameter_index_t* index) {
+  IREE_ASSERT_ARGUMENT(index);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&index->mutex);
+
+  iree_status_t status = iree_ok_status();
+  for (iree_io_parameter_index_resolver_node_t* node = index->resolver_head;
+       node && iree_status_is_ok(status); node = node->next) {
+    iree_slim_mutex_unlock(&index->mutex);
+    status = node->resolver.resolve(node->resolver.user_data, index,
+                                    iree_string_view_empty());
+    iree_slim_mutex_lock(&index->mutex);
+  }
+
+  iree_slim_mutex_unlock(&index->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
     iree_io_parameter_index_t* index, iree_string_view_t key,
     const iree_io_parameter_index_entry_t** out_entry) {
@@ -225,15 +406,9 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
   IREE_TRACE_ZONE_APPEND_TEXT(z0, key.data, key.size);
   iree_slim_mutex_lock(&index->mutex);
 
-  iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < index->entry_count; ++i) {
-    const iree_io_parameter_index_entry_t* entry = index->entries[i];
-    if (iree_string_view_equal(key, entry->key)) {
-      *out_entry = entry;
-      break;
-    }
-  }
-  if (*out_entry == NULL) {
+  iree_status_t status =
+      iree_io_parameter_index_find_or_resolve_unsafe(index, key, out_entry);
+  if (iree_status_is_ok(status) && *out_entry == NULL) {
     status = iree_make_status(IREE_STATUS_NOT_FOUND,
                               "no parameter found in index with key '%.*s'",
                               (int)key.size, key.data);
@@ -244,9 +419,42 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup_batch(
+    iree_io_parameter_index_t* index, iree_host_size_t key_count,
+    const iree_string_view_t* keys,
+    const iree_io_parameter_index_entry_t** out_entries) {
+  IREE_ASSERT_ARGUMENT(index);
+  IREE_ASSERT_ARGUMENT(!key_count || keys);
+  IREE_ASSERT_ARGUMENT(!key_count || out_entries);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)key_count);
+  iree_slim_mutex_lock(&index->mutex);
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < key_count; ++i) {
+    status = iree_io_parameter_index_find_or_resolve_unsafe(index, keys[i],
+                                                            &out_entries[i]);
+    if (!iree_status_is_ok(status)) break;
+    if (out_entries[i] == NULL) {
+      status = iree_make_status(IREE_STATUS_NOT_FOUND,
+                                "no parameter found in index with key '%.*s'",
+                                (int)keys[i].size, keys[i].data);
+      break;
+    }
+  }
+
+  iree_slim_mutex_unlock(&index->mutex);
+  if (!iree_status_is_ok(status)) {
+    memset(out_entries, 0, key_count * sizeof(out_entries[0]));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_dump(
     iree_string_view_t scope, iree_io_parameter_index_t* index,
     iree_string_builder_t* builder) {
+  IREE_RETURN_IF_ERROR(iree_io_parameter_index_resolve_all(index));
   iree_host_size_t entry_count = iree_io_parameter_index_count(index);
   uint64_t total_bytes = 0;
   for (iree_host_size_t i = 0; i < entry_count; ++i) {
@@ -294,11 +502,20 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_dump(
         break;
       }
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE: {
+        // Compressed entries show their stored range and decompressed length.
+        const uint64_t stored_length =
+            entry->storage.file.compression != IREE_IO_COMPRESSION_TYPE_NONE
+                ? entry->storage.file.compressed_length
+                : entry->length;
         IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
-            builder, "%16" PRIu64 " | %16" PRIu64 " | %16" PRIu64 " | `%.*s`\n",
+            builder,
+            "%16" PRIu64 " | %16" PRIu64 " | %16" PRIu64 " | `%.*s`%s\n",
             entry->storage.file.offset,
-            entry->storage.file.offset + entry->length, entry->length,
-            (int)entry->key.size, entry->key.data));
+            entry->storage.file.offset + stored_length, entry->length,
+            (int)entry->key.size, entry->key.data,
+            entry->storage.file.compression != IREE_IO_COMPRESSION_TYPE_NONE
+                ? " (compressed)"
+                : ""));
         break;
       }
       default: {
@@ -8,6 +8,7 @@
 #define IREE_IO_PARAMETER_INDEX_H_
 
 #include "iree/base/api.h"
+#include "iree/io/compression.h"
 #include "iree/io/file_handle.h"
 
 #ifdef __cplusplus
@@ -63,6 +64,12 @@ typedef struct iree_io_parameter_index_entry_t {
       iree_io_file_handle_t* handle;
       // Offset of the entry in bytes relative to the base file offset.
       uint64_t offset;
+      // Compression of the stored contents. When not
+      // IREE_IO_COMPRESSION_TYPE_NONE the file range contains a compressed blob
+      // of |compressed_length| bytes that decompresses to the entry length.
+      iree_io_compression_type_t compression;
+      // Length of the compressed blob in bytes when |compression| is set.
+      uint64_t compressed_length;
     } file;
   } storage;
 } iree_io_parameter_index_entry_t;
@@ -92,6 +99,8 @@ IREE_API_EXPORT void iree_io_parameter_index_release(
 // Returns the number of entries in the index at the time the method is called.
 // New entries may be added by other threads between when the value is queried
 // and when the caller enumerates entries. Use this only for debugging.
+// Entries provided by resolvers are only included once they have been resolved
+// (see iree_io_parameter_index_resolve_all).
 IREE_API_EXPORT iree_host_size_t
 iree_io_parameter_index_count(iree_io_parameter_index_t* index);
 
@@ -115,13 +124,70 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
     const iree_io_parameter_index_entry_t** out_entry);
 
 // Performs a file entry lookup of |key| in the index and returns it.
+// If multiple entries were added with the same key the first is returned.
+// Lookups are constant time on average.
+// If the key is not found any resolvers are queried to add it.
 // The returned |out_entry| is valid for the lifetime of the index.
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
     iree_io_parameter_index_t* index, iree_string_view_t key,
     const iree_io_parameter_index_entry_t** out_entry);
 
+// Performs a file entry lookup of each of the |key_count| |keys| in the index
+// and returns them in the matching slot of |out_entries|. Equivalent to calling
+// iree_io_parameter_index_lookup for each key but only acquires the index lock
+// once. Fails if any key is not found in which case all |out_entries| will be
+// NULL. The returned entries are valid for the lifetime of the index.
+IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup_batch(
+    iree_io_parameter_index_t* index, iree_host_size_t key_count,
+    const iree_string_view_t* keys,
+    const iree_io_parameter_index_entry_t** out_entries);
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_index_resolver_t
+//===----------------------------------------------------------------------===//
+
+// Resolves entries lazily added to |index|.
+// If |key| is non-empty the resolver should add the entry with that key (and
+// any others it can cheaply add at the same time) if it is able to provide it
+// and otherwise return OK without adding anything. If |key| is empty the
+// resolver must add all entries it can provide. Called without the index lock
+// held such that implementations can use iree_io_parameter_index_add.
+// May be called concurrently from multiple threads.
+typedef iree_status_t(IREE_API_PTR* iree_io_parameter_index_resolve_fn_t)(
+    void* user_data, iree_io_parameter_index_t* index, iree_string_view_t key);
+
+// Releases the resolver user data when the index is destroyed.
+typedef void(IREE_API_PTR* iree_io_parameter_index_resolver_release_fn_t)(
+    void* user_data);
+
+// A source of entries that are added to an index on demand.
+// This allows formats spanning many files to defer reading their contents
+// until the entries are looked up.
+typedef struct iree_io_parameter_index_resolver_t {
+  // Resolves entries by key (or all entries if the key is empty).
+  iree_io_parameter_index_resolve_fn_t resolve;
+  // Optional function releasing |user_data|.
+  iree_io_parameter_index_resolver_release_fn_t release;
+  // User data passed to each callback. Owned by the index once added.
+  void* user_data;
+} iree_io_parameter_index_resolver_t;
+
+// Adds a |resolver| to |index| that will be queried in the order added when a
+// lookup misses. The index takes ownership of the resolver user data and will
+// release it when the index is destroyed (or if adding the resolver fails).
+IREE_API_EXPORT iree_status_t iree_io_parameter_index_add_resolver(
+    iree_io_parameter_index_t* index,
+    iree_io_parameter_index_resolver_t resolver);
+
+// Resolves all lazily added entries such that they are available via
+// iree_io_parameter_index_count and iree_io_parameter_index_get.
+// Must be called prior to enumerating an index that may have resolvers.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_resolve_all(iree_io_parameter_index_t* index);
+
 // Formats a textual dump of the parameter |index| to |builder|.
 // An optional |scope| name can be provided to include in the dump.
+// All lazily added entries are resolved prior to dumping.
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_dump(
     iree_string_view_t scope, iree_io_parameter_index_t* index,
     iree_string_builder_t* builder);
@@ -131,6 +197,52 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_dump(
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_fprint(
     FILE* file, iree_string_view_t scope, iree_io_parameter_index_t* index);
 
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_transform_t
+//===----------------------------------------------------------------------===//
+
+// Queries whether the contents of |entry| are transformed when loaded.
+// If transformed |out_length| receives the length in bytes of the transformed
+// contents; all parameter ranges referencing the entry are then relative to
+// the transformed contents instead of those stored in the file.
+typedef iree_status_t(IREE_API_PTR* iree_io_parameter_transform_query_fn_t)(
+    void* user_data, const iree_io_parameter_index_entry_t* entry,
+    bool* out_transformed, uint64_t* out_length);
+
+// Transforms the full |source| contents of |entry| as stored in its file into
+// the |target| storage with the length returned by the query function.
+// May be called concurrently from multiple threads for different entries.
+typedef iree_status_t(IREE_API_PTR* iree_io_parameter_transform_apply_fn_t)(
+    void* user_data, const iree_io_parameter_index_entry_t* entry,
+    iree_const_byte_span_t source, iree_byte_span_t target);
+
+// A transform applied to parameter contents as they are loaded.
+// This allows for repacking parameters from their storage layout (such as
+// block-quantized formats) into the layout expected by the consuming program
+// while the parameters are being streamed instead of as a separate step with
+// an additional copy of the parameters in memory.
+typedef struct iree_io_parameter_transform_t {
+  // Queries whether an entry is transformed and its transformed length.
+  iree_io_parameter_transform_query_fn_t query;
+  // Applies the transform to an entry for which query returned true.
+  iree_io_parameter_transform_apply_fn_t apply;
+  // User data passed to each callback.
+  void* user_data;
+} iree_io_parameter_transform_t;
+
+// Returns a transform that leaves all parameters unmodified.
+static inline iree_io_parameter_transform_t iree_io_parameter_transform_null(
+    void) {
+  iree_io_parameter_transform_t transform = {NULL, NULL, NULL};
+  return transform;
+}
+
+// Returns true if |transform| is a null transform.
+static inline bool iree_io_parameter_transform_is_null(
+    iree_io_parameter_transform_t transform) {
+  return transform.query == NULL;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
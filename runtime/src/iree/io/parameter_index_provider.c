@@ -6,7 +6,9 @@
 
 #include "iree/io/parameter_index_provider.h"
 
-#include "iree/hal/utils/file_cache.h"
+#include <stdlib.h>
+
+#include "iree/io/compression.h"
 
 // Limit concurrent operations to avoid blowing the stack. This is arbitrary and
 // if we wanted to support more we could switch to using heap allocations or
@@ -20,6 +22,7 @@ typedef struct iree_io_parameter_index_provider_t {
   iree_string_view_t scope;
   iree_io_parameter_index_t* index;
   iree_hal_file_cache_t* file_cache;
+  iree_io_parameter_transform_t transform;
 } iree_io_parameter_index_provider_t;
 
 static const iree_io_parameter_provider_vtable_t
@@ -39,16 +42,68 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   IREE_ASSERT_ARGUMENT(out_provider);
   *out_provider = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Private cache used only by this provider.
+  iree_hal_file_cache_params_t file_cache_params;
+  iree_hal_file_cache_params_initialize(&file_cache_params);
+  iree_hal_file_cache_t* file_cache = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_file_cache_create(file_cache_params, host_allocator,
+                                     &file_cache));
+
+  iree_status_t status =
+      iree_io_parameter_index_provider_create_with_file_cache(
+          scope, index, max_concurrent_operations, file_cache, host_allocator,
+          out_provider);
+
+  iree_hal_file_cache_release(file_cache);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_file_cache(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    iree_host_size_t max_concurrent_operations,
+    iree_hal_file_cache_t* file_cache, iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider) {
+  return iree_io_parameter_index_provider_create_with_transform(
+      scope, index, max_concurrent_operations, file_cache,
+      iree_io_parameter_transform_null(), host_allocator, out_provider);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_transform(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    iree_host_size_t max_concurrent_operations,
+    iree_hal_file_cache_t* file_cache, iree_io_parameter_transform_t transform,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider) {
+  IREE_ASSERT_ARGUMENT(index);
+  IREE_ASSERT_ARGUMENT(file_cache);
+  IREE_ASSERT_ARGUMENT(out_provider);
+  *out_provider = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, scope.data, scope.size);
 
   max_concurrent_operations =
       iree_max(1, iree_min(max_concurrent_operations,
                            IREE_IO_PARAMETER_OP_BATCH_MAX_CONCURRENCY));
 
+  // Reference the scope in the cache first so that if it fails we don't need
+  // to worry about releasing it during cleanup.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_file_cache_acquire_scope(file_cache, scope));
+
   iree_io_parameter_index_provider_t* provider = NULL;
   iree_host_size_t total_size = sizeof(*provider) + scope.size;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&provider));
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, total_size, (void**)&provider);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_file_cache_release_scope(file_cache, scope);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
   iree_atomic_ref_count_init(&provider->base.ref_count);
   provider->base.vtable = &iree_io_parameter_index_provider_vtable;
   provider->host_allocator = host_allocator;
@@ -61,16 +116,14 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   provider->index = index;
   iree_io_parameter_index_retain(index);
 
-  iree_status_t status =
-      iree_hal_file_cache_create(host_allocator, &provider->file_cache);
+  provider->file_cache = file_cache;
+  iree_hal_file_cache_retain(file_cache);
 
-  if (iree_status_is_ok(status)) {
-    *out_provider = (iree_io_parameter_provider_t*)provider;
-  } else {
-    iree_io_parameter_provider_release((iree_io_parameter_provider_t*)provider);
-  }
+  provider->transform = transform;
+
+  *out_provider = (iree_io_parameter_provider_t*)provider;
   IREE_TRACE_ZONE_END(z0);
-  return status;
+  return iree_ok_status();
 }
 
 static void iree_io_parameter_index_provider_destroy(
@@ -80,6 +133,7 @@ static void iree_io_parameter_index_provider_destroy(
   iree_allocator_t host_allocator = provider->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_file_cache_release_scope(provider->file_cache, provider->scope);
   iree_hal_file_cache_release(provider->file_cache);
   iree_io_parameter_index_release(provider->index);
 
@@ -143,8 +197,9 @@ static iree_status_t iree_io_parameter_index_provider_resolve(
   if (entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE) {
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0,
-        iree_hal_file_cache_lookup(provider->file_cache, device, queue_affinity,
-                                   access, entry->storage.file.handle,
+        iree_hal_file_cache_lookup(provider->file_cache, provider->scope,
+                                   device, queue_affinity, access,
+                                   entry->storage.file.handle,
                                    IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE, &file));
   }
 
@@ -155,10 +210,12 @@ static iree_status_t iree_io_parameter_index_provider_resolve(
 }
 
 // Validates that the range specified by [offset, offset+length) is in bounds.
+// |entry_length| is the length of the entry contents as seen by the caller and
+// may differ from the stored length of the entry when it is transformed.
 static iree_status_t iree_io_validate_parameter_range(
     iree_hal_memory_access_t required_access,
-    const iree_io_parameter_index_entry_t* entry, uint64_t offset,
-    uint64_t length) {
+    const iree_io_parameter_index_entry_t* entry, uint64_t entry_length,
+    uint64_t offset, uint64_t length) {
   iree_hal_memory_access_t allowed_access = IREE_HAL_MEMORY_ACCESS_NONE;
   switch (entry->type) {
     case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT:
@@ -203,17 +260,123 @@ static iree_status_t iree_io_validate_parameter_range(
 #endif  // IREE_STATUS_MODE
   }
 
-  if (offset + length > entry->length) {
+  if (offset + length > entry_length) {
     return iree_make_status(
         IREE_STATUS_OUT_OF_RANGE,
         "parameter `%.*s` range out of bounds (offset=%" PRIu64
         ", length=%" PRIu64 ", size=%" PRIu64 ")",
-        (int)entry->key.size, entry->key.data, offset, length, entry->length);
+        (int)entry->key.size, entry->key.data, offset, length, entry_length);
   }
 
   return iree_ok_status();
 }
 
+// Queries whether |entry| is transformed by the |provider| transform.
+// Returns the length of the entry contents as seen by callers in
+// |out_entry_length|: the transformed length if transformed and otherwise the
+// stored length.
+static iree_status_t iree_io_parameter_index_provider_query_transform(
+    iree_io_parameter_index_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry, bool* out_transformed,
+    uint64_t* out_entry_length) {
+  *out_transformed = false;
+  *out_entry_length = entry->length;
+  // Compressed contents are always decompressed on the host and bypass any
+  // user transform; the entry length is already the decompressed length.
+  if (entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE &&
+      entry->storage.file.compression != IREE_IO_COMPRESSION_TYPE_NONE) {
+    *out_transformed = true;
+    return iree_ok_status();
+  }
+  // Only file contents can be transformed; splats are synthetic and would need
+  // the transform to understand the pattern.
+  if (iree_io_parameter_transform_is_null(provider->transform) ||
+      entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE) {
+    return iree_ok_status();
+  }
+  bool transformed = false;
+  uint64_t transformed_length = 0;
+  IREE_RETURN_IF_ERROR(provider->transform.query(
+      provider->transform.user_data, entry, &transformed, &transformed_length));
+  if (transformed) {
+    *out_transformed = true;
+    *out_entry_length = transformed_length;
+  }
+  return iree_ok_status();
+}
+
+// Applies the |provider| transform to |entry| and writes the
+// |transformed_length| bytes of transformed contents into |buffer| starting at
+// |buffer_offset|. The transform reads directly from the file backing the
+// entry and writes directly into the mapped buffer memory such that the file
+// contents are only read once and never copied into an intermediate
+// allocation. Compressed entries are decompressed in parallel instead.
+static iree_status_t iree_io_parameter_index_provider_apply_transform(
+    iree_io_parameter_index_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry, uint64_t transformed_length,
+    iree_hal_buffer_t* buffer, iree_device_size_t buffer_offset) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, entry->key.data, entry->key.size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, transformed_length);
+
+  // TODO(benvanik): support streaming non-mapped files through a bounce
+  // buffer. Today GGUF and other formats loaded for transformation are almost
+  // always mapped so this is not a big limitation.
+  iree_io_file_handle_t* file_handle = entry->storage.file.handle;
+  if (iree_io_file_handle_type(file_handle) !=
+      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "parameter `%.*s` is transformed but its file is not host-accessible; "
+        "only mapped or host allocation files can be transformed",
+        (int)entry->key.size, entry->key.data);
+  }
+  iree_byte_span_t host_allocation =
+      iree_io_file_handle_value(file_handle).host_allocation;
+  const bool is_compressed =
+      entry->storage.file.compression != IREE_IO_COMPRESSION_TYPE_NONE;
+  const uint64_t stored_length =
+      is_compressed ? entry->storage.file.compressed_length : entry->length;
+  if (entry->storage.file.offset + stored_length >
+      host_allocation.data_length) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "parameter `%.*s` storage out of bounds of its file (offset=%" PRIu64
+        ", length=%" PRIu64 ", file size=%" PRIhsz ")",
+        (int)entry->key.size, entry->key.data, entry->storage.file.offset,
+        stored_length, host_allocation.data_length);
+  }
+  iree_const_byte_span_t source = iree_make_const_byte_span(
+      host_allocation.data + entry->storage.file.offset,
+      (iree_host_size_t)stored_length);
+
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_buffer_map_range(
+              buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+              IREE_HAL_MEMORY_ACCESS_WRITE | IREE_HAL_MEMORY_ACCESS_DISCARD,
+              buffer_offset, transformed_length, &mapping));
+  iree_status_t status = iree_ok_status();
+  if (is_compressed) {
+    status = iree_io_decompress(source, mapping.contents,
+                                IREE_IO_COMPRESSION_MAX_CONCURRENCY,
+                                provider->host_allocator);
+  } else {
+    status = provider->transform.apply(provider->transform.user_data, entry,
+                                       source, mapping.contents);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_buffer_mapping_flush_range(&mapping, 0,
+                                                 IREE_WHOLE_BUFFER);
+  }
+  status = iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Stateful batch management of multiple parameter operations.
 //
 // The batch distributes operations over multiple timelines based on how much
@@ -318,20 +481,28 @@ static void iree_io_parameter_op_batch_begin(
 // |access| indicates the required access permissions to the parameter storage.
 // Returns the entry, the span indicating source/target ranges, and optionally
 // a file (NULL if a splat). |out_file| is retained and must be released by the
-// caller if set.
+// caller if set. If the entry is transformed by the provider |out_transformed|
+// is set, the span is relative to the transformed contents, and
+// |out_entry_length| contains the total transformed length.
 static iree_status_t iree_io_parameter_op_batch_resolve_entry(
     const iree_io_parameter_op_batch_t* batch, iree_string_view_t scope,
     iree_io_parameter_enumerator_t enumerator, iree_host_size_t i,
     iree_hal_memory_access_t access,
     const iree_io_parameter_index_entry_t** IREE_RESTRICT out_entry,
     iree_io_parameter_span_t* IREE_RESTRICT out_span,
-    iree_hal_file_t** IREE_RESTRICT out_file) {
+    iree_hal_file_t** IREE_RESTRICT out_file,
+    bool* IREE_RESTRICT out_transformed,
+    uint64_t* IREE_RESTRICT out_entry_length) {
   IREE_ASSERT_ARGUMENT(out_entry);
   IREE_ASSERT_ARGUMENT(out_span);
   IREE_ASSERT_ARGUMENT(out_file);
+  IREE_ASSERT_ARGUMENT(out_transformed);
+  IREE_ASSERT_ARGUMENT(out_entry_length);
   *out_entry = NULL;
   memset(out_span, 0, sizeof(*out_span));
   *out_file = NULL;
+  *out_transformed = false;
+  *out_entry_length = 0;
 
   // Fetch the next parameter to copy and its buffer range.
   iree_string_view_t key = iree_string_view_empty();
@@ -345,14 +516,25 @@ static iree_status_t iree_io_parameter_op_batch_resolve_entry(
       batch->provider, batch->device, batch->queue_affinity, scope, key, access,
       &entry, &file));
 
+  // Transformed entries have their ranges validated against the transformed
+  // contents as that's what callers observe.
+  bool transformed = false;
+  uint64_t entry_length = 0;
+  iree_status_t status = iree_io_parameter_index_provider_query_transform(
+      batch->provider, entry, &transformed, &entry_length);
+
   // Validate the parameter range is in-bounds.
-  iree_status_t status = iree_io_validate_parameter_range(
-      access, entry, span.parameter_offset, span.length);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_validate_parameter_range(
+        access, entry, entry_length, span.parameter_offset, span.length);
+  }
 
   if (iree_status_is_ok(status)) {
     *out_entry = entry;
     *out_span = span;
     *out_file = file;
+    *out_transformed = transformed;
+    *out_entry_length = entry_length;
   } else {
     iree_hal_file_release(file);
   }
@@ -563,6 +745,54 @@ static iree_status_t iree_io_parameter_op_batch_enqueue_file_write(
   return status;
 }
 
+// Enqueues a transformed read of |entry| in the batch.
+// The transform is applied on the host into a staging buffer as the operation
+// is enqueued and the transformed range [source_offset, source_offset+length)
+// is then copied into |target_buffer| in queue order. The staging buffer is
+// released as soon as the copy completes.
+static iree_status_t iree_io_parameter_op_batch_enqueue_transform(
+    iree_io_parameter_op_batch_t* batch,
+    const iree_io_parameter_index_entry_t* entry, uint64_t transformed_length,
+    uint64_t source_offset, iree_hal_buffer_t* target_buffer,
+    iree_device_size_t target_buffer_offset, iree_device_size_t length) {
+  IREE_ASSERT_ARGUMENT(batch);
+  IREE_ASSERT_ARGUMENT(entry);
+  IREE_ASSERT_ARGUMENT(target_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Host-local staging memory the device can copy from.
+  const iree_hal_buffer_params_t staging_params = {
+      .type =
+          IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
+      .usage = IREE_HAL_BUFFER_USAGE_TRANSFER | IREE_HAL_BUFFER_USAGE_MAPPING,
+      .queue_affinity = batch->queue_affinity,
+  };
+  iree_hal_buffer_t* staging_buffer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_allocator_allocate_buffer(
+              iree_hal_device_allocator(batch->device), staging_params,
+              transformed_length, &staging_buffer));
+
+  iree_status_t status = iree_io_parameter_index_provider_apply_transform(
+      batch->provider, entry, transformed_length, staging_buffer, 0);
+
+  iree_io_parameter_op_step_t step;
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_op_batch_advance_timeline(batch, length, &step);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_copy(
+        batch->device, batch->queue_affinity, step.wait_semaphore_list,
+        step.signal_semaphore_list, staging_buffer, source_offset,
+        target_buffer, target_buffer_offset, length);
+  }
+
+  // The queue operation retains the staging buffer until it completes.
+  iree_hal_buffer_release(staging_buffer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Flushes any outstanding work in the |batch| and signals the user timeline.
 // Must only be called once at the end of the batch.
 static iree_status_t iree_io_parameter_op_batch_flush(
@@ -589,7 +819,8 @@ static iree_status_t iree_io_parameter_op_batch_flush(
     if (iree_status_is_ok(status)) {
       status = iree_hal_device_queue_execute(
           batch->device, batch->queue_affinity, step.wait_semaphore_list,
-          step.signal_semaphore_list, 1, &batch->transfer_command_buffer);
+          step.signal_semaphore_list, 1, &batch->transfer_command_buffer,
+          /*binding_tables=*/NULL);
     }
     IREE_TRACE_ZONE_END(z_transfer);
   }
@@ -673,6 +904,134 @@ static void iree_io_file_handle_buffer_release(void* user_data,
   iree_io_file_handle_release((iree_io_file_handle_t*)user_data);
 }
 
+// Tries to import the parameter |span| of |entry| directly from its backing
+// file storage as a buffer with |target_params| without performing any copies.
+// This only works with specific file types and with specific target usage. The
+// most common cases for this are when using parameters as staging sources (so
+// host memory is ok) or on unified memory systems such as the local CPU drivers
+// (where host memory is device memory) and the file was originally mapped.
+// When mapped the pages are faulted in lazily on first access instead of being
+// eagerly copied into a device allocation.
+//
+// Returns true and a retained |out_buffer| if the import succeeded. Returns
+// false if the import is not possible and the caller must fall back to
+// allocating and reading the parameter.
+static bool iree_io_parameter_index_provider_try_import(
+    iree_hal_device_t* device, iree_hal_buffer_params_t target_params,
+    const iree_io_parameter_index_entry_t* entry, iree_io_parameter_span_t span,
+    iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE ||
+      span.buffer_offset != 0) {
+    return false;
+  }
+  iree_io_file_handle_t* file_handle = entry->storage.file.handle;
+  if (iree_io_file_handle_type(file_handle) !=
+      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    return false;
+  }
+
+  // Mapped files are often read-only and importing them for writing would
+  // fault on first access instead of failing gracefully.
+  if (iree_any_bit_set(target_params.access, IREE_HAL_MEMORY_ACCESS_WRITE) &&
+      !iree_all_bits_set(iree_io_file_handle_access(file_handle),
+                         IREE_IO_FILE_ACCESS_WRITE)) {
+    return false;
+  }
+
+  // Unaligned parameters would be rejected by all allocators; checking here
+  // avoids the cost of the failing import (status allocation) per parameter.
+  iree_byte_span_t host_allocation =
+      iree_io_file_handle_value(file_handle).host_allocation;
+  uint8_t* ptr =
+      host_allocation.data + entry->storage.file.offset + span.parameter_offset;
+  if (!iree_host_size_has_alignment((iree_host_size_t)ptr,
+                                    IREE_HAL_HEAP_BUFFER_ALIGNMENT)) {
+    return false;
+  }
+
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+      .size = span.length,
+      .handle =
+          {
+              .host_allocation =
+                  {
+                      .ptr = ptr,
+                  },
+          },
+  };
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_io_file_handle_buffer_release,
+      .user_data = file_handle,
+  };
+  iree_io_file_handle_retain(file_handle);
+  iree_status_t import_status = iree_hal_allocator_import_buffer(
+      iree_hal_device_allocator(device), target_params, &external_buffer,
+      release_callback, out_buffer);
+  if (!iree_status_is_ok(import_status)) {
+    // Failed to import - that's ok as the caller will do the full allocate +
+    // read.
+    iree_status_ignore(import_status);
+    iree_io_file_handle_release(file_handle);
+    *out_buffer = NULL;
+    return false;
+  }
+  return true;
+}
+
+// Tries to allocate a host-mappable buffer with |target_params| and transform
+// the parameter |span| of |entry| directly into it. This is possible on
+// unified memory systems and avoids any staging memory or device copies. Only
+// full entries are transformed in place as partial ranges would require
+// transforming into temporary memory anyway.
+//
+// Returns a retained |out_buffer| if the transform succeeded or NULL if the
+// target memory is not mappable and the caller must fall back to a staged
+// transform.
+static iree_status_t iree_io_parameter_index_provider_try_transform_in_place(
+    iree_io_parameter_index_provider_t* provider, iree_hal_device_t* device,
+    iree_hal_buffer_params_t target_params,
+    const iree_io_parameter_index_entry_t* entry, uint64_t transformed_length,
+    iree_io_parameter_span_t span, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (span.parameter_offset != 0 || span.buffer_offset != 0 ||
+      span.length != transformed_length) {
+    return iree_ok_status();
+  }
+
+  // Only use mappable memory if the device considers it fast; otherwise we'd
+  // trade a one-time copy for slower access on every use.
+  iree_hal_allocator_t* device_allocator = iree_hal_device_allocator(device);
+  iree_hal_buffer_params_t mappable_params = target_params;
+  mappable_params.type |= IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  mappable_params.usage |= IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED;
+  iree_device_size_t allocation_size = 0;
+  iree_hal_buffer_compatibility_t compatibility =
+      iree_hal_allocator_query_buffer_compatibility(
+          device_allocator, mappable_params, span.length, &mappable_params,
+          &allocation_size);
+  if (!iree_all_bits_set(compatibility,
+                         IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE) ||
+      iree_any_bit_set(compatibility,
+                       IREE_HAL_BUFFER_COMPATIBILITY_LOW_PERFORMANCE)) {
+    return iree_ok_status();
+  }
+
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+      device_allocator, mappable_params, allocation_size, &buffer));
+  iree_status_t status = iree_io_parameter_index_provider_apply_transform(
+      provider, entry, transformed_length, buffer, 0);
+  if (iree_status_is_ok(status)) {
+    *out_buffer = buffer;
+  } else {
+    iree_hal_buffer_release(buffer);
+  }
+  return status;
+}
+
 static iree_status_t iree_io_parameter_index_provider_load(
     iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
     iree_hal_queue_affinity_t queue_affinity,
@@ -703,9 +1062,11 @@ static iree_status_t iree_io_parameter_index_provider_load(
     const iree_io_parameter_index_entry_t* source_entry = NULL;
     iree_io_parameter_span_t span;
     iree_hal_file_t* source_file = NULL;  // retained, NULL if splat
+    bool transformed = false;
+    uint64_t entry_length = 0;
     status = iree_io_parameter_op_batch_resolve_entry(
         &batch, source_scope, enumerator, i, IREE_HAL_MEMORY_ACCESS_READ,
-        &source_entry, &span, &source_file);
+        &source_entry, &span, &source_file, &transformed, &entry_length);
     if (iree_status_is_ok(status)) {
       IREE_TRACE_ZONE_APPEND_TEXT(z_entry, source_entry->key.data,
                                   source_entry->key.size);
@@ -720,52 +1081,30 @@ static iree_status_t iree_io_parameter_index_provider_load(
     // extremely expensive driver handling. Startup paths with parameters aren't
     // usually critical, though, so it's (probably) fine today as-is.
 
-    // Try first to reuse the file backing store directly as a buffer. This only
-    // works with specific file types and with specific target usage. The most
-    // common cases for this are when using parameters as staging sources (so
-    // host memory is ok) or on unified memory systems (where host memory is
-    // device memory) and the file was originally mapped. We could extend the
-    // conditions in which we use this with some better file handle helpers that
-    // allow us to map files that we already have open via other mechanisms
-    // (FILE, fd, etc).
+    // Try first to reuse the file backing store directly as a buffer. We could
+    // extend the conditions in which we use this with some better file handle
+    // helpers that allow us to map files that we already have open via other
+    // mechanisms (FILE, fd, etc).
+    //
+    // Transformed entries can't be imported as the file contents differ from
+    // what the caller expects but on unified memory systems we can still
+    // transform directly into the target buffer.
     iree_hal_buffer_t* target_buffer = NULL;
-    if (iree_status_is_ok(status) &&
-        source_entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE &&
-        iree_io_file_handle_type(source_entry->storage.file.handle) ==
-            IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-      iree_byte_span_t host_allocation =
-          iree_io_file_handle_primitive(source_entry->storage.file.handle)
-              .value.host_allocation;
-      iree_hal_external_buffer_t external_buffer = {
-          .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
-          .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
-          .size = host_allocation.data_length,
-          .handle =
-              {
-                  .host_allocation =
-                      {
-                          .ptr = host_allocation.data +
-                                 source_entry->storage.file.offset,
-                      },
-              },
-      };
-      iree_hal_buffer_release_callback_t release_callback = {
-          .fn = iree_io_file_handle_buffer_release,
-          .user_data = source_entry->storage.file.handle,
-      };
-      iree_io_file_handle_retain(source_entry->storage.file.handle);
-      iree_status_t import_status = iree_hal_allocator_import_buffer(
-          iree_hal_device_allocator(device), target_params, &external_buffer,
-          release_callback, &target_buffer);
-      if (iree_status_is_ok(import_status)) {
-        // Import succeeded - issue a barrier to preserve the async timeline.
+    if (iree_status_is_ok(status) && transformed) {
+      status = iree_io_parameter_index_provider_try_transform_in_place(
+          provider, device, target_params, source_entry, entry_length, span,
+          &target_buffer);
+      IREE_TRACE_ZONE_APPEND_TEXT(z_entry, target_buffer
+                                               ? "transform in place succeeded"
+                                               : "transform in place failed");
+    } else if (iree_status_is_ok(status)) {
+      if (iree_io_parameter_index_provider_try_import(
+              device, target_params, source_entry, span, &target_buffer)) {
+        // Import succeeded - the batch flush will issue a barrier to preserve
+        // the async timeline.
         IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "import succeeded");
       } else {
-        // Failed to import - that's ok as we'll just do the full allocate +
-        // read.
         IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "import failed");
-        import_status = iree_status_ignore(import_status);
-        iree_io_file_handle_release(source_entry->storage.file.handle);
       }
     }
 
@@ -778,7 +1117,11 @@ static iree_status_t iree_io_parameter_index_provider_load(
           &target_buffer);
 
       // Enqueue the operation on the same timeline as the allocation.
-      if (iree_status_is_ok(status)) {
+      if (iree_status_is_ok(status) && transformed) {
+        status = iree_io_parameter_op_batch_enqueue_transform(
+            &batch, source_entry, entry_length, span.parameter_offset,
+            target_buffer, span.buffer_offset, span.length);
+      } else if (iree_status_is_ok(status)) {
         switch (source_entry->type) {
           case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT: {
             IREE_ASSERT(!source_file);
@@ -829,6 +1172,101 @@ static iree_status_t iree_io_parameter_index_provider_load(
   return status;
 }
 
+// Maximum length of a single file read produced by coalescing adjacent gather
+// spans. Bounded so that large batches are still distributed across timelines.
+#define IREE_IO_PARAMETER_GATHER_MAX_COALESCED_LENGTH (64 * 1024 * 1024)
+
+// Maximum gap in bytes between file ranges that are merged into a single
+// prefetch hint. Reading ahead over a small gap is cheaper than another seek.
+#define IREE_IO_PARAMETER_GATHER_MAX_PREFETCH_GAP (1 * 1024 * 1024)
+
+// A gather file read deferred until all spans have been resolved such that the
+// reads can be issued in file order.
+typedef struct iree_io_parameter_gather_read_t {
+  // Source file handle from the index entry. Unretained as the index owns it.
+  iree_io_file_handle_t* handle;
+  // HAL file imported from |handle|, retained.
+  iree_hal_file_t* file;
+  // Absolute offset in the file to begin reading.
+  uint64_t file_offset;
+  // Offset in the target buffer to write the read contents.
+  iree_device_size_t buffer_offset;
+  // Length of the read in bytes.
+  iree_device_size_t length;
+} iree_io_parameter_gather_read_t;
+
+// Orders reads by file and then by offset within the file.
+static int iree_io_parameter_gather_read_compare(const void* lhs_ptr,
+                                                 const void* rhs_ptr) {
+  const iree_io_parameter_gather_read_t* lhs =
+      (const iree_io_parameter_gather_read_t*)lhs_ptr;
+  const iree_io_parameter_gather_read_t* rhs =
+      (const iree_io_parameter_gather_read_t*)rhs_ptr;
+  if (lhs->handle != rhs->handle) {
+    return (uintptr_t)lhs->handle < (uintptr_t)rhs->handle ? -1 : 1;
+  }
+  if (lhs->file != rhs->file) {
+    return (uintptr_t)lhs->file < (uintptr_t)rhs->file ? -1 : 1;
+  }
+  if (lhs->file_offset != rhs->file_offset) {
+    return lhs->file_offset < rhs->file_offset ? -1 : 1;
+  }
+  return 0;
+}
+
+// Issues read-ahead hints for all of the file-ordered |reads|. Nearby ranges
+// are merged such that the platform sees a few large sequential regions.
+static void iree_io_parameter_gather_prefetch(
+    const iree_io_parameter_gather_read_t* reads, iree_host_size_t count) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_host_size_t i = 0;
+  while (i < count) {
+    iree_io_file_handle_t* handle = reads[i].handle;
+    const uint64_t range_begin = reads[i].file_offset;
+    uint64_t range_end = range_begin + reads[i].length;
+    for (++i; i < count && reads[i].handle == handle &&
+              reads[i].file_offset <=
+                  range_end + IREE_IO_PARAMETER_GATHER_MAX_PREFETCH_GAP;
+         ++i) {
+      range_end = iree_max(range_end, reads[i].file_offset + reads[i].length);
+    }
+    iree_io_file_handle_prefetch(handle, range_begin, range_end - range_begin);
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Enqueues all of the file-ordered |reads| into |target_buffer|. Runs of reads
+// that are contiguous in both the file and the target buffer are merged into a
+// single read.
+static iree_status_t iree_io_parameter_gather_enqueue_reads(
+    iree_io_parameter_op_batch_t* batch,
+    const iree_io_parameter_gather_read_t* reads, iree_host_size_t count,
+    iree_hal_buffer_t* target_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t coalesced_count = 0;
+  iree_host_size_t i = 0;
+  while (i < count && iree_status_is_ok(status)) {
+    const iree_io_parameter_gather_read_t* read = &reads[i];
+    iree_device_size_t length = read->length;
+    for (++i; i < count && reads[i].file == read->file &&
+              reads[i].file_offset == read->file_offset + length &&
+              reads[i].buffer_offset == read->buffer_offset + length &&
+              length + reads[i].length <=
+                  IREE_IO_PARAMETER_GATHER_MAX_COALESCED_LENGTH;
+         ++i) {
+      length += reads[i].length;
+    }
+    status = iree_io_parameter_op_batch_enqueue_file_read(
+        batch, read->file, read->file_offset, target_buffer,
+        read->buffer_offset, length, 0);
+    ++coalesced_count;
+  }
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)coalesced_count);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_io_parameter_index_provider_gather(
     iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
     iree_hal_queue_affinity_t queue_affinity,
@@ -847,9 +1285,20 @@ static iree_status_t iree_io_parameter_index_provider_gather(
                                    wait_semaphore_list, signal_semaphore_list,
                                    &batch);
 
-  // Process each entry by enqueuing the appropriate operation.
+  // File reads are deferred until all entries have been resolved so that they
+  // can be sorted by file offset, coalesced, and prefetched. Programs tend to
+  // gather parameters in an order unrelated to where they are stored and
+  // issuing the reads as-is results in random I/O on cold caches.
+  iree_io_parameter_gather_read_t* reads = NULL;
+  iree_host_size_t read_count = 0;
   iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < count; ++i) {
+  if (count > 0) {
+    status = iree_allocator_malloc(provider->host_allocator,
+                                   count * sizeof(reads[0]), (void**)&reads);
+  }
+
+  // Process each entry by enqueuing the appropriate operation.
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
     IREE_TRACE_ZONE_BEGIN_NAMED(
         z_entry, "iree_io_parameter_index_provider_gather_entry");
     IREE_TRACE_ZONE_APPEND_VALUE_I64(z_entry, i);
@@ -858,9 +1307,11 @@ static iree_status_t iree_io_parameter_index_provider_gather(
     const iree_io_parameter_index_entry_t* source_entry = NULL;
     iree_io_parameter_span_t span;
     iree_hal_file_t* source_file = NULL;  // retained, NULL if splat
+    bool transformed = false;
+    uint64_t entry_length = 0;
     status = iree_io_parameter_op_batch_resolve_entry(
         &batch, source_scope, enumerator, i, IREE_HAL_MEMORY_ACCESS_READ,
-        &source_entry, &span, &source_file);
+        &source_entry, &span, &source_file, &transformed, &entry_length);
     if (iree_status_is_ok(status)) {
       IREE_TRACE_ZONE_APPEND_TEXT(z_entry, source_entry->key.data,
                                   source_entry->key.size);
@@ -868,7 +1319,11 @@ static iree_status_t iree_io_parameter_index_provider_gather(
     }
 
     // Enqueue the transfer/file operation.
-    if (iree_status_is_ok(status)) {
+    if (iree_status_is_ok(status) && transformed) {
+      status = iree_io_parameter_op_batch_enqueue_transform(
+          &batch, source_entry, entry_length, span.parameter_offset,
+          target_buffer, span.buffer_offset, span.length);
+    } else if (iree_status_is_ok(status)) {
       switch (source_entry->type) {
         case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT: {
           IREE_ASSERT(!source_file);
@@ -880,10 +1335,14 @@ static iree_status_t iree_io_parameter_index_provider_gather(
         }
         case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE: {
           IREE_ASSERT(source_file);
-          status = iree_io_parameter_op_batch_enqueue_file_read(
-              &batch, source_file,
-              source_entry->storage.file.offset + span.parameter_offset,
-              target_buffer, span.buffer_offset, span.length, 0);
+          iree_io_parameter_gather_read_t* read = &reads[read_count++];
+          read->handle = source_entry->storage.file.handle;
+          read->file = source_file;
+          read->file_offset =
+              source_entry->storage.file.offset + span.parameter_offset;
+          read->buffer_offset = span.buffer_offset;
+          read->length = span.length;
+          source_file = NULL;  // ownership transferred to the read
           break;
         }
         default: {
@@ -899,9 +1358,21 @@ static iree_status_t iree_io_parameter_index_provider_gather(
     iree_hal_file_release(source_file);
 
     IREE_TRACE_ZONE_END(z_entry);
-    if (!iree_status_is_ok(status)) break;
   }
 
+  // Issue all file reads in file order.
+  if (iree_status_is_ok(status) && read_count > 0) {
+    qsort(reads, read_count, sizeof(reads[0]),
+          iree_io_parameter_gather_read_compare);
+    iree_io_parameter_gather_prefetch(reads, read_count);
+    status = iree_io_parameter_gather_enqueue_reads(&batch, reads, read_count,
+                                                    target_buffer);
+  }
+  for (iree_host_size_t i = 0; i < read_count; ++i) {
+    iree_hal_file_release(reads[i].file);
+  }
+  iree_allocator_free(provider->host_allocator, reads);
+
   // Flush any outstanding batch operations and end the batch.
   status = iree_io_parameter_op_batch_end(&batch, status);
 
@@ -938,15 +1409,26 @@ static iree_status_t iree_io_parameter_index_provider_scatter(
     const iree_io_parameter_index_entry_t* target_entry = NULL;
     iree_io_parameter_span_t span;
     iree_hal_file_t* target_file = NULL;  // retained, NULL if splat
+    bool transformed = false;
+    uint64_t entry_length = 0;
     status = iree_io_parameter_op_batch_resolve_entry(
         &batch, target_scope, enumerator, i, IREE_HAL_MEMORY_ACCESS_WRITE,
-        &target_entry, &span, &target_file);
+        &target_entry, &span, &target_file, &transformed, &entry_length);
     if (iree_status_is_ok(status)) {
       IREE_TRACE_ZONE_APPEND_TEXT(z_entry, target_entry->key.data,
                                   target_entry->key.size);
       IREE_TRACE_ZONE_APPEND_VALUE_I64(z_entry, span.length);
     }
 
+    // Transforms are one-way and the stored contents can't be reconstructed
+    // from the transformed contents being scattered.
+    if (iree_status_is_ok(status) && transformed) {
+      status = iree_make_status(
+          IREE_STATUS_FAILED_PRECONDITION,
+          "scatter not supported with transformed parameters (`%.*s`)",
+          (int)target_entry->key.size, target_entry->key.data);
+    }
+
     // Enqueue the transfer/file operation.
     if (iree_status_is_ok(status)) {
       switch (target_entry->type) {
@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/utils/file_cache.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/parameter_provider.h"
 
@@ -35,6 +36,35 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
     iree_host_size_t max_concurrent_operations, iree_allocator_t host_allocator,
     iree_io_parameter_provider_t** out_provider);
 
+// Creates a parameter provider serving from the provided |index| that imports
+// files through the shared |file_cache|. Multiple providers (optionally across
+// multiple VM contexts) sharing the same cache will only import each file once
+// per device even if their indices are distinct. The provider acquires |scope|
+// in the cache for its lifetime such that files it has used are retained until
+// all providers with the same scope have been released.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_file_cache(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    iree_host_size_t max_concurrent_operations,
+    iree_hal_file_cache_t* file_cache, iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider);
+
+// Creates a parameter provider serving from the provided |index| that imports
+// files through the shared |file_cache| and applies |transform| to parameters
+// as they are loaded or gathered. Entries the transform selects are read once
+// from their backing file and repacked directly into device-visible memory
+// (the target buffer itself on unified memory systems and otherwise a staging
+// buffer that is copied to the target in queue order). Transformed entries must
+// be backed by host-accessible (mapped) files and cannot be scattered.
+// The transform user data must remain valid for the lifetime of the provider.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_transform(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    iree_host_size_t max_concurrent_operations,
+    iree_hal_file_cache_t* file_cache, iree_io_parameter_transform_t transform,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,121 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_index.h"
+
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+class ParameterIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(
+        iree_io_parameter_index_create(iree_allocator_system(), &index_));
+  }
+
+  void TearDown() override { iree_io_parameter_index_release(index_); }
+
+  // Adds a splat entry with |key| whose length is |length|.
+  void AddSplat(const std::string& key, uint64_t length) {
+    iree_io_parameter_index_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.key = iree_make_string_view(key.data(), key.size());
+    entry.length = length;
+    entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT;
+    entry.storage.splat.pattern_length = 1;
+    entry.storage.splat.pattern[0] = 0xCD;
+    IREE_ASSERT_OK(iree_io_parameter_index_add(index_, &entry));
+  }
+
+  iree_io_parameter_index_t* index_ = NULL;
+};
+
+TEST_F(ParameterIndexTest, LookupEmpty) {
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  EXPECT_THAT(iree_io_parameter_index_lookup(index_, IREE_SV("a"), &entry),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(entry, nullptr);
+}
+
+TEST_F(ParameterIndexTest, LookupMany) {
+  // Enough entries to force several growths of the index.
+  static const int kEntryCount = 1000;
+  for (int i = 0; i < kEntryCount; ++i) {
+    AddSplat("param" + std::to_string(i), i);
+  }
+  EXPECT_EQ(iree_io_parameter_index_count(index_), kEntryCount);
+  for (int i = 0; i < kEntryCount; ++i) {
+    std::string key = "param" + std::to_string(i);
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    IREE_ASSERT_OK(iree_io_parameter_index_lookup(
+        index_, iree_make_string_view(key.data(), key.size()), &entry));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->length, i);
+  }
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  EXPECT_THAT(
+      iree_io_parameter_index_lookup(index_, IREE_SV("param1000"), &entry),
+      StatusIs(StatusCode::kNotFound));
+}
+
+TEST_F(ParameterIndexTest, LookupAfterReserve) {
+  IREE_ASSERT_OK(iree_io_parameter_index_reserve(index_, 4));
+  AddSplat("a", 1);
+  IREE_ASSERT_OK(iree_io_parameter_index_reserve(index_, 100));
+  AddSplat("b", 2);
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(index_, IREE_SV("a"), &entry));
+  EXPECT_EQ(entry->length, 1);
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(index_, IREE_SV("b"), &entry));
+  EXPECT_EQ(entry->length, 2);
+}
+
+// Duplicate keys resolve to the first entry added.
+TEST_F(ParameterIndexTest, LookupDuplicate) {
+  AddSplat("a", 1);
+  AddSplat("a", 2);
+  for (int i = 0; i < 100; ++i) {
+    AddSplat("pad" + std::to_string(i), 0);
+  }
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup(index_, IREE_SV("a"), &entry));
+  EXPECT_EQ(entry->length, 1);
+}
+
+TEST_F(ParameterIndexTest, LookupBatch) {
+  AddSplat("a", 1);
+  AddSplat("b", 2);
+  AddSplat("c", 3);
+  iree_string_view_t keys[] = {IREE_SV("c"), IREE_SV("a"), IREE_SV("b")};
+  const iree_io_parameter_index_entry_t* entries[IREE_ARRAYSIZE(keys)] = {0};
+  IREE_ASSERT_OK(iree_io_parameter_index_lookup_batch(
+      index_, IREE_ARRAYSIZE(keys), keys, entries));
+  EXPECT_EQ(entries[0]->length, 3);
+  EXPECT_EQ(entries[1]->length, 1);
+  EXPECT_EQ(entries[2]->length, 2);
+}
+
+TEST_F(ParameterIndexTest, LookupBatchNotFound) {
+  AddSplat("a", 1);
+  iree_string_view_t keys[] = {IREE_SV("a"), IREE_SV("missing")};
+  const iree_io_parameter_index_entry_t* entries[IREE_ARRAYSIZE(keys)] = {0};
+  EXPECT_THAT(iree_io_parameter_index_lookup_batch(
+                  index_, IREE_ARRAYSIZE(keys), keys, entries),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(entries[0], nullptr);
+  EXPECT_EQ(entries[1], nullptr);
+}
+
+}  // namespace
@@ -34,6 +34,16 @@
 
 #endif  // IREE_PLATFORM_WINDOWS
 
+// Streams over seekable files bypass the stdio buffer for vectored reads and
+// writes and issue readv/writev directly against the underlying descriptor.
+#if IREE_FILE_IO_ENABLE && !defined(IREE_PLATFORM_WINDOWS) && \
+    !defined(IREE_PLATFORM_EMSCRIPTEN) && !defined(IREE_PLATFORM_GENERIC)
+#define IREE_IO_STDIO_STREAM_HAVE_VECTORED 1
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif  // IREE_FILE_IO_ENABLE && posix
+
 // Makes a new status message ala iree_make_status but includes the error number
 // and optional string message on platforms that support it.
 #if defined(IREE_PLATFORM_WINDOWS)
@@ -395,6 +405,167 @@ static iree_status_t iree_io_stdio_stream_map_write(
                           "stdio streams do not support mapping");
 }
 
+#if IREE_IO_STDIO_STREAM_HAVE_VECTORED
+
+// Maximum number of iovecs passed to a single readv/writev call. POSIX only
+// guarantees IOV_MAX >= 16 but all supported platforms allow at least 1024.
+#define IREE_IO_STDIO_STREAM_MAX_IOVECS 64
+
+// Transfers |buffers| to or from |fd| at its current file position, resuming
+// after partial transfers. Reads stop early at end-of-file. The number of bytes
+// transferred is returned in |out_total_length| even on failure.
+static iree_status_t iree_io_stdio_stream_transfer_fd(
+    int fd, bool is_write, iree_host_size_t buffer_count,
+    const iree_byte_span_t* buffers, iree_host_size_t* out_total_length) {
+  *out_total_length = 0;
+  struct iovec iovecs[IREE_IO_STDIO_STREAM_MAX_IOVECS];
+  iree_host_size_t buffer_index = 0;
+  iree_host_size_t buffer_offset = 0;
+  while (buffer_index < buffer_count) {
+    // Gather the next batch starting at the partially transferred buffer.
+    int iovec_count = 0;
+    for (iree_host_size_t i = buffer_index;
+         i < buffer_count && iovec_count < IREE_IO_STDIO_STREAM_MAX_IOVECS;
+         ++i) {
+      iree_host_size_t offset = i == buffer_index ? buffer_offset : 0;
+      iree_host_size_t length = buffers[i].data_length - offset;
+      if (!length) continue;
+      iovecs[iovec_count].iov_base = buffers[i].data + offset;
+      iovecs[iovec_count].iov_len = iree_min(length, INT_MAX);
+      ++iovec_count;
+    }
+    if (!iovec_count) break;
+
+    ssize_t result = is_write ? writev(fd, iovecs, iovec_count)
+                              : readv(fd, iovecs, iovec_count);
+    if (result < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "vectored %s failed (%d: %s)",
+                              is_write ? "write" : "read", errno,
+                              strerror(errno));
+    } else if (result == 0) {
+      if (!is_write) break;  // end-of-file
+      return iree_make_status(
+          IREE_STATUS_RESOURCE_EXHAUSTED,
+          "write failed, possibly out of disk space or device lost");
+    }
+    *out_total_length += (iree_host_size_t)result;
+
+    // Advance the cursor past the transferred bytes and any empty buffers.
+    iree_host_size_t remaining = (iree_host_size_t)result;
+    while (buffer_index < buffer_count) {
+      iree_host_size_t available =
+          buffers[buffer_index].data_length - buffer_offset;
+      if (remaining < available) {
+        buffer_offset += remaining;
+        break;
+      }
+      remaining -= available;
+      ++buffer_index;
+      buffer_offset = 0;
+    }
+  }
+  return iree_ok_status();
+}
+
+// Transfers |buffers| at the current stream position. The stdio buffer is
+// flushed so the descriptor position matches the stream position and then the
+// stream is repositioned after the transfer to drop any stale buffered state.
+static iree_status_t iree_io_stdio_stream_transfer(
+    iree_io_stdio_stream_t* stream, bool is_write,
+    iree_host_size_t buffer_count, const iree_byte_span_t* buffers,
+    iree_host_size_t* out_total_length) {
+  *out_total_length = 0;
+  if (fflush(stream->handle) != 0) {
+    return iree_make_stdio_status("unable to flush stream");
+  }
+  int fd = fileno(stream->handle);
+  iree_status_t status = iree_io_stdio_stream_transfer_fd(
+      fd, is_write, buffer_count, buffers, out_total_length);
+  off_t position = lseek(fd, 0, SEEK_CUR);
+  if (position < 0 || iree_fseek(stream->handle, position, SEEK_SET) != 0) {
+    status = iree_status_join(
+        status, iree_make_stdio_status("unable to resynchronize stream"));
+  }
+  return status;
+}
+
+static iree_status_t iree_io_stdio_stream_readv(
+    iree_io_stream_t* base_stream, iree_host_size_t buffer_count,
+    const iree_byte_span_t* buffers, iree_host_size_t* out_total_length) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  IREE_ASSERT_ARGUMENT(buffers);
+  if (out_total_length) *out_total_length = 0;
+  iree_io_stdio_stream_t* stream = iree_io_stdio_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t total_capacity = 0;
+  for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+    total_capacity += buffers[i].data_length;
+  }
+  iree_host_size_t total_length = 0;
+  if (iree_all_bits_set(stream->base.mode, IREE_IO_STREAM_MODE_SEEKABLE)) {
+    status = iree_io_stdio_stream_transfer(stream, /*is_write=*/false,
+                                           buffer_count, buffers,
+                                           &total_length);
+  } else {
+    // Pipes and terminals cannot be repositioned so use the buffered path.
+    for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+      if (!buffers[i].data_length) continue;
+      iree_host_size_t read_length = 0;
+      status = iree_io_stdio_stream_read(base_stream, buffers[i].data_length,
+                                         buffers[i].data, &read_length);
+      if (!iree_status_is_ok(status)) break;
+      total_length += read_length;
+      if (read_length < buffers[i].data_length) break;
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    if (out_total_length) {
+      // Ok to hit EOF; just return what's valid.
+      *out_total_length = total_length;
+    } else if (total_length < total_capacity) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "end-of-file encountered during read");
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_stdio_stream_writev(
+    iree_io_stream_t* base_stream, iree_host_size_t buffer_count,
+    const iree_const_byte_span_t* buffers) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  IREE_ASSERT_ARGUMENT(buffers);
+  iree_io_stdio_stream_t* stream = iree_io_stdio_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_status_t status = iree_ok_status();
+  if (iree_all_bits_set(stream->base.mode, IREE_IO_STREAM_MODE_SEEKABLE)) {
+    iree_host_size_t total_length = 0;
+    status = iree_io_stdio_stream_transfer(
+        stream, /*is_write=*/true, buffer_count,
+        (const iree_byte_span_t*)buffers, &total_length);
+  } else {
+    // Pipes and terminals cannot be repositioned so use the buffered path.
+    for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+      if (!buffers[i].data_length) continue;
+      status = iree_io_stdio_stream_write(base_stream, buffers[i].data_length,
+                                          buffers[i].data);
+      if (!iree_status_is_ok(status)) break;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#endif  // IREE_IO_STDIO_STREAM_HAVE_VECTORED
+
 static const iree_io_stream_vtable_t iree_io_stdio_stream_vtable = {
     .destroy = iree_io_stdio_stream_destroy,
     .offset = iree_io_stdio_stream_offset,
@@ -405,4 +576,8 @@ static const iree_io_stream_vtable_t iree_io_stdio_stream_vtable = {
     .fill = iree_io_stdio_stream_fill,
     .map_read = iree_io_stdio_stream_map_read,
     .map_write = iree_io_stdio_stream_map_write,
+#if IREE_IO_STDIO_STREAM_HAVE_VECTORED
+    .readv = iree_io_stdio_stream_readv,
+    .writev = iree_io_stdio_stream_writev,
+#endif  // IREE_IO_STDIO_STREAM_HAVE_VECTORED
 };
@@ -179,6 +179,73 @@ iree_io_stream_write(iree_io_stream_t* stream, iree_host_size_t buffer_length,
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_io_stream_readv(
+    iree_io_stream_t* stream, iree_host_size_t buffer_count,
+    const iree_byte_span_t* buffers, iree_host_size_t* out_total_length) {
+  IREE_ASSERT_ARGUMENT(stream);
+  IREE_ASSERT_ARGUMENT(!buffer_count || buffers);
+  if (out_total_length) *out_total_length = 0;
+  IREE_RETURN_IF_ERROR(
+      iree_io_stream_validate_mode(iree_io_stream_mode(stream),
+                                   IREE_IO_STREAM_MODE_READABLE),
+      "reading from the stream");
+  if (buffer_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer_count);
+  iree_status_t status = iree_ok_status();
+  if (stream->vtable->readv) {
+    status = stream->vtable->readv(stream, buffer_count, buffers,
+                                   out_total_length);
+  } else {
+    // Emulate with one read per buffer, stopping at the end of the stream.
+    iree_host_size_t total_length = 0;
+    for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+      if (!buffers[i].data_length) continue;
+      iree_host_size_t read_length = 0;
+      status = stream->vtable->read(stream, buffers[i].data_length,
+                                    buffers[i].data,
+                                    out_total_length ? &read_length : NULL);
+      if (!iree_status_is_ok(status)) break;
+      total_length += out_total_length ? read_length : buffers[i].data_length;
+      if (out_total_length && read_length < buffers[i].data_length) break;
+    }
+    if (out_total_length) *out_total_length = total_length;
+  }
+  if (out_total_length) {
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)*out_total_length);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_stream_writev(
+    iree_io_stream_t* stream, iree_host_size_t buffer_count,
+    const iree_const_byte_span_t* buffers) {
+  IREE_ASSERT_ARGUMENT(stream);
+  IREE_ASSERT_ARGUMENT(!buffer_count || buffers);
+  IREE_RETURN_IF_ERROR(
+      iree_io_stream_validate_mode(iree_io_stream_mode(stream),
+                                   IREE_IO_STREAM_MODE_WRITABLE),
+      "writing to the stream");
+  if (buffer_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer_count);
+  iree_status_t status = iree_ok_status();
+  if (stream->vtable->writev) {
+    status = stream->vtable->writev(stream, buffer_count, buffers);
+  } else {
+    // Emulate with one write per buffer.
+    for (iree_host_size_t i = 0; i < buffer_count; ++i) {
+      if (!buffers[i].data_length) continue;
+      status = stream->vtable->write(stream, buffers[i].data_length,
+                                     buffers[i].data);
+      if (!iree_status_is_ok(status)) break;
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t
 iree_io_stream_write_char(iree_io_stream_t* stream, char c) {
   return iree_io_stream_write(stream, sizeof(c), &c);
@@ -113,6 +113,26 @@ IREE_API_EXPORT iree_status_t
 iree_io_stream_write(iree_io_stream_t* stream, iree_host_size_t buffer_length,
                      const void* buffer);
 
+// Reads into each of the |buffer_count| |buffers| in order from |stream| as if
+// iree_io_stream_read was called on each. Returns the total number of bytes
+// read in the optional |out_total_length|, which may be less than the total
+// capacity of all buffers if the end of stream is reached. If
+// |out_total_length| is not provided the read will fail if enough bytes are
+// not available. Streams backed by platform files perform the read with as
+// few system calls as possible.
+// Requires the stream have IREE_IO_STREAM_MODE_READABLE.
+IREE_API_EXPORT iree_status_t iree_io_stream_readv(
+    iree_io_stream_t* stream, iree_host_size_t buffer_count,
+    const iree_byte_span_t* buffers, iree_host_size_t* out_total_length);
+
+// Writes the contents of each of the |buffer_count| |buffers| in order to
+// |stream| as if iree_io_stream_write was called on each. Streams backed by
+// platform files perform the write with as few system calls as possible.
+// Requires the stream have IREE_IO_STREAM_MODE_WRITABLE.
+IREE_API_EXPORT iree_status_t iree_io_stream_writev(
+    iree_io_stream_t* stream, iree_host_size_t buffer_count,
+    const iree_const_byte_span_t* buffers);
+
 // Writes a single character/byte to the stream.
 // Requires the stream have IREE_IO_STREAM_MODE_WRITABLE.
 IREE_API_EXPORT iree_status_t
@@ -183,6 +203,15 @@ typedef struct iree_io_stream_vtable_t {
   iree_status_t(IREE_API_PTR* map_write)(iree_io_stream_t* stream,
                                          iree_host_size_t length,
                                          iree_byte_span_t* out_span);
+  // Optional; when NULL each buffer is passed to |read| individually.
+  iree_status_t(IREE_API_PTR* readv)(iree_io_stream_t* stream,
+                                     iree_host_size_t buffer_count,
+                                     const iree_byte_span_t* buffers,
+                                     iree_host_size_t* out_total_length);
+  // Optional; when NULL each buffer is passed to |write| individually.
+  iree_status_t(IREE_API_PTR* writev)(iree_io_stream_t* stream,
+                                      iree_host_size_t buffer_count,
+                                      const iree_const_byte_span_t* buffers);
 } iree_io_stream_vtable_t;
 
 struct iree_io_stream_t {
@@ -0,0 +1,956 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Needed for syscall and MAP_POPULATE on Linux.
+#define _GNU_SOURCE
+
+#include "iree/io/uring.h"
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/wait_handle.h"
+
+#if IREE_FILE_IO_ENABLE && defined(IREE_PLATFORM_LINUX) && \
+    defined(IREE_HAVE_WAIT_TYPE_EVENTFD)
+#define IREE_IO_URING_ENABLE 1
+#endif  // IREE_FILE_IO_ENABLE && IREE_PLATFORM_LINUX
+
+#if defined(IREE_IO_URING_ENABLE)
+
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+//===----------------------------------------------------------------------===//
+// io_uring syscalls
+//===----------------------------------------------------------------------===//
+
+// NOTE: we issue the raw syscalls instead of depending on liburing so that the
+// runtime has no additional link dependencies. We only use the subset of the
+// API available since Linux 5.1 (readv/writev + eventfd registration).
+
+static int iree_io_uring_setup(uint32_t entries, struct io_uring_params* p) {
+  return (int)syscall(__NR_io_uring_setup, entries, p);
+}
+
+static int iree_io_uring_enter(int ring_fd, uint32_t to_submit,
+                               uint32_t min_complete, uint32_t flags) {
+  return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete,
+                      flags, NULL, 0);
+}
+
+static int iree_io_uring_register(int ring_fd, uint32_t opcode, void* arg,
+                                  uint32_t nr_args) {
+  return (int)syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_uring_t
+//===----------------------------------------------------------------------===//
+
+// Tracks an operation that has been enqueued and not yet reaped.
+// The slot index is passed to the kernel as the SQE user_data and returned to
+// us in the CQE.
+typedef struct iree_io_uring_slot_t {
+  iree_io_uring_completion_t completion;
+  // Retained for the duration of the operation.
+  iree_io_file_handle_t* file_handle;
+  // Referenced by the SQE; must remain valid until the kernel consumes it.
+  struct iovec iov;
+} iree_io_uring_slot_t;
+
+struct iree_io_uring_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // io_uring file descriptor returned by io_uring_setup.
+  int ring_fd;
+  // eventfd registered with the ring that is signaled on each completion.
+  int event_fd;
+
+  // Submission queue ring shared with the kernel.
+  void* sq_ring_ptr;
+  size_t sq_ring_size;
+  iree_atomic_int32_t* sq_head;
+  iree_atomic_int32_t* sq_tail;
+  uint32_t sq_mask;
+  uint32_t sq_entries;
+  uint32_t* sq_array;
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+  // Tail of the SQ as written by us; the kernel-visible tail is updated as
+  // each entry is enqueued.
+  uint32_t sq_local_tail;
+  // Tail of entries that have been passed to io_uring_enter.
+  uint32_t sq_submitted_tail;
+
+  // Completion queue ring shared with the kernel. May alias sq_ring_ptr when
+  // the kernel supports IORING_FEAT_SINGLE_MMAP.
+  void* cq_ring_ptr;
+  size_t cq_ring_size;
+  iree_atomic_int32_t* cq_head;
+  iree_atomic_int32_t* cq_tail;
+  uint32_t cq_mask;
+  struct io_uring_cqe* cqes;
+
+  // Total number of operations enqueued and not yet reaped.
+  iree_host_size_t pending_count;
+
+  // Operation slots. We never allow more in-flight operations than there are
+  // CQ entries so that the completion queue can never overflow.
+  iree_host_size_t slot_capacity;
+  iree_host_size_t free_slot_count;
+  uint32_t* free_slots;  // [slot_capacity]
+  iree_io_uring_slot_t slots[];
+};
+
+static void iree_io_uring_destroy(iree_io_uring_t* ring);
+
+static iree_status_t iree_io_uring_map_rings(iree_io_uring_t* ring,
+                                             const struct io_uring_params* p) {
+  ring->sq_ring_size = p->sq_off.array + p->sq_entries * sizeof(uint32_t);
+  ring->cq_ring_size =
+      p->cq_off.cqes + p->cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = (p->features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    ring->sq_ring_size = iree_max(ring->sq_ring_size, ring->cq_ring_size);
+    ring->cq_ring_size = ring->sq_ring_size;
+  }
+
+  ring->sq_ring_ptr =
+      mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_SQ_RING);
+  if (ring->sq_ring_ptr == MAP_FAILED) {
+    ring->sq_ring_ptr = NULL;
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to map io_uring submission queue (%d)",
+                            errno);
+  }
+  if (single_mmap) {
+    ring->cq_ring_ptr = ring->sq_ring_ptr;
+  } else {
+    ring->cq_ring_ptr =
+        mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+             MAP_SHARED | MAP_POPULATE, ring->ring_fd, IORING_OFF_CQ_RING);
+    if (ring->cq_ring_ptr == MAP_FAILED) {
+      ring->cq_ring_ptr = NULL;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to map io_uring completion queue (%d)",
+                              errno);
+    }
+  }
+
+  ring->sqes_size = p->sq_entries * sizeof(struct io_uring_sqe);
+  void* sqes_ptr = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->ring_fd,
+                        IORING_OFF_SQES);
+  if (sqes_ptr == MAP_FAILED) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to map io_uring submission entries (%d)",
+                            errno);
+  }
+  ring->sqes = (struct io_uring_sqe*)sqes_ptr;
+
+  uint8_t* sq_base = (uint8_t*)ring->sq_ring_ptr;
+  ring->sq_head = (iree_atomic_int32_t*)(sq_base + p->sq_off.head);
+  ring->sq_tail = (iree_atomic_int32_t*)(sq_base + p->sq_off.tail);
+  ring->sq_mask = *(uint32_t*)(sq_base + p->sq_off.ring_mask);
+  ring->sq_entries = *(uint32_t*)(sq_base + p->sq_off.ring_entries);
+  ring->sq_array = (uint32_t*)(sq_base + p->sq_off.array);
+  ring->sq_local_tail = (uint32_t)iree_atomic_load_int32(
+      ring->sq_tail, iree_memory_order_relaxed);
+  ring->sq_submitted_tail = ring->sq_local_tail;
+
+  uint8_t* cq_base = (uint8_t*)ring->cq_ring_ptr;
+  ring->cq_head = (iree_atomic_int32_t*)(cq_base + p->cq_off.head);
+  ring->cq_tail = (iree_atomic_int32_t*)(cq_base + p->cq_off.tail);
+  ring->cq_mask = *(uint32_t*)(cq_base + p->cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe*)(cq_base + p->cq_off.cqes);
+
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_uring_create(iree_host_size_t queue_depth,
+                     iree_allocator_t host_allocator,
+                     iree_io_uring_t** out_ring) {
+  IREE_ASSERT_ARGUMENT(out_ring);
+  *out_ring = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (queue_depth == 0) queue_depth = IREE_IO_URING_DEFAULT_QUEUE_DEPTH;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)queue_depth);
+  if (queue_depth > UINT16_MAX) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "queue depth %" PRIhsz " exceeds the maximum of %u",
+                            queue_depth, (unsigned)UINT16_MAX);
+  }
+
+  // Setup the ring first so that we know how many CQ entries the kernel gave
+  // us and can size our slot tracking to match.
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = iree_io_uring_setup((uint32_t)queue_depth, &params);
+  if (ring_fd < 0) {
+    int error_number = errno;
+    IREE_TRACE_ZONE_END(z0);
+    if (error_number == ENOSYS || error_number == EPERM) {
+      return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                              "io_uring not available (%d)", error_number);
+    }
+    return iree_make_status(iree_status_code_from_errno(error_number),
+                            "io_uring_setup failed (%d)", error_number);
+  }
+
+  const iree_host_size_t slot_capacity = params.cq_entries;
+  iree_io_uring_t* ring = NULL;
+  iree_host_size_t total_size =
+      sizeof(*ring) + slot_capacity * sizeof(ring->slots[0]) +
+      slot_capacity * sizeof(ring->free_slots[0]);
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, total_size, (void**)&ring);
+  if (!iree_status_is_ok(status)) {
+    close(ring_fd);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  memset(ring, 0, total_size);
+  iree_atomic_ref_count_init(&ring->ref_count);
+  ring->host_allocator = host_allocator;
+  ring->ring_fd = ring_fd;
+  ring->event_fd = -1;
+  ring->slot_capacity = slot_capacity;
+  ring->free_slots =
+      (uint32_t*)((uint8_t*)ring + sizeof(*ring) +
+                  slot_capacity * sizeof(ring->slots[0]));
+  // Push in reverse so that slot 0 is handed out first.
+  for (iree_host_size_t i = 0; i < slot_capacity; ++i) {
+    ring->free_slots[i] = (uint32_t)(slot_capacity - i - 1);
+  }
+  ring->free_slot_count = slot_capacity;
+
+  status = iree_io_uring_map_rings(ring, &params);
+
+  if (iree_status_is_ok(status)) {
+    ring->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (ring->event_fd == -1) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to create eventfd (%d)", errno);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    if (iree_io_uring_register(ring->ring_fd, IORING_REGISTER_EVENTFD,
+                               &ring->event_fd, 1) != 0) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to register io_uring eventfd (%d)",
+                                errno);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_ring = ring;
+  } else {
+    iree_io_uring_destroy(ring);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_io_uring_destroy(iree_io_uring_t* ring) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = ring->host_allocator;
+
+  // Drain any in-flight operations: the kernel may still be writing into user
+  // buffers and we need to release the file handles they retain.
+  while (ring->pending_count > 0) {
+    iree_status_t status =
+        iree_io_uring_wait(ring, iree_infinite_timeout(), NULL);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      break;
+    }
+  }
+
+  if (ring->event_fd != -1) close(ring->event_fd);
+  if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+  if (ring->cq_ring_ptr && ring->cq_ring_ptr != ring->sq_ring_ptr) {
+    munmap(ring->cq_ring_ptr, ring->cq_ring_size);
+  }
+  if (ring->sq_ring_ptr) munmap(ring->sq_ring_ptr, ring->sq_ring_size);
+  close(ring->ring_fd);
+
+  iree_allocator_free(host_allocator, ring);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_io_uring_retain(iree_io_uring_t* ring) {
+  if (IREE_LIKELY(ring)) {
+    iree_atomic_ref_count_inc(&ring->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_io_uring_release(iree_io_uring_t* ring) {
+  if (IREE_LIKELY(ring) && iree_atomic_ref_count_dec(&ring->ref_count) == 1) {
+    iree_io_uring_destroy(ring);
+  }
+}
+
+IREE_API_EXPORT iree_host_size_t
+iree_io_uring_pending_count(const iree_io_uring_t* ring) {
+  IREE_ASSERT_ARGUMENT(ring);
+  return ring->pending_count;
+}
+
+// Returns true if the submission queue has no free entries.
+static bool iree_io_uring_sq_is_full(iree_io_uring_t* ring) {
+  uint32_t head = (uint32_t)iree_atomic_load_int32(ring->sq_head,
+                                                   iree_memory_order_acquire);
+  return ring->sq_local_tail - head >= ring->sq_entries;
+}
+
+static iree_status_t iree_io_uring_enqueue(
+    iree_io_uring_t* ring, uint8_t opcode, iree_io_file_handle_t* file_handle,
+    uint64_t file_offset, void* buffer, iree_host_size_t buffer_length,
+    iree_io_uring_completion_t completion) {
+  iree_io_file_handle_primitive_t primitive =
+      iree_io_file_handle_primitive(file_handle);
+  if (primitive.type != IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "io_uring operations require a file descriptor "
+                            "handle; handle type %d not supported",
+                            (int)primitive.type);
+  }
+  if (ring->free_slot_count == 0) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "io_uring has %" PRIhsz
+                            " operations in flight; reap completions before "
+                            "enqueuing more",
+                            ring->pending_count);
+  }
+  if (iree_io_uring_sq_is_full(ring)) {
+    IREE_RETURN_IF_ERROR(iree_io_uring_submit(ring));
+    if (iree_io_uring_sq_is_full(ring)) {
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "io_uring submission queue is full");
+    }
+  }
+
+  uint32_t slot_index = ring->free_slots[--ring->free_slot_count];
+  iree_io_uring_slot_t* slot = &ring->slots[slot_index];
+  slot->completion = completion;
+  slot->file_handle = file_handle;
+  iree_io_file_handle_retain(file_handle);
+  slot->iov.iov_base = buffer;
+  slot->iov.iov_len = buffer_length;
+
+  uint32_t sq_index = ring->sq_local_tail & ring->sq_mask;
+  struct io_uring_sqe* sqe = &ring->sqes[sq_index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = opcode;
+  sqe->fd = primitive.value.fd;
+  sqe->off = file_offset;
+  sqe->addr = (uint64_t)(uintptr_t)&slot->iov;
+  sqe->len = 1;
+  sqe->user_data = slot_index;
+  ring->sq_array[sq_index] = sq_index;
+  ++ring->sq_local_tail;
+  iree_atomic_store_int32(ring->sq_tail, (int32_t)ring->sq_local_tail,
+                          iree_memory_order_release);
+
+  ++ring->pending_count;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_enqueue_read(
+    iree_io_uring_t* ring, iree_io_file_handle_t* file_handle,
+    uint64_t file_offset, iree_byte_span_t buffer,
+    iree_io_uring_completion_t completion) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_ASSERT_ARGUMENT(file_handle);
+  if (!iree_all_bits_set(iree_io_file_handle_access(file_handle),
+                         IREE_IO_FILE_ACCESS_READ)) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "file handle does not allow reading");
+  }
+  return iree_io_uring_enqueue(ring, IORING_OP_READV, file_handle, file_offset,
+                               buffer.data, buffer.data_length, completion);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_enqueue_write(
+    iree_io_uring_t* ring, iree_io_file_handle_t* file_handle,
+    uint64_t file_offset, iree_const_byte_span_t buffer,
+    iree_io_uring_completion_t completion) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_ASSERT_ARGUMENT(file_handle);
+  if (!iree_all_bits_set(iree_io_file_handle_access(file_handle),
+                         IREE_IO_FILE_ACCESS_WRITE)) {
+    return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                            "file handle does not allow writing");
+  }
+  return iree_io_uring_enqueue(ring, IORING_OP_WRITEV, file_handle,
+                               file_offset, (void*)buffer.data,
+                               buffer.data_length, completion);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_submit(iree_io_uring_t* ring) {
+  IREE_ASSERT_ARGUMENT(ring);
+  if (ring->sq_submitted_tail == ring->sq_local_tail) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(
+      z0, (int64_t)(ring->sq_local_tail - ring->sq_submitted_tail));
+  iree_status_t status = iree_ok_status();
+  while (ring->sq_submitted_tail != ring->sq_local_tail) {
+    uint32_t to_submit = ring->sq_local_tail - ring->sq_submitted_tail;
+    int rc = iree_io_uring_enter(ring->ring_fd, to_submit, 0, 0);
+    if (rc < 0) {
+      if (errno == EINTR) continue;
+      if (errno == EAGAIN || errno == EBUSY) {
+        status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                  "io_uring submission temporarily "
+                                  "unavailable; reap completions and retry");
+      } else {
+        status = iree_make_status(iree_status_code_from_errno(errno),
+                                  "io_uring_enter failed (%d)", errno);
+      }
+      break;
+    }
+    ring->sq_submitted_tail += (uint32_t)rc;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_reap(
+    iree_io_uring_t* ring, iree_host_size_t* out_completed_count) {
+  IREE_ASSERT_ARGUMENT(ring);
+  if (out_completed_count) *out_completed_count = 0;
+
+  // Reset the eventfd before draining so that any completions posted while we
+  // are processing re-signal it and are not lost to waiters.
+  uint64_t event_value = 0;
+  if (read(ring->event_fd, &event_value, sizeof(event_value)) < 0 &&
+      errno != EAGAIN) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to reset io_uring eventfd (%d)", errno);
+  }
+
+  iree_host_size_t completed_count = 0;
+  uint32_t head = (uint32_t)iree_atomic_load_int32(ring->cq_head,
+                                                   iree_memory_order_relaxed);
+  for (;;) {
+    uint32_t tail = (uint32_t)iree_atomic_load_int32(
+        ring->cq_tail, iree_memory_order_acquire);
+    if (head == tail) break;
+    const struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+    uint32_t slot_index = (uint32_t)cqe->user_data;
+    int32_t result = cqe->res;
+    // Hand the CQE back to the kernel before issuing the callback so that the
+    // callback can enqueue new operations.
+    ++head;
+    iree_atomic_store_int32(ring->cq_head, (int32_t)head,
+                            iree_memory_order_release);
+
+    iree_io_uring_slot_t* slot = &ring->slots[slot_index];
+    iree_io_uring_completion_t completion = slot->completion;
+    iree_io_file_handle_release(slot->file_handle);
+    memset(slot, 0, sizeof(*slot));
+    ring->free_slots[ring->free_slot_count++] = slot_index;
+    --ring->pending_count;
+
+    iree_status_t status = iree_ok_status();
+    iree_host_size_t bytes_transferred = 0;
+    if (result < 0) {
+      status = iree_make_status(iree_status_code_from_errno(-result),
+                                "io_uring operation failed (%d)", -result);
+    } else {
+      bytes_transferred = (iree_host_size_t)result;
+    }
+    if (completion.fn) {
+      completion.fn(completion.user_data, status, bytes_transferred);
+    } else {
+      iree_status_ignore(status);
+    }
+    ++completed_count;
+  }
+
+  if (out_completed_count) *out_completed_count = completed_count;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_wait(
+    iree_io_uring_t* ring, iree_timeout_t timeout,
+    iree_host_size_t* out_completed_count) {
+  IREE_ASSERT_ARGUMENT(ring);
+  if (out_completed_count) *out_completed_count = 0;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, iree_io_uring_submit(ring));
+
+  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+  iree_wait_handle_t wait_handle;
+  iree_wait_primitive_value_t wait_value;
+  memset(&wait_value, 0, sizeof(wait_value));
+  wait_value.event.fd = ring->event_fd;
+  iree_wait_handle_wrap_primitive(IREE_WAIT_PRIMITIVE_TYPE_EVENT_FD, wait_value,
+                                  &wait_handle);
+
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t completed_count = 0;
+  while (ring->pending_count > 0) {
+    status = iree_io_uring_reap(ring, &completed_count);
+    if (!iree_status_is_ok(status) || completed_count > 0) break;
+    status = iree_wait_one(&wait_handle, deadline_ns);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  if (out_completed_count) *out_completed_count = completed_count;
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_wait_source_t iree_io_uring_await(iree_io_uring_t* ring) {
+  IREE_ASSERT_ARGUMENT(ring);
+  iree_wait_primitive_value_t wait_value;
+  memset(&wait_value, 0, sizeof(wait_value));
+  wait_value.event.fd = ring->event_fd;
+  iree_wait_handle_t wait_handle;
+  iree_wait_handle_wrap_primitive(IREE_WAIT_PRIMITIVE_TYPE_EVENT_FD, wait_value,
+                                  &wait_handle);
+  iree_wait_source_t wait_source;
+  memcpy(wait_source.storage, &wait_handle, sizeof(wait_handle));
+  wait_source.ctl = iree_wait_handle_ctl;
+  return wait_source;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_uring_stream_t
+//===----------------------------------------------------------------------===//
+
+// Maximum size of a single ring operation issued by a stream. Larger transfers
+// are split so that the kernel can process the pieces concurrently.
+#define IREE_IO_URING_STREAM_CHUNK_SIZE (8 * 1024 * 1024)
+
+// Maximum number of chunks a stream will have in flight at once.
+#define IREE_IO_URING_STREAM_MAX_CHUNKS 16
+
+// Size of the staging buffer used to expand fill patterns.
+#define IREE_IO_URING_STREAM_FILL_SIZE 4096
+
+typedef struct iree_io_uring_stream_t {
+  iree_io_stream_t base;
+  iree_allocator_t host_allocator;
+  iree_io_uring_t* ring;
+  iree_io_file_handle_t* file_handle;
+  // Absolute offset of the stream origin in the file.
+  uint64_t file_offset;
+  // Offset of the stream relative to file_offset.
+  iree_io_stream_pos_t offset;
+} iree_io_uring_stream_t;
+
+static const iree_io_stream_vtable_t iree_io_uring_stream_vtable;
+
+static iree_io_uring_stream_t* iree_io_uring_stream_cast(
+    iree_io_stream_t* IREE_RESTRICT base_stream) {
+  return (iree_io_uring_stream_t*)base_stream;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_stream_open(
+    iree_io_stream_mode_t mode, iree_io_uring_t* ring,
+    iree_io_file_handle_t* file_handle, uint64_t file_offset,
+    iree_allocator_t host_allocator, iree_io_stream_t** out_stream) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_ASSERT_ARGUMENT(file_handle);
+  IREE_ASSERT_ARGUMENT(out_stream);
+  *out_stream = NULL;
+  if (iree_io_file_handle_type(file_handle) != IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "io_uring streams require a file descriptor "
+                            "handle; handle type %d not supported",
+                            (int)iree_io_file_handle_type(file_handle));
+  }
+  if (iree_any_bit_set(mode, IREE_IO_STREAM_MODE_RESIZABLE |
+                                 IREE_IO_STREAM_MODE_MAPPABLE)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "io_uring streams are not resizable or mappable");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_uring_stream_t* stream = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*stream), (void**)&stream));
+  iree_atomic_ref_count_init(&stream->base.ref_count);
+  stream->base.vtable = &iree_io_uring_stream_vtable;
+  stream->base.mode = mode;
+  stream->host_allocator = host_allocator;
+  stream->ring = ring;
+  iree_io_uring_retain(ring);
+  stream->file_handle = file_handle;
+  iree_io_file_handle_retain(file_handle);
+  stream->file_offset = file_offset;
+  stream->offset = 0;
+
+  *out_stream = &stream->base;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_io_uring_stream_destroy(
+    iree_io_stream_t* IREE_RESTRICT base_stream) {
+  iree_io_uring_stream_t* stream = iree_io_uring_stream_cast(base_stream);
+  iree_allocator_t host_allocator = stream->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_file_handle_release(stream->file_handle);
+  iree_io_uring_release(stream->ring);
+  iree_allocator_free(host_allocator, stream);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_io_stream_pos_t iree_io_uring_stream_offset(
+    iree_io_stream_t* base_stream) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  iree_io_uring_stream_t* stream = iree_io_uring_stream_cast(base_stream);
+  return stream->offset;
+}
+
+static iree_io_stream_pos_t iree_io_uring_stream_length(
+    iree_io_stream_t* base_stream) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  iree_io_uring_stream_t* stream = iree_io_uring_stream_cast(base_stream);
+  struct stat file_stat;
+  if (fstat(iree_io_file_handle_value(stream->file_handle).fd, &file_stat) !=
+      0) {
+    return 0;
+  }
+  if ((uint64_t)file_stat.st_size <= stream->file_offset) return 0;
+  return (iree_io_stream_pos_t)((uint64_t)file_stat.st_size -
+                                stream->file_offset);
+}
+
+static iree_status_t iree_io_uring_stream_seek(
+    iree_io_stream_t* base_stream, iree_io_stream_seek_mode_t seek_mode,
+    iree_io_stream_pos_t seek_offset) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  iree_io_uring_stream_t* stream = iree_io_uring_stream_cast(base_stream);
+
+  iree_io_stream_pos_t new_offset = stream->offset;
+  switch (seek_mode) {
+    case IREE_IO_STREAM_SEEK_SET:
+      new_offset = seek_offset;
+      break;
+    case IREE_IO_STREAM_SEEK_FROM_CURRENT:
+      new_offset = stream->offset + seek_offset;
+      break;
+    case IREE_IO_STREAM_SEEK_FROM_END:
+      new_offset = iree_io_uring_stream_length(base_stream) + seek_offset;
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unrecognized seek mode %u", (uint32_t)seek_mode);
+  }
+  if (new_offset < 0) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "seek %" PRIi64 " out of stream bounds",
+                            new_offset);
+  }
+
+  stream->offset = new_offset;
+  return iree_ok_status();
+}
+
+// A single chunk of a stream transfer.
+typedef struct iree_io_uring_stream_chunk_t {
+  iree_host_size_t requested_length;
+  iree_host_size_t transferred_length;
+  iree_status_t status;
+  bool completed;
+} iree_io_uring_stream_chunk_t;
+
+static void iree_io_uring_stream_chunk_completed(
+    void* user_data, iree_status_t status, iree_host_size_t bytes_transferred) {
+  iree_io_uring_stream_chunk_t* chunk =
+      (iree_io_uring_stream_chunk_t*)user_data;
+  chunk->status = status;
+  chunk->transferred_length = bytes_transferred;
+  chunk->completed = true;
+}
+
+// Issues a transfer of |length| bytes at the stream offset in batches of up to
+// IREE_IO_URING_STREAM_MAX_CHUNKS chunks and blocks until each batch completes.
+// Returns the total contiguous bytes transferred in |out_length|; a short
+// transfer indicates end-of-file was reached.
+static iree_status_t iree_io_uring_stream_transfer(
+    iree_io_uring_stream_t* stream, bool is_write, iree_host_size_t length,
+    uint8_t* buffer, iree_host_size_t* out_length) {
+  *out_length = 0;
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t total_length = 0;
+  bool hit_eof = false;
+  while (iree_status_is_ok(status) && !hit_eof && total_length < length) {
+    iree_io_uring_stream_chunk_t chunks[IREE_IO_URING_STREAM_MAX_CHUNKS];
+    iree_host_size_t chunk_count = 0;
+    iree_host_size_t batch_offset = total_length;
+    while (chunk_count < IREE_IO_URING_STREAM_MAX_CHUNKS &&
+           batch_offset < length) {
+      iree_host_size_t chunk_length =
+          iree_min(length - batch_offset, IREE_IO_URING_STREAM_CHUNK_SIZE);
+      iree_io_uring_stream_chunk_t* chunk = &chunks[chunk_count];
+      memset(chunk, 0, sizeof(*chunk));
+      chunk->requested_length = chunk_length;
+      iree_io_uring_completion_t completion = {
+          .fn = iree_io_uring_stream_chunk_completed,
+          .user_data = chunk,
+      };
+      uint64_t chunk_file_offset =
+          stream->file_offset + stream->offset + batch_offset;
+      if (is_write) {
+        status = iree_io_uring_enqueue_write(
+            stream->ring, stream->file_handle, chunk_file_offset,
+            iree_make_const_byte_span(buffer + batch_offset, chunk_length),
+            completion);
+      } else {
+        status = iree_io_uring_enqueue_read(
+            stream->ring, stream->file_handle, chunk_file_offset,
+            iree_make_byte_span(buffer + batch_offset, chunk_length),
+            completion);
+      }
+      if (iree_status_is_resource_exhausted(status) && chunk_count > 0) {
+        // Ring is full; process what we have and continue in the next batch.
+        iree_status_ignore(status);
+        status = iree_ok_status();
+        break;
+      } else if (!iree_status_is_ok(status)) {
+        break;
+      }
+      ++chunk_count;
+      batch_offset += chunk_length;
+    }
+
+    // Wait for all chunks issued in this batch even if enqueuing failed as
+    // they reference our stack storage.
+    iree_status_t wait_status = iree_ok_status();
+    for (iree_host_size_t i = 0; i < chunk_count; ++i) {
+      while (!chunks[i].completed && iree_status_is_ok(wait_status)) {
+        wait_status =
+            iree_io_uring_wait(stream->ring, iree_infinite_timeout(), NULL);
+      }
+    }
+    if (!iree_status_is_ok(wait_status)) {
+      // The kernel may still reference the chunk storage; this is unrecoverable
+      // and only happens if the wait primitive itself is broken.
+      IREE_ASSERT(false, "io_uring wait failed with operations in flight");
+      return iree_status_join(status, wait_status);
+    }
+
+    // Accumulate results in order; the first short chunk ends the transfer.
+    for (iree_host_size_t i = 0; i < chunk_count; ++i) {
+      iree_io_uring_stream_chunk_t* chunk = &chunks[i];
+      if (!iree_status_is_ok(chunk->status)) {
+        status = iree_status_join(status, chunk->status);
+        continue;
+      }
+      if (hit_eof) continue;
+      total_length += chunk->transferred_length;
+      if (chunk->transferred_length < chunk->requested_length) {
+        hit_eof = true;
+      }
+    }
+  }
+  *out_length = total_length;
+  return status;
+}
+
+static iree_status_t iree_io_uring_stream_read(
+    iree_io_stream_t* base_stream, iree_host_size_t buffer_capacity,
+    void* buffer, iree_host_size_t* out_buffer_length) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  IREE_ASSERT_ARGUMENT(buffer);
+  if (out_buffer_length) *out_buffer_length = 0;
+  iree_io_uring_stream_t* stream = iree_io_uring_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer_capacity);
+
+  iree_host_size_t bytes_read = 0;
+  iree_status_t status = iree_io_uring_stream_transfer(
+      stream, /*is_write=*/false, buffer_capacity, (uint8_t*)buffer,
+      &bytes_read);
+  if (iree_status_is_ok(status)) {
+    stream->offset += bytes_read;
+    if (out_buffer_length) {
+      *out_buffer_length = bytes_read;
+    } else if (bytes_read != buffer_capacity) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "end-of-file encountered during read");
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_uring_stream_write(iree_io_stream_t* base_stream,
+                                                iree_host_size_t buffer_length,
+                                                const void* buffer) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  IREE_ASSERT_ARGUMENT(buffer);
+  iree_io_uring_stream_t* stream = iree_io_uring_stream_cast(base_stream);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer_length);
+
+  iree_host_size_t bytes_written = 0;
+  iree_status_t status = iree_io_uring_stream_transfer(
+      stream, /*is_write=*/true, buffer_length, (uint8_t*)buffer,
+      &bytes_written);
+  stream->offset += bytes_written;
+  if (iree_status_is_ok(status) && bytes_written != buffer_length) {
+    status = iree_make_status(
+        IREE_STATUS_DATA_LOSS,
+        "short write (%" PRIhsz " of %" PRIhsz
+        " bytes), possibly out of disk space or device lost",
+        bytes_written, buffer_length);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_uring_stream_fill(
+    iree_io_stream_t* base_stream, iree_io_stream_pos_t count,
+    const void* pattern, iree_host_size_t pattern_length) {
+  IREE_ASSERT_ARGUMENT(base_stream);
+  IREE_ASSERT_ARGUMENT(pattern);
+  if (pattern_length == 0 || pattern_length > IREE_IO_URING_STREAM_FILL_SIZE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "fill pattern length %" PRIhsz " not supported",
+                            pattern_length);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Expand the pattern into a staging buffer so that we write in reasonably
+  // sized chunks instead of issuing one operation per element.
+  uint8_t staging[IREE_IO_URING_STREAM_FILL_SIZE];
+  iree_host_size_t elements_per_staging =
+      IREE_IO_URING_STREAM_FILL_SIZE / pattern_length;
+  for (iree_host_size_t i = 0; i < elements_per_staging; ++i) {
+    memcpy(staging + i * pattern_length, pattern, pattern_length);
+  }
+
+  iree_status_t status = iree_ok_status();
+  iree_io_stream_pos_t remaining = count;
+  while (remaining > 0 && iree_status_is_ok(status)) {
+    iree_host_size_t element_count = (iree_host_size_t)iree_min(
+        (iree_io_stream_pos_t)elements_per_staging, remaining);
+    status = iree_io_uring_stream_write(base_stream,
+                                        element_count * pattern_length, staging);
+    remaining -= element_count;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_uring_stream_map_read(
+    iree_io_stream_t* stream, iree_host_size_t length,
+    iree_const_byte_span_t* out_span) {
+  return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                          "io_uring streams do not support mapping");
+}
+
+static iree_status_t iree_io_uring_stream_map_write(
+    iree_io_stream_t* stream, iree_host_size_t length,
+    iree_byte_span_t* out_span) {
+  return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                          "io_uring streams do not support mapping");
+}
+
+static const iree_io_stream_vtable_t iree_io_uring_stream_vtable = {
+    .destroy = iree_io_uring_stream_destroy,
+    .offset = iree_io_uring_stream_offset,
+    .length = iree_io_uring_stream_length,
+    .seek = iree_io_uring_stream_seek,
+    .read = iree_io_uring_stream_read,
+    .write = iree_io_uring_stream_write,
+    .fill = iree_io_uring_stream_fill,
+    .map_read = iree_io_uring_stream_map_read,
+    .map_write = iree_io_uring_stream_map_write,
+};
+
+#else
+
+//===----------------------------------------------------------------------===//
+// Unsupported platforms
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t
+iree_io_uring_create(iree_host_size_t queue_depth,
+                     iree_allocator_t host_allocator,
+                     iree_io_uring_t** out_ring) {
+  IREE_ASSERT_ARGUMENT(out_ring);
+  *out_ring = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "io_uring is only available on Linux with "
+                          "IREE_FILE_IO_ENABLE=1");
+}
+
+IREE_API_EXPORT void iree_io_uring_retain(iree_io_uring_t* ring) {}
+
+IREE_API_EXPORT void iree_io_uring_release(iree_io_uring_t* ring) {}
+
+IREE_API_EXPORT iree_host_size_t
+iree_io_uring_pending_count(const iree_io_uring_t* ring) {
+  return 0;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_enqueue_read(
+    iree_io_uring_t* ring, iree_io_file_handle_t* file_handle,
+    uint64_t file_offset, iree_byte_span_t buffer,
+    iree_io_uring_completion_t completion) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE, "io_uring not available");
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_enqueue_write(
+    iree_io_uring_t* ring, iree_io_file_handle_t* file_handle,
+    uint64_t file_offset, iree_const_byte_span_t buffer,
+    iree_io_uring_completion_t completion) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE, "io_uring not available");
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_submit(iree_io_uring_t* ring) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE, "io_uring not available");
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_reap(
+    iree_io_uring_t* ring, iree_host_size_t* out_completed_count) {
+  if (out_completed_count) *out_completed_count = 0;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE, "io_uring not available");
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_wait(
+    iree_io_uring_t* ring, iree_timeout_t timeout,
+    iree_host_size_t* out_completed_count) {
+  if (out_completed_count) *out_completed_count = 0;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE, "io_uring not available");
+}
+
+IREE_API_EXPORT iree_wait_source_t iree_io_uring_await(iree_io_uring_t* ring) {
+  return iree_wait_source_immediate();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_uring_stream_open(
+    iree_io_stream_mode_t mode, iree_io_uring_t* ring,
+    iree_io_file_handle_t* file_handle, uint64_t file_offset,
+    iree_allocator_t host_allocator, iree_io_stream_t** out_stream) {
+  IREE_ASSERT_ARGUMENT(out_stream);
+  *out_stream = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE, "io_uring not available");
+}
+
+#endif  // IREE_IO_URING_ENABLE
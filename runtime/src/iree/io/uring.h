@@ -0,0 +1,146 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_URING_H_
+#define IREE_IO_URING_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/io/file_handle.h"
+#include "iree/io/stream.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_io_uring_t
+//===----------------------------------------------------------------------===//
+
+// Default number of submission queue entries when none is specified.
+#define IREE_IO_URING_DEFAULT_QUEUE_DEPTH 64
+
+// Callback issued when an operation enqueued on a ring completes.
+// |status| is owned by the callee and must be consumed or ignored.
+// |bytes_transferred| may be less than requested if the operation hit
+// end-of-file or the kernel split the request; callers needing the full range
+// must issue another operation for the remainder.
+typedef void(IREE_API_PTR* iree_io_uring_completion_fn_t)(
+    void* user_data, iree_status_t status, iree_host_size_t bytes_transferred);
+
+// A callback issued when a ring operation completes.
+typedef struct iree_io_uring_completion_t {
+  // Callback function pointer.
+  iree_io_uring_completion_fn_t fn;
+  // User data passed to the callback function. Unowned.
+  void* user_data;
+} iree_io_uring_completion_t;
+
+// An asynchronous file I/O ring backed by Linux io_uring.
+//
+// Operations are enqueued against IREE_IO_FILE_HANDLE_TYPE_FD file handles and
+// batched into the kernel with iree_io_uring_submit. Completions are processed
+// with iree_io_uring_reap, which issues the completion callback of each
+// finished operation from the calling thread. iree_io_uring_await returns a
+// wait source that resolves when completions are pending so that rings can be
+// integrated into iree_loop_t or iree_wait_set_t wait loops without a thread
+// per outstanding operation.
+//
+// Files opened with IREE_IO_FILE_OPEN_FLAG_DIRECT bypass the page cache; the
+// ring performs no bouncing and callers must provide suitably aligned buffers,
+// offsets, and lengths.
+//
+// Thread-compatible: the ring may be used from any thread but must be
+// externally synchronized.
+typedef struct iree_io_uring_t iree_io_uring_t;
+
+// Creates a new ring with room for |queue_depth| in-flight operations.
+// A |queue_depth| of 0 uses IREE_IO_URING_DEFAULT_QUEUE_DEPTH.
+// Returns IREE_STATUS_UNAVAILABLE if io_uring is not supported on the platform
+// or has been disabled by the kernel/sandbox; callers should fall back to
+// synchronous I/O in that case.
+IREE_API_EXPORT iree_status_t
+iree_io_uring_create(iree_host_size_t queue_depth,
+                     iree_allocator_t host_allocator,
+                     iree_io_uring_t** out_ring);
+
+// Retains the given |ring| for the caller.
+IREE_API_EXPORT void iree_io_uring_retain(iree_io_uring_t* ring);
+
+// Releases the given |ring| from the caller.
+// Any operations still in flight are waited on and their completion callbacks
+// are issued before the ring is destroyed.
+IREE_API_EXPORT void iree_io_uring_release(iree_io_uring_t* ring);
+
+// Returns the total number of operations enqueued that have not yet had their
+// completion callbacks issued.
+IREE_API_EXPORT iree_host_size_t
+iree_io_uring_pending_count(const iree_io_uring_t* ring);
+
+// Enqueues a read of |buffer|.data_length bytes from |file_handle| starting at
+// absolute |file_offset| into |buffer|. The file handle is retained until the
+// operation completes and |buffer| must remain valid until |completion| is
+// issued. The operation is not started until iree_io_uring_submit is called
+// (or the submission queue fills and is flushed implicitly).
+// Returns IREE_STATUS_RESOURCE_EXHAUSTED if the ring has no capacity for more
+// in-flight operations; callers should reap completions and retry.
+IREE_API_EXPORT iree_status_t iree_io_uring_enqueue_read(
+    iree_io_uring_t* ring, iree_io_file_handle_t* file_handle,
+    uint64_t file_offset, iree_byte_span_t buffer,
+    iree_io_uring_completion_t completion);
+
+// Enqueues a write of |buffer| to |file_handle| starting at absolute
+// |file_offset|. Follows the same lifetime rules as iree_io_uring_enqueue_read.
+IREE_API_EXPORT iree_status_t iree_io_uring_enqueue_write(
+    iree_io_uring_t* ring, iree_io_file_handle_t* file_handle,
+    uint64_t file_offset, iree_const_byte_span_t buffer,
+    iree_io_uring_completion_t completion);
+
+// Submits all enqueued operations to the kernel in a single system call.
+IREE_API_EXPORT iree_status_t iree_io_uring_submit(iree_io_uring_t* ring);
+
+// Processes all available completions without blocking and issues their
+// callbacks from the calling thread. Returns the number of completions
+// processed in |out_completed_count| (optional).
+IREE_API_EXPORT iree_status_t iree_io_uring_reap(
+    iree_io_uring_t* ring, iree_host_size_t* out_completed_count);
+
+// Submits any enqueued operations and blocks until at least one completion is
+// available or |timeout| elapses and then reaps all available completions.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if the timeout elapses first.
+IREE_API_EXPORT iree_status_t iree_io_uring_wait(
+    iree_io_uring_t* ring, iree_timeout_t timeout,
+    iree_host_size_t* out_completed_count);
+
+// Returns a wait source that resolves when the ring has completions available
+// to reap. The wait source remains valid for the lifetime of the ring and is
+// reset by iree_io_uring_reap. Operations must be submitted with
+// iree_io_uring_submit before waiting or the wait may never resolve.
+IREE_API_EXPORT iree_wait_source_t iree_io_uring_await(iree_io_uring_t* ring);
+
+//===----------------------------------------------------------------------===//
+// iree_io_uring_stream_t
+//===----------------------------------------------------------------------===//
+
+// Opens a stream over the IREE_IO_FILE_HANDLE_TYPE_FD |file_handle| starting at
+// the absolute |file_offset|. Reads and writes are issued through |ring| and
+// block the caller until they complete; large transfers are split and batched
+// into the ring so that the kernel can process them concurrently. The stream
+// retains both the ring and file handle until it is released.
+//
+// The ring is shared with the stream and must not be used concurrently from
+// other threads while a stream operation is in progress.
+IREE_API_EXPORT iree_status_t iree_io_uring_stream_open(
+    iree_io_stream_mode_t mode, iree_io_uring_t* ring,
+    iree_io_file_handle_t* file_handle, uint64_t file_offset,
+    iree_allocator_t host_allocator, iree_io_stream_t** out_stream);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_URING_H_
@@ -0,0 +1,282 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/uring.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+std::string GetUniquePath(const char* unique_name) {
+  const char* test_tmpdir = getenv("TEST_TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TMPDIR");
+  if (!test_tmpdir) test_tmpdir = "/tmp";
+  std::random_device d;
+  uint64_t random = (static_cast<uint64_t>(d()) << 32) | d();
+  char unique_path[256];
+  snprintf(unique_path, sizeof unique_path, "%s/iree_test_%" PRIx64 "_%s",
+           test_tmpdir, random, unique_name);
+  return unique_path;
+}
+
+class UringTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_status_t status =
+        iree_io_uring_create(/*queue_depth=*/8, iree_allocator_system(), &ring_);
+    if (iree_status_is_unavailable(status)) {
+      iree_status_free(status);
+      GTEST_SKIP() << "io_uring not available";
+    }
+    IREE_ASSERT_OK(status);
+  }
+
+  void TearDown() override {
+    iree_io_uring_release(ring_);
+    if (!path_.empty()) remove(path_.c_str());
+  }
+
+  // Creates a new temporary file with |contents| and returns a handle to it.
+  iree_io_file_handle_t* CreateFile(const char* name,
+                                    const std::vector<uint8_t>& contents) {
+    path_ = GetUniquePath(name);
+    iree_io_file_handle_t* file_handle = NULL;
+    IREE_CHECK_OK(iree_io_file_handle_open_fd(
+        IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+        IREE_IO_FILE_OPEN_FLAG_DISCARD,
+        iree_make_string_view(path_.data(), path_.size()),
+        iree_allocator_system(), &file_handle));
+    iree_io_stream_t* stream = NULL;
+    IREE_CHECK_OK(iree_io_uring_stream_open(
+        IREE_IO_STREAM_MODE_WRITABLE, ring_, file_handle, 0,
+        iree_allocator_system(), &stream));
+    IREE_CHECK_OK(
+        iree_io_stream_write(stream, contents.size(), contents.data()));
+    iree_io_stream_release(stream);
+    return file_handle;
+  }
+
+  static std::vector<uint8_t> MakeContents(size_t length) {
+    std::vector<uint8_t> contents(length);
+    for (size_t i = 0; i < length; ++i) contents[i] = (uint8_t)(i * 7);
+    return contents;
+  }
+
+  iree_io_uring_t* ring_ = NULL;
+  std::string path_;
+};
+
+struct Completion {
+  static void Callback(void* user_data, iree_status_t status,
+                       iree_host_size_t bytes_transferred) {
+    auto* completion = reinterpret_cast<Completion*>(user_data);
+    completion->status_code = iree_status_consume_code(status);
+    completion->bytes_transferred = bytes_transferred;
+    ++completion->count;
+  }
+  iree_io_uring_completion_t Get() { return {Callback, this}; }
+  iree_status_code_t status_code = IREE_STATUS_UNKNOWN;
+  iree_host_size_t bytes_transferred = 0;
+  int count = 0;
+};
+
+TEST_F(UringTest, BatchedReads) {
+  auto contents = MakeContents(4096);
+  iree_io_file_handle_t* file_handle = CreateFile("BatchedReads", contents);
+
+  // Issue one read per 1KB quarter of the file in a single submission.
+  std::vector<uint8_t> buffer(contents.size());
+  Completion completions[4];
+  for (int i = 0; i < 4; ++i) {
+    IREE_ASSERT_OK(iree_io_uring_enqueue_read(
+        ring_, file_handle, i * 1024,
+        iree_make_byte_span(buffer.data() + i * 1024, 1024),
+        completions[i].Get()));
+  }
+  EXPECT_EQ(iree_io_uring_pending_count(ring_), 4);
+  IREE_ASSERT_OK(iree_io_uring_submit(ring_));
+  while (iree_io_uring_pending_count(ring_) > 0) {
+    IREE_ASSERT_OK(
+        iree_io_uring_wait(ring_, iree_infinite_timeout(), /*out_count=*/NULL));
+  }
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(completions[i].count, 1);
+    EXPECT_EQ(completions[i].status_code, IREE_STATUS_OK);
+    EXPECT_EQ(completions[i].bytes_transferred, 1024);
+  }
+  EXPECT_EQ(buffer, contents);
+
+  iree_io_file_handle_release(file_handle);
+}
+
+TEST_F(UringTest, ShortReadAtEnd) {
+  auto contents = MakeContents(100);
+  iree_io_file_handle_t* file_handle = CreateFile("ShortReadAtEnd", contents);
+
+  std::vector<uint8_t> buffer(64);
+  Completion completion;
+  IREE_ASSERT_OK(iree_io_uring_enqueue_read(
+      ring_, file_handle, 80, iree_make_byte_span(buffer.data(), buffer.size()),
+      completion.Get()));
+  IREE_ASSERT_OK(iree_io_uring_wait(ring_, iree_infinite_timeout(), NULL));
+  EXPECT_EQ(completion.count, 1);
+  EXPECT_EQ(completion.status_code, IREE_STATUS_OK);
+  EXPECT_EQ(completion.bytes_transferred, 20);
+
+  iree_io_file_handle_release(file_handle);
+}
+
+// Completions resolve the wait source returned by iree_io_uring_await so that
+// rings can be waited on alongside other wait sources.
+TEST_F(UringTest, AwaitWaitSource) {
+  auto contents = MakeContents(256);
+  iree_io_file_handle_t* file_handle = CreateFile("AwaitWaitSource", contents);
+
+  // Nothing is pending so the wait source should not be resolved.
+  iree_wait_source_t wait_source = iree_io_uring_await(ring_);
+  EXPECT_THAT(Status(iree_wait_source_wait_one(wait_source,
+                                               iree_immediate_timeout())),
+              StatusIs(StatusCode::kDeadlineExceeded));
+
+  std::vector<uint8_t> buffer(contents.size());
+  Completion completion;
+  IREE_ASSERT_OK(iree_io_uring_enqueue_read(
+      ring_, file_handle, 0, iree_make_byte_span(buffer.data(), buffer.size()),
+      completion.Get()));
+  IREE_ASSERT_OK(iree_io_uring_submit(ring_));
+  IREE_ASSERT_OK(
+      iree_wait_source_wait_one(wait_source, iree_infinite_timeout()));
+  iree_host_size_t completed_count = 0;
+  IREE_ASSERT_OK(iree_io_uring_reap(ring_, &completed_count));
+  EXPECT_EQ(completed_count, 1);
+  EXPECT_EQ(completion.bytes_transferred, buffer.size());
+  EXPECT_EQ(buffer, contents);
+
+  iree_io_file_handle_release(file_handle);
+}
+
+TEST_F(UringTest, QueueFull) {
+  auto contents = MakeContents(64);
+  iree_io_file_handle_t* file_handle = CreateFile("QueueFull", contents);
+
+  // Fill the ring until it refuses more work.
+  uint8_t buffer[1];
+  std::vector<Completion> completions(1024);
+  iree_status_t status = iree_ok_status();
+  size_t enqueued = 0;
+  for (; enqueued < completions.size(); ++enqueued) {
+    status = iree_io_uring_enqueue_read(ring_, file_handle, 0,
+                                        iree_make_byte_span(buffer, 1),
+                                        completions[enqueued].Get());
+    if (!iree_status_is_ok(status)) break;
+  }
+  EXPECT_THAT(Status(std::move(status)),
+              StatusIs(StatusCode::kResourceExhausted));
+  EXPECT_GT(enqueued, 0);
+  EXPECT_EQ(iree_io_uring_pending_count(ring_), enqueued);
+
+  // Draining the ring makes room again.
+  while (iree_io_uring_pending_count(ring_) > 0) {
+    IREE_ASSERT_OK(iree_io_uring_wait(ring_, iree_infinite_timeout(), NULL));
+  }
+  for (size_t i = 0; i < enqueued; ++i) {
+    EXPECT_EQ(completions[i].count, 1);
+  }
+  Completion completion;
+  IREE_ASSERT_OK(iree_io_uring_enqueue_read(
+      ring_, file_handle, 0, iree_make_byte_span(buffer, 1), completion.Get()));
+  IREE_ASSERT_OK(iree_io_uring_wait(ring_, iree_infinite_timeout(), NULL));
+  EXPECT_EQ(completion.count, 1);
+
+  iree_io_file_handle_release(file_handle);
+}
+
+TEST_F(UringTest, StreamReadSeek) {
+  // Large enough to be split into multiple ring operations.
+  auto contents = MakeContents(20 * 1024 * 1024 + 123);
+  iree_io_file_handle_t* file_handle = CreateFile("StreamReadSeek", contents);
+
+  iree_io_stream_t* stream = NULL;
+  IREE_ASSERT_OK(iree_io_uring_stream_open(
+      IREE_IO_STREAM_MODE_READABLE | IREE_IO_STREAM_MODE_SEEKABLE, ring_,
+      file_handle, /*file_offset=*/3, iree_allocator_system(), &stream));
+  EXPECT_EQ(iree_io_stream_length(stream), contents.size() - 3);
+
+  std::vector<uint8_t> buffer(contents.size());
+  iree_host_size_t read_length = 0;
+  IREE_ASSERT_OK(
+      iree_io_stream_read(stream, buffer.size(), buffer.data(), &read_length));
+  EXPECT_EQ(read_length, contents.size() - 3);
+  EXPECT_TRUE(
+      std::equal(contents.begin() + 3, contents.end(), buffer.begin()));
+  EXPECT_TRUE(iree_io_stream_is_eos(stream));
+
+  // Exact reads past the end fail.
+  IREE_ASSERT_OK(iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_FROM_END, -4));
+  EXPECT_THAT(Status(iree_io_stream_read(stream, 8, buffer.data(), NULL)),
+              StatusIs(StatusCode::kOutOfRange));
+
+  IREE_ASSERT_OK(iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, 10));
+  uint8_t value = 0;
+  IREE_ASSERT_OK(iree_io_stream_read(stream, 1, &value, NULL));
+  EXPECT_EQ(value, contents[13]);
+  EXPECT_EQ(iree_io_stream_offset(stream), 11);
+
+  iree_io_stream_release(stream);
+  iree_io_file_handle_release(file_handle);
+}
+
+TEST_F(UringTest, StreamFill) {
+  auto contents = MakeContents(16);
+  iree_io_file_handle_t* file_handle = CreateFile("StreamFill", contents);
+
+  iree_io_stream_t* stream = NULL;
+  IREE_ASSERT_OK(iree_io_uring_stream_open(
+      IREE_IO_STREAM_MODE_READABLE | IREE_IO_STREAM_MODE_WRITABLE |
+          IREE_IO_STREAM_MODE_SEEKABLE,
+      ring_, file_handle, 0, iree_allocator_system(), &stream));
+  const uint16_t pattern = 0xABCD;
+  IREE_ASSERT_OK(iree_io_stream_fill(stream, 5000, &pattern, sizeof(pattern)));
+  EXPECT_EQ(iree_io_stream_length(stream), 10000);
+
+  IREE_ASSERT_OK(iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, 0));
+  std::vector<uint16_t> buffer(5000);
+  IREE_ASSERT_OK(iree_io_stream_read(stream, buffer.size() * sizeof(uint16_t),
+                                     buffer.data(), NULL));
+  for (uint16_t value : buffer) ASSERT_EQ(value, pattern);
+
+  iree_io_stream_release(stream);
+  iree_io_file_handle_release(file_handle);
+}
+
+TEST_F(UringTest, RequiresFdHandle) {
+  uint8_t data[4] = {0};
+  iree_io_file_handle_t* file_handle = NULL;
+  IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ, iree_make_byte_span(data, sizeof(data)),
+      iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+      &file_handle));
+  Completion completion;
+  EXPECT_THAT(Status(iree_io_uring_enqueue_read(
+                  ring_, file_handle, 0,
+                  iree_make_byte_span(data, sizeof(data)), completion.Get())),
+              StatusIs(StatusCode::kInvalidArgument));
+  iree_io_file_handle_release(file_handle);
+}
+
+}  // namespace
@@ -25,6 +25,7 @@
 // clang-format off
 
 EXPORT_FN("allocator.allocate", iree_hal_module_allocator_allocate, rIiiI, r)
+EXPORT_FN("allocator.allocate.tagged", iree_hal_module_allocator_allocate_tagged, rIiiiI, r)
 EXPORT_FN("allocator.import", iree_hal_module_allocator_import, riIiirII, r)
 
 EXPORT_FN("buffer.assert", iree_hal_module_buffer_assert, rrrIii, v)
@@ -51,6 +52,7 @@ EXPORT_FN("command_buffer.collective", iree_hal_module_command_buffer_collective
 EXPORT_FN("command_buffer.copy_buffer", iree_hal_module_command_buffer_copy_buffer, rrIrII, v)
 EXPORT_FN("command_buffer.create", iree_hal_module_command_buffer_create, riii, r)
 EXPORT_FN("command_buffer.dispatch", iree_hal_module_command_buffer_dispatch, rriiii, v)
+EXPORT_FN("command_buffer.dispatch.batch", iree_hal_module_command_buffer_dispatch_batch, rCriiiiD, v)
 EXPORT_FN("command_buffer.dispatch.indirect", iree_hal_module_command_buffer_dispatch_indirect, rrirI, v)
 EXPORT_FN("command_buffer.end_debug_group", iree_hal_module_command_buffer_end_debug_group, r, v)
 EXPORT_FN("command_buffer.execute.commands", iree_hal_module_command_buffer_execute_commands, rrCrIID, v)
@@ -65,6 +67,7 @@ EXPORT_FN("descriptor_set_layout.create", iree_hal_module_descriptor_set_layout_
 EXPORT_FN("device.allocator", iree_hal_module_device_allocator, r, r)
 EXPORT_FN("device.query.i64", iree_hal_module_device_query_i64, rrr, iI)
 EXPORT_FN("device.queue.alloca", iree_hal_module_device_queue_alloca, rIrriiiI, r)
+EXPORT_FN("device.queue.alloca.tagged", iree_hal_module_device_queue_alloca_tagged, rIrriiiiI, r)
 EXPORT_FN("device.queue.dealloca", iree_hal_module_device_queue_dealloca, rIrrr, v)
 EXPORT_FN("device.queue.execute", iree_hal_module_device_queue_execute, rIrrCrD, v)
 EXPORT_FN("device.queue.flush", iree_hal_module_device_queue_flush, rI, v)
@@ -9,6 +9,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/local/local_executable.h"
+#include "iree/modules/hal/loader/worker_pool.h"
 #include "iree/vm/api.h"
 
 #define IREE_HAL_LOADER_MODULE_VERSION_0_0 0x00000000u
@@ -21,6 +22,9 @@
 typedef struct iree_hal_loader_module_t {
   iree_allocator_t host_allocator;
   iree_hal_loader_module_flags_t flags;
+  // Optional pool used to split dispatches across threads. NULL if all
+  // workgroups run on the calling thread.
+  iree_hal_loader_worker_pool_t* worker_pool;
   // TODO(benvanik): types.
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
@@ -40,6 +44,7 @@ static void IREE_API_PTR iree_hal_loader_module_destroy(void* base_module) {
   for (iree_host_size_t i = 0; i < module->loader_count; ++i) {
     iree_hal_executable_loader_release(module->loaders[i]);
   }
+  iree_hal_loader_worker_pool_free(module->worker_pool);
 }
 
 static iree_status_t IREE_API_PTR
@@ -148,7 +153,9 @@ static iree_status_t iree_hal_loader_module_try_load(
     // supported then the try will fail with IREE_STATUS_CANCELLED and we should
     // continue trying other loaders.
     iree_status_t status = iree_hal_executable_loader_try_load(
-        loader, executable_params, /*worker_capacity=*/1, out_executable);
+        loader, executable_params,
+        iree_hal_loader_worker_pool_concurrency(loader_module->worker_pool),
+        out_executable);
     if (iree_status_is_ok(status)) {
       // Executable was successfully loaded.
       return status;
@@ -230,10 +237,96 @@ typedef struct {
   const iree_vm_abi_rII_t* bindings;
 } iree_hal_loader_dispatch_args_t;
 
+typedef struct iree_hal_loader_parallel_dispatch_t {
+  iree_hal_local_executable_t* executable;
+  iree_host_size_t ordinal;
+  uint32_t variant;
+  uint32_t max_range_x;
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state;
+} iree_hal_loader_parallel_dispatch_t;
+
+// Issues the workgroups with linearized IDs in [begin, end). Functions
+// supporting ranges are called once per contiguous run along X.
+static iree_status_t iree_hal_loader_issue_workgroups(void* user_data,
+                                                      uint32_t begin,
+                                                      uint32_t end,
+                                                      uint32_t worker_id) {
+  const iree_hal_loader_parallel_dispatch_t* dispatch =
+      (const iree_hal_loader_parallel_dispatch_t*)user_data;
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state =
+      dispatch->dispatch_state;
+  const uint32_t workgroup_count_x = dispatch_state->workgroup_count_x;
+  const uint32_t workgroup_count_y = dispatch_state->workgroup_count_y;
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+      .workgroup_id_x = 0,
+      .workgroup_id_y = 0,
+      .workgroup_id_z = 0,
+      .workgroup_range_x = 1,
+      // TODO(benvanik): environmental information.
+      .processor_id = 0,
+      .local_memory = NULL,
+      .local_memory_size = 0,
+  };
+  for (uint32_t i = begin; i < end; i += workgroup_state.workgroup_range_x) {
+    const uint32_t x = i % workgroup_count_x;
+    const uint32_t yz = i / workgroup_count_x;
+    workgroup_state.workgroup_id_x = x;
+    workgroup_state.workgroup_id_y = yz % workgroup_count_y;
+    workgroup_state.workgroup_id_z = yz / workgroup_count_y;
+    workgroup_state.workgroup_range_x = (uint16_t)iree_min(
+        iree_min(workgroup_count_x - x, end - i), dispatch->max_range_x);
+    IREE_RETURN_IF_ERROR(iree_hal_local_executable_issue_call(
+        dispatch->executable, dispatch->ordinal, dispatch->variant,
+        dispatch_state, &workgroup_state, worker_id));
+  }
+  return iree_ok_status();
+}
+
+// Splits the workgroups of a dispatch across the |worker_pool|.
+static iree_status_t iree_hal_loader_issue_dispatch_parallel(
+    iree_hal_loader_worker_pool_t* worker_pool,
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state) {
+  const uint64_t workgroup_count = (uint64_t)dispatch_state->workgroup_count_x *
+                                   dispatch_state->workgroup_count_y *
+                                   dispatch_state->workgroup_count_z;
+  if (workgroup_count > UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "workgroup count %" PRIu64 " exceeds the maximum",
+                            workgroup_count);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  const uint32_t workgroup_counts[3] = {
+      dispatch_state->workgroup_count_x,
+      dispatch_state->workgroup_count_y,
+      dispatch_state->workgroup_count_z,
+  };
+  const iree_hal_loader_parallel_dispatch_t dispatch = {
+      .executable = executable,
+      .ordinal = ordinal,
+      .variant = iree_hal_local_executable_select_variant(
+          executable, ordinal, workgroup_counts,
+          dispatch_state->push_constant_count, dispatch_state->push_constants),
+      .max_range_x =
+          iree_all_bits_set(
+              iree_hal_local_executable_dispatch_flags(executable, ordinal),
+              IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE)
+              ? UINT16_MAX
+              : 1,
+      .dispatch_state = dispatch_state,
+  };
+  iree_status_t status = iree_hal_loader_worker_pool_parallel_for(
+      worker_pool, (uint32_t)workgroup_count, iree_hal_loader_issue_workgroups,
+      (void*)&dispatch);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_loader_module_executable_dispatch(
     iree_vm_stack_t* IREE_RESTRICT stack, void* IREE_RESTRICT module,
     iree_hal_loader_module_state_t* IREE_RESTRICT state,
     const iree_hal_loader_dispatch_args_t* IREE_RESTRICT args) {
+  iree_hal_loader_module_t* loader_module = IREE_HAL_LOADER_MODULE_CAST(module);
   iree_hal_executable_t* executable = NULL;
   IREE_RETURN_IF_ERROR(
       iree_hal_executable_check_deref(args->executable, &executable));
@@ -270,13 +363,20 @@ static iree_status_t iree_hal_loader_module_executable_dispatch(
       .workgroup_count_x = args->workgroup_x,
       .workgroup_count_y = args->workgroup_y,
       .workgroup_count_z = args->workgroup_z,
-      .max_concurrency = 1,
+      .max_concurrency = (uint32_t)iree_hal_loader_worker_pool_concurrency(
+          loader_module->worker_pool),
       .binding_count = args->binding_count,
       .push_constants = args->push_constants,
       .binding_ptrs = binding_ptrs,
       .binding_lengths = binding_lengths,
   };
 
+  if (loader_module->worker_pool) {
+    return iree_hal_loader_issue_dispatch_parallel(
+        loader_module->worker_pool, (iree_hal_local_executable_t*)executable,
+        args->entry_point, &dispatch_state);
+  }
+
   // TODO(benvanik): environmental information.
   uint32_t processor_id = 0;
   iree_byte_span_t local_memory = iree_byte_span_empty();
@@ -385,6 +485,16 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
     iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
+  return iree_hal_loader_module_create_with_workers(
+      instance, flags, /*worker_count=*/0, loader_count, loaders,
+      host_allocator, out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_loader_module_create_with_workers(
+    iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
+    iree_host_size_t worker_count, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module) {
   IREE_ASSERT_ARGUMENT(instance);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
@@ -422,6 +532,14 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
     module->loaders[i] = loaders[i];
     iree_hal_executable_loader_retain(loaders[i]);
   }
+  if (worker_count > 0) {
+    status = iree_hal_loader_worker_pool_create(worker_count, host_allocator,
+                                                &module->worker_pool);
+    if (!iree_status_is_ok(status)) {
+      iree_vm_module_release(base_module);
+      return status;
+    }
+  }
 
   *out_module = base_module;
   return iree_ok_status();
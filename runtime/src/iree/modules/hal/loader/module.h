@@ -30,6 +30,17 @@ IREE_API_EXPORT iree_status_t iree_hal_loader_module_create(
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module);
 
+// Creates the loader module with the workgroups of each dispatch split across
+// a fixed pool of |worker_count| threads and the calling thread. This recovers
+// multi-core parallelism on small systems without the footprint of the task
+// system. A |worker_count| of 0 runs all workgroups on the calling thread as
+// with iree_hal_loader_module_create. Fails on platforms without threads.
+IREE_API_EXPORT iree_status_t iree_hal_loader_module_create_with_workers(
+    iree_vm_instance_t* instance, iree_hal_loader_module_flags_t flags,
+    iree_host_size_t worker_count, iree_host_size_t loader_count,
+    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
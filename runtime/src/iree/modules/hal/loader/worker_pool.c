@@ -0,0 +1,250 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/hal/loader/worker_pool.h"
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+
+#if IREE_HAL_LOADER_WORKER_POOL_ENABLE
+
+typedef struct iree_hal_loader_worker_t {
+  iree_hal_loader_worker_pool_t* pool;
+  iree_thread_t* thread;
+  uint32_t worker_id;
+  // Last pool epoch the worker has processed. Only touched by the worker.
+  int32_t observed_epoch;
+} iree_hal_loader_worker_t;
+
+struct iree_hal_loader_worker_pool_t {
+  iree_allocator_t host_allocator;
+
+  // Serializes parallel-for callers as only one may be in flight.
+  iree_slim_mutex_t mutex;
+
+  // Incremented each time work is published or the workers are asked to exit.
+  iree_atomic_int32_t epoch;
+  iree_atomic_int32_t exit_requested;
+  iree_notification_t work_notification;
+
+  // The in-flight parallel-for. Written before |epoch| is incremented and
+  // read-only until all workers have checked back in via |pending_workers|.
+  iree_hal_loader_parallel_fn_t fn;
+  void* user_data;
+  uint32_t count;
+  uint32_t grain;
+  iree_atomic_int64_t next_index;
+  // First failure (an iree_status_t) or 0 if all chunks have succeeded.
+  iree_atomic_intptr_t failure_status;
+  iree_atomic_int32_t pending_workers;
+  iree_notification_t done_notification;
+
+  iree_host_size_t worker_count;
+  iree_hal_loader_worker_t workers[];
+};
+
+// Claims and processes chunks of the in-flight parallel-for until none remain
+// or a chunk has failed.
+static void iree_hal_loader_worker_pool_drain(
+    iree_hal_loader_worker_pool_t* pool, uint32_t worker_id) {
+  for (;;) {
+    if (iree_atomic_load_intptr(&pool->failure_status,
+                                iree_memory_order_relaxed)) {
+      break;
+    }
+    int64_t begin = iree_atomic_fetch_add_int64(&pool->next_index, pool->grain,
+                                                iree_memory_order_relaxed);
+    if (begin >= pool->count) break;
+    uint32_t end = (uint32_t)iree_min(begin + pool->grain, pool->count);
+    iree_status_t status =
+        pool->fn(pool->user_data, (uint32_t)begin, end, worker_id);
+    if (!iree_status_is_ok(status)) {
+      intptr_t expected = 0;
+      if (!iree_atomic_compare_exchange_strong_intptr(
+              &pool->failure_status, &expected, (intptr_t)status,
+              iree_memory_order_acq_rel, iree_memory_order_relaxed)) {
+        iree_status_ignore(status);
+      }
+      break;
+    }
+  }
+}
+
+static bool iree_hal_loader_worker_has_work(void* arg) {
+  iree_hal_loader_worker_t* worker = (iree_hal_loader_worker_t*)arg;
+  return iree_atomic_load_int32(&worker->pool->epoch,
+                                iree_memory_order_acquire) !=
+         worker->observed_epoch;
+}
+
+static int iree_hal_loader_worker_main(void* arg) {
+  iree_hal_loader_worker_t* worker = (iree_hal_loader_worker_t*)arg;
+  iree_hal_loader_worker_pool_t* pool = worker->pool;
+  for (;;) {
+    iree_notification_await(&pool->work_notification,
+                            iree_hal_loader_worker_has_work, worker,
+                            iree_infinite_timeout());
+    worker->observed_epoch =
+        iree_atomic_load_int32(&pool->epoch, iree_memory_order_acquire);
+    if (iree_atomic_load_int32(&pool->exit_requested,
+                               iree_memory_order_acquire)) {
+      break;
+    }
+    iree_hal_loader_worker_pool_drain(pool, worker->worker_id);
+    if (iree_atomic_fetch_sub_int32(&pool->pending_workers, 1,
+                                    iree_memory_order_acq_rel) == 1) {
+      iree_notification_post(&pool->done_notification, IREE_ALL_WAITERS);
+    }
+  }
+  return 0;
+}
+
+static bool iree_hal_loader_worker_pool_is_done(void* arg) {
+  iree_hal_loader_worker_pool_t* pool = (iree_hal_loader_worker_pool_t*)arg;
+  return iree_atomic_load_int32(&pool->pending_workers,
+                                iree_memory_order_acquire) == 0;
+}
+
+iree_status_t iree_hal_loader_worker_pool_create(
+    iree_host_size_t worker_count, iree_allocator_t host_allocator,
+    iree_hal_loader_worker_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, worker_count);
+
+  iree_hal_loader_worker_pool_t* pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              host_allocator,
+              sizeof(*pool) + worker_count * sizeof(pool->workers[0]),
+              (void**)&pool));
+  memset(pool, 0, sizeof(*pool));
+  pool->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&pool->mutex);
+  iree_notification_initialize(&pool->work_notification);
+  iree_notification_initialize(&pool->done_notification);
+
+  iree_thread_create_params_t params;
+  memset(&params, 0, sizeof(params));
+  params.name = IREE_SV("iree-loader-worker");
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < worker_count; ++i) {
+    iree_hal_loader_worker_t* worker = &pool->workers[i];
+    worker->pool = pool;
+    worker->worker_id = (uint32_t)(i + 1);
+    worker->observed_epoch = 0;
+    status = iree_thread_create(iree_hal_loader_worker_main, worker, params,
+                                host_allocator, &worker->thread);
+    if (!iree_status_is_ok(status)) break;
+    // Only include fully created workers so that cleanup joins them.
+    pool->worker_count = i + 1;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    iree_hal_loader_worker_pool_free(pool);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_loader_worker_pool_free(iree_hal_loader_worker_pool_t* pool) {
+  if (!pool) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Wake all workers and have them exit; releasing the threads joins them.
+  iree_atomic_store_int32(&pool->exit_requested, 1, iree_memory_order_release);
+  iree_atomic_fetch_add_int32(&pool->epoch, 1, iree_memory_order_acq_rel);
+  iree_notification_post(&pool->work_notification, IREE_ALL_WAITERS);
+  for (iree_host_size_t i = 0; i < pool->worker_count; ++i) {
+    iree_thread_release(pool->workers[i].thread);
+  }
+
+  iree_notification_deinitialize(&pool->done_notification);
+  iree_notification_deinitialize(&pool->work_notification);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(pool->host_allocator, pool);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_host_size_t iree_hal_loader_worker_pool_concurrency(
+    const iree_hal_loader_worker_pool_t* pool) {
+  return pool ? pool->worker_count + 1 : 1;
+}
+
+iree_status_t iree_hal_loader_worker_pool_parallel_for(
+    iree_hal_loader_worker_pool_t* pool, uint32_t count,
+    iree_hal_loader_parallel_fn_t fn, void* user_data) {
+  if (count == 0) return iree_ok_status();
+  if (!pool || !pool->worker_count || count == 1) {
+    // Waking the workers is not worth it for a single item.
+    return fn(user_data, 0, count, /*worker_id=*/0);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+
+  iree_slim_mutex_lock(&pool->mutex);
+
+  // Oversplit a bit so that uneven chunks are balanced across workers.
+  const iree_host_size_t concurrency =
+      iree_hal_loader_worker_pool_concurrency(pool);
+  pool->fn = fn;
+  pool->user_data = user_data;
+  pool->count = count;
+  pool->grain = (uint32_t)iree_max(1, count / (concurrency * 4));
+  iree_atomic_store_int64(&pool->next_index, 0, iree_memory_order_relaxed);
+  iree_atomic_store_intptr(&pool->failure_status, 0,
+                           iree_memory_order_relaxed);
+  iree_atomic_store_int32(&pool->pending_workers, (int32_t)pool->worker_count,
+                          iree_memory_order_relaxed);
+
+  // Publish the work and join in on the calling thread.
+  iree_atomic_fetch_add_int32(&pool->epoch, 1, iree_memory_order_acq_rel);
+  iree_notification_post(&pool->work_notification, IREE_ALL_WAITERS);
+  iree_hal_loader_worker_pool_drain(pool, /*worker_id=*/0);
+  iree_notification_await(&pool->done_notification,
+                          iree_hal_loader_worker_pool_is_done, pool,
+                          iree_infinite_timeout());
+
+  iree_status_t status = (iree_status_t)iree_atomic_exchange_intptr(
+      &pool->failure_status, 0, iree_memory_order_acquire);
+
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#else
+
+iree_status_t iree_hal_loader_worker_pool_create(
+    iree_host_size_t worker_count, iree_allocator_t host_allocator,
+    iree_hal_loader_worker_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "loader worker pools require threading support");
+}
+
+void iree_hal_loader_worker_pool_free(iree_hal_loader_worker_pool_t* pool) {}
+
+iree_host_size_t iree_hal_loader_worker_pool_concurrency(
+    const iree_hal_loader_worker_pool_t* pool) {
+  return 1;
+}
+
+iree_status_t iree_hal_loader_worker_pool_parallel_for(
+    iree_hal_loader_worker_pool_t* pool, uint32_t count,
+    iree_hal_loader_parallel_fn_t fn, void* user_data) {
+  if (count == 0) return iree_ok_status();
+  return fn(user_data, 0, count, /*worker_id=*/0);
+}
+
+#endif  // IREE_HAL_LOADER_WORKER_POOL_ENABLE
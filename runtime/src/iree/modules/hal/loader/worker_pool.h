@@ -0,0 +1,70 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_MODULES_HAL_LOADER_WORKER_POOL_H_
+#define IREE_MODULES_HAL_LOADER_WORKER_POOL_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Parallel-for requires OS threads which are not available on bare-metal
+// platforms or when synchronization primitives are disabled. When disabled
+// pools cannot be created and all work runs on the calling thread.
+#if !defined(IREE_HAL_LOADER_WORKER_POOL_ENABLE)
+#if defined(IREE_PLATFORM_GENERIC) || IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#define IREE_HAL_LOADER_WORKER_POOL_ENABLE 0
+#else
+#define IREE_HAL_LOADER_WORKER_POOL_ENABLE 1
+#endif  // IREE_PLATFORM_GENERIC || IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#endif  // !IREE_HAL_LOADER_WORKER_POOL_ENABLE
+
+// Processes the items in [begin, end) on the worker with |worker_id|.
+// Worker IDs are in [0, concurrency) and the calling thread is always worker 0.
+typedef iree_status_t (*iree_hal_loader_parallel_fn_t)(void* user_data,
+                                                       uint32_t begin,
+                                                       uint32_t end,
+                                                       uint32_t worker_id);
+
+// A fixed pool of threads used to split the workgroups of a dispatch.
+// This is a minimal alternative to the task system for deployments that run
+// executables through the loader module but still want to use a few cores:
+// there is no scheduling beyond a single parallel-for executing at a time and
+// idle workers block on a notification until work arrives.
+typedef struct iree_hal_loader_worker_pool_t iree_hal_loader_worker_pool_t;
+
+// Creates a pool of |worker_count| threads. The calling thread participates
+// in each parallel-for so the total concurrency is |worker_count| + 1.
+iree_status_t iree_hal_loader_worker_pool_create(
+    iree_host_size_t worker_count, iree_allocator_t host_allocator,
+    iree_hal_loader_worker_pool_t** out_pool);
+
+// Joins all workers and frees the pool.
+void iree_hal_loader_worker_pool_free(iree_hal_loader_worker_pool_t* pool);
+
+// Returns the maximum number of workers that may concurrently run an item,
+// including the calling thread. Returns 1 if |pool| is NULL.
+iree_host_size_t iree_hal_loader_worker_pool_concurrency(
+    const iree_hal_loader_worker_pool_t* pool);
+
+// Calls |fn| over chunks of [0, count) across the pool and the calling thread
+// and returns once all items have been processed. Only one parallel-for runs
+// at a time and concurrent callers are serialized. If any chunk fails the
+// remaining unclaimed items are skipped and the first failure is returned.
+// If |pool| is NULL all items are processed on the calling thread.
+iree_status_t iree_hal_loader_worker_pool_parallel_for(
+    iree_hal_loader_worker_pool_t* pool, uint32_t count,
+    iree_hal_loader_parallel_fn_t fn, void* user_data);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_MODULES_HAL_LOADER_WORKER_POOL_H_
@@ -0,0 +1,97 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/hal/loader/worker_pool.h"
+
+#include <vector>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+struct CoverageState {
+  std::vector<iree_atomic_int32_t> hits;
+  iree_host_size_t concurrency;
+};
+
+static iree_status_t RecordHits(void* user_data, uint32_t begin, uint32_t end,
+                                uint32_t worker_id) {
+  auto* state = reinterpret_cast<CoverageState*>(user_data);
+  if (worker_id >= state->concurrency) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "invalid worker id");
+  }
+  for (uint32_t i = begin; i < end; ++i) {
+    iree_atomic_fetch_add_int32(&state->hits[i], 1, iree_memory_order_relaxed);
+  }
+  return iree_ok_status();
+}
+
+// Runs a parallel-for over |count| items and checks each ran exactly once.
+static void ExpectFullCoverage(iree_hal_loader_worker_pool_t* pool,
+                               uint32_t count) {
+  CoverageState state;
+  state.hits = std::vector<iree_atomic_int32_t>(count);
+  for (auto& hit : state.hits) {
+    iree_atomic_store_int32(&hit, 0, iree_memory_order_relaxed);
+  }
+  state.concurrency = iree_hal_loader_worker_pool_concurrency(pool);
+  IREE_ASSERT_OK(iree_hal_loader_worker_pool_parallel_for(pool, count,
+                                                          RecordHits, &state));
+  for (uint32_t i = 0; i < count; ++i) {
+    EXPECT_EQ(iree_atomic_load_int32(&state.hits[i], iree_memory_order_relaxed),
+              1);
+  }
+}
+
+TEST(WorkerPoolTest, NullPoolRunsInline) {
+  EXPECT_EQ(iree_hal_loader_worker_pool_concurrency(NULL), 1);
+  ExpectFullCoverage(NULL, 0);
+  ExpectFullCoverage(NULL, 37);
+}
+
+#if IREE_HAL_LOADER_WORKER_POOL_ENABLE
+
+TEST(WorkerPoolTest, Lifetime) {
+  iree_hal_loader_worker_pool_t* pool = NULL;
+  IREE_ASSERT_OK(iree_hal_loader_worker_pool_create(
+      /*worker_count=*/3, iree_allocator_system(), &pool));
+  EXPECT_EQ(iree_hal_loader_worker_pool_concurrency(pool), 4);
+  iree_hal_loader_worker_pool_free(pool);
+}
+
+TEST(WorkerPoolTest, CoversAllItems) {
+  iree_hal_loader_worker_pool_t* pool = NULL;
+  IREE_ASSERT_OK(iree_hal_loader_worker_pool_create(
+      /*worker_count=*/3, iree_allocator_system(), &pool));
+  // Repeated runs reuse the workers across epochs.
+  for (uint32_t count : {0u, 1u, 2u, 7u, 64u, 1000u, 4096u}) {
+    ExpectFullCoverage(pool, count);
+  }
+  iree_hal_loader_worker_pool_free(pool);
+}
+
+TEST(WorkerPoolTest, PropagatesFailure) {
+  iree_hal_loader_worker_pool_t* pool = NULL;
+  IREE_ASSERT_OK(iree_hal_loader_worker_pool_create(
+      /*worker_count=*/2, iree_allocator_system(), &pool));
+  auto fail_fn = +[](void* user_data, uint32_t begin, uint32_t end,
+                     uint32_t worker_id) -> iree_status_t {
+    return iree_make_status(IREE_STATUS_DATA_LOSS, "chunk failed");
+  };
+  iree_status_t status =
+      iree_hal_loader_worker_pool_parallel_for(pool, 128, fail_fn, NULL);
+  EXPECT_TRUE(iree_status_is_data_loss(status));
+  iree_status_ignore(status);
+  // The pool remains usable after a failure.
+  ExpectFullCoverage(pool, 128);
+  iree_hal_loader_worker_pool_free(pool);
+}
+
+#endif  // IREE_HAL_LOADER_WORKER_POOL_ENABLE
+
+}  // namespace
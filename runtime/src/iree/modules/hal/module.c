@@ -10,6 +10,7 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "iree/hal/utils/object_pool.h"
 #include "iree/modules/hal/utils/buffer_diagnostics.h"
 
 //===----------------------------------------------------------------------===//
@@ -33,11 +34,14 @@
 //===----------------------------------------------------------------------===//
 
 #define IREE_HAL_MODULE_VERSION_0_2 0x00000002u
-#define IREE_HAL_MODULE_VERSION_LATEST IREE_HAL_MODULE_VERSION_0_2
+#define IREE_HAL_MODULE_VERSION_0_3 0x00000003u
+#define IREE_HAL_MODULE_VERSION_0_4 0x00000004u
+#define IREE_HAL_MODULE_VERSION_LATEST IREE_HAL_MODULE_VERSION_0_4
 
 typedef struct iree_hal_module_t {
   iree_allocator_t host_allocator;
   iree_hal_module_flags_t flags;
+  iree_hal_module_executable_observer_t executable_observer;
   iree_host_size_t device_count;
   iree_hal_device_t* devices[];
 } iree_hal_module_t;
@@ -59,6 +63,9 @@ typedef struct iree_hal_module_state_t {
   // application. All instantiations of a module share the same flags.
   iree_hal_module_flags_t flags;
 
+  // Optional observer notified of executable preparation.
+  iree_hal_module_executable_observer_t executable_observer;
+
   // Total number of devices available to the module.
   iree_host_size_t device_count;
   // Devices referencing the storage in the parent module.
@@ -71,6 +78,14 @@ typedef struct iree_hal_module_state_t {
   // instead be taking a loop upon creation and scheduling work against that.
   iree_status_t loop_status;
 
+  // Pool for the buffer views and subspan buffers created by the module.
+  // These are created and destroyed many times per invocation and pooling them
+  // keeps the host allocator out of the hot path. Objects that outlive the
+  // state keep the pool alive until they are released.
+  iree_hal_object_pool_t* object_pool;
+  // Allocator routing to |object_pool|.
+  iree_allocator_t object_allocator;
+
   // Shared executable cache for each device used to cache all executables
   // created in the context. We could have multiple to allow for modules to
   // create distinct sets of executables like ones for training vs inference in
@@ -94,16 +109,23 @@ iree_hal_module_alloc_state(void* self, iree_allocator_t host_allocator,
   memset(state, 0, total_size);
   state->host_allocator = host_allocator;
   state->flags = module->flags;
+  state->executable_observer = module->executable_observer;
   state->device_count = module->device_count;
   state->devices = module->devices;
   state->loop_status = iree_ok_status();
 
-  iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < state->device_count; ++i) {
+  iree_status_t status = iree_hal_object_pool_create(
+      IREE_HAL_OBJECT_POOL_DEFAULT_BLOCK_SIZE, host_allocator,
+      &state->object_pool);
+  if (iree_status_is_ok(status)) {
+    state->object_allocator =
+        iree_hal_object_pool_allocator(state->object_pool);
+  }
+  for (iree_host_size_t i = 0;
+       iree_status_is_ok(status) && i < state->device_count; ++i) {
     status = iree_hal_executable_cache_create(
         state->devices[i], iree_string_view_empty(),
         iree_loop_inline(&state->loop_status), &state->executable_caches[i]);
-    if (!iree_status_is_ok(status)) break;
   }
 
   if (iree_status_is_ok(status)) {
@@ -112,12 +134,57 @@ iree_hal_module_alloc_state(void* self, iree_allocator_t host_allocator,
     for (iree_host_size_t i = 0; i < state->device_count; ++i) {
       iree_hal_executable_cache_release(state->executable_caches[i]);
     }
+    iree_hal_object_pool_release(state->object_pool);
     iree_allocator_free(host_allocator, state);
   }
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+// Forked states share the executable caches of the parent state so that
+// executables loaded in the parent context are reused by all forks.
+static iree_status_t IREE_API_PTR iree_hal_module_fork_state(
+    void* self, iree_vm_module_state_t* parent_state,
+    iree_allocator_t host_allocator,
+    iree_vm_module_state_t** out_module_state) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_module_state_t* parent = (iree_hal_module_state_t*)parent_state;
+  iree_hal_module_state_t* state = NULL;
+  iree_host_size_t total_size =
+      sizeof(*state) +
+      parent->device_count * sizeof(state->executable_caches[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&state));
+  memset(state, 0, total_size);
+  state->host_allocator = host_allocator;
+  state->flags = parent->flags;
+  state->executable_observer = parent->executable_observer;
+  state->device_count = parent->device_count;
+  state->devices = parent->devices;
+  state->loop_status = iree_ok_status();
+
+  // Each fork gets its own object pool as forks usually run concurrently.
+  iree_status_t status = iree_hal_object_pool_create(
+      IREE_HAL_OBJECT_POOL_DEFAULT_BLOCK_SIZE, host_allocator,
+      &state->object_pool);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, state);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  state->object_allocator = iree_hal_object_pool_allocator(state->object_pool);
+
+  for (iree_host_size_t i = 0; i < state->device_count; ++i) {
+    state->executable_caches[i] = parent->executable_caches[i];
+    iree_hal_executable_cache_retain(state->executable_caches[i]);
+  }
+
+  *out_module_state = (iree_vm_module_state_t*)state;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static void IREE_API_PTR
 iree_hal_module_free_state(void* self, iree_vm_module_state_t* module_state) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -127,6 +194,7 @@ iree_hal_module_free_state(void* self, iree_vm_module_state_t* module_state) {
     iree_hal_executable_cache_release(state->executable_caches[i]);
   }
   iree_status_ignore(state->loop_status);
+  iree_hal_object_pool_release(state->object_pool);
   iree_allocator_free(state->host_allocator, state);
 
   IREE_TRACE_ZONE_END(z0);
@@ -290,6 +358,35 @@ IREE_VM_ABI_EXPORT(iree_hal_module_allocator_allocate,  //
   return iree_ok_status();
 }
 
+IREE_VM_ABI_EXPORT(iree_hal_module_allocator_allocate_tagged,  //
+                   iree_hal_module_state_t,                    //
+                   rIiiiI, r) {
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_check_deref(args->r0, &allocator));
+  iree_hal_queue_affinity_t queue_affinity =
+      (iree_hal_queue_affinity_t)args->i1;
+  iree_hal_memory_type_t memory_types = (iree_hal_memory_type_t)args->i2;
+  iree_hal_buffer_usage_t buffer_usage = (iree_hal_buffer_usage_t)args->i3;
+  iree_hal_allocation_tag_t allocation_tag =
+      (iree_hal_allocation_tag_t)args->i4;
+  iree_device_size_t allocation_size = iree_hal_cast_device_size(args->i5);
+
+  const iree_hal_buffer_params_t params = {
+      .type = memory_types,
+      .usage = buffer_usage,
+      .queue_affinity = queue_affinity,
+      .tag = allocation_tag,
+  };
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+                           allocator, params, allocation_size, &buffer),
+                       "failed to allocate buffer of length %" PRIdsz,
+                       allocation_size);
+
+  rets->r0 = iree_hal_buffer_move_ref(buffer);
+  return iree_ok_status();
+}
+
 static void iree_hal_module_imported_buffer_release(void* user_data,
                                                     iree_hal_buffer_t* buffer) {
   iree_vm_buffer_t* backing_buffer = (iree_vm_buffer_t*)user_data;
@@ -418,8 +515,9 @@ IREE_VM_ABI_EXPORT(iree_hal_module_buffer_subspan,  //
 
   iree_hal_buffer_t* subspan_buffer = NULL;
   IREE_RETURN_IF_ERROR(
-      iree_hal_buffer_subspan(source_buffer, source_offset, length,
-                              &subspan_buffer),
+      iree_hal_buffer_subspan_with_allocator(source_buffer, source_offset,
+                                             length, state->object_allocator,
+                                             &subspan_buffer),
       "invalid subspan of an existing buffer (source_offset=%" PRIdsz
       ", length=%" PRIdsz ")",
       source_offset, length);
@@ -505,8 +603,9 @@ IREE_VM_ABI_EXPORT(iree_hal_module_buffer_view_create,  //
   if (source_offset != 0 ||
       source_length != iree_hal_buffer_byte_length(source_buffer)) {
     IREE_RETURN_IF_ERROR(
-        iree_hal_buffer_subspan(source_buffer, source_offset, source_length,
-                                &subspan_buffer),
+        iree_hal_buffer_subspan_with_allocator(
+            source_buffer, source_offset, source_length,
+            state->object_allocator, &subspan_buffer),
         "invalid subspan of an existing buffer (source_offset=%" PRIdsz
         ", length=%" PRIdsz ")",
         source_offset, source_length);
@@ -515,7 +614,7 @@ IREE_VM_ABI_EXPORT(iree_hal_module_buffer_view_create,  //
   iree_hal_buffer_view_t* buffer_view = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_buffer_view_create(
       subspan_buffer ? subspan_buffer : source_buffer, shape_rank, shape_dims,
-      element_type, encoding_type, state->host_allocator, &buffer_view));
+      element_type, encoding_type, state->object_allocator, &buffer_view));
 
   iree_hal_buffer_release(subspan_buffer);
 
@@ -901,6 +1000,27 @@ IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch,  //
                                           workgroup_z);
 }
 
+IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch_batch,  //
+                   iree_hal_module_state_t,                        //
+                   rCriiiiD, v) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_command_buffer_check_deref(args->r0, &command_buffer));
+  for (iree_host_size_t i = 0; i < args->a1_count; ++i) {
+    iree_hal_executable_t* executable = NULL;
+    IREE_RETURN_IF_ERROR(
+        iree_hal_executable_check_deref(args->a1[i].r0, &executable));
+    uint32_t entry_point = (uint32_t)args->a1[i].i1;
+    uint32_t workgroup_x = (uint32_t)args->a1[i].i2;
+    uint32_t workgroup_y = (uint32_t)args->a1[i].i3;
+    uint32_t workgroup_z = (uint32_t)args->a1[i].i4;
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_dispatch(
+        command_buffer, executable, entry_point, workgroup_x, workgroup_y,
+        workgroup_z));
+  }
+  return iree_ok_status();
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch_indirect,  //
                    iree_hal_module_state_t,                           //
                    rrirI, v) {
@@ -1050,6 +1170,37 @@ IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_alloca,  //
   return iree_ok_status();
 }
 
+IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_alloca_tagged,  //
+                   iree_hal_module_state_t,                     //
+                   rIrriiiiI, r) {
+  iree_hal_device_t* device = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_device_check_deref(args->r0, &device));
+  iree_hal_queue_affinity_t queue_affinity =
+      (iree_hal_queue_affinity_t)args->i1;
+  iree_hal_fence_t* wait_fence = iree_hal_fence_deref(args->r2);
+  iree_hal_fence_t* signal_fence = iree_hal_fence_deref(args->r3);
+  iree_hal_allocator_pool_t pool = (iree_hal_allocator_pool_t)args->i4;
+  iree_hal_memory_type_t memory_types = (iree_hal_memory_type_t)args->i5;
+  iree_hal_buffer_usage_t buffer_usage = (iree_hal_buffer_usage_t)args->i6;
+  iree_hal_allocation_tag_t allocation_tag =
+      (iree_hal_allocation_tag_t)args->i7;
+  iree_device_size_t allocation_size = iree_hal_cast_device_size(args->i8);
+
+  const iree_hal_buffer_params_t params = {
+      .type = memory_types,
+      .usage = buffer_usage,
+      .tag = allocation_tag,
+  };
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_device_queue_alloca(
+      device, queue_affinity, iree_hal_fence_semaphore_list(wait_fence),
+      iree_hal_fence_semaphore_list(signal_fence), pool, params,
+      allocation_size, &buffer));
+
+  rets->r0 = iree_hal_buffer_move_ref(buffer);
+  return iree_ok_status();
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_dealloca,  //
                    iree_hal_module_state_t,                //
                    rIrrr, v) {
@@ -1128,7 +1279,7 @@ IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_execute,  //
   return iree_hal_device_queue_execute(
       device, queue_affinity, iree_hal_fence_semaphore_list(wait_fence),
       iree_hal_fence_semaphore_list(signal_fence), command_buffer_count,
-      command_buffers);
+      command_buffers, /*binding_tables=*/NULL);
 }
 
 IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_flush,  //
@@ -1227,8 +1378,16 @@ IREE_VM_ABI_EXPORT(iree_hal_module_executable_create,  //
     executable_params.pipeline_layouts = pipeline_layouts;
     executable_params.constant_count = constant_count;
     executable_params.constants = constants;
+    iree_time_t start_ns =
+        state->executable_observer.fn ? iree_time_now() : 0;
     status = iree_hal_executable_cache_prepare_executable(
         executable_cache, &executable_params, &executable);
+    if (state->executable_observer.fn) {
+      state->executable_observer.fn(
+          state->executable_observer.user_data, device, executable_format_str,
+          executable_data->data.data_length, iree_time_now() - start_ns,
+          iree_status_code(status));
+    }
   }
 
   iree_allocator_free(state->host_allocator, pipeline_layouts);
@@ -1654,6 +1813,7 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
       .alloc_state = iree_hal_module_alloc_state,
       .free_state = iree_hal_module_free_state,
       .notify = iree_hal_module_notify,
+      .fork_state = iree_hal_module_fork_state,
   };
 
   // Allocate shared module state.
@@ -1688,6 +1848,14 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT void iree_hal_module_set_executable_observer(
+    iree_vm_module_t* base_module,
+    iree_hal_module_executable_observer_t observer) {
+  IREE_ASSERT_ARGUMENT(base_module);
+  iree_hal_module_t* module = IREE_HAL_MODULE_CAST(base_module);
+  module->executable_observer = observer;
+}
+
 IREE_API_EXPORT iree_host_size_t
 iree_hal_module_state_device_count(iree_vm_module_state_t* module_state) {
   iree_hal_module_state_t* state = (iree_hal_module_state_t*)module_state;
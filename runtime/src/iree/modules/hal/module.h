@@ -34,6 +34,30 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
     iree_hal_device_t** devices, iree_hal_module_flags_t flags,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module);
 
+// Callback issued after a HAL module prepares an executable.
+// |executable_format| and |executable_data_length| describe the executable
+// data provided by the program and |duration_ns| is the time taken by the
+// executable cache to prepare it, including failed attempts.
+typedef void(IREE_API_PTR* iree_hal_module_executable_observer_fn_t)(
+    void* user_data, iree_hal_device_t* device,
+    iree_string_view_t executable_format,
+    iree_host_size_t executable_data_length, iree_duration_t duration_ns,
+    iree_status_code_t status_code);
+
+// An observer of executable preparation used for diagnostics.
+typedef struct {
+  // Callback function pointer.
+  iree_hal_module_executable_observer_fn_t fn;
+  // User data passed to the callback function. Unowned.
+  void* user_data;
+} iree_hal_module_executable_observer_t;
+
+// Sets an |observer| notified each time the HAL |module| prepares an
+// executable. Only applies to module states (contexts) created after the call
+// and the observer must remain valid for their lifetime.
+IREE_API_EXPORT void iree_hal_module_set_executable_observer(
+    iree_vm_module_t* module, iree_hal_module_executable_observer_t observer);
+
 // Returns the total number of available devices registered with the HAL module.
 IREE_API_EXPORT iree_host_size_t
 iree_hal_module_state_device_count(iree_vm_module_state_t* module_state);
@@ -55,11 +55,6 @@ typedef enum {
   IREE_UK_X32U_RSQRTF,
 } iree_uk_x32u_opcode_t;
 
-// Macros to access various typed, dereferenced pointers.
-#define ASF32(ptr) *((float*)ptr)
-#define ASUI32(ptr) *((iree_uk_uint32_t*)ptr)
-#define ASSI32(ptr) *((iree_uk_int32_t*)ptr)
-
 //===----------------------------------------------------------------------===//
 // Implementation macros.
 //===----------------------------------------------------------------------===//
@@ -73,7 +68,7 @@ typedef enum {
       iree_uk_index_t lhs_stride0, iree_uk_index_t lhs_stride1,               \
       const dtype* rhs, iree_uk_index_t rhs_offset,                           \
       iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,               \
-      dtype* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,                \
+      dtype* out, iree_uk_index_t out_offset,                                 \
       iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,               \
       iree_uk_index_t size0, iree_uk_index_t size1) {                         \
     return iree_uk_generic_##category##_2d(                                   \
@@ -88,7 +83,7 @@ typedef enum {
 #define DISPATCH_UKERNEL_UNARY_2D(opcode, opcode_t, dtype, category)          \
   IREE_UK_EXPORT int iree_uk_##category##_##opcode##_2d(                      \
       const dtype* in, iree_uk_index_t in_offset, iree_uk_index_t in_stride0, \
-      iree_uk_index_t in_stride1, dtype* IREE_UK_RESTRICT out,                \
+      iree_uk_index_t in_stride1, dtype* out,                                 \
       iree_uk_index_t out_offset, iree_uk_index_t out_stride0,                \
       iree_uk_index_t out_stride1, iree_uk_index_t size0,                     \
       iree_uk_index_t size1) {                                                \
@@ -101,99 +96,50 @@ typedef enum {
 // Internal helpers.
 //===----------------------------------------------------------------------===//
 
-// Computes a single element of an x32b opcode. On error, should set
-// |*result_code| to a non-zero value (but should not touch it otherwise).
-static void iree_uk_generic_x32b_op(iree_uk_x32b_opcode_t opcode,
-                                    int* result_code,
-                                    const iree_uk_uint32_t* lhs,
-                                    const iree_uk_uint32_t* rhs,
-                                    iree_uk_uint32_t* out) {
-  switch (opcode) {
-    case IREE_UK_X32B_ADDF:
-      ASF32(out) = ASF32(lhs) + ASF32(rhs);
-      return;
-    case IREE_UK_X32B_ADDI:
-      ASUI32(out) = ASUI32(lhs) + ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_ANDI:
-      ASUI32(out) = ASUI32(lhs) & ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_DIVF:
-      ASF32(out) = ASF32(lhs) / ASF32(rhs);
-      return;
-    case IREE_UK_X32B_DIVSI:
-      ASSI32(out) = ASSI32(lhs) / ASSI32(rhs);
-      return;
-    case IREE_UK_X32B_DIVUI:
-      ASUI32(out) = ASUI32(lhs) / ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_MULF:
-      ASF32(out) = ASF32(lhs) * ASF32(rhs);
-      return;
-    case IREE_UK_X32B_MULI:
-      ASUI32(out) = ASUI32(lhs) * ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_ORI:
-      ASUI32(out) = ASUI32(lhs) | ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SHLI:
-      ASUI32(out) = ASUI32(lhs) << ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SHRSI:
-      ASSI32(out) = ASSI32(lhs) >> ASSI32(rhs);
-      return;
-    case IREE_UK_X32B_SHRUI:
-      ASUI32(out) = ASUI32(lhs) >> ASUI32(rhs);
-      return;
-    case IREE_UKENREL_X32B_XORI:
-      ASUI32(out) = ASUI32(lhs) ^ ASUI32(rhs);
-      return;
-    case IREE_UK_X32B_SUBF:
-      ASF32(out) = ASF32(lhs) - ASF32(rhs);
-      return;
-    case IREE_UK_X32B_SUBI:
-      ASSI32(out) = ASUI32(lhs) - ASUI32(rhs);
-      return;
-    default:
-      *result_code = 1;
+// Computes `out = expr(a, b)` over a 2D range where `a` and `b` are the lhs
+// and rhs elements loaded as |type|. The opcode is resolved once outside of
+// the loops and the innermost loop is specialized for unit strides (the common
+// case) so that it is straight-line code the compiler can autovectorize.
+// |out| may alias |lhs| or |rhs| (in-place operations) and is intentionally not
+// restrict-qualified; compilers version the vectorized loop on an overlap check.
+#define IREE_UK_X32B_2D_LOOP(type, expr)                                 \
+  for (iree_uk_index_t i = 0; i < size0; ++i) {                          \
+    const type* lhs_row = (const type*)lhs + i * lhs_stride0;            \
+    const type* rhs_row = (const type*)rhs + i * rhs_stride0;            \
+    type* out_row = (type*)out + i * out_stride0;                        \
+    if (lhs_stride1 == 1 && rhs_stride1 == 1 && out_stride1 == 1) {      \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                      \
+        const type a = lhs_row[j];                                       \
+        const type b = rhs_row[j];                                       \
+        out_row[j] = (expr);                                             \
+      }                                                                  \
+    } else {                                                             \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                      \
+        const type a = lhs_row[j * lhs_stride1];                         \
+        const type b = rhs_row[j * rhs_stride1];                         \
+        out_row[j * out_stride1] = (expr);                               \
+      }                                                                  \
+    }                                                                    \
   }
-}
 
-// Computes a single element of an x32u opcode. On error, should set
-// |*result_code| to a non-zero value (but should not touch it otherwise).
-static void iree_uk_generic_x32u_op(iree_uk_x32u_opcode_t opcode,
-                                    int* result_code,
-                                    const iree_uk_uint32_t* in,
-                                    iree_uk_uint32_t* out) {
-  switch (opcode) {
-    case IREE_UK_X32U_ABSF:
-      ASF32(out) = fabsf(ASF32(in));
-      return;
-    case IREE_UK_X32U_CEILF:
-      ASF32(out) = ceilf(ASF32(in));
-      return;
-    case IREE_UK_X32U_CTLZ:
-      ASUI32(out) = iree_uk_count_leading_zeros_u32(ASUI32(in));
-      return;
-    case IREE_UK_X32U_EXPF:
-      ASF32(out) = expf(ASF32(in));
-      return;
-    case IREE_UK_X32U_FLOORF:
-      ASF32(out) = floorf(ASF32(in));
-      return;
-    case IREE_UK_X32U_LOGF:
-      ASF32(out) = logf(ASF32(in));
-      return;
-    case IREE_UK_X32U_NEGF:
-      ASF32(out) = -ASF32(in);
-      return;
-    case IREE_UK_X32U_RSQRTF:
-      ASF32(out) = 1.0f / sqrtf(ASF32(in));
-      return;
-    default:
-      *result_code = 1;
+// Computes `out = expr(a)` over a 2D range where `a` is the input element
+// loaded as |type|. See IREE_UK_X32B_2D_LOOP.
+#define IREE_UK_X32U_2D_LOOP(type, expr)                           \
+  for (iree_uk_index_t i = 0; i < size0; ++i) {                    \
+    const type* in_row = (const type*)in + i * in_stride0;         \
+    type* out_row = (type*)out + i * out_stride0;                  \
+    if (in_stride1 == 1 && out_stride1 == 1) {                     \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                \
+        const type a = in_row[j];                                  \
+        out_row[j] = (expr);                                       \
+      }                                                            \
+    } else {                                                       \
+      for (iree_uk_index_t j = 0; j < size1; ++j) {                \
+        const type a = in_row[j * in_stride1];                     \
+        out_row[j * out_stride1] = (expr);                         \
+      }                                                            \
+    }                                                              \
   }
-}
 
 //===----------------------------------------------------------------------===//
 // Opcode dispatch entry points.
@@ -209,21 +155,59 @@ IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32b_2d(
     const iree_uk_uint32_t* rhs, iree_uk_index_t rhs_offset,
     iree_uk_index_t rhs_stride0, iree_uk_index_t rhs_stride1,
     // OUT.
-    iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_uint32_t* out, iree_uk_index_t out_offset,
     iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
     // Sizes.
     iree_uk_index_t size0, iree_uk_index_t size1) {
-  int result_code = 0;
-  // TODO: Manually unroll to x4 to trigger vectorization.
-  for (iree_uk_index_t i = 0; i < size0; ++i) {
-    for (iree_uk_index_t j = 0; j < size1; ++j) {
-      iree_uk_generic_x32b_op(opcode, &result_code,
-                              &lhs[i * lhs_stride0 + j * lhs_stride1],
-                              &rhs[i * rhs_stride0 + j * rhs_stride1],
-                              &out[i * out_stride0 + j * out_stride1]);
-    }
+  switch (opcode) {
+    case IREE_UK_X32B_ADDF:
+      IREE_UK_X32B_2D_LOOP(float, a + b);
+      return 0;
+    case IREE_UK_X32B_ADDI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a + b);
+      return 0;
+    case IREE_UK_X32B_ANDI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a & b);
+      return 0;
+    case IREE_UK_X32B_DIVF:
+      IREE_UK_X32B_2D_LOOP(float, a / b);
+      return 0;
+    case IREE_UK_X32B_DIVSI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_int32_t, a / b);
+      return 0;
+    case IREE_UK_X32B_DIVUI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a / b);
+      return 0;
+    case IREE_UK_X32B_MULF:
+      IREE_UK_X32B_2D_LOOP(float, a * b);
+      return 0;
+    case IREE_UK_X32B_MULI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a * b);
+      return 0;
+    case IREE_UK_X32B_ORI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a | b);
+      return 0;
+    case IREE_UK_X32B_SHLI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a << b);
+      return 0;
+    case IREE_UK_X32B_SHRSI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_int32_t, a >> b);
+      return 0;
+    case IREE_UK_X32B_SHRUI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a >> b);
+      return 0;
+    case IREE_UKENREL_X32B_XORI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a ^ b);
+      return 0;
+    case IREE_UK_X32B_SUBF:
+      IREE_UK_X32B_2D_LOOP(float, a - b);
+      return 0;
+    case IREE_UK_X32B_SUBI:
+      IREE_UK_X32B_2D_LOOP(iree_uk_uint32_t, a - b);
+      return 0;
+    default:
+      return 1;
   }
-  return result_code;
 }
 
 // Generic 32bit unary kernels.
@@ -233,20 +217,39 @@ IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32u_2d(
     const iree_uk_uint32_t* in, iree_uk_index_t in_offset,
     iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
     // OUT.
-    iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_uint32_t* out, iree_uk_index_t out_offset,
     iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
     // Sizes.
     iree_uk_index_t size0, iree_uk_index_t size1) {
-  int result_code = 0;
-  // TODO: Manually unroll to x4 to trigger vectorization.
-  for (iree_uk_index_t i = 0; i < size0; ++i) {
-    for (iree_uk_index_t j = 0; j < size1; ++j) {
-      iree_uk_generic_x32u_op(opcode, &result_code,
-                              &in[i * in_stride0 + j * in_stride1],
-                              &out[i * out_stride0 + j * out_stride1]);
-    }
+  switch (opcode) {
+    case IREE_UK_X32U_ABSF:
+      IREE_UK_X32U_2D_LOOP(float, fabsf(a));
+      return 0;
+    case IREE_UK_X32U_CEILF:
+      IREE_UK_X32U_2D_LOOP(float, ceilf(a));
+      return 0;
+    case IREE_UK_X32U_CTLZ:
+      IREE_UK_X32U_2D_LOOP(iree_uk_uint32_t,
+                           iree_uk_count_leading_zeros_u32(a));
+      return 0;
+    case IREE_UK_X32U_EXPF:
+      IREE_UK_X32U_2D_LOOP(float, expf(a));
+      return 0;
+    case IREE_UK_X32U_FLOORF:
+      IREE_UK_X32U_2D_LOOP(float, floorf(a));
+      return 0;
+    case IREE_UK_X32U_LOGF:
+      IREE_UK_X32U_2D_LOOP(float, logf(a));
+      return 0;
+    case IREE_UK_X32U_NEGF:
+      IREE_UK_X32U_2D_LOOP(float, -a);
+      return 0;
+    case IREE_UK_X32U_RSQRTF:
+      IREE_UK_X32U_2D_LOOP(float, 1.0f / sqrtf(a));
+      return 0;
+    default:
+      return 1;
   }
-  return result_code;
 }
 
 DISPATCH_UKERNEL_BINARY_2D(addf, IREE_UK_X32B_ADDF, iree_uk_uint32_t, x32b);
@@ -0,0 +1,602 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/runtime/batcher.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/modules/hal/module.h"
+#include "iree/runtime/call.h"
+#include "iree/runtime/session.h"
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_options_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_runtime_batcher_options_initialize(
+    iree_runtime_batcher_options_t* out_options) {
+  IREE_ASSERT_ARGUMENT(out_options);
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->flags = IREE_RUNTIME_BATCHER_FLAG_NONE;
+  out_options->max_batch_size = 8;
+  out_options->max_latency = 1000000;  // 1ms
+}
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_t
+//===----------------------------------------------------------------------===//
+
+// Layout of a batched function argument established by the first request.
+typedef struct iree_runtime_batcher_input_t {
+  iree_hal_element_type_t element_type;
+  // Shape of a single row (dimensions 1 to N of request shapes).
+  iree_host_size_t row_rank;
+  iree_hal_dim_t* row_shape;
+  iree_device_size_t row_byte_length;
+  // Device buffer with storage for max_batch_size rows. Allocated on first use.
+  iree_hal_buffer_t* buffer;
+} iree_runtime_batcher_input_t;
+
+// A request waiting for its batch to execute.
+// Stored on the stack of the thread calling iree_runtime_batcher_call.
+typedef struct iree_runtime_batcher_request_t {
+  struct iree_runtime_batcher_request_t* next;
+  iree_vm_list_t* inputs;
+  iree_vm_list_t* outputs;
+  // Number of rows along the batch dimension in all inputs.
+  iree_host_size_t row_count;
+  // Result of the request; only valid once |is_complete| is set.
+  iree_status_t status;
+  bool is_complete;
+} iree_runtime_batcher_request_t;
+
+// A batch of requests.
+// Stored on the stack of the thread whose request opened the batch.
+typedef struct iree_runtime_batcher_batch_t {
+  iree_runtime_batcher_request_t* head;
+  iree_runtime_batcher_request_t* tail;
+  // Total rows across all requests.
+  iree_host_size_t row_count;
+  // Set when no more requests may join the batch.
+  bool is_sealed;
+} iree_runtime_batcher_batch_t;
+
+struct iree_runtime_batcher_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_runtime_session_t* session;
+  iree_runtime_batcher_options_t options;
+
+  // Guards batch formation and request completion.
+  iree_slim_mutex_t mutex;
+  // Posted when a batch is sealed and when the requests of a batch complete.
+  iree_notification_t notification;
+  // Batch accepting new requests, if any.
+  iree_runtime_batcher_batch_t* open_batch IREE_GUARDED_BY(mutex);
+  // True once the input layout has been established by the first request.
+  bool has_layout IREE_GUARDED_BY(mutex);
+
+  // Serializes batch execution as the call and input buffers are shared.
+  iree_slim_mutex_t execute_mutex;
+  iree_runtime_call_t call IREE_GUARDED_BY(execute_mutex);
+
+  iree_host_size_t output_count;
+  iree_host_size_t input_count;
+  iree_runtime_batcher_input_t inputs[];
+};
+
+static void iree_runtime_batcher_destroy(iree_runtime_batcher_t* batcher);
+
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_create(
+    iree_runtime_session_t* session, iree_vm_function_t function,
+    const iree_runtime_batcher_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_batcher_t** out_batcher) {
+  IREE_ASSERT_ARGUMENT(session);
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_batcher);
+  *out_batcher = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (options->max_batch_size == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "max_batch_size must be at least 1");
+  }
+
+  // Only functions taking and returning buffer views can be batched.
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t arguments = iree_string_view_empty();
+  iree_string_view_t results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(&signature, &arguments,
+                                                    &results));
+  bool is_batchable = arguments.size > 0;
+  for (iree_host_size_t i = 0; i < arguments.size; ++i) {
+    is_batchable = is_batchable && arguments.data[i] == IREE_VM_CCONV_TYPE_REF;
+  }
+  for (iree_host_size_t i = 0; i < results.size; ++i) {
+    is_batchable = is_batchable && results.data[i] == IREE_VM_CCONV_TYPE_REF;
+  }
+  if (!is_batchable) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "batched functions must take one or more buffer views and only return "
+        "buffer views; signature is '%.*s'",
+        (int)signature.calling_convention.size,
+        signature.calling_convention.data);
+  }
+
+  iree_runtime_batcher_t* batcher = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              host_allocator,
+              sizeof(*batcher) + arguments.size * sizeof(batcher->inputs[0]),
+              (void**)&batcher));
+  iree_atomic_ref_count_init(&batcher->ref_count);
+  batcher->host_allocator = host_allocator;
+  batcher->session = session;
+  iree_runtime_session_retain(session);
+  batcher->options = *options;
+  iree_slim_mutex_initialize(&batcher->mutex);
+  iree_notification_initialize(&batcher->notification);
+  iree_slim_mutex_initialize(&batcher->execute_mutex);
+  batcher->output_count = results.size;
+  batcher->input_count = arguments.size;
+
+  iree_status_t status =
+      iree_runtime_call_initialize(session, function, &batcher->call);
+
+  if (iree_status_is_ok(status)) {
+    *out_batcher = batcher;
+  } else {
+    // The call deinitializes itself on failure.
+    memset(&batcher->call, 0, sizeof(batcher->call));
+    iree_runtime_batcher_release(batcher);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_create_by_name(
+    iree_runtime_session_t* session, iree_string_view_t full_name,
+    const iree_runtime_batcher_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_batcher_t** out_batcher) {
+  iree_vm_function_t function;
+  IREE_RETURN_IF_ERROR(
+      iree_runtime_session_lookup_function(session, full_name, &function));
+  return iree_runtime_batcher_create(session, function, options,
+                                     host_allocator, out_batcher);
+}
+
+static void iree_runtime_batcher_destroy(iree_runtime_batcher_t* batcher) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = batcher->host_allocator;
+
+  for (iree_host_size_t i = 0; i < batcher->input_count; ++i) {
+    iree_runtime_batcher_input_t* input = &batcher->inputs[i];
+    iree_allocator_free(host_allocator, input->row_shape);
+    iree_hal_buffer_release(input->buffer);
+  }
+  if (batcher->call.session) iree_runtime_call_deinitialize(&batcher->call);
+
+  iree_slim_mutex_deinitialize(&batcher->execute_mutex);
+  iree_notification_deinitialize(&batcher->notification);
+  iree_slim_mutex_deinitialize(&batcher->mutex);
+  iree_runtime_session_release(batcher->session);
+  iree_allocator_free(host_allocator, batcher);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_runtime_batcher_retain(
+    iree_runtime_batcher_t* batcher) {
+  if (batcher) {
+    iree_atomic_ref_count_inc(&batcher->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_runtime_batcher_release(
+    iree_runtime_batcher_t* batcher) {
+  if (batcher && iree_atomic_ref_count_dec(&batcher->ref_count) == 1) {
+    iree_runtime_batcher_destroy(batcher);
+  }
+}
+
+// Validates the request |inputs| and returns the number of rows they contain.
+static iree_status_t iree_runtime_batcher_query_row_count(
+    iree_runtime_batcher_t* batcher, iree_vm_list_t* inputs,
+    iree_host_size_t* out_row_count) {
+  *out_row_count = 0;
+  if (iree_vm_list_size(inputs) != batcher->input_count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "expected %" PRIhsz " inputs but got %" PRIhsz,
+                            batcher->input_count, iree_vm_list_size(inputs));
+  }
+  iree_host_size_t row_count = 0;
+  for (iree_host_size_t i = 0; i < batcher->input_count; ++i) {
+    iree_hal_buffer_view_t* view =
+        iree_vm_list_get_buffer_view_assign(inputs, i);
+    if (!view) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "input %" PRIhsz " is not a buffer view", i);
+    } else if (iree_hal_buffer_view_shape_rank(view) == 0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "input %" PRIhsz " has no batch dimension", i);
+    } else if (iree_hal_buffer_view_encoding_type(view) !=
+               IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "input %" PRIhsz " is not dense row-major", i);
+    }
+    iree_host_size_t input_row_count =
+        (iree_host_size_t)iree_hal_buffer_view_shape_dim(view, 0);
+    if (i == 0) {
+      row_count = input_row_count;
+    } else if (input_row_count != row_count) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "input %" PRIhsz " has %" PRIhsz " rows but input 0 has %" PRIhsz, i,
+          input_row_count, row_count);
+    }
+  }
+  if (row_count == 0 || row_count > batcher->options.max_batch_size) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "requests must have between 1 and %" PRIhsz
+                            " rows but got %" PRIhsz,
+                            batcher->options.max_batch_size, row_count);
+  }
+  *out_row_count = row_count;
+  return iree_ok_status();
+}
+
+// Establishes the input layout from the first request.
+static iree_status_t iree_runtime_batcher_initialize_layout(
+    iree_runtime_batcher_t* batcher, iree_vm_list_t* inputs,
+    iree_host_size_t row_count) {
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < batcher->input_count; ++i) {
+    iree_runtime_batcher_input_t* input = &batcher->inputs[i];
+    iree_hal_buffer_view_t* view =
+        iree_vm_list_get_buffer_view_assign(inputs, i);
+    input->element_type = iree_hal_buffer_view_element_type(view);
+    input->row_rank = iree_hal_buffer_view_shape_rank(view) - 1;
+    input->row_byte_length =
+        iree_hal_buffer_view_byte_length(view) / row_count;
+    if (input->row_rank > 0) {
+      status = iree_allocator_malloc(
+          batcher->host_allocator,
+          input->row_rank * sizeof(input->row_shape[0]),
+          (void**)&input->row_shape);
+      if (!iree_status_is_ok(status)) break;
+      memcpy(input->row_shape, iree_hal_buffer_view_shape_dims(view) + 1,
+             input->row_rank * sizeof(input->row_shape[0]));
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    batcher->has_layout = true;
+  } else {
+    for (iree_host_size_t i = 0; i < batcher->input_count; ++i) {
+      iree_runtime_batcher_input_t* input = &batcher->inputs[i];
+      iree_allocator_free(batcher->host_allocator, input->row_shape);
+      input->row_shape = NULL;
+    }
+  }
+  return status;
+}
+
+// Verifies that the request |inputs| match the established input layout.
+static iree_status_t iree_runtime_batcher_check_layout(
+    iree_runtime_batcher_t* batcher, iree_vm_list_t* inputs,
+    iree_host_size_t row_count) {
+  if (!batcher->has_layout) {
+    return iree_runtime_batcher_initialize_layout(batcher, inputs, row_count);
+  }
+  for (iree_host_size_t i = 0; i < batcher->input_count; ++i) {
+    const iree_runtime_batcher_input_t* input = &batcher->inputs[i];
+    iree_hal_buffer_view_t* view =
+        iree_vm_list_get_buffer_view_assign(inputs, i);
+    bool matches =
+        iree_hal_buffer_view_element_type(view) == input->element_type &&
+        iree_hal_buffer_view_shape_rank(view) == input->row_rank + 1 &&
+        memcmp(iree_hal_buffer_view_shape_dims(view) + 1, input->row_shape,
+               input->row_rank * sizeof(input->row_shape[0])) == 0;
+    if (!matches) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "input %" PRIhsz
+          " element type or row shape does not match prior requests",
+          i);
+    }
+  }
+  return iree_ok_status();
+}
+
+static void iree_runtime_batcher_batch_append(
+    iree_runtime_batcher_batch_t* batch,
+    iree_runtime_batcher_request_t* request) {
+  if (batch->tail) {
+    batch->tail->next = request;
+  } else {
+    batch->head = request;
+  }
+  batch->tail = request;
+  batch->row_count += request->row_count;
+}
+
+// Seals |batch| such that no more requests may join it.
+static void iree_runtime_batcher_seal(iree_runtime_batcher_t* batcher,
+                                      iree_runtime_batcher_batch_t* batch) {
+  if (batch->is_sealed) return;
+  batch->is_sealed = true;
+  if (batcher->open_batch == batch) batcher->open_batch = NULL;
+  iree_notification_post(&batcher->notification, IREE_ALL_WAITERS);
+}
+
+// Copies input |i| of all requests in |batch| into the preallocated batch
+// buffer and pushes a buffer view of it with |batch_size| rows to the call.
+static iree_status_t iree_runtime_batcher_gather_input(
+    iree_runtime_batcher_t* batcher, const iree_runtime_batcher_batch_t* batch,
+    iree_host_size_t i, iree_host_size_t batch_size) {
+  iree_runtime_batcher_input_t* input = &batcher->inputs[i];
+  if (!input->buffer) {
+    iree_hal_buffer_params_t params = {
+        .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
+        .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+    };
+    IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+        iree_runtime_session_device_allocator(batcher->session), params,
+        input->row_byte_length * batcher->options.max_batch_size,
+        &input->buffer));
+  }
+
+  // Concatenate the request rows.
+  iree_hal_device_t* device = iree_runtime_session_device(batcher->session);
+  iree_device_size_t row_offset = 0;
+  for (iree_runtime_batcher_request_t* request = batch->head; request != NULL;
+       request = request->next) {
+    iree_hal_buffer_view_t* view =
+        iree_vm_list_get_buffer_view_assign(request->inputs, i);
+    IREE_RETURN_IF_ERROR(iree_hal_device_transfer_d2d(
+        device, iree_hal_buffer_view_buffer(view), 0, input->buffer,
+        row_offset * input->row_byte_length,
+        iree_hal_buffer_view_byte_length(view),
+        IREE_HAL_TRANSFER_BUFFER_FLAG_DEFAULT, iree_infinite_timeout()));
+    row_offset += request->row_count;
+  }
+
+  // Wrap the rows used by the call in a buffer view with the batched shape.
+  iree_hal_dim_t* shape =
+      (iree_hal_dim_t*)iree_alloca((input->row_rank + 1) * sizeof(*shape));
+  shape[0] = (iree_hal_dim_t)batch_size;
+  if (input->row_rank > 0) {
+    memcpy(&shape[1], input->row_shape, input->row_rank * sizeof(*shape));
+  }
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_subspan(
+      input->buffer, 0, batch_size * input->row_byte_length, &buffer));
+  iree_hal_buffer_view_t* batch_view = NULL;
+  iree_status_t status = iree_hal_buffer_view_create(
+      buffer, input->row_rank + 1, shape, input->element_type,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, batcher->host_allocator,
+      &batch_view);
+  iree_hal_buffer_release(buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_runtime_call_inputs_push_back_buffer_view(&batcher->call,
+                                                            batch_view);
+  }
+  iree_hal_buffer_view_release(batch_view);
+  return status;
+}
+
+// Splits output |i| of the call into buffer views aliasing the rows of each
+// request in |batch| and appends them to the request outputs. Failures to
+// produce the view of a single request are stored in its status.
+static iree_status_t iree_runtime_batcher_scatter_output(
+    iree_runtime_batcher_t* batcher, const iree_runtime_batcher_batch_t* batch,
+    iree_host_size_t i, iree_host_size_t batch_size) {
+  iree_hal_buffer_view_t* batch_view = iree_vm_list_get_buffer_view_assign(
+      iree_runtime_call_outputs(&batcher->call), i);
+  if (!batch_view) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "result %" PRIhsz " is not a buffer view", i);
+  }
+  iree_host_size_t rank = iree_hal_buffer_view_shape_rank(batch_view);
+  if (rank == 0 ||
+      iree_hal_buffer_view_shape_dim(batch_view, 0) != batch_size ||
+      iree_hal_buffer_view_encoding_type(batch_view) !=
+          IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "result %" PRIhsz " is not a dense row-major buffer view with %" PRIhsz
+        " rows",
+        i, batch_size);
+  }
+  iree_device_size_t row_byte_length =
+      iree_hal_buffer_view_byte_length(batch_view) / batch_size;
+  iree_hal_dim_t* shape = (iree_hal_dim_t*)iree_alloca(rank * sizeof(*shape));
+  memcpy(shape, iree_hal_buffer_view_shape_dims(batch_view),
+         rank * sizeof(*shape));
+
+  iree_device_size_t row_offset = 0;
+  for (iree_runtime_batcher_request_t* request = batch->head; request != NULL;
+       request = request->next) {
+    shape[0] = (iree_hal_dim_t)request->row_count;
+    iree_hal_buffer_t* buffer = NULL;
+    iree_status_t status = iree_hal_buffer_subspan(
+        iree_hal_buffer_view_buffer(batch_view), row_offset * row_byte_length,
+        request->row_count * row_byte_length, &buffer);
+    iree_hal_buffer_view_t* view = NULL;
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_buffer_view_create(
+          buffer, rank, shape, iree_hal_buffer_view_element_type(batch_view),
+          IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, batcher->host_allocator,
+          &view);
+    }
+    iree_hal_buffer_release(buffer);
+    if (iree_status_is_ok(status)) {
+      iree_vm_ref_t value = {0};
+      status = iree_vm_ref_wrap_assign(view, iree_hal_buffer_view_type(),
+                                       &value);
+      if (iree_status_is_ok(status)) {
+        status = iree_vm_list_push_ref_retain(request->outputs, &value);
+      }
+    }
+    iree_hal_buffer_view_release(view);
+    if (iree_status_is_ok(request->status)) {
+      request->status = status;
+    } else {
+      iree_status_ignore(status);
+    }
+    row_offset += request->row_count;
+  }
+  return iree_ok_status();
+}
+
+// Executes the batched function for all requests in |batch|.
+static iree_status_t iree_runtime_batcher_execute(
+    iree_runtime_batcher_t* batcher,
+    const iree_runtime_batcher_batch_t* batch) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, batch->row_count);
+
+  iree_host_size_t batch_size = batch->row_count;
+  if (batcher->options.flags &
+      IREE_RUNTIME_BATCHER_FLAG_PAD_TO_MAX_BATCH_SIZE) {
+    batch_size = batcher->options.max_batch_size;
+  }
+
+  iree_runtime_call_reset(&batcher->call);
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0;
+       i < batcher->input_count && iree_status_is_ok(status); ++i) {
+    status = iree_runtime_batcher_gather_input(batcher, batch, i, batch_size);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_runtime_call_invoke(&batcher->call,
+                                      IREE_RUNTIME_CALL_FLAG_RESERVED);
+  }
+  for (iree_host_size_t i = 0;
+       i < batcher->output_count && iree_status_is_ok(status); ++i) {
+    status = iree_runtime_batcher_scatter_output(batcher, batch, i, batch_size);
+  }
+  iree_runtime_call_reset(&batcher->call);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_call(
+    iree_runtime_batcher_t* batcher, iree_vm_list_t* inputs,
+    iree_vm_list_t* outputs) {
+  IREE_ASSERT_ARGUMENT(batcher);
+  IREE_ASSERT_ARGUMENT(inputs);
+  IREE_ASSERT_ARGUMENT(outputs);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_runtime_batcher_request_t request;
+  memset(&request, 0, sizeof(request));
+  request.inputs = inputs;
+  request.outputs = outputs;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_runtime_batcher_query_row_count(batcher, inputs,
+                                               &request.row_count));
+
+  iree_slim_mutex_lock(&batcher->mutex);
+  iree_status_t status =
+      iree_runtime_batcher_check_layout(batcher, inputs, request.row_count);
+  if (!iree_status_is_ok(status)) {
+    iree_slim_mutex_unlock(&batcher->mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_runtime_batcher_batch_t* open_batch = batcher->open_batch;
+  const iree_host_size_t max_batch_size = batcher->options.max_batch_size;
+  if (open_batch &&
+      open_batch->row_count + request.row_count <= max_batch_size) {
+    // Join the open batch and wait for the thread that opened it to execute it.
+    iree_runtime_batcher_batch_append(open_batch, &request);
+    if (open_batch->row_count == max_batch_size) {
+      iree_runtime_batcher_seal(batcher, open_batch);
+    }
+    while (!request.is_complete) {
+      iree_wait_token_t wait_token =
+          iree_notification_prepare_wait(&batcher->notification);
+      iree_slim_mutex_unlock(&batcher->mutex);
+      iree_notification_commit_wait(&batcher->notification, wait_token,
+                                    IREE_DURATION_ZERO,
+                                    IREE_TIME_INFINITE_FUTURE);
+      iree_slim_mutex_lock(&batcher->mutex);
+    }
+    iree_slim_mutex_unlock(&batcher->mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return request.status;
+  }
+
+  // The request does not fit in the open batch (if any), which is sealed so
+  // that it executes as soon as possible, and a new batch is opened.
+  if (open_batch) iree_runtime_batcher_seal(batcher, open_batch);
+  iree_runtime_batcher_batch_t batch;
+  memset(&batch, 0, sizeof(batch));
+  iree_runtime_batcher_batch_append(&batch, &request);
+  batcher->open_batch = &batch;
+  if (batch.row_count == max_batch_size) {
+    iree_runtime_batcher_seal(batcher, &batch);
+  }
+
+  // Wait for the batch to fill or the latency deadline to be reached.
+  iree_time_t deadline_ns =
+      iree_relative_timeout_to_deadline_ns(batcher->options.max_latency);
+  while (!batch.is_sealed) {
+    iree_wait_token_t wait_token =
+        iree_notification_prepare_wait(&batcher->notification);
+    iree_slim_mutex_unlock(&batcher->mutex);
+    bool was_posted = iree_notification_commit_wait(
+        &batcher->notification, wait_token, IREE_DURATION_ZERO, deadline_ns);
+    iree_slim_mutex_lock(&batcher->mutex);
+    if (!was_posted) break;
+  }
+  iree_slim_mutex_unlock(&batcher->mutex);
+
+  // Requests continue to join while a prior batch is executing and the batch
+  // is only sealed once it is able to execute.
+  iree_slim_mutex_lock(&batcher->execute_mutex);
+  iree_slim_mutex_lock(&batcher->mutex);
+  iree_runtime_batcher_seal(batcher, &batch);
+  iree_slim_mutex_unlock(&batcher->mutex);
+  iree_status_t batch_status = iree_runtime_batcher_execute(batcher, &batch);
+  iree_slim_mutex_unlock(&batcher->execute_mutex);
+
+  // Complete all requests. The requests live on the stacks of their waiting
+  // threads and must not be accessed once marked complete.
+  iree_slim_mutex_lock(&batcher->mutex);
+  iree_runtime_batcher_request_t* next_request = batch.head;
+  while (next_request) {
+    iree_runtime_batcher_request_t* batch_request = next_request;
+    next_request = batch_request->next;
+    if (batch_request == &request) continue;
+    if (!iree_status_is_ok(batch_status)) {
+      iree_status_ignore(batch_request->status);
+      batch_request->status = iree_status_clone(batch_status);
+    }
+    batch_request->is_complete = true;
+  }
+  iree_slim_mutex_unlock(&batcher->mutex);
+  iree_notification_post(&batcher->notification, IREE_ALL_WAITERS);
+
+  if (iree_status_is_ok(batch_status)) {
+    status = request.status;
+  } else {
+    iree_status_ignore(request.status);
+    status = batch_status;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,112 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_RUNTIME_BATCHER_H_
+#define IREE_RUNTIME_BATCHER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/vm/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+typedef struct iree_runtime_session_t iree_runtime_session_t;
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_options_t
+//===----------------------------------------------------------------------===//
+
+enum iree_runtime_batcher_flag_bits_t {
+  IREE_RUNTIME_BATCHER_FLAG_NONE = 0u,
+  // Always invokes the batched function with max_batch_size rows even if fewer
+  // requests were batched. Required for functions compiled with a static batch
+  // dimension. Rows beyond those of the batched requests have undefined
+  // contents and their results are discarded.
+  IREE_RUNTIME_BATCHER_FLAG_PAD_TO_MAX_BATCH_SIZE = 1u << 0,
+};
+typedef uint32_t iree_runtime_batcher_flags_t;
+
+// Policy controlling how requests are grouped into batches.
+typedef struct iree_runtime_batcher_options_t {
+  iree_runtime_batcher_flags_t flags;
+  // Maximum number of rows along the batch dimension (dimension 0) of a batch.
+  // A batch is executed as soon as it is full.
+  iree_host_size_t max_batch_size;
+  // Maximum time the first request of a batch waits for other requests to
+  // join before the batch is executed. IREE_DURATION_ZERO executes each batch
+  // immediately and only requests arriving while another batch is executing
+  // will be grouped.
+  iree_duration_t max_latency;
+} iree_runtime_batcher_options_t;
+
+// Initializes |out_options| to the default batching policy.
+IREE_API_EXPORT void iree_runtime_batcher_options_initialize(
+    iree_runtime_batcher_options_t* out_options);
+
+//===----------------------------------------------------------------------===//
+// iree_runtime_batcher_t
+//===----------------------------------------------------------------------===//
+
+// Groups concurrent calls to a function into batched invocations.
+//
+// The batched function must take and return only buffer views with the batch
+// along dimension 0. Each request passes buffer views with the same leading
+// dimension (the number of rows in the request) and otherwise the same shape,
+// element type, and encoding as all other requests. Requests are concatenated
+// along dimension 0 into device buffers preallocated for max_batch_size rows,
+// the function is invoked once for the batch, and each request receives buffer
+// views aliasing its rows of the batched results.
+//
+// Batching is driven by the calling threads: the first request of a batch
+// waits up to max_latency for other requests to join and then executes the
+// batch on behalf of all of them. No threads are created by the batcher.
+// Batches execute one at a time and the batcher must be the only user of the
+// session while batches are executing as the VM context is not thread-safe.
+//
+// Thread-safe; iree_runtime_batcher_call may be called from any thread.
+typedef struct iree_runtime_batcher_t iree_runtime_batcher_t;
+
+// Creates a batcher that invokes |function| within |session|.
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_create(
+    iree_runtime_session_t* session, iree_vm_function_t function,
+    const iree_runtime_batcher_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_batcher_t** out_batcher);
+
+// Creates a batcher that invokes the function |full_name| within |session|.
+// See iree_runtime_session_lookup_function for the name format.
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_create_by_name(
+    iree_runtime_session_t* session, iree_string_view_t full_name,
+    const iree_runtime_batcher_options_t* options,
+    iree_allocator_t host_allocator, iree_runtime_batcher_t** out_batcher);
+
+// Retains the given |batcher| for the caller.
+IREE_API_EXPORT void iree_runtime_batcher_retain(
+    iree_runtime_batcher_t* batcher);
+
+// Releases the given |batcher| from the caller.
+IREE_API_EXPORT void iree_runtime_batcher_release(
+    iree_runtime_batcher_t* batcher);
+
+// Synchronously invokes the batched function for a single request.
+// |inputs| must contain one buffer view per function argument and the buffer
+// views for each function result will be appended to |outputs| once the batch
+// the request joined has executed. Output buffer views alias the batched
+// results and may be retained for as long as needed.
+//
+// Errors from executing the batch are returned from all requests in the batch.
+IREE_API_EXPORT iree_status_t iree_runtime_batcher_call(
+    iree_runtime_batcher_t* batcher, iree_vm_list_t* inputs,
+    iree_vm_list_t* outputs);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_RUNTIME_BATCHER_H_
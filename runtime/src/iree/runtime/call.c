@@ -52,6 +52,20 @@ IREE_API_EXPORT iree_status_t iree_runtime_call_initialize(
                             host_allocator, &out_call->outputs);
   }
 
+  // Allocate the stack used for all invocations of the call. Any storage it
+  // grows into while executing is kept for subsequent invocations.
+  if (iree_status_is_ok(status)) {
+    iree_vm_context_t* context = iree_runtime_session_context(session);
+    iree_vm_invocation_flags_t flags = IREE_VM_INVOCATION_FLAG_NONE;
+    if (iree_vm_context_flags(context) &
+        IREE_VM_CONTEXT_FLAG_TRACE_EXECUTION) {
+      flags |= IREE_VM_INVOCATION_FLAG_TRACE_EXECUTION;
+    }
+    status = iree_vm_stack_allocate(flags,
+                                    iree_vm_context_state_resolver(context),
+                                    host_allocator, &out_call->stack);
+  }
+
   if (!iree_status_is_ok(status)) {
     iree_runtime_call_deinitialize(out_call);
   }
@@ -69,6 +83,7 @@ IREE_API_EXPORT iree_status_t iree_runtime_call_initialize_by_name(
 
 IREE_API_EXPORT void iree_runtime_call_deinitialize(iree_runtime_call_t* call) {
   IREE_ASSERT_ARGUMENT(call);
+  if (call->stack) iree_vm_stack_free(call->stack);
   iree_vm_list_release(call->inputs);
   iree_vm_list_release(call->outputs);
   iree_runtime_session_release(call->session);
@@ -94,8 +109,13 @@ IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_outputs(
 
 IREE_API_EXPORT iree_status_t iree_runtime_call_invoke(
     iree_runtime_call_t* call, iree_runtime_call_flags_t flags) {
-  return iree_runtime_session_call(call->session, &call->function, call->inputs,
-                                   call->outputs);
+  IREE_ASSERT_ARGUMENT(call);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_vm_invoke_with_stack(
+      call->stack, iree_runtime_session_context(call->session), call->function,
+      /*policy=*/NULL, call->inputs, call->outputs);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 //===----------------------------------------------------------------------===//
@@ -41,6 +41,11 @@ typedef uint32_t iree_runtime_call_flags_t;
 // call like this callers are required to either reset the call, copy their
 // data out, or reset the particular output they are consuming.
 //
+// The call owns a VM stack that is reused across invocations along with the
+// input and output lists. Once the lists and stack have grown to the sizes
+// required by the function, resetting and re-invoking the call performs no
+// heap allocations of its own.
+//
 // Thread-compatible; these are designed to be stack-local or embedded in a user
 // data structure that can provide synchronization when required.
 typedef struct iree_runtime_call_t {
@@ -48,6 +53,7 @@ typedef struct iree_runtime_call_t {
   iree_vm_function_t function;
   iree_vm_list_t* inputs;
   iree_vm_list_t* outputs;
+  iree_vm_stack_t* stack;
 } iree_runtime_call_t;
 
 // Initializes call state for a call to |function| within |session|.
@@ -68,7 +74,7 @@ IREE_API_EXPORT iree_status_t iree_runtime_call_initialize_by_name(
     iree_runtime_session_t* session, iree_string_view_t full_name,
     iree_runtime_call_t* out_call);
 
-// Deinitializes a call by releasing its input and output lists.
+// Deinitializes a call by releasing its input and output lists and stack.
 IREE_API_EXPORT void iree_runtime_call_deinitialize(iree_runtime_call_t* call);
 
 // Resets the input and output lists back to 0-length in preparation for
@@ -88,7 +94,8 @@ IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_outputs(
 
 // Synchronously invokes the call and returns the status.
 // The inputs list will remain unchanged to allow for subsequent reuse and the
-// output list will be populated with the results of the call.
+// output list will be populated with the results of the call. The stack owned
+// by the call is reused and must not be used by concurrent invocations.
 IREE_API_EXPORT iree_status_t iree_runtime_call_invoke(
     iree_runtime_call_t* call, iree_runtime_call_flags_t flags);
 
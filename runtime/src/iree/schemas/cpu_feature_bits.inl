@@ -123,3 +123,10 @@ IREE_CPU_FEATURE_BIT(X86_64, 0, 52, AMXBF16, "amx-bf16")
 // General features and high-level switches.
 // RISCV vector extension.
 IREE_CPU_FEATURE_BIT(RISCV_64, 0, 0, RVV, "rvv")
+
+//===----------------------------------------------------------------------===//
+// IREE_ARCH_WASM_32 / wasm32
+//===----------------------------------------------------------------------===//
+
+// Fixed-width 128-bit SIMD proposal.
+IREE_CPU_FEATURE_BIT(WASM_32, 0, 0, SIMD128, "simd128")
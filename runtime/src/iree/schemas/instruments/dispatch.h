@@ -30,6 +30,7 @@ enum iree_idbts_chunk_type_e {
   // NOTE: these will change in the real IDB spec.
   IREE_IDBTS_CHUNK_TYPE_DISPATCH_METADATA = 0x0000u,
   IREE_IDBTS_CHUNK_TYPE_DISPATCH_RINGBUFFER = 0x0001u,
+  IREE_IDBTS_CHUNK_TYPE_DISPATCH_RINGBUFFER_SPAN = 0x0002u,
 };
 typedef uint16_t iree_idbts_chunk_type_t;
 
@@ -64,6 +65,21 @@ static_assert(sizeof(iree_idbts_chunk_header_t) % 16 == 0,
 // its end.
 #define IREE_INSTRUMENT_DISPATCH_PADDING 4096
 
+// Prefix of an IREE_IDBTS_CHUNK_TYPE_DISPATCH_RINGBUFFER_SPAN chunk.
+// Spans are produced by draining the ringbuffer while the program is running
+// and contain a contiguous sequence of entries as they were written. Offsets
+// referenced by entries (such as workgroup keys) are ringbuffer offsets and can
+// be resolved with |ring_offset| as the ringbuffer offset of the first entry.
+typedef struct iree_instrument_dispatch_span_header_t {
+  // Power-of-two size of the ringbuffer storage the span was drained from.
+  uint64_t ring_size;
+  // Monotonically increasing write head offset of the first entry in the span.
+  // The ringbuffer offset of the entry is |ring_offset| & (|ring_size| - 1).
+  uint64_t ring_offset;
+} iree_instrument_dispatch_span_header_t;
+static_assert(sizeof(iree_instrument_dispatch_span_header_t) % 16 == 0,
+              "span header must be 16-byte aligned");
+
 typedef enum iree_instrument_dispatch_type_e {
   IREE_INSTRUMENT_DISPATCH_TYPE_WORKGROUP = 0b00000000,
   IREE_INSTRUMENT_DISPATCH_TYPE_PRINT = 0b00000001,
@@ -130,4 +146,25 @@ typedef struct iree_instrument_dispatch_value_t {
   uint64_t bits;
 } iree_instrument_dispatch_value_t;
 
+// Returns the total byte size of the entry starting with |header| or 0 if the
+// entry type is unknown. Entries are always padded to 16-byte multiples.
+static inline uint64_t iree_instrument_dispatch_entry_size(
+    const iree_instrument_dispatch_header_t* header) {
+  switch (header->tag) {
+    case IREE_INSTRUMENT_DISPATCH_TYPE_WORKGROUP:
+      return sizeof(iree_instrument_dispatch_workgroup_t);
+    case IREE_INSTRUMENT_DISPATCH_TYPE_PRINT:
+      return (sizeof(iree_instrument_dispatch_print_t) +
+              ((const iree_instrument_dispatch_print_t*)header)->length + 15) &
+             ~(uint64_t)15;
+    case IREE_INSTRUMENT_DISPATCH_TYPE_VALUE:
+      return sizeof(iree_instrument_dispatch_value_t);
+    case IREE_INSTRUMENT_DISPATCH_TYPE_MEMORY_LOAD:
+    case IREE_INSTRUMENT_DISPATCH_TYPE_MEMORY_STORE:
+      return sizeof(iree_instrument_dispatch_memory_op_t);
+    default:
+      return 0;
+  }
+}
+
 #endif  // IREE_SCHEMAS_INSTRUMENTS_DISPATCH_H_
@@ -160,6 +160,9 @@ enum iree_io_parameter_archive_entry_type_e {
   // Entry represents data stored in an external file.
   // See iree_io_parameter_archive_external_entry_t.
   IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_EXTERNAL = 3,
+  // Entry represents compressed data embedded in the archive.
+  // See iree_io_parameter_archive_compressed_data_entry_t.
+  IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_COMPRESSED_DATA = 4,
 };
 // Defines the type of an entry in the archive entry table.
 typedef uint32_t iree_io_parameter_archive_entry_type_t;
@@ -226,6 +229,32 @@ typedef struct iree_io_parameter_archive_data_entry_t {
   iree_io_parameter_archive_storage_ref_t storage;
 } iree_io_parameter_archive_data_entry_t;
 
+// Compression algorithms used by compressed data entries.
+enum iree_io_parameter_archive_compression_e {
+  // Chunked LZ4 blocks.
+  IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_LZ4 = 1,
+};
+// Defines the compression algorithm of a compressed data entry.
+typedef uint32_t iree_io_parameter_archive_compression_t;
+
+// An entry referencing a compressed blob in the archive data storage segment.
+// The blob is a header and table of independently compressed chunks (see
+// iree/io/compression.h) so that readers can decompress chunks in parallel
+// directly into their destination. Readers that don't support this entry type
+// will fail to load the archive instead of producing garbage.
+typedef struct iree_io_parameter_archive_compressed_data_entry_t {
+  // Entry header with type
+  // IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_COMPRESSED_DATA.
+  iree_io_parameter_archive_entry_header_t header;
+  // Relative offset and length of the compressed blob in the data storage
+  // segment.
+  iree_io_parameter_archive_storage_ref_t storage;
+  // Total decompressed length of the entry in bytes.
+  iree_io_physical_size_t length;
+  // Compression algorithm used by all chunks in the blob.
+  iree_io_parameter_archive_compression_t compression;
+} iree_io_parameter_archive_compressed_data_entry_t;
+
 // An entry referencing data in an external file.
 typedef struct iree_io_parameter_archive_external_entry_t {
   // Entry header with type IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_EXTERNAL.
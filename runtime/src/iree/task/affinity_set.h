@@ -25,15 +25,22 @@ extern "C" {
 // iree_task_affinity_set_t
 //===----------------------------------------------------------------------===//
 
+// A compact set of workers a task may execute on.
+// Each bit covers a block of 1 << affinity_shift consecutive workers in the
+// executor where the shift is chosen such that all workers fit within the
+// 64 bits (see iree_task_affinity_shift_for_worker_count). Executors with 64 or
+// fewer workers have a shift of 0 such that each bit selects one worker. This
+// keeps task headers small while still allowing executors with more workers
+// than bits; internally executors track workers with iree_task_worker_set_t.
 typedef uint64_t iree_task_affinity_set_t;
 
-// Allows for only a specific worker to be selected.
+// Allows for only a specific worker (or worker block) to be selected.
 static inline iree_task_affinity_set_t iree_task_affinity_for_worker(
     uint8_t worker_index) {
   return 1ull << worker_index;
 }
 
-// Allows for a range of workers to be selected.
+// Allows for a range of workers (or worker blocks) to be selected.
 static inline iree_task_affinity_set_t iree_task_affinity_for_worker_range(
     uint8_t worker_start, uint8_t worker_end) {
   return ((1ull << (worker_start - 1)) - 1) ^ ((1ull << worker_end) - 1);
@@ -44,6 +51,15 @@ static inline iree_task_affinity_set_t iree_task_affinity_for_any_worker(void) {
   return UINT64_MAX;
 }
 
+// Returns the shift applied to worker indices to derive their bit in an
+// iree_task_affinity_set_t for an executor with |worker_count| workers.
+static inline uint32_t iree_task_affinity_shift_for_worker_count(
+    iree_host_size_t worker_count) {
+  uint32_t shift = 0;
+  while ((64ull << shift) < worker_count) ++shift;
+  return shift;
+}
+
 #define iree_task_affinity_set_ones(count) \
   (0xFFFFFFFFFFFFFFFFull >> (64 - (count)))
 #define iree_task_affinity_set_count_leading_zeros(set) \
@@ -82,6 +98,183 @@ static inline iree_task_affinity_set_t iree_atomic_task_affinity_set_fetch_or(
   return iree_atomic_fetch_or_int64(set, value, order);
 }
 
+//===----------------------------------------------------------------------===//
+// iree_task_worker_set_t
+//===----------------------------------------------------------------------===//
+
+// Total number of 64-bit words in a worker set.
+#define IREE_TASK_WORKER_SET_WORD_COUNT \
+  ((IREE_TASK_EXECUTOR_MAX_WORKER_COUNT + 63) / 64)
+
+// Total number of bits in a worker set.
+#define IREE_TASK_WORKER_SET_BIT_COUNT (IREE_TASK_WORKER_SET_WORD_COUNT * 64)
+
+// Returns the word within a worker set containing |worker_index|.
+#define iree_task_worker_set_word_index(worker_index) ((worker_index) >> 6)
+
+// Returns the bit within its word representing |worker_index|.
+#define iree_task_worker_set_word_bit(worker_index) \
+  (1ull << ((worker_index) & 63))
+
+// A set of workers within an executor with one bit per worker.
+// Worker N is bit N % 64 of word N / 64. Operations are word-parallel and
+// bounded by IREE_TASK_WORKER_SET_WORD_COUNT instead of the worker count.
+typedef struct iree_task_worker_set_t {
+  iree_task_affinity_set_t words[IREE_TASK_WORKER_SET_WORD_COUNT];
+} iree_task_worker_set_t;
+
+// Removes all workers from |set|.
+static inline void iree_task_worker_set_clear(iree_task_worker_set_t* set) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    set->words[i] = 0;
+  }
+}
+
+// Resets |set| to contain workers [0, |count|).
+static inline void iree_task_worker_set_fill(iree_task_worker_set_t* set,
+                                             iree_host_size_t count) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    if (count >= (i + 1) * 64) {
+      set->words[i] = UINT64_MAX;
+    } else if (count > i * 64) {
+      set->words[i] = iree_task_affinity_set_ones(count - i * 64);
+    } else {
+      set->words[i] = 0;
+    }
+  }
+}
+
+// Adds |worker_index| to |set|.
+static inline void iree_task_worker_set_insert(iree_task_worker_set_t* set,
+                                               iree_host_size_t worker_index) {
+  set->words[iree_task_worker_set_word_index(worker_index)] |=
+      iree_task_worker_set_word_bit(worker_index);
+}
+
+// Returns true if |worker_index| is in |set|.
+static inline bool iree_task_worker_set_contains(
+    const iree_task_worker_set_t* set, iree_host_size_t worker_index) {
+  return (set->words[iree_task_worker_set_word_index(worker_index)] &
+          iree_task_worker_set_word_bit(worker_index)) != 0;
+}
+
+// Returns true if |set| contains no workers.
+static inline bool iree_task_worker_set_is_empty(
+    const iree_task_worker_set_t* set) {
+  iree_task_affinity_set_t any = 0;
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    any |= set->words[i];
+  }
+  return any == 0;
+}
+
+// Returns the total number of workers in |set|.
+static inline iree_host_size_t iree_task_worker_set_count(
+    const iree_task_worker_set_t* set) {
+  iree_host_size_t count = 0;
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    count += iree_task_affinity_set_count_ones(set->words[i]);
+  }
+  return count;
+}
+
+// Returns the lowest worker index in |set| or IREE_HOST_SIZE_MAX if empty.
+static inline iree_host_size_t iree_task_worker_set_find_first(
+    const iree_task_worker_set_t* set) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    if (set->words[i]) {
+      return i * 64 + iree_task_affinity_set_count_trailing_zeros(set->words[i]);
+    }
+  }
+  return IREE_HOST_SIZE_MAX;
+}
+
+// Expands a task |affinity_set| into the workers it covers in |out_set| given
+// the executor |affinity_shift| (see iree_task_affinity_set_t).
+static inline void iree_task_worker_set_from_affinity(
+    iree_task_affinity_set_t affinity_set, uint32_t affinity_shift,
+    iree_task_worker_set_t* out_set) {
+  if (affinity_shift == 0) {
+    iree_task_worker_set_clear(out_set);
+    out_set->words[0] = affinity_set;
+    return;
+  } else if (affinity_set == UINT64_MAX) {
+    iree_task_worker_set_fill(out_set, IREE_TASK_WORKER_SET_BIT_COUNT);
+    return;
+  }
+  iree_task_worker_set_clear(out_set);
+  const iree_task_affinity_set_t block_bits =
+      iree_task_affinity_set_ones(1u << affinity_shift);
+  while (affinity_set) {
+    iree_host_size_t block_index =
+        iree_task_affinity_set_count_trailing_zeros(affinity_set);
+    affinity_set &= affinity_set - 1;
+    iree_host_size_t worker_index = block_index << affinity_shift;
+    if (worker_index >= IREE_TASK_WORKER_SET_BIT_COUNT) break;
+    out_set->words[iree_task_worker_set_word_index(worker_index)] |=
+        block_bits << (worker_index & 63);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// iree_atomic_task_worker_set_t
+//===----------------------------------------------------------------------===//
+
+// An iree_task_worker_set_t with atomic words. Updates to individual workers
+// touch only the word containing them and are a single atomic operation;
+// multi-word loads are not atomic as a whole and should only be used as hints.
+typedef struct iree_atomic_task_worker_set_t {
+  iree_atomic_task_affinity_set_t words[IREE_TASK_WORKER_SET_WORD_COUNT];
+} iree_atomic_task_worker_set_t;
+
+static inline void iree_atomic_task_worker_set_load(
+    iree_atomic_task_worker_set_t* set, iree_memory_order_t order,
+    iree_task_worker_set_t* out_value) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    out_value->words[i] =
+        iree_atomic_task_affinity_set_load(&set->words[i], order);
+  }
+}
+
+static inline void iree_atomic_task_worker_set_store(
+    iree_atomic_task_worker_set_t* set, const iree_task_worker_set_t* value,
+    iree_memory_order_t order) {
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    iree_atomic_task_affinity_set_store(&set->words[i], value->words[i], order);
+  }
+}
+
+// Atomically adds |worker_index| to |set| and returns the prior value of the
+// word containing it.
+static inline iree_task_affinity_set_t iree_atomic_task_worker_set_insert(
+    iree_atomic_task_worker_set_t* set, iree_host_size_t worker_index,
+    iree_memory_order_t order) {
+  return iree_atomic_task_affinity_set_fetch_or(
+      &set->words[iree_task_worker_set_word_index(worker_index)],
+      iree_task_worker_set_word_bit(worker_index), order);
+}
+
+// Atomically removes |worker_index| from |set| and returns the prior value of
+// the word containing it.
+static inline iree_task_affinity_set_t iree_atomic_task_worker_set_erase(
+    iree_atomic_task_worker_set_t* set, iree_host_size_t worker_index,
+    iree_memory_order_t order) {
+  return iree_atomic_task_affinity_set_fetch_and(
+      &set->words[iree_task_worker_set_word_index(worker_index)],
+      ~iree_task_worker_set_word_bit(worker_index), order);
+}
+
+// Returns the approximate number of workers in |set|.
+static inline iree_host_size_t iree_atomic_task_worker_set_count(
+    iree_atomic_task_worker_set_t* set, iree_memory_order_t order) {
+  iree_host_size_t count = 0;
+  for (iree_host_size_t i = 0; i < IREE_TASK_WORKER_SET_WORD_COUNT; ++i) {
+    count += iree_task_affinity_set_count_ones(
+        iree_atomic_task_affinity_set_load(&set->words[i], order));
+  }
+  return count;
+}
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -10,12 +10,21 @@
 #include <string.h>
 
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/threading.h"
 #include "iree/task/topology.h"
 
 //===----------------------------------------------------------------------===//
 // Executor configuration
 //===----------------------------------------------------------------------===//
 
+IREE_FLAG(
+    bool, task_dispatch_locality, false,
+    "Partitions the workgroups of each dispatch into ranges that are always\n"
+    "processed by the same workers so that consecutive dispatches over the\n"
+    "same buffers find their data in warm caches. Workers only take\n"
+    "workgroups from other ranges to balance load once their own range has\n"
+    "been exhausted.");
+
 IREE_FLAG(
     int32_t, task_worker_spin_us, 0,
     "Maximum duration in microseconds each worker should spin waiting for\n"
@@ -24,6 +33,14 @@ IREE_FLAG(
     "when latency is the #1 priority (vs. thermals, system-wide scheduling,\n"
     "etc).");
 
+IREE_FLAG(
+    string, task_worker_spin_mode, "fixed",
+    "Controls how long idle workers spin when --task_worker_spin_us is set:\n"
+    "  'fixed': always spin for --task_worker_spin_us before parking.\n"
+    "  'adaptive': spin for up to --task_worker_spin_us, growing the spin\n"
+    "    when work arrives shortly after going idle and shrinking it when\n"
+    "    workers stay idle for longer than the spin would have covered.");
+
 IREE_FLAG(
     int32_t, task_worker_stack_size, 128 * 1024,
     "Minimum size in bytes of each worker thread stack.\n"
@@ -44,16 +61,58 @@ IREE_FLAG(
     "be configured to make at least that amount of local memory available.\n"
     "By default the CPU L2 cache size is used if such queries are supported.");
 
+IREE_FLAG(
+    string, task_worker_priority, "normal",
+    "Priority class of task system worker threads from [`lowest`, `low`,\n"
+    "`normal`, `high`, `highest`].");
+
+IREE_FLAG(
+    string, task_poller_affinity, "any",
+    "Logical processor ID the task system poller thread waiting on wait\n"
+    "handles is pinned to (optionally suffixed with `+smt` to reserve its SMT\n"
+    "sibling) or `any` to let the system place it. Pinning the poller to a\n"
+    "processor not running workers or other latency-sensitive threads avoids\n"
+    "it preempting them each time a wait completes.");
+
+IREE_FLAG(
+    string, task_poller_priority, "normal",
+    "Priority class of the task system poller thread from [`lowest`, `low`,\n"
+    "`normal`, `high`, `highest`].");
+
 iree_status_t iree_task_executor_options_initialize_from_flags(
     iree_task_executor_options_t* out_options) {
   IREE_ASSERT_ARGUMENT(out_options);
   iree_task_executor_options_initialize(out_options);
+  if (FLAG_task_dispatch_locality) {
+    out_options->scheduling_mode |= IREE_TASK_SCHEDULING_MODE_DISPATCH_LOCALITY;
+  }
   out_options->worker_spin_ns =
       (iree_duration_t)FLAG_task_worker_spin_us * 1000;
+  iree_string_view_t spin_mode =
+      iree_make_cstring_view(FLAG_task_worker_spin_mode);
+  if (iree_string_view_equal(spin_mode, IREE_SV("fixed"))) {
+    out_options->worker_spin_mode = IREE_TASK_WORKER_SPIN_MODE_FIXED;
+  } else if (iree_string_view_equal(spin_mode, IREE_SV("adaptive"))) {
+    out_options->worker_spin_mode = IREE_TASK_WORKER_SPIN_MODE_ADAPTIVE;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown --task_worker_spin_mode '%s'; expected "
+                            "'fixed' or 'adaptive'",
+                            FLAG_task_worker_spin_mode);
+  }
   out_options->worker_stack_size =
       (iree_host_size_t)FLAG_task_worker_stack_size;
   out_options->worker_local_memory_size =
       (iree_host_size_t)FLAG_task_worker_local_memory;
+  IREE_RETURN_IF_ERROR(iree_thread_priority_class_parse(
+      iree_make_cstring_view(FLAG_task_worker_priority),
+      &out_options->worker_priority_class));
+  IREE_RETURN_IF_ERROR(iree_thread_affinity_parse(
+      iree_make_cstring_view(FLAG_task_poller_affinity),
+      &out_options->poller_affinity));
+  IREE_RETURN_IF_ERROR(iree_thread_priority_class_parse(
+      iree_make_cstring_view(FLAG_task_poller_priority),
+      &out_options->poller_priority_class));
   return iree_ok_status();
 }
 
@@ -72,7 +131,16 @@ IREE_FLAG(
     " 'physical_cores':\n"
     "   Creates one executor per NUMA node in --task_topology_nodes= and one\n"
     "   group per physical core in each NUMA node up to the value specified\n"
-    "   by --task_topology_max_group_count=.");
+    "   by --task_topology_max_group_count=.\n"
+    " 'physical_cores_no_smt':\n"
+    "   Like 'physical_cores' but workers are pinned to a single logical\n"
+    "   processor of each core and SMT siblings are left unused.\n"
+    " 'l2_caches':\n"
+    "   Like 'physical_cores' but with one group per L2 cache such that each\n"
+    "   worker has an entire L2 cache to itself.\n"
+    " 'l3_caches':\n"
+    "   Like 'physical_cores' but with one group per L3 cache (CCX/cluster)\n"
+    "   such that each worker has an entire L3 cache to itself.");
 
 IREE_FLAG(
     int32_t, task_topology_group_count, 0,
@@ -189,15 +257,18 @@ iree_status_t iree_task_topology_initialize_from_flags(
     iree_task_topology_initialize_from_group_count(
         FLAG_task_topology_group_count, out_topology);
     return iree_ok_status();
-  } else if (strcmp(FLAG_task_topology_mode, "physical_cores") == 0) {
-    // Physical cores sourced from a specific NUMA node.
-    iree_task_topology_performance_level_t performance_level =
-        IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY;
-    IREE_RETURN_IF_ERROR(iree_task_topology_parse_performance_level(
-        FLAG_task_topology_performance_level, &performance_level));
-    return iree_task_topology_initialize_from_physical_cores(
-        node_id, performance_level, FLAG_task_topology_max_group_count,
-        out_topology);
+  }
+
+  iree_task_topology_distribution_t distribution =
+      IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE;
+  if (strcmp(FLAG_task_topology_mode, "physical_cores") == 0) {
+    distribution = IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE;
+  } else if (strcmp(FLAG_task_topology_mode, "physical_cores_no_smt") == 0) {
+    distribution = IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE_NO_SMT;
+  } else if (strcmp(FLAG_task_topology_mode, "l2_caches") == 0) {
+    distribution = IREE_TASK_TOPOLOGY_DISTRIBUTION_L2_CACHE;
+  } else if (strcmp(FLAG_task_topology_mode, "l3_caches") == 0) {
+    distribution = IREE_TASK_TOPOLOGY_DISTRIBUTION_L3_CACHE;
   } else {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
@@ -205,6 +276,15 @@ iree_status_t iree_task_topology_initialize_from_flags(
         "specified and be a valid value; have --task_topology_mode=%s.",
         FLAG_task_topology_mode);
   }
+
+  // Physical cores sourced from a specific NUMA node.
+  iree_task_topology_performance_level_t performance_level =
+      IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY;
+  IREE_RETURN_IF_ERROR(iree_task_topology_parse_performance_level(
+      FLAG_task_topology_performance_level, &performance_level));
+  return iree_task_topology_initialize_from_distribution(
+      node_id, performance_level, distribution,
+      FLAG_task_topology_max_group_count, out_topology);
 }
 
 //===----------------------------------------------------------------------===//
@@ -233,6 +313,13 @@ static void iree_task_flags_dump_task_topology(
     const iree_task_topology_group_t* group = &topology->groups[j];
     fprintf(stdout, "# group[%d]: '%s'\n", group->group_index, group->name);
     fprintf(stdout, "#      processor: %u\n", group->processor_index);
+    fprintf(stdout, "#      numa node: ");
+    if (group->node_id != IREE_TASK_TOPOLOGY_NODE_ID_ANY) {
+      fprintf(stdout, "%u", group->node_id);
+    } else {
+      fprintf(stdout, "(unspecified)");
+    }
+    fprintf(stdout, "\n");
     fprintf(stdout, "#       affinity: ");
     if (group->ideal_thread_affinity.specified) {
       fprintf(
@@ -243,21 +330,26 @@ static void iree_task_flags_dump_task_topology(
     }
     fprintf(stdout, "\n");
 
-    fprintf(stdout, "#  caches: l1d=%u, l2d=%u\n", group->caches.l1_data,
-            group->caches.l2_data);
+    fprintf(stdout, "#  caches: l1d=%u, l2d=%u, l3d=%u\n",
+            group->caches.l1_data, group->caches.l2_data,
+            group->caches.l3_data);
+    fprintf(stdout, "#  per-worker: l1d=%u, l2d=%u, l3d=%u\n",
+            group->worker_caches.l1_data, group->worker_caches.l2_data,
+            group->worker_caches.l3_data);
 
     fprintf(stdout, "#  last level cache sharing: ");
-    if (group->constructive_sharing_mask == 0) {
+    iree_host_size_t sharing_count =
+        iree_task_worker_set_count(&group->constructive_sharing_mask);
+    if (sharing_count == 0) {
       fprintf(stdout, "(none)\n");
-    } else if (group->constructive_sharing_mask ==
-               IREE_TASK_TOPOLOGY_GROUP_MASK_ALL) {
+    } else if (sharing_count == IREE_TASK_WORKER_SET_BIT_COUNT) {
       fprintf(stdout, "(all/undefined)\n");
     } else {
-      fprintf(stdout, "%d group(s): ",
-              iree_math_count_ones_u64(group->constructive_sharing_mask));
+      fprintf(stdout, "%" PRIhsz " group(s): ", sharing_count);
       for (iree_host_size_t ic = 0, jc = 0;
            ic < IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT; ++ic) {
-        if ((group->constructive_sharing_mask >> ic) & 1) {
+        if (iree_task_worker_set_contains(&group->constructive_sharing_mask,
+                                          ic)) {
           if (jc > 0) fprintf(stdout, ", ");
           fprintf(stdout, "%" PRIhsz, ic);
           ++jc;
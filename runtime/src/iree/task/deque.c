@@ -0,0 +1,201 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/task/deque.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define IREE_TASK_DEQUE_INDEX_MASK ((int64_t)IREE_TASK_DEQUE_CAPACITY - 1)
+
+void iree_task_deque_initialize(iree_task_deque_t* out_deque) {
+  memset(out_deque, 0, sizeof(*out_deque));
+  iree_atomic_store_int64(&out_deque->bottom, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int64(&out_deque->top, 0, iree_memory_order_relaxed);
+}
+
+void iree_task_deque_deinitialize(iree_task_deque_t* deque) {
+  iree_task_deque_discard(deque);
+}
+
+void iree_task_deque_discard(iree_task_deque_t* deque) {
+  // Move everything into a list so that we can reuse the fixed-point discard
+  // that also handles the dependents of each task.
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  iree_task_t* task = NULL;
+  while ((task = iree_task_deque_pop(deque)) != NULL) {
+    iree_task_list_push_back(&list, task);
+  }
+  iree_task_list_discard(&list);
+}
+
+bool iree_task_deque_is_empty(iree_task_deque_t* deque) {
+  return iree_task_deque_approximate_size(deque) == 0;
+}
+
+iree_host_size_t iree_task_deque_approximate_size(iree_task_deque_t* deque) {
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_acquire);
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_acquire);
+  return b > t ? (iree_host_size_t)(b - t) : 0;
+}
+
+// Returns the number of slots free for the owner to push into.
+// Thieves only ever increase top and as such this is a lower bound.
+static iree_host_size_t iree_task_deque_available_unsafe(
+    iree_task_deque_t* deque, int64_t b) {
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_acquire);
+  return IREE_TASK_DEQUE_CAPACITY - (iree_host_size_t)(b - t);
+}
+
+bool iree_task_deque_push(iree_task_deque_t* deque, iree_task_t* task) {
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_relaxed);
+  if (iree_task_deque_available_unsafe(deque, b) == 0) return false;
+  task->next_task = NULL;
+  iree_atomic_store_intptr(&deque->slots[b & IREE_TASK_DEQUE_INDEX_MASK],
+                           (intptr_t)task, iree_memory_order_relaxed);
+  // Publish the slot before thieves can observe the new bottom.
+  iree_atomic_thread_fence(iree_memory_order_release);
+  iree_atomic_store_int64(&deque->bottom, b + 1, iree_memory_order_relaxed);
+  return true;
+}
+
+void iree_task_deque_push_lifo_list(iree_task_deque_t* deque,
+                                    iree_task_list_t* list) {
+  if (iree_task_list_is_empty(list)) return;
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_relaxed);
+  const iree_host_size_t available = iree_task_deque_available_unsafe(deque, b);
+
+  // The list is newest-first; skip over the newest tasks that will not fit so
+  // that they remain in |list| and the oldest tasks end up in the deque.
+  const iree_host_size_t count = iree_task_list_calculate_size(list);
+  iree_task_t* remaining_tail = NULL;
+  iree_task_t* task = list->head;
+  for (iree_host_size_t i = available; i < count; ++i) {
+    remaining_tail = task;
+    task = task->next_task;
+  }
+  if (remaining_tail) {
+    remaining_tail->next_task = NULL;
+    list->tail = remaining_tail;
+  } else {
+    iree_task_list_initialize(list);
+  }
+
+  // Push newer to older so that the oldest task is at the bottom and popped
+  // first. All slots are published with a single fence and bottom update.
+  if (!task) return;
+  while (task) {
+    iree_task_t* next_task = task->next_task;
+    task->next_task = NULL;
+    iree_atomic_store_intptr(&deque->slots[b & IREE_TASK_DEQUE_INDEX_MASK],
+                             (intptr_t)task, iree_memory_order_relaxed);
+    ++b;
+    task = next_task;
+  }
+  iree_atomic_thread_fence(iree_memory_order_release);
+  iree_atomic_store_int64(&deque->bottom, b, iree_memory_order_relaxed);
+}
+
+iree_task_t* iree_task_deque_flush_from_lifo_slist(
+    iree_task_deque_t* deque, iree_atomic_task_slist_t* source_slist) {
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  if (iree_atomic_task_slist_flush(
+          source_slist, IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO,
+          &list.head, &list.tail)) {
+    iree_task_deque_push_lifo_list(deque, &list);
+
+    // Return anything that didn't fit to the mailbox; it'll be flushed again
+    // once the deque has drained.
+    if (!iree_task_list_is_empty(&list)) {
+      iree_atomic_task_slist_concat(source_slist, list.head, list.tail);
+    }
+  }
+  return iree_task_deque_pop(deque);
+}
+
+iree_task_t* iree_task_deque_pop(iree_task_deque_t* deque) {
+  // Reserve the bottom slot before checking for thieves racing us for it.
+  int64_t b =
+      iree_atomic_load_int64(&deque->bottom, iree_memory_order_relaxed) - 1;
+  iree_atomic_store_int64(&deque->bottom, b, iree_memory_order_relaxed);
+  iree_atomic_thread_fence(iree_memory_order_seq_cst);
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_relaxed);
+  if (t > b) {
+    // Empty; restore bottom.
+    iree_atomic_store_int64(&deque->bottom, b + 1, iree_memory_order_relaxed);
+    return NULL;
+  }
+
+  iree_task_t* task = (iree_task_t*)iree_atomic_load_intptr(
+      &deque->slots[b & IREE_TASK_DEQUE_INDEX_MASK], iree_memory_order_relaxed);
+  if (t == b) {
+    // Last task; race thieves for it by bumping top as they would.
+    if (!iree_atomic_compare_exchange_strong_int64(
+            &deque->top, &t, t + 1, iree_memory_order_seq_cst,
+            iree_memory_order_relaxed)) {
+      task = NULL;  // lost the race
+    }
+    iree_atomic_store_int64(&deque->bottom, b + 1, iree_memory_order_relaxed);
+  }
+  return task;
+}
+
+iree_task_t* iree_task_deque_steal(iree_task_deque_t* deque) {
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_acquire);
+  iree_atomic_thread_fence(iree_memory_order_seq_cst);
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_acquire);
+  if (t >= b) return NULL;  // empty
+  iree_task_t* task = (iree_task_t*)iree_atomic_load_intptr(
+      &deque->slots[t & IREE_TASK_DEQUE_INDEX_MASK], iree_memory_order_relaxed);
+  if (!iree_atomic_compare_exchange_strong_int64(&deque->top, &t, t + 1,
+                                                 iree_memory_order_seq_cst,
+                                                 iree_memory_order_relaxed)) {
+    return NULL;  // lost the race with the owner or another thief
+  }
+  return task;
+}
+
+iree_task_t* iree_task_deque_try_steal(iree_task_deque_t* source_deque,
+                                       iree_task_deque_t* target_deque,
+                                       iree_host_size_t max_tasks) {
+  // Take roughly half of the source tasks (but always at least one) so that
+  // over many thefts work evens out across workers. We may get fewer if the
+  // owner or other thieves race us.
+  iree_host_size_t source_size =
+      iree_task_deque_approximate_size(source_deque);
+  if (source_size == 0) return NULL;
+  iree_host_size_t steal_count = iree_min(max_tasks, (source_size + 1) / 2);
+
+  // Don't take more than we can fit; the first task is returned directly.
+  int64_t b =
+      iree_atomic_load_int64(&target_deque->bottom, iree_memory_order_relaxed);
+  steal_count = iree_min(
+      steal_count, iree_task_deque_available_unsafe(target_deque, b) + 1);
+
+  iree_task_t* next_task = iree_task_deque_steal(source_deque);
+  if (!next_task) return NULL;
+
+  // Move the remaining stolen tasks into the target deque and publish them all
+  // at once. Stealing is per-task as a bulk bump of top could race with the
+  // owner popping from the bottom without synchronizing.
+  int64_t new_b = b;
+  for (iree_host_size_t i = 1; i < steal_count; ++i) {
+    iree_task_t* task = iree_task_deque_steal(source_deque);
+    if (!task) break;
+    iree_atomic_store_intptr(
+        &target_deque->slots[new_b & IREE_TASK_DEQUE_INDEX_MASK],
+        (intptr_t)task, iree_memory_order_relaxed);
+    ++new_b;
+  }
+  if (new_b != b) {
+    iree_atomic_thread_fence(iree_memory_order_release);
+    iree_atomic_store_int64(&target_deque->bottom, new_b,
+                            iree_memory_order_relaxed);
+  }
+  return next_task;
+}
@@ -0,0 +1,151 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_TASK_DEQUE_H_
+#define IREE_TASK_DEQUE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/task/list.h"
+#include "iree/task/task.h"
+#include "iree/task/tuning.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+static_assert((IREE_TASK_DEQUE_CAPACITY & (IREE_TASK_DEQUE_CAPACITY - 1)) == 0,
+              "deque capacity must be a power of two");
+
+// A bounded lock-free work-stealing deque after Chase and Lev.
+// This is used by workers to maintain their thread-local working lists in
+// place of the mutex-guarded iree_task_queue_t. The owning worker pushes and
+// pops at the bottom without any read-modify-write atomics on the fast path and
+// thieves take from the top with a single compare-and-swap per task.
+//
+//  +--------+ <- slots[0]
+//  |  top   | <- stealers consume here: task = slots[top++]
+//  |        |
+//  |   ||   |
+//  |        |
+//  |   vv   |
+//  | bottom | <- owner pushes here:    slots[bottom++] = task
+//  |        |    owner consumes here:  task = slots[--bottom]
+//  |        |
+//  +--------+ <- slots[IREE_TASK_DEQUE_CAPACITY-1]
+//
+// The top and bottom indices are 64-bit and only ever increase (modulo the
+// owner transiently decrementing bottom during a pop) so they cannot wrap in
+// practice; the slot for an index is found by masking with the capacity.
+//
+// The owner consumes in LIFO order. To keep the FIFO-ish processing order the
+// mutex queue provided the batch push operations insert tasks such that the
+// oldest task of the batch is at the bottom and will be popped first while the
+// newest is closest to the top and will be the first taken by thieves.
+//
+// Unlike the linked-list queue the deque is bounded. Batch pushes that do not
+// fit leave the remaining tasks for the caller, which for workers means they
+// are returned to the worker mailbox and picked up on the next flush.
+//
+// The memory orderings follow "Correct and Efficient Work-Stealing for Weak
+// Memory Models": https://fzn.fr/readings/ppopp13.pdf
+typedef struct iree_task_deque_t {
+  // Index of the next slot the owner will push to. Only written by the owner.
+  iree_atomic_int64_t bottom;
+
+  // Keeps thieves bumping |top| from invalidating the owner's |bottom| line.
+  uint8_t _padding0[iree_hardware_destructive_interference_size -
+                    sizeof(iree_atomic_int64_t)];
+
+  // Index of the next slot thieves will steal from.
+  iree_atomic_int64_t top;
+
+  uint8_t _padding1[iree_hardware_destructive_interference_size -
+                    sizeof(iree_atomic_int64_t)];
+
+  // Ring of task pointers indexed by top/bottom masked to the capacity.
+  iree_atomic_intptr_t slots[IREE_TASK_DEQUE_CAPACITY];
+} iree_task_deque_t;
+
+// Initializes a work-stealing task deque in-place.
+void iree_task_deque_initialize(iree_task_deque_t* out_deque);
+
+// Deinitializes a task deque and discards any tasks remaining in it.
+// Must not be called while any other worker may be attempting to steal tasks.
+void iree_task_deque_deinitialize(iree_task_deque_t* deque);
+
+// Discards all tasks still in the deque and any that depend on them.
+//
+// Must only be called from the owning worker's thread.
+void iree_task_deque_discard(iree_task_deque_t* deque);
+
+// Returns true if the deque is empty.
+// Note that due to races this may return both false-positives and -negatives.
+bool iree_task_deque_is_empty(iree_task_deque_t* deque);
+
+// Returns the approximate number of tasks in the deque.
+// Note that due to races this may be stale as soon as it is returned.
+iree_host_size_t iree_task_deque_approximate_size(iree_task_deque_t* deque);
+
+// Pushes a task to the bottom of the deque such that it is the next popped.
+// Returns false if the deque is full and the task was not pushed.
+//
+// Must only be called from the owning worker's thread.
+bool iree_task_deque_push(iree_task_deque_t* deque, iree_task_t* task);
+
+// Pushes as many tasks from the LIFO |list| as fit in the deque such that the
+// oldest (tail) task is popped first. Tasks that did not fit are the newest
+// ones and are left in |list| in LIFO order.
+//
+// Must only be called from the owning worker's thread.
+void iree_task_deque_push_lifo_list(iree_task_deque_t* deque,
+                                    iree_task_list_t* list);
+
+// Flushes the |source_slist| LIFO mailbox into the deque. Any tasks that do not
+// fit are returned to |source_slist|. Returns the next task to process upon
+// success; the task may be pre-existing or from the newly flushed tasks.
+//
+// Must only be called from the owning worker's thread.
+iree_task_t* iree_task_deque_flush_from_lifo_slist(
+    iree_task_deque_t* deque, iree_atomic_task_slist_t* source_slist);
+
+// Pops a task from the bottom of the deque if any are available.
+//
+// Must only be called from the owning worker's thread.
+iree_task_t* iree_task_deque_pop(iree_task_deque_t* deque);
+
+// Tries to steal a single task from the top of the deque.
+// Returns NULL if the deque was empty or another thread won the race for the
+// task.
+//
+// May be called from any thread.
+iree_task_t* iree_task_deque_steal(iree_task_deque_t* deque);
+
+// Tries to steal up to |max_tasks| from the top of |source_deque|.
+//
+// On success, up to |max_tasks| (and at most roughly half) of the tasks that
+// were at the top of |source_deque| will be moved to |target_deque| and the
+// first of the stolen tasks is returned. No more tasks are stolen than fit in
+// |target_deque|.
+//
+// On failure, NULL is returned.
+//
+// This function is allowed to fail spuriously, i.e. even if there are
+// tasks to steal.
+//
+// Must only be called from the thread owning |target_deque|.
+iree_task_t* iree_task_deque_try_steal(iree_task_deque_t* source_deque,
+                                       iree_task_deque_t* target_deque,
+                                       iree_host_size_t max_tasks);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TASK_DEQUE_H_
@@ -0,0 +1,299 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Compares the lock-free iree_task_deque_t used by workers against the
+// mutex-guarded iree_task_queue_t it replaced. These are uncontended
+// single-threaded measurements of the owner fast paths and the theft path and
+// show the fixed overhead each operation adds to every task a worker runs.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/task/deque.h"
+#include "iree/task/list.h"
+#include "iree/task/queue.h"
+#include "iree/testing/benchmark.h"
+
+// Builds a LIFO list of |count| tasks from |tasks| as the mailbox would.
+static void iree_task_benchmark_make_lifo_list(iree_host_size_t count,
+                                               iree_task_t* tasks,
+                                               iree_task_list_t* out_list) {
+  iree_task_list_initialize(out_list);
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    iree_task_list_push_front(out_list, &tasks[i]);
+  }
+}
+
+static iree_task_t* iree_task_benchmark_allocate_tasks(
+    iree_allocator_t host_allocator, iree_host_size_t count) {
+  iree_task_t* tasks = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(host_allocator, sizeof(*tasks) * count,
+                                      (void**)&tasks));
+  memset(tasks, 0, sizeof(*tasks) * count);
+  return tasks;
+}
+
+//===----------------------------------------------------------------------===//
+// Owner push/pop
+//===----------------------------------------------------------------------===//
+
+// Pushes one task and pops it back off as a worker posting to itself would.
+static iree_status_t iree_task_queue_benchmark_push_pop_1(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_queue_t queue;
+  iree_task_queue_initialize(&queue);
+  iree_task_t task = {0};
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_queue_push_front(&queue, &task);
+    iree_task_queue_pop_front(&queue);
+  }
+  iree_task_queue_deinitialize(&queue);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_task_deque_benchmark_push_pop_1(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+  iree_task_t task = {0};
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_deque_push(&deque, &task);
+    iree_task_deque_pop(&deque);
+  }
+  iree_task_deque_deinitialize(&deque);
+  return iree_ok_status();
+}
+
+// Pushes a LIFO list of tasks and pops them all as a worker does after
+// receiving a batch.
+//
+// user_data is the number of tasks in each batch.
+static iree_status_t iree_task_queue_benchmark_push_pop_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_host_size_t count = (iree_host_size_t)benchmark_def->user_data;
+  iree_task_t* tasks =
+      iree_task_benchmark_allocate_tasks(host_allocator, count);
+  iree_task_queue_t queue;
+  iree_task_queue_initialize(&queue);
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/count)) {
+    iree_task_list_t list;
+    iree_task_benchmark_make_lifo_list(count, tasks, &list);
+    iree_task_queue_append_from_lifo_list_unsafe(&queue, &list);
+    while (iree_task_queue_pop_front(&queue)) {
+    }
+  }
+  iree_task_queue_deinitialize(&queue);
+  iree_allocator_free(host_allocator, tasks);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_task_deque_benchmark_push_pop_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_host_size_t count = (iree_host_size_t)benchmark_def->user_data;
+  iree_task_t* tasks =
+      iree_task_benchmark_allocate_tasks(host_allocator, count);
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/count)) {
+    iree_task_list_t list;
+    iree_task_benchmark_make_lifo_list(count, tasks, &list);
+    iree_task_deque_push_lifo_list(&deque, &list);
+    while (iree_task_deque_pop(&deque)) {
+    }
+  }
+  iree_task_deque_deinitialize(&deque);
+  iree_allocator_free(host_allocator, tasks);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Mailbox flush
+//===----------------------------------------------------------------------===//
+
+// Posts tasks to a mailbox slist and then flushes and drains them.
+//
+// user_data is the number of tasks posted before each flush.
+static iree_status_t iree_task_queue_benchmark_flush_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_host_size_t count = (iree_host_size_t)benchmark_def->user_data;
+  iree_task_t* tasks =
+      iree_task_benchmark_allocate_tasks(host_allocator, count);
+  iree_atomic_task_slist_t slist;
+  iree_atomic_task_slist_initialize(&slist);
+  iree_task_queue_t queue;
+  iree_task_queue_initialize(&queue);
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/count)) {
+    iree_task_list_t list;
+    iree_task_benchmark_make_lifo_list(count, tasks, &list);
+    iree_atomic_task_slist_concat(&slist, list.head, list.tail);
+    iree_task_t* task = iree_task_queue_flush_from_lifo_slist(&queue, &slist);
+    while (task) task = iree_task_queue_pop_front(&queue);
+  }
+  iree_task_queue_deinitialize(&queue);
+  iree_atomic_task_slist_deinitialize(&slist);
+  iree_allocator_free(host_allocator, tasks);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_task_deque_benchmark_flush_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_host_size_t count = (iree_host_size_t)benchmark_def->user_data;
+  iree_task_t* tasks =
+      iree_task_benchmark_allocate_tasks(host_allocator, count);
+  iree_atomic_task_slist_t slist;
+  iree_atomic_task_slist_initialize(&slist);
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/count)) {
+    iree_task_list_t list;
+    iree_task_benchmark_make_lifo_list(count, tasks, &list);
+    iree_atomic_task_slist_concat(&slist, list.head, list.tail);
+    // Batches larger than the deque capacity round-trip through the mailbox.
+    iree_task_t* task = iree_task_deque_flush_from_lifo_slist(&deque, &slist);
+    while (task) {
+      task = iree_task_deque_pop(&deque);
+      if (!task) task = iree_task_deque_flush_from_lifo_slist(&deque, &slist);
+    }
+  }
+  iree_task_deque_deinitialize(&deque);
+  iree_atomic_task_slist_deinitialize(&slist);
+  iree_allocator_free(host_allocator, tasks);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Theft
+//===----------------------------------------------------------------------===//
+
+// Fills a victim with tasks and has a thief repeatedly steal from it until it
+// is empty. Each theft moves up to IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT
+// tasks as the executor does.
+//
+// user_data is the number of tasks in the victim.
+static iree_status_t iree_task_queue_benchmark_steal_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_host_size_t count = (iree_host_size_t)benchmark_def->user_data;
+  iree_task_t* tasks =
+      iree_task_benchmark_allocate_tasks(host_allocator, count);
+  iree_task_queue_t victim_queue;
+  iree_task_queue_initialize(&victim_queue);
+  iree_task_queue_t thief_queue;
+  iree_task_queue_initialize(&thief_queue);
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/count)) {
+    iree_task_list_t list;
+    iree_task_benchmark_make_lifo_list(count, tasks, &list);
+    iree_task_queue_append_from_lifo_list_unsafe(&victim_queue, &list);
+    while (iree_task_queue_try_steal(&victim_queue, &thief_queue,
+                                     IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT)) {
+      while (iree_task_queue_pop_front(&thief_queue)) {
+      }
+    }
+  }
+  iree_task_queue_deinitialize(&thief_queue);
+  iree_task_queue_deinitialize(&victim_queue);
+  iree_allocator_free(host_allocator, tasks);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_task_deque_benchmark_steal_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  iree_host_size_t count = (iree_host_size_t)benchmark_def->user_data;
+  iree_task_t* tasks =
+      iree_task_benchmark_allocate_tasks(host_allocator, count);
+  iree_task_deque_t victim_deque;
+  iree_task_deque_initialize(&victim_deque);
+  iree_task_deque_t thief_deque;
+  iree_task_deque_initialize(&thief_deque);
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/count)) {
+    iree_task_list_t list;
+    iree_task_benchmark_make_lifo_list(count, tasks, &list);
+    iree_task_deque_push_lifo_list(&victim_deque, &list);
+    while (iree_task_deque_try_steal(&victim_deque, &thief_deque,
+                                     IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT)) {
+      while (iree_task_deque_pop(&thief_deque)) {
+      }
+    }
+  }
+  iree_task_deque_deinitialize(&thief_deque);
+  iree_task_deque_deinitialize(&victim_deque);
+  iree_allocator_free(host_allocator, tasks);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Registration
+//===----------------------------------------------------------------------===//
+
+static void iree_task_benchmark_register_n(const char* name,
+                                           iree_benchmark_fn_t run) {
+  static const iree_host_size_t counts[] = {1, 8, 64, 256};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(counts); ++i) {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = run,
+    };
+    benchmark_def.user_data = (void*)counts[i];
+    char full_name[64];
+    snprintf(full_name, sizeof(full_name), "%s_%" PRIhsz, name, counts[i]);
+    iree_benchmark_register(iree_make_cstring_view(full_name), &benchmark_def);
+  }
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_task_queue_benchmark_push_pop_1,
+    };
+    iree_benchmark_register(iree_make_cstring_view("queue_push_pop"),
+                            &benchmark_def);
+    benchmark_def.run = iree_task_deque_benchmark_push_pop_1;
+    iree_benchmark_register(iree_make_cstring_view("deque_push_pop"),
+                            &benchmark_def);
+  }
+
+  iree_task_benchmark_register_n("queue_push_pop",
+                                 iree_task_queue_benchmark_push_pop_n);
+  iree_task_benchmark_register_n("deque_push_pop",
+                                 iree_task_deque_benchmark_push_pop_n);
+  iree_task_benchmark_register_n("queue_flush",
+                                 iree_task_queue_benchmark_flush_n);
+  iree_task_benchmark_register_n("deque_flush",
+                                 iree_task_deque_benchmark_flush_n);
+  iree_task_benchmark_register_n("queue_steal",
+                                 iree_task_queue_benchmark_steal_n);
+  iree_task_benchmark_register_n("deque_steal",
+                                 iree_task_deque_benchmark_steal_n);
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -0,0 +1,318 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/task/deque.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+
+namespace {
+
+TEST(DequeTest, Lifetime) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, Empty) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+  EXPECT_EQ(0, iree_task_deque_approximate_size(&deque));
+  EXPECT_FALSE(iree_task_deque_pop(&deque));
+  EXPECT_FALSE(iree_task_deque_steal(&deque));
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, PushPop) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  iree_task_t task_a = {0};
+  EXPECT_TRUE(iree_task_deque_push(&deque, &task_a));
+  EXPECT_FALSE(iree_task_deque_is_empty(&deque));
+  iree_task_t task_b = {0};
+  EXPECT_TRUE(iree_task_deque_push(&deque, &task_b));
+  EXPECT_EQ(2, iree_task_deque_approximate_size(&deque));
+
+  // Owner pops LIFO.
+  EXPECT_EQ(&task_b, iree_task_deque_pop(&deque));
+  EXPECT_EQ(&task_a, iree_task_deque_pop(&deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+  EXPECT_FALSE(iree_task_deque_pop(&deque));
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, PushSteal) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  iree_task_t task_a = {0};
+  EXPECT_TRUE(iree_task_deque_push(&deque, &task_a));
+  iree_task_t task_b = {0};
+  EXPECT_TRUE(iree_task_deque_push(&deque, &task_b));
+
+  // Thieves steal FIFO.
+  EXPECT_EQ(&task_a, iree_task_deque_steal(&deque));
+  EXPECT_EQ(&task_b, iree_task_deque_steal(&deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+  EXPECT_FALSE(iree_task_deque_steal(&deque));
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, PushFull) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  std::vector<iree_task_t> tasks(IREE_TASK_DEQUE_CAPACITY + 1);
+  for (int i = 0; i < IREE_TASK_DEQUE_CAPACITY; ++i) {
+    EXPECT_TRUE(iree_task_deque_push(&deque, &tasks[i]));
+  }
+  EXPECT_FALSE(iree_task_deque_push(&deque, &tasks.back()));
+
+  // Making room by stealing allows pushing again and wraps the ring.
+  EXPECT_EQ(&tasks[0], iree_task_deque_steal(&deque));
+  EXPECT_TRUE(iree_task_deque_push(&deque, &tasks.back()));
+  EXPECT_EQ(&tasks.back(), iree_task_deque_pop(&deque));
+  for (int i = IREE_TASK_DEQUE_CAPACITY - 1; i >= 1; --i) {
+    EXPECT_EQ(&tasks[i], iree_task_deque_pop(&deque));
+  }
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, PushLifoListOrdered) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  // Lists are LIFO such that the head is the newest task.
+  iree_task_list_t list = {0};
+  iree_task_t task_a = {0};
+  iree_task_list_push_front(&list, &task_a);
+  iree_task_t task_b = {0};
+  iree_task_list_push_front(&list, &task_b);
+  iree_task_t task_c = {0};
+  iree_task_list_push_front(&list, &task_c);
+
+  iree_task_deque_push_lifo_list(&deque, &list);
+  EXPECT_TRUE(iree_task_list_is_empty(&list));
+
+  // The oldest task is popped first and the newest is stolen first.
+  EXPECT_EQ(&task_a, iree_task_deque_pop(&deque));
+  EXPECT_EQ(&task_c, iree_task_deque_steal(&deque));
+  EXPECT_EQ(&task_b, iree_task_deque_pop(&deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, PushLifoListOverflow) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  const int kOverflowCount = 3;
+  std::vector<iree_task_t> tasks(IREE_TASK_DEQUE_CAPACITY + kOverflowCount);
+  iree_task_list_t list = {0};
+  for (auto& task : tasks) iree_task_list_push_front(&list, &task);
+
+  // The oldest tasks are pushed and the newest remain in the list.
+  iree_task_deque_push_lifo_list(&deque, &list);
+  EXPECT_EQ(IREE_TASK_DEQUE_CAPACITY,
+            iree_task_deque_approximate_size(&deque));
+  EXPECT_EQ(kOverflowCount, iree_task_list_calculate_size(&list));
+  EXPECT_EQ(&tasks.back(), iree_task_list_front(&list));
+  EXPECT_EQ(&tasks[IREE_TASK_DEQUE_CAPACITY], iree_task_list_back(&list));
+  EXPECT_EQ(&tasks[0], iree_task_deque_pop(&deque));
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, FlushSlistEmpty) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  iree_atomic_task_slist_t slist;
+  iree_atomic_task_slist_initialize(&slist);
+
+  EXPECT_FALSE(iree_task_deque_flush_from_lifo_slist(&deque, &slist));
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+
+  iree_atomic_task_slist_deinitialize(&slist);
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, FlushSlistOrdered) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  iree_atomic_task_slist_t slist;
+  iree_atomic_task_slist_initialize(&slist);
+  iree_task_t task_a = {0};
+  iree_atomic_task_slist_push(&slist, &task_a);
+  iree_task_t task_b = {0};
+  iree_atomic_task_slist_push(&slist, &task_b);
+  iree_task_t task_c = {0};
+  iree_atomic_task_slist_push(&slist, &task_c);
+
+  // Tasks are processed in the order they were posted.
+  EXPECT_EQ(&task_a, iree_task_deque_flush_from_lifo_slist(&deque, &slist));
+  EXPECT_EQ(&task_b, iree_task_deque_pop(&deque));
+  EXPECT_EQ(&task_c, iree_task_deque_pop(&deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+
+  iree_atomic_task_slist_deinitialize(&slist);
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, FlushSlistOverflow) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  iree_atomic_task_slist_t slist;
+  iree_atomic_task_slist_initialize(&slist);
+  std::vector<iree_task_t> tasks(IREE_TASK_DEQUE_CAPACITY + 1);
+  for (auto& task : tasks) iree_atomic_task_slist_push(&slist, &task);
+
+  // Tasks that don't fit are returned to the slist for the next flush.
+  EXPECT_EQ(&tasks[0], iree_task_deque_flush_from_lifo_slist(&deque, &slist));
+  EXPECT_EQ(&tasks.back(), iree_atomic_task_slist_pop(&slist));
+  EXPECT_FALSE(iree_atomic_task_slist_pop(&slist));
+
+  iree_atomic_task_slist_deinitialize(&slist);
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, TryStealEmpty) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  EXPECT_FALSE(iree_task_deque_try_steal(&source_deque, &target_deque,
+                                         /*max_tasks=*/1));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+TEST(DequeTest, TryStealLast) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  iree_task_t task_a = {0};
+  iree_task_deque_push(&source_deque, &task_a);
+  EXPECT_EQ(&task_a, iree_task_deque_try_steal(&source_deque, &target_deque,
+                                               /*max_tasks=*/100));
+  EXPECT_TRUE(iree_task_deque_is_empty(&source_deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&target_deque));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+TEST(DequeTest, TryStealHalf) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  iree_task_t tasks[8] = {{0}};
+  for (auto& task : tasks) iree_task_deque_push(&source_deque, &task);
+
+  // Roughly half of the tasks are taken from the top; the first is returned.
+  EXPECT_EQ(&tasks[0], iree_task_deque_try_steal(&source_deque, &target_deque,
+                                                 /*max_tasks=*/100));
+  EXPECT_EQ(4, iree_task_deque_approximate_size(&source_deque));
+  EXPECT_EQ(3, iree_task_deque_approximate_size(&target_deque));
+  EXPECT_EQ(&tasks[3], iree_task_deque_pop(&target_deque));
+  EXPECT_EQ(&tasks[7], iree_task_deque_pop(&source_deque));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+TEST(DequeTest, TryStealMax) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  iree_task_t tasks[8] = {{0}};
+  for (auto& task : tasks) iree_task_deque_push(&source_deque, &task);
+
+  EXPECT_EQ(&tasks[0], iree_task_deque_try_steal(&source_deque, &target_deque,
+                                                 /*max_tasks=*/2));
+  EXPECT_EQ(6, iree_task_deque_approximate_size(&source_deque));
+  EXPECT_EQ(&tasks[1], iree_task_deque_pop(&target_deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&target_deque));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+// Races an owner pushing and popping against several thieves and verifies that
+// every task is consumed exactly once.
+TEST(DequeTest, ConcurrentSteal) {
+  static const int kTaskCount = 100000;
+  static const int kThiefCount = 3;
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+  std::vector<iree_task_t> tasks(kTaskCount);
+  std::vector<std::atomic<int>> consumed(kTaskCount);
+  std::atomic<int> consumed_count(0);
+  auto consume = [&](iree_task_t* task) {
+    ++consumed[task - tasks.data()];
+    ++consumed_count;
+  };
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < kThiefCount; ++i) {
+    thieves.emplace_back([&]() {
+      while (consumed_count.load() < kTaskCount) {
+        iree_task_t* task = iree_task_deque_steal(&deque);
+        if (task) {
+          consume(task);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // Push in bursts and pop some of them back to exercise the owner's race on
+  // the last task.
+  for (int i = 0; i < kTaskCount;) {
+    for (int j = 0; j < 8 && i < kTaskCount; ++j, ++i) {
+      while (!iree_task_deque_push(&deque, &tasks[i])) {
+        iree_task_t* task = iree_task_deque_pop(&deque);
+        if (task) consume(task);
+      }
+    }
+    for (int j = 0; j < 7; ++j) {
+      iree_task_t* task = iree_task_deque_pop(&deque);
+      if (!task) break;
+      consume(task);
+    }
+  }
+  while (iree_task_t* task = iree_task_deque_pop(&deque)) consume(task);
+
+  for (auto& thief : thieves) thief.join();
+  for (int i = 0; i < kTaskCount; ++i) {
+    EXPECT_EQ(1, consumed[i].load()) << "task " << i;
+  }
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+}  // namespace
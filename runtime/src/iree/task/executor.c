@@ -13,11 +13,11 @@
 #include "iree/base/internal/debugging.h"
 #include "iree/base/internal/math.h"
 #include "iree/task/affinity_set.h"
+#include "iree/task/deque.h"
 #include "iree/task/executor_impl.h"
 #include "iree/task/list.h"
 #include "iree/task/pool.h"
 #include "iree/task/post_batch.h"
-#include "iree/task/queue.h"
 #include "iree/task/task_impl.h"
 #include "iree/task/tuning.h"
 #include "iree/task/worker.h"
@@ -71,6 +71,8 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   IREE_ASSERT_ARGUMENT(out_executor);
   *out_executor = NULL;
 
+  iree_task_register_metrics();
+
   // The executor is followed in memory by worker[] + worker_local_memory[].
   iree_host_size_t total_worker_local_memory_size = 0;
   for (iree_host_size_t i = 0; i < worker_count; ++i) {
@@ -97,7 +99,12 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   executor->allocator = allocator;
   executor->scheduling_mode = options.scheduling_mode;
   executor->worker_spin_ns = options.worker_spin_ns;
-  iree_atomic_task_slist_initialize(&executor->incoming_ready_slist);
+  executor->worker_spin_mode = options.worker_spin_mode;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(executor->submission_shards);
+       ++i) {
+    iree_atomic_task_slist_initialize(
+        &executor->submission_shards[i].ready_slist);
+  }
   iree_slim_mutex_initialize(&executor->coordinator_mutex);
 
   IREE_TRACE({
@@ -115,6 +122,24 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
                              IREE_TRACING_PLOT_TYPE_PERCENTAGE, /*step=*/true,
                              /*fill=*/true, /*color=*/0xFF1F883Du);
     IREE_TRACE_PLOT_VALUE_F32(executor->trace_name, 0.0f);
+
+    // Idle wait counters share the executor name with a suffix.
+    IREE_LEAK_CHECK_DISABLE_PUSH();
+    char* spin_trace_name = malloc(trace_name_length + sizeof("-spins"));
+    snprintf(spin_trace_name, trace_name_length + sizeof("-spins"), "%s-spins",
+             trace_name);
+    char* park_trace_name = malloc(trace_name_length + sizeof("-parks"));
+    snprintf(park_trace_name, trace_name_length + sizeof("-parks"), "%s-parks",
+             trace_name);
+    IREE_LEAK_CHECK_DISABLE_POP();
+    executor->spin_trace_name = spin_trace_name;
+    executor->park_trace_name = park_trace_name;
+    IREE_TRACE_SET_PLOT_TYPE(executor->spin_trace_name,
+                             IREE_TRACING_PLOT_TYPE_NUMBER, /*step=*/true,
+                             /*fill=*/false, /*color=*/0);
+    IREE_TRACE_SET_PLOT_TYPE(executor->park_trace_name,
+                             IREE_TRACING_PLOT_TYPE_NUMBER, /*step=*/true,
+                             /*fill=*/false, /*color=*/0);
   });
 
   // Simple PRNG used to generate seeds for the per-worker PRNGs used to
@@ -153,26 +178,26 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   // Wait handling polling and waiting use a dedicated thread to ensure that
   // blocking syscalls stay off the workers.
   if (iree_status_is_ok(status)) {
-    // For now we allow the poller to run anywhere - we should allow callers to
-    // specify it via the topology (or something).
-    iree_thread_affinity_t poller_thread_affinity;
-    iree_thread_affinity_set_any(&poller_thread_affinity);
-    status = iree_task_poller_initialize(executor, poller_thread_affinity,
+    status = iree_task_poller_initialize(executor, options.poller_affinity,
+                                         options.poller_priority_class,
                                          &executor->poller);
   }
 
   // Bring up the workers; the threads will be created here but be suspended
   // (if the platform supports it) awaiting the first tasks getting scheduled.
   if (iree_status_is_ok(status)) {
+    executor->node_id = iree_task_topology_node_id(topology);
     executor->worker_base_index = options.worker_base_index;
     executor->worker_count = worker_count;
+    executor->affinity_shift =
+        iree_task_affinity_shift_for_worker_count(worker_count);
     executor->workers =
         (iree_task_worker_t*)((uint8_t*)executor + executor_base_size);
     uint8_t* worker_local_memory =
         (uint8_t*)executor->workers + worker_list_size;
 
-    iree_task_affinity_set_t worker_mask =
-        iree_task_affinity_set_ones(worker_count);
+    iree_task_worker_set_t worker_mask;
+    iree_task_worker_set_fill(&worker_mask, worker_count);
 
     for (iree_host_size_t i = 0; i < worker_count; ++i) {
       const iree_task_topology_group_t* group =
@@ -180,18 +205,29 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
       iree_host_size_t worker_local_memory_size =
           iree_task_topology_group_local_memory_size(options, group);
       iree_task_worker_t* worker = &executor->workers[i];
+
+      // Migrate the worker local memory to the node the worker runs on. The
+      // memory was zeroed by this thread and may have landed on another node.
+      // This is only a hint and we ignore failures (no NUMA support, etc).
+      if (group->node_id != IREE_TASK_TOPOLOGY_NODE_ID_ANY) {
+        iree_status_ignore(iree_allocator_bind(
+            allocator, worker_local_memory, worker_local_memory_size,
+            group->node_id, IREE_ALLOCATOR_BIND_FLAG_MOVE));
+      }
+
       status = iree_task_worker_initialize(
           executor, i, group, options.worker_stack_size,
+          options.worker_priority_class,
           iree_make_byte_span(worker_local_memory, worker_local_memory_size),
           &seed_prng, worker);
       worker_local_memory += worker_local_memory_size;
       if (!iree_status_is_ok(status)) break;
     }
 
-    iree_atomic_task_affinity_set_store(&executor->worker_idle_mask,
-                                        worker_mask, iree_memory_order_release);
-    iree_atomic_task_affinity_set_store(&executor->worker_live_mask,
-                                        worker_mask, iree_memory_order_release);
+    iree_atomic_task_worker_set_store(&executor->worker_idle_mask, &worker_mask,
+                                      iree_memory_order_release);
+    iree_atomic_task_worker_set_store(&executor->worker_live_mask, &worker_mask,
+                                      iree_memory_order_release);
   }
 
   if (!iree_status_is_ok(status)) {
@@ -242,7 +278,11 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor) {
 
   iree_event_pool_free(executor->event_pool);
   iree_slim_mutex_deinitialize(&executor->coordinator_mutex);
-  iree_atomic_task_slist_deinitialize(&executor->incoming_ready_slist);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(executor->submission_shards);
+       ++i) {
+    iree_atomic_task_slist_deinitialize(
+        &executor->submission_shards[i].ready_slist);
+  }
   iree_task_pool_deinitialize(&executor->transient_task_pool);
   iree_allocator_free(executor->allocator, executor);
 
@@ -275,6 +315,11 @@ iree_host_size_t iree_task_executor_worker_count(
   return executor->worker_count;
 }
 
+iree_task_topology_node_id_t iree_task_executor_node_id(
+    iree_task_executor_t* executor) {
+  return executor->node_id;
+}
+
 iree_event_pool_t* iree_task_executor_event_pool(
     iree_task_executor_t* executor) {
   return executor->event_pool;
@@ -390,15 +435,36 @@ void iree_task_executor_schedule_ready_tasks(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns the incoming submission shard used by the calling thread.
+// There's no portable thread-local storage we can rely on here so threads are
+// told apart by their stack addresses: concurrently running threads have
+// disjoint stacks and a Fibonacci hash of the page spreads the evenly spaced
+// stacks of thread pools across the shards. A thread may land on a different
+// shard if its stack depth differs between calls but as ready tasks have no
+// ordering relative to each other that only costs a bit of locality.
+static iree_task_executor_submission_shard_t*
+iree_task_executor_select_submission_shard(iree_task_executor_t* executor) {
+  const uintptr_t stack_marker = (uintptr_t)&executor;
+  const uint64_t hash = (uint64_t)(stack_marker >> 12) * 0x9E3779B97F4A7C15ull;
+  const iree_host_size_t shard_index =
+      (iree_host_size_t)(hash >> 32) &
+      (IREE_TASK_EXECUTOR_SUBMISSION_SHARD_COUNT - 1);
+  return &executor->submission_shards[shard_index];
+}
+
 void iree_task_executor_merge_submission(iree_task_executor_t* executor,
                                          iree_task_submission_t* submission) {
   // Concatenate all of the incoming tasks into the submission list.
   // Note that the submission stores tasks in LIFO order such that when they are
   // put into the LIFO atomic slist they match the order across all concats
   // (earlier concats are later in the LIFO list).
-  iree_atomic_task_slist_concat(&executor->incoming_ready_slist,
-                                submission->ready_list.head,
-                                submission->ready_list.tail);
+  if (!iree_task_list_is_empty(&submission->ready_list)) {
+    iree_task_executor_submission_shard_t* shard =
+        iree_task_executor_select_submission_shard(executor);
+    iree_atomic_task_slist_concat(&shard->ready_slist,
+                                  submission->ready_list.head,
+                                  submission->ready_list.tail);
+  }
 
   // Enqueue waiting tasks with the poller immediately: this may issue a
   // syscall to kick the poller. If we see bad context switches here then we
@@ -432,14 +498,35 @@ void iree_task_executor_flush(iree_task_executor_t* executor) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Flushes all incoming submission shards into |out_submission|.
+//
+// Only called during coordination and expects the coordinator lock to be held.
+static void iree_task_executor_flush_submission_shards(
+    iree_task_executor_t* executor, iree_task_submission_t* out_submission) {
+  iree_task_submission_initialize(out_submission);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(executor->submission_shards);
+       ++i) {
+    iree_task_list_t shard_list;
+    iree_task_list_initialize(&shard_list);
+    if (iree_atomic_task_slist_flush(
+            &executor->submission_shards[i].ready_slist,
+            IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO, &shard_list.head,
+            &shard_list.tail)) {
+      iree_task_list_append(&out_submission->ready_list, &shard_list);
+    }
+  }
+}
+
 // Dispatches tasks in the global submission queue to workers.
 // This is called by users upon submission of new tasks or by workers when they
 // run out of tasks to process. If |current_worker| is provided then tasks will
 // prefer to be routed back to it for immediate processing.
 //
-// If a coordination run ends up with no ready tasks and |current_worker| is
-// provided the calling thread will enter a wait until the worker has more tasks
-// posted to it.
+// Only one thread coordinates at a time. If another thread is already
+// coordinating we request that it run again once it is done and return
+// immediately instead of waiting on it: the coordinator will pick up anything
+// submitted before the request. This keeps submitters from serializing on the
+// coordinator lock when many of them flush at the same time.
 void iree_task_executor_coordinate(iree_task_executor_t* executor,
                                    iree_task_worker_t* current_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -450,10 +537,21 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
   bool schedule_dirty = true;
   do {
     IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_task_executor_coordinate_try");
-    // TODO(#10212): remove this lock or do something more clever to avoid
-    // contention when many workers try to coordinate at the same time. This can
-    // create very long serialized lock chains that slow down worker wakes.
-    iree_slim_mutex_lock(&executor->coordinator_mutex);
+
+    // Request coordination before trying to become the coordinator. The fence
+    // pairs with the one the coordinator issues after unlocking: either we
+    // acquire the lock or the coordinator is guaranteed to observe the request.
+    // The release publishes our submission to whoever consumes the request.
+    iree_atomic_store_int32(&executor->coordination_requested, 1,
+                            iree_memory_order_release);
+    iree_atomic_thread_fence(iree_memory_order_seq_cst);
+    if (!iree_slim_mutex_try_lock(&executor->coordinator_mutex)) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z1, "deferred");
+      IREE_TRACE_ZONE_END(z1);
+      break;
+    }
+    iree_atomic_exchange_int32(&executor->coordination_requested, 0,
+                               iree_memory_order_acquire);
 
     // Check for incoming submissions and move their posted tasks into our
     // local lists. Any of the tasks here are ready to execute immediately and
@@ -472,90 +570,102 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     // various places and have no relation - hopefully leading to better average
     // latency.
     iree_task_submission_t pending_submission;
-    iree_task_submission_initialize_from_lifo_slist(
-        &executor->incoming_ready_slist, &pending_submission);
+    iree_task_executor_flush_submission_shards(executor, &pending_submission);
     if (iree_task_list_is_empty(&pending_submission.ready_list)) {
       iree_slim_mutex_unlock(&executor->coordinator_mutex);
-      IREE_TRACE_ZONE_END(z1);
-      break;
+      schedule_dirty = false;
+    } else {
+      // Scratch coordinator submission batch used during scheduling to batch
+      // up all tasks that will be posted to each worker. We could stash this
+      // on the executor but given that which thread is playing the role of the
+      // coordinator is random it's better to ensure that these bytes never
+      // incur a cache miss by making them live here in the stack of the chosen
+      // thread.
+      iree_task_post_batch_t* post_batch =
+          iree_alloca(iree_task_post_batch_size(executor->worker_count));
+      iree_task_post_batch_initialize(executor, current_worker, post_batch);
+
+      // Schedule all ready tasks in this batch. Some may complete inline (such
+      // as ready barriers with all their dependencies resolved) while others
+      // may be scheduled on workers via the post batch.
+      iree_task_executor_schedule_ready_tasks(executor, &pending_submission,
+                                              post_batch);
+
+      // Route waiting tasks to the poller.
+      iree_task_poller_enqueue(&executor->poller,
+                               &pending_submission.waiting_list);
+
+      iree_slim_mutex_unlock(&executor->coordinator_mutex);
+
+      // Post all new work to workers; they may wake and begin executing
+      // immediately. Returns whether this worker has new tasks for it to work
+      // on.
+      schedule_dirty = iree_task_post_batch_submit(post_batch);
     }
 
-    // Scratch coordinator submission batch used during scheduling to batch up
-    // all tasks that will be posted to each worker. We could stash this on the
-    // executor but given that which thread is playing the role of the
-    // coordinator is random it's better to ensure that these bytes never incur
-    // a cache miss by making them live here in the stack of the chosen thread.
-    iree_task_post_batch_t* post_batch =
-        iree_alloca(sizeof(iree_task_post_batch_t) +
-                    executor->worker_count * sizeof(iree_task_list_t));
-    iree_task_post_batch_initialize(executor, current_worker, post_batch);
-
-    // Schedule all ready tasks in this batch. Some may complete inline (such
-    // as ready barriers with all their dependencies resolved) while others may
-    // be scheduled on workers via the post batch.
-    iree_task_executor_schedule_ready_tasks(executor, &pending_submission,
-                                            post_batch);
-
-    // Route waiting tasks to the poller.
-    iree_task_poller_enqueue(&executor->poller,
-                             &pending_submission.waiting_list);
-
-    iree_slim_mutex_unlock(&executor->coordinator_mutex);
-    IREE_TRACE_ZONE_END(z1);
+    // Run again if any other thread requested coordination while we were
+    // holding the lock as it will have returned expecting us to handle it.
+    iree_atomic_thread_fence(iree_memory_order_seq_cst);
+    if (iree_atomic_load_int32(&executor->coordination_requested,
+                               iree_memory_order_relaxed)) {
+      schedule_dirty = true;
+    }
 
-    // Post all new work to workers; they may wake and begin executing
-    // immediately. Returns whether this worker has new tasks for it to work on.
-    schedule_dirty = iree_task_post_batch_submit(post_batch);
+    IREE_TRACE_ZONE_END(z1);
   } while (schedule_dirty);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
-static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
-    iree_task_executor_t* executor, iree_task_affinity_set_t victim_mask,
-    uint32_t max_theft_attempts, int rotation_offset,
-    iree_task_queue_t* local_task_queue) {
-  if (!victim_mask) return NULL;
-  max_theft_attempts = iree_min(max_theft_attempts,
-                                iree_task_affinity_set_count_ones(victim_mask));
-  victim_mask = iree_task_affinity_set_rotr(victim_mask, rotation_offset);
-
-  int worker_index = rotation_offset;
-  iree_task_affinity_set_t mask =
-      iree_task_affinity_set_rotr(victim_mask, worker_index);
-  for (uint32_t i = 0; i < max_theft_attempts; ++i) {
-    // Find the last set bit and skip to it. This avoids the need for doing
-    // a full O(n) scan and instead gets us at O(popcnt) * O(ctz).
-    //
-    // Example: sharing mask = 0b01010101
-    //          mask_rotation = 3 (randomly selected)
-    //          mask = 0b01010101 rotr 3 = 0b10101010
-    //          for (i = 0; i < 4; ++i)
-    //            offset = ctz(0b10101010) = 1
-    //            mask_rotation += 1 = 4
-    //            mask >>= 1 = 0b01010101
-    //            victim_index = 4 % 64 = 4
-    int offset = iree_task_affinity_set_count_trailing_zeros(mask);
-    int victim_index = (worker_index + offset) % executor->worker_count;
-    worker_index += offset + 1;
-    mask = iree_shr(mask, offset + 1);
-    iree_task_worker_t* victim_worker = &executor->workers[victim_index];
-    if (iree_atomic_load_int32(&victim_worker->state,
-                               iree_memory_order_acquire) !=
-        IREE_TASK_WORKER_STATE_RUNNING) {
-      return NULL;
+// Tries to steal from the workers in |victim_mask| starting at the worker
+// |start_index| and wrapping around. Only workers with bits set are visited
+// such that the cost is O(words) + O(popcnt) instead of O(worker_count).
+static iree_task_t* iree_task_executor_try_steal_task_from_worker_set(
+    iree_task_executor_t* executor, const iree_task_worker_set_t* victim_mask,
+    uint32_t max_theft_attempts, iree_host_size_t start_index,
+    iree_task_deque_t* local_task_deque) {
+  const iree_host_size_t word_count =
+      iree_task_worker_set_word_index(executor->worker_count - 1) + 1;
+  const iree_host_size_t start_word = iree_task_worker_set_word_index(
+      start_index);
+  const iree_task_affinity_set_t start_bits =
+      ~(iree_task_worker_set_word_bit(start_index) - 1);
+
+  // Walk each word from the starting word and wrap around to the bits of the
+  // starting word preceding the starting bit. The ctz-based skipping avoids
+  // the need for doing a full O(n) scan and instead gets us O(popcnt) * O(ctz).
+  uint32_t attempt_count = 0;
+  for (iree_host_size_t i = 0; i <= word_count; ++i) {
+    iree_host_size_t word_index = (start_word + i) % word_count;
+    iree_task_affinity_set_t mask = victim_mask->words[word_index];
+    if (i == 0) {
+      mask &= start_bits;
+    } else if (i == word_count) {
+      mask &= ~start_bits;
     }
+    while (mask) {
+      if (attempt_count++ >= max_theft_attempts) return NULL;
+      int offset = iree_task_affinity_set_count_trailing_zeros(mask);
+      mask &= mask - 1;
+      iree_host_size_t victim_index = word_index * 64 + offset;
+      iree_task_worker_t* victim_worker = &executor->workers[victim_index];
+      if (iree_atomic_load_int32(&victim_worker->state,
+                                 iree_memory_order_acquire) !=
+          IREE_TASK_WORKER_STATE_RUNNING) {
+        return NULL;
+      }
 
-    // Policy: steal a chunk of tasks at the tail of the victim queue.
-    // This will steal multiple tasks from the victim up to the specified max
-    // and move the them into our local task queue. Not all tasks will be stolen
-    // and the assumption is that over a large-enough random distribution of
-    // thievery taking ~half of the tasks each time (across all queues) will
-    // lead to a relatively even distribution.
-    iree_task_t* task = iree_task_worker_try_steal_task(
-        victim_worker, local_task_queue,
-        /*max_tasks=*/IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT);
-    if (task) return task;
+      // Policy: steal a chunk of tasks at the tail of the victim queue.
+      // This will steal multiple tasks from the victim up to the specified max
+      // and move the them into our local task queue. Not all tasks will be
+      // stolen and the assumption is that over a large-enough random
+      // distribution of thievery taking ~half of the tasks each time (across
+      // all queues) will lead to a relatively even distribution.
+      iree_task_t* task = iree_task_worker_try_steal_task(
+          victim_worker, local_task_deque,
+          /*max_tasks=*/IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT);
+      if (task) return task;
+    }
   }
 
   // No tasks found in victim_mask.
@@ -564,7 +674,7 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 
 // Tries to steal an entire task from a sibling worker (based on topology).
 // Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// May steal multiple tasks and add them to the |local_task_deque|.
 //
 // We do a scan through ideal victims indicated by the
 // |constructive_sharing_mask|; these are the workers most likely to have some
@@ -578,44 +688,62 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 // our search and then go in-order.
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
-    iree_task_affinity_set_t constructive_sharing_mask,
+    const iree_task_worker_set_t* constructive_sharing_mask,
     uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue) {
+    iree_task_deque_t* local_task_deque) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // The masks are accessed with 'relaxed' order because they are just hints.
-  iree_task_affinity_set_t worker_live_mask =
-      iree_atomic_task_affinity_set_load(&executor->worker_live_mask,
-                                         iree_memory_order_relaxed);
-  iree_task_affinity_set_t worker_idle_mask =
-      iree_atomic_task_affinity_set_load(&executor->worker_idle_mask,
-                                         iree_memory_order_relaxed);
   // Limit the workers we will steal from to the ones that are currently live
-  // and not idle.
-  iree_task_affinity_set_t victim_mask = worker_live_mask & ~worker_idle_mask;
+  // and not idle and split them into those we share caches with and those we
+  // don't. The masks are accessed with 'relaxed' order because they are just
+  // hints.
+  iree_task_worker_set_t local_victim_mask;
+  iree_task_worker_set_t remote_victim_mask;
+  bool has_local_victims = false;
+  bool has_remote_victims = false;
+  for (iree_host_size_t i = 0;
+       i <= iree_task_worker_set_word_index(executor->worker_count - 1); ++i) {
+    iree_task_affinity_set_t victim_mask =
+        iree_atomic_task_affinity_set_load(&executor->worker_live_mask.words[i],
+                                           iree_memory_order_relaxed) &
+        ~iree_atomic_task_affinity_set_load(
+            &executor->worker_idle_mask.words[i], iree_memory_order_relaxed);
+    local_victim_mask.words[i] =
+        victim_mask & constructive_sharing_mask->words[i];
+    remote_victim_mask.words[i] =
+        victim_mask & ~constructive_sharing_mask->words[i];
+    has_local_victims |= local_victim_mask.words[i] != 0;
+    has_remote_victims |= remote_victim_mask.words[i] != 0;
+  }
 
   // TODO(benvanik): it may be possible to rework this such that we better
   // use the prng; for example, instead of all this rotating stuff we could just
   // generate an 8-bit number (or even split it into two 4-bit numbers) per
   // theft attempt. The current rotation strategy is biased toward the same try
   // ordering vs. what we may really want with an unbiased random selection.
-  int rotation_offset = iree_prng_minilcg128_next_uint8(theft_prng) &
-                        (8 * sizeof(iree_task_affinity_set_t) - 1);
+  iree_host_size_t start_index =
+      iree_prng_minilcg128_next_uint8(theft_prng) % executor->worker_count;
 
   // Try first with the workers we may have some caches shared with. This
   // helps to prevent cache invalidations/availability updates as it's likely
   // that we won't need to go back to main memory (or higher cache tiers) in the
   // event that the thief and victim are running close to each other in time.
-  iree_task_t* task = iree_task_executor_try_steal_task_from_affinity_set(
-      executor, victim_mask & constructive_sharing_mask, max_theft_attempts,
-      rotation_offset, local_task_queue);
-  if (task) {
-    IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
-  } else {
-    task = iree_task_executor_try_steal_task_from_affinity_set(
-        executor, victim_mask & ~constructive_sharing_mask, max_theft_attempts,
-        rotation_offset, local_task_queue);
+  iree_task_t* task = NULL;
+  if (has_local_victims) {
+    task = iree_task_executor_try_steal_task_from_worker_set(
+        executor, &local_victim_mask, max_theft_attempts, start_index,
+        local_task_deque);
     if (task) {
+      iree_metric_counter_increment(&iree_task_metric_local_steals);
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
+    }
+  }
+  if (!task && has_remote_victims) {
+    task = iree_task_executor_try_steal_task_from_worker_set(
+        executor, &remote_victim_mask, max_theft_attempts, start_index,
+        local_task_deque);
+    if (task) {
+      iree_metric_counter_increment(&iree_task_metric_remote_steals);
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "non-local");
     }
   }
@@ -642,3 +770,159 @@ iree_status_t iree_task_executor_donate_caller(iree_task_executor_t* executor,
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_task_executor_parallel_for
+//===----------------------------------------------------------------------===//
+
+// State shared between the caller of iree_task_executor_parallel_for and the
+// helper dispatch. Heap allocated as the helper dispatch may retire after the
+// caller has returned; the last of the two to release it frees it.
+typedef struct iree_task_parallel_for_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t allocator;
+  iree_task_parallel_tile_fn_t tile_fn;
+  void* user_data;
+  uint32_t tile_count;
+  // Next tile index to claim; may exceed |tile_count| once all are claimed.
+  iree_atomic_int32_t next_tile;
+  // Number of claimed tiles that have finished (or been skipped).
+  iree_atomic_int32_t completed_count;
+  // First failure from any tile or NULL.
+  iree_atomic_intptr_t status;
+  // Posted when |completed_count| reaches |tile_count|.
+  iree_notification_t completion_notification;
+  // Scope used by the helper dispatch; it never has fences or failures.
+  iree_task_scope_t scope;
+  iree_task_dispatch_t dispatch;
+} iree_task_parallel_for_t;
+
+static void iree_task_parallel_for_release(iree_task_parallel_for_t* state) {
+  if (iree_atomic_ref_count_dec(&state->ref_count) == 1) {
+    iree_task_scope_deinitialize(&state->scope);
+    iree_notification_deinitialize(&state->completion_notification);
+    iree_allocator_free(state->allocator, state);
+  }
+}
+
+// Claims and processes tiles until none remain. Tiles claimed after a failure
+// are skipped but still count as completed so that the caller can stop waiting.
+static void iree_task_parallel_for_process(iree_task_parallel_for_t* state) {
+  for (;;) {
+    uint32_t tile_index = (uint32_t)iree_atomic_fetch_add_int32(
+        &state->next_tile, 1, iree_memory_order_relaxed);
+    if (tile_index >= state->tile_count) break;
+    if (!iree_atomic_load_intptr(&state->status, iree_memory_order_acquire)) {
+      iree_status_t status = state->tile_fn(state->user_data, tile_index);
+      if (!iree_status_is_ok(status)) {
+        intptr_t expected = 0;
+        if (!iree_atomic_compare_exchange_strong_intptr(
+                &state->status, &expected, (intptr_t)status,
+                iree_memory_order_acq_rel, iree_memory_order_relaxed)) {
+          iree_status_ignore(status);
+        }
+      }
+    }
+    if (iree_atomic_fetch_add_int32(&state->completed_count, 1,
+                                    iree_memory_order_acq_rel) +
+            1 ==
+        (int32_t)state->tile_count) {
+      iree_notification_post(&state->completion_notification,
+                             IREE_ALL_WAITERS);
+    }
+  }
+}
+
+static iree_status_t iree_task_parallel_for_helper_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  iree_task_parallel_for_process((iree_task_parallel_for_t*)user_context);
+  return iree_ok_status();
+}
+
+static void iree_task_parallel_for_helper_cleanup(
+    iree_task_t* task, iree_status_code_t status_code) {
+  iree_task_parallel_for_t* state =
+      (iree_task_parallel_for_t*)((uint8_t*)task -
+                                  offsetof(iree_task_parallel_for_t, dispatch));
+  iree_task_parallel_for_release(state);
+}
+
+static bool iree_task_parallel_for_is_complete(void* arg) {
+  iree_task_parallel_for_t* state = (iree_task_parallel_for_t*)arg;
+  return iree_atomic_load_int32(&state->completed_count,
+                                iree_memory_order_acquire) ==
+         (int32_t)state->tile_count;
+}
+
+iree_status_t iree_task_executor_parallel_for(
+    iree_task_executor_t* executor, uint32_t tile_count,
+    iree_task_parallel_tile_fn_t tile_fn, void* user_data) {
+  IREE_ASSERT_ARGUMENT(tile_fn);
+  if (IREE_UNLIKELY(tile_count > INT32_MAX)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "tile count %u exceeds the maximum", tile_count);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, tile_count);
+
+  // Fast path for trivial loops or executors that have nobody to help.
+  uint32_t helper_count =
+      iree_min(tile_count - (tile_count ? 1 : 0),
+               (uint32_t)iree_task_executor_worker_count(executor));
+  if (helper_count == 0) {
+    iree_status_t status = iree_ok_status();
+    for (uint32_t i = 0; i < tile_count && iree_status_is_ok(status); ++i) {
+      status = tile_fn(user_data, i);
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_task_parallel_for_t* state = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(executor->allocator, sizeof(*state),
+                                (void**)&state));
+  iree_atomic_ref_count_init_value(&state->ref_count, 2);
+  state->allocator = executor->allocator;
+  state->tile_fn = tile_fn;
+  state->user_data = user_data;
+  state->tile_count = tile_count;
+  iree_atomic_store_int32(&state->next_tile, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&state->completed_count, 0,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_intptr(&state->status, 0, iree_memory_order_relaxed);
+  iree_notification_initialize(&state->completion_notification);
+  iree_task_scope_initialize(iree_make_cstring_view("parallel_for"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &state->scope);
+
+  // Each helper workgroup claims tiles until none remain. Helpers that start
+  // after the caller has claimed everything return immediately.
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {helper_count, 1, 1};
+  iree_task_dispatch_initialize(
+      &state->scope,
+      iree_task_make_dispatch_closure(iree_task_parallel_for_helper_tile,
+                                      state),
+      workgroup_size, workgroup_count, &state->dispatch);
+  iree_task_set_cleanup_fn(&state->dispatch.header,
+                           iree_task_parallel_for_helper_cleanup);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &state->dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+
+  // Process tiles on the calling thread and then wait for any still running
+  // on helpers.
+  iree_task_parallel_for_process(state);
+  iree_notification_await(&state->completion_notification,
+                          iree_task_parallel_for_is_complete, state,
+                          iree_infinite_timeout());
+
+  iree_status_t status = (iree_status_t)iree_atomic_exchange_intptr(
+      &state->status, 0, iree_memory_order_acquire);
+  iree_task_parallel_for_release(state);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
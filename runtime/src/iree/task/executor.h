@@ -113,12 +113,13 @@ extern "C" {
 //      as iree_wait_handle_t then it is placed into the waiting_list.
 //
 // 2. iree_task_executor_submit (LIFO, atomic slist)
-//    Submissions have their task thread-local lists concatenated into a LIFO
-//    incoming_ready_slist or the wait poller shared by the executor.
+//    Submissions have their task thread-local lists concatenated into one of
+//    the LIFO incoming ready slist shards or the wait poller shared by the
+//    executor. Concurrent submitters are spread across the shards.
 //
 // 3. iree_task_executor_flush (or a worker puts on its coordinator hat 🎩)
 //
-//   a. Tasks are flushed from the incoming_ready_slist into a coordinator-local
+//   a. Tasks are flushed from all incoming slist shards into a coordinator-local
 //      FIFO task queue. This centralizes enqueuing from all threads into a
 //      single ordered list.
 //
@@ -135,15 +136,15 @@ extern "C" {
 //    each worker will check its mailbox_slist to see if any tasks have been
 //    posted.
 //
-//    a. Tasks are flushed from the LIFO mailbox into the local_task_queue FIFO
+//    a. Tasks are flushed from the LIFO mailbox into the local_task_deque
 //       for the particular worker.
 //
 //    b. If the mailbox is empty the worker *may* attempt to steal work from
 //       another nearby worker in the topology.
 //
-//    c. Any tasks in the local_task_queue are executed until empty.
+//    c. Any tasks in the local_task_deque are executed until empty.
 //       Tasks are retired and dependent tasks (via completion_task or barriers)
-//       are made ready and placed in the executor incoming_ready_slist as with
+//       are made ready and placed in the executor incoming slist shards as with
 //       iree_task_executor_submit.
 //
 //    d. If no more thread-local work is available and the mailbox_slist is
@@ -265,9 +266,31 @@ enum iree_task_scheduling_mode_bits_t {
   // reach peak utilization or artificially limiting which tasks we allow
   // through to keep certain CPU cores asleep unless absolutely required.
   IREE_TASK_SCHEDULING_MODE_RESERVED = 0u,
+
+  // Dispatches partition their tile grid into contiguous slices that are
+  // assigned to the same workers each time a dispatch is issued. Consecutive
+  // dispatches over the same buffers (such as chains of elementwise and matmul
+  // dispatches in a command buffer) then have each worker touch the same
+  // workgroup ID ranges and find the data still warm in its caches. Workers
+  // only take tiles from other slices once their own slice has been exhausted
+  // in order to balance load.
+  IREE_TASK_SCHEDULING_MODE_DISPATCH_LOCALITY = 1u << 0,
 };
 typedef uint32_t iree_task_scheduling_mode_t;
 
+// Controls how long idle workers spin waiting for new work before parking.
+typedef enum iree_task_worker_spin_mode_e {
+  // Workers always spin for the full worker_spin_ns before parking.
+  IREE_TASK_WORKER_SPIN_MODE_FIXED = 0,
+  // Workers adjust their spin duration based on observed idle periods, up to
+  // worker_spin_ns. Short gaps between work (such as between back-to-back
+  // dispatches of one invocation) grow the spin duration so that the worker
+  // picks up the next work without a system wake and long gaps shrink it so
+  // that workers that will be idle for a while park quickly to free the CPU.
+  // Similar to OpenMP's KMP_BLOCKTIME with an adaptive upper bound.
+  IREE_TASK_WORKER_SPIN_MODE_ADAPTIVE = 1,
+} iree_task_worker_spin_mode_t;
+
 // Options controlling task executor behavior.
 typedef struct iree_task_executor_options_t {
   // Specifies the schedule mode used for worker and workload balancing.
@@ -286,8 +309,14 @@ typedef struct iree_task_executor_options_t {
   // spinning is often extremely harmful to system health. Only set to non-zero
   // values when latency is the #1 priority (over thermals, system-wide
   // scheduling, and the environment).
+  //
+  // Spinning workers are not registered as waiters and submitters posting work
+  // to them avoid the system wake they would need for a parked worker.
   iree_duration_t worker_spin_ns;
 
+  // Controls how the spin duration is chosen when worker_spin_ns is non-zero.
+  iree_task_worker_spin_mode_t worker_spin_mode;
+
   // Minimum size in bytes of each worker thread stack.
   // The underlying platform may allocate more stack space but _should_
   // guarantee that the available stack space is near this amount. Note that the
@@ -303,6 +332,18 @@ typedef struct iree_task_executor_options_t {
   // required.
   // By default the CPU L2 cache size is used if such queries are supported.
   iree_host_size_t worker_local_memory_size;
+
+  // Priority class of each worker thread.
+  iree_thread_priority_class_t worker_priority_class;
+
+  // Processor the poller thread used to wait on wait handles is pinned to.
+  // Unspecified by default to let the system place the thread; deployments
+  // with isolated cores can pin it away from latency-sensitive threads so that
+  // it does not preempt them each time a wait completes.
+  iree_thread_affinity_t poller_affinity;
+
+  // Priority class of the poller thread.
+  iree_thread_priority_class_t poller_priority_class;
 } iree_task_executor_options_t;
 
 // Initializes |out_options| to default values.
@@ -336,6 +377,13 @@ void iree_task_executor_trim(iree_task_executor_t* executor);
 iree_host_size_t iree_task_executor_worker_count(
     iree_task_executor_t* executor);
 
+// Returns the NUMA node the executor workers are placed on or
+// IREE_TASK_TOPOLOGY_NODE_ID_ANY if they span multiple nodes. Memory used
+// primarily by the executor (command buffer arenas, etc) should be bound to
+// this node.
+iree_task_topology_node_id_t iree_task_executor_node_id(
+    iree_task_executor_t* executor);
+
 // Returns an iree_event_t pool managed by the executor.
 // Users of the task system should acquire their transient events from this.
 // Long-lived events should be allocated on their own in order to avoid
@@ -407,6 +455,29 @@ iree_status_t iree_task_executor_donate_caller(iree_task_executor_t* executor,
                                                iree_wait_source_t wait_source,
                                                iree_timeout_t timeout);
 
+// Function called for each tile of a parallel loop.
+// Failures are propagated back to the caller of iree_task_executor_parallel_for
+// and cause any tiles not yet started to be skipped.
+typedef iree_status_t(IREE_API_PTR* iree_task_parallel_tile_fn_t)(
+    void* user_data, uint32_t tile_index);
+
+// Executes |tile_fn| for each tile in [0, |tile_count|) and blocks until all
+// tiles have completed. The calling thread processes tiles itself while any
+// workers that become available help with the remaining ones. Returns the
+// first failure from any tile.
+//
+// Unlike a dispatch this is intended for forking nested work from within a
+// running task (such as an executable import called from a dispatch tile)
+// where the caller needs the results before it can continue. The caller only
+// ever waits for tiles that are actively being processed by other workers and
+// it is safe to call from a worker thread.
+//
+// Tiles may execute in any order and concurrently with each other. They must
+// not depend on worker local memory as helpers run on arbitrary workers.
+iree_status_t iree_task_executor_parallel_for(
+    iree_task_executor_t* executor, uint32_t tile_count,
+    iree_task_parallel_tile_fn_t tile_fn, void* user_data);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,123 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Measures iree_task_executor_submit + iree_task_executor_flush throughput when
+// many host threads submit at the same time, such as a server running one
+// request per thread. Each submitting thread issues a stream of small call
+// tasks and flushes after each one; the reported time is per submission across
+// all threads.
+
+#include <cinttypes>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+#include "iree/task/topology.h"
+#include "iree/testing/benchmark.h"
+
+namespace {
+
+// Number of submissions each thread performs per benchmark iteration.
+// Large enough to amortize the thread launch overhead.
+static constexpr int kSubmissionsPerThread = 256;
+
+// Number of workers in the executor receiving the submissions.
+static constexpr iree_host_size_t kWorkerCount = 4;
+
+static iree_status_t NopCall(void* user_context, iree_task_t* task,
+                             iree_task_submission_t* pending_submission) {
+  return iree_ok_status();
+}
+
+// Submits |kSubmissionsPerThread| call tasks one at a time and flushes after
+// each as independent requests would.
+static void SubmitCalls(iree_task_executor_t* executor,
+                        iree_task_scope_t* scope) {
+  std::vector<iree_task_call_t> calls(kSubmissionsPerThread);
+  for (auto& call : calls) {
+    iree_task_call_initialize(
+        scope, iree_task_make_call_closure(NopCall, nullptr), &call);
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, scope, &fence));
+    iree_task_set_completion_task(&call.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &call.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+  }
+  // The tasks must outlive their execution.
+  IREE_CHECK_OK(iree_task_scope_wait_idle(scope, IREE_TIME_INFINITE_FUTURE));
+}
+
+static iree_status_t BenchmarkConcurrentSubmit(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_host_size_t thread_count =
+      (iree_host_size_t)benchmark_def->user_data;
+
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(kWorkerCount, &topology);
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_executor_t* executor = NULL;
+  IREE_RETURN_IF_ERROR(iree_task_executor_create(
+      options, &topology, benchmark_state->host_allocator, &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  // Each thread gets its own scope so that waiting for its tasks doesn't
+  // depend on the progress of other threads.
+  std::vector<iree_task_scope_t> scopes(thread_count);
+  for (auto& scope : scopes) {
+    iree_task_scope_initialize(iree_make_cstring_view("submitter"),
+                               IREE_TASK_SCOPE_FLAG_NONE, &scope);
+  }
+
+  while (iree_benchmark_keep_running(
+      benchmark_state,
+      /*batch_count=*/thread_count * kSubmissionsPerThread)) {
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (iree_host_size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back(SubmitCalls, executor, &scopes[i]);
+    }
+    for (auto& thread : threads) thread.join();
+  }
+
+  for (auto& scope : scopes) {
+    iree_task_scope_deinitialize(&scope);
+  }
+  iree_task_executor_release(executor);
+  return iree_ok_status();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  static const iree_host_size_t thread_counts[] = {1, 2, 4, 8, 16};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(thread_counts); ++i) {
+    iree_benchmark_def_t benchmark_def = {0};
+    benchmark_def.flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                          IREE_BENCHMARK_FLAG_USE_REAL_TIME;
+    benchmark_def.time_unit = IREE_BENCHMARK_UNIT_NANOSECOND;
+    benchmark_def.run = BenchmarkConcurrentSubmit;
+    benchmark_def.user_data = (void*)thread_counts[i];
+    char name[64];
+    snprintf(name, sizeof(name), "concurrent_submit_%" PRIhsz "_threads",
+             thread_counts[i]);
+    iree_benchmark_register(iree_make_cstring_view(name), &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -12,12 +12,12 @@
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/wait_handle.h"
 #include "iree/task/affinity_set.h"
+#include "iree/task/deque.h"
 #include "iree/task/executor.h"
 #include "iree/task/list.h"
 #include "iree/task/poller.h"
 #include "iree/task/pool.h"
 #include "iree/task/post_batch.h"
-#include "iree/task/queue.h"
 #include "iree/task/tuning.h"
 #include "iree/task/worker.h"
 
@@ -25,6 +25,19 @@
 extern "C" {
 #endif  // __cplusplus
 
+static_assert((IREE_TASK_EXECUTOR_SUBMISSION_SHARD_COUNT &
+               (IREE_TASK_EXECUTOR_SUBMISSION_SHARD_COUNT - 1)) == 0,
+              "submission shard count must be a power of two");
+
+// One shard of the executor incoming ready task lists.
+// Padded so that submitters concatenating into different shards don't
+// invalidate each other's cache lines.
+typedef struct iree_task_executor_submission_shard_t {
+  iree_atomic_task_slist_t ready_slist;
+  uint8_t _padding[iree_hardware_destructive_interference_size -
+                   sizeof(iree_atomic_task_slist_t)];
+} iree_task_executor_submission_shard_t;
+
 struct iree_task_executor_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t allocator;
@@ -35,12 +48,22 @@ struct iree_task_executor_t {
   IREE_TRACE(const char* trace_name;)
 
   // Defines how work is selected across queues.
-  // TODO(benvanik): make mutable; currently always the same reserved value.
+  // TODO(benvanik): make mutable.
   iree_task_scheduling_mode_t scheduling_mode;
 
   // Time each worker should spin before parking itself to wait for more work.
-  // IREE_DURATION_ZERO is used to disable spinning.
+  // IREE_DURATION_ZERO is used to disable spinning. When the spin mode is
+  // adaptive this is the upper bound of each worker's spin duration.
   iree_duration_t worker_spin_ns;
+  iree_task_worker_spin_mode_t worker_spin_mode;
+
+  // Total number of idle waits that were resolved while spinning and that
+  // required parking the worker in the system. Plotted under the leaked
+  // |spin_trace_name| and |park_trace_name| to help tune the spin duration.
+  IREE_TRACE(iree_atomic_int64_t worker_spin_wake_count;)
+  IREE_TRACE(iree_atomic_int64_t worker_park_count;)
+  IREE_TRACE(const char* spin_trace_name;)
+  IREE_TRACE(const char* park_trace_name;)
 
   // State used by the work-stealing operations performed by donated threads.
   // This is **NOT SYNCHRONIZED** and relies on the fact that we actually don't
@@ -60,8 +83,8 @@ struct iree_task_executor_t {
   // Increasing the size larger than these will waste memory.
   iree_task_pool_t transient_task_pool;
 
-  // A list of incoming tasks that are ready to execute immediately.
-  // The list is LIFO and we require that task lists are reversed by the
+  // Lists of incoming tasks that are ready to execute immediately.
+  // Each list is LIFO and we require that task lists are reversed by the
   // submitter so we can use iree_atomic_slist_concat to quickly prepend the
   // LIFO list to the atomic slist. By doing this we can construct the task
   // lists in LIFO order prior to submission, concat with a pointer swap into
@@ -74,7 +97,13 @@ struct iree_task_executor_t {
   //   existing tasks: C B A
   //        new tasks: 1 2 3
   //    updated tasks: 3 2 1 C B A
-  iree_atomic_task_slist_t incoming_ready_slist;
+  //
+  // Submitting threads are spread across the shards so that concurrent
+  // submitters don't all contend on a single list. The coordinator flushes all
+  // shards each time it runs. Tasks from different shards have no ordering
+  // relative to each other but ready tasks never do.
+  iree_task_executor_submission_shard_t
+      submission_shards[IREE_TASK_EXECUTOR_SUBMISSION_SHARD_COUNT];
 
   // iree_event_t pool used to acquire system wait handles.
   // Many subsystems interacting with the executor will need events to park
@@ -84,9 +113,15 @@ struct iree_task_executor_t {
   iree_event_pool_t* event_pool;
 
   // Guards coordination logic; only one thread at a time may be acting as the
-  // coordinator.
+  // coordinator. Threads that find another thread coordinating don't wait for
+  // it and instead set |coordination_requested| so that the current
+  // coordinator runs again on their behalf before it returns.
   iree_slim_mutex_t coordinator_mutex;
 
+  // Non-zero if coordination has been requested since the current coordinator
+  // (if any) started flushing the incoming submission shards.
+  iree_atomic_int32_t coordination_requested;
+
   // Wait task polling and wait thread manager.
   // This handles all system waits so that we can keep the syscalls off the
   // worker threads and lower wake latencies (the wait thread can enqueue
@@ -105,7 +140,7 @@ struct iree_task_executor_t {
   // atomically query worker->state. This mask is for usage patterns where one
   // needs a cheap (single relaxed atomic op) approximation of all N workers'
   // live state without having to perform N expensive atomic ops.
-  iree_atomic_task_affinity_set_t worker_live_mask;
+  iree_atomic_task_worker_set_t worker_live_mask;
 
   // A bitset indicating which workers are currently idle. Used to bias incoming
   // tasks to workers that aren't doing much else. This is a balance of latency
@@ -114,13 +149,21 @@ struct iree_task_executor_t {
   //
   // This mask is just a hint, accessed with memory_order_relaxed. See the
   // comment on worker_live_mask.
-  iree_atomic_task_affinity_set_t worker_idle_mask;
+  iree_atomic_task_worker_set_t worker_idle_mask;
+
+  // NUMA node all workers are placed on or IREE_TASK_TOPOLOGY_NODE_ID_ANY if
+  // they span nodes. Resources used by the executor should be bound here.
+  iree_task_topology_node_id_t node_id;
 
   // Base value added to each executor-local worker index.
   // This allows workers to uniquely identify themselves in multi-executor
   // configurations.
   iree_host_size_t worker_base_index;
 
+  // Shift applied to local worker indices to find the bit covering them in
+  // task iree_task_affinity_set_t values. 0 when there are <= 64 workers.
+  uint32_t affinity_shift;
+
   // Specifies how many workers threads there are.
   // For now this number is fixed per executor however if we wanted to enable
   // live join/leave behavior we could change this to a registration mechanism.
@@ -156,12 +199,12 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
 
 // Tries to steal an entire task from a sibling worker (based on topology).
 // Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// May steal multiple tasks and add them to the |local_task_deque|.
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
-    iree_task_affinity_set_t constructive_sharing_mask,
+    const iree_task_worker_set_t* constructive_sharing_mask,
     uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue);
+    iree_task_deque_t* local_task_deque);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -6,7 +6,10 @@
 
 #include "iree/task/executor.h"
 
+#include <atomic>
 #include <cstddef>
+#include <thread>
+#include <vector>
 
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
@@ -86,6 +89,53 @@ TEST(ExecutorTest, LifetimeStress) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Submits |count| calls to |executor| one at a time and waits for each.
+static void SubmitSerializedCalls(iree_task_executor_t* executor, int count) {
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  // Each call stores its value here; local so that concurrent submitters each
+  // check their own calls.
+  struct CallState {
+    int value;
+    std::atomic<int> received_value;
+  } state;
+  state.received_value = -1;
+
+  for (int i = 0; i < count; ++i) {
+    state.value = i;
+    iree_task_call_t call;
+    iree_task_call_initialize(
+        &scope,
+        iree_task_make_call_closure(
+            [](void* user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              auto* state = (CallState*)user_context;
+              state->received_value = state->value;
+              return iree_ok_status();
+            },
+            (void*)&state),
+        &call);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&call.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &call.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+    EXPECT_EQ(state.received_value, i) << "call did not correlate to loop";
+  }
+
+  iree_task_scope_deinitialize(&scope);
+}
+
 // Tests heavily serialized submission to an executor.
 // This puts pressure on the overheads involved in spilling up threads.
 TEST(ExecutorTest, SubmissionStress) {
@@ -97,37 +147,103 @@ TEST(ExecutorTest, SubmissionStress) {
   iree_task_executor_t* executor = NULL;
   IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
                                            iree_allocator_system(), &executor));
+  SubmitSerializedCalls(executor, 1000);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests serialized submission from many threads at once.
+// Submitters that find another thread coordinating hand their work off to it
+// and must not have it stranded in the incoming lists.
+TEST(ExecutorTest, SubmissionStressConcurrent) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back(SubmitSerializedCalls, executor, 250);
+  }
+  for (auto& thread : threads) thread.join();
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests serialized submission with workers spinning before parking. Workers
+// must not miss posts that arrive while they transition from spinning to
+// parked.
+TEST(ExecutorTest, SubmissionStressSpinning) {
+  for (auto spin_mode : {IREE_TASK_WORKER_SPIN_MODE_FIXED,
+                         IREE_TASK_WORKER_SPIN_MODE_ADAPTIVE}) {
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    options.worker_local_memory_size = 64 * 1024;
+    options.worker_spin_ns = 20 * 1000;
+    options.worker_spin_mode = spin_mode;
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/4,
+                                                   &topology);
+    iree_task_executor_t* executor = NULL;
+    IREE_ASSERT_OK(iree_task_executor_create(
+        options, &topology, iree_allocator_system(), &executor));
+    SubmitSerializedCalls(executor, 500);
+    iree_task_executor_release(executor);
+    iree_task_topology_deinitialize(&topology);
+  }
+}
+
+// Tests an executor with more workers than fit in a single affinity word.
+// Dispatches fan out across all workers and must touch every tile.
+TEST(ExecutorTest, WideDispatch) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 4 * 1024;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/130,
+                                                 &topology);
+  ASSERT_EQ(130, iree_task_topology_group_count(&topology));
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  EXPECT_EQ(130, iree_task_executor_worker_count(executor));
   iree_task_scope_t scope;
   iree_task_scope_initialize(iree_make_cstring_view("scope"),
                              IREE_TASK_SCOPE_FLAG_NONE, &scope);
 
-  for (int i = 0; i < 1000; ++i) {
-    static std::atomic<int> received_value = {0};
-    iree_task_call_t call;
-    iree_task_call_initialize(
+  for (int i = 0; i < 4; ++i) {
+    static std::atomic<int> tile_count = {0};
+    tile_count = 0;
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {1000, 1, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
         &scope,
-        iree_task_make_call_closure(
-            [](void* user_context, iree_task_t* task,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
                iree_task_submission_t* pending_submission) {
-              received_value = (int)(uintptr_t)user_context;
+              ++tile_count;
               return iree_ok_status();
             },
-            (void*)(uintptr_t)i),
-        &call);
+            NULL),
+        workgroup_size, workgroup_count, &dispatch);
 
     iree_task_fence_t* fence = NULL;
     IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
-    iree_task_set_completion_task(&call.header, &fence->header);
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
 
     iree_task_submission_t submission;
     iree_task_submission_initialize(&submission);
-    iree_task_submission_enqueue(&submission, &call.header);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
     iree_task_executor_submit(executor, &submission);
     iree_task_executor_flush(executor);
     IREE_ASSERT_OK(
         iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
 
-    EXPECT_EQ(received_value, i) << "call did not correlate to loop";
+    EXPECT_EQ(tile_count, 1000);
   }
 
   iree_task_scope_deinitialize(&scope);
@@ -135,4 +251,202 @@ TEST(ExecutorTest, SubmissionStress) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Tasks from high priority scopes run before normal tasks that were queued on
+// the same worker earlier.
+TEST(ExecutorTest, HighPriorityScopeRunsFirst) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/1, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+  iree_task_scope_t normal_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("normal"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &normal_scope);
+  iree_task_scope_t priority_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("priority"),
+                             IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY,
+                             &priority_scope);
+
+  static std::atomic<bool> blocker_started = {false};
+  static std::atomic<bool> blocker_released = {false};
+  static std::atomic<int> next_order = {0};
+  static int call_order[9];
+
+  // Occupy the only worker until all other calls have been posted to it.
+  iree_task_call_t blocker;
+  iree_task_call_initialize(
+      &normal_scope,
+      iree_task_make_call_closure(
+          [](void* user_context, iree_task_t* task,
+             iree_task_submission_t* pending_submission) {
+            blocker_started = true;
+            while (!blocker_released) std::this_thread::yield();
+            return iree_ok_status();
+          },
+          NULL),
+      &blocker);
+  iree_task_fence_t* blocker_fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &normal_scope,
+                                                  &blocker_fence));
+  iree_task_set_completion_task(&blocker.header, &blocker_fence->header);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &blocker.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  while (!blocker_started) std::this_thread::yield();
+
+  // Queue up normal calls 0-7 followed by priority call 8.
+  auto record_order = [](void* user_context, iree_task_t* task,
+                         iree_task_submission_t* pending_submission) {
+    call_order[next_order++] = (int)(uintptr_t)user_context;
+    return iree_ok_status();
+  };
+  iree_task_call_t calls[9];
+  iree_task_fence_t* normal_fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &normal_scope,
+                                                  &normal_fence));
+  iree_task_submission_initialize(&submission);
+  for (int i = 0; i < 8; ++i) {
+    iree_task_call_initialize(
+        &normal_scope,
+        iree_task_make_call_closure(record_order, (void*)(uintptr_t)i),
+        &calls[i]);
+    iree_task_set_completion_task(&calls[i].header, &normal_fence->header);
+    iree_task_submission_enqueue(&submission, &calls[i].header);
+  }
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  iree_task_fence_t* priority_fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &priority_scope,
+                                                  &priority_fence));
+  iree_task_call_initialize(
+      &priority_scope,
+      iree_task_make_call_closure(record_order, (void*)(uintptr_t)8),
+      &calls[8]);
+  iree_task_set_completion_task(&calls[8].header, &priority_fence->header);
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &calls[8].header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+
+  blocker_released = true;
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&priority_scope, IREE_TIME_INFINITE_FUTURE));
+  IREE_ASSERT_OK(
+      iree_task_scope_wait_idle(&normal_scope, IREE_TIME_INFINITE_FUTURE));
+
+  ASSERT_EQ(next_order, 9);
+  EXPECT_EQ(call_order[0], 8);
+
+  iree_task_scope_deinitialize(&priority_scope);
+  iree_task_scope_deinitialize(&normal_scope);
+  iree_task_executor_release(executor);
+}
+
+// Tests parallel loops issued from a thread outside of the executor.
+TEST(ExecutorTest, ParallelFor) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  for (uint32_t tile_count : {0u, 1u, 3u, 1000u}) {
+    std::vector<std::atomic<int>> hits(tile_count);
+    for (auto& hit : hits) hit = 0;
+    IREE_ASSERT_OK(iree_task_executor_parallel_for(
+        executor, tile_count,
+        [](void* user_data, uint32_t tile_index) {
+          auto* hits = (std::vector<std::atomic<int>>*)user_data;
+          ++(*hits)[tile_index];
+          return iree_ok_status();
+        },
+        &hits));
+    for (auto& hit : hits) EXPECT_EQ(hit, 1);
+  }
+
+  iree_task_executor_release(executor);
+}
+
+// Tests that parallel loop failures are returned to the caller.
+TEST(ExecutorTest, ParallelForFailure) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_status_t status = iree_task_executor_parallel_for(
+      executor, 100,
+      [](void* user_data, uint32_t tile_index) {
+        return tile_index == 42 ? iree_make_status(IREE_STATUS_DATA_LOSS)
+                                : iree_ok_status();
+      },
+      NULL);
+  EXPECT_EQ(iree_status_code(status), IREE_STATUS_DATA_LOSS);
+  iree_status_ignore(status);
+
+  iree_task_executor_release(executor);
+}
+
+// Tests parallel loops forked from within dispatch tiles running on workers.
+TEST(ExecutorTest, ParallelForFromTile) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  static std::atomic<int> inner_count = {0};
+  inner_count = 0;
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {8, 1, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            return iree_task_executor_parallel_for(
+                tile_context->executor, 64,
+                [](void* user_data, uint32_t tile_index) {
+                  ++inner_count;
+                  return iree_ok_status();
+                },
+                NULL);
+          },
+          NULL),
+      workgroup_size, workgroup_count, &dispatch);
+
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&dispatch.header, &fence->header);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(inner_count, 8 * 64);
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
 }  // namespace
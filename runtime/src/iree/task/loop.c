@@ -0,0 +1,637 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/task/loop.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/task/submission.h"
+#include "iree/task/task.h"
+
+//==============================================================================
+// iree_task_loop_op_t
+//==============================================================================
+
+// A single loop operation and the tasks used to perform it.
+//
+// Every operation ends with |completion_task| which issues the user callback on
+// a worker and retires the operation from its cleanup function. No task in an
+// operation ever fails: callback and workgroup errors are tracked on the
+// operation and loop instead of on the task scope so that one failing or timed
+// out operation does not abort unrelated work sharing the scope.
+//
+// Task DAGs per command:
+//   CALL:       completion
+//   DISPATCH:   dispatch -> completion
+//   WAIT_UNTIL: delay -> completion
+//   WAIT_ONE/WAIT_ANY:
+//     wait[0..n) (wait-any) -> completion
+//     delay (wait-any) -> completion
+//   WAIT_ALL:
+//     wait[0..n) -> join -> nudge -> completion
+//     delay (wait-any) -> completion
+//
+// Waits are issued without a deadline and raced against the delay task
+// instead: a wait task that hits its deadline fails its scope. All wait tasks
+// share |cancellation_flag| such that the first to resolve in wait-any mode
+// (or the delay) cancels the rest. For wait-all the join cancels the delay
+// once all waits have resolved and the nudge (an immediately resolved wait)
+// kicks the poller so that it notices the cancellation. The result of a wait
+// is determined by querying the wait sources once all tasks have retired.
+typedef iree_alignas(iree_max_align_t) struct iree_task_loop_op_t {
+  // Loop the operation was enqueued on.
+  iree_task_loop_t* loop;
+
+  // Intrusive doubly-linked list of pending operations in the loop.
+  struct iree_task_loop_op_t* prev;
+  struct iree_task_loop_op_t* next;
+
+  // Command the operation is performing.
+  iree_loop_command_t command;
+
+  // User callback issued when the operation completes.
+  iree_loop_callback_t callback;
+
+  // Nonzero if the operation was aborted because of a failure in another
+  // operation. The callback will receive IREE_STATUS_ABORTED.
+  iree_atomic_int32_t aborted;
+
+  // Shared cancellation flag for all wait tasks of the operation.
+  iree_atomic_int32_t cancellation_flag;
+
+  // True once |callback| has been issued.
+  bool callback_issued;
+  // Status returned from |callback| routed to the loop error handler.
+  iree_status_t callback_status;
+
+  // DISPATCH: function called per workgroup.
+  iree_loop_workgroup_fn_t workgroup_fn;
+  // DISPATCH: first failure returned from |workgroup_fn|.
+  iree_atomic_intptr_t workgroup_status;
+
+  // WAIT_*: total number of entries in |wait_sources| and |wait_tasks|.
+  iree_host_size_t wait_count;
+  // WAIT_*: wait sources being waited on. Unowned except for WAIT_ONE where
+  // this points at |wait_source|.
+  iree_wait_source_t* wait_sources;
+  // WAIT_ONE: storage for the single wait source.
+  iree_wait_source_t wait_source;
+
+  // Issues |callback| and retires the operation.
+  iree_task_call_t completion_task;
+
+  union {
+    // DISPATCH: the grid dispatch calling |workgroup_fn|.
+    iree_task_dispatch_t dispatch_task;
+    struct {
+      // WAIT_*: delay until the operation deadline, if any.
+      iree_task_wait_t delay_task;
+      // WAIT_ALL: joins all of |wait_tasks| and cancels |delay_task|.
+      iree_task_call_t join_task;
+      // WAIT_ALL: wakes the poller after |join_task| cancels |delay_task|.
+      iree_task_wait_t nudge_task;
+    } wait;
+  } tasks;
+
+  // WAIT_*: one wait task per wait source.
+  iree_task_wait_t wait_tasks[];
+} iree_task_loop_op_t;
+
+//==============================================================================
+// iree_task_loop_t
+//==============================================================================
+
+struct iree_task_loop_t {
+  iree_allocator_t allocator;
+  iree_task_executor_t* executor;
+
+  // Optional function used to report errors returned from callbacks.
+  iree_task_loop_error_fn_t error_fn;
+  void* error_user_data;
+
+  // Scope all tasks are issued against. Each pending operation holds a
+  // begin/end pair on the scope such that it is idle when all operations have
+  // retired.
+  iree_task_scope_t scope;
+
+  // Guards |pending_head|.
+  iree_slim_mutex_t mutex;
+  // All operations that have not yet retired.
+  iree_task_loop_op_t* pending_head;
+};
+
+// Submits all root tasks in |submission| to the loop executor.
+static void iree_task_loop_submit(iree_task_loop_t* loop,
+                                  iree_task_submission_t* submission) {
+  iree_task_executor_submit(loop->executor, submission);
+  iree_task_executor_flush(loop->executor);
+}
+
+// Standalone immediately-resolved wait used to wake the executor poller such
+// that it rescans its waits for cancellation.
+typedef struct iree_task_loop_nudge_t {
+  iree_task_wait_t task;
+  iree_task_loop_t* loop;
+} iree_task_loop_nudge_t;
+
+static void iree_task_loop_nudge_cleanup(iree_task_t* task,
+                                         iree_status_code_t status_code) {
+  iree_task_loop_nudge_t* nudge = (iree_task_loop_nudge_t*)task;
+  iree_task_loop_t* loop = nudge->loop;
+  iree_allocator_free(loop->allocator, nudge);
+  iree_task_scope_end(&loop->scope);
+}
+
+// Wakes the executor poller so that any cancelled waits are retired.
+// Failure to allocate the nudge only delays cancellation until the poller next
+// wakes and is ignored.
+static void iree_task_loop_nudge_poller(iree_task_loop_t* loop) {
+  iree_task_loop_nudge_t* nudge = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(loop->allocator, sizeof(*nudge), (void**)&nudge);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return;
+  }
+  nudge->loop = loop;
+  iree_task_wait_initialize(&loop->scope, iree_wait_source_immediate(),
+                            IREE_TIME_INFINITE_FUTURE, &nudge->task);
+  iree_task_set_cleanup_fn(&nudge->task.header, iree_task_loop_nudge_cleanup);
+  iree_task_scope_begin(&loop->scope);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &nudge->task.header);
+  iree_task_loop_submit(loop, &submission);
+}
+
+// Returns true if |command| is performed with wait tasks.
+static bool iree_task_loop_command_is_wait(iree_loop_command_t command) {
+  return command == IREE_LOOP_COMMAND_WAIT_UNTIL ||
+         command == IREE_LOOP_COMMAND_WAIT_ONE ||
+         command == IREE_LOOP_COMMAND_WAIT_ANY ||
+         command == IREE_LOOP_COMMAND_WAIT_ALL;
+}
+
+// Aborts all pending operations in |loop|.
+// Operations that have not yet issued their callbacks will receive
+// IREE_STATUS_ABORTED and any waits they have outstanding are cancelled.
+static void iree_task_loop_abort_pending(iree_task_loop_t* loop) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  bool any_waits = false;
+  iree_slim_mutex_lock(&loop->mutex);
+  for (iree_task_loop_op_t* op = loop->pending_head; op != NULL;
+       op = op->next) {
+    iree_atomic_store_int32(&op->aborted, 1, iree_memory_order_release);
+    if (iree_task_loop_command_is_wait(op->command)) {
+      iree_atomic_store_int32(&op->cancellation_flag, 1,
+                              iree_memory_order_release);
+      any_waits = true;
+    }
+  }
+  iree_slim_mutex_unlock(&loop->mutex);
+  if (any_waits) iree_task_loop_nudge_poller(loop);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Routes |status| to the loop error handler and aborts pending operations.
+static void iree_task_loop_fail(iree_task_loop_t* loop, iree_status_t status) {
+  if (loop->error_fn) {
+    loop->error_fn(loop->error_user_data, status);
+  } else {
+    iree_status_ignore(status);
+  }
+  iree_task_loop_abort_pending(loop);
+}
+
+void iree_task_loop_options_initialize(iree_task_loop_options_t* out_options) {
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->scope_flags = IREE_TASK_SCOPE_FLAG_NONE;
+}
+
+iree_status_t iree_task_loop_allocate(iree_task_loop_options_t options,
+                                      iree_task_executor_t* executor,
+                                      iree_allocator_t allocator,
+                                      iree_task_loop_t** out_loop) {
+  IREE_ASSERT_ARGUMENT(executor);
+  IREE_ASSERT_ARGUMENT(out_loop);
+  *out_loop = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_task_loop_t* loop = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, sizeof(*loop), (void**)&loop));
+  memset(loop, 0, sizeof(*loop));
+  loop->allocator = allocator;
+  loop->executor = executor;
+  iree_task_executor_retain(executor);
+  loop->error_fn = options.error_fn;
+  loop->error_user_data = options.error_user_data;
+  iree_task_scope_initialize(iree_make_cstring_view("loop"),
+                             options.scope_flags, &loop->scope);
+  iree_slim_mutex_initialize(&loop->mutex);
+
+  *out_loop = loop;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_task_loop_free(iree_task_loop_t* loop) {
+  if (!loop) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Abort everything outstanding and wait for the callbacks to be issued.
+  iree_task_loop_abort_pending(loop);
+  iree_status_ignore(
+      iree_task_scope_wait_idle(&loop->scope, IREE_TIME_INFINITE_FUTURE));
+  IREE_ASSERT(loop->pending_head == NULL);
+
+  iree_slim_mutex_deinitialize(&loop->mutex);
+  iree_task_scope_deinitialize(&loop->scope);
+  iree_task_executor_release(loop->executor);
+  iree_allocator_t allocator = loop->allocator;
+  iree_allocator_free(allocator, loop);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+iree_status_t iree_task_loop_wait_idle(iree_task_loop_t* loop,
+                                       iree_timeout_t timeout) {
+  IREE_ASSERT_ARGUMENT(loop);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_task_scope_wait_idle(
+      &loop->scope, iree_timeout_as_deadline_ns(timeout));
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//==============================================================================
+// Operation lifetime
+//==============================================================================
+
+// Allocates an operation with storage for |wait_count| wait tasks and links it
+// into the pending list of |loop|. The operation holds the loop scope open
+// until it retires.
+static iree_status_t iree_task_loop_op_allocate(
+    iree_task_loop_t* loop, iree_loop_command_t command,
+    iree_loop_callback_t callback, iree_host_size_t wait_count,
+    iree_task_loop_op_t** out_op) {
+  *out_op = NULL;
+  if (IREE_UNLIKELY(wait_count > (IREE_HOST_SIZE_MAX -
+                                  sizeof(iree_task_loop_op_t)) /
+                                     sizeof(iree_task_wait_t))) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "wait count %" PRIhsz " too large", wait_count);
+  }
+  const iree_host_size_t total_size =
+      sizeof(iree_task_loop_op_t) + wait_count * sizeof(iree_task_wait_t);
+  iree_task_loop_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(loop->allocator, total_size, (void**)&op));
+  memset(op, 0, total_size);
+  op->loop = loop;
+  op->command = command;
+  op->callback = callback;
+  op->wait_count = wait_count;
+
+  iree_task_scope_begin(&loop->scope);
+  iree_slim_mutex_lock(&loop->mutex);
+  op->next = loop->pending_head;
+  if (op->next) op->next->prev = op;
+  loop->pending_head = op;
+  iree_slim_mutex_unlock(&loop->mutex);
+
+  *out_op = op;
+  return iree_ok_status();
+}
+
+// Unlinks and frees |op|, routing any callback failure to the loop.
+// The loop may be freed by another thread as soon as this returns.
+static void iree_task_loop_op_retire(iree_task_loop_op_t* op) {
+  iree_task_loop_t* loop = op->loop;
+
+  iree_slim_mutex_lock(&loop->mutex);
+  if (op->prev) {
+    op->prev->next = op->next;
+  } else {
+    loop->pending_head = op->next;
+  }
+  if (op->next) op->next->prev = op->prev;
+  iree_slim_mutex_unlock(&loop->mutex);
+
+  // Any operations enqueued by the callback are still pending and will be
+  // aborted along with everything else.
+  iree_status_t status = op->callback_status;
+  iree_allocator_free(loop->allocator, op);
+  if (!iree_status_is_ok(status)) {
+    iree_task_loop_fail(loop, status);
+  }
+
+  // Must be last: the loop may be deallocated once it goes idle.
+  iree_task_scope_end(&loop->scope);
+}
+
+// Queries the wait sources of a wait operation for the result of the wait.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if the wait condition is not met.
+static iree_status_t iree_task_loop_op_query_waits(iree_task_loop_op_t* op,
+                                                   bool wait_all) {
+  for (iree_host_size_t i = 0; i < op->wait_count; ++i) {
+    iree_status_code_t wait_status_code = IREE_STATUS_OK;
+    IREE_RETURN_IF_ERROR(
+        iree_wait_source_query(op->wait_sources[i], &wait_status_code));
+    if (wait_status_code == IREE_STATUS_OK) {
+      if (!wait_all) return iree_ok_status();
+    } else if (wait_status_code != IREE_STATUS_DEFERRED) {
+      return iree_status_from_code(wait_status_code);
+    } else if (wait_all) {
+      return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+    }
+  }
+  return wait_all ? iree_ok_status()
+                  : iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
+// Returns the status |op| completed with that is passed to its callback.
+static iree_status_t iree_task_loop_op_consume_status(iree_task_loop_op_t* op) {
+  iree_status_t workgroup_status = (iree_status_t)iree_atomic_exchange_intptr(
+      &op->workgroup_status, 0, iree_memory_order_acquire);
+  if (iree_atomic_load_int32(&op->aborted, iree_memory_order_acquire)) {
+    iree_status_ignore(workgroup_status);
+    return iree_status_from_code(IREE_STATUS_ABORTED);
+  }
+  switch (op->command) {
+    case IREE_LOOP_COMMAND_DISPATCH:
+      return workgroup_status;
+    case IREE_LOOP_COMMAND_WAIT_ONE:
+    case IREE_LOOP_COMMAND_WAIT_ANY:
+      return iree_task_loop_op_query_waits(op, /*wait_all=*/false);
+    case IREE_LOOP_COMMAND_WAIT_ALL:
+      return iree_task_loop_op_query_waits(op, /*wait_all=*/true);
+    default:
+      return iree_ok_status();
+  }
+}
+
+// Issues the user callback of |op| with |status|.
+static void iree_task_loop_op_issue_callback(iree_task_loop_op_t* op,
+                                             iree_status_t status) {
+  op->callback_issued = true;
+  op->callback_status = op->callback.fn(op->callback.user_data,
+                                        iree_loop_task(op->loop), status);
+}
+
+// Completion task closure issuing the user callback on a worker.
+static iree_status_t iree_task_loop_op_complete(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_task_loop_op_t* op = (iree_task_loop_op_t*)user_context;
+  iree_task_loop_op_issue_callback(op, iree_task_loop_op_consume_status(op));
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Cleanup function of the completion task retiring the operation.
+// Called with IREE_STATUS_ABORTED if the completion task was discarded before
+// it could run in which case the callback must still be issued.
+static void iree_task_loop_op_cleanup(iree_task_t* task,
+                                      iree_status_code_t status_code) {
+  iree_task_loop_op_t* op =
+      (iree_task_loop_op_t*)((uint8_t*)task -
+                             offsetof(iree_task_loop_op_t, completion_task));
+  if (!op->callback_issued) {
+    iree_status_ignore(iree_task_loop_op_consume_status(op));
+    iree_task_loop_op_issue_callback(
+        op, iree_status_from_code(IREE_STATUS_ABORTED));
+  }
+  iree_task_loop_op_retire(op);
+}
+
+// Initializes the completion task of |op|.
+static void iree_task_loop_op_initialize_completion(iree_task_loop_op_t* op) {
+  iree_task_call_initialize(
+      &op->loop->scope,
+      iree_task_make_call_closure(iree_task_loop_op_complete, op),
+      &op->completion_task);
+  iree_task_set_cleanup_fn(&op->completion_task.header,
+                           iree_task_loop_op_cleanup);
+}
+
+//==============================================================================
+// IREE_LOOP_COMMAND_CALL
+//==============================================================================
+
+static iree_status_t iree_task_loop_run_call(
+    iree_task_loop_t* loop, const iree_loop_call_params_t* params) {
+  iree_task_loop_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_task_loop_op_allocate(
+      loop, IREE_LOOP_COMMAND_CALL, params->callback, 0, &op));
+  iree_task_loop_op_initialize_completion(op);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &op->completion_task.header);
+  iree_task_loop_submit(loop, &submission);
+  return iree_ok_status();
+}
+
+//==============================================================================
+// IREE_LOOP_COMMAND_DISPATCH
+//==============================================================================
+
+// Dispatch tile closure calling the user workgroup function.
+// Failures are stored on the operation and passed to the completion callback
+// instead of failing the dispatch (and with it the loop scope). Workgroups
+// that have not yet started are skipped after the first failure.
+static iree_status_t iree_task_loop_op_workgroup(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  iree_task_loop_op_t* op = (iree_task_loop_op_t*)user_context;
+  if (iree_atomic_load_int32(&op->aborted, iree_memory_order_relaxed) ||
+      iree_atomic_load_intptr(&op->workgroup_status,
+                              iree_memory_order_relaxed)) {
+    return iree_ok_status();
+  }
+  iree_status_t status = op->workgroup_fn(
+      op->callback.user_data, iree_loop_task(op->loop),
+      tile_context->workgroup_xyz[0], tile_context->workgroup_xyz[1],
+      tile_context->workgroup_xyz[2]);
+  if (!iree_status_is_ok(status)) {
+    intptr_t expected = 0;
+    if (!iree_atomic_compare_exchange_strong_intptr(
+            &op->workgroup_status, &expected, (intptr_t)status,
+            iree_memory_order_acq_rel, iree_memory_order_relaxed)) {
+      // Another workgroup failed first; keep its status.
+      iree_status_ignore(status);
+    }
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_task_loop_run_dispatch(
+    iree_task_loop_t* loop, const iree_loop_dispatch_params_t* params) {
+  iree_task_loop_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(iree_task_loop_op_allocate(
+      loop, IREE_LOOP_COMMAND_DISPATCH, params->callback, 0, &op));
+  op->workgroup_fn = params->workgroup_fn;
+  iree_task_loop_op_initialize_completion(op);
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  iree_task_dispatch_initialize(
+      &loop->scope,
+      iree_task_make_dispatch_closure(iree_task_loop_op_workgroup, op),
+      workgroup_size, params->workgroup_count_xyz, &op->tasks.dispatch_task);
+  iree_task_set_completion_task(&op->tasks.dispatch_task.header,
+                                &op->completion_task.header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &op->tasks.dispatch_task.header);
+  iree_task_loop_submit(loop, &submission);
+  return iree_ok_status();
+}
+
+//==============================================================================
+// IREE_LOOP_COMMAND_WAIT_*
+//==============================================================================
+
+// Join task closure for wait-all operations.
+// All waits have resolved (or were cancelled) and the delay can be cancelled.
+// The nudge task readied after this retires wakes the poller to notice.
+static iree_status_t iree_task_loop_op_join(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  iree_task_loop_op_t* op = (iree_task_loop_op_t*)user_context;
+  iree_atomic_store_int32(&op->cancellation_flag, 1, iree_memory_order_release);
+  return iree_ok_status();
+}
+
+// Issues a wait operation on |wait_sources| until |deadline_ns|.
+// |wait_count| is 0 for WAIT_UNTIL.
+static iree_status_t iree_task_loop_run_wait(
+    iree_task_loop_t* loop, iree_loop_command_t command,
+    iree_loop_callback_t callback, iree_time_t deadline_ns,
+    iree_host_size_t wait_count, iree_wait_source_t* wait_sources) {
+  iree_task_loop_op_t* op = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_task_loop_op_allocate(loop, command, callback, wait_count, &op));
+  if (command == IREE_LOOP_COMMAND_WAIT_ONE) {
+    op->wait_source = wait_sources[0];
+    op->wait_sources = &op->wait_source;
+  } else {
+    op->wait_sources = wait_sources;
+  }
+  iree_task_loop_op_initialize_completion(op);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+
+  const bool wait_all = command == IREE_LOOP_COMMAND_WAIT_ALL;
+  const bool has_delay = deadline_ns != IREE_TIME_INFINITE_FUTURE ||
+                         command == IREE_LOOP_COMMAND_WAIT_UNTIL;
+  if (has_delay) {
+    iree_task_wait_t* delay_task = &op->tasks.wait.delay_task;
+    iree_task_wait_initialize_delay(&loop->scope, deadline_ns, delay_task);
+    if (command == IREE_LOOP_COMMAND_WAIT_UNTIL) {
+      // Only cancelled by aborts.
+      delay_task->cancellation_flag = &op->cancellation_flag;
+    } else {
+      // Reaching the deadline cancels all waits.
+      iree_task_wait_set_wait_any(delay_task, &op->cancellation_flag);
+    }
+    iree_task_set_completion_task(&delay_task->header,
+                                  &op->completion_task.header);
+    iree_task_submission_enqueue(&submission, &delay_task->header);
+  }
+
+  // Wait-all with a deadline joins all waits in order to cancel the delay.
+  iree_task_t* wait_target = &op->completion_task.header;
+  if (wait_all && has_delay && wait_count > 0) {
+    iree_task_call_t* join_task = &op->tasks.wait.join_task;
+    iree_task_wait_t* nudge_task = &op->tasks.wait.nudge_task;
+    iree_task_call_initialize(
+        &loop->scope, iree_task_make_call_closure(iree_task_loop_op_join, op),
+        join_task);
+    iree_task_wait_initialize(&loop->scope, iree_wait_source_immediate(),
+                              IREE_TIME_INFINITE_FUTURE, nudge_task);
+    iree_task_set_completion_task(&join_task->header, &nudge_task->header);
+    iree_task_set_completion_task(&nudge_task->header,
+                                  &op->completion_task.header);
+    wait_target = &join_task->header;
+  }
+
+  for (iree_host_size_t i = 0; i < wait_count; ++i) {
+    iree_task_wait_t* wait_task = &op->wait_tasks[i];
+    iree_task_wait_initialize(&loop->scope, op->wait_sources[i],
+                              IREE_TIME_INFINITE_FUTURE, wait_task);
+    if (wait_all) {
+      wait_task->cancellation_flag = &op->cancellation_flag;
+    } else {
+      iree_task_wait_set_wait_any(wait_task, &op->cancellation_flag);
+    }
+    iree_task_set_completion_task(&wait_task->header, wait_target);
+    iree_task_submission_enqueue(&submission, &wait_task->header);
+  }
+
+  if (!has_delay && wait_count == 0) {
+    // Nothing to wait on.
+    iree_task_submission_enqueue(&submission, &op->completion_task.header);
+  }
+
+  iree_task_loop_submit(loop, &submission);
+  return iree_ok_status();
+}
+
+//==============================================================================
+// iree_task_loop_ctl
+//==============================================================================
+
+// Control function for the task executor loop.
+// |self| must be an iree_task_loop_t.
+iree_status_t iree_task_loop_ctl(void* self, iree_loop_command_t command,
+                                 const void* params, void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(self);
+  iree_task_loop_t* loop = (iree_task_loop_t*)self;
+  switch (command) {
+    case IREE_LOOP_COMMAND_CALL:
+      return iree_task_loop_run_call(loop,
+                                     (const iree_loop_call_params_t*)params);
+    case IREE_LOOP_COMMAND_DISPATCH:
+      return iree_task_loop_run_dispatch(
+          loop, (const iree_loop_dispatch_params_t*)params);
+    case IREE_LOOP_COMMAND_WAIT_UNTIL: {
+      const iree_loop_wait_until_params_t* wait_params =
+          (const iree_loop_wait_until_params_t*)params;
+      return iree_task_loop_run_wait(loop, command, wait_params->callback,
+                                     wait_params->deadline_ns, 0, NULL);
+    }
+    case IREE_LOOP_COMMAND_WAIT_ONE: {
+      const iree_loop_wait_one_params_t* wait_params =
+          (const iree_loop_wait_one_params_t*)params;
+      iree_wait_source_t wait_source = wait_params->wait_source;
+      return iree_task_loop_run_wait(loop, command, wait_params->callback,
+                                     wait_params->deadline_ns, 1,
+                                     &wait_source);
+    }
+    case IREE_LOOP_COMMAND_WAIT_ANY:
+    case IREE_LOOP_COMMAND_WAIT_ALL: {
+      const iree_loop_wait_multi_params_t* wait_params =
+          (const iree_loop_wait_multi_params_t*)params;
+      return iree_task_loop_run_wait(
+          loop, command, wait_params->callback, wait_params->deadline_ns,
+          wait_params->count, wait_params->wait_sources);
+    }
+    case IREE_LOOP_COMMAND_DRAIN:
+      return iree_task_loop_wait_idle(
+          loop, iree_make_deadline(
+                    ((const iree_loop_drain_params_t*)params)->deadline_ns));
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unimplemented loop command");
+  }
+}
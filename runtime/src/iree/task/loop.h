@@ -0,0 +1,92 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_TASK_LOOP_H_
+#define IREE_TASK_LOOP_H_
+
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//==============================================================================
+// iree_task_loop_t
+//==============================================================================
+
+// Handles errors returned from loop callback operations.
+// Ownership of |status| is passed to the handler and must be freed.
+// May be called concurrently from any executor worker.
+typedef void(IREE_API_PTR* iree_task_loop_error_fn_t)(void* user_data,
+                                                      iree_status_t status);
+
+// Configuration options for the task executor loop implementation.
+typedef struct iree_task_loop_options_t {
+  // Flags for the task scope all loop operations are issued against.
+  // IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY can be used to have workers prefer the
+  // loop operations over other work sharing the executor.
+  iree_task_scope_flags_t scope_flags;
+
+  // Optional function used to report errors returned from callbacks.
+  iree_task_loop_error_fn_t error_fn;
+  void* error_user_data;
+} iree_task_loop_options_t;
+
+// Initializes |out_options| to their default values.
+void iree_task_loop_options_initialize(iree_task_loop_options_t* out_options);
+
+// A loop that issues all operations as tasks on a shared task executor.
+// Calls and dispatch workgroups run on executor workers and waits are handled
+// by the executor poller such that no thread is blocked while an operation
+// waits. Many loops can share the same executor allowing one process to run
+// many concurrent asynchronous invocations without a thread per invocation.
+//
+// Callbacks may be issued concurrently from any worker and must not block.
+// When a callback returns an error the error is routed to the error handler
+// provided in the options and all other operations pending in the loop at the
+// time are aborted (their callbacks receive IREE_STATUS_ABORTED). Operations
+// enqueued after the failure run as normal.
+//
+// Thread-safe: operations may be enqueued from any thread.
+typedef struct iree_task_loop_t iree_task_loop_t;
+
+// Allocates a loop scheduling its operations on |executor|.
+// The executor is retained by the loop until it is freed.
+iree_status_t iree_task_loop_allocate(iree_task_loop_options_t options,
+                                      iree_task_executor_t* executor,
+                                      iree_allocator_t allocator,
+                                      iree_task_loop_t** out_loop);
+
+// Frees |loop| after aborting all pending operations and waiting for their
+// callbacks to be issued. Must not be called from a loop callback.
+void iree_task_loop_free(iree_task_loop_t* loop);
+
+// Waits until the loop is idle (all operations have retired).
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if |timeout| is reached before the
+// loop is idle. Must not be called from a loop callback as the callback itself
+// keeps the loop from becoming idle.
+iree_status_t iree_task_loop_wait_idle(iree_task_loop_t* loop,
+                                       iree_timeout_t timeout);
+
+iree_status_t iree_task_loop_ctl(void* self, iree_loop_command_t command,
+                                 const void* params, void** inout_ptr);
+
+// Returns a loop that schedules operations against |loop|.
+static inline iree_loop_t iree_loop_task(iree_task_loop_t* loop) {
+  iree_loop_t result = {
+      loop,
+      iree_task_loop_ctl,
+  };
+  return result;
+}
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TASK_LOOP_H_
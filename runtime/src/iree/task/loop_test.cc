@@ -0,0 +1,118 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/task/loop.h"
+
+#include <atomic>
+
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+#include "iree/task/topology.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+// Contains the test definitions applied to all loop implementations:
+#include "iree/base/loop_test.h"
+
+// Executor shared by the loop of the current test.
+static iree_task_executor_t* executor = NULL;
+static iree_task_loop_t* task_loop = NULL;
+
+// Stores the last error reported by the loop in the test loop_status.
+static void StoreLoopError(void* user_data, iree_status_t status) {
+  iree_status_t* out_status = (iree_status_t*)user_data;
+  iree_status_ignore(*out_status);
+  *out_status = status;
+}
+
+void AllocateLoop(iree_status_t* out_status, iree_allocator_t allocator,
+                  iree_loop_t* out_loop) {
+  iree_task_executor_options_t executor_options;
+  iree_task_executor_options_initialize(&executor_options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(4, &topology);
+  IREE_CHECK_OK(iree_task_executor_create(executor_options, &topology,
+                                          allocator, &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_loop_options_t options;
+  iree_task_loop_options_initialize(&options);
+  options.error_fn = StoreLoopError;
+  options.error_user_data = out_status;
+  IREE_CHECK_OK(
+      iree_task_loop_allocate(options, executor, allocator, &task_loop));
+  *out_loop = iree_loop_task(task_loop);
+}
+
+void FreeLoop(iree_allocator_t allocator, iree_loop_t loop) {
+  iree_task_loop_free(task_loop);
+  task_loop = NULL;
+  iree_task_executor_release(executor);
+  executor = NULL;
+}
+
+namespace iree {
+namespace testing {
+
+// Tests that many independent call chains make progress concurrently on the
+// executor without a thread per chain.
+TEST_F(LoopTest, ConcurrentCallChains) {
+  IREE_TRACE_SCOPE();
+  static constexpr int kChainCount = 64;
+  static constexpr int kChainLength = 32;
+  struct ChainData {
+    int remaining = kChainLength;
+    std::atomic<int>* completed_count = nullptr;
+  };
+  static const iree_loop_callback_fn_t chain_fn =
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_EXPECT_OK(status);
+        auto* chain = reinterpret_cast<ChainData*>(user_data_ptr);
+        if (--chain->remaining > 0) {
+          return iree_loop_call(loop, IREE_LOOP_PRIORITY_DEFAULT, chain_fn,
+                                chain);
+        }
+        ++*chain->completed_count;
+        return iree_ok_status();
+      };
+  std::atomic<int> completed_count = {0};
+  ChainData chains[kChainCount];
+  for (auto& chain : chains) {
+    chain.completed_count = &completed_count;
+    IREE_ASSERT_OK(
+        iree_loop_call(loop, IREE_LOOP_PRIORITY_DEFAULT, chain_fn, &chain));
+  }
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+  IREE_ASSERT_OK(loop_status);
+  EXPECT_EQ(completed_count, kChainCount);
+}
+
+// Tests that a wait blocked on an unresolved source is aborted when the loop is
+// freed.
+TEST_F(LoopTest, FreeAbortsPendingWaits) {
+  IREE_TRACE_SCOPE();
+  iree_event_t event;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &event));
+  struct UserData {
+    bool did_wait_callback = false;
+  } user_data;
+  IREE_ASSERT_OK(iree_loop_wait_one(
+      loop, iree_event_await(&event), iree_infinite_timeout(),
+      +[](void* user_data_ptr, iree_loop_t loop, iree_status_t status) {
+        IREE_EXPECT_STATUS_IS(IREE_STATUS_ABORTED, status);
+        auto* user_data = reinterpret_cast<UserData*>(user_data_ptr);
+        user_data->did_wait_callback = true;
+        return iree_ok_status();
+      },
+      &user_data));
+  iree_task_loop_free(task_loop);
+  task_loop = NULL;
+  EXPECT_TRUE(user_data.did_wait_callback);
+  iree_event_deinitialize(&event);
+}
+
+}  // namespace testing
+}  // namespace iree
@@ -17,6 +17,7 @@ static int iree_task_poller_main(iree_task_poller_t* poller);
 iree_status_t iree_task_poller_initialize(
     iree_task_executor_t* executor,
     iree_thread_affinity_t ideal_thread_affinity,
+    iree_thread_priority_class_t priority_class,
     iree_task_poller_t* out_poller) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -41,9 +42,10 @@ iree_status_t iree_task_poller_initialize(
       &out_poller->wake_event);
 
   // Wait set used to batch syscalls for polling/waiting on wait handles.
-  // This is currently limited to a relatively small max to make bad behavior
-  // clearer with nice RESOURCE_EXHAUSTED errors. If we start to hit that limit
-  // (~63+ simultaneous system waits) we'll need to shard out the wait sets -
+  // The epoll-based set on Linux/Android grows as needed and the capacity is
+  // only the initial size. Other implementations are limited to it and will
+  // fail with RESOURCE_EXHAUSTED; if we start to hit that limit (~63+
+  // simultaneous system waits) we'll need to shard out the wait sets there -
   // possibly with multiple wait threads (one per set).
   if (iree_status_is_ok(status)) {
     status = iree_wait_set_allocate(IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS,
@@ -57,10 +59,10 @@ iree_status_t iree_task_poller_initialize(
   memset(&thread_params, 0, sizeof(thread_params));
   thread_params.name = iree_make_cstring_view("iree-poller");
   thread_params.create_suspended = false;
-  // TODO(benvanik): make high so to reduce latency? The sooner we wake the
-  // sooner we get ready tasks back in the execution queue, though we don't
-  // want to preempt any of the workers.
-  thread_params.priority_class = IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  // Raising the priority reduces latency as the sooner we wake the sooner we
+  // get ready tasks back in the execution queue, though unless pinned away
+  // from them it may preempt the workers.
+  thread_params.priority_class = priority_class;
   thread_params.initial_affinity = out_poller->ideal_thread_affinity;
 
   // NOTE: if the thread creation fails we'll bail here and let the caller
@@ -272,17 +274,22 @@ static iree_task_poller_prepare_result_t iree_task_poller_prepare_task(
     if (task->deadline_ns <= now_ns) {
       wait_status_code = IREE_STATUS_DEADLINE_EXCEEDED;
     } else {
-      // Query the status of the wait source to see if it has already been
-      // resolved. Under load we can get lucky and end up with resolved waits
-      // before ever needing to export them for a full system wait. This query
-      // can also avoid making a syscall to check the state of the source such
-      // as when the source is a process-local type.
-      wait_status_code = IREE_STATUS_OK;
-      status = iree_wait_source_query(task->wait_source, &wait_status_code);
-
-      // TODO(benvanik): avoid this query for wait handles: we don't want to
-      // make one syscall per handle and could rely on the completed bit being
-      // set to retire these.
+      if (iree_all_bits_set(task->header.flags,
+                             IREE_TASK_FLAG_WAIT_EXPORTED) &&
+          iree_wait_handle_from_source(&task->wait_source)) {
+        // The wait handle is in the wait set and iree_task_poller_wake_task
+        // will set the completed bit when the system wait reports it. Querying
+        // here would be one syscall per outstanding wait on every pump.
+        wait_status_code = IREE_STATUS_DEFERRED;
+      } else {
+        // Query the status of the wait source to see if it has already been
+        // resolved. Under load we can get lucky and end up with resolved waits
+        // before ever needing to export them for a full system wait. This
+        // query can also avoid making a syscall to check the state of the
+        // source such as when the source is a process-local type.
+        wait_status_code = IREE_STATUS_OK;
+        status = iree_wait_source_query(task->wait_source, &wait_status_code);
+      }
     }
 
     // If the wait has not been resolved then we need to ensure there's an
@@ -412,14 +419,25 @@ static void iree_task_poller_wake_task(iree_task_poller_t* poller,
                                        iree_wait_handle_t wake_handle) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // TODO(benvanik): scan the list. We need a way to map wake_handle back to
-  // the zero or more tasks that match it but don't currently store the
-  // handle. Ideally we'd have the wait set tell us precisely which things
-  // woke - possibly by having a bitmap of original insertions that match the
-  // handle - but for now we just eat the extra query syscall.
+  // Multiple tasks may be waiting on the same handle and all of them are
+  // marked. The scan only touches memory: the next prepare will retire the
+  // marked tasks without querying their wait sources.
   int woken_tasks = 0;
+  for (iree_task_t* task = iree_task_list_front(&poller->wait_list);
+       task != NULL; task = task->next_task) {
+    if (!iree_all_bits_set(task->flags, IREE_TASK_FLAG_WAIT_EXPORTED)) {
+      continue;
+    }
+    iree_wait_handle_t* wait_handle =
+        iree_wait_handle_from_source(&((iree_task_wait_t*)task)->wait_source);
+    if (wait_handle && wait_handle->type == wake_handle.type &&
+        memcmp(&wait_handle->value, &wake_handle.value,
+               sizeof(wake_handle.value)) == 0) {
+      task->flags |= IREE_TASK_FLAG_WAIT_COMPLETED;
+      ++woken_tasks;
+    }
+  }
 
-  (void)woken_tasks;
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, woken_tasks);
   IREE_TRACE_ZONE_END(z0);
 }
@@ -443,12 +461,12 @@ static void iree_task_poller_commit_wait(iree_task_poller_t* poller,
       iree_wait_any(poller->wait_set, deadline_ns, &wake_handle);
   if (iree_status_is_ok(status)) {
     // One or more waiters is ready. We don't support multi-wake right now so
-    // we'll just take the one we got back and try again.
+    // we'll just take the one we got back and try again; the wait set will
+    // report any others that are ready on the next wait.
     //
     // To avoid extra syscalls we scan the list and mark whatever tasks were
     // using the handle the wait set reported waking as completed. On the next
-    // scan they'll be retired immediately. Ideally we'd have the wait set be
-    // able to tell us this precise list.
+    // scan they'll be retired immediately without being queried.
     if (iree_wait_handle_is_immediate(wake_handle)) {
       // No-op wait - ignore.
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "nop");
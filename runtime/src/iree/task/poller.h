@@ -106,9 +106,12 @@ typedef struct {
 
 // Initializes |out_poller| with a new poller.
 // |executor| will be used to submit woken tasks for processing.
+// The poller thread is created with |priority_class| and pinned to
+// |ideal_thread_affinity| when specified.
 iree_status_t iree_task_poller_initialize(
     iree_task_executor_t* executor,
     iree_thread_affinity_t ideal_thread_affinity,
+    iree_thread_priority_class_t priority_class,
     iree_task_poller_t* out_poller);
 
 // Requests that the poller wait thread begin exiting (if it hasn't already).
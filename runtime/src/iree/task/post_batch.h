@@ -37,12 +37,21 @@ typedef struct iree_task_post_batch_t {
 
   // A bitmask of workers indicating which have pending tasks in their lists.
   // Used to quickly scan the lists and perform the posts only when required.
-  iree_task_affinity_set_t worker_pending_mask;
+  iree_task_worker_set_t worker_pending_mask;
 
-  // A per-worker LIFO task list waiting to be posted.
+  // Per-worker LIFO task lists waiting to be posted. The first worker_count
+  // lists contain normal tasks and the following worker_count lists contain
+  // tasks from IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY scopes.
   iree_task_list_t worker_pending_lifos[0];
 } iree_task_post_batch_t;
 
+// Returns the total size in bytes of a post batch for |worker_count| workers.
+static inline iree_host_size_t iree_task_post_batch_size(
+    iree_host_size_t worker_count) {
+  return sizeof(iree_task_post_batch_t) +
+         2 * worker_count * sizeof(iree_task_list_t);
+}
+
 void iree_task_post_batch_initialize(iree_task_executor_t* executor,
                                      iree_task_worker_t* current_worker,
                                      iree_task_post_batch_t* out_post_batch);
@@ -51,6 +60,10 @@ void iree_task_post_batch_initialize(iree_task_executor_t* executor,
 iree_host_size_t iree_task_post_batch_worker_count(
     const iree_task_post_batch_t* post_batch);
 
+// Returns the scheduling mode of the executor the post batch is targeting.
+iree_task_scheduling_mode_t iree_task_post_batch_scheduling_mode(
+    const iree_task_post_batch_t* post_batch);
+
 // Selects a random worker from the given affinity set.
 iree_host_size_t iree_task_post_batch_select_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set);
@@ -19,7 +19,9 @@ extern "C" {
 #endif  // __cplusplus
 
 // A simple work-stealing LIFO queue modeled on a Chase-Lev concurrent deque.
-// This is used by workers to maintain their thread-local working lists. The
+// Workers now use the lock-free iree_task_deque_t for their thread-local
+// working lists; this unbounded variant is kept for comparison (see
+// deque_benchmark.c) and for uses that cannot tolerate a bounded queue. The
 // workers keep the tasks they will process in FIFO order. They allow it to
 // empty and then refresh it with more tasks from the incoming worker mailbox.
 // The performance bias here is to the workers as they are >90% of the
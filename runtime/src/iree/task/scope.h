@@ -25,6 +25,12 @@ enum iree_task_scope_flag_bits_e {
   // Hosting applications should properly handle the errors by retrieving the
   // failure status from the appropriate query or wait primitive.
   IREE_TASK_SCOPE_FLAG_ABORT_ON_FAILURE = 1u << 0,
+  // Tasks within the scope are preferred by workers over tasks from scopes
+  // without the flag. Use for latency-sensitive work (such as interactive
+  // requests) sharing an executor with throughput-oriented batch work.
+  // Tasks that have already begun executing are not preempted: a worker in the
+  // middle of a dispatch shard completes it before picking up priority work.
+  IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY = 1u << 1,
 };
 typedef uint32_t iree_task_scope_flags_t;
 
@@ -17,6 +17,34 @@
 #include "iree/task/task_impl.h"
 #include "iree/task/tuning.h"
 
+//==============================================================================
+// Runtime metrics
+//==============================================================================
+
+IREE_METRIC_COUNTER_DEFINE(iree_task_metric_dispatches,
+                           "iree_task_dispatches_total",
+                           "Total number of dispatches retired.");
+IREE_METRIC_COUNTER_DEFINE(iree_task_metric_dispatch_tiles,
+                           "iree_task_dispatch_tiles_total",
+                           "Total number of dispatch tiles executed.");
+IREE_METRIC_COUNTER_DEFINE(
+    iree_task_metric_local_steals, "iree_task_local_steals_total",
+    "Total number of tasks stolen from workers sharing caches.");
+IREE_METRIC_COUNTER_DEFINE(
+    iree_task_metric_remote_steals, "iree_task_remote_steals_total",
+    "Total number of tasks stolen from workers not sharing caches.");
+IREE_METRIC_HISTOGRAM_DEFINE(
+    iree_task_metric_worker_queue_depth, "iree_task_worker_queue_depth",
+    "Worker local queue depth when incoming work is accepted.");
+
+void iree_task_register_metrics(void) {
+  iree_metric_register(&iree_task_metric_dispatches.base);
+  iree_metric_register(&iree_task_metric_dispatch_tiles.base);
+  iree_metric_register(&iree_task_metric_local_steals.base);
+  iree_metric_register(&iree_task_metric_remote_steals.base);
+  iree_metric_register(&iree_task_metric_worker_queue_depth.base);
+}
+
 //==============================================================================
 // Task bookkeeping
 //==============================================================================
@@ -242,6 +270,13 @@ void iree_task_call_initialize(iree_task_scope_t* scope,
   iree_atomic_store_intptr(&out_task->status, 0, iree_memory_order_release);
 }
 
+void iree_task_call_fail(iree_task_call_t* task, iree_status_t status) {
+  iree_task_try_set_status(&task->status, status);
+  // As with iree_task_retire marking completion tasks we only ever add bits
+  // here and the task is not yet running.
+  task->header.flags |= IREE_TASK_FLAG_ABORTED;
+}
+
 void iree_task_call_execute(iree_task_call_t* task,
                             iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -559,6 +594,15 @@ void iree_task_dispatch_initialize_indirect(
   out_task->workgroup_count.ptr = workgroup_count_ptr;
 }
 
+// Returns the first tile index of slice |slice_index| in a grid of |tile_count|
+// tiles partitioned into |slice_count| slices. Passing |slice_count| as the
+// slice index returns |tile_count|.
+static inline uint32_t iree_task_dispatch_slice_base(uint32_t tile_count,
+                                                     uint32_t slice_count,
+                                                     uint32_t slice_index) {
+  return (uint32_t)(((uint64_t)tile_count * slice_index) / slice_count);
+}
+
 void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
                               iree_task_pool_t* shard_task_pool,
                               iree_task_submission_t* pending_submission,
@@ -575,9 +619,8 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
     // By the task being ready to execute we know any dependencies on the
     // indirection buffer have been satisfied and its safe to read. We perform
     // the indirection here and convert the dispatch to a direct one such that
-    // following code can read the value.
-    // TODO(benvanik): non-one-shot command buffers won't be able to do this as
-    // the intent is that they can be dynamic per execution.
+    // following code can read the value. Reusable command buffers restore the
+    // indirection pointer before each execution.
     const uint32_t* source_ptr = dispatch_task->workgroup_count.ptr;
     memcpy(dispatch_task->workgroup_count.value, source_ptr,
            sizeof(dispatch_task->workgroup_count.value));
@@ -620,15 +663,36 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
         IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
   }
 
-  // Randomize starting worker.
-  iree_host_size_t worker_offset = iree_task_post_batch_select_worker(
-      post_batch, dispatch_task->header.affinity_set);
-  iree_host_size_t worker_index = worker_offset;
+  // Pick which workers the shards are sent to. When preserving locality the
+  // tile grid is partitioned into slices that are always processed by the same
+  // workers so that consecutive dispatches over the same data hit warm caches.
+  // Otherwise we randomize the starting worker to spread the load.
+  iree_host_size_t worker_index = 0;
+  dispatch_task->slice_count = 0;
+  if (iree_all_bits_set(iree_task_post_batch_scheduling_mode(post_batch),
+                        IREE_TASK_SCHEDULING_MODE_DISPATCH_LOCALITY) &&
+      shard_count > 0) {
+    const uint32_t slice_count = (uint32_t)iree_min(
+        shard_count, IREE_TASK_DISPATCH_MAX_LOCALITY_SLICES);
+    for (uint32_t i = 0; i < slice_count; ++i) {
+      iree_atomic_store_int32(
+          &dispatch_task->slice_tile_index[i],
+          iree_task_dispatch_slice_base(dispatch_task->tile_count, slice_count,
+                                        i),
+          iree_memory_order_relaxed);
+    }
+    dispatch_task->slice_count = slice_count;
+  } else {
+    worker_index = iree_task_post_batch_select_worker(
+        post_batch, dispatch_task->header.affinity_set);
+  }
 
   for (iree_host_size_t i = 0; i < shard_count; ++i) {
     // Allocate and initialize the shard.
     iree_task_dispatch_shard_t* shard_task =
         iree_task_dispatch_shard_allocate(dispatch_task, shard_task_pool);
+    shard_task->slice_index =
+        (uint32_t)(i * dispatch_task->slice_count / shard_count);
 
     // Enqueue on the worker selected for the task.
     iree_task_post_batch_enqueue(post_batch, worker_index % worker_count,
@@ -662,6 +726,9 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
   iree_task_dispatch_statistics_merge(
       &dispatch_task->statistics,
       &dispatch_task->header.scope->dispatch_statistics);
+  iree_metric_counter_increment(&iree_task_metric_dispatches);
+  iree_metric_counter_add(&iree_task_metric_dispatch_tiles,
+                          dispatch_task->tile_count);
 
   // Consume the status of the dispatch that may have been set from a workgroup
   // and notify the scope. We need to do this here so that each shard retires
@@ -709,9 +776,124 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
   return shard_task;
 }
 
+// Executes the tiles in the range [tile_base, tile_end) of |dispatch_task|.
+// Returns the failure of the first tile that fails, if any, and skips the
+// remaining tiles in the range.
+static iree_status_t iree_task_dispatch_shard_execute_tiles(
+    iree_task_dispatch_t* dispatch_task, uint32_t tile_base, uint32_t tile_end,
+    iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const uint32_t workgroup_count_x = tile_context->workgroup_count[0];
+  const uint32_t workgroup_count_y = tile_context->workgroup_count[1];
+  const bool issue_ranges = iree_all_bits_set(dispatch_task->header.flags,
+                                              IREE_TASK_FLAG_DISPATCH_RANGE);
+  for (uint32_t tile_index = tile_base; tile_index < tile_end;
+       tile_index += tile_context->workgroup_range_x) {
+    // TODO(benvanik): faster math here, especially knowing we pull off N
+    // sequential indices per reservation.
+    uint32_t tile_i = tile_index;
+    tile_context->workgroup_xyz[0] = tile_i % workgroup_count_x;
+    tile_i /= workgroup_count_x;
+    tile_context->workgroup_xyz[1] = tile_i % workgroup_count_y;
+    tile_i /= workgroup_count_y;
+    tile_context->workgroup_xyz[2] = tile_i;
+
+    // Ranges cover the rest of the reservation up to the end of the row.
+    tile_context->workgroup_range_x =
+        issue_ranges
+            ? iree_min(tile_end - tile_index,
+                       workgroup_count_x - tile_context->workgroup_xyz[0])
+            : 1;
+
+    IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
+                                "iree_task_dispatch_shard_execute_tile");
+    IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(tile_context));
+
+#ifndef NDEBUG
+    // NOTE: these are useful for debugging but dramatically increase our
+    // cost here; only enable if needed for tracking work distribution:
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context->workgroup_xyz[0]);
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context->workgroup_xyz[1]);
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context->workgroup_xyz[2]);
+    // IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, (uint64_t)task->closure.fn);
+#endif  // !NDEBUG
+
+    iree_status_t status =
+        dispatch_task->closure.fn(dispatch_task->closure.user_context,
+                                  tile_context, pending_submission);
+
+    IREE_TRACE_ZONE_END(z_tile);
+
+    // If any tile fails we bail early from the loop. This doesn't match
+    // what an accelerator would do but saves some unneeded work.
+    if (!iree_status_is_ok(status)) return status;
+  }
+  return iree_ok_status();
+}
+
+// Reserves and executes tiles from the shared dispatch tile index until all
+// tiles in the grid have been processed.
+static iree_status_t iree_task_dispatch_shard_execute_shared(
+    iree_task_dispatch_t* dispatch_task, iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const uint32_t tile_count = dispatch_task->tile_count;
+  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
+  // relaxed order because we only care about atomic increments, not about
+  // ordering of tile_index accesses w.r.t. other memory accesses.
+  uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
+                                                   tiles_per_reservation,
+                                                   iree_memory_order_relaxed);
+  while (tile_base < tile_count) {
+    const uint32_t tile_end =
+        iree_min(tile_base + tiles_per_reservation, tile_count);
+    IREE_RETURN_IF_ERROR(iree_task_dispatch_shard_execute_tiles(
+        dispatch_task, tile_base, tile_end, tile_context, pending_submission));
+
+    // Try to grab the next slice of tiles.
+    tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
+                                            tiles_per_reservation,
+                                            iree_memory_order_relaxed);
+  }
+  return iree_ok_status();
+}
+
+// Reserves and executes tiles from the slice at |slice_index| until it has been
+// exhausted and then helps with any tiles remaining in the other slices. Other
+// slices are visited in order starting after our own so that helping shards
+// spread out instead of all piling onto the same slice.
+static iree_status_t iree_task_dispatch_shard_execute_slices(
+    iree_task_dispatch_t* dispatch_task, uint32_t slice_index,
+    iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const uint32_t tile_count = dispatch_task->tile_count;
+  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
+  const uint32_t slice_count = dispatch_task->slice_count;
+  for (uint32_t i = 0; i < slice_count; ++i) {
+    const uint32_t slice = (slice_index + i) % slice_count;
+    const uint32_t slice_end =
+        iree_task_dispatch_slice_base(tile_count, slice_count, slice + 1);
+    iree_atomic_int32_t* slice_tile_index =
+        &dispatch_task->slice_tile_index[slice];
+    // relaxed order for the same reasons as the shared tile index.
+    uint32_t tile_base = iree_atomic_fetch_add_int32(
+        slice_tile_index, tiles_per_reservation, iree_memory_order_relaxed);
+    while (tile_base < slice_end) {
+      const uint32_t tile_end =
+          iree_min(tile_base + tiles_per_reservation, slice_end);
+      IREE_RETURN_IF_ERROR(iree_task_dispatch_shard_execute_tiles(
+          dispatch_task, tile_base, tile_end, tile_context,
+          pending_submission));
+      tile_base = iree_atomic_fetch_add_int32(
+          slice_tile_index, tiles_per_reservation, iree_memory_order_relaxed);
+    }
+  }
+  return iree_ok_status();
+}
+
 void iree_task_dispatch_shard_execute(
-    iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
-    uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_task_dispatch_shard_t* task, struct iree_task_executor_t* executor,
+    iree_cpu_processor_id_t processor_id, uint32_t worker_id,
+    iree_byte_span_t worker_local_memory,
     iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -743,9 +925,8 @@ void iree_task_dispatch_shard_execute(
          sizeof(tile_context.workgroup_size));
   memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
          sizeof(tile_context.workgroup_count));
-  uint32_t workgroup_count_x = tile_context.workgroup_count[0];
-  uint32_t workgroup_count_y = tile_context.workgroup_count[1];
   tile_context.worker_id = worker_id;
+  tile_context.executor = executor;
   tile_context.local_memory = worker_local_memory;
 
   // We perform all our shard statistics work locally here and only push back to
@@ -759,65 +940,21 @@ void iree_task_dispatch_shard_execute(
   tile_context.processor_id = processor_id;
 
   // Loop over all tiles until they are all processed.
-  const uint32_t tile_count = dispatch_task->tile_count;
-  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
-  // relaxed order because we only care about atomic increments, not about
-  // ordering of tile_index accesses w.r.t. other memory accesses.
-  uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                                   tiles_per_reservation,
-                                                   iree_memory_order_relaxed);
-  while (tile_base < tile_count) {
-    const uint32_t tile_range =
-        iree_min(tile_base + tiles_per_reservation, tile_count);
-    for (uint32_t tile_index = tile_base; tile_index < tile_range;
-         ++tile_index) {
-      // TODO(benvanik): faster math here, especially knowing we pull off N
-      // sequential indices per reservation.
-      uint32_t tile_i = tile_index;
-      tile_context.workgroup_xyz[0] = tile_i % workgroup_count_x;
-      tile_i /= workgroup_count_x;
-      tile_context.workgroup_xyz[1] = tile_i % workgroup_count_y;
-      tile_i /= workgroup_count_y;
-      tile_context.workgroup_xyz[2] = tile_i;
-
-      IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
-                                  "iree_task_dispatch_shard_execute_tile");
-      IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(&tile_context));
-
-#ifndef NDEBUG
-      // NOTE: these are useful for debugging but dramatically increase our
-      // cost here; only enable if needed for tracking work distribution:
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[0]);
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[1]);
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[2]);
-      // IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, (uint64_t)task->closure.fn);
-#endif  // !NDEBUG
-
-      iree_status_t status =
-          dispatch_task->closure.fn(dispatch_task->closure.user_context,
-                                    &tile_context, pending_submission);
-
-      IREE_TRACE_ZONE_END(z_tile);
-
-      // If any tile fails we bail early from the loop. This doesn't match
-      // what an accelerator would do but saves some unneeded work.
-      // Note that other shards may have completed execution, be executing
-      // concurrently with this one, or still be pending - this does not
-      // have any influence on them and they may continue to execute even
-      // after we bail from here.
-      if (!iree_status_is_ok(status)) {
-        // Propagate failures to the dispatch task.
-        iree_task_try_set_status(&dispatch_task->status, status);
-        goto abort_shard;  // out of the while-for nest
-      }
-    }
-
-    // Try to grab the next slice of tiles.
-    tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                            tiles_per_reservation,
-                                            iree_memory_order_relaxed);
+  iree_status_t status = iree_ok_status();
+  if (dispatch_task->slice_count > 0) {
+    status = iree_task_dispatch_shard_execute_slices(
+        dispatch_task, task->slice_index, &tile_context, pending_submission);
+  } else {
+    status = iree_task_dispatch_shard_execute_shared(
+        dispatch_task, &tile_context, pending_submission);
+  }
+  if (!iree_status_is_ok(status)) {
+    // Propagate failures to the dispatch task.
+    // Note that other shards may have completed execution, be executing
+    // concurrently with this one, or still be pending - this does not have any
+    // influence on them and they may continue to execute even after we bail.
+    iree_task_try_set_status(&dispatch_task->status, status);
   }
-abort_shard:
 
   // Push aggregate statistics up to the dispatch.
   // Note that we may have partial information here if we errored out of the
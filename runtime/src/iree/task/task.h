@@ -17,6 +17,7 @@
 #include "iree/base/internal/cpu.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/task/affinity_set.h"
+#include "iree/task/tuning.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -117,6 +118,12 @@ enum iree_task_flag_bits_t {
   // happens and may be available for querying before all tasks have been
   // cleaned up.
   IREE_TASK_FLAG_ABORTED = 1u << 5,
+
+  // The dispatch closure processes ranges of consecutive workgroups along X
+  // per invocation as specified by iree_task_tile_context_t::workgroup_range_x
+  // instead of a single workgroup. Ranges never span multiple rows of the grid
+  // and are bounded by the number of tiles reserved by a shard at a time.
+  IREE_TASK_FLAG_DISPATCH_RANGE = 1u << 6,
 };
 typedef uint16_t iree_task_flags_t;
 
@@ -297,6 +304,13 @@ void iree_task_call_initialize(iree_task_scope_t* scope,
                                iree_task_call_closure_t closure,
                                iree_task_call_t* out_task);
 
+// Fails a call task that has not yet executed with |status|.
+// The closure will be skipped when the task becomes ready and the task will
+// retire with the failure, failing its scope and aborting its completion task.
+// The caller must hold a dependency on |task| (or not yet have submitted it) so
+// that it cannot begin executing concurrently. Takes ownership of |status|.
+void iree_task_call_fail(iree_task_call_t* task, iree_status_t status);
+
 //==============================================================================
 // IREE_TASK_TYPE_BARRIER
 //==============================================================================
@@ -524,6 +538,10 @@ typedef struct iree_task_tile_storage_t {
 typedef iree_alignas(iree_max_align_t) struct {
   // Workgroup ID for the current invocation.
   uint32_t workgroup_xyz[3];
+  // Number of consecutive workgroups along X starting at |workgroup_xyz| to
+  // process in the invocation. Always 1 unless the dispatch has the
+  // IREE_TASK_FLAG_DISPATCH_RANGE flag set.
+  uint32_t workgroup_range_x;
   // Workgroup size for each invocation.
   uint32_t workgroup_size[3];
   // Total workgroup count for the task. Can be used in conjunction with the
@@ -539,6 +557,10 @@ typedef iree_alignas(iree_max_align_t) struct {
   // Worker that is processing the tile, [0, worker_capacity).
   uint32_t worker_id;
 
+  // Executor owning the worker. Can be used to fork nested work from within
+  // the tile with iree_task_executor_parallel_for.
+  struct iree_task_executor_t* executor;
+
   // Tile-local memory that is pinned to each worker ensuring no cache
   // thrashing. Aligned to at least the natural pointer size of the machine.
   // Contents are (today) undefined upon entry.
@@ -653,6 +675,18 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // per shard instead of once per slice and are less of a concern.
   iree_atomic_int32_t tile_index;
 
+  // Number of slices the tile grid is partitioned into when the dispatch was
+  // issued with IREE_TASK_SCHEDULING_MODE_DISPATCH_LOCALITY or 0 if all shards
+  // reserve tiles from |tile_index|.
+  uint32_t slice_count;
+
+  // The next tile index of each slice when |slice_count| is non-zero.
+  // Slice i covers the tiles [i * tile_count / slice_count,
+  // (i + 1) * tile_count / slice_count) and is processed by the shards posted
+  // to the same workers on every issue. Shards reserve tiles from their own
+  // slice first and only then help with the remaining slices.
+  iree_atomic_int32_t slice_tile_index[IREE_TASK_DISPATCH_MAX_LOCALITY_SLICES];
+
   // Incrementing process-lifetime dispatch identifier.
   IREE_TRACE(int64_t dispatch_id;)
 } iree_task_dispatch_t;
@@ -678,6 +712,10 @@ typedef iree_alignas(iree_max_align_t) struct {
 
   // NOTE: the parent dispatch task this shard is applied to is in the
   // header.completion_task field.
+
+  // Slice of the parent dispatch the shard prefers to process tiles from when
+  // the dispatch is partitioned into slices. Unused otherwise.
+  uint32_t slice_index;
 } iree_task_dispatch_shard_t;
 
 void iree_task_dispatch_shard_initialize(iree_task_dispatch_t* dispatch_task,
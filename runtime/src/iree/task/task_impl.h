@@ -7,6 +7,7 @@
 #ifndef IREE_TASK_TASK_IMPL_H_
 #define IREE_TASK_TASK_IMPL_H_
 
+#include "iree/base/metrics.h"
 #include "iree/task/list.h"
 #include "iree/task/pool.h"
 #include "iree/task/post_batch.h"
@@ -17,6 +18,24 @@
 extern "C" {
 #endif
 
+//==============================================================================
+// Runtime metrics
+//==============================================================================
+
+// Total number of dispatches retired.
+extern iree_metric_counter_t iree_task_metric_dispatches;
+// Total number of dispatch tiles (workgroups) executed.
+extern iree_metric_counter_t iree_task_metric_dispatch_tiles;
+// Total number of successful steals from workers sharing caches with the thief.
+extern iree_metric_counter_t iree_task_metric_local_steals;
+// Total number of successful steals from workers not sharing caches.
+extern iree_metric_counter_t iree_task_metric_remote_steals;
+// Worker local queue depth sampled each time a mailbox flush yields work.
+extern iree_metric_histogram_t iree_task_metric_worker_queue_depth;
+
+// Registers all task system metrics. Called when an executor is created.
+void iree_task_register_metrics(void);
+
 //==============================================================================
 // IREE_TASK_TYPE_NOP
 //==============================================================================
@@ -121,8 +140,9 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 // Errors are propagated to the parent scope and the dispatch will fail once
 // all shards have completed.
 void iree_task_dispatch_shard_execute(
-    iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
-    uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    iree_task_dispatch_shard_t* task, struct iree_task_executor_t* executor,
+    iree_cpu_processor_id_t processor_id, uint32_t worker_id,
+    iree_byte_span_t worker_local_memory,
     iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
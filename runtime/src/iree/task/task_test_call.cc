@@ -177,6 +177,80 @@ TEST_F(TaskCallTest, IssueFailureChained) {
               StatusIs(StatusCode::kUnauthenticated));
 }
 
+// Tests failing a call before it executes, as when a dependency it was waiting
+// on fails. The call should be skipped, the failure propagated back on the task
+// scope, and the chained call aborted.
+TEST_F(TaskCallTest, FailBeforeIssue) {
+  IREE_TRACE_SCOPE();
+
+  struct TestCtx {
+    int did_call_a = 0;
+    int did_call_b = 0;
+  };
+  TestCtx ctx;
+
+  // First call that will be failed before it runs.
+  iree_task_call_t task_a;
+  iree_task_call_initialize(&scope_,
+                            iree_task_make_call_closure(
+                                [](void* user_context, iree_task_t* task,
+                                   iree_task_submission_t* pending_submission) {
+                                  // This should never get called!
+                                  IREE_TRACE_SCOPE();
+                                  auto* ctx = (TestCtx*)user_context;
+                                  ++ctx->did_call_a;
+                                  return iree_ok_status();
+                                },
+                                (void*)&ctx),
+                            &task_a);
+  static int did_cleanup_a = 0;
+  did_cleanup_a = 0;
+  iree_task_set_cleanup_fn(
+      &task_a.header, +[](iree_task_t* task, iree_status_code_t status_code) {
+        IREE_TRACE_SCOPE();
+        EXPECT_EQ(status_code, IREE_STATUS_ABORTED);
+        ++did_cleanup_a;
+      });
+
+  // Second call that will be aborted after the first fails.
+  iree_task_call_t task_b;
+  iree_task_call_initialize(&scope_,
+                            iree_task_make_call_closure(
+                                [](void* user_context, iree_task_t* task,
+                                   iree_task_submission_t* pending_submission) {
+                                  // This should never get called!
+                                  IREE_TRACE_SCOPE();
+                                  auto* ctx = (TestCtx*)user_context;
+                                  ++ctx->did_call_b;
+                                  return iree_ok_status();
+                                },
+                                (void*)&ctx),
+                            &task_b);
+  static int did_cleanup_b = 0;
+  did_cleanup_b = 0;
+  iree_task_set_cleanup_fn(
+      &task_b.header, +[](iree_task_t* task, iree_status_code_t status_code) {
+        IREE_TRACE_SCOPE();
+        EXPECT_EQ(status_code, IREE_STATUS_ABORTED);
+        ++did_cleanup_b;
+      });
+
+  // A -> B
+  iree_task_set_completion_task(&task_a.header, &task_b.header);
+
+  iree_task_call_fail(&task_a,
+                      iree_make_status(IREE_STATUS_DATA_LOSS, "whoops!"));
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task_a.header, &task_b.header));
+
+  // Expect that neither call was made and both were cleaned up.
+  EXPECT_EQ(0, ctx.did_call_a);
+  EXPECT_EQ(1, did_cleanup_a);
+  EXPECT_EQ(0, ctx.did_call_b);
+  EXPECT_EQ(1, did_cleanup_b);
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&scope_)),
+              StatusIs(StatusCode::kDataLoss));
+}
+
 // Issues task_a which then issues a nested task_b and waits for it to complete
 // prior to progressing. This models dynamic parallelism:
 // http://developer.download.nvidia.com/GTC/PDF/GTC2012/PresentationPDF/S0338-GTC2012-CUDA-Programming-Model.pdf
@@ -47,13 +47,20 @@ class GridCoverage {
                             const iree_task_tile_context_t* tile_context,
                             iree_task_submission_t* pending_submission) {
     GridCoverage* coverage = reinterpret_cast<GridCoverage*>(user_context);
+    if (tile_context->workgroup_xyz[0] + tile_context->workgroup_range_x >
+        tile_context->workgroup_count[0]) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "workgroup range spans multiple rows");
+    }
     uint32_t slot =
         tile_context->workgroup_xyz[2] * (tile_context->workgroup_count[1] *
                                           tile_context->workgroup_count[0]) +
         tile_context->workgroup_xyz[1] * tile_context->workgroup_count[0] +
         tile_context->workgroup_xyz[0];
-    iree_atomic_fetch_add_int32(&coverage->storage_[slot], 1,
-                                iree_memory_order_seq_cst);
+    for (uint32_t i = 0; i < tile_context->workgroup_range_x; ++i) {
+      iree_atomic_fetch_add_int32(&coverage->storage_[slot + i], 1,
+                                  iree_memory_order_seq_cst);
+    }
 
     // Useful when testing large grids:
     // printf("%u, %u, %u\n", tile_context->workgroup_xyz[0],
@@ -113,6 +120,16 @@ TEST_F(TaskDispatchTest, Issue345) {
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
+// Large enough for multi-tile reservations with rows that are not a multiple
+// of the reservation size.
+TEST_F(TaskDispatchTest, IssueRange) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {37, 11, 3};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                        IREE_TASK_FLAG_DISPATCH_RANGE);
+}
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   IREE_TRACE_SCOPE();
 
@@ -214,4 +231,74 @@ TEST_F(TaskDispatchTest, IssueFailureChained) {
               StatusIs(StatusCode::kDataLoss));
 }
 
+// Dispatches issued by an executor preserving locality across dispatches.
+class TaskDispatchLocalityTest : public TaskDispatchTest {
+ protected:
+  TaskDispatchLocalityTest() {
+    scheduling_mode_ = IREE_TASK_SCHEDULING_MODE_DISPATCH_LOCALITY;
+  }
+};
+
+TEST_F(TaskDispatchLocalityTest, Issue000) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {0, 0, 0};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+}
+
+TEST_F(TaskDispatchLocalityTest, Issue111) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {1, 1, 1};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+}
+
+TEST_F(TaskDispatchLocalityTest, Issue345) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {3, 4, 5};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+}
+
+// Large enough for multi-tile reservations and not evenly divisible across the
+// slices.
+TEST_F(TaskDispatchLocalityTest, IssueUneven) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {37, 11, 3};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+}
+
+TEST_F(TaskDispatchLocalityTest, IssueRange) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {37, 11, 3};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                        IREE_TASK_FLAG_DISPATCH_RANGE);
+}
+
+TEST_F(TaskDispatchLocalityTest, IssueFailure) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {64, 1, 1};
+
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    IREE_TRACE_SCOPE();
+    return tile_context->workgroup_xyz[0] == 32
+               ? iree_make_status(IREE_STATUS_DATA_LOSS, "whoops!")
+               : iree_ok_status();
+  };
+
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(&scope_,
+                                iree_task_make_dispatch_closure(tile, NULL),
+                                kWorkgroupSize, kWorkgroupCount, &task);
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&scope_)),
+              StatusIs(StatusCode::kDataLoss));
+}
+
 }  // namespace
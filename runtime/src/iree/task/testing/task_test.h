@@ -25,6 +25,7 @@ class TaskTest : public ::testing::Test {
     iree_task_executor_options_t options;
     options.worker_local_memory_size = 64 * 1024;
     iree_task_executor_options_initialize(&options);
+    options.scheduling_mode = scheduling_mode_;
     iree_task_topology_t topology;
     iree_task_topology_initialize_from_group_count(8, &topology);
     IREE_ASSERT_OK(iree_task_executor_create(
@@ -72,6 +73,10 @@ class TaskTest : public ::testing::Test {
     return iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE);
   }
 
+  // Scheduling mode of the executor created during SetUp.
+  iree_task_scheduling_mode_t scheduling_mode_ =
+      IREE_TASK_SCHEDULING_MODE_RESERVED;
+
   iree_task_executor_t* executor_ = NULL;
   iree_task_scope_t scope_;
 };
@@ -17,8 +17,10 @@ void iree_task_topology_group_initialize(
   out_group->group_index = group_index;
   snprintf(out_group->name, IREE_ARRAYSIZE(out_group->name), "iree-worker-%u",
            group_index);
+  out_group->node_id = IREE_TASK_TOPOLOGY_NODE_ID_ANY;
   iree_thread_affinity_set_any(&out_group->ideal_thread_affinity);
-  out_group->constructive_sharing_mask = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
+  iree_task_worker_set_fill(&out_group->constructive_sharing_mask,
+                            IREE_TASK_WORKER_SET_BIT_COUNT);
 }
 
 void iree_task_topology_initialize(iree_task_topology_t* out_topology) {
@@ -30,6 +32,18 @@ void iree_task_topology_deinitialize(iree_task_topology_t* topology) {
   IREE_ASSERT_ARGUMENT(topology);
 }
 
+iree_task_topology_node_id_t iree_task_topology_node_id(
+    const iree_task_topology_t* topology) {
+  if (topology->group_count == 0) return IREE_TASK_TOPOLOGY_NODE_ID_ANY;
+  iree_task_topology_node_id_t node_id = topology->groups[0].node_id;
+  for (iree_host_size_t i = 1; i < topology->group_count; ++i) {
+    if (topology->groups[i].node_id != node_id) {
+      return IREE_TASK_TOPOLOGY_NODE_ID_ANY;
+    }
+  }
+  return node_id;
+}
+
 iree_status_t iree_task_topology_parse(iree_string_view_t value,
                                        iree_task_topology_t* out_topology) {
   // TODO(benvanik): define a format that is generally useful alongside cpuinfo.
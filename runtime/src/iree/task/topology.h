@@ -13,6 +13,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/threading.h"
+#include "iree/task/affinity_set.h"
 #include "iree/task/tuning.h"
 
 #ifdef __cplusplus
@@ -43,11 +44,12 @@ iree_task_topology_node_id_t iree_task_topology_query_current_node(void);
 
 // A bitmask indicating which other groups from 0 to N may constructively share
 // caches. For example, a value of 0b1100 indicates that group 2 and 3 share.
-typedef uint64_t iree_task_topology_group_mask_t;
+// Groups map 1:1 with executor workers and use the same multi-word bitset.
+typedef iree_task_worker_set_t iree_task_topology_group_mask_t;
 
-#define IREE_TASK_TOPOLOGY_GROUP_MASK_ALL UINT64_MAX
+// Maximum number of groups that can be represented in a group mask.
 #define IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT \
-  (sizeof(iree_task_topology_group_mask_t) * 8)
+  ((iree_host_size_t)IREE_TASK_EXECUTOR_MAX_WORKER_COUNT)
 
 // Total cache sizes (that we care about).
 // More information may be available but we shouldn't be specializing on it
@@ -74,9 +76,21 @@ typedef struct iree_task_topology_group_t {
   // Logical processor index.
   uint32_t processor_index;
 
+  // NUMA node the processor belongs to or IREE_TASK_TOPOLOGY_NODE_ID_ANY if
+  // unknown. Memory used by workers in the group is bound to this node.
+  iree_task_topology_node_id_t node_id;
+
   // Total cache sizes (that we care about).
   iree_task_topology_caches_t caches;
 
+  // Portion of each cache level available to the group when all groups in the
+  // topology sharing the cache are active: the total cache size divided by the
+  // number of groups sharing it. Codegen and ukernel tile selection should size
+  // their working sets against these instead of the total |caches| as caches
+  // shared with other workers will be contended. Values of 0 indicate that the
+  // sharing is unknown and |caches| should be used instead.
+  iree_task_topology_caches_t worker_caches;
+
   // Ideal thread affinity for threads within this group.
   // All threads within the group share the same affinity and this is what
   // allows us to model Simultaneous Multi-Threading (SMT) (aka hyperthreading).
@@ -126,6 +140,12 @@ void iree_task_topology_initialize(iree_task_topology_t* out_topology);
 // Deinitializes a topology structure.
 void iree_task_topology_deinitialize(iree_task_topology_t* topology);
 
+// Returns the NUMA node shared by all groups in |topology| or
+// IREE_TASK_TOPOLOGY_NODE_ID_ANY if the groups span multiple nodes or their
+// nodes are unknown.
+iree_task_topology_node_id_t iree_task_topology_node_id(
+    const iree_task_topology_t* topology);
+
 // Parses a serialized topology in string form.
 iree_status_t iree_task_topology_parse(iree_string_view_t value,
                                        iree_task_topology_t* out_topology);
@@ -218,6 +238,42 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_performance_level_t performance_level,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology);
 
+// Selects how groups are distributed across the cache hierarchy.
+//
+// Workloads with large per-worker working sets (such as ukernel tiles sized to
+// the L2) can lose more to cache contention between workers than they gain
+// from the additional workers. These modes trade total worker count for a
+// larger share of each cache per worker. In all modes groups sharing a cache
+// level are assigned adjacent group indices.
+typedef enum iree_task_topology_distribution_e {
+  // One group per physical core. Workers are pinned to the core and may use
+  // all of its SMT siblings (reserving them from other work).
+  IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE = 0,
+  // One group per physical core pinned to only the first logical processor of
+  // the core. SMT siblings are not used by workers and are left to the system.
+  IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE_NO_SMT,
+  // One group per L2 cache pinned to one of the physical cores sharing the
+  // cache. Workers have the entire L2 to themselves.
+  IREE_TASK_TOPOLOGY_DISTRIBUTION_L2_CACHE,
+  // One group per L3 cache (AMD CCX, Intel/ARM cluster, etc) pinned to one of
+  // the physical cores sharing the cache. Workers have the entire L3 to
+  // themselves.
+  IREE_TASK_TOPOLOGY_DISTRIBUTION_L3_CACHE,
+} iree_task_topology_distribution_t;
+
+// Initializes a topology with one group for each cache domain selected by
+// |distribution| within the given NUMA |node_id|. Up to |max_group_count|
+// groups will be selected from the node.
+//
+// When the cache hierarchy cannot be queried or pinned on the platform (or the
+// requested cache level is not present) this falls back to the behavior of
+// iree_task_topology_initialize_from_physical_cores.
+iree_status_t iree_task_topology_initialize_from_distribution(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -93,8 +93,20 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   return iree_ok_status();
 }
 
+iree_status_t iree_task_topology_initialize_from_distribution(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
+  // No cache hierarchy information is available without cpuinfo.
+  iree_task_topology_initialize_fallback(max_group_count, out_topology);
+  return iree_ok_status();
+}
+
 #else
 
+#include <stdlib.h>
+
 #include <cpuinfo.h>
 
 static bool iree_task_topology_is_cpuinfo_available() {
@@ -182,6 +194,7 @@ static void iree_task_topology_group_initialize_from_processor(
   out_group->processor_index =
       processor->core->processor_start + processor->smt_id;
 #endif  // __linux__
+  out_group->node_id = processor->cluster->cluster_id;
   out_group->caches.l1_data =
       processor->cache.l1d ? processor->cache.l1d->size : 0;
   out_group->caches.l2_data =
@@ -206,33 +219,27 @@ static void iree_task_topology_group_initialize_from_core(
                                                      out_group);
 }
 
-// Returns a bitset with all *processors* that share the same |cache|.
-static uint64_t iree_task_topology_calculate_cache_bits(
-    const struct cpuinfo_cache* cache) {
-  if (!cache) return 0;
-  uint64_t mask = 0;
-  for (uint32_t processor_i = 0; processor_i < cache->processor_count;
-       ++processor_i) {
-    uint32_t i = cache->processor_start + processor_i;
-    if (i < IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT) {
-      mask |= 1ull << i;
-    }
-  }
-  return mask;
+// Returns true if the processor with |processor_index| shares |cache|.
+static bool iree_task_topology_cache_contains_processor(
+    const struct cpuinfo_cache* cache, uint32_t processor_index) {
+  if (!cache) return false;
+  return processor_index >= cache->processor_start &&
+         processor_index < cache->processor_start + cache->processor_count;
 }
 
-// Constructs a constructive sharing mask for all *processors* that share the
-// same cache as the specified |processor|.
-static uint64_t iree_task_topology_calculate_constructive_sharing_mask(
-    const struct cpuinfo_processor* processor) {
-  uint64_t mask = 0;
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1i);
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1d);
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l2);
+// Returns true if the processor with |processor_index| shares some level of
+// the cache hierarchy with |processor|.
+static bool iree_task_topology_shares_cache_with_processor(
+    const struct cpuinfo_processor* processor, uint32_t processor_index) {
   // TODO(benvanik): include L3 here too (for systems that have it)? Or use L3
   // info purely for distribution and focus the group mask on lower-latency
   // caches?
-  return mask;
+  return iree_task_topology_cache_contains_processor(processor->cache.l1i,
+                                                     processor_index) ||
+         iree_task_topology_cache_contains_processor(processor->cache.l1d,
+                                                     processor_index) ||
+         iree_task_topology_cache_contains_processor(processor->cache.l2,
+                                                     processor_index);
 }
 
 iree_status_t iree_task_topology_fixup_constructive_sharing_masks(
@@ -242,26 +249,47 @@ iree_status_t iree_task_topology_fixup_constructive_sharing_masks(
     return iree_ok_status();
   }
 
-  // O(n^2), but n is always <= 64 (and often <= 8).
+  // O(n^2), but n is always <= IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT (and often
+  // <= 8).
   for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
     iree_task_topology_group_t* group = &topology->groups[i];
 
-    // Compute the processors that we can constructively share with.
-    uint64_t constructive_sharing_mask =
-        iree_task_topology_calculate_constructive_sharing_mask(
-            cpuinfo_get_processor(group->processor_index));
-
-    iree_task_topology_group_mask_t group_mask = 0;
+    // Find the groups whose processors we can constructively share with and
+    // count how many groups share each cache level to divide it between them.
+    const struct cpuinfo_processor* processor =
+        cpuinfo_get_processor(group->processor_index);
+    iree_task_topology_group_mask_t group_mask;
+    iree_task_worker_set_clear(&group_mask);
+    uint32_t l1d_sharing_count = 0;
+    uint32_t l2_sharing_count = 0;
+    uint32_t l3_sharing_count = 0;
     for (iree_host_size_t j = 0; j < topology->group_count; ++j) {
       const iree_task_topology_group_t* other_group = &topology->groups[j];
-      uint64_t group_processor_bits =
-          iree_math_rotl_u64(1ull, other_group->processor_index);
-      if (constructive_sharing_mask & group_processor_bits) {
-        group_mask |= iree_math_rotl_u64(1ull, other_group->group_index);
+      if (iree_task_topology_shares_cache_with_processor(
+              processor, other_group->processor_index)) {
+        iree_task_worker_set_insert(&group_mask, other_group->group_index);
+      }
+      if (iree_task_topology_cache_contains_processor(
+              processor->cache.l1d, other_group->processor_index)) {
+        ++l1d_sharing_count;
+      }
+      if (iree_task_topology_cache_contains_processor(
+              processor->cache.l2, other_group->processor_index)) {
+        ++l2_sharing_count;
+      }
+      if (iree_task_topology_cache_contains_processor(
+              processor->cache.l3, other_group->processor_index)) {
+        ++l3_sharing_count;
       }
     }
 
     group->constructive_sharing_mask = group_mask;
+    group->worker_caches.l1_data =
+        group->caches.l1_data / iree_max(1u, l1d_sharing_count);
+    group->worker_caches.l2_data =
+        group->caches.l2_data / iree_max(1u, l2_sharing_count);
+    group->worker_caches.l3_data =
+        group->caches.l3_data / iree_max(1u, l3_sharing_count);
   }
 
   return iree_ok_status();
@@ -366,13 +394,59 @@ static bool iree_task_topology_core_filter_by_cluster_id(
   return core_performance_level == params->performance_level;
 }
 
-// Initializes a topology with one group for each core that matches |filter_fn|.
+// Returns the cache of |core| that |distribution| selects one group per or NULL
+// if |distribution| selects one group per core.
+static const struct cpuinfo_cache* iree_task_topology_core_distribution_cache(
+    const struct cpuinfo_core* core,
+    iree_task_topology_distribution_t distribution) {
+  const struct cpuinfo_processor* processor =
+      cpuinfo_get_processor(core->processor_start);
+  switch (distribution) {
+    case IREE_TASK_TOPOLOGY_DISTRIBUTION_L2_CACHE:
+      return processor->cache.l2;
+    case IREE_TASK_TOPOLOGY_DISTRIBUTION_L3_CACHE:
+      return processor->cache.l3;
+    default:
+      return NULL;
+  }
+}
+
+// Orders cores such that cores sharing an L3 cache and then an L2 cache are
+// adjacent. Caches are identified by their first processor.
+static int iree_task_topology_compare_core_caches(const void* lhs_ptr,
+                                                  const void* rhs_ptr) {
+  const struct cpuinfo_core* lhs = *(const struct cpuinfo_core* const*)lhs_ptr;
+  const struct cpuinfo_core* rhs = *(const struct cpuinfo_core* const*)rhs_ptr;
+  const struct cpuinfo_processor* lhs_processor =
+      cpuinfo_get_processor(lhs->processor_start);
+  const struct cpuinfo_processor* rhs_processor =
+      cpuinfo_get_processor(rhs->processor_start);
+  const uint32_t lhs_keys[3] = {
+      lhs_processor->cache.l3 ? lhs_processor->cache.l3->processor_start : 0,
+      lhs_processor->cache.l2 ? lhs_processor->cache.l2->processor_start : 0,
+      lhs->processor_start,
+  };
+  const uint32_t rhs_keys[3] = {
+      rhs_processor->cache.l3 ? rhs_processor->cache.l3->processor_start : 0,
+      rhs_processor->cache.l2 ? rhs_processor->cache.l2->processor_start : 0,
+      rhs->processor_start,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(lhs_keys); ++i) {
+    if (lhs_keys[i] != rhs_keys[i]) return lhs_keys[i] < rhs_keys[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+// Initializes a topology with one group for each core that matches |filter_fn|
+// or, if |distribution| selects a cache level, one group for the first core
+// matching |filter_fn| in each cache of that level.
 //
 // If cpuinfo is not available this falls back to the same behavior as
 // iree_task_topology_initialize_from_physical_cores.
 static iree_status_t
 iree_task_topology_initialize_from_physical_cores_with_filter(
     iree_task_topology_core_filter_t filter_fn, void* filter_fn_data,
+    iree_task_topology_distribution_t distribution,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
   if (!iree_task_topology_is_cpuinfo_available()) {
     iree_task_topology_initialize_fallback(max_core_count, out_topology);
@@ -382,34 +456,58 @@ iree_task_topology_initialize_from_physical_cores_with_filter(
   max_core_count = iree_min(max_core_count, IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, max_core_count);
-
-  // Count cores that match the filter.
-  iree_host_size_t core_count = 0;
-  for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
-    const struct cpuinfo_core* core = cpuinfo_get_core(i);
-    if (filter_fn(core, filter_fn_data)) ++core_count;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, distribution);
+
+  // If the cache level requested isn't present then each core is its own
+  // domain at that level.
+  if ((distribution == IREE_TASK_TOPOLOGY_DISTRIBUTION_L2_CACHE &&
+       cpuinfo_get_l2_caches_count() == 0) ||
+      (distribution == IREE_TASK_TOPOLOGY_DISTRIBUTION_L3_CACHE &&
+       cpuinfo_get_l3_caches_count() == 0)) {
+    distribution = IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE;
   }
-  core_count = iree_min(core_count, max_core_count);
 
-  iree_task_topology_initialize(out_topology);
-
-  // Build each core up to the max allowed.
-  // TODO(benvanik): if our group_count <= core_count/2 then distribute better;
-  // for now we just do a straight-line through (cores 0-N) when instead we may
-  // want to take advantage of L3 cache info (half of groups on one L3 cache,
-  // half of groups on another, etc).
-  out_topology->group_count = core_count;
-  for (uint32_t core_i = 0, group_i = 0; group_i < out_topology->group_count;
+  // Select cores that match the filter up to the max allowed, taking only one
+  // core from each cache domain if distributing by cache.
+  const struct cpuinfo_core* cores[IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT];
+  iree_host_size_t core_count = 0;
+  for (uint32_t core_i = 0;
+       core_i < cpuinfo_get_cores_count() && core_count < max_core_count;
        ++core_i) {
     // Rotate the core ID so that we avoid setting the affinity to the calling
     // thread which we assume is something the user has plans for and doesn't
     // want to have our workers stealing their time.
     const struct cpuinfo_core* core =
         cpuinfo_get_core(iree_task_topology_rotate_from_base_core(core_i));
-    if (filter_fn(core, filter_fn_data)) {
-      iree_task_topology_group_initialize_from_core(
-          group_i, core, &out_topology->groups[group_i]);
-      ++group_i;
+    if (!filter_fn(core, filter_fn_data)) continue;
+    const struct cpuinfo_cache* cache =
+        iree_task_topology_core_distribution_cache(core, distribution);
+    bool is_cache_selected = false;
+    for (iree_host_size_t i = 0; i < core_count && cache; ++i) {
+      if (iree_task_topology_core_distribution_cache(cores[i], distribution) ==
+          cache) {
+        is_cache_selected = true;
+        break;
+      }
+    }
+    if (!is_cache_selected) cores[core_count++] = core;
+  }
+
+  // Assign adjacent group indices to cores sharing caches so that neighboring
+  // workers (which the executor prefers for stealing and dispatch locality)
+  // share caches. Rotation may have otherwise split a cache domain across the
+  // start and end of the group list.
+  qsort(cores, core_count, sizeof(cores[0]),
+        iree_task_topology_compare_core_caches);
+
+  iree_task_topology_initialize(out_topology);
+  out_topology->group_count = core_count;
+  for (iree_host_size_t i = 0; i < core_count; ++i) {
+    iree_task_topology_group_t* group = &out_topology->groups[i];
+    iree_task_topology_group_initialize_from_core(i, cores[i], group);
+    if (distribution == IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE_NO_SMT) {
+      // Pin only to the first logical processor and leave SMT siblings free.
+      group->ideal_thread_affinity.smt = 0;
     }
   }
 
@@ -423,13 +521,23 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id,
     iree_task_topology_performance_level_t performance_level,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
+  return iree_task_topology_initialize_from_distribution(
+      node_id, performance_level, IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE,
+      max_core_count, out_topology);
+}
+
+iree_status_t iree_task_topology_initialize_from_distribution(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
   iree_task_topology_core_filter_params_t params = {
       .cluster_id = node_id,
       .performance_level = performance_level,
   };
   return iree_task_topology_initialize_from_physical_cores_with_filter(
-      iree_task_topology_core_filter_by_cluster_id, &params, max_core_count,
-      out_topology);
+      iree_task_topology_core_filter_by_cluster_id, &params, distribution,
+      max_group_count, out_topology);
 }
 
 #endif  // IREE_TASK_CPUINFO_DISABLED
@@ -245,4 +245,15 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   return iree_ok_status();
 }
 
+iree_status_t iree_task_topology_initialize_from_distribution(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
+  // Threads can't be pinned to cores on Apple platforms so there's no way to
+  // control how workers are distributed across caches.
+  return iree_task_topology_initialize_from_physical_cores(
+      node_id, performance_level, max_group_count, out_topology);
+}
+
 #endif  // IREE_PLATFORM_APPLE
@@ -69,24 +69,44 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id,
     iree_task_topology_performance_level_t performance_level,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology) {
+  max_core_count = iree_min(max_core_count, IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT);
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, max_group_count);
-
-  // Divide by 2 if there are an even number of cores assuming that most users
-  // have SMT enabled. This physical cores initialization routine is intended to
-  // filter out SMT but since we don't have a way to know in the browser we're
-  // just guessing. This is a conservative decision as it means on a system with
-  // SMT disabled we won't select all cores but it's better than oversubscribing
-  // a machine with SMT enabled, especially in the browser. Hosting applications
-  // can always assign a topology with their own logic/user settings/etc.
-  iree_host_size_t group_count = emscripten_num_logical_cores();
-  if (group_count > 1 && (group_count % 2) == 0) {
-    group_count /= 2;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, max_core_count);
+
+  // Workers can only share memory with the main thread when the module was
+  // built with pthreads and the page is cross-origin isolated so that
+  // SharedArrayBuffer is available. Otherwise there is nothing to run
+  // additional groups on.
+  iree_host_size_t group_count = 1;
+  if (emscripten_has_threading_support()) {
+    // Divide by 2 if there are an even number of cores assuming that most
+    // users have SMT enabled. This physical cores initialization routine is
+    // intended to filter out SMT but since we don't have a way to know in the
+    // browser we're just guessing. This is a conservative decision as it means
+    // on a system with SMT disabled we won't select all cores but it's better
+    // than oversubscribing a machine with SMT enabled, especially in the
+    // browser. Hosting applications can always assign a topology with their
+    // own logic/user settings/etc.
+    group_count = emscripten_num_logical_cores();
+    if (group_count > 1 && (group_count % 2) == 0) {
+      group_count /= 2;
+    }
   }
+  group_count = iree_max(1, iree_min(group_count, max_core_count));
   iree_task_topology_initialize_from_group_count(group_count, out_topology);
 
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
+iree_status_t iree_task_topology_initialize_from_distribution(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
+  // There's no cache hierarchy information or pinning in the browser.
+  return iree_task_topology_initialize_from_physical_cores(
+      node_id, performance_level, max_group_count, out_topology);
+}
+
 #endif  // IREE_PLATFORM_EMSCRIPTEN
@@ -65,6 +65,34 @@ TEST(TopologyTest, Construction) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, NodeId) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+
+  // Empty topologies have no node.
+  EXPECT_EQ(IREE_TASK_TOPOLOGY_NODE_ID_ANY,
+            iree_task_topology_node_id(&topology));
+
+  // Groups default to no node.
+  iree_task_topology_group_t group;
+  iree_task_topology_group_initialize(0, &group);
+  EXPECT_EQ(IREE_TASK_TOPOLOGY_NODE_ID_ANY, group.node_id);
+
+  // All groups on the same node share it.
+  group.node_id = 1;
+  IREE_EXPECT_OK(iree_task_topology_push_group(&topology, &group));
+  IREE_EXPECT_OK(iree_task_topology_push_group(&topology, &group));
+  EXPECT_EQ(1, iree_task_topology_node_id(&topology));
+
+  // Groups spanning nodes have no common node.
+  group.node_id = 2;
+  IREE_EXPECT_OK(iree_task_topology_push_group(&topology, &group));
+  EXPECT_EQ(IREE_TASK_TOPOLOGY_NODE_ID_ANY,
+            iree_task_topology_node_id(&topology));
+
+  iree_task_topology_deinitialize(&topology);
+}
+
 TEST(TopologyTest, MaxCapacity) {
   iree_task_topology_t topology;
   iree_task_topology_initialize(&topology);
@@ -145,4 +173,32 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, FromDistribution) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  for (auto distribution : {
+           IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE,
+           IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE_NO_SMT,
+           IREE_TASK_TOPOLOGY_DISTRIBUTION_L2_CACHE,
+           IREE_TASK_TOPOLOGY_DISTRIBUTION_L3_CACHE,
+       }) {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize(&topology);
+    IREE_ASSERT_OK(iree_task_topology_initialize_from_distribution(
+        IREE_TASK_TOPOLOGY_NODE_ID_ANY,
+        IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY, distribution, kMaxGroupCount,
+        &topology));
+    EnsureTopologyValid(kMaxGroupCount, &topology);
+    for (iree_host_size_t i = 0; i < iree_task_topology_group_count(&topology);
+         ++i) {
+      // Per-worker cache sizes are unknown (0) or a portion of the total.
+      const iree_task_topology_group_t* group =
+          iree_task_topology_get_group(&topology, i);
+      EXPECT_LE(group->worker_caches.l1_data, group->caches.l1_data);
+      EXPECT_LE(group->worker_caches.l2_data, group->caches.l2_data);
+      EXPECT_LE(group->worker_caches.l3_data, group->caches.l3_data);
+    }
+    iree_task_topology_deinitialize(&topology);
+  }
+}
+
 }  // namespace
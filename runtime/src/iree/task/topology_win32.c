@@ -9,6 +9,8 @@
 
 #if defined(IREE_PLATFORM_WINDOWS)
 
+#include <stdlib.h>
+
 //===----------------------------------------------------------------------===//
 // NUMA queries
 //===----------------------------------------------------------------------===//
@@ -84,14 +86,33 @@ static void iree_task_topology_assign_cache_info(
         break;  // not yet used
     }
   }
+  // Count the groups sharing the cache so we can divide it between them.
+  uint32_t sharing_count = 0;
+  for (iree_host_size_t group_i = 0; group_i < topology->group_count;
+       ++group_i) {
+    const iree_task_topology_group_t* group = &topology->groups[group_i];
+    if (group->ideal_thread_affinity.group == group_mask.Group &&
+        (group_mask.Mask & (1ull << group->ideal_thread_affinity.id))) {
+      ++sharing_count;
+    }
+  }
   for (iree_host_size_t group_i = 0; group_i < topology->group_count;
        ++group_i) {
     iree_task_topology_group_t* group = &topology->groups[group_i];
     if (group->ideal_thread_affinity.group == group_mask.Group &&
         (group_mask.Mask & (1ull << group->ideal_thread_affinity.id))) {
-      if (caches.l1_data) group->caches.l1_data = caches.l1_data;
-      if (caches.l2_data) group->caches.l2_data = caches.l2_data;
-      if (caches.l3_data) group->caches.l3_data = caches.l3_data;
+      if (caches.l1_data) {
+        group->caches.l1_data = caches.l1_data;
+        group->worker_caches.l1_data = caches.l1_data / sharing_count;
+      }
+      if (caches.l2_data) {
+        group->caches.l2_data = caches.l2_data;
+        group->worker_caches.l2_data = caches.l2_data / sharing_count;
+      }
+      if (caches.l3_data) {
+        group->caches.l3_data = caches.l3_data;
+        group->worker_caches.l3_data = caches.l3_data / sharing_count;
+      }
     }
   }
 }
@@ -111,7 +132,8 @@ static void iree_task_topology_assign_constructive_sharing(
         iree_task_topology_group_t* other = &topology->groups[group_j];
         if (other->ideal_thread_affinity.group == group_mask.Group &&
             (group_mask.Mask & (1ull << other->ideal_thread_affinity.id))) {
-          group->constructive_sharing_mask |= 1ull << group_j;
+          iree_task_worker_set_insert(&group->constructive_sharing_mask,
+                                      group_j);
         }
       }
     }
@@ -298,7 +320,8 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
         iree_task_topology_group_t* group = &out_topology->groups[group_index];
         iree_task_topology_group_initialize(group_index, group);
         group->processor_index = (uint32_t)global_processor_index;
-        group->constructive_sharing_mask = 0;  // set below
+        // Set below.
+        iree_task_worker_set_clear(&group->constructive_sharing_mask);
 
         // Pin group to the processor.
         iree_thread_affinity_t* affinity = &group->ideal_thread_affinity;
@@ -307,6 +330,17 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
         affinity->smt = (p->Processor.Flags & LTP_PC_SMT) == LTP_PC_SMT;
         affinity->group = p->Processor.GroupMask[0].Group;
         affinity->id = group_offset + bit_offset;
+
+        // Query the NUMA node the processor is attached to.
+        PROCESSOR_NUMBER processor_number = {
+            .Group = affinity->group,
+            .Number = (BYTE)affinity->id,
+        };
+        USHORT node_number = 0;
+        if (GetNumaProcessorNodeEx(&processor_number, &node_number) &&
+            node_number != 0xFFFF) {
+          group->node_id = (iree_task_topology_node_id_t)node_number;
+        }
       }
       group_offset += bit_offset + 1;
       if (out_topology->group_count >= cpu_count) break;
@@ -542,7 +576,9 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_group_t* group = &out_topology->groups[group_index];
     iree_task_topology_group_initialize(group_index, group);
     group->processor_index = (uint32_t)adjusted_core_index;
-    group->constructive_sharing_mask = 0;  // set below
+    group->node_id = node_id;
+    // Set below.
+    iree_task_worker_set_clear(&group->constructive_sharing_mask);
     iree_task_topology_set_affinity_from_processor(
         core, &group->ideal_thread_affinity);
   }
@@ -555,4 +591,204 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   return iree_ok_status();
 }
 
+// Returns true if |cache| is shared by the processor |group| is pinned to.
+static bool iree_task_topology_cache_contains_group(
+    const CACHE_RELATIONSHIP* cache, const iree_task_topology_group_t* group) {
+  // GroupMask aliases GroupMasks[0] and is used when GroupCount is 0.
+  WORD mask_count = cache->GroupCount == 0 ? 1 : cache->GroupCount;
+  for (WORD i = 0; i < mask_count; ++i) {
+    const GROUP_AFFINITY* group_mask = &cache->GroupMasks[i];
+    if (group->ideal_thread_affinity.group == group_mask->Group &&
+        (group_mask->Mask & (1ull << group->ideal_thread_affinity.id))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Returns the unified or data cache at |level| shared by the processor |group|
+// is pinned to or NULL if the processor has no cache at that level.
+static const CACHE_RELATIONSHIP* iree_task_topology_find_group_cache(
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* relationships,
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* relationships_end, BYTE level,
+    const iree_task_topology_group_t* group) {
+  for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* p = relationships;
+       p < relationships_end;
+       p = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)((uintptr_t)p + p->Size)) {
+    if (p->Relationship == RelationCache && p->Cache.Level == level &&
+        (p->Cache.Type == CacheUnified || p->Cache.Type == CacheData) &&
+        iree_task_topology_cache_contains_group(&p->Cache, group)) {
+      return &p->Cache;
+    }
+  }
+  return NULL;
+}
+
+// A group selected to represent a cache domain.
+typedef struct iree_task_topology_cache_domain_t {
+  // Cache shared by the group at the distribution level, if any.
+  const CACHE_RELATIONSHIP* cache;
+  // L3 and L2 caches of the group used for ordering, if any.
+  const CACHE_RELATIONSHIP* l3_cache;
+  const CACHE_RELATIONSHIP* l2_cache;
+  // Group as initialized from its physical core.
+  iree_task_topology_group_t group;
+} iree_task_topology_cache_domain_t;
+
+// Orders domains such that groups sharing an L3 cache and then an L2 cache are
+// adjacent. Caches are identified by their relationship address.
+static int iree_task_topology_compare_cache_domains(const void* lhs_ptr,
+                                                    const void* rhs_ptr) {
+  const iree_task_topology_cache_domain_t* lhs =
+      (const iree_task_topology_cache_domain_t*)lhs_ptr;
+  const iree_task_topology_cache_domain_t* rhs =
+      (const iree_task_topology_cache_domain_t*)rhs_ptr;
+  const uintptr_t lhs_keys[3] = {
+      (uintptr_t)lhs->l3_cache,
+      (uintptr_t)lhs->l2_cache,
+      lhs->group.processor_index,
+  };
+  const uintptr_t rhs_keys[3] = {
+      (uintptr_t)rhs->l3_cache,
+      (uintptr_t)rhs->l2_cache,
+      rhs->group.processor_index,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(lhs_keys); ++i) {
+    if (lhs_keys[i] != rhs_keys[i]) return lhs_keys[i] < rhs_keys[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+// Reduces |topology| to the first group in each cache domain at |level| up to
+// |max_group_count| groups. Groups are visited in their existing order so the
+// rotation away from the calling core is preserved. Groups whose processor has
+// no cache at |level| are each their own domain such that a missing cache level
+// behaves as one group per physical core. The selected groups are reindexed so
+// that groups sharing caches are adjacent.
+static iree_status_t iree_task_topology_select_cache_domains(
+    BYTE level, iree_host_size_t max_group_count,
+    iree_task_topology_t* topology) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)level);
+
+  // Query the total size required for just cache information and allocate
+  // storage for it on the stack - it's generally just a few KB.
+  DWORD cache_relationships_size = 0;
+  if (!GetLogicalProcessorInformationEx(RelationCache, NULL,
+                                        &cache_relationships_size) &&
+      GetLastError() != ERROR_INSUFFICIENT_BUFFER) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        iree_status_code_from_win32_error(GetLastError()),
+        "failed to query logical processor information size (%08X)",
+        (unsigned)GetLastError());
+  }
+  if (cache_relationships_size > 64 * 1024) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "logical processor information size overflow (got "
+                            "%u which is large for a stack alloc)",
+                            (unsigned)cache_relationships_size);
+  }
+  SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* cache_relationships =
+      (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)iree_alloca(
+          cache_relationships_size);
+
+  // Query again to populate the storage with cache relationship information.
+  if (!GetLogicalProcessorInformationEx(RelationCache, cache_relationships,
+                                        &cache_relationships_size)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        iree_status_code_from_win32_error(GetLastError()),
+        "failed to query logical processor information (%08X)",
+        (unsigned)GetLastError());
+  }
+  SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* cache_relationships_end =
+      (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)((uintptr_t)
+                                                     cache_relationships +
+                                                 cache_relationships_size);
+
+  // Take the first group from each cache domain.
+  iree_task_topology_cache_domain_t* domains =
+      iree_alloca(sizeof(iree_task_topology_cache_domain_t) *
+                  iree_max(1, topology->group_count));
+  iree_host_size_t domain_count = 0;
+  for (iree_host_size_t group_i = 0;
+       group_i < topology->group_count && domain_count < max_group_count;
+       ++group_i) {
+    const iree_task_topology_group_t* group = &topology->groups[group_i];
+    const CACHE_RELATIONSHIP* cache = iree_task_topology_find_group_cache(
+        cache_relationships, cache_relationships_end, level, group);
+    bool is_cache_selected = false;
+    for (iree_host_size_t i = 0; i < domain_count && cache; ++i) {
+      if (domains[i].cache == cache) {
+        is_cache_selected = true;
+        break;
+      }
+    }
+    if (is_cache_selected) continue;
+    iree_task_topology_cache_domain_t* domain = &domains[domain_count++];
+    domain->cache = cache;
+    domain->l3_cache = iree_task_topology_find_group_cache(
+        cache_relationships, cache_relationships_end, 3, group);
+    domain->l2_cache = iree_task_topology_find_group_cache(
+        cache_relationships, cache_relationships_end, 2, group);
+    domain->group = *group;
+  }
+
+  // Assign adjacent group indices to groups sharing caches so that neighboring
+  // workers (which the executor prefers for stealing and dispatch locality)
+  // share caches. Rotation may have otherwise split a cache domain across the
+  // start and end of the group list.
+  qsort(domains, domain_count, sizeof(domains[0]),
+        iree_task_topology_compare_cache_domains);
+
+  // Rebuild the topology from the selected groups. Cache sizes and sharing
+  // masks are recomputed as fewer groups now share each cache.
+  topology->group_count = domain_count;
+  for (iree_host_size_t i = 0; i < domain_count; ++i) {
+    const iree_task_topology_group_t* source_group = &domains[i].group;
+    iree_task_topology_group_t* group = &topology->groups[i];
+    iree_task_topology_group_initialize((uint8_t)i, group);
+    group->processor_index = source_group->processor_index;
+    group->node_id = source_group->node_id;
+    group->ideal_thread_affinity = source_group->ideal_thread_affinity;
+    iree_task_worker_set_clear(&group->constructive_sharing_mask);
+  }
+  iree_task_topology_fixup_constructive_sharing_masks_from_relationships(
+      cache_relationships, cache_relationships_end, topology);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_task_topology_initialize_from_distribution(
+    iree_task_topology_node_id_t node_id,
+    iree_task_topology_performance_level_t performance_level,
+    iree_task_topology_distribution_t distribution,
+    iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
+  switch (distribution) {
+    case IREE_TASK_TOPOLOGY_DISTRIBUTION_L2_CACHE:
+    case IREE_TASK_TOPOLOGY_DISTRIBUTION_L3_CACHE:
+      // Start from every core in the node and keep one per cache domain.
+      IREE_RETURN_IF_ERROR(iree_task_topology_initialize_from_physical_cores(
+          node_id, performance_level, IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT,
+          out_topology));
+      return iree_task_topology_select_cache_domains(
+          distribution == IREE_TASK_TOPOLOGY_DISTRIBUTION_L2_CACHE ? 2 : 3,
+          max_group_count, out_topology);
+    default:
+      break;
+  }
+  IREE_RETURN_IF_ERROR(iree_task_topology_initialize_from_physical_cores(
+      node_id, performance_level, max_group_count, out_topology));
+  if (distribution == IREE_TASK_TOPOLOGY_DISTRIBUTION_PHYSICAL_CORE_NO_SMT) {
+    // Pin only to the first logical processor and leave SMT siblings free.
+    for (iree_host_size_t i = 0; i < out_topology->group_count; ++i) {
+      out_topology->groups[i].ideal_thread_affinity.smt = 0;
+    }
+  }
+  return iree_ok_status();
+}
+
 #endif  // IREE_PLATFORM_WINDOWS
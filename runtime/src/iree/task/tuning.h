@@ -12,10 +12,13 @@ extern "C" {
 #endif  // __cplusplus
 
 // Maximum number of workers that an executor can manage.
-// A 64 worker hard limit is based on us using uint64_t as a bitmask to select
-// workers. It's easy to go smaller (just use fewer bits) if it's known that
-// only <64 will ever be used (such as for devices with 2 cores).
-#define IREE_TASK_EXECUTOR_MAX_WORKER_COUNT (64)
+// Workers are tracked in fixed-size multi-word bitsets (iree_task_worker_set_t)
+// and this limit determines their size; topology group indices are 8-bit and
+// bound the maximum at 256. It's easy to go smaller if it's known that only a
+// few workers will ever be used (such as for devices with 2 cores).
+#if !defined(IREE_TASK_EXECUTOR_MAX_WORKER_COUNT)
+#define IREE_TASK_EXECUTOR_MAX_WORKER_COUNT (256)
+#endif  // !IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
 
 // Initial number of shard tasks that are allocated in the executor pool.
 // Increasing this number will decrease initial allocation storms in cases of
@@ -23,6 +26,15 @@ extern "C" {
 // at the cost of a higher minimum memory consumption.
 #define IREE_TASK_EXECUTOR_INITIAL_SHARD_RESERVATION_PER_WORKER (4)
 
+// Number of incoming ready task lists submissions are sharded across.
+// Each submitting thread concatenates its tasks into one shard and the
+// coordinator flushes all of them. More shards reduce contention when many
+// threads submit concurrently at the cost of a few more list flushes per
+// coordination. Must be a power of two.
+#if !defined(IREE_TASK_EXECUTOR_SUBMISSION_SHARD_COUNT)
+#define IREE_TASK_EXECUTOR_SUBMISSION_SHARD_COUNT (8)
+#endif  // !IREE_TASK_EXECUTOR_SUBMISSION_SHARD_COUNT
+
 // Maximum number of events retained by the executor event pool.
 #define IREE_TASK_EXECUTOR_EVENT_POOL_CAPACITY 64
 
@@ -40,6 +52,8 @@ extern "C" {
 // Also, the underlying iree_wait_set_t may not support more than 64 handles on
 // certain platforms without emulation. Trying to keep us on the fast-path
 // with a reasonable number seems fine for now until we have a need for more.
+// Where the wait set is backed by epoll (Linux/Android) this is only the
+// initial capacity and the set grows to fit any number of outstanding waits.
 //
 // NOTE: we reserve 1 wait handle for our own internal use. This allows us to
 // wake the coordination worker when new work is submitted from external
@@ -60,6 +74,12 @@ extern "C" {
 // Setting this to 0 will disable thefts.
 #define IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR (1)
 
+// Fraction of the maximum worker spin duration that adaptive spinning grows
+// by at minimum when idle periods are short enough that spinning would have
+// avoided parking. Larger values make workers that have backed off to not
+// spinning at all take more short idle periods to begin spinning again.
+#define IREE_TASK_WORKER_SPIN_GROWTH_DIVISOR (8)
+
 // Maximum number of tasks that will be stolen in one go from another worker.
 //
 // Too few tasks will cause additional overhead as the worker repeatedly sips
@@ -77,8 +97,17 @@ extern "C" {
 // In real-time systems too few tasks is better (slightly more work for much
 // lower variance in execution) while in batch mode systems too many tasks is
 // better (as latencies don't matter so long as throughput is maximized).
-#define IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT \
-  IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
+#define IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT (64)
+
+// Capacity of each worker's local work-stealing deque in tasks.
+// Must be a power of two. Tasks flushed from the worker mailbox that do not fit
+// in the deque remain in the mailbox until the worker has room for them so this
+// only needs to be large enough to avoid frequent round-trips when a worker is
+// handed many tasks at once. Each slot is a pointer and the deque is embedded
+// in the worker so this also directly contributes to the worker size.
+#if !defined(IREE_TASK_DEQUE_CAPACITY)
+#define IREE_TASK_DEQUE_CAPACITY (256)
+#endif  // !IREE_TASK_DEQUE_CAPACITY
 
 // Number of tiles that will be batched into a single reservation from the grid.
 // This is a maximum; if there are fewer tiles that would otherwise allow for
@@ -94,6 +123,13 @@ extern "C" {
 // memory).
 #define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
 
+// Maximum number of slices the tile grid of a dispatch is partitioned into when
+// using IREE_TASK_SCHEDULING_MODE_DISPATCH_LOCALITY. Each slice has a tile
+// cursor embedded in the dispatch task and so this directly contributes to the
+// size of every dispatch. When there are more workers than slices consecutive
+// workers share a slice (and usually caches as well).
+#define IREE_TASK_DISPATCH_MAX_LOCALITY_SLICES (16)
+
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
 // TODO(#4017): make per-tile color tracing fast enough to always have on.
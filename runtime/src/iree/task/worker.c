@@ -24,18 +24,20 @@ static int iree_task_worker_main(iree_task_worker_t* worker);
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker) {
+    iree_host_size_t stack_size, iree_thread_priority_class_t priority_class,
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_worker->executor = executor;
   out_worker->worker_index = executor->worker_base_index + worker_index;
-  out_worker->worker_bit = iree_task_affinity_for_worker(worker_index);
+  out_worker->local_worker_index = worker_index;
   out_worker->ideal_thread_affinity = topology_group->ideal_thread_affinity;
   out_worker->constructive_sharing_mask =
       topology_group->constructive_sharing_mask;
   out_worker->max_theft_attempts =
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
+  out_worker->spin_ns = executor->worker_spin_ns;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
                                   &out_worker->theft_prng);
   out_worker->local_memory = local_memory;
@@ -45,7 +47,11 @@ iree_status_t iree_task_worker_initialize(
   iree_notification_initialize(&out_worker->wake_notification);
   iree_notification_initialize(&out_worker->state_notification);
   iree_atomic_task_slist_initialize(&out_worker->mailbox_slist);
-  iree_task_queue_initialize(&out_worker->local_task_queue);
+  iree_atomic_task_slist_initialize(&out_worker->priority_mailbox_slist);
+  iree_atomic_store_int32(&out_worker->priority_mailbox_pending, 0,
+                          iree_memory_order_relaxed);
+  iree_task_deque_initialize(&out_worker->local_task_deque);
+  iree_task_deque_initialize(&out_worker->priority_task_deque);
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
   iree_atomic_store_int32(&out_worker->state, initial_state,
@@ -55,7 +61,7 @@ iree_status_t iree_task_worker_initialize(
   memset(&thread_params, 0, sizeof(thread_params));
   thread_params.name = iree_make_cstring_view(topology_group->name);
   thread_params.create_suspended = false;
-  thread_params.priority_class = IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  thread_params.priority_class = priority_class;
   thread_params.initial_affinity = out_worker->ideal_thread_affinity;
   thread_params.stack_size =
       iree_max(IREE_TASK_WORKER_MIN_STACK_SIZE, stack_size);
@@ -129,13 +135,17 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   // Release unfinished tasks by flushing the mailbox (which if we're here can't
   // get anything more posted to it) and then discarding everything we still
   // have a reference to.
+  iree_atomic_task_slist_discard(&worker->priority_mailbox_slist);
   iree_atomic_task_slist_discard(&worker->mailbox_slist);
-  iree_task_list_discard(&worker->local_task_queue.list);
+  iree_task_deque_discard(&worker->priority_task_deque);
+  iree_task_deque_discard(&worker->local_task_deque);
 
   iree_notification_deinitialize(&worker->wake_notification);
   iree_notification_deinitialize(&worker->state_notification);
+  iree_atomic_task_slist_deinitialize(&worker->priority_mailbox_slist);
   iree_atomic_task_slist_deinitialize(&worker->mailbox_slist);
-  iree_task_queue_deinitialize(&worker->local_task_queue);
+  iree_task_deque_deinitialize(&worker->priority_task_deque);
+  iree_task_deque_deinitialize(&worker->local_task_deque);
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -148,13 +158,37 @@ void iree_task_worker_post_tasks(iree_task_worker_t* worker,
   memset(list, 0, sizeof(*list));
 }
 
+void iree_task_worker_post_priority_tasks(iree_task_worker_t* worker,
+                                          iree_task_list_t* list) {
+  iree_atomic_task_slist_concat(&worker->priority_mailbox_slist, list->head,
+                                list->tail);
+  memset(list, 0, sizeof(*list));
+  // Published after the tasks so that the worker observing the flag will find
+  // them when it flushes.
+  iree_atomic_store_int32(&worker->priority_mailbox_pending, 1,
+                          iree_memory_order_release);
+}
+
 iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
+                                             iree_task_deque_t* target_deque,
                                              iree_host_size_t max_tasks) {
+  // Priority tasks are taken one at a time as they would otherwise be moved
+  // into the normal target deque behind any normal tasks stolen later.
+  iree_task_t* task = NULL;
+  if (!iree_task_deque_is_empty(&worker->priority_task_deque)) {
+    task = iree_task_deque_steal(&worker->priority_task_deque);
+    if (task) return task;
+  }
+  if (iree_atomic_load_int32(&worker->priority_mailbox_pending,
+                             iree_memory_order_acquire)) {
+    task = iree_atomic_task_slist_pop(&worker->priority_mailbox_slist);
+    if (task) return task;
+  }
+
   // Try to grab tasks from the worker; if more than one task is stolen then the
-  // first will be returned and the remaining will be added to the target queue.
-  iree_task_t* task = iree_task_queue_try_steal(&worker->local_task_queue,
-                                                target_queue, max_tasks);
+  // first will be returned and the remaining will be added to the target deque.
+  task = iree_task_deque_try_steal(&worker->local_task_deque, target_deque,
+                                   max_tasks);
   if (task) return task;
 
   // If we still didn't steal any tasks then let's try the slist instead.
@@ -185,8 +219,9 @@ static void iree_task_worker_execute(
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
       iree_task_dispatch_shard_execute(
-          (iree_task_dispatch_shard_t*)task, worker->processor_id,
-          worker->worker_index, worker->local_memory, pending_submission);
+          (iree_task_dispatch_shard_t*)task, worker->executor,
+          worker->processor_id, worker->worker_index, worker->local_memory,
+          pending_submission);
       break;
     }
     default:
@@ -198,6 +233,40 @@ static void iree_task_worker_execute(
   task = NULL;
 }
 
+// Pops the next task from a IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY scope, if any.
+// This is checked before each task the worker runs and is kept to a few loads
+// when there is no priority work.
+static iree_task_t* iree_task_worker_pop_priority_task(
+    iree_task_worker_t* worker) {
+  if (!iree_task_deque_is_empty(&worker->priority_task_deque)) {
+    iree_task_t* task = iree_task_deque_pop(&worker->priority_task_deque);
+    if (task) return task;
+  }
+
+  // Clear the pending flag before flushing so that any tasks posted after the
+  // flush set it again.
+  if (!iree_atomic_load_int32(&worker->priority_mailbox_pending,
+                              iree_memory_order_relaxed) ||
+      !iree_atomic_exchange_int32(&worker->priority_mailbox_pending, 0,
+                                  iree_memory_order_acq_rel)) {
+    return NULL;
+  }
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  if (!iree_atomic_task_slist_flush(
+          &worker->priority_mailbox_slist,
+          IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO, &list.head,
+          &list.tail)) {
+    return NULL;
+  }
+  iree_task_deque_push_lifo_list(&worker->priority_task_deque, &list);
+  if (!iree_task_list_is_empty(&list)) {
+    // Didn't all fit; return the remainder and flush it again after draining.
+    iree_task_worker_post_priority_tasks(worker, &list);
+  }
+  return iree_task_deque_pop(&worker->priority_task_deque);
+}
+
 // Pumps the worker thread once, processing a single task.
 // Returns true if pumping should continue as there are more tasks remaining or
 // false if the caller should wait for more tasks to be posted.
@@ -205,10 +274,13 @@ static bool iree_task_worker_pump_once(
     iree_task_worker_t* worker, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Tasks from high priority scopes always run before any others.
+  iree_task_t* task = iree_task_worker_pop_priority_task(worker);
+
   // Check the local work queue for any work we know we should start
   // processing immediately. Other workers may try to steal some of this work
   // if we take too long.
-  iree_task_t* task = iree_task_queue_pop_front(&worker->local_task_queue);
+  if (!task) task = iree_task_deque_pop(&worker->local_task_deque);
 
   // Check the mailbox to see if we have incoming work that has been posted.
   // We try to greedily move it to our local work list so that we can work
@@ -220,20 +292,25 @@ static bool iree_task_worker_pump_once(
     // first place (large uneven workloads for various workers, bad distribution
     // in the face of heterogenous multi-core architectures where some workers
     // complete tasks faster than others, etc).
-    task = iree_task_queue_flush_from_lifo_slist(&worker->local_task_queue,
+    task = iree_task_deque_flush_from_lifo_slist(&worker->local_task_deque,
                                                  &worker->mailbox_slist);
+    if (task) {
+      iree_metric_histogram_record(
+          &iree_task_metric_worker_queue_depth,
+          iree_task_deque_approximate_size(&worker->local_task_deque) + 1);
+    }
   }
 
 #if IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
   // If we ran out of work assigned to this specific worker try to steal some
   // from other workers that we hopefully share some of the cache hierarchy
-  // with. Their tasks will be moved from their local queue into ours and the
-  // the first task in the queue is popped off and returned.
+  // with. Their tasks will be moved from their local deque into ours and the
+  // the first task stolen is returned.
   if (!task) {
     task = iree_task_executor_try_steal_task(
-        worker->executor, worker->constructive_sharing_mask,
+        worker->executor, &worker->constructive_sharing_mask,
         worker->max_theft_attempts, &worker->theft_prng,
-        &worker->local_task_queue);
+        &worker->local_task_deque);
   }
 #endif  // IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
 
@@ -256,6 +333,91 @@ static void iree_task_worker_update_processor_id(iree_task_worker_t* worker) {
   iree_cpu_requery_processor_id(&worker->processor_tag, &worker->processor_id);
 }
 
+// Adjusts the worker spin duration after being idle for |idle_ns|.
+// Idle periods the maximum spin duration would have covered mean that spinning
+// longer would have avoided parking (or did avoid it) and we grow toward the
+// maximum. Longer idle periods mean spinning only burned CPU and we shrink
+// toward zero. The spin duration never drops so low that a run of short idle
+// periods can't grow it back within a few waits.
+static void iree_task_worker_adapt_spin(iree_task_worker_t* worker,
+                                        iree_duration_t idle_ns) {
+  const iree_duration_t max_spin_ns = worker->executor->worker_spin_ns;
+  if (idle_ns <= max_spin_ns) {
+    const iree_duration_t min_growth_ns =
+        max_spin_ns / IREE_TASK_WORKER_SPIN_GROWTH_DIVISOR;
+    worker->spin_ns =
+        iree_min(max_spin_ns, iree_max(worker->spin_ns * 2, min_growth_ns));
+  } else {
+    worker->spin_ns /= 2;
+  }
+}
+
+// Waits for the worker to be notified of new work or to exit.
+// |wait_token| must have been prepared on the worker wake_notification.
+//
+// The worker first spins for its current spin duration without being
+// registered as a waiter such that any thread posting work to it will not need
+// to perform a system wake. If nothing arrives while spinning the worker
+// re-registers and parks in the system.
+static void iree_task_worker_wait_for_work(iree_task_worker_t* worker,
+                                           iree_wait_token_t wait_token) {
+  iree_task_executor_t* executor = worker->executor;
+  const bool is_adaptive =
+      executor->worker_spin_mode == IREE_TASK_WORKER_SPIN_MODE_ADAPTIVE &&
+      executor->worker_spin_ns != IREE_DURATION_ZERO;
+  const iree_time_t idle_start_ns =
+      is_adaptive ? iree_time_now() : IREE_TIME_INFINITE_PAST;
+
+  bool did_spin_wake = false;
+  if (worker->spin_ns != IREE_DURATION_ZERO) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z_spin, "iree_task_worker_spin_wait");
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z_spin, worker->spin_ns);
+    iree_notification_cancel_wait(&worker->wake_notification);
+    did_spin_wake = iree_notification_poll(&worker->wake_notification,
+                                           wait_token, worker->spin_ns);
+    if (!did_spin_wake) {
+      // Re-register before parking. If anything was posted since we last
+      // polled the epoch will have advanced and we must not wait on it.
+      iree_wait_token_t park_wait_token =
+          iree_notification_prepare_wait(&worker->wake_notification);
+      if (park_wait_token != wait_token) {
+        iree_notification_cancel_wait(&worker->wake_notification);
+        did_spin_wake = true;
+      }
+    }
+    IREE_TRACE_ZONE_END(z_spin);
+  }
+
+  if (did_spin_wake) {
+    IREE_TRACE_PLOT_VALUE_I64(
+        executor->spin_trace_name,
+        iree_atomic_fetch_add_int64(&executor->worker_spin_wake_count, 1,
+                                    iree_memory_order_relaxed) +
+            1);
+  } else {
+    // Wait in the kernel. We don't care if the condition fails as we're just
+    // using it as a pulse.
+    IREE_TRACE_ZONE_BEGIN_NAMED(z_wait, "iree_task_worker_main_pump_wake_wait");
+    IREE_TRACE_PLOT_VALUE_I64(
+        executor->park_trace_name,
+        iree_atomic_fetch_add_int64(&executor->worker_park_count, 1,
+                                    iree_memory_order_relaxed) +
+            1);
+    iree_notification_commit_wait(&worker->wake_notification, wait_token,
+                                  /*spin_ns=*/IREE_DURATION_ZERO,
+                                  /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+    IREE_TRACE_ZONE_END(z_wait);
+
+    // Woke from a wait - query the processor ID in case we migrated during
+    // the sleep.
+    iree_task_worker_update_processor_id(worker);
+  }
+
+  if (is_adaptive) {
+    iree_task_worker_adapt_spin(worker, iree_time_now() - idle_start_ns);
+  }
+}
+
 // Alternates between pumping ready tasks in the worker queue and waiting
 // for more tasks to arrive. Only returns when the worker has been asked by
 // the executor to exit.
@@ -276,18 +438,16 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
         iree_notification_prepare_wait(&worker->wake_notification);
 
     // The masks are accessed with 'relaxed' order because they are just hints.
-    iree_task_affinity_set_t old_idle_mask =
-        iree_atomic_task_affinity_set_fetch_and(
-            &worker->executor->worker_idle_mask, ~worker->worker_bit,
-            iree_memory_order_relaxed);
-    (void)old_idle_mask;
+    iree_atomic_task_worker_set_erase(&worker->executor->worker_idle_mask,
+                                      worker->local_worker_index,
+                                      iree_memory_order_relaxed);
     IREE_TRACE_PLOT_VALUE_F32(
         worker->executor->trace_name,
-        old_idle_mask
-            ? (100.0f -
-               100.0f * (iree_task_affinity_set_count_ones(old_idle_mask) - 1) /
-                   (float)worker->executor->worker_count)
-            : 100.0f);
+        100.0f - 100.0f *
+                     iree_atomic_task_worker_set_count(
+                         &worker->executor->worker_idle_mask,
+                         iree_memory_order_relaxed) /
+                     (float)worker->executor->worker_count);
 
     // Check state to see if we've been asked to exit.
     if (iree_atomic_load_int32(&worker->state, iree_memory_order_acquire) ==
@@ -318,14 +478,15 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // We've finished all the work we have scheduled so set our idle flag.
     // This ensures that if any other thread comes in and wants to give us
     // work we will properly coordinate/wake below.
-    old_idle_mask = iree_atomic_task_affinity_set_fetch_or(
-        &worker->executor->worker_idle_mask, worker->worker_bit,
-        iree_memory_order_relaxed);
-    (void)old_idle_mask;
+    iree_atomic_task_worker_set_insert(&worker->executor->worker_idle_mask,
+                                       worker->local_worker_index,
+                                       iree_memory_order_relaxed);
     IREE_TRACE_PLOT_VALUE_F32(
         worker->executor->trace_name,
         100.0f - 100.0f *
-                     (iree_task_affinity_set_count_ones(old_idle_mask) + 1) /
+                     iree_atomic_task_worker_set_count(
+                         &worker->executor->worker_idle_mask,
+                         iree_memory_order_relaxed) /
                      (float)worker->executor->worker_count);
 
     // When we encounter a complete lack of work we can self-nominate to check
@@ -342,23 +503,13 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // coordination didn't find anything) we go idle. Otherwise we fall
     // through and try the loop again.
     if (schedule_dirty ||
-        !iree_task_queue_is_empty(&worker->local_task_queue)) {
+        !iree_task_deque_is_empty(&worker->priority_task_deque) ||
+        !iree_task_deque_is_empty(&worker->local_task_deque)) {
       // Have more work to do; loop around to try another pump.
       iree_notification_cancel_wait(&worker->wake_notification);
     } else {
-      // Spin/wait in the kernel. We don't care if the condition fails as we're
-      // just using it as a pulse.
-      IREE_TRACE_ZONE_BEGIN_NAMED(z_wait,
-                                  "iree_task_worker_main_pump_wake_wait");
-      iree_notification_commit_wait(
-          &worker->wake_notification, wait_token,
-          /*spin_ns=*/worker->executor->worker_spin_ns,
-          /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
-      IREE_TRACE_ZONE_END(z_wait);
-
-      // Woke from a wait - query the processor ID in case we migrated during
-      // the sleep.
-      iree_task_worker_update_processor_id(worker);
+      // Spin and then wait in the kernel.
+      iree_task_worker_wait_for_work(worker, wait_token);
     }
 
     // Wait completed.
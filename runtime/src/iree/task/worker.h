@@ -15,9 +15,9 @@
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/threading.h"
 #include "iree/task/affinity_set.h"
+#include "iree/task/deque.h"
 #include "iree/task/executor.h"
 #include "iree/task/list.h"
-#include "iree/task/queue.h"
 #include "iree/task/task.h"
 #include "iree/task/topology.h"
 #include "iree/task/tuning.h"
@@ -60,7 +60,7 @@ typedef struct iree_task_worker_t {
   // them based on the work distribution policy. When workers go to look for
   // more work after their local queue empties they will flush this list and
   // move all of the tasks into their local queue and restart processing.
-  // LAYOUT: must be 64b away from local_task_queue.
+  // LAYOUT: must be 64b away from local_task_deque.
   iree_atomic_task_slist_t mailbox_slist;
 
   // Current state of the worker (iree_task_worker_state_t).
@@ -74,6 +74,16 @@ typedef struct iree_task_worker_t {
   //         notification.
   iree_notification_t wake_notification;
 
+  // A LIFO mailbox for tasks from IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY scopes.
+  // Flushed into priority_task_deque and drained before any other work.
+  // LAYOUT: posted to alongside mailbox_slist and kept in the same region.
+  iree_atomic_task_slist_t priority_mailbox_slist;
+
+  // Nonzero if tasks may have been posted to priority_mailbox_slist since it
+  // was last flushed. Lets the worker skip locking the mailbox when checking
+  // for priority work on every task it runs.
+  iree_atomic_int32_t priority_mailbox_pending;
+
   // Notification signaled when the worker changes any state.
   iree_notification_t state_notification;
 
@@ -84,9 +94,9 @@ typedef struct iree_task_worker_t {
   // Globally unique worker index (worker_base_index + local worker_index).
   iree_host_size_t worker_index;
 
-  // Bit the worker represents in the various worker bitsets.
-  // Local to the executor owning the worker.
-  iree_task_affinity_set_t worker_bit;
+  // Index of the worker local to the executor owning the worker. This is the
+  // bit the worker represents in the various executor worker sets.
+  iree_host_size_t local_worker_index;
 
   // Ideal thread affinity for the worker thread.
   iree_thread_affinity_t ideal_thread_affinity;
@@ -96,13 +106,19 @@ typedef struct iree_task_worker_t {
   // some cache levels higher up with these other groups. For example, if the
   // workers in a group all share an L2 cache then the groups indicated here may
   // all share the same L3 cache.
-  iree_task_affinity_set_t constructive_sharing_mask;
+  iree_task_worker_set_t constructive_sharing_mask;
 
   // Maximum number of attempts to make when trying to steal tasks from other
-  // workers. This could be 64 (try stealing from all workers) or just a handful
-  // (try stealing from these 3 other cores that share your L3 cache).
+  // workers. This could be the worker count (try stealing from all workers) or
+  // just a handful (try stealing from these 3 other cores that share your L3
+  // cache).
   uint32_t max_theft_attempts;
 
+  // Current duration the worker will spin waiting for work before parking.
+  // Starts at the executor worker_spin_ns and in adaptive spin mode is adjusted
+  // based on how long the worker was idle. Only touched by the worker thread.
+  iree_duration_t spin_ns;
+
   // Rotation counter for work stealing (ensures we don't favor one victim).
   // Only ever touched by the worker thread as it steals work.
   iree_prng_minilcg128_state_t theft_prng;
@@ -121,7 +137,7 @@ typedef struct iree_task_worker_t {
   iree_cpu_processor_tag_t processor_tag;
 
   // Destructive interference padding between the mailbox and local task queue
-  // to ensure that the worker - who is pounding on local_task_queue - doesn't
+  // to ensure that the worker - who is pounding on local_task_deque - doesn't
   // contend with submissions or coordinators dropping new tasks in the mailbox.
   //
   // Today we don't need this, however on 32-bit systems or if we adjust the
@@ -137,19 +153,24 @@ typedef struct iree_task_worker_t {
   // workers.
   iree_byte_span_t local_memory;
 
-  // Worker-local FIFO queue containing the tasks that will be processed by the
-  // worker. This queue supports work-stealing by other workers if they run out
-  // of work of their own.
+  // Worker-local lock-free deque containing the tasks that will be processed
+  // by the worker. This deque supports work-stealing by other workers if they
+  // run out of work of their own.
   // LAYOUT: must be 64b away from mailbox_slist.
-  iree_task_queue_t local_task_queue;
+  iree_task_deque_t local_task_deque;
+
+  // Worker-local deque for tasks from IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY
+  // scopes. The worker pops from this before local_task_deque and thieves
+  // steal from it first.
+  iree_task_deque_t priority_task_deque;
 } iree_task_worker_t;
 static_assert(offsetof(iree_task_worker_t, mailbox_slist) +
                       sizeof(iree_atomic_task_slist_t) <
                   iree_hardware_constructive_interference_size,
               "mailbox_slist must be in the first cache line");
-static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
+static_assert(offsetof(iree_task_worker_t, local_task_deque) >=
                   iree_hardware_constructive_interference_size,
-              "local_task_queue must be separated from mailbox_slist by "
+              "local_task_deque must be separated from mailbox_slist by "
               "at least a cache line");
 
 // Initializes a worker by creating its thread and configuring it for receiving
@@ -159,8 +180,9 @@ static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker);
+    iree_host_size_t stack_size, iree_thread_priority_class_t priority_class,
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker);
 
 // Requests that the worker begin exiting (if it hasn't already).
 // If the worker is actively processing tasks it will wait until it has
@@ -190,13 +212,24 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker);
 void iree_task_worker_post_tasks(iree_task_worker_t* worker,
                                  iree_task_list_t* list);
 
-// Tries to steal up to |max_tasks| from the back of the queue.
+// Posts a FIFO list of tasks from IREE_TASK_SCOPE_FLAG_HIGH_PRIORITY scopes to
+// the worker priority mailbox. The worker will run them before any normal
+// tasks it has not yet started.
+//
+// May be called from any thread (including the worker thread).
+void iree_task_worker_post_priority_tasks(iree_task_worker_t* worker,
+                                          iree_task_list_t* list);
+
+// Tries to steal up to |max_tasks| from the top of the worker deque.
 // Returns NULL if no tasks are available and otherwise up to |max_tasks| tasks
-// that were at the tail of the worker FIFO will be moved to the |target_queue|
-// and the first of the stolen tasks is returned. While tasks from the FIFO
-// are preferred this may also steal tasks from the mailbox.
+// that were at the top of the worker deque will be moved to the |target_deque|
+// and the first of the stolen tasks is returned. While tasks from the deque
+// are preferred this may also steal tasks from the mailbox. A single task from
+// the priority deque or mailbox is taken before any others if available.
+//
+// Must only be called from the thread owning |target_deque|.
 iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
+                                             iree_task_deque_t* target_deque,
                                              iree_host_size_t max_tasks);
 
 #ifdef __cplusplus
@@ -177,6 +177,12 @@ void iree_benchmark_set_bytes_processed(iree_benchmark_state_t* state,
 void iree_benchmark_set_items_processed(iree_benchmark_state_t* state,
                                         int64_t items);
 
+// Adds a `name=value` user counter reported alongside the timing.
+//
+// REQUIRES: must only be called outside of the benchmark step loop.
+void iree_benchmark_set_counter(iree_benchmark_state_t* state,
+                                const char* name, double value);
+
 //===----------------------------------------------------------------------===//
 // iree_benchmark_def_t
 //===----------------------------------------------------------------------===//
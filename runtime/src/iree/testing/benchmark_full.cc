@@ -77,6 +77,12 @@ void iree_benchmark_set_items_processed(iree_benchmark_state_t* state,
   s.SetItemsProcessed(items);
 }
 
+void iree_benchmark_set_counter(iree_benchmark_state_t* state,
+                                const char* name, double value) {
+  auto& s = GetBenchmarkState(state);
+  s.counters[name] = benchmark::Counter(value);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_benchmark_def_t
 //===----------------------------------------------------------------------===//
@@ -6,6 +6,7 @@
 
 #include "iree/tooling/buffer_view_matchers.h"
 
+#include <float.h>
 #include <math.h>
 
 #include "iree/base/internal/math.h"
@@ -62,6 +63,13 @@ static bool iree_hal_compare_strided_elements_exact(
     iree_host_size_t* out_index) {
   const iree_host_size_t element_size =
       iree_hal_element_dense_byte_count(element_type);
+  // Dense buffers are compared in bulk and only scanned element by element to
+  // find the first mismatch if they differ.
+  if (expected_stride == 1 && actual_stride == 1 &&
+      memcmp(expected_elements.data, actual_elements.data,
+             element_count * element_size) == 0) {
+    return true;
+  }
   const uint8_t* expected_ptr = expected_elements.data;
   const uint8_t* actual_ptr = actual_elements.data;
   for (iree_host_size_t i = 0; i < element_count; ++i) {
@@ -76,14 +84,125 @@ static bool iree_hal_compare_strided_elements_exact(
   return true;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute_f16(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
+// Tolerances of an approximate equality resolved for a specific element type.
+typedef struct {
+  double absolute;
+  double relative;
+  uint32_t ulp;
+} iree_hal_buffer_tolerance_t;
+
+static iree_hal_buffer_tolerance_t iree_hal_buffer_equality_tolerance(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type) {
+  iree_hal_buffer_tolerance_t tolerance = {0};
+  switch (element_type) {
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
+      tolerance.absolute = equality.f16_threshold;
+      break;
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
+      tolerance.absolute = equality.f32_threshold;
+      break;
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
+      tolerance.absolute = equality.f64_threshold;
+      break;
+    default:
+      break;
+  }
+  if (equality.mode == IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE) {
+    tolerance.relative = equality.relative_threshold;
+    tolerance.ulp = equality.ulp_threshold;
+  }
+  return tolerance;
+}
+
+// Returns true if error statistics are computed when comparing elements of
+// |element_type| with |equality|. Exact comparisons are bitwise.
+static bool iree_hal_buffer_equality_has_statistics(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type) {
+  if (equality.mode == IREE_HAL_BUFFER_EQUALITY_EXACT) return false;
+  switch (element_type) {
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the distance between two floating-point values in units in the last
+// place. Values are biased such that their unsigned integer representations
+// are ordered the same as the values themselves and -0 == +0.
+static inline uint32_t iree_hal_ulp_distance_f16(uint16_t a, uint16_t b) {
+  const uint32_t ordered_a =
+      (a & 0x8000u) ? 0x8000u - (a & 0x7FFFu) : 0x8000u + a;
+  const uint32_t ordered_b =
+      (b & 0x8000u) ? 0x8000u - (b & 0x7FFFu) : 0x8000u + b;
+  return ordered_a > ordered_b ? ordered_a - ordered_b : ordered_b - ordered_a;
+}
+
+static inline uint32_t iree_hal_ulp_distance_f32(float a, float b) {
+  uint32_t bits_a = 0;
+  uint32_t bits_b = 0;
+  memcpy(&bits_a, &a, sizeof(bits_a));
+  memcpy(&bits_b, &b, sizeof(bits_b));
+  const uint32_t ordered_a = (bits_a & 0x80000000u)
+                                 ? 0x80000000u - (bits_a & 0x7FFFFFFFu)
+                                 : 0x80000000u + bits_a;
+  const uint32_t ordered_b = (bits_b & 0x80000000u)
+                                 ? 0x80000000u - (bits_b & 0x7FFFFFFFu)
+                                 : 0x80000000u + bits_b;
+  return ordered_a > ordered_b ? ordered_a - ordered_b : ordered_b - ordered_a;
+}
+
+static inline uint64_t iree_hal_ulp_distance_f64(double a, double b) {
+  uint64_t bits_a = 0;
+  uint64_t bits_b = 0;
+  memcpy(&bits_a, &a, sizeof(bits_a));
+  memcpy(&bits_b, &b, sizeof(bits_b));
+  const uint64_t sign = 0x8000000000000000ull;
+  const uint64_t ordered_a =
+      (bits_a & sign) ? sign - (bits_a & ~sign) : sign + bits_a;
+  const uint64_t ordered_b =
+      (bits_b & sign) ? sign - (bits_b & ~sign) : sign + bits_b;
+  return ordered_a > ordered_b ? ordered_a - ordered_b : ordered_b - ordered_a;
+}
+
+// Returns true if |actual| does not match |expected|. NaNs match anything as
+// they fail all threshold comparisons.
+static inline bool iree_hal_is_mismatch_f32(float expected, float actual,
+                                            uint32_t ulp_error,
+                                            float absolute_threshold,
+                                            float relative_threshold,
+                                            uint32_t ulp_threshold) {
+  const float absolute_error = fabsf(expected - actual);
+  return (absolute_error >
+          absolute_threshold + relative_threshold * fabsf(expected)) &
+         (ulp_error > ulp_threshold);
+}
+
+static inline bool iree_hal_is_mismatch_f64(double expected, double actual,
+                                            uint64_t ulp_error,
+                                            double absolute_threshold,
+                                            double relative_threshold,
+                                            uint64_t ulp_threshold) {
+  const double absolute_error = fabs(expected - actual);
+  return (absolute_error >
+          absolute_threshold + relative_threshold * fabs(expected)) &
+         (ulp_error > ulp_threshold);
+}
+
+static bool iree_hal_compare_strided_elements_approximate_f16(
+    iree_hal_buffer_tolerance_t tolerance, iree_host_size_t element_count,
     const uint16_t* expected_ptr, iree_host_size_t expected_stride,
     const uint16_t* actual_ptr, iree_host_size_t actual_stride,
     iree_host_size_t* out_index) {
   for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabsf(iree_math_f16_to_f32(*expected_ptr) -
-              iree_math_f16_to_f32(*actual_ptr)) > equality.f16_threshold) {
+    if (iree_hal_is_mismatch_f32(
+            iree_math_f16_to_f32(*expected_ptr),
+            iree_math_f16_to_f32(*actual_ptr),
+            iree_hal_ulp_distance_f16(*expected_ptr, *actual_ptr),
+            (float)tolerance.absolute, (float)tolerance.relative,
+            tolerance.ulp)) {
       *out_index = i;
       return false;
     }
@@ -93,13 +212,17 @@ static bool iree_hal_compare_strided_elements_approximate_absolute_f16(
   return true;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute_f32(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
+static bool iree_hal_compare_strided_elements_approximate_f32(
+    iree_hal_buffer_tolerance_t tolerance, iree_host_size_t element_count,
     const float* expected_ptr, iree_host_size_t expected_stride,
     const float* actual_ptr, iree_host_size_t actual_stride,
     iree_host_size_t* out_index) {
   for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabsf(*expected_ptr - *actual_ptr) > equality.f32_threshold) {
+    if (iree_hal_is_mismatch_f32(
+            *expected_ptr, *actual_ptr,
+            iree_hal_ulp_distance_f32(*expected_ptr, *actual_ptr),
+            (float)tolerance.absolute, (float)tolerance.relative,
+            tolerance.ulp)) {
       *out_index = i;
       return false;
     }
@@ -109,13 +232,16 @@ static bool iree_hal_compare_strided_elements_approximate_absolute_f32(
   return true;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute_f64(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
+static bool iree_hal_compare_strided_elements_approximate_f64(
+    iree_hal_buffer_tolerance_t tolerance, iree_host_size_t element_count,
     const double* expected_ptr, iree_host_size_t expected_stride,
     const double* actual_ptr, iree_host_size_t actual_stride,
     iree_host_size_t* out_index) {
   for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabs(*expected_ptr - *actual_ptr) > equality.f64_threshold) {
+    if (iree_hal_is_mismatch_f64(
+            *expected_ptr, *actual_ptr,
+            iree_hal_ulp_distance_f64(*expected_ptr, *actual_ptr),
+            tolerance.absolute, tolerance.relative, tolerance.ulp)) {
       *out_index = i;
       return false;
     }
@@ -125,25 +251,27 @@ static bool iree_hal_compare_strided_elements_approximate_absolute_f64(
   return true;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute(
+static bool iree_hal_compare_strided_elements_approximate(
     iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
     iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
     iree_host_size_t expected_stride, iree_const_byte_span_t actual_elements,
     iree_host_size_t actual_stride, iree_host_size_t* out_index) {
+  const iree_hal_buffer_tolerance_t tolerance =
+      iree_hal_buffer_equality_tolerance(equality, element_type);
   switch (element_type) {
     case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
-      return iree_hal_compare_strided_elements_approximate_absolute_f16(
-          equality, element_count, (const uint16_t*)expected_elements.data,
+      return iree_hal_compare_strided_elements_approximate_f16(
+          tolerance, element_count, (const uint16_t*)expected_elements.data,
           expected_stride, (const uint16_t*)actual_elements.data, actual_stride,
           out_index);
     case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
-      return iree_hal_compare_strided_elements_approximate_absolute_f32(
-          equality, element_count, (const float*)expected_elements.data,
+      return iree_hal_compare_strided_elements_approximate_f32(
+          tolerance, element_count, (const float*)expected_elements.data,
           expected_stride, (const float*)actual_elements.data, actual_stride,
           out_index);
     case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
-      return iree_hal_compare_strided_elements_approximate_absolute_f64(
-          equality, element_count, (const double*)expected_elements.data,
+      return iree_hal_compare_strided_elements_approximate_f64(
+          tolerance, element_count, (const double*)expected_elements.data,
           expected_stride, (const double*)actual_elements.data, actual_stride,
           out_index);
     default:
@@ -166,7 +294,8 @@ static bool iree_hal_compare_strided_elements(
           element_type, element_count, expected_elements, expected_stride,
           actual_elements, actual_stride, out_index);
     case IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE:
-      return iree_hal_compare_strided_elements_approximate_absolute(
+    case IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE:
+      return iree_hal_compare_strided_elements_approximate(
           equality, element_type, element_count, expected_elements,
           expected_stride, actual_elements, actual_stride, out_index);
     default:
@@ -175,6 +304,348 @@ static bool iree_hal_compare_strided_elements(
   }
 }
 
+//===----------------------------------------------------------------------===//
+// Dense comparison with statistics
+//===----------------------------------------------------------------------===//
+
+// Elements are processed in blocks small enough to convert into stack storage.
+// Within a block each of the lanes accumulates its own partial results so that
+// the inner loop has no dependencies across elements and can be vectorized
+// without reassociating floating-point math. Partial results are folded into
+// double precision totals at the end of each block.
+#define IREE_HAL_COMPARE_BLOCK_SIZE 256
+#define IREE_HAL_COMPARE_LANE_COUNT 8
+
+typedef struct {
+  iree_hal_buffer_element_statistics_t statistics;
+  double dot_product;
+  double expected_norm_squared;
+  double actual_norm_squared;
+} iree_hal_compare_accumulator_t;
+
+typedef struct {
+  uint32_t mismatch_count[IREE_HAL_COMPARE_LANE_COUNT];
+  float max_absolute_error[IREE_HAL_COMPARE_LANE_COUNT];
+  float max_relative_error[IREE_HAL_COMPARE_LANE_COUNT];
+  uint32_t max_ulp_error[IREE_HAL_COMPARE_LANE_COUNT];
+  float dot_product[IREE_HAL_COMPARE_LANE_COUNT];
+  float expected_norm_squared[IREE_HAL_COMPARE_LANE_COUNT];
+  float actual_norm_squared[IREE_HAL_COMPARE_LANE_COUNT];
+} iree_hal_compare_lanes_f32_t;
+
+typedef struct {
+  uint32_t mismatch_count[IREE_HAL_COMPARE_LANE_COUNT];
+  double max_absolute_error[IREE_HAL_COMPARE_LANE_COUNT];
+  double max_relative_error[IREE_HAL_COMPARE_LANE_COUNT];
+  uint64_t max_ulp_error[IREE_HAL_COMPARE_LANE_COUNT];
+  double dot_product[IREE_HAL_COMPARE_LANE_COUNT];
+  double expected_norm_squared[IREE_HAL_COMPARE_LANE_COUNT];
+  double actual_norm_squared[IREE_HAL_COMPARE_LANE_COUNT];
+} iree_hal_compare_lanes_f64_t;
+
+static inline void iree_hal_compare_lane_f32(
+    iree_hal_compare_lanes_f32_t* lanes, int lane, float expected,
+    float actual, uint32_t ulp_error, float absolute_threshold,
+    float relative_threshold, uint32_t ulp_threshold) {
+  const float absolute_error = fabsf(expected - actual);
+  const float magnitude = fabsf(expected);
+  const float relative_error =
+      absolute_error / (magnitude > FLT_MIN ? magnitude : FLT_MIN);
+  lanes->mismatch_count[lane] += iree_hal_is_mismatch_f32(
+      expected, actual, ulp_error, absolute_threshold, relative_threshold,
+      ulp_threshold);
+  lanes->max_absolute_error[lane] =
+      absolute_error > lanes->max_absolute_error[lane]
+          ? absolute_error
+          : lanes->max_absolute_error[lane];
+  lanes->max_relative_error[lane] =
+      relative_error > lanes->max_relative_error[lane]
+          ? relative_error
+          : lanes->max_relative_error[lane];
+  lanes->max_ulp_error[lane] = ulp_error > lanes->max_ulp_error[lane]
+                                   ? ulp_error
+                                   : lanes->max_ulp_error[lane];
+  lanes->dot_product[lane] += expected * actual;
+  lanes->expected_norm_squared[lane] += expected * expected;
+  lanes->actual_norm_squared[lane] += actual * actual;
+}
+
+static inline void iree_hal_compare_lane_f64(
+    iree_hal_compare_lanes_f64_t* lanes, int lane, double expected,
+    double actual, uint64_t ulp_error, double absolute_threshold,
+    double relative_threshold, uint64_t ulp_threshold) {
+  const double absolute_error = fabs(expected - actual);
+  const double magnitude = fabs(expected);
+  const double relative_error =
+      absolute_error / (magnitude > DBL_MIN ? magnitude : DBL_MIN);
+  lanes->mismatch_count[lane] += iree_hal_is_mismatch_f64(
+      expected, actual, ulp_error, absolute_threshold, relative_threshold,
+      ulp_threshold);
+  lanes->max_absolute_error[lane] =
+      absolute_error > lanes->max_absolute_error[lane]
+          ? absolute_error
+          : lanes->max_absolute_error[lane];
+  lanes->max_relative_error[lane] =
+      relative_error > lanes->max_relative_error[lane]
+          ? relative_error
+          : lanes->max_relative_error[lane];
+  lanes->max_ulp_error[lane] = ulp_error > lanes->max_ulp_error[lane]
+                                   ? ulp_error
+                                   : lanes->max_ulp_error[lane];
+  lanes->dot_product[lane] += expected * actual;
+  lanes->expected_norm_squared[lane] += expected * expected;
+  lanes->actual_norm_squared[lane] += actual * actual;
+}
+
+// Accumulates |count| <= IREE_HAL_COMPARE_BLOCK_SIZE elements starting at
+// |base_index| into |accumulator|.
+static void iree_hal_compare_block_f32(
+    iree_hal_buffer_tolerance_t tolerance, iree_host_size_t base_index,
+    iree_host_size_t count, const float* IREE_RESTRICT expected,
+    const float* IREE_RESTRICT actual, const uint32_t* IREE_RESTRICT ulp_errors,
+    iree_hal_compare_accumulator_t* accumulator) {
+  const float absolute_threshold = (float)tolerance.absolute;
+  const float relative_threshold = (float)tolerance.relative;
+  iree_hal_compare_lanes_f32_t lanes;
+  memset(&lanes, 0, sizeof(lanes));
+  iree_host_size_t i = 0;
+  for (; i + IREE_HAL_COMPARE_LANE_COUNT <= count;
+       i += IREE_HAL_COMPARE_LANE_COUNT) {
+    for (int j = 0; j < IREE_HAL_COMPARE_LANE_COUNT; ++j) {
+      iree_hal_compare_lane_f32(&lanes, j, expected[i + j], actual[i + j],
+                                ulp_errors[i + j], absolute_threshold,
+                                relative_threshold, tolerance.ulp);
+    }
+  }
+  for (int j = 0; i < count; ++i, ++j) {
+    iree_hal_compare_lane_f32(&lanes, j, expected[i], actual[i], ulp_errors[i],
+                              absolute_threshold, relative_threshold,
+                              tolerance.ulp);
+  }
+
+  iree_hal_buffer_element_statistics_t* statistics = &accumulator->statistics;
+  iree_host_size_t mismatch_count = 0;
+  for (int j = 0; j < IREE_HAL_COMPARE_LANE_COUNT; ++j) {
+    mismatch_count += lanes.mismatch_count[j];
+    statistics->max_absolute_error =
+        iree_max(statistics->max_absolute_error, lanes.max_absolute_error[j]);
+    statistics->max_relative_error =
+        iree_max(statistics->max_relative_error, lanes.max_relative_error[j]);
+    statistics->max_ulp_error =
+        iree_max(statistics->max_ulp_error, lanes.max_ulp_error[j]);
+    accumulator->dot_product += lanes.dot_product[j];
+    accumulator->expected_norm_squared += lanes.expected_norm_squared[j];
+    accumulator->actual_norm_squared += lanes.actual_norm_squared[j];
+  }
+
+  // Only the first block with a mismatch needs to be rescanned for its index.
+  if (mismatch_count > 0 && statistics->mismatch_count == 0) {
+    for (i = 0; i < count; ++i) {
+      if (iree_hal_is_mismatch_f32(expected[i], actual[i], ulp_errors[i],
+                                   absolute_threshold, relative_threshold,
+                                   tolerance.ulp)) {
+        statistics->first_mismatch_index = base_index + i;
+        break;
+      }
+    }
+  }
+  statistics->mismatch_count += mismatch_count;
+}
+
+static void iree_hal_compare_block_f64(
+    iree_hal_buffer_tolerance_t tolerance, iree_host_size_t base_index,
+    iree_host_size_t count, const double* IREE_RESTRICT expected,
+    const double* IREE_RESTRICT actual,
+    const uint64_t* IREE_RESTRICT ulp_errors,
+    iree_hal_compare_accumulator_t* accumulator) {
+  iree_hal_compare_lanes_f64_t lanes;
+  memset(&lanes, 0, sizeof(lanes));
+  iree_host_size_t i = 0;
+  for (; i + IREE_HAL_COMPARE_LANE_COUNT <= count;
+       i += IREE_HAL_COMPARE_LANE_COUNT) {
+    for (int j = 0; j < IREE_HAL_COMPARE_LANE_COUNT; ++j) {
+      iree_hal_compare_lane_f64(&lanes, j, expected[i + j], actual[i + j],
+                                ulp_errors[i + j], tolerance.absolute,
+                                tolerance.relative, tolerance.ulp);
+    }
+  }
+  for (int j = 0; i < count; ++i, ++j) {
+    iree_hal_compare_lane_f64(&lanes, j, expected[i], actual[i], ulp_errors[i],
+                              tolerance.absolute, tolerance.relative,
+                              tolerance.ulp);
+  }
+
+  iree_hal_buffer_element_statistics_t* statistics = &accumulator->statistics;
+  iree_host_size_t mismatch_count = 0;
+  for (int j = 0; j < IREE_HAL_COMPARE_LANE_COUNT; ++j) {
+    mismatch_count += lanes.mismatch_count[j];
+    statistics->max_absolute_error =
+        iree_max(statistics->max_absolute_error, lanes.max_absolute_error[j]);
+    statistics->max_relative_error =
+        iree_max(statistics->max_relative_error, lanes.max_relative_error[j]);
+    statistics->max_ulp_error =
+        iree_max(statistics->max_ulp_error, lanes.max_ulp_error[j]);
+    accumulator->dot_product += lanes.dot_product[j];
+    accumulator->expected_norm_squared += lanes.expected_norm_squared[j];
+    accumulator->actual_norm_squared += lanes.actual_norm_squared[j];
+  }
+
+  if (mismatch_count > 0 && statistics->mismatch_count == 0) {
+    for (i = 0; i < count; ++i) {
+      if (iree_hal_is_mismatch_f64(expected[i], actual[i], ulp_errors[i],
+                                   tolerance.absolute, tolerance.relative,
+                                   tolerance.ulp)) {
+        statistics->first_mismatch_index = base_index + i;
+        break;
+      }
+    }
+  }
+  statistics->mismatch_count += mismatch_count;
+}
+
+static void iree_hal_compare_dense_elements_f16(
+    iree_hal_buffer_tolerance_t tolerance, iree_host_size_t element_count,
+    const uint16_t* expected, const uint16_t* actual,
+    iree_hal_compare_accumulator_t* accumulator) {
+  float expected_block[IREE_HAL_COMPARE_BLOCK_SIZE];
+  float actual_block[IREE_HAL_COMPARE_BLOCK_SIZE];
+  uint32_t ulp_errors[IREE_HAL_COMPARE_BLOCK_SIZE];
+  for (iree_host_size_t base = 0; base < element_count;
+       base += IREE_HAL_COMPARE_BLOCK_SIZE) {
+    const iree_host_size_t count =
+        iree_min(IREE_HAL_COMPARE_BLOCK_SIZE, element_count - base);
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      expected_block[i] = iree_math_f16_to_f32(expected[base + i]);
+      actual_block[i] = iree_math_f16_to_f32(actual[base + i]);
+      ulp_errors[i] =
+          iree_hal_ulp_distance_f16(expected[base + i], actual[base + i]);
+    }
+    iree_hal_compare_block_f32(tolerance, base, count, expected_block,
+                               actual_block, ulp_errors, accumulator);
+  }
+}
+
+static void iree_hal_compare_dense_elements_f32(
+    iree_hal_buffer_tolerance_t tolerance, iree_host_size_t element_count,
+    const float* expected, const float* actual,
+    iree_hal_compare_accumulator_t* accumulator) {
+  uint32_t ulp_errors[IREE_HAL_COMPARE_BLOCK_SIZE];
+  for (iree_host_size_t base = 0; base < element_count;
+       base += IREE_HAL_COMPARE_BLOCK_SIZE) {
+    const iree_host_size_t count =
+        iree_min(IREE_HAL_COMPARE_BLOCK_SIZE, element_count - base);
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      ulp_errors[i] =
+          iree_hal_ulp_distance_f32(expected[base + i], actual[base + i]);
+    }
+    iree_hal_compare_block_f32(tolerance, base, count, expected + base,
+                               actual + base, ulp_errors, accumulator);
+  }
+}
+
+static void iree_hal_compare_dense_elements_f64(
+    iree_hal_buffer_tolerance_t tolerance, iree_host_size_t element_count,
+    const double* expected, const double* actual,
+    iree_hal_compare_accumulator_t* accumulator) {
+  uint64_t ulp_errors[IREE_HAL_COMPARE_BLOCK_SIZE];
+  for (iree_host_size_t base = 0; base < element_count;
+       base += IREE_HAL_COMPARE_BLOCK_SIZE) {
+    const iree_host_size_t count =
+        iree_min(IREE_HAL_COMPARE_BLOCK_SIZE, element_count - base);
+    for (iree_host_size_t i = 0; i < count; ++i) {
+      ulp_errors[i] =
+          iree_hal_ulp_distance_f64(expected[base + i], actual[base + i]);
+    }
+    iree_hal_compare_block_f64(tolerance, base, count, expected + base,
+                               actual + base, ulp_errors, accumulator);
+  }
+}
+
+// Counts the elements that are not bitwise equal.
+static void iree_hal_compare_dense_elements_exact(
+    iree_hal_element_type_t element_type, iree_host_size_t element_count,
+    iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements,
+    iree_hal_buffer_element_statistics_t* statistics) {
+  const iree_host_size_t element_size =
+      iree_hal_element_dense_byte_count(element_type);
+  if (memcmp(expected_elements.data, actual_elements.data,
+             element_count * element_size) == 0) {
+    return;
+  }
+  const uint8_t* expected_ptr = expected_elements.data;
+  const uint8_t* actual_ptr = actual_elements.data;
+  for (iree_host_size_t i = 0; i < element_count; ++i) {
+    if (memcmp(expected_ptr, actual_ptr, element_size) != 0) {
+      if (statistics->mismatch_count == 0) {
+        statistics->first_mismatch_index = i;
+      }
+      ++statistics->mismatch_count;
+    }
+    expected_ptr += element_size;
+    actual_ptr += element_size;
+  }
+}
+
+bool iree_hal_compare_buffer_elements_with_statistics(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements,
+    iree_hal_buffer_element_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  iree_hal_compare_accumulator_t accumulator;
+  memset(&accumulator, 0, sizeof(accumulator));
+  accumulator.statistics.element_count = element_count;
+  accumulator.statistics.first_mismatch_index = element_count;
+
+  const bool has_statistics =
+      iree_hal_buffer_equality_has_statistics(equality, element_type);
+  const iree_hal_buffer_tolerance_t tolerance =
+      iree_hal_buffer_equality_tolerance(equality, element_type);
+  if (!has_statistics) {
+    iree_hal_compare_dense_elements_exact(element_type, element_count,
+                                          expected_elements, actual_elements,
+                                          &accumulator.statistics);
+  } else if (element_type == IREE_HAL_ELEMENT_TYPE_FLOAT_16) {
+    iree_hal_compare_dense_elements_f16(
+        tolerance, element_count, (const uint16_t*)expected_elements.data,
+        (const uint16_t*)actual_elements.data, &accumulator);
+  } else if (element_type == IREE_HAL_ELEMENT_TYPE_FLOAT_32) {
+    iree_hal_compare_dense_elements_f32(
+        tolerance, element_count, (const float*)expected_elements.data,
+        (const float*)actual_elements.data, &accumulator);
+  } else {
+    iree_hal_compare_dense_elements_f64(
+        tolerance, element_count, (const double*)expected_elements.data,
+        (const double*)actual_elements.data, &accumulator);
+  }
+
+  bool all_match = accumulator.statistics.mismatch_count == 0;
+  if (has_statistics) {
+    const double norm = sqrt(accumulator.expected_norm_squared) *
+                        sqrt(accumulator.actual_norm_squared);
+    if (norm > 0.0) {
+      accumulator.statistics.cosine_similarity =
+          accumulator.dot_product / norm;
+    } else {
+      // Two zero vectors are identical while a single one is orthogonal.
+      accumulator.statistics.cosine_similarity =
+          accumulator.expected_norm_squared == accumulator.actual_norm_squared
+              ? 1.0
+              : 0.0;
+    }
+    if (equality.mode == IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE &&
+        equality.min_cosine_similarity > 0.0 &&
+        !(accumulator.statistics.cosine_similarity >=
+          equality.min_cosine_similarity)) {
+      all_match = false;
+    }
+  }
+
+  *out_statistics = accumulator.statistics;
+  return all_match;
+}
+
 bool iree_hal_compare_buffer_elements_broadcast(
     iree_hal_buffer_equality_t equality,
     iree_hal_buffer_element_t expected_element, iree_host_size_t element_count,
@@ -191,9 +662,43 @@ bool iree_hal_compare_buffer_elements_elementwise(
     iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
     iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
     iree_const_byte_span_t actual_elements, iree_host_size_t* out_index) {
-  return iree_hal_compare_strided_elements(
+  iree_hal_buffer_element_statistics_t statistics;
+  const bool all_match = iree_hal_compare_buffer_elements_with_statistics(
       equality, element_type, element_count, expected_elements,
-      /*expected_stride=*/1, actual_elements, /*actual_stride=*/1, out_index);
+      actual_elements, &statistics);
+  if (!all_match) *out_index = statistics.first_mismatch_index;
+  return all_match;
+}
+
+// Appends a description of how two buffers differ based on |statistics|.
+// |expected_element| and |actual_element| are the first mismatched elements,
+// if any.
+static iree_status_t iree_hal_append_buffer_mismatch_string(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    const iree_hal_buffer_element_statistics_t* statistics,
+    iree_hal_buffer_element_t expected_element,
+    iree_hal_buffer_element_t actual_element, iree_string_builder_t* builder) {
+  if (statistics->mismatch_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_hal_append_element_mismatch_string(
+        statistics->first_mismatch_index, expected_element, actual_element,
+        builder));
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "; %" PRIhsz " of %" PRIhsz " elements differ",
+        statistics->mismatch_count, statistics->element_count));
+  } else {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "cosine similarity (%.9g) is below the minimum (%.9g)",
+        statistics->cosine_similarity, equality.min_cosine_similarity));
+  }
+  if (!iree_hal_buffer_equality_has_statistics(equality, element_type)) {
+    return iree_ok_status();
+  }
+  return iree_string_builder_append_format(
+      builder,
+      " (max absolute error %g, max relative error %g, max ULP error %" PRIu64
+      ", cosine similarity %.9g)",
+      statistics->max_absolute_error, statistics->max_relative_error,
+      statistics->max_ulp_error, statistics->cosine_similarity);
 }
 
 //===----------------------------------------------------------------------===//
@@ -505,21 +1010,28 @@ iree_status_t iree_hal_buffer_view_array_matcher_match(
   iree_const_byte_span_t actual_contents = iree_make_const_byte_span(
       actual_mapping.contents.data, actual_mapping.contents.data_length);
 
-  iree_host_size_t i = 0;
-  const bool all_match = iree_hal_compare_buffer_elements_elementwise(
-      matcher->equality, iree_hal_buffer_view_element_type(matchee),
+  const iree_hal_element_type_t element_type =
+      iree_hal_buffer_view_element_type(matchee);
+  iree_hal_buffer_element_statistics_t statistics;
+  const bool all_match = iree_hal_compare_buffer_elements_with_statistics(
+      matcher->equality, element_type,
       iree_hal_buffer_view_element_count(matchee), matcher->elements,
-      actual_contents, &i);
-  iree_hal_buffer_element_t actual_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), actual_contents, i);
-  iree_hal_buffer_element_t expected_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), matcher->elements, i);
+      actual_contents, &statistics);
+  iree_hal_buffer_element_t actual_element = {.type = element_type};
+  iree_hal_buffer_element_t expected_element = {.type = element_type};
+  if (statistics.mismatch_count > 0) {
+    actual_element = iree_hal_buffer_element_at(
+        element_type, actual_contents, statistics.first_mismatch_index);
+    expected_element = iree_hal_buffer_element_at(
+        element_type, matcher->elements, statistics.first_mismatch_index);
+  }
 
   IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&actual_mapping));
 
   if (!all_match) {
-    IREE_RETURN_IF_ERROR(iree_hal_append_element_mismatch_string(
-        i, expected_element, actual_element, builder));
+    IREE_RETURN_IF_ERROR(iree_hal_append_buffer_mismatch_string(
+        matcher->equality, element_type, &statistics, expected_element,
+        actual_element, builder));
   }
 
   *out_matched = all_match;
@@ -620,22 +1132,29 @@ iree_status_t iree_hal_buffer_view_matcher_match(
   iree_const_byte_span_t expected_contents = iree_make_const_byte_span(
       expected_mapping.contents.data, expected_mapping.contents.data_length);
 
-  iree_host_size_t i = 0;
-  const bool all_match = iree_hal_compare_buffer_elements_elementwise(
-      matcher->equality, iree_hal_buffer_view_element_type(matchee),
+  const iree_hal_element_type_t element_type =
+      iree_hal_buffer_view_element_type(matchee);
+  iree_hal_buffer_element_statistics_t statistics;
+  const bool all_match = iree_hal_compare_buffer_elements_with_statistics(
+      matcher->equality, element_type,
       iree_hal_buffer_view_element_count(matchee), expected_contents,
-      actual_contents, &i);
-  iree_hal_buffer_element_t actual_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), actual_contents, i);
-  iree_hal_buffer_element_t expected_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), expected_contents, i);
+      actual_contents, &statistics);
+  iree_hal_buffer_element_t actual_element = {.type = element_type};
+  iree_hal_buffer_element_t expected_element = {.type = element_type};
+  if (statistics.mismatch_count > 0) {
+    actual_element = iree_hal_buffer_element_at(
+        element_type, actual_contents, statistics.first_mismatch_index);
+    expected_element = iree_hal_buffer_element_at(
+        element_type, expected_contents, statistics.first_mismatch_index);
+  }
 
   IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&actual_mapping));
   IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&expected_mapping));
 
   if (!all_match) {
-    IREE_RETURN_IF_ERROR(iree_hal_append_element_mismatch_string(
-        i, expected_element, actual_element, builder));
+    IREE_RETURN_IF_ERROR(iree_hal_append_buffer_mismatch_string(
+        matcher->equality, element_type, &statistics, expected_element,
+        actual_element, builder));
   }
 
   *out_matched = all_match;
@@ -40,6 +40,10 @@ typedef enum {
   IREE_HAL_BUFFER_EQUALITY_EXACT = 0,
   // abs(a - b) <= threshold
   IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE,
+  // abs(a - b) <= threshold + relative_threshold * abs(a) or a and b are
+  // within ulp_threshold units in the last place, and the cosine similarity
+  // of all elements is >= min_cosine_similarity.
+  IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE,
 } iree_hal_buffer_equality_mode_t;
 
 // TODO(benvanik): initializers/configuration for equality comparisons.
@@ -51,8 +55,34 @@ typedef struct {
   float f16_threshold;
   float f32_threshold;
   double f64_threshold;
+  // Only used by IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE.
+  double relative_threshold;
+  uint32_t ulp_threshold;
+  // Ignored if <= 0.
+  double min_cosine_similarity;
 } iree_hal_buffer_equality_t;
 
+// Summary statistics of the differences between two buffers.
+// Error statistics are only computed for floating-point element types compared
+// approximately and are zero otherwise.
+typedef struct {
+  // Total number of elements compared.
+  iree_host_size_t element_count;
+  // Number of elements that do not match.
+  iree_host_size_t mismatch_count;
+  // Index of the first element that does not match or element_count if all
+  // elements match.
+  iree_host_size_t first_mismatch_index;
+  // Maximum abs(a - b) over all elements.
+  double max_absolute_error;
+  // Maximum abs(a - b) / abs(a) over all elements.
+  double max_relative_error;
+  // Maximum distance in units in the last place over all elements.
+  uint64_t max_ulp_error;
+  // dot(a, b) / (norm(a) * norm(b)) over all elements. 1 if both are zero.
+  double cosine_similarity;
+} iree_hal_buffer_element_statistics_t;
+
 // Variant type storing known HAL buffer elements.
 typedef struct {
   iree_hal_element_type_t type;
@@ -131,12 +161,24 @@ bool iree_hal_compare_buffer_elements_broadcast(
     iree_const_byte_span_t actual_elements, iree_host_size_t* out_index);
 
 // Returns true if all elements match based on |equality|.
-// |out_index| will contain the first index that does not match.
+// |out_index| will contain the first index that does not match or
+// |element_count| if all elements match but the buffers as a whole do not
+// (such as when below the minimum cosine similarity).
 bool iree_hal_compare_buffer_elements_elementwise(
     iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
     iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
     iree_const_byte_span_t actual_elements, iree_host_size_t* out_index);
 
+// Returns true if all elements match based on |equality| and populates
+// |out_statistics| with a summary of the differences. f16, f32, and f64
+// elements are compared in a single vectorizable pass over both buffers that
+// does not stop at the first mismatch.
+bool iree_hal_compare_buffer_elements_with_statistics(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements,
+    iree_hal_buffer_element_statistics_t* out_statistics);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_view_metadata_matcher_t
 //===----------------------------------------------------------------------===//
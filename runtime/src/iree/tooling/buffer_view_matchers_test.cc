@@ -6,6 +6,10 @@
 
 #include "iree/tooling/buffer_view_matchers.h"
 
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 #include "iree/base/api.h"
 #include "iree/base/internal/math.h"
 #include "iree/base/internal/span.h"
@@ -169,6 +173,21 @@ static const iree_hal_buffer_equality_t kApproximateEquality = ([]() {
   return equality;
 })();
 
+static iree_hal_buffer_equality_t MakeRelativeEquality(
+    float threshold, double relative_threshold, uint32_t ulp_threshold,
+    double min_cosine_similarity) {
+  iree_hal_buffer_equality_t equality;
+  memset(&equality, 0, sizeof(equality));
+  equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE;
+  equality.f16_threshold = threshold;
+  equality.f32_threshold = threshold;
+  equality.f64_threshold = threshold;
+  equality.relative_threshold = relative_threshold;
+  equality.ulp_threshold = ulp_threshold;
+  equality.min_cosine_similarity = min_cosine_similarity;
+  return equality;
+}
+
 class BufferViewMatchersTest : public ::testing::Test {
  protected:
   iree_hal_allocator_t* device_allocator_ = nullptr;
@@ -420,6 +439,103 @@ TEST_F(BufferViewMatchersTest, CompareElementwiseF64NE) {
   EXPECT_EQ(index, 1);
 }
 
+TEST_F(BufferViewMatchersTest, CompareElementwiseF32RelativeEQ) {
+  const float lhs[] = {1000.0f, -2000.0f};
+  const float rhs[] = {1000.05f, -2000.1f};
+  iree_host_size_t index = 0;
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_elementwise(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_ARRAYSIZE(lhs),
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), &index));
+  EXPECT_EQ(index, 0);
+  EXPECT_TRUE(iree_hal_compare_buffer_elements_elementwise(
+      MakeRelativeEquality(0.0f, 0.0001, 0, 0.0),
+      IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_ARRAYSIZE(lhs),
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), &index));
+}
+
+TEST_F(BufferViewMatchersTest, CompareElementwiseF32UlpEQ) {
+  const float lhs[] = {1.0f, -0.0f, -1.0f};
+  const float rhs[] = {
+      std::nextafter(1.0f, 2.0f),
+      0.0f,
+      std::nextafter(-1.0f, 0.0f),
+  };
+  iree_host_size_t index = 0;
+  EXPECT_TRUE(iree_hal_compare_buffer_elements_elementwise(
+      MakeRelativeEquality(0.0f, 0.0, 1, 0.0), IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(lhs), iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), &index));
+  const float far_rhs[] = {
+      1.0f,
+      0.0f,
+      std::nextafter(std::nextafter(-1.0f, 0.0f), 0.0f),
+  };
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_elementwise(
+      MakeRelativeEquality(0.0f, 0.0, 1, 0.0), IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_ARRAYSIZE(lhs), iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(far_rhs, sizeof(far_rhs)), &index));
+  EXPECT_EQ(index, 2);
+}
+
+TEST_F(BufferViewMatchersTest, CompareStatisticsF32) {
+  // Spans multiple blocks and ends with a partial set of lanes.
+  std::vector<float> lhs(1003);
+  for (size_t i = 0; i < lhs.size(); ++i) lhs[i] = (float)(i % 17) - 8.0f;
+  std::vector<float> rhs = lhs;
+  rhs[300] += 0.5f;
+  rhs[700] -= 2.0f;
+  iree_hal_buffer_element_statistics_t statistics;
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_with_statistics(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32, lhs.size(),
+      iree_make_const_byte_span(lhs.data(), lhs.size() * sizeof(float)),
+      iree_make_const_byte_span(rhs.data(), rhs.size() * sizeof(float)),
+      &statistics));
+  EXPECT_EQ(statistics.element_count, lhs.size());
+  EXPECT_EQ(statistics.mismatch_count, 2);
+  EXPECT_EQ(statistics.first_mismatch_index, 300);
+  EXPECT_FLOAT_EQ(statistics.max_absolute_error, 2.0);
+  EXPECT_GT(statistics.max_ulp_error, 0);
+  EXPECT_GT(statistics.cosine_similarity, 0.99);
+  EXPECT_LT(statistics.cosine_similarity, 1.0);
+}
+
+TEST_F(BufferViewMatchersTest, CompareStatisticsF16) {
+  std::vector<uint16_t> lhs(300, iree_math_f32_to_f16(1.0f));
+  std::vector<uint16_t> rhs = lhs;
+  rhs[299] = iree_math_f32_to_f16(1.5f);
+  iree_hal_buffer_element_statistics_t statistics;
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_with_statistics(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_16, lhs.size(),
+      iree_make_const_byte_span(lhs.data(), lhs.size() * sizeof(uint16_t)),
+      iree_make_const_byte_span(rhs.data(), rhs.size() * sizeof(uint16_t)),
+      &statistics));
+  EXPECT_EQ(statistics.mismatch_count, 1);
+  EXPECT_EQ(statistics.first_mismatch_index, 299);
+  EXPECT_FLOAT_EQ(statistics.max_absolute_error, 0.5);
+  EXPECT_FLOAT_EQ(statistics.max_relative_error, 0.5);
+}
+
+TEST_F(BufferViewMatchersTest, CompareCosineSimilarityF64) {
+  const double lhs[] = {1.0, 0.0};
+  const double rhs[] = {0.0, 1.0};
+  iree_hal_buffer_element_statistics_t statistics;
+  // All elements are within the absolute threshold but not similar.
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_with_statistics(
+      MakeRelativeEquality(2.0f, 0.0, 0, 0.99), IREE_HAL_ELEMENT_TYPE_FLOAT_64,
+      IREE_ARRAYSIZE(lhs), iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), &statistics));
+  EXPECT_EQ(statistics.mismatch_count, 0);
+  EXPECT_EQ(statistics.first_mismatch_index, IREE_ARRAYSIZE(lhs));
+  EXPECT_DOUBLE_EQ(statistics.cosine_similarity, 0.0);
+  EXPECT_TRUE(iree_hal_compare_buffer_elements_with_statistics(
+      MakeRelativeEquality(2.0f, 0.0, 0, 0.99), IREE_HAL_ELEMENT_TYPE_FLOAT_64,
+      IREE_ARRAYSIZE(lhs), iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(lhs, sizeof(lhs)), &statistics));
+  EXPECT_DOUBLE_EQ(statistics.cosine_similarity, 1.0);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_view_metadata_matcher_t
 //===----------------------------------------------------------------------===//
@@ -704,5 +820,25 @@ TEST_F(BufferViewMatchersTest, MismatchContentsF16) {
   EXPECT_THAT(sb.ToString(), HasSubstr("element at index 0"));
 }
 
+TEST_F(BufferViewMatchersTest, MismatchContentsF32Statistics) {
+  const float lhs_contents[] = {1.0f, 2.0f, 3.0f};
+  const float rhs_contents[] = {1.0f, 2.5f, 4.0f};
+  const iree_hal_dim_t shape[] = {3};
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto lhs,
+      CreateBufferView(shape, IREE_HAL_ELEMENT_TYPE_FLOAT_32, lhs_contents));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto rhs,
+      CreateBufferView(shape, IREE_HAL_ELEMENT_TYPE_FLOAT_32, rhs_contents));
+  auto sb = StringBuilder::MakeSystem();
+  bool match = false;
+  IREE_ASSERT_OK(iree_hal_buffer_view_match_equal(kApproximateEquality, lhs,
+                                                  rhs, sb, &match));
+  EXPECT_FALSE(match);
+  EXPECT_THAT(sb.ToString(), HasSubstr("element at index 1"));
+  EXPECT_THAT(sb.ToString(), HasSubstr("2 of 3 elements differ"));
+  EXPECT_THAT(sb.ToString(), HasSubstr("max absolute error 1"));
+}
+
 }  // namespace
 }  // namespace iree
@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
@@ -24,13 +25,28 @@ IREE_FLAG(float, expected_f32_threshold, 0.0001f,
           "Threshold under which two f32 values are considered equal.");
 IREE_FLAG(double, expected_f64_threshold, 0.0001,
           "Threshold under which two f64 values are considered equal.");
+IREE_FLAG(double, expected_relative_threshold, 0.0,
+          "Threshold relative to the magnitude of the expected value under\n"
+          "which two floating-point values are considered equal. Added to the\n"
+          "per-type absolute thresholds as `abs(a - b) <= threshold +\n"
+          "relative_threshold * abs(a)`.");
+IREE_FLAG(int32_t, expected_ulp_threshold, 0,
+          "Distance in units in the last place under which two floating-point\n"
+          "values are considered equal regardless of the other thresholds.");
+IREE_FLAG(double, expected_min_cosine_similarity, 0.0,
+          "Minimum cosine similarity between expected and actual\n"
+          "floating-point outputs treated as vectors. Ignored if <= 0.");
 
 static iree_hal_buffer_equality_t iree_tooling_equality_from_flags(void) {
   iree_hal_buffer_equality_t equality;
-  equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE;
+  memset(&equality, 0, sizeof(equality));
+  equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE;
   equality.f16_threshold = FLAG_expected_f16_threshold;
   equality.f32_threshold = FLAG_expected_f32_threshold;
   equality.f64_threshold = FLAG_expected_f64_threshold;
+  equality.relative_threshold = FLAG_expected_relative_threshold;
+  equality.ulp_threshold = (uint32_t)iree_max(0, FLAG_expected_ulp_threshold);
+  equality.min_cosine_similarity = FLAG_expected_min_cosine_similarity;
   return equality;
 }
 
@@ -6,6 +6,8 @@
 
 #include "iree/tooling/context_util.h"
 
+#include <errno.h>
+#include <inttypes.h>
 #include <memory.h>
 #include <stdio.h>
 #include <string.h>
@@ -21,6 +23,7 @@
 #include "iree/tooling/device_util.h"
 #include "iree/tooling/modules/resolver.h"
 #include "iree/tooling/parameter_util.h"
+#include "iree/tooling/startup_statistics.h"
 #include "iree/vm/bytecode/module.h"
 #include "iree/vm/dynamic/module.h"
 
@@ -42,7 +45,87 @@ IREE_FLAG(
     "  preload: read entire module into wired memory on startup.\n"
     "  mmap: maps the module file into discardable memory - can increase\n"
     "        warm-up time and variance as mapped pages are swapped\n"
-    "        by the OS.");
+    "        by the OS. Only the pages used are read from the file when\n"
+    "        combined with --module_verification=lazy (or trusted) and\n"
+    "        modules compiled with --iree-hal-lazy-executable-loading.");
+
+IREE_FLAG(
+    string, module_verification, "full",
+    "A bytecode module verification mode of ['full', 'lazy', 'trusted'].\n"
+    "  full: verify the module structure and all functions on load.\n"
+    "  lazy: verify the module structure on load and each function the\n"
+    "        first time it is called.\n"
+    "  trusted: skip structural verification and verify each function the\n"
+    "           first time it is called. Only use with modules from trusted\n"
+    "           sources as corrupted modules may crash the process.");
+
+IREE_FLAG(
+    string, module_trust_cache, "",
+    "Path to a file recording the hashes of bytecode modules that have passed\n"
+    "full verification. Modules with a recorded hash are loaded as if\n"
+    "--module_verification=trusted and modules that pass full verification\n"
+    "have their hash appended. The file is created if it does not exist.");
+
+static iree_status_t iree_tooling_parse_module_verification_flag(
+    iree_vm_bytecode_module_flags_t* out_flags) {
+  *out_flags = IREE_VM_BYTECODE_MODULE_FLAG_NONE;
+  if (strcmp(FLAG_module_verification, "full") == 0) {
+    return iree_ok_status();
+  } else if (strcmp(FLAG_module_verification, "lazy") == 0) {
+    *out_flags = IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION;
+    return iree_ok_status();
+  } else if (strcmp(FLAG_module_verification, "trusted") == 0) {
+    *out_flags = IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED;
+    return iree_ok_status();
+  }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                          "unrecognized --module_verification= value '%s'",
+                          FLAG_module_verification);
+}
+
+// Returns true in |out_found| if |hash| is recorded in the trust cache file.
+// A missing file is treated as an empty cache.
+static iree_status_t iree_tooling_module_trust_cache_lookup(
+    uint64_t hash, iree_allocator_t host_allocator, bool* out_found) {
+  *out_found = false;
+  iree_file_contents_t* contents = NULL;
+  iree_status_t status = iree_file_read_contents(
+      FLAG_module_trust_cache, IREE_FILE_READ_FLAG_DEFAULT, host_allocator,
+      &contents);
+  if (iree_status_is_not_found(status)) {
+    iree_status_ignore(status);
+    return iree_ok_status();
+  }
+  IREE_RETURN_IF_ERROR(status);
+
+  char hash_str[17];
+  snprintf(hash_str, sizeof(hash_str), "%016" PRIx64, hash);
+  iree_string_view_t remaining = iree_make_string_view(
+      (const char*)contents->const_buffer.data,
+      contents->const_buffer.data_length);
+  while (!iree_string_view_is_empty(remaining) && !*out_found) {
+    iree_string_view_t line = iree_string_view_empty();
+    iree_string_view_split(remaining, '\n', &line, &remaining);
+    *out_found = iree_string_view_equal(iree_string_view_trim(line),
+                                        iree_make_cstring_view(hash_str));
+  }
+
+  iree_file_contents_free(contents);
+  return iree_ok_status();
+}
+
+// Appends |hash| to the trust cache file.
+static iree_status_t iree_tooling_module_trust_cache_insert(uint64_t hash) {
+  FILE* file = fopen(FLAG_module_trust_cache, "ab");
+  if (!file) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open module trust cache '%s'",
+                            FLAG_module_trust_cache);
+  }
+  fprintf(file, "%016" PRIx64 "\n", hash);
+  fclose(file);
+  return iree_ok_status();
+}
 
 static iree_status_t iree_tooling_load_bytecode_module(
     iree_vm_instance_t* instance, iree_string_view_t path,
@@ -50,9 +133,15 @@ static iree_status_t iree_tooling_load_bytecode_module(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, path.data, path.size);
 
+  iree_vm_bytecode_module_flags_t module_flags =
+      IREE_VM_BYTECODE_MODULE_FLAG_NONE;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_tooling_parse_module_verification_flag(&module_flags));
+
   // Fetch the file contents into memory.
   // We could map the memory here if we wanted to and were coming from a file
   // on disk.
+  iree_time_t load_start_ns = iree_time_now();
   iree_file_contents_t* file_contents = NULL;
   if (iree_string_view_equal(path, IREE_SV("-"))) {
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -79,10 +168,55 @@ static iree_status_t iree_tooling_load_bytecode_module(
   // Try to load the module as bytecode (all we have today that we can use).
   // We could sniff the file ID and switch off to other module types.
   // The module takes ownership of the file contents (when successful).
+  iree_time_t create_start_ns = iree_time_now();
+  iree_host_size_t byte_length = file_contents->const_buffer.data_length;
+
+  // Modules that previously passed full verification are trusted. Hashing
+  // only covers the FlatBuffer and is much cheaper than verifying it.
+  iree_status_t status = iree_ok_status();
+  bool use_trust_cache = strlen(FLAG_module_trust_cache) > 0;
+  uint64_t archive_hash = 0;
+  if (use_trust_cache) {
+    status = iree_vm_bytecode_module_hash_archive(file_contents->const_buffer,
+                                                  &archive_hash);
+    bool is_trusted = false;
+    if (iree_status_is_ok(status)) {
+      status = iree_tooling_module_trust_cache_lookup(
+          archive_hash, host_allocator, &is_trusted);
+    }
+    if (is_trusted) {
+      module_flags = IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED;
+      use_trust_cache = false;
+    }
+  }
+
   iree_vm_module_t* module = NULL;
-  iree_status_t status = iree_vm_bytecode_module_create(
-      instance, file_contents->const_buffer,
-      iree_file_contents_deallocator(file_contents), host_allocator, &module);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_bytecode_module_create_with_flags(
+        instance, module_flags, file_contents->const_buffer,
+        iree_file_contents_deallocator(file_contents), host_allocator,
+        &module);
+  }
+
+  // Only modules that passed full verification are recorded.
+  if (iree_status_is_ok(status) && use_trust_cache &&
+      module_flags == IREE_VM_BYTECODE_MODULE_FLAG_NONE) {
+    status = iree_tooling_module_trust_cache_insert(archive_hash);
+    if (!iree_status_is_ok(status)) {
+      // The module owns the file contents now.
+      iree_vm_module_release(module);
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+  }
+
+  if (iree_status_is_ok(status) &&
+      iree_tooling_startup_statistics_is_enabled()) {
+    iree_time_t end_ns = iree_time_now();
+    iree_tooling_startup_statistics_record_module(
+        path, byte_length, create_start_ns - load_start_ns,
+        end_ns - create_start_ns);
+  }
 
   if (iree_status_is_ok(status)) {
     *out_module = module;
@@ -200,11 +334,16 @@ static iree_status_t iree_tooling_load_hal_async_module(
   if (iree_string_view_is_empty(default_device_uri)) {
     default_device_uri = iree_hal_default_device_uri();
   }
+  iree_time_t device_start_ns = iree_time_now();
   iree_hal_device_list_t* device_list = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_create_devices_from_flags(
               iree_hal_available_driver_registry(), default_device_uri,
               host_allocator, &device_list));
+  if (iree_tooling_startup_statistics_is_enabled()) {
+    iree_tooling_startup_statistics_record_device_creation(iree_time_now() -
+                                                           device_start_ns);
+  }
 
   // Pick a lead device we'll use for bookkeeping.
   iree_hal_device_t* device = iree_hal_device_list_at(device_list, 0);
@@ -221,6 +360,11 @@ static iree_status_t iree_tooling_load_hal_async_module(
   iree_status_t status =
       iree_hal_module_create(instance, device_list->count, device_list->devices,
                              flags, host_allocator, &module);
+  if (iree_status_is_ok(status) &&
+      iree_tooling_startup_statistics_is_enabled()) {
+    iree_hal_module_set_executable_observer(
+        module, iree_tooling_startup_statistics_executable_observer());
+  }
 
   iree_hal_device_list_free(device_list);
 
@@ -293,6 +437,11 @@ static iree_status_t iree_tooling_load_hal_inline_module(
   return status;
 }
 
+IREE_FLAG(int32_t, loader_worker_count, 0,
+          "Number of threads the HAL loader module uses to split the\n"
+          "workgroups of each dispatch in addition to the calling thread.\n"
+          "0 runs all workgroups on the calling thread.");
+
 static iree_status_t iree_tooling_load_hal_loader_module(
     iree_vm_instance_t* instance, iree_allocator_t host_allocator,
     iree_vm_module_t** out_module) {
@@ -323,8 +472,11 @@ static iree_status_t iree_tooling_load_hal_loader_module(
   iree_vm_module_t* module = NULL;
   if (iree_status_is_ok(status)) {
     iree_hal_loader_module_flags_t flags = IREE_HAL_LOADER_MODULE_FLAG_NONE;
-    status = iree_hal_loader_module_create(instance, flags, loader_count,
-                                           loaders, host_allocator, &module);
+    iree_host_size_t worker_count =
+        (iree_host_size_t)iree_max(0, FLAG_loader_worker_count);
+    status = iree_hal_loader_module_create_with_workers(
+        instance, flags, worker_count, loader_count, loaders, host_allocator,
+        &module);
   }
 
   // Always release loaders; loader module has retained them.
@@ -593,10 +745,23 @@ iree_status_t iree_tooling_create_context_from_flags(
     iree_allocator_t host_allocator, iree_vm_context_t** out_context,
     iree_hal_device_t** out_device,
     iree_hal_allocator_t** out_device_allocator) {
+  return iree_tooling_create_contexts_from_flags(
+      instance, user_module_count, user_modules, default_device_uri,
+      host_allocator, /*context_count=*/1, out_context, out_device,
+      out_device_allocator);
+}
+
+iree_status_t iree_tooling_create_contexts_from_flags(
+    iree_vm_instance_t* instance, iree_host_size_t user_module_count,
+    iree_vm_module_t** user_modules, iree_string_view_t default_device_uri,
+    iree_allocator_t host_allocator, iree_host_size_t context_count,
+    iree_vm_context_t** out_contexts, iree_hal_device_t** out_device,
+    iree_hal_allocator_t** out_device_allocator) {
   IREE_ASSERT_ARGUMENT(instance);
   IREE_ASSERT_ARGUMENT(!user_module_count || user_modules);
-  IREE_ASSERT_ARGUMENT(out_context);
-  *out_context = NULL;
+  IREE_ASSERT_ARGUMENT(context_count > 0);
+  IREE_ASSERT_ARGUMENT(out_contexts);
+  for (iree_host_size_t i = 0; i < context_count; ++i) out_contexts[i] = NULL;
   if (out_device) *out_device = NULL;
   if (out_device_allocator) *out_device_allocator = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -619,12 +784,21 @@ iree_status_t iree_tooling_create_context_from_flags(
     flags |= IREE_VM_CONTEXT_FLAG_TRACE_EXECUTION;
   }
 
-  // Create the context with the full list of resolved modules.
-  // The context retains the modules and we can release them afterward.
-  iree_vm_context_t* context = NULL;
-  iree_status_t status = iree_vm_context_create_with_modules(
-      instance, flags, resolved_list.count, resolved_list.values,
-      host_allocator, &context);
+  // Create the contexts with the full list of resolved modules.
+  // The contexts retain the modules and we can release them afterward.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < context_count && iree_status_is_ok(status);
+       ++i) {
+    iree_time_t start_ns = iree_time_now();
+    status = iree_vm_context_create_with_modules(
+        instance, flags, resolved_list.count, resolved_list.values,
+        host_allocator, &out_contexts[i]);
+    if (iree_status_is_ok(status) &&
+        iree_tooling_startup_statistics_is_enabled()) {
+      iree_tooling_startup_statistics_record_context_creation(iree_time_now() -
+                                                              start_ns);
+    }
+  }
   iree_tooling_module_list_reset(&resolved_list);
 
   // If no device allocator was created we'll create a default one just so that
@@ -637,7 +811,6 @@ iree_status_t iree_tooling_create_context_from_flags(
   }
 
   if (iree_status_is_ok(status)) {
-    *out_context = context;
     if (out_device_allocator) {
       *out_device_allocator = device_allocator;
     } else {
@@ -651,7 +824,10 @@ iree_status_t iree_tooling_create_context_from_flags(
   } else {
     iree_hal_allocator_release(device_allocator);
     iree_hal_device_release(device);
-    iree_vm_context_release(context);
+    for (iree_host_size_t i = 0; i < context_count; ++i) {
+      iree_vm_context_release(out_contexts[i]);
+      out_contexts[i] = NULL;
+    }
   }
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -102,6 +102,19 @@ iree_status_t iree_tooling_create_context_from_flags(
     iree_hal_device_t** out_device,
     iree_hal_allocator_t** out_device_allocator);
 
+// Creates |context_count| VM contexts like
+// iree_tooling_create_context_from_flags, all sharing the same resolved
+// modules and devices but each with its own module state. Useful to run
+// independent sessions of the same program concurrently.
+// |out_contexts| must have room for |context_count| contexts, each of which
+// must be released by the caller.
+iree_status_t iree_tooling_create_contexts_from_flags(
+    iree_vm_instance_t* instance, iree_host_size_t user_module_count,
+    iree_vm_module_t** user_modules, iree_string_view_t default_device_uri,
+    iree_allocator_t host_allocator, iree_host_size_t context_count,
+    iree_vm_context_t** out_contexts, iree_hal_device_t** out_device,
+    iree_hal_allocator_t** out_device_allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -9,7 +9,9 @@
 #include "iree/base/internal/call_once.h"
 #include "iree/base/internal/flags.h"
 #include "iree/hal/drivers/init.h"
+#include "iree/hal/local/dispatch_statistics.h"
 #include "iree/hal/utils/allocators.h"
+#include "iree/hal/utils/local_channel.h"
 #include "iree/hal/utils/mpi_channel_provider.h"
 
 //===----------------------------------------------------------------------===//
@@ -307,6 +309,13 @@ static iree_status_t iree_hal_configure_allocator_from_flags(
 // Collectives configuration
 //===----------------------------------------------------------------------===//
 
+IREE_FLAG(
+    bool, device_local_collectives, false,
+    "Connects all devices specified with --device= with in-process\n"
+    "shared-memory collective channels instead of MPI. Each device is\n"
+    "assigned the rank matching the order it was specified in. Only devices\n"
+    "executing on the host (such as local-task) support local channels.");
+
 // TODO(multi-device): support more provider types/have a provider registry.
 // MPI is insufficient for heterogeneous/multi-device configurations. Currently
 // we set the same provider for every device and that'll really confuse things
@@ -384,8 +393,19 @@ iree_status_t iree_hal_create_devices_from_flags(
       z0, iree_hal_device_list_allocate(flag_list.count, host_allocator,
                                         &device_list));
 
+  // Optionally connect all devices with in-process collectives. The providers
+  // share state and each device retains its own.
+  iree_hal_channel_provider_t*
+      local_channel_providers[IREE_HAL_LOCAL_CHANNEL_MAX_COUNT] = {NULL};
+  const bool use_local_collectives = FLAG_device_local_collectives;
   iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < flag_list.count; ++i) {
+  if (use_local_collectives) {
+    status = iree_hal_local_channel_provider_create(
+        flag_list.count, host_allocator, local_channel_providers);
+  }
+
+  for (iree_host_size_t i = 0; i < flag_list.count && iree_status_is_ok(status);
+       ++i) {
     // Create the device, which may be slow and dynamically load big
     // dependencies (CUDA, Vulkan, etc).
     iree_hal_device_t* device = NULL;
@@ -405,7 +425,12 @@ iree_status_t iree_hal_create_devices_from_flags(
     // do the same to interface with their own implementations. Note that this
     // currently sets the same provider for all devices.
     if (iree_status_is_ok(status)) {
-      status = iree_hal_device_set_default_channel_provider(device);
+      if (use_local_collectives) {
+        iree_hal_device_replace_channel_provider(device,
+                                                 local_channel_providers[i]);
+      } else {
+        status = iree_hal_device_set_default_channel_provider(device);
+      }
     }
 
     // Add the device to the list to retain it for the caller.
@@ -413,8 +438,10 @@ iree_status_t iree_hal_create_devices_from_flags(
       status = iree_hal_device_list_push_back(device_list, device);
     }
     iree_hal_device_release(device);
-
-    if (!iree_status_is_ok(status)) break;
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(local_channel_providers);
+       ++i) {
+    iree_hal_channel_provider_release(local_channel_providers[i]);
   }
 
   if (iree_status_is_ok(status)) {
@@ -441,15 +468,44 @@ IREE_FLAG(
     "Optional file path/prefix for profiling file output. Some\n"
     "implementations may require a file name in order to capture profiling\n"
     "information.");
+IREE_FLAG(
+    bool, print_dispatch_statistics, false,
+    "Prints a table of per-dispatch call counts, times, and bandwidth to\n"
+    "stderr after profiling ends. Implies --device_profiling_mode=dispatch.\n"
+    "Only supported by the local-sync and local-task devices.");
+IREE_FLAG(
+    bool, print_dispatch_hardware_counters, false,
+    "Prints the per-dispatch statistics table including hardware counters\n"
+    "(IPC, cache misses per thousand instructions, and the memory bandwidth\n"
+    "estimated from last-level cache misses) sampled around each call.\n"
+    "Implies --device_profiling_mode=executable and\n"
+    "--print_dispatch_statistics. Requires perf_event_open access on Linux.");
+
+static bool iree_hal_is_printing_dispatch_statistics_from_flags(void) {
+  return FLAG_print_dispatch_statistics ||
+         FLAG_print_dispatch_hardware_counters;
+}
+
+static bool iree_hal_is_profiling_from_flags(void) {
+  return strlen(FLAG_device_profiling_mode) > 0 ||
+         iree_hal_is_printing_dispatch_statistics_from_flags();
+}
 
 iree_status_t iree_hal_begin_profiling_from_flags(iree_hal_device_t* device) {
   if (!device) return iree_ok_status();
+  if (!iree_hal_is_profiling_from_flags()) return iree_ok_status();
 
   // Today we treat these as exclusive. When we have more implementations we
   // can figure out how best to combine them.
   iree_hal_device_profiling_options_t options = {0};
+  if (FLAG_print_dispatch_statistics) {
+    options.mode |= IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS;
+  }
+  if (FLAG_print_dispatch_hardware_counters) {
+    options.mode |= IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS;
+  }
   if (strlen(FLAG_device_profiling_mode) == 0) {
-    return iree_ok_status();
+    // Only implied modes.
   } else if (strcmp(FLAG_device_profiling_mode, "queue") == 0) {
     options.mode |= IREE_HAL_DEVICE_PROFILING_MODE_QUEUE_OPERATIONS;
   } else if (strcmp(FLAG_device_profiling_mode, "dispatch") == 0) {
@@ -470,6 +526,10 @@ iree_status_t iree_hal_begin_profiling_from_flags(iree_hal_device_t* device) {
 
 iree_status_t iree_hal_end_profiling_from_flags(iree_hal_device_t* device) {
   if (!device) return iree_ok_status();
-  if (strlen(FLAG_device_profiling_mode) == 0) return iree_ok_status();
-  return iree_hal_device_profiling_end(device);
+  if (!iree_hal_is_profiling_from_flags()) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(iree_hal_device_profiling_end(device));
+  if (iree_hal_is_printing_dispatch_statistics_from_flags()) {
+    IREE_RETURN_IF_ERROR(iree_hal_local_dispatch_statistics_fprint(stderr));
+  }
+  return iree_ok_status();
 }
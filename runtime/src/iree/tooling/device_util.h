@@ -52,11 +52,15 @@ iree_status_t iree_hal_device_set_default_channel_provider(
 
 // Equivalent to iree_hal_device_profiling_begin with options sourced from
 // command line flags. No-op if profiling is not enabled.
+// --print_dispatch_statistics implies the dispatch profiling mode and
+// --print_dispatch_hardware_counters implies the executable profiling mode.
 // Must be matched with a call to iree_hal_end_profiling_from_flags.
 iree_status_t iree_hal_begin_profiling_from_flags(iree_hal_device_t* device);
 
 // Equivalent to iree_hal_device_profiling_end with options sourced from
 // command line flags. No-op if profiling is not enabled.
+// Prints the per-dispatch statistics table to stderr if
+// --print_dispatch_statistics or --print_dispatch_hardware_counters is set.
 iree_status_t iree_hal_end_profiling_from_flags(iree_hal_device_t* device);
 
 #ifdef __cplusplus
@@ -6,11 +6,22 @@
 
 #include "iree/tooling/function_io.h"
 
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/flags.h"
+#include "iree/io/memory_stream.h"
 #include "iree/io/stdio_stream.h"
 #include "iree/io/stream.h"
 #include "iree/modules/hal/module.h"
 #include "iree/tooling/numpy_io.h"
 
+IREE_FLAG(bool, input_mmap, false,
+          "Maps .npy input files into memory and uses their contents in place\n"
+          "when the device can import host memory instead of reading them\n"
+          "into new allocations. Mapped inputs are read-only and the files\n"
+          "must not be modified (or used as outputs) while in use. This also\n"
+          "applies to `--expected_output=@file.npy` so that large expected\n"
+          "outputs are compared directly against the mapped files.");
+
 //===----------------------------------------------------------------------===//
 // Utilities
 //===----------------------------------------------------------------------===//
@@ -21,6 +32,37 @@
 // kind of registry that the main iree_io_stream_open uses or allow
 // iree_io_file_handle_t to carry a factory function for opening the handles of
 // certain types. For now we shim things here at the leaf.
+static void iree_io_mapped_stream_release(void* user_data,
+                                          iree_io_stream_t* stream) {
+  iree_file_contents_free((iree_file_contents_t*)user_data);
+}
+
+// Maps the file at |path| into memory and wraps it in a mappable stream.
+// The mapping is released when the stream and all buffers imported from it
+// are released.
+static iree_status_t iree_io_stream_open_mapped_path(
+    iree_string_view_t path, iree_allocator_t host_allocator,
+    iree_io_stream_t** out_stream) {
+  char* path_str = (char*)iree_alloca(path.size + 1);
+  memcpy(path_str, path.data, path.size);
+  path_str[path.size] = 0;
+  iree_file_contents_t* contents = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_file_map_contents_readonly(path_str, host_allocator, &contents));
+  iree_io_memory_stream_release_callback_t release_callback = {
+      .fn = iree_io_mapped_stream_release,
+      .user_data = contents,
+  };
+  iree_status_t status = iree_io_memory_stream_wrap(
+      IREE_IO_STREAM_MODE_READABLE | IREE_IO_STREAM_MODE_SEEKABLE |
+          IREE_IO_STREAM_MODE_MAPPABLE,
+      contents->buffer, release_callback, host_allocator, out_stream);
+  if (!iree_status_is_ok(status)) {
+    iree_file_contents_free(contents);
+  }
+  return status;
+}
+
 static iree_status_t iree_io_stream_open_path(iree_io_stdio_stream_mode_t mode,
                                               iree_string_view_t path,
                                               uint64_t file_offset,
@@ -34,7 +76,19 @@ static iree_status_t iree_io_stream_open_path(iree_io_stdio_stream_mode_t mode,
   iree_status_t status = iree_ok_status();
   iree_io_stream_t* stream = NULL;
 
-  status = iree_io_stdio_stream_open(mode, path, host_allocator, &stream);
+  // Read-only files are mapped if requested so that their contents can be used
+  // in place. Files that cannot be mapped (empty files, pipes, etc) fall back
+  // to stdio.
+  if (FLAG_input_mmap && mode == IREE_IO_STDIO_STREAM_MODE_READ) {
+    status = iree_io_stream_open_mapped_path(path, host_allocator, &stream);
+    if (!iree_status_is_ok(status)) {
+      status = iree_status_ignore(status);
+      stream = NULL;
+    }
+  }
+  if (!stream) {
+    status = iree_io_stdio_stream_open(mode, path, host_allocator, &stream);
+  }
   if (iree_status_is_ok(status) && file_offset > 0) {
     status = iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, file_offset);
   }
@@ -568,7 +622,7 @@ static iree_status_t iree_tooling_parse_ndarray_into(
   };
   iree_hal_buffer_view_t* buffer_view = NULL;
   iree_status_t status = iree_numpy_npy_load_ndarray(
-      stream, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params, device,
+      stream, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, buffer_params, device,
       device_allocator, &buffer_view);
 
   if (iree_status_is_ok(status)) {
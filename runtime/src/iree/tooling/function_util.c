@@ -52,13 +52,41 @@ iree_status_t iree_tooling_append_async_fences(
   return status;
 }
 
+// Returns true if all memory heaps of |allocator| are host-visible, as with
+// local CPU devices and most integrated GPUs. Device memory on such allocators
+// can be read by the host as efficiently as host-local memory.
+static bool iree_tooling_allocator_is_unified(iree_hal_allocator_t* allocator) {
+  iree_hal_allocator_memory_heap_t heaps[8];
+  iree_host_size_t heap_count = 0;
+  iree_status_t status = iree_hal_allocator_query_memory_heaps(
+      allocator, IREE_ARRAYSIZE(heaps), heaps, &heap_count);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+  for (iree_host_size_t i = 0; i < heap_count; ++i) {
+    if (!iree_all_bits_set(heaps[i].type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
+      return false;
+    }
+  }
+  return heap_count > 0;
+}
+
 static bool iree_tooling_requires_buffer_transfer(
     iree_hal_buffer_t* source_buffer, iree_hal_device_t* target_device,
-    iree_hal_buffer_params_t target_params) {
+    iree_hal_buffer_params_t target_params, bool is_unified) {
   // TODO(benvanik): if source/target devices don't match or can't be imported
   // then we need a transfer.
+  iree_hal_memory_type_t required_type = target_params.type;
+  if (is_unified && iree_all_bits_set(required_type,
+                                      IREE_HAL_MEMORY_TYPE_HOST_LOCAL)) {
+    // Host-visible memory on unified devices can be mapped in place; copying
+    // it into host-local memory would only add a full copy of each buffer.
+    required_type = (required_type & ~IREE_HAL_MEMORY_TYPE_HOST_LOCAL) |
+                    IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  }
   return !iree_all_bits_set(iree_hal_buffer_memory_type(source_buffer),
-                            target_params.type) ||
+                            required_type) ||
          !iree_all_bits_set(iree_hal_buffer_allowed_usage(source_buffer),
                             target_params.usage);
 }
@@ -117,7 +145,8 @@ static iree_status_t iree_tooling_submit_transfer(
   if (iree_status_is_ok(status)) {
     status = iree_hal_device_queue_execute(
         device, queue_affinity, iree_hal_fence_semaphore_list(wait_fence),
-        iree_hal_fence_semaphore_list(signal_fence), 1, &command_buffer);
+        iree_hal_fence_semaphore_list(signal_fence), 1, &command_buffer,
+        /*binding_tables=*/NULL);
   }
 
   if (iree_status_is_ok(status) && needs_wait) {
@@ -140,6 +169,7 @@ iree_status_t iree_tooling_transfer_variants(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // If all buffers are already host-accessible we can skip the transfer.
+  bool is_unified = iree_tooling_allocator_is_unified(target_allocator);
   bool requires_transfer = false;
   for (iree_host_size_t i = 0; i < iree_vm_list_size(list); ++i) {
     iree_vm_ref_t value = iree_vm_ref_null();
@@ -147,7 +177,7 @@ iree_status_t iree_tooling_transfer_variants(
     if (iree_hal_buffer_isa(value)) {
       iree_hal_buffer_t* source_buffer = iree_hal_buffer_deref(value);
       if (iree_tooling_requires_buffer_transfer(source_buffer, target_device,
-                                                target_params)) {
+                                                target_params, is_unified)) {
         requires_transfer = true;
         break;
       }
@@ -156,7 +186,7 @@ iree_status_t iree_tooling_transfer_variants(
       iree_hal_buffer_t* source_buffer =
           iree_hal_buffer_view_buffer(source_view);
       if (iree_tooling_requires_buffer_transfer(source_buffer, target_device,
-                                                target_params)) {
+                                                target_params, is_unified)) {
         requires_transfer = true;
         break;
       }
@@ -184,7 +214,7 @@ iree_status_t iree_tooling_transfer_variants(
       if (iree_hal_buffer_isa(value)) {
         iree_hal_buffer_t* source_buffer = iree_hal_buffer_deref(value);
         if (!iree_tooling_requires_buffer_transfer(source_buffer, target_device,
-                                                   target_params)) {
+                                                   target_params, is_unified)) {
           // Already ok.
           continue;
         }
@@ -201,7 +231,7 @@ iree_status_t iree_tooling_transfer_variants(
         iree_hal_buffer_t* source_buffer =
             iree_hal_buffer_view_buffer(source_view);
         if (!iree_tooling_requires_buffer_transfer(source_buffer, target_device,
-                                                   target_params)) {
+                                                   target_params, is_unified)) {
           // Already ok.
           continue;
         }
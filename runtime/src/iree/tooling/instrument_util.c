@@ -10,8 +10,12 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/modules/hal/types.h"
+#include "iree/schemas/instruments/dispatch.h"
 
 //===----------------------------------------------------------------------===//
 // Instrument data management
@@ -20,6 +24,15 @@
 IREE_FLAG(string, instrument_file, "",
           "File to populate with instrument data from the program.");
 
+IREE_FLAG(int32_t, instrument_drain_interval_ms, 0,
+          "Continuously drains instrument ringbuffers into the\n"
+          "--instrument_file= from a background thread every N milliseconds\n"
+          "while the program runs. This allows capturing more data than fits\n"
+          "in the ringbuffer and is intended to be paired with sampled\n"
+          "instrumentation for long-running programs. Ringbuffers must be\n"
+          "host-mappable. When 0 the ringbuffers are written once after the\n"
+          "program completes.");
+
 static iree_status_t iree_tooling_write_iovec(iree_vm_ref_t iovec, FILE* file) {
   IREE_TRACE_ZONE_BEGIN(z0);
   bool write_ok = false;
@@ -50,24 +63,12 @@ static iree_status_t iree_tooling_write_iovec(iree_vm_ref_t iovec, FILE* file) {
                                      "failed to write iovec to file");
 }
 
-iree_status_t iree_tooling_process_instrument_data(
-    iree_vm_context_t* context, iree_allocator_t host_allocator) {
-  // If no flag was specified we ignore instrument data.
-  if (strlen(FLAG_instrument_file) == 0) return iree_ok_status();
-
+// Queries the instrument data iovecs from all modules in |context|.
+static iree_status_t iree_tooling_query_instrument_iovecs(
+    iree_vm_context_t* context, iree_allocator_t host_allocator,
+    iree_vm_list_t** out_iovec_list) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_TEXT(z0, FLAG_instrument_file);
-
-  // Open the file for overwriting. We do this even if there is no instrument
-  // data in the program as we'd rather have the user end up with a 0-byte file
-  // when they explicitly ask for it instead of stale data from previous runs.
-  FILE* file = fopen(FLAG_instrument_file, "wb");
-  if (!file) {
-    IREE_TRACE_ZONE_END(z0);
-    return iree_make_status(iree_status_code_from_errno(errno),
-                            "failed to open instrument file '%s' for writing",
-                            FLAG_instrument_file);
-  }
+  *out_iovec_list = NULL;
 
   // Each query function pushes iovecs on to a list we provide; we create one
   // list and use that across all of them.
@@ -112,6 +113,42 @@ iree_status_t iree_tooling_process_instrument_data(
     }
   }
 
+  iree_vm_list_release(input_list);
+  if (iree_status_is_ok(status)) {
+    *out_iovec_list = iovec_list;
+  } else {
+    iree_vm_list_release(iovec_list);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_tooling_process_instrument_data(
+    iree_vm_context_t* context, iree_allocator_t host_allocator) {
+  // If no flag was specified we ignore instrument data.
+  if (strlen(FLAG_instrument_file) == 0) return iree_ok_status();
+
+  // When draining the drainer owns the file and has already written all data.
+  if (FLAG_instrument_drain_interval_ms > 0) return iree_ok_status();
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, FLAG_instrument_file);
+
+  // Open the file for overwriting. We do this even if there is no instrument
+  // data in the program as we'd rather have the user end up with a 0-byte file
+  // when they explicitly ask for it instead of stale data from previous runs.
+  FILE* file = fopen(FLAG_instrument_file, "wb");
+  if (!file) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open instrument file '%s' for writing",
+                            FLAG_instrument_file);
+  }
+
+  iree_vm_list_t* iovec_list = NULL;
+  iree_status_t status = iree_tooling_query_instrument_iovecs(
+      context, host_allocator, &iovec_list);
+
   if (iree_status_is_ok(status)) {
     for (iree_host_size_t i = 0; i < iree_vm_list_size(iovec_list); ++i) {
       iree_vm_ref_t iovec = iree_vm_ref_null();
@@ -122,9 +159,401 @@ iree_status_t iree_tooling_process_instrument_data(
     }
   }
 
-  iree_vm_list_release(input_list);
   iree_vm_list_release(iovec_list);
   fclose(file);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// Instrument data draining
+//===----------------------------------------------------------------------===//
+
+// A device ringbuffer being drained.
+typedef struct iree_tooling_instrument_ring_t {
+  // Buffer view exported by the program aliasing the device ringbuffer.
+  iree_hal_buffer_view_t* buffer_view;
+  // Range of iovecs in the drainer iovec list with the metadata chunks that
+  // describe the ringbuffer contents.
+  iree_host_size_t metadata_begin;
+  iree_host_size_t metadata_end;
+  // Power-of-two size of the ringbuffer storage excluding padding.
+  uint64_t ring_size;
+  // Write head offset up to which entries have been drained.
+  uint64_t read_offset;
+} iree_tooling_instrument_ring_t;
+
+typedef enum iree_tooling_instrument_drainer_state_e {
+  IREE_TOOLING_INSTRUMENT_DRAINER_STATE_RUNNING = 0,
+  IREE_TOOLING_INSTRUMENT_DRAINER_STATE_EXITING,
+  IREE_TOOLING_INSTRUMENT_DRAINER_STATE_ZOMBIE,
+} iree_tooling_instrument_drainer_state_t;
+
+struct iree_tooling_instrument_drainer_t {
+  iree_allocator_t host_allocator;
+  FILE* file;
+  // iovecs returned by the program query functions.
+  iree_vm_list_t* iovec_list;
+  iree_host_size_t ring_count;
+  iree_tooling_instrument_ring_t* rings;
+  // Ring whose metadata chunks were most recently written to the file. Spans
+  // are interpreted by readers using the metadata preceding them.
+  iree_host_size_t metadata_ring;
+  // Scratch storage for assembling spans of entries.
+  iree_host_size_t staging_capacity;
+  uint8_t* staging;
+  // Total bytes of entries overwritten before they could be drained.
+  uint64_t dropped_bytes;
+  // iree_tooling_instrument_drainer_state_t.
+  iree_atomic_int32_t state;
+  iree_notification_t state_notification;
+  iree_thread_t* thread;
+  // Sticky error from the drain thread. Only valid once it has exited.
+  iree_status_t thread_status;
+};
+
+static iree_status_t iree_tooling_write_bytes(const void* data,
+                                              iree_host_size_t length,
+                                              FILE* file) {
+  if (fwrite(data, 1, length, file) != length) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to write instrument data to file");
+  }
+  return iree_ok_status();
+}
+
+// Writes the metadata chunks of |ring_index| to the file if the last metadata
+// written was from another ring.
+static iree_status_t iree_tooling_instrument_drainer_write_metadata(
+    iree_tooling_instrument_drainer_t* drainer, iree_host_size_t ring_index) {
+  if (drainer->metadata_ring == ring_index) return iree_ok_status();
+  const iree_tooling_instrument_ring_t* ring = &drainer->rings[ring_index];
+  for (iree_host_size_t i = ring->metadata_begin; i < ring->metadata_end; ++i) {
+    iree_vm_ref_t iovec = iree_vm_ref_null();
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_ref_assign(drainer->iovec_list, i, &iovec));
+    IREE_RETURN_IF_ERROR(iree_tooling_write_iovec(iovec, drainer->file));
+  }
+  drainer->metadata_ring = ring_index;
+  return iree_ok_status();
+}
+
+// Returns the current write head offset of the ringbuffer stored in
+// |ring_data|.
+static uint64_t iree_tooling_instrument_ring_write_offset(
+    iree_byte_span_t ring_data) {
+  // The write head is updated atomically by dispatches on the device.
+  return (uint64_t)iree_atomic_load_int64(
+      (iree_atomic_int64_t*)(ring_data.data + ring_data.data_length - 8),
+      iree_memory_order_acquire);
+}
+
+// Copies all entries written to the ring since the last drain into a span.
+// Entries are walked individually as those near the end of the ring spill into
+// the padding instead of wrapping and a plain modular copy would tear them.
+static iree_status_t iree_tooling_instrument_drainer_drain_ring(
+    iree_tooling_instrument_drainer_t* drainer, iree_host_size_t ring_index,
+    iree_byte_span_t ring_data) {
+  iree_tooling_instrument_ring_t* ring = &drainer->rings[ring_index];
+  const uint64_t offset_mask = ring->ring_size - 1;
+
+  // If we've been lapped all entries since the last drain are gone. Entry
+  // boundaries are only known at observed write head offsets so skip ahead.
+  uint64_t write_offset = iree_tooling_instrument_ring_write_offset(ring_data);
+  if (write_offset - ring->read_offset > ring->ring_size) {
+    drainer->dropped_bytes += write_offset - ring->read_offset;
+    ring->read_offset = write_offset;
+    return iree_ok_status();
+  }
+
+  // Gather entries. Entries are reserved by bumping the write head prior to
+  // being written and ones still being written by the device are left for the
+  // next drain.
+  uint64_t offset = ring->read_offset;
+  iree_host_size_t span_length = 0;
+  while (offset < write_offset) {
+    const uint8_t* entry_ptr = ring_data.data + (offset & offset_mask);
+    uint64_t entry_size = iree_instrument_dispatch_entry_size(
+        (const iree_instrument_dispatch_header_t*)entry_ptr);
+    if (entry_size == 0 || offset + entry_size > write_offset ||
+        span_length + entry_size > drainer->staging_capacity) {
+      break;
+    }
+    memcpy(drainer->staging + span_length, entry_ptr, entry_size);
+    span_length += entry_size;
+    offset += entry_size;
+  }
+  if (span_length == 0) return iree_ok_status();
+
+  // Discard the span if the device lapped us while we were copying.
+  uint64_t new_write_offset =
+      iree_tooling_instrument_ring_write_offset(ring_data);
+  if (new_write_offset - ring->read_offset > ring->ring_size) {
+    drainer->dropped_bytes += new_write_offset - ring->read_offset;
+    ring->read_offset = new_write_offset;
+    return iree_ok_status();
+  }
+
+  IREE_RETURN_IF_ERROR(
+      iree_tooling_instrument_drainer_write_metadata(drainer, ring_index));
+  iree_instrument_dispatch_span_header_t span_header = {
+      .ring_size = ring->ring_size,
+      .ring_offset = ring->read_offset,
+  };
+  iree_idbts_chunk_header_t chunk_header = {
+      .magic = IREE_IDBTS_CHUNK_MAGIC,
+      .type = IREE_IDBTS_CHUNK_TYPE_DISPATCH_RINGBUFFER_SPAN,
+      .version = 0,
+      .content_length = sizeof(span_header) + span_length,
+  };
+  IREE_RETURN_IF_ERROR(iree_tooling_write_bytes(
+      &chunk_header, sizeof(chunk_header), drainer->file));
+  IREE_RETURN_IF_ERROR(iree_tooling_write_bytes(
+      &span_header, sizeof(span_header), drainer->file));
+  IREE_RETURN_IF_ERROR(
+      iree_tooling_write_bytes(drainer->staging, span_length, drainer->file));
+  ring->read_offset = offset;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_tooling_instrument_drainer_drain(
+    iree_tooling_instrument_drainer_t* drainer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < drainer->ring_count; ++i) {
+    iree_hal_buffer_mapping_t mapping;
+    status = iree_hal_buffer_map_range(
+        iree_hal_buffer_view_buffer(drainer->rings[i].buffer_view),
+        IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+        IREE_WHOLE_BUFFER, &mapping);
+    if (!iree_status_is_ok(status)) break;
+    status = iree_tooling_instrument_drainer_drain_ring(drainer, i,
+                                                        mapping.contents);
+    IREE_IGNORE_ERROR(iree_hal_buffer_unmap_range(&mapping));
+    if (!iree_status_is_ok(status)) break;
+  }
+  if (iree_status_is_ok(status)) fflush(drainer->file);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static bool iree_tooling_instrument_drainer_is_exiting(
+    iree_tooling_instrument_drainer_t* drainer) {
+  return iree_atomic_load_int32(&drainer->state, iree_memory_order_acquire) !=
+         IREE_TOOLING_INSTRUMENT_DRAINER_STATE_RUNNING;
+}
+
+static bool iree_tooling_instrument_drainer_is_zombie(
+    iree_tooling_instrument_drainer_t* drainer) {
+  return iree_atomic_load_int32(&drainer->state, iree_memory_order_acquire) ==
+         IREE_TOOLING_INSTRUMENT_DRAINER_STATE_ZOMBIE;
+}
+
+static int iree_tooling_instrument_drainer_main(void* entry_arg) {
+  iree_tooling_instrument_drainer_t* drainer =
+      (iree_tooling_instrument_drainer_t*)entry_arg;
+  iree_status_t status = iree_ok_status();
+  while (iree_status_is_ok(status)) {
+    if (iree_notification_await(
+            &drainer->state_notification,
+            (iree_condition_fn_t)iree_tooling_instrument_drainer_is_exiting,
+            drainer,
+            iree_make_timeout_ms(FLAG_instrument_drain_interval_ms))) {
+      break;  // exit requested
+    }
+    status = iree_tooling_instrument_drainer_drain(drainer);
+  }
+  drainer->thread_status = status;
+  iree_atomic_store_int32(&drainer->state,
+                          IREE_TOOLING_INSTRUMENT_DRAINER_STATE_ZOMBIE,
+                          iree_memory_order_release);
+  iree_notification_post(&drainer->state_notification, IREE_ALL_WAITERS);
+  return 0;
+}
+
+static void iree_tooling_instrument_drainer_free(
+    iree_tooling_instrument_drainer_t* drainer) {
+  iree_allocator_t host_allocator = drainer->host_allocator;
+  for (iree_host_size_t i = 0; i < drainer->ring_count; ++i) {
+    iree_hal_buffer_view_release(drainer->rings[i].buffer_view);
+  }
+  iree_allocator_free(host_allocator, drainer->rings);
+  iree_allocator_free(host_allocator, drainer->staging);
+  iree_vm_list_release(drainer->iovec_list);
+  iree_notification_deinitialize(&drainer->state_notification);
+  if (drainer->file) fclose(drainer->file);
+  iree_allocator_free(host_allocator, drainer);
+}
+
+// Finds the ringbuffers in the drainer iovec list and the metadata describing
+// them. Each module's query function produces its metadata chunks followed by
+// a ringbuffer chunk header and the ringbuffer buffer view.
+static iree_status_t iree_tooling_instrument_drainer_find_rings(
+    iree_tooling_instrument_drainer_t* drainer) {
+  iree_host_size_t iovec_count = iree_vm_list_size(drainer->iovec_list);
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      drainer->host_allocator, iovec_count * sizeof(*drainer->rings),
+      (void**)&drainer->rings));
+  iree_host_size_t metadata_begin = 0;
+  for (iree_host_size_t i = 0; i + 1 < iovec_count; ++i) {
+    iree_vm_ref_t iovec = iree_vm_ref_null();
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_ref_assign(drainer->iovec_list, i, &iovec));
+    if (!iree_vm_buffer_isa(iovec)) continue;
+    iree_vm_buffer_t* buffer = iree_vm_buffer_deref(iovec);
+    if (iree_vm_buffer_length(buffer) != sizeof(iree_idbts_chunk_header_t)) {
+      continue;
+    }
+    const iree_idbts_chunk_header_t* chunk_header =
+        (const iree_idbts_chunk_header_t*)iree_vm_buffer_data(buffer);
+    if (chunk_header->magic != IREE_IDBTS_CHUNK_MAGIC ||
+        chunk_header->type != IREE_IDBTS_CHUNK_TYPE_DISPATCH_RINGBUFFER) {
+      continue;
+    }
+    iree_vm_ref_t ring_iovec = iree_vm_ref_null();
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_ref_assign(drainer->iovec_list, i + 1, &ring_iovec));
+    if (!iree_hal_buffer_view_isa(ring_iovec) ||
+        chunk_header->content_length <= IREE_INSTRUMENT_DISPATCH_PADDING) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "malformed instrument ringbuffer iovec");
+    }
+    iree_tooling_instrument_ring_t* ring =
+        &drainer->rings[drainer->ring_count++];
+    ring->buffer_view = iree_hal_buffer_view_deref(ring_iovec);
+    iree_hal_buffer_view_retain(ring->buffer_view);
+    ring->metadata_begin = metadata_begin;
+    ring->metadata_end = i;
+    ring->ring_size =
+        chunk_header->content_length - IREE_INSTRUMENT_DISPATCH_PADDING;
+    drainer->staging_capacity =
+        iree_max(drainer->staging_capacity,
+                 ring->ring_size + IREE_INSTRUMENT_DISPATCH_PADDING);
+    metadata_begin = i + 2;
+    ++i;
+  }
+  if (drainer->staging_capacity > 0) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(drainer->host_allocator,
+                                               drainer->staging_capacity,
+                                               (void**)&drainer->staging));
+  }
+  return iree_ok_status();
+}
+
+// Writes the metadata of all rings to the file and starts each ring at its
+// current write head so that only new entries are drained.
+static iree_status_t iree_tooling_instrument_drainer_prime(
+    iree_tooling_instrument_drainer_t* drainer) {
+  for (iree_host_size_t i = 0; i < drainer->ring_count; ++i) {
+    IREE_RETURN_IF_ERROR(
+        iree_tooling_instrument_drainer_write_metadata(drainer, i));
+    iree_hal_buffer_mapping_t mapping;
+    IREE_RETURN_IF_ERROR(
+        iree_hal_buffer_map_range(
+            iree_hal_buffer_view_buffer(drainer->rings[i].buffer_view),
+            IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+            IREE_WHOLE_BUFFER, &mapping),
+        "instrument ringbuffers must be host-mappable to drain them");
+    drainer->rings[i].read_offset =
+        iree_tooling_instrument_ring_write_offset(mapping.contents);
+    IREE_IGNORE_ERROR(iree_hal_buffer_unmap_range(&mapping));
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_tooling_instrument_drainer_start_from_flags(
+    iree_vm_context_t* context, iree_allocator_t host_allocator,
+    iree_tooling_instrument_drainer_t** out_drainer) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_drainer);
+  *out_drainer = NULL;
+  if (strlen(FLAG_instrument_file) == 0 ||
+      FLAG_instrument_drain_interval_ms <= 0) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, FLAG_instrument_file);
+
+  iree_tooling_instrument_drainer_t* drainer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*drainer),
+                                (void**)&drainer));
+  memset(drainer, 0, sizeof(*drainer));
+  drainer->host_allocator = host_allocator;
+  drainer->metadata_ring = IREE_HOST_SIZE_MAX;
+  iree_atomic_store_int32(&drainer->state,
+                          IREE_TOOLING_INSTRUMENT_DRAINER_STATE_RUNNING,
+                          iree_memory_order_relaxed);
+  iree_notification_initialize(&drainer->state_notification);
+
+  iree_status_t status = iree_ok_status();
+  drainer->file = fopen(FLAG_instrument_file, "wb");
+  if (!drainer->file) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "failed to open instrument file '%s' for writing",
+                              FLAG_instrument_file);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_query_instrument_iovecs(context, host_allocator,
+                                                  &drainer->iovec_list);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_instrument_drainer_find_rings(drainer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_instrument_drainer_prime(drainer);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_thread_create_params_t thread_params;
+    memset(&thread_params, 0, sizeof(thread_params));
+    thread_params.name = IREE_SV("iree-instrument-drainer");
+    status = iree_thread_create(iree_tooling_instrument_drainer_main, drainer,
+                                thread_params, host_allocator,
+                                &drainer->thread);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_drainer = drainer;
+  } else {
+    iree_tooling_instrument_drainer_free(drainer);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_tooling_instrument_drainer_stop(
+    iree_tooling_instrument_drainer_t* drainer) {
+  if (!drainer) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Request the drain thread exit and wait for it to finish its current drain.
+  iree_atomic_store_int32(&drainer->state,
+                          IREE_TOOLING_INSTRUMENT_DRAINER_STATE_EXITING,
+                          iree_memory_order_release);
+  iree_notification_post(&drainer->state_notification, IREE_ALL_WAITERS);
+  iree_notification_await(
+      &drainer->state_notification,
+      (iree_condition_fn_t)iree_tooling_instrument_drainer_is_zombie, drainer,
+      iree_infinite_timeout());
+  iree_thread_release(drainer->thread);
+  drainer->thread = NULL;
+
+  // Final drain of everything written since the last periodic drain. The
+  // caller must have waited for all device work to complete.
+  iree_status_t status = drainer->thread_status;
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_instrument_drainer_drain(drainer);
+  }
+  if (drainer->dropped_bytes > 0) {
+    fprintf(stderr,
+            "WARNING: %" PRIu64
+            " bytes of instrument data were overwritten before they could be "
+            "drained; increase the ringbuffer size, sampling rate, or drain "
+            "frequency\n",
+            drainer->dropped_bytes);
+  }
+
+  iree_tooling_instrument_drainer_free(drainer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -23,6 +23,27 @@ extern "C" {
 iree_status_t iree_tooling_process_instrument_data(
     iree_vm_context_t* context, iree_allocator_t host_allocator);
 
+//===----------------------------------------------------------------------===//
+// Instrument data draining
+//===----------------------------------------------------------------------===//
+
+// Background thread continuously draining instrument ringbuffers to a file.
+typedef struct iree_tooling_instrument_drainer_t
+    iree_tooling_instrument_drainer_t;
+
+// Starts draining instrument data in |context| to the --instrument_file= if
+// --instrument_drain_interval_ms= is set. |out_drainer| is set to NULL if
+// draining is not enabled. Only entries written after the drainer starts are
+// captured.
+iree_status_t iree_tooling_instrument_drainer_start_from_flags(
+    iree_vm_context_t* context, iree_allocator_t host_allocator,
+    iree_tooling_instrument_drainer_t** out_drainer);
+
+// Stops |drainer|, drains any remaining instrument data, and frees it.
+// All device work writing instrument data must have completed.
+iree_status_t iree_tooling_instrument_drainer_stop(
+    iree_tooling_instrument_drainer_t* drainer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -123,6 +123,98 @@ static iree_status_t iree_numpy_npy_read_into_mapping(
   return iree_ok_status();
 }
 
+// Releases the stream retained by a buffer imported from its mapped contents.
+static void iree_numpy_npy_mapped_buffer_release(void* user_data,
+                                                 iree_hal_buffer_t* buffer) {
+  iree_io_stream_release((iree_io_stream_t*)user_data);
+}
+
+// Tries to map the next |byte_length| bytes of |stream| and import them
+// directly as a buffer view without copying. The imported buffer retains the
+// |stream| so the caller can release it independently.
+//
+// Returns a retained |out_buffer_view| if the import succeeded or NULL if the
+// stream is not mappable or the device cannot use the mapped memory, in which
+// case the stream position is unchanged and the caller must fall back to
+// reading the contents.
+static iree_status_t iree_numpy_npy_try_import_mapping(
+    iree_io_stream_t* stream, iree_hal_buffer_params_t buffer_params,
+    iree_hal_allocator_t* device_allocator, iree_host_size_t shape_rank,
+    const iree_hal_dim_t* shape, iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type, iree_device_size_t byte_length,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  *out_buffer_view = NULL;
+  if (byte_length == 0 ||
+      !iree_all_bits_set(iree_io_stream_mode(stream),
+                         IREE_IO_STREAM_MODE_READABLE |
+                             IREE_IO_STREAM_MODE_SEEKABLE |
+                             IREE_IO_STREAM_MODE_MAPPABLE)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_stream_pos_t data_offset = iree_io_stream_offset(stream);
+  iree_const_byte_span_t span = iree_const_byte_span_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_io_stream_map_read(stream, (iree_host_size_t)byte_length, &span));
+
+  // npy payloads are 64-byte aligned relative to the start of the file; if the
+  // mapping doesn't start on a similar boundary the contents may not be
+  // usable by devices directly.
+  bool is_aligned = iree_host_size_has_alignment(
+      (iree_host_size_t)span.data,
+      iree_max(64, (iree_host_size_t)buffer_params.min_alignment));
+
+  // Mapped contents are read-only and must not be written by the program.
+  buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+  buffer_params.type |= IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+      .size = (iree_device_size_t)span.data_length,
+      .handle =
+          {
+              .host_allocation =
+                  {
+                      .ptr = (void*)span.data,
+                  },
+          },
+  };
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_numpy_npy_mapped_buffer_release,
+      .user_data = stream,
+  };
+  iree_hal_buffer_t* buffer = NULL;
+  iree_status_t import_status = iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+  if (is_aligned) {
+    iree_io_stream_retain(stream);
+    import_status = iree_hal_allocator_import_buffer(
+        device_allocator, buffer_params, &external_buffer, release_callback,
+        &buffer);
+    if (!iree_status_is_ok(import_status)) {
+      iree_io_stream_release(stream);
+    }
+  }
+  if (!iree_status_is_ok(import_status)) {
+    // Failed to import - that's ok as the caller will do the full allocate +
+    // read. Rewind so it reads the same contents.
+    iree_status_ignore(import_status);
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "import failure");
+    iree_status_t status =
+        iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, data_offset);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_status_t status = iree_hal_buffer_view_create(
+      buffer, shape_rank, shape, element_type, encoding_type,
+      iree_hal_allocator_host_allocator(device_allocator), out_buffer_view);
+  iree_hal_buffer_release(buffer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Scans for the next key: value pair in |dict|.
 // |dict| will be set to the remaining |dict| string after the key and value.
 static iree_status_t iree_numpy_consume_dict_key_value(
@@ -356,10 +448,24 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
     if (!iree_status_is_ok(status)) break;
   }
 
+  // If requested try to use the stream contents in place. This avoids both
+  // the read into host memory and the allocation of the device buffer.
+  if (iree_status_is_ok(status) &&
+      iree_all_bits_set(options, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE)) {
+    iree_device_size_t byte_length = 0;
+    status = iree_hal_buffer_compute_view_size(
+        shape_rank, shape, element_type, encoding_type, &byte_length);
+    if (iree_status_is_ok(status)) {
+      status = iree_numpy_npy_try_import_mapping(
+          stream, buffer_params, device_allocator, shape_rank, shape,
+          element_type, encoding_type, byte_length, out_buffer_view);
+    }
+  }
+
   // Allocate the buffer view and directly read into the allocated memory.
   // On targets where we can perform host mapping this will be zero-copy; on
   // others it'll at least be _somewhat_ efficient.
-  if (iree_status_is_ok(status)) {
+  if (iree_status_is_ok(status) && !*out_buffer_view) {
     iree_numpy_npy_read_params_t read_params = {
         .stream = stream,
     };
@@ -487,12 +593,12 @@ static iree_status_t iree_numpy_npy_build_header(
   return iree_ok_status();
 }
 
-// Writes the numpy file |header_dict| and pads the file to the required
-// alignment. |header_dict| should not have any trailing padding or the newline
-// character.
-static iree_status_t iree_numpy_npy_write_header(
+// Writes the numpy file |header_dict|, pads the file to the required
+// alignment, and writes the ndarray |contents|. |header_dict| should not have
+// any trailing padding or the newline character.
+static iree_status_t iree_numpy_npy_write_ndarray(
     iree_io_stream_t* stream, iree_numpy_npy_save_options_t options,
-    iree_string_view_t header_dict) {
+    iree_string_view_t header_dict, iree_const_byte_span_t contents) {
   // v1 -> v2 if the header requires it; we don't but good to be conformant.
   bool requires_v2 = header_dict.size > 65535;
 
@@ -509,8 +615,6 @@ static iree_status_t iree_numpy_npy_write_header(
       .version_minor = 0,
   };
   static_assert(sizeof(header) == 8, "padding");
-  IREE_RETURN_IF_ERROR(iree_io_stream_write(stream, sizeof(header), &header),
-                       "failed to write header prefix");
 
   // Pad out what we write to 64b.
   // Note that this includes the header prefix, length, dict, and newline.
@@ -519,58 +623,40 @@ static iree_status_t iree_numpy_npy_write_header(
   iree_host_size_t padded_length = iree_host_align(current_length, 64);
   iree_host_size_t padding_length = padded_length - current_length;
 
-  // Write header length.
+  // Header length.
   iree_host_size_t header_length = header_dict.size + padding_length + /*\n*/ 1;
-  if (requires_v2) {
-    uint32_t header_length_u32 = (uint32_t)header_length;
-    IREE_RETURN_IF_ERROR(iree_io_stream_write(stream, sizeof(header_length_u32),
-                                              &header_length_u32),
-                         "failed to write header length");
-  } else {
-    uint16_t header_length_u16 = (uint16_t)header_length;
-    IREE_RETURN_IF_ERROR(iree_io_stream_write(stream, sizeof(header_length_u16),
-                                              &header_length_u16),
-                         "failed to write header length");
-  }
-
-  // Write header contents (without padding/trailing newline).
-  IREE_RETURN_IF_ERROR(
-      iree_io_stream_write(stream, header_dict.size, header_dict.data),
-      "failed to write header contents");
-
-  // Add space padding up to 64b alignment (minus newline).
-  const char space = ' ';
+  uint32_t header_length_u32 = (uint32_t)header_length;
+  uint16_t header_length_u16 = (uint16_t)header_length;
+
+  // Space padding up to 64b alignment followed by the trailing newline, which
+  // should put us right at the %64=0 alignment.
+  static const char trailer[64] =
+      "                                "
+      "                               \n";
+  static_assert(sizeof(trailer) == 64, "padding");
+
+  // Write the prefix, length, dict, padding, and contents in a single batch.
+  // The contents are written directly from the caller's memory (usually a
+  // buffer mapping) so that no intermediate copy is required.
+  const iree_const_byte_span_t spans[] = {
+      iree_make_const_byte_span(&header, sizeof(header)),
+      requires_v2 ? iree_make_const_byte_span(&header_length_u32,
+                                              sizeof(header_length_u32))
+                  : iree_make_const_byte_span(&header_length_u16,
+                                              sizeof(header_length_u16)),
+      iree_make_const_byte_span(header_dict.data, header_dict.size),
+      iree_make_const_byte_span(
+          trailer + sizeof(trailer) - (padding_length + 1),
+          padding_length + 1),
+      iree_make_const_byte_span(contents.data, contents.data_length),
+  };
   IREE_RETURN_IF_ERROR(
-      iree_io_stream_fill(stream, padding_length, &space, sizeof(space)),
-      "failed to pad header");
-
-  // Trailing newline, which should put us right at the %64=0 alignment.
-  IREE_RETURN_IF_ERROR(iree_io_stream_write_char(stream, '\n'),
-                       "failed to write trailing newline");
+      iree_io_stream_writev(stream, IREE_ARRAYSIZE(spans), spans),
+      "failed to write ndarray");
 
   return iree_ok_status();
 }
 
-// Writes |buffer_view| contents to |stream|.
-static iree_status_t iree_numpy_npy_write_bytes(
-    iree_io_stream_t* stream, iree_hal_buffer_view_t* buffer_view) {
-  iree_hal_buffer_t* buffer = iree_hal_buffer_view_buffer(buffer_view);
-  iree_device_size_t write_length =
-      iree_hal_buffer_view_byte_length(buffer_view);
-
-  iree_hal_buffer_mapping_t mapping;
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
-      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
-      write_length, &mapping));
-
-  iree_status_t status = iree_status_annotate(
-      iree_io_stream_write(stream, write_length, mapping.contents.data),
-      IREE_SV("failed to write buffer contents"));
-
-  IREE_IGNORE_ERROR(iree_hal_buffer_unmap_range(&mapping));
-  return status;
-}
-
 IREE_API_EXPORT iree_status_t iree_numpy_npy_save_ndarray(
     iree_io_stream_t* stream, iree_numpy_npy_save_options_t options,
     iree_hal_buffer_view_t* buffer_view, iree_allocator_t host_allocator) {
@@ -584,15 +670,22 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_save_ndarray(
   iree_status_t status =
       iree_numpy_npy_build_header(options, buffer_view, &builder);
 
-  // Write header magic and dict, padded to 64 bytes.
+  // Map the buffer contents so they can be written without a staging copy.
+  iree_hal_buffer_mapping_t mapping = {{0}};
   if (iree_status_is_ok(status)) {
-    status = iree_numpy_npy_write_header(stream, options,
-                                         iree_string_builder_view(&builder));
+    status = iree_hal_buffer_map_range(
+        iree_hal_buffer_view_buffer(buffer_view), IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_READ, 0,
+        iree_hal_buffer_view_byte_length(buffer_view), &mapping);
   }
 
-  // Write buffer contents.
+  // Write header magic and dict, padded to 64 bytes, and the contents.
   if (iree_status_is_ok(status)) {
-    status = iree_numpy_npy_write_bytes(stream, buffer_view);
+    status = iree_numpy_npy_write_ndarray(
+        stream, options, iree_string_builder_view(&builder),
+        iree_make_const_byte_span(mapping.contents.data,
+                                  mapping.contents.data_length));
+    IREE_IGNORE_ERROR(iree_hal_buffer_unmap_range(&mapping));
   }
 
   iree_string_builder_deinitialize(&builder);
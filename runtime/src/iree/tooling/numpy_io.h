@@ -55,8 +55,11 @@ enum iree_numpy_npy_load_options_bits_t {
   // Tries to map the file into memory and use the contents directly from the
   // file system. Only available if the HAL device supports accessing mapped
   // data.
-  // Like providing `mmap_mode` to `numpy.load`.
-  // May be ignored if the implementation does not support mapping.
+  // Like providing `mmap_mode='r'` to `numpy.load`.
+  // Requires a stream with IREE_IO_STREAM_MODE_MAPPABLE whose mapped contents
+  // remain valid for the lifetime of the stream, such as a memory stream
+  // wrapping a mapped file. Imported buffers retain the stream and are
+  // read-only. Ignored if the stream or device does not support mapping.
   IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE = 1u << 0,
 };
 typedef uint32_t iree_numpy_npy_load_options_t;
@@ -72,8 +75,9 @@ typedef uint32_t iree_numpy_npy_save_options_t;
 // in the npy file allocated from the given |device_allocator|.
 //
 // If IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE is set and the
-// |device_allocator| supports mapping then the file will be mapped into the
-// host process. Otherwise the file will be loaded into a new allocation.
+// |device_allocator| supports importing the mapped |stream| contents then the
+// returned buffer view will reference them directly. Otherwise the file will
+// be loaded into a new allocation.
 //
 // Upon return the |stream| will be positioned immediately following the
 // ndarray contents, which may be end-of-stream.
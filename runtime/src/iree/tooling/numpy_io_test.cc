@@ -177,6 +177,60 @@ TEST_F(NumpyIOTest, LoadMultipleArrays) {
   ASSERT_TRUE(iree_io_stream_is_eos(stream.get()));
 }
 
+// Tests loading an array from a mappable stream with
+// IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE uses the stream contents in place.
+TEST_F(NumpyIOTest, LoadMappedArray) {
+  auto source_stream = OpenInputFile("single.npy");
+  iree_io_stream_pos_t source_length =
+      iree_io_stream_length(source_stream.get());
+
+  // Copy to a 64-byte aligned allocation like a mapped file would have.
+  void* contents = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc_aligned(
+      iree_allocator_system(), (iree_host_size_t)source_length, 64, 0,
+      &contents));
+  IREE_ASSERT_OK(iree_io_stream_read(source_stream.get(), source_length,
+                                     contents, NULL));
+  iree_io_stream_t* stream = NULL;
+  IREE_ASSERT_OK(iree_io_memory_stream_wrap(
+      IREE_IO_STREAM_MODE_READABLE | IREE_IO_STREAM_MODE_SEEKABLE |
+          IREE_IO_STREAM_MODE_MAPPABLE,
+      iree_make_byte_span(contents, (iree_host_size_t)source_length),
+      iree_io_memory_stream_release_callback_null(), iree_allocator_system(),
+      &stream));
+
+  iree_hal_buffer_params_t buffer_params = {};
+  buffer_params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+  buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+  buffer_params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_ASSERT_OK(iree_numpy_npy_load_ndarray(
+      stream, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, buffer_params, device_,
+      device_allocator_, &buffer_view));
+  ASSERT_TRUE(iree_io_stream_is_eos(stream));
+
+  // The buffer view retains the stream.
+  iree_io_stream_release(stream);
+
+  // np.array([1.1, 2.2, 3.3], dtype=np.float32)
+  AssertBufferViewContents<float>(buffer_view, {3},
+                                  IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+                                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+                                  {1.1f, 2.2f, 3.3f});
+
+  // The heap allocator can import host memory so no copy should be made.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_ASSERT_OK(iree_hal_buffer_map_range(
+      iree_hal_buffer_view_buffer(buffer_view), IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_READ, 0, IREE_WHOLE_BUFFER, &mapping));
+  EXPECT_EQ(mapping.contents.data,
+            (uint8_t*)contents + source_length - 3 * sizeof(float));
+  IREE_ASSERT_OK(iree_hal_buffer_unmap_range(&mapping));
+
+  iree_hal_buffer_view_release(buffer_view);
+  iree_allocator_free_aligned(iree_allocator_system(), contents);
+}
+
 // Tests loading arrays with various shapes.
 TEST_F(NumpyIOTest, ArrayShapes) {
   auto stream = OpenInputFile("array_shapes.npy");
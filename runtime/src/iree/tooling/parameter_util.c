@@ -8,11 +8,16 @@
 
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/path.h"
+#include "iree/hal/utils/file_cache.h"
+#include "iree/io/formats/gguf/gguf_parser.h"
 #include "iree/io/formats/parser_registry.h"
+#include "iree/io/formats/safetensors/safetensors_parser.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/parameter_index_provider.h"
 #include "iree/io/scope_map.h"
 #include "iree/modules/io/parameters/module.h"
+#include "iree/tooling/startup_statistics.h"
 
 //===----------------------------------------------------------------------===//
 // Parameter file I/O
@@ -91,7 +96,59 @@ IREE_FLAG_LIST(
     "Supported formats:\n"
     "- .irpa (IREE parameter archive)\n"
     "- .gguf (https://github.com/ggerganov/ggml/blob/master/docs/gguf.md)\n"
-    "- .safetensors (https://github.com/huggingface/safetensors)");
+    "- .safetensors (https://github.com/huggingface/safetensors)\n"
+    "- .safetensors.index.json (sharded safetensors; shards are resolved\n"
+    "  relative to the index file and parsed on first use)");
+
+// State for opening safetensors shards relative to their index file.
+typedef struct iree_io_safetensors_shard_open_state_t {
+  iree_allocator_t host_allocator;
+  // Directory containing the index file. Stored inline after the struct.
+  iree_string_view_t base_path;
+} iree_io_safetensors_shard_open_state_t;
+
+static iree_status_t iree_io_safetensors_shard_open(
+    void* user_data, iree_string_view_t shard_name,
+    iree_io_file_handle_t** out_file_handle) {
+  iree_io_safetensors_shard_open_state_t* state =
+      (iree_io_safetensors_shard_open_state_t*)user_data;
+  char* shard_path = NULL;
+  IREE_RETURN_IF_ERROR(iree_file_path_join(state->base_path, shard_name,
+                                           state->host_allocator,
+                                           &shard_path));
+  iree_status_t status =
+      iree_io_open_parameter_file(iree_make_cstring_view(shard_path),
+                                  state->host_allocator, out_file_handle);
+  iree_allocator_free(state->host_allocator, shard_path);
+  return status;
+}
+
+static void iree_io_safetensors_shard_open_release(void* user_data) {
+  iree_io_safetensors_shard_open_state_t* state =
+      (iree_io_safetensors_shard_open_state_t*)user_data;
+  iree_allocator_free(state->host_allocator, state);
+}
+
+// Registers the shards of the sharded safetensors index file |file_handle|
+// located at |path| with |index|. Shards are opened lazily as used.
+static iree_status_t iree_io_append_safetensors_sharded_index(
+    iree_string_view_t path, iree_io_file_handle_t* file_handle,
+    iree_io_parameter_index_t* index, iree_allocator_t host_allocator) {
+  iree_string_view_t base_path = iree_file_path_dirname(path);
+  iree_io_safetensors_shard_open_state_t* state = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*state) + base_path.size, (void**)&state));
+  state->host_allocator = host_allocator;
+  memcpy((char*)(state + 1), base_path.data, base_path.size);
+  state->base_path = iree_make_string_view((char*)(state + 1), base_path.size);
+  iree_io_safetensors_shard_open_callback_t shard_open = {
+      .fn = iree_io_safetensors_shard_open,
+      .release = iree_io_safetensors_shard_open_release,
+      .user_data = state,
+  };
+  return iree_io_parse_safetensors_sharded_index(file_handle, shard_open,
+                                                 host_allocator, index);
+}
 
 // Appends the parameter file located at |path| to |index|.
 static iree_status_t iree_io_append_parameter_file_to_index(
@@ -105,8 +162,16 @@ static iree_status_t iree_io_append_parameter_file_to_index(
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_io_open_parameter_file(path, host_allocator, &file_handle));
 
-  // Index the file based on its (inferred) format.
-  iree_status_t status = iree_io_parse_file_index(path, file_handle, index);
+  // Index the file based on its (inferred) format. Sharded safetensors indices
+  // reference other files and are handled here as the parser registry only
+  // deals with self-contained files.
+  iree_status_t status = iree_ok_status();
+  if (iree_string_view_ends_with(path, IREE_SV(".safetensors.index.json"))) {
+    status = iree_io_append_safetensors_sharded_index(path, file_handle, index,
+                                                      host_allocator);
+  } else {
+    status = iree_io_parse_file_index(path, file_handle, index);
+  }
 
   // Release our file reference - it's still retained by the index if it had any
   // parameters in it.
@@ -146,6 +211,29 @@ iree_status_t iree_tooling_build_parameter_indices_from_flags(
   return iree_ok_status();
 }
 
+IREE_FLAG(
+    string, parameter_transform, "none",
+    "A transform applied to parameters as they are loaded of\n"
+    "['none', 'gguf_unpack'].\n"
+    "  none: parameters are loaded as stored in their files.\n"
+    "  gguf_unpack: unpacks Q4_0/Q8_0 GGUF tensors into planar i4/i8 values\n"
+    "               followed by f16 scales while streaming to the device.");
+
+// Returns the parameter transform specified by the --parameter_transform flag.
+static iree_status_t iree_tooling_resolve_parameter_transform(
+    iree_io_parameter_transform_t* out_transform) {
+  if (strcmp(FLAG_parameter_transform, "none") == 0) {
+    *out_transform = iree_io_parameter_transform_null();
+  } else if (strcmp(FLAG_parameter_transform, "gguf_unpack") == 0) {
+    *out_transform = iree_io_gguf_unpack_transform();
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unrecognized --parameter_transform= value '%s'",
+                            FLAG_parameter_transform);
+  }
+  return iree_ok_status();
+}
+
 iree_status_t iree_tooling_create_parameters_module_from_flags(
     iree_vm_instance_t* instance, iree_allocator_t host_allocator,
     iree_vm_module_t** out_module) {
@@ -155,8 +243,21 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
   iree_io_scope_map_initialize(host_allocator, &scope_map);
 
   // Parse all parameter files and build out their indices.
-  iree_status_t status =
-      iree_tooling_build_parameter_indices_from_flags(&scope_map);
+  iree_io_parameter_transform_t transform = iree_io_parameter_transform_null();
+  iree_status_t status = iree_tooling_resolve_parameter_transform(&transform);
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_build_parameter_indices_from_flags(&scope_map);
+  }
+
+  // All providers share a single file cache so that files referenced from
+  // multiple scopes are only imported once per device.
+  iree_hal_file_cache_t* file_cache = NULL;
+  if (iree_status_is_ok(status)) {
+    iree_hal_file_cache_params_t file_cache_params;
+    iree_hal_file_cache_params_initialize(&file_cache_params);
+    status = iree_hal_file_cache_create(file_cache_params, host_allocator,
+                                        &file_cache);
+  }
 
   // Create one provider per scope.
   iree_host_size_t provider_count = 0;
@@ -165,10 +266,18 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
           scope_map.count * sizeof(iree_io_parameter_provider_t*));
   if (iree_status_is_ok(status)) {
     for (iree_host_size_t i = 0; i < scope_map.count; ++i) {
-      status = iree_io_parameter_index_provider_create(
+      status = iree_io_parameter_index_provider_create_with_transform(
           scope_map.entries[i]->scope, scope_map.entries[i]->index,
           IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS,
-          host_allocator, &providers[i]);
+          file_cache, transform, host_allocator, &providers[i]);
+      if (iree_status_is_ok(status) &&
+          iree_tooling_startup_statistics_is_enabled()) {
+        iree_io_parameter_provider_t* index_provider = providers[i];
+        status = iree_tooling_startup_statistics_wrap_parameter_provider(
+            scope_map.entries[i]->scope, index_provider, host_allocator,
+            &providers[i]);
+        iree_io_parameter_provider_release(index_provider);
+      }
       if (!iree_status_is_ok(status)) break;
       ++provider_count;
     }
@@ -184,6 +293,7 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
   for (iree_host_size_t i = 0; i < provider_count; ++i) {
     iree_io_parameter_provider_release(providers[i]);
   }
+  iree_hal_file_cache_release(file_cache);
   iree_io_scope_map_deinitialize(&scope_map);
 
   IREE_TRACE_ZONE_END(z0);
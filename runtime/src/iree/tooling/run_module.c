@@ -17,6 +17,7 @@
 #include "iree/tooling/function_io.h"
 #include "iree/tooling/function_util.h"
 #include "iree/tooling/instrument_util.h"
+#include "iree/tooling/startup_statistics.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/module.h"
 
@@ -159,6 +160,11 @@ static iree_status_t iree_tooling_create_run_context(
     return status;
   }
 
+  // Report startup costs now that all modules have initialized.
+  if (iree_tooling_startup_statistics_is_enabled()) {
+    IREE_IGNORE_ERROR(iree_tooling_startup_statistics_fprint(stderr));
+  }
+
   // Choose which function to run - either the one specified in the flag or the
   // only exported non-internal function.
   iree_vm_function_t function = {0};
@@ -247,6 +253,15 @@ static iree_status_t iree_tooling_run_function(
                                     "beginning device profiling");
   }
 
+  // Start draining instrument data while the function runs, if requested.
+  iree_tooling_instrument_drainer_t* instrument_drainer = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(
+        iree_tooling_instrument_drainer_start_from_flags(
+            context, host_allocator, &instrument_drainer),
+        "starting instrument data draining");
+  }
+
   // Invoke the function with the provided inputs.
   if (iree_status_is_ok(status)) {
     status = iree_status_annotate_f(
@@ -259,12 +274,22 @@ static iree_status_t iree_tooling_run_function(
 
   // If the function is async we need to wait for it to complete.
   if (iree_status_is_ok(status) && finish_fence) {
-    IREE_RETURN_IF_ERROR(
+    status = iree_status_annotate_f(
         iree_hal_fence_wait(finish_fence, iree_infinite_timeout()),
         "waiting on finish fence");
   }
   iree_hal_fence_release(finish_fence);
 
+  // Stop draining now that all work writing instrument data has completed.
+  if (iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(
+        iree_tooling_instrument_drainer_stop(instrument_drainer),
+        "draining instrument data");
+  } else {
+    iree_status_ignore(
+        iree_tooling_instrument_drainer_stop(instrument_drainer));
+  }
+
   // End profiling after waiting for the invocation to finish.
   if (iree_status_is_ok(status)) {
     status = iree_status_annotate_f(iree_hal_end_profiling_from_flags(device),
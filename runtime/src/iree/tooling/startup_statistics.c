@@ -0,0 +1,433 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/tooling/startup_statistics.h"
+
+#include <string.h>
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/flags.h"
+#include "iree/base/internal/synchronization.h"
+
+IREE_FLAG(bool, print_startup_statistics, false,
+          "Prints a breakdown of the time spent loading modules, creating\n"
+          "devices, preparing executables, loading parameters, and running\n"
+          "initializers to stderr once startup completes. Parameter loads are\n"
+          "serialized while measuring.");
+
+//===----------------------------------------------------------------------===//
+// Statistics storage
+//===----------------------------------------------------------------------===//
+
+// A loaded module.
+typedef struct iree_tooling_startup_module_t {
+  struct iree_tooling_startup_module_t* next;
+  iree_host_size_t byte_length;
+  iree_duration_t load_duration_ns;
+  iree_duration_t create_duration_ns;
+  // + NUL-terminated path storage.
+  char path[];
+} iree_tooling_startup_module_t;
+
+// A prepared executable.
+typedef struct iree_tooling_startup_executable_t {
+  struct iree_tooling_startup_executable_t* next;
+  iree_host_size_t data_length;
+  iree_duration_t duration_ns;
+  iree_status_code_t status_code;
+  // + NUL-terminated format storage.
+  char format[];
+} iree_tooling_startup_executable_t;
+
+// Parameter I/O performed by a single provider.
+typedef struct iree_tooling_startup_provider_t {
+  struct iree_tooling_startup_provider_t* next;
+  iree_host_size_t operation_count;
+  uint64_t bytes_read;
+  iree_duration_t duration_ns;
+  // + NUL-terminated scope storage.
+  char scope[];
+} iree_tooling_startup_provider_t;
+
+// Records are appended in the order they occur and are never freed so that
+// wrapped providers can reference them after being released.
+static struct {
+  iree_slim_mutex_t mutex;
+  iree_tooling_startup_module_t* modules;
+  iree_tooling_startup_module_t** modules_tail;
+  iree_tooling_startup_executable_t* executables;
+  iree_tooling_startup_executable_t** executables_tail;
+  iree_tooling_startup_provider_t* providers;
+  iree_tooling_startup_provider_t** providers_tail;
+  iree_duration_t device_creation_ns;
+  iree_duration_t context_creation_ns;
+  iree_host_size_t context_count;
+} iree_tooling_startup_statistics;
+
+static iree_once_flag iree_tooling_startup_statistics_init_flag =
+    IREE_ONCE_FLAG_INIT;
+
+static void iree_tooling_startup_statistics_initialize(void) {
+  iree_slim_mutex_initialize(&iree_tooling_startup_statistics.mutex);
+  iree_tooling_startup_statistics.modules_tail =
+      &iree_tooling_startup_statistics.modules;
+  iree_tooling_startup_statistics.executables_tail =
+      &iree_tooling_startup_statistics.executables;
+  iree_tooling_startup_statistics.providers_tail =
+      &iree_tooling_startup_statistics.providers;
+}
+
+static void iree_tooling_startup_statistics_lock(void) {
+  iree_call_once(&iree_tooling_startup_statistics_init_flag,
+                 iree_tooling_startup_statistics_initialize);
+  iree_slim_mutex_lock(&iree_tooling_startup_statistics.mutex);
+}
+
+static void iree_tooling_startup_statistics_unlock(void) {
+  iree_slim_mutex_unlock(&iree_tooling_startup_statistics.mutex);
+}
+
+// Allocates a zeroed record of |record_size| bytes followed by a
+// NUL-terminated copy of |name|.
+static void* iree_tooling_startup_statistics_allocate_record(
+    iree_host_size_t record_size, iree_string_view_t name) {
+  uint8_t* record = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(iree_allocator_system(),
+                            record_size + name.size + 1, (void**)&record);
+  if (!iree_status_is_ok(status)) {
+    // Statistics are best-effort and dropped if we are out of memory.
+    iree_status_ignore(status);
+    return NULL;
+  }
+  memcpy(record + record_size, name.data, name.size);
+  record[record_size + name.size] = 0;
+  return record;
+}
+
+bool iree_tooling_startup_statistics_is_enabled(void) {
+  return FLAG_print_startup_statistics;
+}
+
+void iree_tooling_startup_statistics_record_module(
+    iree_string_view_t path, iree_host_size_t byte_length,
+    iree_duration_t load_duration_ns, iree_duration_t create_duration_ns) {
+  iree_tooling_startup_module_t* module =
+      (iree_tooling_startup_module_t*)
+          iree_tooling_startup_statistics_allocate_record(sizeof(*module),
+                                                          path);
+  if (!module) return;
+  module->byte_length = byte_length;
+  module->load_duration_ns = load_duration_ns;
+  module->create_duration_ns = create_duration_ns;
+  iree_tooling_startup_statistics_lock();
+  *iree_tooling_startup_statistics.modules_tail = module;
+  iree_tooling_startup_statistics.modules_tail = &module->next;
+  iree_tooling_startup_statistics_unlock();
+}
+
+void iree_tooling_startup_statistics_record_device_creation(
+    iree_duration_t duration_ns) {
+  iree_tooling_startup_statistics_lock();
+  iree_tooling_startup_statistics.device_creation_ns += duration_ns;
+  iree_tooling_startup_statistics_unlock();
+}
+
+void iree_tooling_startup_statistics_record_context_creation(
+    iree_duration_t duration_ns) {
+  iree_tooling_startup_statistics_lock();
+  iree_tooling_startup_statistics.context_creation_ns += duration_ns;
+  ++iree_tooling_startup_statistics.context_count;
+  iree_tooling_startup_statistics_unlock();
+}
+
+static void iree_tooling_startup_statistics_record_executable(
+    void* user_data, iree_hal_device_t* device,
+    iree_string_view_t executable_format,
+    iree_host_size_t executable_data_length, iree_duration_t duration_ns,
+    iree_status_code_t status_code) {
+  iree_tooling_startup_executable_t* executable =
+      (iree_tooling_startup_executable_t*)
+          iree_tooling_startup_statistics_allocate_record(sizeof(*executable),
+                                                          executable_format);
+  if (!executable) return;
+  executable->data_length = executable_data_length;
+  executable->duration_ns = duration_ns;
+  executable->status_code = status_code;
+  iree_tooling_startup_statistics_lock();
+  *iree_tooling_startup_statistics.executables_tail = executable;
+  iree_tooling_startup_statistics.executables_tail = &executable->next;
+  iree_tooling_startup_statistics_unlock();
+}
+
+iree_hal_module_executable_observer_t
+iree_tooling_startup_statistics_executable_observer(void) {
+  iree_hal_module_executable_observer_t observer = {
+      .fn = iree_tooling_startup_statistics_record_executable,
+      .user_data = NULL,
+  };
+  return observer;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_tooling_startup_parameter_provider_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_tooling_startup_parameter_provider_t {
+  iree_io_parameter_provider_t base;
+  iree_allocator_t host_allocator;
+  iree_io_parameter_provider_t* base_provider;
+  iree_tooling_startup_provider_t* record;
+} iree_tooling_startup_parameter_provider_t;
+
+static const iree_io_parameter_provider_vtable_t
+    iree_tooling_startup_parameter_provider_vtable;
+
+static iree_tooling_startup_parameter_provider_t*
+iree_tooling_startup_parameter_provider_cast(
+    iree_io_parameter_provider_t* IREE_RESTRICT base_provider) {
+  return (iree_tooling_startup_parameter_provider_t*)base_provider;
+}
+
+iree_status_t iree_tooling_startup_statistics_wrap_parameter_provider(
+    iree_string_view_t scope, iree_io_parameter_provider_t* base_provider,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider) {
+  IREE_ASSERT_ARGUMENT(base_provider);
+  IREE_ASSERT_ARGUMENT(out_provider);
+  *out_provider = NULL;
+
+  iree_tooling_startup_provider_t* record =
+      (iree_tooling_startup_provider_t*)
+          iree_tooling_startup_statistics_allocate_record(sizeof(*record),
+                                                          scope);
+  if (!record) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "allocating parameter provider statistics");
+  }
+  iree_tooling_startup_statistics_lock();
+  *iree_tooling_startup_statistics.providers_tail = record;
+  iree_tooling_startup_statistics.providers_tail = &record->next;
+  iree_tooling_startup_statistics_unlock();
+
+  iree_tooling_startup_parameter_provider_t* provider = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, sizeof(*provider),
+                                             (void**)&provider));
+  iree_atomic_ref_count_init(&provider->base.ref_count);
+  provider->base.vtable = &iree_tooling_startup_parameter_provider_vtable;
+  provider->host_allocator = host_allocator;
+  provider->base_provider = base_provider;
+  iree_io_parameter_provider_retain(base_provider);
+  provider->record = record;
+
+  *out_provider = (iree_io_parameter_provider_t*)provider;
+  return iree_ok_status();
+}
+
+static void iree_tooling_startup_parameter_provider_destroy(
+    iree_io_parameter_provider_t* IREE_RESTRICT base_provider) {
+  iree_tooling_startup_parameter_provider_t* provider =
+      iree_tooling_startup_parameter_provider_cast(base_provider);
+  iree_allocator_t host_allocator = provider->host_allocator;
+  iree_io_parameter_provider_release(provider->base_provider);
+  iree_allocator_free(host_allocator, provider);
+}
+
+static iree_status_t iree_tooling_startup_parameter_provider_notify(
+    iree_io_parameter_provider_t* base_provider,
+    iree_io_parameter_provider_signal_t signal) {
+  iree_tooling_startup_parameter_provider_t* provider =
+      iree_tooling_startup_parameter_provider_cast(base_provider);
+  return iree_io_parameter_provider_notify(provider->base_provider, signal);
+}
+
+static bool iree_tooling_startup_parameter_provider_query_support(
+    iree_io_parameter_provider_t* base_provider, iree_string_view_t scope) {
+  iree_tooling_startup_parameter_provider_t* provider =
+      iree_tooling_startup_parameter_provider_cast(base_provider);
+  return iree_io_parameter_provider_query_support(provider->base_provider,
+                                                  scope);
+}
+
+// Returns the total number of bytes referenced by the |count| spans produced
+// by |enumerator|.
+static iree_status_t iree_tooling_startup_parameter_enumerate_length(
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator,
+    uint64_t* out_length) {
+  *out_length = 0;
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    iree_string_view_t key = iree_string_view_empty();
+    iree_io_parameter_span_t span = {0};
+    IREE_RETURN_IF_ERROR(enumerator.fn(enumerator.user_data, i, &key, &span));
+    *out_length += span.length;
+  }
+  return iree_ok_status();
+}
+
+// Completes a provider operation started at |start_ns| by waiting for it to
+// signal and recording |byte_length| bytes read.
+static iree_status_t iree_tooling_startup_parameter_provider_end_operation(
+    iree_tooling_startup_parameter_provider_t* provider, iree_time_t start_ns,
+    uint64_t byte_length, const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_status_t status) {
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_list_wait(signal_semaphore_list,
+                                          iree_infinite_timeout());
+  }
+  if (iree_status_is_ok(status)) {
+    iree_duration_t duration_ns = iree_time_now() - start_ns;
+    iree_tooling_startup_statistics_lock();
+    ++provider->record->operation_count;
+    provider->record->bytes_read += byte_length;
+    provider->record->duration_ns += duration_ns;
+    iree_tooling_startup_statistics_unlock();
+  }
+  return status;
+}
+
+static iree_status_t iree_tooling_startup_parameter_provider_load(
+    iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_string_view_t source_scope, iree_hal_buffer_params_t target_params,
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator,
+    iree_io_parameter_emitter_t emitter) {
+  iree_tooling_startup_parameter_provider_t* provider =
+      iree_tooling_startup_parameter_provider_cast(base_provider);
+  uint64_t byte_length = 0;
+  IREE_RETURN_IF_ERROR(iree_tooling_startup_parameter_enumerate_length(
+      count, enumerator, &byte_length));
+  iree_time_t start_ns = iree_time_now();
+  iree_status_t status = iree_io_parameter_provider_load(
+      provider->base_provider, device, queue_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_scope, target_params, count, enumerator,
+      emitter);
+  return iree_tooling_startup_parameter_provider_end_operation(
+      provider, start_ns, byte_length, signal_semaphore_list, status);
+}
+
+static iree_status_t iree_tooling_startup_parameter_provider_gather(
+    iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_string_view_t source_scope, iree_hal_buffer_t* target_buffer,
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator) {
+  iree_tooling_startup_parameter_provider_t* provider =
+      iree_tooling_startup_parameter_provider_cast(base_provider);
+  uint64_t byte_length = 0;
+  IREE_RETURN_IF_ERROR(iree_tooling_startup_parameter_enumerate_length(
+      count, enumerator, &byte_length));
+  iree_time_t start_ns = iree_time_now();
+  iree_status_t status = iree_io_parameter_provider_gather(
+      provider->base_provider, device, queue_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_scope, target_buffer, count, enumerator);
+  return iree_tooling_startup_parameter_provider_end_operation(
+      provider, start_ns, byte_length, signal_semaphore_list, status);
+}
+
+static iree_status_t iree_tooling_startup_parameter_provider_scatter(
+    iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* source_buffer, iree_string_view_t target_scope,
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator) {
+  // Writes are not part of startup and are passed through unmeasured.
+  iree_tooling_startup_parameter_provider_t* provider =
+      iree_tooling_startup_parameter_provider_cast(base_provider);
+  return iree_io_parameter_provider_scatter(
+      provider->base_provider, device, queue_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_buffer, target_scope, count, enumerator);
+}
+
+static const iree_io_parameter_provider_vtable_t
+    iree_tooling_startup_parameter_provider_vtable = {
+        .destroy = iree_tooling_startup_parameter_provider_destroy,
+        .notify = iree_tooling_startup_parameter_provider_notify,
+        .query_support = iree_tooling_startup_parameter_provider_query_support,
+        .load = iree_tooling_startup_parameter_provider_load,
+        .gather = iree_tooling_startup_parameter_provider_gather,
+        .scatter = iree_tooling_startup_parameter_provider_scatter,
+};
+
+//===----------------------------------------------------------------------===//
+// Reporting
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_tooling_startup_statistics_fprint(FILE* file) {
+  IREE_ASSERT_ARGUMENT(file);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_tooling_startup_statistics_lock();
+
+  fprintf(file, "[[ iree_tooling_startup_statistics ]]\n");
+
+  fprintf(file, "modules:\n");
+  fprintf(file, "  %12s %12s %14s  %s\n", "load(ms)", "create(ms)", "bytes",
+          "path");
+  for (iree_tooling_startup_module_t* module =
+           iree_tooling_startup_statistics.modules;
+       module != NULL; module = module->next) {
+    fprintf(file, "  %12.3f %12.3f %14" PRIhsz "  %s\n",
+            module->load_duration_ns / 1e6, module->create_duration_ns / 1e6,
+            module->byte_length, module->path);
+  }
+
+  fprintf(file, "devices:\n");
+  fprintf(file, "  %12.3f ms creating devices\n",
+          iree_tooling_startup_statistics.device_creation_ns / 1e6);
+
+  iree_host_size_t executable_count = 0;
+  iree_duration_t executable_duration_ns = 0;
+  for (iree_tooling_startup_executable_t* executable =
+           iree_tooling_startup_statistics.executables;
+       executable != NULL; executable = executable->next) {
+    ++executable_count;
+    executable_duration_ns += executable->duration_ns;
+  }
+  fprintf(file, "executables: %" PRIhsz " prepared in %.3f ms\n",
+          executable_count, executable_duration_ns / 1e6);
+  iree_host_size_t executable_ordinal = 0;
+  for (iree_tooling_startup_executable_t* executable =
+           iree_tooling_startup_statistics.executables;
+       executable != NULL; executable = executable->next) {
+    fprintf(file, "  %4" PRIhsz " %12.3f ms %14" PRIhsz " bytes  %s%s%s\n",
+            executable_ordinal++, executable->duration_ns / 1e6,
+            executable->data_length, executable->format,
+            executable->status_code == IREE_STATUS_OK ? "" : " FAILED: ",
+            executable->status_code == IREE_STATUS_OK
+                ? ""
+                : iree_status_code_string(executable->status_code));
+  }
+
+  fprintf(file, "parameters:\n");
+  for (iree_tooling_startup_provider_t* provider =
+           iree_tooling_startup_statistics.providers;
+       provider != NULL; provider = provider->next) {
+    double mbps = provider->duration_ns > 0 ? (double)provider->bytes_read /
+                                                  1e6 /
+                                                  (provider->duration_ns / 1e9)
+                                            : 0.0;
+    fprintf(file,
+            "  scope '%s': %" PRIhsz " operations, %" PRIu64
+            " bytes in %.3f ms (%.2f MB/s)\n",
+            provider->scope, provider->operation_count, provider->bytes_read,
+            provider->duration_ns / 1e6, mbps);
+  }
+
+  fprintf(file, "contexts:\n");
+  fprintf(file,
+          "  %12.3f ms creating %" PRIhsz
+          " context(s) (including initializers, executables, and "
+          "parameters)\n",
+          iree_tooling_startup_statistics.context_creation_ns / 1e6,
+          iree_tooling_startup_statistics.context_count);
+
+  iree_tooling_startup_statistics_unlock();
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
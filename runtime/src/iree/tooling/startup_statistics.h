@@ -0,0 +1,73 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_TOOLING_STARTUP_STATISTICS_H_
+#define IREE_TOOLING_STARTUP_STATISTICS_H_
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/io/parameter_provider.h"
+#include "iree/modules/hal/module.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Startup statistics
+//===----------------------------------------------------------------------===//
+
+// Process-wide timing of the phases of program startup: module file loading,
+// module creation (FlatBuffer and bytecode verification), device creation,
+// executable preparation, parameter loading, and context creation (which runs
+// module initializers).
+//
+// Collection is enabled with the --print_startup_statistics flag and the
+// tooling context utilities record each phase as it runs. Tools then print the
+// report with iree_tooling_startup_statistics_fprint once startup completes.
+
+// Returns true if startup statistics are being collected.
+bool iree_tooling_startup_statistics_is_enabled(void);
+
+// Records a module loaded from |path| with |byte_length| bytes of contents.
+// |load_duration_ns| is the time spent reading or mapping the file and
+// |create_duration_ns| the time spent creating the module, which for bytecode
+// modules is dominated by verification.
+void iree_tooling_startup_statistics_record_module(
+    iree_string_view_t path, iree_host_size_t byte_length,
+    iree_duration_t load_duration_ns, iree_duration_t create_duration_ns);
+
+// Records the time taken to create the HAL devices.
+void iree_tooling_startup_statistics_record_device_creation(
+    iree_duration_t duration_ns);
+
+// Records the time taken to create a VM context, including the time spent in
+// the initializers of all modules in the context.
+void iree_tooling_startup_statistics_record_context_creation(
+    iree_duration_t duration_ns);
+
+// Returns an observer that records each executable prepared by a HAL module.
+iree_hal_module_executable_observer_t
+iree_tooling_startup_statistics_executable_observer(void);
+
+// Wraps |base_provider| serving |scope| in a provider that records the bytes
+// read and the time taken by each operation. Operations are waited on before
+// returning so that the time includes the I/O; this serializes parameter
+// loading and should only be used while diagnosing startup.
+iree_status_t iree_tooling_startup_statistics_wrap_parameter_provider(
+    iree_string_view_t scope, iree_io_parameter_provider_t* base_provider,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider);
+
+// Prints a report of all phases recorded so far to |file|.
+iree_status_t iree_tooling_startup_statistics_fprint(FILE* file);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TOOLING_STARTUP_STATISTICS_H_
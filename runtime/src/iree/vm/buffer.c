@@ -80,14 +80,14 @@ IREE_API_EXPORT void iree_vm_buffer_deinitialize(iree_vm_buffer_t* buffer) {
   iree_allocator_free(buffer->allocator, buffer->data.data);
 }
 
-IREE_API_EXPORT iree_status_t
-iree_vm_buffer_create(iree_vm_buffer_access_t access, iree_host_size_t length,
-                      iree_host_size_t alignment, iree_allocator_t allocator,
-                      iree_vm_buffer_t** out_buffer) {
-  IREE_ASSERT_ARGUMENT(out_buffer);
-  *out_buffer = NULL;
-  IREE_TRACE_ZONE_BEGIN(z0);
-
+// Allocates a buffer of |length| bytes with the contents zeroed only if
+// |zero_contents| is set.
+static iree_status_t iree_vm_buffer_allocate(iree_vm_buffer_access_t access,
+                                             iree_host_size_t length,
+                                             iree_host_size_t alignment,
+                                             bool zero_contents,
+                                             iree_allocator_t allocator,
+                                             iree_vm_buffer_t** out_buffer) {
   // The actual buffer payload is prefixed with the buffer type so we need only
   // a single allocation.
   iree_host_size_t prefix_size = iree_sizeof_struct(**out_buffer);
@@ -95,22 +95,53 @@ iree_vm_buffer_create(iree_vm_buffer_access_t access, iree_host_size_t length,
 
   // Allocate combined [prefix | buffer] memory.
   uint8_t* data_ptr = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc_aligned(allocator, total_size, alignment,
-                                        prefix_size, (void**)&data_ptr));
+  if (zero_contents) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc_aligned(
+        allocator, total_size, alignment, prefix_size, (void**)&data_ptr));
+  } else {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc_aligned_uninitialized(
+        allocator, total_size, alignment, prefix_size, (void**)&data_ptr));
+  }
 
   // Initialize the prefix buffer handle.
   iree_vm_buffer_t* buffer = (iree_vm_buffer_t*)data_ptr;
-  memset(data_ptr, 0, prefix_size - sizeof(*buffer));  // padding
+  memset(data_ptr, 0, prefix_size);
   iree_byte_span_t target_span =
       iree_make_byte_span(data_ptr + prefix_size, length);
   iree_vm_buffer_initialize(access, target_span, allocator, buffer);
 
   *out_buffer = buffer;
-  IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t
+iree_vm_buffer_create(iree_vm_buffer_access_t access, iree_host_size_t length,
+                      iree_host_size_t alignment, iree_allocator_t allocator,
+                      iree_vm_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status =
+      iree_vm_buffer_allocate(access, length, alignment,
+                              /*zero_contents=*/true, allocator, out_buffer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_buffer_create_uninitialized(
+    iree_vm_buffer_access_t access, iree_host_size_t length,
+    iree_host_size_t alignment, iree_allocator_t allocator,
+    iree_vm_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status =
+      iree_vm_buffer_allocate(access, length, alignment,
+                              /*zero_contents=*/false, allocator, out_buffer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static void iree_vm_buffer_destroy(void* ptr) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -147,28 +178,15 @@ IREE_API_EXPORT iree_status_t iree_vm_buffer_clone(
       z0, iree_vm_buffer_map_ro(source_buffer, source_offset, length, 1,
                                 &source_span));
 
-  // The actual buffer payload is prefixed with the buffer type so we need only
-  // a single allocation.
-  iree_host_size_t prefix_size =
-      iree_host_align(sizeof(iree_vm_buffer_t), iree_max_align_t);
-  iree_host_size_t total_size = prefix_size + source_span.data_length;
-
-  // Allocate combined [prefix | buffer] memory.
-  // TODO(benvanik): uninitialized allocation here to avoid the memset(0).
-  uint8_t* data_ptr = NULL;
+  // The entire contents are overwritten by the copy so there's no need to
+  // zero them first.
+  iree_vm_buffer_t* buffer = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc_aligned(allocator, total_size, alignment,
-                                        prefix_size, (void**)&data_ptr));
-
-  // Initialize the prefix buffer handle.
-  iree_vm_buffer_t* buffer = (iree_vm_buffer_t*)data_ptr;
-  memset(data_ptr, 0, prefix_size - sizeof(*buffer));  // padding
-  iree_byte_span_t target_span =
-      iree_make_byte_span(data_ptr + prefix_size, length);
-  iree_vm_buffer_initialize(access, target_span, allocator, buffer);
+      z0, iree_vm_buffer_allocate(access, source_span.data_length, alignment,
+                                  /*zero_contents=*/false, allocator, &buffer));
 
   // Copy the data from the source buffer.
-  memcpy(target_span.data, source_span.data, target_span.data_length);
+  memcpy(buffer->data.data, source_span.data, buffer->data.data_length);
 
   *out_buffer = buffer;
   IREE_TRACE_ZONE_END(z0);
@@ -102,6 +102,14 @@ iree_vm_buffer_create(iree_vm_buffer_access_t access, iree_host_size_t length,
                       iree_host_size_t alignment, iree_allocator_t allocator,
                       iree_vm_buffer_t** out_buffer);
 
+// Creates a new buffer of the given byte |length| as with
+// iree_vm_buffer_create but with undefined initial contents.
+// Only use this when the caller will immediately overwrite the entire buffer.
+IREE_API_EXPORT iree_status_t iree_vm_buffer_create_uninitialized(
+    iree_vm_buffer_access_t access, iree_host_size_t length,
+    iree_host_size_t alignment, iree_allocator_t allocator,
+    iree_vm_buffer_t** out_buffer);
+
 // Retains the given |buffer| for the caller.
 IREE_API_EXPORT void iree_vm_buffer_retain(iree_vm_buffer_t* buffer);
 
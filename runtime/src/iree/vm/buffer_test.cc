@@ -7,9 +7,11 @@
 #include "iree/vm/buffer.h"
 
 #include <cstddef>
+#include <cstring>
 
 #include "iree/base/api.h"
 #include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
 #include "iree/vm/instance.h"
 
 namespace {
@@ -50,4 +52,40 @@ TEST_F(VMBufferTest, Initialize) {
   ASSERT_TRUE(did_free);
 }
 
+// Tests that clones contain exactly the requested range of the source.
+TEST_F(VMBufferTest, Clone) {
+  uint8_t data[] = {0, 1, 2, 3, 4, 5, 6, 7};
+  iree_vm_buffer_t source;
+  iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_HOST,
+                            iree_make_byte_span(data, sizeof(data)),
+                            iree_allocator_null(), &source);
+
+  iree_vm_buffer_t* clone = NULL;
+  IREE_ASSERT_OK(iree_vm_buffer_clone(IREE_VM_BUFFER_ACCESS_MUTABLE, &source,
+                                      /*source_offset=*/2, /*length=*/4,
+                                      /*alignment=*/64, iree_allocator_system(),
+                                      &clone));
+  ASSERT_EQ(iree_vm_buffer_length(clone), 4);
+  EXPECT_TRUE(iree_host_size_has_alignment(
+      (iree_host_size_t)iree_vm_buffer_data(clone), 64));
+  const uint8_t expected[] = {2, 3, 4, 5};
+  EXPECT_EQ(memcmp(iree_vm_buffer_data(clone), expected, sizeof(expected)), 0);
+  iree_vm_buffer_release(clone);
+
+  iree_vm_buffer_deinitialize(&source);
+}
+
+// Tests that uninitialized buffers are allocated with the requested layout.
+TEST_F(VMBufferTest, CreateUninitialized) {
+  iree_vm_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_vm_buffer_create_uninitialized(
+      IREE_VM_BUFFER_ACCESS_MUTABLE, /*length=*/123, /*alignment=*/32,
+      iree_allocator_system(), &buffer));
+  ASSERT_EQ(iree_vm_buffer_length(buffer), 123);
+  EXPECT_TRUE(iree_host_size_has_alignment(
+      (iree_host_size_t)iree_vm_buffer_data(buffer), 32));
+  memset(iree_vm_buffer_data(buffer), 0xCD, iree_vm_buffer_length(buffer));
+  iree_vm_buffer_release(buffer);
+}
+
 }  // namespace
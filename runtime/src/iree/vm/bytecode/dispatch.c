@@ -14,6 +14,7 @@
 #include "iree/vm/bytecode/disassembler.h"
 #include "iree/vm/bytecode/dispatch_util.h"
 #include "iree/vm/bytecode/module_impl.h"
+#include "iree/vm/bytecode/verifier.h"
 #include "iree/vm/ops.h"
 
 //===----------------------------------------------------------------------===//
@@ -30,6 +31,14 @@
 static void iree_vm_bytecode_dispatch_remap_branch_registers(
     int32_t* IREE_RESTRICT regs_i32, iree_vm_ref_t* IREE_RESTRICT regs_ref,
     const iree_vm_register_remap_list_t* IREE_RESTRICT remap_list) {
+  if (!regs_ref) {
+    // Functions without ref registers only ever remap i32 registers.
+    for (int i = 0; i < remap_list->size; ++i) {
+      regs_i32[remap_list->pairs[i].dst_reg] =
+          regs_i32[remap_list->pairs[i].src_reg];
+    }
+    return;
+  }
   for (int i = 0; i < remap_list->size; ++i) {
     // TODO(benvanik): change encoding to avoid this branching.
     // Could write two arrays: one for prims and one for refs.
@@ -51,6 +60,7 @@ static void iree_vm_bytecode_dispatch_remap_branch_registers(
 static void iree_vm_bytecode_dispatch_discard_registers(
     iree_vm_ref_t* IREE_RESTRICT regs_ref,
     const iree_vm_register_list_t* IREE_RESTRICT reg_list) {
+  if (!regs_ref) return;  // no ref registers to discard
   for (int i = 0; i < reg_list->size; ++i) {
     // TODO(benvanik): change encoding to avoid this branching.
     uint16_t reg = reg_list->registers[i];
@@ -72,8 +82,10 @@ static inline iree_vm_registers_t iree_vm_bytecode_get_register_storage(
   return (iree_vm_registers_t){
       .i32 = (int32_t*)((uintptr_t)stack_storage +
                         stack_storage->i32_register_offset),
-      .ref = (iree_vm_ref_t*)((uintptr_t)stack_storage +
-                              stack_storage->ref_register_offset),
+      .ref = stack_storage->ref_register_count
+                 ? (iree_vm_ref_t*)((uintptr_t)stack_storage +
+                                    stack_storage->ref_register_offset)
+                 : NULL,
   };
 }
 
@@ -105,6 +117,16 @@ static iree_status_t iree_vm_bytecode_function_enter(
   const iree_vm_FunctionDescriptor_t* target_descriptor =
       &module->function_descriptor_table[function.ordinal];
 
+#if IREE_VM_BYTECODE_VERIFICATION_ENABLE
+  // Modules loaded with deferred verification verify each function the first
+  // time it is entered. This is the only place frames are created for bytecode
+  // functions so nothing executes unverified bytecode.
+  if (IREE_UNLIKELY(module->verified_function_bitmap)) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_function_verify_lazy(
+        module, (uint16_t)function.ordinal));
+  }
+#endif  // IREE_VM_BYTECODE_VERIFICATION_ENABLE
+
   // We first compute the frame size of the callee and the masks we'll use to
   // bounds check register access. This lets us allocate the entire frame
   // (header, frame, and register storage) as a single pointer bump below.
@@ -280,6 +302,13 @@ static iree_status_t iree_vm_bytecode_internal_enter(
   iree_vm_registers_t src_regs =
       iree_vm_bytecode_get_register_storage(caller_frame);
   iree_vm_registers_t* dst_regs = out_callee_registers;
+  if (!src_regs.ref) {
+    // Callers without ref registers only ever pass i32 registers.
+    for (int i = 0; i < src_reg_list->size; ++i) {
+      dst_regs->i32[i] = src_regs.i32[src_reg_list->registers[i]];
+    }
+    return iree_ok_status();
+  }
   int i32_reg_offset = 0;
   int ref_reg_offset = 0;
   for (int i = 0; i < src_reg_list->size; ++i) {
@@ -335,18 +364,26 @@ static iree_status_t iree_vm_bytecode_internal_leave(
   }
   iree_vm_registers_t caller_registers =
       iree_vm_bytecode_get_register_storage(caller_frame);
-  for (int i = 0; i < src_reg_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
-    uint16_t src_reg = src_reg_list->registers[i];
-    uint16_t dst_reg = dst_reg_list->registers[i];
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      iree_vm_ref_retain_or_move(
-          src_reg & IREE_REF_REGISTER_MOVE_BIT,
-          &callee_registers.ref[src_reg & IREE_REF_REGISTER_MASK],
-          &caller_registers.ref[dst_reg & IREE_REF_REGISTER_MASK]);
-    } else {
-      caller_registers.i32[dst_reg] = callee_registers.i32[src_reg];
+  if (!callee_registers.ref) {
+    // Callees without ref registers only ever return i32 registers.
+    for (int i = 0; i < src_reg_list->size; ++i) {
+      caller_registers.i32[dst_reg_list->registers[i]] =
+          callee_registers.i32[src_reg_list->registers[i]];
+    }
+  } else {
+    for (int i = 0; i < src_reg_list->size; ++i) {
+      // TODO(benvanik): change encoding to avoid this branching.
+      // Could write two arrays: one for prims and one for refs.
+      uint16_t src_reg = src_reg_list->registers[i];
+      uint16_t dst_reg = dst_reg_list->registers[i];
+      if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
+        iree_vm_ref_retain_or_move(
+            src_reg & IREE_REF_REGISTER_MOVE_BIT,
+            &callee_registers.ref[src_reg & IREE_REF_REGISTER_MASK],
+            &caller_registers.ref[dst_reg & IREE_REF_REGISTER_MASK]);
+      } else {
+        caller_registers.i32[dst_reg] = callee_registers.i32[src_reg];
+      }
     }
   }
 
@@ -443,7 +480,7 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
 // Issues a populated import call and marshals the results into |dst_reg_list|.
 static iree_status_t iree_vm_bytecode_issue_import_call(
     iree_vm_stack_t* stack, const iree_vm_function_call_t call,
-    iree_string_view_t cconv_results,
+    const iree_vm_bytecode_import_t* import,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
     iree_vm_stack_frame_t* IREE_RESTRICT* out_caller_frame,
     iree_vm_registers_t* out_caller_registers) {
@@ -472,6 +509,17 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
 
   // Marshal outputs from the ABI results buffer to registers.
   iree_vm_registers_t caller_registers = *out_caller_registers;
+  if (import->flags & IREE_VM_BYTECODE_IMPORT_FLAG_X32_ONLY) {
+    // Results are a packed array of 32-bit words that map 1:1 to registers.
+    const int32_t* IREE_RESTRICT results = (const int32_t*)call.results.data;
+    iree_host_size_t result_count =
+        iree_min(import->results.size, dst_reg_list->size);
+    for (iree_host_size_t i = 0; i < result_count; ++i) {
+      caller_registers.i32[dst_reg_list->registers[i]] = results[i];
+    }
+    return iree_ok_status();
+  }
+  iree_string_view_t cconv_results = import->results;
   uint8_t* IREE_RESTRICT p = call.results.data;
   for (iree_host_size_t i = 0; i < cconv_results.size && i < dst_reg_list->size;
        ++i) {
@@ -556,17 +604,26 @@ static iree_status_t iree_vm_bytecode_call_import(
   // Marshal inputs from registers to the ABI arguments buffer.
   call.arguments.data_length = import->argument_buffer_size;
   call.arguments.data = iree_alloca(call.arguments.data_length);
-  memset(call.arguments.data, 0, call.arguments.data_length);
-  iree_vm_bytecode_populate_import_cconv_arguments(
-      import->arguments, caller_registers,
-      /*segment_size_list=*/NULL, src_reg_list, call.arguments);
+  if (import->flags & IREE_VM_BYTECODE_IMPORT_FLAG_X32_ONLY) {
+    // Fixed signatures of 32-bit scalars fully populate the buffer with one
+    // word per register and need no clearing or cconv parsing.
+    int32_t* IREE_RESTRICT arguments = (int32_t*)call.arguments.data;
+    for (iree_host_size_t i = 0; i < import->arguments.size; ++i) {
+      arguments[i] = caller_registers.i32[src_reg_list->registers[i]];
+    }
+  } else {
+    memset(call.arguments.data, 0, call.arguments.data_length);
+    iree_vm_bytecode_populate_import_cconv_arguments(
+        import->arguments, caller_registers,
+        /*segment_size_list=*/NULL, src_reg_list, call.arguments);
+  }
 
   // Issue the call and handle results.
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
+  return iree_vm_bytecode_issue_import_call(stack, call, import, dst_reg_list,
+                                            out_caller_frame,
                                             out_caller_registers);
 }
 
@@ -606,8 +663,8 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
+  return iree_vm_bytecode_issue_import_call(stack, call, import, dst_reg_list,
+                                            out_caller_frame,
                                             out_caller_registers);
 }
 
@@ -63,7 +63,10 @@
 typedef struct iree_vm_registers_t {
   // 16-byte aligned i32 register array.
   int32_t* i32;
-  // Naturally aligned ref register array.
+  // Naturally aligned ref register array or NULL if the function has no ref
+  // registers. The verifier rejects any use of ref registers in such functions
+  // so register lists are known to contain only i32 registers and can be
+  // processed without testing the type bit of each register.
   iree_vm_ref_t* ref;
 } iree_vm_registers_t;
 
@@ -116,7 +119,7 @@ static inline iree_vm_type_def_t iree_vm_map_type(
 #define IREE_DISPATCH_TRACE_INSTRUCTION(...)
 #endif  // IREE_VM_EXECUTION_TRACING_ENABLE
 
-#if defined(IREE_COMPILER_CLANG) && \
+#if (defined(IREE_COMPILER_CLANG) || defined(IREE_COMPILER_GCC)) && \
     IREE_VM_BYTECODE_DISPATCH_COMPUTED_GOTO_ENABLE
 #define IREE_DISPATCH_MODE_COMPUTED_GOTO 1
 #else
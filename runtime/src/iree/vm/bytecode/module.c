@@ -667,6 +667,52 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   return iree_ok_status();
 }
 
+static iree_status_t iree_vm_bytecode_module_fork_state(
+    void* self, iree_vm_module_state_t* parent_state,
+    iree_allocator_t allocator, iree_vm_module_state_t** out_module_state) {
+  IREE_ASSERT_ARGUMENT(parent_state);
+  IREE_ASSERT_ARGUMENT(out_module_state);
+  *out_module_state = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  iree_vm_bytecode_module_state_t* parent =
+      (iree_vm_bytecode_module_state_t*)parent_state;
+
+  iree_host_size_t total_state_struct_size =
+      iree_vm_bytecode_module_layout_state(module->def, NULL);
+  iree_vm_bytecode_module_state_t* state = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_state_struct_size,
+                                (void**)&state));
+  state->allocator = allocator;
+  iree_vm_bytecode_module_layout_state(module->def, state);
+
+  // Primitive globals are mutable and copied by value.
+  if (state->rwdata_storage.data_length > 0) {
+    memcpy(state->rwdata_storage.data, parent->rwdata_storage.data,
+           state->rwdata_storage.data_length);
+  }
+
+  // Ref globals retain the parent objects such that large immutable values
+  // (buffers, parameters, etc) are shared instead of duplicated. Resetting a
+  // global in either context does not impact the other.
+  for (iree_host_size_t i = 0; i < state->global_ref_count; ++i) {
+    iree_vm_ref_retain(&parent->global_ref_table[i],
+                       &state->global_ref_table[i]);
+  }
+
+  // Imports reference the same modules and stay valid.
+  if (state->import_count > 0) {
+    memcpy(state->import_table, parent->import_table,
+           state->import_count * sizeof(*state->import_table));
+  }
+
+  *out_module_state = (iree_vm_module_state_t*)state;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static void iree_vm_bytecode_module_free_state(
     void* self, iree_vm_module_state_t* module_state) {
   if (!module_state) return;
@@ -685,6 +731,22 @@ static void iree_vm_bytecode_module_free_state(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns true if every value in |cconv_fragment| is a 32-bit scalar.
+// Empty fragments (no values) are trivially 32-bit only.
+static bool iree_vm_bytecode_cconv_fragment_is_x32_only(
+    iree_string_view_t cconv_fragment) {
+  for (iree_host_size_t i = 0; i < cconv_fragment.size; ++i) {
+    switch (cconv_fragment.data[i]) {
+      case IREE_VM_CCONV_TYPE_I32:
+      case IREE_VM_CCONV_TYPE_F32:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
 static iree_status_t iree_vm_bytecode_module_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
     const iree_vm_function_t* function,
@@ -727,6 +789,14 @@ static iree_status_t iree_vm_bytecode_module_resolve_import(
   import->argument_buffer_size = (uint16_t)argument_buffer_size;
   import->result_buffer_size = (uint16_t)result_buffer_size;
 
+  // Detect signatures made entirely of 32-bit scalars so that calls can skip
+  // calling convention parsing and copy register words directly.
+  import->flags = IREE_VM_BYTECODE_IMPORT_FLAG_NONE;
+  if (iree_vm_bytecode_cconv_fragment_is_x32_only(import->arguments) &&
+      iree_vm_bytecode_cconv_fragment_is_x32_only(import->results)) {
+    import->flags |= IREE_VM_BYTECODE_IMPORT_FLAG_X32_ONLY;
+  }
+
   return iree_ok_status();
 }
 
@@ -792,10 +862,25 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_vm_instance_t* instance, iree_const_byte_span_t archive_contents,
     iree_allocator_t archive_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module) {
+  return iree_vm_bytecode_module_create_with_flags(
+      instance, IREE_VM_BYTECODE_MODULE_FLAG_NONE, archive_contents,
+      archive_allocator, allocator, out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create_with_flags(
+    iree_vm_instance_t* instance, iree_vm_bytecode_module_flags_t flags,
+    iree_const_byte_span_t archive_contents, iree_allocator_t archive_allocator,
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
 
+  // Trusted archives always have their functions verified lazily as we don't
+  // want to spend the time skipped by trusting the FlatBuffer on bytecode.
+  if (flags & IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED) {
+    flags |= IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION;
+  }
+
   // Parse and verify the archive header to locate the FlatBuffer.
   iree_const_byte_span_t flatbuffer_contents = iree_const_byte_span_empty();
   iree_host_size_t archive_rodata_offset = 0;
@@ -803,15 +888,18 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
       z0, iree_vm_bytecode_archive_parse_header(
               archive_contents, &flatbuffer_contents, &archive_rodata_offset));
 
-  IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_vm_bytecode_module_flatbuffer_verify");
-  iree_status_t status = iree_vm_bytecode_module_flatbuffer_verify(
-      archive_contents, flatbuffer_contents, archive_rodata_offset);
-  if (!iree_status_is_ok(status)) {
+  if (!(flags & IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED)) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z1,
+                                "iree_vm_bytecode_module_flatbuffer_verify");
+    iree_status_t status = iree_vm_bytecode_module_flatbuffer_verify(
+        archive_contents, flatbuffer_contents, archive_rodata_offset);
+    if (!iree_status_is_ok(status)) {
+      IREE_TRACE_ZONE_END(z1);
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
     IREE_TRACE_ZONE_END(z1);
-    IREE_TRACE_ZONE_END(z0);
-    return status;
   }
-  IREE_TRACE_ZONE_END(z1);
 
   iree_vm_BytecodeModuleDef_table_t module_def =
       iree_vm_BytecodeModuleDef_as_root(flatbuffer_contents.data);
@@ -832,19 +920,38 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   size_t rodata_ref_table_size =
       iree_host_align(rodata_ref_count * sizeof(iree_vm_buffer_t), 16);
 
+  iree_vm_FunctionDescriptor_vec_t function_descriptors =
+      iree_vm_BytecodeModuleDef_function_descriptors(module_def);
+  iree_host_size_t function_descriptor_count =
+      iree_vm_FunctionDescriptor_vec_len(function_descriptors);
+  size_t verified_function_bitmap_size = 0;
+#if IREE_VM_BYTECODE_VERIFICATION_ENABLE
+  if (flags & IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION) {
+    verified_function_bitmap_size = iree_host_align(
+        iree_host_size_ceil_div(function_descriptor_count, 32) *
+            sizeof(iree_atomic_int32_t),
+        16);
+  }
+#endif  // IREE_VM_BYTECODE_VERIFICATION_ENABLE
+
   iree_vm_bytecode_module_t* module = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_allocator_malloc(
-          allocator, sizeof(*module) + type_table_size + rodata_ref_table_size,
-          (void**)&module));
+      z0, iree_allocator_malloc(allocator,
+                                sizeof(*module) + type_table_size +
+                                    rodata_ref_table_size +
+                                    verified_function_bitmap_size,
+                                (void**)&module));
   module->allocator = allocator;
+  module->flags = flags;
 
-  iree_vm_FunctionDescriptor_vec_t function_descriptors =
-      iree_vm_BytecodeModuleDef_function_descriptors(module_def);
-  module->function_descriptor_count =
-      iree_vm_FunctionDescriptor_vec_len(function_descriptors);
+  module->function_descriptor_count = function_descriptor_count;
   module->function_descriptor_table = function_descriptors;
+  if (verified_function_bitmap_size > 0) {
+    // Zeroed by the allocation so that no function is marked verified.
+    module->verified_function_bitmap =
+        (iree_atomic_int32_t*)((uint8_t*)module + sizeof(*module) +
+                               type_table_size + rodata_ref_table_size);
+  }
 
   flatbuffers_uint8_vec_t bytecode_data =
       iree_vm_BytecodeModuleDef_bytecode_data(module_def);
@@ -881,6 +988,7 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
 #endif  // IREE_VM_BACKTRACE_ENABLE
   module->interface.alloc_state = iree_vm_bytecode_module_alloc_state;
   module->interface.free_state = iree_vm_bytecode_module_free_state;
+  module->interface.fork_state = iree_vm_bytecode_module_fork_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.notify = iree_vm_bytecode_module_notify;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
@@ -916,10 +1024,13 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   }
 
   // Verify functions in the module now that we've verified the metadata that we
-  // need to do so.
+  // need to do so. Modules with deferred verification verify each function on
+  // its first call instead.
   iree_status_t verify_status = iree_ok_status();
 #if IREE_VM_BYTECODE_VERIFICATION_ENABLE
-  for (uint16_t i = 0; i < module->function_descriptor_count; ++i) {
+  for (uint16_t i = 0; !module->verified_function_bitmap &&
+                       i < module->function_descriptor_count;
+       ++i) {
     IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_vm_bytecode_function_verify");
     verify_status = iree_vm_bytecode_function_verify(module, i, allocator);
     IREE_TRACE_ZONE_END(z1);
@@ -935,3 +1046,32 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   IREE_TRACE_ZONE_END(z0);
   return verify_status;
 }
+
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_hash_archive(
+    iree_const_byte_span_t archive_contents, uint64_t* out_hash) {
+  IREE_ASSERT_ARGUMENT(out_hash);
+  *out_hash = 0;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_const_byte_span_t flatbuffer_contents = iree_const_byte_span_empty();
+  iree_host_size_t archive_rodata_offset = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_bytecode_archive_parse_header(
+              archive_contents, &flatbuffer_contents, &archive_rodata_offset));
+
+  // 64-bit FNV-1a over the archive size followed by the FlatBuffer bytes.
+  uint64_t hash = 0xCBF29CE484222325ull;
+  uint64_t archive_length = (uint64_t)archive_contents.data_length;
+  for (iree_host_size_t i = 0; i < sizeof(archive_length); ++i) {
+    hash ^= (uint8_t)(archive_length >> (i * 8));
+    hash *= 0x100000001B3ull;
+  }
+  for (iree_host_size_t i = 0; i < flatbuffer_contents.data_length; ++i) {
+    hash ^= flatbuffer_contents.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  *out_hash = hash;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
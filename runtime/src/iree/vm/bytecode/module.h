@@ -14,6 +14,29 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Controls how much of a module is verified when it is created.
+enum iree_vm_bytecode_module_flag_bits_t {
+  IREE_VM_BYTECODE_MODULE_FLAG_NONE = 0u,
+
+  // Defers verification of the bytecode of each function until the first time
+  // it is called. Modules with many functions that are rarely called (or only
+  // called on some paths) load faster and functions that are never called are
+  // never verified. Errors that would have been reported at load time are
+  // instead returned from the first call to the invalid function.
+  IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION = 1u << 0,
+
+  // The archive contents are trusted to have been produced by the compiler and
+  // not modified since: FlatBuffer verification is skipped entirely and
+  // function bytecode is verified lazily as with
+  // IREE_VM_BYTECODE_MODULE_FLAG_LAZY_FUNCTION_VERIFICATION. Loading an
+  // untrusted or corrupted archive with this flag may crash the process;
+  // callers should only set it when the archive has previously been verified,
+  // such as when its iree_vm_bytecode_module_hash_archive hash matches that of
+  // an archive that was loaded with full verification.
+  IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED = 1u << 1,
+};
+typedef uint32_t iree_vm_bytecode_module_flags_t;
+
 // Creates a VM module from an in-memory ModuleDef FlatBuffer archive.
 // If a |archive_allocator| is provided then it will be used to free the
 // |archive_contents| when the module is destroyed and otherwise the ownership
@@ -23,6 +46,26 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_allocator_t archive_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module);
 
+// Creates a VM module as with iree_vm_bytecode_module_create with |flags|
+// controlling how the archive is verified.
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create_with_flags(
+    iree_vm_instance_t* instance, iree_vm_bytecode_module_flags_t flags,
+    iree_const_byte_span_t archive_contents, iree_allocator_t archive_allocator,
+    iree_allocator_t allocator, iree_vm_module_t** out_module);
+
+// Computes a 64-bit hash of the portions of |archive_contents| covered by
+// module verification. The hash includes the module FlatBuffer and the total
+// archive size but not external rodata contents, which are never verified and
+// may be large. Hosts can record the hashes of archives that loaded with full
+// verification and pass IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED when loading an
+// archive with a previously recorded hash.
+//
+// NOTE: the hash is not cryptographically secure and only guards against
+// accidental modification of the archive. Hosts loading archives from
+// untrusted sources must not rely on it.
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_hash_archive(
+    iree_const_byte_span_t archive_contents, uint64_t* out_hash);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -335,6 +335,17 @@ IREE_BENCHMARK_FN(BM_LoopSumBytecode) {
 }
 IREE_BENCHMARK_REGISTER(BM_LoopSumBytecode);
 
+IREE_BENCHMARK_FN(BM_LoopCarriedBytecode) {
+  static const int batch = 100000;
+  return RunFunction(
+      benchmark_state,
+      iree_make_cstring_view("bytecode_module_benchmark.loop_carried"),
+      {batch},
+      /*result_count=*/1,
+      /*batch_size=*/batch);
+}
+IREE_BENCHMARK_REGISTER(BM_LoopCarriedBytecode);
+
 IREE_BENCHMARK_FN(BM_BufferReduceReference) {
   static const int batch = 100000;
   static auto work = +[](int32_t* buffer, int i, int sum) {
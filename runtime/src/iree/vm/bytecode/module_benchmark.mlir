@@ -77,6 +77,22 @@ vm.module @bytecode_module_benchmark {
     vm.return %ie : i32
   }
 
+  // Measures the cost of a loop carrying several values across the backedge
+  // such that each iteration remaps multiple branch operands.
+  vm.export @loop_carried
+  vm.func @loop_carried(%count : i32) -> i32 {
+    %c1 = vm.const.i32 1
+    %i0 = vm.const.i32.zero
+    vm.br ^loop(%i0, %i0, %c1, %i0 : i32, i32, i32, i32)
+  ^loop(%i : i32, %a : i32, %b : i32, %c : i32):
+    %in = vm.add.i32 %i, %c1 : i32
+    %ab = vm.add.i32 %a, %b : i32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %b, %ab, %a : i32, i32, i32, i32), ^loop_exit(%in : i32)
+  ^loop_exit(%ie : i32):
+    vm.return %ie : i32
+  }
+
   // Measures the cost of lots of buffer loads.
   vm.export @buffer_reduce
   vm.func @buffer_reduce(%count : i32) -> i32 {
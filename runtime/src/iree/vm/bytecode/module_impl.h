@@ -11,7 +11,9 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/vm/api.h"
+#include "iree/vm/bytecode/module.h"
 #include "iree/vm/bytecode/utils/isa.h"
 
 #ifdef __cplusplus
@@ -34,6 +36,14 @@ typedef struct iree_vm_bytecode_module_t {
   // A pointer to the bytecode data embedded within the module.
   iree_const_byte_span_t bytecode_data;
 
+  // Flags the module was created with.
+  iree_vm_bytecode_module_flags_t flags;
+
+  // Bitmap with one bit per function descriptor set once the function has been
+  // verified. Only allocated when function verification is deferred until the
+  // first call and otherwise NULL as all functions are verified on creation.
+  iree_atomic_int32_t* verified_function_bitmap;
+
   // Allocator this module was allocated with and must be freed with.
   iree_allocator_t allocator;
 
@@ -55,6 +65,17 @@ typedef struct iree_vm_bytecode_module_t {
 
 // A resolved and split import in the module state table.
 //
+// Bitfield of precomputed import properties used to select call fast paths.
+enum iree_vm_bytecode_import_flag_bits_t {
+  IREE_VM_BYTECODE_IMPORT_FLAG_NONE = 0u,
+  // All arguments and results are 32-bit scalars (`i` or `f`) and map 1:1 to
+  // i32 registers with no ref ownership transfer or variadic segments. Calls
+  // copy register words directly into/out of the ABI buffers without parsing
+  // the calling convention.
+  IREE_VM_BYTECODE_IMPORT_FLAG_X32_ONLY = 1u << 0,
+};
+typedef uint16_t iree_vm_bytecode_import_flags_t;
+
 // NOTE: a table of these are stored per module per context so ideally we'd
 // only store the absolute minimum information to reduce our fixed overhead.
 // There's a big tradeoff though as a few extra bytes here can avoid non-trivial
@@ -73,6 +94,9 @@ typedef struct iree_vm_bytecode_import_t {
   // don't support variadic values (yet).
   uint16_t argument_buffer_size;
   uint16_t result_buffer_size;
+
+  // Precomputed properties of the signature used to select call fast paths.
+  iree_vm_bytecode_import_flags_t flags;
 } iree_vm_bytecode_import_t;
 
 // Per-instance module state.
@@ -332,11 +332,15 @@ iree_status_t iree_vm_bytecode_function_verify(
   }
 
   // Ensure the register storage (rounded to the nearest power of 2) won't
-  // exceed the maximum allowed registers.
+  // exceed the maximum allowed registers. Functions declaring no ref registers
+  // have none allocated and the dispatcher relies on them being unused.
   verify_state.i32_register_count = iree_math_round_up_to_pow2_u32(
       VMMAX(1, function_descriptor->i32_register_count));
-  verify_state.ref_register_count = iree_math_round_up_to_pow2_u32(
-      VMMAX(1, function_descriptor->ref_register_count));
+  verify_state.ref_register_count =
+      function_descriptor->ref_register_count
+          ? iree_math_round_up_to_pow2_u32(
+                function_descriptor->ref_register_count)
+          : 0;
   if (IREE_UNLIKELY(verify_state.i32_register_count > IREE_I32_REGISTER_MASK) ||
       IREE_UNLIKELY(verify_state.ref_register_count > IREE_REF_REGISTER_MASK)) {
     // Register count overflow. A valid compiler should never produce files that
@@ -427,6 +431,26 @@ iree_status_t iree_vm_bytecode_function_verify(
   return status;
 }
 
+iree_status_t iree_vm_bytecode_function_verify_lazy(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal) {
+  IREE_ASSERT(module->verified_function_bitmap);
+  iree_atomic_int32_t* word =
+      &module->verified_function_bitmap[function_ordinal / 32];
+  const int32_t mask = (int32_t)(1u << (function_ordinal % 32));
+  if (iree_atomic_load_int32(word, iree_memory_order_acquire) & mask) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, function_ordinal);
+  iree_status_t status = iree_vm_bytecode_function_verify(
+      module, function_ordinal, module->allocator);
+  if (iree_status_is_ok(status)) {
+    iree_atomic_fetch_or_int32(word, mask, iree_memory_order_release);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // Utilities matching the tablegen op encoding scheme
 //===----------------------------------------------------------------------===//
@@ -506,9 +530,11 @@ iree_status_t iree_vm_bytecode_function_verify(
                             "ref register ordinal %u out of range %u",       \
                             (ordinal), verify_state->ref_register_count);    \
   }
-#define IREE_VM_VERIFY_REG_ANY(ordinal)                               \
-  if (IREE_UNLIKELY(((ordinal) & IREE_REF_REGISTER_TYPE_BIT) == 0)) { \
-  } else {                                                            \
+#define IREE_VM_VERIFY_REG_ANY(ordinal)                 \
+  if (((ordinal) & IREE_REF_REGISTER_TYPE_BIT) == 0) {  \
+    IREE_VM_VERIFY_REG_ORDINAL_X32(ordinal, "operand"); \
+  } else {                                              \
+    IREE_VM_VERIFY_REG_REF(ordinal);                    \
   }
 
 #define VM_VerifyConstI8(name)             \
@@ -35,4 +35,11 @@ iree_status_t iree_vm_bytecode_function_verify(
     iree_vm_bytecode_module_t* module, uint16_t function_ordinal,
     iree_allocator_t scratch_allocator);
 
+// Verifies |function_ordinal| if it has not already been verified.
+// Only valid on modules with a verified_function_bitmap. Verification may race
+// if multiple threads call the function for the first time concurrently with
+// each verifying it independently.
+iree_status_t iree_vm_bytecode_function_verify_lazy(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal);
+
 #endif  // IREE_VM_BYTECODE_VERIFIER_H_
@@ -348,6 +348,72 @@ IREE_API_EXPORT iree_status_t iree_vm_context_create_with_modules(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t iree_vm_context_fork(
+    iree_vm_context_t* context, iree_allocator_t allocator,
+    iree_vm_context_t** out_context) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_context);
+  *out_context = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  const iree_host_size_t module_count = context->list.count;
+  iree_host_size_t context_size =
+      sizeof(iree_vm_context_t) + sizeof(iree_vm_module_t*) * module_count +
+      sizeof(iree_vm_module_state_t*) * module_count;
+
+  iree_vm_context_t* fork = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, context_size, (void**)&fork));
+  iree_atomic_ref_count_init(&fork->ref_count);
+  fork->instance = context->instance;
+  iree_vm_instance_retain(fork->instance);
+  fork->allocator = allocator;
+
+  fork->context_id = iree_vm_context_allocate_id();
+
+  // The module set is fixed at the time of the fork.
+  fork->is_frozen = 1;
+  fork->is_static = 1;
+  fork->flags = context->flags;
+
+  uint8_t* p = (uint8_t*)fork + sizeof(iree_vm_context_t);
+  fork->list.modules = (iree_vm_module_t**)p;
+  p += sizeof(iree_vm_module_t*) * module_count;
+  fork->list.module_states = (iree_vm_module_state_t**)p;
+  p += sizeof(iree_vm_module_state_t*) * module_count;
+  fork->list.count = 0;
+  fork->list.capacity = module_count;
+
+  // Clone module states in registration order. Imports were resolved against
+  // the same module instances and remain valid in the fork.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < module_count; ++i) {
+    iree_vm_module_t* module = context->list.modules[i];
+    fork->list.modules[i] = module;
+    fork->list.module_states[i] = NULL;
+    iree_vm_module_retain(module);
+    ++fork->list.count;
+    if (!module->fork_state) {
+      iree_string_view_t module_name = iree_vm_module_name(module);
+      status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "module '%.*s' does not support forking state",
+                                (int)module_name.size, module_name.data);
+      break;
+    }
+    status = module->fork_state(module->self, context->list.module_states[i],
+                                allocator, &fork->list.module_states[i]);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_context = fork;
+  } else {
+    iree_vm_context_destroy(fork);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static void iree_vm_context_destroy(iree_vm_context_t* context) {
   if (!context) return;
 
@@ -46,7 +46,11 @@ enum iree_vm_context_flag_bits_t {
   // Context allows concurrent execution.
   // Multiple OS threads may call into the context concurrently. Synchronization
   // is not performed by the context and callers must ensure the executing
-  // programs support concurrency.
+  // programs support concurrency. Each concurrent invocation requires its own
+  // stack. Functions for which iree_vm_function_is_stateless returns true do
+  // not mutate module state and are always safe to invoke concurrently; this
+  // allows a single context (and a single copy of its globals) to be shared
+  // across threads instead of creating one context per thread.
   IREE_VM_CONTEXT_FLAG_CONCURRENT = 1u << 1,
 };
 typedef uint32_t iree_vm_context_flags_t;
@@ -69,6 +73,27 @@ IREE_API_EXPORT iree_status_t iree_vm_context_create_with_modules(
     iree_host_size_t module_count, iree_vm_module_t** modules,
     iree_allocator_t allocator, iree_vm_context_t** out_context);
 
+// Creates a new context by forking the fully initialized |context|.
+// The new context has the same instance, flags, and modules as the source and
+// each module state is cloned from the source state via the module
+// `fork_state` interface instead of being allocated and initialized again.
+// Module initializers are not run and imports are not re-resolved, making this
+// significantly cheaper than iree_vm_context_create_with_modules when many
+// contexts (such as per-session contexts in a multi-tenant server) are created
+// with the same modules. `__deinit` functions are still run when the forked
+// context is released.
+//
+// What is shared is up to each module; bytecode modules copy their mutable
+// primitive globals and share ref globals (such as loaded weights) by
+// reference. Fails with IREE_STATUS_UNIMPLEMENTED if any module does not
+// support forking its state.
+//
+// The source |context| must not be executing concurrently with the fork.
+// |out_context| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_vm_context_fork(
+    iree_vm_context_t* context, iree_allocator_t allocator,
+    iree_vm_context_t** out_context);
+
 // Retains the given |context| for the caller.
 IREE_API_EXPORT void iree_vm_context_retain(iree_vm_context_t* context);
 
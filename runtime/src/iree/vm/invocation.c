@@ -159,9 +159,8 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
   }
 
   // Resize the output list to hold all results (and kill anything that may
-  // have been in there).
-  // TODO(benvanik): list method for resetting to a new size.
-  IREE_RETURN_IF_ERROR(iree_vm_list_resize(outputs, 0));
+  // have been in there). Capacity is retained so reused lists don't allocate.
+  iree_vm_list_clear(outputs);
   IREE_RETURN_IF_ERROR(iree_vm_list_resize(outputs, expected_output_count));
 
   uint8_t* p = results.data;
@@ -269,11 +268,19 @@ static void iree_vm_invoke_fiber_leave(iree_vm_invocation_id_t invocation_id,
 // Synchronous invocation
 //===----------------------------------------------------------------------===//
 
-IREE_API_EXPORT iree_status_t iree_vm_invoke(
+static iree_status_t iree_vm_begin_invoke_on_stack(
+    iree_vm_invoke_state_t* state, iree_vm_context_t* context,
+    iree_vm_function_t function, iree_vm_invocation_flags_t flags,
+    const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
+    iree_vm_stack_t* borrowed_stack, iree_allocator_t host_allocator);
+
+// Runs an invocation to completion on either a new stack in the invocation
+// state storage or |borrowed_stack| if provided.
+static iree_status_t iree_vm_invoke_sync(
     iree_vm_context_t* context, iree_vm_function_t function,
     iree_vm_invocation_flags_t flags, const iree_vm_invocation_policy_t* policy,
     const iree_vm_list_t* inputs, iree_vm_list_t* outputs,
-    iree_allocator_t host_allocator) {
+    iree_vm_stack_t* borrowed_stack, iree_allocator_t host_allocator) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Bound the synchronous invocation to the timeout specified by the user
@@ -298,9 +305,13 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
   // Perform the initial invocation step, which if synchronous may fully
   // complete the invocation before returning. If it yields we'll need to resume
   // it, possibly after taking care of pending waits.
-  iree_vm_invoke_state_t state = {0};
-  iree_status_t status = iree_vm_begin_invoke(&state, context, function, flags,
-                                              policy, inputs, host_allocator);
+  // NOTE: only the state header is cleared; the inline stack storage is
+  // initialized as it is used.
+  iree_vm_invoke_state_t state;
+  memset(&state, 0, offsetof(iree_vm_invoke_state_t, stack_storage));
+  iree_status_t status =
+      iree_vm_begin_invoke_on_stack(&state, context, function, flags, policy,
+                                    inputs, borrowed_stack, host_allocator);
   while (iree_status_is_deferred(status)) {
     // Grab the wait frame from the stack holding the wait parameters.
     // This is optional: if an invocation yields for cooperative scheduling
@@ -368,6 +379,26 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_vm_invoke(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, const iree_vm_invocation_policy_t* policy,
+    const iree_vm_list_t* inputs, iree_vm_list_t* outputs,
+    iree_allocator_t host_allocator) {
+  return iree_vm_invoke_sync(context, function, flags, policy, inputs, outputs,
+                             /*borrowed_stack=*/NULL, host_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invoke_with_stack(
+    iree_vm_stack_t* stack, iree_vm_context_t* context,
+    iree_vm_function_t function, const iree_vm_invocation_policy_t* policy,
+    const iree_vm_list_t* inputs, iree_vm_list_t* outputs) {
+  IREE_ASSERT_ARGUMENT(stack);
+  return iree_vm_invoke_sync(context, function,
+                             iree_vm_stack_invocation_flags(stack), policy,
+                             inputs, outputs, stack,
+                             iree_vm_stack_allocator(stack));
+}
+
 //===----------------------------------------------------------------------===//
 // Asynchronous invocation
 //===----------------------------------------------------------------------===//
@@ -375,13 +406,26 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
 // Argument storage larger than this will require a heap allocation.
 #define IREE_VM_STACK_MAX_ARGUMENT_ALLOCA_SIZE (iree_host_size_t)(16 * 1024)
 
-// WARNING: this function cannot have any trace markers that span the begin
-// call; the begin may yield with zones still open.
 IREE_API_EXPORT iree_status_t iree_vm_begin_invoke(
     iree_vm_invoke_state_t* state, iree_vm_context_t* context,
     iree_vm_function_t function, iree_vm_invocation_flags_t flags,
     const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
     iree_allocator_t host_allocator) {
+  return iree_vm_begin_invoke_on_stack(state, context, function, flags, policy,
+                                       inputs, /*borrowed_stack=*/NULL,
+                                       host_allocator);
+}
+
+// Begins an invocation on |borrowed_stack| if provided and otherwise on a new
+// stack initialized in the |state| inline storage.
+//
+// WARNING: this function cannot have any trace markers that span the begin
+// call; the begin may yield with zones still open.
+static iree_status_t iree_vm_begin_invoke_on_stack(
+    iree_vm_invoke_state_t* state, iree_vm_context_t* context,
+    iree_vm_function_t function, iree_vm_invocation_flags_t flags,
+    const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
+    iree_vm_stack_t* borrowed_stack, iree_allocator_t host_allocator) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -462,12 +506,19 @@ IREE_API_EXPORT iree_status_t iree_vm_begin_invoke(
 
   // Initialize the stack with the inline storage.
   // We (probably) sliced off the head of the storage above to use for results
-  // and perform an offset here to account for that.
-  iree_vm_stack_t* stack = NULL;
-  status = iree_vm_stack_initialize(
-      iree_make_byte_span(state->stack_storage + reserved_storage_size,
-                          sizeof(state->stack_storage) - reserved_storage_size),
-      flags, iree_vm_context_state_resolver(context), host_allocator, &stack);
+  // and perform an offset here to account for that. Borrowed stacks are reset
+  // in case a prior invocation was aborted with frames still on them.
+  iree_vm_stack_t* stack = borrowed_stack;
+  if (borrowed_stack) {
+    iree_vm_stack_reset(borrowed_stack);
+  } else {
+    status = iree_vm_stack_initialize(
+        iree_make_byte_span(
+            state->stack_storage + reserved_storage_size,
+            sizeof(state->stack_storage) - reserved_storage_size),
+        flags, iree_vm_context_state_resolver(context), host_allocator,
+        &stack);
+  }
   if (!iree_status_is_ok(status)) {
     iree_vm_invoke_release_argument_storage(cconv_arguments, arguments,
                                             arguments_on_heap, host_allocator);
@@ -487,6 +538,7 @@ IREE_API_EXPORT iree_status_t iree_vm_begin_invoke(
   state->results = results;
   iree_vm_context_retain(context);
   state->stack = stack;
+  state->owns_stack = borrowed_stack == NULL;
 
   // NOTE: we must end the zone here as the begin_call will return with
   // unbalanced zones if we yield.
@@ -678,7 +730,12 @@ IREE_API_EXPORT void iree_vm_abort_invoke(iree_vm_invoke_state_t* state) {
                                         : iree_allocator_null();
 
   if (state->stack) {
-    iree_vm_stack_deinitialize(state->stack);
+    if (state->owns_stack) {
+      iree_vm_stack_deinitialize(state->stack);
+    } else {
+      // Release frame resources but keep the storage for the next invocation.
+      iree_vm_stack_reset(state->stack);
+    }
     state->stack = NULL;
   }
 
@@ -48,6 +48,22 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
     const iree_vm_list_t* inputs, iree_vm_list_t* outputs,
     iree_allocator_t host_allocator);
 
+// Synchronously invokes a function in the VM using a caller-owned |stack|.
+// Behaves like iree_vm_invoke but instead of initializing a new stack per
+// invocation the provided |stack| is reset and reused, retaining any frame
+// storage it has grown into. Callers making repeated invocations (such as a
+// request loop) can allocate a stack once with iree_vm_stack_allocate and reuse
+// |inputs| and |outputs| lists with sufficient capacity to invoke without any
+// heap allocations.
+//
+// |stack| must have been created with the state resolver of |context| and its
+// invocation flags and allocator are used for the invocation. The stack is
+// empty upon return and may not be used by multiple invocations concurrently.
+IREE_API_EXPORT iree_status_t iree_vm_invoke_with_stack(
+    iree_vm_stack_t* stack, iree_vm_context_t* context,
+    iree_vm_function_t function, const iree_vm_invocation_policy_t* policy,
+    const iree_vm_list_t* inputs, iree_vm_list_t* outputs);
+
 //===----------------------------------------------------------------------===//
 // Asynchronous invocation
 //===----------------------------------------------------------------------===//
@@ -90,6 +106,9 @@ typedef struct iree_vm_invoke_state_t {
   // VM stack used during the invocation. Will retain required resources
   // across invocation stages.
   iree_vm_stack_t* stack;
+  // True if |stack| was initialized in |stack_storage| by the invocation and
+  // must be deinitialized when it ends. Caller-provided stacks are only reset.
+  bool owns_stack;
   // Inlined stack storage. If the stack grows larger than this amount
   // additional storage will be allocated automatically.
   uint8_t stack_storage[IREE_VM_STACK_DEFAULT_SIZE];
@@ -618,6 +618,57 @@ static void iree_vm_list_convert_value_type(
   }
 }
 
+// Loads the primitive element of |element_size| bytes at |element_ptr| into
+// the storage of |value|. Value storage is a union and on little-endian
+// targets each member begins at the lowest address.
+static inline void iree_vm_list_load_element(iree_host_size_t element_size,
+                                             uintptr_t element_ptr,
+                                             iree_vm_value_t* value) {
+#if defined(IREE_ENDIANNESS_LITTLE)
+  memcpy(value->value_storage, (const void*)element_ptr, element_size);
+#else
+  switch (element_size) {
+    case 1:
+      value->i8 = *(int8_t*)element_ptr;
+      break;
+    case 2:
+      value->i16 = *(int16_t*)element_ptr;
+      break;
+    case 4:
+      value->i32 = *(int32_t*)element_ptr;
+      break;
+    case 8:
+      value->i64 = *(int64_t*)element_ptr;
+      break;
+  }
+#endif  // IREE_ENDIANNESS_LITTLE
+}
+
+// Stores the storage of |value| into the primitive element of |element_size|
+// bytes at |element_ptr|.
+static inline void iree_vm_list_store_element(iree_host_size_t element_size,
+                                              const iree_vm_value_t* value,
+                                              uintptr_t element_ptr) {
+#if defined(IREE_ENDIANNESS_LITTLE)
+  memcpy((void*)element_ptr, value->value_storage, element_size);
+#else
+  switch (element_size) {
+    case 1:
+      *(int8_t*)element_ptr = value->i8;
+      break;
+    case 2:
+      *(int16_t*)element_ptr = value->i16;
+      break;
+    case 4:
+      *(int32_t*)element_ptr = value->i32;
+      break;
+    case 8:
+      *(int64_t*)element_ptr = value->i64;
+      break;
+  }
+#endif  // IREE_ENDIANNESS_LITTLE
+}
+
 IREE_API_EXPORT iree_status_t
 iree_vm_list_get_value(const iree_vm_list_t* list, iree_host_size_t i,
                        iree_vm_value_t* out_value) {
@@ -631,21 +682,7 @@ iree_vm_list_get_value(const iree_vm_list_t* list, iree_host_size_t i,
   switch (list->storage_mode) {
     case IREE_VM_LIST_STORAGE_MODE_VALUE: {
       out_value->type = iree_vm_type_def_as_value(list->element_type);
-      // TODO(benvanik): #ifdef on LITTLE/BIG_ENDIAN and just memcpy.
-      switch (list->element_size) {
-        case 1:
-          out_value->i8 = *(int8_t*)element_ptr;
-          break;
-        case 2:
-          out_value->i16 = *(int16_t*)element_ptr;
-          break;
-        case 4:
-          out_value->i32 = *(int32_t*)element_ptr;
-          break;
-        case 8:
-          out_value->i64 = *(int64_t*)element_ptr;
-          break;
-      }
+      iree_vm_list_load_element(list->element_size, element_ptr, out_value);
       break;
     }
     case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
@@ -680,21 +717,7 @@ IREE_API_EXPORT iree_status_t iree_vm_list_get_value_as(
   switch (list->storage_mode) {
     case IREE_VM_LIST_STORAGE_MODE_VALUE: {
       value.type = iree_vm_type_def_as_value(list->element_type);
-      // TODO(benvanik): #ifdef on LITTLE/BIG_ENDIAN and just memcpy.
-      switch (list->element_size) {
-        case 1:
-          value.i8 = *(int8_t*)element_ptr;
-          break;
-        case 2:
-          value.i16 = *(int16_t*)element_ptr;
-          break;
-        case 4:
-          value.i32 = *(int32_t*)element_ptr;
-          break;
-        case 8:
-          value.i64 = *(int64_t*)element_ptr;
-          break;
-      }
+      iree_vm_list_load_element(list->element_size, element_ptr, &value);
       break;
     }
     case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
@@ -743,21 +766,8 @@ IREE_API_EXPORT iree_status_t iree_vm_list_set_value(
   uintptr_t element_ptr = (uintptr_t)list->storage + i * list->element_size;
   switch (list->storage_mode) {
     case IREE_VM_LIST_STORAGE_MODE_VALUE: {
-      // TODO(benvanik): #ifdef on LITTLE/BIG_ENDIAN and just memcpy.
-      switch (list->element_size) {
-        case 1:
-          *(int8_t*)element_ptr = converted_value.i8;
-          break;
-        case 2:
-          *(int16_t*)element_ptr = converted_value.i16;
-          break;
-        case 4:
-          *(int32_t*)element_ptr = converted_value.i32;
-          break;
-        case 8:
-          *(int64_t*)element_ptr = converted_value.i64;
-          break;
-      }
+      iree_vm_list_store_element(list->element_size, &converted_value,
+                                 element_ptr);
       break;
     }
     case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
@@ -784,6 +794,104 @@ iree_vm_list_push_value(iree_vm_list_t* list, const iree_vm_value_t* value) {
   return iree_vm_list_set_value(list, i, value);
 }
 
+// Returns true if |list| stores |value_type| elements as a dense array.
+static bool iree_vm_list_stores_value_type(const iree_vm_list_t* list,
+                                           iree_vm_value_type_t value_type) {
+  return list->storage_mode == IREE_VM_LIST_STORAGE_MODE_VALUE &&
+         iree_vm_type_def_as_value(list->element_type) == value_type;
+}
+
+// Verifies that [i, i + count) is within the current list size.
+static iree_status_t iree_vm_list_verify_range(const iree_vm_list_t* list,
+                                               iree_host_size_t i,
+                                               iree_host_size_t count) {
+  if (IREE_UNLIKELY(i > list->count || count > list->count - i)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "range [%" PRIhsz ", %" PRIhsz
+                            ") out of bounds (%" PRIhsz ")",
+                            i, i + count, list->count);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_get_values(
+    const iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_value_type_t value_type, void* out_values) {
+  IREE_ASSERT_ARGUMENT(list);
+  IREE_ASSERT_ARGUMENT(!count || out_values);
+  IREE_RETURN_IF_ERROR(iree_vm_list_verify_range(list, i, count));
+  if (!count) return iree_ok_status();
+  const iree_host_size_t value_size =
+      iree_vm_value_type_size(iree_vm_make_value_type_def(value_type));
+  if (IREE_UNLIKELY(!value_size)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid value type %d", (int)value_type);
+  }
+  if (iree_vm_list_stores_value_type(list, value_type)) {
+    // Fast path for the storage type matching the requested type.
+    memcpy(out_values,
+           (const uint8_t*)list->storage + i * list->element_size,
+           count * value_size);
+    return iree_ok_status();
+  }
+  // Slow path converting each element.
+  uint8_t* p = (uint8_t*)out_values;
+  for (iree_host_size_t j = 0; j < count; ++j, p += value_size) {
+    iree_vm_value_t value;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_value_as(list, i + j, value_type, &value));
+    iree_vm_list_store_element(value_size, &value, (uintptr_t)p);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_set_values(
+    iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_value_type_t value_type, const void* values) {
+  IREE_ASSERT_ARGUMENT(list);
+  IREE_ASSERT_ARGUMENT(!count || values);
+  IREE_RETURN_IF_ERROR(iree_vm_list_verify_range(list, i, count));
+  if (!count) return iree_ok_status();
+  const iree_host_size_t value_size =
+      iree_vm_value_type_size(iree_vm_make_value_type_def(value_type));
+  if (IREE_UNLIKELY(!value_size)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid value type %d", (int)value_type);
+  }
+  if (iree_vm_list_stores_value_type(list, value_type)) {
+    // Fast path for the storage type matching the provided type.
+    memcpy((uint8_t*)list->storage + i * list->element_size, values,
+           count * value_size);
+    return iree_ok_status();
+  }
+  // Slow path converting each element.
+  const uint8_t* p = (const uint8_t*)values;
+  for (iree_host_size_t j = 0; j < count; ++j, p += value_size) {
+    iree_vm_value_t value;
+    value.i64 = 0;
+    value.type = value_type;
+    iree_vm_list_load_element(value_size, (uintptr_t)p, &value);
+    IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, i + j, &value));
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_get_value_span(
+    iree_vm_list_t* list, iree_vm_value_type_t value_type,
+    iree_byte_span_t* out_span) {
+  IREE_ASSERT_ARGUMENT(list);
+  IREE_ASSERT_ARGUMENT(out_span);
+  *out_span = iree_byte_span_empty();
+  if (!iree_vm_list_stores_value_type(list, value_type)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "list does not store values of type %d",
+                            (int)value_type);
+  }
+  *out_span = iree_make_byte_span(list->storage,
+                                  list->count * list->element_size);
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT void* iree_vm_list_get_ref_deref(const iree_vm_list_t* list,
                                                  iree_host_size_t i,
                                                  iree_vm_ref_type_t type) {
@@ -157,6 +157,32 @@ IREE_API_EXPORT iree_status_t iree_vm_list_set_value(
 IREE_API_EXPORT iree_status_t
 iree_vm_list_push_value(iree_vm_list_t* list, const iree_vm_value_t* value);
 
+// Copies |count| values starting at element |i| into |out_values| as a dense
+// array of |value_type| elements. If the specified |value_type| differs from
+// the list storage type the values will be converted using the value type
+// semantics (such as sign/zero extend, etc). Lists storing |value_type|
+// directly are copied with a single memcpy.
+IREE_API_EXPORT iree_status_t iree_vm_list_get_values(
+    const iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_value_type_t value_type, void* out_values);
+
+// Sets |count| values starting at element |i| from |values|, a dense array of
+// |value_type| elements. The range must be within the current list size.
+// If the specified |value_type| differs from the list storage type the values
+// will be converted using the value type semantics (such as sign/zero extend,
+// etc). Lists storing |value_type| directly are copied with a single memcpy.
+IREE_API_EXPORT iree_status_t iree_vm_list_set_values(
+    iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_value_type_t value_type, const void* values);
+
+// Returns a view of the dense primitive storage of a list of |value_type|
+// elements in |out_span|. The view covers the current list size and is only
+// valid until the list is resized, reserved, or its storage is swapped.
+// Fails if the list does not store |value_type| elements directly.
+IREE_API_EXPORT iree_status_t iree_vm_list_get_value_span(
+    iree_vm_list_t* list, iree_vm_value_type_t value_type,
+    iree_byte_span_t* out_span);
+
 // Returns a dereferenced pointer to the given type if the element at the
 // given index |i| matches the |type|. Returns NULL on error.
 IREE_API_EXPORT void* iree_vm_list_get_ref_deref(const iree_vm_list_t* list,
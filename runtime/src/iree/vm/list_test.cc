@@ -1191,6 +1191,104 @@ TEST_F(VMListTest, CopyToVariants) {
 // TODO(benvanik): test ref get/set.
 
 // Tests pushing and popping ref objects.
+// Tests bulk get/set of values matching the list storage type.
+TEST_F(VMListTest, BulkValuesI64) {
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(
+      iree_vm_make_value_type_def(IREE_VM_VALUE_TYPE_I64),
+      /*initial_capacity=*/8, iree_allocator_system(), &list));
+  IREE_ASSERT_OK(iree_vm_list_resize(list, 5));
+
+  const int64_t values[4] = {-1, 2, 1ll << 40, 4};
+  IREE_ASSERT_OK(iree_vm_list_set_values(list, 1, 4, IREE_VM_VALUE_TYPE_I64,
+                                         values));
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    iree_vm_value_t value;
+    IREE_ASSERT_OK(iree_vm_list_get_value(list, i + 1, &value));
+    EXPECT_EQ(values[i], value.i64);
+  }
+
+  int64_t read_values[5] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values(list, 0, 5, IREE_VM_VALUE_TYPE_I64,
+                                         read_values));
+  EXPECT_EQ(0, read_values[0]);
+  EXPECT_EQ(0, std::memcmp(&read_values[1], values, sizeof(values)));
+
+  iree_byte_span_t span = iree_byte_span_empty();
+  IREE_ASSERT_OK(
+      iree_vm_list_get_value_span(list, IREE_VM_VALUE_TYPE_I64, &span));
+  EXPECT_EQ(5 * sizeof(int64_t), span.data_length);
+  EXPECT_EQ(values[2], ((const int64_t*)span.data)[3]);
+  EXPECT_THAT(
+      Status(iree_vm_list_get_value_span(list, IREE_VM_VALUE_TYPE_I32, &span)),
+      StatusIs(StatusCode::kFailedPrecondition));
+
+  EXPECT_THAT(Status(iree_vm_list_get_values(list, 2, 4, IREE_VM_VALUE_TYPE_I64,
+                                             read_values)),
+              StatusIs(StatusCode::kOutOfRange));
+  EXPECT_THAT(Status(iree_vm_list_set_values(list, 6, 0, IREE_VM_VALUE_TYPE_I64,
+                                             values)),
+              StatusIs(StatusCode::kOutOfRange));
+
+  iree_vm_list_release(list);
+}
+
+// Tests bulk get/set of values that require conversion.
+TEST_F(VMListTest, BulkValuesConvert) {
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(
+      iree_vm_make_value_type_def(IREE_VM_VALUE_TYPE_I64),
+      /*initial_capacity=*/8, iree_allocator_system(), &list));
+  IREE_ASSERT_OK(iree_vm_list_resize(list, 3));
+
+  const int32_t values[3] = {-5, 6, 7};
+  IREE_ASSERT_OK(iree_vm_list_set_values(list, 0, 3, IREE_VM_VALUE_TYPE_I32,
+                                         values));
+  int64_t wide_values[3] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values(list, 0, 3, IREE_VM_VALUE_TYPE_I64,
+                                         wide_values));
+  EXPECT_EQ(-5, wide_values[0]);
+  EXPECT_EQ(6, wide_values[1]);
+  EXPECT_EQ(7, wide_values[2]);
+  int16_t narrow_values[3] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values(list, 0, 3, IREE_VM_VALUE_TYPE_I16,
+                                         narrow_values));
+  EXPECT_EQ(-5, narrow_values[0]);
+  EXPECT_EQ(7, narrow_values[2]);
+
+  iree_vm_list_release(list);
+}
+
+// Tests bulk get/set of values in variant lists.
+TEST_F(VMListTest, BulkValuesVariant) {
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                     /*initial_capacity=*/8,
+                                     iree_allocator_system(), &list));
+  IREE_ASSERT_OK(iree_vm_list_resize(list, 2));
+
+  const float values[2] = {1.5f, -2.0f};
+  IREE_ASSERT_OK(iree_vm_list_set_values(list, 0, 2, IREE_VM_VALUE_TYPE_F32,
+                                         values));
+  iree_vm_value_t value;
+  IREE_ASSERT_OK(iree_vm_list_get_value(list, 1, &value));
+  EXPECT_EQ(IREE_VM_VALUE_TYPE_F32, value.type);
+  EXPECT_EQ(-2.0f, value.f32);
+
+  float read_values[2] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values(list, 0, 2, IREE_VM_VALUE_TYPE_F32,
+                                         read_values));
+  EXPECT_EQ(1.5f, read_values[0]);
+  EXPECT_EQ(-2.0f, read_values[1]);
+
+  iree_byte_span_t span = iree_byte_span_empty();
+  EXPECT_THAT(
+      Status(iree_vm_list_get_value_span(list, IREE_VM_VALUE_TYPE_F32, &span)),
+      StatusIs(StatusCode::kFailedPrecondition));
+
+  iree_vm_list_release(list);
+}
+
 TEST_F(VMListTest, PushPopRef) {
   iree_vm_type_def_t element_type = iree_vm_make_ref_type_def(test_a_type());
   iree_host_size_t initial_capacity = 4;
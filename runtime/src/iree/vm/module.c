@@ -367,6 +367,14 @@ IREE_API_EXPORT iree_string_view_t iree_vm_function_lookup_attr_by_name(
   return iree_string_view_empty();
 }
 
+IREE_API_EXPORT bool iree_vm_function_is_stateless(
+    const iree_vm_function_t* function) {
+  return iree_string_view_equal(
+      iree_vm_function_lookup_attr_by_name(function,
+                                           IREE_SV("iree.abi.stateless")),
+      IREE_SV("1"));
+}
+
 IREE_API_EXPORT iree_status_t
 iree_vm_function_get_attr(iree_vm_function_t function, iree_host_size_t index,
                           iree_string_pair_t* out_attr) {
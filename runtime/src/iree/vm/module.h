@@ -451,6 +451,18 @@ typedef struct iree_vm_module_t {
   // without first completing prior ones.
   iree_status_t(IREE_API_PTR* resume_call)(void* self, iree_vm_stack_t* stack,
                                            iree_byte_span_t call_results);
+
+  // Allocates module state data cloned from an existing |parent_state|.
+  // The new state must be usable without running any initializers or
+  // resolving imports again: imports resolved in the parent remain valid as
+  // the forked context shares the same modules. Immutable data may be shared
+  // with the parent by reference while mutable data must be copied.
+  // Optional; modules that do not support forking leave this NULL. Appended
+  // after the original interface to preserve the layout used by dynamic
+  // modules.
+  iree_status_t(IREE_API_PTR* fork_state)(
+      void* self, iree_vm_module_state_t* parent_state,
+      iree_allocator_t allocator, iree_vm_module_state_t** out_module_state);
 } iree_vm_module_t;
 
 // Initializes the interface of a module handle.
@@ -534,6 +546,21 @@ iree_vm_function_signature(const iree_vm_function_t* function);
 IREE_API_EXPORT iree_string_view_t iree_vm_function_lookup_attr_by_name(
     const iree_vm_function_t* function, iree_string_view_t key);
 
+// Returns true if the function has been marked as stateless by the compiler
+// with the `iree.abi.stateless` reflection attribute. Stateless functions never
+// mutate the state of the module they are defined in and may be invoked
+// concurrently with other stateless functions on the same context when the
+// context was created with IREE_VM_CONTEXT_FLAG_CONCURRENT.
+//
+// Stateless functions never store to globals, never load mutable ref globals,
+// and never write into or pass to calls the objects held in immutable ref
+// globals. Imports are assumed to be thread-safe but any state they hold is
+// owned by their own modules and not covered by this attribute.
+//
+// The result should be cached by callers as it requires a reflection lookup.
+IREE_API_EXPORT bool iree_vm_function_is_stateless(
+    const iree_vm_function_t* function);
+
 // Gets a reflection attribute for a function by index into the attribute list.
 // The returned key and value strings are guaranteed valid for the life
 // of the module. Note that not all functions have reflection attributes.
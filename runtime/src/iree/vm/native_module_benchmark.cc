@@ -13,6 +13,42 @@
 
 namespace {
 
-// TODO(benvanik): native module benchmarks.
+// Measures the cost of calling a fixed-signature native function through the
+// module begin_call ABI. This is the same path taken by bytecode imports and
+// includes stack frame management and ABI buffer indirection.
+IREE_BENCHMARK_FN(BM_NativeCallI32) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                        iree_allocator_system(), &instance));
+  iree_vm_module_t* module = NULL;
+  IREE_CHECK_OK(module_a_create(instance, iree_allocator_system(), &module));
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, IREE_VM_CONTEXT_FLAG_NONE, 1, &module,
+      iree_allocator_system(), &context));
+
+  iree_vm_function_t function;
+  IREE_CHECK_OK(iree_vm_context_resolve_function(
+      context, iree_make_cstring_view("module_a.add_1"), &function));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  iree_vm_context_state_resolver(context),
+                                  iree_allocator_system());
+  static const int batch = 100;
+  while (iree_benchmark_keep_running(benchmark_state, batch)) {
+    int32_t value = 0;
+    for (int i = 0; i < batch; ++i) {
+      IREE_CHECK_OK(call_import_i32_i32(stack, &function, value, &value));
+    }
+    iree_optimization_barrier(value);
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_context_release(context);
+  iree_vm_module_release(module);
+  iree_vm_instance_release(instance);
+  return iree_ok_status();
+}
+IREE_BENCHMARK_REGISTER(BM_NativeCallI32);
 
 }  // namespace
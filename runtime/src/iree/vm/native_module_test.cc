@@ -6,6 +6,7 @@
 
 #include "iree/vm/native_module_test.h"
 
+#include <utility>
 #include <vector>
 
 #include "iree/base/api.h"
@@ -94,7 +95,7 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
- private:
+ protected:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
 };
@@ -111,5 +112,86 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+TEST_F(VMNativeModuleTest, Stateless) {
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_a.add_1"), &function));
+  EXPECT_TRUE(iree_vm_function_is_stateless(&function));
+  // module_b.entry mutates per-context state.
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_b.entry"), &function));
+  EXPECT_FALSE(iree_vm_function_is_stateless(&function));
+}
+
+TEST_F(VMNativeModuleTest, InvokeWithStack) {
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, iree_make_cstring_view("module_b.entry"), &function));
+
+  // Stack and lists are allocated once and reused across invocations.
+  iree_vm_stack_t* stack = nullptr;
+  IREE_ASSERT_OK(iree_vm_stack_allocate(
+      IREE_VM_INVOCATION_FLAG_NONE, iree_vm_context_state_resolver(context_),
+      iree_allocator_system(), &stack));
+  vm::ref<iree_vm_list_t> input_list;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                     iree_allocator_system(), &input_list));
+  vm::ref<iree_vm_list_t> output_list;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                     iree_allocator_system(), &output_list));
+
+  // module_b.entry accumulates per-context state across calls.
+  const std::pair<int32_t, int32_t> cases[] = {{1, 1}, {2, 4}, {3, 8}};
+  for (auto [arg0, expected_ret0] : cases) {
+    iree_vm_list_clear(input_list.get());
+    auto arg0_value = iree_vm_value_make_i32(arg0);
+    IREE_ASSERT_OK(iree_vm_list_push_value(input_list.get(), &arg0_value));
+    IREE_ASSERT_OK(iree_vm_invoke_with_stack(stack, context_, function,
+                                             /*policy=*/nullptr,
+                                             input_list.get(),
+                                             output_list.get()));
+    ASSERT_EQ(iree_vm_list_size(output_list.get()), 1);
+    iree_vm_value_t ret0_value;
+    IREE_ASSERT_OK(iree_vm_list_get_value(output_list.get(), 0, &ret0_value));
+    EXPECT_EQ(ret0_value.i32, expected_ret0);
+    EXPECT_EQ(iree_vm_stack_current_frame(stack), nullptr);
+  }
+
+  iree_vm_stack_free(stack);
+}
+
+TEST_F(VMNativeModuleTest, ForkContext) {
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunFunction(iree_make_cstring_view("module_b.entry"), 1));
+  ASSERT_EQ(v0, 1);
+
+  // The fork starts with the accumulated state of the parent.
+  iree_vm_context_t* parent_context = context_;
+  iree_vm_context_t* forked_context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_fork(parent_context, iree_allocator_system(),
+                                      &forked_context));
+  EXPECT_NE(iree_vm_context_id(forked_context),
+            iree_vm_context_id(parent_context));
+  EXPECT_EQ(iree_vm_context_module_count(forked_context),
+            iree_vm_context_module_count(parent_context));
+  context_ = forked_context;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v1, RunFunction(iree_make_cstring_view("module_b.entry"), 2));
+  EXPECT_EQ(v1, 4);
+
+  // The parent is unaffected by calls made on the fork.
+  context_ = parent_context;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v2, RunFunction(iree_make_cstring_view("module_b.entry"), 5));
+  EXPECT_EQ(v2, 7);
+  context_ = forked_context;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v3, RunFunction(iree_make_cstring_view("module_b.entry"), 3));
+  EXPECT_EQ(v3, 8);
+
+  context_ = parent_context;
+  iree_vm_context_release(forked_context);
+}
+
 }  // namespace
 }  // namespace iree
@@ -95,9 +95,15 @@ static iree_status_t module_a_sub_1(iree_vm_stack_t* stack, module_a_t* module,
   return iree_ok_status();
 }
 
+// Neither function touches module state and both may be called concurrently.
+static const iree_string_pair_t module_a_stateless_attrs_[] = {
+    {IREE_SV("iree.abi.stateless"), IREE_SV("1")},
+};
 static const iree_vm_native_export_descriptor_t module_a_exports_[] = {
-    {IREE_SV("add_1"), IREE_SV("0i_i"), 0, NULL},
-    {IREE_SV("sub_1"), IREE_SV("0i_i"), 0, NULL},
+    {IREE_SV("add_1"), IREE_SV("0i_i"),
+     IREE_ARRAYSIZE(module_a_stateless_attrs_), module_a_stateless_attrs_},
+    {IREE_SV("sub_1"), IREE_SV("0i_i"),
+     IREE_ARRAYSIZE(module_a_stateless_attrs_), module_a_stateless_attrs_},
 };
 static const iree_vm_native_function_ptr_t module_a_funcs_[] = {
     {(iree_vm_native_function_shim_t)call_shim_i32_i32,
@@ -196,6 +202,22 @@ module_b_free_state(void* self, iree_vm_module_state_t* module_state) {
   iree_allocator_free(state->allocator, state);
 }
 
+// Clones per-context state from a parent context state, including the
+// resolved imports and user data.
+static iree_status_t IREE_API_PTR
+module_b_fork_state(void* self, iree_vm_module_state_t* parent_state,
+                    iree_allocator_t allocator,
+                    iree_vm_module_state_t** out_module_state) {
+  module_b_state_t* parent = (module_b_state_t*)parent_state;
+  module_b_state_t* state = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, sizeof(*state), (void**)&state));
+  memcpy(state, parent, sizeof(*state));
+  state->allocator = allocator;
+  *out_module_state = (iree_vm_module_state_t*)state;
+  return iree_ok_status();
+}
+
 // Called once per import function so the module can store the function ref.
 static iree_status_t IREE_API_PTR module_b_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
@@ -310,6 +332,7 @@ static iree_status_t module_b_create(iree_vm_instance_t* instance,
   interface.destroy = module_b_destroy;
   interface.alloc_state = module_b_alloc_state;
   interface.free_state = module_b_free_state;
+  interface.fork_state = module_b_fork_state;
   interface.resolve_import = module_b_resolve_import;
   return iree_vm_native_module_create(&interface, &module_b_descriptor_,
                                       instance, allocator, out_module);
@@ -39,6 +39,42 @@ static void iree_vm_ref_ptr_trace(const char* msg, void* ptr,
 #define iree_vm_ref_ptr_trace(...)
 #endif  // 0
 
+#if IREE_VM_REF_ATOMICS_DISABLE_UNSAFE
+
+// Relaxed loads and stores compile to ordinary memory operations without the
+// locked instructions or barriers of a read-modify-write.
+static inline void iree_vm_ref_counter_inc(
+    volatile iree_atomic_ref_count_t* counter) {
+  iree_atomic_ref_count_t* ptr = (iree_atomic_ref_count_t*)counter;
+  iree_atomic_store_int32(
+      ptr, iree_atomic_load_int32(ptr, iree_memory_order_relaxed) + 1,
+      iree_memory_order_relaxed);
+}
+
+// Decrements |counter| and returns its previous value.
+static inline int32_t iree_vm_ref_counter_dec(
+    volatile iree_atomic_ref_count_t* counter) {
+  iree_atomic_ref_count_t* ptr = (iree_atomic_ref_count_t*)counter;
+  int32_t previous = iree_atomic_load_int32(ptr, iree_memory_order_relaxed);
+  iree_atomic_store_int32(ptr, previous - 1, iree_memory_order_relaxed);
+  return previous;
+}
+
+#else
+
+static inline void iree_vm_ref_counter_inc(
+    volatile iree_atomic_ref_count_t* counter) {
+  iree_atomic_ref_count_inc(counter);
+}
+
+// Decrements |counter| and returns its previous value.
+static inline int32_t iree_vm_ref_counter_dec(
+    volatile iree_atomic_ref_count_t* counter) {
+  return iree_atomic_ref_count_dec(counter);
+}
+
+#endif  // IREE_VM_REF_ATOMICS_DISABLE_UNSAFE
+
 IREE_API_EXPORT iree_string_view_t
 iree_vm_ref_type_name(iree_vm_ref_type_t type) {
   IREE_VM_REF_ASSERT(type);
@@ -67,7 +103,7 @@ IREE_API_EXPORT void iree_vm_ref_object_retain(void* ptr,
   IREE_VM_REF_ASSERT(type);
   volatile iree_atomic_ref_count_t* counter =
       iree_vm_get_raw_counter_ptr(ptr, type);
-  iree_atomic_ref_count_inc(counter);
+  iree_vm_ref_counter_inc(counter);
   iree_vm_ref_ptr_trace("RETAIN", ptr, type);
 }
 
@@ -78,7 +114,7 @@ IREE_API_EXPORT void iree_vm_ref_object_release(void* ptr,
   iree_vm_ref_ptr_trace("RELEASE", ptr, type);
   volatile iree_atomic_ref_count_t* counter =
       iree_vm_get_raw_counter_ptr(ptr, type);
-  if (iree_atomic_ref_count_dec(counter) == 1) {
+  if (iree_vm_ref_counter_dec(counter) == 1) {
     const iree_vm_ref_type_descriptor_t* descriptor =
         iree_vm_ref_type_descriptor(type);
     if (descriptor->destroy) {
@@ -121,7 +157,7 @@ IREE_API_EXPORT iree_status_t iree_vm_ref_wrap_retain(void* ptr,
   if (out_ref->ptr) {
     volatile iree_atomic_ref_count_t* counter =
         iree_vm_get_ref_counter_ptr(out_ref);
-    iree_atomic_ref_count_inc(counter);
+    iree_vm_ref_counter_inc(counter);
     iree_vm_ref_trace("WRAP RETAIN", out_ref);
   }
   return iree_ok_status();
@@ -132,7 +168,7 @@ IREE_API_EXPORT void iree_vm_ref_retain_inplace(iree_vm_ref_t* ref) {
   if (ref->ptr) {
     volatile iree_atomic_ref_count_t* counter =
         iree_vm_get_ref_counter_ptr(ref);
-    iree_atomic_ref_count_inc(counter);
+    iree_vm_ref_counter_inc(counter);
     iree_vm_ref_trace("RETAIN", ref);
   }
 }
@@ -147,7 +183,7 @@ IREE_API_EXPORT void iree_vm_ref_retain(iree_vm_ref_t* ref,
   if (ref->ptr) {
     volatile iree_atomic_ref_count_t* counter =
         iree_vm_get_ref_counter_ptr(ref);
-    iree_atomic_ref_count_inc(counter);
+    iree_vm_ref_counter_inc(counter);
     iree_vm_ref_trace("RETAIN", ref);
   }
   if (out_ref->ptr) {
@@ -206,7 +242,7 @@ IREE_API_EXPORT void iree_vm_ref_release(iree_vm_ref_t* ref) {
 
   iree_vm_ref_trace("RELEASE", ref);
   volatile iree_atomic_ref_count_t* counter = iree_vm_get_ref_counter_ptr(ref);
-  if (iree_atomic_ref_count_dec(counter) == 1) {
+  if (iree_vm_ref_counter_dec(counter) == 1) {
     const iree_vm_ref_type_descriptor_t* descriptor =
         iree_vm_ref_type_descriptor(ref->type);
     if (descriptor->destroy) {
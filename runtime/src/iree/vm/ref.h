@@ -24,6 +24,22 @@ typedef struct iree_vm_instance_t iree_vm_instance_t;
 // Enable additional expensive checks to track down ref counting issues.
 // #define IREE_VM_REF_PARANOID
 
+// Adjusts the reference counts of objects retained and released through
+// iree_vm_ref_t (list accesses, register moves, call marshaling, etc) with
+// plain loads and stores instead of atomic read-modify-write operations.
+//
+// This is only safe when every object referenced through the VM is retained
+// and released from a single thread at a time. The counters are shared with the
+// native APIs of each type (such as iree_hal_buffer_retain) and any other
+// thread touching them concurrently - like an asynchronous HAL device releasing
+// resources on completion - will corrupt the counts. Intended for
+// single-threaded deployments (such as those using the local-sync HAL driver)
+// on cores where atomics are expensive. Always enabled when
+// IREE_SYNCHRONIZATION_DISABLE_UNSAFE is set.
+#if !defined(IREE_VM_REF_ATOMICS_DISABLE_UNSAFE)
+#define IREE_VM_REF_ATOMICS_DISABLE_UNSAFE IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#endif  // !IREE_VM_REF_ATOMICS_DISABLE_UNSAFE
+
 // Number of least significant bits available in an iree_vm_ref_type_t value.
 // These can be used for any purpose.
 #define IREE_VM_REF_TYPE_TAG_BITS 3
@@ -43,6 +43,7 @@ IREE_VM_ABI_DEFINE_SHIM(riii, r);
 IREE_VM_ABI_DEFINE_SHIM(riiI, r);
 IREE_VM_ABI_DEFINE_SHIM(riii, v);
 IREE_VM_ABI_DEFINE_SHIM(rIiiI, r);
+IREE_VM_ABI_DEFINE_SHIM(rIiiiI, r);
 IREE_VM_ABI_DEFINE_SHIM(riIiirII, r);
 IREE_VM_ABI_DEFINE_SHIM(rriirIIrIII, v);
 IREE_VM_ABI_DEFINE_SHIM(rrrrCrD, r);
@@ -54,6 +55,7 @@ IREE_VM_ABI_DEFINE_SHIM(rr, ii);
 IREE_VM_ABI_DEFINE_SHIM(rr, iI);
 IREE_VM_ABI_DEFINE_SHIM(rrr, iI);
 IREE_VM_ABI_DEFINE_SHIM(rrr, r);
+IREE_VM_ABI_DEFINE_SHIM(rCriiiiD, v);
 IREE_VM_ABI_DEFINE_SHIM(rrCrIID, v);
 IREE_VM_ABI_DEFINE_SHIM(rriCiD, v);
 IREE_VM_ABI_DEFINE_SHIM(rriiCID, v);
@@ -66,6 +68,7 @@ IREE_VM_ABI_DEFINE_SHIM(rrIrII, v);
 IREE_VM_ABI_DEFINE_SHIM(rrIii, v);
 IREE_VM_ABI_DEFINE_SHIM(rrrIii, v);
 IREE_VM_ABI_DEFINE_SHIM(rIrriiiI, r);
+IREE_VM_ABI_DEFINE_SHIM(rIrriiiiI, r);
 IREE_VM_ABI_DEFINE_SHIM(rIrrrIrIIi, v);
 IREE_VM_ABI_DEFINE_SHIM(rIrrrrrrr, v);
 IREE_VM_ABI_DEFINE_SHIM(rIrrrIiirrr, r);
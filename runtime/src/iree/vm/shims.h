@@ -336,6 +336,15 @@ IREE_VM_ABI_FIXED_STRUCT(rIiiI, {
   int64_t i4;
 });
 
+IREE_VM_ABI_FIXED_STRUCT(rIiiiI, {
+  iree_vm_ref_t r0;
+  int64_t i1;
+  int32_t i2;
+  int32_t i3;
+  int32_t i4;
+  int64_t i5;
+});
+
 IREE_VM_ABI_FIXED_STRUCT(riIiirII, {
   iree_vm_ref_t r0;
   int32_t i1;
@@ -424,6 +433,18 @@ IREE_VM_ABI_FIXED_STRUCT(rIrriiiI, {
   int64_t i7;
 });
 
+IREE_VM_ABI_FIXED_STRUCT(rIrriiiiI, {
+  iree_vm_ref_t r0;
+  int64_t i1;
+  iree_vm_ref_t r2;
+  iree_vm_ref_t r3;
+  int32_t i4;
+  int32_t i5;
+  int32_t i6;
+  int32_t i7;
+  int64_t i8;
+});
+
 IREE_VM_ABI_FIXED_STRUCT(rIrrrIrIIi, {
   iree_vm_ref_t r0;
   int64_t i1;
@@ -581,6 +602,12 @@ IREE_VM_ABI_VLA_STRUCT(rrCrIID, a2_count, a2, {
   iree_vm_abi_rII_t a2[0];
 });
 
+IREE_VM_ABI_VLA_STRUCT(rCriiiiD, a1_count, a1, {
+  iree_vm_ref_t r0;
+  iree_vm_size_t a1_count;
+  iree_vm_abi_riiii_t a1[0];
+});
+
 IREE_VM_ABI_VLA_STRUCT(rriCiirIID, a3_count, a3, {
   iree_vm_ref_t r0;
   iree_vm_ref_t r1;
@@ -650,6 +677,7 @@ IREE_VM_ABI_DECLARE_SHIM(riii, r);
 IREE_VM_ABI_DECLARE_SHIM(riiI, r);
 IREE_VM_ABI_DECLARE_SHIM(riii, v);
 IREE_VM_ABI_DECLARE_SHIM(rIiiI, r);
+IREE_VM_ABI_DECLARE_SHIM(rIiiiI, r);
 IREE_VM_ABI_DECLARE_SHIM(riIiirII, r);
 IREE_VM_ABI_DECLARE_SHIM(rriirIIrIII, v);
 IREE_VM_ABI_DECLARE_SHIM(rrrrCrD, r);
@@ -661,6 +689,7 @@ IREE_VM_ABI_DECLARE_SHIM(rr, ii);
 IREE_VM_ABI_DECLARE_SHIM(rr, iI);
 IREE_VM_ABI_DECLARE_SHIM(rrr, iI);
 IREE_VM_ABI_DECLARE_SHIM(rrr, r);
+IREE_VM_ABI_DECLARE_SHIM(rCriiiiD, v);
 IREE_VM_ABI_DECLARE_SHIM(rrCrIID, v);
 IREE_VM_ABI_DECLARE_SHIM(rriCiD, v);
 IREE_VM_ABI_DECLARE_SHIM(rriiCID, v);
@@ -673,6 +702,7 @@ IREE_VM_ABI_DECLARE_SHIM(rrIrII, v);
 IREE_VM_ABI_DECLARE_SHIM(rrIii, v);
 IREE_VM_ABI_DECLARE_SHIM(rrrIii, v);
 IREE_VM_ABI_DECLARE_SHIM(rIrriiiI, r);
+IREE_VM_ABI_DECLARE_SHIM(rIrriiiiI, r);
 IREE_VM_ABI_DECLARE_SHIM(rIrrrIrIIi, v);
 IREE_VM_ABI_DECLARE_SHIM(rIrrrrrrr, v);
 IREE_VM_ABI_DECLARE_SHIM(rIrrrIiirrr, r);
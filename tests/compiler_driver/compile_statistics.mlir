@@ -0,0 +1,19 @@
+// RUN: iree-compile --iree-hal-target-backends=vmvx --iree-compile-statistics %s -o /dev/null 2>&1 | FileCheck %s
+
+func.func @abs(%input : tensor<f32>) -> (tensor<f32>) {
+  %result = math.absf %input : tensor<f32>
+  return %result : tensor<f32>
+}
+
+// CHECK: ... Compile statistics ...
+// CHECK: Phases
+// CHECK-SAME: high-water mark
+// CHECK: Phase{{ +}}Wall Time{{ +}}Peak RSS{{ +}}Heap{{ +}}Constants
+// CHECK: input{{ +}}{{[0-9.]+}}s
+// CHECK: flow{{ +}}{{[0-9.]+}}s
+// CHECK: executable-targets{{ +}}{{[0-9.]+}}s
+// CHECK: hal{{ +}}{{[0-9.]+}}s
+// CHECK: vm{{ +}}{{[0-9.]+}}s
+// CHECK: Passes (wall time summed over all operations they ran on):
+// CHECK: Wall Time{{ +}}Count{{ +}}Pass
+// CHECK: iree-vmvx-select-lowering-strategy
@@ -24,6 +24,30 @@ func.func @dynamic_matmul() -> tensor<?x?xf32> {
   return %gemm : tensor<?x?xf32>
 }
 
+// Small odd sizes where the vector remainder dominates the runtime.
+func.func @dynamic_matmul_small_tails() -> tensor<?x?xf32> {
+  %A = flow.tensor.dynamic_constant dense<1.0> : tensor<37x29xf32> -> tensor<?x?xf32>
+  %B = flow.tensor.dynamic_constant dense<2.0> : tensor<29x23xf32> -> tensor<?x?xf32>
+  %C = flow.tensor.dynamic_constant dense<0.0> : tensor<37x23xf32> -> tensor<?x?xf32>
+
+  %gemm = linalg.matmul
+      ins(%A, %B : tensor<?x?xf32>, tensor<?x?xf32>)
+      outs(%C : tensor<?x?xf32>) -> tensor<?x?xf32>
+  return %gemm : tensor<?x?xf32>
+}
+
+// Attention-like batch matmul with a variable sequence length.
+func.func @dynamic_batch_matmul() -> tensor<?x?x?xf32> {
+  %A = flow.tensor.dynamic_constant dense<1.0> : tensor<8x77x64xf32> -> tensor<?x?x?xf32>
+  %B = flow.tensor.dynamic_constant dense<2.0> : tensor<8x64x77xf32> -> tensor<?x?x?xf32>
+  %C = flow.tensor.dynamic_constant dense<0.0> : tensor<8x77x77xf32> -> tensor<?x?x?xf32>
+
+  %bmm = linalg.batch_matmul
+      ins(%A, %B : tensor<?x?x?xf32>, tensor<?x?x?xf32>)
+      outs(%C : tensor<?x?x?xf32>) -> tensor<?x?x?xf32>
+  return %bmm : tensor<?x?x?xf32>
+}
+
 func.func @dynamic_elw() -> tensor<?x?xf32> {
   %c0 = arith.constant 0.000000e+00 : f32
   %A = flow.tensor.dynamic_constant dense<1.0> : tensor<513x1025xf32> -> tensor<?x?xf32>
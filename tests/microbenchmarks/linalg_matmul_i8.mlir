@@ -0,0 +1,21 @@
+//===----------------------------------------------------------------------===//
+// Linalg int8 matmul ops.
+// These cover the quantized paths (data tiling and i8 ukernels on CPU) that
+// are most sensitive to code generation changes.
+//===----------------------------------------------------------------------===//
+
+func.func @matmul_i8i8i32_384x384x512() -> tensor<384x512xi32> {
+    %lhs = util.unfoldable_constant dense<1> : tensor<384x384xi8>
+    %rhs = util.unfoldable_constant dense<1> : tensor<384x512xi8>
+    %dst = util.unfoldable_constant dense<0> : tensor<384x512xi32>
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<384x384xi8>, tensor<384x512xi8>) outs(%dst : tensor<384x512xi32>) -> tensor<384x512xi32>
+    return %0 : tensor<384x512xi32>
+}
+
+func.func @matmul_i8i8i32_1x2048x2048() -> tensor<1x2048xi32> {
+    %lhs = util.unfoldable_constant dense<1> : tensor<1x2048xi8>
+    %rhs = util.unfoldable_constant dense<1> : tensor<2048x2048xi8>
+    %dst = util.unfoldable_constant dense<0> : tensor<1x2048xi32>
+    %0 = linalg.matmul ins(%lhs, %rhs : tensor<1x2048xi8>, tensor<2048x2048xi8>) outs(%dst : tensor<1x2048xi32>) -> tensor<1x2048xi32>
+    return %0 : tensor<1x2048xi32>
+}
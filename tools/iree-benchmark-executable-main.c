@@ -12,6 +12,7 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/path.h"
 #include "iree/hal/api.h"
 #include "iree/modules/hal/types.h"
 #include "iree/testing/benchmark.h"
@@ -38,6 +39,30 @@ IREE_FLAG_LIST(
     "Each occurrence of the flag will run a benchmark with that set of\n"
     "workgroup count values.");
 
+IREE_FLAG(int64_t, flops, 0,
+          "Floating-point operations performed by one dispatch across its\n"
+          "whole workgroup grid. Enables the GFLOP/s counter and the compute\n"
+          "term of the roofline.");
+
+IREE_FLAG(string, sweep_file, "",
+          "Path to a sweep file listing multiple benchmarks to run.\n"
+          "Each benchmark is a block of `--flag=value` lines using the\n"
+          "per-benchmark flags of this tool (`--executable_file=`,\n"
+          "`--executable_format=`, `--entry_point=`, `--workgroup_count=`,\n"
+          "`--push_constant=`, `--executable_constant=`, `--binding=`,\n"
+          "`--flops=`) plus an optional `--name=`. Blocks are separated by\n"
+          "lines containing `---` and lines starting with `#` are ignored.\n"
+          "Relative executable paths are resolved against the directory of\n"
+          "the sweep file. The executable file, format, and entry point\n"
+          "default to the command line values when omitted from a block.");
+
+IREE_FLAG(double, peak_gflops, 0.0,
+          "Peak compute throughput of the device in GFLOP/s used to report\n"
+          "results as a fraction of the roofline.");
+IREE_FLAG(double, peak_gbps, 0.0,
+          "Peak memory bandwidth of the device in GB/s used to report\n"
+          "results as a fraction of the roofline.");
+
 // Total number of executable-level constants we (currently) allow; this is only
 // a limitation of how much memory we allocate and we could make this
 // dynamically growable.
@@ -50,9 +75,9 @@ IREE_FLAG_LIST(
 #define IREE_HAL_MAX_TOTAL_BINDING_COUNT \
   (IREE_HAL_MAX_DESCRIPTOR_SET_COUNT * 32)
 
-// Parsed dispatch parameters from flags.
+// Parsed dispatch parameters.
 // Used to construct the dispatch parameters for the benchmark invocation.
-struct {
+typedef struct iree_benchmark_executable_params_t {
   int32_t set_count;
   struct {
     // For now we only track the binding counts and assume they are all storage
@@ -75,7 +100,10 @@ struct {
   char binding_cconv[IREE_HAL_MAX_TOTAL_BINDING_COUNT];
   iree_hal_descriptor_set_layout_binding_t
       binding_layouts[IREE_HAL_MAX_TOTAL_BINDING_COUNT];
-} parsed_params = {
+} iree_benchmark_executable_params_t;
+
+// Dispatch parameters parsed from flags.
+static iree_benchmark_executable_params_t parsed_params = {
     .executable_constant_count = 0,
     .push_constant_count = 0,
     .binding_count = 0,
@@ -84,9 +112,13 @@ struct {
 static iree_status_t parse_executable_constant(iree_string_view_t flag_name,
                                                void* storage,
                                                iree_string_view_t value) {
-  IREE_ASSERT_LE(parsed_params.executable_constant_count + 1,
-                 IREE_ARRAYSIZE(parsed_params.executable_constants),
-                 "too many executable constants");
+  iree_benchmark_executable_params_t* params =
+      (iree_benchmark_executable_params_t*)storage;
+  if (params->executable_constant_count + 1 >
+      IREE_ARRAYSIZE(params->executable_constants)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "too many executable constants");
+  }
   uint32_t value_ui32 = 0;
   if (!iree_string_view_atoi_uint32(value, &value_ui32)) {
     return iree_make_status(
@@ -94,21 +126,23 @@ static iree_status_t parse_executable_constant(iree_string_view_t flag_name,
         "invalid executable constant value `%.*s`; expects uint32_t",
         (int)value.size, value.data);
   }
-  parsed_params.executable_constants[parsed_params.executable_constant_count++]
-      .ui32 = value_ui32;
+  params->executable_constants[params->executable_constant_count++].ui32 =
+      value_ui32;
   return iree_ok_status();
 }
 static void print_executable_constant(iree_string_view_t flag_name,
                                       void* storage, FILE* file) {
-  if (parsed_params.executable_constant_count == 0) {
+  iree_benchmark_executable_params_t* params =
+      (iree_benchmark_executable_params_t*)storage;
+  if (params->executable_constant_count == 0) {
     fprintf(file, "# --%.*s=[integer value]\n", (int)flag_name.size,
             flag_name.data);
     return;
   }
-  for (int32_t i = 0; i < parsed_params.executable_constant_count; ++i) {
+  for (int32_t i = 0; i < params->executable_constant_count; ++i) {
     fprintf(file, "--%.*s=%u", (int)flag_name.size, flag_name.data,
-            parsed_params.executable_constants[i].ui32);
-    if (i < parsed_params.executable_constant_count - 1) {
+            params->executable_constants[i].ui32);
+    if (i < params->executable_constant_count - 1) {
       fprintf(file, "\n");
     }
   }
@@ -120,9 +154,13 @@ IREE_FLAG_CALLBACK(parse_executable_constant, print_executable_constant,
 static iree_status_t parse_push_constant(iree_string_view_t flag_name,
                                          void* storage,
                                          iree_string_view_t value) {
-  IREE_ASSERT_LE(parsed_params.push_constant_count + 1,
-                 IREE_ARRAYSIZE(parsed_params.push_constants),
-                 "too many push constants");
+  iree_benchmark_executable_params_t* params =
+      (iree_benchmark_executable_params_t*)storage;
+  if (params->push_constant_count + 1 >
+      IREE_ARRAYSIZE(params->push_constants)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "too many push constants");
+  }
   uint32_t value_ui32 = 0;
   if (!iree_string_view_atoi_uint32(value, &value_ui32)) {
     return iree_make_status(
@@ -130,21 +168,22 @@ static iree_status_t parse_push_constant(iree_string_view_t flag_name,
         "invalid push constant value `%.*s`; expects uint32_t", (int)value.size,
         value.data);
   }
-  parsed_params.push_constants[parsed_params.push_constant_count++].ui32 =
-      value_ui32;
+  params->push_constants[params->push_constant_count++].ui32 = value_ui32;
   return iree_ok_status();
 }
 static void print_push_constant(iree_string_view_t flag_name, void* storage,
                                 FILE* file) {
-  if (parsed_params.push_constant_count == 0) {
+  iree_benchmark_executable_params_t* params =
+      (iree_benchmark_executable_params_t*)storage;
+  if (params->push_constant_count == 0) {
     fprintf(file, "# --%.*s=[integer value]\n", (int)flag_name.size,
             flag_name.data);
     return;
   }
-  for (int32_t i = 0; i < parsed_params.push_constant_count; ++i) {
+  for (int32_t i = 0; i < params->push_constant_count; ++i) {
     fprintf(file, "--%.*s=%u", (int)flag_name.size, flag_name.data,
-            parsed_params.push_constants[i].ui32);
-    if (i < parsed_params.push_constant_count - 1) {
+            params->push_constants[i].ui32);
+    if (i < params->push_constant_count - 1) {
       fprintf(file, "\n");
     }
   }
@@ -154,14 +193,17 @@ IREE_FLAG_CALLBACK(parse_push_constant, print_push_constant, &parsed_params,
 
 static iree_status_t parse_binding(iree_string_view_t flag_name, void* storage,
                                    iree_string_view_t value) {
-  IREE_ASSERT_LE(parsed_params.binding_count + 1,
-                 IREE_ARRAYSIZE(parsed_params.binding_specs),
-                 "too many bindings");
-  int32_t i = parsed_params.binding_count++;
-  parsed_params.binding_specs[i] = value;
-  parsed_params.binding_cconv[i] = 'r';
+  iree_benchmark_executable_params_t* params =
+      (iree_benchmark_executable_params_t*)storage;
+  if (params->binding_count + 1 > IREE_ARRAYSIZE(params->binding_specs)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "too many bindings");
+  }
+  int32_t i = params->binding_count++;
+  params->binding_specs[i] = value;
+  params->binding_cconv[i] = 'r';
   // TODO(benvanik): allow for a specification of type/immutability.
-  parsed_params.binding_layouts[i] = (iree_hal_descriptor_set_layout_binding_t){
+  params->binding_layouts[i] = (iree_hal_descriptor_set_layout_binding_t){
       .binding = (uint32_t)i,
       .type = IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
       .flags = IREE_HAL_DESCRIPTOR_FLAG_NONE,
@@ -170,13 +212,15 @@ static iree_status_t parse_binding(iree_string_view_t flag_name, void* storage,
 }
 static void print_binding(iree_string_view_t flag_name, void* storage,
                           FILE* file) {
-  if (parsed_params.binding_count == 0) {
+  iree_benchmark_executable_params_t* params =
+      (iree_benchmark_executable_params_t*)storage;
+  if (params->binding_count == 0) {
     fprintf(file, "# --%.*s=\"shapextype[=values]\"\n", (int)flag_name.size,
             flag_name.data);
     return;
   }
-  for (int32_t i = 0; i < parsed_params.binding_count; ++i) {
-    const iree_string_view_t binding_spec = parsed_params.binding_specs[i];
+  for (int32_t i = 0; i < params->binding_count; ++i) {
+    const iree_string_view_t binding_spec = params->binding_specs[i];
     fprintf(file, "--%.*s=\"%.*s\"\n", (int)flag_name.size, flag_name.data,
             (int)binding_spec.size, binding_spec.data);
   }
@@ -202,14 +246,77 @@ IREE_FLAG_CALLBACK(
     "  --binding=2x2xf32=@file.ext\n"
     "  --binding=4xf32=+file.ext");
 
-typedef struct iree_benchmark_executable_args_t {
+// Maximum number of workgroup counts benchmarked per executable export.
+#define IREE_BENCHMARK_EXECUTABLE_MAX_WORKGROUP_COUNTS 64
+
+// One executable export to benchmark and the parameters it is dispatched
+// with, parsed either from the command line flags or a sweep file block.
+typedef struct iree_benchmark_executable_spec_t {
+  // Optional name used to prefix the benchmark names.
+  iree_string_view_t name;
+  iree_string_view_t executable_format;
+  iree_string_view_t executable_file;
+  // Storage for |executable_file| when resolved relative to the sweep file.
+  char* executable_file_storage;
+  int32_t entry_point;
+  // Floating-point operations performed per dispatch or 0 if unknown.
+  int64_t flops;
+  iree_host_size_t workgroup_count_count;
+  iree_string_view_t
+      workgroup_counts[IREE_BENCHMARK_EXECUTABLE_MAX_WORKGROUP_COUNTS];
+  iree_benchmark_executable_params_t params;
+} iree_benchmark_executable_spec_t;
+
+// Resources of a spec loaded on a particular device.
+typedef struct iree_benchmark_executable_instance_t {
+  const iree_benchmark_executable_spec_t* spec;
   iree_hal_device_t* device;
-  iree_hal_executable_t* executable;
+  iree_file_contents_t* file_contents;
+  iree_vm_list_t* binding_list;
+  iree_hal_descriptor_set_layout_t* descriptor_set_layout;
   iree_hal_pipeline_layout_t* pipeline_layout;
-  const iree_hal_descriptor_set_binding_t* bindings;
+  iree_hal_executable_t* executable;
+  iree_hal_descriptor_set_binding_t bindings[IREE_HAL_MAX_TOTAL_BINDING_COUNT];
+  // Total size of all bindings in bytes.
+  iree_device_size_t binding_bytes;
+} iree_benchmark_executable_instance_t;
+
+typedef struct iree_benchmark_executable_args_t {
+  const iree_benchmark_executable_instance_t* instance;
   uint32_t workgroup_count[3];
 } iree_benchmark_executable_args_t;
 
+// Reports the achieved throughput of |dispatch_count| dispatches that took
+// |duration_ns| of device time. With --peak_gflops/--peak_gbps the result is
+// also reported as the fraction of the roofline bound achieved.
+static void iree_benchmark_executable_report_roofline(
+    const iree_benchmark_executable_instance_t* instance,
+    int64_t dispatch_count, iree_time_t duration_ns,
+    iree_benchmark_state_t* benchmark_state) {
+  const double total_flops = (double)instance->spec->flops * dispatch_count;
+  const double total_bytes = (double)instance->binding_bytes * dispatch_count;
+  iree_benchmark_set_bytes_processed(benchmark_state, (int64_t)total_bytes);
+  if (duration_ns <= 0) return;
+  if (total_flops > 0) {
+    iree_benchmark_set_counter(benchmark_state, "GFLOP/s",
+                               total_flops / duration_ns);
+  }
+
+  // The roofline bound is the minimum time the dispatches could have taken
+  // given whichever of the compute or memory peaks is the bottleneck.
+  double bound_ns = 0.0;
+  if (FLAG_peak_gflops > 0 && total_flops > 0) {
+    bound_ns = iree_max(bound_ns, total_flops / FLAG_peak_gflops);
+  }
+  if (FLAG_peak_gbps > 0) {
+    bound_ns = iree_max(bound_ns, total_bytes / FLAG_peak_gbps);
+  }
+  if (bound_ns > 0) {
+    iree_benchmark_set_counter(benchmark_state, "roofline",
+                               bound_ns / duration_ns);
+  }
+}
+
 // NOTE: error handling is here just for better diagnostics: it is not tracking
 // allocations correctly and will leak. Don't use this as an example for how to
 // write robust code.
@@ -218,11 +325,14 @@ static iree_status_t iree_benchmark_executable_run(
     iree_benchmark_state_t* benchmark_state) {
   iree_benchmark_executable_args_t* args =
       (iree_benchmark_executable_args_t*)benchmark_def->user_data;
+  const iree_benchmark_executable_instance_t* instance = args->instance;
+  const iree_benchmark_executable_params_t* params = &instance->spec->params;
+  iree_hal_device_t* device = instance->device;
 
   iree_hal_semaphore_t* fence_semaphore = NULL;
   uint64_t fence_value = 0ull;
   IREE_RETURN_IF_ERROR(
-      iree_hal_semaphore_create(args->device, fence_value, &fence_semaphore));
+      iree_hal_semaphore_create(device, fence_value, &fence_semaphore));
   iree_hal_semaphore_list_t wait_semaphore_list =
       iree_hal_semaphore_list_empty();
   iree_hal_semaphore_list_t signal_semaphore_list = {
@@ -233,7 +343,7 @@ static iree_status_t iree_benchmark_executable_run(
 
   // Start profiling now - all subsequent device operations will be what the
   // user wants to measure.
-  IREE_RETURN_IF_ERROR(iree_hal_begin_profiling_from_flags(args->device));
+  IREE_RETURN_IF_ERROR(iree_hal_begin_profiling_from_flags(device));
 
   // Submit the command buffer and wait for it to complete.
   // Note that each iteration runs through the whole grid as it's important that
@@ -242,6 +352,7 @@ static iree_status_t iree_benchmark_executable_run(
   // not testing cache effects. This means we need to account for the total
   // number of workgroups executed.
   int64_t dispatch_count = 0;
+  iree_time_t submission_duration_ns = 0;
   while (iree_benchmark_keep_running(benchmark_state, FLAG_batch_size)) {
     // TODO(benvanik): record a secondary command buffer and just replay it
     // here. This should fix the overhead at just primary command buffer
@@ -249,6 +360,7 @@ static iree_status_t iree_benchmark_executable_run(
     // some only support inline execution so we are conservatively doing that.
     // In the future we should have an option (possibly based on device query)
     // as to which path to use.
+    iree_time_t submission_start_ns = iree_time_now();
 
     // Record a command buffer with the dispatches.
     // Note that today we are doing this inside of the benchmark loop so that
@@ -259,23 +371,22 @@ static iree_status_t iree_benchmark_executable_run(
     // reusable and one-shot.
     iree_hal_command_buffer_t* command_buffer = NULL;
     IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
-        args->device,
+        device,
         IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
             IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
         IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
         /*binding_capacity=*/0, &command_buffer));
     IREE_RETURN_IF_ERROR(iree_hal_command_buffer_begin(command_buffer));
     IREE_RETURN_IF_ERROR(iree_hal_command_buffer_push_constants(
-        command_buffer, args->pipeline_layout, /*offset=*/0,
-        &parsed_params.push_constants[0].ui32,
-        parsed_params.push_constant_count *
-            sizeof(parsed_params.push_constants[0])));
+        command_buffer, instance->pipeline_layout, /*offset=*/0,
+        &params->push_constants[0].ui32,
+        params->push_constant_count * sizeof(params->push_constants[0])));
     IREE_RETURN_IF_ERROR(iree_hal_command_buffer_push_descriptor_set(
-        command_buffer, args->pipeline_layout, /*set=*/0,
-        parsed_params.binding_count, args->bindings));
+        command_buffer, instance->pipeline_layout, /*set=*/0,
+        params->binding_count, instance->bindings));
     for (int32_t i = 0; i < FLAG_batch_size; ++i) {
       IREE_RETURN_IF_ERROR(iree_hal_command_buffer_dispatch(
-          command_buffer, args->executable, FLAG_entry_point,
+          command_buffer, instance->executable, instance->spec->entry_point,
           args->workgroup_count[0], args->workgroup_count[1],
           args->workgroup_count[2]));
       IREE_RETURN_IF_ERROR(iree_hal_command_buffer_execution_barrier(
@@ -289,14 +400,15 @@ static iree_status_t iree_benchmark_executable_run(
     // we were recording then this will kick off the execution.
     ++fence_value;
     IREE_RETURN_IF_ERROR(iree_hal_device_queue_execute(
-        args->device, IREE_HAL_QUEUE_AFFINITY_ANY, wait_semaphore_list,
-        signal_semaphore_list, 1, &command_buffer));
+        device, IREE_HAL_QUEUE_AFFINITY_ANY, wait_semaphore_list,
+        signal_semaphore_list, 1, &command_buffer, /*binding_tables=*/NULL));
 
     // Block and wait for the submission to complete.
     // Note that this will include round-trip overhead and if the dispatch or
     // batch size is small then the final time may end up being mostly overhead.
     IREE_RETURN_IF_ERROR(iree_hal_semaphore_wait(fence_semaphore, fence_value,
                                                  iree_infinite_timeout()));
+    submission_duration_ns += iree_time_now() - submission_start_ns;
 
     iree_benchmark_pause_timing(benchmark_state);
 
@@ -308,13 +420,13 @@ static iree_status_t iree_benchmark_executable_run(
 
     // Flush profiling if recording. Note that we don't want to include the
     // profiling time in the benchmark result.
-    IREE_RETURN_IF_ERROR(iree_hal_device_profiling_flush(args->device));
+    IREE_RETURN_IF_ERROR(iree_hal_device_profiling_flush(device));
 
     iree_benchmark_resume_timing(benchmark_state);
   }
 
   // End profiling before cleaning up so tooling doesn't capture it.
-  IREE_RETURN_IF_ERROR(iree_hal_end_profiling_from_flags(args->device));
+  IREE_RETURN_IF_ERROR(iree_hal_end_profiling_from_flags(device));
 
   // To get a total time per invocation we set the item count to the total
   // invocations dispatched. That gives us both total dispatch and single
@@ -323,6 +435,9 @@ static iree_status_t iree_benchmark_executable_run(
                               args->workgroup_count[1] *
                               args->workgroup_count[2];
   iree_benchmark_set_items_processed(benchmark_state, total_invocations);
+  iree_benchmark_executable_report_roofline(instance, dispatch_count,
+                                            submission_duration_ns,
+                                            benchmark_state);
 
   iree_hal_semaphore_release(fence_semaphore);
 
@@ -349,31 +464,174 @@ static iree_status_t iree_parse_workgroup_count(
   return iree_ok_status();
 }
 
-// Runs one benchmark per workgroup count specified using the same device
-// and input/output buffers.
-static iree_status_t iree_benchmark_executable_from_flags(
-    iree_allocator_t host_allocator) {
-  iree_vm_instance_t* instance = NULL;
-  IREE_RETURN_IF_ERROR(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
-                                               host_allocator, &instance));
-  IREE_RETURN_IF_ERROR(iree_hal_module_register_inline_types(instance));
+static iree_status_t iree_benchmark_executable_spec_append_workgroup_count(
+    iree_benchmark_executable_spec_t* spec, iree_string_view_t value) {
+  if (spec->workgroup_count_count + 1 >
+      IREE_ARRAYSIZE(spec->workgroup_counts)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "too many workgroup counts");
+  }
+  spec->workgroup_counts[spec->workgroup_count_count++] = value;
+  return iree_ok_status();
+}
 
-  // Create the HAL device we'll be using during execution.
-  // Devices can be very expensive to create and we want to avoid doing it
-  // multiple times throughout the benchmark execution.
-  iree_hal_device_t* device = NULL;
-  IREE_RETURN_IF_ERROR(iree_hal_create_device_from_flags(
-      iree_hal_available_driver_registry(), iree_hal_default_device_uri(),
-      host_allocator, &device));
+// Initializes |out_spec| from the command line flags.
+static iree_status_t iree_benchmark_executable_spec_initialize_from_flags(
+    iree_benchmark_executable_spec_t* out_spec) {
+  memset(out_spec, 0, sizeof(*out_spec));
+  out_spec->executable_format = iree_make_cstring_view(FLAG_executable_format);
+  out_spec->executable_file = iree_make_cstring_view(FLAG_executable_file);
+  out_spec->entry_point = FLAG_entry_point;
+  out_spec->flops = FLAG_flops;
+  for (iree_host_size_t i = 0; i < FLAG_workgroup_count_list().count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_benchmark_executable_spec_append_workgroup_count(
+        out_spec, FLAG_workgroup_count_list().values[i]));
+  }
+  out_spec->params = parsed_params;
+  return iree_ok_status();
+}
+
+// Initializes the sweep file block defaults from the command line flags.
+// Dispatch parameters are never inherited as they are specific to each export.
+static void iree_benchmark_executable_spec_initialize_sweep_defaults(
+    iree_benchmark_executable_spec_t* out_spec) {
+  memset(out_spec, 0, sizeof(*out_spec));
+  out_spec->executable_format = iree_make_cstring_view(FLAG_executable_format);
+  out_spec->executable_file = iree_make_cstring_view(FLAG_executable_file);
+  out_spec->entry_point = FLAG_entry_point;
+}
+
+// Parses a single `--name=value` line of a sweep file block into |spec|.
+// Executable paths are resolved relative to |base_path|.
+static iree_status_t iree_benchmark_executable_spec_parse_flag(
+    iree_string_view_t line, iree_string_view_t base_path,
+    iree_allocator_t host_allocator, iree_benchmark_executable_spec_t* spec) {
+  if (!iree_string_view_consume_prefix(&line, IREE_SV("--"))) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "expected `--flag=value` but got `%.*s`",
+                            (int)line.size, line.data);
+  }
+  iree_string_view_t name, value;
+  iree_string_view_split(line, '=', &name, &value);
+  if (iree_string_view_equal(name, IREE_SV("name"))) {
+    spec->name = value;
+  } else if (iree_string_view_equal(name, IREE_SV("executable_format"))) {
+    spec->executable_format = value;
+  } else if (iree_string_view_equal(name, IREE_SV("executable_file"))) {
+    iree_allocator_free(host_allocator, spec->executable_file_storage);
+    spec->executable_file_storage = NULL;
+    spec->executable_file = value;
+    if (!iree_string_view_starts_with(value, IREE_SV("/")) &&
+        !iree_string_view_is_empty(base_path)) {
+      IREE_RETURN_IF_ERROR(iree_file_path_join(base_path, value,
+                                               host_allocator,
+                                               &spec->executable_file_storage));
+      spec->executable_file =
+          iree_make_cstring_view(spec->executable_file_storage);
+    }
+  } else if (iree_string_view_equal(name, IREE_SV("entry_point"))) {
+    if (!iree_string_view_atoi_int32(value, &spec->entry_point)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid entry point `%.*s`", (int)value.size,
+                              value.data);
+    }
+  } else if (iree_string_view_equal(name, IREE_SV("flops"))) {
+    if (!iree_string_view_atoi_int64(value, &spec->flops)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid flop count `%.*s`", (int)value.size,
+                              value.data);
+    }
+  } else if (iree_string_view_equal(name, IREE_SV("workgroup_count"))) {
+    IREE_RETURN_IF_ERROR(
+        iree_benchmark_executable_spec_append_workgroup_count(spec, value));
+  } else if (iree_string_view_equal(name, IREE_SV("push_constant"))) {
+    IREE_RETURN_IF_ERROR(parse_push_constant(name, &spec->params, value));
+  } else if (iree_string_view_equal(name, IREE_SV("executable_constant"))) {
+    IREE_RETURN_IF_ERROR(parse_executable_constant(name, &spec->params, value));
+  } else if (iree_string_view_equal(name, IREE_SV("binding"))) {
+    IREE_RETURN_IF_ERROR(parse_binding(name, &spec->params, value));
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported sweep file flag `--%.*s`",
+                            (int)name.size, name.data);
+  }
+  return iree_ok_status();
+}
+
+// Parses the sweep file |contents| into a list of specs.
+// Spec string views reference |contents| which must remain valid for the
+// lifetime of the specs.
+static iree_status_t iree_benchmark_executable_parse_sweep_file(
+    iree_string_view_t contents, iree_string_view_t base_path,
+    iree_allocator_t host_allocator, iree_host_size_t* out_spec_count,
+    iree_benchmark_executable_spec_t** out_specs) {
+  *out_spec_count = 0;
+  *out_specs = NULL;
+
+  // Count the blocks so we can allocate all specs at once. Empty blocks are
+  // trimmed below.
+  iree_host_size_t spec_capacity = 1;
+  iree_string_view_t remaining = contents;
+  while (!iree_string_view_is_empty(remaining)) {
+    iree_string_view_t line;
+    iree_string_view_split(remaining, '\n', &line, &remaining);
+    if (iree_string_view_equal(iree_string_view_trim(line), IREE_SV("---"))) {
+      ++spec_capacity;
+    }
+  }
+  iree_benchmark_executable_spec_t* specs = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, spec_capacity * sizeof(*specs), (void**)&specs));
+
+  iree_host_size_t spec_count = 0;
+  bool spec_has_flags = false;
+  iree_benchmark_executable_spec_initialize_sweep_defaults(&specs[0]);
+  iree_status_t status = iree_ok_status();
+  remaining = contents;
+  while (iree_status_is_ok(status) && !iree_string_view_is_empty(remaining)) {
+    iree_string_view_t line;
+    iree_string_view_split(remaining, '\n', &line, &remaining);
+    line = iree_string_view_trim(line);
+    if (iree_string_view_is_empty(line) ||
+        iree_string_view_starts_with(line, IREE_SV("#"))) {
+      continue;
+    } else if (iree_string_view_equal(line, IREE_SV("---"))) {
+      if (spec_has_flags) {
+        ++spec_count;
+        iree_benchmark_executable_spec_initialize_sweep_defaults(
+            &specs[spec_count]);
+        spec_has_flags = false;
+      }
+      continue;
+    }
+    status = iree_benchmark_executable_spec_parse_flag(
+        line, base_path, host_allocator, &specs[spec_count]);
+    spec_has_flags = true;
+  }
+  if (spec_has_flags) ++spec_count;
 
-  // We'll reuse the same executable cache so that once we load the executable
-  // we'll be able to reuse any driver-side optimizations.
-  iree_hal_executable_cache_t* executable_cache = NULL;
-  iree_status_t loop_status = iree_ok_status();
-  IREE_RETURN_IF_ERROR(iree_hal_executable_cache_create(
-      device, iree_make_cstring_view("cache"), iree_loop_inline(&loop_status),
-      &executable_cache));
-  IREE_RETURN_IF_ERROR(loop_status);
+  if (!iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i <= spec_count && i < spec_capacity; ++i) {
+      iree_allocator_free(host_allocator, specs[i].executable_file_storage);
+    }
+    iree_allocator_free(host_allocator, specs);
+    return status;
+  }
+  *out_spec_count = spec_count;
+  *out_specs = specs;
+  return iree_ok_status();
+}
+
+// Loads the executable of |spec| on |device| and allocates its bindings.
+static iree_status_t iree_benchmark_executable_instance_initialize(
+    const iree_benchmark_executable_spec_t* spec, iree_hal_device_t* device,
+    iree_hal_executable_cache_t* executable_cache,
+    iree_allocator_t host_allocator,
+    iree_benchmark_executable_instance_t* out_instance) {
+  memset(out_instance, 0, sizeof(*out_instance));
+  out_instance->spec = spec;
+  out_instance->device = device;
+  const iree_benchmark_executable_params_t* params = &spec->params;
 
   // Allocate storage for buffers and populate them.
   // They only need to remain valid for the duration of the invocation and all
@@ -381,17 +639,14 @@ static iree_status_t iree_benchmark_executable_from_flags(
   // Note that we do this parsing first so that we can reflect on the I/O to
   // infer the pipeline layout.
   iree_hal_allocator_t* device_allocator = iree_hal_device_allocator(device);
-  iree_vm_list_t* binding_list = NULL;
   IREE_RETURN_IF_ERROR(iree_tooling_parse_variants(
-      iree_make_string_view(parsed_params.binding_cconv,
-                            parsed_params.binding_count),
-      (iree_string_view_list_t){parsed_params.binding_count,
-                                parsed_params.binding_specs},
-      device, device_allocator, host_allocator, &binding_list));
-  iree_hal_descriptor_set_binding_t bindings[IREE_HAL_MAX_TOTAL_BINDING_COUNT];
-  for (iree_host_size_t i = 0; i < parsed_params.binding_count; ++i) {
+      iree_make_string_view(params->binding_cconv, params->binding_count),
+      (iree_string_view_list_t){params->binding_count, params->binding_specs},
+      device, device_allocator, host_allocator, &out_instance->binding_list));
+  for (iree_host_size_t i = 0; i < params->binding_count; ++i) {
     iree_vm_ref_t value = iree_vm_ref_null();
-    IREE_RETURN_IF_ERROR(iree_vm_list_get_ref_assign(binding_list, i, &value));
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_ref_assign(out_instance->binding_list, i, &value));
     iree_hal_buffer_t* buffer = NULL;
     if (iree_hal_buffer_isa(value)) {
       buffer = iree_hal_buffer_deref(value);
@@ -404,13 +659,14 @@ static iree_status_t iree_benchmark_executable_from_flags(
           " is not",
           i);
     }
-    bindings[i] = (iree_hal_descriptor_set_binding_t){
+    out_instance->bindings[i] = (iree_hal_descriptor_set_binding_t){
         .binding = i,
         .buffer_slot = 0,
         .buffer = buffer,
         .offset = 0,
         .length = IREE_WHOLE_BUFFER,
     };
+    out_instance->binding_bytes += iree_hal_buffer_byte_length(buffer);
   }
 
   // Setup the specification used to perform the executable load.
@@ -426,58 +682,69 @@ static iree_status_t iree_benchmark_executable_from_flags(
   // Load the executable data into memory.
   // In normal usage this would be mapped from the containing module file (which
   // itself may be mapped from disk).
-  iree_file_contents_t* file_contents = NULL;
-  if (strcmp(FLAG_executable_file, "-") == 0) {
-    IREE_RETURN_IF_ERROR(
-        iree_stdin_read_contents(host_allocator, &file_contents));
+  if (iree_string_view_equal(spec->executable_file, IREE_SV("-"))) {
+    IREE_RETURN_IF_ERROR(iree_stdin_read_contents(
+        host_allocator, &out_instance->file_contents));
   } else {
-    IREE_RETURN_IF_ERROR(iree_file_read_contents(
-        FLAG_executable_file, IREE_FILE_READ_FLAG_DEFAULT, host_allocator,
-        &file_contents));
+    char* executable_path = NULL;
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator,
+                                               spec->executable_file.size + 1,
+                                               (void**)&executable_path));
+    iree_string_view_to_cstring(spec->executable_file, executable_path,
+                                spec->executable_file.size + 1);
+    iree_status_t status = iree_file_read_contents(
+        executable_path, IREE_FILE_READ_FLAG_DEFAULT, host_allocator,
+        &out_instance->file_contents);
+    iree_allocator_free(host_allocator, executable_path);
+    IREE_RETURN_IF_ERROR(status);
   }
-  executable_params.executable_format =
-      iree_make_cstring_view(FLAG_executable_format);
-  executable_params.executable_data = file_contents->const_buffer;
+  executable_params.executable_format = spec->executable_format;
+  executable_params.executable_data = out_instance->file_contents->const_buffer;
 
   // Setup the layouts defining how each entry point is interpreted.
-  iree_hal_pipeline_layout_t* pipeline_layout = NULL;
-  iree_hal_descriptor_set_layout_t* descriptor_set_layout = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_descriptor_set_layout_create(
-      device, IREE_HAL_DESCRIPTOR_SET_LAYOUT_FLAG_NONE,
-      parsed_params.binding_count, parsed_params.binding_layouts,
-      &descriptor_set_layout));
+      device, IREE_HAL_DESCRIPTOR_SET_LAYOUT_FLAG_NONE, params->binding_count,
+      params->binding_layouts, &out_instance->descriptor_set_layout));
   IREE_RETURN_IF_ERROR(iree_hal_pipeline_layout_create(
-      device, parsed_params.push_constant_count,
-      /*set_layout_count=*/1, &descriptor_set_layout, &pipeline_layout));
+      device, params->push_constant_count,
+      /*set_layout_count=*/1, &out_instance->descriptor_set_layout,
+      &out_instance->pipeline_layout));
   executable_params.pipeline_layout_count = 1;
-  executable_params.pipeline_layouts = &pipeline_layout;
+  executable_params.pipeline_layouts = &out_instance->pipeline_layout;
 
   // Executable-level constants allow us to perform some basic load-time value
   // propagation - usually dependent on device features or tuning parameters.
-  executable_params.constant_count = parsed_params.executable_constant_count;
-  executable_params.constants = &parsed_params.executable_constants[0].ui32;
+  executable_params.constant_count = params->executable_constant_count;
+  executable_params.constants = &params->executable_constants[0].ui32;
 
   // Perform the load, which will fail if the executable cannot be loaded or
   // there was an issue with the layouts.
-  iree_hal_executable_t* executable = NULL;
-  IREE_RETURN_IF_ERROR(iree_hal_executable_cache_prepare_executable(
-      executable_cache, &executable_params, &executable));
+  return iree_hal_executable_cache_prepare_executable(
+      executable_cache, &executable_params, &out_instance->executable);
+}
 
-  // Register one benchmark per workgroup count specified.
-  iree_benchmark_executable_args_t* args = NULL;
-  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      host_allocator, sizeof(*args) * FLAG_workgroup_count_list().count,
-      (void**)&args));
-  for (iree_host_size_t i = 0; i < FLAG_workgroup_count_list().count; ++i) {
+static void iree_benchmark_executable_instance_deinitialize(
+    iree_benchmark_executable_instance_t* instance) {
+  iree_vm_list_release(instance->binding_list);
+  iree_hal_executable_release(instance->executable);
+  iree_hal_descriptor_set_layout_release(instance->descriptor_set_layout);
+  iree_hal_pipeline_layout_release(instance->pipeline_layout);
+  iree_file_contents_free(instance->file_contents);
+}
+
+// Registers one benchmark per workgroup count of |instance|.
+// |args| must have capacity for all workgroup counts of the instance spec.
+static iree_status_t iree_benchmark_executable_instance_register(
+    const iree_benchmark_executable_instance_t* instance,
+    iree_string_view_t name_prefix, iree_benchmark_executable_args_t* args) {
+  const iree_benchmark_executable_spec_t* spec = instance->spec;
+  for (iree_host_size_t i = 0; i < spec->workgroup_count_count; ++i) {
     args[i] = (iree_benchmark_executable_args_t){
-        .device = device,
-        .executable = executable,
-        .pipeline_layout = pipeline_layout,
-        .bindings = bindings,
+        .instance = instance,
         .workgroup_count = {1, 1, 1},
     };
-    IREE_RETURN_IF_ERROR(iree_parse_workgroup_count(
-        FLAG_workgroup_count_list().values[i], args[i].workgroup_count));
+    IREE_RETURN_IF_ERROR(iree_parse_workgroup_count(spec->workgroup_counts[i],
+                                                    args[i].workgroup_count));
     iree_benchmark_def_t benchmark_def = {
         .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
                  IREE_BENCHMARK_FLAG_USE_REAL_TIME,
@@ -488,22 +755,148 @@ static iree_status_t iree_benchmark_executable_from_flags(
         .user_data = &args[i],
     };
     char benchmark_name[512];
-    snprintf(benchmark_name, sizeof(benchmark_name) - 1, "dispatch_%ux%ux%u",
+    snprintf(benchmark_name, sizeof(benchmark_name) - 1,
+             "%.*sdispatch_%ux%ux%u", (int)name_prefix.size, name_prefix.data,
              args[i].workgroup_count[0], args[i].workgroup_count[1],
              args[i].workgroup_count[2]);
     iree_benchmark_register(iree_make_cstring_view(benchmark_name),
                             &benchmark_def);
   }
+  return iree_ok_status();
+}
+
+// Runs one benchmark per workgroup count of each spec on each device specified
+// using the same input/output buffers for all workgroup counts of a spec.
+static iree_status_t iree_benchmark_executable_from_flags(
+    iree_allocator_t host_allocator) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                               host_allocator, &instance));
+  IREE_RETURN_IF_ERROR(iree_hal_module_register_inline_types(instance));
+
+  // Create the HAL devices we'll be using during execution.
+  // Devices can be very expensive to create and we want to avoid doing it
+  // multiple times throughout the benchmark execution. Each spec runs on every
+  // device so that multi-device systems can be profiled in one run.
+  iree_hal_device_list_t* device_list = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_create_devices_from_flags(
+      iree_hal_available_driver_registry(), iree_hal_default_device_uri(),
+      host_allocator, &device_list));
+
+  // Gather the specs to benchmark from the sweep file or the flags.
+  iree_file_contents_t* sweep_contents = NULL;
+  iree_host_size_t spec_count = 0;
+  iree_benchmark_executable_spec_t* specs = NULL;
+  if (strlen(FLAG_sweep_file) > 0) {
+    IREE_RETURN_IF_ERROR(iree_file_read_contents(FLAG_sweep_file,
+                                                 IREE_FILE_READ_FLAG_DEFAULT,
+                                                 host_allocator,
+                                                 &sweep_contents));
+    IREE_RETURN_IF_ERROR(iree_benchmark_executable_parse_sweep_file(
+        iree_make_string_view((const char*)sweep_contents->const_buffer.data,
+                              sweep_contents->const_buffer.data_length),
+        iree_file_path_dirname(iree_make_cstring_view(FLAG_sweep_file)),
+        host_allocator, &spec_count, &specs));
+  } else {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(host_allocator, sizeof(*specs),
+                                               (void**)&specs));
+    spec_count = 1;
+    IREE_RETURN_IF_ERROR(
+        iree_benchmark_executable_spec_initialize_from_flags(&specs[0]));
+  }
+
+  // Load every spec on every device. All buffers are allocated up front as
+  // benchmarks only run once all have been registered.
+  const iree_host_size_t device_count = device_list->count;
+  iree_host_size_t total_workgroup_count = 0;
+  for (iree_host_size_t i = 0; i < spec_count; ++i) {
+    total_workgroup_count += specs[i].workgroup_count_count;
+  }
+  iree_hal_executable_cache_t** executable_caches = NULL;
+  iree_benchmark_executable_instance_t* instances = NULL;
+  iree_benchmark_executable_args_t* args = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, device_count * sizeof(*executable_caches),
+      (void**)&executable_caches));
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, device_count * spec_count * sizeof(*instances),
+      (void**)&instances));
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator,
+      iree_max(1, device_count * total_workgroup_count) * sizeof(*args),
+      (void**)&args));
+  iree_benchmark_executable_args_t* next_args = args;
+  for (iree_host_size_t i = 0; i < device_count; ++i) {
+    iree_hal_device_t* device = iree_hal_device_list_at(device_list, i);
+
+    // We'll reuse the same executable cache so that once we load the
+    // executable we'll be able to reuse any driver-side optimizations.
+    iree_status_t loop_status = iree_ok_status();
+    IREE_RETURN_IF_ERROR(iree_hal_executable_cache_create(
+        device, iree_make_cstring_view("cache"), iree_loop_inline(&loop_status),
+        &executable_caches[i]));
+    IREE_RETURN_IF_ERROR(loop_status);
+
+    for (iree_host_size_t j = 0; j < spec_count; ++j) {
+      const iree_benchmark_executable_spec_t* spec = &specs[j];
+      iree_benchmark_executable_instance_t* spec_instance =
+          &instances[i * spec_count + j];
+      IREE_RETURN_IF_ERROR(
+          iree_benchmark_executable_instance_initialize(
+              spec, device, executable_caches[i], host_allocator,
+              spec_instance),
+          "loading sweep entry %" PRIhsz " `%.*s` on device %" PRIhsz, j,
+          (int)spec->executable_file.size, spec->executable_file.data, i);
+
+      // Benchmarks are prefixed with the device and spec only when there's
+      // more than one so that the common single benchmark names are stable.
+      char name_prefix[256] = {0};
+      int name_prefix_length = 0;
+      if (device_count > 1) {
+        name_prefix_length +=
+            snprintf(name_prefix + name_prefix_length,
+                     sizeof(name_prefix) - name_prefix_length,
+                     "device%" PRIhsz "/", i);
+      }
+      if (!iree_string_view_is_empty(spec->name)) {
+        name_prefix_length += snprintf(
+            name_prefix + name_prefix_length,
+            sizeof(name_prefix) - name_prefix_length, "%.*s/",
+            (int)spec->name.size, spec->name.data);
+      } else if (spec_count > 1) {
+        iree_string_view_t stem = iree_file_path_stem(spec->executable_file);
+        name_prefix_length += snprintf(
+            name_prefix + name_prefix_length,
+            sizeof(name_prefix) - name_prefix_length, "%.*s:%d/",
+            (int)stem.size, stem.data, spec->entry_point);
+      }
+      IREE_RETURN_IF_ERROR(iree_benchmark_executable_instance_register(
+          spec_instance,
+          iree_make_string_view(
+              name_prefix,
+              iree_min((iree_host_size_t)name_prefix_length,
+                       sizeof(name_prefix) - 1)),
+          next_args));
+      next_args += spec->workgroup_count_count;
+    }
+  }
   iree_benchmark_run_specified();
-  iree_allocator_free(host_allocator, args);
 
-  iree_vm_list_release(binding_list);
-  iree_hal_executable_release(executable);
-  iree_hal_descriptor_set_layout_release(descriptor_set_layout);
-  iree_hal_pipeline_layout_release(pipeline_layout);
-  iree_file_contents_free(file_contents);
-  iree_hal_executable_cache_release(executable_cache);
-  iree_hal_device_release(device);
+  for (iree_host_size_t i = 0; i < device_count * spec_count; ++i) {
+    iree_benchmark_executable_instance_deinitialize(&instances[i]);
+  }
+  for (iree_host_size_t i = 0; i < device_count; ++i) {
+    iree_hal_executable_cache_release(executable_caches[i]);
+  }
+  for (iree_host_size_t i = 0; i < spec_count; ++i) {
+    iree_allocator_free(host_allocator, specs[i].executable_file_storage);
+  }
+  iree_allocator_free(host_allocator, args);
+  iree_allocator_free(host_allocator, instances);
+  iree_allocator_free(host_allocator, executable_caches);
+  iree_allocator_free(host_allocator, specs);
+  iree_file_contents_free(sweep_contents);
+  iree_hal_device_list_free(device_list);
   iree_vm_instance_release(instance);
 
   return iree_ok_status();
@@ -561,6 +954,20 @@ int main(int argc, char** argv) {
       "  --binding=4xf32=100,200,300,400\n"
       "  --binding=4xf32=0,0,0,0\n"
       "  --workgroup_count=1,1,1\n"
+      "\n"
+      "Multiple exports can be benchmarked in one run with --sweep_file=.\n"
+      "Each block of the file uses the same flags as above and blocks are\n"
+      "separated by `---` lines:\n"
+      "  --name=mul_small\n"
+      "  --executable_file=elementwise_mul_x86_64.so\n"
+      "  --binding=4xf32=1,2,3,4\n"
+      "  --binding=4xf32=100,200,300,400\n"
+      "  --binding=4xf32=0,0,0,0\n"
+      "  --workgroup_count=1,1,1\n"
+      "  --flops=4\n"
+      "  ---\n"
+      "  --name=mul_large\n"
+      "  ...\n"
       "\n");
 
   iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
@@ -51,11 +51,29 @@
 // how the full program will run, though, and YMMV. Always verify timings with
 // an appropriate device-specific tool before trusting the more generic and
 // higher-level numbers from this tool.
-
+//
+// Open-loop serving mode
+// ----------------------
+// The benchmarks above are closed-loop: the next invocation starts as soon as
+// the previous one completes, which measures peak throughput but says nothing
+// about latency under a given load. Passing --open_loop_rate=N instead issues
+// requests to --function at N requests per second (with --open_loop_arrivals=
+// either `poisson` or `constant` inter-arrival times) regardless of whether
+// prior requests have completed, served by --open_loop_sessions independent
+// contexts running concurrently. Latencies are measured from the scheduled
+// arrival time so that time spent queued behind busy sessions is included, and
+// a JSON report with latency percentiles, throughput, and HAL allocator
+// statistics is written to --open_loop_output (stdout by default).
+
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cmath>
 #include <cstdio>
 #include <iterator>
+#include <random>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -105,6 +123,22 @@ IREE_FLAG_LIST(
     "Each occurrence of the flag indicates an input in the order they were\n"
     "specified on the command line.");
 
+IREE_FLAG(double, open_loop_rate, 0.0,
+          "Enables the open-loop serving mode when > 0, issuing requests to "
+          "--function at this average rate in requests per second.");
+IREE_FLAG(string, open_loop_arrivals, "poisson",
+          "Arrival process used in open-loop mode: `poisson` for "
+          "exponentially distributed inter-arrival times or `constant` for a "
+          "fixed interval.");
+IREE_FLAG(int32_t, open_loop_requests, 1000,
+          "Number of requests issued in open-loop mode.");
+IREE_FLAG(int32_t, open_loop_sessions, 1,
+          "Number of sessions serving requests concurrently in open-loop mode. "
+          "Each session has its own VM context sharing the same device.");
+IREE_FLAG(string, open_loop_output, "",
+          "File path to write the open-loop JSON report to. Defaults to "
+          "stdout.");
+
 static iree_status_t parse_time_unit(iree_string_view_t flag_name,
                                      void* storage, iree_string_view_t value) {
   auto* unit = (std::pair<bool, benchmark::TimeUnit>*)storage;
@@ -423,6 +457,270 @@ void RegisterDispatchBenchmark(const std::string& function_name,
                                   : benchmark::kMicrosecond);
 }
 
+//===----------------------------------------------------------------------===//
+// Open-loop serving benchmark
+//===----------------------------------------------------------------------===//
+
+// Timestamps of a single open-loop request. All times are absolute.
+struct OpenLoopRequest {
+  // When the request arrived, independent of whether a session was free.
+  iree_time_t arrival_ns = 0;
+  // When a session started executing the request.
+  iree_time_t start_ns = 0;
+  // When the request results were available.
+  iree_time_t end_ns = 0;
+};
+
+// Returns the |fraction| percentile of the sorted |values| using the nearest
+// rank method.
+static double Percentile(const std::vector<double>& sorted_values,
+                         double fraction) {
+  if (sorted_values.empty()) return 0.0;
+  size_t rank = (size_t)std::ceil(fraction * sorted_values.size());
+  return sorted_values[rank > 0 ? rank - 1 : 0];
+}
+
+// Prints summary statistics of |values| in milliseconds as a JSON object.
+static void PrintLatencyJson(FILE* file, const char* name,
+                             std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  double sum = 0.0;
+  for (double value : values) sum += value;
+  fprintf(file,
+          "  \"%s\": {\"mean\": %.6f, \"min\": %.6f, \"p50\": %.6f, "
+          "\"p90\": %.6f, \"p99\": %.6f, \"p999\": %.6f, \"max\": %.6f}",
+          name, values.empty() ? 0.0 : sum / values.size(),
+          values.empty() ? 0.0 : values.front(), Percentile(values, 0.5),
+          Percentile(values, 0.9), Percentile(values, 0.99),
+          Percentile(values, 0.999), values.empty() ? 0.0 : values.back());
+}
+
+static void PrintAllocatorStatisticsJson(FILE* file,
+                                         iree_hal_allocator_t* allocator) {
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics;
+  iree_hal_allocator_query_statistics(allocator, &statistics);
+  fprintf(file,
+          "  \"allocator_statistics\": {\"host_bytes_peak\": %" PRIu64
+          ", \"host_bytes_allocated\": %" PRIu64
+          ", \"host_bytes_freed\": %" PRIu64
+          ", \"device_bytes_peak\": %" PRIu64
+          ", \"device_bytes_allocated\": %" PRIu64
+          ", \"device_bytes_freed\": %" PRIu64 ", \"pool_hits\": %" PRIu64
+          ", \"pool_misses\": %" PRIu64
+          ", \"pool_bytes_reserved\": %" PRIu64
+          ", \"pool_bytes_used\": %" PRIu64
+          ", \"pool_bytes_requested\": %" PRIu64 "}",
+          (uint64_t)statistics.host_bytes_peak,
+          (uint64_t)statistics.host_bytes_allocated,
+          (uint64_t)statistics.host_bytes_freed,
+          (uint64_t)statistics.device_bytes_peak,
+          (uint64_t)statistics.device_bytes_allocated,
+          (uint64_t)statistics.device_bytes_freed, statistics.pool_hits,
+          statistics.pool_misses, (uint64_t)statistics.pool_bytes_reserved,
+          (uint64_t)statistics.pool_bytes_used,
+          (uint64_t)statistics.pool_bytes_requested);
+#else
+  (void)allocator;
+  fprintf(file, "  \"allocator_statistics\": null");
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+// Generates the arrival times of |count| requests starting at |start_ns|.
+static iree_status_t GenerateOpenLoopArrivals(
+    iree_time_t start_ns, std::vector<OpenLoopRequest>& requests) {
+  double mean_interval_ns = 1e9 / FLAG_open_loop_rate;
+  bool poisson = strcmp(FLAG_open_loop_arrivals, "poisson") == 0;
+  if (!poisson && strcmp(FLAG_open_loop_arrivals, "constant") != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown --open_loop_arrivals=%s; expected "
+                            "`poisson` or `constant`",
+                            FLAG_open_loop_arrivals);
+  }
+  // Fixed seed so that runs are comparable.
+  std::mt19937_64 engine(0);
+  std::exponential_distribution<double> interval_distribution(
+      1.0 / mean_interval_ns);
+  double arrival_ns = (double)start_ns;
+  for (auto& request : requests) {
+    request.arrival_ns = (iree_time_t)arrival_ns;
+    arrival_ns += poisson ? interval_distribution(engine) : mean_interval_ns;
+  }
+  return iree_ok_status();
+}
+
+// Runs a single request on |context|. For coarse-fences functions the
+// invocation is made asynchronously with a fresh signal fence on
+// |session_semaphore| that is then waited on.
+static iree_status_t InvokeOpenLoopRequest(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    bool is_async, iree_hal_semaphore_t* session_semaphore,
+    uint64_t signal_value, iree_vm_list_t* session_inputs) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  vm::ref<iree_vm_list_t> inputs;
+  vm::ref<iree_hal_fence_t> signal_fence;
+  if (is_async) {
+    IREE_RETURN_IF_ERROR(iree_vm_list_clone(session_inputs, host_allocator,
+                                            &inputs));
+    IREE_RETURN_IF_ERROR(iree_hal_fence_create_at(
+        session_semaphore, signal_value, host_allocator, &signal_fence));
+    vm::ref<iree_hal_fence_t> wait_fence;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_push_ref_move(inputs.get(), wait_fence));
+    vm::ref<iree_hal_fence_t> signal_fence_arg = vm::retain_ref(signal_fence);
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_push_ref_move(inputs.get(), signal_fence_arg));
+  }
+  vm::ref<iree_vm_list_t> outputs;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                           16, host_allocator, &outputs));
+  IREE_RETURN_IF_ERROR(iree_vm_invoke(
+      context, function, IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/nullptr,
+      is_async ? inputs.get() : session_inputs, outputs.get(),
+      host_allocator));
+  if (is_async) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_fence_wait(signal_fence.get(), iree_infinite_timeout()));
+  }
+  return iree_ok_status();
+}
+
+// Issues requests to |function| at the rate and with the arrival process given
+// by flags, served concurrently by one session per context in |contexts|, and
+// writes a JSON report.
+static iree_status_t RunOpenLoopBenchmark(
+    const std::string& function_name, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    const std::vector<vm::ref<iree_vm_context_t>>& contexts,
+    iree_vm_function_t function, iree_vm_list_t* inputs) {
+  IREE_TRACE_SCOPE_NAMED("RunOpenLoopBenchmark");
+  if (FLAG_open_loop_requests <= 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "--open_loop_requests must be positive");
+  }
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_string_view_t invocation_model = iree_vm_function_lookup_attr_by_name(
+      &function, IREE_SV("iree.abi.model"));
+  bool is_async =
+      iree_string_view_equal(invocation_model, IREE_SV("coarse-fences"));
+  if (is_async && !device) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "coarse-fences functions require a HAL device");
+  }
+
+  // Each session gets its own copy of the input list and, if needed, its own
+  // timeline to signal completion of its requests on.
+  struct Session {
+    vm::ref<iree_vm_list_t> inputs;
+    vm::ref<iree_hal_semaphore_t> semaphore;
+    uint64_t signal_value = 0;
+    iree_status_t status = iree_ok_status();
+  };
+  std::vector<Session> sessions(contexts.size());
+  for (auto& session : sessions) {
+    if (inputs) {
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_clone(inputs, host_allocator, &session.inputs));
+    } else {
+      IREE_RETURN_IF_ERROR(
+          iree_vm_list_create(iree_vm_make_undefined_type_def(), 0,
+                              host_allocator, &session.inputs));
+    }
+    if (is_async) {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_semaphore_create(device, 0ull, &session.semaphore));
+    }
+  }
+
+  // Warm up each session once so that one-time initialization does not show
+  // up in the first requests.
+  for (size_t i = 0; i < sessions.size(); ++i) {
+    IREE_RETURN_IF_ERROR(InvokeOpenLoopRequest(
+        contexts[i].get(), function, is_async, sessions[i].semaphore.get(),
+        ++sessions[i].signal_value, sessions[i].inputs.get()));
+  }
+
+  // Arrivals are scheduled slightly in the future so that all sessions are
+  // waiting by the time the first request arrives.
+  std::vector<OpenLoopRequest> requests(FLAG_open_loop_requests);
+  IREE_RETURN_IF_ERROR(
+      GenerateOpenLoopArrivals(iree_time_now() + 10000000ll, requests));
+
+  // Sessions pull requests in arrival order. A session that becomes free
+  // after a request arrived starts it immediately, so queueing delays caused
+  // by the load are captured in the latency.
+  std::atomic<size_t> next_request{0};
+  auto run_session = [&](size_t session_index) {
+    Session& session = sessions[session_index];
+    while (iree_status_is_ok(session.status)) {
+      size_t request_index = next_request.fetch_add(1);
+      if (request_index >= requests.size()) break;
+      OpenLoopRequest& request = requests[request_index];
+      iree_wait_until(request.arrival_ns);
+      request.start_ns = iree_time_now();
+      session.status = InvokeOpenLoopRequest(
+          contexts[session_index].get(), function, is_async,
+          session.semaphore.get(), ++session.signal_value,
+          session.inputs.get());
+      request.end_ns = iree_time_now();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < sessions.size(); ++i) {
+    threads.emplace_back(run_session, i);
+  }
+  run_session(0);
+  for (auto& thread : threads) thread.join();
+  iree_status_t status = iree_ok_status();
+  for (auto& session : sessions) {
+    if (iree_status_is_ok(status)) {
+      status = session.status;
+    } else {
+      iree_status_ignore(session.status);
+    }
+  }
+  IREE_RETURN_IF_ERROR(status);
+
+  std::vector<double> latencies_ms, queue_delays_ms, service_times_ms;
+  iree_time_t last_end_ns = 0;
+  for (const auto& request : requests) {
+    latencies_ms.push_back((request.end_ns - request.arrival_ns) / 1e6);
+    queue_delays_ms.push_back((request.start_ns - request.arrival_ns) / 1e6);
+    service_times_ms.push_back((request.end_ns - request.start_ns) / 1e6);
+    last_end_ns = std::max(last_end_ns, request.end_ns);
+  }
+  double duration_s = (last_end_ns - requests.front().arrival_ns) / 1e9;
+
+  FILE* file = stdout;
+  if (strlen(FLAG_open_loop_output) > 0) {
+    file = fopen(FLAG_open_loop_output, "w");
+    if (!file) {
+      return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                              "unable to open --open_loop_output=%s",
+                              FLAG_open_loop_output);
+    }
+  }
+  fprintf(file, "{\n");
+  fprintf(file, "  \"function\": \"%s\",\n", function_name.c_str());
+  fprintf(file, "  \"arrivals\": \"%s\",\n", FLAG_open_loop_arrivals);
+  fprintf(file, "  \"target_rate\": %.6f,\n", FLAG_open_loop_rate);
+  fprintf(file, "  \"sessions\": %zu,\n", sessions.size());
+  fprintf(file, "  \"requests\": %zu,\n", requests.size());
+  fprintf(file, "  \"duration_s\": %.6f,\n", duration_s);
+  fprintf(file, "  \"throughput\": %.6f,\n",
+          duration_s > 0 ? requests.size() / duration_s : 0.0);
+  PrintLatencyJson(file, "latency_ms", latencies_ms);
+  fprintf(file, ",\n");
+  PrintLatencyJson(file, "queue_delay_ms", queue_delays_ms);
+  fprintf(file, ",\n");
+  PrintLatencyJson(file, "service_time_ms", service_times_ms);
+  fprintf(file, ",\n");
+  PrintAllocatorStatisticsJson(file, device_allocator);
+  fprintf(file, "\n}\n");
+  if (file != stdout) fclose(file);
+  return iree_ok_status();
+}
+
 // The lifetime of IREEBenchmark should be as long as
 // ::benchmark::RunSpecifiedBenchmarks() where the resources are used during
 // benchmarking.
@@ -436,6 +734,7 @@ class IREEBenchmark {
     // Order matters. Tear down modules first to release resources.
     inputs_.reset();
     context_.reset();
+    session_contexts_.clear();
     iree_tooling_module_list_reset(&module_list_);
     instance_.reset();
 
@@ -466,8 +765,33 @@ class IREEBenchmark {
     return iree_ok_status();
   }
 
+  // Runs --function in the open-loop serving mode instead of registering
+  // closed-loop benchmarks.
+  iree_status_t RunOpenLoop() {
+    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::RunOpenLoop");
+    if (FLAG_open_loop_sessions <= 0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--open_loop_sessions must be positive");
+    }
+    auto function_name = std::string(FLAG_function);
+    if (function_name.empty()) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "open-loop mode requires --function");
+    }
+    IREE_RETURN_IF_ERROR(Init(FLAG_open_loop_sessions));
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(
+        LookupFunctionAndParseInputs(function_name, &function));
+    IREE_RETURN_IF_ERROR(iree_hal_begin_profiling_from_flags(device_.get()));
+    iree_status_t status = RunOpenLoopBenchmark(
+        function_name, device_.get(), device_allocator_.get(),
+        session_contexts_, function, inputs_.get());
+    return iree_status_join(
+        status, iree_hal_end_profiling_from_flags(device_.get()));
+  }
+
  private:
-  iree_status_t Init() {
+  iree_status_t Init(iree_host_size_t context_count = 1) {
     IREE_TRACE_SCOPE_NAMED("IREEBenchmark::Init");
     IREE_TRACE_FRAME_MARK_BEGIN_NAMED("init");
 
@@ -478,28 +802,31 @@ class IREEBenchmark {
     IREE_RETURN_IF_ERROR(iree_tooling_load_modules_from_flags(
         instance_.get(), host_allocator, &module_list_));
 
-    IREE_RETURN_IF_ERROR(iree_tooling_create_context_from_flags(
+    std::vector<iree_vm_context_t*> contexts(context_count);
+    IREE_RETURN_IF_ERROR(iree_tooling_create_contexts_from_flags(
         instance_.get(), module_list_.count, module_list_.values,
         /*default_device_uri=*/iree_string_view_empty(), host_allocator,
-        &context_, &device_, &device_allocator_));
+        context_count, contexts.data(), &device_, &device_allocator_));
+    for (iree_vm_context_t* context : contexts) {
+      session_contexts_.emplace_back(context);
+    }
+    context_ = vm::retain_ref(session_contexts_.front());
 
     IREE_TRACE_FRAME_MARK_END_NAMED("init");
     return iree_ok_status();
   }
 
-  iree_status_t RegisterSpecificFunction(const std::string& function_name) {
-    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::RegisterSpecificFunction");
-
+  iree_status_t LookupFunctionAndParseInputs(const std::string& function_name,
+                                             iree_vm_function_t* out_function) {
     iree_vm_module_t* main_module =
         iree_tooling_module_list_back(&module_list_);
-    iree_vm_function_t function;
     IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_name(
         main_module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
         iree_string_view_t{function_name.data(),
                            (iree_host_size_t)function_name.size()},
-        &function));
+        out_function));
     iree_vm_function_signature_t signature =
-        iree_vm_function_signature(&function);
+        iree_vm_function_signature(out_function);
     iree_string_view_t arguments_cconv, results_cconv;
     IREE_RETURN_IF_ERROR(iree_vm_function_call_get_cconv_fragments(
         &signature, &arguments_cconv, &results_cconv));
@@ -508,6 +835,15 @@ class IREEBenchmark {
         arguments_cconv, FLAG_input_list(), device_.get(),
         device_allocator_.get(), iree_vm_instance_allocator(instance_.get()),
         &inputs_));
+    return iree_ok_status();
+  }
+
+  iree_status_t RegisterSpecificFunction(const std::string& function_name) {
+    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::RegisterSpecificFunction");
+
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(
+        LookupFunctionAndParseInputs(function_name, &function));
 
     iree_string_view_t invocation_model = iree_vm_function_lookup_attr_by_name(
         &function, IREE_SV("iree.abi.model"));
@@ -596,6 +932,8 @@ class IREEBenchmark {
 
   iree::vm::ref<iree_vm_instance_t> instance_;
   iree::vm::ref<iree_vm_context_t> context_;
+  // One context per open-loop session; the first one is also |context_|.
+  std::vector<iree::vm::ref<iree_vm_context_t>> session_contexts_;
   iree::vm::ref<iree_hal_device_t> device_;
   iree::vm::ref<iree_hal_allocator_t> device_allocator_;
   iree_tooling_module_list_t module_list_;
@@ -622,6 +960,16 @@ int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
 
   iree::IREEBenchmark iree_benchmark;
+  if (FLAG_open_loop_rate > 0.0) {
+    iree_status_t status = iree_benchmark.RunOpenLoop();
+    int exit_code = static_cast<int>(iree_status_code(status));
+    if (!iree_status_is_ok(status)) {
+      printf("%s\n", iree::Status(std::move(status)).ToString().c_str());
+    }
+    IREE_TRACE_ZONE_END(z0);
+    IREE_TRACE_APP_EXIT(exit_code);
+    return exit_code;
+  }
   iree_status_t status = iree_benchmark.Register();
   if (!iree_status_is_ok(status)) {
     int exit_code = static_cast<int>(iree_status_code(status));
@@ -0,0 +1,804 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/flags.h"
+#include "iree/hal/api.h"
+#include "iree/io/parameter_index.h"
+#include "iree/modules/hal/types.h"
+#include "iree/testing/benchmark.h"
+#include "iree/tooling/device_util.h"
+#include "iree/vm/api.h"
+
+IREE_FLAG(int32_t, batch_size, 64,
+          "Number of operations performed per benchmark step. Per-step setup\n"
+          "(such as command buffer creation) is amortized across the batch\n"
+          "and timings are reported per operation.");
+
+IREE_FLAG(string, executable_format, "",
+          "Format of the executable file used for the dispatch recording\n"
+          "benchmark. The benchmark is skipped when not specified.");
+IREE_FLAG(string, executable_file, "",
+          "Path to the executable file used for the dispatch recording\n"
+          "benchmark or `-` to read from stdin.");
+IREE_FLAG(int32_t, entry_point, 0,
+          "Entry point ordinal recorded by the dispatch benchmark.");
+IREE_FLAG(int32_t, binding_count, 1,
+          "Number of storage buffer bindings in set 0 of the executable used\n"
+          "by the dispatch benchmark. All bindings reference the same\n"
+          "scratch buffer as the dispatch is only recorded and never run.");
+IREE_FLAG(int32_t, push_constant_count, 0,
+          "Number of 32-bit push constants declared by the executable used by\n"
+          "the dispatch benchmark.");
+
+IREE_FLAG(int32_t, parameter_count, 1024,
+          "Number of entries in the parameter index used by the parameter\n"
+          "lookup benchmarks.");
+
+// Size of the scratch buffer used by the buffer benchmarks.
+#define IREE_BENCHMARK_RUNTIME_BUFFER_SIZE (64 * 1024)
+
+// Maximum number of bindings supported by the dispatch benchmark.
+#define IREE_BENCHMARK_RUNTIME_MAX_BINDING_COUNT 32
+
+//===----------------------------------------------------------------------===//
+// Native overhead module
+//===----------------------------------------------------------------------===//
+
+// The functions that are invoked only do the minimal amount of work required
+// by their signature so that the timings isolate the VM invocation overhead
+// (argument marshaling, stack setup, and call dispatch).
+
+IREE_VM_ABI_EXPORT(iree_benchmark_runtime_noop,  //
+                   void, v, v) {
+  return iree_ok_status();
+}
+
+IREE_VM_ABI_EXPORT(iree_benchmark_runtime_identity,  //
+                   void, r, r) {
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_view_check_deref(args->r0, &buffer_view));
+  rets->r0 = iree_hal_buffer_view_retain_ref(buffer_view);
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t
+    iree_benchmark_runtime_module_exports_[] = {
+        {IREE_SVL("identity"), IREE_SVL("0r_r"), 0, NULL},
+        {IREE_SVL("noop"), IREE_SVL("0v_v"), 0, NULL},
+};
+static const iree_vm_native_function_ptr_t
+    iree_benchmark_runtime_module_funcs_[] = {
+        {
+            .shim = (iree_vm_native_function_shim_t)iree_vm_shim_r_r,
+            .target = (iree_vm_native_function_target_t)
+                iree_benchmark_runtime_identity,
+        },
+        {
+            .shim = (iree_vm_native_function_shim_t)iree_vm_shim_v_v,
+            .target =
+                (iree_vm_native_function_target_t)iree_benchmark_runtime_noop,
+        },
+};
+static_assert(IREE_ARRAYSIZE(iree_benchmark_runtime_module_funcs_) ==
+                  IREE_ARRAYSIZE(iree_benchmark_runtime_module_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t
+    iree_benchmark_runtime_module_descriptor_ = {
+        .name = IREE_SVL("overhead"),
+        .version = 0u,
+        .attr_count = 0,
+        .attrs = NULL,
+        .dependency_count = 0,
+        .dependencies = NULL,
+        .import_count = 0,
+        .imports = NULL,
+        .export_count = IREE_ARRAYSIZE(iree_benchmark_runtime_module_exports_),
+        .exports = iree_benchmark_runtime_module_exports_,
+        .function_count = IREE_ARRAYSIZE(iree_benchmark_runtime_module_funcs_),
+        .functions = iree_benchmark_runtime_module_funcs_,
+};
+
+static iree_status_t iree_benchmark_runtime_module_create(
+    iree_vm_instance_t* instance, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  return iree_vm_native_module_create(
+      &interface, &iree_benchmark_runtime_module_descriptor_, instance,
+      host_allocator, out_module);
+}
+
+//===----------------------------------------------------------------------===//
+// Benchmark state
+//===----------------------------------------------------------------------===//
+
+// Shared state for the device-independent benchmarks.
+typedef struct iree_benchmark_runtime_t {
+  iree_allocator_t host_allocator;
+  iree_vm_instance_t* instance;
+  iree_vm_context_t* context;
+  iree_vm_function_t noop_function;
+  iree_vm_function_t identity_function;
+  // Buffer view passed to the identity function. Allocated from the first
+  // device as the VM never touches the contents.
+  iree_hal_buffer_view_t* buffer_view;
+  // Parameter index populated with FLAG_parameter_count splat entries.
+  iree_io_parameter_index_t* parameter_index;
+  iree_host_size_t parameter_count;
+  iree_string_view_t* parameter_keys;
+  char* parameter_key_storage;
+} iree_benchmark_runtime_t;
+
+// Per-device state for the HAL benchmarks.
+typedef struct iree_benchmark_runtime_device_t {
+  iree_hal_device_t* device;
+  iree_hal_buffer_t* buffer;
+  // Only populated when an executable was provided by flags.
+  iree_hal_executable_cache_t* executable_cache;
+  iree_hal_descriptor_set_layout_t* descriptor_set_layout;
+  iree_hal_pipeline_layout_t* pipeline_layout;
+  iree_hal_executable_t* executable;
+} iree_benchmark_runtime_device_t;
+
+static iree_status_t iree_benchmark_runtime_initialize(
+    iree_hal_device_t* device, iree_allocator_t host_allocator,
+    iree_benchmark_runtime_t* out_runtime) {
+  memset(out_runtime, 0, sizeof(*out_runtime));
+  out_runtime->host_allocator = host_allocator;
+
+  IREE_RETURN_IF_ERROR(iree_vm_instance_create(
+      IREE_VM_TYPE_CAPACITY_DEFAULT, host_allocator, &out_runtime->instance));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_module_register_inline_types(out_runtime->instance));
+
+  iree_vm_module_t* module = NULL;
+  IREE_RETURN_IF_ERROR(iree_benchmark_runtime_module_create(
+      out_runtime->instance, host_allocator, &module));
+  iree_status_t status = iree_vm_context_create_with_modules(
+      out_runtime->instance, IREE_VM_CONTEXT_FLAG_NONE, 1, &module,
+      host_allocator, &out_runtime->context);
+  iree_vm_module_release(module);
+  IREE_RETURN_IF_ERROR(status);
+  IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+      out_runtime->context, IREE_SV("overhead.noop"),
+      &out_runtime->noop_function));
+  IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+      out_runtime->context, IREE_SV("overhead.identity"),
+      &out_runtime->identity_function));
+
+  if (device) {
+    iree_hal_buffer_params_t params = {
+        .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+        .access = IREE_HAL_MEMORY_ACCESS_ALL,
+        .type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_DEVICE,
+    };
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device), params, sizeof(float) * 4,
+        &buffer));
+    const iree_hal_dim_t shape[1] = {4};
+    status = iree_hal_buffer_view_create(
+        buffer, IREE_ARRAYSIZE(shape), shape, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+        IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, host_allocator,
+        &out_runtime->buffer_view);
+    iree_hal_buffer_release(buffer);
+    IREE_RETURN_IF_ERROR(status);
+  }
+
+  // Keys are stored in a single allocation and referenced by the key list so
+  // that the lookup loop does not need to format them.
+  IREE_RETURN_IF_ERROR(iree_io_parameter_index_create(
+      host_allocator, &out_runtime->parameter_index));
+  out_runtime->parameter_count =
+      (iree_host_size_t)iree_max(1, FLAG_parameter_count);
+  const iree_host_size_t key_capacity = 24;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator,
+      out_runtime->parameter_count * sizeof(*out_runtime->parameter_keys),
+      (void**)&out_runtime->parameter_keys));
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, out_runtime->parameter_count * key_capacity,
+      (void**)&out_runtime->parameter_key_storage));
+  for (iree_host_size_t i = 0; i < out_runtime->parameter_count; ++i) {
+    char* key_buffer = out_runtime->parameter_key_storage + i * key_capacity;
+    int key_length = snprintf(key_buffer, key_capacity, "param_%" PRIhsz, i);
+    out_runtime->parameter_keys[i] =
+        iree_make_string_view(key_buffer, (iree_host_size_t)key_length);
+    iree_io_parameter_index_entry_t entry = {
+        .key = out_runtime->parameter_keys[i],
+        .metadata = iree_const_byte_span_empty(),
+        .length = 4096,
+        .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT,
+    };
+    entry.storage.splat.pattern_length = 1;
+    entry.storage.splat.pattern[0] = (uint8_t)i;
+    IREE_RETURN_IF_ERROR(
+        iree_io_parameter_index_add(out_runtime->parameter_index, &entry));
+  }
+
+  return iree_ok_status();
+}
+
+static void iree_benchmark_runtime_deinitialize(
+    iree_benchmark_runtime_t* runtime) {
+  iree_allocator_free(runtime->host_allocator, runtime->parameter_key_storage);
+  iree_allocator_free(runtime->host_allocator, runtime->parameter_keys);
+  iree_io_parameter_index_release(runtime->parameter_index);
+  iree_hal_buffer_view_release(runtime->buffer_view);
+  iree_vm_context_release(runtime->context);
+  iree_vm_instance_release(runtime->instance);
+  memset(runtime, 0, sizeof(*runtime));
+}
+
+// Initializes the benchmark state for |device|. |executable_contents| is
+// optional and when provided is loaded for the dispatch benchmark.
+static iree_status_t iree_benchmark_runtime_device_initialize(
+    iree_hal_device_t* device, iree_file_contents_t* executable_contents,
+    iree_benchmark_runtime_device_t* out_device) {
+  memset(out_device, 0, sizeof(*out_device));
+  out_device->device = device;
+
+  iree_hal_buffer_params_t params = {
+      .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
+      .access = IREE_HAL_MEMORY_ACCESS_ALL,
+      .type = IREE_HAL_MEMORY_TYPE_OPTIMAL_FOR_DEVICE,
+  };
+  IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+      iree_hal_device_allocator(device), params,
+      IREE_BENCHMARK_RUNTIME_BUFFER_SIZE, &out_device->buffer));
+
+  // The dispatch benchmark is optional as there's no executable format that
+  // is supported by every device.
+  if (!executable_contents) return iree_ok_status();
+
+  iree_status_t loop_status = iree_ok_status();
+  IREE_RETURN_IF_ERROR(iree_hal_executable_cache_create(
+      device, iree_make_cstring_view("cache"), iree_loop_inline(&loop_status),
+      &out_device->executable_cache));
+  IREE_RETURN_IF_ERROR(loop_status);
+
+  iree_hal_descriptor_set_layout_binding_t
+      binding_layouts[IREE_BENCHMARK_RUNTIME_MAX_BINDING_COUNT];
+  for (int32_t i = 0; i < FLAG_binding_count; ++i) {
+    binding_layouts[i] = (iree_hal_descriptor_set_layout_binding_t){
+        .binding = (uint32_t)i,
+        .type = IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .flags = IREE_HAL_DESCRIPTOR_FLAG_NONE,
+    };
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_descriptor_set_layout_create(
+      device, IREE_HAL_DESCRIPTOR_SET_LAYOUT_FLAG_NONE, FLAG_binding_count,
+      binding_layouts, &out_device->descriptor_set_layout));
+  IREE_RETURN_IF_ERROR(iree_hal_pipeline_layout_create(
+      device, FLAG_push_constant_count,
+      /*set_layout_count=*/1, &out_device->descriptor_set_layout,
+      &out_device->pipeline_layout));
+
+  iree_hal_executable_params_t executable_params;
+  iree_hal_executable_params_initialize(&executable_params);
+  executable_params.caching_mode =
+      IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_OPTIMIZATION |
+      IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+  executable_params.executable_format =
+      iree_make_cstring_view(FLAG_executable_format);
+  executable_params.executable_data = executable_contents->const_buffer;
+  executable_params.pipeline_layout_count = 1;
+  executable_params.pipeline_layouts = &out_device->pipeline_layout;
+  return iree_hal_executable_cache_prepare_executable(
+      out_device->executable_cache, &executable_params,
+      &out_device->executable);
+}
+
+static void iree_benchmark_runtime_device_deinitialize(
+    iree_benchmark_runtime_device_t* device) {
+  iree_hal_executable_release(device->executable);
+  iree_hal_pipeline_layout_release(device->pipeline_layout);
+  iree_hal_descriptor_set_layout_release(device->descriptor_set_layout);
+  iree_hal_executable_cache_release(device->executable_cache);
+  iree_hal_buffer_release(device->buffer);
+  memset(device, 0, sizeof(*device));
+}
+
+//===----------------------------------------------------------------------===//
+// VM benchmarks
+//===----------------------------------------------------------------------===//
+
+// Invokes a function taking and returning nothing. This is the floor of the
+// cost of calling into a module from the host.
+static iree_status_t iree_benchmark_runtime_invoke_empty(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_t* runtime =
+      (const iree_benchmark_runtime_t*)benchmark_def->user_data;
+  int64_t total_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, FLAG_batch_size)) {
+    for (int32_t i = 0; i < FLAG_batch_size; ++i) {
+      IREE_RETURN_IF_ERROR(iree_vm_invoke(
+          runtime->context, runtime->noop_function,
+          IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL, /*inputs=*/NULL,
+          /*outputs=*/NULL, runtime->host_allocator));
+    }
+    total_count += FLAG_batch_size;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+  return iree_ok_status();
+}
+
+// Invokes a function passing a buffer view through and back out. Includes the
+// cost of marshaling ref arguments and results through the I/O lists.
+static iree_status_t iree_benchmark_runtime_invoke_buffer_view(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_t* runtime =
+      (const iree_benchmark_runtime_t*)benchmark_def->user_data;
+  if (!runtime->buffer_view) {
+    iree_benchmark_skip(benchmark_state, "no device available");
+    return iree_ok_status();
+  }
+
+  iree_vm_list_t* inputs = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                           1, runtime->host_allocator,
+                                           &inputs));
+  iree_vm_list_t* outputs = NULL;
+  iree_status_t status =
+      iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                          runtime->host_allocator, &outputs);
+  if (iree_status_is_ok(status)) {
+    iree_vm_ref_t buffer_view_ref =
+        iree_hal_buffer_view_retain_ref(runtime->buffer_view);
+    status = iree_vm_list_push_ref_move(inputs, &buffer_view_ref);
+  }
+
+  int64_t total_count = 0;
+  while (iree_status_is_ok(status) &&
+         iree_benchmark_keep_running(benchmark_state, FLAG_batch_size)) {
+    for (int32_t i = 0; i < FLAG_batch_size && iree_status_is_ok(status); ++i) {
+      status = iree_vm_invoke(runtime->context, runtime->identity_function,
+                              IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL,
+                              inputs, outputs, runtime->host_allocator);
+      iree_vm_list_clear(outputs);
+    }
+    total_count += FLAG_batch_size;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+
+  iree_vm_list_release(outputs);
+  iree_vm_list_release(inputs);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// HAL benchmarks
+//===----------------------------------------------------------------------===//
+
+// Records a batch of fill commands into a one-shot command buffer. Command
+// buffers are never submitted and the time is the host-side recording cost.
+static iree_status_t iree_benchmark_runtime_record_fill(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_device_t* device =
+      (const iree_benchmark_runtime_device_t*)benchmark_def->user_data;
+  const uint32_t pattern = 0xCDCDCDCDu;
+  int64_t total_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, FLAG_batch_size)) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
+        device->device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/0, &command_buffer));
+    iree_status_t status = iree_hal_command_buffer_begin(command_buffer);
+    for (int32_t i = 0; i < FLAG_batch_size && iree_status_is_ok(status); ++i) {
+      status = iree_hal_command_buffer_fill_buffer(
+          command_buffer, device->buffer, /*target_offset=*/0,
+          IREE_BENCHMARK_RUNTIME_BUFFER_SIZE, &pattern, sizeof(pattern));
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_command_buffer_end(command_buffer);
+    }
+    iree_hal_command_buffer_release(command_buffer);
+    IREE_RETURN_IF_ERROR(status);
+    total_count += FLAG_batch_size;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+  return iree_ok_status();
+}
+
+// Records a batch of dispatches (each with their descriptor set push) into a
+// one-shot command buffer. Requires an executable provided by flags.
+static iree_status_t iree_benchmark_runtime_record_dispatch(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_device_t* device =
+      (const iree_benchmark_runtime_device_t*)benchmark_def->user_data;
+  if (!device->executable) {
+    iree_benchmark_skip(benchmark_state,
+                        "no executable specified with --executable_file=");
+    return iree_ok_status();
+  }
+
+  iree_hal_descriptor_set_binding_t
+      bindings[IREE_BENCHMARK_RUNTIME_MAX_BINDING_COUNT];
+  for (int32_t i = 0; i < FLAG_binding_count; ++i) {
+    bindings[i] = (iree_hal_descriptor_set_binding_t){
+        .binding = (uint32_t)i,
+        .buffer_slot = 0,
+        .buffer = device->buffer,
+        .offset = 0,
+        .length = IREE_WHOLE_BUFFER,
+    };
+  }
+
+  int64_t total_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, FLAG_batch_size)) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
+        device->device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_DISPATCH, IREE_HAL_QUEUE_AFFINITY_ANY,
+        /*binding_capacity=*/0, &command_buffer));
+    iree_status_t status = iree_hal_command_buffer_begin(command_buffer);
+    for (int32_t i = 0; i < FLAG_batch_size && iree_status_is_ok(status); ++i) {
+      status = iree_hal_command_buffer_push_descriptor_set(
+          command_buffer, device->pipeline_layout, /*set=*/0,
+          FLAG_binding_count, bindings);
+      if (iree_status_is_ok(status)) {
+        status = iree_hal_command_buffer_dispatch(
+            command_buffer, device->executable, FLAG_entry_point, 1, 1, 1);
+      }
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_command_buffer_end(command_buffer);
+    }
+    iree_hal_command_buffer_release(command_buffer);
+    IREE_RETURN_IF_ERROR(status);
+    total_count += FLAG_batch_size;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+  return iree_ok_status();
+}
+
+// Submits an empty queue barrier signaling a semaphore and waits for it on the
+// host. This is the round trip latency of the queue with no device work.
+static iree_status_t iree_benchmark_runtime_queue_barrier(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_device_t* device =
+      (const iree_benchmark_runtime_device_t*)benchmark_def->user_data;
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_semaphore_create(device->device, 0ull, &semaphore));
+  uint64_t payload_value = 0ull;
+  iree_hal_semaphore_list_t signal_list = {
+      .count = 1,
+      .semaphores = &semaphore,
+      .payload_values = &payload_value,
+  };
+  iree_status_t status = iree_ok_status();
+  int64_t total_count = 0;
+  while (iree_status_is_ok(status) &&
+         iree_benchmark_keep_running(benchmark_state, 1)) {
+    ++payload_value;
+    status = iree_hal_device_queue_barrier(
+        device->device, IREE_HAL_QUEUE_AFFINITY_ANY,
+        iree_hal_semaphore_list_empty(), signal_list);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_wait(semaphore, payload_value,
+                                       iree_infinite_timeout());
+    }
+    ++total_count;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+  iree_hal_semaphore_release(semaphore);
+  return status;
+}
+
+// Signals a semaphore from the host and waits on the already-reached value.
+// Measures the host-side semaphore fast path without involving the queue.
+static iree_status_t iree_benchmark_runtime_semaphore_signal_wait(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_device_t* device =
+      (const iree_benchmark_runtime_device_t*)benchmark_def->user_data;
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_semaphore_create(device->device, 0ull, &semaphore));
+  iree_status_t status = iree_ok_status();
+  uint64_t payload_value = 0ull;
+  int64_t total_count = 0;
+  while (iree_status_is_ok(status) &&
+         iree_benchmark_keep_running(benchmark_state, FLAG_batch_size)) {
+    for (int32_t i = 0; i < FLAG_batch_size && iree_status_is_ok(status); ++i) {
+      status = iree_hal_semaphore_signal(semaphore, ++payload_value);
+      if (iree_status_is_ok(status)) {
+        status = iree_hal_semaphore_wait(semaphore, payload_value,
+                                         iree_infinite_timeout());
+      }
+    }
+    total_count += FLAG_batch_size;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+  iree_hal_semaphore_release(semaphore);
+  return status;
+}
+
+// Creates and releases a buffer view around an existing buffer as is done for
+// every tensor crossing the program boundary.
+static iree_status_t iree_benchmark_runtime_buffer_view_create(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_device_t* device =
+      (const iree_benchmark_runtime_device_t*)benchmark_def->user_data;
+  const iree_hal_dim_t shape[4] = {1, 16, 16, 64};
+  int64_t total_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, FLAG_batch_size)) {
+    for (int32_t i = 0; i < FLAG_batch_size; ++i) {
+      iree_hal_buffer_view_t* buffer_view = NULL;
+      IREE_RETURN_IF_ERROR(iree_hal_buffer_view_create(
+          device->buffer, IREE_ARRAYSIZE(shape), shape,
+          IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+          IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+          benchmark_state->host_allocator, &buffer_view));
+      iree_hal_buffer_view_release(buffer_view);
+    }
+    total_count += FLAG_batch_size;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// IO benchmarks
+//===----------------------------------------------------------------------===//
+
+// Looks up parameters one at a time cycling through all keys in the index.
+static iree_status_t iree_benchmark_runtime_parameter_lookup(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_t* runtime =
+      (const iree_benchmark_runtime_t*)benchmark_def->user_data;
+  iree_host_size_t key_ordinal = 0;
+  int64_t total_count = 0;
+  while (iree_benchmark_keep_running(benchmark_state, FLAG_batch_size)) {
+    for (int32_t i = 0; i < FLAG_batch_size; ++i) {
+      const iree_io_parameter_index_entry_t* entry = NULL;
+      IREE_RETURN_IF_ERROR(iree_io_parameter_index_lookup(
+          runtime->parameter_index, runtime->parameter_keys[key_ordinal],
+          &entry));
+      if (++key_ordinal == runtime->parameter_count) key_ordinal = 0;
+    }
+    total_count += FLAG_batch_size;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+  return iree_ok_status();
+}
+
+// Looks up all parameters in the index with a single batched lookup as is done
+// when initializing a module with many parameters.
+static iree_status_t iree_benchmark_runtime_parameter_lookup_batch(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  const iree_benchmark_runtime_t* runtime =
+      (const iree_benchmark_runtime_t*)benchmark_def->user_data;
+  const iree_io_parameter_index_entry_t** entries = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      runtime->host_allocator, runtime->parameter_count * sizeof(*entries),
+      (void**)&entries));
+  iree_status_t status = iree_ok_status();
+  int64_t total_count = 0;
+  while (iree_status_is_ok(status) &&
+         iree_benchmark_keep_running(benchmark_state, 1)) {
+    status = iree_io_parameter_index_lookup_batch(
+        runtime->parameter_index, runtime->parameter_count,
+        runtime->parameter_keys, entries);
+    total_count += runtime->parameter_count;
+  }
+  iree_benchmark_set_items_processed(benchmark_state, total_count);
+  iree_allocator_free(runtime->host_allocator, entries);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Registration
+//===----------------------------------------------------------------------===//
+
+static void iree_benchmark_runtime_register(iree_string_view_t name_prefix,
+                                            const char* name,
+                                            iree_benchmark_fn_t fn,
+                                            const void* user_data) {
+  iree_benchmark_def_t benchmark_def = {
+      .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+               IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+      .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+      .minimum_duration_ns = 0,
+      .iteration_count = 0,
+      .run = fn,
+      .user_data = user_data,
+  };
+  char benchmark_name[512];
+  snprintf(benchmark_name, sizeof(benchmark_name) - 1, "%.*s%s",
+           (int)name_prefix.size, name_prefix.data, name);
+  iree_benchmark_register(iree_make_cstring_view(benchmark_name),
+                          &benchmark_def);
+}
+
+static iree_status_t iree_benchmark_runtime_from_flags(
+    iree_allocator_t host_allocator) {
+  if (FLAG_batch_size <= 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "--batch_size must be positive");
+  }
+
+  // Create the HAL devices we'll be benchmarking. Devices are created once
+  // up front as they can be expensive to create.
+  iree_hal_device_list_t* device_list = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_create_devices_from_flags(
+      iree_hal_available_driver_registry(), iree_hal_default_device_uri(),
+      host_allocator, &device_list));
+  const iree_host_size_t device_count = device_list->count;
+
+  iree_benchmark_runtime_t runtime;
+  iree_status_t status = iree_benchmark_runtime_initialize(
+      device_count > 0 ? iree_hal_device_list_at(device_list, 0) : NULL,
+      host_allocator, &runtime);
+
+  // The executable is read once and shared by all devices so that it can be
+  // provided on stdin.
+  iree_file_contents_t* executable_contents = NULL;
+  if (iree_status_is_ok(status) && strlen(FLAG_executable_file) > 0) {
+    if (FLAG_binding_count < 0 ||
+        FLAG_binding_count > IREE_BENCHMARK_RUNTIME_MAX_BINDING_COUNT) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "--binding_count=%d out of range [0, %d]",
+                                FLAG_binding_count,
+                                IREE_BENCHMARK_RUNTIME_MAX_BINDING_COUNT);
+    } else if (strcmp(FLAG_executable_file, "-") == 0) {
+      status = iree_stdin_read_contents(host_allocator, &executable_contents);
+    } else {
+      status = iree_file_read_contents(FLAG_executable_file,
+                                       IREE_FILE_READ_FLAG_DEFAULT,
+                                       host_allocator, &executable_contents);
+    }
+  }
+
+  iree_benchmark_runtime_device_t* devices = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(host_allocator,
+                                   iree_max(1, device_count) * sizeof(*devices),
+                                   (void**)&devices);
+  }
+  iree_host_size_t initialized_device_count = 0;
+  for (iree_host_size_t i = 0; i < device_count && iree_status_is_ok(status);
+       ++i) {
+    // Partially initialized devices are still deinitialized on failure.
+    ++initialized_device_count;
+    status = iree_benchmark_runtime_device_initialize(
+        iree_hal_device_list_at(device_list, i), executable_contents,
+        &devices[i]);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_benchmark_runtime_register(
+        iree_string_view_empty(), "vm/invoke_empty",
+        iree_benchmark_runtime_invoke_empty, &runtime);
+    iree_benchmark_runtime_register(
+        iree_string_view_empty(), "vm/invoke_buffer_view",
+        iree_benchmark_runtime_invoke_buffer_view, &runtime);
+    iree_benchmark_runtime_register(
+        iree_string_view_empty(), "io/parameter_lookup",
+        iree_benchmark_runtime_parameter_lookup, &runtime);
+    iree_benchmark_runtime_register(
+        iree_string_view_empty(), "io/parameter_lookup_batch",
+        iree_benchmark_runtime_parameter_lookup_batch, &runtime);
+
+    // Device benchmarks are prefixed with the device ID so results from
+    // multiple runs against different drivers can be compared side by side.
+    for (iree_host_size_t i = 0; i < device_count; ++i) {
+      iree_string_view_t device_id = iree_hal_device_id(devices[i].device);
+      char name_prefix[256] = {0};
+      int name_prefix_length = 0;
+      if (device_count > 1) {
+        name_prefix_length =
+            snprintf(name_prefix, sizeof(name_prefix), "%.*s:%" PRIhsz "/",
+                     (int)device_id.size, device_id.data, i);
+      } else {
+        name_prefix_length = snprintf(name_prefix, sizeof(name_prefix),
+                                      "%.*s/", (int)device_id.size,
+                                      device_id.data);
+      }
+      iree_string_view_t prefix = iree_make_string_view(
+          name_prefix, iree_min((iree_host_size_t)name_prefix_length,
+                                sizeof(name_prefix) - 1));
+      iree_benchmark_runtime_register(prefix, "command_buffer/record_fill",
+                                      iree_benchmark_runtime_record_fill,
+                                      &devices[i]);
+      iree_benchmark_runtime_register(prefix, "command_buffer/record_dispatch",
+                                      iree_benchmark_runtime_record_dispatch,
+                                      &devices[i]);
+      iree_benchmark_runtime_register(prefix, "queue/barrier_roundtrip",
+                                      iree_benchmark_runtime_queue_barrier,
+                                      &devices[i]);
+      iree_benchmark_runtime_register(
+          prefix, "semaphore/signal_wait",
+          iree_benchmark_runtime_semaphore_signal_wait, &devices[i]);
+      iree_benchmark_runtime_register(prefix, "buffer_view/create",
+                                      iree_benchmark_runtime_buffer_view_create,
+                                      &devices[i]);
+    }
+
+    iree_benchmark_run_specified();
+  }
+
+  for (iree_host_size_t i = 0; i < initialized_device_count; ++i) {
+    iree_benchmark_runtime_device_deinitialize(&devices[i]);
+  }
+  iree_allocator_free(host_allocator, devices);
+  iree_file_contents_free(executable_contents);
+  iree_benchmark_runtime_deinitialize(&runtime);
+  iree_hal_device_list_free(device_list);
+  return status;
+}
+
+int main(int argc, char** argv) {
+  IREE_TRACE_APP_ENTER();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_allocator_t host_allocator = iree_allocator_system();
+  int exit_code = EXIT_SUCCESS;
+
+  iree_flags_set_usage(
+      "iree-benchmark-runtime",
+      "Benchmarks the fixed overheads of the IREE runtime independent of any\n"
+      "particular program. Results are intended to be tracked over time to\n"
+      "catch regressions in the host-side framework costs that dominate\n"
+      "small workloads.\n"
+      "\n"
+      "Benchmarks:\n"
+      "  vm/invoke_empty: iree_vm_invoke of a native function with no\n"
+      "    arguments or results.\n"
+      "  vm/invoke_buffer_view: iree_vm_invoke passing a buffer view through\n"
+      "    a native function.\n"
+      "  io/parameter_lookup: single parameter index lookups.\n"
+      "  io/parameter_lookup_batch: batched lookup of all parameters.\n"
+      "Per device specified with --device= (defaulting to local-task):\n"
+      "  <device>/command_buffer/record_fill: recording a fill command.\n"
+      "  <device>/command_buffer/record_dispatch: recording a descriptor set\n"
+      "    push and dispatch of the executable provided with\n"
+      "    --executable_format= and --executable_file=.\n"
+      "  <device>/queue/barrier_roundtrip: an empty queue barrier signaling a\n"
+      "    semaphore that is then waited on by the host.\n"
+      "  <device>/semaphore/signal_wait: host signal and wait.\n"
+      "  <device>/buffer_view/create: buffer view creation and release.\n"
+      "\n"
+      "Example:\n"
+      "  iree-benchmark-runtime --device=local-sync --device=local-task \\\n"
+      "    --benchmark_format=json --benchmark_out=runtime.json\n"
+      "\n"
+      "Use --benchmark_filter= to select benchmarks and --benchmark_format=\n"
+      "json or --benchmark_out= to produce machine-readable results.\n");
+
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
+  iree_benchmark_initialize(&argc, argv);
+
+  iree_status_t status = iree_benchmark_runtime_from_flags(host_allocator);
+  if (!iree_status_is_ok(status)) {
+    iree_status_fprint(stderr, status);
+    iree_status_free(status);
+    exit_code = EXIT_FAILURE;
+  }
+  fflush(stderr);
+
+  IREE_TRACE_ZONE_END(z0);
+  IREE_TRACE_APP_EXIT(exit_code);
+  return exit_code;
+}
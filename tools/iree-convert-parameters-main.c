@@ -14,6 +14,7 @@
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
 #include "iree/hal/api.h"
+#include "iree/io/compression.h"
 #include "iree/io/formats/irpa/irpa_builder.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/scope_map.h"
@@ -118,6 +119,7 @@ static iree_status_t iree_tooling_replace_splatted_parameter(
 static iree_status_t iree_tooling_convert_parameter_index(
     iree_io_parameter_index_t* source_index,
     iree_io_parameter_index_t* target_index) {
+  IREE_RETURN_IF_ERROR(iree_io_parameter_index_resolve_all(source_index));
   for (iree_host_size_t i = 0; i < iree_io_parameter_index_count(source_index);
        ++i) {
     // Get the existing entry we'll use as a template.
@@ -164,6 +166,22 @@ IREE_FLAG(bool, quiet, false,
 
 IREE_FLAG(string, output, "", "Output .irpa file path.");
 
+IREE_FLAG(int32_t, copy_concurrency, 8,
+          "Maximum number of parameters compressed or copied into the output\n"
+          "file concurrently. Parameters are written to disjoint ranges of\n"
+          "the output and large conversions are usually bound by memory or\n"
+          "I/O bandwidth that a single thread cannot saturate.");
+
+IREE_FLAG(string, compression, "none",
+          "Compression applied to parameter contents in the output file:\n"
+          "  `none`: stored uncompressed and loadable with zero copies.\n"
+          "  `lz4`: chunked LZ4 that decompresses in parallel on load.\n"
+          "Parameters that do not get smaller are stored uncompressed.");
+
+IREE_FLAG(int32_t, compression_chunk_size, 0,
+          "Uncompressed size in bytes of each independently decompressible\n"
+          "chunk or 0 to use the default (1MB).");
+
 static void iree_io_file_handle_release_mapping(
     void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
   iree_file_contents_free((iree_file_contents_t*)user_data);
@@ -266,9 +284,19 @@ int main(int argc, char** argv) {
         .fn = iree_tooling_open_output_parameter_file,
         .user_data = &open_params,
     };
-    status = iree_io_build_parameter_archive(
-        new_index, built_index, open_callback,
-        /*target_file_offset=*/0, host_allocator);
+    iree_io_parameter_archive_build_options_t build_options = {
+        .concurrency = (iree_host_size_t)iree_max(1, FLAG_copy_concurrency),
+        .compression = IREE_IO_COMPRESSION_TYPE_NONE,
+        .compression_chunk_size =
+            (iree_host_size_t)iree_max(0, FLAG_compression_chunk_size),
+    };
+    status = iree_io_compression_type_parse(
+        iree_make_cstring_view(FLAG_compression), &build_options.compression);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_build_parameter_archive_with_options(
+          new_index, built_index, open_callback,
+          /*target_file_offset=*/0, &build_options, host_allocator);
+    }
   }
 
   // Dump the new index ala iree-dump-parameters to show the final file.
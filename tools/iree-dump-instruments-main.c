@@ -62,6 +62,14 @@ static iree_status_t iree_tooling_dump_dispatch_metadata(
           "//"
           "===---------------------------------------------------------------"
           "-------===//\n");
+  uint32_t sample_rate =
+      iree_instruments_DispatchInstrumentDef_sample_rate(instr_def);
+  if (sample_rate > 1) {
+    fprintf(stream, "// sampled: 1 in %u %s\n", sample_rate,
+            iree_instruments_DispatchInstrumentDef_sample_dispatches(instr_def)
+                ? "dispatches"
+                : "workgroups");
+  }
   iree_instruments_DispatchSiteDef_vec_t dispatch_sites_def =
       iree_instruments_DispatchInstrumentDef_sites(instr_def);
   out_metadata->dispatch_sites_def = dispatch_sites_def;
@@ -141,17 +149,16 @@ static void iree_tooling_dump_print_value(
   }
 }
 
-static iree_status_t iree_tooling_dump_dispatch_ringbuffer(
-    const uint8_t* data_ptr, iree_host_size_t data_size,
-    const iree_dispatch_metadata_t* metadata, FILE* stream) {
-  const uint64_t ring_size = data_size - IREE_INSTRUMENT_DISPATCH_PADDING;
-  const uint8_t* ring_data = data_ptr;
-  const uint64_t ring_head = *(const uint64_t*)(ring_data + data_size - 8);
-  const uint64_t ring_range = iree_min(ring_head, ring_size);
-
-  for (iree_host_size_t i = 0; i < ring_range;) {
+// Dumps the entries in |entry_data| where the first entry is at ringbuffer
+// offset |ring_offset| and offsets wrap at |ring_size|.
+static iree_status_t iree_tooling_dump_dispatch_entries(
+    const uint8_t* entry_data, uint64_t entry_data_size, uint64_t ring_offset,
+    uint64_t ring_size, const iree_dispatch_metadata_t* metadata,
+    FILE* stream) {
+  for (iree_host_size_t i = 0; i < entry_data_size;) {
     const iree_instrument_dispatch_header_t* header =
-        (const iree_instrument_dispatch_header_t*)(ring_data + i);
+        (const iree_instrument_dispatch_header_t*)(entry_data + i);
+    const uint64_t offset = (ring_offset + i) & (ring_size - 1);
     switch (header->tag) {
       case IREE_INSTRUMENT_DISPATCH_TYPE_WORKGROUP: {
         const iree_instrument_dispatch_workgroup_t* workgroup =
@@ -168,12 +175,11 @@ static iree_status_t iree_tooling_dump_dispatch_ringbuffer(
         fprintf(stream,
                 "%016" PRIX64
                 " | WORKGROUP dispatch(%u %s %ux%ux%u) %u,%u,%u pid:%u\n",
-                (uint64_t)i, workgroup->dispatch_id, name_def,
+                offset, workgroup->dispatch_id, name_def,
                 workgroup->workgroup_count_x, workgroup->workgroup_count_y,
                 workgroup->workgroup_count_z, workgroup->workgroup_id_x,
                 workgroup->workgroup_id_y, workgroup->workgroup_id_z,
                 workgroup->processor_id);
-        i += sizeof(*workgroup);
         break;
       }
       case IREE_INSTRUMENT_DISPATCH_TYPE_PRINT: {
@@ -182,7 +188,6 @@ static iree_status_t iree_tooling_dump_dispatch_ringbuffer(
         fprintf(stream, "%016" PRIX64 " | PRINT %.*s\n",
                 (uint64_t)print->workgroup_offset, (int)print->length,
                 print->data);
-        i += iree_host_align(sizeof(*print) + print->length, 16);
         break;
       }
       case IREE_INSTRUMENT_DISPATCH_TYPE_VALUE: {
@@ -192,7 +197,6 @@ static iree_status_t iree_tooling_dump_dispatch_ringbuffer(
                 (uint64_t)value->workgroup_offset, (uint32_t)value->ordinal);
         iree_tooling_dump_print_value(value->type, value->bits, stream);
         fputc('\n', stream);
-        i += sizeof(*value);
         break;
       }
       case IREE_INSTRUMENT_DISPATCH_TYPE_MEMORY_LOAD: {
@@ -200,7 +204,6 @@ static iree_status_t iree_tooling_dump_dispatch_ringbuffer(
             (const iree_instrument_dispatch_memory_op_t*)header;
         fprintf(stream, "%016" PRIX64 " | LOAD  %016" PRIX64 " %u\n",
                 (uint64_t)op->workgroup_offset, op->address, (int)op->length);
-        i += sizeof(*op);
         break;
       }
       case IREE_INSTRUMENT_DISPATCH_TYPE_MEMORY_STORE: {
@@ -208,7 +211,6 @@ static iree_status_t iree_tooling_dump_dispatch_ringbuffer(
             (const iree_instrument_dispatch_memory_op_t*)header;
         fprintf(stream, "%016" PRIX64 " | STORE %016" PRIX64 " %u\n",
                 (uint64_t)op->workgroup_offset, op->address, (int)op->length);
-        i += sizeof(*op);
         break;
       }
       default:
@@ -216,11 +218,47 @@ static iree_status_t iree_tooling_dump_dispatch_ringbuffer(
                                 "unimplemented dispatch instr type: %u",
                                 (uint32_t)header->tag);
     }
+    i += iree_instrument_dispatch_entry_size(header);
   }
 
   return iree_ok_status();
 }
 
+static iree_status_t iree_tooling_dump_dispatch_ringbuffer(
+    const uint8_t* data_ptr, iree_host_size_t data_size,
+    const iree_dispatch_metadata_t* metadata, FILE* stream) {
+  const uint64_t ring_size = data_size - IREE_INSTRUMENT_DISPATCH_PADDING;
+  const uint8_t* ring_data = data_ptr;
+  const uint64_t ring_head = *(const uint64_t*)(ring_data + data_size - 8);
+  const uint64_t ring_range = iree_min(ring_head, ring_size);
+  if (ring_head > ring_size) {
+    // Once wrapped older entries have been overwritten and entry boundaries
+    // may no longer line up. Continuous draining with
+    // --instrument_drain_interval_ms= captures everything in order.
+    fprintf(stream,
+            "// WARNING: ringbuffer wrapped; %" PRIu64
+            " bytes of entries were overwritten\n",
+            ring_head - ring_size);
+  }
+  return iree_tooling_dump_dispatch_entries(ring_data, ring_range,
+                                            /*ring_offset=*/0, ring_size,
+                                            metadata, stream);
+}
+
+static iree_status_t iree_tooling_dump_dispatch_ringbuffer_span(
+    const uint8_t* data_ptr, iree_host_size_t data_size,
+    const iree_dispatch_metadata_t* metadata, FILE* stream) {
+  const iree_instrument_dispatch_span_header_t* span_header =
+      (const iree_instrument_dispatch_span_header_t*)data_ptr;
+  if (data_size < sizeof(*span_header)) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "truncated ringbuffer span");
+  }
+  return iree_tooling_dump_dispatch_entries(
+      data_ptr + sizeof(*span_header), data_size - sizeof(*span_header),
+      span_header->ring_offset, span_header->ring_size, metadata, stream);
+}
+
 static iree_status_t iree_tooling_dump_instrument_file(
     iree_const_byte_span_t file_contents, FILE* stream) {
   const uint8_t* file_ptr = file_contents.data;
@@ -242,6 +280,11 @@ static iree_status_t iree_tooling_dump_instrument_file(
             payload, header->content_length, &dispatch_metadata, stream));
         break;
       }
+      case IREE_IDBTS_CHUNK_TYPE_DISPATCH_RINGBUFFER_SPAN: {
+        IREE_RETURN_IF_ERROR(iree_tooling_dump_dispatch_ringbuffer_span(
+            payload, header->content_length, &dispatch_metadata, stream));
+        break;
+      }
       default:
         return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                 "unimplemented chunk type: %u",
@@ -25,6 +25,7 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
+#include "iree/io/compression.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/scope_map.h"
 #include "iree/tooling/parameter_util.h"
@@ -70,12 +71,31 @@ static iree_status_t iree_tooling_extract_parameter(
   }
   iree_byte_span_t file_contents =
       iree_io_file_handle_value(entry->storage.file.handle).host_allocation;
-  iree_const_byte_span_t entry_contents = iree_make_const_byte_span(
-      file_contents.data + entry->storage.file.offset, entry->length);
   char* path_str = (char*)iree_alloca(path.size + 1);
   memcpy(path_str, path.data, path.size);
   path_str[path.size] = 0;
-  return iree_file_write_contents(path_str, entry_contents);
+  if (entry->storage.file.compression == IREE_IO_COMPRESSION_TYPE_NONE) {
+    iree_const_byte_span_t entry_contents = iree_make_const_byte_span(
+        file_contents.data + entry->storage.file.offset, entry->length);
+    return iree_file_write_contents(path_str, entry_contents);
+  }
+
+  // Compressed entries are decompressed into memory before being written.
+  iree_const_byte_span_t blob = iree_make_const_byte_span(
+      file_contents.data + entry->storage.file.offset,
+      entry->storage.file.compressed_length);
+  uint8_t* entry_data = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc_uninitialized(
+      host_allocator, entry->length, (void**)&entry_data));
+  iree_status_t status = iree_io_decompress(
+      blob, iree_make_byte_span(entry_data, entry->length),
+      IREE_IO_COMPRESSION_MAX_CONCURRENCY, host_allocator);
+  if (iree_status_is_ok(status)) {
+    status = iree_file_write_contents(
+        path_str, iree_make_const_byte_span(entry_data, entry->length));
+  }
+  iree_allocator_free(host_allocator, entry_data);
+  return status;
 }
 
 static iree_status_t iree_tooling_extract_parameters(
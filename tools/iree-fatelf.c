@@ -7,6 +7,7 @@
 #include <stdio.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/cpu.h"
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/path.h"
 #include "iree/hal/local/elf/fatelf.h"
@@ -35,6 +36,11 @@ static int print_usage() {
   fprintf(stderr, "Join multiple ELFs into a FatELF:\n");
   fprintf(stderr, "  iree-fatelf join elf_a.so elf_b.so > fatelf.sos\n");
   fprintf(stderr, "\n");
+  fprintf(stderr, "Join ELFs that require CPU features (selected at load):\n");
+  fprintf(stderr,
+          "  iree-fatelf join base.so avx2.so@avx2,fma "
+          "avx512.so@avx512f,avx512bw > fatelf.sos\n");
+  fprintf(stderr, "\n");
   fprintf(stderr, "Split a FatELF into multiple ELF files (to dir):\n");
   fprintf(stderr, "  iree-fatelf split fatelf.sos\n");
   fprintf(stderr, "\n");
@@ -52,9 +58,14 @@ static int print_usage() {
 // runtime be kept as simple as possible than not repeating 100 lines of code.
 // The runtime version is also designed to gracefully accept ELF files where
 // here we only want FatELF files.
-static iree_status_t fatelf_parse(iree_const_byte_span_t file_data,
-                                  iree_fatelf_header_t** out_header) {
+// If the FatELF has CPU feature requirements they are returned in
+// |out_cpu_features| with one entry per record and otherwise it is set to NULL.
+// The storage is part of the |out_header| allocation.
+static iree_status_t fatelf_parse(
+    iree_const_byte_span_t file_data, iree_fatelf_header_t** out_header,
+    iree_fatelf_cpu_features_t** out_cpu_features) {
   *out_header = NULL;
+  *out_cpu_features = NULL;
 
   if (file_data.data_length <
       sizeof(iree_fatelf_header_t) + sizeof(iree_fatelf_record_t)) {
@@ -85,9 +96,16 @@ static iree_status_t fatelf_parse(iree_const_byte_span_t file_data,
         host_header.version, IREE_FATELF_FORMAT_VERSION);
   }
 
-  iree_host_size_t required_bytes =
+  const bool has_cpu_features = iree_all_bits_set(
+      host_header.reserved, IREE_FATELF_HEADER_FLAG_CPU_FEATURES);
+  iree_host_size_t records_size =
       sizeof(iree_fatelf_header_t) +
       host_header.record_count * sizeof(iree_fatelf_record_t);
+  iree_host_size_t cpu_features_size =
+      has_cpu_features
+          ? host_header.record_count * sizeof(iree_fatelf_cpu_features_t)
+          : 0;
+  iree_host_size_t required_bytes = records_size + cpu_features_size;
   if (file_data.data_length < required_bytes) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "FatELF file truncated, requires at least %" PRIhsz
@@ -96,13 +114,10 @@ static iree_status_t fatelf_parse(iree_const_byte_span_t file_data,
                             required_bytes, file_data.data_length);
   }
 
-  // Allocate storage for the parsed header and records.
+  // Allocate storage for the parsed header, records, and CPU features.
   iree_fatelf_header_t* header = NULL;
   IREE_RETURN_IF_ERROR(iree_allocator_malloc(
-      iree_allocator_system(),
-      sizeof(iree_fatelf_header_t) +
-          host_header.record_count * sizeof(iree_fatelf_record_t),
-      (void**)&header));
+      iree_allocator_system(), required_bytes, (void**)&header));
   memcpy(header, &host_header, sizeof(*header));
   for (iree_elf64_byte_t i = 0; i < host_header.record_count; ++i) {
     const iree_fatelf_record_t* raw_record = &raw_header->records[i];
@@ -119,6 +134,19 @@ static iree_status_t fatelf_parse(iree_const_byte_span_t file_data,
     };
     memcpy(&header->records[i], &host_record, sizeof(host_record));
   }
+  if (has_cpu_features) {
+    const iree_fatelf_cpu_features_t* raw_cpu_features =
+        (const iree_fatelf_cpu_features_t*)(file_data.data + records_size);
+    iree_fatelf_cpu_features_t* cpu_features =
+        (iree_fatelf_cpu_features_t*)((uint8_t*)header + records_size);
+    for (iree_elf64_byte_t i = 0; i < host_header.record_count; ++i) {
+      for (iree_host_size_t j = 0; j < IREE_FATELF_CPU_DATA_FIELD_COUNT; ++j) {
+        cpu_features[i].cpu_data[j] =
+            iree_unaligned_load_le_u64(&raw_cpu_features[i].cpu_data[j]);
+      }
+    }
+    *out_cpu_features = cpu_features;
+  }
 
   *out_header = header;
   return iree_ok_status();
@@ -174,13 +202,65 @@ static iree_status_t fatelf_parse_elf_metadata(
   return iree_ok_status();
 }
 
+// Returns the IREE_ARCH_* name used by the CPU feature bits for ELFs of the
+// given |machine| and |elf_class| or NULL if the architecture has no features.
+static const char* fatelf_cpu_arch_str(iree_elf64_half_t machine,
+                                       iree_elf64_byte_t elf_class) {
+  switch (machine) {
+    case 0xB7:  // EM_AARCH64 / 183
+      return "ARM_64";
+    case 0x3E:  // EM_X86_64 / 62
+      return "X86_64";
+    case 0xF3:  // EM_RISCV / 243
+      return elf_class == IREE_ELF_ELFCLASS64 ? "RISCV_64" : NULL;
+    default:
+      return NULL;
+  }
+}
+
+// Parses a comma-separated list of CPU feature names (as used by LLVM, such as
+// `avx2,fma`) for |arch| and sets the corresponding bits in |features|.
+static iree_status_t fatelf_parse_cpu_features(
+    const char* arch, iree_string_view_t names,
+    iree_fatelf_cpu_features_t* features) {
+  while (!iree_string_view_is_empty(names)) {
+    iree_string_view_t name = iree_string_view_empty();
+    iree_string_view_split(names, ',', &name, &names);
+    name = iree_string_view_trim(name);
+    if (iree_string_view_is_empty(name)) continue;
+    bool found = false;
+#define IREE_CPU_FEATURE_BIT(arch_name, field_index, bit_pos, bit_name, \
+                             llvm_name)                                 \
+  if (!found && arch && strcmp(arch, #arch_name) == 0 &&                \
+      iree_string_view_equal(name, IREE_SV(llvm_name))) {               \
+    features->cpu_data[field_index] |= 1ull << (bit_pos);               \
+    found = true;                                                       \
+  }
+#include "iree/schemas/cpu_feature_bits.inl"
+#undef IREE_CPU_FEATURE_BIT
+    if (!found) {
+      return iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "CPU feature '%.*s' unknown on %s",
+                              (int)name.size, name.data,
+                              arch ? arch : "this architecture");
+    }
+  }
+  return iree_ok_status();
+}
+
 typedef struct {
   uint64_t offset;
   iree_file_contents_t* contents;
   iree_const_byte_span_t elf_data;
+  // Optional `@`-suffixed CPU feature list from the command line.
+  iree_string_view_t cpu_feature_names;
+  iree_fatelf_cpu_features_t cpu_features;
 } fatelf_entry_t;
 
 // Joins one or more ELF files together and writes the output to stdout.
+// Each file may be suffixed with `@feature,feature` to mark the CPU features
+// the ELF requires; the runtime selects the compatible ELF requiring the most
+// features.
 static iree_status_t fatelf_join(int argc, char** argv) {
   IREE_SET_BINARY_MODE(stdout);  // ensure binary output mode
 
@@ -193,7 +273,15 @@ static iree_status_t fatelf_join(int argc, char** argv) {
   fatelf_entry_t* entries =
       (fatelf_entry_t*)iree_alloca(entry_count * sizeof(fatelf_entry_t));
   memset(entries, 0, entry_count * sizeof(*entries));
+  bool has_cpu_features = false;
   for (iree_elf64_byte_t i = 0; i < entry_count; ++i) {
+    char* feature_separator = strrchr(argv[i], '@');
+    if (feature_separator) {
+      *feature_separator = 0;
+      entries[i].cpu_feature_names =
+          iree_make_cstring_view(feature_separator + 1);
+      has_cpu_features = true;
+    }
     IREE_RETURN_IF_ERROR(
         iree_file_read_contents(argv[i], IREE_FILE_READ_FLAG_DEFAULT,
                                 iree_allocator_system(), &entries[i].contents));
@@ -201,9 +289,12 @@ static iree_status_t fatelf_join(int argc, char** argv) {
   }
 
   // Compute offsets of all files based on their size and padding.
-  uint64_t file_offset = iree_host_align(
-      sizeof(iree_fatelf_header_t) + entry_count * sizeof(iree_fatelf_record_t),
-      IREE_FATELF_PAGE_SIZE);
+  uint64_t header_size =
+      sizeof(iree_fatelf_header_t) + entry_count * sizeof(iree_fatelf_record_t);
+  if (has_cpu_features) {
+    header_size += entry_count * sizeof(iree_fatelf_cpu_features_t);
+  }
+  uint64_t file_offset = iree_host_align(header_size, IREE_FATELF_PAGE_SIZE);
   for (iree_elf64_byte_t i = 0; i < entry_count; ++i) {
     entries[i].offset = file_offset;
     file_offset += iree_host_align(
@@ -215,7 +306,7 @@ static iree_status_t fatelf_join(int argc, char** argv) {
       .magic = IREE_FATELF_MAGIC,
       .version = IREE_FATELF_FORMAT_VERSION,
       .record_count = entry_count,
-      .reserved = 0,
+      .reserved = has_cpu_features ? IREE_FATELF_HEADER_FLAG_CPU_FEATURES : 0,
   };
   fwrite(&host_header, 1, sizeof(host_header), stdout);
 
@@ -229,6 +320,9 @@ static iree_status_t fatelf_join(int argc, char** argv) {
     IREE_RETURN_IF_ERROR(
         fatelf_parse_elf_metadata(entries[i].elf_data, &machine, &osabi,
                                   &osabi_version, &elf_class, &elf_data));
+    IREE_RETURN_IF_ERROR(fatelf_parse_cpu_features(
+        fatelf_cpu_arch_str(machine, elf_class), entries[i].cpu_feature_names,
+        &entries[i].cpu_features));
     iree_fatelf_record_t host_record = {
         .machine = machine,
         .osabi = osabi,
@@ -247,9 +341,16 @@ static iree_status_t fatelf_join(int argc, char** argv) {
     fwrite(&host_record, 1, sizeof(host_record), stdout);
   }
 
+  // Write the CPU feature table, if needed, right after the records.
+  if (has_cpu_features) {
+    for (iree_elf64_byte_t i = 0; i < entry_count; ++i) {
+      fwrite(&entries[i].cpu_features, 1, sizeof(entries[i].cpu_features),
+             stdout);
+    }
+  }
+
   // Write all files, padding with zeros in-between as needed.
-  uint64_t write_offset =
-      sizeof(iree_fatelf_header_t) + entry_count * sizeof(iree_fatelf_record_t);
+  uint64_t write_offset = header_size;
   for (iree_elf64_byte_t i = 0; i < entry_count; ++i) {
     uint64_t padding = entries[i].offset - write_offset;
     for (uint64_t i = 0; i < padding; ++i) fputc(0, stdout);
@@ -332,7 +433,9 @@ static iree_status_t fatelf_split(int argc, char** argv) {
       iree_file_read_contents(argv[0], IREE_FILE_READ_FLAG_DEFAULT,
                               iree_allocator_system(), &fatelf_contents));
   iree_fatelf_header_t* header = NULL;
-  IREE_RETURN_IF_ERROR(fatelf_parse(fatelf_contents->const_buffer, &header));
+  iree_fatelf_cpu_features_t* cpu_features = NULL;
+  IREE_RETURN_IF_ERROR(
+      fatelf_parse(fatelf_contents->const_buffer, &header, &cpu_features));
 
   iree_string_view_t dirname, basename;
   iree_file_path_split(iree_make_cstring_view(argv[0]), &dirname, &basename);
@@ -347,12 +450,16 @@ static iree_status_t fatelf_split(int argc, char** argv) {
     const char* word_size_str = fatelf_word_size_id_str(record->word_size);
     const char* byte_order_str = fatelf_byte_order_id_str(record->byte_order);
 
+    // Records that only differ by CPU features need unique names.
+    char variant_str[16] = {0};
+    if (cpu_features) snprintf(variant_str, sizeof(variant_str), "_%d", i);
+
     char record_path[2048];
-    iree_host_size_t record_path_length =
-        snprintf(record_path, IREE_ARRAYSIZE(record_path),
-                 "%.*s%s%.*s.%s_%s_%s%s.so", (int)dirname.size, dirname.data,
-                 dirname.size ? "/" : "", (int)stem.size, stem.data,
-                 machine_str, osabi_str, word_size_str, byte_order_str);
+    iree_host_size_t record_path_length = snprintf(
+        record_path, IREE_ARRAYSIZE(record_path), "%.*s%s%.*s.%s_%s_%s%s%s.so",
+        (int)dirname.size, dirname.data, dirname.size ? "/" : "",
+        (int)stem.size, stem.data, machine_str, osabi_str, word_size_str,
+        byte_order_str, variant_str);
     record_path_length =
         iree_file_path_canonicalize(record_path, record_path_length);
 
@@ -379,6 +486,8 @@ static iree_status_t fatelf_select(int argc, char** argv) {
   IREE_RETURN_IF_ERROR(
       iree_file_read_contents(argv[0], IREE_FILE_READ_FLAG_DEFAULT,
                               iree_allocator_system(), &fatelf_contents));
+  // Selection considers the CPU features of the host.
+  iree_cpu_initialize(iree_allocator_system());
   iree_const_byte_span_t elf_data = iree_const_byte_span_empty();
   IREE_RETURN_IF_ERROR(
       iree_fatelf_select(fatelf_contents->const_buffer, &elf_data));
@@ -416,7 +525,9 @@ static iree_status_t fatelf_dump(int argc, char** argv) {
       iree_file_read_contents(argv[0], IREE_FILE_READ_FLAG_DEFAULT,
                               iree_allocator_system(), &fatelf_contents));
   iree_fatelf_header_t* header = NULL;
-  IREE_RETURN_IF_ERROR(fatelf_parse(fatelf_contents->const_buffer, &header));
+  iree_fatelf_cpu_features_t* cpu_features = NULL;
+  IREE_RETURN_IF_ERROR(
+      fatelf_parse(fatelf_contents->const_buffer, &header, &cpu_features));
 
   fprintf(stdout, "iree_fatelf_header_t:\n");
   fprintf(stdout, "    magic: %" PRIX32 "\n", header->magic);
@@ -446,6 +557,13 @@ static iree_status_t fatelf_dump(int argc, char** argv) {
             record->offset, record->offset);
     fprintf(stdout, "       size: %" PRIu64 " / %016" PRIX64 "\n", record->size,
             record->size);
+    if (cpu_features) {
+      for (iree_host_size_t j = 0; j < IREE_FATELF_CPU_DATA_FIELD_COUNT; ++j) {
+        if (!cpu_features[i].cpu_data[j]) continue;
+        fprintf(stdout, "cpu_data[%d]: %016" PRIX64 "\n", (int)j,
+                cpu_features[i].cpu_data[j]);
+      }
+    }
     fprintf(stdout, "\n");
   }
 